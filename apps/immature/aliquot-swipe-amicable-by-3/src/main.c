@@ -396,6 +396,8 @@ static void configure_state_paths(void) {
     snprintf(g_checkpoint_path, sizeof(g_checkpoint_path), "%s/%s", state_dir, CHECKPOINT_FILE);
     snprintf(g_journal_path, sizeof(g_journal_path), "%s/%s", state_dir, JOURNAL_FILE);
     snprintf(g_lock_path, sizeof(g_lock_path), "%s/%s", state_dir, LOCK_FILE);
+    /* Compiled filter scripts are kept next to the state so restarts skip the compile. */
+    ttak_bigscript_cache_set_dir(state_dir);
 }
 
 /**
@@ -1589,7 +1591,7 @@ int main(int argc, char **argv) {
             .max_steps_per_seed = 10000
         };
         ttak_bigscript_error_t err = {0};
-        g_script_prog = ttak_bigscript_compile(loaded_script, NULL, &limits, &err, now);
+        g_script_prog = ttak_bigscript_compile_cached(loaded_script, NULL, &limits, &err, now);
         if (!g_script_prog) {
             fprintf(stderr, "[FATAL] Script compile error: %s\n", err.message ? err.message : "Unknown");
             return EXIT_FAILURE;
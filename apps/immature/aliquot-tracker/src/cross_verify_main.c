@@ -8,6 +8,7 @@
 #include <ttak/mem/mem.h>
 #include <ttak/timing/timing.h>
 #include <ttak/math/bigint.h>
+#include <ttak/math/factor_cache.h>
 #include <ttak/math/sum_divisors.h>
 
 // Define simplified outcome structure for cross-verification
@@ -31,6 +32,9 @@ typedef struct {
     const char *description;
 } known_test_case_t;
 
+// Known cases share tails (cycle members, common terminating chains), so steps are cached.
+static ttak_factor_cache_t *g_factor_cache;
+
 // Simplified aliquot sequence runner for cross-verification
 static void run_aliquot_sequence_simple(const ttak_bigint_t *seed, simple_outcome_t *out) {
     memset(out, 0, sizeof(*out));
@@ -52,7 +56,9 @@ static void run_aliquot_sequence_simple(const ttak_bigint_t *seed, simple_outcom
         ttak_bigint_t next;
         ttak_bigint_init(&next, now);
         
-        if (!ttak_sum_proper_divisors_big(&current, &next, now)) {
+        bool ok = g_factor_cache ? ttak_factor_cache_sum_proper_divisors(g_factor_cache, &current, &next, now)
+                                 : ttak_sum_proper_divisors_big(&current, &next, now);
+        if (!ok) {
             // Overflow or error
             ttak_bigint_free(&next, now);
             break;
@@ -147,6 +153,7 @@ int main(void) {
 
     int passed_tests = 0;
     int total_tests = sizeof(known_cases) / sizeof(known_test_case_t);
+    g_factor_cache = ttak_factor_cache_create(4096, NULL, ttak_get_tick_count());
 
     for (int i = 0; i < total_tests; ++i) {
         known_test_case_t tc = known_cases[i];
@@ -198,5 +205,6 @@ int main(void) {
     printf("-------------------------------------------------
 ");
 
+    ttak_factor_cache_destroy(g_factor_cache, ttak_get_tick_count());
     return (passed_tests == total_tests) ? 0 : 1;
 }
\ No newline at end of file
@@ -18,9 +18,11 @@
 #include <string.h>
 #include <ctype.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <stdalign.h>
 #include <limits.h>
 
+#include <ttak/io/mmap.h>
 #include <ttak/mem/mem.h>
 #include <ttak/mem/owner.h>
 #include <ttak/sync/sync.h>
@@ -28,8 +30,12 @@
 #include <ttak/atomic/atomic.h>
 #include <ttak/math/bigint.h>
 #include <ttak/math/factor.h>
+#include <ttak/math/factor_cache.h>
 #include <ttak/math/sum_divisors.h>
 #include <ttak/thread/pool.h>
+#include <ttak/net/workq.h>
+#include <netdb.h>
+#include <sys/socket.h>
 
 #ifndef ALIQUOT_ACCEL_LABEL
 #define ALIQUOT_ACCEL_LABEL "CPU"
@@ -46,6 +52,10 @@
 #define TRACK_LOG_NAME      "aliquot_track.jsonl"
 #define CATALOG_FILTER_FILE "catalog_filters.txt"
 #define QUEUE_STATE_NAME    "aliquot_queue.json"
+#define LEDGER_BIN_NAME     "aliquot_ledger.bin"
+#define LEDGER_IDX_NAME     "aliquot_ledger.idx"
+#define QUEUE_BIN_NAME      "aliquot_queue.bin"
+#define FACTOR_CACHE_NAME   "factor_cache.bin"
 #define LEDGER_RESOURCE_NAME "ledger-state"
 
 #define MAX_WORKERS         8
@@ -66,6 +76,35 @@
 #define CATALOG_MAX_EXACT    512
 #define CATALOG_MAX_MOD_RULE 256
 #define SEED_REGISTRY_BUCKETS 65536
+#define FACTOR_CACHE_ENTRIES (1u << 16)
+#define CLUSTER_LISTEN_ENV   "ALIQUOT_CLUSTER_LISTEN"
+#define CLUSTER_COORD_ENV    "ALIQUOT_CLUSTER_COORDINATOR"
+#define CLUSTER_RANGE_ENV    "ALIQUOT_CLUSTER_RANGE"
+#define CLUSTER_LEASE_SEEDS  256
+#define CLUSTER_POLL_MS      10
+#define CLUSTER_WAIT_NS      (100ULL * 1000ULL * 1000ULL)
+#define CLUSTER_LINGER_MS    (5ULL * 1000ULL)
+#define CLUSTER_BACKLOG_MAX  65536
+
+/*
+ * Binary ledger: a 16-byte file header (8-byte magic, u32 version, u32 0)
+ * followed by records of u32 kind, u32 payload bytes and the payload. The
+ * index file has the same header and one 16-byte entry (u64 offset, u32
+ * kind, u32 payload bytes) per record. The ledger is synced before its
+ * index entries are written, so a record the index lacks is still whole
+ * and is re-indexed on restart; a torn tail is cut.
+ */
+#define LEDGER_MAGIC        "ALQLEDG1"
+#define LEDGER_IDX_MAGIC    "ALQLIDX1"
+#define QUEUE_MAGIC         "ALQQUEU1"
+#define LEDGER_VERSION      1u
+#define LEDGER_FILE_HEAD    16u
+#define LEDGER_REC_HEAD     8u
+#define LEDGER_IDX_ENTRY    16u
+#define LEDGER_KIND_FOUND   1u
+#define LEDGER_KIND_JUMP    2u
+#define LEDGER_KIND_TRACK   3u
+#define LEDGER_NULL_STR     UINT32_MAX
 
 typedef struct {
     ttak_bigint_t seed;
@@ -173,6 +212,7 @@ typedef struct {
     uint64_t preview_steps;
     ttak_bigint_t preview_max;
     bool preview_overflow;
+    uint64_t lease;             /* Cluster lease the seed came from; 0 for local work. */
 } aliquot_job_t;
 
 typedef struct seed_entry {
@@ -185,6 +225,14 @@ typedef struct {
     size_t count;
 } pending_queue_t;
 
+/* Growable byte buffer holding encoded ledger records. */
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+    bool failed;
+} ledger_buf_t;
+
 typedef struct {
     found_record_t *found_records;
     size_t found_count;
@@ -201,6 +249,8 @@ typedef struct {
     size_t track_cap;
     size_t persisted_track_count;
 
+    ledger_buf_t pending;       /* Encoded records not yet taken by the writer. */
+
     ttak_mutex_t lock;
 } ledger_state_t;
 
@@ -212,6 +262,11 @@ static char g_found_log_path[PATH_MAX];
 static char g_jump_log_path[PATH_MAX];
 static char g_track_log_path[PATH_MAX];
 static char g_queue_state_path[PATH_MAX];
+static char g_ledger_bin_path[PATH_MAX];
+static char g_ledger_idx_path[PATH_MAX];
+static char g_queue_bin_path[PATH_MAX];
+static char g_factor_cache_path[PATH_MAX];
+static ttak_factor_cache_t *g_factor_cache;
 
 static seed_entry_t *g_seed_buckets[SEED_REGISTRY_BUCKETS];
 static ttak_mutex_t g_seed_lock = PTHREAD_MUTEX_INITIALIZER;
@@ -246,6 +301,14 @@ static pending_queue_t g_pending_queue;
 static ttak_mutex_t g_pending_lock = PTHREAD_MUTEX_INITIALIZER;
 
 static ttak_mutex_t g_disk_lock = PTHREAD_MUTEX_INITIALIZER;
+static int g_ledger_fd = -1;
+static int g_ledger_idx_fd = -1;
+static uint64_t g_ledger_end;
+static uint64_t g_ledger_idx_end;
+static pthread_t g_ledger_writer;
+static bool g_ledger_writer_running;
+static pthread_mutex_t g_ledger_wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_ledger_wake = PTHREAD_COND_INITIALIZER;
 static uint64_t g_last_persist_ms;
 static uint64_t g_total_sequences;
 static uint64_t g_total_probes;
@@ -339,7 +402,7 @@ static ttak_thread_pool_t *g_thread_pool;
 static double compute_overflow_pressure(const aliquot_outcome_t *out);
 static void *worker_process_job_wrapper(void *arg);
 static void process_job(const aliquot_job_t *job);
-static bool enqueue_job(aliquot_job_t *job, const char *source_tag);
+static bool enqueue_job(aliquot_job_t *job);
 static bool ledger_init_owner(void);
 static void ledger_destroy_owner(void);
 static bool ledger_store_found_record(const found_record_t *rec);
@@ -348,6 +411,7 @@ static bool ledger_store_track_record(const track_record_t *rec);
 static void ledger_mark_found_persisted(void);
 static void ledger_mark_jump_persisted(void);
 static void ledger_mark_track_persisted(void);
+static void cluster_upload_found(const found_record_t *rec, uint64_t lease);
 
 static bool pending_queue_add(const ttak_bigint_t *seed) {
     ttak_mutex_lock(&g_pending_lock);
@@ -401,6 +465,12 @@ static uint64_t monotonic_millis(void) {
     return ttak_get_tick_count();
 }
 
+/* Sequences merging into known ones repeat every later term, so steps go through the cache. */
+static bool aliquot_step(const ttak_bigint_t *current, ttak_bigint_t *next, uint64_t now) {
+    if (g_factor_cache) return ttak_factor_cache_sum_proper_divisors(g_factor_cache, current, next, now);
+    return ttak_sum_proper_divisors_big(current, next, now);
+}
+
 static uint64_t monotonic_micros(void) {
     return ttak_get_tick_count_ns() / 1000ULL;
 }
@@ -480,7 +550,11 @@ static void configure_state_paths(void) {
     if (!join_state_path(g_found_log_path, sizeof(g_found_log_path), g_state_dir, FOUND_LOG_NAME) ||
         !join_state_path(g_jump_log_path, sizeof(g_jump_log_path), g_state_dir, JUMP_LOG_NAME) ||
         !join_state_path(g_track_log_path, sizeof(g_track_log_path), g_state_dir, TRACK_LOG_NAME) ||
-        !join_state_path(g_queue_state_path, sizeof(g_queue_state_path), g_state_dir, QUEUE_STATE_NAME)) {
+        !join_state_path(g_queue_state_path, sizeof(g_queue_state_path), g_state_dir, QUEUE_STATE_NAME) ||
+        !join_state_path(g_factor_cache_path, sizeof(g_factor_cache_path), g_state_dir, FACTOR_CACHE_NAME) ||
+        !join_state_path(g_ledger_bin_path, sizeof(g_ledger_bin_path), g_state_dir, LEDGER_BIN_NAME) ||
+        !join_state_path(g_ledger_idx_path, sizeof(g_ledger_idx_path), g_state_dir, LEDGER_IDX_NAME) ||
+        !join_state_path(g_queue_bin_path, sizeof(g_queue_bin_path), g_state_dir, QUEUE_BIN_NAME)) {
         fprintf(stderr, "[ALIQUOT] State path too long, please choose a shorter %s\n", STATE_ENV_VAR);
         exit(1);
     }
@@ -811,7 +885,7 @@ static bool frontier_accept_seed(const ttak_bigint_t *seed, scan_result_t *resul
         
         ttak_bigint_t next;
         ttak_bigint_init(&next, monotonic_millis());
-        bool ok = ttak_sum_proper_divisors_big(&current, &next, monotonic_millis());
+        bool ok = aliquot_step(&current, &next, monotonic_millis());
         tracker_probe_note(&probe_scope, 1);
         steps++;
 
@@ -903,7 +977,7 @@ static void run_aliquot_sequence(const ttak_bigint_t *seed, uint32_t max_steps,
 
         ttak_bigint_t next;
         ttak_bigint_init(&next, monotonic_millis());
-        bool ok = ttak_sum_proper_divisors_big(&current, &next, monotonic_millis());
+        bool ok = aliquot_step(&current, &next, monotonic_millis());
         tracker_probe_note(&probe_scope, 1);
         steps++;
 
@@ -1130,34 +1204,296 @@ static void ledger_owner_store_track(void *ctx, void *args) {
     ttak_mutex_unlock(&state->lock);
 }
 
+static bool ledger_buf_reserve(ledger_buf_t *b, size_t extra) {
+    if (b->failed) return false;
+    if (b->len + extra <= b->cap) return true;
+    size_t cap = b->cap ? b->cap * 2 : 4096;
+    while (cap < b->len + extra) cap *= 2;
+    uint64_t now = monotonic_millis();
+    uint8_t *tmp = b->data
+        ? ttak_mem_realloc_raw(b->data, cap, __TTAK_UNSAFE_MEM_FOREVER__, now)
+        : ttak_mem_alloc_raw(cap, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!tmp) {
+        b->failed = true;
+        return false;
+    }
+    b->data = tmp;
+    b->cap = cap;
+    return true;
+}
+
+static void ledger_buf_free(ledger_buf_t *b) {
+    if (b->data) ttak_mem_free(b->data);
+    memset(b, 0, sizeof(*b));
+}
+
+static void ledger_buf_put(ledger_buf_t *b, const void *src, size_t n) {
+    if (!ledger_buf_reserve(b, n)) return;
+    memcpy(b->data + b->len, src, n);
+    b->len += n;
+}
+
+static void ledger_buf_put_u32(ledger_buf_t *b, uint32_t v) { ledger_buf_put(b, &v, sizeof(v)); }
+static void ledger_buf_put_u64(ledger_buf_t *b, uint64_t v) { ledger_buf_put(b, &v, sizeof(v)); }
+static void ledger_buf_put_f64(ledger_buf_t *b, double v) { ledger_buf_put(b, &v, sizeof(v)); }
+
+static void ledger_buf_put_str(ledger_buf_t *b, const char *str) {
+    if (!str) {
+        ledger_buf_put_u32(b, LEDGER_NULL_STR);
+        return;
+    }
+    size_t n = strlen(str);
+    ledger_buf_put_u32(b, (uint32_t)n);
+    ledger_buf_put(b, str, n);
+}
+
+/* Little-endian magnitude bytes, so the ledger does not depend on the limb width. */
+static void ledger_buf_put_bigint(ledger_buf_t *b, const ttak_bigint_t *v) {
+    size_t n = (ttak_bigint_get_bit_length(v) + 7) / 8;
+    const limb_t *limbs = ttak_bigint_limbs(v);
+    ledger_buf_put_u32(b, (uint32_t)n);
+    if (!ledger_buf_reserve(b, n)) return;
+    for (size_t i = 0; i < n; ++i) {
+        b->data[b->len + i] = (uint8_t)(limbs[i / sizeof(limb_t)] >> (8 * (i % sizeof(limb_t))));
+    }
+    b->len += n;
+}
+
+/* Starts a record; ledger_buf_end_record() fills in its length. */
+static size_t ledger_buf_begin_record(ledger_buf_t *b, uint32_t kind) {
+    size_t at = b->len;
+    ledger_buf_put_u32(b, kind);
+    ledger_buf_put_u32(b, 0);
+    return at;
+}
+
+static void ledger_buf_end_record(ledger_buf_t *b, size_t at) {
+    if (b->failed) return;
+    uint32_t n = (uint32_t)(b->len - at - LEDGER_REC_HEAD);
+    memcpy(b->data + at + 4, &n, sizeof(n));
+}
+
+typedef struct {
+    const uint8_t *p;
+    size_t left;
+    bool ok;
+} ledger_reader_t;
+
+static void ledger_get(ledger_reader_t *r, void *dst, size_t n) {
+    if (!r->ok || r->left < n) {
+        r->ok = false;
+        memset(dst, 0, n);
+        return;
+    }
+    memcpy(dst, r->p, n);
+    r->p += n;
+    r->left -= n;
+}
+
+static uint32_t ledger_get_u32(ledger_reader_t *r) { uint32_t v; ledger_get(r, &v, sizeof(v)); return v; }
+static uint64_t ledger_get_u64(ledger_reader_t *r) { uint64_t v; ledger_get(r, &v, sizeof(v)); return v; }
+static double ledger_get_f64(ledger_reader_t *r) { double v; ledger_get(r, &v, sizeof(v)); return v; }
+
+/* Reads a string into @p dst, or allocates it when @p dup is given; NULL strings stay NULL. */
+static void ledger_get_str(ledger_reader_t *r, char *dst, size_t cap, char **dup, uint64_t now) {
+    uint32_t n = ledger_get_u32(r);
+    if (dst) dst[0] = '\0';
+    if (dup) *dup = NULL;
+    if (n == LEDGER_NULL_STR || !r->ok) return;
+    if (r->left < n) {
+        r->ok = false;
+        return;
+    }
+    if (dst) {
+        size_t c = n < cap ? n : cap - 1;
+        memcpy(dst, r->p, c);
+        dst[c] = '\0';
+    }
+    if (dup) {
+        *dup = ttak_mem_alloc_raw((size_t)n + 1, __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (*dup) {
+            memcpy(*dup, r->p, n);
+            (*dup)[n] = '\0';
+        }
+    }
+    r->p += n;
+    r->left -= n;
+}
+
+static void ledger_get_bigint(ledger_reader_t *r, ttak_bigint_t *dst, uint64_t now) {
+    ttak_bigint_init(dst, now);
+    uint32_t n = ledger_get_u32(r);
+    if (!r->ok || r->left < n) {
+        r->ok = false;
+        return;
+    }
+    size_t count = (n + sizeof(limb_t) - 1) / sizeof(limb_t);
+    if (count > 0) {
+        limb_t *limbs = ttak_mem_alloc_raw(count * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (!limbs) {
+            r->ok = false;
+            return;
+        }
+        memset(limbs, 0, count * sizeof(limb_t));
+        for (size_t i = 0; i < n; ++i) {
+            limbs[i / sizeof(limb_t)] |= (limb_t)r->p[i] << (8 * (i % sizeof(limb_t)));
+        }
+        if (!ttak_bigint_set_limbs(dst, limbs, count, now)) r->ok = false;
+        ttak_mem_free(limbs);
+    }
+    r->p += n;
+    r->left -= n;
+}
+
+static void ledger_encode_found(ledger_buf_t *b, const found_record_t *rec) {
+    size_t at = ledger_buf_begin_record(b, LEDGER_KIND_FOUND);
+    ledger_buf_put_bigint(b, &rec->seed);
+    ledger_buf_put_u64(b, rec->steps);
+    ledger_buf_put_bigint(b, &rec->max_value);
+    ledger_buf_put_bigint(b, &rec->final_value);
+    ledger_buf_put_u32(b, rec->cycle_length);
+    ledger_buf_put_str(b, rec->status);
+    ledger_buf_put_str(b, rec->provenance);
+    ledger_buf_end_record(b, at);
+}
+
+static bool ledger_decode_found(ledger_reader_t *r, found_record_t *rec, uint64_t now) {
+    memset(rec, 0, sizeof(*rec));
+    ledger_get_bigint(r, &rec->seed, now);
+    rec->steps = ledger_get_u64(r);
+    ledger_get_bigint(r, &rec->max_value, now);
+    ledger_get_bigint(r, &rec->final_value, now);
+    rec->cycle_length = ledger_get_u32(r);
+    ledger_get_str(r, rec->status, sizeof(rec->status), NULL, now);
+    ledger_get_str(r, rec->provenance, sizeof(rec->provenance), NULL, now);
+    return r->ok && r->left == 0;
+}
+
+static void ledger_free_found(found_record_t *rec, uint64_t now) {
+    ttak_bigint_free(&rec->seed, now);
+    ttak_bigint_free(&rec->max_value, now);
+    ttak_bigint_free(&rec->final_value, now);
+}
+
+static void ledger_encode_jump(ledger_buf_t *b, const jump_record_t *rec) {
+    size_t at = ledger_buf_begin_record(b, LEDGER_KIND_JUMP);
+    ledger_buf_put_bigint(b, &rec->seed);
+    ledger_buf_put_u64(b, rec->preview_steps);
+    ledger_buf_put_bigint(b, &rec->preview_max);
+    ledger_buf_put_f64(b, rec->score);
+    ledger_buf_put_f64(b, rec->overflow_pressure);
+    ledger_buf_end_record(b, at);
+}
+
+static bool ledger_decode_jump(ledger_reader_t *r, jump_record_t *rec, uint64_t now) {
+    memset(rec, 0, sizeof(*rec));
+    ledger_get_bigint(r, &rec->seed, now);
+    rec->preview_steps = ledger_get_u64(r);
+    ledger_get_bigint(r, &rec->preview_max, now);
+    rec->score = ledger_get_f64(r);
+    rec->overflow_pressure = ledger_get_f64(r);
+    return r->ok && r->left == 0;
+}
+
+static void ledger_free_jump(jump_record_t *rec, uint64_t now) {
+    ttak_bigint_free(&rec->seed, now);
+    ttak_bigint_free(&rec->preview_max, now);
+}
+
+static void ledger_encode_track(ledger_buf_t *b, const track_record_t *rec) {
+    size_t at = ledger_buf_begin_record(b, LEDGER_KIND_TRACK);
+    ledger_buf_put_bigint(b, &rec->seed);
+    ledger_buf_put_u64(b, rec->steps);
+    ledger_buf_put_u64(b, rec->wall_time_ms);
+    ledger_buf_put_u64(b, rec->wall_time_us);
+    ledger_buf_put_u64(b, rec->budget_ms);
+    ledger_buf_put_u32(b, rec->max_step);
+    ledger_buf_put_u32(b, rec->max_bits);
+    ledger_buf_put_u32(b, rec->max_dec_digits);
+    ledger_buf_put_f64(b, rec->scout_score);
+    ledger_buf_put_u32(b, rec->priority);
+    ledger_buf_put_str(b, rec->ended);
+    ledger_buf_put_str(b, rec->ended_by);
+    ledger_buf_put_str(b, rec->max_hash);
+    ledger_buf_put_str(b, rec->max_prefix);
+    ledger_buf_put_str(b, rec->max_value_dec);
+    ledger_buf_end_record(b, at);
+}
+
+static bool ledger_decode_track(ledger_reader_t *r, track_record_t *rec, uint64_t now) {
+    memset(rec, 0, sizeof(*rec));
+    ledger_get_bigint(r, &rec->seed, now);
+    rec->steps = ledger_get_u64(r);
+    rec->wall_time_ms = ledger_get_u64(r);
+    rec->wall_time_us = ledger_get_u64(r);
+    rec->budget_ms = ledger_get_u64(r);
+    rec->max_step = ledger_get_u32(r);
+    rec->max_bits = ledger_get_u32(r);
+    rec->max_dec_digits = ledger_get_u32(r);
+    rec->scout_score = ledger_get_f64(r);
+    rec->priority = ledger_get_u32(r);
+    ledger_get_str(r, rec->ended, sizeof(rec->ended), NULL, now);
+    ledger_get_str(r, rec->ended_by, sizeof(rec->ended_by), NULL, now);
+    ledger_get_str(r, rec->max_hash, sizeof(rec->max_hash), NULL, now);
+    ledger_get_str(r, rec->max_prefix, sizeof(rec->max_prefix), NULL, now);
+    ledger_get_str(r, NULL, 0, &rec->max_value_dec, now);
+    return r->ok && r->left == 0;
+}
+
+static void ledger_free_track(track_record_t *rec, uint64_t now) {
+    ttak_bigint_free(&rec->seed, now);
+    if (rec->max_value_dec) {
+        ttak_mem_free(rec->max_value_dec);
+        rec->max_value_dec = NULL;
+    }
+}
+
+static void ledger_export_found(FILE *fp, const found_record_t *rec, uint64_t now) {
+    char *s_seed = ttak_bigint_to_string(&rec->seed, now);
+    char *s_max = ttak_bigint_to_string(&rec->max_value, now);
+    char *s_final = ttak_bigint_to_string(&rec->final_value, now);
+    fprintf(fp, "{\"seed\":\"%s\",\"steps\":%" PRIu64 ",\"max\":\"%s\",\"final\":\"%s\",\"cycle\":%u,\"status\":\"%s\",\"source\":\"%s\"}\n",
+            s_seed ? s_seed : "0", rec->steps, s_max ? s_max : "0", s_final ? s_final : "0",
+            rec->cycle_length, rec->status, rec->provenance);
+    if (s_seed) ttak_mem_free(s_seed);
+    if (s_max) ttak_mem_free(s_max);
+    if (s_final) ttak_mem_free(s_final);
+}
+
+static void ledger_export_jump(FILE *fp, const jump_record_t *rec, uint64_t now) {
+    char *s_seed = ttak_bigint_to_string(&rec->seed, now);
+    char *s_max = ttak_bigint_to_string(&rec->preview_max, now);
+    fprintf(fp, "{\"seed\":\"%s\",\"steps\":%" PRIu64 ",\"max\":\"%s\",\"score\":%.2f,\"overflow\":%.3f}\n",
+            s_seed ? s_seed : "0", rec->preview_steps, s_max ? s_max : "0", rec->score, rec->overflow_pressure);
+    if (s_seed) ttak_mem_free(s_seed);
+    if (s_max) ttak_mem_free(s_max);
+}
+
+static void ledger_export_track(FILE *fp, const track_record_t *rec, uint64_t now) {
+    char *s_seed = ttak_bigint_to_string(&rec->seed, now);
+    fprintf(fp, "{\"seed\":\"%s\",\"steps\":%" PRIu64 ",\"bits\":%u,\"digits\":%u,"
+            "\"hash\":\"%s\",\"prefix\":\"%s\",\"ended\":\"%s\",\"ended_by\":\"%s\",\"wall_ms\":%" PRIu64 ",\"wall_us\":%" PRIu64 ","
+            "\"budget_ms\":%" PRIu64 ",\"score\":%.2f,\"priority\":%u,\"max_step\":%u,\"max_value\":\"%s\"}\n",
+            s_seed ? s_seed : "0", rec->steps, rec->max_bits, rec->max_dec_digits,
+            rec->max_hash, rec->max_prefix, rec->ended, rec->ended_by, rec->wall_time_ms, rec->wall_time_us,
+            rec->budget_ms, rec->scout_score, rec->priority, rec->max_step,
+            rec->max_value_dec ? rec->max_value_dec : "unknown");
+    if (s_seed) ttak_mem_free(s_seed);
+}
+
+/*
+ * The persist hooks only encode new records into the pending buffer while
+ * holding the ledger lock; decimal conversion and disk I/O happen later on
+ * the writer thread, so workers storing records never wait on the disk.
+ */
 static void ledger_owner_persist_found(void *ctx, void *args) {
     (void)args;
     ledger_state_t *state = (ledger_state_t *)ctx;
     if (!state) return;
     ttak_mutex_lock(&state->lock);
-    if (state->persisted_found_count >= state->found_count) {
-        ttak_mutex_unlock(&state->lock);
-        return;
-    }
-    FILE *fp = fopen(g_found_log_path, "a");
-    if (!fp) {
-        ttak_mutex_unlock(&state->lock);
-        return;
-    }
-    uint64_t now = monotonic_millis();
     for (size_t i = state->persisted_found_count; i < state->found_count; ++i) {
-        const found_record_t *rec = &state->found_records[i];
-        char *s_seed = ttak_bigint_to_string(&rec->seed, now);
-        char *s_max = ttak_bigint_to_string(&rec->max_value, now);
-        char *s_final = ttak_bigint_to_string(&rec->final_value, now);
-        fprintf(fp, "{\"seed\":\"%s\",\"steps\":%" PRIu64 ",\"max\":\"%s\",\"final\":\"%s\",\"cycle\":%u,\"status\":\"%s\",\"source\":\"%s\"}\n",
-                s_seed ? s_seed : "0", rec->steps, s_max ? s_max : "0", s_final ? s_final : "0",
-                rec->cycle_length, rec->status, rec->provenance);
-        if (s_seed) ttak_mem_free(s_seed);
-        if (s_max) ttak_mem_free(s_max);
-        if (s_final) ttak_mem_free(s_final);
+        ledger_encode_found(&state->pending, &state->found_records[i]);
     }
-    fclose(fp);
     state->persisted_found_count = state->found_count;
     ttak_mutex_unlock(&state->lock);
 }
@@ -1167,26 +1503,9 @@ static void ledger_owner_persist_jump(void *ctx, void *args) {
     ledger_state_t *state = (ledger_state_t *)ctx;
     if (!state) return;
     ttak_mutex_lock(&state->lock);
-    if (state->persisted_jump_count >= state->jump_count) {
-        ttak_mutex_unlock(&state->lock);
-        return;
-    }
-    FILE *fp = fopen(g_jump_log_path, "a");
-    if (!fp) {
-        ttak_mutex_unlock(&state->lock);
-        return;
-    }
-    uint64_t now = monotonic_millis();
     for (size_t i = state->persisted_jump_count; i < state->jump_count; ++i) {
-        const jump_record_t *rec = &state->jump_records[i];
-        char *s_seed = ttak_bigint_to_string(&rec->seed, now);
-        char *s_max = ttak_bigint_to_string(&rec->preview_max, now);
-        fprintf(fp, "{\"seed\":\"%s\",\"steps\":%" PRIu64 ",\"max\":\"%s\",\"score\":%.2f,\"overflow\":%.3f}\n",
-                s_seed ? s_seed : "0", rec->preview_steps, s_max ? s_max : "0", rec->score, rec->overflow_pressure);
-        if (s_seed) ttak_mem_free(s_seed);
-        if (s_max) ttak_mem_free(s_max);
+        ledger_encode_jump(&state->pending, &state->jump_records[i]);
     }
-    fclose(fp);
     state->persisted_jump_count = state->jump_count;
     ttak_mutex_unlock(&state->lock);
 }
@@ -1196,37 +1515,28 @@ static void ledger_owner_persist_track(void *ctx, void *args) {
     ledger_state_t *state = (ledger_state_t *)ctx;
     if (!state) return;
     ttak_mutex_lock(&state->lock);
-    if (state->persisted_track_count >= state->track_count) {
-        ttak_mutex_unlock(&state->lock);
-        return;
-    }
-    FILE *fp = fopen(g_track_log_path, "a");
-    if (!fp) {
-        ttak_mutex_unlock(&state->lock);
-        return;
-    }
-    uint64_t now = monotonic_millis();
     for (size_t i = state->persisted_track_count; i < state->track_count; ++i) {
         track_record_t *rec = &state->track_records[i];
-        char *s_seed = ttak_bigint_to_string(&rec->seed, now);
-        fprintf(fp, "{\"seed\":\"%s\",\"steps\":%" PRIu64 ",\"bits\":%u,\"digits\":%u,"
-                "\"hash\":\"%s\",\"prefix\":\"%s\",\"ended\":\"%s\",\"ended_by\":\"%s\",\"wall_ms\":%" PRIu64 ",\"wall_us\":%" PRIu64 ","
-                "\"budget_ms\":%" PRIu64 ",\"score\":%.2f,\"priority\":%u,\"max_step\":%u,\"max_value\":\"%s\"}\n",
-                s_seed ? s_seed : "0", rec->steps, rec->max_bits, rec->max_dec_digits,
-                rec->max_hash, rec->max_prefix, rec->ended, rec->ended_by, rec->wall_time_ms, rec->wall_time_us,
-                rec->budget_ms, rec->scout_score, rec->priority, rec->max_step,
-                rec->max_value_dec ? rec->max_value_dec : "unknown");
-        if (s_seed) ttak_mem_free(s_seed);
+        ledger_encode_track(&state->pending, rec);
         if (rec->max_value_dec) {
             ttak_mem_free(rec->max_value_dec);
             rec->max_value_dec = NULL;
         }
     }
-    fclose(fp);
     state->persisted_track_count = state->track_count;
     ttak_mutex_unlock(&state->lock);
 }
 
+static void ledger_owner_take_pending(void *ctx, void *args) {
+    ledger_state_t *state = (ledger_state_t *)ctx;
+    ledger_buf_t *out = (ledger_buf_t *)args;
+    if (!state || !out) return;
+    ttak_mutex_lock(&state->lock);
+    *out = state->pending;
+    memset(&state->pending, 0, sizeof(state->pending));
+    ttak_mutex_unlock(&state->lock);
+}
+
 static void ledger_owner_mark_found_persisted(void *ctx, void *args) {
     (void)args;
     ledger_state_t *state = (ledger_state_t *)ctx;
@@ -1310,6 +1620,7 @@ static bool ledger_init_owner(void) {
     ok &= ttak_owner_register_func(g_ledger_owner, "persist_found", ledger_owner_persist_found);
     ok &= ttak_owner_register_func(g_ledger_owner, "persist_jump", ledger_owner_persist_jump);
     ok &= ttak_owner_register_func(g_ledger_owner, "persist_track", ledger_owner_persist_track);
+    ok &= ttak_owner_register_func(g_ledger_owner, "take_pending", ledger_owner_take_pending);
     ok &= ttak_owner_register_func(g_ledger_owner, "mark_found_persisted", ledger_owner_mark_found_persisted);
     ok &= ttak_owner_register_func(g_ledger_owner, "mark_jump_persisted", ledger_owner_mark_jump_persisted);
     ok &= ttak_owner_register_func(g_ledger_owner, "mark_track_persisted", ledger_owner_mark_track_persisted);
@@ -1348,11 +1659,12 @@ static void ledger_destroy_owner(void) {
             ttak_mem_free(g_ledger_state.track_records[i].max_value_dec);
     }
     if (g_ledger_state.track_records) ttak_mem_free(g_ledger_state.track_records);
+    ledger_buf_free(&g_ledger_state.pending);
 
     ttak_mutex_destroy(&g_ledger_state.lock);
 }
 
-static void append_found_record(const aliquot_outcome_t *out, const char *source) {
+static void append_found_record(const aliquot_outcome_t *out, const char *source, uint64_t lease) {
     if (!out) return;
     found_record_t rec = {0};
     uint64_t now = monotonic_millis();
@@ -1370,6 +1682,7 @@ static void append_found_record(const aliquot_outcome_t *out, const char *source
         ttak_bigint_free(&rec.final_value, now);
         return;
     }
+    cluster_upload_found(&rec, lease);
     char *s_seed = ttak_bigint_to_string(&rec.seed, now);
     printf("[ALIQUOT] seed=%s steps=%" PRIu64 " status=%s via %s\n",
             s_seed ? s_seed : "0", rec.steps, rec.status,
@@ -1568,29 +1881,161 @@ static void persist_track_records(void) {
     if (g_ledger_owner) ttak_owner_execute(g_ledger_owner, "persist_track", LEDGER_RESOURCE_NAME, NULL);
 }
 
+static bool ledger_write_all(int fd, const uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, buf, len);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        buf += w;
+        len -= (size_t)w;
+    }
+    return true;
+}
+
+/* Reads the record header at @p off; false unless the whole record lies inside @p len. */
+static bool ledger_record_at(const uint8_t *data, size_t len, uint64_t off, uint32_t *kind, uint32_t *payload) {
+    if (off > len || len - off < LEDGER_REC_HEAD) return false;
+    memcpy(kind, data + off, sizeof(*kind));
+    memcpy(payload, data + off + 4, sizeof(*payload));
+    if (*kind < LEDGER_KIND_FOUND || *kind > LEDGER_KIND_TRACK) return false;
+    return len - off - LEDGER_REC_HEAD >= *payload;
+}
+
+static void ledger_file_header(uint8_t out[LEDGER_FILE_HEAD], const char *magic) {
+    uint32_t version = LEDGER_VERSION;
+    memset(out, 0, LEDGER_FILE_HEAD);
+    memcpy(out, magic, 8);
+    memcpy(out + 8, &version, sizeof(version));
+}
+
+/* Writes every record of @p batch to the ledger, syncs it, then indexes and syncs them. */
+static void ledger_write_batch(const ledger_buf_t *batch, bool export_jsonl) {
+    if (batch->failed) {
+        fprintf(stderr, "[ALIQUOT] Out of memory encoding ledger records; batch dropped.\n");
+        return;
+    }
+    if (batch->len == 0 || g_ledger_fd < 0 || g_ledger_idx_fd < 0) return;
+    ledger_buf_t idx = {0};
+    uint32_t kind, payload;
+    for (uint64_t off = 0; ledger_record_at(batch->data, batch->len, off, &kind, &payload);
+         off += LEDGER_REC_HEAD + payload) {
+        ledger_buf_put_u64(&idx, g_ledger_end + off);
+        ledger_buf_put_u32(&idx, kind);
+        ledger_buf_put_u32(&idx, payload);
+    }
+    bool ok = !idx.failed && ledger_write_all(g_ledger_fd, batch->data, batch->len) && fsync(g_ledger_fd) == 0 &&
+              ledger_write_all(g_ledger_idx_fd, idx.data, idx.len) && fsync(g_ledger_idx_fd) == 0;
+    if (!ok) {
+        fprintf(stderr, "[ALIQUOT] Ledger write failed: %s\n", strerror(errno));
+        if (ftruncate(g_ledger_fd, (off_t)g_ledger_end) != 0 || ftruncate(g_ledger_idx_fd, (off_t)g_ledger_idx_end) != 0 ||
+            lseek(g_ledger_fd, (off_t)g_ledger_end, SEEK_SET) < 0 || lseek(g_ledger_idx_fd, (off_t)g_ledger_idx_end, SEEK_SET) < 0) {
+            fprintf(stderr, "[ALIQUOT] Could not roll back the ledger; it is repaired on restart.\n");
+        }
+        ledger_buf_free(&idx);
+        return;
+    }
+    g_ledger_end += batch->len;
+    g_ledger_idx_end += idx.len;
+    ledger_buf_free(&idx);
+    if (!export_jsonl) return;
+
+    /* JSONL stays as the human-readable export the scripts read; restarts use the binary ledger. */
+    FILE *found_fp = NULL, *jump_fp = NULL, *track_fp = NULL;
+    uint64_t now = monotonic_millis();
+    for (uint64_t off = 0; ledger_record_at(batch->data, batch->len, off, &kind, &payload);
+         off += LEDGER_REC_HEAD + payload) {
+        ledger_reader_t r = {batch->data + off + LEDGER_REC_HEAD, payload, true};
+        if (kind == LEDGER_KIND_FOUND) {
+            found_record_t rec;
+            if (!found_fp) found_fp = fopen(g_found_log_path, "a");
+            if (ledger_decode_found(&r, &rec, now) && found_fp) ledger_export_found(found_fp, &rec, now);
+            ledger_free_found(&rec, now);
+        } else if (kind == LEDGER_KIND_JUMP) {
+            jump_record_t rec;
+            if (!jump_fp) jump_fp = fopen(g_jump_log_path, "a");
+            if (ledger_decode_jump(&r, &rec, now) && jump_fp) ledger_export_jump(jump_fp, &rec, now);
+            ledger_free_jump(&rec, now);
+        } else {
+            track_record_t rec;
+            if (!track_fp) track_fp = fopen(g_track_log_path, "a");
+            if (ledger_decode_track(&r, &rec, now) && track_fp) ledger_export_track(track_fp, &rec, now);
+            ledger_free_track(&rec, now);
+        }
+    }
+    if (found_fp) fclose(found_fp);
+    if (jump_fp) fclose(jump_fp);
+    if (track_fp) fclose(track_fp);
+}
+
+/*
+ * Opens the ledger and index for appending at @p end and @p idx_end,
+ * cutting anything past them and writing headers into empty files.
+ */
+static bool ledger_open_files(uint64_t end, uint64_t idx_end) {
+    uint8_t head[LEDGER_FILE_HEAD];
+    g_ledger_fd = open(g_ledger_bin_path, O_RDWR | O_CREAT, 0644);
+    g_ledger_idx_fd = open(g_ledger_idx_path, O_RDWR | O_CREAT, 0644);
+    if (g_ledger_fd < 0 || g_ledger_idx_fd < 0) goto fail;
+    if (ftruncate(g_ledger_fd, (off_t)end) != 0 || ftruncate(g_ledger_idx_fd, (off_t)idx_end) != 0) goto fail;
+    if (end == 0) {
+        ledger_file_header(head, LEDGER_MAGIC);
+        if (!ledger_write_all(g_ledger_fd, head, sizeof(head))) goto fail;
+        end = LEDGER_FILE_HEAD;
+    }
+    if (idx_end == 0) {
+        ledger_file_header(head, LEDGER_IDX_MAGIC);
+        if (!ledger_write_all(g_ledger_idx_fd, head, sizeof(head))) goto fail;
+        idx_end = LEDGER_FILE_HEAD;
+    }
+    if (lseek(g_ledger_fd, (off_t)end, SEEK_SET) < 0 || lseek(g_ledger_idx_fd, (off_t)idx_end, SEEK_SET) < 0) goto fail;
+    g_ledger_end = end;
+    g_ledger_idx_end = idx_end;
+    return true;
+fail:
+    fprintf(stderr, "[ALIQUOT] Cannot open ledger %s: %s\n", g_ledger_bin_path, strerror(errno));
+    if (g_ledger_fd >= 0) close(g_ledger_fd);
+    if (g_ledger_idx_fd >= 0) close(g_ledger_idx_fd);
+    g_ledger_fd = g_ledger_idx_fd = -1;
+    return false;
+}
+
+static void ledger_close_files(void) {
+    if (g_ledger_fd >= 0) close(g_ledger_fd);
+    if (g_ledger_idx_fd >= 0) close(g_ledger_idx_fd);
+    g_ledger_fd = g_ledger_idx_fd = -1;
+}
+
+/* Replaces the queue snapshot through a temporary file so a crash leaves the old one. */
 static void persist_queue_state(void) {
     ttak_bigint_t pending[JOB_QUEUE_CAP];
     size_t count = pending_queue_snapshot(pending, JOB_QUEUE_CAP);
-    FILE *fp = fopen(g_queue_state_path, "w");
-    if (!fp) {
-        for (size_t i = 0; i < count; ++i) ttak_bigint_free(&pending[i], monotonic_millis());
-        return;
-    }
     uint64_t now = monotonic_millis();
-    fprintf(fp, "{\"pending\":[");
+    ledger_buf_t buf = {0};
+    ledger_buf_put(&buf, QUEUE_MAGIC, 8);
+    ledger_buf_put_u32(&buf, (uint32_t)count);
     for (size_t i = 0; i < count; ++i) {
-        char *s = ttak_bigint_to_string(&pending[i], now);
-        fprintf(fp, "%s\"%s\"", (i == 0) ? "" : ",", s ? s : "0");
-        if (s) ttak_mem_free(s);
+        ledger_buf_put_bigint(&buf, &pending[i]);
         ttak_bigint_free(&pending[i], now);
     }
-    fprintf(fp, "],\"ts\":%" PRIu64 "}\n", now);
-    fclose(fp);
+    char tmp_path[PATH_MAX + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", g_queue_bin_path);
+    int fd = buf.failed ? -1 : open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        bool ok = ledger_write_all(fd, buf.data, buf.len) && fsync(fd) == 0;
+        close(fd);
+        if (!ok || rename(tmp_path, g_queue_bin_path) != 0) unlink(tmp_path);
+    }
+    ledger_buf_free(&buf);
 }
 
 static void flush_ledgers(void) {
     ttak_mutex_lock(&g_disk_lock);
-    persist_found_records(); persist_jump_records(); persist_track_records(); persist_queue_state();
+    persist_found_records(); persist_jump_records(); persist_track_records();
+    ledger_buf_t batch = {0};
+    if (g_ledger_owner) ttak_owner_execute(g_ledger_owner, "take_pending", LEDGER_RESOURCE_NAME, &batch);
+    ledger_write_batch(&batch, true);
+    ledger_buf_free(&batch);
+    persist_queue_state();
     uint64_t now = monotonic_millis();
     ttak_atomic_write64(&g_last_persist_ms, now);
 #if defined(ENABLE_CUDA) || defined(ENABLE_ROCM) || defined(ENABLE_OPENCL)
@@ -1599,9 +2044,38 @@ static void flush_ledgers(void) {
     ttak_mutex_unlock(&g_disk_lock);
 }
 
+/* Wakes the writer once the interval has passed; never blocks the caller on the disk. */
 static void maybe_flush_ledgers(void) {
     uint64_t now = monotonic_millis();
-    if (now - ttak_atomic_read64(&g_last_persist_ms) >= FLUSH_INTERVAL_MS) flush_ledgers();
+    if (now - ttak_atomic_read64(&g_last_persist_ms) < FLUSH_INTERVAL_MS) return;
+    if (!g_ledger_writer_running) {
+        flush_ledgers();
+        return;
+    }
+    pthread_mutex_lock(&g_ledger_wake_lock);
+    pthread_cond_signal(&g_ledger_wake);
+    pthread_mutex_unlock(&g_ledger_wake_lock);
+}
+
+/* Batches every record stored since the last pass into one synced append. */
+static void *ledger_writer_main(void *arg) {
+    (void)arg;
+    while (!ttak_atomic_read64(&shutdown_requested)) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += FLUSH_INTERVAL_MS / 1000;
+        deadline.tv_nsec += (long)(FLUSH_INTERVAL_MS % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&g_ledger_wake_lock);
+        pthread_cond_timedwait(&g_ledger_wake, &g_ledger_wake_lock, &deadline);
+        pthread_mutex_unlock(&g_ledger_wake_lock);
+        if (ttak_atomic_read64(&shutdown_requested)) break;
+        flush_ledgers();
+    }
+    return NULL;
 }
 
 static bool ttak_bigint_init_from_string(ttak_bigint_t *bi, const char *s, uint64_t now) {
@@ -1682,7 +2156,6 @@ static void load_found_records(void) {
         }
     }
     fclose(fp);
-    ledger_mark_found_persisted();
 }
 
 static void load_jump_records(void) {
@@ -1709,7 +2182,6 @@ static void load_jump_records(void) {
         }
     }
     fclose(fp);
-    ledger_mark_jump_persisted();
 }
 
 static void load_track_records(void) {
@@ -1750,10 +2222,164 @@ static void load_track_records(void) {
         }
     }
     fclose(fp);
-    ledger_mark_track_persisted();
 }
 
-static bool enqueue_job(aliquot_job_t *job, const char *source_tag) {
+static bool ledger_rehydrate(uint32_t kind, const uint8_t *payload, uint32_t len, uint64_t now) {
+    ledger_reader_t r = {payload, len, true};
+    bool ok;
+    if (kind == LEDGER_KIND_FOUND) {
+        found_record_t rec;
+        ok = ledger_decode_found(&r, &rec, now);
+        if (ok) {
+            rehydrate_found_record(&rec);
+            seed_registry_mark(&rec.seed);
+        }
+        ledger_free_found(&rec, now);
+    } else if (kind == LEDGER_KIND_JUMP) {
+        jump_record_t rec;
+        ok = ledger_decode_jump(&r, &rec, now);
+        if (ok) rehydrate_jump_record(&rec);
+        ledger_free_jump(&rec, now);
+    } else {
+        track_record_t rec;
+        ok = ledger_decode_track(&r, &rec, now);
+        if (ok) rehydrate_track_record(&rec);
+        ledger_free_track(&rec, now);
+    }
+    return ok;
+}
+
+/*
+ * Maps the binary ledger and its index and rehydrates every whole record.
+ * Index entries that agree with the ledger size the record arrays up
+ * front; records past the last good entry are scanned and re-indexed.
+ * Returns false when there is no usable ledger.
+ */
+static bool load_binary_ledger(void) {
+    uint64_t now = monotonic_millis();
+    int fd = open(g_ledger_bin_path, O_RDONLY);
+    if (fd < 0) return false;
+    ttak_io_mmap_t *map = ttak_io_mmap_create(fd, NULL, UINT64_MAX, 0, now);
+    const uint8_t *data = NULL;
+    if (!map || ttak_io_mmap_retain(map, 0, map->len, &data, now) != TTAK_IO_SUCCESS) {
+        if (map) ttak_io_mmap_close(map, now);
+        return false;
+    }
+    size_t len = map->len;
+    uint8_t head[LEDGER_FILE_HEAD];
+    ledger_file_header(head, LEDGER_MAGIC);
+    if (len < LEDGER_FILE_HEAD || memcmp(data, head, LEDGER_FILE_HEAD) != 0) {
+        fprintf(stderr, "[ALIQUOT] %s is not a v%u ledger; rebuilding it from the JSONL ledgers.\n",
+                g_ledger_bin_path, LEDGER_VERSION);
+        ttak_io_mmap_release(map);
+        ttak_io_mmap_close(map, now);
+        return false;
+    }
+    (void)ttak_io_mmap_advise(map, 0, 0, TTAK_IO_MMAP_SEQUENTIAL, now);
+
+    ttak_io_mmap_t *idx_map = NULL;
+    const uint8_t *idx = NULL;
+    size_t idx_count = 0;
+    int idx_fd = open(g_ledger_idx_path, O_RDONLY);
+    if (idx_fd >= 0) idx_map = ttak_io_mmap_create(idx_fd, NULL, UINT64_MAX, 0, now);
+    if (idx_map && ttak_io_mmap_retain(idx_map, 0, idx_map->len, &idx, now) == TTAK_IO_SUCCESS) {
+        ledger_file_header(head, LEDGER_IDX_MAGIC);
+        if (idx_map->len >= LEDGER_FILE_HEAD && memcmp(idx, head, LEDGER_FILE_HEAD) == 0) {
+            idx_count = (idx_map->len - LEDGER_FILE_HEAD) / LEDGER_IDX_ENTRY;
+        }
+    } else {
+        idx = NULL;
+    }
+
+    size_t counts[LEDGER_KIND_TRACK + 1] = {0};
+    size_t indexed = 0;
+    uint64_t end = LEDGER_FILE_HEAD;
+    uint32_t kind, payload;
+    for (; indexed < idx_count; ++indexed) {
+        const uint8_t *e = idx + LEDGER_FILE_HEAD + indexed * LEDGER_IDX_ENTRY;
+        uint64_t e_off;
+        uint32_t e_kind, e_len;
+        memcpy(&e_off, e, 8);
+        memcpy(&e_kind, e + 8, 4);
+        memcpy(&e_len, e + 12, 4);
+        if (e_off != end || !ledger_record_at(data, len, end, &kind, &payload) || kind != e_kind || payload != e_len) break;
+        counts[kind]++;
+        end += LEDGER_REC_HEAD + payload;
+    }
+    uint64_t indexed_end = end;
+    while (ledger_record_at(data, len, end, &kind, &payload)) {
+        counts[kind]++;
+        end += LEDGER_REC_HEAD + payload;
+    }
+
+    ttak_mutex_lock(&g_ledger_state.lock);
+    (void)ledger_ensure_found_capacity_locked(&g_ledger_state, counts[LEDGER_KIND_FOUND]);
+    (void)ledger_ensure_jump_capacity_locked(&g_ledger_state, counts[LEDGER_KIND_JUMP]);
+    (void)ledger_ensure_track_capacity_locked(&g_ledger_state, counts[LEDGER_KIND_TRACK]);
+    ttak_mutex_unlock(&g_ledger_state.lock);
+
+    /* Entries for records the index missed, appended once the files are reopened. */
+    ledger_buf_t tail = {0};
+    size_t records = 0;
+    uint64_t off = LEDGER_FILE_HEAD;
+    while (off < end && ledger_record_at(data, len, off, &kind, &payload)) {
+        if (!ledger_rehydrate(kind, data + off + LEDGER_REC_HEAD, payload, now)) break;
+        if (off >= indexed_end) {
+            ledger_buf_put_u64(&tail, off);
+            ledger_buf_put_u32(&tail, kind);
+            ledger_buf_put_u32(&tail, payload);
+        }
+        records++;
+        off += LEDGER_REC_HEAD + payload;
+    }
+    if (off < indexed_end) indexed = records; /* A bad indexed record drops it and all after it. */
+    end = off;
+
+    ttak_io_mmap_release(map);
+    ttak_io_mmap_close(map, now);
+    if (idx_map) {
+        if (idx) ttak_io_mmap_release(idx_map);
+        ttak_io_mmap_close(idx_map, now);
+    }
+
+    uint64_t idx_end = LEDGER_FILE_HEAD + (uint64_t)indexed * LEDGER_IDX_ENTRY;
+    if (idx_count == 0 && indexed == 0) idx_end = 0;
+    bool ok = ledger_open_files(end, idx_end);
+    if (ok && tail.len > 0 && !tail.failed) {
+        ok = ledger_write_all(g_ledger_idx_fd, tail.data, tail.len) && fsync(g_ledger_idx_fd) == 0;
+        if (ok) g_ledger_idx_end += tail.len;
+    }
+    ledger_buf_free(&tail);
+    if (ok) {
+        printf("[ALIQUOT] Restored %zu ledger records from %s\n", records, g_ledger_bin_path);
+        ledger_mark_found_persisted();
+        ledger_mark_jump_persisted();
+        ledger_mark_track_persisted();
+    }
+    return ok;
+}
+
+/* Restores the ledgers, importing the JSONL files once when no binary ledger exists yet. */
+static void load_ledgers(void) {
+    if (load_binary_ledger()) return;
+    load_found_records(); load_jump_records(); load_track_records();
+    if (!ledger_open_files(0, 0)) {
+        ledger_mark_found_persisted();
+        ledger_mark_jump_persisted();
+        ledger_mark_track_persisted();
+        return;
+    }
+    /* The JSONL files already hold these records, and the queue is not loaded yet. */
+    ttak_mutex_lock(&g_disk_lock);
+    persist_found_records(); persist_jump_records(); persist_track_records();
+    ledger_buf_t batch = {0};
+    ttak_owner_execute(g_ledger_owner, "take_pending", LEDGER_RESOURCE_NAME, &batch);
+    ledger_write_batch(&batch, false);
+    ledger_buf_free(&batch);
+    ttak_mutex_unlock(&g_disk_lock);
+}
+
+static bool enqueue_job(aliquot_job_t *job) {
     if (!job || !g_thread_pool) return false;
     if (!pending_queue_add(&job->seed)) return false;
     uint64_t now = monotonic_millis();
@@ -1762,8 +2388,47 @@ static bool enqueue_job(aliquot_job_t *job, const char *source_tag) {
     return true;
 }
 
+static void enqueue_checkpoint_seed(const ttak_bigint_t *seed, uint64_t now) {
+    if (!seed_registry_try_add(seed)) return;
+    aliquot_job_t *job = ttak_mem_alloc_raw(sizeof(aliquot_job_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!job) return;
+    memset(job, 0, sizeof(*job));
+    ttak_bigint_init_copy(&job->seed, seed, now);
+    job->priority = 1;
+    snprintf(job->provenance, sizeof(job->provenance), "checkpoint");
+    if (!enqueue_job(job)) {
+        ttak_bigint_free(&job->seed, now);
+        ttak_mem_free(job);
+    }
+}
+
+static bool load_queue_binary(void) {
+    FILE *fp = fopen(g_queue_bin_path, "rb");
+    if (!fp) return false;
+    fseek(fp, 0, SEEK_END); long sz = ftell(fp);
+    if (sz < 12) { fclose(fp); return false; }
+    rewind(fp); uint64_t now = monotonic_millis();
+    uint8_t *buf = ttak_mem_alloc_raw((size_t)sz, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!buf) { fclose(fp); return false; }
+    size_t got = fread(buf, 1, (size_t)sz, fp); fclose(fp);
+    bool ok = got == (size_t)sz && memcmp(buf, QUEUE_MAGIC, 8) == 0;
+    if (ok) {
+        ledger_reader_t r = {buf + 8, got - 8, true};
+        uint32_t count = ledger_get_u32(&r);
+        for (uint32_t i = 0; i < count && r.ok; ++i) {
+            ttak_bigint_t seed;
+            ledger_get_bigint(&r, &seed, now);
+            if (r.ok) enqueue_checkpoint_seed(&seed, now);
+            ttak_bigint_free(&seed, now);
+        }
+    }
+    ttak_mem_free(buf);
+    return ok;
+}
+
 static void load_queue_checkpoint(void) {
     if (!g_thread_pool) return;
+    if (load_queue_binary()) return;
     FILE *fp = fopen(g_queue_state_path, "r");
     if (!fp) return;
     fseek(fp, 0, SEEK_END); long sz = ftell(fp); if (sz <= 0) { fclose(fp); return; }
@@ -1787,19 +2452,7 @@ static void load_queue_checkpoint(void) {
                         memcpy(s_seed, start, len); s_seed[len] = '\0';
                         ttak_bigint_t seed;
                         if (ttak_bigint_init_from_string(&seed, s_seed, now)) {
-                            if (seed_registry_try_add(&seed)) {
-                                aliquot_job_t *job = ttak_mem_alloc_raw(sizeof(aliquot_job_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-                                if (job) {
-                                    memset(job, 0, sizeof(*job));
-                                    ttak_bigint_init_copy(&job->seed, &seed, now);
-                                    job->priority = 1;
-                                    snprintf(job->provenance, sizeof(job->provenance), "checkpoint");
-                                    if (!enqueue_job(job, "checkpoint")) {
-                                        ttak_bigint_free(&job->seed, now);
-                                        ttak_mem_free(job);
-                                    }
-                                }
-                            }
+                            enqueue_checkpoint_seed(&seed, now);
                             ttak_bigint_free(&seed, now);
                         }
                     }
@@ -1811,6 +2464,269 @@ static void load_queue_checkpoint(void) {
     ttak_mem_free(buf);
 }
 
+/*
+ * Cluster mode. One node runs with ALIQUOT_CLUSTER_LISTEN=[host:]port and
+ * coordinates: it leases ALIQUOT_CLUSTER_RANGE (lo-hi, default the scout
+ * range) to worker nodes in blocks of CLUSTER_LEASE_SEEDS and stores the
+ * found records they upload in its own ledger. Worker nodes run with
+ * ALIQUOT_CLUSTER_COORDINATOR=host:port, feed the thread pool from their
+ * leases instead of the scouts, and upload each found record as its
+ * encoded ledger record. A coordinator whose ledger writer falls
+ * CLUSTER_BACKLOG_MAX records behind refuses uploads until it catches up,
+ * which stalls the workers' pool threads in cluster_upload_found().
+ */
+typedef enum {
+    CLUSTER_OFF = 0,
+    CLUSTER_COORDINATOR,
+    CLUSTER_WORKER
+} cluster_role_t;
+
+typedef struct {
+    uint64_t id;                /* 0 while the slot is free. */
+    uint64_t outstanding;       /* Jobs queued from the lease and not finished. */
+    bool fed;                   /* Every seed of the lease has been queued. */
+} cluster_lease_t;
+
+static cluster_role_t g_cluster_role;
+static ttak_owner_t *g_cluster_owner;
+static ttak_shared_net_endpoint_t *g_cluster_endpoint;
+static ttak_net_workq_coord_t *g_cluster_coord;
+static ttak_net_workq_worker_t *g_cluster_worker;
+static pthread_t g_cluster_thread;
+static bool g_cluster_thread_running;
+static cluster_lease_t g_cluster_leases[TTAK_NET_WORKQ_MAX_WORKER_LEASES];
+static ttak_mutex_t g_cluster_lock = PTHREAD_MUTEX_INITIALIZER;
+static ttak_net_workq_lease_t g_cluster_feed;
+static uint64_t g_cluster_feed_next;
+static bool g_cluster_feeding;
+static bool g_cluster_finished;
+
+static bool cluster_resolve(const char *spec, bool passive, struct addrinfo **out) {
+    char host[256];
+    const char *port = strrchr(spec, ':');
+    if (port) {
+        size_t n = (size_t)(port - spec);
+        if (n >= sizeof(host)) return false;
+        memcpy(host, spec, n);
+        host[n] = '\0';
+        port++;
+    } else {
+        host[0] = '\0';
+        port = spec;
+    }
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (passive) hints.ai_flags = AI_PASSIVE;
+    return getaddrinfo(host[0] ? host : NULL, port, &hints, out) == 0;
+}
+
+static bool cluster_sink(const ttak_net_workq_result_t *res, size_t n, void *arg) {
+    (void)arg;
+    ttak_mutex_lock(&g_ledger_state.lock);
+    size_t backlog = g_ledger_state.found_count - g_ledger_state.persisted_found_count;
+    ttak_mutex_unlock(&g_ledger_state.lock);
+    if (backlog >= CLUSTER_BACKLOG_MAX) {
+        pthread_mutex_lock(&g_ledger_wake_lock);
+        pthread_cond_signal(&g_ledger_wake);
+        pthread_mutex_unlock(&g_ledger_wake_lock);
+        return false;
+    }
+    uint64_t now = monotonic_millis();
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t kind, len;
+        if (res[i].len < LEDGER_REC_HEAD) continue;
+        memcpy(&kind, res[i].data, sizeof(kind));
+        memcpy(&len, (const uint8_t *)res[i].data + 4, sizeof(len));
+        if (kind != LEDGER_KIND_FOUND || len != res[i].len - LEDGER_REC_HEAD) continue;
+        ledger_reader_t r = {(const uint8_t *)res[i].data + LEDGER_REC_HEAD, len, true};
+        found_record_t rec;
+        if (ledger_decode_found(&r, &rec, now) && ledger_store_found_record(&rec)) {
+            seed_registry_mark(&rec.seed);
+            ttak_atomic_inc64(&g_total_sequences);
+        }
+        ledger_free_found(&rec, now);
+    }
+    maybe_flush_ledgers();
+    return true;
+}
+
+static void *cluster_poll_main(void *arg) {
+    (void)arg;
+    while (!ttak_atomic_read64(&shutdown_requested)) {
+        uint64_t now = monotonic_millis();
+        if (g_cluster_coord) ttak_net_workq_coord_poll(g_cluster_coord, CLUSTER_POLL_MS, now);
+        else ttak_net_workq_worker_poll(g_cluster_worker, CLUSTER_POLL_MS, now);
+    }
+    return NULL;
+}
+
+/* Picks the role from the environment; false only when a requested role cannot start. */
+static bool cluster_start(void) {
+    const char *listen_spec = getenv(CLUSTER_LISTEN_ENV);
+    const char *coord_spec = getenv(CLUSTER_COORD_ENV);
+    if (!listen_spec && !coord_spec) return true;
+    struct addrinfo *ai = NULL;
+    if (!cluster_resolve(listen_spec ? listen_spec : coord_spec, listen_spec != NULL, &ai)) {
+        fprintf(stderr, "[ALIQUOT] Cannot resolve cluster address %s\n", listen_spec ? listen_spec : coord_spec);
+        return false;
+    }
+    int fd = socket(ai->ai_family, SOCK_DGRAM, 0);
+    bool ok = fd >= 0 && (listen_spec ? bind(fd, ai->ai_addr, ai->ai_addrlen) : connect(fd, ai->ai_addr, ai->ai_addrlen)) == 0;
+    uint64_t now = monotonic_millis();
+    g_cluster_owner = ok ? ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT) : NULL;
+    g_cluster_endpoint = g_cluster_owner ? ttak_net_endpoint_create(g_cluster_owner, now) : NULL;
+    ok = g_cluster_endpoint &&
+         ttak_net_endpoint_bind_fd(g_cluster_endpoint, g_cluster_owner, fd, ai->ai_family, SOCK_DGRAM, 0,
+                                   ai->ai_addr, (uint8_t)ai->ai_addrlen,
+                                   ai->ai_family == AF_INET6 ? TTAK_NET_ENDPOINT_IPV6 : TTAK_NET_ENDPOINT_IPV4,
+                                   UINT64_MAX, now) == TTAK_IO_SUCCESS;
+    freeaddrinfo(ai);
+    if (!ok) {
+        fprintf(stderr, "[ALIQUOT] Cluster socket setup failed: %s\n", strerror(errno));
+        if (!g_cluster_endpoint && fd >= 0) close(fd);
+        return false;
+    }
+
+    if (listen_spec) {
+        ttak_net_workq_coord_config_t cfg = {0};
+        cfg.first_seed = SCOUT_MIN_SEED;
+        cfg.end_seed = SCOUT_MAX_SEED;
+        const char *range = getenv(CLUSTER_RANGE_ENV);
+        if (range && sscanf(range, "%" SCNu64 "-%" SCNu64, &cfg.first_seed, &cfg.end_seed) != 2) {
+            fprintf(stderr, "[ALIQUOT] %s must look like lo-hi\n", CLUSTER_RANGE_ENV);
+            return false;
+        }
+        cfg.lease_seeds = CLUSTER_LEASE_SEEDS;
+        cfg.sink = cluster_sink;
+        g_cluster_coord = ttak_net_workq_coord_create(&cfg, g_cluster_endpoint, g_cluster_owner);
+        if (!g_cluster_coord) return false;
+        g_cluster_role = CLUSTER_COORDINATOR;
+        printf("[ALIQUOT] Coordinating seeds %" PRIu64 "..%" PRIu64 " on %s\n", cfg.first_seed, cfg.end_seed, listen_spec);
+    } else {
+        g_cluster_worker = ttak_net_workq_worker_create(NULL, g_cluster_endpoint, g_cluster_owner, NULL, 0);
+        if (!g_cluster_worker) return false;
+        g_cluster_role = CLUSTER_WORKER;
+        printf("[ALIQUOT] Working for coordinator %s as %016" PRIx64 "\n", coord_spec,
+               ttak_net_workq_worker_id(g_cluster_worker));
+    }
+    g_cluster_thread_running = pthread_create(&g_cluster_thread, NULL, cluster_poll_main, NULL) == 0;
+    return g_cluster_thread_running;
+}
+
+static void cluster_stop(void) {
+    if (g_cluster_thread_running) pthread_join(g_cluster_thread, NULL);
+    g_cluster_thread_running = false;
+    ttak_net_workq_coord_destroy(g_cluster_coord);
+    ttak_net_workq_worker_destroy(g_cluster_worker);
+    g_cluster_coord = NULL;
+    g_cluster_worker = NULL;
+    if (g_cluster_endpoint) ttak_net_endpoint_destroy(g_cluster_endpoint, g_cluster_owner, monotonic_millis());
+    if (g_cluster_owner) ttak_owner_destroy(g_cluster_owner);
+    g_cluster_endpoint = NULL;
+    g_cluster_owner = NULL;
+}
+
+/* Uploads a found record, waiting out coordinator backpressure unless shutting down. */
+static void cluster_upload_found(const found_record_t *rec, uint64_t lease) {
+    if (!g_cluster_worker || lease == 0) return;
+    ledger_buf_t b = {0};
+    ledger_encode_found(&b, rec);
+    if (!b.failed && b.len <= TTAK_NET_WORKQ_MAX_RECORD) {
+        while (ttak_net_workq_worker_submit(g_cluster_worker, lease, b.data, (uint32_t)b.len, CLUSTER_WAIT_NS) ==
+                   TTAK_NET_WORKQ_TIMEOUT &&
+               !ttak_atomic_read64(&shutdown_requested)) {
+        }
+    }
+    ledger_buf_free(&b);
+}
+
+static cluster_lease_t *cluster_lease_find_locked(uint64_t id) {
+    for (size_t i = 0; i < TTAK_NET_WORKQ_MAX_WORKER_LEASES; ++i) {
+        if (g_cluster_leases[i].id == id) return &g_cluster_leases[i];
+    }
+    return NULL;
+}
+
+static void cluster_complete(uint64_t lease) {
+    while (ttak_net_workq_worker_complete(g_cluster_worker, lease, CLUSTER_WAIT_NS) == TTAK_NET_WORKQ_TIMEOUT &&
+           !ttak_atomic_read64(&shutdown_requested)) {
+    }
+}
+
+/* Counts one finished job against its lease, completing the lease after its last. */
+static void cluster_seed_done(uint64_t lease) {
+    if (!g_cluster_worker || lease == 0) return;
+    bool complete = false;
+    ttak_mutex_lock(&g_cluster_lock);
+    cluster_lease_t *l = cluster_lease_find_locked(lease);
+    if (l && l->outstanding > 0 && --l->outstanding == 0 && l->fed) {
+        l->id = 0;
+        complete = true;
+    }
+    ttak_mutex_unlock(&g_cluster_lock);
+    if (complete) cluster_complete(lease);
+}
+
+/* Queues up to @p room seeds from the worker's leases; returns how many. */
+static size_t cluster_feed(size_t room) {
+    size_t fed = 0;
+    uint64_t now = monotonic_millis();
+    while (fed < room) {
+        if (!g_cluster_feeding) {
+            ttak_net_workq_status_t st = ttak_net_workq_worker_acquire(g_cluster_worker, &g_cluster_feed, 0);
+            if (st == TTAK_NET_WORKQ_FINISHED) g_cluster_finished = true;
+            if (st != TTAK_NET_WORKQ_OK) break;
+            ttak_mutex_lock(&g_cluster_lock);
+            cluster_lease_t *slot = cluster_lease_find_locked(0);
+            if (slot) *slot = (cluster_lease_t){ .id = g_cluster_feed.id, .outstanding = 0, .fed = false };
+            ttak_mutex_unlock(&g_cluster_lock);
+            g_cluster_feed_next = g_cluster_feed.start;
+            g_cluster_feeding = true;
+        }
+        if (g_cluster_feed_next == g_cluster_feed.start + g_cluster_feed.count) {
+            bool complete = false;
+            ttak_mutex_lock(&g_cluster_lock);
+            cluster_lease_t *l = cluster_lease_find_locked(g_cluster_feed.id);
+            if (l) {
+                l->fed = true;
+                if (l->outstanding == 0) {
+                    l->id = 0;
+                    complete = true;
+                }
+            }
+            ttak_mutex_unlock(&g_cluster_lock);
+            if (complete) cluster_complete(g_cluster_feed.id);
+            g_cluster_feeding = false;
+            continue;
+        }
+        aliquot_job_t *job = ttak_mem_alloc_raw(sizeof(aliquot_job_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (!job) break;
+        memset(job, 0, sizeof(*job));
+        ttak_bigint_init_u64(&job->seed, g_cluster_feed_next, now);
+        job->priority = 1;
+        job->lease = g_cluster_feed.id;
+        snprintf(job->provenance, sizeof(job->provenance), "cluster");
+        ttak_mutex_lock(&g_cluster_lock);
+        cluster_lease_t *l = cluster_lease_find_locked(job->lease);
+        if (l) l->outstanding++;
+        ttak_mutex_unlock(&g_cluster_lock);
+        if (!enqueue_job(job)) {
+            // Queue full: take the count back and retry this seed on the next pass.
+            ttak_mutex_lock(&g_cluster_lock);
+            if (l && l->id == job->lease) l->outstanding--;
+            ttak_mutex_unlock(&g_cluster_lock);
+            ttak_bigint_free(&job->seed, now);
+            ttak_mem_free(job);
+            break;
+        }
+        g_cluster_feed_next++;
+        fed++;
+    }
+    return fed;
+}
+
 static void *worker_process_job_wrapper(void *arg) {
     aliquot_job_t *job = (aliquot_job_t *)arg;
     process_job(job);
@@ -1844,8 +2760,9 @@ static void process_job(const aliquot_job_t *job) {
             memset(retry, 0, sizeof(*retry));
             ttak_bigint_init_copy(&retry->seed, &job->seed, monotonic_millis());
             retry->priority = 10;
+            retry->lease = job->lease;
             retry->scout_score = job->scout_score; snprintf(retry->provenance, sizeof(retry->provenance), "retry-big");
-            if (enqueue_job(retry, "retry-limit")) {
+            if (enqueue_job(retry)) {
                 append_track_record(&outcome, job, budget_ms); maybe_flush_ledgers(); aliquot_outcome_cleanup(&outcome);
                 return;
             } else {
@@ -1854,10 +2771,11 @@ static void process_job(const aliquot_job_t *job) {
             }
         }
     }
-    append_found_record(&outcome, job->provenance);
+    append_found_record(&outcome, job->provenance, job->lease);
     append_track_record(&outcome, job, budget_ms);
     maybe_flush_ledgers();
     aliquot_outcome_cleanup(&outcome);
+    cluster_seed_done(job->lease);
 }
 
 static void *scout_main(void *arg) {
@@ -1907,7 +2825,7 @@ static void *scout_main(void *arg) {
                 job->preview_overflow = probe.overflow || (op >= 45.0);
                 job->scout_score = score;
                 snprintf(job->provenance, sizeof(job->provenance), "scout");
-                if (!enqueue_job(job, "scout")) {
+                if (!enqueue_job(job)) {
                     ttak_bigint_free(&job->seed, now);
                     ttak_mem_free(job);
                 } else maybe_flush_ledgers();
@@ -1931,7 +2849,8 @@ int main(void) {
     if (!ledger_init_owner()) return 1;
     struct sigaction sa = {0}; sa.sa_handler = handle_signal; sigaction(SIGINT, &sa, NULL); sigaction(SIGTERM, &sa, NULL);
     ttak_atomic_write64(&g_last_persist_ms, monotonic_millis());
-    load_found_records(); load_jump_records(); load_track_records();
+    load_ledgers();
+    g_ledger_writer_running = pthread_create(&g_ledger_writer, NULL, ledger_writer_main, NULL) == 0;
 
     long cpus = sysconf(_SC_NPROCESSORS_ONLN);
     if (cpus < 1) {
@@ -1942,6 +2861,11 @@ int main(void) {
     }
     g_thread_pool = ttak_thread_pool_create((size_t)cpus, 0, monotonic_millis());
     if (!g_thread_pool) return 1;
+    g_factor_cache = ttak_factor_cache_create(FACTOR_CACHE_ENTRIES, g_factor_cache_path, monotonic_millis());
+    if (!g_factor_cache) {
+        fprintf(stderr, "[ALIQUOT] Factor cache store %s unavailable; caching in memory only.\n", g_factor_cache_path);
+        g_factor_cache = ttak_factor_cache_create(FACTOR_CACHE_ENTRIES, NULL, monotonic_millis());
+    }
 
     int num_scouts = (cpus > 4) ? 2 : 1;
     size_t slot_cap = (size_t)cpus + (size_t)num_scouts + 4;
@@ -1951,14 +2875,16 @@ int main(void) {
     }
 
     load_queue_checkpoint();
-    
-    pthread_t scout_threads[num_scouts];
+    if (!cluster_start()) return 1;
+    if (g_cluster_role != CLUSTER_OFF) num_scouts = 0;
+
+    pthread_t scout_threads[num_scouts > 0 ? num_scouts : 1];
     for (int i = 0; i < num_scouts; i++) {
         pthread_create(&scout_threads[i], NULL, scout_main, NULL);
     }
 
     /* SELF-SEEDING BOOTSTRAP: Ensure we have work immediately */
-    if (pending_queue_depth() == 0) {
+    if (g_cluster_role == CLUSTER_OFF && pending_queue_depth() == 0) {
         printf("[ALIQUOT] Warm-up: Seeding initial jobs manually...\n");
         for (int i = 0; i < (int)cpus; i++) {
             uint64_t now = monotonic_millis();
@@ -1973,7 +2899,7 @@ int main(void) {
                     ttak_bigint_init_copy(&job->seed, &seed, now);
                     job->priority = 1;
                     snprintf(job->provenance, sizeof(job->provenance), "warmup");
-                    if (!enqueue_job(job, "warmup")) {
+                    if (!enqueue_job(job)) {
                         ttak_bigint_free(&job->seed, now);
                         ttak_mem_free(job);
                     }
@@ -1986,15 +2912,33 @@ int main(void) {
     uint64_t status_last_ms = monotonic_millis();
     uint64_t status_last_probes = ttak_atomic_read64(&g_total_probes) + progress_slots_pending_total();
     double status_rate = 0.0;
+    uint64_t cluster_done_ms = 0;
 
     while (!ttak_atomic_read64(&shutdown_requested)) {
         size_t qd = pending_queue_depth();
 
+        if (g_cluster_role == CLUSTER_COORDINATOR) {
+            // Linger after the last lease so workers hear that the range is done.
+            if (!cluster_done_ms && ttak_net_workq_coord_finished(g_cluster_coord)) {
+                cluster_done_ms = monotonic_millis();
+                printf("[ALIQUOT] Cluster range complete.\n");
+            }
+            if (cluster_done_ms && monotonic_millis() - cluster_done_ms >= CLUSTER_LINGER_MS) {
+                ttak_atomic_write64(&shutdown_requested, 1);
+            }
+        } else if (g_cluster_role == CLUSTER_WORKER) {
+            if (qd < (size_t)cpus * 2) qd += cluster_feed((size_t)cpus * 2 - qd);
+            if (g_cluster_finished && qd == 0 && ttak_net_workq_worker_finished(g_cluster_worker)) {
+                printf("[ALIQUOT] Coordinator reports the range complete.\n");
+                ttak_atomic_write64(&shutdown_requested, 1);
+            }
+        }
+
         /* ACTIVE SCHEDULING: Hunt for seeds if queue is low */
         // Actively try to fill the queue up to a certain threshold to keep workers busy.
         // The cpus variable determines how many parallel jobs the thread pool can handle.
         // We want to keep at least 'cpus' number of jobs in queue.
-        while (qd < (size_t)cpus * 2 && qd < JOB_QUEUE_CAP) {
+        while (g_cluster_role == CLUSTER_OFF && qd < (size_t)cpus * 2 && qd < JOB_QUEUE_CAP) {
             uint64_t now = monotonic_millis();
             uint64_t rand_seed_val = random_seed_between(SCOUT_MIN_SEED, SCOUT_MAX_SEED);
             ttak_bigint_t seed;
@@ -2007,7 +2951,7 @@ int main(void) {
                     ttak_bigint_init_copy(&job->seed, &seed, now);
                     job->priority = 1;
                     snprintf(job->provenance, sizeof(job->provenance), "main_hunt");
-                    if (!enqueue_job(job, "main_hunt")) {
+                    if (!enqueue_job(job)) {
                         ttak_bigint_free(&job->seed, now);
                         ttak_mem_free(job);
                     } else {
@@ -2061,7 +3005,18 @@ int main(void) {
         _exit(2);
     }
     ttak_thread_pool_destroy(g_thread_pool);
+    cluster_stop();
+    ttak_factor_cache_destroy(g_factor_cache, monotonic_millis());
+    g_factor_cache = NULL;
+    if (g_ledger_writer_running) {
+        pthread_mutex_lock(&g_ledger_wake_lock);
+        pthread_cond_signal(&g_ledger_wake);
+        pthread_mutex_unlock(&g_ledger_wake_lock);
+        pthread_join(g_ledger_writer, NULL);
+        g_ledger_writer_running = false;
+    }
     flush_ledgers();
+    ledger_close_files();
     ledger_destroy_owner();
     if (g_progress_slots) {
         ttak_mem_free(g_progress_slots);
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""Compare a bench_harness JSON run against a stored baseline and flag regressions."""
+
+from __future__ import annotations
+
+import argparse
+import json
+import sys
+from pathlib import Path
+
+
+def load(path: Path) -> dict[str, dict]:
+    with path.open() as fh:
+        doc = json.load(fh)
+    return {row["name"]: row for row in doc.get("results", [])}
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument("baseline", type=Path)
+    ap.add_argument("current", type=Path)
+    ap.add_argument("--threshold", type=float, default=0.10,
+                    help="relative slowdown of the median that counts as a regression (default 0.10)")
+    args = ap.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+    regressions = 0
+
+    print(f"  {'benchmark':<34} {'baseline':>12} {'current':>12} {'change':>9}")
+    for name, row in cur.items():
+        old = base.get(name)
+        if old is None:
+            print(f"  {name:<34} {'-':>12} {row['median_ns']:>12.1f} {'new':>9}")
+            continue
+        ratio = row["median_ns"] / old["median_ns"] if old["median_ns"] > 0 else 1.0
+        # A slowdown only counts when the median CIs do not overlap, so a noisy
+        # case has to move clearly before it fails the gate.
+        slower = ratio > 1.0 + args.threshold and row["ci_lo_ns"] > old["ci_hi_ns"]
+        mark = "  REGRESSION" if slower else ""
+        regressions += slower
+        print(f"  {name:<34} {old['median_ns']:>12.1f} {row['median_ns']:>12.1f} {100.0 * (ratio - 1.0):>+8.1f}%{mark}")
+    for name in base.keys() - cur.keys():
+        print(f"  {name:<34} {base[name]['median_ns']:>12.1f} {'-':>12} {'gone':>9}")
+
+    if regressions:
+        print(f"{regressions} benchmark(s) regressed by more than {100.0 * args.threshold:.0f}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,316 @@
+/**
+ * @file bench_harness.h
+ * @brief Header-only harness for named, repeatable libttak benchmarks.
+ *
+ * A case runs its body @c st->iters times per call. The runner calibrates
+ * the iteration count until one repetition lasts at least the minimum
+ * repetition time, discards the warmup repetitions, and summarises the
+ * remaining per-repetition ns/op samples: median, p99, mean, standard
+ * deviation and a distribution-free 95% confidence interval for the median.
+ *
+ * Results print as an aligned table, JSON or CSV. The JSON form is what
+ * bench_compare.py diffs against a stored baseline.
+ *
+ * With --perf the timed repetitions also run under the ttak_perf hardware
+ * counters and every result adds IPC and cache and branch misses per
+ * iteration. Counters the host refuses report as zero.
+ */
+
+#ifndef TTAK_BENCH_HARNESS_H
+#define TTAK_BENCH_HARNESS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <ttak/stats/perf.h>
+
+/**
+ * @brief Prevent the compiler from optimizing away observable variables.
+ */
+#ifndef KEEP
+#define KEEP(var) __asm__ volatile("" : : "g"(var) : "memory")
+#endif
+
+#define TTAK_BENCH_MAX_REPS 1000
+
+/**
+ * @brief Per-call state handed to a case body.
+ */
+typedef struct ttak_bench_state {
+    uint64_t iters;  /**< Iterations this call must run. */
+    uint64_t sink;   /**< Fold results here so the work stays observable. */
+    uintptr_t param; /**< Copied from the case (operand size, thread count...). */
+    void *arg;       /**< Whatever setup returned. */
+} ttak_bench_state_t;
+
+/**
+ * @brief One named benchmark.
+ *
+ * Names are "subsystem/what"; the filter matches any substring of them.
+ */
+typedef struct ttak_bench_case {
+    const char *name;
+    void (*run)(ttak_bench_state_t *st);
+    void *(*setup)(uintptr_t param);   /**< Optional; NULL return skips the case. */
+    void (*teardown)(void *arg);       /**< Optional. */
+    uintptr_t param;
+} ttak_bench_case_t;
+
+typedef enum {
+    TTAK_BENCH_FMT_TEXT = 0,
+    TTAK_BENCH_FMT_JSON,
+    TTAK_BENCH_FMT_CSV
+} ttak_bench_format_t;
+
+typedef struct ttak_bench_opts {
+    size_t warmup;          /**< Repetitions run and discarded. */
+    size_t reps;            /**< Repetitions summarised. */
+    uint64_t min_rep_ns;    /**< Calibration target for one repetition. */
+    const char *filter;     /**< Substring filter on case names; NULL runs all. */
+    const char *suite;      /**< Suite name written into JSON output. */
+    ttak_bench_format_t format;
+    bool list;              /**< Print case names and exit. */
+    bool perf;              /**< Read hardware counters around the timed repetitions. */
+    FILE *out;
+} ttak_bench_opts_t;
+
+typedef struct ttak_bench_result {
+    const char *name;
+    uint64_t iters;   /**< Iterations per repetition. */
+    size_t reps;
+    double median, p99, mean, stddev, min, max; /**< ns per iteration. */
+    double ci_lo, ci_hi;                        /**< 95% CI of the median. */
+    double ipc;                                 /**< Instructions per cycle; --perf only. */
+    double cache_misses, branch_misses;         /**< Per iteration; --perf only. */
+} ttak_bench_result_t;
+
+/**
+ * @brief Monotonic clock in nanoseconds, independent of the library's tick source.
+ */
+static inline uint64_t ttak_bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline int ttak_bench_cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Linear-interpolated quantile of a sorted sample.
+ */
+static inline double ttak_bench_quantile(const double *sorted, size_t n, double q) {
+    if (n == 0) return 0.0;
+    double pos = q * (double)(n - 1);
+    size_t lo = (size_t)pos;
+    size_t hi = lo + 1 < n ? lo + 1 : lo;
+    double frac = pos - (double)lo;
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+/**
+ * @brief Summarises @p n samples; sorts them in place.
+ *
+ * The median CI uses the order statistics at n/2 -+ 0.98 sqrt(n), the
+ * normal approximation to the binomial, so it holds without assuming the
+ * timings are normally distributed.
+ */
+static inline void ttak_bench_summarise(double *samples, size_t n, ttak_bench_result_t *r) {
+    qsort(samples, n, sizeof(double), ttak_bench_cmp_double);
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) sum += samples[i];
+    r->mean = n ? sum / (double)n : 0.0;
+    double var = 0.0;
+    for (size_t i = 0; i < n; i++) var += (samples[i] - r->mean) * (samples[i] - r->mean);
+    r->stddev = n > 1 ? sqrt(var / (double)(n - 1)) : 0.0;
+    r->median = ttak_bench_quantile(samples, n, 0.5);
+    r->p99 = ttak_bench_quantile(samples, n, 0.99);
+    r->min = n ? samples[0] : 0.0;
+    r->max = n ? samples[n - 1] : 0.0;
+    double half = 0.98 * sqrt((double)n);
+    double lo = floor((double)n / 2.0 - half);
+    double hi = ceil((double)n / 2.0 + half);
+    if (lo < 0.0) lo = 0.0;
+    if (hi > (double)(n ? n - 1 : 0)) hi = (double)(n ? n - 1 : 0);
+    r->ci_lo = n ? samples[(size_t)lo] : 0.0;
+    r->ci_hi = n ? samples[(size_t)hi] : 0.0;
+}
+
+static inline void ttak_bench_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--json|--csv] [--filter=SUBSTR] [--reps=N] [--warmup=N]\n"
+            "          [--min-time-ms=MS] [--perf] [--list]\n", prog);
+}
+
+/**
+ * @brief Fills @p o from the command line; returns false on a bad flag.
+ */
+static inline bool ttak_bench_parse_args(int argc, char **argv, ttak_bench_opts_t *o) {
+    if (!o->reps) o->reps = 20;
+    if (!o->warmup) o->warmup = 2;
+    if (!o->min_rep_ns) o->min_rep_ns = 5000000ULL;
+    if (!o->out) o->out = stdout;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (strcmp(a, "--json") == 0) o->format = TTAK_BENCH_FMT_JSON;
+        else if (strcmp(a, "--csv") == 0) o->format = TTAK_BENCH_FMT_CSV;
+        else if (strcmp(a, "--list") == 0) o->list = true;
+        else if (strcmp(a, "--perf") == 0) o->perf = true;
+        else if (strncmp(a, "--filter=", 9) == 0) o->filter = a + 9;
+        else if (strncmp(a, "--reps=", 7) == 0) o->reps = strtoul(a + 7, NULL, 10);
+        else if (strncmp(a, "--warmup=", 9) == 0) o->warmup = strtoul(a + 9, NULL, 10);
+        else if (strncmp(a, "--min-time-ms=", 14) == 0) o->min_rep_ns = strtoull(a + 14, NULL, 10) * 1000000ULL;
+        else {
+            ttak_bench_usage(argv[0]);
+            return false;
+        }
+    }
+    if (o->reps < 1) o->reps = 1;
+    if (o->reps > TTAK_BENCH_MAX_REPS) o->reps = TTAK_BENCH_MAX_REPS;
+    return true;
+}
+
+static inline uint64_t ttak_bench_time_once(const ttak_bench_case_t *c, ttak_bench_state_t *st, uint64_t iters) {
+    st->iters = iters;
+    uint64_t t0 = ttak_bench_now_ns();
+    c->run(st);
+    uint64_t t1 = ttak_bench_now_ns();
+    KEEP(st->sink);
+    return t1 - t0;
+}
+
+/**
+ * @brief Runs one case: calibrate, warm up, then time @c reps repetitions.
+ * @return False if setup declined the case.
+ */
+static inline bool ttak_bench_run_case(const ttak_bench_case_t *c, const ttak_bench_opts_t *o, ttak_bench_result_t *r) {
+    ttak_bench_state_t st = { .param = c->param };
+    if (c->setup) {
+        st.arg = c->setup(c->param);
+        if (!st.arg) return false;
+    }
+
+    /* The first call pays for lazy initialisation; keep it out of calibration. */
+    ttak_bench_time_once(c, &st, 1);
+    uint64_t iters = 1;
+    for (;;) {
+        uint64_t ns = ttak_bench_time_once(c, &st, iters);
+        if (ns >= o->min_rep_ns || iters >= (1ULL << 40)) break;
+        /* Aim straight for the target once the timing is meaningful. */
+        if (ns > o->min_rep_ns / 16) {
+            uint64_t want = (uint64_t)((double)iters * (double)o->min_rep_ns / (double)ns * 1.1) + 1;
+            iters = want > iters ? want : iters * 2;
+        } else {
+            iters *= 8;
+        }
+    }
+    for (size_t i = 0; i < o->warmup; i++) ttak_bench_time_once(c, &st, iters);
+
+    double samples[TTAK_BENCH_MAX_REPS];
+    ttak_perf_sample_t pc0, pc1;
+    if (o->perf) ttak_perf_read(&pc0);
+    for (size_t i = 0; i < o->reps; i++) {
+        samples[i] = (double)ttak_bench_time_once(c, &st, iters) / (double)iters;
+    }
+    if (o->perf) ttak_perf_read(&pc1);
+    if (c->teardown) c->teardown(st.arg);
+
+    memset(r, 0, sizeof(*r));
+    if (o->perf) {
+        /* Counters are per thread, so a case that fans out only sees its caller. */
+        double ops = (double)iters * (double)o->reps;
+        double cycles = (double)(pc1.value[TTAK_PERF_CYCLES] - pc0.value[TTAK_PERF_CYCLES]);
+        double insns = (double)(pc1.value[TTAK_PERF_INSTRUCTIONS] - pc0.value[TTAK_PERF_INSTRUCTIONS]);
+        r->ipc = cycles > 0.0 ? insns / cycles : 0.0;
+        r->cache_misses = (double)(pc1.value[TTAK_PERF_CACHE_MISSES] - pc0.value[TTAK_PERF_CACHE_MISSES]) / ops;
+        r->branch_misses = (double)(pc1.value[TTAK_PERF_BRANCH_MISSES] - pc0.value[TTAK_PERF_BRANCH_MISSES]) / ops;
+    }
+    r->name = c->name;
+    r->iters = iters;
+    r->reps = o->reps;
+    ttak_bench_summarise(samples, o->reps, r);
+    return true;
+}
+
+static inline void ttak_bench_emit_header(const ttak_bench_opts_t *o) {
+    if (o->format == TTAK_BENCH_FMT_CSV) {
+        fprintf(o->out, "name,iters,reps,median_ns,p99_ns,mean_ns,stddev_ns,min_ns,max_ns,ci_lo_ns,ci_hi_ns%s\n",
+                o->perf ? ",ipc,cache_misses_per_op,branch_misses_per_op" : "");
+    } else if (o->format == TTAK_BENCH_FMT_JSON) {
+        char host[256] = "unknown";
+        gethostname(host, sizeof(host) - 1);
+        fprintf(o->out, "{\n  \"suite\": \"%s\",\n  \"host\": \"%s\",\n  \"reps\": %zu,\n  \"results\": [",
+                o->suite ? o->suite : "bench", host, o->reps);
+    } else {
+        fprintf(o->out, "  %-34s %12s %12s %12s %25s", "benchmark", "median ns", "p99 ns", "stddev", "95% CI (median)");
+        if (o->perf) fprintf(o->out, " %6s %10s %10s", "ipc", "cmiss/op", "bmiss/op");
+        fputc('\n', o->out);
+    }
+}
+
+static inline void ttak_bench_emit(const ttak_bench_opts_t *o, const ttak_bench_result_t *r, bool first) {
+    if (o->format == TTAK_BENCH_FMT_CSV) {
+        fprintf(o->out, "%s,%" PRIu64 ",%zu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f", r->name, r->iters, r->reps,
+                r->median, r->p99, r->mean, r->stddev, r->min, r->max, r->ci_lo, r->ci_hi);
+        if (o->perf) fprintf(o->out, ",%.3f,%.4f,%.4f", r->ipc, r->cache_misses, r->branch_misses);
+        fputc('\n', o->out);
+    } else if (o->format == TTAK_BENCH_FMT_JSON) {
+        fprintf(o->out,
+                "%s\n    {\"name\": \"%s\", \"iters\": %" PRIu64 ", \"reps\": %zu, \"median_ns\": %.3f, "
+                "\"p99_ns\": %.3f, \"mean_ns\": %.3f, \"stddev_ns\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, "
+                "\"ci_lo_ns\": %.3f, \"ci_hi_ns\": %.3f",
+                first ? "" : ",", r->name, r->iters, r->reps, r->median, r->p99, r->mean, r->stddev, r->min, r->max,
+                r->ci_lo, r->ci_hi);
+        if (o->perf) {
+            fprintf(o->out, ", \"ipc\": %.3f, \"cache_misses_per_op\": %.4f, \"branch_misses_per_op\": %.4f", r->ipc,
+                    r->cache_misses, r->branch_misses);
+        }
+        fputc('}', o->out);
+    } else {
+        fprintf(o->out, "  %-34s %12.1f %12.1f %12.1f   [%10.1f, %10.1f]", r->name, r->median, r->p99, r->stddev,
+                r->ci_lo, r->ci_hi);
+        if (o->perf) fprintf(o->out, " %6.2f %10.3f %10.3f", r->ipc, r->cache_misses, r->branch_misses);
+        fputc('\n', o->out);
+    }
+    fflush(o->out);
+}
+
+static inline void ttak_bench_emit_footer(const ttak_bench_opts_t *o) {
+    if (o->format == TTAK_BENCH_FMT_JSON) fprintf(o->out, "\n  ]\n}\n");
+}
+
+/**
+ * @brief Runs every case matching the filter and prints the results.
+ * @return Number of cases run.
+ */
+static inline size_t ttak_bench_run_all(const ttak_bench_case_t *cases, size_t n, const ttak_bench_opts_t *o) {
+    if (o->list) {
+        for (size_t i = 0; i < n; i++) fprintf(o->out, "%s\n", cases[i].name);
+        return 0;
+    }
+    size_t ran = 0;
+    ttak_bench_emit_header(o);
+    for (size_t i = 0; i < n; i++) {
+        if (o->filter && !strstr(cases[i].name, o->filter)) continue;
+        ttak_bench_result_t r;
+        if (!ttak_bench_run_case(&cases[i], o, &r)) {
+            fprintf(stderr, "skipped %s: setup failed\n", cases[i].name);
+            continue;
+        }
+        ttak_bench_emit(o, &r, ran == 0);
+        ran++;
+    }
+    ttak_bench_emit_footer(o);
+    return ran;
+}
+
+#endif /* TTAK_BENCH_HARNESS_H */
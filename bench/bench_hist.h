@@ -0,0 +1,80 @@
+/**
+ * @file bench_hist.h
+ * @brief Log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values below 32 get one bucket each. Above that, every power of two is
+ * split into 32 linear sub-buckets, so any recorded value is reported
+ * within about 3% using a fixed 16 KiB of counters. Recording is one
+ * relaxed atomic add, which makes the histogram safe to fill from the
+ * worker threads that complete requests.
+ */
+
+#ifndef TTAK_BENCH_HIST_H
+#define TTAK_BENCH_HIST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#define TTAK_BENCH_HIST_SUB_BITS 5
+#define TTAK_BENCH_HIST_SUB (1u << TTAK_BENCH_HIST_SUB_BITS)
+#define TTAK_BENCH_HIST_BUCKETS (64u * TTAK_BENCH_HIST_SUB)
+
+typedef struct ttak_bench_hist {
+    _Atomic uint64_t counts[TTAK_BENCH_HIST_BUCKETS];
+    _Atomic uint64_t total;
+    _Atomic uint64_t max;
+} ttak_bench_hist_t;
+
+static inline size_t ttak_bench_hist_index(uint64_t v) {
+    if (v < TTAK_BENCH_HIST_SUB) return (size_t)v;
+    unsigned msb = 63u - (unsigned)__builtin_clzll(v);
+    unsigned shift = msb - TTAK_BENCH_HIST_SUB_BITS;
+    return (size_t)(shift + 1) * TTAK_BENCH_HIST_SUB + (size_t)((v >> shift) & (TTAK_BENCH_HIST_SUB - 1));
+}
+
+/** Highest value that lands in bucket @p idx. */
+static inline uint64_t ttak_bench_hist_value(size_t idx) {
+    if (idx < TTAK_BENCH_HIST_SUB) return idx;
+    unsigned shift = (unsigned)(idx / TTAK_BENCH_HIST_SUB) - 1u;
+    uint64_t sub = idx % TTAK_BENCH_HIST_SUB;
+    return ((TTAK_BENCH_HIST_SUB + sub + 1) << shift) - 1;
+}
+
+static inline void ttak_bench_hist_reset(ttak_bench_hist_t *h) {
+    for (size_t i = 0; i < TTAK_BENCH_HIST_BUCKETS; i++) atomic_store_explicit(&h->counts[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&h->total, 0, memory_order_relaxed);
+    atomic_store_explicit(&h->max, 0, memory_order_relaxed);
+}
+
+static inline void ttak_bench_hist_record(ttak_bench_hist_t *h, uint64_t v) {
+    atomic_fetch_add_explicit(&h->counts[ttak_bench_hist_index(v)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->total, 1, memory_order_relaxed);
+    uint64_t cur = atomic_load_explicit(&h->max, memory_order_relaxed);
+    while (v > cur && !atomic_compare_exchange_weak_explicit(&h->max, &cur, v, memory_order_relaxed,
+                                                             memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Value at quantile @p q in [0, 1], as the bucket's upper bound.
+ */
+static inline uint64_t ttak_bench_hist_quantile(ttak_bench_hist_t *h, double q) {
+    uint64_t total = atomic_load_explicit(&h->total, memory_order_relaxed);
+    if (!total) return 0;
+    uint64_t rank = (uint64_t)(q * (double)total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < TTAK_BENCH_HIST_BUCKETS; i++) {
+        seen += atomic_load_explicit(&h->counts[i], memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t v = ttak_bench_hist_value(i);
+            uint64_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+            return v < max ? v : max;
+        }
+    }
+    return atomic_load_explicit(&h->max, memory_order_relaxed);
+}
+
+#endif /* TTAK_BENCH_HIST_H */
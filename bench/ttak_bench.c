@@ -45,6 +45,7 @@
 
 #include <ttak/security/sha256.h>
 #include <ttak/math/bigint.h>
+#include <ttak/math/limbs.h>
 
 #define BENCH_ITERS 100000
 
@@ -774,6 +775,75 @@ static void run_complex(void) {
     ttak_shared_destroy(&sh);
 }
 
+/**
+ * @brief Times each multiplication algorithm across operand sizes.
+ *
+ * The crossover rows are where TTAK_LIMBS_*_THRESHOLD in limbs.h come from.
+ */
+static void run_bigint_mul(void) {
+    puts("\n=== 11. Bigint Multiplication Ladder (ns per product) ===");
+    static const size_t sizes[] = { 16, 24, 32, 48, 64, 96, 128, 192, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536, 131072 };
+    static const struct {
+        const char *name;
+        ttak_limbs_mul_algo_t algo;
+    } algos[] = {
+        { "basecase", TTAK_LIMBS_MUL_BASECASE },
+        { "karatsuba", TTAK_LIMBS_MUL_KARATSUBA },
+        { "toom3", TTAK_LIMBS_MUL_TOOM3 },
+        { "fft", TTAK_LIMBS_MUL_FFT },
+        { "ntt", TTAK_LIMBS_MUL_NTT },
+        { "auto", TTAK_LIMBS_MUL_AUTO },
+    };
+    const size_t max_n = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    limb_t *a = malloc(max_n * sizeof(limb_t));
+    limb_t *b = malloc(max_n * sizeof(limb_t));
+    limb_t *r = malloc(2 * max_n * sizeof(limb_t));
+    if (!a || !b || !r) {
+        free(a);
+        free(b);
+        free(r);
+        return;
+    }
+    uint64_t seed = 0x243F6A8885A308D3ULL;
+    for (size_t i = 0; i < max_n; i++) {
+        a[i] = (limb_t)xorshift64(&seed);
+        b[i] = (limb_t)xorshift64(&seed);
+    }
+
+    printf("  %-8s", "limbs");
+    for (size_t k = 0; k < sizeof(algos) / sizeof(algos[0]); k++) printf(" %12s", algos[k].name);
+    putchar('\n');
+    uint64_t ts = ttak_get_tick_count();
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = sizes[s];
+        printf("  %-8zu", n);
+        for (size_t k = 0; k < sizeof(algos) / sizeof(algos[0]); k++) {
+            /* Schoolbook past a few thousand limbs only says it lost. */
+            if (algos[k].algo == TTAK_LIMBS_MUL_BASECASE && n > 2048) {
+                printf(" %12s", "-");
+                continue;
+            }
+            size_t iters = 1;
+            uint64_t spent = 0;
+            for (;;) {
+                uint64_t t = ttak_get_tick_count_ns();
+                for (size_t i = 0; i < iters; i++) {
+                    ttak_limbs_mul_algo(r, a, n, b, n, algos[k].algo, ts);
+                }
+                spent = dur_u64(t, ttak_get_tick_count_ns());
+                if (spent >= 20000000ULL || iters >= (1U << 20)) break;
+                iters *= 2;
+            }
+            KEEP(r[n]);
+            printf(" %12" PRIu64, spent / iters);
+        }
+        putchar('\n');
+    }
+    free(a);
+    free(b);
+    free(r);
+}
+
 /**
  * @brief Entry point for the subsystem benchmark suite.
  */
@@ -793,6 +863,7 @@ int main(void) {
     run_trees();
     run_io_timing();
     run_complex();
+    run_bigint_mul();
 
     printf("\n  Final RSS:   %ld KB\n", get_rss_kb());
     printf("================================================================\n");
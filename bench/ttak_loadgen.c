@@ -0,0 +1,293 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/**
+ * @file ttak_loadgen.c
+ * @brief Open-loop tail-latency load generator for the thread pool and net lattice.
+ *
+ * A generator thread issues requests on a fixed schedule: request i is due
+ * at start + i / rate, whether or not earlier requests have finished.
+ * Latency is measured from that due time, not from the moment the request
+ * actually went out, so a stalled generator or a backed-up queue shows up
+ * in the percentiles instead of being hidden (coordinated omission).
+ *
+ * Pool targets, one per scheduler path:
+ *   shard  - per-request hash, no priority hint: plain Latin-square routing.
+ *   burst  - TTAK_TASK_DOMAIN_NET with full urgency, so the burst tracker
+ *            rotates hot shards.
+ *   sjf    - a hash per task kind and the SJF-adjusted priority, so short
+ *            tasks overtake the long ones the history has seen.
+ * Lattice target:
+ *   lattice - messages written to a net lattice and drained by one reader.
+ *
+ * The pool workload is 90% short (--short-us) and 10% long (--long-us)
+ * tasks. Every (target, rate) point prints achieved rate and p50, p90, p99,
+ * p99.9 and max latency in microseconds.
+ */
+
+#include <ttak/mem/mem.h>
+#include <ttak/thread/pool.h>
+#include <ttak/async/task.h>
+#include <ttak/priority/scheduler.h>
+#include <ttak/net/lattice.h>
+#include <ttak/timing/timing.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include "bench_harness.h"
+#include "bench_hist.h"
+
+#define LOADGEN_MAX_RATES 32
+#define LOADGEN_SLOT_SIZE 256
+
+typedef enum { TARGET_SHARD, TARGET_BURST, TARGET_SJF, TARGET_LATTICE } loadgen_target_t;
+
+static const char *const g_target_names[] = { "shard", "burst", "sjf", "lattice" };
+
+typedef struct loadgen_run loadgen_run_t;
+
+typedef struct {
+    uint64_t due_ns;
+    uint32_t kind; /* 0 short, 1 long */
+    loadgen_run_t *run;
+} loadgen_req_t;
+
+struct loadgen_run {
+    ttak_bench_hist_t hist;
+    _Atomic uint64_t completed;
+    uint64_t short_ns, long_ns;
+};
+
+static void spin_for(uint64_t ns) {
+    uint64_t end = ttak_bench_now_ns() + ns;
+    while (ttak_bench_now_ns() < end) {
+    }
+}
+
+static void *loadgen_task(void *arg) {
+    loadgen_req_t *req = arg;
+    loadgen_run_t *run = req->run;
+    spin_for(req->kind ? run->long_ns : run->short_ns);
+    ttak_bench_hist_record(&run->hist, ttak_bench_now_ns() - req->due_ns);
+    atomic_fetch_add_explicit(&run->completed, 1, memory_order_release);
+    return NULL;
+}
+
+/**
+ * @brief Sleeps or yields until @p due_ns; never spins a whole core.
+ */
+static void wait_until(uint64_t due_ns) {
+    for (;;) {
+        uint64_t now = ttak_bench_now_ns();
+        if (now >= due_ns) return;
+        uint64_t gap = due_ns - now;
+        if (gap > 50000) {
+            struct timespec nap = { 0, (long)(gap - 20000) };
+            nanosleep(&nap, NULL);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+static bool submit_pool(ttak_thread_pool_t *pool, loadgen_target_t target, loadgen_req_t *req, uint64_t now) {
+    ttak_task_t *task = ttak_task_create(loadgen_task, req, NULL, now);
+    if (!task) return false;
+    int priority = 0;
+    if (target == TARGET_BURST) {
+        ttak_task_set_domain(task, TTAK_TASK_DOMAIN_NET);
+        ttak_task_set_urgency(task, 100);
+    } else if (target == TARGET_SJF) {
+        ttak_task_set_hash(task, ttak_task_hash_of(loadgen_task, (void *)(uintptr_t)(req->kind + 1)));
+        priority = ttak_scheduler_get_adjusted_priority(task, 0);
+    }
+    if (!ttak_thread_pool_schedule_task(pool, task, priority, now)) {
+        ttak_task_destroy(task, now);
+        return false;
+    }
+    return true;
+}
+
+/* ---- lattice reader --------------------------------------------------- */
+
+typedef struct {
+    ttak_net_lattice_t *lat;
+    loadgen_run_t *run;
+    _Atomic bool stop;
+} lattice_reader_t;
+
+static void *lattice_reader_main(void *p) {
+    lattice_reader_t *r = p;
+    uint8_t *buf = malloc(LOADGEN_SLOT_SIZE);
+    if (!buf) return NULL;
+    while (!atomic_load_explicit(&r->stop, memory_order_acquire)) {
+        uint32_t len = 0;
+        if (ttak_net_lattice_read(r->lat, 0, buf, &len, 0) && len >= sizeof(uint64_t)) {
+            uint64_t due;
+            memcpy(&due, buf, sizeof(due));
+            ttak_bench_hist_record(&r->run->hist, ttak_bench_now_ns() - due);
+            atomic_fetch_add_explicit(&r->run->completed, 1, memory_order_release);
+        } else {
+            sched_yield();
+        }
+    }
+    free(buf);
+    return NULL;
+}
+
+/* ---- one (target, rate) point ----------------------------------------- */
+
+typedef struct {
+    unsigned workers;
+    uint64_t window_ms;
+    uint64_t short_ns, long_ns;
+    bool csv;
+} loadgen_opts_t;
+
+static void run_point(loadgen_target_t target, uint64_t rate, const loadgen_opts_t *o) {
+    static loadgen_run_t run;
+    ttak_bench_hist_reset(&run.hist);
+    atomic_store(&run.completed, 0);
+    run.short_ns = o->short_ns;
+    run.long_ns = o->long_ns;
+
+    uint64_t count = rate * o->window_ms / 1000;
+    if (count == 0) count = 1;
+    loadgen_req_t *reqs = calloc(count, sizeof(*reqs));
+    if (!reqs) return;
+
+    uint64_t now_tick = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = NULL;
+    ttak_net_lattice_t *lat = NULL;
+    lattice_reader_t reader = { 0 };
+    pthread_t reader_thread;
+    if (target == TARGET_LATTICE) {
+        lat = ttak_net_lattice_create_sized(8, LOADGEN_SLOT_SIZE, now_tick);
+        reader.lat = lat;
+        reader.run = &run;
+        if (!lat || pthread_create(&reader_thread, NULL, lattice_reader_main, &reader) != 0) {
+            if (lat) ttak_net_lattice_destroy(lat, now_tick);
+            free(reqs);
+            return;
+        }
+    } else {
+        pool = ttak_thread_pool_create(o->workers, 0, now_tick);
+        if (!pool) {
+            free(reqs);
+            return;
+        }
+    }
+
+    uint64_t kind_seed = 0x9E3779B97F4A7C15ULL, dropped = 0;
+    uint64_t interval = 1000000000ULL / rate;
+    uint64_t start = ttak_bench_now_ns() + 1000000;
+    for (uint64_t i = 0; i < count; i++) {
+        loadgen_req_t *req = &reqs[i];
+        req->due_ns = start + i * interval;
+        kind_seed ^= kind_seed << 13;
+        kind_seed ^= kind_seed >> 7;
+        kind_seed ^= kind_seed << 17;
+        req->kind = (kind_seed % 10) == 0;
+        req->run = &run;
+        wait_until(req->due_ns);
+        bool ok;
+        if (target == TARGET_LATTICE) {
+            uint8_t msg[64];
+            memcpy(msg, &req->due_ns, sizeof(req->due_ns));
+            ok = ttak_net_lattice_write(lat, 0, msg, sizeof(msg), now_tick);
+        } else {
+            ok = submit_pool(pool, target, req, now_tick);
+        }
+        if (!ok) dropped++;
+    }
+    uint64_t sent_end = ttak_bench_now_ns();
+
+    /* Let the backlog drain, but give up on a pool that is hopelessly behind. */
+    uint64_t expect = count - dropped;
+    uint64_t give_up = sent_end + 10000000000ULL;
+    while (atomic_load_explicit(&run.completed, memory_order_acquire) < expect && ttak_bench_now_ns() < give_up) {
+        struct timespec nap = { 0, 1000000 };
+        nanosleep(&nap, NULL);
+    }
+    uint64_t done = atomic_load_explicit(&run.completed, memory_order_acquire);
+    uint64_t finish = ttak_bench_now_ns();
+
+    if (target == TARGET_LATTICE) {
+        atomic_store_explicit(&reader.stop, true, memory_order_release);
+        pthread_join(reader_thread, NULL);
+        ttak_net_lattice_destroy(lat, now_tick);
+    } else {
+        ttak_thread_pool_destroy(pool);
+    }
+
+    double achieved = (double)done * 1e9 / (double)(finish - start);
+    double us[5] = {
+        ttak_bench_hist_quantile(&run.hist, 0.50) / 1000.0,
+        ttak_bench_hist_quantile(&run.hist, 0.90) / 1000.0,
+        ttak_bench_hist_quantile(&run.hist, 0.99) / 1000.0,
+        ttak_bench_hist_quantile(&run.hist, 0.999) / 1000.0,
+        atomic_load(&run.hist.max) / 1000.0,
+    };
+    const char *name = g_target_names[target];
+    if (o->csv) {
+        printf("%s,%" PRIu64 ",%.0f,%.2f,%.2f,%.2f,%.2f,%.2f,%" PRIu64 ",%" PRIu64 "\n", name, rate, achieved, us[0], us[1],
+               us[2], us[3], us[4], dropped, expect - done);
+    } else {
+        printf("  %-8s %10" PRIu64 " %10.0f %10.1f %10.1f %10.1f %10.1f %10.1f %8" PRIu64 "\n", name, rate, achieved,
+               us[0], us[1], us[2], us[3], us[4], dropped + (expect - done));
+    }
+    fflush(stdout);
+    /* Workers may still hold requests we gave up on; only free a drained run. */
+    if (done == expect) free(reqs);
+}
+
+static size_t parse_rates(const char *s, uint64_t *out) {
+    size_t n = 0;
+    while (*s && n < LOADGEN_MAX_RATES) {
+        char *end;
+        uint64_t v = strtoull(s, &end, 10);
+        if (end == s) break;
+        if (v) out[n++] = v;
+        s = *end == ',' ? end + 1 : end;
+    }
+    return n;
+}
+
+int main(int argc, char **argv) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    loadgen_opts_t o = { .workers = ncpu > 0 ? (unsigned)ncpu : 1, .window_ms = 1000, .short_ns = 2000, .long_ns = 50000 };
+    uint64_t rates[LOADGEN_MAX_RATES] = { 2000, 5000, 10000, 20000 };
+    size_t nrates = 4;
+    const char *targets = "shard,burst,sjf,lattice";
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (strncmp(a, "--rates=", 8) == 0) nrates = parse_rates(a + 8, rates);
+        else if (strncmp(a, "--targets=", 10) == 0) targets = a + 10;
+        else if (strncmp(a, "--workers=", 10) == 0) o.workers = (unsigned)strtoul(a + 10, NULL, 10);
+        else if (strncmp(a, "--ms=", 5) == 0) o.window_ms = strtoull(a + 5, NULL, 10);
+        else if (strncmp(a, "--short-us=", 11) == 0) o.short_ns = strtoull(a + 11, NULL, 10) * 1000;
+        else if (strncmp(a, "--long-us=", 10) == 0) o.long_ns = strtoull(a + 10, NULL, 10) * 1000;
+        else if (strcmp(a, "--csv") == 0) o.csv = true;
+        else {
+            fprintf(stderr,
+                    "usage: %s [--rates=R1,R2,...] [--targets=shard,burst,sjf,lattice] [--workers=N]\n"
+                    "          [--ms=WINDOW] [--short-us=US] [--long-us=US] [--csv]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!nrates || o.workers < 1 || o.window_ms < 1) return 2;
+
+    if (o.csv) printf("target,offered_per_sec,achieved_per_sec,p50_us,p90_us,p99_us,p999_us,max_us,dropped,unfinished\n");
+    else printf("  %-8s %10s %10s %10s %10s %10s %10s %10s %8s\n", "target", "offered/s", "achieved/s", "p50 us",
+                "p90 us", "p99 us", "p99.9 us", "max us", "lost");
+
+    for (int t = TARGET_SHARD; t <= TARGET_LATTICE; t++) {
+        if (!strstr(targets, g_target_names[t])) continue;
+        for (size_t r = 0; r < nrates; r++) run_point((loadgen_target_t)t, rates[r], &o);
+    }
+    return 0;
+}
@@ -0,0 +1,386 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/**
+ * @file ttak_microbench.c
+ * @brief Per-subsystem microbenchmarks on top of bench_harness.h.
+ *
+ * Every case is named "subsystem/what" so a run can be narrowed with
+ * --filter and so JSON output from two runs can be diffed by name; see
+ * bench_compare.py and the bench-check target in the Makefile.
+ */
+
+#include <ttak/mem/mem.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mem/detachable.h>
+#include <ttak/thread/pool.h>
+#include <ttak/async/future.h>
+#include <ttak/container/ringbuf.h>
+#include <ttak/ht/map.h>
+#include <ttak/ht/table.h>
+#include <ttak/net/lattice.h>
+#include <ttak/security/security_engine.h>
+#include <ttak/security/sha256.h>
+#include <ttak/math/bigint.h>
+#include <ttak/math/limbs.h>
+#include <ttak/math/ntt.h>
+#include <ttak/timing/timing.h>
+
+#include "bench_harness.h"
+
+/**
+ * @brief Fast PRNG for generating non-monotonic keys and inputs.
+ */
+static inline uint64_t xorshift64(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *s = x;
+    return x;
+}
+
+/* ---- alloc ---------------------------------------------------------- */
+
+/**
+ * @brief Allocate, touch and free one block of @c param bytes.
+ *
+ * The sizes are chosen to land in different allocator tiers.
+ */
+static void bench_alloc_free(ttak_bench_state_t *st) {
+    uint64_t now = ttak_get_tick_count();
+    size_t size = (size_t)st->param;
+    for (uint64_t i = 0; i < st->iters; i++) {
+        uint8_t *p = ttak_mem_alloc_raw(size, __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (p) {
+            p[0] = (uint8_t)i;
+            st->sink += p[0];
+        }
+        ttak_mem_free(p);
+    }
+}
+
+static void bench_detachable(ttak_bench_state_t *st) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_detachable_context_t *ctx = ttak_detachable_context_default();
+    for (uint64_t i = 0; i < st->iters; i++) {
+        ttak_detachable_allocation_t a = ttak_detachable_mem_alloc(ctx, 128, now);
+        if (a.data) st->sink += ((uint8_t *)a.data)[0];
+        ttak_detachable_mem_free(ctx, &a);
+    }
+}
+
+/* ---- epoch ---------------------------------------------------------- */
+
+static void bench_epoch_enter_exit(ttak_bench_state_t *st) {
+    for (uint64_t i = 0; i < st->iters; i++) {
+        ttak_epoch_enter();
+        st->sink ^= i;
+        ttak_epoch_exit();
+    }
+}
+
+static void bench_epoch_retire(ttak_bench_state_t *st) {
+    uint64_t now = ttak_get_tick_count();
+    for (uint64_t i = 0; i < st->iters; i++) {
+        void *obj = ttak_mem_alloc_raw(32, __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (obj) ttak_epoch_retire(obj, ttak_mem_free);
+    }
+}
+
+/* ---- pool ----------------------------------------------------------- */
+
+static void *noop_task(void *arg) { return arg; }
+
+static void *pool_setup(uintptr_t param) {
+    return ttak_thread_pool_create((size_t)param, 0, ttak_get_tick_count());
+}
+
+static void pool_teardown(void *arg) { ttak_thread_pool_destroy(arg); }
+
+static void bench_pool_submit(ttak_bench_state_t *st) {
+    uint64_t now = ttak_get_tick_count();
+    for (uint64_t i = 0; i < st->iters; i++) {
+        ttak_future_t *f = ttak_thread_pool_submit_task(st->arg, noop_task, (void *)(uintptr_t)i, 0, now);
+        if (f) st->sink += (uintptr_t)ttak_future_get(f);
+    }
+}
+
+/* ---- ringbuf -------------------------------------------------------- */
+
+static void *ringbuf_setup(uintptr_t param) {
+    return ttak_ringbuf_create_ex(1024, sizeof(uint64_t), (ttak_ringbuf_mode_t)param);
+}
+
+static void ringbuf_teardown(void *arg) { ttak_ringbuf_destroy(arg); }
+
+static void bench_ringbuf(ttak_bench_state_t *st) {
+    for (uint64_t i = 0; i < st->iters; i++) {
+        uint64_t v = i, out = 0;
+        ttak_ringbuf_push(st->arg, &v);
+        ttak_ringbuf_pop(st->arg, &out);
+        st->sink += out;
+    }
+}
+
+/* ---- map / table ---------------------------------------------------- */
+
+#define MAP_KEYS 4096
+
+typedef struct {
+    tt_map_t *map;
+    ttak_table_t tbl;
+    uint64_t keys[MAP_KEYS];
+} map_fixture_t;
+
+static int u64_cmp(const void *a, const void *b) { return memcmp(a, b, 8); }
+
+static void *map_setup(uintptr_t param) {
+    (void)param;
+    uint64_t now = ttak_get_tick_count();
+    map_fixture_t *f = calloc(1, sizeof(*f));
+    if (!f) return NULL;
+    f->map = ttak_create_map(MAP_KEYS * 2, now);
+    ttak_table_init(&f->tbl, MAP_KEYS * 2, NULL, u64_cmp, NULL, NULL);
+    uint64_t seed = 0xC0FFEE1234ULL;
+    for (size_t i = 0; i < MAP_KEYS; i++) {
+        f->keys[i] = xorshift64(&seed);
+        ttak_insert_to_map(f->map, (uintptr_t)f->keys[i], i, now);
+        ttak_table_put(&f->tbl, &f->keys[i], 8, (void *)(uintptr_t)i, now);
+    }
+    return f;
+}
+
+static void map_teardown(void *arg) {
+    map_fixture_t *f = arg;
+    ttak_table_destroy(&f->tbl, ttak_get_tick_count());
+    free(f);
+}
+
+static void bench_map_get(ttak_bench_state_t *st) {
+    map_fixture_t *f = st->arg;
+    uint64_t now = ttak_get_tick_count();
+    for (uint64_t i = 0; i < st->iters; i++) {
+        size_t v = 0;
+        ttak_map_get_key(f->map, (uintptr_t)f->keys[i & (MAP_KEYS - 1)], &v, now);
+        st->sink += v;
+    }
+}
+
+static void bench_map_insert_delete(ttak_bench_state_t *st) {
+    map_fixture_t *f = st->arg;
+    uint64_t now = ttak_get_tick_count();
+    for (uint64_t i = 0; i < st->iters; i++) {
+        uintptr_t k = (uintptr_t)(f->keys[i & (MAP_KEYS - 1)] ^ 0x5A5A5A5A5A5AULL);
+        ttak_insert_to_map(f->map, k, i, now);
+        ttak_delete_from_map(f->map, k, now);
+    }
+}
+
+static void bench_table_get(ttak_bench_state_t *st) {
+    map_fixture_t *f = st->arg;
+    uint64_t now = ttak_get_tick_count();
+    for (uint64_t i = 0; i < st->iters; i++) {
+        st->sink += (uintptr_t)ttak_table_get(&f->tbl, &f->keys[i & (MAP_KEYS - 1)], 8, now);
+    }
+}
+
+/* ---- lattice -------------------------------------------------------- */
+
+static void *lattice_setup(uintptr_t param) {
+    (void)param;
+    return ttak_net_lattice_create_sized(4, 256, ttak_get_tick_count());
+}
+
+static void lattice_teardown(void *arg) { ttak_net_lattice_destroy(arg, ttak_get_tick_count()); }
+
+static void bench_lattice_write_read(ttak_bench_state_t *st) {
+    uint64_t now = ttak_get_tick_count();
+    uint8_t pkt[64] = { 1 }, out[256];
+    for (uint64_t i = 0; i < st->iters; i++) {
+        uint32_t len = 0;
+        pkt[1] = (uint8_t)i;
+        ttak_net_lattice_write(st->arg, 0, pkt, sizeof(pkt), now);
+        ttak_net_lattice_read(st->arg, 0, out, &len, now);
+        st->sink += len + out[1];
+    }
+}
+
+/* ---- aead / hash ---------------------------------------------------- */
+
+typedef struct {
+    uint8_t key[32];
+    uint8_t in[1024];
+    uint8_t out[1024];
+    uint8_t tag[16];
+    ttak_crypto_ctx_t ctx;
+} aead_fixture_t;
+
+static void *aead_setup(uintptr_t param) {
+    aead_fixture_t *f = calloc(1, sizeof(*f));
+    if (!f) return NULL;
+    memset(f->key, 0x42, sizeof(f->key));
+    memset(f->in, 0x77, sizeof(f->in));
+    f->ctx = (ttak_crypto_ctx_t){ .key = f->key, .key_len = 32, .iv_len = 12, .tag = f->tag, .tag_len = 16 };
+    if (param == 1 && ttak_aes256_expand_key(&f->ctx) != TTAK_IO_SUCCESS) {
+        free(f);
+        return NULL;
+    }
+    return f;
+}
+
+static void bench_chacha20_poly1305(ttak_bench_state_t *st) {
+    aead_fixture_t *f = st->arg;
+    for (uint64_t i = 0; i < st->iters; i++) {
+        f->ctx.iv[0] = (uint8_t)i;
+        ttak_chacha20_poly1305_execute(&f->ctx, f->in, f->out, sizeof(f->in));
+        st->sink += f->tag[0];
+    }
+}
+
+static void bench_aes256_gcm(ttak_bench_state_t *st) {
+    aead_fixture_t *f = st->arg;
+    for (uint64_t i = 0; i < st->iters; i++) {
+        f->ctx.iv[0] = (uint8_t)i;
+        ttak_aes256_gcm_execute(&f->ctx, f->in, f->out, sizeof(f->in));
+        st->sink += f->tag[0];
+    }
+}
+
+static void bench_sha256(ttak_bench_state_t *st) {
+    uint8_t data[1024], hash[SHA256_BLOCK_SIZE];
+    memset(data, 0x77, sizeof(data));
+    for (uint64_t i = 0; i < st->iters; i++) {
+        SHA256_CTX ctx;
+        data[0] = (uint8_t)i;
+        sha256_init(&ctx);
+        sha256_update(&ctx, data, sizeof(data));
+        sha256_final(&ctx, hash);
+        st->sink += hash[0];
+    }
+}
+
+/* ---- bigint / ntt --------------------------------------------------- */
+
+typedef struct {
+    size_t n;
+    limb_t *a, *b, *r;
+} mul_fixture_t;
+
+static void *mul_setup(uintptr_t param) {
+    mul_fixture_t *f = calloc(1, sizeof(*f));
+    if (!f) return NULL;
+    f->n = (size_t)param;
+    f->a = malloc(f->n * sizeof(limb_t));
+    f->b = malloc(f->n * sizeof(limb_t));
+    f->r = malloc(2 * f->n * sizeof(limb_t));
+    if (!f->a || !f->b || !f->r) {
+        free(f->a);
+        free(f->b);
+        free(f->r);
+        free(f);
+        return NULL;
+    }
+    uint64_t seed = 0x243F6A8885A308D3ULL;
+    for (size_t i = 0; i < f->n; i++) {
+        f->a[i] = (limb_t)xorshift64(&seed);
+        f->b[i] = (limb_t)xorshift64(&seed);
+    }
+    return f;
+}
+
+static void mul_teardown(void *arg) {
+    mul_fixture_t *f = arg;
+    free(f->a);
+    free(f->b);
+    free(f->r);
+    free(f);
+}
+
+static void bench_bigint_mul(ttak_bench_state_t *st) {
+    mul_fixture_t *f = st->arg;
+    uint64_t now = ttak_get_tick_count();
+    for (uint64_t i = 0; i < st->iters; i++) {
+        ttak_limbs_mul(f->r, f->a, f->n, f->b, f->n, now);
+        st->sink += f->r[f->n];
+    }
+}
+
+typedef struct {
+    ttak_ntt_plan_t plan;
+    uint64_t *data;
+} ntt_fixture_t;
+
+static void *ntt_setup(uintptr_t param) {
+    ntt_fixture_t *f = calloc(1, sizeof(*f));
+    if (!f) return NULL;
+    size_t n = (size_t)param;
+    f->data = malloc(n * sizeof(uint64_t));
+    if (!f->data || !ttak_ntt_plan_init(&f->plan, &ttak_ntt_primes[0], n)) {
+        free(f->data);
+        free(f);
+        return NULL;
+    }
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < n; i++) f->data[i] = xorshift64(&seed) % ttak_ntt_primes[0].modulus;
+    return f;
+}
+
+static void ntt_teardown(void *arg) {
+    ntt_fixture_t *f = arg;
+    ttak_ntt_plan_destroy(&f->plan);
+    free(f->data);
+    free(f);
+}
+
+/* A forward and an inverse transform, so the data stays in range across reps. */
+static void bench_ntt_roundtrip(ttak_bench_state_t *st) {
+    ntt_fixture_t *f = st->arg;
+    for (uint64_t i = 0; i < st->iters; i++) {
+        ttak_ntt_plan_forward(&f->plan, f->data);
+        ttak_ntt_plan_inverse(&f->plan, f->data);
+        st->sink += f->data[0];
+    }
+}
+
+static const ttak_bench_case_t g_cases[] = {
+    { "alloc/raw_64B", bench_alloc_free, NULL, NULL, 64 },
+    { "alloc/raw_4KiB", bench_alloc_free, NULL, NULL, 4096 },
+    { "alloc/raw_64KiB", bench_alloc_free, NULL, NULL, 65536 },
+    { "alloc/raw_1MiB", bench_alloc_free, NULL, NULL, 1 << 20 },
+    { "alloc/detachable_128B", bench_detachable, NULL, NULL, 0 },
+    { "epoch/enter_exit", bench_epoch_enter_exit, NULL, NULL, 0 },
+    { "epoch/retire_32B", bench_epoch_retire, NULL, NULL, 0 },
+    { "pool/submit_get_4t", bench_pool_submit, pool_setup, pool_teardown, 4 },
+    { "ringbuf/push_pop_locked", bench_ringbuf, ringbuf_setup, ringbuf_teardown, TTAK_RINGBUF_LOCKED },
+    { "ringbuf/push_pop_spsc", bench_ringbuf, ringbuf_setup, ringbuf_teardown, TTAK_RINGBUF_SPSC },
+    { "ringbuf/push_pop_mpmc", bench_ringbuf, ringbuf_setup, ringbuf_teardown, TTAK_RINGBUF_MPMC },
+    { "map/get", bench_map_get, map_setup, map_teardown, 0 },
+    { "map/insert_delete", bench_map_insert_delete, map_setup, map_teardown, 0 },
+    { "table/get", bench_table_get, map_setup, map_teardown, 0 },
+    { "lattice/write_read_64B", bench_lattice_write_read, lattice_setup, lattice_teardown, 0 },
+    { "aead/chacha20_poly1305_1KiB", bench_chacha20_poly1305, aead_setup, free, 0 },
+    { "aead/aes256_gcm_1KiB", bench_aes256_gcm, aead_setup, free, 1 },
+    { "hash/sha256_1KiB", bench_sha256, NULL, NULL, 0 },
+    { "bigint/mul_16", bench_bigint_mul, mul_setup, mul_teardown, 16 },
+    { "bigint/mul_64", bench_bigint_mul, mul_setup, mul_teardown, 64 },
+    { "bigint/mul_256", bench_bigint_mul, mul_setup, mul_teardown, 256 },
+    { "bigint/mul_1024", bench_bigint_mul, mul_setup, mul_teardown, 1024 },
+    { "bigint/mul_8192", bench_bigint_mul, mul_setup, mul_teardown, 8192 },
+    { "ntt/roundtrip_2^10", bench_ntt_roundtrip, ntt_setup, ntt_teardown, 1 << 10 },
+    { "ntt/roundtrip_2^14", bench_ntt_roundtrip, ntt_setup, ntt_teardown, 1 << 14 },
+    { "ntt/roundtrip_2^18", bench_ntt_roundtrip, ntt_setup, ntt_teardown, 1 << 18 },
+};
+
+/**
+ * @brief Entry point; see ttak_bench_usage() for flags.
+ */
+int main(int argc, char **argv) {
+    ttak_bench_opts_t opts = { .suite = "ttak_microbench" };
+    if (!ttak_bench_parse_args(argc, argv, &opts)) return 2;
+    ttak_epoch_register_thread();
+    size_t ran = ttak_bench_run_all(g_cases, sizeof(g_cases) / sizeof(g_cases[0]), &opts);
+    ttak_epoch_deregister_thread();
+    return (ran || opts.list) ? 0 : 1;
+}
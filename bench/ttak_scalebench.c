@@ -0,0 +1,365 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/**
+ * @file ttak_scalebench.c
+ * @brief Thread-sweep throughput benchmarks for the contended subsystems.
+ *
+ * Each case runs with 1, 2, 4, ... up to --threads workers for a fixed
+ * wall-clock window and reports aggregate operations per second. Flat or
+ * falling curves are contention; compare them against the linear line the
+ * plot draws from the single-thread point.
+ *
+ * Output is "bench,threads,ops_per_sec,ns_per_op" CSV, which
+ * ttl-cache-multithread-bench/generate_ci_benchmark_svg.py --scaling turns
+ * into throughput curves.
+ */
+
+#include <ttak/mem/mem.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mem/owner.h>
+#include <ttak/shared/shared.h>
+#include <ttak/thread/pool.h>
+#include <ttak/async/future.h>
+#include <ttak/container/ringbuf.h>
+#include <ttak/net/lattice.h>
+#include <ttak/timing/timing.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "bench_harness.h"
+
+/* Workers poll the stop flag once per batch. */
+#define SCALE_BATCH 64
+#define SCALE_MAX_THREADS 256
+
+typedef struct scale_case {
+    const char *name;
+    void *(*setup)(unsigned threads);
+    void (*teardown)(void *arg, unsigned threads);
+    /** Runs until @p stop is set and returns the operations it completed. */
+    uint64_t (*worker)(void *arg, unsigned tid, unsigned threads, _Atomic bool *stop);
+    unsigned max_threads; /**< 0 for no limit. */
+} scale_case_t;
+
+/* ---- fortress alloc/free -------------------------------------------- */
+
+static uint64_t w_alloc_free(void *arg, unsigned tid, unsigned threads, _Atomic bool *stop) {
+    (void)arg;
+    (void)threads;
+    uint64_t now = ttak_get_tick_count(), ops = 0, sink = 0;
+    size_t size = 64 + (tid & 3) * 32;
+    while (!atomic_load_explicit(stop, memory_order_relaxed)) {
+        for (int i = 0; i < SCALE_BATCH; i++) {
+            uint8_t *p = ttak_mem_alloc_raw(size, __TTAK_UNSAFE_MEM_FOREVER__, now);
+            if (p) sink += p[0];
+            ttak_mem_free(p);
+        }
+        ops += SCALE_BATCH;
+    }
+    KEEP(sink);
+    return ops;
+}
+
+/* ---- pocket cross-thread free ----------------------------------------- */
+
+/*
+ * Thread i allocates into ring i and frees whatever thread i-1 left in ring
+ * i-1, so every block is released by a thread other than its allocator.
+ */
+typedef struct {
+    ttak_ringbuf_t *rings[SCALE_MAX_THREADS];
+} xfree_ctx_t;
+
+static void *xfree_setup(unsigned threads) {
+    xfree_ctx_t *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    for (unsigned i = 0; i < threads; i++) {
+        c->rings[i] = ttak_ringbuf_create_ex(1024, sizeof(void *), TTAK_RINGBUF_SPSC);
+        if (!c->rings[i]) return NULL;
+    }
+    return c;
+}
+
+static void xfree_teardown(void *arg, unsigned threads) {
+    xfree_ctx_t *c = arg;
+    for (unsigned i = 0; i < threads; i++) {
+        void *p;
+        while (ttak_ringbuf_pop(c->rings[i], &p)) ttak_mem_free(p);
+        ttak_ringbuf_destroy(c->rings[i]);
+    }
+    free(c);
+}
+
+static uint64_t w_xfree(void *arg, unsigned tid, unsigned threads, _Atomic bool *stop) {
+    xfree_ctx_t *c = arg;
+    ttak_ringbuf_t *out = c->rings[tid];
+    ttak_ringbuf_t *in = c->rings[(tid + threads - 1) % threads];
+    uint64_t now = ttak_get_tick_count(), ops = 0;
+    while (!atomic_load_explicit(stop, memory_order_relaxed)) {
+        for (int i = 0; i < SCALE_BATCH; i++) {
+            void *p;
+            if (ttak_ringbuf_pop(in, &p)) {
+                ttak_mem_free(p);
+                ops++;
+            }
+            p = ttak_mem_alloc_raw(64, __TTAK_UNSAFE_MEM_FOREVER__, now);
+            if (p && !ttak_ringbuf_push(out, &p)) ttak_mem_free(p);
+        }
+    }
+    return ops;
+}
+
+/* ---- thread pool submit ----------------------------------------------- */
+
+static void *noop_task(void *arg) { return arg; }
+
+static void *pool_setup(unsigned threads) {
+    return ttak_thread_pool_create(threads, 0, ttak_get_tick_count());
+}
+
+static void pool_teardown(void *arg, unsigned threads) {
+    (void)threads;
+    ttak_thread_pool_destroy(arg);
+}
+
+static uint64_t w_pool_submit(void *arg, unsigned tid, unsigned threads, _Atomic bool *stop) {
+    (void)threads;
+    uint64_t now = ttak_get_tick_count(), ops = 0, sink = 0;
+    ttak_future_t *futs[SCALE_BATCH];
+    while (!atomic_load_explicit(stop, memory_order_relaxed)) {
+        int n = 0;
+        for (; n < SCALE_BATCH; n++) {
+            futs[n] = ttak_thread_pool_submit_task(arg, noop_task, (void *)(uintptr_t)tid, 0, now);
+            if (!futs[n]) break;
+        }
+        for (int i = 0; i < n; i++) sink += (uintptr_t)ttak_future_get(futs[i]);
+        ops += (uint64_t)n;
+    }
+    KEEP(sink);
+    return ops;
+}
+
+/* ---- shared access ---------------------------------------------------- */
+
+typedef struct {
+    ttak_shared_t sh;
+    ttak_owner_t *owners[SCALE_MAX_THREADS];
+} shared_ctx_t;
+
+static void *shared_setup(unsigned threads) {
+    shared_ctx_t *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    ttak_shared_init(&c->sh);
+    c->sh.allocate_typed(&c->sh, 256, "scale", TTAK_SHARED_LEVEL_1);
+    for (unsigned i = 0; i < threads; i++) {
+        c->owners[i] = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+        c->sh.add_owner(&c->sh, c->owners[i]);
+    }
+    return c;
+}
+
+static void shared_teardown(void *arg, unsigned threads) {
+    shared_ctx_t *c = arg;
+    ttak_shared_destroy(&c->sh);
+    for (unsigned i = 0; i < threads; i++) ttak_owner_destroy(c->owners[i]);
+    free(c);
+}
+
+static uint64_t w_shared_access(void *arg, unsigned tid, unsigned threads, _Atomic bool *stop) {
+    (void)threads;
+    shared_ctx_t *c = arg;
+    uint64_t ops = 0, sink = 0;
+    while (!atomic_load_explicit(stop, memory_order_relaxed)) {
+        for (int i = 0; i < SCALE_BATCH; i++) {
+            ttak_shared_result_t res;
+            const void *p = c->sh.access(&c->sh, c->owners[tid], &res);
+            sink += (uintptr_t)p ^ (uint64_t)res;
+            c->sh.release(&c->sh);
+        }
+        ops += SCALE_BATCH;
+    }
+    KEEP(sink);
+    return ops;
+}
+
+/* ---- net lattice write/read ------------------------------------------- */
+
+static void *lattice_setup(unsigned threads) {
+    (void)threads;
+    return ttak_net_lattice_create_sized(TTAK_LATTICE_MAX_DIM, 256, ttak_get_tick_count());
+}
+
+static void lattice_teardown(void *arg, unsigned threads) {
+    (void)threads;
+    ttak_net_lattice_destroy(arg, ttak_get_tick_count());
+}
+
+/*
+ * Only even worker ids own slots in the MOLS lane mapping; an odd id never
+ * finds a free slot and keeps chaining new lattices. Map thread i to 2i.
+ */
+static uint64_t w_lattice(void *arg, unsigned tid, unsigned threads, _Atomic bool *stop) {
+    (void)threads;
+    tid *= 2;
+    uint64_t now = ttak_get_tick_count(), ops = 0, sink = 0;
+    uint8_t pkt[64] = { (uint8_t)tid }, out[256];
+    while (!atomic_load_explicit(stop, memory_order_relaxed)) {
+        for (int i = 0; i < SCALE_BATCH; i++) {
+            uint32_t len = 0;
+            if (ttak_net_lattice_write(arg, tid, pkt, sizeof(pkt), now) &&
+                ttak_net_lattice_read(arg, tid, out, &len, now)) {
+                ops++;
+                sink += len;
+            }
+        }
+    }
+    KEEP(sink);
+    return ops;
+}
+
+/* ---- epoch retire ----------------------------------------------------- */
+
+static uint64_t w_epoch_retire(void *arg, unsigned tid, unsigned threads, _Atomic bool *stop) {
+    (void)arg;
+    (void)tid;
+    (void)threads;
+    uint64_t now = ttak_get_tick_count(), ops = 0;
+    while (!atomic_load_explicit(stop, memory_order_relaxed)) {
+        for (int i = 0; i < SCALE_BATCH; i++) {
+            ttak_epoch_enter();
+            void *obj = ttak_mem_alloc_raw(32, __TTAK_UNSAFE_MEM_FOREVER__, now);
+            ttak_epoch_exit();
+            if (obj) ttak_epoch_retire(obj, ttak_mem_free);
+        }
+        ops += SCALE_BATCH;
+    }
+    return ops;
+}
+
+static const scale_case_t g_cases[] = {
+    { "alloc_free", NULL, NULL, w_alloc_free, 0 },
+    { "pocket_xfree", xfree_setup, xfree_teardown, w_xfree, SCALE_MAX_THREADS },
+    { "pool_submit", pool_setup, pool_teardown, w_pool_submit, 0 },
+    { "shared_access", shared_setup, shared_teardown, w_shared_access, SCALE_MAX_THREADS },
+    /* Writers sharing a lattice lane race on the slot state, so one per lane. */
+    { "lattice_write_read", lattice_setup, lattice_teardown, w_lattice, TTAK_LATTICE_MAX_DIM / 2 },
+    { "epoch_retire", NULL, NULL, w_epoch_retire, 0 },
+};
+
+/* ---- runner ----------------------------------------------------------- */
+
+typedef struct {
+    const scale_case_t *c;
+    void *arg;
+    unsigned tid, threads;
+    pthread_barrier_t *start;
+    _Atomic bool *stop;
+    uint64_t ops;
+} scale_thread_t;
+
+static void *scale_thread_main(void *p) {
+    scale_thread_t *t = p;
+    ttak_epoch_register_thread();
+    pthread_barrier_wait(t->start);
+    t->ops = t->c->worker(t->arg, t->tid, t->threads, t->stop);
+    ttak_epoch_deregister_thread();
+    return NULL;
+}
+
+/**
+ * @brief Runs @p c with @p threads workers for @p window_ns.
+ * @return Aggregate operations per second, or a negative value on failure.
+ */
+static double scale_run_once(const scale_case_t *c, unsigned threads, uint64_t window_ns) {
+    void *arg = c->setup ? c->setup(threads) : NULL;
+    if (c->setup && !arg) return -1.0;
+
+    pthread_t tids[SCALE_MAX_THREADS];
+    scale_thread_t ts[SCALE_MAX_THREADS];
+    pthread_barrier_t start;
+    _Atomic bool stop = false;
+    pthread_barrier_init(&start, NULL, threads + 1);
+    for (unsigned i = 0; i < threads; i++) {
+        ts[i] = (scale_thread_t){ .c = c, .arg = arg, .tid = i, .threads = threads, .start = &start, .stop = &stop };
+        pthread_create(&tids[i], NULL, scale_thread_main, &ts[i]);
+    }
+    pthread_barrier_wait(&start);
+    uint64_t t0 = ttak_bench_now_ns();
+    struct timespec nap = { .tv_sec = (time_t)(window_ns / 1000000000ULL), .tv_nsec = (long)(window_ns % 1000000000ULL) };
+    nanosleep(&nap, NULL);
+    atomic_store(&stop, true);
+    uint64_t ops = 0;
+    for (unsigned i = 0; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+        ops += ts[i].ops;
+    }
+    uint64_t elapsed = ttak_bench_now_ns() - t0;
+    pthread_barrier_destroy(&start);
+    if (c->teardown) c->teardown(arg, threads);
+    return (double)ops * 1e9 / (double)elapsed;
+}
+
+int main(int argc, char **argv) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned max_threads = ncpu > 0 ? (unsigned)ncpu : 1;
+    uint64_t window_ms = 200;
+    unsigned reps = 3;
+    const char *filter = NULL;
+    bool csv = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (strncmp(a, "--threads=", 10) == 0) max_threads = (unsigned)strtoul(a + 10, NULL, 10);
+        else if (strncmp(a, "--ms=", 5) == 0) window_ms = strtoull(a + 5, NULL, 10);
+        else if (strncmp(a, "--reps=", 7) == 0) reps = (unsigned)strtoul(a + 7, NULL, 10);
+        else if (strncmp(a, "--filter=", 9) == 0) filter = a + 9;
+        else if (strcmp(a, "--csv") == 0) csv = true;
+        else {
+            fprintf(stderr, "usage: %s [--threads=N] [--ms=WINDOW] [--reps=N] [--filter=SUBSTR] [--csv]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (max_threads < 1) max_threads = 1;
+    if (max_threads > SCALE_MAX_THREADS) max_threads = SCALE_MAX_THREADS;
+    if (reps < 1) reps = 1;
+
+    if (csv) printf("bench,threads,ops_per_sec,ns_per_op\n");
+    else printf("  %-20s %8s %16s %12s %10s\n", "benchmark", "threads", "ops/s", "ns/op", "speedup");
+
+    /* Powers of two, plus the maximum itself when it is not one. */
+    unsigned sweep[32], nsweep = 0;
+    for (unsigned t = 1; t < max_threads; t *= 2) sweep[nsweep++] = t;
+    sweep[nsweep++] = max_threads;
+
+    for (size_t k = 0; k < sizeof(g_cases) / sizeof(g_cases[0]); k++) {
+        const scale_case_t *c = &g_cases[k];
+        if (filter && !strstr(c->name, filter)) continue;
+        double base = 0.0;
+        for (unsigned s = 0; s < nsweep; s++) {
+            unsigned t = sweep[s];
+            if (c->max_threads && t > c->max_threads) break;
+            /* Median of the repetitions damps scheduler noise. */
+            double runs[TTAK_BENCH_MAX_REPS];
+            unsigned n = 0;
+            for (unsigned r = 0; r < reps && r < TTAK_BENCH_MAX_REPS; r++) {
+                double v = scale_run_once(c, t, window_ms * 1000000ULL);
+                if (v >= 0.0) runs[n++] = v;
+            }
+            if (!n) {
+                fprintf(stderr, "skipped %s at %u threads: setup failed\n", c->name, t);
+                continue;
+            }
+            qsort(runs, n, sizeof(double), ttak_bench_cmp_double);
+            double ops = ttak_bench_quantile(runs, n, 0.5);
+            if (t == 1) base = ops;
+            double nsop = ops > 0.0 ? 1e9 * (double)t / ops : 0.0;
+            if (csv) printf("%s,%u,%.0f,%.2f\n", c->name, t, ops, nsop);
+            else printf("  %-20s %8u %16.0f %12.1f %9.2fx\n", c->name, t, ops, nsop, base > 0.0 ? ops / base : 0.0);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
@@ -3,6 +3,8 @@
 
 from __future__ import annotations
 
+import argparse
+import csv
 import os
 import re
 from pathlib import Path
@@ -29,6 +31,8 @@ COLORS = {
     "tcc": "#f2cc60",
     "EMBEDDED=0": "#58a6ff",
     "EMBEDDED=1": "#ff7b72",
+    "measured": "#58a6ff",
+    "linear": "#6a737d",
 }
 
 LINE_RE = re.compile(
@@ -107,14 +111,14 @@ def draw_legend(x, y, order, present):
     return "\n".join(out)
 
 
-def draw_panel(title, y_label, metric_key, x, y, w, h, data):
+def draw_panel(title, y_label, metric_key, x, y, w, h, data, x_key="sec", x_label="Elapsed Time (s)", x_unit="s", x_ticks=None):
     out = [
         f"<rect x='{x}' y='{y}' width='{w}' height='{h}' rx='14' fill='#11182e' stroke='#4b5872' stroke-width='1.2'/>",
         f"<text x='{x+30}' y='{y+36}' fill='#e6edf3' font-size='22' font-family='Arial' font-weight='700'>{title}</text>",
     ]
 
     gx, gy, gw, gh = x + 120, y + 54, w - 190, h - 120
-    all_secs = [r["sec"] for rows in data.values() for r in rows]
+    all_secs = [r[x_key] for rows in data.values() for r in rows]
     all_vals = [r[metric_key] for rows in data.values() for r in rows]
     x_min, x_max = min(all_secs), max(all_secs)
     y_min, y_max = min(all_vals), max(all_vals)
@@ -129,29 +133,30 @@ def draw_panel(title, y_label, metric_key, x, y, w, h, data):
     out.append(f"<line x1='{gx}' y1='{gy+gh}' x2='{gx+gw}' y2='{gy+gh}' stroke='#95a2bb' stroke-width='1.4'/>")
     out.append(f"<line x1='{gx}' y1='{gy}' x2='{gx}' y2='{gy+gh}' stroke='#95a2bb' stroke-width='1.4'/>")
 
-    for sec in range(int(x_min), int(x_max) + 1):
-        if sec % 2 != 0 and sec != x_max:
-            continue
+    if x_ticks is None:
+        x_ticks = [sec for sec in range(int(x_min), int(x_max) + 1) if sec % 2 == 0 or sec == x_max]
+    for sec in x_ticks:
         px = gx + ((sec - x_min) / (x_max - x_min if x_max != x_min else 1)) * gw
-        out.append(f"<text x='{px:.1f}' y='{gy+gh+30}' text-anchor='middle' fill='#c9d6e2' font-size='12' font-family='Arial'>{sec}s</text>")
+        out.append(f"<text x='{px:.1f}' y='{gy+gh+30}' text-anchor='middle' fill='#c9d6e2' font-size='12' font-family='Arial'>{sec}{x_unit}</text>")
 
     out.extend(
         [
             f"<text x='{x+35}' y='{y+h/2:.1f}' fill='#c9d6e2' font-size='14' font-family='Arial' transform='rotate(-90 {x+35},{y+h/2:.1f})'>{y_label}</text>",
-            f"<text x='{gx+gw/2:.1f}' y='{y+h-18}' text-anchor='middle' fill='#c9d6e2' font-size='14' font-family='Arial'>Elapsed Time (s)</text>",
+            f"<text x='{gx+gw/2:.1f}' y='{y+h-18}' text-anchor='middle' fill='#c9d6e2' font-size='14' font-family='Arial'>{x_label}</text>",
             f"<text x='{gx-10}' y='{gy+6}' text-anchor='end' fill='#9fb0c0' font-size='12' font-family='Arial'>{y_max:.2f}</text>",
             f"<text x='{gx-10}' y='{gy+gh+5}' text-anchor='end' fill='#9fb0c0' font-size='12' font-family='Arial'>{y_min:.2f}</text>",
         ]
     )
 
     for name, rows in data.items():
-        xs = [r["sec"] for r in rows]
+        xs = [r[x_key] for r in rows]
         ys = [r[metric_key] for r in rows]
         points = scale_points(xs, ys, gx, gy, gw, gh, x_min, x_max, y_min, y_max)
         poly = " ".join(f"{px:.1f},{py:.1f}" for px, py in points)
-        out.append(f"<polyline points='{poly}' fill='none' stroke='{COLORS[name]}' stroke-width='3.2' stroke-linecap='round' stroke-linejoin='round'/>")
+        color = COLORS.get(name, "#9b59b6")
+        out.append(f"<polyline points='{poly}' fill='none' stroke='{color}' stroke-width='3.2' stroke-linecap='round' stroke-linejoin='round'/>")
         for px, py in points:
-            out.append(f"<circle cx='{px:.1f}' cy='{py:.1f}' r='4.0' fill='{COLORS[name]}' stroke='#0b1020' stroke-width='1' />")
+            out.append(f"<circle cx='{px:.1f}' cy='{py:.1f}' r='4.0' fill='{color}' stroke='#0b1020' stroke-width='1' />")
 
     return "\n".join(out)
 
@@ -205,7 +210,61 @@ def write_single_metric_svg(path: Path, title: str, y_label: str, metric_key: st
     print(f"Generated {path}")
 
 
+def load_scaling(path: Path) -> dict[str, list[dict[str, float]]]:
+    """Read ttak_scalebench --csv output into {bench: [{threads, mops}]}."""
+    series: dict[str, list[dict[str, float]]] = {}
+    with path.open(encoding="utf-8") as fh:
+        for row in csv.DictReader(line for line in fh if "," in line):
+            try:
+                point = {"threads": int(row["threads"]), "mops": float(row["ops_per_sec"]) / 1_000_000.0}
+            except (KeyError, ValueError):
+                continue
+            series.setdefault(row["bench"], []).append(point)
+    return series
+
+
+def write_scaling_svg(path: Path, series: dict[str, list[dict[str, float]]]) -> None:
+    """One panel per benchmark: measured throughput against linear scaling from 1 thread."""
+    cols = 2
+    panel_w, panel_h = 840, 420
+    rows_n = (len(series) + cols - 1) // cols
+    width, height = 50 + cols * (panel_w + 30), 170 + rows_n * (panel_h + 30)
+    parts = [
+        f"<svg xmlns='http://www.w3.org/2000/svg' width='{width}' height='{height}' viewBox='0 0 {width} {height}'>",
+        "<rect width='100%' height='100%' fill='#0b1020'/>",
+        "<text x='50%' y='56' text-anchor='middle' fill='#e6edf3' font-size='32' font-family='Arial' font-weight='700'>LibTTAK Thread Scaling</text>",
+        draw_legend(120, 110, ["measured", "linear"], {"measured", "linear"}),
+    ]
+    for idx, (name, points) in enumerate(series.items()):
+        points = sorted(points, key=lambda p: p["threads"])
+        base = points[0]["mops"] / points[0]["threads"] if points else 0.0
+        data = {
+            "measured": points,
+            "linear": [{"threads": p["threads"], "mops": base * p["threads"]} for p in points],
+        }
+        px = 50 + (idx % cols) * (panel_w + 30)
+        py = 140 + (idx // cols) * (panel_h + 30)
+        parts.append(
+            draw_panel(name, "Throughput (Million Ops/s)", "mops", px, py, panel_w, panel_h, data,
+                       x_key="threads", x_label="Threads", x_unit="", x_ticks=[p["threads"] for p in points])
+        )
+    parts.append("</svg>")
+    path.write_text("\n".join(parts), encoding="utf-8")
+    print(f"Generated {path}")
+
+
 def main() -> None:
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument("--scaling", type=Path, help="plot ttak_scalebench --csv output instead of the TTL cache series")
+    ap.add_argument("--out", type=Path, help="output SVG for --scaling (default: scaling.svg next to the CSV)")
+    args = ap.parse_args()
+    if args.scaling:
+        series = load_scaling(args.scaling)
+        if not series:
+            raise SystemExit(f"No scaling rows in {args.scaling}.")
+        write_scaling_svg(args.out or args.scaling.with_name("scaling.svg"), series)
+        return
+
     compiler_data = load_series(RAW_FILES)
     if not compiler_data:
         raise SystemExit("No compiler benchmark raw files found.")
@@ -41,6 +41,7 @@ static long get_rss_kb(void) {
 #include <ttak/mem/mem.h>
 #include <ttak/mem/epoch.h>
 #include <ttak/mem/epoch_gc.h>
+#include <ttak/mem/hazard.h>
 #include <ttak/shared/shared.h>
 #include <ttak/container/pool.h>
 #include <ttak/timing/timing.h>
@@ -153,6 +154,8 @@ typedef struct {
     uint32_t max_probe;
     uint32_t maintenance_scan;
     uint32_t warmup_ops;
+    ttak_reclaim_mode_t reclaim_mode;
+    bool gc_reclaimer;
 } config_t;
 
 static config_t cfg = { 
@@ -179,7 +182,9 @@ static config_t cfg = {
     .table_size = 1u << 20,
     .max_probe = 4,
     .maintenance_scan = 4096,
-    .warmup_ops = 0
+    .warmup_ops = 0,
+    .reclaim_mode = TTAK_RECLAIM_EPOCH,
+    .gc_reclaimer = false
 };
 static const size_t kMaxArenaBudgetBytes = 1024ULL * 1024ULL * 1024ULL;
 
@@ -294,6 +299,22 @@ static inline cache_entry_t *cache_entry_from_payload(cache_item_data_t *payload
     return payload ? TTAK_GET_HEADER(payload) : NULL;
 }
 
+/* Readers either run inside an epoch or pin each payload with a hazard pointer. */
+static inline cache_item_data_t *bench_pin(cache_bucket_t *bucket) {
+    if (cfg.reclaim_mode == TTAK_RECLAIM_HAZARD) {
+        return (cache_item_data_t *)ttak_hazard_protect((void * _Atomic *)&bucket->ptr);
+    }
+    return atomic_load_explicit(&bucket->ptr, memory_order_acquire);
+}
+
+static inline void bench_unpin(void) {
+    if (cfg.reclaim_mode == TTAK_RECLAIM_HAZARD) ttak_hazard_release();
+}
+
+static inline void bench_retire(cache_item_data_t *payload) {
+    ttak_reclaim_retire(cfg.reclaim_mode, payload, retire_payload_cleanup);
+}
+
 static inline uint64_t bench_now_ns(void) {
     return ttak_get_tick_count_ns();
 }
@@ -343,13 +364,15 @@ static inline cache_lookup_result_t cache_table_lookup(cache_table_t *table, uin
     size_t idx = bench_mix_u64(key) & mask;
     uint32_t max_probe = cfg.max_probe ? cfg.max_probe : 1;
     for (uint32_t probe = 0; probe < max_probe; ++probe) {
-        cache_item_data_t *payload = atomic_load_explicit(&table->buckets[idx].ptr, memory_order_acquire);
+        cache_item_data_t *payload = bench_pin(&table->buckets[idx]);
         if (!payload) {
+            bench_unpin();
             result.kind = CACHE_RESULT_MISS;
             return result;
         }
         if (payload->key == key) {
             if (payload->expire_ns > now_ns) {
+                /* Stays pinned until the caller is done with the hit. */
                 result.kind = CACHE_RESULT_HIT;
                 result.entry = cache_entry_from_payload(payload);
                 result.item = payload;
@@ -359,15 +382,17 @@ static inline cache_lookup_result_t cache_table_lookup(cache_table_t *table, uin
             cache_item_data_t *expected = payload;
             if (atomic_compare_exchange_strong_explicit(&table->buckets[idx].ptr, &expected, NULL,
                                                        memory_order_release, memory_order_relaxed)) {
-                ttak_epoch_retire(payload, retire_payload_cleanup);
+                bench_retire(payload);
                 TTAK_FAST_ATOMIC_ADD_U64(&stats.retirements, 1);
                 result.kind = CACHE_RESULT_EXPIRED;
             } else {
                 
                 result.kind = CACHE_RESULT_MISS;
             }
+            bench_unpin();
             return result;
         }
+        bench_unpin();
         idx = (idx + 1) & mask;
     }
     return result;
@@ -382,8 +407,9 @@ static cache_store_result_t cache_table_store(cache_table_t *table, cache_item_d
     uint32_t max_probe = cfg.max_probe ? cfg.max_probe : 1;
     
     for (uint32_t probe = 0; probe < max_probe; ++probe) {
-        cache_item_data_t *existing = atomic_load_explicit(&table->buckets[idx].ptr, memory_order_acquire);
+        cache_item_data_t *existing = bench_pin(&table->buckets[idx]);
         if (!existing) {
+            bench_unpin();
             cache_item_data_t *expected = NULL;
             if (atomic_compare_exchange_strong_explicit(&table->buckets[idx].ptr, &expected, payload,
                                                        memory_order_release, memory_order_relaxed)) {
@@ -394,16 +420,20 @@ static cache_store_result_t cache_table_store(cache_table_t *table, cache_item_d
             continue;
         }
         if (existing->key == key || existing->expire_ns <= now_ns) {
+            bool forced = (existing->key != key);
             if (atomic_compare_exchange_strong_explicit(&table->buckets[idx].ptr, &existing, payload,
                                                        memory_order_release, memory_order_relaxed)) {
+                bench_unpin();
                 result.inserted = true;
                 result.replaced = cache_entry_from_payload(existing);
-                result.forced = (existing->key != key);
+                result.forced = forced;
                 return result;
             }
+            bench_unpin();
             idx = (idx + 1) & mask;
             continue;
         }
+        bench_unpin();
         idx = (idx + 1) & mask;
     }
 
@@ -417,16 +447,17 @@ static size_t cache_table_cleanup(cache_table_t *table, size_t cursor, size_t bu
     size_t start = cursor;
     size_t count = table->bucket_count;
     for (size_t i = 0; i < budget; ++i) {
-        cache_item_data_t *payload = atomic_load_explicit(&table->buckets[start].ptr, memory_order_acquire);
+        cache_item_data_t *payload = bench_pin(&table->buckets[start]);
         if (payload && payload->expire_ns <= now_ns) {
             cache_item_data_t *expected = payload;
             if (atomic_compare_exchange_strong_explicit(&table->buckets[start].ptr, &expected, NULL,
                                                        memory_order_release, memory_order_relaxed)) {
-                ttak_epoch_retire(payload, retire_payload_cleanup);
+                bench_retire(payload);
                 TTAK_FAST_ATOMIC_ADD_U64(&stats.cleanups, 1);
                 TTAK_FAST_ATOMIC_ADD_U64(&stats.retirements, 1);
             }
         }
+        bench_unpin();
         start = (start + 1) & mask;
     }
     return start % count;
@@ -486,7 +517,7 @@ static bool bench_perform_write(worker_ctx_t *ctx, cache_table_t *table, uint64_
     }
     if (store_res.replaced) {
         (*local_retirements)++;
-        ttak_epoch_retire(store_res.replaced->data, retire_payload_cleanup);
+        bench_retire((cache_item_data_t *)store_res.replaced->data);
     }
     if (store_res.forced) {
         (*local_evictions)++;
@@ -527,7 +558,7 @@ static void *worker_func(void *arg) {
         uint64_t start = sample_tick ? bench_read_cycles() : 0;
         uint32_t ops_this_batch = 0;
 
-        ttak_epoch_enter();
+        if (cfg.reclaim_mode == TTAK_RECLAIM_EPOCH) ttak_epoch_enter();
         for (uint32_t r = 0; r < cfg.read_batch; ++r) {
             if (!(TTAK_FAST_ATOMIC_LOAD_U64(&g_running) & 0xFF)) {
                 break;
@@ -538,6 +569,7 @@ static void *worker_func(void *arg) {
             if (lookup.kind == CACHE_RESULT_HIT && lookup.item) {
                 volatile uint8_t *payload_bytes = (volatile uint8_t *)lookup.item->value.data;
                 local_checksum ^= payload_bytes[r & (CACHE_PAYLOAD_BYTES - 1)];
+                bench_unpin();
                 local_hits++;
             } else if (lookup.kind == CACHE_RESULT_EXPIRED) {
                 local_expired++;
@@ -556,7 +588,7 @@ static void *worker_func(void *arg) {
                 }
             }
         }
-        ttak_epoch_exit();
+        if (cfg.reclaim_mode == TTAK_RECLAIM_EPOCH) ttak_epoch_exit();
 
         if (sample_tick && ops_this_batch) {
             uint64_t end = bench_read_cycles();
@@ -593,6 +625,7 @@ worker_cleanup:
         TTAK_FAST_ATOMIC_ADD_U64(&stats.retirements, local_retired);
         TTAK_FAST_ATOMIC_ADD_U64(&stats.total_ticks, local_ticks);
     }
+    ttak_hazard_deregister_thread();
     ttak_epoch_deregister_thread();
     return NULL;
 }
@@ -610,15 +643,20 @@ static void *maintenance_task(void *arg) {
         size_t budget = cfg.maintenance_scan ? cfg.maintenance_scan : 1024;
         size_t cursor = atomic_load_explicit(&g_maintenance_cursor, memory_order_relaxed);
         if (g_table && budget > 0) {
-            ttak_epoch_enter();
+            if (cfg.reclaim_mode == TTAK_RECLAIM_EPOCH) ttak_epoch_enter();
             size_t next = cache_table_cleanup(g_table, cursor % g_table->bucket_count, budget, now_ns);
-            ttak_epoch_exit();
+            if (cfg.reclaim_mode == TTAK_RECLAIM_EPOCH) ttak_epoch_exit();
             atomic_store_explicit(&g_maintenance_cursor, next, memory_order_relaxed);
         }
         bench_usleep_us(1000000);
-        ttak_epoch_reclaim();
-        ttak_epoch_gc_rotate(&g_gc);
+        if (cfg.reclaim_mode == TTAK_RECLAIM_HAZARD) {
+            ttak_hazard_scan();
+        } else {
+            ttak_epoch_reclaim();
+        }
+        if (!cfg.gc_reclaimer) ttak_epoch_gc_rotate(&g_gc);
     }
+    ttak_hazard_deregister_thread();
     ttak_epoch_deregister_thread();
     return NULL;
 }
@@ -748,6 +786,14 @@ int main(void) {
         int warm = atoi(warm_env);
         if (warm >= 0) cfg.warmup_ops = (uint32_t)warm;
     }
+    const char *reclaim_env = getenv("TTAK_BENCH_RECLAIM");
+    if (reclaim_env && reclaim_env[0]) {
+        cfg.reclaim_mode = strcmp(reclaim_env, "hazard") == 0 ? TTAK_RECLAIM_HAZARD : TTAK_RECLAIM_EPOCH;
+    }
+    const char *gc_env = getenv("TTAK_BENCH_GC_RECLAIMER");
+    if (gc_env && gc_env[0]) {
+        cfg.gc_reclaimer = atoi(gc_env) != 0;
+    }
     const char *duration_env = getenv("TTAK_BENCH_DURATION_SEC");
     if (duration_env && *duration_env) {
         int duration = atoi(duration_env);
@@ -812,6 +858,11 @@ int main(void) {
 
     g_cache = ttak_mem_alloc(sizeof(ttak_shared_t), 0, ttak_get_tick_count());
     ttak_shared_init(g_cache);
+    if (cfg.gc_reclaimer && ttak_epoch_gc_start_reclaimer(&g_gc, NULL) != 0) {
+        fprintf(stderr, "Failed to start the epoch GC reclaimer; rotating from maintenance\n");
+        cfg.gc_reclaimer = false;
+    }
+    g_cache->set_reclaim_mode(g_cache, cfg.reclaim_mode);
     g_cache->allocate_typed(g_cache, sizeof(cache_item_data_t), "cache_item_data_t", TTAK_SHARED_NO_LEVEL);
     bench_install_table(g_table);
     for (int i = 0; i < cfg.num_threads; ++i) {
@@ -866,9 +917,11 @@ int main(void) {
         }
     }
 
-    printf("Workers: %d (maintenance threads: 1) | write_pct=%u | ttl_ns=%" PRIu64 " | batch=%u | keyspace=%" PRIu64 " hot=%" PRIu64 " (%u%%)\n",
+    printf("Workers: %d (maintenance threads: 1) | write_pct=%u | ttl_ns=%" PRIu64 " | batch=%u | keyspace=%" PRIu64 " hot=%" PRIu64 " (%u%%) | reclaim=%s%s\n",
            cfg.num_threads, cfg.write_pct, cfg.ttl_ns, cfg.read_batch, cfg.key_space,
-           cfg.hot_key_space, cfg.hot_key_pct);
+           cfg.hot_key_space, cfg.hot_key_pct,
+           cfg.reclaim_mode == TTAK_RECLAIM_HAZARD ? "hazard" : "epoch",
+           cfg.gc_reclaimer ? " (gc reclaimer thread)" : "");
     printf("Time | Ops/s | Hit%% | Miss%% | Exp%% | Writes/s | Latency(ns) | Epoch | RSS(KB) | Evict/s | Clean/s | Retire/s\n");
     printf("------------------------------------------------------------------------------------------------------------------\n");
 
@@ -914,5 +967,6 @@ cleanup:
         pthread_join(threads[i], NULL);
     }
     free(threads);
+    ttak_epoch_gc_stop_reclaimer(&g_gc);
     return exit_code;
 }
@@ -74,6 +74,40 @@ extern "C" {
 #  endif
 #endif
 
+/* ============================================================================
+ * Runtime feature detection
+ * ============================================================================ */
+
+/**
+ * @brief ISA extensions the running CPU and OS support.
+ *
+ * Unlike the TTAK_HAS_* macros, which describe what the compiler may emit
+ * unconditionally, these bits are probed at runtime so one binary can pick
+ * a kernel per host.
+ */
+typedef enum ttak_arch_feature {
+    TTAK_ARCH_FEATURE_SSE2    = (1u << 0),
+    TTAK_ARCH_FEATURE_AVX2    = (1u << 1),
+    TTAK_ARCH_FEATURE_AVX512F = (1u << 2),
+    TTAK_ARCH_FEATURE_NEON    = (1u << 3),
+    TTAK_ARCH_FEATURE_SVE     = (1u << 4),
+    TTAK_ARCH_FEATURE_AES     = (1u << 5),  /**< AES-NI, or the ARMv8 AES instructions. */
+    TTAK_ARCH_FEATURE_BMI2    = (1u << 6),  /**< x86 mulx. */
+    TTAK_ARCH_FEATURE_ADX     = (1u << 7),  /**< x86 adcx / adox. */
+    TTAK_ARCH_FEATURE_AVX512IFMA = (1u << 8), /**< x86 vpmadd52luq / vpmadd52huq. */
+    TTAK_ARCH_FEATURE_CRC32C  = (1u << 9),  /**< SSE4.2 crc32, or the ARMv8 CRC32 instructions. */
+    TTAK_ARCH_FEATURE_CX16    = (1u << 10), /**< x86 cmpxchg16b. */
+    TTAK_ARCH_FEATURE_LSE     = (1u << 11), /**< ARMv8.1 atomics (cas, casp, ldadd). */
+    TTAK_ARCH_FEATURE_FMA     = (1u << 12)  /**< x86 vfmadd (FMA3). */
+} ttak_arch_feature_t;
+
+/**
+ * @brief Returns the ttak_arch_feature_t bits of the running host.
+ *
+ * Probed once (cpuid / getauxval) and cached. TinyCC builds report none.
+ */
+uint32_t ttak_arch_features(void);
+
 /* ============================================================================
  * Force-inline helper
  * ============================================================================ */
@@ -121,6 +155,23 @@ TTAK_ARCH_INLINE void ttak_arch_pause(void) {
 #endif
 }
 
+/* ============================================================================
+ * Software prefetch
+ * ============================================================================ */
+
+/**
+ * @brief Hints that the cache line holding @p p will be read soon.
+ */
+TTAK_ARCH_INLINE void ttak_arch_prefetch(const void *p) {
+#if defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG)
+    __builtin_prefetch(p, 0, 3);
+#elif defined(TTAK_COMPILER_MSVC) && defined(TTAK_ARCH_X86_64)
+    _mm_prefetch((const char *)p, _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
 /* ============================================================================
  * Timestamp counter
  * ============================================================================ */
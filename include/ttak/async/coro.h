@@ -0,0 +1,144 @@
+/**
+ * @file coro.h
+ * @brief Stackless coroutines that suspend on futures, timers and fds.
+ *
+ * A coroutine is a resumable function driven by a thread pool. Its body is
+ * wrapped in TTAK_CORO_BEGIN()/TTAK_CORO_END() and may suspend at any of
+ * the TTAK_CORO_* points; when the awaited event fires the body re-enters
+ * at the point after the suspension, on whichever worker picks it up.
+ *
+ * No stack is kept across a suspension: locals do not survive one, so
+ * persistent state lives in the @c arg object. Like protothreads, the
+ * suspension points may not appear inside a nested @c switch.
+ *
+ * @code
+ * static ttak_coro_status_t session(ttak_coro_t *co, void *arg) {
+ *     session_t *s = arg;
+ *     TTAK_CORO_BEGIN(co);
+ *     TTAK_CORO_AWAIT_FD(co, s->fd, POLLIN, TT_SECOND(5));
+ *     if (!(ttak_coro_revents(co) & POLLIN)) TTAK_CORO_RETURN(co, NULL);
+ *     TTAK_CORO_AWAIT_FUTURE(co, lookup(s));
+ *     s->row = ttak_coro_value(co);
+ *     TTAK_CORO_END(co);
+ * }
+ * @endcode
+ */
+
+#ifndef TTAK_ASYNC_CORO_H
+#define TTAK_ASYNC_CORO_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <ttak/async/future.h>
+#include <ttak/thread/pool.h>
+#include <ttak/types/ttak_compiler.h>
+
+/**
+ * @brief What a coroutine step returned to its driver.
+ */
+typedef enum ttak_coro_status {
+    TTAK_CORO_DONE  = 0, /**< Finished; @c result fulfils the done future. */
+    TTAK_CORO_YIELD = 1, /**< Re-queue on the pool straight away. */
+    TTAK_CORO_WAIT  = 2  /**< Parked until the armed event wakes it. */
+} ttak_coro_status_t;
+
+typedef struct ttak_coro ttak_coro_t;
+
+/**
+ * @brief Coroutine body; re-entered from its last suspension point.
+ */
+typedef ttak_coro_status_t (*ttak_coro_fn)(ttak_coro_t *co, void *arg);
+
+/**
+ * @brief Coroutine control block. Only the macros below touch its fields.
+ */
+struct ttak_coro {
+    int resume_point;          /**< Line of the last suspension; 0 before the first run. */
+    ttak_coro_fn fn;           /**< Body. */
+    void *arg;                 /**< Body state kept across suspensions. */
+    ttak_thread_pool_t *pool;  /**< Pool every step runs on. */
+    int priority;              /**< Priority of each step's task. */
+    void *value;               /**< Result of the last awaited future. */
+    short revents;             /**< Events of the last fd wait; 0 on timeout. */
+    void *result;              /**< Set by TTAK_CORO_RETURN(). */
+    ttak_future_t *done;       /**< Fulfilled with @c result on completion. */
+    _Atomic int run_state;     /**< Handshake between a step and its wakeup. */
+};
+
+/**
+ * @brief Starts @p fn on @p pool.
+ *
+ * The control block is freed once @p fn returns TTAK_CORO_DONE.
+ *
+ * @return A caller-owned future fulfilled with the coroutine's result (free
+ *         it with ttak_future_destroy()), or NULL on failure.
+ */
+ttak_future_t *ttak_coro_spawn(ttak_thread_pool_t *pool, ttak_coro_fn fn, void *arg, int priority, uint64_t now);
+
+/**
+ * @brief Arms a wakeup for when @p future is fulfilled.
+ *
+ * @return False if the coroutine should not suspend; the value is then
+ *         already in @c co->value, or NULL if the wait could not be armed.
+ */
+_Bool ttak_coro_arm_future(ttak_coro_t *co, ttak_future_t *future);
+
+/**
+ * @brief Arms a wakeup for @p events on @p fd, or after @p timeout_ns.
+ *
+ * A negative @p fd waits only for the timeout; a zero @p timeout_ns waits
+ * without one. Waits are served by one shared reactor thread.
+ *
+ * @return False if the wait could not be armed; @c co->revents is then 0.
+ */
+_Bool ttak_coro_arm_fd(ttak_coro_t *co, int fd, short events, uint64_t timeout_ns);
+
+/**
+ * @brief Stops the reactor thread, waking every waiting coroutine with
+ *        @c revents 0. The next fd or timer wait starts it again.
+ */
+void ttak_coro_reactor_shutdown(void);
+
+/** @brief Result of the last TTAK_CORO_AWAIT_FUTURE(). */
+static inline void *ttak_coro_value(const ttak_coro_t *co) { return co->value; }
+
+/** @brief Events seen by the last TTAK_CORO_AWAIT_FD(); 0 on timeout. */
+static inline short ttak_coro_revents(const ttak_coro_t *co) { return co->revents; }
+
+#define TTAK_CORO_BEGIN(co) switch ((co)->resume_point) { case 0:
+
+#define TTAK_CORO_END(co) } (co)->resume_point = -1; return TTAK_CORO_DONE
+
+/** @brief Finishes the coroutine with @p val as its result. */
+#define TTAK_CORO_RETURN(co, val)                                                 \
+    do {                                                                          \
+        (co)->result = (val);                                                     \
+        (co)->resume_point = -1;                                                  \
+        return TTAK_CORO_DONE;                                                    \
+    } while (0)
+
+/** @brief Lets other tasks run, then continues on any worker. */
+#define TTAK_CORO_YIELD(co)                                                       \
+    do {                                                                          \
+        (co)->resume_point = __LINE__;                                            \
+        return TTAK_CORO_YIELD;                                                   \
+        case __LINE__:;                                                           \
+    } while (0)
+
+/** @brief Suspends if @p arm (an expression arming one wakeup) is true. */
+#define TTAK_CORO_SUSPEND_IF(co, arm)                                             \
+    do {                                                                          \
+        (co)->resume_point = __LINE__;                                            \
+        if (arm) return TTAK_CORO_WAIT;                                           \
+        TTAK_FALLTHROUGH;                                                         \
+        case __LINE__:;                                                           \
+    } while (0)
+
+#define TTAK_CORO_AWAIT_FUTURE(co, future) TTAK_CORO_SUSPEND_IF(co, ttak_coro_arm_future((co), (future)))
+
+#define TTAK_CORO_AWAIT_FD(co, fd, events, timeout_ns) \
+    TTAK_CORO_SUSPEND_IF(co, ttak_coro_arm_fd((co), (fd), (events), (timeout_ns)))
+
+#define TTAK_CORO_SLEEP(co, ns) TTAK_CORO_SUSPEND_IF(co, ttak_coro_arm_fd((co), -1, 0, (ns)))
+
+#endif // TTAK_ASYNC_CORO_H
@@ -1,17 +1,34 @@
 /**
  * @file future.h
- * @brief Simple blocking future for async task result retrieval.
+ * @brief Future for async task result retrieval, blocking or chained.
  *
  * A @c ttak_future_t is produced by ttak_promise_get_future() and consumed
- * by calling ttak_future_get(), which blocks the caller until the associated
- * promise is fulfilled.
+ * either by calling ttak_future_get(), which blocks the caller until the
+ * associated promise is fulfilled, or by attaching a continuation with
+ * ttak_future_then(), ttak_future_when_all() or ttak_future_when_any(),
+ * which run when the value arrives and never park a thread.
  */
 
 #ifndef TTAK_ASYNC_FUTURE_H
 #define TTAK_ASYNC_FUTURE_H
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct ttak_thread_pool;
+
+/** @brief ttak_future_t::state values; zero-initialised futures are pending. */
+enum {
+    TTAK_FUTURE_PENDING = 0,
+    TTAK_FUTURE_PARKED = 1,  /**< Pending, and a reader may be asleep on @c state. */
+    TTAK_FUTURE_READY = 2,
+};
+
+/** @brief Continuation node queued on a pending future (opaque). */
+typedef struct ttak_future_cont ttak_future_cont_t;
 
 /**
  * @brief Blocking future that carries a single void* result.
@@ -20,9 +37,15 @@ typedef struct ttak_future {
     void            *result; /**< Result pointer set by the fulfilling promise. */
     _Bool           ready;   /**< Non-zero once the result is available. */
     pthread_mutex_t mutex;   /**< Guards @c ready and @c result. */
-    pthread_cond_t  cond;    /**< Signalled when @c ready becomes true. */
+    _Atomic uint32_t state;  /**< Wait word: TTAK_FUTURE_PENDING, _PARKED or _READY. */
+    ttak_future_cont_t *conts; /**< Continuations to fire on fulfilment; guarded by @c mutex. */
 } ttak_future_t;
 
+/**
+ * @brief Continuation body: receives the source result and the user argument.
+ */
+typedef void *(*ttak_future_then_fn)(void *result, void *arg);
+
 /**
  * @brief Blocks until the future is fulfilled and returns its result.
  *
@@ -31,4 +54,68 @@ typedef struct ttak_future {
  */
 void *ttak_future_get(ttak_future_t *future);
 
+/**
+ * @brief Returns true once the future holds its result.
+ */
+_Bool ttak_future_is_ready(ttak_future_t *future);
+
+/**
+ * @brief Stores @p val, wakes blocked readers and fires queued continuations.
+ *
+ * One-shot: later calls are ignored. ttak_promise_set_value() forwards here.
+ */
+void ttak_future_fulfill(ttak_future_t *future, void *val, uint64_t now);
+
+/**
+ * @brief Calls @p cb(result, arg) once @p future is fulfilled.
+ *
+ * The callback runs inline on the fulfilling thread, or on the caller if
+ * the future is already ready, so it should only hand work off.
+ *
+ * @return False on invalid arguments or allocation failure.
+ */
+_Bool ttak_future_on_ready(ttak_future_t *future, void (*cb)(void *result, void *arg), void *arg, uint64_t now);
+
+/**
+ * @brief Chains @p fn onto @p future without blocking.
+ *
+ * When @p future is fulfilled, @p fn(result, arg) is submitted to @p pool as
+ * a detached task, and its return value fulfils the returned future. With a
+ * NULL @p pool, or if the pool refuses the task, @p fn runs inline on the
+ * fulfilling thread (or on the caller if @p future is already ready).
+ *
+ * @return A new future owned by the caller (see ttak_future_destroy()), or
+ *         NULL on invalid arguments or allocation failure.
+ */
+ttak_future_t *ttak_future_then(ttak_future_t *future, struct ttak_thread_pool *pool,
+                                ttak_future_then_fn fn, void *arg, uint64_t now);
+
+/**
+ * @brief Returns a future fulfilled once every one of @p futures is.
+ *
+ * If @p results is non-NULL, results[i] receives the result of futures[i]
+ * before the combined future resolves; its result is @p results itself.
+ *
+ * @return A new caller-owned future, or NULL on invalid arguments.
+ */
+ttak_future_t *ttak_future_when_all(ttak_future_t *const *futures, size_t count, void **results, uint64_t now);
+
+/**
+ * @brief Returns a future fulfilled with the result of the first of
+ *        @p futures to resolve.
+ *
+ * If @p index is non-NULL it receives the winner's position first. The
+ * sources must outlive their own fulfilment, as with any continuation.
+ *
+ * @return A new caller-owned future, or NULL on invalid arguments.
+ */
+ttak_future_t *ttak_future_when_any(ttak_future_t *const *futures, size_t count, size_t *index, uint64_t now);
+
+/**
+ * @brief Frees a future returned by the chaining helpers.
+ *
+ * Only call once it is ready and no continuation is still being attached.
+ */
+void ttak_future_destroy(ttak_future_t *future);
+
 #endif // TTAK_ASYNC_FUTURE_H
@@ -24,10 +24,22 @@
 /**
  * @brief Initialises the global async thread pool.
  *
+ * The workers are not started here; the first ttak_async_pool() call
+ * builds the pool, so a process that never runs parallel work spawns no
+ * threads.
+ *
  * @param nice Base nice value applied to worker threads (0 = normal).
  */
 void ttak_async_init(int nice);
 
+/**
+ * @brief Returns the global async pool, building it on first use.
+ *
+ * @return The pool, or NULL if ttak_async_init() has not been called or
+ *         the pool could not be created.
+ */
+struct ttak_thread_pool *ttak_async_pool(void);
+
 /** @brief Signals all workers to drain their queues and exit. */
 void ttak_async_shutdown(void);
 
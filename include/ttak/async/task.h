@@ -19,6 +19,10 @@ struct ttak_promise;
 
 typedef struct ttak_promise ttak_promise_t;
 
+struct ttak_wait_group;
+
+typedef struct ttak_wait_group ttak_wait_group_t;
+
 /**
  * @brief Creates a new task.
  *
@@ -36,6 +40,12 @@ ttak_task_t *ttak_task_create(ttak_task_func_t func, void *arg, ttak_promise_t *
  */
 void ttak_task_execute(ttak_task_t *task, uint64_t now);
 
+/**
+ * @brief Completes the task without running it: its promise resolves to
+ *        NULL and its wait group, if any, is marked done.
+ */
+void ttak_task_shed(ttak_task_t *task, uint64_t now);
+
 /**
  * @brief Destroys the task and frees resources.
  *
@@ -52,6 +62,14 @@ void ttak_task_destroy(ttak_task_t *task, uint64_t now);
  */
 ttak_task_t *ttak_task_clone(const ttak_task_t *task, uint64_t now);
 
+/**
+ * @brief Returns the hash ttak_task_create() assigns to a (func, arg) pair.
+ *
+ * Lets wrappers that run @p func through a trampoline keep the routing and
+ * history identity of the wrapped call.
+ */
+uint64_t ttak_task_hash_of(ttak_task_func_t func, void *arg);
+
 /**
  * @brief Sets the hash for the task (used for history/prediction).
  */
@@ -92,4 +110,26 @@ void ttak_task_set_urgency(ttak_task_t *task, uint8_t urgency);
  */
 uint8_t ttak_task_get_urgency(const ttak_task_t *task);
 
+/**
+ * @brief Sets an absolute deadline in ttak_get_tick_count() milliseconds
+ *        (e.g. ttak_deadline_t::deadline_ts); 0 clears it.
+ *
+ * A pool runs deadline tasks earliest-deadline-first ahead of its priority
+ * queues and sheds those already past due instead of running them.
+ */
+void ttak_task_set_deadline(ttak_task_t *task, uint64_t deadline_ts);
+
+/**
+ * @brief Gets the task deadline, or 0 if it has none.
+ */
+uint64_t ttak_task_get_deadline(const ttak_task_t *task);
+
+/**
+ * @brief Attaches a wait group that ttak_task_execute() marks done after the
+ *        function returns. The caller accounts for the task with
+ *        ttak_wait_group_add() beforehand. Like the promise, the group is
+ *        shared with clones, so only one of them may be executed.
+ */
+void ttak_task_set_wait_group(ttak_task_t *task, ttak_wait_group_t *wg);
+
 #endif // TTAK_ASYNC_TASK_H
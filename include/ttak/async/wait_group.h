@@ -0,0 +1,62 @@
+/**
+ * @file wait_group.h
+ * @brief Counter-based fork/join completion for many tasks at once.
+ *
+ * A wait group replaces one promise/future pair per task with a single
+ * atomic counter shared by all of them: the submitter adds one per task,
+ * each task marks itself done when it returns, and ttak_wait_group_wait()
+ * blocks until the counter reaches zero. The group's mutex and condition
+ * variable are only touched when a waiter is actually asleep.
+ */
+
+#ifndef TTAK_ASYNC_WAIT_GROUP_H
+#define TTAK_ASYNC_WAIT_GROUP_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+/**
+ * @brief Outstanding-task counter with a sleeping-waiter fallback.
+ */
+typedef struct ttak_wait_group {
+    _Atomic size_t  pending; /**< Tasks added but not yet done. */
+    _Atomic size_t  waiters; /**< Threads asleep (or about to be) in ttak_wait_group_wait(). */
+    pthread_mutex_t mutex;   /**< Pairs with @c cond for sleeping waiters. */
+    pthread_cond_t  cond;    /**< Broadcast when @c pending drops to zero. */
+} ttak_wait_group_t;
+
+/**
+ * @brief Initialises an empty group.
+ */
+void ttak_wait_group_init(ttak_wait_group_t *wg);
+
+/**
+ * @brief Destroys the group. No task may still reference it.
+ */
+void ttak_wait_group_destroy(ttak_wait_group_t *wg);
+
+/**
+ * @brief Adds @p count outstanding tasks. Call before the tasks are submitted.
+ */
+void ttak_wait_group_add(ttak_wait_group_t *wg, size_t count);
+
+/**
+ * @brief Marks one task done, waking waiters when it was the last.
+ */
+void ttak_wait_group_done(ttak_wait_group_t *wg);
+
+/**
+ * @brief Returns the number of outstanding tasks.
+ */
+size_t ttak_wait_group_pending(ttak_wait_group_t *wg);
+
+/**
+ * @brief Blocks until every added task is done.
+ *
+ * Spins briefly first, then sleeps. Like ttak_future_get(), the caller
+ * leaves its epoch critical section while asleep.
+ */
+void ttak_wait_group_wait(ttak_wait_group_t *wg);
+
+#endif // TTAK_ASYNC_WAIT_GROUP_H
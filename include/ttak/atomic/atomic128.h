@@ -0,0 +1,162 @@
+/**
+ * @file atomic128.h
+ * @brief Lock-free 128-bit load and compare-and-swap.
+ *
+ * Tagged pointers that carry a full pointer next to a 64-bit ABA counter
+ * need a double-width CAS. C11 only promises that for _Atomic types the
+ * compiler deems lock-free, and GCC routes 16-byte atomics through
+ * libatomic, which may take a lock. These primitives emit the instruction
+ * directly: @c lock @c cmpxchg16b on x86-64, @c caspal with LSE on AArch64
+ * and an @c ldaxp / @c stlxp loop on AArch64 without it.
+ *
+ * When the build already targets an ISA that has the instruction
+ * (TTAK_ATOMIC128_NATIVE), the calls inline to it. Otherwise they go
+ * through ttak_atomic128_cas_runtime(), which picks the instruction from
+ * ttak_arch_features() and takes a sharded mutex only when the host has
+ * none; ttak_atomic128_is_lock_free() reports which one was picked.
+ *
+ * Objects must be 16-byte aligned and writable, including those that are
+ * only loaded: the load is a CAS that stores back the value it read.
+ */
+
+#ifndef TTAK_ATOMIC_ATOMIC128_H
+#define TTAK_ATOMIC_ATOMIC128_H
+
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/types/fixed.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief A 128-bit atomic object, low word at the lower address.
+ *
+ * Values go in and out as ttak_u128_t, which need not be aligned.
+ */
+typedef struct ttak_atomic128 {
+    _Alignas(16) uint64_t lo;
+    uint64_t hi;
+} ttak_atomic128_t;
+
+#if defined(TTAK_COMPILER_MSVC) && (defined(TTAK_ARCH_X86_64) || defined(TTAK_ARCH_AARCH64))
+#  define TTAK_ATOMIC128_NATIVE 1
+#elif (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG)) && defined(TTAK_ARCH_X86_64) && \
+    defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#  define TTAK_ATOMIC128_NATIVE 1
+#elif (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG)) && defined(TTAK_ARCH_AARCH64) && \
+    defined(__ARM_FEATURE_ATOMICS)
+#  define TTAK_ATOMIC128_NATIVE 1
+#else
+#  define TTAK_ATOMIC128_NATIVE 0
+#endif
+
+/*
+ * Per-instruction CAS bodies. They are available whenever the compiler can
+ * assemble them, so the runtime path can use them on hosts the build did
+ * not assume. Each is a strong, sequentially consistent CAS that writes the
+ * observed value to @p expected on failure.
+ */
+
+#if (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG)) && defined(TTAK_ARCH_X86_64)
+#  define TTAK_ATOMIC128_HAVE_CX16 1
+TTAK_ARCH_INLINE bool ttak_atomic128_cas_cx16(ttak_atomic128_t *obj, ttak_u128_t *expected, ttak_u128_t desired) {
+    bool ok;
+    __asm__ __volatile__("lock cmpxchg16b %1"
+                         : "=@ccz"(ok), "+m"(*obj), "+a"(expected->lo), "+d"(expected->hi)
+                         : "b"(desired.lo), "c"(desired.hi)
+                         : "memory");
+    return ok;
+}
+#endif
+
+#if (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG)) && defined(TTAK_ARCH_AARCH64)
+#  define TTAK_ATOMIC128_HAVE_LSE 1
+#  define TTAK_ATOMIC128_HAVE_LLSC 1
+TTAK_ARCH_INLINE bool ttak_atomic128_cas_lse(ttak_atomic128_t *obj, ttak_u128_t *expected, ttak_u128_t desired) {
+    /* casp wants consecutive even/odd register pairs. */
+    register uint64_t x0 __asm__("x0") = expected->lo;
+    register uint64_t x1 __asm__("x1") = expected->hi;
+    register uint64_t x2 __asm__("x2") = desired.lo;
+    register uint64_t x3 __asm__("x3") = desired.hi;
+    const uint64_t lo = expected->lo, hi = expected->hi;
+    __asm__ __volatile__(".arch_extension lse\n\t"
+                         "caspal %0, %1, %3, %4, %2"
+                         : "+r"(x0), "+r"(x1), "+Q"(*obj)
+                         : "r"(x2), "r"(x3)
+                         : "memory");
+    expected->lo = x0;
+    expected->hi = x1;
+    return x0 == lo && x1 == hi;
+}
+
+TTAK_ARCH_INLINE bool ttak_atomic128_cas_llsc(ttak_atomic128_t *obj, ttak_u128_t *expected, ttak_u128_t desired) {
+    uint64_t lo, hi;
+    uint32_t fail;
+    /* A mismatch still stores the pair back: only a successful stlxp
+     * proves the two words were read as one. */
+    __asm__ __volatile__("1: ldaxp %0, %1, %3\n\t"
+                         "cmp %0, %4\n\t"
+                         "ccmp %1, %5, #0, eq\n\t"
+                         "b.ne 2f\n\t"
+                         "stlxp %w2, %6, %7, %3\n\t"
+                         "cbnz %w2, 1b\n\t"
+                         "b 3f\n"
+                         "2: stlxp %w2, %0, %1, %3\n\t"
+                         "cbnz %w2, 1b\n"
+                         "3:"
+                         : "=&r"(lo), "=&r"(hi), "=&r"(fail), "+Q"(*obj)
+                         : "r"(expected->lo), "r"(expected->hi), "r"(desired.lo), "r"(desired.hi)
+                         : "cc", "memory");
+    const bool ok = lo == expected->lo && hi == expected->hi;
+    expected->lo = lo;
+    expected->hi = hi;
+    return ok;
+}
+#endif
+
+/**
+ * @brief CAS that chooses its instruction from the running host.
+ *
+ * Same contract as ttak_atomic128_cas(). Falls back to a mutex shard keyed
+ * by address when the host has no double-width CAS; all accesses to a
+ * given object must then go through these functions.
+ */
+bool ttak_atomic128_cas_runtime(ttak_atomic128_t *obj, ttak_u128_t *expected, ttak_u128_t desired);
+
+/** @brief True unless ttak_atomic128_cas_runtime() has to take a lock on this host. */
+bool ttak_atomic128_is_lock_free(void);
+
+/**
+ * @brief Strong, sequentially consistent 128-bit compare-and-swap.
+ *
+ * Stores @p desired if @p obj equals @p expected; otherwise copies the
+ * current value to @p expected.
+ * @return True if the swap happened.
+ */
+static inline bool ttak_atomic128_cas(ttak_atomic128_t *obj, ttak_u128_t *expected, ttak_u128_t desired) {
+#if TTAK_ATOMIC128_NATIVE && defined(TTAK_COMPILER_MSVC)
+    return _InterlockedCompareExchange128((volatile __int64 *)obj, (__int64)desired.hi, (__int64)desired.lo,
+                                          (__int64 *)expected) != 0;
+#elif TTAK_ATOMIC128_NATIVE && defined(TTAK_ATOMIC128_HAVE_CX16)
+    return ttak_atomic128_cas_cx16(obj, expected, desired);
+#elif TTAK_ATOMIC128_NATIVE && defined(TTAK_ATOMIC128_HAVE_LSE)
+    return ttak_atomic128_cas_lse(obj, expected, desired);
+#else
+    return ttak_atomic128_cas_runtime(obj, expected, desired);
+#endif
+}
+
+/** @brief Atomically reads @p obj (which must be writable, see above). */
+static inline ttak_u128_t ttak_atomic128_load(ttak_atomic128_t *obj) {
+    ttak_u128_t cur = ttak_u128_zero();
+    ttak_atomic128_cas(obj, &cur, cur);
+    return cur;
+}
+
+/** @brief Atomically replaces @p obj with @p value. */
+static inline void ttak_atomic128_store(ttak_atomic128_t *obj, ttak_u128_t value) {
+    ttak_u128_t cur = ttak_u128_zero();
+    while (!ttak_atomic128_cas(obj, &cur, value)) {
+    }
+}
+
+#endif // TTAK_ATOMIC_ATOMIC128_H
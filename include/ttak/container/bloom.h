@@ -0,0 +1,66 @@
+#ifndef TTAK_CONTAINER_BLOOM_H
+#define TTAK_CONTAINER_BLOOM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** 64-bit words per block; a block is one 64-byte cache line. */
+#define TTAK_BLOOM_BLOCK_WORDS 8
+
+/** Filter bits per expected key when the caller passes 0. */
+#define TTAK_BLOOM_DEFAULT_BITS_PER_KEY 10
+
+/**
+ * @brief Blocked Bloom filter.
+ *
+ * A key's hash picks one cache-line block and sets one bit in each of the
+ * block's eight words, so both insert and query touch a single line. At
+ * 10 bits per key the false-positive rate is about 1%. There are no false
+ * negatives; keys cannot be removed, so callers that delete rebuild the
+ * filter from their live contents instead.
+ */
+typedef struct ttak_bloom {
+    uint64_t    *words;     /**< nblocks * TTAK_BLOOM_BLOCK_WORDS words, 64-byte aligned */
+    size_t      nblocks;
+    size_t      capacity;   /**< Keys the filter was sized for */
+    size_t      count;      /**< Keys added */
+    uint64_t    seed;
+} ttak_bloom_t;
+
+/**
+ * @brief Creates a filter sized for @p expected keys.
+ *
+ * @param bits_per_key Filter bits per key, or 0 for the default.
+ * @return The filter, or NULL on allocation failure.
+ */
+ttak_bloom_t *ttak_bloom_create(size_t expected, unsigned bits_per_key);
+
+void ttak_bloom_destroy(ttak_bloom_t *filter);
+
+/**
+ * @brief Adds a key the caller has already hashed to 64 bits.
+ */
+void ttak_bloom_add_hash(ttak_bloom_t *filter, uint64_t hash);
+
+/**
+ * @brief False only if no key with this hash was ever added.
+ */
+bool ttak_bloom_may_contain_hash(const ttak_bloom_t *filter, uint64_t hash);
+
+/**
+ * @brief Adds @p len bytes at @p key, hashed with ttak_hash_bytes().
+ */
+void ttak_bloom_add(ttak_bloom_t *filter, const void *key, size_t len);
+
+/**
+ * @brief ttak_bloom_may_contain_hash() for a key hashed as by ttak_bloom_add().
+ */
+bool ttak_bloom_may_contain(const ttak_bloom_t *filter, const void *key, size_t len);
+
+/**
+ * @brief Forgets every key.
+ */
+void ttak_bloom_clear(ttak_bloom_t *filter);
+
+#endif // TTAK_CONTAINER_BLOOM_H
@@ -0,0 +1,113 @@
+#ifndef TTAK_CONTAINER_BYTERING_H
+#define TTAK_CONTAINER_BYTERING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/** Bytes of the length word in front of every record; payloads are aligned to it. */
+#define TTAK_BYTERING_HDR 8
+
+/**
+ * @brief Single-producer, single-consumer ring of variable-length records.
+ *
+ * Every record is stored contiguously behind an 8-byte length word, so the
+ * producer writes straight into the ring through ttak_bytering_reserve()
+ * and the consumer reads straight out of it through ttak_bytering_peek().
+ * A record that would straddle the end of the buffer is placed at the
+ * start instead, behind a padding marker the consumer skips. Positions and
+ * cached views are split across cache lines as in the SPSC ttak_ringbuf_t.
+ */
+typedef struct ttak_bytering {
+    uint8_t *buffer;        /**< Record storage. */
+    size_t capacity;        /**< Bytes; a power of two. */
+    size_t mask;            /**< capacity - 1. */
+
+    /* Producer side: committed position, view of the consumer, open reservation. */
+    _Alignas(64) _Atomic size_t prod_pos;
+    size_t prod_cached;
+    size_t reserved_at;     /**< Position of the reserved record's header. */
+    size_t reserved_len;    /**< Payload bytes reserved; 0 when none is open. */
+    /* Consumer side: released position, view of the producer, peeked record. */
+    _Alignas(64) _Atomic size_t cons_pos;
+    size_t cons_cached;
+    size_t peeked_len;      /**< Bytes the peeked record spans, header included. */
+} ttak_bytering_t;
+
+typedef ttak_bytering_t tt_bytering_t;
+
+/**
+ * @brief Creates a ring of at least @p capacity bytes, rounded up to a power of two.
+ *
+ * @return NULL on a size below 2 * TTAK_BYTERING_HDR or allocation failure.
+ */
+ttak_bytering_t *ttak_bytering_create(size_t capacity);
+
+/**
+ * @brief Destroys the ring.
+ */
+void ttak_bytering_destroy(ttak_bytering_t *ring);
+
+/**
+ * @brief Largest payload a single record may have: half the ring less the header.
+ *
+ * Any record up to this size fits once the consumer has drained the ring,
+ * whatever padding the wrap needs.
+ */
+size_t ttak_bytering_max_record(const ttak_bytering_t *ring);
+
+/**
+ * @brief Reserves @p len contiguous bytes for the next record.
+ *
+ * Producer only. Write the payload there and publish it with
+ * ttak_bytering_commit(); one reservation may be open at a time.
+ *
+ * @return The payload pointer, 8-byte aligned, or NULL if there is no room
+ *         yet or @p len exceeds ttak_bytering_max_record().
+ */
+void *ttak_bytering_reserve(ttak_bytering_t *ring, size_t len);
+
+/**
+ * @brief Publishes the open reservation with a payload of @p len bytes.
+ *
+ * @p len may be smaller than what was reserved (e.g. a log line reserved
+ * at its worst case); the unused tail goes back to the ring. Larger values
+ * are clamped to the reservation.
+ */
+void ttak_bytering_commit(ttak_bytering_t *ring, size_t len);
+
+/**
+ * @brief Copies @p len bytes in as one record.
+ *
+ * @return False if there is no room.
+ */
+bool ttak_bytering_push(ttak_bytering_t *ring, const void *data, size_t len);
+
+/**
+ * @brief Returns the oldest record in place.
+ *
+ * Consumer only. The pointer stays valid until ttak_bytering_release();
+ * peeking again before releasing returns the same record.
+ *
+ * @param len Receives the payload length.
+ * @return The payload, or NULL if the ring is empty.
+ */
+const void *ttak_bytering_peek(ttak_bytering_t *ring, size_t *len);
+
+/**
+ * @brief Frees the record returned by ttak_bytering_peek().
+ */
+void ttak_bytering_release(ttak_bytering_t *ring);
+
+/**
+ * @brief Checks if empty; a snapshot under concurrent use.
+ */
+bool ttak_bytering_is_empty(ttak_bytering_t *ring);
+
+/**
+ * @brief Bytes in use, headers and padding included; a snapshot under concurrent use.
+ */
+size_t ttak_bytering_used(ttak_bytering_t *ring);
+
+#endif // TTAK_CONTAINER_BYTERING_H
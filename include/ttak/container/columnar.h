@@ -0,0 +1,146 @@
+/**
+ * @file columnar.h
+ * @brief Struct-of-arrays table with vectorised filters and parallel scans.
+ *
+ * A table holds a fixed set of typed columns, each its own 64-byte aligned
+ * array, so a pass over one field streams only that field. Filters compare
+ * a whole column against a constant and produce a selection bitmap with
+ * one bit per row (AVX2 where available, a plain loop otherwise); further
+ * filters can AND into it, gathers copy out the selected values, and scans
+ * split the rows across a thread pool.
+ */
+
+#ifndef TTAK_CONTAINER_COLUMNAR_H
+#define TTAK_CONTAINER_COLUMNAR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/thread/pool.h>
+
+/** Most chunks a scan is split into; size per-chunk partials with it. */
+#define TTAK_COLUMNAR_MAX_CHUNKS 16
+
+/** Rows below which a scan chunk is not split off to another thread. */
+#define TTAK_COLUMNAR_MIN_CHUNK 16384
+
+/**
+ * @brief Element type of a column.
+ */
+typedef enum ttak_col_type {
+    TTAK_COL_U32 = 0,
+    TTAK_COL_I32,
+    TTAK_COL_F32,
+    TTAK_COL_U64,
+    TTAK_COL_I64,
+    TTAK_COL_F64
+} ttak_col_type_t;
+
+/**
+ * @brief Comparison a filter applies as @c value OP @c operand.
+ *
+ * Float comparisons are ordered, except NE, which is true for NaN, as in C.
+ */
+typedef enum ttak_col_op {
+    TTAK_COL_EQ = 0,
+    TTAK_COL_NE,
+    TTAK_COL_LT,
+    TTAK_COL_LE,
+    TTAK_COL_GT,
+    TTAK_COL_GE
+} ttak_col_op_t;
+
+/**
+ * @brief Columnar table. Create with ttak_columnar_create().
+ */
+typedef struct ttak_columnar {
+    size_t          ncols;
+    size_t          rows;
+    size_t          capacity;   /**< Rows every column has room for. */
+    ttak_col_type_t *types;
+    void            **cols;     /**< One aligned array per column. */
+} ttak_columnar_t;
+
+typedef ttak_columnar_t tt_columnar_t;
+
+/**
+ * @brief Scan callback: processes rows [@p begin, @p end) as chunk @p chunk.
+ *
+ * Chunks are disjoint and start on multiples of 64 rows, so each may also
+ * own its own words of a selection bitmap.
+ */
+typedef void (*ttak_columnar_scan_fn)(const ttak_columnar_t *table, size_t begin, size_t end,
+                                      size_t chunk, void *ctx);
+
+/**
+ * @brief Creates an empty table with @p ncols columns of the given types.
+ *
+ * @param init_rows Rows to reserve up front; 0 picks a small default.
+ * @return The table, or NULL on a bad type or allocation failure.
+ */
+ttak_columnar_t *ttak_columnar_create(const ttak_col_type_t *types, size_t ncols, size_t init_rows);
+
+/**
+ * @brief Frees the table and all of its columns.
+ */
+void ttak_columnar_destroy(ttak_columnar_t *table);
+
+/**
+ * @brief Bytes per element of @p type.
+ */
+size_t ttak_col_type_size(ttak_col_type_t type);
+
+/**
+ * @brief Appends @p nrows rows.
+ *
+ * @param cols One pointer per column to @p nrows values of its type.
+ * @return False on allocation failure; the table is then unchanged.
+ */
+bool ttak_columnar_append(ttak_columnar_t *table, size_t nrows, const void *const *cols);
+
+/**
+ * @brief The aligned array backing column @p col, valid until the next append.
+ */
+void *ttak_columnar_column(const ttak_columnar_t *table, size_t col);
+
+/**
+ * @brief Number of rows.
+ */
+size_t ttak_columnar_rows(const ttak_columnar_t *table);
+
+/**
+ * @brief Words a selection bitmap over the current rows needs.
+ */
+size_t ttak_columnar_mask_words(const ttak_columnar_t *table);
+
+/**
+ * @brief Marks the rows where column @p col compares true against @p operand.
+ *
+ * @param operand Points to one value of the column's type.
+ * @param sel     ttak_columnar_mask_words() words; bits past the last row are cleared.
+ * @param refine  AND into @p sel instead of overwriting it.
+ * @return Rows selected.
+ */
+size_t ttak_columnar_filter(const ttak_columnar_t *table, size_t col, ttak_col_op_t op,
+                            const void *operand, uint64_t *sel, bool refine);
+
+/**
+ * @brief Copies column @p col's values at the rows set in @p sel into @p out, in row order.
+ *
+ * @return Values written.
+ */
+size_t ttak_columnar_gather(const ttak_columnar_t *table, size_t col, const uint64_t *sel, void *out);
+
+/**
+ * @brief Runs @p fn over the rows split into up to TTAK_COLUMNAR_MAX_CHUNKS
+ *        chunks, all but the first on @p pool, and waits for them.
+ *
+ * With a NULL @p pool, or if the pool refuses a chunk, the chunks run on
+ * the calling thread.
+ *
+ * @return Chunks used; chunk indexes passed to @p fn are below it.
+ */
+size_t ttak_columnar_scan(const ttak_columnar_t *table, ttak_thread_pool_t *pool,
+                          ttak_columnar_scan_fn fn, void *ctx, uint64_t now);
+
+#endif // TTAK_CONTAINER_COLUMNAR_H
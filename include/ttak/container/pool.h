@@ -1,70 +1,164 @@
 #ifndef TTAK_CONTAINER_POOL_H
 #define TTAK_CONTAINER_POOL_H
 
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <ttak/sync/sync.h>
 #include <ttak/sync/spinlock.h>
+#include <ttak/types/ttak_compiler.h>
+
+/** Per-thread magazines per pool; threads beyond this share slots. */
+#define TTAK_OBJECT_POOL_MAGS 16
+
+/** Items a magazine holds before half of it is returned to the shared stack. */
+#define TTAK_OBJECT_POOL_MAG_CAPACITY 32
+
+/** Chunks a pool may grow to; each chunk after the first doubles the total. */
+#define TTAK_OBJECT_POOL_MAX_CHUNKS 33
+
+/**
+ * @brief Per-thread cache of free items, as indexes into the pool.
+ *
+ * Each thread is bound to one magazine of every pool; @c busy keeps two
+ * threads sharing a slot from using it at once, and the loser goes to the
+ * shared stack instead.
+ */
+typedef struct ttak_object_pool_mag {
+    _Alignas(64) _Atomic int busy;
+    uint32_t count;
+    uint32_t items[TTAK_OBJECT_POOL_MAG_CAPACITY];
+} ttak_object_pool_mag_t;
 
 /**
- * @brief Fixed-size Object Pool structure.
- * 
- * Efficiently manages a set of pre-allocated objects of the same size.
- * Uses a bitmap for allocation tracking and a spinlock for thread safety.
+ * @brief Growable pool of fixed-size objects.
+ *
+ * Allocation and free hit the calling thread's magazine and touch no
+ * shared line. Magazines refill from and spill to a lock-free Treiber stack
+ * whose head packs a 32-bit ABA tag with the index of the top item; free
+ * items link through their first four bytes. When both run dry, items are
+ * carved from never-used space, and only adding a chunk takes a lock.
  */
 typedef struct ttak_object_pool {
-    void *buffer;           /**< Contiguous memory block holding all items. */
-    uint8_t *bitmap;        /**< Bitmask indicating allocation status. */
+    void *buffer;           /**< First chunk, holding @c capacity items. */
     size_t item_size;       /**< Size of a single item. */
-    size_t capacity;        /**< Total capacity of the pool. */
-    size_t used_count;      /**< Number of currently allocated items. */
+    size_t stride;          /**< Distance between items, at least 4-byte aligned. */
+    size_t capacity;        /**< Items in the first chunk, a power of two; chunk k > 0 holds capacity << (k - 1). */
+    size_t max_items;       /**< Growth ceiling. */
+    uint32_t chunk_shift;   /**< log2(capacity). */
 
-    /* Fast O(1) LIFO free list (valid when item_size >= sizeof(void *)). */
-    void *free_list;        /**< Linked list of returned items. */
+    ttak_spin_t grow_lock;                           /**< Serialises adding a chunk. */
+    _Atomic uint32_t chunk_count;                    /**< Chunks published so far. */
+    char *chunks[TTAK_OBJECT_POOL_MAX_CHUNKS];       /**< Item storage per chunk. */
+    _Atomic uint8_t *live[TTAK_OBJECT_POOL_MAX_CHUNKS]; /**< Allocated flag per item, guarding double frees. */
 
-    /* Orthogonal Latin Square traversal state (order 8, 64 slots per lattice). */
-    size_t ols_chunk_count;   /**< Number of 8x8 tiles covering the capacity. */
-    size_t ols_chunk_cursor;  /**< Current tile cursor. */
-    uint8_t ols_lane_seed;    /**< Current 6-bit lane seed within the tile. */
-    uint8_t ols_lane_guard;   /**< Cycle guard to detect when to advance tiles. */
-    uint8_t ols_lane_stride;  /**< Coprime stride applied to the lane seed. */
-    size_t last_recycled_index; /**< Hot-slot recycled on the next allocation. */
+    _Alignas(64) _Atomic uint64_t free_head;  /**< Tagged stack head: tag << 32 | (index + 1). */
+    _Alignas(64) _Atomic uint64_t carved;     /**< Items handed out at least once. */
+    _Atomic uint64_t limit;                   /**< Items backed by published chunks. */
 
-    ttak_spin_t lock;       /**< Spinlock for protecting the bitmap/free list. */
+    ttak_object_pool_mag_t mags[TTAK_OBJECT_POOL_MAGS];
 } ttak_object_pool_t;
 
 typedef ttak_object_pool_t tt_object_pool_t;
 
+/** @brief First index of chunk @p k; chunk k > 0 also holds that many items. */
+static inline uint64_t ttak_object_pool_chunk_base(const ttak_object_pool_t *pool, uint32_t k) {
+    return k ? (uint64_t)pool->capacity << (k - 1) : 0;
+}
+
+/** @brief Chunk holding item @p idx. */
+static inline uint32_t ttak_object_pool_chunk_of(const ttak_object_pool_t *pool, uint32_t idx) {
+    uint64_t q = (uint64_t)idx >> pool->chunk_shift;
+    return q ? (uint32_t)(64 - __builtin_clzll(q)) : 0;
+}
+
+/** @brief Storage of item @p idx. */
+static inline char *ttak_object_pool_item(const ttak_object_pool_t *pool, uint32_t idx) {
+    uint32_t k = ttak_object_pool_chunk_of(pool, idx);
+    return pool->chunks[k] + (size_t)(idx - ttak_object_pool_chunk_base(pool, k)) * pool->stride;
+}
+
+/** @brief Allocated flag of item @p idx. */
+static inline _Atomic uint8_t *ttak_object_pool_live(const ttak_object_pool_t *pool, uint32_t idx) {
+    uint32_t k = ttak_object_pool_chunk_of(pool, idx);
+    return &pool->live[k][idx - ttak_object_pool_chunk_base(pool, k)];
+}
+
 /**
- * @brief Creates a new object pool.
- * 
- * @param capacity Maximum number of items.
+ * @brief Creates a new object pool that grows without a ceiling.
+ *
+ * @param capacity Items in the first chunk, rounded up to a power of two.
  * @param item_size Size of each item in bytes.
  * @return Pointer to the new pool, or NULL on failure.
  */
 ttak_object_pool_t *ttak_object_pool_create(size_t capacity, size_t item_size);
 
+/**
+ * @brief Creates a new object pool that grows up to @p max_items.
+ *
+ * @param capacity Items in the first chunk, rounded up to a power of two.
+ * @param item_size Size of each item in bytes.
+ * @param max_items Most items ever outstanding; 0 for no ceiling.
+ * @return Pointer to the new pool, or NULL on failure.
+ */
+ttak_object_pool_t *ttak_object_pool_create_ex(size_t capacity, size_t item_size, size_t max_items);
+
 /**
  * @brief Destroys the object pool and frees memory.
- * 
+ *
  * @param pool Pointer to the pool.
  */
 void ttak_object_pool_destroy(ttak_object_pool_t *pool);
 
 /**
  * @brief Allocates an object from the pool.
- * 
+ *
  * @param pool Pointer to the pool.
- * @return Pointer to the allocated object, or NULL if pool is full.
+ * @return Pointer to the allocated object, or NULL if the pool cannot grow.
  */
 void *ttak_object_pool_alloc(ttak_object_pool_t *pool);
 
 /**
  * @brief Returns an object to the pool (frees it).
- * 
+ *
+ * Pointers the pool did not hand out, and second frees, are ignored.
+ *
  * @param pool Pointer to the pool.
  * @param ptr Pointer to the object to free.
  */
 void ttak_object_pool_free(ttak_object_pool_t *pool, void *ptr);
 
+/**
+ * @brief Items the pool's chunks currently hold.
+ */
+size_t ttak_object_pool_capacity(const ttak_object_pool_t *pool);
+
+#if defined(TTAK_INLINE_FASTPATHS)
+/** Magazine of the calling thread; UINT32_MAX until its first pool call. */
+extern _Thread_local uint32_t ttak_object_pool_thread_mag;
+
+/**
+ * @brief Inline ttak_object_pool_alloc(): a pop from a bound, non-empty
+ *        magazine completes here; refills and contention call the library.
+ */
+TTAK_FORCE_INLINE void *ttak_object_pool_alloc_inline(ttak_object_pool_t *pool) {
+    uint32_t slot = ttak_object_pool_thread_mag;
+    if (TTAK_LIKELY(pool && slot != UINT32_MAX)) {
+        ttak_object_pool_mag_t *mag = &pool->mags[slot];
+        if (TTAK_LIKELY(!atomic_exchange_explicit(&mag->busy, 1, memory_order_acquire))) {
+            if (TTAK_LIKELY(mag->count != 0)) {
+                uint32_t idx = mag->items[--mag->count];
+                atomic_store_explicit(&mag->busy, 0, memory_order_release);
+                atomic_store_explicit(ttak_object_pool_live(pool, idx), 1, memory_order_relaxed);
+                return ttak_object_pool_item(pool, idx);
+            }
+            atomic_store_explicit(&mag->busy, 0, memory_order_release);
+        }
+    }
+    return (ttak_object_pool_alloc)(pool);
+}
+
+#define ttak_object_pool_alloc(pool) ttak_object_pool_alloc_inline((pool))
+#endif
+
 #endif // TTAK_CONTAINER_POOL_H
@@ -4,25 +4,57 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <ttak/sync/sync.h>
 
+/**
+ * @brief Concurrency discipline of a ring buffer, fixed at creation.
+ */
+typedef enum ttak_ringbuf_mode {
+    TTAK_RINGBUF_LOCKED = 0, /**< Any threads; every operation takes the lock. */
+    TTAK_RINGBUF_SPSC   = 1, /**< One producer and one consumer thread, lock-free. */
+    TTAK_RINGBUF_MPMC   = 2  /**< Any threads, lock-free (Vyukov bounded queue). */
+} ttak_ringbuf_mode_t;
+
 /**
  * @brief Thread-safe Ring Buffer structure.
- * 
- * Uses a read-write lock to allow multiple readers or exclusive writers.
- * (Note: Standard ring buffers are often single-producer/single-consumer lock-free,
- * this one is generic and locked).
+ *
+ * The locked mode serialises every operation on a read-write lock held for
+ * writing. The SPSC mode keeps the producer's position and its cached copy
+ * of the consumer's on one cache line and the mirror pair on another, so
+ * each side touches the other's line only when its cached view runs out.
+ * The MPMC mode tags every slot with a sequence number and claims
+ * positions with one CAS. The lock-free modes round the capacity up to a
+ * power of two.
  */
 typedef struct ttak_ringbuf {
     void *buffer;       /**< Internal data buffer. */
     size_t item_size;   /**< Size of each item. */
     size_t capacity;    /**< Maximum number of items. */
-    size_t head;        /**< Write index (where next item goes). */
-    size_t tail;        /**< Read index (where next item is taken). */
-    bool full;          /**< Flag indicating buffer is full (distinguishes empty vs full). */
-    ttak_rwlock_t lock; /**< Lock for thread safety. */
+    size_t head;        /**< Locked mode: write index (where next item goes). */
+    size_t tail;        /**< Locked mode: read index (where next item is taken). */
+    bool full;          /**< Locked mode: distinguishes empty vs full. */
+    ttak_rwlock_t lock; /**< Locked mode: lock for thread safety. */
+    ttak_ringbuf_mode_t mode;
+    size_t mask;        /**< Lock-free modes: capacity - 1. */
+    size_t stride;      /**< Bytes per slot; MPMC slots carry a sequence number first. */
+
+    /* Producer side: next position to write, and its view of the consumer. */
+    _Alignas(64) _Atomic size_t prod_pos;
+    size_t prod_cached;
+    /* Consumer side: next position to read, and its view of the producer. */
+    _Alignas(64) _Atomic size_t cons_pos;
+    size_t cons_cached;
 } ttak_ringbuf_t;
 
+/**
+ * @brief A slot handed out by reserve/claim, returned by commit/release.
+ */
+typedef struct ttak_ringbuf_slot {
+    void *ptr;          /**< Item storage; @c item_size bytes. */
+    size_t pos;         /**< Ring position; private. */
+} ttak_ringbuf_slot_t;
+
 typedef ttak_ringbuf_t tt_ringbuf_t;
 
 /**
@@ -34,6 +66,13 @@ typedef ttak_ringbuf_t tt_ringbuf_t;
  */
 ttak_ringbuf_t *ttak_ringbuf_create(size_t capacity, size_t item_size);
 
+/**
+ * @brief Creates a ring buffer with the given concurrency @p mode.
+ *
+ * @return NULL on a zero or overflowing size, or allocation failure.
+ */
+ttak_ringbuf_t *ttak_ringbuf_create_ex(size_t capacity, size_t item_size, ttak_ringbuf_mode_t mode);
+
 /**
  * @brief Destroys ring buffer.
  */
@@ -57,8 +96,57 @@ bool ttak_ringbuf_push(ttak_ringbuf_t *rb, const void *item);
  */
 bool ttak_ringbuf_pop(ttak_ringbuf_t *rb, void *out_item);
 
+/**
+ * @brief Pushes up to @p count items from the array @p items.
+ *
+ * The lock-free modes claim the whole run of slots at once.
+ *
+ * @return Items pushed, in order; fewer than @p count when it fills up.
+ */
+size_t ttak_ringbuf_push_n(ttak_ringbuf_t *rb, const void *items, size_t count);
+
+/**
+ * @brief Pops up to @p count items into the array @p out_items (may be NULL).
+ *
+ * @return Items popped, oldest first.
+ */
+size_t ttak_ringbuf_pop_n(ttak_ringbuf_t *rb, void *out_items, size_t count);
+
+/**
+ * @brief Reserves the next free slot for in-place writing.
+ *
+ * Fill @c slot->ptr and publish it with ttak_ringbuf_commit(). The locked
+ * mode holds the lock from reserve to commit; SPSC allows one outstanding
+ * reservation at a time.
+ *
+ * @return False if the buffer is full.
+ */
+bool ttak_ringbuf_reserve(ttak_ringbuf_t *rb, ttak_ringbuf_slot_t *slot);
+
+/**
+ * @brief Publishes a slot filled after ttak_ringbuf_reserve().
+ */
+void ttak_ringbuf_commit(ttak_ringbuf_t *rb, ttak_ringbuf_slot_t *slot);
+
+/**
+ * @brief Claims the oldest item for in-place reading.
+ *
+ * Read @c slot->ptr and hand the slot back with ttak_ringbuf_release().
+ * Same holding rules as ttak_ringbuf_reserve().
+ *
+ * @return False if the buffer is empty.
+ */
+bool ttak_ringbuf_claim(ttak_ringbuf_t *rb, ttak_ringbuf_slot_t *slot);
+
+/**
+ * @brief Frees a slot obtained from ttak_ringbuf_claim() for reuse.
+ */
+void ttak_ringbuf_release(ttak_ringbuf_t *rb, ttak_ringbuf_slot_t *slot);
+
 /**
  * @brief Checks if empty.
+ *
+ * Exact in the locked mode; a snapshot under concurrent use otherwise.
  */
 bool ttak_ringbuf_is_empty(ttak_ringbuf_t *rb);
 
@@ -72,4 +160,44 @@ bool ttak_ringbuf_is_full(ttak_ringbuf_t *rb);
  */
 size_t ttak_ringbuf_count(ttak_ringbuf_t *rb);
 
+#if defined(TTAK_INLINE_FASTPATHS)
+#include <string.h>
+#include <ttak/types/ttak_compiler.h>
+
+/**
+ * @brief Inline ttak_ringbuf_push(): an SPSC push the producer's cached
+ *        view has room for completes here; anything else calls the library.
+ */
+TTAK_FORCE_INLINE bool ttak_ringbuf_push_inline(ttak_ringbuf_t *rb, const void *item) {
+    if (TTAK_LIKELY(rb->mode == TTAK_RINGBUF_SPSC && item)) {
+        size_t pos = atomic_load_explicit(&rb->prod_pos, memory_order_relaxed);
+        if (TTAK_LIKELY(pos - rb->prod_cached < rb->capacity)) {
+            memcpy((char *)rb->buffer + (pos & rb->mask) * rb->item_size, item, rb->item_size);
+            atomic_store_explicit(&rb->prod_pos, pos + 1, memory_order_release);
+            return true;
+        }
+    }
+    return (ttak_ringbuf_push)(rb, item);
+}
+
+/**
+ * @brief Inline ttak_ringbuf_pop(): an SPSC pop the consumer's cached view
+ *        covers completes here; anything else calls the library.
+ */
+TTAK_FORCE_INLINE bool ttak_ringbuf_pop_inline(ttak_ringbuf_t *rb, void *out_item) {
+    if (TTAK_LIKELY(rb->mode == TTAK_RINGBUF_SPSC)) {
+        size_t pos = atomic_load_explicit(&rb->cons_pos, memory_order_relaxed);
+        if (TTAK_LIKELY(rb->cons_cached != pos)) {
+            if (out_item) memcpy(out_item, (char *)rb->buffer + (pos & rb->mask) * rb->item_size, rb->item_size);
+            atomic_store_explicit(&rb->cons_pos, pos + 1, memory_order_release);
+            return true;
+        }
+    }
+    return (ttak_ringbuf_pop)(rb, out_item);
+}
+
+#define ttak_ringbuf_push(rb, item) ttak_ringbuf_push_inline((rb), (item))
+#define ttak_ringbuf_pop(rb, out_item) ttak_ringbuf_pop_inline((rb), (out_item))
+#endif
+
 #endif // TTAK_CONTAINER_RINGBUF_H
\ No newline at end of file
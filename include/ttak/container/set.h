@@ -2,16 +2,29 @@
 #define TTAK_CONTAINER_SET_H
 
 #include <ttak/ht/table.h>
+#include <ttak/container/bloom.h>
 #include <stdbool.h>
 
+/**
+ * @brief Generic set over ttak_table_t.
+ *
+ * With ttak_set_enable_filter() a blocked Bloom filter sits in front of
+ * the table, so most lookups of absent keys end after one cache line and
+ * never call key_cmp. Removals leave stale bits behind; once they make up
+ * half the filter's keys it is rebuilt from the live contents, as it is
+ * when the set outgrows it.
+ */
 typedef struct ttak_set {
     ttak_table_t table;
+    ttak_bloom_t *filter;       /**< Front filter, or NULL */
+    size_t filter_stale;        /**< Removals since the filter was built */
 } ttak_set_t;
 
 /**
  * @brief Initialize a generic set.
  * @param capacity Initial capacity.
- * @param hash_func Custom hash function (or NULL for default).
+ * @param hash_func Custom hash function (or NULL for default); ttak_siphash13
+ *                  for keys from untrusted input.
  * @param key_cmp Key comparison function.
  * @param key_free Key cleanup function.
  */
@@ -20,6 +33,13 @@ void ttak_set_init(ttak_set_t *set, size_t capacity,
                    int (*key_cmp)(const void*, const void*),
                    void (*key_free)(void*));
 
+/**
+ * @brief Put a membership filter in front of the set, sized for @p expected keys.
+ *
+ * @return False if the filter could not be allocated; the set still works.
+ */
+bool ttak_set_enable_filter(ttak_set_t *set, size_t expected);
+
 /**
  * @brief Add an element to the set.
  */
@@ -0,0 +1,150 @@
+/**
+ * @file skiplist.h
+ * @brief Lock-free ordered map of u64 keys, kept as a skip list.
+ *
+ * Each node holds its key, its value and its tower of next pointers in one
+ * allocation, so stepping to a node and past it touches the same lines.
+ * Towers grow with probability 1/4 per level, which keeps them short.
+ * Removal follows Harris: it first marks the low bit of every next
+ * pointer in the tower, top level first. Searches that pass a marked node
+ * then unlink it. Readers never write and never wait. A remover waits only
+ * for an insert of that very node to finish linking its tower, so that
+ * once the remover has unlinked the node nothing can relink it, and the
+ * node can be handed to ttak_epoch_retire().
+ *
+ * Every call pins the epoch except the *_pinned variants, which are meant
+ * for callers that already hold a pin. Fingers carry a search position
+ * from one lookup to the next while the caller holds a pin, so lookups in
+ * ascending key order skip the upper levels.
+ */
+
+#ifndef TTAK_CONTAINER_SKIPLIST_H
+#define TTAK_CONTAINER_SKIPLIST_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Tallest tower; with 1/4 growth this covers about 4^16 keys. */
+#define TTAK_SKIPLIST_MAX_LEVEL 16
+
+typedef struct ttak_skiplist_node {
+    uint64_t key;
+    _Atomic uintptr_t value;
+    uint8_t height;                 /**< Levels in @c next; fixed at creation. */
+    _Atomic uint8_t linked;         /**< Set once every level is linked. */
+    _Atomic uintptr_t next[];       /**< Successor per level; bit 0 marks this node deleted there. */
+} ttak_skiplist_node_t;
+
+/**
+ * @brief Skip list. Initialise with ttak_skiplist_init().
+ */
+typedef struct ttak_skiplist {
+    ttak_skiplist_node_t *head;     /**< Sentinel below every key, of full height. */
+    _Atomic size_t size;
+} ttak_skiplist_t;
+
+typedef ttak_skiplist_t tt_skiplist_t;
+
+/**
+ * @brief Cached search path for ttak_skiplist_get_finger().
+ *
+ * Valid only while the epoch pin it was used under is held.
+ */
+typedef struct ttak_skiplist_finger {
+    ttak_skiplist_node_t *preds[TTAK_SKIPLIST_MAX_LEVEL];
+} ttak_skiplist_finger_t;
+
+/**
+ * @brief Callback for ttak_skiplist_range(); returning false stops the scan.
+ *
+ * Runs under the scan's epoch pin, so it must use *_pinned lookups.
+ */
+typedef bool (*ttak_skiplist_visit_t)(uint64_t key, uintptr_t value, void *ctx);
+
+/**
+ * @brief Initialises an empty list.
+ *
+ * @return False if the head could not be allocated.
+ */
+bool ttak_skiplist_init(ttak_skiplist_t *list);
+
+/**
+ * @brief Frees every node. No other thread may be using the list.
+ */
+void ttak_skiplist_destroy(ttak_skiplist_t *list);
+
+/**
+ * @brief Inserts @p key or replaces its value.
+ *
+ * @return False on allocation failure.
+ */
+bool ttak_skiplist_put(ttak_skiplist_t *list, uint64_t key, uintptr_t value);
+
+/**
+ * @brief Removes @p key.
+ *
+ * @return True if this call removed it.
+ */
+bool ttak_skiplist_remove(ttak_skiplist_t *list, uint64_t key);
+
+/**
+ * @brief Looks up @p key without writing to the list, pinning the epoch.
+ *
+ * @param out Receives the value if found; may be NULL.
+ * @return True if found.
+ */
+bool ttak_skiplist_get(ttak_skiplist_t *list, uint64_t key, uintptr_t *out);
+
+/**
+ * @brief ttak_skiplist_get() for callers already between ttak_epoch_enter()
+ *        and ttak_epoch_exit().
+ */
+bool ttak_skiplist_get_pinned(ttak_skiplist_t *list, uint64_t key, uintptr_t *out);
+
+/**
+ * @brief Points @p finger at the head of @p list.
+ */
+void ttak_skiplist_finger_init(ttak_skiplist_t *list, ttak_skiplist_finger_t *finger);
+
+/**
+ * @brief ttak_skiplist_get_pinned() that starts from, and updates, @p finger.
+ *
+ * The search climbs only as high as it must to reach @p key from the last
+ * position, so a run of ascending keys costs about one step each.
+ */
+bool ttak_skiplist_get_finger(ttak_skiplist_t *list, ttak_skiplist_finger_t *finger, uint64_t key,
+                              uintptr_t *out);
+
+/**
+ * @brief Visits present pairs with @p lo <= key <= @p hi in key order.
+ *
+ * The scan is not a snapshot; pairs changed during it may or may not be seen.
+ * @return Number of pairs visited.
+ */
+size_t ttak_skiplist_range(ttak_skiplist_t *list, uint64_t lo, uint64_t hi, ttak_skiplist_visit_t visit,
+                           void *ctx);
+
+/**
+ * @brief Removes every pair with @p lo <= key <= @p hi, e.g. TTL entries now expired.
+ *
+ * @return Number of pairs this call removed.
+ */
+size_t ttak_skiplist_remove_range(ttak_skiplist_t *list, uint64_t lo, uint64_t hi);
+
+/**
+ * @brief Removes the pair with the smallest key.
+ *
+ * @param key Receives its key; may be NULL.
+ * @param value Receives its value; may be NULL.
+ * @return False if the list was empty.
+ */
+bool ttak_skiplist_pop_min(ttak_skiplist_t *list, uint64_t *key, uintptr_t *value);
+
+/**
+ * @brief Number of pairs; exact only while no writer runs.
+ */
+size_t ttak_skiplist_size(ttak_skiplist_t *list);
+
+#endif // TTAK_CONTAINER_SKIPLIST_H
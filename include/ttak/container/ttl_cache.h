@@ -0,0 +1,185 @@
+/**
+ * @file ttl_cache.h
+ * @brief Sharded key/value cache with TTL expiry and a byte budget.
+ *
+ * Keys are 64-bit integers and values are byte strings copied into the
+ * cache. The index is a @c ttak_cmap_t, so lookups take no lock: a reader
+ * pins the epoch, finds the entry and copies its value out (or uses it in
+ * place with ttak_ttl_cache_get_pinned()). Replaced, expired and evicted
+ * entries are retired through ttak_epoch_retire(), never freed under a
+ * reader.
+ *
+ * Writes go to one of TTAK_TTL_CACHE_SHARDS shards, each with its own lock
+ * and an equal share of the byte budget. A shard evicts CLOCK-style: a hit
+ * sets the entry's reference bit, and the hand gives every referenced
+ * entry a second chance before evicting the first unreferenced one.
+ *
+ * Entries with a TTL are armed on the cache's own timing wheel, whose
+ * thread removes them when they fall due; a lookup in the window before
+ * that (at most one tick) already treats them as missing.
+ *
+ * ttak_ttl_cache_get_or_compute() coalesces misses: while one caller
+ * computes a key's value, others asking for the same key wait for its
+ * result instead of computing it again.
+ */
+
+#ifndef TTAK_CONTAINER_TTL_CACHE_H
+#define TTAK_CONTAINER_TTL_CACHE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/ht/cmap.h>
+#include <ttak/sync/sync.h>
+#include <ttak/timing/wheel.h>
+
+/** Shards per cache; a power of two. */
+#define TTAK_TTL_CACHE_SHARDS 16
+
+/** Default byte budget. */
+#define TTAK_TTL_CACHE_DEFAULT_BYTES (64U * 1024U * 1024U)
+
+/** Default largest value ttak_ttl_cache_get_or_compute() lets a compute produce. */
+#define TTAK_TTL_CACHE_DEFAULT_MAX_VALUE 4096U
+
+/**
+ * @brief Outcome of a cache call.
+ */
+typedef enum ttak_ttl_cache_status {
+    TTAK_TTL_CACHE_OK = 0,      /**< Found, stored or computed. */
+    TTAK_TTL_CACHE_MISS,        /**< Absent or expired. */
+    TTAK_TTL_CACHE_TOO_SMALL,   /**< Found, but longer than the buffer; the length is reported. */
+    TTAK_TTL_CACHE_TOO_LARGE,   /**< The value exceeds a shard's budget or the compute limit. */
+    TTAK_TTL_CACHE_NOMEM,       /**< Allocation failed. */
+    TTAK_TTL_CACHE_FAILED       /**< The compute function declined; nothing was cached. */
+} ttak_ttl_cache_status_t;
+
+/**
+ * @brief Cache settings; zero fields take the defaults shown.
+ */
+typedef struct ttak_ttl_cache_config {
+    size_t max_bytes;       /**< Budget for entries, headers included (TTAK_TTL_CACHE_DEFAULT_BYTES). */
+    size_t max_value;       /**< Compute buffer size (TTAK_TTL_CACHE_DEFAULT_MAX_VALUE). */
+    size_t init_cap;        /**< Entries the index is sized for up front (1024). */
+    uint64_t tick_ns;       /**< Expiry resolution (TTAK_TIMER_WHEEL_TICK_NS). */
+} ttak_ttl_cache_config_t;
+
+/**
+ * @brief Computes the value of @p key into @p out, which holds @p cap bytes.
+ *
+ * @return False if there is no value; the caller and its waiters then get
+ *         TTAK_TTL_CACHE_FAILED.
+ */
+typedef bool (*ttak_ttl_cache_compute_fn)(uint64_t key, void *out, size_t cap, size_t *len, void *arg);
+
+typedef struct ttak_ttl_cache_entry ttak_ttl_cache_entry_t;
+typedef struct ttak_ttl_cache_flight ttak_ttl_cache_flight_t;
+
+/**
+ * @brief One shard: its CLOCK ring, byte count and computations in flight,
+ *        all guarded by @c lock.
+ */
+typedef struct ttak_ttl_cache_shard {
+    _Alignas(64) ttak_mutex_t lock;
+    ttak_ttl_cache_entry_t *hand;       /**< Next eviction candidate; the ring is circular. */
+    size_t bytes;
+    size_t entries;
+    size_t budget;
+    ttak_ttl_cache_flight_t *flights;
+    uint64_t evictions;
+    uint64_t expirations;
+    uint64_t computes;
+    uint64_t coalesced;
+    _Alignas(64) _Atomic uint64_t hits; /**< Reader counters, off the writers' line. */
+    _Atomic uint64_t misses;
+} ttak_ttl_cache_shard_t;
+
+/**
+ * @brief TTL cache. Create with ttak_ttl_cache_create().
+ */
+typedef struct ttak_ttl_cache {
+    ttak_cmap_t *index;                 /**< Key to entry pointer. */
+    uint64_t seed;
+    size_t max_value;
+    ttak_timer_wheel_t wheel;
+    ttak_ttl_cache_shard_t shards[TTAK_TTL_CACHE_SHARDS];
+} ttak_ttl_cache_t;
+
+typedef ttak_ttl_cache_t tt_ttl_cache_t;
+
+typedef struct ttak_ttl_cache_stats {
+    uint64_t entries;
+    uint64_t bytes;         /**< Bytes charged to the budget. */
+    uint64_t hits;
+    uint64_t misses;        /**< Expired entries included. */
+    uint64_t evictions;     /**< Entries removed to stay within budget. */
+    uint64_t expirations;   /**< Entries removed by their timer. */
+    uint64_t computes;      /**< Compute calls made by get-or-compute. */
+    uint64_t coalesced;     /**< Get-or-compute calls that waited for another's compute. */
+} ttak_ttl_cache_stats_t;
+
+/**
+ * @brief Creates a cache and starts its expiry thread.
+ *
+ * @param cfg May be NULL for all defaults.
+ * @return NULL on allocation failure or if the thread could not start.
+ */
+ttak_ttl_cache_t *ttak_ttl_cache_create(const ttak_ttl_cache_config_t *cfg);
+
+/**
+ * @brief Stops the expiry thread and frees the cache. No other thread may be using it.
+ */
+void ttak_ttl_cache_destroy(ttak_ttl_cache_t *cache);
+
+/**
+ * @brief Stores a copy of @p len bytes at @p data under @p key, replacing any value.
+ *
+ * Evicts as needed to keep the key's shard within its budget.
+ *
+ * @param ttl_ns Lifetime; 0 never expires.
+ * @param now_ns As from ttak_get_tick_count_ns().
+ */
+ttak_ttl_cache_status_t ttak_ttl_cache_put(ttak_ttl_cache_t *cache, uint64_t key, const void *data, size_t len,
+                                           uint64_t ttl_ns, uint64_t now_ns);
+
+/**
+ * @brief Copies the value of @p key into @p dst.
+ *
+ * @param len Receives the value's length, also on TTAK_TTL_CACHE_TOO_SMALL.
+ */
+ttak_ttl_cache_status_t ttak_ttl_cache_get(ttak_ttl_cache_t *cache, uint64_t key, void *dst, size_t cap,
+                                           size_t *len, uint64_t now_ns);
+
+/**
+ * @brief Returns the value of @p key in place, or NULL.
+ *
+ * For callers between ttak_epoch_enter() and ttak_epoch_exit(); the bytes
+ * stay valid until the exit even if the entry is replaced meanwhile.
+ */
+const void *ttak_ttl_cache_get_pinned(ttak_ttl_cache_t *cache, uint64_t key, size_t *len, uint64_t now_ns);
+
+/**
+ * @brief Removes @p key.
+ *
+ * @return True if it was present.
+ */
+bool ttak_ttl_cache_remove(ttak_ttl_cache_t *cache, uint64_t key);
+
+/**
+ * @brief ttak_ttl_cache_get(), computing and storing the value on a miss.
+ *
+ * Concurrent misses on one key run @p fn once; the others wait for it and
+ * copy its result. @p fn runs without any cache lock held.
+ *
+ * @param ttl_ns Lifetime of a computed value; 0 never expires.
+ */
+ttak_ttl_cache_status_t ttak_ttl_cache_get_or_compute(ttak_ttl_cache_t *cache, uint64_t key,
+                                                      ttak_ttl_cache_compute_fn fn, void *arg,
+                                                      uint64_t ttl_ns, void *dst, size_t cap,
+                                                      size_t *len, uint64_t now_ns);
+
+void ttak_ttl_cache_stats(ttak_ttl_cache_t *cache, ttak_ttl_cache_stats_t *out);
+
+#endif // TTAK_CONTAINER_TTL_CACHE_H
@@ -0,0 +1,95 @@
+/**
+ * @file typed_ringbuf.h
+ * @brief Type-specialized single-producer/single-consumer ring buffer.
+ *
+ * TTAK_RINGBUF_DEFINE(name, T) expands to a ring type @c name_t over a
+ * typed array and static inline @c name_push / @c name_pop, so an item is
+ * moved by assignment, with no memcpy of a runtime @c item_size. The
+ * protocol is the SPSC mode of @c ttak_ringbuf_t: each side keeps its
+ * position and a cached copy of the other side's on its own cache line,
+ * and reads the other side's line only when the cached view runs out.
+ *
+ * Exactly one thread may push and one thread may pop at a time.
+ */
+
+#ifndef TTAK_CONTAINER_TYPED_RINGBUF_H
+#define TTAK_CONTAINER_TYPED_RINGBUF_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/mem/mem.h>
+
+#define TTAK_RINGBUF_DEFINE(name, T)                                                                   \
+    typedef struct name {                                                                              \
+        T *items;                                                                                      \
+        size_t mask;      /* Capacity - 1; capacity is a power of two. */                              \
+        _Alignas(64) _Atomic size_t prod_pos;                                                          \
+        size_t prod_cached;                                                                            \
+        _Alignas(64) _Atomic size_t cons_pos;                                                          \
+        size_t cons_cached;                                                                            \
+    } name##_t;                                                                                        \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Initializes an empty ring of at least @p capacity items, rounded up to a power of two.   \
+     * @return False on a zero capacity or allocation failure.                                         \
+     */                                                                                                \
+    static inline bool name##_init(name##_t *rb, size_t capacity) {                                    \
+        if (capacity == 0 || capacity > SIZE_MAX / 2 / sizeof(T)) return false;                        \
+        size_t cap = 1;                                                                                \
+        while (cap < capacity) cap <<= 1;                                                              \
+        rb->items = (T *)ttak_dangerous_calloc(cap, sizeof(T));                                        \
+        if (!rb->items) return false;                                                                  \
+        rb->mask = cap - 1;                                                                            \
+        atomic_init(&rb->prod_pos, 0);                                                                 \
+        rb->prod_cached = 0;                                                                           \
+        atomic_init(&rb->cons_pos, 0);                                                                 \
+        rb->cons_cached = 0;                                                                           \
+        return true;                                                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    static inline void name##_destroy(name##_t *rb) {                                                  \
+        ttak_dangerous_free(rb->items);                                                                \
+        rb->items = NULL;                                                                              \
+    }                                                                                                  \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Appends @p item. Producer only.                                                          \
+     * @return False if the ring is full.                                                              \
+     */                                                                                                \
+    static inline bool name##_push(name##_t *rb, T item) {                                             \
+        size_t pos = atomic_load_explicit(&rb->prod_pos, memory_order_relaxed);                        \
+        if (pos - rb->prod_cached > rb->mask) {                                                        \
+            rb->prod_cached = atomic_load_explicit(&rb->cons_pos, memory_order_acquire);               \
+            if (pos - rb->prod_cached > rb->mask) return false;                                        \
+        }                                                                                              \
+        rb->items[pos & rb->mask] = item;                                                              \
+        atomic_store_explicit(&rb->prod_pos, pos + 1, memory_order_release);                           \
+        return true;                                                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Takes the oldest item into @p out. Consumer only.                                        \
+     * @return False if the ring is empty.                                                             \
+     */                                                                                                \
+    static inline bool name##_pop(name##_t *rb, T *out) {                                              \
+        size_t pos = atomic_load_explicit(&rb->cons_pos, memory_order_relaxed);                        \
+        if (pos == rb->cons_cached) {                                                                  \
+            rb->cons_cached = atomic_load_explicit(&rb->prod_pos, memory_order_acquire);               \
+            if (pos == rb->cons_cached) return false;                                                  \
+        }                                                                                              \
+        *out = rb->items[pos & rb->mask];                                                              \
+        atomic_store_explicit(&rb->cons_pos, pos + 1, memory_order_release);                           \
+        return true;                                                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    /** @brief Items queued; a snapshot when the other side is running. */                            \
+    static inline size_t name##_count(name##_t *rb) {                                                  \
+        return atomic_load_explicit(&rb->prod_pos, memory_order_acquire) -                             \
+               atomic_load_explicit(&rb->cons_pos, memory_order_acquire);                              \
+    }                                                                                                  \
+                                                                                                       \
+    static inline size_t name##_capacity(const name##_t *rb) { return rb->mask + 1; }
+
+#endif // TTAK_CONTAINER_TYPED_RINGBUF_H
@@ -0,0 +1,107 @@
+/**
+ * @file cmap.h
+ * @brief Concurrent integer-keyed hash map with lock-free reads.
+ *
+ * Keys hash to one of TTAK_CMAP_SHARDS shards, each a Swiss table laid
+ * out like @c ttak_map_t (H2 control bytes, group probes from group.h).
+ * Writers take the shard's mutex; readers take no lock at all. A reader
+ * pins the epoch, probes the shard's current table, and retries if the
+ * shard's sequence count moved while it looked, so reads scale with cores
+ * and only contend with writes to the same shard.
+ *
+ * A shard grows by building a new table off to the side while readers
+ * keep using the old one, then publishing it with one pointer store; the
+ * old table is retired through ttak_epoch_retire(). Only writers to that
+ * one shard wait for it, so resizing never stops the world.
+ */
+
+#ifndef TTAK_HT_CMAP_H
+#define TTAK_HT_CMAP_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/sync/sync.h>
+
+/** Shards per map; a power of two. */
+#define TTAK_CMAP_SHARDS 64
+
+/**
+ * @brief One shard's slot arrays, replaced wholesale on resize.
+ */
+typedef struct ttak_cmap_table {
+    size_t              cap;        /**< Power of two; cap + TTAK_HT_PAD slots exist. */
+    uint8_t             *ctrls;     /**< EMPTY, DELETED, or OCCUPIED | H2. */
+    _Atomic uintptr_t   *keys;
+    _Atomic size_t      *values;
+} ttak_cmap_table_t;
+
+/**
+ * @brief A shard: its table, writer lock, and the sequence count readers
+ *        validate against (odd while a write is in progress).
+ */
+typedef struct ttak_cmap_shard {
+    _Alignas(64) _Atomic uint64_t       seq;
+    ttak_cmap_table_t * _Atomic         table;
+    ttak_mutex_t                        lock;
+    _Atomic size_t                      size;       /**< Live pairs; written under @c lock. */
+    size_t                              deleted;    /**< Tombstones; guarded by @c lock. */
+} ttak_cmap_shard_t;
+
+/**
+ * @brief Concurrent map. Create with ttak_cmap_create().
+ */
+typedef struct ttak_cmap {
+    uint64_t            seed;
+    ttak_cmap_shard_t   shards[TTAK_CMAP_SHARDS];
+} ttak_cmap_t;
+
+typedef ttak_cmap_t tt_cmap_t;
+
+/**
+ * @brief Creates a map sized for about @p init_cap pairs.
+ *
+ * @return The map, or NULL on allocation failure.
+ */
+ttak_cmap_t *ttak_cmap_create(size_t init_cap);
+
+/**
+ * @brief Destroys the map. No other thread may be using it.
+ */
+void ttak_cmap_destroy(ttak_cmap_t *map);
+
+/**
+ * @brief Inserts @p key or replaces its value.
+ *
+ * @return False if the shard needed to grow and could not allocate.
+ */
+bool ttak_cmap_put(ttak_cmap_t *map, uintptr_t key, size_t val);
+
+/**
+ * @brief Removes @p key.
+ *
+ * @return True if it was present.
+ */
+bool ttak_cmap_remove(ttak_cmap_t *map, uintptr_t key);
+
+/**
+ * @brief Looks up @p key, pinning the epoch for the duration.
+ *
+ * @param out Receives the value if found; may be NULL.
+ * @return True if found.
+ */
+bool ttak_cmap_get(ttak_cmap_t *map, uintptr_t key, size_t *out);
+
+/**
+ * @brief ttak_cmap_get() for callers already between ttak_epoch_enter()
+ *        and ttak_epoch_exit(), e.g. to batch many lookups under one pin.
+ */
+bool ttak_cmap_get_pinned(ttak_cmap_t *map, uintptr_t key, size_t *out);
+
+/**
+ * @brief Number of pairs; exact only while no writer runs.
+ */
+size_t ttak_cmap_size(ttak_cmap_t *map);
+
+#endif // TTAK_HT_CMAP_H
@@ -0,0 +1,94 @@
+/**
+ * @file counter.h
+ * @brief Lock-free integer-keyed counter map for concurrent event counting.
+ *
+ * A fixed-capacity Swiss table laid out like @c ttak_map_t (H2 control
+ * bytes, group probes from group.h) whose values are atomic 64-bit counts
+ * instead of value pointers. Any thread may add to any key: an existing
+ * key costs one probe and one fetch-add on its slot, and a new key claims
+ * the first EMPTY slot on its probe path with a CAS on the control byte.
+ * Keys are never removed, so no tombstones or resizes are needed; size the
+ * map for the distinct keys expected, or give each thread its own map and
+ * combine them with ttak_counter_map_merge().
+ */
+
+#ifndef TTAK_HT_COUNTER_H
+#define TTAK_HT_COUNTER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Counter map. Create with ttak_counter_map_create().
+ */
+typedef struct ttak_counter_map {
+    size_t              cap;        /**< Power of two; cap + TTAK_HT_PAD slots exist. */
+    size_t              limit;      /**< Most keys accepted, 7/8 of the slots. */
+    uint64_t            seed;
+    uint8_t             *ctrls;     /**< EMPTY, DELETED while being claimed, or OCCUPIED | H2. */
+    _Atomic uintptr_t   *keys;
+    _Atomic uint64_t    *counts;
+    _Alignas(64) _Atomic size_t size;
+} ttak_counter_map_t;
+
+typedef ttak_counter_map_t tt_counter_map_t;
+
+/**
+ * @brief One key and its count, as returned by ttak_counter_map_top_k().
+ */
+typedef struct ttak_counter_entry {
+    uintptr_t key;
+    uint64_t  count;
+} ttak_counter_entry_t;
+
+/**
+ * @brief Creates a map with room for at least @p max_keys distinct keys.
+ *
+ * @return The map, or NULL on allocation failure.
+ */
+ttak_counter_map_t *ttak_counter_map_create(size_t max_keys);
+
+/**
+ * @brief Destroys the map. No other thread may be using it.
+ */
+void ttak_counter_map_destroy(ttak_counter_map_t *map);
+
+/**
+ * @brief Adds @p delta to @p key's count, inserting it at @p delta if new.
+ *
+ * @return False if @p key is new and the map is full.
+ */
+bool ttak_counter_map_add(ttak_counter_map_t *map, uintptr_t key, uint64_t delta);
+
+/**
+ * @brief Current count of @p key; 0 if it was never added.
+ */
+uint64_t ttak_counter_map_get(ttak_counter_map_t *map, uintptr_t key);
+
+/**
+ * @brief Number of distinct keys.
+ */
+size_t ttak_counter_map_size(ttak_counter_map_t *map);
+
+/**
+ * @brief Adds every count in @p src into @p dst.
+ *
+ * @p src must be quiescent; @p dst may be in concurrent use.
+ *
+ * @return False if @p dst filled up; the keys merged so far stay merged.
+ */
+bool ttak_counter_map_merge(ttak_counter_map_t *dst, ttak_counter_map_t *src);
+
+/**
+ * @brief Writes the @p k keys with the highest counts to @p out, highest first.
+ *
+ * Exact on a quiescent map; under concurrent adds each count is read once
+ * during the pass, so the result is a close approximation.
+ *
+ * @return Entries written, at most @p k.
+ */
+size_t ttak_counter_map_top_k(ttak_counter_map_t *map, size_t k, ttak_counter_entry_t *out);
+
+#endif // TTAK_HT_COUNTER_H
@@ -0,0 +1,143 @@
+/**
+ * @file group.h
+ * @brief Group-at-a-time control byte scans for the open-addressing tables.
+ *
+ * @c ttak_map_t and @c ttak_table_t probe a group of control bytes at once:
+ * one compare finds every slot whose 7-bit H2 fingerprint matches, so keys
+ * are only read for likely hits, and a group holding an EMPTY byte ends the
+ * probe. Groups are 32 bytes with AVX2, 16 with SSE2 or NEON, and 8 with
+ * the portable SWAR fallback. Groups start at any slot, which the
+ * TTAK_HT_PAD slots past the capacity make safe to load.
+ *
+ * Match results are bitmasks with TTAK_HT_MASK_STRIDE bits per slot; walk
+ * them with ttak_ht_mask_next().
+ */
+
+#ifndef TTAK_HT_GROUP_H
+#define TTAK_HT_GROUP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/ht/hash.h>
+
+#if defined(TTAK_HAS_AVX2)
+#  include <immintrin.h>
+#  define TTAK_HT_GROUP_WIDTH 32
+#  define TTAK_HT_MASK_SHIFT 0
+#elif defined(TTAK_HAS_SSE2)
+#  include <emmintrin.h>
+#  define TTAK_HT_GROUP_WIDTH 16
+#  define TTAK_HT_MASK_SHIFT 0
+#elif defined(TTAK_HAS_NEON)
+#  include <arm_neon.h>
+#  define TTAK_HT_GROUP_WIDTH 16
+#  define TTAK_HT_MASK_SHIFT 2
+#else
+#  define TTAK_HT_GROUP_WIDTH 8
+#  define TTAK_HT_MASK_SHIFT 3
+#endif
+
+/** Keys a batch lookup hashes and prefetches before resolving any of them. */
+#define TTAK_HT_BATCH_WINDOW 32
+
+/** Bits per slot in a match mask. */
+#define TTAK_HT_MASK_STRIDE (1U << TTAK_HT_MASK_SHIFT)
+
+#if TTAK_HT_GROUP_WIDTH > TTAK_HT_PAD
+#  error "TTAK_HT_PAD must cover a whole probe group"
+#endif
+
+#if !defined(TTAK_HAS_AVX2) && !defined(TTAK_HAS_SSE2) && !defined(TTAK_HAS_NEON)
+#define TTAK_HT_LSB 0x0101010101010101ULL
+#define TTAK_HT_MSB 0x8080808080808080ULL
+
+static inline uint64_t ttak_ht_group_load(const uint8_t *ctrl) {
+    uint64_t w;
+    memcpy(&w, ctrl, sizeof(w));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return w;
+}
+
+/* High bit of each byte of @p w that is exactly zero. */
+static inline uint64_t ttak_ht_zero_bytes(uint64_t w) {
+    return ~(((w & ~TTAK_HT_MSB) + ~TTAK_HT_MSB) | w) & TTAK_HT_MSB;
+}
+#endif
+
+/**
+ * @brief Slots in the group at @p ctrl whose control byte equals @p tag.
+ */
+static inline uint64_t ttak_ht_group_match(const uint8_t *ctrl, uint8_t tag) {
+#if defined(TTAK_HAS_AVX2)
+    __m256i g = _mm256_loadu_si256((const __m256i *)ctrl);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(g, _mm256_set1_epi8((char)tag)));
+#elif defined(TTAK_HAS_SSE2)
+    __m128i g = _mm_loadu_si128((const __m128i *)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)tag)));
+#elif defined(TTAK_HAS_NEON)
+    uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(tag));
+    uint64_t m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+    return m & 0x8888888888888888ULL;
+#else
+    return ttak_ht_zero_bytes(ttak_ht_group_load(ctrl) ^ (TTAK_HT_LSB * tag));
+#endif
+}
+
+/**
+ * @brief Slots in the group at @p ctrl that are EMPTY.
+ */
+static inline uint64_t ttak_ht_group_match_empty(const uint8_t *ctrl) {
+    return ttak_ht_group_match(ctrl, EMPTY);
+}
+
+/**
+ * @brief Slots in the group at @p ctrl that are EMPTY or DELETED.
+ */
+static inline uint64_t ttak_ht_group_match_free(const uint8_t *ctrl) {
+#if defined(TTAK_HAS_AVX2)
+    return (uint32_t)~_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)ctrl));
+#elif defined(TTAK_HAS_SSE2)
+    return (uint16_t)~_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#elif defined(TTAK_HAS_NEON)
+    uint8x16_t free_ = vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl)), vdupq_n_s8(0));
+    uint64_t m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(free_), 4)), 0);
+    return ~m & 0x8888888888888888ULL;
+#else
+    return ~ttak_ht_group_load(ctrl) & TTAK_HT_MSB;
+#endif
+}
+
+/**
+ * @brief Pops the lowest slot offset from a non-zero match mask.
+ */
+static inline size_t ttak_ht_mask_next(uint64_t *mask) {
+    size_t off = (size_t)__builtin_ctzll(*mask) >> TTAK_HT_MASK_SHIFT;
+    *mask &= *mask - 1;
+    return off;
+}
+
+/**
+ * @brief Start of the group probed after the one at @p pos.
+ *
+ * Steps a group at a time, takes the last group that fits in @p slots
+ * before wrapping to 0, so every slot is reachable from any start.
+ */
+static inline size_t ttak_ht_probe_next(size_t pos, size_t slots) {
+    size_t last = slots - TTAK_HT_GROUP_WIDTH;
+    if (pos >= last) return 0;
+    pos += TTAK_HT_GROUP_WIDTH;
+    return pos > last ? last : pos;
+}
+
+/**
+ * @brief Groups a probe may visit before it has seen every slot.
+ */
+static inline size_t ttak_ht_probe_limit(size_t slots) {
+    return slots / TTAK_HT_GROUP_WIDTH + 2;
+}
+
+#endif // TTAK_HT_GROUP_H
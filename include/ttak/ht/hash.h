@@ -3,8 +3,10 @@
  * @brief Low-level open-addressing hash map (SoA layout) with SipHash/wyhash.
  *
  * @c ttak_map_t is the inner SoA table used by the higher-level map and
- * table APIs.  Control bytes follow the Swiss-table convention:
- * @c EMPTY (0x00), @c DELETED (0xDE), @c OCCUPIED (0x0C).
+ * table APIs.  Control bytes follow the Swiss-table convention: @c EMPTY
+ * (0x00) and @c DELETED (0x01) have the high bit clear, and a live slot
+ * holds @c OCCUPIED | H2, the top 7 bits of its hash, so group probes
+ * (see group.h) compare fingerprints before touching keys.
  */
 
 #ifndef __TTAK_HASH_H__
@@ -18,19 +20,28 @@
 /** @brief Slot is empty and was never used. */
 #define EMPTY    0x00
 /** @brief Slot was occupied but has been deleted (tombstone). */
-#define DELETED  0xDE
-/** @brief Slot holds a live key/value pair. */
-#define OCCUPIED 0x0C
+#define DELETED  0x01
+/** @brief Bit set in the control byte of every slot holding a live pair. */
+#define OCCUPIED 0x80
+
+/** @brief True if control byte @p c marks a live slot. */
+#define TTAK_CTRL_FULL(c) (((c) & OCCUPIED) != 0)
+/** @brief Control byte for a live slot whose key hashed to @p h. */
+#define TTAK_CTRL_H2(h) ((uint8_t)(OCCUPIED | (uint8_t)((uint64_t)(h) >> 57)))
+
+/** @brief Slots allocated past the capacity so a probe group never wraps mid-load. */
+#define TTAK_HT_PAD 32
 
 /**
  * @brief Map structure using Structure of Arrays (SoA) for cache efficiency.
  */
 typedef struct {
-    uint8_t   *ctrls;  /**< Control bytes (OCCUPIED, EMPTY, DELETED) */
+    uint8_t   *ctrls;  /**< Control bytes (EMPTY, DELETED, or OCCUPIED | H2) */
     uintptr_t *keys;   /**< Keys array */
     size_t    *values; /**< Values array */
-    size_t    cap;     /**< Capacity (must be power of two) */
+    size_t    cap;     /**< Capacity (must be power of two); cap + TTAK_HT_PAD slots exist */
     size_t    size;    /**< Number of occupied slots */
+    size_t    deleted; /**< Number of tombstones */
     uint64_t  seed;    /**< Seed for wyhash */
 #ifndef _MSC_VER
     alignas(ttak_max_align_t) char padding[0];
@@ -58,4 +69,39 @@ uint64_t gen_hash_sip24(uintptr_t key, uint64_t k0, uint64_t k1);
  */
 uint64_t gen_hash_wyhash(uintptr_t key, uint64_t seed);
 
+/** @brief Keys at least this long use the AES kernel when the host has one. */
+#define TTAK_HASH_AES_MIN_LEN 64
+
+/**
+ * @brief Hashes @p len bytes for table indexing, picking the kernel at runtime.
+ *
+ * Keys shorter than TTAK_HASH_AES_MIN_LEN get ttak_wyhash(). Longer keys
+ * use an AES-round kernel (AES-NI or ARMv8 AES) when ttak_arch_features()
+ * reports TTAK_ARCH_FEATURE_AES, and wyhash otherwise. Long-key results
+ * therefore differ between hosts and must not be persisted. The function
+ * is not a keyed PRF; hash untrusted keys with gen_hash_sip24() or
+ * ttak_siphash24().
+ */
+uint64_t ttak_hash_bytes(const void *key, size_t len, uint64_t seed);
+
+/**
+ * @brief ttak_hash_bytes() over @p n keys, interleaving independent keys.
+ *
+ * @param keys Key pointers.
+ * @param lens Key lengths.
+ * @param out  Receives one hash per key.
+ */
+void ttak_hash_bytes_batch(const void *const *keys, const size_t *lens, size_t n,
+                           uint64_t seed, uint64_t *out);
+
+/**
+ * @brief ttak_hash_u64() over @p n keys, interleaving independent keys.
+ */
+void ttak_hash_u64_batch(const uint64_t *keys, size_t n, uint64_t seed, uint64_t *out);
+
+/**
+ * @brief Name of the long-key kernel ttak_hash_bytes() selected.
+ */
+const char *ttak_hash_kernel_name(void);
+
 #endif // __TTAK_HASH_H__
@@ -12,6 +12,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <ttak/ht/hash.h>
+#include <ttak/ht/group.h>
 
 /** @brief Alias: create a new map with @p init_cap initial capacity. */
 #define ttak_create_map tt_create_map
@@ -19,6 +20,8 @@
 #define ttak_insert_to_map tt_ins_map
 /** @brief Alias: look up a key in the map. */
 #define ttak_map_get_key tt_map_get
+/** @brief Alias: look up many keys in the map. */
+#define ttak_map_get_batch tt_map_get_batch
 /** @brief Alias: delete a key from the map. */
 #define ttak_delete_from_map tt_del_map
 
@@ -61,6 +64,64 @@ void ttak_delete_from_map(tt_map_t *map, uintptr_t key, uint64_t now);
  */
 _Bool ttak_map_get_key(tt_map_t *map, uintptr_t key, size_t *out, uint64_t now);
 
+/**
+ * @brief Slot of @p map holding @p key, whose hash is @p h, or SIZE_MAX.
+ */
+static inline size_t ttak_map_find_slot(const tt_map_t *map, uintptr_t key, uint64_t h) {
+    size_t slots = map->cap + TTAK_HT_PAD;
+    uint8_t tag = TTAK_CTRL_H2(h);
+    size_t pos = h & (map->cap - 1);
+
+    for (size_t n = ttak_ht_probe_limit(slots); n > 0; n--) {
+        const uint8_t *group = map->ctrls + pos;
+        for (uint64_t m = ttak_ht_group_match(group, tag); m != 0;) {
+            size_t idx = pos + ttak_ht_mask_next(&m);
+            if (map->keys[idx] == key) return idx;
+        }
+        if (ttak_ht_group_match_empty(group)) break;
+        pos = ttak_ht_probe_next(pos, slots);
+    }
+    return SIZE_MAX;
+}
+
+#if defined(TTAK_INLINE_FASTPATHS)
+#include <ttak/ht/wyhash.h>
+#include <ttak/mem/mem.h>
+#include <ttak/types/ttak_compiler.h>
+
+/**
+ * @brief Inline ttak_map_get_key(): the whole lookup, with the hash and
+ *        the group probe compiled into the caller.
+ */
+TTAK_FORCE_INLINE _Bool ttak_map_get_key_inline(tt_map_t *map, uintptr_t key, size_t *out, uint64_t now) {
+    if (!ttak_mem_access(map, now)) return 0;
+    // Same hash as gen_hash_wyhash().
+    size_t idx = ttak_map_find_slot(map, key, ttak_hash_u64((uint64_t)key, map->seed));
+    if (idx == SIZE_MAX) return 0;
+    if (out) *out = map->values[idx];
+    return 1;
+}
+
+#define tt_map_get(map, key, out, now) ttak_map_get_key_inline((map), (key), (out), (now))
+#endif
+
+/**
+ * @brief Looks up @p n keys at once.
+ *
+ * Hashes a window of keys and prefetches every group they land in before
+ * probing any of them, so the cache misses of the whole window overlap
+ * instead of being paid one key at a time.
+ *
+ * @param keys  Keys to find.
+ * @param n     Number of keys.
+ * @param out   Receives each key's value, or 0 where it is missing.
+ * @param found Receives whether each key was present; may be NULL.
+ * @param now   Current monotonic timestamp in nanoseconds.
+ * @return      Number of keys found.
+ */
+size_t ttak_map_get_batch(tt_map_t *map, const uintptr_t *keys, size_t n, size_t *out,
+                          _Bool *found, uint64_t now);
+
 /** @brief Trigger growth when load exceeds 1/3 of capacity. */
 #define __TT_MAP_RESIZE__ 3
 /** @brief Trigger shrink when load drops below 1/2 of capacity. */
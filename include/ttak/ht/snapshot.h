@@ -0,0 +1,91 @@
+/**
+ * @file snapshot.h
+ * @brief On-disk snapshots of @c tt_map_t that open with mmap instead of a rebuild.
+ *
+ * A snapshot is a header followed by the map's three SoA arrays (control
+ * bytes, keys, values) exactly as they sit in memory, padding included.
+ * The header records the seed, capacity, and each array's offset from the
+ * start of the file, so opening one maps the file read-only and points a
+ * @c tt_map_t at it: startup costs page faults for the slots actually
+ * probed, not a rehash of every pair.
+ *
+ * The probe layout depends on the build (word size, byte order, probe
+ * group width); the header records these and ttak_map_snapshot_open()
+ * rejects a file written by an incompatible build. Values are stored as
+ * plain words, so a map whose values are pointers does not survive.
+ */
+
+#ifndef TTAK_HT_SNAPSHOT_H
+#define TTAK_HT_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/ht/hash.h>
+
+/** "TTAKMAP1" read as a little-endian word; byte order mismatches fail it. */
+#define TTAK_MAP_SNAPSHOT_MAGIC 0x3150414d4b415454ULL
+#define TTAK_MAP_SNAPSHOT_VERSION 1
+
+/** Alignment of each array within the file. */
+#define TTAK_MAP_SNAPSHOT_ALIGN 64
+
+/**
+ * @brief Fixed header at offset 0 of a snapshot file.
+ */
+typedef struct ttak_map_snapshot_header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t header_size;   /**< sizeof(ttak_map_snapshot_header_t) */
+    uint32_t word_size;     /**< sizeof(uintptr_t) of the writer */
+    uint32_t group_width;   /**< TTAK_HT_GROUP_WIDTH of the writer */
+    uint32_t pad;           /**< TTAK_HT_PAD of the writer */
+    uint32_t reserved;
+    uint64_t seed;
+    uint64_t cap;
+    uint64_t size;
+    uint64_t deleted;
+    uint64_t ctrls_off;     /**< Offsets from the start of the file */
+    uint64_t keys_off;
+    uint64_t values_off;
+    uint64_t file_size;
+    uint64_t check;         /**< wyhash of every field above */
+} ttak_map_snapshot_header_t;
+
+/**
+ * @brief A mapped snapshot.
+ *
+ * @c map is a read-only view: look keys up with ttak_map_get_key() or
+ * ttak_map_get_batch(), but never insert, delete, or destroy it.
+ */
+typedef struct ttak_map_snapshot {
+    tt_map_t    *map;
+    void        *base;
+    size_t      len;
+} ttak_map_snapshot_t;
+
+/**
+ * @brief Writes @p map to @p path atomically.
+ *
+ * The data goes to a temporary file beside @p path, is fsync'd, and is
+ * renamed over @p path, so readers see the old snapshot or the new one
+ * and never a torn file.
+ *
+ * @return 0 on success, -1 on failure (errno is set).
+ */
+int ttak_map_snapshot_write(const tt_map_t *map, const char *path);
+
+/**
+ * @brief Maps the snapshot at @p path read-only.
+ *
+ * @param now Current monotonic timestamp in nanoseconds.
+ * @return The snapshot, or NULL if the file is missing, malformed, or
+ *         from an incompatible build.
+ */
+ttak_map_snapshot_t *ttak_map_snapshot_open(const char *path, uint64_t now);
+
+/**
+ * @brief Unmaps a snapshot. Its @c map must no longer be in use.
+ */
+void ttak_map_snapshot_close(ttak_map_snapshot_t *snap);
+
+#endif // TTAK_HT_SNAPSHOT_H
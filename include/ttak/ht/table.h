@@ -5,6 +5,22 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+/** Old slots moved to the new arrays by each put or remove during a resize. */
+#define TTAK_TABLE_MIGRATE_STEP 64
+
+/** Longest key an inline-key table stores in the slot itself. */
+#define TTAK_TABLE_INLINE_KEY 16
+
+/**
+ * @brief Slot key of an inline-key table: the key bytes, zero padded, or
+ *        for keys longer than TTAK_TABLE_INLINE_KEY the caller's pointer.
+ */
+typedef union ttak_table_ikey {
+    uint64_t    words[TTAK_TABLE_INLINE_KEY / 8];
+    uint8_t     bytes[TTAK_TABLE_INLINE_KEY];
+    void        *ptr;
+} ttak_table_ikey_t;
+
 /**
  * @brief Generic Table Entry.
  */
@@ -16,16 +32,41 @@ typedef struct ttak_table_entry {
 
 /**
  * @brief Generic SipHash Table (Refactored to Open Addressing SoA).
+ *
+ * Growth is incremental: a resize allocates the new arrays and parks the
+ * current ones in the @c old_* fields, and every put or remove then moves
+ * TTAK_TABLE_MIGRATE_STEP old slots across, so no single call rehashes
+ * the whole table. Until the old arrays drain, a key lives in exactly one
+ * of the two and lookups check both. Lookups never migrate, so they stay
+ * safe to run concurrently under a reader lock.
+ *
+ * A table made with ttak_table_init_inline() keeps keys in @c ikeys
+ * instead of @c keys: a key of up to TTAK_TABLE_INLINE_KEY bytes is copied
+ * into its slot, so a probe compares two words beside the fingerprint
+ * without dereferencing anything and the caller need not keep the key
+ * alive. Longer keys still point at caller memory.
  */
 typedef struct ttak_table {
-    uint8_t  *ctrls;    /**< Control bytes */
-    void     **keys;    /**< Keys array */
+    uint8_t  *ctrls;    /**< Control bytes, as for ttak_map_t (see group.h) */
+    void     **keys;    /**< Keys array; NULL for inline-key tables */
+    ttak_table_ikey_t *ikeys; /**< Inline keys; NULL unless @c inline_keys */
     size_t   *key_lens; /**< Key lengths array */
     void     **values;  /**< Values array */
-    size_t   capacity;
+    size_t   capacity;  /**< Power of two; capacity + TTAK_HT_PAD slots exist */
     size_t   size;
+    size_t   deleted;   /**< Tombstones */
+
+    uint8_t  *old_ctrls;    /**< Arrays being migrated from, or NULL */
+    void     **old_keys;
+    ttak_table_ikey_t *old_ikeys;
+    size_t   *old_key_lens;
+    void     **old_values;
+    size_t   old_capacity;
+    size_t   old_size;      /**< Live pairs not yet migrated, included in @c size */
+    size_t   migrate_pos;   /**< Next old slot to migrate */
     uint64_t k0;
     uint64_t k1;
+    bool     inline_keys;   /**< Keys compared bytewise and stored in @c ikeys */
     
     // Function pointers for generic behavior
     uint64_t (*hash_func)(const void *key, size_t key_len, uint64_t k0, uint64_t k1);
@@ -36,7 +77,10 @@ typedef struct ttak_table {
 
 /**
  * @brief Initialize a generic table.
- * @param hash_func Custom hash function (or NULL for default SipHash on generic bytes).
+ * @param hash_func Custom hash function, or NULL for the default byte hash
+ *                  (ttak_hash_bytes()). Tables keyed by untrusted input
+ *                  should pass ttak_siphash13, which ttak_table_get_batch()
+ *                  also hashes four keys at a time.
  * @param key_cmp Key comparison function (returns 0 if equal).
  */
 void ttak_table_init(ttak_table_t *table, size_t capacity, 
@@ -45,8 +89,33 @@ void ttak_table_init(ttak_table_t *table, size_t capacity,
                      void (*key_free)(void*),
                      void (*val_free)(void*));
 
+/**
+ * @brief Initialize a table that stores short keys inline.
+ *
+ * Keys are compared as bytes, so no key_cmp is needed, and only keys
+ * longer than TTAK_TABLE_INLINE_KEY are stored by pointer and passed to
+ * @p key_free.
+ * @param hash_func Custom hash function (or NULL for the default).
+ */
+void ttak_table_init_inline(ttak_table_t *table, size_t capacity,
+                            uint64_t (*hash_func)(const void*, size_t, uint64_t, uint64_t),
+                            void (*key_free)(void*),
+                            void (*val_free)(void*));
+
 void ttak_table_put(ttak_table_t *table, void *key, size_t key_len, void *value, uint64_t now);
 void *ttak_table_get(ttak_table_t *table, const void *key, size_t key_len, uint64_t now);
+
+/**
+ * @brief Looks up @p n keys at once.
+ *
+ * Hashes a window of keys, prefetches the slots each one probes first in
+ * both generations, then resolves them, so the window's cache misses
+ * overlap. Like ttak_table_get() it never migrates.
+ * @param out Receives each key's value, or NULL where it is missing.
+ * @return Number of keys found.
+ */
+size_t ttak_table_get_batch(ttak_table_t *table, const void *const *keys, const size_t *key_lens,
+                            size_t n, void **out, uint64_t now);
 bool ttak_table_remove(ttak_table_t *table, const void *key, size_t key_len, uint64_t now);
 void ttak_table_destroy(ttak_table_t *table, uint64_t now);
 
@@ -0,0 +1,215 @@
+/**
+ * @file typed_map.h
+ * @brief Type-specialized open-addressing map generated per key/value type.
+ *
+ * TTAK_MAP_DEFINE(name, K, V, hash, eq) expands to a map type @c name_t
+ * and static inline functions @c name_init, @c name_put, @c name_get and
+ * so on. Keys and values live in typed arrays, and @p hash and @p eq are
+ * substituted as expressions, so each probe compiles to straight-line code
+ * with no indirect call and no copy through @c void*. Use it where
+ * @c ttak_map_t or @c ttak_table_t would need a callback per probe.
+ *
+ * The layout and probing follow @c ttak_map_t: control bytes hold EMPTY,
+ * DELETED or OCCUPIED | H2, and lookups scan a group of them at a time
+ * (group.h). @p hash must spread entropy into both its low bits, which pick
+ * the home slot, and its top seven, which form the fingerprint; the
+ * TTAK_TYPED_HASH_* helpers do.
+ *
+ * Not thread-safe. Keys and values are copied by assignment and never
+ * destroyed by the map.
+ *
+ * @code
+ *     TTAK_MAP_DEFINE(u64map, uint64_t, uint32_t, TTAK_TYPED_HASH_U64, TTAK_TYPED_EQ)
+ *
+ *     u64map_t m;
+ *     u64map_init(&m, 0);
+ *     u64map_put(&m, 42, 7);
+ *     uint32_t *v = u64map_get(&m, 42);
+ * @endcode
+ */
+
+#ifndef TTAK_HT_TYPED_MAP_H
+#define TTAK_HT_TYPED_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <ttak/ht/group.h>
+#include <ttak/ht/hash.h>
+#include <ttak/ht/wyhash.h>
+#include <ttak/mem/mem.h>
+
+/** Seed of the helper hashes; fixed, so hashes are reproducible. */
+#define TTAK_TYPED_HASH_SEED 0x2d358dccaa6c78a5ULL
+
+/** Hash for integer keys up to 64 bits. */
+#define TTAK_TYPED_HASH_U64(k) ttak_hash_u64((uint64_t)(k), TTAK_TYPED_HASH_SEED)
+
+/** Hash for NUL-terminated string keys. */
+#define TTAK_TYPED_HASH_STR(k) ttak_wyhash((k), strlen(k), TTAK_TYPED_HASH_SEED)
+
+/** Equality for scalar keys. */
+#define TTAK_TYPED_EQ(a, b) ((a) == (b))
+
+/** Equality for string keys. */
+#define TTAK_TYPED_STR_EQ(a, b) (strcmp((a), (b)) == 0)
+
+/** Slots kept free by growth: the map grows past 7/8 full, tombstones included. */
+#define TTAK_TYPED_MAP_LOAD_NUM 7
+#define TTAK_TYPED_MAP_LOAD_DEN 8
+
+#define TTAK_MAP_DEFINE(name, K, V, hash, eq)                                                          \
+    typedef struct name {                                                                              \
+        uint8_t *ctrls;   /* cap + TTAK_HT_PAD control bytes. */                                       \
+        K *keys;                                                                                       \
+        V *vals;                                                                                       \
+        size_t cap;       /* Power of two. */                                                          \
+        size_t size;                                                                                   \
+        size_t deleted;                                                                                \
+    } name##_t;                                                                                        \
+                                                                                                       \
+    /* One zeroed block: keys, then values, then control bytes (zero is EMPTY). */                     \
+    static inline bool name##_alloc_(name##_t *m, size_t cap) {                                        \
+        size_t slots = cap + TTAK_HT_PAD;                                                              \
+        size_t voff = (slots * sizeof(K) + _Alignof(V) - 1) & ~(size_t)(_Alignof(V) - 1);              \
+        size_t coff = voff + slots * sizeof(V);                                                        \
+        char *block = (char *)ttak_dangerous_calloc(1, coff + slots);                                  \
+        if (!block) return false;                                                                      \
+        m->keys = (K *)(void *)block;                                                                  \
+        m->vals = (V *)(void *)(block + voff);                                                         \
+        m->ctrls = (uint8_t *)(block + coff);                                                          \
+        m->cap = cap;                                                                                  \
+        m->size = 0;                                                                                   \
+        m->deleted = 0;                                                                                \
+        return true;                                                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    static inline size_t name##_find_(const name##_t *m, K key, uint64_t h) {                          \
+        size_t slots = m->cap + TTAK_HT_PAD;                                                           \
+        uint8_t tag = TTAK_CTRL_H2(h);                                                                 \
+        size_t pos = (size_t)h & (m->cap - 1);                                                         \
+        for (size_t n = ttak_ht_probe_limit(slots); n > 0; n--) {                                      \
+            const uint8_t *group = m->ctrls + pos;                                                     \
+            uint64_t match = ttak_ht_group_match(group, tag);                                          \
+            while (match != 0) {                                                                       \
+                size_t idx = pos + ttak_ht_mask_next(&match);                                          \
+                if (eq(m->keys[idx], key)) return idx;                                                 \
+            }                                                                                          \
+            if (ttak_ht_group_match_empty(group) != 0) break;                                          \
+            pos = ttak_ht_probe_next(pos, slots);                                                      \
+        }                                                                                              \
+        return SIZE_MAX;                                                                               \
+    }                                                                                                  \
+                                                                                                       \
+    static inline size_t name##_find_free_(const name##_t *m, uint64_t h) {                            \
+        size_t slots = m->cap + TTAK_HT_PAD;                                                           \
+        size_t pos = (size_t)h & (m->cap - 1);                                                         \
+        for (size_t n = ttak_ht_probe_limit(slots); n > 0; n--) {                                      \
+            uint64_t match = ttak_ht_group_match_free(m->ctrls + pos);                                 \
+            if (match != 0) return pos + ttak_ht_mask_next(&match);                                    \
+            pos = ttak_ht_probe_next(pos, slots);                                                      \
+        }                                                                                              \
+        return SIZE_MAX;                                                                               \
+    }                                                                                                  \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Initializes an empty map with room for about @p init_cap pairs.                          \
+     * @return False on allocation failure.                                                            \
+     */                                                                                                \
+    static inline bool name##_init(name##_t *m, size_t init_cap) {                                     \
+        size_t cap = 16;                                                                               \
+        while (cap * TTAK_TYPED_MAP_LOAD_NUM < init_cap * TTAK_TYPED_MAP_LOAD_DEN) cap <<= 1;          \
+        return name##_alloc_(m, cap);                                                                  \
+    }                                                                                                  \
+                                                                                                       \
+    static inline void name##_destroy(name##_t *m) {                                                   \
+        ttak_dangerous_free(m->keys);                                                                  \
+        memset(m, 0, sizeof(*m));                                                                      \
+    }                                                                                                  \
+                                                                                                       \
+    static inline bool name##_rehash_(name##_t *m, size_t cap) {                                       \
+        name##_t old = *m;                                                                             \
+        if (!name##_alloc_(m, cap)) {                                                                  \
+            *m = old;                                                                                  \
+            return false;                                                                              \
+        }                                                                                              \
+        for (size_t i = 0; i < old.cap + TTAK_HT_PAD; i++) {                                           \
+            if (!TTAK_CTRL_FULL(old.ctrls[i])) continue;                                               \
+            uint64_t h = (uint64_t)(hash(old.keys[i]));                                                \
+            size_t idx = name##_find_free_(m, h);                                                      \
+            m->keys[idx] = old.keys[i];                                                                \
+            m->vals[idx] = old.vals[i];                                                                \
+            m->ctrls[idx] = TTAK_CTRL_H2(h);                                                           \
+        }                                                                                              \
+        m->size = old.size;                                                                            \
+        ttak_dangerous_free(old.keys);                                                                 \
+        return true;                                                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Value stored under @p key, or NULL. Valid until the next put or remove.                  \
+     */                                                                                                \
+    static inline V *name##_get(const name##_t *m, K key) {                                            \
+        size_t idx = name##_find_(m, key, (uint64_t)(hash(key)));                                      \
+        return idx == SIZE_MAX ? NULL : &m->vals[idx];                                                 \
+    }                                                                                                  \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Inserts @p key or replaces its value.                                                    \
+     * @return False if the map needed to grow and could not allocate.                                \
+     */                                                                                                \
+    static inline bool name##_put(name##_t *m, K key, V val) {                                         \
+        uint64_t h = (uint64_t)(hash(key));                                                            \
+        size_t idx = name##_find_(m, key, h);                                                          \
+        if (idx != SIZE_MAX) {                                                                         \
+            m->vals[idx] = val;                                                                        \
+            return true;                                                                               \
+        }                                                                                              \
+        if ((m->size + m->deleted + 1) * TTAK_TYPED_MAP_LOAD_DEN > m->cap * TTAK_TYPED_MAP_LOAD_NUM) { \
+            /* Mostly tombstones: rehash at the same size; otherwise grow. */                          \
+            if (!name##_rehash_(m, m->size * 2 >= m->cap ? m->cap * 2 : m->cap)) return false;         \
+        }                                                                                              \
+        idx = name##_find_free_(m, h);                                                                 \
+        if (idx == SIZE_MAX) return false;                                                             \
+        if (m->ctrls[idx] == DELETED) m->deleted--;                                                    \
+        m->keys[idx] = key;                                                                            \
+        m->vals[idx] = val;                                                                            \
+        m->ctrls[idx] = TTAK_CTRL_H2(h);                                                               \
+        m->size++;                                                                                     \
+        return true;                                                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Removes @p key, copying its value to @p out if not NULL.                                 \
+     * @return True if it was present.                                                                 \
+     */                                                                                                \
+    static inline bool name##_remove(name##_t *m, K key, V *out) {                                     \
+        size_t idx = name##_find_(m, key, (uint64_t)(hash(key)));                                      \
+        if (idx == SIZE_MAX) return false;                                                             \
+        if (out) *out = m->vals[idx];                                                                  \
+        m->ctrls[idx] = DELETED;                                                                       \
+        m->size--;                                                                                     \
+        m->deleted++;                                                                                  \
+        return true;                                                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    static inline size_t name##_size(const name##_t *m) { return m->size; }                            \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Iterates pairs in slot order; start with *@p pos = 0.                                    \
+     * @return False once every pair has been visited.                                                 \
+     */                                                                                                \
+    static inline bool name##_next(const name##_t *m, size_t *pos, K **key, V **val) {                 \
+        for (size_t i = *pos; i < m->cap + TTAK_HT_PAD; i++) {                                         \
+            if (!TTAK_CTRL_FULL(m->ctrls[i])) continue;                                                \
+            if (key) *key = &m->keys[i];                                                               \
+            if (val) *val = &m->vals[i];                                                               \
+            *pos = i + 1;                                                                              \
+            return true;                                                                               \
+        }                                                                                              \
+        *pos = m->cap + TTAK_HT_PAD;                                                                   \
+        return false;                                                                                  \
+    }
+
+#endif // TTAK_HT_TYPED_MAP_H
@@ -28,6 +28,18 @@ extern "C" {
  */
 typedef void (*ttak_io_async_result_cb)(ttak_io_status_t status, size_t bytes, void *user);
 
+struct ttak_io_uring;
+
+/**
+ * @brief Routes ttak_io_async_read() and ttak_io_async_write() through
+ *        @p ring instead of the worker pool.
+ *
+ * Each call then queues one operation and submits it right away; callbacks
+ * run on whichever thread drives ttak_io_uring_poll() on @p ring. Pass NULL
+ * to go back to the pool. The ring must outlive every operation routed to it.
+ */
+void ttak_io_async_set_uring(struct ttak_io_uring *ring);
+
 /**
  * @brief Enqueues an asynchronous read from the guarded descriptor.
  *
@@ -1,9 +1,16 @@
 /**
  * @file bits.h
- * @brief Lightweight FNV-32 checksum utilities for buffer integrity checks.
+ * @brief Checksum utilities for buffer integrity checks.
  *
- * Provides a fast non-cryptographic checksum, a verifier, and a recovery
- * helper that copies a snapshot only when its checksum matches.
+ * Provides CRC32C (Castagnoli), the default checksum behind the verifier
+ * and the recovery helper that copies a snapshot only when its checksum
+ * matches, and the older byte-at-a-time FNV-1a.
+ *
+ * CRC32C uses the SSE4.2 crc32 instruction or the ARMv8 CRC32 extension
+ * when the host has them (ttak_arch_features()), and slicing-by-8 tables
+ * otherwise. Large buffers are split into three streams whose crc32
+ * chains run in parallel and are merged with a precomputed shift, which
+ * hides the instruction's three-cycle latency.
  */
 
 #ifndef TTAK_IO_BITS_H
@@ -28,11 +35,43 @@ extern "C" {
 uint32_t ttak_io_bits_fnv32(const void *data, size_t len);
 
 /**
- * @brief Verifies that a buffer's FNV-32 checksum matches an expected value.
+ * @brief Computes the CRC32C of a byte buffer.
+ *
+ * @param data Pointer to the data to checksum.
+ * @param len  Number of bytes.
+ * @return     CRC32C; 0 for an empty buffer.
+ */
+uint32_t ttak_io_bits_crc32c(const void *data, size_t len);
+
+/**
+ * @brief Extends a CRC32C over more data.
+ *
+ * ttak_io_bits_crc32c_update(ttak_io_bits_crc32c(a, n), b, m) equals the
+ * CRC32C of a followed by b.
+ *
+ * @param crc  CRC32C of the preceding bytes (0 to start).
+ */
+uint32_t ttak_io_bits_crc32c_update(uint32_t crc, const void *data, size_t len);
+
+/**
+ * @brief Name of the CRC32C kernel picked for this host: "sse4.2",
+ *        "armv8-crc" or "table".
+ */
+const char *ttak_io_bits_crc32c_impl(void);
+
+/**
+ * @brief Default checksum for ttak_io_bits_verify(); currently CRC32C.
+ */
+static inline uint32_t ttak_io_bits_checksum(const void *data, size_t len) {
+    return ttak_io_bits_crc32c(data, len);
+}
+
+/**
+ * @brief Verifies that a buffer's checksum matches an expected value.
  *
  * @param data              Buffer to verify.
  * @param len               Buffer length in bytes.
- * @param expected_checksum Expected FNV-32 digest.
+ * @param expected_checksum Expected ttak_io_bits_checksum() digest.
  * @return                  @c TTAK_IO_SUCCESS if matching, else error.
  */
 ttak_io_status_t ttak_io_bits_verify(const void *data,
@@ -45,7 +84,7 @@ ttak_io_status_t ttak_io_bits_verify(const void *data,
  * @param snapshot          Source snapshot buffer.
  * @param len               Buffer length in bytes.
  * @param dst               Destination to copy into on success.
- * @param expected_checksum Expected FNV-32 digest of @p snapshot.
+ * @param expected_checksum Expected ttak_io_bits_checksum() digest of @p snapshot.
  * @return                  @c TTAK_IO_SUCCESS if checksum matched and copy done.
  */
 ttak_io_status_t ttak_io_bits_recover(const void *snapshot,
@@ -0,0 +1,156 @@
+/**
+ * @file chain.h
+ * @brief Buffer chains: scatter/gather byte sequences over shared blocks.
+ *
+ * A chain is an ordered list of segments, each a window into a reference
+ * counted block allocated from a detachable arena. Appending copies bytes
+ * into the tail block while it has room and no other chain shares it;
+ * slicing, splitting and appending one chain onto another only take block
+ * references, so a header, a received payload and a trailer can be framed
+ * into one message without copying the payload. A zero-copy receive region
+ * can be adopted as a block as is.
+ *
+ * ttak_io_chain_to_iovec() exposes the segments for writev()/sendmsg(),
+ * and ttak_io_chain_send() sends them in one call and drops what went out.
+ *
+ * A chain is not thread-safe, but blocks may be shared by chains on other
+ * threads. Blocks from a worker-confined arena must be released on that
+ * worker. Do not copy a chain by value; it may point into itself.
+ */
+
+#ifndef TTAK_IO_CHAIN_H
+#define TTAK_IO_CHAIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/io/io.h>
+#include <ttak/io/zerocopy.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Segments a chain holds before it allocates a segment array. */
+#define TTAK_IO_CHAIN_INLINE_SEGS 8U
+
+/** Payload bytes of a block allocated by an append. */
+#define TTAK_IO_CHAIN_BLOCK_BYTES 2048U
+
+/** Segments one ttak_io_chain_send() call hands to the kernel. */
+#define TTAK_IO_CHAIN_IOV_MAX 64U
+
+typedef struct ttak_io_chain_block ttak_io_chain_block_t;
+
+/**
+ * @brief Window of @c len bytes at @c data inside @c block.
+ */
+typedef struct ttak_io_chain_seg {
+    ttak_io_chain_block_t *block;
+    uint8_t *data;
+    size_t len;
+} ttak_io_chain_seg_t;
+
+/**
+ * @brief Sequence of segments, @c len bytes in all.
+ */
+typedef struct ttak_io_chain {
+    ttak_io_chain_seg_t *segs;
+    uint32_t count;
+    uint32_t cap;
+    size_t len;
+    ttak_detachable_context_t *arena;   /**< Arena new blocks come from; NULL selects the default. */
+    ttak_io_chain_seg_t inline_segs[TTAK_IO_CHAIN_INLINE_SEGS];
+} ttak_io_chain_t;
+
+typedef ttak_io_chain_t tt_io_chain_t;
+
+/**
+ * @brief Initialises an empty chain allocating blocks from @p arena.
+ */
+void ttak_io_chain_init(ttak_io_chain_t *chain, ttak_detachable_context_t *arena);
+
+/**
+ * @brief Drops every segment, freeing blocks no other chain references.
+ *
+ * The chain stays initialised and may be reused.
+ */
+void ttak_io_chain_destroy(ttak_io_chain_t *chain);
+
+/**
+ * @brief Copies @p len bytes from @p data onto the end of @p chain.
+ */
+ttak_io_status_t ttak_io_chain_append(ttak_io_chain_t *chain, const void *data, size_t len, uint64_t now);
+
+/**
+ * @brief Appends @p len contiguous bytes and returns them for the caller to fill.
+ *
+ * @return The bytes, or NULL if no block could be allocated.
+ */
+uint8_t *ttak_io_chain_reserve(ttak_io_chain_t *chain, size_t len, uint64_t now);
+
+/**
+ * @brief Appends bytes [@p off, @p off + @p len) of @p src to @p dst without copying.
+ *
+ * @return TTAK_IO_ERR_INVALID_ARGUMENT if the range exceeds @p src or
+ *         @p dst is @p src.
+ */
+ttak_io_status_t ttak_io_chain_append_slice(ttak_io_chain_t *dst,
+                                            const ttak_io_chain_t *src,
+                                            size_t off,
+                                            size_t len);
+
+/**
+ * @brief Appends all of @p src to @p dst without copying.
+ */
+ttak_io_status_t ttak_io_chain_append_chain(ttak_io_chain_t *dst, const ttak_io_chain_t *src);
+
+/**
+ * @brief Moves the data received into @p region onto the end of @p chain.
+ *
+ * The region's buffer becomes a block of the chain and @p region is left
+ * empty, keeping its arena binding.
+ */
+ttak_io_status_t ttak_io_chain_adopt_region(ttak_io_chain_t *chain, ttak_io_zerocopy_region_t *region);
+
+/**
+ * @brief Moves bytes from @p off onwards to the end of @p tail, keeping the
+ *        first @p off in @p chain. No bytes are copied.
+ */
+ttak_io_status_t ttak_io_chain_split(ttak_io_chain_t *chain, size_t off, ttak_io_chain_t *tail);
+
+/**
+ * @brief Drops the first @p len bytes (all of them if fewer remain).
+ */
+void ttak_io_chain_consume(ttak_io_chain_t *chain, size_t len);
+
+/**
+ * @brief Copies up to @p len bytes starting at @p off into @p dst.
+ *
+ * @return Bytes copied.
+ */
+size_t ttak_io_chain_copyout(const ttak_io_chain_t *chain, size_t off, void *dst, size_t len);
+
+struct iovec;
+
+/**
+ * @brief Describes the first @p max segments in @p iov (POSIX).
+ *
+ * @return Entries filled.
+ */
+size_t ttak_io_chain_to_iovec(const ttak_io_chain_t *chain, struct iovec *iov, size_t max);
+
+/**
+ * @brief Sends the chain's bytes on @p fd in one gather call and consumes
+ *        what the kernel took.
+ *
+ * @param sent Bytes sent; may be NULL.
+ * @return TTAK_IO_ERR_NEEDS_RETRY if nothing could be sent without blocking.
+ */
+ttak_io_status_t ttak_io_chain_send(int fd, ttak_io_chain_t *chain, int flags, size_t *sent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_IO_CHAIN_H */
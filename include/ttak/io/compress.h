@@ -0,0 +1,257 @@
+/**
+ * @file compress.h
+ * @brief LZ4-class block compression, framed streams over buffer chains.
+ *
+ * Blocks use the LZ4 block format: literal runs and back-references of at
+ * least four bytes, up to 64 KiB back. The compressor is a single-probe
+ * greedy matcher, so it trades ratio for speed; checkpoints and ledgers
+ * still shrink several times over. An optional dictionary primes every
+ * block with up to 64 KiB of typical content, which pays off on short
+ * blocks of repetitive records such as JSONL lines.
+ *
+ * A frame is a 12-byte header followed by blocks, each prefixed by its
+ * decoded and encoded length, and an empty end block:
+ *
+ *     header  u32 magic "TTZ1" | u32 max block | u32 dictionary id
+ *     block   u32 raw length | u32 stored length (bit 31: not compressed) | bytes
+ *     end     u32 0 | u32 0
+ *
+ * All integers are little-endian. Blocks never reference each other, so
+ * a frame is compressed and decompressed a batch of blocks at a time on a
+ * thread pool, and the per-block lengths give every block its output
+ * offset before any of them is decoded. That lets ttak_io_decompress_frame()
+ * write straight into a caller's buffer, an arena allocation or a mapped
+ * file, with no staging copy.
+ *
+ * The stream types feed the same format through buffer chains in pieces,
+ * for writers that produce a checkpoint incrementally and readers that
+ * receive one from a socket.
+ */
+
+#ifndef TTAK_IO_COMPRESS_H
+#define TTAK_IO_COMPRESS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/io/chain.h>
+#include <ttak/io/io.h>
+#include <ttak/io/mmap.h>
+#include <ttak/thread/pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Bytes of dictionary a block can reference; longer dictionaries keep their tail. */
+#define TTAK_IO_COMPRESS_DICT_MAX (64U * 1024U)
+
+/** Block size used when none is given. */
+#define TTAK_IO_COMPRESS_BLOCK_DEFAULT (64U * 1024U)
+
+/** Largest block size a frame may declare. */
+#define TTAK_IO_COMPRESS_BLOCK_MAX (4U * 1024U * 1024U)
+
+/** Bytes of a frame header. */
+#define TTAK_IO_COMPRESS_FRAME_HEADER 12U
+
+/** Bytes in front of every block of a frame. */
+#define TTAK_IO_COMPRESS_BLOCK_HEADER 8U
+
+/**
+ * @brief Prepared dictionary: its bytes plus a primed match table.
+ *
+ * Immutable once created, so one dictionary may serve any number of
+ * threads at once.
+ */
+typedef struct ttak_io_compress_dict ttak_io_compress_dict_t;
+
+typedef ttak_io_compress_dict_t tt_io_compress_dict_t;
+
+/**
+ * @brief Copies the last TTAK_IO_COMPRESS_DICT_MAX bytes of @p data into a dictionary.
+ *
+ * @return NULL if @p len is 0 or on allocation failure.
+ */
+ttak_io_compress_dict_t *ttak_io_compress_dict_create(const void *data, size_t len);
+
+void ttak_io_compress_dict_destroy(ttak_io_compress_dict_t *dict);
+
+/**
+ * @brief Id a frame records so a reader can tell it holds the right dictionary.
+ *
+ * Derived from the contents; never 0.
+ */
+uint32_t ttak_io_compress_dict_id(const ttak_io_compress_dict_t *dict);
+
+/**
+ * @brief Largest encoding of @p len input bytes by ttak_io_compress_block().
+ */
+static inline size_t ttak_io_compress_bound(size_t len) {
+    return len + len / 255U + 16U;
+}
+
+/**
+ * @brief Compresses @p len bytes of @p src into @p dst.
+ *
+ * @param dict May be NULL; the decoder must then pass NULL too.
+ * @return Bytes written, or 0 if the result would not fit in @p cap or
+ *         @p len exceeds TTAK_IO_COMPRESS_BLOCK_MAX.
+ */
+size_t ttak_io_compress_block(const void *src, size_t len, void *dst, size_t cap,
+                              const ttak_io_compress_dict_t *dict);
+
+/**
+ * @brief Decodes one block of @p len bytes into @p dst.
+ *
+ * Every length and back-reference is checked, so a corrupt or hostile
+ * block fails cleanly instead of writing past @p cap.
+ *
+ * @param out_len Bytes decoded.
+ * @return TTAK_IO_ERR_RANGE for a malformed block or one that decodes to
+ *         more than @p cap bytes.
+ */
+ttak_io_status_t ttak_io_decompress_block(const void *src, size_t len, void *dst, size_t cap,
+                                          const ttak_io_compress_dict_t *dict, size_t *out_len);
+
+/**
+ * @brief Appends a complete frame holding @p len bytes of @p src to @p out.
+ *
+ * Blocks are compressed in parallel on @p pool, which may be NULL.
+ *
+ * @param block_size 0 selects TTAK_IO_COMPRESS_BLOCK_DEFAULT.
+ */
+ttak_io_status_t ttak_io_compress_frame(ttak_thread_pool_t *pool, const void *src, size_t len,
+                                        size_t block_size, const ttak_io_compress_dict_t *dict,
+                                        ttak_io_chain_t *out, uint64_t now);
+
+/**
+ * @brief Reads the decoded size of the frame in @p src from its block headers.
+ *
+ * Walks the headers only; no block is decoded.
+ *
+ * @return TTAK_IO_ERR_RANGE if the frame is truncated or malformed.
+ */
+ttak_io_status_t ttak_io_decompress_frame_size(const void *src, size_t len, size_t *size);
+
+/**
+ * @brief Decodes the frame in @p src into @p dst, blocks in parallel on @p pool.
+ *
+ * @p dst may be any writable memory: an arena allocation, a shared
+ * mapping of the output file, or a plain buffer sized with
+ * ttak_io_decompress_frame_size().
+ *
+ * @return TTAK_IO_ERR_INVALID_ARGUMENT if the frame needs a different
+ *         dictionary, TTAK_IO_ERR_RANGE if it is malformed or larger than @p cap.
+ */
+ttak_io_status_t ttak_io_decompress_frame(ttak_thread_pool_t *pool, const void *src, size_t len,
+                                          const ttak_io_compress_dict_t *dict,
+                                          void *dst, size_t cap, size_t *out_len);
+
+/**
+ * @brief Decodes a frame file mapped by ttak_io_mmap_create() into a new
+ *        allocation from @p arena.
+ *
+ * The mapping is retained for the duration of the call, so it may be
+ * closed concurrently. On success @p out holds exactly the decoded bytes;
+ * free it with ttak_detachable_mem_free().
+ */
+ttak_io_status_t ttak_io_decompress_mmap(ttak_thread_pool_t *pool, ttak_io_mmap_t *map,
+                                         const ttak_io_compress_dict_t *dict,
+                                         ttak_detachable_context_t *arena,
+                                         ttak_detachable_allocation_t *out, uint64_t now);
+
+/**
+ * @brief Incremental frame writer.
+ *
+ * Collects written bytes into a batch of blocks and compresses the batch
+ * on the pool once it is full; one block per live pool worker plus the
+ * caller, so every participant gets a block.
+ */
+typedef struct ttak_io_compress_stream {
+    ttak_thread_pool_t *pool;
+    const ttak_io_compress_dict_t *dict;
+    size_t block_size;
+    uint8_t *buf;           /**< Pending input, @c cap bytes. */
+    size_t len;
+    size_t cap;
+    bool started;           /**< Frame header written. */
+    uint64_t raw_bytes;     /**< Input consumed so far. */
+    uint64_t out_bytes;     /**< Frame bytes produced so far. */
+} ttak_io_compress_stream_t;
+
+typedef ttak_io_compress_stream_t tt_io_compress_stream_t;
+
+/**
+ * @param block_size 0 selects TTAK_IO_COMPRESS_BLOCK_DEFAULT.
+ * @return TTAK_IO_ERR_INVALID_ARGUMENT for a block size above the maximum.
+ */
+ttak_io_status_t ttak_io_compress_stream_init(ttak_io_compress_stream_t *stream, ttak_thread_pool_t *pool,
+                                              size_t block_size, const ttak_io_compress_dict_t *dict);
+
+void ttak_io_compress_stream_destroy(ttak_io_compress_stream_t *stream);
+
+/**
+ * @brief Buffers @p len bytes, appending the frame bytes of every batch it fills to @p out.
+ */
+ttak_io_status_t ttak_io_compress_stream_write(ttak_io_compress_stream_t *stream, const void *data, size_t len,
+                                               ttak_io_chain_t *out, uint64_t now);
+
+/**
+ * @brief Compresses whatever is buffered, so @p out holds every byte written so far.
+ *
+ * Emits a short block; flushing after every small write costs ratio.
+ */
+ttak_io_status_t ttak_io_compress_stream_flush(ttak_io_compress_stream_t *stream, ttak_io_chain_t *out,
+                                               uint64_t now);
+
+/**
+ * @brief Flushes and appends the end block. The stream may then start a new frame.
+ */
+ttak_io_status_t ttak_io_compress_stream_finish(ttak_io_compress_stream_t *stream, ttak_io_chain_t *out,
+                                                uint64_t now);
+
+/**
+ * @brief Incremental frame reader.
+ */
+typedef struct ttak_io_decompress_stream {
+    const ttak_io_compress_dict_t *dict;
+    uint8_t *scratch;       /**< Gathers a block split across segments. */
+    size_t scratch_cap;
+    uint32_t max_block;     /**< From the frame header; 0 before it arrives. */
+    bool finished;          /**< End block seen. */
+    uint64_t raw_bytes;
+} ttak_io_decompress_stream_t;
+
+typedef ttak_io_decompress_stream_t tt_io_decompress_stream_t;
+
+void ttak_io_decompress_stream_init(ttak_io_decompress_stream_t *stream, const ttak_io_compress_dict_t *dict);
+
+void ttak_io_decompress_stream_destroy(ttak_io_decompress_stream_t *stream);
+
+/**
+ * @brief Decodes every complete block at the front of @p in onto @p out.
+ *
+ * Consumed frame bytes are dropped from @p in; a partial block stays
+ * there for the next call. Each block is decoded straight into a block
+ * of @p out's arena. Bytes after the end block are left in @p in.
+ *
+ * @return TTAK_IO_ERR_RANGE or TTAK_IO_ERR_INVALID_ARGUMENT as for
+ *         ttak_io_decompress_frame(); the stream is then unusable.
+ */
+ttak_io_status_t ttak_io_decompress_stream_feed(ttak_io_decompress_stream_t *stream, ttak_io_chain_t *in,
+                                                ttak_io_chain_t *out, uint64_t now);
+
+/**
+ * @brief True once the end block has been decoded.
+ */
+static inline bool ttak_io_decompress_stream_done(const ttak_io_decompress_stream_t *stream) {
+    return stream->finished;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_IO_COMPRESS_H */
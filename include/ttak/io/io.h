@@ -11,6 +11,7 @@
 #ifndef TTAK_IO_IO_H
 #define TTAK_IO_IO_H
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -18,6 +19,7 @@
 #include <ttak/mem/owner.h>
 #include <ttak/mem/detachable.h>
 #include <ttak/timing/timing.h>
+#include <ttak/timing/wheel.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -59,15 +61,25 @@ typedef struct ttak_io_buffer {
  * All I/O operations check the guard before touching the fd.  Once
  * @c expires_at is exceeded the guard is considered invalid and operations
  * return @c TTAK_IO_ERR_EXPIRED_GUARD.
+ *
+ * In coarse mode (ttak_io_guard_set_coarse()) a refresh writes the guard
+ * at most once per window, so busy connections stop dirtying its cache
+ * line on every operation. With a timer wheel attached, expiry is decided
+ * by a timer instead and ttak_io_guard_valid() no longer reads the clock.
  */
 typedef struct ttak_io_guard {
     int fd;                 /**< Underlying file descriptor. */
     ttak_owner_t *owner;    /**< Owning arena/epoch context. */
     uint64_t ttl_ns;        /**< Configured time-to-live in nanoseconds. */
-    uint64_t expires_at;    /**< Absolute expiry timestamp (ns). */
-    uint64_t last_used;     /**< Timestamp of the last successful operation. */
+    _Atomic uint64_t expires_at; /**< Absolute expiry timestamp (ns); 0 never expires. */
+    uint64_t last_used;     /**< Timestamp of the last refresh that wrote the guard. */
     bool closed;            /**< True after ttak_io_guard_close(). */
     char resource_tag[32];  /**< Diagnostic label for the guarded resource. */
+    uint64_t coarse_ns;     /**< Coarse refresh window; 0 refreshes on every op. */
+    ttak_timer_wheel_t *wheel;  /**< Wheel enforcing expiry in coarse mode, or NULL. */
+    ttak_timer_t ttl_timer;     /**< Armed at the deadline while @c wheel is set. */
+    uint64_t timer_deadline;    /**< @c expires_at the timer was last armed for. */
+    _Atomic bool expired;       /**< Set by the TTL timer once the deadline passes unrefreshed. */
 } ttak_io_guard_t;
 
 typedef void (*ttak_io_poll_cb)(int fd, short revents, void *user);
@@ -78,12 +90,53 @@ ttak_io_status_t ttak_io_guard_init(ttak_io_guard_t *guard,
                                     uint64_t ttl_ns,
                                     uint64_t now);
 
+/**
+ * @brief Points a closed or recycled guard at a new descriptor.
+ *
+ * Same result as ttak_io_guard_init(), but the guard is not cleared and
+ * the owner's resource entry is only rewritten when the owner or the
+ * descriptor number changed since the guard was last bound. Pooled
+ * endpoints use it so a reconnect on a reused fd stays off the owner lock.
+ */
+ttak_io_status_t ttak_io_guard_rebind(ttak_io_guard_t *guard,
+                                      int fd,
+                                      ttak_owner_t *owner,
+                                      uint64_t ttl_ns,
+                                      uint64_t now);
+
 ttak_io_status_t ttak_io_guard_refresh(ttak_io_guard_t *guard, uint64_t now);
 
 ttak_io_status_t ttak_io_guard_close(ttak_io_guard_t *guard, uint64_t now);
 
 bool ttak_io_guard_valid(const ttak_io_guard_t *guard, uint64_t now);
 
+/**
+ * @brief Switches an open guard to coarse TTL tracking.
+ *
+ * Refreshes within @p window_ns of the last written one return without
+ * touching the guard, and the deadline is extended by the window so a
+ * guard in use never expires early; expiry is therefore accurate to one
+ * window. With @p wheel set, a TTL timer on it marks the guard expired
+ * and ttak_io_guard_valid() only reads that flag. A window of 0 and a
+ * NULL wheel return the guard to per-operation tracking.
+ *
+ * ttak_io_guard_close() disarms the timer. When @p wheel is advanced on
+ * another thread its callback may already be running, so free a closed
+ * guard through ttak_epoch_retire(); the callback runs inside an epoch.
+ */
+ttak_io_status_t ttak_io_guard_set_coarse(ttak_io_guard_t *guard,
+                                          uint64_t window_ns,
+                                          ttak_timer_wheel_t *wheel);
+
+/**
+ * @brief Stable, non-zero task hash for work on @p guard's connection.
+ *
+ * Tasks tagged with it through ttak_task_set_hash() route to the same pool
+ * shard, so one connection's work stays on one worker; other workers only
+ * steal it when that one falls behind.
+ */
+uint64_t ttak_io_guard_affinity(const ttak_io_guard_t *guard);
+
 ttak_io_status_t ttak_io_buffer_acquire(ttak_io_buffer_t *buffer,
                                         void *user_ptr,
                                         size_t len,
@@ -98,6 +151,13 @@ ttak_io_status_t ttak_io_buffer_sync_out(ttak_io_buffer_t *buffer, size_t bytes,
 
 void ttak_io_buffer_release(ttak_io_buffer_t *buffer);
 
+/**
+ * @brief Waits once for @p events on the guarded fd.
+ *
+ * With @p schedule_async the wait runs as its own task on a pool thread,
+ * one poll() per call; descriptors watched for their whole lifetime are
+ * better registered with a ttak_io_reactor_t (see reactor.h).
+ */
 ttak_io_status_t ttak_io_poll_wait(const ttak_io_guard_t *guard,
                                    short events,
                                    int timeout_ms,
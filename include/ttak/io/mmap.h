@@ -0,0 +1,132 @@
+/**
+ * @file mmap.h
+ * @brief Read-only file mappings with guard-checked access and paging hints.
+ *
+ * Large read-mostly files (snapshots, lookup tables) are mapped once and
+ * read in place. The descriptor lives in an I/O guard, so a mapping obeys
+ * the same TTL and close rules as a socket: once the guard is closed or
+ * has expired no new slices are handed out. Slices already taken keep the
+ * pages mapped until they are released, so closing never pulls memory out
+ * from under a reader.
+ *
+ * Paging behaviour is tuned with madvise() hints, prefetches that fault
+ * pages in on the async pool, MAP_POPULATE at map time and, on request, a
+ * 2 MiB aligned mapping so the kernel can back it with huge pages.
+ * ttak_net_view_from_mmap() wraps a slice as a ttak_net_view_t.
+ */
+
+#ifndef TTAK_IO_MMAP_H
+#define TTAK_IO_MMAP_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/io/async.h>
+#include <ttak/io/io.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Fault the whole file in while mapping it (MAP_POPULATE). */
+#define TTAK_IO_MMAP_POPULATE   (1U << 0)
+/** Align the mapping to TTAK_IO_MMAP_HUGE_ALIGN and ask for huge pages. */
+#define TTAK_IO_MMAP_HUGE       (1U << 1)
+
+/** Alignment of a TTAK_IO_MMAP_HUGE mapping. */
+#define TTAK_IO_MMAP_HUGE_ALIGN (2U * 1024U * 1024U)
+
+typedef enum ttak_io_mmap_advice {
+    TTAK_IO_MMAP_NORMAL = 0,    /**< Default readahead. */
+    TTAK_IO_MMAP_SEQUENTIAL,    /**< Read front to back; aggressive readahead. */
+    TTAK_IO_MMAP_RANDOM         /**< Scattered lookups; no readahead. */
+} ttak_io_mmap_advice_t;
+
+/**
+ * @brief A mapped file. Created by ttak_io_mmap_create().
+ *
+ * @c refs counts the creator's handle plus every slice and prefetch in
+ * flight; the pages are unmapped when it drops to zero.
+ */
+typedef struct ttak_io_mmap {
+    ttak_io_guard_t guard;      /**< Owns the file descriptor. */
+    const uint8_t *data;        /**< First byte of the file. */
+    size_t len;                 /**< File size at map time. */
+    size_t page_size;
+    uint32_t flags;             /**< TTAK_IO_MMAP_* given at creation. */
+    ttak_io_mmap_advice_t advice;
+    _Atomic uint32_t refs;
+} ttak_io_mmap_t;
+
+typedef ttak_io_mmap_t tt_io_mmap_t;
+
+/**
+ * @brief Maps all of @p fd read-only and takes ownership of the descriptor.
+ *
+ * @param ttl_ns Guard TTL; every slice refreshes it.
+ * @param flags  TTAK_IO_MMAP_* bits.
+ * @return The mapping, or NULL if @p fd is empty or cannot be mapped
+ *         (the descriptor is closed either way).
+ */
+ttak_io_mmap_t *ttak_io_mmap_create(int fd, ttak_owner_t *owner, uint64_t ttl_ns, uint32_t flags, uint64_t now);
+
+/**
+ * @brief Closes the guard and drops the creator's reference.
+ *
+ * The pages stay mapped until the last slice is released; @p map must not
+ * be passed to anything but ttak_io_mmap_release() afterwards.
+ */
+void ttak_io_mmap_close(ttak_io_mmap_t *map, uint64_t now);
+
+/**
+ * @brief Applies @p advice to the pages covering [@p offset, @p offset + @p len).
+ *
+ * A @p len of 0 covers the rest of the file.
+ */
+ttak_io_status_t ttak_io_mmap_advise(ttak_io_mmap_t *map,
+                                     size_t offset,
+                                     size_t len,
+                                     ttak_io_mmap_advice_t advice,
+                                     uint64_t now);
+
+/**
+ * @brief Reads the range ahead on the async pool.
+ *
+ * Issues MADV_WILLNEED and faults the pages in, so later reads of the
+ * range neither block on the disk nor take page faults. @p cb, if given,
+ * receives the bytes covered once the pages are resident. Without a pool
+ * the work runs before this returns. A @p len of 0 covers the rest of the
+ * file.
+ */
+ttak_io_status_t ttak_io_mmap_prefetch(ttak_io_mmap_t *map,
+                                       size_t offset,
+                                       size_t len,
+                                       ttak_io_async_result_cb cb,
+                                       void *user,
+                                       uint64_t now);
+
+/**
+ * @brief Takes a reference on [@p offset, @p offset + @p len) after checking the guard.
+ *
+ * @param data Receives a pointer to @p offset; valid until the matching
+ *             ttak_io_mmap_release().
+ * @return TTAK_IO_ERR_EXPIRED_GUARD once the mapping is closed or expired,
+ *         TTAK_IO_ERR_RANGE for a range past the end of the file.
+ */
+ttak_io_status_t ttak_io_mmap_retain(ttak_io_mmap_t *map,
+                                     size_t offset,
+                                     size_t len,
+                                     const uint8_t **data,
+                                     uint64_t now);
+
+/**
+ * @brief Drops a reference taken by ttak_io_mmap_retain() or ttak_io_mmap_create().
+ */
+void ttak_io_mmap_release(ttak_io_mmap_t *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_IO_MMAP_H */
@@ -0,0 +1,112 @@
+/**
+ * @file reactor.h
+ * @brief Edge-triggered readiness reactor over epoll or kqueue.
+ *
+ * Where ttak_io_poll_wait() spends a pool task and a poll() call per wait,
+ * a reactor runs a few I/O threads, each owning one epoll (Linux) or
+ * kqueue (BSD, macOS) instance. Guarded descriptors are registered once,
+ * edge-triggered, with the loop picked by their fd; every wakeup of a loop
+ * collects up to TTAK_IO_REACTOR_BATCH ready descriptors and hands all of
+ * their callbacks to the thread pool as a single task.
+ *
+ * Edge-triggered means a callback fires when the descriptor becomes ready,
+ * not while it stays ready: drain it (read or write until EAGAIN) before
+ * returning. Callbacks of one batch run in order on one worker; callbacks
+ * for the same descriptor from different wakeups may overlap.
+ *
+ * Platforms without epoll or kqueue (including Windows) get NULL from
+ * ttak_io_reactor_create() and should keep using ttak_io_poll_wait().
+ */
+
+#ifndef TTAK_IO_REACTOR_H
+#define TTAK_IO_REACTOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/io/io.h>
+#include <ttak/thread/pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Most ready descriptors one loop collects, and dispatches as one task, per wakeup. */
+#define TTAK_IO_REACTOR_BATCH 64
+
+/** Most I/O threads a reactor runs. */
+#define TTAK_IO_REACTOR_MAX_LOOPS 64
+
+typedef struct ttak_io_reactor ttak_io_reactor_t;
+
+/** @brief A registration returned by ttak_io_reactor_add(). */
+typedef struct ttak_io_watch ttak_io_watch_t;
+
+/**
+ * @brief Called once the reactor can no longer invoke a watch's callback,
+ *        so @p user may be freed.
+ */
+typedef void (*ttak_io_reactor_release_cb)(void *user);
+
+/**
+ * @brief Starts @p loops I/O threads.
+ *
+ * @param loops Number of I/O threads, clamped to [1, TTAK_IO_REACTOR_MAX_LOOPS].
+ * @param pool  Pool that runs the callbacks, or NULL to run them on the I/O
+ *              thread itself (keep them short then).
+ * @return The reactor, or NULL on failure or an unsupported platform.
+ */
+ttak_io_reactor_t *ttak_io_reactor_create(size_t loops, ttak_thread_pool_t *pool);
+
+/**
+ * @brief Stops the I/O threads and releases every remaining watch.
+ *
+ * Batches already handed to the pool still run; @p pool must outlive them.
+ */
+void ttak_io_reactor_destroy(ttak_io_reactor_t *reactor);
+
+/**
+ * @brief Registers @p guard's descriptor for @p events.
+ *
+ * @param events  POLLIN and/or POLLOUT.
+ * @param cb      Receives the fd, the ready events (POLLIN, POLLOUT, POLLHUP,
+ *                POLLERR) and @p user. A guard found expired on a wakeup is
+ *                reported as POLLHUP | POLLERR once and then removed.
+ * @param release Called with @p user after the watch is gone; may be NULL.
+ * @param out     Receives the watch handle; may be NULL if never removed.
+ * @return TTAK_IO_ERR_EXPIRED_GUARD for an invalid guard,
+ *         TTAK_IO_ERR_SYS_FAILURE if the kernel refused the descriptor.
+ */
+ttak_io_status_t ttak_io_reactor_add(ttak_io_reactor_t *reactor,
+                                     ttak_io_guard_t *guard,
+                                     short events,
+                                     ttak_io_poll_cb cb,
+                                     void *user,
+                                     ttak_io_reactor_release_cb release,
+                                     ttak_io_watch_t **out,
+                                     uint64_t now);
+
+/**
+ * @brief Changes the events a watch waits for.
+ */
+ttak_io_status_t ttak_io_reactor_modify(ttak_io_watch_t *watch, short events);
+
+/**
+ * @brief Unregisters a watch. Call before closing its guard.
+ *
+ * No callback starts after this returns; one already running may still
+ * finish, which is what the release callback waits for.
+ */
+void ttak_io_reactor_remove(ttak_io_watch_t *watch);
+
+/**
+ * @brief Number of live watches.
+ */
+size_t ttak_io_reactor_watch_count(ttak_io_reactor_t *reactor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_IO_REACTOR_H */
@@ -0,0 +1,195 @@
+/**
+ * @file uring.h
+ * @brief io_uring submission/completion rings for guarded descriptors (Linux).
+ *
+ * ttak_io_async_read() and ttak_io_async_write() spend a pool task, a
+ * poll() and a blocking syscall per operation. A ring instead queues
+ * operations as submission entries, hands the whole batch to the kernel in
+ * one io_uring_enter(), and reaps completions in batches on the thread that
+ * calls ttak_io_uring_poll(); no worker thread touches an operation.
+ *
+ * Each ring owns an arena of equal-sized receive buffers taken from the
+ * detachable allocator. The arena is registered with the kernel as a fixed
+ * buffer, so reads and writes that land inside it skip the per-call page
+ * pinning, and its buffers are provided to the kernel for multishot
+ * receive: one ttak_io_uring_recv() keeps delivering incoming data straight
+ * into arena buffers, each surfaced as a read-only
+ * @c ttak_io_zerocopy_region_t, until the caller stops it or buffers run out.
+ * Guards may also be registered as fixed files to spare the kernel an fd
+ * table lookup per operation.
+ *
+ * Operations may be queued from any thread; completions are delivered only
+ * from ttak_io_uring_poll(), which one thread at a time should drive.
+ * Other platforms, and kernels without io_uring, get NULL from
+ * ttak_io_uring_create().
+ */
+
+#ifndef TTAK_IO_URING_H
+#define TTAK_IO_URING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/io/async.h>
+#include <ttak/io/io.h>
+#include <ttak/io/zerocopy.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Most receive buffers a ring provides; counts are rounded up to a power of two. */
+#define TTAK_IO_URING_MAX_BUFS 32768U
+
+/** Largest receive buffer, so one buffer fits a region's segment mask. */
+#define TTAK_IO_URING_MAX_BUF_BYTES ((size_t)TTAK_IO_ZC_MAX_SEGMENTS * TTAK_IO_ZC_SEG_BYTES)
+
+/** Fixed-file slots per ring. */
+#define TTAK_IO_URING_MAX_FILES 256U
+
+/** Completions ttak_io_uring_poll() reaps under one lock hold. */
+#define TTAK_IO_URING_REAP_BATCH 64U
+
+typedef struct ttak_io_uring ttak_io_uring_t;
+
+typedef ttak_io_uring_t tt_io_uring_t;
+
+/**
+ * @brief Receives each chunk of a multishot receive.
+ *
+ * @param status  TTAK_IO_SUCCESS with data, or with @p region->len == 0 at
+ *                end of stream; TTAK_IO_ERR_NEEDS_RETRY when the ring ran
+ *                out of buffers or the receive was cancelled.
+ * @param region  On success with data, a read-only view of one ring buffer.
+ *                Copy the struct to keep it and hand it back through
+ *                ttak_io_uring_recycle() once done; only valid for this
+ *                call otherwise.
+ * @param more    False on the last callback of this receive.
+ * @param user    Context passed to ttak_io_uring_recv().
+ */
+typedef void (*ttak_io_uring_recv_cb)(ttak_io_status_t status,
+                                      const ttak_io_zerocopy_region_t *region,
+                                      bool more,
+                                      void *user);
+
+/**
+ * @brief Creates a ring.
+ *
+ * @param entries   Submission queue depth, rounded up to a power of two by
+ *                  the kernel; the completion queue is twice as deep.
+ * @param buf_count Receive buffers, rounded up to a power of two and
+ *                  clamped to TTAK_IO_URING_MAX_BUFS; 0 disables multishot
+ *                  receive.
+ * @param buf_size  Bytes per receive buffer, rounded up to
+ *                  TTAK_IO_ZC_SEG_BYTES and clamped to
+ *                  TTAK_IO_URING_MAX_BUF_BYTES.
+ * @param now       Current monotonic timestamp in nanoseconds.
+ * @return The ring, or NULL on failure or where io_uring is unavailable.
+ */
+ttak_io_uring_t *ttak_io_uring_create(unsigned entries, unsigned buf_count, size_t buf_size, uint64_t now);
+
+/**
+ * @brief Tears the ring down.
+ *
+ * Operations still in flight are cancelled by the kernel without their
+ * callbacks running; regions not yet recycled become invalid.
+ */
+void ttak_io_uring_destroy(ttak_io_uring_t *ring);
+
+/**
+ * @brief Registers @p guard's descriptor as a fixed file of @p ring.
+ *
+ * Later operations on the guard use the fixed slot. Unregister before
+ * closing the guard.
+ *
+ * @return TTAK_IO_ERR_RANGE when every slot is taken.
+ */
+ttak_io_status_t ttak_io_uring_register_guard(ttak_io_uring_t *ring, ttak_io_guard_t *guard, uint64_t now);
+
+/**
+ * @brief Releases the fixed slot registered for @p guard, if any.
+ */
+void ttak_io_uring_unregister_guard(ttak_io_uring_t *ring, const ttak_io_guard_t *guard);
+
+/**
+ * @brief Queues a read of up to @p len bytes into @p dst.
+ *
+ * @param timeout_ms Cancels the read after this long, completing it with
+ *                   TTAK_IO_ERR_NEEDS_RETRY; -1 waits indefinitely.
+ * @param cb         Called from ttak_io_uring_poll() with the bytes read;
+ *                   may be NULL.
+ * @return TTAK_IO_ERR_NEEDS_RETRY if the ring is full.
+ */
+ttak_io_status_t ttak_io_uring_read(ttak_io_uring_t *ring,
+                                    ttak_io_guard_t *guard,
+                                    void *dst,
+                                    size_t len,
+                                    int timeout_ms,
+                                    ttak_io_async_result_cb cb,
+                                    void *user,
+                                    uint64_t now);
+
+/**
+ * @brief Queues a write of @p len bytes from @p src.
+ *
+ * @p src may point into a received region, which forwards it without a
+ * copy; recycle the region only after @p cb has run.
+ */
+ttak_io_status_t ttak_io_uring_write(ttak_io_uring_t *ring,
+                                     ttak_io_guard_t *guard,
+                                     const void *src,
+                                     size_t len,
+                                     int timeout_ms,
+                                     ttak_io_async_result_cb cb,
+                                     void *user,
+                                     uint64_t now);
+
+/**
+ * @brief Starts a multishot receive on a socket guard.
+ *
+ * Each arriving chunk lands in a free ring buffer and is reported to
+ * @p cb. The receive runs until end of stream, an error, the ring running
+ * out of buffers (recycle faster, then start a new receive), or
+ * ttak_io_uring_cancel().
+ *
+ * @return TTAK_IO_ERR_INVALID_ARGUMENT if the ring has no receive buffers.
+ */
+ttak_io_status_t ttak_io_uring_recv(ttak_io_uring_t *ring,
+                                    ttak_io_guard_t *guard,
+                                    ttak_io_uring_recv_cb cb,
+                                    void *user,
+                                    uint64_t now);
+
+/**
+ * @brief Returns a received region's buffer to the kernel.
+ *
+ * May be called from any thread, once per region.
+ */
+ttak_io_status_t ttak_io_uring_recycle(ttak_io_uring_t *ring, const ttak_io_zerocopy_region_t *region);
+
+/**
+ * @brief Cancels every operation queued on @p guard.
+ *
+ * Each completes through its callback with TTAK_IO_ERR_NEEDS_RETRY.
+ */
+ttak_io_status_t ttak_io_uring_cancel(ttak_io_uring_t *ring, const ttak_io_guard_t *guard);
+
+/**
+ * @brief Hands queued operations to the kernel without waiting.
+ */
+ttak_io_status_t ttak_io_uring_submit(ttak_io_uring_t *ring);
+
+/**
+ * @brief Submits queued operations, waits for at least @p wait_nr
+ *        completions, and runs the callbacks of every completion ready.
+ *
+ * @return Number of callbacks run.
+ */
+size_t ttak_io_uring_poll(ttak_io_uring_t *ring, unsigned wait_nr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_IO_URING_H */
@@ -36,6 +36,7 @@ typedef struct ttak_io_zerocopy_region {
     uint32_t segment_mask[TTAK_IO_ZC_SEGMENT_WORD_COUNT];
     ttak_detachable_context_t *arena;
     ttak_detachable_allocation_t allocation;
+    ttak_detachable_context_t *bound_arena; /**< Arena recv allocates from; NULL selects the default. */
 } ttak_io_zerocopy_region_t;
 
 /**
@@ -43,6 +44,16 @@ typedef struct ttak_io_zerocopy_region {
  */
 void ttak_io_zerocopy_region_init(ttak_io_zerocopy_region_t *region);
 
+/**
+ * @brief Makes every later recv on @p region allocate from @p arena.
+ *
+ * Binding a worker's confined context (ttak_worker_detachable_context())
+ * keeps receive buffers off the shared default arena; the region must then
+ * be received into and released on that worker only. The binding survives
+ * ttak_io_zerocopy_release(); pass NULL to restore the default arena.
+ */
+void ttak_io_zerocopy_region_bind(ttak_io_zerocopy_region_t *region, ttak_detachable_context_t *arena);
+
 /**
  * @brief Receives data from @p fd into a detachable buffer without copying back
  *        into user memory.
@@ -61,6 +72,107 @@ ttak_io_status_t ttak_io_zerocopy_recv_fd(int fd,
  */
 void ttak_io_zerocopy_release(ttak_io_zerocopy_region_t *region);
 
+/** Default payload size below which a zero-copy send just copies. */
+#define TTAK_IO_ZC_TX_THRESHOLD    (10U * 1024U)
+
+/** Sends whose buffers a transmit context can hold awaiting completion. */
+#define TTAK_IO_ZC_TX_MAX_PENDING  64U
+
+/**
+ * @brief Buffer handed to the kernel by MSG_ZEROCOPY, kept until the
+ *        error-queue notification covering its send calls arrives.
+ */
+typedef struct ttak_io_zerocopy_pending {
+    ttak_detachable_allocation_t allocation;
+    uint32_t first_id;      /**< Kernel counter of the first send call. */
+    uint32_t calls;         /**< Send calls made from this buffer. */
+    uint32_t completed;     /**< Calls the kernel has reported done. */
+} ttak_io_zerocopy_pending_t;
+
+/**
+ * @brief Zero-copy transmit state for one socket.
+ *
+ * Payloads are built in buffers from ttak_io_zerocopy_tx_alloc() and handed
+ * over by ttak_io_zerocopy_send(). Payloads of at least @c threshold bytes
+ * go out with MSG_ZEROCOPY (Linux); the kernel then transmits straight from
+ * the buffer, which stays in the arena until ttak_io_zerocopy_tx_reap()
+ * sees its completion. Smaller payloads, and sockets or platforms without
+ * SO_ZEROCOPY, are sent with an ordinary copy and freed at once. A context
+ * is not thread-safe.
+ */
+typedef struct ttak_io_zerocopy_tx {
+    int fd;
+    bool enabled;                   /**< SO_ZEROCOPY accepted by the socket. */
+    size_t threshold;
+    ttak_detachable_context_t *arena;
+    uint32_t next_id;               /**< Mirrors the kernel's per-socket send counter. */
+    uint32_t head;
+    uint32_t count;
+    uint64_t zerocopied;            /**< Completed calls the kernel sent without copying. */
+    uint64_t copied;                /**< Completed calls the kernel fell back to copying. */
+    ttak_io_zerocopy_pending_t pending[TTAK_IO_ZC_TX_MAX_PENDING];
+} ttak_io_zerocopy_tx_t;
+
+/**
+ * @brief Prepares @p tx for sends on @p fd and asks the socket for SO_ZEROCOPY.
+ *
+ * @param arena     Arena for payload buffers; NULL selects the default.
+ * @param threshold Smallest payload sent zero-copy; 0 selects
+ *                  TTAK_IO_ZC_TX_THRESHOLD.
+ */
+ttak_io_status_t ttak_io_zerocopy_tx_init(ttak_io_zerocopy_tx_t *tx,
+                                          int fd,
+                                          ttak_detachable_context_t *arena,
+                                          size_t threshold);
+
+/**
+ * @brief Allocates a payload buffer from the context's arena.
+ */
+ttak_detachable_allocation_t ttak_io_zerocopy_tx_alloc(ttak_io_zerocopy_tx_t *tx, size_t len, uint64_t now);
+
+/**
+ * @brief Sends the first @p len bytes of @p alloc and takes ownership of it.
+ *
+ * Runs until every byte is queued, waiting for writability on a
+ * non-blocking socket and for completions when the pending table or the
+ * socket's pinned-page budget is full. @p alloc is cleared on return: its
+ * buffer is either freed or pending until reaped, even on failure.
+ *
+ * @param sent Receives the bytes queued; may be NULL.
+ */
+ttak_io_status_t ttak_io_zerocopy_send(ttak_io_zerocopy_tx_t *tx,
+                                       ttak_detachable_allocation_t *alloc,
+                                       size_t len,
+                                       int flags,
+                                       size_t *sent);
+
+/**
+ * @brief Drains completion notifications and frees finished buffers.
+ *
+ * @param timeout_ms How long to wait for a first notification when buffers
+ *                   are pending; 0 only drains what has arrived.
+ * @return Buffers freed.
+ */
+size_t ttak_io_zerocopy_tx_reap(ttak_io_zerocopy_tx_t *tx, int timeout_ms);
+
+/**
+ * @brief Waits up to @p timeout_ms for outstanding completions, then frees
+ *        every buffer still pending.
+ *
+ * Buffers freed without a completion may still be read by the kernel; close
+ * or shut down the socket first if that matters.
+ */
+void ttak_io_zerocopy_tx_destroy(ttak_io_zerocopy_tx_t *tx, int timeout_ms);
+
+/**
+ * @brief Sends @p len bytes of the file @p in_fd from @p *offset to the
+ *        socket @p out_fd without staging them in user memory.
+ *
+ * Uses sendfile(2) on Linux and a pread/send loop elsewhere; @p *offset
+ * advances by the bytes sent and the file position is left untouched.
+ */
+ttak_io_status_t ttak_io_zerocopy_sendfile(int out_fd, int in_fd, uint64_t *offset, size_t len, size_t *sent);
+
 #ifdef __cplusplus
 }
 #endif
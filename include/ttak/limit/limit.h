@@ -1,29 +1,49 @@
 #ifndef TTAK_LIMIT_LIMIT_H
 #define TTAK_LIMIT_LIMIT_H
 
-#include <stdint.h>
+#include <stdatomic.h>
 #include <stdbool.h>
-#include <ttak/sync/sync.h>
-#include <ttak/sync/spinlock.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Fixed-point scale of token counts: limiters account in billionths of a token. */
+#define TTAK_NANOTOKENS_PER_TOKEN 1000000000ULL
+
+/** Lease shards of a tenant limiter; threads beyond this share shards. */
+#define TTAK_RATELIMIT_SHARDS 8
 
 /**
  * @brief Token Bucket structure for rate limiting.
- * 
- * Implements the standard token bucket algorithm.
- * Thread-safe using a spinlock.
+ *
+ * Tokens are held as an integer count of nanotokens, so a check is one
+ * 64-bit CAS with no lock and no floating point. Because tokens per second
+ * equals nanotokens per nanosecond, refill is the elapsed nanoseconds times
+ * @c rate_q32, a 32.32 fixed-point rate. Whichever thread advances
+ * @c last_ns by CAS credits that interval, so no time is counted twice or
+ * lost.
  */
 typedef struct ttak_token_bucket {
-    double tokens;              /**< Current number of tokens available. */
-    double max_tokens;          /**< Maximum bucket capacity (burst size). */
-    double refill_rate;         /**< Rate at which tokens are refilled (tokens per second). */
-    uint64_t last_refill_ts;    /**< Timestamp of the last refill operation. */
-    ttak_spin_t lock;           /**< Spinlock for thread safety. */
+    _Atomic uint64_t tokens;    /**< Nanotokens currently available. */
+    _Atomic uint64_t last_ns;   /**< Time up to which refill has been credited. */
+    uint64_t max_tokens;        /**< Burst capacity in nanotokens. */
+    uint64_t rate_q32;          /**< Nanotokens per nanosecond, 32.32 fixed point. */
+    uint64_t fill_ns;           /**< Time to fill from empty; longer gaps just fill. */
 } ttak_token_bucket_t;
 
 typedef ttak_token_bucket_t tt_token_bucket_t;
 
 /**
- * @brief Initializes a token bucket.
+ * @brief Converts a token count to nanotokens, rounding to nearest and
+ *        saturating; non-positive and NaN counts are 0.
+ */
+static inline uint64_t ttak_tokens_to_nanotokens(double tokens) {
+    if (!(tokens > 0.0)) return 0;
+    double nt = tokens * (double)TTAK_NANOTOKENS_PER_TOKEN;
+    return nt >= 1.8e19 ? UINT64_MAX : (uint64_t)(nt + 0.5);
+}
+
+/**
+ * @brief Initializes a token bucket, full, as of the coarse clock.
  * 
  * @param tb Pointer to the bucket.
  * @param rate Refill rate in tokens per second.
@@ -31,8 +51,15 @@ typedef ttak_token_bucket_t tt_token_bucket_t;
  */
 void ttak_token_bucket_init(ttak_token_bucket_t *tb, double rate, double burst);
 
+/**
+ * @brief Initializes a token bucket, full, as of @p now_ns.
+ */
+void ttak_token_bucket_init_at(ttak_token_bucket_t *tb, double rate, double burst, uint64_t now_ns);
+
 /**
  * @brief Attempts to consume tokens from the bucket.
+ *
+ * Reads the time from ttak_get_tick_count_coarse_ns().
  * 
  * @param tb Pointer to the bucket.
  * @param tokens Number of tokens to consume.
@@ -41,6 +68,49 @@ void ttak_token_bucket_init(ttak_token_bucket_t *tb, double rate, double burst);
  */
 bool ttak_token_bucket_consume(ttak_token_bucket_t *tb, double tokens);
 
+/**
+ * @brief Takes @p nanotokens if the bucket holds that many at @p now_ns.
+ *
+ * @return true if they were taken; the bucket is untouched otherwise.
+ */
+bool ttak_token_bucket_take(ttak_token_bucket_t *tb, uint64_t nanotokens, uint64_t now_ns);
+
+/**
+ * @brief Returns unused @p nanotokens to the bucket, capped at its capacity.
+ */
+void ttak_token_bucket_give(ttak_token_bucket_t *tb, uint64_t nanotokens);
+
+/**
+ * @brief Nanotokens available at @p now_ns.
+ */
+uint64_t ttak_token_bucket_available(ttak_token_bucket_t *tb, uint64_t now_ns);
+
+#if defined(TTAK_INLINE_FASTPATHS)
+#include <ttak/timing/timing.h>
+#include <ttak/types/ttak_compiler.h>
+
+/**
+ * @brief Inline ttak_token_bucket_consume(): when the coarse clock has not
+ *        moved past the last refill, the take is one CAS here; a refill is
+ *        left to the library.
+ */
+TTAK_FORCE_INLINE bool ttak_token_bucket_consume_inline(ttak_token_bucket_t *tb, double tokens) {
+    uint64_t need = ttak_tokens_to_nanotokens(tokens);
+    uint64_t now = ttak_get_tick_count_coarse_ns();
+    if (TTAK_UNLIKELY(now > atomic_load_explicit(&tb->last_ns, memory_order_relaxed))) {
+        return ttak_token_bucket_take(tb, need, now);
+    }
+    uint64_t cur = atomic_load_explicit(&tb->tokens, memory_order_relaxed);
+    do {
+        if (cur < need) return false;
+    } while (!atomic_compare_exchange_weak_explicit(&tb->tokens, &cur, cur - need,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    return true;
+}
+
+#define ttak_token_bucket_consume(tb, tokens) ttak_token_bucket_consume_inline((tb), (tokens))
+#endif
+
 /**
  * @brief Rate Limiter structure (wrapper around Token Bucket).
  * 
@@ -75,4 +145,132 @@ static inline bool ttak_ratelimit_allow(ttak_ratelimit_t *rl) {
     return ttak_token_bucket_consume(&rl->bucket, 1.0);
 }
 
+/**
+ * @brief Generic Cell Rate Algorithm limiter.
+ *
+ * Equivalent to a token bucket but keeps a single word of state, the
+ * theoretical arrival time (TAT) of the next conforming request, so a
+ * check is one load and one CAS and refill needs no bookkeeping. A request
+ * conforms while it leaves the TAT no more than @c limit_ns ahead of now.
+ */
+typedef struct ttak_gcra {
+    _Atomic uint64_t tat;   /**< Theoretical arrival time, in ns. */
+    uint64_t interval_ns;   /**< Emission interval: 1 / rate. */
+    uint64_t limit_ns;      /**< How far ahead the TAT may run: burst * interval. */
+} ttak_gcra_t;
+
+typedef ttak_gcra_t tt_gcra_t;
+
+/**
+ * @brief Initializes a GCRA limiter that starts with its full burst.
+ *
+ * @param rate Allowed rate in requests per second.
+ * @param burst Requests that may arrive back to back.
+ */
+void ttak_gcra_init(ttak_gcra_t *g, double rate, double burst);
+
+/**
+ * @brief Admits @p n requests at @p now_ns if they conform.
+ *
+ * @return 0 if admitted; otherwise nanoseconds until they would conform.
+ */
+uint64_t ttak_gcra_check(ttak_gcra_t *g, uint64_t n, uint64_t now_ns);
+
+/**
+ * @brief Admits one request at @p now_ns if it conforms.
+ */
+static inline bool ttak_gcra_allow(ttak_gcra_t *g, uint64_t now_ns) {
+    return ttak_gcra_check(g, 1, now_ns) == 0;
+}
+
+/**
+ * @brief A tenant's bucket in a tenant limiter.
+ */
+typedef struct ttak_tenant_entry {
+    _Alignas(64) _Atomic uint64_t tag;  /**< Tenant id + 1; 0 for a free slot. */
+    ttak_token_bucket_t bucket;
+} ttak_tenant_entry_t;
+
+/**
+ * @brief Tokens one lease shard has drawn ahead for a tenant.
+ */
+typedef struct ttak_tenant_lease {
+    _Atomic uint64_t tag;       /**< Tenant id + 1; 0 for a free slot. */
+    _Atomic uint64_t tokens;    /**< Nanotokens drawn and not yet spent. */
+    _Atomic uint64_t stamp_ns;  /**< When the last draw was made. */
+} ttak_tenant_lease_t;
+
+/**
+ * @brief Per-tenant rate limiter keyed by tenant id.
+ *
+ * Tenants hash into a fixed open-addressed table of token buckets, claimed
+ * by CAS on first use. Checks do not hit the tenant's bucket each time:
+ * each thread is bound to one of TTAK_RATELIMIT_SHARDS lease shards, which
+ * draws up to @c lease_nt extra nanotokens per trip to the bucket and
+ * spends them locally. Leases reconcile with the bucket so idle tokens do
+ * not strand: a lease older than @c reconcile_ns goes back to the bucket
+ * instead of being spent, and a check the bucket cannot cover first
+ * reclaims the tenant's leases in other shards. Admission therefore never
+ * exceeds the configured rate plus one burst; leases can only delay
+ * tokens by up to @c reconcile_ns. Tenants beyond the table's capacity
+ * share @c overflow.
+ */
+typedef struct ttak_tenant_limiter {
+    uint64_t seed;              /**< Hash seed for tenant ids. */
+    size_t mask;                /**< Table slots - 1. */
+    size_t max_tenants;         /**< Tenants given a bucket of their own. */
+    _Atomic size_t tenants;     /**< Tenants claimed so far. */
+    uint64_t lease_nt;          /**< Extra nanotokens drawn per trip; 0 disables leasing. */
+    uint64_t reconcile_ns;      /**< Age after which a lease is returned unspent. */
+    ttak_tenant_entry_t *entries;
+    ttak_tenant_lease_t *leases[TTAK_RATELIMIT_SHARDS];
+    ttak_token_bucket_t overflow;
+} ttak_tenant_limiter_t;
+
+typedef ttak_tenant_limiter_t tt_tenant_limiter_t;
+
+/**
+ * @brief Creates a limiter giving each tenant @p rate tokens/s and @p burst.
+ *
+ * @param max_tenants Tenants that get a bucket of their own.
+ * @param lease Tokens a shard draws ahead per trip to a bucket; 0 makes
+ *              every check go to the bucket.
+ * @param reconcile_ns Lease lifetime; 0 selects 10 ms.
+ * @param now_ns Current time.
+ * @return The limiter, or NULL on allocation failure.
+ */
+ttak_tenant_limiter_t *ttak_tenant_limiter_create(size_t max_tenants, double rate, double burst,
+                                                  double lease, uint64_t reconcile_ns,
+                                                  uint64_t now_ns);
+
+/**
+ * @brief Destroys a tenant limiter.
+ */
+void ttak_tenant_limiter_destroy(ttak_tenant_limiter_t *lim);
+
+/**
+ * @brief Consumes @p tokens of @p tenant's budget at @p now_ns.
+ *
+ * @param tenant Any id except UINT64_MAX.
+ * @return true if admitted.
+ */
+bool ttak_tenant_limiter_consume(ttak_tenant_limiter_t *lim, uint64_t tenant, double tokens,
+                                 uint64_t now_ns);
+
+/**
+ * @brief Admits one request from @p tenant at @p now_ns if within budget.
+ */
+static inline bool ttak_tenant_limiter_allow(ttak_tenant_limiter_t *lim, uint64_t tenant,
+                                             uint64_t now_ns) {
+    return ttak_tenant_limiter_consume(lim, tenant, 1.0, now_ns);
+}
+
+/**
+ * @brief Returns leases older than the reconcile window to their buckets.
+ *
+ * Checks already do this lazily; calling it periodically, e.g. from a
+ * timer, also settles tenants that have gone quiet.
+ */
+void ttak_tenant_limiter_reconcile(ttak_tenant_limiter_t *lim, uint64_t now_ns);
+
 #endif // TTAK_LIMIT_LIMIT_H
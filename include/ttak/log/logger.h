@@ -2,6 +2,12 @@
 #define TTAK_LOG_LOGGER_H
 
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/limit/limit.h>
 
 /**
  * @brief Log levels.
@@ -21,6 +27,33 @@ typedef enum {
  */
 typedef void (*ttak_log_func_t)(ttak_log_level_t level, const char *msg);
 
+/**
+ * @brief What a deferred log call does when its thread's ring is full.
+ */
+typedef enum {
+    TTAK_LOG_OVERFLOW_DROP,     /**< Discard the record and count it. */
+    TTAK_LOG_OVERFLOW_BLOCK     /**< Wait until the writer frees room. */
+} ttak_log_overflow_t;
+
+/** Per-thread ring size used when the configuration gives 0. */
+#define TTAK_LOG_ASYNC_DEFAULT_RING (64U * 1024U)
+
+/** Writer wake-up interval used when the configuration gives 0. */
+#define TTAK_LOG_ASYNC_DEFAULT_INTERVAL_MS 5U
+
+/**
+ * @brief Settings for ttak_logger_start_async(); zero fields pick defaults.
+ */
+typedef struct ttak_logger_async_config {
+    size_t ring_bytes;              /**< Ring per logging thread, rounded up to a power of two. */
+    ttak_log_overflow_t overflow;
+    int fd;                         /**< Target of batched writes with the default handler; 0 means stderr. */
+    uint32_t interval_ms;           /**< Longest a record waits before the writer wakes up. */
+    bool binary;                    /**< Write the binary format to @c fd instead of text lines. */
+} ttak_logger_async_config_t;
+
+struct ttak_logger_async;
+
 /**
  * @brief Logger structure.
  * 
@@ -30,6 +63,7 @@ typedef struct ttak_logger {
     ttak_log_level_t min_level; /**< Minimum severity to log. */
     ttak_log_func_t log_func;   /**< Callback function for processing logs. */
     void (*should_trace)(int enable); /**< Toggle memory tracing for all objects. */
+    struct ttak_logger_async *async; /**< Deferred-mode state, NULL while logging synchronously. */
 } ttak_logger_t;
 
 typedef ttak_logger_t tt_logger_t;
@@ -58,4 +92,168 @@ void ttak_logger_init(ttak_logger_t *l, ttak_log_func_t func, ttak_log_level_t l
  */
 void ttak_logger_log(ttak_logger_t *l, ttak_log_level_t level, const char *fmt, ...);
 
+/**
+ * @brief Static descriptor of one TTAK_LOG_BIN() call site.
+ *
+ * Built by the macro at compile time; the id and argument kinds are filled
+ * in on first use.
+ */
+typedef struct ttak_log_site {
+    const char *fmt;
+    const char *file;
+    uint32_t line;
+    ttak_log_level_t level;
+    _Atomic uint32_t id;            /**< Dictionary id, unique in the process. */
+    _Atomic uint64_t stream;        /**< Binary stream that last received the definition. */
+    _Atomic uint8_t state;          /**< 0 new, 1 ready, 2 not encodable, 3 being prepared. */
+    uint8_t nsig;
+    uint8_t sig[16];                /**< Kind of each argument @c fmt consumes. */
+} ttak_log_site_t;
+
+/**
+ * @brief One message recovered by ttak_logger_bin_decode().
+ */
+typedef struct ttak_log_bin_entry {
+    ttak_log_level_t level;
+    uint64_t timestamp_ns;          /**< CLOCK_REALTIME when logged (when written, for plain messages). */
+    const char *file;               /**< Source file of the call site; NULL for plain messages. */
+    uint32_t line;
+    const char *msg;                /**< Formatted text. */
+} ttak_log_bin_entry_t;
+
+typedef void (*ttak_log_bin_cb)(const ttak_log_bin_entry_t *entry, void *user);
+
+/** @cond internal */
+#define TTAK_LOG_BIN_FMT_(fmt, ...) "" fmt
+/** @endcond */
+
+/**
+ * @brief Logs through a call site registered at compile time.
+ *
+ * The format must be a string literal. In binary mode (see
+ * ttak_logger_async_config_t::binary) the record is the site id, a
+ * timestamp and the packed arguments; the format text is written once per
+ * stream as a dictionary entry. In every other mode it behaves like
+ * ttak_logger_log() with the site's level.
+ */
+#define TTAK_LOG_BIN(logger, lvl, ...)                                              \
+    do {                                                                            \
+        static ttak_log_site_t ttak_log_site_ = {                                   \
+            .fmt = TTAK_LOG_BIN_FMT_(__VA_ARGS__, ""),                              \
+            .file = __FILE__,                                                       \
+            .line = __LINE__,                                                       \
+            .level = (lvl),                                                         \
+        };                                                                          \
+        ttak_logger_log_site((logger), &ttak_log_site_, __VA_ARGS__);               \
+    } while (0)
+
+/** Default interval between suppression summaries of a limited call site. */
+#define TTAK_LOG_LIMIT_REPORT_NS 5000000000ULL
+
+/**
+ * @brief Rate limit and sampling state of one call site.
+ *
+ * Declared static at the call site with TTAK_LOG_LIMIT_INIT(); the
+ * bucket is set up on first use.
+ */
+typedef struct ttak_log_limit {
+    double rate;                    /**< Messages per second; 0 disables the rate limit. */
+    double burst;                   /**< Messages allowed back to back. */
+    uint32_t sample;                /**< Pass one call in @c sample; 0 or 1 passes all. */
+    uint64_t report_ns;             /**< Summary interval; 0 means TTAK_LOG_LIMIT_REPORT_NS. */
+    _Atomic uint8_t state;          /**< 0 new, 1 being set up, 2 ready. */
+    ttak_ratelimit_t rl;
+    _Atomic uint64_t calls;
+    _Atomic uint64_t suppressed;    /**< Calls held back since the last summary. */
+    _Atomic uint64_t next_report_ns;
+} ttak_log_limit_t;
+
+typedef ttak_log_limit_t tt_log_limit_t;
+
+/** Static initializer for a ttak_log_limit_t. */
+#define TTAK_LOG_LIMIT_INIT(rate_, burst_, sample_) \
+    { .rate = (rate_), .burst = (burst_), .sample = (sample_) }
+
+/**
+ * @brief Decides whether a limited call site may log, before anything is formatted.
+ *
+ * Calls below the logger's level are rejected without being counted.
+ * Others are sampled, then charged against the site's bucket. At most
+ * once per @c report_ns, a call that finds messages held
+ * back logs a summary naming @p file and @p line and the count; a
+ * quiet site reports its remainder on its next call.
+ *
+ * @param l Logger for the level check and the summary; NULL means the
+ *          default stderr handler with no level filter.
+ * @return True if the caller should log its message.
+ */
+bool ttak_logger_limit_pass(ttak_logger_t *l, ttak_log_limit_t *lim, ttak_log_level_t level,
+                            const char *file, uint32_t line);
+
+/**
+ * @brief ttak_logger_log() limited to @p rate per second with bursts of
+ *        @p burst, passing one call in @p sample.
+ *
+ * The arguments are not evaluated for suppressed calls.
+ */
+#define TTAK_LOG_LIMITED(logger, lvl, rate, burst, sample, ...)                             \
+    do {                                                                                    \
+        static ttak_log_limit_t ttak_log_limit_ = TTAK_LOG_LIMIT_INIT(rate, burst, sample); \
+        if (ttak_logger_limit_pass((logger), &ttak_log_limit_, (lvl), __FILE__, __LINE__)) {\
+            ttak_logger_log((logger), (lvl), __VA_ARGS__);                                  \
+        }                                                                                   \
+    } while (0)
+
+/**
+ * @brief Moves formatting and output off the logging threads.
+ *
+ * Each thread then appends its records to a private lock-free ring: the
+ * format pointer plus the raw arguments, with %s strings copied. A
+ * background writer formats them and hands them to the handler, or, with
+ * the default handler, writes them to @c cfg->fd in batches with writev().
+ * Formats must therefore stay valid until the writer has run, which string
+ * literals do. Records from one thread keep their order.
+ *
+ * Conversions the ring cannot carry (%n, %ls, long double) are formatted
+ * on the calling thread instead.
+ *
+ * @return False if the writer could not be started; logging stays synchronous.
+ */
+bool ttak_logger_start_async(ttak_logger_t *l, const ttak_logger_async_config_t *cfg);
+
+/**
+ * @brief Waits until every record logged before the call has been written.
+ */
+void ttak_logger_flush(ttak_logger_t *l);
+
+/**
+ * @brief Writes what is queued, stops the writer and goes back to synchronous logging.
+ *
+ * No thread may be logging through @p l while this runs.
+ */
+void ttak_logger_stop_async(ttak_logger_t *l);
+
+/**
+ * @brief Records discarded under TTAK_LOG_OVERFLOW_DROP.
+ */
+uint64_t ttak_logger_dropped(const ttak_logger_t *l);
+
+/**
+ * @brief Backend of TTAK_LOG_BIN(); @p fmt repeats @c site->fmt.
+ */
+void ttak_logger_log_site(ttak_logger_t *l, ttak_log_site_t *site, const char *fmt, ...);
+
+/**
+ * @brief Decodes a binary log, e.g. a file read back offline.
+ *
+ * Streams may be concatenated; each starts with its own header and
+ * dictionary. Definitions may follow the records that use them, so each
+ * stream is scanned for its dictionary before any record is decoded.
+ *
+ * @param records Receives the messages passed to @p cb; may be NULL.
+ * @return False if the data is not a binary log or is cut short; the
+ *         messages before the damage have been delivered.
+ */
+bool ttak_logger_bin_decode(const void *data, size_t len, ttak_log_bin_cb cb, void *user, size_t *records);
+
 #endif // TTAK_LOG_LOGGER_H
\ No newline at end of file
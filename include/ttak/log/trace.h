@@ -0,0 +1,133 @@
+/**
+ * @file trace.h
+ * @brief Runtime-toggled event tracing with a Chrome/Perfetto JSON dumper.
+ *
+ * Tracing is always compiled in. While it is off, every trace point costs
+ * one relaxed load and a predicted branch. While it is on, an event is a
+ * timestamp and a 32-byte store into the calling thread's ring, with no
+ * lock and no shared cache line; each ring keeps the most recent
+ * TTAK_TRACE_RING_EVENTS events of its thread and overwrites older ones.
+ *
+ * The library records task submit, dequeue, steal, start and end in the
+ * thread pool, reactor readiness and I/O completions, epoch reclaim passes
+ * and lattice compactions. Applications add their own with
+ * ttak_trace_user(). ttak_trace_write_json() turns the rings into the
+ * Trace Event format that chrome://tracing and ui.perfetto.dev load, with
+ * flow arrows from each task's submit to its start.
+ */
+
+#ifndef TTAK_LOG_TRACE_H
+#define TTAK_LOG_TRACE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <ttak/types/ttak_compiler.h>
+
+/** Events kept per thread; a power of two. */
+#define TTAK_TRACE_RING_EVENTS 16384
+
+/**
+ * @brief What an event records, and the meaning of its two arguments.
+ */
+typedef enum ttak_trace_kind {
+    TTAK_TRACE_TASK_SUBMIT = 1,     /**< a0 = task, a1 = shard. */
+    TTAK_TRACE_TASK_DEQUEUE,        /**< a0 = task, a1 = ttak_trace_source_t. */
+    TTAK_TRACE_TASK_STEAL,          /**< a0 = task, a1 = ttak_trace_source_t. */
+    TTAK_TRACE_TASK_START,          /**< a0 = task. */
+    TTAK_TRACE_TASK_END,            /**< a0 = task. */
+    TTAK_TRACE_IO_READY,            /**< a0 = fd, a1 = poll revents. */
+    TTAK_TRACE_IO_COMPLETE,         /**< a0 = ttak_io_status_t, a1 = bytes. */
+    TTAK_TRACE_EPOCH_RECLAIM,       /**< a0 = batches freed, a1 = pass duration in ns. */
+    TTAK_TRACE_LATTICE_COMPACT,     /**< a0 = node reset, a1 = node stubbed. */
+    TTAK_TRACE_USER,                /**< a0 = static name string, a1 = value. */
+    TTAK_TRACE_KIND_COUNT
+} ttak_trace_kind_t;
+
+/**
+ * @brief Where a worker found a task.
+ */
+typedef enum ttak_trace_source {
+    TTAK_TRACE_SRC_EDF = 0,         /**< Deadline heap of the preferred shard. */
+    TTAK_TRACE_SRC_DEQUE,           /**< The worker's own deque. */
+    TTAK_TRACE_SRC_SHARD,           /**< Refill from the preferred shard. */
+    TTAK_TRACE_SRC_WORKER,          /**< Stolen from another worker's deque. */
+    TTAK_TRACE_SRC_REMOTE_SHARD     /**< Stolen from another shard. */
+} ttak_trace_source_t;
+
+/**
+ * @brief One recorded event.
+ */
+typedef struct ttak_trace_event {
+    uint64_t ts_ns;                 /**< ttak_get_tick_count_ns() at the event. */
+    uint64_t a0;
+    uint64_t a1;
+    uint16_t kind;                  /**< ttak_trace_kind_t. */
+    uint16_t reserved;
+    uint32_t tid;                   /**< Recording thread. */
+} ttak_trace_event_t;
+
+/** Non-zero while tracing is on; read by TTAK_TRACE(). */
+extern _Atomic uint32_t ttak_trace_active;
+
+/**
+ * @brief Records an event unconditionally. Use TTAK_TRACE() at trace points.
+ */
+void ttak_trace_emit(ttak_trace_kind_t kind, uint64_t a0, uint64_t a1);
+
+/**
+ * @brief Records an event if tracing is on.
+ */
+#define TTAK_TRACE(kind, a0, a1)                                                          \
+    do {                                                                                  \
+        if (TTAK_UNLIKELY(atomic_load_explicit(&ttak_trace_active, memory_order_relaxed))) \
+            ttak_trace_emit((kind), (uint64_t)(a0), (uint64_t)(a1));                      \
+    } while (0)
+
+/**
+ * @brief Turns tracing on. Events already recorded are kept.
+ */
+void ttak_trace_start(void);
+
+/**
+ * @brief Turns tracing off. Recorded events stay available for writing.
+ */
+void ttak_trace_stop(void);
+
+/**
+ * @brief Returns non-zero while tracing is on.
+ */
+int ttak_trace_is_enabled(void);
+
+/**
+ * @brief Discards every recorded event.
+ *
+ * Events being recorded concurrently may survive.
+ */
+void ttak_trace_reset(void);
+
+/**
+ * @brief Records an application event named by the static string @p name.
+ */
+static inline void ttak_trace_user(const char *name, uint64_t value) {
+    TTAK_TRACE(TTAK_TRACE_USER, (uintptr_t)name, value);
+}
+
+/**
+ * @brief Returns the number of events currently held in all rings.
+ */
+size_t ttak_trace_event_count(void);
+
+/**
+ * @brief Writes the recorded events as Trace Event JSON.
+ *
+ * Safe while other threads keep recording; events overwritten during the
+ * dump are skipped.
+ *
+ * @return 0 on success, -1 on a write error.
+ */
+int ttak_trace_write_json(FILE *out);
+
+#endif // TTAK_LOG_TRACE_H
@@ -13,16 +13,28 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/** Summary levels above the bitmap; enough for 2^32 bits at 64 per level. */
+#define TTAK_DYNAMIC_MASK_LEVELS 5
+
 /**
  * @struct ttak_dynamic_mask_t
  * @brief Thread-safe dynamic bitmap.
  * Optimized for lock-free reads via EBR.
+ *
+ * Above the bitmap sit summary levels with one bit per word of the level
+ * below: @c any marks words with a set bit, @c full words with every bit
+ * set. Searches descend them, so find-first and claim-first-free touch one
+ * word per level instead of scanning the bitmap. The summaries share the
+ * bitmap's allocation and are only read under the lock.
  */
 typedef struct {
     uint64_t * _Atomic bits;    /**< The actual bitmap array (Atomic for lock-free read) */
     uint32_t capacity;          /**< Capacity in bits (multiples of 64) */
     uint32_t count;             /**< Number of set bits (optional tracking) */
     ttak_rwlock_t lock;         /**< RWLock for writer synchronization */
+    uint32_t levels;                                /**< Summary levels in use; the top one is a single word. */
+    uint64_t *any[TTAK_DYNAMIC_MASK_LEVELS];        /**< Level k bit: word below is non-zero. */
+    uint64_t *full[TTAK_DYNAMIC_MASK_LEVELS];       /**< Level k bit: word below is all ones. */
 } ttak_dynamic_mask_t;
 
 /**
@@ -61,4 +73,41 @@ bool ttak_dynamic_mask_test_unsafe(ttak_dynamic_mask_t *mask, uint32_t bit_idx);
  */
 bool ttak_dynamic_mask_ensure(ttak_dynamic_mask_t *mask, uint32_t bit_idx);
 
+/**
+ * @brief Finds the lowest set bit at or above @p from.
+ * @param out Receives the bit index.
+ * @return false if no such bit is set.
+ */
+bool ttak_dynamic_mask_find_next(ttak_dynamic_mask_t *mask, uint32_t from, uint32_t *out);
+
+/**
+ * @brief Finds the lowest set bit.
+ * @return false if the mask is empty.
+ */
+bool ttak_dynamic_mask_find_first(ttak_dynamic_mask_t *mask, uint32_t *out);
+
+/**
+ * @brief Finds the lowest clear bit within the current capacity.
+ * @return false if every bit is set.
+ */
+bool ttak_dynamic_mask_find_first_free(ttak_dynamic_mask_t *mask, uint32_t *out);
+
+/**
+ * @brief Atomically finds the lowest clear bit and sets it, growing the
+ *        mask when it is full.
+ * @param out Receives the claimed index.
+ * @return false if the mask could not grow.
+ */
+bool ttak_dynamic_mask_claim_first_free(ttak_dynamic_mask_t *mask, uint32_t *out);
+
+/**
+ * @brief Counts set bits in [@p begin, @p end).
+ */
+size_t ttak_dynamic_mask_count_range(ttak_dynamic_mask_t *mask, uint32_t begin, uint32_t end);
+
+/**
+ * @brief Number of set bits.
+ */
+uint32_t ttak_dynamic_mask_count(ttak_dynamic_mask_t *mask);
+
 #endif /* TTAK_DYNAMIC_MASK_H */
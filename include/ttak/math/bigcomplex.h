@@ -26,4 +26,18 @@ void ttak_bigcomplex_free(ttak_bigcomplex_t *bc, uint64_t now);
  */
 _Bool ttak_bigcomplex_add(ttak_bigcomplex_t *dst, const ttak_bigcomplex_t *lhs, const ttak_bigcomplex_t *rhs, uint64_t now);
 
+/**
+ * @brief In-place DFT of @p n complex numbers in double precision.
+ *
+ * Components are rounded to doubles, transformed with the plan cached for
+ * @p n (see fft.h) and written back, so the result carries double accuracy
+ * whatever the inputs held. Both directions use natural order; the inverse
+ * includes the 1/n factor.
+ *
+ * Returns false if @p n is not a power of two within TTAK_FFT_MAX_LOG, a
+ * component overflows a double or memory runs out; @p v may then be
+ * partly written.
+ */
+_Bool ttak_bigcomplex_fft(ttak_bigcomplex_t *v, size_t n, _Bool inverse, uint64_t now);
+
 #endif // TTAK_MATH_BIGCOMPLEX_H
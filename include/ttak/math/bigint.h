@@ -8,12 +8,39 @@
 #include <ttak/types/ttak_align.h>
 #include <ttak/types/fixed.h>
 
+/**
+ * @brief Width of a limb in bits.
+ *
+ * 64 where the compiler has a 128-bit integer type for the double-width
+ * products (x86-64, AArch64 and other 64-bit GCC/Clang targets), 32
+ * elsewhere. Define it to 32 to force narrow limbs; the GPU backends
+ * require them.
+ */
+#ifndef TTAK_BIGINT_LIMB_BITS
+#  if defined(__SIZEOF_INT128__) && !defined(__TINYC__)
+#    define TTAK_BIGINT_LIMB_BITS 64
+#  else
+#    define TTAK_BIGINT_LIMB_BITS 32
+#  endif
+#endif
+
+#if TTAK_BIGINT_LIMB_BITS == 64
+typedef uint64_t limb_t;
+#elif TTAK_BIGINT_LIMB_BITS == 32
 /**
  * @brief Platform-optimized word type for Raspberry Pi (ARMv7/v8).
  */
 typedef uint32_t limb_t;
+#else
+#  error "TTAK_BIGINT_LIMB_BITS must be 32 or 64"
+#endif
+
+#define TTAK_BIGINT_SSO_LIMIT 4 // 4 limbs: 128 or 256 bits
 
-#define TTAK_BIGINT_SSO_LIMIT 4 // 4 * 32-bit = 128-bit
+/* Largest per-thread scratch arena kept between operations, in limbs. */
+#ifndef TTAK_BIGINT_SCRATCH_RETAIN_LIMBS
+#define TTAK_BIGINT_SCRATCH_RETAIN_LIMBS 65536
+#endif
 
 /**
  * @brief Arbitrary-precision integer engine with Small Stack Optimization (SSO).
@@ -62,15 +89,27 @@ bool ttak_bigint_set_u128(ttak_bigint_t *bi, ttak_u128_t value, uint64_t now);
 bool ttak_bigint_set_u256(ttak_bigint_t *bi, ttak_u256_t value, uint64_t now);
 bool ttak_bigint_copy(ttak_bigint_t *dst, const ttak_bigint_t *src, uint64_t now);
 
+/**
+ * @brief Assigns the non-negative value held in @p count limbs, least significant first.
+ *
+ * @return true on success, false on allocation failure.
+ */
+bool ttak_bigint_set_limbs(ttak_bigint_t *bi, const limb_t *limbs, size_t count, uint64_t now);
+
+/**
+ * @brief Read-only view of the magnitude; bi->used limbs, least significant first.
+ */
+const limb_t *ttak_bigint_limbs(const ttak_bigint_t *bi);
+
 int ttak_bigint_cmp(const ttak_bigint_t *lhs, const ttak_bigint_t *rhs);
 int ttak_bigint_cmp_u64(const ttak_bigint_t *lhs, uint64_t rhs);
 bool ttak_bigint_is_zero(const ttak_bigint_t *bi);
 limb_t sub_limbs(limb_t *u, const limb_t *v, size_t n);
 
 /**
- * @brief Adds two non-negative bigints: dst = lhs + rhs.
+ * @brief Adds two signed bigints: dst = lhs + rhs.
  *
- * The destination must be initialized. Sign handling is limited to positive inputs.
+ * The destination must be initialized and may alias either operand.
  *
  * @return true on success, false on allocation failure.
  */
@@ -94,5 +133,14 @@ void ttak_bigint_to_hex_hash(const ttak_bigint_t *bi, char out[65]);
 void ttak_bigint_format_prefix(const ttak_bigint_t *bi, char *dest, size_t dest_cap);
 void ttak_bigint_hash(const ttak_bigint_t *bi, uint8_t out[32]);
 
+/**
+ * @brief Frees the calling thread's scratch arena.
+ *
+ * Multiplication and division into an operand, and division with aliased
+ * outputs, stage limbs in a per-thread arena that is reused across calls.
+ * Threads that are about to exit call this to return it.
+ */
+void ttak_bigint_scratch_release(void);
+
 
 #endif // TTAK_MATH_BIGINT_H
@@ -14,6 +14,19 @@ extern "C" {
 #  define ATOMIC_VAR_INIT(x) (x)
 #endif
 
+/* Operand sizes, in limbs, that ttak_bigint_accel_calibrate() tries, doubling from the minimum. */
+#ifndef TTAK_BIGINT_ACCEL_CALIBRATE_MIN_LIMBS
+#define TTAK_BIGINT_ACCEL_CALIBRATE_MIN_LIMBS 32
+#endif
+#ifndef TTAK_BIGINT_ACCEL_CALIBRATE_MAX_LIMBS
+#define TTAK_BIGINT_ACCEL_CALIBRATE_MAX_LIMBS 8192
+#endif
+
+/* Runs per size and side; the fastest one counts. */
+#ifndef TTAK_BIGINT_ACCEL_CALIBRATE_REPS
+#define TTAK_BIGINT_ACCEL_CALIBRATE_REPS 3
+#endif
+
 /**
  * @brief Returns true when a GPU backend capable of BigInt operations is available.
  */
@@ -21,9 +34,38 @@ bool ttak_bigint_accel_available(void);
 
 /**
  * @brief Returns the minimum operand limb count required before acceleration is attempted.
+ *
+ * TTAK_BIGINT_ACCEL_THRESHOLD wins when set; otherwise the value stored by
+ * the last ttak_bigint_accel_calibrate() on this host is used, and 256
+ * without one.
  */
 size_t ttak_bigint_accel_min_limbs(void);
 
+/**
+ * @brief Measures where device multiplication starts beating the CPU.
+ *
+ * Times balanced CPU and device products over the calibration sizes, then
+ * stores the resulting threshold in the accelerator cache and applies it
+ * (unless TTAK_BIGINT_ACCEL_THRESHOLD overrides it). Takes up to a few
+ * seconds, so run it once after install or from a setup step rather than on
+ * every start; later processes load the stored value.
+ *
+ * @return The new threshold, SIZE_MAX when the device never won, or 0 when
+ *         no backend is available or a device multiply failed.
+ */
+size_t ttak_bigint_accel_calibrate(uint64_t now);
+
+/**
+ * @brief Creates the device contexts, kernels and buffer pools up front.
+ *
+ * Call once at startup so the first offloaded operation does not pay for
+ * context creation or an OpenCL program build. Backends that fail here are
+ * disabled, exactly as after a failed operation.
+ *
+ * @return ttak_bigint_accel_available() after the warm-up.
+ */
+bool ttak_bigint_accel_warmup(void);
+
 /**
  * @brief Performs limb-wise addition via an accelerator backend.
  *
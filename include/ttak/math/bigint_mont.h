@@ -0,0 +1,171 @@
+/**
+ * @file bigint_mont.h
+ * @brief Modular multiplication and exponentiation with a fixed modulus.
+ *
+ * A context precomputes what reduction by one modulus needs so that the
+ * products of a modular loop never run a long division. Odd moduli use
+ * Montgomery form (R = 2^(k * TTAK_BIGINT_LIMB_BITS) for a k-limb modulus,
+ * with R^2 mod n and -n^-1 mod 2^TTAK_BIGINT_LIMB_BITS cached); even moduli
+ * fall back to Barrett reduction with floor(2^(2k * TTAK_BIGINT_LIMB_BITS) / n).
+ * Both share the API below, so callers need not care which one runs.
+ *
+ * Values passed to ttak_bigint_mont_mul() are in the context's internal
+ * form; ttak_bigint_mont_to() and ttak_bigint_mont_from() convert. The
+ * exponentiation and ttak_bigint_mulmod() helpers take and return plain
+ * values.
+ *
+ * Contexts and comb tables are read-only once built and may be shared
+ * between threads. Scratch for moduli up to TTAK_BIGINT_MONT_STACK_LIMBS
+ * limbs lives on the stack, so those products never touch the heap.
+ */
+
+#ifndef TTAK_MATH_BIGINT_MONT_H
+#define TTAK_MATH_BIGINT_MONT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/math/bigint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Moduli up to this many limbs keep product scratch on the stack. */
+#ifndef TTAK_BIGINT_MONT_STACK_LIMBS
+#define TTAK_BIGINT_MONT_STACK_LIMBS 32
+#endif
+
+/**
+ * @brief Reduction state for one modulus.
+ */
+typedef struct ttak_bigint_mont_ctx {
+    limb_t *n;       /**< Modulus, k limbs. */
+    limb_t *r2;      /**< R^2 mod n (Montgomery only). */
+    limb_t *one;     /**< 1 in internal form. */
+    limb_t *mu;      /**< floor(B^2k / n), k + 1 limbs (Barrett only). */
+    limb_t n_inv;    /**< -n^-1 mod B (Montgomery only). */
+    size_t k;        /**< Limbs in the modulus. */
+    bool barrett;    /**< true for even moduli. */
+} ttak_bigint_mont_ctx_t;
+
+typedef ttak_bigint_mont_ctx_t tt_bigint_mont_ctx_t;
+
+/**
+ * @brief Fixed-base comb table (Lim-Lee) for repeated powers of one base.
+ *
+ * Entry i holds the product of base^(2^(j * spacing)) over the set bits j
+ * of i, so an exponent of up to max_bits bits costs spacing squarings and
+ * at most spacing multiplications.
+ */
+typedef struct ttak_bigint_mont_comb {
+    const ttak_bigint_mont_ctx_t *ctx; /**< Context the table was built for. */
+    limb_t *table;                     /**< 2^teeth entries of k limbs, internal form. */
+    size_t teeth;                      /**< Bits of the exponent read per column. */
+    size_t spacing;                    /**< Columns, ceil(max_bits / teeth). */
+    size_t max_bits;                   /**< Longest exponent the table covers. */
+} ttak_bigint_mont_comb_t;
+
+typedef ttak_bigint_mont_comb_t tt_bigint_mont_comb_t;
+
+/**
+ * @brief Prepares a context for the positive modulus @p n, which must exceed 1.
+ * @return false for an unsupported modulus or on allocation failure.
+ */
+bool ttak_bigint_mont_init(ttak_bigint_mont_ctx_t *ctx, const ttak_bigint_t *n, uint64_t now);
+
+/**
+ * @brief Releases the limbs owned by @p ctx.
+ */
+void ttak_bigint_mont_free(ttak_bigint_mont_ctx_t *ctx);
+
+/**
+ * @brief dst = a mod n in internal form. @p a may be negative or exceed n.
+ */
+bool ttak_bigint_mont_to(const ttak_bigint_mont_ctx_t *ctx, ttak_bigint_t *dst, const ttak_bigint_t *a,
+                         uint64_t now);
+
+/**
+ * @brief dst = plain value of the internal-form @p a.
+ */
+bool ttak_bigint_mont_from(const ttak_bigint_mont_ctx_t *ctx, ttak_bigint_t *dst, const ttak_bigint_t *a,
+                           uint64_t now);
+
+/**
+ * @brief dst = a * b in internal form; both operands must be reduced values
+ * produced by this context. @p dst may alias either operand.
+ */
+bool ttak_bigint_mont_mul(const ttak_bigint_mont_ctx_t *ctx, ttak_bigint_t *dst, const ttak_bigint_t *a,
+                          const ttak_bigint_t *b, uint64_t now);
+
+/**
+ * @brief dst = base^exp mod n by a sliding window over @p exp.
+ *
+ * @p base is a plain value; @p exp must be non-negative.
+ */
+bool ttak_bigint_mont_powmod(const ttak_bigint_mont_ctx_t *ctx, ttak_bigint_t *dst, const ttak_bigint_t *base,
+                             const ttak_bigint_t *exp, uint64_t now);
+
+/**
+ * @brief Builds a comb table of @p base for exponents up to @p max_bits bits.
+ */
+bool ttak_bigint_mont_comb_init(ttak_bigint_mont_comb_t *comb, const ttak_bigint_mont_ctx_t *ctx,
+                                const ttak_bigint_t *base, size_t max_bits, uint64_t now);
+
+/**
+ * @brief Releases the table of @p comb.
+ */
+void ttak_bigint_mont_comb_free(ttak_bigint_mont_comb_t *comb);
+
+/**
+ * @brief dst = base^exp mod n from a comb table.
+ *
+ * Exponents longer than the table's max_bits take the sliding window path.
+ */
+bool ttak_bigint_mont_comb_powmod(const ttak_bigint_mont_comb_t *comb, ttak_bigint_t *dst,
+                                  const ttak_bigint_t *exp, uint64_t now);
+
+/*
+ * Limb-level entry points for inner loops that keep their residues as
+ * k-limb arrays (k = ctx->k) instead of ttak_bigint_t. Products take
+ * TTAK_BIGINT_MONT_WORK_LIMBS(k) limbs of scratch in @p tp; destinations
+ * may alias the operands but not @p tp.
+ */
+
+/** @brief Scratch limbs ttak_bigint_mont_mul_n() needs for a k-limb modulus. */
+#define TTAK_BIGINT_MONT_WORK_LIMBS(k) (6 * (k) + 3)
+
+/** @brief rp = ap * bp in internal form. */
+bool ttak_bigint_mont_mul_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, const limb_t *bp,
+                            limb_t *tp, uint64_t now);
+
+/** @brief rp = ap + bp mod n. */
+void ttak_bigint_mont_add_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, const limb_t *bp);
+
+/** @brief rp = ap - bp mod n. */
+void ttak_bigint_mont_sub_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, const limb_t *bp);
+
+/** @brief rp = a mod n in internal form. */
+bool ttak_bigint_mont_to_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const ttak_bigint_t *a, limb_t *tp,
+                           uint64_t now);
+
+/** @brief rp = plain value of the internal-form @p ap. */
+void ttak_bigint_mont_from_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, limb_t *tp);
+
+/**
+ * @brief dst = a * b mod n without a caller-held context.
+ */
+bool ttak_bigint_mulmod(ttak_bigint_t *dst, const ttak_bigint_t *a, const ttak_bigint_t *b,
+                        const ttak_bigint_t *n, uint64_t now);
+
+/**
+ * @brief dst = base^exp mod n without a caller-held context.
+ */
+bool ttak_bigint_powmod(ttak_bigint_t *dst, const ttak_bigint_t *base, const ttak_bigint_t *exp,
+                        const ttak_bigint_t *n, uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_MATH_BIGINT_MONT_H */
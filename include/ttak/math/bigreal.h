@@ -44,4 +44,22 @@ _Bool ttak_bigreal_div(ttak_bigreal_t *dst, const ttak_bigreal_t *lhs, const tta
 
 int ttak_bigreal_cmp(const ttak_bigreal_t *lhs, const ttak_bigreal_t *rhs, uint64_t now);
 
+/**
+ * @brief Nearest double to @p br.
+ *
+ * @return false when the value overflows a double; @p out then holds +-inf.
+ */
+_Bool ttak_bigreal_to_double(const ttak_bigreal_t *br, double *out);
+
+/**
+ * @brief Sets @p br to the finite double @p value.
+ *
+ * Integral values below 2^64 convert exactly. Others keep 17 significant
+ * decimal digits, which round-trip through ttak_bigreal_to_double(), with
+ * trailing zeros dropped so the exponents stay close for ttak_bigreal_align().
+ *
+ * @return false if @p value is NaN or infinite.
+ */
+_Bool ttak_bigreal_set_double(ttak_bigreal_t *br, double value, uint64_t now);
+
 #endif // TTAK_MATH_BIGREAL_H
@@ -14,6 +14,15 @@
  */
 typedef _Bool (*ttak_math_func_t)(ttak_bigreal_t *res, const ttak_bigreal_t *x, void *ctx, uint64_t now);
 
+/**
+ * @brief Batch integrand for the double engine: y[i] = f(x[i]) for i < n.
+ *
+ * Called with every node of one or two Gauss-Kronrod rules at once (15 or
+ * 30 points), so an implementation can evaluate them with SIMD.
+ * @return false to abort the integration.
+ */
+typedef _Bool (*ttak_math_batch_func_t)(double *y, const double *x, size_t n, void *ctx);
+
 /**
  * @brief Numerical differentiation at point x.
  */
@@ -25,11 +34,75 @@ _Bool ttak_calculus_diff(ttak_bigreal_t *res, ttak_math_func_t f, const ttak_big
 _Bool ttak_calculus_partial_diff(ttak_bigreal_t *res, ttak_math_func_t f, const ttak_bigreal_t *x_vec, uint8_t dim, void *ctx, uint64_t now);
 
 /**
- * @brief Numerical definite integration over [a, b].
- * Uses adaptive methods and can be parallelized.
+ * @brief Numerical definite integration over [a, b] in bigreal arithmetic.
+ *
+ * Composite Simpson over four panels evaluated on the async pool. Slow but
+ * carries the integrand's own precision; ttak_calculus_integrate_f64() is
+ * the adaptive double-precision path.
  */
 _Bool ttak_calculus_integrate(ttak_bigreal_t *res, ttak_math_func_t f, const ttak_bigreal_t *a, const ttak_bigreal_t *b, void *ctx, uint64_t now);
 
+/** @brief Subinterval budget of ttak_calculus_integrate_f64() unless the options set one. */
+#define TTAK_CALCULUS_QUAD_DEFAULT_MAX_INTERVALS 8192
+
+/** @brief Deepest bisection of the initial interval. */
+#define TTAK_CALCULUS_QUAD_MAX_DEPTH 60
+
+/** @brief Most threads, caller included, one integration runs on. */
+#define TTAK_CALCULUS_QUAD_MAX_SLOTS 64
+
+struct ttak_thread_pool;
+
+/**
+ * @brief Tolerances and resources for ttak_calculus_integrate_f64().
+ */
+typedef struct ttak_calculus_quad_options {
+    double abs_tol;                /**< Absolute error target. */
+    double rel_tol;                /**< Error target relative to the first estimate of the integral. */
+    size_t max_intervals;          /**< Subinterval budget; 0 selects the default. */
+    struct ttak_thread_pool *pool; /**< Pool to spread over; NULL runs on the caller. */
+    uint64_t now;                  /**< Timestamp handed to the pool. */
+} ttak_calculus_quad_options_t;
+
+/**
+ * @brief Outcome of ttak_calculus_integrate_f64().
+ */
+typedef struct ttak_calculus_quad_result {
+    double value;       /**< Integral estimate. */
+    double error;       /**< Sum of the accepted subintervals' error estimates. */
+    size_t intervals;   /**< Subintervals accepted. */
+    size_t evaluations; /**< Integrand points evaluated. */
+    _Bool converged;    /**< Every subinterval met its share of the tolerance. */
+} ttak_calculus_quad_result_t;
+
+/**
+ * @brief Fills @p options with abs_tol 1e-12, rel_tol 1e-10, the default
+ * budget and the shared pool from ttak_async_pool().
+ */
+void ttak_calculus_quad_options_init(ttak_calculus_quad_options_t *options);
+
+/**
+ * @brief Adaptive Gauss-Kronrod (G7/K15) integration over [a, b] in doubles.
+ *
+ * A subinterval is accepted once its error estimate is within its share,
+ * by width, of max(abs_tol, rel_tol * |I|); otherwise it is bisected and
+ * both halves are evaluated in one 30-point batch call. Subintervals are
+ * tasks in per-thread work-stealing deques: each thread refines its own
+ * depth first while idle ones steal the oldest, so irregular integrands
+ * balance themselves. The caller takes part and finishes alone if the
+ * pool never schedules a helper, so nested use from a pool task is safe.
+ *
+ * Running out of budget or depth still yields an estimate, with
+ * converged false. The last bits of the value may vary between parallel
+ * runs because the subintervals are summed per thread.
+ *
+ * @param options NULL for the defaults.
+ * @return false on invalid arguments, allocation failure, an integrand
+ *         that returns false or a non-finite integrand value.
+ */
+_Bool ttak_calculus_integrate_f64(ttak_calculus_quad_result_t *out, ttak_math_batch_func_t f, double a, double b,
+                                  const ttak_calculus_quad_options_t *options, void *ctx);
+
 /**
  * @brief RK4 (Runge-Kutta 4th Order) ODE solver step.
  * Solves dy/dt = f(t, y)
@@ -2,6 +2,8 @@
 #define TTAK_MATH_FACTOR_H
 
 #include <ttak/math/bigint.h>
+#include <ttak/thread/pool.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
@@ -28,13 +30,72 @@ typedef struct {
  */
 int ttak_factor_u64(uint64_t n, ttak_prime_factor_t **factors_out, size_t *count_out, uint64_t now);
 
+/**
+ * @brief Bounds of one ECM run.
+ */
+typedef struct ttak_factor_ecm_params {
+    uint64_t b1;     /**< Stage 1 bound. */
+    uint64_t b2;     /**< Stage 2 bound; 0 selects 100 * b1. */
+    size_t   curves; /**< Curves to try before giving up. */
+    uint64_t seed;   /**< Start of the Suyama sigma sequence. */
+} ttak_factor_ecm_params_t;
+
+/**
+ * @brief Looks for a factor of @p n with the elliptic curve method.
+ *
+ * Each curve is a Montgomery curve from Suyama's parameterization. Stage 1
+ * runs an x-only Montgomery ladder through every prime power up to b1.
+ * Stage 2 covers primes up to b2 with baby and giant steps, normalized by
+ * batched inversions. Curves run as tasks on @p pool (NULL runs them on
+ * the caller), and the first factor found stops the rest.
+ *
+ * @param n          Odd composite above 2^64 with no factor below 1000.
+ * @param params     Bounds and curve count.
+ * @param pool       Pool to spread the curves over, or NULL.
+ * @param factor_out Receives a proper factor of @p n on success.
+ * @param now        Timestamp for allocations.
+ * @return 1 when a factor was found, 0 when none was, -1 on allocation failure.
+ */
+int ttak_factor_ecm(const ttak_bigint_t *n, const ttak_factor_ecm_params_t *params, ttak_thread_pool_t *pool,
+                    ttak_bigint_t *factor_out, uint64_t now);
+
+/* Largest input, in decimal digits, ttak_factor_siqs() has parameters for. */
+#ifndef TTAK_FACTOR_SIQS_MAX_DIGITS
+#define TTAK_FACTOR_SIQS_MAX_DIGITS 100
+#endif
+
+/**
+ * @brief Splits @p n with the self-initializing quadratic sieve.
+ *
+ * Sieves polynomials (Ax + B)^2 - kN, with the A values built from factor
+ * base primes and 2^(s-1) B values per A reached by Gray code. Relations
+ * with one large prime are paired. The sieving runs as tasks on @p pool.
+ * Dependencies come from Gaussian elimination over GF(2).
+ *
+ * @param n          Odd composite, not a perfect power, of at most
+ *                   TTAK_FACTOR_SIQS_MAX_DIGITS digits.
+ * @param pool       Pool to spread the sieving over, or NULL.
+ * @param factor_out Receives a proper factor of @p n on success.
+ * @param now        Timestamp for allocations.
+ * @return 1 when a factor was found, 0 when the dependencies all came out
+ *         trivial or @p n is out of range, -1 on allocation failure.
+ */
+int ttak_factor_siqs(const ttak_bigint_t *n, ttak_thread_pool_t *pool, ttak_bigint_t *factor_out, uint64_t now);
+
 /**
  * @brief Factorizes a big integer.
+ *
+ * Trial division strips small primes. Each remaining cofactor is then
+ * either recorded as a strong probable prime, taken apart as a perfect
+ * power, or split by ECM and, up to TTAK_FACTOR_SIQS_MAX_DIGITS digits,
+ * the quadratic sieve. ttak_async_pool() carries the parallel work.
+ *
  * @param n The bigint to factor.
  * @param factors_out A pointer to an array of big integer factors, allocated by the function.
  * @param count_out A pointer to store the number of prime factors found.
  * @param now The current timestamp for memory allocation.
- * @return 0 on success, non-zero on failure. The caller must free the allocated factors array
+ * @return 0 on success, -1 on allocation failure, -2 when a composite cofactor
+ *         could not be split. The caller must free the allocated factors array
  *         and the bigints within it.
  */
 int ttak_factor_big(const ttak_bigint_t *n, ttak_prime_factor_big_t **factors_out, size_t *count_out, uint64_t now);
@@ -0,0 +1,111 @@
+/**
+ * @file factor_cache.h
+ * @brief Bounded concurrent cache of factorisations and divisor sums.
+ *
+ * Aliquot sequences and the cross-verify tools keep meeting numbers they
+ * have already stepped through: a new seed merges into a known sequence and
+ * every later term repeats. The cache maps n to its factorisation and
+ * sigma(n), so a repeated n is answered without factoring it again.
+ *
+ * Entries are keyed by the first 64 bits of ttak_bigint_hash() and compared
+ * on the full value, so hash collisions cost a miss, never a wrong answer.
+ * The key space is split over TTAK_FACTOR_CACHE_SHARDS shards, each with its
+ * own lock, hash index and CLOCK ring; once a shard is full the hand evicts
+ * the first entry not looked up since the hand last passed it.
+ *
+ * With a store path every new entry is also appended to that file, and a
+ * later cache opened on the same path maps the file read-only and serves
+ * the entries from it, so both eviction and restarts fall back to the disk
+ * rather than the factoriser.
+ */
+
+#ifndef TTAK_MATH_FACTOR_CACHE_H
+#define TTAK_MATH_FACTOR_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/math/bigint.h>
+#include <ttak/math/factor.h>
+#include <ttak/types/fixed.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Independently locked shards per cache; a power of two. */
+#ifndef TTAK_FACTOR_CACHE_SHARDS
+#define TTAK_FACTOR_CACHE_SHARDS 16
+#endif
+
+/** @brief Opaque cache handle. */
+typedef struct ttak_factor_cache ttak_factor_cache_t;
+
+typedef ttak_factor_cache_t tt_factor_cache_t;
+
+/**
+ * @brief Counters since ttak_factor_cache_create(); exact only while no
+ *        lookup runs.
+ */
+typedef struct ttak_factor_cache_stats {
+    uint64_t hits;          /**< Answered from memory. */
+    uint64_t store_hits;    /**< Answered from the store file. */
+    uint64_t misses;        /**< Factored. */
+    uint64_t evictions;     /**< Entries the CLOCK hand dropped from memory. */
+    size_t   resident;      /**< Entries held in memory. */
+    size_t   stored;        /**< Entries in the store file. */
+} ttak_factor_cache_stats_t;
+
+/**
+ * @brief Creates a cache holding up to @p capacity entries in memory.
+ *
+ * @param store_path File backing the cache, created if missing; NULL keeps
+ *                   the cache in memory only. A file written by another
+ *                   limb width, or cut short, is truncated to its valid
+ *                   prefix.
+ * @return NULL if @p capacity is 0, memory runs out or the store cannot
+ *         be opened.
+ */
+ttak_factor_cache_t *ttak_factor_cache_create(size_t capacity, const char *store_path, uint64_t now);
+
+/** @brief Releases @p cache and closes its store. No lookup may be running. */
+void ttak_factor_cache_destroy(ttak_factor_cache_t *cache, uint64_t now);
+
+/**
+ * @brief Factorisation and sigma of @p n, factoring it only on a miss.
+ *
+ * @param factors_out Receives an array in ttak_factor_big() form, owned by
+ *                    the caller; may be NULL when only sigma is wanted.
+ * @param sigma_out   Receives sigma(n); may be NULL.
+ * @return false if @p n is below 2, factoring fails or memory runs out.
+ */
+bool ttak_factor_cache_get(ttak_factor_cache_t *cache, const ttak_bigint_t *n, ttak_prime_factor_big_t **factors_out,
+                           size_t *count_out, ttak_bigint_t *sigma_out, uint64_t now);
+
+/**
+ * @brief One aliquot step: sigma(n) - n through the cache.
+ *
+ * Matches ttak_sum_proper_divisors_big(), including 0 for n below 2 and
+ * the bit limit of ttak_sum_divisors_set_limits().
+ */
+bool ttak_factor_cache_sum_proper_divisors(ttak_factor_cache_t *cache, const ttak_bigint_t *n,
+                                           ttak_bigint_t *result_out, uint64_t now);
+
+/** @brief sigma(n) of a 64-bit @p n, which always fits 128 bits. */
+bool ttak_factor_cache_sigma_u64(ttak_factor_cache_t *cache, uint64_t n, ttak_u128_t *sigma_out, uint64_t now);
+
+/** @brief sigma(n) of a 128-bit @p n, which always fits 256 bits. */
+bool ttak_factor_cache_sigma_u128(ttak_factor_cache_t *cache, ttak_u128_t n, ttak_u256_t *sigma_out, uint64_t now);
+
+/** @brief Releases an array returned through ttak_factor_cache_get(). */
+void ttak_factor_cache_free_factors(ttak_prime_factor_big_t *factors, size_t count, uint64_t now);
+
+/** @brief Copies the counters of @p cache into @p out. */
+void ttak_factor_cache_get_stats(ttak_factor_cache_t *cache, ttak_factor_cache_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_MATH_FACTOR_CACHE_H */
@@ -0,0 +1,110 @@
+/**
+ * @file fft.h
+ * @brief Double-precision complex FFT with precomputed plans.
+ *
+ * Vectors are held split, real parts in one array and imaginary parts in
+ * another, so every butterfly lane is a plain double and the kernels load
+ * whole vectors without shuffles. Stages are fused in pairs (radix 4), with
+ * one twiddle-free radix-2 pass when log2 n is odd, and transforms longer
+ * than TTAK_FFT_BLOCK_ELEMS finish their short stages block by block.
+ *
+ * Like the NTT plans, the plan transforms skip both bit-reversal passes:
+ * forward consumes natural order and leaves the spectrum bit-reversed,
+ * inverse consumes that order and restores natural order, so a convolution
+ * is forward, pointwise, inverse with no permutation at all.
+ */
+
+#ifndef TTAK_MATH_FFT_H
+#define TTAK_MATH_FFT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Butterfly kernels a plan can run. */
+typedef enum ttak_fft_kernel {
+    TTAK_FFT_KERNEL_SCALAR = 0, /**< Portable C, one element at a time. */
+    TTAK_FFT_KERNEL_AVX2,       /**< Four lanes with FMA3. */
+    TTAK_FFT_KERNEL_AVX512,     /**< Eight lanes. */
+    TTAK_FFT_KERNEL_NEON        /**< Two lanes. */
+} ttak_fft_kernel_t;
+
+typedef ttak_fft_kernel_t tt_fft_kernel_t;
+
+/** @brief Fastest kernel the running host offers. TTAK_FFT_KERNEL=scalar forces the portable one. */
+ttak_fft_kernel_t ttak_fft_kernel_default(void);
+
+/** @brief Name of a kernel: "scalar", "avx2", "avx512" or "neon". */
+const char *ttak_fft_kernel_name(ttak_fft_kernel_t kernel);
+
+/** @brief Longest transform a plan supports, as log2 of the length. */
+#define TTAK_FFT_MAX_LOG 24U
+
+/**
+ * @brief Transforms longer than this many elements run their small stages
+ * one block at a time; the default block (128 KiB of doubles) fits L2.
+ */
+#ifndef TTAK_FFT_BLOCK_ELEMS
+#define TTAK_FFT_BLOCK_ELEMS ((size_t)1 << 13)
+#endif
+
+/**
+ * @brief Precomputed twiddles for transforms of one length.
+ *
+ * The radix-4 stage with quarter length q keeps w^j, w^2j and w^3j for
+ * j < q, w = e^(-2 pi i / 4q), as six arrays of q doubles (re, im of each)
+ * starting at 2 (q - q0), where q0 is the smallest quarter of the plan.
+ * Every twiddle is evaluated directly rather than by recurrence, so each
+ * is within an ulp or so of the exact root.
+ */
+typedef struct ttak_fft_plan {
+    size_t n;                 /**< Transform length. */
+    double *twiddles;         /**< Radix-4 stage tables, smallest quarter first. */
+    ttak_fft_kernel_t kernel; /**< Butterflies in use; any kernel the host runs may be set. */
+} ttak_fft_plan_t;
+
+typedef ttak_fft_plan_t tt_fft_plan_t;
+
+/**
+ * @brief Builds the twiddle tables for transforms of length @p n.
+ * @return False if @p n is not a power of two up to 2^TTAK_FFT_MAX_LOG or
+ *         memory runs out.
+ */
+bool ttak_fft_plan_init(ttak_fft_plan_t *plan, size_t n);
+
+/** @brief Releases the twiddle tables. */
+void ttak_fft_plan_destroy(ttak_fft_plan_t *plan);
+
+/**
+ * @brief Plan for length @p n, built on first use and kept for the life of
+ * the process. Safe to call from any thread.
+ * @return NULL when ttak_fft_plan_init() would fail.
+ */
+const ttak_fft_plan_t *ttak_fft_plan_get(size_t n, uint64_t now);
+
+/** @brief Forward transform (sign -1); natural-order input, bit-reversed output. */
+void ttak_fft_plan_forward(const ttak_fft_plan_t *plan, double *re, double *im);
+
+/** @brief dst = lhs * rhs * @p scale element by element; dst may alias either operand. */
+void ttak_fft_plan_pointwise_mul(const ttak_fft_plan_t *plan, double *dst_re, double *dst_im,
+                                 const double *lhs_re, const double *lhs_im, const double *rhs_re,
+                                 const double *rhs_im, double scale);
+
+/**
+ * @brief Inverse transform (sign +1) including the 1/n normalisation;
+ * bit-reversed input, natural-order output.
+ */
+void ttak_fft_plan_inverse(const ttak_fft_plan_t *plan, double *re, double *im);
+
+/** @brief Permutes @p n elements into bit-reversed order, or back. */
+void ttak_fft_bit_reverse(double *re, double *im, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TTAK_MATH_FFT_H
@@ -0,0 +1,190 @@
+/**
+ * @file limbs.h
+ * @brief Limb-vector kernels behind ttak_bigint_t.
+ *
+ * Primitives on little-endian limb arrays in the style of GMP's mpn
+ * layer. The implementation is picked once per process: x86-64 hosts
+ * with BMI2 and ADX multiply with mulx and two independent carry chains
+ * (adcx / adox), other x86-64 hosts add and subtract with adc / sbb
+ * loops, and everything else runs portable C over the double-width type,
+ * which AArch64 compilers turn into mul / umulh.
+ *
+ * Destination arrays may coincide with a source array but not partially
+ * overlap it.
+ */
+
+#ifndef TTAK_MATH_LIMBS_H
+#define TTAK_MATH_LIMBS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/math/bigint.h>
+#include <ttak/thread/pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Unsigned type holding the full product of two limbs. */
+#if TTAK_BIGINT_LIMB_BITS == 64
+typedef unsigned __int128 ttak_dlimb_t;
+#else
+typedef uint64_t ttak_dlimb_t;
+#endif
+
+/**
+ * @brief rp = ap + bp over @p n limbs.
+ * @return The carry out, 0 or 1.
+ */
+limb_t ttak_limbs_add_n(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n);
+
+/**
+ * @brief rp = ap - bp over @p n limbs.
+ * @return The borrow out, 0 or 1.
+ */
+limb_t ttak_limbs_sub_n(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n);
+
+/**
+ * @brief rp = ap * b over @p n limbs.
+ * @return The high limb of the product.
+ */
+limb_t ttak_limbs_mul_1(limb_t *rp, const limb_t *ap, size_t n, limb_t b);
+
+/**
+ * @brief rp += ap * b over @p n limbs.
+ * @return The limb carried out of rp[n - 1].
+ */
+limb_t ttak_limbs_addmul_1(limb_t *rp, const limb_t *ap, size_t n, limb_t b);
+
+/**
+ * @brief rp -= ap * b over @p n limbs.
+ * @return The limb borrowed out of rp[n - 1].
+ */
+limb_t ttak_limbs_submul_1(limb_t *rp, const limb_t *ap, size_t n, limb_t b);
+
+/**
+ * @brief Name of the kernels in use: "x86-64-adx", "x86-64" or "generic".
+ */
+const char *ttak_limbs_kernel_name(void);
+
+/*
+ * Crossover points of the multiplication ladder, in limbs of the shorter
+ * operand. The defaults come from the bigint_mul ladder in bench/ttak_bench.c
+ * on an x86-64 host with 64-bit limbs; override them at build time to retune.
+ */
+#ifndef TTAK_LIMBS_KARATSUBA_THRESHOLD
+#define TTAK_LIMBS_KARATSUBA_THRESHOLD 80
+#endif
+#ifndef TTAK_LIMBS_TOOM3_THRESHOLD
+#define TTAK_LIMBS_TOOM3_THRESHOLD 384
+#endif
+/* Reached only when the NTT runs its scalar kernel; the vector kernels take over first. */
+#ifndef TTAK_LIMBS_FFT_THRESHOLD
+#define TTAK_LIMBS_FFT_THRESHOLD 2048
+#endif
+/* Widest digit the FFT tier tries; narrower ones are used when the rounding bound demands. */
+#ifndef TTAK_LIMBS_FFT_MAX_BITS
+#define TTAK_LIMBS_FFT_MAX_BITS 20
+#endif
+#ifndef TTAK_LIMBS_NTT_THRESHOLD
+#define TTAK_LIMBS_NTT_THRESHOLD 32768
+#endif
+/* Replaces TTAK_LIMBS_NTT_THRESHOLD when the NTT butterflies run on a vector kernel. */
+#ifndef TTAK_LIMBS_NTT_VECTOR_THRESHOLD
+#define TTAK_LIMBS_NTT_VECTOR_THRESHOLD 1024
+#endif
+/* Shorter operands below this stay on one thread in ttak_limbs_mul_parallel(). */
+#ifndef TTAK_LIMBS_NTT_PARALLEL_THRESHOLD
+#define TTAK_LIMBS_NTT_PARALLEL_THRESHOLD 8192
+#endif
+
+/* Divisor and quotient lengths from which division recurses instead of running Algorithm D. */
+#ifndef TTAK_LIMBS_DC_DIV_THRESHOLD
+#define TTAK_LIMBS_DC_DIV_THRESHOLD 48
+#endif
+/* Numbers shorter than this many limbs go to decimal by repeated division. */
+#ifndef TTAK_LIMBS_DC_GET_STR_THRESHOLD
+#define TTAK_LIMBS_DC_GET_STR_THRESHOLD 24
+#endif
+
+/**
+ * @brief Multiplication algorithms of the ladder.
+ */
+typedef enum ttak_limbs_mul_algo {
+    TTAK_LIMBS_MUL_AUTO = 0,  /**< Pick by operand size. */
+    TTAK_LIMBS_MUL_BASECASE,  /**< Schoolbook, O(n^2). */
+    TTAK_LIMBS_MUL_KARATSUBA, /**< Two-way split, O(n^1.585). */
+    TTAK_LIMBS_MUL_TOOM3,     /**< Three-way split, O(n^1.465). */
+    TTAK_LIMBS_MUL_NTT,       /**< Three-prime NTT with CRT, O(n log n). */
+    TTAK_LIMBS_MUL_FFT        /**< Double-precision complex FFT on balanced digits, O(n log n). */
+} ttak_limbs_mul_algo_t;
+
+/**
+ * @brief Schoolbook product rp = ap * bp.
+ *
+ * @p rp must hold @p an + @p bn limbs and may not overlap either operand.
+ * Both lengths must be non-zero.
+ */
+void ttak_limbs_mul_basecase(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn);
+
+/**
+ * @brief Product rp = ap * bp, choosing the algorithm by size.
+ *
+ * @p rp must hold @p an + @p bn limbs and may not overlap either operand.
+ * @return false when scratch memory could not be allocated.
+ */
+bool ttak_limbs_mul(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn, uint64_t now);
+
+/**
+ * @brief Like ttak_limbs_mul() but with the top-level algorithm forced.
+ *
+ * Recursive sub-products still pick by size. An algorithm the operands do
+ * not suit (a Toom-3 split of very unbalanced inputs, an NTT beyond the
+ * transform length of the primes, an FFT whose rounding error could reach
+ * one half) falls back to the automatic choice.
+ */
+bool ttak_limbs_mul_algo(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                         ttak_limbs_mul_algo_t algo, uint64_t now);
+
+/**
+ * @brief Like ttak_limbs_mul() but spread over @p pool once the shorter
+ * operand reaches TTAK_LIMBS_NTT_PARALLEL_THRESHOLD limbs.
+ *
+ * The NTT primes and the column and block passes of each transform run
+ * as pool tasks, with the caller taking a share. NULL @p pool, smaller
+ * operands and products too long for the NTT run ttak_limbs_mul().
+ */
+bool ttak_limbs_mul_parallel(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                             ttak_thread_pool_t *pool, uint64_t now);
+
+/**
+ * @brief Quotient and remainder of np (nn limbs) by dp (dn limbs).
+ *
+ * @p qp receives nn - dn + 1 limbs and @p rp dn limbs; either may be
+ * NULL. Neither may overlap an operand. Past TTAK_LIMBS_DC_DIV_THRESHOLD
+ * the division recurses on the multiplication ladder (Burnikel-Ziegler).
+ *
+ * @return false when dn is 0, nn < dn, the top limb of @p dp is zero, or
+ *         scratch memory could not be allocated.
+ */
+bool ttak_limbs_divrem(limb_t *qp, limb_t *rp, const limb_t *np, size_t nn, const limb_t *dp, size_t dn,
+                       uint64_t now);
+
+/**
+ * @brief Writes the decimal digits of xp (xn limbs) to @p out, without a
+ * terminator.
+ *
+ * @p out must hold xn * TTAK_BIGINT_LIMB_BITS * log10(2) + 1 characters.
+ * Long numbers are split by cached powers of ten and both halves converted
+ * recursively.
+ *
+ * @return Number of digits written, or 0 when scratch memory ran out.
+ */
+size_t ttak_limbs_get_str(char *out, const limb_t *xp, size_t xn, uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_MATH_LIMBS_H */
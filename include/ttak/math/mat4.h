@@ -0,0 +1,108 @@
+/**
+ * @file mat4.h
+ * @brief Fixed-precision 4x4 matrices and 4-vectors for geometry work.
+ *
+ * The float and double types here sit beside the exact ttak_matrix_t and
+ * ttak_vector_t. They are plain aligned values with no owner or shared
+ * wrapper, so a 4x4 multiply is a few dozen vector instructions rather
+ * than a bigreal operation per element. Kernels use SSE2, AVX2 or NEON
+ * where the compiler may emit them and portable loops otherwise.
+ *
+ * Matrices are row-major with the same layout as ttak_matrix_t, and they
+ * act on column vectors: r = M v. ttak_matrix_export_f64() and
+ * ttak_matrix_import_f64() move values between the two families.
+ */
+
+#ifndef TTAK_MATH_MAT4_H
+#define TTAK_MATH_MAT4_H
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ttak_vec4f {
+    alignas(16) float v[4];
+} ttak_vec4f_t;
+
+typedef struct ttak_mat4f {
+    alignas(16) float m[16];
+} ttak_mat4f_t;
+
+typedef struct ttak_vec4d {
+    alignas(32) double v[4];
+} ttak_vec4d_t;
+
+typedef struct ttak_mat4d {
+    alignas(32) double m[16];
+} ttak_mat4d_t;
+
+typedef ttak_vec4f_t tt_vec4f_t;
+typedef ttak_mat4f_t tt_mat4f_t;
+typedef ttak_vec4d_t tt_vec4d_t;
+typedef ttak_mat4d_t tt_mat4d_t;
+
+/** @brief Sets @p m to the identity. */
+void ttak_mat4f_identity(ttak_mat4f_t *m);
+
+/** @brief res = a b. @p res may alias either operand. */
+void ttak_mat4f_mul(ttak_mat4f_t *res, const ttak_mat4f_t *a, const ttak_mat4f_t *b);
+
+/** @brief res = m v. @p res may alias @p v. */
+void ttak_mat4f_mul_vec(ttak_vec4f_t *res, const ttak_mat4f_t *m, const ttak_vec4f_t *v);
+
+/**
+ * @brief out[i] = m in[i] for @p count vectors.
+ *
+ * The columns of @p m are loaded once for the whole batch. @p out may be
+ * @p in but must not otherwise overlap it.
+ */
+void ttak_mat4f_transform(const ttak_mat4f_t *m, const ttak_vec4f_t *in, ttak_vec4f_t *out, size_t count);
+
+/** @brief res = m^T. @p res may alias @p m. */
+void ttak_mat4f_transpose(ttak_mat4f_t *res, const ttak_mat4f_t *m);
+
+/**
+ * @brief Rotation by @p angle radians about axis 0 (x), 1 (y) or any other
+ *        value (z), laid out as ttak_matrix_set_rotation() lays it out.
+ */
+void ttak_mat4f_rotation(ttak_mat4f_t *m, uint8_t axis, float angle);
+
+/** @brief Sum of the four products a[i] b[i]. */
+float ttak_vec4f_dot(const ttak_vec4f_t *a, const ttak_vec4f_t *b);
+
+/** @brief Cross product of the xyz parts; the w of @p res is 0. @p res may alias either operand. */
+void ttak_vec4f_cross(ttak_vec4f_t *res, const ttak_vec4f_t *a, const ttak_vec4f_t *b);
+
+/** @brief Sets @p m to the identity. */
+void ttak_mat4d_identity(ttak_mat4d_t *m);
+
+/** @brief res = a b. @p res may alias either operand. */
+void ttak_mat4d_mul(ttak_mat4d_t *res, const ttak_mat4d_t *a, const ttak_mat4d_t *b);
+
+/** @brief res = m v. @p res may alias @p v. */
+void ttak_mat4d_mul_vec(ttak_vec4d_t *res, const ttak_mat4d_t *m, const ttak_vec4d_t *v);
+
+/** @brief out[i] = m in[i] for @p count vectors; overlap rules as ttak_mat4f_transform(). */
+void ttak_mat4d_transform(const ttak_mat4d_t *m, const ttak_vec4d_t *in, ttak_vec4d_t *out, size_t count);
+
+/** @brief res = m^T. @p res may alias @p m. */
+void ttak_mat4d_transpose(ttak_mat4d_t *res, const ttak_mat4d_t *m);
+
+/** @brief Rotation by @p angle radians; see ttak_mat4f_rotation(). */
+void ttak_mat4d_rotation(ttak_mat4d_t *m, uint8_t axis, double angle);
+
+/** @brief Sum of the four products a[i] b[i]. */
+double ttak_vec4d_dot(const ttak_vec4d_t *a, const ttak_vec4d_t *b);
+
+/** @brief Cross product of the xyz parts; the w of @p res is 0. */
+void ttak_vec4d_cross(ttak_vec4d_t *res, const ttak_vec4d_t *a, const ttak_vec4d_t *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_MATH_MAT4_H */
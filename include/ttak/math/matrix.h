@@ -2,6 +2,7 @@
 #define TTAK_MATH_MATRIX_H
 
 #include <ttak/math/vector.h>
+#include <ttak/math/mat4.h>
 
 /**
  * @brief Matrix structure for up to 4x4.
@@ -30,6 +31,38 @@ ttak_bigreal_t* ttak_matrix_get(tt_shared_matrix_t *sm, tt_owner_t *owner, uint8
  */
 _Bool ttak_matrix_set(tt_shared_matrix_t *sm, tt_owner_t *owner, uint8_t row, uint8_t col, const ttak_bigreal_t *val, uint64_t now);
 
+/**
+ * @brief Copies @p count values, row-major, into every element at once.
+ *
+ * Takes the owner check and the shared access once for the whole matrix
+ * rather than once per element as ttak_matrix_set() does.
+ *
+ * @return false unless @p count equals rows * cols.
+ */
+_Bool ttak_matrix_set_all(tt_shared_matrix_t *sm, tt_owner_t *owner, const ttak_bigreal_t *vals, size_t count, uint64_t now);
+
+/**
+ * @brief Copies every element, row-major, into @p out under one access.
+ *
+ * @param out @p count initialised bigreals; @p count must equal rows * cols.
+ */
+_Bool ttak_matrix_get_all(tt_shared_matrix_t *sm, tt_owner_t *owner, ttak_bigreal_t *out, size_t count, uint64_t now);
+
+/**
+ * @brief Rounds the matrix into a ttak_mat4d_t for the fixed-precision kernels.
+ *
+ * A matrix smaller than 4x4 lands in the top-left corner and the rest of
+ * @p out is the identity, so a 3x3 rotation still transforms 4-vectors.
+ *
+ * @return false if the owner is refused or an element overflows a double.
+ */
+_Bool ttak_matrix_export_f64(tt_shared_matrix_t *sm, tt_owner_t *owner, ttak_mat4d_t *out);
+
+/**
+ * @brief Loads the top-left rows x cols of @p in, through ttak_bigreal_set_double().
+ */
+_Bool ttak_matrix_import_f64(tt_shared_matrix_t *sm, tt_owner_t *owner, const ttak_mat4d_t *in, uint64_t now);
+
 /**
  * @brief Matrix-Vector Multiplication.
  */
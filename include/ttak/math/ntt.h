@@ -16,6 +16,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <ttak/types/fixed.h>
+#include <ttak/thread/pool.h>
 
 /**
  * @brief Predefined prime information for NTT operations.
@@ -34,6 +35,18 @@ typedef struct ttak_ntt_prime {
 /** @brief Table of built-in NTT-friendly primes. */
 extern const ttak_ntt_prime_t ttak_ntt_primes[TTAK_NTT_PRIME_COUNT];
 
+/** @brief Number of built-in primes below 2^50, sized for 52-bit IFMA lanes. */
+#define TTAK_NTT_PRIME50_COUNT 2
+
+/**
+ * @brief Primes c * 2^k + 1 below 2^50 (k = 40 and 39).
+ *
+ * Two of them cover what the three 30-bit primes do, which pays off on
+ * hosts where TTAK_NTT_KERNEL_IFMA multiplies 50-bit residues as fast as
+ * the other kernels multiply 30-bit ones.
+ */
+extern const ttak_ntt_prime_t ttak_ntt_primes50[TTAK_NTT_PRIME50_COUNT];
+
 /** @brief Modular addition: returns (a + b) mod @p mod. */
 uint64_t ttak_mod_add(uint64_t a, uint64_t b, uint64_t mod);
 /** @brief Modular subtraction: returns (a - b) mod @p mod. */
@@ -66,10 +79,120 @@ uint64_t ttak_montgomery_convert(uint64_t value, const ttak_ntt_prime_t *prime);
  * @param n       Transform size (power of two, ≤ 2^prime->max_power_two).
  * @param prime   NTT prime providing the primitive root.
  * @param inverse True for inverse NTT (includes 1/n normalisation).
- * @return        True on success, false if @p n exceeds the prime's limit.
+ * @return        True on success, false if @p n exceeds the prime's limit
+ *                or the twiddle table cannot be allocated.
  */
 _Bool ttak_ntt_transform(uint64_t *data, size_t n, const ttak_ntt_prime_t *prime, _Bool inverse);
 
+/**
+ * @brief Butterfly kernels a plan can run.
+ *
+ * The vector kernels keep one residue per 64-bit lane, so spectra have the
+ * same layout whichever kernel wrote them.
+ */
+typedef enum ttak_ntt_kernel {
+    TTAK_NTT_KERNEL_SCALAR = 0, /**< Portable C, one element at a time. */
+    TTAK_NTT_KERNEL_AVX2,       /**< Four lanes of vpmuludq, primes below 2^31. */
+    TTAK_NTT_KERNEL_AVX512,     /**< Eight lanes of vpmuludq, primes below 2^31. */
+    TTAK_NTT_KERNEL_IFMA,       /**< Eight lanes of vpmadd52, primes below 2^50. */
+    TTAK_NTT_KERNEL_NEON        /**< Two lanes of umull, primes below 2^31. */
+} ttak_ntt_kernel_t;
+
+typedef ttak_ntt_kernel_t tt_ntt_kernel_t;
+
+/**
+ * @brief Fastest kernel the running host offers for @p prime.
+ *
+ * ttak_ntt_plan_init() uses it; it also tells callers which prime width
+ * is cheap here.
+ */
+ttak_ntt_kernel_t ttak_ntt_kernel_for(const ttak_ntt_prime_t *prime);
+
+/** @brief Name of a kernel: "scalar", "avx2", "avx512", "ifma" or "neon". */
+const char *ttak_ntt_kernel_name(ttak_ntt_kernel_t kernel);
+
+/**
+ * @brief Precomputed twiddles for repeated transforms of one (prime, n).
+ *
+ * The plan transforms skip both bit-reversal passes: forward consumes
+ * natural order and leaves the spectrum bit-reversed, inverse consumes that
+ * order and restores natural order. Spectra stay in the plan's Montgomery
+ * domain: ttak_ntt_plan_pointwise_mul() leaves a factor R^-1 that
+ * ttak_ntt_plan_inverse() cancels together with 1/n, so a multiply is
+ * forward, forward, pointwise, inverse with no conversion passes.
+ *
+ * The Montgomery radix R follows the kernel: 2^32 for primes below 2^31,
+ * 2^52 for primes below 2^50 on the IFMA kernel and 2^64 otherwise.
+ * Stages are fused in pairs (radix 4), and transforms longer than
+ * TTAK_NTT_BLOCK_ELEMS finish block by block so the short stages stay
+ * in cache.
+ */
+typedef struct ttak_ntt_plan {
+    const ttak_ntt_prime_t *prime; /**< Prime the plan was built for. */
+    size_t n;                      /**< Transform length. */
+    uint64_t *twiddles;            /**< Stage len uses [len, 2 len) forward and [n + len, n + 2 len) inverse, Montgomery form. */
+    uint64_t inv_n;                /**< 1/n mod p. */
+    uint64_t r_mod;                /**< R mod p, the Montgomery form of 1. */
+    uint64_t scale;                /**< R^2/n mod p, applied after the inverse. */
+    uint64_t inv_r;                /**< -p^-1 mod R when R is 2^32 or 2^52. */
+    uint32_t radix_bits;           /**< log2 R: 32, 52 or 64. */
+    ttak_ntt_kernel_t kernel;      /**< Butterflies in use; any kernel valid for radix_bits may be set. */
+} ttak_ntt_plan_t;
+
+typedef ttak_ntt_plan_t tt_ntt_plan_t;
+
+/**
+ * @brief Transforms longer than this many elements run their small stages
+ * one block at a time; the default block (512 KiB) fits a typical L2.
+ */
+#ifndef TTAK_NTT_BLOCK_ELEMS
+#define TTAK_NTT_BLOCK_ELEMS ((size_t)1 << 16)
+#endif
+
+/**
+ * @brief Builds the twiddle table for transforms of length @p n.
+ * @return False if @p n is not a supported power of two or memory runs out.
+ */
+_Bool ttak_ntt_plan_init(ttak_ntt_plan_t *plan, const ttak_ntt_prime_t *prime, size_t n);
+
+/** @brief Releases the twiddle table. */
+void ttak_ntt_plan_destroy(ttak_ntt_plan_t *plan);
+
+/**
+ * @brief Forward transform; natural-order input, bit-reversed output.
+ *
+ * Inputs at or above the modulus are reduced on the first stage.
+ */
+void ttak_ntt_plan_forward(const ttak_ntt_plan_t *plan, uint64_t *data);
+
+/** @brief dst[i] = lhs[i] * rhs[i] * R^-1 mod p on two forward spectra. */
+void ttak_ntt_plan_pointwise_mul(const ttak_ntt_plan_t *plan, uint64_t *dst, const uint64_t *lhs, const uint64_t *rhs);
+
+/**
+ * @brief Inverse of forward followed by pointwise_mul; bit-reversed input,
+ * natural-order output in plain residues.
+ */
+void ttak_ntt_plan_inverse(const ttak_ntt_plan_t *plan, uint64_t *data);
+
+/** @brief Narrowest column task of ttak_ntt_plan_convolve(), in elements. */
+#ifndef TTAK_NTT_COLUMN_MIN
+#define TTAK_NTT_COLUMN_MIN ((size_t)64)
+#endif
+
+/**
+ * @brief @p count cyclic convolutions at once: lhs[i] becomes the product
+ * of lhs[i] and rhs[i] under plans[i], spread over @p pool.
+ *
+ * Every plan must have the same length. rhs[i] may equal lhs[i] to square;
+ * otherwise it is left holding its spectrum. Stages longer than a block
+ * run as column tasks and the rest as block tasks, the plans side by side,
+ * so the primes of a CRT product proceed together. The caller takes tasks
+ * as well, which makes the call safe from inside a task of @p pool; with a
+ * NULL pool it runs inline and matches forward, pointwise_mul and inverse.
+ */
+void ttak_ntt_plan_convolve(const ttak_ntt_plan_t *const *plans, uint64_t *const *lhs, uint64_t *const *rhs,
+                            size_t count, ttak_thread_pool_t *pool, uint64_t now);
+
 /** @brief Point-wise multiplication: dst[i] = lhs[i] * rhs[i] mod p. */
 void ttak_ntt_pointwise_mul(uint64_t *dst, const uint64_t *lhs, const uint64_t *rhs, size_t n, const ttak_ntt_prime_t *prime);
 
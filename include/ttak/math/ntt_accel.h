@@ -0,0 +1,80 @@
+/**
+ * @file ntt_accel.h
+ * @brief Batched NTTs and pointwise products on an accelerator.
+ *
+ * A batch is @c count rows of @c n residues that stay resident on the
+ * device between calls, so a chain of transforms and pointwise products
+ * crosses the bus only on upload and download. Every call works on all
+ * rows at once and matches ttak_ntt_transform(), ttak_ntt_pointwise_mul()
+ * and ttak_ntt_pointwise_square() row by row: transforms take and return
+ * natural order, and the inverse includes the 1/n normalisation.
+ *
+ * A batch uses the first CUDA, ROCm or OpenCL backend that accepts it when
+ * created. Without one, the rows live in host memory and the same calls run
+ * the CPU transforms, so callers need not branch on availability.
+ */
+
+#ifndef TTAK_MATH_NTT_ACCEL_H
+#define TTAK_MATH_NTT_ACCEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/math/ntt.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Rows of residues owned by one backend. */
+typedef struct ttak_ntt_accel_batch ttak_ntt_accel_batch_t;
+
+typedef ttak_ntt_accel_batch_t tt_ntt_accel_batch_t;
+
+/**
+ * @brief Returns true when a GPU backend for batched NTTs is available.
+ */
+bool ttak_ntt_accel_available(void);
+
+/**
+ * @brief Allocates @p count rows of @p n residues; @p n must be a power of two.
+ * @return NULL on a bad shape or allocation failure.
+ */
+ttak_ntt_accel_batch_t *ttak_ntt_accel_batch_create(size_t n, size_t count, uint64_t now);
+
+/** @brief Releases @p batch and its device memory. */
+void ttak_ntt_accel_batch_destroy(ttak_ntt_accel_batch_t *batch);
+
+/** @brief true when the rows of @p batch live on a device rather than the host. */
+bool ttak_ntt_accel_batch_on_device(const ttak_ntt_accel_batch_t *batch);
+
+/** @brief Copies count * n residues, row after row, from @p src into the batch. */
+bool ttak_ntt_accel_upload(ttak_ntt_accel_batch_t *batch, const uint64_t *src);
+
+/** @brief Copies count * n residues, row after row, out of the batch into @p dst. */
+bool ttak_ntt_accel_download(const ttak_ntt_accel_batch_t *batch, uint64_t *dst);
+
+/**
+ * @brief Forward or inverse transform of every row under @p prime.
+ * @return false if n exceeds the prime's limit or the device fails.
+ */
+bool ttak_ntt_accel_transform(ttak_ntt_accel_batch_t *batch, const ttak_ntt_prime_t *prime, bool inverse);
+
+/**
+ * @brief dst[i] = lhs[i] * rhs[i] mod p over every residue of the batches.
+ *
+ * All three batches must have the same shape and backend; @p dst may be
+ * @p lhs or @p rhs.
+ */
+bool ttak_ntt_accel_pointwise_mul(ttak_ntt_accel_batch_t *dst, const ttak_ntt_accel_batch_t *lhs,
+                                  const ttak_ntt_accel_batch_t *rhs, const ttak_ntt_prime_t *prime);
+
+/** @brief dst[i] = src[i]^2 mod p; @p dst may be @p src. */
+bool ttak_ntt_accel_pointwise_square(ttak_ntt_accel_batch_t *dst, const ttak_ntt_accel_batch_t *src,
+                                     const ttak_ntt_prime_t *prime);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_MATH_NTT_ACCEL_H */
@@ -0,0 +1,111 @@
+/**
+ * @file prime.h
+ * @brief Prime sieves and 64-bit primality tests shared by the factorers.
+ *
+ * The sieves keep one bit per odd number and walk it in segments of
+ * TTAK_PRIME_SIEVE_SEGMENT_WORDS words, so the words being crossed off stay
+ * in L1 however far the range reaches. Each segment starts as a copy of a
+ * pattern with the multiples of 3, 5, 7, 11 and 13 already cleared, which
+ * turns the densest crossing-off into straight block copies.
+ *
+ * ttak_is_prime_u64() trial-divides by the primes below
+ * TTAK_PRIME_SMALL_LIMIT and then runs Miller-Rabin in Montgomery form over
+ * a witness set that is deterministic for every 64-bit n.
+ */
+
+#ifndef TTAK_MATH_PRIME_H
+#define TTAK_MATH_PRIME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief ttak_prime_small_table() holds the primes below this bound. */
+#define TTAK_PRIME_SMALL_LIMIT 1000
+
+/** @brief Bitmap words sieved at a time; 4096 words cover 2^19 numbers in 32 KiB. */
+#ifndef TTAK_PRIME_SIEVE_SEGMENT_WORDS
+#define TTAK_PRIME_SIEVE_SEGMENT_WORDS 4096
+#endif
+
+/** @brief Values ttak_is_prime_u64_batch() carries through one Montgomery ladder together. */
+#ifndef TTAK_PRIME_BATCH_LANES
+#define TTAK_PRIME_BATCH_LANES 8
+#endif
+
+/** @brief The primes below TTAK_PRIME_SMALL_LIMIT in increasing order; @p count_out receives 168. */
+const uint16_t *ttak_prime_small_table(size_t *count_out);
+
+/**
+ * @brief Segmented sieve over the odd numbers up to @p limit.
+ *
+ * Bit i of the result is set when 2i + 1 is a prime no larger than
+ * @p limit. Free with ttak_mem_free().
+ *
+ * @return NULL on allocation failure.
+ */
+uint64_t *ttak_prime_odd_bits(uint64_t limit, uint64_t now);
+
+/** @brief true when the odd number @p v is marked prime in @p bits. */
+static inline bool ttak_prime_is_odd_marked(const uint64_t *bits, uint64_t v) {
+    uint64_t i = v >> 1;
+    return (bits[i >> 6] >> (i & 63)) & 1u;
+}
+
+/**
+ * @brief The odd primes from 3 up to @p limit, in increasing order.
+ *
+ * Free with ttak_mem_free(). Limits below 2^16 are served from a table
+ * built once per process.
+ *
+ * @return NULL on allocation failure; a list with no primes is still allocated.
+ */
+uint32_t *ttak_prime_odd_list(uint32_t limit, size_t *count_out, uint64_t now);
+
+/** @brief Opaque walk over the primes of a range. */
+typedef struct ttak_prime_sieve ttak_prime_sieve_t;
+
+typedef ttak_prime_sieve_t tt_prime_sieve_t;
+
+/**
+ * @brief Starts a walk over the primes in [@p lo, @p hi).
+ *
+ * Holds the primes up to sqrt(hi) plus one segment, so memory grows with
+ * the square root of @p hi rather than with the range.
+ *
+ * @return NULL on allocation failure.
+ */
+ttak_prime_sieve_t *ttak_prime_sieve_create(uint64_t lo, uint64_t hi, uint64_t now);
+
+/**
+ * @brief Writes the next primes of the walk, in increasing order.
+ *
+ * @return The number written to @p out, at most @p cap; 0 once the range is done.
+ */
+size_t ttak_prime_sieve_next(ttak_prime_sieve_t *sieve, uint64_t *out, size_t cap);
+
+/** @brief Releases a walk from ttak_prime_sieve_create(). */
+void ttak_prime_sieve_destroy(ttak_prime_sieve_t *sieve);
+
+/** @brief Deterministic primality test for any 64-bit @p n. */
+bool ttak_is_prime_u64(uint64_t n);
+
+/**
+ * @brief ttak_is_prime_u64() over @p count values at once.
+ *
+ * Values left after trial division run Miller-Rabin in groups of
+ * TTAK_PRIME_BATCH_LANES, each witness applied to the whole group in one
+ * ladder, so their independent multiplications overlap in the pipeline.
+ * prime_out[i] receives the result for values[i].
+ */
+void ttak_is_prime_u64_batch(const uint64_t *values, size_t count, bool *prime_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_MATH_PRIME_H */
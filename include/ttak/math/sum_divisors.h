@@ -3,6 +3,8 @@
 
 #include <ttak/log/logger.h>
 #include <ttak/math/bigint.h>
+#include <ttak/thread/pool.h>
+#include <ttak/types/fixed.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -31,6 +33,36 @@ typedef enum {
  */
 bool ttak_sum_proper_divisors_u64(uint64_t n, uint64_t *result_out);
 
+/** @brief Values per ttak_sum_divisors_range() task; sized to keep a segment in L2. */
+#ifndef TTAK_SUMDIV_RANGE_SEGMENT
+#define TTAK_SUMDIV_RANGE_SEGMENT 16384
+#endif
+
+/**
+ * @brief Largest prime ttak_sum_divisors_range() sieves with. Past its
+ * square, the cofactor each value has left is factored on its own, since
+ * sieving on would walk far more primes per segment than it has values.
+ */
+#ifndef TTAK_SUMDIV_RANGE_SIEVE_MAX_PRIME
+#define TTAK_SUMDIV_RANGE_SIEVE_MAX_PRIME (1u << 22)
+#endif
+
+/**
+ * @brief Computes sigma(n) for every n in [start, start + count).
+ *
+ * A segmented sieve divides the primes up to sqrt(start + count - 1), at
+ * most TTAK_SUMDIV_RANGE_SIEVE_MAX_PRIME, out of one
+ * TTAK_SUMDIV_RANGE_SEGMENT block at a time, with the blocks spread
+ * over @p pool (NULL runs them on the caller). sigma_out[i] receives
+ * sigma(start + i); the sum of proper divisors is that minus start + i.
+ * Every sigma(n) of a 64-bit n fits the 128-bit output.
+ *
+ * @return false when @p start is 0, the range passes UINT64_MAX, or memory
+ *         runs out.
+ */
+bool ttak_sum_divisors_range(uint64_t start, size_t count, ttak_u128_t *sigma_out, ttak_thread_pool_t *pool,
+                             uint64_t now);
+
 /**
  * @brief Calculates the sum of proper divisors for a big integer.
  *
@@ -2,6 +2,7 @@
 #define TTAK_MATH_VECTOR_H
 
 #include <ttak/math/bigreal.h>
+#include <ttak/math/mat4.h>
 #include <ttak/shared/shared.h>
 #include <ttak/mem/owner.h>
 #include <stdbool.h>
@@ -38,6 +39,30 @@ ttak_bigreal_t* ttak_vector_get(tt_shared_vector_t *sv, tt_owner_t *owner, uint8
  */
 bool ttak_vector_set(tt_shared_vector_t *sv, tt_owner_t *owner, uint8_t index, const ttak_bigreal_t *val, uint64_t now);
 
+/**
+ * @brief Copies @p count values into every element under one owner access.
+ *
+ * @return false unless @p count equals the dimension.
+ */
+bool ttak_vector_set_all(tt_shared_vector_t *sv, tt_owner_t *owner, const ttak_bigreal_t *vals, size_t count, uint64_t now);
+
+/**
+ * @brief Copies every element into @p count initialised bigreals under one owner access.
+ */
+bool ttak_vector_get_all(tt_shared_vector_t *sv, tt_owner_t *owner, ttak_bigreal_t *out, size_t count, uint64_t now);
+
+/**
+ * @brief Rounds the vector into a ttak_vec4d_t; entries past the dimension are 0.
+ *
+ * @return false if the owner is refused or an element overflows a double.
+ */
+bool ttak_vector_export_f64(tt_shared_vector_t *sv, tt_owner_t *owner, ttak_vec4d_t *out);
+
+/**
+ * @brief Loads the first dim entries of @p in, through ttak_bigreal_set_double().
+ */
+bool ttak_vector_import_f64(tt_shared_vector_t *sv, tt_owner_t *owner, const ttak_vec4d_t *in, uint64_t now);
+
 /**
  * @brief Vector Dot Product.
  */
@@ -1,6 +1,8 @@
 #ifndef TTAK_MEM_ARENA_HELPER_H
 #define TTAK_MEM_ARENA_HELPER_H
 
+#include <stdalign.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -17,6 +19,7 @@ typedef struct ttak_arena_env_config {
     size_t chunk_bytes;            /**< Default chunk size carved from a generation. */
     ttak_mem_flags_t alloc_flags;  /**< Flags passed to ttak_mem_alloc_with_flags. */
     uint64_t lifetime_ticks;       /**< Lifetime hint for allocations. */
+    size_t lane_refill_bytes;      /**< Bytes a lane takes per refill; see ttak_arena_generation_claim_lane(). */
 } ttak_arena_env_config_t;
 
 /**
@@ -29,6 +32,18 @@ typedef struct ttak_arena_env {
     bool owns_gc;
 } ttak_arena_env_t;
 
+/**
+ * @brief Bump region owned by one worker inside a laned generation.
+ *
+ * Only the owning worker touches a lane, so claims need no atomics. Each
+ * lane sits on its own cache line to keep neighbours from false sharing.
+ */
+typedef struct ttak_arena_lane {
+    alignas(64) uint8_t *cursor;   /**< Next free byte. */
+    uint8_t *limit;                /**< End of the current refill. */
+    void *refills;                 /**< Overflow buffers taken from the env, chained through a header in their first cache line. */
+} ttak_arena_lane_t;
+
 /**
  * @brief Fixed-width arena generation descriptor.
  */
@@ -37,6 +52,9 @@ typedef struct ttak_arena_generation {
     size_t capacity;
     size_t used;
     uint32_t epoch_id;
+    ttak_arena_lane_t *lanes;      /**< Per-worker lanes, or NULL for a shared generation. */
+    uint32_t lane_count;           /**< Number of entries in @c lanes. */
+    _Atomic size_t lane_cursor;    /**< Bytes of @c base already handed to lane refills. */
 } ttak_arena_generation_t;
 
 /**
@@ -68,6 +86,38 @@ void ttak_arena_env_destroy(ttak_arena_env_t *env);
  */
 bool ttak_arena_generation_begin(ttak_arena_env_t *env, ttak_arena_generation_t *generation, uint32_t epoch_id);
 
+/**
+ * @brief Allocates a generation whose claims go through per-worker lanes.
+ *
+ * Lanes refill @c lane_refill_bytes at a time, first from the generation
+ * buffer with a single atomic add, then from fresh env allocations once
+ * it is exhausted. Use ttak_arena_generation_claim_lane() on such a
+ * generation; ttak_arena_generation_claim() returns NULL for it.
+ *
+ * @param env Arena helper context.
+ * @param generation Generation descriptor to fill.
+ * @param epoch_id Epoch identifier recorded in the descriptor.
+ * @param lane_count Number of lanes, typically one per worker.
+ * @return False on allocation failure or a zero @p lane_count.
+ */
+bool ttak_arena_generation_begin_lanes(ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                                       uint32_t epoch_id, uint32_t lane_count);
+
+/**
+ * @brief Claims a chunk from lane @p lane of a laned generation.
+ *
+ * Wait-free unless the lane must refill: the bump itself touches only the
+ * lane. Each lane must be used by a single thread at a time.
+ *
+ * @param env Arena helper context.
+ * @param generation Generation begun with ttak_arena_generation_begin_lanes().
+ * @param lane Lane index, reduced modulo the lane count.
+ * @param bytes Chunk size; config chunk_bytes when zero.
+ * @return Cache-line aligned chunk, or NULL on allocation failure.
+ */
+void *ttak_arena_generation_claim_lane(ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                                       uint32_t lane, size_t bytes);
+
 /**
  * @brief Resets the scatter epoch, executing the Arena_Reset_Routine.
  */
@@ -85,6 +135,8 @@ size_t ttak_arena_generation_remaining(const ttak_arena_generation_t *generation
 
 /**
  * @brief Retires the generation, dropping the mem-tree reference and resetting the descriptor.
+ *
+ * For a laned generation the lane overflow buffers are released with it.
  */
 bool ttak_arena_generation_retire(ttak_arena_env_t *env, ttak_arena_generation_t *generation);
 
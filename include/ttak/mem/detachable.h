@@ -17,7 +17,7 @@ extern "C" {
 #endif
 
 /**
- * @brief Maximum size in bytes for cacheable detachable chunks.
+ * @brief Chunk size of the tiny-chunk cache; larger requests use the size classes.
  */
 #define TTAK_DETACHABLE_CACHE_MAX_BYTES 16U
 
@@ -26,6 +26,21 @@ extern "C" {
  */
 #define TTAK_DETACHABLE_CACHE_SLOTS 8U
 
+/**
+ * @brief Number of large size classes cached per context.
+ *
+ * Classes are powers of four from TTAK_DETACHABLE_CLASS_MIN_SHIFT: 4 KiB,
+ * 16 KiB, 64 KiB, 256 KiB and 1 MiB. Larger requests bypass the caches.
+ */
+#define TTAK_DETACHABLE_SIZE_CLASSES 5U
+#define TTAK_DETACHABLE_CLASS_MIN_SHIFT 12U
+#define TTAK_DETACHABLE_CLASS_MAX_BYTES (1UL << (TTAK_DETACHABLE_CLASS_MIN_SHIFT + 2U * (TTAK_DETACHABLE_SIZE_CLASSES - 1U)))
+
+/**
+ * @brief Buffers kept per size class in a thread front cache.
+ */
+#define TTAK_DETACHABLE_FRONT_SLOTS 2U
+
 /**
  * @brief Maximum number of tracked generations per arena row.
  */
@@ -101,9 +116,10 @@ static inline void ttak_detach_status_converge(ttak_detach_status_t *status) {
 }
 
 /**
- * @brief Per-context cache for tiny detachable chunks (<= 16 bytes).
+ * @brief Per-context cache for detachable chunks of one size.
  *
- * The cache implements an approximated LRU queue that is biased to favor the
+ * Serves the tiny (<= 16 bytes) chunk cache and the shared depot of each
+ * large size class. The cache implements an approximated LRU queue that is biased to favor the
  * active generation. Entries are zeroed before returning to the caller to keep
  * calloc semantics intact.
  */
@@ -146,6 +162,7 @@ typedef struct ttak_detachable_context {
     uint32_t flags;
     ttak_detach_status_t base_status;
     ttak_detachable_cache_t small_cache;
+    ttak_detachable_cache_t class_caches[TTAK_DETACHABLE_SIZE_CLASSES]; /**< Shared depots for 4 KiB..1 MiB buffers. */
     ttak_detachable_generation_row_t rows[TTAK_DETACHABLE_MATRIX_ROWS];
     ttak_detachable_quarantine_row_t quarantine;
     pthread_rwlock_t arena_lock;
@@ -170,11 +187,38 @@ typedef struct ttak_detachable_allocation {
     ttak_detachable_cache_t *cache;
 } ttak_detachable_allocation_t;
 
+/**
+ * @brief Front cache of large buffers owned by one thread.
+ *
+ * An explicit handle rather than hidden TLS: the owning thread passes it to
+ * ttak_detachable_mem_alloc_front() / ttak_detachable_mem_free_front(),
+ * which reuse buffers without taking the depot locks. It spills to and
+ * refills from the context depots, and must be flushed before the context
+ * is destroyed.
+ */
+typedef struct ttak_detachable_front {
+    ttak_detachable_context_t *ctx;
+    void *slots[TTAK_DETACHABLE_SIZE_CLASSES][TTAK_DETACHABLE_FRONT_SLOTS];
+    uint8_t count[TTAK_DETACHABLE_SIZE_CLASSES];
+    uint64_t hits;
+    uint64_t misses;
+} ttak_detachable_front_t;
+
 /**
  * @brief Initializes a detachable context with sane defaults.
  */
 void ttak_detachable_context_init(ttak_detachable_context_t *ctx, uint32_t flags);
 
+/**
+ * @brief Initializes a context that only its creating thread may use.
+ *
+ * Sets TTAK_ARENA_IS_SINGLE_THREAD (and drops TTAK_ARENA_USE_LOCKED_ACCESS),
+ * so allocation and free skip every lock and the flip quarantine. Epoch
+ * reclamation still applies when requested. Pool workers own one each; see
+ * ttak_worker_detachable_context().
+ */
+void ttak_detachable_context_init_confined(ttak_detachable_context_t *ctx, uint32_t flags);
+
 /**
  * @brief Destroys a detachable context and releases cached entries.
  */
@@ -205,6 +249,48 @@ ttak_detachable_allocation_t ttak_detachable_mem_alloc(ttak_detachable_context_t
  */
 void ttak_detachable_mem_free(ttak_detachable_context_t *ctx, ttak_detachable_allocation_t *alloc);
 
+/**
+ * @brief Binds a front cache to @p ctx (the default context when NULL).
+ */
+void ttak_detachable_front_init(ttak_detachable_front_t *front, ttak_detachable_context_t *ctx);
+
+/**
+ * @brief Returns every buffer held by @p front to its context depots.
+ */
+void ttak_detachable_front_flush(ttak_detachable_front_t *front);
+
+/**
+ * @brief Allocates like ttak_detachable_mem_alloc(), trying @p front first.
+ *
+ * @param front Front cache owned by the calling thread.
+ * @param size Requested bytes.
+ * @param epoch_hint Epoch hint recorded on a fresh allocation.
+ */
+ttak_detachable_allocation_t ttak_detachable_mem_alloc_front(ttak_detachable_front_t *front, size_t size, uint64_t epoch_hint);
+
+/**
+ * @brief Frees like ttak_detachable_mem_free(), keeping large buffers in @p front.
+ *
+ * @param front Front cache owned by the calling thread.
+ * @param alloc Allocation to release.
+ */
+void ttak_detachable_mem_free_front(ttak_detachable_front_t *front, ttak_detachable_allocation_t *alloc);
+
+/**
+ * @brief Releases every buffer parked in @p ctx's tiny-chunk cache and
+ *        size-class depots. A confined context may only be trimmed by its
+ *        owning thread.
+ *
+ * @return Bytes released (retired through EBR when the context uses it).
+ */
+size_t ttak_detachable_context_trim(ttak_detachable_context_t *ctx);
+
+/**
+ * @brief ttak_detachable_context_trim() on every live shared context;
+ *        confined contexts are skipped.
+ */
+size_t ttak_detachable_trim_all(void);
+
 #ifndef _WIN32
 /**
  * @brief Registers signal handlers that gracefully flush detachable arenas and exit.
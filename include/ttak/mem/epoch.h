@@ -2,33 +2,112 @@
 #define TTAK_MEM_EPOCH_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdatomic.h>
 #include <ttak/types/ttak_compiler.h>
+#include <ttak/stats/stats.h>
 
 #define TTAK_EPOCH_SESSIONS 3
 
+/** @brief Pointers held by one retire batch. */
+#define TTAK_EPOCH_BATCH_SIZE 64
+
+/** @brief Default number of sealed batches that makes a retire trigger ttak_epoch_reclaim(). */
+#define TTAK_EPOCH_RECLAIM_THRESHOLD 32
+
+/** @brief Upper bound (ns) of the printed reclaim duration histogram; slower passes are still bucketed. */
+#define TTAK_EPOCH_RECLAIM_HIST_MAX_NS 1000000ULL
+
 typedef struct ttak_retired_node {
     void *ptr;
     void (*cleanup)(void *);
     struct ttak_retired_node *next;
 } ttak_retired_node_t;
 
+/**
+ * @brief Cleanup invoked once for a whole batch retired with ttak_epoch_retire_bulk().
+ */
+typedef void (*ttak_epoch_bulk_cleanup_t)(void **ptrs, size_t count);
+
+/**
+ * @brief Fixed-size array of retired pointers reclaimed as a unit.
+ *
+ * A batch is filled by its owning thread without atomics, stamped with the
+ * global epoch when sealed, and freed once no reader can still hold an
+ * epoch at or before the stamp.
+ */
+typedef struct ttak_retire_batch {
+    struct ttak_retire_batch *next;         /**< Link in the retired or cached batch stack. */
+    unsigned int epoch;                     /**< Global epoch when the batch was sealed. */
+    uint32_t count;                         /**< Number of filled entries. */
+    ttak_epoch_bulk_cleanup_t bulk;         /**< Whole-batch cleanup, or NULL for per-entry cleanups. */
+    struct ttak_thread_state *owner;        /**< Thread whose backlog counters the batch is charged to. */
+    uint64_t bytes;                         /**< Bytes declared through ttak_epoch_retire_sized(). */
+    void *ptrs[TTAK_EPOCH_BATCH_SIZE];      /**< Retired pointers. */
+    void (*cleanups[TTAK_EPOCH_BATCH_SIZE])(void *); /**< Per-entry cleanups when @c bulk is NULL. */
+} ttak_retire_batch_t;
+
 typedef struct {
     unsigned int _Atomic global_epoch;
     ttak_retired_node_t * _Atomic retired_queues[TTAK_EPOCH_SESSIONS];
 } ttak_epoch_manager_t;
 
-typedef struct {
-    unsigned int _Atomic local_epoch;
+/**
+ * @brief Per-thread epoch state.
+ *
+ * The backlog is kept as two monotonic pairs so neither side needs a
+ * read-modify-write: the owner advances @c retired_*, the reclaimer
+ * (under its lock) advances @c reclaimed_*, and the difference is what
+ * the thread retired that has not been freed yet.
+ *
+ * States are stored back to back by logical id, one cache line each, so
+ * a thread pinning its epoch does not invalidate its neighbours' lines.
+ */
+typedef struct ttak_thread_state {
+    _Alignas(64) unsigned int _Atomic local_epoch;
     bool _Atomic active;
     uint32_t logical_tid;
+    ttak_retire_batch_t *open_batch;    /**< Batch receiving ttak_epoch_retire(); owned by the thread. */
+    ttak_retire_batch_t *open_bulk;     /**< Batch receiving ttak_epoch_retire_bulk(); owned by the thread. */
+    uint64_t _Atomic retired_ptrs;      /**< Pointers retired by this thread. */
+    uint64_t _Atomic retired_bytes;     /**< Bytes declared for those pointers. */
+    uint64_t _Atomic reclaimed_ptrs;    /**< Pointers of this thread already freed. */
+    uint64_t _Atomic reclaimed_bytes;   /**< Bytes of this thread already freed. */
 } ttak_thread_state_t;
 
+/**
+ * @brief Backlog of one registered thread, as seen by ttak_epoch_thread_stats().
+ */
+typedef struct {
+    uint32_t logical_tid;       /**< Logical thread id. */
+    bool active;                /**< True while the thread is inside a critical section. */
+    uint32_t epoch_lag;         /**< Global epoch minus the thread's pinned epoch; 0 when inactive. */
+    uint64_t pending_ptrs;      /**< Retired but not yet reclaimed pointers. */
+    uint64_t pending_bytes;     /**< Declared bytes of those pointers. */
+} ttak_epoch_thread_stats_t;
+
+/**
+ * @brief Process-wide EBR health, as filled by ttak_epoch_stats_snapshot().
+ */
+typedef struct {
+    uint32_t global_epoch;          /**< Current global epoch. */
+    uint32_t oldest_epoch_lag;      /**< Epochs the oldest pinned thread is behind; 0 if none is pinned. */
+    uint32_t registered_threads;    /**< Logical ids handed out: the most threads registered at once. */
+    uint32_t pinned_threads;        /**< Threads currently inside a critical section. */
+    uint64_t pending_batches;       /**< Sealed batches waiting for reclamation. */
+    uint64_t pending_ptrs;          /**< Retired but not yet reclaimed pointers, all threads. */
+    uint64_t pending_bytes;         /**< Declared bytes of those pointers. */
+    ttak_stats_snapshot_t reclaim_ns; /**< Durations of ttak_epoch_reclaim() passes, in ns. */
+} ttak_epoch_stats_t;
+
 extern ttak_epoch_manager_t g_epoch_mgr;
 
 /**
  * @brief Registers the current thread with the epoch manager.
+ *
+ * The thread gets the lowest logical id not held by another registered
+ * thread; ids come back when a thread deregisters or exits.
  */
 void ttak_epoch_register_thread(void);
 
@@ -86,14 +165,86 @@ TTAK_FORCE_INLINE void ttak_epoch_exit(void) {
 
 /**
  * @brief Retires a pointer for deferred reclamation.
+ *
+ * The pointer is appended to the calling thread's open batch; only a full
+ * batch touches shared state. Once TTAK_EPOCH_RECLAIM_THRESHOLD sealed
+ * batches are pending, the retiring thread attempts a reclaim itself.
+ *
  * @param ptr The pointer to retire.
  * @param cleanup Optional cleanup function (e.g., free).
  */
 void ttak_epoch_retire(void *ptr, void (*cleanup)(void *));
 
+/**
+ * @brief Retires a pointer and charges @p size bytes to the thread's backlog.
+ *
+ * Identical to ttak_epoch_retire() except that the size shows up in
+ * ttak_epoch_stats_snapshot() until the pointer is reclaimed.
+ *
+ * @param ptr The pointer to retire.
+ * @param size Bytes owned by @p ptr.
+ * @param cleanup Optional cleanup function.
+ */
+void ttak_epoch_retire_sized(void *ptr, size_t size, void (*cleanup)(void *));
+
+/**
+ * @brief Retires an array of pointers that share a whole-batch cleanup.
+ *
+ * The pointers are packed into batches of up to TTAK_EPOCH_BATCH_SIZE and
+ * @p cleanup runs once per batch with every pointer in it. Batching
+ * continues across calls while the same @p cleanup is used.
+ *
+ * @param ptrs Pointers to retire; NULL entries are skipped.
+ * @param count Number of entries in @p ptrs.
+ * @param cleanup Bulk cleanup function; must not be NULL.
+ */
+void ttak_epoch_retire_bulk(void *const *ptrs, size_t count, ttak_epoch_bulk_cleanup_t cleanup);
+
+/**
+ * @brief Seals the calling thread's partially filled batches.
+ *
+ * ttak_epoch_reclaim() and ttak_epoch_deregister_thread() flush the caller
+ * implicitly, and thread exit flushes registered threads; this is only
+ * needed to hand partial batches to a reclaim running on another thread.
+ */
+void ttak_epoch_flush(void);
+
+/**
+ * @brief Sets how many sealed batches trigger an automatic reclaim.
+ * @param batches Pending batch count; 0 disables automatic reclaim.
+ */
+void ttak_epoch_set_reclaim_threshold(size_t batches);
+
 /**
  * @brief Attempts to reclaim memory from safe epochs.
+ *
+ * A batch is freed once every active reader entered after it was sealed,
+ * so a pointer retired just before this call needs a second reclaim.
  */
 void ttak_epoch_reclaim(void);
 
+/**
+ * @brief Fills @p out with the current EBR counters.
+ *
+ * Reads only atomics and copies the reclaim histogram under its own
+ * spinlock, so it never blocks retirers, readers or a running reclaim
+ * and is cheap enough to scrape every second. Counters are sampled one
+ * by one and need not be mutually consistent.
+ *
+ * @param out Destination snapshot.
+ */
+void ttak_epoch_stats_snapshot(ttak_epoch_stats_t *out);
+
+/**
+ * @brief Copies the per-thread backlog of up to @p max logical thread ids.
+ *
+ * Entry i describes id i. Ids freed by exited threads are included with
+ * the backlog their last owner left pending.
+ *
+ * @param out Destination array, may be NULL when @p max is 0.
+ * @param max Capacity of @p out.
+ * @return Number of logical ids handed out (may exceed @p max).
+ */
+size_t ttak_epoch_thread_stats(ttak_epoch_thread_stats_t *out, size_t max);
+
 #endif // TTAK_MEM_EPOCH_H
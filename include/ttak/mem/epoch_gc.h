@@ -2,6 +2,7 @@
 #define TTAK_MEM_EPOCH_GC_H
 
 #include <ttak/mem_tree/mem_tree.h>
+#include <ttak/stats/stats.h>
 #include <pthread.h>
 #include <stdatomic.h>
 
@@ -11,6 +12,9 @@
  * Manages memory lifecycle using generational epochs.
  * Designed for periodic, non-blocking cleanup where the user triggers the cycle.
  * Traverses the heap tree to identify and free expired blocks without a global stop-the-world pause.
+ *
+ * Rotation is driven by the caller unless ttak_epoch_gc_start_reclaimer()
+ * hands it to a background thread.
  */
 typedef struct ttak_epoch_gc {
     ttak_mem_tree_t tree;             /**< Underlying memory tree tracking allocations. */
@@ -25,10 +29,38 @@ typedef struct ttak_epoch_gc {
     _Atomic uint64_t max_rotate_ns;   /**< Maximum backoff interval (ns) between auto rotations. */
     _Bool rotate_thread_started;      /**< Tracks whether the rotate thread was launched. */
     _Atomic uint32_t pending_hints;   /**< Bitmask of pending hints from the memory manager. */
+    ttak_stats_t rotate_stats;        /**< Durations of ttak_epoch_gc_rotate() passes, in ns. */
+    _Atomic size_t pressure_bytes;    /**< Bytes registered since the last rotation. */
+    _Atomic size_t pressure_threshold;/**< Registered bytes that wake the reclaimer; 0 while it is stopped. */
 } ttak_epoch_gc_t;
 
 typedef ttak_epoch_gc_t tt_epoch_gc_t;
 
+/** @brief Default registered-bytes threshold that wakes the background reclaimer (1MB). */
+#define TTAK_EPOCH_GC_DEFAULT_PRESSURE (1024U * 1024U)
+
+/**
+ * @brief Settings for ttak_epoch_gc_start_reclaimer().
+ */
+typedef struct {
+    uint64_t min_interval_ns;   /**< Interval while blocks keep being registered; 0 keeps the current value. */
+    uint64_t max_interval_ns;   /**< Interval the idle backoff grows to; 0 keeps the current value. */
+    size_t pressure_bytes;      /**< Registered bytes that force an immediate rotation; 0 disables. */
+    int cpu;                    /**< CPU the reclaimer is pinned to, or -1 for no pinning. */
+} ttak_epoch_gc_reclaimer_config_t;
+
+/** @brief Upper bound (ns) of the printed rotate duration histogram; slower passes are still bucketed. */
+#define TTAK_EPOCH_GC_HIST_MAX_NS 10000000ULL
+
+/**
+ * @brief Counters of one GC context, as filled by ttak_epoch_gc_stats_snapshot().
+ */
+typedef struct {
+    uint64_t epoch;             /**< Current GC epoch (number of rotations). */
+    uint64_t last_cleanup_ts;   /**< Tick (ms) of the last completed rotation. */
+    ttak_stats_snapshot_t rotate_ns; /**< Durations of rotation passes, in ns. */
+} ttak_epoch_gc_stats_t;
+
 /**
  * @brief Initializes the Epoch GC.
  * 
@@ -96,4 +128,39 @@ typedef enum {
  */
 void ttak_epoch_gc_hint(ttak_epoch_gc_t *gc, ttak_epoch_gc_hint_t hint);
 
+/**
+ * @brief Starts a background thread that rotates @p gc and reclaims epochs.
+ *
+ * The thread rotates every @c min_interval_ns while blocks are being
+ * registered, backs off towards @c max_interval_ns when idle, and is woken
+ * at once when @c pressure_bytes have been registered since the last
+ * rotation. Registering threads only pay an atomic add; crossing the
+ * threshold costs one condition-variable signal. Also clears manual mode.
+ *
+ * @param gc Pointer to the GC structure.
+ * @param config Reclaimer settings, or NULL for the defaults (unpinned, 1MB pressure).
+ * @return 0 on success, EALREADY if a reclaimer is running, or the error
+ *         from thread creation or CPU pinning.
+ */
+int ttak_epoch_gc_start_reclaimer(ttak_epoch_gc_t *gc, const ttak_epoch_gc_reclaimer_config_t *config);
+
+/**
+ * @brief Stops and joins the background reclaimer, if any.
+ *
+ * ttak_epoch_gc_destroy() stops it implicitly.
+ *
+ * @param gc Pointer to the GC structure.
+ */
+void ttak_epoch_gc_stop_reclaimer(ttak_epoch_gc_t *gc);
+
+/**
+ * @brief Copies the GC counters without blocking rotations.
+ *
+ * Combine with ttak_epoch_stats_snapshot() for the process-wide EBR backlog.
+ *
+ * @param gc Pointer to the GC structure.
+ * @param out Destination snapshot.
+ */
+void ttak_epoch_gc_stats_snapshot(ttak_epoch_gc_t *gc, ttak_epoch_gc_stats_t *out);
+
 #endif // TTAK_MEM_EPOCH_GC_H
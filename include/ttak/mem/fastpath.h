@@ -1,12 +1,13 @@
 /**
  * @file fastpath.h
- * @brief Architecture-aware memory primitives for TinyCC builds.
+ * @brief Architecture-aware memory primitives.
  *
- * Exposes streaming zero/copy helpers that fall back to plain C when the
- * target ISA is not covered or when a non-TinyCC compiler is driving the
- * build. The helpers retain memcpy/memset semantics (non-overlapping copy,
- * byte-exact zeroing) but are written so libttak can keep high throughput
- * even when TinyCC emits -O0 code.
+ * Exposes streaming zero/copy helpers with memcpy/memset semantics
+ * (non-overlapping copy, byte-exact zeroing). TinyCC builds use inline
+ * assembly so libttak keeps high throughput even when TinyCC emits -O0
+ * code. Other compilers inline memset/memcpy for small buffers and, for
+ * large ones, dispatch at runtime to non-temporal store kernels once the
+ * buffer exceeds a crossover calibrated on the running host.
  */
 
 #ifndef TTAK_MEM_FASTPATH_H
@@ -23,13 +24,73 @@ extern "C" {
 #if defined(__TINYC__)
 void ttak_mem_stream_zero(void *dst, size_t len);
 void ttak_mem_stream_copy(void *dst, const void *src, size_t len);
+
+static inline void ttak_mem_stream_copy_uncached(void *dst, const void *src, size_t len) {
+    ttak_mem_stream_copy(dst, src, len);
+}
 #else
+/**
+ * @brief Smallest request that may take a non-temporal kernel.
+ *
+ * Anything shorter stays on inline memset/memcpy without consulting the
+ * calibrated crossover.
+ */
+#define TTAK_MEM_STREAM_NT_MIN_BYTES (256U * 1024U)
+
+/**
+ * @brief Zeroes @p len bytes, streaming past the cache above the crossover.
+ */
+void ttak_mem_stream_zero_large(void *dst, size_t len);
+
+/**
+ * @brief Copies @p len non-overlapping bytes, streaming above the crossover.
+ */
+void ttak_mem_stream_copy_large(void *dst, const void *src, size_t len);
+
+/**
+ * @brief Copies @p len non-overlapping bytes with non-temporal stores
+ *        whenever the host has a kernel, whatever the crossover.
+ *
+ * For buffers below the crossover that the caller knows will next be read
+ * by another core, or not soon at all.
+ */
+void ttak_mem_stream_copy_uncached(void *dst, const void *src, size_t len);
+
+/**
+ * @brief Returns the size at which non-temporal stores take over.
+ *
+ * The first call picks the widest kernel the host supports (AVX-512, AVX2,
+ * SSE2 or NEON) and times it against memcpy to find the crossover.
+ * SIZE_MAX means streaming stores are never used.
+ */
+size_t ttak_mem_stream_nt_threshold(void);
+
+/**
+ * @brief Overrides the calibrated crossover; SIZE_MAX disables streaming.
+ *
+ * Values below TTAK_MEM_STREAM_NT_MIN_BYTES behave as that minimum.
+ */
+void ttak_mem_stream_set_nt_threshold(size_t bytes);
+
+/**
+ * @brief Names the selected kernel ("avx512", "avx2", "sse2", "neon" or "none").
+ */
+const char *ttak_mem_stream_kernel(void);
+
 static inline void ttak_mem_stream_zero(void *dst, size_t len) {
-    if (len) memset(dst, 0, len);
+    if (len >= TTAK_MEM_STREAM_NT_MIN_BYTES) {
+        ttak_mem_stream_zero_large(dst, len);
+    } else if (len) {
+        memset(dst, 0, len);
+    }
 }
 
 static inline void ttak_mem_stream_copy(void *dst, const void *src, size_t len) {
-    if (len) memcpy(dst, src, len);
+    if (len >= TTAK_MEM_STREAM_NT_MIN_BYTES) {
+        ttak_mem_stream_copy_large(dst, src, len);
+    } else if (len) {
+        memcpy(dst, src, len);
+    }
 }
 #endif
 
@@ -0,0 +1,145 @@
+/**
+ * @file governor.h
+ * @brief Sheds cached memory as the process nears its cgroup limit.
+ *
+ * The governor runs as the system usage sampler's post-sample hook. Each
+ * sample is classified by two inputs:
+ * - usage against the limit: memory.current against the lower of
+ *   memory.high and memory.max, or RSS against an explicit limit
+ * - memory PSI
+ * A sample at soft pressure, or above, triggers these steps:
+ * - reclaims safe EBR epochs
+ * - rotates or wakes the watched epoch GCs
+ * - reports pressure to the watched mem trees
+ * - drains the detachable caches of every shared context
+ * - calls the registered callbacks
+ * Hard pressure also runs ttak_mem_trim(). While pressure persists the
+ * steps repeat at most once per cooldown, so caches are shed before the
+ * kernel has to reclaim or OOM-kill.
+ */
+
+#ifndef TTAK_MEM_GOVERNOR_H
+#define TTAK_MEM_GOVERNOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/stats/system_usage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ttak_mem_tree;
+struct ttak_epoch_gc;
+
+/** Callbacks, trees and GCs each have this many slots. */
+#define TTAK_MEM_GOVERNOR_SLOTS 16
+
+typedef enum ttak_mem_pressure {
+    TTAK_MEM_PRESSURE_NONE = 0,
+    TTAK_MEM_PRESSURE_SOFT,     /**< Shed caches. */
+    TTAK_MEM_PRESSURE_HARD      /**< Shed everything that can go. */
+} ttak_mem_pressure_t;
+
+/**
+ * @brief Governor settings; zero fields select the defaults in brackets.
+ */
+typedef struct ttak_mem_governor_config {
+    uint64_t limit_bytes;   /**< Limit for RSS; 0 uses the cgroup's memory.high / memory.max. */
+    double soft_pct;        /**< Usage percent of the limit that is soft pressure [80]. */
+    double hard_pct;        /**< Usage percent of the limit that is hard pressure [92]. */
+    double psi_soft;        /**< Memory PSI "some" avg10 that is soft pressure [10]; negative ignores it. */
+    double psi_hard;        /**< Memory PSI "full" avg10 that is hard pressure [5]; negative ignores it. */
+    uint64_t cooldown_ns;   /**< Minimum gap between sheds at an unchanged level [250 ms]. */
+    uint32_t hz;            /**< Sampler rate if the governor has to start it [10]. */
+} ttak_mem_governor_config_t;
+
+/**
+ * @brief User shedding hook, called on the sampler thread.
+ *
+ * @return Bytes the callback released, for the governor's statistics.
+ */
+typedef size_t (*ttak_mem_pressure_fn)(ttak_mem_pressure_t level, const ttak_sys_snapshot_t *snap, void *arg);
+
+/**
+ * @brief Counters since the governor was first started.
+ */
+typedef struct ttak_mem_governor_stats {
+    ttak_mem_pressure_t level;  /**< Level of the latest sample. */
+    uint64_t usage_bytes;       /**< Usage of the latest sample. */
+    uint64_t limit_bytes;       /**< Limit in force; 0 when there is none. */
+    uint64_t sheds;             /**< Shedding passes run. */
+    uint64_t released_bytes;    /**< Bytes the passes reported releasing. */
+} ttak_mem_governor_stats_t;
+
+/**
+ * @brief Starts governing, or applies @p cfg to a running governor.
+ *
+ * Starts the system usage sampler unless it already runs, and takes over
+ * its post-sample hook.
+ *
+ * @param cfg Settings, or NULL for the defaults.
+ * @return 0 on success, -1 if the sampler cannot be started.
+ */
+int ttak_mem_governor_start(const ttak_mem_governor_config_t *cfg);
+
+/**
+ * @brief Removes the hook, and stops the sampler if the governor started it.
+ */
+void ttak_mem_governor_stop(void);
+
+/**
+ * @brief Level of the latest governed sample.
+ */
+ttak_mem_pressure_t ttak_mem_governor_level(void);
+
+/**
+ * @brief Classifies @p snap under the current settings without acting on it.
+ */
+ttak_mem_pressure_t ttak_mem_governor_classify(const ttak_sys_snapshot_t *snap);
+
+/**
+ * @brief Runs one shedding pass at @p level now, on the calling thread.
+ *
+ * @param snap Snapshot handed to the callbacks, or NULL for the latest.
+ * @return Bytes released.
+ */
+size_t ttak_mem_governor_shed(ttak_mem_pressure_t level, const ttak_sys_snapshot_t *snap);
+
+/**
+ * @brief Registers a shedding callback.
+ *
+ * @return 0 on success, -1 when every slot is taken.
+ */
+int ttak_mem_governor_add_callback(ttak_mem_pressure_fn fn, void *arg);
+
+/**
+ * @brief Unregisters a callback; returns once it is no longer running.
+ *        Must not be called from inside a callback.
+ */
+void ttak_mem_governor_remove_callback(ttak_mem_pressure_fn fn, void *arg);
+
+/**
+ * @brief Reports pressure to @p tree on every pass.
+ *
+ * @return 0 on success, -1 when every slot is taken.
+ */
+int ttak_mem_governor_watch_tree(struct ttak_mem_tree *tree);
+void ttak_mem_governor_unwatch_tree(struct ttak_mem_tree *tree);
+
+/**
+ * @brief Rotates @p gc on every pass, or wakes its reclaimer if it has one.
+ *
+ * @return 0 on success, -1 when every slot is taken.
+ */
+int ttak_mem_governor_watch_gc(struct ttak_epoch_gc *gc);
+void ttak_mem_governor_unwatch_gc(struct ttak_epoch_gc *gc);
+
+void ttak_mem_governor_stats(ttak_mem_governor_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_MEM_GOVERNOR_H */
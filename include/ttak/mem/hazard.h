@@ -0,0 +1,113 @@
+/**
+ * @file hazard.h
+ * @brief Hazard-pointer reclamation for structures whose readers may stall.
+ *
+ * Epoch-based reclamation lets one reader stuck inside ttak_epoch_enter()
+ * hold back every retirement in the process. Hazard pointers bound the
+ * damage instead: a reader publishes exactly the pointers it dereferences,
+ * and a retired pointer is freed as soon as no published slot matches it.
+ * A stalled reader pins at most TTAK_HAZARD_SLOTS objects, and each thread
+ * keeps at most a scan threshold's worth of unreclaimed retirements.
+ *
+ * Slots are used as a per-thread stack: ttak_hazard_protect() pushes and
+ * ttak_hazard_release() pops, mirroring nested enter/exit pairs.
+ */
+
+#ifndef TTAK_MEM_HAZARD_H
+#define TTAK_MEM_HAZARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <ttak/mem/epoch.h>
+
+/** @brief Hazard slots available to each thread. */
+#define TTAK_HAZARD_SLOTS 8
+
+/** @brief Minimum number of retired pointers a thread holds before scanning. */
+#define TTAK_HAZARD_SCAN_MIN 64
+
+/**
+ * @brief Reclamation scheme protecting a structure's readers.
+ */
+typedef enum {
+    TTAK_RECLAIM_EPOCH = 0, /**< Epoch-based reclamation (ttak_epoch_*). */
+    TTAK_RECLAIM_HAZARD     /**< Hazard pointers (ttak_hazard_*). */
+} ttak_reclaim_mode_t;
+
+/**
+ * @brief Claims a hazard record for the calling thread. Called lazily.
+ */
+void ttak_hazard_register_thread(void);
+
+/**
+ * @brief Releases the calling thread's record after a final scan.
+ *
+ * Retirements still protected by other threads are handed to the next
+ * thread that scans. Exiting threads deregister automatically.
+ */
+void ttak_hazard_deregister_thread(void);
+
+/**
+ * @brief Loads @p src and keeps the result safe from reclamation.
+ *
+ * Publishes the pointer in the next free slot and re-reads @p src until the
+ * published value is the current one.
+ *
+ * @param src Atomic location holding the pointer.
+ * @return The protected pointer (possibly NULL), or NULL if all slots are in use.
+ */
+void *ttak_hazard_protect(void * _Atomic *src);
+
+/**
+ * @brief Publishes a pointer the caller already knows to be live.
+ *
+ * @param ptr Pointer to protect.
+ * @return False if all slots are in use.
+ */
+bool ttak_hazard_publish(void *ptr);
+
+/**
+ * @brief Returns how many more slots the calling thread can protect or publish.
+ */
+size_t ttak_hazard_available(void);
+
+/**
+ * @brief Clears the most recently protected or published slot.
+ */
+void ttak_hazard_release(void);
+
+/**
+ * @brief Retires a pointer that has already been unlinked.
+ *
+ * @param ptr Pointer to retire.
+ * @param cleanup Optional cleanup function run once no hazard protects @p ptr.
+ */
+void ttak_hazard_retire(void *ptr, void (*cleanup)(void *));
+
+/**
+ * @brief Frees the calling thread's retirements that no hazard protects.
+ */
+void ttak_hazard_scan(void);
+
+/**
+ * @brief Returns the number of retirements the calling thread has not yet freed.
+ */
+size_t ttak_hazard_pending(void);
+
+/**
+ * @brief Retires @p ptr through the scheme selected for its structure.
+ *
+ * @param mode Reclamation scheme of the owning structure.
+ * @param ptr Pointer to retire.
+ * @param cleanup Optional cleanup function.
+ */
+static inline void ttak_reclaim_retire(ttak_reclaim_mode_t mode, void *ptr, void (*cleanup)(void *)) {
+    if (mode == TTAK_RECLAIM_HAZARD) {
+        ttak_hazard_retire(ptr, cleanup);
+    } else {
+        ttak_epoch_retire(ptr, cleanup);
+    }
+}
+
+#endif /* TTAK_MEM_HAZARD_H */
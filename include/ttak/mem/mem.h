@@ -37,6 +37,9 @@
 #endif
 #include <ttak/mem/epoch_gc.h>
 #include <ttak/types/ttak_compiler.h>
+#if defined(__ARM_FEATURE_CRC32) && defined(__aarch64__)
+#include <arm_acle.h>
+#endif
 #include <stdalign.h>
 #include <pthread.h>
 
@@ -113,10 +116,34 @@ typedef struct ttak_mem_header_t {
     uint64_t canary_end;                /**< Magic number for end of user data (in strict mode) */
     char     *tracking_log;             /**< Dynamic memory operation tracking log (JSON) */
     uint8_t  allocation_tier;           /**< Tier that performed the allocation */
+    uint32_t profile_site;              /**< Heap-profiler site tag; 0 when the block was not sampled */
     size_t   mapped_size;               /**< Total OS-mapped bytes (header + payload + canary) */
-    char     reserved[2];               /**< Explicit padding for header alignment */
+    uint8_t  access_mode;               /**< ttak_mem_access_accounting_t override; 0 follows the global mode */
+    char     reserved[1];               /**< Explicit padding for header alignment */
 } ttak_mem_header_t;
 
+/**
+ * @brief Magic number identifying a header-lite allocation.
+ */
+#define TTAK_LITE_MAGIC_NUMBER 0x54544C48
+
+/**
+ * @struct ttak_mem_lite_header_t
+ * @brief Compact 16-byte header used by ttak_mem_alloc_lite().
+ *
+ * Replaces the fortress header's per-allocation mutex with a single atomic
+ * state word. TTL and checksum are opt-in; when a TTL is requested the
+ * expiry tick is stored in a 16-byte prefix directly before this header.
+ * @c size and @c checksum come first because a freed pocket block reuses
+ * its first word as the freelist link; @c magic and @c state survive it.
+ */
+typedef struct ttak_mem_lite_header_t {
+    uint32_t size;                      /**< User-requested size in bytes */
+    uint32_t checksum;                  /**< Header checksum, or 0 when not requested */
+    uint32_t magic;                     /**< TTAK_LITE_MAGIC_NUMBER */
+    _Atomic uint32_t state;             /**< Atomic state word (live bit, tier, option bits) */
+} ttak_mem_lite_header_t;
+
 /**
  * @enum ttak_mem_flags_t
  * @brief Memory allocation behavior flags.
@@ -126,9 +153,23 @@ typedef enum {
     TTAK_MEM_HUGE_PAGES = (1 << 0),     /**< Try to use 2MB/1GB pages */
     TTAK_MEM_CACHE_ALIGNED = (1 << 1),  /**< Force 64-byte cache alignment */
     TTAK_MEM_STRICT_CHECK = (1 << 2),   /**< Enable strict boundary/canary checks */
-    TTAK_MEM_LOW_PRIORITY = (1 << 3)    /**< Reject if under memory pressure/high friction */
+    TTAK_MEM_LOW_PRIORITY = (1 << 3),   /**< Reject if under memory pressure/high friction */
+    TTAK_MEM_ACCESS_UNCOUNTED = (1 << 4), /**< ttak_mem_access() never writes @c access_count */
+    TTAK_MEM_ACCESS_SAMPLED = (1 << 5), /**< ttak_mem_access() counts 1 in N accesses, weighted by N */
+    TTAK_MEM_NUMA_NODE_MASK = (0xFF << 8) /**< Encoded NUMA node hint, see TTAK_MEM_NUMA_NODE() */
 } ttak_mem_flags_t;
 
+#define TTAK_MEM_NUMA_NODE_SHIFT 8
+
+/**
+ * @brief Builds a preferred-node hint that can be OR'ed into ttak_mem_flags_t.
+ *
+ * Honoured by the OS-backed VMA and large tiers; pocket blocks share pages
+ * across callers and ignore it. Nodes 0..254 are representable.
+ */
+#define TTAK_MEM_NUMA_NODE(node) \
+    ((ttak_mem_flags_t)((((unsigned)(node) + 1u) & 0xFFu) << TTAK_MEM_NUMA_NODE_SHIFT))
+
 /**
  * @brief Unified memory allocation with lifecycle management.
  * @param size Number of bytes requested.
@@ -205,6 +246,35 @@ void ttak_mem_free(void *ptr);
  */
 void ttak_mem_unuse(void *ptr, ttak_owner_t *owner);
 
+/**
+ * @brief Allocates @p count same-sized blocks in one call.
+ *
+ * Each block behaves exactly like one from ttak_mem_alloc_safe() with
+ * default access flags. For roots, the registry update and mem_tree
+ * insertion happen once for the whole batch instead of once per block.
+ *
+ * @param out Receives @p count user pointers.
+ * @param count Number of blocks to allocate.
+ * @param size Bytes per block.
+ * @param lifetime_ticks Lifetime hint in ticks.
+ * @param now_tick Current timestamp in ticks.
+ * @param is_root Whether the blocks are root nodes.
+ * @param flags Allocation behavior flags.
+ * @return @p count on success, 0 on failure (nothing stays allocated).
+ */
+size_t ttak_mem_alloc_bulk(void **out, size_t count, size_t size, uint64_t lifetime_ticks, uint64_t now_tick, bool is_root, ttak_mem_flags_t flags);
+
+/**
+ * @brief Frees a batch of blocks, unregistering roots in one transaction.
+ *
+ * NULL and already-freed entries are skipped. Entries in @p ptrs may be
+ * overwritten during the call; the array must not be reused afterwards.
+ *
+ * @param ptrs Blocks to free.
+ * @param count Number of entries in @p ptrs.
+ */
+void ttak_mem_free_bulk(void **ptrs, size_t count);
+
 /**
  * @brief Duplicates a memory block with lifecycle management.
  * @param src Source memory block.
@@ -223,6 +293,35 @@ void *ttak_mem_dup_safe(const void *src, size_t size, uint64_t lifetime_ticks, u
  */
 void ttak_mem_free(void *ptr);
 
+/**
+ * @brief Allocates memory behind a compact 16-byte header.
+ *
+ * Intended for large populations of small objects where the fortress
+ * header would dominate RSS. The block carries no mutex, no mem_tree
+ * registration and no tracing; it must be released with ttak_mem_free_lite().
+ *
+ * @param size Number of bytes requested (must fit in 32 bits).
+ * @param lifetime_ticks Lifetime hint in ticks; __TTAK_UNSAFE_MEM_FOREVER__ skips TTL storage.
+ * @param now_tick Current timestamp in ticks.
+ * @param flags TTAK_MEM_STRICT_CHECK enables the header checksum; other flags are ignored.
+ * @return Pointer to zeroed user memory (16-byte aligned), or NULL on failure.
+ */
+void *ttak_mem_alloc_lite(size_t size, uint64_t lifetime_ticks, uint64_t now_tick, ttak_mem_flags_t flags);
+
+/**
+ * @brief Validates a header-lite block and its optional TTL.
+ * @param ptr Pointer returned by ttak_mem_alloc_lite().
+ * @param now_tick Current timestamp in ticks.
+ * @return @p ptr if live and unexpired, otherwise NULL.
+ */
+void *ttak_mem_access_lite(void *ptr, uint64_t now_tick);
+
+/**
+ * @brief Frees a header-lite block. Double frees are ignored.
+ * @param ptr Pointer returned by ttak_mem_alloc_lite().
+ */
+void ttak_mem_free_lite(void *ptr);
+
 /**
  * @brief Frees a memory block and clears the caller's pointer.
  *
@@ -234,6 +333,53 @@ void ttak_mem_free(void *ptr);
  */
 void ttak_mem_freep(void **ptr);
 
+/**
+ * @brief How ttak_mem_access() maintains a header's @c access_count.
+ *
+ * Counting every access turns read-only traffic into writes to the header
+ * cache line, which readers on other cores then keep stealing from each
+ * other. Sampling keeps the count's expected value with one write per
+ * sample period; uncounted blocks are never written. Validation (magic,
+ * freed, TTL) stays read-only in every mode.
+ */
+typedef enum {
+    TTAK_MEM_ACCESS_COUNT_INHERIT = 0,  /**< Per block only: follow the global mode. */
+    TTAK_MEM_ACCESS_COUNT_ALL = 1,      /**< One atomic add per access (default). */
+    TTAK_MEM_ACCESS_COUNT_SAMPLED = 2,  /**< One add of N per N accesses on each thread. */
+    TTAK_MEM_ACCESS_COUNT_OFF = 3       /**< No writes. */
+} ttak_mem_access_accounting_t;
+
+/** Global accounting mode read by the inline accessor; set with ttak_mem_set_access_accounting(). */
+extern volatile uint32_t ttak_mem_access_mode_global;
+
+/**
+ * @brief Selects the accounting mode of blocks allocated without an access flag.
+ *
+ * @param mode TTAK_MEM_ACCESS_COUNT_ALL, _SAMPLED or _OFF; INHERIT means ALL.
+ * @param sample_period N for the sampled mode, rounded up to a power of two;
+ *        0 keeps the current period (64 by default).
+ */
+void ttak_mem_set_access_accounting(ttak_mem_access_accounting_t mode, uint32_t sample_period);
+
+/**
+ * @brief Sampled-mode slow path: counts this access once per sample period.
+ *
+ * The period is tracked per thread, so skipped accesses write nothing shared.
+ */
+void ttak_mem_access_sample(ttak_mem_header_t *header);
+
+/**
+ * @brief Applies the block's accounting mode to one successful access.
+ */
+static inline void ttak_mem_access_note(ttak_mem_header_t *header) {
+    uint32_t mode = header->access_mode ? header->access_mode : ttak_mem_access_mode_global;
+    if (TTAK_LIKELY(mode <= TTAK_MEM_ACCESS_COUNT_ALL)) {
+        TTAK_ATOMIC_FETCH_ADD_U64(&header->access_count, 1ULL);
+    } else if (mode == TTAK_MEM_ACCESS_COUNT_SAMPLED) {
+        ttak_mem_access_sample(header);
+    }
+}
+
 /**
  * @brief Safe accessor implemented in the library for ABI-stable builds.
  *
@@ -280,7 +426,7 @@ static inline void *ttak_mem_access(void *ptr, uint64_t now_tick) {
     if (header->expires_tick != __TTAK_UNSAFE_MEM_FOREVER__ && now_tick > header->expires_tick) return NULL;
     if (!header->allow_direct_access) return NULL;
 
-    TTAK_ATOMIC_FETCH_ADD_U64(&header->access_count, 1ULL);
+    ttak_mem_access_note(header);
     return ptr;
 }
 #endif
@@ -327,12 +473,49 @@ void ttak_mem_set_trace(int enable);
  */
 int ttak_mem_is_trace_enabled(void);
 
+/**
+ * @brief Bytes currently allocated through the ttak allocator.
+ */
+uint64_t ttak_mem_get_usage(void);
+
+/**
+ * @brief Returns cached allocator memory to the kernel.
+ *
+ * Unmaps orphaned pocket pages, releases free region pages on static
+ * builds and, with glibc, trims the malloc heap. Live blocks are untouched.
+ *
+ * @return Bytes released, as far as they can be counted.
+ */
+size_t ttak_mem_trim(void);
+
 /**
  * @brief Calculates a 32-bit checksum for the memory header.
+ *
+ * Builds with the SSE4.2 or ARMv8 CRC32 instructions enabled fold the
+ * fields with crc32c, six instructions that catch multi-bit damage an XOR
+ * fold cancels out. Other builds use the XOR fold.
+ *
  * @param h Pointer to the header.
  * @return Calculated checksum.
  */
 static inline uint32_t ttak_calc_header_checksum(const ttak_mem_header_t *h) {
+#if (defined(__SSE4_2__) && defined(__x86_64__) && !defined(__TINYC__)) || \
+    (defined(__ARM_FEATURE_CRC32) && defined(__aarch64__))
+    uint64_t flags = (uint64_t)h->magic | ((uint64_t)h->allocation_tier << 32) |
+                     ((uint64_t)h->should_join << 40) | ((uint64_t)h->strict_check << 48) |
+                     ((uint64_t)h->is_root << 56);
+    const uint64_t words[6] = { flags, h->created_tick, h->expires_tick, (uint64_t)h->size,
+                                h->canary_start, h->canary_end };
+    uint64_t crc = 0xffffffffu;
+    for (int i = 0; i < 6; i++) {
+#if defined(__SSE4_2__) && defined(__x86_64__)
+        crc = __builtin_ia32_crc32di(crc, words[i]);
+#else
+        crc = __crc32cd((uint32_t)crc, words[i]);
+#endif
+    }
+    return ~(uint32_t)crc;
+#else
     uint32_t sum1 = h->magic;
     uint32_t sum2 = (uint32_t)h->created_tick;
     sum1 ^= (uint32_t)(h->created_tick >> 32);
@@ -351,6 +534,7 @@ static inline uint32_t ttak_calc_header_checksum(const ttak_mem_header_t *h) {
     sum2 ^= (uint32_t)(h->canary_end >> 32);
     sum1 ^= (uint32_t)h->allocation_tier;
     return sum1 ^ sum2;
+#endif
 }
 
 /* Convenience type alias for lifecycle objects */
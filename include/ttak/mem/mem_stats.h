@@ -0,0 +1,100 @@
+/**
+ * @file mem_stats.h
+ * @brief Per-tier memory telemetry and fragmentation snapshots.
+ *
+ * Every fortress and lite allocation is credited to the tier that served
+ * it. A snapshot reads those counters and walks each tier's free lists, so
+ * it reports both how much memory is live and how badly the reserved
+ * remainder is fragmented. Rates are derived from two snapshots taken by
+ * the caller; the library keeps no history of its own.
+ */
+
+#ifndef TTAK_MEM_STATS_H
+#define TTAK_MEM_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <ttak/phys/mem/buddy.h>
+
+/** @brief Pocket size classes reported per snapshot. */
+#define TTAK_MEM_STATS_POCKET_BINS 7U
+
+/** @brief Region free-list bins reported for the VMA and general tiers. */
+#define TTAK_MEM_STATS_REGION_BINS 96U
+
+/**
+ * @brief Allocation tiers covered by a snapshot.
+ */
+typedef enum {
+    TTAK_MEM_STATS_TIER_POCKET = 0, /**< Thread-local pockets (small objects) */
+    TTAK_MEM_STATS_TIER_VMA,        /**< Medium objects */
+    TTAK_MEM_STATS_TIER_BUDDY,      /**< Buddy pool (embedded builds) */
+    TTAK_MEM_STATS_TIER_GENERAL,    /**< Large objects and lite fallbacks */
+    TTAK_MEM_STATS_TIER_COUNT
+} ttak_mem_stats_tier_t;
+
+/**
+ * @brief Counters and fragmentation figures for one tier.
+ */
+typedef struct ttak_mem_tier_stats {
+    uint64_t live_bytes;        /**< Bytes in live blocks, including headers */
+    uint64_t reserved_bytes;    /**< Bytes the tier holds from the OS or its pool */
+    uint64_t allocs;            /**< Allocations since start-up */
+    uint64_t frees;             /**< Frees since start-up */
+    double alloc_rate;          /**< Allocations per second since the previous snapshot */
+    double free_rate;           /**< Frees per second since the previous snapshot */
+    size_t free_blocks;         /**< Blocks on the tier's free lists */
+    size_t largest_free_block;  /**< Largest contiguous free block in bytes, 0 if none */
+} ttak_mem_tier_stats_t;
+
+/**
+ * @brief Point-in-time view of every tier.
+ *
+ * Per-bin arrays are indexed by pocket size class, region bin or buddy
+ * order. Bins a build does not use stay zero: OS-managed builds map VMA
+ * and general blocks individually and keep no region free lists.
+ */
+typedef struct ttak_mem_stats {
+    uint64_t timestamp_ns;                                          /**< Monotonic time of the snapshot */
+    uint64_t total_live_bytes;                                      /**< Sum of live bytes across tiers */
+    ttak_mem_tier_stats_t tiers[TTAK_MEM_STATS_TIER_COUNT];         /**< Per-tier figures */
+    size_t pocket_free_blocks[TTAK_MEM_STATS_POCKET_BINS];          /**< Free pocket slots per size class */
+    size_t vma_free_blocks[TTAK_MEM_STATS_REGION_BINS];             /**< VMA region free-list lengths */
+    size_t general_free_blocks[TTAK_MEM_STATS_REGION_BINS];         /**< Large region free-list lengths */
+    size_t buddy_free_blocks[TTAK_MEM_BUDDY_ORDER_COUNT];           /**< Buddy free-list lengths per order */
+} ttak_mem_stats_t;
+
+/**
+ * @brief Captures the current telemetry of every tier.
+ *
+ * Counters are read without stopping allocators, so figures from different
+ * tiers may be a few operations apart. Free lists are walked under each
+ * tier's lock; pocket slots are derived from page and live-block counts.
+ *
+ * @param out Receives the snapshot.
+ * @param prev Earlier snapshot used for rates, or NULL to leave them zero.
+ */
+void ttak_mem_stats_snapshot(ttak_mem_stats_t *out, const ttak_mem_stats_t *prev);
+
+/**
+ * @brief Returns the fraction of reserved bytes a tier cannot hand out as one block.
+ *
+ * Computed as 1 - largest_free_block / (reserved_bytes - live_bytes).
+ *
+ * @return Value in [0, 1]; 0 when the tier has no free bytes.
+ */
+double ttak_mem_stats_fragmentation(const ttak_mem_tier_stats_t *tier);
+
+/**
+ * @brief Writes a human-readable fragmentation report.
+ *
+ * One line per tier followed by the non-empty free-list bins.
+ *
+ * @param stats Snapshot to format.
+ * @param out Destination stream.
+ * @return 0 on success, -1 on a write error or NULL argument.
+ */
+int ttak_mem_stats_write_report(const ttak_mem_stats_t *stats, FILE *out);
+
+#endif /* TTAK_MEM_STATS_H */
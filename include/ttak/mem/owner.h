@@ -8,6 +8,21 @@
 
 /* Forward declaration; full typedef lives in <ttak/mem/mem.h> to avoid cycles. */
 struct ttak_owner;
+/* Slot table keyed by interned name; defined in owner.c. */
+struct ttak_owner_slots;
+
+/**
+ * @brief Interned name handle.
+ *
+ * Names are interned once per process; the handle stays valid for the
+ * lifetime of the program and is shared by every owner.
+ */
+typedef uint32_t ttak_owner_name_t;
+
+/**
+ * @brief Handle value that never names anything.
+ */
+#define TTAK_OWNER_NAME_NONE ((ttak_owner_name_t)0)
 
 /**
  * @brief Sentinel indicating that a memory pointer has no owning context.
@@ -40,9 +55,9 @@ typedef enum {
  */
 struct ttak_owner {
     uint32_t id;                /**< Unique ID for bitmap tracking. */
-    ttak_map_t *resources;      /**< Map storing owned resources (isolated variables). */
-    ttak_map_t *functions;      /**< Map storing registered functions. */
-    ttak_rwlock_t lock;         /**< RWLock for thread-safe access to the owner's state. */
+    struct ttak_owner_slots *_Atomic resources; /**< Owned resources (isolated variables), keyed by name handle. */
+    struct ttak_owner_slots *_Atomic functions; /**< Registered functions, keyed by name handle. */
+    ttak_rwlock_t lock;         /**< Serialises writers; lookups and execute never take it. */
     uint64_t creation_ts;       /**< Timestamp when this owner was created. */
     uint32_t policy_flags;      /**< Safety policy bitmask. */
 };
@@ -50,6 +65,25 @@ struct ttak_owner {
 typedef struct ttak_owner ttak_owner_t;
 typedef ttak_owner_t tt_owner_t;
 
+/**
+ * @brief Interns @p name and returns its handle.
+ *
+ * The first call for a name allocates its handle; later calls only hash and
+ * compare. Resolve hot names once and use the *_id entry points afterwards.
+ *
+ * @param name NUL-terminated name.
+ * @return Handle for @p name, or TTAK_OWNER_NAME_NONE on failure.
+ */
+ttak_owner_name_t ttak_owner_intern(const char *name);
+
+/**
+ * @brief Looks up the handle for @p name without interning it.
+ *
+ * @param name NUL-terminated name.
+ * @return Handle for @p name, or TTAK_OWNER_NAME_NONE if it was never interned.
+ */
+ttak_owner_name_t ttak_owner_name_find(const char *name);
+
 /**
  * @brief Creates a new Owner context.
  * 
@@ -77,6 +111,11 @@ void ttak_owner_destroy(ttak_owner_t *owner);
  */
 bool ttak_owner_register_func(ttak_owner_t *owner, const char *name, ttak_owner_func_t func);
 
+/**
+ * @brief Registers a function under an interned name handle.
+ */
+bool ttak_owner_register_func_id(ttak_owner_t *owner, ttak_owner_name_t name, ttak_owner_func_t func);
+
 /**
  * @brief Registers a resource (variable) into the owner's isolated context.
  * 
@@ -87,6 +126,28 @@ bool ttak_owner_register_func(ttak_owner_t *owner, const char *name, ttak_owner_
  */
 bool ttak_owner_register_resource(ttak_owner_t *owner, const char *name, void *data);
 
+/**
+ * @brief Registers a resource under an interned name handle.
+ */
+bool ttak_owner_register_resource_id(ttak_owner_t *owner, ttak_owner_name_t name, void *data);
+
+/**
+ * @brief Looks up a registered resource without taking the owner lock.
+ *
+ * @param owner The owner context.
+ * @param name  Interned resource name.
+ * @param out   Receives the resource pointer on success; may be NULL.
+ * @return true if the resource is registered.
+ */
+bool ttak_owner_lookup_resource(ttak_owner_t *owner, ttak_owner_name_t name, void **out);
+
+/**
+ * @brief Drops whichever resource entry currently points at @p data.
+ *
+ * @return true if an entry was removed.
+ */
+bool ttak_owner_forget_data(ttak_owner_t *owner, const void *data);
+
 /**
  * @brief Transfers a resource from one owner to another.
  */
@@ -103,4 +164,18 @@ bool ttak_owner_transfer_resource(ttak_owner_t *from, ttak_owner_t *to, const ch
  */
 bool ttak_owner_execute(ttak_owner_t *owner, const char *func_name, const char *resource_name, void *args);
 
+/**
+ * @brief Executes a registered function by handle.
+ *
+ * Lookups are lock-free: readers walk the owner's slot tables under an
+ * epoch and never contend with each other or with registrations.
+ *
+ * @param owner    The owner context.
+ * @param func     Interned function name.
+ * @param resource Interned resource name, or TTAK_OWNER_NAME_NONE.
+ * @param args     Runtime arguments to pass to the function.
+ * @return true if the function was found and run.
+ */
+bool ttak_owner_execute_id(ttak_owner_t *owner, ttak_owner_name_t func, ttak_owner_name_t resource, void *args);
+
 #endif // TTAK_MEM_OWNER_H
@@ -0,0 +1,99 @@
+/**
+ * @file profile.h
+ * @brief Sampling heap profiler for the fortress allocation path.
+ *
+ * When enabled, roughly one in every @c sample_interval allocated bytes
+ * triggers a stack capture inside ttak_mem_alloc_safe(). Samples are
+ * aggregated by call stack, allocation tier and lifetime class; frees of
+ * sampled blocks are credited back so the profile reflects live memory.
+ * Sample gaps are drawn from an exponential distribution, which keeps the
+ * result unbiased and lets pprof rescale it.
+ */
+
+#ifndef TTAK_MEM_PROFILE_H
+#define TTAK_MEM_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** @brief Maximum number of frames recorded per sample. */
+#define TTAK_MEM_PROFILE_MAX_DEPTH 32
+
+/** @brief Maximum number of distinct (stack, tier, lifetime) sites tracked. */
+#define TTAK_MEM_PROFILE_MAX_SITES 1024
+
+/**
+ * @brief Lifetime buckets used to aggregate samples.
+ */
+typedef enum {
+    TTAK_MEM_LIFETIME_SHORT = 0,    /**< Lifetime under one second */
+    TTAK_MEM_LIFETIME_MEDIUM,       /**< Lifetime under one minute */
+    TTAK_MEM_LIFETIME_LONG,         /**< Finite lifetime of a minute or more */
+    TTAK_MEM_LIFETIME_FOREVER,      /**< __TTAK_UNSAFE_MEM_FOREVER__ */
+    TTAK_MEM_LIFETIME_CLASS_COUNT
+} ttak_mem_lifetime_class_t;
+
+/**
+ * @brief Aggregate counters for one profiled site, as raw (unscaled) samples.
+ */
+typedef struct ttak_mem_profile_site_stats {
+    uint64_t alloc_count;   /**< Sampled allocations */
+    uint64_t alloc_bytes;   /**< Bytes of sampled allocations */
+    uint64_t inuse_count;   /**< Sampled allocations not yet freed */
+    uint64_t inuse_bytes;   /**< Bytes of sampled allocations not yet freed */
+} ttak_mem_profile_site_stats_t;
+
+/**
+ * @brief Enables sampling with the given mean interval in bytes.
+ *
+ * Restarting with a different interval keeps existing samples; call
+ * ttak_mem_profile_reset() first for a clean profile.
+ *
+ * @param sample_interval Mean bytes between samples; 0 disables sampling.
+ */
+void ttak_mem_profile_start(size_t sample_interval);
+
+/**
+ * @brief Disables sampling. Collected samples stay available for writing.
+ */
+void ttak_mem_profile_stop(void);
+
+/**
+ * @brief Returns the active sampling interval, or 0 when disabled.
+ */
+size_t ttak_mem_profile_interval(void);
+
+/**
+ * @brief Drops all collected samples.
+ *
+ * Blocks sampled before the reset are no longer credited on free.
+ */
+void ttak_mem_profile_reset(void);
+
+/**
+ * @brief Sums the raw sample counters of every site.
+ * @param out Receives the totals.
+ * @return Number of distinct sites recorded.
+ */
+size_t ttak_mem_profile_totals(ttak_mem_profile_site_stats_t *out);
+
+/**
+ * @brief Writes the profile in the legacy pprof heap format (heap_v2).
+ *
+ * The output can be fed directly to `pprof <binary> <file>`. On Linux the
+ * process memory map is appended so pprof can symbolize shared objects.
+ *
+ * @param out Destination stream.
+ * @return 0 on success, -1 on invalid arguments or write failure.
+ */
+int ttak_mem_profile_write_pprof(FILE *out);
+
+/**
+ * @brief Writes a human-readable per-site summary including tier and lifetime.
+ * @param out Destination stream.
+ * @return 0 on success, -1 on invalid arguments or write failure.
+ */
+int ttak_mem_profile_write_summary(FILE *out);
+
+#endif /* TTAK_MEM_PROFILE_H */
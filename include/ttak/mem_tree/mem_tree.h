@@ -5,16 +5,39 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdatomic.h>
+#include <stdalign.h>
 #include <pthread.h>
+#include <ttak/sync/spinlock.h>
 
 typedef struct ttak_mem_tree ttak_mem_tree_t;
+struct ttak_mem_node_list;
+struct ttak_mem_node_slab;
+struct ttak_mem_tree_index;
+
+/** @brief log2 of the number of timing-wheel slots. */
+#define TTAK_MEM_TREE_WHEEL_BITS 9
+/** @brief Number of timing-wheel slots. */
+#define TTAK_MEM_TREE_WHEEL_SLOTS (1u << TTAK_MEM_TREE_WHEEL_BITS)
+/** @brief log2 of the ticks covered by one wheel slot (~67 ms of nanosecond ticks). */
+#define TTAK_MEM_TREE_WHEEL_SHIFT 26
+/** @brief Nodes examined per tree-lock hold during a sweep. */
+#define TTAK_MEM_TREE_SWEEP_CHUNK 256
+/** @brief Per-wakeup sweep budget used by the background cleanup thread. */
+#define TTAK_MEM_TREE_DEFAULT_BUDGET 4096
+/** @brief Nodes carved from each slab chunk. */
+#define TTAK_MEM_TREE_SLAB_NODES 256
+/** @brief Number of insert/remove shards per tree (power of two). */
+#ifndef TTAK_MEM_TREE_SHARDS
+#define TTAK_MEM_TREE_SHARDS 64
+#endif
 
 /**
  * @brief Represents a node in the generic heap tree, tracking a dynamically allocated memory block.
  *
  * Each node stores metadata about a memory allocation, including its pointer, size,
- * expiration time, and reference count. It also includes flags for managing its
- * lifecycle within the heap tree and a mutex for thread-safe access.
+ * expiration time, and reference count. Nodes are carved from per-tree slabs and
+ * carry no lock of their own: the reference count is atomic and the links are
+ * guarded by the tree lock.
  */
 typedef struct ttak_mem_node {
     void *ptr;                      /**< Pointer to the actual memory block. */
@@ -22,12 +45,42 @@ typedef struct ttak_mem_node {
     uint64_t expires_tick;          /**< Monotonic tick when this memory block should expire. */
     _Atomic uint32_t ref_count;     /**< Atomic count of references to this node. */
     _Bool is_root;                  /**< True if this node is referenced externally (not by another heap node). */
-    pthread_mutex_t lock;           /**< Mutex for thread-safe access to this node's metadata. */
-    struct ttak_mem_node *next;    /**< Pointer to the next node in the mem tree's internal list. */
-    struct ttak_mem_node *prev;    /**< Pointer to the previous node in the mem tree's internal list. */
+    struct ttak_mem_node *next;    /**< Next node in the same expiry bucket. */
+    struct ttak_mem_node *prev;    /**< Previous node in the same expiry bucket. */
+    struct ttak_mem_node *hnext;   /**< Next node on the slab free list while unused. */
+    struct ttak_mem_node_list *bucket; /**< Expiry bucket or shard inbox currently holding this node. */
     ttak_mem_tree_t *tree;         /**< Pointer back to the parent mem tree. */
+    _Bool filed;                    /**< Moved from its shard inbox into an expiry bucket; guarded by the shard lock. */
+    _Bool detached;                 /**< Removed while filed; the next drain unlinks and recycles it. */
 } ttak_mem_node_t;
 
+/**
+ * @brief Doubly-linked FIFO of nodes sharing an expiry bucket.
+ */
+typedef struct ttak_mem_node_list {
+    ttak_mem_node_t *head;          /**< Oldest node in the bucket. */
+    ttak_mem_node_t *tail;          /**< Newest node in the bucket. */
+    size_t count;                   /**< Number of nodes in the bucket. */
+} ttak_mem_node_list_t;
+
+/**
+ * @brief One address slice of a tree's insert/remove path.
+ *
+ * Adds and removes only take the lock of the shard their block hashes to.
+ * New nodes wait on the shard inbox, and nodes removed after being filed
+ * wait on the detached list, until a sweep drains them into or out of the
+ * expiry buckets under the tree lock. Cache-line aligned so neighbouring
+ * shard locks never false-share.
+ */
+typedef struct ttak_mem_tree_shard {
+    alignas(64) pthread_mutex_t lock;          /**< Guards the fields below and the nodes' filed/detached flags. */
+    struct ttak_mem_tree_index *_Atomic index; /**< Pointer index over the shard's nodes; read without the lock. */
+    struct ttak_mem_tree_index *index_stale;   /**< Tables replaced by a rebuild, retired once the lock is dropped. */
+    ttak_mem_node_list_t inbox;                /**< Nodes added since the last drain. */
+    ttak_mem_node_t *detached;                 /**< Filed nodes removed since the last drain, linked through @c hnext. */
+    size_t node_count;                         /**< Number of tracked nodes in this shard. */
+} ttak_mem_tree_shard_t;
+
 /**
  * @brief Manages the collection of dynamically allocated memory blocks as a mem tree.
  *
@@ -35,9 +88,32 @@ typedef struct ttak_mem_node {
  * their interdependencies (via reference counts), and their lifetimes. It supports
  * automatic cleanup of expired or unreferenced blocks and allows for manual control
  * over the cleanup process.
+ *
+ * Nodes are filed by @c expires_tick into a timing wheel: one slot per
+ * 2^TTAK_MEM_TREE_WHEEL_SHIFT ticks over a horizon of TTAK_MEM_TREE_WHEEL_SLOTS
+ * slots, with an overflow list beyond the horizon and a separate list for
+ * nodes that never expire. A sweep only touches slots whose time has come,
+ * so its cost follows the number of expiring nodes, not the number of live
+ * ones. Adds and removes go through TTAK_MEM_TREE_SHARDS address shards,
+ * hashed like the pointer registry in mem.c, and never take the tree lock;
+ * a sweep drains the shards into the wheel first. Each shard keeps an
+ * open-addressed pointer index, so lookups and removals are O(1), and
+ * ttak_mem_tree_find_node() probes it lock-free under the epoch. Node storage comes
+ * from slabs of TTAK_MEM_TREE_SLAB_NODES nodes that are recycled through a
+ * free list and only returned to the system by ttak_mem_tree_destroy().
  */
 struct ttak_mem_tree {
-    ttak_mem_node_t *head;             /**< Head of the linked list of all tracked mem nodes. */
+    ttak_mem_node_list_t wheel[TTAK_MEM_TREE_WHEEL_SLOTS]; /**< Future expiries within the horizon. */
+    ttak_mem_node_list_t overflow;      /**< Expiries beyond the wheel horizon. */
+    ttak_mem_node_list_t forever;       /**< Nodes with __TTAK_UNSAFE_MEM_FOREVER__ lifetimes. */
+    ttak_mem_node_list_t due;           /**< Nodes whose slot has been reached; candidates for release. */
+    uint64_t wheel_cursor;              /**< Absolute slot number of the next slot to sweep. */
+    uint64_t overflow_rescan;           /**< Cursor position at which the overflow list is re-filed. */
+    ttak_mem_tree_shard_t shards[TTAK_MEM_TREE_SHARDS]; /**< Insert/remove path, split by block address. */
+    struct ttak_mem_node_slab *slabs;   /**< Slab chunks backing every node of this tree. */
+    ttak_mem_node_t *node_free;         /**< LIFO free list of unused slab nodes. */
+    size_t slab_count;                  /**< Number of slab chunks allocated. */
+    ttak_spin_t slab_lock;              /**< Spinlock protecting the slab list and free list. */
     pthread_mutex_t lock;               /**< Mutex for thread-safe access to the mem tree structure. */
     pthread_cond_t cond;                /**< Condition variable for immediate cleanup wakeup. */
     _Atomic uint64_t max_cleanup_interval_ns; /**< Maximum interval in nanoseconds for automatic cleanup (default 120s). */
@@ -46,6 +122,7 @@ struct ttak_mem_tree {
     _Atomic size_t pressure_threshold;  /**< Threshold to trigger immediate cleanup (default 1MB). */
     _Atomic _Bool use_manual_cleanup;   /**< Flag to disable automatic cleanup (1 for manual, 0 for auto). */
     pthread_t cleanup_thread;           /**< Thread ID for the background automatic cleanup process. */
+    _Atomic _Bool cleanup_settled;      /**< Set once adds no longer need the tree lock to start the cleanup thread. */
     _Atomic _Bool shutdown_requested;   /**< Flag to signal the cleanup thread to terminate. */
     _Atomic uint32_t pending_hints;     /**< Bitmask of pending hints from the memory manager. */
     _Atomic _Bool cleanup_needed;       /**< True when there is a known candidate for release; avoids walking the tree when empty. */
@@ -77,17 +154,59 @@ void ttak_mem_tree_destroy(ttak_mem_tree_t *tree);
  */
 ttak_mem_node_t *ttak_mem_tree_add(ttak_mem_tree_t *tree, void *ptr, size_t size, uint64_t expires_tick, _Bool is_root);
 
+/**
+ * @brief Adds a batch of same-sized blocks.
+ *
+ * Nodes are built before any lock is taken, then each one is filed under
+ * its shard lock.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param ptrs Array of allocated memory blocks.
+ * @param count Number of entries in @p ptrs.
+ * @param size Size of each memory block.
+ * @param expires_tick Monotonic tick when the blocks should expire.
+ * @param is_root True if the blocks are root nodes.
+ * @return Number of nodes added; stops early if node allocation fails, and
+ *         skips blocks the pointer index has no room for.
+ */
+size_t ttak_mem_tree_add_bulk(ttak_mem_tree_t *tree, void *const *ptrs, size_t count, size_t size, uint64_t expires_tick, _Bool is_root);
+
 /**
  * @brief Removes a memory block from the mem tree bookkeeping.
  *
  * Callers are responsible for freeing the actual allocation once the node has
- * been detached from the tree.
+ * been detached from the tree. Only the node's shard lock is taken; a node
+ * that was already filed into the expiry wheel is recycled by the next sweep.
  *
  * @param tree Pointer to the mem tree.
  * @param node Pointer to the mem node to remove.
  */
 void ttak_mem_tree_remove(ttak_mem_tree_t *tree, ttak_mem_node_t *node);
 
+/**
+ * @brief Detaches the nodes tracking a batch of pointers in one step.
+ *
+ * Equivalent to ttak_mem_tree_find_node() + ttak_mem_tree_remove() per
+ * pointer, with the nodes recycled in one step at the end. Like
+ * ttak_mem_tree_remove(), the allocations themselves are left untouched.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param ptrs Pointers to detach.
+ * @param count Number of entries in @p ptrs.
+ */
+void ttak_mem_tree_remove_bulk(ttak_mem_tree_t *tree, void *const *ptrs, size_t count);
+
+/**
+ * @brief Returns the number of blocks the tree tracks.
+ *
+ * Sums the shard counts one shard lock at a time, so the result is only
+ * exact while no add or remove is running.
+ *
+ * @param tree Pointer to the mem tree.
+ * @return Number of tracked nodes.
+ */
+size_t ttak_mem_tree_node_count(ttak_mem_tree_t *tree);
+
 /**
  * @brief Increments the reference count for a given mem node.
  *
@@ -157,9 +276,28 @@ void ttak_mem_tree_set_manual_cleanup(ttak_mem_tree_t *tree, _Bool manual_cleanu
  */
 void ttak_mem_tree_perform_cleanup(ttak_mem_tree_t *tree, uint64_t now);
 
+/**
+ * @brief Performs a bounded, incremental cleanup pass.
+ *
+ * Advances the timing wheel up to @p now and releases expired, unreferenced
+ * blocks, examining at most @p budget nodes. Each chunk of
+ * TTAK_MEM_TREE_SWEEP_CHUNK nodes first drains the shards into the wheel.
+ * Adds and removes only take their shard lock, so they never wait for a
+ * sweep to finish.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param now Current monotonic tick.
+ * @param budget Maximum number of nodes to examine (SIZE_MAX for no limit).
+ * @return True if the budget ran out before the sweep caught up with @p now.
+ */
+_Bool ttak_mem_tree_perform_cleanup_budget(ttak_mem_tree_t *tree, uint64_t now, size_t budget);
+
 /**
  * @brief Finds a mem node associated with a given memory pointer.
  *
+ * Lock-free and O(1). The node stays valid only while the caller keeps the
+ * block from being removed, as with any other lookup.
+ *
  * @param tree Pointer to the mem tree.
  * @param ptr The memory pointer to search for.
  * @return A pointer to the found mem node, or NULL if not found.
@@ -33,6 +33,20 @@ extern "C" {
  */
 uint32_t ttak_apply_mols_control(uint16_t node_id, uint32_t current_load);
 
+/**
+ * @brief Apply the same MOLS mixing on a square mesh of order 2^@p order_log2.
+ *
+ * The 64×64 entry point is the @p order_log2 == 6 case; smaller and larger
+ * power-of-two orders (up to 2^16) reproduce its construction with their own
+ * symbol mask, which is what lets the pool size its routing mesh at runtime.
+ *
+ * @param order_log2   Log₂ of the mesh order, in [1, 16].
+ * @param node_id      Linearized node identifier, row << order_log2 | col.
+ * @param current_load Load metric packed the same way as @p node_id.
+ * @return Mixed coordinate packed as row << order_log2 | col.
+ */
+uint32_t ttak_apply_mols_control_order(uint32_t order_log2, uint32_t node_id, uint32_t current_load);
+
 #ifdef __cplusplus
 }
 #endif
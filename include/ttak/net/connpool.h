@@ -0,0 +1,138 @@
+/**
+ * @file connpool.h
+ * @brief Warm outbound connection pool keyed by destination address.
+ *
+ * Fan-out clients check a connection to a backend out, use it, and check
+ * it back in. Idle connections are kept per destination and handed out
+ * again after a cheap health check, so the TCP handshake is paid once per
+ * connection rather than once per request. A miss starts a non-blocking
+ * connect whose completion is reported by the reactor, so no thread
+ * waits on the handshake.
+ *
+ * Destinations are socket addresses; the pool never resolves names.
+ * Endpoints come from a ttak_net_endpoint_pool_t and belong to the pool's
+ * owner, which callers use to access them while checked out. Sockets
+ * are non-blocking. Times are ttak_get_tick_count_ns() nanoseconds.
+ */
+
+#ifndef TTAK_NET_CONNPOOL_H
+#define TTAK_NET_CONNPOOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/io/reactor.h>
+#include <ttak/net/endpoint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Idle connections kept per destination when the configuration gives 0. */
+#define TTAK_NET_CONN_POOL_DEFAULT_IDLE 8U
+
+/** Idle lifetime used when the configuration gives 0. */
+#define TTAK_NET_CONN_POOL_DEFAULT_IDLE_TTL TT_SECOND(60)
+
+typedef struct ttak_net_conn_pool ttak_net_conn_pool_t;
+
+/**
+ * @brief Settings for ttak_net_conn_pool_create(); zero fields pick defaults.
+ */
+typedef struct ttak_net_conn_pool_config {
+    size_t max_idle;            /**< Idle connections kept per destination. */
+    size_t min_idle;            /**< Connections a checkout tops each destination back up to. */
+    uint64_t idle_ttl_ns;       /**< Idle connections older than this are closed, not reused. */
+    uint64_t guard_ttl_ns;      /**< TTL of each endpoint's guard; 0 never expires. */
+} ttak_net_conn_pool_config_t;
+
+/**
+ * @brief Receives a checked-out endpoint, or NULL and the failure.
+ *
+ * Runs on the checking-out thread for a reused connection and on a
+ * reactor or pool thread after a connect.
+ */
+typedef void (*ttak_net_conn_ready_cb)(ttak_shared_net_endpoint_t *endpoint,
+                                       ttak_io_status_t status,
+                                       void *user);
+
+/**
+ * @brief Counters filled by ttak_net_conn_pool_stats().
+ */
+typedef struct ttak_net_conn_pool_stats {
+    uint64_t reused;            /**< Checkouts served by an idle connection. */
+    uint64_t connected;         /**< Connects that completed. */
+    uint64_t failed;            /**< Connects that failed. */
+    uint64_t discarded;         /**< Idle connections dropped as stale or unhealthy. */
+    size_t idle;                /**< Idle connections, all destinations. */
+    size_t connecting;          /**< Connects in flight. */
+} ttak_net_conn_pool_stats_t;
+
+/**
+ * @brief Creates a pool whose connects complete on @p reactor.
+ *
+ * With a NULL @p reactor (or on platforms without one) a miss connects
+ * on the calling thread instead.
+ */
+ttak_net_conn_pool_t *ttak_net_conn_pool_create(const ttak_net_conn_pool_config_t *cfg,
+                                                ttak_io_reactor_t *reactor,
+                                                ttak_owner_t *owner);
+
+/**
+ * @brief Waits for connects in flight, then closes every idle connection.
+ *
+ * Checked-out endpoints must have been checked in first. The reactor must
+ * still be running.
+ */
+void ttak_net_conn_pool_destroy(ttak_net_conn_pool_t *pool, uint64_t now);
+
+/**
+ * @brief Hands @p cb a connection to the destination @p addr.
+ *
+ * A healthy idle connection is passed to @p cb before this returns;
+ * otherwise a connect is started and @p cb runs once it completes.
+ *
+ * @return TTAK_IO_SUCCESS once @p cb has run or is sure to run; any other
+ *         status means the connect could not be started and @p cb will
+ *         not be called.
+ */
+ttak_io_status_t ttak_net_conn_pool_checkout(ttak_net_conn_pool_t *pool,
+                                             const void *addr,
+                                             uint8_t addr_len,
+                                             ttak_net_conn_ready_cb cb,
+                                             void *user,
+                                             uint64_t now);
+
+/**
+ * @brief Returns a checked-out endpoint.
+ *
+ * @param reusable False when the connection is in an unknown protocol
+ *                 state, e.g. after an error; it is closed then.
+ */
+void ttak_net_conn_pool_checkin(ttak_net_conn_pool_t *pool,
+                                ttak_shared_net_endpoint_t *endpoint,
+                                bool reusable,
+                                uint64_t now);
+
+/**
+ * @brief Starts connects until @p addr has @p count idle or pending connections.
+ *
+ * @return Number of connects started.
+ */
+size_t ttak_net_conn_pool_prewarm(ttak_net_conn_pool_t *pool,
+                                  const void *addr,
+                                  uint8_t addr_len,
+                                  size_t count,
+                                  uint64_t now);
+
+/**
+ * @brief Copies the pool's counters into @p out.
+ */
+void ttak_net_conn_pool_stats(ttak_net_conn_pool_t *pool, ttak_net_conn_pool_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_NET_CONNPOOL_H */
@@ -10,6 +10,7 @@
 #ifndef TTAK_NET_CORE_PORT_H
 #define TTAK_NET_CORE_PORT_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -24,6 +25,36 @@ typedef enum ttak_net_os {
     TTAK_NET_OS_BAREMETAL   /**< No OS; uses caller-supplied NIC hooks. */
 } ttak_net_os_t;
 
+/** Messages handed to the kernel per recvmmsg()/sendmmsg() call. */
+#define TTAK_NET_MMSG_CHUNK 64
+
+/**
+ * @brief One datagram of a batch send or receive.
+ *
+ * A portable stand-in for struct mmsghdr with a single buffer, plus the
+ * UDP segmentation offload size in both directions.
+ */
+typedef struct ttak_net_msg {
+    void *buf;          /**< Payload. */
+    size_t len;         /**< Bytes to send, or capacity of @c buf on receive. */
+    size_t bytes;       /**< Bytes sent or received. */
+    void *addr;         /**< Peer sockaddr to send to or receive into; NULL if connected. */
+    uint32_t addr_len;  /**< Size of @c addr; the received address length on return. */
+    uint16_t gso_size;  /**< Send: split into datagrams of this size in the kernel (UDP GSO); 0 sends one.
+                             Receive: size of the datagrams GRO coalesced into @c buf, 0 if none. */
+    int flags;          /**< Receive: msg_flags reported by the kernel (MSG_TRUNC, ...). */
+} ttak_net_msg_t;
+
+/**
+ * @brief Offload and busy-poll settings applied by @c socket_offload.
+ */
+typedef struct ttak_net_offload {
+    bool udp_gro;               /**< Let the kernel coalesce received datagrams (UDP_GRO). */
+    uint32_t busy_poll_us;      /**< SO_BUSY_POLL budget in microseconds; 0 leaves it unset. */
+    uint32_t busy_poll_budget;  /**< Packets per busy-poll pass (SO_BUSY_POLL_BUDGET); 0 leaves it unset. */
+    bool prefer_busy_poll;      /**< SO_PREFER_BUSY_POLL. */
+} ttak_net_offload_t;
+
 /**
  * @brief Vtable of platform socket primitives.
  *
@@ -40,10 +71,19 @@ typedef struct ttak_net_driver_ops {
     int  (*socket_recv)(int fd, void *buf, size_t len);          /**< Receive data. */
     int  (*socket_setopt)(int fd, int opt, const void *val, size_t len); /**< Set option. */
     int  (*poll_wait)(int fd, uint32_t events, int timeout_ms);  /**< Poll/select. */
+    /** Sends a batch (sendmmsg where available); returns messages sent, -1 if none. */
+    int  (*socket_sendmmsg)(int fd, ttak_net_msg_t *msgs, size_t n, int flags);
+    /** Receives a batch, waiting for the first message only; returns messages received, -1 if none. */
+    int  (*socket_recvmmsg)(int fd, ttak_net_msg_t *msgs, size_t n, int flags);
+    /** Applies GRO and busy-poll settings; -1 with ENOTSUP where unsupported. */
+    int  (*socket_offload)(int fd, const ttak_net_offload_t *cfg);
 } ttak_net_driver_ops_t;
 
 /**
  * @brief Hooks for bare-metal NIC drivers (used when @c os == TTAK_NET_OS_BAREMETAL).
+ *
+ * @c driver_ops also overrides hosted targets, which is how kernel-bypass
+ * drivers such as AF_XDP plug in.
  */
 typedef struct ttak_net_baremetal_spec {
     const ttak_net_driver_ops_t *driver_ops; /**< Optional override vtable. */
@@ -58,7 +98,8 @@ typedef struct ttak_net_baremetal_spec {
  *
  * @param ops Output vtable to populate.
  * @param os  Receives the detected OS kind.
- * @param bm  Bare-metal spec (pass NULL on POSIX/Windows targets).
+ * @param bm  Bare-metal spec. On POSIX/Windows targets only @c driver_ops is
+ *            used, replacing the detected vtable; pass NULL to keep it.
  */
 void ttak_net_driver_detect(ttak_net_driver_ops_t *ops,
                             ttak_net_os_t *os,
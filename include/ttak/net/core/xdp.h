@@ -0,0 +1,152 @@
+/**
+ * @file xdp.h
+ * @brief AF_XDP kernel-bypass sockets behind @c ttak_net_driver_ops_t (Linux).
+ *
+ * An XDP socket receives frames straight off one NIC queue and transmits
+ * frames without the kernel network stack. Frames live in a UMEM carved
+ * from the buddy allocator and move through four single-producer rings
+ * shared with the kernel: fill (free frames for receive), RX, TX and
+ * completion (transmitted frames coming back).
+ *
+ * ttak_net_xdp_open() builds the UMEM and rings, binds the socket to a
+ * queue and, unless told otherwise, attaches a minimal XDP program that
+ * redirects every frame on the interface into the socket map. Received
+ * frames are drained either into lattice slots by
+ * ttak_net_xdp_rx_to_lattice(), one batch at a time with their frames
+ * handed straight back to the fill ring, or by a busy-poll worker started
+ * with ttak_net_xdp_start_worker() that does the same in a loop.
+ *
+ * ttak_net_xdp_driver_ops() fills a driver vtable whose batch, send,
+ * receive, poll and offload entries work on the descriptors returned by
+ * ttak_net_xdp_fd(). Pass it through @c ttak_net_baremetal_spec_t::driver_ops
+ * to ttak_net_driver_detect() to run the endpoint layer over XDP.
+ *
+ * Opening a socket needs CAP_NET_RAW, and attaching the program
+ * CAP_NET_ADMIN and CAP_BPF. Other platforms get NULL from
+ * ttak_net_xdp_open().
+ */
+
+#ifndef TTAK_NET_CORE_XDP_H
+#define TTAK_NET_CORE_XDP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/net/core/port.h>
+#include <ttak/net/lattice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Default UMEM frame count; counts are rounded up to a power of two. */
+#define TTAK_NET_XDP_DEFAULT_FRAMES 4096U
+
+/** Default frame size; the kernel accepts 2048 or 4096 in aligned mode. */
+#define TTAK_NET_XDP_DEFAULT_FRAME_SIZE 2048U
+
+/** Frames moved per ring pass. */
+#define TTAK_NET_XDP_BATCH 64U
+
+/** Queues one program's socket map can redirect to. */
+#define TTAK_NET_XDP_MAX_QUEUES 64U
+
+typedef struct ttak_net_xdp ttak_net_xdp_t;
+
+typedef ttak_net_xdp_t tt_net_xdp_t;
+
+/**
+ * @brief Settings for ttak_net_xdp_open().
+ */
+typedef struct ttak_net_xdp_config {
+    const char *ifname;         /**< Interface to bind. */
+    uint32_t queue_id;          /**< NIC queue to bind, below TTAK_NET_XDP_MAX_QUEUES. */
+    uint32_t frame_count;       /**< UMEM frames; 0 selects TTAK_NET_XDP_DEFAULT_FRAMES. Half feed receive. */
+    uint32_t frame_size;        /**< 2048 or 4096; 0 selects TTAK_NET_XDP_DEFAULT_FRAME_SIZE. */
+    bool zerocopy;              /**< Require driver zero-copy (XDP_ZEROCOPY) instead of copy mode. */
+    bool native;                /**< Attach the program in driver mode instead of generic (SKB) mode. */
+    bool no_program;            /**< Attach no program; frames arrive only through @c share's or an external map. */
+    ttak_net_xdp_t *share;      /**< Socket whose program redirects to this queue too; must outlive this one. */
+} ttak_net_xdp_config_t;
+
+/**
+ * @brief Counters kept by one socket.
+ */
+typedef struct ttak_net_xdp_stats {
+    uint64_t rx_frames;         /**< Frames taken off the RX ring. */
+    uint64_t rx_dropped;        /**< Received frames a lattice had no room for. */
+    uint64_t tx_frames;         /**< Frames placed on the TX ring. */
+    uint64_t tx_completed;      /**< Frames the kernel reported transmitted. */
+} ttak_net_xdp_stats_t;
+
+/**
+ * @brief Opens an XDP socket on @c cfg->ifname queue @c cfg->queue_id.
+ *
+ * @return The socket, or NULL on failure, without privileges, or where
+ *         AF_XDP is unavailable; errno tells which.
+ */
+ttak_net_xdp_t *ttak_net_xdp_open(const ttak_net_xdp_config_t *cfg, uint64_t now);
+
+/**
+ * @brief Stops the worker, detaches the program and frees the UMEM.
+ */
+void ttak_net_xdp_close(ttak_net_xdp_t *xdp);
+
+/**
+ * @brief Descriptor the driver vtable from ttak_net_xdp_driver_ops() accepts.
+ */
+int ttak_net_xdp_fd(const ttak_net_xdp_t *xdp);
+
+/**
+ * @brief Moves up to @p budget received frames into @p lat as worker @p tid.
+ *
+ * Frames are copied into lattice slots with ttak_net_lattice_write_batch()
+ * and their UMEM frames returned to the fill ring in the same pass; frames
+ * the lattice refuses are counted as dropped.
+ *
+ * @return Frames written to the lattice.
+ */
+size_t ttak_net_xdp_rx_to_lattice(ttak_net_xdp_t *xdp,
+                                  ttak_net_lattice_t *lat,
+                                  uint32_t tid,
+                                  size_t budget,
+                                  uint64_t now);
+
+/**
+ * @brief Starts a thread that busy-polls the socket into @p lat as worker @p tid.
+ *
+ * The loop spins on ttak_net_xdp_rx_to_lattice() and, with nothing
+ * received, drives the kernel with a non-blocking receive so SO_BUSY_POLL
+ * settings applied through the offload entry take effect. Only one worker
+ * per socket; do not receive through the vtable while it runs.
+ *
+ * @return 0, or an errno value.
+ */
+int ttak_net_xdp_start_worker(ttak_net_xdp_t *xdp, ttak_net_lattice_t *lat, uint32_t tid);
+
+/**
+ * @brief Stops and joins the worker, if one runs.
+ */
+void ttak_net_xdp_stop_worker(ttak_net_xdp_t *xdp);
+
+/**
+ * @brief Copies the socket's counters into @p out.
+ */
+void ttak_net_xdp_stats(const ttak_net_xdp_t *xdp, ttak_net_xdp_stats_t *out);
+
+/**
+ * @brief Fills @p ops with entries that run over XDP sockets.
+ *
+ * socket_send/recv, their batch forms, poll_wait, socket_offload and
+ * socket_close act on descriptors from ttak_net_xdp_fd(); frames are raw
+ * link-layer frames and message addresses are ignored. The remaining
+ * entries fail with ENOTSUP.
+ */
+void ttak_net_xdp_driver_ops(ttak_net_driver_ops_t *ops);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_NET_CORE_XDP_H */
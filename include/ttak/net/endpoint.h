@@ -7,6 +7,7 @@
 #include <ttak/shared/shared.h>
 #include <ttak/io/io.h>
 #include <ttak/net/lattice.h>
+#include <ttak/net/core/port.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -90,6 +91,67 @@ void ttak_net_endpoint_destroy(ttak_shared_net_endpoint_t *endpoint,
                                ttak_owner_t *owner,
                                uint64_t now);
 
+/** Idle endpoints a pool keeps when ttak_net_endpoint_pool_init() is given 0. */
+#define TTAK_NET_ENDPOINT_POOL_DEFAULT_IDLE 1024U
+
+struct ttak_net_endpoint_pool_node;
+
+/**
+ * @brief Recycles closed endpoints so accept-heavy servers skip the
+ *        allocation, shared-handle setup and owner registration of
+ *        ttak_net_endpoint_create().
+ *
+ * Released endpoints go onto a lock-free stack, but only after an epoch
+ * has passed: ttak_net_endpoint_pool_release() retires them through
+ * ttak_epoch_retire() and the reclaim pushes them back. A thread popping
+ * the stack inside an epoch section therefore never sees a node come back
+ * underneath it, which rules out ABA without tagged pointers.
+ */
+typedef struct ttak_net_endpoint_pool {
+    struct ttak_net_endpoint_pool_node *_Atomic head;
+    _Atomic size_t idle;            /**< Endpoints ready on the stack. */
+    _Atomic size_t deferred;        /**< Released endpoints waiting for their epoch. */
+    size_t max_idle;                /**< Releases beyond this are destroyed instead. */
+    _Atomic uint64_t created;       /**< Endpoints built from scratch. */
+    _Atomic uint64_t reused;        /**< Acquires served from the stack. */
+} ttak_net_endpoint_pool_t;
+
+typedef ttak_net_endpoint_pool_t tt_net_endpoint_pool_t;
+
+/**
+ * @brief Initialises an empty pool holding at most @p max_idle endpoints.
+ */
+void ttak_net_endpoint_pool_init(ttak_net_endpoint_pool_t *pool, size_t max_idle);
+
+/**
+ * @brief Destroys every pooled endpoint, waiting out pending releases.
+ *
+ * Endpoints still acquired must have been released or destroyed first.
+ */
+void ttak_net_endpoint_pool_destroy(ttak_net_endpoint_pool_t *pool, uint64_t now);
+
+/**
+ * @brief Returns an endpoint bound to @p owner, reusing a released one
+ *        when available.
+ *
+ * A reused endpoint is reset to the state ttak_net_endpoint_create()
+ * produces, with a generation above any it had before, so guard
+ * snapshots taken during its previous life no longer commit.
+ */
+ttak_shared_net_endpoint_t *ttak_net_endpoint_pool_acquire(ttak_net_endpoint_pool_t *pool,
+                                                           ttak_owner_t *owner,
+                                                           uint64_t now);
+
+/**
+ * @brief Closes @p endpoint and hands it back to the pool it came from.
+ *
+ * @p endpoint must come from ttak_net_endpoint_pool_acquire() on @p pool.
+ */
+void ttak_net_endpoint_pool_release(ttak_net_endpoint_pool_t *pool,
+                                    ttak_shared_net_endpoint_t *endpoint,
+                                    ttak_owner_t *owner,
+                                    uint64_t now);
+
 /**
  * @brief Binds an existing descriptor into the endpoint wrapper.
  */
@@ -124,6 +186,18 @@ ttak_io_status_t ttak_net_endpoint_close(ttak_shared_net_endpoint_t *endpoint,
                                          ttak_owner_t *owner,
                                          uint64_t now);
 
+/**
+ * @brief Puts the endpoint's guard in coarse TTL mode; see ttak_io_guard_set_coarse().
+ *
+ * The setting lasts across restarts of the bound socket and is cleared
+ * when a pool hands the endpoint out again.
+ */
+ttak_io_status_t ttak_net_endpoint_set_coarse_ttl(ttak_shared_net_endpoint_t *endpoint,
+                                                  ttak_owner_t *owner,
+                                                  uint64_t window_ns,
+                                                  ttak_timer_wheel_t *wheel,
+                                                  uint64_t now);
+
 /**
  * @brief Captures guard metadata so callers can use the fd safely after
  *        releasing shared access.
@@ -146,6 +220,53 @@ ttak_io_status_t ttak_net_endpoint_force_restart(ttak_shared_net_endpoint_t *end
                                                  ttak_owner_t *owner,
                                                  uint64_t now);
 
+/**
+ * @brief Sends a batch of datagrams with as few syscalls as the platform allows.
+ *
+ * Messages with a non-zero @c gso_size are split into datagrams by the
+ * kernel (UDP GSO, Linux only).
+ *
+ * @param sent Receives the number of messages sent; each one's @c bytes is set.
+ * @return TTAK_IO_ERR_NEEDS_RETRY if nothing could be sent without blocking.
+ */
+ttak_io_status_t ttak_net_endpoint_send_batch(ttak_shared_net_endpoint_t *endpoint,
+                                              ttak_owner_t *owner,
+                                              ttak_net_msg_t *msgs,
+                                              size_t n,
+                                              int flags,
+                                              size_t *sent,
+                                              uint64_t now);
+
+/**
+ * @brief Receives up to @p n datagrams, waiting (unless @p flags says not
+ *        to) for the first only.
+ *
+ * With GRO enabled, one message may hold several datagrams of
+ * @c gso_size bytes each.
+ *
+ * @param received Receives the number of messages filled.
+ * @return TTAK_IO_ERR_NEEDS_RETRY if nothing was queued on a non-blocking call.
+ */
+ttak_io_status_t ttak_net_endpoint_recv_batch(ttak_shared_net_endpoint_t *endpoint,
+                                              ttak_owner_t *owner,
+                                              ttak_net_msg_t *msgs,
+                                              size_t n,
+                                              int flags,
+                                              size_t *received,
+                                              uint64_t now);
+
+/**
+ * @brief Applies UDP GRO and busy-poll settings to the endpoint's socket.
+ *
+ * Not reapplied after a restart.
+ *
+ * @return TTAK_IO_ERR_SYS_FAILURE if the platform or kernel refuses a setting.
+ */
+ttak_io_status_t ttak_net_endpoint_set_offload(ttak_shared_net_endpoint_t *endpoint,
+                                               ttak_owner_t *owner,
+                                               const ttak_net_offload_t *cfg,
+                                               uint64_t now);
+
 #ifdef __cplusplus
 }
 #endif
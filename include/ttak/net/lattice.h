@@ -7,27 +7,67 @@
 #include <ttak/mem/mem.h>
 #include <ttak/sync/sync.h>
 #include <ttak/atomic/atomic.h>
+#include <ttak/sync/waitword.h>
 
 /**
  * @file lattice.h
  * @brief Lock-free parallel ingress buffer using a 2-D slot lattice.
+ *
+ * Slots are 64-byte descriptors pointing into a payload block allocated
+ * right behind them, so a lattice costs dim * dim * slot_size bytes of
+ * payload for whatever slot size it was created with. Lattices of the
+ * same chain share one slot size.
  */
 
+/** Slot size of ttak_net_lattice_create(). */
 #define TTAK_LATTICE_SLOT_SIZE 16384
+/** Bounds of ttak_net_lattice_create_sized(); sizes round up to 64 bytes. */
+#define TTAK_LATTICE_MIN_SLOT_SIZE 64
+#define TTAK_LATTICE_MAX_SLOT_SIZE 65536
 #define TTAK_LATTICE_MAX_DIM 16
 
+/** Most spare lattices ttak_net_lattice_start_maintenance() keeps ready. */
+#define TTAK_LATTICE_MAX_SPARES 8
+
+/** Size classes of a ttak_net_lattice_classes_t: 256 B, 2 KiB, 16 KiB, 64 KiB. */
+#define TTAK_LATTICE_CLASSES 4
+
 /**
  * @brief A single data slot in the lattice.
  */
 typedef struct ttak_net_lattice_slot {
-    _Alignas(64) uint8_t  data[TTAK_LATTICE_SLOT_SIZE];
+    _Alignas(64) uint8_t *data; /* slot_size bytes in the lattice's payload block */
     uint64_t timestamp;
     uint32_t len;
     uint32_t seq;
     volatile uint64_t state;
-    uint8_t padding[32]; /* Pad to ensure 64-byte multiple if needed */
 } ttak_net_lattice_slot_t;
 
+/**
+ * @brief One message of a batch write or read.
+ *
+ * Writers fill @c data and @c len. ttak_net_lattice_read_batch() fills all
+ * four, with @c data pointing into the claimed slot until the message is
+ * released.
+ */
+typedef struct ttak_net_lattice_msg {
+    const uint8_t *data;
+    uint32_t len;
+    ttak_net_lattice_slot_t *slot;
+    struct ttak_net_lattice *node;
+} ttak_net_lattice_msg_t;
+
+/**
+ * @brief Wakeup state of one consumer lane; see ttak_net_lattice_enable_doorbells().
+ */
+typedef struct ttak_net_lattice_doorbell {
+    _Alignas(64) _Atomic uint32_t ready;   /* Messages published to the lane and not yet claimed. */
+    _Atomic uint32_t armed;                 /* A consumer found the lane empty and waits for a ring. */
+    _Atomic uint32_t rung;                  /* The eventfd holds an unread count. */
+    int fd;                                 /* eventfd, or -1 */
+    ttak_eventcount_t ec;
+} ttak_net_lattice_doorbell_t;
+
 /**
  * @brief The lattice structure.
  */
@@ -35,27 +75,89 @@ typedef struct ttak_net_lattice {
     uint32_t dim;      /* Dimension of the square (must be power of 2) */
     uint32_t mask;     /* dim - 1 */
     uint32_t capacity; /* Total number of slots */
+    uint32_t slot_size; /* Payload bytes per slot */
     ttak_net_lattice_slot_t *slots; /* dim * dim array */
     volatile uint64_t total_ingress;
     volatile uint64_t used_slots;
     _Atomic uint32_t compact_state;
     _Bool is_full;
     _Bool is_stub;
+    uint32_t nt_write_min; /* Writes this long or longer bypass the cache; 0 = never. Read from the head node. */
     struct ttak_net_lattice *prev;
     struct ttak_net_lattice *next; /* Grows when the lattice saturates */
     ttak_mutex_t expand_lock;
+    struct ttak_metrics_registry *metrics; /* Registry the head node exports to, if any. */
+    ttak_net_lattice_doorbell_t *doorbells; /* One per lane on the head node, or NULL. */
+    uint32_t doorbell_mask;
+    struct ttak_net_lattice_maint *_Atomic maint; /* Shared by every node once maintenance has started. */
 } ttak_net_lattice_t;
 
+/**
+ * @brief Counters of a chain's maintenance thread.
+ */
+typedef struct ttak_net_lattice_maint_stats {
+    uint64_t spares;        /* Spare lattices ready now. */
+    uint64_t spare_hits;    /* Growths served from a spare. */
+    uint64_t inline_allocs; /* Growths that found no spare and allocated on the writer. */
+    uint64_t grown;         /* Growths done ahead of need by the thread. */
+    uint64_t compactions;   /* Pairs of idle lattices folded by the thread. */
+} ttak_net_lattice_maint_stats_t;
+
 /**
  * @brief Initializes a net lattice with given dimension.
  */
 ttak_net_lattice_t* ttak_net_lattice_create(uint32_t dim, uint64_t now);
 
+/**
+ * @brief Initializes a net lattice whose slots hold @p slot_size bytes.
+ *
+ * @p slot_size is rounded up to a multiple of 64 and must not exceed
+ * TTAK_LATTICE_MAX_SLOT_SIZE. Lattices it grows into inherit the size.
+ */
+ttak_net_lattice_t* ttak_net_lattice_create_sized(uint32_t dim, uint32_t slot_size, uint64_t now);
+
 /**
  * @brief Destroys the lattice.
  */
 void ttak_net_lattice_destroy(ttak_net_lattice_t *lat, uint64_t now);
 
+/**
+ * @brief Exports node count, capacity, used slots and ingress of the whole chain to @p reg.
+ *
+ * Series are read at scrape time and carry @p labels (or none if NULL). A
+ * lattice exports to one registry at a time; ttak_net_lattice_destroy()
+ * removes its series.
+ *
+ * @return Number of series registered; 0 if the lattice already exports.
+ */
+size_t ttak_net_lattice_export_metrics(ttak_net_lattice_t *lat, struct ttak_metrics_registry *reg,
+                                       const char *labels);
+
+/**
+ * @brief Starts a thread that grows and compacts the chain off the writer path.
+ *
+ * Without it, the write that pushes a lattice past 80% occupancy allocates
+ * its successor, and the release that empties one runs a compaction pass,
+ * both inline. With it, those calls only flag the work and the thread does
+ * it. The thread also keeps @p spares lattices (at most
+ * TTAK_LATTICE_MAX_SPARES) allocated, so a writer that runs off the end of
+ * the chain before the thread caught up links a spare instead of
+ * allocating.
+ *
+ * @return 0, EALREADY if maintenance is running, EINVAL, ENOMEM or the
+ *         error from thread creation.
+ */
+int ttak_net_lattice_start_maintenance(ttak_net_lattice_t *lat, uint32_t spares);
+
+/**
+ * @brief Stops and joins the maintenance thread. Spares are kept for a restart.
+ *
+ * ttak_net_lattice_destroy() stops it implicitly.
+ */
+void ttak_net_lattice_stop_maintenance(ttak_net_lattice_t *lat);
+
+void ttak_net_lattice_maintenance_stats(ttak_net_lattice_t *lat, ttak_net_lattice_maint_stats_t *out);
+
 /**
  * @brief Lock-free deterministic write into the lattice.
  */
@@ -66,6 +168,87 @@ _Bool ttak_net_lattice_write(ttak_net_lattice_t *lat, uint32_t tid, const void *
  */
 _Bool ttak_net_lattice_read(ttak_net_lattice_t *lat, uint32_t tid, void *dst, uint32_t *len_out, uint64_t now);
 
+/**
+ * @brief Writes up to @p n messages for @p tid in one sweep.
+ *
+ * The worker's slots are found once per lattice, every free one is filled
+ * in order, and the ingress and occupancy counters are bumped once per
+ * lattice rather than once per message.
+ *
+ * @return Messages written; a prefix of @p msgs. Stops early at a message
+ *         larger than the slot size.
+ */
+size_t ttak_net_lattice_write_batch(ttak_net_lattice_t *lat, uint32_t tid, const ttak_net_lattice_msg_t *msgs,
+                                    size_t n, uint64_t now);
+
+/**
+ * @brief Claims up to @p max ready messages for @p tid without copying them.
+ *
+ * Each entry of @p out views its slot in place; hand the batch back with
+ * ttak_net_lattice_release_batch() once done.
+ *
+ * @return Messages claimed.
+ */
+size_t ttak_net_lattice_read_batch(ttak_net_lattice_t *lat, uint32_t tid, ttak_net_lattice_msg_t *out,
+                                   size_t max, uint64_t now);
+
+/**
+ * @brief Frees the slots of a batch from ttak_net_lattice_read_batch().
+ */
+void ttak_net_lattice_release_batch(ttak_net_lattice_msg_t *msgs, size_t n);
+
+/**
+ * @brief Gives every consumer lane of the chain a doorbell.
+ *
+ * A lane is the set of slots a tid (modulo the dimension) writes and
+ * reads. Writers count what they publish per lane and ring the lane's
+ * doorbell only when that count leaves zero while a consumer is armed,
+ * so a busy consumer costs writers one atomic add and nobody a syscall.
+ * With @p with_eventfd each lane also gets an eventfd that becomes
+ * readable on a ring, for consumers driven by a reactor; otherwise a
+ * ring is a futex wake and costs nothing without sleepers.
+ *
+ * Call once, before the lattice is shared.
+ *
+ * @return False if the lattice already has doorbells or on allocation
+ *         or eventfd failure.
+ */
+_Bool ttak_net_lattice_enable_doorbells(ttak_net_lattice_t *lat, _Bool with_eventfd);
+
+/**
+ * @brief The eventfd of @p tid's lane, or -1 without one.
+ *
+ * The lattice owns the descriptor, so hand the reactor a guard around a
+ * dup() of it and watch for POLLIN. The callback drains the lane and then
+ * calls ttak_net_lattice_doorbell_arm().
+ */
+int ttak_net_lattice_doorbell_fd(ttak_net_lattice_t *lat, uint32_t tid);
+
+/**
+ * @brief Asks to be woken by the next message for @p tid's lane.
+ *
+ * Also clears a pending eventfd count, so an edge-triggered watch fires
+ * again on the next ring.
+ *
+ * @return False if messages are already waiting; drain them and arm again.
+ */
+_Bool ttak_net_lattice_doorbell_arm(ttak_net_lattice_t *lat, uint32_t tid);
+
+/**
+ * @brief Number of messages ready in @p tid's lane.
+ */
+uint32_t ttak_net_lattice_pending(ttak_net_lattice_t *lat, uint32_t tid);
+
+/**
+ * @brief Sleeps until @p tid's lane has a message, for at most @p timeout_ns.
+ *
+ * Returns at once while the lane is non-empty. TTAK_WAIT_FOREVER blocks
+ * without a limit.
+ *
+ * @return True if messages are ready, false on timeout or without doorbells.
+ */
+_Bool ttak_net_lattice_wait(ttak_net_lattice_t *lat, uint32_t tid, uint64_t timeout_ns);
+
 /**
  * @brief Returns the global default lattice.
  */
@@ -81,6 +264,15 @@ void ttak_net_lattice_set_worker_id(uint32_t tid);
  */
 uint32_t ttak_net_lattice_get_worker_id(void);
 
+/**
+ * @brief Writes payloads of at least @p min_bytes with non-temporal stores.
+ *
+ * Streaming stores skip the writer's cache, which pays off when ingress is
+ * heavy and slots are read on other cores. 0 (the default) keeps every
+ * write cached. Applies to the whole chain @p lat belongs to.
+ */
+void ttak_net_lattice_set_stream_writes(ttak_net_lattice_t *lat, uint32_t min_bytes);
+
 /**
  * @brief Ensures the current lattice has a successor allocated when needed.
  */
@@ -96,4 +288,46 @@ void ttak_net_lattice_mark_slot_acquired(ttak_net_lattice_t *lat, uint64_t now);
  */
 void ttak_net_lattice_mark_slot_released(ttak_net_lattice_t *lat);
 
+/**
+ * @brief One lattice chain per size class, created on first use.
+ *
+ * Writes land in the smallest class that fits the payload, so small
+ * packets stop pinning 16 KiB slots each.
+ */
+typedef struct ttak_net_lattice_classes {
+    uint32_t dim;
+    ttak_net_lattice_t *_Atomic lattices[TTAK_LATTICE_CLASSES];
+} ttak_net_lattice_classes_t;
+
+/**
+ * @brief Payload bytes per slot of class @p cls, or 0 past the last class.
+ */
+uint32_t ttak_net_lattice_class_size(uint32_t cls);
+
+/**
+ * @brief Initializes an empty class set whose lattices will have dimension @p dim.
+ *
+ * @return False if @p dim is not a power of two up to TTAK_LATTICE_MAX_DIM.
+ */
+_Bool ttak_net_lattice_classes_init(ttak_net_lattice_classes_t *set, uint32_t dim);
+
+/**
+ * @brief Destroys every lattice the set created.
+ */
+void ttak_net_lattice_classes_destroy(ttak_net_lattice_classes_t *set, uint64_t now);
+
+/**
+ * @brief Writes into the smallest class whose slots fit @p len bytes.
+ */
+_Bool ttak_net_lattice_classes_write(ttak_net_lattice_classes_t *set, uint32_t tid, const void *data,
+                                     uint32_t len, uint64_t now);
+
+/**
+ * @brief Reads the first ready payload for @p tid, smallest class first.
+ *
+ * Only classes whose slots fit in @p dst_cap bytes are searched.
+ */
+_Bool ttak_net_lattice_classes_read(ttak_net_lattice_classes_t *set, uint32_t tid, void *dst, size_t dst_cap,
+                                    uint32_t *len_out, uint64_t now);
+
 #endif /* TTAK_NET_LATTICE_H */
@@ -0,0 +1,175 @@
+/**
+ * @file parse.h
+ * @brief Incremental framing and HTTP/1.1 tokenizing over buffer chains.
+ *
+ * A parser owns a ttak_io_chain_t input. Received data is fed in as
+ * chains, zero-copy views or plain bytes, and ttak_net_parser_next()
+ * returns the next complete frame whenever one is buffered. It returns
+ * TTAK_NET_PARSE_NEED_MORE otherwise, so parsing resumes where it
+ * stopped and no input is scanned twice.
+ *
+ * Three framings are built in:
+ * - length-prefixed: a 1, 2, 4 or 8 byte length, then that many bytes;
+ * - delimited: frames end in a delimiter of up to eight bytes;
+ * - HTTP/1.1: the request line and each header field become their own
+ *   events, split into tokens, and an empty line ends the header block.
+ *
+ * Delimiters are found with a vector scan (AVX2, SSE2 or NEON, else
+ * memchr). Tokens point straight into the received blocks. A frame is
+ * copied only when it straddles two segments, and then only into the
+ * parser's scratch buffer. Tokens stay valid until the next call that
+ * advances the parser.
+ */
+
+#ifndef TTAK_NET_PARSE_H
+#define TTAK_NET_PARSE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/io/chain.h>
+#include <ttak/net/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Longest delimiter a delimited parser accepts. */
+#define TTAK_NET_PARSE_MAX_DELIM 8U
+
+/** Frame limit used when the configuration gives none. */
+#define TTAK_NET_PARSE_DEFAULT_MAX_FRAME (64U * 1024U)
+
+typedef enum ttak_net_frame_kind {
+    TTAK_NET_FRAME_LENGTH = 0,
+    TTAK_NET_FRAME_DELIMITER,
+    TTAK_NET_FRAME_HTTP1
+} ttak_net_frame_kind_t;
+
+typedef enum ttak_net_parse_status {
+    TTAK_NET_PARSE_FRAME = 0,       /**< A frame was returned. */
+    TTAK_NET_PARSE_NEED_MORE,       /**< No complete frame is buffered. */
+    TTAK_NET_PARSE_ERROR            /**< Malformed input or a frame over @c max_frame; call reset. */
+} ttak_net_parse_status_t;
+
+typedef enum ttak_net_http_event {
+    TTAK_NET_HTTP_NONE = 0,
+    TTAK_NET_HTTP_REQUEST_LINE,     /**< @c method, @c target and @c version are set. */
+    TTAK_NET_HTTP_HEADER,           /**< @c name and @c value are set. */
+    TTAK_NET_HTTP_HEADERS_DONE      /**< Blank line; the body, if any, follows. */
+} ttak_net_http_event_t;
+
+/**
+ * @brief Settings for ttak_net_parser_init().
+ */
+typedef struct ttak_net_parser_config {
+    ttak_net_frame_kind_t kind;
+    uint8_t length_bytes;           /**< 1, 2, 4 or 8; length-prefixed only. */
+    bool length_little_endian;      /**< Byte order of the prefix; big endian by default. */
+    const uint8_t *delim;           /**< Delimiter bytes; delimited only. */
+    uint8_t delim_len;              /**< 1 to TTAK_NET_PARSE_MAX_DELIM. */
+    size_t max_frame;               /**< Largest frame or line; 0 selects the default. */
+} ttak_net_parser_config_t;
+
+/**
+ * @brief Bytes of a frame or one of its parts.
+ */
+typedef struct ttak_net_token {
+    const uint8_t *data;
+    size_t len;
+} ttak_net_token_t;
+
+/**
+ * @brief One frame returned by ttak_net_parser_next().
+ */
+typedef struct ttak_net_frame {
+    ttak_net_token_t payload;       /**< Frame without prefix or delimiter; the line for HTTP. */
+    ttak_net_http_event_t http;
+    ttak_net_token_t method;
+    ttak_net_token_t target;
+    ttak_net_token_t version;
+    ttak_net_token_t name;
+    ttak_net_token_t value;         /**< Without surrounding whitespace. */
+} ttak_net_frame_t;
+
+/**
+ * @brief Resumable parser state. Not thread-safe.
+ */
+typedef struct ttak_net_parser {
+    ttak_net_parser_config_t cfg;
+    uint8_t delim[TTAK_NET_PARSE_MAX_DELIM];
+    ttak_io_chain_t in;
+    size_t scanned;                 /**< Input already searched for a delimiter. */
+    size_t pending;                 /**< Bytes of the last frame, dropped on the next call. */
+    uint8_t *scratch;               /**< Holds frames that straddle segments. */
+    size_t scratch_cap;
+    bool in_headers;                /**< HTTP: past the request line. */
+    bool has_content_length;
+    uint64_t content_length;        /**< HTTP: Content-Length of the current message. */
+    uint64_t frames;
+    uint64_t copied_bytes;          /**< Bytes copied to join split frames. */
+} ttak_net_parser_t;
+
+typedef ttak_net_parser_t tt_net_parser_t;
+
+/**
+ * @brief Initialises @p parser; input blocks come from @p arena (NULL for the default).
+ *
+ * @return False if the configuration is invalid.
+ */
+bool ttak_net_parser_init(ttak_net_parser_t *parser,
+                          const ttak_net_parser_config_t *cfg,
+                          ttak_detachable_context_t *arena);
+
+/**
+ * @brief Releases the buffered input and the scratch buffer.
+ */
+void ttak_net_parser_destroy(ttak_net_parser_t *parser);
+
+/**
+ * @brief Discards buffered input and parse state, keeping the configuration.
+ */
+void ttak_net_parser_reset(ttak_net_parser_t *parser);
+
+/**
+ * @brief Appends @p chain's bytes to the input without copying.
+ */
+ttak_io_status_t ttak_net_parser_feed_chain(ttak_net_parser_t *parser, const ttak_io_chain_t *chain);
+
+/**
+ * @brief Moves a view's bytes into the input and releases the view.
+ *
+ * A view read into a zero-copy region hands its buffer over as is; a view
+ * of a lattice slot is copied, since the slot goes back to the lattice.
+ */
+ttak_io_status_t ttak_net_parser_feed_view(ttak_net_parser_t *parser, ttak_net_view_t *view, uint64_t now);
+
+/**
+ * @brief Copies @p len bytes into the input.
+ */
+ttak_io_status_t ttak_net_parser_feed(ttak_net_parser_t *parser, const void *data, size_t len, uint64_t now);
+
+/**
+ * @brief Returns the next complete frame in @p out.
+ */
+ttak_net_parse_status_t ttak_net_parser_next(ttak_net_parser_t *parser, ttak_net_frame_t *out);
+
+/**
+ * @brief Returns the next @p len raw bytes, such as an HTTP body after
+ *        TTAK_NET_HTTP_HEADERS_DONE.
+ *
+ * @return TTAK_NET_PARSE_NEED_MORE until @p len bytes are buffered.
+ */
+ttak_net_parse_status_t ttak_net_parser_take(ttak_net_parser_t *parser, size_t len, ttak_net_token_t *out);
+
+/**
+ * @brief First occurrence of @p byte in @p len bytes at @p data, or NULL.
+ */
+const uint8_t *ttak_net_scan_byte(const uint8_t *data, size_t len, uint8_t byte);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_NET_PARSE_H */
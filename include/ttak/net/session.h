@@ -9,6 +9,7 @@
 #include <ttak/net/core/port.h>
 #include <ttak/mem/epoch.h>
 #include <ttak/sync/sync.h>
+#include <ttak/timing/wheel.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,8 +30,16 @@ typedef enum ttak_net_session_policy {
     TTAK_SOCK_RESTART = (1u << 1)
 } ttak_net_session_policy_t;
 
+/** Session table shards; a power of two. */
+#define TTAK_NET_SESSION_SHARDS 64U
+
+struct ttak_net_session_mgr;
+
 /**
  * @brief Logical connection wrapper that ties an endpoint to parent/child relationships.
+ *
+ * A session's child list and state flags are guarded by the lock of the
+ * shard its id hashes to; a root session also sits on that shard's list.
  */
 typedef struct ttak_net_session {
     uint64_t id;
@@ -44,19 +53,35 @@ typedef struct ttak_net_session {
     uint64_t lifetime_ns;
     uint64_t next_sanity_ns;
     struct ttak_net_session *next_retire;
-    struct ttak_net_session *sanity_next;
     struct ttak_net_session *fault_next;
+    struct ttak_net_session_mgr *mgr;
+    uint64_t affinity;              /**< Task hash of the endpoint's guard; routes fault work with its I/O. */
+    ttak_timer_t sanity_timer;      /**< Armed for the next sanity check of an immortal session. */
 } ttak_net_session_t;
 
+/**
+ * @brief One slice of the session table.
+ */
+typedef struct ttak_net_session_shard {
+    ttak_mutex_t lock;
+    ttak_net_session_t *head;       /**< Root sessions hashing here. */
+} ttak_net_session_shard_t;
+
+/**
+ * @brief Session table sharded by id hash, with sanity checks on a timer wheel.
+ *
+ * Create and close take only the shard locks of the sessions they touch,
+ * and a tick fires only the sanity timers that are due.
+ */
 typedef struct ttak_net_session_mgr {
-    ttak_rwlock_t lock;
-    ttak_net_session_t *head;
-    uint64_t next_id;
+    ttak_net_session_shard_t shards[TTAK_NET_SESSION_SHARDS];
+    _Atomic uint64_t next_id;
     uint32_t policy_flags;
-    ttak_net_session_t *retire_head;
     ttak_net_session_t *fault_head;
     bool async_offload;
     const ttak_net_driver_ops_t *net_ops;
+    ttak_timer_wheel_t wheel;       /**< Sanity timers, advanced by ttak_net_session_mgr_tick(). */
+    _Atomic uint64_t tick_now;      /**< Time of the tick firing timers. */
 } ttak_net_session_mgr_t;
 
 /**
@@ -86,7 +111,11 @@ void ttak_net_session_mgr_close(ttak_net_session_mgr_t *mgr,
                                 uint64_t now);
 
 /**
- * @brief Periodic heartbeat for immortal sockets: runs sanity checks and applies policy.
+ * @brief Periodic heartbeat for immortal sockets: runs the sanity checks due
+ *        by @p now and applies policy.
+ *
+ * Costs O(due sessions), not O(sessions); call it at least as often as the
+ * check resolution wanted (the wheel tick is 1 ms).
  */
 void ttak_net_session_mgr_tick(ttak_net_session_mgr_t *mgr, uint64_t now);
 
@@ -0,0 +1,187 @@
+/**
+ * @file shm_ring.h
+ * @brief Shared-memory message ring between processes on one host.
+ *
+ * A ring lives in a shared memory object: a POSIX shm_open() name that
+ * sidecars open by name, or an anonymous memfd handed over by fork() or
+ * SCM_RIGHTS. The first page holds the control block and the rest is a
+ * power-of-two byte ring of variable-length records. Processes map the
+ * object at different addresses, so the ring stores positions, never
+ * pointers.
+ *
+ * A record is a ttak_net_shm_record_t header followed by its payload,
+ * padded to whole 64-byte granules. The header carries the timestamp,
+ * length, sequence and state fields of a ttak_net_lattice_slot_t, in the
+ * same order. Payloads are capped at TTAK_LATTICE_MAX_SLOT_SIZE, so every
+ * record fits a lattice slot class, and ttak_net_shm_ring_to_lattice()
+ * moves records into a lattice straight from the shared mapping. A record
+ * that would straddle the end of the ring is placed at the start, behind
+ * a padding record that consumers skip.
+ *
+ * In TTAK_NET_SHM_RING_SPSC mode one producer and one consumer (any
+ * process, any thread) move the cursors with plain stores. In
+ * TTAK_NET_SHM_RING_MPMC mode producers reserve space and consumers claim
+ * records with a CAS. Consumers then hand space back in ring order, so a
+ * consumer descheduled while holding a record delays reuse of the space
+ * behind it, though not claims. Blocking sends and receives park on
+ * process-shared eventcounts (futexes on Linux).
+ */
+
+#ifndef TTAK_NET_SHM_RING_H
+#define TTAK_NET_SHM_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include <ttak/net/lattice.h>
+#include <ttak/sync/waitword.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Record granule; record sizes and positions are multiples of it. */
+#define TTAK_NET_SHM_RING_ALIGN 64U
+
+/** Smallest ring; capacities are rounded up to a power of two. */
+#define TTAK_NET_SHM_RING_MIN_CAPACITY 4096U
+
+/** Records moved per ttak_net_shm_ring_to_lattice() sweep. */
+#define TTAK_NET_SHM_RING_BATCH 32U
+
+typedef enum ttak_net_shm_ring_mode {
+    TTAK_NET_SHM_RING_SPSC = 0, /**< One producer and one consumer. */
+    TTAK_NET_SHM_RING_MPMC = 1  /**< Any number of producers and consumers. */
+} ttak_net_shm_ring_mode_t;
+
+/**
+ * @brief Header in front of every record in the shared ring.
+ *
+ * Payload bytes follow directly and are 8-byte aligned.
+ */
+typedef struct ttak_net_shm_record {
+    uint64_t timestamp;         /**< @c now passed by the sender. */
+    uint32_t len;               /**< Payload bytes. */
+    uint32_t seq;               /**< Granule index of the record; increases along the ring. */
+    _Atomic uint64_t state;     /**< Ring position with a committed or padding tag; stale otherwise. */
+} ttak_net_shm_record_t;
+
+typedef struct ttak_net_shm_ring ttak_net_shm_ring_t;
+
+typedef ttak_net_shm_ring_t tt_net_shm_ring_t;
+
+/**
+ * @brief Counters kept by one process's handle.
+ */
+typedef struct ttak_net_shm_ring_stats {
+    uint64_t sent;              /**< Records this handle published. */
+    uint64_t received;          /**< Records this handle consumed. */
+    uint64_t full;              /**< Sends that found no room and had to wait or fail. */
+    uint64_t dropped;           /**< Records a lattice refused in ttak_net_shm_ring_to_lattice(). */
+} ttak_net_shm_ring_stats_t;
+
+/**
+ * @brief Creates a ring with at least @p capacity bytes of record space.
+ *
+ * @param name shm_open() name such as "/svc-ingress", created exclusively
+ *             with mode 0600; NULL creates an anonymous memfd, whose
+ *             descriptor ttak_net_shm_ring_fd() returns for handing over.
+ * @return The ring, or NULL with errno set (EEXIST if @p name is taken,
+ *         ENOTSUP where shared memory is unavailable).
+ */
+ttak_net_shm_ring_t *ttak_net_shm_ring_create(const char *name, size_t capacity, ttak_net_shm_ring_mode_t mode);
+
+/**
+ * @brief Opens the ring another process created under @p name.
+ *
+ * @return The ring, or NULL with errno set; EAGAIN while the creator is
+ *         still initializing it, EINVAL if the object is not a ring.
+ */
+ttak_net_shm_ring_t *ttak_net_shm_ring_open(const char *name);
+
+/**
+ * @brief Opens the ring behind @p fd; the handle keeps its own duplicate.
+ */
+ttak_net_shm_ring_t *ttak_net_shm_ring_open_fd(int fd);
+
+/**
+ * @brief Unmaps the ring and closes the handle's descriptor.
+ *
+ * The shared object lives on until every process has closed it and, for
+ * a named ring, until ttak_net_shm_ring_unlink().
+ */
+void ttak_net_shm_ring_close(ttak_net_shm_ring_t *ring);
+
+/**
+ * @brief Removes the name of a ring; processes that have it open keep it.
+ *
+ * @return 0, or an errno value.
+ */
+int ttak_net_shm_ring_unlink(const char *name);
+
+/**
+ * @brief Close-on-exec descriptor of the shared object.
+ */
+int ttak_net_shm_ring_fd(const ttak_net_shm_ring_t *ring);
+
+/**
+ * @brief Largest payload a record may carry.
+ *
+ * The lesser of TTAK_LATTICE_MAX_SLOT_SIZE and what fits in half the
+ * ring, so any record fits once consumers have drained it.
+ */
+uint32_t ttak_net_shm_ring_max_record(const ttak_net_shm_ring_t *ring);
+
+/**
+ * @brief Publishes @p len bytes of @p data as one record.
+ *
+ * Waits up to @p timeout_ns for room; 0 fails at once on a full ring and
+ * TTAK_WAIT_FOREVER waits indefinitely.
+ *
+ * @return False if the ring stayed full or @p len exceeds
+ *         ttak_net_shm_ring_max_record().
+ */
+bool ttak_net_shm_ring_send(ttak_net_shm_ring_t *ring, const void *data, uint32_t len, uint64_t now,
+                            uint64_t timeout_ns);
+
+/**
+ * @brief Consumes the next record into @p dst.
+ *
+ * Waits up to @p timeout_ns for a record, as ttak_net_shm_ring_send()
+ * waits for room.
+ *
+ * @param len_out Payload length of the record. A record longer than
+ *                @p cap is left in the ring, with false returned and its
+ *                length stored here; 0 when the ring stayed empty.
+ * @param ts_out  Sender's timestamp, or NULL.
+ * @return True if a record was consumed.
+ */
+bool ttak_net_shm_ring_recv(ttak_net_shm_ring_t *ring, void *dst, size_t cap, uint32_t *len_out,
+                            uint64_t *ts_out, uint64_t timeout_ns);
+
+/**
+ * @brief Moves up to @p budget records into @p lat as worker @p tid.
+ *
+ * Records are claimed TTAK_NET_SHM_RING_BATCH at a time and written with
+ * ttak_net_lattice_write_batch() straight from the shared mapping. A
+ * record the lattice refuses ends the call: in SPSC mode it stays in the
+ * ring with those behind it, in MPMC mode the claimed records from it on
+ * are counted as dropped. Does not wait for records.
+ *
+ * @return Records written to the lattice.
+ */
+size_t ttak_net_shm_ring_to_lattice(ttak_net_shm_ring_t *ring, ttak_net_lattice_t *lat, uint32_t tid,
+                                    size_t budget, uint64_t now);
+
+/**
+ * @brief Copies the handle's counters into @p out.
+ */
+void ttak_net_shm_ring_stats(const ttak_net_shm_ring_t *ring, ttak_net_shm_ring_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_NET_SHM_RING_H */
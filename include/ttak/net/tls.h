@@ -0,0 +1,175 @@
+/**
+ * @file tls.h
+ * @brief TLS record protection after the handshake, in the kernel or here.
+ *
+ * Once a userspace handshake has derived the traffic keys, they can be
+ * handed to Linux kernel TLS (TCP_ULP "tls"). The socket then takes
+ * plaintext: send(), MSG_ZEROCOPY and sendfile() all keep working and
+ * the kernel frames and encrypts the records. When the kernel, the
+ * platform or the cipher is not supported, the keys stay here and every
+ * record is sealed with ttak_aes256_gcm_execute() or
+ * ttak_chacha20_poly1305_execute() before it is sent.
+ *
+ * Only the transmit side falls back. A receive key the kernel refuses is
+ * left to the caller's own record layer, and ttak_net_tls_t says which
+ * side is offloaded.
+ */
+
+#ifndef TTAK_NET_TLS_H
+#define TTAK_NET_TLS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/net/endpoint.h>
+#include <ttak/security/key_schedule.h>
+#include <ttak/security/security_engine.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest plaintext one record carries. */
+#define TTAK_NET_TLS_MAX_PLAINTEXT 16384U
+
+/** Record header, explicit nonce and tag a record adds at most. */
+#define TTAK_NET_TLS_MAX_OVERHEAD (5U + 8U + 1U + 16U)
+
+/** TLS content type of application data. */
+#define TTAK_NET_TLS_APPLICATION_DATA 23U
+
+typedef enum ttak_net_tls_version {
+    TTAK_NET_TLS_1_2 = 0,
+    TTAK_NET_TLS_1_3
+} ttak_net_tls_version_t;
+
+typedef enum ttak_net_tls_cipher {
+    TTAK_NET_TLS_AES_256_GCM = 0,
+    TTAK_NET_TLS_CHACHA20_POLY1305
+} ttak_net_tls_cipher_t;
+
+typedef enum ttak_net_tls_mode {
+    TTAK_NET_TLS_MODE_NONE = 0,     /**< Not configured. */
+    TTAK_NET_TLS_MODE_USER,         /**< Records are protected by this library. */
+    TTAK_NET_TLS_MODE_KERNEL        /**< Records are protected by the kernel. */
+} ttak_net_tls_mode_t;
+
+/**
+ * @brief Traffic keys handed over by the handshake.
+ *
+ * Each direction is a crypto context with a 32-byte @c key and a 12-byte
+ * @c iv. For AES-256-GCM the IV is the 4-byte salt followed by the 8-byte
+ * IV; under TLS 1.2 that 8-byte part is the first explicit nonce.
+ */
+typedef struct ttak_net_tls_params {
+    ttak_net_tls_version_t version;
+    ttak_net_tls_cipher_t cipher;
+    const ttak_crypto_ctx_t *tx;    /**< Transmit key; required. */
+    uint64_t tx_seq;                /**< Sequence number of the next record sent. */
+    const ttak_crypto_ctx_t *rx;    /**< Receive key, or NULL to keep receiving in userspace. */
+    uint64_t rx_seq;
+    bool force_user;                /**< Skip the kernel and seal records here. */
+} ttak_net_tls_params_t;
+
+/**
+ * @brief Record protection state of one connection. Not thread-safe.
+ */
+typedef struct ttak_net_tls {
+    ttak_net_tls_mode_t tx_mode;
+    ttak_net_tls_mode_t rx_mode;    /**< NONE when the caller keeps decrypting. */
+    ttak_net_tls_version_t version;
+    ttak_net_tls_cipher_t cipher;
+    uint8_t key[32];                /**< Userspace mode only. */
+    uint8_t iv[12];
+    ttak_crypto_ctx_t ctx;          /**< Userspace mode: cipher state for @c key. */
+    ttak_security_schedule_t schedule; /**< Userspace AES-GCM: @c key expanded once for every record. */
+    uint64_t tx_seq;
+    uint8_t *record;                /**< Userspace mode: the record being sent. */
+    size_t record_len;
+    size_t record_off;              /**< Bytes of @c record already on the wire. */
+    uint64_t records;               /**< Records sealed in userspace. */
+} ttak_net_tls_t;
+
+typedef ttak_net_tls_t tt_net_tls_t;
+
+/**
+ * @brief Moves @p endpoint's socket to kernel TLS, or prepares userspace sealing.
+ *
+ * The transmit side always ends up in one of the two modes; check
+ * @c tx_mode to see which. The kernel only takes the keys of a TCP socket
+ * with no unsent records of its own.
+ *
+ * @return TTAK_IO_ERR_INVALID_ARGUMENT for a bad key or IV length.
+ */
+ttak_io_status_t ttak_net_tls_enable(ttak_net_tls_t *tls,
+                                     ttak_shared_net_endpoint_t *endpoint,
+                                     ttak_owner_t *owner,
+                                     const ttak_net_tls_params_t *params,
+                                     uint64_t now);
+
+/**
+ * @brief Wipes the keys and frees the record buffer.
+ */
+void ttak_net_tls_destroy(ttak_net_tls_t *tls);
+
+/**
+ * @brief Seals @p len bytes (at most TTAK_NET_TLS_MAX_PLAINTEXT) into one record at @p out.
+ *
+ * Advances the sequence number. Used by userspace mode; exposed for
+ * protocols that build records themselves.
+ *
+ * @param cap Room at @p out; @p len + TTAK_NET_TLS_MAX_OVERHEAD always fits.
+ */
+ttak_io_status_t ttak_net_tls_seal(ttak_net_tls_t *tls,
+                                   uint8_t content_type,
+                                   const void *data,
+                                   size_t len,
+                                   uint8_t *out,
+                                   size_t cap,
+                                   size_t *out_len);
+
+/**
+ * @brief Sends application data over the protected connection.
+ *
+ * In kernel mode this is one send() with @p flags, MSG_ZEROCOPY
+ * included. In userspace mode data goes out as sealed records and
+ * MSG_ZEROCOPY is dropped, since the record buffer is reused. A record
+ * cut short by a full socket buffer is finished by the next call before
+ * anything new is sent.
+ *
+ * @param sent Plaintext bytes accepted.
+ * @return TTAK_IO_ERR_NEEDS_RETRY if nothing could be sent without blocking.
+ */
+ttak_io_status_t ttak_net_tls_send(ttak_net_tls_t *tls,
+                                   ttak_shared_net_endpoint_t *endpoint,
+                                   ttak_owner_t *owner,
+                                   const void *data,
+                                   size_t len,
+                                   int flags,
+                                   size_t *sent,
+                                   uint64_t now);
+
+/**
+ * @brief Sends @p count bytes of @p in_fd from @p offset, the way sendfile() does.
+ *
+ * Kernel mode uses sendfile() on the TLS socket; userspace mode reads and
+ * seals the file a record at a time.
+ *
+ * @param offset Advanced by the bytes sent.
+ * @param sent   Bytes of the file sent.
+ */
+ttak_io_status_t ttak_net_tls_sendfile(ttak_net_tls_t *tls,
+                                       ttak_shared_net_endpoint_t *endpoint,
+                                       ttak_owner_t *owner,
+                                       int in_fd,
+                                       uint64_t *offset,
+                                       size_t count,
+                                       size_t *sent,
+                                       uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_NET_TLS_H */
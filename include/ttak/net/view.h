@@ -6,6 +6,7 @@
 
 #include <ttak/net/endpoint.h>
 #include <ttak/io/zerocopy.h>
+#include <ttak/io/mmap.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,6 +22,7 @@ typedef struct ttak_net_view {
     ttak_io_zerocopy_region_t region;
     ttak_net_lattice_slot_t *slot;
     ttak_net_lattice_t *slot_lattice;
+    ttak_io_mmap_t *map;        /**< Mapping the view references, if any. */
 } ttak_net_view_t;
 
 /**
@@ -38,6 +40,18 @@ ttak_io_status_t ttak_net_view_from_endpoint(ttak_net_view_t *view,
                                              int flags,
                                              uint64_t now);
 
+/**
+ * @brief Wires @p view to [@p offset, @p offset + @p len) of a file mapping.
+ *
+ * The view holds a reference on @p map until ttak_net_view_release(), so
+ * the bytes stay readable after ttak_io_mmap_close(). Nothing is copied.
+ */
+ttak_io_status_t ttak_net_view_from_mmap(ttak_net_view_t *view,
+                                         ttak_io_mmap_t *map,
+                                         size_t offset,
+                                         size_t len,
+                                         uint64_t now);
+
 /**
  * @brief Returns the immutable payload pointer held by the view.
  */
@@ -0,0 +1,251 @@
+/**
+ * @file workq.h
+ * @brief Coordinator/worker protocol that spreads a seed range over nodes.
+ *
+ * One coordinator owns a half-open range of 64-bit seeds and hands it out
+ * in leases of consecutive seeds over UDP, through the batch calls of a
+ * shared endpoint. A worker node keeps a few leases queued for its local
+ * threads, uploads result records in batches and reports each lease done.
+ *
+ * - Leases expire unless renewed. A worker renews the ones it holds with
+ *   periodic heartbeats, and any result batch naming a lease renews it
+ *   too. The coordinator hands expired ranges out again ahead of fresh
+ *   ones, so a node that dies costs one lease TTL of its work, not the
+ *   work itself.
+ * - Result batches are numbered per worker and acknowledged cumulatively,
+ *   go-back-N style, with a window of datagrams in flight. The
+ *   coordinator passes each new batch to a sink callback exactly once.
+ *   A lease that was reassigned may have its seeds reported by both
+ *   holders, so sinks should tolerate duplicates per seed.
+ * - Backpressure works at both ends. A sink that returns false makes the
+ *   coordinator refuse batches and grants for a back-off interval, and
+ *   workers then stop draining their result buffer. A full buffer blocks
+ *   ttak_net_workq_worker_submit(), which throttles the compute threads.
+ *
+ * Neither side owns a thread: the caller runs the poll function in a loop
+ * on a thread of its own. The worker's acquire, submit and complete calls
+ * are safe from any thread; the coordinator is driven by one thread only.
+ */
+
+#ifndef TTAK_NET_WORKQ_H
+#define TTAK_NET_WORKQ_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/net/endpoint.h>
+#include <ttak/mem/owner.h>
+#include <ttak/sync/waitword.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest datagram either side sends; fits an Ethernet MTU. */
+#define TTAK_NET_WORKQ_DATAGRAM 1400U
+
+/** Largest result record a worker may submit. */
+#define TTAK_NET_WORKQ_MAX_RECORD (TTAK_NET_WORKQ_DATAGRAM - 36U)
+
+/** Upper bound on leases one worker holds at a time. */
+#define TTAK_NET_WORKQ_MAX_WORKER_LEASES 32U
+
+/** Upper bound on result datagrams a worker keeps unacknowledged. */
+#define TTAK_NET_WORKQ_MAX_WINDOW 64U
+
+/**
+ * @brief Outcome of a worker call.
+ */
+typedef enum ttak_net_workq_status {
+    TTAK_NET_WORKQ_OK = 0,      /**< Done. */
+    TTAK_NET_WORKQ_WOULD_BLOCK, /**< Polled (timeout 0) and nothing was ready. */
+    TTAK_NET_WORKQ_TIMEOUT,     /**< The timeout passed first. */
+    TTAK_NET_WORKQ_FINISHED,    /**< The coordinator has completed the whole range. */
+    TTAK_NET_WORKQ_REVOKED,     /**< The lease expired and went to another worker. */
+    TTAK_NET_WORKQ_INVALID      /**< Unknown lease, oversized record or bad argument. */
+} ttak_net_workq_status_t;
+
+/**
+ * @brief Seeds [start, start + count) leased to one worker.
+ */
+typedef struct ttak_net_workq_lease {
+    uint64_t id;        /**< Never reused by a coordinator. */
+    uint64_t start;
+    uint64_t count;
+} ttak_net_workq_lease_t;
+
+/**
+ * @brief One uploaded record as the coordinator's sink sees it.
+ */
+typedef struct ttak_net_workq_result {
+    uint64_t worker;    /**< Worker id of the uploader. */
+    uint64_t lease;     /**< Lease the record was produced under. */
+    const void *data;   /**< Valid only during the sink call. */
+    uint32_t len;
+} ttak_net_workq_result_t;
+
+/**
+ * @brief Receives the records of one new batch, in upload order.
+ *
+ * @return False to refuse the batch; it is retried after the back-off.
+ */
+typedef bool (*ttak_net_workq_sink_fn)(const ttak_net_workq_result_t *results, size_t n, void *arg);
+
+/**
+ * @brief Coordinator settings; zero fields take the defaults shown.
+ */
+typedef struct ttak_net_workq_coord_config {
+    uint64_t first_seed;            /**< First seed handed out. */
+    uint64_t end_seed;              /**< One past the last seed; must exceed @c first_seed. */
+    uint64_t lease_seeds;           /**< Seeds per lease (4096). */
+    uint32_t lease_ttl_ms;          /**< Lease lifetime without renewal (10000). */
+    uint32_t busy_backoff_ms;       /**< Refusal period after the sink says no (100). */
+    uint32_t leases_per_worker;     /**< Leases one worker may hold (4). */
+    uint32_t max_leases;            /**< Leases outstanding across workers (1024, at most 65536). */
+    uint32_t max_workers;           /**< Workers tracked at once (256). */
+    ttak_net_workq_sink_fn sink;    /**< Required. */
+    void *sink_arg;
+} ttak_net_workq_coord_config_t;
+
+/**
+ * @brief Worker settings; zero fields take the defaults shown.
+ */
+typedef struct ttak_net_workq_worker_config {
+    uint64_t worker_id;             /**< Stable id across restarts; random if 0. */
+    uint32_t leases;                /**< Leases kept queued and running (4). */
+    uint32_t heartbeat_ms;          /**< Renewal period; keep well under the lease TTL (2000). */
+    uint32_t rto_ms;                /**< Retransmission and re-request timeout (200). */
+    uint32_t window;                /**< Result datagrams in flight (8). */
+    size_t max_pending_bytes;       /**< Result bytes buffered before submit blocks (65536). */
+} ttak_net_workq_worker_config_t;
+
+typedef struct ttak_net_workq_coord_stats {
+    uint64_t workers;               /**< Workers currently tracked. */
+    uint64_t granted;               /**< Leases handed out, reissues included. */
+    uint64_t reassigned;            /**< Leases that expired and were put back. */
+    uint64_t completed;             /**< Leases reported done by their holder. */
+    uint64_t results;               /**< Records passed to the sink. */
+    uint64_t duplicates;            /**< Result datagrams seen again or out of order. */
+    uint64_t refused;               /**< Batches refused while the sink was busy. */
+} ttak_net_workq_coord_stats_t;
+
+typedef struct ttak_net_workq_worker_stats {
+    uint64_t leases;                /**< Leases received. */
+    uint64_t revoked;               /**< Leases the coordinator took back. */
+    uint64_t records;               /**< Records submitted. */
+    uint64_t batches;               /**< Result datagrams sent, retransmissions excluded. */
+    uint64_t retransmits;           /**< Result datagrams sent again. */
+    uint64_t refused;               /**< Acknowledgements that said the sink was busy. */
+} ttak_net_workq_worker_stats_t;
+
+typedef struct ttak_net_workq_coord ttak_net_workq_coord_t;
+typedef struct ttak_net_workq_worker ttak_net_workq_worker_t;
+
+typedef ttak_net_workq_coord_t tt_net_workq_coord_t;
+typedef ttak_net_workq_worker_t tt_net_workq_worker_t;
+
+/**
+ * @brief Creates a coordinator serving on @p endpoint, a bound UDP socket.
+ *
+ * The endpoint stays the caller's; it must outlive the coordinator.
+ *
+ * @return NULL on a bad configuration or allocation failure.
+ */
+ttak_net_workq_coord_t *ttak_net_workq_coord_create(const ttak_net_workq_coord_config_t *cfg,
+                                                    ttak_shared_net_endpoint_t *endpoint,
+                                                    ttak_owner_t *owner);
+
+void ttak_net_workq_coord_destroy(ttak_net_workq_coord_t *coord);
+
+/**
+ * @brief Handles queued datagrams, waiting up to @p wait_ms for the first,
+ *        and expires leases that are overdue at @p now.
+ *
+ * @param now Milliseconds, as from ttak_get_tick_count().
+ * @return Datagrams handled.
+ */
+size_t ttak_net_workq_coord_poll(ttak_net_workq_coord_t *coord, uint32_t wait_ms, uint64_t now);
+
+/**
+ * @brief True once every seed has been leased and every lease completed.
+ */
+bool ttak_net_workq_coord_finished(const ttak_net_workq_coord_t *coord);
+
+void ttak_net_workq_coord_stats(const ttak_net_workq_coord_t *coord, ttak_net_workq_coord_stats_t *out);
+
+/**
+ * @brief Creates a worker that talks to the coordinator at @p addr.
+ *
+ * @param endpoint UDP endpoint; @p addr may be NULL if its socket is
+ *                 connected to the coordinator.
+ * @return NULL on a bad configuration or allocation failure.
+ */
+ttak_net_workq_worker_t *ttak_net_workq_worker_create(const ttak_net_workq_worker_config_t *cfg,
+                                                      ttak_shared_net_endpoint_t *endpoint,
+                                                      ttak_owner_t *owner,
+                                                      const void *addr,
+                                                      uint32_t addr_len);
+
+/**
+ * @brief Destroys the worker; records not yet acknowledged are lost.
+ */
+void ttak_net_workq_worker_destroy(ttak_net_workq_worker_t *worker);
+
+/**
+ * @brief Sends what is due (requests, heartbeats, result batches and
+ *        retransmissions) and handles replies, waiting up to @p wait_ms.
+ *
+ * Submitted records leave at the next poll, so @p wait_ms bounds the
+ * upload latency.
+ *
+ * @param now Milliseconds, as from ttak_get_tick_count().
+ * @return Datagrams handled.
+ */
+size_t ttak_net_workq_worker_poll(ttak_net_workq_worker_t *worker, uint32_t wait_ms, uint64_t now);
+
+/**
+ * @brief Takes a queued lease for the calling thread to work on.
+ *
+ * Waits up to @p timeout_ns; 0 polls and TTAK_WAIT_FOREVER blocks.
+ *
+ * @return TTAK_NET_WORKQ_OK with @p out filled, or TTAK_NET_WORKQ_FINISHED
+ *         once the coordinator has nothing left at all.
+ */
+ttak_net_workq_status_t ttak_net_workq_worker_acquire(ttak_net_workq_worker_t *worker,
+                                                      ttak_net_workq_lease_t *out,
+                                                      uint64_t timeout_ns);
+
+/**
+ * @brief Queues one result record of lease @p lease for upload.
+ *
+ * Waits up to @p timeout_ns for room in the result buffer.
+ *
+ * @return TTAK_NET_WORKQ_REVOKED if the lease was taken back; the caller
+ *         may stop working on it.
+ */
+ttak_net_workq_status_t ttak_net_workq_worker_submit(ttak_net_workq_worker_t *worker, uint64_t lease,
+                                                     const void *data, uint32_t len, uint64_t timeout_ns);
+
+/**
+ * @brief Reports lease @p lease done, behind every record submitted for it.
+ *
+ * The lease's slot is refilled once the coordinator acknowledges it.
+ */
+ttak_net_workq_status_t ttak_net_workq_worker_complete(ttak_net_workq_worker_t *worker, uint64_t lease,
+                                                       uint64_t timeout_ns);
+
+/**
+ * @brief True when the coordinator said it finished and nothing is left to upload.
+ */
+bool ttak_net_workq_worker_finished(ttak_net_workq_worker_t *worker);
+
+uint64_t ttak_net_workq_worker_id(const ttak_net_workq_worker_t *worker);
+
+void ttak_net_workq_worker_stats(ttak_net_workq_worker_t *worker, ttak_net_workq_worker_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_NET_WORKQ_H */
@@ -2,6 +2,7 @@
 #define TTAK_PHYS_DIMLESS_TRANSPORT_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -143,6 +144,119 @@ ttak_phys_status_t ttak_phys_calc_km(
     double length,
     double diffusivity);
 
+/*
+ * Batched (structure-of-arrays) variants.
+ *
+ * Each takes one array per argument of the scalar call and fills out[i]
+ * from element i of every input, applying the same checks per lane. The
+ * lanes run in tiles whose loops carry no branches, so the checks become
+ * vector compare masks and the compiler emits SIMD code for the build's
+ * target. A lane that fails a check gets NaN in its output and its status
+ * code in batch->status; the others are unaffected. Results agree with
+ * the scalar calls to within a few ulps (L^3 is a product, not pow()).
+ */
+
+struct ttak_thread_pool;
+
+/** @brief Lanes per tile of a batched call. */
+#define TTAK_PHYS_BATCH_TILE 256
+
+/**
+ * @brief How a batched call runs and where it reports per-lane status.
+ */
+typedef struct ttak_phys_batch {
+    size_t count;                  /**< Lanes in every array. */
+    uint8_t *status;               /**< Optional: ttak_phys_status_t of each lane. */
+    struct ttak_thread_pool *pool; /**< Optional: splits the lanes with ttak_parallel_for(). */
+    size_t grain;                  /**< Lanes per chunk on the pool; 0 picks one. */
+    uint64_t now;                  /**< Timestamp handed to the pool. */
+} ttak_phys_batch_t;
+
+/*
+ * The batched calls return TTAK_PHYS_ERR_INVALID_ARGUMENT when @p batch,
+ * the output or an input array is NULL (and count is not 0), and otherwise
+ * the status of the lowest-numbered failing lane, or TTAK_PHYS_SUCCESS.
+ * The output may alias an input; the status array may not overlap either.
+ */
+
+/** @brief Batched ttak_phys_calc_reynolds(). */
+ttak_phys_status_t ttak_phys_calc_reynolds_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_re,
+    const double *rho,
+    const double *velocity,
+    const double *length,
+    const double *dynamic_viscosity);
+
+/** @brief Batched ttak_phys_calc_schmidt(). */
+ttak_phys_status_t ttak_phys_calc_schmidt_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_sc,
+    const double *rho,
+    const double *dynamic_viscosity,
+    const double *diffusivity);
+
+/** @brief Batched ttak_phys_calc_mass_peclet(). */
+ttak_phys_status_t ttak_phys_calc_mass_peclet_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_pe,
+    const double *velocity,
+    const double *length,
+    const double *diffusivity);
+
+/** @brief Batched ttak_phys_calc_sherwood(). */
+ttak_phys_status_t ttak_phys_calc_sherwood_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_sh,
+    const double *mass_transfer_coeff,
+    const double *length,
+    const double *diffusivity);
+
+/** @brief Batched ttak_phys_calc_prandtl(). */
+ttak_phys_status_t ttak_phys_calc_prandtl_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_pr,
+    const double *dynamic_viscosity,
+    const double *specific_heat,
+    const double *thermal_conductivity);
+
+/** @brief Batched ttak_phys_calc_grashof(). */
+ttak_phys_status_t ttak_phys_calc_grashof_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_gr,
+    const double *gravity,
+    const double *expansion_coeff,
+    const double *delta_temp,
+    const double *length,
+    const double *rho,
+    const double *dynamic_viscosity);
+
+/** @brief Batched ttak_phys_calc_grashof_mass(). */
+ttak_phys_status_t ttak_phys_calc_grashof_mass_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_grm,
+    const double *gravity,
+    const double *expansion_coeff_mass,
+    const double *delta_conc,
+    const double *length,
+    const double *rho,
+    const double *dynamic_viscosity);
+
+/** @brief Batched ttak_phys_calc_rayleigh(). */
+ttak_phys_status_t ttak_phys_calc_rayleigh_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_ra,
+    const double *grashof,
+    const double *pr_or_sc);
+
+/** @brief Batched ttak_phys_calc_km(). */
+ttak_phys_status_t ttak_phys_calc_km_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_km,
+    const double *sherwood,
+    const double *length,
+    const double *diffusivity);
+
 #ifdef __cplusplus
 }
 #endif
@@ -58,6 +58,88 @@ void ttak_mem_buddy_init(void *pool_start, size_t pool_len, int embedded_mode);
  */
 void ttak_mem_buddy_set_pool(void *pool_start, size_t pool_len);
 
+/** @brief Number of buddy orders reported by ttak_mem_buddy_stats(). */
+#define TTAK_MEM_BUDDY_ORDER_COUNT 61U
+
+/**
+ * @brief Occupancy and fragmentation of the buddy pool.
+ */
+typedef struct ttak_mem_buddy_stats {
+    size_t pool_bytes;                                 /**< Bytes across all pool segments. */
+    size_t bytes_in_use;                               /**< Bytes in allocated blocks (whole orders). */
+    size_t free_blocks[TTAK_MEM_BUDDY_ORDER_COUNT];    /**< Free-list length per order. */
+    size_t largest_free_block;                         /**< Size of the largest free block, 0 if none. */
+} ttak_mem_buddy_stats_t;
+
+/**
+ * @brief Walks the buddy free lists under the pool locks.
+ *
+ * Blocks parked in per-thread magazines count as in use.
+ *
+ * @param out Receives the snapshot.
+ */
+void ttak_mem_buddy_stats(ttak_mem_buddy_stats_t *out);
+
+/**
+ * @brief Runs one slice of the incremental free-list coalescer.
+ *
+ * Merges free buddy pairs order by order and resumes where the previous
+ * slice stopped, so repeated calls sweep the whole pool without holding
+ * the locks for long. Allocations only take the per-order locks the slice
+ * is not using at that moment.
+ *
+ * @param budget_ns Time the slice may run for; UINT64_MAX to finish the pass.
+ * @return Number of merges performed.
+ */
+size_t ttak_mem_buddy_coalesce_step(uint64_t budget_ns);
+
+/**
+ * @brief Returns fully free auto-grown segments to the OS.
+ *
+ * Only segments the allocator grew on its own are released; a pool passed
+ * to ttak_mem_buddy_init() stays. Capacity never drops below @p keep_bytes
+ * or below twice the bytes in use. Blocks parked in per-thread magazines
+ * or awaiting epoch reclamation keep their segment mapped.
+ *
+ * @param keep_bytes Capacity to keep mapped regardless of use.
+ * @return Bytes released.
+ */
+size_t ttak_mem_buddy_release_free_segments(size_t keep_bytes);
+
+/** @brief Default interval between compactor ticks (10 ms). */
+#define TTAK_MEM_BUDDY_COMPACTOR_INTERVAL_NS 10000000ULL
+/** @brief Default coalescing budget per compactor tick (200 us). */
+#define TTAK_MEM_BUDDY_COMPACTOR_BUDGET_NS 200000ULL
+/** @brief Default capacity the compactor keeps mapped (1 MB). */
+#define TTAK_MEM_BUDDY_COMPACTOR_KEEP_BYTES ((size_t)1 << 20)
+
+/**
+ * @brief Settings for ttak_mem_buddy_start_compactor().
+ */
+typedef struct ttak_mem_buddy_compactor_config {
+    uint64_t interval_ns;   /**< Time between ticks; 0 selects the default. */
+    uint64_t budget_ns;     /**< Coalescing time per tick; 0 selects the default. */
+    size_t keep_bytes;      /**< Capacity kept when releasing segments; SIZE_MAX never releases. */
+} ttak_mem_buddy_compactor_config_t;
+
+/**
+ * @brief Starts a background thread that coalesces and trims the pool.
+ *
+ * Each tick runs ttak_mem_buddy_coalesce_step() with the configured budget
+ * and then ttak_mem_buddy_release_free_segments(), so high-order requests
+ * find merged blocks instead of growing the zone.
+ *
+ * @param config Compactor settings, or NULL for the defaults.
+ * @return 0 on success, EALREADY if the compactor is running, or the
+ *         error from thread creation.
+ */
+int ttak_mem_buddy_start_compactor(const ttak_mem_buddy_compactor_config_t *config);
+
+/**
+ * @brief Stops and joins the background compactor, if any.
+ */
+void ttak_mem_buddy_stop_compactor(void);
+
 /**
  * @brief Allocates a block from the buddy pool.
  *
@@ -66,6 +148,19 @@ void ttak_mem_buddy_set_pool(void *pool_start, size_t pool_len);
  */
 void *ttak_mem_buddy_alloc(const ttak_mem_req_t *req);
 
+/**
+ * @brief Grows an allocated block in place to hold @p size_bytes.
+ *
+ * Absorbs the block's free upper buddies one order at a time. If the block
+ * is itself an upper half, or a buddy it needs is in use, the block is left
+ * as it was.
+ *
+ * @param ptr        Pointer returned by ttak_mem_buddy_alloc().
+ * @param size_bytes Bytes the block must hold, as passed to ttak_mem_buddy_alloc().
+ * @return           Non-zero if the block now holds @p size_bytes.
+ */
+int ttak_mem_buddy_grow(void *ptr, size_t size_bytes);
+
 /**
  * @brief Returns a previously allocated block to the buddy pool.
  *
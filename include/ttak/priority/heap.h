@@ -46,4 +46,91 @@ void *ttak_heap_tree_peek(const ttak_heap_tree_t *heap);
  */
 void ttak_heap_tree_destroy(ttak_heap_tree_t *heap, uint64_t now);
 
+/** Children per d-ary heap node; 4 entries of 16 bytes fill one cache line. */
+#ifndef TTAK_DHEAP_ARITY
+#define TTAK_DHEAP_ARITY 4
+#endif
+
+/** Handle value meaning "no entry". */
+#define TTAK_DHEAP_NONE UINT32_MAX
+
+/**
+ * @brief One d-ary heap slot: the key and its payload, stored inline.
+ */
+typedef struct ttak_dheap_entry {
+    uint64_t key;
+    uintptr_t payload;
+} ttak_dheap_entry_t;
+
+/**
+ * @brief Fixed-capacity implicit d-ary min-heap on u64 keys.
+ *
+ * Entries sit in one array, offset so that each node's TTAK_DHEAP_ARITY
+ * children share a cache line. Every entry has a stable handle, so entries
+ * can be re-keyed or removed in O(log n). All storage is allocated at
+ * init; push never reallocates and fails once the heap is full. Not
+ * thread-safe: give each timer or scheduler thread its own heap.
+ */
+typedef struct ttak_dheap {
+    ttak_dheap_entry_t *entries;    /**< Position p lives at entries[p]; 64-byte aligned sibling groups. */
+    void *block;                    /**< Allocation behind @c entries. */
+    uint32_t *handles;              /**< Handle of the entry at each position. */
+    uint32_t *where;                /**< Position of each live handle; the next free handle for free ones. */
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t free_head;             /**< First free handle, or TTAK_DHEAP_NONE. */
+} ttak_dheap_t;
+
+/**
+ * @brief Allocates room for @p capacity entries.
+ *
+ * @return False on allocation failure or a zero @p capacity.
+ */
+bool ttak_dheap_init(ttak_dheap_t *heap, uint32_t capacity);
+
+/**
+ * @brief Frees the heap's storage; payloads are not touched.
+ */
+void ttak_dheap_destroy(ttak_dheap_t *heap);
+
+/**
+ * @brief Adds @p payload under @p key.
+ *
+ * @return The entry's handle, or TTAK_DHEAP_NONE if the heap is full.
+ */
+uint32_t ttak_dheap_push(ttak_dheap_t *heap, uint64_t key, uintptr_t payload);
+
+/**
+ * @brief Reads the entry with the smallest key; either out pointer may be NULL.
+ *
+ * @return False if the heap is empty.
+ */
+bool ttak_dheap_peek(const ttak_dheap_t *heap, uint64_t *key, uintptr_t *payload);
+
+/**
+ * @brief Removes the entry with the smallest key; either out pointer may be NULL.
+ *
+ * @return False if the heap is empty.
+ */
+bool ttak_dheap_pop(ttak_dheap_t *heap, uint64_t *key, uintptr_t *payload);
+
+/**
+ * @brief Changes the key of entry @p handle, moving it up or down as needed.
+ *
+ * @return False if @p handle is not live.
+ */
+bool ttak_dheap_update(ttak_dheap_t *heap, uint32_t handle, uint64_t key);
+
+/**
+ * @brief Removes entry @p handle; @p payload may be NULL.
+ *
+ * @return False if @p handle is not live.
+ */
+bool ttak_dheap_remove(ttak_dheap_t *heap, uint32_t handle, uintptr_t *payload);
+
+/**
+ * @brief True if @p handle names a live entry.
+ */
+bool ttak_dheap_contains(const ttak_dheap_t *heap, uint32_t handle);
+
 #endif // TTAK_PRIORITY_HEAP_H
@@ -1,32 +1,51 @@
 /**
  * @file queue.h (internal)
- * @brief Internal priority-queue node and vtable types.
+ * @brief Internal priority-queue band and vtable types.
  *
  * These types are implementation details of the priority subsystem.
  * External code should use the public API in ttak/priority/queue.h.
+ *
+ * The queue is a bounded, lock-free multi-level queue: priorities are
+ * clamped into TTAK_PQ_BANDS bands, each band is a multi-producer /
+ * multi-consumer ring, and a bitmap of non-empty bands lets pop find the
+ * most urgent band with one count-leading-zeros. Tasks of equal band leave
+ * in FIFO order. A band's ring is allocated the first time it is used, so
+ * steady-state push and pop never allocate.
+ *
+ * Define TTAK_QUEUE_TRACE to log every push and pop to stderr.
  */
 
 #ifndef __TTAK_INTERNAL_QUEUE_H__
 #define __TTAK_INTERNAL_QUEUE_H__
 
 #include <ttak/async/task.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <pthread.h>
 
-struct __internal_ttak_qnode_t {
-    ttak_task_t *task;
-    int priority;
-    struct __internal_ttak_qnode_t *next;
-};
+/** Number of priority bands; one bit each in the non-empty bitmap. */
+#define TTAK_PQ_BANDS 64
+
+/** Lowest priority with its own band; anything lower shares band 0. */
+#define TTAK_PQ_PRIORITY_MIN (-(TTAK_PQ_BANDS / 2))
+
+/** Highest priority with its own band; anything higher shares the top band. */
+#define TTAK_PQ_PRIORITY_MAX (TTAK_PQ_BANDS / 2 - 1)
+
+/** Tasks each band holds before push reports the queue full. Power of two. */
+#define TTAK_PQ_BAND_CAPACITY 1024
+
+typedef struct __internal_ttak_pq_ring_t __internal_ttak_pq_ring_t;
 
 struct __internal_ttak_proc_priority_queue_t {
-    struct __internal_ttak_qnode_t *head;
-    size_t size;
+    _Atomic uint64_t nonempty;                              /**< Bit b set: band b may hold tasks. */
+    _Atomic size_t size;                                    /**< Approximate task count. */
+    __internal_ttak_pq_ring_t *_Atomic bands[TTAK_PQ_BANDS]; /**< Lazily allocated rings. */
     size_t cap;
 
     void (*init)(struct __internal_ttak_proc_priority_queue_t *q);
-    void (*push)(struct __internal_ttak_proc_priority_queue_t *q, ttak_task_t *task, int priority, uint64_t now);
+    _Bool (*push)(struct __internal_ttak_proc_priority_queue_t *q, ttak_task_t *task, int priority, uint64_t now);
     ttak_task_t *(*pop)(struct __internal_ttak_proc_priority_queue_t *q, uint64_t now);
     ttak_task_t *(*pop_blocking)(struct __internal_ttak_proc_priority_queue_t *q, pthread_mutex_t *mutex, pthread_cond_t *cond, uint64_t now);
     size_t (*get_size)(struct __internal_ttak_proc_priority_queue_t *q);
@@ -35,4 +54,11 @@ struct __internal_ttak_proc_priority_queue_t {
 
 void ttak_priority_queue_init(struct __internal_ttak_proc_priority_queue_t *q);
 
-#endif // __TTAK_INTERNAL_QUEUE_H__
\ No newline at end of file
+/**
+ * @brief Frees the band rings. Tasks still queued are not destroyed.
+ *
+ * No thread may use the queue afterwards.
+ */
+void ttak_priority_queue_destroy(struct __internal_ttak_proc_priority_queue_t *q);
+
+#endif // __TTAK_INTERNAL_QUEUE_H__
@@ -5,6 +5,4 @@
 
 #include <ttak/priority/internal/queue.h>
 
-typedef struct __internal_ttak_qnode_t __i_tt_qn_t;
-
 typedef struct __internal_ttak_proc_priority_queue_t __i_tt_proc_pq_t;
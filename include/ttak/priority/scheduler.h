@@ -14,6 +14,16 @@
 #include <ttak/priority/nice.h>
 #include <ttak/async/task.h>
 
+/** Slots in the execution-history table (power of two). */
+#ifndef TTAK_SCHED_HISTORY_SLOTS
+#define TTAK_SCHED_HISTORY_SLOTS 4096
+#endif
+
+/** Slots probed per lookup before the newest hash evicts one. */
+#ifndef TTAK_SCHED_HISTORY_PROBE
+#define TTAK_SCHED_HISTORY_PROBE 8
+#endif
+
 typedef struct ttak_scheduler ttak_scheduler_t;
 
 struct ttak_scheduler {
@@ -30,7 +40,7 @@ ttak_scheduler_t *ttak_scheduler_get_instance(void);
 
 /**
  * @brief Initialize the scheduler's internal history tracking.
- * Must be called once before using smart features.
+ * The history table needs no setup; kept for API compatibility.
  */
 void ttak_scheduler_init(void);
 
@@ -41,6 +51,14 @@ void ttak_scheduler_init(void);
  */
 void ttak_scheduler_record_execution(ttak_task_t *task, uint64_t duration_ms);
 
+/**
+ * @brief Reads the EWMA duration recorded for a task hash.
+ * @param hash Task hash as returned by ttak_task_get_hash().
+ * @param avg_ms Receives the average in milliseconds; may be NULL.
+ * @return True if the hash has history.
+ */
+_Bool ttak_scheduler_history_get(uint64_t hash, uint64_t *avg_ms);
+
 /**
  * @brief Calculate an adjusted priority based on history (SJF) and user priority.
  * @param task The task to evaluate.
@@ -1,6 +1,7 @@
 #ifndef TTAK_PRIORITY_SIMPLE_H
 #define TTAK_PRIORITY_SIMPLE_H
 
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -118,4 +119,102 @@ size_t ttak_simple_stack_size(const ttak_simple_stack_t *s);
  */
 void ttak_simple_stack_destroy(ttak_simple_stack_t *s, uint64_t now);
 
+/** Elimination slots a contended ttak_simple_mpmc_stack_t tries before retrying its CAS. */
+#define TTAK_SIMPLE_ELIM_SLOTS 8
+
+/**
+ * @brief Node of the concurrent queue and stack, recycled through a pool.
+ */
+typedef struct ttak_simple_mpmc_node {
+    void *data;
+    struct ttak_simple_mpmc_node *_Atomic next;
+    struct ttak_simple_mpmc_pool *owner;    /**< Pool the node returns to once no reader can hold it. */
+} ttak_simple_mpmc_node_t;
+
+/** Node pool shared by a container and the nodes still waiting in EBR. */
+typedef struct ttak_simple_mpmc_pool ttak_simple_mpmc_pool_t;
+
+/**
+ * @brief Lock-free MPMC FIFO queue (Michael-Scott).
+ *
+ * Head and tail sit on separate cache lines, so producers and consumers
+ * only meet when the queue is nearly empty. Dequeued dummies are retired
+ * through ttak_epoch_retire() and then go back to a per-queue object
+ * pool, so steady traffic allocates nothing.
+ */
+typedef struct ttak_simple_mpmc_queue {
+    _Alignas(64) ttak_simple_mpmc_node_t *_Atomic head;     /**< Dummy; its successor holds the front. */
+    _Alignas(64) ttak_simple_mpmc_node_t *_Atomic tail;
+    _Alignas(64) _Atomic size_t size;
+    ttak_simple_mpmc_pool_t *pool;
+} ttak_simple_mpmc_queue_t;
+
+/**
+ * @brief Lock-free MPMC LIFO stack (Treiber) with elimination backoff.
+ *
+ * A push or pop that loses the CAS on @c top tries to meet an opposite
+ * operation in a random elimination slot and completes with it without
+ * touching @c top. Nodes are recycled like the queue's.
+ */
+typedef struct ttak_simple_mpmc_stack {
+    _Alignas(64) ttak_simple_mpmc_node_t *_Atomic top;
+    _Alignas(64) ttak_simple_mpmc_node_t *_Atomic elim[TTAK_SIMPLE_ELIM_SLOTS];
+    _Alignas(64) _Atomic size_t size;
+    ttak_simple_mpmc_pool_t *pool;
+} ttak_simple_mpmc_stack_t;
+
+/**
+ * @brief Initializes an empty concurrent queue.
+ *
+ * @return False on allocation failure.
+ */
+bool ttak_simple_mpmc_queue_init(ttak_simple_mpmc_queue_t *q);
+/**
+ * @brief Enqueues @p data at the tail; safe from any thread.
+ *
+ * @return False if no node could be allocated.
+ */
+bool ttak_simple_mpmc_queue_push(ttak_simple_mpmc_queue_t *q, void *data);
+/**
+ * @brief Dequeues the head element into @p out; safe from any thread.
+ *
+ * @return False when the queue is empty.
+ */
+bool ttak_simple_mpmc_queue_pop(ttak_simple_mpmc_queue_t *q, void **out);
+/**
+ * @brief Element count; exact only while no thread pushes or pops.
+ */
+size_t ttak_simple_mpmc_queue_size(ttak_simple_mpmc_queue_t *q);
+/**
+ * @brief Frees the queue. No other thread may be using it.
+ */
+void ttak_simple_mpmc_queue_destroy(ttak_simple_mpmc_queue_t *q);
+
+/**
+ * @brief Initializes an empty concurrent stack.
+ *
+ * @return False on allocation failure.
+ */
+bool ttak_simple_mpmc_stack_init(ttak_simple_mpmc_stack_t *s);
+/**
+ * @brief Pushes @p data; safe from any thread.
+ *
+ * @return False if no node could be allocated.
+ */
+bool ttak_simple_mpmc_stack_push(ttak_simple_mpmc_stack_t *s, void *data);
+/**
+ * @brief Pops the top element into @p out; safe from any thread.
+ *
+ * @return False when the stack is empty.
+ */
+bool ttak_simple_mpmc_stack_pop(ttak_simple_mpmc_stack_t *s, void **out);
+/**
+ * @brief Element count; exact only while no thread pushes or pops.
+ */
+size_t ttak_simple_mpmc_stack_size(ttak_simple_mpmc_stack_t *s);
+/**
+ * @brief Frees the stack. No other thread may be using it.
+ */
+void ttak_simple_mpmc_stack_destroy(ttak_simple_mpmc_stack_t *s);
+
 #endif // TTAK_PRIORITY_SIMPLE_H
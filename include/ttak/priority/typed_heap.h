@@ -0,0 +1,112 @@
+/**
+ * @file typed_heap.h
+ * @brief Type-specialized growable min-heap.
+ *
+ * TTAK_HEAP_DEFINE(name, T, less) expands to a heap type @c name_t over a
+ * typed array and static inline @c name_push / @c name_pop. Elements are
+ * stored by value rather than as @c void* pointers, and @p less(a, b) is
+ * substituted as an expression, so sifting compares inline instead of
+ * calling through a comparator the way @c ttak_heap_tree_t does. The root
+ * is the element no other is less than; pass a reversed @p less for a
+ * max-heap.
+ *
+ * Nodes have TTAK_TYPED_HEAP_ARITY children, which keeps the tree shallow
+ * and a node's children on one or two cache lines for small @p T.
+ *
+ * Not thread-safe.
+ */
+
+#ifndef TTAK_PRIORITY_TYPED_HEAP_H
+#define TTAK_PRIORITY_TYPED_HEAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <ttak/mem/mem.h>
+
+/** Children per node. */
+#ifndef TTAK_TYPED_HEAP_ARITY
+#define TTAK_TYPED_HEAP_ARITY 4
+#endif
+
+#define TTAK_HEAP_DEFINE(name, T, less)                                                                \
+    typedef struct name {                                                                              \
+        T *data;                                                                                       \
+        size_t size;                                                                                   \
+        size_t capacity;                                                                               \
+    } name##_t;                                                                                        \
+                                                                                                       \
+    /** @brief Initializes an empty heap; @p initial_cap may be 0. */                                  \
+    static inline bool name##_init(name##_t *h, size_t initial_cap) {                                  \
+        h->size = 0;                                                                                   \
+        h->capacity = initial_cap;                                                                     \
+        h->data = NULL;                                                                                \
+        if (initial_cap == 0) return true;                                                             \
+        h->data = (T *)ttak_dangerous_alloc(initial_cap * sizeof(T));                                  \
+        return h->data != NULL;                                                                        \
+    }                                                                                                  \
+                                                                                                       \
+    static inline void name##_destroy(name##_t *h) {                                                   \
+        ttak_dangerous_free(h->data);                                                                  \
+        h->data = NULL;                                                                                \
+        h->size = h->capacity = 0;                                                                     \
+    }                                                                                                  \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Adds @p item, doubling the array when full.                                              \
+     * @return False on allocation failure.                                                            \
+     */                                                                                                \
+    static inline bool name##_push(name##_t *h, T item) {                                              \
+        if (h->size == h->capacity) {                                                                  \
+            size_t cap = h->capacity ? h->capacity * 2 : 16;                                           \
+            T *data = (T *)ttak_dangerous_alloc(cap * sizeof(T));                                      \
+            if (!data) return false;                                                                   \
+            if (h->size) memcpy(data, h->data, h->size * sizeof(T));                                   \
+            ttak_dangerous_free(h->data);                                                              \
+            h->data = data;                                                                            \
+            h->capacity = cap;                                                                         \
+        }                                                                                              \
+        size_t i = h->size++;                                                                          \
+        while (i > 0) {                                                                                \
+            size_t parent = (i - 1) / TTAK_TYPED_HEAP_ARITY;                                           \
+            if (!(less(item, h->data[parent]))) break;                                                 \
+            h->data[i] = h->data[parent];                                                              \
+            i = parent;                                                                                \
+        }                                                                                              \
+        h->data[i] = item;                                                                             \
+        return true;                                                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    /**                                                                                                \
+     * @brief Removes the root into @p out.                                                            \
+     * @return False if the heap is empty.                                                             \
+     */                                                                                                \
+    static inline bool name##_pop(name##_t *h, T *out) {                                               \
+        if (h->size == 0) return false;                                                                \
+        *out = h->data[0];                                                                             \
+        T last = h->data[--h->size];                                                                   \
+        size_t n = h->size;                                                                            \
+        size_t i = 0;                                                                                  \
+        for (;;) {                                                                                     \
+            size_t first = i * TTAK_TYPED_HEAP_ARITY + 1;                                              \
+            if (first >= n) break;                                                                     \
+            size_t end = first + TTAK_TYPED_HEAP_ARITY < n ? first + TTAK_TYPED_HEAP_ARITY : n;        \
+            size_t best = first;                                                                       \
+            for (size_t c = first + 1; c < end; c++) {                                                 \
+                if (less(h->data[c], h->data[best])) best = c;                                         \
+            }                                                                                          \
+            if (!(less(h->data[best], last))) break;                                                   \
+            h->data[i] = h->data[best];                                                                \
+            i = best;                                                                                  \
+        }                                                                                              \
+        if (n) h->data[i] = last;                                                                      \
+        return true;                                                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    /** @brief The root, or NULL if the heap is empty. */                                              \
+    static inline const T *name##_peek(const name##_t *h) { return h->size ? &h->data[0] : NULL; }     \
+                                                                                                       \
+    static inline size_t name##_size(const name##_t *h) { return h->size; }
+
+#endif // TTAK_PRIORITY_TYPED_HEAP_H
@@ -7,6 +7,7 @@
 #include <ttak/math/bigint.h>
 #include <ttak/math/bigreal.h>
 #include <ttak/math/bigcomplex.h>
+#include <ttak/thread/pool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -93,12 +94,16 @@ typedef struct {
 
 /**
  * @brief Compiles source code into an immutable program.
+ *
+ * Integer constant expressions are folded and constant conditions resolved
+ * here, so per-seed evaluation pays only for what depends on the inputs.
+ *
  * @param source Null-terminated source string.
  * @param loader Optional loader for include/import.
  * @param limits Safety limits to apply.
  * @param err Error output structure.
  * @param now Monotonic timestamp.
- * @return Compiled program, or NULL on error.
+ * @return Compiled program, or NULL on error with @p err filled in.
  */
 ttak_bigscript_program_t *ttak_bigscript_compile(
     const char *source,
@@ -107,8 +112,61 @@ ttak_bigscript_program_t *ttak_bigscript_compile(
     ttak_bigscript_error_t *err,
     uint64_t now);
 
+/** @brief Programs the in-memory cache of ttak_bigscript_compile_cached() holds. */
+#ifndef TTAK_BIGSCRIPT_CACHE_MAX
+#define TTAK_BIGSCRIPT_CACHE_MAX 64
+#endif
+
 /**
- * @brief Frees a compiled program.
+ * @brief Compiles source code, reusing a program already compiled from it.
+ *
+ * Programs are cached process-wide, keyed by the source hash reported by
+ * ttak_bigscript_hash_program() together with @p limits. A hit takes a
+ * reference without locking; a miss compiles once, even when several threads
+ * ask for the same script. When ttak_bigscript_cache_set_dir() named a
+ * directory, a miss first tries its bytecode file and a compile writes one.
+ * The cache holds at most TTAK_BIGSCRIPT_CACHE_MAX programs and evicts the
+ * least recently used one to admit another. The result is shared and immutable; release it with
+ * ttak_bigscript_program_free().
+ *
+ * @param source Null-terminated source string.
+ * @param loader Optional loader for include/import.
+ * @param limits Safety limits to apply; part of the cache key.
+ * @param err Error output structure.
+ * @param now Monotonic timestamp.
+ * @return Compiled program, or NULL on error with @p err filled in.
+ */
+ttak_bigscript_program_t *ttak_bigscript_compile_cached(
+    const char *source,
+    ttak_bigscript_loader_t *loader,
+    const ttak_bigscript_limits_t *limits,
+    ttak_bigscript_error_t *err,
+    uint64_t now);
+
+/**
+ * @brief Sets the directory holding bytecode files for the program cache.
+ *
+ * Files are named after the source hash and carry a checksum; a stale or
+ * damaged file is recompiled and replaced. The directory must exist.
+ *
+ * @param dir Directory path, or NULL to keep the cache in memory only.
+ * @return false if the path is too long.
+ */
+bool ttak_bigscript_cache_set_dir(const char *dir);
+
+/**
+ * @brief Drops every program from the in-memory cache.
+ *
+ * Programs still held by callers stay valid until they are released.
+ */
+void ttak_bigscript_cache_clear(void);
+
+/**
+ * @brief Releases a compiled program.
+ *
+ * Programs from ttak_bigscript_compile_cached() are shared, and are freed
+ * once their last holder releases them.
+ *
  * @param prog Program to free.
  * @param now Monotonic timestamp.
  */
@@ -135,6 +193,8 @@ void ttak_bigscript_vm_free(ttak_bigscript_vm_t *vm, uint64_t now);
  * @brief Evaluates a script against a specific seed.
  * 
  * The worker must provide the pre-computed sum-of-proper-divisors (sn).
+ * The VM keeps its registers between calls, so evaluating many seeds with
+ * one VM reuses their limb storage.
  * 
  * @param prog Compiled program.
  * @param vm Thread-local VM.
@@ -154,6 +214,51 @@ bool ttak_bigscript_eval_seed(
     ttak_bigscript_error_t *err,
     uint64_t now);
 
+/**
+ * @brief Evaluates a script against every seed of an array.
+ *
+ * Seeds are split into chunks of TTAK_BIGSCRIPT_BATCH_CHUNK spread over
+ * @p pool (NULL runs them on the caller), each with its own VM. A seed whose
+ * inputs, constants and intermediate values all stay within 64 unsigned bits
+ * is evaluated on machine words; any other seed, or one that would fail,
+ * reruns on the bigint VM exactly as ttak_bigscript_eval_seed() would, so
+ * results and errors match the per-seed call.
+ *
+ * @param prog  Compiled program.
+ * @param seeds Array of @p count seeds.
+ * @param sns   Array of @p count pre-computed s(seed) values.
+ * @param count Number of seeds.
+ * @param outs  Array of @p count results, each to be released with
+ *              ttak_bigscript_value_free(); a failed seed holds zero.
+ * @param errs  Optional array of @p count per-seed errors.
+ * @param pool  Thread pool for the chunks, or NULL.
+ * @param now   Monotonic timestamp.
+ * @return true when every seed evaluated successfully.
+ */
+bool ttak_bigscript_eval_batch(
+    ttak_bigscript_program_t *prog,
+    const ttak_bigint_t *seeds,
+    const ttak_bigint_t *sns,
+    size_t count,
+    ttak_bigscript_value_t *outs,
+    ttak_bigscript_error_t *errs,
+    ttak_thread_pool_t *pool,
+    uint64_t now);
+
+/**
+ * @brief Translates a program to native code now instead of when it is hot.
+ *
+ * Every program is translated on its own once it has evaluated
+ * TTAK_BIGSCRIPT_JIT_THRESHOLD seeds. Native code covers 64-bit unsigned
+ * arithmetic and control flow; a seed whose values leave that range falls
+ * back to the interpreter, so results and errors do not change. Only x86-64
+ * is translated, and defining TTAK_BIGSCRIPT_NO_JIT turns the tier off.
+ *
+ * @param prog Compiled program.
+ * @return true when native code is in use for @p prog.
+ */
+bool ttak_bigscript_jit_compile(ttak_bigscript_program_t *prog);
+
 /**
  * @brief Computes the SHA256 identity hash of a compiled program.
  * @param prog Compiled program.
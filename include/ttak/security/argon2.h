@@ -0,0 +1,92 @@
+/**
+ * @file argon2.h
+ * @brief Argon2id memory-hard key derivation (RFC 9106).
+ *
+ * The m_cost blocks of working memory are claimed from a private arena
+ * generation rather than malloc, wiped before the generation is retired,
+ * and the lanes of each slice can be filled in parallel on a thread pool.
+ */
+
+#ifndef TTAK_SECURITY_ARGON2_H
+#define TTAK_SECURITY_ARGON2_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/io/io.h>
+#include <ttak/thread/pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TTAK_ARGON2_BLOCK_LEN 1024U  /**< Size of one memory block in bytes. */
+#define TTAK_ARGON2_SALT_MIN_LEN 8U  /**< Shortest salt accepted. */
+#define TTAK_ARGON2_TAG_MIN_LEN 4U   /**< Shortest tag accepted. */
+
+/**
+ * @def TTAK_ARGON2_DEFAULT_T_COST
+ * @brief Passes used when a caller leaves @c t_cost at zero.
+ */
+#ifndef TTAK_ARGON2_DEFAULT_T_COST
+#define TTAK_ARGON2_DEFAULT_T_COST 3U
+#endif
+
+/**
+ * @def TTAK_ARGON2_DEFAULT_M_COST_KIB
+ * @brief Memory in KiB used when a caller leaves @c m_cost_kib at zero.
+ */
+#ifndef TTAK_ARGON2_DEFAULT_M_COST_KIB
+#define TTAK_ARGON2_DEFAULT_M_COST_KIB (64U * 1024U)
+#endif
+
+/**
+ * @def TTAK_ARGON2_DEFAULT_LANES
+ * @brief Parallelism used when a caller leaves @c lanes at zero.
+ */
+#ifndef TTAK_ARGON2_DEFAULT_LANES
+#define TTAK_ARGON2_DEFAULT_LANES 4U
+#endif
+
+/**
+ * @brief Cost parameters and optional inputs for ttak_argon2id().
+ *
+ * Zero costs take the TTAK_ARGON2_DEFAULT_* values. The tag depends on
+ * @c lanes but never on @c pool, which only decides where lanes run.
+ */
+typedef struct ttak_argon2_params {
+    uint32_t t_cost;           /**< Passes over memory. */
+    uint32_t m_cost_kib;       /**< Memory in KiB; rounded down to a multiple of 4 lanes, at least 8 per lane. */
+    uint32_t lanes;            /**< Degree of parallelism, 1 to 2^24 - 1. */
+    const uint8_t *secret;     /**< Optional secret value K. */
+    size_t secret_len;         /**< Length of @c secret. */
+    const uint8_t *ad;         /**< Optional associated data X. */
+    size_t ad_len;             /**< Length of @c ad. */
+    ttak_thread_pool_t *pool;  /**< Pool that fills lanes 1.. of each slice, or NULL. */
+} ttak_argon2_params_t;
+
+typedef ttak_argon2_params_t tt_argon2_params_t;
+
+/**
+ * @brief Derives @p out_len bytes from @p pwd and @p salt with Argon2id.
+ *
+ * @param params   Costs and optional inputs; NULL means all defaults.
+ * @param pwd      Password, may be NULL when @p pwd_len is zero.
+ * @param pwd_len  Password length in bytes.
+ * @param salt     Salt of at least TTAK_ARGON2_SALT_MIN_LEN bytes.
+ * @param salt_len Salt length in bytes.
+ * @param out      Tag output.
+ * @param out_len  Tag length, at least TTAK_ARGON2_TAG_MIN_LEN.
+ * @param now      Timestamp for the pool's bookkeeping.
+ * @return @c TTAK_IO_SUCCESS, @c TTAK_IO_ERR_INVALID_ARGUMENT for bad
+ *         parameters, or @c TTAK_IO_ERR_SYS_FAILURE if the memory could
+ *         not be allocated.
+ */
+ttak_io_status_t ttak_argon2id(const ttak_argon2_params_t *params, const uint8_t *pwd, size_t pwd_len,
+                               const uint8_t *salt, size_t salt_len, uint8_t *out, size_t out_len, uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_SECURITY_ARGON2_H */
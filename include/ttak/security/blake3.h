@@ -0,0 +1,79 @@
+/**
+ * @file blake3.h
+ * @brief BLAKE3 hashing, keyed hashing and extendable output.
+ *
+ * One-shot entry points over a linear buffer. Long inputs are hashed as a
+ * tree: whole 1 KiB chunks run several at a time in SIMD lanes, and
+ * ttak_blake3_hash_pool() splits large buffers into subtrees hashed on a
+ * thread pool. Every path produces the same digest as the reference.
+ */
+
+#ifndef TTAK_SECURITY_BLAKE3_H
+#define TTAK_SECURITY_BLAKE3_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/thread/pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TTAK_BLAKE3_OUT_LEN 32U    /**< Default digest length in bytes. */
+#define TTAK_BLAKE3_KEY_LEN 32U    /**< Key length for keyed hashing. */
+#define TTAK_BLAKE3_BLOCK_LEN 64U  /**< Compression block size. */
+#define TTAK_BLAKE3_CHUNK_LEN 1024U /**< Leaf size of the hash tree. */
+
+/**
+ * @def TTAK_BLAKE3_POOL_MIN_BYTES
+ * @brief Shortest input ttak_blake3_hash_pool() splits across workers;
+ *        shorter ones are hashed on the calling thread.
+ */
+#ifndef TTAK_BLAKE3_POOL_MIN_BYTES
+#define TTAK_BLAKE3_POOL_MIN_BYTES (1U << 20)
+#endif
+
+/**
+ * @def TTAK_BLAKE3_POOL_MAX_TASKS
+ * @brief Most subtrees one ttak_blake3_hash_pool() call hands to the pool.
+ */
+#ifndef TTAK_BLAKE3_POOL_MAX_TASKS
+#define TTAK_BLAKE3_POOL_MAX_TASKS 32U
+#endif
+
+/**
+ * @brief Hashes @p len bytes of @p in into @p out_len bytes of @p out.
+ *
+ * @param key     32-byte key for keyed hashing, or NULL for plain BLAKE3.
+ * @param in      Input, may be NULL when @p len is zero.
+ * @param len     Input length in bytes.
+ * @param out     Output buffer.
+ * @param out_len Output length; any length, 32 for a standard digest.
+ *                Shorter outputs are prefixes of longer ones.
+ */
+void ttak_blake3_hash(const uint8_t *key, const uint8_t *in, size_t len, uint8_t *out, size_t out_len);
+
+/**
+ * @brief ttak_blake3_hash() with subtrees of a large input spread over @p pool.
+ *
+ * Inputs shorter than TTAK_BLAKE3_POOL_MIN_BYTES, or a NULL @p pool, are
+ * hashed on the calling thread, which also takes part in the work and
+ * hashes any subtree the pool refuses.
+ *
+ * @param pool    Pool for the subtree tasks, or NULL.
+ * @param key     32-byte key, or NULL.
+ * @param in      Input buffer.
+ * @param len     Input length in bytes.
+ * @param out     Output buffer.
+ * @param out_len Output length in bytes.
+ * @param now     Timestamp for the pool's bookkeeping.
+ */
+void ttak_blake3_hash_pool(ttak_thread_pool_t *pool, const uint8_t *key, const uint8_t *in, size_t len,
+                           uint8_t *out, size_t out_len, uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_SECURITY_BLAKE3_H */
@@ -0,0 +1,146 @@
+/**
+ * @file key_schedule.h
+ * @brief Expanded key schedules kept per session key.
+ *
+ * A connection that builds a fresh ttak_crypto_ctx_t for every record batch
+ * would otherwise expand its key each time: AES-256 round keys plus the
+ * GHASH powers of H for GCM, the LEA or SEED round keys for those ciphers.
+ * A ttak_security_schedule_t holds that work for one key, and a
+ * ttak_security_schedule_cache_t keeps a few of them in the endpoint or
+ * session object. Setting @c ctx->schedule hands one to the kernels, which
+ * use it only when it was built from the context's own @c key; any other
+ * context falls back to expanding as before.
+ */
+
+#ifndef TTAK_SECURITY_KEY_SCHEDULE_H
+#define TTAK_SECURITY_KEY_SCHEDULE_H
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ttak/security/lea.h>
+#include <ttak/security/security_engine.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TTAK_SECURITY_GHASH_KEY_BYTES
+ * @brief Room for the GHASH key table of any compiled GHASH path.
+ */
+#define TTAK_SECURITY_GHASH_KEY_BYTES 512U
+
+/**
+ * @def TTAK_SECURITY_SCHEDULE_CACHE_SLOTS
+ * @brief Schedules one ttak_security_schedule_cache_t holds.
+ *
+ * Enough for both directions of a connection across one key update.
+ */
+#ifndef TTAK_SECURITY_SCHEDULE_CACHE_SLOTS
+#define TTAK_SECURITY_SCHEDULE_CACHE_SLOTS 4U
+#endif
+
+/**
+ * @brief Cipher a schedule was expanded for.
+ */
+typedef enum ttak_security_cipher {
+    TTAK_SECURITY_CIPHER_NONE = 0, /**< Empty schedule. */
+    TTAK_SECURITY_CIPHER_AES256,   /**< AES-256 round keys and GHASH powers. */
+    TTAK_SECURITY_CIPHER_LEA,      /**< LEA-128/192/256 round keys. */
+    TTAK_SECURITY_CIPHER_SEED      /**< SEED-128 round keys. */
+} ttak_security_cipher_t;
+
+/**
+ * @brief Key expansion for one key, reusable across contexts.
+ */
+typedef struct ttak_security_schedule {
+    ttak_security_cipher_t cipher; /**< NONE until initialised. */
+    size_t key_len;                /**< Length of @c key in bytes. */
+    uint8_t key[32];               /**< Key the schedule was built from. */
+    uint64_t last_use;             /**< Cache clock at the last lookup. */
+    union {
+        struct {
+            alignas(64) uint8_t round_keys[15][16];                   /**< AES-256 round keys. */
+            alignas(64) uint8_t ghash[TTAK_SECURITY_GHASH_KEY_BYTES]; /**< GHASH key for H = AES_K(0). */
+        } aes;
+        ttak_lea_schedule_t lea;  /**< LEA round keys. */
+        uint32_t seed[32];        /**< SEED round keys. */
+    } u;
+} ttak_security_schedule_t;
+
+typedef ttak_security_schedule_t tt_security_schedule_t;
+
+/**
+ * @brief A few schedules keyed by cipher and key, evicted least recently used.
+ *
+ * Not thread-safe; keep one per session and use it from the thread that
+ * owns the session.
+ */
+typedef struct ttak_security_schedule_cache {
+    ttak_security_schedule_t slots[TTAK_SECURITY_SCHEDULE_CACHE_SLOTS];
+    uint64_t clock; /**< Bumped on every lookup. */
+} ttak_security_schedule_cache_t;
+
+typedef ttak_security_schedule_cache_t tt_security_schedule_cache_t;
+
+/**
+ * @brief Maps @p op to the cipher whose schedule it uses.
+ *
+ * @return The cipher, or @c TTAK_SECURITY_CIPHER_NONE for operations
+ *         without a key schedule (ChaCha20-Poly1305, hashing, KDF).
+ */
+ttak_security_cipher_t ttak_security_op_cipher(ttak_security_op_t op);
+
+/**
+ * @brief Expands @p key for @p op into @p sched.
+ *
+ * @param sched   Schedule to fill; overwritten.
+ * @param op      Operation the schedule will serve.
+ * @param key     Raw key.
+ * @param key_len 32 for AES-GCM, 16/24/32 for LEA, 16 for SEED.
+ * @return        @c TTAK_IO_SUCCESS, or @c TTAK_IO_ERR_INVALID_ARGUMENT for
+ *                an operation without a schedule or a bad key length, in
+ *                which case @p sched is left empty.
+ */
+ttak_io_status_t ttak_security_schedule_init(ttak_security_schedule_t *sched,
+                                             ttak_security_op_t op,
+                                             const uint8_t *key,
+                                             size_t key_len);
+
+/**
+ * @brief Wipes @p sched, leaving it empty.
+ */
+void ttak_security_schedule_wipe(ttak_security_schedule_t *sched);
+
+/**
+ * @brief Empties every slot of @p cache.
+ */
+void ttak_security_schedule_cache_init(ttak_security_schedule_cache_t *cache);
+
+/**
+ * @brief Wipes every slot of @p cache; call when the session ends.
+ */
+void ttak_security_schedule_cache_clear(ttak_security_schedule_cache_t *cache);
+
+/**
+ * @brief Returns the schedule for @p key under @p op, expanding it on a miss.
+ *
+ * A miss reuses an empty slot or the least recently used one, so the
+ * returned pointer stays valid until
+ * TTAK_SECURITY_SCHEDULE_CACHE_SLOTS other keys have been looked up.
+ *
+ * @return The schedule, or NULL when ttak_security_schedule_init() would
+ *         reject @p op or @p key_len.
+ */
+const ttak_security_schedule_t *ttak_security_schedule_cache_get(ttak_security_schedule_cache_t *cache,
+                                                                 ttak_security_op_t op,
+                                                                 const uint8_t *key,
+                                                                 size_t key_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TTAK_SECURITY_KEY_SCHEDULE_H */
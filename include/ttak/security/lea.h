@@ -24,11 +24,23 @@ extern "C" {
 /** @brief Maximum number of rounds for a 256-bit LEA key schedule. */
 #define TTAK_LEA_MAX_ROUNDS 32U
 
+/**
+ * @def TTAK_LEA_CTR_CHUNK_BLOCKS
+ * @brief Counter blocks encrypted per keystream pass of ttak_lea_ctr_execute().
+ *
+ * The keystream lives on the stack; a multiple of 16 keeps every pass on
+ * the widest block kernel.
+ */
+#ifndef TTAK_LEA_CTR_CHUNK_BLOCKS
+#define TTAK_LEA_CTR_CHUNK_BLOCKS 32U
+#endif
+
 /**
  * @brief Pre-expanded LEA round-key schedule.
  *
  * Populated by ttak_lea_schedule_init().  The @c rounds field is set to
- * 32 (256-bit), 28 (192-bit), or 24 (128-bit) depending on key length.
+ * 32 (256-bit), 28 (192-bit), or 24 (128-bit) depending on key length,
+ * and to 0 for any other length.
  */
 typedef struct ttak_lea_schedule {
     uint32_t round_keys[TTAK_LEA_MAX_ROUNDS * 6U]; /**< Expanded sub-keys. */
@@ -50,15 +62,35 @@ void ttak_lea_schedule_init(ttak_lea_schedule_t *sched,
  * @brief Encrypts data with LEA, using the best available SIMD driver.
  *
  * Input/output buffers and key material are read from @p ctx.  Block count
- * must be a multiple of @c TTAK_LEA_BLOCK_SIZE.
+ * must be a multiple of @c TTAK_LEA_BLOCK_SIZE.  Blocks are encrypted
+ * independently (ECB), up to @c driver->lane_width at a time.
  *
  * @param ctx    Crypto context carrying plaintext, key, and output buffer.
  * @param driver Driver descriptor from ttak_security_pick_driver().
- * @return       @c TTAK_IO_SUCCESS on success, or an error code.
+ * @return       @c TTAK_IO_SUCCESS on success, @c TTAK_IO_ERR_RANGE for a
+ *               bad key or data length, or an error code.
  */
 ttak_io_status_t ttak_lea_encrypt_simd(const ttak_crypto_ctx_t *ctx,
                                        const ttak_security_driver_t *driver);
 
+/**
+ * @brief Encrypts or decrypts @c ctx->in with LEA in counter mode.
+ *
+ * @c ctx->iv is the 16-byte initial counter block, incremented as one
+ * 128-bit big-endian integer per block and left pointing at the block
+ * after the last one used, so consecutive calls continue one stream.
+ * Any input length is accepted; a partial final block consumes a whole
+ * counter value.  @c in and @c out may be the same buffer.
+ *
+ * @param ctx    Crypto context with input, output, key, and counter block.
+ * @param driver Driver descriptor from ttak_security_pick_driver().
+ * @return       @c TTAK_IO_SUCCESS, @c TTAK_IO_ERR_INVALID_ARGUMENT for
+ *               missing buffers or an @c iv_len other than 0 or 16, or
+ *               @c TTAK_IO_ERR_RANGE for a bad key length or short output.
+ */
+ttak_io_status_t ttak_lea_ctr_execute(ttak_crypto_ctx_t *ctx,
+                                      const ttak_security_driver_t *driver);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,13 +6,15 @@
  * encryption, hashing, and KDF requests to the best available driver
  * (scalar, SIMD, or hardware accelerator) selected at runtime.
  *
- * Supported operations: LEA, SEED, AES-256-GCM, ChaCha20-Poly1305,
- * post-quantum signatures, fast hashing, and memory-hard KDF.
+ * Supported operations: LEA and SEED (ECB and counter mode), AES-256-GCM,
+ * ChaCha20-Poly1305, BLAKE3 fast hashing, and the Argon2id memory-hard
+ * KDF. The post-quantum signature slot has no kernel yet.
  */
 
 #ifndef TTAK_SECURITY_ENGINE_H
 #define TTAK_SECURITY_ENGINE_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdalign.h>
@@ -31,9 +33,12 @@ typedef enum ttak_security_op {
     TTAK_SECURITY_SEED_ENC,             /**< SEED block-cipher encryption. */
     TTAK_SECURITY_AES_GCM,              /**< AES-256-GCM authenticated encryption. */
     TTAK_SECURITY_CHACHA20_POLY1305,    /**< ChaCha20-Poly1305 AEAD. */
-    TTAK_SECURITY_SIGN_PQC,             /**< Post-quantum signature (stub). */
-    TTAK_SECURITY_HASH_FAST,            /**< Fast non-cryptographic hash. */
-    TTAK_SECURITY_KDF_HARD              /**< Memory-hard key derivation. */
+    TTAK_SECURITY_SIGN_PQC,             /**< Post-quantum signature (unsupported). */
+    TTAK_SECURITY_HASH_FAST,            /**< BLAKE3 of @c in into @c out; keyed when @c key_len is 32. */
+    TTAK_SECURITY_KDF_HARD,             /**< Argon2id of password @c in and salt @c aad; see hw_state.argon2. */
+    TTAK_SECURITY_LEA_CTR,              /**< LEA counter mode; @c iv is the counter block and advances. */
+    TTAK_SECURITY_SEED_CTR,             /**< SEED counter mode; @c iv is the counter block and advances. */
+    TTAK_SECURITY_OP_COUNT              /**< Number of operations; not an operation. */
 } ttak_security_op_t;
 
 /**
@@ -45,13 +50,31 @@ typedef enum ttak_security_driver_kind {
     TTAK_SECURITY_DRIVER_ACCEL       /**< Hardware crypto engine or GPU. */
 } ttak_security_driver_kind_t;
 
+struct ttak_crypto_ctx;
+struct ttak_security_driver;
+struct ttak_security_schedule;
+
+/**
+ * @brief Kernel a driver runs for one record of its operation.
+ *
+ * Called with the record context and the driver itself, so the kernel can
+ * read the lane width it was selected with.
+ */
+typedef ttak_io_status_t (*ttak_security_kernel_fn)(struct ttak_crypto_ctx *ctx,
+                                                    const struct ttak_security_driver *driver);
+
 /**
  * @brief Runtime descriptor for a cryptographic driver backend.
+ *
+ * There is one driver per ttak_security_op_t, chosen once for the host the
+ * first time any driver is asked for.
  */
 typedef struct ttak_security_driver {
     ttak_security_driver_kind_t kind; /**< Back-end kind. */
     const char *name;                 /**< Human-readable driver name. */
     size_t lane_width;                /**< Preferred parallel block count. */
+    ttak_security_op_t op;            /**< Operation this driver serves. */
+    ttak_security_kernel_fn execute;  /**< Kernel for one record; never NULL. */
 } ttak_security_driver_t;
 
 /**
@@ -89,7 +112,18 @@ typedef struct ttak_crypto_ctx {
             uint32_t round_keys[32]; /**< SEED expanded round keys. */
             size_t rounds;           /**< Active round count (16 for SEED-128). */
         } seed;
+        struct {
+            uint32_t t_cost;     /**< Argon2id passes; 0 for TTAK_ARGON2_DEFAULT_T_COST. */
+            uint32_t m_cost_kib; /**< Memory in KiB; 0 for TTAK_ARGON2_DEFAULT_M_COST_KIB. */
+            uint32_t lanes;      /**< Parallelism; 0 for TTAK_ARGON2_DEFAULT_LANES. */
+        } argon2;                /**< KDF_HARD costs; @c key, when set, is the Argon2 secret. */
     } hw_state; /**< Pre-expanded cipher state for hardware-assisted paths. */
+    /**
+     * Optional session schedule (ttak/security/key_schedule.h). Used in
+     * place of @c hw_state and per-call expansion when it was built from
+     * this context's @c key for the operation's cipher; ignored otherwise.
+     */
+    const struct ttak_security_schedule *schedule;
 } ttak_crypto_ctx_t;
 
 /**
@@ -105,13 +139,106 @@ ttak_io_status_t ttak_security_execute(ttak_crypto_ctx_t *ctx,
                                        uint64_t now);
 
 /**
- * @brief Returns the best driver for the given operation at runtime.
+ * @def TTAK_SECURITY_BATCH_WINDOW
+ * @brief Records ttak_security_execute_batch() interleaves at a time.
+ */
+#ifndef TTAK_SECURITY_BATCH_WINDOW
+#define TTAK_SECURITY_BATCH_WINDOW 64U
+#endif
+
+/**
+ * @def TTAK_CHACHA_BATCH_MAX_BYTES
+ * @brief Longest ChaCha20-Poly1305 record that shares vector lanes with
+ *        other records in a batch; longer ones run on their own, where a
+ *        single record already fills the lanes.
+ */
+#ifndef TTAK_CHACHA_BATCH_MAX_BYTES
+#define TTAK_CHACHA_BATCH_MAX_BYTES 2048U
+#endif
+
+/**
+ * @def TTAK_SECURITY_ACCEL_MIN_RECORD_BYTES
+ * @brief Shortest ChaCha20-Poly1305 record a batch hands to a GPU backend;
+ *        shorter ones stay on the CPU kernels.
+ */
+#ifndef TTAK_SECURITY_ACCEL_MIN_RECORD_BYTES
+#define TTAK_SECURITY_ACCEL_MIN_RECORD_BYTES (64U * 1024U)
+#endif
+
+/**
+ * @def TTAK_SECURITY_ACCEL_MIN_BATCH_BYTES
+ * @brief Fewest bytes of such records for a batch to use the GPU at all, so
+ *        the transfers do not cost more than the keystream they replace.
+ */
+#ifndef TTAK_SECURITY_ACCEL_MIN_BATCH_BYTES
+#define TTAK_SECURITY_ACCEL_MIN_BATCH_BYTES (8U * 1024U * 1024U)
+#endif
+
+/**
+ * @brief Runs @p op over @p count independent records after one dispatch.
+ *
+ * Each record is a context set up exactly as for ttak_security_execute(),
+ * with its own key, nonce, AAD and tag. Records are processed from
+ * @c in / @c in_len to @c out and may be in place (@c in == @c out), so a
+ * batch can work directly on lattice slot payloads or zero-copy buffers.
+ *
+ * For ChaCha20-Poly1305, linear records up to TTAK_CHACHA_BATCH_MAX_BYTES
+ * are interleaved: keystream blocks from different records share one
+ * vector pass, so a window of small packets costs about as many passes as
+ * their total block count divided by the lane width. When a CUDA, ROCm or
+ * OpenCL backend is compiled in and the batch's records of at least
+ * TTAK_SECURITY_ACCEL_MIN_RECORD_BYTES add up to
+ * TTAK_SECURITY_ACCEL_MIN_BATCH_BYTES, their keystream is generated on the
+ * GPU in one launch and only Poly1305 runs on the CPU; if the device
+ * fails they fall back to the CPU path. Other operations run record by
+ * record with the driver resolved once.
+ *
+ * @param ctxs     Array of @p count record contexts.
+ * @param count    Number of records.
+ * @param op       Operation applied to every record.
+ * @param statuses Optional array of @p count per-record results.
+ * @param now      Current monotonic timestamp in nanoseconds.
+ * @return         @c TTAK_IO_SUCCESS if every record succeeded, otherwise
+ *                 the status of the first record that failed.
+ */
+ttak_io_status_t ttak_security_execute_batch(ttak_crypto_ctx_t *ctxs,
+                                             size_t count,
+                                             ttak_security_op_t op,
+                                             ttak_io_status_t *statuses,
+                                             uint64_t now);
+
+/**
+ * @brief Returns the driver selected for @p op on this host.
+ *
+ * The per-operation table is built once from the compiled kernels and the
+ * runtime CPU features (ttak_arch_features()); later calls are a table
+ * lookup. Setting TTAK_SECURITY_KERNEL=scalar in the environment before
+ * the first call selects the single-lane drivers, e.g. to cross-check
+ * results. Operations without a kernel, and values outside the enum, get
+ * a driver whose @c execute reports @c TTAK_IO_ERR_INVALID_ARGUMENT.
  *
  * @param op Requested operation.
  * @return   Pointer to a statically-allocated driver descriptor.
  */
 const ttak_security_driver_t *ttak_security_pick_driver(ttak_security_op_t op);
 
+/**
+ * @brief Returns true when a GPU backend can take bulk security batches.
+ *
+ * False without a CUDA, ROCm or OpenCL build, after every backend has
+ * failed once, or when TTAK_SECURITY_KERNEL=scalar is set.
+ */
+bool ttak_security_accel_available(void);
+
+/**
+ * @brief Expands the 32-byte @c key into @c hw_state.aes.round_keys.
+ *
+ * @param ctx Crypto context with @c key and @c key_len set.
+ * @return    @c TTAK_IO_SUCCESS, or @c TTAK_IO_ERR_INVALID_ARGUMENT for
+ *            any other key length.
+ */
+ttak_io_status_t ttak_aes256_expand_key(ttak_crypto_ctx_t *ctx);
+
 /**
  * @brief Low-level AES-256-GCM encrypt/decrypt helper.
  *
@@ -140,6 +267,20 @@ ttak_io_status_t ttak_chacha20_poly1305_execute(ttak_crypto_ctx_t *ctx,
                                                 uint8_t *out,
                                                 size_t len);
 
+/**
+ * @brief ChaCha20-Poly1305 over a batch of records; see ttak_security_execute_batch().
+ *
+ * @param ctxs     Record contexts, processed from @c in / @c in_len to @c out.
+ * @param count    Number of records.
+ * @param driver   Driver whose lane width bounds the interleaving.
+ * @param statuses Optional per-record results.
+ * @return         @c TTAK_IO_SUCCESS, or the first failing record's status.
+ */
+ttak_io_status_t ttak_chacha20_poly1305_execute_batch(ttak_crypto_ctx_t *ctxs,
+                                                      size_t count,
+                                                      const ttak_security_driver_t *driver,
+                                                      ttak_io_status_t *statuses);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,8 +3,9 @@
  * @brief SEED block cipher interface (KS X 1213, ISO/IEC 18033-3).
  *
  * SEED is a 128-bit block cipher standardised by the Korean government.
- * Key expansion is stored in @c ttak_crypto_ctx_t::hw_state::seed and the
- * single entry point below performs aligned software encryption.
+ * Key expansion is stored in @c ttak_crypto_ctx_t::hw_state::seed, or read
+ * from a matching @c ctx->schedule; blocks can be encrypted one by one
+ * (ECB) or as a counter-mode stream.
  */
 
 #ifndef TTAK_SECURITY_SEED_H
@@ -19,6 +20,19 @@
 extern "C" {
 #endif
 
+/**
+ * @def TTAK_SEED_CTR_BITSLICE_MIN_BLOCKS
+ * @brief Fewest remaining counter blocks worth a bitsliced batch.
+ *
+ * A batch always costs a full plane's worth of blocks (128 to 512), so
+ * shorter tails go through the S-box tables one block at a time. Batches
+ * broke even with the tables at roughly 70 to 140 blocks from SSE2 to
+ * AVX-512.
+ */
+#ifndef TTAK_SEED_CTR_BITSLICE_MIN_BLOCKS
+#define TTAK_SEED_CTR_BITSLICE_MIN_BLOCKS 128U
+#endif
+
 /**
  * @brief Encrypts data using SEED with a 16-byte-aligned software path.
  *
@@ -32,6 +46,26 @@ extern "C" {
 ttak_io_status_t ttak_seed_encrypt_aligned(const ttak_crypto_ctx_t *ctx,
                                             const ttak_security_driver_t *driver);
 
+/**
+ * @brief Encrypts or decrypts @c ctx->in with SEED in counter mode.
+ *
+ * @c ctx->iv is the 16-byte initial counter block, incremented as one
+ * 128-bit big-endian integer per block and left pointing at the block
+ * after the last one used.  Any input length is accepted and @c in may
+ * equal @c out.  When @p driver has more than one lane and the build has
+ * a vector plane, runs of at least TTAK_SEED_CTR_BITSLICE_MIN_BLOCKS
+ * blocks use the bitsliced cipher; the keystream is identical either way.
+ *
+ * @param ctx    Crypto context with input, output, key, and counter block;
+ *               @c hw_state.seed caches the key schedule as above.
+ * @param driver Driver descriptor from ttak_security_pick_driver().
+ * @return       @c TTAK_IO_SUCCESS, @c TTAK_IO_ERR_INVALID_ARGUMENT for
+ *               missing buffers or an @c iv_len other than 0 or 16, or
+ *               @c TTAK_IO_ERR_RANGE for a bad key length or short output.
+ */
+ttak_io_status_t ttak_seed_ctr_execute(ttak_crypto_ctx_t *ctx,
+                                       const ttak_security_driver_t *driver);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,15 @@ extern "C" {
 /** @brief Output digest length in bytes. */
 #define SHA256_BLOCK_SIZE 32
 
+/**
+ * @def TTAK_SHA256_MB_MIN_BATCH
+ * @brief Fewest messages sha256_hash_many() hands to the multi-buffer
+ *        kernel at once; smaller remainders are hashed one at a time.
+ */
+#ifndef TTAK_SHA256_MB_MIN_BATCH
+#define TTAK_SHA256_MB_MIN_BATCH 4
+#endif
+
 /**
  * @brief SHA-256 incremental hash context.
  */
@@ -53,6 +62,23 @@ void sha256_update(SHA256_CTX *ctx, const uint8_t data[], size_t len);
  */
 void sha256_final(SHA256_CTX *ctx, uint8_t hash[]);
 
+/**
+ * @brief Hashes @p count independent messages.
+ *
+ * digests[i] receives the SHA-256 of the @p lens[i] bytes at @p msgs[i].
+ * With AVX2 or AVX-512 the messages are hashed 8 or 16 at a time, one per
+ * vector lane, which pays off for many short messages of similar length;
+ * each batch runs for as many blocks as its longest message. Elsewhere
+ * this is a loop over sha256_init() / sha256_update() / sha256_final().
+ *
+ * @param msgs    Message pointers (may be NULL where the length is 0).
+ * @param lens    Message lengths in bytes.
+ * @param count   Number of messages.
+ * @param digests Output digests, one per message.
+ */
+void sha256_hash_many(const uint8_t *const msgs[], const size_t lens[], size_t count,
+                      uint8_t digests[][SHA256_BLOCK_SIZE]);
+
 #ifdef __cplusplus
 }
 #endif
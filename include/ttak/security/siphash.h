@@ -28,4 +28,37 @@ uint64_t ttak_siphash24(const void *key, size_t len, uint64_t k0, uint64_t k1);
  */
 uint64_t ttak_siphash24_u64(uint64_t val, uint64_t k0, uint64_t k1);
 
+/**
+ * @brief SipHash-1-3 of a byte array.
+ *
+ * One compression and three finalisation rounds: about half the rounds of
+ * SipHash-2-4, and still keyed, which is all hash-flooding defence needs.
+ * Its signature fits the @c hash_func of ttak_table_init() and
+ * ttak_set_init(), and ttak_table_get_batch() hashes through
+ * ttak_siphash13_batch() when it is selected.
+ *
+ * @param key Input data to hash.
+ * @param len Length of the input data.
+ * @param k0  First 64-bit key.
+ * @param k1  Second 64-bit key.
+ * @return 64-bit hash value.
+ */
+uint64_t ttak_siphash13(const void *key, size_t len, uint64_t k0, uint64_t k1);
+
+/**
+ * @brief SipHash-1-3 of @p n independent byte arrays.
+ *
+ * With AVX2, four keys share one vector state per step; the result is
+ * the same as calling ttak_siphash13() on each key.
+ *
+ * @param keys Input pointers.
+ * @param lens Input lengths.
+ * @param n    Number of inputs.
+ * @param k0   First 64-bit key.
+ * @param k1   Second 64-bit key.
+ * @param out  @p n hash values.
+ */
+void ttak_siphash13_batch(const void *const *keys, const size_t *lens, size_t n,
+                          uint64_t k0, uint64_t k1, uint64_t *out);
+
 #endif // TTAK_SECURITY_SIPHASH_H
@@ -10,8 +10,10 @@
 
 #include <ttak/mem/owner.h>
 #include <ttak/sync/sync.h>
+#include <ttak/sync/brlock.h>
 #include <ttak/mask/dynamic_mask.h>
 #include <ttak/mem/epoch.h>
+#include <ttak/mem/hazard.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -43,6 +45,7 @@ typedef uint32_t ttak_shared_status_t;
 #define TTAK_SHARED_READONLY (1 << 3)  /**< Resource is in read-only mode */
 #define TTAK_SHARED_USE_EBR  (1 << 4)  /**< EBR protection enabled */
 #define TTAK_SHARED_SWAPPING (1 << 5)  /**< Data is currently being swapped */
+#define TTAK_SHARED_READ_MOSTLY (1 << 6) /**< Readers use ttak_shared_read(); swaps only replace the pointer */
 
 /**
  * @brief Operational result codes for shared memory actions.
@@ -79,12 +82,14 @@ typedef struct ttak_shared_s {
 	ttak_shard_table_t shards;      /**< Lock-free Segmented Shards for sync */
 	uint64_t ts;                    /**< Timestamp to track its lifetime */
 
-	ttak_rwlock_t rwlock;           /**< R/W lock for metadata (swap, status) */
+	ttak_brlock_t rwlock;           /**< Reader-biased lock for metadata (swap, status) */
 	ttak_shared_status_t status;    /**< Current status flags (DIRTY, EXPIRED, etc.) */
 	ttak_shared_level_t level;      /**< Enforced security level for this resource */
 	bool is_atomic_read;            /**< Flag to enable/disable atomic read operations */
+	ttak_reclaim_mode_t reclaim_mode; /**< Scheme protecting access_ebr() readers (default TTAK_RECLAIM_EPOCH) */
 
 	void * _Atomic retired_ptr;    /**< Pointer currently being retired (internal use) */
+	uint64_t _Atomic owner_gen;    /**< Process-unique stamp keying per-thread owner checks (internal use) */
 
 	/**
 	 * @brief Custom destructor for the shared payload.
@@ -130,9 +135,16 @@ typedef struct ttak_shared_s {
 
 	/**
 	 * @brief Validates and grants access with optional EBR protection.
+	 *
+	 * In TTAK_RECLAIM_HAZARD mode the protection publishes hazard pointers
+	 * for the container and the payload instead of entering an epoch, so a
+	 * reader that stalls before release_ebr() only pins what it holds. That
+	 * uses two of the thread's TTAK_HAZARD_SLOTS; NULL is returned when they
+	 * are exhausted.
+	 *
 	 * @param self Pointer to the ttak_shared_t instance.
 	 * @param claimant The owner requesting access.
-	 * @param use_ebr_protection If true, enters EBR critical section.
+	 * @param use_ebr_protection If true, enters EBR critical section (or publishes hazards).
 	 * @param result Pointer to store the detailed validation result.
 	 * @return Const pointer to the shared data, or NULL if denied.
 	 */
@@ -177,7 +189,30 @@ typedef struct ttak_shared_s {
 	ttak_shared_result_t (*set_atomic_read)(struct ttak_shared_s *self, bool enable);
 
 	/**
-	 * @brief Retires the entire container safely using EBR.
+	 * @brief Selects the reclamation scheme used by access_ebr(), swap and retire.
+	 *
+	 * Must be chosen before the resource is shared between threads.
+	 *
+	 * @param self Pointer to the ttak_shared_t instance.
+	 * @param mode TTAK_RECLAIM_EPOCH or TTAK_RECLAIM_HAZARD.
+	 */
+	ttak_shared_result_t (*set_reclaim_mode)(struct ttak_shared_s *self, ttak_reclaim_mode_t mode);
+
+	/**
+	 * @brief Switches the resource to or from read-mostly mode.
+	 *
+	 * In read-mostly mode ttak_shared_swap_ebr() never sets TTAK_SHARED_DIRTY
+	 * and only serializes writers, so ttak_shared_read() stays a pure reader.
+	 * Requires TTAK_RECLAIM_EPOCH; set_reclaim_mode() refuses hazard mode
+	 * while it is on.
+	 *
+	 * @param self Pointer to the ttak_shared_t instance.
+	 * @param enable True to enter read-mostly mode.
+	 */
+	ttak_shared_result_t (*set_read_mostly)(struct ttak_shared_s *self, bool enable);
+
+	/**
+	 * @brief Retires the entire container safely using the selected reclamation scheme.
 	 * @param self Pointer to the ttak_shared_t instance.
 	 */
 	void (*retire)(struct ttak_shared_s *self);
@@ -185,7 +220,7 @@ typedef struct ttak_shared_s {
 } ttak_shared_t;
 
 /**
- * @brief Swaps the internal data pointer using EBR for safety.
+ * @brief Swaps the internal data pointer, retiring the old one through the selected scheme.
  * @param self Pointer to the ttak_shared_t instance.
  * @param new_shared Pointer to the new data.
  * @param new_size Size of the new data.
@@ -193,6 +228,29 @@ typedef struct ttak_shared_s {
  */
 ttak_shared_result_t ttak_shared_swap_ebr(ttak_shared_t *self, void *new_shared, size_t new_size);
 
+/**
+ * @brief RCU-style read of a read-mostly resource.
+ *
+ * Enters an epoch and loads the payload with acquire ordering; nothing
+ * shared is written. The owner check is done once per thread, owner and
+ * resource, then answered from a small thread-local cache. Timestamps are
+ * not compared: a payload published by ttak_shared_swap_ebr() is complete
+ * before readers can see it. A non-NULL return must be paired with
+ * ttak_shared_read_end(); a NULL return holds nothing.
+ *
+ * @param self Pointer to the ttak_shared_t instance.
+ * @param claimant The owner requesting access.
+ * @param result Pointer to store the validation result.
+ * @return Const pointer to the payload, or NULL if denied.
+ */
+const void *ttak_shared_read(ttak_shared_t *self, ttak_owner_t *claimant, ttak_shared_result_t *result);
+
+/**
+ * @brief Ends a read started by ttak_shared_read().
+ * @param self Pointer to the ttak_shared_t instance.
+ */
+void ttak_shared_read_end(ttak_shared_t *self);
+
 /**
  * @brief Retrieves the size of the payload from the implicit header.
  * @param ptr Pointer returned by access() or access_ebr().
@@ -0,0 +1,99 @@
+/**
+ * @file kll.h
+ * @brief Mergeable KLL quantile sketch for online percentiles.
+ *
+ * A KLL sketch keeps a hierarchy of compactors: level h holds samples that
+ * each stand for 2^h originals. When a level fills it is sorted and every
+ * other sample, starting at a random parity, moves up a level, so rank
+ * errors cancel out on average. Capacities shrink by 2/3 per level below
+ * the top, which bounds the sketch to about 3k samples whatever the
+ * stream length, with a rank error near 1.7/k.
+ *
+ * A sketch is single-writer. Give each thread its own and combine them
+ * with ttak_kll_merge(), which yields the sketch of the joined streams.
+ */
+
+#ifndef TTAK_STATS_KLL_H
+#define TTAK_STATS_KLL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Default accuracy parameter; about 1% rank error. */
+#define TTAK_KLL_DEFAULT_K 200
+
+/** Smallest capacity of any level. */
+#define TTAK_KLL_MIN_LEVEL_CAP 8
+
+/** Levels a sketch can grow to; 2^61 samples and beyond. */
+#define TTAK_KLL_MAX_LEVELS 61
+
+/**
+ * @brief KLL sketch state. Fields are private.
+ */
+typedef struct ttak_kll {
+    uint32_t k;                                   /**< Capacity of the top level. */
+    uint32_t levels;                              /**< Levels in use. */
+    uint64_t n;                                   /**< Samples summarised. */
+    uint64_t min;                                 /**< Smallest sample seen. */
+    uint64_t max;                                 /**< Largest sample seen. */
+    uint64_t rng;                                 /**< Chooses the parity each compaction keeps. */
+    uint64_t *items[TTAK_KLL_MAX_LEVELS];         /**< Samples per level. */
+    uint32_t len[TTAK_KLL_MAX_LEVELS];            /**< Samples held per level. */
+    uint32_t alloc[TTAK_KLL_MAX_LEVELS];          /**< Allocated slots per level. */
+} ttak_kll_t;
+
+/**
+ * @brief Initialises an empty sketch; nothing is allocated until the first sample.
+ *
+ * @param k Accuracy parameter; 0 selects TTAK_KLL_DEFAULT_K.
+ * @param seed Seed for the compaction coin; any value.
+ */
+void ttak_kll_init(ttak_kll_t *sk, uint32_t k, uint64_t seed);
+
+/**
+ * @brief Frees the sketch's buffers; it may be initialised again.
+ */
+void ttak_kll_destroy(ttak_kll_t *sk);
+
+/**
+ * @brief Adds one sample.
+ *
+ * @return false if a level could not grow; the sample is then dropped.
+ */
+_Bool ttak_kll_update(ttak_kll_t *sk, uint64_t value);
+
+/**
+ * @brief Folds @p src into @p dst; @p src is left unchanged.
+ *
+ * Both sketches should share @c k; @p dst keeps its own.
+ *
+ * @return false on allocation failure, leaving @p dst partly merged.
+ */
+_Bool ttak_kll_merge(ttak_kll_t *dst, const ttak_kll_t *src);
+
+/**
+ * @brief Samples summarised.
+ */
+uint64_t ttak_kll_count(const ttak_kll_t *sk);
+
+/**
+ * @brief Estimated values at @p nq quantiles in [0, 1], with one sort.
+ *
+ * Quantile 0 is the exact minimum and 1 the exact maximum.
+ *
+ * @return false if the sketch is empty or scratch space could not be allocated.
+ */
+_Bool ttak_kll_quantiles(const ttak_kll_t *sk, const double *qs, size_t nq, uint64_t *out);
+
+/**
+ * @brief Estimated value at quantile @p q; 0 for an empty sketch.
+ */
+uint64_t ttak_kll_quantile(const ttak_kll_t *sk, double q);
+
+/**
+ * @brief Estimated fraction of samples less than or equal to @p value.
+ */
+double ttak_kll_rank(const ttak_kll_t *sk, uint64_t value);
+
+#endif // TTAK_STATS_KLL_H
@@ -0,0 +1,223 @@
+/**
+ * @file metrics.h
+ * @brief Registry of counters, gauges and histograms with a Prometheus text exporter.
+ *
+ * A metric is either owned or read through a callback. An owned metric
+ * keeps its own storage:
+ * - a counter has one cache line per shard, and the calling thread always
+ *   adds to the same one
+ * - a gauge is a single atomic
+ * - a histogram is a ttak_stats_t
+ * None of these updates take a lock. A callback metric reads a value that
+ * already lives elsewhere, such as a pool's queue depth or the allocator's
+ * byte count, and is evaluated only when the registry is scraped.
+ *
+ * Registering, unregistering and exporting serialise on the registry's
+ * mutex; updates never touch it. ttak_metrics_write() emits the Prometheus
+ * text exposition format, which OpenMetrics scrapers also accept.
+ * Series sharing a name are grouped under one HELP/TYPE header.
+ * Histograms are reported with power-of-two bucket bounds.
+ *
+ * ttak_metrics_default() is a process-wide registry that already exports
+ * allocator and epoch-reclamation health; thread pools and lattices add
+ * themselves with their *_export_metrics() helpers.
+ */
+
+#ifndef TTAK_STATS_METRICS_H
+#define TTAK_STATS_METRICS_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <ttak/stats/stats.h>
+
+typedef enum ttak_metric_type {
+    TTAK_METRIC_COUNTER = 0,    /**< Monotonic total. */
+    TTAK_METRIC_GAUGE,          /**< Value that goes up and down. */
+    TTAK_METRIC_HISTOGRAM       /**< Distribution of observed values. */
+} ttak_metric_type_t;
+
+/** Reads a counter or gauge at scrape time. */
+typedef double (*ttak_metric_read_fn)(void *arg);
+/** Fills a histogram snapshot at scrape time. */
+typedef void (*ttak_metric_snapshot_fn)(void *arg, ttak_stats_snapshot_t *out);
+
+/**
+ * @brief One counter cell, alone on its cache line.
+ */
+typedef struct ttak_metric_cell {
+    _Alignas(64) _Atomic uint64_t value;
+} ttak_metric_cell_t;
+
+/**
+ * @brief A registered series.
+ */
+typedef struct ttak_metric {
+    struct ttak_metric *next;
+    char *name;
+    char *help;
+    char *labels;                       /**< `key="value",...` without braces, or NULL. */
+    ttak_metric_type_t type;
+    const void *owner;                  /**< Grouping key for ttak_metrics_unregister_owner(). */
+    ttak_metric_read_fn read;           /**< Callback counter or gauge. */
+    ttak_metric_snapshot_fn snapshot;   /**< Callback histogram. */
+    void *arg;
+    ttak_stats_t *hist;                 /**< Owned histogram. */
+    _Atomic int64_t gauge;              /**< Owned gauge. */
+    ttak_metric_cell_t cells[TTAK_STATS_SHARDS]; /**< Owned counter. */
+} ttak_metric_t;
+
+/**
+ * @brief A set of metrics exported together.
+ */
+typedef struct ttak_metrics_registry {
+    pthread_mutex_t lock;
+    ttak_metric_t *head;
+    ttak_metric_t *tail;
+} ttak_metrics_registry_t;
+
+void ttak_metrics_registry_init(ttak_metrics_registry_t *reg);
+
+/**
+ * @brief Frees every metric. No thread may still update them.
+ */
+void ttak_metrics_registry_destroy(ttak_metrics_registry_t *reg);
+
+/**
+ * @brief Process-wide registry, created on first use with the built-in
+ *        allocator and epoch metrics.
+ */
+ttak_metrics_registry_t *ttak_metrics_default(void);
+
+/**
+ * @brief Registers an owned counter, gauge or histogram.
+ *
+ * @param name   Metric name, matching [a-zA-Z_:][a-zA-Z0-9_:]*.
+ * @param help   One-line description, or NULL.
+ * @param labels Label pairs as they appear between the braces, e.g.
+ *               `pool="io",shard="3"`, or NULL. Copied.
+ * @return NULL on an invalid name or allocation failure.
+ */
+ttak_metric_t *ttak_metrics_counter(ttak_metrics_registry_t *reg, const char *name, const char *help,
+                                    const char *labels);
+ttak_metric_t *ttak_metrics_gauge(ttak_metrics_registry_t *reg, const char *name, const char *help,
+                                  const char *labels);
+ttak_metric_t *ttak_metrics_histogram(ttak_metrics_registry_t *reg, const char *name, const char *help,
+                                      const char *labels);
+
+/**
+ * @brief Registers a counter or gauge whose value @p read returns at scrape time.
+ *
+ * @param owner Key for ttak_metrics_unregister_owner(), typically @p arg.
+ */
+ttak_metric_t *ttak_metrics_register_fn(ttak_metrics_registry_t *reg, ttak_metric_type_t type,
+                                        const char *name, const char *help, const char *labels,
+                                        ttak_metric_read_fn read, void *arg, const void *owner);
+
+/**
+ * @brief Registers a histogram that @p snapshot fills at scrape time.
+ */
+ttak_metric_t *ttak_metrics_register_histogram_fn(ttak_metrics_registry_t *reg, const char *name,
+                                                  const char *help, const char *labels,
+                                                  ttak_metric_snapshot_fn snapshot, void *arg,
+                                                  const void *owner);
+
+/**
+ * @brief Removes and frees @p metric. No thread may still update it.
+ */
+void ttak_metrics_unregister(ttak_metrics_registry_t *reg, ttak_metric_t *metric);
+
+/**
+ * @brief Removes every metric registered with @p owner.
+ *
+ * @return Number of metrics removed.
+ */
+size_t ttak_metrics_unregister_owner(ttak_metrics_registry_t *reg, const void *owner);
+
+/**
+ * @brief Adds @p n to an owned counter.
+ */
+void ttak_metric_add(ttak_metric_t *metric, uint64_t n);
+
+static inline void ttak_metric_inc(ttak_metric_t *metric) {
+    ttak_metric_add(metric, 1);
+}
+
+/**
+ * @brief Sets an owned gauge.
+ */
+static inline void ttak_metric_set(ttak_metric_t *metric, int64_t value) {
+    atomic_store_explicit(&metric->gauge, value, memory_order_relaxed);
+}
+
+/**
+ * @brief Adds @p delta (possibly negative) to an owned gauge.
+ */
+static inline void ttak_metric_gauge_add(ttak_metric_t *metric, int64_t delta) {
+    atomic_fetch_add_explicit(&metric->gauge, delta, memory_order_relaxed);
+}
+
+/**
+ * @brief Records one value into an owned histogram.
+ */
+static inline void ttak_metric_observe(ttak_metric_t *metric, uint64_t value) {
+    ttak_stats_record(metric->hist, value);
+}
+
+/**
+ * @brief Current value of a counter or gauge, owned or callback.
+ */
+double ttak_metric_value(const ttak_metric_t *metric);
+
+/** Receives exporter output; returns non-zero to abort the write. */
+typedef int (*ttak_metrics_sink_fn)(void *arg, const char *data, size_t len);
+
+/**
+ * @brief Writes every metric in Prometheus text format through @p sink.
+ *
+ * @return 0 on success, -1 if the sink aborted.
+ */
+int ttak_metrics_write(ttak_metrics_registry_t *reg, ttak_metrics_sink_fn sink, void *arg);
+
+/**
+ * @brief ttak_metrics_write() into a stdio stream.
+ */
+int ttak_metrics_write_file(ttak_metrics_registry_t *reg, FILE *out);
+
+/**
+ * @brief Answers one HTTP request on @p fd with the registry, then returns.
+ *
+ * The request itself is read and ignored; @p fd is left open.
+ *
+ * @return 0 on success, -1 on a socket error.
+ */
+int ttak_metrics_serve_fd(ttak_metrics_registry_t *reg, int fd);
+
+typedef struct ttak_metrics_server ttak_metrics_server_t;
+
+/**
+ * @brief Serves the registry over HTTP from a background thread.
+ *
+ * @param bind_addr IPv4 address to listen on, or NULL for 127.0.0.1.
+ * @param port      TCP port, or 0 for an ephemeral one.
+ * @return NULL if the socket cannot be bound or on platforms without
+ *         BSD sockets.
+ */
+ttak_metrics_server_t *ttak_metrics_server_start(ttak_metrics_registry_t *reg, const char *bind_addr,
+                                                 uint16_t port);
+
+/**
+ * @brief Port the server is listening on.
+ */
+uint16_t ttak_metrics_server_port(const ttak_metrics_server_t *server);
+
+/**
+ * @brief Stops the server thread and closes its socket.
+ */
+void ttak_metrics_server_stop(ttak_metrics_server_t *server);
+
+#endif // TTAK_STATS_METRICS_H
@@ -0,0 +1,134 @@
+/**
+ * @file perf.h
+ * @brief Hardware performance counters around scoped regions.
+ *
+ * Each thread opens one perf_event group on first use: cycles as the
+ * leader, then instructions, cache misses and branch misses, all counting
+ * user space only. A read uses rdpmc when the kernel maps the counters for
+ * user space and falls back to one read() of the whole group otherwise.
+ * Where perf_event_open is refused (no PMU, a strict perf_event_paranoid,
+ * a seccomp filter, or a platform other than Linux) every read returns
+ * zero counts and ttak_perf_available() reports false, so instrumented
+ * code runs unchanged.
+ *
+ * A region folds the deltas of every begin/end pair into one ttak_stats_t
+ * per counter plus one for wall time. ttak_stats_t shards by thread, so
+ * threads recording the same region do not contend.
+ *
+ * Define TTAK_PERF_DISABLE to compile TTAK_PERF_BEGIN/END down to a plain
+ * block.
+ */
+
+#ifndef TTAK_STATS_PERF_H
+#define TTAK_STATS_PERF_H
+
+#include <stdint.h>
+#include <ttak/stats/stats.h>
+
+/**
+ * @brief Counters every thread group tracks.
+ */
+typedef enum ttak_perf_event {
+    TTAK_PERF_CYCLES = 0,
+    TTAK_PERF_INSTRUCTIONS,
+    TTAK_PERF_CACHE_MISSES,
+    TTAK_PERF_BRANCH_MISSES,
+    TTAK_PERF_EVENTS
+} ttak_perf_event_t;
+
+/**
+ * @brief Counter values and wall clock at one instant on one thread.
+ */
+typedef struct ttak_perf_sample {
+    uint64_t ns;                       /**< ttak_get_tick_count_ns() at the read. */
+    uint64_t value[TTAK_PERF_EVENTS];  /**< Raw counts; 0 for a counter that is not open. */
+} ttak_perf_sample_t;
+
+/**
+ * @brief Accumulated begin/end deltas of one instrumented region.
+ *
+ * Large (five ttak_stats_t); give it static storage.
+ */
+typedef struct ttak_perf_region {
+    const char *name;
+    ttak_stats_t ns;                       /**< Wall time per pass. */
+    ttak_stats_t event[TTAK_PERF_EVENTS];  /**< Counter delta per pass. */
+} ttak_perf_region_t;
+
+/**
+ * @brief Per-pass means of a region.
+ */
+typedef struct ttak_perf_summary {
+    uint64_t passes;                  /**< Begin/end pairs recorded. */
+    double ns;                        /**< Mean wall time. */
+    double value[TTAK_PERF_EVENTS];   /**< Mean counter deltas. */
+    double ipc;                       /**< Instructions per cycle; 0 without counters. */
+} ttak_perf_summary_t;
+
+/**
+ * @brief Opens the calling thread's counters if needed.
+ *
+ * @return true if at least the cycle counter is open on this thread.
+ */
+_Bool ttak_perf_available(void);
+
+/**
+ * @brief Closes the calling thread's counters; the next read reopens them.
+ *
+ * Threads that exit close their counters automatically.
+ */
+void ttak_perf_thread_close(void);
+
+/**
+ * @brief Mask of TTAK_PERF_* bits open on the calling thread.
+ */
+uint32_t ttak_perf_open_mask(void);
+
+/**
+ * @brief Reads every counter of the calling thread.
+ */
+void ttak_perf_read(ttak_perf_sample_t *out);
+
+/**
+ * @brief Prepares an empty region.
+ *
+ * @param name Label for ttak_perf_region_print(); not copied.
+ */
+void ttak_perf_region_init(ttak_perf_region_t *r, const char *name);
+
+/**
+ * @brief Records the deltas between two samples taken on the same thread.
+ */
+void ttak_perf_region_record(ttak_perf_region_t *r, const ttak_perf_sample_t *begin,
+                             const ttak_perf_sample_t *end);
+
+/**
+ * @brief Means over every pass recorded so far.
+ */
+void ttak_perf_region_summary(const ttak_perf_region_t *r, ttak_perf_summary_t *out);
+
+/**
+ * @brief Prints passes, ns, IPC and misses per pass on one line to stdout.
+ */
+void ttak_perf_region_print(const ttak_perf_region_t *r);
+
+#ifndef TTAK_PERF_DISABLE
+/**
+ * @brief Opens a measured block; close it with TTAK_PERF_END() in the same scope.
+ */
+#define TTAK_PERF_BEGIN(region)                  \
+    {                                            \
+        ttak_perf_sample_t ttak_perf_begin_;     \
+        ttak_perf_read(&ttak_perf_begin_);
+
+#define TTAK_PERF_END(region)                                              \
+        ttak_perf_sample_t ttak_perf_end_;                                 \
+        ttak_perf_read(&ttak_perf_end_);                                   \
+        ttak_perf_region_record((region), &ttak_perf_begin_, &ttak_perf_end_); \
+    }
+#else
+#define TTAK_PERF_BEGIN(region) {
+#define TTAK_PERF_END(region) }
+#endif
+
+#endif // TTAK_STATS_PERF_H
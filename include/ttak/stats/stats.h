@@ -1,40 +1,107 @@
 #ifndef TTAK_STATS_STATS_H
 #define TTAK_STATS_STATS_H
 
+#include <stdatomic.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <ttak/sync/sync.h>
 #include <ttak/sync/spinlock.h>
+#include <ttak/types/ttak_compiler.h>
 
-#define TTAK_STATS_HIST_BUCKETS 10
+/** log2 of the sub-buckets per power of two; buckets are at most 1/16 of their value wide. */
+#define TTAK_STATS_SUB_BITS 4
+#define TTAK_STATS_SUB_BUCKETS (1U << TTAK_STATS_SUB_BITS)
+
+/**
+ * Log-linear buckets covering every uint64_t: values below
+ * TTAK_STATS_SUB_BUCKETS get one bucket each, and every power of two
+ * above is split into TTAK_STATS_SUB_BUCKETS equal buckets.
+ */
+#define TTAK_STATS_HIST_BUCKETS ((64U - TTAK_STATS_SUB_BITS + 1U) * TTAK_STATS_SUB_BUCKETS)
+
+/** Cells samples are spread over; each thread always records into the same one. */
+#define TTAK_STATS_SHARDS 8
+
+/**
+ * @brief One shard of a stats accumulator, on its own cache lines.
+ */
+typedef struct ttak_stats_cell {
+    _Alignas(64) _Atomic uint64_t count;
+    _Atomic uint64_t sum;
+    _Atomic uint64_t min;
+    _Atomic uint64_t max;
+    _Atomic uint64_t histogram[TTAK_STATS_HIST_BUCKETS];
+} ttak_stats_cell_t;
 
 /**
  * @brief Thread-safe Statistics structure.
- * 
- * Tracks count, sum, min, max, and a simple histogram.
+ *
+ * Tracks count, sum, min, max, and a log-linear histogram. Recording is a
+ * few relaxed atomic adds on the calling thread's cell, so concurrent
+ * writers do not contend; readers merge the cells with ttak_stats_snapshot().
  */
 typedef struct ttak_stats {
-    uint64_t count;                             /**< Total number of samples. */
-    uint64_t sum;                               /**< Sum of all sample values. */
-    uint64_t min;                               /**< Minimum value observed. */
-    uint64_t max;                               /**< Maximum value observed. */
-    uint64_t histogram[TTAK_STATS_HIST_BUCKETS];/**< Histogram buckets. */
-    uint64_t hist_min;                          /**< Lower bound for the histogram. */
-    uint64_t hist_max;                          /**< Upper bound for the histogram. */
-    uint64_t hist_step;                         /**< Range of each histogram bucket. */
-    ttak_spin_t lock;                           /**< Spinlock for thread safety. */
+    uint64_t hist_min;                       /**< Lower bound of the printed histogram. */
+    uint64_t hist_max;                       /**< Upper bound of the printed histogram. */
+    ttak_stats_cell_t cells[TTAK_STATS_SHARDS];
 } ttak_stats_t;
 
 typedef ttak_stats_t tt_stats_t;
 
+/**
+ * @brief Merged view of a stats accumulator.
+ */
+typedef struct ttak_stats_snapshot {
+    uint64_t count;                               /**< Total number of samples. */
+    uint64_t sum;                                 /**< Sum of all sample values. */
+    uint64_t min;                                 /**< Minimum value observed; 0 if none. */
+    uint64_t max;                                 /**< Maximum value observed. */
+    uint64_t histogram[TTAK_STATS_HIST_BUCKETS];  /**< Samples per log-linear bucket. */
+} ttak_stats_snapshot_t;
+
 /**
  * @brief Initializes the statistics structure.
- * 
+ *
+ * Every value is bucketed whatever the bounds; they only select the range
+ * ttak_stats_print_ascii() draws.
+ *
  * @param s Pointer to the stats structure.
  * @param hist_min Lower bound for the histogram.
  * @param hist_max Upper bound for the histogram.
  */
 void ttak_stats_init(ttak_stats_t *s, uint64_t hist_min, uint64_t hist_max);
 
+/**
+ * @brief Bucket index holding @p value; the inline body of ttak_stats_bucket_of().
+ */
+static inline size_t ttak_stats_bucket_index(uint64_t value) {
+    if (value < TTAK_STATS_SUB_BUCKETS) return (size_t)value;
+    unsigned e = 63U - (unsigned)__builtin_clzll(value);
+    size_t sub = (size_t)(value >> (e - TTAK_STATS_SUB_BITS)) & (TTAK_STATS_SUB_BUCKETS - 1U);
+    return ((size_t)(e - TTAK_STATS_SUB_BITS + 1U) << TTAK_STATS_SUB_BITS) | sub;
+}
+
+/**
+ * @brief Records @p value into cell @p c.
+ */
+static inline void ttak_stats_cell_record(ttak_stats_cell_t *c, uint64_t value) {
+    atomic_fetch_add_explicit(&c->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->sum, value, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->histogram[ttak_stats_bucket_index(value)], 1, memory_order_relaxed);
+
+    /* Extremes only change early on, so the common case is one load each. */
+    uint64_t cur = atomic_load_explicit(&c->min, memory_order_relaxed);
+    while (value < cur &&
+           !atomic_compare_exchange_weak_explicit(&c->min, &cur, value,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    cur = atomic_load_explicit(&c->max, memory_order_relaxed);
+    while (value > cur &&
+           !atomic_compare_exchange_weak_explicit(&c->max, &cur, value,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
 /**
  * @brief Records a new value into the statistics.
  * 
@@ -43,10 +110,61 @@ void ttak_stats_init(ttak_stats_t *s, uint64_t hist_min, uint64_t hist_max);
  */
 void ttak_stats_record(ttak_stats_t *s, uint64_t value);
 
+#if defined(TTAK_INLINE_FASTPATHS)
+/** Cell of the calling thread; UINT32_MAX until its first record. */
+extern _Thread_local uint32_t ttak_stats_thread_cell;
+
+/**
+ * @brief Inline ttak_stats_record(): records here once the thread has its cell.
+ */
+TTAK_FORCE_INLINE void ttak_stats_record_inline(ttak_stats_t *s, uint64_t value) {
+    uint32_t cell = ttak_stats_thread_cell;
+    if (TTAK_LIKELY(cell != UINT32_MAX)) {
+        ttak_stats_cell_record(&s->cells[cell], value);
+        return;
+    }
+    (ttak_stats_record)(s, value);
+}
+
+#define ttak_stats_record(s, value) ttak_stats_record_inline((s), (value))
+#endif
+
+/**
+ * @brief Merges every cell into @p out.
+ *
+ * Samples recorded concurrently may or may not be included.
+ */
+void ttak_stats_snapshot(const ttak_stats_t *s, ttak_stats_snapshot_t *out);
+
+/**
+ * @brief Like ttak_stats_snapshot() but fills only count, sum, min and max.
+ */
+void ttak_stats_totals(const ttak_stats_t *s, ttak_stats_snapshot_t *out);
+
+/**
+ * @brief Value at quantile @p q (0..1) of a snapshot.
+ *
+ * @return The top of the bucket holding that rank, clamped to the observed
+ *         range, so at most one bucket (1/16 of the value) above the exact
+ *         answer; 0 for an empty snapshot.
+ */
+uint64_t ttak_stats_snapshot_percentile(const ttak_stats_snapshot_t *snap, double q);
+
+/**
+ * @brief Bucket index holding @p value.
+ */
+size_t ttak_stats_bucket_of(uint64_t value);
+
+/**
+ * @brief Smallest value in bucket @p idx.
+ */
+uint64_t ttak_stats_bucket_lower(size_t idx);
+
 /**
  * @brief Prints the statistics to stdout in ASCII format.
  * 
- * Includes basic metrics and a bar chart for the histogram.
+ * Includes basic metrics, tail percentiles and a bar chart of the
+ * histogram between the bounds given to ttak_stats_init().
  * 
  * @param s Pointer to the stats structure.
  */
@@ -60,14 +178,4 @@ void ttak_stats_print_ascii(ttak_stats_t *s);
  */
 double ttak_stats_mean(ttak_stats_t *s);
 
-#include <ttak/math/bigreal.h>
-
-/**
- * @brief Computes percentiles from raw data and outputs them as bigreal numbers.
- */
-_Bool ttak_stats_compute_percentiles(uint64_t *data, size_t count, 
-                                   ttak_bigreal_t *p50, ttak_bigreal_t *p95, 
-                                   ttak_bigreal_t *p99, ttak_bigreal_t *p999, 
-                                   uint64_t now);
-
-#endif // TTAK_STATS_STATS_H
\ No newline at end of file
+#endif // TTAK_STATS_STATS_H
@@ -5,12 +5,59 @@
 #include <ttak/math/bigint.h>
 #include <ttak/math/bigreal.h>
 #include <ttak/priority/scheduler.h>
+#include <ttak/thread/pool.h>
+
+/**
+ * @brief How ttak_stats_ext_t accumulates its moments.
+ */
+typedef enum ttak_stats_ext_mode {
+    TTAK_STATS_EXT_FAST  = 0, /**< Welford moments in double only; constant cost per sample. */
+    TTAK_STATS_EXT_EXACT = 1  /**< Also keeps exact bigint power sums for ttak_stats_ext_variance(). */
+} ttak_stats_ext_mode_t;
+
+/**
+ * @brief Running means and centred moments of (x, y), updated with Welford's method.
+ */
+typedef struct ttak_stats_welford {
+    uint64_t n;       /**< Samples folded in. */
+    double mean_x;
+    double mean_y;
+    double m2_x;      /**< Sum of squared deviations of x from its mean. */
+    double m2_y;      /**< Sum of squared deviations of y from its mean. */
+    double c_xy;      /**< Sum of products of the x and y deviations. */
+} ttak_stats_welford_t;
+
+/**
+ * @brief Folds one (x, y) pair into @p w.
+ */
+static inline void ttak_stats_welford_update(ttak_stats_welford_t *w, double x, double y) {
+    w->n++;
+    double inv = 1.0 / (double)w->n;
+    double dx = x - w->mean_x;
+    double dy = y - w->mean_y;
+    w->mean_x += dx * inv;
+    w->mean_y += dy * inv;
+    w->m2_x += dx * (x - w->mean_x);
+    w->m2_y += dy * (y - w->mean_y);
+    w->c_xy += dx * (y - w->mean_y);
+}
+
+/**
+ * @brief Combines @p src into @p dst as if every sample had gone to @p dst (Chan et al.).
+ */
+void ttak_stats_welford_merge(ttak_stats_welford_t *dst, const ttak_stats_welford_t *src);
 
 /**
  * @brief Extended statistics structure with automatic promotion and high precision.
+ *
+ * Every mode keeps the Welford moments, from which the *_f64 queries
+ * answer in constant time. TTAK_STATS_EXT_EXACT additionally runs the
+ * bigint accumulators below on every sample.
  */
 typedef struct ttak_stats_ext {
     ttak_stats_t base;
+    ttak_stats_ext_mode_t mode;
+    ttak_stats_welford_t welford;  /**< Guarded by @c lock_ext. */
     _Bool promoted;
     
     // High precision accumulators (used if promoted or for complex stats)
@@ -25,10 +72,20 @@ typedef struct ttak_stats_ext {
 } ttak_stats_ext_t;
 
 /**
- * @brief Initializes the extended statistics.
+ * @brief Initializes the extended statistics in TTAK_STATS_EXT_FAST mode.
  */
 void ttak_stats_ext_init(ttak_stats_ext_t *s, uint64_t now);
 
+/**
+ * @brief Initializes the extended statistics in @p mode.
+ */
+void ttak_stats_ext_init_mode(ttak_stats_ext_t *s, ttak_stats_ext_mode_t mode, uint64_t now);
+
+/**
+ * @brief Frees the bigint accumulators.
+ */
+void ttak_stats_ext_destroy(ttak_stats_ext_t *s, uint64_t now);
+
 /**
  * @brief Records a sample pair (x, y) for correlation/regression.
  * If y is not needed, pass 0.
@@ -36,25 +93,61 @@ void ttak_stats_ext_init(ttak_stats_ext_t *s, uint64_t now);
 void ttak_stats_ext_record(ttak_stats_ext_t *s, uint64_t x, uint64_t y, uint64_t now);
 
 /**
- * @brief Calculates the variance.
+ * @brief Calculates the population variance of x.
+ *
+ * Exact from the bigint power sums in TTAK_STATS_EXT_EXACT mode; otherwise
+ * the Welford value rounded to 16 significant digits.
  */
 _Bool ttak_stats_ext_variance(ttak_bigreal_t *res, ttak_stats_ext_t *s, uint64_t now);
 
 /**
- * @brief Calculates the standard deviation.
+ * @brief Calculates the standard deviation of x, from the Welford moments.
  */
 _Bool ttak_stats_ext_stddev(ttak_bigreal_t *res, ttak_stats_ext_t *s, uint64_t now);
 
 /**
- * @brief Calculates the correlation coefficient.
+ * @brief Calculates the correlation coefficient, from the Welford moments.
  */
 _Bool ttak_stats_ext_correlation(ttak_bigreal_t *res, ttak_stats_ext_t *s, uint64_t now);
 
 /**
- * @brief Performs linear regression, returning slope and intercept.
+ * @brief Performs a least-squares fit y = slope * x + intercept, from the Welford moments.
  */
 _Bool ttak_stats_ext_linear_regression(ttak_bigreal_t *slope, ttak_bigreal_t *intercept, ttak_stats_ext_t *s, uint64_t now);
 
+/**
+ * @brief Mean of x; 0 with no samples.
+ */
+double ttak_stats_ext_mean_f64(ttak_stats_ext_t *s);
+
+/**
+ * @brief Population variance of x.
+ *
+ * @return false with no samples.
+ */
+_Bool ttak_stats_ext_variance_f64(ttak_stats_ext_t *s, double *out);
+
+/**
+ * @brief Population standard deviation of x.
+ *
+ * @return false with no samples.
+ */
+_Bool ttak_stats_ext_stddev_f64(ttak_stats_ext_t *s, double *out);
+
+/**
+ * @brief Pearson correlation of x and y.
+ *
+ * @return false unless both x and y vary.
+ */
+_Bool ttak_stats_ext_correlation_f64(ttak_stats_ext_t *s, double *out);
+
+/**
+ * @brief Least-squares fit y = slope * x + intercept.
+ *
+ * @return false unless x varies.
+ */
+_Bool ttak_stats_ext_linear_regression_f64(ttak_stats_ext_t *s, double *slope, double *intercept);
+
 /**
  * @brief Distribution analysis: Normal PDF.
  */
@@ -72,13 +165,37 @@ _Bool ttak_stats_dist_binomial(ttak_bigreal_t *res, uint64_t k, uint64_t n, cons
 
 /**
  * @brief Parallel mean/variance calculation for large datasets.
+ *
+ * In TTAK_STATS_EXT_FAST mode each task folds its chunk into private
+ * Welford moments and merges them once; exact mode records every sample.
  */
 _Bool ttak_stats_parallel_process(ttak_stats_ext_t *s, uint64_t *data, size_t count, ttak_scheduler_t *sched, uint64_t now);
 
+/**
+ * @brief Values at several quantiles of @p data without sorting it.
+ *
+ * A radix pass over the sample range finds the bin holding each wanted
+ * rank, then only those bins' samples are copied out and finished with a
+ * multi-rank introselect. Each of the three scans is split across @p pool.
+ *
+ * @param data Samples; not modified.
+ * @param count Number of samples.
+ * @param qs Quantiles in [0, 1]; out[i] is the sample at rank
+ *           floor(qs[i] * count) of the sorted data.
+ * @param nq Number of quantiles.
+ * @param out Results, one per quantile.
+ * @param pool Pool the scans run on, or NULL to run on the caller.
+ * @param now Timestamp for task submission.
+ * @return false on bad arguments or allocation failure.
+ */
+_Bool ttak_stats_select_quantiles(const uint64_t *data, size_t count, const double *qs, size_t nq,
+                                  uint64_t *out, ttak_thread_pool_t *pool, uint64_t now);
+
 /**
  * @brief Calculates specific percentiles (P50, P95, P99, P99.9) from a dataset.
- * 
- * Note: This operation modifies the input 'data' array by sorting it.
+ *
+ * Runs ttak_stats_select_quantiles() on the async pool; @p data is left
+ * in place.
  * 
  * @param data Array of samples.
  * @param count Number of samples.
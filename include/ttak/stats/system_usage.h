@@ -1,7 +1,9 @@
 #ifndef TTAK_STATS_SYSTEM_USAGE_H
 #define TTAK_STATS_SYSTEM_USAGE_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,6 +16,110 @@ double ttak_get_gpu_usage_per_cu(int cu);
 size_t ttak_get_rss_footprint(void);
 char *ttak_get_rss_footprint_full(void);
 
+/*
+ * Background sampler.
+ *
+ * One thread keeps /proc/stat, /proc/self/statm and the cgroup's PSI and
+ * memory files open and re-reads them with pread() at a fixed rate,
+ * parsing with a plain integer scanner. Each sample is published under a
+ * seqlock, so readers copy a consistent snapshot without a lock or a
+ * syscall. While the sampler runs, the functions above answer from the
+ * latest snapshot instead of reading /proc themselves.
+ */
+
+/** CPUs tracked individually; later ones only count toward the total. */
+#define TTAK_SYS_MAX_CPUS 256
+
+/**
+ * @brief One PSI resource line pair, in percent of wall time.
+ */
+typedef struct ttak_sys_psi {
+    double some_avg10;      /**< Some task stalled, 10 s average. */
+    double some_avg60;
+    double full_avg10;      /**< All tasks stalled, 10 s average; 0 for CPU on older kernels. */
+    uint64_t some_total_us; /**< Cumulative stall time. */
+} ttak_sys_psi_t;
+
+/**
+ * @brief Everything one sample measures.
+ */
+typedef struct ttak_sys_snapshot {
+    uint64_t seq;                       /**< Samples taken so far; 0 means none yet. */
+    uint64_t ts_ns;                     /**< ttak_get_tick_count_ns() at the sample. */
+    double cpu_total;                   /**< Busy percent since the previous sample. */
+    uint32_t ncpu;                      /**< Entries valid in @c cpu_core. */
+    float cpu_core[TTAK_SYS_MAX_CPUS];  /**< Busy percent per CPU since the previous sample. */
+    size_t rss_bytes;
+    size_t vm_bytes;
+    bool has_cgroup_mem;                /**< Whether the cgroup memory fields are meaningful. */
+    uint64_t cgroup_mem_current;        /**< Bytes charged to the cgroup. */
+    uint64_t cgroup_mem_max;            /**< Hard limit; UINT64_MAX when unlimited. */
+    uint64_t cgroup_mem_high;           /**< Throttle limit (v2 memory.high); UINT64_MAX when unset. */
+    bool has_psi;                       /**< Whether the PSI fields are meaningful. */
+    ttak_sys_psi_t psi_cpu;
+    ttak_sys_psi_t psi_mem;
+    ttak_sys_psi_t psi_io;
+} ttak_sys_snapshot_t;
+
+/**
+ * @brief Starts the sampler thread at @p hz samples per second (1..1000),
+ *        or changes the rate of a running one.
+ *
+ * @return 0 on success, -1 if the thread cannot be started.
+ */
+int ttak_sys_sampler_start(uint32_t hz);
+
+/**
+ * @brief Stops the sampler thread. The last snapshot stays readable.
+ */
+void ttak_sys_sampler_stop(void);
+
+/**
+ * @brief Returns true while the sampler thread runs.
+ */
+bool ttak_sys_sampler_running(void);
+
+/**
+ * @brief Takes one sample on the calling thread and publishes it.
+ */
+void ttak_sys_sampler_sample_now(void);
+
+/**
+ * @brief Copies the latest snapshot.
+ *
+ * @return false if no sample has been taken yet.
+ */
+bool ttak_sys_sampler_read(ttak_sys_snapshot_t *out);
+
+/**
+ * @brief CPU PSI "some" 10 s average of the latest sample, in percent,
+ *        or -1 when unknown. One atomic load.
+ */
+double ttak_sys_cpu_pressure(void);
+
+/**
+ * @brief Memory PSI "some" 10 s average of the latest sample, in percent,
+ *        or -1 when unknown. One atomic load.
+ */
+double ttak_sys_mem_pressure(void);
+
+struct ttak_mem_tree;
+
+/**
+ * @brief Asks the sampler to wake @p tree's cleanup whenever memory PSI
+ *        "some" reaches @p threshold_pct. NULL detaches.
+ */
+void ttak_sys_sampler_attach_mem_tree(struct ttak_mem_tree *tree, double threshold_pct);
+
+/** Runs after each published sample, on the thread that took it. */
+typedef void (*ttak_sys_sample_fn)(const ttak_sys_snapshot_t *snap, void *arg);
+
+/**
+ * @brief Installs the post-sample hook, replacing any previous one; NULL
+ *        removes it. Returns once no call to the old hook is in progress.
+ */
+void ttak_sys_sampler_set_hook(ttak_sys_sample_fn fn, void *arg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,69 @@
+/**
+ * @file brlock.h
+ * @brief Reader-biased rwlock (BRAVO) over a pthread rwlock.
+ *
+ * Every pthread_rwlock_rdlock() writes the lock word, so readers on
+ * different cores fight over one cache line even though they never block
+ * each other. ttak_brlock_t adds a reader bias in front of the rwlock:
+ * while it is set, a reader publishes itself by CASing the lock's address
+ * into a slot of a process-wide visible-readers table picked by hashing
+ * the thread and the lock, and never touches the lock itself. Different
+ * threads land on different slots, so read acquisition stays on a line
+ * the thread mostly has to itself.
+ *
+ * A writer takes the underlying rwlock, clears the bias and waits until no
+ * table slot holds the lock (revocation). Because that scan is costly,
+ * the bias stays off for a multiple of the time it took; a reader that
+ * arrives on the slow path after that window turns it back on. Readers
+ * that find their slot taken, or the bias off, fall back to the rwlock.
+ *
+ * A thread may hold up to TTAK_BRLOCK_MAX_FAST biased read locks at once;
+ * further ones use the slow path. Read unlocks must use
+ * ttak_brlock_rdunlock() on the locking thread and write unlocks
+ * ttak_brlock_wrunlock(). Tiny C builds always take the slow path.
+ */
+
+#ifndef TTAK_SYNC_BRLOCK_H
+#define TTAK_SYNC_BRLOCK_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+/** Slots in the process-wide visible-readers table. */
+#define TTAK_BRLOCK_TABLE_SIZE 4096
+
+/** Biased read locks one thread may hold before using the rwlock. */
+#define TTAK_BRLOCK_MAX_FAST 8
+
+/** Bias stays off for this many times the last revocation's duration. */
+#define TTAK_BRLOCK_INHIBIT_MULT 9
+
+/**
+ * @brief Reader-biased rwlock.
+ */
+typedef struct ttak_brlock {
+    pthread_rwlock_t lock;                /**< Writers and slow-path readers. */
+    _Atomic uint32_t rbias;               /**< Readers may use the table. */
+    _Atomic uint64_t inhibit_until_ns;    /**< No re-biasing before this time. */
+} ttak_brlock_t;
+
+#define TTAK_BRLOCK_INITIALIZER { PTHREAD_RWLOCK_INITIALIZER, 1, 0 }
+
+int ttak_brlock_init(ttak_brlock_t *lock);
+int ttak_brlock_destroy(ttak_brlock_t *lock);
+
+/**
+ * @brief Acquires for reading; with the bias on this writes only the
+ *        caller's table slot.
+ */
+int ttak_brlock_rdlock(ttak_brlock_t *lock);
+int ttak_brlock_rdunlock(ttak_brlock_t *lock);
+
+/**
+ * @brief Acquires for writing and revokes the reader bias if it is on.
+ */
+int ttak_brlock_wrlock(ttak_brlock_t *lock);
+int ttak_brlock_wrunlock(ttak_brlock_t *lock);
+
+#endif // TTAK_SYNC_BRLOCK_H
@@ -0,0 +1,252 @@
+/**
+ * @file qlock.h
+ * @brief Fair and queue-based spin locks for contended critical sections.
+ *
+ * ttak_spin_t is a test-and-set lock: every waiter hammers the same cache
+ * line and the winner is whoever's CAS lands first. That is the cheapest
+ * lock with no contention and the worst one with a lot of it. This header
+ * adds the classic alternatives, all with the init/lock/trylock/unlock
+ * shape of ttak_spin_t and all zero-initializable:
+ *
+ * - ttak_ticket_t: FIFO; waiters still read one line but only write once.
+ * - ttak_mcs_t: each waiter spins on its own node; the owner hands over
+ *   with a single remote write.
+ * - ttak_clh_t: like MCS, but a waiter spins on its predecessor's node, so
+ *   release is one store and never waits for a successor to link in.
+ * - ttak_cohort_t: a ticket lock per NUMA node under a global ticket lock.
+ *   A releasing owner with a waiter on its own node passes the global lock
+ *   along with the local one, up to a batch limit, so the lock stays on
+ *   one socket for a while instead of bouncing between them.
+ *
+ * MCS and CLH queue nodes come from a small per-thread pool, so callers do
+ * not manage them. A thread may hold up to TTAK_MCS_MAX_HELD MCS locks at
+ * once; CLH has no limit. Unlock must happen on the thread that locked.
+ *
+ * ttak_hot_lock_t picks one of these (or ttak_spin_t) at build time for the
+ * library's own short, hot critical sections. Build with
+ * EXTRA_CFLAGS=-DTTAK_HOT_LOCK=TTAK_HOT_LOCK_MCS (or _TICKET, _CLH,
+ * _COHORT) to switch them over; the default is TTAK_HOT_LOCK_TAS.
+ */
+
+#ifndef TTAK_SYNC_QLOCK_H
+#define TTAK_SYNC_QLOCK_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <ttak/sync/spinlock.h>
+
+/** Most MCS locks one thread may hold at the same time. */
+#define TTAK_MCS_MAX_HELD 16
+
+/** NUMA nodes with their own cohort; higher nodes share modulo this. */
+#define TTAK_COHORT_MAX_NODES 8
+
+/** Local handoffs before a cohort owner must release the global lock. */
+#define TTAK_COHORT_BATCH 64
+
+/* ---- Ticket ------------------------------------------------------------ */
+
+/**
+ * @brief FIFO ticket lock.
+ */
+typedef struct ttak_ticket {
+    _Atomic uint32_t next;   /**< Next ticket to hand out. */
+    _Atomic uint32_t owner;  /**< Ticket currently allowed in. */
+} ttak_ticket_t;
+
+#define TTAK_TICKET_INITIALIZER { 0, 0 }
+
+static inline void ttak_ticket_init(ttak_ticket_t *lock) {
+    atomic_init(&lock->next, 0);
+    atomic_init(&lock->owner, 0);
+}
+
+/**
+ * @brief Takes a ticket and waits for it, backing off in proportion to
+ *        the number of waiters ahead.
+ */
+void ttak_ticket_lock(ttak_ticket_t *lock);
+
+/**
+ * @brief Acquires the lock only if nobody holds or waits for it.
+ */
+static inline bool ttak_ticket_trylock(ttak_ticket_t *lock) {
+    uint32_t owner = atomic_load_explicit(&lock->owner, memory_order_relaxed);
+    uint32_t expected = owner;
+    return atomic_compare_exchange_strong_explicit(&lock->next, &expected, owner + 1,
+                                                   memory_order_acquire, memory_order_relaxed);
+}
+
+static inline void ttak_ticket_unlock(ttak_ticket_t *lock) {
+    uint32_t owner = atomic_load_explicit(&lock->owner, memory_order_relaxed);
+    atomic_store_explicit(&lock->owner, owner + 1, memory_order_release);
+}
+
+/**
+ * @brief True while a thread other than the owner is queued. Owner only.
+ */
+static inline bool ttak_ticket_has_waiters(ttak_ticket_t *lock) {
+    uint32_t next = atomic_load_explicit(&lock->next, memory_order_relaxed);
+    uint32_t owner = atomic_load_explicit(&lock->owner, memory_order_relaxed);
+    return next - owner > 1;
+}
+
+/* ---- MCS --------------------------------------------------------------- */
+
+/**
+ * @brief MCS queue node; one per waiting or owning thread.
+ */
+typedef struct ttak_mcs_node {
+    struct ttak_mcs_node *_Atomic next;
+    _Atomic uint32_t locked;
+} ttak_mcs_node_t;
+
+/**
+ * @brief MCS queue lock.
+ */
+typedef struct ttak_mcs {
+    ttak_mcs_node_t *_Atomic tail;  /**< Last queued node, NULL when free. */
+    ttak_mcs_node_t *holder;        /**< Owner's node; written only by the owner. */
+} ttak_mcs_t;
+
+#define TTAK_MCS_INITIALIZER { NULL, NULL }
+
+static inline void ttak_mcs_init(ttak_mcs_t *lock) {
+    atomic_init(&lock->tail, NULL);
+    lock->holder = NULL;
+}
+
+/**
+ * @brief Queues behind the current tail and spins on the caller's own node.
+ *
+ * Aborts if the calling thread already holds TTAK_MCS_MAX_HELD MCS locks.
+ */
+void ttak_mcs_lock(ttak_mcs_t *lock);
+bool ttak_mcs_trylock(ttak_mcs_t *lock);
+void ttak_mcs_unlock(ttak_mcs_t *lock);
+
+/* ---- CLH --------------------------------------------------------------- */
+
+/**
+ * @brief CLH queue node. Ownership moves to the successor at release.
+ */
+typedef struct ttak_clh_node {
+    _Atomic uint32_t locked;
+    struct ttak_clh_node *free_next;  /**< Link in the owning thread's node cache. */
+} ttak_clh_node_t;
+
+/**
+ * @brief CLH queue lock.
+ */
+typedef struct ttak_clh {
+    ttak_clh_node_t *_Atomic tail;  /**< Last queued node, NULL when free. */
+    ttak_clh_node_t *holder;        /**< Owner's node; written only by the owner. */
+} ttak_clh_t;
+
+#define TTAK_CLH_INITIALIZER { NULL, NULL }
+
+static inline void ttak_clh_init(ttak_clh_t *lock) {
+    atomic_init(&lock->tail, NULL);
+    lock->holder = NULL;
+}
+
+/**
+ * @brief Queues behind the current tail and spins on the predecessor's node.
+ *
+ * Nodes are cache-line sized heap blocks kept in a per-thread cache and
+ * freed when the thread exits; the first lock on a thread may allocate.
+ * Aborts if that allocation fails.
+ */
+void ttak_clh_lock(ttak_clh_t *lock);
+bool ttak_clh_trylock(ttak_clh_t *lock);
+void ttak_clh_unlock(ttak_clh_t *lock);
+
+/* ---- Cohort ------------------------------------------------------------ */
+
+/**
+ * @brief One NUMA node's share of a cohort lock.
+ */
+typedef struct ttak_cohort_local {
+    _Alignas(64) ttak_ticket_t lock;
+    bool global_held;  /**< The global lock was passed along with this one. */
+    uint32_t batch;    /**< Consecutive local handoffs. */
+} ttak_cohort_local_t;
+
+/**
+ * @brief NUMA-aware cohort lock built from ticket locks.
+ */
+typedef struct ttak_cohort {
+    ttak_ticket_t global;
+    ttak_cohort_local_t local[TTAK_COHORT_MAX_NODES];
+    uint32_t holder;  /**< Index into @c local of the owner; owner only. */
+} ttak_cohort_t;
+
+#define TTAK_COHORT_INITIALIZER { TTAK_TICKET_INITIALIZER, { { TTAK_TICKET_INITIALIZER, false, 0 } }, 0 }
+
+void ttak_cohort_init(ttak_cohort_t *lock);
+
+/**
+ * @brief Acquires the local lock of the caller's current NUMA node, then
+ *        the global lock unless the previous local owner passed it on.
+ */
+void ttak_cohort_lock(ttak_cohort_t *lock);
+bool ttak_cohort_trylock(ttak_cohort_t *lock);
+void ttak_cohort_unlock(ttak_cohort_t *lock);
+
+/**
+ * @brief NUMA node of the CPU the caller runs on, or 0 if unknown.
+ */
+int ttak_qlock_current_node(void);
+
+/* ---- Build-time selection ---------------------------------------------- */
+
+#define TTAK_HOT_LOCK_TAS 0
+#define TTAK_HOT_LOCK_TICKET 1
+#define TTAK_HOT_LOCK_MCS 2
+#define TTAK_HOT_LOCK_CLH 3
+#define TTAK_HOT_LOCK_COHORT 4
+
+#ifndef TTAK_HOT_LOCK
+#define TTAK_HOT_LOCK TTAK_HOT_LOCK_TAS
+#endif
+
+#if TTAK_HOT_LOCK == TTAK_HOT_LOCK_TICKET
+#define TTAK_HOT_LOCK_PREFIX ttak_ticket
+typedef ttak_ticket_t ttak_hot_lock_t;
+#elif TTAK_HOT_LOCK == TTAK_HOT_LOCK_MCS
+#define TTAK_HOT_LOCK_PREFIX ttak_mcs
+typedef ttak_mcs_t ttak_hot_lock_t;
+#elif TTAK_HOT_LOCK == TTAK_HOT_LOCK_CLH
+#define TTAK_HOT_LOCK_PREFIX ttak_clh
+typedef ttak_clh_t ttak_hot_lock_t;
+#elif TTAK_HOT_LOCK == TTAK_HOT_LOCK_COHORT
+#define TTAK_HOT_LOCK_PREFIX ttak_cohort
+typedef ttak_cohort_t ttak_hot_lock_t;
+#elif TTAK_HOT_LOCK == TTAK_HOT_LOCK_TAS
+#define TTAK_HOT_LOCK_PREFIX ttak_spin
+typedef ttak_spin_t ttak_hot_lock_t;
+#else
+#error "TTAK_HOT_LOCK must be one of the TTAK_HOT_LOCK_* values"
+#endif
+
+#define TTAK_HOT_LOCK_CAT_(a, b) a##b
+#define TTAK_HOT_LOCK_CAT(a, b) TTAK_HOT_LOCK_CAT_(a, b)
+
+static inline void ttak_hot_lock_init(ttak_hot_lock_t *lock) {
+    TTAK_HOT_LOCK_CAT(TTAK_HOT_LOCK_PREFIX, _init)(lock);
+}
+
+static inline void ttak_hot_lock(ttak_hot_lock_t *lock) {
+    TTAK_HOT_LOCK_CAT(TTAK_HOT_LOCK_PREFIX, _lock)(lock);
+}
+
+static inline bool ttak_hot_trylock(ttak_hot_lock_t *lock) {
+    return TTAK_HOT_LOCK_CAT(TTAK_HOT_LOCK_PREFIX, _trylock)(lock);
+}
+
+static inline void ttak_hot_unlock(ttak_hot_lock_t *lock) {
+    TTAK_HOT_LOCK_CAT(TTAK_HOT_LOCK_PREFIX, _unlock)(lock);
+}
+
+#endif // TTAK_SYNC_QLOCK_H
@@ -0,0 +1,151 @@
+/**
+ * @file waitword.h
+ * @brief Wait/notify on a 32-bit word, and an eventcount built on it.
+ *
+ * ttak_waitword_wait() sleeps while a word still holds an expected value
+ * and ttak_waitword_wake_*() wakes sleepers on that word. No mutex or
+ * condition variable is involved, so a handoff costs the waker one
+ * syscall (none at all if the caller knows nobody sleeps) and the waiter
+ * one. The backend is the platform's address wait:
+ *
+ * - Linux: futex(FUTEX_WAIT_PRIVATE / FUTEX_WAKE_PRIVATE).
+ * - Windows: WaitOnAddress() / WakeByAddress*() (link Synchronization.lib).
+ * - macOS: __ulock_wait() / __ulock_wake().
+ * - Elsewhere: a small table of hashed mutex/condvar buckets.
+ *
+ * Like a futex, a wait may return early; callers re-check their
+ * condition in a loop. ttak_waitword_await() does that loop, spinning for
+ * TTAK_WAITWORD_SPINS polls before the first sleep.
+ *
+ * A ttak_eventcount_t lets consumers of a lock-free structure park
+ * without missing a wakeup:
+ *
+ *     for (;;) {
+ *         if (try_pop(q, &item)) break;
+ *         uint32_t key = ttak_eventcount_prepare(&ec);
+ *         if (try_pop(q, &item)) { ttak_eventcount_cancel(&ec); break; }
+ *         ttak_eventcount_wait(&ec, key);
+ *     }
+ *
+ * and producers call ttak_eventcount_notify() after each push. Notify is
+ * a fence and a load when no consumer is parked.
+ *
+ * The *_shared variants work on words in memory mapped by several
+ * processes. Linux uses a non-private futex and macOS a shared ulock;
+ * elsewhere a shared wait naps for at most a millisecond at a time and a
+ * shared wake does nothing.
+ */
+
+#ifndef TTAK_SYNC_WAITWORD_H
+#define TTAK_SYNC_WAITWORD_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Timeout meaning "no timeout". */
+#define TTAK_WAIT_FOREVER UINT64_MAX
+
+/** Polls ttak_waitword_await() makes before sleeping. */
+#define TTAK_WAITWORD_SPINS 128
+
+/**
+ * @brief Sleeps while *@p word == @p expected, for at most @p timeout_ns.
+ *
+ * @return 0 on a wake, a changed value or a spurious return; ETIMEDOUT
+ *         when the timeout expired.
+ */
+int ttak_waitword_wait(_Atomic uint32_t *word, uint32_t expected, uint64_t timeout_ns);
+
+/**
+ * @brief Wakes one thread sleeping on @p word.
+ */
+void ttak_waitword_wake_one(_Atomic uint32_t *word);
+
+/**
+ * @brief Wakes every thread sleeping on @p word.
+ */
+void ttak_waitword_wake_all(_Atomic uint32_t *word);
+
+/**
+ * @brief ttak_waitword_wait() on a word shared between processes.
+ */
+int ttak_waitword_wait_shared(_Atomic uint32_t *word, uint32_t expected, uint64_t timeout_ns);
+
+/**
+ * @brief Wakes one, or with @p all every, waiter of any process sleeping on @p word.
+ */
+void ttak_waitword_wake_shared(_Atomic uint32_t *word, bool all);
+
+/**
+ * @brief Spins, then sleeps, until *@p word != @p expected.
+ *
+ * @return 0 once the value changed, ETIMEDOUT if @p timeout_ns passed first.
+ */
+int ttak_waitword_await(_Atomic uint32_t *word, uint32_t expected, uint64_t timeout_ns);
+
+/**
+ * @brief Eventcount: a wake sequence plus a count of parked waiters.
+ */
+typedef struct ttak_eventcount {
+    _Atomic uint32_t seq;      /**< Bumped by every notify that finds a waiter. */
+    _Atomic uint32_t waiters;  /**< Threads between prepare and wait/cancel. */
+} ttak_eventcount_t;
+
+#define TTAK_EVENTCOUNT_INITIALIZER { 0, 0 }
+
+static inline void ttak_eventcount_init(ttak_eventcount_t *ec) {
+    atomic_init(&ec->seq, 0);
+    atomic_init(&ec->waiters, 0);
+}
+
+/**
+ * @brief Announces an intent to wait; re-check the condition afterwards.
+ *
+ * @return Key for ttak_eventcount_wait().
+ */
+static inline uint32_t ttak_eventcount_prepare(ttak_eventcount_t *ec) {
+    atomic_fetch_add_explicit(&ec->waiters, 1, memory_order_seq_cst);
+    return atomic_load_explicit(&ec->seq, memory_order_seq_cst);
+}
+
+/**
+ * @brief Withdraws a prepare() whose re-check succeeded.
+ */
+static inline void ttak_eventcount_cancel(ttak_eventcount_t *ec) {
+    atomic_fetch_sub_explicit(&ec->waiters, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Parks until a notify after the matching prepare().
+ */
+void ttak_eventcount_wait(ttak_eventcount_t *ec, uint32_t key);
+
+/**
+ * @brief ttak_eventcount_wait() that gives up after @p timeout_ns.
+ *
+ * @return 0 after a notify, ETIMEDOUT if the timeout passed first.
+ */
+int ttak_eventcount_wait_for(ttak_eventcount_t *ec, uint32_t key, uint64_t timeout_ns);
+
+/**
+ * @brief ttak_eventcount_wait_for() on an eventcount shared between processes.
+ */
+int ttak_eventcount_wait_shared(ttak_eventcount_t *ec, uint32_t key, uint64_t timeout_ns);
+
+/**
+ * @brief Wakes one parked waiter, if any.
+ */
+void ttak_eventcount_notify(ttak_eventcount_t *ec);
+
+/**
+ * @brief Wakes every parked waiter.
+ */
+void ttak_eventcount_notify_all(ttak_eventcount_t *ec);
+
+/**
+ * @brief Wakes one, or with @p all every, waiter parked in any process.
+ */
+void ttak_eventcount_notify_shared(ttak_eventcount_t *ec, bool all);
+
+#endif // TTAK_SYNC_WAITWORD_H
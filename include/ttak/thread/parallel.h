@@ -0,0 +1,117 @@
+/**
+ * @file parallel.h
+ * @brief Data-parallel loops, reductions, scans and sorts on a thread pool.
+ *
+ * Every call splits its index range into chunks of @c grain indices and
+ * runs them on the calling thread plus up to one helper task per live
+ * worker of @p pool. Chunks are claimed from a shared atomic cursor, so a
+ * helper that finishes early keeps taking work from slower ones, and the
+ * caller drains chunks itself instead of blocking. That also makes the
+ * calls safe from inside a task of the same pool: if no helper ever gets
+ * scheduled the caller simply runs every chunk.
+ *
+ * A @c grain of 0 picks one that gives each participant about
+ * TTAK_PARALLEL_CHUNKS_PER_THREAD chunks. A NULL pool, a pool without live
+ * workers, or a range that fits in one chunk runs inline with no
+ * allocation.
+ */
+
+#ifndef TTAK_THREAD_PARALLEL_H
+#define TTAK_THREAD_PARALLEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/thread/pool.h>
+
+/** Chunks per participating thread when the grain is chosen automatically. */
+#define TTAK_PARALLEL_CHUNKS_PER_THREAD 4
+
+/** Elements below which the radix sorts stay on the calling thread. */
+#define TTAK_PARALLEL_SORT_MIN_BLOCK 16384
+
+/** Most blocks a radix sort pass is split into. */
+#define TTAK_PARALLEL_SORT_MAX_BLOCKS 64
+
+/**
+ * @brief Loop body: processes indices [@p begin, @p end).
+ */
+typedef void (*ttak_parallel_body_t)(void *ctx, size_t begin, size_t end);
+
+/**
+ * @brief Reduction body: folds indices [@p begin, @p end) into @p acc.
+ *
+ * @p acc starts as a copy of the identity passed to ttak_parallel_reduce().
+ */
+typedef void (*ttak_parallel_reduce_body_t)(void *ctx, size_t begin, size_t end, void *acc);
+
+/**
+ * @brief Associative operator: *@p out = *@p lhs (+) *@p rhs.
+ *
+ * @p out may alias @p lhs or @p rhs. The operator need not commute;
+ * operands are always combined in index order.
+ */
+typedef void (*ttak_parallel_op_t)(void *ctx, void *out, const void *lhs, const void *rhs);
+
+/**
+ * @brief Key/value pair sorted by ttak_parallel_sort_kv().
+ */
+typedef struct ttak_parallel_kv {
+    uint64_t key;
+    uint64_t value;
+} ttak_parallel_kv_t;
+
+/**
+ * @brief Calls @p body over [@p begin, @p end) in chunks of @p grain.
+ *
+ * Returns once every chunk has run.
+ */
+void ttak_parallel_for(ttak_thread_pool_t *pool, size_t begin, size_t end, size_t grain,
+                       ttak_parallel_body_t body, void *ctx, uint64_t now);
+
+/**
+ * @brief Reduces [@p begin, @p end) into @p result.
+ *
+ * Each chunk folds into its own accumulator of @p size bytes, initialised
+ * from @p identity; the accumulators are then combined with @p op in chunk
+ * order, so the result is deterministic for a given grain.
+ *
+ * @return False on invalid arguments.
+ */
+_Bool ttak_parallel_reduce(ttak_thread_pool_t *pool, size_t begin, size_t end, size_t grain,
+                           void *result, size_t size, const void *identity,
+                           ttak_parallel_reduce_body_t body, ttak_parallel_op_t op, void *ctx, uint64_t now);
+
+/**
+ * @brief In-place inclusive scan of @p count elements of @p size bytes.
+ *
+ * Element i becomes data[0] (+) ... (+) data[i]. Runs as two parallel
+ * passes over the chunks (local scan, then carry-in) around a serial
+ * scan of the chunk totals.
+ *
+ * @return False on invalid arguments.
+ */
+_Bool ttak_parallel_scan(ttak_thread_pool_t *pool, void *data, size_t count, size_t size, size_t grain,
+                         ttak_parallel_op_t op, void *ctx, uint64_t now);
+
+/**
+ * @brief Sorts @p count keys ascending with a parallel LSD radix sort.
+ *
+ * Eight 8-bit passes; a pass whose digit is the same for every key is
+ * skipped. Needs a scratch buffer of @p count keys.
+ *
+ * @return False on invalid arguments or when the scratch buffer cannot be
+ *         allocated; @p keys is then left unchanged.
+ */
+_Bool ttak_parallel_sort_u64(ttak_thread_pool_t *pool, uint64_t *keys, size_t count, uint64_t now);
+
+/**
+ * @brief Stable sort of @p count pairs by key, as ttak_parallel_sort_u64().
+ *
+ * Pairs with equal keys keep their relative order.
+ *
+ * @return False on invalid arguments or when the scratch buffer cannot be
+ *         allocated; @p pairs is then left unchanged.
+ */
+_Bool ttak_parallel_sort_kv(ttak_thread_pool_t *pool, ttak_parallel_kv_t *pairs, size_t count, uint64_t now);
+
+#endif // TTAK_THREAD_PARALLEL_H
@@ -6,8 +6,19 @@
  * queue.  Tasks are routed to shards via a deterministic hash-to-coordinate
  * mapping backed by a Latin-square routing table, reducing lock contention
  * by confining queue operations to a single shard lock rather than a global
- * pool lock.  Threads are created lazily and respect the nice value set at
+ * pool lock.  The shard count grows with the worker count (two workers per
+ * shard, at least TTAK_THREAD_POOL_SHARDS), and the routing table is
+ * generated for that order when the pool is created.  Threads are created lazily and respect the nice value set at
  * init time.
+ *
+ * Shards are the initial placement only. Each worker also owns a Chase-Lev
+ * deque: it pulls batches from its preferred shard into the deque, tasks a
+ * worker submits to its own shard go straight onto it, and idle workers
+ * steal from randomly chosen deques before falling back to other shards.
+ *
+ * Idle workers spin with exponential pause backoff, then yield, and only
+ * then park (see ttak_thread_pool_idle_config_t). Submitters skip the
+ * condition variable entirely while any idle worker is still spinning.
  */
 
 #ifndef TTAK_THREAD_POOL_H
@@ -19,42 +30,162 @@
 #include <ttak/async/task.h>
 #include <ttak/thread/worker.h>
 #include <ttak/priority/queue.h>
+#include <ttak/priority/heap.h>
 
-/** Number of independent queue shards in the pool. Must equal TTAK_POOL_SHARD_COUNT. */
+/** Minimum number of queue shards in a pool. Must equal TTAK_POOL_SHARD_COUNT. */
 #define TTAK_THREAD_POOL_SHARDS 8
 
+/** Largest shard count a pool generates. Must equal TTAK_POOL_SHARD_MAX. */
+#define TTAK_THREAD_POOL_MAX_SHARDS 256
+
+/** Tasks a worker moves from its preferred shard into its deque per refill. */
+#define TTAK_THREAD_POOL_BATCH 8
+
+/** Default idle rounds spent on pause-instruction backoff before yielding. */
+#define TTAK_THREAD_POOL_SPIN_ROUNDS 10
+
+/** Default cap on pause instructions per spin round (backoff doubles up to it). */
+#define TTAK_THREAD_POOL_MAX_PAUSES 1024
+
+/** Default idle rounds spent in sched_yield() before parking. */
+#define TTAK_THREAD_POOL_YIELD_ROUNDS 16
+
+/** Default longest a parked worker sleeps before rescanning for work. */
+#define TTAK_THREAD_POOL_PARK_NS 10000000ULL
+
+/** Default interval at which an elastic pool re-evaluates its size. */
+#define TTAK_THREAD_POOL_ELASTIC_TICK_NS 2000000ULL
+
+/** Default estimated queue wait (Little's law) above which an elastic pool grows. */
+#define TTAK_THREAD_POOL_GROW_WAIT_US 2000U
+
+/** Default time an elastic pool must sit idle before retiring an extra worker. */
+#define TTAK_THREAD_POOL_SHRINK_IDLE_NS 500000000ULL
+
+/**
+ * CPU PSI "some" 10 s average (percent) above which an elastic pool stops
+ * growing for slowness: more threads cannot help a cgroup already starved
+ * of CPU. Read from the system sampler (ttak_sys_sampler_start()) when it runs.
+ */
+#define TTAK_THREAD_POOL_PSI_CPU_MAX 40.0
+
+/**
+ * @brief How an idle worker waits for work.
+ *
+ * An idle worker first spins for @c spin_rounds rounds, executing 1, 2, 4,
+ * ... up to @c max_pauses pause instructions per round, then yields the
+ * CPU for @c yield_rounds rounds, and finally parks on the pool condition
+ * variable for at most @c park_ns. Every round rescans all work sources.
+ * Zero rounds skip a phase; a zero @c park_ns keeps the default.
+ */
+typedef struct ttak_thread_pool_idle_config {
+    uint32_t spin_rounds;
+    uint32_t max_pauses;
+    uint32_t yield_rounds;
+    uint64_t park_ns;
+} ttak_thread_pool_idle_config_t;
+
+/**
+ * @brief Placement options for ttak_thread_pool_create_ex().
+ *
+ * With @c cpus set, worker i is pinned to cpus[i % cpu_count]. With
+ * @c numa_aware set, shards are split into one contiguous group per NUMA
+ * node in use, each worker prefers a shard of its own node's group, and
+ * idle workers steal from same-node deques and shards before remote ones.
+ * A NUMA-aware pool without @c cpus pins workers round-robin over the CPUs
+ * the process may run on, so that every worker has a node. Pinning and
+ * node discovery are Linux-only; elsewhere the options are accepted and
+ * workers run unpinned.
+ */
+typedef struct ttak_thread_pool_options {
+    int         default_nice;   /**< Initial nice value for workers. */
+    const int   *cpus;          /**< CPUs to pin workers to, or NULL. */
+    size_t      cpu_count;      /**< Entries in @c cpus. */
+    _Bool       numa_aware;     /**< Group shards and stealing by NUMA node. */
+    /**
+     * Elastic ceiling. Above the requested worker count, a sizing thread
+     * adds workers while queued work waits longer than @c grow_wait_us or
+     * when every worker is stuck on tasks that stopped completing, and
+     * retires the extras after @c shrink_idle_ns without queued work.
+     * 0 (or at most the worker count) keeps the pool fixed.
+     */
+    size_t      max_threads;
+    uint32_t    grow_wait_us;   /**< 0 selects TTAK_THREAD_POOL_GROW_WAIT_US. */
+    uint64_t    shrink_idle_ns; /**< 0 selects TTAK_THREAD_POOL_SHRINK_IDLE_NS. */
+} ttak_thread_pool_options_t;
+
 typedef struct ttak_thread_pool ttak_thread_pool_t;
+struct ttak_metrics_registry;
 
 typedef struct ttak_worker ttak_worker_t;
 
 /**
  * @brief One independent queue shard with its own lock and condition variable.
  *
- * Confining push/pop operations to a single shard reduces the probability
- * that two concurrent enqueue/dequeue calls contend on the same mutex.
+ * The queue itself is lock-free; confining traffic to one shard keeps
+ * concurrent enqueue/dequeue calls off the same ring cache lines. Tasks
+ * with a deadline go to @c edf instead, a min-heap on the deadline that
+ * workers drain before any priority queue.
  */
 typedef struct {
-    __i_tt_proc_pq_t  queue;  /**< Shard-local priority queue.          */
-    pthread_mutex_t   lock;   /**< Mutex protecting this shard's queue.  */
-    pthread_cond_t    cond;   /**< Condition variable for this shard.    */
+    __i_tt_proc_pq_t  queue;    /**< Shard-local lock-free priority queue. */
+    pthread_mutex_t   lock;     /**< Guards @c edf; pairs with @c cond for blocking waits. */
+    pthread_cond_t    cond;     /**< Condition variable for this shard.    */
+    ttak_heap_tree_t  edf;      /**< Deadline tasks, earliest first. */
+    _Atomic size_t    edf_size; /**< Mirror of @c edf.size readable without @c lock. */
 } ttak_pool_shard_t;
 
 struct ttak_thread_pool {
+    /** Workers started at creation; an elastic pool never shrinks below it. */
     size_t              num_threads;
+    /** Every worker slot, live or not; an elastic pool has @c worker_slots > @c num_threads. */
     ttak_worker_t       **workers;
+    size_t              worker_slots;
+    /** Worker threads currently started and not yet reaped. */
+    _Atomic size_t      live_workers;
+
+    /** Distinct NUMA nodes among the workers; 1 unless the pool is NUMA-aware. */
+    size_t              numa_groups;
 
     /** Sharded queues — tasks are routed here via the deterministic mapping. */
-    ttak_pool_shard_t   shards[TTAK_THREAD_POOL_SHARDS];
+    ttak_pool_shard_t   *shards;
+    /** Power of two in [TTAK_THREAD_POOL_SHARDS, TTAK_THREAD_POOL_MAX_SHARDS], from num_threads. */
+    size_t              shard_count;
+    uint32_t            shard_log2;
+    /** shard_count × shard_count Latin square generated at creation. */
+    uint8_t             *shard_route;
 
-    /** Coarse-grained lock used only during shutdown signalling. */
+    /** Coarse-grained lock used for parking and shutdown signalling. */
     pthread_mutex_t     pool_lock;
-    /** Condition variable broadcast on shutdown so all workers wake. */
+    /** Parked workers wait here; signalled on submit and broadcast on shutdown. */
     pthread_cond_t      task_cond;
+    /** Workers idle but still spinning or yielding; they find new work unaided. */
+    _Atomic size_t      spinning_workers;
+    /** Workers waiting on @c task_cond. */
+    _Atomic size_t      parked_workers;
+    _Atomic uint32_t    idle_spin_rounds;
+    _Atomic uint32_t    idle_max_pauses;
+    _Atomic uint32_t    idle_yield_rounds;
+    _Atomic uint64_t    idle_park_ns;
+    /** Elastic sizing thread, present when @c worker_slots > @c num_threads. */
+    _Bool               elastic;
+    pthread_t           elastic_thread;
+    pthread_mutex_t     elastic_lock;
+    pthread_cond_t      elastic_cond;
+    _Bool               elastic_stop;
+    uint32_t            grow_wait_us;
+    uint64_t            shrink_idle_ns;
+    /** EWMA of the estimated queue wait in microseconds, per sizing tick. */
+    _Atomic uint32_t    wait_ewma_us;
+    /** Deadline tasks dropped because they were already late when dequeued. */
+    _Atomic uint64_t    shed_count;
     uint64_t            creation_ts;
     _Bool               is_shutdown;
     _Atomic uint32_t    burst_hot_row_q10[4];
     _Atomic uint32_t    burst_hot_col_q10[4];
     _Atomic uint32_t    burst_mag_q10[4];
+    /** Registry the pool exports to, if any; see ttak_thread_pool_export_metrics(). */
+    struct ttak_metrics_registry *metrics;
 
     /**
      * @brief Kills all sub-threads.
@@ -62,11 +193,168 @@ struct ttak_thread_pool {
     void (*force_shutdown)(ttak_thread_pool_t *pool);
 };
 
+/**
+ * @brief One call in a batch submission.
+ */
+typedef struct ttak_pool_batch_item {
+    void *(*func)(void *); /**< Function to run. */
+    void *arg;             /**< Argument passed to @c func. */
+} ttak_pool_batch_item_t;
+
+/**
+ * @brief Aggregate completion handle for ttak_thread_pool_submit_batch().
+ *
+ * Opaque; released with ttak_pool_batch_destroy().
+ */
+typedef struct ttak_pool_batch ttak_pool_batch_t;
+
 ttak_thread_pool_t *ttak_thread_pool_create(size_t num_threads, int default_nice, uint64_t now);
 void ttak_thread_pool_destroy(ttak_thread_pool_t *pool);
+
+/**
+ * @brief Fills @p options with the defaults: nice 0, unpinned, not NUMA-aware.
+ */
+void ttak_thread_pool_options_init(ttak_thread_pool_options_t *options);
+
+/**
+ * @brief Creates a pool with explicit placement options.
+ *
+ * @param num_threads Number of worker threads.
+ * @param options     Placement options, or NULL for the defaults.
+ * @param now         Timestamp for memory tracking.
+ * @return The pool, or NULL on failure or if @p options names an invalid CPU.
+ */
+ttak_thread_pool_t *ttak_thread_pool_create_ex(size_t num_threads, const ttak_thread_pool_options_t *options, uint64_t now);
+
+/**
+ * @brief Fills @p config with the TTAK_THREAD_POOL_* idle defaults.
+ */
+void ttak_thread_pool_idle_config_init(ttak_thread_pool_idle_config_t *config);
+
+/**
+ * @brief Changes how the pool's idle workers wait; NULL restores the defaults.
+ *
+ * Takes effect from each worker's next idle round.
+ */
+void ttak_thread_pool_set_idle_config(ttak_thread_pool_t *pool, const ttak_thread_pool_idle_config_t *config);
+
+/**
+ * @brief Reads back the pool's current idle settings.
+ */
+void ttak_thread_pool_get_idle_config(const ttak_thread_pool_t *pool, ttak_thread_pool_idle_config_t *config);
 ttak_future_t *ttak_thread_pool_submit_task(ttak_thread_pool_t *pool, void *(*func)(void *), void *arg, int priority, uint64_t now);
 _Bool ttak_thread_pool_schedule_task(ttak_thread_pool_t *pool, ttak_task_t *task, int priority, uint64_t now);
 
+/**
+ * @brief Submits @p func in the pool's earliest-deadline-first class.
+ *
+ * @p deadline_ts is absolute, in ttak_get_tick_count() milliseconds (e.g.
+ * ttak_deadline_t::deadline_ts). Deadline tasks run before any priority
+ * queue; one still waiting once its deadline has passed is shed, counted
+ * in ttak_thread_pool_shed_count(), and its future resolves to NULL.
+ *
+ * @return Future for the result, or NULL if @p deadline_ts is 0 or the
+ *         task could not be queued.
+ */
+ttak_future_t *ttak_thread_pool_submit_deadline(ttak_thread_pool_t *pool, void *(*func)(void *), void *arg,
+                                                uint64_t deadline_ts, uint64_t now);
+
+/**
+ * @brief Number of worker threads currently running.
+ */
+size_t ttak_thread_pool_live_workers(const ttak_thread_pool_t *pool);
+
+/**
+ * @brief Number of deadline tasks the pool has shed so far.
+ */
+uint64_t ttak_thread_pool_shed_count(const ttak_thread_pool_t *pool);
+
+/**
+ * @brief Exports the pool's worker, queue and burst state to @p reg.
+ *
+ * Every series is read at scrape time and carries @p labels (for example
+ * `pool="io"`, or NULL). A pool exports to one registry at a time, and
+ * ttak_thread_pool_destroy() removes its series.
+ *
+ * @return Number of series registered; 0 if the pool already exports.
+ */
+size_t ttak_thread_pool_export_metrics(ttak_thread_pool_t *pool, struct ttak_metrics_registry *reg,
+                                       const char *labels);
+
+/**
+ * @brief Fire-and-forget submit: no promise or future is allocated.
+ *
+ * The result of @p func is discarded. Priority is adjusted by the scheduler
+ * exactly as in ttak_thread_pool_submit_task().
+ *
+ * @return True once the task is queued.
+ */
+_Bool ttak_thread_pool_submit_detached(ttak_thread_pool_t *pool, void *(*func)(void *), void *arg, int priority, uint64_t now);
+
+/**
+ * @brief Submits a task that marks @p wg done when it returns.
+ *
+ * Adds one to @p wg itself, so a fork/join caller only submits and then
+ * calls ttak_wait_group_wait(). On failure the count is left unchanged.
+ *
+ * @return True once the task is queued.
+ */
+_Bool ttak_thread_pool_submit_wg(ttak_thread_pool_t *pool, ttak_wait_group_t *wg, void *(*func)(void *), void *arg,
+                                 int priority, uint64_t now);
+
+/**
+ * @brief Submits @p count calls and returns one handle for all of them.
+ *
+ * No promise or future is created per call: every task reports into the
+ * shared handle. Tasks are routed exactly as ttak_thread_pool_schedule_task()
+ * would route them, and at most min(@p count, parked) parked workers are
+ * woken once the whole batch is queued. @p priority is used as given; the per-task history
+ * adjustment of ttak_thread_pool_submit_task() is skipped.
+ *
+ * If the pool refuses a task part-way (shutdown, or a full priority band),
+ * the calls before it stay queued and the rest are not submitted; see
+ * ttak_pool_batch_submitted().
+ *
+ * @param pool     Pool receiving the work.
+ * @param items    Array of @p count calls; copied, so it may be reused at once.
+ * @param count    Number of calls.
+ * @param priority Priority for every call.
+ * @param now      Timestamp for memory bookkeeping.
+ * @return Batch handle, or NULL if nothing could be submitted.
+ */
+ttak_pool_batch_t *ttak_thread_pool_submit_batch(ttak_thread_pool_t *pool, const ttak_pool_batch_item_t *items,
+                                                 size_t count, int priority, uint64_t now);
+
+/**
+ * @brief Number of calls from the batch that were actually queued.
+ */
+size_t ttak_pool_batch_submitted(const ttak_pool_batch_t *batch);
+
+/**
+ * @brief Returns true once every submitted call has finished.
+ */
+_Bool ttak_pool_batch_done(ttak_pool_batch_t *batch);
+
+/**
+ * @brief Blocks until every submitted call has finished.
+ *
+ * @return Number of calls that ran (ttak_pool_batch_submitted()).
+ */
+size_t ttak_pool_batch_wait(ttak_pool_batch_t *batch);
+
+/**
+ * @brief Returns what call @p index returned, or NULL if it has not run.
+ *
+ * Only meaningful after ttak_pool_batch_wait() or a true ttak_pool_batch_done().
+ */
+void *ttak_pool_batch_result(const ttak_pool_batch_t *batch, size_t index);
+
+/**
+ * @brief Waits for the batch, then frees the handle.
+ */
+void ttak_pool_batch_destroy(ttak_pool_batch_t *batch);
+
+/** Global async pool; NULL until ttak_async_pool() first builds it. */
 extern ttak_thread_pool_t *async_pool;
 
 #endif // TTAK_THREAD_POOL_H
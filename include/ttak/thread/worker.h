@@ -13,12 +13,20 @@
 #include <pthread.h>
 #include <setjmp.h>
 #include <stdint.h>
+#include <stdatomic.h>
 #include <ttak/async/promise.h>
+#include <ttak/mem/detachable.h>
+#include <ttak/thread/ws_deque.h>
 
 #define TTAK_ERR_JOIN_FAILED     -101
 #define TTAK_ERR_SHUTDOWN_RETRY  -102
 #define TTAK_ERR_FATAL_EXIT      -103
 
+/** Worker slot states; see ttak_worker_t::state. */
+#define TTAK_WORKER_SLOT_FREE    0
+#define TTAK_WORKER_SLOT_RUNNING 1
+#define TTAK_WORKER_SLOT_EXITED  2
+
 typedef struct ttak_worker_wrapper {
 #ifdef _WIN32
     jmp_buf         env;
@@ -41,6 +49,16 @@ typedef struct ttak_worker {
     _Bool                   should_stop;
     int                     exit_code;
     size_t                  preferred_shard; /**< Shard index this worker drains first. */
+    ttak_detachable_context_t detachable;    /**< Confined to this worker's thread. */
+    ttak_ws_deque_t         deque;           /**< Tasks this worker owns; idle workers steal from the top. */
+    uint64_t                steal_seed;      /**< xorshift state picking steal victims. */
+    int                     cpu;             /**< CPU the worker is pinned to, or -1. */
+    int                     numa_node;       /**< NUMA node of @c cpu, or -1 if unknown. */
+    size_t                  shard_lo;        /**< First shard of this worker's node group. */
+    size_t                  shard_hi;        /**< One past the last shard of the group. */
+    _Atomic int             state;           /**< TTAK_WORKER_SLOT_*; EXITED until the thread is joined. */
+    _Atomic _Bool           retire;          /**< Elastic shrink: exit at the next idle moment. */
+    _Atomic uint64_t        tasks_done;      /**< Tasks run; written only by this worker. */
 } ttak_worker_t;
 
 void *ttak_worker_routine(void *arg);
@@ -51,4 +69,30 @@ void *ttak_worker_routine(void *arg);
  */
 void ttak_worker_abort(void);
 
+/**
+ * @brief Returns the pool worker running on the calling thread, or NULL.
+ */
+ttak_worker_t *ttak_worker_current(void);
+
+/**
+ * @brief Returns the NUMA node the calling pool worker is pinned to.
+ *
+ * Pairs with TTAK_MEM_NUMA_NODE() so task payloads can be placed on the
+ * node that will run them.
+ *
+ * @return Node index, or -1 when not a pinned pool worker or unknown.
+ */
+int ttak_worker_numa_node(void);
+
+/**
+ * @brief Returns the calling worker's thread-confined detachable context.
+ *
+ * Tasks can allocate scratch and receive buffers here without any locking.
+ * The context lives as long as the worker, and buffers taken from it must be
+ * freed by the same worker.
+ *
+ * @return The context, or NULL when not called from a pool worker.
+ */
+ttak_detachable_context_t *ttak_worker_detachable_context(void);
+
 #endif // TTAK_THREAD_WORKER_H
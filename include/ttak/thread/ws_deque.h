@@ -0,0 +1,77 @@
+/**
+ * @file ws_deque.h
+ * @brief Chase-Lev work-stealing deque.
+ *
+ * One owner thread pushes and pops at the bottom without locks; any number
+ * of thieves take from the top with a single CAS. The owner therefore runs
+ * its most recent work first while thieves take the oldest. The ring grows
+ * on demand; retired rings stay allocated until the deque is destroyed
+ * because a thief may still be reading one.
+ */
+
+#ifndef TTAK_THREAD_WS_DEQUE_H
+#define TTAK_THREAD_WS_DEQUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+/** @brief Default initial ring capacity. */
+#define TTAK_WS_DEQUE_DEFAULT_CAPACITY 64
+
+typedef struct ttak_ws_deque_ring ttak_ws_deque_ring_t;
+
+/**
+ * @brief Work-stealing deque of opaque pointers.
+ *
+ * @c top and @c bottom sit on separate cache lines so thieves and the
+ * owner do not falsely share.
+ */
+typedef struct ttak_ws_deque {
+    _Alignas(64) _Atomic int64_t top;       /**< Next index thieves take. */
+    _Alignas(64) _Atomic int64_t bottom;    /**< Next index the owner fills. */
+    ttak_ws_deque_ring_t *_Atomic ring;     /**< Current ring. */
+} ttak_ws_deque_t;
+
+/**
+ * @brief Initialises an empty deque.
+ *
+ * @param dq Deque to initialise.
+ * @param capacity Initial slot count, rounded up to a power of two; 0 selects the default.
+ * @return False if the ring could not be allocated.
+ */
+bool ttak_ws_deque_init(ttak_ws_deque_t *dq, size_t capacity);
+
+/**
+ * @brief Frees every ring. No thread may use the deque afterwards.
+ */
+void ttak_ws_deque_destroy(ttak_ws_deque_t *dq);
+
+/**
+ * @brief Pushes @p item at the bottom (owner only).
+ *
+ * @return False if the ring was full and could not grow.
+ */
+bool ttak_ws_deque_push(ttak_ws_deque_t *dq, void *item);
+
+/**
+ * @brief Pops the most recently pushed item (owner only).
+ *
+ * @return The item, or NULL if the deque is empty or a thief took the last one.
+ */
+void *ttak_ws_deque_pop(ttak_ws_deque_t *dq);
+
+/**
+ * @brief Takes the oldest item (any thread).
+ *
+ * @return The item, or NULL if the deque is empty or another thread won the race.
+ */
+void *ttak_ws_deque_steal(ttak_ws_deque_t *dq);
+
+/**
+ * @brief Returns an approximate item count.
+ */
+size_t ttak_ws_deque_size(const ttak_ws_deque_t *dq);
+
+#endif /* TTAK_THREAD_WS_DEQUE_H */
@@ -1,6 +1,7 @@
 #ifndef TTAK_TIMING_H
 #define TTAK_TIMING_H
 
+#include <stdatomic.h>
 #include <stdint.h>
 #include <time.h>
 #include <ttak/types/ttak_compiler.h>
@@ -14,14 +15,49 @@
 #      include <x86intrin.h>
 #    endif
 #  endif
+/** g_tsc_state values. */
+#  define TTAK_TSC_UNCALIBRATED 0
+#  define TTAK_TSC_STABLE       1 /**< Invariant TSC, calibrated and anchored to the OS clock. */
+#  define TTAK_TSC_FALLBACK     2 /**< TSC unusable; time comes from the OS clock. */
+   /**
+    * @brief TSC-to-nanosecond mapping. Each published one is immutable;
+    *        refining the calibration publishes a new one.
+    */
+   typedef struct ttak_tsc_calibration {
+       uint64_t base;    /**< TSC reading at the anchor. */
+       uint64_t base_ns; /**< Clock value at the anchor. */
+       uint64_t scale;   /**< Nanoseconds per TSC tick, 32.32 fixed point. */
+   } ttak_tsc_calibration_t;
    extern uint64_t g_tsc_freq_ghz;
-   extern uint64_t g_tsc_scale;
+   extern uint64_t g_tsc_scale;   /**< Scale of the current calibration. */
+   extern _Atomic int g_tsc_state;
+   /** Current mapping; NULL unless the state is TTAK_TSC_STABLE. */
+   extern const ttak_tsc_calibration_t *_Atomic g_tsc_calibration;
+   /**
+    * @brief Decides once whether the TSC is used: it must advertise
+    *        invariance and calibrate to a sane frequency. The environment
+    *        variable TTAK_CLOCK_SOURCE=os forces the OS clock; =tsc skips the
+    *        invariance check. The clock thread then refines the rate over
+    *        longer windows and falls back to the OS clock for good if the
+    *        TSC drifts away from it.
+    */
    void calibrate_tsc(void);
 #endif
+#ifdef _WIN32
+extern uint64_t ttak_get_tick_count_ns_win32(void);
+#endif
+
+/** Refresh interval of the coarse clock (ttak_get_tick_count_coarse_ns()). */
+#define TTAK_COARSE_TICK_NS 1000000ULL
+
+/** Last value published by the coarse clock ticker; 0 before it starts. */
+extern _Atomic uint64_t g_ttak_coarse_ns;
 
 /**
- * @brief Time unit macros for converting to nanoseconds.
+ * @brief Starts the coarse clock ticker on first use and returns the precise time.
  */
+uint64_t ttak_coarse_clock_start(void);
+
 #define TT_NANO_SECOND(n)   ((uint64_t)(n))
 #define TT_MICRO_SECOND(n)  ((uint64_t)(n) * 1000ULL)
 #define TT_MILLI_SECOND(n)  ((uint64_t)(n) * 1000ULL * 1000ULL)
@@ -29,52 +65,64 @@
 #define TT_MINUTE(n)        ((uint64_t)(n) * 60ULL * 1000ULL * 1000ULL * 1000ULL)
 #define TT_HOUR(n)          ((uint64_t)(n) * 60ULL * 60ULL * 1000ULL * 1000ULL * 1000ULL)
 
-#if defined(__TINYC__)
-#  if defined(__x86_64__) || defined(_M_X64)
-#    define ttak_get_tick_count_ns() ({ \
-        uint64_t __scale = g_tsc_scale; \
-        if (TTAK_UNLIKELY(__scale == 0)) { calibrate_tsc(); __scale = g_tsc_scale; if (__scale == 0) __scale = (1ULL << 32) / 2; } \
-        (ttak_arch_rdtsc() * __scale) >> 32; \
-    })
-
-#    define ttak_get_tick_count() (ttak_get_tick_count_ns() / 1000000ULL)
-#  elif defined(_WIN32)
-extern uint64_t ttak_get_tick_count_ns_win32(void);
-static inline uint64_t ttak_get_tick_count_ns(void) { return ttak_get_tick_count_ns_win32(); }
-static inline uint64_t ttak_get_tick_count(void) { return ttak_get_tick_count_ns() / 1000000ULL; }
-#  else
-static inline uint64_t ttak_get_tick_count_ns(void) {
+/**
+ * @brief The OS monotonic clock in nanoseconds: the TSC clock's anchor and fallback.
+ */
+static inline uint64_t ttak_clock_os_ns(void) {
+#if defined(_WIN32)
+    return ttak_get_tick_count_ns_win32();
+#else
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
     return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#endif
 }
 
-static inline uint64_t ttak_get_tick_count(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ((uint64_t)ts.tv_sec * 1000ULL) + ((uint64_t)ts.tv_nsec / 1000000ULL);
+#if defined(__x86_64__) || defined(_M_X64)
+/**
+ * @brief Converts a TSC reading to OS-clock nanoseconds.
+ *
+ * The 64x32-bit product is split in two halves so it cannot overflow
+ * however long the machine has been up. A reading from a core marginally
+ * behind the calibrating one clamps to the anchor.
+ */
+static inline uint64_t ttak_tsc_to_ns(const ttak_tsc_calibration_t *c, uint64_t tsc) {
+    uint64_t d = tsc > c->base ? tsc - c->base : 0;
+    return c->base_ns + (d >> 32) * c->scale + (((d & 0xFFFFFFFFULL) * c->scale) >> 32);
+}
+
+static inline uint64_t ttak_tick_count_ns_x86(void) {
+    const ttak_tsc_calibration_t *c = atomic_load_explicit(&g_tsc_calibration, memory_order_acquire);
+    if (TTAK_LIKELY(c != NULL)) return ttak_tsc_to_ns(c, ttak_arch_rdtsc());
+    if (atomic_load_explicit(&g_tsc_state, memory_order_acquire) == TTAK_TSC_UNCALIBRATED) {
+        calibrate_tsc();
+        c = atomic_load_explicit(&g_tsc_calibration, memory_order_acquire);
+        if (c) return ttak_tsc_to_ns(c, ttak_arch_rdtsc());
+    }
+    return ttak_clock_os_ns();
 }
+#endif
+
+#if defined(__TINYC__)
+#  if defined(__x86_64__) || defined(_M_X64)
+#    define ttak_get_tick_count_ns() ttak_tick_count_ns_x86()
+#    define ttak_get_tick_count() (ttak_get_tick_count_ns() / 1000000ULL)
+#  else
+static inline uint64_t ttak_get_tick_count_ns(void) { return ttak_clock_os_ns(); }
+static inline uint64_t ttak_get_tick_count(void) { return ttak_clock_os_ns() / 1000000ULL; }
 #  endif
 #else
 /**
  * @brief Returns the current tick count in nanoseconds.
+ *
+ * Same epoch as CLOCK_MONOTONIC (QPC on Windows) whichever source backs
+ * it, so it can feed absolute condition-variable deadlines directly.
  */
 TTAK_FORCE_INLINE uint64_t ttak_get_tick_count_ns(void) {
 #if defined(__x86_64__) || defined(_M_X64)
-    uint64_t scale = g_tsc_scale;
-    if (TTAK_UNLIKELY(scale == 0)) {
-        calibrate_tsc();
-        scale = g_tsc_scale;
-        if (scale == 0) scale = (1ULL << 32) / 2; 
-    }
-    return (ttak_arch_rdtsc() * scale) >> 32;
-#elif defined(_WIN32)
-    extern uint64_t ttak_get_tick_count_ns_win32(void);
-    return ttak_get_tick_count_ns_win32();
+    return ttak_tick_count_ns_x86();
 #else
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+    return ttak_clock_os_ns();
 #endif
 }
 
@@ -82,16 +130,29 @@ TTAK_FORCE_INLINE uint64_t ttak_get_tick_count_ns(void) {
  * @brief Returns the current tick count in milliseconds.
  */
 TTAK_FORCE_INLINE uint64_t ttak_get_tick_count(void) {
-#if defined(__x86_64__) || defined(_M_X64)
-    return ttak_get_tick_count_ns() / 1000000ULL;
-#elif defined(_WIN32)
     return ttak_get_tick_count_ns() / 1000000ULL;
-#else
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ((uint64_t)ts.tv_sec * 1000ULL) + ((uint64_t)ts.tv_nsec / 1000000ULL);
-#endif
 }
 #endif
 
+/**
+ * @brief Nanoseconds as of the last coarse tick: one relaxed load.
+ *
+ * A ticker thread, started on first use, republishes the time every
+ * TTAK_COARSE_TICK_NS, so the value lags by up to about that much. Meant
+ * for hot paths that stamp timestamps they only compare at millisecond
+ * grain, such as the @c now arguments most APIs take. Falls back to the
+ * precise clock if the ticker cannot start.
+ */
+static inline uint64_t ttak_get_tick_count_coarse_ns(void) {
+    uint64_t ns = atomic_load_explicit(&g_ttak_coarse_ns, memory_order_relaxed);
+    return TTAK_LIKELY(ns != 0) ? ns : ttak_coarse_clock_start();
+}
+
+/**
+ * @brief Milliseconds as of the last coarse tick.
+ */
+static inline uint64_t ttak_get_tick_count_coarse(void) {
+    return ttak_get_tick_count_coarse_ns() / 1000000ULL;
+}
+
 #endif // TTAK_TIMING_H
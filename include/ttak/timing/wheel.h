@@ -0,0 +1,148 @@
+/**
+ * @file wheel.h
+ * @brief Hierarchical timing wheel for timeouts and TTLs.
+ *
+ * Timers are intrusive nodes owned by the caller, so arming one never
+ * allocates. The wheel has TTAK_TIMER_WHEEL_LEVELS levels of 64 slots;
+ * level k holds timers due within 64^(k+1) ticks and is cascaded into the
+ * level below as time reaches each of its slots. Arm and cancel are O(1)
+ * list operations; advancing skips straight past empty slots using each
+ * level's occupancy bitmap, so pending timers cost nothing until they
+ * are due. Timers further out than the wheel spans wait in the top level
+ * and are re-placed each time they cascade.
+ *
+ * The wheel is driven either by its own thread (ttak_timer_wheel_start())
+ * or by whoever calls ttak_timer_wheel_advance(), e.g. a pool task or an
+ * event loop. ttak_timer_wheel_shared() is a process-wide wheel on its own
+ * thread for callers that do not want to run one.
+ *
+ * All times are ttak_get_tick_count_ns() nanoseconds.
+ */
+
+#ifndef TTAK_TIMING_WHEEL_H
+#define TTAK_TIMING_WHEEL_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+/** Levels of the wheel; 64^levels ticks are placed exactly. */
+#define TTAK_TIMER_WHEEL_LEVELS 5
+
+/** Slots per level. */
+#define TTAK_TIMER_WHEEL_SLOTS 64
+
+/** Default tick: timers fire up to one tick late, never early. */
+#define TTAK_TIMER_WHEEL_TICK_NS 1000000ULL
+
+struct ttak_thread_pool;
+
+/**
+ * @brief Timer callback; same shape as a pool task so it can run as one.
+ */
+typedef void *(*ttak_timer_fn)(void *arg);
+
+/**
+ * @brief Timer node. Initialise with ttak_timer_init(); fields are private.
+ */
+typedef struct ttak_timer {
+    struct ttak_timer   *next;
+    struct ttak_timer   **pprev;   /**< NULL while not pending. */
+    uint64_t            expires;   /**< Due tick. */
+    uint16_t            where;     /**< Slot index, or the expired list. */
+    ttak_timer_fn       fn;
+    void                *arg;
+} ttak_timer_t;
+
+/**
+ * @brief Timing wheel. Every field is guarded by @c lock.
+ */
+typedef struct ttak_timer_wheel {
+    pthread_mutex_t         lock;
+    pthread_cond_t          cond;       /**< Wakes the driver for an earlier timer or stop. */
+    uint64_t                tick_ns;
+    uint64_t                origin_ns;  /**< Time of tick 0. */
+    uint64_t                current;    /**< Last tick processed. */
+    uint64_t                pending;    /**< Timers in slots or the expired list. */
+    uint64_t                occupied[TTAK_TIMER_WHEEL_LEVELS];
+    ttak_timer_t            *slots[TTAK_TIMER_WHEEL_LEVELS][TTAK_TIMER_WHEEL_SLOTS];
+    ttak_timer_t            *expired;   /**< Due timers not yet called. */
+    struct ttak_thread_pool *pool;      /**< Runs callbacks when set; else the advancing thread does. */
+    pthread_t               thread;
+    _Bool                   running;
+    _Bool                   stop;
+    uint64_t                wake_tick;  /**< Tick the driver sleeps until; UINT64_MAX if none. */
+} ttak_timer_wheel_t;
+
+/**
+ * @brief Initialises @p timer to call @p fn(@p arg) when it fires.
+ */
+void ttak_timer_init(ttak_timer_t *timer, ttak_timer_fn fn, void *arg);
+
+/**
+ * @brief Initialises an empty wheel whose tick 0 is @p now_ns.
+ *
+ * @param tick_ns Resolution; 0 selects TTAK_TIMER_WHEEL_TICK_NS.
+ */
+void ttak_timer_wheel_init(ttak_timer_wheel_t *wheel, uint64_t tick_ns, uint64_t now_ns);
+
+/**
+ * @brief Stops the driver thread, if any, and destroys the wheel.
+ *
+ * Timers still pending are dropped without firing.
+ */
+void ttak_timer_wheel_destroy(ttak_timer_wheel_t *wheel);
+
+/**
+ * @brief Arms @p timer to fire at @p expires_ns, moving it if already pending.
+ *
+ * A time already past fires on the next tick.
+ */
+void ttak_timer_arm(ttak_timer_wheel_t *wheel, ttak_timer_t *timer, uint64_t expires_ns);
+
+/**
+ * @brief Disarms @p timer.
+ *
+ * @return True if it was pending; false if it was never armed or has
+ *         already been handed to its callback.
+ */
+_Bool ttak_timer_cancel(ttak_timer_wheel_t *wheel, ttak_timer_t *timer);
+
+/**
+ * @brief Number of timers armed and not yet fired.
+ */
+uint64_t ttak_timer_wheel_pending(ttak_timer_wheel_t *wheel);
+
+/**
+ * @brief Fires every timer due by @p now_ns.
+ *
+ * Callbacks run on the calling thread without the wheel lock held, or as
+ * detached tasks when the wheel was started with a pool; a callback may
+ * re-arm or cancel any timer.
+ *
+ * @return Nanoseconds from @p now_ns until the next timer could be due, or
+ *         UINT64_MAX if none is pending.
+ */
+uint64_t ttak_timer_wheel_advance(ttak_timer_wheel_t *wheel, uint64_t now_ns);
+
+/**
+ * @brief Starts a thread that advances the wheel, sleeping until the next
+ *        timer is due.
+ *
+ * @param pool Pool that runs the callbacks, or NULL to run them on the
+ *             wheel thread, which should then be kept short.
+ * @return False if the thread could not be started or already runs.
+ */
+_Bool ttak_timer_wheel_start(ttak_timer_wheel_t *wheel, struct ttak_thread_pool *pool);
+
+/**
+ * @brief Stops and joins the driver thread; pending timers stay armed.
+ */
+void ttak_timer_wheel_stop(ttak_timer_wheel_t *wheel);
+
+/**
+ * @brief Process-wide wheel with the default tick, driven by its own
+ *        thread from first use. Callbacks run on that thread.
+ */
+ttak_timer_wheel_t *ttak_timer_wheel_shared(void);
+
+#endif // TTAK_TIMING_WHEEL_H
@@ -0,0 +1,130 @@
+/**
+ * @file art.h
+ * @brief Adaptive radix tree of bit prefixes with longest-prefix match.
+ *
+ * Keys are big-endian byte strings of up to TTAK_ART_MAX_KEY bytes, such
+ * as IPv4 or IPv6 addresses, and each route covers a prefix of 0 to
+ * 8 * TTAK_ART_MAX_KEY bits. Each key byte takes one level. Each level
+ * node has 4, 16, 48 or 256 child slots and grows or shrinks between
+ * those sizes as children come and go. Node16 finds a byte with one SIMD
+ * compare. A route whose length is not a whole number of bytes lives in
+ * the node where its last partial byte would branch, so every level
+ * resolves up to eight prefix lengths at once.
+ *
+ * Lookups take no lock; they only pin the epoch. Writers serialise on one
+ * mutex. They publish new children and route sets with release stores,
+ * and they replace nodes whole when these grow, shrink or lose a
+ * child. Replaced nodes and route sets go through ttak_epoch_retire(). A
+ * tree holds one key family: use one tree for IPv4 and another for IPv6.
+ */
+
+#ifndef TTAK_TREE_ART_H
+#define TTAK_TREE_ART_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/sync/sync.h>
+
+/** Longest key in bytes; enough for an IPv6 address. */
+#define TTAK_ART_MAX_KEY 16
+
+typedef struct ttak_art_node ttak_art_node_t;
+
+/**
+ * @brief Route table. Initialise with ttak_art_init().
+ */
+typedef struct ttak_art {
+    ttak_art_node_t *_Atomic root;
+    ttak_mutex_t lock;              /**< Serialises writers. */
+    _Atomic size_t size;            /**< Routes stored. */
+} ttak_art_t;
+
+/**
+ * @brief Initialises an empty table.
+ *
+ * @return False if the root node could not be allocated.
+ */
+bool ttak_art_init(ttak_art_t *art);
+
+/**
+ * @brief Frees every node. No other thread may be using the table.
+ */
+void ttak_art_destroy(ttak_art_t *art);
+
+/**
+ * @brief Adds the route @p prefix / @p prefix_len or replaces its value.
+ *
+ * Bits of @p prefix past @p prefix_len are ignored.
+ * @return False if @p prefix_len exceeds 8 * TTAK_ART_MAX_KEY or allocation failed.
+ */
+bool ttak_art_insert(ttak_art_t *art, const uint8_t *prefix, unsigned prefix_len, uintptr_t value);
+
+/**
+ * @brief Removes the route @p prefix / @p prefix_len, pruning nodes it leaves empty.
+ *
+ * @return True if the route was present.
+ */
+bool ttak_art_remove(ttak_art_t *art, const uint8_t *prefix, unsigned prefix_len);
+
+/**
+ * @brief Looks up the route @p prefix / @p prefix_len exactly.
+ *
+ * @param out Receives the value if found; may be NULL.
+ * @return True if found.
+ */
+bool ttak_art_get(ttak_art_t *art, const uint8_t *prefix, unsigned prefix_len, uintptr_t *out);
+
+/**
+ * @brief Finds the longest route covering @p key, pinning the epoch.
+ *
+ * @param key_len Bytes in @p key, at most TTAK_ART_MAX_KEY.
+ * @param out Receives the route's value; may be NULL.
+ * @param matched_len Receives the route's prefix length; may be NULL.
+ * @return True if any route covers @p key.
+ */
+bool ttak_art_lookup(ttak_art_t *art, const uint8_t *key, size_t key_len, uintptr_t *out, unsigned *matched_len);
+
+/**
+ * @brief ttak_art_lookup() for callers already between ttak_epoch_enter()
+ *        and ttak_epoch_exit(), e.g. to route a whole ingress batch under one pin.
+ */
+bool ttak_art_lookup_pinned(ttak_art_t *art, const uint8_t *key, size_t key_len, uintptr_t *out,
+                            unsigned *matched_len);
+
+/**
+ * @brief Number of routes; exact only while no writer runs.
+ */
+size_t ttak_art_size(ttak_art_t *art);
+
+/** @brief Big-endian bytes of host-order IPv4 address @p addr. */
+static inline void ttak_art_v4_bytes(uint32_t addr, uint8_t out[4]) {
+    out[0] = (uint8_t)(addr >> 24);
+    out[1] = (uint8_t)(addr >> 16);
+    out[2] = (uint8_t)(addr >> 8);
+    out[3] = (uint8_t)addr;
+}
+
+/** @brief ttak_art_insert() for host-order IPv4 prefix @p addr / @p prefix_len. */
+static inline bool ttak_art_insert_v4(ttak_art_t *art, uint32_t addr, unsigned prefix_len, uintptr_t value) {
+    uint8_t b[4];
+    ttak_art_v4_bytes(addr, b);
+    return prefix_len <= 32 && ttak_art_insert(art, b, prefix_len, value);
+}
+
+/** @brief ttak_art_remove() for host-order IPv4 prefix @p addr / @p prefix_len. */
+static inline bool ttak_art_remove_v4(ttak_art_t *art, uint32_t addr, unsigned prefix_len) {
+    uint8_t b[4];
+    ttak_art_v4_bytes(addr, b);
+    return prefix_len <= 32 && ttak_art_remove(art, b, prefix_len);
+}
+
+/** @brief ttak_art_lookup() for host-order IPv4 address @p addr. */
+static inline bool ttak_art_lookup_v4(ttak_art_t *art, uint32_t addr, uintptr_t *out, unsigned *matched_len) {
+    uint8_t b[4];
+    ttak_art_v4_bytes(addr, b);
+    return ttak_art_lookup(art, b, 4, out, matched_len);
+}
+
+#endif // TTAK_TREE_ART_H
@@ -12,6 +12,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <ttak/mem/arena_helper.h>
 
 typedef struct ttak_ast_node {
     int type;
@@ -22,6 +23,7 @@ typedef struct ttak_ast_node {
     size_t cap_children;
     
     struct ttak_ast_node *parent;
+    struct ttak_ast_tree *arena_owner; /* Arena-backed tree that made this node, or NULL */
 } ttak_ast_node_t;
 
 typedef struct ttak_ast_tree {
@@ -29,10 +31,35 @@ typedef struct ttak_ast_tree {
     
     /* Optional hooks for payload management */
     void (*free_value)(void *value);
+
+    /* Optional node arena; see ttak_ast_tree_use_arena() */
+    ttak_arena_env_t *arena_env;
+    ttak_arena_generation_t *arena;
+    uint32_t arena_lane;
 } ttak_ast_tree_t;
 
 void ttak_ast_tree_init(ttak_ast_tree_t *tree, void (*free_value)(void*));
 ttak_ast_node_t *ttak_ast_create_node(int type, void *value, uint64_t now);
+
+/**
+ * @brief Claims nodes made by ttak_ast_tree_create_node() from lane @p lane
+ *        of a laned generation.
+ *
+ * Such nodes and their child arrays cost one bump each and carry no
+ * allocator header. If every node of the tree comes from the arena and no
+ * free_value hook is set, ttak_ast_tree_destroy() does no walk at all, and
+ * retiring the generation releases the whole tree at once. The generation
+ * must outlive the tree, and no other thread may claim from the same lane.
+ *
+ * @return False if the tree has a root or @p generation has no lanes.
+ */
+bool ttak_ast_tree_use_arena(ttak_ast_tree_t *tree, ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                             uint32_t lane);
+
+/**
+ * @brief Creates a node from @p tree's arena, or like ttak_ast_create_node() without one.
+ */
+ttak_ast_node_t *ttak_ast_tree_create_node(ttak_ast_tree_t *tree, int type, void *value, uint64_t now);
 void ttak_ast_add_child(ttak_ast_node_t *parent, ttak_ast_node_t *child, uint64_t now);
 void ttak_ast_tree_destroy(ttak_ast_tree_t *tree, uint64_t now);
 
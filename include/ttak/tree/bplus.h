@@ -12,6 +12,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <ttak/mem/arena_helper.h>
 
 typedef struct ttak_bplus_node {
     bool is_leaf;
@@ -34,11 +35,63 @@ typedef struct ttak_bplus_tree {
     int (*cmp)(const void *k1, const void *k2);
     void (*key_free)(void *key);
     void (*val_free)(void *val);
+
+    ttak_arena_env_t *arena_env;        /**< Node arena context, or NULL for per-node allocations. */
+    ttak_arena_generation_t *arena;     /**< Laned generation nodes are claimed from. */
+    uint32_t arena_lane;                /**< Lane this tree claims from. */
 } ttak_bplus_tree_t;
 
+/**
+ * @brief Callback for ttak_bplus_range(); returning false stops the scan.
+ */
+typedef bool (*ttak_bplus_visit_t)(void *key, void *value, void *ctx);
+
 void ttak_bplus_init(ttak_bplus_tree_t *tree, int order, int (*cmp)(const void*, const void*), void (*kf)(void*), void (*vf)(void*));
+
+/**
+ * @brief Claims the nodes of empty @p tree from lane @p lane of a laned generation.
+ *
+ * Nodes then cost one bump each and carry no allocator header. Nodes freed
+ * by merges stay in the generation, and ttak_bplus_destroy() skips the
+ * node walk unless key or value destructors are set; retiring the
+ * generation afterwards releases every node at once. The generation must
+ * outlive the tree, and no other thread may claim from the same lane.
+ *
+ * @return False if the tree is not empty or @p generation has no lanes.
+ */
+bool ttak_bplus_use_arena(ttak_bplus_tree_t *tree, ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                          uint32_t lane);
 void ttak_bplus_insert(ttak_bplus_tree_t *tree, void *key, void *value, uint64_t now);
 void *ttak_bplus_get(ttak_bplus_tree_t *tree, const void *key, uint64_t now);
+
+/**
+ * @brief Removes @p key, rebalancing by borrow or merge, and frees its pair.
+ *
+ * @return True if the key was present.
+ */
+bool ttak_bplus_remove(ttak_bplus_tree_t *tree, const void *key, uint64_t now);
+
+/**
+ * @brief Builds an empty tree bottom-up from pairs in strictly increasing key order.
+ *
+ * Each node is filled to @p fill of its capacity (clamped to the minimum
+ * fill), giving fewer, fuller nodes than repeated inserts.
+ * @return False if the tree was not empty, keys were out of order, or
+ *         allocation failed; the tree is unchanged.
+ */
+bool ttak_bplus_bulk_load(ttak_bplus_tree_t *tree, void *const *keys, void *const *values, size_t n,
+                          double fill, uint64_t now);
+
+/**
+ * @brief Visits pairs with @p lo <= key <= @p hi in key order.
+ *
+ * Descends once to the leaf holding @p lo, then follows the leaf links.
+ * @param lo Lower bound, or NULL to start at the smallest key.
+ * @param hi Upper bound, or NULL to run to the largest key.
+ * @return Number of pairs visited.
+ */
+size_t ttak_bplus_range(ttak_bplus_tree_t *tree, const void *lo, const void *hi,
+                        ttak_bplus_visit_t visit, void *ctx, uint64_t now);
 void ttak_bplus_destroy(ttak_bplus_tree_t *tree, uint64_t now);
 
 #endif // TTAK_TREE_BPLUS_H
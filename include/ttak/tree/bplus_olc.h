@@ -0,0 +1,111 @@
+/**
+ * @file bplus_olc.h
+ * @brief Concurrent u64-keyed B+ tree using optimistic lock coupling.
+ *
+ * Every node carries a version word: bit 0 marks a node unlinked from the
+ * tree, bit 1 is the node's write lock, and the bits above count writes.
+ * Readers never lock. They note a node's version, read what they need,
+ * and check the version again, restarting the operation from the root if
+ * a writer got in between. Writers traverse the same way and lock only
+ * the nodes they modify: the leaf, plus its parent when a node splits or
+ * an empty leaf is unlinked. Full nodes split on the way down, so a split
+ * never has to climb back up.
+ *
+ * Keys and values are plain words because readers may see a node mid-write
+ * and only later learn to discard what they read; callback-compared keys
+ * would be dereferenced in that window. Unlinked leaves are retired through
+ * ttak_epoch_retire(), and every operation pins the epoch for its
+ * duration, so a node a reader is looking at is never freed under it.
+ *
+ * Deletion does not rebalance: a leaf that empties is unlinked from its
+ * parent when that parent can be locked, and inner nodes never shrink.
+ */
+
+#ifndef TTAK_TREE_BPLUS_OLC_H
+#define TTAK_TREE_BPLUS_OLC_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Keys per node. */
+#define TTAK_BPLUS_OLC_FANOUT 16
+
+typedef struct ttak_bplus_olc_node {
+    _Atomic uint64_t version;   /**< writes << 2 | locked << 1 | obsolete */
+    _Atomic uint32_t n;
+    bool leaf;                  /**< Fixed at creation */
+    _Atomic uint64_t keys[TTAK_BPLUS_OLC_FANOUT];
+    union {
+        struct ttak_bplus_olc_node *_Atomic children[TTAK_BPLUS_OLC_FANOUT + 1];
+        _Atomic uint64_t values[TTAK_BPLUS_OLC_FANOUT];
+    };
+} ttak_bplus_olc_node_t;
+
+typedef struct ttak_bplus_olc {
+    ttak_bplus_olc_node_t *_Atomic root;
+    _Atomic size_t size;
+} ttak_bplus_olc_t;
+
+/**
+ * @brief Callback for ttak_bplus_olc_range(); returning false stops the scan.
+ */
+typedef bool (*ttak_bplus_olc_visit_t)(uint64_t key, uint64_t value, void *ctx);
+
+/**
+ * @brief Initialises an empty tree.
+ *
+ * @return False if the root leaf could not be allocated.
+ */
+bool ttak_bplus_olc_init(ttak_bplus_olc_t *tree);
+
+/**
+ * @brief Frees every node. No other thread may be using the tree.
+ */
+void ttak_bplus_olc_destroy(ttak_bplus_olc_t *tree);
+
+/**
+ * @brief Inserts @p key or replaces its value.
+ *
+ * @return False if a split could not allocate.
+ */
+bool ttak_bplus_olc_insert(ttak_bplus_olc_t *tree, uint64_t key, uint64_t value);
+
+/**
+ * @brief Removes @p key.
+ *
+ * @return True if it was present.
+ */
+bool ttak_bplus_olc_remove(ttak_bplus_olc_t *tree, uint64_t key);
+
+/**
+ * @brief Looks up @p key without taking any lock, pinning the epoch.
+ *
+ * @param out Receives the value if found; may be NULL.
+ * @return True if found.
+ */
+bool ttak_bplus_olc_get(ttak_bplus_olc_t *tree, uint64_t key, uint64_t *out);
+
+/**
+ * @brief ttak_bplus_olc_get() for callers already between ttak_epoch_enter()
+ *        and ttak_epoch_exit().
+ */
+bool ttak_bplus_olc_get_pinned(ttak_bplus_olc_t *tree, uint64_t key, uint64_t *out);
+
+/**
+ * @brief Visits pairs with @p lo <= key <= @p hi in key order.
+ *
+ * Each leaf is copied out consistently and visited outside the tree; the
+ * scan as a whole is not a snapshot of one instant.
+ * @return Number of pairs visited.
+ */
+size_t ttak_bplus_olc_range(ttak_bplus_olc_t *tree, uint64_t lo, uint64_t hi,
+                            ttak_bplus_olc_visit_t visit, void *ctx);
+
+/**
+ * @brief Number of pairs; exact only while no writer runs.
+ */
+size_t ttak_bplus_olc_size(ttak_bplus_olc_t *tree);
+
+#endif // TTAK_TREE_BPLUS_OLC_H
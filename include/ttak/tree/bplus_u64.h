@@ -0,0 +1,77 @@
+/**
+ * @file bplus_u64.h
+ * @brief B+ tree specialised for 64-bit integer keys.
+ *
+ * Unlike @c ttak_bplus_tree_t, keys live inline in each node as one
+ * contiguous, cache-line aligned array, and comparisons are plain integer
+ * compares with no callback. A node search counts the keys below the
+ * target across the whole array at once (AVX2 or NEON where available,
+ * a branch-free loop otherwise), so a lookup costs one short, predictable
+ * scan per level instead of a chain of indirect calls and pointer loads.
+ *
+ * Unused key slots hold UINT64_MAX so full-width scans need no tail
+ * handling. Leaves are linked for range scans.
+ */
+
+#ifndef TTAK_TREE_BPLUS_U64_H
+#define TTAK_TREE_BPLUS_U64_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Keys per node: two cache lines of keys. */
+#define TTAK_BPLUS_U64_FANOUT 16
+
+typedef struct ttak_bplus_u64_node {
+    _Alignas(64) uint64_t keys[TTAK_BPLUS_U64_FANOUT];
+    uint32_t n;
+    bool leaf;
+    union {
+        struct ttak_bplus_u64_node *children[TTAK_BPLUS_U64_FANOUT + 1];
+        struct {
+            uint64_t values[TTAK_BPLUS_U64_FANOUT];
+            struct ttak_bplus_u64_node *next;
+        };
+    };
+} ttak_bplus_u64_node_t;
+
+typedef struct ttak_bplus_u64 {
+    ttak_bplus_u64_node_t *root;
+    size_t size;
+    uint32_t height;    /**< Levels including the leaves; 0 when empty */
+} ttak_bplus_u64_t;
+
+/**
+ * @brief Callback for ttak_bplus_u64_range(); returning false stops the scan.
+ */
+typedef bool (*ttak_bplus_u64_visit_t)(uint64_t key, uint64_t value, void *ctx);
+
+void ttak_bplus_u64_init(ttak_bplus_u64_t *tree);
+
+/**
+ * @brief Inserts @p key or replaces its value.
+ *
+ * @return False if a node could not be allocated.
+ */
+bool ttak_bplus_u64_insert(ttak_bplus_u64_t *tree, uint64_t key, uint64_t value);
+
+/**
+ * @brief Looks up @p key.
+ *
+ * @param out Receives the value if found; may be NULL.
+ * @return True if found.
+ */
+bool ttak_bplus_u64_get(const ttak_bplus_u64_t *tree, uint64_t key, uint64_t *out);
+
+/**
+ * @brief Visits pairs with @p lo <= key <= @p hi in key order.
+ *
+ * @return Number of pairs visited.
+ */
+size_t ttak_bplus_u64_range(const ttak_bplus_u64_t *tree, uint64_t lo, uint64_t hi,
+                            ttak_bplus_u64_visit_t visit, void *ctx);
+
+void ttak_bplus_u64_destroy(ttak_bplus_u64_t *tree);
+
+#endif // TTAK_TREE_BPLUS_U64_H
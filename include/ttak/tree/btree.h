@@ -13,6 +13,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <ttak/mem/arena_helper.h>
 
 typedef struct ttak_btree_node {
     int n;          // Current number of keys
@@ -29,11 +30,46 @@ typedef struct ttak_btree {
     int (*cmp)(const void *k1, const void *k2);
     void (*key_free)(void *key);
     void (*val_free)(void *val);
+
+    ttak_arena_env_t *arena_env;        /**< Node arena context, or NULL for per-node allocations. */
+    ttak_arena_generation_t *arena;     /**< Laned generation nodes are claimed from. */
+    uint32_t arena_lane;                /**< Lane this tree claims from. */
 } ttak_btree_t;
 
 void ttak_btree_init(ttak_btree_t *tree, int t, int (*cmp)(const void*, const void*), void (*key_free)(void*), void (*val_free)(void*));
+
+/**
+ * @brief Claims the nodes of empty @p tree from lane @p lane of a laned generation.
+ *
+ * Nodes then cost one bump each and carry no allocator header. Nodes freed
+ * by removals stay in the generation, and ttak_btree_destroy() skips the
+ * node walk unless key or value destructors are set; retiring the
+ * generation afterwards releases every node at once. The generation must
+ * outlive the tree, and no other thread may claim from the same lane.
+ *
+ * @return False if the tree is not empty or @p generation has no lanes.
+ */
+bool ttak_btree_use_arena(ttak_btree_t *tree, ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                          uint32_t lane);
 void ttak_btree_insert(ttak_btree_t *tree, void *key, void *value, uint64_t now);
 void *ttak_btree_search(ttak_btree_t *tree, const void *key, uint64_t now);
+
+/**
+ * @brief Removes @p key in one top-down pass and frees its pair.
+ *
+ * @return True if the key was present.
+ */
+bool ttak_btree_remove(ttak_btree_t *tree, const void *key, uint64_t now);
+
+/**
+ * @brief Builds an empty tree bottom-up from pairs in strictly increasing key order.
+ *
+ * Nodes are filled to @p fill of 2t - 1 keys (clamped to t - 1).
+ * @return False if the tree was not empty, keys were out of order, or
+ *         allocation failed; the tree is unchanged.
+ */
+bool ttak_btree_bulk_load(ttak_btree_t *tree, void *const *keys, void *const *values, size_t n,
+                          double fill, uint64_t now);
 void ttak_btree_destroy(ttak_btree_t *tree, uint64_t now);
 
 #endif // TTAK_TREE_BTREE_H
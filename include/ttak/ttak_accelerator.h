@@ -13,6 +13,31 @@ extern "C" {
 #  define ATOMIC_VAR_INIT(x) (x)
 #endif
 
+/* Moduli the CPU backend's Pollard rho advances side by side. */
+#ifndef TTAK_ACCEL_CPU_LANES
+#define TTAK_ACCEL_CPU_LANES 8
+#endif
+/* Values the CPU backend hands to each thread pool task. */
+#ifndef TTAK_ACCEL_CPU_CHUNK
+#define TTAK_ACCEL_CPU_CHUNK 32
+#endif
+
+/* GPU backends hand batches with fewer values than this to the CPU backend. */
+#ifndef TTAK_ACCEL_GPU_MIN_VALUES
+#define TTAK_ACCEL_GPU_MIN_VALUES 2048
+#endif
+/* Values per GPU transfer. Batches are cut into pieces of this size, and each
+ * piece's upload and download overlap the kernel of the previous piece. */
+#ifndef TTAK_ACCEL_GPU_PIECE_VALUES
+#define TTAK_ACCEL_GPU_PIECE_VALUES 8192
+#endif
+
+/* Smallest share of a hybrid batch's bytes, in 1/1024ths, either backend
+ * keeps so that both throughput estimates stay fresh. */
+#ifndef TTAK_ACCEL_HYBRID_MIN_SHARE
+#define TTAK_ACCEL_HYBRID_MIN_SHARE 32
+#endif
+
 /**
  * @brief Result codes returned by accelerator backends.
  */
@@ -30,7 +55,9 @@ typedef enum ttak_accel_target {
     TTAK_ACCEL_TARGET_CPU = 0,
     TTAK_ACCEL_TARGET_CUDA,
     TTAK_ACCEL_TARGET_OPENCL,
-    TTAK_ACCEL_TARGET_ROCM
+    TTAK_ACCEL_TARGET_ROCM,
+    /* Split each batch between the GPU backend and the CPU backend. */
+    TTAK_ACCEL_TARGET_HYBRID
 } ttak_accel_target_t;
 
 /**
@@ -68,6 +95,12 @@ typedef ttak_result_t (*ttak_accel_backend_fn)(
  *
  * The dispatcher uses lock-free atomics to lazily bind the backend the first time
  * this function is invoked so there is no global mutex contention after startup.
+ *
+ * With TTAK_ACCEL_TARGET_HYBRID the items are split between the first
+ * compiled-in GPU backend and the CPU backend, which run concurrently. The
+ * split follows each side's measured bytes per second, refreshed after every
+ * hybrid batch; items the GPU side fails on are rerun on the CPU. Without a
+ * GPU backend the whole batch runs on the CPU.
  */
 ttak_result_t ttak_execute_batch(
     const ttak_accel_batch_item_t *items,
@@ -129,7 +129,13 @@ static inline uint64_t ttak_u128_bit(ttak_u128_t v, unsigned bit) {
 
 static inline void ttak_mul_64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo) {
     /* Inline ISA primitives keep TinyCC builds fast without optimizer help. */
-#if defined(__x86_64__) && !TTAK_TINYCC_NEEDS_PORTABLE_FALLBACK
+#if defined(__SIZEOF_INT128__) && !defined(__TINYC__)
+    /* Optimizing compilers schedule a native product better than opaque asm. */
+    unsigned __int128 p = (unsigned __int128)a * b;
+    *lo = (uint64_t)p;
+    *hi = (uint64_t)(p >> 64);
+    return;
+#elif defined(__x86_64__) && !TTAK_TINYCC_NEEDS_PORTABLE_FALLBACK
     uint64_t lo_tmp, hi_tmp;
     __asm__ __volatile__("mulq %[rhs]"
                          : "=a"(lo_tmp), "=d"(hi_tmp)
@@ -210,12 +216,16 @@ static inline ttak_u128_t ttak_u128_mul64(uint64_t a, uint64_t b) {
 
 static inline uint64_t ttak_u128_mod_u64(ttak_u128_t value, uint64_t mod) {
     if (mod == 0) return 0;
+#if defined(__SIZEOF_INT128__) && !defined(__TINYC__)
+    return (uint64_t)((((unsigned __int128)value.hi << 64) | value.lo) % mod);
+#else
     uint64_t rem = 0;
     for (int bit = 127; bit >= 0; --bit) {
         rem = (rem << 1) | ttak_u128_bit(value, (unsigned)bit);
         if (rem >= mod) rem -= mod;
     }
     return rem;
+#endif
 }
 
 static inline ttak_u256_t ttak_u256_zero(void) {
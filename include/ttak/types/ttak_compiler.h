@@ -203,6 +203,14 @@
 #  define TTAK_FORCE_INLINE static inline
 #endif
 
+/*
+ * Defining TTAK_INLINE_FASTPATHS before including the library headers
+ * turns ttak_ringbuf_push/pop, ttak_map_get_key, ttak_object_pool_alloc,
+ * ttak_stats_record and ttak_token_bucket_consume into macros over
+ * TTAK_FORCE_INLINE fast paths that fall back to the out-of-line functions
+ * on their slow paths. The library itself does not need rebuilding.
+ */
+
 /** @brief Suppresses unused-variable warnings portably. */
 #if defined(__GNUC__) || defined(__clang__)
 #  define TTAK_MAYBE_UNUSED __attribute__((unused))
@@ -210,6 +218,13 @@
 #  define TTAK_MAYBE_UNUSED
 #endif
 
+/** @brief Marks a deliberate switch fallthrough, including inside macros. */
+#if (defined(__GNUC__) && __GNUC__ >= 7) || defined(__clang__)
+#  define TTAK_FALLTHROUGH __attribute__((fallthrough))
+#else
+#  define TTAK_FALLTHROUGH ((void)0)
+#endif
+
 #include <ttak/arch/ttak_arch.h>
 
 #if !defined(__GNUC__) && !defined(__clang__)
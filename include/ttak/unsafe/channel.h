@@ -0,0 +1,112 @@
+/**
+ * @file channel.h
+ * @brief Bounded channels that hand off unsafe regions by ownership transfer.
+ *
+ * A channel is a lock-free ring of ttak_unsafe_region_t handles. Sending
+ * moves the sender's region into a ring slot and rebinds it to the
+ * receiver's context and allocator tag (ttak_unsafe_region_move_cross_ctx());
+ * receiving steals it out of the slot into the caller's empty region. Only
+ * the handle travels, so a hand-off costs the same for 64 bytes or 64 MiB,
+ * and the sender's region is left empty exactly as after a move.
+ *
+ * A channel is typed by an element size: every region sent must hold a
+ * whole number of elements, so the receiver can view @c ptr as an array of
+ * @c size / elem_size items. An element size of 1 accepts any region.
+ *
+ * Send and receive take a timeout: 0 polls, TTAK_WAIT_FOREVER blocks.
+ * Blocked senders and receivers park on eventcounts, so the uncontended
+ * path never touches a lock or a syscall. Closing wakes everyone; receivers
+ * still drain what was sent before the close.
+ */
+
+#ifndef TTAK_UNSAFE_CHANNEL_H
+#define TTAK_UNSAFE_CHANNEL_H
+
+#include <ttak/unsafe/region.h>
+#include <ttak/container/ringbuf.h>
+#include <ttak/sync/waitword.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Outcome of a channel operation.
+ */
+typedef enum ttak_chan_status {
+    TTAK_CHAN_OK = 0,       /**< The region was transferred. */
+    TTAK_CHAN_WOULD_BLOCK,  /**< Polled (timeout 0) and the ring was full or empty. */
+    TTAK_CHAN_TIMEOUT,      /**< The timeout passed first. */
+    TTAK_CHAN_CLOSED,       /**< Send after close, or receive on a closed and drained channel. */
+    TTAK_CHAN_INVALID       /**< Bad argument, pinned region, or size not a multiple of the element size. */
+} ttak_chan_status_t;
+
+/**
+ * @brief Bounded region channel.
+ */
+typedef struct ttak_region_chan {
+    ttak_ringbuf_t *ring;           /**< Slots hold ttak_unsafe_region_t by value. */
+    size_t elem_size;               /**< Every region's size is a multiple of this. */
+    uint32_t recv_ctx_id;           /**< Context a received region belongs to. */
+    const char *recv_tag;           /**< Allocator tag of a received region, or NULL to keep the sender's. */
+    _Atomic uint32_t closed;
+    ttak_eventcount_t not_empty;    /**< Receivers park here. */
+    ttak_eventcount_t not_full;     /**< Senders park here. */
+} ttak_region_chan_t;
+
+/**
+ * @brief Creates a channel of at least @p capacity slots.
+ *
+ * @param capacity    Slots; rounded up to a power of two in the lock-free modes.
+ * @param mode        Ring discipline: TTAK_RINGBUF_SPSC for one sender and
+ *                    one receiver thread, TTAK_RINGBUF_MPMC for any.
+ * @param elem_size   Element size regions must be a multiple of (0 means 1).
+ * @param recv_ctx_id Context id stamped on received regions.
+ * @param recv_tag    Allocator tag stamped on received regions, or NULL.
+ * @return NULL on a zero capacity or allocation failure.
+ */
+ttak_region_chan_t *ttak_region_chan_create(size_t capacity, ttak_ringbuf_mode_t mode, size_t elem_size,
+                                            uint32_t recv_ctx_id, const char *recv_tag);
+
+/**
+ * @brief Destroys the channel. No thread may still be using it.
+ *
+ * Regions still queued are handed to @p drop (which owns freeing them),
+ * or leaked when @p drop is NULL.
+ */
+void ttak_region_chan_destroy(ttak_region_chan_t *chan,
+                              void (*drop)(ttak_unsafe_region_t *region, void *arg), void *arg);
+
+/**
+ * @brief Moves @p src into the channel, waiting up to @p timeout_ns for a slot.
+ *
+ * On TTAK_CHAN_OK @p src is reset to the canonical empty region; on any
+ * other status it is untouched. @p src must not be pinned.
+ */
+ttak_chan_status_t ttak_region_chan_send(ttak_region_chan_t *chan, ttak_unsafe_region_t *src,
+                                         uint64_t timeout_ns);
+
+/**
+ * @brief Moves the oldest region into @p dst, waiting up to @p timeout_ns.
+ *
+ * @p dst must be empty and unpinned; it receives the region with the
+ * channel's receive context and tag.
+ */
+ttak_chan_status_t ttak_region_chan_recv(ttak_region_chan_t *chan, ttak_unsafe_region_t *dst,
+                                         uint64_t timeout_ns);
+
+/**
+ * @brief Closes the channel and wakes every blocked sender and receiver.
+ */
+void ttak_region_chan_close(ttak_region_chan_t *chan);
+
+/**
+ * @brief Returns true once ttak_region_chan_close() has been called.
+ */
+bool ttak_region_chan_is_closed(const ttak_region_chan_t *chan);
+
+/**
+ * @brief Returns the number of queued regions (a snapshot under concurrent use).
+ */
+size_t ttak_region_chan_len(ttak_region_chan_t *chan);
+
+#endif // TTAK_UNSAFE_CHANNEL_H
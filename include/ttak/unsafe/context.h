@@ -11,7 +11,10 @@
 
 #include <ttak/mem/owner.h>
 #include <ttak/sync/sync.h>
+#include <ttak/sync/waitword.h>
+#include <stdatomic.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #define __TTAK_CTX_USE_FIRST__  0
@@ -52,4 +55,78 @@ ttak_owner_t *ttak_context_owner(const ttak_context_t *ctx, ttak_context_inherit
 ttak_context_inherit_t ttak_context_active(const ttak_context_t *ctx);
 void *ttak_context_shared(const ttak_context_t *ctx, size_t *size_out);
 
+/**
+ * @brief Lock-free two-owner bridge for high-frequency hand-offs.
+ *
+ * Where ttak_context_t takes a mutex and the active owner's lock on every
+ * run, a bridge keeps the whole protocol in one atomic word: which side
+ * holds the shared memory, whether that side is inside a callback, and a
+ * generation count. Entering is one CAS from (side, idle) to (side, busy);
+ * leaving, or handing off between calls, is one store or CAS to
+ * (next side, idle). Threads waiting for their turn sleep on the word.
+ *
+ * The owners' policies are checked once, in ttak_context_bridge_init():
+ * an owner with TTAK_OWNER_STRICT_ISOLATION cannot share memory through a
+ * bridge. Calls never take the owners' locks, so callbacks must not race
+ * with registrations on the same owner.
+ */
+typedef struct ttak_context_bridge {
+    _Atomic uint32_t state;     /**< Side bit, busy bit, generation above them. */
+    _Atomic uint32_t waiters;   /**< Threads asleep on @c state. */
+    ttak_owner_t *owners[2];
+    void *shared_mem;
+    size_t shared_size;
+    bool initialized;
+} ttak_context_bridge_t;
+
+/**
+ * @brief Initialises a bridge held by @p inherit_side.
+ *
+ * @return False on NULL owners or when either owner's policy forbids sharing.
+ */
+bool ttak_context_bridge_init(ttak_context_bridge_t *bridge,
+                              ttak_owner_t *first,
+                              ttak_owner_t *second,
+                              void *shared_mem,
+                              size_t shared_size,
+                              ttak_context_inherit_t inherit_side);
+
+void ttak_context_bridge_destroy(ttak_context_bridge_t *bridge);
+
+/**
+ * @brief Waits up to @p timeout_ns until @p side holds the idle bridge, then marks it busy.
+ *
+ * A timeout of 0 tries once; TTAK_WAIT_FOREVER waits forever.
+ *
+ * @return False on timeout or an uninitialised bridge.
+ */
+bool ttak_context_bridge_enter(ttak_context_bridge_t *bridge, ttak_context_inherit_t side, uint64_t timeout_ns);
+
+/**
+ * @brief Leaves the bridge after ttak_context_bridge_enter(), giving it to @p next_side.
+ */
+void ttak_context_bridge_leave(ttak_context_bridge_t *bridge, ttak_context_inherit_t next_side);
+
+/**
+ * @brief enter(), run @p cb on the shared memory, then leave() to @p next_side.
+ */
+bool ttak_context_bridge_run(ttak_context_bridge_t *bridge,
+                             ttak_context_inherit_t side,
+                             ttak_context_callback_t cb,
+                             void *arg,
+                             ttak_context_inherit_t next_side,
+                             uint64_t timeout_ns);
+
+/**
+ * @brief Hands an idle bridge from @p from to @p to with one CAS.
+ *
+ * @return False if @p from does not hold the bridge or it is busy.
+ */
+bool ttak_context_bridge_handoff(ttak_context_bridge_t *bridge,
+                                 ttak_context_inherit_t from,
+                                 ttak_context_inherit_t to);
+
+ttak_owner_t *ttak_context_bridge_owner(const ttak_context_bridge_t *bridge, ttak_context_inherit_t side);
+ttak_context_inherit_t ttak_context_bridge_active(const ttak_context_bridge_t *bridge);
+
 #endif // TTAK_UNSAFE_CONTEXT_H
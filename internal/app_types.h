@@ -41,6 +41,23 @@
 #endif
 #endif
 
+/**
+ * @brief Places a TTAK_THREAD_LOCAL in the static TLS block.
+ *
+ * The library is built with -ftls-model=global-dynamic so it can be
+ * dlopen()ed, which makes every TLS access a __tls_get_addr() call.
+ * Initial-exec reads the slot at a fixed offset from the thread pointer.
+ * Keep such variables small: they come out of the surplus static TLS
+ * that glibc reserves for dlopen()ed libraries.
+ */
+#ifndef TTAK_TLS_INITIAL_EXEC
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(__TINYC__) && !defined(_WIN32)
+#define TTAK_TLS_INITIAL_EXEC __attribute__((tls_model("initial-exec")))
+#else
+#define TTAK_TLS_INITIAL_EXEC
+#endif
+#endif
+
 /**
  * @brief Time unit macros for converting to nanoseconds.
  */
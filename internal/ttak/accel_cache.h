@@ -0,0 +1,62 @@
+/**
+ * @file accel_cache.h
+ * @brief Location of the per-user cache the accelerator code persists into.
+ */
+
+#ifndef TTAK_INTERNAL_ACCEL_CACHE_H
+#define TTAK_INTERNAL_ACCEL_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define ttak_accel_mkdir(path) _mkdir(path)
+#else
+#define ttak_accel_mkdir(path) mkdir((path), 0700)
+#endif
+
+/**
+ * @brief Writes the cache directory into @p out, creating it if needed.
+ *
+ * Uses $TTAK_ACCEL_CACHE_DIR, else $XDG_CACHE_HOME/ttak, else
+ * $HOME/.cache/ttak. An empty TTAK_ACCEL_CACHE_DIR disables caching.
+ *
+ * @return false when caching is disabled or the path does not fit.
+ */
+static inline bool ttak_accel_cache_dir(char *out, size_t cap) {
+    const char *dir = getenv("TTAK_ACCEL_CACHE_DIR");
+    int n;
+    if (dir != NULL) {
+        if (*dir == '\0') return false;
+        n = snprintf(out, cap, "%s", dir);
+    } else if ((dir = getenv("XDG_CACHE_HOME")) != NULL && *dir != '\0') {
+        n = snprintf(out, cap, "%s/ttak", dir);
+    } else if ((dir = getenv("HOME")) != NULL && *dir != '\0') {
+        n = snprintf(out, cap, "%s/.cache", dir);
+        if (n < 0 || (size_t)n >= cap) return false;
+        (void)ttak_accel_mkdir(out);
+        n = snprintf(out, cap, "%s/.cache/ttak", dir);
+    } else {
+        return false;
+    }
+    if (n < 0 || (size_t)n >= cap) return false;
+    (void)ttak_accel_mkdir(out);
+    return true;
+}
+
+/** @brief FNV-1a 64 over @p len bytes, continuing from @p hash. */
+static inline uint64_t ttak_accel_cache_hash(uint64_t hash, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+#endif /* TTAK_INTERNAL_ACCEL_CACHE_H */
@@ -0,0 +1,33 @@
+/**
+ * @file factor_internal.h
+ * @brief Helpers shared by the big-integer factoring engines.
+ *
+ * Implemented in src/math/factor.c and used by the ECM and quadratic
+ * sieve engines next to it.
+ */
+
+#ifndef TTAK_INTERNAL_FACTOR_INTERNAL_H
+#define TTAK_INTERNAL_FACTOR_INTERNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ttak/math/bigint.h>
+#include <ttak/thread/pool.h>
+
+/**
+ * @brief Runs fn(ctx, i) for every i below @p count, spread over @p pool.
+ *
+ * Helpers and the caller claim indices from one counter, and the caller
+ * only waits for indices already claimed, so this is safe to call from a
+ * task of the same pool. A NULL pool runs the loop on the caller.
+ */
+void ttak_factor_parallel_for(ttak_thread_pool_t *pool, size_t count, void (*fn)(void *ctx, size_t index),
+                              void *ctx, uint64_t now);
+
+/**
+ * @brief g = gcd(|a|, |b|).
+ */
+bool ttak_factor_gcd(ttak_bigint_t *g, const ttak_bigint_t *a, const ttak_bigint_t *b, uint64_t now);
+
+#endif /* TTAK_INTERNAL_FACTOR_INTERNAL_H */
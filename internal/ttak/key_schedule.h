@@ -0,0 +1,34 @@
+/**
+ * @file key_schedule.h
+ * @brief Hooks between the session schedule cache and the cipher files.
+ *
+ * ttak_security_schedule_init() lives in src/security/key_schedule.c and
+ * calls into each cipher's own expansion; the kernels ask
+ * ttak_security_schedule_match() whether ctx->schedule applies to them.
+ */
+
+#ifndef TTAK_INTERNAL_KEY_SCHEDULE_H
+#define TTAK_INTERNAL_KEY_SCHEDULE_H
+
+#include <stdint.h>
+
+#include <ttak/security/key_schedule.h>
+
+/**
+ * @brief Returns @c ctx->schedule when it was expanded from @c ctx->key for
+ *        @p cipher, otherwise NULL.
+ */
+const ttak_security_schedule_t *ttak_security_schedule_match(const ttak_crypto_ctx_t *ctx,
+                                                             ttak_security_cipher_t cipher);
+
+/**
+ * @brief Fills @c sched->u.aes from the 32-byte @c sched->key.
+ */
+void ttak_aes256_gcm_schedule_fill(ttak_security_schedule_t *sched);
+
+/**
+ * @brief Expands a 16-byte SEED key into its 32 round keys.
+ */
+void ttak_seed_expand_key(uint32_t round_keys[32], const uint8_t key[16]);
+
+#endif /* TTAK_INTERNAL_KEY_SCHEDULE_H */
@@ -48,24 +48,127 @@ static inline void ttak_os_mem_free(void *ptr, size_t size) {
 }
 #endif
 #endif
+
+/*
+ * The fixed regions of non-OS-managed builds (VMA, large, pocket pages,
+ * buddy pool) are reserved with mmap on first use where mmap exists, so
+ * they cost neither .bss nor startup time. Define TTAK_STATIC_REGIONS_IN_BSS
+ * to keep them as static arrays.
+ */
+#if !TTAK_OS_MANAGED_MEMORY && defined(__unix__) && !defined(TTAK_STATIC_REGIONS_IN_BSS)
+#define TTAK_LAZY_STATIC_REGIONS 1
+#include <sys/mman.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+static inline void *ttak_static_region_reserve(size_t size) {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+#else
+#define TTAK_LAZY_STATIC_REGIONS 0
+#endif
+
 #include "../../internal/app_types.h"
 #include <ttak/mem/mem.h>
+#include <ttak/mem/mem_stats.h>
 #include <ttak/types/ttak_compiler.h>
 
+#if TTAK_OS_MANAGED_MEMORY
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#define TTAK_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+/**
+ * @brief ttak_os_mem_alloc() honouring the placement bits of ttak_mem_flags_t.
+ *
+ * TTAK_MEM_HUGE_PAGES aligns mappings of at least one huge page to a 2 MiB
+ * boundary and advises MADV_HUGEPAGE. A TTAK_MEM_NUMA_NODE() hint sets a
+ * preferred-node policy before the caller's first touch, so the pages are
+ * faulted in on that node when it has room. Hints that the platform cannot
+ * apply are dropped silently; the mapping length is always @p size so the
+ * block is released with ttak_os_mem_free() as usual.
+ */
+static inline void *ttak_os_mem_alloc_hinted(size_t size, ttak_mem_flags_t flags) {
+    unsigned node_field = ((unsigned)flags & (unsigned)TTAK_MEM_NUMA_NODE_MASK) >> TTAK_MEM_NUMA_NODE_SHIFT;
+#ifdef _WIN32
+    if (node_field) {
+        void *p = VirtualAllocExNuma(GetCurrentProcess(), NULL, size, MEM_COMMIT | MEM_RESERVE,
+                                     PAGE_READWRITE, (DWORD)(node_field - 1));
+        if (p) return p;
+    }
+    return ttak_os_mem_alloc(size);
+#else
+    void *p = NULL;
+    bool huge = (flags & TTAK_MEM_HUGE_PAGES) && size >= TTAK_HUGE_PAGE_SIZE;
+    if (huge && size <= SIZE_MAX - TTAK_HUGE_PAGE_SIZE) {
+        uint8_t *raw = (uint8_t *)ttak_os_mem_alloc(size + TTAK_HUGE_PAGE_SIZE);
+        if (raw) {
+            uintptr_t aligned = ((uintptr_t)raw + TTAK_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(TTAK_HUGE_PAGE_SIZE - 1);
+            size_t head = aligned - (uintptr_t)raw;
+            if (head) ttak_os_mem_free(raw, head);
+            ttak_os_mem_free((uint8_t *)aligned + size, TTAK_HUGE_PAGE_SIZE - head);
+            p = (void *)aligned;
+        }
+    }
+    if (!p) p = ttak_os_mem_alloc(size);
+    if (!p) return NULL;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (huge) (void)madvise(p, size, MADV_HUGEPAGE);
+#endif
+#if defined(__linux__) && defined(SYS_mbind)
+    if (node_field) {
+        enum { TTAK_MPOL_PREFERRED = 1 };
+        unsigned long nodemask[256 / (8 * sizeof(unsigned long))] = {0};
+        unsigned node = node_field - 1;
+        nodemask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+        (void)syscall(SYS_mbind, p, size, TTAK_MPOL_PREFERRED, nodemask,
+                      (unsigned long)(sizeof(nodemask) * 8 + 1), 0UL);
+    }
+#endif
+    return p;
+#endif
+}
+#endif
+
 // --- Memory Magic Numbers ---
 #define POCKET_MAGIC 0x80C4E700 /**< Base magic for 4KB pocket pages (Lower bits: freelist_idx) */
 #define SLAB_MAGIC   0x51ABCA5E /**< Magic for Slab pages */
 
+/**
+ * @brief Per-thread flags of the fortress allocator.
+ *
+ * One struct so an API call resolves its thread state once and then works
+ * on a plain pointer. Defined in mem.c.
+ */
+typedef struct ttak_mem_tls {
+    bool reentrancy_guard;  /**< Set while a block is being carved; nested allocations fail. */
+    bool in_mem_op;         /**< Set while the registry or mem_tree is being updated. */
+    bool in_mem_init;       /**< Set while the registry is being initialised. */
+} ttak_mem_tls_t;
+
 #if defined(__TINYC__)
-bool *ttak_tls_get_reentrancy_guard(void);
-#define t_reentrancy_guard (*ttak_tls_get_reentrancy_guard())
+/* TinyCC has no usable _Thread_local; the state lives behind a pthread key. */
+ttak_mem_tls_t *ttak_mem_tls(void);
 #else
+extern TTAK_THREAD_LOCAL ttak_mem_tls_t ttak_mem_tls_state TTAK_TLS_INITIAL_EXEC;
+
+static inline ttak_mem_tls_t *ttak_mem_tls(void) {
+    return &ttak_mem_tls_state;
+}
+#endif
+
 /**
  * @brief Reentrancy guard to prevent recursive calls during boot/allocation.
- * Defined in mem.c.
  */
-extern TTAK_THREAD_LOCAL bool t_reentrancy_guard;
-#endif
+#define t_reentrancy_guard (ttak_mem_tls()->reentrancy_guard)
 
 /**
  * @typedef ttak_fixed_16_16_t
@@ -101,7 +204,7 @@ typedef struct ttak_mem_header_t ttak_mem_header_t;
 // --- Thread-Local Pockets (Objects <= 512B user payload) ---
 #define TTAK_POCKET_PAGE_SIZE 4096 
 #define TTAK_POCKET_ALIGNMENT 4096 
-#define TTAK_NUM_POCKET_FREELISTS 4 
+#define TTAK_NUM_POCKET_FREELISTS 7 
 
 /**
  * @struct ttak_mem_pocket_freelist
@@ -168,10 +271,16 @@ ttak_mem_header_t* ttak_mem_pocket_alloc_internal(size_t size);
 
 /**
  * @brief Allocates memory from the VMA (Virtual Mapping Area) tier.
+ *
+ * The whole block, header included, reads zero: OS-backed blocks are fresh
+ * anonymous pages and region blocks are cleared only where the region has
+ * handed the bytes out before.
+ *
  * @param size Requested user memory size.
+ * @param flags Placement hints (huge pages, NUMA node) for OS-backed blocks.
  * @return Pointer to the ttak_mem_header_t of the allocated block, or NULL on failure.
  */
-ttak_mem_header_t* ttak_mem_vma_alloc_internal(size_t size);
+ttak_mem_header_t* ttak_mem_vma_alloc_internal(size_t size, ttak_mem_flags_t flags);
 
 /**
  * @brief Releases a memory block back to the pocket tier.
@@ -179,18 +288,51 @@ ttak_mem_header_t* ttak_mem_vma_alloc_internal(size_t size);
  */
 void _pocket_free_internal(ttak_mem_header_t* header);
 
+/**
+ * @brief Allocates a raw pocket block without assuming a header layout.
+ *
+ * Used by the header-lite path, whose blocks are far smaller than a
+ * fortress header and land in the sub-192-byte size classes.
+ *
+ * @param total_block_size Bytes needed including any caller-owned header.
+ * @return Start of the block, or NULL if no size class fits.
+ */
+void *ttak_mem_pocket_alloc_block(size_t total_block_size);
+
+/**
+ * @brief Returns a raw block obtained from ttak_mem_pocket_alloc_block().
+ * @param block Start of the block.
+ */
+void ttak_mem_pocket_free_block(void *block);
+
 /**
  * @brief Releases a memory block back to the VMA tier.
  * @param header Pointer to the memory header to be freed.
  */
 void _vma_free_internal(ttak_mem_header_t* header);
 
+/**
+ * @brief Grows a VMA-tier or large-tier block to @p new_total bytes, header included.
+ *
+ * Region builds absorb a free neighbouring block; OS-managed builds remap
+ * the block's pages with mremap(MREMAP_MAYMOVE), which may move it. The
+ * caller updates @c mapped_size and the header's other fields.
+ *
+ * @return The block's header, at its new address if it moved, or NULL if
+ *         it cannot grow without a copy; the block is untouched then.
+ */
+ttak_mem_header_t* ttak_mem_vma_grow_internal(ttak_mem_header_t* header, size_t new_total);
+
 /**
  * @brief Allocates memory from the dedicated large-allocation region.
+ *
+ * Returns zeroed blocks like ttak_mem_vma_alloc_internal().
+ *
  * @param size Requested user memory size.
+ * @param flags Placement hints (huge pages, NUMA node) for OS-backed blocks.
  * @return Pointer to the ttak_mem_header_t of the allocated block, or NULL on failure.
  */
-ttak_mem_header_t* ttak_mem_large_alloc_internal(size_t size);
+ttak_mem_header_t* ttak_mem_large_alloc_internal(size_t size, ttak_mem_flags_t flags);
 
 /**
  * @brief Releases a memory block back to the dedicated large tier.
@@ -198,6 +340,99 @@ ttak_mem_header_t* ttak_mem_large_alloc_internal(size_t size);
  */
 void _large_free_internal(ttak_mem_header_t* header);
 
+/**
+ * @brief Mean sampling interval of the heap profiler in bytes; 0 when off.
+ * Defined in ttak_mem_profile.c.
+ */
+extern _Atomic size_t global_profile_interval;
+
+/**
+ * @brief Charges a freshly initialised block to the heap profiler.
+ *
+ * Only called while profiling is enabled; decides whether this block is
+ * sampled and, if so, tags header->profile_site.
+ */
+void ttak_mem_profile_record_alloc(ttak_mem_header_t *header, uint64_t lifetime_ticks);
+
+/**
+ * @brief Credits a sampled block back to its site on free.
+ */
+void ttak_mem_profile_record_free(ttak_mem_header_t *header);
+
+/**
+ * @brief Per-tier telemetry counters behind ttak_mem_stats_snapshot().
+ * Defined in ttak_mem_stats.c; each tier sits on its own cache line.
+ */
+typedef struct ttak_mem_tier_counter {
+    _Alignas(64) _Atomic uint64_t live_bytes;
+    _Atomic uint64_t allocs;
+    _Atomic uint64_t frees;
+} ttak_mem_tier_counter_t;
+
+extern ttak_mem_tier_counter_t ttak_mem_tier_counters[TTAK_MEM_STATS_TIER_COUNT];
+
+static inline ttak_mem_tier_counter_t *ttak_mem_tier_counter(ttak_allocation_tier_t tier) {
+    if (tier == TTAK_ALLOC_TIER_POCKET) return &ttak_mem_tier_counters[TTAK_MEM_STATS_TIER_POCKET];
+    if (tier == TTAK_ALLOC_TIER_VMA) return &ttak_mem_tier_counters[TTAK_MEM_STATS_TIER_VMA];
+    if (tier == TTAK_ALLOC_TIER_BUDDY) return &ttak_mem_tier_counters[TTAK_MEM_STATS_TIER_BUDDY];
+    return &ttak_mem_tier_counters[TTAK_MEM_STATS_TIER_GENERAL];
+}
+
+/** @brief Credits @p bytes of a new block to @p tier. */
+static inline void ttak_mem_stats_note_alloc(ttak_allocation_tier_t tier, size_t bytes) {
+    ttak_mem_tier_counter_t *c = ttak_mem_tier_counter(tier);
+    atomic_fetch_add_explicit(&c->live_bytes, bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->allocs, 1, memory_order_relaxed);
+}
+
+/** @brief Debits @p bytes of a released block from @p tier. */
+static inline void ttak_mem_stats_note_free(ttak_allocation_tier_t tier, size_t bytes) {
+    ttak_mem_tier_counter_t *c = ttak_mem_tier_counter(tier);
+    atomic_fetch_sub_explicit(&c->live_bytes, bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->frees, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief True when @p tier's allocator hands out blocks that already read zero.
+ *
+ * Pocket and buddy blocks are recycled as they were freed and need clearing.
+ */
+static inline bool ttak_mem_tier_returns_zeroed(ttak_allocation_tier_t tier) {
+    return tier == TTAK_ALLOC_TIER_VMA || tier == TTAK_ALLOC_TIER_GENERAL;
+}
+
+/** @brief Moves @p tier's live bytes from @p old_bytes to @p new_bytes for a block resized in place. */
+static inline void ttak_mem_stats_note_resize(ttak_allocation_tier_t tier, size_t old_bytes, size_t new_bytes) {
+    ttak_mem_tier_counter_t *c = ttak_mem_tier_counter(tier);
+    atomic_fetch_add_explicit(&c->live_bytes, (uint64_t)new_bytes - (uint64_t)old_bytes, memory_order_relaxed);
+}
+
+/**
+ * @brief Fills the pocket tier's reserved bytes and per-class free slots.
+ * Defined in ttak_mem_pocket.c.
+ */
+void ttak_mem_pocket_stats(ttak_mem_stats_t *out);
+
+/**
+ * @brief Fills reserved bytes and free-list figures of the VMA and general tiers.
+ * Defined in ttak_mem_vma.c.
+ */
+void ttak_mem_vma_stats(ttak_mem_stats_t *out);
+
+/**
+ * @brief Drains the calling thread's remote frees and unmaps orphaned
+ *        pocket pages with no live block. Defined in ttak_mem_pocket.c.
+ * @return Bytes unmapped.
+ */
+size_t ttak_mem_pocket_trim(void);
+
+/**
+ * @brief Hands the free pages of the static VMA and general regions back
+ *        to the kernel. Defined in ttak_mem_vma.c.
+ * @return Bytes advised away; always 0 on OS-managed builds.
+ */
+size_t ttak_mem_vma_trim(void);
+
 /**
  * @brief Raw linear VMA allocator (internal use).
  * @param size Total bytes to allocate.
@@ -219,10 +454,13 @@ void _slab_free_internal(ttak_mem_header_t* header, uintptr_t slab_page_start_ad
  * @brief Maps a total block size to a pocket freelist index.
  */
 static inline int get_pocket_size_class_idx(size_t total_block_size) {
-    if (total_block_size <= 192) return 0;
-    if (total_block_size <= 256) return 1;
-    if (total_block_size <= 384) return 2;
-    if (total_block_size <= 768) return 3;
+    if (total_block_size <= 32) return 0;
+    if (total_block_size <= 64) return 1;
+    if (total_block_size <= 128) return 2;
+    if (total_block_size <= 192) return 3;
+    if (total_block_size <= 256) return 4;
+    if (total_block_size <= 384) return 5;
+    if (total_block_size <= 768) return 6;
     return -1;
 }
 
@@ -231,10 +469,13 @@ static inline int get_pocket_size_class_idx(size_t total_block_size) {
  */
 static inline size_t get_total_block_size_for_freelist(int idx) {
     switch (idx) {
-        case 0: return 192;
-        case 1: return 256;
-        case 2: return 384;
-        case 3: return 768;
+        case 0: return 32;
+        case 1: return 64;
+        case 2: return 128;
+        case 3: return 192;
+        case 4: return 256;
+        case 5: return 384;
+        case 6: return 768;
     }
     return 0;
 }
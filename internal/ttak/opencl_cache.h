@@ -0,0 +1,26 @@
+/**
+ * @file opencl_cache.h
+ * @brief On-disk cache of built OpenCL programs shared by the OpenCL backends.
+ *
+ * Implemented in src/accel/opencl_cache.c, which is compiled only with
+ * USE_OPENCL=1.
+ */
+
+#ifndef TTAK_INTERNAL_OPENCL_CACHE_H
+#define TTAK_INTERNAL_OPENCL_CACHE_H
+
+#include <CL/cl.h>
+
+/**
+ * @brief Builds @p src for @p device, reusing a program binary cached on disk.
+ *
+ * Binaries live in $TTAK_ACCEL_CACHE_DIR, else $XDG_CACHE_HOME/ttak, else
+ * $HOME/.cache/ttak. Each file is keyed by the source text, device name,
+ * device version and driver version, so a driver update rebuilds from source.
+ * Setting TTAK_ACCEL_CACHE_DIR to an empty string disables the cache.
+ *
+ * @return A built program, or NULL with @p err_out set on failure.
+ */
+cl_program ttak_opencl_build_cached(cl_context context, cl_device_id device, const char *src, cl_int *err_out);
+
+#endif /* TTAK_INTERNAL_OPENCL_CACHE_H */
@@ -0,0 +1,35 @@
+/**
+ * @file security_accel.h
+ * @brief GPU offload of bulk ChaCha20 keystream for security batches.
+ *
+ * Implemented in src/security/security_accel.c on top of the per-backend
+ * kernels in src/accel/security_{cuda,rocm,opencl}. Every backend takes the
+ * same packed layout: records of TTAK_SECURITY_ACCEL_RECORD_WORDS words
+ * (key words 0..7, nonce words 8..10, first data block 11, rest zero) and
+ * one buffer of 64-byte blocks, where each record's text starts on its own
+ * block and block b of a record uses counter 1 + b.
+ */
+
+#ifndef TTAK_INTERNAL_SECURITY_ACCEL_H
+#define TTAK_INTERNAL_SECURITY_ACCEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <ttak/security/security_engine.h>
+
+#define TTAK_SECURITY_ACCEL_RECORD_WORDS 16U
+
+/**
+ * @brief XORs the ChaCha20 keystream into @c out for every record of
+ *        @p ctxs that @p pick accepts, on the first GPU backend that works.
+ *
+ * Only the encryption is done; Poly1305 stays with the caller. Records
+ * must be linear with @c in / @c out set and a 32-byte key.
+ *
+ * @return false, with no @c out written, when no backend took the batch.
+ */
+bool ttak_security_accel_chacha20(ttak_crypto_ctx_t *ctxs, size_t count,
+                                  bool (*pick)(const ttak_crypto_ctx_t *ctx));
+
+#endif /* TTAK_INTERNAL_SECURITY_ACCEL_H */
@@ -12,6 +12,12 @@
  * uniform dispersion similar in spirit to Orthogonal Latin Square constructions,
  * minimising clustering and collision across shards.
  *
+ * Thread pools size their own map at creation: ttak_shard_count_for_threads()
+ * picks a power of two in [TTAK_POOL_SHARD_COUNT, TTAK_POOL_SHARD_MAX], and
+ * ttak_shard_route_build() generates the matching n×n cyclic square.  The
+ * _n variants below take that count; the fixed 8-shard functions stay for
+ * process-wide users such as the scheduler history.
+ *
  * All functions are deterministic, pure, and side-effect-free.
  */
 
@@ -22,7 +28,7 @@
 #include <stddef.h>
 #include <ttak/mols_control.h>
 
-/** Default shard count — must be a power of two, maximum 8. */
+/** Default (and minimum) shard count — must be a power of two. */
 #define TTAK_POOL_SHARD_COUNT 8
 
 /** Log₂ of TTAK_POOL_SHARD_COUNT (used for bit shifts). */
@@ -31,6 +37,12 @@
 /** Mask to reduce a coordinate to [0, TTAK_POOL_SHARD_COUNT). */
 #define TTAK_POOL_SHARD_MASK  (TTAK_POOL_SHARD_COUNT - 1)
 
+/** Largest shard count a pool may generate; route entries stay uint8_t. */
+#define TTAK_POOL_SHARD_MAX   256
+
+/** Workers sharing one shard lock before the pool doubles its shard count. */
+#define TTAK_POOL_WORKERS_PER_SHARD 2
+
 /**
  * @brief 8×8 Latin-square routing table.
  *
@@ -54,11 +66,39 @@ static const uint8_t shard_route_table[TTAK_POOL_SHARD_COUNT][TTAK_POOL_SHARD_CO
 };
 
 /**
- * @brief Convert a task hash into (row, col) shard coordinates.
+ * @brief Convert a task hash into (row, col) coordinates on an n×n grid.
  *
  * Uses Fibonacci/multiplicative hashing with the 64-bit golden-ratio constant
  * to project the hash into a bounded 2D coordinate space.  The upper and lower
- * halves of the mixed value are used independently to decorrelate the two axes.
+ * halves of the mixed value are used independently to decorrelate the two axes,
+ * then the pair is shuffled by the MOLS construction of the same order.
+ *
+ * @param hash        Task hash value.
+ * @param count_log2  Log₂ of the grid order (shard count).
+ * @param row         Output: row coordinate in [0, 2^count_log2).
+ * @param col         Output: column coordinate in [0, 2^count_log2).
+ */
+static inline void ttak_shard_hash_to_coords_n(uint64_t hash,
+                                                uint32_t count_log2,
+                                                uint32_t *row,
+                                                uint32_t *col)
+{
+    /* 64-bit golden-ratio constant (⌊2^64 / φ⌋) for Fibonacci hashing */
+    const uint64_t GOLDEN = UINT64_C(0x9e3779b97f4a7c15);
+    const uint32_t mask = (1U << count_log2) - 1U;
+    uint64_t mixed = hash * GOLDEN;
+    const uint32_t row_bits = (uint32_t)(mixed >> 32) & mask;
+    const uint32_t col_bits = (uint32_t)(mixed & UINT32_MAX) & mask;
+    const uint32_t combined = (row_bits << count_log2) | col_bits;
+    const uint32_t adjusted = ttak_apply_mols_control_order(count_log2, combined, combined);
+    *row = (adjusted >> count_log2) & mask;
+    *col = adjusted & mask;
+}
+
+/**
+ * @brief Convert a task hash into (row, col) shard coordinates.
+ *
+ * Same as ttak_shard_hash_to_coords_n() on the default 8×8 grid.
  *
  * @param hash  Task hash value.
  * @param row   Output: row coordinate in [0, TTAK_POOL_SHARD_COUNT).
@@ -68,20 +108,7 @@ static inline void ttak_shard_hash_to_coords(uint64_t hash,
                                               uint32_t *row,
                                               uint32_t *col)
 {
-    /* 64-bit golden-ratio constant (⌊2^64 / φ⌋) for Fibonacci hashing */
-    const uint64_t GOLDEN = UINT64_C(0x9e3779b97f4a7c15);
-    uint64_t mixed = hash * GOLDEN;
-    *row = (uint32_t)(mixed >> 32) & (uint32_t)TTAK_POOL_SHARD_MASK;
-    *col = (uint32_t)(mixed & UINT32_MAX) & (uint32_t)TTAK_POOL_SHARD_MASK;
-    const uint32_t row_bits = *row & (uint32_t)TTAK_MOLS_SYMBOL_MASK;
-    const uint32_t col_bits = *col & (uint32_t)TTAK_MOLS_SYMBOL_MASK;
-    const uint16_t node_id =
-        (uint16_t)((row_bits << TTAK_MOLS_COORD_SHIFT) | col_bits);
-    const uint32_t combined =
-        (row_bits << TTAK_MOLS_COORD_SHIFT) | col_bits;
-    const uint32_t adjusted = ttak_apply_mols_control(node_id, combined);
-    *row = (adjusted >> TTAK_MOLS_COORD_SHIFT) & (uint32_t)TTAK_POOL_SHARD_MASK;
-    *col = adjusted & (uint32_t)TTAK_POOL_SHARD_MASK;
+    ttak_shard_hash_to_coords_n(hash, TTAK_POOL_SHARD_LOG2, row, col);
 }
 
 /**
@@ -101,6 +128,23 @@ static inline size_t ttak_shard_for_hash(uint64_t hash)
     return (size_t)shard_route_table[row][col];
 }
 
+/**
+ * @brief Map a task hash through a generated n×n routing table.
+ *
+ * @param route       Table from ttak_shard_route_build(), row-major.
+ * @param count_log2  Log₂ of the table order.
+ * @param hash        Task identifier hash.
+ * @return            Shard index in [0, 2^count_log2).
+ */
+static inline size_t ttak_shard_for_hash_n(const uint8_t *route,
+                                           uint32_t count_log2,
+                                           uint64_t hash)
+{
+    uint32_t row, col;
+    ttak_shard_hash_to_coords_n(hash, count_log2, &row, &col);
+    return (size_t)route[((size_t)row << count_log2) | col];
+}
+
 /**
  * @brief Map a worker index to its preferred shard.
  *
@@ -115,4 +159,84 @@ static inline size_t ttak_shard_for_worker(size_t worker_idx)
     return worker_idx & (size_t)TTAK_POOL_SHARD_MASK;
 }
 
+/**
+ * @brief Map a worker index to its preferred shard among @p count shards.
+ *
+ * @param count       Power-of-two shard count.
+ * @param worker_idx  Zero-based worker index.
+ * @return            Preferred shard index.
+ */
+static inline size_t ttak_shard_for_worker_n(size_t count, size_t worker_idx)
+{
+    return worker_idx & (count - 1U);
+}
+
+/**
+ * @brief Pick the shard count for a pool of @p num_threads workers.
+ *
+ * The smallest power of two giving each shard at most
+ * TTAK_POOL_WORKERS_PER_SHARD workers, clamped to
+ * [TTAK_POOL_SHARD_COUNT, TTAK_POOL_SHARD_MAX].
+ *
+ * @param num_threads  Worker count.
+ * @param log2_out     Optional output: log₂ of the returned count.
+ * @return             Shard count.
+ */
+static inline size_t ttak_shard_count_for_threads(size_t num_threads, uint32_t *log2_out)
+{
+    size_t want = (num_threads + TTAK_POOL_WORKERS_PER_SHARD - 1U) / TTAK_POOL_WORKERS_PER_SHARD;
+    size_t count = TTAK_POOL_SHARD_COUNT;
+    uint32_t log2 = TTAK_POOL_SHARD_LOG2;
+    while (count < want && count < TTAK_POOL_SHARD_MAX) {
+        count <<= 1;
+        log2++;
+    }
+    if (log2_out) *log2_out = log2;
+    return count;
+}
+
+/**
+ * @brief Contiguous shard range owned by NUMA group @p group of @p groups.
+ *
+ * Shards are split as evenly as possible. With more groups than shards,
+ * each group gets the single shard @p group mod @p count.
+ *
+ * @param count   Shard count.
+ * @param groups  Number of groups (NUMA nodes in use); 0 is treated as 1.
+ * @param group   Group index in [0, groups).
+ * @param lo      Output: first shard of the range.
+ * @param hi      Output: one past the last shard of the range.
+ */
+static inline void ttak_shard_group_range(size_t count, size_t groups, size_t group,
+                                          size_t *lo, size_t *hi)
+{
+    if (groups == 0) groups = 1;
+    if (groups > count) {
+        *lo = group % count;
+        *hi = *lo + 1U;
+        return;
+    }
+    *lo = group * count / groups;
+    *hi = (group + 1U) * count / groups;
+}
+
+/**
+ * @brief Fill @p route with the cyclic Latin square of order @p count.
+ *
+ * Entry (r, c) = (r + c) mod count, the same construction as
+ * shard_route_table, so every shard appears once per row and column.
+ *
+ * @param route       Output table of count × count entries, row-major.
+ * @param count_log2  Log₂ of the order; at most log₂(TTAK_POOL_SHARD_MAX).
+ */
+static inline void ttak_shard_route_build(uint8_t *route, uint32_t count_log2)
+{
+    const size_t count = (size_t)1 << count_log2;
+    for (size_t r = 0; r < count; r++) {
+        for (size_t c = 0; c < count; c++) {
+            route[(r << count_log2) | c] = (uint8_t)((r + c) & (count - 1U));
+        }
+    }
+}
+
 #endif /* TTAK_INTERNAL_SHARD_MAP_H */
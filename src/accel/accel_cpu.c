@@ -1,4 +1,10 @@
 #include "ttak/ttak_accelerator.h"
+#include <ttak/async/sched.h>
+#include <ttak/math/prime.h>
+#include <ttak/mem/mem.h>
+#include <ttak/thread/pool.h>
+#include <ttak/timing/timing.h>
+#include "../../internal/ttak/factor_internal.h"
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -43,26 +49,6 @@ typedef struct {
     uint64_t r2;
 } ttak_monty64_t;
 
-static const uint16_t k_small_primes[] = {
-    2,  3,  5,  7, 11, 13, 17, 19, 23, 29,
-    31, 37, 41, 43, 47, 53, 59, 61, 67, 71,
-    73, 79, 83, 89, 97,101,103,107,109,113,
-    127,131,137,139,149,151,157,163,167,173,
-    179,181,191,193,197,199,211,223,227,229,
-    233,239,241,251,257,263,269,271,277,281,
-    283,293,307,311,313,317,331,337,347,349,
-    353,359,367,373,379,383,389,397,401,409,
-    419,421,431,433,439,443,449,457,461,463,
-    467,479,487,491,499,503,509,521,523,541,
-    547,557,563,569,571,577,587,593,599,601,
-    607,613,617,619,631,641,643,647,653,659,
-    661,673,677,683,691,701,709,719,727,733,
-    739,743,751,757,761,769,773,787,797,809,
-    811,821,823,827,829,839,853,857,859,863,
-    877,881,883,887,907,911,919,929,937,941,
-    947,953,967,971,977,983,991,997
-};
-
 static inline uint32_t ttak_guard_word(const ttak_accel_config_t *config,
                                        const ttak_accel_batch_item_t *item) {
     uint32_t guard = config->integrity_mask ^ item->mask_seed;
@@ -132,21 +118,12 @@ static uint64_t ttak_monty_compute_inverse(uint64_t n) {
     return ~inv + 1ULL;
 }
 
-/* ---- Compiler-specific 128-bit modular arithmetic ----------------------
+/* ---- Compiler-specific 128-bit Montgomery arithmetic ---------------------
  * MSVC has no __int128; use _umul128/_udiv128 intrinsics instead.
  * GCC/Clang use __uint128_t natively.                                   */
 #ifdef _MSC_VER
 #include <intrin.h>
 
-static inline uint64_t ttak_mulmod_u64(uint64_t a, uint64_t b, uint64_t mod) {
-    uint64_t hi;
-    uint64_t lo = _umul128(a, b, &hi);
-    if (!hi) return lo % mod;
-    uint64_t rem;
-    _udiv128(hi, lo, mod, &rem);
-    return rem;
-}
-
 static void ttak_monty_init(ttak_monty64_t *ctx, uint64_t n) {
     ctx->modulus = n;
     ctx->modulus_inv = ttak_monty_compute_inverse(n);
@@ -166,8 +143,12 @@ static inline uint64_t ttak_monty_reduce(const ttak_monty64_t *ctx,
     uint64_t prod_lo = _umul128(m, ctx->modulus, &prod_hi);
     uint64_t u_lo    = t_lo + prod_lo;
     uint64_t carry   = (u_lo < t_lo) ? 1ULL : 0ULL;
-    uint64_t u_hi    = t_hi + prod_hi + carry;
-    if (u_hi >= ctx->modulus) u_hi -= ctx->modulus;
+    uint64_t u_hi    = t_hi + prod_hi;
+    /* Moduli above 2^63 can carry the sum out of 128 bits. */
+    bool over = u_hi < t_hi;
+    u_hi += carry;
+    over |= u_hi < carry;
+    if (over || u_hi >= ctx->modulus) u_hi -= ctx->modulus;
     return u_hi;
 }
 
@@ -177,10 +158,6 @@ static inline uint64_t ttak_monty_to(const ttak_monty64_t *ctx, uint64_t x) {
     return ttak_monty_reduce(ctx, lo, hi);
 }
 
-static inline uint64_t ttak_monty_from(const ttak_monty64_t *ctx, uint64_t x) {
-    return ttak_monty_reduce(ctx, x, 0ULL);
-}
-
 static inline uint64_t ttak_monty_mul(const ttak_monty64_t *ctx,
                                       uint64_t a, uint64_t b) {
     uint64_t hi;
@@ -190,10 +167,6 @@ static inline uint64_t ttak_monty_mul(const ttak_monty64_t *ctx,
 
 #else /* __SIZEOF_INT128__ available */
 
-static inline uint64_t ttak_mulmod_u64(uint64_t a, uint64_t b, uint64_t mod) {
-    return (uint64_t)(((__uint128_t)a * (__uint128_t)b) % mod);
-}
-
 static void ttak_monty_init(ttak_monty64_t *ctx, uint64_t n) {
     ctx->modulus = n;
     ctx->modulus_inv = ttak_monty_compute_inverse(n);
@@ -206,8 +179,10 @@ static inline uint64_t ttak_monty_reduce(const ttak_monty64_t *ctx,
                                          __uint128_t t) {
     uint64_t m = (uint64_t)t * ctx->modulus_inv;
     __uint128_t u = t + (__uint128_t)m * ctx->modulus;
+    /* Moduli above 2^63 can carry the sum out of 128 bits. */
+    bool over = u < t;
     uint64_t res = (uint64_t)(u >> 64);
-    if (res >= ctx->modulus) {
+    if (over || res >= ctx->modulus) {
         res -= ctx->modulus;
     }
     return res;
@@ -217,10 +192,6 @@ static inline uint64_t ttak_monty_to(const ttak_monty64_t *ctx, uint64_t x) {
     return ttak_monty_reduce(ctx, (__uint128_t)x * ctx->r2);
 }
 
-static inline uint64_t ttak_monty_from(const ttak_monty64_t *ctx, uint64_t x) {
-    return ttak_monty_reduce(ctx, (__uint128_t)x);
-}
-
 static inline uint64_t ttak_monty_mul(const ttak_monty64_t *ctx,
                                       uint64_t a,
                                       uint64_t b) {
@@ -229,102 +200,6 @@ static inline uint64_t ttak_monty_mul(const ttak_monty64_t *ctx,
 
 #endif /* _MSC_VER */
 
-static uint64_t ttak_monty_pow(uint64_t base,
-                               uint64_t exponent,
-                               const ttak_monty64_t *ctx) {
-    uint64_t result = ttak_monty_to(ctx, 1ULL);
-    uint64_t x = ttak_monty_to(ctx, base % ctx->modulus);
-    while (exponent > 0) {
-        if (exponent & 1ULL) {
-            result = ttak_monty_mul(ctx, result, x);
-        }
-        x = ttak_monty_mul(ctx, x, x);
-        exponent >>= 1ULL;
-    }
-    return ttak_monty_from(ctx, result);
-}
-
-static bool ttak_miller_rabin_u64(uint64_t n) {
-    if (n < 2) return false;
-    for (size_t i = 0; i < sizeof(k_small_primes) / sizeof(k_small_primes[0]); ++i) {
-        uint64_t p = k_small_primes[i];
-        if (n == p) return true;
-        if (n % p == 0 && n != p) return false;
-    }
-
-    uint64_t d = n - 1;
-    uint32_t s = 0;
-    while ((d & 1ULL) == 0) {
-        d >>= 1ULL;
-        ++s;
-    }
-
-    ttak_monty64_t monty;
-    ttak_monty_init(&monty, n);
-    static const uint64_t bases[] = {2ULL, 3ULL, 5ULL, 7ULL, 11ULL, 13ULL};
-    for (size_t i = 0; i < sizeof(bases) / sizeof(bases[0]); ++i) {
-        uint64_t a = bases[i] % n;
-        if (a == 0ULL) continue;
-        uint64_t x = ttak_monty_pow(a, d, &monty);
-        if (x == 1ULL || x == n - 1ULL) continue;
-        bool witness = true;
-        for (uint32_t r = 1; r < s; ++r) {
-            x = ttak_mulmod_u64(x, x, n);
-            if (x == n - 1ULL) {
-                witness = false;
-                break;
-            }
-        }
-        if (witness) {
-            return false;
-        }
-    }
-    return true;
-}
-
-static uint64_t ttak_pollard_rho_brent(uint64_t n, ttak_factor_rng_t *rng) {
-    if ((n & 1ULL) == 0ULL) return 2ULL;
-    uint64_t c = ttak_rng_between(rng, 1ULL, n - 1ULL);
-    uint64_t y = ttak_rng_between(rng, 1ULL, n - 1ULL);
-    uint64_t m = 128ULL;
-    uint64_t g = 1ULL;
-    uint64_t r = 1ULL;
-    uint64_t q = 1ULL;
-    uint64_t ys = 0ULL;
-    uint64_t x = 0ULL;
-
-    while (g == 1ULL) {
-        x = y;
-        for (uint64_t i = 0; i < r; ++i) {
-            y = (ttak_mulmod_u64(y, y, n) + c) % n;
-        }
-        uint64_t k = 0ULL;
-        while (k < r && g == 1ULL) {
-            ys = y;
-            uint64_t limit = (m < (r - k)) ? m : (r - k);
-            for (uint64_t i = 0; i < limit; ++i) {
-                y = (ttak_mulmod_u64(y, y, n) + c) % n;
-                uint64_t diff = ttak_abs_diff_u64(x, y);
-                if (diff == 0ULL) continue;
-                q = ttak_mulmod_u64(q, diff, n);
-            }
-            g = ttak_gcd_u64(q, n);
-            k += limit;
-        }
-        r <<= 1ULL;
-    }
-
-    if (g == n) {
-        do {
-            ys = (ttak_mulmod_u64(ys, ys, n) + c) % n;
-            uint64_t diff = ttak_abs_diff_u64(x, ys);
-            g = ttak_gcd_u64(diff, n);
-        } while (g == 1ULL);
-    }
-
-    return g;
-}
-
 static bool ttak_add_factor_slot(uint64_t prime,
                                  ttak_accel_factor_record_t *record) {
     size_t count = record->factor_count;
@@ -352,50 +227,166 @@ static bool ttak_add_factor_slot(uint64_t prime,
     return true;
 }
 
-static bool ttak_factor_recursive(uint64_t n,
-                                  ttak_factor_rng_t *rng,
-                                  ttak_accel_factor_record_t *record) {
-    if (n == 1ULL) return true;
-    if (ttak_miller_rabin_u64(n)) {
-        return ttak_add_factor_slot(n, record);
-    }
+/* Iterations each lane runs between two gcd checks. */
+#define TTAK_RHO_SEGMENT 128
+/* Fresh constants tried on one cofactor before it is recorded unsplit. */
+#define TTAK_RHO_ATTEMPTS 32
+/* Cofactors left after trial division by ttak_prime_small_table() have at most six prime factors. */
+#define TTAK_RHO_PENDING (TTAK_ACCEL_CPU_CHUNK * 8)
 
-    for (int attempt = 0; attempt < 32; ++attempt) {
-        uint64_t factor = ttak_pollard_rho_brent(n, rng);
-        if (factor > 1ULL && factor < n) {
-            if (!ttak_factor_recursive(factor, rng, record)) return false;
-            if (!ttak_factor_recursive(n / factor, rng, record)) return false;
-            return true;
+typedef struct {
+    uint64_t n;
+    uint32_t record;
+    uint32_t attempts;
+    bool composite;     /* Already known composite, so not tested again. */
+} ttak_rho_job_t;
+
+/*
+ * Brent-style rho on TTAK_ACCEL_CPU_LANES independent moduli. Each lane
+ * iterates y = y^2 + c in Montgomery form and multiplies |x - y| into q,
+ * with x refreshed at every power-of-two step. The lanes share no data, so
+ * their multiplications overlap in the pipeline; the lane loop has no
+ * cross-lane dependency for the compiler to vectorize around.
+ */
+typedef struct {
+    ttak_monty64_t monty[TTAK_ACCEL_CPU_LANES];
+    uint64_t x[TTAK_ACCEL_CPU_LANES];
+    uint64_t y[TTAK_ACCEL_CPU_LANES];
+    uint64_t c[TTAK_ACCEL_CPU_LANES];
+    uint64_t q[TTAK_ACCEL_CPU_LANES];
+    uint64_t steps[TTAK_ACCEL_CPU_LANES];
+    uint64_t reset[TTAK_ACCEL_CPU_LANES];
+    ttak_rho_job_t job[TTAK_ACCEL_CPU_LANES];
+    bool active[TTAK_ACCEL_CPU_LANES];
+} ttak_rho_lanes_t;
+
+static void ttak_rho_lane_start(ttak_rho_lanes_t *lanes, size_t l, ttak_rho_job_t job, ttak_factor_rng_t *rng) {
+    uint64_t n = job.n;
+    ttak_monty_init(&lanes->monty[l], n);
+    lanes->y[l] = ttak_rng_between(rng, 1ULL, n - 1ULL);
+    lanes->c[l] = ttak_rng_between(rng, 1ULL, n - 1ULL);
+    lanes->x[l] = lanes->y[l];
+    lanes->q[l] = ttak_monty_to(&lanes->monty[l], 1ULL);
+    lanes->steps[l] = 0;
+    lanes->reset[l] = 1;
+    lanes->job[l] = job;
+    lanes->active[l] = true;
+}
+
+static void ttak_rho_segment(ttak_rho_lanes_t *lanes) {
+    for (size_t it = 0; it < TTAK_RHO_SEGMENT; ++it) {
+        for (size_t l = 0; l < TTAK_ACCEL_CPU_LANES; ++l) {
+            if (!lanes->active[l]) continue;
+            const ttak_monty64_t *m = &lanes->monty[l];
+            uint64_t y = ttak_monty_mul(m, lanes->y[l], lanes->y[l]);
+            uint64_t gap = m->modulus - lanes->c[l];
+            y = (y >= gap) ? y - gap : y + lanes->c[l];
+            lanes->y[l] = y;
+            lanes->q[l] = ttak_monty_mul(m, lanes->q[l], ttak_abs_diff_u64(lanes->x[l], y));
+            if (++lanes->steps[l] == lanes->reset[l]) {
+                lanes->x[l] = y;
+                lanes->reset[l] <<= 1;
+            }
         }
     }
+}
 
-    return ttak_add_factor_slot(n, record);
+static bool ttak_rho_push(ttak_rho_job_t *pending, size_t *count, ttak_rho_job_t job) {
+    if (*count >= TTAK_RHO_PENDING) return false;
+    pending[(*count)++] = job;
+    return true;
 }
 
-static bool ttak_factor_number(uint64_t value,
-                               ttak_factor_rng_t *rng,
-                               ttak_accel_factor_record_t *record) {
-    record->factor_count = 0;
-    memset(record->slots, 0, sizeof(record->slots));
-    if (value <= 1ULL) {
-        return true;
-    }
+/**
+ * @brief Factor @p count values into @p records, running the composite
+ * cofactors of all of them through the rho lanes together.
+ */
+static bool ttak_factor_chunk(const uint8_t *input,
+                              size_t count,
+                              ttak_factor_rng_t *rng,
+                              ttak_accel_factor_record_t *records) {
+    ttak_rho_job_t pending[TTAK_RHO_PENDING];
+    size_t pending_count = 0;
+    uint64_t cofactor[TTAK_ACCEL_CPU_CHUNK];
+    uint32_t cofactor_record[TTAK_ACCEL_CPU_CHUNK];
+    bool cofactor_prime[TTAK_ACCEL_CPU_CHUNK];
+    size_t cofactor_count = 0;
+    size_t small_count = 0;
+    const uint16_t *small = ttak_prime_small_table(&small_count);
 
-    uint64_t n = value;
-    for (size_t i = 0; i < sizeof(k_small_primes) / sizeof(k_small_primes[0]); ++i) {
-        uint64_t p = k_small_primes[i];
-        if (p * p > n) break;
-        while (n % p == 0ULL) {
-            if (!ttak_add_factor_slot(p, record)) return false;
-            n /= p;
+    for (size_t i = 0; i < count; ++i) {
+        ttak_accel_factor_record_t *record = &records[i];
+        memset(record, 0, sizeof(*record));
+        memcpy(&record->value, input + i * sizeof(uint64_t), sizeof(uint64_t));
+        uint64_t n = record->value;
+        if (n <= 1ULL) continue;
+        for (size_t k = 0; k < small_count; ++k) {
+            uint64_t p = small[k];
+            if (p * p > n) break;
+            while (n % p == 0ULL) {
+                if (!ttak_add_factor_slot(p, record)) return false;
+                n /= p;
+            }
         }
+        if (n == 1ULL) continue;
+        cofactor[cofactor_count] = n;
+        cofactor_record[cofactor_count++] = (uint32_t)i;
     }
 
-    if (n == 1ULL) {
-        return true;
+    /* Settle the first cofactors together; only those the rho lanes split are tested one by one. */
+    ttak_is_prime_u64_batch(cofactor, cofactor_count, cofactor_prime);
+    for (size_t k = 0; k < cofactor_count; ++k) {
+        if (cofactor_prime[k]) {
+            if (!ttak_add_factor_slot(cofactor[k], &records[cofactor_record[k]])) return false;
+            continue;
+        }
+        ttak_rho_job_t job = { cofactor[k], cofactor_record[k], 0, true };
+        if (!ttak_rho_push(pending, &pending_count, job)) return false;
     }
 
-    return ttak_factor_recursive(n, rng, record);
+    ttak_rho_lanes_t lanes;
+    memset(lanes.active, 0, sizeof(lanes.active));
+    for (;;) {
+        size_t live = 0;
+        for (size_t l = 0; l < TTAK_ACCEL_CPU_LANES; ++l) {
+            while (!lanes.active[l] && pending_count > 0) {
+                ttak_rho_job_t job = pending[--pending_count];
+                if (!job.composite && ttak_is_prime_u64(job.n)) {
+                    if (!ttak_add_factor_slot(job.n, &records[job.record])) return false;
+                    continue;
+                }
+                ttak_rho_lane_start(&lanes, l, job, rng);
+            }
+            live += lanes.active[l];
+        }
+        if (live == 0) break;
+
+        ttak_rho_segment(&lanes);
+
+        for (size_t l = 0; l < TTAK_ACCEL_CPU_LANES; ++l) {
+            if (!lanes.active[l]) continue;
+            ttak_rho_job_t job = lanes.job[l];
+            uint64_t g = ttak_gcd_u64(lanes.q[l], job.n);
+            if (g == 1ULL) continue;
+            lanes.active[l] = false;
+            if (g == job.n) {
+                /* The cycle closed on both factors at once: retry with a new constant. */
+                job.composite = true;
+                if (++job.attempts >= TTAK_RHO_ATTEMPTS) {
+                    if (!ttak_add_factor_slot(job.n, &records[job.record])) return false;
+                } else if (!ttak_rho_push(pending, &pending_count, job)) {
+                    return false;
+                }
+                continue;
+            }
+            ttak_rho_job_t lo = { g, job.record, 0, false };
+            ttak_rho_job_t hi = { job.n / g, job.record, 0, false };
+            if (!ttak_rho_push(pending, &pending_count, lo) || !ttak_rho_push(pending, &pending_count, hi)) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 static void ttak_finalize_record(ttak_accel_factor_record_t *record,
@@ -433,8 +424,10 @@ static ttak_result_t ttak_finalize_output(const ttak_accel_batch_item_t *item,
     return TTAK_RESULT_OK;
 }
 
-static ttak_result_t ttak_process_item(const ttak_accel_batch_item_t *item,
-                                       const ttak_accel_config_t *config) {
+/**
+ * @brief Check one item's buffers and report how many values it carries.
+ */
+static ttak_result_t ttak_check_item(const ttak_accel_batch_item_t *item, size_t *record_count_out) {
     if (item->input == NULL || item->output == NULL) {
         return TTAK_RESULT_ERR_ARGUMENT;
     }
@@ -457,34 +450,59 @@ static ttak_result_t ttak_process_item(const ttak_accel_batch_item_t *item,
     if (item->output_len < needed) {
         return TTAK_RESULT_ERR_ARGUMENT;
     }
+    *record_count_out = record_count;
+    return TTAK_RESULT_OK;
+}
 
-    uint32_t guard = ttak_guard_word(config, item);
-    uint32_t checksum_seed = ttak_checksum_seed(item);
-    uint8_t *payload = item->output + sizeof(ttak_accel_record_prefix_t);
+/* Batch-wide state for the pool tasks; chunk_start[i] is item i's first chunk. */
+typedef struct {
+    const ttak_accel_batch_item_t *items;
+    const ttak_accel_config_t *config;
+    const size_t *chunk_start;
+    size_t item_count;
+    atomic_int failed;
+} ttak_cpu_batch_t;
+
+static void ttak_cpu_chunk_task(void *arg, size_t index) {
+    ttak_cpu_batch_t *batch = arg;
+    if (atomic_load_explicit(&batch->failed, memory_order_relaxed)) return;
+
+    size_t lo = 0, hi = batch->item_count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (batch->chunk_start[mid] <= index) lo = mid;
+        else hi = mid;
+    }
+    const ttak_accel_batch_item_t *item = &batch->items[lo];
+    size_t record_count = item->input_len / sizeof(uint64_t);
+    size_t first = (index - batch->chunk_start[lo]) * TTAK_ACCEL_CPU_CHUNK;
+    size_t count = record_count - first;
+    if (count > TTAK_ACCEL_CPU_CHUNK) count = TTAK_ACCEL_CPU_CHUNK;
 
+    uint32_t guard = ttak_guard_word(batch->config, item);
+    uint32_t checksum_seed = ttak_checksum_seed(item);
     ttak_factor_rng_t rng = {
-        .state = ((uint64_t)guard << 32) ^ (uint64_t)record_count ^ (uint64_t)(uintptr_t)item->input
+        .state = ((uint64_t)guard << 32) ^ (uint64_t)first ^ (uint64_t)(uintptr_t)item->input
     };
 
-    for (size_t idx = 0; idx < record_count; ++idx) {
-        uint64_t value = 0;
-        memcpy(&value, item->input + idx * sizeof(uint64_t), sizeof(uint64_t));
-
-        ttak_accel_factor_record_t record;
-        memset(&record, 0, sizeof(record));
-        record.value = value;
-        if (!ttak_factor_number(value, &rng, &record)) {
-            return TTAK_RESULT_ERR_EXECUTION;
-        }
-        ttak_finalize_record(&record, checksum_seed, (uint32_t)idx);
-        memcpy(payload + idx * sizeof(ttak_accel_factor_record_t),
-               &record,
+    ttak_accel_factor_record_t records[TTAK_ACCEL_CPU_CHUNK];
+    if (!ttak_factor_chunk(item->input + first * sizeof(uint64_t), count, &rng, records)) {
+        atomic_store_explicit(&batch->failed, 1, memory_order_relaxed);
+        return;
+    }
+    uint8_t *payload = item->output + sizeof(ttak_accel_record_prefix_t);
+    for (size_t i = 0; i < count; ++i) {
+        ttak_finalize_record(&records[i], checksum_seed, (uint32_t)(first + i));
+        memcpy(payload + (first + i) * sizeof(ttak_accel_factor_record_t),
+               &records[i],
                sizeof(ttak_accel_factor_record_t));
     }
-
-    return ttak_finalize_output(item, guard, record_count, checksum_seed);
 }
 
+/**
+ * @brief Factor every value of every item, TTAK_ACCEL_CPU_CHUNK values per
+ * task on async_pool (or on the caller when no pool is running).
+ */
 ttak_result_t ttak_accel_run_cpu(
     const ttak_accel_batch_item_t *items,
     size_t item_count,
@@ -492,27 +510,43 @@ ttak_result_t ttak_accel_run_cpu(
     if (items == NULL || config == NULL) {
         return TTAK_RESULT_ERR_ARGUMENT;
     }
-
-    atomic_size_t cursor = ATOMIC_VAR_INIT(0);
-    size_t tile = config->max_tiles;
-    if (tile == 0 || tile > item_count) {
-        tile = item_count;
+    if (item_count == 0) {
+        return TTAK_RESULT_OK;
     }
 
-    while (true) {
-        size_t start = atomic_fetch_add_explicit(&cursor, tile, memory_order_relaxed);
-        if (start >= item_count) {
-            break;
-        }
-        size_t end = start + tile;
-        if (end > item_count) end = item_count;
-        for (size_t idx = start; idx < end; ++idx) {
-            ttak_result_t status = ttak_process_item(&items[idx], config);
-            if (status != TTAK_RESULT_OK) {
-                return status;
-            }
+    uint64_t now = ttak_get_tick_count();
+    size_t *chunk_start = ttak_mem_alloc_raw((item_count + 1) * sizeof(size_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (chunk_start == NULL) {
+        return TTAK_RESULT_ERR_EXECUTION;
+    }
+    chunk_start[0] = 0;
+    for (size_t idx = 0; idx < item_count; ++idx) {
+        size_t record_count = 0;
+        ttak_result_t status = ttak_check_item(&items[idx], &record_count);
+        if (status != TTAK_RESULT_OK) {
+            ttak_mem_free(chunk_start);
+            return status;
         }
+        chunk_start[idx + 1] = chunk_start[idx] + (record_count + TTAK_ACCEL_CPU_CHUNK - 1) / TTAK_ACCEL_CPU_CHUNK;
     }
 
+    ttak_cpu_batch_t batch = {
+        .items = items,
+        .config = config,
+        .chunk_start = chunk_start,
+        .item_count = item_count
+    };
+    atomic_init(&batch.failed, 0);
+    ttak_factor_parallel_for(ttak_async_pool(), chunk_start[item_count], ttak_cpu_chunk_task, &batch, now);
+    ttak_mem_free(chunk_start);
+    if (atomic_load(&batch.failed)) {
+        return TTAK_RESULT_ERR_EXECUTION;
+    }
+
+    for (size_t idx = 0; idx < item_count; ++idx) {
+        const ttak_accel_batch_item_t *item = &items[idx];
+        ttak_finalize_output(item, ttak_guard_word(config, item), item->input_len / sizeof(uint64_t),
+                             ttak_checksum_seed(item));
+    }
     return TTAK_RESULT_OK;
 }
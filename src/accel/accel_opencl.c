@@ -21,6 +21,9 @@ extern ttak_result_t ttak_accel_run_cpu(
 
 #ifdef ENABLE_OPENCL
 #include <CL/cl.h>
+#include <pthread.h>
+
+#include "../../internal/ttak/opencl_cache.h"
 
 #define TTAK_STR_HELPER(x) #x
 #define TTAK_STR(x) TTAK_STR_HELPER(x)
@@ -425,20 +428,12 @@ static bool ttak_opencl_build(void) {
         return ttak_opencl_mark_failed();
     }
 
-    const char *src = kFactorKernelSrc;
-    size_t len = strlen(kFactorKernelSrc);
-    g_ocl.program = clCreateProgramWithSource(g_ocl.context, 1, &src, &len, &err);
+    g_ocl.program = ttak_opencl_build_cached(g_ocl.context, g_ocl.device, kFactorKernelSrc, &err);
     if (err != CL_SUCCESS || g_ocl.program == NULL) {
         ttak_opencl_release();
         return ttak_opencl_mark_failed();
     }
 
-    err = clBuildProgram(g_ocl.program, 1, &g_ocl.device, NULL, NULL, NULL);
-    if (err != CL_SUCCESS) {
-        ttak_opencl_release();
-        return ttak_opencl_mark_failed();
-    }
-
     g_ocl.kernel = clCreateKernel(g_ocl.program, "factor_kernel", &err);
     if (err != CL_SUCCESS || g_ocl.kernel == NULL) {
         ttak_opencl_release();
@@ -449,150 +444,282 @@ static bool ttak_opencl_build(void) {
     return true;
 }
 
-static ttak_result_t ttak_opencl_process_item(const ttak_accel_batch_item_t *item,
-                                              const ttak_accel_config_t *config) {
+/* Pieces in flight at once; two gives double buffering. */
+#define TTAK_OCL_PIPELINE_DEPTH 2
+
+/* One transfer: values [first, first + count) of one batch item. */
+typedef struct {
+    const ttak_accel_batch_item_t *item;
+    size_t item_index;
+    size_t first;
+    size_t count;
+} ttak_gpu_piece_t;
+
+/*
+ * Persistent per-queue buffers. Each slot owns an in-order queue, pinned
+ * staging (CL_MEM_ALLOC_HOST_PTR buffers mapped once) for one piece in each
+ * direction and the matching device buffers, all sized for
+ * TTAK_ACCEL_GPU_PIECE_VALUES and kept for the life of the process.
+ */
+typedef struct {
+    cl_command_queue queue;
+    cl_mem host_values_buf;
+    cl_mem host_records_buf;
+    cl_mem values_buf;
+    cl_mem records_buf;
+    uint64_t *host_values;
+    ttak_accel_factor_record_t *host_records;
+    cl_event done;
+    ttak_gpu_piece_t piece;
+    bool busy;
+} ttak_opencl_slot_t;
+
+static ttak_opencl_slot_t g_ocl_slots[TTAK_OCL_PIPELINE_DEPTH];
+static bool g_ocl_slots_ready = false;
+static bool g_ocl_slots_failed = false;
+static pthread_mutex_t g_ocl_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void ttak_opencl_slots_release(void) {
+    for (int s = 0; s < TTAK_OCL_PIPELINE_DEPTH; ++s) {
+        ttak_opencl_slot_t *slot = &g_ocl_slots[s];
+        if (slot->queue) {
+            if (slot->host_values) {
+                clEnqueueUnmapMemObject(slot->queue, slot->host_values_buf, slot->host_values, 0, NULL, NULL);
+            }
+            if (slot->host_records) {
+                clEnqueueUnmapMemObject(slot->queue, slot->host_records_buf, slot->host_records, 0, NULL, NULL);
+            }
+            clFinish(slot->queue);
+        }
+        if (slot->records_buf) clReleaseMemObject(slot->records_buf);
+        if (slot->values_buf) clReleaseMemObject(slot->values_buf);
+        if (slot->host_records_buf) clReleaseMemObject(slot->host_records_buf);
+        if (slot->host_values_buf) clReleaseMemObject(slot->host_values_buf);
+        if (slot->queue) clReleaseCommandQueue(slot->queue);
+        memset(slot, 0, sizeof(*slot));
+    }
+    g_ocl_slots_ready = false;
+}
+
+static cl_mem ttak_opencl_pinned(cl_command_queue queue, size_t bytes, void **mapped) {
+    cl_int err = CL_SUCCESS;
+    cl_mem buf = clCreateBuffer(g_ocl.context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, bytes, NULL, &err);
+    if (err != CL_SUCCESS || buf == NULL) {
+        return NULL;
+    }
+    *mapped = clEnqueueMapBuffer(queue, buf, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, bytes, 0, NULL, NULL, &err);
+    if (err != CL_SUCCESS || *mapped == NULL) {
+        *mapped = NULL;
+        clReleaseMemObject(buf);
+        return NULL;
+    }
+    return buf;
+}
+
+static bool ttak_opencl_slots_init(void) {
+    if (g_ocl_slots_ready) return true;
+    if (g_ocl_slots_failed) return false;
+
+    const size_t value_bytes = TTAK_ACCEL_GPU_PIECE_VALUES * sizeof(uint64_t);
+    const size_t record_bytes = TTAK_ACCEL_GPU_PIECE_VALUES * sizeof(ttak_accel_factor_record_t);
+    for (int s = 0; s < TTAK_OCL_PIPELINE_DEPTH; ++s) {
+        ttak_opencl_slot_t *slot = &g_ocl_slots[s];
+        memset(slot, 0, sizeof(*slot));
+        cl_int err = CL_SUCCESS;
+#if defined(CL_TARGET_OPENCL_VERSION) && (CL_TARGET_OPENCL_VERSION >= 200)
+        slot->queue = clCreateCommandQueueWithProperties(g_ocl.context, g_ocl.device, NULL, &err);
+#else
+        slot->queue = clCreateCommandQueue(g_ocl.context, g_ocl.device, 0, &err);
+#endif
+        if (err != CL_SUCCESS || slot->queue == NULL) {
+            slot->queue = NULL;
+            ttak_opencl_slots_release();
+            g_ocl_slots_failed = true;
+            return false;
+        }
+        void *host_values = NULL;
+        void *host_records = NULL;
+        slot->host_values_buf = ttak_opencl_pinned(slot->queue, value_bytes, &host_values);
+        slot->host_records_buf = ttak_opencl_pinned(slot->queue, record_bytes, &host_records);
+        slot->host_values = (uint64_t *)host_values;
+        slot->host_records = (ttak_accel_factor_record_t *)host_records;
+        slot->values_buf = clCreateBuffer(g_ocl.context, CL_MEM_READ_ONLY, value_bytes, NULL, &err);
+        if (err != CL_SUCCESS) slot->values_buf = NULL;
+        slot->records_buf = clCreateBuffer(g_ocl.context, CL_MEM_WRITE_ONLY, record_bytes, NULL, &err);
+        if (err != CL_SUCCESS) slot->records_buf = NULL;
+        if (!slot->host_values_buf || !slot->host_records_buf || !slot->values_buf || !slot->records_buf) {
+            ttak_opencl_slots_release();
+            g_ocl_slots_failed = true;
+            return false;
+        }
+    }
+    g_ocl_slots_ready = true;
+    return true;
+}
+
+/**
+ * @brief Validates one item and returns its value count, or 0 when invalid.
+ */
+static size_t ttak_gpu_check_item(const ttak_accel_batch_item_t *item) {
     if (item->input == NULL || item->output == NULL) {
-        return TTAK_RESULT_ERR_ARGUMENT;
+        return 0;
     }
     if (item->input_len == 0 || (item->input_len % sizeof(uint64_t)) != 0) {
-        return TTAK_RESULT_ERR_ARGUMENT;
+        return 0;
     }
 
     size_t record_count = item->input_len / sizeof(uint64_t);
-    if (record_count == 0 || record_count > UINT32_MAX) {
-        return TTAK_RESULT_ERR_ARGUMENT;
+    if (record_count > UINT32_MAX) {
+        return 0;
     }
     if (record_count > (SIZE_MAX - sizeof(ttak_accel_record_prefix_t)) /
                            sizeof(ttak_accel_factor_record_t)) {
-        return TTAK_RESULT_ERR_ARGUMENT;
+        return 0;
     }
 
-    size_t payload_size = record_count * sizeof(ttak_accel_factor_record_t);
-    size_t needed = sizeof(ttak_accel_record_prefix_t) + payload_size;
+    size_t needed = sizeof(ttak_accel_record_prefix_t) +
+                    record_count * sizeof(ttak_accel_factor_record_t);
     if (item->output_len < needed) {
-        return TTAK_RESULT_ERR_ARGUMENT;
-    }
-
-    uint32_t guard = ttak_guard_word(config, item);
-    uint32_t checksum_seed = ttak_checksum_seed(item);
-
-    size_t value_bytes = record_count * sizeof(uint64_t);
-    uint64_t *host_values = (uint64_t *)malloc(value_bytes);
-    ttak_accel_factor_record_t *host_records =
-        (ttak_accel_factor_record_t *)malloc(payload_size);
-    if (!host_values || !host_records) {
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
+        return 0;
     }
+    return record_count;
+}
 
-    for (size_t idx = 0; idx < record_count; ++idx) {
-        memcpy(&host_values[idx],
-               item->input + idx * sizeof(uint64_t),
-               sizeof(uint64_t));
+/**
+ * @brief Queues upload, kernel and download of @p piece on @p slot's queue.
+ *
+ * Kernel arguments are captured at enqueue time, so one kernel object serves
+ * both queues while g_ocl_lock is held.
+ */
+static bool ttak_opencl_submit(ttak_opencl_slot_t *slot,
+                               const ttak_gpu_piece_t *piece,
+                               const ttak_accel_config_t *config) {
+    const ttak_accel_batch_item_t *item = piece->item;
+    size_t count = piece->count;
+    memcpy(slot->host_values, item->input + piece->first * sizeof(uint64_t), count * sizeof(uint64_t));
+    cl_int err = clEnqueueWriteBuffer(slot->queue, slot->values_buf, CL_FALSE, 0, count * sizeof(uint64_t),
+                                      slot->host_values, 0, NULL, NULL);
+    if (err != CL_SUCCESS) {
+        return false;
     }
 
-    cl_int err = CL_SUCCESS;
-    cl_mem values_buf = clCreateBuffer(g_ocl.context,
-                                       CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                                       value_bytes,
-                                       host_values,
-                                       &err);
-    if (err != CL_SUCCESS || values_buf == NULL) {
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
-    }
-
-    cl_mem records_buf = clCreateBuffer(g_ocl.context,
-                                        CL_MEM_WRITE_ONLY,
-                                        payload_size,
-                                        NULL,
-                                        &err);
-    if (err != CL_SUCCESS || records_buf == NULL) {
-        clReleaseMemObject(values_buf);
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
-    }
-
-    err = clSetKernelArg(g_ocl.kernel, 0, sizeof(cl_mem), &values_buf);
-    err |= clSetKernelArg(g_ocl.kernel, 1, sizeof(cl_mem), &records_buf);
-    cl_ulong count_arg = (cl_ulong)record_count;
+    err = clSetKernelArg(g_ocl.kernel, 0, sizeof(cl_mem), &slot->values_buf);
+    err |= clSetKernelArg(g_ocl.kernel, 1, sizeof(cl_mem), &slot->records_buf);
+    cl_ulong count_arg = (cl_ulong)count;
     err |= clSetKernelArg(g_ocl.kernel, 2, sizeof(cl_ulong), &count_arg);
-    cl_ulong seed_base = ((cl_ulong)guard << 32) ^ (cl_ulong)record_count ^ (cl_ulong)(uintptr_t)item->input;
+    cl_ulong seed_base = ((cl_ulong)ttak_guard_word(config, item) << 32) ^ (cl_ulong)piece->first ^
+                         (cl_ulong)(uintptr_t)item->input;
     err |= clSetKernelArg(g_ocl.kernel, 3, sizeof(cl_ulong), &seed_base);
     if (err != CL_SUCCESS) {
-        clReleaseMemObject(values_buf);
-        clReleaseMemObject(records_buf);
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
+        return false;
     }
 
     size_t local = 64;
-    size_t global = ((record_count + local - 1) / local) * local;
-    err = clEnqueueNDRangeKernel(g_ocl.queue, g_ocl.kernel, 1, NULL, &global, &local, 0, NULL, NULL);
+    size_t global = ((count + local - 1) / local) * local;
+    err = clEnqueueNDRangeKernel(slot->queue, g_ocl.kernel, 1, NULL, &global, &local, 0, NULL, NULL);
     if (err != CL_SUCCESS) {
-        clReleaseMemObject(values_buf);
-        clReleaseMemObject(records_buf);
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
+        return false;
     }
 
-    err = clFinish(g_ocl.queue);
+    err = clEnqueueReadBuffer(slot->queue, slot->records_buf, CL_FALSE, 0,
+                              count * sizeof(ttak_accel_factor_record_t), slot->host_records,
+                              0, NULL, &slot->done);
     if (err != CL_SUCCESS) {
-        clReleaseMemObject(values_buf);
-        clReleaseMemObject(records_buf);
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
-    }
-
-    err = clEnqueueReadBuffer(g_ocl.queue,
-                              records_buf,
-                              CL_TRUE,
-                              0,
-                              payload_size,
-                              host_records,
-                              0,
-                              NULL,
-                              NULL);
-    clReleaseMemObject(values_buf);
-    clReleaseMemObject(records_buf);
-    free(host_values);
+        return false;
+    }
+    /* The piece is queued from here on; the slot must be drained or quiesced. */
+    slot->piece = *piece;
+    slot->busy = true;
+    return clFlush(slot->queue) == CL_SUCCESS;
+}
+
+/**
+ * @brief Waits for @p slot's piece and writes its records into the item.
+ *
+ * Pieces drain in submission order, so the last piece of an item also
+ * writes the item's prefix and masks its payload; @p finished_items then
+ * becomes the number of leading items that are complete.
+ */
+static bool ttak_opencl_drain(ttak_opencl_slot_t *slot,
+                              const ttak_accel_config_t *config,
+                              size_t *finished_items) {
+    slot->busy = false;
+    cl_int err = clWaitForEvents(1, &slot->done);
+    clReleaseEvent(slot->done);
+    slot->done = NULL;
     if (err != CL_SUCCESS) {
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
+        return false;
     }
 
-    for (size_t idx = 0; idx < record_count; ++idx) {
-        ttak_finalize_record(&host_records[idx], checksum_seed, (uint32_t)idx);
-        memcpy(item->output + sizeof(ttak_accel_record_prefix_t) +
-                   idx * sizeof(ttak_accel_factor_record_t),
-               &host_records[idx],
+    const ttak_gpu_piece_t *piece = &slot->piece;
+    const ttak_accel_batch_item_t *item = piece->item;
+    uint32_t checksum_seed = ttak_checksum_seed(item);
+    uint8_t *payload = item->output + sizeof(ttak_accel_record_prefix_t);
+    for (size_t idx = 0; idx < piece->count; ++idx) {
+        size_t ordinal = piece->first + idx;
+        ttak_finalize_record(&slot->host_records[idx], checksum_seed, (uint32_t)ordinal);
+        memcpy(payload + ordinal * sizeof(ttak_accel_factor_record_t),
+               &slot->host_records[idx],
                sizeof(ttak_accel_factor_record_t));
     }
 
-    free(host_records);
-    return ttak_finalize_output(item, guard, record_count, checksum_seed);
+    size_t record_count = item->input_len / sizeof(uint64_t);
+    if (piece->first + piece->count == record_count) {
+        ttak_finalize_output(item, ttak_guard_word(config, item), record_count, checksum_seed);
+        *finished_items = piece->item_index + 1;
+    }
+    return true;
 }
 
-static ttak_result_t ttak_opencl_dispatch(const ttak_accel_batch_item_t *items,
-                                          size_t item_count,
-                                          const ttak_accel_config_t *config) {
-    if (!ttak_opencl_build()) {
-        return TTAK_RESULT_ERR_EXECUTION;
+/**
+ * @brief Streams every item through the slots, overlapping the transfers of
+ * one piece with the kernel of the other.
+ * @return Number of leading items completed; the rest need another backend.
+ */
+static size_t ttak_opencl_pipeline(const ttak_accel_batch_item_t *items,
+                                   size_t item_count,
+                                   const ttak_accel_config_t *config) {
+    size_t finished_items = 0;
+    size_t next_slot = 0;
+    bool ok = true;
+    for (size_t idx = 0; idx < item_count && ok; ++idx) {
+        size_t record_count = items[idx].input_len / sizeof(uint64_t);
+        for (size_t first = 0; first < record_count; first += TTAK_ACCEL_GPU_PIECE_VALUES) {
+            ttak_opencl_slot_t *slot = &g_ocl_slots[next_slot];
+            next_slot = (next_slot + 1) % TTAK_OCL_PIPELINE_DEPTH;
+            if (slot->busy && !ttak_opencl_drain(slot, config, &finished_items)) {
+                ok = false;
+                break;
+            }
+            ttak_gpu_piece_t piece = {
+                .item = &items[idx],
+                .item_index = idx,
+                .first = first,
+                .count = record_count - first
+            };
+            if (piece.count > TTAK_ACCEL_GPU_PIECE_VALUES) piece.count = TTAK_ACCEL_GPU_PIECE_VALUES;
+            if (!ttak_opencl_submit(slot, &piece, config)) {
+                ok = false;
+                break;
+            }
+        }
     }
 
-    for (size_t idx = 0; idx < item_count; ++idx) {
-        ttak_result_t status = ttak_opencl_process_item(&items[idx], config);
-        if (status != TTAK_RESULT_OK) {
-            return ttak_accel_run_cpu(items + idx, item_count - idx, config);
+    for (int k = 0; k < TTAK_OCL_PIPELINE_DEPTH; ++k) {
+        ttak_opencl_slot_t *slot = &g_ocl_slots[(next_slot + k) % TTAK_OCL_PIPELINE_DEPTH];
+        if (ok && slot->busy) {
+            ok = ttak_opencl_drain(slot, config, &finished_items);
+        } else if (slot->queue) {
+            /* Quiesce the queue so its buffers are free for the next batch. */
+            clFinish(slot->queue);
+            if (slot->done) {
+                clReleaseEvent(slot->done);
+                slot->done = NULL;
+            }
+            slot->busy = false;
         }
     }
-    return TTAK_RESULT_OK;
+    return finished_items;
 }
 
 ttak_result_t ttak_accel_run_opencl(
@@ -603,11 +730,30 @@ ttak_result_t ttak_accel_run_opencl(
         return TTAK_RESULT_ERR_ARGUMENT;
     }
 
-    ttak_result_t status = ttak_opencl_dispatch(items, item_count, config);
-    if (status != TTAK_RESULT_OK) {
+    size_t total_values = 0;
+    for (size_t idx = 0; idx < item_count; ++idx) {
+        size_t record_count = ttak_gpu_check_item(&items[idx]);
+        if (record_count == 0) {
+            return TTAK_RESULT_ERR_ARGUMENT;
+        }
+        total_values += record_count;
+    }
+
+    /* A launch plus two transfers costs more than small batches take on the CPU. */
+    if (total_values < TTAK_ACCEL_GPU_MIN_VALUES) {
         return ttak_accel_run_cpu(items, item_count, config);
     }
-    return status;
+
+    size_t finished = 0;
+    pthread_mutex_lock(&g_ocl_lock);
+    if (ttak_opencl_build() && ttak_opencl_slots_init()) {
+        finished = ttak_opencl_pipeline(items, item_count, config);
+    }
+    pthread_mutex_unlock(&g_ocl_lock);
+    if (finished < item_count) {
+        return ttak_accel_run_cpu(items + finished, item_count - finished, config);
+    }
+    return TTAK_RESULT_OK;
 }
 
 #else
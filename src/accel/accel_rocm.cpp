@@ -2,6 +2,7 @@
 
 #ifdef ENABLE_ROCM
 #include <hip/hip_runtime.h>
+#include <mutex>
 #endif
 
 #include <stdint.h>
@@ -443,115 +444,224 @@ __global__ void ttak_hip_factor_kernel(const uint64_t *values,
     records[idx] = record;
 }
 
-static ttak_result_t ttak_hip_process_item(const ttak_accel_batch_item_t *item,
-                                           const ttak_accel_config_t *config) {
+/* Pieces in flight at once; two gives double buffering. */
+#define TTAK_HIP_PIPELINE_DEPTH 2
+
+/* One transfer: values [first, first + count) of one batch item. */
+typedef struct {
+    const ttak_accel_batch_item_t *item;
+    size_t item_index;
+    size_t first;
+    size_t count;
+} ttak_gpu_piece_t;
+
+/*
+ * Persistent per-stream buffers. Each slot owns a stream, pinned staging for
+ * one piece in each direction and the matching device buffers, all sized for
+ * TTAK_ACCEL_GPU_PIECE_VALUES and kept for the life of the process.
+ */
+typedef struct {
+    hipStream_t stream;
+    hipEvent_t done;
+    uint64_t *host_values;
+    ttak_accel_factor_record_t *host_records;
+    uint64_t *device_values;
+    ttak_accel_factor_record_t *device_records;
+    ttak_gpu_piece_t piece;
+    bool busy;
+} ttak_hip_slot_t;
+
+static ttak_hip_slot_t g_hip_slots[TTAK_HIP_PIPELINE_DEPTH];
+static bool g_hip_slots_ready = false;
+static bool g_hip_slots_failed = false;
+static std::mutex g_hip_lock;
+
+static void ttak_hip_slots_release(void) {
+    for (int s = 0; s < TTAK_HIP_PIPELINE_DEPTH; ++s) {
+        ttak_hip_slot_t *slot = &g_hip_slots[s];
+        if (slot->device_records) hipFree(slot->device_records);
+        if (slot->device_values) hipFree(slot->device_values);
+        if (slot->host_records) hipHostFree(slot->host_records);
+        if (slot->host_values) hipHostFree(slot->host_values);
+        if (slot->done) hipEventDestroy(slot->done);
+        if (slot->stream) hipStreamDestroy(slot->stream);
+        memset(slot, 0, sizeof(*slot));
+    }
+    (void)hipGetLastError();
+    g_hip_slots_ready = false;
+}
+
+static bool ttak_hip_slots_init(void) {
+    if (g_hip_slots_ready) return true;
+    if (g_hip_slots_failed) return false;
+
+    const size_t value_bytes = TTAK_ACCEL_GPU_PIECE_VALUES * sizeof(uint64_t);
+    const size_t record_bytes = TTAK_ACCEL_GPU_PIECE_VALUES * sizeof(ttak_accel_factor_record_t);
+    for (int s = 0; s < TTAK_HIP_PIPELINE_DEPTH; ++s) {
+        ttak_hip_slot_t *slot = &g_hip_slots[s];
+        memset(slot, 0, sizeof(*slot));
+        /* Values are only written by the host, so they can bypass its caches. */
+        if (hipStreamCreateWithFlags(&slot->stream, hipStreamNonBlocking) != hipSuccess ||
+            hipEventCreateWithFlags(&slot->done, hipEventDisableTiming) != hipSuccess ||
+            hipHostMalloc((void **)&slot->host_values, value_bytes, hipHostMallocWriteCombined) != hipSuccess ||
+            hipHostMalloc((void **)&slot->host_records, record_bytes, hipHostMallocDefault) != hipSuccess ||
+            hipMalloc((void **)&slot->device_values, value_bytes) != hipSuccess ||
+            hipMalloc((void **)&slot->device_records, record_bytes) != hipSuccess) {
+            ttak_hip_slots_release();
+            g_hip_slots_failed = true;
+            return false;
+        }
+    }
+    g_hip_slots_ready = true;
+    return true;
+}
+
+/**
+ * @brief Validates one item and returns its value count, or 0 when invalid.
+ */
+static size_t ttak_gpu_check_item(const ttak_accel_batch_item_t *item) {
     if (item->input == NULL || item->output == NULL) {
-        return TTAK_RESULT_ERR_ARGUMENT;
+        return 0;
     }
     if (item->input_len == 0 || (item->input_len % sizeof(uint64_t)) != 0) {
-        return TTAK_RESULT_ERR_ARGUMENT;
+        return 0;
     }
 
     size_t record_count = item->input_len / sizeof(uint64_t);
-    if (record_count == 0 || record_count > UINT32_MAX) {
-        return TTAK_RESULT_ERR_ARGUMENT;
+    if (record_count > UINT32_MAX) {
+        return 0;
     }
     if (record_count > (SIZE_MAX - sizeof(ttak_accel_record_prefix_t)) /
                            sizeof(ttak_accel_factor_record_t)) {
-        return TTAK_RESULT_ERR_ARGUMENT;
+        return 0;
     }
 
-    size_t payload_size = record_count * sizeof(ttak_accel_factor_record_t);
-    size_t needed = sizeof(ttak_accel_record_prefix_t) + payload_size;
+    size_t needed = sizeof(ttak_accel_record_prefix_t) +
+                    record_count * sizeof(ttak_accel_factor_record_t);
     if (item->output_len < needed) {
-        return TTAK_RESULT_ERR_ARGUMENT;
+        return 0;
     }
+    return record_count;
+}
 
-    uint32_t guard = ttak_guard_word(config, item);
-    uint32_t checksum_seed = ttak_checksum_seed(item);
-
-    size_t value_bytes = record_count * sizeof(uint64_t);
-    uint64_t *host_values = (uint64_t *)malloc(value_bytes);
-    ttak_accel_factor_record_t *host_records =
-        (ttak_accel_factor_record_t *)malloc(payload_size);
-    if (!host_values || !host_records) {
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
+/**
+ * @brief Queues upload, kernel and download of @p piece on @p slot's stream.
+ */
+static bool ttak_hip_submit(ttak_hip_slot_t *slot,
+                             const ttak_gpu_piece_t *piece,
+                             const ttak_accel_config_t *config) {
+    const ttak_accel_batch_item_t *item = piece->item;
+    size_t count = piece->count;
+    memcpy(slot->host_values, item->input + piece->first * sizeof(uint64_t), count * sizeof(uint64_t));
+    if (hipMemcpyAsync(slot->device_values, slot->host_values, count * sizeof(uint64_t),
+                        hipMemcpyHostToDevice, slot->stream) != hipSuccess) {
+        return false;
+    }
+
+    uint64_t seed_base = ((uint64_t)ttak_guard_word(config, item) << 32) ^ (uint64_t)piece->first ^
+                         (uint64_t)(uintptr_t)item->input;
+    const int threads = 256;
+    const int blocks = (int)((count + threads - 1) / threads);
+    hipLaunchKernelGGL(ttak_hip_factor_kernel, dim3(blocks), dim3(threads), 0, slot->stream,
+                       slot->device_values, slot->device_records, count, seed_base);
+    if (hipGetLastError() != hipSuccess) {
+        return false;
     }
 
-    memcpy(host_values, item->input, value_bytes);
-
-    uint64_t *device_values = NULL;
-    ttak_accel_factor_record_t *device_records = NULL;
-    hipError_t err = hipMalloc((void **)&device_values, value_bytes);
-    if (err != hipSuccess) {
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
+    if (hipMemcpyAsync(slot->host_records, slot->device_records, count * sizeof(ttak_accel_factor_record_t),
+                        hipMemcpyDeviceToHost, slot->stream) != hipSuccess) {
+        return false;
     }
-    err = hipMalloc((void **)&device_records, payload_size);
-    if (err != hipSuccess) {
-        hipFree(device_values);
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
+    if (hipEventRecord(slot->done, slot->stream) != hipSuccess) {
+        return false;
+    }
+    slot->piece = *piece;
+    slot->busy = true;
+    return true;
+}
+
+/**
+ * @brief Waits for @p slot's piece and writes its records into the item.
+ *
+ * Pieces drain in submission order, so the last piece of an item also
+ * writes the item's prefix and masks its payload; @p finished_items then
+ * becomes the number of leading items that are complete.
+ */
+static bool ttak_hip_drain(ttak_hip_slot_t *slot,
+                            const ttak_accel_config_t *config,
+                            size_t *finished_items) {
+    slot->busy = false;
+    if (hipEventSynchronize(slot->done) != hipSuccess) {
+        return false;
+    }
+
+    const ttak_gpu_piece_t *piece = &slot->piece;
+    const ttak_accel_batch_item_t *item = piece->item;
+    uint32_t checksum_seed = ttak_checksum_seed(item);
+    uint8_t *payload = item->output + sizeof(ttak_accel_record_prefix_t);
+    for (size_t idx = 0; idx < piece->count; ++idx) {
+        size_t ordinal = piece->first + idx;
+        ttak_finalize_record(&slot->host_records[idx], checksum_seed, (uint32_t)ordinal);
+        memcpy(payload + ordinal * sizeof(ttak_accel_factor_record_t),
+               &slot->host_records[idx],
+               sizeof(ttak_accel_factor_record_t));
     }
 
-    err = hipMemcpy(device_values, host_values, value_bytes, hipMemcpyHostToDevice);
-    if (err != hipSuccess) {
-        hipFree(device_values);
-        hipFree(device_records);
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
+    size_t record_count = item->input_len / sizeof(uint64_t);
+    if (piece->first + piece->count == record_count) {
+        ttak_finalize_output(item, ttak_guard_word(config, item), record_count, checksum_seed);
+        *finished_items = piece->item_index + 1;
     }
+    return true;
+}
 
-    uint64_t seed_base = ((uint64_t)guard << 32) ^ (uint64_t)record_count ^ (uint64_t)(uintptr_t)item->input;
-    const int threads = 256;
-    const int blocks = (int)((record_count + threads - 1) / threads);
-    hipLaunchKernelGGL(ttak_hip_factor_kernel, dim3(blocks), dim3(threads), 0, 0,
-                       device_values, device_records, record_count, seed_base);
-    err = hipDeviceSynchronize();
-    if (err != hipSuccess) {
-        hipFree(device_values);
-        hipFree(device_records);
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
-    }
-
-    err = hipGetLastError();
-    if (err != hipSuccess) {
-        hipFree(device_values);
-        hipFree(device_records);
-        free(host_values);
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
-    }
-
-    err = hipMemcpy(host_records,
-                    device_records,
-                    payload_size,
-                    hipMemcpyDeviceToHost);
-    hipFree(device_values);
-    hipFree(device_records);
-    free(host_values);
-    if (err != hipSuccess) {
-        free(host_records);
-        return TTAK_RESULT_ERR_EXECUTION;
-    }
-
-    for (size_t idx = 0; idx < record_count; ++idx) {
-        ttak_finalize_record(&host_records[idx], checksum_seed, (uint32_t)idx);
-        memcpy(item->output + sizeof(ttak_accel_record_prefix_t) +
-                   idx * sizeof(ttak_accel_factor_record_t),
-               &host_records[idx],
-               sizeof(ttak_accel_factor_record_t));
+/**
+ * @brief Streams every item through the slots, overlapping the transfers of
+ * one piece with the kernel of the other.
+ * @return Number of leading items completed; the rest need another backend.
+ */
+static size_t ttak_hip_pipeline(const ttak_accel_batch_item_t *items,
+                                 size_t item_count,
+                                 const ttak_accel_config_t *config) {
+    size_t finished_items = 0;
+    size_t next_slot = 0;
+    bool ok = true;
+    for (size_t idx = 0; idx < item_count && ok; ++idx) {
+        size_t record_count = items[idx].input_len / sizeof(uint64_t);
+        for (size_t first = 0; first < record_count; first += TTAK_ACCEL_GPU_PIECE_VALUES) {
+            ttak_hip_slot_t *slot = &g_hip_slots[next_slot];
+            next_slot = (next_slot + 1) % TTAK_HIP_PIPELINE_DEPTH;
+            if (slot->busy && !ttak_hip_drain(slot, config, &finished_items)) {
+                ok = false;
+                break;
+            }
+            ttak_gpu_piece_t piece;
+            piece.item = &items[idx];
+            piece.item_index = idx;
+            piece.first = first;
+            piece.count = record_count - first;
+            if (piece.count > TTAK_ACCEL_GPU_PIECE_VALUES) piece.count = TTAK_ACCEL_GPU_PIECE_VALUES;
+            if (!ttak_hip_submit(slot, &piece, config)) {
+                ok = false;
+                break;
+            }
+        }
     }
 
-    free(host_records);
-    return ttak_finalize_output(item, guard, record_count, checksum_seed);
+    for (int k = 0; k < TTAK_HIP_PIPELINE_DEPTH; ++k) {
+        ttak_hip_slot_t *slot = &g_hip_slots[(next_slot + k) % TTAK_HIP_PIPELINE_DEPTH];
+        if (ok && slot->busy) {
+            ok = ttak_hip_drain(slot, config, &finished_items);
+        } else {
+            /* Quiesce the stream so its buffers are free for the next batch. */
+            slot->busy = false;
+            (void)hipStreamSynchronize(slot->stream);
+        }
+    }
+    if (!ok) {
+        (void)hipGetLastError();
+    }
+    return finished_items;
 }
 
 #endif /* ENABLE_ROCM */
@@ -565,17 +675,30 @@ extern "C" ttak_result_t ttak_accel_run_rocm(
         return TTAK_RESULT_ERR_ARGUMENT;
     }
 
-    if (!ttak_hip_context_ready()) {
+    size_t total_values = 0;
+    for (size_t idx = 0; idx < item_count; ++idx) {
+        size_t record_count = ttak_gpu_check_item(&items[idx]);
+        if (record_count == 0) {
+            return TTAK_RESULT_ERR_ARGUMENT;
+        }
+        total_values += record_count;
+    }
+
+    /* A launch plus two transfers costs more than small batches take on the CPU. */
+    if (total_values < TTAK_ACCEL_GPU_MIN_VALUES || !ttak_hip_context_ready()) {
         return ttak_accel_run_cpu(items, item_count, config);
     }
 
-    for (size_t idx = 0; idx < item_count; ++idx) {
-        ttak_result_t status = ttak_hip_process_item(&items[idx], config);
-        if (status != TTAK_RESULT_OK) {
-            return ttak_accel_run_cpu(items + idx, item_count - idx, config);
+    size_t finished = 0;
+    {
+        std::lock_guard<std::mutex> hold(g_hip_lock);
+        if (ttak_hip_slots_init()) {
+            finished = ttak_hip_pipeline(items, item_count, config);
         }
     }
-
+    if (finished < item_count) {
+        return ttak_accel_run_cpu(items + finished, item_count - finished, config);
+    }
     return TTAK_RESULT_OK;
 #else
     (void)items;
@@ -1,6 +1,7 @@
 #include <ttak/math/bigint.h>
 
 #include <cuda_runtime.h>
+#include <mutex>
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -47,101 +48,169 @@ __global__ static void ttak_bigint_cuda_mul_kernel(const limb_t *lhs,
     temp[k] = sum;
 }
 
-static bool ttak_bigint_cuda_copy_to_device(const limb_t *src,
-                                            size_t count,
-                                            limb_t **device_ptr) {
-    if (count == 0 || !src) {
-        *device_ptr = NULL;
-        return true;
-    }
-    limb_t *dev = NULL;
-    cudaError_t err = cudaMalloc((void **)&dev, count * sizeof(limb_t));
-    if (err != cudaSuccess) {
-        return false;
-    }
-    err = cudaMemcpy(dev, src, count * sizeof(limb_t), cudaMemcpyHostToDevice);
-    if (err != cudaSuccess) {
-        cudaFree(dev);
+/* Device buffers kept for the life of the process, each grown to the
+ * largest request seen; g_bigint_cuda_lock serializes their users. */
+typedef struct {
+    void *ptr;
+    size_t bytes;
+} ttak_bigint_cuda_buf_t;
+
+typedef struct {
+    ttak_bigint_cuda_buf_t lhs;
+    ttak_bigint_cuda_buf_t rhs;
+    ttak_bigint_cuda_buf_t temp;
+    void *host;        /* Pinned staging for results. */
+    size_t host_bytes;
+    bool ready;
+} ttak_bigint_cuda_pool_t;
+
+/* First allocation of each pooled buffer; later growth doubles it. */
+#define TTAK_BIGINT_CUDA_POOL_MIN_BYTES 65536
+
+static ttak_bigint_cuda_pool_t g_bigint_cuda;
+static std::mutex g_bigint_cuda_lock;
+
+static size_t ttak_bigint_cuda_grow(size_t have, size_t need) {
+    size_t want = have ? have : TTAK_BIGINT_CUDA_POOL_MIN_BYTES;
+    while (want < need) want *= 2;
+    return want;
+}
+
+static bool ttak_bigint_cuda_reserve(ttak_bigint_cuda_buf_t *buf, size_t bytes) {
+    if (buf->bytes >= bytes) return true;
+    size_t want = ttak_bigint_cuda_grow(buf->bytes, bytes);
+    void *ptr = NULL;
+    if (cudaMalloc(&ptr, want) != cudaSuccess) {
+        (void)cudaGetLastError();
         return false;
     }
-    *device_ptr = dev;
+    if (buf->ptr) cudaFree(buf->ptr);
+    buf->ptr = ptr;
+    buf->bytes = want;
     return true;
 }
 
-static void ttak_bigint_cuda_free_all(limb_t *lhs,
-                                      limb_t *rhs,
-                                      void *tmp) {
-    if (lhs) cudaFree(lhs);
-    if (rhs) cudaFree(rhs);
-    if (tmp) cudaFree(tmp);
+static bool ttak_bigint_cuda_reserve_host(size_t bytes) {
+    if (g_bigint_cuda.host_bytes >= bytes) return true;
+    size_t want = ttak_bigint_cuda_grow(g_bigint_cuda.host_bytes, bytes);
+    void *ptr = NULL;
+    if (cudaHostAlloc(&ptr, want, cudaHostAllocDefault) != cudaSuccess) {
+        (void)cudaGetLastError();
+        return false;
+    }
+    if (g_bigint_cuda.host) cudaFreeHost(g_bigint_cuda.host);
+    g_bigint_cuda.host = ptr;
+    g_bigint_cuda.host_bytes = want;
+    return true;
 }
 
-extern "C" bool ttak_bigint_accel_cuda_add(limb_t *dst,
-                                           size_t dst_capacity,
-                                           size_t *out_used,
-                                           const limb_t *lhs,
-                                           size_t lhs_used,
-                                           const limb_t *rhs,
-                                           size_t rhs_used) {
-    size_t max_used = lhs_used > rhs_used ? lhs_used : rhs_used;
-    size_t result_len = max_used + 1;
-    if (dst_capacity < result_len) {
+/* Creates the device context and the pool; the caller holds the lock. */
+static bool ttak_bigint_cuda_ready(void) {
+    if (g_bigint_cuda.ready) return true;
+    /* Touching the runtime creates the primary context up front. */
+    if (cudaFree(0) != cudaSuccess ||
+        !ttak_bigint_cuda_reserve(&g_bigint_cuda.lhs, TTAK_BIGINT_CUDA_POOL_MIN_BYTES) ||
+        !ttak_bigint_cuda_reserve(&g_bigint_cuda.rhs, TTAK_BIGINT_CUDA_POOL_MIN_BYTES) ||
+        !ttak_bigint_cuda_reserve(&g_bigint_cuda.temp, TTAK_BIGINT_CUDA_POOL_MIN_BYTES) ||
+        !ttak_bigint_cuda_reserve_host(TTAK_BIGINT_CUDA_POOL_MIN_BYTES)) {
+        (void)cudaGetLastError();
         return false;
     }
+    g_bigint_cuda.ready = true;
+    return true;
+}
 
-    limb_t *d_lhs = NULL;
-    limb_t *d_rhs = NULL;
-    uint64_t *d_temp = NULL;
-
-    if (!ttak_bigint_cuda_copy_to_device(lhs, lhs_used, &d_lhs)) {
+/* Uploads @p count limbs into @p buf; an empty operand stays NULL on the device. */
+static bool ttak_bigint_cuda_stage(ttak_bigint_cuda_buf_t *buf,
+                                  const limb_t *src,
+                                  size_t count,
+                                  limb_t **device_ptr) {
+    *device_ptr = NULL;
+    if (count == 0 || !src) {
+        return true;
+    }
+    if (!ttak_bigint_cuda_reserve(buf, count * sizeof(limb_t))) {
         return false;
     }
-    if (!ttak_bigint_cuda_copy_to_device(rhs, rhs_used, &d_rhs)) {
-        ttak_bigint_cuda_free_all(d_lhs, NULL, NULL);
+    if (cudaMemcpy(buf->ptr, src, count * sizeof(limb_t), cudaMemcpyHostToDevice) != cudaSuccess) {
         return false;
     }
+    *device_ptr = (limb_t *)buf->ptr;
+    return true;
+}
 
-    cudaError_t err = cudaMalloc((void **)&d_temp, result_len * sizeof(uint64_t));
-    if (err != cudaSuccess) {
-        ttak_bigint_cuda_free_all(d_lhs, d_rhs, NULL);
+/**
+ * @brief Runs the kernel of ttak_bigint_accel_cuda_add/mul on pooled buffers
+ * and copies @p temp_bytes of partial sums back into the pinned staging.
+ */
+static bool ttak_bigint_cuda_run(bool mul,
+                                const limb_t *lhs,
+                                size_t lhs_used,
+                                const limb_t *rhs,
+                                size_t rhs_used,
+                                size_t result_len,
+                                size_t temp_bytes) {
+    limb_t *d_lhs = NULL;
+    limb_t *d_rhs = NULL;
+    if (!ttak_bigint_cuda_ready() ||
+        !ttak_bigint_cuda_stage(&g_bigint_cuda.lhs, lhs, lhs_used, &d_lhs) ||
+        !ttak_bigint_cuda_stage(&g_bigint_cuda.rhs, rhs, rhs_used, &d_rhs) ||
+        !ttak_bigint_cuda_reserve(&g_bigint_cuda.temp, temp_bytes) ||
+        !ttak_bigint_cuda_reserve_host(temp_bytes)) {
         return false;
     }
-    err = cudaMemset(d_temp, 0, result_len * sizeof(uint64_t));
-    if (err != cudaSuccess) {
-        ttak_bigint_cuda_free_all(d_lhs, d_rhs, d_temp);
+    if (cudaMemset(g_bigint_cuda.temp.ptr, 0, temp_bytes) != cudaSuccess) {
         return false;
     }
 
     int threads = 256;
     int blocks = (int)((result_len + threads - 1) / threads);
-    ttak_bigint_cuda_add_kernel<<<blocks, threads>>>(
-        d_lhs, (uint32_t)lhs_used, d_rhs, (uint32_t)rhs_used,
-        d_temp, (uint32_t)result_len);
-    err = cudaDeviceSynchronize();
-    if (err != cudaSuccess) {
-        ttak_bigint_cuda_free_all(d_lhs, d_rhs, d_temp);
+    if (mul) {
+        ttak_bigint_cuda_mul_kernel<<<blocks, threads>>>(
+            d_lhs, (uint32_t)lhs_used, d_rhs, (uint32_t)rhs_used,
+            (ttak_u128_t *)g_bigint_cuda.temp.ptr, (uint32_t)result_len);
+    } else {
+        ttak_bigint_cuda_add_kernel<<<blocks, threads>>>(
+            d_lhs, (uint32_t)lhs_used, d_rhs, (uint32_t)rhs_used,
+            (uint64_t *)g_bigint_cuda.temp.ptr, (uint32_t)result_len);
+    }
+    if (cudaDeviceSynchronize() != cudaSuccess) {
         return false;
     }
+    return cudaMemcpy(g_bigint_cuda.host, g_bigint_cuda.temp.ptr, temp_bytes, cudaMemcpyDeviceToHost) == cudaSuccess;
+}
+
+extern "C" bool ttak_bigint_accel_cuda_warmup(void) {
+    std::lock_guard<std::mutex> hold(g_bigint_cuda_lock);
+    return ttak_bigint_cuda_ready();
+}
 
-    uint64_t *temp = (uint64_t *)malloc(result_len * sizeof(uint64_t));
-    if (!temp) {
-        ttak_bigint_cuda_free_all(d_lhs, d_rhs, d_temp);
+extern "C" bool ttak_bigint_accel_cuda_add(limb_t *dst,
+                                           size_t dst_capacity,
+                                           size_t *out_used,
+                                           const limb_t *lhs,
+                                           size_t lhs_used,
+                                           const limb_t *rhs,
+                                           size_t rhs_used) {
+    size_t max_used = lhs_used > rhs_used ? lhs_used : rhs_used;
+    size_t result_len = max_used + 1;
+    if (dst_capacity < result_len) {
         return false;
     }
-    err = cudaMemcpy(temp, d_temp, result_len * sizeof(uint64_t), cudaMemcpyDeviceToHost);
-    ttak_bigint_cuda_free_all(d_lhs, d_rhs, d_temp);
-    if (err != cudaSuccess) {
-        free(temp);
+
+    std::lock_guard<std::mutex> hold(g_bigint_cuda_lock);
+    if (!ttak_bigint_cuda_run(false, lhs, lhs_used, rhs, rhs_used, result_len,
+                             result_len * sizeof(uint64_t))) {
         return false;
     }
 
+    const uint64_t *temp = (const uint64_t *)g_bigint_cuda.host;
     uint64_t carry = 0;
     for (size_t i = 0; i < result_len; ++i) {
         uint64_t v = temp[i] + carry;
         dst[i] = (limb_t)v;
         carry = v >> 32;
     }
-    free(temp);
 
     size_t used = result_len;
     while (used > 0 && dst[used - 1] == 0) {
@@ -165,58 +234,19 @@ extern "C" bool ttak_bigint_accel_cuda_mul(limb_t *dst,
         return false;
     }
 
-    limb_t *d_lhs = NULL;
-    limb_t *d_rhs = NULL;
-    ttak_u128_t *d_temp = NULL;
-
-    if (!ttak_bigint_cuda_copy_to_device(lhs, lhs_used, &d_lhs)) {
-        return false;
-    }
-    if (!ttak_bigint_cuda_copy_to_device(rhs, rhs_used, &d_rhs)) {
-        ttak_bigint_cuda_free_all(d_lhs, NULL, NULL);
-        return false;
-    }
-    cudaError_t err = cudaMalloc((void **)&d_temp, result_len * sizeof(ttak_u128_t));
-    if (err != cudaSuccess) {
-        ttak_bigint_cuda_free_all(d_lhs, d_rhs, NULL);
-        return false;
-    }
-    err = cudaMemset(d_temp, 0, result_len * sizeof(ttak_u128_t));
-    if (err != cudaSuccess) {
-        ttak_bigint_cuda_free_all(d_lhs, d_rhs, d_temp);
-        return false;
-    }
-
-    int threads = 256;
-    int blocks = (int)((result_len + threads - 1) / threads);
-    ttak_bigint_cuda_mul_kernel<<<blocks, threads>>>(
-        d_lhs, (uint32_t)lhs_used, d_rhs, (uint32_t)rhs_used,
-        d_temp, (uint32_t)result_len);
-    err = cudaDeviceSynchronize();
-    if (err != cudaSuccess) {
-        ttak_bigint_cuda_free_all(d_lhs, d_rhs, d_temp);
-        return false;
-    }
-
-    ttak_u128_t *temp = (ttak_u128_t *)malloc(result_len * sizeof(ttak_u128_t));
-    if (!temp) {
-        ttak_bigint_cuda_free_all(d_lhs, d_rhs, d_temp);
-        return false;
-    }
-    err = cudaMemcpy(temp, d_temp, result_len * sizeof(ttak_u128_t), cudaMemcpyDeviceToHost);
-    ttak_bigint_cuda_free_all(d_lhs, d_rhs, d_temp);
-    if (err != cudaSuccess) {
-        free(temp);
+    std::lock_guard<std::mutex> hold(g_bigint_cuda_lock);
+    if (!ttak_bigint_cuda_run(true, lhs, lhs_used, rhs, rhs_used, result_len,
+                             result_len * sizeof(ttak_u128_t))) {
         return false;
     }
 
+    const ttak_u128_t *temp = (const ttak_u128_t *)g_bigint_cuda.host;
     uint64_t carry = 0;
     for (size_t i = 0; i < result_len; ++i) {
         ttak_u128_t v = ttak_u128_add64(temp[i], carry);
         dst[i] = (limb_t)(ttak_u128_get_lo(v) & 0xFFFFFFFFULL);
         carry = ttak_u128_get_lo(ttak_u128_shr(v, 32));
     }
-    free(temp);
 
     size_t used = result_len;
     while (used > 0 && dst[used - 1] == 0) {
@@ -11,6 +11,7 @@
 #ifdef ENABLE_OPENCL
 
 #include <CL/cl.h>
+#include <pthread.h>
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -18,6 +19,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../../internal/ttak/opencl_cache.h"
+
 typedef struct {
     cl_context context;
     cl_command_queue queue;
@@ -120,20 +123,12 @@ static bool ttak_bigint_opencl_build(void) {
         return false;
     }
 
-    size_t src_len = strlen(kBigIntKernelSrc);
-    const char *src_ptr = kBigIntKernelSrc;
-    g_bigint_ocl.program = clCreateProgramWithSource(g_bigint_ocl.context, 1, &src_ptr, &src_len, &err);
+    g_bigint_ocl.program = ttak_opencl_build_cached(g_bigint_ocl.context, g_bigint_ocl.device, kBigIntKernelSrc, &err);
     if (err != CL_SUCCESS || g_bigint_ocl.program == NULL) {
         ttak_bigint_opencl_release();
         return false;
     }
 
-    err = clBuildProgram(g_bigint_ocl.program, 1, &g_bigint_ocl.device, NULL, NULL, NULL);
-    if (err != CL_SUCCESS) {
-        ttak_bigint_opencl_release();
-        return false;
-    }
-
     g_bigint_ocl.add_kernel = clCreateKernel(g_bigint_ocl.program, "bigint_add", &err);
     if (err != CL_SUCCESS || g_bigint_ocl.add_kernel == NULL) {
         ttak_bigint_opencl_release();
@@ -149,69 +144,113 @@ static bool ttak_bigint_opencl_build(void) {
     return true;
 }
 
-static cl_mem ttak_bigint_opencl_buffer_from_host(const limb_t *src,
-                                                  size_t count,
-                                                  cl_mem_flags flags,
-                                                  cl_int *out_err) {
-    cl_uint zero = 0;
-    size_t bytes = (count > 0) ? (count * sizeof(cl_uint)) : sizeof(cl_uint);
-    const void *host_ptr = (count > 0 && src) ? (const void *)src : (const void *)&zero;
-    return clCreateBuffer(g_bigint_ocl.context,
-                          flags | CL_MEM_COPY_HOST_PTR,
-                          bytes,
-                          (void *)host_ptr,
-                          out_err);
+/* Device buffers kept for the life of the process, each grown to the
+ * largest request seen; g_bigint_ocl_lock serializes their users. */
+typedef struct {
+    cl_mem mem;
+    size_t bytes;
+} ttak_bigint_opencl_buf_t;
+
+typedef struct {
+    ttak_bigint_opencl_buf_t lhs;
+    ttak_bigint_opencl_buf_t rhs;
+    ttak_bigint_opencl_buf_t temp_lo;
+    ttak_bigint_opencl_buf_t temp_hi;
+    cl_ulong *host_lo;
+    cl_ulong *host_hi;
+    size_t host_len;
+} ttak_bigint_opencl_pool_t;
+
+/* First allocation of each pooled buffer; later growth doubles it. */
+#define TTAK_BIGINT_OPENCL_POOL_MIN_BYTES 65536
+
+static ttak_bigint_opencl_pool_t g_bigint_ocl_pool = {0};
+static pthread_mutex_t g_bigint_ocl_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t ttak_bigint_opencl_grow(size_t have, size_t need) {
+    size_t want = have ? have : TTAK_BIGINT_OPENCL_POOL_MIN_BYTES;
+    while (want < need) want *= 2;
+    return want;
 }
 
-static void ttak_bigint_opencl_trim(const limb_t *src, size_t len, size_t *out_used) {
-    size_t used = len;
-    while (used > 0 && src[used - 1] == 0) {
-        --used;
+static bool ttak_bigint_opencl_reserve(ttak_bigint_opencl_buf_t *buf, size_t bytes, cl_mem_flags flags) {
+    if (buf->bytes >= bytes) return true;
+    size_t want = ttak_bigint_opencl_grow(buf->bytes, bytes);
+    cl_int err = CL_SUCCESS;
+    cl_mem mem = clCreateBuffer(g_bigint_ocl.context, flags, want, NULL, &err);
+    if (err != CL_SUCCESS || mem == NULL) {
+        return false;
     }
-    if (out_used) *out_used = used;
+    if (buf->mem) clReleaseMemObject(buf->mem);
+    buf->mem = mem;
+    buf->bytes = want;
+    return true;
 }
 
-bool ttak_bigint_accel_opencl_add(limb_t *dst,
-                                  size_t dst_capacity,
-                                  size_t *out_used,
-                                  const limb_t *lhs,
-                                  size_t lhs_used,
-                                  const limb_t *rhs,
-                                  size_t rhs_used) {
-    if (!ttak_bigint_opencl_build()) return false;
+static bool ttak_bigint_opencl_reserve_host(size_t len) {
+    if (g_bigint_ocl_pool.host_len >= len) return true;
+    size_t want = ttak_bigint_opencl_grow(g_bigint_ocl_pool.host_len * sizeof(cl_ulong), len * sizeof(cl_ulong)) /
+                  sizeof(cl_ulong);
+    cl_ulong *lo = (cl_ulong *)realloc(g_bigint_ocl_pool.host_lo, want * sizeof(cl_ulong));
+    if (lo == NULL) return false;
+    g_bigint_ocl_pool.host_lo = lo;
+    cl_ulong *hi = (cl_ulong *)realloc(g_bigint_ocl_pool.host_hi, want * sizeof(cl_ulong));
+    if (hi == NULL) return false;
+    g_bigint_ocl_pool.host_hi = hi;
+    g_bigint_ocl_pool.host_len = want;
+    return true;
+}
 
-    size_t max_used = lhs_used > rhs_used ? lhs_used : rhs_used;
-    size_t result_len = max_used + 1;
-    if (dst_capacity < result_len) {
+/* Queues the upload of @p count limbs into @p buf; empty operands upload nothing. */
+static bool ttak_bigint_opencl_stage(ttak_bigint_opencl_buf_t *buf, const limb_t *src, size_t count) {
+    size_t bytes = count * sizeof(cl_uint);
+    if (!ttak_bigint_opencl_reserve(buf, bytes ? bytes : sizeof(cl_uint), CL_MEM_READ_ONLY)) {
         return false;
     }
-
-    cl_int err = CL_SUCCESS;
-    cl_mem lhs_buf = ttak_bigint_opencl_buffer_from_host(lhs, lhs_used, CL_MEM_READ_ONLY, &err);
-    if (err != CL_SUCCESS) return false;
-    cl_mem rhs_buf = ttak_bigint_opencl_buffer_from_host(rhs, rhs_used, CL_MEM_READ_ONLY, &err);
-    if (err != CL_SUCCESS) {
-        clReleaseMemObject(lhs_buf);
-        return false;
+    if (count == 0 || src == NULL) {
+        return true;
     }
-    cl_mem temp_buf = clCreateBuffer(g_bigint_ocl.context, CL_MEM_WRITE_ONLY, result_len * sizeof(cl_ulong), NULL, &err);
-    if (err != CL_SUCCESS) {
-        clReleaseMemObject(lhs_buf);
-        clReleaseMemObject(rhs_buf);
+    return clEnqueueWriteBuffer(g_bigint_ocl.queue, buf->mem, CL_FALSE, 0, bytes, src, 0, NULL, NULL) ==
+           CL_SUCCESS;
+}
+
+/**
+ * @brief Runs the add or mul kernel on pooled buffers and reads the
+ * @p result_len partial sums back into the host staging.
+ *
+ * Only the mul kernel fills temp_hi. The caller holds g_bigint_ocl_lock.
+ */
+static bool ttak_bigint_opencl_run(bool mul,
+                                   const limb_t *lhs,
+                                   size_t lhs_used,
+                                   const limb_t *rhs,
+                                   size_t rhs_used,
+                                   size_t result_len) {
+    size_t temp_bytes = result_len * sizeof(cl_ulong);
+    if (!ttak_bigint_opencl_build() ||
+        !ttak_bigint_opencl_stage(&g_bigint_ocl_pool.lhs, lhs, lhs_used) ||
+        !ttak_bigint_opencl_stage(&g_bigint_ocl_pool.rhs, rhs, rhs_used) ||
+        !ttak_bigint_opencl_reserve(&g_bigint_ocl_pool.temp_lo, temp_bytes, CL_MEM_WRITE_ONLY) ||
+        (mul && !ttak_bigint_opencl_reserve(&g_bigint_ocl_pool.temp_hi, temp_bytes, CL_MEM_WRITE_ONLY)) ||
+        !ttak_bigint_opencl_reserve_host(result_len)) {
         return false;
     }
 
-    cl_kernel kernel = g_bigint_ocl.add_kernel;
-    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &lhs_buf);
+    cl_kernel kernel = mul ? g_bigint_ocl.mul_kernel : g_bigint_ocl.add_kernel;
+    cl_int err;
+    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &g_bigint_ocl_pool.lhs.mem);
     err |= clSetKernelArg(kernel, 1, sizeof(cl_uint), &(cl_uint){ (cl_uint)lhs_used });
-    err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &rhs_buf);
+    err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &g_bigint_ocl_pool.rhs.mem);
     err |= clSetKernelArg(kernel, 3, sizeof(cl_uint), &(cl_uint){ (cl_uint)rhs_used });
-    err |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &temp_buf);
-    err |= clSetKernelArg(kernel, 5, sizeof(cl_uint), &(cl_uint){ (cl_uint)result_len });
+    err |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &g_bigint_ocl_pool.temp_lo.mem);
+    if (mul) {
+        err |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &g_bigint_ocl_pool.temp_hi.mem);
+        err |= clSetKernelArg(kernel, 6, sizeof(cl_uint), &(cl_uint){ (cl_uint)result_len });
+    } else {
+        err |= clSetKernelArg(kernel, 5, sizeof(cl_uint), &(cl_uint){ (cl_uint)result_len });
+    }
     if (err != CL_SUCCESS) {
-        clReleaseMemObject(lhs_buf);
-        clReleaseMemObject(rhs_buf);
-        clReleaseMemObject(temp_buf);
+        clFinish(g_bigint_ocl.queue);
         return false;
     }
 
@@ -219,38 +258,69 @@ bool ttak_bigint_accel_opencl_add(limb_t *dst,
     size_t global = ((result_len + local - 1) / local) * local;
     err = clEnqueueNDRangeKernel(g_bigint_ocl.queue, kernel, 1, NULL, &global, &local, 0, NULL, NULL);
     if (err == CL_SUCCESS) {
-        err = clFinish(g_bigint_ocl.queue);
+        err = clEnqueueReadBuffer(g_bigint_ocl.queue, g_bigint_ocl_pool.temp_lo.mem, mul ? CL_FALSE : CL_TRUE, 0,
+                                  temp_bytes, g_bigint_ocl_pool.host_lo, 0, NULL, NULL);
+    }
+    if (err == CL_SUCCESS && mul) {
+        err = clEnqueueReadBuffer(g_bigint_ocl.queue, g_bigint_ocl_pool.temp_hi.mem, CL_TRUE, 0,
+                                  temp_bytes, g_bigint_ocl_pool.host_hi, 0, NULL, NULL);
     }
+    if (err != CL_SUCCESS) {
+        clFinish(g_bigint_ocl.queue);
+        return false;
+    }
+    return true;
+}
 
-    bool ok = (err == CL_SUCCESS);
-    cl_ulong *temp = NULL;
-    if (ok) {
-        temp = (cl_ulong *)malloc(result_len * sizeof(cl_ulong));
-        if (temp) {
-            err = clEnqueueReadBuffer(g_bigint_ocl.queue, temp_buf, CL_TRUE, 0,
-                                      result_len * sizeof(cl_ulong), temp, 0, NULL, NULL);
-            ok = (err == CL_SUCCESS);
-        } else {
-            ok = false;
-        }
+static void ttak_bigint_opencl_trim(const limb_t *src, size_t len, size_t *out_used) {
+    size_t used = len;
+    while (used > 0 && src[used - 1] == 0) {
+        --used;
     }
+    if (out_used) *out_used = used;
+}
 
-    clReleaseMemObject(lhs_buf);
-    clReleaseMemObject(rhs_buf);
-    clReleaseMemObject(temp_buf);
+bool ttak_bigint_accel_opencl_warmup(void) {
+    pthread_mutex_lock(&g_bigint_ocl_lock);
+    bool ok = ttak_bigint_opencl_build() &&
+              ttak_bigint_opencl_reserve(&g_bigint_ocl_pool.lhs, TTAK_BIGINT_OPENCL_POOL_MIN_BYTES, CL_MEM_READ_ONLY) &&
+              ttak_bigint_opencl_reserve(&g_bigint_ocl_pool.rhs, TTAK_BIGINT_OPENCL_POOL_MIN_BYTES, CL_MEM_READ_ONLY) &&
+              ttak_bigint_opencl_reserve(&g_bigint_ocl_pool.temp_lo, TTAK_BIGINT_OPENCL_POOL_MIN_BYTES,
+                                         CL_MEM_WRITE_ONLY) &&
+              ttak_bigint_opencl_reserve(&g_bigint_ocl_pool.temp_hi, TTAK_BIGINT_OPENCL_POOL_MIN_BYTES,
+                                         CL_MEM_WRITE_ONLY) &&
+              ttak_bigint_opencl_reserve_host(TTAK_BIGINT_OPENCL_POOL_MIN_BYTES / sizeof(cl_ulong));
+    pthread_mutex_unlock(&g_bigint_ocl_lock);
+    return ok;
+}
+
+bool ttak_bigint_accel_opencl_add(limb_t *dst,
+                                  size_t dst_capacity,
+                                  size_t *out_used,
+                                  const limb_t *lhs,
+                                  size_t lhs_used,
+                                  const limb_t *rhs,
+                                  size_t rhs_used) {
+    size_t max_used = lhs_used > rhs_used ? lhs_used : rhs_used;
+    size_t result_len = max_used + 1;
+    if (dst_capacity < result_len) {
+        return false;
+    }
 
-    if (!ok) {
-        free(temp);
+    pthread_mutex_lock(&g_bigint_ocl_lock);
+    if (!ttak_bigint_opencl_run(false, lhs, lhs_used, rhs, rhs_used, result_len)) {
+        pthread_mutex_unlock(&g_bigint_ocl_lock);
         return false;
     }
 
+    const cl_ulong *temp = g_bigint_ocl_pool.host_lo;
     cl_ulong carry = 0;
     for (size_t i = 0; i < result_len; ++i) {
         cl_ulong v = temp[i] + carry;
         dst[i] = (limb_t)v;
         carry = v >> 32;
     }
-    free(temp);
+    pthread_mutex_unlock(&g_bigint_ocl_lock);
 
     ttak_bigint_opencl_trim(dst, result_len, out_used);
     return true;
@@ -263,88 +333,19 @@ bool ttak_bigint_accel_opencl_mul(limb_t *dst,
                                   size_t lhs_used,
                                   const limb_t *rhs,
                                   size_t rhs_used) {
-    if (!ttak_bigint_opencl_build()) return false;
     size_t result_len = lhs_used + rhs_used;
     if (result_len == 0 || dst_capacity < result_len) {
         return false;
     }
 
-    cl_int err = CL_SUCCESS;
-    cl_mem lhs_buf = ttak_bigint_opencl_buffer_from_host(lhs, lhs_used, CL_MEM_READ_ONLY, &err);
-    if (err != CL_SUCCESS) return false;
-    cl_mem rhs_buf = ttak_bigint_opencl_buffer_from_host(rhs, rhs_used, CL_MEM_READ_ONLY, &err);
-    if (err != CL_SUCCESS) {
-        clReleaseMemObject(lhs_buf);
-        return false;
-    }
-    cl_mem temp_lo_buf = clCreateBuffer(g_bigint_ocl.context, CL_MEM_WRITE_ONLY, result_len * sizeof(cl_ulong), NULL, &err);
-    if (err != CL_SUCCESS) {
-        clReleaseMemObject(lhs_buf);
-        clReleaseMemObject(rhs_buf);
-        return false;
-    }
-    cl_mem temp_hi_buf = clCreateBuffer(g_bigint_ocl.context, CL_MEM_WRITE_ONLY, result_len * sizeof(cl_ulong), NULL, &err);
-    if (err != CL_SUCCESS) {
-        clReleaseMemObject(lhs_buf);
-        clReleaseMemObject(rhs_buf);
-        clReleaseMemObject(temp_lo_buf);
-        return false;
-    }
-
-    cl_kernel kernel = g_bigint_ocl.mul_kernel;
-    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &lhs_buf);
-    err |= clSetKernelArg(kernel, 1, sizeof(cl_uint), &(cl_uint){ (cl_uint)lhs_used });
-    err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &rhs_buf);
-    err |= clSetKernelArg(kernel, 3, sizeof(cl_uint), &(cl_uint){ (cl_uint)rhs_used });
-    err |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &temp_lo_buf);
-    err |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &temp_hi_buf);
-    err |= clSetKernelArg(kernel, 6, sizeof(cl_uint), &(cl_uint){ (cl_uint)result_len });
-    if (err != CL_SUCCESS) {
-        clReleaseMemObject(lhs_buf);
-        clReleaseMemObject(rhs_buf);
-        clReleaseMemObject(temp_lo_buf);
-        clReleaseMemObject(temp_hi_buf);
-        return false;
-    }
-
-    size_t local = 64;
-    size_t global = ((result_len + local - 1) / local) * local;
-    err = clEnqueueNDRangeKernel(g_bigint_ocl.queue, kernel, 1, NULL, &global, &local, 0, NULL, NULL);
-    if (err == CL_SUCCESS) {
-        err = clFinish(g_bigint_ocl.queue);
-    }
-
-    bool ok = (err == CL_SUCCESS);
-    cl_ulong *temp_lo = NULL;
-    cl_ulong *temp_hi = NULL;
-    if (ok) {
-        temp_lo = (cl_ulong *)malloc(result_len * sizeof(cl_ulong));
-        temp_hi = (cl_ulong *)malloc(result_len * sizeof(cl_ulong));
-        if (temp_lo && temp_hi) {
-            err = clEnqueueReadBuffer(g_bigint_ocl.queue, temp_lo_buf, CL_TRUE, 0,
-                                      result_len * sizeof(cl_ulong), temp_lo, 0, NULL, NULL);
-            ok = (err == CL_SUCCESS);
-            if (ok) {
-                err = clEnqueueReadBuffer(g_bigint_ocl.queue, temp_hi_buf, CL_TRUE, 0,
-                                          result_len * sizeof(cl_ulong), temp_hi, 0, NULL, NULL);
-                ok = (err == CL_SUCCESS);
-            }
-        } else {
-            ok = false;
-        }
-    }
-
-    clReleaseMemObject(lhs_buf);
-    clReleaseMemObject(rhs_buf);
-    clReleaseMemObject(temp_lo_buf);
-    clReleaseMemObject(temp_hi_buf);
-
-    if (!ok) {
-        free(temp_lo);
-        free(temp_hi);
+    pthread_mutex_lock(&g_bigint_ocl_lock);
+    if (!ttak_bigint_opencl_run(true, lhs, lhs_used, rhs, rhs_used, result_len)) {
+        pthread_mutex_unlock(&g_bigint_ocl_lock);
         return false;
     }
 
+    const cl_ulong *temp_lo = g_bigint_ocl_pool.host_lo;
+    const cl_ulong *temp_hi = g_bigint_ocl_pool.host_hi;
     cl_ulong carry = 0;
     for (size_t i = 0; i < result_len; ++i) {
         cl_ulong lo = temp_lo[i] + carry;
@@ -352,8 +353,7 @@ bool ttak_bigint_accel_opencl_mul(limb_t *dst,
         dst[i] = (limb_t)(lo & 0xFFFFFFFFUL);
         carry = (hi << 32) | (lo >> 32);
     }
-    free(temp_lo);
-    free(temp_hi);
+    pthread_mutex_unlock(&g_bigint_ocl_lock);
 
     ttak_bigint_opencl_trim(dst, result_len, out_used);
     return true;
@@ -11,6 +11,7 @@
 
 #ifdef ENABLE_ROCM
 #include <hip/hip_runtime.h>
+#include <mutex>
 #endif
 
 #include <stdbool.h>
@@ -54,101 +55,169 @@ __global__ static void ttak_bigint_hip_mul_kernel(const limb_t *lhs,
     temp[k] = sum;
 }
 
-static bool ttak_bigint_hip_copy_to_device(const limb_t *src,
-                                           size_t count,
-                                           limb_t **device_ptr) {
-    if (count == 0 || !src) {
-        *device_ptr = NULL;
-        return true;
-    }
-    limb_t *dev = NULL;
-    hipError_t err = hipMalloc((void **)&dev, count * sizeof(limb_t));
-    if (err != hipSuccess) {
-        return false;
-    }
-    err = hipMemcpy(dev, src, count * sizeof(limb_t), hipMemcpyHostToDevice);
-    if (err != hipSuccess) {
-        hipFree(dev);
+/* Device buffers kept for the life of the process, each grown to the
+ * largest request seen; g_bigint_hip_lock serializes their users. */
+typedef struct {
+    void *ptr;
+    size_t bytes;
+} ttak_bigint_hip_buf_t;
+
+typedef struct {
+    ttak_bigint_hip_buf_t lhs;
+    ttak_bigint_hip_buf_t rhs;
+    ttak_bigint_hip_buf_t temp;
+    void *host;        /* Pinned staging for results. */
+    size_t host_bytes;
+    bool ready;
+} ttak_bigint_hip_pool_t;
+
+/* First allocation of each pooled buffer; later growth doubles it. */
+#define TTAK_BIGINT_HIP_POOL_MIN_BYTES 65536
+
+static ttak_bigint_hip_pool_t g_bigint_hip;
+static std::mutex g_bigint_hip_lock;
+
+static size_t ttak_bigint_hip_grow(size_t have, size_t need) {
+    size_t want = have ? have : TTAK_BIGINT_HIP_POOL_MIN_BYTES;
+    while (want < need) want *= 2;
+    return want;
+}
+
+static bool ttak_bigint_hip_reserve(ttak_bigint_hip_buf_t *buf, size_t bytes) {
+    if (buf->bytes >= bytes) return true;
+    size_t want = ttak_bigint_hip_grow(buf->bytes, bytes);
+    void *ptr = NULL;
+    if (hipMalloc(&ptr, want) != hipSuccess) {
+        (void)hipGetLastError();
         return false;
     }
-    *device_ptr = dev;
+    if (buf->ptr) hipFree(buf->ptr);
+    buf->ptr = ptr;
+    buf->bytes = want;
     return true;
 }
 
-static void ttak_bigint_hip_free_all(limb_t *lhs,
-                                     limb_t *rhs,
-                                     void *tmp) {
-    if (lhs) hipFree(lhs);
-    if (rhs) hipFree(rhs);
-    if (tmp) hipFree(tmp);
+static bool ttak_bigint_hip_reserve_host(size_t bytes) {
+    if (g_bigint_hip.host_bytes >= bytes) return true;
+    size_t want = ttak_bigint_hip_grow(g_bigint_hip.host_bytes, bytes);
+    void *ptr = NULL;
+    if (hipHostMalloc(&ptr, want, hipHostMallocDefault) != hipSuccess) {
+        (void)hipGetLastError();
+        return false;
+    }
+    if (g_bigint_hip.host) hipHostFree(g_bigint_hip.host);
+    g_bigint_hip.host = ptr;
+    g_bigint_hip.host_bytes = want;
+    return true;
 }
 
-extern "C" bool ttak_bigint_accel_rocm_add(limb_t *dst,
-                                           size_t dst_capacity,
-                                           size_t *out_used,
-                                           const limb_t *lhs,
-                                           size_t lhs_used,
-                                           const limb_t *rhs,
-                                           size_t rhs_used) {
-    size_t max_used = lhs_used > rhs_used ? lhs_used : rhs_used;
-    size_t result_len = max_used + 1;
-    if (dst_capacity < result_len) {
+/* Creates the device context and the pool; the caller holds the lock. */
+static bool ttak_bigint_hip_ready(void) {
+    if (g_bigint_hip.ready) return true;
+    /* Touching the runtime creates the primary context up front. */
+    if (hipFree(0) != hipSuccess ||
+        !ttak_bigint_hip_reserve(&g_bigint_hip.lhs, TTAK_BIGINT_HIP_POOL_MIN_BYTES) ||
+        !ttak_bigint_hip_reserve(&g_bigint_hip.rhs, TTAK_BIGINT_HIP_POOL_MIN_BYTES) ||
+        !ttak_bigint_hip_reserve(&g_bigint_hip.temp, TTAK_BIGINT_HIP_POOL_MIN_BYTES) ||
+        !ttak_bigint_hip_reserve_host(TTAK_BIGINT_HIP_POOL_MIN_BYTES)) {
+        (void)hipGetLastError();
         return false;
     }
+    g_bigint_hip.ready = true;
+    return true;
+}
 
-    limb_t *d_lhs = NULL;
-    limb_t *d_rhs = NULL;
-    uint64_t *d_temp = NULL;
-
-    if (!ttak_bigint_hip_copy_to_device(lhs, lhs_used, &d_lhs)) {
+/* Uploads @p count limbs into @p buf; an empty operand stays NULL on the device. */
+static bool ttak_bigint_hip_stage(ttak_bigint_hip_buf_t *buf,
+                                  const limb_t *src,
+                                  size_t count,
+                                  limb_t **device_ptr) {
+    *device_ptr = NULL;
+    if (count == 0 || !src) {
+        return true;
+    }
+    if (!ttak_bigint_hip_reserve(buf, count * sizeof(limb_t))) {
         return false;
     }
-    if (!ttak_bigint_hip_copy_to_device(rhs, rhs_used, &d_rhs)) {
-        ttak_bigint_hip_free_all(d_lhs, NULL, NULL);
+    if (hipMemcpy(buf->ptr, src, count * sizeof(limb_t), hipMemcpyHostToDevice) != hipSuccess) {
         return false;
     }
+    *device_ptr = (limb_t *)buf->ptr;
+    return true;
+}
 
-    hipError_t err = hipMalloc((void **)&d_temp, result_len * sizeof(uint64_t));
-    if (err != hipSuccess) {
-        ttak_bigint_hip_free_all(d_lhs, d_rhs, NULL);
+/**
+ * @brief Runs the kernel of ttak_bigint_accel_rocm_add/mul on pooled buffers
+ * and copies @p temp_bytes of partial sums back into the pinned staging.
+ */
+static bool ttak_bigint_hip_run(bool mul,
+                                const limb_t *lhs,
+                                size_t lhs_used,
+                                const limb_t *rhs,
+                                size_t rhs_used,
+                                size_t result_len,
+                                size_t temp_bytes) {
+    limb_t *d_lhs = NULL;
+    limb_t *d_rhs = NULL;
+    if (!ttak_bigint_hip_ready() ||
+        !ttak_bigint_hip_stage(&g_bigint_hip.lhs, lhs, lhs_used, &d_lhs) ||
+        !ttak_bigint_hip_stage(&g_bigint_hip.rhs, rhs, rhs_used, &d_rhs) ||
+        !ttak_bigint_hip_reserve(&g_bigint_hip.temp, temp_bytes) ||
+        !ttak_bigint_hip_reserve_host(temp_bytes)) {
         return false;
     }
-    err = hipMemset(d_temp, 0, result_len * sizeof(uint64_t));
-    if (err != hipSuccess) {
-        ttak_bigint_hip_free_all(d_lhs, d_rhs, d_temp);
+    if (hipMemset(g_bigint_hip.temp.ptr, 0, temp_bytes) != hipSuccess) {
         return false;
     }
 
     int threads = 256;
     int blocks = (int)((result_len + threads - 1) / threads);
-    hipLaunchKernelGGL(ttak_bigint_hip_add_kernel, dim3(blocks), dim3(threads), 0, 0,
-                       d_lhs, (uint32_t)lhs_used, d_rhs, (uint32_t)rhs_used,
-                       d_temp, (uint32_t)result_len);
-    err = hipDeviceSynchronize();
-    if (err != hipSuccess) {
-        ttak_bigint_hip_free_all(d_lhs, d_rhs, d_temp);
+    if (mul) {
+        hipLaunchKernelGGL(ttak_bigint_hip_mul_kernel, dim3(blocks), dim3(threads), 0, 0,
+                           d_lhs, (uint32_t)lhs_used, d_rhs, (uint32_t)rhs_used,
+                           (unsigned __int128 *)g_bigint_hip.temp.ptr, (uint32_t)result_len);
+    } else {
+        hipLaunchKernelGGL(ttak_bigint_hip_add_kernel, dim3(blocks), dim3(threads), 0, 0,
+                           d_lhs, (uint32_t)lhs_used, d_rhs, (uint32_t)rhs_used,
+                           (uint64_t *)g_bigint_hip.temp.ptr, (uint32_t)result_len);
+    }
+    if (hipDeviceSynchronize() != hipSuccess) {
         return false;
     }
+    return hipMemcpy(g_bigint_hip.host, g_bigint_hip.temp.ptr, temp_bytes, hipMemcpyDeviceToHost) == hipSuccess;
+}
 
-    uint64_t *temp = (uint64_t *)malloc(result_len * sizeof(uint64_t));
-    if (!temp) {
-        ttak_bigint_hip_free_all(d_lhs, d_rhs, d_temp);
+extern "C" bool ttak_bigint_accel_rocm_warmup(void) {
+    std::lock_guard<std::mutex> hold(g_bigint_hip_lock);
+    return ttak_bigint_hip_ready();
+}
+
+extern "C" bool ttak_bigint_accel_rocm_add(limb_t *dst,
+                                           size_t dst_capacity,
+                                           size_t *out_used,
+                                           const limb_t *lhs,
+                                           size_t lhs_used,
+                                           const limb_t *rhs,
+                                           size_t rhs_used) {
+    size_t max_used = lhs_used > rhs_used ? lhs_used : rhs_used;
+    size_t result_len = max_used + 1;
+    if (dst_capacity < result_len) {
         return false;
     }
-    err = hipMemcpy(temp, d_temp, result_len * sizeof(uint64_t), hipMemcpyDeviceToHost);
-    ttak_bigint_hip_free_all(d_lhs, d_rhs, d_temp);
-    if (err != hipSuccess) {
-        free(temp);
+
+    std::lock_guard<std::mutex> hold(g_bigint_hip_lock);
+    if (!ttak_bigint_hip_run(false, lhs, lhs_used, rhs, rhs_used, result_len,
+                             result_len * sizeof(uint64_t))) {
         return false;
     }
 
+    const uint64_t *temp = (const uint64_t *)g_bigint_hip.host;
     uint64_t carry = 0;
     for (size_t i = 0; i < result_len; ++i) {
         uint64_t v = temp[i] + carry;
         dst[i] = (limb_t)v;
         carry = v >> 32;
     }
-    free(temp);
 
     size_t used = result_len;
     while (used > 0 && dst[used - 1] == 0) {
@@ -172,58 +241,19 @@ extern "C" bool ttak_bigint_accel_rocm_mul(limb_t *dst,
         return false;
     }
 
-    limb_t *d_lhs = NULL;
-    limb_t *d_rhs = NULL;
-    unsigned __int128 *d_temp = NULL;
-
-    if (!ttak_bigint_hip_copy_to_device(lhs, lhs_used, &d_lhs)) {
-        return false;
-    }
-    if (!ttak_bigint_hip_copy_to_device(rhs, rhs_used, &d_rhs)) {
-        ttak_bigint_hip_free_all(d_lhs, NULL, NULL);
-        return false;
-    }
-    hipError_t err = hipMalloc((void **)&d_temp, result_len * sizeof(unsigned __int128));
-    if (err != hipSuccess) {
-        ttak_bigint_hip_free_all(d_lhs, d_rhs, NULL);
-        return false;
-    }
-    err = hipMemset(d_temp, 0, result_len * sizeof(unsigned __int128));
-    if (err != hipSuccess) {
-        ttak_bigint_hip_free_all(d_lhs, d_rhs, d_temp);
-        return false;
-    }
-
-    int threads = 256;
-    int blocks = (int)((result_len + threads - 1) / threads);
-    hipLaunchKernelGGL(ttak_bigint_hip_mul_kernel, dim3(blocks), dim3(threads), 0, 0,
-                       d_lhs, (uint32_t)lhs_used, d_rhs, (uint32_t)rhs_used,
-                       d_temp, (uint32_t)result_len);
-    err = hipDeviceSynchronize();
-    if (err != hipSuccess) {
-        ttak_bigint_hip_free_all(d_lhs, d_rhs, d_temp);
-        return false;
-    }
-
-    unsigned __int128 *temp = (unsigned __int128 *)malloc(result_len * sizeof(unsigned __int128));
-    if (!temp) {
-        ttak_bigint_hip_free_all(d_lhs, d_rhs, d_temp);
-        return false;
-    }
-    err = hipMemcpy(temp, d_temp, result_len * sizeof(unsigned __int128), hipMemcpyDeviceToHost);
-    ttak_bigint_hip_free_all(d_lhs, d_rhs, d_temp);
-    if (err != hipSuccess) {
-        free(temp);
+    std::lock_guard<std::mutex> hold(g_bigint_hip_lock);
+    if (!ttak_bigint_hip_run(true, lhs, lhs_used, rhs, rhs_used, result_len,
+                             result_len * sizeof(unsigned __int128))) {
         return false;
     }
 
+    const unsigned __int128 *temp = (const unsigned __int128 *)g_bigint_hip.host;
     uint64_t carry = 0;
     for (size_t i = 0; i < result_len; ++i) {
         unsigned __int128 v = temp[i] + carry;
         dst[i] = (limb_t)(uint64_t)(v & 0xFFFFFFFF);
         carry = (uint64_t)(v >> 32);
     }
-    free(temp);
 
     size_t used = result_len;
     while (used > 0 && dst[used - 1] == 0) {
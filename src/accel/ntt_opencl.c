@@ -0,0 +1,255 @@
+/**
+ * @file ntt_opencl.c
+ * @brief OpenCL kernels behind ttak/math/ntt_accel.h.
+ *
+ * Same passes as the CUDA backend: bit reversal, one radix-2 launch per
+ * stage across every row of the batch, then the 1/n scale for inverses.
+ * Device handles given to the dispatcher are cl_mem objects.
+ */
+
+#include <ttak/math/ntt.h>
+
+#ifdef ENABLE_OPENCL
+
+#include <CL/cl.h>
+#include <pthread.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../internal/ttak/opencl_cache.h"
+
+typedef struct {
+    cl_context context;
+    cl_command_queue queue;
+    cl_program program;
+    cl_kernel bitrev;
+    cl_kernel stage;
+    cl_kernel scale;
+    cl_kernel pointwise;
+    cl_device_id device;
+    bool ready;
+} ttak_ntt_opencl_ctx_t;
+
+static ttak_ntt_opencl_ctx_t g_ntt_ocl = {0};
+/* Kernel arguments are shared state, so launches are serialized. */
+static pthread_mutex_t g_ntt_ocl_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *kNttKernelSrc =
+"inline ulong ntt_mont(ulong a, ulong b, ulong mod, ulong inv) {\n"
+"    ulong lo = a * b;\n"
+"    ulong m = lo * inv;\n"
+"    ulong sum = lo + m * mod;\n"
+"    ulong r = mul_hi(a, b) + mul_hi(m, mod) + (sum < lo ? 1UL : 0UL);\n"
+"    return r >= mod ? r - mod : r;\n"
+"}\n"
+"inline ulong ntt_reduce(ulong x, ulong mod) { return x >= mod ? x % mod : x; }\n"
+"__kernel void ntt_bitrev(__global ulong *data, ulong total, uint log_n, ulong mod) {\n"
+"    ulong idx = get_global_id(0);\n"
+"    if (idx >= total) return;\n"
+"    ulong n = 1UL << log_n;\n"
+"    ulong i = idx & (n - 1);\n"
+"    ulong j = 0;\n"
+"    for (uint b = 0; b < log_n; ++b) j |= ((i >> b) & 1UL) << (log_n - 1 - b);\n"
+"    if (i > j) return;\n"
+"    __global ulong *row = data + (idx - i);\n"
+"    ulong a = ntt_reduce(row[i], mod);\n"
+"    ulong c = ntt_reduce(row[j], mod);\n"
+"    row[i] = c;\n"
+"    row[j] = a;\n"
+"}\n"
+"__kernel void ntt_stage(__global ulong *data, __global const ulong *twiddles, ulong tw_base, ulong pairs,\n"
+"                        uint log_n, ulong len, ulong mod, ulong inv) {\n"
+"    ulong idx = get_global_id(0);\n"
+"    if (idx >= pairs) return;\n"
+"    ulong half = 1UL << (log_n - 1);\n"
+"    ulong row = idx / half;\n"
+"    ulong k = idx - row * half;\n"
+"    ulong j = k & (len - 1);\n"
+"    __global ulong *x = data + (row << log_n) + ((k - j) << 1) + j;\n"
+"    ulong u = x[0];\n"
+"    ulong v = ntt_mont(x[len], twiddles[tw_base + len + j], mod, inv);\n"
+"    ulong s = u + v;\n"
+"    x[0] = s >= mod ? s - mod : s;\n"
+"    x[len] = u >= v ? u - v : u + mod - v;\n"
+"}\n"
+"__kernel void ntt_scale(__global ulong *data, ulong total, ulong scale, ulong mod, ulong inv) {\n"
+"    ulong idx = get_global_id(0);\n"
+"    if (idx < total) data[idx] = ntt_mont(data[idx], scale, mod, inv);\n"
+"}\n"
+"__kernel void ntt_pointwise(__global ulong *dst, __global const ulong *lhs, __global const ulong *rhs,\n"
+"                            ulong total, ulong mod, ulong inv, ulong r2) {\n"
+"    ulong idx = get_global_id(0);\n"
+"    if (idx >= total) return;\n"
+"    ulong a = ntt_reduce(lhs[idx], mod);\n"
+"    ulong b = ntt_reduce(rhs[idx], mod);\n"
+"    dst[idx] = ntt_mont(ntt_mont(a, b, mod, inv), r2, mod, inv);\n"
+"}\n";
+
+static void ttak_ntt_opencl_release(void) {
+    if (g_ntt_ocl.bitrev) clReleaseKernel(g_ntt_ocl.bitrev);
+    if (g_ntt_ocl.stage) clReleaseKernel(g_ntt_ocl.stage);
+    if (g_ntt_ocl.scale) clReleaseKernel(g_ntt_ocl.scale);
+    if (g_ntt_ocl.pointwise) clReleaseKernel(g_ntt_ocl.pointwise);
+    if (g_ntt_ocl.program) clReleaseProgram(g_ntt_ocl.program);
+    if (g_ntt_ocl.queue) clReleaseCommandQueue(g_ntt_ocl.queue);
+    if (g_ntt_ocl.context) clReleaseContext(g_ntt_ocl.context);
+    g_ntt_ocl = (ttak_ntt_opencl_ctx_t){0};
+}
+
+/* Creates the context, queue and kernels; the caller holds the lock. */
+static bool ttak_ntt_opencl_ready(void) {
+    if (g_ntt_ocl.ready) return true;
+
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform = NULL;
+    cl_uint platform_count = 0;
+    if (clGetPlatformIDs(1, &platform, &platform_count) != CL_SUCCESS || platform_count == 0) {
+        return false;
+    }
+    cl_uint device_count = 0;
+    err = clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, 1, &g_ntt_ocl.device, &device_count);
+    if (err != CL_SUCCESS) {
+        err = clGetDeviceIDs(platform, CL_DEVICE_TYPE_CPU, 1, &g_ntt_ocl.device, &device_count);
+        if (err != CL_SUCCESS) {
+            return false;
+        }
+    }
+
+    g_ntt_ocl.context = clCreateContext(NULL, 1, &g_ntt_ocl.device, NULL, NULL, &err);
+    if (err != CL_SUCCESS || g_ntt_ocl.context == NULL) {
+        ttak_ntt_opencl_release();
+        return false;
+    }
+#if defined(CL_TARGET_OPENCL_VERSION) && (CL_TARGET_OPENCL_VERSION >= 200)
+    g_ntt_ocl.queue = clCreateCommandQueueWithProperties(g_ntt_ocl.context, g_ntt_ocl.device, NULL, &err);
+#else
+    g_ntt_ocl.queue = clCreateCommandQueue(g_ntt_ocl.context, g_ntt_ocl.device, 0, &err);
+#endif
+    if (err != CL_SUCCESS || g_ntt_ocl.queue == NULL) {
+        ttak_ntt_opencl_release();
+        return false;
+    }
+    g_ntt_ocl.program = ttak_opencl_build_cached(g_ntt_ocl.context, g_ntt_ocl.device, kNttKernelSrc, &err);
+    if (err != CL_SUCCESS || g_ntt_ocl.program == NULL) {
+        ttak_ntt_opencl_release();
+        return false;
+    }
+
+    static const char *names[] = { "ntt_bitrev", "ntt_stage", "ntt_scale", "ntt_pointwise" };
+    cl_kernel *kernels[] = { &g_ntt_ocl.bitrev, &g_ntt_ocl.stage, &g_ntt_ocl.scale, &g_ntt_ocl.pointwise };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        *kernels[i] = clCreateKernel(g_ntt_ocl.program, names[i], &err);
+        if (err != CL_SUCCESS || *kernels[i] == NULL) {
+            ttak_ntt_opencl_release();
+            return false;
+        }
+    }
+    g_ntt_ocl.ready = true;
+    return true;
+}
+
+static bool ttak_ntt_opencl_launch(cl_kernel kernel, uint64_t work) {
+    size_t local = 256;
+    size_t global = (size_t)((work + local - 1) / local) * local;
+    return clEnqueueNDRangeKernel(g_ntt_ocl.queue, kernel, 1, NULL, &global, &local, 0, NULL, NULL) == CL_SUCCESS;
+}
+
+bool ttak_ntt_accel_opencl_alloc(void **dev, size_t bytes) {
+    *dev = NULL;
+    pthread_mutex_lock(&g_ntt_ocl_lock);
+    cl_int err = CL_SUCCESS;
+    cl_mem mem = NULL;
+    if (ttak_ntt_opencl_ready()) {
+        mem = clCreateBuffer(g_ntt_ocl.context, CL_MEM_READ_WRITE, bytes, NULL, &err);
+    }
+    pthread_mutex_unlock(&g_ntt_ocl_lock);
+    if (err != CL_SUCCESS || mem == NULL) return false;
+    *dev = (void *)mem;
+    return true;
+}
+
+void ttak_ntt_accel_opencl_free(void *dev) {
+    if (dev) clReleaseMemObject((cl_mem)dev);
+}
+
+bool ttak_ntt_accel_opencl_write(void *dev, const uint64_t *src, size_t count) {
+    pthread_mutex_lock(&g_ntt_ocl_lock);
+    cl_int err = clEnqueueWriteBuffer(g_ntt_ocl.queue, (cl_mem)dev, CL_TRUE, 0, count * sizeof(uint64_t), src, 0,
+                                      NULL, NULL);
+    pthread_mutex_unlock(&g_ntt_ocl_lock);
+    return err == CL_SUCCESS;
+}
+
+bool ttak_ntt_accel_opencl_read(const void *dev, uint64_t *dst, size_t count) {
+    pthread_mutex_lock(&g_ntt_ocl_lock);
+    cl_int err = clEnqueueReadBuffer(g_ntt_ocl.queue, (cl_mem)dev, CL_TRUE, 0, count * sizeof(uint64_t), dst, 0,
+                                     NULL, NULL);
+    pthread_mutex_unlock(&g_ntt_ocl_lock);
+    return err == CL_SUCCESS;
+}
+
+#define TTAK_NTT_OPENCL_ARG(kernel, index, value) \
+    (clSetKernelArg((kernel), (index), sizeof(value), &(value)) == CL_SUCCESS)
+
+bool ttak_ntt_accel_opencl_transform(void *data, const void *twiddles, size_t n, size_t rows, uint64_t mod,
+                                     uint64_t inv, uint64_t scale, bool inverse) {
+    cl_mem d = (cl_mem)data;
+    cl_mem tw = (cl_mem)twiddles;
+    cl_uint log_n = 0;
+    while (((size_t)1 << log_n) < n) ++log_n;
+    cl_ulong total = (cl_ulong)n * rows;
+    cl_ulong pairs = total / 2;
+    cl_ulong tw_base = inverse ? (cl_ulong)n : 0;
+    cl_ulong m = mod;
+    cl_ulong minv = inv;
+    cl_ulong s = scale;
+
+    pthread_mutex_lock(&g_ntt_ocl_lock);
+    bool ok = ttak_ntt_opencl_ready() &&
+              TTAK_NTT_OPENCL_ARG(g_ntt_ocl.bitrev, 0, d) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.bitrev, 1, total) &&
+              TTAK_NTT_OPENCL_ARG(g_ntt_ocl.bitrev, 2, log_n) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.bitrev, 3, m) &&
+              ttak_ntt_opencl_launch(g_ntt_ocl.bitrev, total);
+    if (ok && n > 1) {
+        ok = TTAK_NTT_OPENCL_ARG(g_ntt_ocl.stage, 0, d) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.stage, 1, tw) &&
+             TTAK_NTT_OPENCL_ARG(g_ntt_ocl.stage, 2, tw_base) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.stage, 3, pairs) &&
+             TTAK_NTT_OPENCL_ARG(g_ntt_ocl.stage, 4, log_n) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.stage, 6, m) &&
+             TTAK_NTT_OPENCL_ARG(g_ntt_ocl.stage, 7, minv);
+        /* The in-order queue runs the stages one after another. */
+        for (cl_ulong len = 1; ok && len < n; len <<= 1) {
+            ok = TTAK_NTT_OPENCL_ARG(g_ntt_ocl.stage, 5, len) && ttak_ntt_opencl_launch(g_ntt_ocl.stage, pairs);
+        }
+    }
+    if (ok && inverse) {
+        ok = TTAK_NTT_OPENCL_ARG(g_ntt_ocl.scale, 0, d) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.scale, 1, total) &&
+             TTAK_NTT_OPENCL_ARG(g_ntt_ocl.scale, 2, s) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.scale, 3, m) &&
+             TTAK_NTT_OPENCL_ARG(g_ntt_ocl.scale, 4, minv) && ttak_ntt_opencl_launch(g_ntt_ocl.scale, total);
+    }
+    ok = ok && clFinish(g_ntt_ocl.queue) == CL_SUCCESS;
+    pthread_mutex_unlock(&g_ntt_ocl_lock);
+    return ok;
+}
+
+bool ttak_ntt_accel_opencl_pointwise(void *dst, const void *lhs, const void *rhs, size_t total, uint64_t mod,
+                                     uint64_t inv, uint64_t r2) {
+    cl_mem d = (cl_mem)dst;
+    cl_mem l = (cl_mem)lhs;
+    cl_mem r = (cl_mem)rhs;
+    cl_ulong count = total;
+    cl_ulong m = mod;
+    cl_ulong minv = inv;
+    cl_ulong mr2 = r2;
+
+    pthread_mutex_lock(&g_ntt_ocl_lock);
+    bool ok = ttak_ntt_opencl_ready() &&
+              TTAK_NTT_OPENCL_ARG(g_ntt_ocl.pointwise, 0, d) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.pointwise, 1, l) &&
+              TTAK_NTT_OPENCL_ARG(g_ntt_ocl.pointwise, 2, r) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.pointwise, 3, count) &&
+              TTAK_NTT_OPENCL_ARG(g_ntt_ocl.pointwise, 4, m) && TTAK_NTT_OPENCL_ARG(g_ntt_ocl.pointwise, 5, minv) &&
+              TTAK_NTT_OPENCL_ARG(g_ntt_ocl.pointwise, 6, mr2) &&
+              ttak_ntt_opencl_launch(g_ntt_ocl.pointwise, count) && clFinish(g_ntt_ocl.queue) == CL_SUCCESS;
+    pthread_mutex_unlock(&g_ntt_ocl_lock);
+    return ok;
+}
+
+#endif /* ENABLE_OPENCL */
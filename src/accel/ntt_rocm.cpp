@@ -0,0 +1,137 @@
+/**
+ * @file ntt_rocm.cpp
+ * @brief ROCm/HIP kernels behind ttak/math/ntt_accel.h.
+ *
+ * Rows are transformed in place by a bit-reversal pass followed by one
+ * radix-2 launch per stage, every launch covering all rows of the batch.
+ * Twiddles arrive in Montgomery form (R = 2^64) so a butterfly multiplies
+ * plain residues by one Montgomery product.
+ */
+
+#include <hip/hip_runtime.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+__device__ static inline uint64_t ttak_ntt_hip_mont(uint64_t a, uint64_t b, uint64_t mod, uint64_t inv) {
+    uint64_t lo = a * b;
+    uint64_t hi = __umul64hi(a, b);
+    uint64_t m = lo * inv;
+    uint64_t mlo = m * mod;
+    uint64_t sum = lo + mlo;
+    uint64_t r = hi + __umul64hi(m, mod) + (sum < lo ? 1u : 0u);
+    return r >= mod ? r - mod : r;
+}
+
+__device__ static inline uint64_t ttak_ntt_hip_reduce(uint64_t x, uint64_t mod) {
+    return x >= mod ? x % mod : x;
+}
+
+__global__ static void ttak_ntt_hip_bitrev_kernel(uint64_t *data, uint64_t total, uint32_t log_n, uint64_t mod) {
+    uint64_t idx = (uint64_t)blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= total) return;
+    uint64_t n = 1ull << log_n;
+    uint64_t i = idx & (n - 1);
+    uint64_t j = log_n ? __brevll(i) >> (64 - log_n) : 0;
+    if (i > j) return;
+    uint64_t *row = data + (idx - i);
+    uint64_t a = ttak_ntt_hip_reduce(row[i], mod);
+    uint64_t b = ttak_ntt_hip_reduce(row[j], mod);
+    row[i] = b;
+    row[j] = a;
+}
+
+__global__ static void ttak_ntt_hip_stage_kernel(uint64_t *data, const uint64_t *twiddles, uint64_t pairs,
+                                                  uint32_t log_n, uint64_t len, uint64_t mod, uint64_t inv) {
+    uint64_t idx = (uint64_t)blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= pairs) return;
+    uint64_t half = 1ull << (log_n - 1);
+    uint64_t row = idx / half;
+    uint64_t k = idx - row * half;
+    uint64_t j = k & (len - 1);
+    uint64_t *x = data + (row << log_n) + ((k - j) << 1) + j;
+    uint64_t u = x[0];
+    uint64_t v = ttak_ntt_hip_mont(x[len], twiddles[len + j], mod, inv);
+    uint64_t s = u + v;
+    x[0] = s >= mod ? s - mod : s;
+    x[len] = u >= v ? u - v : u + mod - v;
+}
+
+__global__ static void ttak_ntt_hip_scale_kernel(uint64_t *data, uint64_t total, uint64_t scale, uint64_t mod,
+                                                  uint64_t inv) {
+    uint64_t idx = (uint64_t)blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx < total) data[idx] = ttak_ntt_hip_mont(data[idx], scale, mod, inv);
+}
+
+__global__ static void ttak_ntt_hip_pointwise_kernel(uint64_t *dst, const uint64_t *lhs, const uint64_t *rhs,
+                                                      uint64_t total, uint64_t mod, uint64_t inv, uint64_t r2) {
+    uint64_t idx = (uint64_t)blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= total) return;
+    uint64_t a = ttak_ntt_hip_reduce(lhs[idx], mod);
+    uint64_t b = ttak_ntt_hip_reduce(rhs[idx], mod);
+    /* (a b R^-1) R^2 R^-1 = a b. */
+    dst[idx] = ttak_ntt_hip_mont(ttak_ntt_hip_mont(a, b, mod, inv), r2, mod, inv);
+}
+
+#define TTAK_NTT_HIP_THREADS 256
+
+static unsigned ttak_ntt_hip_blocks(uint64_t work) {
+    return (unsigned)((work + TTAK_NTT_HIP_THREADS - 1) / TTAK_NTT_HIP_THREADS);
+}
+
+static bool ttak_ntt_hip_finish(void) {
+    if (hipGetLastError() != hipSuccess || hipStreamSynchronize(0) != hipSuccess) {
+        (void)hipGetLastError();
+        return false;
+    }
+    return true;
+}
+
+extern "C" bool ttak_ntt_accel_rocm_alloc(void **dev, size_t bytes) {
+    *dev = NULL;
+    if (hipMalloc(dev, bytes) != hipSuccess) {
+        (void)hipGetLastError();
+        *dev = NULL;
+        return false;
+    }
+    return true;
+}
+
+extern "C" void ttak_ntt_accel_rocm_free(void *dev) {
+    if (dev) hipFree(dev);
+}
+
+extern "C" bool ttak_ntt_accel_rocm_write(void *dev, const uint64_t *src, size_t count) {
+    return hipMemcpy(dev, src, count * sizeof(uint64_t), hipMemcpyHostToDevice) == hipSuccess;
+}
+
+extern "C" bool ttak_ntt_accel_rocm_read(const void *dev, uint64_t *dst, size_t count) {
+    return hipMemcpy(dst, dev, count * sizeof(uint64_t), hipMemcpyDeviceToHost) == hipSuccess;
+}
+
+extern "C" bool ttak_ntt_accel_rocm_transform(void *data, const void *twiddles, size_t n, size_t rows, uint64_t mod,
+                                              uint64_t inv, uint64_t scale, bool inverse) {
+    uint64_t *d = (uint64_t *)data;
+    const uint64_t *tw = (const uint64_t *)twiddles + (inverse ? n : 0);
+    uint32_t log_n = 0;
+    while (((size_t)1 << log_n) < n) ++log_n;
+    uint64_t total = (uint64_t)n * rows;
+    ttak_ntt_hip_bitrev_kernel<<<ttak_ntt_hip_blocks(total), TTAK_NTT_HIP_THREADS>>>(d, total, log_n, mod);
+    for (uint64_t len = 1; len < n; len <<= 1) {
+        ttak_ntt_hip_stage_kernel<<<ttak_ntt_hip_blocks(total / 2), TTAK_NTT_HIP_THREADS>>>(
+            d, tw, total / 2, log_n, len, mod, inv);
+    }
+    if (inverse) {
+        ttak_ntt_hip_scale_kernel<<<ttak_ntt_hip_blocks(total), TTAK_NTT_HIP_THREADS>>>(d, total, scale, mod,
+                                                                                            inv);
+    }
+    return ttak_ntt_hip_finish();
+}
+
+extern "C" bool ttak_ntt_accel_rocm_pointwise(void *dst, const void *lhs, const void *rhs, size_t total,
+                                              uint64_t mod, uint64_t inv, uint64_t r2) {
+    ttak_ntt_hip_pointwise_kernel<<<ttak_ntt_hip_blocks(total), TTAK_NTT_HIP_THREADS>>>(
+        (uint64_t *)dst, (const uint64_t *)lhs, (const uint64_t *)rhs, total, mod, inv, r2);
+    return ttak_ntt_hip_finish();
+}
@@ -0,0 +1,130 @@
+/**
+ * @file opencl_cache.c
+ * @brief Persists built OpenCL program binaries between processes.
+ *
+ * Compiling the kernels from source costs tens to hundreds of milliseconds
+ * per process, which dominates short runs. The first build on a machine
+ * stores the device binary; later processes load it with
+ * clCreateProgramWithBinary and fall back to source when it no longer loads.
+ */
+
+#include "../../internal/ttak/opencl_cache.h"
+
+#include "../../internal/ttak/accel_cache.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/* Cached binaries above this size are treated as corrupt. */
+#define TTAK_OPENCL_CACHE_MAX_BYTES (64u << 20)
+
+static uint64_t ttak_opencl_hash_info(uint64_t hash, cl_device_id device, cl_device_info param) {
+    char buf[256];
+    size_t len = 0;
+    if (clGetDeviceInfo(device, param, sizeof(buf), buf, &len) != CL_SUCCESS) {
+        return hash;
+    }
+    if (len > sizeof(buf)) len = sizeof(buf);
+    return ttak_accel_cache_hash(hash, buf, len);
+}
+
+static unsigned char *ttak_opencl_cache_read(const char *path, size_t *len_out) {
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) return NULL;
+    unsigned char *data = NULL;
+    long size = 0;
+    if (fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) > 0 && size <= (long)TTAK_OPENCL_CACHE_MAX_BYTES &&
+        fseek(fp, 0, SEEK_SET) == 0) {
+        data = (unsigned char *)malloc((size_t)size);
+        if (data != NULL && fread(data, 1, (size_t)size, fp) != (size_t)size) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(fp);
+    *len_out = (size_t)size;
+    return data;
+}
+
+/* Stores the program's binary under a temporary name and renames it into
+ * place, so a concurrent reader never sees a partial file. */
+static void ttak_opencl_cache_write(const char *path, cl_program program) {
+    size_t size = 0;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size), &size, NULL) != CL_SUCCESS ||
+        size == 0 || size > TTAK_OPENCL_CACHE_MAX_BYTES) {
+        return;
+    }
+    unsigned char *data = (unsigned char *)malloc(size);
+    if (data == NULL) return;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(data), &data, NULL) == CL_SUCCESS) {
+        char tmp[1100];
+        if (snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long)getpid()) < (int)sizeof(tmp)) {
+            FILE *fp = fopen(tmp, "wb");
+            if (fp != NULL) {
+                int ok = fwrite(data, 1, size, fp) == size;
+                ok &= fclose(fp) == 0;
+                if (!ok || rename(tmp, path) != 0) {
+                    remove(tmp);
+                }
+            }
+        }
+    }
+    free(data);
+}
+
+cl_program ttak_opencl_build_cached(cl_context context, cl_device_id device, const char *src, cl_int *err_out) {
+    cl_int err = CL_SUCCESS;
+    char dir[1024];
+    char path[1100];
+    bool cached = ttak_accel_cache_dir(dir, sizeof(dir));
+    if (cached) {
+        uint64_t key = ttak_accel_cache_hash(0xcbf29ce484222325ULL, src, strlen(src));
+        key = ttak_opencl_hash_info(key, device, CL_DEVICE_NAME);
+        key = ttak_opencl_hash_info(key, device, CL_DEVICE_VERSION);
+        key = ttak_opencl_hash_info(key, device, CL_DRIVER_VERSION);
+        cached = snprintf(path, sizeof(path), "%s/ocl-%016llx.bin", dir, (unsigned long long)key) <
+                 (int)sizeof(path);
+    }
+
+    if (cached) {
+        size_t len = 0;
+        unsigned char *binary = ttak_opencl_cache_read(path, &len);
+        if (binary != NULL) {
+            const unsigned char *bin_ptr = binary;
+            cl_int status = CL_SUCCESS;
+            cl_program program = clCreateProgramWithBinary(context, 1, &device, &len, &bin_ptr, &status, &err);
+            free(binary);
+            if (err == CL_SUCCESS && status == CL_SUCCESS && program != NULL) {
+                if (clBuildProgram(program, 1, &device, NULL, NULL, NULL) == CL_SUCCESS) {
+                    if (err_out) *err_out = CL_SUCCESS;
+                    return program;
+                }
+            }
+            if (program != NULL) clReleaseProgram(program);
+        }
+    }
+
+    size_t src_len = strlen(src);
+    cl_program program = clCreateProgramWithSource(context, 1, &src, &src_len, &err);
+    if (err != CL_SUCCESS || program == NULL) {
+        if (err_out) *err_out = (err != CL_SUCCESS) ? err : CL_INVALID_PROGRAM;
+        return NULL;
+    }
+    err = clBuildProgram(program, 1, &device, NULL, NULL, NULL);
+    if (err != CL_SUCCESS) {
+        clReleaseProgram(program);
+        if (err_out) *err_out = err;
+        return NULL;
+    }
+    if (cached) {
+        ttak_opencl_cache_write(path, program);
+    }
+    if (err_out) *err_out = CL_SUCCESS;
+    return program;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file security_cuda.cu
+ * @brief CUDA ChaCha20 kernel behind internal/ttak/security_accel.h.
+ *
+ * One thread per 64-byte block of the packed batch: it finds its record by
+ * binary search over the records' first blocks and XORs that record's
+ * keystream block into the data in place.
+ */
+
+#include <cuda_runtime.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TTAK_SECURITY_CUDA_RECORD_WORDS 16
+#define TTAK_SECURITY_CUDA_THREADS 256
+
+__device__ static inline uint32_t ttak_security_cuda_rotl(uint32_t v, int n) {
+    return (v << n) | (v >> (32 - n));
+}
+
+#define TTAK_SECURITY_CUDA_QR(a, b, c, d)                                          \
+    do {                                                                           \
+        a += b; d = ttak_security_cuda_rotl(d ^ a, 16);                            \
+        c += d; b = ttak_security_cuda_rotl(b ^ c, 12);                            \
+        a += b; d = ttak_security_cuda_rotl(d ^ a, 8);                             \
+        c += d; b = ttak_security_cuda_rotl(b ^ c, 7);                             \
+    } while (0)
+
+__global__ static void ttak_security_cuda_chacha20_kernel(const uint32_t *records, uint32_t record_count,
+                                                          uint32_t *data, uint32_t blocks) {
+    uint32_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= blocks) return;
+    uint32_t lo = 0, hi = record_count;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (records[mid * TTAK_SECURITY_CUDA_RECORD_WORDS + 11] <= idx) lo = mid;
+        else hi = mid;
+    }
+    const uint32_t *rec = records + lo * TTAK_SECURITY_CUDA_RECORD_WORDS;
+    uint32_t s[16] = { 0x61707865U, 0x3320646EU, 0x79622D32U, 0x6B206574U,
+                       rec[0], rec[1], rec[2], rec[3], rec[4], rec[5], rec[6], rec[7],
+                       1U + idx - rec[11], rec[8], rec[9], rec[10] };
+    uint32_t x[16];
+    for (int i = 0; i < 16; ++i) x[i] = s[i];
+    for (int i = 0; i < 10; ++i) {
+        TTAK_SECURITY_CUDA_QR(x[0], x[4], x[8], x[12]);
+        TTAK_SECURITY_CUDA_QR(x[1], x[5], x[9], x[13]);
+        TTAK_SECURITY_CUDA_QR(x[2], x[6], x[10], x[14]);
+        TTAK_SECURITY_CUDA_QR(x[3], x[7], x[11], x[15]);
+        TTAK_SECURITY_CUDA_QR(x[0], x[5], x[10], x[15]);
+        TTAK_SECURITY_CUDA_QR(x[1], x[6], x[11], x[12]);
+        TTAK_SECURITY_CUDA_QR(x[2], x[7], x[8], x[13]);
+        TTAK_SECURITY_CUDA_QR(x[3], x[4], x[9], x[14]);
+    }
+    uint32_t *block = data + (size_t)idx * 16;
+    for (int i = 0; i < 16; ++i) block[i] ^= x[i] + s[i];
+}
+
+extern "C" bool ttak_security_accel_cuda_chacha20(const uint32_t *records, size_t record_count, uint8_t *data,
+                                                  size_t blocks) {
+    size_t record_bytes = record_count * TTAK_SECURITY_CUDA_RECORD_WORDS * sizeof(uint32_t);
+    size_t data_bytes = blocks * 64;
+    uint32_t *d_records = NULL;
+    uint32_t *d_data = NULL;
+    bool ok = cudaMalloc((void **)&d_records, record_bytes) == cudaSuccess &&
+              cudaMalloc((void **)&d_data, data_bytes) == cudaSuccess &&
+              cudaMemcpy(d_records, records, record_bytes, cudaMemcpyHostToDevice) == cudaSuccess &&
+              cudaMemcpy(d_data, data, data_bytes, cudaMemcpyHostToDevice) == cudaSuccess;
+    if (ok) {
+        unsigned grid = (unsigned)((blocks + TTAK_SECURITY_CUDA_THREADS - 1) / TTAK_SECURITY_CUDA_THREADS);
+        ttak_security_cuda_chacha20_kernel<<<grid, TTAK_SECURITY_CUDA_THREADS>>>(d_records, (uint32_t)record_count,
+                                                                               d_data, (uint32_t)blocks);
+        ok = cudaGetLastError() == cudaSuccess && cudaStreamSynchronize(0) == cudaSuccess &&
+             cudaMemcpy(data, d_data, data_bytes, cudaMemcpyDeviceToHost) == cudaSuccess;
+    }
+    if (!ok) (void)cudaGetLastError();
+    /* The device copies hold keys and plaintext. */
+    if (d_records) {
+        cudaMemset(d_records, 0, record_bytes);
+        cudaFree(d_records);
+    }
+    if (d_data) {
+        cudaMemset(d_data, 0, data_bytes);
+        cudaFree(d_data);
+    }
+    return ok;
+}
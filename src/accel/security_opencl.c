@@ -0,0 +1,166 @@
+/**
+ * @file security_opencl.c
+ * @brief OpenCL ChaCha20 kernel behind internal/ttak/security_accel.h.
+ *
+ * Same layout as the CUDA backend: one work item per 64-byte block, which
+ * looks up its record and XORs that record's keystream into the data.
+ */
+
+#include "../../internal/ttak/security_accel.h"
+
+#ifdef ENABLE_OPENCL
+
+#include <CL/cl.h>
+#include <pthread.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../internal/ttak/opencl_cache.h"
+
+typedef struct {
+    cl_context context;
+    cl_command_queue queue;
+    cl_program program;
+    cl_kernel chacha20;
+    cl_device_id device;
+    bool ready;
+} ttak_security_opencl_ctx_t;
+
+static ttak_security_opencl_ctx_t g_security_ocl = {0};
+/* Kernel arguments are shared state, so launches are serialized. */
+static pthread_mutex_t g_security_ocl_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *kSecurityKernelSrc =
+"#define QR(a, b, c, d) \\\n"
+"    a += b; d = rotate(d ^ a, 16U); c += d; b = rotate(b ^ c, 12U); \\\n"
+"    a += b; d = rotate(d ^ a, 8U); c += d; b = rotate(b ^ c, 7U);\n"
+"__kernel void security_chacha20(__global const uint *records, uint record_count, __global uint *data,\n"
+"                                uint blocks) {\n"
+"    uint idx = (uint)get_global_id(0);\n"
+"    if (idx >= blocks) return;\n"
+"    uint lo = 0, hi = record_count;\n"
+"    while (hi - lo > 1) {\n"
+"        uint mid = lo + (hi - lo) / 2;\n"
+"        if (records[mid * 16 + 11] <= idx) lo = mid; else hi = mid;\n"
+"    }\n"
+"    __global const uint *rec = records + lo * 16;\n"
+"    uint s[16] = { 0x61707865U, 0x3320646EU, 0x79622D32U, 0x6B206574U,\n"
+"                   rec[0], rec[1], rec[2], rec[3], rec[4], rec[5], rec[6], rec[7],\n"
+"                   1U + idx - rec[11], rec[8], rec[9], rec[10] };\n"
+"    uint x[16];\n"
+"    for (int i = 0; i < 16; ++i) x[i] = s[i];\n"
+"    for (int i = 0; i < 10; ++i) {\n"
+"        QR(x[0], x[4], x[8], x[12]) QR(x[1], x[5], x[9], x[13])\n"
+"        QR(x[2], x[6], x[10], x[14]) QR(x[3], x[7], x[11], x[15])\n"
+"        QR(x[0], x[5], x[10], x[15]) QR(x[1], x[6], x[11], x[12])\n"
+"        QR(x[2], x[7], x[8], x[13]) QR(x[3], x[4], x[9], x[14])\n"
+"    }\n"
+"    __global uint *block = data + (ulong)idx * 16;\n"
+"    for (int i = 0; i < 16; ++i) block[i] ^= x[i] + s[i];\n"
+"}\n";
+
+static void ttak_security_opencl_release(void) {
+    if (g_security_ocl.chacha20) clReleaseKernel(g_security_ocl.chacha20);
+    if (g_security_ocl.program) clReleaseProgram(g_security_ocl.program);
+    if (g_security_ocl.queue) clReleaseCommandQueue(g_security_ocl.queue);
+    if (g_security_ocl.context) clReleaseContext(g_security_ocl.context);
+    g_security_ocl = (ttak_security_opencl_ctx_t){0};
+}
+
+/* Creates the context, queue and kernel; the caller holds the lock. */
+static bool ttak_security_opencl_ready(void) {
+    if (g_security_ocl.ready) return true;
+
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform = NULL;
+    cl_uint platform_count = 0;
+    if (clGetPlatformIDs(1, &platform, &platform_count) != CL_SUCCESS || platform_count == 0) {
+        return false;
+    }
+    cl_uint device_count = 0;
+    err = clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, 1, &g_security_ocl.device, &device_count);
+    if (err != CL_SUCCESS) {
+        err = clGetDeviceIDs(platform, CL_DEVICE_TYPE_CPU, 1, &g_security_ocl.device, &device_count);
+        if (err != CL_SUCCESS) {
+            return false;
+        }
+    }
+
+    g_security_ocl.context = clCreateContext(NULL, 1, &g_security_ocl.device, NULL, NULL, &err);
+    if (err != CL_SUCCESS || g_security_ocl.context == NULL) {
+        ttak_security_opencl_release();
+        return false;
+    }
+#if defined(CL_TARGET_OPENCL_VERSION) && (CL_TARGET_OPENCL_VERSION >= 200)
+    g_security_ocl.queue = clCreateCommandQueueWithProperties(g_security_ocl.context, g_security_ocl.device, NULL, &err);
+#else
+    g_security_ocl.queue = clCreateCommandQueue(g_security_ocl.context, g_security_ocl.device, 0, &err);
+#endif
+    if (err != CL_SUCCESS || g_security_ocl.queue == NULL) {
+        ttak_security_opencl_release();
+        return false;
+    }
+    g_security_ocl.program =
+        ttak_opencl_build_cached(g_security_ocl.context, g_security_ocl.device, kSecurityKernelSrc, &err);
+    if (err != CL_SUCCESS || g_security_ocl.program == NULL) {
+        ttak_security_opencl_release();
+        return false;
+    }
+    g_security_ocl.chacha20 = clCreateKernel(g_security_ocl.program, "security_chacha20", &err);
+    if (err != CL_SUCCESS || g_security_ocl.chacha20 == NULL) {
+        ttak_security_opencl_release();
+        return false;
+    }
+    g_security_ocl.ready = true;
+    return true;
+}
+
+#define TTAK_SECURITY_OCL_ARG(kernel, index, value) \
+    (clSetKernelArg((kernel), (index), sizeof(value), &(value)) == CL_SUCCESS)
+
+bool ttak_security_accel_opencl_chacha20(const uint32_t *records, size_t record_count, uint8_t *data,
+                                         size_t blocks) {
+    size_t record_bytes = record_count * TTAK_SECURITY_ACCEL_RECORD_WORDS * sizeof(uint32_t);
+    size_t data_bytes = blocks * 64;
+    bool ok = false;
+    pthread_mutex_lock(&g_security_ocl_lock);
+    if (ttak_security_opencl_ready()) {
+        cl_int err = CL_SUCCESS;
+        cl_mem d_records = clCreateBuffer(g_security_ocl.context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                                          record_bytes, (void *)records, &err);
+        cl_mem d_data = err == CL_SUCCESS ? clCreateBuffer(g_security_ocl.context,
+                                                           CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, data_bytes,
+                                                           data, &err)
+                                          : NULL;
+        if (err == CL_SUCCESS) {
+            cl_uint count32 = (cl_uint)record_count;
+            cl_uint blocks32 = (cl_uint)blocks;
+            cl_kernel k = g_security_ocl.chacha20;
+            size_t local = 256;
+            size_t global = (blocks + local - 1) / local * local;
+            ok = TTAK_SECURITY_OCL_ARG(k, 0, d_records) && TTAK_SECURITY_OCL_ARG(k, 1, count32) &&
+                 TTAK_SECURITY_OCL_ARG(k, 2, d_data) && TTAK_SECURITY_OCL_ARG(k, 3, blocks32) &&
+                 clEnqueueNDRangeKernel(g_security_ocl.queue, k, 1, NULL, &global, &local, 0, NULL, NULL) ==
+                     CL_SUCCESS &&
+                 clEnqueueReadBuffer(g_security_ocl.queue, d_data, CL_TRUE, 0, data_bytes, data, 0, NULL, NULL) ==
+                     CL_SUCCESS;
+        }
+        /* The device copies hold keys and plaintext. */
+        static const cl_uint zero = 0;
+        if (d_records) {
+            clEnqueueFillBuffer(g_security_ocl.queue, d_records, &zero, sizeof(zero), 0, record_bytes, 0, NULL, NULL);
+        }
+        if (d_data) {
+            clEnqueueFillBuffer(g_security_ocl.queue, d_data, &zero, sizeof(zero), 0, data_bytes, 0, NULL, NULL);
+        }
+        clFinish(g_security_ocl.queue);
+        if (d_records) clReleaseMemObject(d_records);
+        if (d_data) clReleaseMemObject(d_data);
+    }
+    pthread_mutex_unlock(&g_security_ocl_lock);
+    return ok;
+}
+
+#endif /* ENABLE_OPENCL */
@@ -1,8 +1,10 @@
 #include "ttak/ttak_accelerator.h"
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdatomic.h>
+#include <ttak/timing/timing.h>
 
 static _Atomic uintptr_t g_backend_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
 static _Atomic ttak_accel_target_t g_backend_target =
@@ -58,12 +60,32 @@ static inline ttak_accel_backend_fn ttak_backend_for_target(
 #else
             break;
 #endif
+        case TTAK_ACCEL_TARGET_HYBRID:
+            /* Handled by ttak_execute_hybrid(); never bound as one backend. */
+            break;
         default:
             break;
     }
     return NULL;
 }
 
+/* Throughput estimates for hybrid batches in bytes per millisecond; 0 until measured. */
+static _Atomic uint64_t g_hybrid_gpu_rate = ATOMIC_VAR_INIT(0);
+static _Atomic uint64_t g_hybrid_cpu_rate = ATOMIC_VAR_INIT(0);
+
+/* First compiled-in GPU backend, in the fallback order below. */
+static ttak_accel_backend_fn ttak_gpu_backend(void) {
+#if defined(ENABLE_CUDA)
+    return ttak_accel_run_cuda;
+#elif defined(ENABLE_ROCM)
+    return ttak_accel_run_rocm;
+#elif defined(ENABLE_OPENCL)
+    return ttak_accel_run_opencl;
+#else
+    return NULL;
+#endif
+}
+
 static ttak_accel_backend_fn ttak_attempt_bind(ttak_accel_target_t requested,
                                                ttak_accel_target_t *bound_target) {
     uintptr_t cached = atomic_load_explicit(&g_backend_ptr, memory_order_acquire);
@@ -123,6 +145,124 @@ static ttak_accel_backend_fn ttak_attempt_bind(ttak_accel_target_t requested,
     return (ttak_accel_backend_fn)expected;
 }
 
+typedef struct {
+    ttak_accel_backend_fn fn;
+    const ttak_accel_batch_item_t *items;
+    size_t item_count;
+    const ttak_accel_config_t *config;
+    ttak_result_t status;
+    uint64_t elapsed_ns;
+} ttak_hybrid_leg_t;
+
+static void ttak_hybrid_run_leg(ttak_hybrid_leg_t *leg) {
+    uint64_t start = ttak_get_tick_count_ns();
+    leg->status = leg->fn(leg->items, leg->item_count, leg->config);
+    leg->elapsed_ns = ttak_get_tick_count_ns() - start;
+}
+
+static void *ttak_hybrid_leg_thread(void *arg) {
+    ttak_hybrid_run_leg(arg);
+    return NULL;
+}
+
+static size_t ttak_items_bytes(const ttak_accel_batch_item_t *items, size_t count) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        bytes += items[i].input_len;
+    }
+    return bytes;
+}
+
+/* Folds one leg's measurement into its estimate with weight 1/4. */
+static void ttak_hybrid_update_rate(_Atomic uint64_t *rate, size_t bytes, uint64_t elapsed_ns) {
+    if (bytes == 0) return;
+    if (elapsed_ns == 0) elapsed_ns = 1;
+    uint64_t sample = (uint64_t)bytes * 1000000ULL / elapsed_ns;
+    if (sample == 0) sample = 1;
+    uint64_t old = atomic_load_explicit(rate, memory_order_relaxed);
+    uint64_t next = (old == 0) ? sample : old - old / 4 + sample / 4;
+    atomic_store_explicit(rate, next, memory_order_relaxed);
+}
+
+/* GPU share of the next hybrid batch's bytes, in 1/1024ths. */
+static uint64_t ttak_hybrid_gpu_share(void) {
+    uint64_t gpu = atomic_load_explicit(&g_hybrid_gpu_rate, memory_order_relaxed);
+    uint64_t cpu = atomic_load_explicit(&g_hybrid_cpu_rate, memory_order_relaxed);
+    if (gpu == 0 || cpu == 0) return 512;
+    uint64_t share = (uint64_t)((double)gpu * 1024.0 / ((double)gpu + (double)cpu));
+    if (share < TTAK_ACCEL_HYBRID_MIN_SHARE) share = TTAK_ACCEL_HYBRID_MIN_SHARE;
+    if (share > 1024 - TTAK_ACCEL_HYBRID_MIN_SHARE) share = 1024 - TTAK_ACCEL_HYBRID_MIN_SHARE;
+    return share;
+}
+
+/**
+ * @brief Runs the first items of the batch on the GPU backend on a helper
+ * thread and the rest on the CPU backend on the caller.
+ */
+static ttak_result_t ttak_execute_hybrid(const ttak_accel_batch_item_t *items,
+                                         size_t item_count,
+                                         const ttak_accel_config_t *config) {
+    ttak_accel_backend_fn gpu = ttak_gpu_backend();
+    if (gpu == NULL) {
+        return ttak_accel_run_cpu(items, item_count, config);
+    }
+
+    size_t total = ttak_items_bytes(items, item_count);
+    uint64_t share = ttak_hybrid_gpu_share();
+    size_t split = 0;
+    if (item_count == 1) {
+        split = (share >= 512) ? 1 : 0;
+    } else {
+        /* Hand whole items to the GPU until its byte share is reached,
+         * keeping at least one item on each side. */
+        size_t target = (size_t)((double)total * (double)share / 1024.0);
+        size_t bytes = 0;
+        while (split < item_count - 1 && (split == 0 || bytes + items[split].input_len / 2 < target)) {
+            bytes += items[split].input_len;
+            ++split;
+        }
+    }
+
+    ttak_hybrid_leg_t gpu_leg = { gpu, items, split, config, TTAK_RESULT_OK, 0 };
+    ttak_hybrid_leg_t cpu_leg = { ttak_accel_run_cpu, items + split, item_count - split, config,
+                                  TTAK_RESULT_OK, 0 };
+    pthread_t thread;
+    bool threaded = false;
+    if (gpu_leg.item_count > 0) {
+        threaded = pthread_create(&thread, NULL, ttak_hybrid_leg_thread, &gpu_leg) == 0;
+        if (!threaded) {
+            ttak_hybrid_run_leg(&gpu_leg);
+        }
+    }
+    if (cpu_leg.item_count > 0) {
+        ttak_hybrid_run_leg(&cpu_leg);
+    }
+    if (threaded) {
+        pthread_join(thread, NULL);
+    }
+
+    if (gpu_leg.item_count > 0 && gpu_leg.status == TTAK_RESULT_OK) {
+        ttak_hybrid_update_rate(&g_hybrid_gpu_rate, ttak_items_bytes(gpu_leg.items, gpu_leg.item_count),
+                                gpu_leg.elapsed_ns);
+    }
+    if (cpu_leg.item_count > 0 && cpu_leg.status == TTAK_RESULT_OK) {
+        ttak_hybrid_update_rate(&g_hybrid_cpu_rate, ttak_items_bytes(cpu_leg.items, cpu_leg.item_count),
+                                cpu_leg.elapsed_ns);
+    }
+    if (cpu_leg.status != TTAK_RESULT_OK) {
+        return cpu_leg.status;
+    }
+    if (gpu_leg.item_count > 0 && gpu_leg.status != TTAK_RESULT_OK) {
+        if (gpu_leg.status == TTAK_RESULT_ERR_ARGUMENT) {
+            return gpu_leg.status;
+        }
+        /* Shrink the GPU side to its minimum share until it succeeds again. */
+        atomic_store_explicit(&g_hybrid_gpu_rate, 1, memory_order_relaxed);
+        return ttak_accel_run_cpu(gpu_leg.items, gpu_leg.item_count, config);
+    }
+    return TTAK_RESULT_OK;
+}
+
 ttak_result_t ttak_execute_batch(
     const ttak_accel_batch_item_t *items,
     size_t item_count,
@@ -147,6 +287,10 @@ ttak_result_t ttak_execute_batch(
         }
     }
 
+    if (safe_cfg.preferred_target == TTAK_ACCEL_TARGET_HYBRID) {
+        return ttak_execute_hybrid(items, item_count, &safe_cfg);
+    }
+
     ttak_accel_target_t chosen_target = safe_cfg.preferred_target;
     ttak_accel_backend_fn backend = ttak_attempt_bind(safe_cfg.preferred_target,
                                                       &chosen_target);
@@ -2,16 +2,84 @@
  * @file ttak_arch_features.c
  * @brief Runtime architecture feature detection.
  *
- * Currently a placeholder for the narrow-first rollout. Future phases can add
- * cpuid / getauxval probing and expose a ttak_arch_features_t struct.
+ * x86-64 relies on the compiler's cpuid model (__builtin_cpu_supports),
+ * which also checks that the OS saves the wider register state. AArch64
+ * Linux reads AT_HWCAP; other AArch64 targets assume the baseline NEON.
  */
 
 #include <ttak/arch/ttak_arch.h>
 
-#if defined(TTAK_ARCH_X86_64) && !defined(TTAK_COMPILER_TCC)
-/* x86 runtime feature detection will go here. */
+#include <stdatomic.h>
+
+#if defined(TTAK_ARCH_X86_64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#include <cpuid.h>
 #endif
 
 #if defined(TTAK_ARCH_AARCH64) && defined(__linux__) && !defined(TTAK_COMPILER_TCC)
-/* getauxval(AT_HWCAP) probing will go here. */
+#include <sys/auxv.h>
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD (1UL << 1)
+#endif
+#ifndef HWCAP_AES
+#define HWCAP_AES (1UL << 3)
+#endif
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1UL << 7)
+#endif
+#ifndef HWCAP_ATOMICS
+#define HWCAP_ATOMICS (1UL << 8)
+#endif
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1UL << 22)
+#endif
 #endif
+
+/** @brief Set alongside the feature bits once the host has been probed. */
+#define TTAK_ARCH_FEATURES_PROBED (1u << 31)
+
+static _Atomic uint32_t g_arch_features = 0;
+
+static uint32_t ttak_arch_probe(void) {
+    uint32_t features = 0;
+#if defined(TTAK_ARCH_X86_64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) features |= TTAK_ARCH_FEATURE_SSE2;
+    if (__builtin_cpu_supports("avx2")) features |= TTAK_ARCH_FEATURE_AVX2;
+    if (__builtin_cpu_supports("avx512f")) features |= TTAK_ARCH_FEATURE_AVX512F;
+    if (__builtin_cpu_supports("avx512ifma")) features |= TTAK_ARCH_FEATURE_AVX512IFMA;
+    if (__builtin_cpu_supports("aes")) features |= TTAK_ARCH_FEATURE_AES;
+    if (__builtin_cpu_supports("bmi2")) features |= TTAK_ARCH_FEATURE_BMI2;
+    if (__builtin_cpu_supports("adx")) features |= TTAK_ARCH_FEATURE_ADX;
+    if (__builtin_cpu_supports("sse4.2")) features |= TTAK_ARCH_FEATURE_CRC32C;
+    if (__builtin_cpu_supports("fma")) features |= TTAK_ARCH_FEATURE_FMA;
+    /* __builtin_cpu_supports only learned cmpxchg16b in GCC 12. */
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_CMPXCHG16B)) features |= TTAK_ARCH_FEATURE_CX16;
+#elif defined(TTAK_ARCH_X86_64) && defined(TTAK_COMPILER_MSVC)
+    /* 64-bit Windows 8.1 and later refuse to boot without cmpxchg16b. */
+    features |= TTAK_ARCH_FEATURE_SSE2 | TTAK_ARCH_FEATURE_CX16;
+#elif defined(TTAK_ARCH_AARCH64) && defined(__linux__) && !defined(TTAK_COMPILER_TCC)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    if (hwcap & HWCAP_ASIMD) features |= TTAK_ARCH_FEATURE_NEON;
+    if (hwcap & HWCAP_SVE) features |= TTAK_ARCH_FEATURE_SVE;
+    if (hwcap & HWCAP_AES) features |= TTAK_ARCH_FEATURE_AES;
+    if (hwcap & HWCAP_CRC32) features |= TTAK_ARCH_FEATURE_CRC32C;
+    if (hwcap & HWCAP_ATOMICS) features |= TTAK_ARCH_FEATURE_LSE;
+#elif defined(TTAK_ARCH_AARCH64) && !defined(TTAK_COMPILER_TCC)
+    features |= TTAK_ARCH_FEATURE_NEON;
+#  if defined(__ARM_FEATURE_ATOMICS) || defined(__APPLE__)
+    features |= TTAK_ARCH_FEATURE_LSE;
+#  endif
+#endif
+    return features;
+}
+
+uint32_t ttak_arch_features(void) {
+    uint32_t features = atomic_load_explicit(&g_arch_features, memory_order_relaxed);
+    if (!(features & TTAK_ARCH_FEATURES_PROBED)) {
+        /* Probing is idempotent, so a racing first call just repeats it. */
+        features = ttak_arch_probe() | TTAK_ARCH_FEATURES_PROBED;
+        atomic_store_explicit(&g_arch_features, features, memory_order_relaxed);
+    }
+    return features & ~TTAK_ARCH_FEATURES_PROBED;
+}
@@ -0,0 +1,355 @@
+/**
+ * @file coro.c
+ * @brief Coroutine driver and the shared fd/timer reactor.
+ *
+ * Each step of a coroutine runs as a detached pool task. A step that
+ * returns TTAK_CORO_WAIT has armed exactly one wakeup; @c run_state lets
+ * that wakeup race the end of the step safely:
+ *
+ *  - the step ends with RUNNING -> PARKED, and the wakeup later does
+ *    PARKED -> RUNNING and resubmits the coroutine;
+ *  - or the wakeup lands first, RUNNING -> WOKEN, and the step sees that
+ *    and simply runs the body again.
+ *
+ * Fd and timer waits are served by one reactor thread sleeping in poll()
+ * on every registered fd plus a wake pipe, with the nearest deadline as
+ * its timeout, so no worker ever blocks on I/O.
+ */
+
+#include <ttak/async/coro.h>
+#include <ttak/mem/mem.h>
+#include <ttak/timing/timing.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#define coro_poll WSAPoll
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#define coro_poll poll
+#endif
+
+enum {
+    CORO_PARKED  = 0,
+    CORO_RUNNING = 1,
+    CORO_WOKEN   = 2
+};
+
+#ifdef _WIN32
+/** Without a wake pipe the reactor polls at this period to notice new waits. */
+#define CORO_REACTOR_TICK_MS 10
+#endif
+
+static void *coro_task(void *arg);
+
+/**
+ * @brief Runs steps until the coroutine finishes, parks or is re-queued.
+ */
+static void coro_run(ttak_coro_t *co) {
+    for (;;) {
+        ttak_coro_status_t st = co->fn(co, co->arg);
+        if (st == TTAK_CORO_DONE) {
+            ttak_future_t *done = co->done;
+            void *result = co->result;
+            ttak_mem_free(co);
+            ttak_future_fulfill(done, result, ttak_get_tick_count());
+            return;
+        }
+        if (st == TTAK_CORO_YIELD) {
+            if (ttak_thread_pool_submit_detached(co->pool, coro_task, co, co->priority, ttak_get_tick_count())) {
+                return;
+            }
+            continue; /* Pool refused the task: keep going here. */
+        }
+        int expected = CORO_RUNNING;
+        if (atomic_compare_exchange_strong_explicit(&co->run_state, &expected, CORO_PARKED,
+                                                    memory_order_acq_rel, memory_order_acquire)) {
+            return; /* The wakeup owns the coroutine now. */
+        }
+        /* Woken before the step even returned. */
+        atomic_store_explicit(&co->run_state, CORO_RUNNING, memory_order_relaxed);
+    }
+}
+
+static void *coro_task(void *arg) {
+    coro_run((ttak_coro_t *)arg);
+    return NULL;
+}
+
+static void coro_submit(ttak_coro_t *co) {
+    if (!ttak_thread_pool_submit_detached(co->pool, coro_task, co, co->priority, ttak_get_tick_count())) {
+        coro_run(co);
+    }
+}
+
+/**
+ * @brief Delivers the one wakeup armed by the current suspension.
+ */
+static void coro_wake(ttak_coro_t *co) {
+    int expected = CORO_RUNNING;
+    if (atomic_compare_exchange_strong_explicit(&co->run_state, &expected, CORO_WOKEN,
+                                                memory_order_acq_rel, memory_order_acquire)) {
+        return;
+    }
+    atomic_store_explicit(&co->run_state, CORO_RUNNING, memory_order_relaxed);
+    coro_submit(co);
+}
+
+ttak_future_t *ttak_coro_spawn(ttak_thread_pool_t *pool, ttak_coro_fn fn, void *arg, int priority, uint64_t now) {
+    if (!pool || !fn) return NULL;
+    ttak_promise_t *promise = ttak_promise_create(now);
+    if (!promise) return NULL;
+    ttak_future_t *done = ttak_promise_get_future(promise);
+    ttak_mem_free(promise); /* The coroutine fulfils the future directly. */
+
+    ttak_coro_t *co = (ttak_coro_t *)ttak_mem_alloc_raw(sizeof(ttak_coro_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!co) {
+        ttak_future_destroy(done);
+        return NULL;
+    }
+    co->resume_point = 0;
+    co->fn = fn;
+    co->arg = arg;
+    co->pool = pool;
+    co->priority = priority;
+    co->value = NULL;
+    co->revents = 0;
+    co->result = NULL;
+    co->done = done;
+    atomic_init(&co->run_state, CORO_RUNNING);
+    coro_submit(co);
+    return done;
+}
+
+static void coro_future_ready(void *result, void *arg) {
+    ttak_coro_t *co = (ttak_coro_t *)arg;
+    co->value = result;
+    coro_wake(co);
+}
+
+_Bool ttak_coro_arm_future(ttak_coro_t *co, ttak_future_t *future) {
+    co->value = NULL;
+    if (!future) return false;
+    if (ttak_future_is_ready(future)) {
+        co->value = future->result;
+        return false;
+    }
+    return ttak_future_on_ready(future, coro_future_ready, co, ttak_get_tick_count());
+}
+
+/* ---- Reactor ---------------------------------------------------------- */
+
+typedef struct {
+    ttak_coro_t *co;
+    int fd;             /**< Negative for a pure timer. */
+    short events;
+    short revents;      /**< Set by the reactor once poll() reports the fd. */
+    uint64_t deadline;  /**< Absolute ns; 0 for none. */
+} coro_wait_t;
+
+static pthread_mutex_t g_reactor_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t g_reactor_thread;
+static bool g_reactor_running = false;
+static bool g_reactor_stop = false;
+static coro_wait_t *g_waits = NULL;
+static size_t g_wait_count = 0;
+static size_t g_wait_cap = 0;
+#ifndef _WIN32
+static int g_reactor_pipe[2] = { -1, -1 };
+#endif
+
+static void reactor_kick(void) {
+#ifndef _WIN32
+    char b = 1;
+    ssize_t rc;
+    do {
+        rc = write(g_reactor_pipe[1], &b, 1);
+    } while (rc < 0 && errno == EINTR);
+    /* EAGAIN: the pipe is already full of unread kicks. */
+#endif
+}
+
+static void reactor_drain(void) {
+#ifndef _WIN32
+    char buf[64];
+    while (read(g_reactor_pipe[0], buf, sizeof(buf)) > 0) { }
+#endif
+}
+
+/**
+ * @brief Removes wait @p i by moving the last entry into its place.
+ */
+static coro_wait_t reactor_take(size_t i) {
+    coro_wait_t w = g_waits[i];
+    g_waits[i] = g_waits[--g_wait_count];
+    return w;
+}
+
+static void *reactor_main(void *arg) {
+    (void)arg;
+    struct pollfd *pfds = NULL;
+    size_t *pfd_wait = NULL;
+    size_t pfd_cap = 0;
+
+    pthread_mutex_lock(&g_reactor_lock);
+    while (!g_reactor_stop) {
+        /* Snapshot the fds and the nearest deadline under the lock. */
+        size_t snap = g_wait_count;
+        if (snap + 1 > pfd_cap) {
+            size_t cap = pfd_cap ? pfd_cap : 16;
+            while (cap < snap + 1) cap *= 2;
+            struct pollfd *np = (struct pollfd *)realloc(pfds, cap * sizeof(*np));
+            size_t *nw = np ? (size_t *)realloc(pfd_wait, cap * sizeof(*nw)) : NULL;
+            if (np) pfds = np;
+            if (nw) pfd_wait = nw;
+            if (np && nw) pfd_cap = cap;
+            if (!pfd_cap) break; /* Cannot poll at all: release everyone below. */
+        }
+        size_t n = 0;
+#ifndef _WIN32
+        pfds[n].fd = g_reactor_pipe[0];
+        pfds[n].events = POLLIN;
+        pfds[n].revents = 0;
+        n++;
+#endif
+        uint64_t now = ttak_get_tick_count_ns();
+        uint64_t nearest = 0;
+        for (size_t i = 0; i < snap && n < pfd_cap; i++) {
+            if (g_waits[i].deadline && (!nearest || g_waits[i].deadline < nearest)) nearest = g_waits[i].deadline;
+            if (g_waits[i].fd < 0) continue;
+            pfds[n].fd = g_waits[i].fd;
+            pfds[n].events = g_waits[i].events;
+            pfds[n].revents = 0;
+            pfd_wait[n] = i;
+            n++;
+        }
+        int timeout_ms = -1;
+        if (nearest) timeout_ms = nearest > now ? (int)((nearest - now + 999999ULL) / 1000000ULL) : 0;
+#ifdef _WIN32
+        if (timeout_ms < 0 || timeout_ms > CORO_REACTOR_TICK_MS) timeout_ms = CORO_REACTOR_TICK_MS;
+#endif
+        pthread_mutex_unlock(&g_reactor_lock);
+
+        int rc = n ? coro_poll(pfds, (unsigned long)n, timeout_ms) : 0;
+#ifdef _WIN32
+        if (!n) Sleep((DWORD)timeout_ms);
+#endif
+
+        pthread_mutex_lock(&g_reactor_lock);
+        size_t first = 0;
+#ifndef _WIN32
+        if (rc > 0 && pfds[0].revents) reactor_drain();
+        first = 1;
+#endif
+        /* Mark fired fd waits by their snapshot index (still valid: only this thread removes). */
+        for (size_t k = first; rc > 0 && k < n; k++) {
+            g_waits[pfd_wait[k]].revents = pfds[k].revents;
+        }
+
+        /* Collect fired and expired waits; wake them outside the lock. */
+        now = ttak_get_tick_count_ns();
+        coro_wait_t ready[64];
+        size_t ready_n = 0;
+        for (size_t i = snap; i-- > 0 && ready_n < 64;) {
+            coro_wait_t *w = &g_waits[i];
+            bool fired = w->revents != 0;
+            bool expired = w->deadline && w->deadline <= now;
+            if (!fired && !expired) continue;
+            coro_wait_t t = reactor_take(i);
+            t.co->revents = t.revents;
+            ready[ready_n++] = t;
+        }
+        pthread_mutex_unlock(&g_reactor_lock);
+        for (size_t i = 0; i < ready_n; i++) coro_wake(ready[i].co);
+        pthread_mutex_lock(&g_reactor_lock);
+    }
+
+    /* Shutting down: release every waiter as if it timed out. */
+    while (g_wait_count) {
+        coro_wait_t t = reactor_take(g_wait_count - 1);
+        pthread_mutex_unlock(&g_reactor_lock);
+        t.co->revents = 0;
+        coro_wake(t.co);
+        pthread_mutex_lock(&g_reactor_lock);
+    }
+    pthread_mutex_unlock(&g_reactor_lock);
+    free(pfds);
+    free(pfd_wait);
+    return NULL;
+}
+
+/**
+ * @brief Starts the reactor if needed. Called with the reactor lock held.
+ */
+static bool reactor_start_locked(void) {
+    if (g_reactor_running) return true;
+#ifndef _WIN32
+    if (g_reactor_pipe[0] < 0) {
+        if (pipe(g_reactor_pipe) != 0) return false;
+        for (int i = 0; i < 2; i++) {
+            fcntl(g_reactor_pipe[i], F_SETFL, fcntl(g_reactor_pipe[i], F_GETFL) | O_NONBLOCK);
+            fcntl(g_reactor_pipe[i], F_SETFD, FD_CLOEXEC);
+        }
+    }
+#endif
+    if (pthread_create(&g_reactor_thread, NULL, reactor_main, NULL) != 0) return false;
+    g_reactor_running = true;
+    return true;
+}
+
+_Bool ttak_coro_arm_fd(ttak_coro_t *co, int fd, short events, uint64_t timeout_ns) {
+    co->revents = 0;
+    if (fd < 0 && timeout_ns == 0) return false;
+
+    pthread_mutex_lock(&g_reactor_lock);
+    if (g_reactor_stop || !reactor_start_locked()) {
+        pthread_mutex_unlock(&g_reactor_lock);
+        return false;
+    }
+    if (g_wait_count == g_wait_cap) {
+        size_t cap = g_wait_cap ? g_wait_cap * 2 : 64;
+        coro_wait_t *grown = (coro_wait_t *)realloc(g_waits, cap * sizeof(*grown));
+        if (!grown) {
+            pthread_mutex_unlock(&g_reactor_lock);
+            return false;
+        }
+        g_waits = grown;
+        g_wait_cap = cap;
+    }
+    g_waits[g_wait_count].co = co;
+    g_waits[g_wait_count].fd = fd;
+    g_waits[g_wait_count].events = events;
+    g_waits[g_wait_count].revents = 0;
+    g_waits[g_wait_count].deadline = timeout_ns ? ttak_get_tick_count_ns() + timeout_ns : 0;
+    g_wait_count++;
+    pthread_mutex_unlock(&g_reactor_lock);
+    reactor_kick();
+    return true;
+}
+
+void ttak_coro_reactor_shutdown(void) {
+    pthread_mutex_lock(&g_reactor_lock);
+    if (!g_reactor_running) {
+        pthread_mutex_unlock(&g_reactor_lock);
+        return;
+    }
+    g_reactor_stop = true;
+    pthread_t thread = g_reactor_thread;
+    pthread_mutex_unlock(&g_reactor_lock);
+    reactor_kick();
+    pthread_join(thread, NULL);
+
+    pthread_mutex_lock(&g_reactor_lock);
+    g_reactor_running = false;
+    g_reactor_stop = false;
+    free(g_waits);
+    g_waits = NULL;
+    g_wait_count = g_wait_cap = 0;
+    pthread_mutex_unlock(&g_reactor_lock);
+}
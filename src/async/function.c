@@ -62,8 +62,10 @@ void ttak_async_future_cleanup(ttak_async_future_t *future) {
     if (future->future) {
         ttak_future_t *safe_future = ttak_mem_access(future->future, now);
         if (safe_future) {
+            /* A fulfiller may still be unlocking after the wake. */
+            pthread_mutex_lock(&safe_future->mutex);
+            pthread_mutex_unlock(&safe_future->mutex);
             pthread_mutex_destroy(&safe_future->mutex);
-            pthread_cond_destroy(&safe_future->cond);
             safe_future->ready = false;
             safe_future->result = NULL;
         }
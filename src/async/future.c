@@ -1,10 +1,69 @@
 #include <ttak/async/future.h>
 #include <ttak/mem/epoch.h>
+#include <ttak/mem/mem.h>
+#include <ttak/thread/pool.h>
+#include <ttak/timing/timing.h>
+#include <ttak/sync/waitword.h>
+#include <ttak/arch/ttak_arch.h>
+#include <stdatomic.h>
 #include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Queued continuation. Concrete kinds embed this as their first member.
+ */
+struct ttak_future_cont {
+    void (*fire)(ttak_future_cont_t *cont, void *result, uint64_t now);
+    ttak_future_cont_t *next;
+};
+
+/** @brief ttak_future_then() node; owns itself until its body has run. */
+typedef struct {
+    ttak_future_cont_t base;
+    ttak_thread_pool_t *pool;
+    ttak_future_then_fn fn;
+    void *arg;
+    void *result;       /**< Source result, captured when the node fires. */
+    ttak_future_t *out;
+} future_then_t;
+
+/** @brief ttak_future_on_ready() node; freed once the callback returns. */
+typedef struct {
+    ttak_future_cont_t base;
+    void (*cb)(void *result, void *arg);
+    void *arg;
+} future_callback_t;
+
+typedef struct future_join future_join_t;
+
+/** @brief One per source future of a when_all/when_any join. */
+typedef struct {
+    ttak_future_cont_t base;
+    future_join_t *join;
+    size_t index;
+} future_join_slot_t;
+
+/**
+ * @brief Shared state of a when_all/when_any join.
+ *
+ * Freed by whichever source fires last, so late sources of a when_any never
+ * touch freed memory.
+ */
+struct future_join {
+    _Atomic size_t remaining;  /**< Sources that have not fired yet. */
+    _Atomic _Bool won;         /**< when_any: set by the first source. */
+    _Bool any;
+    void **results;            /**< when_all: optional caller array. */
+    size_t *index;             /**< when_any: optional winner index. */
+    ttak_future_t *out;
+    future_join_slot_t slots[]; /**< One per source. */
+};
 
 /**
  * @brief Retrieve the computed result from the future.
  * * Synchronously blocks the calling thread until the producer signals completion.
+ * The wait spins briefly, then sleeps on the future's wait word; the fulfiller
+ * only issues a wake when a reader has marked the word parked.
  * To prevent epoch stalls and potential deadlocks with the background GC thread,
  * this function temporarily exits the epoch critical section during the wait period.
  *
@@ -16,26 +75,240 @@ void *ttak_future_get(ttak_future_t *future) {
         return NULL;
     }
 
+    uint32_t state = atomic_load_explicit(&future->state, memory_order_acquire);
+    if (state != TTAK_FUTURE_READY) {
+        /* * Transition the current thread to an inactive state before blocking.
+         * This allows the background GC (Epoch Manager) to advance the global epoch
+         * without being stalled by this waiting thread.
+         */
+        ttak_epoch_exit();
+
+        for (int i = 0; i < TTAK_WAITWORD_SPINS && state != TTAK_FUTURE_READY; i++) {
+            ttak_arch_pause();
+            state = atomic_load_explicit(&future->state, memory_order_acquire);
+        }
+        while (state != TTAK_FUTURE_READY) {
+            if (state == TTAK_FUTURE_PENDING &&
+                !atomic_compare_exchange_weak_explicit(&future->state, &state, TTAK_FUTURE_PARKED,
+                                                       memory_order_acquire, memory_order_acquire)) {
+                continue;
+            }
+            ttak_waitword_wait(&future->state, TTAK_FUTURE_PARKED, TTAK_WAIT_FOREVER);
+            state = atomic_load_explicit(&future->state, memory_order_acquire);
+        }
+
+        /* * Re-enter the epoch critical section upon wakeup to ensure that
+         * any subsequent memory access to the returned result remains safe.
+         */
+        ttak_epoch_enter();
+    }
+
+    /* The acquire on state orders this after the fulfiller's store. */
+    return future->result;
+}
+
+_Bool ttak_future_is_ready(ttak_future_t *future) {
+    if (!future) return false;
+    return atomic_load_explicit(&future->state, memory_order_acquire) == TTAK_FUTURE_READY;
+}
+
+/**
+ * @brief Completes the future and fires its continuations.
+ *
+ * Continuations are detached under the mutex and fired after it is dropped,
+ * in the order they were attached, so a continuation may freely chain onto
+ * or read the future it was attached to.
+ */
+void ttak_future_fulfill(ttak_future_t *future, void *val, uint64_t now) {
+    if (!future) return;
+
     pthread_mutex_lock(&future->mutex);
+    if (future->ready) {
+        pthread_mutex_unlock(&future->mutex);
+        return;
+    }
+    future->result = val;
+    future->ready = true;
+    ttak_future_cont_t *list = future->conts;
+    future->conts = NULL;
+    /* Wake under the mutex so ttak_future_destroy() cannot free the word mid-wake. */
+    if (atomic_exchange_explicit(&future->state, TTAK_FUTURE_READY, memory_order_acq_rel) == TTAK_FUTURE_PARKED) {
+        ttak_waitword_wake_all(&future->state);
+    }
+    pthread_mutex_unlock(&future->mutex);
 
-    /* * Transition the current thread to an inactive state before blocking.
-     * This allows the background GC (Epoch Manager) to advance the global epoch
-     * without being stalled by this waiting thread.
-     */
-    ttak_epoch_exit();
+    ttak_future_cont_t *ordered = NULL;
+    while (list) {
+        ttak_future_cont_t *next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+    while (ordered) {
+        ttak_future_cont_t *next = ordered->next;
+        ordered->fire(ordered, val, now);
+        ordered = next;
+    }
+}
 
-    while (!future->ready) {
-        /* Suspend execution until the future state is set to ready by the worker. */
-        pthread_cond_wait(&future->cond, &future->mutex);
+/**
+ * @brief Queues @p cont on @p future, or fires it at once if already ready.
+ */
+static void future_attach(ttak_future_t *future, ttak_future_cont_t *cont, uint64_t now) {
+    pthread_mutex_lock(&future->mutex);
+    if (!future->ready) {
+        cont->next = future->conts;
+        future->conts = cont;
+        pthread_mutex_unlock(&future->mutex);
+        return;
     }
+    void *result = future->result;
+    pthread_mutex_unlock(&future->mutex);
+    cont->fire(cont, result, now);
+}
 
-    /* * Re-enter the epoch critical section upon wakeup to ensure that
-     * any subsequent memory access to the returned result remains safe.
-     */
-    ttak_epoch_enter();
+static ttak_future_t *future_new(uint64_t now) {
+    ttak_future_t *future = (ttak_future_t *)ttak_mem_alloc_raw(sizeof(ttak_future_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!future) return NULL;
+    memset(future, 0, sizeof(*future));
+    pthread_mutex_init(&future->mutex, NULL);
+    atomic_init(&future->state, TTAK_FUTURE_PENDING);
+    return future;
+}
 
-    void *res = future->result;
+void ttak_future_destroy(ttak_future_t *future) {
+    if (!future) return;
+    /* A fulfiller may still be unlocking after the wake. */
+    pthread_mutex_lock(&future->mutex);
     pthread_mutex_unlock(&future->mutex);
+    pthread_mutex_destroy(&future->mutex);
+    ttak_mem_free(future);
+}
+
+static void future_callback_fire(ttak_future_cont_t *cont, void *result, uint64_t now) {
+    (void)now;
+    future_callback_t *node = (future_callback_t *)cont;
+    void (*cb)(void *, void *) = node->cb;
+    void *arg = node->arg;
+    ttak_dangerous_free(node);
+    cb(result, arg);
+}
+
+_Bool ttak_future_on_ready(ttak_future_t *future, void (*cb)(void *result, void *arg), void *arg, uint64_t now) {
+    if (!future || !cb) return false;
+    future_callback_t *node = (future_callback_t *)ttak_dangerous_alloc(sizeof(*node));
+    if (!node) return false;
+    node->base.fire = future_callback_fire;
+    node->base.next = NULL;
+    node->cb = cb;
+    node->arg = arg;
+    future_attach(future, &node->base, now);
+    return true;
+}
+
+/**
+ * @brief Runs a then-continuation body; task entry point on the pool.
+ */
+static void *future_then_run(void *arg) {
+    future_then_t *node = (future_then_t *)arg;
+    void *res = node->fn(node->result, node->arg);
+    ttak_future_t *out = node->out;
+    ttak_dangerous_free(node);
+    ttak_future_fulfill(out, res, ttak_get_tick_count());
+    return NULL;
+}
+
+static void future_then_fire(ttak_future_cont_t *cont, void *result, uint64_t now) {
+    future_then_t *node = (future_then_t *)cont;
+    node->result = result;
+    if (node->pool && ttak_thread_pool_submit_detached(node->pool, future_then_run, node, 0, now)) return;
+    future_then_run(node);
+}
+
+ttak_future_t *ttak_future_then(ttak_future_t *future, struct ttak_thread_pool *pool,
+                                ttak_future_then_fn fn, void *arg, uint64_t now) {
+    if (!future || !fn) return NULL;
+    future_then_t *node = (future_then_t *)ttak_dangerous_alloc(sizeof(*node));
+    if (!node) return NULL;
+    ttak_future_t *out = future_new(now);
+    if (!out) {
+        ttak_dangerous_free(node);
+        return NULL;
+    }
+    node->base.fire = future_then_fire;
+    node->base.next = NULL;
+    node->pool = pool;
+    node->fn = fn;
+    node->arg = arg;
+    node->result = NULL;
+    node->out = out;
+    future_attach(future, &node->base, now);
+    return out;
+}
+
+static void future_join_fire(ttak_future_cont_t *cont, void *result, uint64_t now) {
+    future_join_slot_t *slot = (future_join_slot_t *)cont;
+    future_join_t *join = slot->join;
+
+    if (join->any) {
+        _Bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(&join->won, &expected, true,
+                                                    memory_order_acq_rel, memory_order_relaxed)) {
+            if (join->index) *join->index = slot->index;
+            ttak_future_fulfill(join->out, result, now);
+        }
+    } else if (join->results) {
+        join->results[slot->index] = result;
+    }
+
+    /* acq_rel: the last source sees every other source's results[] store. */
+    if (atomic_fetch_sub_explicit(&join->remaining, 1, memory_order_acq_rel) != 1) return;
+    if (!join->any) ttak_future_fulfill(join->out, join->results, now);
+    ttak_dangerous_free(join);
+}
+
+static ttak_future_t *future_join(ttak_future_t *const *futures, size_t count, _Bool any,
+                                  void **results, size_t *index, uint64_t now) {
+    if (!futures || (any && count == 0)) return NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (!futures[i]) return NULL;
+    }
+
+    ttak_future_t *out = future_new(now);
+    if (!out) return NULL;
+    if (count == 0) {
+        ttak_future_fulfill(out, results, now);
+        return out;
+    }
+
+    future_join_t *join = (future_join_t *)ttak_dangerous_alloc(sizeof(*join) + count * sizeof(future_join_slot_t));
+    if (!join) {
+        ttak_future_destroy(out);
+        return NULL;
+    }
+    atomic_init(&join->remaining, count);
+    atomic_init(&join->won, false);
+    join->any = any;
+    join->results = results;
+    join->index = index;
+    join->out = out;
+    for (size_t i = 0; i < count; i++) {
+        join->slots[i].base.fire = future_join_fire;
+        join->slots[i].base.next = NULL;
+        join->slots[i].join = join;
+        join->slots[i].index = i;
+    }
+    /* The join may be freed by the last attach firing inline; do not touch it after. */
+    for (size_t i = 0; i < count; i++) {
+        future_attach(futures[i], &join->slots[i].base, now);
+    }
+    return out;
+}
+
+ttak_future_t *ttak_future_when_all(ttak_future_t *const *futures, size_t count, void **results, uint64_t now) {
+    return future_join(futures, count, false, results, NULL, now);
+}
 
-    return res;
+ttak_future_t *ttak_future_when_any(ttak_future_t *const *futures, size_t count, size_t *index, uint64_t now) {
+    return future_join(futures, count, true, NULL, index, now);
 }
@@ -25,7 +25,7 @@ ttak_promise_t *ttak_promise_create(uint64_t now) {
     memset(promise->future, 0, sizeof(*promise->future));
 
     pthread_mutex_init(&promise->future->mutex, NULL);
-    pthread_cond_init(&promise->future->cond, NULL);
+    atomic_init(&promise->future->state, TTAK_FUTURE_PENDING);
 
     return promise;
 }
@@ -33,7 +33,8 @@ ttak_promise_t *ttak_promise_create(uint64_t now) {
 /**
  * @brief Fulfill the promise and notify the waiting future.
  *
- * Updates the stored result, marks the future as ready, and wakes any waiters.
+ * Updates the stored result, marks the future as ready, wakes any waiters
+ * and fires the continuations chained onto it.
  *
  * @param promise Promise to resolve.
  * @param val Pointer to the resolved value.
@@ -47,11 +48,7 @@ void ttak_promise_set_value(ttak_promise_t *promise, void *val, uint64_t now) {
     ttak_future_t *future = (ttak_future_t *)ttak_mem_access(safe_promise->future, now);
     if (!future) return;
 
-    pthread_mutex_lock(&future->mutex);
-    future->result = val;
-    future->ready = true;
-    pthread_cond_broadcast(&future->cond);
-    pthread_mutex_unlock(&future->mutex);
+    ttak_future_fulfill(future, val, now);
 }
 
 /**
@@ -14,6 +14,9 @@
 #ifndef _WIN32
 #include <sched.h>
 #endif
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stddef.h>
 #ifdef _WIN32
 #  ifndef WIN32_LEAN_AND_MEAN
@@ -29,7 +32,13 @@
 
 ttak_thread_pool_t *async_pool = NULL;
 
-void ttak_async_init(int nice) {
+/* ttak_async_init() only records the request; the pool is built by the first ttak_async_pool(). */
+static pthread_mutex_t async_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic(ttak_thread_pool_t *) async_pool_live = NULL;
+static _Atomic bool async_pool_wanted = false;
+static int async_pool_nice = 0;
+
+static ttak_thread_pool_t *async_pool_create(int nice) {
     long available_cores;
 #ifdef _WIN32
     SYSTEM_INFO sysinfo;
@@ -46,23 +55,57 @@ void ttak_async_init(int nice) {
 #endif
     size_t target_threads = (available_cores > 0) ? (size_t)available_cores / 4 : 0;
     if (target_threads == 0) target_threads = 1;
-    uint64_t now = ttak_get_tick_count();
-    if (async_pool) ttak_thread_pool_destroy(async_pool);
-    async_pool = ttak_thread_pool_create(target_threads, nice, now);
+    /* Start at a quarter of the cores; grow toward all of them when work queues up or blocks. */
+    ttak_thread_pool_options_t options;
+    ttak_thread_pool_options_init(&options);
+    options.default_nice = nice;
+    options.max_threads = (available_cores > 0) ? (size_t)available_cores : target_threads;
+    if (options.max_threads < target_threads) options.max_threads = target_threads;
+    return ttak_thread_pool_create_ex(target_threads, &options, ttak_get_tick_count());
+}
+
+void ttak_async_init(int nice) {
+    pthread_mutex_lock(&async_pool_lock);
+    ttak_thread_pool_t *old = atomic_exchange(&async_pool_live, NULL);
+    async_pool = NULL;
+    async_pool_nice = nice;
+    atomic_store(&async_pool_wanted, true);
+    pthread_mutex_unlock(&async_pool_lock);
+    if (old) ttak_thread_pool_destroy(old);
+}
+
+ttak_thread_pool_t *ttak_async_pool(void) {
+    ttak_thread_pool_t *pool = atomic_load_explicit(&async_pool_live, memory_order_acquire);
+    if (pool || !atomic_load_explicit(&async_pool_wanted, memory_order_relaxed)) return pool;
+    pthread_mutex_lock(&async_pool_lock);
+    pool = atomic_load_explicit(&async_pool_live, memory_order_relaxed);
+    if (!pool && atomic_load_explicit(&async_pool_wanted, memory_order_relaxed)) {
+        pool = async_pool_create(async_pool_nice);
+        /* Creation failure leaves callers on their serial fallbacks for good. */
+        if (!pool) atomic_store(&async_pool_wanted, false);
+        async_pool = pool;
+        atomic_store_explicit(&async_pool_live, pool, memory_order_release);
+    }
+    pthread_mutex_unlock(&async_pool_lock);
+    return pool;
 }
 
 void ttak_async_shutdown(void) {
-    if (!async_pool) return;
-    ttak_thread_pool_destroy(async_pool);
+    pthread_mutex_lock(&async_pool_lock);
+    ttak_thread_pool_t *old = atomic_exchange(&async_pool_live, NULL);
     async_pool = NULL;
+    atomic_store(&async_pool_wanted, false);
+    pthread_mutex_unlock(&async_pool_lock);
+    if (old) ttak_thread_pool_destroy(old);
 }
 
 void ttak_async_schedule(ttak_task_t *task, uint64_t now, int priority) {
     if (!task) return;
-    if (async_pool) {
+    ttak_thread_pool_t *pool = ttak_async_pool();
+    if (pool) {
         ttak_task_t *queued_task = ttak_task_clone(task, now);
         if (queued_task) {
-            if (ttak_thread_pool_schedule_task(async_pool, queued_task, priority, now)) return;
+            if (ttak_thread_pool_schedule_task(pool, queued_task, priority, now)) return;
             ttak_task_destroy(queued_task, now);
         }
     }
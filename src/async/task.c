@@ -9,6 +9,7 @@
 #include <stddef.h>
 
 #include <ttak/async/promise.h>
+#include <ttak/async/wait_group.h>
 
 /**
  * @brief Internal task structure.
@@ -17,8 +18,10 @@ struct ttak_task {
     ttak_task_func_t func; /**< Function to execute. */
     void *arg;             /**< Argument for the function. */
     ttak_promise_t *promise; /**< Promise to fulfill. */
+    ttak_wait_group_t *wait_group; /**< Group to mark done, if any. */
     uint64_t task_hash;      /**< Hash to identify task type. */
     uint64_t start_ts;       /**< Execution start timestamp. */
+    uint64_t deadline_ts;    /**< Absolute deadline (ttak_get_tick_count() ms); 0 for none. */
     int base_priority;       /**< Original user priority. */
     uint8_t domain;          /**< Task domain metadata. */
     uint8_t urgency;         /**< Task urgency metadata. */
@@ -40,19 +43,10 @@ ttak_task_t *ttak_task_create(ttak_task_func_t func, void *arg, ttak_promise_t *
         task->func = func;
         task->arg = arg;
         task->promise = promise;
-        
-        // Use SipHash-2-4 with arbitrary keys for task fingerprinting
-        uint64_t k0 = 0x0706050403020100ULL;
-        uint64_t k1 = 0x0F0E0D0C0B0A0908ULL;
-        // Combine func and arg into a pseudo-key or hash them separately and combine?
-        // Since the hash function takes a uintptr_t key, let's mix them first or just hash one heavily.
-        // Better: Hash the pointer to the function, and XOR with hash of arg?
-        // Or just XOR the pointers and hash the result?
-        // Let's do: Hash(func ^ arg). Simple and consistent.
-        uintptr_t combined = (uintptr_t)func ^ (uintptr_t)arg;
-        task->task_hash = gen_hash_sip24(combined, k0, k1);
-        
+        task->wait_group = NULL;
+        task->task_hash = ttak_task_hash_of(func, arg);
         task->start_ts = 0;
+        task->deadline_ts = 0;
         task->base_priority = 0;
         task->domain = (uint8_t)TTAK_TASK_DOMAIN_THREAD;
         task->urgency = 0;
@@ -60,6 +54,15 @@ ttak_task_t *ttak_task_create(ttak_task_func_t func, void *arg, ttak_promise_t *
     return task;
 }
 
+uint64_t ttak_task_hash_of(ttak_task_func_t func, void *arg) {
+    // Use SipHash-2-4 with arbitrary keys for task fingerprinting
+    uint64_t k0 = 0x0706050403020100ULL;
+    uint64_t k1 = 0x0F0E0D0C0B0A0908ULL;
+    // Hash(func ^ arg). Simple and consistent.
+    uintptr_t combined = (uintptr_t)func ^ (uintptr_t)arg;
+    return gen_hash_sip24(combined, k0, k1);
+}
+
 void ttak_task_set_hash(ttak_task_t *task, uint64_t hash) {
     if (task) task->task_hash = hash;
 }
@@ -97,6 +100,18 @@ uint8_t ttak_task_get_urgency(const ttak_task_t *task) {
     return task ? task->urgency : 0U;
 }
 
+void ttak_task_set_deadline(ttak_task_t *task, uint64_t deadline_ts) {
+    if (task) task->deadline_ts = deadline_ts;
+}
+
+uint64_t ttak_task_get_deadline(const ttak_task_t *task) {
+    return task ? task->deadline_ts : 0;
+}
+
+void ttak_task_set_wait_group(ttak_task_t *task, ttak_wait_group_t *wg) {
+    if (task) task->wait_group = wg;
+}
+
 /**
  * @brief Executes the task.
  * 
@@ -108,6 +123,24 @@ void ttak_task_execute(ttak_task_t *task, uint64_t now) {
         if (task->promise) {
             ttak_promise_set_value(task->promise, res, now);
         }
+        if (task->wait_group) {
+            ttak_wait_group_done(task->wait_group);
+        }
+    }
+}
+
+/**
+ * @brief Completes the task without running it.
+ *
+ * @param task Pointer to the task.
+ */
+void ttak_task_shed(ttak_task_t *task, uint64_t now) {
+    if (!task) return;
+    if (task->promise) {
+        ttak_promise_set_value(task->promise, NULL, now);
+    }
+    if (task->wait_group) {
+        ttak_wait_group_done(task->wait_group);
     }
 }
 
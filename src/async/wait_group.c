@@ -0,0 +1,66 @@
+#include <ttak/async/wait_group.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/mem/epoch.h>
+
+/** Polls of the counter before a waiter goes to sleep. */
+#define TTAK_WAIT_GROUP_SPINS 256
+
+void ttak_wait_group_init(ttak_wait_group_t *wg) {
+    if (!wg) return;
+    atomic_init(&wg->pending, 0);
+    atomic_init(&wg->waiters, 0);
+    pthread_mutex_init(&wg->mutex, NULL);
+    pthread_cond_init(&wg->cond, NULL);
+}
+
+void ttak_wait_group_destroy(ttak_wait_group_t *wg) {
+    if (!wg) return;
+    /* The last done() may still be inside the broadcast. */
+    pthread_mutex_lock(&wg->mutex);
+    pthread_mutex_unlock(&wg->mutex);
+    pthread_mutex_destroy(&wg->mutex);
+    pthread_cond_destroy(&wg->cond);
+}
+
+void ttak_wait_group_add(ttak_wait_group_t *wg, size_t count) {
+    if (wg) atomic_fetch_add_explicit(&wg->pending, count, memory_order_relaxed);
+}
+
+/**
+ * @brief Marks one task done.
+ *
+ * The seq_cst decrement and waiter check pair with the waiter's seq_cst
+ * registration and recheck, so either the waiter sees zero or this call
+ * sees the waiter and broadcasts under the mutex.
+ */
+void ttak_wait_group_done(ttak_wait_group_t *wg) {
+    if (!wg) return;
+    if (atomic_fetch_sub_explicit(&wg->pending, 1, memory_order_seq_cst) != 1) return;
+    if (atomic_load_explicit(&wg->waiters, memory_order_seq_cst) == 0) return;
+    pthread_mutex_lock(&wg->mutex);
+    pthread_cond_broadcast(&wg->cond);
+    pthread_mutex_unlock(&wg->mutex);
+}
+
+size_t ttak_wait_group_pending(ttak_wait_group_t *wg) {
+    return wg ? atomic_load_explicit(&wg->pending, memory_order_acquire) : 0;
+}
+
+void ttak_wait_group_wait(ttak_wait_group_t *wg) {
+    if (!wg) return;
+    for (int i = 0; i < TTAK_WAIT_GROUP_SPINS; i++) {
+        if (atomic_load_explicit(&wg->pending, memory_order_acquire) == 0) return;
+        ttak_arch_pause();
+    }
+
+    pthread_mutex_lock(&wg->mutex);
+    atomic_fetch_add_explicit(&wg->waiters, 1, memory_order_seq_cst);
+    /* Let the epoch advance while this thread sleeps. */
+    ttak_epoch_exit();
+    while (atomic_load_explicit(&wg->pending, memory_order_seq_cst) != 0) {
+        pthread_cond_wait(&wg->cond, &wg->mutex);
+    }
+    ttak_epoch_enter();
+    atomic_fetch_sub_explicit(&wg->waiters, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&wg->mutex);
+}
@@ -1,4 +1,5 @@
 #include <ttak/atomic/atomic.h>
+#include <ttak/atomic/atomic128.h>
 #include <ttak/ht/map.h>
 #include <ttak/mem/mem.h>
 #include <pthread.h>
@@ -91,6 +92,59 @@ uint64_t ttak_atomic_sub64(volatile uint64_t *ptr, uint64_t delta) {
     return atomic_fetch_sub_explicit((_Atomic uint64_t *)ptr, delta, memory_order_seq_cst) - delta;
 }
 
+static bool ttak_atomic128_cas_locked(ttak_atomic128_t *obj, ttak_u128_t *expected, ttak_u128_t desired) TTAK_MAYBE_UNUSED;
+
+/** @brief Last resort for hosts without a double-width CAS. */
+static bool ttak_atomic128_cas_locked(ttak_atomic128_t *obj, ttak_u128_t *expected, ttak_u128_t desired) {
+    pthread_once(&__ttak_atomic_fallback_once, __ttak_atomic_fallback_setup);
+    pthread_mutex_t *lock = &__ttak_atomic_fallback_locks[((uintptr_t)obj >> 4) & (__TT_ATOMIC_FALLBACK_SHARDS - 1)];
+    pthread_mutex_lock(lock);
+    bool ok = obj->lo == expected->lo && obj->hi == expected->hi;
+    if (ok) {
+        obj->lo = desired.lo;
+        obj->hi = desired.hi;
+    } else {
+        expected->lo = obj->lo;
+        expected->hi = obj->hi;
+    }
+    pthread_mutex_unlock(lock);
+    return ok;
+}
+
+/**
+ * @brief 128-bit CAS using the best instruction the host offers.
+ *
+ * The feature word is cached by ttak_arch_features(), so dispatch costs a
+ * relaxed load and a branch on top of the instruction itself.
+ */
+bool ttak_atomic128_cas_runtime(ttak_atomic128_t *obj, ttak_u128_t *expected, ttak_u128_t desired) {
+#if defined(TTAK_ATOMIC128_HAVE_CX16)
+    if (TTAK_LIKELY(ttak_arch_features() & TTAK_ARCH_FEATURE_CX16)) {
+        return ttak_atomic128_cas_cx16(obj, expected, desired);
+    }
+    return ttak_atomic128_cas_locked(obj, expected, desired);
+#elif defined(TTAK_ATOMIC128_HAVE_LSE)
+    if (ttak_arch_features() & TTAK_ARCH_FEATURE_LSE) {
+        return ttak_atomic128_cas_lse(obj, expected, desired);
+    }
+    return ttak_atomic128_cas_llsc(obj, expected, desired);
+#elif TTAK_ATOMIC128_NATIVE
+    return ttak_atomic128_cas(obj, expected, desired);
+#else
+    return ttak_atomic128_cas_locked(obj, expected, desired);
+#endif
+}
+
+bool ttak_atomic128_is_lock_free(void) {
+#if TTAK_ATOMIC128_NATIVE || defined(TTAK_ATOMIC128_HAVE_LLSC)
+    return true;
+#elif defined(TTAK_ATOMIC128_HAVE_CX16)
+    return (ttak_arch_features() & TTAK_ARCH_FEATURE_CX16) != 0;
+#else
+    return false;
+#endif
+}
+
 /**
  * @brief Check tt_func_wrapper has expired.
  */
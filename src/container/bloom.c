@@ -0,0 +1,97 @@
+#include <ttak/container/bloom.h>
+#include <ttak/ht/hash.h>
+#include <ttak/ht/wyhash.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void *bloom_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
+}
+
+static void bloom_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/* Block holding @p hash's bits: the high half scaled onto [0, nblocks). */
+static inline const uint64_t *bloom_block(const ttak_bloom_t *filter, uint64_t hash) {
+    size_t b = (size_t)(((hash >> 32) * (uint64_t)filter->nblocks) >> 32);
+    return filter->words + b * TTAK_BLOOM_BLOCK_WORDS;
+}
+
+/* Six bits per word choose the bit set in that word; remixed so they do not repeat the block bits. */
+static inline uint64_t bloom_pattern(const ttak_bloom_t *filter, uint64_t hash) {
+    return ttak_hash_u64(hash, filter->seed);
+}
+
+ttak_bloom_t *ttak_bloom_create(size_t expected, unsigned bits_per_key) {
+    if (bits_per_key == 0) bits_per_key = TTAK_BLOOM_DEFAULT_BITS_PER_KEY;
+    if (expected == 0) expected = 1;
+    size_t block_bits = TTAK_BLOOM_BLOCK_WORDS * 64;
+    if (expected > (SIZE_MAX - block_bits) / bits_per_key) return NULL;
+    size_t nblocks = (expected * bits_per_key + block_bits - 1) / block_bits;
+    if (nblocks > UINT32_MAX) return NULL;
+
+    ttak_bloom_t *filter = malloc(sizeof(*filter));
+    if (!filter) return NULL;
+    size_t bytes = nblocks * TTAK_BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+    filter->words = bloom_aligned_alloc(bytes);
+    if (!filter->words) {
+        free(filter);
+        return NULL;
+    }
+    memset(filter->words, 0, bytes);
+    filter->nblocks = nblocks;
+    filter->capacity = expected;
+    filter->count = 0;
+    filter->seed = 0x8ebc6af09c88c6e3ULL;
+    return filter;
+}
+
+void ttak_bloom_destroy(ttak_bloom_t *filter) {
+    if (!filter) return;
+    bloom_aligned_free(filter->words);
+    free(filter);
+}
+
+void ttak_bloom_add_hash(ttak_bloom_t *filter, uint64_t hash) {
+    uint64_t *block = (uint64_t *)bloom_block(filter, hash);
+    uint64_t bits = bloom_pattern(filter, hash);
+    for (int w = 0; w < TTAK_BLOOM_BLOCK_WORDS; w++) {
+        block[w] |= 1ULL << ((bits >> (6 * w)) & 63);
+    }
+    filter->count++;
+}
+
+bool ttak_bloom_may_contain_hash(const ttak_bloom_t *filter, uint64_t hash) {
+    const uint64_t *block = bloom_block(filter, hash);
+    uint64_t bits = bloom_pattern(filter, hash);
+    uint64_t miss = 0;
+    // Branch-free across the line; the compiler can keep it in vector registers.
+    for (int w = 0; w < TTAK_BLOOM_BLOCK_WORDS; w++) {
+        miss |= ~block[w] & (1ULL << ((bits >> (6 * w)) & 63));
+    }
+    return miss == 0;
+}
+
+void ttak_bloom_add(ttak_bloom_t *filter, const void *key, size_t len) {
+    ttak_bloom_add_hash(filter, ttak_hash_bytes(key, len, filter->seed));
+}
+
+bool ttak_bloom_may_contain(const ttak_bloom_t *filter, const void *key, size_t len) {
+    return ttak_bloom_may_contain_hash(filter, ttak_hash_bytes(key, len, filter->seed));
+}
+
+void ttak_bloom_clear(ttak_bloom_t *filter) {
+    memset(filter->words, 0, filter->nblocks * TTAK_BLOOM_BLOCK_WORDS * sizeof(uint64_t));
+    filter->count = 0;
+}
@@ -0,0 +1,155 @@
+#include <ttak/container/bytering.h>
+#include <string.h>
+#include <stdlib.h>
+
+/** Length word of a padding record: skip to the start of the buffer. */
+#define BR_PAD UINT64_MAX
+
+static void *br_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
+}
+
+static void br_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/* Bytes a record of @p len payload bytes spans, header included. */
+static inline size_t br_span(size_t len) {
+    return (TTAK_BYTERING_HDR + len + TTAK_BYTERING_HDR - 1) & ~(size_t)(TTAK_BYTERING_HDR - 1);
+}
+
+static inline uint64_t *br_hdr(ttak_bytering_t *ring, size_t pos) {
+    return (uint64_t *)(ring->buffer + (pos & ring->mask));
+}
+
+/**
+ * @brief Creates ring, rounding @p capacity to a power of two.
+ */
+ttak_bytering_t *ttak_bytering_create(size_t capacity) {
+    if (capacity < 2 * TTAK_BYTERING_HDR || capacity > (SIZE_MAX >> 1) + 1) return NULL;
+    size_t pow2 = 2 * TTAK_BYTERING_HDR;
+    while (pow2 < capacity) pow2 <<= 1;
+
+    ttak_bytering_t *ring = br_aligned_alloc(sizeof(ttak_bytering_t));
+    if (!ring) return NULL;
+    ring->buffer = br_aligned_alloc(pow2);
+    if (!ring->buffer) {
+        br_aligned_free(ring);
+        return NULL;
+    }
+    ring->capacity = pow2;
+    ring->mask = pow2 - 1;
+    atomic_init(&ring->prod_pos, 0);
+    ring->prod_cached = 0;
+    ring->reserved_at = 0;
+    ring->reserved_len = 0;
+    atomic_init(&ring->cons_pos, 0);
+    ring->cons_cached = 0;
+    ring->peeked_len = 0;
+    return ring;
+}
+
+/**
+ * @brief Destroys ring.
+ */
+void ttak_bytering_destroy(ttak_bytering_t *ring) {
+    if (ring) {
+        br_aligned_free(ring->buffer);
+        br_aligned_free(ring);
+    }
+}
+
+size_t ttak_bytering_max_record(const ttak_bytering_t *ring) {
+    return ring ? ring->capacity / 2 - TTAK_BYTERING_HDR : 0;
+}
+
+/**
+ * @brief Reserves a contiguous record, padding to the start when it would wrap.
+ */
+void *ttak_bytering_reserve(ttak_bytering_t *ring, size_t len) {
+    if (!ring || len > ttak_bytering_max_record(ring)) return NULL;
+    size_t pos = atomic_load_explicit(&ring->prod_pos, memory_order_relaxed);
+    size_t need = br_span(len);
+    size_t off = pos & ring->mask;
+    size_t pad = off + need > ring->capacity ? ring->capacity - off : 0;
+
+    if (ring->capacity - (pos - ring->prod_cached) < pad + need) {
+        ring->prod_cached = atomic_load_explicit(&ring->cons_pos, memory_order_acquire);
+        if (ring->capacity - (pos - ring->prod_cached) < pad + need) return NULL;
+    }
+
+    // The marker is unpublished until prod_pos passes it in commit.
+    if (pad) *br_hdr(ring, pos) = BR_PAD;
+    ring->reserved_at = pos + pad;
+    ring->reserved_len = len;
+    return br_hdr(ring, ring->reserved_at) + 1;
+}
+
+/**
+ * @brief Stamps the length and publishes the record.
+ */
+void ttak_bytering_commit(ttak_bytering_t *ring, size_t len) {
+    if (!ring) return;
+    if (len > ring->reserved_len) len = ring->reserved_len;
+    *br_hdr(ring, ring->reserved_at) = (uint64_t)len;
+    ring->reserved_len = 0;
+    atomic_store_explicit(&ring->prod_pos, ring->reserved_at + br_span(len), memory_order_release);
+}
+
+bool ttak_bytering_push(ttak_bytering_t *ring, const void *data, size_t len) {
+    void *dst = ttak_bytering_reserve(ring, len);
+    if (!dst) return false;
+    if (len) memcpy(dst, data, len);
+    ttak_bytering_commit(ring, len);
+    return true;
+}
+
+/**
+ * @brief Returns the oldest record, freeing any padding in front of it.
+ */
+const void *ttak_bytering_peek(ttak_bytering_t *ring, size_t *len) {
+    if (!ring) return NULL;
+    size_t pos = atomic_load_explicit(&ring->cons_pos, memory_order_relaxed);
+    for (;;) {
+        if (pos == ring->cons_cached) {
+            ring->cons_cached = atomic_load_explicit(&ring->prod_pos, memory_order_acquire);
+            if (pos == ring->cons_cached) return NULL;
+        }
+        uint64_t *hdr = br_hdr(ring, pos);
+        if (*hdr != BR_PAD) {
+            ring->peeked_len = br_span((size_t)*hdr);
+            if (len) *len = (size_t)*hdr;
+            return hdr + 1;
+        }
+        pos += ring->capacity - (pos & ring->mask);
+        atomic_store_explicit(&ring->cons_pos, pos, memory_order_release);
+    }
+}
+
+void ttak_bytering_release(ttak_bytering_t *ring) {
+    if (!ring || !ring->peeked_len) return;
+    size_t pos = atomic_load_explicit(&ring->cons_pos, memory_order_relaxed);
+    atomic_store_explicit(&ring->cons_pos, pos + ring->peeked_len, memory_order_release);
+    ring->peeked_len = 0;
+}
+
+bool ttak_bytering_is_empty(ttak_bytering_t *ring) {
+    return ttak_bytering_used(ring) == 0;
+}
+
+size_t ttak_bytering_used(ttak_bytering_t *ring) {
+    if (!ring) return 0;
+    size_t cons = atomic_load_explicit(&ring->cons_pos, memory_order_acquire);
+    size_t prod = atomic_load_explicit(&ring->prod_pos, memory_order_acquire);
+    return prod - cons;
+}
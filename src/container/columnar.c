@@ -0,0 +1,376 @@
+/**
+ * @file columnar.c
+ * @brief Columnar table: aligned column storage, bitmap filters, pool scans.
+ */
+
+#include <ttak/container/columnar.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/priority/nice.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(TTAK_HAS_AVX2)
+#  include <immintrin.h>
+#endif
+
+#define COL_DEFAULT_ROWS 64
+
+static void *col_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
+}
+
+static void col_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+size_t ttak_col_type_size(ttak_col_type_t type) {
+    switch (type) {
+        case TTAK_COL_U32:
+        case TTAK_COL_I32:
+        case TTAK_COL_F32:
+            return 4;
+        case TTAK_COL_U64:
+        case TTAK_COL_I64:
+        case TTAK_COL_F64:
+            return 8;
+    }
+    return 0;
+}
+
+ttak_columnar_t *ttak_columnar_create(const ttak_col_type_t *types, size_t ncols, size_t init_rows) {
+    if (!types || ncols == 0) return NULL;
+    for (size_t c = 0; c < ncols; c++) {
+        if (ttak_col_type_size(types[c]) == 0) return NULL;
+    }
+    // Whole 64-row blocks, so filters never read past an allocation.
+    size_t cap = init_rows ? (init_rows + 63) & ~(size_t)63 : COL_DEFAULT_ROWS;
+
+    ttak_columnar_t *t = calloc(1, sizeof(*t));
+    if (!t) return NULL;
+    t->types = malloc(ncols * sizeof(*t->types));
+    t->cols = calloc(ncols, sizeof(*t->cols));
+    if (!t->types || !t->cols) goto fail;
+    memcpy(t->types, types, ncols * sizeof(*t->types));
+    t->ncols = ncols;
+    for (size_t c = 0; c < ncols; c++) {
+        t->cols[c] = col_aligned_alloc(cap * ttak_col_type_size(types[c]));
+        if (!t->cols[c]) goto fail;
+    }
+    t->capacity = cap;
+    return t;
+
+fail:
+    ttak_columnar_destroy(t);
+    return NULL;
+}
+
+void ttak_columnar_destroy(ttak_columnar_t *table) {
+    if (!table) return;
+    if (table->cols) {
+        for (size_t c = 0; c < table->ncols; c++) col_aligned_free(table->cols[c]);
+    }
+    free(table->cols);
+    free(table->types);
+    free(table);
+}
+
+/* Grows every column to hold @p rows, all or nothing. */
+static bool col_reserve(ttak_columnar_t *t, size_t rows) {
+    if (rows <= t->capacity) return true;
+    size_t cap = t->capacity;
+    while (cap < rows) {
+        if (cap > SIZE_MAX / 2) return false;
+        cap *= 2;
+    }
+    void **fresh = calloc(t->ncols, sizeof(*fresh));
+    if (!fresh) return false;
+    for (size_t c = 0; c < t->ncols; c++) {
+        size_t es = ttak_col_type_size(t->types[c]);
+        if (cap > SIZE_MAX / es || !(fresh[c] = col_aligned_alloc(cap * es))) {
+            for (size_t k = 0; k < c; k++) col_aligned_free(fresh[k]);
+            free(fresh);
+            return false;
+        }
+        memcpy(fresh[c], t->cols[c], t->rows * es);
+    }
+    for (size_t c = 0; c < t->ncols; c++) {
+        col_aligned_free(t->cols[c]);
+        t->cols[c] = fresh[c];
+    }
+    free(fresh);
+    t->capacity = cap;
+    return true;
+}
+
+bool ttak_columnar_append(ttak_columnar_t *table, size_t nrows, const void *const *cols) {
+    if (!table || !cols) return false;
+    if (nrows == 0) return true;
+    if (nrows > SIZE_MAX - table->rows || !col_reserve(table, table->rows + nrows)) return false;
+    for (size_t c = 0; c < table->ncols; c++) {
+        size_t es = ttak_col_type_size(table->types[c]);
+        memcpy((char *)table->cols[c] + table->rows * es, cols[c], nrows * es);
+    }
+    table->rows += nrows;
+    return true;
+}
+
+void *ttak_columnar_column(const ttak_columnar_t *table, size_t col) {
+    return table && col < table->ncols ? table->cols[col] : NULL;
+}
+
+size_t ttak_columnar_rows(const ttak_columnar_t *table) {
+    return table ? table->rows : 0;
+}
+
+size_t ttak_columnar_mask_words(const ttak_columnar_t *table) {
+    return table ? (table->rows + 63) / 64 : 0;
+}
+
+/* ---- Filters: one 64-bit selection word per 64-row block. ---- */
+
+/* Scalar block of @p n <= 64 rows; each op loop is simple enough to auto-vectorise. */
+#define COL_SCALAR_BLOCK(NAME, T)                                                       \
+    static uint64_t NAME(const T *v, size_t n, ttak_col_op_t op, T x) {                 \
+        uint64_t m = 0;                                                                 \
+        switch (op) {                                                                   \
+            case TTAK_COL_EQ: for (size_t i = 0; i < n; i++) m |= (uint64_t)(v[i] == x) << i; break; \
+            case TTAK_COL_NE: for (size_t i = 0; i < n; i++) m |= (uint64_t)(v[i] != x) << i; break; \
+            case TTAK_COL_LT: for (size_t i = 0; i < n; i++) m |= (uint64_t)(v[i] < x) << i; break;  \
+            case TTAK_COL_LE: for (size_t i = 0; i < n; i++) m |= (uint64_t)(v[i] <= x) << i; break; \
+            case TTAK_COL_GT: for (size_t i = 0; i < n; i++) m |= (uint64_t)(v[i] > x) << i; break;  \
+            case TTAK_COL_GE: for (size_t i = 0; i < n; i++) m |= (uint64_t)(v[i] >= x) << i; break; \
+        }                                                                               \
+        return m;                                                                       \
+    }
+
+COL_SCALAR_BLOCK(col_block_u32, uint32_t)
+COL_SCALAR_BLOCK(col_block_i32, int32_t)
+COL_SCALAR_BLOCK(col_block_f32, float)
+COL_SCALAR_BLOCK(col_block_u64, uint64_t)
+COL_SCALAR_BLOCK(col_block_i64, int64_t)
+COL_SCALAR_BLOCK(col_block_f64, double)
+
+#if defined(TTAK_HAS_AVX2)
+/*
+ * Integer compares have only EQ and signed GT; unsigned lanes are biased by
+ * the sign bit first, and NE, LE, GE invert EQ, GT, LT.
+ */
+static uint64_t avx2_block_int32(const void *p, ttak_col_op_t op, uint32_t xv, int32_t bias_v) {
+    const __m256i bias = _mm256_set1_epi32(bias_v);
+    const __m256i x = _mm256_xor_si256(_mm256_set1_epi32((int32_t)xv), bias);
+    const uint32_t inv = (op == TTAK_COL_NE || op == TTAK_COL_LE || op == TTAK_COL_GE) ? 0xffu : 0u;
+    uint64_t m = 0;
+    for (int j = 0; j < 8; j++) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)p + j), bias);
+        __m256i r;
+        switch (op) {
+            case TTAK_COL_EQ: case TTAK_COL_NE: r = _mm256_cmpeq_epi32(v, x); break;
+            case TTAK_COL_LT: case TTAK_COL_GE: r = _mm256_cmpgt_epi32(x, v); break;
+            case TTAK_COL_GT: case TTAK_COL_LE:
+            default:                            r = _mm256_cmpgt_epi32(v, x); break;
+        }
+        uint32_t b = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(r)) ^ inv;
+        m |= (uint64_t)b << (8 * j);
+    }
+    return m;
+}
+
+static uint64_t avx2_block_int64(const void *p, ttak_col_op_t op, uint64_t xv, int64_t bias_v) {
+    const __m256i bias = _mm256_set1_epi64x(bias_v);
+    const __m256i x = _mm256_xor_si256(_mm256_set1_epi64x((int64_t)xv), bias);
+    const uint32_t inv = (op == TTAK_COL_NE || op == TTAK_COL_LE || op == TTAK_COL_GE) ? 0xfu : 0u;
+    uint64_t m = 0;
+    for (int j = 0; j < 16; j++) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)p + j), bias);
+        __m256i r;
+        switch (op) {
+            case TTAK_COL_EQ: case TTAK_COL_NE: r = _mm256_cmpeq_epi64(v, x); break;
+            case TTAK_COL_LT: case TTAK_COL_GE: r = _mm256_cmpgt_epi64(x, v); break;
+            case TTAK_COL_GT: case TTAK_COL_LE:
+            default:                            r = _mm256_cmpgt_epi64(v, x); break;
+        }
+        uint32_t b = (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(r)) ^ inv;
+        m |= (uint64_t)b << (4 * j);
+    }
+    return m;
+}
+
+/* The predicate is an immediate, hence one loop per op. */
+#define AVX2_FLOAT_LOOP(LANES, LOAD, CMP, MOVE, PRED)                       \
+    for (int j = 0; j < 64 / (LANES); j++) {                                \
+        uint32_t b = (uint32_t)MOVE(CMP(LOAD(v + j * (LANES)), x, PRED));   \
+        m |= (uint64_t)b << ((LANES) * j);                                  \
+    }
+
+static uint64_t avx2_block_f32(const float *v, ttak_col_op_t op, float xv) {
+    const __m256 x = _mm256_set1_ps(xv);
+    uint64_t m = 0;
+    switch (op) {
+        case TTAK_COL_EQ: AVX2_FLOAT_LOOP(8, _mm256_loadu_ps, _mm256_cmp_ps, _mm256_movemask_ps, _CMP_EQ_OQ) break;
+        case TTAK_COL_NE: AVX2_FLOAT_LOOP(8, _mm256_loadu_ps, _mm256_cmp_ps, _mm256_movemask_ps, _CMP_NEQ_UQ) break;
+        case TTAK_COL_LT: AVX2_FLOAT_LOOP(8, _mm256_loadu_ps, _mm256_cmp_ps, _mm256_movemask_ps, _CMP_LT_OQ) break;
+        case TTAK_COL_LE: AVX2_FLOAT_LOOP(8, _mm256_loadu_ps, _mm256_cmp_ps, _mm256_movemask_ps, _CMP_LE_OQ) break;
+        case TTAK_COL_GT: AVX2_FLOAT_LOOP(8, _mm256_loadu_ps, _mm256_cmp_ps, _mm256_movemask_ps, _CMP_GT_OQ) break;
+        case TTAK_COL_GE: AVX2_FLOAT_LOOP(8, _mm256_loadu_ps, _mm256_cmp_ps, _mm256_movemask_ps, _CMP_GE_OQ) break;
+    }
+    return m;
+}
+
+static uint64_t avx2_block_f64(const double *v, ttak_col_op_t op, double xv) {
+    const __m256d x = _mm256_set1_pd(xv);
+    uint64_t m = 0;
+    switch (op) {
+        case TTAK_COL_EQ: AVX2_FLOAT_LOOP(4, _mm256_loadu_pd, _mm256_cmp_pd, _mm256_movemask_pd, _CMP_EQ_OQ) break;
+        case TTAK_COL_NE: AVX2_FLOAT_LOOP(4, _mm256_loadu_pd, _mm256_cmp_pd, _mm256_movemask_pd, _CMP_NEQ_UQ) break;
+        case TTAK_COL_LT: AVX2_FLOAT_LOOP(4, _mm256_loadu_pd, _mm256_cmp_pd, _mm256_movemask_pd, _CMP_LT_OQ) break;
+        case TTAK_COL_LE: AVX2_FLOAT_LOOP(4, _mm256_loadu_pd, _mm256_cmp_pd, _mm256_movemask_pd, _CMP_LE_OQ) break;
+        case TTAK_COL_GT: AVX2_FLOAT_LOOP(4, _mm256_loadu_pd, _mm256_cmp_pd, _mm256_movemask_pd, _CMP_GT_OQ) break;
+        case TTAK_COL_GE: AVX2_FLOAT_LOOP(4, _mm256_loadu_pd, _mm256_cmp_pd, _mm256_movemask_pd, _CMP_GE_OQ) break;
+    }
+    return m;
+}
+#endif
+
+/* Selection word for rows [64 * block, 64 * block + n) of column @p col. */
+static uint64_t col_filter_block(const ttak_columnar_t *t, size_t col, size_t block, size_t n,
+                                 ttak_col_op_t op, const void *operand) {
+    const void *base = t->cols[col];
+    size_t row = block * 64;
+    switch (t->types[col]) {
+        case TTAK_COL_U32: {
+            uint32_t x;
+            memcpy(&x, operand, sizeof(x));
+#if defined(TTAK_HAS_AVX2)
+            if (n == 64) return avx2_block_int32((const uint32_t *)base + row, op, x, INT32_MIN);
+#endif
+            return col_block_u32((const uint32_t *)base + row, n, op, x);
+        }
+        case TTAK_COL_I32: {
+            int32_t x;
+            memcpy(&x, operand, sizeof(x));
+#if defined(TTAK_HAS_AVX2)
+            if (n == 64) return avx2_block_int32((const int32_t *)base + row, op, (uint32_t)x, 0);
+#endif
+            return col_block_i32((const int32_t *)base + row, n, op, x);
+        }
+        case TTAK_COL_F32: {
+            float x;
+            memcpy(&x, operand, sizeof(x));
+#if defined(TTAK_HAS_AVX2)
+            if (n == 64) return avx2_block_f32((const float *)base + row, op, x);
+#endif
+            return col_block_f32((const float *)base + row, n, op, x);
+        }
+        case TTAK_COL_U64: {
+            uint64_t x;
+            memcpy(&x, operand, sizeof(x));
+#if defined(TTAK_HAS_AVX2)
+            if (n == 64) return avx2_block_int64((const uint64_t *)base + row, op, x, INT64_MIN);
+#endif
+            return col_block_u64((const uint64_t *)base + row, n, op, x);
+        }
+        case TTAK_COL_I64: {
+            int64_t x;
+            memcpy(&x, operand, sizeof(x));
+#if defined(TTAK_HAS_AVX2)
+            if (n == 64) return avx2_block_int64((const int64_t *)base + row, op, (uint64_t)x, 0);
+#endif
+            return col_block_i64((const int64_t *)base + row, n, op, x);
+        }
+        case TTAK_COL_F64: {
+            double x;
+            memcpy(&x, operand, sizeof(x));
+#if defined(TTAK_HAS_AVX2)
+            if (n == 64) return avx2_block_f64((const double *)base + row, op, x);
+#endif
+            return col_block_f64((const double *)base + row, n, op, x);
+        }
+    }
+    return 0;
+}
+
+size_t ttak_columnar_filter(const ttak_columnar_t *table, size_t col, ttak_col_op_t op,
+                            const void *operand, uint64_t *sel, bool refine) {
+    if (!table || col >= table->ncols || !operand || !sel) return 0;
+    size_t words = ttak_columnar_mask_words(table), hits = 0;
+    for (size_t w = 0; w < words; w++) {
+        size_t n = table->rows - w * 64 < 64 ? table->rows - w * 64 : 64;
+        uint64_t m = col_filter_block(table, col, w, n, op, operand);
+        if (refine) m &= sel[w];
+        sel[w] = m;
+        hits += (size_t)__builtin_popcountll(m);
+    }
+    return hits;
+}
+
+size_t ttak_columnar_gather(const ttak_columnar_t *table, size_t col, const uint64_t *sel, void *out) {
+    if (!table || col >= table->ncols || !sel || !out) return 0;
+    size_t words = ttak_columnar_mask_words(table), k = 0;
+    if (ttak_col_type_size(table->types[col]) == 4) {
+        const uint32_t *src = table->cols[col];
+        uint32_t *dst = out;
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t m = sel[w]; m; m &= m - 1) dst[k++] = src[w * 64 + (size_t)__builtin_ctzll(m)];
+        }
+    } else {
+        const uint64_t *src = table->cols[col];
+        uint64_t *dst = out;
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t m = sel[w]; m; m &= m - 1) dst[k++] = src[w * 64 + (size_t)__builtin_ctzll(m)];
+        }
+    }
+    return k;
+}
+
+/* ---- Scans ---- */
+
+typedef struct {
+    const ttak_columnar_t *table;
+    ttak_columnar_scan_fn fn;
+    void *ctx;
+    size_t begin;
+    size_t end;
+    size_t chunk;
+} col_scan_chunk_t;
+
+static void *col_scan_task(void *arg) {
+    col_scan_chunk_t *c = arg;
+    c->fn(c->table, c->begin, c->end, c->chunk, c->ctx);
+    return NULL;
+}
+
+size_t ttak_columnar_scan(const ttak_columnar_t *table, ttak_thread_pool_t *pool,
+                          ttak_columnar_scan_fn fn, void *ctx, uint64_t now) {
+    if (!table || !fn || table->rows == 0) return 0;
+    size_t n = table->rows / TTAK_COLUMNAR_MIN_CHUNK;
+    if (n < 1) n = 1;
+    if (n > TTAK_COLUMNAR_MAX_CHUNKS) n = TTAK_COLUMNAR_MAX_CHUNKS;
+    size_t per = ((table->rows + n - 1) / n + 63) & ~(size_t)63;
+    n = (table->rows + per - 1) / per;
+
+    col_scan_chunk_t chunks[TTAK_COLUMNAR_MAX_CHUNKS];
+    ttak_pool_batch_item_t items[TTAK_COLUMNAR_MAX_CHUNKS];
+    for (size_t i = 0; i < n; i++) {
+        size_t end = (i + 1) * per;
+        chunks[i] = (col_scan_chunk_t){ table, fn, ctx, i * per, end < table->rows ? end : table->rows, i };
+        items[i] = (ttak_pool_batch_item_t){ col_scan_task, &chunks[i] };
+    }
+
+    ttak_pool_batch_t *batch = pool && n > 1
+        ? ttak_thread_pool_submit_batch(pool, items + 1, n - 1, __TT_SCHED_NORMAL__, now) : NULL;
+    size_t queued = batch ? ttak_pool_batch_submitted(batch) : 0;
+    col_scan_task(&chunks[0]);
+    for (size_t i = 1 + queued; i < n; i++) col_scan_task(&chunks[i]);
+    if (batch) ttak_pool_batch_destroy(batch);
+    return n;
+}
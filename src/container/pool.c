@@ -1,96 +1,228 @@
 #include <ttak/container/pool.h>
-#include <ttak/mols_control.h>
 #include <ttak/sync/spinlock.h>
+#include <ttak/types/ttak_compiler.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define TTAK_POOL_OLS_ORDER        8U
-#define TTAK_POOL_OLS_ORDER_LOG2   3U
-#define TTAK_POOL_OLS_MASK         (TTAK_POOL_OLS_ORDER - 1U)
-#define TTAK_POOL_OLS_AREA         (TTAK_POOL_OLS_ORDER * TTAK_POOL_OLS_ORDER)
-#define TTAK_POOL_OLS_AREA_MASK    (TTAK_POOL_OLS_AREA - 1U)
-#define TTAK_POOL_OLS_AREA_SHIFT   6U
-#define TTAK_POOL_GF8_PRIMITIVE    0x3U /* x^3 + x + 1 polynomial */
-/* Orthogonal Latin lattice selection for deterministic slot traversal. */
-
-#ifndef TTAK_POOL_HAVE_ARCH_OLS
-#define TTAK_POOL_HAVE_ARCH_OLS 0
-#endif
+/** Items moved between a magazine and the shared stack at a time. */
+#define TTAK_POOL_MAG_BATCH (TTAK_OBJECT_POOL_MAG_CAPACITY / 2U)
+
+/** Stack entries store index + 1 in 32 bits, so this many items at most. */
+#define TTAK_POOL_INDEX_LIMIT ((uint64_t)UINT32_MAX)
+
+static _Atomic uint32_t g_pool_thread_seq;
+_Thread_local uint32_t ttak_object_pool_thread_mag = UINT32_MAX;
 
-/* GF(2^3) multiplication table for polynomial x^3 + x + 1 */
-static const uint8_t ttak_pool_gf8_mul_table[8][8] = {
-    {0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 2, 3, 4, 5, 6, 7},
-    {0, 2, 4, 6, 3, 1, 7, 5},
-    {0, 3, 6, 5, 7, 4, 1, 2},
-    {0, 4, 3, 7, 6, 2, 5, 1},
-    {0, 5, 1, 4, 2, 7, 3, 6},
-    {0, 6, 7, 1, 5, 3, 2, 4},
-    {0, 7, 5, 2, 1, 6, 4, 3}
-};
-
-static inline uint8_t ttak_pool_gf8_mul(uint8_t a, uint8_t b) {
-    return ttak_pool_gf8_mul_table[a & 7][b & 7];
-}
-
-#if TTAK_POOL_HAVE_ARCH_OLS
-/* Architecture-specific backend must provide this symbol when enabled. */
-extern uint8_t ttak_pool_arch_ols_lane(uint8_t lane_seed);
-#define ttak_pool_ols_lane(lane_seed) ttak_pool_arch_ols_lane(lane_seed)
+static void *pool_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
 #else
-static inline uint8_t ttak_pool_ols_lane(uint8_t lane_seed) {
-    uint8_t row = lane_seed & TTAK_POOL_OLS_MASK;
-    uint8_t col = (lane_seed >> TTAK_POOL_OLS_ORDER_LOG2) & TTAK_POOL_OLS_MASK;
-    uint8_t latin_a = row ^ col;
-    uint8_t latin_b = ttak_pool_gf8_mul(TTAK_POOL_GF8_PRIMITIVE, row) ^ col;
-    return (uint8_t)((latin_a << TTAK_POOL_OLS_ORDER_LOG2) | latin_b);
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
 }
+
+static void pool_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
 #endif
+}
 
-static inline uint8_t ttak_pool_ols_lane_advance(uint8_t lane_seed, uint8_t stride) {
-    return (uint8_t)((lane_seed + stride) & TTAK_POOL_OLS_AREA_MASK);
+/* Magazine slot of the calling thread, fixed for its lifetime. */
+static inline uint32_t pool_thread_slot(void) {
+    if (TTAK_UNLIKELY(ttak_object_pool_thread_mag == UINT32_MAX)) {
+        ttak_object_pool_thread_mag =
+            atomic_fetch_add_explicit(&g_pool_thread_seq, 1, memory_order_relaxed) % TTAK_OBJECT_POOL_MAGS;
+    }
+    return ttak_object_pool_thread_mag;
 }
 
-static inline size_t ttak_pool_chunk_count(size_t capacity) {
-    size_t tiles = (capacity + (TTAK_POOL_OLS_AREA - 1U)) >> TTAK_POOL_OLS_AREA_SHIFT;
-    return tiles ? tiles : 1U;
+/* A free item's first word links to the next one, as index + 1. */
+static inline _Atomic uint32_t *pool_link(const ttak_object_pool_t *pool, uint32_t idx) {
+    return (_Atomic uint32_t *)ttak_object_pool_item(pool, idx);
+}
+
+/* Maps @p ptr back to its index; false if the pool did not hand it out. */
+static _Bool pool_index_of(const ttak_object_pool_t *pool, const void *ptr, uint32_t *idx) {
+    uint32_t count = atomic_load_explicit(&pool->chunk_count, memory_order_acquire);
+    uint64_t limit = atomic_load_explicit(&pool->limit, memory_order_acquire);
+    uintptr_t addr = (uintptr_t)ptr;
+    for (uint32_t k = 0; k < count; ++k) {
+        uint64_t base = ttak_object_pool_chunk_base(pool, k);
+        uint64_t next = (k + 1 < count) ? ttak_object_pool_chunk_base(pool, k + 1) : limit;
+        uintptr_t start = (uintptr_t)pool->chunks[k];
+        if (addr < start || addr >= start + (size_t)(next - base) * pool->stride) continue;
+        size_t off = (size_t)(addr - start);
+        if (off % pool->stride != 0) return 0;
+        *idx = (uint32_t)(base + off / pool->stride);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Pops one item off the shared stack. The tag changes on every pop, so a
+ * head that was popped and pushed back between our load and CAS no longer
+ * matches even though its index does; reading the link of an item some
+ * other thread already took is harmless since chunks are never unmapped.
+ */
+static _Bool pool_stack_pop(ttak_object_pool_t *pool, uint32_t *idx) {
+    uint64_t head = atomic_load_explicit(&pool->free_head, memory_order_acquire);
+    for (;;) {
+        uint32_t top = (uint32_t)head;
+        if (!top) return 0;
+        uint32_t next = atomic_load_explicit(pool_link(pool, top - 1), memory_order_relaxed);
+        uint64_t desired = (((head >> 32) + 1) << 32) | next;
+        if (atomic_compare_exchange_weak_explicit(&pool->free_head, &head, desired,
+                                                  memory_order_acquire, memory_order_acquire)) {
+            *idx = top - 1;
+            return 1;
+        }
+    }
+}
+
+/* Pushes @p count items as one pre-linked chain with a single CAS. */
+static void pool_stack_push(ttak_object_pool_t *pool, const uint32_t *items, uint32_t count) {
+    for (uint32_t i = 0; i + 1 < count; ++i) {
+        atomic_store_explicit(pool_link(pool, items[i]), items[i + 1] + 1, memory_order_relaxed);
+    }
+    _Atomic uint32_t *tail = pool_link(pool, items[count - 1]);
+    uint64_t head = atomic_load_explicit(&pool->free_head, memory_order_relaxed);
+    uint64_t desired;
+    do {
+        atomic_store_explicit(tail, (uint32_t)head, memory_order_relaxed);
+        desired = (((head >> 32) + 1) << 32) | (items[0] + 1);
+    } while (!atomic_compare_exchange_weak_explicit(&pool->free_head, &head, desired,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+/* Publishes the next chunk. Called with grow_lock held. */
+static _Bool pool_add_chunk(ttak_object_pool_t *pool) {
+    uint32_t k = atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+    if (k >= TTAK_OBJECT_POOL_MAX_CHUNKS) return 0;
+    uint64_t base = ttak_object_pool_chunk_base(pool, k);
+    if (base >= pool->max_items) return 0;
+    uint64_t n = k ? base : pool->capacity;
+    if (n > pool->max_items - base) n = pool->max_items - base;
+    if (n > SIZE_MAX / pool->stride) return 0;
+
+    char *mem = pool_aligned_alloc((size_t)n * pool->stride);
+    _Atomic uint8_t *live = calloc((size_t)n, sizeof(*live));
+    if (!mem || !live) {
+        pool_aligned_free(mem);
+        free(live);
+        return 0;
+    }
+    pool->chunks[k] = mem;
+    pool->live[k] = live;
+    if (k == 0) pool->buffer = mem;
+    atomic_store_explicit(&pool->chunk_count, k + 1, memory_order_release);
+    atomic_store_explicit(&pool->limit, base + n, memory_order_release);
+    return 1;
+}
+
+/* Grows past @p seen_limit unless another thread already has. */
+static _Bool pool_grow(ttak_object_pool_t *pool, uint64_t seen_limit) {
+    _Bool ok = 1;
+    ttak_spin_lock(&pool->grow_lock);
+    if (atomic_load_explicit(&pool->limit, memory_order_relaxed) == seen_limit) {
+        ok = pool_add_chunk(pool);
+    }
+    ttak_spin_unlock(&pool->grow_lock);
+    return ok;
+}
+
+/* Claims up to @p want never-used items, growing the pool when needed. */
+static uint32_t pool_carve(ttak_object_pool_t *pool, uint32_t *out, uint32_t want) {
+    for (;;) {
+        uint64_t limit = atomic_load_explicit(&pool->limit, memory_order_acquire);
+        uint64_t carved = atomic_load_explicit(&pool->carved, memory_order_relaxed);
+        if (carved < limit) {
+            uint64_t n = limit - carved < want ? limit - carved : want;
+            if (!atomic_compare_exchange_weak_explicit(&pool->carved, &carved, carved + n,
+                                                       memory_order_relaxed, memory_order_relaxed)) {
+                continue;
+            }
+            for (uint64_t i = 0; i < n; ++i) out[i] = (uint32_t)(carved + i);
+            return (uint32_t)n;
+        }
+        if (!pool_grow(pool, limit)) return 0;
+    }
+}
+
+/* Takes up to @p want items parked in magazines other than @p self. */
+static uint32_t pool_steal(ttak_object_pool_t *pool, uint32_t *out, uint32_t want,
+                           const ttak_object_pool_mag_t *self) {
+    uint32_t got = 0;
+    for (uint32_t i = 0; i < TTAK_OBJECT_POOL_MAGS && got < want; ++i) {
+        ttak_object_pool_mag_t *mag = &pool->mags[i];
+        if (mag == self || !mag->count) continue;
+        if (atomic_exchange_explicit(&mag->busy, 1, memory_order_acquire)) continue;
+        while (mag->count && got < want) out[got++] = mag->items[--mag->count];
+        atomic_store_explicit(&mag->busy, 0, memory_order_release);
+    }
+    return got;
+}
+
+/*
+ * Gathers up to @p want items: the shared stack first, then fresh space,
+ * and only once the pool is at its ceiling, other threads' magazines.
+ */
+static uint32_t pool_gather(ttak_object_pool_t *pool, uint32_t *out, uint32_t want,
+                            const ttak_object_pool_mag_t *self) {
+    uint32_t got = 0;
+    while (got < want && pool_stack_pop(pool, &out[got])) ++got;
+    if (got) return got;
+    got = pool_carve(pool, out, want);
+    if (got) return got;
+    return pool_steal(pool, out, want, self);
 }
 
 /**
  * @brief Creates pool logic.
  */
 ttak_object_pool_t *ttak_object_pool_create(size_t capacity, size_t item_size) {
-    ttak_object_pool_t *pool = malloc(sizeof(ttak_object_pool_t));
+    return ttak_object_pool_create_ex(capacity, item_size, 0);
+}
+
+/**
+ * @brief Creates a pool and publishes its first chunk.
+ */
+ttak_object_pool_t *ttak_object_pool_create_ex(size_t capacity, size_t item_size, size_t max_items) {
+    if (!item_size) return NULL;
+    if (!capacity) capacity = 1;
+    if (capacity > ((size_t)1 << 31)) return NULL;
+
+    ttak_object_pool_t *pool = pool_aligned_alloc(sizeof(*pool));
     if (!pool) return NULL;
-    
-    pool->buffer = calloc(capacity, item_size);
-    pool->bitmap = calloc((capacity + 7) / 8, 1);
-    pool->capacity = capacity;
+    memset(pool, 0, sizeof(*pool));
+
+    uint32_t shift = 0;
+    while (((size_t)1 << shift) < capacity) ++shift;
     pool->item_size = item_size;
-    pool->used_count = 0;
-    pool->free_list = NULL;
-    pool->ols_chunk_count = ttak_pool_chunk_count(capacity);
-    pool->ols_chunk_cursor = 0;
-    pool->ols_lane_guard = 1U;
-    pool->ols_lane_seed = pool->ols_lane_guard;
-    pool->ols_lane_stride = 9U; /* Coprime to 64 to cover the entire lattice. */
-    pool->last_recycled_index = SIZE_MAX;
-    ttak_spin_init(&pool->lock);
-    
-    if (!pool->buffer || !pool->bitmap) {
-        free(pool->buffer);
-        free(pool->bitmap);
-        free(pool);
-        return NULL;
+    pool->stride = item_size < sizeof(uint32_t)
+                       ? sizeof(uint32_t)
+                       : (item_size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+    pool->capacity = (size_t)1 << shift;
+    pool->chunk_shift = shift;
+    pool->max_items = (max_items && (uint64_t)max_items < TTAK_POOL_INDEX_LIMIT)
+                          ? max_items
+                          : (size_t)TTAK_POOL_INDEX_LIMIT;
+    ttak_spin_init(&pool->grow_lock);
+    atomic_init(&pool->chunk_count, 0);
+    atomic_init(&pool->free_head, 0);
+    atomic_init(&pool->carved, 0);
+    atomic_init(&pool->limit, 0);
+    for (uint32_t i = 0; i < TTAK_OBJECT_POOL_MAGS; ++i) {
+        atomic_init(&pool->mags[i].busy, 0);
     }
 
-    /* Build an O(1) LIFO free list when items are large enough to hold a pointer. */
-    if (item_size >= sizeof(void *)) {
-        for (size_t i = 0; i < capacity; ++i) {
-            void *item = (char *)pool->buffer + (i * item_size);
-            *(void **)item = pool->free_list;
-            pool->free_list = item;
-        }
+    if (!pool_add_chunk(pool)) {
+        pool_aligned_free(pool);
+        return NULL;
     }
     return pool;
 }
@@ -99,121 +231,61 @@ ttak_object_pool_t *ttak_object_pool_create(size_t capacity, size_t item_size) {
  * @brief Destroys pool.
  */
 void ttak_object_pool_destroy(ttak_object_pool_t *pool) {
-    if (pool) {
-        free(pool->buffer);
-        free(pool->bitmap);
-        free(pool);
+    if (!pool) return;
+    uint32_t count = atomic_load_explicit(&pool->chunk_count, memory_order_acquire);
+    for (uint32_t k = 0; k < count; ++k) {
+        pool_aligned_free(pool->chunks[k]);
+        free((void *)pool->live[k]);
     }
+    pool_aligned_free(pool);
 }
 
 /**
- * @brief Fast allocation using bitmap scan.
+ * @brief Pops from the thread's magazine, refilling it a batch at a time.
  */
-void *ttak_object_pool_alloc(ttak_object_pool_t *pool) {
-    ttak_spin_lock(&pool->lock);
-
-    /* Fast path: pop from the LIFO free list. */
-    if (pool->free_list) {
-        void *item = pool->free_list;
-        pool->free_list = *(void **)item;
-        pool->used_count++;
-        size_t idx = (size_t)((char *)item - (char *)pool->buffer) / pool->item_size;
-        size_t byte = idx >> 3;
-        uint8_t mask = (uint8_t)(1U << (idx & 7U));
-        pool->bitmap[byte] |= mask;
-        ttak_spin_unlock(&pool->lock);
-        return item;
-    }
-
-    if (pool->used_count >= pool->capacity) {
-        ttak_spin_unlock(&pool->lock);
-        return NULL;
-    }
-
-    if (pool->last_recycled_index != SIZE_MAX) {
-        size_t idx = pool->last_recycled_index;
-        size_t byte = idx >> 3;
-        uint8_t mask = (uint8_t)(1U << (idx & 7U));
-        if (idx < pool->capacity && !(pool->bitmap[byte] & mask)) {
-            pool->bitmap[byte] |= mask;
-            pool->used_count++;
-            pool->last_recycled_index = SIZE_MAX;
-            ttak_spin_unlock(&pool->lock);
-            return (char *)pool->buffer + (idx * pool->item_size);
-        }
-        pool->last_recycled_index = SIZE_MAX;
-    }
-
-    uint8_t lane = pool->ols_lane_seed;
-    size_t chunk = pool->ols_chunk_cursor;
-    const uint8_t stride = pool->ols_lane_stride;
-    const uint8_t guard = pool->ols_lane_guard;
-    const size_t chunk_count = pool->ols_chunk_count ? pool->ols_chunk_count : 1U;
-
-    size_t probed = 0;
-    while (probed < pool->capacity) {
-        size_t idx = (chunk << TTAK_POOL_OLS_AREA_SHIFT) + ttak_pool_ols_lane(lane);
-        lane = ttak_pool_ols_lane_advance(lane, stride);
-        const uint16_t node_id = (uint16_t)(idx & (size_t)(TTAK_MOLS_NODE_COUNT - 1U));
-        const uint32_t damp = ttak_apply_mols_control(node_id, (uint32_t)idx);
-        const uint32_t jitter = damp ^ (uint32_t)idx;
-        const uint8_t extra = (uint8_t)(jitter & TTAK_POOL_OLS_AREA_MASK);
-        if (extra != 0U) {
-            lane = ttak_pool_ols_lane_advance(lane, extra);
-        }
-        if (lane == guard) {
-            chunk++;
-            if (chunk >= chunk_count) chunk = 0;
-        }
-
-        if (idx >= pool->capacity) {
-            ++probed;
-            continue;
-        }
-
-        size_t byte = idx >> 3;
-        uint8_t mask = (uint8_t)(1U << (idx & 7U));
-        if (!(pool->bitmap[byte] & mask)) {
-            pool->bitmap[byte] |= mask;
-            pool->used_count++;
-            pool->ols_lane_seed = lane;
-            pool->ols_chunk_cursor = chunk;
-            ttak_spin_unlock(&pool->lock);
-            return (char *)pool->buffer + (idx * pool->item_size);
+void *(ttak_object_pool_alloc)(ttak_object_pool_t *pool) {
+    if (!pool) return NULL;
+    ttak_object_pool_mag_t *mag = &pool->mags[pool_thread_slot()];
+    uint32_t idx;
+    if (TTAK_LIKELY(!atomic_exchange_explicit(&mag->busy, 1, memory_order_acquire))) {
+        if (TTAK_UNLIKELY(mag->count == 0)) {
+            mag->count = pool_gather(pool, mag->items, TTAK_POOL_MAG_BATCH, mag);
         }
-        ++probed;
+        _Bool got = mag->count != 0;
+        if (got) idx = mag->items[--mag->count];
+        atomic_store_explicit(&mag->busy, 0, memory_order_release);
+        if (!got) return NULL;
+    } else if (!pool_gather(pool, &idx, 1, NULL)) {
+        return NULL;
     }
-
-    pool->ols_lane_seed = lane;
-    pool->ols_chunk_cursor = chunk;
-    ttak_spin_unlock(&pool->lock);
-    return NULL;
+    atomic_store_explicit(ttak_object_pool_live(pool, idx), 1, memory_order_relaxed);
+    return ttak_object_pool_item(pool, idx);
 }
 
 /**
- * @brief Frees object by clearing bit.
+ * @brief Pushes onto the thread's magazine, spilling its colder half when full.
  */
 void ttak_object_pool_free(ttak_object_pool_t *pool, void *ptr) {
-    if (!ptr) return;
-    
-    ttak_spin_lock(&pool->lock);
-    ptrdiff_t offset = (char *)ptr - (char *)pool->buffer;
-    
-    // Bounds and alignment check
-    if (offset < 0 || (size_t)offset >= (pool->capacity * pool->item_size) || (offset % pool->item_size) != 0) {
-        ttak_spin_unlock(&pool->lock);
-        return; // Invalid pointer
+    if (!pool || !ptr) return;
+    uint32_t idx;
+    if (!pool_index_of(pool, ptr, &idx)) return;
+    if (!atomic_exchange_explicit(ttak_object_pool_live(pool, idx), 0, memory_order_relaxed)) return;
+
+    ttak_object_pool_mag_t *mag = &pool->mags[pool_thread_slot()];
+    if (TTAK_UNLIKELY(atomic_exchange_explicit(&mag->busy, 1, memory_order_acquire))) {
+        pool_stack_push(pool, &idx, 1);
+        return;
     }
-    
-    size_t idx = offset / pool->item_size;
-    if (pool->bitmap[idx / 8] & (1 << (idx % 8))) {
-        pool->bitmap[idx / 8] &= ~(1 << (idx % 8));
-        pool->used_count--;
-        pool->last_recycled_index = idx;
-        if (pool->item_size >= sizeof(void *)) {
-            *(void **)ptr = pool->free_list;
-            pool->free_list = ptr;
-        }
+    if (TTAK_UNLIKELY(mag->count == TTAK_OBJECT_POOL_MAG_CAPACITY)) {
+        pool_stack_push(pool, mag->items, TTAK_POOL_MAG_BATCH);
+        memmove(mag->items, mag->items + TTAK_POOL_MAG_BATCH,
+                (TTAK_OBJECT_POOL_MAG_CAPACITY - TTAK_POOL_MAG_BATCH) * sizeof(mag->items[0]));
+        mag->count -= TTAK_POOL_MAG_BATCH;
     }
-    ttak_spin_unlock(&pool->lock);
+    mag->items[mag->count++] = idx;
+    atomic_store_explicit(&mag->busy, 0, memory_order_release);
+}
+
+size_t ttak_object_pool_capacity(const ttak_object_pool_t *pool) {
+    return pool ? (size_t)atomic_load_explicit(&pool->limit, memory_order_acquire) : 0;
 }
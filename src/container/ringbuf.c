@@ -3,31 +3,96 @@
 #include <ttak/timing/timing.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
+
+/** MPMC slot header: the sequence number, padded so the item stays max-aligned. */
+#define RB_SEQ_HDR (sizeof(size_t) > _Alignof(max_align_t) ? sizeof(size_t) : _Alignof(max_align_t))
+
+static void *rb_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
+}
+
+static void rb_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+static inline char *rb_item(ttak_ringbuf_t *rb, size_t index) {
+    return (char *)rb->buffer + index * rb->item_size;
+}
+
+static inline _Atomic size_t *rb_mpmc_seq(ttak_ringbuf_t *rb, size_t pos) {
+    return (_Atomic size_t *)((char *)rb->buffer + (pos & rb->mask) * rb->stride);
+}
+
+static inline char *rb_mpmc_item(ttak_ringbuf_t *rb, size_t pos) {
+    return (char *)rb->buffer + (pos & rb->mask) * rb->stride + RB_SEQ_HDR;
+}
 
 /**
  * @brief Creates ring buffer.
  */
 ttak_ringbuf_t *ttak_ringbuf_create(size_t capacity, size_t item_size) {
+    return ttak_ringbuf_create_ex(capacity, item_size, TTAK_RINGBUF_LOCKED);
+}
+
+/**
+ * @brief Creates a ring buffer in @p mode, rounding lock-free capacities to a power of two.
+ */
+ttak_ringbuf_t *ttak_ringbuf_create_ex(size_t capacity, size_t item_size, ttak_ringbuf_mode_t mode) {
     if (!capacity || !item_size) return NULL;
     if (capacity > SIZE_MAX / item_size) return NULL;
 
-    ttak_ringbuf_t *rb = malloc(sizeof(ttak_ringbuf_t));
+    size_t stride = item_size;
+    if (mode != TTAK_RINGBUF_LOCKED) {
+        if (capacity > (SIZE_MAX >> 1) + 1) return NULL;
+        size_t pow2 = 1;
+        while (pow2 < capacity) pow2 <<= 1;
+        capacity = pow2;
+        if (mode == TTAK_RINGBUF_MPMC) {
+            const size_t align = _Alignof(max_align_t);
+            if (item_size > SIZE_MAX - RB_SEQ_HDR - align) return NULL;
+            stride = (RB_SEQ_HDR + item_size + align - 1) / align * align;
+        }
+        if (capacity > SIZE_MAX / stride) return NULL;
+    }
+
+    ttak_ringbuf_t *rb = rb_aligned_alloc(sizeof(ttak_ringbuf_t));
     if (!rb) return NULL;
-    
-    // Using simple malloc for internal buffer to avoid lifecycle complexity inside ringbuf
-    rb->buffer = malloc(capacity * item_size);
+
+    // Using simple aligned allocation for internal buffer to avoid lifecycle complexity inside ringbuf
+    rb->buffer = rb_aligned_alloc(capacity * stride);
     if (!rb->buffer) {
-        free(rb);
+        rb_aligned_free(rb);
         return NULL;
     }
-    
+
     rb->capacity = capacity;
     rb->item_size = item_size;
     rb->head = 0;
     rb->tail = 0;
     rb->full = false;
     ttak_rwlock_init(&rb->lock);
-    
+    rb->mode = mode;
+    rb->mask = capacity - 1;
+    rb->stride = stride;
+    atomic_init(&rb->prod_pos, 0);
+    rb->prod_cached = 0;
+    atomic_init(&rb->cons_pos, 0);
+    rb->cons_cached = 0;
+    if (mode == TTAK_RINGBUF_MPMC) {
+        for (size_t i = 0; i < capacity; i++) atomic_init(rb_mpmc_seq(rb, i), i);
+    }
+
     return rb;
 }
 
@@ -36,30 +101,133 @@ ttak_ringbuf_t *ttak_ringbuf_create(size_t capacity, size_t item_size) {
  */
 void ttak_ringbuf_destroy(ttak_ringbuf_t *rb) {
     if (rb) {
-        free(rb->buffer);
+        rb_aligned_free(rb->buffer);
         ttak_rwlock_destroy(&rb->lock);
-        free(rb);
+        rb_aligned_free(rb);
+    }
+}
+
+/* ---- SPSC: each side refreshes its cached view of the other only when it runs out. ---- */
+
+static size_t spsc_writable(ttak_ringbuf_t *rb, size_t pos, size_t want) {
+    size_t room = rb->capacity - (pos - rb->prod_cached);
+    if (room < want) {
+        rb->prod_cached = atomic_load_explicit(&rb->cons_pos, memory_order_acquire);
+        room = rb->capacity - (pos - rb->prod_cached);
+    }
+    return room < want ? room : want;
+}
+
+static size_t spsc_readable(ttak_ringbuf_t *rb, size_t pos, size_t want) {
+    size_t ready = rb->cons_cached - pos;
+    if (ready < want) {
+        rb->cons_cached = atomic_load_explicit(&rb->prod_pos, memory_order_acquire);
+        ready = rb->cons_cached - pos;
+    }
+    return ready < want ? ready : want;
+}
+
+static size_t spsc_push_n(ttak_ringbuf_t *rb, const void *items, size_t count) {
+    size_t pos = atomic_load_explicit(&rb->prod_pos, memory_order_relaxed);
+    size_t n = spsc_writable(rb, pos, count);
+    if (n == 0) return 0;
+    size_t idx = pos & rb->mask;
+    size_t first = rb->capacity - idx < n ? rb->capacity - idx : n;
+    memcpy(rb_item(rb, idx), items, first * rb->item_size);
+    memcpy(rb_item(rb, 0), (const char *)items + first * rb->item_size, (n - first) * rb->item_size);
+    atomic_store_explicit(&rb->prod_pos, pos + n, memory_order_release);
+    return n;
+}
+
+static size_t spsc_pop_n(ttak_ringbuf_t *rb, void *out_items, size_t count) {
+    size_t pos = atomic_load_explicit(&rb->cons_pos, memory_order_relaxed);
+    size_t n = spsc_readable(rb, pos, count);
+    if (n == 0) return 0;
+    if (out_items) {
+        size_t idx = pos & rb->mask;
+        size_t first = rb->capacity - idx < n ? rb->capacity - idx : n;
+        memcpy(out_items, rb_item(rb, idx), first * rb->item_size);
+        memcpy((char *)out_items + first * rb->item_size, rb_item(rb, 0), (n - first) * rb->item_size);
+    }
+    atomic_store_explicit(&rb->cons_pos, pos + n, memory_order_release);
+    return n;
+}
+
+/* ---- MPMC: a slot's sequence is pos when free for the producer of pos, pos + 1 when full. ---- */
+
+/**
+ * @brief Claims up to @p count consecutive positions from @p cursor.
+ *
+ * @p ready is the sequence offset a claimable slot shows (0 for producers,
+ * 1 for consumers). The run stops at the first slot not yet ready, and the
+ * whole run is taken with one CAS.
+ *
+ * @return Positions claimed, starting at @p *start.
+ */
+static size_t mpmc_claim(ttak_ringbuf_t *rb, _Atomic size_t *cursor, size_t ready, size_t count, size_t *start) {
+    size_t pos = atomic_load_explicit(cursor, memory_order_relaxed);
+    for (;;) {
+        size_t k = 0;
+        intptr_t dif = 0;
+        while (k < count) {
+            size_t seq = atomic_load_explicit(rb_mpmc_seq(rb, pos + k), memory_order_acquire);
+            dif = (intptr_t)seq - (intptr_t)(pos + k + ready);
+            if (dif != 0) break;
+            k++;
+        }
+        if (k == 0) {
+            if (dif < 0) return 0; /* Full (producer) or empty (consumer). */
+            pos = atomic_load_explicit(cursor, memory_order_relaxed);
+            continue;
+        }
+        if (atomic_compare_exchange_weak_explicit(cursor, &pos, pos + k,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            *start = pos;
+            return k;
+        }
+    }
+}
+
+static size_t mpmc_push_n(ttak_ringbuf_t *rb, const void *items, size_t count) {
+    size_t pos;
+    size_t n = mpmc_claim(rb, &rb->prod_pos, 0, count, &pos);
+    for (size_t i = 0; i < n; i++) {
+        memcpy(rb_mpmc_item(rb, pos + i), (const char *)items + i * rb->item_size, rb->item_size);
+        atomic_store_explicit(rb_mpmc_seq(rb, pos + i), pos + i + 1, memory_order_release);
     }
+    return n;
+}
+
+static size_t mpmc_pop_n(ttak_ringbuf_t *rb, void *out_items, size_t count) {
+    size_t pos;
+    size_t n = mpmc_claim(rb, &rb->cons_pos, 1, count, &pos);
+    for (size_t i = 0; i < n; i++) {
+        if (out_items) memcpy((char *)out_items + i * rb->item_size, rb_mpmc_item(rb, pos + i), rb->item_size);
+        atomic_store_explicit(rb_mpmc_seq(rb, pos + i), pos + i + rb->capacity, memory_order_release);
+    }
+    return n;
 }
 
 /**
  * @brief Pushes item (copy).
  */
-bool ttak_ringbuf_push(ttak_ringbuf_t *rb, const void *item) {
+bool (ttak_ringbuf_push)(ttak_ringbuf_t *rb, const void *item) {
+    if (rb->mode != TTAK_RINGBUF_LOCKED) return ttak_ringbuf_push_n(rb, item, 1) == 1;
+
     ttak_rwlock_wrlock(&rb->lock);
     if (rb->full) {
         ttak_rwlock_unlock(&rb->lock);
         return false;
     }
-    
+
     char *dest = (char *)rb->buffer + (rb->head * rb->item_size);
     memcpy(dest, item, rb->item_size);
-    
+
     rb->head = (rb->head + 1) % rb->capacity;
     if (rb->head == rb->tail) {
         rb->full = true;
     }
-    
+
     ttak_rwlock_unlock(&rb->lock);
     return true;
 }
@@ -67,35 +235,195 @@ bool ttak_ringbuf_push(ttak_ringbuf_t *rb, const void *item) {
 /**
  * @brief Pops item (copy).
  */
-bool ttak_ringbuf_pop(ttak_ringbuf_t *rb, void *out_item) {
+bool (ttak_ringbuf_pop)(ttak_ringbuf_t *rb, void *out_item) {
+    if (rb->mode != TTAK_RINGBUF_LOCKED) return ttak_ringbuf_pop_n(rb, out_item, 1) == 1;
+
     ttak_rwlock_wrlock(&rb->lock);
     if (ttak_ringbuf_is_empty(rb)) {
         ttak_rwlock_unlock(&rb->lock);
         return false;
     }
-    
+
     char *src = (char *)rb->buffer + (rb->tail * rb->item_size);
     if (out_item) {
         memcpy(out_item, src, rb->item_size);
     }
-    
+
     rb->tail = (rb->tail + 1) % rb->capacity;
     rb->full = false;
-    
+
+    ttak_rwlock_unlock(&rb->lock);
+    return true;
+}
+
+/**
+ * @brief Pushes a run of items (copy).
+ */
+size_t ttak_ringbuf_push_n(ttak_ringbuf_t *rb, const void *items, size_t count) {
+    if (!rb || !items || count == 0) return 0;
+    if (rb->mode == TTAK_RINGBUF_SPSC) return spsc_push_n(rb, items, count);
+    if (rb->mode == TTAK_RINGBUF_MPMC) return mpmc_push_n(rb, items, count);
+
+    ttak_rwlock_wrlock(&rb->lock);
+    size_t n = 0;
+    while (n < count && !rb->full) {
+        memcpy(rb_item(rb, rb->head), (const char *)items + n * rb->item_size, rb->item_size);
+        rb->head = (rb->head + 1) % rb->capacity;
+        if (rb->head == rb->tail) rb->full = true;
+        n++;
+    }
+    ttak_rwlock_unlock(&rb->lock);
+    return n;
+}
+
+/**
+ * @brief Pops a run of items (copy).
+ */
+size_t ttak_ringbuf_pop_n(ttak_ringbuf_t *rb, void *out_items, size_t count) {
+    if (!rb || count == 0) return 0;
+    if (rb->mode == TTAK_RINGBUF_SPSC) return spsc_pop_n(rb, out_items, count);
+    if (rb->mode == TTAK_RINGBUF_MPMC) return mpmc_pop_n(rb, out_items, count);
+
+    ttak_rwlock_wrlock(&rb->lock);
+    size_t n = 0;
+    while (n < count && !ttak_ringbuf_is_empty(rb)) {
+        if (out_items) memcpy((char *)out_items + n * rb->item_size, rb_item(rb, rb->tail), rb->item_size);
+        rb->tail = (rb->tail + 1) % rb->capacity;
+        rb->full = false;
+        n++;
+    }
     ttak_rwlock_unlock(&rb->lock);
+    return n;
+}
+
+/**
+ * @brief Reserves a slot for in-place writing; the locked mode keeps the lock until commit.
+ */
+bool ttak_ringbuf_reserve(ttak_ringbuf_t *rb, ttak_ringbuf_slot_t *slot) {
+    if (!rb || !slot) return false;
+    size_t pos;
+    switch (rb->mode) {
+        case TTAK_RINGBUF_SPSC:
+            pos = atomic_load_explicit(&rb->prod_pos, memory_order_relaxed);
+            if (spsc_writable(rb, pos, 1) == 0) return false;
+            slot->ptr = rb_item(rb, pos & rb->mask);
+            break;
+        case TTAK_RINGBUF_MPMC:
+            if (mpmc_claim(rb, &rb->prod_pos, 0, 1, &pos) == 0) return false;
+            slot->ptr = rb_mpmc_item(rb, pos);
+            break;
+        case TTAK_RINGBUF_LOCKED:
+        default:
+            ttak_rwlock_wrlock(&rb->lock);
+            if (rb->full) {
+                ttak_rwlock_unlock(&rb->lock);
+                return false;
+            }
+            pos = rb->head;
+            slot->ptr = rb_item(rb, pos);
+            break;
+    }
+    slot->pos = pos;
+    return true;
+}
+
+/**
+ * @brief Publishes a reserved slot.
+ */
+void ttak_ringbuf_commit(ttak_ringbuf_t *rb, ttak_ringbuf_slot_t *slot) {
+    if (!rb || !slot) return;
+    switch (rb->mode) {
+        case TTAK_RINGBUF_SPSC:
+            atomic_store_explicit(&rb->prod_pos, slot->pos + 1, memory_order_release);
+            break;
+        case TTAK_RINGBUF_MPMC:
+            atomic_store_explicit(rb_mpmc_seq(rb, slot->pos), slot->pos + 1, memory_order_release);
+            break;
+        case TTAK_RINGBUF_LOCKED:
+        default:
+            rb->head = (rb->head + 1) % rb->capacity;
+            if (rb->head == rb->tail) rb->full = true;
+            ttak_rwlock_unlock(&rb->lock);
+            break;
+    }
+}
+
+/**
+ * @brief Claims the oldest item for in-place reading; the locked mode keeps the lock until release.
+ */
+bool ttak_ringbuf_claim(ttak_ringbuf_t *rb, ttak_ringbuf_slot_t *slot) {
+    if (!rb || !slot) return false;
+    size_t pos;
+    switch (rb->mode) {
+        case TTAK_RINGBUF_SPSC:
+            pos = atomic_load_explicit(&rb->cons_pos, memory_order_relaxed);
+            if (spsc_readable(rb, pos, 1) == 0) return false;
+            slot->ptr = rb_item(rb, pos & rb->mask);
+            break;
+        case TTAK_RINGBUF_MPMC:
+            if (mpmc_claim(rb, &rb->cons_pos, 1, 1, &pos) == 0) return false;
+            slot->ptr = rb_mpmc_item(rb, pos);
+            break;
+        case TTAK_RINGBUF_LOCKED:
+        default:
+            ttak_rwlock_wrlock(&rb->lock);
+            if (ttak_ringbuf_is_empty(rb)) {
+                ttak_rwlock_unlock(&rb->lock);
+                return false;
+            }
+            pos = rb->tail;
+            slot->ptr = rb_item(rb, pos);
+            break;
+    }
+    slot->pos = pos;
     return true;
 }
 
+/**
+ * @brief Returns a claimed slot to the producers.
+ */
+void ttak_ringbuf_release(ttak_ringbuf_t *rb, ttak_ringbuf_slot_t *slot) {
+    if (!rb || !slot) return;
+    switch (rb->mode) {
+        case TTAK_RINGBUF_SPSC:
+            atomic_store_explicit(&rb->cons_pos, slot->pos + 1, memory_order_release);
+            break;
+        case TTAK_RINGBUF_MPMC:
+            atomic_store_explicit(rb_mpmc_seq(rb, slot->pos), slot->pos + rb->capacity, memory_order_release);
+            break;
+        case TTAK_RINGBUF_LOCKED:
+        default:
+            rb->tail = (rb->tail + 1) % rb->capacity;
+            rb->full = false;
+            ttak_rwlock_unlock(&rb->lock);
+            break;
+    }
+}
+
+/**
+ * @brief Items between the consumer and producer positions, clamped to the capacity.
+ */
+static size_t rb_lockfree_count(ttak_ringbuf_t *rb) {
+    size_t cons = atomic_load_explicit(&rb->cons_pos, memory_order_acquire);
+    size_t prod = atomic_load_explicit(&rb->prod_pos, memory_order_acquire);
+    size_t n = prod - cons;
+    if (n > rb->capacity) n = (intptr_t)n < 0 ? 0 : rb->capacity;
+    return n;
+}
+
 bool ttak_ringbuf_is_empty(ttak_ringbuf_t *rb) {
+    if (rb->mode != TTAK_RINGBUF_LOCKED) return rb_lockfree_count(rb) == 0;
     return (!rb->full && (rb->head == rb->tail));
 }
 
 bool ttak_ringbuf_is_full(ttak_ringbuf_t *rb) {
+    if (rb->mode != TTAK_RINGBUF_LOCKED) return rb_lockfree_count(rb) == rb->capacity;
     return rb->full;
 }
 
 size_t ttak_ringbuf_count(ttak_ringbuf_t *rb) {
+    if (rb->mode != TTAK_RINGBUF_LOCKED) return rb_lockfree_count(rb);
     if (rb->full) return rb->capacity;
     if (rb->head >= rb->tail) return rb->head - rb->tail;
     return rb->capacity + rb->head - rb->tail;
-}
\ No newline at end of file
+}
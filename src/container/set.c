@@ -1,4 +1,5 @@
 #include <ttak/container/set.h>
+#include <ttak/ht/hash.h>
 #include <stddef.h>
 
 /**
@@ -16,6 +17,52 @@ void ttak_set_init(ttak_set_t *set, size_t capacity,
                    void (*key_free)(void*)) {
     if (!set) return;
     ttak_table_init(&set->table, capacity, hash_func, key_cmp, key_free, NULL);
+    set->filter = NULL;
+    set->filter_stale = 0;
+}
+
+static uint64_t ttak_set_hash(const ttak_set_t *set, const void *key, size_t key_len) {
+    const ttak_table_t *t = &set->table;
+    return t->hash_func(key, key_len, t->k0, t->k1);
+}
+
+/* Adds every live key in one generation of the table's arrays to @p filter. */
+static void ttak_set_filter_fill(const ttak_set_t *set, ttak_bloom_t *filter, uint8_t *ctrls,
+                                 void **keys, size_t *key_lens, size_t capacity) {
+    if (!ctrls) return;
+    for (size_t i = 0; i < capacity + TTAK_HT_PAD; i++) {
+        if (TTAK_CTRL_FULL(ctrls[i])) ttak_bloom_add_hash(filter, ttak_set_hash(set, keys[i], key_lens[i]));
+    }
+}
+
+/*
+ * Replaces the filter with one built from the live keys, sized for
+ * @p expected. On allocation failure the old filter stays: it still has
+ * no false negatives, only more false positives.
+ */
+static bool ttak_set_filter_rebuild(ttak_set_t *set, size_t expected) {
+    ttak_bloom_t *filter = ttak_bloom_create(expected, 0);
+    if (!filter) return false;
+    const ttak_table_t *t = &set->table;
+    ttak_set_filter_fill(set, filter, t->ctrls, t->keys, t->key_lens, t->capacity);
+    ttak_set_filter_fill(set, filter, t->old_ctrls, t->old_keys, t->old_key_lens, t->old_capacity);
+    ttak_bloom_destroy(set->filter);
+    set->filter = filter;
+    set->filter_stale = 0;
+    return true;
+}
+
+/**
+ * @brief Build a front filter for the set from its current contents.
+ *
+ * @param set      Set to accelerate.
+ * @param expected Keys to size the filter for; grown past automatically.
+ * @return true if the filter was built.
+ */
+bool ttak_set_enable_filter(ttak_set_t *set, size_t expected) {
+    if (!set || !set->table.ctrls) return false;
+    if (expected < set->table.size) expected = set->table.size;
+    return ttak_set_filter_rebuild(set, expected);
 }
 
 /**
@@ -31,8 +78,15 @@ void ttak_set_init(ttak_set_t *set, size_t capacity,
  */
 void ttak_set_add(ttak_set_t *set, void *key, size_t key_len, uint64_t now) {
     if (!set) return;
-    if (ttak_table_get(&set->table, key, key_len, now) != NULL) {
+    if (ttak_table_get(&set->table, key, key_len, now) == NULL) {
         ttak_table_put(&set->table, key, key_len, (void*)1, now);
+        if (set->filter) {
+            if (set->table.size > set->filter->capacity) {
+                ttak_set_filter_rebuild(set, set->table.size * 2);
+                if (set->table.size <= set->filter->capacity) return;
+            }
+            ttak_bloom_add_hash(set->filter, ttak_set_hash(set, key, key_len));
+        }
     }
 }
 
@@ -47,6 +101,9 @@ void ttak_set_add(ttak_set_t *set, void *key, size_t key_len, uint64_t now) {
  */
 bool ttak_set_contains(ttak_set_t *set, const void *key, size_t key_len, uint64_t now) {
     if (!set) return false;
+    if (set->filter && !ttak_bloom_may_contain_hash(set->filter, ttak_set_hash(set, key, key_len))) {
+        return false;
+    }
     return ttak_table_get(&set->table, key, key_len, now) != NULL;
 }
 
@@ -61,7 +118,11 @@ bool ttak_set_contains(ttak_set_t *set, const void *key, size_t key_len, uint64_
  */
 bool ttak_set_remove(ttak_set_t *set, const void *key, size_t key_len, uint64_t now) {
     if (!set) return false;
-    return ttak_table_remove(&set->table, key, key_len, now);
+    if (!ttak_table_remove(&set->table, key, key_len, now)) return false;
+    if (set->filter && ++set->filter_stale * 2 > set->filter->count) {
+        ttak_set_filter_rebuild(set, set->filter->capacity);
+    }
+    return true;
 }
 
 /**
@@ -73,4 +134,6 @@ bool ttak_set_remove(ttak_set_t *set, const void *key, size_t key_len, uint64_t
 void ttak_set_destroy(ttak_set_t *set, uint64_t now) {
     if (!set) return;
     ttak_table_destroy(&set->table, now);
+    ttak_bloom_destroy(set->filter);
+    set->filter = NULL;
 }
@@ -0,0 +1,278 @@
+#include <ttak/container/skiplist.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mem/mem.h>
+#include <sched.h>
+
+#define SL_MARK ((uintptr_t)1)
+
+#define sl_ptr(w) ((ttak_skiplist_node_t *)((w) & ~SL_MARK))
+#define sl_marked(w) (((w) & SL_MARK) != 0)
+#define sl_load(p) atomic_load_explicit((p), memory_order_acquire)
+
+static ttak_skiplist_node_t *sl_node_new(uint64_t key, uintptr_t value, unsigned height) {
+    ttak_skiplist_node_t *node =
+        ttak_dangerous_calloc(1, sizeof(*node) + height * sizeof(node->next[0]));
+    if (!node) return NULL;
+    node->key = key;
+    atomic_init(&node->value, value);
+    node->height = (uint8_t)height;
+    return node;
+}
+
+/* Tower height: each extra level with probability 1/4. */
+static unsigned sl_random_height(void) {
+    static _Thread_local uint64_t state;
+    if (!state) state = (uint64_t)(uintptr_t)&state * 0x9E3779B97F4A7C15ULL | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    uint64_t r = state;
+    unsigned h = 1;
+    while (h < TTAK_SKIPLIST_MAX_LEVEL && (r & 3) == 0) {
+        h++;
+        r >>= 2;
+    }
+    return h;
+}
+
+static inline bool sl_deleted(ttak_skiplist_node_t *node) {
+    return sl_marked(sl_load(&node->next[0]));
+}
+
+/*
+ * Fills @p preds and @p succs with the nodes around @p key on every level,
+ * unlinking marked nodes on the way. Returns the node holding @p key, or
+ * NULL. Must run pinned.
+ */
+static ttak_skiplist_node_t *sl_find(ttak_skiplist_t *list, uint64_t key, ttak_skiplist_node_t **preds,
+                                     ttak_skiplist_node_t **succs) {
+retry:;
+    ttak_skiplist_node_t *pred = list->head;
+    for (int l = TTAK_SKIPLIST_MAX_LEVEL - 1; l >= 0; l--) {
+        ttak_skiplist_node_t *cur = sl_ptr(sl_load(&pred->next[l]));
+        while (cur) {
+            uintptr_t nxt = sl_load(&cur->next[l]);
+            if (sl_marked(nxt)) {
+                uintptr_t expect = (uintptr_t)cur;
+                if (!atomic_compare_exchange_strong(&pred->next[l], &expect, nxt & ~SL_MARK)) goto retry;
+                cur = sl_ptr(nxt);
+                continue;
+            }
+            if (cur->key >= key) break;
+            pred = cur;
+            cur = sl_ptr(nxt);
+        }
+        preds[l] = pred;
+        succs[l] = cur;
+    }
+    return succs[0] && succs[0]->key == key ? succs[0] : NULL;
+}
+
+/*
+ * Read-only descent from @p start at level @p level: leaves in @p preds the
+ * last live node below @p key per level and returns the first live node at
+ * or above @p key on level 0.
+ */
+static ttak_skiplist_node_t *sl_descend(ttak_skiplist_node_t *start, int level, uint64_t key,
+                                        ttak_skiplist_node_t **preds) {
+    ttak_skiplist_node_t *pred = start, *cur = NULL;
+    for (int l = level; l >= 0; l--) {
+        cur = sl_ptr(sl_load(&pred->next[l]));
+        while (cur) {
+            uintptr_t nxt = sl_load(&cur->next[l]);
+            // Marked nodes are passed over but never become a start point.
+            if (!sl_marked(nxt) && cur->key >= key) break;
+            if (!sl_marked(nxt)) pred = cur;
+            cur = sl_ptr(nxt);
+        }
+        if (preds) preds[l] = pred;
+    }
+    return cur;
+}
+
+bool ttak_skiplist_init(ttak_skiplist_t *list) {
+    if (!list) return false;
+    list->head = sl_node_new(0, 0, TTAK_SKIPLIST_MAX_LEVEL);
+    atomic_init(&list->size, 0);
+    if (list->head) atomic_store_explicit(&list->head->linked, 1, memory_order_relaxed);
+    return list->head != NULL;
+}
+
+void ttak_skiplist_destroy(ttak_skiplist_t *list) {
+    if (!list || !list->head) return;
+    ttak_skiplist_node_t *node = list->head;
+    while (node) {
+        ttak_skiplist_node_t *next = sl_ptr(atomic_load_explicit(&node->next[0], memory_order_relaxed));
+        ttak_dangerous_free(node);
+        node = next;
+    }
+    list->head = NULL;
+    atomic_store_explicit(&list->size, 0, memory_order_relaxed);
+}
+
+bool ttak_skiplist_put(ttak_skiplist_t *list, uint64_t key, uintptr_t value) {
+    ttak_skiplist_node_t *preds[TTAK_SKIPLIST_MAX_LEVEL], *succs[TTAK_SKIPLIST_MAX_LEVEL];
+    ttak_skiplist_node_t *node = NULL;
+    unsigned height = sl_random_height();
+
+    ttak_epoch_enter();
+    for (;;) {
+        ttak_skiplist_node_t *found = sl_find(list, key, preds, succs);
+        if (found) {
+            atomic_store_explicit(&found->value, value, memory_order_release);
+            ttak_epoch_exit();
+            if (node) ttak_dangerous_free(node);
+            return true;
+        }
+        if (!node && !(node = sl_node_new(key, value, height))) {
+            ttak_epoch_exit();
+            return false;
+        }
+        for (unsigned l = 0; l < height; l++) {
+            atomic_store_explicit(&node->next[l], (uintptr_t)succs[l], memory_order_relaxed);
+        }
+        // Linking level 0 is the insert; the upper levels only speed up searches.
+        uintptr_t expect = (uintptr_t)succs[0];
+        if (atomic_compare_exchange_strong(&preds[0]->next[0], &expect, (uintptr_t)node)) break;
+    }
+    atomic_fetch_add_explicit(&list->size, 1, memory_order_relaxed);
+
+    for (unsigned l = 1; l < height; l++) {
+        for (;;) {
+            uintptr_t expect = (uintptr_t)succs[l];
+            if (atomic_compare_exchange_strong(&preds[l]->next[l], &expect, (uintptr_t)node)) break;
+            // Nobody else reaches this level of the node yet, so it is safe to re-aim.
+            sl_find(list, key, preds, succs);
+            atomic_store_explicit(&node->next[l], (uintptr_t)succs[l], memory_order_relaxed);
+        }
+    }
+    atomic_store_explicit(&node->linked, 1, memory_order_release);
+    ttak_epoch_exit();
+    return true;
+}
+
+/*
+ * Marks @p node deleted, then unlinks and retires it. Returns false if
+ * another thread removed it first. Must run pinned.
+ */
+static bool sl_remove_node(ttak_skiplist_t *list, ttak_skiplist_node_t *node) {
+    // A half-linked tower could be linked again after unlinking; wait for it.
+    for (unsigned spins = 0; !atomic_load_explicit(&node->linked, memory_order_acquire); spins++) {
+        if (spins & 63) ttak_arch_pause();
+        else sched_yield();
+    }
+    for (int l = node->height - 1; l > 0; l--) {
+        atomic_fetch_or_explicit(&node->next[l], SL_MARK, memory_order_acq_rel);
+    }
+    uintptr_t nxt = sl_load(&node->next[0]);
+    do {
+        if (sl_marked(nxt)) return false;
+    } while (!atomic_compare_exchange_weak(&node->next[0], &nxt, nxt | SL_MARK));
+
+    atomic_fetch_sub_explicit(&list->size, 1, memory_order_relaxed);
+    ttak_skiplist_node_t *preds[TTAK_SKIPLIST_MAX_LEVEL], *succs[TTAK_SKIPLIST_MAX_LEVEL];
+    sl_find(list, node->key, preds, succs);
+    ttak_epoch_retire(node, ttak_dangerous_free);
+    return true;
+}
+
+bool ttak_skiplist_remove(ttak_skiplist_t *list, uint64_t key) {
+    ttak_skiplist_node_t *preds[TTAK_SKIPLIST_MAX_LEVEL], *succs[TTAK_SKIPLIST_MAX_LEVEL];
+    ttak_epoch_enter();
+    ttak_skiplist_node_t *node = sl_find(list, key, preds, succs);
+    bool removed = node && sl_remove_node(list, node);
+    ttak_epoch_exit();
+    return removed;
+}
+
+bool ttak_skiplist_get_pinned(ttak_skiplist_t *list, uint64_t key, uintptr_t *out) {
+    ttak_skiplist_node_t *cur = sl_descend(list->head, TTAK_SKIPLIST_MAX_LEVEL - 1, key, NULL);
+    if (!cur || cur->key != key) return false;
+    if (out) *out = atomic_load_explicit(&cur->value, memory_order_acquire);
+    return true;
+}
+
+bool ttak_skiplist_get(ttak_skiplist_t *list, uint64_t key, uintptr_t *out) {
+    ttak_epoch_enter();
+    bool found = ttak_skiplist_get_pinned(list, key, out);
+    ttak_epoch_exit();
+    return found;
+}
+
+void ttak_skiplist_finger_init(ttak_skiplist_t *list, ttak_skiplist_finger_t *finger) {
+    for (int l = 0; l < TTAK_SKIPLIST_MAX_LEVEL; l++) finger->preds[l] = list->head;
+}
+
+bool ttak_skiplist_get_finger(ttak_skiplist_t *list, ttak_skiplist_finger_t *finger, uint64_t key,
+                              uintptr_t *out) {
+    // Climb until the cached predecessor is still live, below key, and its
+    // successor on that level is not: the search can start there.
+    int l = 0;
+    ttak_skiplist_node_t *start = list->head;
+    for (; l < TTAK_SKIPLIST_MAX_LEVEL; l++) {
+        ttak_skiplist_node_t *p = finger->preds[l];
+        if (p != list->head && (p->key >= key || sl_deleted(p))) continue;
+        ttak_skiplist_node_t *succ = sl_ptr(sl_load(&p->next[l]));
+        if (!succ || succ->key >= key || l == TTAK_SKIPLIST_MAX_LEVEL - 1) {
+            start = p;
+            break;
+        }
+    }
+    if (l == TTAK_SKIPLIST_MAX_LEVEL) l--;
+    ttak_skiplist_node_t *cur = sl_descend(start, l, key, finger->preds);
+    if (!cur || cur->key != key) return false;
+    if (out) *out = atomic_load_explicit(&cur->value, memory_order_acquire);
+    return true;
+}
+
+size_t ttak_skiplist_range(ttak_skiplist_t *list, uint64_t lo, uint64_t hi, ttak_skiplist_visit_t visit,
+                           void *ctx) {
+    if (!list || !visit || lo > hi) return 0;
+    size_t visited = 0;
+    ttak_epoch_enter();
+    ttak_skiplist_node_t *cur = sl_descend(list->head, TTAK_SKIPLIST_MAX_LEVEL - 1, lo, NULL);
+    for (; cur && cur->key <= hi; cur = sl_ptr(sl_load(&cur->next[0]))) {
+        if (sl_deleted(cur)) continue;
+        visited++;
+        if (!visit(cur->key, atomic_load_explicit(&cur->value, memory_order_acquire), ctx)) break;
+    }
+    ttak_epoch_exit();
+    return visited;
+}
+
+size_t ttak_skiplist_remove_range(ttak_skiplist_t *list, uint64_t lo, uint64_t hi) {
+    if (!list || lo > hi) return 0;
+    size_t removed = 0;
+    ttak_epoch_enter();
+    ttak_skiplist_node_t *cur = sl_descend(list->head, TTAK_SKIPLIST_MAX_LEVEL - 1, lo, NULL);
+    while (cur && cur->key <= hi) {
+        // The successor survives our own unlinking: marked pointers still lead on.
+        ttak_skiplist_node_t *next = sl_ptr(sl_load(&cur->next[0]));
+        if (!sl_deleted(cur) && sl_remove_node(list, cur)) removed++;
+        cur = next;
+    }
+    ttak_epoch_exit();
+    return removed;
+}
+
+bool ttak_skiplist_pop_min(ttak_skiplist_t *list, uint64_t *key, uintptr_t *value) {
+    ttak_epoch_enter();
+    ttak_skiplist_node_t *cur = sl_ptr(sl_load(&list->head->next[0]));
+    for (; cur; cur = sl_ptr(sl_load(&cur->next[0]))) {
+        if (sl_deleted(cur)) continue;
+        if (sl_remove_node(list, cur)) {
+            // Still pinned, so the retired node stays readable.
+            if (key) *key = cur->key;
+            if (value) *value = atomic_load_explicit(&cur->value, memory_order_acquire);
+            ttak_epoch_exit();
+            return true;
+        }
+    }
+    ttak_epoch_exit();
+    return false;
+}
+
+size_t ttak_skiplist_size(ttak_skiplist_t *list) {
+    return list ? atomic_load_explicit(&list->size, memory_order_relaxed) : 0;
+}
@@ -0,0 +1,368 @@
+#include <ttak/container/ttl_cache.h>
+#include <ttak/ht/hash.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mem/mem.h>
+#include <ttak/sync/waitword.h>
+#include <ttak/timing/timing.h>
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert((TTAK_TTL_CACHE_SHARDS & (TTAK_TTL_CACHE_SHARDS - 1)) == 0, "shards must be a power of two");
+
+/*
+ * An entry and its value in one block, so it retires as one pointer. The
+ * ring links, @c linked and @c armed are guarded by the shard lock; readers
+ * only touch the key, expiry, value and reference bit.
+ */
+struct ttak_ttl_cache_entry {
+    uint64_t key;
+    uint64_t expires_ns;            /* 0: never. */
+    size_t len;
+    size_t charge;                  /* Bytes counted against the budget. */
+    ttak_ttl_cache_t *cache;
+    ttak_ttl_cache_entry_t *prev;
+    ttak_ttl_cache_entry_t *next;
+    ttak_timer_t timer;
+    _Atomic uint8_t ref;            /* Set by hits, cleared by the CLOCK hand. */
+    bool linked;                    /* In the ring and the index. */
+    bool armed;                     /* The timer was armed; it may be in flight. */
+    _Alignas(16) uint8_t data[];
+};
+
+/* One computation in progress and the callers waiting on it. */
+struct ttak_ttl_cache_flight {
+    ttak_ttl_cache_flight_t *next;
+    uint64_t key;
+    uint32_t refs;                  /* Leader plus waiters; guarded by the shard lock. */
+    _Atomic uint32_t done;
+    ttak_eventcount_t ec;
+    ttak_ttl_cache_status_t status; /* Written before @c done. */
+    size_t len;
+    uint8_t *buf;
+};
+
+static inline ttak_ttl_cache_shard_t *ttl_cache_shard(ttak_ttl_cache_t *cache, uint64_t key) {
+    uint64_t h = gen_hash_wyhash((uintptr_t)key, cache->seed);
+    return &cache->shards[(h >> 32) & (TTAK_TTL_CACHE_SHARDS - 1)];
+}
+
+static inline bool ttl_cache_live(const ttak_ttl_cache_entry_t *e, uint64_t now_ns) {
+    return e->expires_ns == 0 || now_ns < e->expires_ns;
+}
+
+/* Entry currently indexed under @p key. Its shard lock must be held. */
+static ttak_ttl_cache_entry_t *ttl_cache_lookup_locked(ttak_ttl_cache_t *cache, uint64_t key) {
+    size_t v = 0;
+    return ttak_cmap_get(cache->index, (uintptr_t)key, &v) ? (ttak_ttl_cache_entry_t *)v : NULL;
+}
+
+/* New entries join just behind the hand, so they are the last it reaches. */
+static void ttl_cache_ring_insert(ttak_ttl_cache_shard_t *sh, ttak_ttl_cache_entry_t *e) {
+    if (!sh->hand) {
+        e->prev = e->next = e;
+        sh->hand = e;
+        return;
+    }
+    e->next = sh->hand;
+    e->prev = sh->hand->prev;
+    sh->hand->prev->next = e;
+    sh->hand->prev = e;
+}
+
+static void ttl_cache_ring_remove(ttak_ttl_cache_shard_t *sh, ttak_ttl_cache_entry_t *e) {
+    if (e->next == e) {
+        sh->hand = NULL;
+    } else {
+        e->prev->next = e->next;
+        e->next->prev = e->prev;
+        if (sh->hand == e) sh->hand = e->next;
+    }
+    e->prev = e->next = NULL;
+}
+
+/*
+ * Takes @p e out of its shard and retires it. A timer already handed to
+ * its callback cannot be cancelled; the callback then finds the entry
+ * unlinked and retires it instead.
+ */
+static void ttl_cache_unlink(ttak_ttl_cache_t *cache, ttak_ttl_cache_shard_t *sh, ttak_ttl_cache_entry_t *e,
+                             bool drop_index) {
+    ttl_cache_ring_remove(sh, e);
+    sh->bytes -= e->charge;
+    sh->entries--;
+    if (drop_index) ttak_cmap_remove(cache->index, (uintptr_t)e->key);
+    e->linked = false;
+    if (!e->armed || ttak_timer_cancel(&cache->wheel, &e->timer)) {
+        ttak_epoch_retire(e, ttak_dangerous_free);
+    }
+}
+
+/* Runs the CLOCK hand until @p need more bytes fit in the shard's budget. */
+static void ttl_cache_evict(ttak_ttl_cache_t *cache, ttak_ttl_cache_shard_t *sh, size_t need) {
+    while (sh->hand && sh->bytes + need > sh->budget) {
+        ttak_ttl_cache_entry_t *e = sh->hand;
+        if (atomic_load_explicit(&e->ref, memory_order_relaxed)) {
+            atomic_store_explicit(&e->ref, 0, memory_order_relaxed);
+            sh->hand = e->next;
+            continue;
+        }
+        ttl_cache_unlink(cache, sh, e, true);
+        sh->evictions++;
+    }
+}
+
+static void *ttl_cache_expire(void *arg) {
+    ttak_ttl_cache_entry_t *e = arg;
+    ttak_ttl_cache_t *cache = e->cache;
+    ttak_ttl_cache_shard_t *sh = ttl_cache_shard(cache, e->key);
+    ttak_mutex_lock(&sh->lock);
+    if (e->linked) {
+        e->armed = false;
+        ttl_cache_unlink(cache, sh, e, true);
+        sh->expirations++;
+    } else {
+        ttak_epoch_retire(e, ttak_dangerous_free);
+    }
+    ttak_mutex_unlock(&sh->lock);
+    return NULL;
+}
+
+ttak_ttl_cache_t *ttak_ttl_cache_create(const ttak_ttl_cache_config_t *cfg) {
+    ttak_ttl_cache_config_t c = cfg ? *cfg : (ttak_ttl_cache_config_t){0};
+    if (!c.max_bytes) c.max_bytes = TTAK_TTL_CACHE_DEFAULT_BYTES;
+    if (!c.max_value) c.max_value = TTAK_TTL_CACHE_DEFAULT_MAX_VALUE;
+    if (!c.init_cap) c.init_cap = 1024;
+
+    ttak_ttl_cache_t *cache = ttak_dangerous_alloc(sizeof(*cache));
+    if (!cache) return NULL;
+    cache->index = ttak_cmap_create(c.init_cap);
+    if (!cache->index) {
+        ttak_dangerous_free(cache);
+        return NULL;
+    }
+    cache->seed = 0xe7037ed1a0b428dbULL ^ (uint64_t)(uintptr_t)cache;
+    cache->max_value = c.max_value;
+    for (size_t s = 0; s < TTAK_TTL_CACHE_SHARDS; s++) {
+        ttak_ttl_cache_shard_t *sh = &cache->shards[s];
+        ttak_mutex_init(&sh->lock);
+        sh->budget = c.max_bytes / TTAK_TTL_CACHE_SHARDS;
+        atomic_init(&sh->hits, 0);
+        atomic_init(&sh->misses, 0);
+    }
+    ttak_timer_wheel_init(&cache->wheel, c.tick_ns, ttak_get_tick_count_ns());
+    if (!ttak_timer_wheel_start(&cache->wheel, NULL)) {
+        ttak_timer_wheel_destroy(&cache->wheel);
+        for (size_t s = 0; s < TTAK_TTL_CACHE_SHARDS; s++) ttak_mutex_destroy(&cache->shards[s].lock);
+        ttak_cmap_destroy(cache->index);
+        ttak_dangerous_free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void ttak_ttl_cache_destroy(ttak_ttl_cache_t *cache) {
+    if (!cache) return;
+    /* Joins the expiry thread; no callback runs after this. */
+    ttak_timer_wheel_destroy(&cache->wheel);
+    for (size_t s = 0; s < TTAK_TTL_CACHE_SHARDS; s++) {
+        ttak_ttl_cache_shard_t *sh = &cache->shards[s];
+        while (sh->hand) {
+            ttak_ttl_cache_entry_t *e = sh->hand;
+            ttl_cache_ring_remove(sh, e);
+            ttak_dangerous_free(e);
+        }
+        ttak_mutex_destroy(&sh->lock);
+    }
+    ttak_cmap_destroy(cache->index);
+    ttak_dangerous_free(cache);
+}
+
+ttak_ttl_cache_status_t ttak_ttl_cache_put(ttak_ttl_cache_t *cache, uint64_t key, const void *data, size_t len,
+                                           uint64_t ttl_ns, uint64_t now_ns) {
+    ttak_ttl_cache_shard_t *sh = ttl_cache_shard(cache, key);
+    size_t charge = sizeof(ttak_ttl_cache_entry_t) + len;
+    if (charge > sh->budget) return TTAK_TTL_CACHE_TOO_LARGE;
+
+    ttak_ttl_cache_entry_t *e = ttak_dangerous_alloc(charge);
+    if (!e) return TTAK_TTL_CACHE_NOMEM;
+    e->key = key;
+    e->expires_ns = ttl_ns ? now_ns + ttl_ns : 0;
+    e->len = len;
+    e->charge = charge;
+    e->cache = cache;
+    atomic_init(&e->ref, 0);
+    if (len) memcpy(e->data, data, len);
+
+    ttak_mutex_lock(&sh->lock);
+    /* The old entry stays indexed until the new one replaces it, so readers never see a gap. */
+    ttak_ttl_cache_entry_t *old = ttl_cache_lookup_locked(cache, key);
+    if (old) ttl_cache_unlink(cache, sh, old, false);
+    ttl_cache_evict(cache, sh, charge);
+    if (!ttak_cmap_put(cache->index, (uintptr_t)key, (size_t)(uintptr_t)e)) {
+        if (old) ttak_cmap_remove(cache->index, (uintptr_t)key);
+        ttak_mutex_unlock(&sh->lock);
+        ttak_dangerous_free(e);
+        return TTAK_TTL_CACHE_NOMEM;
+    }
+    e->linked = true;
+    ttl_cache_ring_insert(sh, e);
+    sh->bytes += charge;
+    sh->entries++;
+    if (e->expires_ns) {
+        e->armed = true;
+        ttak_timer_init(&e->timer, ttl_cache_expire, e);
+        ttak_timer_arm(&cache->wheel, &e->timer, e->expires_ns);
+    }
+    ttak_mutex_unlock(&sh->lock);
+    return TTAK_TTL_CACHE_OK;
+}
+
+const void *ttak_ttl_cache_get_pinned(ttak_ttl_cache_t *cache, uint64_t key, size_t *len, uint64_t now_ns) {
+    ttak_ttl_cache_shard_t *sh = ttl_cache_shard(cache, key);
+    size_t v = 0;
+    ttak_ttl_cache_entry_t *e = ttak_cmap_get_pinned(cache->index, (uintptr_t)key, &v)
+                                    ? (ttak_ttl_cache_entry_t *)v : NULL;
+    if (!e || !ttl_cache_live(e, now_ns)) {
+        atomic_fetch_add_explicit(&sh->misses, 1, memory_order_relaxed);
+        return NULL;
+    }
+    /* Only the first hit since the hand passed writes the line. */
+    if (!atomic_load_explicit(&e->ref, memory_order_relaxed)) {
+        atomic_store_explicit(&e->ref, 1, memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&sh->hits, 1, memory_order_relaxed);
+    if (len) *len = e->len;
+    return e->data;
+}
+
+static ttak_ttl_cache_status_t ttl_cache_copy_out(const void *src, size_t n, void *dst, size_t cap, size_t *len) {
+    if (len) *len = n;
+    if (n > cap) return TTAK_TTL_CACHE_TOO_SMALL;
+    if (n) memcpy(dst, src, n);
+    return TTAK_TTL_CACHE_OK;
+}
+
+ttak_ttl_cache_status_t ttak_ttl_cache_get(ttak_ttl_cache_t *cache, uint64_t key, void *dst, size_t cap,
+                                           size_t *len, uint64_t now_ns) {
+    ttak_ttl_cache_status_t st = TTAK_TTL_CACHE_MISS;
+    size_t n = 0;
+    ttak_epoch_enter();
+    const void *p = ttak_ttl_cache_get_pinned(cache, key, &n, now_ns);
+    if (p) st = ttl_cache_copy_out(p, n, dst, cap, len);
+    ttak_epoch_exit();
+    return st;
+}
+
+bool ttak_ttl_cache_remove(ttak_ttl_cache_t *cache, uint64_t key) {
+    ttak_ttl_cache_shard_t *sh = ttl_cache_shard(cache, key);
+    ttak_mutex_lock(&sh->lock);
+    ttak_ttl_cache_entry_t *e = ttl_cache_lookup_locked(cache, key);
+    if (e) ttl_cache_unlink(cache, sh, e, true);
+    ttak_mutex_unlock(&sh->lock);
+    return e != NULL;
+}
+
+static void ttl_cache_flight_release(ttak_ttl_cache_shard_t *sh, ttak_ttl_cache_flight_t *f) {
+    ttak_mutex_lock(&sh->lock);
+    bool last = --f->refs == 0;
+    ttak_mutex_unlock(&sh->lock);
+    if (last) {
+        free(f->buf);
+        free(f);
+    }
+}
+
+static ttak_ttl_cache_status_t ttl_cache_flight_result(ttak_ttl_cache_shard_t *sh, ttak_ttl_cache_flight_t *f,
+                                                       void *dst, size_t cap, size_t *len) {
+    ttak_ttl_cache_status_t st = f->status == TTAK_TTL_CACHE_OK
+                                     ? ttl_cache_copy_out(f->buf, f->len, dst, cap, len) : f->status;
+    ttl_cache_flight_release(sh, f);
+    return st;
+}
+
+ttak_ttl_cache_status_t ttak_ttl_cache_get_or_compute(ttak_ttl_cache_t *cache, uint64_t key,
+                                                      ttak_ttl_cache_compute_fn fn, void *arg,
+                                                      uint64_t ttl_ns, void *dst, size_t cap,
+                                                      size_t *len, uint64_t now_ns) {
+    ttak_ttl_cache_status_t st = ttak_ttl_cache_get(cache, key, dst, cap, len, now_ns);
+    if (st != TTAK_TTL_CACHE_MISS) return st;
+
+    ttak_ttl_cache_shard_t *sh = ttl_cache_shard(cache, key);
+    ttak_mutex_lock(&sh->lock);
+    ttak_ttl_cache_flight_t *f = sh->flights;
+    while (f && f->key != key) f = f->next;
+    if (f) {
+        f->refs++;
+        sh->coalesced++;
+        ttak_mutex_unlock(&sh->lock);
+        while (!atomic_load_explicit(&f->done, memory_order_acquire)) {
+            uint32_t ticket = ttak_eventcount_prepare(&f->ec);
+            if (atomic_load_explicit(&f->done, memory_order_acquire)) {
+                ttak_eventcount_cancel(&f->ec);
+                break;
+            }
+            ttak_eventcount_wait(&f->ec, ticket);
+        }
+        return ttl_cache_flight_result(sh, f, dst, cap, len);
+    }
+
+    /* A leader may have stored the value between our miss and the lock. */
+    st = ttak_ttl_cache_get(cache, key, dst, cap, len, now_ns);
+    if (st != TTAK_TTL_CACHE_MISS) {
+        ttak_mutex_unlock(&sh->lock);
+        return st;
+    }
+    f = calloc(1, sizeof(*f));
+    uint8_t *buf = f ? malloc(cache->max_value ? cache->max_value : 1) : NULL;
+    if (!buf) {
+        ttak_mutex_unlock(&sh->lock);
+        free(f);
+        return TTAK_TTL_CACHE_NOMEM;
+    }
+    f->key = key;
+    f->refs = 1;
+    f->buf = buf;
+    ttak_eventcount_init(&f->ec);
+    f->next = sh->flights;
+    sh->flights = f;
+    sh->computes++;
+    ttak_mutex_unlock(&sh->lock);
+
+    size_t n = 0;
+    if (!fn(key, buf, cache->max_value, &n, arg)) {
+        f->status = TTAK_TTL_CACHE_FAILED;
+    } else if (n > cache->max_value) {
+        f->status = TTAK_TTL_CACHE_TOO_LARGE;
+    } else {
+        /* The value is served even if it cannot be cached. */
+        f->status = TTAK_TTL_CACHE_OK;
+        f->len = n;
+        ttak_ttl_cache_put(cache, key, buf, n, ttl_ns, ttak_get_tick_count_ns());
+    }
+
+    ttak_mutex_lock(&sh->lock);
+    ttak_ttl_cache_flight_t **pp = &sh->flights;
+    while (*pp != f) pp = &(*pp)->next;
+    *pp = f->next;
+    atomic_store_explicit(&f->done, 1, memory_order_release);
+    ttak_mutex_unlock(&sh->lock);
+    ttak_eventcount_notify_all(&f->ec);
+    return ttl_cache_flight_result(sh, f, dst, cap, len);
+}
+
+void ttak_ttl_cache_stats(ttak_ttl_cache_t *cache, ttak_ttl_cache_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    for (size_t s = 0; s < TTAK_TTL_CACHE_SHARDS; s++) {
+        ttak_ttl_cache_shard_t *sh = &cache->shards[s];
+        ttak_mutex_lock(&sh->lock);
+        out->entries += sh->entries;
+        out->bytes += sh->bytes;
+        out->evictions += sh->evictions;
+        out->expirations += sh->expirations;
+        out->computes += sh->computes;
+        out->coalesced += sh->coalesced;
+        ttak_mutex_unlock(&sh->lock);
+        out->hits += atomic_load_explicit(&sh->hits, memory_order_relaxed);
+        out->misses += atomic_load_explicit(&sh->misses, memory_order_relaxed);
+    }
+}
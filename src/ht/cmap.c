@@ -0,0 +1,279 @@
+#include <ttak/ht/cmap.h>
+#include <ttak/ht/group.h>
+#include <ttak/ht/hash.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mem/mem.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/types/ttak_compiler.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Low hash bits pick the shard; the slot uses the bits above them. */
+#define TTAK_CMAP_SHARD_BITS 6
+
+_Static_assert((1U << TTAK_CMAP_SHARD_BITS) == TTAK_CMAP_SHARDS, "shard bits must match TTAK_CMAP_SHARDS");
+
+static void *cmap_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
+}
+
+static void cmap_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+static size_t cmap_round_pow2(size_t n) {
+    size_t cap = 16;
+    while (cap < n) cap <<= 1;
+    return cap;
+}
+
+/* One block holds the header and all three arrays, so a table retires as one pointer. */
+static ttak_cmap_table_t *cmap_table_alloc(size_t cap) {
+    size_t slots = cap + TTAK_HT_PAD;
+    size_t bytes = sizeof(ttak_cmap_table_t) + slots * (sizeof(uintptr_t) + sizeof(size_t) + sizeof(uint8_t));
+    ttak_cmap_table_t *t = ttak_dangerous_calloc(1, bytes);
+    if (!t) return NULL;
+    t->cap = cap;
+    t->keys = (_Atomic uintptr_t *)(t + 1);
+    t->values = (_Atomic size_t *)(t->keys + slots);
+    t->ctrls = (uint8_t *)(t->values + slots);
+    return t;
+}
+
+static inline ttak_cmap_shard_t *cmap_shard(ttak_cmap_t *map, uint64_t h) {
+    return &map->shards[h & (TTAK_CMAP_SHARDS - 1)];
+}
+
+static inline size_t cmap_home(const ttak_cmap_table_t *t, uint64_t h) {
+    return (size_t)(h >> TTAK_CMAP_SHARD_BITS) & (t->cap - 1);
+}
+
+static inline void cmap_store_ctrl(ttak_cmap_table_t *t, size_t idx, uint8_t ctrl) {
+    atomic_store_explicit((_Atomic uint8_t *)&t->ctrls[idx], ctrl, memory_order_release);
+}
+
+/*
+ * Slot of @p key in @p t, or SIZE_MAX. Safe against a concurrent writer:
+ * control bytes are read a group at a time without atomics and may be
+ * stale, which readers detect through the shard's sequence count.
+ */
+static size_t cmap_find(const ttak_cmap_table_t *t, uintptr_t key, uint64_t h) {
+    size_t slots = t->cap + TTAK_HT_PAD;
+    uint8_t tag = TTAK_CTRL_H2(h);
+    size_t pos = cmap_home(t, h);
+
+    for (size_t n = ttak_ht_probe_limit(slots); n > 0; n--) {
+        const uint8_t *group = t->ctrls + pos;
+        uint64_t m = ttak_ht_group_match(group, tag);
+        uint64_t empty = ttak_ht_group_match_empty(group);
+        atomic_thread_fence(memory_order_acquire);
+        while (m != 0) {
+            size_t idx = pos + ttak_ht_mask_next(&m);
+            if (atomic_load_explicit(&t->keys[idx], memory_order_relaxed) == key) return idx;
+        }
+        if (empty != 0) break;
+        pos = ttak_ht_probe_next(pos, slots);
+    }
+    return SIZE_MAX;
+}
+
+/* First EMPTY or DELETED slot on @p h's probe path. Writer only. */
+static size_t cmap_find_free(const ttak_cmap_table_t *t, uint64_t h) {
+    size_t slots = t->cap + TTAK_HT_PAD;
+    size_t pos = cmap_home(t, h);
+    for (size_t n = ttak_ht_probe_limit(slots); n > 0; n--) {
+        uint64_t m = ttak_ht_group_match_free(t->ctrls + pos);
+        if (m != 0) return pos + ttak_ht_mask_next(&m);
+        pos = ttak_ht_probe_next(pos, slots);
+    }
+    return SIZE_MAX;
+}
+
+/*
+ * Builds a table of @p new_cap from the shard's current one and publishes
+ * it. Readers keep probing the old table, which no writer touches again,
+ * until the epoch lets it go.
+ */
+static ttak_cmap_table_t *cmap_shard_resize(ttak_cmap_t *map, ttak_cmap_shard_t *sh, size_t new_cap) {
+    ttak_cmap_table_t *old = atomic_load_explicit(&sh->table, memory_order_relaxed);
+    ttak_cmap_table_t *t = cmap_table_alloc(new_cap);
+    if (!t) return NULL;
+
+    size_t old_slots = old->cap + TTAK_HT_PAD;
+    for (size_t i = 0; i < old_slots; i++) {
+        if (!TTAK_CTRL_FULL(old->ctrls[i])) continue;
+        uintptr_t key = atomic_load_explicit(&old->keys[i], memory_order_relaxed);
+        uint64_t h = gen_hash_wyhash(key, map->seed);
+        size_t idx = cmap_find_free(t, h);
+        atomic_store_explicit(&t->keys[idx], key, memory_order_relaxed);
+        atomic_store_explicit(&t->values[idx],
+                              atomic_load_explicit(&old->values[i], memory_order_relaxed),
+                              memory_order_relaxed);
+        t->ctrls[idx] = TTAK_CTRL_H2(h);
+    }
+
+    atomic_store_explicit(&sh->table, t, memory_order_release);
+    sh->deleted = 0;
+    ttak_epoch_retire(old, ttak_dangerous_free);
+    return t;
+}
+
+ttak_cmap_t *ttak_cmap_create(size_t init_cap) {
+    ttak_cmap_t *map = cmap_aligned_alloc(sizeof(ttak_cmap_t));
+    if (!map) return NULL;
+    memset(map, 0, sizeof(*map));
+    map->seed = 0xa0761d6478bd642fULL ^ (uint64_t)(uintptr_t)map;
+
+    size_t cap = cmap_round_pow2((init_cap / TTAK_CMAP_SHARDS) * 10 / 7 + 1);
+    for (size_t s = 0; s < TTAK_CMAP_SHARDS; s++) {
+        ttak_cmap_shard_t *sh = &map->shards[s];
+        ttak_cmap_table_t *t = cmap_table_alloc(cap);
+        if (!t) {
+            for (size_t i = 0; i < s; i++) {
+                ttak_dangerous_free(atomic_load(&map->shards[i].table));
+                ttak_mutex_destroy(&map->shards[i].lock);
+            }
+            cmap_aligned_free(map);
+            return NULL;
+        }
+        atomic_init(&sh->seq, 0);
+        atomic_init(&sh->table, t);
+        atomic_init(&sh->size, 0);
+        sh->deleted = 0;
+        ttak_mutex_init(&sh->lock);
+    }
+    return map;
+}
+
+void ttak_cmap_destroy(ttak_cmap_t *map) {
+    if (!map) return;
+    for (size_t s = 0; s < TTAK_CMAP_SHARDS; s++) {
+        ttak_dangerous_free(atomic_load(&map->shards[s].table));
+        ttak_mutex_destroy(&map->shards[s].lock);
+    }
+    cmap_aligned_free(map);
+}
+
+bool ttak_cmap_put(ttak_cmap_t *map, uintptr_t key, size_t val) {
+    uint64_t h = gen_hash_wyhash(key, map->seed);
+    ttak_cmap_shard_t *sh = cmap_shard(map, h);
+
+    ttak_mutex_lock(&sh->lock);
+    ttak_cmap_table_t *t = atomic_load_explicit(&sh->table, memory_order_relaxed);
+
+    /* Replacing a value never moves the key, so readers need no retry. */
+    size_t idx = cmap_find(t, key, h);
+    if (idx != SIZE_MAX) {
+        atomic_store_explicit(&t->values[idx], val, memory_order_release);
+        ttak_mutex_unlock(&sh->lock);
+        return true;
+    }
+
+    size_t size = atomic_load_explicit(&sh->size, memory_order_relaxed);
+    if ((size + sh->deleted) * 10 >= t->cap * 7) {
+        // Mostly tombstones: rehash at the same size; otherwise grow.
+        ttak_cmap_table_t *grown = cmap_shard_resize(map, sh, size * 2 >= t->cap ? t->cap * 2 : t->cap);
+        if (!grown && size * 10 >= t->cap * 9) {
+            ttak_mutex_unlock(&sh->lock);
+            return false;
+        }
+        if (grown) t = grown;
+    }
+
+    idx = cmap_find_free(t, h);
+    if (TTAK_UNLIKELY(idx == SIZE_MAX)) {
+        ttak_mutex_unlock(&sh->lock);
+        return false;
+    }
+
+    if (t->ctrls[idx] == DELETED) {
+        /*
+         * A reader may have matched this slot's old fingerprint and be
+         * about to read its key and value: make it retry.
+         */
+        uint64_t seq = atomic_load_explicit(&sh->seq, memory_order_relaxed);
+        atomic_store_explicit(&sh->seq, seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        atomic_store_explicit(&t->keys[idx], key, memory_order_relaxed);
+        atomic_store_explicit(&t->values[idx], val, memory_order_relaxed);
+        cmap_store_ctrl(t, idx, TTAK_CTRL_H2(h));
+        atomic_store_explicit(&sh->seq, seq + 2, memory_order_release);
+        sh->deleted--;
+    } else {
+        /* An EMPTY slot is invisible until its control byte is published. */
+        atomic_store_explicit(&t->keys[idx], key, memory_order_relaxed);
+        atomic_store_explicit(&t->values[idx], val, memory_order_relaxed);
+        cmap_store_ctrl(t, idx, TTAK_CTRL_H2(h));
+    }
+    atomic_store_explicit(&sh->size, size + 1, memory_order_relaxed);
+    ttak_mutex_unlock(&sh->lock);
+    return true;
+}
+
+bool ttak_cmap_remove(ttak_cmap_t *map, uintptr_t key) {
+    uint64_t h = gen_hash_wyhash(key, map->seed);
+    ttak_cmap_shard_t *sh = cmap_shard(map, h);
+
+    ttak_mutex_lock(&sh->lock);
+    ttak_cmap_table_t *t = atomic_load_explicit(&sh->table, memory_order_relaxed);
+    size_t idx = cmap_find(t, key, h);
+    if (idx == SIZE_MAX) {
+        ttak_mutex_unlock(&sh->lock);
+        return false;
+    }
+    /* The key and value stay put until the slot is reused, which bumps seq. */
+    cmap_store_ctrl(t, idx, DELETED);
+    sh->deleted++;
+    atomic_store_explicit(&sh->size, atomic_load_explicit(&sh->size, memory_order_relaxed) - 1,
+                          memory_order_relaxed);
+    ttak_mutex_unlock(&sh->lock);
+    return true;
+}
+
+bool ttak_cmap_get_pinned(ttak_cmap_t *map, uintptr_t key, size_t *out) {
+    uint64_t h = gen_hash_wyhash(key, map->seed);
+    ttak_cmap_shard_t *sh = cmap_shard(map, h);
+
+    for (unsigned spins = 0;; spins++) {
+        uint64_t seq = atomic_load_explicit(&sh->seq, memory_order_acquire);
+        if (TTAK_UNLIKELY(seq & 1)) {
+            if (spins & 63) ttak_arch_pause();
+            else sched_yield();
+            continue;
+        }
+        ttak_cmap_table_t *t = atomic_load_explicit(&sh->table, memory_order_acquire);
+        size_t idx = cmap_find(t, key, h);
+        size_t val = idx != SIZE_MAX ? atomic_load_explicit(&t->values[idx], memory_order_acquire) : 0;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&sh->seq, memory_order_relaxed) != seq) continue;
+        if (idx == SIZE_MAX) return false;
+        if (out) *out = val;
+        return true;
+    }
+}
+
+bool ttak_cmap_get(ttak_cmap_t *map, uintptr_t key, size_t *out) {
+    ttak_epoch_enter();
+    bool found = ttak_cmap_get_pinned(map, key, out);
+    ttak_epoch_exit();
+    return found;
+}
+
+size_t ttak_cmap_size(ttak_cmap_t *map) {
+    size_t total = 0;
+    for (size_t s = 0; s < TTAK_CMAP_SHARDS; s++) {
+        total += atomic_load_explicit(&map->shards[s].size, memory_order_relaxed);
+    }
+    return total;
+}
@@ -0,0 +1,188 @@
+#include <ttak/ht/counter.h>
+#include <ttak/ht/group.h>
+#include <ttak/ht/hash.h>
+#include <ttak/mem/mem.h>
+#include <ttak/arch/ttak_arch.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Control byte of a slot whose key is being written; never ends a probe. */
+#define COUNTER_BUSY DELETED
+
+static inline _Atomic uint8_t *counter_ctrl(ttak_counter_map_t *map, size_t idx) {
+    return (_Atomic uint8_t *)&map->ctrls[idx];
+}
+
+static inline size_t counter_home(const ttak_counter_map_t *map, uint64_t h) {
+    return (size_t)h & (map->cap - 1);
+}
+
+ttak_counter_map_t *ttak_counter_map_create(size_t max_keys) {
+    size_t cap = 16;
+    while (cap < max_keys / 7 * 8 + 8) cap <<= 1;
+    size_t slots = cap + TTAK_HT_PAD;
+
+    ttak_counter_map_t *map = calloc(1, sizeof(*map));
+    if (!map) return NULL;
+    /* One block for all three arrays, counts first to keep them 8-byte aligned. */
+    size_t bytes = slots * (sizeof(uint64_t) + sizeof(uintptr_t) + sizeof(uint8_t));
+    map->counts = ttak_dangerous_calloc(1, bytes);
+    if (!map->counts) {
+        free(map);
+        return NULL;
+    }
+    map->keys = (_Atomic uintptr_t *)(map->counts + slots);
+    map->ctrls = (uint8_t *)(map->keys + slots);
+    map->cap = cap;
+    map->limit = slots / 8 * 7;
+    map->seed = 0xe7037ed1a0b428dbULL ^ (uint64_t)(uintptr_t)map;
+    atomic_init(&map->size, 0);
+    return map;
+}
+
+void ttak_counter_map_destroy(ttak_counter_map_t *map) {
+    if (!map) return;
+    ttak_dangerous_free(map->counts);
+    free(map);
+}
+
+/* Spins until a slot being claimed has its key published. */
+static void counter_wait_claimed(ttak_counter_map_t *map, size_t idx) {
+    while (atomic_load_explicit(counter_ctrl(map, idx), memory_order_acquire) == COUNTER_BUSY) {
+        ttak_arch_pause();
+    }
+}
+
+/**
+ * @brief Finds @p key's slot, claiming the first EMPTY one on the probe
+ *        path when @p claim is set.
+ *
+ * Slots never go back to EMPTY, so every thread probing for the same key
+ * reaches the same first EMPTY slot; the CAS there decides which of them
+ * inserts, and the rest wait for its key and find it.
+ *
+ * @return The slot, or SIZE_MAX if absent (or, claiming, if full).
+ */
+static size_t counter_slot(ttak_counter_map_t *map, uintptr_t key, bool claim, bool *fresh) {
+    uint64_t h = gen_hash_wyhash(key, map->seed);
+    size_t slots = map->cap + TTAK_HT_PAD;
+    uint8_t tag = TTAK_CTRL_H2(h);
+    size_t pos = counter_home(map, h);
+
+    for (size_t n = ttak_ht_probe_limit(slots); n > 0;) {
+        const uint8_t *group = map->ctrls + pos;
+        uint64_t m = ttak_ht_group_match(group, tag);
+        uint64_t busy = ttak_ht_group_match(group, COUNTER_BUSY);
+        uint64_t empty = ttak_ht_group_match_empty(group);
+        atomic_thread_fence(memory_order_acquire);
+        while (m != 0) {
+            size_t idx = pos + ttak_ht_mask_next(&m);
+            if (atomic_load_explicit(&map->keys[idx], memory_order_relaxed) == key) return idx;
+        }
+        if (busy != 0) {
+            // The key being written may be ours; look at the group again once it is.
+            while (busy != 0) counter_wait_claimed(map, pos + ttak_ht_mask_next(&busy));
+            continue;
+        }
+        if (empty != 0) {
+            if (!claim) return SIZE_MAX;
+            if (atomic_load_explicit(&map->size, memory_order_relaxed) >= map->limit) return SIZE_MAX;
+            size_t idx = pos + ttak_ht_mask_next(&empty);
+            uint8_t expect = EMPTY;
+            if (!atomic_compare_exchange_strong_explicit(counter_ctrl(map, idx), &expect, COUNTER_BUSY,
+                                                         memory_order_acq_rel, memory_order_acquire)) {
+                continue;
+            }
+            atomic_store_explicit(&map->keys[idx], key, memory_order_relaxed);
+            atomic_fetch_add_explicit(&map->size, 1, memory_order_relaxed);
+            *fresh = true;
+            return idx;
+        }
+        pos = ttak_ht_probe_next(pos, slots);
+        n--;
+    }
+    return SIZE_MAX;
+}
+
+bool ttak_counter_map_add(ttak_counter_map_t *map, uintptr_t key, uint64_t delta) {
+    if (!map) return false;
+    bool fresh = false;
+    size_t idx = counter_slot(map, key, true, &fresh);
+    if (idx == SIZE_MAX) return false;
+    if (fresh) {
+        // Unpublished, so no one else can be counting on the slot yet.
+        atomic_store_explicit(&map->counts[idx], delta, memory_order_relaxed);
+        atomic_store_explicit(counter_ctrl(map, idx),
+                              TTAK_CTRL_H2(gen_hash_wyhash(key, map->seed)), memory_order_release);
+        return true;
+    }
+    atomic_fetch_add_explicit(&map->counts[idx], delta, memory_order_relaxed);
+    return true;
+}
+
+uint64_t ttak_counter_map_get(ttak_counter_map_t *map, uintptr_t key) {
+    if (!map) return 0;
+    size_t idx = counter_slot(map, key, false, NULL);
+    return idx == SIZE_MAX ? 0 : atomic_load_explicit(&map->counts[idx], memory_order_relaxed);
+}
+
+size_t ttak_counter_map_size(ttak_counter_map_t *map) {
+    return map ? atomic_load_explicit(&map->size, memory_order_relaxed) : 0;
+}
+
+bool ttak_counter_map_merge(ttak_counter_map_t *dst, ttak_counter_map_t *src) {
+    if (!dst || !src) return false;
+    size_t slots = src->cap + TTAK_HT_PAD;
+    for (size_t i = 0; i < slots; i++) {
+        if (!TTAK_CTRL_FULL(src->ctrls[i])) continue;
+        uintptr_t key = atomic_load_explicit(&src->keys[i], memory_order_relaxed);
+        if (!ttak_counter_map_add(dst, key, atomic_load_explicit(&src->counts[i], memory_order_relaxed))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Min-heap on count: the root is the weakest of the current top k. */
+static void counter_sift_down(ttak_counter_entry_t *heap, size_t n, size_t i) {
+    for (;;) {
+        size_t l = 2 * i + 1, m = i;
+        if (l < n && heap[l].count < heap[m].count) m = l;
+        if (l + 1 < n && heap[l + 1].count < heap[m].count) m = l + 1;
+        if (m == i) return;
+        ttak_counter_entry_t t = heap[i];
+        heap[i] = heap[m];
+        heap[m] = t;
+        i = m;
+    }
+}
+
+size_t ttak_counter_map_top_k(ttak_counter_map_t *map, size_t k, ttak_counter_entry_t *out) {
+    if (!map || !out || k == 0) return 0;
+    size_t slots = map->cap + TTAK_HT_PAD, n = 0;
+    for (size_t i = 0; i < slots; i++) {
+        if (!TTAK_CTRL_FULL(atomic_load_explicit(counter_ctrl(map, i), memory_order_acquire))) continue;
+        ttak_counter_entry_t e = { atomic_load_explicit(&map->keys[i], memory_order_relaxed),
+                                   atomic_load_explicit(&map->counts[i], memory_order_relaxed) };
+        if (n < k) {
+            out[n++] = e;
+            if (n == k) {
+                for (size_t j = k / 2; j-- > 0;) counter_sift_down(out, k, j);
+            }
+        } else if (e.count > out[0].count) {
+            out[0] = e;
+            counter_sift_down(out, k, 0);
+        }
+    }
+    if (n < k) {
+        for (size_t j = n / 2; j-- > 0;) counter_sift_down(out, n, j);
+    }
+    // Heap-sort in place: repeatedly move the minimum to the back.
+    for (size_t end = n; end > 1; end--) {
+        ttak_counter_entry_t t = out[0];
+        out[0] = out[end - 1];
+        out[end - 1] = t;
+        counter_sift_down(out, end - 1, 0);
+    }
+    return n;
+}
@@ -1,6 +1,8 @@
 #include <ttak/ht/hash.h>
 #include <ttak/ht/wyhash.h>
 #include <ttak/security/siphash.h>
+#include <ttak/arch/ttak_arch.h>
+#include <pthread.h>
 
 /**
  * @brief Compute the SipHash-2-4 digest for a machine-word key.
@@ -24,3 +26,175 @@ uint64_t gen_hash_sip24(uintptr_t key, uint64_t k0, uint64_t k1) {
 uint64_t gen_hash_wyhash(uintptr_t key, uint64_t seed) {
     return ttak_hash_u64((uint64_t)key, seed);
 }
+
+#if defined(TTAK_ARCH_X86_64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#include <immintrin.h>
+#define TTAK_HASH_AES_X86 1
+#elif defined(TTAK_ARCH_AARCH64) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h>
+#define TTAK_HASH_AES_ARM 1
+#endif
+
+typedef uint64_t (*ttak_hash_long_fn)(const uint8_t *p, size_t len, uint64_t seed);
+
+typedef struct {
+    const char *name;
+    ttak_hash_long_fn hash_long;    /**< Keys of at least TTAK_HASH_AES_MIN_LEN bytes. */
+} ttak_hash_kernels_t;
+
+static uint64_t ttak_hash_long_wyhash(const uint8_t *p, size_t len, uint64_t seed) {
+    return ttak_wyhash(p, len, seed);
+}
+
+static ttak_hash_kernels_t g_hash_kernels = { "wyhash", ttak_hash_long_wyhash };
+static pthread_once_t g_hash_once = PTHREAD_ONCE_INIT;
+
+/*
+ * AES kernels: four lanes each absorb every fourth 16-byte block as the
+ * round key of one AES round, so the lanes' rounds pipeline. The final 64
+ * bytes are absorbed from an overlapping load, which is why the kernels
+ * need len >= 64. Each lane then gets two more rounds, the lanes fold
+ * pairwise, and three rounds keyed by the seed and length finish.
+ *
+ * This is a fast non-cryptographic hash; untrusted keys should go
+ * through SipHash (gen_hash_sip24() / ttak_siphash24()).
+ */
+#if defined(TTAK_HASH_AES_X86)
+__attribute__((target("aes,sse2")))
+static uint64_t ttak_hash_long_aesni(const uint8_t *p, size_t len, uint64_t seed) {
+    const __m128i sv = _mm_set_epi64x((long long)len, (long long)seed);
+    const __m128i k0 = _mm_set_epi64x((long long)0xe7037ed1a0b428dbULL, (long long)0xa0761d6478bd642fULL);
+    const __m128i k1 = _mm_set_epi64x((long long)0x589965cc75374cc3ULL, (long long)0x8ebc6af09c88c6e3ULL);
+    const uint8_t *end = p + len;
+    __m128i s0 = _mm_xor_si128(sv, k0);
+    __m128i s1 = _mm_xor_si128(sv, k1);
+    __m128i s2 = _mm_xor_si128(sv, _mm_shuffle_epi32(k0, 0x4e));
+    __m128i s3 = _mm_xor_si128(sv, _mm_shuffle_epi32(k1, 0x4e));
+
+    for (; len > 64; p += 64, len -= 64) {
+        s0 = _mm_aesenc_si128(s0, _mm_loadu_si128((const __m128i *)(p)));
+        s1 = _mm_aesenc_si128(s1, _mm_loadu_si128((const __m128i *)(p + 16)));
+        s2 = _mm_aesenc_si128(s2, _mm_loadu_si128((const __m128i *)(p + 32)));
+        s3 = _mm_aesenc_si128(s3, _mm_loadu_si128((const __m128i *)(p + 48)));
+    }
+    s0 = _mm_aesenc_si128(s0, _mm_loadu_si128((const __m128i *)(end - 64)));
+    s1 = _mm_aesenc_si128(s1, _mm_loadu_si128((const __m128i *)(end - 48)));
+    s2 = _mm_aesenc_si128(s2, _mm_loadu_si128((const __m128i *)(end - 32)));
+    s3 = _mm_aesenc_si128(s3, _mm_loadu_si128((const __m128i *)(end - 16)));
+
+    s0 = _mm_aesenc_si128(_mm_aesenc_si128(s0, k0), k1);
+    s1 = _mm_aesenc_si128(_mm_aesenc_si128(s1, k1), k0);
+    s2 = _mm_aesenc_si128(_mm_aesenc_si128(s2, k0), k1);
+    s3 = _mm_aesenc_si128(_mm_aesenc_si128(s3, k1), k0);
+    __m128i h = _mm_aesenc_si128(_mm_aesenc_si128(s0, s1), _mm_aesenc_si128(s2, s3));
+    h = _mm_aesenc_si128(_mm_aesenc_si128(_mm_aesenc_si128(h, sv), k0), k1);
+    return (uint64_t)_mm_cvtsi128_si64(h) ^ (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(h, h));
+}
+#elif defined(TTAK_HASH_AES_ARM)
+/* vaeseq XORs the key before SubBytes; with a zero key plus vaesmcq this is one AESENC round. */
+static inline uint8x16_t ttak_hash_aesenc(uint8x16_t s, uint8x16_t k) {
+    return veorq_u8(vaesmcq_u8(vaeseq_u8(s, vdupq_n_u8(0))), k);
+}
+
+static uint64_t ttak_hash_long_armaes(const uint8_t *p, size_t len, uint64_t seed) {
+    const uint64_t sw[2] = { seed, (uint64_t)len };
+    const uint64_t kw0[2] = { 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL };
+    const uint64_t kw1[2] = { 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL };
+    const uint8x16_t sv = vreinterpretq_u8_u64(vld1q_u64(sw));
+    const uint8x16_t k0 = vreinterpretq_u8_u64(vld1q_u64(kw0));
+    const uint8x16_t k1 = vreinterpretq_u8_u64(vld1q_u64(kw1));
+    const uint8_t *end = p + len;
+    uint8x16_t s0 = veorq_u8(sv, k0);
+    uint8x16_t s1 = veorq_u8(sv, k1);
+    uint8x16_t s2 = veorq_u8(sv, vextq_u8(k0, k0, 8));
+    uint8x16_t s3 = veorq_u8(sv, vextq_u8(k1, k1, 8));
+
+    for (; len > 64; p += 64, len -= 64) {
+        s0 = ttak_hash_aesenc(s0, vld1q_u8(p));
+        s1 = ttak_hash_aesenc(s1, vld1q_u8(p + 16));
+        s2 = ttak_hash_aesenc(s2, vld1q_u8(p + 32));
+        s3 = ttak_hash_aesenc(s3, vld1q_u8(p + 48));
+    }
+    s0 = ttak_hash_aesenc(s0, vld1q_u8(end - 64));
+    s1 = ttak_hash_aesenc(s1, vld1q_u8(end - 48));
+    s2 = ttak_hash_aesenc(s2, vld1q_u8(end - 32));
+    s3 = ttak_hash_aesenc(s3, vld1q_u8(end - 16));
+
+    s0 = ttak_hash_aesenc(ttak_hash_aesenc(s0, k0), k1);
+    s1 = ttak_hash_aesenc(ttak_hash_aesenc(s1, k1), k0);
+    s2 = ttak_hash_aesenc(ttak_hash_aesenc(s2, k0), k1);
+    s3 = ttak_hash_aesenc(ttak_hash_aesenc(s3, k1), k0);
+    uint8x16_t h = ttak_hash_aesenc(ttak_hash_aesenc(s0, s1), ttak_hash_aesenc(s2, s3));
+    h = ttak_hash_aesenc(ttak_hash_aesenc(ttak_hash_aesenc(h, sv), k0), k1);
+    uint64x2_t w = vreinterpretq_u64_u8(h);
+    return vgetq_lane_u64(w, 0) ^ vgetq_lane_u64(w, 1);
+}
+#endif
+
+static void ttak_hash_select(void) {
+    uint32_t features = ttak_arch_features();
+    (void)features;
+#if defined(TTAK_HASH_AES_X86)
+    if (features & TTAK_ARCH_FEATURE_AES) {
+        g_hash_kernels = (ttak_hash_kernels_t){ "aesni", ttak_hash_long_aesni };
+    }
+#elif defined(TTAK_HASH_AES_ARM)
+    if (features & TTAK_ARCH_FEATURE_AES) {
+        g_hash_kernels = (ttak_hash_kernels_t){ "armv8-aes", ttak_hash_long_armaes };
+    }
+#endif
+}
+
+static inline const ttak_hash_kernels_t *ttak_hash_kernels(void) {
+    pthread_once(&g_hash_once, ttak_hash_select);
+    return &g_hash_kernels;
+}
+
+uint64_t ttak_hash_bytes(const void *key, size_t len, uint64_t seed) {
+    if (len < TTAK_HASH_AES_MIN_LEN) return ttak_wyhash(key, len, seed);
+    return ttak_hash_kernels()->hash_long((const uint8_t *)key, len, seed);
+}
+
+void ttak_hash_bytes_batch(const void *const *keys, const size_t *lens, size_t n,
+                           uint64_t seed, uint64_t *out) {
+    ttak_hash_long_fn hash_long = ttak_hash_kernels()->hash_long;
+    size_t i = 0;
+    /* Four independent keys per step keep several multiply or AES chains in flight. */
+    for (; i + 4 <= n; i += 4) {
+        uint64_t h0 = lens[i] < TTAK_HASH_AES_MIN_LEN ? ttak_wyhash(keys[i], lens[i], seed)
+                                                      : hash_long((const uint8_t *)keys[i], lens[i], seed);
+        uint64_t h1 = lens[i + 1] < TTAK_HASH_AES_MIN_LEN ? ttak_wyhash(keys[i + 1], lens[i + 1], seed)
+                                                          : hash_long((const uint8_t *)keys[i + 1], lens[i + 1], seed);
+        uint64_t h2 = lens[i + 2] < TTAK_HASH_AES_MIN_LEN ? ttak_wyhash(keys[i + 2], lens[i + 2], seed)
+                                                          : hash_long((const uint8_t *)keys[i + 2], lens[i + 2], seed);
+        uint64_t h3 = lens[i + 3] < TTAK_HASH_AES_MIN_LEN ? ttak_wyhash(keys[i + 3], lens[i + 3], seed)
+                                                          : hash_long((const uint8_t *)keys[i + 3], lens[i + 3], seed);
+        out[i] = h0;
+        out[i + 1] = h1;
+        out[i + 2] = h2;
+        out[i + 3] = h3;
+    }
+    for (; i < n; i++) {
+        out[i] = lens[i] < TTAK_HASH_AES_MIN_LEN ? ttak_wyhash(keys[i], lens[i], seed)
+                                                 : hash_long((const uint8_t *)keys[i], lens[i], seed);
+    }
+}
+
+void ttak_hash_u64_batch(const uint64_t *keys, size_t n, uint64_t seed, uint64_t *out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint64_t h0 = ttak_hash_u64(keys[i], seed);
+        uint64_t h1 = ttak_hash_u64(keys[i + 1], seed);
+        uint64_t h2 = ttak_hash_u64(keys[i + 2], seed);
+        uint64_t h3 = ttak_hash_u64(keys[i + 3], seed);
+        out[i] = h0;
+        out[i + 1] = h1;
+        out[i + 2] = h2;
+        out[i + 3] = h3;
+    }
+    for (; i < n; i++) out[i] = ttak_hash_u64(keys[i], seed);
+}
+
+const char *ttak_hash_kernel_name(void) {
+    return ttak_hash_kernels()->name;
+}
@@ -1,11 +1,11 @@
 #include <ttak/ht/hash.h>
 #include <ttak/ht/map.h>
+#include <ttak/ht/group.h>
+#include <ttak/ht/wyhash.h>
 #include <ttak/mem/mem.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define MAX_PROBE 32
-
 static size_t next_pow2(size_t n) {
     if (n == 0) return 1;
     n--;
@@ -24,7 +24,8 @@ static void ttak_map_arrays_destroy(tt_map_t *map) {
     if (map->values) { ttak_mem_free(map->values); map->values = NULL; }
 }
 
-/* Internal constructor: allocate and zero-initialise all three arrays.
+/* Internal constructor: allocate all three arrays, which come back zeroed.
+ * Large arrays stay unfaulted until probed instead of being cleared up front.
  * Returns 0 on success, -1 on any allocation failure (arrays freed on error). */
 static int ttak_map_arrays_alloc(tt_map_t *map, size_t padded_cap, uint64_t now) {
     map->ctrls  = ttak_mem_alloc_raw(padded_cap * sizeof(uint8_t),   __TTAK_UNSAFE_MEM_FOREVER__, now);
@@ -35,10 +36,6 @@ static int ttak_map_arrays_alloc(tt_map_t *map, size_t padded_cap, uint64_t now)
         ttak_map_arrays_destroy(map);
         return -1;
     }
-
-    memset(map->ctrls,  0, padded_cap * sizeof(uint8_t));
-    memset(map->keys,   0, padded_cap * sizeof(uintptr_t));
-    memset(map->values, 0, padded_cap * sizeof(size_t));
     return 0;
 }
 
@@ -48,13 +45,14 @@ tt_map_t *ttak_create_map(size_t init_cap, uint64_t now) {
 
     map->cap  = next_pow2(init_cap);
     map->size = 0;
+    map->deleted = 0;
     map->seed = 0xa0761d6478bd642fULL;
     map->ctrls  = NULL;
     map->keys   = NULL;
     map->values = NULL;
 
-    // Allocate with padding to allow branchless linear probing
-    size_t padded_cap = map->cap + MAX_PROBE;
+    // Allocate with padding so a probe group never straddles the end
+    size_t padded_cap = map->cap + TTAK_HT_PAD;
     if (ttak_map_arrays_alloc(map, padded_cap, now) != 0) {
         ttak_mem_free(map);
         return NULL;
@@ -63,18 +61,19 @@ tt_map_t *ttak_create_map(size_t init_cap, uint64_t now) {
     return map;
 }
 
-static void ttak_resize_map(tt_map_t *map, uint64_t now) {
-    size_t old_cap = map->cap;
+/* Rebuilds the map at @p new_cap slots, dropping tombstones. */
+static void ttak_resize_map(tt_map_t *map, size_t new_cap, uint64_t now) {
+    size_t old_slots = map->cap + TTAK_HT_PAD;
     uint8_t *old_ctrls = map->ctrls;
     uintptr_t *old_keys = map->keys;
     size_t *old_vals = map->values;
 
-    size_t new_cap = old_cap * 2;
     tt_map_t *new_m = ttak_create_map(new_cap, now);
     if (!new_m) return;
+    new_m->seed = map->seed;
 
-    for (size_t i = 0; i < old_cap; i++) {
-        if (old_ctrls[i] == OCCUPIED) {
+    for (size_t i = 0; i < old_slots; i++) {
+        if (TTAK_CTRL_FULL(old_ctrls[i])) {
             ttak_insert_to_map(new_m, old_keys[i], old_vals[i], now);
         }
     }
@@ -83,69 +82,97 @@ static void ttak_resize_map(tt_map_t *map, uint64_t now) {
     ttak_mem_free(old_keys);
     ttak_mem_free(old_vals);
 
-    uint64_t s = map->seed;
     *map = *new_m;
-    map->seed = s;
     ttak_mem_free(new_m);
 }
 
 void ttak_insert_to_map(tt_map_t *map, uintptr_t key, size_t val, uint64_t now) {
     if (!ttak_mem_access(map, now)) return;
-    if (map->size * 10 >= map->cap * 7) ttak_resize_map(map, now);
+    if ((map->size + map->deleted) * 10 >= map->cap * 7) {
+        // Mostly tombstones: rehash in place; otherwise grow.
+        ttak_resize_map(map, map->size * 2 >= map->cap ? map->cap * 2 : map->cap, now);
+    }
 
     uint64_t h = gen_hash_wyhash(key, map->seed);
-    size_t idx = h & (map->cap - 1);
-
-    // Linear probing with padding - fewer branches
-    while (map->ctrls[idx] == OCCUPIED) {
-        if (map->keys[idx] == key) {
-            map->values[idx] = val;
-            return;
+    size_t slots = map->cap + TTAK_HT_PAD;
+    uint8_t tag = TTAK_CTRL_H2(h);
+    size_t pos = h & (map->cap - 1);
+    size_t target = SIZE_MAX;
+
+    // Look for the key a group at a time, remembering the first free slot
+    for (size_t n = ttak_ht_probe_limit(slots); n > 0; n--) {
+        const uint8_t *group = map->ctrls + pos;
+        for (uint64_t m = ttak_ht_group_match(group, tag); m != 0;) {
+            size_t idx = pos + ttak_ht_mask_next(&m);
+            if (map->keys[idx] == key) {
+                map->values[idx] = val;
+                return;
+            }
         }
-        idx++;
-        // If we hit the padding limit, we must wrap. 
-        // But with MAX_PROBE and 70% load, this is rare.
-        if (idx >= map->cap + MAX_PROBE - 1) {
-            idx = 0;
+        if (target == SIZE_MAX) {
+            uint64_t m = ttak_ht_group_match_free(group);
+            if (m != 0) target = pos + ttak_ht_mask_next(&m);
         }
+        if (ttak_ht_group_match_empty(group)) break;
+        pos = ttak_ht_probe_next(pos, slots);
     }
+    if (target == SIZE_MAX) return;
 
-    map->ctrls[idx] = OCCUPIED;
-    map->keys[idx] = key;
-    map->values[idx] = val;
+    if (map->ctrls[target] == DELETED) map->deleted--;
+    map->ctrls[target] = tag;
+    map->keys[target] = key;
+    map->values[target] = val;
     map->size++;
 }
 
-_Bool ttak_map_get_key(tt_map_t *map, uintptr_t key, size_t *out, uint64_t now) {
+_Bool (ttak_map_get_key)(tt_map_t *map, uintptr_t key, size_t *out, uint64_t now) {
     if (!ttak_mem_access(map, now)) return 0;
-    uint64_t h = gen_hash_wyhash(key, map->seed);
-    size_t idx = h & (map->cap - 1);
+    size_t idx = ttak_map_find_slot(map, key, gen_hash_wyhash(key, map->seed));
+    if (idx == SIZE_MAX) return 0;
+    if (out) *out = map->values[idx];
+    return 1;
+}
 
-    while (map->ctrls[idx] != EMPTY) {
-        if (map->ctrls[idx] == OCCUPIED && map->keys[idx] == key) {
-            if (out) *out = map->values[idx];
-            return 1;
+size_t ttak_map_get_batch(tt_map_t *map, const uintptr_t *keys, size_t n, size_t *out,
+                          _Bool *found, uint64_t now) {
+    if (!ttak_mem_access(map, now)) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = 0;
+            if (found) found[i] = 0;
         }
-        idx++;
-        if (idx >= map->cap + MAX_PROBE - 1) idx = 0;
+        return 0;
     }
-    return 0;
+
+    uint64_t h[TTAK_HT_BATCH_WINDOW];
+    size_t hits = 0;
+    for (size_t base = 0; base < n; base += TTAK_HT_BATCH_WINDOW) {
+        size_t cnt = n - base < TTAK_HT_BATCH_WINDOW ? n - base : TTAK_HT_BATCH_WINDOW;
+        // Same hash as gen_hash_wyhash(), inlined so the window pipelines.
+        for (size_t i = 0; i < cnt; i++) {
+            h[i] = ttak_hash_u64((uint64_t)keys[base + i], map->seed);
+            size_t pos = h[i] & (map->cap - 1);
+            ttak_arch_prefetch(map->ctrls + pos);
+            ttak_arch_prefetch(map->keys + pos);
+            ttak_arch_prefetch(map->values + pos);
+        }
+        for (size_t i = 0; i < cnt; i++) {
+            size_t idx = ttak_map_find_slot(map, keys[base + i], h[i]);
+            _Bool hit = idx != SIZE_MAX;
+            out[base + i] = hit ? map->values[idx] : 0;
+            if (found) found[base + i] = hit;
+            hits += hit;
+        }
+    }
+    return hits;
 }
 
 void ttak_delete_from_map(tt_map_t *map, uintptr_t key, uint64_t now) {
     if (!ttak_mem_access(map, now)) return;
-    uint64_t h = gen_hash_wyhash(key, map->seed);
-    size_t idx = h & (map->cap - 1);
-
-    while (map->ctrls[idx] != EMPTY) {
-        if (map->ctrls[idx] == OCCUPIED && map->keys[idx] == key) {
-            map->ctrls[idx] = DELETED;
-            map->size--;
-            return;
-        }
-        idx++;
-        if (idx >= map->cap + MAX_PROBE - 1) idx = 0;
-    }
+    size_t idx = ttak_map_find_slot(map, key, gen_hash_wyhash(key, map->seed));
+    if (idx == SIZE_MAX) return;
+    map->ctrls[idx] = DELETED;
+    map->size--;
+    map->deleted++;
 }
 
 void ttak_destroy_map(tt_map_t *map) {
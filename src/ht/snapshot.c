@@ -0,0 +1,223 @@
+#include <ttak/ht/snapshot.h>
+#include <ttak/ht/group.h>
+#include <ttak/ht/wyhash.h>
+#include <ttak/mem/mem.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t snapshot_align(uint64_t off) {
+    return (off + TTAK_MAP_SNAPSHOT_ALIGN - 1) & ~(uint64_t)(TTAK_MAP_SNAPSHOT_ALIGN - 1);
+}
+
+static uint64_t snapshot_check(const ttak_map_snapshot_header_t *h) {
+    return ttak_wyhash(h, offsetof(ttak_map_snapshot_header_t, check), h->seed);
+}
+
+/* Fills in the header for @p map, laying the arrays out after it. */
+static void snapshot_layout(ttak_map_snapshot_header_t *h, const tt_map_t *map) {
+    uint64_t slots = (uint64_t)map->cap + TTAK_HT_PAD;
+    memset(h, 0, sizeof(*h));
+    h->magic = TTAK_MAP_SNAPSHOT_MAGIC;
+    h->version = TTAK_MAP_SNAPSHOT_VERSION;
+    h->header_size = (uint32_t)sizeof(*h);
+    h->word_size = (uint32_t)sizeof(uintptr_t);
+    h->group_width = TTAK_HT_GROUP_WIDTH;
+    h->pad = TTAK_HT_PAD;
+    h->seed = map->seed;
+    h->cap = map->cap;
+    h->size = map->size;
+    h->deleted = map->deleted;
+    h->ctrls_off = snapshot_align(sizeof(*h));
+    h->keys_off = snapshot_align(h->ctrls_off + slots);
+    h->values_off = snapshot_align(h->keys_off + slots * sizeof(uintptr_t));
+    h->file_size = h->values_off + slots * sizeof(size_t);
+    h->check = snapshot_check(h);
+}
+
+/* Layout checks for a header read back from a file of @p file_size bytes. */
+static int snapshot_valid(const ttak_map_snapshot_header_t *h, uint64_t file_size) {
+    if (h->magic != TTAK_MAP_SNAPSHOT_MAGIC || h->version != TTAK_MAP_SNAPSHOT_VERSION) return 0;
+    if (h->header_size != sizeof(*h) || h->check != snapshot_check(h)) return 0;
+    if (h->word_size != sizeof(uintptr_t) || h->group_width != TTAK_HT_GROUP_WIDTH ||
+        h->pad != TTAK_HT_PAD) {
+        return 0;
+    }
+    if (h->cap == 0 || (h->cap & (h->cap - 1)) != 0 || h->cap > SIZE_MAX / 16) return 0;
+    if (h->size + h->deleted > h->cap) return 0;
+
+    uint64_t slots = h->cap + TTAK_HT_PAD;
+    if (h->ctrls_off < sizeof(*h) || h->ctrls_off % TTAK_MAP_SNAPSHOT_ALIGN) return 0;
+    if (h->keys_off < h->ctrls_off + slots || h->keys_off % TTAK_MAP_SNAPSHOT_ALIGN) return 0;
+    if (h->values_off < h->keys_off + slots * sizeof(uintptr_t) ||
+        h->values_off % TTAK_MAP_SNAPSHOT_ALIGN) {
+        return 0;
+    }
+    if (h->file_size != file_size || h->values_off + slots * sizeof(size_t) > file_size) return 0;
+    return 1;
+}
+
+#ifndef _WIN32
+static int snapshot_write_all(int fd, const void *buf, uint64_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        size_t chunk = len > (1u << 30) ? (1u << 30) : (size_t)len;
+        ssize_t n = write(fd, p, chunk);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (uint64_t)n;
+    }
+    return 0;
+}
+
+/* Zero bytes from @p from up to offset @p to. */
+static int snapshot_write_gap(int fd, uint64_t from, uint64_t to) {
+    static const char zeros[TTAK_MAP_SNAPSHOT_ALIGN];
+    return snapshot_write_all(fd, zeros, to - from);
+}
+
+/* fsyncs the directory holding @p path so the rename itself is durable. */
+static void snapshot_sync_dir(const char *path) {
+    const char *slash = strrchr(path, '/');
+    char *dir = NULL;
+    if (slash) {
+        size_t len = slash == path ? 1 : (size_t)(slash - path);
+        dir = malloc(len + 1);
+        if (!dir) return;
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+    }
+    int dfd = open(dir ? dir : ".", O_RDONLY | O_DIRECTORY);
+    if (dfd >= 0) {
+        fsync(dfd);
+        close(dfd);
+    }
+    free(dir);
+}
+
+int ttak_map_snapshot_write(const tt_map_t *map, const char *path) {
+    if (!map || !map->ctrls || !path) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ttak_map_snapshot_header_t h;
+    snapshot_layout(&h, map);
+    uint64_t slots = (uint64_t)map->cap + TTAK_HT_PAD;
+
+    size_t tmp_len = strlen(path) + sizeof(".tmp");
+    char *tmp = malloc(tmp_len);
+    if (!tmp) return -1;
+    snprintf(tmp, tmp_len, "%s.tmp", path);
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        free(tmp);
+        return -1;
+    }
+    int rc = snapshot_write_all(fd, &h, sizeof(h));
+    if (rc == 0) rc = snapshot_write_gap(fd, sizeof(h), h.ctrls_off);
+    if (rc == 0) rc = snapshot_write_all(fd, map->ctrls, slots);
+    if (rc == 0) rc = snapshot_write_gap(fd, h.ctrls_off + slots, h.keys_off);
+    if (rc == 0) rc = snapshot_write_all(fd, map->keys, slots * sizeof(uintptr_t));
+    if (rc == 0) rc = snapshot_write_gap(fd, h.keys_off + slots * sizeof(uintptr_t), h.values_off);
+    if (rc == 0) rc = snapshot_write_all(fd, map->values, slots * sizeof(size_t));
+    if (rc == 0) rc = fsync(fd);
+
+    int saved = errno;
+    close(fd);
+    if (rc == 0 && rename(tmp, path) != 0) {
+        rc = -1;
+        saved = errno;
+    }
+    if (rc != 0) unlink(tmp);
+    else snapshot_sync_dir(path);
+    free(tmp);
+    errno = saved;
+    return rc;
+}
+
+ttak_map_snapshot_t *ttak_map_snapshot_open(const char *path, uint64_t now) {
+    if (!path) return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(ttak_map_snapshot_header_t) ||
+        (uint64_t)st.st_size > SIZE_MAX) {
+        close(fd);
+        return NULL;
+    }
+    size_t len = (size_t)st.st_size;
+    void *base = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    const ttak_map_snapshot_header_t *h = base;
+    if (!snapshot_valid(h, len)) {
+        munmap(base, len);
+        return NULL;
+    }
+    // Every probe reads control bytes first; start paging them in now.
+    madvise((char *)base + h->ctrls_off, (size_t)(h->cap + TTAK_HT_PAD), MADV_WILLNEED);
+
+    ttak_map_snapshot_t *snap = malloc(sizeof(*snap));
+    tt_map_t *map = ttak_mem_alloc_raw(sizeof(tt_map_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!snap || !map) {
+        free(snap);
+        if (map) ttak_mem_free(map);
+        munmap(base, len);
+        return NULL;
+    }
+    map->ctrls = (uint8_t *)base + h->ctrls_off;
+    map->keys = (uintptr_t *)((char *)base + h->keys_off);
+    map->values = (size_t *)((char *)base + h->values_off);
+    map->cap = (size_t)h->cap;
+    map->size = (size_t)h->size;
+    map->deleted = (size_t)h->deleted;
+    map->seed = h->seed;
+
+    snap->map = map;
+    snap->base = base;
+    snap->len = len;
+    return snap;
+}
+
+void ttak_map_snapshot_close(ttak_map_snapshot_t *snap) {
+    if (!snap) return;
+    ttak_mem_free(snap->map);
+    munmap(snap->base, snap->len);
+    free(snap);
+}
+#else
+/* Not yet ported to Windows file mappings. */
+int ttak_map_snapshot_write(const tt_map_t *map, const char *path) {
+    (void)map;
+    (void)path;
+    (void)snapshot_layout;
+    (void)snapshot_valid;
+    errno = ENOSYS;
+    return -1;
+}
+
+ttak_map_snapshot_t *ttak_map_snapshot_open(const char *path, uint64_t now) {
+    (void)path;
+    (void)now;
+    return NULL;
+}
+
+void ttak_map_snapshot_close(ttak_map_snapshot_t *snap) {
+    (void)snap;
+}
+#endif
@@ -1,104 +1,327 @@
 #include <ttak/ht/table.h>
 #include <ttak/ht/hash.h>
+#include <ttak/ht/group.h>
 #include <ttak/ht/wyhash.h>
 #include <ttak/mem/mem.h>
+#include <ttak/security/siphash.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define MAX_PROBE 32
+/**
+ * @brief One generation of the table's slot arrays.
+ */
+typedef struct {
+    uint8_t *ctrls;
+    void    **keys;
+    ttak_table_ikey_t *ikeys;
+    size_t  *key_lens;
+    void    **values;
+    size_t  capacity;
+} ttak_table_arrays_t;
+
+/**
+ * @brief A key being looked up, with its slot form for inline tables.
+ */
+typedef struct {
+    const void          *key;
+    size_t              len;
+    ttak_table_ikey_t   ikey;
+} ttak_table_probe_t;
 
 /**
- * @brief Default wyhash implementation for arbitrary byte keys.
+ * @brief Default hash for arbitrary byte keys: wyhash, or AES for long keys.
  */
 static uint64_t default_wyhash(const void *key, size_t len, uint64_t k0, uint64_t k1) {
     (void)k1;
-    return ttak_wyhash(key, len, k0);
+    return ttak_hash_bytes(key, len, k0);
 }
 
-/**
- * @brief Initialize a hash table with optional callbacks.
- */
-void ttak_table_init(ttak_table_t *table, size_t capacity,
-                     uint64_t (*hash_func)(const void*, size_t, uint64_t, uint64_t),
-                     int (*key_cmp)(const void*, const void*),
-                     void (*key_free)(void*),
-                     void (*val_free)(void*)) {
-    if (!table) return;
-    
+static ttak_table_arrays_t ttak_table_current(const ttak_table_t *table) {
+    ttak_table_arrays_t a = {table->ctrls, table->keys, table->ikeys, table->key_lens, table->values,
+                             table->capacity};
+    return a;
+}
+
+static ttak_table_arrays_t ttak_table_old(const ttak_table_t *table) {
+    ttak_table_arrays_t a = {table->old_ctrls, table->old_keys, table->old_ikeys, table->old_key_lens,
+                             table->old_values, table->old_capacity};
+    return a;
+}
+
+static void ttak_table_arrays_free(ttak_table_arrays_t *a) {
+    if (a->ctrls) ttak_mem_free(a->ctrls);
+    if (a->keys) ttak_mem_free(a->keys);
+    if (a->ikeys) ttak_mem_free(a->ikeys);
+    if (a->key_lens) ttak_mem_free(a->key_lens);
+    if (a->values) ttak_mem_free(a->values);
+    memset(a, 0, sizeof(*a));
+}
+
+/* Allocates empty arrays of @p cap slots plus padding; false on failure. */
+static bool ttak_table_arrays_alloc(ttak_table_arrays_t *a, size_t cap, bool inline_keys) {
+    size_t padded_cap = cap + TTAK_HT_PAD;
+    size_t key_size = inline_keys ? sizeof(ttak_table_ikey_t) : sizeof(void*);
+    ttak_mem_flags_t flags = (padded_cap * (sizeof(uint8_t) + key_size + sizeof(void*) * 2) >= 2 * 1024 * 1024) ? TTAK_MEM_HUGE_PAGES : TTAK_MEM_DEFAULT;
+
+    memset(a, 0, sizeof(*a));
+    a->capacity = cap;
+    a->ctrls = ttak_mem_alloc_safe(padded_cap * sizeof(uint8_t), __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
+    if (inline_keys) {
+        a->ikeys = ttak_mem_alloc_safe(padded_cap * key_size, __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
+    } else {
+        a->keys = ttak_mem_alloc_safe(padded_cap * key_size, __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
+    }
+    a->key_lens = ttak_mem_alloc_safe(padded_cap * sizeof(size_t), __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
+    a->values = ttak_mem_alloc_safe(padded_cap * sizeof(void*), __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
+
+    if (!a->ctrls || !(a->keys || a->ikeys) || !a->key_lens || !a->values) {
+        ttak_table_arrays_free(a);
+        return false;
+    }
+    /* The arrays come back zeroed (all slots empty); fresh pages stay unfaulted. */
+    return true;
+}
+
+static void ttak_table_setup(ttak_table_t *table, size_t capacity, bool inline_keys,
+                             uint64_t (*hash_func)(const void*, size_t, uint64_t, uint64_t),
+                             int (*key_cmp)(const void*, const void*),
+                             void (*key_free)(void*),
+                             void (*val_free)(void*)) {
     // Round up capacity to power of 2
     size_t cap = 16;
     while (cap < capacity) cap <<= 1;
     
-    table->capacity = cap;
-    table->size = 0;
+    memset(table, 0, sizeof(*table));
     table->k0 = 0xa0761d6478bd642fULL;
     table->k1 = 0xe7037ed1a0b428dbULL;
+    table->inline_keys = inline_keys;
     table->hash_func = hash_func ? hash_func : default_wyhash;
     table->key_cmp = key_cmp;
     table->key_free = key_free;
     table->val_free = val_free;
 
-    size_t padded_cap = cap + MAX_PROBE;
-    ttak_mem_flags_t flags = (padded_cap * (sizeof(uint8_t) + sizeof(void*) * 3) >= 2 * 1024 * 1024) ? TTAK_MEM_HUGE_PAGES : TTAK_MEM_DEFAULT;
-    
-    table->ctrls = ttak_mem_alloc_safe(padded_cap * sizeof(uint8_t), __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
-    table->keys = ttak_mem_alloc_safe(padded_cap * sizeof(void*), __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
-    table->key_lens = ttak_mem_alloc_safe(padded_cap * sizeof(size_t), __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
-    table->values = ttak_mem_alloc_safe(padded_cap * sizeof(void*), __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
+    ttak_table_arrays_t a;
+    if (!ttak_table_arrays_alloc(&a, cap, inline_keys)) return;
+    table->ctrls = a.ctrls;
+    table->keys = a.keys;
+    table->ikeys = a.ikeys;
+    table->key_lens = a.key_lens;
+    table->values = a.values;
+    table->capacity = a.capacity;
+}
 
-    if (table->ctrls) memset(table->ctrls, 0, padded_cap * sizeof(uint8_t));
+/**
+ * @brief Initialize a hash table with optional callbacks.
+ */
+void ttak_table_init(ttak_table_t *table, size_t capacity,
+                     uint64_t (*hash_func)(const void*, size_t, uint64_t, uint64_t),
+                     int (*key_cmp)(const void*, const void*),
+                     void (*key_free)(void*),
+                     void (*val_free)(void*)) {
+    if (!table) return;
+    ttak_table_setup(table, capacity, false, hash_func, key_cmp, key_free, val_free);
 }
 
-static void ttak_table_resize(ttak_table_t *table, uint64_t now) {
-    size_t old_cap = table->capacity;
-    uint8_t *old_ctrls = table->ctrls;
-    void **old_keys = table->keys;
-    size_t *old_key_lens = table->key_lens;
-    void **old_vals = table->values;
+/**
+ * @brief Initialize a hash table that keeps short keys in its slots.
+ */
+void ttak_table_init_inline(ttak_table_t *table, size_t capacity,
+                            uint64_t (*hash_func)(const void*, size_t, uint64_t, uint64_t),
+                            void (*key_free)(void*),
+                            void (*val_free)(void*)) {
+    if (!table) return;
+    ttak_table_setup(table, capacity, true, hash_func, NULL, key_free, val_free);
+}
 
-    ttak_table_t new_t;
-    ttak_table_init(&new_t, old_cap * 2, table->hash_func, table->key_cmp, NULL, NULL);
-    new_t.k0 = table->k0;
-    new_t.k1 = table->k1;
+static void ttak_table_probe_init(const ttak_table_t *table, ttak_table_probe_t *p,
+                                  const void *key, size_t key_len) {
+    p->key = key;
+    p->len = key_len;
+    if (!table->inline_keys) return;
+    memset(&p->ikey, 0, sizeof(p->ikey));
+    if (key_len <= TTAK_TABLE_INLINE_KEY) memcpy(p->ikey.bytes, key, key_len);
+    else p->ikey.ptr = (void *)key;
+}
 
-    for (size_t i = 0; i < old_cap + MAX_PROBE; i++) {
-        if (old_ctrls[i] == OCCUPIED) {
-            ttak_table_put(&new_t, old_keys[i], old_key_lens[i], old_vals[i], now); 
+static inline bool ttak_table_slot_matches(const ttak_table_t *table, const ttak_table_arrays_t *a,
+                                           size_t idx, const ttak_table_probe_t *p) {
+    if (!table->inline_keys) return table->key_cmp(a->keys[idx], p->key) == 0;
+    if (a->key_lens[idx] != p->len) return false;
+    if (p->len <= TTAK_TABLE_INLINE_KEY) {
+        return a->ikeys[idx].words[0] == p->ikey.words[0] && a->ikeys[idx].words[1] == p->ikey.words[1];
+    }
+    return memcmp(a->ikeys[idx].ptr, p->key, p->len) == 0;
+}
+
+/* Bytes of the key in slot @p idx, for rehashing. */
+static inline const void *ttak_table_slot_key(const ttak_table_t *table, const ttak_table_arrays_t *a,
+                                              size_t idx) {
+    if (!table->inline_keys) return a->keys[idx];
+    return a->key_lens[idx] <= TTAK_TABLE_INLINE_KEY ? (const void *)a->ikeys[idx].bytes : a->ikeys[idx].ptr;
+}
+
+/* Caller memory the slot's key points at, which key_free owns; NULL if inline. */
+static inline void *ttak_table_slot_owned_key(const ttak_table_t *table, const ttak_table_arrays_t *a,
+                                              size_t idx) {
+    if (!table->inline_keys) return a->keys[idx];
+    return a->key_lens[idx] > TTAK_TABLE_INLINE_KEY ? a->ikeys[idx].ptr : NULL;
+}
+
+/* Slot holding the probed key in @p a, or SIZE_MAX. */
+static size_t ttak_table_find(const ttak_table_t *table, const ttak_table_arrays_t *a,
+                              const ttak_table_probe_t *p, uint64_t hash) {
+    size_t slots = a->capacity + TTAK_HT_PAD;
+    uint8_t tag = TTAK_CTRL_H2(hash);
+    size_t pos = hash & (a->capacity - 1);
+
+    for (size_t n = ttak_ht_probe_limit(slots); n > 0; n--) {
+        const uint8_t *group = a->ctrls + pos;
+        for (uint64_t m = ttak_ht_group_match(group, tag); m != 0;) {
+            size_t idx = pos + ttak_ht_mask_next(&m);
+            if (ttak_table_slot_matches(table, a, idx, p)) return idx;
+        }
+        if (ttak_ht_group_match_empty(group)) break;
+        pos = ttak_ht_probe_next(pos, slots);
+    }
+    return SIZE_MAX;
+}
+
+/*
+ * Claims the first EMPTY or DELETED slot on @p hash's probe path in the
+ * current arrays and stamps its control byte; SIZE_MAX if none.
+ */
+static size_t ttak_table_claim(ttak_table_t *table, uint64_t hash) {
+    size_t slots = table->capacity + TTAK_HT_PAD;
+    size_t pos = hash & (table->capacity - 1);
+    for (size_t n = ttak_ht_probe_limit(slots); n > 0; n--) {
+        uint64_t m = ttak_ht_group_match_free(table->ctrls + pos);
+        if (m != 0) {
+            size_t idx = pos + ttak_ht_mask_next(&m);
+            if (table->ctrls[idx] == DELETED) table->deleted--;
+            table->ctrls[idx] = TTAK_CTRL_H2(hash);
+            return idx;
         }
+        pos = ttak_ht_probe_next(pos, slots);
     }
+    return SIZE_MAX;
+}
+
+/* Moves slot @p i of @p from into the current arrays. */
+static bool ttak_table_move(ttak_table_t *table, ttak_table_arrays_t *from, size_t i, uint64_t hash) {
+    size_t idx = ttak_table_claim(table, hash);
+    if (idx == SIZE_MAX) return false;
+    if (table->inline_keys) table->ikeys[idx] = from->ikeys[i];
+    else table->keys[idx] = from->keys[i];
+    table->key_lens[idx] = from->key_lens[i];
+    table->values[idx] = from->values[i];
+    from->ctrls[i] = DELETED;
+    return true;
+}
+
+/* Moves up to @p budget old slots into the current arrays; frees them once drained. */
+static void ttak_table_migrate(ttak_table_t *table, size_t budget) {
+    if (!table->old_ctrls) return;
+    ttak_table_arrays_t old = ttak_table_old(table);
+    size_t old_slots = old.capacity + TTAK_HT_PAD;
+    size_t end = table->migrate_pos + budget;
+    if (end > old_slots || end < table->migrate_pos) end = old_slots;
+
+    for (size_t i = table->migrate_pos; i < end; i++) {
+        if (!TTAK_CTRL_FULL(old.ctrls[i])) continue;
+        uint64_t hash = table->hash_func(ttak_table_slot_key(table, &old, i), old.key_lens[i],
+                                         table->k0, table->k1);
+        if (!ttak_table_move(table, &old, i, hash)) {
+            end = i;
+            break;
+        }
+        table->old_size--;
+    }
+    table->migrate_pos = end;
+
+    if (table->migrate_pos >= old_slots || table->old_size == 0) {
+        ttak_table_arrays_free(&old);
+        table->old_ctrls = NULL;
+        table->old_keys = NULL;
+        table->old_ikeys = NULL;
+        table->old_key_lens = NULL;
+        table->old_values = NULL;
+        table->old_capacity = 0;
+        table->old_size = 0;
+        table->migrate_pos = 0;
+    }
+}
 
-    ttak_mem_free(old_ctrls);
-    ttak_mem_free(old_keys);
-    ttak_mem_free(old_key_lens);
-    ttak_mem_free(old_vals);
+/*
+ * Starts moving to fresh arrays of @p new_cap slots. Any earlier migration
+ * is finished first, so at most two generations exist.
+ */
+static void ttak_table_resize(ttak_table_t *table, size_t new_cap) {
+    if (table->old_ctrls) ttak_table_migrate(table, SIZE_MAX);
+    if (table->old_ctrls) return;
+
+    ttak_table_arrays_t fresh;
+    if (!ttak_table_arrays_alloc(&fresh, new_cap, table->inline_keys)) return;
+
+    table->old_ctrls = table->ctrls;
+    table->old_keys = table->keys;
+    table->old_ikeys = table->ikeys;
+    table->old_key_lens = table->key_lens;
+    table->old_values = table->values;
+    table->old_capacity = table->capacity;
+    table->old_size = table->size;
+    table->migrate_pos = 0;
 
-    table->ctrls = new_t.ctrls;
-    table->keys = new_t.keys;
-    table->key_lens = new_t.key_lens;
-    table->values = new_t.values;
-    table->capacity = new_t.capacity;
+    table->ctrls = fresh.ctrls;
+    table->keys = fresh.keys;
+    table->ikeys = fresh.ikeys;
+    table->key_lens = fresh.key_lens;
+    table->values = fresh.values;
+    table->capacity = fresh.capacity;
+    table->deleted = 0;
 }
 
 void ttak_table_put(ttak_table_t *table, void *key, size_t key_len, void *value, uint64_t now) {
     if (!table || !table->ctrls) return;
-    if (table->size * 10 >= table->capacity * 7) ttak_table_resize(table, now);
+    (void)now;
+    ttak_table_migrate(table, TTAK_TABLE_MIGRATE_STEP);
+
+    size_t live = table->size - table->old_size;
+    if ((live + table->deleted) * 10 >= table->capacity * 7) {
+        // Mostly tombstones: rehash at the same size; otherwise grow.
+        size_t cap = table->capacity;
+        ttak_table_resize(table, table->size * 2 >= cap ? cap * 2 : cap);
+        ttak_table_migrate(table, TTAK_TABLE_MIGRATE_STEP);
+    }
 
+    ttak_table_probe_t p;
+    ttak_table_probe_init(table, &p, key, key_len);
     uint64_t hash = table->hash_func(key, key_len, table->k0, table->k1);
-    size_t idx = hash & (table->capacity - 1);
+    ttak_table_arrays_t cur = ttak_table_current(table);
+    size_t idx = ttak_table_find(table, &cur, &p, hash);
+    if (idx != SIZE_MAX) {
+        if (table->val_free && table->values[idx]) table->val_free(table->values[idx]);
+        table->values[idx] = value;
+        table->key_lens[idx] = key_len;
+        return;
+    }
 
-    while (table->ctrls[idx] == OCCUPIED) {
-        if (table->key_cmp(table->keys[idx], key) == 0) {
-            if (table->val_free && table->values[idx]) table->val_free(table->values[idx]);
-            table->values[idx] = value;
-            table->key_lens[idx] = key_len;
+    if (table->old_ctrls) {
+        ttak_table_arrays_t old = ttak_table_old(table);
+        idx = ttak_table_find(table, &old, &p, hash);
+        if (idx != SIZE_MAX) {
+            // Move the pair over now rather than update it in place.
+            if (table->val_free && old.values[idx]) table->val_free(old.values[idx]);
+            old.values[idx] = value;
+            old.key_lens[idx] = key_len;
+            if (ttak_table_move(table, &old, idx, hash)) table->old_size--;
             return;
         }
-        idx++;
-        if (idx >= table->capacity + MAX_PROBE - 1) idx = 0;
     }
 
-    table->ctrls[idx] = OCCUPIED;
-    table->keys[idx] = key;
+    idx = ttak_table_claim(table, hash);
+    if (idx == SIZE_MAX) return;
+    if (table->inline_keys) table->ikeys[idx] = p.ikey;
+    else table->keys[idx] = key;
     table->key_lens[idx] = key_len;
     table->values[idx] = value;
     table->size++;
@@ -108,53 +331,132 @@ void *ttak_table_get(ttak_table_t *table, const void *key, size_t key_len, uint6
     if (!table || !table->ctrls) return NULL;
     (void)now;
 
+    ttak_table_probe_t p;
+    ttak_table_probe_init(table, &p, key, key_len);
     uint64_t hash = table->hash_func(key, key_len, table->k0, table->k1);
-    size_t idx = hash & (table->capacity - 1);
+    ttak_table_arrays_t cur = ttak_table_current(table);
+    size_t idx = ttak_table_find(table, &cur, &p, hash);
+    if (idx != SIZE_MAX) return table->values[idx];
+    if (!table->old_ctrls) return NULL;
+
+    ttak_table_arrays_t old = ttak_table_old(table);
+    idx = ttak_table_find(table, &old, &p, hash);
+    return idx == SIZE_MAX ? NULL : old.values[idx];
+}
+
+/* Prefetches the first group @p hash probes in @p a and the slots beside it. */
+static inline void ttak_table_prefetch(const ttak_table_arrays_t *a, uint64_t hash) {
+    size_t pos = hash & (a->capacity - 1);
+    ttak_arch_prefetch(a->ctrls + pos);
+    if (a->ikeys) ttak_arch_prefetch(a->ikeys + pos);
+    else ttak_arch_prefetch(a->keys + pos);
+    ttak_arch_prefetch(a->key_lens + pos);
+    ttak_arch_prefetch(a->values + pos);
+}
 
-    while (table->ctrls[idx] != EMPTY) {
-        if (table->ctrls[idx] == OCCUPIED && table->key_cmp(table->keys[idx], key) == 0) {
-            return table->values[idx];
+size_t ttak_table_get_batch(ttak_table_t *table, const void *const *keys, const size_t *key_lens,
+                            size_t n, void **out, uint64_t now) {
+    (void)now;
+    if (!table || !table->ctrls) {
+        for (size_t i = 0; i < n; i++) out[i] = NULL;
+        return 0;
+    }
+
+    ttak_table_arrays_t cur = ttak_table_current(table);
+    ttak_table_arrays_t old = ttak_table_old(table);
+    uint64_t h[TTAK_HT_BATCH_WINDOW];
+    size_t hits = 0;
+    for (size_t base = 0; base < n; base += TTAK_HT_BATCH_WINDOW) {
+        size_t cnt = n - base < TTAK_HT_BATCH_WINDOW ? n - base : TTAK_HT_BATCH_WINDOW;
+        if (table->hash_func == default_wyhash) {
+            ttak_hash_bytes_batch(keys + base, key_lens + base, cnt, table->k0, h);
+        } else if (table->hash_func == ttak_siphash13) {
+            ttak_siphash13_batch(keys + base, key_lens + base, cnt, table->k0, table->k1, h);
+        } else {
+            for (size_t i = 0; i < cnt; i++) {
+                h[i] = table->hash_func(keys[base + i], key_lens[base + i], table->k0, table->k1);
+            }
+        }
+        for (size_t i = 0; i < cnt; i++) {
+            ttak_table_prefetch(&cur, h[i]);
+            if (old.ctrls) ttak_table_prefetch(&old, h[i]);
+        }
+
+        for (size_t i = 0; i < cnt; i++) {
+            ttak_table_probe_t p;
+            ttak_table_probe_init(table, &p, keys[base + i], key_lens[base + i]);
+            void *val = NULL;
+            size_t idx = ttak_table_find(table, &cur, &p, h[i]);
+            if (idx != SIZE_MAX) {
+                val = cur.values[idx];
+                hits++;
+            } else if (old.ctrls && (idx = ttak_table_find(table, &old, &p, h[i])) != SIZE_MAX) {
+                val = old.values[idx];
+                hits++;
+            }
+            out[base + i] = val;
         }
-        idx++;
-        if (idx >= table->capacity + MAX_PROBE - 1) idx = 0;
     }
-    return NULL;
+    return hits;
 }
 
 bool ttak_table_remove(ttak_table_t *table, const void *key, size_t key_len, uint64_t now) {
     if (!table || !table->ctrls) return false;
     (void)now;
+    ttak_table_migrate(table, TTAK_TABLE_MIGRATE_STEP);
 
+    ttak_table_probe_t p;
+    ttak_table_probe_init(table, &p, key, key_len);
     uint64_t hash = table->hash_func(key, key_len, table->k0, table->k1);
-    size_t idx = hash & (table->capacity - 1);
-
-    while (table->ctrls[idx] != EMPTY) {
-        if (table->ctrls[idx] == OCCUPIED && table->key_cmp(table->keys[idx], key) == 0) {
-            if (table->key_free && table->keys[idx]) table->key_free(table->keys[idx]);
-            if (table->val_free && table->values[idx]) table->val_free(table->values[idx]);
-            table->ctrls[idx] = DELETED;
-            table->size--;
-            return true;
+    ttak_table_arrays_t a = ttak_table_current(table);
+    size_t idx = ttak_table_find(table, &a, &p, hash);
+    bool in_old = false;
+    if (idx == SIZE_MAX && table->old_ctrls) {
+        a = ttak_table_old(table);
+        idx = ttak_table_find(table, &a, &p, hash);
+        in_old = true;
+    }
+    if (idx == SIZE_MAX) return false;
+
+    void *owned = ttak_table_slot_owned_key(table, &a, idx);
+    if (table->key_free && owned) table->key_free(owned);
+    if (table->val_free && a.values[idx]) table->val_free(a.values[idx]);
+    a.ctrls[idx] = DELETED;
+    table->size--;
+    if (in_old) table->old_size--;
+    else table->deleted++;
+    return true;
+}
+
+/* Runs the free callbacks on every live pair in @p a. */
+static void ttak_table_release_pairs(ttak_table_t *table, const ttak_table_arrays_t *a) {
+    for (size_t i = 0; i < a->capacity + TTAK_HT_PAD; i++) {
+        if (TTAK_CTRL_FULL(a->ctrls[i])) {
+            void *owned = ttak_table_slot_owned_key(table, a, i);
+            if (table->key_free && owned) table->key_free(owned);
+            if (table->val_free && a->values[i]) table->val_free(a->values[i]);
         }
-        idx++;
-        if (idx >= table->capacity + MAX_PROBE - 1) idx = 0;
     }
-    return false;
 }
 
 void ttak_table_destroy(ttak_table_t *table, uint64_t now) {
     if (!table || !table->ctrls) return;
     (void)now;
 
-    for (size_t i = 0; i < table->capacity + MAX_PROBE; i++) {
-        if (table->ctrls[i] == OCCUPIED) {
-            if (table->key_free && table->keys[i]) table->key_free(table->keys[i]);
-            if (table->val_free && table->values[i]) table->val_free(table->values[i]);
-        }
+    ttak_table_arrays_t cur = ttak_table_current(table);
+    ttak_table_release_pairs(table, &cur);
+    ttak_table_arrays_free(&cur);
+    if (table->old_ctrls) {
+        ttak_table_arrays_t old = ttak_table_old(table);
+        ttak_table_release_pairs(table, &old);
+        ttak_table_arrays_free(&old);
     }
-    ttak_mem_free(table->ctrls);
-    ttak_mem_free(table->keys);
-    ttak_mem_free(table->key_lens);
-    ttak_mem_free(table->values);
+    table->ctrls = NULL;
+    table->keys = NULL;
+    table->ikeys = NULL;
+    table->key_lens = NULL;
+    table->values = NULL;
+    table->old_ctrls = NULL;
     table->size = 0;
+    table->old_size = 0;
 }
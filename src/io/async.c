@@ -4,14 +4,17 @@
  *
  * Wraps ttak_io_sync_read / ttak_io_sync_write as async tasks submitted
  * to the scheduler.  The completion callback is invoked on the worker
- * thread when the operation finishes or the timeout expires.
+ * thread when the operation finishes or the timeout expires. Once a ring
+ * is installed with ttak_io_async_set_uring(), operations go to it instead.
  */
 
 #include <ttak/io/async.h>
 
 #include <ttak/io/sync.h>
+#include <ttak/io/uring.h>
 #include <ttak/async/sched.h>
 #include <ttak/mem/mem.h>
+#include <ttak/log/trace.h>
 #include <ttak/timing/timing.h>
 
 #ifdef _WIN32
@@ -20,6 +23,26 @@
 #include <poll.h>
 #endif
 
+#include <stdatomic.h>
+
+static ttak_io_uring_t *_Atomic ttak_io_async_ring;
+
+void ttak_io_async_set_uring(ttak_io_uring_t *ring) {
+    atomic_store_explicit(&ttak_io_async_ring, ring, memory_order_release);
+}
+
+/* Queues and submits on the installed ring; false if none is installed. */
+static bool ttak_io_async_try_uring(ttak_io_guard_t *guard, void *buf, size_t len, int timeout_ms,
+                                    ttak_io_async_result_cb cb, void *user, bool is_write,
+                                    uint64_t now, ttak_io_status_t *status) {
+    ttak_io_uring_t *ring = atomic_load_explicit(&ttak_io_async_ring, memory_order_acquire);
+    if (!ring) return false;
+    *status = is_write ? ttak_io_uring_write(ring, guard, buf, len, timeout_ms, cb, user, now)
+                       : ttak_io_uring_read(ring, guard, buf, len, timeout_ms, cb, user, now);
+    if (*status == TTAK_IO_SUCCESS) ttak_io_uring_submit(ring);
+    return true;
+}
+
 typedef struct ttak_io_async_ctx {
     ttak_io_guard_t *guard;
     void *buffer;
@@ -31,6 +54,7 @@ typedef struct ttak_io_async_ctx {
 } ttak_io_async_ctx_t;
 
 static void ttak_io_async_finish(ttak_io_async_ctx_t *ctx, ttak_io_status_t status, size_t bytes) {
+    TTAK_TRACE(TTAK_TRACE_IO_COMPLETE, status, bytes);
     if (ctx->cb) {
         ctx->cb(status, bytes, ctx->user);
     }
@@ -80,6 +104,11 @@ ttak_io_status_t ttak_io_async_read(ttak_io_guard_t *guard,
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
 
+    ttak_io_status_t status;
+    if (ttak_io_async_try_uring(guard, dst, len, timeout_ms, cb, user, false, now, &status)) {
+        return status;
+    }
+
     ttak_io_async_ctx_t *ctx = ttak_mem_alloc_raw(sizeof(*ctx), __TTAK_UNSAFE_MEM_FOREVER__, now);
     if (!ctx) return TTAK_IO_ERR_SYS_FAILURE;
     ctx->guard = guard;
@@ -90,14 +119,14 @@ ttak_io_status_t ttak_io_async_read(ttak_io_guard_t *guard,
     ctx->user = user;
     ctx->is_write = false;
 
-    ttak_io_status_t status = ttak_io_poll_wait(guard,
-                                                POLLIN,
-                                                timeout_ms,
-                                                ttak_io_async_read_ready,
-                                                ctx,
-                                                NULL,
-                                                true,
-                                                now);
+    status = ttak_io_poll_wait(guard,
+                               POLLIN,
+                               timeout_ms,
+                               ttak_io_async_read_ready,
+                               ctx,
+                               NULL,
+                               true,
+                               now);
     if (status != TTAK_IO_SUCCESS) {
         ttak_mem_free(ctx);
     }
@@ -115,6 +144,11 @@ ttak_io_status_t ttak_io_async_write(ttak_io_guard_t *guard,
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
 
+    ttak_io_status_t status;
+    if (ttak_io_async_try_uring(guard, (void *)src, len, timeout_ms, cb, user, true, now, &status)) {
+        return status;
+    }
+
     ttak_io_async_ctx_t *ctx = ttak_mem_alloc_raw(sizeof(*ctx), __TTAK_UNSAFE_MEM_FOREVER__, now);
     if (!ctx) return TTAK_IO_ERR_SYS_FAILURE;
     ctx->guard = guard;
@@ -125,14 +159,14 @@ ttak_io_status_t ttak_io_async_write(ttak_io_guard_t *guard,
     ctx->user = user;
     ctx->is_write = true;
 
-    ttak_io_status_t status = ttak_io_poll_wait(guard,
-                                                POLLOUT,
-                                                timeout_ms,
-                                                ttak_io_async_write_ready,
-                                                ctx,
-                                                NULL,
-                                                true,
-                                                now);
+    status = ttak_io_poll_wait(guard,
+                               POLLOUT,
+                               timeout_ms,
+                               ttak_io_async_write_ready,
+                               ctx,
+                               NULL,
+                               true,
+                               now);
     if (status != TTAK_IO_SUCCESS) {
         ttak_mem_free(ctx);
     }
@@ -1,15 +1,208 @@
 /**
  * @file bits.c
- * @brief FNV-1a 32-bit checksum, buffer verification, and snapshot recovery.
+ * @brief CRC32C and FNV-1a 32-bit checksums, buffer verification, and snapshot recovery.
  */
 
 #include <ttak/io/bits.h>
 
+#include <ttak/arch/ttak_arch.h>
 #include <ttak/mem/mem.h>
 #include <ttak/timing/timing.h>
 
+#include <pthread.h>
 #include <string.h>
 
+#if defined(TTAK_ARCH_X86_64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#include <immintrin.h>
+#define TTAK_CRC32C_X86 1
+#elif defined(TTAK_ARCH_AARCH64) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define TTAK_CRC32C_ARM 1
+#endif
+
+/** Reflected Castagnoli polynomial. */
+#define CRC32C_POLY 0x82f63b78u
+
+/*
+ * Stream lengths for the three-way kernels. Each round checksums three
+ * adjacent blocks of one length in parallel, then shifts the first two
+ * forward over the bytes that follow them and folds them in.
+ */
+#define CRC32C_LONG 8192
+#define CRC32C_SHORT 256
+
+typedef uint32_t (*crc32c_fn)(uint32_t crc, const uint8_t *p, size_t len);
+
+static uint32_t crc32c_table[8][256];
+/* Multiplication by x^(8 * CRC32C_LONG) and x^(8 * CRC32C_SHORT) modulo P, one table per byte of the input. */
+static uint32_t crc32c_long_shift[4][256];
+static uint32_t crc32c_short_shift[4][256];
+
+static uint32_t crc32c_sw(uint32_t crc, const uint8_t *p, size_t len);
+static crc32c_fn g_crc32c = crc32c_sw;
+static const char *g_crc32c_name = "table";
+static pthread_once_t g_crc32c_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief a * b modulo P, in the reflected bit order CRCs use.
+ */
+static uint32_t crc32c_multmodp(uint32_t a, uint32_t b) {
+    uint32_t m = 1u << 31;
+    uint32_t p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+    }
+    return p;
+}
+
+/**
+ * @brief x^(8 * len) modulo P.
+ */
+static uint32_t crc32c_x8nmodp(size_t len) {
+    uint32_t p = 1u << 31;          /* x^0 */
+    uint32_t sq = 1u << 23;         /* x^8 */
+    while (len) {
+        if (len & 1) p = crc32c_multmodp(sq, p);
+        sq = crc32c_multmodp(sq, sq);
+        len >>= 1;
+    }
+    return p;
+}
+
+static void crc32c_shift_table(uint32_t table[4][256], size_t len) {
+    uint32_t k = crc32c_x8nmodp(len);
+    for (int b = 0; b < 4; b++) {
+        for (uint32_t n = 0; n < 256; n++) table[b][n] = crc32c_multmodp(k, n << (8 * b));
+    }
+}
+
+static inline uint32_t crc32c_shift(const uint32_t table[4][256], uint32_t crc) {
+    return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^
+           table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+}
+
+static inline uint64_t crc32c_load64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Slicing-by-8 on the raw (unconditioned) CRC register.
+ */
+static uint32_t crc32c_sw(uint32_t crc, const uint8_t *p, size_t len) {
+    while (len && ((uintptr_t)p & 7)) {
+        crc = crc32c_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+        len--;
+    }
+    for (; len >= 8; p += 8, len -= 8) {
+        /* Little-endian word order; on big-endian hosts fall through to bytes. */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        break;
+#endif
+        uint64_t w = crc32c_load64(p) ^ crc;
+        crc = crc32c_table[7][w & 0xff] ^ crc32c_table[6][(w >> 8) & 0xff] ^
+              crc32c_table[5][(w >> 16) & 0xff] ^ crc32c_table[4][(w >> 24) & 0xff] ^
+              crc32c_table[3][(w >> 32) & 0xff] ^ crc32c_table[2][(w >> 40) & 0xff] ^
+              crc32c_table[1][(w >> 48) & 0xff] ^ crc32c_table[0][w >> 56];
+    }
+    while (len--) crc = crc32c_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+#if defined(TTAK_CRC32C_X86) || defined(TTAK_CRC32C_ARM)
+#if defined(TTAK_CRC32C_X86)
+#define CRC32C_HW_TARGET __attribute__((target("sse4.2")))
+#define CRC32C_U8(c, v) _mm_crc32_u8((c), (v))
+#define CRC32C_U64(c, v) _mm_crc32_u64((c), (v))
+#else
+#define CRC32C_HW_TARGET
+#define CRC32C_U8(c, v) __crc32cb((c), (v))
+#define CRC32C_U64(c, v) __crc32cd((uint32_t)(c), (v))
+#endif
+
+/**
+ * @brief One three-way round over 3 * @p block bytes at @p p.
+ */
+#define CRC32C_HW_ROUND(block, table)                                          \
+    while (len >= 3 * (block)) {                                               \
+        uint64_t c1 = 0, c2 = 0;                                               \
+        const uint8_t *end = p + (block);                                      \
+        do {                                                                   \
+            c0 = CRC32C_U64(c0, crc32c_load64(p));                             \
+            c1 = CRC32C_U64(c1, crc32c_load64(p + (block)));                   \
+            c2 = CRC32C_U64(c2, crc32c_load64(p + 2 * (block)));               \
+            p += 8;                                                            \
+        } while (p < end);                                                     \
+        c0 = crc32c_shift((table), (uint32_t)c0) ^ (uint32_t)c1;               \
+        c0 = crc32c_shift((table), (uint32_t)c0) ^ (uint32_t)c2;               \
+        p += 2 * (block);                                                      \
+        len -= 3 * (block);                                                    \
+    }
+
+CRC32C_HW_TARGET
+static uint32_t crc32c_hw(uint32_t crc, const uint8_t *p, size_t len) {
+    while (len && ((uintptr_t)p & 7)) {
+        crc = CRC32C_U8(crc, *p++);
+        len--;
+    }
+    uint64_t c0 = crc;
+    CRC32C_HW_ROUND(CRC32C_LONG, crc32c_long_shift)
+    CRC32C_HW_ROUND(CRC32C_SHORT, crc32c_short_shift)
+    for (; len >= 8; p += 8, len -= 8) c0 = CRC32C_U64(c0, crc32c_load64(p));
+    crc = (uint32_t)c0;
+    while (len--) crc = CRC32C_U8(crc, *p++);
+    return crc;
+}
+#endif
+
+static void crc32c_select(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? (c >> 1) ^ CRC32C_POLY : c >> 1;
+        crc32c_table[0][n] = c;
+    }
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = crc32c_table[0][n];
+        for (int t = 1; t < 8; t++) {
+            c = crc32c_table[0][c & 0xff] ^ (c >> 8);
+            crc32c_table[t][n] = c;
+        }
+    }
+#if defined(TTAK_CRC32C_X86) || defined(TTAK_CRC32C_ARM)
+    if (ttak_arch_features() & TTAK_ARCH_FEATURE_CRC32C) {
+        crc32c_shift_table(crc32c_long_shift, CRC32C_LONG);
+        crc32c_shift_table(crc32c_short_shift, CRC32C_SHORT);
+        g_crc32c = crc32c_hw;
+#if defined(TTAK_CRC32C_X86)
+        g_crc32c_name = "sse4.2";
+#else
+        g_crc32c_name = "armv8-crc";
+#endif
+    }
+#endif
+}
+
+uint32_t ttak_io_bits_crc32c_update(uint32_t crc, const void *data, size_t len) {
+    pthread_once(&g_crc32c_once, crc32c_select);
+    if (!data || len == 0) return crc;
+    return ~g_crc32c(~crc, (const uint8_t *)data, len);
+}
+
+uint32_t ttak_io_bits_crc32c(const void *data, size_t len) {
+    return ttak_io_bits_crc32c_update(0, data, len);
+}
+
+const char *ttak_io_bits_crc32c_impl(void) {
+    pthread_once(&g_crc32c_once, crc32c_select);
+    return g_crc32c_name;
+}
+
 uint32_t ttak_io_bits_fnv32(const void *data, size_t len) {
     const uint8_t *bytes = (const uint8_t *)data;
     uint32_t hash = 2166136261u;
@@ -30,7 +223,7 @@ ttak_io_status_t ttak_io_bits_verify(const void *data,
     if (!data && len > 0) {
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
-    uint32_t checksum = ttak_io_bits_fnv32(data, len);
+    uint32_t checksum = ttak_io_bits_checksum(data, len);
     if (checksum != expected_checksum) {
         return TTAK_IO_ERR_NEEDS_RETRY;
     }
@@ -0,0 +1,327 @@
+/**
+ * @file chain.c
+ * @brief Buffer chains over reference-counted detachable blocks.
+ *
+ * A block allocated by an append carries its header in front of the
+ * payload in a single detachable allocation. An adopted zero-copy region
+ * keeps its own buffer and gets a separate header. A segment holds one
+ * block reference; the last one frees the block.
+ */
+
+#include <ttak/io/chain.h>
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+struct ttak_io_chain_block {
+    _Atomic uint32_t refs;
+    ttak_detachable_context_t *arena;
+    ttak_detachable_allocation_t self;      /**< Allocation holding this header. */
+    ttak_detachable_allocation_t payload;   /**< Adopted buffer; data NULL when inline. */
+    uint8_t *data;
+    size_t cap;
+    size_t used;                            /**< Bytes handed out by appends. */
+};
+
+static ttak_detachable_context_t *chain_arena(const ttak_io_chain_t *chain) {
+    return chain->arena ? chain->arena : ttak_detachable_context_default();
+}
+
+static void block_ref(ttak_io_chain_block_t *block) {
+    atomic_fetch_add_explicit(&block->refs, 1, memory_order_relaxed);
+}
+
+static void block_unref(ttak_io_chain_block_t *block) {
+    if (atomic_fetch_sub_explicit(&block->refs, 1, memory_order_acq_rel) != 1) return;
+    ttak_detachable_context_t *arena = block->arena;
+    if (block->payload.data) ttak_detachable_mem_free(arena, &block->payload);
+    ttak_detachable_allocation_t self = block->self;
+    ttak_detachable_mem_free(arena, &self);
+}
+
+static ttak_io_chain_block_t *block_new(ttak_detachable_context_t *arena, size_t cap, uint64_t now) {
+    ttak_detachable_allocation_t alloc = ttak_detachable_mem_alloc(arena, sizeof(ttak_io_chain_block_t) + cap, now);
+    if (!alloc.data) return NULL;
+    ttak_io_chain_block_t *block = alloc.data;
+    atomic_init(&block->refs, 0);
+    block->arena = arena;
+    block->self = alloc;
+    memset(&block->payload, 0, sizeof(block->payload));
+    block->data = (uint8_t *)(block + 1);
+    block->cap = cap;
+    block->used = 0;
+    return block;
+}
+
+static bool chain_grow(ttak_io_chain_t *chain, uint32_t need) {
+    if (chain->count + need <= chain->cap) return true;
+    uint32_t cap = chain->cap * 2U;
+    while (cap < chain->count + need) cap *= 2U;
+    ttak_io_chain_seg_t *segs;
+    if (chain->segs == chain->inline_segs) {
+        segs = malloc(sizeof(*segs) * cap);
+        if (segs) memcpy(segs, chain->inline_segs, sizeof(*segs) * chain->count);
+    } else {
+        segs = realloc(chain->segs, sizeof(*segs) * cap);
+    }
+    if (!segs) return false;
+    chain->segs = segs;
+    chain->cap = cap;
+    return true;
+}
+
+/* Appends a segment taking a new reference on @p block. */
+static bool chain_push(ttak_io_chain_t *chain, ttak_io_chain_block_t *block, uint8_t *data, size_t len) {
+    if (!chain_grow(chain, 1)) return false;
+    block_ref(block);
+    chain->segs[chain->count++] = (ttak_io_chain_seg_t){ .block = block, .data = data, .len = len };
+    chain->len += len;
+    return true;
+}
+
+/* Free room at the end of the tail block if only this chain can see it. */
+static size_t chain_tail_room(const ttak_io_chain_t *chain) {
+    if (chain->count == 0) return 0;
+    const ttak_io_chain_seg_t *tail = &chain->segs[chain->count - 1];
+    ttak_io_chain_block_t *block = tail->block;
+    if (block->payload.data) return 0;
+    if (tail->data + tail->len != block->data + block->used) return 0;
+    if (atomic_load_explicit(&block->refs, memory_order_acquire) != 1) return 0;
+    return block->cap - block->used;
+}
+
+void ttak_io_chain_init(ttak_io_chain_t *chain, ttak_detachable_context_t *arena) {
+    if (!chain) return;
+    chain->segs = chain->inline_segs;
+    chain->count = 0;
+    chain->cap = TTAK_IO_CHAIN_INLINE_SEGS;
+    chain->len = 0;
+    chain->arena = arena;
+}
+
+void ttak_io_chain_destroy(ttak_io_chain_t *chain) {
+    if (!chain) return;
+    for (uint32_t i = 0; i < chain->count; i++) block_unref(chain->segs[i].block);
+    if (chain->segs != chain->inline_segs) free(chain->segs);
+    ttak_io_chain_init(chain, chain->arena);
+}
+
+uint8_t *ttak_io_chain_reserve(ttak_io_chain_t *chain, size_t len, uint64_t now) {
+    if (!chain || len == 0) return NULL;
+    if (chain_tail_room(chain) >= len) {
+        ttak_io_chain_seg_t *tail = &chain->segs[chain->count - 1];
+        uint8_t *out = tail->data + tail->len;
+        tail->len += len;
+        tail->block->used += len;
+        chain->len += len;
+        return out;
+    }
+    size_t cap = len > TTAK_IO_CHAIN_BLOCK_BYTES ? len : TTAK_IO_CHAIN_BLOCK_BYTES;
+    ttak_io_chain_block_t *block = block_new(chain_arena(chain), cap, now);
+    if (!block) return NULL;
+    if (!chain_push(chain, block, block->data, len)) {
+        atomic_init(&block->refs, 1);
+        block_unref(block);
+        return NULL;
+    }
+    block->used = len;
+    return block->data;
+}
+
+ttak_io_status_t ttak_io_chain_append(ttak_io_chain_t *chain, const void *data, size_t len, uint64_t now) {
+    if (!chain || (!data && len > 0)) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (len == 0) return TTAK_IO_SUCCESS;
+    const uint8_t *src = data;
+    // Top up the tail block first so small appends share one segment.
+    size_t room = chain_tail_room(chain);
+    if (room > 0 && room < len) {
+        memcpy(ttak_io_chain_reserve(chain, room, now), src, room);
+        src += room;
+        len -= room;
+    }
+    uint8_t *dst = ttak_io_chain_reserve(chain, len, now);
+    if (!dst) return TTAK_IO_ERR_SYS_FAILURE;
+    memcpy(dst, src, len);
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_chain_append_slice(ttak_io_chain_t *dst,
+                                            const ttak_io_chain_t *src,
+                                            size_t off,
+                                            size_t len) {
+    if (!dst || !src || dst == src) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (off > src->len || len > src->len - off) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    uint32_t i = 0;
+    while (i < src->count && off >= src->segs[i].len) off -= src->segs[i++].len;
+    uint32_t need = 0;
+    for (size_t left = len, j = i, skip = off; left > 0; j++, skip = 0) {
+        size_t take = src->segs[j].len - skip;
+        left -= take < left ? take : left;
+        need++;
+    }
+    if (!chain_grow(dst, need)) return TTAK_IO_ERR_SYS_FAILURE;
+    while (len > 0) {
+        const ttak_io_chain_seg_t *seg = &src->segs[i++];
+        size_t take = seg->len - off;
+        if (take > len) take = len;
+        chain_push(dst, seg->block, seg->data + off, take);
+        len -= take;
+        off = 0;
+    }
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_chain_append_chain(ttak_io_chain_t *dst, const ttak_io_chain_t *src) {
+    if (!src) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    return ttak_io_chain_append_slice(dst, src, 0, src->len);
+}
+
+ttak_io_status_t ttak_io_chain_adopt_region(ttak_io_chain_t *chain, ttak_io_zerocopy_region_t *region) {
+    if (!chain || !region) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (!region->allocation.data || region->len == 0) return TTAK_IO_SUCCESS;
+    ttak_detachable_context_t *arena = region->arena ? region->arena : ttak_detachable_context_default();
+    ttak_io_chain_block_t *block = block_new(arena, 0, 0);
+    if (!block) return TTAK_IO_ERR_SYS_FAILURE;
+    block->payload = region->allocation;
+    block->data = region->allocation.data;
+    block->cap = region->capacity;
+    block->used = region->len;
+    if (!chain_push(chain, block, block->data, region->len)) {
+        memset(&block->payload, 0, sizeof(block->payload));
+        atomic_init(&block->refs, 1);
+        block_unref(block);
+        return TTAK_IO_ERR_SYS_FAILURE;
+    }
+    ttak_detachable_context_t *bound = region->bound_arena;
+    ttak_io_zerocopy_region_init(region);
+    ttak_io_zerocopy_region_bind(region, bound);
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_chain_split(ttak_io_chain_t *chain, size_t off, ttak_io_chain_t *tail) {
+    if (!chain || !tail || chain == tail || off > chain->len) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    ttak_io_status_t status = ttak_io_chain_append_slice(tail, chain, off, chain->len - off);
+    if (status != TTAK_IO_SUCCESS) return status;
+
+    // Keep whole segments before @p off and the front of the one it falls in.
+    uint32_t keep = 0;
+    size_t left = off;
+    while (left > 0) {
+        ttak_io_chain_seg_t *seg = &chain->segs[keep++];
+        if (seg->len >= left) {
+            seg->len = left;
+            break;
+        }
+        left -= seg->len;
+    }
+    for (uint32_t i = keep; i < chain->count; i++) block_unref(chain->segs[i].block);
+    chain->count = keep;
+    chain->len = off;
+    return TTAK_IO_SUCCESS;
+}
+
+void ttak_io_chain_consume(ttak_io_chain_t *chain, size_t len) {
+    if (!chain) return;
+    if (len >= chain->len) {
+        ttak_io_chain_destroy(chain);
+        return;
+    }
+    uint32_t drop = 0;
+    chain->len -= len;
+    while (len > 0 && len >= chain->segs[drop].len) {
+        len -= chain->segs[drop].len;
+        block_unref(chain->segs[drop++].block);
+    }
+    chain->segs[drop].data += len;
+    chain->segs[drop].len -= len;
+    chain->count -= drop;
+    memmove(chain->segs, chain->segs + drop, sizeof(*chain->segs) * chain->count);
+}
+
+size_t ttak_io_chain_copyout(const ttak_io_chain_t *chain, size_t off, void *dst, size_t len) {
+    if (!chain || !dst || off >= chain->len) return 0;
+    uint8_t *out = dst;
+    size_t copied = 0;
+    for (uint32_t i = 0; i < chain->count && copied < len; i++) {
+        const ttak_io_chain_seg_t *seg = &chain->segs[i];
+        if (off >= seg->len) {
+            off -= seg->len;
+            continue;
+        }
+        size_t take = seg->len - off;
+        if (take > len - copied) take = len - copied;
+        memcpy(out + copied, seg->data + off, take);
+        copied += take;
+        off = 0;
+    }
+    return copied;
+}
+
+#ifndef _WIN32
+size_t ttak_io_chain_to_iovec(const ttak_io_chain_t *chain, struct iovec *iov, size_t max) {
+    if (!chain || !iov) return 0;
+    size_t n = chain->count < max ? chain->count : max;
+    for (size_t i = 0; i < n; i++) {
+        iov[i].iov_base = chain->segs[i].data;
+        iov[i].iov_len = chain->segs[i].len;
+    }
+    return n;
+}
+
+ttak_io_status_t ttak_io_chain_send(int fd, ttak_io_chain_t *chain, int flags, size_t *sent) {
+    if (sent) *sent = 0;
+    if (fd < 0 || !chain) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (chain->len == 0) return TTAK_IO_SUCCESS;
+    struct iovec iov[TTAK_IO_CHAIN_IOV_MAX];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = ttak_io_chain_to_iovec(chain, iov, TTAK_IO_CHAIN_IOV_MAX);
+    ssize_t rc;
+    do {
+        rc = sendmsg(fd, &msg, flags);
+    } while (rc < 0 && errno == EINTR);
+    if (rc < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? TTAK_IO_ERR_NEEDS_RETRY : TTAK_IO_ERR_SYS_FAILURE;
+    }
+    ttak_io_chain_consume(chain, (size_t)rc);
+    if (sent) *sent = (size_t)rc;
+    return TTAK_IO_SUCCESS;
+}
+#else
+size_t ttak_io_chain_to_iovec(const ttak_io_chain_t *chain, struct iovec *iov, size_t max) {
+    (void)chain;
+    (void)iov;
+    (void)max;
+    return 0;
+}
+
+ttak_io_status_t ttak_io_chain_send(int fd, ttak_io_chain_t *chain, int flags, size_t *sent) {
+    if (sent) *sent = 0;
+    if (fd < 0 || !chain) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (chain->len == 0) return TTAK_IO_SUCCESS;
+    WSABUF bufs[TTAK_IO_CHAIN_IOV_MAX];
+    DWORD n = chain->count < TTAK_IO_CHAIN_IOV_MAX ? chain->count : TTAK_IO_CHAIN_IOV_MAX;
+    for (DWORD i = 0; i < n; i++) {
+        bufs[i].buf = (char *)chain->segs[i].data;
+        bufs[i].len = (ULONG)chain->segs[i].len;
+    }
+    DWORD bytes = 0;
+    if (WSASend((SOCKET)fd, bufs, n, &bytes, (DWORD)flags, NULL, NULL) != 0) {
+        return WSAGetLastError() == WSAEWOULDBLOCK ? TTAK_IO_ERR_NEEDS_RETRY : TTAK_IO_ERR_SYS_FAILURE;
+    }
+    ttak_io_chain_consume(chain, bytes);
+    if (sent) *sent = bytes;
+    return TTAK_IO_SUCCESS;
+}
+#endif
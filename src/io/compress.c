@@ -0,0 +1,669 @@
+/**
+ * @file compress.c
+ * @brief LZ4 block codec, frame layout and pool-parallel frame coding.
+ *
+ * The compressor addresses input through one position space in which the
+ * dictionary occupies [0, dict_len) and the block follows it, so a match
+ * candidate is a plain 32-bit position whichever side it lands on. A
+ * dictionary keeps a match table primed over its bytes; each block starts
+ * from a copy of it.
+ */
+
+#include <ttak/io/compress.h>
+#include <ttak/thread/parallel.h>
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LZ_MIN_MATCH 4U
+#define LZ_LAST_LITERALS 5U     /* A block ends in at least this many literals. */
+#define LZ_MATCH_FLOOR 12U      /* No match starts closer than this to the end. */
+#define LZ_MAX_OFFSET 65535U
+#define LZ_HASH_LOG 12U
+#define LZ_HASH_SIZE (1U << LZ_HASH_LOG)
+#define LZ_SKIP_TRIGGER 6U      /* Misses before the search starts striding. */
+
+#define FRAME_MAGIC 0x315a5454U /* "TTZ1" */
+#define FRAME_STORED 0x80000000U
+
+/* Blocks compressed per parallel batch of a one-shot frame. */
+#define FRAME_BATCH_BLOCKS 64U
+
+struct ttak_io_compress_dict {
+    uint32_t len;
+    uint32_t id;
+    uint32_t table[LZ_HASH_SIZE];
+    uint8_t data[];
+};
+
+static inline uint32_t read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t get_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void put_le32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t lz_hash(uint32_t v) {
+    return (v * 2654435761U) >> (32U - LZ_HASH_LOG);
+}
+
+/* Length of the common prefix of @p a and @p b, not reading @p a past @p limit. */
+static inline size_t lz_count(const uint8_t *a, const uint8_t *b, const uint8_t *limit) {
+    const uint8_t *start = a;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (limit - a >= 8) {
+        uint64_t diff = read64(a) ^ read64(b);
+        if (diff) return (size_t)(a - start) + (size_t)(__builtin_ctzll(diff) >> 3);
+        a += 8;
+        b += 8;
+    }
+#endif
+    while (a < limit && *a == *b) {
+        a++;
+        b++;
+    }
+    return (size_t)(a - start);
+}
+
+static inline uint8_t *lz_put_length(uint8_t *op, size_t len) {
+    for (; len >= 255; len -= 255) *op++ = 255;
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+/* Bytes a length field of @p len past its 15 in the token takes. */
+static inline size_t lz_length_bytes(size_t len) {
+    return len < 15 ? 0 : (len - 15) / 255 + 1;
+}
+
+static uint8_t *lz_put_literals(uint8_t *op, const uint8_t *oend, const uint8_t *lit, size_t len,
+                                uint8_t **token) {
+    if ((size_t)(oend - op) < 1 + lz_length_bytes(len) + len) return NULL;
+    *token = op++;
+    if (len >= 15) {
+        **token = 15 << 4;
+        op = lz_put_length(op, len - 15);
+    } else {
+        **token = (uint8_t)(len << 4);
+    }
+    memcpy(op, lit, len);
+    return op + len;
+}
+
+ttak_io_compress_dict_t *ttak_io_compress_dict_create(const void *data, size_t len) {
+    if (!data || len == 0) return NULL;
+    const uint8_t *src = data;
+    if (len > TTAK_IO_COMPRESS_DICT_MAX) {
+        src += len - TTAK_IO_COMPRESS_DICT_MAX;
+        len = TTAK_IO_COMPRESS_DICT_MAX;
+    }
+    ttak_io_compress_dict_t *dict = calloc(1, sizeof(*dict) + len);
+    if (!dict) return NULL;
+    memcpy(dict->data, src, len);
+    dict->len = (uint32_t)len;
+    // Later positions overwrite earlier ones, so the table favours near matches.
+    for (uint32_t i = 0; i + LZ_MIN_MATCH <= dict->len; i++) dict->table[lz_hash(read32(dict->data + i))] = i;
+    uint32_t id = 2166136261U;
+    for (size_t i = 0; i < len; i++) id = (id ^ dict->data[i]) * 16777619U;
+    dict->id = id ? id : 1;
+    return dict;
+}
+
+void ttak_io_compress_dict_destroy(ttak_io_compress_dict_t *dict) {
+    free(dict);
+}
+
+uint32_t ttak_io_compress_dict_id(const ttak_io_compress_dict_t *dict) {
+    return dict ? dict->id : 0;
+}
+
+size_t ttak_io_compress_block(const void *src_, size_t len, void *dst, size_t cap,
+                              const ttak_io_compress_dict_t *dict) {
+    if ((!src_ && len > 0) || !dst || len > TTAK_IO_COMPRESS_BLOCK_MAX) return 0;
+    const uint8_t *src = src_;
+    uint8_t *op = dst;
+    const uint8_t *oend = op + cap;
+    uint8_t *token;
+    size_t anchor = 0;
+
+    if (len >= LZ_MATCH_FLOOR + 1) {
+        uint32_t table[LZ_HASH_SIZE];
+        const uint8_t *dbytes = dict ? dict->data : NULL;
+        const uint32_t dlen = dict ? dict->len : 0;
+        if (dict) memcpy(table, dict->table, sizeof(table));
+        else memset(table, 0, sizeof(table));
+
+        const size_t mflimit = len - LZ_MATCH_FLOOR;
+        const uint8_t *matchlimit = src + len - LZ_LAST_LITERALS;
+        size_t ip = 0;
+        table[lz_hash(read32(src))] = dlen;
+        ip++;
+
+        for (;;) {
+            uint32_t cand, cur;
+            uint32_t misses = 1U << LZ_SKIP_TRIGGER;
+            for (;;) {
+                if (ip > mflimit) goto last;
+                uint32_t seq = read32(src + ip);
+                uint32_t h = lz_hash(seq);
+                cur = dlen + (uint32_t)ip;
+                cand = table[h];
+                table[h] = cur;
+                if (cand < cur && cur - cand <= LZ_MAX_OFFSET) {
+                    if (cand >= dlen) {
+                        if (read32(src + (cand - dlen)) == seq) break;
+                    } else if (cand + LZ_MIN_MATCH <= dlen && read32(dbytes + cand) == seq) {
+                        break;
+                    }
+                }
+                ip += misses++ >> LZ_SKIP_TRIGGER;
+            }
+
+            // Extend a match inside the block backwards over pending literals.
+            while (ip > anchor && cand > dlen && src[ip - 1] == src[cand - dlen - 1]) {
+                ip--;
+                cand--;
+            }
+            cur = dlen + (uint32_t)ip;
+
+            size_t mlen;
+            if (cand >= dlen) {
+                mlen = LZ_MIN_MATCH + lz_count(src + ip + LZ_MIN_MATCH, src + (cand - dlen) + LZ_MIN_MATCH, matchlimit);
+            } else {
+                // Match in the dictionary; it may run off its end into the block.
+                const uint8_t *limit = src + ip + (dlen - cand);
+                if (limit > matchlimit) limit = matchlimit;
+                mlen = LZ_MIN_MATCH + lz_count(src + ip + LZ_MIN_MATCH, dbytes + cand + LZ_MIN_MATCH, limit);
+                if (cand + mlen == dlen) mlen += lz_count(src + ip + mlen, src, matchlimit);
+            }
+
+            op = lz_put_literals(op, oend, src + anchor, ip - anchor, &token);
+            if (!op || (size_t)(oend - op) < 2 + lz_length_bytes(mlen - LZ_MIN_MATCH)) return 0;
+            uint32_t offset = cur - cand;
+            *op++ = (uint8_t)offset;
+            *op++ = (uint8_t)(offset >> 8);
+            if (mlen - LZ_MIN_MATCH >= 15) {
+                *token |= 15;
+                op = lz_put_length(op, mlen - LZ_MIN_MATCH - 15);
+            } else {
+                *token |= (uint8_t)(mlen - LZ_MIN_MATCH);
+            }
+            ip += mlen;
+            anchor = ip;
+            if (ip > mflimit) break;
+            table[lz_hash(read32(src + ip - 2))] = dlen + (uint32_t)(ip - 2);
+        }
+    }
+last:
+    op = lz_put_literals(op, oend, src + anchor, len - anchor, &token);
+    return op ? (size_t)(op - (uint8_t *)dst) : 0;
+}
+
+static inline bool lz_get_length(const uint8_t **ip, const uint8_t *iend, size_t *len) {
+    uint8_t b;
+    do {
+        if (*ip >= iend) return false;
+        b = *(*ip)++;
+        *len += b;
+    } while (b == 255 && *len < TTAK_IO_COMPRESS_BLOCK_MAX * 2U);
+    return b != 255;
+}
+
+ttak_io_status_t ttak_io_decompress_block(const void *src, size_t len, void *dst_, size_t cap,
+                                          const ttak_io_compress_dict_t *dict, size_t *out_len) {
+    if (!src || !dst_ || !out_len) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    const uint8_t *ip = src;
+    const uint8_t *iend = ip + len;
+    uint8_t *dst = dst_;
+    uint8_t *op = dst;
+    const uint8_t *oend = dst + cap;
+    const size_t dlen = dict ? dict->len : 0;
+
+    for (;;) {
+        if (ip >= iend) return TTAK_IO_ERR_RANGE;
+        uint8_t token = *ip++;
+        size_t lit = token >> 4;
+        if (lit == 15 && !lz_get_length(&ip, iend, &lit)) return TTAK_IO_ERR_RANGE;
+        if (lit > (size_t)(iend - ip) || lit > (size_t)(oend - op)) return TTAK_IO_ERR_RANGE;
+        memcpy(op, ip, lit);
+        op += lit;
+        ip += lit;
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return TTAK_IO_ERR_RANGE;
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        size_t mlen = token & 15U;
+        if (mlen == 15 && !lz_get_length(&ip, iend, &mlen)) return TTAK_IO_ERR_RANGE;
+        mlen += LZ_MIN_MATCH;
+        size_t produced = (size_t)(op - dst);
+        if (offset == 0 || offset > produced + dlen || mlen > (size_t)(oend - op)) return TTAK_IO_ERR_RANGE;
+
+        const uint8_t *match;
+        if (offset > produced) {
+            size_t back = offset - produced;
+            size_t n = back < mlen ? back : mlen;
+            memcpy(op, dict->data + dlen - back, n);
+            op += n;
+            mlen -= n;
+            match = dst;
+        } else {
+            match = op - offset;
+        }
+        // Overlapping copies repeat the last @c offset bytes, so copy forwards.
+        if ((size_t)(op - match) >= mlen) {
+            memcpy(op, match, mlen);
+            op += mlen;
+        } else if (op - match >= 8) {
+            while (mlen >= 8) {
+                memcpy(op, match, 8);
+                op += 8;
+                match += 8;
+                mlen -= 8;
+            }
+            while (mlen--) *op++ = *match++;
+        } else {
+            while (mlen--) *op++ = *match++;
+        }
+    }
+    *out_len = (size_t)(op - dst);
+    return TTAK_IO_SUCCESS;
+}
+
+/* ---- Frames ---- */
+
+typedef struct frame_batch {
+    const uint8_t *src;
+    size_t len;
+    size_t block;
+    const ttak_io_compress_dict_t *dict;
+    uint8_t *scratch;       /* @c block bytes per block. */
+    uint32_t *sizes;        /* Encoded length, FRAME_STORED when kept raw. */
+} frame_batch_t;
+
+static void frame_batch_body(void *ctx, size_t begin, size_t end) {
+    frame_batch_t *b = ctx;
+    for (size_t i = begin; i < end; i++) {
+        size_t off = i * b->block;
+        size_t raw = b->len - off < b->block ? b->len - off : b->block;
+        // A block that does not shrink is stored as is.
+        size_t n = ttak_io_compress_block(b->src + off, raw, b->scratch + off, raw - 1, b->dict);
+        b->sizes[i] = n ? (uint32_t)n : FRAME_STORED;
+    }
+}
+
+static ttak_io_status_t frame_put_header(ttak_io_chain_t *out, uint32_t raw, uint32_t stored, uint64_t now) {
+    uint8_t *hdr = ttak_io_chain_reserve(out, TTAK_IO_COMPRESS_BLOCK_HEADER, now);
+    if (!hdr) return TTAK_IO_ERR_SYS_FAILURE;
+    put_le32(hdr, raw);
+    put_le32(hdr + 4, stored);
+    return TTAK_IO_SUCCESS;
+}
+
+static ttak_io_status_t frame_put_start(ttak_io_chain_t *out, size_t block, const ttak_io_compress_dict_t *dict,
+                                        uint64_t now) {
+    uint8_t *hdr = ttak_io_chain_reserve(out, TTAK_IO_COMPRESS_FRAME_HEADER, now);
+    if (!hdr) return TTAK_IO_ERR_SYS_FAILURE;
+    put_le32(hdr, FRAME_MAGIC);
+    put_le32(hdr + 4, (uint32_t)block);
+    put_le32(hdr + 8, ttak_io_compress_dict_id(dict));
+    return TTAK_IO_SUCCESS;
+}
+
+/* Compresses @p len bytes as consecutive blocks and appends them to @p out. */
+static ttak_io_status_t frame_put_blocks(ttak_thread_pool_t *pool, const uint8_t *src, size_t len, size_t block,
+                                         const ttak_io_compress_dict_t *dict, ttak_io_chain_t *out,
+                                         uint64_t *out_bytes, uint64_t now) {
+    if (len == 0) return TTAK_IO_SUCCESS;
+    size_t nblocks = (len + block - 1) / block;
+    frame_batch_t b = { src, len, block, dict, malloc(len), malloc(nblocks * sizeof(uint32_t)) };
+    ttak_io_status_t st = TTAK_IO_ERR_SYS_FAILURE;
+    if (!b.scratch || !b.sizes) goto out;
+    ttak_parallel_for(pool, 0, nblocks, 1, frame_batch_body, &b, now);
+
+    for (size_t i = 0; i < nblocks; i++) {
+        size_t off = i * block;
+        uint32_t raw = (uint32_t)(len - off < block ? len - off : block);
+        bool stored = b.sizes[i] == FRAME_STORED;
+        uint32_t n = stored ? raw : b.sizes[i];
+        st = frame_put_header(out, raw, stored ? (raw | FRAME_STORED) : n, now);
+        if (st == TTAK_IO_SUCCESS) st = ttak_io_chain_append(out, stored ? src + off : b.scratch + off, n, now);
+        if (st != TTAK_IO_SUCCESS) goto out;
+        if (out_bytes) *out_bytes += TTAK_IO_COMPRESS_BLOCK_HEADER + n;
+    }
+    st = TTAK_IO_SUCCESS;
+out:
+    free(b.scratch);
+    free(b.sizes);
+    return st;
+}
+
+ttak_io_status_t ttak_io_compress_frame(ttak_thread_pool_t *pool, const void *src, size_t len,
+                                        size_t block_size, const ttak_io_compress_dict_t *dict,
+                                        ttak_io_chain_t *out, uint64_t now) {
+    if (block_size == 0) block_size = TTAK_IO_COMPRESS_BLOCK_DEFAULT;
+    if ((!src && len > 0) || !out || block_size > TTAK_IO_COMPRESS_BLOCK_MAX) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    ttak_io_status_t st = frame_put_start(out, block_size, dict, now);
+    // Batches bound the scratch memory to a fixed number of blocks.
+    const size_t batch = block_size * FRAME_BATCH_BLOCKS;
+    for (size_t off = 0; st == TTAK_IO_SUCCESS && off < len; off += batch) {
+        size_t n = len - off < batch ? len - off : batch;
+        st = frame_put_blocks(pool, (const uint8_t *)src + off, n, block_size, dict, out, NULL, now);
+    }
+    if (st == TTAK_IO_SUCCESS) st = frame_put_header(out, 0, 0, now);
+    return st;
+}
+
+typedef struct frame_block {
+    size_t in;          /* Offset of the block bytes in the frame. */
+    size_t out;         /* Offset of the decoded bytes. */
+    uint32_t raw;
+    uint32_t stored;
+} frame_block_t;
+
+/*
+ * Validates the frame and counts its blocks and decoded bytes; with
+ * @p blocks set, also describes each block.
+ */
+static ttak_io_status_t frame_scan(const uint8_t *src, size_t len, frame_block_t *blocks, size_t *nblocks,
+                                   size_t *size, uint32_t *dict_id) {
+    if (len < TTAK_IO_COMPRESS_FRAME_HEADER || get_le32(src) != FRAME_MAGIC) return TTAK_IO_ERR_RANGE;
+    uint32_t max_block = get_le32(src + 4);
+    if (max_block == 0 || max_block > TTAK_IO_COMPRESS_BLOCK_MAX) return TTAK_IO_ERR_RANGE;
+    *dict_id = get_le32(src + 8);
+    size_t pos = TTAK_IO_COMPRESS_FRAME_HEADER;
+    size_t n = 0, total = 0;
+    for (;;) {
+        if (len - pos < TTAK_IO_COMPRESS_BLOCK_HEADER) return TTAK_IO_ERR_RANGE;
+        uint32_t raw = get_le32(src + pos);
+        uint32_t stored = get_le32(src + pos + 4);
+        pos += TTAK_IO_COMPRESS_BLOCK_HEADER;
+        if (raw == 0) {
+            if (stored != 0) return TTAK_IO_ERR_RANGE;
+            break;
+        }
+        uint32_t bytes = stored & ~FRAME_STORED;
+        if (raw > max_block || ((stored & FRAME_STORED) ? bytes != raw : bytes >= raw) || bytes > len - pos) {
+            return TTAK_IO_ERR_RANGE;
+        }
+        if (blocks) blocks[n] = (frame_block_t){ pos, total, raw, stored };
+        pos += bytes;
+        total += raw;
+        n++;
+    }
+    *nblocks = n;
+    *size = total;
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_decompress_frame_size(const void *src, size_t len, size_t *size) {
+    if (!src || !size) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    size_t n;
+    uint32_t id;
+    return frame_scan(src, len, NULL, &n, size, &id);
+}
+
+typedef struct frame_decode {
+    const uint8_t *src;
+    uint8_t *dst;
+    const frame_block_t *blocks;
+    const ttak_io_compress_dict_t *dict;
+    _Atomic bool failed;
+} frame_decode_t;
+
+static void frame_decode_body(void *ctx, size_t begin, size_t end) {
+    frame_decode_t *d = ctx;
+    for (size_t i = begin; i < end && !atomic_load_explicit(&d->failed, memory_order_relaxed); i++) {
+        const frame_block_t *b = &d->blocks[i];
+        if (b->stored & FRAME_STORED) {
+            memcpy(d->dst + b->out, d->src + b->in, b->raw);
+            continue;
+        }
+        size_t got = 0;
+        if (ttak_io_decompress_block(d->src + b->in, b->stored, d->dst + b->out, b->raw, d->dict, &got) !=
+                TTAK_IO_SUCCESS || got != b->raw) {
+            atomic_store_explicit(&d->failed, true, memory_order_relaxed);
+        }
+    }
+}
+
+ttak_io_status_t ttak_io_decompress_frame(ttak_thread_pool_t *pool, const void *src, size_t len,
+                                          const ttak_io_compress_dict_t *dict,
+                                          void *dst, size_t cap, size_t *out_len) {
+    if (!src || (!dst && cap > 0) || !out_len) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    size_t n, size;
+    uint32_t id;
+    ttak_io_status_t st = frame_scan(src, len, NULL, &n, &size, &id);
+    if (st != TTAK_IO_SUCCESS) return st;
+    if (id != ttak_io_compress_dict_id(dict)) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (size > cap) return TTAK_IO_ERR_RANGE;
+    if (n == 0) {
+        *out_len = 0;
+        return TTAK_IO_SUCCESS;
+    }
+    frame_block_t *blocks = malloc(n * sizeof(*blocks));
+    if (!blocks) return TTAK_IO_ERR_SYS_FAILURE;
+    frame_scan(src, len, blocks, &n, &size, &id);
+    frame_decode_t d = { src, dst, blocks, dict, false };
+    ttak_parallel_for(pool, 0, n, 1, frame_decode_body, &d, ttak_get_tick_count());
+    free(blocks);
+    if (atomic_load(&d.failed)) return TTAK_IO_ERR_RANGE;
+    *out_len = size;
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_decompress_mmap(ttak_thread_pool_t *pool, ttak_io_mmap_t *map,
+                                         const ttak_io_compress_dict_t *dict,
+                                         ttak_detachable_context_t *arena,
+                                         ttak_detachable_allocation_t *out, uint64_t now) {
+    if (!map || !out) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (!arena) arena = ttak_detachable_context_default();
+    memset(out, 0, sizeof(*out));
+    const uint8_t *data;
+    ttak_io_status_t st = ttak_io_mmap_retain(map, 0, map->len, &data, now);
+    if (st != TTAK_IO_SUCCESS) return st;
+    size_t size = 0;
+    st = ttak_io_decompress_frame_size(data, map->len, &size);
+    if (st == TTAK_IO_SUCCESS) {
+        *out = ttak_detachable_mem_alloc(arena, size ? size : 1, now);
+        if (!out->data) st = TTAK_IO_ERR_SYS_FAILURE;
+    }
+    if (st == TTAK_IO_SUCCESS) {
+        st = ttak_io_decompress_frame(pool, data, map->len, dict, out->data, size, &size);
+        if (st != TTAK_IO_SUCCESS) ttak_detachable_mem_free(arena, out);
+        else out->size = size;
+    }
+    ttak_io_mmap_release(map);
+    return st;
+}
+
+/* ---- Streams ---- */
+
+ttak_io_status_t ttak_io_compress_stream_init(ttak_io_compress_stream_t *stream, ttak_thread_pool_t *pool,
+                                              size_t block_size, const ttak_io_compress_dict_t *dict) {
+    if (!stream) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (block_size == 0) block_size = TTAK_IO_COMPRESS_BLOCK_DEFAULT;
+    if (block_size > TTAK_IO_COMPRESS_BLOCK_MAX) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    memset(stream, 0, sizeof(*stream));
+    stream->pool = pool;
+    stream->dict = dict;
+    stream->block_size = block_size;
+    stream->cap = block_size * ((pool ? ttak_thread_pool_live_workers(pool) : 0) + 1);
+    stream->buf = malloc(stream->cap);
+    return stream->buf ? TTAK_IO_SUCCESS : TTAK_IO_ERR_SYS_FAILURE;
+}
+
+void ttak_io_compress_stream_destroy(ttak_io_compress_stream_t *stream) {
+    if (!stream) return;
+    free(stream->buf);
+    stream->buf = NULL;
+    stream->len = 0;
+}
+
+static ttak_io_status_t compress_stream_start(ttak_io_compress_stream_t *stream, ttak_io_chain_t *out,
+                                              uint64_t now) {
+    if (stream->started) return TTAK_IO_SUCCESS;
+    ttak_io_status_t st = frame_put_start(out, stream->block_size, stream->dict, now);
+    if (st != TTAK_IO_SUCCESS) return st;
+    stream->started = true;
+    stream->out_bytes += TTAK_IO_COMPRESS_FRAME_HEADER;
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_compress_stream_write(ttak_io_compress_stream_t *stream, const void *data, size_t len,
+                                               ttak_io_chain_t *out, uint64_t now) {
+    if (!stream || !stream->buf || (!data && len > 0) || !out) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    ttak_io_status_t st = compress_stream_start(stream, out, now);
+    const uint8_t *src = data;
+    while (st == TTAK_IO_SUCCESS && len > 0) {
+        // Whole batches skip the buffer.
+        if (stream->len == 0 && len >= stream->cap) {
+            size_t n = len - len % stream->cap;
+            st = frame_put_blocks(stream->pool, src, n, stream->block_size, stream->dict, out, &stream->out_bytes, now);
+            if (st != TTAK_IO_SUCCESS) break;
+            stream->raw_bytes += n;
+            src += n;
+            len -= n;
+            continue;
+        }
+        size_t n = stream->cap - stream->len < len ? stream->cap - stream->len : len;
+        memcpy(stream->buf + stream->len, src, n);
+        stream->len += n;
+        stream->raw_bytes += n;
+        src += n;
+        len -= n;
+        if (stream->len == stream->cap) st = ttak_io_compress_stream_flush(stream, out, now);
+    }
+    return st;
+}
+
+ttak_io_status_t ttak_io_compress_stream_flush(ttak_io_compress_stream_t *stream, ttak_io_chain_t *out,
+                                               uint64_t now) {
+    if (!stream || !stream->buf || !out) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (stream->len == 0) return TTAK_IO_SUCCESS;
+    ttak_io_status_t st = compress_stream_start(stream, out, now);
+    if (st == TTAK_IO_SUCCESS) {
+        st = frame_put_blocks(stream->pool, stream->buf, stream->len, stream->block_size, stream->dict, out,
+                              &stream->out_bytes, now);
+    }
+    if (st == TTAK_IO_SUCCESS) stream->len = 0;
+    return st;
+}
+
+ttak_io_status_t ttak_io_compress_stream_finish(ttak_io_compress_stream_t *stream, ttak_io_chain_t *out,
+                                                uint64_t now) {
+    if (!stream || !stream->buf || !out) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    ttak_io_status_t st = compress_stream_start(stream, out, now);
+    if (st == TTAK_IO_SUCCESS) st = ttak_io_compress_stream_flush(stream, out, now);
+    if (st == TTAK_IO_SUCCESS) st = frame_put_header(out, 0, 0, now);
+    if (st != TTAK_IO_SUCCESS) return st;
+    stream->out_bytes += TTAK_IO_COMPRESS_BLOCK_HEADER;
+    stream->started = false;
+    return TTAK_IO_SUCCESS;
+}
+
+void ttak_io_decompress_stream_init(ttak_io_decompress_stream_t *stream, const ttak_io_compress_dict_t *dict) {
+    if (!stream) return;
+    memset(stream, 0, sizeof(*stream));
+    stream->dict = dict;
+}
+
+void ttak_io_decompress_stream_destroy(ttak_io_decompress_stream_t *stream) {
+    if (!stream) return;
+    free(stream->scratch);
+    stream->scratch = NULL;
+    stream->scratch_cap = 0;
+}
+
+/* Decodes one block whose header has been consumed and whose @p bytes lead @p in. */
+static ttak_io_status_t decompress_stream_block(ttak_io_decompress_stream_t *stream, ttak_io_chain_t *in,
+                                                uint32_t raw, uint32_t stored, ttak_io_chain_t *out,
+                                                uint64_t now) {
+    uint32_t bytes = stored & ~FRAME_STORED;
+    const uint8_t *payload = in->segs[0].data;
+    if (in->segs[0].len < bytes) {
+        if (stream->scratch_cap < bytes) {
+            uint8_t *grown = realloc(stream->scratch, bytes);
+            if (!grown) return TTAK_IO_ERR_SYS_FAILURE;
+            stream->scratch = grown;
+            stream->scratch_cap = bytes;
+        }
+        ttak_io_chain_copyout(in, 0, stream->scratch, bytes);
+        payload = stream->scratch;
+    }
+    // Decode into a chain of its own so a bad block leaves @p out untouched.
+    ttak_io_chain_t block;
+    ttak_io_chain_init(&block, out->arena);
+    uint8_t *dst = ttak_io_chain_reserve(&block, raw, now);
+    ttak_io_status_t st = dst ? TTAK_IO_SUCCESS : TTAK_IO_ERR_SYS_FAILURE;
+    if (st == TTAK_IO_SUCCESS) {
+        if (stored & FRAME_STORED) {
+            memcpy(dst, payload, raw);
+        } else {
+            size_t got = 0;
+            st = ttak_io_decompress_block(payload, bytes, dst, raw, stream->dict, &got);
+            if (st == TTAK_IO_SUCCESS && got != raw) st = TTAK_IO_ERR_RANGE;
+        }
+    }
+    if (st == TTAK_IO_SUCCESS) st = ttak_io_chain_append_chain(out, &block);
+    ttak_io_chain_destroy(&block);
+    if (st != TTAK_IO_SUCCESS) return st;
+    ttak_io_chain_consume(in, bytes);
+    stream->raw_bytes += raw;
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_decompress_stream_feed(ttak_io_decompress_stream_t *stream, ttak_io_chain_t *in,
+                                                ttak_io_chain_t *out, uint64_t now) {
+    if (!stream || !in || !out) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    uint8_t hdr[TTAK_IO_COMPRESS_FRAME_HEADER];
+    while (!stream->finished) {
+        if (stream->max_block == 0) {
+            if (in->len < TTAK_IO_COMPRESS_FRAME_HEADER) break;
+            ttak_io_chain_copyout(in, 0, hdr, TTAK_IO_COMPRESS_FRAME_HEADER);
+            uint32_t max_block = get_le32(hdr + 4);
+            if (get_le32(hdr) != FRAME_MAGIC || max_block == 0 || max_block > TTAK_IO_COMPRESS_BLOCK_MAX) {
+                return TTAK_IO_ERR_RANGE;
+            }
+            if (get_le32(hdr + 8) != ttak_io_compress_dict_id(stream->dict)) return TTAK_IO_ERR_INVALID_ARGUMENT;
+            stream->max_block = max_block;
+            ttak_io_chain_consume(in, TTAK_IO_COMPRESS_FRAME_HEADER);
+        }
+        if (in->len < TTAK_IO_COMPRESS_BLOCK_HEADER) break;
+        ttak_io_chain_copyout(in, 0, hdr, TTAK_IO_COMPRESS_BLOCK_HEADER);
+        uint32_t raw = get_le32(hdr);
+        uint32_t stored = get_le32(hdr + 4);
+        uint32_t bytes = stored & ~FRAME_STORED;
+        if (raw == 0) {
+            if (stored != 0) return TTAK_IO_ERR_RANGE;
+            ttak_io_chain_consume(in, TTAK_IO_COMPRESS_BLOCK_HEADER);
+            stream->finished = true;
+            break;
+        }
+        if (raw > stream->max_block || ((stored & FRAME_STORED) ? bytes != raw : bytes >= raw)) {
+            return TTAK_IO_ERR_RANGE;
+        }
+        if (in->len < TTAK_IO_COMPRESS_BLOCK_HEADER + (size_t)bytes) break;
+        ttak_io_chain_consume(in, TTAK_IO_COMPRESS_BLOCK_HEADER);
+        ttak_io_status_t st = decompress_stream_block(stream, in, raw, stored, out, now);
+        if (st != TTAK_IO_SUCCESS) return st;
+    }
+    return TTAK_IO_SUCCESS;
+}
@@ -12,9 +12,10 @@
 #include <ttak/async/sched.h>
 #include <ttak/async/task.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/fastpath.h>
+#include <ttak/mem/epoch.h>
 
 #include <errno.h>
-#include <stdio.h>
 #include <string.h>
 
 #ifdef _WIN32
@@ -59,9 +60,61 @@ static int ttak_io_perform_poll(int fd, short events, int timeout_ms, short *rev
     return rc;
 }
 
+/* Writes "iofd-<fd>"; runs once per connection, so it avoids snprintf. */
 static void ttak_io_format_resource_tag(ttak_io_guard_t *guard) {
     if (!guard) return;
-    snprintf(guard->resource_tag, sizeof(guard->resource_tag), "iofd-%d", guard->fd);
+    char digits[12];
+    size_t n = 0;
+    unsigned int v = (guard->fd < 0) ? 0U - (unsigned int)guard->fd : (unsigned int)guard->fd;
+    do {
+        digits[n++] = (char)('0' + v % 10U);
+        v /= 10U;
+    } while (v);
+    char *out = guard->resource_tag;
+    memcpy(out, "iofd-", 5);
+    out += 5;
+    if (guard->fd < 0) *out++ = '-';
+    while (n) *out++ = digits[--n];
+    *out = '\0';
+}
+
+/* A TTL reaching past the clock's range never expires (0). */
+static inline uint64_t ttak_io_guard_deadline(uint64_t now, uint64_t ttl_ns) {
+    return ttl_ns > UINT64_MAX - now ? 0 : now + ttl_ns;
+}
+
+/* Lifetime granted by one refresh: the TTL plus, in coarse mode, the skipped window. */
+static inline uint64_t ttak_io_guard_span(const ttak_io_guard_t *guard) {
+    uint64_t w = guard->coarse_ns;
+    return w > UINT64_MAX - guard->ttl_ns ? UINT64_MAX : guard->ttl_ns + w;
+}
+
+/*
+ * TTL timer: timers never fire early, so a deadline no refresh has moved
+ * since arming has passed. Otherwise follow the deadline forward.
+ */
+static void *ttak_io_guard_ttl_fire(void *arg) {
+    ttak_io_guard_t *guard = arg;
+    ttak_epoch_enter();
+    uint64_t deadline = atomic_load_explicit(&guard->expires_at, memory_order_acquire);
+    ttak_timer_wheel_t *wheel = guard->wheel;
+    if (wheel && !guard->closed) {
+        if (deadline != 0 && deadline <= guard->timer_deadline) {
+            atomic_store_explicit(&guard->expired, true, memory_order_release);
+        } else if (deadline != 0) {
+            guard->timer_deadline = deadline;
+            ttak_timer_arm(wheel, &guard->ttl_timer, deadline);
+        }
+    }
+    ttak_epoch_exit();
+    return NULL;
+}
+
+static void ttak_io_guard_arm_ttl(ttak_io_guard_t *guard) {
+    atomic_store_explicit(&guard->expired, false, memory_order_relaxed);
+    uint64_t deadline = atomic_load_explicit(&guard->expires_at, memory_order_relaxed);
+    guard->timer_deadline = deadline;
+    if (deadline != 0) ttak_timer_arm(guard->wheel, &guard->ttl_timer, deadline);
 }
 
 ttak_io_status_t ttak_io_guard_init(ttak_io_guard_t *guard,
@@ -77,7 +130,7 @@ ttak_io_status_t ttak_io_guard_init(ttak_io_guard_t *guard,
     guard->fd = fd;
     guard->owner = owner;
     guard->ttl_ns = ttl_ns;
-    guard->expires_at = now + ttl_ns;
+    atomic_store_explicit(&guard->expires_at, ttak_io_guard_deadline(now, ttl_ns), memory_order_relaxed);
     guard->last_used = now;
     guard->closed = false;
     ttak_io_format_resource_tag(guard);
@@ -89,15 +142,50 @@ ttak_io_status_t ttak_io_guard_init(ttak_io_guard_t *guard,
     return TTAK_IO_SUCCESS;
 }
 
+ttak_io_status_t ttak_io_guard_rebind(ttak_io_guard_t *guard,
+                                      int fd,
+                                      ttak_owner_t *owner,
+                                      uint64_t ttl_ns,
+                                      uint64_t now) {
+    if (!guard || fd < 0 || ttl_ns == 0) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+
+    char prev_tag[sizeof(guard->resource_tag)];
+    memcpy(prev_tag, guard->resource_tag, sizeof(prev_tag));
+    bool same_owner = (guard->owner == owner);
+
+    guard->fd = fd;
+    guard->owner = owner;
+    guard->ttl_ns = ttl_ns;
+    atomic_store_explicit(&guard->expires_at, ttak_io_guard_deadline(now, ttak_io_guard_span(guard)),
+                          memory_order_relaxed);
+    guard->last_used = now;
+    guard->closed = false;
+    ttak_io_format_resource_tag(guard);
+    if (guard->wheel) ttak_io_guard_arm_ttl(guard);
+
+    if (owner && !(same_owner && strcmp(prev_tag, guard->resource_tag) == 0)) {
+        ttak_owner_register_resource(owner, guard->resource_tag, guard);
+    }
+
+    return TTAK_IO_SUCCESS;
+}
+
 ttak_io_status_t ttak_io_guard_refresh(ttak_io_guard_t *guard, uint64_t now) {
     if (!guard || guard->fd < 0) {
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
-    if (guard->closed) {
+    if (guard->closed || (guard->wheel && atomic_load_explicit(&guard->expired, memory_order_acquire))) {
         return TTAK_IO_ERR_EXPIRED_GUARD;
     }
+    /* Coarse mode: reads only until the window has passed. */
+    if (guard->coarse_ns && now >= guard->last_used && now - guard->last_used < guard->coarse_ns) {
+        return TTAK_IO_SUCCESS;
+    }
     guard->last_used = now;
-    guard->expires_at = now + guard->ttl_ns;
+    atomic_store_explicit(&guard->expires_at, ttak_io_guard_deadline(now, ttak_io_guard_span(guard)),
+                          memory_order_release);
     return TTAK_IO_SUCCESS;
 }
 
@@ -109,7 +197,8 @@ ttak_io_status_t ttak_io_guard_close(ttak_io_guard_t *guard, uint64_t now) {
     guard->fd = -1;
     guard->closed = true;
     guard->last_used = now;
-    guard->expires_at = now;
+    atomic_store_explicit(&guard->expires_at, now, memory_order_relaxed);
+    if (guard->wheel) ttak_timer_cancel(guard->wheel, &guard->ttl_timer);
     return TTAK_IO_SUCCESS;
 }
 
@@ -117,10 +206,39 @@ bool ttak_io_guard_valid(const ttak_io_guard_t *guard, uint64_t now) {
     if (!guard) return false;
     if (guard->closed) return false;
     if (guard->fd < 0) return false;
-    if (guard->expires_at != 0 && now > guard->expires_at) return false;
+    if (guard->wheel) return !atomic_load_explicit(&guard->expired, memory_order_acquire);
+    uint64_t expires_at = atomic_load_explicit(&guard->expires_at, memory_order_relaxed);
+    if (expires_at != 0 && now > expires_at) return false;
     return true;
 }
 
+ttak_io_status_t ttak_io_guard_set_coarse(ttak_io_guard_t *guard,
+                                          uint64_t window_ns,
+                                          ttak_timer_wheel_t *wheel) {
+    if (!guard || guard->fd < 0 || guard->closed) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    if (guard->wheel) ttak_timer_cancel(guard->wheel, &guard->ttl_timer);
+    guard->coarse_ns = window_ns;
+    guard->wheel = wheel;
+    atomic_store_explicit(&guard->expires_at,
+                          ttak_io_guard_deadline(guard->last_used, ttak_io_guard_span(guard)),
+                          memory_order_relaxed);
+    if (wheel) {
+        ttak_timer_init(&guard->ttl_timer, ttak_io_guard_ttl_fire, guard);
+        ttak_io_guard_arm_ttl(guard);
+    }
+    return TTAK_IO_SUCCESS;
+}
+
+uint64_t ttak_io_guard_affinity(const ttak_io_guard_t *guard) {
+    uint64_t h = (uint64_t)(uintptr_t)guard;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h ? h : 1;
+}
+
 static ttak_detachable_context_t *ttak_io_select_arena(void) {
     return ttak_detachable_context_default();
 }
@@ -171,7 +289,7 @@ ttak_io_status_t ttak_io_buffer_sync_in(ttak_io_buffer_t *buffer, uint64_t now)
     if (!safe && buffer->user_ptr) {
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
-    memcpy(buffer->staging.data, safe ? safe : buffer->user_ptr, buffer->len);
+    ttak_mem_stream_copy(buffer->staging.data, safe ? safe : buffer->user_ptr, buffer->len);
     return TTAK_IO_SUCCESS;
 }
 
@@ -188,7 +306,7 @@ ttak_io_status_t ttak_io_buffer_sync_out(ttak_io_buffer_t *buffer, size_t bytes,
     if (!safe && buffer->user_ptr) {
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
-    memcpy(safe ? safe : buffer->user_ptr, buffer->staging.data, bytes);
+    ttak_mem_stream_copy(safe ? safe : buffer->user_ptr, buffer->staging.data, bytes);
     return TTAK_IO_SUCCESS;
 }
 
@@ -279,6 +397,7 @@ ttak_io_status_t ttak_io_poll_wait(const ttak_io_guard_t *guard,
         return TTAK_IO_ERR_SYS_FAILURE;
     }
     ttak_task_set_domain(task, TTAK_TASK_DOMAIN_IO);
+    ttak_task_set_hash(task, ttak_io_guard_affinity(guard));
     ttak_async_schedule(task, now, 0);
     return TTAK_IO_SUCCESS;
 }
@@ -0,0 +1,259 @@
+/**
+ * @file mmap.c
+ * @brief Read-only file mappings guarded like descriptors.
+ *
+ * The mapping is reference counted: the creator holds one reference and
+ * each slice or prefetch in flight holds another, so munmap() only runs
+ * once nobody can still be reading. The guard decides whether new slices
+ * may be taken; it does not revoke existing ones.
+ */
+
+#include <ttak/io/mmap.h>
+
+#include <ttak/async/sched.h>
+#include <ttak/async/task.h>
+#include <ttak/mem/mem.h>
+
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+static size_t ttak_io_mmap_round_up(size_t v, size_t align) {
+    return (v + align - 1U) & ~(align - 1U);
+}
+
+/* Page-aligned span covering [offset, offset + len); len 0 means to the end. */
+static bool ttak_io_mmap_span(const ttak_io_mmap_t *map, size_t offset, size_t len,
+                              uint8_t **start, size_t *span) {
+    if (offset > map->len || (len && len > map->len - offset)) return false;
+    if (!len) len = map->len - offset;
+    size_t first = offset & ~(map->page_size - 1U);
+    *start = (uint8_t *)map->data + first;
+    *span = ttak_io_mmap_round_up(offset + len, map->page_size) - first;
+    return true;
+}
+
+/*
+ * Maps @p len bytes of @p fd at a TTAK_IO_MMAP_HUGE_ALIGN boundary: reserve
+ * an oversized window, map the file over its aligned part, trim the rest.
+ */
+static void *ttak_io_mmap_map_aligned(int fd, size_t len, int mflags) {
+    size_t reserve = len + TTAK_IO_MMAP_HUGE_ALIGN;
+    uint8_t *window = mmap(NULL, reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (window == MAP_FAILED) return MAP_FAILED;
+    uint8_t *aligned = (uint8_t *)ttak_io_mmap_round_up((size_t)(uintptr_t)window, TTAK_IO_MMAP_HUGE_ALIGN);
+    void *p = mmap(aligned, len, PROT_READ, mflags | MAP_FIXED, fd, 0);
+    if (p == MAP_FAILED) {
+        munmap(window, reserve);
+        return MAP_FAILED;
+    }
+    if (aligned > window) munmap(window, (size_t)(aligned - window));
+    uint8_t *tail = aligned + len;
+    if (tail < window + reserve) munmap(tail, (size_t)(window + reserve - tail));
+    return p;
+}
+
+static int ttak_io_mmap_advice_flag(ttak_io_mmap_advice_t advice) {
+    switch (advice) {
+        case TTAK_IO_MMAP_SEQUENTIAL:
+            return MADV_SEQUENTIAL;
+        case TTAK_IO_MMAP_RANDOM:
+            return MADV_RANDOM;
+        case TTAK_IO_MMAP_NORMAL:
+        default:
+            return MADV_NORMAL;
+    }
+}
+#endif
+
+ttak_io_mmap_t *ttak_io_mmap_create(int fd, ttak_owner_t *owner, uint64_t ttl_ns, uint32_t flags, uint64_t now) {
+#ifndef _WIN32
+    if (fd < 0) return NULL;
+    struct stat st;
+    ttak_io_mmap_t *map = NULL;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size > SIZE_MAX) goto fail;
+    map = calloc(1, sizeof(*map));
+    if (!map) goto fail;
+
+    size_t len = (size_t)st.st_size;
+    long page = sysconf(_SC_PAGESIZE);
+    map->page_size = page > 0 ? (size_t)page : 4096U;
+    size_t map_len = ttak_io_mmap_round_up(len, map->page_size);
+    int mflags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (flags & TTAK_IO_MMAP_POPULATE) mflags |= MAP_POPULATE;
+#endif
+    void *p = MAP_FAILED;
+    if ((flags & TTAK_IO_MMAP_HUGE) && len >= TTAK_IO_MMAP_HUGE_ALIGN) {
+        p = ttak_io_mmap_map_aligned(fd, map_len, mflags);
+    }
+    if (p == MAP_FAILED) p = mmap(NULL, map_len, PROT_READ, mflags, fd, 0);
+    if (p == MAP_FAILED) goto fail;
+#ifdef MADV_HUGEPAGE
+    if (flags & TTAK_IO_MMAP_HUGE) (void)madvise(p, map_len, MADV_HUGEPAGE);
+#endif
+
+    if (ttak_io_guard_init(&map->guard, fd, owner, ttl_ns, now) != TTAK_IO_SUCCESS) {
+        munmap(p, map_len);
+        goto fail;
+    }
+    map->data = p;
+    map->len = len;
+    map->flags = flags;
+    map->advice = TTAK_IO_MMAP_NORMAL;
+    atomic_init(&map->refs, 1U);
+    return map;
+
+fail:
+    free(map);
+    close(fd);
+    return NULL;
+#else
+    (void)fd;
+    (void)owner;
+    (void)ttl_ns;
+    (void)flags;
+    (void)now;
+    return NULL;
+#endif
+}
+
+void ttak_io_mmap_release(ttak_io_mmap_t *map) {
+    if (!map) return;
+    if (atomic_fetch_sub_explicit(&map->refs, 1U, memory_order_acq_rel) != 1U) return;
+#ifndef _WIN32
+    munmap((void *)map->data, ttak_io_mmap_round_up(map->len, map->page_size));
+#endif
+    free(map);
+}
+
+void ttak_io_mmap_close(ttak_io_mmap_t *map, uint64_t now) {
+    if (!map) return;
+    ttak_io_guard_close(&map->guard, now);
+    ttak_io_mmap_release(map);
+}
+
+ttak_io_status_t ttak_io_mmap_retain(ttak_io_mmap_t *map,
+                                     size_t offset,
+                                     size_t len,
+                                     const uint8_t **data,
+                                     uint64_t now) {
+    if (!map || !data) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (!ttak_io_guard_valid(&map->guard, now)) return TTAK_IO_ERR_EXPIRED_GUARD;
+    if (offset > map->len || len > map->len - offset) return TTAK_IO_ERR_RANGE;
+    ttak_io_status_t status = ttak_io_guard_refresh(&map->guard, now);
+    if (status != TTAK_IO_SUCCESS) return status;
+    atomic_fetch_add_explicit(&map->refs, 1U, memory_order_relaxed);
+    *data = map->data + offset;
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_mmap_advise(ttak_io_mmap_t *map,
+                                     size_t offset,
+                                     size_t len,
+                                     ttak_io_mmap_advice_t advice,
+                                     uint64_t now) {
+    if (!map) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (!ttak_io_guard_valid(&map->guard, now)) return TTAK_IO_ERR_EXPIRED_GUARD;
+#ifndef _WIN32
+    uint8_t *start;
+    size_t span;
+    if (!ttak_io_mmap_span(map, offset, len, &start, &span)) return TTAK_IO_ERR_RANGE;
+    if (madvise(start, span, ttak_io_mmap_advice_flag(advice)) != 0) return TTAK_IO_ERR_SYS_FAILURE;
+    if (offset == 0 && (len == 0 || len == map->len)) map->advice = advice;
+    return TTAK_IO_SUCCESS;
+#else
+    (void)offset;
+    (void)len;
+    (void)advice;
+    return TTAK_IO_ERR_SYS_FAILURE;
+#endif
+}
+
+typedef struct ttak_io_mmap_prefetch_ctx {
+    ttak_io_mmap_t *map;
+    uint8_t *start;
+    size_t span;
+    size_t bytes;
+    ttak_io_async_result_cb cb;
+    void *user;
+} ttak_io_mmap_prefetch_ctx_t;
+
+static void *ttak_io_mmap_prefetch_worker(void *arg) {
+    ttak_io_mmap_prefetch_ctx_t *ctx = arg;
+    ttak_io_status_t status = TTAK_IO_SUCCESS;
+#ifndef _WIN32
+    /* WILLNEED starts the disk reads; touching the pages then maps them. */
+    (void)madvise(ctx->start, ctx->span, MADV_WILLNEED);
+#ifdef MADV_POPULATE_READ
+    if (madvise(ctx->start, ctx->span, MADV_POPULATE_READ) != 0)
+#endif
+    {
+        const size_t page = ctx->map->page_size;
+        uint8_t sink = 0;
+        for (size_t off = 0; off < ctx->span; off += page) {
+            sink ^= *(volatile const uint8_t *)(ctx->start + off);
+        }
+        (void)sink;
+    }
+#else
+    status = TTAK_IO_ERR_SYS_FAILURE;
+#endif
+    if (ctx->cb) ctx->cb(status, status == TTAK_IO_SUCCESS ? ctx->bytes : 0U, ctx->user);
+    ttak_io_mmap_release(ctx->map);
+    ttak_mem_free(ctx);
+    return NULL;
+}
+
+ttak_io_status_t ttak_io_mmap_prefetch(ttak_io_mmap_t *map,
+                                       size_t offset,
+                                       size_t len,
+                                       ttak_io_async_result_cb cb,
+                                       void *user,
+                                       uint64_t now) {
+    if (!map) return TTAK_IO_ERR_INVALID_ARGUMENT;
+#ifndef _WIN32
+    uint8_t *start;
+    size_t span;
+    if (!ttak_io_mmap_span(map, offset, len, &start, &span)) return TTAK_IO_ERR_RANGE;
+    const uint8_t *data;
+    ttak_io_status_t status = ttak_io_mmap_retain(map, offset, 0, &data, now);
+    if (status != TTAK_IO_SUCCESS) return status;
+
+    ttak_io_mmap_prefetch_ctx_t *ctx = ttak_mem_alloc_raw(sizeof(*ctx), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!ctx) {
+        ttak_io_mmap_release(map);
+        return TTAK_IO_ERR_SYS_FAILURE;
+    }
+    ctx->map = map;
+    ctx->start = start;
+    ctx->span = span;
+    ctx->bytes = len ? len : map->len - offset;
+    ctx->cb = cb;
+    ctx->user = user;
+
+    ttak_task_t *task = ttak_task_create(ttak_io_mmap_prefetch_worker, ctx, NULL, now);
+    if (!task) {
+        ttak_mem_free(ctx);
+        ttak_io_mmap_release(map);
+        return TTAK_IO_ERR_SYS_FAILURE;
+    }
+    ttak_task_set_domain(task, TTAK_TASK_DOMAIN_IO);
+    ttak_task_set_hash(task, ttak_io_guard_affinity(&map->guard));
+    ttak_async_schedule(task, now, 0);
+    ttak_task_destroy(task, now);
+    return TTAK_IO_SUCCESS;
+#else
+    (void)offset;
+    (void)len;
+    (void)cb;
+    (void)user;
+    (void)now;
+    return TTAK_IO_ERR_SYS_FAILURE;
+#endif
+}
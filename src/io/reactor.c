@@ -0,0 +1,451 @@
+/**
+ * @file reactor.c
+ * @brief Per-thread epoll/kqueue loops dispatching readiness in batches.
+ *
+ * Watches are reference counted: one reference for the registration and one
+ * for every batch entry still waiting to run. Removing a watch deletes its
+ * fd from the kernel queue at once, so the fd may be closed and reused
+ * right away, but only the watch's own loop thread drops the registration,
+ * after finishing the events it had already collected, so no event can
+ * surface for a freed watch.
+ */
+
+#include <ttak/io/reactor.h>
+#include <ttak/priority/nice.h>
+#include <ttak/sync/sync.h>
+#include <ttak/log/trace.h>
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#  define TTAK_REACTOR_EPOLL 1
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+#  define TTAK_REACTOR_KQUEUE 1
+#endif
+
+#if defined(TTAK_REACTOR_EPOLL) || defined(TTAK_REACTOR_KQUEUE)
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(TTAK_REACTOR_EPOLL)
+#  include <sys/epoll.h>
+typedef struct epoll_event reactor_event_t;
+#else
+#  include <sys/event.h>
+#  include <sys/time.h>
+typedef struct kevent reactor_event_t;
+#endif
+
+typedef struct reactor_loop reactor_loop_t;
+
+struct ttak_io_watch {
+    ttak_io_reactor_t           *reactor;
+    reactor_loop_t              *loop;
+    ttak_io_guard_t             *guard;
+    int                         fd;
+    ttak_io_poll_cb             cb;
+    void                        *user;
+    ttak_io_reactor_release_cb  release;
+    _Atomic unsigned            refs;
+    _Atomic bool                removed;
+    bool                        armed;      /**< Known to the kernel queue. */
+    struct ttak_io_watch        *prev;      /**< Loop's live list; guarded by the loop lock. */
+    struct ttak_io_watch        *next;
+    struct ttak_io_watch        *next_dead; /**< Loop's removal list; guarded by the loop lock. */
+};
+
+struct reactor_loop {
+    ttak_io_reactor_t   *reactor;
+    int                 kfd;        /**< epoll or kqueue descriptor. */
+    int                 wake[2];    /**< Self-pipe; its read end is registered with a NULL watch. */
+    pthread_t           thread;
+    bool                started;
+    ttak_mutex_t        lock;
+    ttak_io_watch_t     *live;
+    ttak_io_watch_t     *dead;
+};
+
+struct ttak_io_reactor {
+    ttak_thread_pool_t  *pool;
+    size_t              nloops;
+    _Atomic bool        stop;
+    _Atomic size_t      watches;
+    reactor_loop_t      loops[];
+};
+
+typedef struct reactor_entry {
+    ttak_io_watch_t *watch;
+    short           revents;
+    bool            final;      /**< Expired guard: deliver although removed. */
+} reactor_entry_t;
+
+typedef struct reactor_batch {
+    size_t          count;
+    reactor_entry_t entries[TTAK_IO_REACTOR_BATCH];
+} reactor_batch_t;
+
+static void watch_unref(ttak_io_watch_t *w) {
+    if (atomic_fetch_sub_explicit(&w->refs, 1, memory_order_acq_rel) == 1) {
+        if (w->release) w->release(w->user);
+        free(w);
+    }
+}
+
+static void reactor_run_entries(reactor_batch_t *b) {
+    for (size_t i = 0; i < b->count; i++) {
+        reactor_entry_t *e = &b->entries[i];
+        if (e->final || !atomic_load_explicit(&e->watch->removed, memory_order_acquire)) {
+            e->watch->cb(e->watch->fd, e->revents, e->watch->user);
+        }
+        watch_unref(e->watch);
+    }
+}
+
+static void *reactor_run_batch(void *arg) {
+    reactor_run_entries(arg);
+    free(arg);
+    return NULL;
+}
+
+/* ---- Kernel queue glue ---- */
+
+static int kq_create(void) {
+#if defined(TTAK_REACTOR_EPOLL)
+    return epoll_create1(EPOLL_CLOEXEC);
+#else
+    return kqueue();
+#endif
+}
+
+/* (Re)arms @p fd for @p events, edge-triggered; @p add on first registration. */
+static int kq_arm(int kfd, int fd, short events, void *udata, bool add) {
+#if defined(TTAK_REACTOR_EPOLL)
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLET | EPOLLRDHUP;
+    if (events & POLLIN) ev.events |= EPOLLIN;
+    if (events & POLLOUT) ev.events |= EPOLLOUT;
+    ev.data.ptr = udata;
+    return epoll_ctl(kfd, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev);
+#else
+    (void)add;
+    struct kevent kev[2];
+    EV_SET(&kev[0], fd, EVFILT_READ, EV_ADD | EV_CLEAR | ((events & POLLIN) ? EV_ENABLE : EV_DISABLE), 0, 0, udata);
+    EV_SET(&kev[1], fd, EVFILT_WRITE, EV_ADD | EV_CLEAR | ((events & POLLOUT) ? EV_ENABLE : EV_DISABLE), 0, 0, udata);
+    return kevent(kfd, kev, 2, NULL, 0, NULL);
+#endif
+}
+
+static void kq_del(int kfd, int fd) {
+#if defined(TTAK_REACTOR_EPOLL)
+    epoll_ctl(kfd, EPOLL_CTL_DEL, fd, NULL);
+#else
+    struct kevent kev[2];
+    EV_SET(&kev[0], fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+    EV_SET(&kev[1], fd, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+    kevent(kfd, kev, 2, NULL, 0, NULL);
+#endif
+}
+
+static int kq_wait(int kfd, reactor_event_t *evs, int n) {
+#if defined(TTAK_REACTOR_EPOLL)
+    return epoll_wait(kfd, evs, n, -1);
+#else
+    return kevent(kfd, NULL, 0, evs, n, NULL);
+#endif
+}
+
+static void *kq_udata(const reactor_event_t *ev) {
+#if defined(TTAK_REACTOR_EPOLL)
+    return ev->data.ptr;
+#else
+    return (void *)ev->udata;
+#endif
+}
+
+static short kq_revents(const reactor_event_t *ev) {
+    short r = 0;
+#if defined(TTAK_REACTOR_EPOLL)
+    if (ev->events & EPOLLIN) r |= POLLIN;
+    if (ev->events & EPOLLOUT) r |= POLLOUT;
+    if (ev->events & (EPOLLHUP | EPOLLRDHUP)) r |= POLLHUP;
+    if (ev->events & EPOLLERR) r |= POLLERR;
+#else
+    if (ev->filter == EVFILT_READ) r |= POLLIN;
+    if (ev->filter == EVFILT_WRITE) r |= POLLOUT;
+    if (ev->flags & EV_EOF) r |= POLLHUP;
+    if (ev->flags & EV_ERROR) r |= POLLERR;
+#endif
+    return r;
+}
+
+/* ---- Loops ---- */
+
+static void loop_wake(reactor_loop_t *loop) {
+    char c = 0;
+    ssize_t rc;
+    do {
+        rc = write(loop->wake[1], &c, 1);
+    } while (rc < 0 && errno == EINTR);
+}
+
+/* Unarms @p w and queues it for its loop to drop; the first caller wins. */
+static bool loop_retire(reactor_loop_t *loop, ttak_io_watch_t *w) {
+    if (atomic_exchange_explicit(&w->removed, true, memory_order_acq_rel)) return false;
+    if (w->armed) kq_del(loop->kfd, w->fd);
+    ttak_mutex_lock(&loop->lock);
+    w->next_dead = loop->dead;
+    loop->dead = w;
+    ttak_mutex_unlock(&loop->lock);
+    return true;
+}
+
+/* Loop thread only: drops the registrations of retired watches. */
+static void loop_reap(reactor_loop_t *loop) {
+    ttak_mutex_lock(&loop->lock);
+    ttak_io_watch_t *dead = loop->dead;
+    loop->dead = NULL;
+    for (ttak_io_watch_t *w = dead; w; w = w->next_dead) {
+        if (w->prev) w->prev->next = w->next;
+        else loop->live = w->next;
+        if (w->next) w->next->prev = w->prev;
+    }
+    ttak_mutex_unlock(&loop->lock);
+
+    while (dead) {
+        ttak_io_watch_t *next = dead->next_dead;
+        atomic_fetch_sub_explicit(&loop->reactor->watches, 1, memory_order_relaxed);
+        watch_unref(dead);
+        dead = next;
+    }
+}
+
+static void loop_drain_wake(reactor_loop_t *loop) {
+    char buf[64];
+    while (read(loop->wake[0], buf, sizeof(buf)) > 0) {}
+}
+
+static void *loop_main(void *arg) {
+    reactor_loop_t *loop = arg;
+    ttak_io_reactor_t *r = loop->reactor;
+    reactor_event_t evs[TTAK_IO_REACTOR_BATCH];
+
+    while (!atomic_load_explicit(&r->stop, memory_order_acquire)) {
+        int n = kq_wait(loop->kfd, evs, TTAK_IO_REACTOR_BATCH);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        uint64_t now = ttak_get_tick_count();
+        reactor_batch_t *batch = NULL, local;
+        for (int i = 0; i < n; i++) {
+            ttak_io_watch_t *w = kq_udata(&evs[i]);
+            if (!w) {
+                loop_drain_wake(loop);
+                continue;
+            }
+            if (atomic_load_explicit(&w->removed, memory_order_acquire)) continue;
+            if (!batch) {
+                // Out of memory: run this wakeup inline rather than lose edges.
+                batch = malloc(sizeof(*batch));
+                if (!batch) batch = &local;
+                batch->count = 0;
+            }
+
+            reactor_entry_t *e = &batch->entries[batch->count++];
+            e->watch = w;
+            e->revents = kq_revents(&evs[i]);
+            e->final = false;
+            if (!ttak_io_guard_valid(w->guard, now)) {
+                e->revents = POLLHUP | POLLERR;
+                e->final = loop_retire(loop, w);
+            }
+            TTAK_TRACE(TTAK_TRACE_IO_READY, (int64_t)w->fd, (uint32_t)e->revents);
+            atomic_fetch_add_explicit(&w->refs, 1, memory_order_relaxed);
+        }
+
+        if (batch == &local) {
+            reactor_run_entries(batch);
+        } else if (batch) {
+            if (!r->pool || !ttak_thread_pool_submit_detached(r->pool, reactor_run_batch, batch,
+                                                              __TT_SCHED_NORMAL__, now)) {
+                reactor_run_batch(batch);
+            }
+        }
+        loop_reap(loop);
+    }
+    return NULL;
+}
+
+static void loop_close(reactor_loop_t *loop) {
+    if (loop->kfd >= 0) close(loop->kfd);
+    if (loop->wake[0] >= 0) close(loop->wake[0]);
+    if (loop->wake[1] >= 0) close(loop->wake[1]);
+    ttak_mutex_destroy(&loop->lock);
+}
+
+static bool loop_open(reactor_loop_t *loop, ttak_io_reactor_t *r) {
+    loop->reactor = r;
+    loop->kfd = -1;
+    loop->wake[0] = loop->wake[1] = -1;
+    loop->live = loop->dead = NULL;
+    loop->started = false;
+    ttak_mutex_init(&loop->lock);
+
+    if ((loop->kfd = kq_create()) < 0 || pipe(loop->wake) != 0) return false;
+    for (int i = 0; i < 2; i++) {
+        fcntl(loop->wake[i], F_SETFL, fcntl(loop->wake[i], F_GETFL) | O_NONBLOCK);
+        fcntl(loop->wake[i], F_SETFD, FD_CLOEXEC);
+    }
+    return kq_arm(loop->kfd, loop->wake[0], POLLIN, NULL, true) == 0;
+}
+
+ttak_io_reactor_t *ttak_io_reactor_create(size_t loops, ttak_thread_pool_t *pool) {
+    if (loops == 0) loops = 1;
+    if (loops > TTAK_IO_REACTOR_MAX_LOOPS) loops = TTAK_IO_REACTOR_MAX_LOOPS;
+
+    ttak_io_reactor_t *r = calloc(1, sizeof(*r) + loops * sizeof(reactor_loop_t));
+    if (!r) return NULL;
+    r->pool = pool;
+    atomic_init(&r->stop, false);
+    atomic_init(&r->watches, 0);
+
+    for (size_t i = 0; i < loops; i++) {
+        bool ok = loop_open(&r->loops[i], r);
+        r->nloops = i + 1;
+        if (ok) ok = pthread_create(&r->loops[i].thread, NULL, loop_main, &r->loops[i]) == 0;
+        if (!ok) {
+            ttak_io_reactor_destroy(r);
+            return NULL;
+        }
+        r->loops[i].started = true;
+    }
+    return r;
+}
+
+void ttak_io_reactor_destroy(ttak_io_reactor_t *reactor) {
+    if (!reactor) return;
+    atomic_store_explicit(&reactor->stop, true, memory_order_release);
+    for (size_t i = 0; i < reactor->nloops; i++) {
+        if (reactor->loops[i].started) loop_wake(&reactor->loops[i]);
+    }
+    for (size_t i = 0; i < reactor->nloops; i++) {
+        reactor_loop_t *loop = &reactor->loops[i];
+        if (loop->started) pthread_join(loop->thread, NULL);
+        // The thread is gone, so this thread may reap on its behalf.
+        for (ttak_io_watch_t *w = loop->live; w; w = w->next) loop_retire(loop, w);
+        if (loop->kfd >= 0) loop_reap(loop);
+        loop_close(loop);
+    }
+    free(reactor);
+}
+
+ttak_io_status_t ttak_io_reactor_add(ttak_io_reactor_t *reactor,
+                                     ttak_io_guard_t *guard,
+                                     short events,
+                                     ttak_io_poll_cb cb,
+                                     void *user,
+                                     ttak_io_reactor_release_cb release,
+                                     ttak_io_watch_t **out,
+                                     uint64_t now) {
+    if (!reactor || !guard || !cb) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (!ttak_io_guard_valid(guard, now)) return TTAK_IO_ERR_EXPIRED_GUARD;
+
+    ttak_io_watch_t *w = calloc(1, sizeof(*w));
+    if (!w) return TTAK_IO_ERR_SYS_FAILURE;
+    w->reactor = reactor;
+    w->loop = &reactor->loops[(size_t)guard->fd % reactor->nloops];
+    w->guard = guard;
+    w->fd = guard->fd;
+    w->cb = cb;
+    w->user = user;
+    w->release = release;
+    atomic_init(&w->refs, 1);
+    atomic_init(&w->removed, false);
+
+    // Linked before arming, so an immediate event finds it live.
+    reactor_loop_t *loop = w->loop;
+    ttak_mutex_lock(&loop->lock);
+    w->next = loop->live;
+    if (loop->live) loop->live->prev = w;
+    loop->live = w;
+    ttak_mutex_unlock(&loop->lock);
+    atomic_fetch_add_explicit(&reactor->watches, 1, memory_order_relaxed);
+
+    w->armed = true;
+    if (kq_arm(loop->kfd, w->fd, events, w, true) != 0) {
+        // Never armed, so it must not delete a registration the fd already has.
+        w->armed = false;
+        w->release = NULL;
+        loop_retire(loop, w);
+        loop_wake(loop);
+        return TTAK_IO_ERR_SYS_FAILURE;
+    }
+    if (out) *out = w;
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_reactor_modify(ttak_io_watch_t *watch, short events) {
+    if (!watch || atomic_load_explicit(&watch->removed, memory_order_acquire)) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    return kq_arm(watch->loop->kfd, watch->fd, events, watch, false) == 0 ? TTAK_IO_SUCCESS
+                                                                       : TTAK_IO_ERR_SYS_FAILURE;
+}
+
+void ttak_io_reactor_remove(ttak_io_watch_t *watch) {
+    if (!watch) return;
+    if (loop_retire(watch->loop, watch)) loop_wake(watch->loop);
+}
+
+size_t ttak_io_reactor_watch_count(ttak_io_reactor_t *reactor) {
+    return reactor ? atomic_load_explicit(&reactor->watches, memory_order_relaxed) : 0;
+}
+
+#else /* No epoll or kqueue. */
+
+ttak_io_reactor_t *ttak_io_reactor_create(size_t loops, ttak_thread_pool_t *pool) {
+    (void)loops;
+    (void)pool;
+    return NULL;
+}
+
+void ttak_io_reactor_destroy(ttak_io_reactor_t *reactor) {
+    (void)reactor;
+}
+
+ttak_io_status_t ttak_io_reactor_add(ttak_io_reactor_t *reactor,
+                                     ttak_io_guard_t *guard,
+                                     short events,
+                                     ttak_io_poll_cb cb,
+                                     void *user,
+                                     ttak_io_reactor_release_cb release,
+                                     ttak_io_watch_t **out,
+                                     uint64_t now) {
+    (void)reactor; (void)guard; (void)events; (void)cb; (void)user; (void)release; (void)out; (void)now;
+    return TTAK_IO_ERR_INVALID_ARGUMENT;
+}
+
+ttak_io_status_t ttak_io_reactor_modify(ttak_io_watch_t *watch, short events) {
+    (void)watch;
+    (void)events;
+    return TTAK_IO_ERR_INVALID_ARGUMENT;
+}
+
+void ttak_io_reactor_remove(ttak_io_watch_t *watch) {
+    (void)watch;
+}
+
+size_t ttak_io_reactor_watch_count(ttak_io_reactor_t *reactor) {
+    (void)reactor;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,767 @@
+/**
+ * @file uring.c
+ * @brief io_uring rings driven through the raw syscalls.
+ *
+ * Operations live in a fixed table sized to the completion queue and are
+ * named in a submission entry's user_data by index + 1; user_data 0 marks
+ * entries whose completions are ignored (linked timeouts, cancels). One
+ * mutex covers the submission queue, the operation table, the file table
+ * and the provided-buffer ring. Completions are copied out of the queue
+ * under it and their callbacks run after it is dropped, so a callback may
+ * queue further operations or recycle buffers.
+ */
+
+#include <ttak/io/uring.h>
+
+#include <ttak/mem/detachable.h>
+#include <ttak/sync/sync.h>
+#include <ttak/log/trace.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#    include <linux/io_uring.h>
+#    if defined(IORING_RECV_MULTISHOT)
+#      define TTAK_IO_URING_SUPPORTED 1
+#    endif
+#  endif
+#endif
+
+#if defined(TTAK_IO_URING_SUPPORTED)
+
+#include <ttak/ht/map.h>
+#include <ttak/timing/timing.h>
+
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+enum {
+    URING_OP_READ,
+    URING_OP_WRITE,
+    URING_OP_RECV
+};
+
+typedef struct uring_op {
+    uint8_t                     kind;
+    ttak_io_guard_t             *guard;
+    ttak_io_async_result_cb     cb;
+    ttak_io_uring_recv_cb       recv_cb;
+    void                        *user;
+    struct __kernel_timespec    ts;         /**< Linked timeout; read by the kernel until completion. */
+    uint32_t                    next_free;  /**< Free list link, index + 1. */
+} uring_op_t;
+
+/* A completion copied out of the queue, run after the lock is dropped. */
+typedef struct uring_done {
+    uint8_t                     kind;
+    bool                        more;
+    bool                        has_buf;
+    int                         res;
+    unsigned                    bid;
+    ttak_io_guard_t             *guard;
+    ttak_io_async_result_cb     cb;
+    ttak_io_uring_recv_cb       recv_cb;
+    void                        *user;
+} uring_done_t;
+
+struct ttak_io_uring {
+    int                     fd;
+    ttak_mutex_t            lock;
+
+    void                    *sq_map;
+    size_t                  sq_map_len;
+    void                    *cq_map;        /**< Same as sq_map with IORING_FEAT_SINGLE_MMAP. */
+    size_t                  cq_map_len;
+    _Atomic unsigned        *sq_head;
+    _Atomic unsigned        *sq_tail;
+    _Atomic unsigned        *sq_flags;
+    unsigned                sq_mask;
+    unsigned                sq_entries;
+    unsigned                sq_local_tail;  /**< Entries filled, published to sq_tail on submit. */
+    struct io_uring_sqe     *sqes;
+    size_t                  sqes_len;
+    _Atomic unsigned        *cq_head;
+    _Atomic unsigned        *cq_tail;
+    unsigned                cq_mask;
+    struct io_uring_cqe     *cqes;
+
+    uring_op_t              *ops;
+    unsigned                nops;
+    uint32_t                free_op;        /**< Free list head, index + 1. */
+
+    ttak_detachable_allocation_t arena;     /**< buf_count * buf_size bytes. */
+    bool                    fixed_buf;      /**< Arena registered as fixed buffer 0. */
+    unsigned                buf_count;
+    size_t                  buf_size;
+    struct io_uring_buf_ring *br;           /**< Provided buffers, group 0. */
+    size_t                  br_len;
+    uint16_t                br_tail;
+
+    int                     files[TTAK_IO_URING_MAX_FILES]; /**< fd per fixed slot, -1 when free. */
+    tt_map_t                *file_slots;    /**< fd + 1 -> slot. */
+};
+
+static int uring_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int uring_register(int fd, unsigned op, const void *arg, unsigned nr) {
+    return (int)syscall(__NR_io_uring_register, fd, op, arg, nr);
+}
+
+static ttak_io_status_t uring_status(int res) {
+    if (res >= 0) return TTAK_IO_SUCCESS;
+    switch (-res) {
+        case EAGAIN:
+        case EINTR:
+        case ECANCELED:
+        case ENOBUFS:
+        case ETIME:
+            return TTAK_IO_ERR_NEEDS_RETRY;
+        case EBADF:
+            return TTAK_IO_ERR_EXPIRED_GUARD;
+        default:
+            return TTAK_IO_ERR_SYS_FAILURE;
+    }
+}
+
+static unsigned round_pow2(unsigned v) {
+    unsigned p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+/* ---- Submission side; callers hold ring->lock ---- */
+
+static unsigned sq_space(ttak_io_uring_t *ring) {
+    unsigned head = atomic_load_explicit(ring->sq_head, memory_order_acquire);
+    return ring->sq_entries - (ring->sq_local_tail - head);
+}
+
+static struct io_uring_sqe *sq_next(ttak_io_uring_t *ring) {
+    struct io_uring_sqe *sqe = &ring->sqes[ring->sq_local_tail & ring->sq_mask];
+    ring->sq_local_tail++;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+static void sq_publish(ttak_io_uring_t *ring) {
+    atomic_store_explicit(ring->sq_tail, ring->sq_local_tail, memory_order_release);
+}
+
+static unsigned sq_pending(ttak_io_uring_t *ring) {
+    return ring->sq_local_tail - atomic_load_explicit(ring->sq_head, memory_order_acquire);
+}
+
+static uring_op_t *op_alloc(ttak_io_uring_t *ring) {
+    if (!ring->free_op) return NULL;
+    uring_op_t *op = &ring->ops[ring->free_op - 1];
+    ring->free_op = op->next_free;
+    return op;
+}
+
+static void op_free(ttak_io_uring_t *ring, uring_op_t *op) {
+    op->next_free = ring->free_op;
+    ring->free_op = (uint32_t)(op - ring->ops) + 1;
+}
+
+/* Points @p sqe at @p guard, using its fixed slot when it has one. */
+static void sq_set_file(ttak_io_uring_t *ring, struct io_uring_sqe *sqe, const ttak_io_guard_t *guard) {
+    size_t slot;
+    if (ttak_map_get_key(ring->file_slots, (uintptr_t)guard->fd + 1, &slot, 0)) {
+        sqe->fd = (int)slot;
+        sqe->flags |= IOSQE_FIXED_FILE;
+    } else {
+        sqe->fd = guard->fd;
+    }
+}
+
+/* Reserves @p need entries and an op, flushing the queue to the kernel once if full. */
+static uring_op_t *sq_reserve(ttak_io_uring_t *ring, unsigned need) {
+    if (sq_space(ring) < need) {
+        sq_publish(ring);
+        unsigned pending = sq_pending(ring);
+        ttak_mutex_unlock(&ring->lock);
+        uring_enter(ring->fd, pending, 0, 0);
+        ttak_mutex_lock(&ring->lock);
+        if (sq_space(ring) < need) return NULL;
+    }
+    return op_alloc(ring);
+}
+
+static ttak_io_status_t uring_queue_rw(ttak_io_uring_t *ring,
+                                       ttak_io_guard_t *guard,
+                                       bool is_write,
+                                       void *buf,
+                                       size_t len,
+                                       int timeout_ms,
+                                       ttak_io_async_result_cb cb,
+                                       void *user,
+                                       uint64_t now) {
+    if (!ring || !guard || (!buf && len > 0) || len > UINT32_MAX) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (!ttak_io_guard_valid(guard, now)) {
+        ttak_io_guard_close(guard, now);
+        return TTAK_IO_ERR_EXPIRED_GUARD;
+    }
+
+    ttak_mutex_lock(&ring->lock);
+    uring_op_t *op = sq_reserve(ring, timeout_ms >= 0 ? 2 : 1);
+    if (!op) {
+        ttak_mutex_unlock(&ring->lock);
+        return TTAK_IO_ERR_NEEDS_RETRY;
+    }
+    op->kind = is_write ? URING_OP_WRITE : URING_OP_READ;
+    op->guard = guard;
+    op->cb = cb;
+    op->recv_cb = NULL;
+    op->user = user;
+
+    const uint8_t *base = ring->arena.data;
+    const uint8_t *p = buf;
+    bool fixed = ring->fixed_buf && p >= base && len <= ring->arena.size &&
+                 (size_t)(p - base) <= ring->arena.size - len;
+
+    struct io_uring_sqe *sqe = sq_next(ring);
+    if (fixed) {
+        sqe->opcode = is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        sqe->buf_index = 0;
+    } else {
+        sqe->opcode = is_write ? IORING_OP_WRITE : IORING_OP_READ;
+    }
+    sq_set_file(ring, sqe, guard);
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)len;
+    sqe->off = (uint64_t)-1;    /* Current file position, like read()/write(). */
+    sqe->user_data = (uint64_t)(op - ring->ops) + 1;
+
+    if (timeout_ms >= 0) {
+        sqe->flags |= IOSQE_IO_LINK;
+        op->ts.tv_sec = timeout_ms / 1000;
+        op->ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000LL;
+        struct io_uring_sqe *tsqe = sq_next(ring);
+        tsqe->opcode = IORING_OP_LINK_TIMEOUT;
+        tsqe->fd = -1;
+        tsqe->addr = (uint64_t)(uintptr_t)&op->ts;
+        tsqe->len = 1;
+        tsqe->user_data = 0;
+    }
+    ttak_mutex_unlock(&ring->lock);
+    return TTAK_IO_SUCCESS;
+}
+
+/* ---- Provided buffers; callers hold ring->lock ---- */
+
+static void br_add(ttak_io_uring_t *ring, unsigned bid) {
+    struct io_uring_buf *b = &ring->br->bufs[ring->br_tail & (ring->buf_count - 1)];
+    b->addr = (uint64_t)(uintptr_t)((uint8_t *)ring->arena.data + (size_t)bid * ring->buf_size);
+    b->len = (uint32_t)ring->buf_size;
+    b->bid = (uint16_t)bid;
+    ring->br_tail++;
+}
+
+static void br_publish(ttak_io_uring_t *ring) {
+    __atomic_store_n(&ring->br->tail, ring->br_tail, __ATOMIC_RELEASE);
+}
+
+/* ---- Lifecycle ---- */
+
+static void uring_unmap(ttak_io_uring_t *ring) {
+    if (ring->sqes) munmap(ring->sqes, ring->sqes_len);
+    if (ring->cq_map && ring->cq_map != ring->sq_map) munmap(ring->cq_map, ring->cq_map_len);
+    if (ring->sq_map) munmap(ring->sq_map, ring->sq_map_len);
+}
+
+static void uring_free(ttak_io_uring_t *ring) {
+    if (ring->fd >= 0) close(ring->fd);
+    uring_unmap(ring);
+    if (ring->br) munmap(ring->br, ring->br_len);
+    if (ring->arena.data) ttak_detachable_mem_free(ttak_detachable_context_default(), &ring->arena);
+    if (ring->file_slots) ttak_destroy_map(ring->file_slots);
+    free(ring->ops);
+    ttak_mutex_destroy(&ring->lock);
+    free(ring);
+}
+
+static bool uring_map_queues(ttak_io_uring_t *ring, const struct io_uring_params *p) {
+    ring->sq_map_len = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+    ring->cq_map_len = p->cq_off.cqes + p->cq_entries * sizeof(struct io_uring_cqe);
+    bool single = (p->features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && ring->cq_map_len > ring->sq_map_len) ring->sq_map_len = ring->cq_map_len;
+
+    void *sq = mmap(NULL, ring->sq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring->fd, IORING_OFF_SQ_RING);
+    if (sq == MAP_FAILED) return false;
+    ring->sq_map = sq;
+    if (single) {
+        ring->cq_map = sq;
+    } else {
+        void *cq = mmap(NULL, ring->cq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring->fd, IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED) return false;
+        ring->cq_map = cq;
+    }
+    ring->sqes_len = p->sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(NULL, ring->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return false;
+    ring->sqes = sqes;
+
+    uint8_t *sqb = ring->sq_map;
+    uint8_t *cqb = ring->cq_map;
+    ring->sq_head = (_Atomic unsigned *)(void *)(sqb + p->sq_off.head);
+    ring->sq_tail = (_Atomic unsigned *)(void *)(sqb + p->sq_off.tail);
+    ring->sq_flags = (_Atomic unsigned *)(void *)(sqb + p->sq_off.flags);
+    ring->sq_mask = *(unsigned *)(void *)(sqb + p->sq_off.ring_mask);
+    ring->sq_entries = p->sq_entries;
+    unsigned *array = (unsigned *)(void *)(sqb + p->sq_off.array);
+    for (unsigned i = 0; i < p->sq_entries; i++) array[i] = i;
+    ring->sq_local_tail = atomic_load_explicit(ring->sq_tail, memory_order_relaxed);
+
+    ring->cq_head = (_Atomic unsigned *)(void *)(cqb + p->cq_off.head);
+    ring->cq_tail = (_Atomic unsigned *)(void *)(cqb + p->cq_off.tail);
+    ring->cq_mask = *(unsigned *)(void *)(cqb + p->cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(void *)(cqb + p->cq_off.cqes);
+    return true;
+}
+
+static bool uring_setup_buffers(ttak_io_uring_t *ring, unsigned buf_count, size_t buf_size, uint64_t now) {
+    if (buf_count == 0) return true;
+    if (buf_count > TTAK_IO_URING_MAX_BUFS) buf_count = TTAK_IO_URING_MAX_BUFS;
+    ring->buf_count = round_pow2(buf_count);
+    if (buf_size == 0) buf_size = TTAK_IO_ZC_SEG_BYTES;
+    if (buf_size > TTAK_IO_URING_MAX_BUF_BYTES) buf_size = TTAK_IO_URING_MAX_BUF_BYTES;
+    ring->buf_size = (buf_size + TTAK_IO_ZC_SEG_MASK) & ~(size_t)TTAK_IO_ZC_SEG_MASK;
+
+    ring->arena = ttak_detachable_mem_alloc(ttak_detachable_context_default(),
+                                            (size_t)ring->buf_count * ring->buf_size, now);
+    if (!ring->arena.data) return false;
+
+    /* Fixed buffers only save pinning; carry on without them if refused (e.g. RLIMIT_MEMLOCK). */
+    struct iovec iov = { .iov_base = ring->arena.data, .iov_len = ring->arena.size };
+    ring->fixed_buf = uring_register(ring->fd, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+
+    ring->br_len = (size_t)ring->buf_count * sizeof(struct io_uring_buf);
+    void *br = mmap(NULL, ring->br_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (br == MAP_FAILED) return false;
+    ring->br = br;
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)br;
+    reg.ring_entries = ring->buf_count;
+    reg.bgid = 0;
+    if (uring_register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) return false;
+
+    for (unsigned i = 0; i < ring->buf_count; i++) br_add(ring, i);
+    br_publish(ring);
+    return true;
+}
+
+ttak_io_uring_t *ttak_io_uring_create(unsigned entries, unsigned buf_count, size_t buf_size, uint64_t now) {
+    if (entries == 0) entries = 64;
+    ttak_io_uring_t *ring = calloc(1, sizeof(*ring));
+    if (!ring) return NULL;
+    ring->fd = -1;
+    ttak_mutex_init(&ring->lock);
+    for (unsigned i = 0; i < TTAK_IO_URING_MAX_FILES; i++) ring->files[i] = -1;
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_COOP_TASKRUN;
+    ring->fd = uring_setup(entries, &p);
+    if (ring->fd < 0 && errno == EINVAL) {
+        memset(&p, 0, sizeof(p));
+        ring->fd = uring_setup(entries, &p);
+    }
+    if (ring->fd < 0 || !uring_map_queues(ring, &p)) {
+        uring_free(ring);
+        return NULL;
+    }
+
+    /* The kernel sizes the CQ at twice the SQ; no more ops than that can be outstanding. */
+    ring->nops = p.cq_entries;
+    ring->ops = calloc(ring->nops, sizeof(*ring->ops));
+    ring->file_slots = ttak_create_map(TTAK_IO_URING_MAX_FILES, now);
+    if (!ring->ops || !ring->file_slots) {
+        uring_free(ring);
+        return NULL;
+    }
+    for (unsigned i = 0; i < ring->nops; i++) {
+        ring->ops[i].next_free = i + 2 <= ring->nops ? i + 2 : 0;
+    }
+    ring->free_op = 1;
+
+    if (uring_register(ring->fd, IORING_REGISTER_FILES, ring->files, TTAK_IO_URING_MAX_FILES) != 0 ||
+        !uring_setup_buffers(ring, buf_count, buf_size, now)) {
+        uring_free(ring);
+        return NULL;
+    }
+    return ring;
+}
+
+void ttak_io_uring_destroy(ttak_io_uring_t *ring) {
+    if (!ring) return;
+    uring_free(ring);
+}
+
+ttak_io_status_t ttak_io_uring_register_guard(ttak_io_uring_t *ring, ttak_io_guard_t *guard, uint64_t now) {
+    if (!ring || !guard) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (!ttak_io_guard_valid(guard, now)) return TTAK_IO_ERR_EXPIRED_GUARD;
+
+    ttak_io_status_t status = TTAK_IO_ERR_RANGE;
+    ttak_mutex_lock(&ring->lock);
+    size_t slot;
+    if (ttak_map_get_key(ring->file_slots, (uintptr_t)guard->fd + 1, &slot, now)) {
+        status = TTAK_IO_SUCCESS;
+    } else {
+        for (unsigned i = 0; i < TTAK_IO_URING_MAX_FILES; i++) {
+            if (ring->files[i] != -1) continue;
+            struct io_uring_files_update up;
+            memset(&up, 0, sizeof(up));
+            up.offset = i;
+            up.fds = (uint64_t)(uintptr_t)&guard->fd;
+            if (uring_register(ring->fd, IORING_REGISTER_FILES_UPDATE, &up, 1) != 1) {
+                status = TTAK_IO_ERR_SYS_FAILURE;
+                break;
+            }
+            ring->files[i] = guard->fd;
+            ttak_insert_to_map(ring->file_slots, (uintptr_t)guard->fd + 1, i, now);
+            status = TTAK_IO_SUCCESS;
+            break;
+        }
+    }
+    ttak_mutex_unlock(&ring->lock);
+    return status;
+}
+
+void ttak_io_uring_unregister_guard(ttak_io_uring_t *ring, const ttak_io_guard_t *guard) {
+    if (!ring || !guard) return;
+    ttak_mutex_lock(&ring->lock);
+    size_t slot;
+    if (ttak_map_get_key(ring->file_slots, (uintptr_t)guard->fd + 1, &slot, 0)) {
+        int none = -1;
+        struct io_uring_files_update up;
+        memset(&up, 0, sizeof(up));
+        up.offset = (uint32_t)slot;
+        up.fds = (uint64_t)(uintptr_t)&none;
+        uring_register(ring->fd, IORING_REGISTER_FILES_UPDATE, &up, 1);
+        ring->files[slot] = -1;
+        ttak_delete_from_map(ring->file_slots, (uintptr_t)guard->fd + 1, 0);
+    }
+    ttak_mutex_unlock(&ring->lock);
+}
+
+ttak_io_status_t ttak_io_uring_read(ttak_io_uring_t *ring,
+                                    ttak_io_guard_t *guard,
+                                    void *dst,
+                                    size_t len,
+                                    int timeout_ms,
+                                    ttak_io_async_result_cb cb,
+                                    void *user,
+                                    uint64_t now) {
+    return uring_queue_rw(ring, guard, false, dst, len, timeout_ms, cb, user, now);
+}
+
+ttak_io_status_t ttak_io_uring_write(ttak_io_uring_t *ring,
+                                     ttak_io_guard_t *guard,
+                                     const void *src,
+                                     size_t len,
+                                     int timeout_ms,
+                                     ttak_io_async_result_cb cb,
+                                     void *user,
+                                     uint64_t now) {
+    return uring_queue_rw(ring, guard, true, (void *)src, len, timeout_ms, cb, user, now);
+}
+
+ttak_io_status_t ttak_io_uring_recv(ttak_io_uring_t *ring,
+                                    ttak_io_guard_t *guard,
+                                    ttak_io_uring_recv_cb cb,
+                                    void *user,
+                                    uint64_t now) {
+    if (!ring || !guard || !cb || !ring->br) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    if (!ttak_io_guard_valid(guard, now)) {
+        ttak_io_guard_close(guard, now);
+        return TTAK_IO_ERR_EXPIRED_GUARD;
+    }
+
+    ttak_mutex_lock(&ring->lock);
+    uring_op_t *op = sq_reserve(ring, 1);
+    if (!op) {
+        ttak_mutex_unlock(&ring->lock);
+        return TTAK_IO_ERR_NEEDS_RETRY;
+    }
+    op->kind = URING_OP_RECV;
+    op->guard = guard;
+    op->cb = NULL;
+    op->recv_cb = cb;
+    op->user = user;
+
+    struct io_uring_sqe *sqe = sq_next(ring);
+    sqe->opcode = IORING_OP_RECV;
+    sq_set_file(ring, sqe, guard);
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+    sqe->user_data = (uint64_t)(op - ring->ops) + 1;
+    ttak_mutex_unlock(&ring->lock);
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_uring_recycle(ttak_io_uring_t *ring, const ttak_io_zerocopy_region_t *region) {
+    if (!ring || !region || !ring->br || !region->data) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    const uint8_t *base = ring->arena.data;
+    if (region->data < base || (size_t)(region->data - base) >= ring->arena.size) return TTAK_IO_ERR_RANGE;
+    unsigned bid = (unsigned)((size_t)(region->data - base) / ring->buf_size);
+
+    ttak_mutex_lock(&ring->lock);
+    br_add(ring, bid);
+    br_publish(ring);
+    ttak_mutex_unlock(&ring->lock);
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_io_status_t ttak_io_uring_cancel(ttak_io_uring_t *ring, const ttak_io_guard_t *guard) {
+    if (!ring || !guard) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    ttak_mutex_lock(&ring->lock);
+    if (sq_space(ring) < 1) {
+        sq_publish(ring);
+        unsigned pending = sq_pending(ring);
+        ttak_mutex_unlock(&ring->lock);
+        uring_enter(ring->fd, pending, 0, 0);
+        ttak_mutex_lock(&ring->lock);
+        if (sq_space(ring) < 1) {
+            ttak_mutex_unlock(&ring->lock);
+            return TTAK_IO_ERR_NEEDS_RETRY;
+        }
+    }
+    struct io_uring_sqe *sqe = sq_next(ring);
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sq_set_file(ring, sqe, guard);
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    if (sqe->flags & IOSQE_FIXED_FILE) {
+        sqe->flags &= (uint8_t)~IOSQE_FIXED_FILE;
+        sqe->cancel_flags |= IORING_ASYNC_CANCEL_FD_FIXED;
+    }
+    sqe->user_data = 0;
+    ttak_mutex_unlock(&ring->lock);
+    return ttak_io_uring_submit(ring);
+}
+
+ttak_io_status_t ttak_io_uring_submit(ttak_io_uring_t *ring) {
+    if (!ring) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    ttak_mutex_lock(&ring->lock);
+    sq_publish(ring);
+    unsigned pending = sq_pending(ring);
+    ttak_mutex_unlock(&ring->lock);
+    if (pending == 0) return TTAK_IO_SUCCESS;
+    int rc;
+    do {
+        rc = uring_enter(ring->fd, pending, 0, 0);
+    } while (rc < 0 && errno == EINTR);
+    return rc < 0 ? uring_status(-errno) : TTAK_IO_SUCCESS;
+}
+
+/* ---- Completion side ---- */
+
+static void uring_deliver(ttak_io_uring_t *ring, const uring_done_t *d) {
+    ttak_io_status_t status = uring_status(d->res);
+    TTAK_TRACE(TTAK_TRACE_IO_COMPLETE, status, d->res > 0 ? (uint64_t)d->res : 0);
+    if (d->kind != URING_OP_RECV) {
+        if (status == TTAK_IO_SUCCESS) ttak_io_guard_refresh(d->guard, ttak_get_tick_count());
+        if (d->cb) d->cb(status, d->res > 0 ? (size_t)d->res : 0, d->user);
+        return;
+    }
+
+    ttak_io_zerocopy_region_t region;
+    ttak_io_zerocopy_region_init(&region);
+    if (d->has_buf) {
+        region.data = (const uint8_t *)ring->arena.data + (size_t)d->bid * ring->buf_size;
+        region.capacity = ring->buf_size;
+        if (d->res > 0) {
+            region.len = (size_t)d->res;
+            size_t segs = (region.len + TTAK_IO_ZC_SEG_MASK) >> TTAK_IO_ZC_SEG_SHIFT;
+            for (size_t s = 0; s < segs; s++) {
+                region.segment_mask[s / TTAK_IO_ZC_SEGMENT_WORD_BITS] |= 1U << (s % TTAK_IO_ZC_SEGMENT_WORD_BITS);
+            }
+        }
+        region.read_only = true;
+        if (d->res <= 0) {
+            /* A buffer was taken but nothing landed in it; give it straight back. */
+            ttak_io_uring_recycle(ring, &region);
+            ttak_io_zerocopy_region_init(&region);
+        }
+    }
+    if (status == TTAK_IO_SUCCESS) ttak_io_guard_refresh(d->guard, ttak_get_tick_count());
+    d->recv_cb(status, &region, d->more, d->user);
+}
+
+/* Copies up to TTAK_IO_URING_REAP_BATCH completions out of the queue. */
+static size_t uring_reap(ttak_io_uring_t *ring, uring_done_t *out) {
+    size_t n = 0;
+    ttak_mutex_lock(&ring->lock);
+    unsigned head = atomic_load_explicit(ring->cq_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(ring->cq_tail, memory_order_acquire);
+    while (head != tail && n < TTAK_IO_URING_REAP_BATCH) {
+        const struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+        head++;
+        if (cqe->user_data == 0) continue;
+        uring_op_t *op = &ring->ops[cqe->user_data - 1];
+        uring_done_t *d = &out[n++];
+        d->kind = op->kind;
+        d->res = cqe->res;
+        d->has_buf = (cqe->flags & IORING_CQE_F_BUFFER) != 0;
+        d->bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        d->more = op->kind == URING_OP_RECV && (cqe->flags & IORING_CQE_F_MORE) != 0;
+        d->guard = op->guard;
+        d->cb = op->cb;
+        d->recv_cb = op->recv_cb;
+        d->user = op->user;
+        if (!d->more) op_free(ring, op);
+    }
+    atomic_store_explicit(ring->cq_head, head, memory_order_release);
+    ttak_mutex_unlock(&ring->lock);
+    return n;
+}
+
+size_t ttak_io_uring_poll(ttak_io_uring_t *ring, unsigned wait_nr) {
+    if (!ring) return 0;
+    ttak_mutex_lock(&ring->lock);
+    sq_publish(ring);
+    unsigned pending = sq_pending(ring);
+    ttak_mutex_unlock(&ring->lock);
+
+    unsigned kflags = atomic_load_explicit(ring->sq_flags, memory_order_relaxed);
+    if (pending || wait_nr || (kflags & (IORING_SQ_CQ_OVERFLOW | IORING_SQ_TASKRUN))) {
+        int rc;
+        do {
+            rc = uring_enter(ring->fd, pending, wait_nr, IORING_ENTER_GETEVENTS);
+        } while (rc < 0 && errno == EINTR && wait_nr == 0);
+    }
+
+    size_t ran = 0;
+    uring_done_t batch[TTAK_IO_URING_REAP_BATCH];
+    for (;;) {
+        size_t n = uring_reap(ring, batch);
+        for (size_t i = 0; i < n; i++) uring_deliver(ring, &batch[i]);
+        ran += n;
+        if (n > 0) continue;
+        /* Completions the kernel held back while the queue was full. */
+        if (!(atomic_load_explicit(ring->sq_flags, memory_order_relaxed) & IORING_SQ_CQ_OVERFLOW)) break;
+        uring_enter(ring->fd, 0, 0, IORING_ENTER_GETEVENTS);
+        if (atomic_load_explicit(ring->cq_head, memory_order_relaxed) ==
+            atomic_load_explicit(ring->cq_tail, memory_order_acquire)) break;
+    }
+    return ran;
+}
+
+#else /* No io_uring. */
+
+ttak_io_uring_t *ttak_io_uring_create(unsigned entries, unsigned buf_count, size_t buf_size, uint64_t now) {
+    (void)entries;
+    (void)buf_count;
+    (void)buf_size;
+    (void)now;
+    return NULL;
+}
+
+void ttak_io_uring_destroy(ttak_io_uring_t *ring) {
+    (void)ring;
+}
+
+ttak_io_status_t ttak_io_uring_register_guard(ttak_io_uring_t *ring, ttak_io_guard_t *guard, uint64_t now) {
+    (void)ring;
+    (void)guard;
+    (void)now;
+    return TTAK_IO_ERR_SYS_FAILURE;
+}
+
+void ttak_io_uring_unregister_guard(ttak_io_uring_t *ring, const ttak_io_guard_t *guard) {
+    (void)ring;
+    (void)guard;
+}
+
+ttak_io_status_t ttak_io_uring_read(ttak_io_uring_t *ring,
+                                    ttak_io_guard_t *guard,
+                                    void *dst,
+                                    size_t len,
+                                    int timeout_ms,
+                                    ttak_io_async_result_cb cb,
+                                    void *user,
+                                    uint64_t now) {
+    (void)ring;
+    (void)guard;
+    (void)dst;
+    (void)len;
+    (void)timeout_ms;
+    (void)cb;
+    (void)user;
+    (void)now;
+    return TTAK_IO_ERR_SYS_FAILURE;
+}
+
+ttak_io_status_t ttak_io_uring_write(ttak_io_uring_t *ring,
+                                     ttak_io_guard_t *guard,
+                                     const void *src,
+                                     size_t len,
+                                     int timeout_ms,
+                                     ttak_io_async_result_cb cb,
+                                     void *user,
+                                     uint64_t now) {
+    (void)ring;
+    (void)guard;
+    (void)src;
+    (void)len;
+    (void)timeout_ms;
+    (void)cb;
+    (void)user;
+    (void)now;
+    return TTAK_IO_ERR_SYS_FAILURE;
+}
+
+ttak_io_status_t ttak_io_uring_recv(ttak_io_uring_t *ring,
+                                    ttak_io_guard_t *guard,
+                                    ttak_io_uring_recv_cb cb,
+                                    void *user,
+                                    uint64_t now) {
+    (void)ring;
+    (void)guard;
+    (void)cb;
+    (void)user;
+    (void)now;
+    return TTAK_IO_ERR_SYS_FAILURE;
+}
+
+ttak_io_status_t ttak_io_uring_recycle(ttak_io_uring_t *ring, const ttak_io_zerocopy_region_t *region) {
+    (void)ring;
+    (void)region;
+    return TTAK_IO_ERR_SYS_FAILURE;
+}
+
+ttak_io_status_t ttak_io_uring_cancel(ttak_io_uring_t *ring, const ttak_io_guard_t *guard) {
+    (void)ring;
+    (void)guard;
+    return TTAK_IO_ERR_SYS_FAILURE;
+}
+
+ttak_io_status_t ttak_io_uring_submit(ttak_io_uring_t *ring) {
+    (void)ring;
+    return TTAK_IO_ERR_SYS_FAILURE;
+}
+
+size_t ttak_io_uring_poll(ttak_io_uring_t *ring, unsigned wait_nr) {
+    (void)ring;
+    (void)wait_nr;
+    return 0;
+}
+
+#endif
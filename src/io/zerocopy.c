@@ -5,11 +5,16 @@
  * Allocates a contiguous segment-aligned buffer in a detachable arena so
  * that received data can be handed off to consumers without copying.
  * Segment occupancy is tracked with a 256-bit bitmap for O(1) iteration.
+ *
+ * The transmit side hands large payloads to the kernel with MSG_ZEROCOPY
+ * and parks their buffers in a small in-order table until the socket's
+ * error queue reports the matching send calls done.
  */
 
 #include <ttak/io/zerocopy.h>
 
 #include <ttak/mem/mem.h>
+#include <ttak/timing/timing.h>
 
 #include <errno.h>
 #include <stdbool.h>
@@ -19,14 +24,36 @@
 #include <winsock2.h>
 typedef int ttak_io_ssize_t;
 #else
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/uio.h>
 #include <unistd.h>
 typedef ssize_t ttak_io_ssize_t;
 #endif
 
-void ttak_io_zerocopy_region_init(ttak_io_zerocopy_region_t *region) {
-    if (!region) return;
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/sendfile.h>
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+#define TTAK_IO_ZC_TX_SUPPORTED 1
+#endif
+
+/**
+ * @brief Clears the received window while keeping the arena binding.
+ */
+static void ttak_io_zerocopy_region_reset(ttak_io_zerocopy_region_t *region) {
     region->data = NULL;
     region->len = 0;
     region->capacity = 0;
@@ -37,6 +64,17 @@ void ttak_io_zerocopy_region_init(ttak_io_zerocopy_region_t *region) {
     region->allocation.size = 0;
 }
 
+void ttak_io_zerocopy_region_init(ttak_io_zerocopy_region_t *region) {
+    if (!region) return;
+    region->bound_arena = NULL;
+    ttak_io_zerocopy_region_reset(region);
+}
+
+void ttak_io_zerocopy_region_bind(ttak_io_zerocopy_region_t *region, ttak_detachable_context_t *arena) {
+    if (!region) return;
+    region->bound_arena = arena;
+}
+
 ttak_io_status_t ttak_io_zerocopy_recv_fd(int fd,
                                           ttak_io_zerocopy_region_t *region,
                                           size_t max_len,
@@ -46,17 +84,17 @@ ttak_io_status_t ttak_io_zerocopy_recv_fd(int fd,
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
     if (max_len == 0) {
-        ttak_io_zerocopy_region_init(region);
+        ttak_io_zerocopy_region_reset(region);
         return TTAK_IO_SUCCESS;
     }
     if (max_len > (size_t)TTAK_IO_ZC_MAX_SEGMENTS * (size_t)TTAK_IO_ZC_SEG_BYTES) {
         max_len = (size_t)TTAK_IO_ZC_MAX_SEGMENTS * (size_t)TTAK_IO_ZC_SEG_BYTES;
     }
 
-    region->arena = ttak_detachable_context_default();
+    region->arena = region->bound_arena ? region->bound_arena : ttak_detachable_context_default();
     region->allocation = ttak_detachable_mem_alloc(region->arena, max_len, now);
     if (!region->allocation.data) {
-        ttak_io_zerocopy_region_init(region);
+        ttak_io_zerocopy_region_reset(region);
         return TTAK_IO_ERR_SYS_FAILURE;
     }
 
@@ -112,7 +150,7 @@ ttak_io_status_t ttak_io_zerocopy_recv_fd(int fd,
 #endif
             if (total == 0) {
                 ttak_detachable_mem_free(region->arena, &region->allocation);
-                ttak_io_zerocopy_region_init(region);
+                ttak_io_zerocopy_region_reset(region);
                 return retry ? TTAK_IO_ERR_NEEDS_RETRY : TTAK_IO_ERR_SYS_FAILURE;
             }
             break;
@@ -156,5 +194,256 @@ void ttak_io_zerocopy_release(ttak_io_zerocopy_region_t *region) {
     if (region->arena && region->allocation.data) {
         ttak_detachable_mem_free(region->arena, &region->allocation);
     }
-    ttak_io_zerocopy_region_init(region);
+    ttak_io_zerocopy_region_reset(region);
+}
+
+ttak_io_status_t ttak_io_zerocopy_tx_init(ttak_io_zerocopy_tx_t *tx,
+                                          int fd,
+                                          ttak_detachable_context_t *arena,
+                                          size_t threshold) {
+    if (!tx || fd < 0) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    memset(tx, 0, sizeof(*tx));
+    tx->fd = fd;
+    tx->arena = arena ? arena : ttak_detachable_context_default();
+    tx->threshold = threshold ? threshold : TTAK_IO_ZC_TX_THRESHOLD;
+#ifdef TTAK_IO_ZC_TX_SUPPORTED
+    int one = 1;
+    tx->enabled = setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+#endif
+    return TTAK_IO_SUCCESS;
+}
+
+ttak_detachable_allocation_t ttak_io_zerocopy_tx_alloc(ttak_io_zerocopy_tx_t *tx, size_t len, uint64_t now) {
+    ttak_detachable_allocation_t empty;
+    memset(&empty, 0, sizeof(empty));
+    if (!tx || len == 0) return empty;
+    return ttak_detachable_mem_alloc(tx->arena, len, now);
+}
+
+/**
+ * @brief Blocks until @p fd is writable or has an error queued.
+ */
+static void ttak_io_zerocopy_wait(int fd, short events, int timeout_ms) {
+    struct pollfd pfd;
+    memset(&pfd, 0, sizeof(pfd));
+    pfd.fd = fd;
+    pfd.events = events;
+#ifdef _WIN32
+    (void)WSAPoll(&pfd, 1, timeout_ms);
+#else
+    (void)poll(&pfd, 1, timeout_ms);
+#endif
+}
+
+#ifdef TTAK_IO_ZC_TX_SUPPORTED
+/**
+ * @brief Credits the kernel's completed send calls [@p lo, @p hi] to the
+ *        pending buffers they came from.
+ *
+ * Ids are compared relative to the oldest pending buffer so the 32-bit
+ * counter may wrap.
+ */
+static void ttak_io_zerocopy_complete(ttak_io_zerocopy_tx_t *tx, uint32_t lo, uint32_t hi) {
+    uint32_t base = tx->pending[tx->head].first_id;
+    uint64_t rlo = (uint32_t)(lo - base);
+    uint64_t rhi = (uint64_t)(uint32_t)(hi - base) + 1U;
+    for (uint32_t i = 0; i < tx->count; i++) {
+        ttak_io_zerocopy_pending_t *p = &tx->pending[(tx->head + i) % TTAK_IO_ZC_TX_MAX_PENDING];
+        uint64_t rs = (uint32_t)(p->first_id - base);
+        uint64_t re = rs + p->calls;
+        uint64_t from = rs > rlo ? rs : rlo;
+        uint64_t to = re < rhi ? re : rhi;
+        if (to > from) p->completed += (uint32_t)(to - from);
+    }
+}
+#endif
+
+size_t ttak_io_zerocopy_tx_reap(ttak_io_zerocopy_tx_t *tx, int timeout_ms) {
+    if (!tx || tx->count == 0) return 0;
+#ifdef TTAK_IO_ZC_TX_SUPPORTED
+    // POLLERR is reported whenever the error queue is non-empty.
+    if (timeout_ms != 0) ttak_io_zerocopy_wait(tx->fd, 0, timeout_ms);
+    for (;;) {
+        char control[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(tx->fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) break;
+        for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            bool recverr = (cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_RECVERR) ||
+                           (cm->cmsg_level == IPPROTO_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+            if (!recverr) continue;
+            struct sock_extended_err serr;
+            memcpy(&serr, CMSG_DATA(cm), sizeof(serr));
+            if (serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY || serr.ee_errno != 0) continue;
+            uint64_t calls = (uint64_t)(uint32_t)(serr.ee_data - serr.ee_info) + 1U;
+            if (serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                tx->copied += calls;
+            } else {
+                tx->zerocopied += calls;
+            }
+            ttak_io_zerocopy_complete(tx, serr.ee_info, serr.ee_data);
+        }
+    }
+#else
+    (void)timeout_ms;
+#endif
+    size_t freed = 0;
+    while (tx->count > 0) {
+        ttak_io_zerocopy_pending_t *p = &tx->pending[tx->head];
+        if (p->completed < p->calls) break;
+        ttak_detachable_mem_free(tx->arena, &p->allocation);
+        memset(p, 0, sizeof(*p));
+        tx->head = (tx->head + 1U) % TTAK_IO_ZC_TX_MAX_PENDING;
+        tx->count--;
+        freed++;
+    }
+    return freed;
+}
+
+static bool ttak_io_zerocopy_send_retry(void) {
+#ifdef _WIN32
+    int err = WSAGetLastError();
+    return err == WSAEINTR || err == WSAEWOULDBLOCK;
+#else
+    return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+ttak_io_status_t ttak_io_zerocopy_send(ttak_io_zerocopy_tx_t *tx,
+                                       ttak_detachable_allocation_t *alloc,
+                                       size_t len,
+                                       int flags,
+                                       size_t *sent) {
+    if (sent) *sent = 0;
+    if (!tx || !alloc || (!alloc->data && len > 0) || len > alloc->size) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    const uint8_t *buf = (const uint8_t *)alloc->data;
+    ttak_io_zerocopy_pending_t *slot = NULL;
+    int send_flags = flags;
+#ifdef TTAK_IO_ZC_TX_SUPPORTED
+    if (tx->enabled && len >= tx->threshold) {
+        while (tx->count == TTAK_IO_ZC_TX_MAX_PENDING) {
+            ttak_io_zerocopy_tx_reap(tx, 100);
+        }
+        slot = &tx->pending[(tx->head + tx->count) % TTAK_IO_ZC_TX_MAX_PENDING];
+        slot->allocation = *alloc;
+        slot->first_id = tx->next_id;
+        // Open-ended until the last call is made, so an early completion cannot free it.
+        slot->calls = UINT32_MAX;
+        slot->completed = 0;
+        tx->count++;
+        send_flags |= MSG_ZEROCOPY;
+    }
+#endif
+
+    ttak_io_status_t status = TTAK_IO_SUCCESS;
+    uint32_t calls = 0;
+    size_t off = 0;
+    while (off < len) {
+#ifdef _WIN32
+        ttak_io_ssize_t rc = send(tx->fd, (const char *)(buf + off), (int)(len - off), send_flags);
+#else
+        ttak_io_ssize_t rc = send(tx->fd, buf + off, len - off, send_flags);
+#endif
+        if (rc > 0) {
+            off += (size_t)rc;
+            if (slot) {
+                calls++;
+                tx->next_id++;
+            }
+            continue;
+        }
+        if (rc < 0 && ttak_io_zerocopy_send_retry()) {
+            ttak_io_zerocopy_wait(tx->fd, POLLOUT, 100);
+            if (slot) ttak_io_zerocopy_tx_reap(tx, 0);
+            continue;
+        }
+        if (rc < 0 && slot && errno == ENOBUFS) {
+            // Pinned-page budget (optmem) exhausted: wait for earlier sends to finish.
+            ttak_io_zerocopy_tx_reap(tx, 100);
+            continue;
+        }
+        status = TTAK_IO_ERR_SYS_FAILURE;
+        break;
+    }
+
+    if (slot) {
+        slot->calls = calls;
+        ttak_io_zerocopy_tx_reap(tx, 0);
+    } else {
+        ttak_detachable_mem_free(tx->arena, alloc);
+    }
+    memset(alloc, 0, sizeof(*alloc));
+    if (sent) *sent = off;
+    return status;
+}
+
+void ttak_io_zerocopy_tx_destroy(ttak_io_zerocopy_tx_t *tx, int timeout_ms) {
+    if (!tx) return;
+    uint64_t deadline = ttak_get_tick_count() + (uint64_t)(timeout_ms > 0 ? timeout_ms : 0);
+    while (tx->count > 0) {
+        uint64_t now = ttak_get_tick_count();
+        if (now >= deadline) break;
+        ttak_io_zerocopy_tx_reap(tx, (int)(deadline - now));
+    }
+    while (tx->count > 0) {
+        ttak_detachable_mem_free(tx->arena, &tx->pending[tx->head].allocation);
+        tx->head = (tx->head + 1U) % TTAK_IO_ZC_TX_MAX_PENDING;
+        tx->count--;
+    }
+    tx->fd = -1;
+}
+
+ttak_io_status_t ttak_io_zerocopy_sendfile(int out_fd, int in_fd, uint64_t *offset, size_t len, size_t *sent) {
+    if (sent) *sent = 0;
+    if (out_fd < 0 || in_fd < 0 || !offset) return TTAK_IO_ERR_INVALID_ARGUMENT;
+#ifdef _WIN32
+    (void)len;
+    return TTAK_IO_ERR_SYS_FAILURE;
+#else
+    size_t total = 0;
+    ttak_io_status_t status = TTAK_IO_SUCCESS;
+    while (total < len) {
+#if defined(__linux__)
+        off_t pos = (off_t)*offset;
+        ttak_io_ssize_t rc = sendfile(out_fd, in_fd, &pos, len - total);
+#else
+        uint8_t chunk[(size_t)TTAK_IO_ZC_SEG_BYTES * TTAK_IO_ZC_MAX_IOV];
+        size_t want = len - total < sizeof(chunk) ? len - total : sizeof(chunk);
+        ttak_io_ssize_t got = pread(in_fd, chunk, want, (off_t)*offset);
+        ttak_io_ssize_t rc = got;
+        if (got > 0) {
+            size_t done = 0;
+            while (done < (size_t)got) {
+                ttak_io_ssize_t w = send(out_fd, chunk + done, (size_t)got - done, 0);
+                if (w > 0) {
+                    done += (size_t)w;
+                } else if (w < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    ttak_io_zerocopy_wait(out_fd, POLLOUT, 100);
+                } else {
+                    break;
+                }
+            }
+            rc = done > 0 ? (ttak_io_ssize_t)done : -1;
+        }
+#endif
+        if (rc > 0) {
+            *offset += (uint64_t)rc;
+            total += (size_t)rc;
+            continue;
+        }
+        if (rc == 0) break;     /* End of file. */
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+            ttak_io_zerocopy_wait(out_fd, POLLOUT, 100);
+            continue;
+        }
+        status = TTAK_IO_ERR_SYS_FAILURE;
+        break;
+    }
+    if (sent) *sent = total;
+    return status;
+#endif
 }
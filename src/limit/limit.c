@@ -1,7 +1,64 @@
 #include <ttak/limit/limit.h>
 #include <ttak/timing/timing.h>
-#include <ttak/sync/spinlock.h>
-#include <math.h>
+#include <ttak/security/siphash.h>
+#include <ttak/types/ttak_compiler.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Lease lifetime when the caller passes 0. */
+#define TTAK_RATELIMIT_RECONCILE_NS 10000000ULL
+
+static _Atomic uint32_t g_limit_thread_seq;
+static _Thread_local uint32_t t_limit_shard = UINT32_MAX;
+
+static void *limit_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
+}
+
+static void limit_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/* Lease shard of the calling thread, fixed for its lifetime. */
+static inline uint32_t limit_thread_shard(void) {
+    if (TTAK_UNLIKELY(t_limit_shard == UINT32_MAX)) {
+        t_limit_shard = atomic_fetch_add_explicit(&g_limit_thread_seq, 1, memory_order_relaxed) %
+                        TTAK_RATELIMIT_SHARDS;
+    }
+    return t_limit_shard;
+}
+
+/* (a * b) >> 32 without a 128-bit type; the caller keeps the result in range. */
+static inline uint64_t limit_mul_q32(uint64_t a, uint64_t b) {
+    uint64_t ah = a >> 32, al = a & 0xffffffffULL;
+    uint64_t bh = b >> 32, bl = b & 0xffffffffULL;
+    return ((ah * bh) << 32) + ah * bl + al * bh + ((al * bl) >> 32);
+}
+
+void ttak_token_bucket_init_at(ttak_token_bucket_t *tb, double rate, double burst, uint64_t now_ns) {
+    uint64_t max = ttak_tokens_to_nanotokens(burst);
+    double q32 = rate > 0.0 ? rate * 4294967296.0 : 0.0;
+    tb->max_tokens = max;
+    tb->rate_q32 = q32 >= 1.8e19 ? UINT64_MAX : (uint64_t)q32;
+    if (tb->rate_q32 == 0) {
+        tb->fill_ns = UINT64_MAX;
+    } else {
+        double fill = (double)max / ((double)tb->rate_q32 / 4294967296.0);
+        tb->fill_ns = fill >= 1.8e19 ? UINT64_MAX : (uint64_t)fill + 1;
+    }
+    atomic_init(&tb->tokens, max);
+    atomic_init(&tb->last_ns, now_ns);
+}
 
 /**
  * @brief Initializes a token bucket with specific rate and burst parameters.
@@ -11,11 +68,51 @@
  * @param burst Burst capacity.
  */
 void ttak_token_bucket_init(ttak_token_bucket_t *tb, double rate, double burst) {
-    tb->tokens = burst;
-    tb->max_tokens = burst;
-    tb->refill_rate = rate; 
-    tb->last_refill_ts = ttak_get_tick_count();
-    ttak_spin_init(&tb->lock);
+    ttak_token_bucket_init_at(tb, rate, burst, ttak_get_tick_count_coarse_ns());
+}
+
+void ttak_token_bucket_give(ttak_token_bucket_t *tb, uint64_t nanotokens) {
+    if (nanotokens == 0) return;
+    uint64_t cur = atomic_load_explicit(&tb->tokens, memory_order_relaxed);
+    for (;;) {
+        if (cur >= tb->max_tokens) return;
+        uint64_t next = (nanotokens >= tb->max_tokens - cur) ? tb->max_tokens : cur + nanotokens;
+        if (atomic_compare_exchange_weak_explicit(&tb->tokens, &cur, next,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+/*
+ * Credits the time since last_ns. Only the thread whose CAS moves last_ns
+ * credits an interval; a loser leaves its share to the next caller.
+ */
+static inline void bucket_refill(ttak_token_bucket_t *tb, uint64_t now_ns) {
+    uint64_t last = atomic_load_explicit(&tb->last_ns, memory_order_relaxed);
+    if (now_ns <= last) return;
+    if (!atomic_compare_exchange_strong_explicit(&tb->last_ns, &last, now_ns,
+                                                 memory_order_relaxed, memory_order_relaxed)) {
+        return;
+    }
+    uint64_t elapsed = now_ns - last;
+    uint64_t add = elapsed >= tb->fill_ns ? tb->max_tokens : limit_mul_q32(elapsed, tb->rate_q32);
+    ttak_token_bucket_give(tb, add);
+}
+
+bool ttak_token_bucket_take(ttak_token_bucket_t *tb, uint64_t nanotokens, uint64_t now_ns) {
+    bucket_refill(tb, now_ns);
+    uint64_t cur = atomic_load_explicit(&tb->tokens, memory_order_relaxed);
+    do {
+        if (cur < nanotokens) return false;
+    } while (!atomic_compare_exchange_weak_explicit(&tb->tokens, &cur, cur - nanotokens,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    return true;
+}
+
+uint64_t ttak_token_bucket_available(ttak_token_bucket_t *tb, uint64_t now_ns) {
+    bucket_refill(tb, now_ns);
+    return atomic_load_explicit(&tb->tokens, memory_order_relaxed);
 }
 
 /**
@@ -27,26 +124,189 @@ void ttak_token_bucket_init(ttak_token_bucket_t *tb, double rate, double burst)
  * @param tokens Amount to consume.
  * @return true if successful, false if insufficient tokens.
  */
-bool ttak_token_bucket_consume(ttak_token_bucket_t *tb, double tokens) {
-    ttak_spin_lock(&tb->lock);
-    
-    uint64_t now = ttak_get_tick_count();
-    uint64_t elapsed = now - tb->last_refill_ts;
-    
-    // Refill logic: (Elapsed MS) * (Rate / 1000)
-    if (elapsed > 0) {
-        double new_tokens = (double)elapsed * (tb->refill_rate / 1000.0);
-        tb->tokens = fmin(tb->max_tokens, tb->tokens + new_tokens);
-        tb->last_refill_ts = now;
-    }
-    
-    // Consume logic
-    if (tb->tokens >= tokens) {
-        tb->tokens -= tokens;
-        ttak_spin_unlock(&tb->lock);
+bool (ttak_token_bucket_consume)(ttak_token_bucket_t *tb, double tokens) {
+    return ttak_token_bucket_take(tb, ttak_tokens_to_nanotokens(tokens), ttak_get_tick_count_coarse_ns());
+}
+
+void ttak_gcra_init(ttak_gcra_t *g, double rate, double burst) {
+    double interval = rate > 0.0 ? 1e9 / rate : 1.8e19;
+    g->interval_ns = interval >= 1.8e19 ? UINT64_MAX : (uint64_t)(interval + 0.5);
+    double limit = (double)g->interval_ns * (burst > 0.0 ? burst : 0.0);
+    g->limit_ns = limit >= 1.8e19 ? UINT64_MAX : (uint64_t)(limit + 0.5);
+    atomic_init(&g->tat, 0);
+}
+
+uint64_t ttak_gcra_check(ttak_gcra_t *g, uint64_t n, uint64_t now_ns) {
+    uint64_t cost = (n && g->interval_ns > UINT64_MAX / n) ? UINT64_MAX : n * g->interval_ns;
+    uint64_t tat = atomic_load_explicit(&g->tat, memory_order_relaxed);
+    for (;;) {
+        uint64_t base = tat > now_ns ? tat : now_ns;
+        uint64_t ahead = base - now_ns;
+        if (cost > g->limit_ns || ahead > g->limit_ns - cost) {
+            uint64_t over = (cost > g->limit_ns) ? UINT64_MAX : ahead - (g->limit_ns - cost);
+            return over ? over : 1;
+        }
+        if (atomic_compare_exchange_weak_explicit(&g->tat, &tat, base + cost,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            return 0;
+        }
+    }
+}
+
+static inline size_t tenant_home(const ttak_tenant_limiter_t *lim, uint64_t tenant) {
+    return (size_t)ttak_siphash24_u64(tenant, lim->seed, ~lim->seed) & lim->mask;
+}
+
+/* The tenant's bucket, claiming a slot on first sight; overflow once full. */
+static ttak_token_bucket_t *tenant_bucket(ttak_tenant_limiter_t *lim, uint64_t tag, size_t home) {
+    for (size_t i = 0; i <= lim->mask; i++) {
+        ttak_tenant_entry_t *e = &lim->entries[(home + i) & lim->mask];
+        uint64_t cur = atomic_load_explicit(&e->tag, memory_order_acquire);
+        if (cur == tag) return &e->bucket;
+        if (cur != 0) continue;
+        if (atomic_fetch_add_explicit(&lim->tenants, 1, memory_order_relaxed) >= lim->max_tenants) {
+            atomic_fetch_sub_explicit(&lim->tenants, 1, memory_order_relaxed);
+            return &lim->overflow;
+        }
+        if (atomic_compare_exchange_strong_explicit(&e->tag, &cur, tag,
+                                                    memory_order_acq_rel, memory_order_acquire)) {
+            return &e->bucket;
+        }
+        atomic_fetch_sub_explicit(&lim->tenants, 1, memory_order_relaxed);
+        if (cur == tag) return &e->bucket;
+    }
+    return &lim->overflow;
+}
+
+/*
+ * The tenant's lease in a shard's table, claiming a slot if @p claim; NULL
+ * if absent or the table is full.
+ */
+static ttak_tenant_lease_t *tenant_lease(ttak_tenant_lease_t *table, size_t mask, uint64_t tag,
+                                         size_t home, bool claim) {
+    for (size_t i = 0; i <= mask; i++) {
+        ttak_tenant_lease_t *l = &table[(home + i) & mask];
+        uint64_t cur = atomic_load_explicit(&l->tag, memory_order_relaxed);
+        if (cur == tag) return l;
+        if (cur != 0) continue;
+        if (!claim) return NULL;
+        if (atomic_compare_exchange_strong_explicit(&l->tag, &cur, tag,
+                                                    memory_order_relaxed, memory_order_relaxed) ||
+            cur == tag) {
+            return l;
+        }
+    }
+    return NULL;
+}
+
+/* Spends @p need from the lease if it holds that much. */
+static inline bool lease_spend(ttak_tenant_lease_t *l, uint64_t need) {
+    uint64_t cur = atomic_load_explicit(&l->tokens, memory_order_relaxed);
+    do {
+        if (cur < need) return false;
+    } while (!atomic_compare_exchange_weak_explicit(&l->tokens, &cur, cur - need,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    return true;
+}
+
+static inline void lease_return(ttak_tenant_lease_t *l, ttak_token_bucket_t *bucket) {
+    ttak_token_bucket_give(bucket, atomic_exchange_explicit(&l->tokens, 0, memory_order_relaxed));
+}
+
+ttak_tenant_limiter_t *ttak_tenant_limiter_create(size_t max_tenants, double rate, double burst,
+                                                  double lease, uint64_t reconcile_ns,
+                                                  uint64_t now_ns) {
+    if (max_tenants == 0) max_tenants = 1;
+    size_t slots = 16;
+    while (slots < max_tenants * 2) slots <<= 1;
+
+    ttak_tenant_limiter_t *lim = calloc(1, sizeof(*lim));
+    if (!lim) return NULL;
+    lim->entries = limit_aligned_alloc(slots * sizeof(ttak_tenant_entry_t));
+    if (!lim->entries) {
+        free(lim);
+        return NULL;
+    }
+    for (size_t s = 0; s < TTAK_RATELIMIT_SHARDS; s++) {
+        lim->leases[s] = limit_aligned_alloc(slots * sizeof(ttak_tenant_lease_t));
+        if (!lim->leases[s]) {
+            ttak_tenant_limiter_destroy(lim);
+            return NULL;
+        }
+        memset(lim->leases[s], 0, slots * sizeof(ttak_tenant_lease_t));
+    }
+
+    lim->mask = slots - 1;
+    lim->max_tenants = max_tenants;
+    lim->seed = ttak_siphash24_u64((uint64_t)(uintptr_t)lim, now_ns, 0x6c696d6974ULL);
+    lim->lease_nt = ttak_tokens_to_nanotokens(lease);
+    lim->reconcile_ns = reconcile_ns ? reconcile_ns : TTAK_RATELIMIT_RECONCILE_NS;
+    atomic_init(&lim->tenants, 0);
+    /* Buckets are ready before any slot is claimed, so claiming is one CAS. */
+    for (size_t i = 0; i < slots; i++) {
+        atomic_init(&lim->entries[i].tag, 0);
+        ttak_token_bucket_init_at(&lim->entries[i].bucket, rate, burst, now_ns);
+    }
+    ttak_token_bucket_init_at(&lim->overflow, rate, burst, now_ns);
+    return lim;
+}
+
+void ttak_tenant_limiter_destroy(ttak_tenant_limiter_t *lim) {
+    if (!lim) return;
+    for (size_t s = 0; s < TTAK_RATELIMIT_SHARDS; s++) limit_aligned_free(lim->leases[s]);
+    limit_aligned_free(lim->entries);
+    free(lim);
+}
+
+bool ttak_tenant_limiter_consume(ttak_tenant_limiter_t *lim, uint64_t tenant, double tokens,
+                                 uint64_t now_ns) {
+    uint64_t need = ttak_tokens_to_nanotokens(tokens);
+    uint64_t tag = tenant + 1;
+    size_t home = tenant_home(lim, tenant);
+
+    ttak_tenant_lease_t *table = lim->leases[limit_thread_shard()];
+    ttak_tenant_lease_t *l = lim->lease_nt ? tenant_lease(table, lim->mask, tag, home, true) : NULL;
+    if (l) {
+        uint64_t stamp = atomic_load_explicit(&l->stamp_ns, memory_order_relaxed);
+        if (now_ns - stamp <= lim->reconcile_ns || now_ns < stamp) {
+            if (lease_spend(l, need)) return true;
+        }
+    }
+
+    ttak_token_bucket_t *bucket = tenant_bucket(lim, tag, home);
+    if (!l) {
+        return ttak_token_bucket_take(bucket, need, now_ns);
+    }
+
+    /* Whatever is left in the lease is stale or too small; give it back. */
+    lease_return(l, bucket);
+    uint64_t want = (need > UINT64_MAX - lim->lease_nt) ? need : need + lim->lease_nt;
+    if (ttak_token_bucket_take(bucket, want, now_ns)) {
+        atomic_store_explicit(&l->stamp_ns, now_ns, memory_order_relaxed);
+        atomic_fetch_add_explicit(&l->tokens, want - need, memory_order_relaxed);
         return true;
     }
-    
-    ttak_spin_unlock(&tb->lock);
-    return false;
+    if (ttak_token_bucket_take(bucket, need, now_ns)) return true;
+
+    /* Reclaim what other shards are holding for this tenant and retry once. */
+    for (size_t s = 0; s < TTAK_RATELIMIT_SHARDS; s++) {
+        if (lim->leases[s] == table) continue;
+        ttak_tenant_lease_t *other = tenant_lease(lim->leases[s], lim->mask, tag, home, false);
+        if (other) lease_return(other, bucket);
+    }
+    return ttak_token_bucket_take(bucket, need, now_ns);
+}
+
+void ttak_tenant_limiter_reconcile(ttak_tenant_limiter_t *lim, uint64_t now_ns) {
+    for (size_t s = 0; s < TTAK_RATELIMIT_SHARDS; s++) {
+        ttak_tenant_lease_t *table = lim->leases[s];
+        for (size_t i = 0; i <= lim->mask; i++) {
+            ttak_tenant_lease_t *l = &table[i];
+            uint64_t tag = atomic_load_explicit(&l->tag, memory_order_relaxed);
+            if (tag == 0 || atomic_load_explicit(&l->tokens, memory_order_relaxed) == 0) continue;
+            uint64_t stamp = atomic_load_explicit(&l->stamp_ns, memory_order_relaxed);
+            if (now_ns >= stamp && now_ns - stamp <= lim->reconcile_ns) continue;
+            lease_return(l, tenant_bucket(lim, tag, tenant_home(lim, tag - 1)));
+        }
+    }
 }
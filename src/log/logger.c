@@ -1,19 +1,47 @@
 #include <ttak/log/logger.h>
+#include <ttak/timing/timing.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+/** Longest message, as in the synchronous path; longer ones are cut. */
+#define TTAK_LOG_LINE_MAX 1024U
+/** Arguments (including '*' widths) one deferred record can carry. */
+#define TTAK_LOG_MAX_ARGS 16U
+/** Records start on this boundary so a header never wraps. */
+#define TTAK_LOG_REC_ALIGN 16U
+/** Pieces and bytes gathered into one writev(). */
+#define TTAK_LOG_BATCH_IOV 128U
+#define TTAK_LOG_BATCH_BYTES (64U * 1024U)
+#define TTAK_LOG_MIN_RING 8192U
+
+static const char *ttak_log_level_name(ttak_log_level_t level) {
+    switch (level) {
+        case TTAK_LOG_DEBUG: return "DEBUG";
+        case TTAK_LOG_INFO:  return "INFO ";
+        case TTAK_LOG_WARN:  return "WARN ";
+        case TTAK_LOG_ERROR: return "ERROR";
+        default:             return "INFO ";
+    }
+}
 
 /**
  * @brief Default logging function writing to stderr.
  */
 static void default_log_func(ttak_log_level_t level, const char *msg) {
-    const char *lvl_str = "INFO";
-    switch (level) {
-        case TTAK_LOG_DEBUG: lvl_str = "DEBUG"; break;
-        case TTAK_LOG_INFO:  lvl_str = "INFO "; break;
-        case TTAK_LOG_WARN:  lvl_str = "WARN "; break;
-        case TTAK_LOG_ERROR: lvl_str = "ERROR"; break;
-    }
-    fprintf(stderr, "[%s] %s\n", lvl_str, msg);
+    fprintf(stderr, "[%s] %s\n", ttak_log_level_name(level), msg);
 }
 
 /**
@@ -23,6 +51,477 @@ void ttak_logger_init(ttak_logger_t *l, ttak_log_func_t func, ttak_log_level_t l
     l->log_func = func ? func : default_log_func;
     l->min_level = level;
     l->should_trace = ttak_mem_set_trace;
+    l->async = NULL;
+}
+
+/* --- Deferred records --- */
+
+/**
+ * @brief One captured argument. Strings are copied behind the arguments
+ *        and referenced by offset from the record start.
+ */
+typedef union ttak_log_arg {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void *p;
+    struct {
+        uint32_t off;
+        uint32_t len;
+    } s;
+} ttak_log_arg_t;
+
+enum {
+    TTAK_LOG_REC_PAD = 0,       /**< Filler up to the end of the ring. */
+    TTAK_LOG_REC_DEFERRED,      /**< Format pointer plus arguments. */
+    TTAK_LOG_REC_TEXT,          /**< Message formatted by the caller. */
+    TTAK_LOG_REC_BINARY         /**< Encoded stream bytes, written as they are. */
+};
+
+typedef struct ttak_log_rec {
+    uint32_t size;              /**< Whole record, a multiple of TTAK_LOG_REC_ALIGN. */
+    uint8_t kind;
+    uint8_t level;
+    uint8_t nargs;
+    uint8_t reserved;
+    union {
+        const char *fmt;        /**< TTAK_LOG_REC_DEFERRED. */
+        size_t bytes;           /**< TTAK_LOG_REC_BINARY: encoded length. */
+    } u;
+} ttak_log_rec_t;
+
+#define TTAK_LOG_REC_HDR \
+    ((sizeof(ttak_log_rec_t) + TTAK_LOG_REC_ALIGN - 1U) & ~(size_t)(TTAK_LOG_REC_ALIGN - 1U))
+
+enum {
+    TTAK_LOG_RING_FREE = 0,     /**< Left by an exited thread; claimable. */
+    TTAK_LOG_RING_OWNED,        /**< Written by one live thread. */
+    TTAK_LOG_RING_ABANDONED     /**< Logger stopped; the owning thread frees it on exit. */
+};
+
+/**
+ * @brief Single-producer ring of one thread. The producer owns @c head,
+ *        the writer owns @c tail; both only grow.
+ */
+typedef struct ttak_log_ring {
+    _Atomic uint64_t head;
+    uint8_t pad0[56];
+    _Atomic uint64_t tail;
+    uint8_t pad1[56];
+    struct ttak_logger_async *async;
+    struct ttak_log_ring *next;         /**< Logger's list; immutable once published. */
+    struct ttak_log_ring *thread_next;  /**< Owning thread's list. */
+    _Atomic int state;
+    size_t mask;
+    uint8_t *buf;
+} ttak_log_ring_t;
+
+struct ttak_logger_async {
+    ttak_logger_t *logger;
+    ttak_log_ring_t *_Atomic rings;
+    size_t ring_bytes;
+    ttak_log_overflow_t overflow;
+    int fd;
+    bool batch;                 /**< Default handler: writev() to @c fd. */
+    bool binary;                /**< Binary stream to @c fd. */
+    uint64_t stream;            /**< Binary stream id, for per-stream site definitions. */
+    uint32_t interval_ms;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        /**< Writer sleeps here. */
+    pthread_cond_t done;        /**< Flushers and blocked producers sleep here. */
+    _Atomic bool stop;
+    _Atomic uint64_t flush_req;
+    uint64_t flush_done;        /**< Guarded by @c lock. */
+    _Atomic uint64_t dropped;
+};
+
+static _Thread_local ttak_log_ring_t *t_log_ring = NULL;
+static _Thread_local ttak_log_ring_t *t_log_rings = NULL;
+
+static pthread_key_t g_log_exit_key;
+static pthread_once_t g_log_exit_once = PTHREAD_ONCE_INIT;
+
+static void ttak_log_ring_free(ttak_log_ring_t *r) {
+    free(r->buf);
+    free(r);
+}
+
+/* Hands the exiting thread's rings to the next thread, or frees those of stopped loggers. */
+static void ttak_log_thread_exit(void *arg) {
+    (void)arg;
+    ttak_log_ring_t *r = t_log_rings;
+    t_log_rings = NULL;
+    t_log_ring = NULL;
+    while (r) {
+        ttak_log_ring_t *next = r->thread_next;
+        int expected = TTAK_LOG_RING_OWNED;
+        if (!atomic_compare_exchange_strong_explicit(&r->state, &expected, TTAK_LOG_RING_FREE,
+                                                     memory_order_acq_rel, memory_order_acquire)) {
+            ttak_log_ring_free(r);
+        }
+        r = next;
+    }
+}
+
+static void ttak_log_exit_key_init(void) {
+    pthread_key_create(&g_log_exit_key, ttak_log_thread_exit);
+}
+
+static ttak_log_ring_t *ttak_log_thread_ring(struct ttak_logger_async *a) {
+    ttak_log_ring_t *r = t_log_ring;
+    if (r && r->async == a && atomic_load_explicit(&r->state, memory_order_relaxed) == TTAK_LOG_RING_OWNED) {
+        return r;
+    }
+    for (r = t_log_rings; r; r = r->thread_next) {
+        if (r->async == a && atomic_load_explicit(&r->state, memory_order_relaxed) == TTAK_LOG_RING_OWNED) {
+            t_log_ring = r;
+            return r;
+        }
+    }
+
+    for (r = atomic_load_explicit(&a->rings, memory_order_acquire); r; r = r->next) {
+        int expected = TTAK_LOG_RING_FREE;
+        if (atomic_load_explicit(&r->state, memory_order_relaxed) == TTAK_LOG_RING_FREE &&
+            atomic_compare_exchange_strong_explicit(&r->state, &expected, TTAK_LOG_RING_OWNED,
+                                                    memory_order_acq_rel, memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (!r) {
+        r = calloc(1, sizeof(*r));
+        if (!r) return NULL;
+        r->buf = malloc(a->ring_bytes);
+        if (!r->buf) {
+            free(r);
+            return NULL;
+        }
+        r->async = a;
+        r->mask = a->ring_bytes - 1U;
+        atomic_init(&r->head, 0);
+        atomic_init(&r->tail, 0);
+        atomic_init(&r->state, TTAK_LOG_RING_OWNED);
+        ttak_log_ring_t *head = atomic_load_explicit(&a->rings, memory_order_acquire);
+        do {
+            r->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&a->rings, &head, r,
+                                                        memory_order_release, memory_order_acquire));
+    }
+
+    r->thread_next = t_log_rings;
+    t_log_rings = r;
+    t_log_ring = r;
+    pthread_once(&g_log_exit_once, ttak_log_exit_key_init);
+    pthread_setspecific(g_log_exit_key, r);
+    return r;
+}
+
+/* Room for @p size bytes, or NULL if the ring is full. Publish with ttak_log_commit(). */
+static uint8_t *ttak_log_reserve(ttak_log_ring_t *r, size_t size, uint64_t *out_head) {
+    const size_t cap = r->mask + 1U;
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    size_t pos = (size_t)(head & r->mask);
+    size_t to_end = cap - pos;
+    size_t need = size + (to_end < size ? to_end : 0U);
+    uint64_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    if (cap - (size_t)(head - tail) < need) return NULL;
+    if (to_end < size) {
+        ttak_log_rec_t *pad = (ttak_log_rec_t *)(void *)(r->buf + pos);
+        pad->size = (uint32_t)to_end;
+        pad->kind = TTAK_LOG_REC_PAD;
+        head += to_end;
+        pos = 0;
+    }
+    *out_head = head;
+    return r->buf + pos;
+}
+
+static void ttak_log_commit(ttak_log_ring_t *r, uint64_t head, size_t size) {
+    atomic_store_explicit(&r->head, head + size, memory_order_release);
+}
+
+/* --- printf conversion parsing shared by capture and formatting --- */
+
+typedef enum {
+    TTAK_LOG_LEN_NONE = 0,
+    TTAK_LOG_LEN_HH,
+    TTAK_LOG_LEN_H,
+    TTAK_LOG_LEN_L,
+    TTAK_LOG_LEN_LL,
+    TTAK_LOG_LEN_J,
+    TTAK_LOG_LEN_Z,
+    TTAK_LOG_LEN_T,
+    TTAK_LOG_LEN_BIG_L
+} ttak_log_len_t;
+
+typedef struct ttak_log_spec {
+    const char *end;            /**< First byte after the conversion. */
+    size_t prefix_len;          /**< '%' through precision, before the length modifier. */
+    ttak_log_len_t len;
+    char conv;
+    unsigned stars;             /**< '*' width and precision arguments. */
+    bool star_prec;
+    int prec;                   /**< Literal precision, or -1. */
+} ttak_log_spec_t;
+
+/* Parses the conversion at @p p (a '%'); false for one this file cannot defer. */
+static bool ttak_log_parse_spec(const char *p, ttak_log_spec_t *s) {
+    const char *q = p + 1;
+    memset(s, 0, sizeof(*s));
+    s->prec = -1;
+    while (*q && strchr("-+ #0'", *q)) q++;
+    if (*q == '*') {
+        s->stars++;
+        q++;
+    } else {
+        while (*q >= '0' && *q <= '9') q++;
+    }
+    if (*q == '.') {
+        q++;
+        if (*q == '*') {
+            s->stars++;
+            s->star_prec = true;
+            q++;
+        } else {
+            s->prec = 0;
+            while (*q >= '0' && *q <= '9') {
+                if (s->prec < 100000) s->prec = s->prec * 10 + (*q - '0');
+                q++;
+            }
+        }
+    }
+    s->prefix_len = (size_t)(q - p);
+    switch (*q) {
+        case 'h':
+            s->len = (q[1] == 'h') ? TTAK_LOG_LEN_HH : TTAK_LOG_LEN_H;
+            q += (q[1] == 'h') ? 2 : 1;
+            break;
+        case 'l':
+            s->len = (q[1] == 'l') ? TTAK_LOG_LEN_LL : TTAK_LOG_LEN_L;
+            q += (q[1] == 'l') ? 2 : 1;
+            break;
+        case 'j': s->len = TTAK_LOG_LEN_J; q++; break;
+        case 'z': s->len = TTAK_LOG_LEN_Z; q++; break;
+        case 't': s->len = TTAK_LOG_LEN_T; q++; break;
+        case 'L': s->len = TTAK_LOG_LEN_BIG_L; q++; break;
+        default: break;
+    }
+    s->conv = *q;
+    s->end = *q ? q + 1 : q;
+    /* The rebuilt spec gets a two-byte modifier; keep it within the 32-byte buffer. */
+    if (!*q || s->prefix_len > 24U) return false;
+    switch (s->conv) {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+            return s->len != TTAK_LOG_LEN_BIG_L;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+        case 'c': case 's':
+            return s->len == TTAK_LOG_LEN_NONE;
+        case 'p':
+            return s->len == TTAK_LOG_LEN_NONE;
+        case '%':
+            return s->stars == 0;
+        default:
+            return false;
+    }
+}
+
+static long long ttak_log_fetch_signed(ttak_log_len_t len, va_list *ap) {
+    switch (len) {
+        case TTAK_LOG_LEN_HH: return (signed char)va_arg(*ap, int);
+        case TTAK_LOG_LEN_H:  return (short)va_arg(*ap, int);
+        case TTAK_LOG_LEN_L:  return va_arg(*ap, long);
+        case TTAK_LOG_LEN_LL: return va_arg(*ap, long long);
+        case TTAK_LOG_LEN_J:  return (long long)va_arg(*ap, intmax_t);
+        case TTAK_LOG_LEN_Z:  return (long long)va_arg(*ap, ptrdiff_t);
+        case TTAK_LOG_LEN_T:  return (long long)va_arg(*ap, ptrdiff_t);
+        case TTAK_LOG_LEN_NONE:
+        case TTAK_LOG_LEN_BIG_L:
+        default:              return va_arg(*ap, int);
+    }
+}
+
+static unsigned long long ttak_log_fetch_unsigned(ttak_log_len_t len, va_list *ap) {
+    switch (len) {
+        case TTAK_LOG_LEN_HH: return (unsigned char)va_arg(*ap, unsigned);
+        case TTAK_LOG_LEN_H:  return (unsigned short)va_arg(*ap, unsigned);
+        case TTAK_LOG_LEN_L:  return va_arg(*ap, unsigned long);
+        case TTAK_LOG_LEN_LL: return va_arg(*ap, unsigned long long);
+        case TTAK_LOG_LEN_J:  return (unsigned long long)va_arg(*ap, uintmax_t);
+        case TTAK_LOG_LEN_Z:  return (unsigned long long)va_arg(*ap, size_t);
+        case TTAK_LOG_LEN_T:  return (unsigned long long)(size_t)va_arg(*ap, ptrdiff_t);
+        case TTAK_LOG_LEN_NONE:
+        case TTAK_LOG_LEN_BIG_L:
+        default:              return va_arg(*ap, unsigned);
+    }
+}
+
+/*
+ * Pulls every argument @p fmt consumes out of @p ap. String arguments are
+ * left in @p strs with their length in the slot; @p str_bytes sums the
+ * copies including terminators. False means the caller must format now.
+ */
+static bool ttak_log_capture(const char *fmt, va_list *ap, ttak_log_arg_t *args, const char **strs,
+                             uint8_t *nargs, size_t *str_bytes) {
+    size_t n = 0;
+    size_t bytes = 0;
+    for (const char *p = fmt; *p; p++) {
+        if (*p != '%') continue;
+        ttak_log_spec_t s;
+        if (!ttak_log_parse_spec(p, &s)) return false;
+        p = s.end - 1;
+        if (s.conv == '%') continue;
+        if (n + s.stars + 1U > TTAK_LOG_MAX_ARGS) return false;
+        int star_prec = -1;
+        for (unsigned i = 0; i < s.stars; i++) {
+            strs[n] = NULL;
+            args[n].i = va_arg(*ap, int);
+            if (s.star_prec && i + 1U == s.stars) star_prec = (int)args[n].i;
+            n++;
+        }
+        strs[n] = NULL;
+        switch (s.conv) {
+            case 'd': case 'i':
+                args[n].i = ttak_log_fetch_signed(s.len, ap);
+                break;
+            case 'o': case 'u': case 'x': case 'X':
+                args[n].u = ttak_log_fetch_unsigned(s.len, ap);
+                break;
+            case 'c':
+                args[n].i = va_arg(*ap, int);
+                break;
+            case 'p':
+                args[n].p = va_arg(*ap, void *);
+                break;
+            case 's': {
+                const char *str = va_arg(*ap, const char *);
+                if (!str) str = "(null)";
+                size_t limit = TTAK_LOG_LINE_MAX - 1U;
+                int prec = s.star_prec ? star_prec : s.prec;
+                if (prec >= 0 && (size_t)prec < limit) limit = (size_t)prec;
+                size_t len = strnlen(str, limit);
+                strs[n] = str;
+                args[n].s.len = (uint32_t)len;
+                bytes += len + 1U;
+                break;
+            }
+            default:
+                args[n].d = va_arg(*ap, double);
+                break;
+        }
+        n++;
+    }
+    *nargs = (uint8_t)n;
+    *str_bytes = bytes;
+    return true;
+}
+
+static size_t ttak_log_round(size_t v) {
+    return (v + TTAK_LOG_REC_ALIGN - 1U) & ~(size_t)(TTAK_LOG_REC_ALIGN - 1U);
+}
+
+/* Builds the record in place; @p text is set for a caller-formatted message. */
+static void ttak_log_fill(uint8_t *dst, size_t size, ttak_log_level_t level, const char *fmt,
+                          const ttak_log_arg_t *args, const char **strs, uint8_t nargs, const char *text) {
+    ttak_log_rec_t *rec = (ttak_log_rec_t *)(void *)dst;
+    rec->size = (uint32_t)size;
+    rec->level = (uint8_t)level;
+    rec->reserved = 0;
+    if (text) {
+        rec->kind = TTAK_LOG_REC_TEXT;
+        rec->nargs = 0;
+        rec->u.fmt = NULL;
+        strcpy((char *)dst + TTAK_LOG_REC_HDR, text);
+        return;
+    }
+    rec->kind = TTAK_LOG_REC_DEFERRED;
+    rec->nargs = nargs;
+    rec->u.fmt = fmt;
+    ttak_log_arg_t *slots = (ttak_log_arg_t *)(void *)(dst + TTAK_LOG_REC_HDR);
+    size_t off = TTAK_LOG_REC_HDR + (size_t)nargs * sizeof(ttak_log_arg_t);
+    for (uint8_t i = 0; i < nargs; i++) {
+        slots[i] = args[i];
+        if (strs[i]) {
+            memcpy(dst + off, strs[i], args[i].s.len);
+            dst[off + args[i].s.len] = '\0';
+            slots[i].s.off = (uint32_t)off;
+            off += args[i].s.len + 1U;
+        }
+    }
+}
+
+/* Nudges the writer and waits briefly for it to free ring space. */
+static void ttak_log_wait_room(struct ttak_logger_async *a) {
+    pthread_mutex_lock(&a->lock);
+    pthread_cond_signal(&a->wake);
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&a->done, &a->lock, &ts);
+    pthread_mutex_unlock(&a->lock);
+}
+
+/* ttak_log_reserve() that applies the overflow policy; NULL once the record is dropped. */
+static uint8_t *ttak_log_reserve_wait(struct ttak_logger_async *a, ttak_log_ring_t *r, size_t size, uint64_t *head) {
+    uint8_t *dst;
+    while (!(dst = ttak_log_reserve(r, size, head))) {
+        if (a->overflow == TTAK_LOG_OVERFLOW_DROP) {
+            atomic_fetch_add_explicit(&a->dropped, 1, memory_order_relaxed);
+            return NULL;
+        }
+        ttak_log_wait_room(a);
+    }
+    return dst;
+}
+
+static void ttak_log_defer(struct ttak_logger_async *a, ttak_log_level_t level, const char *fmt, va_list ap) {
+    ttak_log_ring_t *r = ttak_log_thread_ring(a);
+    if (!r) {
+        atomic_fetch_add_explicit(&a->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    ttak_log_arg_t args[TTAK_LOG_MAX_ARGS];
+    const char *strs[TTAK_LOG_MAX_ARGS];
+    uint8_t nargs = 0;
+    size_t str_bytes = 0;
+    char text[TTAK_LOG_LINE_MAX];
+    const char *preformatted = NULL;
+    size_t size;
+
+    va_list copy;
+    va_copy(copy, ap);
+    bool deferred = ttak_log_capture(fmt, &copy, args, strs, &nargs, &str_bytes);
+    va_end(copy);
+    size = TTAK_LOG_REC_HDR + (size_t)nargs * sizeof(ttak_log_arg_t) + str_bytes;
+    if (!deferred || size > (r->mask + 1U) / 4U) {
+        vsnprintf(text, sizeof(text), fmt, ap);
+        preformatted = text;
+        size = TTAK_LOG_REC_HDR + strlen(text) + 1U;
+    }
+    size = ttak_log_round(size);
+
+    uint64_t head;
+    uint8_t *dst = ttak_log_reserve_wait(a, r, size, &head);
+    if (!dst) return;
+    ttak_log_fill(dst, size, level, fmt, args, strs, nargs, preformatted);
+    ttak_log_commit(r, head, size);
+}
+
+static void ttak_logger_vlog(ttak_logger_t *l, ttak_log_level_t level, const char *fmt, va_list args) {
+    if (l->async) {
+        ttak_log_defer(l->async, level, fmt, args);
+        return;
+    }
+    char buffer[1024];
+    vsnprintf(buffer, sizeof(buffer), fmt, args);
+
+    if (l->log_func) {
+        l->log_func(level, buffer);
+    }
 }
 
 /**
@@ -30,14 +529,890 @@ void ttak_logger_init(ttak_logger_t *l, ttak_log_func_t func, ttak_log_level_t l
  */
 void ttak_logger_log(ttak_logger_t *l, ttak_log_level_t level, const char *fmt, ...) {
     if (level < l->min_level) return;
-    
-    char buffer[1024];
+
     va_list args;
     va_start(args, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    ttak_logger_vlog(l, level, fmt, args);
     va_end(args);
-    
-    if (l->log_func) {
-        l->log_func(level, buffer);
+}
+
+/* --- Call-site limits --- */
+
+/* Sets up the bucket once; false while another thread is doing it. */
+static bool ttak_log_limit_ready(ttak_log_limit_t *lim) {
+    uint8_t state = atomic_load_explicit(&lim->state, memory_order_acquire);
+    if (state == 2U) return true;
+    if (state != 0U ||
+        !atomic_compare_exchange_strong_explicit(&lim->state, &state, 1U,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        return state == 2U;
+    }
+    if (lim->rate > 0.0) ttak_ratelimit_init(&lim->rl, lim->rate, lim->burst >= 1.0 ? lim->burst : 1.0);
+    if (!lim->report_ns) lim->report_ns = TTAK_LOG_LIMIT_REPORT_NS;
+    atomic_store_explicit(&lim->next_report_ns, ttak_get_tick_count_coarse_ns() + lim->report_ns,
+                          memory_order_relaxed);
+    atomic_store_explicit(&lim->state, 2U, memory_order_release);
+    return true;
+}
+
+bool ttak_logger_limit_pass(ttak_logger_t *l, ttak_log_limit_t *lim, ttak_log_level_t level,
+                            const char *file, uint32_t line) {
+    if (l && level < l->min_level) return false;
+    /* Passes the few calls that race with set-up; the limit applies from then on. */
+    if (!ttak_log_limit_ready(lim)) return true;
+
+    bool pass = true;
+    uint64_t n = atomic_fetch_add_explicit(&lim->calls, 1, memory_order_relaxed);
+    if (lim->sample > 1U && n % lim->sample != 0U) {
+        pass = false;
+    } else if (lim->rate > 0.0 && !ttak_ratelimit_allow(&lim->rl)) {
+        pass = false;
+    }
+    if (!pass) atomic_fetch_add_explicit(&lim->suppressed, 1, memory_order_relaxed);
+
+    if (atomic_load_explicit(&lim->suppressed, memory_order_relaxed) == 0U) return pass;
+    uint64_t now = ttak_get_tick_count_coarse_ns();
+    uint64_t due = atomic_load_explicit(&lim->next_report_ns, memory_order_relaxed);
+    if (now < due ||
+        !atomic_compare_exchange_strong_explicit(&lim->next_report_ns, &due, now + lim->report_ns,
+                                                 memory_order_relaxed, memory_order_relaxed)) {
+        return pass;
+    }
+    uint64_t count = atomic_exchange_explicit(&lim->suppressed, 0, memory_order_relaxed);
+    if (!count) return pass;
+    if (l) {
+        ttak_logger_log(l, level, "suppressed %llu messages from %s:%u", (unsigned long long)count, file,
+                        (unsigned)line);
+    } else {
+        char msg[TTAK_LOG_LINE_MAX];
+        snprintf(msg, sizeof(msg), "suppressed %llu messages from %s:%u", (unsigned long long)count, file,
+                 (unsigned)line);
+        default_log_func(level, msg);
+    }
+    return pass;
+}
+
+/* --- Binary stream ---
+ *
+ * A stream is the 8-byte magic followed by entries:
+ *   DEF:  type, id, level, line, file length, file, format length, format
+ *   REC:  type, id, payload length, payload = timestamp, arguments
+ *   TEXT: type, level, timestamp, length, message
+ * Integers are LEB128 varints, signed ones zigzag encoded; doubles are
+ * their IEEE bits as a little-endian uint64; strings are length-prefixed.
+ */
+
+static const uint8_t ttak_log_bin_magic[8] = { 'T', 'T', 'A', 'K', 'B', 'L', 'G', 1 };
+
+enum {
+    TTAK_LOG_BIN_DEF = 1,
+    TTAK_LOG_BIN_REC,
+    TTAK_LOG_BIN_TEXT
+};
+
+/* Argument kinds in ttak_log_site_t::sig; the low nibble is the ttak_log_len_t. */
+enum {
+    TTAK_LOG_SIG_STAR = 1,
+    TTAK_LOG_SIG_SIGNED,
+    TTAK_LOG_SIG_UNSIGNED,
+    TTAK_LOG_SIG_DOUBLE,
+    TTAK_LOG_SIG_CHAR,
+    TTAK_LOG_SIG_PTR,
+    TTAK_LOG_SIG_STR
+};
+
+/** Largest encoded entry; keeps every entry within a quarter of the smallest ring. */
+#define TTAK_LOG_BIN_MAX (TTAK_LOG_MIN_RING / 4U - TTAK_LOG_REC_HDR)
+
+static _Atomic uint32_t g_log_site_ids = 0;
+static _Atomic uint64_t g_log_streams = 0;
+
+static size_t ttak_log_put_varint(uint8_t *p, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80U) {
+        p[n++] = (uint8_t)(v | 0x80U);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static bool ttak_log_get_varint(const uint8_t **p, const uint8_t *end, uint64_t *out) {
+    uint64_t v = 0;
+    for (unsigned shift = 0; *p < end && shift < 64U; shift += 7U) {
+        uint8_t byte = *(*p)++;
+        v |= (uint64_t)(byte & 0x7FU) << shift;
+        if (!(byte & 0x80U)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint64_t ttak_log_zigzag(long long v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static long long ttak_log_unzigzag(uint64_t v) {
+    return (long long)(v >> 1) ^ -(long long)(v & 1U);
+}
+
+static uint64_t ttak_log_wall_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Argument kinds of @p fmt; false if it has a conversion the stream cannot carry. */
+static bool ttak_log_signature(const char *fmt, uint8_t *sig, uint8_t *nsig) {
+    size_t n = 0;
+    for (const char *p = fmt; *p; p++) {
+        if (*p != '%') continue;
+        ttak_log_spec_t s;
+        if (!ttak_log_parse_spec(p, &s)) return false;
+        p = s.end - 1;
+        if (s.conv == '%') continue;
+        if (n + s.stars + 1U > sizeof(((ttak_log_site_t *)0)->sig)) return false;
+        for (unsigned i = 0; i < s.stars; i++) sig[n++] = TTAK_LOG_SIG_STAR << 4;
+        uint8_t kind;
+        switch (s.conv) {
+            case 'd': case 'i': kind = TTAK_LOG_SIG_SIGNED; break;
+            case 'o': case 'u': case 'x': case 'X': kind = TTAK_LOG_SIG_UNSIGNED; break;
+            case 'c': kind = TTAK_LOG_SIG_CHAR; break;
+            case 'p': kind = TTAK_LOG_SIG_PTR; break;
+            case 's': kind = TTAK_LOG_SIG_STR; break;
+            default: kind = TTAK_LOG_SIG_DOUBLE; break;
+        }
+        sig[n++] = (uint8_t)((kind << 4) | (uint8_t)s.len);
+    }
+    *nsig = (uint8_t)n;
+    return true;
+}
+
+/* Fills in the site's argument kinds once; false while it cannot be encoded. */
+static bool ttak_log_site_prepare(ttak_log_site_t *site) {
+    uint8_t state = atomic_load_explicit(&site->state, memory_order_acquire);
+    if (state == 1U) return true;
+    if (state != 0U) return false;
+    if (!atomic_compare_exchange_strong_explicit(&site->state, &state, 3U,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        return state == 1U;
+    }
+    bool ok = ttak_log_signature(site->fmt, site->sig, &site->nsig) &&
+              strlen(site->fmt) + strlen(site->file) + 32U <= TTAK_LOG_BIN_MAX;
+    atomic_store_explicit(&site->state, ok ? 1U : 2U, memory_order_release);
+    return ok;
+}
+
+static uint32_t ttak_log_site_id(ttak_log_site_t *site) {
+    uint32_t id = atomic_load_explicit(&site->id, memory_order_acquire);
+    if (id) return id;
+    uint32_t fresh = atomic_fetch_add_explicit(&g_log_site_ids, 1, memory_order_relaxed) + 1U;
+    if (atomic_compare_exchange_strong_explicit(&site->id, &id, fresh, memory_order_acq_rel, memory_order_acquire)) {
+        return fresh;
+    }
+    return id;
+}
+
+/* Queues the site's dictionary entry; false if the ring had no room for it. */
+static bool ttak_log_put_def(struct ttak_logger_async *a, ttak_log_ring_t *r, const ttak_log_site_t *site, uint32_t id) {
+    size_t flen = strlen(site->file);
+    size_t mlen = strlen(site->fmt);
+    uint64_t head;
+    uint8_t *dst = ttak_log_reserve_wait(a, r, ttak_log_round(TTAK_LOG_REC_HDR + flen + mlen + 32U), &head);
+    if (!dst) return false;
+    uint8_t *p = dst + TTAK_LOG_REC_HDR;
+    size_t n = 0;
+    p[n++] = TTAK_LOG_BIN_DEF;
+    n += ttak_log_put_varint(p + n, id);
+    p[n++] = (uint8_t)site->level;
+    n += ttak_log_put_varint(p + n, site->line);
+    n += ttak_log_put_varint(p + n, flen);
+    memcpy(p + n, site->file, flen);
+    n += flen;
+    n += ttak_log_put_varint(p + n, mlen);
+    memcpy(p + n, site->fmt, mlen);
+    n += mlen;
+    ttak_log_rec_t *rec = (ttak_log_rec_t *)(void *)dst;
+    rec->kind = TTAK_LOG_REC_BINARY;
+    rec->level = (uint8_t)site->level;
+    rec->u.bytes = n;
+    rec->size = (uint32_t)ttak_log_round(TTAK_LOG_REC_HDR + n);
+    ttak_log_commit(r, head, rec->size);
+    return true;
+}
+
+static void ttak_log_bin_record(struct ttak_logger_async *a, ttak_log_site_t *site, va_list ap) {
+    ttak_log_ring_t *r = ttak_log_thread_ring(a);
+    if (!r) {
+        atomic_fetch_add_explicit(&a->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    uint64_t now = ttak_log_wall_ns();
+
+    /* Pull the arguments first so the size is known before reserving. */
+    ttak_log_arg_t args[TTAK_LOG_MAX_ARGS];
+    const char *strs[TTAK_LOG_MAX_ARGS];
+    uint8_t nargs = 0;
+    size_t str_bytes = 0;
+    va_list copy;
+    va_copy(copy, ap);
+    bool ok = ttak_log_capture(site->fmt, &copy, args, strs, &nargs, &str_bytes);
+    va_end(copy);
+    size_t bound = 1U + 5U + 5U + 10U + str_bytes + (size_t)nargs * 10U;
+    if (!ok || nargs != site->nsig || bound > TTAK_LOG_BIN_MAX) {
+        ttak_log_defer(a, site->level, site->fmt, ap);
+        return;
+    }
+
+    uint32_t id = ttak_log_site_id(site);
+    uint64_t seen = atomic_load_explicit(&site->stream, memory_order_acquire);
+    if (seen != a->stream &&
+        atomic_compare_exchange_strong_explicit(&site->stream, &seen, a->stream,
+                                                memory_order_acq_rel, memory_order_acquire) &&
+        !ttak_log_put_def(a, r, site, id)) {
+        /* Without its definition the record would be undecodable; let the next call retry. */
+        atomic_store_explicit(&site->stream, seen, memory_order_release);
+        return;
+    }
+
+    uint64_t head;
+    uint8_t *dst = ttak_log_reserve_wait(a, r, ttak_log_round(TTAK_LOG_REC_HDR + bound), &head);
+    if (!dst) return;
+    uint8_t payload[TTAK_LOG_BIN_MAX];
+    size_t m = ttak_log_put_varint(payload, now);
+    for (uint8_t i = 0; i < site->nsig; i++) {
+        switch (site->sig[i] >> 4) {
+            case TTAK_LOG_SIG_STAR:
+            case TTAK_LOG_SIG_SIGNED:
+            case TTAK_LOG_SIG_CHAR:
+                m += ttak_log_put_varint(payload + m, ttak_log_zigzag(args[i].i));
+                break;
+            case TTAK_LOG_SIG_UNSIGNED:
+                m += ttak_log_put_varint(payload + m, args[i].u);
+                break;
+            case TTAK_LOG_SIG_PTR:
+                m += ttak_log_put_varint(payload + m, (uint64_t)(uintptr_t)args[i].p);
+                break;
+            case TTAK_LOG_SIG_STR:
+                m += ttak_log_put_varint(payload + m, args[i].s.len);
+                memcpy(payload + m, strs[i], args[i].s.len);
+                m += args[i].s.len;
+                break;
+            default: {
+                uint64_t bits;
+                memcpy(&bits, &args[i].d, sizeof(bits));
+                for (int b = 0; b < 8; b++) payload[m++] = (uint8_t)(bits >> (8 * b));
+                break;
+            }
+        }
+    }
+    uint8_t *p = dst + TTAK_LOG_REC_HDR;
+    size_t n = 0;
+    p[n++] = TTAK_LOG_BIN_REC;
+    n += ttak_log_put_varint(p + n, id);
+    n += ttak_log_put_varint(p + n, m);
+    memcpy(p + n, payload, m);
+    n += m;
+    ttak_log_rec_t *rec = (ttak_log_rec_t *)(void *)dst;
+    rec->kind = TTAK_LOG_REC_BINARY;
+    rec->level = (uint8_t)site->level;
+    rec->u.bytes = n;
+    rec->size = (uint32_t)ttak_log_round(TTAK_LOG_REC_HDR + n);
+    ttak_log_commit(r, head, rec->size);
+}
+
+void ttak_logger_log_site(ttak_logger_t *l, ttak_log_site_t *site, const char *fmt, ...) {
+    if (!site || site->level < l->min_level) return;
+    va_list args;
+    va_start(args, fmt);
+    struct ttak_logger_async *a = l->async;
+    if (a && a->binary && ttak_log_site_prepare(site)) {
+        ttak_log_bin_record(a, site, args);
+    } else {
+        ttak_logger_vlog(l, site->level, site->fmt, args);
+    }
+    va_end(args);
+}
+
+/* --- Writer thread --- */
+
+/*
+ * Formats @p fmt the way vsnprintf() would have from captured arguments;
+ * string offsets are relative to @p base.
+ */
+static void ttak_log_render(const char *fmt, const ttak_log_arg_t *args, const uint8_t *base, char *out, size_t cap) {
+    size_t pos = 0;
+    size_t n = 0;
+    const char *p = fmt;
+    while (*p && pos + 1U < cap) {
+        if (*p != '%') {
+            out[pos++] = *p++;
+            continue;
+        }
+        ttak_log_spec_t s;
+        ttak_log_parse_spec(p, &s);
+        if (s.conv == '%') {
+            out[pos++] = '%';
+            p = s.end;
+            continue;
+        }
+
+        /* Same flags, width and precision; the length modifier matches the stored type. */
+        char spec[32];
+        memcpy(spec, p, s.prefix_len);
+        size_t k = s.prefix_len;
+        bool integral = strchr("diouxX", s.conv) != NULL;
+        if (integral) {
+            spec[k++] = 'l';
+            spec[k++] = 'l';
+        }
+        spec[k++] = s.conv;
+        spec[k] = '\0';
+        p = s.end;
+
+        int star[2] = { 0, 0 };
+        for (unsigned i = 0; i < s.stars; i++) star[i] = (int)args[n++].i;
+        const ttak_log_arg_t *v = &args[n++];
+        char *dst = out + pos;
+        size_t room = cap - pos;
+        int w = 0;
+
+#define TTAK_LOG_EMIT(value)                                                        \
+    do {                                                                            \
+        switch (s.stars) {                                                          \
+            case 0: w = snprintf(dst, room, spec, value); break;                    \
+            case 1: w = snprintf(dst, room, spec, star[0], value); break;           \
+            default: w = snprintf(dst, room, spec, star[0], star[1], value); break; \
+        }                                                                           \
+    } while (0)
+
+        switch (s.conv) {
+            case 'd': case 'i':
+                TTAK_LOG_EMIT(v->i);
+                break;
+            case 'o': case 'u': case 'x': case 'X':
+                TTAK_LOG_EMIT(v->u);
+                break;
+            case 'c':
+                TTAK_LOG_EMIT((int)v->i);
+                break;
+            case 'p':
+                TTAK_LOG_EMIT(v->p);
+                break;
+            case 's':
+                TTAK_LOG_EMIT((const char *)base + v->s.off);
+                break;
+            default:
+                TTAK_LOG_EMIT(v->d);
+                break;
+        }
+#undef TTAK_LOG_EMIT
+        if (w < 0) break;
+        pos += ((size_t)w < room) ? (size_t)w : room - 1U;
+    }
+    out[pos] = '\0';
+}
+
+/* Output gathered for one writev(): static level prefixes and copied bytes. */
+typedef struct ttak_log_batch {
+    uint8_t bytes[TTAK_LOG_BATCH_BYTES];
+    size_t used;
+#ifndef _WIN32
+    struct iovec iov[TTAK_LOG_BATCH_IOV];
+#endif
+    size_t iovs;
+} ttak_log_batch_t;
+
+static void ttak_log_batch_flush(struct ttak_logger_async *a, ttak_log_batch_t *b) {
+#ifndef _WIN32
+    struct iovec *iov = b->iov;
+    int cnt = (int)b->iovs;
+    while (cnt > 0) {
+        ssize_t n = writev(a->fd, iov, cnt);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        while (cnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+#else
+    if (b->used) _write(a->fd, b->bytes, (unsigned)b->used);
+#endif
+    b->used = 0;
+    b->iovs = 0;
+}
+
+/* Appends @p len bytes; a @p stable piece outlives the batch and is not copied. */
+static void ttak_log_batch_add(struct ttak_logger_async *a, ttak_log_batch_t *b, const void *piece, size_t len,
+                               bool stable) {
+    if (b->used + len > sizeof(b->bytes) || b->iovs == TTAK_LOG_BATCH_IOV) ttak_log_batch_flush(a, b);
+#ifndef _WIN32
+    if (stable) {
+        b->iov[b->iovs].iov_base = (void *)piece;
+        b->iov[b->iovs++].iov_len = len;
+        return;
+    }
+    uint8_t *dst = b->bytes + b->used;
+    memcpy(dst, piece, len);
+    b->used += len;
+    struct iovec *last = b->iovs ? &b->iov[b->iovs - 1U] : NULL;
+    if (last && (uint8_t *)last->iov_base + last->iov_len == dst) {
+        last->iov_len += len;
+    } else {
+        b->iov[b->iovs].iov_base = dst;
+        b->iov[b->iovs++].iov_len = len;
+    }
+#else
+    (void)stable;
+    memcpy(b->bytes + b->used, piece, len);
+    b->used += len;
+#endif
+}
+
+static void ttak_log_emit(struct ttak_logger_async *a, ttak_log_batch_t *b, ttak_log_level_t level, const char *msg) {
+    size_t len = strlen(msg);
+    if (a->binary) {
+        uint8_t enc[TTAK_LOG_LINE_MAX + 32U];
+        size_t n = 0;
+        enc[n++] = TTAK_LOG_BIN_TEXT;
+        enc[n++] = (uint8_t)level;
+        n += ttak_log_put_varint(enc + n, ttak_log_wall_ns());
+        n += ttak_log_put_varint(enc + n, len);
+        memcpy(enc + n, msg, len);
+        ttak_log_batch_add(a, b, enc, n + len, false);
+        return;
+    }
+    if (!a->batch) {
+        if (a->logger->log_func) a->logger->log_func(level, msg);
+        return;
     }
-}
\ No newline at end of file
+    static const char *const prefixes[] = { "[DEBUG] ", "[INFO ] ", "[WARN ] ", "[ERROR] " };
+    const char *prefix = ((unsigned)level < 4U) ? prefixes[level] : prefixes[TTAK_LOG_INFO];
+    ttak_log_batch_add(a, b, prefix, 8, true);
+    ttak_log_batch_add(a, b, msg, len, false);
+    ttak_log_batch_add(a, b, "\n", 1, false);
+}
+
+/* Formats and emits everything published in @p r; returns the records seen. */
+static size_t ttak_log_drain(struct ttak_logger_async *a, ttak_log_ring_t *r, ttak_log_batch_t *b) {
+    char line[TTAK_LOG_LINE_MAX];
+    size_t records = 0;
+    uint64_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    while (tail != head) {
+        const uint8_t *base = r->buf + (size_t)(tail & r->mask);
+        const ttak_log_rec_t *rec = (const ttak_log_rec_t *)(const void *)base;
+        if (rec->kind == TTAK_LOG_REC_DEFERRED) {
+            ttak_log_render(rec->u.fmt, (const ttak_log_arg_t *)(const void *)(base + TTAK_LOG_REC_HDR), base,
+                            line, sizeof(line));
+            ttak_log_emit(a, b, (ttak_log_level_t)rec->level, line);
+            records++;
+        } else if (rec->kind == TTAK_LOG_REC_TEXT) {
+            ttak_log_emit(a, b, (ttak_log_level_t)rec->level, (const char *)base + TTAK_LOG_REC_HDR);
+            records++;
+        } else if (rec->kind == TTAK_LOG_REC_BINARY) {
+            ttak_log_batch_add(a, b, base + TTAK_LOG_REC_HDR, rec->u.bytes, false);
+            records++;
+        }
+        tail += rec->size;
+        atomic_store_explicit(&r->tail, tail, memory_order_release);
+    }
+    return records;
+}
+
+static void *ttak_log_writer(void *arg) {
+    struct ttak_logger_async *a = arg;
+    ttak_log_batch_t *b = malloc(sizeof(*b));
+    if (!b) return NULL;
+    b->used = 0;
+    b->iovs = 0;
+    if (a->binary) ttak_log_batch_add(a, b, ttak_log_bin_magic, sizeof(ttak_log_bin_magic), true);
+    for (;;) {
+        uint64_t req = atomic_load_explicit(&a->flush_req, memory_order_acquire);
+        bool stopping = atomic_load_explicit(&a->stop, memory_order_acquire);
+        size_t records = 0;
+        for (ttak_log_ring_t *r = atomic_load_explicit(&a->rings, memory_order_acquire); r; r = r->next) {
+            records += ttak_log_drain(a, r, b);
+        }
+        if (b->iovs) ttak_log_batch_flush(a, b);
+
+        pthread_mutex_lock(&a->lock);
+        a->flush_done = req;
+        pthread_cond_broadcast(&a->done);
+        if (stopping) {
+            pthread_mutex_unlock(&a->lock);
+            break;
+        }
+        if (records == 0 && req == atomic_load_explicit(&a->flush_req, memory_order_acquire) &&
+            !atomic_load_explicit(&a->stop, memory_order_acquire)) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += (time_t)(a->interval_ms / 1000U);
+            ts.tv_nsec += (long)(a->interval_ms % 1000U) * 1000000L;
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&a->wake, &a->lock, &ts);
+        }
+        pthread_mutex_unlock(&a->lock);
+    }
+    free(b);
+    return NULL;
+}
+
+bool ttak_logger_start_async(ttak_logger_t *l, const ttak_logger_async_config_t *cfg) {
+    if (!l || l->async) return false;
+    struct ttak_logger_async *a = calloc(1, sizeof(*a));
+    if (!a) return false;
+
+    size_t want = (cfg && cfg->ring_bytes) ? cfg->ring_bytes : TTAK_LOG_ASYNC_DEFAULT_RING;
+    size_t ring = TTAK_LOG_MIN_RING;
+    while (ring < want && ring < ((size_t)1 << 30)) ring <<= 1;
+    a->logger = l;
+    a->ring_bytes = ring;
+    a->overflow = cfg ? cfg->overflow : TTAK_LOG_OVERFLOW_DROP;
+    a->fd = (cfg && cfg->fd > 0) ? cfg->fd : 2;
+    a->batch = (l->log_func == default_log_func);
+    a->binary = cfg && cfg->binary;
+    if (a->binary) a->stream = atomic_fetch_add_explicit(&g_log_streams, 1, memory_order_relaxed) + 1U;
+    a->interval_ms = (cfg && cfg->interval_ms) ? cfg->interval_ms : TTAK_LOG_ASYNC_DEFAULT_INTERVAL_MS;
+    atomic_init(&a->rings, NULL);
+    atomic_init(&a->stop, false);
+    atomic_init(&a->flush_req, 0);
+    atomic_init(&a->dropped, 0);
+    pthread_mutex_init(&a->lock, NULL);
+    pthread_cond_init(&a->wake, NULL);
+    pthread_cond_init(&a->done, NULL);
+    if (pthread_create(&a->writer, NULL, ttak_log_writer, a) != 0) {
+        pthread_cond_destroy(&a->done);
+        pthread_cond_destroy(&a->wake);
+        pthread_mutex_destroy(&a->lock);
+        free(a);
+        return false;
+    }
+    if (a->batch) fflush(stderr);
+    l->async = a;
+    return true;
+}
+
+void ttak_logger_flush(ttak_logger_t *l) {
+    struct ttak_logger_async *a = l ? l->async : NULL;
+    if (!a) return;
+    uint64_t mine = atomic_fetch_add_explicit(&a->flush_req, 1, memory_order_acq_rel) + 1U;
+    pthread_mutex_lock(&a->lock);
+    pthread_cond_signal(&a->wake);
+    while (a->flush_done < mine) pthread_cond_wait(&a->done, &a->lock);
+    pthread_mutex_unlock(&a->lock);
+}
+
+void ttak_logger_stop_async(ttak_logger_t *l) {
+    struct ttak_logger_async *a = l ? l->async : NULL;
+    if (!a) return;
+    atomic_store_explicit(&a->stop, true, memory_order_release);
+    pthread_mutex_lock(&a->lock);
+    pthread_cond_signal(&a->wake);
+    pthread_mutex_unlock(&a->lock);
+    pthread_join(a->writer, NULL);
+    l->async = NULL;
+
+    /* Rings of exited threads go now; live owners free theirs when they exit. */
+    ttak_log_ring_t *r = atomic_load_explicit(&a->rings, memory_order_acquire);
+    while (r) {
+        ttak_log_ring_t *next = r->next;
+        int state = atomic_load_explicit(&r->state, memory_order_acquire);
+        for (;;) {
+            if (state == TTAK_LOG_RING_FREE) {
+                ttak_log_ring_free(r);
+                break;
+            }
+            if (atomic_compare_exchange_weak_explicit(&r->state, &state, TTAK_LOG_RING_ABANDONED,
+                                                      memory_order_acq_rel, memory_order_acquire)) {
+                break;
+            }
+        }
+        r = next;
+    }
+    pthread_cond_destroy(&a->done);
+    pthread_cond_destroy(&a->wake);
+    pthread_mutex_destroy(&a->lock);
+    free(a);
+}
+
+uint64_t ttak_logger_dropped(const ttak_logger_t *l) {
+    return (l && l->async) ? atomic_load_explicit(&l->async->dropped, memory_order_relaxed) : 0U;
+}
+
+/* --- Offline decoding --- */
+
+typedef struct ttak_log_bin_def {
+    bool set;
+    uint8_t level;
+    uint8_t nsig;
+    uint8_t sig[TTAK_LOG_MAX_ARGS];
+    uint32_t line;
+    char *file;
+    char *fmt;
+} ttak_log_bin_def_t;
+
+/** Largest site id accepted from a stream; bounds the dictionary table. */
+#define TTAK_LOG_BIN_MAX_ID (1U << 24)
+
+typedef struct ttak_log_bin_dict {
+    ttak_log_bin_def_t *defs;
+    size_t cap;
+} ttak_log_bin_dict_t;
+
+static void ttak_log_bin_dict_clear(ttak_log_bin_dict_t *d) {
+    for (size_t i = 0; i < d->cap; i++) {
+        free(d->defs[i].file);
+        free(d->defs[i].fmt);
+    }
+    free(d->defs);
+    d->defs = NULL;
+    d->cap = 0;
+}
+
+static char *ttak_log_bin_strdup(const uint8_t *s, size_t len) {
+    char *out = malloc(len + 1U);
+    if (!out) return NULL;
+    memcpy(out, s, len);
+    out[len] = '\0';
+    return out;
+}
+
+static bool ttak_log_bin_at_magic(const uint8_t *p, const uint8_t *end) {
+    return (size_t)(end - p) >= sizeof(ttak_log_bin_magic) &&
+           memcmp(p, ttak_log_bin_magic, sizeof(ttak_log_bin_magic)) == 0;
+}
+
+/* Reads a length-prefixed byte string. */
+static bool ttak_log_bin_get_bytes(const uint8_t **p, const uint8_t *end, const uint8_t **s, size_t *len) {
+    uint64_t n;
+    if (!ttak_log_get_varint(p, end, &n) || n > (uint64_t)(end - *p)) return false;
+    *s = *p;
+    *len = (size_t)n;
+    *p += n;
+    return true;
+}
+
+typedef struct ttak_log_bin_raw_def {
+    uint64_t id;
+    uint64_t line;
+    uint8_t level;
+    const uint8_t *file;
+    size_t flen;
+    const uint8_t *fmt;
+    size_t mlen;
+} ttak_log_bin_raw_def_t;
+
+static bool ttak_log_bin_parse_def(const uint8_t **p, const uint8_t *end, ttak_log_bin_raw_def_t *r) {
+    if (!ttak_log_get_varint(p, end, &r->id) || *p >= end) return false;
+    r->level = *(*p)++;
+    return ttak_log_get_varint(p, end, &r->line) && ttak_log_bin_get_bytes(p, end, &r->file, &r->flen) &&
+           ttak_log_bin_get_bytes(p, end, &r->fmt, &r->mlen) && r->id != 0 && r->id <= TTAK_LOG_BIN_MAX_ID;
+}
+
+static bool ttak_log_bin_parse_text(const uint8_t **p, const uint8_t *end, uint8_t *level, uint64_t *ts,
+                                    const uint8_t **s, size_t *len) {
+    if (*p >= end) return false;
+    *level = *(*p)++;
+    return ttak_log_get_varint(p, end, ts) && ttak_log_bin_get_bytes(p, end, s, len);
+}
+
+static bool ttak_log_bin_add_def(ttak_log_bin_dict_t *d, const uint8_t **p, const uint8_t *end) {
+    ttak_log_bin_raw_def_t r;
+    if (!ttak_log_bin_parse_def(p, end, &r)) return false;
+    size_t id = (size_t)r.id;
+    if (id >= d->cap) {
+        size_t cap = d->cap ? d->cap : 64U;
+        while (cap <= id) cap *= 2U;
+        ttak_log_bin_def_t *defs = realloc(d->defs, cap * sizeof(*defs));
+        if (!defs) return false;
+        memset(defs + d->cap, 0, (cap - d->cap) * sizeof(*defs));
+        d->defs = defs;
+        d->cap = cap;
+    }
+    ttak_log_bin_def_t *def = &d->defs[id];
+    free(def->file);
+    free(def->fmt);
+    def->file = ttak_log_bin_strdup(r.file, r.flen);
+    def->fmt = ttak_log_bin_strdup(r.fmt, r.mlen);
+    def->set = def->file && def->fmt && ttak_log_signature(def->fmt, def->sig, &def->nsig);
+    def->level = r.level;
+    def->line = (uint32_t)r.line;
+    return def->set;
+}
+
+static bool ttak_log_bin_put_rec(const ttak_log_bin_dict_t *d, const uint8_t **p, const uint8_t *end,
+                                 ttak_log_bin_cb cb, void *user) {
+    uint64_t id, plen, ts;
+    if (!ttak_log_get_varint(p, end, &id) || !ttak_log_get_varint(p, end, &plen) ||
+        plen > (uint64_t)(end - *p)) {
+        return false;
+    }
+    const uint8_t *q = *p;
+    const uint8_t *qend = q + plen;
+    *p = qend;
+    if (id >= d->cap || !d->defs[id].set || !ttak_log_get_varint(&q, qend, &ts)) return false;
+    const ttak_log_bin_def_t *def = &d->defs[id];
+
+    ttak_log_arg_t args[TTAK_LOG_MAX_ARGS];
+    uint8_t strings[TTAK_LOG_BIN_MAX + TTAK_LOG_MAX_ARGS];
+    size_t used = 0;
+    for (uint8_t i = 0; i < def->nsig; i++) {
+        uint64_t v = 0;
+        switch (def->sig[i] >> 4) {
+            case TTAK_LOG_SIG_STAR:
+            case TTAK_LOG_SIG_SIGNED:
+            case TTAK_LOG_SIG_CHAR:
+                if (!ttak_log_get_varint(&q, qend, &v)) return false;
+                args[i].i = ttak_log_unzigzag(v);
+                break;
+            case TTAK_LOG_SIG_UNSIGNED:
+                if (!ttak_log_get_varint(&q, qend, &v)) return false;
+                args[i].u = v;
+                break;
+            case TTAK_LOG_SIG_PTR:
+                if (!ttak_log_get_varint(&q, qend, &v)) return false;
+                args[i].p = (void *)(uintptr_t)v;
+                break;
+            case TTAK_LOG_SIG_STR: {
+                const uint8_t *s;
+                size_t len;
+                if (!ttak_log_bin_get_bytes(&q, qend, &s, &len) || used + len + 1U > sizeof(strings)) return false;
+                memcpy(strings + used, s, len);
+                strings[used + len] = '\0';
+                args[i].s.off = (uint32_t)used;
+                args[i].s.len = (uint32_t)len;
+                used += len + 1U;
+                break;
+            }
+            default:
+                if (qend - q < 8) return false;
+                for (int b = 0; b < 8; b++) v |= (uint64_t)q[b] << (8 * b);
+                q += 8;
+                memcpy(&args[i].d, &v, sizeof(v));
+                break;
+        }
+    }
+    char msg[TTAK_LOG_LINE_MAX];
+    ttak_log_render(def->fmt, args, strings, msg, sizeof(msg));
+    ttak_log_bin_entry_t entry = {
+        .level = (ttak_log_level_t)def->level,
+        .timestamp_ns = ts,
+        .file = def->file,
+        .line = def->line,
+        .msg = msg,
+    };
+    if (cb) cb(&entry, user);
+    return true;
+}
+
+static bool ttak_log_bin_put_text(const uint8_t **p, const uint8_t *end, ttak_log_bin_cb cb, void *user) {
+    uint8_t level;
+    uint64_t ts;
+    const uint8_t *s;
+    size_t len;
+    if (!ttak_log_bin_parse_text(p, end, &level, &ts, &s, &len)) return false;
+    char msg[TTAK_LOG_LINE_MAX];
+    if (len >= sizeof(msg)) len = sizeof(msg) - 1U;
+    memcpy(msg, s, len);
+    msg[len] = '\0';
+    ttak_log_bin_entry_t entry = {
+        .level = (ttak_log_level_t)level,
+        .timestamp_ns = ts,
+        .file = NULL,
+        .line = 0,
+        .msg = msg,
+    };
+    if (cb) cb(&entry, user);
+    return true;
+}
+
+/*
+ * Walks the entries of one stream body. With @p collect it only records
+ * definitions; otherwise it delivers messages. Stops at the next stream
+ * header, returned through @p next.
+ */
+static bool ttak_log_bin_walk(ttak_log_bin_dict_t *dict, bool collect, const uint8_t *p, const uint8_t *end,
+                              ttak_log_bin_cb cb, void *user, size_t *records, const uint8_t **next) {
+    while (p < end && !ttak_log_bin_at_magic(p, end)) {
+        uint8_t type = *p++;
+        bool ok;
+        switch (type) {
+            case TTAK_LOG_BIN_DEF:
+                if (collect) {
+                    ok = ttak_log_bin_add_def(dict, &p, end);
+                } else {
+                    ttak_log_bin_raw_def_t skip;
+                    ok = ttak_log_bin_parse_def(&p, end, &skip);
+                }
+                break;
+            case TTAK_LOG_BIN_REC:
+                if (collect) {
+                    uint64_t skip, plen;
+                    ok = ttak_log_get_varint(&p, end, &skip) && ttak_log_get_varint(&p, end, &plen) &&
+                         plen <= (uint64_t)(end - p);
+                    if (ok) p += plen;
+                } else {
+                    ok = ttak_log_bin_put_rec(dict, &p, end, cb, user);
+                    if (ok && records) (*records)++;
+                }
+                break;
+            case TTAK_LOG_BIN_TEXT:
+                if (collect) {
+                    uint8_t level;
+                    uint64_t ts;
+                    const uint8_t *s;
+                    size_t len;
+                    ok = ttak_log_bin_parse_text(&p, end, &level, &ts, &s, &len);
+                } else {
+                    ok = ttak_log_bin_put_text(&p, end, cb, user);
+                    if (ok && records) (*records)++;
+                }
+                break;
+            default:
+                ok = false;
+                break;
+        }
+        if (!ok) return false;
+    }
+    *next = p;
+    return true;
+}
+
+bool ttak_logger_bin_decode(const void *data, size_t len, ttak_log_bin_cb cb, void *user, size_t *records) {
+    const uint8_t *p = data;
+    const uint8_t *end = p + len;
+    if (records) *records = 0;
+    if (!p || !ttak_log_bin_at_magic(p, end)) return false;
+
+    ttak_log_bin_dict_t dict = { NULL, 0 };
+    bool ok = true;
+    while (ok && p < end) {
+        if (!ttak_log_bin_at_magic(p, end)) {
+            ok = false;
+            break;
+        }
+        const uint8_t *body = p + sizeof(ttak_log_bin_magic);
+        const uint8_t *next;
+        /* A damaged tail still lets the records before it through. */
+        bool complete = ttak_log_bin_walk(&dict, true, body, end, NULL, NULL, NULL, &next);
+        ok = ttak_log_bin_walk(&dict, false, body, end, cb, user, records, &next) && complete;
+        ttak_log_bin_dict_clear(&dict);
+        p = next;
+    }
+    ttak_log_bin_dict_clear(&dict);
+    return ok;
+}
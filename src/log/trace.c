@@ -0,0 +1,284 @@
+/**
+ * @file trace.c
+ * @brief Per-thread event rings and the Trace Event JSON dumper.
+ *
+ * Each thread writes into its own ring and only ever moves its own @c head,
+ * so recording is a handful of plain stores plus one release store. Rings
+ * are never freed: a thread that exits marks its ring free and the next new
+ * thread adopts it, which is why every event carries its thread id.
+ */
+
+#include <ttak/log/trace.h>
+#include <ttak/timing/timing.h>
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define trace_getpid() ((long)_getpid())
+#else
+#include <unistd.h>
+#define trace_getpid() ((long)getpid())
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#define TRACE_MASK ((uint64_t)TTAK_TRACE_RING_EVENTS - 1U)
+
+_Static_assert((TTAK_TRACE_RING_EVENTS & (TTAK_TRACE_RING_EVENTS - 1)) == 0,
+               "TTAK_TRACE_RING_EVENTS must be a power of two");
+_Static_assert(sizeof(ttak_trace_event_t) == 32, "trace events are 32 bytes");
+
+_Atomic uint32_t ttak_trace_active = 0;
+
+enum {
+    TTAK_TRACE_RING_FREE = 0,   /**< Left by an exited thread; claimable. */
+    TTAK_TRACE_RING_OWNED       /**< Written by one live thread. */
+};
+
+/**
+ * @brief Single-writer ring. Events in [max(base, head - size), head) are live.
+ */
+typedef struct ttak_trace_ring {
+    _Atomic uint64_t head;              /**< Next event index; only the owner moves it. */
+    _Atomic uint64_t base;              /**< Events below this were discarded by a reset. */
+    uint32_t tid;                       /**< Owner's thread id, refreshed on adoption. */
+    _Atomic int state;
+    struct ttak_trace_ring *next;       /**< Global list; immutable once published. */
+    ttak_trace_event_t events[TTAK_TRACE_RING_EVENTS];
+} ttak_trace_ring_t;
+
+static ttak_trace_ring_t *_Atomic g_trace_rings = NULL;
+static _Thread_local ttak_trace_ring_t *t_trace_ring = NULL;
+
+static pthread_key_t g_trace_exit_key;
+static pthread_once_t g_trace_exit_once = PTHREAD_ONCE_INIT;
+
+static void trace_thread_exit(void *arg) {
+    ttak_trace_ring_t *r = arg;
+    t_trace_ring = NULL;
+    if (r) atomic_store_explicit(&r->state, TTAK_TRACE_RING_FREE, memory_order_release);
+}
+
+static void trace_exit_key_init(void) {
+    pthread_key_create(&g_trace_exit_key, trace_thread_exit);
+}
+
+static uint32_t trace_thread_id(void) {
+#if defined(__linux__) && defined(SYS_gettid)
+    return (uint32_t)syscall(SYS_gettid);
+#else
+    pthread_t self = pthread_self();
+    uint64_t h = 0;
+    memcpy(&h, &self, sizeof(self) < sizeof(h) ? sizeof(self) : sizeof(h));
+    return (uint32_t)(h ^ (h >> 32));
+#endif
+}
+
+static ttak_trace_ring_t *trace_attach(void) {
+    ttak_trace_ring_t *r;
+    for (r = atomic_load_explicit(&g_trace_rings, memory_order_acquire); r; r = r->next) {
+        int expected = TTAK_TRACE_RING_FREE;
+        if (atomic_load_explicit(&r->state, memory_order_relaxed) == TTAK_TRACE_RING_FREE &&
+            atomic_compare_exchange_strong_explicit(&r->state, &expected, TTAK_TRACE_RING_OWNED,
+                                                    memory_order_acq_rel, memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (!r) {
+        r = malloc(sizeof(*r));
+        if (!r) return NULL;
+        atomic_init(&r->head, 0);
+        atomic_init(&r->base, 0);
+        atomic_init(&r->state, TTAK_TRACE_RING_OWNED);
+        ttak_trace_ring_t *head = atomic_load_explicit(&g_trace_rings, memory_order_acquire);
+        do {
+            r->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&g_trace_rings, &head, r,
+                                                        memory_order_release, memory_order_acquire));
+    }
+    r->tid = trace_thread_id();
+    t_trace_ring = r;
+    pthread_once(&g_trace_exit_once, trace_exit_key_init);
+    pthread_setspecific(g_trace_exit_key, r);
+    return r;
+}
+
+void ttak_trace_emit(ttak_trace_kind_t kind, uint64_t a0, uint64_t a1) {
+    ttak_trace_ring_t *r = t_trace_ring;
+    if (TTAK_UNLIKELY(!r)) {
+        r = trace_attach();
+        if (!r) return;
+    }
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    ttak_trace_event_t *e = &r->events[head & TRACE_MASK];
+    e->ts_ns = ttak_get_tick_count_ns();
+    e->a0 = a0;
+    e->a1 = a1;
+    e->kind = (uint16_t)kind;
+    e->reserved = 0;
+    e->tid = r->tid;
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+}
+
+void ttak_trace_start(void) {
+    atomic_store_explicit(&ttak_trace_active, 1, memory_order_release);
+}
+
+void ttak_trace_stop(void) {
+    atomic_store_explicit(&ttak_trace_active, 0, memory_order_release);
+}
+
+int ttak_trace_is_enabled(void) {
+    return atomic_load_explicit(&ttak_trace_active, memory_order_acquire) != 0;
+}
+
+void ttak_trace_reset(void) {
+    for (ttak_trace_ring_t *r = atomic_load_explicit(&g_trace_rings, memory_order_acquire); r; r = r->next) {
+        atomic_store_explicit(&r->base, atomic_load_explicit(&r->head, memory_order_acquire),
+                              memory_order_release);
+    }
+}
+
+/* First live index of @p r given its current @p head. */
+static uint64_t trace_ring_first(ttak_trace_ring_t *r, uint64_t head) {
+    uint64_t base = atomic_load_explicit(&r->base, memory_order_acquire);
+    uint64_t floor = head > TTAK_TRACE_RING_EVENTS ? head - TTAK_TRACE_RING_EVENTS : 0;
+    return base > floor ? base : floor;
+}
+
+size_t ttak_trace_event_count(void) {
+    size_t n = 0;
+    for (ttak_trace_ring_t *r = atomic_load_explicit(&g_trace_rings, memory_order_acquire); r; r = r->next) {
+        uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        n += (size_t)(head - trace_ring_first(r, head));
+    }
+    return n;
+}
+
+/* --- JSON --- */
+
+static const char *trace_source_name(uint64_t src) {
+    switch (src) {
+        case TTAK_TRACE_SRC_EDF:          return "edf";
+        case TTAK_TRACE_SRC_DEQUE:        return "deque";
+        case TTAK_TRACE_SRC_SHARD:        return "shard";
+        case TTAK_TRACE_SRC_WORKER:       return "worker";
+        case TTAK_TRACE_SRC_REMOTE_SHARD: return "remote_shard";
+        default:                          return "unknown";
+    }
+}
+
+static void trace_write_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+/* Common prefix: name, phase, timestamp in microseconds, pid and tid. */
+static void trace_write_head(FILE *out, bool *first, const char *name, const char *ph,
+                             uint64_t ts_ns, long pid, uint32_t tid) {
+    fputs(*first ? "\n" : ",\n", out);
+    *first = false;
+    fputs("{\"name\":", out);
+    trace_write_string(out, name);
+    fprintf(out, ",\"ph\":\"%s\",\"ts\":%" PRIu64 ".%03u,\"pid\":%ld,\"tid\":%" PRIu32,
+            ph, ts_ns / 1000U, (unsigned)(ts_ns % 1000U), pid, tid);
+}
+
+static void trace_write_event(FILE *out, bool *first, long pid, const ttak_trace_event_t *e) {
+    switch (e->kind) {
+        case TTAK_TRACE_TASK_SUBMIT:
+            /* A zero-length slice gives the flow arrow something to start from. */
+            trace_write_head(out, first, "submit", "X", e->ts_ns, pid, e->tid);
+            fprintf(out, ",\"dur\":0,\"cat\":\"task\",\"args\":{\"task\":\"0x%" PRIx64 "\",\"shard\":%" PRIu64 "}}",
+                    e->a0, e->a1);
+            trace_write_head(out, first, "task", "s", e->ts_ns, pid, e->tid);
+            fprintf(out, ",\"cat\":\"task\",\"id\":\"0x%" PRIx64 "\"}", e->a0);
+            break;
+        case TTAK_TRACE_TASK_DEQUEUE:
+        case TTAK_TRACE_TASK_STEAL:
+            trace_write_head(out, first, e->kind == TTAK_TRACE_TASK_STEAL ? "steal" : "dequeue", "i",
+                             e->ts_ns, pid, e->tid);
+            fprintf(out, ",\"s\":\"t\",\"cat\":\"task\",\"args\":{\"task\":\"0x%" PRIx64 "\",\"source\":\"%s\"}}",
+                    e->a0, trace_source_name(e->a1));
+            break;
+        case TTAK_TRACE_TASK_START:
+            trace_write_head(out, first, "task", "B", e->ts_ns, pid, e->tid);
+            fprintf(out, ",\"cat\":\"task\",\"args\":{\"task\":\"0x%" PRIx64 "\"}}", e->a0);
+            trace_write_head(out, first, "task", "f", e->ts_ns, pid, e->tid);
+            fprintf(out, ",\"bp\":\"e\",\"cat\":\"task\",\"id\":\"0x%" PRIx64 "\"}", e->a0);
+            break;
+        case TTAK_TRACE_TASK_END:
+            trace_write_head(out, first, "task", "E", e->ts_ns, pid, e->tid);
+            fputs(",\"cat\":\"task\"}", out);
+            break;
+        case TTAK_TRACE_IO_READY:
+            trace_write_head(out, first, "io_ready", "i", e->ts_ns, pid, e->tid);
+            fprintf(out, ",\"s\":\"t\",\"cat\":\"io\",\"args\":{\"fd\":%" PRId64 ",\"revents\":%" PRIu64 "}}",
+                    (int64_t)e->a0, e->a1);
+            break;
+        case TTAK_TRACE_IO_COMPLETE:
+            trace_write_head(out, first, "io_complete", "i", e->ts_ns, pid, e->tid);
+            fprintf(out, ",\"s\":\"t\",\"cat\":\"io\",\"args\":{\"status\":%" PRIu64 ",\"bytes\":%" PRIu64 "}}",
+                    e->a0, e->a1);
+            break;
+        case TTAK_TRACE_EPOCH_RECLAIM: {
+            /* Recorded at the end of the pass; drawn as the whole pass. */
+            uint64_t dur = e->a1 < e->ts_ns ? e->a1 : e->ts_ns;
+            trace_write_head(out, first, "epoch_reclaim", "X", e->ts_ns - dur, pid, e->tid);
+            fprintf(out, ",\"dur\":%" PRIu64 ".%03u,\"cat\":\"mem\",\"args\":{\"freed\":%" PRIu64 "}}",
+                    dur / 1000U, (unsigned)(dur % 1000U), e->a0);
+            break;
+        }
+        case TTAK_TRACE_LATTICE_COMPACT:
+            trace_write_head(out, first, "lattice_compact", "i", e->ts_ns, pid, e->tid);
+            fprintf(out, ",\"s\":\"t\",\"cat\":\"net\",\"args\":{\"reset\":\"0x%" PRIx64 "\",\"stub\":\"0x%" PRIx64 "\"}}",
+                    e->a0, e->a1);
+            break;
+        case TTAK_TRACE_USER:
+            trace_write_head(out, first, (const char *)(uintptr_t)e->a0, "i", e->ts_ns, pid, e->tid);
+            fprintf(out, ",\"s\":\"t\",\"cat\":\"user\",\"args\":{\"value\":%" PRIu64 "}}", e->a1);
+            break;
+        default:
+            break;
+    }
+}
+
+int ttak_trace_write_json(FILE *out) {
+    if (!out) return -1;
+    ttak_trace_event_t *copy = malloc(sizeof(ttak_trace_event_t) * TTAK_TRACE_RING_EVENTS);
+    if (!copy) return -1;
+    long pid = trace_getpid();
+    bool first = true;
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+    for (ttak_trace_ring_t *r = atomic_load_explicit(&g_trace_rings, memory_order_acquire); r; r = r->next) {
+        uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        uint64_t from = trace_ring_first(r, head);
+        for (uint64_t i = from; i < head; i++) copy[i - from] = r->events[i & TRACE_MASK];
+        /* Anything the owner lapped while we copied is torn; skip it. */
+        uint64_t now_head = atomic_load_explicit(&r->head, memory_order_acquire);
+        uint64_t safe = trace_ring_first(r, now_head);
+        for (uint64_t i = from > safe ? from : safe; i < head; i++) {
+            trace_write_event(out, &first, pid, &copy[i - from]);
+        }
+    }
+    fputs("\n]}\n", out);
+    free(copy);
+    return ferror(out) ? -1 : 0;
+}
@@ -4,6 +4,7 @@
  */
 
 #include <ttak/mask/dynamic_mask.h>
+#include <ttak/arch/ttak_arch.h>
 #include <ttak/mem/mem.h>
 #include <ttak/mem/epoch.h>
 #include <ttak/types/ttak_compiler.h>
@@ -11,10 +12,155 @@
 #include <string.h>
 #include <stdatomic.h>
 
+#if defined(TTAK_HAS_AVX2)
+#  include <immintrin.h>
+#endif
+
+/* Words needed for @p n bits. */
+static size_t words_for(size_t n) {
+    return (n + 63) / 64;
+}
+
+/* Entries (bits) at summary level @p k, i.e. words in the level below. */
+static size_t level_entries(const ttak_dynamic_mask_t *mask, uint32_t k) {
+    size_t n = mask->capacity / 64;
+    for (uint32_t i = 0; i < k; i++) n = words_for(n);
+    return n;
+}
+
+/**
+ * @brief Points the summary levels into @p block past @p words bitmap words.
+ *
+ * @return Total words the block needs; call with NULL to size it.
+ */
+static size_t mask_layout(ttak_dynamic_mask_t *mask, uint64_t *block, size_t words) {
+    size_t used = words;
+    uint32_t k = 0;
+    for (size_t n = words; n > 1 && k < TTAK_DYNAMIC_MASK_LEVELS; k++) {
+        n = words_for(n);
+        if (block) {
+            mask->any[k] = block + used;
+            mask->full[k] = block + used + n;
+        }
+        used += 2 * n;
+    }
+    if (block) mask->levels = k;
+    return used;
+}
+
+/* Mask of the valid bits in word @p w of a level with @p entries bits. */
+static uint64_t valid_bits(size_t entries, size_t w) {
+    size_t rem = entries - w * 64;
+    return rem >= 64 ? ~0ULL : (1ULL << rem) - 1;
+}
+
+/**
+ * @brief Refreshes the summary bits covering bitmap word @p word, stopping
+ *        at the first level where neither bit changes.
+ */
+static void mask_summarize(ttak_dynamic_mask_t *mask, const uint64_t *bits, size_t word) {
+    uint64_t child = bits[word];
+    bool any = child != 0, full = child == ~0ULL;
+    size_t idx = word;
+    for (uint32_t k = 0; k < mask->levels; k++) {
+        size_t w = idx / 64;
+        uint64_t bit = 1ULL << (idx % 64);
+        uint64_t a = any ? mask->any[k][w] | bit : mask->any[k][w] & ~bit;
+        uint64_t f = full ? mask->full[k][w] | bit : mask->full[k][w] & ~bit;
+        if (a == mask->any[k][w] && f == mask->full[k][w]) return;
+        mask->any[k][w] = a;
+        mask->full[k][w] = f;
+        any = a != 0;
+        full = f == valid_bits(level_entries(mask, k), w);
+        idx = w;
+    }
+}
+
+/* Rebuilds every summary level from the bitmap. */
+static void mask_summarize_all(ttak_dynamic_mask_t *mask, const uint64_t *bits) {
+    const uint64_t *below = bits;
+    size_t entries = mask->capacity / 64;
+    for (uint32_t k = 0; k < mask->levels; k++) {
+        size_t n = words_for(entries);
+        memset(mask->any[k], 0, n * sizeof(uint64_t));
+        memset(mask->full[k], 0, n * sizeof(uint64_t));
+        for (size_t i = 0; i < entries; i++) {
+            uint64_t bit = 1ULL << (i % 64);
+            bool full = k == 0 ? below[i] == ~0ULL
+                               : mask->full[k - 1][i] == valid_bits(level_entries(mask, k - 1), i);
+            bool any = k == 0 ? below[i] != 0 : mask->any[k - 1][i] != 0;
+            if (any) mask->any[k][i / 64] |= bit;
+            if (full) mask->full[k][i / 64] |= bit;
+        }
+        below = mask->any[k];
+        entries = n;
+    }
+}
+
+/* Word @p w of level @p k as a search sees it: set bits, or clear bits when @p free. */
+static uint64_t search_word(const ttak_dynamic_mask_t *mask, const uint64_t *bits,
+                            uint32_t k, size_t w, bool free) {
+    if (k == 0) return free ? ~bits[w] : bits[w];
+    if (!free) return mask->any[k - 1][w];
+    return ~mask->full[k - 1][w] & valid_bits(level_entries(mask, k - 1), w);
+}
+
+/**
+ * @brief Finds the first set (or, with @p free, clear) bit at or above
+ *        @p from: climbs while the rest of a word is empty, then descends
+ *        along the lowest marked summary bit.
+ */
+static bool mask_search(const ttak_dynamic_mask_t *mask, const uint64_t *bits,
+                        size_t from, bool free, size_t *out) {
+    size_t i = from;
+    uint32_t k = 0;
+    for (;;) {
+        size_t w = i / 64;
+        size_t len = k == 0 ? mask->capacity / 64 : words_for(level_entries(mask, k - 1));
+        if (w >= len) return false;
+        uint64_t word = search_word(mask, bits, k, w, free) & (~0ULL << (i % 64));
+        if (word) {
+            i = w * 64 + (size_t)__builtin_ctzll(word);
+            break;
+        }
+        if (k == mask->levels) return false;
+        i = w + 1;
+        k++;
+    }
+    while (k > 0) {
+        k--;
+        i = i * 64 + (size_t)__builtin_ctzll(search_word(mask, bits, k, i, free));
+    }
+    *out = i;
+    return true;
+}
+
+/* Popcount of @p n words, 256 bits at a time via nibble lookups where AVX2 exists. */
+static size_t popcount_words(const uint64_t *w, size_t n) {
+    size_t total = 0, i = 0;
+#if defined(TTAK_HAS_AVX2)
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(w + i));
+        __m256i c = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(v, low)),
+                                    _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(c, _mm256_setzero_si256()));
+    }
+    total = (size_t)(_mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+                     _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3));
+#endif
+    for (; i < n; i++) total += (size_t)__builtin_popcountll(w[i]);
+    return total;
+}
+
 void ttak_dynamic_mask_init(ttak_dynamic_mask_t *mask) {
     if (TTAK_UNLIKELY(!mask)) return;
     mask->capacity = 64;
     mask->count = 0;
+    mask->levels = 0;
     uint64_t *initial = (uint64_t *)ttak_dangerous_calloc(1, sizeof(uint64_t));
     atomic_init(&mask->bits, initial);
     ttak_rwlock_init(&mask->lock);
@@ -33,7 +179,8 @@ bool ttak_dynamic_mask_ensure(ttak_dynamic_mask_t *mask, uint32_t bit_idx) {
     uint32_t new_cap = mask->capacity ? mask->capacity : 64;
     while (bit_idx >= new_cap) new_cap *= 2;
 
-    uint64_t *new_bits = (uint64_t *)ttak_dangerous_calloc(new_cap / 64, sizeof(uint64_t));
+    uint64_t *new_bits = (uint64_t *)ttak_dangerous_calloc(mask_layout(mask, NULL, new_cap / 64),
+                                                            sizeof(uint64_t));
     if (TTAK_UNLIKELY(!new_bits)) return false;
 
     uint64_t *old_bits = atomic_load(&mask->bits);
@@ -42,6 +189,8 @@ bool ttak_dynamic_mask_ensure(ttak_dynamic_mask_t *mask, uint32_t bit_idx) {
     }
 
     mask->capacity = new_cap;
+    mask_layout(mask, new_bits, new_cap / 64);
+    mask_summarize_all(mask, new_bits);
     atomic_store_explicit(&mask->bits, new_bits, memory_order_release);
     
     if (TTAK_LIKELY(old_bits)) {
@@ -65,6 +214,7 @@ bool ttak_dynamic_mask_set(ttak_dynamic_mask_t *mask, uint32_t bit_idx) {
     if (!(bits[word] & (1ULL << bit))) {
         bits[word] |= (1ULL << bit);
         mask->count++;
+        mask_summarize(mask, bits, word);
     }
 
     ttak_rwlock_unlock(&mask->lock);
@@ -85,6 +235,7 @@ void ttak_dynamic_mask_clear(ttak_dynamic_mask_t *mask, uint32_t bit_idx) {
     if (bits[word] & (1ULL << bit)) {
         bits[word] &= ~(1ULL << bit);
         mask->count--;
+        mask_summarize(mask, bits, word);
     }
 
     ttak_rwlock_unlock(&mask->lock);
@@ -104,3 +255,73 @@ bool ttak_dynamic_mask_test(ttak_dynamic_mask_t *mask, uint32_t bit_idx) {
     if (TTAK_UNLIKELY(bit_idx >= cap)) return false;
     return (bits[bit_idx / 64] & (1ULL << (bit_idx % 64))) != 0;
 }
+
+bool ttak_dynamic_mask_find_next(ttak_dynamic_mask_t *mask, uint32_t from, uint32_t *out) {
+    ttak_rwlock_rdlock(&mask->lock);
+    size_t idx = 0;
+    bool found = mask_search(mask, atomic_load(&mask->bits), from, false, &idx);
+    ttak_rwlock_unlock(&mask->lock);
+    if (found && out) *out = (uint32_t)idx;
+    return found;
+}
+
+bool ttak_dynamic_mask_find_first(ttak_dynamic_mask_t *mask, uint32_t *out) {
+    return ttak_dynamic_mask_find_next(mask, 0, out);
+}
+
+bool ttak_dynamic_mask_find_first_free(ttak_dynamic_mask_t *mask, uint32_t *out) {
+    ttak_rwlock_rdlock(&mask->lock);
+    size_t idx = 0;
+    bool found = mask_search(mask, atomic_load(&mask->bits), 0, true, &idx);
+    ttak_rwlock_unlock(&mask->lock);
+    if (found && out) *out = (uint32_t)idx;
+    return found;
+}
+
+bool ttak_dynamic_mask_claim_first_free(ttak_dynamic_mask_t *mask, uint32_t *out) {
+    ttak_rwlock_wrlock(&mask->lock);
+    size_t idx = 0;
+    if (!mask_search(mask, atomic_load(&mask->bits), 0, true, &idx)) {
+        idx = mask->capacity;
+        if (TTAK_UNLIKELY(idx == 0 || !ttak_dynamic_mask_ensure(mask, (uint32_t)idx))) {
+            ttak_rwlock_unlock(&mask->lock);
+            return false;
+        }
+    }
+
+    uint64_t *bits = atomic_load(&mask->bits);
+    bits[idx / 64] |= 1ULL << (idx % 64);
+    mask->count++;
+    mask_summarize(mask, bits, idx / 64);
+    ttak_rwlock_unlock(&mask->lock);
+    if (out) *out = (uint32_t)idx;
+    return true;
+}
+
+size_t ttak_dynamic_mask_count_range(ttak_dynamic_mask_t *mask, uint32_t begin, uint32_t end) {
+    ttak_rwlock_rdlock(&mask->lock);
+    if (end > mask->capacity) end = mask->capacity;
+    size_t total = 0;
+    if (begin < end) {
+        const uint64_t *bits = atomic_load(&mask->bits);
+        size_t first = begin / 64, last = (end - 1) / 64;
+        uint64_t head = ~0ULL << (begin % 64);
+        uint64_t tail = end % 64 ? (1ULL << (end % 64)) - 1 : ~0ULL;
+        if (first == last) {
+            total = (size_t)__builtin_popcountll(bits[first] & head & tail);
+        } else {
+            total = (size_t)__builtin_popcountll(bits[first] & head) +
+                    popcount_words(bits + first + 1, last - first - 1) +
+                    (size_t)__builtin_popcountll(bits[last] & tail);
+        }
+    }
+    ttak_rwlock_unlock(&mask->lock);
+    return total;
+}
+
+uint32_t ttak_dynamic_mask_count(ttak_dynamic_mask_t *mask) {
+    ttak_rwlock_rdlock(&mask->lock);
+    uint32_t count = mask->count;
+    ttak_rwlock_unlock(&mask->lock);
+    return count;
+}
@@ -1,4 +1,5 @@
 #include <ttak/math/bigcomplex.h>
+#include <ttak/math/fft.h>
 #include <ttak/mem/mem.h>
 
 /**
@@ -41,3 +42,39 @@ _Bool ttak_bigcomplex_add(ttak_bigcomplex_t *dst, const ttak_bigcomplex_t *lhs,
     }
     return true;
 }
+
+/**
+ * @brief Transform @p n complex numbers in place through the double FFT.
+ *
+ * @param v       Values to transform.
+ * @param n       Count, a power of two.
+ * @param inverse Run the inverse transform, scaled by 1/n.
+ * @param now     Timestamp for memory tracking.
+ * @return true on success, false on a bad length, overflow or allocation failure.
+ */
+_Bool ttak_bigcomplex_fft(ttak_bigcomplex_t *v, size_t n, _Bool inverse, uint64_t now) {
+    const ttak_fft_plan_t *plan = ttak_fft_plan_get(n, now);
+    if (!plan) return false;
+    double *re = ttak_mem_alloc_lite(2 * n * sizeof(double), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    if (!re) return false;
+    double *im = re + n;
+    _Bool ok = true;
+    for (size_t i = 0; i < n && ok; i++) {
+        ok = ttak_bigreal_to_double(&v[i].real, &re[i]) && ttak_bigreal_to_double(&v[i].imag, &im[i]);
+    }
+    if (ok) {
+        /* The plans leave the spectrum bit-reversed; callers get natural order. */
+        if (inverse) {
+            ttak_fft_bit_reverse(re, im, n);
+            ttak_fft_plan_inverse(plan, re, im);
+        } else {
+            ttak_fft_plan_forward(plan, re, im);
+            ttak_fft_bit_reverse(re, im, n);
+        }
+        for (size_t i = 0; i < n && ok; i++) {
+            ok = ttak_bigreal_set_double(&v[i].real, re[i], now) && ttak_bigreal_set_double(&v[i].imag, im[i], now);
+        }
+    }
+    ttak_mem_free_lite(re);
+    return ok;
+}
@@ -1,11 +1,18 @@
 #include <ttak/math/bigint.h>
+#include <ttak/async/sched.h>
 #include <ttak/math/bigint_accel.h>
+#include <ttak/math/limbs.h>
 #include <ttak/mem/mem.h>
 #include "../../internal/app_types.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 
+#define TTAK_BIGINT_BASE_BITS TTAK_BIGINT_LIMB_BITS
+
+/* The GPU backends exchange 32-bit limbs. */
+#define TTAK_BIGINT_USE_ACCEL (TTAK_BIGINT_LIMB_BITS == 32)
+
 /**
  * @brief Retrieve a mutable pointer to the limb storage.
  *
@@ -56,12 +63,11 @@ static _Bool ensure_capacity(ttak_bigint_t *bi, size_t required, uint64_t now) {
     if (bi->is_dynamic) {
         new_buf = ttak_mem_realloc_raw(bi->data.dyn_ptr, new_size, __TTAK_UNSAFE_MEM_FOREVER__, now);
     } else {
-        new_buf = ttak_mem_dup_raw(bi->data.sso_buf, bi->used * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        /* The whole new capacity is allocated; only the used SSO limbs carry over. */
+        new_buf = ttak_mem_alloc_raw(new_size, __TTAK_UNSAFE_MEM_FOREVER__, now);
         if (new_buf) {
-            /* If we duped but requested more than was in SSO, zero the rest */
-            if (new_capacity > bi->used) {
-                 memset(new_buf + bi->used, 0, (new_capacity - bi->used) * sizeof(limb_t));
-            }
+            memcpy(new_buf, bi->data.sso_buf, bi->used * sizeof(limb_t));
+            memset(new_buf + bi->used, 0, (new_capacity - bi->used) * sizeof(limb_t));
         }
     }
 
@@ -91,6 +97,104 @@ static void trim_unused(ttak_bigint_t *bi) {
     }
 }
 
+/*
+ * Per-thread scratch for operands and products that cannot be written
+ * straight into the destination. Frames are taken and given back in stack
+ * order, so a nested call (division calling multiplication) just stacks on
+ * top. The arena only grows while no frame is live; a request that does
+ * not fit beside live frames, or exceeds TTAK_BIGINT_SCRATCH_RETAIN_LIMBS,
+ * goes to the heap for that call alone.
+ */
+typedef struct bigint_scratch {
+    limb_t *base;
+    size_t  capacity;
+    size_t  top;
+} bigint_scratch_t;
+
+static _Thread_local bigint_scratch_t t_scratch;
+
+typedef struct scratch_frame {
+    limb_t *limbs;
+    size_t  mark;
+    bool    heap;
+} scratch_frame_t;
+
+/**
+ * @brief Take @p count limbs of scratch for the calling thread.
+ *
+ * @return Pointer to the limbs, or NULL on allocation failure.
+ */
+static limb_t *scratch_take(scratch_frame_t *frame, size_t count, uint64_t now) {
+    bigint_scratch_t *sc = &t_scratch;
+    frame->mark = sc->top;
+    frame->heap = false;
+    if (count <= sc->capacity - sc->top) {
+        frame->limbs = sc->base + sc->top;
+        sc->top += count;
+        return frame->limbs;
+    }
+    if (sc->top == 0 && count <= TTAK_BIGINT_SCRATCH_RETAIN_LIMBS) {
+        size_t cap = sc->capacity ? sc->capacity : TTAK_BIGINT_SSO_LIMIT * 16;
+        while (cap < count) cap *= 2;
+        if (cap > TTAK_BIGINT_SCRATCH_RETAIN_LIMBS) cap = TTAK_BIGINT_SCRATCH_RETAIN_LIMBS;
+        limb_t *grown = ttak_mem_alloc_raw(cap * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (grown) {
+            if (sc->base) ttak_mem_free(sc->base);
+            sc->base = grown;
+            sc->capacity = cap;
+            sc->top = count;
+            frame->limbs = grown;
+            return grown;
+        }
+    }
+    frame->heap = true;
+    frame->limbs = ttak_mem_alloc_raw(count * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    return frame->limbs;
+}
+
+/**
+ * @brief Give back a frame taken by scratch_take().
+ */
+static void scratch_give(scratch_frame_t *frame) {
+    if (!frame->limbs) return;
+    if (frame->heap) {
+        ttak_mem_free(frame->limbs);
+    } else {
+        t_scratch.top = frame->mark;
+    }
+    frame->limbs = NULL;
+}
+
+/**
+ * @brief Free the calling thread's bigint scratch arena.
+ *
+ * Worker threads that ran bigint arithmetic call this before exiting; the
+ * arena is rebuilt on the next operation that needs it.
+ */
+void ttak_bigint_scratch_release(void) {
+    bigint_scratch_t *sc = &t_scratch;
+    if (sc->top != 0) return;
+    if (sc->base) ttak_mem_free(sc->base);
+    sc->base = NULL;
+    sc->capacity = 0;
+}
+
+/**
+ * @brief Compare the magnitudes of two big integers, ignoring sign.
+ */
+static int cmp_abs(const ttak_bigint_t *lhs, const ttak_bigint_t *rhs) {
+    const limb_t *l = get_const_limbs(lhs);
+    const limb_t *r = get_const_limbs(rhs);
+    size_t ln = lhs->used, rn = rhs->used;
+    while (ln > 0 && l[ln - 1] == 0) ln--;
+    while (rn > 0 && r[rn - 1] == 0) rn--;
+    if (ln != rn) return ln > rn ? 1 : -1;
+    for (size_t i = ln; i > 0; --i) {
+        if (l[i - 1] != r[i - 1]) return l[i - 1] > r[i - 1] ? 1 : -1;
+    }
+    return 0;
+}
+
 /**
  * @brief Initialize a big integer with zero value using SSO storage.
  *
@@ -147,89 +251,79 @@ void ttak_bigint_free(ttak_bigint_t *bi, uint64_t now) {
 }
 
 /**
- * @brief Assign an unsigned 64-bit value to the big integer.
+ * @brief Store @p count 64-bit words, least significant first.
  *
  * @param bi    Destination integer.
- * @param value Value to copy.
+ * @param words Value to store.
+ * @param count Number of words.
  * @param now   Timestamp for potential reallocations.
  * @return true on success, false on allocation failure.
  */
-_Bool ttak_bigint_set_u64(ttak_bigint_t *bi, uint64_t value, uint64_t now) {
+static _Bool set_words(ttak_bigint_t *bi, const uint64_t *words, size_t count, uint64_t now) {
+    const size_t per_word = 64 / TTAK_BIGINT_BASE_BITS;
+    size_t needed_limbs = count * per_word;
+    limb_t limbs_tmp[4 * (64 / TTAK_BIGINT_BASE_BITS)];
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t word = words[i];
+        for (size_t k = 0; k < per_word; ++k) {
+            limbs_tmp[i * per_word + k] = (limb_t)word;
+            word = per_word > 1 ? word >> (TTAK_BIGINT_BASE_BITS % 64) : 0;
+        }
+    }
+    while (needed_limbs > 0 && limbs_tmp[needed_limbs - 1] == 0) {
+        needed_limbs--;
+    }
     bi->is_negative = false;
-    if (value == 0) {
+    if (needed_limbs == 0) {
         bi->used = 0;
         return true;
     }
-
-    size_t needed_limbs = (value > 0xFFFFFFFFu) ? 2 : 1;
     if (!ensure_capacity(bi, needed_limbs, now)) {
         return false;
     }
-
-    limb_t *limbs = get_limbs(bi);
-    if (needed_limbs == 1) {
-        limbs[0] = (limb_t)value;
-        bi->used = 1;
-    } else {
-        limbs[0] = (limb_t)(value & 0xFFFFFFFFu);
-        limbs[1] = (limb_t)(value >> 32);
-        bi->used = 2;
-    }
+    memcpy(get_limbs(bi), limbs_tmp, needed_limbs * sizeof(limb_t));
+    bi->used = needed_limbs;
     return true;
 }
 
-_Bool ttak_bigint_set_u128(ttak_bigint_t *bi, ttak_u128_t value, uint64_t now) {
-    bi->is_negative = false;
-    if (ttak_u128_is_zero(value)) {
-        bi->used = 0;
-        return true;
-    }
-
-    size_t needed_limbs = 0;
-    if (value.hi != 0) {
-        needed_limbs = 4;
-    } else if (value.lo > 0xFFFFFFFFu) {
-        needed_limbs = 2;
-    } else {
-        needed_limbs = 1;
+/**
+ * @brief Read the value as @p count 64-bit words, least significant first.
+ *
+ * @return true if the magnitude fits, false otherwise (the words are zeroed).
+ */
+static bool export_words(const ttak_bigint_t *bi, uint64_t *words, size_t count) {
+    const size_t per_word = 64 / TTAK_BIGINT_BASE_BITS;
+    memset(words, 0, count * sizeof(*words));
+    if (!bi) return false;
+    const limb_t *limbs = get_const_limbs(bi);
+    size_t used = bi->used;
+    while (used > 0 && limbs[used - 1] == 0) used--;
+    if (bi->is_negative || used > count * per_word) return false;
+    for (size_t i = 0; i < used; ++i) {
+        words[i / per_word] |= (uint64_t)limbs[i] << ((i % per_word) * TTAK_BIGINT_BASE_BITS);
     }
+    return true;
+}
 
-    if (!ensure_capacity(bi, needed_limbs, now)) {
-        return false;
-    }
+/**
+ * @brief Assign an unsigned 64-bit value to the big integer.
+ *
+ * @param bi    Destination integer.
+ * @param value Value to copy.
+ * @param now   Timestamp for potential reallocations.
+ * @return true on success, false on allocation failure.
+ */
+_Bool ttak_bigint_set_u64(ttak_bigint_t *bi, uint64_t value, uint64_t now) {
+    return set_words(bi, &value, 1, now);
+}
 
-    limb_t *limbs = get_limbs(bi);
-    limbs[0] = (limb_t)(value.lo & 0xFFFFFFFFu);
-    if (needed_limbs > 1) limbs[1] = (limb_t)(value.lo >> 32);
-    if (needed_limbs > 2) limbs[2] = (limb_t)(value.hi & 0xFFFFFFFFu);
-    if (needed_limbs > 3) limbs[3] = (limb_t)(value.hi >> 32);
-    bi->used = needed_limbs;
-    return true;
+_Bool ttak_bigint_set_u128(ttak_bigint_t *bi, ttak_u128_t value, uint64_t now) {
+    uint64_t words[2] = { value.lo, value.hi };
+    return set_words(bi, words, 2, now);
 }
 
 _Bool ttak_bigint_set_u256(ttak_bigint_t *bi, ttak_u256_t value, uint64_t now) {
-    bi->is_negative = false;
-    limb_t words[8];
-    for (int i = 0; i < 4; ++i) {
-        uint64_t chunk = value.limb[i];
-        words[i * 2] = (limb_t)(chunk & 0xFFFFFFFFu);
-        words[i * 2 + 1] = (limb_t)(chunk >> 32);
-    }
-    size_t needed_limbs = 8;
-    while (needed_limbs > 0 && words[needed_limbs - 1] == 0) {
-        needed_limbs--;
-    }
-    if (needed_limbs == 0) {
-        bi->used = 0;
-        return true;
-    }
-    if (!ensure_capacity(bi, needed_limbs, now)) {
-        return false;
-    }
-    limb_t *limbs = get_limbs(bi);
-    memcpy(limbs, words, needed_limbs * sizeof(limb_t));
-    bi->used = needed_limbs;
-    return true;
+    return set_words(bi, value.limb, 4, now);
 }
 
 /**
@@ -250,6 +344,34 @@ _Bool ttak_bigint_copy(ttak_bigint_t *dst, const ttak_bigint_t *src, uint64_t no
     return true;
 }
 
+/**
+ * @brief Assign a non-negative value from a limb array.
+ *
+ * @param bi     Destination big integer.
+ * @param limbs  Limbs to copy, least significant first.
+ * @param count  Number of limbs.
+ * @param now    Timestamp used for reallocations.
+ * @return true on success, false otherwise.
+ */
+_Bool ttak_bigint_set_limbs(ttak_bigint_t *bi, const limb_t *limbs, size_t count, uint64_t now) {
+    while (count > 0 && limbs[count - 1] == 0) count--;
+    if (!ensure_capacity(bi, count, now)) return false;
+    memmove(get_limbs(bi), limbs, count * sizeof(limb_t));
+    bi->used = count;
+    bi->is_negative = false;
+    return true;
+}
+
+/**
+ * @brief Expose the limb storage for read-only access.
+ *
+ * @param bi Big integer to inspect.
+ * @return Pointer to bi->used limbs.
+ */
+const limb_t *ttak_bigint_limbs(const ttak_bigint_t *bi) {
+    return get_const_limbs(bi);
+}
+
 /**
  * @brief Compare two big integers.
  *
@@ -322,119 +444,118 @@ bool ttak_bigint_is_zero(const ttak_bigint_t *bi) {
 }
 
 /**
- * @brief Add two big integers.
- *
- * @param dst Destination for the result.
- * @param lhs Left operand.
- * @param rhs Right operand.
- * @param now Timestamp for potential allocations.
- * @return true on success, false on allocation failure.
+ * @brief dst = |lhs| + |rhs| with the sign @p negative.
  */
-_Bool ttak_bigint_add(ttak_bigint_t *dst, const ttak_bigint_t *lhs, const ttak_bigint_t *rhs, uint64_t now) {
-    if (lhs->is_negative != rhs->is_negative) {
-        // Subtraction case
-        if (lhs->is_negative) { // (-a) + b == b - a
-            return ttak_bigint_sub(dst, rhs, lhs, now);
-        } else { // a + (-b) == a - b
-            return ttak_bigint_sub(dst, lhs, rhs, now);
-        }
-    }
-
-    size_t max_used = lhs->used > rhs->used ? lhs->used : rhs->used;
+static _Bool add_magnitudes(ttak_bigint_t *dst, const ttak_bigint_t *lhs, const ttak_bigint_t *rhs, bool negative,
+                            uint64_t now) {
+    size_t l_used = lhs->used, r_used = rhs->used;
+    size_t max_used = l_used > r_used ? l_used : r_used;
     if (!ensure_capacity(dst, max_used + 1, now)) return false;
     const limb_t *l = get_const_limbs(lhs);
     const limb_t *r = get_const_limbs(rhs);
     limb_t *d = get_limbs(dst);
 
-    if (ttak_bigint_accel_available() && max_used >= ttak_bigint_accel_min_limbs()) {
+    if (TTAK_BIGINT_USE_ACCEL && ttak_bigint_accel_available() && max_used >= ttak_bigint_accel_min_limbs()) {
         size_t out_used = 0;
-        if (ttak_bigint_accel_add_raw(d, dst->capacity, &out_used,
-                                      l, lhs->used, r, rhs->used)) {
+        if (ttak_bigint_accel_add_raw(d, dst->capacity, &out_used, l, l_used, r, r_used)) {
             dst->used = out_used;
-            dst->is_negative = lhs->is_negative;
+            dst->is_negative = negative;
             trim_unused(dst);
             return true;
         }
     }
 
-    uint64_t carry = 0;
-    size_t i = 0;
+    /* Add the common part, then run the carry through the longer operand. */
+    const limb_t *longer = l_used >= r_used ? l : r;
+    size_t common = l_used < r_used ? l_used : r_used;
+    limb_t carry = ttak_limbs_add_n(d, l, r, common);
+    size_t i = common;
     for (; i < max_used; ++i) {
-        uint64_t sum = carry;
-        if (i < lhs->used) sum += l[i];
-        if (i < rhs->used) sum += r[i];
-        d[i] = (limb_t)sum;
-        carry = sum >> 32;
+        limb_t sum = longer[i] + carry;
+        carry = sum < carry;
+        d[i] = sum;
     }
     if (carry) {
-        d[i++] = (limb_t)carry;
+        d[i++] = carry;
+    }
+    dst->used = i;
+    dst->is_negative = negative;
+    trim_unused(dst);
+    return true;
+}
+
+/**
+ * @brief dst = |big| - |small| with the sign @p negative; |big| must not be below |small|.
+ */
+static _Bool sub_magnitudes(ttak_bigint_t *dst, const ttak_bigint_t *big, const ttak_bigint_t *small, bool negative,
+                            uint64_t now) {
+    size_t b_used = big->used, s_used = small->used;
+    const limb_t *s_limbs = get_const_limbs(small);
+    while (s_used > 0 && s_limbs[s_used - 1] == 0) s_used--;
+    if (!ensure_capacity(dst, b_used, now)) return false;
+
+    limb_t *d = get_limbs(dst);
+    const limb_t *l = get_const_limbs(big);
+    const limb_t *r = get_const_limbs(small);
+
+    limb_t borrow = ttak_limbs_sub_n(d, l, r, s_used);
+    size_t i = s_used;
+    for (; i < b_used; ++i) {
+        limb_t li = l[i];
+        d[i] = li - borrow;
+        borrow = li < borrow;
     }
     dst->used = i;
-    dst->is_negative = lhs->is_negative;
+    dst->is_negative = negative;
     trim_unused(dst);
     return true;
 }
 
+/**
+ * @brief dst = lhs + rhs where the operands carry the signs @p l_neg and @p r_neg.
+ */
+static _Bool add_signed(ttak_bigint_t *dst, const ttak_bigint_t *lhs, bool l_neg, const ttak_bigint_t *rhs,
+                        bool r_neg, uint64_t now) {
+    if (l_neg == r_neg) return add_magnitudes(dst, lhs, rhs, l_neg, now);
+    int cmp = cmp_abs(lhs, rhs);
+    if (cmp == 0) return ttak_bigint_set_u64(dst, 0, now);
+    if (cmp > 0) return sub_magnitudes(dst, lhs, rhs, l_neg, now);
+    return sub_magnitudes(dst, rhs, lhs, r_neg, now);
+}
+
+/**
+ * @brief Add two big integers.
+ *
+ * @param dst Destination for the result; may alias either operand.
+ * @param lhs Left operand.
+ * @param rhs Right operand.
+ * @param now Timestamp for potential allocations.
+ * @return true on success, false on allocation failure.
+ */
+_Bool ttak_bigint_add(ttak_bigint_t *dst, const ttak_bigint_t *lhs, const ttak_bigint_t *rhs, uint64_t now) {
+    return add_signed(dst, lhs, lhs->is_negative, rhs, rhs->is_negative, now);
+}
+
 /**
  * @brief Subtract rhs from lhs and store in dst.
  *
- * @param dst Destination big integer.
+ * @param dst Destination big integer; may alias either operand.
  * @param lhs Minuend.
  * @param rhs Subtrahend.
  * @param now Timestamp for allocations.
  * @return true on success, false otherwise.
  */
 _Bool ttak_bigint_sub(ttak_bigint_t *dst, const ttak_bigint_t *lhs, const ttak_bigint_t *rhs, uint64_t now) {
-    if (lhs->is_negative != rhs->is_negative) {
-        // Addition case
-        if (lhs->is_negative) { // (-a) - b == -(a + b)
-            _Bool ok = ttak_bigint_add(dst, lhs, rhs, now);
-            if (ok) dst->is_negative = true;
-            return ok;
-        } else { // a - (-b) == a + b
-            return ttak_bigint_add(dst, lhs, rhs, now);
-        }
-    }
-
-    // Same signs: a - b or (-a) - (-b) == b - a
-    const ttak_bigint_t *a = lhs, *b = rhs;
-    if (lhs->is_negative) { // Switch for (-a) - (-b)
-        a = rhs; b = lhs;
-    }
-
-    int cmp = ttak_bigint_cmp(a, b);
-    if (cmp == 0) {
-        return ttak_bigint_set_u64(dst, 0, now);
-    }
-
-    bool result_is_negative = (cmp < 0);
-    if (result_is_negative) {
-        const ttak_bigint_t *tmp = a; a = b; b = tmp;
-    }
-
-    if (!ensure_capacity(dst, a->used, now)) return false;
-
-    limb_t *d = get_limbs(dst);
-    const limb_t *l = get_const_limbs(a);
-    const limb_t *r = get_const_limbs(b);
-
-    uint64_t borrow = 0;
-    size_t i = 0;
-    for (; i < a->used; ++i) {
-        uint64_t diff = (uint64_t)l[i] - borrow;
-        if (i < b->used) diff -= r[i];
-        d[i] = (limb_t)diff;
-        borrow = (diff >> 32) & 1;
-    }
-    dst->used = i;
-    dst->is_negative = result_is_negative;
-    trim_unused(dst);
-    return true;
+    bool r_neg = !rhs->is_negative && !ttak_bigint_is_zero(rhs);
+    return add_signed(dst, lhs, lhs->is_negative, rhs, r_neg, now);
 }
 
 /**
  * @brief Multiply two big integers.
  *
+ * Products of operands past TTAK_LIMBS_NTT_PARALLEL_THRESHOLD limbs run
+ * on ttak_async_pool() when ttak_async_init() has been called.
+ *
  * @param dst Destination for the product.
  * @param lhs Left operand.
  * @param rhs Right operand.
@@ -447,59 +568,56 @@ _Bool ttak_bigint_mul(ttak_bigint_t *dst, const ttak_bigint_t *lhs, const ttak_b
     }
 
     size_t needed = lhs->used + rhs->used;
-    ttak_bigint_t tmp;
-    ttak_bigint_init(&tmp, now);
-    if (!ensure_capacity(&tmp, needed, now)) {
-        ttak_bigint_free(&tmp, now);
+    size_t l_used = lhs->used, r_used = rhs->used;
+    bool negative = lhs->is_negative != rhs->is_negative;
+    bool aliased = dst == lhs || dst == rhs;
+
+    /*
+     * A distinct destination takes the product directly. An aliased one
+     * gets it through a stack buffer when it fits the inline limbs and
+     * through the thread's scratch arena otherwise.
+     */
+    limb_t small[TTAK_BIGINT_SSO_LIMIT];
+    scratch_frame_t frame = { NULL, 0, false };
+    limb_t *t;
+    size_t t_cap = needed;
+    if (!aliased) {
+        if (!ensure_capacity(dst, needed, now)) return false;
+        t = get_limbs(dst);
+        t_cap = dst->capacity;
+    } else if (needed <= TTAK_BIGINT_SSO_LIMIT) {
+        t = small;
+    } else if (!(t = scratch_take(&frame, needed, now))) {
         return false;
     }
 
-    limb_t *t = get_limbs(&tmp);
     const limb_t *l = get_const_limbs(lhs);
     const limb_t *r = get_const_limbs(rhs);
+    size_t out_used = needed;
+    bool done = false;
 
-    bool attempted_accel = false;
-    if (ttak_bigint_accel_available()) {
+    if (TTAK_BIGINT_USE_ACCEL && ttak_bigint_accel_available()) {
         size_t threshold = ttak_bigint_accel_min_limbs();
-        if (lhs->used >= threshold || rhs->used >= threshold || needed >= threshold) {
-            size_t out_used = 0;
-            if (ttak_bigint_accel_mul_raw(t, tmp.capacity, &out_used, l, lhs->used, r, rhs->used)) {
-                tmp.used = out_used;
-                tmp.is_negative = lhs->is_negative != rhs->is_negative;
-                trim_unused(&tmp);
-                _Bool ok = ttak_bigint_copy(dst, &tmp, now);
-                ttak_bigint_free(&tmp, now);
-                return ok;
-            }
-            attempted_accel = true;
+        if (l_used >= threshold || r_used >= threshold || needed >= threshold) {
+            done = ttak_bigint_accel_mul_raw(t, t_cap, &out_used, l, l_used, r, r_used);
         }
     }
 
-    (void)attempted_accel;
-    memset(t, 0, needed * sizeof(limb_t));
-    for (size_t i = 0; i < lhs->used; ++i) {
-        uint64_t carry = 0;
-        for (size_t j = 0; j < rhs->used; ++j) {
-            uint64_t prod = (uint64_t)l[i] * r[j] + t[i+j] + carry;
-            t[i+j] = (limb_t)prod;
-            carry = prod >> 32;
-        }
-        size_t k = i + rhs->used;
-        while (carry && k < needed) {
-            uint64_t sum = (uint64_t)t[k] + carry;
-            t[k] = (limb_t)sum;
-            carry = sum >> 32;
-            k++;
-        }
+    if (!done && !ttak_limbs_mul_parallel(t, l, l_used, r, r_used, ttak_async_pool(), now)) {
+        if (aliased) scratch_give(&frame);
+        return false;
     }
 
-    tmp.used = needed;
-    tmp.is_negative = lhs->is_negative != rhs->is_negative;
-    trim_unused(&tmp);
-    
-    _Bool ok = ttak_bigint_copy(dst, &tmp, now);
-    ttak_bigint_free(&tmp, now);
-    return ok;
+    if (aliased) {
+        bool ok = ensure_capacity(dst, out_used, now);
+        if (ok) memcpy(get_limbs(dst), t, out_used * sizeof(limb_t));
+        scratch_give(&frame);
+        if (!ok) return false;
+    }
+    dst->used = out_used;
+    dst->is_negative = negative;
+    trim_unused(dst);
+    return true;
 }
 
 /**
@@ -522,6 +640,15 @@ _Bool ttak_bigint_div_u64(ttak_bigint_t *q, ttak_bigint_t *r, const ttak_bigint_
         return true;
     }
 
+    // A divisor wider than a limb goes through long division.
+    if (d > (limb_t)-1) {
+        ttak_bigint_t d_bi;
+        ttak_bigint_init_u64(&d_bi, d, now);
+        _Bool ok = ttak_bigint_div(q, r, n, &d_bi, now);
+        ttak_bigint_free(&d_bi, now);
+        return ok;
+    }
+
     // Handle division by 1
     if (d == 1) {
         if (q) ttak_bigint_copy(q, n, now);
@@ -532,43 +659,29 @@ _Bool ttak_bigint_div_u64(ttak_bigint_t *q, ttak_bigint_t *r, const ttak_bigint_
     // Determine signs
     bool q_neg = n->is_negative; // d is always positive (uint64_t)
     bool r_neg = n->is_negative;
-
-    // Use absolute value of n for calculation
-    ttak_bigint_t n_abs;
-    ttak_bigint_init_copy(&n_abs, n, now);
-    n_abs.is_negative = false;
-
-    // If dividend is smaller than divisor, quotient is 0, remainder is dividend
-    if (ttak_bigint_cmp_u64(&n_abs, d) < 0) {
-        if (q) ttak_bigint_set_u64(q, 0, now);
-        if (r) ttak_bigint_copy(r, n, now); // Remainder keeps original sign
-        ttak_bigint_free(&n_abs, now);
-        return true;
-    }
-
-    // Prepare quotient (q)
-    if (q) {
-        if (!ensure_capacity(q, n_abs.used, now)) {
-            ttak_bigint_free(&n_abs, now);
-            return false;
-        }
-        q->used = n_abs.used;
-        memset(get_limbs(q), 0, q->capacity * sizeof(limb_t));
-    }
+    size_t n_used = n->used;
+
+    /*
+     * Long division runs from the top limb down and reads each dividend
+     * limb before writing the quotient limb at the same index, so q may
+     * alias n without a copy.
+     */
+    if (q && !ensure_capacity(q, n_used, now)) return false;
     limb_t *q_limbs = q ? get_limbs(q) : NULL;
-    const limb_t *n_limbs = get_const_limbs(&n_abs);
+    const limb_t *n_limbs = get_const_limbs(n);
 
-    uint64_t remainder = 0; // Current remainder for long division
-    for (size_t i = n_abs.used; i > 0; --i) {
-        remainder = (remainder << 32) | n_limbs[i-1];
+    limb_t remainder = 0; // Current remainder for long division, always below d
+    for (size_t i = n_used; i > 0; --i) {
+        ttak_dlimb_t cur = ((ttak_dlimb_t)remainder << TTAK_BIGINT_BASE_BITS) | n_limbs[i-1];
         if (q_limbs) {
-            q_limbs[i-1] = (limb_t)(remainder / d);
+            q_limbs[i-1] = (limb_t)(cur / d);
         }
-        remainder %= d;
+        remainder = (limb_t)(cur % d);
     }
 
     // Set quotient and remainder
     if (q) {
+        q->used = n_used;
         q->is_negative = q_neg;
         trim_unused(q);
     }
@@ -576,8 +689,6 @@ _Bool ttak_bigint_div_u64(ttak_bigint_t *q, ttak_bigint_t *r, const ttak_bigint_
         ttak_bigint_set_u64(r, remainder, now);
         r->is_negative = r_neg;
     }
-    
-ttak_bigint_free(&n_abs, now);
     return true;
 }
 
@@ -628,45 +739,33 @@ _Bool ttak_bigint_mul_u64(ttak_bigint_t *dst, const ttak_bigint_t *lhs, uint64_t
         return ttak_bigint_copy(dst, lhs, now);
     }
 
-    size_t rhs_used = (rhs > 0xFFFFFFFFu) ? 2 : 1;
-    size_t needed = lhs->used + rhs_used;
-    
-    // Use a temporary limb buffer to handle in-place multiplication safely
-    limb_t *d = ttak_mem_alloc_raw(needed * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-    if (!d) return false;
-    memset(d, 0, needed * sizeof(limb_t));
-
-    const limb_t *l = get_const_limbs(lhs);
-    limb_t rhs_limbs[2] = {(limb_t)rhs, (limb_t)(rhs >> 32)};
-
-    for (size_t i = 0; i < lhs->used; ++i) {
-        uint64_t carry = 0;
-        for (size_t j = 0; j < rhs_used; ++j) {
-            uint64_t prod = (uint64_t)l[i] * rhs_limbs[j] + d[i+j] + carry;
-            d[i+j] = (limb_t)prod;
-            carry = prod >> 32;
-        }
-        size_t k = i + rhs_used;
-        while (carry && k < needed) {
-            uint64_t sum = (uint64_t)d[k] + carry;
-            d[k] = (limb_t)sum;
-            carry = sum >> 32;
-            k++;
-        }
+    limb_t rhs_limbs[64 / TTAK_BIGINT_BASE_BITS];
+    size_t rhs_used = 0;
+    for (uint64_t v = rhs; v; v = (TTAK_BIGINT_BASE_BITS < 64) ? v >> (TTAK_BIGINT_BASE_BITS % 64) : 0) {
+        rhs_limbs[rhs_used++] = (limb_t)v;
     }
+    size_t l_used = lhs->used;
+    size_t needed = l_used + rhs_used;
 
-    if (!ensure_capacity(dst, needed, now)) {
-        ttak_mem_free(d);
-        return false;
+    // A one-limb multiplier runs in place; a wider one needs a separate product buffer.
+    if (rhs_used == 1) {
+        if (!ensure_capacity(dst, needed, now)) return false;
+        limb_t *d = get_limbs(dst);
+        d[l_used] = ttak_limbs_mul_1(d, get_const_limbs(lhs), l_used, rhs_limbs[0]);
+    } else {
+        limb_t small[TTAK_BIGINT_SSO_LIMIT];
+        scratch_frame_t frame = { NULL, 0, false };
+        limb_t *d = needed <= TTAK_BIGINT_SSO_LIMIT ? small : scratch_take(&frame, needed, now);
+        if (!d) return false;
+        ttak_limbs_mul_basecase(d, get_const_limbs(lhs), l_used, rhs_limbs, rhs_used);
+        bool ok = ensure_capacity(dst, needed, now);
+        if (ok) memcpy(get_limbs(dst), d, needed * sizeof(limb_t));
+        scratch_give(&frame);
+        if (!ok) return false;
     }
-    
-    limb_t *dst_limbs = get_limbs(dst);
-    memcpy(dst_limbs, d, needed * sizeof(limb_t));
     dst->used = needed;
     dst->is_negative = lhs->is_negative; // rhs is not negative
     trim_unused(dst);
-    
-    ttak_mem_free(d);
     return true;
 }
 
@@ -681,26 +780,23 @@ size_t ttak_bigint_get_bit_length(const ttak_bigint_t *bi) {
     const limb_t *limbs = get_const_limbs(bi);
     size_t top_limb_idx = bi->used - 1;
     limb_t top_limb = limbs[top_limb_idx];
-    size_t bits = top_limb_idx * 32;
+    size_t bits = top_limb_idx * TTAK_BIGINT_BASE_BITS;
     
     unsigned long msb_pos;
-    #if defined(__GNUC__) || defined(__clang__)
+    #if (defined(__GNUC__) || defined(__clang__)) && TTAK_BIGINT_BASE_BITS == 64
+        msb_pos = 63 - __builtin_clzll(top_limb);
+    #elif defined(__GNUC__) || defined(__clang__)
         msb_pos = 31 - __builtin_clz(top_limb);
     #else
         msb_pos = 0;
-        while ((1UL << msb_pos) <= top_limb && msb_pos < 32) {
+        while (msb_pos + 1 < TTAK_BIGINT_BASE_BITS && (top_limb >> (msb_pos + 1)) != 0) {
             msb_pos++;
         }
-        msb_pos--;
     #endif
     
     return bits + msb_pos + 1;
 }
 
-#define TTAK_BIGINT_BASE_BITS 32
-#define TTAK_BIGINT_BASE (1ULL << TTAK_BIGINT_BASE_BITS)
-
-// Helper for Knuth division: u -= v
 /**
  * @brief Subtract two limb arrays in-place (u -= v).
  *
@@ -710,16 +806,9 @@ size_t ttak_bigint_get_bit_length(const ttak_bigint_t *bi) {
  * @return Final borrow flag (0 or 1).
  */
 limb_t sub_limbs(limb_t *u, const limb_t *v, size_t n) {
-    uint64_t borrow = 0;
-    for (size_t i = 0; i < n; ++i) {
-        uint64_t diff = (uint64_t)u[i] - v[i] - borrow;
-        u[i] = (limb_t)diff;
-        borrow = (diff >> TTAK_BIGINT_BASE_BITS) & 1;
-    }
-    return (limb_t)borrow;
+    return ttak_limbs_sub_n(u, u, v, n);
 }
 
-// Helper for Knuth division: u += v
 /**
  * @brief Add two limb arrays in-place (u += v).
  *
@@ -729,151 +818,7 @@ limb_t sub_limbs(limb_t *u, const limb_t *v, size_t n) {
  * @return Final carry flag.
  */
 limb_t add_limbs(limb_t *u, const limb_t *v, size_t n) {
-    uint64_t carry = 0;
-    for (size_t i = 0; i < n; ++i) {
-        uint64_t sum = (uint64_t)u[i] + v[i] + carry;
-        u[i] = (limb_t)sum;
-        carry = sum >> TTAK_BIGINT_BASE_BITS;
-    }
-    return (limb_t)carry;
-}
-
-// Helper for Knuth division: left shift
-/**
- * @brief Left shift a limb array by a small number of bits.
- *
- * @param num        Buffer to shift.
- * @param len        Number of limbs.
- * @param shift_bits Bits to shift (0 < shift_bits < base bits).
- * @return Carry produced by the shift.
- */
-static limb_t lshift_limbs(limb_t *num, size_t len, int shift_bits) {
-    if (shift_bits == 0) return 0;
-    limb_t carry = 0;
-    for (size_t i = 0; i < len; ++i) {
-        limb_t next_carry = num[i] >> (TTAK_BIGINT_BASE_BITS - shift_bits);
-        num[i] = (num[i] << shift_bits) | carry;
-        carry = next_carry;
-    }
-    return carry;
-}
-
-// Helper for Knuth division: right shift
-/**
- * @brief Right shift a limb array by a small number of bits.
- *
- * @param num        Buffer to shift.
- * @param len        Number of limbs.
- * @param shift_bits Bits to shift (0 < shift_bits < base bits).
- */
-static void rshift_limbs(limb_t *num, size_t len, int shift_bits) {
-    if (shift_bits == 0) return;
-    limb_t carry = 0;
-    for (size_t i = len; i > 0; --i) {
-        limb_t next_carry = num[i-1] << (TTAK_BIGINT_BASE_BITS - shift_bits);
-        num[i-1] = (num[i-1] >> shift_bits) | carry;
-        carry = next_carry;
-    }
-}
-
-// Knuth's Algorithm D for division.
-// q_out will have m + 1 limbs, r_out will have n limbs.
-// u is the dividend (m+n limbs), v is the divisor (n limbs).
-/**
- * @brief Execute Knuth's Algorithm D for limb arrays.
- *
- * @param q_out Quotient result (m + 1 limbs).
- * @param r_out Remainder result (n limbs).
- * @param u     Dividend limbs (m + n limbs).
- * @param m     Difference in limb counts between dividend and divisor.
- * @param v     Divisor limbs (n limbs).
- * @param n     Limb count of the divisor.
- * @param now   Timestamp for transient allocations.
- * @return true on success, false if allocation fails or divisor is invalid.
- */
-static _Bool knuth_div_limbs(limb_t *q_out, limb_t *r_out,
-                             const limb_t *u, size_t m,
-                             const limb_t *v, size_t n,
-                             uint64_t now) {
-    // D1. Normalize.
-    int d = 0;
-    if (n > 0) {
-        limb_t vn_1 = v[n - 1];
-        if (vn_1 == 0) return false; // Should not happen if d is normalized
-        while (vn_1 < (limb_t)(TTAK_BIGINT_BASE / 2)) {
-            vn_1 <<= 1;
-            d++;
-        }
-    }
-
-    limb_t *u_norm = ttak_mem_alloc_raw((m + n + 1) * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-    limb_t *v_norm = ttak_mem_alloc_raw(n * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-    if (!u_norm || !v_norm) {
-        ttak_mem_free(u_norm);
-        ttak_mem_free(v_norm);
-        return false;
-    }
-    memset(u_norm, 0, (m + n + 1) * sizeof(limb_t));
-
-    memcpy(u_norm, u, (m + n) * sizeof(limb_t));
-    if (d > 0) u_norm[m + n] = lshift_limbs(u_norm, m + n, d);
-
-    memcpy(v_norm, v, n * sizeof(limb_t));
-    if (d > 0) lshift_limbs(v_norm, n, d);
-
-    // D2. Initialize j.
-    for (int j = m; j >= 0; --j) {
-        // D3. Calculate q_hat.
-        uint64_t u_hat = ((uint64_t)u_norm[j + n] << TTAK_BIGINT_BASE_BITS) | u_norm[j + n - 1];
-        limb_t q_hat;
-
-        if (u_norm[j + n] == v_norm[n - 1]) {
-            q_hat = (limb_t)-1;
-        } else {
-            q_hat = u_hat / v_norm[n - 1];
-        }
-
-        if (n > 1) {
-            while ((uint64_t)q_hat * v_norm[n - 2] >
-                   (u_hat - (uint64_t)q_hat * v_norm[n - 1]) * TTAK_BIGINT_BASE + u_norm[j + n - 2]) {
-                q_hat--;
-            }
-        }
-
-        // D4. Multiply and subtract.
-        limb_t *u_norm_slice = &u_norm[j];
-        uint64_t borrow = 0;
-        uint64_t carry_prod = 0;
-        for (size_t i = 0; i < n; ++i) {
-            uint64_t prod = (uint64_t)v_norm[i] * q_hat + carry_prod;
-            carry_prod = prod >> TTAK_BIGINT_BASE_BITS;
-            uint64_t diff = (uint64_t)u_norm_slice[i] - (limb_t)prod - borrow;
-            u_norm_slice[i] = (limb_t)diff;
-            borrow = (diff >> TTAK_BIGINT_BASE_BITS) & 1;
-        }
-        uint64_t diff = (uint64_t)u_norm_slice[n] - carry_prod - borrow;
-        u_norm_slice[n] = (limb_t)diff;
-        borrow = (diff >> TTAK_BIGINT_BASE_BITS) & 1;
-
-        // D5. Add back if remainder is negative.
-        if (borrow > 0) {
-            q_hat--;
-            u_norm_slice[n] += add_limbs(u_norm_slice, v_norm, n);
-        }
-
-        // D6. Set quotient digit.
-        if (q_out) q_out[j] = q_hat;
-    }
-
-    // D7. Unnormalize remainder.
-    if (r_out) {
-        memcpy(r_out, u_norm, n * sizeof(limb_t));
-        if (d > 0) rshift_limbs(r_out, n, d);
-    }
-
-    ttak_mem_free(u_norm);
-    ttak_mem_free(v_norm);
-    return true;
+    return ttak_limbs_add_n(u, u, v, n);
 }
 
 /**
@@ -889,88 +834,79 @@ static _Bool knuth_div_limbs(limb_t *q_out, limb_t *r_out,
 _Bool ttak_bigint_div(ttak_bigint_t *q, ttak_bigint_t *r, const ttak_bigint_t *n, const ttak_bigint_t *d, uint64_t now) {
     if (ttak_bigint_is_zero(d)) return false;
 
-    // Use absolute values for comparison and division
-    ttak_bigint_t n_abs, d_abs;
-    ttak_bigint_init_copy(&n_abs, n, now);
-    ttak_bigint_init_copy(&d_abs, d, now);
-    n_abs.is_negative = false;
-    d_abs.is_negative = false;
-
-    int cmp = ttak_bigint_cmp(&n_abs, &d_abs);
-
-    ttak_bigint_free(&n_abs, now);
-    ttak_bigint_free(&d_abs, now);
+    bool q_neg = n->is_negative != d->is_negative;
+    bool r_neg = n->is_negative;
 
+    int cmp = cmp_abs(n, d);
     if (cmp < 0) {
-        if (q) ttak_bigint_set_u64(q, 0, now);
         if (r) ttak_bigint_copy(r, n, now);
+        if (q) ttak_bigint_set_u64(q, 0, now);
         return true;
     }
     if (cmp == 0) {
         if (q) {
             ttak_bigint_set_u64(q, 1, now);
-            q->is_negative = n->is_negative != d->is_negative;
+            q->is_negative = q_neg;
         }
         if (r) ttak_bigint_set_u64(r, 0, now);
         return true;
     }
 
-    ttak_bigint_t n_tmp;
-    ttak_bigint_init_copy(&n_tmp, n, now);
-    n_tmp.is_negative = false;
-
-    ttak_bigint_t d_tmp;
-    ttak_bigint_init_copy(&d_tmp, d, now);
-    d_tmp.is_negative = false;
-
-    const limb_t *n_limbs = get_const_limbs(&n_tmp);
-    const limb_t *d_limbs = get_const_limbs(&d_tmp);
-    size_t n_used = n_tmp.used;
-    size_t d_used = d_tmp.used;
-
-    size_t m = n_used - d_used;
-    size_t q_limbs_len = m + 1;
+    size_t n_used = n->used;
+    size_t d_used = d->used;
+    while (d_used > 0 && get_const_limbs(d)[d_used - 1] == 0) d_used--;
+    size_t q_limbs_len = n_used - d_used + 1;
+
+    /* Only an operand that is also an output has to be copied aside. */
+    bool n_aliased = n == q || n == r;
+    bool d_aliased = d == q || d == r;
+    scratch_frame_t n_frame = { NULL, 0, false };
+    scratch_frame_t d_frame = { NULL, 0, false };
+    const limb_t *n_limbs = get_const_limbs(n);
+    const limb_t *d_limbs = get_const_limbs(d);
+    _Bool ok = true;
+    if (n_aliased) {
+        limb_t *copy = scratch_take(&n_frame, n_used, now);
+        if (copy) memcpy(copy, n_limbs, n_used * sizeof(limb_t));
+        n_limbs = copy;
+        ok = copy != NULL;
+    }
+    if (ok && d_aliased) {
+        limb_t *copy = scratch_take(&d_frame, d_used, now);
+        if (copy) memcpy(copy, d_limbs, d_used * sizeof(limb_t));
+        d_limbs = copy;
+        ok = copy != NULL;
+    }
 
     limb_t *q_limbs = NULL;
-    if (q) {
-        if (!ensure_capacity(q, q_limbs_len, now)) {
-             ttak_bigint_free(&n_tmp, now);
-             ttak_bigint_free(&d_tmp, now);
-             return false;
-        }
-        q_limbs = get_limbs(q);
-        memset(q_limbs, 0, q->capacity * sizeof(limb_t));
+    if (ok && q) {
+        ok = ensure_capacity(q, q_limbs_len, now);
+        if (ok) q_limbs = get_limbs(q);
     }
-
     limb_t *r_limbs = NULL;
-    if (r) {
-        if (!ensure_capacity(r, d_used, now)) {
-            ttak_bigint_free(&n_tmp, now);
-            ttak_bigint_free(&d_tmp, now);
-            return false;
-        }
-        r_limbs = get_limbs(r);
-        memset(r_limbs, 0, r->capacity * sizeof(limb_t));
+    if (ok && r) {
+        ok = ensure_capacity(r, d_used, now);
+        if (ok) r_limbs = get_limbs(r);
     }
 
-    _Bool ok = knuth_div_limbs(q_limbs, r_limbs, n_limbs, m, d_limbs, d_used, now);
+    if (ok) ok = ttak_limbs_divrem(q_limbs, r_limbs, n_limbs, n_used, d_limbs, d_used, now);
 
     if (ok) {
         if (q) {
             q->used = q_limbs_len;
-            q->is_negative = n->is_negative != d->is_negative;
+            q->is_negative = q_neg;
             trim_unused(q);
         }
         if (r) {
             r->used = d_used;
-            r->is_negative = n->is_negative;
+            r->is_negative = r_neg;
             trim_unused(r);
         }
     }
 
-    ttak_bigint_free(&n_tmp, now);
-    ttak_bigint_free(&d_tmp, now);
-
+    /* Frames go back in reverse order of taking. */
+    scratch_give(&d_frame);
+    scratch_give(&n_frame);
     return ok;
 }
 
@@ -1012,35 +948,13 @@ char* ttak_bigint_to_string(const ttak_bigint_t *bi, uint64_t now) {
     if (!s) return NULL;
 
     char *p = s;
-    
-    ttak_bigint_t tmp, rem;
-    ttak_bigint_init_copy(&tmp, bi, now);
-    ttak_bigint_init(&rem, now);
-    tmp.is_negative = false;
-
-    while(!ttak_bigint_is_zero(&tmp)) {
-        ttak_bigint_div_u64(&tmp, &rem, &tmp, 10, now);
-        limb_t *rem_limbs = get_limbs(&rem);
-        *p++ = "0123456789"[rem_limbs[0]];
-    }
-
-    if (bi->is_negative) {
-        *p++ = '-';
-    }
-    *p = '\0';
-
-    // Reverse the string
-    char *start = s;
-    char *end = p - 1;
-    while(start < end) {
-        char temp = *start;
-        *start++ = *end;
-        *end-- = temp;
+    if (bi->is_negative) *p++ = '-';
+    size_t digits = ttak_limbs_get_str(p, get_const_limbs(bi), bi->used, now);
+    if (!digits) {
+        ttak_mem_free(s);
+        return NULL;
     }
-    
-    ttak_bigint_free(&tmp, now);
-    ttak_bigint_free(&rem, now);
-
+    p[digits] = '\0';
     return s;
 }
 
@@ -1053,7 +967,7 @@ char* ttak_bigint_to_string(const ttak_bigint_t *bi, uint64_t now) {
  */
 void ttak_bigint_mersenne_mod(ttak_bigint_t *bi, int p, uint64_t now) {
     (void)now;
-    size_t required_limbs = ((size_t)p + 31) / 32;
+    size_t required_limbs = ((size_t)p + TTAK_BIGINT_BASE_BITS - 1) / TTAK_BIGINT_BASE_BITS;
     if (required_limbs > TTAK_MAX_LIMB_LIMIT) {
         return;
     }
@@ -1068,12 +982,12 @@ void ttak_bigint_mersenne_mod(ttak_bigint_t *bi, int p, uint64_t now) {
         limb_t* bi_limbs = get_limbs(bi);
         limb_t* low_limbs = get_limbs(&low);
 
-        size_t p_limb_idx = p / 32;
-        size_t p_bit_off = p % 32;
+        size_t p_limb_idx = p / TTAK_BIGINT_BASE_BITS;
+        size_t p_bit_off = p % TTAK_BIGINT_BASE_BITS;
 
         // Low part
         memcpy(low_limbs, bi_limbs, p_limb_idx * sizeof(limb_t));
-        limb_t mask = (1U << p_bit_off) - 1;
+        limb_t mask = ((limb_t)1 << p_bit_off) - 1;
         if (p_bit_off > 0) {
             low_limbs[p_limb_idx] = bi_limbs[p_limb_idx] & mask;
         }
@@ -1088,7 +1002,7 @@ void ttak_bigint_mersenne_mod(ttak_bigint_t *bi, int p, uint64_t now) {
         for(size_t i = 0; i < high_limbs_needed; ++i) {
             limb_t val = bi_limbs[p_limb_idx + i] >> p_bit_off;
             if (p_bit_off > 0 && (p_limb_idx + i + 1) < bi->used) {
-                val |= bi_limbs[p_limb_idx + i + 1] << (32 - p_bit_off);
+                val |= bi_limbs[p_limb_idx + i + 1] << (TTAK_BIGINT_BASE_BITS - p_bit_off);
             }
             high_limbs[i] = val;
         }
@@ -1106,10 +1020,10 @@ void ttak_bigint_mersenne_mod(ttak_bigint_t *bi, int p, uint64_t now) {
     ttak_bigint_init(&mersenne_prime, now);
     ttak_bigint_set_u64(&mersenne_prime, 1, now);
     // left shift by p
-    size_t limb_shift = p / 32;
-    size_t bit_shift = p % 32;
+    size_t limb_shift = p / TTAK_BIGINT_BASE_BITS;
+    size_t bit_shift = p % TTAK_BIGINT_BASE_BITS;
     ensure_capacity(&mersenne_prime, limb_shift + 1, now);
-    get_limbs(&mersenne_prime)[limb_shift] = 1UL << bit_shift;
+    get_limbs(&mersenne_prime)[limb_shift] = (limb_t)1 << bit_shift;
     mersenne_prime.used = limb_shift + 1;
     
     ttak_bigint_t one;
@@ -1132,51 +1046,38 @@ void ttak_bigint_mersenne_mod(ttak_bigint_t *bi, int p, uint64_t now) {
  * @return true if the value fits in 64 bits, false otherwise.
  */
 bool ttak_bigint_export_u64(const ttak_bigint_t *bi, uint64_t *value_out) {
-    if (!bi || bi->is_negative || bi->used > 2) {
-        if (value_out) *value_out = 0;
-        return false;
-    }
-    const limb_t *limbs = get_const_limbs(bi);
-    uint64_t value = 0;
-    if (bi->used > 0) value |= limbs[0];
-    if (bi->used > 1) value |= (uint64_t)limbs[1] << 32;
+    uint64_t value;
+    bool ok = export_words(bi, &value, 1);
     if (value_out) *value_out = value;
-    return true;
+    return ok;
 }
 
 bool ttak_bigint_export_u128(const ttak_bigint_t *bi, ttak_u128_t *value_out) {
-    if (!bi || !value_out || bi->is_negative || bi->used > 4) {
-        if (value_out) *value_out = ttak_u128_zero();
-        return false;
-    }
-    const limb_t *limbs = get_const_limbs(bi);
-    uint64_t lo = 0, hi = 0;
-    if (bi->used > 0) lo |= (uint64_t)limbs[0];
-    if (bi->used > 1) lo |= (uint64_t)limbs[1] << 32;
-    if (bi->used > 2) hi |= (uint64_t)limbs[2];
-    if (bi->used > 3) hi |= (uint64_t)limbs[3] << 32;
-    *value_out = ttak_u128_make(hi, lo);
-    return true;
+    if (!value_out) return false;
+    uint64_t words[2];
+    bool ok = export_words(bi, words, 2);
+    *value_out = ttak_u128_make(words[1], words[0]);
+    return ok;
 }
 
 bool ttak_bigint_export_u256(const ttak_bigint_t *bi, ttak_u256_t *value_out) {
-    if (!bi || !value_out || bi->is_negative || bi->used > 8) {
-        if (value_out) *value_out = ttak_u256_zero();
-        return false;
-    }
-    uint64_t chunks[4] = {0, 0, 0, 0};
-    const limb_t *limbs = get_const_limbs(bi);
-    for (int pair = 0; pair < 4; ++pair) {
-        size_t idx = pair * 2;
-        if (bi->used > idx) chunks[pair] |= (uint64_t)limbs[idx];
-        if (bi->used > idx + 1) chunks[pair] |= (uint64_t)limbs[idx + 1] << 32;
-    }
-    *value_out = ttak_u256_from_limbs(chunks[3], chunks[2], chunks[1], chunks[0]);
-    return true;
+    if (!value_out) return false;
+    uint64_t words[4];
+    bool ok = export_words(bi, words, 4);
+    *value_out = ttak_u256_from_limbs(words[3], words[2], words[1], words[0]);
+    return ok;
 }
 
 #include <ttak/security/sha256.h>
 
+/*
+ * Bytes of the limb array that feed the digests: whole 32-bit words up
+ * to the top set bit, so digests do not depend on the limb width.
+ */
+static size_t hash_bytes(const ttak_bigint_t *bi) {
+    return (ttak_bigint_get_bit_length(bi) + 31) / 32 * 4;
+}
+
 /**
  * @brief Hash the big integer with SHA-256 and emit a hexadecimal digest.
  *
@@ -1187,8 +1088,7 @@ void ttak_bigint_to_hex_hash(const ttak_bigint_t *bi, char out[65]) {
     SHA256_CTX ctx;
     sha256_init(&ctx);
     if (bi && bi->used > 0) {
-        const limb_t *limbs = get_const_limbs(bi);
-        sha256_update(&ctx, (const uint8_t *)limbs, bi->used * sizeof(limb_t));
+        sha256_update(&ctx, (const uint8_t *)get_const_limbs(bi), hash_bytes(bi));
     }
     uint8_t digest[32];
     sha256_final(&ctx, digest);
@@ -1234,8 +1134,7 @@ void ttak_bigint_hash(const ttak_bigint_t *bi, uint8_t out[32]) {
     SHA256_CTX ctx;
     sha256_init(&ctx);
     if (bi && bi->used > 0) {
-        const limb_t *limbs = get_const_limbs(bi);
-        sha256_update(&ctx, (const uint8_t *)limbs, bi->used * sizeof(limb_t));
+        sha256_update(&ctx, (const uint8_t *)get_const_limbs(bi), hash_bytes(bi));
     }
     sha256_final(&ctx, out);
 }
@@ -4,13 +4,28 @@
  *
  * Reads TTAK_BIGINT_ACCEL_THRESHOLD at startup to decide the minimum
  * operand size (in limbs) at which GPU or SIMD acceleration is engaged.
- * Falls back to a compiled-in default when the variable is absent.
+ * Without it, a crossover measured earlier by ttak_bigint_accel_calibrate()
+ * is loaded from the accelerator cache, and failing that a compiled-in
+ * default applies. ttak_bigint_accel_warmup() lets callers pay backend
+ * start-up at a time of their choosing instead of on the first large
+ * operation.
  */
 
 #include <ttak/math/bigint_accel.h>
+#include <ttak/async/sched.h>
+#include <ttak/math/limbs.h>
+#include <ttak/mem/mem.h>
+#include <ttak/thread/pool.h>
+#include <ttak/timing/timing.h>
+#include "../../internal/ttak/accel_cache.h"
 
 #include <stdatomic.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 static size_t g_bigint_accel_threshold = 0;
 static bool g_bigint_accel_threshold_ready = false;
@@ -27,17 +42,89 @@ static atomic_bool g_bigint_accel_rocm_enabled = ATOMIC_VAR_INIT(true);
 static atomic_bool g_bigint_accel_opencl_enabled = ATOMIC_VAR_INIT(true);
 #endif
 
-static void ttak_bigint_accel_init_threshold(void) {
-    if (g_bigint_accel_threshold_ready) return;
-    g_bigint_accel_threshold = 256;
+static bool ttak_bigint_accel_env_threshold(size_t *out) {
     const char *env = getenv("TTAK_BIGINT_ACCEL_THRESHOLD");
     if (env && *env) {
         char *endp = NULL;
         long parsed = strtol(env, &endp, 10);
         if (endp && *endp == '\0' && parsed > 0) {
-            g_bigint_accel_threshold = (size_t)parsed;
+            *out = (size_t)parsed;
+            return true;
         }
     }
+    return false;
+}
+
+/*
+ * The crossover depends on the host CPU and the device, so the cache entry
+ * is keyed by host name and the backends compiled in.
+ */
+static bool ttak_bigint_accel_cache_path(char *out, size_t cap) {
+    char dir[1024];
+    if (!ttak_accel_cache_dir(dir, sizeof(dir))) return false;
+    char host[256] = "";
+#ifdef _WIN32
+    const char *name = getenv("COMPUTERNAME");
+    if (name) snprintf(host, sizeof(host), "%s", name);
+#else
+    if (gethostname(host, sizeof(host) - 1) != 0) host[0] = '\0';
+#endif
+    host[sizeof(host) - 1] = '\0';
+    uint64_t key = ttak_accel_cache_hash(0xcbf29ce484222325ULL, host, strlen(host));
+    const char *backends = ""
+#if defined(ENABLE_CUDA)
+                           "cuda;"
+#endif
+#if defined(ENABLE_ROCM)
+                           "rocm;"
+#endif
+#if defined(ENABLE_OPENCL)
+                           "opencl;"
+#endif
+        ;
+    key = ttak_accel_cache_hash(key, backends, strlen(backends));
+    int n = snprintf(out, cap, "%s/bigint-accel-%016llx.txt", dir, (unsigned long long)key);
+    return n > 0 && (size_t)n < cap;
+}
+
+static bool ttak_bigint_accel_cache_load(size_t *out) {
+    char path[1100];
+    if (!ttak_bigint_accel_cache_path(path, sizeof(path))) return false;
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) return false;
+    unsigned long long limbs = 0;
+    bool ok = fscanf(fp, "ttak-bigint-accel 1 threshold %llu", &limbs) == 1 && limbs > 0;
+    fclose(fp);
+    if (ok) *out = (size_t)limbs;
+    return ok;
+}
+
+static void ttak_bigint_accel_cache_store(size_t limbs) {
+    char path[1100];
+    char tmp[1140];
+    if (!ttak_bigint_accel_cache_path(path, sizeof(path))) return;
+#ifdef _WIN32
+    int n = snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+#else
+    int n = snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long)getpid());
+#endif
+    if (n < 0 || (size_t)n >= sizeof(tmp)) return;
+    FILE *fp = fopen(tmp, "w");
+    if (fp == NULL) return;
+    bool ok = fprintf(fp, "ttak-bigint-accel 1\nthreshold %llu\n", (unsigned long long)limbs) > 0;
+    ok = fclose(fp) == 0 && ok;
+#ifdef _WIN32
+    if (ok) remove(path);
+#endif
+    if (!ok || rename(tmp, path) != 0) remove(tmp);
+}
+
+static void ttak_bigint_accel_init_threshold(void) {
+    if (g_bigint_accel_threshold_ready) return;
+    g_bigint_accel_threshold = 256;
+    if (!ttak_bigint_accel_env_threshold(&g_bigint_accel_threshold) && ttak_bigint_accel_available()) {
+        (void)ttak_bigint_accel_cache_load(&g_bigint_accel_threshold);
+    }
     g_bigint_accel_threshold_ready = true;
 }
 
@@ -67,6 +154,7 @@ bool ttak_bigint_accel_available(void) {
 }
 
 #if defined(ENABLE_CUDA)
+bool ttak_bigint_accel_cuda_warmup(void);
 bool ttak_bigint_accel_cuda_add(limb_t *dst,
                                 size_t dst_capacity,
                                 size_t *out_used,
@@ -84,6 +172,7 @@ bool ttak_bigint_accel_cuda_mul(limb_t *dst,
 #endif
 
 #if defined(ENABLE_ROCM)
+bool ttak_bigint_accel_rocm_warmup(void);
 bool ttak_bigint_accel_rocm_add(limb_t *dst,
                                 size_t dst_capacity,
                                 size_t *out_used,
@@ -101,6 +190,7 @@ bool ttak_bigint_accel_rocm_mul(limb_t *dst,
 #endif
 
 #if defined(ENABLE_OPENCL)
+bool ttak_bigint_accel_opencl_warmup(void);
 bool ttak_bigint_accel_opencl_add(limb_t *dst,
                                   size_t dst_capacity,
                                   size_t *out_used,
@@ -117,6 +207,29 @@ bool ttak_bigint_accel_opencl_mul(limb_t *dst,
                                   size_t rhs_used);
 #endif
 
+bool ttak_bigint_accel_warmup(void) {
+#if defined(ENABLE_CUDA)
+    if (atomic_load_explicit(&g_bigint_accel_cuda_enabled, memory_order_relaxed) &&
+        !ttak_bigint_accel_cuda_warmup()) {
+        atomic_store_explicit(&g_bigint_accel_cuda_enabled, false, memory_order_relaxed);
+    }
+#endif
+#if defined(ENABLE_ROCM)
+    if (atomic_load_explicit(&g_bigint_accel_rocm_enabled, memory_order_relaxed) &&
+        !ttak_bigint_accel_rocm_warmup()) {
+        atomic_store_explicit(&g_bigint_accel_rocm_enabled, false, memory_order_relaxed);
+    }
+#endif
+#if defined(ENABLE_OPENCL)
+    if (atomic_load_explicit(&g_bigint_accel_opencl_enabled, memory_order_relaxed) &&
+        !ttak_bigint_accel_opencl_warmup()) {
+        atomic_store_explicit(&g_bigint_accel_opencl_enabled, false, memory_order_relaxed);
+    }
+#endif
+    ttak_bigint_accel_init_threshold();
+    return ttak_bigint_accel_available();
+}
+
 bool ttak_bigint_accel_add_raw(limb_t *dst,
                                size_t dst_capacity,
                                size_t *out_used,
@@ -198,3 +311,72 @@ bool ttak_bigint_accel_mul_raw(limb_t *dst,
 #endif
     return false;
 }
+
+/* Best of a few runs, in nanoseconds; UINT64_MAX when the multiply failed. */
+static uint64_t ttak_bigint_accel_time_mul(bool device, limb_t *rp, size_t rcap, const limb_t *ap,
+                                           const limb_t *bp, size_t n, uint64_t now) {
+    uint64_t best = UINT64_MAX;
+    for (int rep = 0; rep < TTAK_BIGINT_ACCEL_CALIBRATE_REPS; ++rep) {
+        size_t used = 0;
+        uint64_t start = ttak_get_tick_count_ns();
+        bool ok = device ? ttak_bigint_accel_mul_raw(rp, rcap, &used, ap, n, bp, n)
+                         : ttak_limbs_mul_parallel(rp, ap, n, bp, n, ttak_async_pool(), now);
+        uint64_t elapsed = ttak_get_tick_count_ns() - start;
+        if (!ok) return UINT64_MAX;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+size_t ttak_bigint_accel_calibrate(uint64_t now) {
+    if (!ttak_bigint_accel_available()) return 0;
+    size_t max_n = TTAK_BIGINT_ACCEL_CALIBRATE_MAX_LIMBS;
+    limb_t *ap = ttak_mem_alloc_raw(max_n * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    limb_t *bp = ttak_mem_alloc_raw(max_n * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    limb_t *rp = ttak_mem_alloc_raw(2 * max_n * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    size_t threshold = 0;
+    if (ap && bp && rp) {
+        uint64_t x = 0x9e3779b97f4a7c15ULL;
+        for (size_t i = 0; i < max_n; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            ap[i] = (limb_t)x;
+            bp[i] = (limb_t)(x >> 17);
+        }
+        /* The first offload pays for context and kernel set-up; keep it out of the timings. */
+        size_t used = 0;
+        bool ok = ttak_bigint_accel_mul_raw(rp, 2 * max_n, &used, ap, 1, bp, 1);
+        /* Smallest size from which the device wins at every larger size tried. */
+        size_t crossover = 0;
+        for (size_t n = TTAK_BIGINT_ACCEL_CALIBRATE_MIN_LIMBS; ok && n <= max_n; n *= 2) {
+            uint64_t cpu = ttak_bigint_accel_time_mul(false, rp, 2 * max_n, ap, bp, n, now);
+            uint64_t dev = ttak_bigint_accel_time_mul(true, rp, 2 * max_n, ap, bp, n, now);
+            if (cpu == UINT64_MAX || dev == UINT64_MAX) {
+                ok = false;
+            } else if (dev < cpu) {
+                if (crossover == 0) crossover = n;
+            } else {
+                crossover = 0;
+            }
+        }
+        if (ok) {
+            /*
+             * ttak_bigint_mul() offloads once the product reaches the threshold,
+             * so balanced operands of crossover limbs need twice that. A device
+             * that never won disables offload.
+             */
+            threshold = crossover ? 2 * crossover : SIZE_MAX;
+        }
+    }
+    ttak_mem_free(rp);
+    ttak_mem_free(bp);
+    ttak_mem_free(ap);
+    if (threshold == 0) return 0;
+
+    ttak_bigint_accel_cache_store(threshold);
+    ttak_bigint_accel_init_threshold();
+    size_t ignored;
+    if (!ttak_bigint_accel_env_threshold(&ignored)) g_bigint_accel_threshold = threshold;
+    return threshold;
+}
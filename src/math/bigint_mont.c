@@ -0,0 +1,560 @@
+#include <ttak/math/bigint_mont.h>
+#include <ttak/math/limbs.h>
+#include <ttak/mem/mem.h>
+#include <string.h>
+
+/* Product and reduction scratch for a k-limb modulus (see mont_reduce and barrett_reduce). */
+#define MONT_WORK_LIMBS(k) TTAK_BIGINT_MONT_WORK_LIMBS(k)
+
+/* Stack scratch: the reduction work plus three k-limb operands. */
+#define MONT_STACK_LIMBS (MONT_WORK_LIMBS(TTAK_BIGINT_MONT_STACK_LIMBS) + 3 * TTAK_BIGINT_MONT_STACK_LIMBS)
+
+typedef struct mont_work {
+    limb_t  stack[MONT_STACK_LIMBS];
+    limb_t *heap;
+} mont_work_t;
+
+/**
+ * @brief Scratch for one operation: the stack buffer when @p count fits, the heap otherwise.
+ */
+static limb_t *work_take(mont_work_t *w, size_t count, uint64_t now) {
+    w->heap = NULL;
+    if (count <= MONT_STACK_LIMBS) return w->stack;
+    w->heap = ttak_mem_alloc_raw(count * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    return w->heap;
+}
+
+static void work_give(mont_work_t *w) {
+    if (w->heap) ttak_mem_free(w->heap);
+    w->heap = NULL;
+}
+
+static int cmp_n(const limb_t *ap, const limb_t *bp, size_t n) {
+    for (size_t i = n; i > 0; --i) {
+        if (ap[i - 1] != bp[i - 1]) return ap[i - 1] > bp[i - 1] ? 1 : -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Copy a reduced big integer into @p k zero-padded limbs.
+ * @return false when the value is negative or wider than the modulus.
+ */
+static bool load_limbs(limb_t *rp, const ttak_bigint_t *a, size_t k) {
+    const limb_t *ap = ttak_bigint_limbs(a);
+    size_t used = a->used;
+    while (used > 0 && ap[used - 1] == 0) used--;
+    if (a->is_negative && used > 0) return false;
+    if (used > k) return false;
+    memcpy(rp, ap, used * sizeof(limb_t));
+    memset(rp + used, 0, (k - used) * sizeof(limb_t));
+    return true;
+}
+
+/**
+ * @brief Montgomery reduction rp = tp * R^-1 mod n of a 2k-limb @p tp below n * R.
+ *
+ * Uses tp[2k] as the carry limb. @p rp may alias anything but @p tp.
+ */
+static void mont_reduce(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, limb_t *tp) {
+    size_t k = ctx->k;
+    tp[2 * k] = 0;
+    for (size_t i = 0; i < k; ++i) {
+        limb_t m = tp[i] * ctx->n_inv;
+        limb_t cy = ttak_limbs_addmul_1(tp + i, ctx->n, k, m);
+        for (size_t j = i + k; cy && j <= 2 * k; ++j) {
+            limb_t s = tp[j] + cy;
+            cy = s < cy;
+            tp[j] = s;
+        }
+    }
+    limb_t *hi = tp + k;
+    if (hi[k] || cmp_n(hi, ctx->n, k) >= 0) {
+        ttak_limbs_sub_n(rp, hi, ctx->n, k);
+    } else {
+        memcpy(rp, hi, k * sizeof(limb_t));
+    }
+}
+
+/**
+ * @brief Barrett reduction rp = tp mod n of a 2k-limb @p tp below n^2.
+ *
+ * q = floor(floor(x / B^(k-1)) * mu / B^(k+1)) undershoots the quotient by
+ * at most two, so at most two subtractions of n follow.
+ */
+static bool barrett_reduce(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, limb_t *tp, uint64_t now) {
+    size_t k = ctx->k;
+    limb_t *q2 = tp + 2 * k;
+    limb_t *r2 = q2 + 2 * k + 2;
+    if (!ttak_limbs_mul(q2, tp + k - 1, k + 1, ctx->mu, k + 1, now)) return false;
+    if (!ttak_limbs_mul(r2, q2 + k + 1, k + 1, ctx->n, k, now)) return false;
+    ttak_limbs_sub_n(tp, tp, r2, k + 1);
+    while (tp[k] || cmp_n(tp, ctx->n, k) >= 0) {
+        tp[k] -= ttak_limbs_sub_n(tp, tp, ctx->n, k);
+    }
+    memcpy(rp, tp, k * sizeof(limb_t));
+    return true;
+}
+
+/**
+ * @brief rp = ap * bp in internal form; @p tp holds MONT_WORK_LIMBS(k) limbs.
+ *
+ * @p rp may alias either operand.
+ */
+static bool mul_form(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, const limb_t *bp,
+                     limb_t *tp, uint64_t now) {
+    size_t k = ctx->k;
+    if (!ttak_limbs_mul(tp, ap, k, bp, k, now)) return false;
+    if (ctx->barrett) return barrett_reduce(ctx, rp, tp, now);
+    mont_reduce(ctx, rp, tp);
+    return true;
+}
+
+/**
+ * @brief rp = a mod n in internal form, for any big integer @p a.
+ */
+static bool to_form(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const ttak_bigint_t *a, limb_t *tp,
+                    uint64_t now) {
+    size_t k = ctx->k;
+    if (!load_limbs(rp, a, k) || cmp_n(rp, ctx->n, k) >= 0) {
+        ttak_bigint_t n, r;
+        ttak_bigint_init(&n, now);
+        ttak_bigint_init(&r, now);
+        bool ok = ttak_bigint_set_limbs(&n, ctx->n, k, now) && ttak_bigint_mod(&r, a, &n, now);
+        if (ok && r.is_negative) ok = ttak_bigint_add(&r, &r, &n, now);
+        if (ok) ok = load_limbs(rp, &r, k);
+        ttak_bigint_free(&r, now);
+        ttak_bigint_free(&n, now);
+        if (!ok) return false;
+    }
+    if (ctx->barrett) return true;
+    return mul_form(ctx, rp, rp, ctx->r2, tp, now);
+}
+
+/**
+ * @brief rp = plain value of the internal-form @p ap.
+ */
+static void from_form(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, limb_t *tp) {
+    size_t k = ctx->k;
+    if (ctx->barrett) {
+        memmove(rp, ap, k * sizeof(limb_t));
+        return;
+    }
+    memcpy(tp, ap, k * sizeof(limb_t));
+    memset(tp + k, 0, k * sizeof(limb_t));
+    mont_reduce(ctx, rp, tp);
+}
+
+static unsigned exp_bit(const limb_t *ep, size_t i) {
+    return (unsigned)(ep[i / TTAK_BIGINT_LIMB_BITS] >> (i % TTAK_BIGINT_LIMB_BITS)) & 1u;
+}
+
+/**
+ * @brief Window width of the sliding-window exponentiation for an @p ebits-bit exponent.
+ *
+ * Minimizes the table build plus one multiplication per window, as in GMP.
+ */
+static size_t window_bits(size_t ebits) {
+    if (ebits <= 8) return 1;
+    if (ebits <= 24) return 2;
+    if (ebits <= 80) return 3;
+    if (ebits <= 240) return 4;
+    if (ebits <= 672) return 5;
+    return 6;
+}
+
+/**
+ * @brief xp = bp^ep by a left-to-right sliding window, all in internal form.
+ *
+ * @p ws holds (2^(w-1) + 1) * k + MONT_WORK_LIMBS(k) limbs for the window
+ * width w of @p ebits.
+ */
+static bool pow_window(const ttak_bigint_mont_ctx_t *ctx, limb_t *xp, const limb_t *bp, const limb_t *ep,
+                       size_t ebits, limb_t *ws, uint64_t now) {
+    size_t k = ctx->k;
+    if (ebits == 0) {
+        memcpy(xp, ctx->one, k * sizeof(limb_t));
+        return true;
+    }
+    size_t w = window_bits(ebits);
+    size_t entries = (size_t)1 << (w - 1);
+    limb_t *tbl = ws;
+    limb_t *sq = tbl + entries * k;
+    limb_t *tp = sq + k;
+
+    /* tbl[i] = b^(2i + 1). */
+    memcpy(tbl, bp, k * sizeof(limb_t));
+    if (entries > 1) {
+        if (!mul_form(ctx, sq, bp, bp, tp, now)) return false;
+        for (size_t i = 1; i < entries; ++i) {
+            if (!mul_form(ctx, tbl + i * k, tbl + (i - 1) * k, sq, tp, now)) return false;
+        }
+    }
+
+    bool started = false;
+    size_t i = ebits;
+    while (i > 0) {
+        if (!exp_bit(ep, i - 1)) {
+            if (!mul_form(ctx, xp, xp, xp, tp, now)) return false;
+            i--;
+            continue;
+        }
+        size_t lo = i > w ? i - w : 0;
+        while (!exp_bit(ep, lo)) lo++;
+        size_t val = 0;
+        for (size_t j = i; j > lo; --j) val = (val << 1) | exp_bit(ep, j - 1);
+        const limb_t *factor = tbl + (val >> 1) * k;
+        if (started) {
+            for (size_t s = lo; s < i; ++s) {
+                if (!mul_form(ctx, xp, xp, xp, tp, now)) return false;
+            }
+            if (!mul_form(ctx, xp, xp, factor, tp, now)) return false;
+        } else {
+            memcpy(xp, factor, k * sizeof(limb_t));
+            started = true;
+        }
+        i = lo;
+    }
+    return true;
+}
+
+static size_t pow_window_limbs(size_t k, size_t ebits) {
+    return (((size_t)1 << (window_bits(ebits) - 1)) + 1) * k + MONT_WORK_LIMBS(k);
+}
+
+/**
+ * @brief Check an exponent and return its bit length through @p ebits.
+ */
+static bool exp_bits(const ttak_bigint_t *exp, size_t *ebits) {
+    *ebits = ttak_bigint_get_bit_length(exp);
+    return *ebits == 0 || !exp->is_negative;
+}
+
+/**
+ * @brief Prepare reduction by @p n.
+ *
+ * One division of B^2k by n yields both R^2 mod n (Montgomery) and mu
+ * (Barrett); n' comes from Newton iteration on the low limb.
+ *
+ * @param ctx Context to fill.
+ * @param n   Modulus, greater than 1.
+ * @param now Timestamp for allocations.
+ * @return true on success, false for a bad modulus or allocation failure.
+ */
+bool ttak_bigint_mont_init(ttak_bigint_mont_ctx_t *ctx, const ttak_bigint_t *n, uint64_t now) {
+    memset(ctx, 0, sizeof(*ctx));
+    if (n->is_negative || ttak_bigint_cmp_u64(n, 1) <= 0) return false;
+
+    const limb_t *np = ttak_bigint_limbs(n);
+    size_t k = n->used;
+    while (k > 0 && np[k - 1] == 0) k--;
+
+    limb_t *block = ttak_mem_alloc_raw((4 * k + 1) * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!block) return false;
+    ctx->k = k;
+    ctx->barrett = (np[0] & 1) == 0;
+    ctx->n = block;
+    ctx->one = block + k;
+    limb_t *r2 = block + 2 * k;
+    limb_t *mu = block + 3 * k;
+    memcpy(ctx->n, np, k * sizeof(limb_t));
+
+    mont_work_t w;
+    size_t num_len = 2 * k + 1;
+    limb_t *ws = work_take(&w, num_len + (k + 2) + MONT_WORK_LIMBS(k), now);
+    if (!ws) {
+        ttak_mem_free(block);
+        memset(ctx, 0, sizeof(*ctx));
+        return false;
+    }
+    limb_t *num = ws;
+    limb_t *quot = num + num_len;
+    limb_t *tp = quot + k + 2;
+    memset(num, 0, num_len * sizeof(limb_t));
+    num[2 * k] = 1;
+    bool ok = ttak_limbs_divrem(quot, r2, num, num_len, ctx->n, k, now);
+
+    if (ok && ctx->barrett) {
+        memcpy(mu, quot, (k + 1) * sizeof(limb_t));
+        ctx->mu = mu;
+        memset(ctx->one, 0, k * sizeof(limb_t));
+        ctx->one[0] = 1;
+    } else if (ok) {
+        limb_t n0 = ctx->n[0];
+        limb_t inv = n0; /* Correct to 3 bits for odd n0; each step doubles that. */
+        for (int i = 0; i < 6; ++i) inv *= 2 - n0 * inv;
+        ctx->n_inv = (limb_t)0 - inv;
+        ctx->r2 = r2;
+        /* R mod n = REDC(R^2). */
+        memcpy(tp, r2, k * sizeof(limb_t));
+        memset(tp + k, 0, k * sizeof(limb_t));
+        mont_reduce(ctx, ctx->one, tp);
+    }
+    work_give(&w);
+    if (!ok) {
+        ttak_mem_free(block);
+        memset(ctx, 0, sizeof(*ctx));
+    }
+    return ok;
+}
+
+/**
+ * @brief Release the precomputed limbs of @p ctx.
+ *
+ * @param ctx Context to clear; safe to call twice.
+ */
+void ttak_bigint_mont_free(ttak_bigint_mont_ctx_t *ctx) {
+    if (!ctx) return;
+    if (ctx->n) ttak_mem_free(ctx->n);
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+/**
+ * @brief Reduce @p a and convert it to internal form.
+ */
+bool ttak_bigint_mont_to(const ttak_bigint_mont_ctx_t *ctx, ttak_bigint_t *dst, const ttak_bigint_t *a,
+                         uint64_t now) {
+    size_t k = ctx->k;
+    mont_work_t w;
+    limb_t *ws = work_take(&w, k + MONT_WORK_LIMBS(k), now);
+    if (!ws) return false;
+    bool ok = to_form(ctx, ws, a, ws + k, now) && ttak_bigint_set_limbs(dst, ws, k, now);
+    work_give(&w);
+    return ok;
+}
+
+/**
+ * @brief Convert an internal-form value back to a plain residue.
+ */
+bool ttak_bigint_mont_from(const ttak_bigint_mont_ctx_t *ctx, ttak_bigint_t *dst, const ttak_bigint_t *a,
+                           uint64_t now) {
+    size_t k = ctx->k;
+    mont_work_t w;
+    limb_t *ws = work_take(&w, k + MONT_WORK_LIMBS(k), now);
+    if (!ws) return false;
+    bool ok = load_limbs(ws, a, k);
+    if (ok) {
+        from_form(ctx, ws, ws, ws + k);
+        ok = ttak_bigint_set_limbs(dst, ws, k, now);
+    }
+    work_give(&w);
+    return ok;
+}
+
+/**
+ * @brief Multiply two internal-form values without a division.
+ */
+bool ttak_bigint_mont_mul(const ttak_bigint_mont_ctx_t *ctx, ttak_bigint_t *dst, const ttak_bigint_t *a,
+                          const ttak_bigint_t *b, uint64_t now) {
+    size_t k = ctx->k;
+    mont_work_t w;
+    limb_t *ws = work_take(&w, 2 * k + MONT_WORK_LIMBS(k), now);
+    if (!ws) return false;
+    limb_t *ap = ws;
+    limb_t *bp = ws + k;
+    bool ok = load_limbs(ap, a, k) && load_limbs(bp, b, k) && mul_form(ctx, ap, ap, bp, bp + k, now) &&
+              ttak_bigint_set_limbs(dst, ap, k, now);
+    work_give(&w);
+    return ok;
+}
+
+/**
+ * @brief Modular exponentiation with a sliding window.
+ */
+bool ttak_bigint_mont_powmod(const ttak_bigint_mont_ctx_t *ctx, ttak_bigint_t *dst, const ttak_bigint_t *base,
+                             const ttak_bigint_t *exp, uint64_t now) {
+    size_t ebits;
+    if (!exp_bits(exp, &ebits)) return false;
+    size_t k = ctx->k;
+    mont_work_t w;
+    limb_t *ws = work_take(&w, 2 * k + pow_window_limbs(k, ebits), now);
+    if (!ws) return false;
+    limb_t *bp = ws;
+    limb_t *xp = ws + k;
+    limb_t *rest = xp + k;
+    bool ok = to_form(ctx, bp, base, rest, now) &&
+              pow_window(ctx, xp, bp, ttak_bigint_limbs(exp), ebits, rest, now);
+    if (ok) {
+        from_form(ctx, xp, xp, rest);
+        ok = ttak_bigint_set_limbs(dst, xp, k, now);
+    }
+    work_give(&w);
+    return ok;
+}
+
+/**
+ * @brief Build the comb table of @p base.
+ *
+ * Entry 2^j is base^(2^(j * spacing)), reached by spacing squarings of
+ * entry 2^(j-1); the entries between are products with lower ones.
+ */
+bool ttak_bigint_mont_comb_init(ttak_bigint_mont_comb_t *comb, const ttak_bigint_mont_ctx_t *ctx,
+                                const ttak_bigint_t *base, size_t max_bits, uint64_t now) {
+    memset(comb, 0, sizeof(*comb));
+    if (max_bits == 0) max_bits = 1;
+    size_t teeth = max_bits < 128 ? 4 : max_bits < 512 ? 5 : 6;
+    if (teeth > max_bits) teeth = max_bits;
+    size_t spacing = (max_bits + teeth - 1) / teeth;
+    size_t k = ctx->k;
+    size_t entries = (size_t)1 << teeth;
+
+    limb_t *table = ttak_mem_alloc_raw(entries * k * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!table) return false;
+    mont_work_t w;
+    limb_t *tp = work_take(&w, MONT_WORK_LIMBS(k), now);
+    bool ok = tp && to_form(ctx, table + k, base, tp, now);
+    memcpy(table, ctx->one, k * sizeof(limb_t));
+    for (size_t j = 1; ok && j < teeth; ++j) {
+        size_t top = (size_t)1 << j;
+        limb_t *g = table + top * k;
+        memcpy(g, table + (top >> 1) * k, k * sizeof(limb_t));
+        for (size_t s = 0; ok && s < spacing; ++s) ok = mul_form(ctx, g, g, g, tp, now);
+        for (size_t i = 1; ok && i < top; ++i) ok = mul_form(ctx, g + i * k, table + i * k, g, tp, now);
+    }
+    if (tp) work_give(&w);
+    if (!ok) {
+        ttak_mem_free(table);
+        return false;
+    }
+    comb->ctx = ctx;
+    comb->table = table;
+    comb->teeth = teeth;
+    comb->spacing = spacing;
+    comb->max_bits = max_bits;
+    return true;
+}
+
+/**
+ * @brief Release the table of @p comb.
+ */
+void ttak_bigint_mont_comb_free(ttak_bigint_mont_comb_t *comb) {
+    if (!comb) return;
+    if (comb->table) ttak_mem_free(comb->table);
+    memset(comb, 0, sizeof(*comb));
+}
+
+/**
+ * @brief Fixed-base exponentiation over a comb table.
+ */
+bool ttak_bigint_mont_comb_powmod(const ttak_bigint_mont_comb_t *comb, ttak_bigint_t *dst,
+                                  const ttak_bigint_t *exp, uint64_t now) {
+    size_t ebits;
+    if (!exp_bits(exp, &ebits)) return false;
+    const ttak_bigint_mont_ctx_t *ctx = comb->ctx;
+    size_t k = ctx->k;
+    const limb_t *ep = ttak_bigint_limbs(exp);
+    bool long_exp = ebits > comb->max_bits;
+    mont_work_t w;
+    limb_t *ws = work_take(&w, k + (long_exp ? pow_window_limbs(k, ebits) : MONT_WORK_LIMBS(k)), now);
+    if (!ws) return false;
+    limb_t *xp = ws;
+    limb_t *tp = ws + k;
+    bool ok = true;
+
+    if (long_exp) {
+        ok = pow_window(ctx, xp, comb->table + k, ep, ebits, tp, now);
+    } else {
+        bool started = false;
+        for (size_t col = comb->spacing; ok && col > 0; --col) {
+            if (started) ok = mul_form(ctx, xp, xp, xp, tp, now);
+            size_t idx = 0;
+            for (size_t j = comb->teeth; j > 0; --j) {
+                size_t bit = (j - 1) * comb->spacing + col - 1;
+                idx = (idx << 1) | (bit < ebits ? exp_bit(ep, bit) : 0u);
+            }
+            if (!idx || !ok) continue;
+            if (started) {
+                ok = mul_form(ctx, xp, xp, comb->table + idx * k, tp, now);
+            } else {
+                memcpy(xp, comb->table + idx * k, k * sizeof(limb_t));
+                started = true;
+            }
+        }
+        if (!started) memcpy(xp, ctx->one, k * sizeof(limb_t));
+    }
+    if (ok) {
+        from_form(ctx, xp, xp, tp);
+        ok = ttak_bigint_set_limbs(dst, xp, k, now);
+    }
+    work_give(&w);
+    return ok;
+}
+
+/**
+ * @brief Limb-level product in internal form.
+ */
+bool ttak_bigint_mont_mul_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, const limb_t *bp,
+                            limb_t *tp, uint64_t now) {
+    return mul_form(ctx, rp, ap, bp, tp, now);
+}
+
+/**
+ * @brief Limb-level modular sum; both forms add the same way.
+ */
+void ttak_bigint_mont_add_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, const limb_t *bp) {
+    size_t k = ctx->k;
+    limb_t cy = ttak_limbs_add_n(rp, ap, bp, k);
+    if (cy || cmp_n(rp, ctx->n, k) >= 0) ttak_limbs_sub_n(rp, rp, ctx->n, k);
+}
+
+/**
+ * @brief Limb-level modular difference.
+ */
+void ttak_bigint_mont_sub_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, const limb_t *bp) {
+    size_t k = ctx->k;
+    if (ttak_limbs_sub_n(rp, ap, bp, k)) ttak_limbs_add_n(rp, rp, ctx->n, k);
+}
+
+/**
+ * @brief Limb-level conversion into internal form.
+ */
+bool ttak_bigint_mont_to_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const ttak_bigint_t *a, limb_t *tp,
+                           uint64_t now) {
+    return to_form(ctx, rp, a, tp, now);
+}
+
+/**
+ * @brief Limb-level conversion out of internal form.
+ */
+void ttak_bigint_mont_from_n(const ttak_bigint_mont_ctx_t *ctx, limb_t *rp, const limb_t *ap, limb_t *tp) {
+    from_form(ctx, rp, ap, tp);
+}
+
+/**
+ * @brief One-off modular product through a temporary context.
+ */
+bool ttak_bigint_mulmod(ttak_bigint_t *dst, const ttak_bigint_t *a, const ttak_bigint_t *b,
+                        const ttak_bigint_t *n, uint64_t now) {
+    ttak_bigint_mont_ctx_t ctx;
+    if (!ttak_bigint_mont_init(&ctx, n, now)) return false;
+    size_t k = ctx.k;
+    mont_work_t w;
+    limb_t *ws = work_take(&w, 2 * k + MONT_WORK_LIMBS(k), now);
+    bool ok = ws != NULL;
+    if (ok) {
+        limb_t *ap = ws;
+        limb_t *bp = ws + k;
+        limb_t *tp = bp + k;
+        ok = to_form(&ctx, ap, a, tp, now) && to_form(&ctx, bp, b, tp, now) &&
+             mul_form(&ctx, ap, ap, bp, tp, now);
+        if (ok) {
+            from_form(&ctx, ap, ap, tp);
+            ok = ttak_bigint_set_limbs(dst, ap, k, now);
+        }
+        work_give(&w);
+    }
+    ttak_bigint_mont_free(&ctx);
+    return ok;
+}
+
+/**
+ * @brief One-off modular exponentiation through a temporary context.
+ */
+bool ttak_bigint_powmod(ttak_bigint_t *dst, const ttak_bigint_t *base, const ttak_bigint_t *exp,
+                        const ttak_bigint_t *n, uint64_t now) {
+    ttak_bigint_mont_ctx_t ctx;
+    if (!ttak_bigint_mont_init(&ctx, n, now)) return false;
+    bool ok = ttak_bigint_mont_powmod(&ctx, dst, base, exp, now);
+    ttak_bigint_mont_free(&ctx);
+    return ok;
+}
@@ -1,5 +1,6 @@
 #include <ttak/math/bigreal.h>
 #include <ttak/mem/mem.h>
+#include <math.h>
 #include <string.h>
 #include <stdalign.h>
 
@@ -176,3 +177,69 @@ int ttak_bigreal_cmp(const ttak_bigreal_t *lhs, const ttak_bigreal_t *rhs, uint6
     ttak_bigreal_free(&r, now);
     return res;
 }
+
+/*
+ * v * 10^exponent. 10^k for k <= 22 is exact in a double, so the common
+ * case rounds once; larger powers are split so the factor stays finite.
+ */
+static double ttak_bigreal_scale10(double v, int64_t exponent) {
+    if (exponent > 700) return v * INFINITY;
+    if (exponent < -700) return v * 0.0;
+    if (exponent > 300) {
+        v *= 1e300;
+        exponent -= 300;
+    } else if (exponent < -300) {
+        v /= 1e300;
+        exponent += 300;
+    }
+    return exponent >= 0 ? v * pow(10.0, (double)exponent) : v / pow(10.0, (double)-exponent);
+}
+
+_Bool ttak_bigreal_to_double(const ttak_bigreal_t *br, double *out) {
+    const ttak_bigint_t *m = &br->mantissa;
+    const limb_t *limbs = ttak_bigint_limbs(m);
+    size_t used = m->used;
+    double v = 0.0;
+    if (used > 0 && limbs) {
+        /* Three limbs hold at least 96 bits, well past a double's 53. */
+        size_t low = used > 3 ? used - 3 : 0;
+        for (size_t i = used; i-- > low;) {
+            v = ldexp(v, TTAK_BIGINT_LIMB_BITS) + (double)limbs[i];
+        }
+        size_t shift = low * TTAK_BIGINT_LIMB_BITS;
+        v = shift > 1100 ? v * INFINITY : ldexp(v, (int)shift);
+    }
+    if (v != 0.0) v = ttak_bigreal_scale10(v, br->exponent);
+    if (m->is_negative) v = -v;
+    *out = v;
+    return isfinite(v);
+}
+
+_Bool ttak_bigreal_set_double(ttak_bigreal_t *br, double value, uint64_t now) {
+    if (!isfinite(value)) return false;
+    double mag = fabs(value);
+    uint64_t mant;
+    int64_t exponent = 0;
+    if (mag == 0.0) {
+        mant = 0;
+    } else if (mag < 18446744073709551616.0 && mag == floor(mag)) {
+        mant = (uint64_t)mag;
+    } else {
+        /* Scale to 17 significant digits, below 10^17 and so below 2^64. */
+        exponent = (int64_t)floor(log10(mag)) - 16;
+        double scaled = ttak_bigreal_scale10(mag, -exponent);
+        if (scaled >= 1e17) {
+            exponent++;
+            scaled = ttak_bigreal_scale10(mag, -exponent);
+        }
+        mant = (uint64_t)llround(scaled);
+        while (mant != 0 && mant % 10 == 0) {
+            mant /= 10;
+            exponent++;
+        }
+    }
+    if (!ttak_bigint_set_u64(&br->mantissa, mant, now)) return false;
+    br->mantissa.is_negative = value < 0.0 && mant != 0;
+    br->exponent = exponent;
+    return true;
+}
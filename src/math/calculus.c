@@ -1,9 +1,16 @@
 #include <ttak/math/calculus.h>
+#include <ttak/async/sched.h>
+#include <ttak/thread/parallel.h>
 #include <ttak/thread/pool.h>
-#include <ttak/async/future.h>
+#include <ttak/thread/ws_deque.h>
+#include <ttak/arch/ttak_arch.h>
 #include <ttak/mem/mem.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <float.h>
 #include <math.h>
+#include <sched.h>
 
 _Bool ttak_calculus_diff(ttak_bigreal_t *res, ttak_math_func_t f, const ttak_bigreal_t *x, void *ctx, uint64_t now) {
     if (!res || !f || !x) return false;
@@ -106,12 +113,16 @@ static void* integrate_worker(void *arg) {
     return NULL;
 }
 
+static void integrate_body(void *ctx, size_t begin, size_t end) {
+    integrate_interval_t *intervals = (integrate_interval_t *)ctx;
+    for (size_t i = begin; i < end; i++) integrate_worker(&intervals[i]);
+}
+
 _Bool ttak_calculus_integrate(ttak_bigreal_t *res, ttak_math_func_t f, const ttak_bigreal_t *a, const ttak_bigreal_t *b, void *ctx, uint64_t now) {
     if (!res || !f || !a || !b) return false;
     
     int num_intervals = 4;
     integrate_interval_t intervals[4];
-    ttak_future_t *futures[4];
     
     ttak_bigreal_t step, current;
     ttak_bigreal_init(&step, now);
@@ -131,16 +142,13 @@ _Bool ttak_calculus_integrate(ttak_bigreal_t *res, ttak_math_func_t f, const tta
         ttak_bigreal_copy(&intervals[i].a, &current, now);
         ttak_bigreal_add(&current, &current, &step, now);
         ttak_bigreal_copy(&intervals[i].b, &current, now);
-        
-        futures[i] = ttak_thread_pool_submit_task(async_pool, integrate_worker, &intervals[i], __TT_SCHED_NORMAL__, now);
     }
     
+    ttak_parallel_for(ttak_async_pool(), 0, (size_t)num_intervals, 1, integrate_body, intervals, now);
+    
     ttak_bigreal_init_u64(res, 0, now);
     for (int i = 0; i < num_intervals; i++) {
-        if (futures[i]) {
-            ttak_future_get(futures[i]);
-            ttak_bigreal_add(res, res, &intervals[i].result, now);
-        }
+        ttak_bigreal_add(res, res, &intervals[i].result, now);
     }
     
     for (int i = 0; i < num_intervals; i++) {
@@ -154,6 +162,278 @@ _Bool ttak_calculus_integrate(ttak_bigreal_t *res, ttak_math_func_t f, const tta
     return true;
 }
 
+/*
+ * Gauss-Kronrod G7/K15 abscissae and weights (QUADPACK qk15). The odd
+ * Kronrod nodes and the centre are the Gauss nodes.
+ */
+static const double quad_xgk[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.0,
+};
+static const double quad_wgk[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714,
+};
+static const double quad_wg[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327,
+};
+
+#define QUAD_POINTS 15
+
+typedef struct {
+    double a, b;
+    double integral, error;
+    unsigned depth;
+} quad_node_t;
+
+/* One participant: its deque and the subintervals it accepted. */
+typedef struct {
+    ttak_ws_deque_t deque;
+    double sum, comp, error;
+    size_t intervals, evaluations;
+} quad_slot_t;
+
+typedef struct {
+    ttak_math_batch_func_t f;
+    void *ctx;
+    double tol_per_width;
+    quad_node_t *nodes;
+    size_t node_cap;
+    _Atomic size_t node_next;
+    _Atomic size_t pending; /* Subintervals created but not yet accepted or dropped. */
+    _Atomic bool failed;
+    _Atomic bool capped;
+    quad_slot_t *slots;
+    size_t nslots;
+} quad_job_t;
+
+void ttak_calculus_quad_options_init(ttak_calculus_quad_options_t *options) {
+    if (!options) return;
+    options->abs_tol = 1e-12;
+    options->rel_tol = 1e-10;
+    options->max_intervals = TTAK_CALCULUS_QUAD_DEFAULT_MAX_INTERVALS;
+    options->pool = ttak_async_pool();
+    options->now = 0;
+}
+
+/* Applies K15 and its error estimate to the 15 values belonging to node. */
+static void quad_rule(quad_node_t *node, const double *y) {
+    const double half = 0.5 * (node->b - node->a);
+    const double fc = y[0];
+    double resg = fc * quad_wg[3];
+    double resk = fc * quad_wgk[7];
+    double resabs = fabs(resk);
+    for (int j = 0; j < 7; j++) {
+        const double f1 = y[1 + 2 * j], f2 = y[2 + 2 * j];
+        resk += quad_wgk[j] * (f1 + f2);
+        resabs += quad_wgk[j] * (fabs(f1) + fabs(f2));
+        if (j & 1) resg += quad_wg[j >> 1] * (f1 + f2);
+    }
+    const double mean = 0.5 * resk;
+    double resasc = quad_wgk[7] * fabs(fc - mean);
+    for (int j = 0; j < 7; j++) resasc += quad_wgk[j] * (fabs(y[1 + 2 * j] - mean) + fabs(y[2 + 2 * j] - mean));
+    resabs *= half;
+    resasc *= half;
+    double err = fabs((resk - resg) * half);
+    if (resasc != 0.0 && err != 0.0) err = resasc * fmin(1.0, pow(200.0 * err / resasc, 1.5));
+    if (resabs > DBL_MIN / (50.0 * DBL_EPSILON)) err = fmax(50.0 * DBL_EPSILON * resabs, err);
+    node->integral = resk * half;
+    node->error = err;
+}
+
+/* Evaluates one or two nodes with a single batch call. */
+static bool quad_eval(quad_job_t *job, quad_slot_t *slot, quad_node_t *const *nodes, size_t count) {
+    double x[2 * QUAD_POINTS], y[2 * QUAD_POINTS];
+    for (size_t k = 0; k < count; k++) {
+        const double c = 0.5 * (nodes[k]->a + nodes[k]->b);
+        const double half = 0.5 * (nodes[k]->b - nodes[k]->a);
+        double *xk = x + k * QUAD_POINTS;
+        xk[0] = c;
+        for (int j = 0; j < 7; j++) {
+            xk[1 + 2 * j] = c - half * quad_xgk[j];
+            xk[2 + 2 * j] = c + half * quad_xgk[j];
+        }
+    }
+    const size_t n = count * QUAD_POINTS;
+    slot->evaluations += n;
+    if (!job->f(y, x, n, job->ctx)) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (!isfinite(y[i])) return false;
+    }
+    for (size_t k = 0; k < count; k++) quad_rule(nodes[k], y + k * QUAD_POINTS);
+    return true;
+}
+
+static void quad_accept(quad_job_t *job, quad_slot_t *slot, const quad_node_t *node) {
+    /* Neumaier summation keeps thousands of small pieces from drifting. */
+    const double t = slot->sum + node->integral;
+    if (fabs(slot->sum) >= fabs(node->integral)) {
+        slot->comp += (slot->sum - t) + node->integral;
+    } else {
+        slot->comp += (node->integral - t) + slot->sum;
+    }
+    slot->sum = t;
+    slot->error += node->error;
+    slot->intervals++;
+    atomic_fetch_sub_explicit(&job->pending, 1, memory_order_release);
+}
+
+/*
+ * Accepts or bisects node. A bisection pushes the half with the smaller
+ * error for thieves and returns the other to keep refining here.
+ */
+static quad_node_t *quad_refine(quad_job_t *job, quad_slot_t *slot, quad_node_t *node) {
+    if (atomic_load_explicit(&job->failed, memory_order_relaxed)) {
+        atomic_fetch_sub_explicit(&job->pending, 1, memory_order_release);
+        return NULL;
+    }
+    const double width = node->b - node->a;
+    if (node->error <= job->tol_per_width * width) {
+        quad_accept(job, slot, node);
+        return NULL;
+    }
+    const double mid = node->a + 0.5 * width;
+    size_t at = SIZE_MAX;
+    if (node->depth < TTAK_CALCULUS_QUAD_MAX_DEPTH && mid > node->a && mid < node->b) {
+        at = atomic_fetch_add_explicit(&job->node_next, 2, memory_order_relaxed);
+    }
+    if (at >= job->node_cap || job->node_cap - at < 2) {
+        atomic_store_explicit(&job->capped, true, memory_order_relaxed);
+        quad_accept(job, slot, node);
+        return NULL;
+    }
+
+    quad_node_t *left = &job->nodes[at], *right = left + 1;
+    *left = (quad_node_t){ .a = node->a, .b = mid, .depth = node->depth + 1 };
+    *right = (quad_node_t){ .a = mid, .b = node->b, .depth = node->depth + 1 };
+    quad_node_t *const pair[2] = { left, right };
+    if (!quad_eval(job, slot, pair, 2)) {
+        atomic_store_explicit(&job->failed, true, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&job->pending, 1, memory_order_release);
+        return NULL;
+    }
+
+    quad_node_t *keep = left->error >= right->error ? left : right;
+    quad_node_t *give = keep == left ? right : left;
+    atomic_fetch_add_explicit(&job->pending, 1, memory_order_relaxed);
+    if (!ttak_ws_deque_push(&slot->deque, give)) {
+        atomic_store_explicit(&job->failed, true, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&job->pending, 1, memory_order_release);
+    }
+    return keep;
+}
+
+static void quad_body(void *ctx, size_t begin, size_t end) {
+    quad_job_t *job = (quad_job_t *)ctx;
+    for (size_t me = begin; me < end; me++) {
+        quad_slot_t *slot = &job->slots[me];
+        unsigned idle = 0;
+        for (;;) {
+            quad_node_t *node = ttak_ws_deque_pop(&slot->deque);
+            for (size_t k = 1; !node && k < job->nslots; k++) {
+                node = ttak_ws_deque_steal(&job->slots[(me + k) % job->nslots].deque);
+            }
+            if (!node) {
+                if (atomic_load_explicit(&job->pending, memory_order_acquire) == 0) break;
+                if (++idle < 64) {
+                    ttak_arch_pause();
+                } else {
+                    sched_yield();
+                }
+                continue;
+            }
+            idle = 0;
+            while (node) node = quad_refine(job, slot, node);
+        }
+    }
+}
+
+_Bool ttak_calculus_integrate_f64(ttak_calculus_quad_result_t *out, ttak_math_batch_func_t f, double a, double b,
+                                  const ttak_calculus_quad_options_t *options, void *ctx) {
+    if (!out || !f || !isfinite(a) || !isfinite(b)) return false;
+    ttak_calculus_quad_options_t defaults;
+    if (!options) {
+        ttak_calculus_quad_options_init(&defaults);
+        options = &defaults;
+    }
+    if (!(options->abs_tol >= 0.0) || !(options->rel_tol >= 0.0)) return false;
+
+    *out = (ttak_calculus_quad_result_t){ .converged = true };
+    if (a == b) return true;
+    double sign = 1.0;
+    if (a > b) {
+        const double t = a;
+        a = b;
+        b = t;
+        sign = -1.0;
+    }
+    if (!isfinite(b - a)) return false;
+
+    size_t nslots = 1;
+    if (options->pool) nslots += ttak_thread_pool_live_workers(options->pool);
+    if (nslots > TTAK_CALCULUS_QUAD_MAX_SLOTS) nslots = TTAK_CALCULUS_QUAD_MAX_SLOTS;
+
+    quad_job_t job = {
+        .f = f,
+        .ctx = ctx,
+        .node_cap = options->max_intervals ? options->max_intervals : TTAK_CALCULUS_QUAD_DEFAULT_MAX_INTERVALS,
+        .nslots = nslots,
+    };
+    bool ok = false;
+    size_t ready = 0;
+    job.nodes = malloc(job.node_cap * sizeof(*job.nodes));
+    job.slots = aligned_alloc(_Alignof(quad_slot_t), nslots * sizeof(*job.slots));
+    if (!job.nodes || !job.slots) goto cleanup;
+    for (; ready < nslots; ready++) {
+        job.slots[ready] = (quad_slot_t){ .sum = 0.0 };
+        if (!ttak_ws_deque_init(&job.slots[ready].deque, 0)) goto cleanup;
+    }
+
+    quad_node_t *root = &job.nodes[0];
+    *root = (quad_node_t){ .a = a, .b = b };
+    quad_node_t *const first[1] = { root };
+    if (!quad_eval(&job, &job.slots[0], first, 1)) goto cleanup;
+
+    /* The relative target is fixed from the first estimate so every
+     * participant tests against the same threshold without sharing a sum. */
+    const double tol = fmax(options->abs_tol, options->rel_tol * fabs(root->integral));
+    job.tol_per_width = tol / (b - a);
+    atomic_init(&job.node_next, 1);
+    atomic_init(&job.pending, 1);
+    atomic_init(&job.failed, false);
+    atomic_init(&job.capped, false);
+    if (!ttak_ws_deque_push(&job.slots[0].deque, root)) goto cleanup;
+
+    ttak_parallel_for(nslots > 1 ? options->pool : NULL, 0, nslots, 1, quad_body, &job, options->now);
+    if (atomic_load_explicit(&job.failed, memory_order_relaxed)) goto cleanup;
+
+    double sum = 0.0, comp = 0.0;
+    for (size_t i = 0; i < nslots; i++) {
+        const quad_slot_t *slot = &job.slots[i];
+        const double part = slot->sum + slot->comp;
+        const double t = sum + part;
+        comp += fabs(sum) >= fabs(part) ? (sum - t) + part : (part - t) + sum;
+        sum = t;
+        out->error += slot->error;
+        out->intervals += slot->intervals;
+        out->evaluations += slot->evaluations;
+    }
+    out->value = sign * (sum + comp);
+    out->converged = !atomic_load_explicit(&job.capped, memory_order_relaxed);
+    ok = true;
+
+cleanup:
+    for (size_t i = 0; i < ready; i++) ttak_ws_deque_destroy(&job.slots[i].deque);
+    free(job.slots);
+    free(job.nodes);
+    return ok;
+}
+
 _Bool ttak_calculus_rk4_step(ttak_bigreal_t *y_next, ttak_math_func_t f, const ttak_bigreal_t *t, const ttak_bigreal_t *y, const ttak_bigreal_t *h, void *ctx, uint64_t now) {
     if (!y_next || !f || !t || !y || !h) return false;
 
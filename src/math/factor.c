@@ -1,6 +1,13 @@
 #include <ttak/math/factor.h>
+#include <ttak/async/sched.h>
+#include <ttak/math/bigint_mont.h>
+#include <ttak/math/prime.h>
 #include <ttak/mem/mem.h>
+#include <ttak/priority/nice.h>
+#include "../../internal/ttak/factor_internal.h"
 
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <string.h>
 
@@ -16,26 +23,6 @@ typedef struct {
     uint64_t now;
 } ttak_factor_ctx_t;
 
-static const uint16_t k_small_primes[] = {
-    2,  3,  5,  7, 11, 13, 17, 19, 23, 29,
-    31, 37, 41, 43, 47, 53, 59, 61, 67, 71,
-    73, 79, 83, 89, 97,101,103,107,109,113,
-    127,131,137,139,149,151,157,163,167,173,
-    179,181,191,193,197,199,211,223,227,229,
-    233,239,241,251,257,263,269,271,277,281,
-    283,293,307,311,313,317,331,337,347,349,
-    353,359,367,373,379,383,389,397,401,409,
-    419,421,431,433,439,443,449,457,461,463,
-    467,479,487,491,499,503,509,521,523,541,
-    547,557,563,569,571,577,587,593,599,601,
-    607,613,617,619,631,641,643,647,653,659,
-    661,673,677,683,691,701,709,719,727,733,
-    739,743,751,757,761,769,773,787,797,809,
-    811,821,823,827,829,839,853,857,859,863,
-    877,881,883,887,907,911,919,929,937,941,
-    947,953,967,971,977,983,991,997
-};
-
 /**
  * @brief Compute Greatest Common Divisor using the binary (Stein) algorithm outlined in Dae-yeon-gu-il-sul.
  *
@@ -72,6 +59,12 @@ static inline uint64_t ttak_prng_next(uint64_t *state) {
     return z ^ (z >> 31);
 }
 
+/* (a + b) mod @p mod for reduced operands, even when the sum passes 2^64. */
+static inline uint64_t ttak_addmod_u64(uint64_t a, uint64_t b, uint64_t mod) {
+    uint64_t sum = a + b;
+    return (sum < a || sum >= mod) ? sum - mod : sum;
+}
+
 static inline uint64_t ttak_mulmod_u64(uint64_t a, uint64_t b, uint64_t mod) {
 #if HAVE_UINT128
     return (uint64_t)(((__uint128_t)a * (__uint128_t)b) % mod);
@@ -88,52 +81,6 @@ static inline uint64_t ttak_mulmod_u64(uint64_t a, uint64_t b, uint64_t mod) {
 #endif
 }
 
-static uint64_t ttak_powmod_u64(uint64_t base, uint64_t exponent, uint64_t mod) {
-    uint64_t result = 1ULL;
-    while (exponent > 0) {
-        if (exponent & 1ULL) {
-            result = ttak_mulmod_u64(result, base, mod);
-        }
-        base = ttak_mulmod_u64(base, base, mod);
-        exponent >>= 1ULL;
-    }
-    return result;
-}
-
-static bool ttak_miller_rabin_u64(uint64_t n) {
-    if (n < 2) return false;
-    for (size_t i = 0; i < sizeof(k_small_primes)/sizeof(k_small_primes[0]); ++i) {
-        uint64_t p = k_small_primes[i];
-        if (n == p) return true;
-        if (n % p == 0 && n != p) return false;
-    }
-
-    uint64_t d = n - 1;
-    uint32_t s = 0;
-    while ((d & 1ULL) == 0) {
-        d >>= 1ULL;
-        ++s;
-    }
-
-    static const uint64_t bases[] = {2ULL, 3ULL, 5ULL, 7ULL, 11ULL, 13ULL};
-    for (size_t i = 0; i < sizeof(bases)/sizeof(bases[0]); ++i) {
-        uint64_t a = bases[i] % n;
-        if (a == 0) continue;
-        uint64_t x = ttak_powmod_u64(a, d, n);
-        if (x == 1ULL || x == n - 1) continue;
-        bool witness = true;
-        for (uint32_t r = 1; r < s; ++r) {
-            x = ttak_mulmod_u64(x, x, n);
-            if (x == n - 1) {
-                witness = false;
-                break;
-            }
-        }
-        if (witness) return false;
-    }
-    return true;
-}
-
 static uint64_t ttak_pollard_rho_brent(uint64_t n, ttak_factor_ctx_t *ctx) {
     if ((n & 1ULL) == 0ULL) return 2ULL;
     uint64_t c = ttak_prng_next(&ctx->rng_state) % (n - 1ULL) + 1ULL;
@@ -143,21 +90,22 @@ static uint64_t ttak_pollard_rho_brent(uint64_t n, ttak_factor_ctx_t *ctx) {
     uint64_t r = 1ULL;
     uint64_t q = 1ULL;
     uint64_t ys = 0ULL;
+    uint64_t x = 0ULL;
 
     while (g == 1ULL) {
-        uint64_t x = y;
+        x = y;
         for (uint64_t i = 0; i < r; ++i) {
-            y = (ttak_mulmod_u64(y, y, n) + c) % n;
+            y = ttak_addmod_u64(ttak_mulmod_u64(y, y, n), c, n);
         }
         uint64_t k = 0ULL;
         while (k < r && g == 1ULL) {
             ys = y;
             uint64_t limit = (m < (r - k)) ? m : (r - k);
             for (uint64_t i = 0; i < limit; ++i) {
-                y = (ttak_mulmod_u64(y, y, n) + c) % n;
-                uint64_t diff = ttak_abs_diff_u64(x, y);
-                if (diff == 0) continue;
-                q = ttak_mulmod_u64(q, diff, n);
+                y = ttak_addmod_u64(ttak_mulmod_u64(y, y, n), c, n);
+                /* A zero difference zeroes q, so g becomes n and the caller
+                 * retries with another constant instead of looping forever. */
+                q = ttak_mulmod_u64(q, ttak_abs_diff_u64(x, y), n);
             }
             g = ttak_gcd_u64(q, n);
             k += limit;
@@ -166,9 +114,9 @@ static uint64_t ttak_pollard_rho_brent(uint64_t n, ttak_factor_ctx_t *ctx) {
     }
 
     if (g == n) {
+        /* Step from the last checkpoint against the same x the batch used. */
         do {
-            uint64_t x = ys;
-            ys = (ttak_mulmod_u64(ys, ys, n) + c) % n;
+            ys = ttak_addmod_u64(ttak_mulmod_u64(ys, ys, n), c, n);
             g = ttak_gcd_u64(ttak_abs_diff_u64(x, ys), n);
         } while (g == 1ULL);
     }
@@ -217,7 +165,7 @@ static int ttak_record_factor(uint64_t p, ttak_factor_ctx_t *ctx) {
 
 static int ttak_factor_recursive(uint64_t n, ttak_factor_ctx_t *ctx) {
     if (n == 1) return 0;
-    if (ttak_miller_rabin_u64(n)) {
+    if (ttak_is_prime_u64(n)) {
         return ttak_record_factor(n, ctx);
     }
 
@@ -258,8 +206,10 @@ int ttak_factor_u64(uint64_t n, ttak_prime_factor_t **factors_out, size_t *count
         .now = now
     };
 
-    for (size_t i = 0; i < sizeof(k_small_primes)/sizeof(k_small_primes[0]); ++i) {
-        uint16_t p = k_small_primes[i];
+    size_t small_count = 0;
+    const uint16_t *small = ttak_prime_small_table(&small_count);
+    for (size_t i = 0; i < small_count; ++i) {
+        uint16_t p = small[i];
         if ((uint64_t)p * (uint64_t)p > n) break;
         while (n % p == 0) {
             if (ttak_record_factor(p, &ctx) != 0) goto fail;
@@ -282,6 +232,112 @@ fail:
     return -1;
 }
 
+/*
+ * Index-claiming parallel loop shared by the ECM and sieve engines, built
+ * like the one behind ttak_ntt_plan_convolve(). The last reference frees it.
+ */
+typedef struct factor_job {
+    _Atomic size_t refs;
+    _Atomic size_t next;
+    size_t count;
+    size_t done;
+    void (*fn)(void *ctx, size_t index);
+    void *ctx;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} factor_job_t;
+
+static void factor_job_release(factor_job_t *job) {
+    if (atomic_fetch_sub_explicit(&job->refs, 1, memory_order_acq_rel) != 1) return;
+    pthread_cond_destroy(&job->cond);
+    pthread_mutex_destroy(&job->lock);
+    ttak_mem_free_lite(job);
+}
+
+static void factor_job_drain(factor_job_t *job) {
+    size_t ran = 0;
+    for (;;) {
+        size_t i = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (i >= job->count) break;
+        job->fn(job->ctx, i);
+        ran++;
+    }
+    if (!ran) return;
+    pthread_mutex_lock(&job->lock);
+    job->done += ran;
+    if (job->done == job->count) pthread_cond_broadcast(&job->cond);
+    pthread_mutex_unlock(&job->lock);
+}
+
+static void *factor_job_helper(void *arg) {
+    factor_job_t *job = arg;
+    factor_job_drain(job);
+    factor_job_release(job);
+    return NULL;
+}
+
+void ttak_factor_parallel_for(ttak_thread_pool_t *pool, size_t count, void (*fn)(void *ctx, size_t index),
+                              void *ctx, uint64_t now) {
+    size_t helpers = pool && count > 1 ? ttak_thread_pool_live_workers(pool) : 0;
+    if (helpers > count - 1) helpers = count - 1;
+    factor_job_t *job = NULL;
+    if (helpers) job = ttak_mem_alloc_lite(sizeof(*job), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    if (!job) {
+        for (size_t i = 0; i < count; i++) fn(ctx, i);
+        return;
+    }
+    atomic_init(&job->refs, 1 + helpers);
+    atomic_init(&job->next, 0);
+    job->count = count;
+    job->done = 0;
+    job->fn = fn;
+    job->ctx = ctx;
+    pthread_mutex_init(&job->lock, NULL);
+    pthread_cond_init(&job->cond, NULL);
+    for (size_t h = 0; h < helpers; h++) {
+        if (!ttak_thread_pool_submit_detached(pool, factor_job_helper, job, __TT_SCHED_NORMAL__, now)) {
+            atomic_fetch_sub_explicit(&job->refs, helpers - h, memory_order_acq_rel);
+            break;
+        }
+    }
+    factor_job_drain(job);
+    pthread_mutex_lock(&job->lock);
+    while (job->done < job->count) pthread_cond_wait(&job->cond, &job->lock);
+    pthread_mutex_unlock(&job->lock);
+    factor_job_release(job);
+}
+
+/**
+ * @brief Euclid's algorithm on big integers.
+ *
+ * @param g   Receives gcd(|a|, |b|); may alias either operand.
+ * @param a   First operand.
+ * @param b   Second operand.
+ * @param now Timestamp for allocations.
+ * @return true on success, false on allocation failure.
+ */
+bool ttak_factor_gcd(ttak_bigint_t *g, const ttak_bigint_t *a, const ttak_bigint_t *b, uint64_t now) {
+    ttak_bigint_t x, y, r;
+    ttak_bigint_init_copy(&x, a, now);
+    ttak_bigint_init_copy(&y, b, now);
+    ttak_bigint_init(&r, now);
+    x.is_negative = false;
+    y.is_negative = false;
+    bool ok = true;
+    while (ok && !ttak_bigint_is_zero(&y)) {
+        ok = ttak_bigint_mod(&r, &x, &y, now);
+        ttak_bigint_t t = x;
+        x = y;
+        y = r;
+        r = t;
+    }
+    if (ok) ok = ttak_bigint_copy(g, &x, now);
+    ttak_bigint_free(&x, now);
+    ttak_bigint_free(&y, now);
+    ttak_bigint_free(&r, now);
+    return ok;
+}
+
 /**
  * @brief Append or increment a big prime factor within the dynamic list.
  *
@@ -315,22 +371,173 @@ static int add_factor_big(const ttak_bigint_t *p, ttak_prime_factor_big_t **fact
 }
 
 
-// NOTE: This is a trial division implementation for big integers. It is correct but will be
-// very slow for numbers with large prime factors. For a "fast" implementation as requested,
-// this should be replaced or augmented with algorithms like Pollard's Rho or the
-// Elliptic Curve Method (ECM), especially for factors beyond a certain bit size.
+/* Miller-Rabin bases for big cofactors: the primes up to 53. */
+#define FACTOR_BIG_MR_ROUNDS 16
+
 /**
- * @brief Factor a big integer via naive trial division.
+ * @brief Strong probable-prime test of an odd big integer.
+ *
+ * Runs Miller-Rabin over the first FACTOR_BIG_MR_ROUNDS primes as bases.
+ * Every round is one Montgomery exponentiation plus squarings in
+ * Montgomery form, so no step divides by @p n.
+ *
+ * @param n   Odd value above 2^64 to test.
+ * @param now Timestamp for allocations.
+ * @return true when @p n passes every round, false when it is composite or memory ran out.
+ */
+static bool ttak_miller_rabin_big(const ttak_bigint_t *n, uint64_t now) {
+    ttak_bigint_mont_ctx_t ctx;
+    if (!ttak_bigint_mont_init(&ctx, n, now)) return false;
+
+    ttak_bigint_t n_minus_1, d, a, x, m1_form;
+    ttak_bigint_init(&n_minus_1, now);
+    ttak_bigint_init(&d, now);
+    ttak_bigint_init(&a, now);
+    ttak_bigint_init(&x, now);
+    ttak_bigint_init(&m1_form, now);
+
+    bool ok = ttak_bigint_copy(&n_minus_1, n, now) && ttak_bigint_set_u64(&a, 1, now) &&
+              ttak_bigint_sub(&n_minus_1, &n_minus_1, &a, now) && ttak_bigint_copy(&d, &n_minus_1, now) &&
+              ttak_bigint_mont_to(&ctx, &m1_form, &n_minus_1, now);
+    uint32_t s = 0;
+    uint64_t low = 0;
+    while (ok && ttak_bigint_mod_u64(&x, &d, 1ULL << 32, now) && ttak_bigint_export_u64(&x, &low) && low == 0) {
+        ok = ttak_bigint_div_u64(&d, NULL, &d, 1ULL << 32, now);
+        s += 32;
+    }
+    while (ok && (low & 1u) == 0) {
+        low >>= 1;
+        ++s;
+        ok = ttak_bigint_div_u64(&d, NULL, &d, 2, now);
+    }
+
+    const uint16_t *bases = ttak_prime_small_table(NULL);
+    bool prime = ok;
+    for (size_t i = 0; prime && i < FACTOR_BIG_MR_ROUNDS; ++i) {
+        if (!ttak_bigint_set_u64(&a, bases[i], now) || !ttak_bigint_mont_powmod(&ctx, &x, &a, &d, now)) {
+            prime = false;
+            break;
+        }
+        if (ttak_bigint_cmp_u64(&x, 1) == 0 || ttak_bigint_cmp(&x, &n_minus_1) == 0) continue;
+        bool witness = ttak_bigint_mont_to(&ctx, &x, &x, now);
+        for (uint32_t r = 1; witness && r < s; ++r) {
+            if (!ttak_bigint_mont_mul(&ctx, &x, &x, &x, now)) break;
+            if (ttak_bigint_cmp(&x, &m1_form) == 0) witness = false;
+        }
+        if (witness) prime = false;
+    }
+
+    ttak_bigint_free(&n_minus_1, now);
+    ttak_bigint_free(&d, now);
+    ttak_bigint_free(&a, now);
+    ttak_bigint_free(&x, now);
+    ttak_bigint_free(&m1_form, now);
+    ttak_bigint_mont_free(&ctx);
+    return prime;
+}
+
+/* Trial division bound for big inputs; cofactors are then free of primes below it. */
+#define FACTOR_BIG_TRIAL_BOUND 65536
+
+/* ECM schedule: B1, curve count, and the factor size in digits each level targets. */
+static const struct {
+    uint64_t b1;
+    size_t curves;
+    unsigned digits;
+} k_ecm_levels[] = {
+    {    2000,   25, 15 },
+    {   11000,   90, 20 },
+    {   50000,  300, 25 },
+    {  250000,  700, 30 },
+    { 1000000, 1800, 35 },
+    { 3000000, 5100, 40 },
+};
+
+/**
+ * @brief r = floor(c^(1/e)) by Newton's iteration from above.
+ */
+static bool big_root(ttak_bigint_t *r, const ttak_bigint_t *c, uint32_t e, uint64_t now) {
+    ttak_bigint_t x, y, t;
+    ttak_bigint_init_u64(&x, 1, now);
+    ttak_bigint_init(&y, now);
+    ttak_bigint_init(&t, now);
+    bool ok = true;
+    for (size_t bits = (ttak_bigint_get_bit_length(c) + e - 1) / e; ok && bits > 0; bits -= bits > 32 ? 32 : bits) {
+        ok = ttak_bigint_mul_u64(&x, &x, 1ULL << (bits > 32 ? 32 : bits), now);
+    }
+    /* y = ((e - 1) x + c / x^(e - 1)) / e until that stops decreasing. */
+    while (ok) {
+        ok = ttak_bigint_set_u64(&t, 1, now);
+        for (uint32_t i = 1; ok && i < e; ++i) ok = ttak_bigint_mul(&t, &t, &x, now);
+        ok = ok && ttak_bigint_div(&y, NULL, c, &t, now) && ttak_bigint_mul_u64(&t, &x, e - 1, now) &&
+             ttak_bigint_add(&y, &y, &t, now) && ttak_bigint_div_u64(&y, NULL, &y, e, now);
+        if (!ok || ttak_bigint_cmp(&y, &x) >= 0) break;
+        ttak_bigint_t swap = x;
+        x = y;
+        y = swap;
+    }
+    if (ok) ok = ttak_bigint_copy(r, &x, now);
+    ttak_bigint_free(&x, now);
+    ttak_bigint_free(&y, now);
+    ttak_bigint_free(&t, now);
+    return ok;
+}
+
+/**
+ * @brief Find r and e > 1 with r^e = c, for c free of factors below FACTOR_BIG_TRIAL_BOUND.
+ * @return The exponent, 1 when @p c is not a perfect power, 0 on allocation failure.
+ */
+static uint32_t big_perfect_power(ttak_bigint_t *r, const ttak_bigint_t *c, uint64_t now) {
+    size_t bits = ttak_bigint_get_bit_length(c);
+    ttak_bigint_t t;
+    ttak_bigint_init(&t, now);
+    uint32_t found = 1;
+    /* The root exceeds 2^16, so only exponents up to bits / 16 are possible. */
+    for (uint32_t e = 2; e <= bits / 16 && found == 1; ++e) {
+        if (e > 2 && !ttak_is_prime_u64(e)) continue;
+        bool ok = big_root(r, c, e, now) && ttak_bigint_set_u64(&t, 1, now);
+        for (uint32_t i = 0; ok && i < e; ++i) ok = ttak_bigint_mul(&t, &t, r, now);
+        if (!ok) found = 0;
+        else if (ttak_bigint_cmp(&t, c) == 0) found = e;
+    }
+    ttak_bigint_free(&t, now);
+    return found;
+}
+
+/**
+ * @brief Split the composite @p c, which has no factor below FACTOR_BIG_TRIAL_BOUND.
+ *
+ * ECM runs the levels whose target size is at most 30% of the digits of
+ * @p c (all of them past the sieve's range); the quadratic sieve goes last.
+ *
+ * @return 1 with a proper factor in @p f, 0 when nothing split it, -1 on allocation failure.
+ */
+static int big_split(const ttak_bigint_t *c, ttak_bigint_t *f, uint64_t now) {
+    unsigned digits = (unsigned)(ttak_bigint_get_bit_length(c) * 0.30103) + 1;
+    bool sieve = digits <= TTAK_FACTOR_SIQS_MAX_DIGITS;
+    for (size_t i = 0; i < sizeof(k_ecm_levels) / sizeof(k_ecm_levels[0]); ++i) {
+        if (sieve && i > 0 && k_ecm_levels[i].digits * 10 > digits * 3) break;
+        ttak_factor_ecm_params_t params = { k_ecm_levels[i].b1, 0, k_ecm_levels[i].curves, 6 + 7919 * i };
+        int got = ttak_factor_ecm(c, &params, ttak_async_pool(), f, now);
+        if (got != 0) return got;
+    }
+    return sieve ? ttak_factor_siqs(c, ttak_async_pool(), f, now) : 0;
+}
+
+/**
+ * @brief Factor a big integer.
+ *
+ * Trial division strips the primes below FACTOR_BIG_TRIAL_BOUND. The
+ * cofactors then go through a work stack: 64-bit ones to ttak_factor_u64(),
+ * probable primes to the result, perfect powers to their root, and the rest
+ * to big_split().
  *
  * @param n           Value to factor (must be > 1).
  * @param factors_out Output array of big factors.
  * @param count_out   Number of factors produced.
  * @param now         Timestamp for allocations.
- * @return 0 on success, -1 when allocation fails.
+ * @return 0 on success, -1 when allocation fails, -2 when a cofactor could not be split.
  */
-/* Hard stop so big-int trial division cannot stall forever on tough inputs. */
-#define FACTOR_BIG_TRIAL_LIMIT 500000
-
 int ttak_factor_big(const ttak_bigint_t *n, ttak_prime_factor_big_t **factors_out, size_t *count_out, uint64_t now) {
     if (ttak_bigint_is_zero(n) || ttak_bigint_cmp_u64(n, 1) <= 0) {
         *factors_out = NULL;
@@ -384,71 +591,102 @@ int ttak_factor_big(const ttak_bigint_t *n, ttak_prime_factor_big_t **factors_ou
     size_t capacity = 0;
     int ret = -1;
 
-    ttak_bigint_t temp_n, rem, p;
-    ttak_bigint_init_copy(&temp_n, n, now);
+    ttak_bigint_t rem, p;
     ttak_bigint_init(&rem, now);
-    ttak_bigint_init_u64(&p, 2, now);
-
-    // Handle factor 2
-    ttak_bigint_mod_u64(&rem, &temp_n, 2, now);
-    while (ttak_bigint_is_zero(&rem)) {
-        if (add_factor_big(&p, &factors, &count, &capacity, now) != 0) goto big_fail;
-        ttak_bigint_div_u64(&temp_n, NULL, &temp_n, 2, now);
-        ttak_bigint_mod_u64(&rem, &temp_n, 2, now);
+    ttak_bigint_init(&p, now);
+    ttak_bigint_t *stack = NULL;
+    size_t depth = 0, stack_cap = 0;
+    uint64_t *sieve = ttak_prime_odd_bits(FACTOR_BIG_TRIAL_BOUND, now);
+    if (!sieve) goto cleanup;
+
+    stack_cap = 8;
+    stack = ttak_mem_alloc_raw(stack_cap * sizeof(ttak_bigint_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!stack) goto cleanup;
+    ttak_bigint_init_copy(&stack[depth++], n, now);
+
+    /* rem takes each quotient, p the remainder and then the prime itself. */
+    ttak_bigint_t *cofactor = &stack[0];
+    for (uint64_t d = 2; d < FACTOR_BIG_TRIAL_BOUND; d = d == 2 ? 3 : d + 2) {
+        if (d > 2 && !ttak_prime_is_odd_marked(sieve, d)) continue;
+        uint64_t r = 0;
+        if (!ttak_bigint_div_u64(&rem, &p, cofactor, d, now) || !ttak_bigint_export_u64(&p, &r)) goto cleanup;
+        while (r == 0) {
+            if (!ttak_bigint_set_u64(&p, d, now) || add_factor_big(&p, &factors, &count, &capacity, now) != 0 ||
+                !ttak_bigint_copy(cofactor, &rem, now) || !ttak_bigint_div_u64(&rem, &p, cofactor, d, now) ||
+                !ttak_bigint_export_u64(&p, &r)) {
+                goto cleanup;
+            }
+        }
     }
 
-    // Handle odd factors
-    ttak_bigint_set_u64(&p, 3, now);
-    ttak_bigint_t p_squared;
-    ttak_bigint_init(&p_squared, now);
-    ttak_bigint_mul(&p_squared, &p, &p, now);
-
-    size_t trial_steps = 0;
-    while (ttak_bigint_cmp(&p_squared, &temp_n) <= 0) {
-        if (trial_steps++ >= FACTOR_BIG_TRIAL_LIMIT) {
-            goto big_fail_limit;
+    while (depth > 0) {
+        ttak_bigint_t c = stack[--depth];
+        uint64_t small = 0;
+        int step = 0;
+        if (ttak_bigint_cmp_u64(&c, 1) <= 0) {
+            step = 0;
+        } else if (ttak_bigint_export_u64(&c, &small)) {
+            ttak_prime_factor_t *u64_factors = NULL;
+            size_t u64_count = 0;
+            step = ttak_factor_u64(small, &u64_factors, &u64_count, now) == 0 ? 0 : -1;
+            for (size_t i = 0; step == 0 && i < u64_count; ++i) {
+                if (!ttak_bigint_set_u64(&p, u64_factors[i].p, now)) step = -1;
+                for (uint32_t a = 0; step == 0 && a < u64_factors[i].a; ++a) {
+                    if (add_factor_big(&p, &factors, &count, &capacity, now) != 0) step = -1;
+                }
+            }
+            if (u64_factors) ttak_mem_free(u64_factors);
+        } else if (ttak_miller_rabin_big(&c, now)) {
+            step = add_factor_big(&c, &factors, &count, &capacity, now);
+        } else {
+            uint32_t e = big_perfect_power(&p, &c, now);
+            bool power = e > 1;
+            int split = power ? 1 : e == 0 ? -1 : big_split(&c, &p, now);
+            if (split == 1 && !power && !ttak_bigint_div(&rem, NULL, &c, &p, now)) split = -1;
+            /* A split pushes the factor and its cofactor, a perfect power e copies of its root. */
+            size_t pushes = power ? e : 2;
+            if (split == 1 && depth + pushes > stack_cap) {
+                size_t grown_cap = (depth + pushes) * 2;
+                ttak_bigint_t *grown = ttak_mem_realloc_raw(stack, grown_cap * sizeof(ttak_bigint_t),
+                                                            __TTAK_UNSAFE_MEM_FOREVER__, now);
+                if (grown) {
+                    stack = grown;
+                    stack_cap = grown_cap;
+                } else {
+                    split = -1;
+                }
+            }
+            for (size_t i = 0; split == 1 && i < pushes; ++i) {
+                ttak_bigint_init_copy(&stack[depth++], !power && i == 1 ? &rem : &p, now);
+            }
+            step = split == 1 ? 0 : split == 0 ? -2 : -1;
         }
-        ttak_bigint_mod(&rem, &temp_n, &p, now);
-        while (ttak_bigint_is_zero(&rem)) {
-            if (add_factor_big(&p, &factors, &count, &capacity, now) != 0) goto big_fail;
-            ttak_bigint_div(&temp_n, NULL, &temp_n, &p, now);
-            ttak_bigint_mod(&rem, &temp_n, &p, now);
+        ttak_bigint_free(&c, now);
+        if (step != 0) {
+            ret = step;
+            goto cleanup;
         }
-        ttak_bigint_add_u64(&p, &p, 2, now);
-        ttak_bigint_mul(&p_squared, &p, &p, now);
-    }
-
-    if (ttak_bigint_cmp_u64(&temp_n, 1) > 0) {
-        if (add_factor_big(&temp_n, &factors, &count, &capacity, now) != 0) goto big_fail;
     }
 
-    *factors_out = factors;
-    *count_out = count;
-
-    ttak_bigint_free(&temp_n, now);
+    ttak_mem_free(stack);
+    ttak_mem_free(sieve);
     ttak_bigint_free(&rem, now);
     ttak_bigint_free(&p, now);
-    ttak_bigint_free(&p_squared, now);
+    *factors_out = factors;
+    *count_out = count;
     return 0;
 
-big_fail:
-    ret = -1;
-    goto cleanup;
-
-big_fail_limit:
-    ret = -2;
-    goto cleanup;
-
 cleanup:
-    for(size_t i = 0; i < count; ++i) {
+    for (size_t i = 0; i < depth; ++i) ttak_bigint_free(&stack[i], now);
+    if (stack) ttak_mem_free(stack);
+    if (sieve) ttak_mem_free(sieve);
+    for (size_t i = 0; i < count; ++i) {
         ttak_bigint_free(&factors[i].p, now);
     }
-    ttak_mem_free(factors);
+    if (factors) ttak_mem_free(factors);
     *factors_out = NULL;
     *count_out = 0;
-    ttak_bigint_free(&temp_n, now);
     ttak_bigint_free(&rem, now);
     ttak_bigint_free(&p, now);
-    ttak_bigint_free(&p_squared, now);
     return ret;
 }
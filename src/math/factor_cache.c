@@ -0,0 +1,567 @@
+/**
+ * @file factor_cache.c
+ * @brief Sharded CLOCK cache of factorisations with an append-only store.
+ *
+ * Memory and disk hold entries in the same record form, so a store hit is
+ * one copy and a miss is one append:
+ *
+ *   u32 bytes, u32 key limbs, u32 factor count, u32 sigma limbs, u64 hash,
+ *   key limbs, then per factor u32 exponent, u32 limbs and the prime's
+ *   limbs, then sigma's limbs, padded to 8 bytes.
+ *
+ * The store starts with an 8-byte magic and the limb width. Its index is
+ * rebuilt by one pass over the mapped file at open; entries appended later
+ * lie past the mapping and are read back with pread().
+ */
+
+#include <ttak/math/factor_cache.h>
+#include <ttak/math/sum_divisors.h>
+#include <ttak/ht/map.h>
+#include <ttak/io/mmap.h>
+#include <ttak/mem/mem.h>
+#include <ttak/sync/sync.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define FC_MAGIC "TTAKFAC1"
+#define FC_FILE_HEAD 16u
+#define FC_REC_HEAD 24u
+
+typedef struct fc_head {
+    uint32_t bytes;
+    uint32_t key_limbs;
+    uint32_t factor_count;
+    uint32_t sigma_limbs;
+    uint64_t hash;
+} fc_head_t;
+
+typedef struct fc_slot {
+    uint8_t *rec;
+    uint64_t hash;
+    bool referenced;
+} fc_slot_t;
+
+typedef struct fc_shard {
+    _Alignas(64) ttak_mutex_t lock;
+    tt_map_t *index; /* hash -> slot */
+    fc_slot_t *slots;
+    size_t cap;
+    size_t used;
+    size_t hand;
+} fc_shard_t;
+
+struct ttak_factor_cache {
+    fc_shard_t shards[TTAK_FACTOR_CACHE_SHARDS];
+    ttak_mutex_t store_lock;
+    tt_map_t *store_index; /* hash -> file offset */
+    ttak_io_mmap_t *store_map;
+    size_t store_mapped;   /* Bytes covered by store_map. */
+    size_t store_end;
+    size_t stored;
+    int store_fd;
+    _Atomic uint64_t hits;
+    _Atomic uint64_t store_hits;
+    _Atomic uint64_t misses;
+    _Atomic uint64_t evictions;
+};
+
+static size_t fc_limb_count(const ttak_bigint_t *bi) {
+    return (ttak_bigint_get_bit_length(bi) + TTAK_BIGINT_LIMB_BITS - 1) / TTAK_BIGINT_LIMB_BITS;
+}
+
+static uint64_t fc_hash(const ttak_bigint_t *n) {
+    uint8_t digest[32];
+    uint64_t h;
+    ttak_bigint_hash(n, digest);
+    memcpy(&h, digest, sizeof(h));
+    return h;
+}
+
+static size_t fc_pad8(size_t bytes) {
+    return (bytes + 7u) & ~(size_t)7u;
+}
+
+static void fc_read_head(const uint8_t *rec, fc_head_t *head) {
+    memcpy(&head->bytes, rec, 4);
+    memcpy(&head->key_limbs, rec + 4, 4);
+    memcpy(&head->factor_count, rec + 8, 4);
+    memcpy(&head->sigma_limbs, rec + 12, 4);
+    memcpy(&head->hash, rec + 16, 8);
+}
+
+/* Checks that the record's lengths add up to its size; @p avail bounds the read. */
+static bool fc_rec_valid(const uint8_t *rec, size_t avail) {
+    if (avail < FC_REC_HEAD) return false;
+    fc_head_t head;
+    fc_read_head(rec, &head);
+    if (head.bytes < FC_REC_HEAD || head.bytes > avail || head.bytes % 8 != 0) return false;
+    size_t off = FC_REC_HEAD + (size_t)head.key_limbs * sizeof(limb_t);
+    for (uint32_t i = 0; i < head.factor_count; ++i) {
+        if (off + 8 > head.bytes) return false;
+        uint32_t limbs;
+        memcpy(&limbs, rec + off + 4, 4);
+        off += 8 + (size_t)limbs * sizeof(limb_t);
+    }
+    off += (size_t)head.sigma_limbs * sizeof(limb_t);
+    return fc_pad8(off) == head.bytes;
+}
+
+static bool fc_rec_matches(const uint8_t *rec, const ttak_bigint_t *n, size_t limbs) {
+    fc_head_t head;
+    fc_read_head(rec, &head);
+    return head.key_limbs == limbs &&
+           memcmp(rec + FC_REC_HEAD, ttak_bigint_limbs(n), limbs * sizeof(limb_t)) == 0;
+}
+
+static size_t fc_put_limbs(uint8_t *dst, const ttak_bigint_t *bi, size_t limbs) {
+    memcpy(dst, ttak_bigint_limbs(bi), limbs * sizeof(limb_t));
+    return limbs * sizeof(limb_t);
+}
+
+static uint8_t *fc_encode(const ttak_bigint_t *n, uint64_t hash, const ttak_prime_factor_big_t *factors,
+                          size_t count, const ttak_bigint_t *sigma, uint64_t now) {
+    size_t key_limbs = fc_limb_count(n);
+    size_t sigma_limbs = fc_limb_count(sigma);
+    size_t bytes = FC_REC_HEAD + (key_limbs + sigma_limbs) * sizeof(limb_t);
+    for (size_t i = 0; i < count; ++i) {
+        bytes += 8 + fc_limb_count(&factors[i].p) * sizeof(limb_t);
+    }
+    bytes = fc_pad8(bytes);
+    if (bytes > UINT32_MAX || count > UINT32_MAX) return NULL;
+    uint8_t *rec = ttak_mem_alloc_raw(bytes, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!rec) return NULL;
+    memset(rec, 0, bytes);
+
+    uint32_t fields[4] = { (uint32_t)bytes, (uint32_t)key_limbs, (uint32_t)count, (uint32_t)sigma_limbs };
+    memcpy(rec, fields, sizeof(fields));
+    memcpy(rec + 16, &hash, sizeof(hash));
+    size_t off = FC_REC_HEAD + fc_put_limbs(rec + FC_REC_HEAD, n, key_limbs);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t pair[2] = { factors[i].a, (uint32_t)fc_limb_count(&factors[i].p) };
+        memcpy(rec + off, pair, sizeof(pair));
+        off += 8 + fc_put_limbs(rec + off + 8, &factors[i].p, pair[1]);
+    }
+    fc_put_limbs(rec + off, sigma, sigma_limbs);
+    return rec;
+}
+
+static bool fc_set_limbs(ttak_bigint_t *dst, const uint8_t *src, size_t limbs, uint64_t now) {
+    limb_t tmp[TTAK_BIGINT_SSO_LIMIT];
+    limb_t *buf = tmp;
+    if (limbs > TTAK_BIGINT_SSO_LIMIT) {
+        buf = ttak_mem_alloc_lite(limbs * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, 0, TTAK_MEM_DEFAULT);
+        if (!buf) return false;
+    }
+    memcpy(buf, src, limbs * sizeof(limb_t));
+    bool ok = limbs ? ttak_bigint_set_limbs(dst, buf, limbs, now) : ttak_bigint_set_u64(dst, 0, now);
+    if (buf != tmp) ttak_mem_free_lite(buf);
+    return ok;
+}
+
+void ttak_factor_cache_free_factors(ttak_prime_factor_big_t *factors, size_t count, uint64_t now) {
+    if (!factors) return;
+    for (size_t i = 0; i < count; ++i) {
+        ttak_bigint_free(&factors[i].p, now);
+    }
+    ttak_mem_free(factors);
+}
+
+static bool fc_decode(const uint8_t *rec, ttak_prime_factor_big_t **factors_out, size_t *count_out,
+                      ttak_bigint_t *sigma_out, uint64_t now) {
+    fc_head_t head;
+    fc_read_head(rec, &head);
+    size_t off = FC_REC_HEAD + (size_t)head.key_limbs * sizeof(limb_t);
+    ttak_prime_factor_big_t *factors = NULL;
+    if (factors_out && head.factor_count > 0) {
+        factors = ttak_mem_alloc_raw(head.factor_count * sizeof(*factors), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (!factors) return false;
+        for (uint32_t i = 0; i < head.factor_count; ++i) {
+            ttak_bigint_init(&factors[i].p, now);
+        }
+    }
+    bool ok = true;
+    for (uint32_t i = 0; i < head.factor_count; ++i) {
+        uint32_t pair[2];
+        memcpy(pair, rec + off, sizeof(pair));
+        if (factors) {
+            factors[i].a = pair[0];
+            ok = ok && fc_set_limbs(&factors[i].p, rec + off + 8, pair[1], now);
+        }
+        off += 8 + (size_t)pair[1] * sizeof(limb_t);
+    }
+    if (sigma_out) ok = ok && fc_set_limbs(sigma_out, rec + off, head.sigma_limbs, now);
+    if (!ok) {
+        ttak_factor_cache_free_factors(factors, head.factor_count, now);
+        return false;
+    }
+    if (factors_out) *factors_out = factors;
+    if (count_out) *count_out = head.factor_count;
+    return true;
+}
+
+/* sigma(n) = prod (1 + p + ... + p^a). */
+static bool fc_sigma(const ttak_prime_factor_big_t *factors, size_t count, ttak_bigint_t *sigma, uint64_t now) {
+    ttak_bigint_t term, power;
+    ttak_bigint_init(&term, now);
+    ttak_bigint_init(&power, now);
+    bool ok = ttak_bigint_set_u64(sigma, 1, now);
+    for (size_t i = 0; ok && i < count; ++i) {
+        ok = ttak_bigint_set_u64(&term, 1, now) && ttak_bigint_set_u64(&power, 1, now);
+        for (uint32_t e = 0; ok && e < factors[i].a; ++e) {
+            ok = ttak_bigint_mul(&power, &power, &factors[i].p, now) && ttak_bigint_add(&term, &term, &power, now);
+        }
+        ok = ok && ttak_bigint_mul(sigma, sigma, &term, now);
+    }
+    ttak_bigint_free(&term, now);
+    ttak_bigint_free(&power, now);
+    return ok;
+}
+
+static fc_shard_t *fc_shard(ttak_factor_cache_t *cache, uint64_t hash) {
+    return &cache->shards[(hash >> 32) & (TTAK_FACTOR_CACHE_SHARDS - 1)];
+}
+
+/* Looks @p n up in memory and decodes it under the shard lock. */
+static bool fc_memory_get(ttak_factor_cache_t *cache, const ttak_bigint_t *n, size_t limbs, uint64_t hash,
+                          ttak_prime_factor_big_t **factors_out, size_t *count_out, ttak_bigint_t *sigma_out,
+                          bool *decoded, uint64_t now) {
+    fc_shard_t *shard = fc_shard(cache, hash);
+    size_t slot;
+    bool found = false;
+    *decoded = false;
+    ttak_mutex_lock(&shard->lock);
+    if (ttak_map_get_key(shard->index, (uintptr_t)hash, &slot, now) && shard->slots[slot].hash == hash &&
+        fc_rec_matches(shard->slots[slot].rec, n, limbs)) {
+        shard->slots[slot].referenced = true;
+        found = true;
+        *decoded = fc_decode(shard->slots[slot].rec, factors_out, count_out, sigma_out, now);
+    }
+    ttak_mutex_unlock(&shard->lock);
+    return found;
+}
+
+/* Hands @p rec to the shard, evicting with the CLOCK hand when it is full. */
+static void fc_memory_put(ttak_factor_cache_t *cache, uint8_t *rec, uint64_t hash, uint64_t now) {
+    fc_shard_t *shard = fc_shard(cache, hash);
+    size_t slot;
+    ttak_mutex_lock(&shard->lock);
+    if (ttak_map_get_key(shard->index, (uintptr_t)hash, &slot, now) && shard->slots[slot].hash == hash) {
+        /* Same hash: either n raced in twice or collided; keep the newer. */
+        ttak_mem_free(shard->slots[slot].rec);
+    } else if (shard->used < shard->cap) {
+        slot = shard->used++;
+        ttak_insert_to_map(shard->index, (uintptr_t)hash, slot, now);
+    } else {
+        while (shard->slots[shard->hand].referenced) {
+            shard->slots[shard->hand].referenced = false;
+            shard->hand = (shard->hand + 1) % shard->cap;
+        }
+        slot = shard->hand;
+        shard->hand = (shard->hand + 1) % shard->cap;
+        ttak_delete_from_map(shard->index, (uintptr_t)shard->slots[slot].hash, now);
+        ttak_mem_free(shard->slots[slot].rec);
+        atomic_fetch_add_explicit(&cache->evictions, 1, memory_order_relaxed);
+        ttak_insert_to_map(shard->index, (uintptr_t)hash, slot, now);
+    }
+    shard->slots[slot].rec = rec;
+    shard->slots[slot].hash = hash;
+    shard->slots[slot].referenced = false;
+    ttak_mutex_unlock(&shard->lock);
+}
+
+#ifndef _WIN32
+/* Copies the record at @p off out of the mapping, or the file past its end. */
+static uint8_t *fc_store_read(ttak_factor_cache_t *cache, size_t off, uint64_t now) {
+    uint8_t head_buf[FC_REC_HEAD];
+    const uint8_t *mapped = NULL;
+    if (off < cache->store_mapped) {
+        if (ttak_io_mmap_retain(cache->store_map, off, FC_REC_HEAD, &mapped, now) != TTAK_IO_SUCCESS) return NULL;
+        memcpy(head_buf, mapped, FC_REC_HEAD);
+        ttak_io_mmap_release(cache->store_map);
+    } else if (pread(cache->store_fd, head_buf, FC_REC_HEAD, (off_t)off) != (ssize_t)FC_REC_HEAD) {
+        return NULL;
+    }
+    fc_head_t head;
+    fc_read_head(head_buf, &head);
+    uint8_t *rec = ttak_mem_alloc_raw(head.bytes, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!rec) return NULL;
+    bool ok;
+    if (off < cache->store_mapped) {
+        ok = ttak_io_mmap_retain(cache->store_map, off, head.bytes, &mapped, now) == TTAK_IO_SUCCESS;
+        if (ok) {
+            memcpy(rec, mapped, head.bytes);
+            ttak_io_mmap_release(cache->store_map);
+        }
+    } else {
+        ok = pread(cache->store_fd, rec, head.bytes, (off_t)off) == (ssize_t)head.bytes;
+    }
+    if (!ok) {
+        ttak_mem_free(rec);
+        return NULL;
+    }
+    return rec;
+}
+
+static bool fc_write_all(int fd, const uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, buf, len);
+        if (w <= 0) return false;
+        buf += w;
+        len -= (size_t)w;
+    }
+    return true;
+}
+
+/* Opens or creates the store, maps what it holds and indexes every whole record. */
+static bool fc_store_open(ttak_factor_cache_t *cache, const char *path, uint64_t now) {
+    int fd = open(path, O_RDWR | O_CREAT, 0600);
+    if (fd < 0) return false;
+    cache->store_fd = fd;
+    off_t size = lseek(fd, 0, SEEK_END);
+    uint8_t file_head[FC_FILE_HEAD] = FC_MAGIC;
+    uint32_t limb_bits = TTAK_BIGINT_LIMB_BITS;
+    memcpy(file_head + 8, &limb_bits, sizeof(limb_bits));
+
+    size_t end = FC_FILE_HEAD;
+    if (size > (off_t)FC_FILE_HEAD) {
+        int map_fd = dup(fd);
+        if (map_fd >= 0) cache->store_map = ttak_io_mmap_create(map_fd, NULL, UINT64_MAX, 0, now);
+        const uint8_t *data = NULL;
+        if (cache->store_map &&
+            ttak_io_mmap_retain(cache->store_map, 0, cache->store_map->len, &data, now) == TTAK_IO_SUCCESS) {
+            size_t len = cache->store_map->len;
+            if (memcmp(data, file_head, FC_FILE_HEAD) == 0) {
+                while (fc_rec_valid(data + end, len - end)) {
+                    fc_head_t head;
+                    fc_read_head(data + end, &head);
+                    ttak_insert_to_map(cache->store_index, (uintptr_t)head.hash, end, now);
+                    cache->stored++;
+                    end += head.bytes;
+                }
+            }
+            ttak_io_mmap_release(cache->store_map);
+            cache->store_mapped = end;
+        }
+    }
+    if (end == FC_FILE_HEAD) {
+        /* Empty, foreign or unreadable: start the file over. */
+        if (ftruncate(fd, 0) != 0 || lseek(fd, 0, SEEK_SET) != 0 || !fc_write_all(fd, file_head, FC_FILE_HEAD)) {
+            return false;
+        }
+    } else if ((off_t)end != size && ftruncate(fd, (off_t)end) != 0) {
+        return false;
+    }
+    cache->store_end = end;
+    return lseek(fd, (off_t)end, SEEK_SET) == (off_t)end;
+}
+#endif
+
+/* A copy of the stored record for @p n, or NULL. */
+static uint8_t *fc_store_get(ttak_factor_cache_t *cache, const ttak_bigint_t *n, size_t limbs, uint64_t hash,
+                             uint64_t now) {
+    uint8_t *rec = NULL;
+#ifndef _WIN32
+    size_t off;
+    if (cache->store_fd < 0) return NULL;
+    ttak_mutex_lock(&cache->store_lock);
+    if (ttak_map_get_key(cache->store_index, (uintptr_t)hash, &off, now)) {
+        rec = fc_store_read(cache, off, now);
+    }
+    ttak_mutex_unlock(&cache->store_lock);
+    if (rec && !fc_rec_matches(rec, n, limbs)) {
+        ttak_mem_free(rec);
+        rec = NULL;
+    }
+#else
+    (void)cache;
+    (void)n;
+    (void)limbs;
+    (void)hash;
+    (void)now;
+#endif
+    return rec;
+}
+
+static void fc_store_put(ttak_factor_cache_t *cache, const uint8_t *rec, uint64_t hash, uint64_t now) {
+#ifndef _WIN32
+    if (cache->store_fd < 0) return;
+    fc_head_t head;
+    fc_read_head(rec, &head);
+    ttak_mutex_lock(&cache->store_lock);
+    if (!ttak_map_get_key(cache->store_index, (uintptr_t)hash, NULL, now)) {
+        if (fc_write_all(cache->store_fd, rec, head.bytes)) {
+            ttak_insert_to_map(cache->store_index, (uintptr_t)hash, cache->store_end, now);
+            cache->store_end += head.bytes;
+            cache->stored++;
+        } else if (ftruncate(cache->store_fd, (off_t)cache->store_end) != 0 ||
+                   lseek(cache->store_fd, (off_t)cache->store_end, SEEK_SET) != (off_t)cache->store_end) {
+            /* A torn tail is cut at the next open; stop appending until then. */
+            close(cache->store_fd);
+            cache->store_fd = -1;
+        }
+    }
+    ttak_mutex_unlock(&cache->store_lock);
+#else
+    (void)cache;
+    (void)rec;
+    (void)hash;
+    (void)now;
+#endif
+}
+
+ttak_factor_cache_t *ttak_factor_cache_create(size_t capacity, const char *store_path, uint64_t now) {
+    if (capacity == 0) return NULL;
+    ttak_factor_cache_t *cache = ttak_mem_alloc_raw(sizeof(*cache), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!cache) return NULL;
+    memset(cache, 0, sizeof(*cache));
+    cache->store_fd = -1;
+    ttak_mutex_init(&cache->store_lock);
+    size_t per_shard = (capacity + TTAK_FACTOR_CACHE_SHARDS - 1) / TTAK_FACTOR_CACHE_SHARDS;
+    bool ok = true;
+    for (size_t i = 0; i < TTAK_FACTOR_CACHE_SHARDS; ++i) {
+        fc_shard_t *shard = &cache->shards[i];
+        ttak_mutex_init(&shard->lock);
+        shard->cap = per_shard;
+        shard->index = ttak_create_map(2 * per_shard, now);
+        shard->slots = ttak_mem_alloc_raw(per_shard * sizeof(fc_slot_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        ok = ok && shard->index && shard->slots;
+    }
+    if (ok && store_path) {
+#ifndef _WIN32
+        cache->store_index = ttak_create_map(64, now);
+        ok = cache->store_index && fc_store_open(cache, store_path, now);
+#else
+        ok = false;
+#endif
+    }
+    if (!ok) {
+        ttak_factor_cache_destroy(cache, now);
+        return NULL;
+    }
+    return cache;
+}
+
+void ttak_factor_cache_destroy(ttak_factor_cache_t *cache, uint64_t now) {
+    if (!cache) return;
+    for (size_t i = 0; i < TTAK_FACTOR_CACHE_SHARDS; ++i) {
+        fc_shard_t *shard = &cache->shards[i];
+        for (size_t s = 0; s < shard->used; ++s) {
+            ttak_mem_free(shard->slots[s].rec);
+        }
+        if (shard->slots) ttak_mem_free(shard->slots);
+        if (shard->index) ttak_destroy_map(shard->index);
+        ttak_mutex_destroy(&shard->lock);
+    }
+#ifndef _WIN32
+    if (cache->store_map) ttak_io_mmap_close(cache->store_map, now);
+    if (cache->store_fd >= 0) close(cache->store_fd);
+#endif
+    if (cache->store_index) ttak_destroy_map(cache->store_index);
+    ttak_mutex_destroy(&cache->store_lock);
+    ttak_mem_free(cache);
+}
+
+bool ttak_factor_cache_get(ttak_factor_cache_t *cache, const ttak_bigint_t *n, ttak_prime_factor_big_t **factors_out,
+                           size_t *count_out, ttak_bigint_t *sigma_out, uint64_t now) {
+    if (!cache || !n || n->is_negative || ttak_bigint_cmp_u64(n, 1) <= 0) return false;
+    size_t limbs = fc_limb_count(n);
+    uint64_t hash = fc_hash(n);
+    bool decoded;
+    if (fc_memory_get(cache, n, limbs, hash, factors_out, count_out, sigma_out, &decoded, now)) {
+        atomic_fetch_add_explicit(&cache->hits, 1, memory_order_relaxed);
+        return decoded;
+    }
+
+    uint8_t *rec = fc_store_get(cache, n, limbs, hash, now);
+    if (rec) {
+        atomic_fetch_add_explicit(&cache->store_hits, 1, memory_order_relaxed);
+        decoded = fc_decode(rec, factors_out, count_out, sigma_out, now);
+        fc_memory_put(cache, rec, hash, now);
+        return decoded;
+    }
+
+    atomic_fetch_add_explicit(&cache->misses, 1, memory_order_relaxed);
+    ttak_prime_factor_big_t *factors = NULL;
+    size_t count = 0;
+    if (ttak_factor_big(n, &factors, &count, now) != 0) return false;
+    ttak_bigint_t sigma;
+    ttak_bigint_init(&sigma, now);
+    bool ok = fc_sigma(factors, count, &sigma, now);
+    if (ok) {
+        rec = fc_encode(n, hash, factors, count, &sigma, now);
+        if (rec) {
+            fc_store_put(cache, rec, hash, now);
+            fc_memory_put(cache, rec, hash, now);
+        }
+        if (sigma_out) ok = ttak_bigint_copy(sigma_out, &sigma, now);
+    }
+    ttak_bigint_free(&sigma, now);
+    if (ok && factors_out) {
+        *factors_out = factors;
+        if (count_out) *count_out = count;
+    } else {
+        ttak_factor_cache_free_factors(factors, count, now);
+        if (ok && count_out) *count_out = count;
+    }
+    return ok;
+}
+
+bool ttak_factor_cache_sum_proper_divisors(ttak_factor_cache_t *cache, const ttak_bigint_t *n,
+                                           ttak_bigint_t *result_out, uint64_t now) {
+    if (!n || !result_out) return false;
+    if (ttak_bigint_cmp_u64(n, 1) <= 0) return ttak_bigint_set_u64(result_out, 0, now);
+    ttak_sumdiv_limits_t limits;
+    ttak_sum_divisors_get_limits(&limits);
+    if (limits.max_input_bits > 0 && ttak_bigint_get_bit_length(n) > limits.max_input_bits) return false;
+    ttak_bigint_t sigma;
+    ttak_bigint_init(&sigma, now);
+    bool ok = ttak_factor_cache_get(cache, n, NULL, NULL, &sigma, now) && ttak_bigint_sub(result_out, &sigma, n, now);
+    ttak_bigint_free(&sigma, now);
+    return ok;
+}
+
+bool ttak_factor_cache_sigma_u64(ttak_factor_cache_t *cache, uint64_t n, ttak_u128_t *sigma_out, uint64_t now) {
+    if (!sigma_out) return false;
+    ttak_bigint_t key, sigma;
+    ttak_bigint_init_u64(&key, n, now);
+    ttak_bigint_init(&sigma, now);
+    bool ok = ttak_factor_cache_get(cache, &key, NULL, NULL, &sigma, now) && ttak_bigint_export_u128(&sigma, sigma_out);
+    ttak_bigint_free(&key, now);
+    ttak_bigint_free(&sigma, now);
+    return ok;
+}
+
+bool ttak_factor_cache_sigma_u128(ttak_factor_cache_t *cache, ttak_u128_t n, ttak_u256_t *sigma_out, uint64_t now) {
+    if (!sigma_out) return false;
+    ttak_bigint_t key, sigma;
+    ttak_bigint_init(&key, now);
+    ttak_bigint_init(&sigma, now);
+    bool ok = ttak_bigint_set_u128(&key, n, now) && ttak_factor_cache_get(cache, &key, NULL, NULL, &sigma, now) &&
+              ttak_bigint_export_u256(&sigma, sigma_out);
+    ttak_bigint_free(&key, now);
+    ttak_bigint_free(&sigma, now);
+    return ok;
+}
+
+void ttak_factor_cache_get_stats(ttak_factor_cache_t *cache, ttak_factor_cache_stats_t *out) {
+    if (!cache || !out) return;
+    out->hits = atomic_load_explicit(&cache->hits, memory_order_relaxed);
+    out->store_hits = atomic_load_explicit(&cache->store_hits, memory_order_relaxed);
+    out->misses = atomic_load_explicit(&cache->misses, memory_order_relaxed);
+    out->evictions = atomic_load_explicit(&cache->evictions, memory_order_relaxed);
+    out->resident = 0;
+    for (size_t i = 0; i < TTAK_FACTOR_CACHE_SHARDS; ++i) {
+        ttak_mutex_lock(&cache->shards[i].lock);
+        out->resident += cache->shards[i].used;
+        ttak_mutex_unlock(&cache->shards[i].lock);
+    }
+    ttak_mutex_lock(&cache->store_lock);
+    out->stored = cache->stored;
+    ttak_mutex_unlock(&cache->store_lock);
+}
@@ -0,0 +1,483 @@
+#include <ttak/math/factor.h>
+#include <ttak/math/bigint_mont.h>
+#include <ttak/math/prime.h>
+#include <ttak/mem/mem.h>
+#include "../../internal/ttak/factor_internal.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+/* Giant step 2 * 3 * 5 * 7 * 11; the residues below D / 2 prime to D are the 240 baby steps. */
+#define ECM_D 2310
+#define ECM_BABY 240
+/* Giant steps normalized per inversion. */
+#define ECM_BATCH 64
+
+/* Stage 2 pass over [B1, B2] reads the shared prime bitmap up to B2 + D. */
+typedef struct ecm_shared {
+    const ttak_bigint_t *n;
+    ttak_bigint_mont_ctx_t ctx;
+    const uint64_t *primes;
+    uint64_t b1;
+    uint64_t b2;
+    uint64_t sigma0;
+    uint64_t now;
+    _Atomic int state; /* 0 searching, 1 factor found, -1 allocation failure. */
+    pthread_mutex_t lock;
+    ttak_bigint_t *factor;
+} ecm_shared_t;
+
+/*
+ * Per-curve state. Residues are k-limb arrays in Montgomery form, carved
+ * out of one block; ok drops to false if a product ever runs out of memory.
+ */
+typedef struct ecm_curve {
+    const ttak_bigint_mont_ctx_t *ctx;
+    size_t k;
+    bool ok;
+    uint64_t now;
+    limb_t *tp;
+    limb_t *t0, *t1, *t2;
+    limb_t *a24;        /* (A + 2) / 4 */
+    limb_t *px, *pz;    /* Ladder base. */
+    limb_t *rx, *rz;    /* Ladder partner. */
+    limb_t *qx, *qz;    /* Point carried through both stages. */
+    limb_t *dx, *dz;    /* D * Q. */
+    limb_t *ax, *az;    /* Stage 2 rolling points. */
+    limb_t *bx, *bz;
+    limb_t *acc;
+    limb_t *baby_x;     /* ECM_BABY normalized x coordinates. */
+    limb_t *baby_z;
+    limb_t *giant_x;    /* ECM_BATCH giant steps. */
+    limb_t *giant_z;
+    limb_t *prefix;     /* Running products for batched inversion. */
+    uint16_t baby_j[ECM_BABY];
+    ttak_bigint_t g;    /* Last gcd that came out above 1. */
+} ecm_curve_t;
+
+#define ECM_SCALARS 17
+#define ECM_VECTOR_LIMBS(k) ((2 * ECM_BABY + 2 * ECM_BATCH + ECM_BABY) * (k))
+
+static inline void ecm_mul(ecm_curve_t *c, limb_t *rp, const limb_t *ap, const limb_t *bp) {
+    if (!ttak_bigint_mont_mul_n(c->ctx, rp, ap, bp, c->tp, c->now)) c->ok = false;
+}
+
+static inline void ecm_add(ecm_curve_t *c, limb_t *rp, const limb_t *ap, const limb_t *bp) {
+    ttak_bigint_mont_add_n(c->ctx, rp, ap, bp);
+}
+
+static inline void ecm_sub(ecm_curve_t *c, limb_t *rp, const limb_t *ap, const limb_t *bp) {
+    ttak_bigint_mont_sub_n(c->ctx, rp, ap, bp);
+}
+
+static inline void ecm_copy(ecm_curve_t *c, limb_t *rp, const limb_t *ap) {
+    memmove(rp, ap, c->k * sizeof(limb_t));
+}
+
+/**
+ * @brief (x2 : z2) = 2 (x : z) on the curve with constant a24. Outputs may alias inputs.
+ */
+static void ecm_xdbl(ecm_curve_t *c, limb_t *x2, limb_t *z2, const limb_t *x, const limb_t *z) {
+    ecm_add(c, c->t1, x, z);
+    ecm_sub(c, c->t0, x, z);
+    ecm_mul(c, c->t1, c->t1, c->t1);
+    ecm_mul(c, c->t0, c->t0, c->t0);
+    ecm_mul(c, x2, c->t0, c->t1);
+    ecm_sub(c, c->t1, c->t1, c->t0);
+    ecm_mul(c, c->t2, c->a24, c->t1);
+    ecm_add(c, c->t2, c->t2, c->t0);
+    ecm_mul(c, z2, c->t1, c->t2);
+}
+
+/**
+ * @brief (x3 : z3) = P + Q given (xd : zd) = P - Q. (x3 : z3) may alias P or Q.
+ */
+static void ecm_xadd(ecm_curve_t *c, limb_t *x3, limb_t *z3, const limb_t *xp, const limb_t *zp,
+                     const limb_t *xq, const limb_t *zq, const limb_t *xd, const limb_t *zd) {
+    ecm_sub(c, c->t0, xp, zp);
+    ecm_add(c, c->t1, xq, zq);
+    ecm_mul(c, c->t0, c->t0, c->t1);
+    ecm_add(c, c->t1, xp, zp);
+    ecm_sub(c, c->t2, xq, zq);
+    ecm_mul(c, c->t1, c->t1, c->t2);
+    ecm_add(c, c->t2, c->t0, c->t1);
+    ecm_sub(c, c->t0, c->t0, c->t1);
+    ecm_mul(c, c->t2, c->t2, c->t2);
+    ecm_mul(c, c->t0, c->t0, c->t0);
+    ecm_mul(c, c->t2, c->t2, zd);
+    ecm_mul(c, z3, c->t0, xd);
+    ecm_copy(c, x3, c->t2);
+}
+
+/**
+ * @brief (x : z) = s (x : z) by the Montgomery ladder, for s >= 1.
+ */
+static void ecm_ladder(ecm_curve_t *c, limb_t *x, limb_t *z, uint64_t s) {
+    if (s <= 1) return;
+    ecm_copy(c, c->px, x);
+    ecm_copy(c, c->pz, z);
+    ecm_xdbl(c, c->rx, c->rz, x, z);
+    int top = 63 - __builtin_clzll(s);
+    for (int bit = top - 1; bit >= 0; --bit) {
+        if ((s >> bit) & 1u) {
+            ecm_xadd(c, x, z, c->rx, c->rz, x, z, c->px, c->pz);
+            ecm_xdbl(c, c->rx, c->rz, c->rx, c->rz);
+        } else {
+            ecm_xadd(c, c->rx, c->rz, x, z, c->rx, c->rz, c->px, c->pz);
+            ecm_xdbl(c, x, z, x, z);
+        }
+    }
+}
+
+/**
+ * @brief rp = ap^-1 in internal form by the extended Euclidean algorithm.
+ *
+ * @return 1 when @p ap is invertible, 0 when it is not (c->g then holds
+ *         gcd(ap, n)), -1 on allocation failure.
+ */
+static int ecm_invert(ecm_curve_t *c, limb_t *rp, const limb_t *ap) {
+    const ttak_bigint_mont_ctx_t *ctx = c->ctx;
+    uint64_t now = c->now;
+    ttak_bigint_t r0, r1, s0, s1, q, t;
+    ttak_bigint_init(&r0, now);
+    ttak_bigint_init(&r1, now);
+    ttak_bigint_init(&s0, now);
+    ttak_bigint_init_u64(&s1, 1, now);
+    ttak_bigint_init(&q, now);
+    ttak_bigint_init(&t, now);
+
+    ttak_bigint_mont_from_n(ctx, rp, ap, c->tp);
+    bool ok = ttak_bigint_set_limbs(&r0, ctx->n, c->k, now) && ttak_bigint_set_limbs(&r1, rp, c->k, now);
+    while (ok && !ttak_bigint_is_zero(&r1)) {
+        ok = ttak_bigint_div(&q, &t, &r0, &r1, now);
+        ttak_bigint_t swap = r0;
+        r0 = r1;
+        r1 = t;
+        t = swap;
+        ok = ok && ttak_bigint_mul(&t, &q, &s1, now) && ttak_bigint_sub(&t, &s0, &t, now);
+        swap = s0;
+        s0 = s1;
+        s1 = t;
+        t = swap;
+    }
+    int ret = -1;
+    if (ok) {
+        if (ttak_bigint_cmp_u64(&r0, 1) != 0) {
+            ret = ttak_bigint_copy(&c->g, &r0, now) ? 0 : -1;
+        } else {
+            ret = ttak_bigint_mont_to_n(ctx, rp, &s0, c->tp, now) ? 1 : -1;
+        }
+    }
+    ttak_bigint_free(&r0, now);
+    ttak_bigint_free(&r1, now);
+    ttak_bigint_free(&s0, now);
+    ttak_bigint_free(&s1, now);
+    ttak_bigint_free(&q, now);
+    ttak_bigint_free(&t, now);
+    return ret;
+}
+
+/**
+ * @brief xs[i] = xs[i] / zs[i] for @p count points with one inversion (Montgomery's trick).
+ * @return As ecm_invert().
+ */
+static int ecm_normalize(ecm_curve_t *c, limb_t *xs, const limb_t *zs, size_t count) {
+    size_t k = c->k;
+    limb_t *pre = c->prefix;
+    ecm_copy(c, pre, zs);
+    for (size_t i = 1; i < count; ++i) ecm_mul(c, pre + i * k, pre + (i - 1) * k, zs + i * k);
+    int inv = ecm_invert(c, c->t0, pre + (count - 1) * k);
+    if (inv != 1) return inv;
+    /* t0 runs through (z_0 ... z_i)^-1 while t1 picks out z_i^-1. */
+    for (size_t i = count - 1; i > 0; --i) {
+        ecm_mul(c, c->t1, c->t0, pre + (i - 1) * k);
+        ecm_mul(c, c->t0, c->t0, zs + i * k);
+        ecm_mul(c, xs + i * k, xs + i * k, c->t1);
+    }
+    ecm_mul(c, xs, xs, c->t0);
+    return 1;
+}
+
+/**
+ * @brief c->g = gcd(ap, n).
+ * @return 1 when that is a proper factor, 0 when it is 1 or n, -1 on allocation failure.
+ */
+static int ecm_gcd(ecm_curve_t *c, const ttak_bigint_t *n, const limb_t *ap) {
+    if (!ttak_bigint_set_limbs(&c->g, ap, c->k, c->now) || !ttak_factor_gcd(&c->g, &c->g, n, c->now)) return -1;
+    return ttak_bigint_cmp_u64(&c->g, 1) > 0 && ttak_bigint_cmp(&c->g, n) < 0;
+}
+
+/* A failed inversion returns gcd(z, n); only a proper divisor helps. */
+static int ecm_inverse_outcome(ecm_curve_t *c, const ttak_bigint_t *n, int inv) {
+    if (inv < 0) return -1;
+    return ttak_bigint_cmp(&c->g, n) < 0 ? 1 : 0;
+}
+
+static bool ecm_small_to(ecm_curve_t *c, limb_t *rp, uint64_t v) {
+    ttak_bigint_t b;
+    ttak_bigint_init_u64(&b, v, c->now);
+    bool ok = ttak_bigint_mont_to_n(c->ctx, rp, &b, c->tp, c->now);
+    ttak_bigint_free(&b, c->now);
+    return ok;
+}
+
+/**
+ * @brief Suyama curve for @p sigma: a24 and the start point x = u^3 / v^3 in Q.
+ *
+ * u = sigma^2 - 5, v = 4 sigma, (A + 2) / 4 = (v - u)^3 (3u + v) / (16 u^3 v).
+ * @return 1 on success, 2 when an inversion turned up a factor, 0 when the
+ *         curve is degenerate, -1 on allocation failure.
+ */
+static int ecm_setup(ecm_curve_t *c, const ttak_bigint_t *n, uint64_t sigma) {
+    limb_t *u = c->ax, *v = c->az, *num = c->bx, *den = c->bz;
+    if (!ecm_small_to(c, v, sigma) || !ecm_small_to(c, c->t2, 5)) return -1;
+    ecm_mul(c, u, v, v);
+    ecm_sub(c, u, u, c->t2);                     /* u = sigma^2 - 5 */
+    ecm_add(c, v, v, v);
+    ecm_add(c, v, v, v);                         /* v = 4 sigma */
+    ecm_mul(c, c->qx, u, u);
+    ecm_mul(c, c->qx, c->qx, u);                 /* X = u^3 */
+    ecm_mul(c, c->qz, v, v);
+    ecm_mul(c, c->qz, c->qz, v);                 /* Z = v^3 */
+    ecm_sub(c, num, v, u);
+    ecm_mul(c, c->t2, num, num);
+    ecm_mul(c, num, c->t2, num);                 /* (v - u)^3 */
+    ecm_add(c, c->t2, u, u);
+    ecm_add(c, c->t2, c->t2, u);
+    ecm_add(c, c->t2, c->t2, v);
+    ecm_mul(c, num, num, c->t2);                 /* A24 = (v - u)^3 (3u + v) */
+    ecm_mul(c, den, c->qx, v);
+    ecm_add(c, den, den, den);
+    ecm_add(c, den, den, den);
+    ecm_add(c, den, den, den);
+    ecm_add(c, den, den, den);                   /* C24 = 16 u^3 v */
+    if (!c->ok) return -1;
+
+    /* One inversion of C24 * Z yields both a24 = A24 / C24 and x = X / Z. */
+    ecm_mul(c, c->acc, den, c->qz);
+    int inv = ecm_invert(c, c->acc, c->acc);
+    if (inv != 1) {
+        int found = ecm_inverse_outcome(c, n, inv);
+        return found == 1 ? 2 : found;
+    }
+    ecm_mul(c, c->a24, num, c->qz);
+    ecm_mul(c, c->a24, c->a24, c->acc);
+    ecm_mul(c, c->qx, c->qx, den);
+    ecm_mul(c, c->qx, c->qx, c->acc);
+    ecm_copy(c, c->qz, c->ctx->one);
+    return c->ok ? 1 : -1;
+}
+
+/**
+ * @brief Multiply Q by every prime power up to b1.
+ */
+static void ecm_stage1(ecm_curve_t *c, const ecm_shared_t *sh) {
+    uint64_t b1 = sh->b1;
+    uint64_t q = 2;
+    while (q <= b1 / 2) q *= 2;
+    uint64_t scalar = q;
+    for (uint64_t p = 3; p <= b1 && c->ok; p += 2) {
+        if (!ttak_prime_is_odd_marked(sh->primes, p)) continue;
+        q = p;
+        while (q <= b1 / p) q *= p;
+        if (scalar > UINT64_MAX / q) {
+            ecm_ladder(c, c->qx, c->qz, scalar);
+            scalar = 1;
+            if (atomic_load_explicit(&sh->state, memory_order_relaxed) != 0) return;
+        }
+        scalar *= q;
+    }
+    ecm_ladder(c, c->qx, c->qz, scalar);
+}
+
+static inline bool ecm_stage2_prime(const ecm_shared_t *sh, uint64_t v) {
+    return v > sh->b1 && v <= sh->b2 && ttak_prime_is_odd_marked(sh->primes, v);
+}
+
+/**
+ * @brief Standard continuation: pair giant steps m D Q with baby steps j Q
+ * so that every prime m D +- j in (b1, b2] contributes x(mDQ) - x(jQ).
+ *
+ * @return 1 when a factor is in c->g, 0 when none turned up, -1 on allocation failure.
+ */
+static int ecm_stage2(ecm_curve_t *c, const ecm_shared_t *sh) {
+    size_t k = c->k;
+    const ttak_bigint_t *n = sh->n;
+
+    /* Odd multiples jQ: Q, 3Q, 5Q, ... with 2Q as the constant difference. */
+    size_t baby = 0;
+    ecm_xdbl(c, c->dx, c->dz, c->qx, c->qz);
+    ecm_copy(c, c->ax, c->qx);
+    ecm_copy(c, c->az, c->qz);
+    ecm_xadd(c, c->bx, c->bz, c->dx, c->dz, c->qx, c->qz, c->qx, c->qz);
+    for (uint64_t j = 1; j < ECM_D / 2; j += 2) {
+        limb_t *jx = j == 1 ? c->ax : c->bx;
+        limb_t *jz = j == 1 ? c->az : c->bz;
+        if (j > 3) {
+            /* (a, b) hold ((j - 4) Q, (j - 2) Q); step to ((j - 2) Q, jQ). */
+            ecm_xadd(c, c->ax, c->az, c->bx, c->bz, c->dx, c->dz, c->ax, c->az);
+            limb_t *sx = c->ax, *sz = c->az;
+            c->ax = c->bx;
+            c->az = c->bz;
+            c->bx = sx;
+            c->bz = sz;
+            jx = c->bx;
+            jz = c->bz;
+        }
+        if (j % 3 == 0 || j % 5 == 0 || j % 7 == 0 || j % 11 == 0) continue;
+        ecm_copy(c, c->baby_x + baby * k, jx);
+        ecm_copy(c, c->baby_z + baby * k, jz);
+        c->baby_j[baby++] = (uint16_t)j;
+    }
+    int inv = ecm_normalize(c, c->baby_x, c->baby_z, baby);
+    if (inv != 1) return ecm_inverse_outcome(c, n, inv);
+
+    /* Giant steps from m0 D Q, stepping by D Q. */
+    uint64_t m0 = sh->b1 / ECM_D;
+    if (m0 < 1) m0 = 1;
+    uint64_t m_end = (sh->b2 + ECM_D / 2) / ECM_D + 1;
+    ecm_copy(c, c->dx, c->qx);
+    ecm_copy(c, c->dz, c->qz);
+    ecm_ladder(c, c->dx, c->dz, ECM_D);
+    ecm_copy(c, c->ax, c->dx);
+    ecm_copy(c, c->az, c->dz);
+    ecm_ladder(c, c->ax, c->az, m0);             /* a = m0 D Q */
+    ecm_copy(c, c->bx, c->dx);
+    ecm_copy(c, c->bz, c->dz);
+    ecm_ladder(c, c->bx, c->bz, m0 + 1);         /* b = (m0 + 1) D Q */
+    ecm_copy(c, c->acc, c->ctx->one);
+
+    for (uint64_t m = m0; m < m_end && c->ok; m += ECM_BATCH) {
+        if (atomic_load_explicit(&sh->state, memory_order_relaxed) != 0) return 0;
+        size_t batch = (size_t)(m_end - m < ECM_BATCH ? m_end - m : ECM_BATCH);
+        for (size_t i = 0; i < batch; ++i) {
+            ecm_copy(c, c->giant_x + i * k, c->ax);
+            ecm_copy(c, c->giant_z + i * k, c->az);
+            /* (a, b) = (b, b + D Q) with a as the difference. */
+            ecm_xadd(c, c->ax, c->az, c->bx, c->bz, c->dx, c->dz, c->ax, c->az);
+            limb_t *sx = c->ax, *sz = c->az;
+            c->ax = c->bx;
+            c->az = c->bz;
+            c->bx = sx;
+            c->bz = sz;
+        }
+        inv = ecm_normalize(c, c->giant_x, c->giant_z, batch);
+        if (inv != 1) return ecm_inverse_outcome(c, n, inv);
+        for (size_t i = 0; i < batch; ++i) {
+            uint64_t md = (m + i) * ECM_D;
+            const limb_t *gx = c->giant_x + i * k;
+            for (size_t b = 0; b < baby; ++b) {
+                uint64_t j = c->baby_j[b];
+                if (!ecm_stage2_prime(sh, md - j) && !ecm_stage2_prime(sh, md + j)) continue;
+                ecm_sub(c, c->t2, gx, c->baby_x + b * k);
+                ecm_mul(c, c->acc, c->acc, c->t2);
+            }
+        }
+    }
+    if (!c->ok) return -1;
+    return ecm_gcd(c, n, c->acc);
+}
+
+static int ecm_run_curve(ecm_curve_t *c, const ecm_shared_t *sh, uint64_t sigma) {
+    int setup = ecm_setup(c, sh->n, sigma);
+    if (setup != 1) return setup == 2 ? 1 : setup;
+    ecm_stage1(c, sh);
+    if (!c->ok) return -1;
+    if (atomic_load_explicit(&sh->state, memory_order_relaxed) != 0) return 0;
+    int found = ecm_gcd(c, sh->n, c->qz);
+    /* gcd(z, n) = n means Q hit the identity mod every factor at once. */
+    if (found != 0 || ttak_bigint_cmp_u64(&c->g, 1) != 0) return found;
+    return ecm_stage2(c, sh);
+}
+
+static void ecm_curve_task(void *arg, size_t index) {
+    ecm_shared_t *sh = arg;
+    if (atomic_load_explicit(&sh->state, memory_order_relaxed) != 0) return;
+    size_t k = sh->ctx.k;
+    size_t limbs = TTAK_BIGINT_MONT_WORK_LIMBS(k) + ECM_SCALARS * k + ECM_VECTOR_LIMBS(k);
+    limb_t *block = ttak_mem_alloc_raw(limbs * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, sh->now);
+    if (!block) {
+        int expected = 0;
+        atomic_compare_exchange_strong(&sh->state, &expected, -1);
+        return;
+    }
+
+    ecm_curve_t c;
+    c.ctx = &sh->ctx;
+    c.k = k;
+    c.ok = true;
+    c.now = sh->now;
+    c.tp = block;
+    limb_t *cur = block + TTAK_BIGINT_MONT_WORK_LIMBS(k);
+    limb_t **scalars[ECM_SCALARS] = {
+        &c.t0, &c.t1, &c.t2, &c.a24, &c.px, &c.pz, &c.rx, &c.rz, &c.qx, &c.qz,
+        &c.dx, &c.dz, &c.ax, &c.az, &c.bx, &c.bz, &c.acc
+    };
+    for (size_t i = 0; i < ECM_SCALARS; ++i) {
+        *scalars[i] = cur;
+        cur += k;
+    }
+    c.baby_x = cur;
+    c.baby_z = c.baby_x + ECM_BABY * k;
+    c.giant_x = c.baby_z + ECM_BABY * k;
+    c.giant_z = c.giant_x + ECM_BATCH * k;
+    c.prefix = c.giant_z + ECM_BATCH * k;
+    ttak_bigint_init(&c.g, sh->now);
+
+    int found = ecm_run_curve(&c, sh, sh->sigma0 + index);
+    if (found == 1) {
+        pthread_mutex_lock(&sh->lock);
+        if (atomic_load_explicit(&sh->state, memory_order_relaxed) == 0) {
+            if (ttak_bigint_copy(sh->factor, &c.g, sh->now)) {
+                atomic_store_explicit(&sh->state, 1, memory_order_relaxed);
+            } else {
+                atomic_store_explicit(&sh->state, -1, memory_order_relaxed);
+            }
+        }
+        pthread_mutex_unlock(&sh->lock);
+    } else if (found < 0) {
+        int expected = 0;
+        atomic_compare_exchange_strong(&sh->state, &expected, -1);
+    }
+    ttak_bigint_free(&c.g, sh->now);
+    ttak_mem_free(block);
+}
+
+/**
+ * @brief Runs ECM curves over @p pool until one of them splits @p n.
+ */
+int ttak_factor_ecm(const ttak_bigint_t *n, const ttak_factor_ecm_params_t *params, ttak_thread_pool_t *pool,
+                    ttak_bigint_t *factor_out, uint64_t now) {
+    if (!n || !params || !factor_out || params->curves == 0 || params->b1 < 2) return 0;
+    if (n->is_negative || ttak_bigint_cmp_u64(n, 3) <= 0) return 0;
+    uint64_t parity = 0;
+    if (!ttak_bigint_mod_u64(factor_out, n, 2, now) || !ttak_bigint_export_u64(factor_out, &parity)) return -1;
+    if (parity == 0) return ttak_bigint_set_u64(factor_out, 2, now) ? 1 : -1;
+
+    ecm_shared_t sh;
+    sh.n = n;
+    sh.b1 = params->b1;
+    sh.b2 = params->b2 ? params->b2 : 100 * params->b1;
+    if (sh.b2 < sh.b1) sh.b2 = sh.b1;
+    /* sigma in {0, 1, 3, 5} gives a singular curve; start past them. */
+    sh.sigma0 = params->seed < 6 ? 6 + params->seed : params->seed;
+    sh.now = now;
+    sh.factor = factor_out;
+    atomic_init(&sh.state, 0);
+    if (!ttak_bigint_mont_init(&sh.ctx, n, now)) return -1;
+    uint64_t *primes = ttak_prime_odd_bits(sh.b2 + ECM_D, now);
+    if (!primes) {
+        ttak_bigint_mont_free(&sh.ctx);
+        return -1;
+    }
+    sh.primes = primes;
+    pthread_mutex_init(&sh.lock, NULL);
+
+    ttak_factor_parallel_for(pool, params->curves, ecm_curve_task, &sh, now);
+
+    pthread_mutex_destroy(&sh.lock);
+    ttak_mem_free(primes);
+    ttak_bigint_mont_free(&sh.ctx);
+    return atomic_load(&sh.state);
+}
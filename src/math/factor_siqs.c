@@ -0,0 +1,954 @@
+#include <ttak/math/factor.h>
+#include <ttak/math/bigint_mont.h>
+#include <ttak/mem/mem.h>
+#include "../../internal/ttak/factor_internal.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+/* Sieve block: the interval is processed this many bytes at a time. */
+#define SIQS_BLOCK 32768
+/* Primes below this are not sieved; the threshold allows for their share instead. */
+#define SIQS_SMALL_PRIME 30
+/* Most primes in A; 2^(s-1) B values per A. */
+#define SIQS_MAX_S 20
+/* Relations beyond the factor base size, to be sure of dependencies. */
+#define SIQS_EXCESS 64
+/* Dependencies tried before giving up. */
+#define SIQS_MAX_DEPS 64
+/* Attempts at an unused A before a worker gives up. */
+#define SIQS_A_TRIES 256
+
+/*
+ * Factor base size, sieve blocks and large prime multiplier by input size.
+ * Sizes between two rows are interpolated.
+ */
+typedef struct siqs_params {
+    unsigned digits;
+    uint32_t fb_size;
+    uint32_t blocks;
+    uint32_t lp_mult;
+} siqs_params_t;
+
+static const siqs_params_t k_siqs_params[] = {
+    {  20,   100,  1,  20 },
+    {  30,   200,  1,  30 },
+    {  40,   450,  1,  40 },
+    {  50,  1200,  2,  50 },
+    {  60,  2500,  2,  60 },
+    {  70,  5500,  4,  80 },
+    {  80, 12000,  6, 100 },
+    {  90, 24000,  8, 120 },
+    { 100, 40000, 10, 150 },
+};
+
+/* One relation Y^2 = prod(fb[fac]) * large^2 (mod N); fac lists indices with repetition. */
+typedef struct siqs_rel {
+    ttak_bigint_t y;
+    uint32_t *fac;
+    uint32_t nfac;
+    uint32_t large;
+} siqs_rel_t;
+
+typedef struct siqs_rel_list {
+    siqs_rel_t *items;
+    size_t count;
+    size_t capacity;
+} siqs_rel_list_t;
+
+typedef struct siqs {
+    const ttak_bigint_t *n;
+    ttak_bigint_t kn;
+    uint64_t now;
+
+    /* Factor base: index 0 stands for -1, index 1 for 2. */
+    uint32_t *prime;
+    uint32_t *sqrt_kn;
+    uint8_t *logp;
+    size_t fb_size;
+    size_t sieve_start;
+
+    uint32_t m;           /* Sieve over x in [-m, m). */
+    uint32_t len;         /* 2m, a whole number of blocks. */
+    uint32_t large_bound;
+    uint8_t sieve_init;
+    size_t s;             /* Primes in each A. */
+    size_t a_lo, a_hi;    /* Index range the first s - 1 primes of A come from. */
+    double a_log;         /* log2 of the ideal A, sqrt(2kN) / m. */
+
+    pthread_mutex_t lock;
+    siqs_rel_list_t fulls;     /* Full relations and matched partial pairs. */
+    siqs_rel_list_t partials;
+    uint32_t *partial_slot;    /* Open addressing on the large prime, index + 1. */
+    size_t partial_slots;
+    uint64_t *used_a;
+    size_t used_a_count;
+    size_t used_a_capacity;
+    size_t need;
+    _Atomic int state;         /* 0 sieving, 1 enough relations, -1 allocation failure. */
+    _Atomic size_t exhausted;  /* Workers that ran out of fresh A values. */
+    size_t workers;
+} siqs_t;
+
+/* Per-worker polynomial state for one A and its B values. */
+typedef struct siqs_poly {
+    ttak_bigint_t a, b, c;
+    ttak_bigint_t bl[SIQS_MAX_S];
+    ttak_bigint_t v, t, r;
+    size_t q[SIQS_MAX_S];
+    uint32_t *ainv;
+    uint32_t *root1, *root2;
+    uint32_t *next1, *next2;
+    uint32_t *bainv2;       /* s rows of fb_size entries. */
+    uint8_t *sieve;
+    uint32_t *fac;          /* Scratch for one relation's indices. */
+    size_t fac_cap;
+    uint64_t rng;
+} siqs_poly_t;
+
+static uint64_t siqs_rng(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static uint64_t siqs_powmod(uint64_t b, uint64_t e, uint64_t p) {
+    uint64_t r = 1;
+    b %= p;
+    while (e) {
+        if (e & 1u) r = r * b % p;
+        b = b * b % p;
+        e >>= 1;
+    }
+    return r;
+}
+
+static uint32_t siqs_inverse(uint32_t a, uint32_t p) {
+    int64_t t0 = 0, t1 = 1, r0 = p, r1 = a % p;
+    while (r1) {
+        int64_t q = r0 / r1, tmp = r0 - q * r1;
+        r0 = r1;
+        r1 = tmp;
+        tmp = t0 - q * t1;
+        t0 = t1;
+        t1 = tmp;
+    }
+    return (uint32_t)(t0 < 0 ? t0 + p : t0);
+}
+
+/**
+ * @brief Square root of the quadratic residue @p a modulo the odd prime @p p (Tonelli-Shanks).
+ */
+static uint32_t siqs_sqrt_mod(uint32_t a, uint32_t p) {
+    if (a == 0) return 0;
+    if (p % 4 == 3) return (uint32_t)siqs_powmod(a, (p + 1) / 4, p);
+    uint64_t q = p - 1, s = 0;
+    while (!(q & 1u)) {
+        q >>= 1;
+        ++s;
+    }
+    uint64_t z = 2;
+    while (siqs_powmod(z, (p - 1) / 2, p) != p - 1) ++z;
+    uint64_t c = siqs_powmod(z, q, p), x = siqs_powmod(a, (q + 1) / 2, p), t = siqs_powmod(a, q, p);
+    while (t != 1) {
+        uint64_t i = 0, tt = t;
+        while (tt != 1) {
+            tt = tt * tt % p;
+            ++i;
+        }
+        uint64_t bb = c;
+        for (uint64_t j = 0; j + 1 < s - i; ++j) bb = bb * bb % p;
+        x = x * bb % p;
+        c = bb * bb % p;
+        t = t * c % p;
+        s = i;
+    }
+    return (uint32_t)x;
+}
+
+static uint32_t siqs_mod_u32(const ttak_bigint_t *v, uint32_t p) {
+    const limb_t *limbs = ttak_bigint_limbs(v);
+    uint64_t r = 0;
+    for (size_t i = v->used; i > 0; --i) {
+#if TTAK_BIGINT_LIMB_BITS == 64
+        r = (uint64_t)((((unsigned __int128)r << 64) | limbs[i - 1]) % p);
+#else
+        r = ((r << 32) | limbs[i - 1]) % p;
+#endif
+    }
+    return (uint32_t)r;
+}
+
+static bool siqs_is_prime_u32(uint32_t v) {
+    if (v < 2) return false;
+    for (uint32_t d = 2; d * d <= v; ++d) {
+        if (v % d == 0) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Knuth-Schroeppel multiplier: the squarefree k below 100 whose kN
+ * has the most small primes as quadratic residues, weighted by size.
+ */
+static uint32_t siqs_multiplier(const ttak_bigint_t *n) {
+    static const uint8_t k_candidates[] = {
+        1, 2, 3, 5, 6, 7, 10, 11, 13, 14, 15, 17, 19, 21, 22, 23, 26, 29, 30, 31, 33, 34, 35, 37,
+        38, 39, 41, 42, 43, 46, 47, 51, 53, 55, 57, 58, 59, 61, 62, 65, 66, 67, 69, 70, 71, 73
+    };
+    uint32_t n8 = siqs_mod_u32(n, 8);
+    double best = -1e30;
+    uint32_t best_k = 1;
+    for (size_t c = 0; c < sizeof(k_candidates); ++c) {
+        uint32_t k = k_candidates[c];
+        uint32_t kn8 = (uint32_t)((uint64_t)k * n8 % 8);
+        double score = -0.5 * log((double)k);
+        if (kn8 == 1) score += 2.0 * log(2.0);
+        else if (kn8 == 5) score += log(2.0);
+        else if (kn8 == 3 || kn8 == 7) score += 0.5 * log(2.0);
+        else continue; /* kN even: 2 would divide every value. */
+        uint32_t seen = 0;
+        for (uint32_t p = 3; seen < 300; p += 2) {
+            if (!siqs_is_prime_u32(p)) continue;
+            ++seen;
+            uint32_t a = (uint32_t)((uint64_t)siqs_mod_u32(n, p) * k % p);
+            if (a == 0) {
+                score += log((double)p) / p;
+            } else if (siqs_powmod(a, (p - 1) / 2, p) == 1) {
+                score += 2.0 * log((double)p) / (p - 1);
+            }
+        }
+        if (score > best) {
+            best = score;
+            best_k = k;
+        }
+    }
+    return best_k;
+}
+
+static void siqs_pick_params(unsigned digits, siqs_params_t *out) {
+    size_t rows = sizeof(k_siqs_params) / sizeof(k_siqs_params[0]);
+    if (digits <= k_siqs_params[0].digits) {
+        *out = k_siqs_params[0];
+        return;
+    }
+    for (size_t i = 1; i < rows; ++i) {
+        const siqs_params_t *lo = &k_siqs_params[i - 1], *hi = &k_siqs_params[i];
+        if (digits <= hi->digits) {
+            double f = (double)(digits - lo->digits) / (hi->digits - lo->digits);
+            out->digits = digits;
+            out->fb_size = (uint32_t)(lo->fb_size + f * (hi->fb_size - lo->fb_size));
+            out->blocks = (uint32_t)(lo->blocks + f * (hi->blocks - lo->blocks) + 0.5);
+            out->lp_mult = (uint32_t)(lo->lp_mult + f * (hi->lp_mult - lo->lp_mult));
+            return;
+        }
+    }
+    *out = k_siqs_params[rows - 1];
+}
+
+static bool siqs_list_push(siqs_rel_list_t *list, uint64_t now) {
+    if (list->count < list->capacity) return true;
+    size_t cap = list->capacity ? list->capacity * 2 : 256;
+    siqs_rel_t *items = ttak_mem_realloc_raw(list->items, cap * sizeof(siqs_rel_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!items) return false;
+    list->items = items;
+    list->capacity = cap;
+    return true;
+}
+
+static void siqs_list_free(siqs_rel_list_t *list, uint64_t now) {
+    for (size_t i = 0; i < list->count; ++i) {
+        ttak_bigint_free(&list->items[i].y, now);
+        ttak_mem_free(list->items[i].fac);
+    }
+    if (list->items) ttak_mem_free(list->items);
+}
+
+/**
+ * @brief Append a relation with a copy of @p fac to @p list. Holds ctx->lock.
+ */
+static bool siqs_list_add(siqs_t *ctx, siqs_rel_list_t *list, const ttak_bigint_t *y, const uint32_t *fac,
+                          size_t nfac, const uint32_t *fac2, size_t nfac2, uint32_t large) {
+    if (!siqs_list_push(list, ctx->now)) return false;
+    uint32_t *copy = ttak_mem_alloc_raw((nfac + nfac2) * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, ctx->now);
+    if (!copy) return false;
+    memcpy(copy, fac, nfac * sizeof(uint32_t));
+    if (nfac2) memcpy(copy + nfac, fac2, nfac2 * sizeof(uint32_t));
+    siqs_rel_t *rel = &list->items[list->count];
+    ttak_bigint_init_copy(&rel->y, y, ctx->now);
+    rel->fac = copy;
+    rel->nfac = (uint32_t)(nfac + nfac2);
+    rel->large = large;
+    list->count++;
+    return true;
+}
+
+static bool siqs_partial_rehash(siqs_t *ctx) {
+    size_t slots = ctx->partial_slots ? ctx->partial_slots * 2 : 1024;
+    uint32_t *table = ttak_mem_alloc_raw(slots * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, ctx->now);
+    if (!table) return false;
+    memset(table, 0, slots * sizeof(uint32_t));
+    for (size_t i = 0; i < ctx->partials.count; ++i) {
+        size_t h = (ctx->partials.items[i].large * 0x9E3779B1u) & (slots - 1);
+        while (table[h]) h = (h + 1) & (slots - 1);
+        table[h] = (uint32_t)(i + 1);
+    }
+    if (ctx->partial_slot) ttak_mem_free(ctx->partial_slot);
+    ctx->partial_slot = table;
+    ctx->partial_slots = slots;
+    return true;
+}
+
+/**
+ * @brief Record a relation with cofactor @p large (1 for a full one).
+ *
+ * A partial whose large prime was seen before pairs up with the earlier one
+ * into a full relation. Sets the state to 1 once enough have piled up.
+ */
+static bool siqs_record(siqs_t *ctx, const ttak_bigint_t *y, const uint32_t *fac, size_t nfac, uint32_t large,
+                        ttak_bigint_t *tmp) {
+    bool ok = true;
+    pthread_mutex_lock(&ctx->lock);
+    if (large == 1) {
+        ok = siqs_list_add(ctx, &ctx->fulls, y, fac, nfac, NULL, 0, 1);
+    } else {
+        if (2 * (ctx->partials.count + 1) > ctx->partial_slots) ok = siqs_partial_rehash(ctx);
+        size_t mask = ctx->partial_slots - 1;
+        size_t h = (large * 0x9E3779B1u) & mask;
+        while (ok && ctx->partial_slot[h] && ctx->partials.items[ctx->partial_slot[h] - 1].large != large) {
+            h = (h + 1) & mask;
+        }
+        if (ok && ctx->partial_slot[h]) {
+            const siqs_rel_t *mate = &ctx->partials.items[ctx->partial_slot[h] - 1];
+            ok = ttak_bigint_mul(tmp, y, &mate->y, ctx->now) && ttak_bigint_mod(tmp, tmp, ctx->n, ctx->now) &&
+                 siqs_list_add(ctx, &ctx->fulls, tmp, fac, nfac, mate->fac, mate->nfac, large);
+        } else if (ok) {
+            ok = siqs_list_add(ctx, &ctx->partials, y, fac, nfac, NULL, 0, large);
+            if (ok) ctx->partial_slot[h] = (uint32_t)ctx->partials.count;
+        }
+    }
+    if (!ok) {
+        atomic_store(&ctx->state, -1);
+    } else if (ctx->fulls.count >= ctx->need) {
+        int expected = 0;
+        atomic_compare_exchange_strong(&ctx->state, &expected, 1);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    return ok;
+}
+
+/**
+ * @brief Build the factor base of primes p with (kN / p) != -1.
+ * @return 1 on success, 2 when a base prime divides N (left in @p factor),
+ *         -1 on allocation failure.
+ */
+static int siqs_factor_base(siqs_t *ctx, size_t want, ttak_bigint_t *factor) {
+    uint64_t now = ctx->now;
+    ctx->prime = ttak_mem_alloc_raw(want * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ctx->sqrt_kn = ttak_mem_alloc_raw(want * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ctx->logp = ttak_mem_alloc_raw(want, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!ctx->prime || !ctx->sqrt_kn || !ctx->logp) return -1;
+    ctx->prime[0] = 1;
+    ctx->sqrt_kn[0] = 0;
+    ctx->prime[1] = 2;
+    ctx->sqrt_kn[1] = 1;
+    size_t count = 2;
+    for (uint32_t p = 3; count < want; p += 2) {
+        if (!siqs_is_prime_u32(p)) continue;
+        if (siqs_mod_u32(ctx->n, p) == 0) {
+            return ttak_bigint_set_u64(factor, p, now) ? 2 : -1;
+        }
+        uint32_t a = siqs_mod_u32(&ctx->kn, p);
+        if (a != 0 && siqs_powmod(a, (p - 1) / 2, p) != 1) continue;
+        ctx->prime[count] = p;
+        ctx->sqrt_kn[count] = siqs_sqrt_mod(a, p);
+        count++;
+    }
+    ctx->fb_size = count;
+    ctx->sieve_start = 2;
+    while (ctx->sieve_start < count && ctx->prime[ctx->sieve_start] < SIQS_SMALL_PRIME) ctx->sieve_start++;
+    return 1;
+}
+
+/* Sieve logs are log2 scaled so the largest value fits comfortably below the 0x80 marker bit. */
+static void siqs_thresholds(siqs_t *ctx) {
+    double kn_bits = (double)ttak_bigint_get_bit_length(&ctx->kn);
+    double g_bits = log2((double)ctx->m) + 0.5 * kn_bits - 0.5;
+    double lp_bits = log2((double)ctx->large_bound);
+    double skipped = 1.0;
+    for (size_t i = 2; i < ctx->sieve_start; ++i) {
+        double p = ctx->prime[i];
+        skipped += (ctx->sqrt_kn[i] ? 2.0 : 1.0) * log2(p) / (p - 1.0);
+    }
+    double thresh = g_bits - lp_bits - skipped;
+    double scale = 100.0 / g_bits;
+    for (size_t i = 0; i < ctx->fb_size; ++i) {
+        long l = lround(log2((double)(ctx->prime[i] | 1u)) * scale);
+        ctx->logp[i] = (uint8_t)(l < 1 ? 1 : l);
+    }
+    long init = 128 - lround(thresh * scale);
+    ctx->sieve_init = (uint8_t)(init < 0 ? 0 : init > 127 ? 127 : init);
+}
+
+/*
+ * A is a product of s base primes near a_log. The first s - 1 come from
+ * [a_lo, a_hi] at random and the last one is the prime closest to what
+ * remains, so A stays within a few percent of the ideal size.
+ */
+static void siqs_plan_a(siqs_t *ctx) {
+    double pmax = ctx->prime[ctx->fb_size - 1];
+    double ideal = ctx->a_log < 33.0 ? 200.0 : 2000.0;
+    if (ideal > pmax / 3) ideal = pmax / 3;
+    size_t s = (size_t)lround(ctx->a_log / log2(ideal));
+    if (s < 2) s = 2;
+    if (s > SIQS_MAX_S) s = SIQS_MAX_S;
+    ctx->s = s;
+    double each = exp2(ctx->a_log / s);
+    size_t lo = ctx->sieve_start, hi = ctx->fb_size - 1;
+    while (lo < hi && ctx->prime[lo] < each / 2) lo++;
+    while (hi > lo && ctx->prime[hi] > each * 2) hi--;
+    if (hi < lo + 2 * s) hi = lo + 2 * s < ctx->fb_size - 1 ? lo + 2 * s : ctx->fb_size - 1;
+    ctx->a_lo = lo;
+    ctx->a_hi = hi;
+}
+
+static uint64_t siqs_a_key(const size_t *q, size_t s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < s; ++i) {
+        h ^= q[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/**
+ * @brief Draw a fresh A for @p poly.
+ * @return 1 on success, 0 when no unused A turned up, -1 on allocation failure.
+ */
+static int siqs_choose_a(siqs_t *ctx, siqs_poly_t *poly) {
+    size_t s = ctx->s;
+    size_t span = ctx->a_hi - ctx->a_lo + 1;
+    for (int attempt = 0; attempt < SIQS_A_TRIES; ++attempt) {
+        double have = 0;
+        size_t picked = 0;
+        while (picked < s - 1) {
+            size_t idx = ctx->a_lo + (size_t)(siqs_rng(&poly->rng) % span);
+            bool dup = ctx->sqrt_kn[idx] == 0;
+            for (size_t i = 0; i < picked; ++i) dup |= poly->q[i] == idx;
+            if (dup) continue;
+            poly->q[picked++] = idx;
+            have += log2((double)ctx->prime[idx]);
+        }
+        double rest = exp2(ctx->a_log - have);
+        size_t best = 0;
+        double best_err = 1e300;
+        for (size_t i = ctx->sieve_start; i < ctx->fb_size; ++i) {
+            bool dup = ctx->sqrt_kn[i] == 0;
+            for (size_t j = 0; j < picked; ++j) dup |= poly->q[j] == i;
+            double err = fabs(log((double)ctx->prime[i] / rest));
+            if (!dup && err < best_err) {
+                best_err = err;
+                best = i;
+            }
+        }
+        if (!best) continue;
+        poly->q[picked] = best;
+        for (size_t i = 1; i < s; ++i) {
+            for (size_t j = i; j > 0 && poly->q[j - 1] > poly->q[j]; --j) {
+                size_t t = poly->q[j];
+                poly->q[j] = poly->q[j - 1];
+                poly->q[j - 1] = t;
+            }
+        }
+        uint64_t key = siqs_a_key(poly->q, s);
+        bool fresh = true;
+        pthread_mutex_lock(&ctx->lock);
+        for (size_t i = 0; i < ctx->used_a_count && fresh; ++i) fresh = ctx->used_a[i] != key;
+        if (fresh && ctx->used_a_count == ctx->used_a_capacity) {
+            size_t cap = ctx->used_a_capacity ? ctx->used_a_capacity * 2 : 64;
+            uint64_t *grown = ttak_mem_realloc_raw(ctx->used_a, cap * sizeof(uint64_t), __TTAK_UNSAFE_MEM_FOREVER__,
+                                                   ctx->now);
+            if (!grown) {
+                pthread_mutex_unlock(&ctx->lock);
+                return -1;
+            }
+            ctx->used_a = grown;
+            ctx->used_a_capacity = cap;
+        }
+        if (fresh) ctx->used_a[ctx->used_a_count++] = key;
+        pthread_mutex_unlock(&ctx->lock);
+        if (fresh) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Set up A, its B_l terms, the first B and C, and the roots of every base prime.
+ */
+static bool siqs_init_poly(siqs_t *ctx, siqs_poly_t *poly) {
+    uint64_t now = ctx->now;
+    size_t s = ctx->s;
+    bool ok = ttak_bigint_set_u64(&poly->a, 1, now);
+    for (size_t l = 0; ok && l < s; ++l) ok = ttak_bigint_mul_u64(&poly->a, &poly->a, ctx->prime[poly->q[l]], now);
+    ok = ok && ttak_bigint_set_u64(&poly->b, 0, now);
+    for (size_t l = 0; ok && l < s; ++l) {
+        uint32_t q = ctx->prime[poly->q[l]];
+        ok = ttak_bigint_div_u64(&poly->t, NULL, &poly->a, q, now);
+        uint32_t a_over_q = siqs_mod_u32(&poly->t, q);
+        uint64_t gamma = (uint64_t)ctx->sqrt_kn[poly->q[l]] * siqs_inverse(a_over_q, q) % q;
+        if (gamma > q / 2) gamma = q - gamma;
+        ok = ok && ttak_bigint_mul_u64(&poly->bl[l], &poly->t, gamma, now) &&
+             ttak_bigint_add(&poly->b, &poly->b, &poly->bl[l], now);
+    }
+    /* C = (B^2 - kN) / A, exact because B^2 = kN mod A. */
+    ok = ok && ttak_bigint_mul(&poly->t, &poly->b, &poly->b, now) && ttak_bigint_sub(&poly->t, &poly->t, &ctx->kn, now) &&
+         ttak_bigint_div(&poly->c, NULL, &poly->t, &poly->a, now);
+    if (!ok) return false;
+
+    size_t fb = ctx->fb_size;
+    for (size_t i = 2; i < fb; ++i) {
+        uint32_t p = ctx->prime[i];
+        uint32_t amod = siqs_mod_u32(&poly->a, p);
+        if (amod == 0) {
+            poly->ainv[i] = 0;
+            poly->root1[i] = poly->root2[i] = UINT32_MAX;
+            continue;
+        }
+        uint64_t ainv = siqs_inverse(amod, p);
+        poly->ainv[i] = (uint32_t)ainv;
+        for (size_t l = 0; l < s; ++l) {
+            uint64_t blm = siqs_mod_u32(&poly->bl[l], p);
+            poly->bainv2[l * fb + i] = (uint32_t)(2 * blm % p * ainv % p);
+        }
+        uint64_t bm = siqs_mod_u32(&poly->b, p);
+        uint64_t t = ctx->sqrt_kn[i];
+        uint64_t shift = ctx->m % p;
+        uint64_t r1 = ((t + p - bm) % p * ainv + shift) % p;
+        uint64_t r2 = ((2 * (uint64_t)p - t - bm) % p * ainv + shift) % p;
+        poly->root1[i] = (uint32_t)r1;
+        poly->root2[i] = (uint32_t)r2;
+    }
+    return true;
+}
+
+/**
+ * @brief Step to the B of Gray code index @p i (i >= 1) of the current A.
+ */
+static bool siqs_next_b(siqs_t *ctx, siqs_poly_t *poly, size_t i) {
+    uint64_t now = ctx->now;
+    size_t l = (size_t)__builtin_ctzll(i);
+    bool plus = ((i >> (l + 1)) & 1u) != 0;
+    /* B' = B +- 2 B_l moves each root by -+ 2 B_l / A. */
+    bool ok = ttak_bigint_add(&poly->t, &poly->bl[l], &poly->bl[l], now) &&
+              (plus ? ttak_bigint_add(&poly->b, &poly->b, &poly->t, now)
+                    : ttak_bigint_sub(&poly->b, &poly->b, &poly->t, now));
+    ok = ok && ttak_bigint_mul(&poly->t, &poly->b, &poly->b, now) && ttak_bigint_sub(&poly->t, &poly->t, &ctx->kn, now) &&
+         ttak_bigint_div(&poly->c, NULL, &poly->t, &poly->a, now);
+    if (!ok) return false;
+    const uint32_t *delta = poly->bainv2 + l * ctx->fb_size;
+    for (size_t j = 2; j < ctx->fb_size; ++j) {
+        if (poly->root1[j] == UINT32_MAX) continue;
+        uint32_t p = ctx->prime[j], d = delta[j];
+        if (plus) {
+            poly->root1[j] = poly->root1[j] >= d ? poly->root1[j] - d : poly->root1[j] + p - d;
+            poly->root2[j] = poly->root2[j] >= d ? poly->root2[j] - d : poly->root2[j] + p - d;
+        } else {
+            uint32_t r1 = poly->root1[j] + d, r2 = poly->root2[j] + d;
+            poly->root1[j] = r1 >= p ? r1 - p : r1;
+            poly->root2[j] = r2 >= p ? r2 - p : r2;
+        }
+    }
+    return true;
+}
+
+static void siqs_sieve(siqs_t *ctx, siqs_poly_t *poly) {
+    uint8_t *sieve = poly->sieve;
+    size_t fb = ctx->fb_size;
+    memset(sieve, ctx->sieve_init, ctx->len);
+    for (size_t i = ctx->sieve_start; i < fb; ++i) {
+        poly->next1[i] = poly->root1[i];
+        poly->next2[i] = poly->root1[i] == poly->root2[i] ? UINT32_MAX : poly->root2[i];
+    }
+    for (uint32_t end = SIQS_BLOCK; end <= ctx->len; end += SIQS_BLOCK) {
+        for (size_t i = ctx->sieve_start; i < fb; ++i) {
+            if (poly->root1[i] == UINT32_MAX) continue;
+            uint32_t p = ctx->prime[i];
+            uint8_t lp = ctx->logp[i];
+            uint32_t j = poly->next1[i];
+            for (; j < end; j += p) sieve[j] += lp;
+            poly->next1[i] = j;
+            j = poly->next2[i];
+            for (; j < end; j += p) sieve[j] += lp;
+            if (poly->next2[i] != UINT32_MAX) poly->next2[i] = j;
+        }
+    }
+}
+
+static bool siqs_fac_push(siqs_t *ctx, siqs_poly_t *poly, size_t *count, uint32_t index) {
+    if (*count == poly->fac_cap) {
+        size_t cap = poly->fac_cap * 2;
+        uint32_t *grown = ttak_mem_realloc_raw(poly->fac, cap * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, ctx->now);
+        if (!grown) return false;
+        poly->fac = grown;
+        poly->fac_cap = cap;
+    }
+    poly->fac[(*count)++] = index;
+    return true;
+}
+
+/* Divide every factor of p out of poly->v, recording index i once per factor. */
+static bool siqs_divide_out(siqs_t *ctx, siqs_poly_t *poly, size_t *count, size_t i) {
+    uint32_t p = ctx->prime[i];
+    while (siqs_mod_u32(&poly->v, p) == 0) {
+        if (!ttak_bigint_div_u64(&poly->v, NULL, &poly->v, p, ctx->now) || !siqs_fac_push(ctx, poly, count, (uint32_t)i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Factor g(x) = A x^2 + 2 B x + C at sieve offset @p j by trial division
+ * and record it if it is smooth up to one large prime.
+ */
+static bool siqs_check(siqs_t *ctx, siqs_poly_t *poly, uint32_t j) {
+    uint64_t now = ctx->now;
+    int64_t x = (int64_t)j - ctx->m;
+    uint64_t ax = (uint64_t)(x < 0 ? -x : x);
+
+    /* v = (A x + 2B) x + C and r = A x + B, the square root side. */
+    bool ok = ttak_bigint_mul_u64(&poly->r, &poly->a, ax, now);
+    if (ok && x < 0 && !ttak_bigint_is_zero(&poly->r)) poly->r.is_negative = true;
+    ok = ok && ttak_bigint_add(&poly->v, &poly->r, &poly->b, now) && ttak_bigint_add(&poly->v, &poly->v, &poly->b, now) &&
+         ttak_bigint_mul_u64(&poly->v, &poly->v, ax, now);
+    if (ok && x < 0 && !ttak_bigint_is_zero(&poly->v)) poly->v.is_negative = !poly->v.is_negative;
+    ok = ok && ttak_bigint_add(&poly->v, &poly->v, &poly->c, now) && ttak_bigint_add(&poly->r, &poly->r, &poly->b, now);
+    if (!ok) return false;
+    if (ttak_bigint_is_zero(&poly->v)) return true;
+
+    size_t count = 0;
+    if (poly->v.is_negative) {
+        poly->v.is_negative = false;
+        if (!siqs_fac_push(ctx, poly, &count, 0)) return false;
+    }
+    for (size_t l = 0; l < ctx->s; ++l) {
+        if (!siqs_fac_push(ctx, poly, &count, (uint32_t)poly->q[l])) return false;
+    }
+    for (size_t i = 1; i < ctx->sieve_start; ++i) {
+        if (!siqs_divide_out(ctx, poly, &count, i)) return false;
+    }
+    for (size_t i = ctx->sieve_start; i < ctx->fb_size; ++i) {
+        uint32_t p = ctx->prime[i];
+        if (poly->root1[i] == UINT32_MAX) {
+            if (!siqs_divide_out(ctx, poly, &count, i)) return false;
+            continue;
+        }
+        uint32_t jm = j % p;
+        if (jm != poly->root1[i] && jm != poly->root2[i]) continue;
+        if (!siqs_divide_out(ctx, poly, &count, i)) return false;
+    }
+
+    uint64_t rest = 0;
+    if (!ttak_bigint_export_u64(&poly->v, &rest) || rest >= ctx->large_bound) return true;
+    if (rest > 1 && rest <= ctx->prime[ctx->fb_size - 1]) return true;
+    ok = ttak_bigint_mod(&poly->r, &poly->r, ctx->n, now);
+    if (ok && poly->r.is_negative) ok = ttak_bigint_add(&poly->r, &poly->r, ctx->n, now);
+    return ok && siqs_record(ctx, &poly->r, poly->fac, count, (uint32_t)rest, &poly->t);
+}
+
+static void siqs_scan(siqs_t *ctx, siqs_poly_t *poly) {
+    const uint8_t *sieve = poly->sieve;
+    for (uint32_t j = 0; j < ctx->len; j += 8) {
+        uint64_t w;
+        memcpy(&w, sieve + j, sizeof(w));
+        if (!(w & 0x8080808080808080ULL)) continue;
+        for (uint32_t b = 0; b < 8; ++b) {
+            if (!(sieve[j + b] & 0x80)) continue;
+            if (!siqs_check(ctx, poly, j + b)) {
+                atomic_store(&ctx->state, -1);
+                return;
+            }
+        }
+    }
+}
+
+static void siqs_poly_free(siqs_poly_t *poly, uint64_t now) {
+    ttak_bigint_free(&poly->a, now);
+    ttak_bigint_free(&poly->b, now);
+    ttak_bigint_free(&poly->c, now);
+    ttak_bigint_free(&poly->v, now);
+    ttak_bigint_free(&poly->t, now);
+    ttak_bigint_free(&poly->r, now);
+    for (size_t l = 0; l < SIQS_MAX_S; ++l) ttak_bigint_free(&poly->bl[l], now);
+    if (poly->ainv) ttak_mem_free(poly->ainv);
+    if (poly->sieve) ttak_mem_free(poly->sieve);
+    if (poly->fac) ttak_mem_free(poly->fac);
+}
+
+/* One worker: draw A values and sieve all of their B values until enough relations exist. */
+static void siqs_worker(void *arg, size_t index) {
+    siqs_t *ctx = arg;
+    uint64_t now = ctx->now;
+    size_t fb = ctx->fb_size;
+    siqs_poly_t poly;
+    memset(&poly, 0, sizeof(poly));
+    ttak_bigint_init(&poly.a, now);
+    ttak_bigint_init(&poly.b, now);
+    ttak_bigint_init(&poly.c, now);
+    ttak_bigint_init(&poly.v, now);
+    ttak_bigint_init(&poly.t, now);
+    ttak_bigint_init(&poly.r, now);
+    for (size_t l = 0; l < SIQS_MAX_S; ++l) ttak_bigint_init(&poly.bl[l], now);
+    poly.rng = 0x9E3779B97F4A7C15ULL * (index + 1);
+    poly.ainv = ttak_mem_alloc_raw((5 + ctx->s) * fb * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    poly.sieve = ttak_mem_alloc_raw(ctx->len + 8, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    poly.fac_cap = 64;
+    poly.fac = ttak_mem_alloc_raw(poly.fac_cap * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!poly.ainv || !poly.sieve || !poly.fac) {
+        atomic_store(&ctx->state, -1);
+        siqs_poly_free(&poly, now);
+        return;
+    }
+    poly.root1 = poly.ainv + fb;
+    poly.root2 = poly.root1 + fb;
+    poly.next1 = poly.root2 + fb;
+    poly.next2 = poly.next1 + fb;
+    poly.bainv2 = poly.next2 + fb;
+
+    size_t polys = (size_t)1 << (ctx->s - 1);
+    while (atomic_load_explicit(&ctx->state, memory_order_relaxed) == 0) {
+        int got = siqs_choose_a(ctx, &poly);
+        if (got <= 0) {
+            if (got < 0) atomic_store(&ctx->state, -1);
+            break;
+        }
+        if (!siqs_init_poly(ctx, &poly)) {
+            atomic_store(&ctx->state, -1);
+            break;
+        }
+        for (size_t i = 0; i < polys && atomic_load_explicit(&ctx->state, memory_order_relaxed) == 0; ++i) {
+            if (i > 0 && !siqs_next_b(ctx, &poly, i)) {
+                atomic_store(&ctx->state, -1);
+                break;
+            }
+            siqs_sieve(ctx, &poly);
+            siqs_scan(ctx, &poly);
+        }
+    }
+    siqs_poly_free(&poly, now);
+}
+
+/**
+ * @brief Drop relations whose odd-exponent columns appear nowhere else; they
+ * cannot be part of a dependency.
+ * @return Number of relations kept at the front of @p keep.
+ */
+static size_t siqs_filter(siqs_t *ctx, uint8_t *parity, size_t ncols, size_t *keep, uint32_t *weight) {
+    size_t nrel = ctx->fulls.count;
+    size_t live = nrel;
+    for (size_t i = 0; i < nrel; ++i) keep[i] = i;
+    for (;;) {
+        memset(weight, 0, ncols * sizeof(uint32_t));
+        for (size_t r = 0; r < live; ++r) {
+            const siqs_rel_t *rel = &ctx->fulls.items[keep[r]];
+            memset(parity, 0, ncols);
+            for (uint32_t f = 0; f < rel->nfac; ++f) parity[rel->fac[f]] ^= 1u;
+            for (uint32_t f = 0; f < rel->nfac; ++f) {
+                if (parity[rel->fac[f]]) {
+                    weight[rel->fac[f]]++;
+                    parity[rel->fac[f]] = 0;
+                }
+            }
+        }
+        size_t out = 0;
+        for (size_t r = 0; r < live; ++r) {
+            const siqs_rel_t *rel = &ctx->fulls.items[keep[r]];
+            memset(parity, 0, ncols);
+            for (uint32_t f = 0; f < rel->nfac; ++f) parity[rel->fac[f]] ^= 1u;
+            bool lonely = false;
+            for (uint32_t f = 0; f < rel->nfac && !lonely; ++f) lonely = parity[rel->fac[f]] && weight[rel->fac[f]] == 1;
+            if (!lonely) keep[out++] = keep[r];
+        }
+        if (out == live) return live;
+        live = out;
+    }
+}
+
+/**
+ * @brief Try one dependency: X = prod y, Y = sqrt(prod of the values), factor = gcd(X - Y, N).
+ * @return 1 on a proper factor, 0 on a trivial one, -1 on allocation failure.
+ */
+static int siqs_try_dependency(siqs_t *ctx, const size_t *rels, size_t count, uint32_t *exps,
+                               ttak_bigint_t *factor) {
+    uint64_t now = ctx->now;
+    const ttak_bigint_t *n = ctx->n;
+    ttak_bigint_t x, y;
+    ttak_bigint_init_u64(&x, 1, now);
+    ttak_bigint_init_u64(&y, 1, now);
+    memset(exps, 0, ctx->fb_size * sizeof(uint32_t));
+    bool ok = true;
+    for (size_t r = 0; ok && r < count; ++r) {
+        const siqs_rel_t *rel = &ctx->fulls.items[rels[r]];
+        for (uint32_t f = 0; f < rel->nfac; ++f) exps[rel->fac[f]]++;
+        ok = ttak_bigint_mul(&x, &x, &rel->y, now) && ttak_bigint_mod(&x, &x, n, now);
+        if (ok && rel->large != 1) {
+            ok = ttak_bigint_mul_u64(&y, &y, rel->large, now) && ttak_bigint_mod(&y, &y, n, now);
+        }
+    }
+    for (size_t i = 1; ok && i < ctx->fb_size; ++i) {
+        for (uint32_t e = 0; ok && e < exps[i] / 2; ++e) {
+            ok = ttak_bigint_mul_u64(&y, &y, ctx->prime[i], now) && ttak_bigint_mod(&y, &y, n, now);
+        }
+    }
+    int ret = -1;
+    if (ok && ttak_bigint_sub(&x, &x, &y, now) && ttak_factor_gcd(factor, &x, n, now)) {
+        ret = ttak_bigint_cmp_u64(factor, 1) > 0 && ttak_bigint_cmp(factor, n) < 0;
+    }
+    ttak_bigint_free(&x, now);
+    ttak_bigint_free(&y, now);
+    return ret;
+}
+
+/**
+ * @brief Gaussian elimination over GF(2) on the transposed exponent matrix,
+ * then the square root step on each null vector until one splits N.
+ */
+static int siqs_solve(siqs_t *ctx, ttak_bigint_t *factor) {
+    uint64_t now = ctx->now;
+    size_t ncols = ctx->fb_size;
+    size_t nrel = ctx->fulls.count;
+    int ret = -1;
+    uint8_t *parity = ttak_mem_alloc_raw(ncols, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    size_t *keep = ttak_mem_alloc_raw(nrel * sizeof(size_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    uint32_t *weight = ttak_mem_alloc_raw(ncols * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    size_t *pivot_row = ttak_mem_alloc_raw(nrel * sizeof(size_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    size_t *dep = ttak_mem_alloc_raw(nrel * sizeof(size_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    uint64_t *matrix = NULL;
+    if (!parity || !keep || !weight || !pivot_row || !dep) goto done;
+
+    size_t live = siqs_filter(ctx, parity, ncols, keep, weight);
+    ret = 0;
+    if (live == 0) goto done;
+    size_t words = (live + 63) / 64;
+    matrix = ttak_mem_alloc_raw(ncols * words * sizeof(uint64_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!matrix) {
+        ret = -1;
+        goto done;
+    }
+    memset(matrix, 0, ncols * words * sizeof(uint64_t));
+    for (size_t r = 0; r < live; ++r) {
+        const siqs_rel_t *rel = &ctx->fulls.items[keep[r]];
+        for (uint32_t f = 0; f < rel->nfac; ++f) matrix[rel->fac[f] * words + r / 64] ^= 1ULL << (r % 64);
+    }
+
+    /* Row i (one prime) picks its lowest surviving relation as pivot and clears it everywhere else. */
+    for (size_t c = 0; c < live; ++c) pivot_row[c] = SIZE_MAX;
+    for (size_t i = 0; i < ncols; ++i) {
+        uint64_t *row = matrix + i * words;
+        size_t c = SIZE_MAX;
+        for (size_t w = 0; w < words; ++w) {
+            if (row[w]) {
+                c = w * 64 + (size_t)__builtin_ctzll(row[w]);
+                break;
+            }
+        }
+        if (c == SIZE_MAX) continue;
+        pivot_row[c] = i;
+        uint64_t bit = 1ULL << (c % 64);
+        for (size_t o = 0; o < ncols; ++o) {
+            uint64_t *other = matrix + o * words;
+            if (o == i || !(other[c / 64] & bit)) continue;
+            for (size_t w = 0; w < words; ++w) other[w] ^= row[w];
+        }
+    }
+
+    /* Each free relation f with the pivots of the rows that contain it sums to zero. */
+    size_t tried = 0;
+    for (size_t f = 0; f < live && tried < SIQS_MAX_DEPS; ++f) {
+        if (pivot_row[f] != SIZE_MAX) continue;
+        size_t count = 0;
+        dep[count++] = keep[f];
+        for (size_t c = 0; c < live; ++c) {
+            size_t i = pivot_row[c];
+            if (i != SIZE_MAX && (matrix[i * words + f / 64] >> (f % 64)) & 1u) dep[count++] = keep[c];
+        }
+        ++tried;
+        int got = siqs_try_dependency(ctx, dep, count, weight, factor);
+        if (got != 0) {
+            ret = got;
+            break;
+        }
+    }
+
+done:
+    if (parity) ttak_mem_free(parity);
+    if (keep) ttak_mem_free(keep);
+    if (weight) ttak_mem_free(weight);
+    if (pivot_row) ttak_mem_free(pivot_row);
+    if (dep) ttak_mem_free(dep);
+    if (matrix) ttak_mem_free(matrix);
+    return ret;
+}
+
+/**
+ * @brief Factor base, parallel sieving, then linear algebra.
+ */
+int ttak_factor_siqs(const ttak_bigint_t *n, ttak_thread_pool_t *pool, ttak_bigint_t *factor_out, uint64_t now) {
+    if (!n || !factor_out || n->is_negative) return 0;
+    size_t bits = ttak_bigint_get_bit_length(n);
+    unsigned digits = (unsigned)(bits * 0.30103) + 1;
+    if (bits <= 64 || digits > TTAK_FACTOR_SIQS_MAX_DIGITS) return 0;
+
+    siqs_params_t params;
+    siqs_pick_params(digits, &params);
+
+    siqs_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.n = n;
+    ctx.now = now;
+    ttak_bigint_init(&ctx.kn, now);
+    pthread_mutex_init(&ctx.lock, NULL);
+    atomic_init(&ctx.state, 0);
+    atomic_init(&ctx.exhausted, 0);
+
+    int ret = -1;
+    if (!ttak_bigint_mul_u64(&ctx.kn, n, siqs_multiplier(n), now)) goto out;
+    int fb = siqs_factor_base(&ctx, params.fb_size, factor_out);
+    if (fb != 1) {
+        ret = fb == 2 ? 1 : -1;
+        goto out;
+    }
+    ctx.len = params.blocks * SIQS_BLOCK;
+    ctx.m = ctx.len / 2;
+    uint64_t bound = (uint64_t)ctx.prime[ctx.fb_size - 1] * params.lp_mult;
+    ctx.large_bound = bound > UINT32_MAX ? UINT32_MAX : (uint32_t)bound;
+    ctx.a_log = 0.5 * (1.0 + (double)ttak_bigint_get_bit_length(&ctx.kn)) - log2((double)ctx.m);
+    siqs_thresholds(&ctx);
+    siqs_plan_a(&ctx);
+    ctx.need = ctx.fb_size + SIQS_EXCESS;
+
+    size_t workers = pool ? ttak_thread_pool_live_workers(pool) + 1 : 1;
+    ttak_factor_parallel_for(pool, workers, siqs_worker, &ctx, now);
+
+    int state = atomic_load(&ctx.state);
+    if (state < 0) goto out;
+    ret = 0;
+    if (state == 1 || ctx.fulls.count > 0) ret = siqs_solve(&ctx, factor_out);
+
+out:
+    siqs_list_free(&ctx.fulls, now);
+    siqs_list_free(&ctx.partials, now);
+    if (ctx.partial_slot) ttak_mem_free(ctx.partial_slot);
+    if (ctx.used_a) ttak_mem_free(ctx.used_a);
+    if (ctx.prime) ttak_mem_free(ctx.prime);
+    if (ctx.sqrt_kn) ttak_mem_free(ctx.sqrt_kn);
+    if (ctx.logp) ttak_mem_free(ctx.logp);
+    ttak_bigint_free(&ctx.kn, now);
+    pthread_mutex_destroy(&ctx.lock);
+    return ret;
+}
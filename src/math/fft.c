@@ -0,0 +1,465 @@
+/**
+ * @file fft.c
+ * @brief Split-layout radix-4 complex FFT over doubles.
+ *
+ * One radix-4 butterfly is two radix-2 decimation-in-frequency stages
+ * fused, so the output order stays plain bit reversal and the inverse can
+ * undo it stage for stage. The butterflies are written once against a
+ * small set of vector operations and instantiated per ISA; stages whose
+ * quarter is shorter than a vector fall back to the scalar instance.
+ */
+
+#include <ttak/math/fft.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/mem/mem.h>
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    size_t lanes;
+    void (*dif4)(double *re, double *im, size_t len, size_t q, const double *tw);
+    void (*dit4)(double *re, double *im, size_t len, size_t q, const double *tw);
+    void (*pointwise)(double *dr, double *di, const double *ar, const double *ai, const double *br,
+                      const double *bi, double scale, size_t n);
+} fft_ops_t;
+
+/*
+ * FFT_KERNELS(name, attr, lanes) expects name##_vec_t with name##_load,
+ * _store, _set1, _add, _sub, _mul, _fmadd (a * b + c) and _fmsub
+ * (a * b - c). Both stage functions sweep @p len elements in blocks of 4q.
+ *
+ * Forward, with w = e^(-2 pi i / 4q), turns a, b, c, d at j, j + q, j + 2q,
+ * j + 3q into (a + c) + (b + d), w^2j ((a + c) - (b + d)),
+ * w^j ((a - c) - i (b - d)) and w^3j ((a - c) + i (b - d)); the inverse
+ * multiplies by the conjugate twiddles and recovers 4a, 4b, 4c, 4d.
+ */
+#define FFT_KERNELS(name, attr, lanes)                                                              \
+    attr static inline void name##_cmul(name##_vec_t *xr, name##_vec_t *xi, name##_vec_t wr,       \
+                                        name##_vec_t wi) {                                          \
+        name##_vec_t r = name##_fmsub(*xr, wr, name##_mul(*xi, wi));                                \
+        *xi = name##_fmadd(*xr, wi, name##_mul(*xi, wr));                                           \
+        *xr = r;                                                                                    \
+    }                                                                                               \
+    attr static inline void name##_cmul_conj(name##_vec_t *xr, name##_vec_t *xi, name##_vec_t wr,  \
+                                             name##_vec_t wi) {                                     \
+        name##_vec_t r = name##_fmadd(*xr, wr, name##_mul(*xi, wi));                                \
+        *xi = name##_fmsub(*xi, wr, name##_mul(*xr, wi));                                           \
+        *xr = r;                                                                                    \
+    }                                                                                               \
+    attr static void name##_dif4(double *re, double *im, size_t len, size_t q, const double *tw) {   \
+        if ((lanes) > 1 && q < (lanes)) {                                                           \
+            fft_scalar_dif4(re, im, len, q, tw);                                                    \
+            return;                                                                                 \
+        }                                                                                           \
+        for (size_t base = 0; base < len; base += 4 * q) {                                          \
+            double *r0 = re + base, *r1 = r0 + q, *r2 = r1 + q, *r3 = r2 + q;                       \
+            double *i0 = im + base, *i1 = i0 + q, *i2 = i1 + q, *i3 = i2 + q;                       \
+            for (size_t j = 0; j < q; j += (lanes)) {                                               \
+                name##_vec_t ar = name##_load(r0 + j), ai = name##_load(i0 + j);                    \
+                name##_vec_t br = name##_load(r1 + j), bi = name##_load(i1 + j);                    \
+                name##_vec_t cr = name##_load(r2 + j), ci = name##_load(i2 + j);                    \
+                name##_vec_t dr = name##_load(r3 + j), di = name##_load(i3 + j);                    \
+                name##_vec_t s0r = name##_add(ar, cr), s0i = name##_add(ai, ci);                    \
+                name##_vec_t d0r = name##_sub(ar, cr), d0i = name##_sub(ai, ci);                    \
+                name##_vec_t s1r = name##_add(br, dr), s1i = name##_add(bi, di);                    \
+                name##_vec_t d1r = name##_sub(br, dr), d1i = name##_sub(bi, di);                    \
+                name##_store(r0 + j, name##_add(s0r, s1r));                                         \
+                name##_store(i0 + j, name##_add(s0i, s1i));                                         \
+                name##_vec_t yr = name##_sub(s0r, s1r), yi = name##_sub(s0i, s1i);                  \
+                name##_cmul(&yr, &yi, name##_load(tw + 2 * q + j), name##_load(tw + 3 * q + j));     \
+                name##_store(r1 + j, yr);                                                           \
+                name##_store(i1 + j, yi);                                                           \
+                yr = name##_add(d0r, d1i);                                                          \
+                yi = name##_sub(d0i, d1r);                                                          \
+                name##_cmul(&yr, &yi, name##_load(tw + j), name##_load(tw + q + j));                 \
+                name##_store(r2 + j, yr);                                                           \
+                name##_store(i2 + j, yi);                                                           \
+                yr = name##_sub(d0r, d1i);                                                          \
+                yi = name##_add(d0i, d1r);                                                          \
+                name##_cmul(&yr, &yi, name##_load(tw + 4 * q + j), name##_load(tw + 5 * q + j));     \
+                name##_store(r3 + j, yr);                                                           \
+                name##_store(i3 + j, yi);                                                           \
+            }                                                                                       \
+        }                                                                                           \
+    }                                                                                               \
+    attr static void name##_dit4(double *re, double *im, size_t len, size_t q, const double *tw) {   \
+        if ((lanes) > 1 && q < (lanes)) {                                                           \
+            fft_scalar_dit4(re, im, len, q, tw);                                                    \
+            return;                                                                                 \
+        }                                                                                           \
+        for (size_t base = 0; base < len; base += 4 * q) {                                          \
+            double *r0 = re + base, *r1 = r0 + q, *r2 = r1 + q, *r3 = r2 + q;                       \
+            double *i0 = im + base, *i1 = i0 + q, *i2 = i1 + q, *i3 = i2 + q;                       \
+            for (size_t j = 0; j < q; j += (lanes)) {                                               \
+                name##_vec_t x0r = name##_load(r0 + j), x0i = name##_load(i0 + j);                  \
+                name##_vec_t x1r = name##_load(r1 + j), x1i = name##_load(i1 + j);                  \
+                name##_vec_t x2r = name##_load(r2 + j), x2i = name##_load(i2 + j);                  \
+                name##_vec_t x3r = name##_load(r3 + j), x3i = name##_load(i3 + j);                  \
+                name##_cmul_conj(&x1r, &x1i, name##_load(tw + 2 * q + j), name##_load(tw + 3 * q + j)); \
+                name##_cmul_conj(&x2r, &x2i, name##_load(tw + j), name##_load(tw + q + j));          \
+                name##_cmul_conj(&x3r, &x3i, name##_load(tw + 4 * q + j), name##_load(tw + 5 * q + j)); \
+                name##_vec_t sar = name##_add(x0r, x1r), sai = name##_add(x0i, x1i);                \
+                name##_vec_t sbr = name##_sub(x0r, x1r), sbi = name##_sub(x0i, x1i);                \
+                name##_vec_t scr = name##_add(x2r, x3r), sci = name##_add(x2i, x3i);                \
+                name##_vec_t sdr = name##_sub(x3i, x2i), sdi = name##_sub(x2r, x3r);                \
+                name##_store(r0 + j, name##_add(sar, scr));                                         \
+                name##_store(i0 + j, name##_add(sai, sci));                                         \
+                name##_store(r2 + j, name##_sub(sar, scr));                                         \
+                name##_store(i2 + j, name##_sub(sai, sci));                                         \
+                name##_store(r1 + j, name##_add(sbr, sdr));                                         \
+                name##_store(i1 + j, name##_add(sbi, sdi));                                         \
+                name##_store(r3 + j, name##_sub(sbr, sdr));                                         \
+                name##_store(i3 + j, name##_sub(sbi, sdi));                                         \
+            }                                                                                       \
+        }                                                                                           \
+    }                                                                                               \
+    attr static void name##_pointwise(double *dr, double *di, const double *ar, const double *ai,    \
+                                      const double *br, const double *bi, double scale, size_t n) { \
+        const name##_vec_t s = name##_set1(scale);                                                  \
+        size_t i = 0;                                                                               \
+        for (; i + (lanes) <= n; i += (lanes)) {                                                    \
+            name##_vec_t xr = name##_mul(name##_load(ar + i), s);                                   \
+            name##_vec_t xi = name##_mul(name##_load(ai + i), s);                                   \
+            name##_cmul(&xr, &xi, name##_load(br + i), name##_load(bi + i));                        \
+            name##_store(dr + i, xr);                                                               \
+            name##_store(di + i, xi);                                                               \
+        }                                                                                           \
+        if ((lanes) > 1 && i < n) fft_scalar_pointwise(dr + i, di + i, ar + i, ai + i, br + i, bi + i, scale, n - i); \
+    }                                                                                               \
+    static const fft_ops_t name##_ops = { (lanes), name##_dif4, name##_dit4, name##_pointwise };
+
+typedef double fft_scalar_vec_t;
+
+static inline double fft_scalar_load(const double *p) {
+    return *p;
+}
+static inline void fft_scalar_store(double *p, double v) {
+    *p = v;
+}
+static inline double fft_scalar_set1(double x) {
+    return x;
+}
+static inline double fft_scalar_add(double a, double b) {
+    return a + b;
+}
+static inline double fft_scalar_sub(double a, double b) {
+    return a - b;
+}
+static inline double fft_scalar_mul(double a, double b) {
+    return a * b;
+}
+static inline double fft_scalar_fmadd(double a, double b, double c) {
+    return a * b + c;
+}
+static inline double fft_scalar_fmsub(double a, double b, double c) {
+    return a * b - c;
+}
+
+static void fft_scalar_dif4(double *re, double *im, size_t len, size_t q, const double *tw);
+static void fft_scalar_dit4(double *re, double *im, size_t len, size_t q, const double *tw);
+static void fft_scalar_pointwise(double *dr, double *di, const double *ar, const double *ai, const double *br,
+                                 const double *bi, double scale, size_t n);
+
+FFT_KERNELS(fft_scalar, , 1)
+
+#if defined(TTAK_ARCH_X86_64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#define TTAK_FFT_X86_64 1
+#include <immintrin.h>
+
+#define FFT_AVX2 __attribute__((target("avx2,fma")))
+#define FFT_AVX512 __attribute__((target("avx512f")))
+
+typedef __m256d fft_avx2_vec_t;
+
+FFT_AVX2 static inline __m256d fft_avx2_load(const double *p) {
+    return _mm256_loadu_pd(p);
+}
+FFT_AVX2 static inline void fft_avx2_store(double *p, __m256d v) {
+    _mm256_storeu_pd(p, v);
+}
+FFT_AVX2 static inline __m256d fft_avx2_set1(double x) {
+    return _mm256_set1_pd(x);
+}
+FFT_AVX2 static inline __m256d fft_avx2_add(__m256d a, __m256d b) {
+    return _mm256_add_pd(a, b);
+}
+FFT_AVX2 static inline __m256d fft_avx2_sub(__m256d a, __m256d b) {
+    return _mm256_sub_pd(a, b);
+}
+FFT_AVX2 static inline __m256d fft_avx2_mul(__m256d a, __m256d b) {
+    return _mm256_mul_pd(a, b);
+}
+FFT_AVX2 static inline __m256d fft_avx2_fmadd(__m256d a, __m256d b, __m256d c) {
+    return _mm256_fmadd_pd(a, b, c);
+}
+FFT_AVX2 static inline __m256d fft_avx2_fmsub(__m256d a, __m256d b, __m256d c) {
+    return _mm256_fmsub_pd(a, b, c);
+}
+
+FFT_KERNELS(fft_avx2, FFT_AVX2, 4)
+
+typedef __m512d fft_avx512_vec_t;
+
+FFT_AVX512 static inline __m512d fft_avx512_load(const double *p) {
+    return _mm512_loadu_pd(p);
+}
+FFT_AVX512 static inline void fft_avx512_store(double *p, __m512d v) {
+    _mm512_storeu_pd(p, v);
+}
+FFT_AVX512 static inline __m512d fft_avx512_set1(double x) {
+    return _mm512_set1_pd(x);
+}
+FFT_AVX512 static inline __m512d fft_avx512_add(__m512d a, __m512d b) {
+    return _mm512_add_pd(a, b);
+}
+FFT_AVX512 static inline __m512d fft_avx512_sub(__m512d a, __m512d b) {
+    return _mm512_sub_pd(a, b);
+}
+FFT_AVX512 static inline __m512d fft_avx512_mul(__m512d a, __m512d b) {
+    return _mm512_mul_pd(a, b);
+}
+FFT_AVX512 static inline __m512d fft_avx512_fmadd(__m512d a, __m512d b, __m512d c) {
+    return _mm512_fmadd_pd(a, b, c);
+}
+FFT_AVX512 static inline __m512d fft_avx512_fmsub(__m512d a, __m512d b, __m512d c) {
+    return _mm512_fmsub_pd(a, b, c);
+}
+
+FFT_KERNELS(fft_avx512, FFT_AVX512, 8)
+
+#elif defined(TTAK_ARCH_AARCH64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#define TTAK_FFT_NEON 1
+#include <arm_neon.h>
+
+typedef float64x2_t fft_neon_vec_t;
+
+static inline float64x2_t fft_neon_load(const double *p) {
+    return vld1q_f64(p);
+}
+static inline void fft_neon_store(double *p, float64x2_t v) {
+    vst1q_f64(p, v);
+}
+static inline float64x2_t fft_neon_set1(double x) {
+    return vdupq_n_f64(x);
+}
+static inline float64x2_t fft_neon_add(float64x2_t a, float64x2_t b) {
+    return vaddq_f64(a, b);
+}
+static inline float64x2_t fft_neon_sub(float64x2_t a, float64x2_t b) {
+    return vsubq_f64(a, b);
+}
+static inline float64x2_t fft_neon_mul(float64x2_t a, float64x2_t b) {
+    return vmulq_f64(a, b);
+}
+static inline float64x2_t fft_neon_fmadd(float64x2_t a, float64x2_t b, float64x2_t c) {
+    return vfmaq_f64(c, a, b);
+}
+static inline float64x2_t fft_neon_fmsub(float64x2_t a, float64x2_t b, float64x2_t c) {
+    return vnegq_f64(vfmsq_f64(c, a, b));
+}
+
+FFT_KERNELS(fft_neon, , 2)
+#endif
+
+ttak_fft_kernel_t ttak_fft_kernel_default(void) {
+    const char *env = getenv("TTAK_FFT_KERNEL");
+    if (env && strcmp(env, "scalar") == 0) return TTAK_FFT_KERNEL_SCALAR;
+    uint32_t features = ttak_arch_features();
+    (void)features;
+#if defined(TTAK_FFT_X86_64)
+    if (features & TTAK_ARCH_FEATURE_AVX512F) return TTAK_FFT_KERNEL_AVX512;
+    const uint32_t want = TTAK_ARCH_FEATURE_AVX2 | TTAK_ARCH_FEATURE_FMA;
+    if ((features & want) == want) return TTAK_FFT_KERNEL_AVX2;
+#elif defined(TTAK_FFT_NEON)
+    if (features & TTAK_ARCH_FEATURE_NEON) return TTAK_FFT_KERNEL_NEON;
+#endif
+    return TTAK_FFT_KERNEL_SCALAR;
+}
+
+const char *ttak_fft_kernel_name(ttak_fft_kernel_t kernel) {
+    switch (kernel) {
+        case TTAK_FFT_KERNEL_AVX2:
+            return "avx2";
+        case TTAK_FFT_KERNEL_AVX512:
+            return "avx512";
+        case TTAK_FFT_KERNEL_NEON:
+            return "neon";
+        case TTAK_FFT_KERNEL_SCALAR:
+        default:
+            return "scalar";
+    }
+}
+
+static const fft_ops_t *fft_ops_for(ttak_fft_kernel_t kernel) {
+    switch (kernel) {
+        case TTAK_FFT_KERNEL_AVX2:
+#if defined(TTAK_FFT_X86_64)
+            return &fft_avx2_ops;
+#endif
+            return &fft_scalar_ops;
+        case TTAK_FFT_KERNEL_AVX512:
+#if defined(TTAK_FFT_X86_64)
+            return &fft_avx512_ops;
+#endif
+            return &fft_scalar_ops;
+        case TTAK_FFT_KERNEL_NEON:
+#if defined(TTAK_FFT_NEON)
+            return &fft_neon_ops;
+#endif
+            return &fft_scalar_ops;
+        case TTAK_FFT_KERNEL_SCALAR:
+        default:
+            return &fft_scalar_ops;
+    }
+}
+
+/* Smallest radix-4 quarter: 1 for even log2 n, 2 for odd, where a radix-2 pass finishes. */
+static size_t fft_q0(size_t n) {
+    size_t lg = 0;
+    while (((size_t)1 << lg) < n) lg++;
+    return (lg & 1) ? 2 : 1;
+}
+
+/* The twiddle-free radix-2 stage on adjacent pairs; applied twice it doubles the input. */
+static void fft_pairs(double *re, double *im, size_t len) {
+    for (size_t k = 0; k < len; k += 2) {
+        double ar = re[k], ai = im[k];
+        re[k] = ar + re[k + 1];
+        im[k] = ai + im[k + 1];
+        re[k + 1] = ar - re[k + 1];
+        im[k + 1] = ai - im[k + 1];
+    }
+}
+
+bool ttak_fft_plan_init(ttak_fft_plan_t *plan, size_t n) {
+    if (!plan) return false;
+    memset(plan, 0, sizeof(*plan));
+    if (n == 0 || (n & (n - 1)) != 0 || n > ((size_t)1 << TTAK_FFT_MAX_LOG)) return false;
+    plan->n = n;
+    plan->kernel = ttak_fft_kernel_default();
+    if (n < 4) return true;
+
+    const size_t q0 = fft_q0(n);
+    plan->twiddles = ttak_mem_alloc_lite(2 * n * sizeof(double), __TTAK_UNSAFE_MEM_FOREVER__, 0, TTAK_MEM_DEFAULT);
+    if (!plan->twiddles) return false;
+    const double quarter_turn = 1.57079632679489661923132169163975144;
+    for (size_t q = q0; q <= n / 4; q *= 4) {
+        double *tw = plan->twiddles + 2 * (q - q0);
+        for (size_t j = 0; j < q; j++) {
+            /* -2 pi j / 4q, and its double and triple. */
+            double a = -quarter_turn * ((double)j / (double)q);
+            tw[j] = cos(a);
+            tw[q + j] = sin(a);
+            tw[2 * q + j] = cos(2 * a);
+            tw[3 * q + j] = sin(2 * a);
+            tw[4 * q + j] = cos(3 * a);
+            tw[5 * q + j] = sin(3 * a);
+        }
+    }
+    return true;
+}
+
+void ttak_fft_plan_destroy(ttak_fft_plan_t *plan) {
+    if (!plan) return;
+    if (plan->twiddles) ttak_mem_free_lite(plan->twiddles);
+    plan->twiddles = NULL;
+    plan->n = 0;
+}
+
+/* Plans are built on first use and kept for the life of the process. */
+static _Atomic(ttak_fft_plan_t *) fft_plans[TTAK_FFT_MAX_LOG + 1];
+
+const ttak_fft_plan_t *ttak_fft_plan_get(size_t n, uint64_t now) {
+    if (n == 0 || (n & (n - 1)) != 0 || n > ((size_t)1 << TTAK_FFT_MAX_LOG)) return NULL;
+    unsigned lg = 0;
+    while (((size_t)1 << lg) < n) lg++;
+    ttak_fft_plan_t *plan = atomic_load_explicit(&fft_plans[lg], memory_order_acquire);
+    if (plan) return plan;
+    plan = ttak_mem_alloc_lite(sizeof(*plan), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    if (!plan) return NULL;
+    if (!ttak_fft_plan_init(plan, n)) {
+        ttak_fft_plan_destroy(plan);
+        ttak_mem_free_lite(plan);
+        return NULL;
+    }
+    ttak_fft_plan_t *seen = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&fft_plans[lg], &seen, plan, memory_order_acq_rel,
+                                                 memory_order_acquire)) {
+        ttak_fft_plan_destroy(plan);
+        ttak_mem_free_lite(plan);
+        return seen;
+    }
+    return plan;
+}
+
+/*
+ * Decimation in frequency. Stages whose butterflies span more than a block
+ * sweep the whole array; the rest finish one block at a time while it is
+ * still in cache.
+ */
+void ttak_fft_plan_forward(const ttak_fft_plan_t *plan, double *re, double *im) {
+    const size_t n = plan->n;
+    if (n < 2) return;
+    if (n == 2) {
+        fft_pairs(re, im, 2);
+        return;
+    }
+    const fft_ops_t *ops = fft_ops_for(plan->kernel);
+    const size_t q0 = fft_q0(n);
+    const size_t block = n < TTAK_FFT_BLOCK_ELEMS ? n : TTAK_FFT_BLOCK_ELEMS;
+    size_t q = n / 4;
+    for (; q >= q0 && 4 * q > block; q /= 4) ops->dif4(re, im, n, q, plan->twiddles + 2 * (q - q0));
+    for (size_t b = 0; b < n; b += block) {
+        for (size_t s = q; s >= q0; s /= 4) ops->dif4(re + b, im + b, block, s, plan->twiddles + 2 * (s - q0));
+        if (q0 == 2) fft_pairs(re + b, im + b, block);
+    }
+}
+
+void ttak_fft_plan_pointwise_mul(const ttak_fft_plan_t *plan, double *dst_re, double *dst_im,
+                                 const double *lhs_re, const double *lhs_im, const double *rhs_re,
+                                 const double *rhs_im, double scale) {
+    fft_ops_for(plan->kernel)->pointwise(dst_re, dst_im, lhs_re, lhs_im, rhs_re, rhs_im, scale, plan->n);
+}
+
+/* Decimation in time with conjugate twiddles, the mirror of the forward pass. */
+void ttak_fft_plan_inverse(const ttak_fft_plan_t *plan, double *re, double *im) {
+    const size_t n = plan->n;
+    if (n < 2) return;
+    if (n == 2) {
+        fft_pairs(re, im, 2);
+    } else {
+        const fft_ops_t *ops = fft_ops_for(plan->kernel);
+        const size_t q0 = fft_q0(n);
+        const size_t block = n < TTAK_FFT_BLOCK_ELEMS ? n : TTAK_FFT_BLOCK_ELEMS;
+        size_t q = q0;
+        for (size_t b = 0; b < n; b += block) {
+            if (q0 == 2) fft_pairs(re + b, im + b, block);
+            for (q = q0; 4 * q <= block; q *= 4) ops->dit4(re + b, im + b, block, q, plan->twiddles + 2 * (q - q0));
+        }
+        for (; q <= n / 4; q *= 4) ops->dit4(re, im, n, q, plan->twiddles + 2 * (q - q0));
+    }
+    const double scale = 1.0 / (double)n;
+    for (size_t i = 0; i < n; i++) {
+        re[i] *= scale;
+        im[i] *= scale;
+    }
+}
+
+void ttak_fft_bit_reverse(double *re, double *im, size_t n) {
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j) {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+}
@@ -0,0 +1,338 @@
+/**
+ * @file limbs.c
+ * @brief Portable and x86-64 limb-vector kernels with runtime selection.
+ *
+ * The x86-64 loops keep their carry in the flags for the whole array, so
+ * the loop control uses only lea and jrcxz, which leave the flags alone.
+ * The multiply kernels handle four limbs per iteration and alternate two
+ * registers for the high halves: adcx folds in the destination limb on
+ * the CF chain while adox adds the previous high half on the OF chain.
+ */
+
+#include <ttak/math/limbs.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/types/ttak_compiler.h>
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TTAK_LIMB_BITS TTAK_BIGINT_LIMB_BITS
+
+typedef struct ttak_limbs_ops {
+    const char *name;
+    limb_t (*add_n)(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n);
+    limb_t (*sub_n)(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n);
+    limb_t (*mul_1)(limb_t *rp, const limb_t *ap, size_t n, limb_t b);
+    limb_t (*addmul_1)(limb_t *rp, const limb_t *ap, size_t n, limb_t b);
+    limb_t (*submul_1)(limb_t *rp, const limb_t *ap, size_t n, limb_t b);
+} ttak_limbs_ops_t;
+
+/* --- Portable C --- */
+
+static limb_t ttak_limbs_add_n_c(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t a = ap[i];
+        limb_t s = a + bp[i];
+        limb_t c = s < a;
+        limb_t r = s + carry;
+        carry = c | (r < s);
+        rp[i] = r;
+    }
+    return carry;
+}
+
+static limb_t ttak_limbs_sub_n_c(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n) {
+    limb_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t a = ap[i];
+        limb_t d = a - bp[i];
+        limb_t b = a < bp[i];
+        limb_t r = d - borrow;
+        borrow = b | (d < borrow);
+        rp[i] = r;
+    }
+    return borrow;
+}
+
+static limb_t ttak_limbs_mul_1_c(limb_t *rp, const limb_t *ap, size_t n, limb_t b) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        ttak_dlimb_t p = (ttak_dlimb_t)ap[i] * b + carry;
+        rp[i] = (limb_t)p;
+        carry = (limb_t)(p >> TTAK_LIMB_BITS);
+    }
+    return carry;
+}
+
+static limb_t ttak_limbs_addmul_1_c(limb_t *rp, const limb_t *ap, size_t n, limb_t b) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        ttak_dlimb_t p = (ttak_dlimb_t)ap[i] * b + rp[i] + carry;
+        rp[i] = (limb_t)p;
+        carry = (limb_t)(p >> TTAK_LIMB_BITS);
+    }
+    return carry;
+}
+
+static limb_t ttak_limbs_submul_1_c(limb_t *rp, const limb_t *ap, size_t n, limb_t b) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        ttak_dlimb_t p = (ttak_dlimb_t)ap[i] * b + carry;
+        limb_t lo = (limb_t)p;
+        /* The high half is at most B - 2, so the extra borrow cannot wrap it. */
+        carry = (limb_t)(p >> TTAK_LIMB_BITS);
+        limb_t r = rp[i];
+        rp[i] = r - lo;
+        carry += r < lo;
+    }
+    return carry;
+}
+
+static const ttak_limbs_ops_t g_limbs_generic = {
+    "generic",
+    ttak_limbs_add_n_c,
+    ttak_limbs_sub_n_c,
+    ttak_limbs_mul_1_c,
+    ttak_limbs_addmul_1_c,
+    ttak_limbs_submul_1_c,
+};
+
+/* --- x86-64 --- */
+
+#if TTAK_LIMB_BITS == 64 && defined(TTAK_ARCH_X86_64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#define TTAK_LIMBS_X86_64 1
+
+/* Expands to an adc (add) or sbb (sub) loop; the carry stays in CF throughout. */
+#define TTAK_LIMBS_X86_ADDSUB(op)                                                   \
+    size_t blocks = n / 4;                                                          \
+    size_t tail = n % 4;                                                            \
+    limb_t t;                                                                       \
+    unsigned char c;                                                                \
+    __asm__ volatile(                                                               \
+        "clc\n\t"                                                                   \
+        "jrcxz 3f\n"                                                                \
+        "1:\n\t"                                                                    \
+        "movq (%[a]), %[t]\n\t"                                                     \
+        op " (%[b]), %[t]\n\t"                                                      \
+        "movq %[t], (%[r])\n\t"                                                     \
+        "movq 8(%[a]), %[t]\n\t"                                                    \
+        op " 8(%[b]), %[t]\n\t"                                                     \
+        "movq %[t], 8(%[r])\n\t"                                                    \
+        "movq 16(%[a]), %[t]\n\t"                                                   \
+        op " 16(%[b]), %[t]\n\t"                                                    \
+        "movq %[t], 16(%[r])\n\t"                                                   \
+        "movq 24(%[a]), %[t]\n\t"                                                   \
+        op " 24(%[b]), %[t]\n\t"                                                    \
+        "movq %[t], 24(%[r])\n\t"                                                   \
+        "leaq 32(%[a]), %[a]\n\t"                                                   \
+        "leaq 32(%[b]), %[b]\n\t"                                                   \
+        "leaq 32(%[r]), %[r]\n\t"                                                   \
+        "leaq -1(%[n]), %[n]\n\t"                                                   \
+        "jrcxz 3f\n\t"                                                              \
+        "jmp 1b\n"                                                                  \
+        "3:\n\t"                                                                    \
+        "movq %[tail], %[n]\n\t"                                                    \
+        "jrcxz 5f\n"                                                                \
+        "4:\n\t"                                                                    \
+        "movq (%[a]), %[t]\n\t"                                                     \
+        op " (%[b]), %[t]\n\t"                                                      \
+        "movq %[t], (%[r])\n\t"                                                     \
+        "leaq 8(%[a]), %[a]\n\t"                                                    \
+        "leaq 8(%[b]), %[b]\n\t"                                                    \
+        "leaq 8(%[r]), %[r]\n\t"                                                    \
+        "leaq -1(%[n]), %[n]\n\t"                                                   \
+        "jrcxz 5f\n\t"                                                              \
+        "jmp 4b\n"                                                                  \
+        "5:\n\t"                                                                    \
+        "setc %[c]\n\t"                                                             \
+        : [t] "=&r"(t), [c] "=&r"(c), [r] "+r"(rp), [a] "+r"(ap), [b] "+r"(bp),     \
+          [n] "+c"(blocks)                                                          \
+        : [tail] "r"(tail)                                                          \
+        : "cc", "memory");                                                          \
+    (void)t;                                                                        \
+    return c
+
+static limb_t ttak_limbs_add_n_x86(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n) {
+    TTAK_LIMBS_X86_ADDSUB("adcq");
+}
+
+static limb_t ttak_limbs_sub_n_x86(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n) {
+    TTAK_LIMBS_X86_ADDSUB("sbbq");
+}
+
+#undef TTAK_LIMBS_X86_ADDSUB
+
+/*
+ * One limb of addmul_1: rp[off] += ap[off] * rdx + prev, leaving the high
+ * half in next. CF carries the destination add, OF the high-half add.
+ */
+#define TTAK_LIMBS_ADX_STEP(off, prev, next)                                        \
+    "mulxq " off "(%[a]), %[lo], %[" next "]\n\t"                                   \
+    "adcxq " off "(%[r]), %[lo]\n\t"                                                \
+    "adoxq %[" prev "], %[lo]\n\t"                                                  \
+    "movq %[lo], " off "(%[r])\n\t"
+
+static limb_t ttak_limbs_addmul_1_adx(limb_t *rp, const limb_t *ap, size_t n, limb_t b) {
+    size_t blocks = n / 4;
+    size_t tail = n % 4;
+    limb_t lo, hi, carry = 0;
+    __asm__ volatile(
+        "xorl %k[lo], %k[lo]\n\t" /* clears CF and OF */
+        "jrcxz 3f\n"
+        "1:\n\t"
+        TTAK_LIMBS_ADX_STEP("0", "carry", "hi")
+        TTAK_LIMBS_ADX_STEP("8", "hi", "carry")
+        TTAK_LIMBS_ADX_STEP("16", "carry", "hi")
+        TTAK_LIMBS_ADX_STEP("24", "hi", "carry")
+        "leaq 32(%[a]), %[a]\n\t"
+        "leaq 32(%[r]), %[r]\n\t"
+        "leaq -1(%[n]), %[n]\n\t"
+        "jrcxz 3f\n\t"
+        "jmp 1b\n"
+        "3:\n\t"
+        "movq %[tail], %[n]\n\t"
+        "jrcxz 5f\n"
+        "4:\n\t"
+        TTAK_LIMBS_ADX_STEP("0", "carry", "hi")
+        "movq %[hi], %[carry]\n\t"
+        "leaq 8(%[a]), %[a]\n\t"
+        "leaq 8(%[r]), %[r]\n\t"
+        "leaq -1(%[n]), %[n]\n\t"
+        "jrcxz 5f\n\t"
+        "jmp 4b\n"
+        "5:\n\t"
+        /* The full sum fits in n + 1 limbs, so folding both flags in cannot overflow. */
+        "movl $0, %k[lo]\n\t"
+        "adcxq %[lo], %[carry]\n\t"
+        "adoxq %[lo], %[carry]\n\t"
+        : [lo] "=&r"(lo), [hi] "=&r"(hi), [carry] "+&r"(carry), [r] "+r"(rp), [a] "+r"(ap),
+          [n] "+c"(blocks)
+        : [tail] "r"(tail), "d"(b)
+        : "cc", "memory");
+    (void)lo;
+    (void)hi;
+    return carry;
+}
+
+#undef TTAK_LIMBS_ADX_STEP
+
+/* One limb of mul_1: rp[off] = ap[off] * rdx + prev on the CF chain. */
+#define TTAK_LIMBS_MULX_STEP(off, prev, next)                                       \
+    "mulxq " off "(%[a]), %[lo], %[" next "]\n\t"                                   \
+    "adcxq %[" prev "], %[lo]\n\t"                                                  \
+    "movq %[lo], " off "(%[r])\n\t"
+
+static limb_t ttak_limbs_mul_1_adx(limb_t *rp, const limb_t *ap, size_t n, limb_t b) {
+    size_t blocks = n / 4;
+    size_t tail = n % 4;
+    limb_t lo, hi, carry = 0;
+    __asm__ volatile(
+        "xorl %k[lo], %k[lo]\n\t"
+        "jrcxz 3f\n"
+        "1:\n\t"
+        TTAK_LIMBS_MULX_STEP("0", "carry", "hi")
+        TTAK_LIMBS_MULX_STEP("8", "hi", "carry")
+        TTAK_LIMBS_MULX_STEP("16", "carry", "hi")
+        TTAK_LIMBS_MULX_STEP("24", "hi", "carry")
+        "leaq 32(%[a]), %[a]\n\t"
+        "leaq 32(%[r]), %[r]\n\t"
+        "leaq -1(%[n]), %[n]\n\t"
+        "jrcxz 3f\n\t"
+        "jmp 1b\n"
+        "3:\n\t"
+        "movq %[tail], %[n]\n\t"
+        "jrcxz 5f\n"
+        "4:\n\t"
+        TTAK_LIMBS_MULX_STEP("0", "carry", "hi")
+        "movq %[hi], %[carry]\n\t"
+        "leaq 8(%[a]), %[a]\n\t"
+        "leaq 8(%[r]), %[r]\n\t"
+        "leaq -1(%[n]), %[n]\n\t"
+        "jrcxz 5f\n\t"
+        "jmp 4b\n"
+        "5:\n\t"
+        "movl $0, %k[lo]\n\t"
+        "adcxq %[lo], %[carry]\n\t"
+        : [lo] "=&r"(lo), [hi] "=&r"(hi), [carry] "+&r"(carry), [r] "+r"(rp), [a] "+r"(ap),
+          [n] "+c"(blocks)
+        : [tail] "r"(tail), "d"(b)
+        : "cc", "memory");
+    (void)lo;
+    (void)hi;
+    return carry;
+}
+
+#undef TTAK_LIMBS_MULX_STEP
+
+static const ttak_limbs_ops_t g_limbs_x86 = {
+    "x86-64",
+    ttak_limbs_add_n_x86,
+    ttak_limbs_sub_n_x86,
+    ttak_limbs_mul_1_c,
+    ttak_limbs_addmul_1_c,
+    ttak_limbs_submul_1_c,
+};
+
+/* submul_1 needs one chain for the products and one for the subtraction; sbb clobbers OF, so it stays in C. */
+static const ttak_limbs_ops_t g_limbs_x86_adx = {
+    "x86-64-adx",
+    ttak_limbs_add_n_x86,
+    ttak_limbs_sub_n_x86,
+    ttak_limbs_mul_1_adx,
+    ttak_limbs_addmul_1_adx,
+    ttak_limbs_submul_1_c,
+};
+#endif
+
+/* --- Selection --- */
+
+static _Atomic(const ttak_limbs_ops_t *) g_limbs_ops = NULL;
+
+/* TTAK_BIGINT_KERNEL=generic forces the portable kernels, e.g. to cross-check results. */
+static const ttak_limbs_ops_t *ttak_limbs_select(void) {
+    const char *env = getenv("TTAK_BIGINT_KERNEL");
+    if (env && strcmp(env, "generic") == 0) return &g_limbs_generic;
+#ifdef TTAK_LIMBS_X86_64
+    const uint32_t want = TTAK_ARCH_FEATURE_BMI2 | TTAK_ARCH_FEATURE_ADX;
+    if ((ttak_arch_features() & want) == want) return &g_limbs_x86_adx;
+    return &g_limbs_x86;
+#else
+    return &g_limbs_generic;
+#endif
+}
+
+static inline const ttak_limbs_ops_t *ttak_limbs_ops(void) {
+    const ttak_limbs_ops_t *ops = atomic_load_explicit(&g_limbs_ops, memory_order_acquire);
+    if (TTAK_UNLIKELY(!ops)) {
+        /* Selection is idempotent, so a racing first call just repeats it. */
+        ops = ttak_limbs_select();
+        atomic_store_explicit(&g_limbs_ops, ops, memory_order_release);
+    }
+    return ops;
+}
+
+limb_t ttak_limbs_add_n(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n) {
+    return n ? ttak_limbs_ops()->add_n(rp, ap, bp, n) : 0;
+}
+
+limb_t ttak_limbs_sub_n(limb_t *rp, const limb_t *ap, const limb_t *bp, size_t n) {
+    return n ? ttak_limbs_ops()->sub_n(rp, ap, bp, n) : 0;
+}
+
+limb_t ttak_limbs_mul_1(limb_t *rp, const limb_t *ap, size_t n, limb_t b) {
+    return n ? ttak_limbs_ops()->mul_1(rp, ap, n, b) : 0;
+}
+
+limb_t ttak_limbs_addmul_1(limb_t *rp, const limb_t *ap, size_t n, limb_t b) {
+    return n ? ttak_limbs_ops()->addmul_1(rp, ap, n, b) : 0;
+}
+
+limb_t ttak_limbs_submul_1(limb_t *rp, const limb_t *ap, size_t n, limb_t b) {
+    return n ? ttak_limbs_ops()->submul_1(rp, ap, n, b) : 0;
+}
+
+const char *ttak_limbs_kernel_name(void) {
+    return ttak_limbs_ops()->name;
+}
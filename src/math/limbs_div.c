@@ -0,0 +1,329 @@
+/**
+ * @file limbs_div.c
+ * @brief Limb division and decimal conversion.
+ *
+ * Short divisors run Knuth's Algorithm D. Longer ones use the recursive
+ * division of Burnikel and Ziegler: the top half of each quotient block
+ * comes from dividing by the top half of the divisor, a product with the
+ * low half corrects it, and the low half of the block follows the same
+ * way, so a division costs a few multiplications of the ladder instead of
+ * n^2 limb steps. Decimal output splits a number by the cached powers
+ * 10^(k 2^i) and converts quotient and remainder recursively.
+ */
+
+#include <ttak/math/limbs.h>
+#include <ttak/mem/mem.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+#define TTAK_LIMB_BITS TTAK_BIGINT_LIMB_BITS
+
+/* Largest power of ten in a limb and its digit count. */
+#if TTAK_LIMB_BITS == 64
+#define DEC_CHUNK ((limb_t)10000000000000000000ULL)
+#define DEC_CHUNK_DIGITS 19
+#else
+#define DEC_CHUNK ((limb_t)1000000000UL)
+#define DEC_CHUNK_DIGITS 9
+#endif
+
+/* Squarings of DEC_CHUNK kept; 2^40 chunks is far past any allocation. */
+#define DEC_POW_LEVELS 40
+
+static int cmp_n(const limb_t *ap, const limb_t *bp, size_t n) {
+    for (size_t i = n; i-- > 0;) {
+        if (ap[i] != bp[i]) return ap[i] < bp[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+/* rp -= 1 over n limbs; returns the borrow out. */
+static limb_t decrement(limb_t *rp, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (rp[i]-- != 0) return 0;
+    }
+    return 1;
+}
+
+static unsigned leading_zeros(limb_t x) {
+    unsigned s = 0;
+    while (!(x >> (TTAK_LIMB_BITS - 1))) {
+        x <<= 1;
+        s++;
+    }
+    return s;
+}
+
+/* rp = ap << s over n limbs with 0 <= s < TTAK_LIMB_BITS; returns the bits shifted out. */
+static limb_t lshift(limb_t *rp, const limb_t *ap, size_t n, unsigned s) {
+    if (s == 0) {
+        memmove(rp, ap, n * sizeof(limb_t));
+        return 0;
+    }
+    limb_t out = ap[n - 1] >> (TTAK_LIMB_BITS - s);
+    for (size_t i = n - 1; i > 0; i--) rp[i] = (ap[i] << s) | (ap[i - 1] >> (TTAK_LIMB_BITS - s));
+    rp[0] = ap[0] << s;
+    return out;
+}
+
+static void rshift(limb_t *rp, const limb_t *ap, size_t n, unsigned s) {
+    if (s == 0) {
+        memmove(rp, ap, n * sizeof(limb_t));
+        return;
+    }
+    for (size_t i = 0; i + 1 < n; i++) rp[i] = (ap[i] >> s) | (ap[i + 1] << (TTAK_LIMB_BITS - s));
+    rp[n - 1] = ap[n - 1] >> s;
+}
+
+/*
+ * Algorithm D on a normalised divisor: np (nn limbs) becomes the remainder
+ * in its low dn limbs, qp receives nn - dn limbs and the quotient limb
+ * above them, 0 or 1, is returned.
+ */
+static limb_t div_basecase(limb_t *qp, limb_t *np, size_t nn, const limb_t *dp, size_t dn) {
+    limb_t qh = cmp_n(np + nn - dn, dp, dn) >= 0;
+    if (qh) ttak_limbs_sub_n(np + nn - dn, np + nn - dn, dp, dn);
+    const limb_t v1 = dp[dn - 1];
+    const limb_t v2 = dn > 1 ? dp[dn - 2] : 0;
+    for (size_t j = nn - dn; j-- > 0;) {
+        limb_t *u = np + j;
+        ttak_dlimb_t u_hat = ((ttak_dlimb_t)u[dn] << TTAK_LIMB_BITS) | u[dn - 1];
+        ttak_dlimb_t q_hat = u_hat / v1;
+        ttak_dlimb_t r_hat = u_hat % v1;
+        while ((q_hat >> TTAK_LIMB_BITS) ||
+               (dn > 1 && q_hat * v2 > ((r_hat << TTAK_LIMB_BITS) | u[dn - 2]))) {
+            q_hat--;
+            r_hat += v1;
+            if (r_hat >> TTAK_LIMB_BITS) break;
+        }
+        limb_t borrow = ttak_limbs_submul_1(u, dp, dn, (limb_t)q_hat);
+        limb_t top = u[dn];
+        u[dn] = top - borrow;
+        if (top < borrow) {
+            q_hat--;
+            u[dn] += ttak_limbs_add_n(u, u, dp, dn);
+        }
+        qp[j] = (limb_t)q_hat;
+    }
+    return qh;
+}
+
+static bool dc_div_n(limb_t *qh, limb_t *qp, limb_t *np, const limb_t *dp, size_t n, limb_t *tp, uint64_t now);
+
+/*
+ * Divides the dn + b limbs at np by the normalised dp (b <= dn): b
+ * quotient limbs go to qp and the carry limb to *qh, the remainder stays
+ * in np[0, dn). The top 2b limbs are divided by the top b divisor limbs,
+ * then the product with the low dn - b limbs is taken back; that estimate
+ * is at most two too large. tp holds dn limbs.
+ */
+static bool dc_div_step(limb_t *qh, limb_t *qp, limb_t *np, const limb_t *dp, size_t dn, size_t b,
+                        limb_t *tp, uint64_t now) {
+    const size_t k = dn - b;
+    limb_t h;
+    if (b < TTAK_LIMBS_DC_DIV_THRESHOLD) {
+        h = div_basecase(qp, np + k, 2 * b, dp + k, b);
+    } else if (!dc_div_n(&h, qp, np + k, dp + k, b, tp, now)) {
+        return false;
+    }
+    if (k) {
+        if (!ttak_limbs_mul(tp, qp, b, dp, k, now)) return false;
+        limb_t cy = ttak_limbs_sub_n(np, np, tp, dn);
+        if (h) cy += ttak_limbs_sub_n(np + b, np + b, dp, k);
+        while (cy) {
+            h -= decrement(qp, b);
+            cy -= ttak_limbs_add_n(np, np, dp, dn);
+        }
+    }
+    *qh = h;
+    return true;
+}
+
+/* 2n limbs by n: the high quotient half, then the low one. */
+static bool dc_div_n(limb_t *qh, limb_t *qp, limb_t *np, const limb_t *dp, size_t n, limb_t *tp, uint64_t now) {
+    const size_t lo = n >> 1;
+    const size_t hi = n - lo;
+    limb_t ql;
+    if (!dc_div_step(qh, qp + lo, np + lo, dp, n, hi, tp, now)) return false;
+    return dc_div_step(&ql, qp, np, dp, n, lo, tp, now);
+}
+
+bool ttak_limbs_divrem(limb_t *qp, limb_t *rp, const limb_t *np, size_t nn, const limb_t *dp, size_t dn,
+                       uint64_t now) {
+    if (dn == 0 || nn < dn || dp[dn - 1] == 0) return false;
+    const size_t len = nn + 1;
+    const size_t qn = len - dn;
+    const bool recursive = dn >= TTAK_LIMBS_DC_DIV_THRESHOLD && qn >= TTAK_LIMBS_DC_DIV_THRESHOLD;
+    size_t words = len + dn + (qp ? 0 : qn) + (recursive ? dn : 0);
+    limb_t *ws = ttak_mem_alloc_lite(words * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    if (!ws) return false;
+    limb_t *un = ws;
+    limb_t *vn = un + len;
+    limb_t *q = qp ? qp : vn + dn;
+    limb_t *tp = vn + dn + (qp ? 0 : qn);
+
+    const unsigned s = leading_zeros(dp[dn - 1]);
+    lshift(vn, dp, dn, s);
+    un[nn] = lshift(un, np, nn, s);
+
+    /*
+     * The padded dividend is below vn * B^qn, so no quotient limb spills
+     * past qn. Blocks of dn quotient limbs run from the top, the odd-sized
+     * one first.
+     */
+    bool ok = true;
+    if (!recursive) {
+        div_basecase(q, un, len, vn, dn);
+    } else {
+        size_t b = qn % dn ? qn % dn : dn;
+        size_t off = qn - b;
+        limb_t qh;
+        ok = dc_div_step(&qh, q + off, un + off, vn, dn, b, tp, now);
+        while (ok && off) {
+            off -= dn;
+            ok = dc_div_step(&qh, q + off, un + off, vn, dn, dn, tp, now);
+        }
+    }
+    if (ok && rp) rshift(rp, un, dn, s);
+    ttak_mem_free_lite(ws);
+    return ok;
+}
+
+/*
+ * DEC_CHUNK^(2^i), built by squaring on first use and kept for the life
+ * of the process.
+ */
+typedef struct dec_pow {
+    size_t n;
+    limb_t limbs[];
+} dec_pow_t;
+
+static _Atomic(dec_pow_t *) dec_pows[DEC_POW_LEVELS];
+
+static const dec_pow_t *dec_pow_get(unsigned level, uint64_t now) {
+    dec_pow_t *p = atomic_load_explicit(&dec_pows[level], memory_order_acquire);
+    if (p) return p;
+    const dec_pow_t *prev = NULL;
+    size_t n = 1;
+    if (level) {
+        prev = dec_pow_get(level - 1, now);
+        if (!prev) return NULL;
+        n = 2 * prev->n;
+    }
+    p = ttak_mem_alloc_lite(sizeof(*p) + n * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    if (!p) return NULL;
+    if (prev) {
+        if (!ttak_limbs_mul(p->limbs, prev->limbs, prev->n, prev->limbs, prev->n, now)) {
+            ttak_mem_free_lite(p);
+            return NULL;
+        }
+        while (n > 1 && p->limbs[n - 1] == 0) n--;
+    } else {
+        p->limbs[0] = DEC_CHUNK;
+    }
+    p->n = n;
+    dec_pow_t *seen = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&dec_pows[level], &seen, p, memory_order_acq_rel,
+                                                 memory_order_acquire)) {
+        ttak_mem_free_lite(p);
+        return seen;
+    }
+    return p;
+}
+
+/* Writes the @p width digits of @p x, zero-padded to the left. */
+static char *put_chunk(char *out, limb_t x, size_t width) {
+    for (size_t i = width; i-- > 0;) {
+        out[i] = (char)('0' + x % 10);
+        x /= 10;
+    }
+    return out + width;
+}
+
+static char *put_minimal(char *out, limb_t x) {
+    size_t width = 1;
+    for (limb_t t = x; t >= 10; t /= 10) width++;
+    return put_chunk(out, x, width);
+}
+
+static char *put_zeros(char *out, size_t count) {
+    memset(out, '0', count);
+    return out + count;
+}
+
+/* x (xn < TTAK_LIMBS_DC_GET_STR_THRESHOLD limbs) by repeated division by DEC_CHUNK. */
+static char *get_str_basecase(char *out, const limb_t *xp, size_t xn, size_t width, bool pad) {
+    limb_t t[TTAK_LIMBS_DC_GET_STR_THRESHOLD];
+    limb_t chunks[2 * TTAK_LIMBS_DC_GET_STR_THRESHOLD + 1];
+    size_t m = 0;
+    memcpy(t, xp, xn * sizeof(limb_t));
+    while (xn) {
+        limb_t rem = 0;
+        for (size_t i = xn; i-- > 0;) {
+            ttak_dlimb_t cur = ((ttak_dlimb_t)rem << TTAK_LIMB_BITS) | t[i];
+            t[i] = (limb_t)(cur / DEC_CHUNK);
+            rem = (limb_t)(cur % DEC_CHUNK);
+        }
+        chunks[m++] = rem;
+        while (xn && t[xn - 1] == 0) xn--;
+    }
+    if (pad) {
+        out = put_zeros(out, width - m * DEC_CHUNK_DIGITS);
+    } else if (m) {
+        out = put_minimal(out, chunks[--m]);
+    }
+    while (m) out = put_chunk(out, chunks[--m], DEC_CHUNK_DIGITS);
+    return out;
+}
+
+/*
+ * Digits of x < DEC_CHUNK^(2^(level + 1)), exactly DEC_CHUNK_DIGITS <<
+ * (level + 1) of them when @p pad is set. Returns the end of the output,
+ * or NULL when scratch memory runs out.
+ */
+static char *get_str_rec(char *out, const limb_t *xp, size_t xn, int level, bool pad, uint64_t now) {
+    while (xn && xp[xn - 1] == 0) xn--;
+    const size_t width = (size_t)DEC_CHUNK_DIGITS << (level + 1);
+    if (level < 0 || xn < TTAK_LIMBS_DC_GET_STR_THRESHOLD) return get_str_basecase(out, xp, xn, width, pad);
+    const dec_pow_t *p = dec_pow_get((unsigned)level, now);
+    if (!p) return NULL;
+    if (xn < p->n || (xn == p->n && cmp_n(xp, p->limbs, xn) < 0)) {
+        /* The quotient is zero: only the padding of the high half is left. */
+        if (pad) out = put_zeros(out, width >> 1);
+        return get_str_rec(out, xp, xn, level - 1, pad, now);
+    }
+    size_t qn = xn - p->n + 1;
+    limb_t *q = ttak_mem_alloc_lite((qn + p->n) * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    if (!q) return NULL;
+    limb_t *r = q + qn;
+    if (ttak_limbs_divrem(q, r, xp, xn, p->limbs, p->n, now)) {
+        out = get_str_rec(out, q, qn, level - 1, pad, now);
+        if (out) out = get_str_rec(out, r, p->n, level - 1, true, now);
+    } else {
+        out = NULL;
+    }
+    ttak_mem_free_lite(q);
+    return out;
+}
+
+size_t ttak_limbs_get_str(char *out, const limb_t *xp, size_t xn, uint64_t now) {
+    while (xn && xp[xn - 1] == 0) xn--;
+    if (!xn) {
+        out[0] = '0';
+        return 1;
+    }
+    /* Climb until DEC_CHUNK^(2^(level + 1)), at least 2 n - 1 limbs long, exceeds x. */
+    int level = -1;
+    if (xn >= TTAK_LIMBS_DC_GET_STR_THRESHOLD) {
+        level = 0;
+        for (;;) {
+            const dec_pow_t *p = dec_pow_get((unsigned)level, now);
+            if (!p) return 0;
+            if (2 * p->n - 1 > xn || level + 1 == DEC_POW_LEVELS) break;
+            level++;
+        }
+    }
+    char *end = get_str_rec(out, xp, xn, level, false, now);
+    return end ? (size_t)(end - out) : 0;
+}
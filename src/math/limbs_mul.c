@@ -0,0 +1,640 @@
+/**
+ * @file limbs_mul.c
+ * @brief Size-tiered limb multiplication: schoolbook, Karatsuba, Toom-3, FFT, NTT.
+ *
+ * Each recursive step keeps its temporaries at the front of one workspace
+ * and hands the remainder to its children, so a product costs a single
+ * allocation sized by mul_itch(). Toom-3 interpolates in fixed-width two's
+ * complement, where the exact divisions by 2 and 3 are a shift and a Hensel
+ * division. The NTT tier cuts limbs into 32-bit digits, convolves them
+ * modulo the three built-in 30-bit NTT primes (or the two 50-bit ones on
+ * hosts with the IFMA kernel) through per-size plans cached for the life
+ * of the process, and rebuilds every coefficient with Garner's form of the
+ * CRT. Below that, the FFT tier convolves balanced digits in doubles, with
+ * the digit width chosen so a worst-case rounding bound stays under half.
+ */
+
+#include <ttak/math/limbs.h>
+#include <ttak/math/fft.h>
+#include <ttak/math/ntt.h>
+#include <ttak/mem/mem.h>
+
+#include <math.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define TTAK_LIMB_BITS TTAK_BIGINT_LIMB_BITS
+#define TTAK_LIMB_DIGITS (TTAK_LIMB_BITS / 32)
+
+/* Longest transform every built-in prime supports. */
+#define TTAK_LIMBS_NTT_MAX_LOG 21U
+
+typedef enum {
+    MUL_TIER_BASECASE,
+    MUL_TIER_CHUNKED,
+    MUL_TIER_KARATSUBA,
+    MUL_TIER_TOOM3,
+    MUL_TIER_FFT,
+    MUL_TIER_NTT
+} mul_tier_t;
+
+static bool mul_rec(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                    limb_t *ws, uint64_t now);
+
+static limb_t add_1(limb_t *rp, size_t n, limb_t c) {
+    for (size_t i = 0; i < n && c; i++) {
+        rp[i] += c;
+        c = rp[i] < c;
+    }
+    return c;
+}
+
+static limb_t sub_1(limb_t *rp, size_t n, limb_t b) {
+    for (size_t i = 0; i < n && b; i++) {
+        limb_t v = rp[i];
+        rp[i] = v - b;
+        b = v < b;
+    }
+    return b;
+}
+
+/* rp[0..rn) += sp[0..sn) with sn <= rn. */
+static limb_t add_into(limb_t *rp, size_t rn, const limb_t *sp, size_t sn) {
+    return add_1(rp + sn, rn - sn, ttak_limbs_add_n(rp, rp, sp, sn));
+}
+
+/* rp[0..rn) -= sp[0..sn) with sn <= rn. */
+static limb_t sub_into(limb_t *rp, size_t rn, const limb_t *sp, size_t sn) {
+    return sub_1(rp + sn, rn - sn, ttak_limbs_sub_n(rp, rp, sp, sn));
+}
+
+/* rp = |a - b| over an limbs (an >= bn); returns true when a < b. */
+static bool abs_diff(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn) {
+    bool less = false;
+    size_t i = an;
+    while (i > bn && ap[i - 1] == 0) i--;
+    if (i == bn) {
+        while (i > 0 && ap[i - 1] == bp[i - 1]) i--;
+        less = i > 0 && ap[i - 1] < bp[i - 1];
+    }
+    if (less) {
+        ttak_limbs_sub_n(rp, bp, ap, bn);
+        memset(rp + bn, 0, (an - bn) * sizeof(limb_t));
+    } else {
+        limb_t borrow = ttak_limbs_sub_n(rp, ap, bp, bn);
+        memcpy(rp + bn, ap + bn, (an - bn) * sizeof(limb_t));
+        sub_1(rp + bn, an - bn, borrow);
+    }
+    return less;
+}
+
+static void negate(limb_t *rp, size_t n) {
+    for (size_t i = 0; i < n; i++) rp[i] = ~rp[i];
+    add_1(rp, n, 1);
+}
+
+static void rshift_1(limb_t *rp, size_t n) {
+    for (size_t i = 0; i + 1 < n; i++) {
+        rp[i] = (rp[i] >> 1) | (rp[i + 1] << (TTAK_LIMB_BITS - 1));
+    }
+    rp[n - 1] >>= 1;
+}
+
+/* rp /= 3 for an exact multiple of 3, by Hensel division modulo B^n. */
+static void divexact_3(limb_t *rp, size_t n) {
+    const limb_t inv3 = (limb_t)~(limb_t)0 / 3 * 2 + 1;
+    limb_t c = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t s = rp[i];
+        limb_t l = s - c;
+        c = s < c;
+        limb_t q = l * inv3;
+        rp[i] = q;
+        c += (limb_t)(((ttak_dlimb_t)q * 3) >> TTAK_LIMB_BITS);
+    }
+}
+
+static bool ntt_fits(size_t an, size_t bn) {
+    return an + bn <= ((size_t)1 << TTAK_LIMBS_NTT_MAX_LOG) / TTAK_LIMB_DIGITS;
+}
+
+/* Karatsuba needs a non-empty high half on both sides. */
+static bool karatsuba_fits(size_t an, size_t bn) {
+    return bn >= 2 && bn > (an + 1) / 2;
+}
+
+static bool toom3_fits(size_t an, size_t bn) {
+    return bn >= 3 && bn > 2 * ((an + 2) / 3);
+}
+
+/*
+ * Widest digit, at most TTAK_LIMBS_FFT_MAX_BITS, for which the FFT product
+ * of an x bn limbs rounds correctly, or 0 if none of at least 8 bits does.
+ * Digits are balanced, |d| <= 2^(bits - 1) but for the top one, and the
+ * two operands ride in one complex vector z, so the error of z * z is
+ * bounded by Percival's eps |z|^2 (6 lg N + sqrt(5) (3 lg N + 1)) with
+ * twiddles good to an ulp; the product is half its imaginary part. The
+ * bound is kept below 0.4 so the nearest integer is the exact coefficient.
+ */
+static unsigned fft_digit_bits(size_t an, size_t bn, size_t *len_out) {
+    for (unsigned bits = TTAK_LIMBS_FFT_MAX_BITS; bits >= 8; bits--) {
+        size_t da = (an * TTAK_LIMB_BITS + bits - 1) / bits;
+        size_t db = (bn * TTAK_LIMB_BITS + bits - 1) / bits;
+        size_t n = ttak_next_power_of_two(da + db - 1);
+        if (n > ((size_t)1 << TTAK_FFT_MAX_LOG)) return 0;
+        unsigned lg = 0;
+        while (((size_t)1 << lg) < n) lg++;
+        double norm = (double)(da + db + 6) * ldexp(1.0, 2 * (int)bits - 2);
+        double bound = ldexp(norm, -53) * (6.0 * lg + 2.2360679775 * (3.0 * lg + 1)) / 2;
+        if (bound < 0.4) {
+            if (len_out) *len_out = n;
+            return bits;
+        }
+    }
+    return 0;
+}
+
+static bool fft_fits(size_t an, size_t bn) {
+    return fft_digit_bits(an, bn, NULL) != 0;
+}
+
+/* The NTT prime set mul_ntt() uses on this host: the 50-bit pair needs the IFMA kernel. */
+static bool ntt_use_pair(void) {
+    return ttak_ntt_kernel_for(&ttak_ntt_primes50[0]) == TTAK_NTT_KERNEL_IFMA;
+}
+
+/* 0 until first asked, then 1 for the scalar NTT kernels and 2 for vector ones. */
+static _Atomic int ntt_vector_cache = 0;
+
+static bool ntt_vector(void) {
+    int v = atomic_load_explicit(&ntt_vector_cache, memory_order_relaxed);
+    if (!v) {
+        /* Idempotent, so a racing first call just repeats it. */
+        bool vector = ntt_use_pair() || ttak_ntt_kernel_for(&ttak_ntt_primes[0]) != TTAK_NTT_KERNEL_SCALAR;
+        v = vector ? 2 : 1;
+        atomic_store_explicit(&ntt_vector_cache, v, memory_order_relaxed);
+    }
+    return v == 2;
+}
+
+static mul_tier_t mul_pick(size_t an, size_t bn) {
+    if (bn < TTAK_LIMBS_KARATSUBA_THRESHOLD) return MUL_TIER_BASECASE;
+    /* The vector NTT kernels beat the FFT at every size; the scalar one only where the FFT cannot go. */
+    if (ntt_vector() && bn >= TTAK_LIMBS_NTT_VECTOR_THRESHOLD && ntt_fits(an, bn)) return MUL_TIER_NTT;
+    if (bn >= TTAK_LIMBS_FFT_THRESHOLD && fft_fits(an, bn)) return MUL_TIER_FFT;
+    if (bn >= TTAK_LIMBS_NTT_THRESHOLD && ntt_fits(an, bn)) return MUL_TIER_NTT;
+    if (bn >= TTAK_LIMBS_TOOM3_THRESHOLD && toom3_fits(an, bn)) return MUL_TIER_TOOM3;
+    if (karatsuba_fits(an, bn)) return MUL_TIER_KARATSUBA;
+    return MUL_TIER_CHUNKED;
+}
+
+static size_t mul_itch(size_t an, size_t bn);
+
+static size_t max_size(size_t a, size_t b) {
+    return a > b ? a : b;
+}
+
+/* Workspace limbs used by a product of the given tier, children included. */
+static size_t tier_itch(mul_tier_t tier, size_t an, size_t bn) {
+    switch (tier) {
+        case MUL_TIER_CHUNKED: {
+            size_t last = an % bn;
+            size_t child = mul_itch(bn, bn);
+            if (last) child = max_size(child, mul_itch(bn, last));
+            return 2 * bn + child;
+        }
+        case MUL_TIER_KARATSUBA: {
+            size_t h = (an + 1) / 2;
+            return 6 * h + 1 + max_size(mul_itch(h, h), mul_itch(an - h, bn - h));
+        }
+        case MUL_TIER_TOOM3: {
+            size_t k = (an + 2) / 3;
+            size_t child = max_size(mul_itch(k + 1, k + 1), mul_itch(k, k));
+            child = max_size(child, mul_itch(an - 2 * k, bn - 2 * k));
+            return 6 * (k + 1) + 3 * (2 * k + 2) + child;
+        }
+        case MUL_TIER_BASECASE:
+        case MUL_TIER_FFT:
+        case MUL_TIER_NTT:
+        default:
+            return 0;
+    }
+}
+
+static size_t mul_itch(size_t an, size_t bn) {
+    return tier_itch(mul_pick(an, bn), an, bn);
+}
+
+void ttak_limbs_mul_basecase(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn) {
+    /* Each row walks the longer operand so the kernels run long loops. */
+    if (an < bn) {
+        const limb_t *tp = ap; ap = bp; bp = tp;
+        size_t tn = an; an = bn; bn = tn;
+    }
+    rp[an] = ttak_limbs_mul_1(rp, ap, an, bp[0]);
+    for (size_t i = 1; i < bn; ++i) {
+        rp[an + i] = ttak_limbs_addmul_1(rp + i, ap, an, bp[i]);
+    }
+}
+
+/* Unbalanced operands: multiply bn-limb slices of a by b and accumulate. */
+static bool mul_chunked(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                        limb_t *ws, uint64_t now) {
+    limb_t *next = ws + 2 * bn;
+    if (!mul_rec(rp, ap, bn, bp, bn, next, now)) return false;
+    for (size_t off = bn; off < an; off += bn) {
+        size_t len = an - off < bn ? an - off : bn;
+        if (!mul_rec(ws, bp, bn, ap + off, len, next, now)) return false;
+        limb_t cy = ttak_limbs_add_n(rp + off, rp + off, ws, bn);
+        memcpy(rp + off + bn, ws + bn, len * sizeof(limb_t));
+        add_1(rp + off + bn, len, cy);
+    }
+    return true;
+}
+
+/*
+ * a = a1 B^h + a0, b = b1 B^h + b0 and
+ * a0 b1 + a1 b0 = a0 b0 + a1 b1 + (a0 - a1)(b1 - b0).
+ */
+static bool mul_karatsuba(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                          limb_t *ws, uint64_t now) {
+    size_t h = (an + 1) / 2;
+    size_t a1n = an - h;
+    size_t b1n = bn - h;
+    size_t rn = an + bn;
+    limb_t *da = ws;
+    limb_t *db = da + h;
+    limb_t *prod = db + h;
+    limb_t *t = prod + 2 * h;
+    limb_t *next = t + 2 * h + 1;
+
+    bool neg = abs_diff(da, ap, h, ap + h, a1n) == abs_diff(db, bp, h, bp + h, b1n);
+    if (!mul_rec(prod, da, h, db, h, next, now)) return false;
+    if (!mul_rec(rp, ap, h, bp, h, next, now)) return false;
+    if (!mul_rec(rp + 2 * h, ap + h, a1n, bp + h, b1n, next, now)) return false;
+
+    memcpy(t, rp, 2 * h * sizeof(limb_t));
+    t[2 * h] = 0;
+    add_into(t, 2 * h + 1, rp + 2 * h, rn - 2 * h);
+    if (neg) {
+        sub_into(t, 2 * h + 1, prod, 2 * h);
+    } else {
+        add_into(t, 2 * h + 1, prod, 2 * h);
+    }
+    size_t tn = rn - h < 2 * h + 1 ? rn - h : 2 * h + 1;
+    add_into(rp + h, rn - h, t, tn);
+    return true;
+}
+
+/*
+ * Evaluates x0 + x1 y + x2 y^2 at y = 1, -1 and 2 into k + 1 limbs each.
+ * Returns true when the value at -1 is negative.
+ */
+static bool toom3_eval(limb_t *p1, limb_t *pm1, limb_t *p2, const limb_t *xp, size_t k, size_t x2n) {
+    memcpy(p1, xp, k * sizeof(limb_t));
+    p1[k] = 0;
+    add_into(p1, k + 1, xp + 2 * k, x2n);
+    bool neg = abs_diff(pm1, p1, k + 1, xp + k, k);
+    add_into(p1, k + 1, xp + k, k);
+    memcpy(p2, p1, (k + 1) * sizeof(limb_t));
+    add_into(p2, k + 1, xp + k, k);
+    limb_t cy = ttak_limbs_addmul_1(p2, xp + 2 * k, x2n, 3);
+    add_1(p2 + x2n, k + 1 - x2n, cy);
+    return neg;
+}
+
+/*
+ * Evaluates at 0, 1, -1, 2 and infinity, then interpolates the five
+ * coefficients in L = 2k + 2 limbs, which holds every intermediate.
+ */
+static bool mul_toom3(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                      limb_t *ws, uint64_t now) {
+    size_t k = (an + 2) / 3;
+    size_t a2n = an - 2 * k;
+    size_t b2n = bn - 2 * k;
+    size_t rn = an + bn;
+    size_t len = 2 * k + 2;
+    limb_t *p1 = ws;
+    limb_t *pm1 = p1 + (k + 1);
+    limb_t *p2 = pm1 + (k + 1);
+    limb_t *q1 = p2 + (k + 1);
+    limb_t *qm1 = q1 + (k + 1);
+    limb_t *q2 = qm1 + (k + 1);
+    limb_t *r1 = q2 + (k + 1);
+    limb_t *rm1 = r1 + len;
+    limb_t *r2 = rm1 + len;
+    limb_t *next = r2 + len;
+    const limb_t *rinf = rp + 4 * k;
+
+    bool neg = toom3_eval(p1, pm1, p2, ap, k, a2n) != toom3_eval(q1, qm1, q2, bp, k, b2n);
+    if (!mul_rec(r1, p1, k + 1, q1, k + 1, next, now)) return false;
+    if (!mul_rec(rm1, pm1, k + 1, qm1, k + 1, next, now)) return false;
+    if (!mul_rec(r2, p2, k + 1, q2, k + 1, next, now)) return false;
+    if (!mul_rec(rp, ap, k, bp, k, next, now)) return false;
+    if (!mul_rec(rp + 4 * k, ap + 2 * k, a2n, bp + 2 * k, b2n, next, now)) return false;
+    memset(rp + 2 * k, 0, 2 * k * sizeof(limb_t));
+    if (neg) negate(rm1, len);
+
+    ttak_limbs_sub_n(r2, r2, rm1, len);
+    divexact_3(r2, len);                              /* c1 + c2 + 3c3 + 5c4 */
+    ttak_limbs_sub_n(r1, r1, rm1, len);
+    rshift_1(r1, len);                                /* c1 + c3 */
+    sub_into(rm1, len, rp, 2 * k);                    /* c2 - c1 - c3 + c4 */
+    ttak_limbs_sub_n(r2, r2, rm1, len);
+    rshift_1(r2, len);
+    sub_into(r2, len, rinf, a2n + b2n);
+    sub_into(r2, len, rinf, a2n + b2n);               /* c1 + 2c3 */
+    ttak_limbs_add_n(rm1, rm1, r1, len);
+    sub_into(rm1, len, rinf, a2n + b2n);              /* c2 */
+    ttak_limbs_sub_n(r2, r2, r1, len);                /* c3 */
+    ttak_limbs_sub_n(r1, r1, r2, len);                /* c1 */
+
+    /* Every coefficient is non-negative, so limbs past the product are 0. */
+    const limb_t *coef[3] = { r1, rm1, r2 };
+    for (size_t i = 0; i < 3; i++) {
+        size_t off = (i + 1) * k;
+        add_into(rp + off, rn - off, coef[i], rn - off < len ? rn - off : len);
+    }
+    return true;
+}
+
+/* x mod m for x < 2m. */
+static uint64_t reduce_once(uint64_t x, uint64_t m) {
+    return x >= m ? x - m : x;
+}
+
+static uint32_t limb_digit(const limb_t *xp, size_t i) {
+    return (uint32_t)(xp[i / TTAK_LIMB_DIGITS] >> (32 * (i % TTAK_LIMB_DIGITS)));
+}
+
+/* The first @p digits 32-bit digits of xp, zero-padded to @p n. */
+static void ntt_load(uint64_t *dst, const limb_t *xp, size_t digits, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = i < digits ? limb_digit(xp, i) : 0;
+}
+
+/* Index space of ntt_plans: the 30-bit primes first, then the 50-bit ones. */
+#define NTT_PRIME_SLOTS (TTAK_NTT_PRIME_COUNT + TTAK_NTT_PRIME50_COUNT)
+
+static const ttak_ntt_prime_t *ntt_prime(size_t slot) {
+    return slot < TTAK_NTT_PRIME_COUNT ? &ttak_ntt_primes[slot] : &ttak_ntt_primes50[slot - TTAK_NTT_PRIME_COUNT];
+}
+
+/* Plans are built on first use and kept for the life of the process. */
+static _Atomic(ttak_ntt_plan_t *) ntt_plans[NTT_PRIME_SLOTS][TTAK_LIMBS_NTT_MAX_LOG + 1];
+
+static const ttak_ntt_plan_t *ntt_plan_get(size_t prime, size_t n, uint64_t now) {
+    unsigned lg = 0;
+    while (((size_t)1 << lg) < n) lg++;
+    ttak_ntt_plan_t *plan = atomic_load_explicit(&ntt_plans[prime][lg], memory_order_acquire);
+    if (plan) return plan;
+    plan = ttak_mem_alloc_lite(sizeof(*plan), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    if (!plan) return NULL;
+    if (!ttak_ntt_plan_init(plan, ntt_prime(prime), n)) {
+        ttak_ntt_plan_destroy(plan);
+        ttak_mem_free_lite(plan);
+        return NULL;
+    }
+    ttak_ntt_plan_t *seen = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&ntt_plans[prime][lg], &seen, plan,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        ttak_ntt_plan_destroy(plan);
+        ttak_mem_free_lite(plan);
+        return seen;
+    }
+    return plan;
+}
+
+/*
+ * Convolution of 32-bit digits modulo each prime; a coefficient is below
+ * 2^21 * 2^64, inside both the ~2^88 product of the 30-bit primes and the
+ * ~2^100 product of the 50-bit pair. The pair needs one transform fewer,
+ * which wins wherever IFMA makes 50-bit butterflies as cheap as 30-bit ones.
+ */
+static bool mul_ntt(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                    ttak_thread_pool_t *pool, uint64_t now) {
+    size_t da = an * TTAK_LIMB_DIGITS;
+    size_t db = bn * TTAK_LIMB_DIGITS;
+    size_t coeffs = da + db - 1;
+    size_t n = ttak_next_power_of_two(coeffs);
+    bool square = ap == bp && an == bn;
+    bool pair = ntt_use_pair();
+    size_t first = pair ? TTAK_NTT_PRIME_COUNT : 0;
+    size_t count = pair ? TTAK_NTT_PRIME50_COUNT : TTAK_NTT_PRIME_COUNT;
+    const ttak_ntt_plan_t *plans[TTAK_NTT_PRIME_COUNT];
+    for (size_t p = 0; p < count; p++) {
+        plans[p] = ntt_plan_get(first + p, n, now);
+        if (!plans[p]) return false;
+    }
+    /* With a pool every prime gets its own copy of bp so the primes run together. */
+    size_t copies = square ? 0 : pool ? count : 1;
+    uint64_t *buf = ttak_mem_alloc_lite((count + copies) * n * sizeof(uint64_t), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    if (!buf) return false;
+    uint64_t *res[TTAK_NTT_PRIME_COUNT];
+    uint64_t *rhs[TTAK_NTT_PRIME_COUNT];
+    for (size_t p = 0; p < count; p++) {
+        res[p] = buf + p * n;
+        rhs[p] = square ? res[p] : buf + (count + (pool ? p : 0)) * n;
+    }
+
+    /* The forward spectra are bit-reversed, which pointwise work ignores. */
+    for (size_t p = 0; p < count; p++) ntt_load(res[p], ap, da, n);
+    if (pool) {
+        for (size_t p = 0; p < count && !square; p++) ntt_load(rhs[p], bp, db, n);
+        ttak_ntt_plan_convolve(plans, res, rhs, count, pool, now);
+    } else {
+        for (size_t p = 0; p < count; p++) {
+            if (!square) ntt_load(rhs[p], bp, db, n);
+            ttak_ntt_plan_convolve(&plans[p], &res[p], &rhs[p], 1, NULL, now);
+        }
+    }
+
+    memset(rp, 0, (an + bn) * sizeof(limb_t));
+    ttak_u128_t acc = ttak_u128_zero();
+    if (pair) {
+        /* Garner: x = r0 + m0 k1 with r0 < m0 < m1. */
+        const uint64_t m0 = ttak_ntt_primes50[0].modulus;
+        const uint64_t m1 = ttak_ntt_primes50[1].modulus;
+        const uint64_t inv01 = ttak_mod_inverse(m0, m1);
+        for (size_t i = 0; i < da + db; i++) {
+            if (i < coeffs) {
+                uint64_t r0 = res[0][i];
+                uint64_t k1 = ttak_mod_mul(ttak_mod_sub(res[1][i], r0, m1), inv01, m1);
+                acc = ttak_u128_add(acc, ttak_u128_add64(ttak_u128_mul64(m0, k1), r0));
+            }
+            rp[i / TTAK_LIMB_DIGITS] |= (limb_t)(acc.lo & 0xFFFFFFFFULL) << (32 * (i % TTAK_LIMB_DIGITS));
+            acc = ttak_u128_shr(acc, 32);
+        }
+        ttak_mem_free_lite(buf);
+        return true;
+    }
+
+    /* Garner: x = r0 + m0 k1 + m0 m1 k2; the moduli are below 2^30 and r0 < 2 m1. */
+    const uint64_t m0 = ttak_ntt_primes[0].modulus;
+    const uint64_t m1 = ttak_ntt_primes[1].modulus;
+    const uint64_t m2 = ttak_ntt_primes[2].modulus;
+    const uint64_t m01 = m0 * m1;
+    const uint64_t inv01 = ttak_mod_inverse(m0 % m1, m1);
+    const uint64_t inv012 = ttak_mod_inverse(m01 % m2, m2);
+
+    for (size_t i = 0; i < da + db; i++) {
+        if (i < coeffs) {
+            uint64_t r0 = res[0][i];
+            uint64_t k1 = reduce_once(res[1][i] + m1 - reduce_once(r0, m1), m1) * inv01 % m1;
+            uint64_t x01 = r0 + m0 * k1;
+            uint64_t k2 = reduce_once(res[2][i] + m2 - x01 % m2, m2) * inv012 % m2;
+            acc = ttak_u128_add(acc, ttak_u128_add64(ttak_u128_mul64(m01, k2), x01));
+        }
+        rp[i / TTAK_LIMB_DIGITS] |= (limb_t)(acc.lo & 0xFFFFFFFFULL) << (32 * (i % TTAK_LIMB_DIGITS));
+        acc = ttak_u128_shr(acc, 32);
+    }
+    ttak_mem_free_lite(buf);
+    return true;
+}
+
+/*
+ * Bits [k bits, (k + 1) bits) of xp as balanced digits: one at or above
+ * 2^(bits - 1) becomes negative and carries into the next, except the top
+ * one, which absorbs the last carry. Zero-padded to @p n. Random operands
+ * make the carry a coin flip, so the loop has no branches on the data.
+ */
+static void fft_load(double *dst, const limb_t *xp, size_t xn, unsigned bits, size_t digits, size_t n) {
+    const limb_t mask = ((limb_t)1 << bits) - 1;
+    const int64_t half = (int64_t)1 << (bits - 1);
+    int64_t carry = 0;
+    for (size_t k = 0; k < digits; k++) {
+        size_t pos = k * bits;
+        size_t i = pos / TTAK_LIMB_BITS;
+        unsigned sh = (unsigned)(pos % TTAK_LIMB_BITS);
+        limb_t next = i + 1 < xn ? xp[i + 1] : 0;
+        limb_t raw = (xp[i] >> sh) | ((next << 1) << (TTAK_LIMB_BITS - 1 - sh));
+        int64_t d = (int64_t)(raw & mask) + carry;
+        carry = (d + half) >> bits;
+        dst[k] = (double)(d - carry * 2 * half);
+    }
+    dst[digits - 1] += (double)(carry * 2 * half);
+    memset(dst + digits, 0, (n - digits) * sizeof(double));
+}
+
+static bool mul_fft(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn, uint64_t now) {
+    size_t n = 0;
+    unsigned bits = fft_digit_bits(an, bn, &n);
+    if (!bits) return false;
+    const ttak_fft_plan_t *plan = ttak_fft_plan_get(n, now);
+    if (!plan) return false;
+    /* A power-of-two gap would put re[i] and im[i] in the same cache set. */
+    const size_t gap = 64;
+    double *re = ttak_mem_alloc_lite((2 * n + gap) * sizeof(double), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    if (!re) return false;
+    double *im = re + n + gap;
+    size_t da = (an * TTAK_LIMB_BITS + bits - 1) / bits;
+    size_t db = (bn * TTAK_LIMB_BITS + bits - 1) / bits;
+    fft_load(re, ap, an, bits, da, n);
+    fft_load(im, bp, bn, bits, db, n);
+    ttak_fft_plan_forward(plan, re, im);
+    ttak_fft_plan_pointwise_mul(plan, re, im, re, im, re, im, 0.5);
+    ttak_fft_plan_inverse(plan, re, im);
+
+    /* Adding and removing 1.5 * 2^52 rounds to the nearest integer; coefficients stay below 2^51. */
+    const double magic = 0x1.8p52;
+    const int64_t mask = ((int64_t)1 << bits) - 1;
+    const size_t rn = an + bn;
+    int64_t carry = 0;
+    ttak_dlimb_t window = 0;
+    unsigned held = 0;
+    for (size_t k = 0, out = 0; out < rn; k++) {
+        if (k < da + db - 1) carry += (int64_t)((im[k] + magic) - magic);
+        int64_t digit = carry & mask;
+        window |= (ttak_dlimb_t)digit << held;
+        carry = (carry - digit) / (mask + 1);
+        held += bits;
+        if (held >= TTAK_LIMB_BITS) {
+            rp[out++] = (limb_t)window;
+            window >>= TTAK_LIMB_BITS;
+            held -= TTAK_LIMB_BITS;
+        }
+    }
+    ttak_mem_free_lite(re);
+    return true;
+}
+
+static bool mul_tier(mul_tier_t tier, limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp,
+                     size_t bn, limb_t *ws, uint64_t now) {
+    switch (tier) {
+        case MUL_TIER_CHUNKED:
+            return mul_chunked(rp, ap, an, bp, bn, ws, now);
+        case MUL_TIER_KARATSUBA:
+            return mul_karatsuba(rp, ap, an, bp, bn, ws, now);
+        case MUL_TIER_TOOM3:
+            return mul_toom3(rp, ap, an, bp, bn, ws, now);
+        case MUL_TIER_FFT:
+            return mul_fft(rp, ap, an, bp, bn, now);
+        case MUL_TIER_NTT:
+            return mul_ntt(rp, ap, an, bp, bn, NULL, now);
+        case MUL_TIER_BASECASE:
+        default:
+            ttak_limbs_mul_basecase(rp, ap, an, bp, bn);
+            return true;
+    }
+}
+
+/* Requires an >= bn >= 1. */
+static bool mul_rec(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                    limb_t *ws, uint64_t now) {
+    return mul_tier(mul_pick(an, bn), rp, ap, an, bp, bn, ws, now);
+}
+
+static mul_tier_t mul_forced(ttak_limbs_mul_algo_t algo, size_t an, size_t bn) {
+    switch (algo) {
+        case TTAK_LIMBS_MUL_BASECASE:
+            return MUL_TIER_BASECASE;
+        case TTAK_LIMBS_MUL_KARATSUBA:
+            return karatsuba_fits(an, bn) ? MUL_TIER_KARATSUBA : mul_pick(an, bn);
+        case TTAK_LIMBS_MUL_TOOM3:
+            return toom3_fits(an, bn) ? MUL_TIER_TOOM3 : mul_pick(an, bn);
+        case TTAK_LIMBS_MUL_NTT:
+            return ntt_fits(an, bn) ? MUL_TIER_NTT : mul_pick(an, bn);
+        case TTAK_LIMBS_MUL_FFT:
+            return fft_fits(an, bn) ? MUL_TIER_FFT : mul_pick(an, bn);
+        case TTAK_LIMBS_MUL_AUTO:
+        default:
+            return mul_pick(an, bn);
+    }
+}
+
+bool ttak_limbs_mul_algo(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                         ttak_limbs_mul_algo_t algo, uint64_t now) {
+    if (an < bn) {
+        const limb_t *tp = ap; ap = bp; bp = tp;
+        size_t tn = an; an = bn; bn = tn;
+    }
+    if (bn == 0) {
+        memset(rp, 0, an * sizeof(limb_t));
+        return true;
+    }
+    mul_tier_t tier = mul_forced(algo, an, bn);
+    size_t itch = tier_itch(tier, an, bn);
+    limb_t *ws = NULL;
+    if (itch) {
+        ws = ttak_mem_alloc_lite(itch * sizeof(limb_t), __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+        if (!ws) return false;
+    }
+    bool ok = mul_tier(tier, rp, ap, an, bp, bn, ws, now);
+    if (ws) ttak_mem_free_lite(ws);
+    return ok;
+}
+
+bool ttak_limbs_mul(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn, uint64_t now) {
+    return ttak_limbs_mul_algo(rp, ap, an, bp, bn, TTAK_LIMBS_MUL_AUTO, now);
+}
+
+bool ttak_limbs_mul_parallel(limb_t *rp, const limb_t *ap, size_t an, const limb_t *bp, size_t bn,
+                             ttak_thread_pool_t *pool, uint64_t now) {
+    if (an < bn) {
+        const limb_t *tp = ap; ap = bp; bp = tp;
+        size_t tn = an; an = bn; bn = tn;
+    }
+    if (!pool || bn < TTAK_LIMBS_NTT_PARALLEL_THRESHOLD || !ntt_fits(an, bn)) {
+        return ttak_limbs_mul(rp, ap, an, bp, bn, now);
+    }
+    return mul_ntt(rp, ap, an, bp, bn, pool, now);
+}
@@ -0,0 +1,296 @@
+#include <ttak/math/mat4.h>
+#include <ttak/arch/ttak_arch.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(TTAK_HAS_AVX2)
+#  include <immintrin.h>
+#elif defined(TTAK_HAS_SSE2)
+#  include <emmintrin.h>
+#elif defined(TTAK_HAS_NEON)
+#  include <arm_neon.h>
+#endif
+
+/*
+ * Every product here reduces to one kernel: out = c0 r0 + c1 r1 + c2 r2 + c3 r3
+ * for four row vectors r. A multiply a b takes the rows of b with the
+ * entries of each row of a as coefficients. A transform m v takes the rows
+ * of m^T, the columns of m, with the entries of v as coefficients, so a
+ * batch pays for the transpose once and then needs only broadcasts.
+ * The sum is paired the same way on every path so results match bit for
+ * bit across them.
+ */
+
+#if defined(TTAK_HAS_SSE2)
+typedef __m128 mat4f_row_t;
+#  define MAT4F_LOAD(p)     _mm_load_ps(p)
+#  define MAT4F_STORE(p, r) _mm_store_ps((p), (r))
+static inline __m128 mat4f_comb(const float *c, __m128 r0, __m128 r1, __m128 r2, __m128 r3) {
+    __m128 lo = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(c[0]), r0), _mm_mul_ps(_mm_set1_ps(c[1]), r1));
+    __m128 hi = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(c[2]), r2), _mm_mul_ps(_mm_set1_ps(c[3]), r3));
+    return _mm_add_ps(lo, hi);
+}
+#elif defined(TTAK_HAS_NEON)
+typedef float32x4_t mat4f_row_t;
+#  define MAT4F_LOAD(p)     vld1q_f32(p)
+#  define MAT4F_STORE(p, r) vst1q_f32((p), (r))
+static inline float32x4_t mat4f_comb(const float *c, float32x4_t r0, float32x4_t r1, float32x4_t r2, float32x4_t r3) {
+    float32x4_t lo = vaddq_f32(vmulq_n_f32(r0, c[0]), vmulq_n_f32(r1, c[1]));
+    float32x4_t hi = vaddq_f32(vmulq_n_f32(r2, c[2]), vmulq_n_f32(r3, c[3]));
+    return vaddq_f32(lo, hi);
+}
+#else
+typedef struct { float v[4]; } mat4f_row_t;
+static inline mat4f_row_t mat4f_load(const float *p) {
+    mat4f_row_t r;
+    memcpy(r.v, p, sizeof(r.v));
+    return r;
+}
+#  define MAT4F_LOAD(p)     mat4f_load(p)
+#  define MAT4F_STORE(p, r) memcpy((p), (r).v, sizeof((r).v))
+static inline mat4f_row_t mat4f_comb(const float *c, mat4f_row_t r0, mat4f_row_t r1, mat4f_row_t r2, mat4f_row_t r3) {
+    mat4f_row_t out;
+    for (int i = 0; i < 4; i++) {
+        out.v[i] = (c[0] * r0.v[i] + c[1] * r1.v[i]) + (c[2] * r2.v[i] + c[3] * r3.v[i]);
+    }
+    return out;
+}
+#endif
+
+#if defined(TTAK_HAS_AVX2)
+typedef __m256d mat4d_row_t;
+#  define MAT4D_LOAD(p)     _mm256_load_pd(p)
+#  define MAT4D_STORE(p, r) _mm256_store_pd((p), (r))
+static inline __m256d mat4d_comb(const double *c, __m256d r0, __m256d r1, __m256d r2, __m256d r3) {
+    __m256d lo = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(c[0]), r0), _mm256_mul_pd(_mm256_set1_pd(c[1]), r1));
+    __m256d hi = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(c[2]), r2), _mm256_mul_pd(_mm256_set1_pd(c[3]), r3));
+    return _mm256_add_pd(lo, hi);
+}
+#elif defined(TTAK_HAS_SSE2)
+typedef struct { __m128d lo, hi; } mat4d_row_t;
+static inline mat4d_row_t mat4d_load(const double *p) {
+    mat4d_row_t r = { _mm_load_pd(p), _mm_load_pd(p + 2) };
+    return r;
+}
+static inline void mat4d_store(double *p, mat4d_row_t r) {
+    _mm_store_pd(p, r.lo);
+    _mm_store_pd(p + 2, r.hi);
+}
+#  define MAT4D_LOAD(p)     mat4d_load(p)
+#  define MAT4D_STORE(p, r) mat4d_store((p), (r))
+static inline __m128d mat4d_comb_half(const double *c, __m128d r0, __m128d r1, __m128d r2, __m128d r3) {
+    __m128d lo = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(c[0]), r0), _mm_mul_pd(_mm_set1_pd(c[1]), r1));
+    __m128d hi = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(c[2]), r2), _mm_mul_pd(_mm_set1_pd(c[3]), r3));
+    return _mm_add_pd(lo, hi);
+}
+static inline mat4d_row_t mat4d_comb(const double *c, mat4d_row_t r0, mat4d_row_t r1, mat4d_row_t r2, mat4d_row_t r3) {
+    mat4d_row_t out = {
+        mat4d_comb_half(c, r0.lo, r1.lo, r2.lo, r3.lo),
+        mat4d_comb_half(c, r0.hi, r1.hi, r2.hi, r3.hi),
+    };
+    return out;
+}
+#elif defined(TTAK_HAS_NEON) && defined(__aarch64__)
+typedef struct { float64x2_t lo, hi; } mat4d_row_t;
+static inline mat4d_row_t mat4d_load(const double *p) {
+    mat4d_row_t r = { vld1q_f64(p), vld1q_f64(p + 2) };
+    return r;
+}
+static inline void mat4d_store(double *p, mat4d_row_t r) {
+    vst1q_f64(p, r.lo);
+    vst1q_f64(p + 2, r.hi);
+}
+#  define MAT4D_LOAD(p)     mat4d_load(p)
+#  define MAT4D_STORE(p, r) mat4d_store((p), (r))
+static inline float64x2_t mat4d_comb_half(const double *c, float64x2_t r0, float64x2_t r1, float64x2_t r2, float64x2_t r3) {
+    float64x2_t lo = vaddq_f64(vmulq_n_f64(r0, c[0]), vmulq_n_f64(r1, c[1]));
+    float64x2_t hi = vaddq_f64(vmulq_n_f64(r2, c[2]), vmulq_n_f64(r3, c[3]));
+    return vaddq_f64(lo, hi);
+}
+static inline mat4d_row_t mat4d_comb(const double *c, mat4d_row_t r0, mat4d_row_t r1, mat4d_row_t r2, mat4d_row_t r3) {
+    mat4d_row_t out = {
+        mat4d_comb_half(c, r0.lo, r1.lo, r2.lo, r3.lo),
+        mat4d_comb_half(c, r0.hi, r1.hi, r2.hi, r3.hi),
+    };
+    return out;
+}
+#else
+typedef struct { double v[4]; } mat4d_row_t;
+static inline mat4d_row_t mat4d_load(const double *p) {
+    mat4d_row_t r;
+    memcpy(r.v, p, sizeof(r.v));
+    return r;
+}
+#  define MAT4D_LOAD(p)     mat4d_load(p)
+#  define MAT4D_STORE(p, r) memcpy((p), (r).v, sizeof((r).v))
+static inline mat4d_row_t mat4d_comb(const double *c, mat4d_row_t r0, mat4d_row_t r1, mat4d_row_t r2, mat4d_row_t r3) {
+    mat4d_row_t out;
+    for (int i = 0; i < 4; i++) {
+        out.v[i] = (c[0] * r0.v[i] + c[1] * r1.v[i]) + (c[2] * r2.v[i] + c[3] * r3.v[i]);
+    }
+    return out;
+}
+#endif
+
+void ttak_mat4f_identity(ttak_mat4f_t *m) {
+    memset(m->m, 0, sizeof(m->m));
+    m->m[0] = m->m[5] = m->m[10] = m->m[15] = 1.0f;
+}
+
+void ttak_mat4f_mul(ttak_mat4f_t *res, const ttak_mat4f_t *a, const ttak_mat4f_t *b) {
+    mat4f_row_t b0 = MAT4F_LOAD(&b->m[0]);
+    mat4f_row_t b1 = MAT4F_LOAD(&b->m[4]);
+    mat4f_row_t b2 = MAT4F_LOAD(&b->m[8]);
+    mat4f_row_t b3 = MAT4F_LOAD(&b->m[12]);
+    /* All four rows are formed before any store so res may alias a. */
+    mat4f_row_t r0 = mat4f_comb(&a->m[0], b0, b1, b2, b3);
+    mat4f_row_t r1 = mat4f_comb(&a->m[4], b0, b1, b2, b3);
+    mat4f_row_t r2 = mat4f_comb(&a->m[8], b0, b1, b2, b3);
+    mat4f_row_t r3 = mat4f_comb(&a->m[12], b0, b1, b2, b3);
+    MAT4F_STORE(&res->m[0], r0);
+    MAT4F_STORE(&res->m[4], r1);
+    MAT4F_STORE(&res->m[8], r2);
+    MAT4F_STORE(&res->m[12], r3);
+}
+
+void ttak_mat4f_transpose(ttak_mat4f_t *res, const ttak_mat4f_t *m) {
+#if defined(TTAK_HAS_SSE2)
+    __m128 r0 = _mm_load_ps(&m->m[0]);
+    __m128 r1 = _mm_load_ps(&m->m[4]);
+    __m128 r2 = _mm_load_ps(&m->m[8]);
+    __m128 r3 = _mm_load_ps(&m->m[12]);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_store_ps(&res->m[0], r0);
+    _mm_store_ps(&res->m[4], r1);
+    _mm_store_ps(&res->m[8], r2);
+    _mm_store_ps(&res->m[12], r3);
+#else
+    ttak_mat4f_t t;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) t.m[j * 4 + i] = m->m[i * 4 + j];
+    }
+    *res = t;
+#endif
+}
+
+void ttak_mat4f_transform(const ttak_mat4f_t *m, const ttak_vec4f_t *in, ttak_vec4f_t *out, size_t count) {
+    ttak_mat4f_t t;
+    ttak_mat4f_transpose(&t, m);
+    mat4f_row_t c0 = MAT4F_LOAD(&t.m[0]);
+    mat4f_row_t c1 = MAT4F_LOAD(&t.m[4]);
+    mat4f_row_t c2 = MAT4F_LOAD(&t.m[8]);
+    mat4f_row_t c3 = MAT4F_LOAD(&t.m[12]);
+    for (size_t i = 0; i < count; i++) {
+        mat4f_row_t r = mat4f_comb(in[i].v, c0, c1, c2, c3);
+        MAT4F_STORE(out[i].v, r);
+    }
+}
+
+void ttak_mat4f_mul_vec(ttak_vec4f_t *res, const ttak_mat4f_t *m, const ttak_vec4f_t *v) {
+    ttak_mat4f_transform(m, v, res, 1);
+}
+
+void ttak_mat4f_rotation(ttak_mat4f_t *m, uint8_t axis, float angle) {
+    float c = cosf(angle);
+    float s = sinf(angle);
+    ttak_mat4f_identity(m);
+    if (axis == 0) {
+        m->m[5] = c;  m->m[6] = -s;
+        m->m[9] = s;  m->m[10] = c;
+    } else if (axis == 1) {
+        m->m[0] = c;  m->m[2] = s;
+        m->m[8] = -s; m->m[10] = c;
+    } else {
+        m->m[0] = c;  m->m[1] = -s;
+        m->m[4] = s;  m->m[5] = c;
+    }
+}
+
+float ttak_vec4f_dot(const ttak_vec4f_t *a, const ttak_vec4f_t *b) {
+    return (a->v[0] * b->v[0] + a->v[1] * b->v[1]) + (a->v[2] * b->v[2] + a->v[3] * b->v[3]);
+}
+
+void ttak_vec4f_cross(ttak_vec4f_t *res, const ttak_vec4f_t *a, const ttak_vec4f_t *b) {
+    float x = a->v[1] * b->v[2] - a->v[2] * b->v[1];
+    float y = a->v[2] * b->v[0] - a->v[0] * b->v[2];
+    float z = a->v[0] * b->v[1] - a->v[1] * b->v[0];
+    res->v[0] = x;
+    res->v[1] = y;
+    res->v[2] = z;
+    res->v[3] = 0.0f;
+}
+
+void ttak_mat4d_identity(ttak_mat4d_t *m) {
+    memset(m->m, 0, sizeof(m->m));
+    m->m[0] = m->m[5] = m->m[10] = m->m[15] = 1.0;
+}
+
+void ttak_mat4d_mul(ttak_mat4d_t *res, const ttak_mat4d_t *a, const ttak_mat4d_t *b) {
+    mat4d_row_t b0 = MAT4D_LOAD(&b->m[0]);
+    mat4d_row_t b1 = MAT4D_LOAD(&b->m[4]);
+    mat4d_row_t b2 = MAT4D_LOAD(&b->m[8]);
+    mat4d_row_t b3 = MAT4D_LOAD(&b->m[12]);
+    mat4d_row_t r0 = mat4d_comb(&a->m[0], b0, b1, b2, b3);
+    mat4d_row_t r1 = mat4d_comb(&a->m[4], b0, b1, b2, b3);
+    mat4d_row_t r2 = mat4d_comb(&a->m[8], b0, b1, b2, b3);
+    mat4d_row_t r3 = mat4d_comb(&a->m[12], b0, b1, b2, b3);
+    MAT4D_STORE(&res->m[0], r0);
+    MAT4D_STORE(&res->m[4], r1);
+    MAT4D_STORE(&res->m[8], r2);
+    MAT4D_STORE(&res->m[12], r3);
+}
+
+void ttak_mat4d_transpose(ttak_mat4d_t *res, const ttak_mat4d_t *m) {
+    ttak_mat4d_t t;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) t.m[j * 4 + i] = m->m[i * 4 + j];
+    }
+    *res = t;
+}
+
+void ttak_mat4d_transform(const ttak_mat4d_t *m, const ttak_vec4d_t *in, ttak_vec4d_t *out, size_t count) {
+    ttak_mat4d_t t;
+    ttak_mat4d_transpose(&t, m);
+    mat4d_row_t c0 = MAT4D_LOAD(&t.m[0]);
+    mat4d_row_t c1 = MAT4D_LOAD(&t.m[4]);
+    mat4d_row_t c2 = MAT4D_LOAD(&t.m[8]);
+    mat4d_row_t c3 = MAT4D_LOAD(&t.m[12]);
+    for (size_t i = 0; i < count; i++) {
+        mat4d_row_t r = mat4d_comb(in[i].v, c0, c1, c2, c3);
+        MAT4D_STORE(out[i].v, r);
+    }
+}
+
+void ttak_mat4d_mul_vec(ttak_vec4d_t *res, const ttak_mat4d_t *m, const ttak_vec4d_t *v) {
+    ttak_mat4d_transform(m, v, res, 1);
+}
+
+void ttak_mat4d_rotation(ttak_mat4d_t *m, uint8_t axis, double angle) {
+    double c = cos(angle);
+    double s = sin(angle);
+    ttak_mat4d_identity(m);
+    if (axis == 0) {
+        m->m[5] = c;  m->m[6] = -s;
+        m->m[9] = s;  m->m[10] = c;
+    } else if (axis == 1) {
+        m->m[0] = c;  m->m[2] = s;
+        m->m[8] = -s; m->m[10] = c;
+    } else {
+        m->m[0] = c;  m->m[1] = -s;
+        m->m[4] = s;  m->m[5] = c;
+    }
+}
+
+double ttak_vec4d_dot(const ttak_vec4d_t *a, const ttak_vec4d_t *b) {
+    return (a->v[0] * b->v[0] + a->v[1] * b->v[1]) + (a->v[2] * b->v[2] + a->v[3] * b->v[3]);
+}
+
+void ttak_vec4d_cross(ttak_vec4d_t *res, const ttak_vec4d_t *a, const ttak_vec4d_t *b) {
+    double x = a->v[1] * b->v[2] - a->v[2] * b->v[1];
+    double y = a->v[2] * b->v[0] - a->v[0] * b->v[2];
+    double z = a->v[0] * b->v[1] - a->v[1] * b->v[0];
+    res->v[0] = x;
+    res->v[1] = y;
+    res->v[2] = z;
+    res->v[3] = 0.0;
+}
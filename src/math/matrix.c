@@ -99,6 +99,71 @@ _Bool ttak_matrix_set(tt_shared_matrix_t *sm, tt_owner_t *owner, uint8_t row, ui
     return ok;
 }
 
+_Bool ttak_matrix_set_all(tt_shared_matrix_t *sm, tt_owner_t *owner, const ttak_bigreal_t *vals, size_t count, uint64_t now) {
+    if (!sm || !owner || !vals) return false;
+
+    ttak_shared_result_t res;
+    ttak_matrix_t *m = (ttak_matrix_t *)sm->base.access(&sm->base, owner, &res);
+    if (!m) return false;
+
+    _Bool ok = count == (size_t)m->rows * m->cols;
+    for (size_t i = 0; ok && i < count; i++) {
+        ok = ttak_bigreal_copy(&m->elements[i], &vals[i], now);
+    }
+    sm->base.release(&sm->base);
+    return ok;
+}
+
+_Bool ttak_matrix_get_all(tt_shared_matrix_t *sm, tt_owner_t *owner, ttak_bigreal_t *out, size_t count, uint64_t now) {
+    if (!sm || !owner || !out) return false;
+
+    ttak_shared_result_t res;
+    ttak_matrix_t *m = (ttak_matrix_t *)sm->base.access(&sm->base, owner, &res);
+    if (!m) return false;
+
+    _Bool ok = count == (size_t)m->rows * m->cols;
+    for (size_t i = 0; ok && i < count; i++) {
+        ok = ttak_bigreal_copy(&out[i], &m->elements[i], now);
+    }
+    sm->base.release(&sm->base);
+    return ok;
+}
+
+_Bool ttak_matrix_export_f64(tt_shared_matrix_t *sm, tt_owner_t *owner, ttak_mat4d_t *out) {
+    if (!sm || !owner || !out) return false;
+
+    ttak_shared_result_t res;
+    ttak_matrix_t *m = (ttak_matrix_t *)sm->base.access(&sm->base, owner, &res);
+    if (!m) return false;
+
+    ttak_mat4d_identity(out);
+    _Bool ok = true;
+    for (uint8_t i = 0; i < m->rows; i++) {
+        for (uint8_t j = 0; j < m->cols; j++) {
+            ok &= ttak_bigreal_to_double(&m->elements[i * m->cols + j], &out->m[i * 4 + j]);
+        }
+    }
+    sm->base.release(&sm->base);
+    return ok;
+}
+
+_Bool ttak_matrix_import_f64(tt_shared_matrix_t *sm, tt_owner_t *owner, const ttak_mat4d_t *in, uint64_t now) {
+    if (!sm || !owner || !in) return false;
+
+    ttak_shared_result_t res;
+    ttak_matrix_t *m = (ttak_matrix_t *)sm->base.access(&sm->base, owner, &res);
+    if (!m) return false;
+
+    _Bool ok = true;
+    for (uint8_t i = 0; ok && i < m->rows; i++) {
+        for (uint8_t j = 0; ok && j < m->cols; j++) {
+            ok = ttak_bigreal_set_double(&m->elements[i * m->cols + j], in->m[i * 4 + j], now);
+        }
+    }
+    sm->base.release(&sm->base);
+    return ok;
+}
+
 _Bool ttak_matrix_multiply_vec(tt_shared_vector_t *res, tt_shared_matrix_t *m, tt_shared_vector_t *v, tt_owner_t *owner, uint64_t now) {
     ttak_shared_result_t rm, rv, rr;
     ttak_matrix_t *mat = (ttak_matrix_t *)m->base.access(&m->base, owner, &rm);
@@ -1,17 +1,24 @@
 #include <ttak/math/ntt.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/mem/mem.h>
+#include <ttak/thread/parallel.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 
-#define TTAK_NTT_MAX_LATTICE_DIM 32U
-
 const ttak_ntt_prime_t ttak_ntt_primes[TTAK_NTT_PRIME_COUNT] = {
     { 998244353ULL, 3ULL, 23U, 17450252288407896063ULL, 299560064ULL },
     { 1004535809ULL, 3ULL, 21U, 8214279848305098751ULL, 742115580ULL },
     { 469762049ULL, 3ULL, 26U, 18226067692438159359ULL, 118963808ULL }
 };
 
+const ttak_ntt_prime_t ttak_ntt_primes50[TTAK_NTT_PRIME50_COUNT] = {
+    { 1072023837081601ULL, 11ULL, 40U, 1072023837081599ULL, 385048140437572ULL },
+    { 1114355034750977ULL, 3ULL, 39U, 1114355034750975ULL, 567625728422287ULL }
+};
+
 /**
  * @brief Compute (a + b) mod mod without overflow.
  *
@@ -143,28 +150,6 @@ uint64_t ttak_montgomery_mul(uint64_t lhs, uint64_t rhs, const ttak_ntt_prime_t
     return ttak_montgomery_reduce(value, prime);
 }
 
-/**
- * @brief Choose lattice tile size for the current butterfly width.
- */
-static inline size_t ttak_ntt_lattice_dim(size_t len) {
-    if (len >= 64) return 32;
-    if (len >= 32) return 16;
-    if (len >= 16) return 8;
-    if (len >= 8)  return 4;
-    if (len >= 4)  return 2;
-    return 1;
-}
-
-static inline size_t ttak_ntt_lattice_shift(size_t dim) {
-#if defined(__GNUC__) || defined(__clang__)
-    return (size_t)__builtin_ctzll(dim);
-#else
-    size_t shift = 0;
-    while ((1ULL << shift) < dim) ++shift;
-    return shift;
-#endif
-}
-
 /**
  * @brief Convert a standard residue into Montgomery representation.
  *
@@ -201,107 +186,966 @@ static void bit_reverse(uint64_t *data, size_t n) {
     }
 }
 
+#define NTT_MASK52 ((1ULL << 52) - 1)
+
 /**
- * @brief Convert every element into Montgomery space.
+ * @brief Montgomery product with R = 2^32 for moduli below 2^31.
  *
- * @param data  Array of residues.
- * @param n     Number of elements.
- * @param prime Prime modulus descriptor.
+ * Both operands are below @p mod, so the product and the correction fit a
+ * single 64-bit word and the loop avoids 128-bit arithmetic entirely.
  */
-static void montgomery_array_convert(uint64_t *data, size_t n, const ttak_ntt_prime_t *prime) {
-    for (size_t i = 0; i < n; ++i) {
-        data[i] = ttak_montgomery_convert(data[i], prime);
-    }
+static inline uint64_t montgomery_mul_narrow(uint64_t a, uint64_t b, uint64_t mod, uint64_t inv) {
+    uint64_t t = a * b;
+    uint32_t m = (uint32_t)t * (uint32_t)inv;
+    uint64_t u = (t + (uint64_t)m * mod) >> 32;
+    return u - (mod & (0 - (uint64_t)(u >= mod)));
 }
 
 /**
- * @brief Convert every element from Montgomery space back to standard form.
+ * @brief Montgomery product with R = 2^52 for moduli below 2^50, the scalar
+ * twin of the IFMA lanes.
  *
- * @param data  Array of residues.
- * @param n     Number of elements.
- * @param prime Prime modulus descriptor.
+ * @p a may be any value below 2^52, which the first stage relies on.
  */
-static void montgomery_array_restore(uint64_t *data, size_t n, const ttak_ntt_prime_t *prime) {
-    for (size_t i = 0; i < n; ++i) {
-        ttak_u128_t value = ttak_u128_make(0, data[i]);
-        data[i] = ttak_montgomery_reduce(value, prime);
-    }
+static inline uint64_t montgomery_mul_52(uint64_t a, uint64_t b, uint64_t mod, uint64_t inv) {
+    ttak_u128_t t = ttak_u128_mul64(a, b);
+    uint64_t m = (t.lo * inv) & NTT_MASK52;
+    ttak_u128_t s = ttak_u128_add(t, ttak_u128_mul64(m, mod));
+    uint64_t u = (s.hi << 12) | (s.lo >> 52);
+    return u - (mod & (0 - (uint64_t)(u >= mod)));
+}
+
+/*
+ * Branch-free modular add and subtract: butterfly operands are effectively
+ * random, so conditional jumps here mispredict half the time.
+ */
+static inline uint64_t ntt_add(uint64_t a, uint64_t b, uint64_t mod) {
+    uint64_t sum = a + b;
+    return sum - (mod & (0 - (uint64_t)((sum >= mod) | (sum < a))));
+}
+
+static inline uint64_t ntt_sub(uint64_t a, uint64_t b, uint64_t mod) {
+    return a - b + (mod & (0 - (uint64_t)(a < b)));
 }
 
 /**
- * @brief Perform an in-place NTT or inverse NTT over the provided data.
+ * @brief Loop constants of one plan, held by value so stores to the data
+ * array cannot force them to be reloaded.
+ */
+typedef struct ntt_consts {
+    const ttak_ntt_prime_t *prime;
+    uint64_t mod;
+    uint64_t inv;
+} ntt_consts_t;
+
+static inline ntt_consts_t ntt_consts(const ttak_ntt_plan_t *plan) {
+    return (ntt_consts_t){ plan->prime, plan->prime->modulus, plan->inv_r };
+}
+
+/**
+ * @brief Montgomery product in radix 2^@p radix.
  *
- * @param data   Array of residues to transform (length must be power of two).
- * @param n      Number of elements.
- * @param prime  Prime modulus descriptor.
- * @param inverse Set to true for inverse transform.
- * @return true on success, false if parameters are invalid.
+ * Always called with a constant @p radix so each kernel is specialised.
  */
-_Bool ttak_ntt_transform(uint64_t *data, size_t n, const ttak_ntt_prime_t *prime, _Bool inverse) {
-    if (!data || !prime || n == 0) return false;
-    if ((n & (n - 1)) != 0) return false;
-    if (n > (size_t)(1ULL << prime->max_power_two)) return false;
+static inline uint64_t ntt_mul(ntt_consts_t k, uint64_t a, uint64_t b, unsigned radix) {
+    if (radix == 32) return montgomery_mul_narrow(a, b, k.mod, k.inv);
+    if (radix == 52) return montgomery_mul_52(a, b, k.mod, k.inv);
+    return ttak_montgomery_mul(a, b, k.prime);
+}
 
-    uint64_t modulus = prime->modulus;
-    uint64_t unity = ttak_montgomery_convert(1ULL, prime);
+/* Single butterflies; the vector kernels use them for stages shorter than a vector. */
+
+static inline void dif_pair(ntt_consts_t k, uint64_t *lo, uint64_t *hi, uint64_t w, unsigned radix) {
+    uint64_t u = *lo;
+    uint64_t v = *hi;
+    *lo = ntt_add(u, v, k.mod);
+    *hi = ntt_mul(k, ntt_sub(u, v, k.mod), w, radix);
+}
+
+/* @p w comes from the inverse table, so every column has the same shape. */
+static inline void dit_pair(ntt_consts_t k, uint64_t *lo, uint64_t *hi, uint64_t w, unsigned radix) {
+    uint64_t u = *lo;
+    uint64_t v = ntt_mul(k, *hi, w, radix);
+    *lo = ntt_add(u, v, k.mod);
+    *hi = ntt_sub(u, v, k.mod);
+}
+
+/* Two DIF stages (len = 2q, then q) on the column x[j], x[j + q], x[j + 2q], x[j + 3q]. */
+static inline void dif_quad(ntt_consts_t k, uint64_t *x, size_t q, const uint64_t *wl, const uint64_t *wq,
+                            size_t j, unsigned radix) {
+    dif_pair(k, x + j, x + j + 2 * q, wl[j], radix);
+    dif_pair(k, x + j + q, x + j + 3 * q, wl[j + q], radix);
+    dif_pair(k, x + j, x + j + q, wq[j], radix);
+    dif_pair(k, x + j + 2 * q, x + j + 3 * q, wq[j], radix);
+}
+
+/* Two DIT stages (len = q, then 2q), the inverse of dif_quad(). */
+static inline void dit_quad(ntt_consts_t k, uint64_t *x, size_t q, const uint64_t *wl, const uint64_t *wq,
+                            size_t j, unsigned radix) {
+    dit_pair(k, x + j, x + j + q, wq[j], radix);
+    dit_pair(k, x + j + 2 * q, x + j + 3 * q, wq[j], radix);
+    dit_pair(k, x + j, x + j + 2 * q, wl[j], radix);
+    dit_pair(k, x + j + q, x + j + 3 * q, wl[j + q], radix);
+}
+
+/**
+ * @brief Butterfly passes of one kernel.
+ *
+ * dif2 / dit2 run the single stage of half-length @p len over @p span
+ * elements, dif4 / dit4 the two stages len and len / 2 (forward) or len
+ * and 2 len (inverse) in one sweep. They touch only the columns j in
+ * [j0, j1) of each group, out of len (dif2, dit2, dit4) or len / 2 (dif4);
+ * the bounds are multiples of @c lanes. Vector kernels only see stages at
+ * least @c lanes long there; dif_tail / dit_head run all the shorter ones
+ * on transposed tiles of lanes x lanes elements.
+ */
+typedef struct ntt_ops {
+    size_t lanes;
+    void (*reduce)(const ttak_ntt_plan_t *plan, uint64_t *data, size_t n);
+    void (*dif2)(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, size_t j0, size_t j1);
+    void (*dif4)(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, size_t j0, size_t j1);
+    void (*dif_tail)(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span);
+    void (*dit_head)(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span);
+    void (*dit2)(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, size_t j0, size_t j1);
+    void (*dit4)(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, size_t j0, size_t j1);
+    /** dst[i] = a[i] * b[i] * R^-1, or a[i] * scale * R^-1 when @p b is NULL. */
+    void (*pointwise)(const ttak_ntt_plan_t *plan, uint64_t *dst, const uint64_t *a, const uint64_t *b,
+                      uint64_t scale, size_t n);
+} ntt_ops_t;
 
-    bit_reverse(data, n);
-    montgomery_array_convert(data, n, prime);
+/*
+ * x * (R mod p) * R^-1 = x mod p for any x below R, so the first stage's
+ * reduction needs a divide only for oversized inputs.
+ */
+static inline uint64_t ntt_reduce_one(ntt_consts_t k, uint64_t x, uint64_t r_mod, unsigned radix) {
+    if (radix == 32) return x <= UINT32_MAX ? montgomery_mul_narrow(x, r_mod, k.mod, k.inv) : x % k.mod;
+    if (radix == 52) return x <= NTT_MASK52 ? montgomery_mul_52(x, r_mod, k.mod, k.inv) : x % k.mod;
+    return x >= k.mod ? x % k.mod : x;
+}
+
+#define NTT_SCALAR_KERNELS(name, radix)                                                           \
+    static void name##_reduce(const ttak_ntt_plan_t *plan, uint64_t *data, size_t n) {            \
+        const ntt_consts_t k = ntt_consts(plan);                                                  \
+        const uint64_t r_mod = plan->r_mod;                                                       \
+        for (size_t i = 0; i < n; ++i) data[i] = ntt_reduce_one(k, data[i], r_mod, radix);        \
+    }                                                                                             \
+    static void name##_dif2(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, \
+                            size_t j0, size_t j1) {                                               \
+        const ntt_consts_t k = ntt_consts(plan);                                                  \
+        const uint64_t *w = plan->twiddles + len;                                                 \
+        for (size_t i = 0; i < span; i += 2 * len) {                                              \
+            for (size_t j = j0; j < j1; ++j) dif_pair(k, data + i + j, data + i + len + j, w[j], radix); \
+        }                                                                                         \
+    }                                                                                             \
+    static void name##_dif4(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, \
+                            size_t j0, size_t j1) {                                               \
+        const ntt_consts_t k = ntt_consts(plan);                                                  \
+        const size_t q = len >> 1;                                                                \
+        const uint64_t *wl = plan->twiddles + len;                                                \
+        const uint64_t *wq = plan->twiddles + q;                                                  \
+        for (size_t i = 0; i < span; i += 2 * len) {                                              \
+            for (size_t j = j0; j < j1; ++j) dif_quad(k, data + i, q, wl, wq, j, radix);          \
+        }                                                                                         \
+    }                                                                                             \
+    static void name##_dit2(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, \
+                            size_t j0, size_t j1) {                                               \
+        const ntt_consts_t k = ntt_consts(plan);                                                  \
+        const uint64_t *w = plan->twiddles + plan->n + len;                                       \
+        for (size_t i = 0; i < span; i += 2 * len) {                                              \
+            for (size_t j = j0; j < j1; ++j) dit_pair(k, data + i + j, data + i + len + j, w[j], radix); \
+        }                                                                                         \
+    }                                                                                             \
+    static void name##_dit4(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, \
+                            size_t j0, size_t j1) {                                               \
+        const ntt_consts_t k = ntt_consts(plan);                                                  \
+        const uint64_t *wl = plan->twiddles + plan->n + 2 * len;                                  \
+        const uint64_t *wq = plan->twiddles + plan->n + len;                                      \
+        for (size_t i = 0; i < span; i += 4 * len) {                                              \
+            for (size_t j = j0; j < j1; ++j) dit_quad(k, data + i, len, wl, wq, j, radix);        \
+        }                                                                                         \
+    }                                                                                             \
+    static void name##_pointwise(const ttak_ntt_plan_t *plan, uint64_t *dst, const uint64_t *a,     \
+                                 const uint64_t *b, uint64_t scale, size_t n) {                   \
+        const ntt_consts_t k = ntt_consts(plan);                                                  \
+        for (size_t i = 0; i < n; ++i) dst[i] = ntt_mul(k, a[i], b ? b[i] : scale, radix);        \
+    }                                                                                             \
+    static const ntt_ops_t name##_ops = { 1, name##_reduce, name##_dif2, name##_dif4, NULL, NULL,  \
+                                          name##_dit2, name##_dit4, name##_pointwise };
+
+NTT_SCALAR_KERNELS(ntt_scalar32, 32)
+NTT_SCALAR_KERNELS(ntt_scalar52, 52)
+NTT_SCALAR_KERNELS(ntt_scalar64, 64)
+
+/*
+ * Vector passes. Each ISA supplies name##_vec_t, name##_k_t and the inline
+ * primitives name##_consts, _set1, _load, _store, _below_r (every lane
+ * below R), _transpose (a lanes x lanes tile in place), _add, _sub and
+ * _mul; the loops below are shared. Residues sit one per 64-bit lane so
+ * spectra match the scalar layout.
+ */
+#define NTT_VECTOR_KERNELS(name, attr, lanes, scalar, radix)                                      \
+    attr static void name##_reduce(const ttak_ntt_plan_t *plan, uint64_t *data, size_t n) {       \
+        const name##_k_t k = name##_consts(plan);                                                 \
+        const name##_vec_t r = name##_set1(plan->r_mod);                                          \
+        const ntt_consts_t ks = ntt_consts(plan);                                                 \
+        size_t i = 0;                                                                             \
+        for (; i + (lanes) <= n; i += (lanes)) {                                                  \
+            name##_vec_t x = name##_load(data + i);                                               \
+            if (name##_below_r(x)) {                                                              \
+                name##_store(data + i, name##_mul(x, r, k));                                      \
+                continue;                                                                         \
+            }                                                                                     \
+            for (size_t j = i; j < i + (lanes); ++j) data[j] = ntt_reduce_one(ks, data[j], plan->r_mod, radix); \
+        }                                                                                         \
+        for (; i < n; ++i) data[i] = ntt_reduce_one(ks, data[i], plan->r_mod, radix);             \
+    }                                                                                             \
+    attr static void name##_dif2(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, \
+                                 size_t j0, size_t j1) {                                          \
+        const name##_k_t k = name##_consts(plan);                                                 \
+        const uint64_t *w = plan->twiddles + len;                                                 \
+        for (size_t i = 0; i < span; i += 2 * len) {                                              \
+            uint64_t *lo = data + i;                                                              \
+            uint64_t *hi = lo + len;                                                              \
+            for (size_t j = j0; j < j1; j += (lanes)) {                                           \
+                name##_vec_t u = name##_load(lo + j);                                             \
+                name##_vec_t v = name##_load(hi + j);                                             \
+                name##_store(lo + j, name##_add(u, v, k));                                        \
+                name##_store(hi + j, name##_mul(name##_sub(u, v, k), name##_load(w + j), k));     \
+            }                                                                                     \
+        }                                                                                         \
+    }                                                                                             \
+    attr static void name##_dif4(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, \
+                                 size_t j0, size_t j1) {                                          \
+        const size_t q = len >> 1;                                                                \
+        const name##_k_t k = name##_consts(plan);                                                 \
+        const uint64_t *wl = plan->twiddles + len;                                                \
+        const uint64_t *wq = plan->twiddles + q;                                                  \
+        for (size_t i = 0; i < span; i += 2 * len) {                                              \
+            uint64_t *x0 = data + i;                                                              \
+            uint64_t *x1 = x0 + q;                                                                \
+            uint64_t *x2 = x1 + q;                                                                \
+            uint64_t *x3 = x2 + q;                                                                \
+            for (size_t j = j0; j < j1; j += (lanes)) {                                           \
+                name##_vec_t a0 = name##_load(x0 + j);                                            \
+                name##_vec_t a1 = name##_load(x1 + j);                                            \
+                name##_vec_t a2 = name##_load(x2 + j);                                            \
+                name##_vec_t a3 = name##_load(x3 + j);                                            \
+                name##_vec_t b0 = name##_add(a0, a2, k);                                          \
+                name##_vec_t b1 = name##_add(a1, a3, k);                                          \
+                name##_vec_t b2 = name##_mul(name##_sub(a0, a2, k), name##_load(wl + j), k);      \
+                name##_vec_t b3 = name##_mul(name##_sub(a1, a3, k), name##_load(wl + q + j), k);  \
+                name##_vec_t w = name##_load(wq + j);                                             \
+                name##_store(x0 + j, name##_add(b0, b1, k));                                      \
+                name##_store(x1 + j, name##_mul(name##_sub(b0, b1, k), w, k));                    \
+                name##_store(x2 + j, name##_add(b2, b3, k));                                      \
+                name##_store(x3 + j, name##_mul(name##_sub(b2, b3, k), w, k));                    \
+            }                                                                                     \
+        }                                                                                         \
+    }                                                                                             \
+    /* After the transpose, v[e] holds element e of lanes consecutive blocks. */                  \
+    attr static void name##_dif_tail(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span) {  \
+        if (span < (lanes) * (lanes)) {                                                           \
+            for (size_t len = (span < (lanes) ? span : (lanes)) >> 1; len > 0; len >>= 1) {       \
+                scalar##_dif2(plan, data, span, len, 0, len);                                     \
+            }                                                                                     \
+            return;                                                                               \
+        }                                                                                         \
+        const name##_k_t k = name##_consts(plan);                                                 \
+        for (size_t i = 0; i < span; i += (lanes) * (lanes)) {                                    \
+            name##_vec_t v[(lanes)];                                                              \
+            for (size_t r = 0; r < (lanes); ++r) v[r] = name##_load(data + i + r * (lanes));      \
+            name##_transpose(v);                                                                  \
+            for (size_t len = (lanes) >> 1; len > 0; len >>= 1) {                                 \
+                const uint64_t *w = plan->twiddles + len;                                         \
+                for (size_t s = 0; s < (lanes); s += 2 * len) {                                   \
+                    for (size_t j = 0; j < len; ++j) {                                            \
+                        name##_vec_t u = v[s + j];                                                \
+                        name##_vec_t d = name##_sub(u, v[s + j + len], k);                        \
+                        v[s + j] = name##_add(u, v[s + j + len], k);                              \
+                        v[s + j + len] = j ? name##_mul(d, name##_set1(w[j]), k) : d;             \
+                    }                                                                             \
+                }                                                                                 \
+            }                                                                                     \
+            name##_transpose(v);                                                                  \
+            for (size_t r = 0; r < (lanes); ++r) name##_store(data + i + r * (lanes), v[r]);      \
+        }                                                                                         \
+    }                                                                                             \
+    attr static void name##_dit_head(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span) {  \
+        if (span < (lanes) * (lanes)) {                                                           \
+            for (size_t len = 1; len < (lanes) && len < span; len <<= 1) {                        \
+                scalar##_dit2(plan, data, span, len, 0, len);                                     \
+            }                                                                                     \
+            return;                                                                               \
+        }                                                                                         \
+        const name##_k_t k = name##_consts(plan);                                                 \
+        for (size_t i = 0; i < span; i += (lanes) * (lanes)) {                                    \
+            name##_vec_t v[(lanes)];                                                              \
+            for (size_t r = 0; r < (lanes); ++r) v[r] = name##_load(data + i + r * (lanes));      \
+            name##_transpose(v);                                                                  \
+            for (size_t len = 1; len < (lanes); len <<= 1) {                                      \
+                const uint64_t *w = plan->twiddles + plan->n + len;                               \
+                for (size_t s = 0; s < (lanes); s += 2 * len) {                                   \
+                    for (size_t j = 0; j < len; ++j) {                                            \
+                        name##_vec_t u = v[s + j];                                                \
+                        name##_vec_t t = v[s + j + len];                                          \
+                        if (j) t = name##_mul(t, name##_set1(w[j]), k);                           \
+                        v[s + j] = name##_add(u, t, k);                                           \
+                        v[s + j + len] = name##_sub(u, t, k);                                     \
+                    }                                                                             \
+                }                                                                                 \
+            }                                                                                     \
+            name##_transpose(v);                                                                  \
+            for (size_t r = 0; r < (lanes); ++r) name##_store(data + i + r * (lanes), v[r]);      \
+        }                                                                                         \
+    }                                                                                             \
+    attr static void name##_dit2(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, \
+                                 size_t j0, size_t j1) {                                          \
+        const name##_k_t k = name##_consts(plan);                                                 \
+        const uint64_t *w = plan->twiddles + plan->n + len;                                       \
+        for (size_t i = 0; i < span; i += 2 * len) {                                              \
+            uint64_t *lo = data + i;                                                              \
+            uint64_t *hi = lo + len;                                                              \
+            for (size_t j = j0; j < j1; j += (lanes)) {                                           \
+                name##_vec_t u = name##_load(lo + j);                                             \
+                name##_vec_t v = name##_mul(name##_load(hi + j), name##_load(w + j), k);          \
+                name##_store(lo + j, name##_add(u, v, k));                                        \
+                name##_store(hi + j, name##_sub(u, v, k));                                        \
+            }                                                                                     \
+        }                                                                                         \
+    }                                                                                             \
+    attr static void name##_dit4(const ttak_ntt_plan_t *plan, uint64_t *data, size_t span, size_t len, \
+                                 size_t j0, size_t j1) {                                          \
+        const name##_k_t k = name##_consts(plan);                                                 \
+        const size_t q = len;                                                                     \
+        const uint64_t *wl = plan->twiddles + plan->n + 2 * q;                                    \
+        const uint64_t *wq = plan->twiddles + plan->n + q;                                        \
+        for (size_t i = 0; i < span; i += 4 * q) {                                                \
+            uint64_t *x0 = data + i;                                                              \
+            uint64_t *x1 = x0 + q;                                                                \
+            uint64_t *x2 = x1 + q;                                                                \
+            uint64_t *x3 = x2 + q;                                                                \
+            for (size_t j = j0; j < j1; j += (lanes)) {                                           \
+                name##_vec_t w = name##_load(wq + j);                                             \
+                name##_vec_t a0 = name##_load(x0 + j);                                            \
+                name##_vec_t a2 = name##_load(x2 + j);                                            \
+                name##_vec_t v1 = name##_mul(name##_load(x1 + j), w, k);                          \
+                name##_vec_t v3 = name##_mul(name##_load(x3 + j), w, k);                          \
+                name##_vec_t b0 = name##_add(a0, v1, k);                                          \
+                name##_vec_t b1 = name##_sub(a0, v1, k);                                          \
+                name##_vec_t c2 = name##_mul(name##_add(a2, v3, k), name##_load(wl + j), k);      \
+                name##_vec_t c3 = name##_mul(name##_sub(a2, v3, k), name##_load(wl + q + j), k);  \
+                name##_store(x0 + j, name##_add(b0, c2, k));                                      \
+                name##_store(x2 + j, name##_sub(b0, c2, k));                                      \
+                name##_store(x1 + j, name##_add(b1, c3, k));                                      \
+                name##_store(x3 + j, name##_sub(b1, c3, k));                                      \
+            }                                                                                     \
+        }                                                                                         \
+    }                                                                                             \
+    attr static void name##_pointwise(const ttak_ntt_plan_t *plan, uint64_t *dst, const uint64_t *a, \
+                                      const uint64_t *b, uint64_t scale, size_t n) {              \
+        const name##_k_t k = name##_consts(plan);                                                 \
+        const name##_vec_t s = name##_set1(scale);                                                \
+        size_t i = 0;                                                                             \
+        for (; i + (lanes) <= n; i += (lanes)) {                                                  \
+            name##_vec_t y = b ? name##_load(b + i) : s;                                          \
+            name##_store(dst + i, name##_mul(name##_load(a + i), y, k));                          \
+        }                                                                                         \
+        scalar##_pointwise(plan, dst + i, a + i, b ? b + i : NULL, scale, n - i);                 \
+    }                                                                                             \
+    static const ntt_ops_t name##_ops = { (lanes), name##_reduce, name##_dif2, name##_dif4,       \
+                                          name##_dif_tail, name##_dit_head, name##_dit2,          \
+                                          name##_dit4, name##_pointwise };
+
+#if defined(TTAK_ARCH_X86_64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#define TTAK_NTT_X86_64 1
+#include <immintrin.h>
 
-    uint64_t root = ttak_mod_pow(prime->primitive_root, (prime->modulus - 1) / n, modulus);
-    if (inverse) {
-        root = ttak_mod_inverse(root, modulus);
+#define NTT_AVX2 __attribute__((target("avx2")))
+#define NTT_AVX512 __attribute__((target("avx512f")))
+#define NTT_IFMA __attribute__((target("avx512f,avx512ifma")))
+
+/*
+ * 32-bit primes: vpmuludq multiplies the low halves of each 64-bit lane,
+ * and every value stays below 2^32, so the reductions compare 32-bit lanes
+ * whose upper neighbours are zero on both sides.
+ */
+typedef __m256i ntt_avx2_vec_t;
+typedef struct { __m256i p, inv; } ntt_avx2_k_t;
+
+NTT_AVX2 static inline ntt_avx2_k_t ntt_avx2_consts(const ttak_ntt_plan_t *plan) {
+    return (ntt_avx2_k_t){ _mm256_set1_epi64x((long long)plan->prime->modulus),
+                           _mm256_set1_epi64x((long long)(plan->inv_r & 0xFFFFFFFFULL)) };
+}
+NTT_AVX2 static inline __m256i ntt_avx2_set1(uint64_t x) {
+    return _mm256_set1_epi64x((long long)x);
+}
+NTT_AVX2 static inline __m256i ntt_avx2_load(const uint64_t *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+NTT_AVX2 static inline void ntt_avx2_store(uint64_t *p, __m256i v) {
+    _mm256_storeu_si256((__m256i *)p, v);
+}
+NTT_AVX2 static inline bool ntt_avx2_below_r(__m256i v) {
+    return _mm256_testz_si256(v, _mm256_set1_epi64x((long long)0xFFFFFFFF00000000ULL));
+}
+NTT_AVX2 static inline void ntt_avx2_transpose(__m256i *v) {
+    __m256i t0 = _mm256_unpacklo_epi64(v[0], v[1]);
+    __m256i t1 = _mm256_unpackhi_epi64(v[0], v[1]);
+    __m256i t2 = _mm256_unpacklo_epi64(v[2], v[3]);
+    __m256i t3 = _mm256_unpackhi_epi64(v[2], v[3]);
+    v[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    v[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    v[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    v[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+NTT_AVX2 static inline __m256i ntt_avx2_add(__m256i a, __m256i b, ntt_avx2_k_t k) {
+    __m256i s = _mm256_add_epi32(a, b);
+    return _mm256_min_epu32(s, _mm256_sub_epi32(s, k.p));
+}
+NTT_AVX2 static inline __m256i ntt_avx2_sub(__m256i a, __m256i b, ntt_avx2_k_t k) {
+    __m256i d = _mm256_sub_epi32(a, b);
+    return _mm256_min_epu32(d, _mm256_add_epi32(d, k.p));
+}
+NTT_AVX2 static inline __m256i ntt_avx2_mul(__m256i a, __m256i b, ntt_avx2_k_t k) {
+    __m256i t = _mm256_mul_epu32(a, b);
+    __m256i m = _mm256_mul_epu32(t, k.inv);
+    __m256i u = _mm256_srli_epi64(_mm256_add_epi64(t, _mm256_mul_epu32(m, k.p)), 32);
+    return _mm256_min_epu32(u, _mm256_sub_epi32(u, k.p));
+}
+
+NTT_VECTOR_KERNELS(ntt_avx2, NTT_AVX2, 4, ntt_scalar32, 32)
+
+/* An 8 x 8 tile of 64-bit lanes: pairs within 128-bit lanes, then two rounds of 128-bit shuffles. */
+NTT_AVX512 static inline void ntt_transpose8(__m512i *v) {
+    __m512i t[8], u[8];
+    for (int r = 0; r < 8; r += 2) {
+        t[r] = _mm512_unpacklo_epi64(v[r], v[r + 1]);
+        t[r + 1] = _mm512_unpackhi_epi64(v[r], v[r + 1]);
+    }
+    for (int r = 0; r < 8; r += 4) {
+        u[r] = _mm512_shuffle_i64x2(t[r], t[r + 2], 0x88);
+        u[r + 1] = _mm512_shuffle_i64x2(t[r], t[r + 2], 0xDD);
+        u[r + 2] = _mm512_shuffle_i64x2(t[r + 1], t[r + 3], 0x88);
+        u[r + 3] = _mm512_shuffle_i64x2(t[r + 1], t[r + 3], 0xDD);
     }
+    v[0] = _mm512_shuffle_i64x2(u[0], u[4], 0x88);
+    v[4] = _mm512_shuffle_i64x2(u[0], u[4], 0xDD);
+    v[2] = _mm512_shuffle_i64x2(u[1], u[5], 0x88);
+    v[6] = _mm512_shuffle_i64x2(u[1], u[5], 0xDD);
+    v[1] = _mm512_shuffle_i64x2(u[2], u[6], 0x88);
+    v[5] = _mm512_shuffle_i64x2(u[2], u[6], 0xDD);
+    v[3] = _mm512_shuffle_i64x2(u[3], u[7], 0x88);
+    v[7] = _mm512_shuffle_i64x2(u[3], u[7], 0xDD);
+}
+
+typedef __m512i ntt_avx512_vec_t;
+typedef struct { __m512i p, inv; } ntt_avx512_k_t;
+
+NTT_AVX512 static inline ntt_avx512_k_t ntt_avx512_consts(const ttak_ntt_plan_t *plan) {
+    return (ntt_avx512_k_t){ _mm512_set1_epi64((long long)plan->prime->modulus),
+                             _mm512_set1_epi64((long long)(plan->inv_r & 0xFFFFFFFFULL)) };
+}
+NTT_AVX512 static inline __m512i ntt_avx512_set1(uint64_t x) {
+    return _mm512_set1_epi64((long long)x);
+}
+NTT_AVX512 static inline __m512i ntt_avx512_load(const uint64_t *p) {
+    return _mm512_loadu_si512((const void *)p);
+}
+NTT_AVX512 static inline void ntt_avx512_store(uint64_t *p, __m512i v) {
+    _mm512_storeu_si512((void *)p, v);
+}
+NTT_AVX512 static inline bool ntt_avx512_below_r(__m512i v) {
+    return _mm512_test_epi64_mask(v, _mm512_set1_epi64((long long)0xFFFFFFFF00000000ULL)) == 0;
+}
+NTT_AVX512 static inline void ntt_avx512_transpose(__m512i *v) {
+    ntt_transpose8(v);
+}
+NTT_AVX512 static inline __m512i ntt_avx512_add(__m512i a, __m512i b, ntt_avx512_k_t k) {
+    __m512i s = _mm512_add_epi32(a, b);
+    return _mm512_min_epu32(s, _mm512_sub_epi32(s, k.p));
+}
+NTT_AVX512 static inline __m512i ntt_avx512_sub(__m512i a, __m512i b, ntt_avx512_k_t k) {
+    __m512i d = _mm512_sub_epi32(a, b);
+    return _mm512_min_epu32(d, _mm512_add_epi32(d, k.p));
+}
+NTT_AVX512 static inline __m512i ntt_avx512_mul(__m512i a, __m512i b, ntt_avx512_k_t k) {
+    __m512i t = _mm512_mul_epu32(a, b);
+    __m512i m = _mm512_mul_epu32(t, k.inv);
+    __m512i u = _mm512_srli_epi64(_mm512_add_epi64(t, _mm512_mul_epu32(m, k.p)), 32);
+    return _mm512_min_epu32(u, _mm512_sub_epi32(u, k.p));
+}
+
+NTT_VECTOR_KERNELS(ntt_avx512, NTT_AVX512, 8, ntt_scalar32, 32)
+
+/*
+ * 50-bit primes in 52-bit lanes. t = a * b splits into lo + 2^52 hi, and
+ * lo + (m * p mod 2^52) is 0 or exactly 2^52, so the carry into the high
+ * half is just lo != 0.
+ */
+typedef __m512i ntt_ifma_vec_t;
+typedef struct { __m512i p, inv; } ntt_ifma_k_t;
+
+NTT_IFMA static inline ntt_ifma_k_t ntt_ifma_consts(const ttak_ntt_plan_t *plan) {
+    return (ntt_ifma_k_t){ _mm512_set1_epi64((long long)plan->prime->modulus),
+                           _mm512_set1_epi64((long long)(plan->inv_r & NTT_MASK52)) };
+}
+NTT_IFMA static inline __m512i ntt_ifma_set1(uint64_t x) {
+    return _mm512_set1_epi64((long long)x);
+}
+NTT_IFMA static inline __m512i ntt_ifma_load(const uint64_t *p) {
+    return _mm512_loadu_si512((const void *)p);
+}
+NTT_IFMA static inline void ntt_ifma_store(uint64_t *p, __m512i v) {
+    _mm512_storeu_si512((void *)p, v);
+}
+NTT_IFMA static inline bool ntt_ifma_below_r(__m512i v) {
+    return _mm512_test_epi64_mask(v, _mm512_set1_epi64((long long)~NTT_MASK52)) == 0;
+}
+NTT_IFMA static inline void ntt_ifma_transpose(__m512i *v) {
+    ntt_transpose8(v);
+}
+NTT_IFMA static inline __m512i ntt_ifma_add(__m512i a, __m512i b, ntt_ifma_k_t k) {
+    __m512i s = _mm512_add_epi64(a, b);
+    return _mm512_min_epu64(s, _mm512_sub_epi64(s, k.p));
+}
+NTT_IFMA static inline __m512i ntt_ifma_sub(__m512i a, __m512i b, ntt_ifma_k_t k) {
+    __m512i d = _mm512_sub_epi64(a, b);
+    return _mm512_min_epu64(d, _mm512_add_epi64(d, k.p));
+}
+NTT_IFMA static inline __m512i ntt_ifma_mul(__m512i a, __m512i b, ntt_ifma_k_t k) {
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i lo = _mm512_madd52lo_epu64(zero, a, b);
+    __m512i hi = _mm512_madd52hi_epu64(zero, a, b);
+    __m512i m = _mm512_madd52lo_epu64(zero, lo, k.inv);
+    __m512i u = _mm512_madd52hi_epu64(hi, m, k.p);
+    u = _mm512_mask_sub_epi64(u, _mm512_test_epi64_mask(lo, lo), u, _mm512_set1_epi64(-1));
+    return _mm512_min_epu64(u, _mm512_sub_epi64(u, k.p));
+}
+
+NTT_VECTOR_KERNELS(ntt_ifma, NTT_IFMA, 8, ntt_scalar52, 52)
+
+#elif defined(TTAK_ARCH_AARCH64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#define TTAK_NTT_NEON 1
+#include <arm_neon.h>
+
+/* Same scheme as the AVX2 kernel on two lanes: umull, then 32-bit umin. */
+typedef uint64x2_t ntt_neon_vec_t;
+typedef struct { uint32x4_t p; uint32x2_t p2, inv; } ntt_neon_k_t;
 
-    for (size_t len = 1; len < n; len <<= 1) {
-        uint64_t wlen = ttak_mod_pow(root, n / (len << 1), modulus);
-        uint64_t wlen_mont = ttak_montgomery_convert(wlen, prime);
-        size_t lattice_dim = ttak_ntt_lattice_dim(len);
-        size_t lattice_shift = ttak_ntt_lattice_shift(lattice_dim);
-        size_t lattice_mask = lattice_dim - 1;
-        size_t lattice_rows = len >> lattice_shift;
-        uint64_t lane_pows[TTAK_NTT_MAX_LATTICE_DIM];
-        lane_pows[0] = unity;
-        for (size_t idx = 1; idx < lattice_dim; ++idx) {
-            lane_pows[idx] = ttak_montgomery_mul(lane_pows[idx - 1], wlen_mont, prime);
+static inline ntt_neon_k_t ntt_neon_consts(const ttak_ntt_plan_t *plan) {
+    uint32_t p = (uint32_t)plan->prime->modulus;
+    return (ntt_neon_k_t){ vreinterpretq_u32_u64(vdupq_n_u64(p)), vdup_n_u32(p), vdup_n_u32((uint32_t)plan->inv_r) };
+}
+static inline uint64x2_t ntt_neon_set1(uint64_t x) {
+    return vdupq_n_u64(x);
+}
+static inline uint64x2_t ntt_neon_load(const uint64_t *p) {
+    return vld1q_u64(p);
+}
+static inline void ntt_neon_store(uint64_t *p, uint64x2_t v) {
+    vst1q_u64(p, v);
+}
+static inline bool ntt_neon_below_r(uint64x2_t v) {
+    return vmaxvq_u32(vreinterpretq_u32_u64(vshrq_n_u64(v, 32))) == 0;
+}
+static inline void ntt_neon_transpose(uint64x2_t *v) {
+    uint64x2_t lo = vtrn1q_u64(v[0], v[1]);
+    v[1] = vtrn2q_u64(v[0], v[1]);
+    v[0] = lo;
+}
+static inline uint64x2_t ntt_neon_reduce(uint32x4_t x, ntt_neon_k_t k) {
+    return vreinterpretq_u64_u32(vminq_u32(x, vsubq_u32(x, k.p)));
+}
+static inline uint64x2_t ntt_neon_add(uint64x2_t a, uint64x2_t b, ntt_neon_k_t k) {
+    return ntt_neon_reduce(vaddq_u32(vreinterpretq_u32_u64(a), vreinterpretq_u32_u64(b)), k);
+}
+static inline uint64x2_t ntt_neon_sub(uint64x2_t a, uint64x2_t b, ntt_neon_k_t k) {
+    uint32x4_t d = vsubq_u32(vreinterpretq_u32_u64(a), vreinterpretq_u32_u64(b));
+    return vreinterpretq_u64_u32(vminq_u32(d, vaddq_u32(d, k.p)));
+}
+static inline uint64x2_t ntt_neon_mul(uint64x2_t a, uint64x2_t b, ntt_neon_k_t k) {
+    uint64x2_t t = vmull_u32(vmovn_u64(a), vmovn_u64(b));
+    uint32x2_t m = vmul_u32(vmovn_u64(t), k.inv);
+    uint64x2_t u = vshrq_n_u64(vmlal_u32(t, m, k.p2), 32);
+    return ntt_neon_reduce(vreinterpretq_u32_u64(u), k);
+}
+
+NTT_VECTOR_KERNELS(ntt_neon, , 2, ntt_scalar32, 32)
+#endif
+
+/* TTAK_NTT_KERNEL=scalar forces the portable butterflies, e.g. to cross-check results. */
+ttak_ntt_kernel_t ttak_ntt_kernel_for(const ttak_ntt_prime_t *prime) {
+    if (!prime) return TTAK_NTT_KERNEL_SCALAR;
+    const char *env = getenv("TTAK_NTT_KERNEL");
+    if (env && strcmp(env, "scalar") == 0) return TTAK_NTT_KERNEL_SCALAR;
+    uint32_t features = ttak_arch_features();
+    (void)features;
+#if defined(TTAK_NTT_X86_64)
+    if (prime->modulus < (1ULL << 31)) {
+        if (features & TTAK_ARCH_FEATURE_AVX512F) return TTAK_NTT_KERNEL_AVX512;
+        if (features & TTAK_ARCH_FEATURE_AVX2) return TTAK_NTT_KERNEL_AVX2;
+    } else if (prime->modulus < (1ULL << 50)) {
+        const uint32_t want = TTAK_ARCH_FEATURE_AVX512F | TTAK_ARCH_FEATURE_AVX512IFMA;
+        if ((features & want) == want) return TTAK_NTT_KERNEL_IFMA;
+    }
+#elif defined(TTAK_NTT_NEON)
+    if (prime->modulus < (1ULL << 31) && (features & TTAK_ARCH_FEATURE_NEON)) return TTAK_NTT_KERNEL_NEON;
+#endif
+    return TTAK_NTT_KERNEL_SCALAR;
+}
+
+const char *ttak_ntt_kernel_name(ttak_ntt_kernel_t kernel) {
+    switch (kernel) {
+        case TTAK_NTT_KERNEL_AVX2:
+            return "avx2";
+        case TTAK_NTT_KERNEL_AVX512:
+            return "avx512";
+        case TTAK_NTT_KERNEL_IFMA:
+            return "ifma";
+        case TTAK_NTT_KERNEL_NEON:
+            return "neon";
+        case TTAK_NTT_KERNEL_SCALAR:
+        default:
+            return "scalar";
+    }
+}
+
+/* A kernel that does not match the plan's radix, or this build, runs scalar. */
+static const ntt_ops_t *ntt_ops(const ttak_ntt_plan_t *plan) {
+    const ntt_ops_t *scalar = plan->radix_bits == 32   ? &ntt_scalar32_ops
+                              : plan->radix_bits == 52 ? &ntt_scalar52_ops
+                                                       : &ntt_scalar64_ops;
+    switch (plan->kernel) {
+        case TTAK_NTT_KERNEL_AVX2:
+#if defined(TTAK_NTT_X86_64)
+            if (plan->radix_bits == 32) return &ntt_avx2_ops;
+#endif
+            return scalar;
+        case TTAK_NTT_KERNEL_AVX512:
+#if defined(TTAK_NTT_X86_64)
+            if (plan->radix_bits == 32) return &ntt_avx512_ops;
+#endif
+            return scalar;
+        case TTAK_NTT_KERNEL_IFMA:
+#if defined(TTAK_NTT_X86_64)
+            if (plan->radix_bits == 52) return &ntt_ifma_ops;
+#endif
+            return scalar;
+        case TTAK_NTT_KERNEL_NEON:
+#if defined(TTAK_NTT_NEON)
+            if (plan->radix_bits == 32) return &ntt_neon_ops;
+#endif
+            return scalar;
+        case TTAK_NTT_KERNEL_SCALAR:
+        default:
+            return scalar;
+    }
+}
+
+/* One Montgomery product in the plan's radix, for set-up work. */
+static uint64_t plan_mul(const ttak_ntt_plan_t *plan, uint64_t a, uint64_t b) {
+    const ntt_consts_t k = ntt_consts(plan);
+    if (plan->radix_bits == 32) return ntt_mul(k, a, b, 32);
+    if (plan->radix_bits == 52) return ntt_mul(k, a, b, 52);
+    return ntt_mul(k, a, b, 64);
+}
+
+/*
+ * Stages of half-length len down to floor over span, two at a time where
+ * both qualify. Only the columns whose index mod floor lies in [c0, c1)
+ * are touched; every stage keeps those columns to themselves, so disjoint
+ * windows may run on different threads.
+ */
+static void dif_stages(const ntt_ops_t *ops, const ttak_ntt_plan_t *plan, uint64_t *data, size_t span,
+                       size_t len, size_t floor, size_t c0, size_t c1) {
+    const bool whole = c0 == 0 && c1 == floor;
+    while (len >= floor && len > 0) {
+        if (len >= 2 && (len >> 1) >= floor) {
+            const size_t cols = len >> 1;
+            if (whole) ops->dif4(plan, data, span, len, 0, cols);
+            else for (size_t t = 0; t < cols; t += floor) ops->dif4(plan, data, span, len, t + c0, t + c1);
+            len >>= 2;
+        } else {
+            if (whole) ops->dif2(plan, data, span, len, 0, len);
+            else for (size_t t = 0; t < len; t += floor) ops->dif2(plan, data, span, len, t + c0, t + c1);
+            len >>= 1;
         }
-        uint64_t lattice_stride = unity;
-        for (size_t step = 0; step < lattice_dim; ++step) {
-            lattice_stride = ttak_montgomery_mul(lattice_stride, wlen_mont, prime);
+    }
+}
+
+/* Stages of half-length len up to top; the column window repeats every len of the first stage. */
+static void dit_stages(const ntt_ops_t *ops, const ttak_ntt_plan_t *plan, uint64_t *data, size_t span,
+                       size_t len, size_t top, size_t c0, size_t c1) {
+    const size_t period = len;
+    const bool whole = c0 == 0 && c1 == period;
+    while (len <= top && len > 0) {
+        if (2 * len <= top) {
+            if (whole) ops->dit4(plan, data, span, len, 0, len);
+            else for (size_t t = 0; t < len; t += period) ops->dit4(plan, data, span, len, t + c0, t + c1);
+            len <<= 2;
+        } else {
+            if (whole) ops->dit2(plan, data, span, len, 0, len);
+            else for (size_t t = 0; t < len; t += period) ops->dit2(plan, data, span, len, t + c0, t + c1);
+            len <<= 1;
         }
+    }
+}
 
-        for (size_t i = 0; i < n; i += (len << 1)) {
-            uint64_t row_factor = unity;
-            for (size_t row = 0; row < lattice_rows; ++row) {
-                size_t row_seed = row & lattice_mask;
-                size_t row_base = row << lattice_shift;
-                for (size_t lane = 0; lane < lattice_dim; ++lane) {
-                    size_t lane_idx = (row_seed + lane) & lattice_mask;
-                    size_t j = row_base | lane_idx;
-                    uint64_t w = ttak_montgomery_mul(row_factor, lane_pows[lane_idx], prime);
-
-                    uint64_t u = data[i + j];
-                    uint64_t v = ttak_montgomery_mul(data[i + j + len], w, prime);
-                    uint64_t add = u + v;
-                    if (add >= modulus) add -= modulus;
-                    uint64_t sub = (u >= v) ? (u - v) : (u + modulus - v);
-                    data[i + j] = add;
-                    data[i + j + len] = sub;
-                }
-                row_factor = ttak_montgomery_mul(row_factor, lattice_stride, prime);
-            }
+static size_t ntt_block_len(const ttak_ntt_plan_t *plan) {
+    return plan->n < TTAK_NTT_BLOCK_ELEMS ? plan->n : TTAK_NTT_BLOCK_ELEMS;
+}
+
+/* The stages inside one block, the ones shorter than a vector on transposed tiles. */
+static void ntt_block_forward(const ntt_ops_t *ops, const ttak_ntt_plan_t *plan, uint64_t *data, size_t block) {
+    dif_stages(ops, plan, data, block, block >> 1, ops->lanes, 0, ops->lanes);
+    if (ops->dif_tail) ops->dif_tail(plan, data, block);
+}
+
+static void ntt_block_inverse(const ntt_ops_t *ops, const ttak_ntt_plan_t *plan, uint64_t *data, size_t block) {
+    if (ops->dit_head) ops->dit_head(plan, data, block);
+    dit_stages(ops, plan, data, block, ops->lanes, block >> 1, 0, ops->lanes);
+}
+
+/*
+ * Decimation in frequency, natural order in and bit-reversed out. Stages
+ * whose butterflies span more than a block sweep the whole array; the rest
+ * finish one block at a time while it is still in cache.
+ */
+static void ntt_forward_stages(const ntt_ops_t *ops, const ttak_ntt_plan_t *plan, uint64_t *data) {
+    const size_t n = plan->n;
+    const size_t block = ntt_block_len(plan);
+    dif_stages(ops, plan, data, n, n >> 1, block, 0, block);
+    for (size_t b = 0; b < n; b += block) ntt_block_forward(ops, plan, data + b, block);
+}
+
+/* Decimation in time with inverse roots, the mirror of ntt_forward_stages(). */
+static void ntt_inverse_stages(const ntt_ops_t *ops, const ttak_ntt_plan_t *plan, uint64_t *data) {
+    const size_t n = plan->n;
+    const size_t block = ntt_block_len(plan);
+    for (size_t b = 0; b < n; b += block) ntt_block_inverse(ops, plan, data + b, block);
+    dit_stages(ops, plan, data, n, block, n >> 1, 0, block);
+}
+
+_Bool ttak_ntt_plan_init(ttak_ntt_plan_t *plan, const ttak_ntt_prime_t *prime, size_t n) {
+    if (!plan) return false;
+    memset(plan, 0, sizeof(*plan));
+    if (!prime || n == 0) return false;
+    if ((n & (n - 1)) != 0) return false;
+    if (n > (size_t)(1ULL << prime->max_power_two)) return false;
+
+    uint64_t modulus = prime->modulus;
+    plan->prime = prime;
+    plan->n = n;
+    plan->kernel = ttak_ntt_kernel_for(prime);
+    if (modulus < (1ULL << 31)) {
+        plan->radix_bits = 32;
+        plan->inv_r = prime->montgomery_inv & 0xFFFFFFFFULL;
+    } else if (plan->kernel == TTAK_NTT_KERNEL_IFMA) {
+        plan->radix_bits = 52;
+        plan->inv_r = prime->montgomery_inv & NTT_MASK52;
+    } else {
+        plan->radix_bits = 64;
+    }
+
+    /* R^2 / n folds the pointwise R^-1 and the 1/n of the inverse together. */
+    uint64_t inv_n = ttak_mod_inverse((uint64_t)n % modulus, modulus);
+    uint64_t r_mod;
+    if (plan->radix_bits < 64) {
+        r_mod = (1ULL << plan->radix_bits) % modulus;
+        plan->scale = ttak_mod_mul(ttak_mod_mul(r_mod, r_mod, modulus), inv_n, modulus);
+    } else {
+        r_mod = ttak_u128_mod_u64(ttak_u128_make(1, 0), modulus);
+        plan->scale = ttak_mod_mul(prime->montgomery_r2, inv_n, modulus);
+    }
+    plan->inv_n = inv_n;
+    plan->r_mod = r_mod;
+
+    size_t half = n >> 1;
+    if (!half) return true;
+    plan->twiddles = ttak_mem_alloc_lite(2 * n * sizeof(uint64_t), __TTAK_UNSAFE_MEM_FOREVER__, 0, TTAK_MEM_DEFAULT);
+    if (!plan->twiddles) return false;
+
+    uint64_t root = ttak_mod_pow(prime->primitive_root, (modulus - 1) / n, modulus);
+    uint64_t root_mont = ttak_mod_mul(root, r_mod, modulus);
+    uint64_t *top = plan->twiddles + half;
+    uint64_t *inv_top = top + n;
+    top[0] = r_mod;
+    for (size_t j = 1; j < half; ++j) {
+        top[j] = plan_mul(plan, top[j - 1], root_mont);
+    }
+    /* w^-j = w^(n - j) = -w^(half - j), since w^half = -1. */
+    inv_top[0] = r_mod;
+    for (size_t j = 1; j < half; ++j) {
+        inv_top[j] = modulus - top[half - j];
+    }
+    /* The root of stage len is the square of the root of stage 2 len. */
+    for (size_t len = half >> 1; len > 0; len >>= 1) {
+        for (size_t j = 0; j < len; ++j) {
+            plan->twiddles[len + j] = plan->twiddles[2 * len + 2 * j];
+            plan->twiddles[n + len + j] = plan->twiddles[n + 2 * len + 2 * j];
         }
     }
+    return true;
+}
+
+void ttak_ntt_plan_destroy(ttak_ntt_plan_t *plan) {
+    if (!plan) return;
+    ttak_mem_free_lite(plan->twiddles);
+    plan->twiddles = NULL;
+    plan->n = 0;
+}
+
+void ttak_ntt_plan_forward(const ttak_ntt_plan_t *plan, uint64_t *data) {
+    const ntt_ops_t *ops = ntt_ops(plan);
+    ops->reduce(plan, data, plan->n);
+    ntt_forward_stages(ops, plan, data);
+}
+
+void ttak_ntt_plan_pointwise_mul(const ttak_ntt_plan_t *plan, uint64_t *dst, const uint64_t *lhs, const uint64_t *rhs) {
+    ntt_ops(plan)->pointwise(plan, dst, lhs, rhs, 0, plan->n);
+}
+
+void ttak_ntt_plan_inverse(const ttak_ntt_plan_t *plan, uint64_t *data) {
+    const ntt_ops_t *ops = ntt_ops(plan);
+    ntt_inverse_stages(ops, plan, data);
+    ops->pointwise(plan, data, data, NULL, plan->scale, plan->n);
+}
+
+/*
+ * Per-index loop on ttak_parallel_for() with a grain of one, so helpers
+ * claim single column or block tasks.
+ */
+typedef struct ntt_loop {
+    void (*fn)(void *ctx, size_t index);
+    void *ctx;
+} ntt_loop_t;
+
+static void ntt_loop_body(void *arg, size_t begin, size_t end) {
+    ntt_loop_t *loop = arg;
+    for (size_t i = begin; i < end; i++) loop->fn(loop->ctx, i);
+}
+
+static void ntt_parallel_for(ttak_thread_pool_t *pool, size_t count, void (*fn)(void *ctx, size_t index),
+                             void *ctx, uint64_t now) {
+    ntt_loop_t loop = { fn, ctx };
+    ttak_parallel_for(pool, 0, count, 1, ntt_loop_body, &loop, now);
+}
+
+/*
+ * Work split of ttak_ntt_plan_convolve(). The long stages keep each
+ * column index mod block to itself, so they run as column tasks of
+ * chunk columns (a four-step column pass without the transposes); the
+ * short stages and the pointwise product run as one task per block.
+ */
+typedef struct ntt_conv {
+    const ttak_ntt_plan_t *const *plans;
+    uint64_t *const *lhs;
+    uint64_t *const *rhs;
+    size_t n;
+    size_t block;
+    size_t chunk;
+    size_t chunks;
+    size_t blocks;
+} ntt_conv_t;
 
-    if (inverse) {
-        uint64_t inv_n = ttak_mod_inverse((uint64_t)n % modulus, modulus);
-        uint64_t inv_n_mont = ttak_montgomery_convert(inv_n, prime);
+static void ntt_conv_columns_forward(void *arg, size_t index) {
+    const ntt_conv_t *cv = arg;
+    size_t i = index / (2 * cv->chunks);
+    bool second = (index / cv->chunks) & 1;
+    if (second && cv->rhs[i] == cv->lhs[i]) return;
+    const ttak_ntt_plan_t *plan = cv->plans[i];
+    const ntt_ops_t *ops = ntt_ops(plan);
+    uint64_t *data = second ? cv->rhs[i] : cv->lhs[i];
+    size_t c0 = (index % cv->chunks) * cv->chunk;
+    for (size_t b = 0; b < cv->n; b += cv->block) ops->reduce(plan, data + b + c0, cv->chunk);
+    dif_stages(ops, plan, data, cv->n, cv->n >> 1, cv->block, c0, c0 + cv->chunk);
+}
+
+static void ntt_conv_blocks(void *arg, size_t index) {
+    const ntt_conv_t *cv = arg;
+    size_t i = index / cv->blocks;
+    size_t off = (index % cv->blocks) * cv->block;
+    const ttak_ntt_plan_t *plan = cv->plans[i];
+    const ntt_ops_t *ops = ntt_ops(plan);
+    const bool single = cv->blocks == 1;
+    uint64_t *x = cv->lhs[i] + off;
+    uint64_t *y = cv->rhs[i] + off;
+    if (single) ops->reduce(plan, x, cv->block);
+    ntt_block_forward(ops, plan, x, cv->block);
+    if (y != x) {
+        if (single) ops->reduce(plan, y, cv->block);
+        ntt_block_forward(ops, plan, y, cv->block);
+    }
+    ops->pointwise(plan, x, x, y, 0, cv->block);
+    ntt_block_inverse(ops, plan, x, cv->block);
+    if (single) ops->pointwise(plan, x, x, NULL, plan->scale, cv->block);
+}
+
+static void ntt_conv_columns_inverse(void *arg, size_t index) {
+    const ntt_conv_t *cv = arg;
+    size_t i = index / cv->chunks;
+    const ttak_ntt_plan_t *plan = cv->plans[i];
+    const ntt_ops_t *ops = ntt_ops(plan);
+    uint64_t *data = cv->lhs[i];
+    size_t c0 = (index % cv->chunks) * cv->chunk;
+    dit_stages(ops, plan, data, cv->n, cv->block, cv->n >> 1, c0, c0 + cv->chunk);
+    for (size_t b = 0; b < cv->n; b += cv->block) {
+        ops->pointwise(plan, data + b + c0, data + b + c0, NULL, plan->scale, cv->chunk);
+    }
+}
+
+void ttak_ntt_plan_convolve(const ttak_ntt_plan_t *const *plans, uint64_t *const *lhs, uint64_t *const *rhs,
+                            size_t count, ttak_thread_pool_t *pool, uint64_t now) {
+    if (!count) return;
+    ntt_conv_t cv = { .plans = plans, .lhs = lhs, .rhs = rhs, .n = plans[0]->n };
+    cv.block = ntt_block_len(plans[0]);
+    cv.blocks = cv.n / cv.block;
+    /* A column task touches about one block of elements. */
+    cv.chunk = cv.block / cv.blocks;
+    if (cv.chunk < TTAK_NTT_COLUMN_MIN) cv.chunk = TTAK_NTT_COLUMN_MIN;
+    if (cv.chunk > cv.block) cv.chunk = cv.block;
+    cv.chunks = cv.block / cv.chunk;
+    if (cv.blocks > 1) ntt_parallel_for(pool, count * 2 * cv.chunks, ntt_conv_columns_forward, &cv, now);
+    ntt_parallel_for(pool, count * cv.blocks, ntt_conv_blocks, &cv, now);
+    if (cv.blocks > 1) ntt_parallel_for(pool, count * cv.chunks, ntt_conv_columns_inverse, &cv, now);
+}
+
+/**
+ * @brief Perform an in-place NTT or inverse NTT over the provided data.
+ *
+ * Runs a temporary plan and puts the spectrum back into natural order, so
+ * callers transforming many same-size arrays should hold a ttak_ntt_plan_t
+ * instead.
+ *
+ * @param data   Array of residues to transform (length must be power of two).
+ * @param n      Number of elements.
+ * @param prime  Prime modulus descriptor.
+ * @param inverse Set to true for inverse transform.
+ * @return true on success, false if parameters are invalid or the twiddle
+ *         table cannot be allocated.
+ */
+_Bool ttak_ntt_transform(uint64_t *data, size_t n, const ttak_ntt_prime_t *prime, _Bool inverse) {
+    if (!data) return false;
+    ttak_ntt_plan_t plan;
+    if (!ttak_ntt_plan_init(&plan, prime, n)) {
+        ttak_ntt_plan_destroy(&plan);
+        return false;
+    }
+    if (!inverse) {
+        ttak_ntt_plan_forward(&plan, data);
+        bit_reverse(data, n);
+    } else {
+        uint64_t mod = prime->modulus;
         for (size_t i = 0; i < n; ++i) {
-            data[i] = ttak_montgomery_mul(data[i], inv_n_mont, prime);
+            if (data[i] >= mod) data[i] %= mod;
+        }
+        bit_reverse(data, n);
+        ntt_inverse_stages(ntt_ops(&plan), &plan, data);
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = ttak_mod_mul(data[i], plan.inv_n, mod);
         }
     }
-
-    montgomery_array_restore(data, n, prime);
+    ttak_ntt_plan_destroy(&plan);
     return true;
 }
 
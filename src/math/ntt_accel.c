@@ -0,0 +1,248 @@
+/**
+ * @file ntt_accel.c
+ * @brief Backend selection and host fallback for batched NTTs.
+ *
+ * Each batch is bound to one backend when created: CUDA, then ROCm, then
+ * OpenCL, then host memory. Device backends take Montgomery-form twiddles
+ * (R = 2^64), built here once per prime and kept on the device next to the
+ * rows. A backend whose kernels fail is skipped by later batches, as in
+ * bigint_accel.c.
+ */
+
+#include <ttak/math/ntt_accel.h>
+#include <ttak/mem/mem.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+#ifndef ATOMIC_VAR_INIT
+#  define ATOMIC_VAR_INIT(x) (x)
+#endif
+
+typedef struct ttak_ntt_accel_ops {
+    bool (*alloc)(void **dev, size_t bytes);
+    void (*release)(void *dev);
+    bool (*write)(void *dev, const uint64_t *src, size_t count);
+    bool (*read)(const void *dev, uint64_t *dst, size_t count);
+    bool (*transform)(void *data, const void *twiddles, size_t n, size_t rows, uint64_t mod, uint64_t inv,
+                      uint64_t scale, bool inverse);
+    bool (*pointwise)(void *dst, const void *lhs, const void *rhs, size_t total, uint64_t mod, uint64_t inv,
+                      uint64_t r2);
+    atomic_bool *enabled;
+} ttak_ntt_accel_ops_t;
+
+struct ttak_ntt_accel_batch {
+    const ttak_ntt_accel_ops_t *ops; /* NULL for host rows. */
+    void *data;                      /* Device handle, or the host rows. */
+    void *twiddles;                  /* Device twiddles for tw_modulus. */
+    uint64_t tw_modulus;             /* Prime the twiddles belong to; 0 before the first transform. */
+    uint64_t tw_root;                /* Its primitive root. */
+    uint64_t tw_scale;               /* (1/n) R mod p for that prime. */
+    size_t n;
+    size_t count;
+};
+
+#define TTAK_NTT_ACCEL_DECLARE(P)                                                                              \
+    bool ttak_ntt_accel_##P##_alloc(void **dev, size_t bytes);                                                 \
+    void ttak_ntt_accel_##P##_free(void *dev);                                                                 \
+    bool ttak_ntt_accel_##P##_write(void *dev, const uint64_t *src, size_t count);                             \
+    bool ttak_ntt_accel_##P##_read(const void *dev, uint64_t *dst, size_t count);                              \
+    bool ttak_ntt_accel_##P##_transform(void *data, const void *twiddles, size_t n, size_t rows, uint64_t mod, \
+                                        uint64_t inv, uint64_t scale, bool inverse);                           \
+    bool ttak_ntt_accel_##P##_pointwise(void *dst, const void *lhs, const void *rhs, size_t total,             \
+                                        uint64_t mod, uint64_t inv, uint64_t r2);                              \
+    static atomic_bool g_ntt_accel_##P##_enabled = ATOMIC_VAR_INIT(true);                                      \
+    static const ttak_ntt_accel_ops_t g_ntt_accel_##P = {                                                      \
+        ttak_ntt_accel_##P##_alloc, ttak_ntt_accel_##P##_free, ttak_ntt_accel_##P##_write,                     \
+        ttak_ntt_accel_##P##_read, ttak_ntt_accel_##P##_transform, ttak_ntt_accel_##P##_pointwise,             \
+        &g_ntt_accel_##P##_enabled                                                                             \
+    };
+
+#if defined(ENABLE_CUDA)
+TTAK_NTT_ACCEL_DECLARE(cuda)
+#endif
+#if defined(ENABLE_ROCM)
+TTAK_NTT_ACCEL_DECLARE(rocm)
+#endif
+#if defined(ENABLE_OPENCL)
+TTAK_NTT_ACCEL_DECLARE(opencl)
+#endif
+
+static const ttak_ntt_accel_ops_t *const g_ntt_accel_backends[] = {
+#if defined(ENABLE_CUDA)
+    &g_ntt_accel_cuda,
+#endif
+#if defined(ENABLE_ROCM)
+    &g_ntt_accel_rocm,
+#endif
+#if defined(ENABLE_OPENCL)
+    &g_ntt_accel_opencl,
+#endif
+    NULL
+};
+
+static bool ttak_ntt_accel_enabled(const ttak_ntt_accel_ops_t *ops) {
+    return atomic_load_explicit(ops->enabled, memory_order_relaxed);
+}
+
+static bool ttak_ntt_accel_check(const ttak_ntt_accel_batch_t *batch, bool ok) {
+    if (!ok && batch->ops) atomic_store_explicit(batch->ops->enabled, false, memory_order_relaxed);
+    return ok;
+}
+
+bool ttak_ntt_accel_available(void) {
+    for (size_t i = 0; g_ntt_accel_backends[i]; ++i) {
+        if (ttak_ntt_accel_enabled(g_ntt_accel_backends[i])) return true;
+    }
+    return false;
+}
+
+ttak_ntt_accel_batch_t *ttak_ntt_accel_batch_create(size_t n, size_t count, uint64_t now) {
+    if (n == 0 || (n & (n - 1)) != 0 || count == 0) return NULL;
+    if (count > SIZE_MAX / sizeof(uint64_t) / n) return NULL;
+    ttak_ntt_accel_batch_t *batch = ttak_mem_alloc_raw(sizeof(*batch), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!batch) return NULL;
+    memset(batch, 0, sizeof(*batch));
+    batch->n = n;
+    batch->count = count;
+
+    size_t bytes = n * count * sizeof(uint64_t);
+    for (size_t i = 0; g_ntt_accel_backends[i]; ++i) {
+        const ttak_ntt_accel_ops_t *ops = g_ntt_accel_backends[i];
+        if (!ttak_ntt_accel_enabled(ops)) continue;
+        if (ops->alloc(&batch->data, bytes)) {
+            batch->ops = ops;
+            return batch;
+        }
+        atomic_store_explicit(ops->enabled, false, memory_order_relaxed);
+    }
+    batch->data = ttak_mem_alloc_raw(bytes, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!batch->data) {
+        ttak_mem_free(batch);
+        return NULL;
+    }
+    memset(batch->data, 0, bytes);
+    return batch;
+}
+
+void ttak_ntt_accel_batch_destroy(ttak_ntt_accel_batch_t *batch) {
+    if (!batch) return;
+    if (batch->ops) {
+        batch->ops->release(batch->data);
+        batch->ops->release(batch->twiddles);
+    } else {
+        ttak_mem_free(batch->data);
+    }
+    ttak_mem_free(batch);
+}
+
+bool ttak_ntt_accel_batch_on_device(const ttak_ntt_accel_batch_t *batch) {
+    return batch && batch->ops;
+}
+
+bool ttak_ntt_accel_upload(ttak_ntt_accel_batch_t *batch, const uint64_t *src) {
+    if (!batch || !src) return false;
+    size_t total = batch->n * batch->count;
+    if (!batch->ops) {
+        memcpy(batch->data, src, total * sizeof(uint64_t));
+        return true;
+    }
+    return ttak_ntt_accel_check(batch, batch->ops->write(batch->data, src, total));
+}
+
+bool ttak_ntt_accel_download(const ttak_ntt_accel_batch_t *batch, uint64_t *dst) {
+    if (!batch || !dst) return false;
+    size_t total = batch->n * batch->count;
+    if (!batch->ops) {
+        memcpy(dst, batch->data, total * sizeof(uint64_t));
+        return true;
+    }
+    return ttak_ntt_accel_check(batch, batch->ops->read(batch->data, dst, total));
+}
+
+/*
+ * Stage len (1 <= len < n) reads w_2len^j R mod p at [len + j] for the
+ * forward transform and the inverse roots at [n + len + j].
+ */
+static bool ttak_ntt_accel_twiddles(ttak_ntt_accel_batch_t *batch, const ttak_ntt_prime_t *prime) {
+    if (batch->tw_modulus == prime->modulus && batch->tw_root == prime->primitive_root) return true;
+    uint64_t mod = prime->modulus;
+    size_t n = batch->n;
+    uint64_t *host = ttak_mem_alloc_lite(2 * n * sizeof(uint64_t), __TTAK_UNSAFE_MEM_FOREVER__, 0,
+                                         TTAK_MEM_DEFAULT);
+    if (!host) return false;
+    host[0] = host[n] = 0;
+    for (size_t len = 1; len < n; len <<= 1) {
+        uint64_t root = ttak_mod_pow(prime->primitive_root, (mod - 1) / (2 * len), mod);
+        uint64_t inv_root = ttak_mod_inverse(root, mod);
+        uint64_t w = 1;
+        uint64_t w_inv = 1;
+        for (size_t j = 0; j < len; ++j) {
+            host[len + j] = ttak_montgomery_convert(w, prime);
+            host[n + len + j] = ttak_montgomery_convert(w_inv, prime);
+            w = ttak_mod_mul(w, root, mod);
+            w_inv = ttak_mod_mul(w_inv, inv_root, mod);
+        }
+    }
+    if (!batch->twiddles && !batch->ops->alloc(&batch->twiddles, 2 * n * sizeof(uint64_t))) {
+        batch->twiddles = NULL;
+        ttak_mem_free_lite(host);
+        return false;
+    }
+    bool ok = batch->ops->write(batch->twiddles, host, 2 * n);
+    ttak_mem_free_lite(host);
+    if (!ok) return false;
+    uint64_t inv_n = ttak_mod_inverse((uint64_t)n % mod, mod);
+    batch->tw_scale = ttak_montgomery_convert(inv_n, prime);
+    batch->tw_modulus = mod;
+    batch->tw_root = prime->primitive_root;
+    return true;
+}
+
+bool ttak_ntt_accel_transform(ttak_ntt_accel_batch_t *batch, const ttak_ntt_prime_t *prime, bool inverse) {
+    if (!batch || !prime) return false;
+    if (batch->n > (size_t)(1ULL << prime->max_power_two)) return false;
+    if (!batch->ops) {
+        uint64_t *rows = batch->data;
+        for (size_t i = 0; i < batch->count; ++i) {
+            if (!ttak_ntt_transform(rows + i * batch->n, batch->n, prime, inverse)) return false;
+        }
+        return true;
+    }
+    bool ok = ttak_ntt_accel_twiddles(batch, prime) &&
+              batch->ops->transform(batch->data, batch->twiddles, batch->n, batch->count, prime->modulus,
+                                    prime->montgomery_inv, batch->tw_scale, inverse);
+    return ttak_ntt_accel_check(batch, ok);
+}
+
+static bool ttak_ntt_accel_same_shape(const ttak_ntt_accel_batch_t *a, const ttak_ntt_accel_batch_t *b) {
+    return a->n == b->n && a->count == b->count && a->ops == b->ops;
+}
+
+bool ttak_ntt_accel_pointwise_mul(ttak_ntt_accel_batch_t *dst, const ttak_ntt_accel_batch_t *lhs,
+                                  const ttak_ntt_accel_batch_t *rhs, const ttak_ntt_prime_t *prime) {
+    if (!dst || !lhs || !rhs || !prime) return false;
+    if (!ttak_ntt_accel_same_shape(dst, lhs) || !ttak_ntt_accel_same_shape(dst, rhs)) return false;
+    size_t total = dst->n * dst->count;
+    if (!dst->ops) {
+        ttak_ntt_pointwise_mul(dst->data, lhs->data, rhs->data, total, prime);
+        return true;
+    }
+    bool ok = dst->ops->pointwise(dst->data, lhs->data, rhs->data, total, prime->modulus, prime->montgomery_inv,
+                                  prime->montgomery_r2);
+    return ttak_ntt_accel_check(dst, ok);
+}
+
+bool ttak_ntt_accel_pointwise_square(ttak_ntt_accel_batch_t *dst, const ttak_ntt_accel_batch_t *src,
+                                     const ttak_ntt_prime_t *prime) {
+    if (!dst || !src || !prime) return false;
+    if (!ttak_ntt_accel_same_shape(dst, src)) return false;
+    size_t total = dst->n * dst->count;
+    if (!dst->ops) {
+        ttak_ntt_pointwise_square(dst->data, src->data, total, prime);
+        return true;
+    }
+    bool ok = dst->ops->pointwise(dst->data, src->data, src->data, total, prime->modulus, prime->montgomery_inv,
+                                  prime->montgomery_r2);
+    return ttak_ntt_accel_check(dst, ok);
+}
@@ -0,0 +1,481 @@
+#include <ttak/math/prime.h>
+#include <ttak/mem/mem.h>
+
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+
+/* 3 * 5 * 7 * 11 * 13: the pre-sieve pattern repeats every this many words. */
+#define PRIME_PRESIEVE_WORDS 15015u
+#define PRIME_PRESIEVE_MAX 13u
+/* The cached base table holds the odd primes below this bound. */
+#define PRIME_BASE_LIMIT 65536u
+#define PRIME_BASE_COUNT 6541u
+
+static const uint16_t k_small_primes[] = {
+    2,  3,  5,  7, 11, 13, 17, 19, 23, 29,
+    31, 37, 41, 43, 47, 53, 59, 61, 67, 71,
+    73, 79, 83, 89, 97,101,103,107,109,113,
+    127,131,137,139,149,151,157,163,167,173,
+    179,181,191,193,197,199,211,223,227,229,
+    233,239,241,251,257,263,269,271,277,281,
+    283,293,307,311,313,317,331,337,347,349,
+    353,359,367,373,379,383,389,397,401,409,
+    419,421,431,433,439,443,449,457,461,463,
+    467,479,487,491,499,503,509,521,523,541,
+    547,557,563,569,571,577,587,593,599,601,
+    607,613,617,619,631,641,643,647,653,659,
+    661,673,677,683,691,701,709,719,727,733,
+    739,743,751,757,761,769,773,787,797,809,
+    811,821,823,827,829,839,853,857,859,863,
+    877,881,883,887,907,911,919,929,937,941,
+    947,953,967,971,977,983,991,997
+};
+
+#define PRIME_SMALL_COUNT (sizeof(k_small_primes) / sizeof(k_small_primes[0]))
+
+/*
+ * Witnesses found by Jim Sinclair; together they decide every n < 2^64.
+ * Each has at most one prime factor above TTAK_PRIME_SMALL_LIMIT, so once
+ * trial division has passed, an n dividing one of them is prime and the
+ * base can be skipped.
+ */
+static const uint64_t k_mr_bases[] = {2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL};
+
+#define PRIME_MR_BASES (sizeof(k_mr_bases) / sizeof(k_mr_bases[0]))
+
+static uint64_t g_presieve[PRIME_PRESIEVE_WORDS];
+/* p^-1 mod 2^64 and floor((2^64 - 1) / p) for the odd small primes: p | n exactly when n * inv <= lim. */
+static uint64_t g_trial_inv[PRIME_SMALL_COUNT];
+static uint64_t g_trial_lim[PRIME_SMALL_COUNT];
+static uint32_t g_base_primes[PRIME_BASE_COUNT];
+static size_t g_base_count;
+static pthread_once_t g_prime_once = PTHREAD_ONCE_INIT;
+static pthread_once_t g_trial_once = PTHREAD_ONCE_INIT;
+
+const uint16_t *ttak_prime_small_table(size_t *count_out) {
+    if (count_out) *count_out = PRIME_SMALL_COUNT;
+    return k_small_primes;
+}
+
+static uint64_t prime_isqrt(uint64_t n) {
+    uint64_t r = 0;
+    for (uint64_t bit = 1ULL << 62; bit != 0; bit >>= 2) {
+        if (n >= r + bit) {
+            n -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+    }
+    return r;
+}
+
+/*
+ * Sieves bitmap words [word0, word0 + words) into @p bits, bit j of word w
+ * standing for 2 * (64 * (word0 + w) + j) + 1. @p base holds the odd
+ * primes up to the square root of the last value, in increasing order.
+ */
+static void prime_sieve_words(uint64_t *bits, uint64_t word0, size_t words, const uint32_t *base, size_t base_count) {
+    size_t pos = (size_t)(word0 % PRIME_PRESIEVE_WORDS);
+    for (size_t done = 0; done < words;) {
+        size_t run = PRIME_PRESIEVE_WORDS - pos;
+        if (run > words - done) run = words - done;
+        memcpy(bits + done, g_presieve + pos, run * sizeof(uint64_t));
+        done += run;
+        pos = 0;
+    }
+    if (word0 == 0) {
+        /* 1 is not prime; the pre-sieved primes are. */
+        bits[0] &= ~1ULL;
+        bits[0] |= (1ULL << 1) | (1ULL << 2) | (1ULL << 3) | (1ULL << 5) | (1ULL << 6);
+    }
+
+    uint64_t first = word0 * 64;
+    uint64_t end = first + (uint64_t)words * 64;
+    for (size_t k = 0; k < base_count; ++k) {
+        uint64_t p = base[k];
+        if (p <= PRIME_PRESIEVE_MAX) continue;
+        /* Odd multiples of p sit at indices congruent to (p - 1) / 2, from p^2 at (p^2 - 1) / 2. */
+        uint64_t square = (p * p - 1) / 2;
+        if (square >= end) break;
+        uint64_t j = first + ((p - 1) / 2 + p - first % p) % p;
+        if (j < square) j = square;
+        for (j -= first; j < end - first; j += p) bits[j >> 6] &= ~(1ULL << (j & 63));
+    }
+}
+
+static void prime_build_trial(void) {
+    for (size_t i = 1; i < PRIME_SMALL_COUNT; ++i) {
+        uint64_t p = k_small_primes[i];
+        uint64_t inv = p;
+        for (int k = 0; k < 5; ++k) inv *= 2 - p * inv;
+        g_trial_inv[i] = inv;
+        g_trial_lim[i] = UINT64_MAX / p;
+    }
+}
+
+static void prime_build_tables(void) {
+    for (size_t w = 0; w < PRIME_PRESIEVE_WORDS; ++w) g_presieve[w] = ~0ULL;
+    static const uint32_t presieve_primes[] = {3, 5, 7, 11, 13};
+    for (size_t k = 0; k < sizeof(presieve_primes) / sizeof(presieve_primes[0]); ++k) {
+        uint64_t p = presieve_primes[k];
+        for (uint64_t j = (p - 1) / 2; j < (uint64_t)PRIME_PRESIEVE_WORDS * 64; j += p) {
+            g_presieve[j >> 6] &= ~(1ULL << (j & 63));
+        }
+    }
+
+    /* Every composite below 2^16 has a factor below 2^8, which the small table covers. */
+    uint32_t seed[PRIME_SMALL_COUNT];
+    size_t seed_count = 0;
+    for (size_t i = 1; i < PRIME_SMALL_COUNT && k_small_primes[i] < 256; ++i) seed[seed_count++] = k_small_primes[i];
+    static uint64_t bits[PRIME_BASE_LIMIT / 128];
+    prime_sieve_words(bits, 0, PRIME_BASE_LIMIT / 128, seed, seed_count);
+    for (uint64_t i = 1; i < PRIME_BASE_LIMIT / 2; ++i) {
+        if ((bits[i >> 6] >> (i & 63)) & 1u) g_base_primes[g_base_count++] = (uint32_t)(2 * i + 1);
+    }
+}
+
+/* The sieve tables; the primality tests only need prime_trial_init(). */
+static void prime_init(void) {
+    pthread_once(&g_prime_once, prime_build_tables);
+}
+
+static void prime_trial_init(void) {
+    pthread_once(&g_trial_once, prime_build_trial);
+}
+
+uint64_t *ttak_prime_odd_bits(uint64_t limit, uint64_t now) {
+    prime_init();
+    uint64_t slots = limit / 2 + 1;
+    size_t words = (size_t)((slots + 63) / 64);
+    uint64_t *bits = ttak_mem_alloc_raw(words * sizeof(uint64_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!bits) return NULL;
+
+    uint64_t root = prime_isqrt(limit);
+    uint32_t *base = g_base_primes;
+    size_t base_count = g_base_count;
+    if (root >= PRIME_BASE_LIMIT) {
+        base = ttak_prime_odd_list((uint32_t)root, &base_count, now);
+        if (!base) {
+            ttak_mem_free(bits);
+            return NULL;
+        }
+    }
+    for (size_t w = 0; w < words; w += TTAK_PRIME_SIEVE_SEGMENT_WORDS) {
+        size_t span = words - w < TTAK_PRIME_SIEVE_SEGMENT_WORDS ? words - w : TTAK_PRIME_SIEVE_SEGMENT_WORDS;
+        prime_sieve_words(bits + w, w, span, base, base_count);
+    }
+    if (base != g_base_primes) ttak_mem_free(base);
+
+    /* Clear the slots past @p limit, including 1 when @p limit is 0. */
+    uint64_t valid = limit ? (limit - 1) / 2 + 1 : 0;
+    for (uint64_t i = valid; i < (uint64_t)words * 64; ++i) bits[i >> 6] &= ~(1ULL << (i & 63));
+    return bits;
+}
+
+uint32_t *ttak_prime_odd_list(uint32_t limit, size_t *count_out, uint64_t now) {
+    prime_init();
+    if (limit < PRIME_BASE_LIMIT) {
+        size_t lo = 0, hi = g_base_count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (g_base_primes[mid] <= limit) lo = mid + 1;
+            else hi = mid;
+        }
+        uint32_t *primes = ttak_mem_alloc_raw((lo ? lo : 1) * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (!primes) return NULL;
+        memcpy(primes, g_base_primes, lo * sizeof(uint32_t));
+        if (count_out) *count_out = lo;
+        return primes;
+    }
+
+    /* pi(x) < 1.25506 x / ln x bounds the list; sqrt(limit) < 2^16 lets the cached table sieve it. */
+    size_t cap = (size_t)(1.25506 * (double)limit / log((double)limit)) + 1;
+    uint32_t *primes = ttak_mem_alloc_raw(cap * sizeof(uint32_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    uint64_t *seg = ttak_mem_alloc_raw(TTAK_PRIME_SIEVE_SEGMENT_WORDS * sizeof(uint64_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!primes || !seg) {
+        if (primes) ttak_mem_free(primes);
+        if (seg) ttak_mem_free(seg);
+        return NULL;
+    }
+    uint64_t slots = (uint64_t)(limit - 1) / 2 + 1;
+    uint64_t words = (slots + 63) / 64;
+    size_t count = 0;
+    for (uint64_t w = 0; w < words; w += TTAK_PRIME_SIEVE_SEGMENT_WORDS) {
+        size_t span = words - w < TTAK_PRIME_SIEVE_SEGMENT_WORDS ? (size_t)(words - w) : TTAK_PRIME_SIEVE_SEGMENT_WORDS;
+        prime_sieve_words(seg, w, span, g_base_primes, g_base_count);
+        for (size_t k = 0; k < span; ++k) {
+            for (uint64_t word = seg[k]; word; word &= word - 1) {
+                uint64_t i = 64 * (w + k) + (uint64_t)__builtin_ctzll(word);
+                if (i >= slots) break;
+                if (i > 0) primes[count++] = (uint32_t)(2 * i + 1);
+            }
+        }
+    }
+    ttak_mem_free(seg);
+    if (count_out) *count_out = count;
+    return primes;
+}
+
+struct ttak_prime_sieve {
+    uint64_t next;        /* Next odd index to report. */
+    uint64_t end;         /* One past the last odd index of the range. */
+    bool two;             /* 2 is in range and not yet reported. */
+    uint32_t *base;
+    size_t base_count;
+    uint64_t seg_word;    /* First word held in seg. */
+    size_t seg_words;     /* Words of seg sieved; 0 before the first segment. */
+    uint64_t seg[TTAK_PRIME_SIEVE_SEGMENT_WORDS];
+};
+
+ttak_prime_sieve_t *ttak_prime_sieve_create(uint64_t lo, uint64_t hi, uint64_t now) {
+    prime_init();
+    ttak_prime_sieve_t *sieve = ttak_mem_alloc_raw(sizeof(*sieve), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!sieve) return NULL;
+    memset(sieve, 0, sizeof(*sieve));
+    sieve->two = lo <= 2 && hi > 2;
+    if (hi > 3) {
+        uint64_t first = lo < 3 ? 3 : lo | 1;
+        uint64_t last = (hi - 1) & 1 ? hi - 1 : hi - 2;
+        if (first <= last) {
+            sieve->next = (first - 1) / 2;
+            sieve->end = (last - 1) / 2 + 1;
+        }
+    }
+    uint64_t root = sieve->end ? prime_isqrt(2 * (sieve->end - 1) + 1) : 0;
+    sieve->base = ttak_prime_odd_list((uint32_t)root, &sieve->base_count, now);
+    if (!sieve->base) {
+        ttak_mem_free(sieve);
+        return NULL;
+    }
+    return sieve;
+}
+
+size_t ttak_prime_sieve_next(ttak_prime_sieve_t *sieve, uint64_t *out, size_t cap) {
+    if (!sieve || !out) return 0;
+    size_t n = 0;
+    if (sieve->two && cap > 0) {
+        out[n++] = 2;
+        sieve->two = false;
+    }
+    while (n < cap && sieve->next < sieve->end) {
+        uint64_t word = sieve->next >> 6;
+        if (sieve->seg_words == 0 || word < sieve->seg_word || word >= sieve->seg_word + sieve->seg_words) {
+            uint64_t last_word = (sieve->end - 1) >> 6;
+            uint64_t span = last_word - word + 1;
+            sieve->seg_word = word;
+            sieve->seg_words = span < TTAK_PRIME_SIEVE_SEGMENT_WORDS ? (size_t)span : TTAK_PRIME_SIEVE_SEGMENT_WORDS;
+            prime_sieve_words(sieve->seg, word, sieve->seg_words, sieve->base, sieve->base_count);
+        }
+        uint64_t seg_end = (sieve->seg_word + sieve->seg_words) * 64;
+        if (seg_end > sieve->end) seg_end = sieve->end;
+        while (n < cap && sieve->next < seg_end) {
+            uint64_t i = sieve->next;
+            uint64_t bits = sieve->seg[(i >> 6) - sieve->seg_word] >> (i & 63);
+            if (bits == 0) {
+                sieve->next = (i | 63) + 1;
+                continue;
+            }
+            i += (uint64_t)__builtin_ctzll(bits);
+            if (i >= seg_end) {
+                sieve->next = seg_end;
+                break;
+            }
+            out[n++] = 2 * i + 1;
+            sieve->next = i + 1;
+        }
+        if (sieve->next > sieve->end) sieve->next = sieve->end;
+    }
+    return n;
+}
+
+void ttak_prime_sieve_destroy(ttak_prime_sieve_t *sieve) {
+    if (!sieve) return;
+    ttak_mem_free(sieve->base);
+    ttak_mem_free(sieve);
+}
+
+/* Low 64 bits of a * b, high half in @p hi. */
+static inline uint64_t prime_mul_wide(uint64_t a, uint64_t b, uint64_t *hi) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t t = (__uint128_t)a * b;
+    *hi = (uint64_t)(t >> 64);
+    return (uint64_t)t;
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32, b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+    uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return (mid << 32) | (uint32_t)ll;
+#endif
+}
+
+/* Montgomery constants for one odd modulus, R = 2^64. */
+typedef struct {
+    uint64_t n;
+    uint64_t neg_inv;   /* -n^-1 mod 2^64 */
+    uint64_t one;       /* R mod n */
+    uint64_t minus_one; /* -R mod n */
+    uint64_t r2;        /* R^2 mod n */
+} prime_monty_t;
+
+static inline uint64_t prime_monty_reduce(const prime_monty_t *m, uint64_t lo, uint64_t hi) {
+    uint64_t q = lo * m->neg_inv;
+    uint64_t q_hi;
+    uint64_t q_lo = prime_mul_wide(q, m->n, &q_hi);
+    /* lo + q_lo is 0 mod 2^64 and carries exactly when lo is not 0. */
+    uint64_t carry = (q_lo + lo) < lo;
+    uint64_t res = hi + q_hi;
+    bool over = res < hi;
+    res += carry;
+    over |= res < carry;
+    /* Moduli above 2^63 can carry the sum past 64 bits. */
+    return (over || res >= m->n) ? res - m->n : res;
+}
+
+static inline uint64_t prime_monty_mul(const prime_monty_t *m, uint64_t a, uint64_t b) {
+    uint64_t hi;
+    uint64_t lo = prime_mul_wide(a, b, &hi);
+    return prime_monty_reduce(m, lo, hi);
+}
+
+static void prime_monty_init(prime_monty_t *m, uint64_t n) {
+    uint64_t inv = n; /* Correct to 3 bits for odd n; each step doubles that. */
+    for (int i = 0; i < 5; ++i) inv *= 2 - n * inv;
+    m->n = n;
+    m->neg_inv = 0 - inv;
+    m->one = (0 - n) % n;
+    m->minus_one = n - m->one;
+#if defined(__SIZEOF_INT128__)
+    m->r2 = (uint64_t)(((__uint128_t)m->one * m->one) % n);
+#else
+    uint64_t r2 = m->one;
+    for (int i = 0; i < 64; ++i) r2 = (r2 >= n - r2) ? r2 - (n - r2) : r2 + r2;
+    m->r2 = r2;
+#endif
+}
+
+/* 1 if @p n is prime, 0 if composite, -1 when trial division leaves it open. */
+static int prime_trial(uint64_t n) {
+    if (n < 2) return 0;
+    if ((n & 1u) == 0) return n == 2;
+    for (size_t i = 1; i < PRIME_SMALL_COUNT; ++i) {
+        uint64_t p = k_small_primes[i];
+        if (p * p > n) return 1;
+        if (n * g_trial_inv[i] <= g_trial_lim[i]) return n == p;
+    }
+    return -1;
+}
+
+/*
+ * Miller-Rabin with witnesses [first, last) on @p lanes odd moduli past
+ * trial division; pass[l] stays true only if every witness passes. Each
+ * witness runs one left-to-right ladder across all lanes for the longest
+ * exponent. Lanes start from R mod n, which leading zero bits only square,
+ * so the lanes stay in lockstep without branching on their own exponents.
+ */
+static void prime_mr_lanes(const prime_monty_t *m, size_t lanes, size_t first, size_t last, bool *pass) {
+    uint64_t d[TTAK_PRIME_BATCH_LANES];
+    uint32_t s[TTAK_PRIME_BATCH_LANES];
+    uint64_t d_max = 0;
+    uint32_t s_max = 0;
+    for (size_t l = 0; l < lanes; ++l) {
+        d[l] = m[l].n - 1;
+        s[l] = (uint32_t)__builtin_ctzll(d[l]);
+        d[l] >>= s[l];
+        pass[l] = true;
+        if (d[l] > d_max) d_max = d[l];
+        if (s[l] > s_max) s_max = s[l];
+    }
+    int top = 63 - __builtin_clzll(d_max);
+
+    for (size_t b = first; b < last; ++b) {
+        uint64_t a[TTAK_PRIME_BATCH_LANES];
+        uint64_t x[TTAK_PRIME_BATCH_LANES];
+        bool ok[TTAK_PRIME_BATCH_LANES];
+        bool live = false;
+        for (size_t l = 0; l < lanes; ++l) {
+            uint64_t base = k_mr_bases[b] % m[l].n;
+            ok[l] = !pass[l] || base == 0;
+            live |= !ok[l];
+            a[l] = prime_monty_mul(&m[l], base, m[l].r2);
+            x[l] = m[l].one;
+        }
+        if (!live) continue;
+        for (int bit = top; bit >= 0; --bit) {
+            for (size_t l = 0; l < lanes; ++l) {
+                uint64_t sq = prime_monty_mul(&m[l], x[l], x[l]);
+                uint64_t step = prime_monty_mul(&m[l], sq, a[l]);
+                x[l] = ((d[l] >> bit) & 1u) ? step : sq;
+            }
+        }
+        for (size_t l = 0; l < lanes; ++l) ok[l] |= x[l] == m[l].one || x[l] == m[l].minus_one;
+        for (uint32_t r = 1; r < s_max; ++r) {
+            for (size_t l = 0; l < lanes; ++l) {
+                x[l] = prime_monty_mul(&m[l], x[l], x[l]);
+                ok[l] |= r < s[l] && x[l] == m[l].minus_one;
+            }
+        }
+        for (size_t l = 0; l < lanes; ++l) pass[l] = pass[l] && ok[l];
+    }
+}
+
+bool ttak_is_prime_u64(uint64_t n) {
+    prime_trial_init();
+    int trial = prime_trial(n);
+    if (trial >= 0) return trial == 1;
+    prime_monty_t m;
+    prime_monty_init(&m, n);
+    bool pass;
+    for (size_t b = 0; b < PRIME_MR_BASES; ++b) {
+        prime_mr_lanes(&m, 1, b, b + 1, &pass);
+        if (!pass) return false;
+    }
+    return true;
+}
+
+/* Values ttak_is_prime_u64_batch() stages at a time between its two Miller-Rabin passes. */
+#define PRIME_BATCH_CHUNK 256
+
+/* Runs witnesses [first, last) over @p count staged moduli and keeps the survivors, in order. */
+static size_t prime_mr_filter(prime_monty_t *m, size_t *slot, size_t count, size_t first, size_t last) {
+    size_t kept = 0;
+    for (size_t g = 0; g < count; g += TTAK_PRIME_BATCH_LANES) {
+        size_t lanes = count - g < TTAK_PRIME_BATCH_LANES ? count - g : TTAK_PRIME_BATCH_LANES;
+        bool pass[TTAK_PRIME_BATCH_LANES];
+        prime_mr_lanes(m + g, lanes, first, last, pass);
+        for (size_t l = 0; l < lanes; ++l) {
+            if (!pass[l]) continue;
+            m[kept] = m[g + l];
+            slot[kept++] = slot[g + l];
+        }
+    }
+    return kept;
+}
+
+void ttak_is_prime_u64_batch(const uint64_t *values, size_t count, bool *prime_out) {
+    if (!values || !prime_out) return;
+    prime_trial_init();
+    prime_monty_t m[PRIME_BATCH_CHUNK];
+    size_t slot[PRIME_BATCH_CHUNK];
+    for (size_t base = 0; base < count; base += PRIME_BATCH_CHUNK) {
+        size_t end = count - base < PRIME_BATCH_CHUNK ? count : base + PRIME_BATCH_CHUNK;
+        size_t open = 0;
+        for (size_t i = base; i < end; ++i) {
+            int trial = prime_trial(values[i]);
+            prime_out[i] = trial == 1;
+            if (trial >= 0) continue;
+            prime_monty_init(&m[open], values[i]);
+            slot[open++] = i;
+        }
+        /*
+         * Base 2 rejects nearly every composite, so the survivors are
+         * regrouped before the other witnesses rather than carrying dead
+         * lanes through them.
+         */
+        open = prime_mr_filter(m, slot, open, 0, 1);
+        open = prime_mr_filter(m, slot, open, 1, PRIME_MR_BASES);
+        for (size_t k = 0; k < open; ++k) prime_out[slot[k]] = true;
+    }
+}
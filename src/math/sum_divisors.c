@@ -1,7 +1,12 @@
 #include <ttak/math/sum_divisors.h>
 #include <ttak/math/factor.h>
+#include <ttak/math/prime.h>
 #include <ttak/mem/mem.h>
 #include <ttak/types/fixed.h>
+#include "../../internal/ttak/factor_internal.h"
+
+#include <math.h>
+#include <stdatomic.h>
 
 #if defined(__TINYC__)
 #define SUMDIV_THREAD_LOCAL
@@ -335,6 +340,129 @@ bool ttak_sum_proper_divisors_u64(uint64_t n, uint64_t *result_out) {
     return true;
 }
 
+typedef struct {
+    uint64_t start;
+    size_t count;
+    ttak_u128_t *sigma;
+    const uint32_t *primes; /* Odd primes up to limit. */
+    size_t prime_count;
+    uint64_t limit;         /* Sieving bound; cofactors below (limit + 1)^2 are prime. */
+    uint64_t now;
+    atomic_bool failed;
+} sumdiv_range_ctx_t;
+
+/* p^-1 mod 2^64 for odd p, by Newton's iteration. */
+static uint64_t sumdiv_inverse_u64(uint64_t p) {
+    uint64_t x = p;
+    for (int i = 0; i < 5; ++i) x *= 2 - p * x;
+    return x;
+}
+
+static ttak_u128_t sumdiv_mul_u128(ttak_u128_t a, ttak_u128_t b) {
+    return ttak_u256_extract_low(ttak_u128_mul_u128(a, b));
+}
+
+static void sumdiv_range_segment(void *arg, size_t index) {
+    sumdiv_range_ctx_t *ctx = arg;
+    size_t off = index * TTAK_SUMDIV_RANGE_SEGMENT;
+    size_t len = ctx->count - off < TTAK_SUMDIV_RANGE_SEGMENT ? ctx->count - off : TTAK_SUMDIV_RANGE_SEGMENT;
+    uint64_t lo = ctx->start + off;
+    ttak_u128_t *sig = ctx->sigma + off;
+
+    /* rem[i] is what remains of lo + i once the primes so far are divided out. */
+    uint64_t *rem = ttak_mem_alloc_raw(len * sizeof(uint64_t), __TTAK_UNSAFE_MEM_FOREVER__, ctx->now);
+    if (!rem) {
+        atomic_store(&ctx->failed, true);
+        return;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        rem[i] = lo + i;
+        sig[i] = ttak_u128_from_u64(1);
+    }
+    for (size_t i = lo & 1; i < len; i += 2) {
+        unsigned tz = (unsigned)__builtin_ctzll(rem[i]);
+        rem[i] >>= tz;
+        /* 2^(tz + 1) - 1; at tz = 63 the shift wraps to 0 and the result to 2^64 - 1. */
+        sig[i] = ttak_u128_from_u64((2ULL << tz) - 1);
+    }
+    for (size_t k = 0; k < ctx->prime_count; ++k) {
+        uint64_t p = ctx->primes[k];
+        uint64_t r = lo % p;
+        size_t i = r ? (size_t)(p - r) : 0;
+        if (i >= len) continue;
+        /* v * p^-1 <= UINT64_MAX / p exactly when p divides v, and is then v / p. */
+        uint64_t inv = sumdiv_inverse_u64(p);
+        uint64_t lim = UINT64_MAX / p;
+        for (; i < len; i += p) {
+            uint64_t v = rem[i] * inv;
+            uint64_t pk = p;
+            ttak_u128_t term = ttak_u128_from_u64(1 + p);
+            uint64_t q;
+            while ((q = v * inv) <= lim) {
+                v = q;
+                pk *= p;
+                term = ttak_u128_add64(term, pk);
+            }
+            rem[i] = v;
+            sig[i] = sumdiv_mul_u128(sig[i], term);
+        }
+    }
+    /*
+     * What is left has no prime factor up to the limit: a single prime when
+     * below (limit + 1)^2, otherwise a product of a few large primes.
+     */
+    for (size_t i = 0; i < len; ++i) {
+        uint64_t v = rem[i];
+        if (v <= 1) continue;
+        if (v / (ctx->limit + 1) <= ctx->limit) {
+            sig[i] = sumdiv_mul_u128(sig[i], ttak_u128_add64(ttak_u128_from_u64(v), 1));
+            continue;
+        }
+        ttak_prime_factor_t *factors = NULL;
+        size_t count = 0;
+        ttak_u128_t term;
+        bool ok = ttak_factor_u64(v, &factors, &count, ctx->now) == 0 &&
+                  compute_sigma_u64_lane(factors, count, &term);
+        ttak_mem_free(factors);
+        if (!ok) {
+            atomic_store(&ctx->failed, true);
+            break;
+        }
+        sig[i] = sumdiv_mul_u128(sig[i], term);
+    }
+    ttak_mem_free(rem);
+}
+
+static uint64_t sumdiv_isqrt(uint64_t n) {
+    uint64_t r = (uint64_t)sqrt((double)n);
+    while (r > 0 && (r > UINT32_MAX || r * r > n)) --r;
+    while (r < UINT32_MAX && (r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+bool ttak_sum_divisors_range(uint64_t start, size_t count, ttak_u128_t *sigma_out, ttak_thread_pool_t *pool,
+                             uint64_t now) {
+    if (start == 0 || !sigma_out) return false;
+    if (count == 0) return true;
+    if ((uint64_t)count - 1 > UINT64_MAX - start) return false;
+
+    sumdiv_range_ctx_t ctx = { .start = start, .count = count, .sigma = sigma_out, .now = now };
+    atomic_init(&ctx.failed, false);
+    uint64_t limit = sumdiv_isqrt(start + (count - 1));
+    if (limit > TTAK_SUMDIV_RANGE_SIEVE_MAX_PRIME) limit = TTAK_SUMDIV_RANGE_SIEVE_MAX_PRIME;
+    size_t found = 0;
+    uint32_t *primes = ttak_prime_odd_list((uint32_t)limit, &found, now);
+    if (!primes) return false;
+    ctx.primes = primes;
+    ctx.prime_count = found;
+    ctx.limit = limit;
+
+    size_t segments = (count + TTAK_SUMDIV_RANGE_SEGMENT - 1) / TTAK_SUMDIV_RANGE_SEGMENT;
+    ttak_factor_parallel_for(pool, segments, sumdiv_range_segment, &ctx, now);
+    ttak_mem_free(primes);
+    return !atomic_load(&ctx.failed);
+}
+
 static bool sum_proper_divisors_big_impl(const ttak_bigint_t *n, ttak_bigint_t *result_out,
                                          uint64_t now, bool safe_mode, size_t bitlen) {
     if (!safe_mode &&
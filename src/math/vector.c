@@ -89,6 +89,67 @@ bool ttak_vector_set(tt_shared_vector_t *sv, tt_owner_t *owner, uint8_t index, c
     return ok;
 }
 
+bool ttak_vector_set_all(tt_shared_vector_t *sv, tt_owner_t *owner, const ttak_bigreal_t *vals, size_t count, uint64_t now) {
+    if (!sv || !owner || !vals) return false;
+
+    ttak_shared_result_t res;
+    ttak_vector_t *v = (ttak_vector_t *)sv->base.access(&sv->base, owner, &res);
+    if (!v) return false;
+
+    bool ok = count == v->dim;
+    for (size_t i = 0; ok && i < count; i++) {
+        ok = ttak_bigreal_copy(&v->elements[i], &vals[i], now);
+    }
+    sv->base.release(&sv->base);
+    return ok;
+}
+
+bool ttak_vector_get_all(tt_shared_vector_t *sv, tt_owner_t *owner, ttak_bigreal_t *out, size_t count, uint64_t now) {
+    if (!sv || !owner || !out) return false;
+
+    ttak_shared_result_t res;
+    ttak_vector_t *v = (ttak_vector_t *)sv->base.access(&sv->base, owner, &res);
+    if (!v) return false;
+
+    bool ok = count == v->dim;
+    for (size_t i = 0; ok && i < count; i++) {
+        ok = ttak_bigreal_copy(&out[i], &v->elements[i], now);
+    }
+    sv->base.release(&sv->base);
+    return ok;
+}
+
+bool ttak_vector_export_f64(tt_shared_vector_t *sv, tt_owner_t *owner, ttak_vec4d_t *out) {
+    if (!sv || !owner || !out) return false;
+
+    ttak_shared_result_t res;
+    ttak_vector_t *v = (ttak_vector_t *)sv->base.access(&sv->base, owner, &res);
+    if (!v) return false;
+
+    bool ok = true;
+    for (uint8_t i = 0; i < 4; i++) {
+        out->v[i] = 0.0;
+        if (i < v->dim) ok &= ttak_bigreal_to_double(&v->elements[i], &out->v[i]);
+    }
+    sv->base.release(&sv->base);
+    return ok;
+}
+
+bool ttak_vector_import_f64(tt_shared_vector_t *sv, tt_owner_t *owner, const ttak_vec4d_t *in, uint64_t now) {
+    if (!sv || !owner || !in) return false;
+
+    ttak_shared_result_t res;
+    ttak_vector_t *v = (ttak_vector_t *)sv->base.access(&sv->base, owner, &res);
+    if (!v) return false;
+
+    bool ok = true;
+    for (uint8_t i = 0; ok && i < v->dim; i++) {
+        ok = ttak_bigreal_set_double(&v->elements[i], in->v[i], now);
+    }
+    sv->base.release(&sv->base);
+    return ok;
+}
+
 bool ttak_vector_dot(ttak_bigreal_t *res, tt_shared_vector_t *a, tt_shared_vector_t *b, tt_owner_t *owner, uint64_t now) {
     if (!res || !a || !b || !owner) return false;
     
@@ -4,6 +4,11 @@
  *
  * Provides convenience wrappers that create, grow, and destroy arenas
  * while keeping the mem-tree node index consistent.
+ *
+ * Laned generations give each worker its own bump pointer. A lane refills
+ * from the generation buffer through one atomic add and, once that is
+ * spent, from buffers allocated and registered through the env, so the
+ * common claim path is a thread-private pointer bump.
  */
 
 #include <ttak/mem/arena_helper.h>
@@ -11,6 +16,7 @@
 #include <ttak/mem_tree/mem_tree.h>
 #include <ttak/timing/timing.h>
 #include <ttak/mem/fastpath.h>
+#include <ttak/types/ttak_compiler.h>
 
 #include <string.h>
 #include <stdint.h>
@@ -60,6 +66,7 @@ void ttak_arena_env_config_init(ttak_arena_env_config_t *config) {
     config->chunk_bytes = 128;
     config->alloc_flags = TTAK_MEM_CACHE_ALIGNED | TTAK_MEM_STRICT_CHECK;
     config->lifetime_ticks = __TTAK_UNSAFE_MEM_FOREVER__;
+    config->lane_refill_bytes = 1024;
 }
 
 static void clamp_config(ttak_arena_env_config_t *config) {
@@ -75,6 +82,10 @@ static void clamp_config(ttak_arena_env_config_t *config) {
     if (!config->lifetime_ticks) {
         config->lifetime_ticks = __TTAK_UNSAFE_MEM_FOREVER__;
     }
+    if (!config->lane_refill_bytes) {
+        config->lane_refill_bytes = config->generation_bytes / 4 ? config->generation_bytes / 4 : config->generation_bytes;
+    }
+    config->lane_refill_bytes = ttak_cacheline_pad(config->lane_refill_bytes);
 }
 
 bool ttak_arena_env_init(ttak_arena_env_t *env, const ttak_arena_env_config_t *config) {
@@ -135,17 +146,122 @@ bool ttak_arena_generation_begin(ttak_arena_env_t *env, ttak_arena_generation_t
     generation->capacity = buffer_bytes;
     generation->used = 0;
     generation->epoch_id = epoch_id;
+    generation->lanes = NULL;
+    generation->lane_count = 0;
+    atomic_store_explicit(&generation->lane_cursor, 0, memory_order_relaxed);
 
     ttak_epoch_gc_register(env->gc, buffer, buffer_bytes);
     return true;
 }
 
+bool ttak_arena_generation_begin_lanes(ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                                       uint32_t epoch_id, uint32_t lane_count) {
+    if (!lane_count || !ttak_arena_generation_begin(env, generation, epoch_id)) {
+        return false;
+    }
+
+    size_t lanes_bytes = (size_t)lane_count * sizeof(ttak_arena_lane_t);
+    ttak_arena_lane_t *lanes = (ttak_arena_lane_t *)ttak_mem_alloc_with_flags_raw(
+        lanes_bytes, __TTAK_UNSAFE_MEM_FOREVER__, ttak_get_tick_count(), TTAK_MEM_CACHE_ALIGNED);
+    if (!lanes) {
+        ttak_arena_generation_retire(env, generation);
+        return false;
+    }
+    ttak_mem_stream_zero(lanes, lanes_bytes);
+
+    generation->lanes = lanes;
+    generation->lane_count = lane_count;
+    return true;
+}
+
+/**
+ * @brief Header in the first cache line of a lane overflow buffer.
+ */
+typedef struct ttak_arena_refill {
+    struct ttak_arena_refill *next;
+    size_t bytes;
+} ttak_arena_refill_t;
+
+/**
+ * @brief Drops the mem-tree reference of a registered buffer.
+ */
+static bool arena_release_buffer(ttak_arena_env_t *env, void *buffer, size_t bytes) {
+    ttak_mem_node_t *node = ttak_mem_tree_find_node(&env->gc->tree, buffer);
+    if (!node) {
+        return false;
+    }
+    ttak_mem_node_release(node);
+    ttak_mem_tree_report_pressure(&env->gc->tree, bytes);
+    return true;
+}
+
+/**
+ * @brief Points @p lane at a fresh region of at least @p need bytes.
+ *
+ * Carves the generation buffer while it lasts; afterwards allocates a
+ * buffer through the env whose first cache line links it into the lane's
+ * refill chain for retirement.
+ */
+static bool arena_lane_refill(ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                              ttak_arena_lane_t *lane, size_t need) {
+    size_t want = env->config.lane_refill_bytes > need ? env->config.lane_refill_bytes : need;
+
+    if (atomic_load_explicit(&generation->lane_cursor, memory_order_relaxed) < generation->capacity) {
+        size_t offset = atomic_fetch_add_explicit(&generation->lane_cursor, want, memory_order_relaxed);
+        if (offset + want <= generation->capacity) {
+            lane->cursor = (uint8_t *)generation->base + offset;
+            lane->limit = lane->cursor + want;
+            return true;
+        }
+    }
+
+    size_t buffer_bytes = TTAK_CACHE_LINE_SIZE + want;
+    uint8_t *buffer = (uint8_t *)ttak_mem_alloc_with_flags_raw(buffer_bytes, env->config.lifetime_ticks,
+                                                               ttak_get_tick_count(), env->config.alloc_flags);
+    if (!buffer) {
+        return false;
+    }
+    ttak_epoch_gc_register(env->gc, buffer, buffer_bytes);
+
+    ttak_arena_refill_t *refill = (ttak_arena_refill_t *)buffer;
+    refill->next = (ttak_arena_refill_t *)lane->refills;
+    refill->bytes = buffer_bytes;
+    lane->refills = refill;
+    lane->cursor = buffer + TTAK_CACHE_LINE_SIZE;
+    lane->limit = lane->cursor + want;
+    return true;
+}
+
+void *ttak_arena_generation_claim_lane(ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                                       uint32_t lane, size_t bytes) {
+    if (!env || !env->gc || !generation || !generation->lanes) {
+        return NULL;
+    }
+
+    size_t chunk = bytes ? bytes : env->config.chunk_bytes;
+    if (!chunk) {
+        return NULL;
+    }
+    size_t aligned_chunk = ttak_cacheline_pad(chunk);
+
+    ttak_arena_lane_t *self = &generation->lanes[lane % generation->lane_count];
+    if (TTAK_UNLIKELY((size_t)(self->limit - self->cursor) < aligned_chunk)) {
+        if (!arena_lane_refill(env, generation, self, aligned_chunk)) {
+            return NULL;
+        }
+    }
+
+    uint8_t *slot = self->cursor;
+    self->cursor += aligned_chunk;
+    return slot;
+}
+
 void ttak_arena_generation_reset(ttak_arena_generation_t *generation) {
     Arena_Reset_Routine(generation);
 }
 
 void *ttak_arena_generation_claim(ttak_arena_env_t *env, ttak_arena_generation_t *generation, size_t bytes) {
-    if (!env || !generation || !generation->base) {
+    if (!env || !generation || !generation->base || generation->lanes) {
         return NULL;
     }
 
@@ -169,11 +285,17 @@ void *ttak_arena_generation_claim(ttak_arena_env_t *env, ttak_arena_generation_t
 }
 
 size_t ttak_arena_generation_remaining(const ttak_arena_generation_t *generation) {
-    if (!generation || !generation->base || generation->used > generation->capacity) {
+    if (!generation || !generation->base) {
         return 0;
     }
 
-    return generation->capacity - generation->used;
+    size_t used = generation->lanes
+        ? atomic_load_explicit(&((ttak_arena_generation_t *)generation)->lane_cursor, memory_order_relaxed)
+        : generation->used;
+    if (used > generation->capacity) {
+        return 0;
+    }
+    return generation->capacity - used;
 }
 
 bool ttak_arena_generation_retire(ttak_arena_env_t *env, ttak_arena_generation_t *generation) {
@@ -183,17 +305,26 @@ bool ttak_arena_generation_retire(ttak_arena_env_t *env, ttak_arena_generation_t
 
     bool released = false;
     if (env->gc) {
-        ttak_mem_node_t *node = ttak_mem_tree_find_node(&env->gc->tree, generation->base);
-        if (node) {
-            ttak_mem_node_release(node);
-            ttak_mem_tree_report_pressure(&env->gc->tree, generation->capacity);
-            released = true;
+        released = arena_release_buffer(env, generation->base, generation->capacity);
+        for (uint32_t i = 0; i < generation->lane_count; i++) {
+            ttak_arena_refill_t *refill = (ttak_arena_refill_t *)generation->lanes[i].refills;
+            while (refill) {
+                ttak_arena_refill_t *next = refill->next;
+                arena_release_buffer(env, refill, refill->bytes);
+                refill = next;
+            }
         }
     }
+    if (generation->lanes) {
+        ttak_mem_free(generation->lanes);
+    }
 
     generation->base = NULL;
     generation->capacity = 0;
     generation->used = 0;
+    generation->lanes = NULL;
+    generation->lane_count = 0;
+    atomic_store_explicit(&generation->lane_cursor, 0, memory_order_relaxed);
     return released;
 }
 
@@ -5,6 +5,11 @@
  * Detachable allocations can be handed off across ownership boundaries
  * by transferring a generation ticket.  A per-CPU cache ring minimises
  * lock contention on the hot path.
+ *
+ * Besides the tiny-chunk cache, each context keeps a depot per large size
+ * class (4 KiB..1 MiB). Buffers in a class are always allocated at the
+ * full class size, so any request in the class can reuse them; explicit
+ * front caches let one thread recycle them without the depot lock.
  */
 
 #include <ttak/mem/detachable.h>
@@ -67,8 +72,8 @@ static bool ttak_detachable_quarantine_push(ttak_detachable_context_t *ctx, void
 static void ttak_detachable_track_pointer(ttak_detachable_context_t *ctx, void *ptr);
 static bool ttak_detachable_untrack_pointer(ttak_detachable_context_t *ctx, void *ptr);
 static bool ttak_detachable_cache_store(ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache, void *ptr, size_t size);
-static void *ttak_detachable_cache_take(ttak_detachable_cache_t *cache, size_t requested);
-static void ttak_detachable_cache_drain(ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache, bool release_storage);
+static void *ttak_detachable_cache_take(ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache, size_t requested);
+static size_t ttak_detachable_cache_drain(ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache, bool release_storage);
 typedef enum {
     TTAK_DETACHABLE_MODE_STANDARD = 0,
     TTAK_DETACHABLE_MODE_DETACHED = 1
@@ -84,10 +89,64 @@ static void ttak_detachable_signal_handler(int signo);
 static int ttak_hard_kill_configure(sigset_t signals, int *ret, _Bool graceful);
 #endif
 
+/** @brief Depot slots per size class; larger classes keep fewer buffers. */
+static const size_t g_detachable_class_slots[TTAK_DETACHABLE_SIZE_CLASSES] = {32, 16, 8, 4, 2};
+
+static inline size_t ttak_detachable_class_bytes(size_t cls) {
+    return (size_t)1 << (TTAK_DETACHABLE_CLASS_MIN_SHIFT + 2U * cls);
+}
+
+/**
+ * @brief Maps a request to the size class that serves it, or -1.
+ *
+ * A class serves requests above a quarter of its size, so a cached buffer
+ * is never more than four times larger than the request it backs.
+ */
+static inline int ttak_detachable_size_class(size_t size) {
+    if (size <= ttak_detachable_class_bytes(0) / 4U || size > TTAK_DETACHABLE_CLASS_MAX_BYTES) {
+        return -1;
+    }
+    size_t cls = 0;
+    while (size > ttak_detachable_class_bytes(cls)) {
+        cls++;
+    }
+    return (int)cls;
+}
+
+static inline void ttak_detachable_release_ptr(ttak_detachable_context_t *ctx, void *ptr) {
+    if (ctx->flags & TTAK_ARENA_HAS_EPOCH_RECLAMATION) {
+        ttak_epoch_retire(ptr, free);
+    } else {
+        free(ptr);
+    }
+}
+
 static inline _Bool ttak_detachable_need_lock(const ttak_detachable_context_t *ctx) {
     return (ctx->flags & TTAK_ARENA_USE_LOCKED_ACCESS) && !(ctx->flags & TTAK_ARENA_IS_SINGLE_THREAD);
 }
 
+/**
+ * @brief True when @p ctx is confined to one thread.
+ *
+ * Confined contexts skip the arena lock, the cache-ring mutexes and the
+ * flip detector, whose shared counters exist to catch cross-thread churn.
+ */
+static inline _Bool ttak_detachable_is_confined(const ttak_detachable_context_t *ctx) {
+    return ctx && (ctx->flags & TTAK_ARENA_IS_SINGLE_THREAD);
+}
+
+static inline void ttak_detachable_cache_lock(const ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache) {
+    if (!ttak_detachable_is_confined(ctx)) {
+        pthread_mutex_lock(&cache->lock);
+    }
+}
+
+static inline void ttak_detachable_cache_unlock(const ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache) {
+    if (!ttak_detachable_is_confined(ctx)) {
+        pthread_mutex_unlock(&cache->lock);
+    }
+}
+
 static inline void ttak_detachable_wrlock(ttak_detachable_context_t *ctx) {
     if (ttak_detachable_need_lock(ctx)) {
         pthread_rwlock_wrlock(&ctx->arena_lock);
@@ -129,6 +188,9 @@ void ttak_detachable_context_init(ttak_detachable_context_t *ctx, uint32_t flags
     pthread_rwlockattr_destroy(&attr);
 
     ttak_detachable_cache_init(&ctx->small_cache, TTAK_DETACHABLE_CACHE_MAX_BYTES, TTAK_DETACHABLE_CACHE_SLOTS);
+    for (size_t i = 0; i < TTAK_DETACHABLE_SIZE_CLASSES; ++i) {
+        ttak_detachable_cache_init(&ctx->class_caches[i], ttak_detachable_class_bytes(i), g_detachable_class_slots[i]);
+    }
     ctx->quarantine.columns = NULL;
     ctx->quarantine.sizes = NULL;
     ctx->quarantine.len = 0;
@@ -152,6 +214,11 @@ void ttak_detachable_context_init(ttak_detachable_context_t *ctx, uint32_t flags
     ttak_detachable_register_context(ctx);
 }
 
+void ttak_detachable_context_init_confined(ttak_detachable_context_t *ctx, uint32_t flags) {
+    flags &= ~(uint32_t)TTAK_ARENA_USE_LOCKED_ACCESS;
+    ttak_detachable_context_init(ctx, flags | TTAK_ARENA_IS_SINGLE_THREAD);
+}
+
 void ttak_detachable_context_destroy(ttak_detachable_context_t *ctx) {
     if (!ctx) return;
 
@@ -166,6 +233,9 @@ void ttak_detachable_context_destroy(ttak_detachable_context_t *ctx) {
     }
 
     ttak_detachable_cache_destroy(ctx, &ctx->small_cache);
+    for (size_t i = 0; i < TTAK_DETACHABLE_SIZE_CLASSES; ++i) {
+        ttak_detachable_cache_destroy(ctx, &ctx->class_caches[i]);
+    }
     ttak_detachable_quarantine_flush(ctx);
     free(ctx->quarantine.columns);
     free(ctx->quarantine.sizes);
@@ -181,9 +251,7 @@ void ttak_detachable_cache_init(ttak_detachable_cache_t *cache, size_t chunk_siz
     if (!cache) return;
 
     ttak_mem_stream_zero(cache, sizeof(*cache));
-    cache->chunk_size = (chunk_size == 0 || chunk_size > TTAK_DETACHABLE_CACHE_MAX_BYTES)
-                            ? TTAK_DETACHABLE_CACHE_MAX_BYTES
-                            : chunk_size;
+    cache->chunk_size = (chunk_size == 0) ? TTAK_DETACHABLE_CACHE_MAX_BYTES : chunk_size;
     cache->capacity = (capacity == 0) ? TTAK_DETACHABLE_CACHE_SLOTS : capacity;
     cache->slots = calloc(cache->capacity, sizeof(void *));
     if (cache->slots == NULL) {
@@ -198,7 +266,29 @@ void ttak_detachable_cache_destroy(ttak_detachable_context_t *ctx, ttak_detachab
     pthread_mutex_destroy(&cache->lock);
 }
 
-ttak_detachable_allocation_t ttak_detachable_mem_alloc(ttak_detachable_context_t *ctx, size_t size, uint64_t epoch_hint) {
+static void *ttak_detachable_front_take(ttak_detachable_front_t *front, size_t cls, size_t requested) {
+    if (!front || front->count[cls] == 0) {
+        if (front) front->misses++;
+        return NULL;
+    }
+    void *ptr = front->slots[cls][--front->count[cls]];
+    front->slots[cls][front->count[cls]] = NULL;
+    front->hits++;
+    ttak_mem_stream_zero(ptr, requested);
+    return ptr;
+}
+
+static bool ttak_detachable_front_store(ttak_detachable_front_t *front, size_t cls, void *ptr) {
+    if (!front || front->count[cls] >= TTAK_DETACHABLE_FRONT_SLOTS) {
+        return false;
+    }
+    front->slots[cls][front->count[cls]++] = ptr;
+    return true;
+}
+
+static ttak_detachable_allocation_t ttak_detachable_alloc_impl(ttak_detachable_context_t *ctx,
+                                                               ttak_detachable_front_t *front,
+                                                               size_t size, uint64_t epoch_hint) {
     ttak_detachable_allocation_t result = {0};
     if (!ctx) ctx = ttak_detachable_context_default();
 
@@ -213,20 +303,29 @@ ttak_detachable_allocation_t ttak_detachable_mem_alloc(ttak_detachable_context_t
 
     void *data = NULL;
     bool from_cache = false;
+    int cls = -1;
+    ttak_detachable_cache_t *cache = &ctx->small_cache;
 
     if (actual_size <= ctx->small_cache.chunk_size) {
-        data = ttak_detachable_cache_take(&ctx->small_cache, actual_size);
-        if (data) {
-            from_cache = true;
+        data = ttak_detachable_cache_take(ctx, &ctx->small_cache, actual_size);
+    } else if ((cls = ttak_detachable_size_class(actual_size)) >= 0) {
+        cache = &ctx->class_caches[cls];
+        data = ttak_detachable_front_take(front, (size_t)cls, actual_size);
+        if (!data) {
+            data = ttak_detachable_cache_take(ctx, cache, actual_size);
         }
     }
+    if (data) {
+        from_cache = true;
+    }
 
     if (!data) {
+        size_t alloc_bytes = cls >= 0 ? ttak_detachable_class_bytes((size_t)cls) : actual_size;
         if (ctx->flags & TTAK_ARENA_HAS_EPOCH_RECLAMATION) {
             ttak_epoch_enter();
         }
 
-        data = calloc(1, actual_size);
+        data = calloc(1, alloc_bytes);
 
         if (ctx->flags & TTAK_ARENA_HAS_EPOCH_RECLAMATION) {
             atomic_store_explicit(&ctx->global_epoch_hint, epoch_hint, memory_order_relaxed);
@@ -239,7 +338,7 @@ ttak_detachable_allocation_t ttak_detachable_mem_alloc(ttak_detachable_context_t
 
 #ifdef __linux__
         if (ctx->flags & TTAK_ARENA_USE_ASYNC_OPT) {
-            madvise(data, actual_size, MADV_DONTFORK);
+            madvise(data, alloc_bytes, MADV_DONTFORK);
         }
 #endif
     }
@@ -257,11 +356,12 @@ ttak_detachable_allocation_t ttak_detachable_mem_alloc(ttak_detachable_context_t
     result.data = data;
     result.size = actual_size;
     result.detach_status = status;
-    result.cache = &ctx->small_cache;
+    result.cache = cache;
     return result;
 }
 
-void ttak_detachable_mem_free(ttak_detachable_context_t *ctx, ttak_detachable_allocation_t *alloc) {
+static void ttak_detachable_free_impl(ttak_detachable_context_t *ctx, ttak_detachable_front_t *front,
+                                      ttak_detachable_allocation_t *alloc) {
     if (!alloc || !alloc->data) return;
     if (!ctx) ctx = ttak_detachable_context_default();
 
@@ -281,21 +381,25 @@ void ttak_detachable_mem_free(ttak_detachable_context_t *ctx, ttak_detachable_al
         ttak_detachable_unlock(ctx);
     }
 
-    if (!quarantined && 
-        alloc->size <= ctx->small_cache.chunk_size &&
-        !flip_hot &&
-        mode == TTAK_DETACHABLE_MODE_STANDARD) {
-        stored = ttak_detachable_cache_store(ctx, &ctx->small_cache, alloc->data, alloc->size);
-        if (stored) {
-            alloc->detach_status.bits |= TTAK_DETACHABLE_PARTIAL_CACHE;
-        }
-    }
-
+    /* Untrack first: a pointer a row flush already retired must not be cached. */
     ttak_detachable_wrlock(ctx);
     bool was_tracked = ttak_detachable_untrack_pointer(ctx, alloc->data);
     ttak_detachable_unlock(ctx);
     bool skip_retire = (!was_tracked) && (ctx->flags & TTAK_ARENA_HAS_EPOCH_RECLAMATION);
 
+    if (!quarantined && was_tracked && !flip_hot && mode == TTAK_DETACHABLE_MODE_STANDARD) {
+        int cls;
+        if (alloc->size <= ctx->small_cache.chunk_size) {
+            stored = ttak_detachable_cache_store(ctx, &ctx->small_cache, alloc->data, alloc->size);
+        } else if ((cls = ttak_detachable_size_class(alloc->size)) >= 0) {
+            stored = ttak_detachable_front_store(front, (size_t)cls, alloc->data) ||
+                     ttak_detachable_cache_store(ctx, &ctx->class_caches[cls], alloc->data, alloc->size);
+        }
+        if (stored) {
+            alloc->detach_status.bits |= TTAK_DETACHABLE_PARTIAL_CACHE;
+        }
+    }
+
     if (!stored && !quarantined && !skip_retire) {
         if (ctx->flags & TTAK_ARENA_HAS_EPOCH_RECLAMATION) {
             ttak_epoch_enter();
@@ -312,6 +416,42 @@ void ttak_detachable_mem_free(ttak_detachable_context_t *ctx, ttak_detachable_al
     ttak_detach_status_reset(&alloc->detach_status);
 }
 
+ttak_detachable_allocation_t ttak_detachable_mem_alloc(ttak_detachable_context_t *ctx, size_t size, uint64_t epoch_hint) {
+    return ttak_detachable_alloc_impl(ctx, NULL, size, epoch_hint);
+}
+
+void ttak_detachable_mem_free(ttak_detachable_context_t *ctx, ttak_detachable_allocation_t *alloc) {
+    ttak_detachable_free_impl(ctx, NULL, alloc);
+}
+
+void ttak_detachable_front_init(ttak_detachable_front_t *front, ttak_detachable_context_t *ctx) {
+    if (!front) return;
+    ttak_mem_stream_zero(front, sizeof(*front));
+    front->ctx = ctx ? ctx : ttak_detachable_context_default();
+}
+
+void ttak_detachable_front_flush(ttak_detachable_front_t *front) {
+    if (!front || !front->ctx) return;
+    ttak_detachable_context_t *ctx = front->ctx;
+    for (size_t cls = 0; cls < TTAK_DETACHABLE_SIZE_CLASSES; ++cls) {
+        while (front->count[cls] > 0) {
+            void *ptr = front->slots[cls][--front->count[cls]];
+            front->slots[cls][front->count[cls]] = NULL;
+            if (!ttak_detachable_cache_store(ctx, &ctx->class_caches[cls], ptr, ttak_detachable_class_bytes(cls))) {
+                ttak_detachable_release_ptr(ctx, ptr);
+            }
+        }
+    }
+}
+
+ttak_detachable_allocation_t ttak_detachable_mem_alloc_front(ttak_detachable_front_t *front, size_t size, uint64_t epoch_hint) {
+    return ttak_detachable_alloc_impl(front ? front->ctx : NULL, front, size, epoch_hint);
+}
+
+void ttak_detachable_mem_free_front(ttak_detachable_front_t *front, ttak_detachable_allocation_t *alloc) {
+    ttak_detachable_free_impl(front ? front->ctx : NULL, front, alloc);
+}
+
 static uint64_t ttak_detachable_now_ns(void) {
 #ifdef _WIN32
     return 0;
@@ -325,7 +465,7 @@ static uint64_t ttak_detachable_now_ns(void) {
 }
 
 static bool ttak_detachable_flip_should_quarantine(ttak_detachable_context_t *ctx, size_t size) {
-    if (!ctx || size == 0) {
+    if (!ctx || size == 0 || ttak_detachable_is_confined(ctx)) {
         return false;
     }
     if (ctx->flip_event_threshold == 0 || ctx->flip_window_ns == 0 || ctx->flip_max_gap_ns == 0) {
@@ -528,6 +668,15 @@ static void ttak_detachable_track_pointer(ttak_detachable_context_t *ctx, void *
     ttak_detachable_generation_row_t *row = &ctx->rows[ctx->active_row];
     ttak_detachable_row_alloc(row);
 
+    if (row->len >= row->cap) {
+        /* Reuse the holes left by frees before expiring the generation. */
+        size_t live = 0;
+        for (size_t c = 0; c < row->len; ++c) {
+            if (row->columns[c]) row->columns[live++] = row->columns[c];
+        }
+        row->len = live;
+    }
+
     if (row->len >= row->cap) {
         ttak_detachable_row_flush(ctx, row);
         size_t advance = ctx->epoch_delay ? ctx->epoch_delay : 1;
@@ -557,9 +706,9 @@ static bool ttak_detachable_untrack_pointer(ttak_detachable_context_t *ctx, void
 
 static bool ttak_detachable_cache_store(ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache, void *ptr, size_t size) {
     if (!cache || !ptr) return false;
-    pthread_mutex_lock(&cache->lock);
+    ttak_detachable_cache_lock(ctx, cache);
     if (!cache->slots || size > cache->chunk_size) {
-        pthread_mutex_unlock(&cache->lock);
+        ttak_detachable_cache_unlock(ctx, cache);
         return false;
     }
 
@@ -577,7 +726,7 @@ static bool ttak_detachable_cache_store(ttak_detachable_context_t *ctx, ttak_det
             cache->count--;
         } else {
             cache->misses++;
-            pthread_mutex_unlock(&cache->lock);
+            ttak_detachable_cache_unlock(ctx, cache);
             return false;
         }
     } else {
@@ -587,16 +736,16 @@ static bool ttak_detachable_cache_store(ttak_detachable_context_t *ctx, ttak_det
     cache->slots[cache->tail] = ptr;
     cache->tail = (cache->tail + 1) % cache->capacity;
     cache->count++;
-    pthread_mutex_unlock(&cache->lock);
+    ttak_detachable_cache_unlock(ctx, cache);
     return true;
 }
 
-static void *ttak_detachable_cache_take(ttak_detachable_cache_t *cache, size_t requested) {
+static void *ttak_detachable_cache_take(ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache, size_t requested) {
     if (!cache) return NULL;
-    pthread_mutex_lock(&cache->lock);
+    ttak_detachable_cache_lock(ctx, cache);
     if (!cache->slots || cache->count == 0 || requested > cache->chunk_size) {
         cache->misses++;
-        pthread_mutex_unlock(&cache->lock);
+        ttak_detachable_cache_unlock(ctx, cache);
         return NULL;
     }
 
@@ -605,16 +754,21 @@ static void *ttak_detachable_cache_take(ttak_detachable_cache_t *cache, size_t r
     cache->head = (cache->head + 1) % cache->capacity;
     cache->count--;
     cache->hits++;
-    pthread_mutex_unlock(&cache->lock);
+    ttak_detachable_cache_unlock(ctx, cache);
 
     if (ptr) {
-        ttak_mem_stream_zero(ptr, cache->chunk_size);
+        ttak_mem_stream_zero(ptr, requested);
     }
     return ptr;
 }
 
-static void ttak_detachable_cache_drain(ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache, bool release_storage) {
-    if (!cache) return;
+/**
+ * @brief Releases every cached entry.
+ * @return Number of entries released.
+ */
+static size_t ttak_detachable_cache_drain(ttak_detachable_context_t *ctx, ttak_detachable_cache_t *cache, bool release_storage) {
+    if (!cache) return 0;
+    size_t released = 0;
     pthread_mutex_lock(&cache->lock);
     void **slots = cache->slots;
     size_t cap = cache->capacity;
@@ -622,6 +776,7 @@ static void ttak_detachable_cache_drain(ttak_detachable_context_t *ctx, ttak_det
         for (size_t i = 0; i < cap; ++i) {
             void *ptr = slots[i];
             if (!ptr) continue;
+            released++;
             if (ctx && (ctx->flags & TTAK_ARENA_HAS_EPOCH_RECLAMATION)) {
                 ttak_epoch_retire(ptr, free);
             } else {
@@ -640,6 +795,27 @@ static void ttak_detachable_cache_drain(ttak_detachable_context_t *ctx, ttak_det
     if (release_storage) {
         free(slots);
     }
+    return released;
+}
+
+size_t ttak_detachable_context_trim(ttak_detachable_context_t *ctx) {
+    if (!ctx) return 0;
+    size_t bytes = ttak_detachable_cache_drain(ctx, &ctx->small_cache, false) * ctx->small_cache.chunk_size;
+    for (size_t c = 0; c < TTAK_DETACHABLE_SIZE_CLASSES; ++c) {
+        bytes += ttak_detachable_cache_drain(ctx, &ctx->class_caches[c], false) * ctx->class_caches[c].chunk_size;
+    }
+    return bytes;
+}
+
+size_t ttak_detachable_trim_all(void) {
+    size_t bytes = 0;
+    pthread_mutex_lock(&g_ctx_registry_lock);
+    for (size_t i = 0; i < g_ctx_registry_len; ++i) {
+        ttak_detachable_context_t *ctx = g_ctx_registry[i];
+        if (ctx && !ttak_detachable_is_confined(ctx)) bytes += ttak_detachable_context_trim(ctx);
+    }
+    pthread_mutex_unlock(&g_ctx_registry_lock);
+    return bytes;
 }
 
 #ifndef _WIN32
@@ -649,6 +825,9 @@ static void ttak_detachable_global_shutdown(_Bool flush_rows) {
         ttak_detachable_context_t *ctx = g_ctx_registry[i];
         if (!ctx) continue;
         ttak_detachable_cache_drain(ctx, &ctx->small_cache, false);
+        for (size_t c = 0; c < TTAK_DETACHABLE_SIZE_CLASSES; ++c) {
+            ttak_detachable_cache_drain(ctx, &ctx->class_caches[c], false);
+        }
         if (flush_rows) {
             for (size_t r = 0; r < ctx->matrix_rows; ++r) {
                 ttak_detachable_row_flush(ctx, &ctx->rows[r]);
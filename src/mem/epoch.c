@@ -7,6 +7,9 @@
 #include <ttak/mols_control.h>
 #include <ttak/timing/timing.h>
 #include <ttak/types/ttak_compiler.h>
+#include <ttak/sync/qlock.h>
+#include <ttak/log/trace.h>
+#include <ttak/mask/dynamic_mask.h>
 
 #ifndef _MSC_VER
 #include <stdatomic.h>
@@ -24,10 +27,17 @@
  * @brief Epoch-Based Reclamation (EBR) using a 16x16 OLS mapping.
  *
  * This implementation provides:
- * - Thread registration with a logical TID assignment.
+ * - Thread registration with a logical TID assignment; ids are recycled
+ *   and index dense, cache-line sized per-thread records.
  * - Per-thread epoch tracking for quiescent state detection.
- * - Retire lists stored in an OLS grid (buckets[x][y]) indexed by (tid, gen).
- * - A reclaim step that advances the global epoch and frees retired nodes when safe.
+ * - Per-thread retire batches: fixed-size arrays filled without atomics and
+ *   sealed with a single epoch stamp, so one CAS covers TTAK_EPOCH_BATCH_SIZE retires.
+ * - Sealed batches stored in an OLS grid (buckets[x][y]) indexed by (tid, gen).
+ * - A reclaim step that advances the global epoch and frees batches sealed
+ *   before the oldest active reader, triggered automatically once enough
+ *   batches are pending.
+ * - Backlog counters and a reclaim duration histogram readable through
+ *   ttak_epoch_stats_snapshot() without taking the reclaim lock.
  *
  * Cross-platform strategy:
  * - On GCC/Clang: uses C11 <stdatomic.h>, _Thread_local, and GNU attributes.
@@ -38,25 +48,17 @@
 /* --- Configuration --- */
 
 #define OLS_ORDER 16
-#define TTAK_EPOCH_NODE_POOL_LIMIT 16384U
+#define TTAK_EPOCH_BATCH_POOL_LIMIT 256U
+#define TTAK_EPOCH_SLAB_SHIFT 6
+#define TTAK_EPOCH_SLAB_THREADS (1U << TTAK_EPOCH_SLAB_SHIFT)
+#define TTAK_EPOCH_MAX_SLABS 1024U
 
 /* --- Cross-compiler attributes and TLS --- */
 
-#define TTAK_STRINGIFY_INNER(x) #x
-#define TTAK_STRINGIFY(x) TTAK_STRINGIFY_INNER(x)
-
 #if defined(_MSC_VER)
 #define TTAK_VIS_DEFAULT
-#define TTAK_CONSTRUCTOR(prio)
-#elif defined(__TINYC__)
-#define TTAK_VIS_DEFAULT __attribute__((visibility("default")))
-#define TTAK_CONSTRUCTOR(prio)                                                      \
-    __attribute__((constructor))                                                    \
-    __attribute__((used))                                                           \
-    __attribute__((section(".init_array.0" TTAK_STRINGIFY(prio))))
 #else
 #define TTAK_VIS_DEFAULT __attribute__((visibility("default")))
-#define TTAK_CONSTRUCTOR(prio) __attribute__((constructor(prio)))
 #endif
 
 /* --- Minimal atomics abstraction --- */
@@ -142,6 +144,22 @@ static __forceinline void tt_atomic_store_bool(bool _Atomic *obj, bool val, memo
 #define TT_ATOMIC_STORE_U32(p, v, order)        tt_atomic_store_u32((uint32_t _Atomic *)(p), (uint32_t)(v), (order))
 #define TT_ATOMIC_FETCH_ADD_U32(p, v, order)    tt_atomic_fetch_add_u32((uint32_t _Atomic *)(p), (uint32_t)(v), (order))
 
+static __forceinline uint64_t tt_atomic_load_u64(uint64_t _Atomic *obj, memory_order order) {
+    (void)order;
+    tt_atomic_fence(memory_order_seq_cst);
+    return (uint64_t)(*obj);
+}
+
+static __forceinline void tt_atomic_store_u64(uint64_t _Atomic *obj, uint64_t val, memory_order order) {
+    (void)order;
+    tt_atomic_fence(memory_order_seq_cst);
+    *obj = val;
+    tt_atomic_fence(memory_order_seq_cst);
+}
+
+#define TT_ATOMIC_LOAD_U64(p, order)            tt_atomic_load_u64((uint64_t _Atomic *)(p), (order))
+#define TT_ATOMIC_STORE_U64(p, v, order)        tt_atomic_store_u64((uint64_t _Atomic *)(p), (uint64_t)(v), (order))
+
 #define TT_ATOMIC_LOAD_BOOL(p, order)           tt_atomic_load_bool((bool _Atomic *)(p), (order))
 #define TT_ATOMIC_STORE_BOOL(p, v, order)       tt_atomic_store_bool((bool _Atomic *)(p), (bool)(v), (order))
 
@@ -158,6 +176,9 @@ static __forceinline void tt_atomic_store_bool(bool _Atomic *obj, bool val, memo
 #define TT_ATOMIC_STORE_U32(p, v, order)        atomic_store_explicit((p), (v), (order))
 #define TT_ATOMIC_FETCH_ADD_U32(p, v, order)    atomic_fetch_add_explicit((p), (v), (order))
 
+#define TT_ATOMIC_LOAD_U64(p, order)            atomic_load_explicit((p), (order))
+#define TT_ATOMIC_STORE_U64(p, v, order)        atomic_store_explicit((p), (v), (order))
+
 #define TT_ATOMIC_LOAD_BOOL(p, order)           atomic_load_explicit((p), (order))
 #define TT_ATOMIC_STORE_BOOL(p, v, order)       atomic_store_explicit((p), (v), (order))
 
@@ -170,11 +191,11 @@ static __forceinline void tt_atomic_store_bool(bool _Atomic *obj, bool val, memo
 /**
  * @brief 16x16 OLS mapping plane containing retired pointer lists.
  *
- * buckets[x][y] is a Treiber stack of ttak_retired_node_t, accessed atomically.
+ * buckets[x][y] is a Treiber stack of sealed ttak_retire_batch_t, accessed atomically.
  * occupancy[] is initialized to zero and may be used for debugging/visibility.
  */
 typedef struct {
-    ttak_retired_node_t * _Atomic buckets[OLS_ORDER][OLS_ORDER];
+    ttak_retire_batch_t * _Atomic buckets[OLS_ORDER][OLS_ORDER];
     size_t _Atomic occupancy[OLS_ORDER];
 } ttak_ols_plane_t;
 
@@ -189,10 +210,26 @@ typedef struct {
 TTAK_VIS_DEFAULT ttak_epoch_manager_t g_epoch_mgr = {0};
 
 /**
- * @brief Lock-free cache of retired nodes to avoid alloc/free flapping.
+ * @brief Cache of empty batches to avoid alloc/free flapping.
+ *
+ * Many threads pop and the reclaimer pushes, so a Treiber stack would be
+ * exposed to ABA; batches are taken once per TTAK_EPOCH_BATCH_SIZE retires,
+ * which makes a spinlock cheap enough.
+ */
+static ttak_retire_batch_t *g_batch_pool = NULL;
+static uint32_t g_batch_pool_count = 0;
+static ttak_hot_lock_t g_batch_pool_lock;
+
+/**
+ * @brief Sealed batches not yet freed, and the count that triggers a reclaim.
+ */
+static uint32_t _Atomic g_pending_batches = 0;
+static uint32_t _Atomic g_reclaim_threshold = TTAK_EPOCH_RECLAIM_THRESHOLD;
+
+/**
+ * @brief Durations of reclaim passes; written under g_reclaim_lock, copied by snapshots.
  */
-static ttak_retired_node_t * _Atomic g_retired_node_pool = NULL;
-static uint32_t _Atomic g_retired_node_pool_count = 0;
+static ttak_stats_t g_reclaim_stats;
 
 /**
  * @brief Global OLS plane storage.
@@ -213,15 +250,6 @@ TTAK_VIS_DEFAULT bool _Atomic g_epoch_init_ready = false;
  */
 static pthread_mutex_t g_reclaim_lock = PTHREAD_MUTEX_INITIALIZER;
 
-/**
- * @brief Linked list node used to track registered threads.
- */
-typedef struct ttak_thread_node {
-    ttak_thread_state_t *state;
-    uint32_t logical_tid;
-    struct ttak_thread_node *next;
-} ttak_thread_node_t;
-
 /**
  * @brief Per-thread state pointer.
  *
@@ -253,66 +281,132 @@ TTAK_VIS_DEFAULT void ttak_set_t_local_state(ttak_thread_state_t *val) {
 #endif
 
 /**
- * @brief Head of the registered thread list (atomic pointer).
+ * @brief Key whose destructor seals a thread's open batches when it exits.
+ */
+static pthread_key_t g_exit_key;
+static pthread_once_t g_exit_once = PTHREAD_ONCE_INIT;
+
+static void epoch_seal_thread(ttak_thread_state_t *st);
+
+static void epoch_release_thread(ttak_thread_state_t *st);
+
+/* A thread that exits without deregistering gives its id back all the same. */
+static void epoch_thread_exit(void *arg) {
+#if defined(__TINYC__)
+    ttak_set_t_local_state(NULL);
+#else
+    t_local_state = NULL;
+#endif
+    epoch_release_thread((ttak_thread_state_t *)arg);
+}
+
+static void epoch_exit_key_init(void) {
+    pthread_key_create(&g_exit_key, epoch_thread_exit);
+}
+
+/**
+ * @brief Per-thread states, TTAK_EPOCH_SLAB_THREADS to a slab, indexed by logical id.
+ *
+ * Slabs are published once and never freed, so reclaimers walk the ids
+ * below g_tid_counter over contiguous records instead of a list. Left
+ * implicitly zero-initialized like g_ols_static_plane.
  */
-TTAK_VIS_DEFAULT ttak_thread_node_t * _Atomic g_thread_list = NULL;
+static ttak_thread_state_t * _Atomic g_thread_slabs[TTAK_EPOCH_MAX_SLABS];
 
 /**
- * @brief Logical thread ID counter (atomic).
+ * @brief Logical ids handed out so far; the states of all of them are valid.
  */
 TTAK_VIS_DEFAULT uint32_t _Atomic g_tid_counter = 0;
 
-/* --- Retired node cache helpers --- */
+/**
+ * @brief Ids owned by a registered thread. Guarded by g_tid_lock.
+ *
+ * A released id is handed out again lowest first, so the walked range and
+ * everything indexed by id (ttak_shared_t shard pages) stay bounded by the
+ * peak number of concurrent threads rather than by thread churn.
+ */
+static ttak_dynamic_mask_t g_tids_in_use;
+static pthread_mutex_t g_tid_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline ttak_thread_state_t *epoch_state_at(uint32_t tid) {
+    ttak_thread_state_t *slab =
+        (ttak_thread_state_t *)TT_ATOMIC_LOAD_PTR((void * _Atomic *)&g_thread_slabs[tid >> TTAK_EPOCH_SLAB_SHIFT],
+                                                  memory_order_acquire);
+    return &slab[tid & (TTAK_EPOCH_SLAB_THREADS - 1)];
+}
 
-static inline ttak_retired_node_t *epoch_node_pool_acquire(void) {
-    while (1) {
-        ttak_retired_node_t *head =
-            (ttak_retired_node_t *)TT_ATOMIC_LOAD_PTR((void * _Atomic *)&g_retired_node_pool,
-                                                      memory_order_acquire);
-        if (!head) {
-            break;
-        }
-        ttak_retired_node_t *next = head->next;
-        void *expected = head;
-        if (TT_ATOMIC_CAS_WEAK_PTR((void * _Atomic *)&g_retired_node_pool, &expected, next,
-                                   memory_order_acq_rel, memory_order_acquire)) {
-            uint32_t prev = TT_ATOMIC_FETCH_ADD_U32(&g_retired_node_pool_count, (uint32_t)-1,
-                                                    memory_order_relaxed);
-            if (TTAK_UNLIKELY(prev == 0)) {
-                TT_ATOMIC_FETCH_ADD_U32(&g_retired_node_pool_count, 1, memory_order_relaxed);
-            }
-            head->next = NULL;
-            return head;
+/* --- Batch cache helpers --- */
+
+static inline ttak_retire_batch_t *epoch_batch_acquire(void) {
+    ttak_hot_lock(&g_batch_pool_lock);
+    ttak_retire_batch_t *batch = g_batch_pool;
+    if (batch) {
+        g_batch_pool = batch->next;
+        g_batch_pool_count--;
+    }
+    ttak_hot_unlock(&g_batch_pool_lock);
+
+    if (!batch) {
+        batch = (ttak_retire_batch_t *)ttak_dangerous_calloc(1, sizeof(ttak_retire_batch_t));
+        if (!batch) {
+            return NULL;
         }
     }
-    return (ttak_retired_node_t *)ttak_dangerous_calloc(1, sizeof(ttak_retired_node_t));
+    batch->next = NULL;
+    batch->count = 0;
+    batch->bulk = NULL;
+    batch->owner = NULL;
+    batch->bytes = 0;
+    return batch;
 }
 
-static inline void epoch_node_pool_release(ttak_retired_node_t *node) {
-    if (!node) {
-        return;
+static inline void epoch_batch_release(ttak_retire_batch_t *batch) {
+    ttak_hot_lock(&g_batch_pool_lock);
+    if (g_batch_pool_count < TTAK_EPOCH_BATCH_POOL_LIMIT) {
+        batch->next = g_batch_pool;
+        g_batch_pool = batch;
+        g_batch_pool_count++;
+        batch = NULL;
     }
-    node->ptr = NULL;
-    node->cleanup = NULL;
-
-    uint32_t cached = TT_ATOMIC_LOAD_U32(&g_retired_node_pool_count, memory_order_relaxed);
-    if (cached >= TTAK_EPOCH_NODE_POOL_LIMIT) {
-        ttak_dangerous_free(node);
-        return;
+    ttak_hot_unlock(&g_batch_pool_lock);
+    if (batch) {
+        ttak_dangerous_free(batch);
     }
+}
 
-    while (1) {
-        ttak_retired_node_t *head =
-            (ttak_retired_node_t *)TT_ATOMIC_LOAD_PTR((void * _Atomic *)&g_retired_node_pool,
-                                                      memory_order_acquire);
-        node->next = head;
-        void *expected = head;
-        if (TT_ATOMIC_CAS_WEAK_PTR((void * _Atomic *)&g_retired_node_pool, &expected, node,
-                                   memory_order_release, memory_order_acquire)) {
-            TT_ATOMIC_FETCH_ADD_U32(&g_retired_node_pool_count, 1, memory_order_relaxed);
-            return;
+/**
+ * @brief Runs the cleanups of a batch, credits its owner and returns it to the cache.
+ *
+ * Only called with g_reclaim_lock held, which makes the reclaimed counters
+ * single-writer.
+ */
+static void epoch_batch_free(ttak_retire_batch_t *batch) {
+    ttak_thread_state_t *owner = batch->owner;
+    if (owner) {
+        TT_ATOMIC_STORE_U64(&owner->reclaimed_ptrs,
+                            TT_ATOMIC_LOAD_U64(&owner->reclaimed_ptrs, memory_order_relaxed) + batch->count,
+                            memory_order_relaxed);
+        TT_ATOMIC_STORE_U64(&owner->reclaimed_bytes,
+                            TT_ATOMIC_LOAD_U64(&owner->reclaimed_bytes, memory_order_relaxed) + batch->bytes,
+                            memory_order_relaxed);
+    }
+    if (batch->bulk) {
+        batch->bulk(batch->ptrs, batch->count);
+    } else {
+        for (uint32_t i = 0; i < batch->count; i++) {
+            if (batch->cleanups[i]) {
+                batch->cleanups[i](batch->ptrs[i]);
+            }
         }
     }
+    epoch_batch_release(batch);
+}
+
+/**
+ * @brief True if epoch @p a precedes @p b, tolerating counter wrap-around.
+ */
+static inline bool epoch_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
 }
 
 /* --- Internal helpers --- */
@@ -340,18 +434,9 @@ static inline void ttak_get_ols_coords(uint32_t tid, uint32_t gen, int *x, int *
 
 /* --- Initialization --- */
 
-/**
- * @brief Initialize the OLS plane and mark the subsystem ready.
- *
- * On GCC/Clang, this function is also tagged as a constructor for early init.
- * On MSVC, constructor decoration is disabled; lazy init is performed by callers.
- */
-TTAK_CONSTRUCTOR(101)
-void ttak_epoch_subsystem_init(void) {
-    if (TT_ATOMIC_LOAD_BOOL(&g_epoch_init_ready, memory_order_seq_cst)) {
-        return;
-    }
+static pthread_once_t g_epoch_init_once = PTHREAD_ONCE_INIT;
 
+static void epoch_subsystem_init_once(void) {
     for (int i = 0; i < OLS_ORDER; i++) {
         for (int j = 0; j < OLS_ORDER; j++) {
 #if defined(_MSC_VER)
@@ -367,16 +452,64 @@ void ttak_epoch_subsystem_init(void) {
 #endif
     }
 
+    ttak_hot_lock_init(&g_batch_pool_lock);
+    ttak_stats_init(&g_reclaim_stats, 0, TTAK_EPOCH_RECLAIM_HIST_MAX_NS);
+    ttak_dynamic_mask_init(&g_tids_in_use);
     TT_ATOMIC_STORE_BOOL(&g_epoch_init_ready, true, memory_order_seq_cst);
 }
 
+/**
+ * @brief Initialize the OLS plane and mark the subsystem ready.
+ *
+ * Runs once, from the first thread registration rather than a load-time
+ * constructor, so processes that never touch EBR pay nothing for it.
+ */
+void ttak_epoch_subsystem_init(void) {
+    if (TT_ATOMIC_LOAD_BOOL(&g_epoch_init_ready, memory_order_acquire)) return;
+    pthread_once(&g_epoch_init_once, epoch_subsystem_init_once);
+}
+
 /* --- Thread registration --- */
 
+/**
+ * @brief Appends a slab of states for ids starting at @p base. Called under g_tid_lock.
+ */
+static bool epoch_add_slab(uint32_t base) {
+    uint32_t slab_idx = base >> TTAK_EPOCH_SLAB_SHIFT;
+    if (slab_idx >= TTAK_EPOCH_MAX_SLABS) {
+        return false;
+    }
+    ttak_thread_state_t *slab =
+        (ttak_thread_state_t *)ttak_dangerous_calloc(TTAK_EPOCH_SLAB_THREADS, sizeof(ttak_thread_state_t));
+    if (!slab) {
+        return false;
+    }
+    for (uint32_t i = 0; i < TTAK_EPOCH_SLAB_THREADS; ++i) {
+        ttak_thread_state_t *st = &slab[i];
+#if defined(_MSC_VER)
+        st->local_epoch = 0;
+        st->active = false;
+#else
+        atomic_init(&st->local_epoch, 0);
+        atomic_init(&st->active, false);
+        atomic_init(&st->retired_ptrs, 0);
+        atomic_init(&st->retired_bytes, 0);
+        atomic_init(&st->reclaimed_ptrs, 0);
+        atomic_init(&st->reclaimed_bytes, 0);
+#endif
+        st->logical_tid = base + i;
+    }
+    TT_ATOMIC_STORE_PTR((void * _Atomic *)&g_thread_slabs[slab_idx], slab, memory_order_release);
+    return true;
+}
+
 /**
  * @brief Register the current thread with the epoch subsystem.
  *
- * Allocates a per-thread state and publishes it to the global thread list.
- * This function is idempotent for the current thread.
+ * Takes the lowest free logical id and its state, adding a slab of states
+ * when every id handed out so far is in use. A reused state keeps its
+ * retire counters, so batches its previous owner left pending are still
+ * credited to it. This function is idempotent for the current thread.
  */
 void ttak_epoch_register_thread(void) {
 #if defined(__TINYC__)
@@ -390,193 +523,460 @@ void ttak_epoch_register_thread(void) {
         ttak_epoch_subsystem_init();
     }
 
-    ttak_thread_state_t *new_st = (ttak_thread_state_t *)ttak_dangerous_calloc(1, sizeof(ttak_thread_state_t));
-    if (!new_st) {
-        return;
+    pthread_mutex_lock(&g_tid_lock);
+    uint32_t count = TT_ATOMIC_LOAD_U32(&g_tid_counter, memory_order_relaxed);
+    uint32_t tid;
+    if (!ttak_dynamic_mask_find_first_free(&g_tids_in_use, &tid) || tid >= count) {
+        tid = count;
+        if ((tid & (TTAK_EPOCH_SLAB_THREADS - 1)) == 0 && !epoch_add_slab(tid)) {
+            pthread_mutex_unlock(&g_tid_lock);
+            return;
+        }
+        TT_ATOMIC_STORE_U32(&g_tid_counter, tid + 1, memory_order_release);
     }
+    ttak_thread_state_t *new_st = epoch_state_at(tid);
 
 #if defined(__TINYC__)
     ttak_set_t_local_state(new_st);
 #else
     t_local_state = new_st;
 #endif
-
 #if defined(_MSC_VER)
     new_st->local_epoch = 0;
-    new_st->active = false;
 #else
-    atomic_init(&new_st->local_epoch, 0);
-    atomic_init(&new_st->active, false);
+    atomic_store_explicit(&new_st->local_epoch, 0, memory_order_relaxed);
 #endif
 
-    ttak_thread_node_t *node = (ttak_thread_node_t *)ttak_dangerous_calloc(1, sizeof(ttak_thread_node_t));
-    if (!node) {
+    /* Set only once the thread owns a state: growing the mask retires its old bitmap. */
+    if (!ttak_dynamic_mask_set(&g_tids_in_use, tid)) {
 #if defined(__TINYC__)
         ttak_set_t_local_state(NULL);
 #else
         t_local_state = NULL;
 #endif
+        pthread_mutex_unlock(&g_tid_lock);
         return;
     }
+    pthread_mutex_unlock(&g_tid_lock);
 
-    node->state = new_st;
-    node->logical_tid = TT_ATOMIC_FETCH_ADD_U32(&g_tid_counter, 1, memory_order_relaxed);
-    new_st->logical_tid = node->logical_tid;
-
-    ttak_thread_node_t *old_head;
-    do {
-        old_head = (ttak_thread_node_t *)TT_ATOMIC_LOAD_PTR((void * _Atomic *)&g_thread_list, memory_order_acquire);
-        node->next = old_head;
+    pthread_once(&g_exit_once, epoch_exit_key_init);
+    pthread_setspecific(g_exit_key, new_st);
+}
 
-        void *expected = old_head;
-        if (TT_ATOMIC_CAS_WEAK_PTR((void * _Atomic *)&g_thread_list, &expected, node,
-                                  memory_order_release, memory_order_acquire)) {
-            break;
-        }
-    } while (1);
+/**
+ * @brief Seals @p st's batches, marks it inactive and returns its id.
+ *
+ * The caller has already dropped its TLS pointer; once the id is back in
+ * the pool another thread may take the state over.
+ */
+static void epoch_release_thread(ttak_thread_state_t *st) {
+    epoch_seal_thread(st);
+#if defined(_MSC_VER)
+    st->active = false;
+#else
+    atomic_store_explicit(&st->active, false, memory_order_seq_cst);
+#endif
+    ttak_dynamic_mask_clear(&g_tids_in_use, st->logical_tid);
 }
 
 /**
  * @brief Deregister the current thread from epoch tracking.
  *
- * This marks the thread inactive and drops the TLS pointer. The allocated state is
- * intentionally not freed to avoid races with concurrent reclaim operations.
+ * This seals the thread's open batches, marks it inactive, drops the TLS
+ * pointer and releases the logical id for reuse. The state itself is never
+ * freed, since concurrent reclaimers may still be reading it.
  */
 void ttak_epoch_deregister_thread(void) {
 #if defined(__TINYC__)
     ttak_thread_state_t *st = ttak_get_t_local_state();
     if (!st) return;
-    atomic_store_explicit(&st->active, false, memory_order_seq_cst);
     ttak_set_t_local_state(NULL);
 #else
-    if (!t_local_state) {
+    ttak_thread_state_t *st = t_local_state;
+    if (!st) {
         return;
     }
-
-#if defined(_MSC_VER)
-    t_local_state->active = false;
-#else
-    atomic_store_explicit(&t_local_state->active, false, memory_order_seq_cst);
-#endif
-
     t_local_state = NULL;
 #endif
+    pthread_setspecific(g_exit_key, NULL);
+    epoch_release_thread(st);
 }
 
 /* --- Epoch enter/exit is now inlined in include/ttak/mem/epoch.h --- */
 
 /* --- Retirement --- */
 
+/**
+ * @brief Stamps a filled batch and publishes it to the OLS plane.
+ *
+ * The stamp is read after every pointer in the batch was unlinked, so it is
+ * no older than the epoch any reader of those pointers entered with.
+ *
+ * @return True if enough batches are pending that the caller should reclaim.
+ */
+static bool epoch_seal_batch(ttak_thread_state_t *st, ttak_retire_batch_t *batch) {
+    if (batch->count == 0) {
+        epoch_batch_release(batch);
+        return false;
+    }
+
+    uint32_t gen = TT_ATOMIC_LOAD_U32(&g_epoch_mgr.global_epoch, memory_order_seq_cst);
+    batch->epoch = gen;
+
+    int x, y;
+    ttak_get_ols_coords(st->logical_tid, gen, &x, &y);
+
+    ttak_retire_batch_t *old_head;
+    do {
+        old_head = (ttak_retire_batch_t *)TT_ATOMIC_LOAD_PTR((void * _Atomic *)&g_ols_static_plane.buckets[x][y],
+                                                             memory_order_acquire);
+        batch->next = old_head;
+
+        void *expected = old_head;
+        if (TT_ATOMIC_CAS_WEAK_PTR((void * _Atomic *)&g_ols_static_plane.buckets[x][y], &expected, batch,
+                                  memory_order_release, memory_order_acquire)) {
+            break;
+        }
+    } while (1);
+
+    uint32_t pending = TT_ATOMIC_FETCH_ADD_U32(&g_pending_batches, 1, memory_order_relaxed) + 1;
+    uint32_t threshold = TT_ATOMIC_LOAD_U32(&g_reclaim_threshold, memory_order_relaxed);
+    return threshold != 0 && pending >= threshold;
+}
+
+static void epoch_seal_thread(ttak_thread_state_t *st) {
+    if (!st) {
+        return;
+    }
+    ttak_retire_batch_t *batch = st->open_batch;
+    ttak_retire_batch_t *bulk = st->open_bulk;
+    st->open_batch = NULL;
+    st->open_bulk = NULL;
+    if (batch) {
+        (void)epoch_seal_batch(st, batch);
+    }
+    if (bulk) {
+        (void)epoch_seal_batch(st, bulk);
+    }
+}
+
+static inline ttak_thread_state_t *epoch_current_state(void) {
+    if (TTAK_UNLIKELY(!t_local_state)) {
+        ttak_epoch_register_thread();
+    }
+    return t_local_state;
+}
+
+/**
+ * @brief Appends one pointer to the caller's open batch.
+ *
+ * The owner is the only writer of the retired counters, so a relaxed
+ * load/store pair is enough to keep them readable by snapshots.
+ */
+static inline void epoch_retire_one(void *ptr, size_t size, void (*cleanup)(void *)) {
+    ttak_thread_state_t *st = epoch_current_state();
+    if (!st) {
+        return;
+    }
+
+    ttak_retire_batch_t *batch = st->open_batch;
+    if (TTAK_UNLIKELY(!batch)) {
+        batch = epoch_batch_acquire();
+        if (!batch) {
+            return;
+        }
+        batch->owner = st;
+        st->open_batch = batch;
+    }
+
+    uint32_t n = batch->count;
+    batch->ptrs[n] = ptr;
+    batch->cleanups[n] = cleanup;
+    batch->count = n + 1;
+    batch->bytes += size;
+
+    TT_ATOMIC_STORE_U64(&st->retired_ptrs, TT_ATOMIC_LOAD_U64(&st->retired_ptrs, memory_order_relaxed) + 1,
+                        memory_order_relaxed);
+    if (size) {
+        TT_ATOMIC_STORE_U64(&st->retired_bytes, TT_ATOMIC_LOAD_U64(&st->retired_bytes, memory_order_relaxed) + size,
+                            memory_order_relaxed);
+    }
+
+    if (TTAK_UNLIKELY(batch->count == TTAK_EPOCH_BATCH_SIZE)) {
+        st->open_batch = NULL;
+        if (epoch_seal_batch(st, batch)) {
+            ttak_epoch_reclaim();
+        }
+    }
+}
+
 /**
  * @brief Retire a pointer for deferred reclamation.
  *
- * The retired node is pushed into the OLS bucket selected by the current
- * thread TID and current global epoch value.
+ * The pointer is appended to the calling thread's open batch. A full batch
+ * is sealed into the OLS bucket selected by the thread TID and the current
+ * global epoch, and a reclaim is attempted once enough batches are pending.
  *
  * @param ptr Pointer to retire.
- * @param cleanup Optional cleanup callback to run before node memory is freed.
+ * @param cleanup Optional cleanup callback to run when the pointer is reclaimed.
  */
 void ttak_epoch_retire(void *ptr, void (*cleanup)(void *)) {
     if (!ptr) {
         return;
     }
-    if (!t_local_state) {
-        ttak_epoch_register_thread();
-    }
-    if (!t_local_state) {
+    epoch_retire_one(ptr, 0, cleanup);
+}
+
+/**
+ * @brief Retire a pointer and account its size in the thread's backlog.
+ *
+ * @param ptr Pointer to retire.
+ * @param size Bytes owned by @p ptr.
+ * @param cleanup Optional cleanup callback to run when the pointer is reclaimed.
+ */
+void ttak_epoch_retire_sized(void *ptr, size_t size, void (*cleanup)(void *)) {
+    if (!ptr) {
         return;
     }
+    epoch_retire_one(ptr, size, cleanup);
+}
 
-    ttak_retired_node_t *node = epoch_node_pool_acquire();
-    if (!node) {
+/**
+ * @brief Retire an array of pointers with a whole-batch cleanup.
+ *
+ * @param ptrs Pointers to retire; NULL entries are skipped.
+ * @param count Number of entries in @p ptrs.
+ * @param cleanup Bulk cleanup callback invoked once per reclaimed batch.
+ */
+void ttak_epoch_retire_bulk(void *const *ptrs, size_t count, ttak_epoch_bulk_cleanup_t cleanup) {
+    if (!ptrs || count == 0 || !cleanup) {
+        return;
+    }
+    ttak_thread_state_t *st = epoch_current_state();
+    if (!st) {
         return;
     }
 
-    node->ptr = ptr;
-    node->cleanup = cleanup;
+    bool reclaim = false;
+    uint64_t retired = 0;
+    ttak_retire_batch_t *batch = st->open_bulk;
+    if (batch && batch->bulk != cleanup) {
+        st->open_bulk = NULL;
+        reclaim |= epoch_seal_batch(st, batch);
+        batch = NULL;
+    }
 
-    uint32_t gen = TT_ATOMIC_LOAD_U32(&g_epoch_mgr.global_epoch, memory_order_acquire);
-    uint32_t tid = t_local_state->logical_tid;
+    for (size_t i = 0; i < count; i++) {
+        if (!ptrs[i]) {
+            continue;
+        }
+        if (!batch) {
+            batch = epoch_batch_acquire();
+            if (!batch) {
+                break;
+            }
+            batch->bulk = cleanup;
+            batch->owner = st;
+        }
+        batch->ptrs[batch->count++] = ptrs[i];
+        retired++;
+        if (batch->count == TTAK_EPOCH_BATCH_SIZE) {
+            reclaim |= epoch_seal_batch(st, batch);
+            batch = NULL;
+        }
+    }
+    st->open_bulk = batch;
+    TT_ATOMIC_STORE_U64(&st->retired_ptrs, TT_ATOMIC_LOAD_U64(&st->retired_ptrs, memory_order_relaxed) + retired,
+                        memory_order_relaxed);
 
-    int x, y;
-    ttak_get_ols_coords(tid, gen, &x, &y);
+    if (reclaim) {
+        ttak_epoch_reclaim();
+    }
+}
 
-    ttak_retired_node_t *old_head;
-    do {
-        old_head = (ttak_retired_node_t *)TT_ATOMIC_LOAD_PTR((void * _Atomic *)&g_ols_static_plane.buckets[x][y],
-                                                             memory_order_acquire);
-        node->next = old_head;
+/**
+ * @brief Seal the calling thread's partially filled batches.
+ */
+void ttak_epoch_flush(void) {
+    epoch_seal_thread(t_local_state);
+}
 
-        void *expected = old_head;
-        if (TT_ATOMIC_CAS_WEAK_PTR((void * _Atomic *)&g_ols_static_plane.buckets[x][y], &expected, node,
-                                  memory_order_release, memory_order_acquire)) {
-            break;
-        }
-    } while (1);
+/**
+ * @brief Set how many pending batches make a retire attempt a reclaim.
+ *
+ * @param batches Pending batch count; 0 disables automatic reclaim.
+ */
+void ttak_epoch_set_reclaim_threshold(size_t batches) {
+    uint32_t value = batches > UINT32_MAX ? UINT32_MAX : (uint32_t)batches;
+    TT_ATOMIC_STORE_U32(&g_reclaim_threshold, value, memory_order_relaxed);
 }
 
 /* --- Reclamation --- */
 
 /**
- * @brief Attempt to reclaim retired nodes if it is safe to advance the epoch.
+ * @brief Attempt to reclaim retired batches and advance the epoch.
  *
- * A reclamation is safe if all active threads have local_epoch >= current global_epoch.
- * If safe, the global epoch is incremented and all OLS buckets are drained.
+ * The caller's own open batches are sealed first. The oldest epoch among
+ * active threads bounds what can be freed: every batch sealed before it is
+ * reclaimed. If no active thread lags behind the global epoch, the epoch is
+ * advanced so the next call can free the batches sealed in this one.
  */
 void ttak_epoch_reclaim(void) {
     if (!TT_ATOMIC_LOAD_BOOL(&g_epoch_init_ready, memory_order_seq_cst)) {
         return;
     }
 
+    ttak_epoch_flush();
+
     if (pthread_mutex_trylock(&g_reclaim_lock) != 0) {
         return;
     }
+    uint64_t start_ns = ttak_get_tick_count_ns();
 
     uint32_t current = TT_ATOMIC_LOAD_U32(&g_epoch_mgr.global_epoch, memory_order_acquire);
-    bool safe = true;
+    uint32_t bound = current;
 
     TT_ATOMIC_FENCE(memory_order_seq_cst);
 
-    ttak_thread_node_t *node = (ttak_thread_node_t *)TT_ATOMIC_LOAD_PTR((void * _Atomic *)&g_thread_list,
-                                                                        memory_order_acquire);
-    while (node) {
+    uint32_t threads = TT_ATOMIC_LOAD_U32(&g_tid_counter, memory_order_acquire);
+    for (uint32_t tid = 0; tid < threads; ++tid) {
+        ttak_thread_state_t *st = epoch_state_at(tid);
 #if defined(_MSC_VER)
-        bool active = node->state->active ? true : false;
-        uint32_t local_epoch = (uint32_t)node->state->local_epoch;
+        bool active = st->active ? true : false;
+        uint32_t local_epoch = (uint32_t)st->local_epoch;
 #else
-        bool active = atomic_load_explicit(&node->state->active, memory_order_acquire);
-        uint32_t local_epoch = atomic_load_explicit(&node->state->local_epoch, memory_order_acquire);
+        bool active = atomic_load_explicit(&st->active, memory_order_acquire);
+        uint32_t local_epoch = atomic_load_explicit(&st->local_epoch, memory_order_acquire);
 #endif
 
-        if (active) {
-            if (local_epoch < current) {
-                safe = false;
-                break;
-            }
+        if (active && epoch_before(local_epoch, bound)) {
+            bound = local_epoch;
         }
-        node = node->next;
     }
 
-    if (safe) {
+    if (bound == current) {
         (void)TT_ATOMIC_FETCH_ADD_U32(&g_epoch_mgr.global_epoch, 1, memory_order_acq_rel);
+    }
 
-        for (int i = 0; i < OLS_ORDER; i++) {
-            for (int j = 0; j < OLS_ORDER; j++) {
-                ttak_retired_node_t *to_free =
-                    (ttak_retired_node_t *)TT_ATOMIC_XCHG_PTR((void * _Atomic *)&g_ols_static_plane.buckets[i][j],
-                                                             NULL, memory_order_acq_rel);
-
-                while (to_free) {
-                    ttak_retired_node_t *next = to_free->next;
-                    if (to_free->cleanup) {
-                        to_free->cleanup(to_free->ptr);
-                    }
-                    epoch_node_pool_release(to_free);
-                    to_free = next;
+    uint32_t freed = 0;
+    for (int i = 0; i < OLS_ORDER; i++) {
+        for (int j = 0; j < OLS_ORDER; j++) {
+            ttak_retire_batch_t *batch =
+                (ttak_retire_batch_t *)TT_ATOMIC_XCHG_PTR((void * _Atomic *)&g_ols_static_plane.buckets[i][j],
+                                                          NULL, memory_order_acq_rel);
+            ttak_retire_batch_t *keep = NULL;
+            ttak_retire_batch_t *keep_tail = NULL;
+
+            while (batch) {
+                ttak_retire_batch_t *next = batch->next;
+                if (epoch_before(batch->epoch, bound)) {
+                    epoch_batch_free(batch);
+                    freed++;
+                } else {
+                    batch->next = keep;
+                    keep = batch;
+                    if (!keep_tail) keep_tail = batch;
+                }
+                batch = next;
+            }
+
+            /* Splice the survivors back above anything sealed meanwhile. */
+            while (keep) {
+                ttak_retire_batch_t *old_head =
+                    (ttak_retire_batch_t *)TT_ATOMIC_LOAD_PTR((void * _Atomic *)&g_ols_static_plane.buckets[i][j],
+                                                              memory_order_acquire);
+                keep_tail->next = old_head;
+                void *expected = old_head;
+                if (TT_ATOMIC_CAS_WEAK_PTR((void * _Atomic *)&g_ols_static_plane.buckets[i][j], &expected, keep,
+                                          memory_order_release, memory_order_acquire)) {
+                    break;
                 }
             }
         }
     }
+    if (freed) {
+        (void)TT_ATOMIC_FETCH_ADD_U32(&g_pending_batches, (uint32_t)-freed, memory_order_relaxed);
+    }
 
+    uint64_t dur_ns = ttak_get_tick_count_ns() - start_ns;
+    ttak_stats_record(&g_reclaim_stats, dur_ns);
+    TTAK_TRACE(TTAK_TRACE_EPOCH_RECLAIM, freed, dur_ns);
     pthread_mutex_unlock(&g_reclaim_lock);
 }
+
+/* --- Metrics --- */
+
+static inline void epoch_thread_sample(ttak_thread_state_t *st, uint32_t current, ttak_epoch_thread_stats_t *out) {
+#if defined(_MSC_VER)
+    out->active = st->active ? true : false;
+    uint32_t local_epoch = (uint32_t)st->local_epoch;
+#else
+    out->active = atomic_load_explicit(&st->active, memory_order_acquire);
+    uint32_t local_epoch = atomic_load_explicit(&st->local_epoch, memory_order_acquire);
+#endif
+    out->logical_tid = st->logical_tid;
+    out->epoch_lag = (out->active && epoch_before(local_epoch, current)) ? current - local_epoch : 0;
+
+    /* Read the reclaimed side first so a racing reclaim cannot make pending negative. */
+    uint64_t reclaimed_ptrs = TT_ATOMIC_LOAD_U64(&st->reclaimed_ptrs, memory_order_relaxed);
+    uint64_t reclaimed_bytes = TT_ATOMIC_LOAD_U64(&st->reclaimed_bytes, memory_order_relaxed);
+    uint64_t retired_ptrs = TT_ATOMIC_LOAD_U64(&st->retired_ptrs, memory_order_relaxed);
+    uint64_t retired_bytes = TT_ATOMIC_LOAD_U64(&st->retired_bytes, memory_order_relaxed);
+    out->pending_ptrs = retired_ptrs > reclaimed_ptrs ? retired_ptrs - reclaimed_ptrs : 0;
+    out->pending_bytes = retired_bytes > reclaimed_bytes ? retired_bytes - reclaimed_bytes : 0;
+}
+
+/**
+ * @brief Copy the per-thread backlog of every logical id handed out.
+ *
+ * Ids released by exited threads are listed too, with whatever backlog
+ * their last owner left pending.
+ *
+ * @param out Destination array.
+ * @param max Capacity of @p out.
+ * @return Number of logical ids handed out.
+ */
+size_t ttak_epoch_thread_stats(ttak_epoch_thread_stats_t *out, size_t max) {
+    uint32_t current = TT_ATOMIC_LOAD_U32(&g_epoch_mgr.global_epoch, memory_order_acquire);
+    uint32_t n = TT_ATOMIC_LOAD_U32(&g_tid_counter, memory_order_acquire);
+    for (uint32_t tid = 0; out && tid < n && tid < max; ++tid) {
+        epoch_thread_sample(epoch_state_at(tid), current, &out[tid]);
+    }
+    return n;
+}
+
+/**
+ * @brief Fill @p out with process-wide EBR counters.
+ *
+ * @param out Destination snapshot.
+ */
+void ttak_epoch_stats_snapshot(ttak_epoch_stats_t *out) {
+    if (!out) {
+        return;
+    }
+    memset(out, 0, sizeof(*out));
+    if (!TT_ATOMIC_LOAD_BOOL(&g_epoch_init_ready, memory_order_seq_cst)) {
+        return;
+    }
+
+    uint32_t current = TT_ATOMIC_LOAD_U32(&g_epoch_mgr.global_epoch, memory_order_acquire);
+    out->global_epoch = current;
+    out->pending_batches = TT_ATOMIC_LOAD_U32(&g_pending_batches, memory_order_relaxed);
+
+    uint32_t threads = TT_ATOMIC_LOAD_U32(&g_tid_counter, memory_order_acquire);
+    for (uint32_t tid = 0; tid < threads; ++tid) {
+        ttak_epoch_thread_stats_t ts;
+        epoch_thread_sample(epoch_state_at(tid), current, &ts);
+        out->registered_threads++;
+        if (ts.active) {
+            out->pinned_threads++;
+        }
+        if (ts.epoch_lag > out->oldest_epoch_lag) {
+            out->oldest_epoch_lag = ts.epoch_lag;
+        }
+        out->pending_ptrs += ts.pending_ptrs;
+        out->pending_bytes += ts.pending_bytes;
+    }
+
+    ttak_stats_snapshot(&g_reclaim_stats, &out->reclaim_ns);
+}
@@ -1,7 +1,13 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <ttak/mem/epoch_gc.h>
 #include <ttak/mem/mem.h>
 #include <ttak/mem/epoch.h>
 #include <ttak/timing/timing.h>
+#include <errno.h>
+#include <sched.h>
 #include <stdio.h>
 #include <time.h>
 
@@ -36,13 +42,9 @@ static void *epoch_gc_rotate_thread(void *arg) {
         _Bool manual = atomic_load(&gc->manual_rotation);
 
         if (!manual) {
-            if (hints & TTAK_EPOCH_GC_HINT_COLLECT_NOW) {
-                ttak_epoch_gc_rotate(gc);
-                ttak_epoch_reclaim();
-                sleep_ns = atomic_load(&gc->min_rotate_ns);
-            } else if (hints & (TTAK_EPOCH_GC_HINT_ALLOC | TTAK_EPOCH_GC_HINT_FREE | TTAK_EPOCH_GC_HINT_REALLOC)) {
-                ttak_epoch_gc_rotate(gc);
-                ttak_epoch_reclaim();
+            _Bool busy = atomic_load_explicit(&gc->pressure_bytes, memory_order_relaxed) != 0;
+            if (hints & (TTAK_EPOCH_GC_HINT_COLLECT_NOW | TTAK_EPOCH_GC_HINT_ALLOC |
+                         TTAK_EPOCH_GC_HINT_FREE | TTAK_EPOCH_GC_HINT_REALLOC) || busy) {
                 sleep_ns = atomic_load(&gc->min_rotate_ns);
             } else {
                 // Idle: back off gracefully, but still rotate/reclaim at
@@ -50,16 +52,15 @@ static void *epoch_gc_rotate_thread(void *arg) {
                 sleep_ns += atomic_load(&gc->min_rotate_ns);
                 uint64_t max_ns = atomic_load(&gc->max_rotate_ns);
                 if (sleep_ns > max_ns) sleep_ns = max_ns;
-
-                ttak_epoch_gc_rotate(gc);
-                ttak_epoch_reclaim();
             }
+            ttak_epoch_gc_rotate(gc);
+            ttak_epoch_reclaim();
         } else {
             sleep_ns = atomic_load(&gc->max_rotate_ns);
         }
 
         pthread_mutex_lock(&gc->rotate_lock);
-        if (!atomic_load(&gc->shutdown_requested)) {
+        if (!atomic_load(&gc->shutdown_requested) && atomic_load(&gc->pending_hints) == 0) {
             struct timespec ts;
             epoch_gc_clock_gettime(&ts);
             uint64_t total_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec + sleep_ns;
@@ -70,6 +71,7 @@ static void *epoch_gc_rotate_thread(void *arg) {
         pthread_mutex_unlock(&gc->rotate_lock);
     }
 
+    ttak_epoch_deregister_thread();
     return NULL;
 }
 
@@ -92,15 +94,26 @@ void ttak_epoch_gc_init(ttak_epoch_gc_t *gc) {
     atomic_store(&gc->last_cleanup_ts, ttak_get_tick_count());
 
     pthread_mutex_init(&gc->rotate_lock, NULL);
+#ifdef _WIN32
     pthread_cond_init(&gc->rotate_cond, NULL);
+#else
+    /* Deadlines are computed on CLOCK_MONOTONIC; the condvar must agree. */
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&gc->rotate_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+#endif
     atomic_store(&gc->shutdown_requested, false);
     atomic_store(&gc->manual_rotation, true);
     atomic_store(&gc->min_rotate_ns, TTAK_EPOCH_GC_MIN_ROTATE_NS);
     atomic_store(&gc->max_rotate_ns, TTAK_EPOCH_GC_MAX_ROTATE_NS);
     atomic_store(&gc->pending_hints, 0);
-    /* Do not spawn a background rotate thread: it busy-waits in
-     * ttak_epoch_reclaim and consumes whole cores.  Callers rotate/reclaim
-     * explicitly. */
+    ttak_stats_init(&gc->rotate_stats, 0, TTAK_EPOCH_GC_HIST_MAX_NS);
+    atomic_store(&gc->pressure_bytes, 0);
+    atomic_store(&gc->pressure_threshold, 0);
+    /* The background rotate thread is opt-in: callers rotate/reclaim
+     * explicitly unless they call ttak_epoch_gc_start_reclaimer(). */
     gc->rotate_thread_started = false;
 }
 
@@ -112,14 +125,7 @@ void ttak_epoch_gc_init(ttak_epoch_gc_t *gc) {
  * @param gc Pointer to the GC context.
  */
 void ttak_epoch_gc_destroy(ttak_epoch_gc_t *gc) {
-    atomic_store(&gc->shutdown_requested, true);
-    pthread_mutex_lock(&gc->rotate_lock);
-    pthread_cond_signal(&gc->rotate_cond);
-    pthread_mutex_unlock(&gc->rotate_lock);
-
-    if (gc->rotate_thread_started) {
-        pthread_join(gc->rotate_thread, NULL);
-    }
+    ttak_epoch_gc_stop_reclaimer(gc);
 
     pthread_cond_destroy(&gc->rotate_cond);
     pthread_mutex_destroy(&gc->rotate_lock);
@@ -140,6 +146,13 @@ void ttak_epoch_gc_register(ttak_epoch_gc_t *gc, void *ptr, size_t size) {
     // not strictly by clock time, though mem_tree supports both.
     // We treat these as "roots" for the current epoch.
     ttak_mem_tree_add(&gc->tree, ptr, size, 0, true);
+
+    // Wake the reclaimer only on the registration that crosses the threshold.
+    size_t threshold = atomic_load_explicit(&gc->pressure_threshold, memory_order_relaxed);
+    size_t total = atomic_fetch_add_explicit(&gc->pressure_bytes, size, memory_order_relaxed) + size;
+    if (threshold && total >= threshold && total - size < threshold) {
+        ttak_epoch_gc_hint(gc, TTAK_EPOCH_GC_HINT_COLLECT_NOW);
+    }
 }
 
 /**
@@ -155,7 +168,9 @@ void ttak_epoch_gc_rotate(ttak_epoch_gc_t *gc) {
     if (!gc) return;
 
     atomic_fetch_add(&gc->current_epoch, 1);
+    atomic_store_explicit(&gc->pressure_bytes, 0, memory_order_relaxed);
 
+    uint64_t start_ns = ttak_get_tick_count_ns();
     uint64_t now = ttak_get_tick_count();
     // Perform cleanup using the current timestamp.
     // mem_tree_perform_cleanup iterates the tree and removes expired/unreferenced nodes.
@@ -163,6 +178,76 @@ void ttak_epoch_gc_rotate(ttak_epoch_gc_t *gc) {
     ttak_mem_tree_perform_cleanup(&gc->tree, now);
 
     atomic_store(&gc->last_cleanup_ts, now);
+    ttak_stats_record(&gc->rotate_stats, ttak_get_tick_count_ns() - start_ns);
+}
+
+/**
+ * @brief Starts the background reclaimer thread.
+ *
+ * @param gc Pointer to the GC context.
+ * @param config Reclaimer settings, or NULL for the defaults.
+ * @return 0 on success or an errno value.
+ */
+int ttak_epoch_gc_start_reclaimer(ttak_epoch_gc_t *gc, const ttak_epoch_gc_reclaimer_config_t *config) {
+    if (!gc) return EINVAL;
+    if (gc->rotate_thread_started) return EALREADY;
+
+    ttak_epoch_gc_reclaimer_config_t cfg = {0, 0, TTAK_EPOCH_GC_DEFAULT_PRESSURE, -1};
+    if (config) cfg = *config;
+#if !defined(__linux__)
+    if (cfg.cpu >= 0) return ENOTSUP;
+#endif
+    if (cfg.min_interval_ns) atomic_store(&gc->min_rotate_ns, cfg.min_interval_ns);
+    if (cfg.max_interval_ns) atomic_store(&gc->max_rotate_ns, cfg.max_interval_ns);
+    if (atomic_load(&gc->max_rotate_ns) < atomic_load(&gc->min_rotate_ns)) {
+        atomic_store(&gc->max_rotate_ns, atomic_load(&gc->min_rotate_ns));
+    }
+
+    atomic_store(&gc->shutdown_requested, false);
+    atomic_store(&gc->manual_rotation, false);
+    int rc = pthread_create(&gc->rotate_thread, NULL, epoch_gc_rotate_thread, gc);
+    if (rc != 0) {
+        atomic_store(&gc->manual_rotation, true);
+        return rc;
+    }
+    gc->rotate_thread_started = true;
+
+#if defined(__linux__)
+    if (cfg.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cfg.cpu, &set);
+        rc = pthread_setaffinity_np(gc->rotate_thread, sizeof(set), &set);
+        if (rc != 0) {
+            ttak_epoch_gc_stop_reclaimer(gc);
+            return rc;
+        }
+    }
+#endif
+
+    atomic_store(&gc->pressure_threshold, cfg.pressure_bytes);
+    return 0;
+}
+
+/**
+ * @brief Stops and joins the background reclaimer thread.
+ *
+ * @param gc Pointer to the GC context.
+ */
+void ttak_epoch_gc_stop_reclaimer(ttak_epoch_gc_t *gc) {
+    if (!gc) return;
+    atomic_store(&gc->pressure_threshold, 0);
+    atomic_store(&gc->shutdown_requested, true);
+    pthread_mutex_lock(&gc->rotate_lock);
+    pthread_cond_signal(&gc->rotate_cond);
+    pthread_mutex_unlock(&gc->rotate_lock);
+
+    if (gc->rotate_thread_started) {
+        pthread_join(gc->rotate_thread, NULL);
+        gc->rotate_thread_started = false;
+    }
+    atomic_store(&gc->manual_rotation, true);
+    atomic_store(&gc->shutdown_requested, false);
 }
 
 void ttak_epoch_gc_manual_rotate(ttak_epoch_gc_t *gc, _Bool manual_mode) {
@@ -182,3 +267,16 @@ void ttak_epoch_gc_hint(ttak_epoch_gc_t *gc, ttak_epoch_gc_hint_t hint) {
         pthread_mutex_unlock(&gc->rotate_lock);
     }
 }
+
+/**
+ * @brief Copies the GC counters and merges the rotate histogram.
+ *
+ * @param gc Pointer to the GC context.
+ * @param out Destination snapshot.
+ */
+void ttak_epoch_gc_stats_snapshot(ttak_epoch_gc_t *gc, ttak_epoch_gc_stats_t *out) {
+    if (!gc || !out) return;
+    out->epoch = atomic_load(&gc->current_epoch);
+    out->last_cleanup_ts = atomic_load(&gc->last_cleanup_ts);
+    ttak_stats_snapshot(&gc->rotate_stats, &out->rotate_ns);
+}
@@ -3,7 +3,13 @@
  * @brief Compiler/arch-specific fast memory allocation hot path.
  *
  * Contains inline-assembly optimised allocation sequences for TinyCC on
- * x86-64.  The generic C fallback is used on all other targets.
+ * x86-64.  The generic C fallback is used on all other TinyCC targets.
+ *
+ * Other compilers get the large-buffer half of ttak_mem_stream_zero() and
+ * ttak_mem_stream_copy(): non-temporal store kernels chosen at runtime from
+ * ttak_arch_features(), and a crossover measured once against memcpy.
+ * Kernels only see a 64-byte aligned destination and a multiple of 64
+ * bytes; the wrappers handle the ragged edges and the store fence.
  * @warning This file contains platform-specific inline assembly.
  *          Do not modify the assembly blocks without testing all targets.
  */
@@ -282,4 +288,283 @@ void ttak_mem_stream_copy(void *dst, const void *src, size_t len) {
 #endif
 }
 
+#else /* !__TINYC__ */
+
+#include <ttak/arch/ttak_arch.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(TTAK_ARCH_X86_64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#include <immintrin.h>
+#define TTAK_MEM_STREAM_X86 1
+#elif defined(TTAK_ARCH_AARCH64) && (defined(TTAK_COMPILER_GCC) || defined(TTAK_COMPILER_CLANG))
+#define TTAK_MEM_STREAM_AARCH64 1
+#endif
+
+/** @brief Largest buffer the calibration copies. */
+#define TTAK_MEM_STREAM_CALIBRATE_MAX_BYTES (4U * 1024U * 1024U)
+#define TTAK_MEM_STREAM_CALIBRATE_REPS 3
+
+typedef void (*ttak_mem_stream_copy_fn)(uint8_t *dst, const uint8_t *src, size_t len);
+typedef void (*ttak_mem_stream_zero_fn)(uint8_t *dst, size_t len);
+
+typedef struct {
+    const char *name;
+    ttak_mem_stream_copy_fn copy;
+    ttak_mem_stream_zero_fn zero;
+} ttak_mem_stream_kernels_t;
+
+static ttak_mem_stream_kernels_t g_stream_kernels = { "none", NULL, NULL };
+static _Atomic size_t g_stream_threshold = SIZE_MAX;
+static atomic_bool g_stream_overridden = false;
+static pthread_once_t g_stream_once = PTHREAD_ONCE_INIT;
+
+#if defined(TTAK_MEM_STREAM_X86)
+static void ttak_mem_stream_copy_sse2(uint8_t *dst, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; i += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(src + i + 48));
+        _mm_stream_si128((__m128i *)(dst + i), a);
+        _mm_stream_si128((__m128i *)(dst + i + 16), b);
+        _mm_stream_si128((__m128i *)(dst + i + 32), c);
+        _mm_stream_si128((__m128i *)(dst + i + 48), d);
+    }
+}
+
+static void ttak_mem_stream_zero_sse2(uint8_t *dst, size_t len) {
+    __m128i z = _mm_setzero_si128();
+    for (size_t i = 0; i < len; i += 64) {
+        _mm_stream_si128((__m128i *)(dst + i), z);
+        _mm_stream_si128((__m128i *)(dst + i + 16), z);
+        _mm_stream_si128((__m128i *)(dst + i + 32), z);
+        _mm_stream_si128((__m128i *)(dst + i + 48), z);
+    }
+}
+
+__attribute__((target("avx2")))
+static void ttak_mem_stream_copy_avx2(uint8_t *dst, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; i += 64) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src + i + 32));
+        _mm256_stream_si256((__m256i *)(dst + i), a);
+        _mm256_stream_si256((__m256i *)(dst + i + 32), b);
+    }
+}
+
+__attribute__((target("avx2")))
+static void ttak_mem_stream_zero_avx2(uint8_t *dst, size_t len) {
+    __m256i z = _mm256_setzero_si256();
+    for (size_t i = 0; i < len; i += 64) {
+        _mm256_stream_si256((__m256i *)(dst + i), z);
+        _mm256_stream_si256((__m256i *)(dst + i + 32), z);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void ttak_mem_stream_copy_avx512(uint8_t *dst, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; i += 64) {
+        __m512i a = _mm512_loadu_si512((const void *)(src + i));
+        _mm512_stream_si512((__m512i *)(dst + i), a);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void ttak_mem_stream_zero_avx512(uint8_t *dst, size_t len) {
+    __m512i z = _mm512_setzero_si512();
+    for (size_t i = 0; i < len; i += 64) {
+        _mm512_stream_si512((__m512i *)(dst + i), z);
+    }
+}
+
+static inline void ttak_mem_stream_fence(void) {
+    _mm_sfence();
+}
+#elif defined(TTAK_MEM_STREAM_AARCH64)
+static void ttak_mem_stream_copy_neon(uint8_t *dst, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; i += 64) {
+        __asm__ volatile(
+            "ldp q0, q1, [%1]\n"
+            "ldp q2, q3, [%1, #32]\n"
+            "stnp q0, q1, [%0]\n"
+            "stnp q2, q3, [%0, #32]\n"
+            :
+            : "r"(dst + i), "r"(src + i)
+            : "v0", "v1", "v2", "v3", "memory");
+    }
+}
+
+static void ttak_mem_stream_zero_neon(uint8_t *dst, size_t len) {
+    for (size_t i = 0; i < len; i += 64) {
+        __asm__ volatile(
+            "stnp xzr, xzr, [%0]\n"
+            "stnp xzr, xzr, [%0, #16]\n"
+            "stnp xzr, xzr, [%0, #32]\n"
+            "stnp xzr, xzr, [%0, #48]\n"
+            :
+            : "r"(dst + i)
+            : "memory");
+    }
+}
+
+static inline void ttak_mem_stream_fence(void) {
+    __asm__ volatile("dmb ishst" ::: "memory");
+}
+#else
+static inline void ttak_mem_stream_fence(void) {
+}
+#endif
+
+static void ttak_mem_stream_select(void) {
+    uint32_t features = ttak_arch_features();
+    (void)features;
+#if defined(TTAK_MEM_STREAM_X86)
+    if (features & TTAK_ARCH_FEATURE_AVX512F) {
+        g_stream_kernels = (ttak_mem_stream_kernels_t){ "avx512", ttak_mem_stream_copy_avx512, ttak_mem_stream_zero_avx512 };
+    } else if (features & TTAK_ARCH_FEATURE_AVX2) {
+        g_stream_kernels = (ttak_mem_stream_kernels_t){ "avx2", ttak_mem_stream_copy_avx2, ttak_mem_stream_zero_avx2 };
+    } else {
+        g_stream_kernels = (ttak_mem_stream_kernels_t){ "sse2", ttak_mem_stream_copy_sse2, ttak_mem_stream_zero_sse2 };
+    }
+#elif defined(TTAK_MEM_STREAM_AARCH64)
+    /* SVE hosts use STNP too: stnt1 gains nothing over it at 128-bit vectors. */
+    if (features & (TTAK_ARCH_FEATURE_NEON | TTAK_ARCH_FEATURE_SVE)) {
+        g_stream_kernels = (ttak_mem_stream_kernels_t){ "neon", ttak_mem_stream_copy_neon, ttak_mem_stream_zero_neon };
+    }
+#endif
+}
+
+static void ttak_mem_stream_copy_nt(uint8_t *dst, const uint8_t *src, size_t len) {
+    size_t head = (size_t)(-(uintptr_t)dst & 63U);
+    if (head > len) head = len;
+    memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    len -= head;
+
+    size_t body = len & ~(size_t)63U;
+    g_stream_kernels.copy(dst, src, body);
+    ttak_mem_stream_fence();
+    memcpy(dst + body, src + body, len - body);
+}
+
+static void ttak_mem_stream_zero_nt(uint8_t *dst, size_t len) {
+    size_t head = (size_t)(-(uintptr_t)dst & 63U);
+    if (head > len) head = len;
+    memset(dst, 0, head);
+    dst += head;
+    len -= head;
+
+    size_t body = len & ~(size_t)63U;
+    g_stream_kernels.zero(dst, body);
+    ttak_mem_stream_fence();
+    memset(dst + body, 0, len - body);
+}
+
+static uint64_t ttak_mem_stream_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t ttak_mem_stream_time(uint8_t *dst, const uint8_t *src, size_t len, bool streaming) {
+    uint64_t best = UINT64_MAX;
+    for (int rep = 0; rep < TTAK_MEM_STREAM_CALIBRATE_REPS; ++rep) {
+        uint64_t start = ttak_mem_stream_now_ns();
+        if (streaming) {
+            ttak_mem_stream_copy_nt(dst, src, len);
+        } else {
+            memcpy(dst, src, len);
+        }
+        uint64_t elapsed = ttak_mem_stream_now_ns() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+/**
+ * @brief Picks the kernel and finds the first size where it beats memcpy.
+ *
+ * Sizes grow by 4x from TTAK_MEM_STREAM_NT_MIN_BYTES. Streaming must win by
+ * 10% to count. If it never does, the probe stayed cache resident, so the
+ * crossover is placed well past the largest size probed.
+ */
+static void ttak_mem_stream_calibrate(void) {
+    ttak_mem_stream_select();
+    if (!g_stream_kernels.copy || atomic_load(&g_stream_overridden)) return;
+
+    uint8_t *src = malloc(TTAK_MEM_STREAM_CALIBRATE_MAX_BYTES);
+    uint8_t *dst = malloc(TTAK_MEM_STREAM_CALIBRATE_MAX_BYTES);
+    size_t threshold = 4U * TTAK_MEM_STREAM_CALIBRATE_MAX_BYTES;
+    if (src && dst) {
+        memset(src, 0x5a, TTAK_MEM_STREAM_CALIBRATE_MAX_BYTES);
+        memset(dst, 0, TTAK_MEM_STREAM_CALIBRATE_MAX_BYTES);
+        for (size_t len = TTAK_MEM_STREAM_NT_MIN_BYTES; len <= TTAK_MEM_STREAM_CALIBRATE_MAX_BYTES; len *= 4U) {
+            uint64_t cached = ttak_mem_stream_time(dst, src, len, false);
+            uint64_t streamed = ttak_mem_stream_time(dst, src, len, true);
+            if (streamed * 10U < cached * 9U) {
+                threshold = len;
+                break;
+            }
+        }
+    }
+    free(src);
+    free(dst);
+
+    if (!atomic_load(&g_stream_overridden)) {
+        atomic_store_explicit(&g_stream_threshold, threshold, memory_order_relaxed);
+    }
+}
+
+static inline bool ttak_mem_stream_use_nt(size_t len) {
+    pthread_once(&g_stream_once, ttak_mem_stream_calibrate);
+    return g_stream_kernels.copy &&
+           len >= atomic_load_explicit(&g_stream_threshold, memory_order_relaxed);
+}
+
+void ttak_mem_stream_zero_large(void *dst, size_t len) {
+    if (ttak_mem_stream_use_nt(len)) {
+        ttak_mem_stream_zero_nt((uint8_t *)dst, len);
+    } else if (len) {
+        memset(dst, 0, len);
+    }
+}
+
+void ttak_mem_stream_copy_large(void *dst, const void *src, size_t len) {
+    if (ttak_mem_stream_use_nt(len)) {
+        ttak_mem_stream_copy_nt((uint8_t *)dst, (const uint8_t *)src, len);
+    } else if (len) {
+        memcpy(dst, src, len);
+    }
+}
+
+void ttak_mem_stream_copy_uncached(void *dst, const void *src, size_t len) {
+    pthread_once(&g_stream_once, ttak_mem_stream_calibrate);
+    if (g_stream_kernels.copy && len >= 64U) {
+        ttak_mem_stream_copy_nt((uint8_t *)dst, (const uint8_t *)src, len);
+    } else if (len) {
+        memcpy(dst, src, len);
+    }
+}
+
+size_t ttak_mem_stream_nt_threshold(void) {
+    pthread_once(&g_stream_once, ttak_mem_stream_calibrate);
+    return g_stream_kernels.copy ? atomic_load_explicit(&g_stream_threshold, memory_order_relaxed) : SIZE_MAX;
+}
+
+void ttak_mem_stream_set_nt_threshold(size_t bytes) {
+    atomic_store(&g_stream_overridden, true);
+    atomic_store_explicit(&g_stream_threshold, bytes, memory_order_relaxed);
+}
+
+const char *ttak_mem_stream_kernel(void) {
+    pthread_once(&g_stream_once, ttak_mem_stream_calibrate);
+    return g_stream_kernels.name;
+}
+
 #endif /* __TINYC__ */
@@ -0,0 +1,310 @@
+/**
+ * @file governor.c
+ * @brief Memory governor driven by the system usage sampler.
+ *
+ * Classification and shedding run on the sampler thread, inside its
+ * post-sample hook. Registration only touches the slot arrays under
+ * @c lock. A pass copies the slots out first and runs under @c shed_lock,
+ * so a callback is never called after its removal returns.
+ */
+
+#include <ttak/mem/governor.h>
+#include <ttak/mem/mem.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mem/epoch_gc.h>
+#include <ttak/mem/detachable.h>
+#include <ttak/mem_tree/mem_tree.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define GOV_DEFAULT_SOFT_PCT 80.0
+#define GOV_DEFAULT_HARD_PCT 92.0
+#define GOV_DEFAULT_PSI_SOFT 10.0
+#define GOV_DEFAULT_PSI_HARD 5.0
+#define GOV_DEFAULT_COOLDOWN_NS 250000000ULL
+#define GOV_DEFAULT_HZ 10U
+
+typedef struct {
+    ttak_mem_pressure_fn fn;
+    void *arg;
+} gov_callback_t;
+
+typedef struct {
+    pthread_mutex_t lock;               /**< Guards the settings and slot arrays. */
+    pthread_mutex_t shed_lock;          /**< Held for the whole of a shedding pass. */
+    ttak_mem_governor_config_t cfg;
+    bool active;
+    bool owns_sampler;                  /**< The governor started the sampler and stops it. */
+    gov_callback_t callbacks[TTAK_MEM_GOVERNOR_SLOTS];
+    size_t ncallbacks;
+    void *trees[TTAK_MEM_GOVERNOR_SLOTS];     /**< ttak_mem_tree_t pointers. */
+    size_t ntrees;
+    void *gcs[TTAK_MEM_GOVERNOR_SLOTS];       /**< ttak_epoch_gc_t pointers. */
+    size_t ngcs;
+
+    _Atomic int level;
+    _Atomic uint64_t usage_bytes;
+    _Atomic uint64_t limit_bytes;
+    _Atomic uint64_t sheds;
+    _Atomic uint64_t released_bytes;
+
+    /* Written by the hook only; the sampler serialises hook calls. */
+    ttak_mem_pressure_t last_shed_level;
+    uint64_t last_shed_ns;
+} governor_t;
+
+static governor_t g_gov = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .shed_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static void governor_fill_defaults(ttak_mem_governor_config_t *cfg) {
+    if (cfg->soft_pct <= 0.0) cfg->soft_pct = GOV_DEFAULT_SOFT_PCT;
+    if (cfg->hard_pct <= 0.0) cfg->hard_pct = GOV_DEFAULT_HARD_PCT;
+    if (cfg->hard_pct < cfg->soft_pct) cfg->hard_pct = cfg->soft_pct;
+    if (cfg->psi_soft == 0.0) cfg->psi_soft = GOV_DEFAULT_PSI_SOFT;
+    if (cfg->psi_hard == 0.0) cfg->psi_hard = GOV_DEFAULT_PSI_HARD;
+    if (cfg->cooldown_ns == 0) cfg->cooldown_ns = GOV_DEFAULT_COOLDOWN_NS;
+    if (cfg->hz == 0) cfg->hz = GOV_DEFAULT_HZ;
+}
+
+static ttak_mem_pressure_t governor_classify(const ttak_mem_governor_config_t *cfg, const ttak_sys_snapshot_t *snap,
+                                             uint64_t *usage_out, uint64_t *limit_out) {
+    uint64_t limit = cfg->limit_bytes;
+    uint64_t usage = snap->rss_bytes;
+    if (!limit && snap->has_cgroup_mem) {
+        limit = snap->cgroup_mem_high < snap->cgroup_mem_max ? snap->cgroup_mem_high : snap->cgroup_mem_max;
+        if (limit == UINT64_MAX) limit = 0;
+        usage = snap->cgroup_mem_current;
+    }
+    ttak_mem_pressure_t level = TTAK_MEM_PRESSURE_NONE;
+    if (limit) {
+        double pct = (double)usage * 100.0 / (double)limit;
+        if (pct >= cfg->hard_pct) level = TTAK_MEM_PRESSURE_HARD;
+        else if (pct >= cfg->soft_pct) level = TTAK_MEM_PRESSURE_SOFT;
+    }
+    if (snap->has_psi) {
+        if (cfg->psi_hard >= 0.0 && snap->psi_mem.full_avg10 >= cfg->psi_hard) {
+            level = TTAK_MEM_PRESSURE_HARD;
+        } else if (cfg->psi_soft >= 0.0 && snap->psi_mem.some_avg10 >= cfg->psi_soft &&
+                   level == TTAK_MEM_PRESSURE_NONE) {
+            level = TTAK_MEM_PRESSURE_SOFT;
+        }
+    }
+    if (usage_out) *usage_out = usage;
+    if (limit_out) *limit_out = limit;
+    return level;
+}
+
+static void governor_on_sample(const ttak_sys_snapshot_t *snap, void *arg) {
+    governor_t *gov = arg;
+    pthread_mutex_lock(&gov->lock);
+    ttak_mem_governor_config_t cfg = gov->cfg;
+    pthread_mutex_unlock(&gov->lock);
+
+    uint64_t usage, limit;
+    ttak_mem_pressure_t level = governor_classify(&cfg, snap, &usage, &limit);
+    atomic_store_explicit(&gov->usage_bytes, usage, memory_order_relaxed);
+    atomic_store_explicit(&gov->limit_bytes, limit, memory_order_relaxed);
+    atomic_store_explicit(&gov->level, (int)level, memory_order_relaxed);
+
+    if (level == TTAK_MEM_PRESSURE_NONE) {
+        gov->last_shed_level = TTAK_MEM_PRESSURE_NONE;
+        return;
+    }
+    /* Shed on every escalation, then once per cooldown while it lasts. */
+    if (level > gov->last_shed_level || snap->ts_ns - gov->last_shed_ns >= cfg.cooldown_ns) {
+        ttak_mem_governor_shed(level, snap);
+        gov->last_shed_level = level;
+        gov->last_shed_ns = snap->ts_ns;
+    }
+}
+
+int ttak_mem_governor_start(const ttak_mem_governor_config_t *cfg) {
+    governor_t *gov = &g_gov;
+    ttak_mem_governor_config_t next;
+    if (cfg) next = *cfg;
+    else memset(&next, 0, sizeof(next));
+    governor_fill_defaults(&next);
+
+    pthread_mutex_lock(&gov->lock);
+    gov->cfg = next;
+    if (gov->active) {
+        pthread_mutex_unlock(&gov->lock);
+        return 0;
+    }
+    if (!ttak_sys_sampler_running()) {
+        if (ttak_sys_sampler_start(next.hz) != 0) {
+            pthread_mutex_unlock(&gov->lock);
+            return -1;
+        }
+        gov->owns_sampler = true;
+    }
+    gov->last_shed_level = TTAK_MEM_PRESSURE_NONE;
+    gov->last_shed_ns = 0;
+    gov->active = true;
+    pthread_mutex_unlock(&gov->lock);
+    ttak_sys_sampler_set_hook(governor_on_sample, gov);
+    return 0;
+}
+
+void ttak_mem_governor_stop(void) {
+    governor_t *gov = &g_gov;
+    pthread_mutex_lock(&gov->lock);
+    if (!gov->active) {
+        pthread_mutex_unlock(&gov->lock);
+        return;
+    }
+    gov->active = false;
+    bool owns = gov->owns_sampler;
+    gov->owns_sampler = false;
+    pthread_mutex_unlock(&gov->lock);
+
+    ttak_sys_sampler_set_hook(NULL, NULL);
+    if (owns) ttak_sys_sampler_stop();
+    atomic_store_explicit(&gov->level, TTAK_MEM_PRESSURE_NONE, memory_order_relaxed);
+}
+
+ttak_mem_pressure_t ttak_mem_governor_level(void) {
+    return (ttak_mem_pressure_t)atomic_load_explicit(&g_gov.level, memory_order_relaxed);
+}
+
+ttak_mem_pressure_t ttak_mem_governor_classify(const ttak_sys_snapshot_t *snap) {
+    if (!snap) return TTAK_MEM_PRESSURE_NONE;
+    pthread_mutex_lock(&g_gov.lock);
+    ttak_mem_governor_config_t cfg = g_gov.cfg;
+    pthread_mutex_unlock(&g_gov.lock);
+    governor_fill_defaults(&cfg);
+    return governor_classify(&cfg, snap, NULL, NULL);
+}
+
+size_t ttak_mem_governor_shed(ttak_mem_pressure_t level, const ttak_sys_snapshot_t *snap) {
+    governor_t *gov = &g_gov;
+    if (level == TTAK_MEM_PRESSURE_NONE) return 0;
+    ttak_sys_snapshot_t latest;
+    if (!snap) {
+        if (!ttak_sys_sampler_read(&latest)) memset(&latest, 0, sizeof(latest));
+        snap = &latest;
+    }
+
+    pthread_mutex_lock(&gov->shed_lock);
+    gov_callback_t callbacks[TTAK_MEM_GOVERNOR_SLOTS];
+    void *trees[TTAK_MEM_GOVERNOR_SLOTS];
+    void *gcs[TTAK_MEM_GOVERNOR_SLOTS];
+    pthread_mutex_lock(&gov->lock);
+    size_t ncallbacks = gov->ncallbacks, ntrees = gov->ntrees, ngcs = gov->ngcs;
+    memcpy(callbacks, gov->callbacks, ncallbacks * sizeof(callbacks[0]));
+    memcpy(trees, gov->trees, ntrees * sizeof(trees[0]));
+    memcpy(gcs, gov->gcs, ngcs * sizeof(gcs[0]));
+    pthread_mutex_unlock(&gov->lock);
+
+    /* Cheapest first: garbage that is already dead, then caches, then the user. */
+    ttak_epoch_reclaim();
+    for (size_t i = 0; i < ngcs; ++i) {
+        ttak_epoch_gc_t *gc = gcs[i];
+        if (gc->rotate_thread_started) ttak_epoch_gc_hint(gc, TTAK_EPOCH_GC_HINT_COLLECT_NOW);
+        else ttak_epoch_gc_rotate(gc);
+    }
+    for (size_t i = 0; i < ntrees; ++i) {
+        ttak_mem_tree_t *tree = trees[i];
+        ttak_mem_tree_report_pressure(tree, atomic_load(&tree->pressure_threshold));
+    }
+    size_t released = ttak_detachable_trim_all();
+    if (level == TTAK_MEM_PRESSURE_HARD) released += ttak_mem_trim();
+    for (size_t i = 0; i < ncallbacks; ++i) {
+        released += callbacks[i].fn(level, snap, callbacks[i].arg);
+    }
+    pthread_mutex_unlock(&gov->shed_lock);
+
+    atomic_fetch_add_explicit(&gov->sheds, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&gov->released_bytes, released, memory_order_relaxed);
+    return released;
+}
+
+int ttak_mem_governor_add_callback(ttak_mem_pressure_fn fn, void *arg) {
+    if (!fn) return -1;
+    pthread_mutex_lock(&g_gov.lock);
+    int rc = -1;
+    if (g_gov.ncallbacks < TTAK_MEM_GOVERNOR_SLOTS) {
+        g_gov.callbacks[g_gov.ncallbacks++] = (gov_callback_t){ fn, arg };
+        rc = 0;
+    }
+    pthread_mutex_unlock(&g_gov.lock);
+    return rc;
+}
+
+void ttak_mem_governor_remove_callback(ttak_mem_pressure_fn fn, void *arg) {
+    pthread_mutex_lock(&g_gov.shed_lock);
+    pthread_mutex_lock(&g_gov.lock);
+    for (size_t i = 0; i < g_gov.ncallbacks; ++i) {
+        if (g_gov.callbacks[i].fn == fn && g_gov.callbacks[i].arg == arg) {
+            g_gov.callbacks[i] = g_gov.callbacks[--g_gov.ncallbacks];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_gov.lock);
+    pthread_mutex_unlock(&g_gov.shed_lock);
+}
+
+/* Slot helpers for the pointer arrays; both run under g_gov.lock. */
+static int governor_slot_add(void **slots, size_t *n, void *p) {
+    for (size_t i = 0; i < *n; ++i) {
+        if (slots[i] == p) return 0;
+    }
+    if (*n == TTAK_MEM_GOVERNOR_SLOTS) return -1;
+    slots[(*n)++] = p;
+    return 0;
+}
+
+static void governor_slot_remove(void **slots, size_t *n, void *p) {
+    for (size_t i = 0; i < *n; ++i) {
+        if (slots[i] == p) {
+            slots[i] = slots[--*n];
+            return;
+        }
+    }
+}
+
+int ttak_mem_governor_watch_tree(ttak_mem_tree_t *tree) {
+    if (!tree) return -1;
+    pthread_mutex_lock(&g_gov.lock);
+    int rc = governor_slot_add(g_gov.trees, &g_gov.ntrees, tree);
+    pthread_mutex_unlock(&g_gov.lock);
+    return rc;
+}
+
+void ttak_mem_governor_unwatch_tree(ttak_mem_tree_t *tree) {
+    pthread_mutex_lock(&g_gov.shed_lock);
+    pthread_mutex_lock(&g_gov.lock);
+    governor_slot_remove(g_gov.trees, &g_gov.ntrees, tree);
+    pthread_mutex_unlock(&g_gov.lock);
+    pthread_mutex_unlock(&g_gov.shed_lock);
+}
+
+int ttak_mem_governor_watch_gc(ttak_epoch_gc_t *gc) {
+    if (!gc) return -1;
+    pthread_mutex_lock(&g_gov.lock);
+    int rc = governor_slot_add(g_gov.gcs, &g_gov.ngcs, gc);
+    pthread_mutex_unlock(&g_gov.lock);
+    return rc;
+}
+
+void ttak_mem_governor_unwatch_gc(ttak_epoch_gc_t *gc) {
+    pthread_mutex_lock(&g_gov.shed_lock);
+    pthread_mutex_lock(&g_gov.lock);
+    governor_slot_remove(g_gov.gcs, &g_gov.ngcs, gc);
+    pthread_mutex_unlock(&g_gov.lock);
+    pthread_mutex_unlock(&g_gov.shed_lock);
+}
+
+void ttak_mem_governor_stats(ttak_mem_governor_stats_t *out) {
+    if (!out) return;
+    out->level = ttak_mem_governor_level();
+    out->usage_bytes = atomic_load_explicit(&g_gov.usage_bytes, memory_order_relaxed);
+    out->limit_bytes = atomic_load_explicit(&g_gov.limit_bytes, memory_order_relaxed);
+    out->sheds = atomic_load_explicit(&g_gov.sheds, memory_order_relaxed);
+    out->released_bytes = atomic_load_explicit(&g_gov.released_bytes, memory_order_relaxed);
+}
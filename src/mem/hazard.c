@@ -0,0 +1,283 @@
+/**
+ * @file hazard.c
+ * @brief Hazard-pointer reclamation.
+ *
+ * Each thread claims a ttak_hazard_record_t from a global, append-only list
+ * and keeps its retirements in a private array. Once the array reaches the
+ * scan threshold (twice the number of published slots, at least
+ * TTAK_HAZARD_SCAN_MIN), the thread snapshots every slot, sorts the
+ * snapshot and frees the retirements that do not appear in it. Records are
+ * recycled rather than freed so readers of the list never see them vanish.
+ */
+
+#include <ttak/mem/hazard.h>
+#include <ttak/mem/mem.h>
+#include <ttak/types/ttak_compiler.h>
+#include "../../internal/app_types.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    void *ptr;
+    void (*cleanup)(void *);
+} ttak_hazard_retired_t;
+
+/**
+ * @brief Per-thread hazard slots and retire list.
+ *
+ * @c slots are read by every scanning thread; everything else belongs to
+ * the thread holding the record.
+ */
+typedef struct ttak_hazard_record {
+    void * _Atomic slots[TTAK_HAZARD_SLOTS];
+    _Atomic bool in_use;
+    struct ttak_hazard_record *next;    /**< Immutable once the record is published. */
+    uint32_t depth;                     /**< Number of slots currently in use. */
+    ttak_hazard_retired_t *retired;
+    size_t retired_count;
+    size_t retired_cap;
+} ttak_hazard_record_t;
+
+static ttak_hazard_record_t * _Atomic g_hazard_records = NULL;
+static _Atomic size_t g_hazard_record_count = 0;
+
+/** @brief Retirements left behind by exiting threads, adopted by the next scan. */
+static ttak_hazard_retired_t *g_orphans = NULL;
+static size_t g_orphan_count = 0;
+static _Atomic size_t g_orphan_pending = 0;
+static pthread_mutex_t g_orphan_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static TTAK_THREAD_LOCAL ttak_hazard_record_t *t_hazard = NULL;
+
+static pthread_key_t g_hazard_exit_key;
+static pthread_once_t g_hazard_exit_once = PTHREAD_ONCE_INIT;
+
+static void hazard_thread_exit(void *arg) {
+    (void)arg;
+    ttak_hazard_deregister_thread();
+}
+
+static void hazard_exit_key_init(void) {
+    pthread_key_create(&g_hazard_exit_key, hazard_thread_exit);
+}
+
+static bool hazard_reserve(ttak_hazard_record_t *rec, size_t extra) {
+    size_t need = rec->retired_count + extra;
+    if (need <= rec->retired_cap) return true;
+    size_t cap = rec->retired_cap ? rec->retired_cap * 2 : TTAK_HAZARD_SCAN_MIN * 2;
+    while (cap < need) cap *= 2;
+    ttak_hazard_retired_t *grown = (ttak_hazard_retired_t *)realloc(rec->retired, cap * sizeof(*grown));
+    if (!grown) return false;
+    rec->retired = grown;
+    rec->retired_cap = cap;
+    return true;
+}
+
+void ttak_hazard_register_thread(void) {
+    if (t_hazard) return;
+
+    ttak_hazard_record_t *rec = atomic_load_explicit(&g_hazard_records, memory_order_acquire);
+    for (; rec; rec = rec->next) {
+        bool expected = false;
+        if (!atomic_load_explicit(&rec->in_use, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&rec->in_use, &expected, true,
+                                                    memory_order_acq_rel, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (!rec) {
+        rec = (ttak_hazard_record_t *)ttak_dangerous_calloc(1, sizeof(ttak_hazard_record_t));
+        if (!rec) return;
+        for (int i = 0; i < TTAK_HAZARD_SLOTS; i++) atomic_init(&rec->slots[i], NULL);
+        atomic_init(&rec->in_use, true);
+
+        ttak_hazard_record_t *head = atomic_load_explicit(&g_hazard_records, memory_order_acquire);
+        do {
+            rec->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&g_hazard_records, &head, rec,
+                                                        memory_order_release, memory_order_acquire));
+        atomic_fetch_add_explicit(&g_hazard_record_count, 1, memory_order_relaxed);
+    }
+
+    rec->depth = 0;
+    t_hazard = rec;
+    pthread_once(&g_hazard_exit_once, hazard_exit_key_init);
+    pthread_setspecific(g_hazard_exit_key, rec);
+}
+
+void ttak_hazard_deregister_thread(void) {
+    ttak_hazard_record_t *rec = t_hazard;
+    if (!rec) return;
+
+    for (int i = 0; i < TTAK_HAZARD_SLOTS; i++) {
+        atomic_store_explicit(&rec->slots[i], NULL, memory_order_release);
+    }
+    rec->depth = 0;
+    ttak_hazard_scan();
+
+    if (rec->retired_count) {
+        pthread_mutex_lock(&g_orphan_lock);
+        ttak_hazard_retired_t *grown =
+            (ttak_hazard_retired_t *)realloc(g_orphans, (g_orphan_count + rec->retired_count) * sizeof(*grown));
+        if (grown) {
+            memcpy(grown + g_orphan_count, rec->retired, rec->retired_count * sizeof(*grown));
+            g_orphans = grown;
+            g_orphan_count += rec->retired_count;
+            atomic_store_explicit(&g_orphan_pending, g_orphan_count, memory_order_relaxed);
+            rec->retired_count = 0;
+        }
+        pthread_mutex_unlock(&g_orphan_lock);
+    }
+    /* On allocation failure the leftovers stay with the record for its next owner. */
+
+    pthread_setspecific(g_hazard_exit_key, NULL);
+    t_hazard = NULL;
+    atomic_store_explicit(&rec->in_use, false, memory_order_release);
+}
+
+static inline ttak_hazard_record_t *hazard_current(void) {
+    if (TTAK_UNLIKELY(!t_hazard)) ttak_hazard_register_thread();
+    return t_hazard;
+}
+
+void *ttak_hazard_protect(void * _Atomic *src) {
+    ttak_hazard_record_t *rec = hazard_current();
+    if (TTAK_UNLIKELY(!rec || rec->depth >= TTAK_HAZARD_SLOTS)) return NULL;
+
+    void * _Atomic *slot = &rec->slots[rec->depth++];
+    void *ptr = atomic_load_explicit(src, memory_order_acquire);
+    for (;;) {
+        atomic_store_explicit(slot, ptr, memory_order_seq_cst);
+        void *again = atomic_load_explicit(src, memory_order_seq_cst);
+        if (TTAK_LIKELY(again == ptr)) return ptr;
+        ptr = again;
+    }
+}
+
+bool ttak_hazard_publish(void *ptr) {
+    ttak_hazard_record_t *rec = hazard_current();
+    if (TTAK_UNLIKELY(!rec || rec->depth >= TTAK_HAZARD_SLOTS)) return false;
+    atomic_store_explicit(&rec->slots[rec->depth++], ptr, memory_order_seq_cst);
+    return true;
+}
+
+size_t ttak_hazard_available(void) {
+    ttak_hazard_record_t *rec = hazard_current();
+    return rec ? TTAK_HAZARD_SLOTS - rec->depth : 0;
+}
+
+void ttak_hazard_release(void) {
+    ttak_hazard_record_t *rec = t_hazard;
+    if (TTAK_UNLIKELY(!rec || rec->depth == 0)) return;
+    atomic_store_explicit(&rec->slots[--rec->depth], NULL, memory_order_release);
+}
+
+static int hazard_ptr_cmp(const void *a, const void *b) {
+    uintptr_t x = (uintptr_t)*(void *const *)a;
+    uintptr_t y = (uintptr_t)*(void *const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Moves orphaned retirements into @p rec so this scan covers them.
+ */
+static void hazard_adopt_orphans(ttak_hazard_record_t *rec) {
+    if (atomic_load_explicit(&g_orphan_pending, memory_order_relaxed) == 0) return;
+    if (pthread_mutex_trylock(&g_orphan_lock) != 0) return;
+    if (g_orphan_count && hazard_reserve(rec, g_orphan_count)) {
+        memcpy(rec->retired + rec->retired_count, g_orphans, g_orphan_count * sizeof(*g_orphans));
+        rec->retired_count += g_orphan_count;
+        g_orphan_count = 0;
+        atomic_store_explicit(&g_orphan_pending, 0, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&g_orphan_lock);
+}
+
+void ttak_hazard_scan(void) {
+    ttak_hazard_record_t *rec = t_hazard;
+    if (!rec) return;
+    hazard_adopt_orphans(rec);
+    if (rec->retired_count == 0) return;
+
+    /* Pairs with the seq_cst slot stores in ttak_hazard_protect(). */
+    atomic_thread_fence(memory_order_seq_cst);
+
+    size_t cap = atomic_load_explicit(&g_hazard_record_count, memory_order_acquire) * TTAK_HAZARD_SLOTS;
+    void **seen = cap ? (void **)malloc(cap * sizeof(void *)) : NULL;
+    if (cap && !seen) return;
+
+    size_t n = 0;
+    for (ttak_hazard_record_t *r = atomic_load_explicit(&g_hazard_records, memory_order_acquire); r && n < cap; r = r->next) {
+        for (int i = 0; i < TTAK_HAZARD_SLOTS && n < cap; i++) {
+            void *p = atomic_load_explicit(&r->slots[i], memory_order_acquire);
+            if (p) seen[n++] = p;
+        }
+    }
+    if (n > 1) qsort(seen, n, sizeof(void *), hazard_ptr_cmp);
+
+    /* Cleanups may retire again, so detach the list before running them. */
+    ttak_hazard_retired_t *list = rec->retired;
+    size_t count = rec->retired_count;
+    size_t list_cap = rec->retired_cap;
+    rec->retired = NULL;
+    rec->retired_count = 0;
+    rec->retired_cap = 0;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        void *p = list[i].ptr;
+        if (n && bsearch(&p, seen, n, sizeof(void *), hazard_ptr_cmp)) {
+            list[kept++] = list[i];
+        } else if (list[i].cleanup) {
+            list[i].cleanup(p);
+        }
+    }
+    free(seen);
+
+    /* Append whatever the cleanups retired behind the survivors. */
+    ttak_hazard_retired_t *fresh = rec->retired;
+    size_t fresh_count = rec->retired_count;
+    rec->retired = list;
+    rec->retired_count = kept;
+    rec->retired_cap = list_cap;
+    if (fresh_count && hazard_reserve(rec, fresh_count)) {
+        memcpy(rec->retired + rec->retired_count, fresh, fresh_count * sizeof(*fresh));
+        rec->retired_count += fresh_count;
+        fresh_count = 0;
+    }
+    if (fresh_count) {
+        /* Keep the cleanups' retirements rather than leak their array. */
+        free(rec->retired);
+        rec->retired = fresh;
+        rec->retired_count = fresh_count;
+        rec->retired_cap = fresh_count;
+    } else {
+        free(fresh);
+    }
+}
+
+void ttak_hazard_retire(void *ptr, void (*cleanup)(void *)) {
+    if (!ptr) return;
+    ttak_hazard_record_t *rec = hazard_current();
+    if (TTAK_UNLIKELY(!rec || !hazard_reserve(rec, 1))) {
+        /* Nowhere to defer to: leaking is the only safe choice. */
+        return;
+    }
+    rec->retired[rec->retired_count].ptr = ptr;
+    rec->retired[rec->retired_count].cleanup = cleanup;
+    rec->retired_count++;
+
+    size_t threshold = 2 * atomic_load_explicit(&g_hazard_record_count, memory_order_relaxed) * TTAK_HAZARD_SLOTS;
+    if (threshold < TTAK_HAZARD_SCAN_MIN) threshold = TTAK_HAZARD_SCAN_MIN;
+    if (rec->retired_count >= threshold) {
+        ttak_hazard_scan();
+    }
+}
+
+size_t ttak_hazard_pending(void) {
+    return t_hazard ? t_hazard->retired_count : 0;
+}
@@ -20,6 +20,9 @@
 #include <pthread.h>
 #include <limits.h>
 #include <errno.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 #ifdef _WIN32
     #define _CRT_NONSTDC_NO_DEPRECATE 1
@@ -74,7 +77,6 @@ static int posix_memalign(void **memptr, size_t alignment, size_t size) {
 #define TTAK_CANARY_END_MAGIC   0xBEEFDEADBEEFDEADULL
 
 static volatile uint64_t global_mem_usage = 0;           /**< Atomic counter for total libttak usage */
-static pthread_mutex_t global_map_lock = PTHREAD_MUTEX_INITIALIZER; /**< Global lock for pointer map */
 static ttak_mem_tree_t global_mem_tree;                 /**< Global root-tracking mem_tree */
 static int global_trace_enabled = 0;                    /**< Flag for JSON tracing */
 
@@ -130,9 +132,62 @@ uint64_t ttak_atomic_fetch_add_u64_fallback(uint64_t *ptr, uint64_t val) {
 #define GET_HEADER(ptr) ((ttak_mem_header_t *)(ptr) - 1)
 #define GET_USER_PTR(header) ((void *)((ttak_mem_header_t *)(header) + 1))
 
-static volatile tt_map_t *global_ptr_map = NULL;
+/**
+ * @brief Number of independent pointer-registry shards (power of two).
+ *
+ * Root allocations are spread across shards by address so concurrent
+ * alloc/free pairs on different threads rarely touch the same lock.
+ */
+#ifndef TTAK_MEM_REGISTRY_SHARDS
+#define TTAK_MEM_REGISTRY_SHARDS 64
+#endif
+#define TTAK_MEM_REGISTRY_SHARD_MASK (TTAK_MEM_REGISTRY_SHARDS - 1)
+#if (TTAK_MEM_REGISTRY_SHARDS & TTAK_MEM_REGISTRY_SHARD_MASK) != 0
+#error "TTAK_MEM_REGISTRY_SHARDS must be a power of two"
+#endif
+
+/**
+ * @brief One slice of the global pointer registry.
+ *
+ * Cache-line aligned so neighbouring shard locks never false-share.
+ */
+typedef struct {
+    alignas(64) pthread_mutex_t lock;   /**< Guards @c map and tree ops for pointers in this shard */
+    tt_map_t *map;                      /**< user_ptr -> header for this shard */
+} ttak_mem_registry_shard_t;
+
+static ttak_mem_registry_shard_t global_ptr_shards[TTAK_MEM_REGISTRY_SHARDS];
 static pthread_mutex_t global_init_lock = PTHREAD_MUTEX_INITIALIZER;
 
+/**
+ * @brief Maps a user pointer to its registry shard.
+ *
+ * Drops the 64-byte alignment bits, then applies Fibonacci hashing so
+ * allocations carved from the same region still spread evenly.
+ */
+static inline ttak_mem_registry_shard_t *ttak_mem_registry_shard(const void *ptr) {
+    uint64_t mixed = ((uint64_t)(uintptr_t)ptr >> 6) * UINT64_C(0x9e3779b97f4a7c15);
+    return &global_ptr_shards[(mixed >> 32) & TTAK_MEM_REGISTRY_SHARD_MASK];
+}
+
+/**
+ * @brief Locks every shard in index order to obtain a consistent snapshot.
+ */
+static void ttak_mem_registry_lock_all(void) {
+    for (size_t i = 0; i < TTAK_MEM_REGISTRY_SHARDS; ++i) {
+        pthread_mutex_lock(&global_ptr_shards[i].lock);
+    }
+}
+
+/**
+ * @brief Releases all shard locks taken by ttak_mem_registry_lock_all().
+ */
+static void ttak_mem_registry_unlock_all(void) {
+    for (size_t i = TTAK_MEM_REGISTRY_SHARDS; i-- > 0;) {
+        pthread_mutex_unlock(&global_ptr_shards[i].lock);
+    }
+}
+
 #if EMBEDDED
 #include <ttak/phys/mem/buddy.h>
 #ifndef TTAK_EMBEDDED_POOL_ORDER
@@ -146,10 +201,12 @@ static pthread_mutex_t global_init_lock = PTHREAD_MUTEX_INITIALIZER;
 #if TTAK_EMBEDDED_POOL_ORDER >= 63
 #error "TTAK_EMBEDDED_POOL_ORDER must be less than 63"
 #endif
+#if !TTAK_LAZY_STATIC_REGIONS
 static _Alignas(64) uint8_t buddy_pool[TTAK_EMBEDDED_POOL_SIZE];
+#endif
 static pthread_once_t buddy_once = PTHREAD_ONCE_INIT;
-static void *embedded_pool_start = buddy_pool;
-static size_t embedded_pool_len = sizeof(buddy_pool);
+static void *embedded_pool_start = NULL;
+static size_t embedded_pool_len = 0;
 
 #ifndef TTAK_BUDDY_DEFAULT_EMBEDDED_MODE
 #define TTAK_BUDDY_DEFAULT_EMBEDDED_MODE 0 /* override to 1 for strict embedded builds */
@@ -176,9 +233,16 @@ static int ttak_detect_embedded_pool_mode(void) {
  * @brief Lazy-init for the buddy system in embedded builds.
  */
 static void buddy_bootstrap(void) {
-    ttak_mem_buddy_init(buddy_pool, sizeof(buddy_pool), ttak_detect_embedded_pool_mode());
-    embedded_pool_start = buddy_pool;
-    embedded_pool_len = sizeof(buddy_pool);
+#if TTAK_LAZY_STATIC_REGIONS
+    /* A failed reservation leaves the buddy without a pool; allocations fall through. */
+    void *pool = ttak_static_region_reserve(TTAK_EMBEDDED_POOL_SIZE);
+#else
+    void *pool = buddy_pool;
+#endif
+    size_t len = pool ? TTAK_EMBEDDED_POOL_SIZE : 0;
+    ttak_mem_buddy_init(pool, len, ttak_detect_embedded_pool_mode());
+    embedded_pool_start = pool;
+    embedded_pool_len = len;
 }
 
 static bool ttak_embedded_ptr_in_pool(const void *ptr) {
@@ -217,59 +281,93 @@ static void ttak_embedded_os_free(void *ptr, size_t size) {
 
 #if defined(__TINYC__)
 static pthread_once_t ttak_tls_once = PTHREAD_ONCE_INIT;
-static pthread_key_t ttak_tls_guard_key;
-static pthread_key_t ttak_tls_memop_key;
-static pthread_key_t ttak_tls_meminit_key;
-static pthread_key_t ttak_tls_retrying_key;
-
-static void ttak_tls_init_keys(void) {
-    pthread_key_create(&ttak_tls_guard_key, free);
-    pthread_key_create(&ttak_tls_memop_key, free);
-    pthread_key_create(&ttak_tls_meminit_key, free);
-    pthread_key_create(&ttak_tls_retrying_key, free);
-}
-
-static void *ttak_tls_get_slot(pthread_key_t key, size_t slot_size, void *fallback) {
-    pthread_once(&ttak_tls_once, ttak_tls_init_keys);
-    void *slot = pthread_getspecific(key);
-    if (!slot) {
-        slot = calloc(1, slot_size);
-        if (slot && pthread_setspecific(key, slot) != 0) {
-            free(slot);
-            slot = NULL;
+static pthread_key_t ttak_tls_key;
+
+static void ttak_tls_init_key(void) {
+    pthread_key_create(&ttak_tls_key, free);
+}
+
+ttak_mem_tls_t *ttak_mem_tls(void) {
+    static ttak_mem_tls_t fallback;
+    pthread_once(&ttak_tls_once, ttak_tls_init_key);
+    ttak_mem_tls_t *tls = pthread_getspecific(ttak_tls_key);
+    if (!tls) {
+        tls = calloc(1, sizeof(*tls));
+        if (tls && pthread_setspecific(ttak_tls_key, tls) != 0) {
+            free(tls);
+            tls = NULL;
         }
     }
-    return slot ? slot : fallback;
+    return tls ? tls : &fallback;
 }
+#else
+TTAK_THREAD_LOCAL ttak_mem_tls_t ttak_mem_tls_state TTAK_TLS_INITIAL_EXEC; /**< Allocator flags of this thread */
+#endif
+static volatile int global_init_done = 0;         /**< Subsystem initialization ready flag */
 
-bool *ttak_tls_get_reentrancy_guard(void) {
-    static bool global_fallback = false;
-    return (bool *)ttak_tls_get_slot(ttak_tls_guard_key, sizeof(bool), &global_fallback);
-}
+#if !EMBEDDED && TTAK_OS_MANAGED_MEMORY
+/*
+ * Large bootstrap allocations are mapped directly: the kernel's zero pages
+ * stand in for the clearing pass and stay unfaulted until first use. Such
+ * mappings are few, so a small table tells them apart from heap blocks
+ * when they are freed; once it is full, allocations use the heap again.
+ */
+#ifndef TTAK_DANGEROUS_MAP_MIN
+#define TTAK_DANGEROUS_MAP_MIN ((size_t)256 * 1024)
+#endif
+#define TTAK_DANGEROUS_MAP_SLOTS 64
 
-static int *ttak_tls_get_in_mem_op(void) {
-    static int fallback = 0;
-    return (int *)ttak_tls_get_slot(ttak_tls_memop_key, sizeof(int), &fallback);
-}
+static struct {
+    void *ptr;
+    size_t len;
+} dangerous_maps[TTAK_DANGEROUS_MAP_SLOTS];
+static pthread_mutex_t dangerous_maps_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic size_t dangerous_maps_live = 0;
 
-static int *ttak_tls_get_in_mem_init(void) {
-    static int fallback = 0;
-    return (int *)ttak_tls_get_slot(ttak_tls_meminit_key, sizeof(int), &fallback);
+static void *ttak_dangerous_map(size_t size) {
+    void *ptr = ttak_os_mem_alloc(size);
+    if (!ptr) return NULL;
+    pthread_mutex_lock(&dangerous_maps_lock);
+    for (size_t i = 0; i < TTAK_DANGEROUS_MAP_SLOTS; ++i) {
+        if (!dangerous_maps[i].ptr) {
+            dangerous_maps[i].ptr = ptr;
+            dangerous_maps[i].len = size;
+            atomic_fetch_add_explicit(&dangerous_maps_live, 1, memory_order_relaxed);
+            pthread_mutex_unlock(&dangerous_maps_lock);
+            return ptr;
+        }
+    }
+    pthread_mutex_unlock(&dangerous_maps_lock);
+    ttak_os_mem_free(ptr, size);
+    return NULL;
 }
 
-static int *ttak_tls_get_retrying_counter(void) {
-    static int fallback = 0;
-    return (int *)ttak_tls_get_slot(ttak_tls_retrying_key, sizeof(int), &fallback);
+/**
+ * @brief Unmaps @p ptr if ttak_dangerous_map() produced it.
+ * @return false for heap blocks.
+ */
+static bool ttak_dangerous_unmap(void *ptr) {
+    /* Mappings are page aligned; most heap blocks are not and skip the lock. */
+    if (((uintptr_t)ptr & (TTAK_POCKET_PAGE_SIZE - 1)) != 0 ||
+        atomic_load_explicit(&dangerous_maps_live, memory_order_relaxed) == 0) {
+        return false;
+    }
+    size_t len = 0;
+    pthread_mutex_lock(&dangerous_maps_lock);
+    for (size_t i = 0; i < TTAK_DANGEROUS_MAP_SLOTS; ++i) {
+        if (dangerous_maps[i].ptr == ptr) {
+            len = dangerous_maps[i].len;
+            dangerous_maps[i].ptr = NULL;
+            atomic_fetch_sub_explicit(&dangerous_maps_live, 1, memory_order_relaxed);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&dangerous_maps_lock);
+    if (!len) return false;
+    ttak_os_mem_free(ptr, len);
+    return true;
 }
-
-#define in_mem_op        (*ttak_tls_get_in_mem_op())
-#define in_mem_init      (*ttak_tls_get_in_mem_init())
-#else
-TTAK_THREAD_LOCAL bool t_reentrancy_guard = false;  /**< Thread-local guard against recursive allocation */
-TTAK_THREAD_LOCAL int in_mem_op = 0;               /**< Guard for pointer-map operations */
-TTAK_THREAD_LOCAL int in_mem_init = 0;            /**< Guard for subsystem initialization */
 #endif
-static volatile int global_init_done = 0;         /**< Subsystem initialization ready flag */
 
 /**
  * @brief Primitive allocator for internal subsystem bootstrap.
@@ -284,18 +382,23 @@ void *ttak_dangerous_alloc(size_t size) {
     pthread_once(&buddy_once, buddy_bootstrap);
     ttak_mem_req_t req = { .size_bytes = size, .priority = 0, .owner_tag = 0, .call_safety = 0, .flags = 0 };
     ptr = ttak_mem_buddy_alloc(&req);
-    if (!ptr) {
+    if (ptr) {
+        ttak_mem_stream_zero(ptr, size);
+    } else {
         size_t mapped_size;
         void *os_ptr;
         if (size > SIZE_MAX - sizeof(size_t)) return NULL;
         mapped_size = size + sizeof(size_t);
+        /* Fresh OS pages already read zero. */
         os_ptr = ttak_embedded_os_alloc(mapped_size);
         if (!os_ptr) return NULL;
         *((size_t *)os_ptr) = mapped_size;
         ptr = (char *)os_ptr + sizeof(size_t);
     }
-    ttak_mem_stream_zero(ptr, size);
 #else
+#if TTAK_OS_MANAGED_MEMORY
+    if (size >= TTAK_DANGEROUS_MAP_MIN && (ptr = ttak_dangerous_map(size)) != NULL) return ptr;
+#endif
     if (posix_memalign(&ptr, 64, size) != 0) return NULL;
     ttak_mem_stream_zero(ptr, size);
 #endif
@@ -325,6 +428,9 @@ void ttak_dangerous_free(void *ptr) {
         ttak_embedded_os_free(os_ptr, mapped_size);
     }
 #else
+#if TTAK_OS_MANAGED_MEMORY
+    if (ttak_dangerous_unmap(ptr)) return;
+#endif
     posix_memfree(ptr);
 #endif
 }
@@ -346,21 +452,58 @@ static ttak_fixed_16_16_t ttak_mem_calculate_global_friction(void) {
  * @brief Ensures the global pointer map and mem_tree are initialized.
  */
 static void ensure_global_map(uint64_t now) {
-    if (global_init_done || in_mem_init) return;
+    if (global_init_done) return;
+    ttak_mem_tls_t *tls = ttak_mem_tls();
+    if (tls->in_mem_init) return;
     pthread_mutex_lock(&global_init_lock);
-    if (!global_ptr_map && !global_init_done) {
-        in_mem_init = true;
-        global_ptr_map = ttak_create_map(8192, now);
+    if (!global_init_done) {
+        tls->in_mem_init = true;
+        for (size_t i = 0; i < TTAK_MEM_REGISTRY_SHARDS; ++i) {
+            pthread_mutex_init(&global_ptr_shards[i].lock, NULL);
+            global_ptr_shards[i].map = ttak_create_map(8192 / TTAK_MEM_REGISTRY_SHARDS, now);
+        }
         ttak_mem_tree_init(&global_mem_tree);
         global_init_done = true;
-        in_mem_init = false;
+        tls->in_mem_init = false;
     }
     pthread_mutex_unlock(&global_init_lock);
 }
 
+/**
+ * @brief Adds a root block to its registry shard and the mem_tree.
+ */
+static void ttak_mem_root_register(ttak_mem_tls_t *tls, void *user_ptr, ttak_mem_header_t *header, uint64_t now) {
+    ensure_global_map(now);
+    ttak_mem_registry_shard_t *shard = ttak_mem_registry_shard(user_ptr);
+    if (global_init_done && !tls->in_mem_init && !tls->in_mem_op && shard->map) {
+        pthread_mutex_lock(&shard->lock); tls->in_mem_op = true;
+        ttak_insert_to_map(shard->map, (uintptr_t)user_ptr, (size_t)header, now);
+        ttak_mem_tree_add(&global_mem_tree, user_ptr, header->size, header->expires_tick, header->is_root);
+        tls->in_mem_op = false; pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+/**
+ * @brief Takes a root block out of its registry shard and the mem_tree.
+ */
+static void ttak_mem_root_unregister(ttak_mem_tls_t *tls, void *user_ptr) {
+    ttak_mem_registry_shard_t *shard = ttak_mem_registry_shard(user_ptr);
+    pthread_mutex_lock(&shard->lock); tls->in_mem_op = 1;
+    if (shard->map) ttak_delete_from_map(shard->map, (uintptr_t)user_ptr, 0);
+    ttak_mem_node_t *node = ttak_mem_tree_find_node(&global_mem_tree, user_ptr);
+    if (node) ttak_mem_tree_remove(&global_mem_tree, node);
+    tls->in_mem_op = 0; pthread_mutex_unlock(&shard->lock);
+}
+
 // See public interfaces in include/ttak/mem/mem.h for full documentation
 
-void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, uint64_t now, _Bool is_const, _Bool is_volatile, _Bool allow_direct, _Bool is_root, ttak_mem_flags_t flags) {
+/**
+ * @brief Allocates and initialises a fortress block without registering roots.
+ *
+ * Shared by ttak_mem_alloc_safe() and ttak_mem_alloc_bulk(); the latter
+ * batches the registry and mem_tree work for a whole group of roots.
+ */
+static void *ttak_mem_alloc_block(ttak_mem_tls_t *tls, size_t size, uint64_t lifetime_ticks, uint64_t now, _Bool is_const, _Bool is_volatile, _Bool allow_direct, _Bool is_root, ttak_mem_flags_t flags) {
     size_t header_size = sizeof(ttak_mem_header_t);
     bool strict_check_enabled = (flags & TTAK_MEM_STRICT_CHECK);
     ttak_mem_header_t *header = NULL;
@@ -380,14 +523,14 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
         return NULL;
     }
 
-    if (t_reentrancy_guard) {
+    if (tls->reentrancy_guard) {
         /* Returning a raw malloc pointer here would create a use-after-free risk
          * because callers may later pass it to ttak_mem_free(), which reads the
          * TTAK header that precedes managed allocations.  Return NULL so the
          * caller can handle the failure safely. */
         return NULL;
     }
-    t_reentrancy_guard = true;
+    tls->reentrancy_guard = true;
 
     // --- Tier 1: Pockets (small objects) ---
     if (size > 0 && size <= 512 && lifetime_ticks < TT_SECOND(1)) {
@@ -401,7 +544,7 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
         if (strict_check_enabled) {
             vma_size += sizeof(uint64_t);
         }
-        header = ttak_mem_vma_alloc_internal(vma_size);
+        header = ttak_mem_vma_alloc_internal(vma_size, flags);
         if (header) {
             allocated_tier = TTAK_ALLOC_TIER_VMA;
         }
@@ -422,7 +565,7 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
         size_t tier3_size = size;
         if (strict_check_enabled) {
             if (tier3_size > SIZE_MAX - sizeof(uint64_t)) {
-                t_reentrancy_guard = false;
+                tls->reentrancy_guard = false;
                 return NULL;
             }
             tier3_size += sizeof(uint64_t);
@@ -430,7 +573,7 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
 #if EMBEDDED
         if ((flags & TTAK_MEM_LOW_PRIORITY) &&
             atomic_load(&global_friction_matrix.global_friction) > atomic_load(&global_friction_matrix.pressure_threshold)) {
-            t_reentrancy_guard = false;
+            tls->reentrancy_guard = false;
             return NULL;
         }
         pthread_once(&buddy_once, buddy_bootstrap);
@@ -448,17 +591,20 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
             }
         }
 #else
-        header = ttak_mem_large_alloc_internal(tier3_size);
+        header = ttak_mem_large_alloc_internal(tier3_size, flags);
         if (header) allocated_tier = TTAK_ALLOC_TIER_GENERAL;
 #endif
     }
 
-    if (!header) { t_reentrancy_guard = false; return NULL; }
+    if (!header) { tls->reentrancy_guard = false; return NULL; }
 
     header->magic = TTAK_MAGIC_NUMBER;
     header->created_tick = now;
     header->expires_tick = (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__) ? (uint64_t)-1 : now + lifetime_ticks;
     header->access_count = 0;
+    header->access_mode = (flags & TTAK_MEM_ACCESS_UNCOUNTED) ? TTAK_MEM_ACCESS_COUNT_OFF
+                        : (flags & TTAK_MEM_ACCESS_SAMPLED) ? TTAK_MEM_ACCESS_COUNT_SAMPLED
+                        : TTAK_MEM_ACCESS_COUNT_INHERIT;
     header->pin_count = 0;
     header->size = size;
     header->freed = false;
@@ -482,11 +628,16 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
         actual_total_alloc_size = (raw + TTAK_VMA_ALIGNMENT - 1) & ~((size_t)TTAK_VMA_ALIGNMENT - 1);
     } else actual_total_alloc_size = header_size + size + (strict_check_enabled ? sizeof(uint64_t) : 0);
     header->mapped_size = actual_total_alloc_size;
+    header->profile_site = 0;
+    if (atomic_load_explicit(&global_profile_interval, memory_order_relaxed)) {
+        ttak_mem_profile_record_alloc(header, lifetime_ticks);
+    }
     header->checksum = ttak_calc_header_checksum(header);
 
     ttak_atomic_add64(&global_mem_usage, actual_total_alloc_size);
+    ttak_mem_stats_note_alloc(allocated_tier, actual_total_alloc_size);
     user_ptr = (char *)header + header_size;
-    ttak_mem_stream_zero(user_ptr, size);
+    if (!ttak_mem_tier_returns_zeroed(allocated_tier)) ttak_mem_stream_zero(user_ptr, size);
     if (strict_check_enabled) *((uint64_t *)((char *)user_ptr + size)) = TTAK_CANARY_END_MAGIC;
 
     if (global_trace_enabled) {
@@ -497,23 +648,47 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
         }
     } else header->tracking_log = NULL;
 
-    if (is_root) {
-        ensure_global_map(now);
-        tt_map_t *map_handle = (tt_map_t *)global_ptr_map;
-        if (global_init_done && !in_mem_init && !in_mem_op && map_handle) {
-            /* Clear the reentrancy guard before map/tree operations so that
-             * internal map resize allocations (non-root) can succeed normally
-             * instead of hitting the NULL fallback path. */
-            t_reentrancy_guard = false;
-            pthread_mutex_lock(&global_map_lock); in_mem_op = true;
-            ttak_insert_to_map(map_handle, (uintptr_t)user_ptr, (size_t)header, now);
-            ttak_mem_tree_add(&global_mem_tree, user_ptr, size, header->expires_tick, is_root);
-            in_mem_op = false; pthread_mutex_unlock(&global_map_lock);
+    tls->reentrancy_guard = false;
+    return user_ptr;
+}
+
+void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, uint64_t now, _Bool is_const, _Bool is_volatile, _Bool allow_direct, _Bool is_root, ttak_mem_flags_t flags) {
+    ttak_mem_tls_t *tls = ttak_mem_tls();
+    void *user_ptr = ttak_mem_alloc_block(tls, size, lifetime_ticks, now, is_const, is_volatile, allow_direct, is_root, flags);
+    if (user_ptr && is_root) {
+        /* The reentrancy guard is already clear, so the shard maps and
+         * their resize allocations (non-root) succeed normally instead of
+         * hitting the NULL fallback path. */
+        ttak_mem_root_register(tls, user_ptr, GET_HEADER(user_ptr), now);
+    }
+    return user_ptr;
+}
+
+size_t ttak_mem_alloc_bulk(void **out, size_t count, size_t size, uint64_t lifetime_ticks, uint64_t now, _Bool is_root, ttak_mem_flags_t flags) {
+    if (!out || count == 0) return 0;
+    ttak_mem_tls_t *tls = ttak_mem_tls();
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = ttak_mem_alloc_block(tls, size, lifetime_ticks, now, false, false, true, is_root, flags);
+        if (!out[i]) {
+            while (i > 0) ttak_mem_free(out[--i]);
+            return 0;
         }
     }
+    if (!is_root) return count;
 
-    t_reentrancy_guard = false;
-    return user_ptr;
+    /* One registry transaction and one mem_tree splice for the whole batch. */
+    ensure_global_map(now);
+    if (global_init_done && !tls->in_mem_init && !tls->in_mem_op) {
+        uint64_t expires = GET_HEADER(out[0])->expires_tick;
+        ttak_mem_registry_lock_all(); tls->in_mem_op = true;
+        for (size_t i = 0; i < count; ++i) {
+            ttak_mem_registry_shard_t *shard = ttak_mem_registry_shard(out[i]);
+            if (shard->map) ttak_insert_to_map(shard->map, (uintptr_t)out[i], (size_t)GET_HEADER(out[i]), now);
+        }
+        ttak_mem_tree_add_bulk(&global_mem_tree, out, count, size, expires, true);
+        tls->in_mem_op = false; ttak_mem_registry_unlock_all();
+    }
+    return count;
 }
 
 void * ttak_fastalloc(ttak_epoch_gc_t *gc, size_t size, uint64_t lifetime_ticks, uint64_t now) {
@@ -523,24 +698,106 @@ void * ttak_fastalloc(ttak_epoch_gc_t *gc, size_t size, uint64_t lifetime_ticks,
 }
 
 void * ttak_fastcalloc(ttak_epoch_gc_t *gc, size_t size, uint64_t lifetime_ticks, uint64_t now) {
-    void *ptr = ttak_fastalloc(gc, size, lifetime_ticks, now);
-    if (ptr) memset(ptr, 0, size);
-    return ptr;
+    /* ttak_mem_alloc_safe() already returns zeroed memory, without touching fresh pages. */
+    return ttak_fastalloc(gc, size, lifetime_ticks, now);
 }
 
 
+/**
+ * @brief Grows a block without copying it; NULL if its tier cannot.
+ *
+ * Slack in the block (a pocket size class, alignment padding) is used as
+ * is. VMA and large blocks absorb a free neighbour or are remapped, which
+ * may move them; buddy blocks absorb free upper buddies. The grown block
+ * keeps its attributes and takes the new lifetime, as a copy would.
+ */
+static void *ttak_mem_grow_in_place(void *ptr, size_t new_size, uint64_t lifetime_ticks, uint64_t now, ttak_mem_flags_t flags) {
+    ttak_mem_header_t *header = GET_HEADER(ptr);
+    size_t header_size = sizeof(ttak_mem_header_t);
+    size_t extra = header->strict_check ? sizeof(uint64_t) : 0;
+    size_t old_size = header->size, old_mapped = header->mapped_size;
+    ttak_allocation_tier_t tier = header->allocation_tier;
+    /* Sampled blocks are charged to the profiler at their original size. */
+    if (header->profile_site || header->pin_count || new_size <= old_size) return NULL;
+    if (new_size > SIZE_MAX - header_size - extra - TTAK_VMA_ALIGNMENT) return NULL;
+    size_t need = header_size + new_size + extra;
+    size_t mapped = old_mapped;
+    size_t fresh_from = new_size;   /* Bytes from here on are known to be zero. */
+
+    ttak_mem_tls_t *tls = ttak_mem_tls();
+    bool registered = header->is_root && global_init_done;
+    /* A remap may move the block; scans must not see the old address meanwhile. */
+    if (registered) ttak_mem_root_unregister(tls, ptr);
+
+    ttak_mem_header_t *grown = NULL;
+    if (need <= old_mapped) {
+        grown = header;
+    } else if (tier == TTAK_ALLOC_TIER_VMA || tier == TTAK_ALLOC_TIER_GENERAL) {
+        grown = ttak_mem_vma_grow_internal(header, need);
+        mapped = (need + TTAK_VMA_ALIGNMENT - 1) & ~((size_t)TTAK_VMA_ALIGNMENT - 1);
+#if TTAK_OS_MANAGED_MEMORY
+        /* Pages past the old mapping are new anonymous pages. */
+        size_t old_end = ((old_mapped + TTAK_POCKET_PAGE_SIZE - 1) & ~((size_t)TTAK_POCKET_PAGE_SIZE - 1)) - header_size;
+        if (old_end < fresh_from) fresh_from = old_end;
+#endif
+    }
+#if EMBEDDED
+    else if (tier == TTAK_ALLOC_TIER_BUDDY && ttak_embedded_ptr_in_pool(header) && ttak_mem_buddy_grow(header, need)) {
+        grown = header;
+        mapped = need;
+    }
+#endif
+
+    if (!grown) {
+        if (registered) ttak_mem_root_register(tls, ptr, header, now);
+        return NULL;
+    }
+    if (grown != header) pthread_mutex_init(&grown->lock, NULL);
+    void *user_ptr = GET_USER_PTR(grown);
+
+    pthread_mutex_lock(&grown->lock);
+    /* The old canary and any absorbed neighbour's bytes must read as zero, like a fresh block. */
+    if (fresh_from > old_size) ttak_mem_stream_zero((char *)user_ptr + old_size, fresh_from - old_size);
+    grown->size = new_size;
+    grown->mapped_size = mapped;
+    grown->expires_tick = (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__) ? (uint64_t)-1 : now + lifetime_ticks;
+    if (flags & TTAK_MEM_ACCESS_UNCOUNTED) grown->access_mode = TTAK_MEM_ACCESS_COUNT_OFF;
+    else if (flags & TTAK_MEM_ACCESS_SAMPLED) grown->access_mode = TTAK_MEM_ACCESS_COUNT_SAMPLED;
+    if (grown->strict_check) *((uint64_t *)((char *)user_ptr + new_size)) = TTAK_CANARY_END_MAGIC;
+    grown->checksum = ttak_calc_header_checksum(grown);
+    pthread_mutex_unlock(&grown->lock);
+
+    if (mapped != old_mapped) {
+        ttak_atomic_add64(&global_mem_usage, mapped - old_mapped);
+        ttak_mem_stats_note_resize(tier, old_mapped, mapped);
+    }
+    if (registered) ttak_mem_root_register(tls, user_ptr, grown, now);
+    return user_ptr;
+}
+
 void TTAK_HOT_PATH *ttak_mem_realloc_safe(void *ptr, size_t new_size, uint64_t lifetime_ticks, uint64_t now, _Bool is_root, ttak_mem_flags_t flags) {
     V_HEADER(ptr);
     if (!ptr) return ttak_mem_alloc_safe(new_size, lifetime_ticks, now, false, false, true, is_root, flags);
 
     ttak_mem_header_t *old_header = GET_HEADER(ptr);
+    if (old_header->is_root == is_root) {
+        void *grown = ttak_mem_grow_in_place(ptr, new_size, lifetime_ticks, now, flags);
+        if (grown) return grown;
+    }
+
     pthread_mutex_lock(&old_header->lock);
     bool is_const = old_header->is_const, is_volatile = old_header->is_volatile, allow_direct = old_header->allow_direct_access, old_strict = old_header->strict_check;
     size_t old_size = old_header->size;
+    uint8_t old_access = old_header->access_mode;
     pthread_mutex_unlock(&old_header->lock);
 
     ttak_mem_flags_t new_flags = flags;
     if (old_strict) new_flags |= TTAK_MEM_STRICT_CHECK; else new_flags &= ~TTAK_MEM_STRICT_CHECK;
+    /* The block keeps its accounting mode unless the caller picks a new one. */
+    if (!(new_flags & (TTAK_MEM_ACCESS_UNCOUNTED | TTAK_MEM_ACCESS_SAMPLED))) {
+        if (old_access == TTAK_MEM_ACCESS_COUNT_OFF) new_flags |= TTAK_MEM_ACCESS_UNCOUNTED;
+        else if (old_access == TTAK_MEM_ACCESS_COUNT_SAMPLED) new_flags |= TTAK_MEM_ACCESS_SAMPLED;
+    }
 
     void *new_ptr = ttak_mem_alloc_safe(new_size, lifetime_ticks, now, is_const, is_volatile, allow_direct, is_root, new_flags);
     if (!new_ptr) return NULL;
@@ -564,35 +821,35 @@ void TTAK_HOT_PATH *ttak_mem_dup_safe(const void *src, size_t size, uint64_t lif
     return new_ptr;
 }
 
-void TTAK_HOT_PATH ttak_mem_free(void *ptr) {
-    if (!ptr) return;
-    void *stable_ptr = ptr;
-    ttak_mem_header_t *header = GET_HEADER(stable_ptr);
+/**
+ * @brief Claims a block for release; returns NULL if it was already freed.
+ */
+static ttak_mem_header_t *ttak_mem_free_claim(void *ptr) {
+    ttak_mem_header_t *header = GET_HEADER(ptr);
 
     pthread_mutex_lock(&header->lock);
-    if (header->freed) { pthread_mutex_unlock(&header->lock); return; }
+    if (header->freed) { pthread_mutex_unlock(&header->lock); return NULL; }
     header->freed = true;
     pthread_mutex_unlock(&header->lock);
 
-    V_HEADER(stable_ptr);
+    V_HEADER(ptr);
+
+    if (header->profile_site) ttak_mem_profile_record_free(header);
 
     if (global_trace_enabled && header->tracking_log) {
-        snprintf(header->tracking_log, 1024, "{\"event\":\"free\",\"ptr\":\"%p\",\"ts\":%" PRIu64 ",\"tier\":%d}", stable_ptr, ttak_get_tick_count(), (int)header->allocation_tier);
+        snprintf(header->tracking_log, 1024, "{\"event\":\"free\",\"ptr\":\"%p\",\"ts\":%" PRIu64 ",\"tier\":%d}", ptr, ttak_get_tick_count(), (int)header->allocation_tier);
         fprintf(stderr, "[MEM_TRACK] %s\n", header->tracking_log);
         free(header->tracking_log); header->tracking_log = NULL;
     }
+    return header;
+}
 
-    size_t actual_total_alloc_size = header->mapped_size;
-
-    if (header->is_root && (header->allocation_tier == TTAK_ALLOC_TIER_GENERAL || header->allocation_tier == TTAK_ALLOC_TIER_BUDDY)) {
-        pthread_mutex_lock(&global_map_lock); in_mem_op = 1;
-        ttak_delete_from_map((tt_map_t*)global_ptr_map, (uintptr_t)stable_ptr, 0);
-        ttak_mem_node_t *node = ttak_mem_tree_find_node(&global_mem_tree, stable_ptr);
-        if (node) ttak_mem_tree_remove(&global_mem_tree, node);
-        in_mem_op = 0; pthread_mutex_unlock(&global_map_lock);
-    }
-
-    ttak_atomic_sub64(&global_mem_usage, actual_total_alloc_size);
+/**
+ * @brief Returns a claimed, unregistered block to its tier.
+ */
+static void ttak_mem_release_header(ttak_mem_header_t *header) {
+    ttak_atomic_sub64(&global_mem_usage, header->mapped_size);
+    ttak_mem_stats_note_free(header->allocation_tier, header->mapped_size);
 
     switch (header->allocation_tier) {
         case TTAK_ALLOC_TIER_POCKET: _pocket_free_internal(header); break;
@@ -623,6 +880,53 @@ void TTAK_HOT_PATH ttak_mem_free(void *ptr) {
     }
 }
 
+void TTAK_HOT_PATH ttak_mem_free(void *ptr) {
+    if (!ptr) return;
+    ttak_mem_header_t *header = ttak_mem_free_claim(ptr);
+    if (!header) return;
+
+    /* Every root is registered on allocation regardless of tier, so every
+     * root must leave the registry here or the dirty-pointer scan would
+     * observe recycled pocket/VMA headers. */
+    if (header->is_root && global_init_done) ttak_mem_root_unregister(ttak_mem_tls(), ptr);
+
+    ttak_mem_release_header(header);
+}
+
+void ttak_mem_free_bulk(void **ptrs, size_t count) {
+    if (!ptrs || count == 0) return;
+    size_t roots = 0;
+    for (size_t i = 0; i < count; ++i) {
+        ttak_mem_header_t *header = ptrs[i] ? ttak_mem_free_claim(ptrs[i]) : NULL;
+        if (!header) { ptrs[i] = NULL; continue; }
+        if (header->is_root) roots++;
+    }
+
+    if (roots > 0 && global_init_done) {
+        void **root_ptrs = (void **)malloc(roots * sizeof(void *));
+        size_t n = 0;
+        ttak_mem_tls_t *tls = ttak_mem_tls();
+        ttak_mem_registry_lock_all(); tls->in_mem_op = 1;
+        for (size_t i = 0; i < count; ++i) {
+            if (!ptrs[i] || !GET_HEADER(ptrs[i])->is_root) continue;
+            ttak_mem_registry_shard_t *shard = ttak_mem_registry_shard(ptrs[i]);
+            if (shard->map) ttak_delete_from_map(shard->map, (uintptr_t)ptrs[i], 0);
+            if (root_ptrs) root_ptrs[n++] = ptrs[i];
+            else {
+                ttak_mem_node_t *node = ttak_mem_tree_find_node(&global_mem_tree, ptrs[i]);
+                if (node) ttak_mem_tree_remove(&global_mem_tree, node);
+            }
+        }
+        if (root_ptrs) ttak_mem_tree_remove_bulk(&global_mem_tree, root_ptrs, n);
+        tls->in_mem_op = 0; ttak_mem_registry_unlock_all();
+        free(root_ptrs);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (ptrs[i]) ttak_mem_release_header(GET_HEADER(ptrs[i]));
+    }
+}
+
 void ttak_mem_freep(void **ptr) {
     if (ptr && *ptr) {
         ttak_mem_free(*ptr);
@@ -630,6 +934,111 @@ void ttak_mem_freep(void **ptr) {
     }
 }
 
+/**
+ * @brief Header-lite state word layout.
+ */
+#define TTAK_LITE_STATE_LIVE      0x1u   /**< Cleared exactly once by ttak_mem_free_lite */
+#define TTAK_LITE_STATE_TTL       0x2u   /**< Expiry prefix precedes the header */
+#define TTAK_LITE_STATE_CHECKSUM  0x4u   /**< checksum field is populated */
+#define TTAK_LITE_STATE_TIER_SHIFT 8
+#define TTAK_LITE_PREFIX_SIZE     16     /**< TTL prefix, keeps user data 16-byte aligned */
+
+static inline uint32_t ttak_lite_checksum(const ttak_mem_lite_header_t *h, uint32_t state) {
+    return h->magic ^ (h->size * 0x9E3779B1u) ^ (state & ~TTAK_LITE_STATE_LIVE);
+}
+
+static inline uint64_t *ttak_lite_expiry_slot(ttak_mem_lite_header_t *h) {
+    return (uint64_t *)((char *)h - TTAK_LITE_PREFIX_SIZE);
+}
+
+/**
+ * @brief Resolves and validates the lite header behind a user pointer.
+ */
+static ttak_mem_lite_header_t *ttak_lite_header_of(void *ptr, uint32_t *state_out) {
+    ttak_mem_lite_header_t *h = (ttak_mem_lite_header_t *)ptr - 1;
+    if (h->magic != TTAK_LITE_MAGIC_NUMBER) {
+        fprintf(stderr, "[FATAL] TTAK Memory Corruption detected at %p (Lite header corrupted)\n", ptr);
+        abort();
+    }
+    uint32_t state = atomic_load_explicit(&h->state, memory_order_acquire);
+    if ((state & TTAK_LITE_STATE_LIVE) && (state & TTAK_LITE_STATE_CHECKSUM) &&
+        h->checksum != ttak_lite_checksum(h, state)) {
+        fprintf(stderr, "[FATAL] TTAK Memory Corruption detected at %p (Lite checksum mismatch)\n", ptr);
+        abort();
+    }
+    *state_out = state;
+    return h;
+}
+
+void TTAK_HOT_PATH *ttak_mem_alloc_lite(size_t size, uint64_t lifetime_ticks, uint64_t now, ttak_mem_flags_t flags) {
+    if (size == 0 || size > UINT32_MAX) return NULL;
+    bool has_ttl = (lifetime_ticks != __TTAK_UNSAFE_MEM_FOREVER__);
+    size_t prefix = (has_ttl ? TTAK_LITE_PREFIX_SIZE : 0) + sizeof(ttak_mem_lite_header_t);
+    size_t total = prefix + size;
+
+    ttak_allocation_tier_t tier = TTAK_ALLOC_TIER_POCKET;
+    void *block = ttak_mem_pocket_alloc_block(total);
+    if (block) {
+        total = get_total_block_size_for_freelist(get_pocket_size_class_idx(total));
+    } else {
+        tier = TTAK_ALLOC_TIER_GENERAL;
+        block = ttak_dangerous_alloc(total);
+        if (!block) return NULL;
+    }
+
+    ttak_mem_lite_header_t *h = (ttak_mem_lite_header_t *)((char *)block + prefix) - 1;
+    uint32_t state = TTAK_LITE_STATE_LIVE | ((uint32_t)tier << TTAK_LITE_STATE_TIER_SHIFT);
+    if (has_ttl) {
+        state |= TTAK_LITE_STATE_TTL;
+        *ttak_lite_expiry_slot(h) = now + lifetime_ticks;
+    }
+    if (flags & TTAK_MEM_STRICT_CHECK) state |= TTAK_LITE_STATE_CHECKSUM;
+    h->magic = TTAK_LITE_MAGIC_NUMBER;
+    h->size = (uint32_t)size;
+    h->checksum = (state & TTAK_LITE_STATE_CHECKSUM) ? ttak_lite_checksum(h, state) : 0;
+    atomic_store_explicit(&h->state, state, memory_order_release);
+
+    ttak_atomic_add64(&global_mem_usage, total);
+    ttak_mem_stats_note_alloc(tier, total);
+    void *user_ptr = h + 1;
+    if (tier == TTAK_ALLOC_TIER_POCKET) ttak_mem_stream_zero(user_ptr, size);
+    return user_ptr;
+}
+
+void *ttak_mem_access_lite(void *ptr, uint64_t now_tick) {
+    if (!ptr) return NULL;
+    uint32_t state;
+    ttak_mem_lite_header_t *h = ttak_lite_header_of(ptr, &state);
+    if (!(state & TTAK_LITE_STATE_LIVE)) return NULL;
+    if ((state & TTAK_LITE_STATE_TTL) && now_tick > *ttak_lite_expiry_slot(h)) return NULL;
+    return ptr;
+}
+
+void TTAK_HOT_PATH ttak_mem_free_lite(void *ptr) {
+    if (!ptr) return;
+    uint32_t state;
+    ttak_mem_lite_header_t *h = ttak_lite_header_of(ptr, &state);
+    if (!(state & TTAK_LITE_STATE_LIVE)) return;
+    if (!atomic_compare_exchange_strong_explicit(&h->state, &state, state & ~TTAK_LITE_STATE_LIVE,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        return; /* Another thread won the race to free this block. */
+    }
+
+    size_t prefix = ((state & TTAK_LITE_STATE_TTL) ? TTAK_LITE_PREFIX_SIZE : 0) + sizeof(ttak_mem_lite_header_t);
+    size_t total = prefix + h->size;  /* read before the block is relinked */
+    void *block = (char *)ptr - prefix;
+    if (((state >> TTAK_LITE_STATE_TIER_SHIFT) & 0xFFu) == TTAK_ALLOC_TIER_POCKET) {
+        size_t block_size = get_total_block_size_for_freelist(get_pocket_size_class_idx(total));
+        ttak_atomic_sub64(&global_mem_usage, block_size);
+        ttak_mem_stats_note_free(TTAK_ALLOC_TIER_POCKET, block_size);
+        ttak_mem_pocket_free_block(block);
+    } else {
+        ttak_atomic_sub64(&global_mem_usage, total);
+        ttak_mem_stats_note_free(TTAK_ALLOC_TIER_GENERAL, total);
+        ttak_dangerous_free(block);
+    }
+}
+
 void ttak_mem_unuse(void *ptr, ttak_owner_t *owner) {
     if (!ptr) return;
     void *stable_ptr = ptr;
@@ -637,25 +1046,19 @@ void ttak_mem_unuse(void *ptr, ttak_owner_t *owner) {
     V_HEADER(stable_ptr);
 
     /* Remove the pointer from the owner's resource map when an owner is given. */
-    if (owner != TTAK_NO_OWNER && owner != NULL && owner->resources) {
-        ttak_rwlock_wrlock(&owner->lock);
-        ttak_map_t *res = (ttak_map_t *)owner->resources;
-        for (size_t i = 0; i < res->cap; ++i) {
-            if (res->ctrls[i] == OCCUPIED && (void *)res->values[i] == stable_ptr) {
-                ttak_delete_from_map(res, res->keys[i], ttak_get_tick_count());
-                break;
-            }
-        }
-        ttak_rwlock_unlock(&owner->lock);
+    if (owner != TTAK_NO_OWNER && owner != NULL) {
+        ttak_owner_forget_data(owner, stable_ptr);
     }
 
     /* Release one GC reference so the mem tree can collect the block when expired. */
-    if (header->is_root && (header->allocation_tier == TTAK_ALLOC_TIER_GENERAL ||
+    if (header->is_root && global_init_done && (header->allocation_tier == TTAK_ALLOC_TIER_GENERAL ||
                             header->allocation_tier == TTAK_ALLOC_TIER_BUDDY)) {
-        pthread_mutex_lock(&global_map_lock); in_mem_op = 1;
+        ttak_mem_tls_t *tls = ttak_mem_tls();
+        ttak_mem_registry_shard_t *shard = ttak_mem_registry_shard(stable_ptr);
+        pthread_mutex_lock(&shard->lock); tls->in_mem_op = 1;
         ttak_mem_node_t *node = ttak_mem_tree_find_node(&global_mem_tree, stable_ptr);
         if (node) ttak_mem_node_release(node);
-        in_mem_op = 0; pthread_mutex_unlock(&global_map_lock);
+        tls->in_mem_op = 0; pthread_mutex_unlock(&shard->lock);
     }
 }
 
@@ -680,18 +1083,40 @@ void *ttak_mem_access_bridge(void *ptr, uint64_t now_tick) {
     if (header->expires_tick != __TTAK_UNSAFE_MEM_FOREVER__ && now_tick > header->expires_tick) return NULL;
     if (!header->allow_direct_access) return NULL;
 
-    TTAK_ATOMIC_FETCH_ADD_U64(&header->access_count, 1ULL);
+    ttak_mem_access_note(header);
     return ptr;
 }
 
+volatile uint32_t ttak_mem_access_mode_global = TTAK_MEM_ACCESS_COUNT_ALL;
+static volatile uint32_t g_access_sample_mask = 63;
+static _Thread_local uint32_t t_access_clock;
+
+void ttak_mem_set_access_accounting(ttak_mem_access_accounting_t mode, uint32_t sample_period) {
+    if (sample_period) {
+        uint32_t period = 1;
+        while (period < sample_period && period < (1u << 31)) period <<= 1;
+        g_access_sample_mask = period - 1;
+    }
+    if (mode == TTAK_MEM_ACCESS_COUNT_INHERIT || mode > TTAK_MEM_ACCESS_COUNT_OFF) mode = TTAK_MEM_ACCESS_COUNT_ALL;
+    ttak_mem_access_mode_global = (uint32_t)mode;
+}
+
+void ttak_mem_access_sample(ttak_mem_header_t *header) {
+    uint32_t mask = g_access_sample_mask;
+    /* Weighted by the period so access_count keeps its expected value. */
+    if ((++t_access_clock & mask) == 0) TTAK_ATOMIC_FETCH_ADD_U64(&header->access_count, (uint64_t)mask + 1);
+}
+
 void ttak_mem_set_trace(int enable) {
     global_trace_enabled = enable;
     if (!global_init_done) return;
-    pthread_mutex_lock(&global_map_lock);
-    tt_map_t *map_handle = (tt_map_t *)global_ptr_map;
-    if (map_handle) {
-        for (size_t i = 0; i < map_handle->cap; i++) {
-            if (map_handle->ctrls[i] == OCCUPIED) {
+    for (size_t s = 0; s < TTAK_MEM_REGISTRY_SHARDS; ++s) {
+        ttak_mem_registry_shard_t *shard = &global_ptr_shards[s];
+        pthread_mutex_lock(&shard->lock);
+        tt_map_t *map_handle = shard->map;
+        if (!map_handle) { pthread_mutex_unlock(&shard->lock); continue; }
+        for (size_t i = 0; i < map_handle->cap + TTAK_HT_PAD; i++) {
+            if (TTAK_CTRL_FULL(map_handle->ctrls[i])) {
                 ttak_mem_header_t *h = (ttak_mem_header_t *)map_handle->values[i];
                 pthread_mutex_lock(&h->lock);
                 if (enable && !h->tracking_log) {
@@ -701,8 +1126,8 @@ void ttak_mem_set_trace(int enable) {
                 pthread_mutex_unlock(&h->lock);
             }
         }
+        pthread_mutex_unlock(&shard->lock);
     }
-    pthread_mutex_unlock(&global_map_lock);
 }
 
 int ttak_mem_is_trace_enabled(void) { return global_trace_enabled; }
@@ -725,26 +1150,43 @@ void TTAK_COLD_PATH tt_autoclean_dirty_pointers(uint64_t now) {
 }
 
 void TTAK_COLD_PATH **tt_inspect_dirty_pointers(uint64_t now, size_t *count_out) {
-    tt_map_t *map_handle = (tt_map_t *)global_ptr_map;
-    if (!count_out || !map_handle) return NULL;
-    pthread_mutex_lock(&global_map_lock);
-    void **dirty = malloc(sizeof(void *) * map_handle->size);
-    if (!dirty) { pthread_mutex_unlock(&global_map_lock); return NULL; }
+    if (!count_out || !global_init_done) return NULL;
+    /* Hold every shard so the snapshot matches a single point in time. */
+    ttak_mem_registry_lock_all();
+    size_t total = 0;
+    for (size_t s = 0; s < TTAK_MEM_REGISTRY_SHARDS; ++s) {
+        if (global_ptr_shards[s].map) total += global_ptr_shards[s].map->size;
+    }
+    void **dirty = malloc(sizeof(void *) * (total ? total : 1));
+    if (!dirty) { ttak_mem_registry_unlock_all(); return NULL; }
     size_t found = 0;
-    for (size_t i = 0; i < map_handle->cap; i++) {
-        if (map_handle->ctrls[i] == OCCUPIED) {
-            ttak_mem_header_t *h = (ttak_mem_header_t *)map_handle->values[i];
-            if ((h->expires_tick != (uint64_t)-1 && now > h->expires_tick) || ttak_atomic_read64(&h->access_count) > 1000000)
-                dirty[found++] = (void*)map_handle->keys[i];
+    for (size_t s = 0; s < TTAK_MEM_REGISTRY_SHARDS; ++s) {
+        tt_map_t *map_handle = global_ptr_shards[s].map;
+        if (!map_handle) continue;
+        for (size_t i = 0; i < map_handle->cap + TTAK_HT_PAD; i++) {
+            if (TTAK_CTRL_FULL(map_handle->ctrls[i])) {
+                ttak_mem_header_t *h = (ttak_mem_header_t *)map_handle->values[i];
+                if ((h->expires_tick != (uint64_t)-1 && now > h->expires_tick) || ttak_atomic_read64(&h->access_count) > 1000000)
+                    dirty[found++] = (void*)map_handle->keys[i];
+            }
         }
     }
-    pthread_mutex_unlock(&global_map_lock); *count_out = found; return dirty;
+    ttak_mem_registry_unlock_all(); *count_out = found; return dirty;
 }
 
 void **tt_autoclean_and_inspect(uint64_t now, size_t *count_out) {
     tt_autoclean_dirty_pointers(now); return tt_inspect_dirty_pointers(now, count_out);
 }
 
+uint64_t ttak_mem_get_usage(void) { return ttak_atomic_read64(&global_mem_usage); }
+
+size_t ttak_mem_trim(void) {
+    size_t released = ttak_mem_pocket_trim() + ttak_mem_vma_trim();
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+    return released;
+}
 _Bool ttak_mem_is_pressure_high(void) { return ttak_atomic_read64(&global_mem_usage) > TTAK_MEM_HIGH_WATERMARK; }
 
 void save_current_progress(const char *filename, const void *data, size_t size) {
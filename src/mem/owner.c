@@ -1,27 +1,224 @@
 #include <ttak/mem/owner.h>
 #include <ttak/ht/hash.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/epoch.h>
 #include <ttak/timing/timing.h>
 #include <stdatomic.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 static _Atomic uint32_t g_owner_id_counter = 1;
 
-/**
- * @brief Hashing helper for string keys.
+#define OWNER_SLOTS_MIN 16u
+
+/*
+ * Per-owner slot table, open-addressed by name handle. A slot's id is written
+ * once and never changes, so readers can probe without a lock: writers only
+ * flip `live` and `value`, and growth publishes a fresh table while the old
+ * one is retired through EBR.
+ */
+typedef struct {
+    _Atomic uint32_t id;
+    _Atomic uint32_t live;
+    _Atomic uintptr_t value;
+} ttak_owner_slot_t;
+
+struct ttak_owner_slots {
+    uint32_t mask;
+    uint32_t used;      /* Slots with an id, live or not. Writer-only. */
+    ttak_owner_slot_t slot[];
+};
+
+/*
+ * Process-wide name interning. Entries live forever; the table itself is
+ * copy-on-grow like the slot tables.
  */
-static inline uintptr_t _hash_str(const char *str) {
-    // Simple wrapper assuming string keys are cast to uintptr_t or hashed
-    // For this implementation, we use a basic DJB2-like hash or cast if the map supports it.
-    // Assuming ttak_map handles uintptr_t keys. We hash the string to uintptr_t.
-    uintptr_t hash = 5381;
-    int c;
-    while ((c = *str++))
-        hash = ((hash << 5) + hash) + c;
-    return hash;
+typedef struct {
+    uint64_t hash;
+    ttak_owner_name_t id;
+    char name[];
+} ttak_owner_name_entry_t;
+
+typedef struct {
+    uint32_t mask;
+    uint32_t used;
+    ttak_owner_name_entry_t *_Atomic slot[];
+} ttak_owner_name_table_t;
+
+static ttak_owner_name_table_t *_Atomic g_names;
+static pthread_mutex_t g_names_lock = PTHREAD_MUTEX_INITIALIZER;
+static ttak_owner_name_t g_names_next = 1;
+
+static inline uint64_t _hash_str(const char *str, size_t len) {
+    return ttak_hash_bytes(str, len, 0x6f776e6572ULL);
+}
+
+static inline uint32_t _slot_home(ttak_owner_name_t id, uint32_t mask) {
+    return (uint32_t)(id * 2654435761u) & mask;
+}
+
+static ttak_owner_name_t _name_probe(const ttak_owner_name_table_t *t, const char *name, uint64_t h) {
+    if (!t) return TTAK_OWNER_NAME_NONE;
+    for (uint32_t i = (uint32_t)h & t->mask, n = 0; n <= t->mask; i = (i + 1) & t->mask, ++n) {
+        ttak_owner_name_entry_t *e = atomic_load_explicit(&t->slot[i], memory_order_acquire);
+        if (!e) break;
+        if (e->hash == h && strcmp(e->name, name) == 0) return e->id;
+    }
+    return TTAK_OWNER_NAME_NONE;
+}
+
+static ttak_owner_name_table_t *_name_table_new(uint32_t cap, uint64_t now) {
+    size_t bytes = sizeof(ttak_owner_name_table_t) + (size_t)cap * sizeof(ttak_owner_name_entry_t *);
+    ttak_owner_name_table_t *t = ttak_mem_alloc_raw(bytes, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!t) return NULL;
+    memset(t, 0, bytes);
+    t->mask = cap - 1;
+    return t;
+}
+
+static void _name_table_put(ttak_owner_name_table_t *t, ttak_owner_name_entry_t *e) {
+    uint32_t i = (uint32_t)e->hash & t->mask;
+    while (atomic_load_explicit(&t->slot[i], memory_order_relaxed)) i = (i + 1) & t->mask;
+    atomic_store_explicit(&t->slot[i], e, memory_order_release);
+    t->used++;
+}
+
+ttak_owner_name_t ttak_owner_name_find(const char *name) {
+    if (!name) return TTAK_OWNER_NAME_NONE;
+    uint64_t h = _hash_str(name, strlen(name));
+    ttak_epoch_enter();
+    ttak_owner_name_t id = _name_probe(atomic_load_explicit(&g_names, memory_order_acquire), name, h);
+    ttak_epoch_exit();
+    return id;
+}
+
+ttak_owner_name_t ttak_owner_intern(const char *name) {
+    if (!name) return TTAK_OWNER_NAME_NONE;
+    ttak_owner_name_t id = ttak_owner_name_find(name);
+    if (id != TTAK_OWNER_NAME_NONE) return id;
+
+    size_t len = strlen(name);
+    uint64_t h = _hash_str(name, len);
+    uint64_t now = ttak_get_tick_count();
+
+    pthread_mutex_lock(&g_names_lock);
+    ttak_owner_name_table_t *t = atomic_load_explicit(&g_names, memory_order_relaxed);
+    id = _name_probe(t, name, h);
+    if (id != TTAK_OWNER_NAME_NONE) goto out;
+
+    if (!t || (t->used + 1) * 4 > (t->mask + 1) * 3) {
+        uint32_t cap = t ? (t->mask + 1) * 2 : 64;
+        ttak_owner_name_table_t *grown = _name_table_new(cap, now);
+        if (!grown) goto out;
+        if (t) {
+            for (uint32_t i = 0; i <= t->mask; ++i) {
+                ttak_owner_name_entry_t *e = atomic_load_explicit(&t->slot[i], memory_order_relaxed);
+                if (e) _name_table_put(grown, e);
+            }
+        }
+        atomic_store_explicit(&g_names, grown, memory_order_release);
+        if (t) ttak_epoch_retire(t, ttak_mem_free);
+        t = grown;
+    }
+
+    ttak_owner_name_entry_t *e = ttak_mem_alloc_raw(sizeof(*e) + len + 1, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!e) goto out;
+    e->hash = h;
+    e->id = g_names_next++;
+    memcpy(e->name, name, len + 1);
+    _name_table_put(t, e);
+    id = e->id;
+out:
+    pthread_mutex_unlock(&g_names_lock);
+    return id;
+}
+
+static struct ttak_owner_slots *_slots_new(uint32_t cap, uint64_t now) {
+    size_t bytes = sizeof(struct ttak_owner_slots) + (size_t)cap * sizeof(ttak_owner_slot_t);
+    struct ttak_owner_slots *t = ttak_mem_alloc_raw(bytes, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!t) return NULL;
+    memset(t, 0, bytes);
+    t->mask = cap - 1;
+    return t;
+}
+
+/* Lock-free lookup; caller holds an epoch. */
+static bool _slots_get(struct ttak_owner_slots *t, ttak_owner_name_t id, uintptr_t *out) {
+    if (!t) return false;
+    for (uint32_t i = _slot_home(id, t->mask), n = 0; n <= t->mask; i = (i + 1) & t->mask, ++n) {
+        uint32_t sid = atomic_load_explicit(&t->slot[i].id, memory_order_acquire);
+        if (sid == 0) return false;
+        if (sid != id) continue;
+        if (!atomic_load_explicit(&t->slot[i].live, memory_order_acquire)) return false;
+        *out = atomic_load_explicit(&t->slot[i].value, memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+static ttak_owner_slot_t *_slots_find(struct ttak_owner_slots *t, ttak_owner_name_t id) {
+    for (uint32_t i = _slot_home(id, t->mask), n = 0; n <= t->mask; i = (i + 1) & t->mask, ++n) {
+        uint32_t sid = atomic_load_explicit(&t->slot[i].id, memory_order_relaxed);
+        if (sid == id) return &t->slot[i];
+        if (sid == 0) return NULL;
+    }
+    return NULL;
+}
+
+static void _slots_claim(struct ttak_owner_slots *t, ttak_owner_name_t id, uintptr_t value) {
+    uint32_t i = _slot_home(id, t->mask);
+    while (atomic_load_explicit(&t->slot[i].id, memory_order_relaxed)) i = (i + 1) & t->mask;
+    atomic_store_explicit(&t->slot[i].value, value, memory_order_relaxed);
+    atomic_store_explicit(&t->slot[i].live, 1, memory_order_relaxed);
+    atomic_store_explicit(&t->slot[i].id, id, memory_order_release);
+    t->used++;
+}
+
+/* Writer-side insert or update; caller holds owner->lock as writer. */
+static bool _slots_put(struct ttak_owner_slots *_Atomic *root, ttak_owner_name_t id, uintptr_t value) {
+    struct ttak_owner_slots *t = atomic_load_explicit(root, memory_order_relaxed);
+    ttak_owner_slot_t *s = t ? _slots_find(t, id) : NULL;
+    if (s) {
+        atomic_store_explicit(&s->value, value, memory_order_relaxed);
+        atomic_store_explicit(&s->live, 1, memory_order_release);
+        return true;
+    }
+    if (!t || (t->used + 1) * 4 > (t->mask + 1) * 3) {
+        /* Rebuild from live entries only, which also sheds dead slots. */
+        uint32_t live = 0;
+        if (t) {
+            for (uint32_t i = 0; i <= t->mask; ++i) live += atomic_load_explicit(&t->slot[i].live, memory_order_relaxed);
+        }
+        uint32_t cap = OWNER_SLOTS_MIN;
+        while (cap * 3 < (live + 1) * 8) cap <<= 1;
+        struct ttak_owner_slots *grown = _slots_new(cap, ttak_get_tick_count());
+        if (!grown) return false;
+        if (t) {
+            for (uint32_t i = 0; i <= t->mask; ++i) {
+                if (!atomic_load_explicit(&t->slot[i].live, memory_order_relaxed)) continue;
+                _slots_claim(grown, atomic_load_explicit(&t->slot[i].id, memory_order_relaxed),
+                             atomic_load_explicit(&t->slot[i].value, memory_order_relaxed));
+            }
+        }
+        _slots_claim(grown, id, value);
+        atomic_store_explicit(root, grown, memory_order_release);
+        if (t) ttak_epoch_retire(t, ttak_mem_free);
+        return true;
+    }
+    _slots_claim(t, id, value);
+    return true;
+}
+
+static bool _slots_take(struct ttak_owner_slots *_Atomic *root, ttak_owner_name_t id, uintptr_t *out) {
+    struct ttak_owner_slots *t = atomic_load_explicit(root, memory_order_relaxed);
+    ttak_owner_slot_t *s = t ? _slots_find(t, id) : NULL;
+    if (!s || !atomic_load_explicit(&s->live, memory_order_relaxed)) return false;
+    *out = atomic_load_explicit(&s->value, memory_order_relaxed);
+    atomic_store_explicit(&s->live, 0, memory_order_release);
+    return true;
 }
 
 ttak_owner_t *ttak_owner_create(uint32_t policy) {
@@ -30,11 +227,11 @@ ttak_owner_t *ttak_owner_create(uint32_t policy) {
     if (!owner) return NULL;
 
     owner->id = atomic_fetch_add(&g_owner_id_counter, 1);
-    
-    // Initialize resource and function maps
-    owner->resources = ttak_create_map(32, now);
-    owner->functions = ttak_create_map(32, now);
-    
+
+    // Slot tables are allocated on first registration.
+    atomic_init(&owner->resources, NULL);
+    atomic_init(&owner->functions, NULL);
+
     ttak_rwlock_init(&owner->lock);
     owner->creation_ts = now;
     owner->policy_flags = policy;
@@ -46,66 +243,90 @@ void ttak_owner_destroy(ttak_owner_t *owner) {
     if (!owner) return;
 
     ttak_rwlock_wrlock(&owner->lock);
-    
+
     // Note: We do not deep-free resources here as we don't know their destructors.
     // In a full system, we might need a resource wrapper with a dtor.
-    // ttak_map_destroy(owner->resources); // Assuming generic map destroy exists or we just leak for this snippet
-    // ttak_map_destroy(owner->functions);
-    
+    struct ttak_owner_slots *res = atomic_exchange(&owner->resources, NULL);
+    struct ttak_owner_slots *fns = atomic_exchange(&owner->functions, NULL);
+
     ttak_rwlock_unlock(&owner->lock);
     ttak_rwlock_destroy(&owner->lock);
+    if (res) ttak_mem_free(res);
+    if (fns) ttak_mem_free(fns);
     ttak_mem_free(owner);
 }
 
-bool ttak_owner_register_func(ttak_owner_t *owner, const char *name, ttak_owner_func_t func) {
-    if (!owner || !name || !func) return false;
+bool ttak_owner_register_func_id(ttak_owner_t *owner, ttak_owner_name_t name, ttak_owner_func_t func) {
+    if (!owner || name == TTAK_OWNER_NAME_NONE || !func) return false;
 
     ttak_rwlock_wrlock(&owner->lock);
-    uintptr_t key = _hash_str(name);
-    
     // Check if strict policy prevents overwriting (simplified: just insert)
-    ttak_insert_to_map(owner->functions, key, (size_t)func, ttak_get_tick_count());
-    
+    bool ok = _slots_put(&owner->functions, name, (uintptr_t)func);
     ttak_rwlock_unlock(&owner->lock);
-    return true;
+    return ok;
 }
 
-bool ttak_owner_register_resource(ttak_owner_t *owner, const char *name, void *data) {
-    if (!owner || !name) return false;
+bool ttak_owner_register_func(ttak_owner_t *owner, const char *name, ttak_owner_func_t func) {
+    if (!owner || !name || !func) return false;
+    return ttak_owner_register_func_id(owner, ttak_owner_intern(name), func);
+}
 
+static bool _register_resource(ttak_owner_t *owner, ttak_owner_name_t id, const char *name, void *data) {
     ttak_rwlock_wrlock(&owner->lock);
-    uintptr_t key = _hash_str(name);
-    
-    ttak_insert_to_map(owner->resources, key, (size_t)data, ttak_get_tick_count());
-    
-    if (ttak_mem_is_trace_enabled()) {
-        fprintf(stderr, "[MEM_TRACK] {\"event\":\"register\",\"ptr\":\"%p\",\"owner\":\"%p\",\"name\":\"%s\",\"ts\":%" PRIu64 "}\n", 
-                data, (void*)owner, name, ttak_get_tick_count());
+    bool ok = _slots_put(&owner->resources, id, (uintptr_t)data);
+
+    if (ok && ttak_mem_is_trace_enabled()) {
+        if (name) {
+            fprintf(stderr, "[MEM_TRACK] {\"event\":\"register\",\"ptr\":\"%p\",\"owner\":\"%p\",\"name\":\"%s\",\"ts\":%" PRIu64 "}\n",
+                    data, (void*)owner, name, ttak_get_tick_count());
+        } else {
+            fprintf(stderr, "[MEM_TRACK] {\"event\":\"register\",\"ptr\":\"%p\",\"owner\":\"%p\",\"name_id\":%" PRIu32 ",\"ts\":%" PRIu64 "}\n",
+                    data, (void*)owner, id, ttak_get_tick_count());
+        }
     }
 
     ttak_rwlock_unlock(&owner->lock);
-    return true;
+    return ok;
+}
+
+bool ttak_owner_register_resource_id(ttak_owner_t *owner, ttak_owner_name_t name, void *data) {
+    if (!owner || name == TTAK_OWNER_NAME_NONE) return false;
+    return _register_resource(owner, name, NULL, data);
+}
+
+bool ttak_owner_register_resource(ttak_owner_t *owner, const char *name, void *data) {
+    if (!owner || !name) return false;
+    ttak_owner_name_t id = ttak_owner_intern(name);
+    if (id == TTAK_OWNER_NAME_NONE) return false;
+    return _register_resource(owner, id, name, data);
 }
 
 bool ttak_owner_transfer_resource(ttak_owner_t *from, ttak_owner_t *to, const char *name) {
     if (!from || !to || !name) return false;
 
-    uintptr_t key = _hash_str(name);
-    size_t data_val = 0;
+    ttak_owner_name_t id = ttak_owner_name_find(name);
+    if (id == TTAK_OWNER_NAME_NONE) return false;
+    uintptr_t data_val = 0;
 
     ttak_rwlock_wrlock(&from->lock);
-    if (!ttak_map_get_key(from->resources, key, &data_val, ttak_get_tick_count())) {
+    if (!_slots_take(&from->resources, id, &data_val)) {
         ttak_rwlock_unlock(&from->lock);
         return false;
     }
-    ttak_delete_from_map(from->resources, key, 0);
     ttak_rwlock_unlock(&from->lock);
 
     ttak_rwlock_wrlock(&to->lock);
-    ttak_insert_to_map(to->resources, key, data_val, ttak_get_tick_count());
-    
+    if (!_slots_put(&to->resources, id, data_val)) {
+        ttak_rwlock_unlock(&to->lock);
+        /* Hand it back rather than lose it. */
+        ttak_rwlock_wrlock(&from->lock);
+        _slots_put(&from->resources, id, data_val);
+        ttak_rwlock_unlock(&from->lock);
+        return false;
+    }
+
     if (ttak_mem_is_trace_enabled()) {
-        fprintf(stderr, "[MEM_TRACK] {\"event\":\"transfer\",\"ptr\":\"%p\",\"from\":\"%p\",\"to\":\"%p\",\"name\":\"%s\",\"ts\":%" PRIu64 "}\n", 
+        fprintf(stderr, "[MEM_TRACK] {\"event\":\"transfer\",\"ptr\":\"%p\",\"from\":\"%p\",\"to\":\"%p\",\"name\":\"%s\",\"ts\":%" PRIu64 "}\n",
                 (void*)data_val, (void*)from, (void*)to, name, ttak_get_tick_count());
     }
 
@@ -113,42 +334,74 @@ bool ttak_owner_transfer_resource(ttak_owner_t *from, ttak_owner_t *to, const ch
     return true;
 }
 
-bool ttak_owner_execute(ttak_owner_t *owner, const char *func_name, const char *resource_name, void *args) {
-    if (!owner || !func_name) return false;
+bool ttak_owner_forget_data(ttak_owner_t *owner, const void *data) {
+    if (!owner) return false;
+    bool found = false;
+
+    ttak_rwlock_wrlock(&owner->lock);
+    struct ttak_owner_slots *t = atomic_load_explicit(&owner->resources, memory_order_relaxed);
+    for (uint32_t i = 0; t && i <= t->mask; ++i) {
+        if (atomic_load_explicit(&t->slot[i].live, memory_order_relaxed) &&
+            atomic_load_explicit(&t->slot[i].value, memory_order_relaxed) == (uintptr_t)data) {
+            atomic_store_explicit(&t->slot[i].live, 0, memory_order_release);
+            found = true;
+            break;
+        }
+    }
+    ttak_rwlock_unlock(&owner->lock);
+    return found;
+}
+
+bool ttak_owner_lookup_resource(ttak_owner_t *owner, ttak_owner_name_t name, void **out) {
+    if (!owner || name == TTAK_OWNER_NAME_NONE) return false;
+    uintptr_t v = 0;
+    ttak_epoch_enter();
+    bool found = _slots_get(atomic_load_explicit(&owner->resources, memory_order_acquire), name, &v);
+    ttak_epoch_exit();
+    if (found && out) *out = (void *)v;
+    return found;
+}
 
-    ttak_rwlock_rdlock(&owner->lock);
+bool ttak_owner_execute_id(ttak_owner_t *owner, ttak_owner_name_t func_name, ttak_owner_name_t resource, void *args) {
+    if (!owner || func_name == TTAK_OWNER_NAME_NONE) return false;
 
     // 1. Safety Check: Verify policy
-    
-    uintptr_t func_key = _hash_str(func_name);
-    if(func_key == (uintptr_t) NULL) return false;
-    size_t func_ptr_val = 0;
-    
+
+    uintptr_t func_ptr_val = 0;
+    uintptr_t res_ptr_val = 0;
+
+    ttak_epoch_enter();
+
     // 2. Retrieve Function
-    if (!ttak_map_get_key(owner->functions, func_key, &func_ptr_val, ttak_get_tick_count())) {
-        ttak_rwlock_unlock(&owner->lock);
+    if (!_slots_get(atomic_load_explicit(&owner->functions, memory_order_acquire), func_name, &func_ptr_val)) {
+        ttak_epoch_exit();
         return false; // Function not found
     }
 
     // 3. Retrieve Context Resource (if specified)
-    void *ctx = NULL;
-    if (resource_name) {
-        uintptr_t res_key = _hash_str(resource_name);
-        size_t res_ptr_val = 0;
-        if (ttak_map_get_key(owner->resources, res_key, &res_ptr_val, ttak_get_tick_count())) {
-            ctx = (void *)res_ptr_val;
-        }
+    if (resource != TTAK_OWNER_NAME_NONE) {
+        _slots_get(atomic_load_explicit(&owner->resources, memory_order_acquire), resource, &res_ptr_val);
     }
 
-    ttak_owner_func_t func = (ttak_owner_func_t)func_ptr_val;
-
-    ttak_rwlock_unlock(&owner->lock);
+    ttak_epoch_exit();
 
     // 4. Execution Boundary
     // Ideally, we would set thread-local storage here to indicate we are inside this owner
     // so that mem_alloc calls check the owner's policy.
 
-    func(ctx, args);
+    ttak_owner_func_t func = (ttak_owner_func_t)func_ptr_val;
+    func((void *)res_ptr_val, args);
 
     return true;
 }
+
+bool ttak_owner_execute(ttak_owner_t *owner, const char *func_name, const char *resource_name, void *args) {
+    if (!owner || !func_name) return false;
+
+    // Names that were never interned cannot have been registered.
+    ttak_owner_name_t func_id = ttak_owner_name_find(func_name);
+    if (func_id == TTAK_OWNER_NAME_NONE) return false;
+    ttak_owner_name_t res_id = resource_name ? ttak_owner_name_find(resource_name) : TTAK_OWNER_NAME_NONE;
+
+    return ttak_owner_execute_id(owner, func_id, res_id, args);
+}
@@ -3,7 +3,9 @@
  * @brief Implementation of the Thread-Local Pocket Allocator.
  *
  * This tier handles small, frequently allocated objects (up to 512 bytes user payload)
- * using thread-local freelists to avoid global synchronization.
+ * using thread-local freelists to avoid global synchronization. Blocks freed on a
+ * foreign thread go onto the owning thread's lock-free remote stack and are drained
+ * back in batches, so pages stay with the thread that carved them.
  *
  * Dual-Path Architecture:
  *   - OS Managed (TTAK_OS_MANAGED_MEMORY == 1): Pages are allocated directly from
@@ -57,26 +59,155 @@ ttak_mem_pocket_freelist_t *ttak_tls_get_pocket_freelists(void) {
 TTAK_THREAD_LOCAL ttak_mem_pocket_freelist_t ttak_pocket_freelists[TTAK_NUM_POCKET_FREELISTS] = {0};
 #endif
 
+/**
+ * @brief Per-thread pocket owner descriptor.
+ *
+ * Blocks freed by a thread other than the page owner are pushed onto the
+ * owner's lock-free remote stacks; the owner drains them in one exchange
+ * when its local freelist runs dry. Descriptors are never released because
+ * pages outlive their owner thread.
+ */
+typedef struct ttak_pocket_owner_t {
+    alignas(64) void *_Atomic remote_heads[TTAK_NUM_POCKET_FREELISTS]; /**< Remote-free stacks per class */
+    _Atomic uint32_t alive;             /**< Cleared by the thread-exit destructor */
+    alignas(64) _Atomic uint64_t allocs[TTAK_NUM_POCKET_FREELISTS]; /**< Written only by the owning thread */
+    _Atomic uint64_t frees[TTAK_NUM_POCKET_FREELISTS];              /**< Written only by the owning thread */
+    struct ttak_pocket_owner_t *_Atomic stats_next;                  /**< Link in pocket_owner_list */
+} ttak_pocket_owner_t;
+
 typedef struct ttak_pocket_page_meta_t {
     uint32_t magic_with_idx;
-    uintptr_t owner_thread;
+    ttak_pocket_owner_t *owner;
 #if TTAK_OS_MANAGED_MEMORY
-    _Atomic uint32_t free_count;
+    _Atomic uint32_t free_count;        /**< Blocks resident in the owner's local freelist */
     uint32_t total_blocks;
 #endif
 } ttak_pocket_page_meta_t;
 
-static pthread_mutex_t pocket_remote_lock = PTHREAD_MUTEX_INITIALIZER;
-static void *pocket_remote_freelists[TTAK_NUM_POCKET_FREELISTS] = {0};
+/* Blocks whose owner thread has exited; shared by every thread. */
+static pthread_mutex_t pocket_orphan_lock = PTHREAD_MUTEX_INITIALIZER;
+static void *pocket_orphan_freelists[TTAK_NUM_POCKET_FREELISTS] = {0};
+
+static pthread_once_t pocket_owner_once = PTHREAD_ONCE_INIT;
+static pthread_key_t pocket_owner_key;
+#if !defined(__TINYC__)
+static TTAK_THREAD_LOCAL ttak_pocket_owner_t *pocket_tls_owner = NULL;
+#endif
+
+_Static_assert(TTAK_MEM_STATS_POCKET_BINS == TTAK_NUM_POCKET_FREELISTS, "pocket bin count mismatch");
+
+/* Every descriptor ever created, walked by ttak_mem_pocket_stats(). */
+static ttak_pocket_owner_t *_Atomic pocket_owner_list = NULL;
+/* Pages currently carved per class, and operations by threads without a descriptor. */
+static _Atomic uint64_t pocket_pages[TTAK_NUM_POCKET_FREELISTS];
+static _Atomic uint64_t pocket_unowned_allocs[TTAK_NUM_POCKET_FREELISTS];
+static _Atomic uint64_t pocket_unowned_frees[TTAK_NUM_POCKET_FREELISTS];
 
 #if !TTAK_OS_MANAGED_MEMORY
 static pthread_mutex_t pocket_page_pool_lock = PTHREAD_MUTEX_INITIALIZER;
-static _Alignas(TTAK_POCKET_ALIGNMENT) uint8_t pocket_page_pool[TTAK_POCKET_PAGE_SIZE * 2048];
+#define TTAK_POCKET_POOL_SIZE ((size_t)TTAK_POCKET_PAGE_SIZE * 2048)
+#if TTAK_LAZY_STATIC_REGIONS
+/* Reserved on the first page carve. */
+static uint8_t *pocket_page_pool = NULL;
+#else
+static _Alignas(TTAK_POCKET_ALIGNMENT) uint8_t pocket_page_pool[TTAK_POCKET_POOL_SIZE];
+#endif
 static size_t pocket_page_pool_cursor = 0;
 #endif
 
-static uintptr_t ttak_thread_identity(void) {
-    return (uintptr_t)pthread_self();
+/**
+ * @brief Splices a NULL-terminated block chain onto an orphan freelist.
+ */
+static void pocket_orphan_push_chain(int idx, void *chain) {
+    if (!chain) return;
+    void *tail = chain;
+    while (*(void **)tail) tail = *(void **)tail;
+    pthread_mutex_lock(&pocket_orphan_lock);
+    *(void **)tail = pocket_orphan_freelists[idx];
+    pocket_orphan_freelists[idx] = chain;
+    pthread_mutex_unlock(&pocket_orphan_lock);
+}
+
+/**
+ * @brief Moves whatever is parked on a dead owner's remote stacks to the orphan lists.
+ */
+static void pocket_owner_orphan_remote(ttak_pocket_owner_t *owner) {
+    for (int i = 0; i < TTAK_NUM_POCKET_FREELISTS; ++i) {
+        pocket_orphan_push_chain(i, atomic_exchange_explicit(&owner->remote_heads[i], NULL, memory_order_acquire));
+    }
+}
+
+static void pocket_owner_destructor(void *arg) {
+    ttak_pocket_owner_t *owner = (ttak_pocket_owner_t *)arg;
+    if (!owner) return;
+    atomic_store_explicit(&owner->alive, 0, memory_order_seq_cst);
+    pocket_owner_orphan_remote(owner);
+    for (int i = 0; i < TTAK_NUM_POCKET_FREELISTS; ++i) {
+        pocket_orphan_push_chain(i, ttak_pocket_freelists[i].head);
+        ttak_pocket_freelists[i].head = NULL;
+    }
+#if !defined(__TINYC__)
+    pocket_tls_owner = NULL;
+#endif
+}
+
+static void pocket_owner_key_init(void) {
+    pthread_key_create(&pocket_owner_key, pocket_owner_destructor);
+}
+
+/**
+ * @brief Returns the calling thread's owner descriptor without creating one.
+ */
+static inline ttak_pocket_owner_t *pocket_owner_current(void) {
+#if defined(__TINYC__)
+    pthread_once(&pocket_owner_once, pocket_owner_key_init);
+    return (ttak_pocket_owner_t *)pthread_getspecific(pocket_owner_key);
+#else
+    return pocket_tls_owner;
+#endif
+}
+
+/**
+ * @brief Returns the calling thread's owner descriptor, creating it on first use.
+ */
+static ttak_pocket_owner_t *pocket_owner_self(void) {
+    ttak_pocket_owner_t *owner = pocket_owner_current();
+    if (owner) return owner;
+    pthread_once(&pocket_owner_once, pocket_owner_key_init);
+    owner = (ttak_pocket_owner_t *)ttak_dangerous_alloc(sizeof(*owner));
+    if (!owner) return NULL;
+    for (int i = 0; i < TTAK_NUM_POCKET_FREELISTS; ++i) atomic_init(&owner->remote_heads[i], NULL);
+    atomic_init(&owner->alive, 1);
+    for (int i = 0; i < TTAK_NUM_POCKET_FREELISTS; ++i) {
+        atomic_init(&owner->allocs[i], 0);
+        atomic_init(&owner->frees[i], 0);
+    }
+    ttak_pocket_owner_t *head = atomic_load_explicit(&pocket_owner_list, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&owner->stats_next, head, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&pocket_owner_list, &head, owner,
+                                                    memory_order_release, memory_order_relaxed));
+    pthread_setspecific(pocket_owner_key, owner);
+#if !defined(__TINYC__)
+    pocket_tls_owner = owner;
+#endif
+    return owner;
+}
+
+/**
+ * @brief Counts one allocation or free of class @p idx for the calling thread.
+ *
+ * Descriptor counters have a single writer, so a plain load/store pair
+ * suffices; threads without a descriptor share the atomic fallback.
+ */
+static inline void pocket_count(ttak_pocket_owner_t *self, bool is_alloc, int idx) {
+    if (self) {
+        _Atomic uint64_t *c = is_alloc ? &self->allocs[idx] : &self->frees[idx];
+        atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + 1, memory_order_relaxed);
+    } else {
+        atomic_fetch_add_explicit(is_alloc ? &pocket_unowned_allocs[idx] : &pocket_unowned_frees[idx],
+                                  1, memory_order_relaxed);
+    }
 }
 
 #if TTAK_OS_MANAGED_MEMORY
@@ -95,6 +226,8 @@ static void pocket_freelist_remove_page(void **head, uintptr_t page_start, size_
 
 static void* allocate_new_pocket_page(int freelist_idx) {
     void *page;
+    ttak_pocket_owner_t *owner = pocket_owner_self();
+    if (!owner) return NULL;
 
 #if TTAK_OS_MANAGED_MEMORY
     page = ttak_os_mem_alloc(TTAK_POCKET_PAGE_SIZE);
@@ -104,7 +237,13 @@ static void* allocate_new_pocket_page(int freelist_idx) {
     }
 #else
     pthread_mutex_lock(&pocket_page_pool_lock);
-    if (pocket_page_pool_cursor + TTAK_POCKET_PAGE_SIZE > sizeof(pocket_page_pool)) {
+#if TTAK_LAZY_STATIC_REGIONS
+    if (!pocket_page_pool) pocket_page_pool = ttak_static_region_reserve(TTAK_POCKET_POOL_SIZE);
+    if (!pocket_page_pool ||
+        pocket_page_pool_cursor + TTAK_POCKET_PAGE_SIZE > TTAK_POCKET_POOL_SIZE) {
+#else
+    if (pocket_page_pool_cursor + TTAK_POCKET_PAGE_SIZE > TTAK_POCKET_POOL_SIZE) {
+#endif
         pthread_mutex_unlock(&pocket_page_pool_lock);
         fprintf(stderr, "ttak_mem_pocket: Failed to allocate new page\n");
         return NULL;
@@ -118,7 +257,7 @@ static void* allocate_new_pocket_page(int freelist_idx) {
 
     ttak_pocket_page_meta_t *page_meta = (ttak_pocket_page_meta_t *)page;
     page_meta->magic_with_idx = POCKET_MAGIC | (freelist_idx & 0xFF);
-    page_meta->owner_thread = ttak_thread_identity();
+    page_meta->owner = owner;
 
     size_t total_block_size = get_total_block_size_for_freelist(freelist_idx);
 
@@ -130,6 +269,7 @@ static void* allocate_new_pocket_page(int freelist_idx) {
     atomic_init(&page_meta->free_count, (uint32_t)num_blocks);
     page_meta->total_blocks = (uint32_t)num_blocks;
 #endif
+    atomic_fetch_add_explicit(&pocket_pages[freelist_idx], 1, memory_order_relaxed);
 
     for (size_t i = 0; i < num_blocks; ++i) {
         void* block = (void*)current_block_ptr;
@@ -140,87 +280,240 @@ static void* allocate_new_pocket_page(int freelist_idx) {
     return page;
 }
 
-ttak_mem_header_t* ttak_mem_pocket_alloc_internal(size_t user_requested_size) {
-    if (user_requested_size == 0 || user_requested_size > 512) return NULL;
+/**
+ * @brief Returns a block to the owner's local freelist (owner thread only).
+ *
+ * Unmaps the page once every block is back on the local list.
+ */
+static void pocket_local_free(ttak_pocket_page_meta_t *page_meta, int idx, void *block) {
+#if TTAK_OS_MANAGED_MEMORY
+    uint32_t prev_free = atomic_fetch_add_explicit(&page_meta->free_count, 1, memory_order_relaxed);
+    if (prev_free + 1 >= page_meta->total_blocks) {
+        pocket_freelist_remove_page(&ttak_pocket_freelists[idx].head, (uintptr_t)page_meta, TTAK_POCKET_PAGE_SIZE);
+        ttak_os_mem_free((void *)page_meta, TTAK_POCKET_PAGE_SIZE);
+        atomic_fetch_sub_explicit(&pocket_pages[idx], 1, memory_order_relaxed);
+        return;
+    }
+#else
+    (void)page_meta;
+#endif
+    *(void**)block = ttak_pocket_freelists[idx].head;
+    ttak_pocket_freelists[idx].head = block;
+}
 
-    size_t total_block_size = sizeof(ttak_mem_header_t) + user_requested_size;
-    int idx = get_pocket_size_class_idx(total_block_size);
-    if (idx == -1) {
-        return NULL;
+/**
+ * @brief Drains the calling owner's remote stack for one size class in a single exchange.
+ * @return Number of blocks moved back to the local freelist.
+ */
+static size_t pocket_drain_remote(ttak_pocket_owner_t *owner, int idx) {
+    if (!owner || !atomic_load_explicit(&owner->remote_heads[idx], memory_order_relaxed)) return 0;
+    void *chain = atomic_exchange_explicit(&owner->remote_heads[idx], NULL, memory_order_acquire);
+    size_t drained = 0;
+    while (chain) {
+        void *next = *(void **)chain;
+        uintptr_t page_start = (uintptr_t)chain & ~((uintptr_t)TTAK_POCKET_PAGE_SIZE - 1);
+        pocket_local_free((ttak_pocket_page_meta_t *)page_start, idx, chain);
+        chain = next;
+        ++drained;
     }
+    return drained;
+}
 
-    ttak_mem_header_t* header_block = (ttak_mem_header_t*)ttak_pocket_freelists[idx].head;
-    if (header_block) {
-        ttak_pocket_freelists[idx].head = *(void**)header_block;
-    } else {
-        pthread_mutex_lock(&pocket_remote_lock);
-        if (pocket_remote_freelists[idx]) {
-            header_block = (ttak_mem_header_t*)pocket_remote_freelists[idx];
-            pocket_remote_freelists[idx] = *(void **)header_block;
-            pthread_mutex_unlock(&pocket_remote_lock);
-        } else {
-            pthread_mutex_unlock(&pocket_remote_lock);
-            if (!allocate_new_pocket_page(idx)) {
-                return NULL;
-            }
-            header_block = (ttak_mem_header_t*)ttak_pocket_freelists[idx].head;
-            if (header_block) {
-                 ttak_pocket_freelists[idx].head = *(void**)header_block;
-            } else {
-                return NULL;
-            }
-        }
+/**
+ * @brief Pushes a block onto its owner's remote stack (any thread, lock-free).
+ */
+static void pocket_remote_free(ttak_pocket_owner_t *owner, int idx, void *block) {
+    if (!atomic_load_explicit(&owner->alive, memory_order_acquire)) {
+        *(void **)block = NULL;
+        pocket_orphan_push_chain(idx, block);
+        return;
+    }
+    void *head = atomic_load_explicit(&owner->remote_heads[idx], memory_order_relaxed);
+    do {
+        *(void **)block = head;
+    } while (!atomic_compare_exchange_weak_explicit(&owner->remote_heads[idx], &head, block,
+                                                    memory_order_release, memory_order_relaxed));
+    /* The owner may have exited between the liveness check and the push. */
+    if (!atomic_load_explicit(&owner->alive, memory_order_seq_cst)) {
+        pocket_owner_orphan_remote(owner);
     }
+}
+
+static void *pocket_alloc_class(int idx) {
 
+    void *block = ttak_pocket_freelists[idx].head;
+    if (!block && pocket_drain_remote(pocket_owner_current(), idx) > 0) {
+        block = ttak_pocket_freelists[idx].head;
+    }
+    if (block) {
+        ttak_pocket_freelists[idx].head = *(void**)block;
 #if TTAK_OS_MANAGED_MEMORY
-    if (header_block) {
-        uintptr_t page_start = (uintptr_t)header_block & ~((uintptr_t)TTAK_POCKET_PAGE_SIZE - 1);
+        uintptr_t page_start = (uintptr_t)block & ~((uintptr_t)TTAK_POCKET_PAGE_SIZE - 1);
+        ttak_pocket_page_meta_t *meta = (ttak_pocket_page_meta_t *)page_start;
+        atomic_fetch_sub_explicit(&meta->free_count, 1, memory_order_relaxed);
+#endif
+        return block;
+    }
+
+    /* Orphaned blocks are never counted in free_count; their pages stay mapped. */
+    pthread_mutex_lock(&pocket_orphan_lock);
+    block = pocket_orphan_freelists[idx];
+    if (block) pocket_orphan_freelists[idx] = *(void **)block;
+    pthread_mutex_unlock(&pocket_orphan_lock);
+    if (block) return block;
+
+    if (!allocate_new_pocket_page(idx)) {
+        return NULL;
+    }
+    block = ttak_pocket_freelists[idx].head;
+    if (!block) return NULL;
+    ttak_pocket_freelists[idx].head = *(void**)block;
+#if TTAK_OS_MANAGED_MEMORY
+    {
+        uintptr_t page_start = (uintptr_t)block & ~((uintptr_t)TTAK_POCKET_PAGE_SIZE - 1);
         ttak_pocket_page_meta_t *meta = (ttak_pocket_page_meta_t *)page_start;
         atomic_fetch_sub_explicit(&meta->free_count, 1, memory_order_relaxed);
     }
 #endif
+    return block;
+}
 
-    return header_block;
+void *ttak_mem_pocket_alloc_block(size_t total_block_size) {
+    int idx = get_pocket_size_class_idx(total_block_size);
+    if (idx == -1) {
+        return NULL;
+    }
+    void *block = pocket_alloc_class(idx);
+    if (block) pocket_count(pocket_owner_current(), true, idx);
+    return block;
+}
+
+ttak_mem_header_t* ttak_mem_pocket_alloc_internal(size_t user_requested_size) {
+    if (user_requested_size == 0 || user_requested_size > 512) return NULL;
+    return (ttak_mem_header_t *)ttak_mem_pocket_alloc_block(sizeof(ttak_mem_header_t) + user_requested_size);
 }
 
 void _pocket_free_internal(ttak_mem_header_t* header) {
-    if (!header) return;
+    ttak_mem_pocket_free_block(header);
+}
+
+void ttak_mem_pocket_free_block(void *block) {
+    if (!block) return;
 
-    uintptr_t page_start_addr = (uintptr_t)header & ~((uintptr_t)TTAK_POCKET_PAGE_SIZE - 1);
+    uintptr_t page_start_addr = (uintptr_t)block & ~((uintptr_t)TTAK_POCKET_PAGE_SIZE - 1);
     ttak_pocket_page_meta_t *page_meta = (ttak_pocket_page_meta_t *)page_start_addr;
     uint32_t page_magic_val = page_meta->magic_with_idx;
 
     if ((page_magic_val & 0xFFFFFF00) != POCKET_MAGIC) {
-        fprintf(stderr, "ttak_mem_pocket: Freeing non-pocket allocated header %p\n", (void*)header);
+        fprintf(stderr, "ttak_mem_pocket: Freeing non-pocket allocated header %p\n", block);
         return;
     }
 
     int idx = page_magic_val & 0xFF;
     if (idx < 0 || idx >= TTAK_NUM_POCKET_FREELISTS) {
-        fprintf(stderr, "ttak_mem_pocket: Corrupted freelist index for header %p\n", (void*)header);
+        fprintf(stderr, "ttak_mem_pocket: Corrupted freelist index for header %p\n", block);
         return;
     }
 
-#if TTAK_OS_MANAGED_MEMORY
-    uint32_t prev_free = atomic_fetch_add_explicit(&page_meta->free_count, 1, memory_order_relaxed);
-    if (prev_free + 1 >= page_meta->total_blocks) {
-        pocket_freelist_remove_page(&ttak_pocket_freelists[idx].head, page_start_addr, TTAK_POCKET_PAGE_SIZE);
-        pthread_mutex_lock(&pocket_remote_lock);
-        pocket_freelist_remove_page(&pocket_remote_freelists[idx], page_start_addr, TTAK_POCKET_PAGE_SIZE);
-        pthread_mutex_unlock(&pocket_remote_lock);
-        ttak_os_mem_free((void*)page_start_addr, TTAK_POCKET_PAGE_SIZE);
+    ttak_pocket_owner_t *self = pocket_owner_current();
+    pocket_count(self, false, idx);
+    if (page_meta->owner == self) {
+        pocket_local_free(page_meta, idx, block);
         return;
     }
+    pocket_remote_free(page_meta->owner, idx, block);
+}
+
+#if TTAK_OS_MANAGED_MEMORY
+static int pocket_addr_cmp(const void *a, const void *b) {
+    uintptr_t x = *(const uintptr_t *)a, y = *(const uintptr_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Unmaps orphan pages of class @p idx whose every block is on the orphan list.
+ *
+ * Blocks of a dead owner's page are either live or orphaned, so a page
+ * with all its blocks on the list is unused. The list stays locked while
+ * it is rebuilt, so no block can be handed out in between.
+ */
+static size_t pocket_trim_orphans(int idx) {
+    size_t per_page = (TTAK_POCKET_PAGE_SIZE - 64) / get_total_block_size_for_freelist(idx);
+    pthread_mutex_lock(&pocket_orphan_lock);
+    size_t n = 0;
+    for (void *b = pocket_orphan_freelists[idx]; b; b = *(void **)b) n++;
+    if (n < per_page) {
+        pthread_mutex_unlock(&pocket_orphan_lock);
+        return 0;
+    }
+    uintptr_t *pages = malloc(n * sizeof(*pages));
+    if (!pages) {
+        pthread_mutex_unlock(&pocket_orphan_lock);
+        return 0;
+    }
+    n = 0;
+    for (void *b = pocket_orphan_freelists[idx]; b; b = *(void **)b) {
+        pages[n++] = (uintptr_t)b & ~((uintptr_t)TTAK_POCKET_PAGE_SIZE - 1);
+    }
+    qsort(pages, n, sizeof(*pages), pocket_addr_cmp);
+    /* Compact to the pages that are entirely free. */
+    size_t full = 0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && pages[j] == pages[i]) j++;
+        if (j - i == per_page) pages[full++] = pages[i];
+        i = j;
+    }
+    if (full) {
+        void **link = &pocket_orphan_freelists[idx];
+        while (*link) {
+            uintptr_t page = (uintptr_t)*link & ~((uintptr_t)TTAK_POCKET_PAGE_SIZE - 1);
+            if (bsearch(&page, pages, full, sizeof(*pages), pocket_addr_cmp)) {
+                *link = *(void **)*link;
+            } else {
+                link = (void **)*link;
+            }
+        }
+    }
+    pthread_mutex_unlock(&pocket_orphan_lock);
+    for (size_t i = 0; i < full; ++i) ttak_os_mem_free((void *)pages[i], TTAK_POCKET_PAGE_SIZE);
+    atomic_fetch_sub_explicit(&pocket_pages[idx], full, memory_order_relaxed);
+    free(pages);
+    return full * TTAK_POCKET_PAGE_SIZE;
+}
 #endif
 
-    if (page_meta->owner_thread == ttak_thread_identity()) {
-        *(void**)header = ttak_pocket_freelists[idx].head;
-        ttak_pocket_freelists[idx].head = header;
-        return;
+size_t ttak_mem_pocket_trim(void) {
+    size_t released = 0;
+    ttak_pocket_owner_t *self = pocket_owner_current();
+    for (int i = 0; i < TTAK_NUM_POCKET_FREELISTS; ++i) {
+        /* Draining unmaps pages that remote frees had left one block short. */
+        pocket_drain_remote(self, i);
+#if TTAK_OS_MANAGED_MEMORY
+        released += pocket_trim_orphans(i);
+#endif
     }
+    return released;
+}
 
-    pthread_mutex_lock(&pocket_remote_lock);
-    *(void**)header = pocket_remote_freelists[idx];
-    pocket_remote_freelists[idx] = header;
-    pthread_mutex_unlock(&pocket_remote_lock);
+void ttak_mem_pocket_stats(ttak_mem_stats_t *out) {
+    ttak_mem_tier_stats_t *tier = &out->tiers[TTAK_MEM_STATS_TIER_POCKET];
+    for (int i = 0; i < TTAK_NUM_POCKET_FREELISTS; ++i) {
+        int64_t live = (int64_t)(atomic_load_explicit(&pocket_unowned_allocs[i], memory_order_relaxed) -
+                                 atomic_load_explicit(&pocket_unowned_frees[i], memory_order_relaxed));
+        for (ttak_pocket_owner_t *o = atomic_load_explicit(&pocket_owner_list, memory_order_acquire); o;
+             o = atomic_load_explicit(&o->stats_next, memory_order_relaxed)) {
+            live += (int64_t)(atomic_load_explicit(&o->allocs[i], memory_order_relaxed) -
+                              atomic_load_explicit(&o->frees[i], memory_order_relaxed));
+        }
+        size_t block_size = get_total_block_size_for_freelist(i);
+        uint64_t pages = atomic_load_explicit(&pocket_pages[i], memory_order_relaxed);
+        int64_t slots = (int64_t)(pages * ((TTAK_POCKET_PAGE_SIZE - 64) / block_size));
+        /* Counters from different threads can be a few operations apart. */
+        size_t free_slots = (live < slots) ? (size_t)(slots - (live > 0 ? live : 0)) : 0;
+        out->pocket_free_blocks[i] = free_slots;
+        tier->free_blocks += free_slots;
+        tier->reserved_bytes += pages * TTAK_POCKET_PAGE_SIZE;
+        if (free_slots) tier->largest_free_block = block_size;
+    }
 }
@@ -0,0 +1,300 @@
+/**
+ * @file ttak_mem_profile.c
+ * @brief Sampling heap profiler hooked into ttak_mem_alloc_safe()/ttak_mem_free().
+ *
+ * Each thread keeps a byte countdown; when an allocation drives it below
+ * zero the call stack is captured and charged to a site keyed by
+ * (stack, tier, lifetime class). The next countdown is drawn from an
+ * exponential distribution with the configured mean, which is the model
+ * pprof assumes when it rescales heap_v2 profiles.
+ *
+ * Sampled headers remember their site (tagged with the reset generation),
+ * so the free path can credit in-use counters without any lookup.
+ */
+
+#include <ttak/mem/profile.h>
+#include <ttak/mem/mem.h>
+#include "../../internal/app_types.h"
+#include "../../internal/ttak/mem_internal.h"
+
+#include <math.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#if (defined(__GLIBC__) || defined(__APPLE__)) && !defined(__TINYC__)
+#include <execinfo.h>
+#define TTAK_PROFILE_HAVE_BACKTRACE 1
+#else
+#define TTAK_PROFILE_HAVE_BACKTRACE 0
+#endif
+
+/** Frames belonging to the profiler and allocator themselves. */
+#define TTAK_PROFILE_SKIP_FRAMES 2
+#define TTAK_PROFILE_SITE_BITS 16
+#define TTAK_PROFILE_SITE_MASK ((1u << TTAK_PROFILE_SITE_BITS) - 1u)
+
+typedef struct ttak_profile_site {
+    uint64_t hash;
+    uint32_t depth;
+    uint8_t tier;
+    uint8_t lifetime;
+    uint8_t used;
+    void *pcs[TTAK_MEM_PROFILE_MAX_DEPTH];
+    _Atomic uint64_t alloc_count;
+    _Atomic uint64_t alloc_bytes;
+    _Atomic uint64_t inuse_count;
+    _Atomic uint64_t inuse_bytes;
+} ttak_profile_site_t;
+
+_Atomic size_t global_profile_interval = 0;
+
+static ttak_profile_site_t profile_sites[TTAK_MEM_PROFILE_MAX_SITES];
+static size_t profile_site_count = 0;
+static _Atomic uint32_t profile_generation = 1;
+static _Atomic uint64_t profile_dropped = 0;
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static TTAK_THREAD_LOCAL int64_t t_profile_countdown = 0;
+static TTAK_THREAD_LOCAL uint64_t t_profile_rng = 0;
+
+static const char *const profile_tier_names[] = {
+    "unknown", "pocket", "vma", "slab", "buddy", "general"
+};
+
+static const char *const profile_lifetime_names[] = {
+    "short", "medium", "long", "forever"
+};
+
+static ttak_mem_lifetime_class_t profile_lifetime_class(uint64_t lifetime_ticks) {
+    if (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__) return TTAK_MEM_LIFETIME_FOREVER;
+    if (lifetime_ticks < TT_SECOND(1)) return TTAK_MEM_LIFETIME_SHORT;
+    if (lifetime_ticks < TT_MINUTE(1)) return TTAK_MEM_LIFETIME_MEDIUM;
+    return TTAK_MEM_LIFETIME_LONG;
+}
+
+/**
+ * @brief Draws the next sampling gap, exponentially distributed around @p mean.
+ */
+static int64_t profile_next_gap(size_t mean) {
+    if (t_profile_rng == 0) {
+        t_profile_rng = ((uint64_t)(uintptr_t)&t_profile_rng * 0x9E3779B97F4A7C15ULL) | 1u;
+    }
+    t_profile_rng ^= t_profile_rng << 13;
+    t_profile_rng ^= t_profile_rng >> 7;
+    t_profile_rng ^= t_profile_rng << 17;
+    /* 53 random bits mapped into (0, 1]. */
+    double u = ((double)(t_profile_rng >> 11) + 1.0) / 9007199254740992.0;
+    double gap = -log(u) * (double)mean;
+    if (gap > (double)INT64_MAX / 2) gap = (double)INT64_MAX / 2;
+    return (int64_t)gap + 1;
+}
+
+static uint64_t profile_hash(void *const *pcs, uint32_t depth, uint8_t tier, uint8_t lifetime) {
+    uint64_t h = 0xcbf29ce484222325ULL ^ ((uint64_t)tier << 8) ^ lifetime;
+    for (uint32_t i = 0; i < depth; ++i) {
+        h ^= (uint64_t)(uintptr_t)pcs[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h ? h : 1;
+}
+
+static uint32_t profile_capture(void **pcs) {
+#if TTAK_PROFILE_HAVE_BACKTRACE
+    void *raw[TTAK_MEM_PROFILE_MAX_DEPTH + TTAK_PROFILE_SKIP_FRAMES];
+    int n = backtrace(raw, (int)(sizeof(raw) / sizeof(raw[0])));
+    if (n <= TTAK_PROFILE_SKIP_FRAMES) return 0;
+    uint32_t depth = (uint32_t)(n - TTAK_PROFILE_SKIP_FRAMES);
+    memcpy(pcs, raw + TTAK_PROFILE_SKIP_FRAMES, depth * sizeof(void *));
+    return depth;
+#elif defined(__GNUC__) || defined(__clang__)
+    pcs[0] = __builtin_return_address(0);
+    return 1;
+#else
+    (void)pcs;
+    return 0;
+#endif
+}
+
+/**
+ * @brief Finds or creates the slot for a site. Caller holds profile_lock.
+ * @return Slot index, or -1 when the table is full.
+ */
+static int profile_site_slot(uint64_t hash, void *const *pcs, uint32_t depth, uint8_t tier, uint8_t lifetime) {
+    size_t idx = (size_t)hash & (TTAK_MEM_PROFILE_MAX_SITES - 1);
+    for (size_t probe = 0; probe < TTAK_MEM_PROFILE_MAX_SITES; ++probe) {
+        ttak_profile_site_t *site = &profile_sites[idx];
+        if (!site->used) {
+            if (profile_site_count >= TTAK_MEM_PROFILE_MAX_SITES - TTAK_MEM_PROFILE_MAX_SITES / 8) return -1;
+            site->used = 1;
+            site->hash = hash;
+            site->depth = depth;
+            site->tier = tier;
+            site->lifetime = lifetime;
+            memcpy(site->pcs, pcs, depth * sizeof(void *));
+            profile_site_count++;
+            return (int)idx;
+        }
+        if (site->hash == hash && site->depth == depth && site->tier == tier &&
+            site->lifetime == lifetime && memcmp(site->pcs, pcs, depth * sizeof(void *)) == 0) {
+            return (int)idx;
+        }
+        idx = (idx + 1) & (TTAK_MEM_PROFILE_MAX_SITES - 1);
+    }
+    return -1;
+}
+
+void ttak_mem_profile_record_alloc(ttak_mem_header_t *header, uint64_t lifetime_ticks) {
+    size_t mean = atomic_load_explicit(&global_profile_interval, memory_order_relaxed);
+    if (!mean) return;
+
+    t_profile_countdown -= (int64_t)header->size;
+    if (t_profile_countdown > 0) return;
+    t_profile_countdown = profile_next_gap(mean);
+
+    void *pcs[TTAK_MEM_PROFILE_MAX_DEPTH];
+    uint32_t depth = profile_capture(pcs);
+    uint8_t tier = header->allocation_tier;
+    uint8_t lifetime = (uint8_t)profile_lifetime_class(lifetime_ticks);
+    uint64_t hash = profile_hash(pcs, depth, tier, lifetime);
+
+    pthread_mutex_lock(&profile_lock);
+    int slot = profile_site_slot(hash, pcs, depth, tier, lifetime);
+    uint32_t gen = atomic_load_explicit(&profile_generation, memory_order_relaxed);
+    pthread_mutex_unlock(&profile_lock);
+    if (slot < 0) {
+        atomic_fetch_add_explicit(&profile_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    ttak_profile_site_t *site = &profile_sites[slot];
+    atomic_fetch_add_explicit(&site->alloc_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&site->alloc_bytes, header->size, memory_order_relaxed);
+    atomic_fetch_add_explicit(&site->inuse_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&site->inuse_bytes, header->size, memory_order_relaxed);
+    header->profile_site = (gen << TTAK_PROFILE_SITE_BITS) | ((uint32_t)slot + 1u);
+}
+
+void ttak_mem_profile_record_free(ttak_mem_header_t *header) {
+    uint32_t tag = header->profile_site;
+    header->profile_site = 0;
+    uint32_t gen = atomic_load_explicit(&profile_generation, memory_order_relaxed);
+    if ((tag >> TTAK_PROFILE_SITE_BITS) != (gen & (UINT32_MAX >> TTAK_PROFILE_SITE_BITS))) return;
+
+    ttak_profile_site_t *site = &profile_sites[(tag & TTAK_PROFILE_SITE_MASK) - 1u];
+    atomic_fetch_sub_explicit(&site->inuse_count, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&site->inuse_bytes, header->size, memory_order_relaxed);
+}
+
+void ttak_mem_profile_start(size_t sample_interval) {
+    atomic_store(&global_profile_interval, sample_interval);
+}
+
+void ttak_mem_profile_stop(void) {
+    atomic_store(&global_profile_interval, 0);
+}
+
+size_t ttak_mem_profile_interval(void) {
+    return atomic_load(&global_profile_interval);
+}
+
+void ttak_mem_profile_reset(void) {
+    pthread_mutex_lock(&profile_lock);
+    uint32_t gen = atomic_load(&profile_generation) + 1u;
+    if ((gen & (UINT32_MAX >> TTAK_PROFILE_SITE_BITS)) == 0) gen = 1;
+    atomic_store(&profile_generation, gen);
+    memset(profile_sites, 0, sizeof(profile_sites));
+    profile_site_count = 0;
+    atomic_store(&profile_dropped, 0);
+    pthread_mutex_unlock(&profile_lock);
+}
+
+size_t ttak_mem_profile_totals(ttak_mem_profile_site_stats_t *out) {
+    ttak_mem_profile_site_stats_t total = {0};
+    pthread_mutex_lock(&profile_lock);
+    for (size_t i = 0; i < TTAK_MEM_PROFILE_MAX_SITES; ++i) {
+        ttak_profile_site_t *site = &profile_sites[i];
+        if (!site->used) continue;
+        total.alloc_count += atomic_load(&site->alloc_count);
+        total.alloc_bytes += atomic_load(&site->alloc_bytes);
+        total.inuse_count += atomic_load(&site->inuse_count);
+        total.inuse_bytes += atomic_load(&site->inuse_bytes);
+    }
+    size_t sites = profile_site_count;
+    pthread_mutex_unlock(&profile_lock);
+    if (out) *out = total;
+    return sites;
+}
+
+static int profile_append_maps(FILE *out) {
+    if (fprintf(out, "\nMAPPED_LIBRARIES:\n") < 0) return -1;
+#if defined(__linux__)
+    FILE *maps = fopen("/proc/self/maps", "r");
+    if (!maps) return 0;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), maps)) > 0) {
+        if (fwrite(buf, 1, n, out) != n) {
+            fclose(maps);
+            return -1;
+        }
+    }
+    fclose(maps);
+#endif
+    return 0;
+}
+
+int ttak_mem_profile_write_pprof(FILE *out) {
+    if (!out) return -1;
+    ttak_mem_profile_site_stats_t total;
+    ttak_mem_profile_totals(&total);
+    size_t interval = atomic_load(&global_profile_interval);
+
+    int rc = 0;
+    pthread_mutex_lock(&profile_lock);
+    if (fprintf(out, "heap profile: %" PRIu64 ": %" PRIu64 " [%" PRIu64 ": %" PRIu64 "] @ heap_v2/%zu\n",
+                total.inuse_count, total.inuse_bytes, total.alloc_count, total.alloc_bytes, interval) < 0) {
+        rc = -1;
+    }
+    for (size_t i = 0; rc == 0 && i < TTAK_MEM_PROFILE_MAX_SITES; ++i) {
+        ttak_profile_site_t *site = &profile_sites[i];
+        if (!site->used) continue;
+        if (fprintf(out, "%" PRIu64 ": %" PRIu64 " [%" PRIu64 ": %" PRIu64 "] @",
+                    atomic_load(&site->inuse_count), atomic_load(&site->inuse_bytes),
+                    atomic_load(&site->alloc_count), atomic_load(&site->alloc_bytes)) < 0) {
+            rc = -1;
+            break;
+        }
+        for (uint32_t f = 0; f < site->depth; ++f) {
+            fprintf(out, " %p", site->pcs[f]);
+        }
+        if (fputc('\n', out) == EOF) rc = -1;
+    }
+    pthread_mutex_unlock(&profile_lock);
+
+    if (rc == 0) rc = profile_append_maps(out);
+    return (rc == 0 && !ferror(out)) ? 0 : -1;
+}
+
+int ttak_mem_profile_write_summary(FILE *out) {
+    if (!out) return -1;
+    pthread_mutex_lock(&profile_lock);
+    fprintf(out, "# interval=%zu sites=%zu dropped=%" PRIu64 "\n",
+            atomic_load(&global_profile_interval), profile_site_count, atomic_load(&profile_dropped));
+    fprintf(out, "# %-8s %-8s %12s %14s %12s %14s  top frame\n",
+            "tier", "lifetime", "inuse_objs", "inuse_bytes", "alloc_objs", "alloc_bytes");
+    for (size_t i = 0; i < TTAK_MEM_PROFILE_MAX_SITES; ++i) {
+        ttak_profile_site_t *site = &profile_sites[i];
+        if (!site->used) continue;
+        const char *tier = site->tier < sizeof(profile_tier_names) / sizeof(profile_tier_names[0])
+                               ? profile_tier_names[site->tier] : "unknown";
+        fprintf(out, "  %-8s %-8s %12" PRIu64 " %14" PRIu64 " %12" PRIu64 " %14" PRIu64 "  %p\n",
+                tier, profile_lifetime_names[site->lifetime],
+                atomic_load(&site->inuse_count), atomic_load(&site->inuse_bytes),
+                atomic_load(&site->alloc_count), atomic_load(&site->alloc_bytes),
+                site->depth ? site->pcs[0] : NULL);
+    }
+    pthread_mutex_unlock(&profile_lock);
+    return ferror(out) ? -1 : 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file ttak_mem_stats.c
+ * @brief Per-tier telemetry snapshots and fragmentation reports.
+ *
+ * The allocation paths in mem.c credit each block to its tier through
+ * ttak_mem_stats_note_alloc()/ttak_mem_stats_note_free(). A snapshot adds
+ * what only the tiers themselves know: reserved bytes and the shape of
+ * their free lists.
+ */
+
+#include <ttak/mem/mem_stats.h>
+#include <ttak/phys/mem/buddy.h>
+#include <ttak/timing/timing.h>
+#include "../../internal/ttak/mem_internal.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+ttak_mem_tier_counter_t ttak_mem_tier_counters[TTAK_MEM_STATS_TIER_COUNT];
+
+static const char *const tier_names[TTAK_MEM_STATS_TIER_COUNT] = {
+    "pocket", "vma", "buddy", "general",
+};
+
+static void buddy_tier_stats(ttak_mem_stats_t *out) {
+    ttak_mem_buddy_stats_t buddy;
+    ttak_mem_buddy_stats(&buddy);
+    ttak_mem_tier_stats_t *tier = &out->tiers[TTAK_MEM_STATS_TIER_BUDDY];
+    tier->reserved_bytes = buddy.pool_bytes;
+    tier->largest_free_block = buddy.largest_free_block;
+    for (size_t i = 0; i < TTAK_MEM_BUDDY_ORDER_COUNT; ++i) {
+        out->buddy_free_blocks[i] = buddy.free_blocks[i];
+        tier->free_blocks += buddy.free_blocks[i];
+    }
+}
+
+static double stats_rate(uint64_t now, uint64_t before, uint64_t elapsed_ns) {
+    if (elapsed_ns == 0 || now < before) return 0.0;
+    return (double)(now - before) * 1e9 / (double)elapsed_ns;
+}
+
+void ttak_mem_stats_snapshot(ttak_mem_stats_t *out, const ttak_mem_stats_t *prev) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    out->timestamp_ns = ttak_get_tick_count_ns();
+
+    for (int t = 0; t < TTAK_MEM_STATS_TIER_COUNT; ++t) {
+        ttak_mem_tier_counter_t *c = &ttak_mem_tier_counters[t];
+        ttak_mem_tier_stats_t *tier = &out->tiers[t];
+        tier->live_bytes = atomic_load_explicit(&c->live_bytes, memory_order_relaxed);
+        tier->allocs = atomic_load_explicit(&c->allocs, memory_order_relaxed);
+        tier->frees = atomic_load_explicit(&c->frees, memory_order_relaxed);
+        out->total_live_bytes += tier->live_bytes;
+    }
+
+    ttak_mem_pocket_stats(out);
+    ttak_mem_vma_stats(out);
+    buddy_tier_stats(out);
+
+    /* Lite fallbacks come from the system heap, which reports nothing back. */
+    ttak_mem_tier_stats_t *general = &out->tiers[TTAK_MEM_STATS_TIER_GENERAL];
+    if (general->reserved_bytes < general->live_bytes) general->reserved_bytes = general->live_bytes;
+
+    if (prev && out->timestamp_ns > prev->timestamp_ns) {
+        uint64_t elapsed = out->timestamp_ns - prev->timestamp_ns;
+        for (int t = 0; t < TTAK_MEM_STATS_TIER_COUNT; ++t) {
+            out->tiers[t].alloc_rate = stats_rate(out->tiers[t].allocs, prev->tiers[t].allocs, elapsed);
+            out->tiers[t].free_rate = stats_rate(out->tiers[t].frees, prev->tiers[t].frees, elapsed);
+        }
+    }
+}
+
+double ttak_mem_stats_fragmentation(const ttak_mem_tier_stats_t *tier) {
+    if (!tier || tier->reserved_bytes <= tier->live_bytes) return 0.0;
+    uint64_t free_bytes = tier->reserved_bytes - tier->live_bytes;
+    if (tier->largest_free_block >= free_bytes) return 0.0;
+    return 1.0 - (double)tier->largest_free_block / (double)free_bytes;
+}
+
+static int report_bins(FILE *out, const char *label, const size_t *bins, size_t count) {
+    bool any = false;
+    for (size_t i = 0; i < count; ++i) {
+        if (!bins[i]) continue;
+        if (!any && fprintf(out, "  %s free:", label) < 0) return -1;
+        any = true;
+        if (fprintf(out, " [%zu]=%zu", i, bins[i]) < 0) return -1;
+    }
+    if (any && fputc('\n', out) == EOF) return -1;
+    return 0;
+}
+
+int ttak_mem_stats_write_report(const ttak_mem_stats_t *stats, FILE *out) {
+    if (!stats || !out) return -1;
+    if (fprintf(out, "ttak memory: %" PRIu64 " bytes live\n", stats->total_live_bytes) < 0) return -1;
+    for (int t = 0; t < TTAK_MEM_STATS_TIER_COUNT; ++t) {
+        const ttak_mem_tier_stats_t *tier = &stats->tiers[t];
+        if (fprintf(out,
+                    "%-8s live=%" PRIu64 " reserved=%" PRIu64 " allocs=%" PRIu64 " frees=%" PRIu64
+                    " alloc/s=%.1f free/s=%.1f free_blocks=%zu largest_free=%zu frag=%.3f\n",
+                    tier_names[t], tier->live_bytes, tier->reserved_bytes, tier->allocs, tier->frees,
+                    tier->alloc_rate, tier->free_rate, tier->free_blocks, tier->largest_free_block,
+                    ttak_mem_stats_fragmentation(tier)) < 0) {
+            return -1;
+        }
+    }
+    if (report_bins(out, "pocket class", stats->pocket_free_blocks, TTAK_MEM_STATS_POCKET_BINS) ||
+        report_bins(out, "vma bin", stats->vma_free_blocks, TTAK_MEM_STATS_REGION_BINS) ||
+        report_bins(out, "general bin", stats->general_free_blocks, TTAK_MEM_STATS_REGION_BINS) ||
+        report_bins(out, "buddy order", stats->buddy_free_blocks, TTAK_MEM_BUDDY_ORDER_COUNT)) {
+        return -1;
+    }
+    return 0;
+}
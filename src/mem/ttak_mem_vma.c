@@ -18,59 +18,122 @@
 #include "../../internal/ttak/mem_internal.h"
 #include "../../include/ttak/mem/mem.h"
 #include <ttak/mem/fastpath.h>
+#include <ttak/arch/ttak_arch.h>
 
 #if !TTAK_OS_MANAGED_MEMORY
 
+#if defined(__unix__)
+#include <sys/mman.h>
+#endif
+
 typedef struct ttak_region_block_t {
     size_t size;
     struct ttak_region_block_t *prev;
     struct ttak_region_block_t *next;
+    struct ttak_region_block_t *free_prev;
     struct ttak_region_block_t *free_next;
     uint8_t is_free;
 } ttak_region_block_t;
 
+/*
+ * Size classes: every power of two from 2^TTAK_BIN_MIN_SHIFT upward is split
+ * into four quarter steps, so a class never spans more than 25% of its base.
+ */
+#define TTAK_BIN_MIN_SHIFT 8
+#define TTAK_BIN_SUB_SHIFT 2
+#define TTAK_BIN_SUB_COUNT (1 << TTAK_BIN_SUB_SHIFT)
+#define TTAK_BIN_COUNT 96
+#define TTAK_BIN_WORDS ((TTAK_BIN_COUNT + 63) / 64)
+
 typedef struct ttak_region_allocator_t {
     uint8_t *base;
     size_t len;
     ttak_region_block_t *head;
-    ttak_region_block_t *free_bins[16];
+    ttak_region_block_t *free_bins[TTAK_BIN_COUNT];
+    uint64_t bin_map[TTAK_BIN_WORDS];   /**< Bit i set when free_bins[i] is non-empty. */
+    uint8_t *fresh;                     /**< Bytes from here to the end were never handed out and read zero. */
     pthread_mutex_t lock;
 } ttak_region_allocator_t;
 
 #define TTAK_MIN_SPLIT_BLOCK 256
-#define TTAK_BIN_COUNT 16
 
+#if TTAK_LAZY_STATIC_REGIONS
+/* Reserved by region_init_once() on the first allocation. */
+#define TTAK_VMA_REGION_BASE NULL
+#define TTAK_LARGE_REGION_BASE NULL
+#else
 static _Alignas(64) uint8_t vma_region_buffer[TTAK_VMA_REGION_SIZE];
 static _Alignas(64) uint8_t large_region_buffer[TTAK_LARGE_REGION_SIZE];
+#define TTAK_VMA_REGION_BASE vma_region_buffer
+#define TTAK_LARGE_REGION_BASE large_region_buffer
+#endif
 
 static ttak_region_allocator_t vma_allocator = {
-    .base = vma_region_buffer,
-    .len = sizeof(vma_region_buffer),
+    .base = TTAK_VMA_REGION_BASE,
+    .len = TTAK_VMA_REGION_SIZE,
     .head = NULL,
     .free_bins = {0},
+    .bin_map = {0},
+    .fresh = NULL,
     .lock = PTHREAD_MUTEX_INITIALIZER,
 };
 
 static ttak_region_allocator_t large_allocator = {
-    .base = large_region_buffer,
-    .len = sizeof(large_region_buffer),
+    .base = TTAK_LARGE_REGION_BASE,
+    .len = TTAK_LARGE_REGION_SIZE,
     .head = NULL,
     .free_bins = {0},
+    .bin_map = {0},
+    .fresh = NULL,
     .lock = PTHREAD_MUTEX_INITIALIZER,
 };
 
+_Static_assert(TTAK_MEM_STATS_REGION_BINS == TTAK_BIN_COUNT, "region bin count mismatch");
+
+/**
+ * @brief Copies a region's free-list lengths and largest free block under its lock.
+ */
+static void region_stats(ttak_region_allocator_t *alloc, size_t *bins, ttak_mem_tier_stats_t *tier) {
+    pthread_mutex_lock(&alloc->lock);
+    for (int b = 0; b < TTAK_BIN_COUNT; ++b) {
+        size_t count = 0;
+        for (ttak_region_block_t *cur = alloc->free_bins[b]; cur; cur = cur->free_next) {
+            count++;
+            if (cur->size > tier->largest_free_block) tier->largest_free_block = cur->size;
+        }
+        bins[b] = count;
+        tier->free_blocks += count;
+    }
+    if (alloc->base) tier->reserved_bytes += alloc->len;
+    pthread_mutex_unlock(&alloc->lock);
+}
+
 ttak_mem_vma_region_t global_vma_region = {
-    .start_addr = vma_region_buffer,
-    .current_cursor = (uintptr_t)vma_region_buffer,
+    .start_addr = TTAK_VMA_REGION_BASE,
+    .current_cursor = (uintptr_t)TTAK_VMA_REGION_BASE,
 };
 
+/**
+ * @brief Maps a block size to its quarter-power size class in O(1).
+ */
 static int size_to_bin(size_t sz) {
-    size_t limit = 512;
-    for (int i = 0; i < TTAK_BIN_COUNT - 1; ++i) {
-        if (sz <= limit) return i;
-        limit <<= 1;
+    if (sz < ((size_t)1 << TTAK_BIN_MIN_SHIFT)) return 0;
+    int fl = 63 - ttak_arch_clz64((uint64_t)sz);
+    int sl = (int)((sz >> (fl - TTAK_BIN_SUB_SHIFT)) & (TTAK_BIN_SUB_COUNT - 1));
+    int bin = ((fl - TTAK_BIN_MIN_SHIFT) << TTAK_BIN_SUB_SHIFT) + sl;
+    return bin < TTAK_BIN_COUNT ? bin : TTAK_BIN_COUNT - 1;
+}
+
+/**
+ * @brief Returns the first non-empty bin at or above @p from, or -1.
+ */
+static int bin_map_next(const ttak_region_allocator_t *alloc, int from) {
+    for (int w = from >> 6; w < TTAK_BIN_WORDS; ++w) {
+        uint64_t bits = alloc->bin_map[w];
+        if (w == (from >> 6)) bits &= ~0ULL << (from & 63);
+        if (bits) return (w << 6) + ttak_arch_ctz64(bits);
     }
-    return TTAK_BIN_COUNT - 1;
+    return -1;
 }
 
 static inline size_t payload_offset(void) {
@@ -80,46 +143,69 @@ static inline size_t payload_offset(void) {
 
 static void free_bin_insert(ttak_region_allocator_t *alloc, ttak_region_block_t *blk) {
     int bin = size_to_bin(blk->size);
+    blk->free_prev = NULL;
     blk->free_next = alloc->free_bins[bin];
+    if (blk->free_next) blk->free_next->free_prev = blk;
     alloc->free_bins[bin] = blk;
+    alloc->bin_map[bin >> 6] |= 1ULL << (bin & 63);
 }
 
 static void free_bin_remove(ttak_region_allocator_t *alloc, ttak_region_block_t *blk) {
     int bin = size_to_bin(blk->size);
-    ttak_region_block_t *prev = NULL;
-    ttak_region_block_t *cur = alloc->free_bins[bin];
-    while (cur) {
-        if (cur == blk) {
-            if (prev) prev->free_next = cur->free_next;
-            else alloc->free_bins[bin] = cur->free_next;
-            blk->free_next = NULL;
-            return;
-        }
-        prev = cur;
-        cur = cur->free_next;
-    }
+    if (blk->free_prev) blk->free_prev->free_next = blk->free_next;
+    else alloc->free_bins[bin] = blk->free_next;
+    if (blk->free_next) blk->free_next->free_prev = blk->free_prev;
+    blk->free_prev = NULL;
+    blk->free_next = NULL;
+    if (!alloc->free_bins[bin]) alloc->bin_map[bin >> 6] &= ~(1ULL << (bin & 63));
 }
 
-static void region_init_once(ttak_region_allocator_t *alloc) {
-    if (alloc->head) return;
+/**
+ * @brief Lays out the region as one free block; reserves it first when lazy.
+ *
+ * @return false if the region cannot be reserved.
+ */
+static bool region_init_once(ttak_region_allocator_t *alloc) {
+    if (alloc->head) return true;
+#if TTAK_LAZY_STATIC_REGIONS
+    alloc->base = ttak_static_region_reserve(alloc->len);
+    if (!alloc->base) return false;
+    if (alloc == &vma_allocator) {
+        global_vma_region.start_addr = alloc->base;
+        global_vma_region.current_cursor = (uintptr_t)alloc->base;
+    }
+#endif
     ttak_region_block_t *head = (ttak_region_block_t *)alloc->base;
     head->size = alloc->len - payload_offset();
     head->prev = NULL;
     head->next = NULL;
+    head->free_prev = NULL;
     head->free_next = NULL;
     head->is_free = 1;
     alloc->head = head;
+    /* Static and freshly reserved regions both start out zeroed. */
+    alloc->fresh = alloc->base + payload_offset();
     free_bin_insert(alloc, head);
+    return true;
 }
 
+/**
+ * @brief Good-fit search over the size-class bitmap.
+ *
+ * Only the request's own class (and the open-ended top class) can hold
+ * blocks smaller than the request, so those are scanned; any block in a
+ * higher non-empty class fits by construction.
+ */
 static ttak_region_block_t *region_find_fit(ttak_region_allocator_t *alloc, size_t req_size) {
     int bin = size_to_bin(req_size);
-    for (int i = bin; i < TTAK_BIN_COUNT; ++i) {
-        ttak_region_block_t *cur = alloc->free_bins[i];
-        while (cur) {
-            if (cur->is_free && cur->size >= req_size) return cur;
-            cur = cur->free_next;
-        }
+    for (ttak_region_block_t *cur = alloc->free_bins[bin]; cur; cur = cur->free_next) {
+        if (cur->size >= req_size) return cur;
+    }
+    int next = (bin + 1 < TTAK_BIN_COUNT) ? bin_map_next(alloc, bin + 1) : -1;
+    if (next < 0) return NULL;
+    if (next < TTAK_BIN_COUNT - 1) return alloc->free_bins[next];
+    for (ttak_region_block_t *cur = alloc->free_bins[next]; cur; cur = cur->free_next) {
+        if (cur->size >= req_size) return cur;
     }
     return NULL;
 }
@@ -134,6 +220,7 @@ static void region_split_block(ttak_region_allocator_t *alloc, ttak_region_block
     new_blk->size = blk->size - req_size - payload_offset();
     new_blk->prev = blk;
     new_blk->next = blk->next;
+    new_blk->free_prev = NULL;
     new_blk->free_next = NULL;
     new_blk->is_free = 1;
     if (blk->next) blk->next->prev = new_blk;
@@ -163,6 +250,20 @@ static ttak_region_block_t *region_coalesce(ttak_region_allocator_t *alloc, ttak
     return blk;
 }
 
+/**
+ * @brief Moves the never-handed-out mark past @p blk and the block header its split wrote.
+ *
+ * Called under the region lock. Returns the old mark.
+ */
+static uint8_t *region_note_used(ttak_region_allocator_t *alloc, ttak_region_block_t *blk) {
+    uint8_t *old = alloc->fresh;
+    uint8_t *end = (uint8_t *)blk + 2 * payload_offset() + blk->size;
+    uint8_t *limit = alloc->base + alloc->len;
+    if (end > limit) end = limit;
+    if (end > alloc->fresh) alloc->fresh = end;
+    return old;
+}
+
 static ttak_mem_header_t *region_alloc(ttak_region_allocator_t *alloc, size_t user_requested_size) {
     if (user_requested_size == 0 || user_requested_size > SIZE_MAX - sizeof(ttak_mem_header_t)) return NULL;
 
@@ -171,9 +272,7 @@ static ttak_mem_header_t *region_alloc(ttak_region_allocator_t *alloc, size_t us
     size_t aligned_total_alloc_size = (total_alloc_size + TTAK_VMA_ALIGNMENT - 1) & ~((size_t)TTAK_VMA_ALIGNMENT - 1);
 
     pthread_mutex_lock(&alloc->lock);
-    region_init_once(alloc);
-
-    ttak_region_block_t *blk = region_find_fit(alloc, aligned_total_alloc_size);
+    ttak_region_block_t *blk = region_init_once(alloc) ? region_find_fit(alloc, aligned_total_alloc_size) : NULL;
     if (!blk) {
         pthread_mutex_unlock(&alloc->lock);
         return NULL;
@@ -182,11 +281,17 @@ static ttak_mem_header_t *region_alloc(ttak_region_allocator_t *alloc, size_t us
     free_bin_remove(alloc, blk);
     blk->is_free = 0;
     region_split_block(alloc, blk, aligned_total_alloc_size);
+    uint8_t *fresh = region_note_used(alloc, blk);
+
+    pthread_mutex_unlock(&alloc->lock);
 
+    /* The block is private once unlinked; clear it outside the region lock.
+     * Only the part below the old mark can hold stale bytes. */
     ttak_mem_header_t *header = (ttak_mem_header_t *)((uint8_t *)blk + payload_offset());
-    ttak_mem_stream_zero(header, aligned_total_alloc_size);
+    uint8_t *dirty_end = (uint8_t *)header + aligned_total_alloc_size;
+    if (dirty_end > fresh) dirty_end = fresh;
+    if (dirty_end > (uint8_t *)header) ttak_mem_stream_zero(header, (size_t)(dirty_end - (uint8_t *)header));
     pthread_mutex_init(&header->lock, NULL);
-    pthread_mutex_unlock(&alloc->lock);
     return header;
 }
 
@@ -203,23 +308,88 @@ static void region_free(ttak_region_allocator_t *alloc, ttak_mem_header_t *heade
     pthread_mutex_unlock(&alloc->lock);
 }
 
+/**
+ * @brief Extends a live block to @p new_total bytes by absorbing a free right neighbour.
+ *
+ * @return false if the neighbour is in use or too small; the block is untouched then.
+ */
+static bool region_grow(ttak_region_allocator_t *alloc, ttak_mem_header_t *header, size_t new_total) {
+    pthread_mutex_lock(&alloc->lock);
+    ttak_region_block_t *blk = (ttak_region_block_t *)((uint8_t *)header - payload_offset());
+    if (blk->size < new_total) {
+        ttak_region_block_t *right = blk->next;
+        if (!right || !right->is_free || blk->size + payload_offset() + right->size < new_total) {
+            pthread_mutex_unlock(&alloc->lock);
+            return false;
+        }
+        free_bin_remove(alloc, right);
+        blk->size += payload_offset() + right->size;
+        blk->next = right->next;
+        if (right->next) right->next->prev = blk;
+        region_split_block(alloc, blk, new_total);
+        (void)region_note_used(alloc, blk);
+    }
+    pthread_mutex_unlock(&alloc->lock);
+    return true;
+}
+
+/**
+ * @brief Returns the whole pages inside free blocks of @p alloc to the kernel.
+ *
+ * Block headers stay resident; the pages behind them read back as zeroes,
+ * which region_alloc() would have written anyway.
+ */
+static size_t region_trim(ttak_region_allocator_t *alloc) {
+    size_t released = 0;
+#if defined(__unix__) && defined(MADV_DONTNEED)
+    const uintptr_t page = TTAK_POCKET_PAGE_SIZE;
+    pthread_mutex_lock(&alloc->lock);
+    for (int b = 0; b < TTAK_BIN_COUNT; ++b) {
+        for (ttak_region_block_t *cur = alloc->free_bins[b]; cur; cur = cur->free_next) {
+            uintptr_t start = ((uintptr_t)cur + sizeof(*cur) + page - 1) & ~(page - 1);
+            uintptr_t end = ((uintptr_t)cur + payload_offset() + cur->size) & ~(page - 1);
+            if (end > start && madvise((void *)start, end - start, MADV_DONTNEED) == 0) {
+                released += end - start;
+            }
+        }
+    }
+    pthread_mutex_unlock(&alloc->lock);
+#else
+    (void)alloc;
+#endif
+    return released;
+}
+
+#else /* TTAK_OS_MANAGED_MEMORY */
+
+/* Bytes mapped for live VMA and large blocks, rounded to whole pages. */
+static _Atomic uint64_t vma_os_reserved = 0;
+static _Atomic uint64_t large_os_reserved = 0;
+
+static inline uint64_t os_mapping_bytes(size_t len) {
+    return ((uint64_t)len + TTAK_POCKET_PAGE_SIZE - 1) & ~((uint64_t)TTAK_POCKET_PAGE_SIZE - 1);
+}
+
 #endif /* !TTAK_OS_MANAGED_MEMORY */
 
 /* ------------------------------------------------------------------ */
 /*  Public tier entry points                                           */
 /* ------------------------------------------------------------------ */
 
-ttak_mem_header_t* ttak_mem_vma_alloc_internal(size_t user_requested_size) {
+ttak_mem_header_t* ttak_mem_vma_alloc_internal(size_t user_requested_size, ttak_mem_flags_t flags) {
 #if TTAK_OS_MANAGED_MEMORY
     size_t total = sizeof(ttak_mem_header_t) + user_requested_size;
     total = (total + TTAK_VMA_ALIGNMENT - 1) & ~((size_t)TTAK_VMA_ALIGNMENT - 1);
-    ttak_mem_header_t *header = (ttak_mem_header_t *)ttak_os_mem_alloc(total);
+    /* Fresh anonymous pages read zero; leaving them untouched keeps large
+     * blocks lazily faulted, and the node policy is set on the mapping. */
+    ttak_mem_header_t *header = (ttak_mem_header_t *)ttak_os_mem_alloc_hinted(total, flags);
     if (header) {
-        memset(header, 0, total);
         pthread_mutex_init(&header->lock, NULL);
+        atomic_fetch_add_explicit(&vma_os_reserved, os_mapping_bytes(total), memory_order_relaxed);
     }
     return header;
 #else
+    (void)flags;
     return region_alloc(&vma_allocator, user_requested_size);
 #endif
 }
@@ -228,23 +398,27 @@ void _vma_free_internal(ttak_mem_header_t* header) {
 #if TTAK_OS_MANAGED_MEMORY
     if (!header) return;
     pthread_mutex_destroy(&header->lock);
+    atomic_fetch_sub_explicit(&vma_os_reserved, os_mapping_bytes(header->mapped_size), memory_order_relaxed);
     ttak_os_mem_free(header, header->mapped_size);
 #else
     region_free(&vma_allocator, header);
 #endif
 }
 
-ttak_mem_header_t* ttak_mem_large_alloc_internal(size_t user_requested_size) {
+ttak_mem_header_t* ttak_mem_large_alloc_internal(size_t user_requested_size, ttak_mem_flags_t flags) {
 #if TTAK_OS_MANAGED_MEMORY
     size_t total = sizeof(ttak_mem_header_t) + user_requested_size;
     total = (total + TTAK_VMA_ALIGNMENT - 1) & ~((size_t)TTAK_VMA_ALIGNMENT - 1);
-    ttak_mem_header_t *header = (ttak_mem_header_t *)ttak_os_mem_alloc(total);
+    /* Fresh anonymous pages read zero; leaving them untouched keeps large
+     * blocks lazily faulted, and the node policy is set on the mapping. */
+    ttak_mem_header_t *header = (ttak_mem_header_t *)ttak_os_mem_alloc_hinted(total, flags);
     if (header) {
-        memset(header, 0, total);
         pthread_mutex_init(&header->lock, NULL);
+        atomic_fetch_add_explicit(&large_os_reserved, os_mapping_bytes(total), memory_order_relaxed);
     }
     return header;
 #else
+    (void)flags;
     return region_alloc(&large_allocator, user_requested_size);
 #endif
 }
@@ -253,8 +427,56 @@ void _large_free_internal(ttak_mem_header_t* header) {
 #if TTAK_OS_MANAGED_MEMORY
     if (!header) return;
     pthread_mutex_destroy(&header->lock);
+    atomic_fetch_sub_explicit(&large_os_reserved, os_mapping_bytes(header->mapped_size), memory_order_relaxed);
     ttak_os_mem_free(header, header->mapped_size);
 #else
     region_free(&large_allocator, header);
 #endif
 }
+
+ttak_mem_header_t *ttak_mem_vma_grow_internal(ttak_mem_header_t *header, size_t new_total) {
+    new_total = (new_total + TTAK_VMA_ALIGNMENT - 1) & ~((size_t)TTAK_VMA_ALIGNMENT - 1);
+    bool large = header->allocation_tier == TTAK_ALLOC_TIER_GENERAL;
+#if TTAK_OS_MANAGED_MEMORY
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+    uint64_t old_bytes = os_mapping_bytes(header->mapped_size);
+    uint64_t new_bytes = os_mapping_bytes(new_total);
+    if (new_bytes > old_bytes) {
+        /* The kernel moves the page tables, not the bytes, and extends with zero pages. */
+        void *moved = mremap(header, (size_t)old_bytes, (size_t)new_bytes, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) return NULL;
+        header = (ttak_mem_header_t *)moved;
+        atomic_fetch_add_explicit(large ? &large_os_reserved : &vma_os_reserved, new_bytes - old_bytes,
+                                  memory_order_relaxed);
+    }
+    return header;
+#else
+    (void)large;
+    return NULL;
+#endif
+#else
+    return region_grow(large ? &large_allocator : &vma_allocator, header, new_total) ? header : NULL;
+#endif
+}
+
+size_t ttak_mem_vma_trim(void) {
+#if TTAK_OS_MANAGED_MEMORY
+    /* Freed blocks are unmapped on the spot; nothing is held back. */
+    return 0;
+#else
+    return region_trim(&vma_allocator) + region_trim(&large_allocator);
+#endif
+}
+
+void ttak_mem_vma_stats(ttak_mem_stats_t *out) {
+    ttak_mem_tier_stats_t *vma = &out->tiers[TTAK_MEM_STATS_TIER_VMA];
+    ttak_mem_tier_stats_t *general = &out->tiers[TTAK_MEM_STATS_TIER_GENERAL];
+#if TTAK_OS_MANAGED_MEMORY
+    /* Each block is its own mapping, so nothing sits on a free list. */
+    vma->reserved_bytes += atomic_load_explicit(&vma_os_reserved, memory_order_relaxed);
+    general->reserved_bytes += atomic_load_explicit(&large_os_reserved, memory_order_relaxed);
+#else
+    region_stats(&vma_allocator, out->vma_free_blocks, vma);
+    region_stats(&large_allocator, out->general_free_blocks, general);
+#endif
+}
@@ -1,5 +1,6 @@
 #include <ttak/mem_tree/mem_tree.h>
 #include <ttak/mem/mem.h> // For ttak_mem_free
+#include <ttak/mem/epoch.h>
 #include <ttak/timing/timing.h> // For ttak_get_tick_count
 #include "../../internal/app_types.h" // For TT_SECOND, etc.
 #include <stdlib.h>
@@ -17,12 +18,462 @@
 // Forward declaration for the cleanup thread function
 static void *cleanup_thread_func(void *arg);
 
+#define TTAK_MEM_TREE_WHEEL_MASK ((uint64_t)TTAK_MEM_TREE_WHEEL_SLOTS - 1)
+#define TTAK_MEM_TREE_INDEX_MIN 64
+#if (TTAK_MEM_TREE_SHARDS & (TTAK_MEM_TREE_SHARDS - 1)) != 0
+#error "TTAK_MEM_TREE_SHARDS must be a power of two"
+#endif
+
+static void node_list_push(ttak_mem_node_list_t *list, ttak_mem_node_t *node) {
+    node->bucket = list;
+    node->next = NULL;
+    node->prev = list->tail;
+    if (list->tail) list->tail->next = node;
+    else list->head = node;
+    list->tail = node;
+    list->count++;
+}
+
+static void node_list_unlink(ttak_mem_node_t *node) {
+    ttak_mem_node_list_t *list = node->bucket;
+    if (!list) return;
+    if (node->prev) node->prev->next = node->next;
+    else list->head = node->next;
+    if (node->next) node->next->prev = node->prev;
+    else list->tail = node->prev;
+    list->count--;
+    node->next = NULL;
+    node->prev = NULL;
+    node->bucket = NULL;
+}
+
+/* Index keys: 0 marks a never-used slot, 1 a removed one. Neither is a valid block address. */
+#define INDEX_EMPTY ((uintptr_t)0)
+#define INDEX_TOMB ((uintptr_t)1)
+
+/**
+ * @brief One pointer-index slot. The node is stored before the key is
+ * published, so a reader that sees the key also sees its node.
+ */
+typedef struct ttak_mem_index_slot {
+    _Atomic uintptr_t key;
+    ttak_mem_node_t *_Atomic node;
+} ttak_mem_index_slot_t;
+
+/**
+ * @brief Open-addressed pointer index with linear probing.
+ *
+ * Writers modify it under the shard lock. Readers probe it inside an epoch
+ * critical section without any lock, and a table replaced by a rebuild is
+ * retired through the epoch so a reader never probes freed slots.
+ */
+struct ttak_mem_tree_index {
+    struct ttak_mem_tree_index *stale_next; /**< Link while waiting to be retired. */
+    size_t mask;                            /**< Capacity minus one. */
+    size_t used;                            /**< Live keys plus tombstones; writer-only. */
+    ttak_mem_index_slot_t slots[];
+};
+
+/**
+ * @brief Slot hash. Mixes differently from tree_shard() so the keys of one
+ * shard, which share their shard bits, still spread over the whole table.
+ */
+static inline size_t index_hash(const void *ptr) {
+    uint64_t h = (uint64_t)(uintptr_t)ptr >> 4;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return (size_t)h;
+}
+
+/**
+ * @brief Maps a block address to its shard.
+ *
+ * Same hash as the pointer registry in mem.c: the 64-byte alignment bits
+ * are dropped and the rest Fibonacci-hashed, so with equal shard counts a
+ * root lands in the tree shard matching the registry shard already locked.
+ */
+static inline ttak_mem_tree_shard_t *tree_shard(ttak_mem_tree_t *tree, const void *ptr) {
+    uint64_t mixed = ((uint64_t)(uintptr_t)ptr >> 6) * UINT64_C(0x9E3779B97F4A7C15);
+    return &tree->shards[(mixed >> 32) & (TTAK_MEM_TREE_SHARDS - 1)];
+}
+
+/**
+ * @brief Visits every expiry bucket; used by destroy.
+ */
+static ttak_mem_node_list_t *tree_bucket_at(ttak_mem_tree_t *tree, size_t i) {
+    if (i < TTAK_MEM_TREE_WHEEL_SLOTS) return &tree->wheel[i];
+    switch (i - TTAK_MEM_TREE_WHEEL_SLOTS) {
+        case 0: return &tree->overflow;
+        case 1: return &tree->forever;
+        case 2: return &tree->due;
+        default: return NULL;
+    }
+}
+
+/**
+ * @brief Lock-free probe. Caller is pinned by the epoch or holds the shard lock.
+ */
+static ttak_mem_node_t *index_lookup(const struct ttak_mem_tree_index *idx, const void *ptr) {
+    uintptr_t want = (uintptr_t)ptr;
+retry:
+    for (size_t i = index_hash(ptr), n = 0; n <= idx->mask; ++i, ++n) {
+        const ttak_mem_index_slot_t *slot = &idx->slots[i & idx->mask];
+        uintptr_t key = atomic_load_explicit(&slot->key, memory_order_acquire);
+        if (key == INDEX_EMPTY) return NULL;
+        if (key != want) continue;
+        ttak_mem_node_t *node = atomic_load_explicit(&slot->node, memory_order_acquire);
+        /* The slot may have been emptied and reused between the two loads. */
+        if (atomic_load_explicit(&slot->key, memory_order_acquire) != want) goto retry;
+        return node;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Stores @p node in the first free or removed slot. Caller holds the shard lock.
+ */
+static void index_place(struct ttak_mem_tree_index *idx, ttak_mem_node_t *node) {
+    for (size_t i = index_hash(node->ptr);; ++i) {
+        ttak_mem_index_slot_t *slot = &idx->slots[i & idx->mask];
+        uintptr_t key = atomic_load_explicit(&slot->key, memory_order_relaxed);
+        if (key != INDEX_EMPTY && key != INDEX_TOMB) continue;
+        if (key == INDEX_EMPTY) idx->used++;
+        atomic_store_explicit(&slot->node, node, memory_order_relaxed);
+        atomic_store_explicit(&slot->key, (uintptr_t)node->ptr, memory_order_release);
+        return;
+    }
+}
+
+/**
+ * @brief Replaces the shard's pointer index with a fresh table holding its live keys.
+ *
+ * Caller holds the shard lock. The old table is queued on @c index_stale
+ * and must be handed to index_retire_stale() once the lock is dropped,
+ * because an epoch reclaim may run cleanups that free tracked blocks.
+ *
+ * @return false if the table could not be allocated (the old one is kept).
+ */
+static _Bool index_rebuild(ttak_mem_tree_shard_t *shard, size_t new_cap) {
+    struct ttak_mem_tree_index *fresh =
+        calloc(1, sizeof(*fresh) + new_cap * sizeof(ttak_mem_index_slot_t));
+    if (!fresh) return false;
+    fresh->mask = new_cap - 1;
+    struct ttak_mem_tree_index *old = atomic_load_explicit(&shard->index, memory_order_relaxed);
+    for (size_t i = 0; old && i <= old->mask; ++i) {
+        uintptr_t key = atomic_load_explicit(&old->slots[i].key, memory_order_relaxed);
+        if (key == INDEX_EMPTY || key == INDEX_TOMB) continue;
+        index_place(fresh, atomic_load_explicit(&old->slots[i].node, memory_order_relaxed));
+    }
+    atomic_store_explicit(&shard->index, fresh, memory_order_release);
+    if (old) {
+        old->stale_next = shard->index_stale;
+        shard->index_stale = old;
+    }
+    return true;
+}
+
+/**
+ * @brief Detaches the tables replaced by rebuilds. Caller holds the shard lock.
+ */
+static struct ttak_mem_tree_index *index_take_stale(ttak_mem_tree_shard_t *shard) {
+    struct ttak_mem_tree_index *stale = shard->index_stale;
+    shard->index_stale = NULL;
+    return stale;
+}
+
+/**
+ * @brief Retires tables from index_take_stale(); called without the shard lock.
+ */
+static void index_retire_stale(struct ttak_mem_tree_index *stale) {
+    while (stale) {
+        struct ttak_mem_tree_index *next = stale->stale_next;
+        ttak_epoch_retire(stale, free);
+        stale = next;
+    }
+}
+
+/**
+ * @brief Indexes a node in its shard. Caller holds the shard lock.
+ *
+ * Once live keys and tombstones pass 75% of the table it is rebuilt:
+ * doubled when the live keys alone fill half of it, otherwise at the same
+ * size to sweep the tombstones out.
+ *
+ * @return false if the node could not be indexed because the table is full
+ *         and no larger one could be allocated; node_count is left untouched.
+ */
+static _Bool index_insert(ttak_mem_tree_shard_t *shard, ttak_mem_node_t *node) {
+    struct ttak_mem_tree_index *idx = atomic_load_explicit(&shard->index, memory_order_relaxed);
+    size_t count = shard->node_count + 1;
+    size_t cap = idx ? idx->mask + 1 : 0;
+    size_t used = idx ? idx->used : 0;
+    if (used + 1 > cap - cap / 4) {
+        size_t new_cap = cap ? (count > cap / 2 ? cap * 2 : cap) : TTAK_MEM_TREE_INDEX_MIN;
+        while (count > new_cap / 2) new_cap *= 2;
+        if (index_rebuild(shard, new_cap)) {
+            idx = atomic_load_explicit(&shard->index, memory_order_relaxed);
+        } else if (!idx || used + 1 > idx->mask) {
+            /* Full: a node lookups would miss must not be tracked at all. */
+            return false;
+        }
+    }
+    index_place(idx, node);
+    shard->node_count = count;
+    return true;
+}
+
+static void index_remove(ttak_mem_tree_shard_t *shard, ttak_mem_node_t *node) {
+    shard->node_count--;
+    struct ttak_mem_tree_index *idx = atomic_load_explicit(&shard->index, memory_order_relaxed);
+    if (!idx) return;
+    for (size_t i = index_hash(node->ptr), n = 0; n <= idx->mask; ++i, ++n) {
+        ttak_mem_index_slot_t *slot = &idx->slots[i & idx->mask];
+        uintptr_t key = atomic_load_explicit(&slot->key, memory_order_relaxed);
+        if (key == INDEX_EMPTY) return;
+        if (key == (uintptr_t)node->ptr && atomic_load_explicit(&slot->node, memory_order_relaxed) == node) {
+            atomic_store_explicit(&slot->key, INDEX_TOMB, memory_order_release);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Lookup for writers. Caller holds the shard lock.
+ */
+static ttak_mem_node_t *index_find(ttak_mem_tree_shard_t *shard, const void *ptr) {
+    struct ttak_mem_tree_index *idx = atomic_load_explicit(&shard->index, memory_order_relaxed);
+    return idx ? index_lookup(idx, ptr) : NULL;
+}
+
+/**
+ * @brief Files a node into the bucket matching its expiry. Caller holds tree->lock.
+ */
+static void tree_file_node(ttak_mem_tree_t *tree, ttak_mem_node_t *node) {
+    if (node->expires_tick == __TTAK_UNSAFE_MEM_FOREVER__) {
+        node_list_push(&tree->forever, node);
+        return;
+    }
+    uint64_t slot = node->expires_tick >> TTAK_MEM_TREE_WHEEL_SHIFT;
+    if (slot < tree->wheel_cursor) {
+        node_list_push(&tree->due, node);
+    } else if (slot - tree->wheel_cursor < TTAK_MEM_TREE_WHEEL_SLOTS) {
+        node_list_push(&tree->wheel[slot & TTAK_MEM_TREE_WHEEL_MASK], node);
+    } else {
+        node_list_push(&tree->overflow, node);
+    }
+}
+
+/**
+ * @brief Indexes a node and queues it on the shard inbox. Caller holds the shard lock.
+ *
+ * @return false if the node could not be indexed; it is not tracked.
+ */
+static _Bool shard_track_node(ttak_mem_tree_shard_t *shard, ttak_mem_node_t *node) {
+    if (!index_insert(shard, node)) return false;
+    node_list_push(&shard->inbox, node);
+    return true;
+}
+
+/**
+ * @brief Stops tracking a node. Caller holds the shard lock.
+ *
+ * A node still on the inbox is unlinked at once. A filed node sits in an
+ * expiry bucket guarded by the tree lock, so it is only marked and queued
+ * for the next drain.
+ *
+ * @return true if the node's storage can be recycled now.
+ */
+static _Bool shard_untrack_node(ttak_mem_tree_shard_t *shard, ttak_mem_node_t *node) {
+    index_remove(shard, node);
+    if (!node->filed) {
+        node_list_unlink(node);
+        return true;
+    }
+    node->detached = true;
+    node->hnext = shard->detached;
+    shard->detached = node;
+    return false;
+}
+
+/**
+ * @brief Launches the background cleanup thread on first use.
+ *
+ * Caller holds tree->lock. A tree that never tracks a node in automatic
+ * mode never owns a thread. Marks the tree settled unless the launch
+ * failed, so adds stop taking the tree lock to get here.
+ */
+static void tree_start_cleanup_locked(ttak_mem_tree_t *tree) {
+    if (tree->cleanup_thread || atomic_load(&tree->use_manual_cleanup) ||
+        atomic_load(&tree->shutdown_requested)) {
+        atomic_store(&tree->cleanup_settled, true);
+        return;
+    }
+    if (pthread_create(&tree->cleanup_thread, NULL, cleanup_thread_func, tree) != 0) {
+        tree->cleanup_thread = 0;
+        fprintf(stderr, "[TTAK_MEM_TREE] Failed to create cleanup thread.\n");
+        return;
+    }
+    atomic_store(&tree->cleanup_settled, true);
+}
+
+/**
+ * @brief Starts the cleanup thread from an add; takes tree->lock only until settled.
+ */
+static void tree_start_cleanup(ttak_mem_tree_t *tree) {
+    if (atomic_load(&tree->cleanup_settled)) return;
+    pthread_mutex_lock(&tree->lock);
+    tree_start_cleanup_locked(tree);
+    pthread_mutex_unlock(&tree->lock);
+}
+
+/**
+ * @brief Chunk of node storage; nodes follow the header in the same allocation.
+ */
+typedef struct ttak_mem_node_slab {
+    struct ttak_mem_node_slab *next;
+    ttak_mem_node_t nodes[TTAK_MEM_TREE_SLAB_NODES];
+} ttak_mem_node_slab_t;
+
+/**
+ * @brief Pops a node from the tree's slab free list, growing it by one slab when empty.
+ *
+ * The free list is linked through @c hnext.
+ */
+static ttak_mem_node_t *node_slab_alloc(ttak_mem_tree_t *tree) {
+    ttak_spin_lock(&tree->slab_lock);
+    ttak_mem_node_t *node = tree->node_free;
+    if (node) {
+        tree->node_free = node->hnext;
+        ttak_spin_unlock(&tree->slab_lock);
+        return node;
+    }
+    ttak_spin_unlock(&tree->slab_lock);
+
+    ttak_mem_node_slab_t *slab = (ttak_mem_node_slab_t *)malloc(sizeof(ttak_mem_node_slab_t));
+    if (!slab) return NULL;
+    for (size_t i = 1; i + 1 < TTAK_MEM_TREE_SLAB_NODES; ++i) {
+        slab->nodes[i].hnext = &slab->nodes[i + 1];
+    }
+
+    ttak_spin_lock(&tree->slab_lock);
+    slab->next = tree->slabs;
+    tree->slabs = slab;
+    tree->slab_count++;
+    slab->nodes[TTAK_MEM_TREE_SLAB_NODES - 1].hnext = tree->node_free;
+    tree->node_free = &slab->nodes[1];
+    ttak_spin_unlock(&tree->slab_lock);
+    return &slab->nodes[0];
+}
+
+/**
+ * @brief Returns a chain of nodes linked through @c next to the slab free list.
+ */
+static void node_slab_free_chain(ttak_mem_tree_t *tree, ttak_mem_node_t *chain) {
+    if (!chain) return;
+    ttak_mem_node_t *tail = chain;
+    for (;;) {
+        tail->hnext = tail->next;
+        if (!tail->next) break;
+        tail = tail->next;
+    }
+    ttak_spin_lock(&tree->slab_lock);
+    tail->hnext = tree->node_free;
+    tree->node_free = chain;
+    ttak_spin_unlock(&tree->slab_lock);
+}
+
+static void node_slab_free(ttak_mem_tree_t *tree, ttak_mem_node_t *node) {
+    node->next = NULL;
+    node_slab_free_chain(tree, node);
+}
+
+static ttak_mem_node_t *node_create(ttak_mem_tree_t *tree, void *ptr, size_t size, uint64_t expires_tick, _Bool is_root) {
+    ttak_mem_node_t *node = node_slab_alloc(tree);
+    if (!node) {
+        fprintf(stderr, "[TTAK_MEM_TREE] Failed to allocate mem node.\n");
+        return NULL;
+    }
+    node->ptr = ptr;
+    node->size = size;
+    node->expires_tick = expires_tick;
+    atomic_init(&node->ref_count, 1); // Initial ref count is 1
+    node->is_root = is_root;
+    node->tree = tree;
+    node->next = NULL;
+    node->prev = NULL;
+    node->hnext = NULL;
+    node->bucket = NULL;
+    node->filed = false;
+    node->detached = false;
+    return node;
+}
+
+/**
+ * @brief Files every shard's new nodes into the expiry buckets and recycles
+ * the nodes removed since the last drain. Caller holds tree->lock.
+ */
+static void tree_drain_locked(ttak_mem_tree_t *tree) {
+    ttak_mem_node_t *recycled = NULL;
+    for (size_t s = 0; s < TTAK_MEM_TREE_SHARDS; ++s) {
+        ttak_mem_tree_shard_t *shard = &tree->shards[s];
+        pthread_mutex_lock(&shard->lock);
+        while (shard->inbox.head) {
+            ttak_mem_node_t *node = shard->inbox.head;
+            node_list_unlink(node);
+            node->filed = true;
+            tree_file_node(tree, node);
+        }
+        ttak_mem_node_t *node = shard->detached;
+        shard->detached = NULL;
+        pthread_mutex_unlock(&shard->lock);
+
+        /* Detached nodes are final; only the tree lock guards their buckets. */
+        while (node) {
+            ttak_mem_node_t *next = node->hnext;
+            node_list_unlink(node);
+            node->next = recycled;
+            recycled = node;
+            node = next;
+        }
+    }
+    node_slab_free_chain(tree, recycled);
+}
+
+/**
+ * @brief Takes a filed node out of its shard so a sweep can free it. Caller holds tree->lock.
+ *
+ * @return false if the node was removed concurrently; the next drain recycles it.
+ */
+static _Bool tree_claim_filed(ttak_mem_tree_t *tree, ttak_mem_node_t *node) {
+    ttak_mem_tree_shard_t *shard = tree_shard(tree, node->ptr);
+    pthread_mutex_lock(&shard->lock);
+    _Bool live = !node->detached;
+    if (live) index_remove(shard, node);
+    pthread_mutex_unlock(&shard->lock);
+    return live;
+}
+
+/**
+ * @brief Sums the shard counts. May be called with or without tree->lock.
+ */
+static size_t tree_node_count(ttak_mem_tree_t *tree) {
+    size_t total = 0;
+    for (size_t s = 0; s < TTAK_MEM_TREE_SHARDS; ++s) {
+        pthread_mutex_lock(&tree->shards[s].lock);
+        total += tree->shards[s].node_count;
+        pthread_mutex_unlock(&tree->shards[s].lock);
+    }
+    return total;
+}
+
 /**
  * @brief Initializes a new mem tree instance.
  *
  * This function sets up the initial state of the mem tree, including its mutex,
- * default cleanup interval, and manual cleanup flag. It also launches a background
- * thread responsible for automatic memory cleanup.
+ * default cleanup interval, and manual cleanup flag. The background thread
+ * responsible for automatic memory cleanup is launched by the first add, so
+ * an unused tree costs no thread.
  *
  * @param tree Pointer to the ttak_mem_tree_t structure to initialize.
  */
@@ -32,6 +483,10 @@ void ttak_mem_tree_init(ttak_mem_tree_t *tree) {
     memset(tree, 0, sizeof(ttak_mem_tree_t));
     pthread_mutex_init(&tree->lock, NULL);
     pthread_cond_init(&tree->cond, NULL);
+    ttak_spin_init(&tree->slab_lock);
+    for (size_t s = 0; s < TTAK_MEM_TREE_SHARDS; ++s) {
+        pthread_mutex_init(&tree->shards[s].lock, NULL);
+    }
     atomic_store(&tree->min_cleanup_interval_ns, TT_MILLI_SECOND(500)); // Default min 500ms
     atomic_store(&tree->max_cleanup_interval_ns, TT_SECOND(10)); // Default max 10s
     atomic_store(&tree->garbage_pressure, 0);
@@ -40,11 +495,7 @@ void ttak_mem_tree_init(ttak_mem_tree_t *tree) {
     atomic_store(&tree->shutdown_requested, false);
     atomic_store(&tree->pending_hints, 0);
     atomic_store(&tree->cleanup_needed, false);
-
-    // Launch the background cleanup thread
-    if (pthread_create(&tree->cleanup_thread, NULL, cleanup_thread_func, tree) != 0) {
-        fprintf(stderr, "[TTAK_MEM_TREE] Failed to create cleanup thread.\n");
-    }
+    tree->overflow_rescan = TTAK_MEM_TREE_WHEEL_SLOTS;
 }
 
 /**
@@ -70,20 +521,52 @@ void ttak_mem_tree_destroy(ttak_mem_tree_t *tree) {
     }
 
     pthread_mutex_lock(&tree->lock);
-    ttak_mem_node_t *to_free_list = tree->head;
-    tree->head = NULL;
+    tree_drain_locked(tree);
+    ttak_mem_node_t *to_free_list = NULL;
+    ttak_mem_node_list_t *list;
+    for (size_t i = 0; (list = tree_bucket_at(tree, i)) != NULL; ++i) {
+        while (list->head) {
+            ttak_mem_node_t *node = list->head;
+            node_list_unlink(node);
+            node->next = to_free_list;
+            to_free_list = node;
+        }
+    }
+    /* No reader can be probing once the tree is being destroyed. */
+    for (size_t s = 0; s < TTAK_MEM_TREE_SHARDS; ++s) {
+        ttak_mem_tree_shard_t *shard = &tree->shards[s];
+        struct ttak_mem_tree_index *stale = index_take_stale(shard);
+        while (stale) {
+            struct ttak_mem_tree_index *next = stale->stale_next;
+            free(stale);
+            stale = next;
+        }
+        free(atomic_exchange_explicit(&shard->index, NULL, memory_order_relaxed));
+        shard->node_count = 0;
+    }
     pthread_mutex_unlock(&tree->lock);
 
     ttak_mem_node_t *current = to_free_list;
     while (current) {
-        ttak_mem_node_t *next = current->next;
         // Free the actual memory block if it hasn't been freed already
         if (current->ptr) {
             ttak_mem_free(current->ptr);
         }
-        pthread_mutex_destroy(&current->lock);
-        free(current); // Free the mem node itself
-        current = next;
+        current = current->next;
+    }
+
+    // Release the slabs backing every node, tracked or not.
+    ttak_mem_node_slab_t *slab = tree->slabs;
+    while (slab) {
+        ttak_mem_node_slab_t *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    tree->slabs = NULL;
+    tree->node_free = NULL;
+    tree->slab_count = 0;
+    for (size_t s = 0; s < TTAK_MEM_TREE_SHARDS; ++s) {
+        pthread_mutex_destroy(&tree->shards[s].lock);
     }
     pthread_cond_destroy(&tree->cond);
     pthread_mutex_destroy(&tree->lock);
@@ -93,8 +576,9 @@ void ttak_mem_tree_destroy(ttak_mem_tree_t *tree) {
  * @brief Adds a new memory block to be tracked by the mem tree.
  *
  * A new mem node is created to encapsulate the provided memory block's metadata.
- * This node is then added to the mem tree's internal list. The initial reference
- * count is set to 1.
+ * It is indexed and queued under the lock of the shard @p ptr hashes to; the
+ * tree lock is not taken, and the next sweep files the node by expiry. The
+ * initial reference count is set to 1.
  *
  * @param tree Pointer to the mem tree.
  * @param ptr Pointer to the allocated memory block.
@@ -106,38 +590,84 @@ void ttak_mem_tree_destroy(ttak_mem_tree_t *tree) {
 ttak_mem_node_t *ttak_mem_tree_add(ttak_mem_tree_t *tree, void *ptr, size_t size, uint64_t expires_tick, _Bool is_root) {
     if (!tree || !ptr) return NULL;
 
-    ttak_mem_node_t *new_node = (ttak_mem_node_t *)malloc(sizeof(ttak_mem_node_t));
-    if (!new_node) {
-        fprintf(stderr, "[TTAK_MEM_TREE] Failed to allocate mem node.\n");
+    ttak_mem_node_t *new_node = node_create(tree, ptr, size, expires_tick, is_root);
+    if (!new_node) return NULL;
+
+    ttak_mem_tree_shard_t *shard = tree_shard(tree, ptr);
+    pthread_mutex_lock(&shard->lock);
+    _Bool tracked = shard_track_node(shard, new_node);
+    struct ttak_mem_tree_index *stale = index_take_stale(shard);
+    pthread_mutex_unlock(&shard->lock);
+    index_retire_stale(stale);
+
+    if (!tracked) {
+        fprintf(stderr, "[TTAK_MEM_TREE] Failed to grow the pointer index.\n");
+        node_slab_free(tree, new_node);
         return NULL;
     }
+    tree_start_cleanup(tree);
+    return new_node;
+}
 
-    new_node->ptr = ptr;
-    new_node->size = size;
-    new_node->expires_tick = expires_tick;
-    atomic_init(&new_node->ref_count, 1); // Initial ref count is 1
-    new_node->is_root = is_root;
-    new_node->tree = tree;
-    pthread_mutex_init(&new_node->lock, NULL);
+/**
+ * @brief Adds a batch of same-sized blocks.
+ *
+ * The nodes are built before any lock is taken, so the shard locks are
+ * only held for the index insert and the inbox push of each node.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param ptrs Array of allocated memory blocks.
+ * @param count Number of entries in @p ptrs.
+ * @param size Size of each memory block.
+ * @param expires_tick Monotonic tick when the blocks should expire.
+ * @param is_root True if the blocks are root nodes.
+ * @return Number of nodes added; stops early if node allocation fails, and
+ *         skips blocks the pointer index has no room for.
+ */
+size_t ttak_mem_tree_add_bulk(ttak_mem_tree_t *tree, void *const *ptrs, size_t count, size_t size, uint64_t expires_tick, _Bool is_root) {
+    if (!tree || !ptrs || count == 0) return 0;
 
-    pthread_mutex_lock(&tree->lock);
-    new_node->next = tree->head;
-    new_node->prev = NULL;
-    if (tree->head) {
-        tree->head->prev = new_node;
+    ttak_mem_node_t *chain = NULL;
+    size_t added = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!ptrs[i]) continue;
+        ttak_mem_node_t *node = node_create(tree, ptrs[i], size, expires_tick, is_root);
+        if (!node) break;
+        node->next = chain;
+        chain = node;
+        added++;
     }
-    tree->head = new_node;
-    pthread_mutex_unlock(&tree->lock);
+    if (!chain) return 0;
 
-    return new_node;
+    ttak_mem_node_t *rejected = NULL;
+    while (chain) {
+        ttak_mem_node_t *next = chain->next;
+        ttak_mem_tree_shard_t *shard = tree_shard(tree, chain->ptr);
+        pthread_mutex_lock(&shard->lock);
+        _Bool tracked = shard_track_node(shard, chain);
+        struct ttak_mem_tree_index *stale = index_take_stale(shard);
+        pthread_mutex_unlock(&shard->lock);
+        index_retire_stale(stale);
+        if (!tracked) {
+            chain->next = rejected;
+            rejected = chain;
+            added--;
+        }
+        chain = next;
+    }
+
+    node_slab_free_chain(tree, rejected);
+    if (added) tree_start_cleanup(tree);
+    return added;
 }
 
 /**
  * @brief Removes a memory block from the mem tree.
  *
- * This function unlinks the node from the tree's bookkeeping list, but it does
- * not release the underlying allocation. Callers are responsible for freeing
- * the tracked pointer once it has been detached from the tree.
+ * This function drops the node from its shard, but it does not release the
+ * underlying allocation. Callers are responsible for freeing the tracked
+ * pointer once it has been detached from the tree. A node the last sweep
+ * already filed by expiry is recycled by the next one instead of here.
  *
  * @param tree Pointer to the mem tree.
  * @param node Pointer to the mem node to remove.
@@ -145,22 +675,51 @@ ttak_mem_node_t *ttak_mem_tree_add(ttak_mem_tree_t *tree, void *ptr, size_t size
 void ttak_mem_tree_remove(ttak_mem_tree_t *tree, ttak_mem_node_t *node) {
     if (!tree || !node) return;
 
-    pthread_mutex_lock(&tree->lock);
-    
-    if (node->prev) {
-        node->prev->next = node->next;
-    } else if (tree->head == node) {
-        tree->head = node->next;
-    }
+    ttak_mem_tree_shard_t *shard = tree_shard(tree, node->ptr);
+    pthread_mutex_lock(&shard->lock);
+    _Bool recycle = shard_untrack_node(shard, node);
+    pthread_mutex_unlock(&shard->lock);
+
+    if (recycle) node_slab_free(tree, node); // Return the mem node to the slab
+}
+
+/**
+ * @brief Detaches the nodes tracking a batch of pointers in one step.
+ *
+ * Every lookup goes through the shard's pointer index under that shard's
+ * lock; the nodes that can be recycled at once are returned in one step.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param ptrs Pointers to detach.
+ * @param count Number of entries in @p ptrs.
+ */
+void ttak_mem_tree_remove_bulk(ttak_mem_tree_t *tree, void *const *ptrs, size_t count) {
+    if (!tree || !ptrs || count == 0) return;
 
-    if (node->next) {
-        node->next->prev = node->prev;
+    ttak_mem_node_t *detached = NULL;
+    for (size_t i = 0; i < count; ++i) {
+        if (!ptrs[i]) continue;
+        ttak_mem_tree_shard_t *shard = tree_shard(tree, ptrs[i]);
+        pthread_mutex_lock(&shard->lock);
+        ttak_mem_node_t *node = index_find(shard, ptrs[i]);
+        if (node && shard_untrack_node(shard, node)) {
+            node->next = detached;
+            detached = node;
+        }
+        pthread_mutex_unlock(&shard->lock);
     }
 
-    pthread_mutex_unlock(&tree->lock);
+    node_slab_free_chain(tree, detached);
+}
 
-    pthread_mutex_destroy(&node->lock);
-    free(node); // Free the mem node itself
+/**
+ * @brief Returns the number of blocks the tree tracks.
+ *
+ * @param tree Pointer to the mem tree.
+ * @return Sum of the shard counts, each read under its shard lock.
+ */
+size_t ttak_mem_tree_node_count(ttak_mem_tree_t *tree) {
+    return tree ? tree_node_count(tree) : 0;
 }
 
 /**
@@ -259,115 +818,177 @@ void ttak_mem_tree_set_manual_cleanup(ttak_mem_tree_t *tree, _Bool manual_cleanu
 
     if (manual_cleanup_enabled) {
         // Transition to manual: stop the auto-cleanup thread.
-        if (tree->cleanup_thread) {
+        pthread_mutex_lock(&tree->lock);
+        pthread_t th = tree->cleanup_thread;
+        tree->cleanup_thread = 0;
+        if (th) {
             atomic_store(&tree->shutdown_requested, true);
-            pthread_mutex_lock(&tree->lock);
             pthread_cond_signal(&tree->cond);
-            pthread_mutex_unlock(&tree->lock);
-            pthread_join(tree->cleanup_thread, NULL);
-            tree->cleanup_thread = 0;
+        }
+        pthread_mutex_unlock(&tree->lock);
+        if (th) {
+            pthread_join(th, NULL);
             atomic_store(&tree->shutdown_requested, false);
         }
     } else {
-        // Transition to auto: start the auto-cleanup thread if not already running.
-        if (!tree->cleanup_thread) {
-            atomic_store(&tree->shutdown_requested, false);
-            if (pthread_create(&tree->cleanup_thread, NULL, cleanup_thread_func, tree) != 0) {
-                fprintf(stderr, "[TTAK_MEM_TREE] Failed to create cleanup thread.\n");
-            } else {
-                pthread_mutex_lock(&tree->lock);
-                pthread_cond_signal(&tree->cond);
-                pthread_mutex_unlock(&tree->lock);
-            }
+        // Transition to auto: start the auto-cleanup thread if nodes are already tracked.
+        pthread_mutex_lock(&tree->lock);
+        atomic_store(&tree->cleanup_settled, false);
+        if (tree_node_count(tree)) tree_start_cleanup_locked(tree);
+        pthread_cond_signal(&tree->cond);
+        pthread_mutex_unlock(&tree->lock);
+    }
+}
+
+/**
+ * @brief Moves the contents of elapsed wheel slots onto the due list.
+ *
+ * Caller holds tree->lock. Moves at most @p limit nodes; empty slots are
+ * skipped without charge, and once a whole rotation has been visited the
+ * cursor jumps straight past @p now_slot because the wheel is empty.
+ *
+ * @return Number of nodes moved.
+ */
+static size_t tree_advance_wheel(ttak_mem_tree_t *tree, uint64_t now_slot, size_t limit) {
+    size_t moved = 0;
+    size_t steps = 0;
+    while (tree->wheel_cursor <= now_slot && moved < limit) {
+        ttak_mem_node_list_t *slot = &tree->wheel[tree->wheel_cursor & TTAK_MEM_TREE_WHEEL_MASK];
+        if (slot->head) {
+            ttak_mem_node_t *node = slot->head;
+            node_list_unlink(node);
+            node_list_push(&tree->due, node);
+            moved++;
+            continue;
+        }
+        tree->wheel_cursor++;
+        if (++steps >= TTAK_MEM_TREE_WHEEL_SLOTS && tree->wheel_cursor <= now_slot) {
+            tree->wheel_cursor = now_slot + 1;
+        }
+    }
+
+    if (tree->wheel_cursor >= tree->overflow_rescan) {
+        /* Re-file far-future nodes now that the horizon has moved; each node
+         * is visited once per rotation at most. */
+        ttak_mem_node_t *node = tree->overflow.head;
+        size_t pending = tree->overflow.count;
+        while (node && pending-- > 0) {
+            ttak_mem_node_t *next = node->next;
+            node_list_unlink(node);
+            tree_file_node(tree, node);
+            node = next;
         }
+        tree->overflow_rescan = tree->wheel_cursor + TTAK_MEM_TREE_WHEEL_SLOTS;
     }
+    return moved;
 }
 
 /**
- * @brief Performs a manual cleanup pass, freeing expired and unreferenced memory blocks.
+ * @brief Performs a bounded, incremental cleanup pass.
  *
- * This function first checks whether any cleanup work is known to be pending. If
- * garbage_pressure is zero and cleanup_needed is false, it returns immediately
- * without walking the tree. Otherwise it iterates through the tracked mem nodes
- * and frees those whose reference count is zero and whose expiration time has passed.
+ * Each chunk holds the tree lock for at most TTAK_MEM_TREE_SWEEP_CHUNK
+ * nodes: elapsed wheel slots are moved onto the due list, then due nodes
+ * are checked and the expired, unreferenced ones detached. Surviving due
+ * nodes rotate to the tail so a budgeted pass always makes progress. The
+ * detached blocks are freed after the lock is dropped.
  *
  * @param tree Pointer to the mem tree.
  * @param now Current monotonic tick.
+ * @param budget Maximum number of nodes to examine (SIZE_MAX for no limit).
+ * @return True if the budget ran out before the sweep caught up with @p now.
  */
-void ttak_mem_tree_perform_cleanup(ttak_mem_tree_t *tree, uint64_t now) {
-    if (!tree) return;
+_Bool ttak_mem_tree_perform_cleanup_budget(ttak_mem_tree_t *tree, uint64_t now, size_t budget) {
+    if (!tree || budget == 0) return false;
 
     // Only walk the tree when there is a known candidate for release.
     if (atomic_load(&tree->garbage_pressure) == 0 && !atomic_load(&tree->cleanup_needed)) {
-        return;
+        return false;
     }
 
-    pthread_mutex_lock(&tree->lock);
-    ttak_mem_node_t **indirect = &tree->head;
-    ttak_mem_node_t *to_free_head = NULL;
-    ttak_mem_node_t *to_free_tail = NULL;
+    uint64_t now_slot = now >> TTAK_MEM_TREE_WHEEL_SHIFT;
+    size_t used = 0;
+    size_t due_left = SIZE_MAX;
+    _Bool more = false;
 
-    while (*indirect) {
-        ttak_mem_node_t *node = *indirect;
-        pthread_mutex_lock(&node->lock); // Lock node before checking its state
+    for (;;) {
+        size_t chunk = budget - used < TTAK_MEM_TREE_SWEEP_CHUNK ? budget - used : TTAK_MEM_TREE_SWEEP_CHUNK;
+        ttak_mem_node_t *to_free = NULL;
 
-        _Bool should_free = false;
-        if (atomic_load(&node->ref_count) == 0 && node->expires_tick != __TTAK_UNSAFE_MEM_FOREVER__ && now >= node->expires_tick) {
-            should_free = true;
-        }
+        pthread_mutex_lock(&tree->lock);
+        tree_drain_locked(tree);
+        size_t n = tree_advance_wheel(tree, now_slot, chunk);
+        if (tree->wheel_cursor > now_slot) {
+            /* Examine each node that was due when the wheel caught up once. */
+            if (due_left == SIZE_MAX) due_left = tree->due.count;
+            while (n < chunk && due_left > 0 && tree->due.head) {
+                ttak_mem_node_t *node = tree->due.head;
+                due_left--;
+                n++;
 
-        pthread_mutex_unlock(&node->lock); // Unlock node
+                _Bool should_free = atomic_load(&node->ref_count) == 0 && now >= node->expires_tick;
 
-        if (should_free) {
-            *indirect = node->next; // Remove from main list
-            if (node->next) {
-                node->next->prev = node->prev;
+                node_list_unlink(node);
+                if (!should_free) {
+                    node_list_push(&tree->due, node);
+                } else if (tree_claim_filed(tree, node)) {
+                    node->next = to_free;
+                    to_free = node;
+                }
+                /* Otherwise it was removed meanwhile and waits on its shard's detached list. */
             }
-            
-            // Add to temporary free list
-            node->next = NULL;
-            node->prev = NULL;
-            if (!to_free_head) {
-                to_free_head = node;
-                to_free_tail = node;
-            } else {
-                to_free_tail->next = node;
-                to_free_tail = node;
+        }
+        _Bool caught_up = tree->wheel_cursor > now_slot && (due_left == 0 || !tree->due.head);
+        pthread_mutex_unlock(&tree->lock);
+
+        // Free collected nodes outside the tree lock
+        size_t total_freed = 0;
+        for (ttak_mem_node_t *node = to_free; node; node = node->next) {
+            total_freed += node->size;
+            if (node->ptr) {
+                ttak_mem_free(node->ptr);
+                node->ptr = NULL;
             }
-        } else {
-            indirect = &(*indirect)->next;
         }
-    }
-    pthread_mutex_unlock(&tree->lock);
+        node_slab_free_chain(tree, to_free);
 
-    // Free collected nodes outside the tree lock
-    size_t total_freed = 0;
-    ttak_mem_node_t *current = to_free_head;
-    while (current) {
-        ttak_mem_node_t *next = current->next;
-        total_freed += current->size;
-        if (current->ptr) {
-            ttak_mem_free(current->ptr);
-            current->ptr = NULL;
+        // Subtract freed amount from pressure
+        if (total_freed > 0) {
+            size_t old_pressure = atomic_load(&tree->garbage_pressure);
+            while (old_pressure >= total_freed && !atomic_compare_exchange_weak(&tree->garbage_pressure, &old_pressure, old_pressure - total_freed));
+            if (old_pressure < total_freed) {
+                atomic_store(&tree->garbage_pressure, 0);
+            }
         }
-        pthread_mutex_destroy(&current->lock);
-        free(current);
-        current = next;
-    }
 
-    // Subtract freed amount from pressure
-    if (total_freed > 0) {
-        size_t old_pressure = atomic_load(&tree->garbage_pressure);
-        while (old_pressure >= total_freed && !atomic_compare_exchange_weak(&tree->garbage_pressure, &old_pressure, old_pressure - total_freed));
-        if (old_pressure < total_freed) {
-            atomic_store(&tree->garbage_pressure, 0);
+        used += n;
+        if (caught_up) break;
+        if (used >= budget) {
+            more = true;
+            break;
         }
     }
 
     // No remaining pressure means there is nothing left to clean up.
-    if (atomic_load(&tree->garbage_pressure) == 0) {
+    if (!more && atomic_load(&tree->garbage_pressure) == 0) {
         atomic_store(&tree->cleanup_needed, false);
     }
+    return more;
+}
+
+/**
+ * @brief Performs a manual cleanup pass, freeing expired and unreferenced memory blocks.
+ *
+ * This function first checks whether any cleanup work is known to be pending. If
+ * garbage_pressure is zero and cleanup_needed is false, it returns immediately
+ * without touching the tree. Otherwise it runs an unbounded incremental sweep
+ * and frees every node whose reference count is zero and whose expiration time
+ * has passed.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param now Current monotonic tick.
+ */
+void ttak_mem_tree_perform_cleanup(ttak_mem_tree_t *tree, uint64_t now) {
+    (void)ttak_mem_tree_perform_cleanup_budget(tree, now, SIZE_MAX);
 }
 
 #ifdef _WIN32
@@ -424,7 +1045,10 @@ static void *cleanup_thread_func(void *arg) {
             size_t pressure = atomic_load(&tree->garbage_pressure);
 
             if (pressure > 0 || (hints & (TTAK_MEM_TREE_HINT_ALLOC | TTAK_MEM_TREE_HINT_FREE | TTAK_MEM_TREE_HINT_PRESSURE))) {
-                ttak_mem_tree_perform_cleanup(tree, ttak_get_tick_count());
+                // Budgeted sweep; come straight back if it had to stop early.
+                if (ttak_mem_tree_perform_cleanup_budget(tree, ttak_get_tick_count(), TTAK_MEM_TREE_DEFAULT_BUDGET)) {
+                    continue;
+                }
                 // Reset sleep interval to min after productive work.
                 current_sleep_ns = atomic_load(&tree->min_cleanup_interval_ns);
             } else {
@@ -465,9 +1089,10 @@ static void *cleanup_thread_func(void *arg) {
 /**
  * @brief Finds a mem node associated with a given memory pointer.
  *
- * This function traverses the mem tree's internal list to find the node
- * that tracks the specified memory pointer. It ensures thread-safe access
- * to the tree structure.
+ * This function probes the pointer index of @p ptr's shard without taking
+ * any lock, pinned by the epoch so a concurrent rebuild cannot free the
+ * table under it. A caller already inside an epoch critical section keeps
+ * its pin. A shard whose index could never be allocated tracks no nodes.
  *
  * @param tree Pointer to the mem tree.
  * @param ptr The memory pointer to search for.
@@ -476,17 +1101,13 @@ static void *cleanup_thread_func(void *arg) {
 ttak_mem_node_t *ttak_mem_tree_find_node(ttak_mem_tree_t *tree, void *ptr) {
     if (!tree || !ptr) return NULL;
 
-    pthread_mutex_lock(&tree->lock);
-    ttak_mem_node_t *current = tree->head;
-    while (current) {
-        if (current->ptr == ptr) {
-            pthread_mutex_unlock(&tree->lock);
-            return current;
-        }
-        current = current->next;
-    }
-    pthread_mutex_unlock(&tree->lock);
-    return NULL;
+    ttak_thread_state_t *st = t_local_state;
+    _Bool pinned = st && atomic_load_explicit(&st->active, memory_order_relaxed);
+    if (!pinned) ttak_epoch_enter();
+    struct ttak_mem_tree_index *idx = atomic_load_explicit(&tree_shard(tree, ptr)->index, memory_order_acquire);
+    ttak_mem_node_t *found = idx ? index_lookup(idx, ptr) : NULL;
+    if (!pinned) ttak_epoch_exit();
+    return found;
 }
 
 void ttak_mem_tree_hint(ttak_mem_tree_t *tree, ttak_mem_tree_hint_t hint) {
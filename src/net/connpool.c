@@ -0,0 +1,442 @@
+/**
+ * @file connpool.c
+ * @brief Per-destination idle connection lists with reactor-driven connects.
+ *
+ * Destinations hash into a small table behind one pool lock; each keeps
+ * a LIFO array of idle endpoints, so the most recently used (and most
+ * likely still open) connection is tried first. A health check runs
+ * outside the lock on every reuse. Misses open a non-blocking socket and
+ * register it with the reactor for POLLOUT; the watch's release callback
+ * binds the finished socket into an endpoint, since by then the reactor
+ * has dropped its registration of the fd.
+ */
+
+#include <ttak/net/connpool.h>
+
+#include <ttak/sync/sync.h>
+
+#include <errno.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#define conn_close_fd closesocket
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define conn_close_fd close
+#endif
+
+#define CONN_POOL_BUCKETS 64U
+
+typedef struct conn_idle {
+    ttak_shared_net_endpoint_t *ep;
+    uint64_t since;
+} conn_idle_t;
+
+typedef struct conn_dest {
+    struct conn_dest *next;
+    struct sockaddr_storage addr;
+    uint8_t addr_len;
+    conn_idle_t *idle;              /* max_idle slots, most recent last. */
+    size_t nidle;
+    size_t connecting;
+} conn_dest_t;
+
+struct ttak_net_conn_pool {
+    ttak_net_conn_pool_config_t cfg;
+    ttak_io_reactor_t *reactor;
+    ttak_owner_t *owner;
+    ttak_net_endpoint_pool_t endpoints;
+    ttak_mutex_t lock;              /* Guards everything below. */
+    conn_dest_t *buckets[CONN_POOL_BUCKETS];
+    ttak_net_conn_pool_stats_t stats;
+};
+
+/* One connect waiting on the reactor. */
+typedef struct conn_pending {
+    ttak_net_conn_pool_t *pool;
+    conn_dest_t *dest;
+    ttak_io_guard_t guard;          /* Only carries the fd to the reactor; never closed. */
+    ttak_io_watch_t *watch;
+    _Atomic int steps;              /* Watch published + connect settled; the second removes. */
+    _Atomic bool done;
+    int error;
+    ttak_net_conn_ready_cb cb;
+    void *user;
+} conn_pending_t;
+
+static uint32_t conn_hash(const void *addr, uint8_t len) {
+    const uint8_t *p = addr;
+    uint32_t h = 2166136261u;
+    for (uint8_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* Pool lock held. */
+static conn_dest_t *conn_dest_get(ttak_net_conn_pool_t *pool, const void *addr, uint8_t len, bool create) {
+    conn_dest_t **slot = &pool->buckets[conn_hash(addr, len) % CONN_POOL_BUCKETS];
+    for (conn_dest_t *d = *slot; d; d = d->next) {
+        if (d->addr_len == len && memcmp(&d->addr, addr, len) == 0) return d;
+    }
+    if (!create) return NULL;
+    conn_dest_t *d = calloc(1, sizeof(*d));
+    if (!d) return NULL;
+    d->idle = calloc(pool->cfg.max_idle, sizeof(*d->idle));
+    if (!d->idle) {
+        free(d);
+        return NULL;
+    }
+    memcpy(&d->addr, addr, len);
+    d->addr_len = len;
+    d->next = *slot;
+    *slot = d;
+    return d;
+}
+
+static ttak_net_endpoint_type_t conn_endpoint_type(int family) {
+    switch (family) {
+    case AF_INET6: return TTAK_NET_ENDPOINT_IPV6;
+#ifndef _WIN32
+    case AF_UNIX: return TTAK_NET_ENDPOINT_UNIX;
+#endif
+    default: return TTAK_NET_ENDPOINT_IPV4;
+    }
+}
+
+/* Opens a non-blocking stream socket and starts connecting it: 0 connected, 1 in progress, -1 failed. */
+static int conn_open(const conn_dest_t *dest, int *out_fd) {
+    int fd = (int)socket(dest->addr.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+#ifdef _WIN32
+    u_long on = 1;
+    if (ioctlsocket(fd, FIONBIO, &on) != 0) {
+        conn_close_fd(fd);
+        return -1;
+    }
+#else
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+        conn_close_fd(fd);
+        return -1;
+    }
+#endif
+    *out_fd = fd;
+    if (connect(fd, (const struct sockaddr *)&dest->addr, dest->addr_len) == 0) return 0;
+#ifdef _WIN32
+    if (WSAGetLastError() == WSAEWOULDBLOCK) return 1;
+#else
+    if (errno == EINPROGRESS || errno == EAGAIN) return 1;
+#endif
+    conn_close_fd(fd);
+    return -1;
+}
+
+static int conn_socket_error(int fd) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, (char *)&err, &len) != 0) return errno ? errno : EIO;
+    return err;
+}
+
+/* Closes @p ep for good, or parks it when its destination has room. */
+static void conn_park(ttak_net_conn_pool_t *pool, conn_dest_t *dest, ttak_shared_net_endpoint_t *ep, uint64_t now) {
+    bool parked = false;
+    ttak_mutex_lock(&pool->lock);
+    if (dest && dest->nidle < pool->cfg.max_idle) {
+        dest->idle[dest->nidle].ep = ep;
+        dest->idle[dest->nidle].since = now;
+        dest->nidle++;
+        pool->stats.idle++;
+        parked = true;
+    }
+    ttak_mutex_unlock(&pool->lock);
+    if (!parked) ttak_net_endpoint_pool_release(&pool->endpoints, ep, pool->owner, now);
+}
+
+/*
+ * Settles a connect: binds the socket into an endpoint on success and
+ * hands it to @p cb, or to the idle list for a prewarm (@p cb NULL).
+ */
+static void conn_finish(ttak_net_conn_pool_t *pool, conn_dest_t *dest, int fd, int error,
+                        ttak_net_conn_ready_cb cb, void *user, uint64_t now) {
+    ttak_shared_net_endpoint_t *ep = NULL;
+    ttak_io_status_t status = TTAK_IO_ERR_SYS_FAILURE;
+    if (error == 0) {
+        ep = ttak_net_endpoint_pool_acquire(&pool->endpoints, pool->owner, now);
+        if (ep) {
+            status = ttak_net_endpoint_bind_fd(ep, pool->owner, fd, dest->addr.ss_family, SOCK_STREAM, 0,
+                                               &dest->addr, dest->addr_len,
+                                               conn_endpoint_type(dest->addr.ss_family),
+                                               pool->cfg.guard_ttl_ns, now);
+            if (status != TTAK_IO_SUCCESS) {
+                ttak_net_endpoint_pool_release(&pool->endpoints, ep, NULL, now);
+                ep = NULL;
+            }
+        }
+    }
+    if (!ep) conn_close_fd(fd);
+
+    ttak_mutex_lock(&pool->lock);
+    dest->connecting--;
+    pool->stats.connecting--;
+    if (ep) {
+        pool->stats.connected++;
+    } else {
+        pool->stats.failed++;
+    }
+    ttak_mutex_unlock(&pool->lock);
+
+    if (cb) {
+        cb(ep, ep ? TTAK_IO_SUCCESS : status, user);
+    } else if (ep) {
+        conn_park(pool, dest, ep, now);
+    }
+}
+
+static void conn_pending_step(conn_pending_t *p) {
+    if (atomic_fetch_add_explicit(&p->steps, 1, memory_order_acq_rel) == 1) {
+        ttak_io_reactor_remove(p->watch);
+    }
+}
+
+static void conn_on_ready(int fd, short revents, void *user) {
+    conn_pending_t *p = user;
+    if (!(revents & (POLLOUT | POLLERR | POLLHUP))) return;
+    bool expected = false;
+    if (!atomic_compare_exchange_strong(&p->done, &expected, true)) return;
+    p->error = conn_socket_error(fd);
+    if (p->error == 0 && (revents & POLLERR)) p->error = ECONNREFUSED;
+    conn_pending_step(p);
+}
+
+/* The reactor has dropped the fd, so the socket can now change hands. */
+static void conn_on_release(void *user) {
+    conn_pending_t *p = user;
+    int error = atomic_load_explicit(&p->done, memory_order_acquire) ? p->error : ECANCELED;
+    conn_finish(p->pool, p->dest, p->guard.fd, error, p->cb, p->user, ttak_get_tick_count_ns());
+    free(p);
+}
+
+static ttak_io_status_t conn_start(ttak_net_conn_pool_t *pool, conn_dest_t *dest,
+                                   ttak_net_conn_ready_cb cb, void *user, uint64_t now) {
+    ttak_mutex_lock(&pool->lock);
+    dest->connecting++;
+    pool->stats.connecting++;
+    ttak_mutex_unlock(&pool->lock);
+
+    int fd = -1;
+    int rc = conn_open(dest, &fd);
+    if (rc == 0) {
+        conn_finish(pool, dest, fd, 0, cb, user, now);
+        return TTAK_IO_SUCCESS;
+    }
+    if (rc > 0 && pool->reactor) {
+        conn_pending_t *p = calloc(1, sizeof(*p));
+        if (p) {
+            p->pool = pool;
+            p->dest = dest;
+            p->cb = cb;
+            p->user = user;
+            atomic_init(&p->steps, 0);
+            atomic_init(&p->done, false);
+            ttak_io_guard_init(&p->guard, fd, NULL, UINT64_MAX, now);
+            if (ttak_io_reactor_add(pool->reactor, &p->guard, POLLOUT, conn_on_ready, p,
+                                    conn_on_release, &p->watch, now) == TTAK_IO_SUCCESS) {
+                conn_pending_step(p);
+                return TTAK_IO_SUCCESS;
+            }
+            free(p);
+        }
+        conn_close_fd(fd);
+        rc = -1;
+    }
+#ifndef _WIN32
+    if (rc > 0) {
+        /* No reactor: wait for the handshake here. */
+        struct pollfd pfd = { .fd = fd, .events = POLLOUT, .revents = 0 };
+        int n;
+        do {
+            n = poll(&pfd, 1, -1);
+        } while (n < 0 && errno == EINTR);
+        conn_finish(pool, dest, fd, n > 0 ? conn_socket_error(fd) : EIO, cb, user, now);
+        return TTAK_IO_SUCCESS;
+    }
+#endif
+    if (rc > 0) conn_close_fd(fd);
+
+    ttak_mutex_lock(&pool->lock);
+    dest->connecting--;
+    pool->stats.connecting--;
+    pool->stats.failed++;
+    ttak_mutex_unlock(&pool->lock);
+    return TTAK_IO_ERR_SYS_FAILURE;
+}
+
+/* Open, unexpired, and neither closed by the peer nor holding unread bytes. */
+static bool conn_healthy(ttak_net_conn_pool_t *pool, ttak_shared_net_endpoint_t *ep, uint64_t now) {
+    ttak_net_guard_snapshot_t snap;
+    if (ttak_net_endpoint_snapshot_guard(ep, pool->owner, &snap, now) != TTAK_IO_SUCCESS) return false;
+    char byte;
+#ifdef _WIN32
+    u_long pending = 0;
+    (void)byte;
+    return ioctlsocket(snap.fd, FIONREAD, &pending) == 0 && pending == 0;
+#else
+    ssize_t n = recv(snap.fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+#endif
+}
+
+/* Starts parked connects until @p dest holds @p want connections. */
+static size_t conn_top_up(ttak_net_conn_pool_t *pool, conn_dest_t *dest, size_t want, uint64_t now) {
+    ttak_mutex_lock(&pool->lock);
+    size_t have = dest->nidle + dest->connecting;
+    ttak_mutex_unlock(&pool->lock);
+    size_t started = 0;
+    for (; have + started < want; started++) {
+        if (conn_start(pool, dest, NULL, NULL, now) != TTAK_IO_SUCCESS) break;
+    }
+    return started;
+}
+
+ttak_net_conn_pool_t *ttak_net_conn_pool_create(const ttak_net_conn_pool_config_t *cfg,
+                                                ttak_io_reactor_t *reactor,
+                                                ttak_owner_t *owner) {
+    if (!owner) return NULL;
+    ttak_net_conn_pool_t *pool = calloc(1, sizeof(*pool));
+    if (!pool) return NULL;
+    if (cfg) pool->cfg = *cfg;
+    if (pool->cfg.max_idle == 0) pool->cfg.max_idle = TTAK_NET_CONN_POOL_DEFAULT_IDLE;
+    if (pool->cfg.min_idle > pool->cfg.max_idle) pool->cfg.min_idle = pool->cfg.max_idle;
+    if (pool->cfg.idle_ttl_ns == 0) pool->cfg.idle_ttl_ns = TTAK_NET_CONN_POOL_DEFAULT_IDLE_TTL;
+    if (pool->cfg.guard_ttl_ns == 0) pool->cfg.guard_ttl_ns = UINT64_MAX;
+    pool->reactor = reactor;
+    pool->owner = owner;
+    ttak_net_endpoint_pool_init(&pool->endpoints, 0);
+    ttak_mutex_init(&pool->lock);
+    return pool;
+}
+
+void ttak_net_conn_pool_destroy(ttak_net_conn_pool_t *pool, uint64_t now) {
+    if (!pool) return;
+    for (;;) {
+        ttak_mutex_lock(&pool->lock);
+        size_t connecting = pool->stats.connecting;
+        ttak_mutex_unlock(&pool->lock);
+        if (connecting == 0) break;
+        sched_yield();
+    }
+    for (uint32_t b = 0; b < CONN_POOL_BUCKETS; b++) {
+        conn_dest_t *d = pool->buckets[b];
+        while (d) {
+            conn_dest_t *next = d->next;
+            for (size_t i = 0; i < d->nidle; i++) {
+                ttak_net_endpoint_pool_release(&pool->endpoints, d->idle[i].ep, pool->owner, now);
+            }
+            free(d->idle);
+            free(d);
+            d = next;
+        }
+    }
+    ttak_net_endpoint_pool_destroy(&pool->endpoints, now);
+    ttak_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+ttak_io_status_t ttak_net_conn_pool_checkout(ttak_net_conn_pool_t *pool,
+                                             const void *addr,
+                                             uint8_t addr_len,
+                                             ttak_net_conn_ready_cb cb,
+                                             void *user,
+                                             uint64_t now) {
+    if (!pool || !addr || addr_len == 0 || addr_len > sizeof(struct sockaddr_storage) || !cb) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    ttak_mutex_lock(&pool->lock);
+    conn_dest_t *dest = conn_dest_get(pool, addr, addr_len, true);
+    ttak_mutex_unlock(&pool->lock);
+    if (!dest) return TTAK_IO_ERR_SYS_FAILURE;
+
+    for (;;) {
+        conn_idle_t slot = { NULL, 0 };
+        ttak_mutex_lock(&pool->lock);
+        if (dest->nidle > 0) {
+            slot = dest->idle[--dest->nidle];
+            pool->stats.idle--;
+        }
+        ttak_mutex_unlock(&pool->lock);
+        if (!slot.ep) break;
+
+        bool fresh = now < slot.since || now - slot.since <= pool->cfg.idle_ttl_ns;
+        if (fresh && conn_healthy(pool, slot.ep, now)) {
+            ttak_mutex_lock(&pool->lock);
+            pool->stats.reused++;
+            ttak_mutex_unlock(&pool->lock);
+            if (pool->cfg.min_idle) conn_top_up(pool, dest, pool->cfg.min_idle, now);
+            cb(slot.ep, TTAK_IO_SUCCESS, user);
+            return TTAK_IO_SUCCESS;
+        }
+        ttak_net_endpoint_pool_release(&pool->endpoints, slot.ep, pool->owner, now);
+        ttak_mutex_lock(&pool->lock);
+        pool->stats.discarded++;
+        ttak_mutex_unlock(&pool->lock);
+    }
+
+    if (pool->cfg.min_idle) conn_top_up(pool, dest, pool->cfg.min_idle, now);
+    return conn_start(pool, dest, cb, user, now);
+}
+
+void ttak_net_conn_pool_checkin(ttak_net_conn_pool_t *pool,
+                                ttak_shared_net_endpoint_t *endpoint,
+                                bool reusable,
+                                uint64_t now) {
+    if (!pool || !endpoint) return;
+    conn_dest_t *dest = NULL;
+    if (reusable) {
+        ttak_shared_result_t res = 0;
+        ttak_net_endpoint_t *payload = ttak_shared_net_endpoint_access(endpoint, pool->owner, &res);
+        if (payload && res == TTAK_OWNER_SUCCESS) {
+            if (payload->fd >= 0) {
+                ttak_mutex_lock(&pool->lock);
+                dest = conn_dest_get(pool, payload->addr.storage, payload->addr.len, false);
+                ttak_mutex_unlock(&pool->lock);
+            }
+            ttak_shared_net_endpoint_release(endpoint);
+        }
+    }
+    conn_park(pool, dest, endpoint, now);
+}
+
+size_t ttak_net_conn_pool_prewarm(ttak_net_conn_pool_t *pool,
+                                  const void *addr,
+                                  uint8_t addr_len,
+                                  size_t count,
+                                  uint64_t now) {
+    if (!pool || !addr || addr_len == 0 || addr_len > sizeof(struct sockaddr_storage)) return 0;
+    ttak_mutex_lock(&pool->lock);
+    conn_dest_t *dest = conn_dest_get(pool, addr, addr_len, true);
+    ttak_mutex_unlock(&pool->lock);
+    if (!dest) return 0;
+    if (count > pool->cfg.max_idle) count = pool->cfg.max_idle;
+    return conn_top_up(pool, dest, count, now);
+}
+
+void ttak_net_conn_pool_stats(ttak_net_conn_pool_t *pool, ttak_net_conn_pool_stats_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!pool) return;
+    ttak_mutex_lock(&pool->lock);
+    *out = pool->stats;
+    ttak_mutex_unlock(&pool->lock);
+}
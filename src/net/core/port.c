@@ -5,6 +5,10 @@
  * Called once at startup via ttak_net_driver_detect().  Selects the right
  * socket function pointers based on the compiled target and, for bare-metal,
  * installs the caller-supplied NIC hooks from @c ttak_net_baremetal_spec_t.
+ *
+ * Batch I/O maps onto recvmmsg()/sendmmsg() on Linux, with UDP GSO/GRO
+ * sizes carried in control messages; other targets loop over one
+ * datagram per call and refuse segmentation offload.
  */
 
 #include <ttak/net/core/port.h>
@@ -18,11 +22,67 @@
 #include <netinet/in.h>
 #include <unistd.h>
 #include <poll.h>
+#include <sys/uio.h>
+#endif
+#if defined(__linux__)
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+#ifndef SO_BUSY_POLL_BUDGET
+#define SO_BUSY_POLL_BUDGET 70
+#endif
 #endif
 
 #include <errno.h>
+#include <string.h>
 
-static int ttak_baremetal_stub(void) {
+#if defined(__BAREMETAL__) || !(defined(_WIN32) || defined(__linux__) || defined(__FreeBSD__) || \
+    defined(__OpenBSD__) || defined(__NetBSD__) || defined(__APPLE__))
+/* Bare-metal targets without NIC hooks get stubs that refuse every call. */
+static int ttak_bm_socket_open(int domain, int type, int protocol) {
+    (void)domain; (void)type; (void)protocol;
+    return -ENOSYS;
+}
+static int ttak_bm_socket_close(int fd) {
+    (void)fd;
+    return -ENOSYS;
+}
+static int ttak_bm_socket_addr(int fd, const void *addr, size_t len) {
+    (void)fd; (void)addr; (void)len;
+    return -ENOSYS;
+}
+static int ttak_bm_socket_listen(int fd, int backlog) {
+    (void)fd; (void)backlog;
+    return -ENOSYS;
+}
+static int ttak_bm_socket_recv(int fd, void *buf, size_t len) {
+    (void)fd; (void)buf; (void)len;
+    return -ENOSYS;
+}
+static int ttak_bm_socket_setopt(int fd, int opt, const void *val, size_t len) {
+    (void)fd; (void)opt; (void)val; (void)len;
+    return -ENOSYS;
+}
+static int ttak_bm_poll_wait(int fd, uint32_t events, int timeout_ms) {
+    (void)fd; (void)events; (void)timeout_ms;
+    return -ENOSYS;
+}
+static int ttak_bm_socket_mmsg(int fd, ttak_net_msg_t *msgs, size_t n, int flags) {
+    (void)fd; (void)msgs; (void)n; (void)flags;
+    return -ENOSYS;
+}
+static int ttak_bm_socket_offload(int fd, const ttak_net_offload_t *offload) {
+    (void)fd; (void)offload;
     return -ENOSYS;
 }
 
@@ -32,16 +92,20 @@ static void ttak_fill_baremetal(ttak_net_driver_ops_t *ops,
         *ops = *bm->driver_ops;
         return;
     }
-    ops->socket_open = (int (*)(int, int, int))ttak_baremetal_stub;
-    ops->socket_close = (int (*)(int))ttak_baremetal_stub;
-    ops->socket_bind = (int (*)(int, const void *, size_t))ttak_baremetal_stub;
-    ops->socket_listen = (int (*)(int, int))ttak_baremetal_stub;
-    ops->socket_connect = (int (*)(int, const void *, size_t))ttak_baremetal_stub;
-    ops->socket_send = (int (*)(int, const void *, size_t))ttak_baremetal_stub;
-    ops->socket_recv = (int (*)(int, void *, size_t))ttak_baremetal_stub;
-    ops->socket_setopt = (int (*)(int, int, const void *, size_t))ttak_baremetal_stub;
-    ops->poll_wait = (int (*)(int, uint32_t, int))ttak_baremetal_stub;
+    ops->socket_open = ttak_bm_socket_open;
+    ops->socket_close = ttak_bm_socket_close;
+    ops->socket_bind = ttak_bm_socket_addr;
+    ops->socket_listen = ttak_bm_socket_listen;
+    ops->socket_connect = ttak_bm_socket_addr;
+    ops->socket_send = ttak_bm_socket_addr;
+    ops->socket_recv = ttak_bm_socket_recv;
+    ops->socket_setopt = ttak_bm_socket_setopt;
+    ops->poll_wait = ttak_bm_poll_wait;
+    ops->socket_sendmmsg = ttak_bm_socket_mmsg;
+    ops->socket_recvmmsg = ttak_bm_socket_mmsg;
+    ops->socket_offload = ttak_bm_socket_offload;
 }
+#endif
 
 #if defined(_WIN32)
 static int ttak_win_socket_open(int domain, int type, int protocol) {
@@ -65,10 +129,57 @@ static int ttak_win_socket_send(int fd, const void *buf, size_t len) {
 static int ttak_win_socket_recv(int fd, void *buf, size_t len) {
     return recv(fd, buf, (int)len, 0);
 }
+/* Options are socket-level (SOL_SOCKET). */
+static int ttak_win_socket_setopt(int fd, int opt, const void *val, size_t len) {
+    return setsockopt(fd, SOL_SOCKET, opt, (const char *)val, (int)len);
+}
 static int ttak_win_poll_wait(int fd, uint32_t events, int timeout_ms) {
     WSAPOLLFD pfd = { .fd = fd, .events = (SHORT)events };
     return WSAPoll(&pfd, 1, timeout_ms);
 }
+static int ttak_win_socket_sendmmsg(int fd, ttak_net_msg_t *msgs, size_t n, int flags) {
+    size_t i;
+    for (i = 0; i < n; i++) {
+        if (msgs[i].gso_size) {
+            WSASetLastError(WSAEOPNOTSUPP);
+            break;
+        }
+        int rc = msgs[i].addr
+                 ? sendto(fd, msgs[i].buf, (int)msgs[i].len, flags, (const struct sockaddr *)msgs[i].addr, (int)msgs[i].addr_len)
+                 : send(fd, msgs[i].buf, (int)msgs[i].len, flags);
+        if (rc < 0) break;
+        msgs[i].bytes = (size_t)rc;
+    }
+    return i ? (int)i : -1;
+}
+static int ttak_win_socket_recvmmsg(int fd, ttak_net_msg_t *msgs, size_t n, int flags) {
+    size_t i;
+    for (i = 0; i < n; i++) {
+        /* Only the first message may block. */
+        if (i > 0) {
+            WSAPOLLFD pfd = { .fd = fd, .events = POLLRDNORM };
+            if (WSAPoll(&pfd, 1, 0) <= 0) break;
+        }
+        int alen = (int)msgs[i].addr_len;
+        int rc = msgs[i].addr
+                 ? recvfrom(fd, msgs[i].buf, (int)msgs[i].len, flags, (struct sockaddr *)msgs[i].addr, &alen)
+                 : recv(fd, msgs[i].buf, (int)msgs[i].len, flags);
+        if (rc < 0) break;
+        msgs[i].bytes = (size_t)rc;
+        msgs[i].addr_len = msgs[i].addr ? (uint32_t)alen : 0;
+        msgs[i].gso_size = 0;
+        msgs[i].flags = 0;
+    }
+    return i ? (int)i : -1;
+}
+static int ttak_win_socket_offload(int fd, const ttak_net_offload_t *cfg) {
+    (void)fd;
+    if (cfg && (cfg->udp_gro || cfg->busy_poll_us || cfg->busy_poll_budget || cfg->prefer_busy_poll)) {
+        WSASetLastError(WSAEOPNOTSUPP);
+        return -1;
+    }
+    return 0;
+}
 #endif
 
 #if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__APPLE__)
@@ -91,10 +202,172 @@ static int ttak_posix_socket_send(int fd, const void *buf, size_t len) {
 static int ttak_posix_socket_recv(int fd, void *buf, size_t len) {
     return (int)recv(fd, buf, len, 0);
 }
+/* Options are socket-level (SOL_SOCKET). */
+static int ttak_posix_socket_setopt(int fd, int opt, const void *val, size_t len) {
+    return setsockopt(fd, SOL_SOCKET, opt, val, (socklen_t)len);
+}
 static int ttak_posix_poll_wait(int fd, uint32_t events, int timeout_ms) {
     struct pollfd pfd = { .fd = fd, .events = (short)events };
     return poll(&pfd, 1, timeout_ms);
 }
+
+#if defined(__linux__)
+typedef union {
+    char buf[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+} ttak_posix_cmsg_t;
+
+static int ttak_posix_socket_sendmmsg(int fd, ttak_net_msg_t *msgs, size_t n, int flags) {
+    struct mmsghdr hdr[TTAK_NET_MMSG_CHUNK];
+    struct iovec iov[TTAK_NET_MMSG_CHUNK];
+    ttak_posix_cmsg_t ctl[TTAK_NET_MMSG_CHUNK];
+    size_t total = 0;
+    while (total < n) {
+        unsigned k = (unsigned)((n - total) < TTAK_NET_MMSG_CHUNK ? (n - total) : TTAK_NET_MMSG_CHUNK);
+        memset(hdr, 0, k * sizeof(hdr[0]));
+        for (unsigned i = 0; i < k; i++) {
+            ttak_net_msg_t *m = &msgs[total + i];
+            iov[i].iov_base = m->buf;
+            iov[i].iov_len = m->len;
+            hdr[i].msg_hdr.msg_iov = &iov[i];
+            hdr[i].msg_hdr.msg_iovlen = 1;
+            hdr[i].msg_hdr.msg_name = m->addr;
+            hdr[i].msg_hdr.msg_namelen = m->addr ? (socklen_t)m->addr_len : 0;
+            if (m->gso_size) {
+                uint16_t seg = m->gso_size;
+                memset(&ctl[i], 0, sizeof(ctl[i]));
+                hdr[i].msg_hdr.msg_control = ctl[i].buf;
+                hdr[i].msg_hdr.msg_controllen = CMSG_SPACE(sizeof(seg));
+                struct cmsghdr *cm = CMSG_FIRSTHDR(&hdr[i].msg_hdr);
+                cm->cmsg_level = SOL_UDP;
+                cm->cmsg_type = UDP_SEGMENT;
+                cm->cmsg_len = CMSG_LEN(sizeof(seg));
+                memcpy(CMSG_DATA(cm), &seg, sizeof(seg));
+            }
+        }
+        int rc = sendmmsg(fd, hdr, k, flags);
+        if (rc < 0) return total ? (int)total : -1;
+        for (int i = 0; i < rc; i++) msgs[total + (size_t)i].bytes = hdr[i].msg_len;
+        total += (size_t)rc;
+        if ((unsigned)rc < k) break;
+    }
+    return (int)total;
+}
+
+static int ttak_posix_socket_recvmmsg(int fd, ttak_net_msg_t *msgs, size_t n, int flags) {
+    struct mmsghdr hdr[TTAK_NET_MMSG_CHUNK];
+    struct iovec iov[TTAK_NET_MMSG_CHUNK];
+    ttak_posix_cmsg_t ctl[TTAK_NET_MMSG_CHUNK];
+    size_t total = 0;
+    while (total < n) {
+        unsigned k = (unsigned)((n - total) < TTAK_NET_MMSG_CHUNK ? (n - total) : TTAK_NET_MMSG_CHUNK);
+        memset(hdr, 0, k * sizeof(hdr[0]));
+        for (unsigned i = 0; i < k; i++) {
+            ttak_net_msg_t *m = &msgs[total + i];
+            iov[i].iov_base = m->buf;
+            iov[i].iov_len = m->len;
+            hdr[i].msg_hdr.msg_iov = &iov[i];
+            hdr[i].msg_hdr.msg_iovlen = 1;
+            hdr[i].msg_hdr.msg_name = m->addr;
+            hdr[i].msg_hdr.msg_namelen = m->addr ? (socklen_t)m->addr_len : 0;
+            hdr[i].msg_hdr.msg_control = ctl[i].buf;
+            hdr[i].msg_hdr.msg_controllen = sizeof(ctl[i].buf);
+        }
+        /* Block for the first message at most; later chunks take only what is queued. */
+        int rc = recvmmsg(fd, hdr, k, total ? (flags | MSG_DONTWAIT) : (flags | MSG_WAITFORONE), NULL);
+        if (rc < 0) return total ? (int)total : -1;
+        for (int i = 0; i < rc; i++) {
+            ttak_net_msg_t *m = &msgs[total + (size_t)i];
+            m->bytes = hdr[i].msg_len;
+            m->addr_len = m->addr ? (uint32_t)hdr[i].msg_hdr.msg_namelen : 0;
+            m->flags = hdr[i].msg_hdr.msg_flags;
+            m->gso_size = 0;
+            for (struct cmsghdr *cm = CMSG_FIRSTHDR(&hdr[i].msg_hdr); cm; cm = CMSG_NXTHDR(&hdr[i].msg_hdr, cm)) {
+                if (cm->cmsg_level == SOL_UDP && cm->cmsg_type == UDP_GRO) {
+                    int seg;
+                    memcpy(&seg, CMSG_DATA(cm), sizeof(seg));
+                    m->gso_size = (uint16_t)seg;
+                }
+            }
+        }
+        total += (size_t)rc;
+        if ((unsigned)rc < k) break;
+    }
+    return (int)total;
+}
+
+static int ttak_posix_socket_offload(int fd, const ttak_net_offload_t *cfg) {
+    if (!cfg) {
+        errno = EINVAL;
+        return -1;
+    }
+    int on = cfg->udp_gro ? 1 : 0;
+    if (setsockopt(fd, SOL_UDP, UDP_GRO, &on, sizeof(on)) != 0 && cfg->udp_gro) return -1;
+    if (cfg->busy_poll_us) {
+        int us = (int)cfg->busy_poll_us;
+        if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &us, sizeof(us)) != 0) return -1;
+    }
+    if (cfg->busy_poll_budget) {
+        int budget = (int)cfg->busy_poll_budget;
+        if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &budget, sizeof(budget)) != 0) return -1;
+    }
+    if (cfg->prefer_busy_poll) {
+        int prefer = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer)) != 0) return -1;
+    }
+    return 0;
+}
+#else
+static int ttak_posix_socket_sendmmsg(int fd, ttak_net_msg_t *msgs, size_t n, int flags) {
+    size_t i;
+    for (i = 0; i < n; i++) {
+        if (msgs[i].gso_size) {
+            errno = ENOTSUP;
+            break;
+        }
+        struct iovec iov = { .iov_base = msgs[i].buf, .iov_len = msgs[i].len };
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = &iov;
+        mh.msg_iovlen = 1;
+        mh.msg_name = msgs[i].addr;
+        mh.msg_namelen = msgs[i].addr ? (socklen_t)msgs[i].addr_len : 0;
+        ssize_t rc = sendmsg(fd, &mh, flags);
+        if (rc < 0) break;
+        msgs[i].bytes = (size_t)rc;
+    }
+    return i ? (int)i : -1;
+}
+
+static int ttak_posix_socket_recvmmsg(int fd, ttak_net_msg_t *msgs, size_t n, int flags) {
+    size_t i;
+    for (i = 0; i < n; i++) {
+        struct iovec iov = { .iov_base = msgs[i].buf, .iov_len = msgs[i].len };
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = &iov;
+        mh.msg_iovlen = 1;
+        mh.msg_name = msgs[i].addr;
+        mh.msg_namelen = msgs[i].addr ? (socklen_t)msgs[i].addr_len : 0;
+        ssize_t rc = recvmsg(fd, &mh, i ? (flags | MSG_DONTWAIT) : flags);
+        if (rc < 0) break;
+        msgs[i].bytes = (size_t)rc;
+        msgs[i].addr_len = msgs[i].addr ? (uint32_t)mh.msg_namelen : 0;
+        msgs[i].flags = mh.msg_flags;
+        msgs[i].gso_size = 0;
+    }
+    return i ? (int)i : -1;
+}
+
+static int ttak_posix_socket_offload(int fd, const ttak_net_offload_t *cfg) {
+    (void)fd;
+    if (cfg && (cfg->udp_gro || cfg->busy_poll_us || cfg->busy_poll_budget || cfg->prefer_busy_poll)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    return 0;
+}
+#endif
 #endif
 
 void ttak_net_driver_detect(ttak_net_driver_ops_t *ops,
@@ -115,8 +388,11 @@ void ttak_net_driver_detect(ttak_net_driver_ops_t *ops,
     ops->socket_connect = ttak_win_socket_connect;
     ops->socket_send = ttak_win_socket_send;
     ops->socket_recv = ttak_win_socket_recv;
-    ops->socket_setopt = (int (*)(int, int, const void *, size_t))setsockopt;
+    ops->socket_setopt = ttak_win_socket_setopt;
     ops->poll_wait = ttak_win_poll_wait;
+    ops->socket_sendmmsg = ttak_win_socket_sendmmsg;
+    ops->socket_recvmmsg = ttak_win_socket_recvmmsg;
+    ops->socket_offload = ttak_win_socket_offload;
 #elif defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__APPLE__)
     *os = TTAK_NET_OS_POSIX;
     ops->socket_open = ttak_posix_socket_open;
@@ -126,10 +402,18 @@ void ttak_net_driver_detect(ttak_net_driver_ops_t *ops,
     ops->socket_connect = ttak_posix_socket_connect;
     ops->socket_send = ttak_posix_socket_send;
     ops->socket_recv = ttak_posix_socket_recv;
-    ops->socket_setopt = (int (*)(int, int, const void *, size_t))setsockopt;
+    ops->socket_setopt = ttak_posix_socket_setopt;
     ops->poll_wait = ttak_posix_poll_wait;
+    ops->socket_sendmmsg = ttak_posix_socket_sendmmsg;
+    ops->socket_recvmmsg = ttak_posix_socket_recvmmsg;
+    ops->socket_offload = ttak_posix_socket_offload;
 #else
     *os = TTAK_NET_OS_BAREMETAL;
     ttak_fill_baremetal(ops, bm);
 #endif
+#if !defined(__BAREMETAL__) && (defined(_WIN32) || defined(__linux__) || defined(__FreeBSD__) || \
+    defined(__OpenBSD__) || defined(__NetBSD__) || defined(__APPLE__))
+    /* A caller-supplied vtable (e.g. ttak_net_xdp_driver_ops()) replaces the OS sockets. */
+    if (bm && bm->driver_ops) *ops = *bm->driver_ops;
+#endif
 }
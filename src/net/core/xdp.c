@@ -0,0 +1,769 @@
+/**
+ * @file xdp.c
+ * @brief AF_XDP sockets with a buddy-allocated UMEM and lattice ingress.
+ *
+ * Each socket owns one UMEM split into equal frames: the first half is
+ * posted to the fill ring for receive, the second half kept on a free
+ * stack for transmit. Received frames go back to the fill ring in the same
+ * pass that consumes them; transmitted frames return to the free stack
+ * when the completion ring reports them. The redirect program is five raw
+ * BPF instructions loaded with the bpf() syscall and attached through a
+ * BPF link, so it detaches when the socket closes or the process dies.
+ */
+
+#include <ttak/net/core/xdp.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/if_xdp.h>) && __has_include(<linux/bpf.h>)
+#    include <linux/if_xdp.h>
+#    include <linux/bpf.h>
+#    if defined(XDP_USE_NEED_WAKEUP) && defined(XDP_RING_NEED_WAKEUP)
+#      define TTAK_NET_XDP_SUPPORTED 1
+#    endif
+#  endif
+#endif
+
+#if defined(TTAK_NET_XDP_SUPPORTED)
+
+#include <ttak/phys/mem/buddy.h>
+#include <ttak/sync/sync.h>
+#include <ttak/timing/timing.h>
+
+#include <net/if.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+#ifndef SO_BUSY_POLL_BUDGET
+#define SO_BUSY_POLL_BUDGET 70
+#endif
+
+#define XDP_FLAGS_SKB 2U
+#define XDP_FLAGS_DRV 4U
+#define XDP_PAGE 4096U
+#define XDP_MIN_FRAMES (2U * TTAK_NET_XDP_BATCH)
+#define XDP_BIND_RETRIES 1000
+
+typedef struct xdp_ring {
+    _Atomic uint32_t    *producer;
+    _Atomic uint32_t    *consumer;
+    _Atomic uint32_t    *flags;
+    void                *descs;
+    uint32_t            mask;
+    uint32_t            size;
+    uint32_t            cached;     /**< Our producer index, or our consumer index on rings we read. */
+    void                *map;
+    size_t              map_len;
+} xdp_ring_t;
+
+struct ttak_net_xdp {
+    int                 fd;
+    uint32_t            queue_id;
+    bool                copy_mode;
+
+    void                *umem_block;    /**< Buddy block; umem is its first page boundary. */
+    uint8_t             *umem;
+    uint32_t            frame_size;
+    uint32_t            frame_count;
+
+    ttak_mutex_t        rx_lock;        /**< Guards rx and fill. */
+    xdp_ring_t          fill;
+    xdp_ring_t          rx;
+    ttak_mutex_t        tx_lock;        /**< Guards tx, comp and the free stack. */
+    xdp_ring_t          tx;
+    xdp_ring_t          comp;
+    uint64_t            *free_frames;
+    uint32_t            free_count;
+
+    int                 map_fd;         /**< Socket map this socket is entered in; -1 if none. */
+    bool                owns_map;       /**< Map created here rather than borrowed from a shared socket. */
+    bool                mapped;         /**< Entry for queue_id present in map_fd. */
+    int                 prog_fd;
+    int                 link_fd;
+
+    pthread_t           worker;
+    bool                worker_running;
+    atomic_bool         worker_stop;
+    ttak_net_lattice_t  *worker_lat;
+    uint32_t            worker_tid;
+
+    _Atomic uint64_t    rx_frames;
+    _Atomic uint64_t    rx_dropped;
+    _Atomic uint64_t    tx_frames;
+    _Atomic uint64_t    tx_completed;
+};
+
+/* Open sockets by descriptor, for the driver vtable. */
+static _Atomic(ttak_net_xdp_t *) xdp_sockets[TTAK_NET_XDP_MAX_QUEUES];
+
+static ttak_net_xdp_t *xdp_lookup(int fd) {
+    if (fd < 0) return NULL;
+    for (size_t i = 0; i < TTAK_NET_XDP_MAX_QUEUES; i++) {
+        ttak_net_xdp_t *x = atomic_load_explicit(&xdp_sockets[i], memory_order_acquire);
+        if (x && x->fd == fd) return x;
+    }
+    return NULL;
+}
+
+static bool xdp_register(ttak_net_xdp_t *xdp) {
+    for (size_t i = 0; i < TTAK_NET_XDP_MAX_QUEUES; i++) {
+        ttak_net_xdp_t *expected = NULL;
+        if (atomic_compare_exchange_strong(&xdp_sockets[i], &expected, xdp)) return true;
+    }
+    return false;
+}
+
+static void xdp_unregister(ttak_net_xdp_t *xdp) {
+    for (size_t i = 0; i < TTAK_NET_XDP_MAX_QUEUES; i++) {
+        ttak_net_xdp_t *expected = xdp;
+        if (atomic_compare_exchange_strong(&xdp_sockets[i], &expected, NULL)) return;
+    }
+}
+
+static long xdp_bpf(int cmd, union bpf_attr *attr) {
+    return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+static uint32_t round_pow2(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+/* ---- Rings ---- */
+
+/* Entries ready on a ring the kernel produces. */
+static uint32_t ring_ready(const xdp_ring_t *r) {
+    return atomic_load_explicit(r->producer, memory_order_acquire) - r->cached;
+}
+
+/* Entries free on a ring we produce. */
+static uint32_t ring_space(const xdp_ring_t *r) {
+    return r->size - (r->cached - atomic_load_explicit(r->consumer, memory_order_acquire));
+}
+
+static void ring_release(xdp_ring_t *r, uint32_t n) {
+    r->cached += n;
+    atomic_store_explicit(r->consumer, r->cached, memory_order_release);
+}
+
+static void ring_submit(xdp_ring_t *r, uint32_t n) {
+    r->cached += n;
+    atomic_store_explicit(r->producer, r->cached, memory_order_release);
+}
+
+static bool ring_needs_wakeup(const xdp_ring_t *r) {
+    return (atomic_load_explicit(r->flags, memory_order_relaxed) & XDP_RING_NEED_WAKEUP) != 0;
+}
+
+static bool ring_map(int fd, xdp_ring_t *r, const struct xdp_ring_offset *off, uint32_t size,
+                     size_t elem, off_t pgoff, bool produced_by_us) {
+    r->map_len = off->desc + (size_t)size * elem;
+    void *map = mmap(NULL, r->map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, pgoff);
+    if (map == MAP_FAILED) return false;
+    uint8_t *base = map;
+    r->map = map;
+    r->producer = (_Atomic uint32_t *)(void *)(base + off->producer);
+    r->consumer = (_Atomic uint32_t *)(void *)(base + off->consumer);
+    r->flags = (_Atomic uint32_t *)(void *)(base + off->flags);
+    r->descs = base + off->desc;
+    r->size = size;
+    r->mask = size - 1U;
+    r->cached = produced_by_us ? atomic_load(r->producer) : atomic_load(r->consumer);
+    return true;
+}
+
+static void ring_unmap(xdp_ring_t *r) {
+    if (r->map) munmap(r->map, r->map_len);
+    r->map = NULL;
+}
+
+/* ---- Receive side; callers hold rx_lock ---- */
+
+static void fill_post(ttak_net_xdp_t *xdp, const uint64_t *addrs, uint32_t n) {
+    uint64_t *ring = xdp->fill.descs;
+    uint32_t space = ring_space(&xdp->fill);
+    if (n > space) n = space;
+    for (uint32_t i = 0; i < n; i++) {
+        ring[(xdp->fill.cached + i) & xdp->fill.mask] = addrs[i];
+    }
+    ring_submit(&xdp->fill, n);
+    if (ring_needs_wakeup(&xdp->fill)) (void)recvfrom(xdp->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+}
+
+/*
+ * Copies up to TTAK_NET_XDP_BATCH ready descriptors out, and their frames'
+ * base addresses into @p frames; the frames stay ours until rx_finish().
+ */
+static uint32_t rx_take(ttak_net_xdp_t *xdp, struct xdp_desc *out, uint64_t *frames, uint32_t max) {
+    uint32_t n = ring_ready(&xdp->rx);
+    if (n > max) n = max;
+    if (n > TTAK_NET_XDP_BATCH) n = TTAK_NET_XDP_BATCH;
+    const struct xdp_desc *ring = xdp->rx.descs;
+    uint64_t frame_mask = ~(uint64_t)(xdp->frame_size - 1U);
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = ring[(xdp->rx.cached + i) & xdp->rx.mask];
+        frames[i] = out[i].addr & frame_mask;
+    }
+    return n;
+}
+
+/* Gives the taken frames back to the fill ring. */
+static void rx_finish(ttak_net_xdp_t *xdp, uint64_t *addrs, uint32_t n) {
+    ring_release(&xdp->rx, n);
+    fill_post(xdp, addrs, n);
+    atomic_fetch_add_explicit(&xdp->rx_frames, n, memory_order_relaxed);
+}
+
+static size_t xdp_rx_lattice(ttak_net_xdp_t *xdp, ttak_net_lattice_t *lat, uint32_t tid,
+                             size_t budget, uint64_t now, uint32_t *taken) {
+    struct xdp_desc descs[TTAK_NET_XDP_BATCH];
+    uint64_t frames[TTAK_NET_XDP_BATCH];
+    ttak_net_lattice_msg_t msgs[TTAK_NET_XDP_BATCH];
+    uint32_t max = budget < TTAK_NET_XDP_BATCH ? (uint32_t)budget : TTAK_NET_XDP_BATCH;
+
+    ttak_mutex_lock(&xdp->rx_lock);
+    uint32_t n = rx_take(xdp, descs, frames, max);
+    for (uint32_t i = 0; i < n; i++) {
+        msgs[i].data = xdp->umem + descs[i].addr;
+        msgs[i].len = descs[i].len;
+    }
+    // A refused frame ends a batch; skip it and hand the rest over.
+    size_t written = 0, dropped = 0;
+    for (size_t i = 0; i < n;) {
+        size_t w = ttak_net_lattice_write_batch(lat, tid, msgs + i, n - i, now);
+        written += w;
+        i += w;
+        if (i < n) {
+            dropped++;
+            i++;
+        }
+    }
+    rx_finish(xdp, frames, n);
+    ttak_mutex_unlock(&xdp->rx_lock);
+
+    if (dropped) atomic_fetch_add_explicit(&xdp->rx_dropped, dropped, memory_order_relaxed);
+    if (taken) *taken = n;
+    return written;
+}
+
+/* ---- Transmit side; callers hold tx_lock ---- */
+
+static void tx_reap(ttak_net_xdp_t *xdp) {
+    uint32_t n = ring_ready(&xdp->comp);
+    const uint64_t *ring = xdp->comp.descs;
+    for (uint32_t i = 0; i < n; i++) {
+        xdp->free_frames[xdp->free_count++] = ring[(xdp->comp.cached + i) & xdp->comp.mask];
+    }
+    ring_release(&xdp->comp, n);
+    if (n) atomic_fetch_add_explicit(&xdp->tx_completed, n, memory_order_relaxed);
+}
+
+static void tx_kick(ttak_net_xdp_t *xdp) {
+    // Copy mode has no driver NAPI to pick the ring up; it always needs the syscall.
+    if (xdp->copy_mode || ring_needs_wakeup(&xdp->tx)) {
+        (void)sendto(xdp->fd, NULL, 0, MSG_DONTWAIT, NULL, 0);
+    }
+}
+
+static int xdp_send_batch(ttak_net_xdp_t *xdp, ttak_net_msg_t *msgs, size_t n) {
+    ttak_mutex_lock(&xdp->tx_lock);
+    tx_reap(xdp);
+    if (xdp->free_count == 0 && n > 0) {
+        tx_kick(xdp);
+        tx_reap(xdp);
+    }
+    uint32_t max = ring_space(&xdp->tx);
+    if (max > xdp->free_count) max = xdp->free_count;
+    struct xdp_desc *ring = xdp->tx.descs;
+    uint32_t sent = 0;
+    int err = EAGAIN;
+    while (sent < max && sent < n) {
+        ttak_net_msg_t *m = &msgs[sent];
+        if (m->len > xdp->frame_size) {
+            err = EMSGSIZE;
+            break;
+        }
+        uint64_t addr = xdp->free_frames[--xdp->free_count];
+        memcpy(xdp->umem + addr, m->buf, m->len);
+        struct xdp_desc *d = &ring[(xdp->tx.cached + sent) & xdp->tx.mask];
+        d->addr = addr;
+        d->len = (uint32_t)m->len;
+        d->options = 0;
+        m->bytes = m->len;
+        sent++;
+    }
+    if (sent) {
+        ring_submit(&xdp->tx, sent);
+        tx_kick(xdp);
+        atomic_fetch_add_explicit(&xdp->tx_frames, sent, memory_order_relaxed);
+    }
+    ttak_mutex_unlock(&xdp->tx_lock);
+    if (sent == 0 && n > 0) {
+        errno = err;
+        return -1;
+    }
+    return (int)sent;
+}
+
+static int xdp_recv_batch(ttak_net_xdp_t *xdp, ttak_net_msg_t *msgs, size_t n, int flags) {
+    if (n == 0) return 0;
+    struct xdp_desc descs[TTAK_NET_XDP_BATCH];
+    uint64_t frames[TTAK_NET_XDP_BATCH];
+    uint32_t max = n < TTAK_NET_XDP_BATCH ? (uint32_t)n : TTAK_NET_XDP_BATCH;
+    for (;;) {
+        ttak_mutex_lock(&xdp->rx_lock);
+        uint32_t got = rx_take(xdp, descs, frames, max);
+        for (uint32_t i = 0; i < got; i++) {
+            ttak_net_msg_t *m = &msgs[i];
+            size_t copy = descs[i].len < m->len ? descs[i].len : m->len;
+            memcpy(m->buf, xdp->umem + descs[i].addr, copy);
+            m->bytes = copy;
+            m->addr_len = 0;
+            m->gso_size = 0;
+            m->flags = copy < descs[i].len ? MSG_TRUNC : 0;
+        }
+        rx_finish(xdp, frames, got);
+        ttak_mutex_unlock(&xdp->rx_lock);
+        if (got) return (int)got;
+        if (flags & MSG_DONTWAIT) break;
+        struct pollfd pfd = { .fd = xdp->fd, .events = POLLIN };
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) return -1;
+    }
+    errno = EAGAIN;
+    return -1;
+}
+
+/* ---- Program ---- */
+
+static bool xdp_attach_program(ttak_net_xdp_t *xdp, int ifindex, bool native) {
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(uint32_t);
+    attr.max_entries = TTAK_NET_XDP_MAX_QUEUES;
+    xdp->map_fd = (int)xdp_bpf(BPF_MAP_CREATE, &attr);
+    if (xdp->map_fd < 0) return false;
+    xdp->owns_map = true;
+
+    // return bpf_redirect_map(&map, ctx->rx_queue_index, XDP_PASS);
+    struct bpf_insn prog[] = {
+        { .code = BPF_LDX | BPF_W | BPF_MEM, .dst_reg = BPF_REG_2, .src_reg = BPF_REG_1,
+          .off = (int16_t)offsetof(struct xdp_md, rx_queue_index) },
+        { .code = BPF_LD | BPF_DW | BPF_IMM, .dst_reg = BPF_REG_1, .src_reg = BPF_PSEUDO_MAP_FD,
+          .imm = xdp->map_fd },
+        { .code = 0 },
+        { .code = BPF_ALU64 | BPF_MOV | BPF_K, .dst_reg = BPF_REG_3, .imm = XDP_PASS },
+        { .code = BPF_JMP | BPF_CALL, .imm = BPF_FUNC_redirect_map },
+        { .code = BPF_JMP | BPF_EXIT },
+    };
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insns = (uint64_t)(uintptr_t)prog;
+    attr.insn_cnt = (uint32_t)(sizeof(prog) / sizeof(prog[0]));
+    attr.license = (uint64_t)(uintptr_t)"GPL";
+    xdp->prog_fd = (int)xdp_bpf(BPF_PROG_LOAD, &attr);
+    if (xdp->prog_fd < 0) return false;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.link_create.prog_fd = (uint32_t)xdp->prog_fd;
+    attr.link_create.target_ifindex = (uint32_t)ifindex;
+    attr.link_create.attach_type = BPF_XDP;
+    attr.link_create.flags = native ? XDP_FLAGS_DRV : XDP_FLAGS_SKB;
+    xdp->link_fd = (int)xdp_bpf(BPF_LINK_CREATE, &attr);
+    return xdp->link_fd >= 0;
+}
+
+static bool xdp_map_insert(int map_fd, uint32_t queue_id, int fd) {
+    uint32_t key = queue_id;
+    uint32_t value = (uint32_t)fd;
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_fd = (uint32_t)map_fd;
+    attr.key = (uint64_t)(uintptr_t)&key;
+    attr.value = (uint64_t)(uintptr_t)&value;
+    return xdp_bpf(BPF_MAP_UPDATE_ELEM, &attr) == 0;
+}
+
+static void xdp_map_remove(int map_fd, uint32_t queue_id) {
+    uint32_t key = queue_id;
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_fd = (uint32_t)map_fd;
+    attr.key = (uint64_t)(uintptr_t)&key;
+    (void)xdp_bpf(BPF_MAP_DELETE_ELEM, &attr);
+}
+
+/* ---- Lifecycle ---- */
+
+static void xdp_free(ttak_net_xdp_t *xdp) {
+    if (xdp->mapped) xdp_map_remove(xdp->map_fd, xdp->queue_id);
+    if (xdp->link_fd >= 0) close(xdp->link_fd);
+    if (xdp->prog_fd >= 0) close(xdp->prog_fd);
+    if (xdp->owns_map) close(xdp->map_fd);
+    ring_unmap(&xdp->fill);
+    ring_unmap(&xdp->rx);
+    ring_unmap(&xdp->tx);
+    ring_unmap(&xdp->comp);
+    if (xdp->fd >= 0) close(xdp->fd);
+    if (xdp->umem_block) ttak_mem_buddy_free(xdp->umem_block);
+    free(xdp->free_frames);
+    ttak_mutex_destroy(&xdp->rx_lock);
+    ttak_mutex_destroy(&xdp->tx_lock);
+    free(xdp);
+}
+
+static bool xdp_setup_umem(ttak_net_xdp_t *xdp) {
+    size_t bytes = (size_t)xdp->frame_count * xdp->frame_size;
+    ttak_mem_req_t req = { .size_bytes = bytes + XDP_PAGE, .priority = TTAK_PRIORITY_BEST_FIT };
+    xdp->umem_block = ttak_mem_buddy_alloc(&req);
+    if (!xdp->umem_block) {
+        errno = ENOMEM;
+        return false;
+    }
+    uintptr_t base = ((uintptr_t)xdp->umem_block + XDP_PAGE - 1U) & ~(uintptr_t)(XDP_PAGE - 1U);
+    xdp->umem = (uint8_t *)base;
+
+    struct xdp_umem_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.addr = (uint64_t)base;
+    reg.len = bytes;
+    reg.chunk_size = xdp->frame_size;
+    if (setsockopt(xdp->fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) != 0) return false;
+
+    uint32_t ring = xdp->frame_count / 2U;
+    return setsockopt(xdp->fd, SOL_XDP, XDP_UMEM_FILL_RING, &ring, sizeof(ring)) == 0 &&
+           setsockopt(xdp->fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &ring, sizeof(ring)) == 0 &&
+           setsockopt(xdp->fd, SOL_XDP, XDP_RX_RING, &ring, sizeof(ring)) == 0 &&
+           setsockopt(xdp->fd, SOL_XDP, XDP_TX_RING, &ring, sizeof(ring)) == 0;
+}
+
+static bool xdp_setup_rings(ttak_net_xdp_t *xdp) {
+    struct xdp_mmap_offsets off;
+    socklen_t len = sizeof(off);
+    if (getsockopt(xdp->fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &len) != 0) return false;
+    uint32_t ring = xdp->frame_count / 2U;
+    if (!ring_map(xdp->fd, &xdp->fill, &off.fr, ring, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING, true) ||
+        !ring_map(xdp->fd, &xdp->comp, &off.cr, ring, sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING, false) ||
+        !ring_map(xdp->fd, &xdp->rx, &off.rx, ring, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING, false) ||
+        !ring_map(xdp->fd, &xdp->tx, &off.tx, ring, sizeof(struct xdp_desc), XDP_PGOFF_TX_RING, true)) {
+        return false;
+    }
+
+    // First half of the UMEM feeds receive, second half transmit.
+    uint64_t *fill = xdp->fill.descs;
+    for (uint32_t i = 0; i < ring; i++) fill[(xdp->fill.cached + i) & xdp->fill.mask] = (uint64_t)i * xdp->frame_size;
+    ring_submit(&xdp->fill, ring);
+    xdp->free_frames = malloc(sizeof(uint64_t) * ring);
+    if (!xdp->free_frames) return false;
+    for (uint32_t i = 0; i < ring; i++) xdp->free_frames[i] = (uint64_t)(ring + i) * xdp->frame_size;
+    xdp->free_count = ring;
+    return true;
+}
+
+ttak_net_xdp_t *ttak_net_xdp_open(const ttak_net_xdp_config_t *cfg, uint64_t now) {
+    (void)now;
+    if (!cfg || !cfg->ifname || cfg->queue_id >= TTAK_NET_XDP_MAX_QUEUES) {
+        errno = EINVAL;
+        return NULL;
+    }
+    uint32_t frame_size = cfg->frame_size ? cfg->frame_size : TTAK_NET_XDP_DEFAULT_FRAME_SIZE;
+    if (frame_size != 2048U && frame_size != 4096U) {
+        errno = EINVAL;
+        return NULL;
+    }
+    int ifindex = (int)if_nametoindex(cfg->ifname);
+    if (ifindex == 0) return NULL;
+
+    ttak_net_xdp_t *xdp = calloc(1, sizeof(*xdp));
+    if (!xdp) return NULL;
+    xdp->fd = -1;
+    xdp->map_fd = xdp->prog_fd = xdp->link_fd = -1;
+    xdp->queue_id = cfg->queue_id;
+    xdp->frame_size = frame_size;
+    uint32_t frames = cfg->frame_count ? cfg->frame_count : TTAK_NET_XDP_DEFAULT_FRAMES;
+    xdp->frame_count = round_pow2(frames < XDP_MIN_FRAMES ? XDP_MIN_FRAMES : frames);
+    ttak_mutex_init(&xdp->rx_lock);
+    ttak_mutex_init(&xdp->tx_lock);
+
+    xdp->fd = socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+    bool ok = xdp->fd >= 0 && xdp_setup_umem(xdp) && xdp_setup_rings(xdp);
+    if (ok) {
+        struct sockaddr_xdp sxdp;
+        memset(&sxdp, 0, sizeof(sxdp));
+        sxdp.sxdp_family = AF_XDP;
+        sxdp.sxdp_ifindex = (uint32_t)ifindex;
+        sxdp.sxdp_queue_id = cfg->queue_id;
+        sxdp.sxdp_flags = XDP_USE_NEED_WAKEUP | (cfg->zerocopy ? XDP_ZEROCOPY : XDP_COPY);
+        xdp->copy_mode = !cfg->zerocopy;
+        // The kernel releases a previous socket's UMEM on the queue from a workqueue.
+        for (int tries = 0; !(ok = bind(xdp->fd, (struct sockaddr *)&sxdp, sizeof(sxdp)) == 0) &&
+                            errno == EBUSY && tries < XDP_BIND_RETRIES; tries++) {
+            usleep(1000);
+        }
+    }
+    if (ok && cfg->share) {
+        xdp->map_fd = cfg->share->map_fd;
+        ok = xdp->map_fd >= 0;
+    } else if (ok && !cfg->no_program) {
+        ok = xdp_attach_program(xdp, ifindex, cfg->native);
+    }
+    if (ok && xdp->map_fd >= 0) {
+        ok = xdp->mapped = xdp_map_insert(xdp->map_fd, cfg->queue_id, xdp->fd);
+    }
+    if (ok && !xdp_register(xdp)) {
+        errno = EMFILE;
+        ok = false;
+    }
+    if (!ok) {
+        int err = errno;
+        xdp_free(xdp);
+        errno = err;
+        return NULL;
+    }
+    return xdp;
+}
+
+void ttak_net_xdp_close(ttak_net_xdp_t *xdp) {
+    if (!xdp) return;
+    ttak_net_xdp_stop_worker(xdp);
+    xdp_unregister(xdp);
+    xdp_free(xdp);
+}
+
+int ttak_net_xdp_fd(const ttak_net_xdp_t *xdp) {
+    return xdp ? xdp->fd : -1;
+}
+
+size_t ttak_net_xdp_rx_to_lattice(ttak_net_xdp_t *xdp,
+                                  ttak_net_lattice_t *lat,
+                                  uint32_t tid,
+                                  size_t budget,
+                                  uint64_t now) {
+    if (!xdp || !lat || budget == 0) return 0;
+    return xdp_rx_lattice(xdp, lat, tid, budget, now, NULL);
+}
+
+static void *xdp_worker_main(void *arg) {
+    ttak_net_xdp_t *xdp = arg;
+    while (!atomic_load_explicit(&xdp->worker_stop, memory_order_acquire)) {
+        uint32_t taken = 0;
+        xdp_rx_lattice(xdp, xdp->worker_lat, xdp->worker_tid, TTAK_NET_XDP_BATCH, ttak_get_tick_count(), &taken);
+        if (taken == 0) {
+            // Drives NAPI busy polling when SO_PREFER_BUSY_POLL is set.
+            (void)recvfrom(xdp->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+int ttak_net_xdp_start_worker(ttak_net_xdp_t *xdp, ttak_net_lattice_t *lat, uint32_t tid) {
+    if (!xdp || !lat) return EINVAL;
+    if (xdp->worker_running) return EBUSY;
+    xdp->worker_lat = lat;
+    xdp->worker_tid = tid;
+    atomic_store(&xdp->worker_stop, false);
+    int rc = pthread_create(&xdp->worker, NULL, xdp_worker_main, xdp);
+    xdp->worker_running = rc == 0;
+    return rc;
+}
+
+void ttak_net_xdp_stop_worker(ttak_net_xdp_t *xdp) {
+    if (!xdp || !xdp->worker_running) return;
+    atomic_store_explicit(&xdp->worker_stop, true, memory_order_release);
+    pthread_join(xdp->worker, NULL);
+    xdp->worker_running = false;
+}
+
+void ttak_net_xdp_stats(const ttak_net_xdp_t *xdp, ttak_net_xdp_stats_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!xdp) return;
+    out->rx_frames = atomic_load_explicit(&xdp->rx_frames, memory_order_relaxed);
+    out->rx_dropped = atomic_load_explicit(&xdp->rx_dropped, memory_order_relaxed);
+    out->tx_frames = atomic_load_explicit(&xdp->tx_frames, memory_order_relaxed);
+    out->tx_completed = atomic_load_explicit(&xdp->tx_completed, memory_order_relaxed);
+}
+
+/* ---- Driver vtable ---- */
+
+static int xdp_op_open(int domain, int type, int protocol) {
+    (void)domain; (void)type; (void)protocol;
+    errno = ENOTSUP;
+    return -1;
+}
+static int xdp_op_close(int fd) {
+    ttak_net_xdp_t *xdp = xdp_lookup(fd);
+    if (!xdp) return close(fd);
+    ttak_net_xdp_close(xdp);
+    return 0;
+}
+static int xdp_op_addr(int fd, const void *addr, size_t len) {
+    (void)fd; (void)addr; (void)len;
+    errno = ENOTSUP;
+    return -1;
+}
+static int xdp_op_listen(int fd, int backlog) {
+    (void)fd; (void)backlog;
+    errno = ENOTSUP;
+    return -1;
+}
+static int xdp_op_setopt(int fd, int opt, const void *val, size_t len) {
+    (void)fd; (void)opt; (void)val; (void)len;
+    errno = ENOTSUP;
+    return -1;
+}
+static int xdp_op_sendmmsg(int fd, ttak_net_msg_t *msgs, size_t n, int flags) {
+    (void)flags;
+    ttak_net_xdp_t *xdp = xdp_lookup(fd);
+    if (!xdp || (!msgs && n > 0)) {
+        errno = EBADF;
+        return -1;
+    }
+    return xdp_send_batch(xdp, msgs, n);
+}
+static int xdp_op_recvmmsg(int fd, ttak_net_msg_t *msgs, size_t n, int flags) {
+    ttak_net_xdp_t *xdp = xdp_lookup(fd);
+    if (!xdp || (!msgs && n > 0)) {
+        errno = EBADF;
+        return -1;
+    }
+    return xdp_recv_batch(xdp, msgs, n, flags);
+}
+static int xdp_op_send(int fd, const void *buf, size_t len) {
+    ttak_net_msg_t m = { .buf = (void *)buf, .len = len };
+    int rc = xdp_op_sendmmsg(fd, &m, 1, 0);
+    return rc == 1 ? (int)m.bytes : -1;
+}
+static int xdp_op_recv(int fd, void *buf, size_t len) {
+    ttak_net_msg_t m = { .buf = buf, .len = len };
+    int rc = xdp_op_recvmmsg(fd, &m, 1, 0);
+    return rc == 1 ? (int)m.bytes : -1;
+}
+static int xdp_op_poll(int fd, uint32_t events, int timeout_ms) {
+    struct pollfd pfd = { .fd = fd, .events = (short)events };
+    return poll(&pfd, 1, timeout_ms);
+}
+static int xdp_op_offload(int fd, const ttak_net_offload_t *cfg) {
+    if (!cfg) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (cfg->udp_gro) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    int on = 1;
+    int us = (int)cfg->busy_poll_us;
+    int budget = (int)cfg->busy_poll_budget;
+    if (cfg->busy_poll_us && setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &us, sizeof(us)) != 0) return -1;
+    if (cfg->busy_poll_budget && setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &budget, sizeof(budget)) != 0) return -1;
+    if (cfg->prefer_busy_poll && setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &on, sizeof(on)) != 0) return -1;
+    return 0;
+}
+
+void ttak_net_xdp_driver_ops(ttak_net_driver_ops_t *ops) {
+    if (!ops) return;
+    ops->socket_open = xdp_op_open;
+    ops->socket_close = xdp_op_close;
+    ops->socket_bind = xdp_op_addr;
+    ops->socket_listen = xdp_op_listen;
+    ops->socket_connect = xdp_op_addr;
+    ops->socket_send = xdp_op_send;
+    ops->socket_recv = xdp_op_recv;
+    ops->socket_setopt = xdp_op_setopt;
+    ops->poll_wait = xdp_op_poll;
+    ops->socket_sendmmsg = xdp_op_sendmmsg;
+    ops->socket_recvmmsg = xdp_op_recvmmsg;
+    ops->socket_offload = xdp_op_offload;
+}
+
+#else
+
+static int xdp_unsupported(void) {
+    errno = ENOTSUP;
+    return -1;
+}
+static int xdp_stub_open(int a, int b, int c) { (void)a; (void)b; (void)c; return xdp_unsupported(); }
+static int xdp_stub_close(int fd) { (void)fd; return xdp_unsupported(); }
+static int xdp_stub_addr(int fd, const void *p, size_t n) { (void)fd; (void)p; (void)n; return xdp_unsupported(); }
+static int xdp_stub_listen(int fd, int b) { (void)fd; (void)b; return xdp_unsupported(); }
+static int xdp_stub_send(int fd, const void *p, size_t n) { (void)fd; (void)p; (void)n; return xdp_unsupported(); }
+static int xdp_stub_recv(int fd, void *p, size_t n) { (void)fd; (void)p; (void)n; return xdp_unsupported(); }
+static int xdp_stub_setopt(int fd, int o, const void *p, size_t n) { (void)fd; (void)o; (void)p; (void)n; return xdp_unsupported(); }
+static int xdp_stub_poll(int fd, uint32_t e, int t) { (void)fd; (void)e; (void)t; return xdp_unsupported(); }
+static int xdp_stub_mmsg(int fd, ttak_net_msg_t *m, size_t n, int f) { (void)fd; (void)m; (void)n; (void)f; return xdp_unsupported(); }
+static int xdp_stub_offload(int fd, const ttak_net_offload_t *c) { (void)fd; (void)c; return xdp_unsupported(); }
+
+ttak_net_xdp_t *ttak_net_xdp_open(const ttak_net_xdp_config_t *cfg, uint64_t now) {
+    (void)cfg;
+    (void)now;
+    errno = ENOTSUP;
+    return NULL;
+}
+
+void ttak_net_xdp_close(ttak_net_xdp_t *xdp) { (void)xdp; }
+
+int ttak_net_xdp_fd(const ttak_net_xdp_t *xdp) {
+    (void)xdp;
+    return -1;
+}
+
+size_t ttak_net_xdp_rx_to_lattice(ttak_net_xdp_t *xdp, ttak_net_lattice_t *lat, uint32_t tid, size_t budget,
+                                  uint64_t now) {
+    (void)xdp; (void)lat; (void)tid; (void)budget; (void)now;
+    return 0;
+}
+
+int ttak_net_xdp_start_worker(ttak_net_xdp_t *xdp, ttak_net_lattice_t *lat, uint32_t tid) {
+    (void)xdp; (void)lat; (void)tid;
+    return ENOTSUP;
+}
+
+void ttak_net_xdp_stop_worker(ttak_net_xdp_t *xdp) { (void)xdp; }
+
+void ttak_net_xdp_stats(const ttak_net_xdp_t *xdp, ttak_net_xdp_stats_t *out) {
+    (void)xdp;
+    if (out) memset(out, 0, sizeof(*out));
+}
+
+void ttak_net_xdp_driver_ops(ttak_net_driver_ops_t *ops) {
+    if (!ops) return;
+    ops->socket_open = xdp_stub_open;
+    ops->socket_close = xdp_stub_close;
+    ops->socket_bind = xdp_stub_addr;
+    ops->socket_listen = xdp_stub_listen;
+    ops->socket_connect = xdp_stub_addr;
+    ops->socket_send = xdp_stub_send;
+    ops->socket_recv = xdp_stub_recv;
+    ops->socket_setopt = xdp_stub_setopt;
+    ops->poll_wait = xdp_stub_poll;
+    ops->socket_sendmmsg = xdp_stub_mmsg;
+    ops->socket_recvmmsg = xdp_stub_mmsg;
+    ops->socket_offload = xdp_stub_offload;
+}
+
+#endif
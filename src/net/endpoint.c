@@ -4,7 +4,9 @@
  *
  * Wraps a raw socket fd inside a reference-counted shared handle with TTL
  * guard and optional restart hooks for client/server roles.  All operations
- * require a valid ttak_owner_t to enforce epoch-safe access.
+ * require a valid ttak_owner_t to enforce epoch-safe access.  Batch send and
+ * receive go through the driver vtable on a guard snapshot, so the shared
+ * handle is not held across the syscall.
  */
 
 #include <ttak/net/endpoint.h>
@@ -14,6 +16,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <pthread.h>
+#include <sched.h>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -26,7 +29,10 @@
 #include <unistd.h>
 #endif
 #include <ttak/net/core/port.h>
-#include <ttak/net/core/port.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mask/dynamic_mask.h>
+
+#include <errno.h>
 
 static ttak_io_status_t ttak_net_endpoint_restart_client(ttak_net_endpoint_t *payload, uint64_t now);
 static ttak_io_status_t ttak_net_endpoint_restart_server(ttak_net_endpoint_t *payload, uint64_t now);
@@ -38,35 +44,13 @@ static void endpoint_port_bootstrap(void) {
     ttak_net_driver_detect(&endpoint_ops, &endpoint_os, NULL);
 }
 
-ttak_shared_net_endpoint_t *ttak_net_endpoint_create(ttak_owner_t *owner, uint64_t now) {
-    if (!owner) return NULL;
-    pthread_once(&endpoint_port_once, endpoint_port_bootstrap);
-    ttak_shared_net_endpoint_t *shared = malloc(sizeof(*shared));
-    if (!shared) return NULL;
-    memset(shared, 0, sizeof(*shared));
-    ttak_shared_init(&shared->base);
-    if (ttak_shared_net_endpoint_allocate(shared, TTAK_SHARED_LEVEL_3) != TTAK_OWNER_SUCCESS) {
-        ttak_shared_destroy(&shared->base);
-        free(shared);
-        return NULL;
-    }
-    if (shared->base.add_owner(&shared->base, owner) != TTAK_OWNER_SUCCESS) {
-        ttak_shared_destroy(&shared->base);
-        free(shared);
-        return NULL;
-    }
-
-    ttak_shared_result_t res = 0;
-    ttak_net_endpoint_t *payload = ttak_shared_net_endpoint_access(shared, owner, &res);
-    if (!payload || res != TTAK_OWNER_SUCCESS) {
-        ttak_shared_destroy(&shared->base);
-        free(shared);
-        return NULL;
-    }
-
-    memset(payload, 0, sizeof(*payload));
+/* Puts a payload into the state create() hands out, keeping the guard's last tag. */
+static void ttak_net_endpoint_payload_reset(ttak_net_endpoint_t *payload,
+                                            ttak_owner_t *owner,
+                                            uint64_t generation,
+                                            uint64_t now) {
     payload->fd = -1;
-    payload->generation_id = now;
+    payload->generation_id = generation;
     payload->type = TTAK_NET_ENDPOINT_IPV4;
     payload->domain = AF_UNSPEC;
     payload->socktype = SOCK_STREAM;
@@ -76,6 +60,14 @@ ttak_shared_net_endpoint_t *ttak_net_endpoint_create(ttak_owner_t *owner, uint64
     payload->listen_backlog = SOMAXCONN;
     payload->restart_ctx = NULL;
     payload->lattice = ttak_net_lattice_get_default();
+    if (payload->guard.owner != owner) {
+        payload->guard.resource_tag[0] = '\0';
+    }
+    if (payload->guard.wheel) {
+        ttak_timer_cancel(payload->guard.wheel, &payload->guard.ttl_timer);
+        payload->guard.wheel = NULL;
+    }
+    payload->guard.coarse_ns = 0;
     payload->guard.fd = -1;
     payload->guard.ttl_ns = 0;
     payload->guard.expires_at = now;
@@ -84,8 +76,43 @@ ttak_shared_net_endpoint_t *ttak_net_endpoint_create(ttak_owner_t *owner, uint64
     payload->guard.owner = owner;
     payload->addr.len = 0;
     memset(payload->addr.storage, 0, sizeof(payload->addr.storage));
+}
+
+/* Builds a fresh shared endpoint in @p shared, which the caller allocated. */
+static bool ttak_net_endpoint_setup(ttak_shared_net_endpoint_t *shared, ttak_owner_t *owner, uint64_t now) {
+    memset(shared, 0, sizeof(*shared));
+    ttak_shared_init(&shared->base);
+    if (ttak_shared_net_endpoint_allocate(shared, TTAK_SHARED_LEVEL_3) != TTAK_OWNER_SUCCESS) {
+        ttak_shared_destroy(&shared->base);
+        return false;
+    }
+    if (shared->base.add_owner(&shared->base, owner) != TTAK_OWNER_SUCCESS) {
+        ttak_shared_destroy(&shared->base);
+        return false;
+    }
+
+    ttak_shared_result_t res = 0;
+    ttak_net_endpoint_t *payload = ttak_shared_net_endpoint_access(shared, owner, &res);
+    if (!payload || res != TTAK_OWNER_SUCCESS) {
+        ttak_shared_destroy(&shared->base);
+        return false;
+    }
+
+    memset(payload, 0, sizeof(*payload));
+    ttak_net_endpoint_payload_reset(payload, owner, now, now);
     ttak_shared_net_endpoint_release(shared);
+    return true;
+}
 
+ttak_shared_net_endpoint_t *ttak_net_endpoint_create(ttak_owner_t *owner, uint64_t now) {
+    if (!owner) return NULL;
+    pthread_once(&endpoint_port_once, endpoint_port_bootstrap);
+    ttak_shared_net_endpoint_t *shared = malloc(sizeof(*shared));
+    if (!shared) return NULL;
+    if (!ttak_net_endpoint_setup(shared, owner, now)) {
+        free(shared);
+        return NULL;
+    }
     return shared;
 }
 
@@ -100,6 +127,130 @@ void ttak_net_endpoint_destroy(ttak_shared_net_endpoint_t *endpoint,
     free(endpoint);
 }
 
+/*
+ * Pool nodes start with the shared endpoint, so the pointer handed to
+ * callers is the node and ttak_net_endpoint_destroy() frees it as is.
+ */
+typedef struct ttak_net_endpoint_pool_node {
+    ttak_shared_net_endpoint_t shared;
+    struct ttak_net_endpoint_pool_node *next;
+    ttak_net_endpoint_pool_t *pool;
+    ttak_owner_t *bound;            /* Owner whose bit is set in the mask. */
+} ttak_net_endpoint_pool_node_t;
+
+static void ttak_net_endpoint_pool_push(ttak_net_endpoint_pool_t *pool, ttak_net_endpoint_pool_node_t *node) {
+    ttak_net_endpoint_pool_node_t *head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    do {
+        node->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&pool->head, &head, node,
+                                                    memory_order_release, memory_order_relaxed));
+    atomic_fetch_add_explicit(&pool->idle, 1, memory_order_relaxed);
+}
+
+/* Epoch cleanup: the release's grace period is over, so the node may be popped again. */
+static void ttak_net_endpoint_pool_repush(void *ptr) {
+    ttak_net_endpoint_pool_node_t *node = ptr;
+    ttak_net_endpoint_pool_t *pool = node->pool;
+    ttak_net_endpoint_pool_push(pool, node);
+    atomic_fetch_sub_explicit(&pool->deferred, 1, memory_order_release);
+}
+
+static ttak_net_endpoint_pool_node_t *ttak_net_endpoint_pool_pop(ttak_net_endpoint_pool_t *pool) {
+    ttak_epoch_enter();
+    ttak_net_endpoint_pool_node_t *head = atomic_load_explicit(&pool->head, memory_order_acquire);
+    while (head && !atomic_compare_exchange_weak_explicit(&pool->head, &head, head->next,
+                                                          memory_order_acquire, memory_order_acquire)) {
+    }
+    ttak_epoch_exit();
+    if (head) atomic_fetch_sub_explicit(&pool->idle, 1, memory_order_relaxed);
+    return head;
+}
+
+void ttak_net_endpoint_pool_init(ttak_net_endpoint_pool_t *pool, size_t max_idle) {
+    if (!pool) return;
+    atomic_init(&pool->head, NULL);
+    atomic_init(&pool->idle, 0);
+    atomic_init(&pool->deferred, 0);
+    pool->max_idle = max_idle ? max_idle : TTAK_NET_ENDPOINT_POOL_DEFAULT_IDLE;
+    atomic_init(&pool->created, 0);
+    atomic_init(&pool->reused, 0);
+}
+
+void ttak_net_endpoint_pool_destroy(ttak_net_endpoint_pool_t *pool, uint64_t now) {
+    if (!pool) return;
+    while (atomic_load_explicit(&pool->deferred, memory_order_acquire) > 0) {
+        ttak_epoch_reclaim();
+        if (atomic_load_explicit(&pool->deferred, memory_order_acquire) > 0) sched_yield();
+    }
+    ttak_net_endpoint_pool_node_t *node;
+    while ((node = ttak_net_endpoint_pool_pop(pool)) != NULL) {
+        ttak_net_endpoint_destroy(&node->shared, NULL, now);
+    }
+}
+
+/* Moves a recycled node to @p owner and resets its payload. */
+static bool ttak_net_endpoint_pool_rebind(ttak_net_endpoint_pool_node_t *node, ttak_owner_t *owner, uint64_t now) {
+    ttak_shared_t *base = &node->shared.base;
+    if (node->bound != owner) {
+        if (base->add_owner(base, owner) != TTAK_OWNER_SUCCESS) return false;
+        if (node->bound) ttak_dynamic_mask_clear(&base->owners_mask, node->bound->id);
+        node->bound = owner;
+    }
+    ttak_shared_result_t res = 0;
+    ttak_net_endpoint_t *payload = ttak_shared_net_endpoint_access(&node->shared, owner, &res);
+    if (!payload || res != TTAK_OWNER_SUCCESS) return false;
+    uint64_t generation = payload->generation_id + 1;
+    ttak_net_endpoint_payload_reset(payload, owner, generation > now ? generation : now, now);
+    ttak_shared_net_endpoint_release(&node->shared);
+    return true;
+}
+
+ttak_shared_net_endpoint_t *ttak_net_endpoint_pool_acquire(ttak_net_endpoint_pool_t *pool,
+                                                           ttak_owner_t *owner,
+                                                           uint64_t now) {
+    if (!pool || !owner) return NULL;
+    ttak_net_endpoint_pool_node_t *node = ttak_net_endpoint_pool_pop(pool);
+    if (node) {
+        if (ttak_net_endpoint_pool_rebind(node, owner, now)) {
+            atomic_fetch_add_explicit(&pool->reused, 1, memory_order_relaxed);
+            return &node->shared;
+        }
+        ttak_net_endpoint_destroy(&node->shared, NULL, now);
+    }
+
+    pthread_once(&endpoint_port_once, endpoint_port_bootstrap);
+    node = malloc(sizeof(*node));
+    if (!node) return NULL;
+    if (!ttak_net_endpoint_setup(&node->shared, owner, now)) {
+        free(node);
+        return NULL;
+    }
+    node->next = NULL;
+    node->pool = pool;
+    node->bound = owner;
+    atomic_fetch_add_explicit(&pool->created, 1, memory_order_relaxed);
+    return &node->shared;
+}
+
+void ttak_net_endpoint_pool_release(ttak_net_endpoint_pool_t *pool,
+                                    ttak_shared_net_endpoint_t *endpoint,
+                                    ttak_owner_t *owner,
+                                    uint64_t now) {
+    if (!endpoint) return;
+    ttak_net_endpoint_pool_node_t *node = (ttak_net_endpoint_pool_node_t *)endpoint;
+    if (owner) {
+        ttak_net_endpoint_close(endpoint, owner, now);
+    }
+    if (!pool || node->pool != pool ||
+        atomic_load_explicit(&pool->idle, memory_order_relaxed) +
+        atomic_load_explicit(&pool->deferred, memory_order_relaxed) >= pool->max_idle) {
+        ttak_net_endpoint_destroy(endpoint, NULL, now);
+        return;
+    }
+    atomic_fetch_add_explicit(&pool->deferred, 1, memory_order_relaxed);
+    ttak_epoch_retire(node, ttak_net_endpoint_pool_repush);
+}
+
 static ttak_io_status_t ttak_net_endpoint_access(ttak_shared_net_endpoint_t *endpoint,
                                                  ttak_owner_t *owner,
                                                  ttak_net_endpoint_t **out_ep,
@@ -153,7 +304,7 @@ ttak_io_status_t ttak_net_endpoint_bind_fd(ttak_shared_net_endpoint_t *endpoint,
         memcpy(payload->addr.storage, addr_bytes, addr_len);
     }
 
-    status = ttak_io_guard_init(&payload->guard, fd, owner, ttl_ns, now);
+    status = ttak_io_guard_rebind(&payload->guard, fd, owner, ttl_ns, now);
 
     ttak_shared_net_endpoint_release(endpoint);
     return status;
@@ -206,6 +357,21 @@ ttak_io_status_t ttak_net_endpoint_close(ttak_shared_net_endpoint_t *endpoint,
     return status;
 }
 
+ttak_io_status_t ttak_net_endpoint_set_coarse_ttl(ttak_shared_net_endpoint_t *endpoint,
+                                                  ttak_owner_t *owner,
+                                                  uint64_t window_ns,
+                                                  ttak_timer_wheel_t *wheel,
+                                                  uint64_t now) {
+    ttak_net_endpoint_t *payload = NULL;
+    ttak_io_status_t status = ttak_net_endpoint_access(endpoint, owner, &payload, now, false);
+    if (status != TTAK_IO_SUCCESS) {
+        return status;
+    }
+    status = ttak_io_guard_set_coarse(&payload->guard, window_ns, wheel);
+    ttak_shared_net_endpoint_release(endpoint);
+    return status;
+}
+
 ttak_io_status_t ttak_net_endpoint_snapshot_guard(ttak_shared_net_endpoint_t *endpoint,
                                                   ttak_owner_t *owner,
                                                   ttak_net_guard_snapshot_t *snapshot,
@@ -266,11 +432,11 @@ static ttak_io_status_t ttak_net_endpoint_restart_client(ttak_net_endpoint_t *pa
     ttak_io_guard_close(&payload->guard, now);
     payload->fd = fd;
     payload->generation_id++;
-    ttak_io_status_t status = ttak_io_guard_init(&payload->guard,
-                                                 fd,
-                                                 payload->guard.owner,
-                                                 payload->guard.ttl_ns,
-                                                 now);
+    ttak_io_status_t status = ttak_io_guard_rebind(&payload->guard,
+                                                   fd,
+                                                   payload->guard.owner,
+                                                   payload->guard.ttl_ns,
+                                                   now);
     if (status != TTAK_IO_SUCCESS) {
         endpoint_ops.socket_close(fd);
         payload->fd = -1;
@@ -300,11 +466,11 @@ static ttak_io_status_t ttak_net_endpoint_restart_server(ttak_net_endpoint_t *pa
     ttak_io_guard_close(&payload->guard, now);
     payload->fd = fd;
     payload->generation_id++;
-    ttak_io_status_t status = ttak_io_guard_init(&payload->guard,
-                                                 fd,
-                                                 payload->guard.owner,
-                                                 payload->guard.ttl_ns,
-                                                 now);
+    ttak_io_status_t status = ttak_io_guard_rebind(&payload->guard,
+                                                   fd,
+                                                   payload->guard.owner,
+                                                   payload->guard.ttl_ns,
+                                                   now);
     if (status != TTAK_IO_SUCCESS) {
         endpoint_ops.socket_close(fd);
         payload->fd = -1;
@@ -330,3 +496,70 @@ ttak_io_status_t ttak_net_endpoint_force_restart(ttak_shared_net_endpoint_t *end
     ttak_shared_net_endpoint_release(endpoint);
     return status;
 }
+
+static ttak_io_status_t ttak_net_endpoint_batch_status(void) {
+#ifdef _WIN32
+    return (WSAGetLastError() == WSAEWOULDBLOCK) ? TTAK_IO_ERR_NEEDS_RETRY : TTAK_IO_ERR_SYS_FAILURE;
+#else
+    return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+           ? TTAK_IO_ERR_NEEDS_RETRY
+           : TTAK_IO_ERR_SYS_FAILURE;
+#endif
+}
+
+static ttak_io_status_t ttak_net_endpoint_batch(ttak_shared_net_endpoint_t *endpoint,
+                                                ttak_owner_t *owner,
+                                                ttak_net_msg_t *msgs,
+                                                size_t n,
+                                                int flags,
+                                                size_t *done,
+                                                bool is_send,
+                                                uint64_t now) {
+    if (done) *done = 0;
+    if (!msgs && n > 0) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    pthread_once(&endpoint_port_once, endpoint_port_bootstrap);
+
+    ttak_net_guard_snapshot_t snap;
+    ttak_io_status_t status = ttak_net_endpoint_snapshot_guard(endpoint, owner, &snap, now);
+    if (status != TTAK_IO_SUCCESS) return status;
+    if (n == 0) return TTAK_IO_SUCCESS;
+
+    int rc = is_send ? endpoint_ops.socket_sendmmsg(snap.fd, msgs, n, flags)
+                     : endpoint_ops.socket_recvmmsg(snap.fd, msgs, n, flags);
+    if (rc < 0) return ttak_net_endpoint_batch_status();
+    if (done) *done = (size_t)rc;
+    return ttak_net_endpoint_guard_commit(&snap, now);
+}
+
+ttak_io_status_t ttak_net_endpoint_send_batch(ttak_shared_net_endpoint_t *endpoint,
+                                              ttak_owner_t *owner,
+                                              ttak_net_msg_t *msgs,
+                                              size_t n,
+                                              int flags,
+                                              size_t *sent,
+                                              uint64_t now) {
+    return ttak_net_endpoint_batch(endpoint, owner, msgs, n, flags, sent, true, now);
+}
+
+ttak_io_status_t ttak_net_endpoint_recv_batch(ttak_shared_net_endpoint_t *endpoint,
+                                              ttak_owner_t *owner,
+                                              ttak_net_msg_t *msgs,
+                                              size_t n,
+                                              int flags,
+                                              size_t *received,
+                                              uint64_t now) {
+    return ttak_net_endpoint_batch(endpoint, owner, msgs, n, flags, received, false, now);
+}
+
+ttak_io_status_t ttak_net_endpoint_set_offload(ttak_shared_net_endpoint_t *endpoint,
+                                               ttak_owner_t *owner,
+                                               const ttak_net_offload_t *cfg,
+                                               uint64_t now) {
+    if (!cfg) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    pthread_once(&endpoint_port_once, endpoint_port_bootstrap);
+
+    ttak_net_guard_snapshot_t snap;
+    ttak_io_status_t status = ttak_net_endpoint_snapshot_guard(endpoint, owner, &snap, now);
+    if (status != TTAK_IO_SUCCESS) return status;
+    return endpoint_ops.socket_offload(snap.fd, cfg) == 0 ? TTAK_IO_SUCCESS : TTAK_IO_ERR_SYS_FAILURE;
+}
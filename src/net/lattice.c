@@ -3,127 +3,41 @@
  * @brief Lock-free parallel ingress buffer using a 2-D slot lattice.
  *
  * Implements a 2-D slot lattice for zero-copy parallel packet ingress.
- * Contains architecture-specific inline assembly (x86-64, AArch64, RISC-V, PPC64)
- * for the TinyCC fast-copy path.
- * @warning Do not modify inline assembly blocks without testing all arches.
  */
 
 #include <ttak/net/lattice.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/fastpath.h>
 #include <ttak/mols_control.h>
 #include <ttak/atomic/atomic.h>
 #include <ttak/timing/timing.h>
-#include <ttak/types/ttak_compiler.h>
+#include <ttak/log/trace.h>
+#include <ttak/stats/metrics.h>
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <pthread.h>
 #include <stdatomic.h>
-
-#if defined(__TINYC__) && !TTAK_TINYCC_NEEDS_PORTABLE_FALLBACK
-static inline void ttak_net_lattice_copy_bytes(uint8_t *dst, const uint8_t *src, uint32_t len) {
-    if (!dst || !src || len == 0) {
-        return;
-    }
-#if defined(__x86_64__) || defined(_M_X64)
-    size_t cnt = len;
-    __asm__ __volatile__(
-        "rep movsb"
-        : "+D"(dst), "+S"(src), "+c"(cnt)
-        :
-        : "memory");
-#elif defined(__aarch64__)
-    register uint8_t *d = dst;
-    register const uint8_t *s = src;
-    register uint64_t n = len;
-    uint64_t tmp;
-    __asm__ __volatile__(
-        "cbz %w2, 2f\n"
-        "1:\n"
-        "ldrb %w3, [%1], #1\n"
-        "strb %w3, [%0], #1\n"
-        "subs %w2, %w2, #1\n"
-        "b.ne 1b\n"
-        "2:\n"
-        : "+r"(d), "+r"(s), "+r"(n), "=&r"(tmp)
-        :
-        : "memory");
-#elif defined(__riscv) && (__riscv_xlen == 64)
-    register uint8_t *d = dst;
-    register const uint8_t *s = src;
-    register uint64_t n = len;
-    unsigned long tmp;
-    __asm__ __volatile__(
-        "beqz %2, 2f\n"
-        "1:\n"
-        "lb %3, 0(%1)\n"
-        "addi %1, %1, 1\n"
-        "sb %3, 0(%0)\n"
-        "addi %0, %0, 1\n"
-        "addi %2, %2, -1\n"
-        "bnez %2, 1b\n"
-        "2:\n"
-        : "+r"(d), "+r"(s), "+r"(n), "=&r"(tmp)
-        :
-        : "memory");
-#elif defined(__powerpc64__) || defined(__ppc64__)
-    register uint8_t *d = dst;
-    register const uint8_t *s = src;
-    register uint64_t n = len;
-    unsigned long tmp;
-    __asm__ __volatile__(
-        "cmpdi %2, 0\n"
-        "beq 2f\n"
-        "1:\n"
-        "lbz %3, 0(%1)\n"
-        "addi %1, %1, 1\n"
-        "stb %3, 0(%0)\n"
-        "addi %0, %0, 1\n"
-        "addi %2, %2, -1\n"
-        "cmpdi %2, 0\n"
-        "bne 1b\n"
-        "2:\n"
-        : "+r"(d), "+r"(s), "+r"(n), "=&r"(tmp)
-        :
-        : "memory");
-#elif defined(__mips64) || defined(__mips64__) || (defined(__mips) && (__mips == 64))
-    register uint8_t *d = dst;
-    register const uint8_t *s = src;
-    register uint64_t n = len;
-    unsigned long tmp;
-    __asm__ __volatile__(
-        "beqz %2, 2f\n"
-        "1:\n"
-        "lbu %3, 0(%1)\n"
-        "daddi %1, %1, 1\n"
-        "sb %3, 0(%0)\n"
-        "daddi %0, %0, 1\n"
-        "daddi %2, %2, -1\n"
-        "bnez %2, 1b\n"
-        "2:\n"
-        : "+r"(d), "+r"(s), "+r"(n), "=&r"(tmp)
-        :
-        : "memory");
-#else
-    for (uint32_t i = 0; i < len; ++i) {
-        dst[i] = src[i];
-    }
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
 #endif
-}
-#elif defined(__TINYC__) && TTAK_TINYCC_NEEDS_PORTABLE_FALLBACK
-static inline void ttak_net_lattice_copy_bytes(uint8_t *dst, const uint8_t *src, uint32_t len) {
-    if (!dst || !src || len == 0) {
-        return;
-    }
-    memcpy(dst, src, len);
-}
-#else
-static inline void ttak_net_lattice_copy_bytes(uint8_t *dst, const uint8_t *src, uint32_t len) {
-    if (!dst || !src || len == 0) {
-        return;
+
+/*
+ * Slots are 16 KiB, so copies go through the fastpath streaming copy: inline
+ * memcpy (word-wide asm under TinyCC), or non-temporal stores for payloads
+ * at least nt_write_min long when the lattice asks for them. Streaming
+ * writes keep ingress from evicting the writer's working set, since the
+ * payload is next touched by whichever worker reads the slot.
+ */
+static inline void ttak_net_lattice_copy_in(const ttak_net_lattice_t *head, uint8_t *dst,
+                                            const uint8_t *src, uint32_t len) {
+    if (head->nt_write_min && len >= head->nt_write_min) {
+        ttak_mem_stream_copy_uncached(dst, src, len);
+    } else {
+        ttak_mem_stream_copy(dst, src, len);
     }
-    memcpy(dst, src, len);
 }
-#endif
 
 #if defined(__TINYC__)
 static uint32_t tls_worker_id = 0;
@@ -139,6 +53,33 @@ static _Thread_local uint32_t tls_worker_id = 0;
 
 static _Atomic uint32_t g_lattice_compact_counter = 0;
 
+/* Work a writer or reader hands to the maintenance thread. */
+#define TTAK_LATTICE_MAINT_GROW    0x1U
+#define TTAK_LATTICE_MAINT_COMPACT 0x2U
+#define TTAK_LATTICE_MAINT_REFILL  0x4U
+
+/*
+ * Maintenance state of one chain. Allocated by the first start and freed
+ * only with the chain, so a writer that loaded the pointer can always use
+ * it; @c running says whether anyone acts on the requests.
+ */
+typedef struct ttak_net_lattice_maint {
+    ttak_net_lattice_t *head;
+    pthread_t thread;
+    _Bool started;
+    _Atomic _Bool running;
+    _Atomic _Bool stop;
+    _Atomic uint32_t work;
+    ttak_eventcount_t wake;
+    uint32_t target;
+    ttak_net_lattice_t *_Atomic spares[TTAK_LATTICE_MAX_SPARES];
+    ttak_net_lattice_t *_Atomic husks[TTAK_LATTICE_MAX_SPARES]; /* Spares that gave their slots to a stub. */
+    _Atomic uint64_t spare_hits;
+    _Atomic uint64_t inline_allocs;
+    _Atomic uint64_t grown;
+    _Atomic uint64_t compactions;
+} ttak_net_lattice_maint_t;
+
 static ttak_net_lattice_t *global_default_lattice = NULL;
 static pthread_once_t lattice_once = PTHREAD_ONCE_INIT;
 
@@ -155,6 +96,51 @@ static ttak_net_lattice_t *ttak_net_lattice_head(ttak_net_lattice_t *lat) {
     return lat;
 }
 
+static inline ttak_net_lattice_maint_t *ttak_net_lattice_active_maint(const ttak_net_lattice_t *lat) {
+    ttak_net_lattice_maint_t *m = atomic_load_explicit(&lat->maint, memory_order_acquire);
+    return m && atomic_load_explicit(&m->running, memory_order_acquire) ? m : NULL;
+}
+
+/* Flags @p bits for the thread; only the call that sets a bit first wakes it. */
+static void ttak_net_lattice_maint_request(ttak_net_lattice_maint_t *m, uint32_t bits) {
+    uint32_t prior = atomic_fetch_or_explicit(&m->work, bits, memory_order_acq_rel);
+    if ((prior & bits) != bits) {
+        ttak_eventcount_notify(&m->wake);
+    }
+}
+
+static ttak_net_lattice_t *ttak_net_lattice_take_spare(ttak_net_lattice_maint_t *m) {
+    for (uint32_t i = 0; i < TTAK_LATTICE_MAX_SPARES; i++) {
+        ttak_net_lattice_t *spare = atomic_exchange_explicit(&m->spares[i], NULL, memory_order_acq_rel);
+        if (spare) {
+            ttak_net_lattice_maint_request(m, TTAK_LATTICE_MAINT_REFILL);
+            return spare;
+        }
+    }
+    return NULL;
+}
+
+/* Frees one node that is not linked into any chain. */
+static void ttak_net_lattice_free_node(ttak_net_lattice_t *lat) {
+    if (lat->slots) {
+        ttak_mem_free(lat->slots);
+    }
+    ttak_mutex_destroy(&lat->expand_lock);
+    ttak_mem_free(lat);
+}
+
+/* Parks @p node in the first free cell of @p cells, or frees it if there is none. */
+static void ttak_net_lattice_park(ttak_net_lattice_t *_Atomic *cells, ttak_net_lattice_t *node) {
+    for (uint32_t i = 0; i < TTAK_LATTICE_MAX_SPARES; i++) {
+        ttak_net_lattice_t *expected = NULL;
+        if (atomic_compare_exchange_strong_explicit(&cells[i], &expected, node, memory_order_acq_rel,
+                                                    memory_order_relaxed)) {
+            return;
+        }
+    }
+    ttak_net_lattice_free_node(node);
+}
+
 static inline _Bool ttak_net_lattice_is_real(const ttak_net_lattice_t *lat) {
     return lat && !lat->is_stub && lat->dim != 0 && lat->slots;
 }
@@ -210,42 +196,54 @@ static void ttak_net_lattice_mark_stub(ttak_net_lattice_t *lat) {
     atomic_store_explicit(&lat->compact_state, 0U, memory_order_release);
 }
 
-static _Bool ttak_net_lattice_rehydrate(ttak_net_lattice_t *lat, uint32_t dim, uint64_t now) {
-    if (!lat || dim == 0) {
-        return false;
+/* Formats descriptors for @p count slots at @p slots, payloads following them. */
+static void ttak_net_lattice_reset_slots(ttak_net_lattice_slot_t *slots, size_t count, uint32_t slot_size) {
+    uint8_t *payload = (uint8_t *)(slots + count);
+    ttak_mem_stream_zero(slots, count * sizeof(ttak_net_lattice_slot_t));
+    for (size_t i = 0; i < count; ++i) {
+        slots[i].data = payload + i * slot_size;
     }
+}
 
-    size_t slots_count = (size_t)dim * (size_t)dim;
-    ttak_net_lattice_slot_t *slots = ttak_mem_alloc_raw(slots_count * sizeof(ttak_net_lattice_slot_t),
-                                                    __TTAK_UNSAFE_MEM_FOREVER__, now);
-    if (!slots) {
-        return false;
+/* One block: dim * dim descriptors, then their payloads. */
+static ttak_net_lattice_slot_t *ttak_net_lattice_alloc_slots(uint32_t dim, uint32_t slot_size, uint64_t now) {
+    size_t count = (size_t)dim * (size_t)dim;
+    ttak_net_lattice_slot_t *slots =
+        ttak_mem_alloc_raw(count * (sizeof(ttak_net_lattice_slot_t) + slot_size), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (slots) {
+        ttak_net_lattice_reset_slots(slots, count, slot_size);
     }
-    memset(slots, 0, slots_count * sizeof(ttak_net_lattice_slot_t));
+    return slots;
+}
 
+/* Turns stub @p lat back into a live lattice over @p slots. */
+static void ttak_net_lattice_adopt_slots(ttak_net_lattice_t *lat, uint32_t dim, ttak_net_lattice_slot_t *slots) {
     lat->slots = slots;
     lat->dim = dim;
     lat->mask = dim - 1U;
-    lat->capacity = (uint32_t)slots_count;
+    lat->capacity = dim * dim;
     lat->is_stub = false;
     ttak_atomic_write64(&lat->used_slots, 0);
     ttak_atomic_write64(&lat->total_ingress, 0);
     lat->is_full = false;
     atomic_store_explicit(&lat->compact_state, 0U, memory_order_release);
-    return true;
 }
 
-static void ttak_net_lattice_try_compact(ttak_net_lattice_t *lat) {
-    if (!lat) {
-        return;
+static _Bool ttak_net_lattice_rehydrate(ttak_net_lattice_t *lat, uint32_t dim, uint64_t now) {
+    if (!lat || dim == 0) {
+        return false;
     }
 
-    uint32_t ticket = atomic_fetch_add_explicit(&g_lattice_compact_counter, 1U, memory_order_relaxed);
-    if ((ticket & TTAK_LATTICE_COMPACT_THROTTLE_MASK) != 0U) {
-        return;
+    ttak_net_lattice_slot_t *slots = ttak_net_lattice_alloc_slots(dim, lat->slot_size, now);
+    if (!slots) {
+        return false;
     }
+    ttak_net_lattice_adopt_slots(lat, dim, slots);
+    return true;
+}
 
-    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+/* Folds the last pair of adjacent idle lattices of the chain; true if it did. */
+static _Bool ttak_net_lattice_compact_pass(ttak_net_lattice_t *head) {
     uint64_t total_capacity = 0;
     uint64_t total_used = 0;
     size_t real_nodes = 0;
@@ -275,25 +273,27 @@ static void ttak_net_lattice_try_compact(ttak_net_lattice_t *lat) {
     }
 
     if (real_nodes < 2 || total_capacity == 0) {
-        return;
+        return false;
     }
 
     uint64_t free_pct = ((total_capacity - total_used) * 100ULL) / total_capacity;
     if (free_pct < TTAK_LATTICE_COMPACT_MIN_FREE_PCT || !first || !second) {
-        return;
+        return false;
     }
 
     _Bool claimed_first = ttak_net_lattice_claim_compaction(first);
     if (!claimed_first) {
-        return;
+        return false;
     }
 
     _Bool claimed_second = ttak_net_lattice_claim_compaction(second);
     if (!claimed_second) {
         ttak_net_lattice_release_compaction(first);
-        return;
+        return false;
     }
 
+    _Bool folded = false;
+
     do {
         if (!ttak_net_lattice_is_real(first) || !ttak_net_lattice_is_real(second) ||
             ttak_atomic_read64(&first->used_slots) != 0 ||
@@ -306,13 +306,34 @@ static void ttak_net_lattice_try_compact(ttak_net_lattice_t *lat) {
             break;
         }
 
-        size_t slots_bytes = (size_t)first->capacity * sizeof(ttak_net_lattice_slot_t);
-        memset(first->slots, 0, slots_bytes);
+        ttak_net_lattice_reset_slots(first->slots, first->capacity, first->slot_size);
         ttak_net_lattice_mark_stub(second);
+        TTAK_TRACE(TTAK_TRACE_LATTICE_COMPACT, (uintptr_t)first, (uintptr_t)second);
+        folded = true;
     } while (0);
 
     ttak_net_lattice_release_compaction(second);
     ttak_net_lattice_release_compaction(first);
+    return folded;
+}
+
+static void ttak_net_lattice_try_compact(ttak_net_lattice_t *lat) {
+    if (!lat) {
+        return;
+    }
+
+    ttak_net_lattice_maint_t *m = ttak_net_lattice_active_maint(lat);
+    if (m) {
+        ttak_net_lattice_maint_request(m, TTAK_LATTICE_MAINT_COMPACT);
+        return;
+    }
+
+    uint32_t ticket = atomic_fetch_add_explicit(&g_lattice_compact_counter, 1U, memory_order_relaxed);
+    if ((ticket & TTAK_LATTICE_COMPACT_THROTTLE_MASK) != 0U) {
+        return;
+    }
+
+    ttak_net_lattice_compact_pass(ttak_net_lattice_head(lat));
 }
 
 ttak_net_lattice_t* ttak_net_lattice_get_default(void) {
@@ -328,15 +349,26 @@ uint32_t ttak_net_lattice_get_worker_id(void) {
     return tls_worker_id;
 }
 
+void ttak_net_lattice_set_stream_writes(ttak_net_lattice_t *lat, uint32_t min_bytes) {
+    lat = ttak_net_lattice_head(lat);
+    if (lat) lat->nt_write_min = min_bytes;
+}
+
 ttak_net_lattice_t* ttak_net_lattice_create(uint32_t dim, uint64_t now) {
+    return ttak_net_lattice_create_sized(dim, TTAK_LATTICE_SLOT_SIZE, now);
+}
+
+ttak_net_lattice_t* ttak_net_lattice_create_sized(uint32_t dim, uint32_t slot_size, uint64_t now) {
     /* Ensure dim is power of 2 for masking */
     if (dim == 0 || (dim & (dim - 1)) != 0 || dim > TTAK_LATTICE_MAX_DIM) return NULL;
+    if (slot_size == 0 || slot_size > TTAK_LATTICE_MAX_SLOT_SIZE) return NULL;
+    slot_size = (slot_size + 63U) & ~63U;
 
     ttak_net_lattice_t *lat = ttak_mem_alloc_raw(sizeof(ttak_net_lattice_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
     if (!lat) return NULL;
 
     size_t slots_count = (size_t)dim * (size_t)dim;
-    lat->slots = ttak_mem_alloc_raw(slots_count * sizeof(ttak_net_lattice_slot_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    lat->slots = ttak_net_lattice_alloc_slots(dim, slot_size, now);
     if (!lat->slots) {
         ttak_mem_free(lat);
         return NULL;
@@ -345,42 +377,132 @@ ttak_net_lattice_t* ttak_net_lattice_create(uint32_t dim, uint64_t now) {
     lat->dim = dim;
     lat->mask = dim - 1;
     lat->capacity = (uint32_t)slots_count;
+    lat->slot_size = slot_size;
     lat->total_ingress = 0;
     lat->used_slots = 0;
     atomic_store_explicit(&lat->compact_state, 0U, memory_order_relaxed);
     lat->is_full = false;
     lat->is_stub = false;
+    lat->nt_write_min = 0;
     lat->prev = NULL;
     lat->next = NULL;
+    lat->metrics = NULL;
+    lat->doorbells = NULL;
+    lat->doorbell_mask = 0;
+    atomic_init(&lat->maint, NULL);
     if (ttak_mutex_init(&lat->expand_lock) != 0) {
         ttak_mem_free(lat->slots);
         ttak_mem_free(lat);
         return NULL;
     }
 
-    memset(lat->slots, 0, slots_count * sizeof(ttak_net_lattice_slot_t));
-    (void)now;
     return lat;
 }
 
 void ttak_net_lattice_destroy(ttak_net_lattice_t *lat, uint64_t now) {
     (void)now;
+    ttak_net_lattice_maint_t *m = lat ? atomic_load_explicit(&lat->maint, memory_order_acquire) : NULL;
+    if (m) {
+        ttak_net_lattice_stop_maintenance(lat);
+        for (uint32_t i = 0; i < TTAK_LATTICE_MAX_SPARES; i++) {
+            ttak_net_lattice_t *spare = atomic_load_explicit(&m->spares[i], memory_order_relaxed);
+            if (spare) ttak_net_lattice_free_node(spare);
+            ttak_net_lattice_t *husk = atomic_load_explicit(&m->husks[i], memory_order_relaxed);
+            if (husk) ttak_net_lattice_free_node(husk);
+        }
+        free(m);
+    }
+    if (lat && lat->metrics) ttak_metrics_unregister_owner(lat->metrics, lat);
+    if (lat && lat->doorbells) {
+        for (uint32_t i = 0; i <= lat->doorbell_mask; i++) {
+            if (lat->doorbells[i].fd >= 0) close(lat->doorbells[i].fd);
+        }
+        free(lat->doorbells);
+    }
     while (lat) {
         ttak_net_lattice_t *next = lat->next;
-        if (lat->slots) {
-            ttak_mem_free(lat->slots);
-        }
-        ttak_mutex_destroy(&lat->expand_lock);
-        ttak_mem_free(lat);
+        ttak_net_lattice_free_node(lat);
         lat = next;
     }
 }
 
+typedef enum {
+    LATTICE_METRIC_NODES = 0,
+    LATTICE_METRIC_CAPACITY,
+    LATTICE_METRIC_USED,
+    LATTICE_METRIC_INGRESS
+} lattice_metric_t;
+
+/* Sum of one field over the live nodes of the chain @p lat heads. */
+static double ttak_net_lattice_metric_sum(ttak_net_lattice_t *lat, lattice_metric_t which) {
+    uint64_t sum = 0;
+    for (ttak_net_lattice_t *node = lat; node; node = node->next) {
+        if (!ttak_net_lattice_is_real(node)) continue;
+        switch (which) {
+            case LATTICE_METRIC_NODES:    sum += 1; break;
+            case LATTICE_METRIC_CAPACITY: sum += node->capacity; break;
+            case LATTICE_METRIC_USED:     sum += ttak_atomic_read64(&node->used_slots); break;
+            case LATTICE_METRIC_INGRESS:  sum += ttak_atomic_read64(&node->total_ingress); break;
+        }
+    }
+    return (double)sum;
+}
+
+static double ttak_net_lattice_metric_nodes(void *arg) { return ttak_net_lattice_metric_sum(arg, LATTICE_METRIC_NODES); }
+static double ttak_net_lattice_metric_capacity(void *arg) { return ttak_net_lattice_metric_sum(arg, LATTICE_METRIC_CAPACITY); }
+static double ttak_net_lattice_metric_used(void *arg) { return ttak_net_lattice_metric_sum(arg, LATTICE_METRIC_USED); }
+static double ttak_net_lattice_metric_ingress(void *arg) { return ttak_net_lattice_metric_sum(arg, LATTICE_METRIC_INGRESS); }
+
+size_t ttak_net_lattice_export_metrics(ttak_net_lattice_t *lat, ttak_metrics_registry_t *reg, const char *labels) {
+    lat = ttak_net_lattice_head(lat);
+    if (!lat || !reg || lat->metrics) return 0;
+    size_t n = 0;
+    n += ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_lattice_nodes", "Live lattice nodes in the chain.",
+                                  labels, ttak_net_lattice_metric_nodes, lat, lat) != NULL;
+    n += ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_lattice_capacity_slots", "Slots across live nodes.",
+                                  labels, ttak_net_lattice_metric_capacity, lat, lat) != NULL;
+    n += ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_lattice_used_slots", "Slots holding unread messages.",
+                                  labels, ttak_net_lattice_metric_used, lat, lat) != NULL;
+    n += ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_lattice_ingress", "Messages written since each live node was last reset.",
+                                  labels, ttak_net_lattice_metric_ingress, lat, lat) != NULL;
+    lat->metrics = reg;
+    return n;
+}
+
+static inline ttak_net_lattice_doorbell_t *ttak_net_lattice_bell(const ttak_net_lattice_t *head, uint32_t tid) {
+    return head->doorbells ? &head->doorbells[tid & head->doorbell_mask] : NULL;
+}
+
+/*
+ * Counts @p n messages published to @p tid's lane. Only the add that takes
+ * the count off zero looks at @c armed, and only an armed lane is rung, so
+ * writers to a lane that is already being drained never leave user space.
+ */
+static void ttak_net_lattice_ring(ttak_net_lattice_t *head, uint32_t tid, uint32_t n) {
+    ttak_net_lattice_doorbell_t *bell = ttak_net_lattice_bell(head, tid);
+    if (!bell || n == 0) return;
+    if (atomic_fetch_add_explicit(&bell->ready, n, memory_order_seq_cst) != 0) return;
+    if (!atomic_load_explicit(&bell->armed, memory_order_seq_cst)) return;
+    if (!atomic_exchange_explicit(&bell->armed, 0, memory_order_acq_rel)) return;
+    if (bell->fd >= 0) {
+        uint64_t one = 1;
+        if (write(bell->fd, &one, sizeof(one)) == (ssize_t)sizeof(one)) {
+            atomic_store_explicit(&bell->rung, 1, memory_order_release);
+        }
+    }
+    ttak_eventcount_notify_all(&bell->ec);
+}
+
+static inline void ttak_net_lattice_claimed(ttak_net_lattice_t *head, uint32_t tid, uint32_t n) {
+    ttak_net_lattice_doorbell_t *bell = ttak_net_lattice_bell(head, tid);
+    if (bell && n) atomic_fetch_sub_explicit(&bell->ready, n, memory_order_release);
+}
+
 /**
  * @brief Lock-free deterministic write into the lattice.
  */
 _Bool ttak_net_lattice_write(ttak_net_lattice_t *lat, uint32_t tid, const void *data, uint32_t len, uint64_t now) {
-    if (!lat || !data || len > TTAK_LATTICE_SLOT_SIZE) return false;
+    if (!lat || !data || len > lat->slot_size) return false;
 
     ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
     ttak_net_lattice_t *mask_node = head;
@@ -415,7 +537,7 @@ _Bool ttak_net_lattice_write(ttak_net_lattice_t *lat, uint32_t tid, const void *
                     if (ttak_atomic_read64(&slot->state) == 0) {
                         ttak_atomic_write64(&slot->state, 1); /* Entering writing state */
                         
-                        ttak_net_lattice_copy_bytes(slot->data, (const uint8_t *)data, len);
+                        ttak_net_lattice_copy_in(head, slot->data, (const uint8_t *)data, len);
                         slot->len = len;
                         slot->timestamp = now;
                         slot->seq++;
@@ -423,14 +545,16 @@ _Bool ttak_net_lattice_write(ttak_net_lattice_t *lat, uint32_t tid, const void *
                         ttak_atomic_write64(&slot->state, 2); /* Ready state */
                         ttak_atomic_add64(&node->total_ingress, 1);
                         ttak_net_lattice_mark_slot_acquired(node, now);
+                        ttak_net_lattice_ring(head, my_tid, 1);
                         return true;
                     }
                 }
             }
         }
 
+        /* A stub left by compaction is revived here if the grower has not got to it yet. */
         ttak_net_lattice_t *next = node->next;
-        if (!next) {
+        if (!next || next->is_stub) {
             next = ttak_net_lattice_ensure_next(node, now);
         }
         node = next;
@@ -475,11 +599,12 @@ _Bool ttak_net_lattice_read(ttak_net_lattice_t *lat, uint32_t tid, void *dst, ui
                         ttak_atomic_write64(&slot->state, 3); /* Mark as reading/processing */
                         
                         uint32_t len = slot->len;
-                        ttak_net_lattice_copy_bytes((uint8_t *)dst, slot->data, len);
+                        ttak_mem_stream_copy(dst, slot->data, len);
                         *len_out = len;
                         
                         ttak_atomic_write64(&slot->state, 0); /* Reset to empty */
                         ttak_net_lattice_mark_slot_released(node);
+                        ttak_net_lattice_claimed(head, my_tid, 1);
                         return true;
                     }
                 }
@@ -490,43 +615,80 @@ _Bool ttak_net_lattice_read(ttak_net_lattice_t *lat, uint32_t tid, void *dst, ui
     return false;
 }
 
-ttak_net_lattice_t* ttak_net_lattice_ensure_next(ttak_net_lattice_t *lat, uint64_t now) {
+/*
+ * Gives @p lat a live successor. Writers take a spare first and allocate
+ * only when none is left; the maintenance thread (@p background) always
+ * allocates, leaving the spares for writers that outrun it.
+ */
+static ttak_net_lattice_t *ttak_net_lattice_grow(ttak_net_lattice_t *lat, _Bool background, uint64_t now) {
     if (!lat) return NULL;
     if (lat->next && !lat->next->is_stub) return lat->next;
 
+    ttak_net_lattice_maint_t *m = atomic_load_explicit(&lat->maint, memory_order_acquire);
+    ttak_net_lattice_t *spare = NULL;
     ttak_mutex_lock(&lat->expand_lock);
     ttak_net_lattice_t *next = lat->next;
+    if (next && !next->is_stub) {
+        ttak_mutex_unlock(&lat->expand_lock);
+        return next;
+    }
+    if (m && !background) {
+        spare = ttak_net_lattice_take_spare(m);
+    }
     if (!next) {
-        next = ttak_net_lattice_create(lat->dim, now);
+        next = spare ? spare : ttak_net_lattice_create_sized(lat->dim, lat->slot_size, now);
         if (next) {
             next->prev = lat;
+            atomic_store_explicit(&next->maint, m, memory_order_release);
             lat->next = next;
         }
-    } else if (next->is_stub) {
-        if (!ttak_net_lattice_rehydrate(next, lat->dim, now)) {
-            next = NULL;
-        }
+    } else if (spare) {
+        ttak_net_lattice_adopt_slots(next, lat->dim, spare->slots);
+        spare->slots = NULL;
+        ttak_net_lattice_park(m->husks, spare);
+    } else if (!ttak_net_lattice_rehydrate(next, lat->dim, now)) {
+        next = NULL;
     }
     ttak_mutex_unlock(&lat->expand_lock);
+
+    if (m && next) {
+        if (background) {
+            atomic_fetch_add_explicit(&m->grown, 1, memory_order_relaxed);
+        } else if (spare) {
+            atomic_fetch_add_explicit(&m->spare_hits, 1, memory_order_relaxed);
+        } else {
+            atomic_fetch_add_explicit(&m->inline_allocs, 1, memory_order_relaxed);
+        }
+    }
     return next;
 }
 
-void ttak_net_lattice_mark_slot_acquired(ttak_net_lattice_t *lat, uint64_t now) {
-    if (!lat || lat->capacity == 0) return;
-    uint64_t used = ttak_atomic_add64(&lat->used_slots, 1);
+ttak_net_lattice_t* ttak_net_lattice_ensure_next(ttak_net_lattice_t *lat, uint64_t now) {
+    return ttak_net_lattice_grow(lat, false, now);
+}
+
+/* Slot accounting for @p n slots at once: one atomic per call, not per slot. */
+static void ttak_net_lattice_account_acquired(ttak_net_lattice_t *lat, uint64_t n, uint64_t now) {
+    if (!lat || lat->capacity == 0 || n == 0) return;
+    uint64_t used = ttak_atomic_add64(&lat->used_slots, n);
     if (used >= lat->capacity) {
         lat->is_full = true;
     }
     uint64_t scaled = used * 100;
     uint64_t threshold = (uint64_t)lat->capacity * 80;
     if (scaled >= threshold) {
-        ttak_net_lattice_ensure_next(lat, now);
+        ttak_net_lattice_maint_t *m = ttak_net_lattice_active_maint(lat);
+        if (!m) {
+            ttak_net_lattice_ensure_next(lat, now);
+        } else if (!lat->next || lat->next->is_stub) {
+            ttak_net_lattice_maint_request(m, TTAK_LATTICE_MAINT_GROW);
+        }
     }
 }
 
-void ttak_net_lattice_mark_slot_released(ttak_net_lattice_t *lat) {
-    if (!lat || lat->capacity == 0) return;
-    uint64_t remaining = ttak_atomic_sub64(&lat->used_slots, 1);
+static void ttak_net_lattice_account_released(ttak_net_lattice_t *lat, uint64_t n) {
+    if (!lat || lat->capacity == 0 || n == 0) return;
+    uint64_t remaining = ttak_atomic_sub64(&lat->used_slots, n);
     if (remaining < lat->capacity) {
         lat->is_full = false;
     }
@@ -534,3 +696,412 @@ void ttak_net_lattice_mark_slot_released(ttak_net_lattice_t *lat) {
         ttak_net_lattice_try_compact(lat);
     }
 }
+
+void ttak_net_lattice_mark_slot_acquired(ttak_net_lattice_t *lat, uint64_t now) {
+    ttak_net_lattice_account_acquired(lat, 1, now);
+}
+
+void ttak_net_lattice_mark_slot_released(ttak_net_lattice_t *lat) {
+    ttak_net_lattice_account_released(lat, 1);
+}
+
+/* ---- Batches ---- */
+
+/* Indexes of the slots of @p node that belong to @p my_tid, in sweep order. */
+static uint32_t ttak_net_lattice_lanes(const ttak_net_lattice_t *node, uint32_t my_tid, uint32_t mask,
+                                       uint16_t *out) {
+    uint32_t dim = node->dim;
+    uint32_t n = 0;
+    for (uint32_t r = 0; r < dim; r++) {
+        for (uint32_t c = 0; c < dim; c++) {
+            const uint16_t node_id =
+                (uint16_t)(((r & (uint32_t)TTAK_MOLS_SYMBOL_MASK) << TTAK_MOLS_COORD_SHIFT) |
+                           (c & (uint32_t)TTAK_MOLS_SYMBOL_MASK));
+            uint32_t lane = ttak_apply_mols_control(node_id, my_tid) & mask;
+            if (((r + c) & mask) == lane) {
+                out[n++] = (uint16_t)(r * dim + c);
+            }
+        }
+    }
+    return n;
+}
+
+/* First real node's mask, which every node of the chain shares. */
+static _Bool ttak_net_lattice_chain_mask(ttak_net_lattice_t *head, uint32_t *mask) {
+    for (ttak_net_lattice_t *node = head; node; node = node->next) {
+        if (ttak_net_lattice_is_real(node)) {
+            *mask = node->mask;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ttak_net_lattice_write_batch(ttak_net_lattice_t *lat, uint32_t tid, const ttak_net_lattice_msg_t *msgs,
+                                    size_t n, uint64_t now) {
+    if (!lat || !msgs) return 0;
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    uint32_t mask;
+    if (!ttak_net_lattice_chain_mask(head, &mask)) return 0;
+    uint32_t my_tid = tid & mask;
+
+    uint16_t lanes[TTAK_LATTICE_MAX_DIM * TTAK_LATTICE_MAX_DIM];
+    size_t done = 0;
+    for (ttak_net_lattice_t *node = head; node && done < n; ) {
+        if (ttak_net_lattice_is_real(node) && !TTAK_LATTICE_NODE_IS_BUSY(node)) {
+            uint32_t count = ttak_net_lattice_lanes(node, my_tid, mask, lanes);
+            if (count == 0) break; /* Same geometry everywhere: no lattice has a slot for this worker. */
+            uint32_t filled = 0;
+            for (uint32_t i = 0; i < count && done < n; i++) {
+                ttak_net_lattice_slot_t *slot = &node->slots[lanes[i]];
+                if (ttak_atomic_read64(&slot->state) != 0) continue;
+                const ttak_net_lattice_msg_t *m = &msgs[done];
+                if (!m->data || m->len > node->slot_size) break;
+
+                ttak_atomic_write64(&slot->state, 1);
+                ttak_net_lattice_copy_in(head, slot->data, m->data, m->len);
+                slot->len = m->len;
+                slot->timestamp = now;
+                slot->seq++;
+                ttak_atomic_write64(&slot->state, 2);
+                filled++;
+                done++;
+            }
+            if (filled) {
+                ttak_atomic_add64(&node->total_ingress, filled);
+                ttak_net_lattice_account_acquired(node, filled, now);
+            }
+            if (done < n && (!msgs[done].data || msgs[done].len > node->slot_size)) break;
+        }
+        if (done == n) break;
+
+        ttak_net_lattice_t *next = node->next;
+        if (!next || (next->is_stub && ttak_net_lattice_is_real(node))) {
+            next = ttak_net_lattice_ensure_next(node, now);
+        }
+        node = next;
+    }
+    ttak_net_lattice_ring(head, my_tid, (uint32_t)done);
+    return done;
+}
+
+size_t ttak_net_lattice_read_batch(ttak_net_lattice_t *lat, uint32_t tid, ttak_net_lattice_msg_t *out,
+                                   size_t max, uint64_t now) {
+    (void)now;
+    if (!lat || !out) return 0;
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    uint32_t mask;
+    if (!ttak_net_lattice_chain_mask(head, &mask)) return 0;
+    uint32_t my_tid = tid & mask;
+
+    uint16_t lanes[TTAK_LATTICE_MAX_DIM * TTAK_LATTICE_MAX_DIM];
+    size_t got = 0;
+    for (ttak_net_lattice_t *node = head; node && got < max; node = node->next) {
+        if (!ttak_net_lattice_is_real(node) || TTAK_LATTICE_NODE_IS_BUSY(node)) {
+            continue;
+        }
+        uint32_t count = ttak_net_lattice_lanes(node, my_tid, mask, lanes);
+        for (uint32_t i = 0; i < count && got < max; i++) {
+            ttak_net_lattice_slot_t *slot = &node->slots[lanes[i]];
+            if (ttak_atomic_read64(&slot->state) != 2) continue;
+            ttak_atomic_write64(&slot->state, 3);
+            out[got].data = slot->data;
+            out[got].len = slot->len;
+            out[got].slot = slot;
+            out[got].node = node;
+            got++;
+        }
+    }
+    ttak_net_lattice_claimed(head, my_tid, (uint32_t)got);
+    return got;
+}
+
+void ttak_net_lattice_release_batch(ttak_net_lattice_msg_t *msgs, size_t n) {
+    if (!msgs) return;
+    /* read_batch hands out each node's slots as one run, so one release per run. */
+    size_t i = 0;
+    while (i < n) {
+        ttak_net_lattice_t *node = msgs[i].node;
+        size_t run = 0;
+        for (; i < n && msgs[i].node == node; i++, run++) {
+            if (msgs[i].slot) ttak_atomic_write64(&msgs[i].slot->state, 0);
+            msgs[i].slot = NULL;
+            msgs[i].node = NULL;
+        }
+        ttak_net_lattice_account_released(node, run);
+    }
+}
+
+/* ---- Doorbells ---- */
+
+_Bool ttak_net_lattice_enable_doorbells(ttak_net_lattice_t *lat, _Bool with_eventfd) {
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    uint32_t mask;
+    if (!head || head->doorbells || !ttak_net_lattice_chain_mask(head, &mask)) return false;
+#ifndef __linux__
+    if (with_eventfd) return false;
+#endif
+    size_t bytes = sizeof(ttak_net_lattice_doorbell_t) * ((size_t)mask + 1);
+    ttak_net_lattice_doorbell_t *bells = aligned_alloc(_Alignof(ttak_net_lattice_doorbell_t), bytes);
+    if (!bells) return false;
+    memset(bells, 0, bytes);
+    for (uint32_t i = 0; i <= mask; i++) {
+        ttak_eventcount_init(&bells[i].ec);
+        bells[i].fd = -1;
+    }
+#ifdef __linux__
+    for (uint32_t i = 0; with_eventfd && i <= mask; i++) {
+        bells[i].fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (bells[i].fd < 0) {
+            while (i-- > 0) close(bells[i].fd);
+            free(bells);
+            return false;
+        }
+    }
+#endif
+    head->doorbell_mask = mask;
+    head->doorbells = bells;
+    return true;
+}
+
+int ttak_net_lattice_doorbell_fd(ttak_net_lattice_t *lat, uint32_t tid) {
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    ttak_net_lattice_doorbell_t *bell = head ? ttak_net_lattice_bell(head, tid) : NULL;
+    return bell ? bell->fd : -1;
+}
+
+/* Messages ready in the lane; a claim may briefly run ahead of the publishing add. */
+static inline uint32_t ttak_net_lattice_ready(const ttak_net_lattice_doorbell_t *bell) {
+    int32_t ready = (int32_t)atomic_load_explicit(&bell->ready, memory_order_seq_cst);
+    return ready > 0 ? (uint32_t)ready : 0U;
+}
+
+_Bool ttak_net_lattice_doorbell_arm(ttak_net_lattice_t *lat, uint32_t tid) {
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    ttak_net_lattice_doorbell_t *bell = head ? ttak_net_lattice_bell(head, tid) : NULL;
+    if (!bell) return false;
+    if (bell->fd >= 0 && atomic_exchange_explicit(&bell->rung, 0, memory_order_acquire)) {
+        uint64_t count;
+        while (read(bell->fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+        }
+    }
+    atomic_store_explicit(&bell->armed, 1, memory_order_seq_cst);
+    return atomic_load_explicit(&bell->ready, memory_order_seq_cst) == 0;
+}
+
+uint32_t ttak_net_lattice_pending(ttak_net_lattice_t *lat, uint32_t tid) {
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    ttak_net_lattice_doorbell_t *bell = head ? ttak_net_lattice_bell(head, tid) : NULL;
+    return bell ? ttak_net_lattice_ready(bell) : 0U;
+}
+
+_Bool ttak_net_lattice_wait(ttak_net_lattice_t *lat, uint32_t tid, uint64_t timeout_ns) {
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    ttak_net_lattice_doorbell_t *bell = head ? ttak_net_lattice_bell(head, tid) : NULL;
+    if (!bell) return false;
+    if (ttak_net_lattice_ready(bell)) return true;
+    uint64_t deadline = TTAK_WAIT_FOREVER;
+    if (timeout_ns != TTAK_WAIT_FOREVER) {
+        uint64_t start = ttak_get_tick_count_ns();
+        deadline = timeout_ns > TTAK_WAIT_FOREVER - start ? TTAK_WAIT_FOREVER : start + timeout_ns;
+    }
+    for (;;) {
+        uint64_t left = TTAK_WAIT_FOREVER;
+        if (deadline != TTAK_WAIT_FOREVER) {
+            uint64_t now = ttak_get_tick_count_ns();
+            if (now >= deadline) return false;
+            left = deadline - now;
+        }
+        uint32_t key = ttak_eventcount_prepare(&bell->ec);
+        atomic_store_explicit(&bell->armed, 1, memory_order_seq_cst);
+        if (ttak_net_lattice_ready(bell)) {
+            ttak_eventcount_cancel(&bell->ec);
+            return true;
+        }
+        ttak_eventcount_wait_for(&bell->ec, key, left);
+        if (ttak_net_lattice_ready(bell)) return true;
+    }
+}
+
+/* ---- Maintenance ---- */
+
+/* Grows every lattice past the threshold that has no live successor yet. */
+static void ttak_net_lattice_grow_ahead(ttak_net_lattice_t *head, uint64_t now) {
+    for (ttak_net_lattice_t *node = head; node; node = node->next) {
+        if (!ttak_net_lattice_is_real(node)) continue;
+        uint64_t used = ttak_atomic_read64(&node->used_slots);
+        if (used * 100 >= (uint64_t)node->capacity * 80 && (!node->next || node->next->is_stub)) {
+            ttak_net_lattice_grow(node, true, now);
+        }
+    }
+}
+
+/* Gives husks fresh slots and tops the spares up to the target. */
+static void ttak_net_lattice_refill(ttak_net_lattice_maint_t *m, uint64_t now) {
+    uint32_t mask;
+    if (!ttak_net_lattice_chain_mask(m->head, &mask)) return;
+    uint32_t dim = mask + 1U;
+    uint32_t slot_size = m->head->slot_size;
+
+    uint32_t ready = 0;
+    for (uint32_t i = 0; i < TTAK_LATTICE_MAX_SPARES; i++) {
+        if (atomic_load_explicit(&m->spares[i], memory_order_acquire)) ready++;
+    }
+    for (uint32_t i = 0; i < TTAK_LATTICE_MAX_SPARES && ready < m->target; i++) {
+        if (atomic_load_explicit(&m->spares[i], memory_order_acquire)) continue;
+        ttak_net_lattice_t *spare = atomic_exchange_explicit(&m->husks[i], NULL, memory_order_acq_rel);
+        if (spare) {
+            ttak_net_lattice_slot_t *slots = ttak_net_lattice_alloc_slots(dim, slot_size, now);
+            if (!slots) {
+                ttak_net_lattice_park(m->husks, spare);
+                return;
+            }
+            ttak_net_lattice_adopt_slots(spare, dim, slots);
+        } else if (!(spare = ttak_net_lattice_create_sized(dim, slot_size, now))) {
+            return;
+        }
+        ttak_net_lattice_park(m->spares, spare);
+        ready++;
+    }
+}
+
+static void *ttak_net_lattice_maint_main(void *arg) {
+    ttak_net_lattice_maint_t *m = arg;
+    for (;;) {
+        uint32_t key = ttak_eventcount_prepare(&m->wake);
+        uint32_t work = atomic_exchange_explicit(&m->work, 0U, memory_order_acq_rel);
+        if (atomic_load_explicit(&m->stop, memory_order_acquire)) {
+            ttak_eventcount_cancel(&m->wake);
+            break;
+        }
+        if (work == 0U) {
+            ttak_eventcount_wait(&m->wake, key);
+            continue;
+        }
+        ttak_eventcount_cancel(&m->wake);
+
+        uint64_t now = ttak_get_tick_count();
+        if (work & TTAK_LATTICE_MAINT_COMPACT) {
+            while (ttak_net_lattice_compact_pass(m->head)) {
+                atomic_fetch_add_explicit(&m->compactions, 1, memory_order_relaxed);
+            }
+        }
+        if (work & TTAK_LATTICE_MAINT_GROW) {
+            ttak_net_lattice_grow_ahead(m->head, now);
+        }
+        ttak_net_lattice_refill(m, now);
+    }
+    return NULL;
+}
+
+int ttak_net_lattice_start_maintenance(ttak_net_lattice_t *lat, uint32_t spares) {
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    if (!head) return EINVAL;
+    if (spares > TTAK_LATTICE_MAX_SPARES) spares = TTAK_LATTICE_MAX_SPARES;
+
+    ttak_net_lattice_maint_t *m = atomic_load_explicit(&head->maint, memory_order_acquire);
+    if (m && m->started) return EALREADY;
+    if (!m) {
+        m = calloc(1, sizeof(*m));
+        if (!m) return ENOMEM;
+        m->head = head;
+        ttak_eventcount_init(&m->wake);
+        /* Nodes linked from here on inherit the pointer from their predecessor. */
+        for (ttak_net_lattice_t *node = head; node; node = node->next) {
+            atomic_store_explicit(&node->maint, m, memory_order_release);
+        }
+    }
+    m->target = spares;
+    atomic_store_explicit(&m->stop, false, memory_order_relaxed);
+    atomic_store_explicit(&m->work, TTAK_LATTICE_MAINT_GROW | TTAK_LATTICE_MAINT_REFILL, memory_order_relaxed);
+    int rc = pthread_create(&m->thread, NULL, ttak_net_lattice_maint_main, m);
+    if (rc != 0) return rc;
+    m->started = true;
+    atomic_store_explicit(&m->running, true, memory_order_release);
+    return 0;
+}
+
+void ttak_net_lattice_stop_maintenance(ttak_net_lattice_t *lat) {
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    ttak_net_lattice_maint_t *m = head ? atomic_load_explicit(&head->maint, memory_order_acquire) : NULL;
+    if (!m || !m->started) return;
+    atomic_store_explicit(&m->running, false, memory_order_release);
+    atomic_store_explicit(&m->stop, true, memory_order_release);
+    ttak_eventcount_notify_all(&m->wake);
+    pthread_join(m->thread, NULL);
+    m->started = false;
+}
+
+void ttak_net_lattice_maintenance_stats(ttak_net_lattice_t *lat, ttak_net_lattice_maint_stats_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    ttak_net_lattice_t *head = ttak_net_lattice_head(lat);
+    ttak_net_lattice_maint_t *m = head ? atomic_load_explicit(&head->maint, memory_order_acquire) : NULL;
+    if (!m) return;
+    for (uint32_t i = 0; i < TTAK_LATTICE_MAX_SPARES; i++) {
+        if (atomic_load_explicit(&m->spares[i], memory_order_acquire)) out->spares++;
+    }
+    out->spare_hits = atomic_load_explicit(&m->spare_hits, memory_order_relaxed);
+    out->inline_allocs = atomic_load_explicit(&m->inline_allocs, memory_order_relaxed);
+    out->grown = atomic_load_explicit(&m->grown, memory_order_relaxed);
+    out->compactions = atomic_load_explicit(&m->compactions, memory_order_relaxed);
+}
+
+/* ---- Size classes ---- */
+
+static const uint32_t ttak_net_lattice_class_sizes[TTAK_LATTICE_CLASSES] = { 256U, 2048U, 16384U, 65536U };
+
+uint32_t ttak_net_lattice_class_size(uint32_t cls) {
+    return cls < TTAK_LATTICE_CLASSES ? ttak_net_lattice_class_sizes[cls] : 0U;
+}
+
+_Bool ttak_net_lattice_classes_init(ttak_net_lattice_classes_t *set, uint32_t dim) {
+    if (!set || dim == 0 || (dim & (dim - 1)) != 0 || dim > TTAK_LATTICE_MAX_DIM) return false;
+    set->dim = dim;
+    for (uint32_t i = 0; i < TTAK_LATTICE_CLASSES; i++) {
+        atomic_init(&set->lattices[i], NULL);
+    }
+    return true;
+}
+
+void ttak_net_lattice_classes_destroy(ttak_net_lattice_classes_t *set, uint64_t now) {
+    if (!set) return;
+    for (uint32_t i = 0; i < TTAK_LATTICE_CLASSES; i++) {
+        ttak_net_lattice_destroy(atomic_exchange(&set->lattices[i], NULL), now);
+    }
+}
+
+/* The class's lattice, created on first use; the loser of a creation race drops its copy. */
+static ttak_net_lattice_t *ttak_net_lattice_class_get(ttak_net_lattice_classes_t *set, uint32_t cls, uint64_t now) {
+    ttak_net_lattice_t *lat = atomic_load_explicit(&set->lattices[cls], memory_order_acquire);
+    if (lat) return lat;
+    ttak_net_lattice_t *fresh = ttak_net_lattice_create_sized(set->dim, ttak_net_lattice_class_sizes[cls], now);
+    if (!fresh) return NULL;
+    if (!atomic_compare_exchange_strong_explicit(&set->lattices[cls], &lat, fresh,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        ttak_net_lattice_destroy(fresh, now);
+        return lat;
+    }
+    return fresh;
+}
+
+_Bool ttak_net_lattice_classes_write(ttak_net_lattice_classes_t *set, uint32_t tid, const void *data,
+                                     uint32_t len, uint64_t now) {
+    if (!set || !data) return false;
+    for (uint32_t cls = 0; cls < TTAK_LATTICE_CLASSES; cls++) {
+        if (len > ttak_net_lattice_class_sizes[cls]) continue;
+        ttak_net_lattice_t *lat = ttak_net_lattice_class_get(set, cls, now);
+        if (lat && ttak_net_lattice_write(lat, tid, data, len, now)) return true;
+    }
+    return false;
+}
+
+_Bool ttak_net_lattice_classes_read(ttak_net_lattice_classes_t *set, uint32_t tid, void *dst, size_t dst_cap,
+                                    uint32_t *len_out, uint64_t now) {
+    if (!set || !dst || !len_out) return false;
+    for (uint32_t cls = 0; cls < TTAK_LATTICE_CLASSES && ttak_net_lattice_class_sizes[cls] <= dst_cap; cls++) {
+        ttak_net_lattice_t *lat = atomic_load_explicit(&set->lattices[cls], memory_order_acquire);
+        if (lat && ttak_net_lattice_read(lat, tid, dst, len_out, now)) return true;
+    }
+    return false;
+}
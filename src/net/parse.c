@@ -0,0 +1,369 @@
+/**
+ * @file parse.c
+ * @brief Resumable framing and HTTP/1.1 tokenizing over a buffer chain.
+ *
+ * Delimiter searches walk the input segments with a vector byte scan for
+ * the delimiter's first byte and confirm the rest, which may cross into
+ * the next segment, by copying out at most TTAK_NET_PARSE_MAX_DELIM
+ * bytes. The offset reached is kept so a search resumes after more input
+ * arrives. A frame is consumed lazily, on the call after the one that
+ * returned it, so its tokens stay valid in between.
+ */
+
+#include <ttak/net/parse.h>
+
+#include <ttak/arch/ttak_arch.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(TTAK_HAS_AVX2)
+#include <immintrin.h>
+#elif defined(TTAK_HAS_SSE2)
+#include <emmintrin.h>
+#elif defined(TTAK_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
+static const uint8_t ttak_net_parse_empty[1];
+
+const uint8_t *ttak_net_scan_byte(const uint8_t *data, size_t len, uint8_t byte) {
+    if (!data) return NULL;
+    size_t i = 0;
+#if defined(TTAK_HAS_AVX2)
+    __m256i needle = _mm256_set1_epi8((char)byte);
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(data + i));
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle));
+        if (m) return data + i + (size_t)__builtin_ctz(m);
+    }
+#elif defined(TTAK_HAS_SSE2)
+    __m128i needle = _mm_set1_epi8((char)byte);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+        uint32_t m = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+        if (m) return data + i + (size_t)__builtin_ctz(m);
+    }
+#elif defined(TTAK_HAS_NEON)
+    uint8x16_t needle = vdupq_n_u8(byte);
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(data + i), needle);
+        uint64_t m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (m) return data + i + ((size_t)__builtin_ctzll(m) >> 2);
+    }
+#endif
+    if (i >= len) return NULL;
+    return memchr(data + i, byte, len - i);
+}
+
+static void ttak_net_parser_clear(ttak_net_parser_t *parser) {
+    parser->scanned = 0;
+    parser->pending = 0;
+    parser->in_headers = false;
+    parser->has_content_length = false;
+    parser->content_length = 0;
+}
+
+bool ttak_net_parser_init(ttak_net_parser_t *parser,
+                          const ttak_net_parser_config_t *cfg,
+                          ttak_detachable_context_t *arena) {
+    if (!parser || !cfg) return false;
+    memset(parser, 0, sizeof(*parser));
+    parser->cfg = *cfg;
+    switch (cfg->kind) {
+    case TTAK_NET_FRAME_LENGTH:
+        if (cfg->length_bytes != 1 && cfg->length_bytes != 2 &&
+            cfg->length_bytes != 4 && cfg->length_bytes != 8) return false;
+        break;
+    case TTAK_NET_FRAME_DELIMITER:
+        if (!cfg->delim || cfg->delim_len == 0 || cfg->delim_len > TTAK_NET_PARSE_MAX_DELIM) return false;
+        memcpy(parser->delim, cfg->delim, cfg->delim_len);
+        break;
+    case TTAK_NET_FRAME_HTTP1:
+        parser->delim[0] = '\n';
+        parser->cfg.delim_len = 1;
+        break;
+    default:
+        return false;
+    }
+    parser->cfg.delim = parser->delim;
+    if (parser->cfg.max_frame == 0) parser->cfg.max_frame = TTAK_NET_PARSE_DEFAULT_MAX_FRAME;
+    ttak_io_chain_init(&parser->in, arena);
+    return true;
+}
+
+void ttak_net_parser_destroy(ttak_net_parser_t *parser) {
+    if (!parser) return;
+    ttak_io_chain_destroy(&parser->in);
+    free(parser->scratch);
+    parser->scratch = NULL;
+    parser->scratch_cap = 0;
+    ttak_net_parser_clear(parser);
+}
+
+void ttak_net_parser_reset(ttak_net_parser_t *parser) {
+    if (!parser) return;
+    ttak_io_chain_destroy(&parser->in);
+    ttak_net_parser_clear(parser);
+}
+
+ttak_io_status_t ttak_net_parser_feed_chain(ttak_net_parser_t *parser, const ttak_io_chain_t *chain) {
+    if (!parser || !chain) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    return ttak_io_chain_append_chain(&parser->in, chain);
+}
+
+ttak_io_status_t ttak_net_parser_feed(ttak_net_parser_t *parser, const void *data, size_t len, uint64_t now) {
+    if (!parser) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    return ttak_io_chain_append(&parser->in, data, len, now);
+}
+
+ttak_io_status_t ttak_net_parser_feed_view(ttak_net_parser_t *parser, ttak_net_view_t *view, uint64_t now) {
+    if (!parser || !view) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    ttak_io_status_t status = TTAK_IO_SUCCESS;
+    if (view->region.allocation.data) {
+        status = ttak_io_chain_adopt_region(&parser->in, &view->region);
+    } else if (view->data && view->len > 0) {
+        status = ttak_io_chain_append(&parser->in, view->data, view->len, now);
+    }
+    if (status == TTAK_IO_SUCCESS) ttak_net_view_release(view);
+    return status;
+}
+
+/* Drops the frame returned last; offsets restart at the new front. */
+static void ttak_net_parser_drop_pending(ttak_net_parser_t *parser) {
+    if (parser->pending == 0) return;
+    ttak_io_chain_consume(&parser->in, parser->pending);
+    parser->pending = 0;
+    parser->scanned = 0;
+}
+
+/* Points @p out at input bytes [off, off + len), copying only if they straddle segments. */
+static bool ttak_net_parser_window(ttak_net_parser_t *parser, size_t off, size_t len, ttak_net_token_t *out) {
+    out->len = len;
+    if (len == 0) {
+        out->data = ttak_net_parse_empty;
+        return true;
+    }
+    const ttak_io_chain_t *in = &parser->in;
+    size_t pos = off;
+    for (uint32_t i = 0; i < in->count; i++) {
+        const ttak_io_chain_seg_t *seg = &in->segs[i];
+        if (pos < seg->len) {
+            if (len <= seg->len - pos) {
+                out->data = seg->data + pos;
+                return true;
+            }
+            break;
+        }
+        pos -= seg->len;
+    }
+    if (parser->scratch_cap < len) {
+        size_t cap = parser->scratch_cap ? parser->scratch_cap : 256;
+        while (cap < len) cap *= 2;
+        uint8_t *scratch = realloc(parser->scratch, cap);
+        if (!scratch) return false;
+        parser->scratch = scratch;
+        parser->scratch_cap = cap;
+    }
+    ttak_io_chain_copyout(in, off, parser->scratch, len);
+    parser->copied_bytes += len;
+    out->data = parser->scratch;
+    return true;
+}
+
+/* Finds the delimiter from where the last search stopped; false if not buffered yet. */
+static bool ttak_net_parser_find_delim(ttak_net_parser_t *parser, size_t *at) {
+    const ttak_io_chain_t *in = &parser->in;
+    const uint8_t *delim = parser->delim;
+    size_t dlen = parser->cfg.delim_len;
+    size_t base = 0;
+    for (uint32_t i = 0; i < in->count; i++) {
+        const ttak_io_chain_seg_t *seg = &in->segs[i];
+        if (base + seg->len <= parser->scanned) {
+            base += seg->len;
+            continue;
+        }
+        size_t local = parser->scanned > base ? parser->scanned - base : 0;
+        while (local < seg->len) {
+            const uint8_t *hit = ttak_net_scan_byte(seg->data + local, seg->len - local, delim[0]);
+            if (!hit) break;
+            size_t pos = base + (size_t)(hit - seg->data);
+            if (dlen > 1) {
+                if (pos + dlen > in->len) {
+                    parser->scanned = pos;
+                    return false;
+                }
+                uint8_t tail[TTAK_NET_PARSE_MAX_DELIM];
+                ttak_io_chain_copyout(in, pos + 1, tail, dlen - 1);
+                if (memcmp(tail, delim + 1, dlen - 1) != 0) {
+                    local = (size_t)(hit - seg->data) + 1;
+                    continue;
+                }
+            }
+            parser->scanned = pos;
+            *at = pos;
+            return true;
+        }
+        base += seg->len;
+    }
+    parser->scanned = in->len;
+    return false;
+}
+
+static ttak_net_parse_status_t ttak_net_parser_next_length(ttak_net_parser_t *parser, ttak_net_frame_t *out) {
+    size_t lb = parser->cfg.length_bytes;
+    if (parser->in.len < lb) return TTAK_NET_PARSE_NEED_MORE;
+    uint8_t hdr[8];
+    ttak_io_chain_copyout(&parser->in, 0, hdr, lb);
+    uint64_t n = 0;
+    for (size_t i = 0; i < lb; i++) {
+        size_t b = parser->cfg.length_little_endian ? lb - 1 - i : i;
+        n = (n << 8) | hdr[b];
+    }
+    if (n > parser->cfg.max_frame) return TTAK_NET_PARSE_ERROR;
+    if (parser->in.len - lb < n) return TTAK_NET_PARSE_NEED_MORE;
+    if (!ttak_net_parser_window(parser, lb, (size_t)n, &out->payload)) return TTAK_NET_PARSE_ERROR;
+    parser->pending = lb + (size_t)n;
+    return TTAK_NET_PARSE_FRAME;
+}
+
+static ttak_net_parse_status_t ttak_net_parser_next_delim(ttak_net_parser_t *parser, ttak_net_frame_t *out) {
+    size_t at = 0;
+    if (!ttak_net_parser_find_delim(parser, &at)) {
+        return parser->scanned > parser->cfg.max_frame ? TTAK_NET_PARSE_ERROR : TTAK_NET_PARSE_NEED_MORE;
+    }
+    if (at > parser->cfg.max_frame) return TTAK_NET_PARSE_ERROR;
+    if (!ttak_net_parser_window(parser, 0, at, &out->payload)) return TTAK_NET_PARSE_ERROR;
+    parser->pending = at + parser->cfg.delim_len;
+    return TTAK_NET_PARSE_FRAME;
+}
+
+static bool ttak_net_http_is_ows(uint8_t c) {
+    return c == ' ' || c == '\t';
+}
+
+static bool ttak_net_http_name_is(const ttak_net_token_t *name, const char *lower) {
+    size_t n = strlen(lower);
+    if (name->len != n) return false;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t c = name->data[i];
+        if (c >= 'A' && c <= 'Z') c = (uint8_t)(c + ('a' - 'A'));
+        if (c != (uint8_t)lower[i]) return false;
+    }
+    return true;
+}
+
+static bool ttak_net_http_request_line(ttak_net_frame_t *out) {
+    const uint8_t *p = out->payload.data;
+    size_t len = out->payload.len;
+    const uint8_t *sp1 = ttak_net_scan_byte(p, len, ' ');
+    if (!sp1 || sp1 == p) return false;
+    const uint8_t *rest = sp1 + 1;
+    const uint8_t *sp2 = ttak_net_scan_byte(rest, len - (size_t)(rest - p), ' ');
+    if (!sp2 || sp2 == rest) return false;
+    const uint8_t *ver = sp2 + 1;
+    size_t ver_len = len - (size_t)(ver - p);
+    if (ver_len < 6 || memcmp(ver, "HTTP/", 5) != 0) return false;
+    if (ttak_net_scan_byte(ver, ver_len, ' ')) return false;
+    out->method = (ttak_net_token_t){ p, (size_t)(sp1 - p) };
+    out->target = (ttak_net_token_t){ rest, (size_t)(sp2 - rest) };
+    out->version = (ttak_net_token_t){ ver, ver_len };
+    return true;
+}
+
+static bool ttak_net_http_header(ttak_net_parser_t *parser, ttak_net_frame_t *out) {
+    const uint8_t *p = out->payload.data;
+    size_t len = out->payload.len;
+    // Obsolete line folding is rejected, as RFC 9112 allows.
+    if (ttak_net_http_is_ows(p[0])) return false;
+    const uint8_t *colon = ttak_net_scan_byte(p, len, ':');
+    if (!colon || colon == p || ttak_net_http_is_ows(colon[-1])) return false;
+    const uint8_t *v = colon + 1;
+    const uint8_t *end = p + len;
+    while (v < end && ttak_net_http_is_ows(*v)) v++;
+    while (end > v && ttak_net_http_is_ows(end[-1])) end--;
+    out->name = (ttak_net_token_t){ p, (size_t)(colon - p) };
+    out->value = (ttak_net_token_t){ v, (size_t)(end - v) };
+
+    if (ttak_net_http_name_is(&out->name, "content-length")) {
+        if (out->value.len == 0) return false;
+        uint64_t n = 0;
+        for (size_t i = 0; i < out->value.len; i++) {
+            uint8_t c = out->value.data[i];
+            if (c < '0' || c > '9' || n > (UINT64_MAX - 9) / 10) return false;
+            n = n * 10 + (uint64_t)(c - '0');
+        }
+        if (parser->has_content_length && parser->content_length != n) return false;
+        parser->has_content_length = true;
+        parser->content_length = n;
+    }
+    return true;
+}
+
+static ttak_net_parse_status_t ttak_net_parser_next_http(ttak_net_parser_t *parser, ttak_net_frame_t *out) {
+    for (;;) {
+        size_t at = 0;
+        if (!ttak_net_parser_find_delim(parser, &at)) {
+            return parser->scanned > parser->cfg.max_frame ? TTAK_NET_PARSE_ERROR : TTAK_NET_PARSE_NEED_MORE;
+        }
+        if (at > parser->cfg.max_frame) return TTAK_NET_PARSE_ERROR;
+        if (!ttak_net_parser_window(parser, 0, at, &out->payload)) return TTAK_NET_PARSE_ERROR;
+        parser->pending = at + 1;
+        if (out->payload.len > 0 && out->payload.data[out->payload.len - 1] == '\r') out->payload.len--;
+
+        if (!parser->in_headers) {
+            // Blank lines before a request line are ignored.
+            if (out->payload.len == 0) {
+                ttak_net_parser_drop_pending(parser);
+                continue;
+            }
+            if (!ttak_net_http_request_line(out)) return TTAK_NET_PARSE_ERROR;
+            parser->in_headers = true;
+            parser->has_content_length = false;
+            parser->content_length = 0;
+            out->http = TTAK_NET_HTTP_REQUEST_LINE;
+            return TTAK_NET_PARSE_FRAME;
+        }
+        if (out->payload.len == 0) {
+            parser->in_headers = false;
+            out->http = TTAK_NET_HTTP_HEADERS_DONE;
+            return TTAK_NET_PARSE_FRAME;
+        }
+        if (!ttak_net_http_header(parser, out)) return TTAK_NET_PARSE_ERROR;
+        out->http = TTAK_NET_HTTP_HEADER;
+        return TTAK_NET_PARSE_FRAME;
+    }
+}
+
+ttak_net_parse_status_t ttak_net_parser_next(ttak_net_parser_t *parser, ttak_net_frame_t *out) {
+    if (!parser || !out) return TTAK_NET_PARSE_ERROR;
+    ttak_net_parser_drop_pending(parser);
+    memset(out, 0, sizeof(*out));
+    ttak_net_parse_status_t status;
+    switch (parser->cfg.kind) {
+    case TTAK_NET_FRAME_LENGTH:
+        status = ttak_net_parser_next_length(parser, out);
+        break;
+    case TTAK_NET_FRAME_DELIMITER:
+        status = ttak_net_parser_next_delim(parser, out);
+        break;
+    case TTAK_NET_FRAME_HTTP1:
+        status = ttak_net_parser_next_http(parser, out);
+        break;
+    default:
+        status = TTAK_NET_PARSE_ERROR;
+        break;
+    }
+    if (status == TTAK_NET_PARSE_FRAME) parser->frames++;
+    return status;
+}
+
+ttak_net_parse_status_t ttak_net_parser_take(ttak_net_parser_t *parser, size_t len, ttak_net_token_t *out) {
+    if (!parser || !out) return TTAK_NET_PARSE_ERROR;
+    ttak_net_parser_drop_pending(parser);
+    if (parser->in.len < len) return TTAK_NET_PARSE_NEED_MORE;
+    if (!ttak_net_parser_window(parser, 0, len, out)) return TTAK_NET_PARSE_ERROR;
+    parser->pending = len;
+    parser->scanned = 0;
+    return TTAK_NET_PARSE_FRAME;
+}
@@ -2,10 +2,12 @@
  * @file session.c
  * @brief Network session manager: create, close, tick, and fault handling.
  *
- * Maintains a linked list of active sessions keyed by 64-bit ID.  A
- * periodic sanity tick checks immortal sockets and applies the configured
- * alert/restart policy.  Retiring and fault-queue processing can be
- * offloaded to an async worker thread.
+ * Sessions are spread over TTAK_NET_SESSION_SHARDS lists by a hash of
+ * their 64-bit ID, each behind its own lock, so create and close contend
+ * only on the shards they touch.  Immortal sockets keep a sanity timer on
+ * the manager's wheel; a tick fires just the checks that are due and
+ * applies the configured alert/restart policy.  Retiring and fault-queue
+ * processing can be offloaded to an async worker thread.
  */
 
 #include <ttak/net/session.h>
@@ -15,6 +17,7 @@
 #include <ttak/async/task.h>
 #include <ttak/async/sched.h>
 #include <ttak/timing/timing.h>
+#include <ttak/log/logger.h>
 #include <pthread.h>
 
 #include <inttypes.h>
@@ -48,27 +51,9 @@ static void ttak_net_session_free(void *ptr) {
     ttak_mem_free(ptr);
 }
 
-static void ttak_net_session_detach_locked(ttak_net_session_mgr_t *mgr,
-                                           ttak_net_session_t *session) {
-    if (!session) return;
-    ttak_net_session_t **cursor = session->parent ? &session->parent->first_child : &mgr->head;
-    while (*cursor) {
-        if (*cursor == session) {
-            *cursor = session->next_sibling;
-            break;
-        }
-        cursor = &(*cursor)->next_sibling;
-    }
-    session->next_sibling = NULL;
-    session->parent = NULL;
-}
-
-static void ttak_net_session_queue_retire(ttak_net_session_mgr_t *mgr,
-                                          ttak_net_session_t *session,
-                                          uint64_t now) {
-    (void)now;
-    session->next_retire = mgr->retire_head;
-    mgr->retire_head = session;
+static inline ttak_net_session_shard_t *ttak_net_session_shard(ttak_net_session_mgr_t *mgr, uint64_t id) {
+    uint64_t h = id * 0x9E3779B97F4A7C15ULL;
+    return &mgr->shards[(h >> 32) & (TTAK_NET_SESSION_SHARDS - 1U)];
 }
 
 static void ttak_net_session_flush_retire(ttak_net_session_t *list) {
@@ -80,38 +65,95 @@ static void ttak_net_session_flush_retire(ttak_net_session_t *list) {
     }
 }
 
-static void ttak_net_session_mark_for_retire(ttak_net_session_mgr_t *mgr,
-                                             ttak_net_session_t *session,
-                                             uint64_t now) {
-    if (!session) return;
-    ttak_net_session_t *child = session->first_child;
-    while (child) {
-        ttak_net_session_t *next = child->next_sibling;
-        ttak_net_session_mark_for_retire(mgr, child, now);
-        child = next;
+/* Unlinks @p session from its parent's child list, or its shard's root list. */
+static void ttak_net_session_detach(ttak_net_session_mgr_t *mgr, ttak_net_session_t *session) {
+    ttak_net_session_t *parent = session->parent;
+    ttak_net_session_shard_t *shard = ttak_net_session_shard(mgr, parent ? parent->id : session->id);
+    ttak_mutex_lock(&shard->lock);
+    // A zombie parent's list is already owned by whoever is retiring it.
+    if (!parent || !(parent->state_flags & TTAK_NET_SESSION_ZOMBIE)) {
+        ttak_net_session_t **cursor = parent ? &parent->first_child : &shard->head;
+        while (*cursor) {
+            if (*cursor == session) {
+                *cursor = session->next_sibling;
+                session->next_sibling = NULL;
+                break;
+            }
+            cursor = &(*cursor)->next_sibling;
+        }
     }
+    ttak_mutex_unlock(&shard->lock);
+}
+
+/*
+ * Marks @p session and its descendants as zombies and queues them on @p list.
+ * Each session is claimed under its own shard lock, one lock at a time, so a
+ * subtree spread over many shards never holds two.
+ */
+static void ttak_net_session_retire_subtree(ttak_net_session_mgr_t *mgr,
+                                            ttak_net_session_t *session,
+                                            uint64_t now,
+                                            ttak_net_session_t **list) {
+    ttak_net_session_shard_t *shard = ttak_net_session_shard(mgr, session->id);
+    ttak_mutex_lock(&shard->lock);
+    if (session->state_flags & TTAK_NET_SESSION_ZOMBIE) {
+        ttak_mutex_unlock(&shard->lock);
+        return;
+    }
+    session->state_flags |= TTAK_NET_SESSION_ZOMBIE;
+    ttak_net_session_t *child = session->first_child;
     session->first_child = NULL;
+    ttak_timer_cancel(&mgr->wheel, &session->sanity_timer);
+    ttak_mutex_unlock(&shard->lock);
 
     if (session->endpoint) {
         ttak_net_endpoint_close(session->endpoint, session->owner, now);
     }
+    session->next_retire = *list;
+    *list = session;
 
-    ttak_net_session_detach_locked(mgr, session);
-    session->state_flags |= TTAK_NET_SESSION_ZOMBIE;
-    ttak_net_session_queue_retire(mgr, session, now);
+    while (child) {
+        ttak_net_session_t *next = child->next_sibling;
+        ttak_net_session_retire_subtree(mgr, child, now, list);
+        child = next;
+    }
+}
+
+static void ttak_net_session_close_internal(ttak_net_session_mgr_t *mgr,
+                                            ttak_net_session_t *session,
+                                            uint64_t now) {
+    ttak_net_session_t *pending = NULL;
+    ttak_epoch_enter();
+    ttak_net_session_detach(mgr, session);
+    ttak_net_session_retire_subtree(mgr, session, now, &pending);
+    ttak_net_session_flush_retire(pending);
+    ttak_epoch_exit();
+}
+
+/* Arms the next sanity check; the caller holds the session's shard lock. */
+static void ttak_net_session_arm_locked(ttak_net_session_mgr_t *mgr,
+                                        ttak_net_session_t *session,
+                                        uint64_t now) {
+    session->next_sanity_ns = now + TTAK_NET_SANITY_INTERVAL_NS;
+    ttak_timer_arm(&mgr->wheel, &session->sanity_timer, session->next_sanity_ns);
 }
 
+static void *ttak_net_session_sanity_fire(void *arg);
+
 void ttak_net_session_mgr_init(ttak_net_session_mgr_t *mgr, bool async_offload) {
     if (!mgr) return;
     pthread_once(&net_port_once, net_port_bootstrap);
-    ttak_rwlock_init(&mgr->lock);
-    mgr->head = NULL;
-    mgr->next_id = 1;
+    for (uint32_t i = 0; i < TTAK_NET_SESSION_SHARDS; i++) {
+        ttak_mutex_init(&mgr->shards[i].lock);
+        mgr->shards[i].head = NULL;
+    }
+    atomic_init(&mgr->next_id, 1);
     mgr->policy_flags = 0;
-    mgr->retire_head = NULL;
     mgr->fault_head = NULL;
     mgr->async_offload = async_offload;
     mgr->net_ops = &global_net_ops;
+    ttak_timer_wheel_init(&mgr->wheel, 0, 0);
+    atomic_init(&mgr->tick_now, 0);
 }
 
 void ttak_net_session_mgr_set_policy(ttak_net_session_mgr_t *mgr, uint32_t flags) {
@@ -132,43 +174,57 @@ ttak_net_session_t *ttak_net_session_mgr_create(ttak_net_session_mgr_t *mgr,
     session->endpoint = endpoint;
     session->parent = parent;
     session->owner = owner;
+    session->mgr = mgr;
     session->generation = now;
     session->state_flags = TTAK_NET_SESSION_ACTIVE;
     session->lifetime_ns = TTAK_NET_SANITY_INTERVAL_NS;
     session->next_sanity_ns = now + TTAK_NET_SANITY_INTERVAL_NS;
+    ttak_timer_init(&session->sanity_timer, ttak_net_session_sanity_fire, session);
 
     ttak_shared_result_t res = 0;
     ttak_net_endpoint_t *payload = ttak_shared_net_endpoint_access(endpoint, owner, &res);
     if (payload && res == TTAK_OWNER_SUCCESS) {
         uint64_t ttl = payload->guard.ttl_ns;
+        session->affinity = ttak_io_guard_affinity(&payload->guard);
         if (ttl == UINT64_MAX) {
             session->state_flags |= TTAK_NET_SESSION_IMMORTAL;
             session->lifetime_ns = UINT64_MAX;
-            session->next_sanity_ns = UINT64_MAX;
         } else if (ttl > 0) {
             session->lifetime_ns = ttl;
             session->next_sanity_ns = now + ttl;
-        } else {
-            session->lifetime_ns = TTAK_NET_SANITY_INTERVAL_NS;
-            session->next_sanity_ns = now + TTAK_NET_SANITY_INTERVAL_NS;
         }
         ttak_shared_net_endpoint_release(endpoint);
     }
 
-    ttak_rwlock_wrlock(&mgr->lock);
-    session->id = mgr->next_id++;
-    if (parent) {
-        session->next_sibling = parent->first_child;
-        parent->first_child = session;
-    } else {
-        session->next_sibling = mgr->head;
-        mgr->head = session;
+    session->id = atomic_fetch_add_explicit(&mgr->next_id, 1, memory_order_relaxed);
+    ttak_net_session_shard_t *shard = ttak_net_session_shard(mgr, parent ? parent->id : session->id);
+    ttak_mutex_lock(&shard->lock);
+    if (parent && (parent->state_flags & TTAK_NET_SESSION_ZOMBIE)) {
+        ttak_mutex_unlock(&shard->lock);
+        ttak_mem_free(session);
+        return NULL;
+    }
+    ttak_net_session_t **head = parent ? &parent->first_child : &shard->head;
+    session->next_sibling = *head;
+    *head = session;
+    ttak_mutex_unlock(&shard->lock);
+
+    if (session->state_flags & TTAK_NET_SESSION_IMMORTAL) {
+        // The parent's close may already have claimed the new child.
+        shard = ttak_net_session_shard(mgr, session->id);
+        ttak_mutex_lock(&shard->lock);
+        if (!(session->state_flags & TTAK_NET_SESSION_ZOMBIE)) {
+            ttak_net_session_arm_locked(mgr, session, now);
+        }
+        ttak_mutex_unlock(&shard->lock);
     }
-    ttak_rwlock_unlock(&mgr->lock);
     return session;
 }
 
 static void ttak_net_session_log_alert(const ttak_net_session_t *session) {
+    /* A dead peer can fail every health check; keep the alerts from flooding stderr. */
+    static ttak_log_limit_t limit = TTAK_LOG_LIMIT_INIT(10.0, 20.0, 1);
+    if (!ttak_logger_limit_pass(NULL, &limit, TTAK_LOG_WARN, __FILE__, __LINE__)) return;
     fprintf(stderr,
             "[TTAK_SOCK_ALERT] session=%" PRIu64 " owner=%p endpoint=%p\n",
             session ? session->id : 0,
@@ -202,34 +258,24 @@ static void ttak_net_session_finish_restart(ttak_net_session_mgr_t *mgr,
                                             ttak_net_session_t *session,
                                             ttak_io_status_t status,
                                             uint64_t now) {
-    ttak_net_session_t *pending = NULL;
-    ttak_rwlock_wrlock(&mgr->lock);
-    if (!(session->state_flags & TTAK_NET_SESSION_ZOMBIE)) {
-        if (status == TTAK_IO_SUCCESS) {
-            session->state_flags &= ~(TTAK_NET_SESSION_NEEDS_RESTART | TTAK_NET_SESSION_FAULTING);
-            session->state_flags |= TTAK_NET_SESSION_ACTIVE;
-            session->next_sanity_ns = now + TTAK_NET_SANITY_INTERVAL_NS;
-        } else {
-            ttak_net_session_mark_for_retire(mgr, session, now);
-            pending = mgr->retire_head;
-            mgr->retire_head = NULL;
-        }
+    if (status != TTAK_IO_SUCCESS) {
+        ttak_net_session_close_internal(mgr, session, now);
+        return;
     }
-    ttak_rwlock_unlock(&mgr->lock);
-    if (pending) {
-        ttak_net_session_flush_retire(pending);
+    ttak_net_session_shard_t *shard = ttak_net_session_shard(mgr, session->id);
+    ttak_mutex_lock(&shard->lock);
+    if (!(session->state_flags & TTAK_NET_SESSION_ZOMBIE)) {
+        session->state_flags &= ~(TTAK_NET_SESSION_NEEDS_RESTART | TTAK_NET_SESSION_FAULTING);
+        session->state_flags |= TTAK_NET_SESSION_ACTIVE;
+        ttak_net_session_arm_locked(mgr, session, now);
     }
+    ttak_mutex_unlock(&shard->lock);
 }
 
 static void ttak_net_session_finish_shutdown(ttak_net_session_mgr_t *mgr,
                                              ttak_net_session_t *session,
                                              uint64_t now) {
-    ttak_rwlock_wrlock(&mgr->lock);
-    ttak_net_session_mark_for_retire(mgr, session, now);
-    ttak_net_session_t *pending = mgr->retire_head;
-    mgr->retire_head = NULL;
-    ttak_rwlock_unlock(&mgr->lock);
-    ttak_net_session_flush_retire(pending);
+    ttak_net_session_close_internal(mgr, session, now);
 }
 
 static void ttak_net_session_dispatch_fault(ttak_net_session_mgr_t *mgr,
@@ -240,66 +286,66 @@ void ttak_net_session_mgr_close(ttak_net_session_mgr_t *mgr,
                                 ttak_net_session_t *session,
                                 uint64_t now) {
     if (!mgr || !session) return;
-    ttak_rwlock_wrlock(&mgr->lock);
-    ttak_net_session_mark_for_retire(mgr, session, now);
-    ttak_net_session_t *pending = mgr->retire_head;
-    mgr->retire_head = NULL;
-    ttak_rwlock_unlock(&mgr->lock);
-    ttak_net_session_flush_retire(pending);
+    ttak_net_session_close_internal(mgr, session, now);
 }
 
-static void ttak_net_session_collect_pending(ttak_net_session_t *node,
-                                             uint64_t now,
-                                             ttak_net_session_t **pending) {
-    while (node) {
-        if (!(node->state_flags & TTAK_NET_SESSION_ZOMBIE) &&
-            (node->state_flags & TTAK_NET_SESSION_IMMORTAL) &&
-            now >= node->next_sanity_ns) {
-            node->next_sanity_ns = now + TTAK_NET_SANITY_INTERVAL_NS;
-            node->sanity_next = *pending;
-            *pending = node;
-        }
-        if (node->first_child) {
-            ttak_net_session_collect_pending(node->first_child, now, pending);
-        }
-        node = node->next_sibling;
+/* Sanity timer callback: runs inside the tick's epoch section. */
+static void *ttak_net_session_sanity_fire(void *arg) {
+    ttak_net_session_t *session = arg;
+    ttak_net_session_mgr_t *mgr = session->mgr;
+    uint64_t now = atomic_load_explicit(&mgr->tick_now, memory_order_relaxed);
+    ttak_net_session_shard_t *shard = ttak_net_session_shard(mgr, session->id);
+
+    ttak_mutex_lock(&shard->lock);
+    bool live = !(session->state_flags & TTAK_NET_SESSION_ZOMBIE) &&
+                (session->state_flags & TTAK_NET_SESSION_IMMORTAL);
+    ttak_mutex_unlock(&shard->lock);
+    if (!live) return NULL;
+
+    if (!ttak_net_session_guard_healthy(session, now)) {
+        ttak_net_session_dispatch_fault(mgr, session, now);
+        return NULL;
     }
+    ttak_mutex_lock(&shard->lock);
+    if (!(session->state_flags & TTAK_NET_SESSION_ZOMBIE)) {
+        ttak_net_session_arm_locked(mgr, session, now);
+    }
+    ttak_mutex_unlock(&shard->lock);
+    return NULL;
 }
 
 void ttak_net_session_mgr_tick(ttak_net_session_mgr_t *mgr, uint64_t now) {
     if (!mgr) return;
-    ttak_rwlock_wrlock(&mgr->lock);
-    ttak_net_session_t *pending = NULL;
-    ttak_net_session_collect_pending(mgr->head, now, &pending);
-    ttak_rwlock_unlock(&mgr->lock);
-
-    while (pending) {
-        ttak_net_session_t *current = pending;
-        pending = pending->sanity_next;
-        current->sanity_next = NULL;
-        if (!ttak_net_session_guard_healthy(current, now)) {
-            ttak_net_session_dispatch_fault(mgr, current, now);
-        }
-    }
+    atomic_store_explicit(&mgr->tick_now, now, memory_order_relaxed);
+    ttak_epoch_enter();
+    ttak_timer_wheel_advance(&mgr->wheel, now);
+    ttak_epoch_exit();
 }
 
 void ttak_net_session_mgr_destroy(ttak_net_session_mgr_t *mgr, uint64_t now) {
     if (!mgr) return;
 
-    ttak_rwlock_wrlock(&mgr->lock);
-    ttak_net_session_t *cursor = mgr->head;
-    while (cursor) {
-        ttak_net_session_t *next = cursor->next_sibling;
-        ttak_net_session_mark_for_retire(mgr, cursor, now);
-        cursor = next;
+    ttak_net_session_t *pending = NULL;
+    ttak_epoch_enter();
+    for (uint32_t i = 0; i < TTAK_NET_SESSION_SHARDS; i++) {
+        ttak_net_session_shard_t *shard = &mgr->shards[i];
+        ttak_mutex_lock(&shard->lock);
+        ttak_net_session_t *cursor = shard->head;
+        shard->head = NULL;
+        ttak_mutex_unlock(&shard->lock);
+        while (cursor) {
+            ttak_net_session_t *next = cursor->next_sibling;
+            ttak_net_session_retire_subtree(mgr, cursor, now, &pending);
+            cursor = next;
+        }
     }
-    mgr->head = NULL;
-    ttak_net_session_t *pending = mgr->retire_head;
-    mgr->retire_head = NULL;
-    ttak_rwlock_unlock(&mgr->lock);
-
     ttak_net_session_flush_retire(pending);
-    ttak_rwlock_destroy(&mgr->lock);
+    ttak_epoch_exit();
+
+    ttak_timer_wheel_destroy(&mgr->wheel);
+    for (uint32_t i = 0; i < TTAK_NET_SESSION_SHARDS; i++) {
+        ttak_mutex_destroy(&mgr->shards[i].lock);
+    }
 }
 typedef struct ttak_net_session_task_ctx {
     ttak_net_session_mgr_t *mgr;
@@ -370,6 +416,7 @@ static bool ttak_net_session_enqueue_task(ttak_net_session_mgr_t *mgr,
         return false;
     }
     ttak_task_set_domain(task, TTAK_TASK_DOMAIN_NET);
+    if (session->affinity) ttak_task_set_hash(task, session->affinity);
     ttak_task_set_urgency(task, 85);
     ttak_async_schedule(task, now, 0);
     return true;
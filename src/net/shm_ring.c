@@ -0,0 +1,573 @@
+/**
+ * @file shm_ring.c
+ * @brief Shared-memory record ring over shm_open() or memfd objects.
+ *
+ * Three cursors in the control block split the ring, all absolute byte
+ * positions that only grow:
+ *   - tail: space below it is free for producers.
+ *   - read: records below it are claimed by consumers.
+ *   - head: space below it is reserved by producers.
+ * A producer reserves [head, head + size) and publishes the record by
+ * storing its position, tagged, into the header's state word; a consumer
+ * at @c read takes the record only if the state names that exact
+ * position, so stale headers from earlier laps never match. Releasing a
+ * record clears the state word of every granule it covered before @c tail
+ * moves past it, so payload bytes from an earlier lap cannot pose as a
+ * header either.
+ */
+
+#include <ttak/net/shm_ring.h>
+
+#include <errno.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/timing/timing.h>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+#define SHM_RING_MAGIC 0x52485354U   /* "TSHR" */
+#define SHM_RING_VERSION 1U
+/** Bytes in front of the record space; holds the control block. */
+#define SHM_RING_CTL_SIZE 4096U
+
+/** Low bits of a state word; positions are multiples of 64. */
+#define SHM_STATE_COMMITTED 1U
+#define SHM_STATE_PADDING 3U
+
+#define SHM_RECORD_HDR sizeof(ttak_net_shm_record_t)
+
+/** Polls of the release hand-off before a consumer yields. */
+#define SHM_RELEASE_SPINS 256
+
+/**
+ * @brief Control block at offset 0 of the shared object.
+ *
+ * @c magic is stored last by the creator; openers refuse the object until
+ * it reads SHM_RING_MAGIC.
+ */
+typedef struct shm_ring_ctl {
+    _Atomic uint32_t magic;
+    uint32_t version;
+    uint32_t mode;
+    uint32_t max_record;
+    uint64_t capacity;
+    _Alignas(64) _Atomic uint64_t head;
+    _Alignas(64) _Atomic uint64_t read;
+    _Alignas(64) _Atomic uint64_t tail;
+    _Alignas(64) ttak_eventcount_t readable;
+    _Alignas(64) ttak_eventcount_t writable;
+} shm_ring_ctl_t;
+
+_Static_assert(sizeof(shm_ring_ctl_t) <= SHM_RING_CTL_SIZE, "shm ring control block exceeds its page");
+_Static_assert(sizeof(ttak_net_shm_record_t) == 24, "shm record header layout changed");
+
+struct ttak_net_shm_ring {
+    shm_ring_ctl_t *ctl;
+    uint8_t *data;
+    size_t map_len;
+    uint64_t capacity;
+    uint64_t mask;
+    uint32_t max_record;
+    bool mpmc;
+    int fd;
+    _Atomic uint64_t sent;
+    _Atomic uint64_t received;
+    _Atomic uint64_t full;
+    _Atomic uint64_t dropped;
+};
+
+static inline uint64_t shm_round(uint64_t n) {
+    return (n + TTAK_NET_SHM_RING_ALIGN - 1) & ~(uint64_t)(TTAK_NET_SHM_RING_ALIGN - 1);
+}
+
+static inline ttak_net_shm_record_t *shm_record_at(const ttak_net_shm_ring_t *ring, uint64_t pos) {
+    return (ttak_net_shm_record_t *)(ring->data + (pos & ring->mask));
+}
+
+static uint64_t shm_deadline(uint64_t timeout_ns) {
+    if (timeout_ns == TTAK_WAIT_FOREVER) return TTAK_WAIT_FOREVER;
+    uint64_t now = ttak_get_tick_count_ns();
+    return timeout_ns > TTAK_WAIT_FOREVER - now ? TTAK_WAIT_FOREVER : now + timeout_ns;
+}
+
+/**
+ * @brief Time left until @p deadline; 0 once it has passed.
+ */
+static uint64_t shm_time_left(uint64_t deadline) {
+    if (deadline == TTAK_WAIT_FOREVER) return TTAK_WAIT_FOREVER;
+    uint64_t now = ttak_get_tick_count_ns();
+    return now >= deadline ? 0 : deadline - now;
+}
+
+static int shm_memfd(void) {
+#if defined(__linux__) && defined(SYS_memfd_create)
+    int mfd = (int)syscall(SYS_memfd_create, "ttak_shm_ring", MFD_CLOEXEC);
+    if (mfd >= 0 || errno != ENOSYS) return mfd;
+#endif
+    /* No memfd: an exclusive name, unlinked at once, is just as anonymous. */
+    static _Atomic uint32_t counter;
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        char name[64];
+        snprintf(name, sizeof(name), "/ttak-shm-%ld-%u", (long)getpid(), atomic_fetch_add(&counter, 1));
+        int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) {
+            shm_unlink(name);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+            return fd;
+        }
+        if (errno != EEXIST) return -1;
+    }
+    errno = EEXIST;
+    return -1;
+}
+
+/**
+ * @brief Maps @p fd and checks its control block; takes ownership of @p fd.
+ */
+static ttak_net_shm_ring_t *shm_ring_map(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) goto fail_fd;
+    if ((uint64_t)st.st_size < SHM_RING_CTL_SIZE + TTAK_NET_SHM_RING_MIN_CAPACITY) {
+        errno = st.st_size == 0 ? EAGAIN : EINVAL;
+        goto fail_fd;
+    }
+    size_t map_len = (size_t)st.st_size;
+    void *base = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) goto fail_fd;
+
+    shm_ring_ctl_t *ctl = base;
+    uint32_t magic = atomic_load_explicit(&ctl->magic, memory_order_acquire);
+    uint64_t cap = ctl->capacity;
+    if (magic != SHM_RING_MAGIC) {
+        errno = magic == 0 ? EAGAIN : EINVAL;
+        goto fail_map;
+    }
+    if (ctl->version != SHM_RING_VERSION || ctl->mode > TTAK_NET_SHM_RING_MPMC ||
+        cap < TTAK_NET_SHM_RING_MIN_CAPACITY || (cap & (cap - 1)) != 0 ||
+        cap > (uint64_t)map_len - SHM_RING_CTL_SIZE ||
+        ctl->max_record == 0 || SHM_RECORD_HDR + ctl->max_record > cap / 2) {
+        errno = EINVAL;
+        goto fail_map;
+    }
+
+    ttak_net_shm_ring_t *ring = calloc(1, sizeof(*ring));
+    if (!ring) goto fail_map;
+    ring->ctl = ctl;
+    ring->data = (uint8_t *)base + SHM_RING_CTL_SIZE;
+    ring->map_len = map_len;
+    ring->capacity = cap;
+    ring->mask = cap - 1;
+    ring->max_record = ctl->max_record;
+    ring->mpmc = ctl->mode == TTAK_NET_SHM_RING_MPMC;
+    ring->fd = fd;
+    return ring;
+
+fail_map: {
+        int err = errno;
+        munmap(base, map_len);
+        errno = err;
+    }
+fail_fd: {
+        int err = errno;
+        close(fd);
+        errno = err;
+    }
+    return NULL;
+}
+
+ttak_net_shm_ring_t *ttak_net_shm_ring_create(const char *name, size_t capacity, ttak_net_shm_ring_mode_t mode) {
+    if (mode != TTAK_NET_SHM_RING_SPSC && mode != TTAK_NET_SHM_RING_MPMC) {
+        errno = EINVAL;
+        return NULL;
+    }
+    uint64_t cap = TTAK_NET_SHM_RING_MIN_CAPACITY;
+    while (cap < capacity) {
+        if (cap > (uint64_t)(SIZE_MAX / 4)) {
+            errno = EINVAL;
+            return NULL;
+        }
+        cap <<= 1;
+    }
+
+    int fd = name ? shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600) : shm_memfd();
+    if (fd < 0) return NULL;
+    if (name) fcntl(fd, F_SETFD, FD_CLOEXEC);
+    size_t map_len = SHM_RING_CTL_SIZE + (size_t)cap;
+    if (ftruncate(fd, (off_t)map_len) != 0) {
+        int err = errno;
+        close(fd);
+        if (name) shm_unlink(name);
+        errno = err;
+        return NULL;
+    }
+    void *base = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        int err = errno;
+        close(fd);
+        if (name) shm_unlink(name);
+        errno = err;
+        return NULL;
+    }
+
+    /* A fresh object reads as zeros: cursors at 0, every state word stale. */
+    shm_ring_ctl_t *ctl = base;
+    uint64_t max_record = cap / 2 - SHM_RECORD_HDR;
+    if (max_record > TTAK_LATTICE_MAX_SLOT_SIZE) max_record = TTAK_LATTICE_MAX_SLOT_SIZE;
+    ctl->version = SHM_RING_VERSION;
+    ctl->mode = (uint32_t)mode;
+    ctl->max_record = (uint32_t)max_record;
+    ctl->capacity = cap;
+    ttak_eventcount_init(&ctl->readable);
+    ttak_eventcount_init(&ctl->writable);
+    atomic_store_explicit(&ctl->magic, SHM_RING_MAGIC, memory_order_release);
+    munmap(base, map_len);
+
+    ttak_net_shm_ring_t *ring = shm_ring_map(fd);
+    if (!ring && name) {
+        int err = errno;
+        shm_unlink(name);
+        errno = err;
+    }
+    return ring;
+}
+
+ttak_net_shm_ring_t *ttak_net_shm_ring_open(const char *name) {
+    if (!name) {
+        errno = EINVAL;
+        return NULL;
+    }
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) return NULL;
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return shm_ring_map(fd);
+}
+
+ttak_net_shm_ring_t *ttak_net_shm_ring_open_fd(int fd) {
+    int dup_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (dup_fd < 0) return NULL;
+    return shm_ring_map(dup_fd);
+}
+
+void ttak_net_shm_ring_close(ttak_net_shm_ring_t *ring) {
+    if (!ring) return;
+    munmap(ring->ctl, ring->map_len);
+    close(ring->fd);
+    free(ring);
+}
+
+int ttak_net_shm_ring_unlink(const char *name) {
+    if (!name) return EINVAL;
+    return shm_unlink(name) == 0 ? 0 : errno;
+}
+
+int ttak_net_shm_ring_fd(const ttak_net_shm_ring_t *ring) {
+    return ring ? ring->fd : -1;
+}
+
+uint32_t ttak_net_shm_ring_max_record(const ttak_net_shm_ring_t *ring) {
+    return ring ? ring->max_record : 0;
+}
+
+/**
+ * @brief Reserves room for a record of @p need bytes plus any wrap padding.
+ *
+ * @return Position of the reservation, or UINT64_MAX if the ring is full.
+ *         @p pad_out receives the padding bytes in front of the record.
+ */
+static uint64_t shm_reserve(ttak_net_shm_ring_t *ring, uint64_t need, uint64_t *pad_out) {
+    shm_ring_ctl_t *ctl = ring->ctl;
+    uint64_t pos = atomic_load_explicit(&ctl->head, memory_order_relaxed);
+    for (;;) {
+        uint64_t room_to_end = ring->capacity - (pos & ring->mask);
+        uint64_t pad = room_to_end < need ? room_to_end : 0;
+        uint64_t tail = atomic_load_explicit(&ctl->tail, memory_order_acquire);
+        if (pos + pad + need - tail > ring->capacity) return UINT64_MAX;
+        if (!ring->mpmc) {
+            atomic_store_explicit(&ctl->head, pos + pad + need, memory_order_relaxed);
+        } else if (!atomic_compare_exchange_weak_explicit(&ctl->head, &pos, pos + pad + need,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+            continue;
+        }
+        *pad_out = pad;
+        return pos;
+    }
+}
+
+bool ttak_net_shm_ring_send(ttak_net_shm_ring_t *ring, const void *data, uint32_t len, uint64_t now,
+                            uint64_t timeout_ns) {
+    if (!ring || (len && !data) || len > ring->max_record) return false;
+    shm_ring_ctl_t *ctl = ring->ctl;
+    uint64_t need = shm_round(SHM_RECORD_HDR + len);
+    uint64_t pad = 0;
+    uint64_t pos = shm_reserve(ring, need, &pad);
+    if (pos == UINT64_MAX) {
+        atomic_fetch_add_explicit(&ring->full, 1, memory_order_relaxed);
+        uint64_t deadline = shm_deadline(timeout_ns);
+        for (;;) {
+            uint64_t left = shm_time_left(deadline);
+            if (left == 0) return false;
+            uint32_t key = ttak_eventcount_prepare(&ctl->writable);
+            pos = shm_reserve(ring, need, &pad);
+            if (pos != UINT64_MAX) {
+                ttak_eventcount_cancel(&ctl->writable);
+                break;
+            }
+            ttak_eventcount_wait_shared(&ctl->writable, key, left);
+        }
+    }
+
+    if (pad) {
+        ttak_net_shm_record_t *filler = shm_record_at(ring, pos);
+        filler->timestamp = now;
+        filler->len = 0;
+        filler->seq = (uint32_t)(pos / TTAK_NET_SHM_RING_ALIGN);
+        atomic_store_explicit(&filler->state, pos | SHM_STATE_PADDING, memory_order_release);
+        pos += pad;
+    }
+    ttak_net_shm_record_t *rec = shm_record_at(ring, pos);
+    rec->timestamp = now;
+    rec->len = len;
+    rec->seq = (uint32_t)(pos / TTAK_NET_SHM_RING_ALIGN);
+    if (len) memcpy(rec + 1, data, len);
+    atomic_store_explicit(&rec->state, pos | SHM_STATE_COMMITTED, memory_order_release);
+
+    atomic_fetch_add_explicit(&ring->sent, 1, memory_order_relaxed);
+    ttak_eventcount_notify_shared(&ctl->readable, false);
+    return true;
+}
+
+/**
+ * @brief Hands [@p pos, @p pos + @p size) back to producers.
+ *
+ * MPMC consumers finish out of order, so each waits until every record in
+ * front of its own has been released.
+ */
+static void shm_release(ttak_net_shm_ring_t *ring, uint64_t pos, uint64_t size) {
+    shm_ring_ctl_t *ctl = ring->ctl;
+    for (uint64_t off = 0; off < size; off += TTAK_NET_SHM_RING_ALIGN) {
+        atomic_store_explicit(&shm_record_at(ring, pos + off)->state, 0, memory_order_relaxed);
+    }
+    if (ring->mpmc) {
+        int spins = 0;
+        while (atomic_load_explicit(&ctl->tail, memory_order_acquire) != pos) {
+            if (++spins < SHM_RELEASE_SPINS) ttak_arch_pause();
+            else sched_yield();
+        }
+    }
+    atomic_store_explicit(&ctl->tail, pos + size, memory_order_release);
+    ttak_eventcount_notify_shared(&ctl->writable, ring->mpmc);
+}
+
+/**
+ * @brief Claims the next record, together with any padding in front of it.
+ *
+ * @param max_len Records longer than this are left unclaimed.
+ * @return The record, or NULL if none is ready or it is too long; in the
+ *         latter case @p len_out holds its length, otherwise 0. The claimed
+ *         span is [*@p pos_out, *@p pos_out + *@p size_out).
+ */
+static ttak_net_shm_record_t *shm_claim(ttak_net_shm_ring_t *ring, uint32_t max_len, uint64_t *pos_out,
+                                        uint64_t *size_out, uint32_t *len_out) {
+    shm_ring_ctl_t *ctl = ring->ctl;
+    uint64_t pos = atomic_load_explicit(&ctl->read, memory_order_relaxed);
+    *len_out = 0;
+    for (;;) {
+        ttak_net_shm_record_t *rec = shm_record_at(ring, pos);
+        uint64_t state = atomic_load_explicit(&rec->state, memory_order_acquire);
+        uint64_t pad = 0;
+        if (state == (pos | SHM_STATE_PADDING)) {
+            pad = ring->capacity - (pos & ring->mask);
+            rec = shm_record_at(ring, pos + pad);
+            state = atomic_load_explicit(&rec->state, memory_order_acquire);
+        }
+        if (state != ((pos + pad) | SHM_STATE_COMMITTED)) return NULL;
+        uint32_t len = rec->len;
+        if (len > ring->max_record) return NULL;
+        uint64_t size = pad + shm_round(SHM_RECORD_HDR + len);
+
+        if (len > max_len) {
+            /* Trust the length only if nobody claimed the record meanwhile. */
+            uint64_t cur = atomic_load_explicit(&ctl->read, memory_order_acquire);
+            if (cur != pos) {
+                pos = cur;
+                continue;
+            }
+            *len_out = len;
+            return NULL;
+        }
+        if (!ring->mpmc) {
+            atomic_store_explicit(&ctl->read, pos + size, memory_order_relaxed);
+        } else if (!atomic_compare_exchange_weak_explicit(&ctl->read, &pos, pos + size,
+                                                          memory_order_acquire, memory_order_relaxed)) {
+            /* Fields read before a failed claim may be stale; start over. */
+            continue;
+        }
+        *pos_out = pos;
+        *size_out = size;
+        *len_out = len;
+        return rec;
+    }
+}
+
+bool ttak_net_shm_ring_recv(ttak_net_shm_ring_t *ring, void *dst, size_t cap, uint32_t *len_out,
+                            uint64_t *ts_out, uint64_t timeout_ns) {
+    uint32_t len = 0;
+    if (len_out) *len_out = 0;
+    if (!ring || (cap && !dst)) return false;
+    shm_ring_ctl_t *ctl = ring->ctl;
+    uint32_t max_len = cap > UINT32_MAX ? UINT32_MAX : (uint32_t)cap;
+    uint64_t pos = 0, size = 0;
+    ttak_net_shm_record_t *rec = shm_claim(ring, max_len, &pos, &size, &len);
+    if (!rec && len == 0 && timeout_ns != 0) {
+        uint64_t deadline = shm_deadline(timeout_ns);
+        for (;;) {
+            uint64_t left = shm_time_left(deadline);
+            if (left == 0) break;
+            uint32_t key = ttak_eventcount_prepare(&ctl->readable);
+            rec = shm_claim(ring, max_len, &pos, &size, &len);
+            if (rec || len) {
+                ttak_eventcount_cancel(&ctl->readable);
+                break;
+            }
+            ttak_eventcount_wait_shared(&ctl->readable, key, left);
+        }
+    }
+    if (len_out) *len_out = len;
+    if (!rec) return false;
+
+    if (len) memcpy(dst, rec + 1, len);
+    if (ts_out) *ts_out = rec->timestamp;
+    shm_release(ring, pos, size);
+    atomic_fetch_add_explicit(&ring->received, 1, memory_order_relaxed);
+    return true;
+}
+
+size_t ttak_net_shm_ring_to_lattice(ttak_net_shm_ring_t *ring, ttak_net_lattice_t *lat, uint32_t tid,
+                                    size_t budget, uint64_t now) {
+    if (!ring || !lat) return 0;
+    ttak_net_lattice_msg_t msgs[TTAK_NET_SHM_RING_BATCH];
+    uint64_t pos[TTAK_NET_SHM_RING_BATCH];
+    uint64_t size[TTAK_NET_SHM_RING_BATCH];
+    size_t total = 0;
+
+    while (total < budget) {
+        size_t want = budget - total < TTAK_NET_SHM_RING_BATCH ? budget - total : TTAK_NET_SHM_RING_BATCH;
+        size_t n = 0;
+        while (n < want) {
+            uint32_t len = 0;
+            ttak_net_shm_record_t *rec = shm_claim(ring, UINT32_MAX, &pos[n], &size[n], &len);
+            if (!rec) break;
+            msgs[n].data = (const uint8_t *)(rec + 1);
+            msgs[n].len = len;
+            msgs[n].slot = NULL;
+            msgs[n].node = NULL;
+            n++;
+        }
+        if (n == 0) break;
+
+        size_t written = ttak_net_lattice_write_batch(lat, tid, msgs, n, now);
+        for (size_t i = 0; i < written; ++i) shm_release(ring, pos[i], size[i]);
+        if (written < n) {
+            if (ring->mpmc) {
+                for (size_t i = written; i < n; ++i) shm_release(ring, pos[i], size[i]);
+                atomic_fetch_add_explicit(&ring->dropped, n - written, memory_order_relaxed);
+            } else {
+                /* The sole consumer can un-claim: the refused records stay queued. */
+                atomic_store_explicit(&ring->ctl->read, pos[written], memory_order_relaxed);
+            }
+        }
+        atomic_fetch_add_explicit(&ring->received, written, memory_order_relaxed);
+        total += written;
+        if (written < n) break;
+    }
+    return total;
+}
+
+void ttak_net_shm_ring_stats(const ttak_net_shm_ring_t *ring, ttak_net_shm_ring_stats_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!ring) return;
+    out->sent = atomic_load_explicit(&ring->sent, memory_order_relaxed);
+    out->received = atomic_load_explicit(&ring->received, memory_order_relaxed);
+    out->full = atomic_load_explicit(&ring->full, memory_order_relaxed);
+    out->dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+}
+
+#else
+
+ttak_net_shm_ring_t *ttak_net_shm_ring_create(const char *name, size_t capacity, ttak_net_shm_ring_mode_t mode) {
+    (void)name; (void)capacity; (void)mode;
+    errno = ENOTSUP;
+    return NULL;
+}
+
+ttak_net_shm_ring_t *ttak_net_shm_ring_open(const char *name) {
+    (void)name;
+    errno = ENOTSUP;
+    return NULL;
+}
+
+ttak_net_shm_ring_t *ttak_net_shm_ring_open_fd(int fd) {
+    (void)fd;
+    errno = ENOTSUP;
+    return NULL;
+}
+
+void ttak_net_shm_ring_close(ttak_net_shm_ring_t *ring) { (void)ring; }
+
+int ttak_net_shm_ring_unlink(const char *name) {
+    (void)name;
+    return ENOTSUP;
+}
+
+int ttak_net_shm_ring_fd(const ttak_net_shm_ring_t *ring) {
+    (void)ring;
+    return -1;
+}
+
+uint32_t ttak_net_shm_ring_max_record(const ttak_net_shm_ring_t *ring) {
+    (void)ring;
+    return 0;
+}
+
+bool ttak_net_shm_ring_send(ttak_net_shm_ring_t *ring, const void *data, uint32_t len, uint64_t now,
+                            uint64_t timeout_ns) {
+    (void)ring; (void)data; (void)len; (void)now; (void)timeout_ns;
+    return false;
+}
+
+bool ttak_net_shm_ring_recv(ttak_net_shm_ring_t *ring, void *dst, size_t cap, uint32_t *len_out,
+                            uint64_t *ts_out, uint64_t timeout_ns) {
+    (void)ring; (void)dst; (void)cap; (void)ts_out; (void)timeout_ns;
+    if (len_out) *len_out = 0;
+    return false;
+}
+
+size_t ttak_net_shm_ring_to_lattice(ttak_net_shm_ring_t *ring, ttak_net_lattice_t *lat, uint32_t tid,
+                                    size_t budget, uint64_t now) {
+    (void)ring; (void)lat; (void)tid; (void)budget; (void)now;
+    return 0;
+}
+
+void ttak_net_shm_ring_stats(const ttak_net_shm_ring_t *ring, ttak_net_shm_ring_stats_t *out) {
+    (void)ring;
+    if (out) memset(out, 0, sizeof(*out));
+}
+
+#endif
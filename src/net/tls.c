@@ -0,0 +1,363 @@
+/**
+ * @file tls.c
+ * @brief Kernel TLS hand-off with a userspace record sealer as fallback.
+ *
+ * ttak_net_tls_enable() attaches the "tls" ULP and passes the keys in the
+ * kernel's crypto_info layout; from then on the socket is written plain.
+ * Without kTLS each record is built here: header, nonce derived from the
+ * IV and sequence number as RFC 5288, 7905 and 8446 describe, AEAD over
+ * the payload in place, tag appended.
+ */
+
+#include <ttak/net/tls.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/tls.h>)
+#    include <linux/tls.h>
+#    include <sys/sendfile.h>
+#    if defined(TLS_CIPHER_AES_GCM_256) && defined(TLS_CIPHER_CHACHA20_POLY1305) && defined(TCP_ULP)
+#      define TTAK_NET_KTLS_SUPPORTED 1
+#    endif
+#  endif
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0
+#endif
+
+static void tls_store_be64(uint8_t *p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+static uint64_t tls_load_be64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+/* Wipes key material so the compiler cannot drop the stores. */
+static void tls_wipe(void *p, size_t n) {
+    volatile uint8_t *v = p;
+    while (n--) *v++ = 0;
+}
+
+/* GCM under TLS 1.2 carries an explicit 8-byte nonce in every record. */
+static bool tls_explicit_nonce(const ttak_net_tls_t *tls) {
+    return tls->version == TTAK_NET_TLS_1_2 && tls->cipher == TTAK_NET_TLS_AES_256_GCM;
+}
+
+#if defined(TTAK_NET_KTLS_SUPPORTED)
+typedef union {
+    struct tls_crypto_info info;
+    struct tls12_crypto_info_aes_gcm_256 gcm;
+    struct tls12_crypto_info_chacha20_poly1305 chacha;
+} tls_kernel_info_t;
+
+static socklen_t tls_kernel_info(const ttak_net_tls_params_t *p, const ttak_crypto_ctx_t *c, uint64_t seq,
+                                 tls_kernel_info_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->info.version = p->version == TTAK_NET_TLS_1_3 ? TLS_1_3_VERSION : TLS_1_2_VERSION;
+    if (p->cipher == TTAK_NET_TLS_AES_256_GCM) {
+        out->info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        memcpy(out->gcm.salt, c->iv, TLS_CIPHER_AES_GCM_256_SALT_SIZE);
+        memcpy(out->gcm.iv, c->iv + TLS_CIPHER_AES_GCM_256_SALT_SIZE, TLS_CIPHER_AES_GCM_256_IV_SIZE);
+        memcpy(out->gcm.key, c->key, TLS_CIPHER_AES_GCM_256_KEY_SIZE);
+        tls_store_be64(out->gcm.rec_seq, seq);
+        return sizeof(out->gcm);
+    }
+    out->info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+    memcpy(out->chacha.iv, c->iv, TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE);
+    memcpy(out->chacha.key, c->key, TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE);
+    tls_store_be64(out->chacha.rec_seq, seq);
+    return sizeof(out->chacha);
+}
+
+static bool tls_kernel_set(int fd, int dir, const ttak_net_tls_params_t *p, const ttak_crypto_ctx_t *c,
+                           uint64_t seq) {
+    tls_kernel_info_t info;
+    socklen_t len = tls_kernel_info(p, c, seq, &info);
+    bool ok = setsockopt(fd, SOL_TLS, dir, &info, len) == 0;
+    tls_wipe(&info, sizeof(info));
+    return ok;
+}
+#endif
+
+static bool tls_key_ok(const ttak_crypto_ctx_t *c) {
+    return c && c->key && c->key_len == 32U && (c->iv_len == 12U || c->iv_len == 0U);
+}
+
+ttak_io_status_t ttak_net_tls_enable(ttak_net_tls_t *tls,
+                                     ttak_shared_net_endpoint_t *endpoint,
+                                     ttak_owner_t *owner,
+                                     const ttak_net_tls_params_t *params,
+                                     uint64_t now) {
+    if (!tls || !params || !tls_key_ok(params->tx) || (params->rx && !tls_key_ok(params->rx))) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    ttak_net_guard_snapshot_t snap;
+    ttak_io_status_t status = ttak_net_endpoint_snapshot_guard(endpoint, owner, &snap, now);
+    if (status != TTAK_IO_SUCCESS) return status;
+
+    memset(tls, 0, sizeof(*tls));
+    tls->version = params->version;
+    tls->cipher = params->cipher;
+    tls->tx_seq = params->tx_seq;
+
+#if defined(TTAK_NET_KTLS_SUPPORTED)
+    if (!params->force_user && setsockopt(snap.fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0) {
+        if (tls_kernel_set(snap.fd, TLS_TX, params, params->tx, params->tx_seq)) {
+            tls->tx_mode = TTAK_NET_TLS_MODE_KERNEL;
+        }
+        if (params->rx && tls_kernel_set(snap.fd, TLS_RX, params, params->rx, params->rx_seq)) {
+            tls->rx_mode = TTAK_NET_TLS_MODE_KERNEL;
+        }
+    }
+#endif
+
+    if (tls->tx_mode != TTAK_NET_TLS_MODE_KERNEL) {
+        tls->record = malloc(TTAK_NET_TLS_MAX_PLAINTEXT + TTAK_NET_TLS_MAX_OVERHEAD);
+        if (!tls->record) return TTAK_IO_ERR_SYS_FAILURE;
+        memcpy(tls->key, params->tx->key, sizeof(tls->key));
+        memcpy(tls->iv, params->tx->iv, sizeof(tls->iv));
+        tls->ctx.key = tls->key;
+        tls->ctx.key_len = sizeof(tls->key);
+        tls->ctx.iv_len = 12;
+        tls->ctx.tag_len = 16;
+        if (tls->cipher == TTAK_NET_TLS_AES_256_GCM) {
+            if (ttak_security_schedule_init(&tls->schedule, TTAK_SECURITY_AES_GCM, tls->key,
+                                            sizeof(tls->key)) != TTAK_IO_SUCCESS) {
+                ttak_net_tls_destroy(tls);
+                return TTAK_IO_ERR_INVALID_ARGUMENT;
+            }
+            tls->ctx.schedule = &tls->schedule;
+        }
+        tls->tx_mode = TTAK_NET_TLS_MODE_USER;
+    }
+    return ttak_net_endpoint_guard_commit(&snap, now);
+}
+
+void ttak_net_tls_destroy(ttak_net_tls_t *tls) {
+    if (!tls) return;
+    free(tls->record);
+    tls_wipe(tls, sizeof(*tls));
+}
+
+ttak_io_status_t ttak_net_tls_seal(ttak_net_tls_t *tls,
+                                   uint8_t content_type,
+                                   const void *data,
+                                   size_t len,
+                                   uint8_t *out,
+                                   size_t cap,
+                                   size_t *out_len) {
+    if (!tls || tls->tx_mode != TTAK_NET_TLS_MODE_USER || !out || (len && !data)) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    const bool tls13 = tls->version == TTAK_NET_TLS_1_3;
+    const size_t explicit_len = tls_explicit_nonce(tls) ? 8U : 0U;
+    const size_t body = len + (tls13 ? 1U : 0U);
+    const size_t record_len = 5U + explicit_len + body + 16U;
+    if (len > TTAK_NET_TLS_MAX_PLAINTEXT || cap < record_len) return TTAK_IO_ERR_RANGE;
+
+    uint8_t seq[8];
+    tls_store_be64(seq, tls->tx_seq);
+    uint8_t *text = out + 5 + explicit_len;
+
+    /* Nonce: salt || explicit for TLS 1.2 GCM, otherwise IV xor the sequence number. */
+    memcpy(tls->ctx.iv, tls->iv, 12);
+    if (explicit_len) {
+        memcpy(out + 5, tls->iv + 4, 8);
+    } else {
+        for (int i = 0; i < 8; i++) tls->ctx.iv[4 + i] ^= seq[i];
+    }
+
+    const size_t wire_len = record_len - 5U;
+    out[0] = tls13 ? TTAK_NET_TLS_APPLICATION_DATA : content_type;
+    out[1] = 0x03;
+    out[2] = 0x03;
+    out[3] = (uint8_t)(wire_len >> 8);
+    out[4] = (uint8_t)wire_len;
+
+    uint8_t aad[13];
+    if (tls13) {
+        memcpy(aad, out, 5);
+        tls->ctx.aad_len = 5;
+    } else {
+        memcpy(aad, seq, 8);
+        aad[8] = content_type;
+        aad[9] = 0x03;
+        aad[10] = 0x03;
+        aad[11] = (uint8_t)(len >> 8);
+        aad[12] = (uint8_t)len;
+        tls->ctx.aad_len = 13;
+    }
+    tls->ctx.aad = aad;
+
+    if (len) memmove(text, data, len);
+    if (tls13) text[len] = content_type;
+    tls->ctx.in = text;
+    tls->ctx.in_len = body;
+    tls->ctx.out = text;
+    tls->ctx.tag = text + body;
+
+    ttak_io_status_t status = tls->cipher == TTAK_NET_TLS_AES_256_GCM
+                              ? ttak_aes256_gcm_execute(&tls->ctx, text, text, body)
+                              : ttak_chacha20_poly1305_execute(&tls->ctx, text, text, body);
+    tls->ctx.aad = NULL;
+    if (status != TTAK_IO_SUCCESS) return status;
+
+    if (explicit_len) tls_store_be64(tls->iv + 4, tls_load_be64(tls->iv + 4) + 1U);
+    tls->tx_seq++;
+    tls->records++;
+    if (out_len) *out_len = record_len;
+    return TTAK_IO_SUCCESS;
+}
+
+static ttak_io_status_t tls_send_status(void) {
+#ifdef _WIN32
+    return (WSAGetLastError() == WSAEWOULDBLOCK) ? TTAK_IO_ERR_NEEDS_RETRY : TTAK_IO_ERR_SYS_FAILURE;
+#else
+    return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOBUFS)
+           ? TTAK_IO_ERR_NEEDS_RETRY
+           : TTAK_IO_ERR_SYS_FAILURE;
+#endif
+}
+
+/* Writes out the rest of the pending record; NEEDS_RETRY if the socket filled up first. */
+static ttak_io_status_t tls_flush_record(ttak_net_tls_t *tls, int fd) {
+    while (tls->record_off < tls->record_len) {
+        ssize_t n = send(fd, (const char *)tls->record + tls->record_off,
+                         tls->record_len - tls->record_off, MSG_NOSIGNAL);
+        if (n < 0) return tls_send_status();
+        tls->record_off += (size_t)n;
+    }
+    tls->record_len = 0;
+    tls->record_off = 0;
+    return TTAK_IO_SUCCESS;
+}
+
+/* Userspace mode: seals and sends @p len bytes record by record. */
+static ttak_io_status_t tls_send_user(ttak_net_tls_t *tls, int fd, const uint8_t *data, size_t len, size_t *sent) {
+    ttak_io_status_t status = tls_flush_record(tls, fd);
+    while (status == TTAK_IO_SUCCESS && *sent < len) {
+        size_t chunk = len - *sent;
+        if (chunk > TTAK_NET_TLS_MAX_PLAINTEXT) chunk = TTAK_NET_TLS_MAX_PLAINTEXT;
+        status = ttak_net_tls_seal(tls, TTAK_NET_TLS_APPLICATION_DATA, data + *sent, chunk, tls->record,
+                                   TTAK_NET_TLS_MAX_PLAINTEXT + TTAK_NET_TLS_MAX_OVERHEAD, &tls->record_len);
+        if (status != TTAK_IO_SUCCESS) break;
+        tls->record_off = 0;
+        /* The record is committed; its plaintext counts as sent even if the socket fills up. */
+        *sent += chunk;
+        status = tls_flush_record(tls, fd);
+    }
+    if (status == TTAK_IO_ERR_NEEDS_RETRY && *sent > 0) status = TTAK_IO_SUCCESS;
+    return status;
+}
+
+ttak_io_status_t ttak_net_tls_send(ttak_net_tls_t *tls,
+                                   ttak_shared_net_endpoint_t *endpoint,
+                                   ttak_owner_t *owner,
+                                   const void *data,
+                                   size_t len,
+                                   int flags,
+                                   size_t *sent,
+                                   uint64_t now) {
+    if (sent) *sent = 0;
+    if (!tls || tls->tx_mode == TTAK_NET_TLS_MODE_NONE || (len && !data)) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    ttak_net_guard_snapshot_t snap;
+    ttak_io_status_t status = ttak_net_endpoint_snapshot_guard(endpoint, owner, &snap, now);
+    if (status != TTAK_IO_SUCCESS) return status;
+
+    size_t done = 0;
+    if (tls->tx_mode == TTAK_NET_TLS_MODE_KERNEL) {
+        ssize_t n = len ? send(snap.fd, (const char *)data, len, flags | MSG_NOSIGNAL) : 0;
+        if (n < 0) return tls_send_status();
+        done = (size_t)n;
+    } else {
+        (void)flags;
+        status = tls_send_user(tls, snap.fd, data, len, &done);
+        if (status != TTAK_IO_SUCCESS) return status;
+    }
+    if (sent) *sent = done;
+    return ttak_net_endpoint_guard_commit(&snap, now);
+}
+
+ttak_io_status_t ttak_net_tls_sendfile(ttak_net_tls_t *tls,
+                                       ttak_shared_net_endpoint_t *endpoint,
+                                       ttak_owner_t *owner,
+                                       int in_fd,
+                                       uint64_t *offset,
+                                       size_t count,
+                                       size_t *sent,
+                                       uint64_t now) {
+    if (sent) *sent = 0;
+    if (!tls || tls->tx_mode == TTAK_NET_TLS_MODE_NONE || in_fd < 0 || !offset) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    ttak_net_guard_snapshot_t snap;
+    ttak_io_status_t status = ttak_net_endpoint_snapshot_guard(endpoint, owner, &snap, now);
+    if (status != TTAK_IO_SUCCESS) return status;
+
+    size_t done = 0;
+#if defined(TTAK_NET_KTLS_SUPPORTED)
+    if (tls->tx_mode == TTAK_NET_TLS_MODE_KERNEL) {
+        off_t off = (off_t)*offset;
+        ssize_t n = count ? sendfile(snap.fd, in_fd, &off, count) : 0;
+        if (n < 0) return tls_send_status();
+        *offset = (uint64_t)off;
+        if (sent) *sent = (size_t)n;
+        return ttak_net_endpoint_guard_commit(&snap, now);
+    }
+#endif
+#ifndef _WIN32
+    /* Userspace mode: pread a record's worth, seal it, send it. */
+    status = tls_flush_record(tls, snap.fd);
+    uint8_t *chunk_buf = (status == TTAK_IO_SUCCESS) ? malloc(TTAK_NET_TLS_MAX_PLAINTEXT) : NULL;
+    if (status == TTAK_IO_SUCCESS && !chunk_buf) status = TTAK_IO_ERR_SYS_FAILURE;
+    while (status == TTAK_IO_SUCCESS && done < count) {
+        size_t want = count - done;
+        if (want > TTAK_NET_TLS_MAX_PLAINTEXT) want = TTAK_NET_TLS_MAX_PLAINTEXT;
+        ssize_t n = pread(in_fd, chunk_buf, want, (off_t)(*offset + done));
+        if (n < 0) {
+            status = TTAK_IO_ERR_SYS_FAILURE;
+            break;
+        }
+        if (n == 0) break;
+        size_t accepted = 0;
+        status = tls_send_user(tls, snap.fd, chunk_buf, (size_t)n, &accepted);
+        done += accepted;
+        if (accepted < (size_t)n) break;
+    }
+    free(chunk_buf);
+    *offset += done;
+    if (sent) *sent = done;
+    if (done > 0 && status == TTAK_IO_ERR_NEEDS_RETRY) status = TTAK_IO_SUCCESS;
+    if (status != TTAK_IO_SUCCESS) return status;
+    return ttak_net_endpoint_guard_commit(&snap, now);
+#else
+    (void)done;
+    return TTAK_IO_ERR_SYS_FAILURE;
+#endif
+}
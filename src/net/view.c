@@ -38,6 +38,7 @@ void ttak_net_view_init(ttak_net_view_t *view) {
     view->birth_ns = 0;
     view->slot = NULL;
     view->slot_lattice = NULL;
+    view->map = NULL;
     ttak_io_zerocopy_region_init(&view->region);
 }
 
@@ -52,6 +53,7 @@ ttak_io_status_t ttak_net_view_from_endpoint(ttak_net_view_t *view,
     }
     view->slot = NULL;
     view->slot_lattice = NULL;
+    view->map = NULL;
 
     ttak_shared_result_t res;
     ttak_net_endpoint_t *payload = ttak_shared_net_endpoint_access(endpoint, owner, &res);
@@ -80,7 +82,7 @@ ttak_io_status_t ttak_net_view_from_endpoint(ttak_net_view_t *view,
                         ttak_net_lattice_slot_t *slot = &node->slots[r * dim + c];
                         if (ttak_atomic_read64(&slot->state) == 0) {
                             ttak_atomic_write64(&slot->state, 1);
-                            ssize_t valread = recv(fd, slot->data, TTAK_LATTICE_SLOT_SIZE, flags);
+                            ssize_t valread = recv(fd, slot->data, node->slot_size, flags);
                             if (valread > 0) {
                                 slot->len = (uint32_t)valread;
                                 slot->timestamp = now;
@@ -136,6 +138,27 @@ ttak_io_status_t ttak_net_view_from_endpoint(ttak_net_view_t *view,
     return status;
 }
 
+ttak_io_status_t ttak_net_view_from_mmap(ttak_net_view_t *view,
+                                         ttak_io_mmap_t *map,
+                                         size_t offset,
+                                         size_t len,
+                                         uint64_t now) {
+    if (!view || !map) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    const uint8_t *data = NULL;
+    ttak_io_status_t status = ttak_io_mmap_retain(map, offset, len, &data, now);
+    if (status != TTAK_IO_SUCCESS) {
+        return status;
+    }
+    ttak_net_view_init(view);
+    view->data = data;
+    view->len = len;
+    view->birth_ns = now;
+    view->map = map;
+    return TTAK_IO_SUCCESS;
+}
+
 const uint8_t *ttak_net_view_data(const ttak_net_view_t *view) {
     return view ? view->data : NULL;
 }
@@ -143,8 +166,10 @@ const uint8_t *ttak_net_view_data(const ttak_net_view_t *view) {
 void ttak_net_view_release(ttak_net_view_t *view) {
     if (!view) return;
 
-    /* If this view was backed by a lattice slot, release it */
-    if (view->slot && view->slot_lattice) {
+    /* Drop the mapping reference, or release the lattice slot backing the view */
+    if (view->map) {
+        ttak_io_mmap_release(view->map);
+    } else if (view->slot && view->slot_lattice) {
         ttak_atomic_write64(&view->slot->state, 0);
         ttak_net_lattice_mark_slot_released(view->slot_lattice);
     } else {
@@ -171,4 +196,5 @@ void ttak_net_view_release(ttak_net_view_t *view) {
     view->birth_ns = 0;
     view->slot = NULL;
     view->slot_lattice = NULL;
+    view->map = NULL;
 }
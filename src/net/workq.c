@@ -0,0 +1,955 @@
+/**
+ * @file workq.c
+ * @brief Leased seed ranges, heartbeats and batched result upload over UDP.
+ *
+ * Every datagram starts with a 24-byte little-endian header: u32 magic,
+ * u8 type, u8 flags, u16 entry count, u64 worker id and u64 sequence.
+ * Entries follow, by type:
+ *   - REQUEST (worker): none; count is the number of leases wanted.
+ *   - GRANT (coordinator): u64 id, start, count for every lease the worker
+ *     holds, so a lost grant is repaired by the next request.
+ *   - HEARTBEAT (worker) and REVOKE (coordinator): u64 lease ids.
+ *   - RESULTS (worker): u64 lease, u16 length, u8 kind, u8 0, then the
+ *     record bytes; a DONE entry carries no bytes. seq numbers the batch.
+ *   - ACK (coordinator): none; seq is the last batch accepted.
+ * A lease id is the lease's table slot in its low 16 bits under a grant
+ * counter, so the coordinator finds a lease without a search and a stale
+ * id never matches the slot's next tenant.
+ */
+
+#include <ttak/net/workq.h>
+
+#include <ttak/net/core/port.h>
+#include <ttak/sync/sync.h>
+#include <ttak/sync/waitword.h>
+#include <ttak/timing/timing.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#define WORKQ_DONTWAIT 0
+#else
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define WORKQ_DONTWAIT MSG_DONTWAIT
+#endif
+
+#ifndef MSG_TRUNC
+#define MSG_TRUNC 0
+#endif
+
+#define WORKQ_MAGIC         0x31515754U     /* "TWQ1" */
+#define WORKQ_HDR           24U
+#define WORKQ_GRANT_ENTRY   24U
+#define WORKQ_ID_ENTRY      8U
+#define WORKQ_RESULT_HEAD   12U
+#define WORKQ_MAX_ENTRIES   ((TTAK_NET_WORKQ_DATAGRAM - WORKQ_HDR) / WORKQ_RESULT_HEAD)
+#define WORKQ_RX_BATCH      16U
+#define WORKQ_TX_BATCH      32U
+#define WORKQ_SLOT_BITS     16U
+#define WORKQ_SLOT_MASK     ((1ULL << WORKQ_SLOT_BITS) - 1)
+#define WORKQ_NONE          UINT32_MAX
+#define WORKQ_SEQ_ANY       UINT64_MAX      /* Accept whatever batch comes next. */
+
+enum {
+    WORKQ_MSG_REQUEST = 1,
+    WORKQ_MSG_GRANT,
+    WORKQ_MSG_HEARTBEAT,
+    WORKQ_MSG_REVOKE,
+    WORKQ_MSG_RESULTS,
+    WORKQ_MSG_ACK
+};
+
+enum {
+    WORKQ_FLAG_FINISHED = 1u << 0,  /* GRANT: the whole range is done. */
+    WORKQ_FLAG_BUSY     = 1u << 1,  /* GRANT/ACK: the sink is refusing work. */
+    WORKQ_FLAG_HELLO    = 1u << 2   /* REQUEST: first contact of a worker incarnation. */
+};
+
+enum { WORKQ_ENTRY_RECORD = 0, WORKQ_ENTRY_DONE = 1 };
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+typedef struct workq_hdr {
+    uint8_t type;
+    uint8_t flags;
+    uint16_t count;
+    uint64_t worker;
+    uint64_t seq;
+} workq_hdr_t;
+
+static void hdr_put(uint8_t *p, uint8_t type, uint8_t flags, uint16_t count, uint64_t worker, uint64_t seq) {
+    put_u32(p, WORKQ_MAGIC);
+    p[4] = type;
+    p[5] = flags;
+    put_u16(p + 6, count);
+    put_u64(p + 8, worker);
+    put_u64(p + 16, seq);
+}
+
+static bool hdr_get(const uint8_t *p, size_t len, workq_hdr_t *h) {
+    if (len < WORKQ_HDR || get_u32(p) != WORKQ_MAGIC) return false;
+    h->type = p[4];
+    h->flags = p[5];
+    h->count = get_u16(p + 6);
+    h->worker = get_u64(p + 8);
+    h->seq = get_u64(p + 16);
+    return h->worker != 0;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Datagram I/O through the endpoint                                        */
+/* ----------------------------------------------------------------------- */
+
+/**
+ * @brief Outbox and receive buffers shared by both roles.
+ *
+ * Replies are staged during a poll and leave in one send batch.
+ */
+typedef struct workq_io {
+    ttak_shared_net_endpoint_t *endpoint;
+    ttak_owner_t *owner;
+    ttak_net_msg_t tx[WORKQ_TX_BATCH];
+    struct sockaddr_storage tx_addr[WORKQ_TX_BATCH];
+    uint8_t tx_buf[WORKQ_TX_BATCH][TTAK_NET_WORKQ_DATAGRAM];
+    size_t ntx;
+    ttak_net_msg_t rx[WORKQ_RX_BATCH];
+    struct sockaddr_storage rx_addr[WORKQ_RX_BATCH];
+    uint8_t rx_buf[WORKQ_RX_BATCH][TTAK_NET_WORKQ_DATAGRAM];
+} workq_io_t;
+
+static void io_flush(workq_io_t *io, uint64_t now) {
+    size_t off = 0;
+    while (off < io->ntx) {
+        size_t sent = 0;
+        ttak_net_endpoint_send_batch(io->endpoint, io->owner, io->tx + off, io->ntx - off, 0, &sent, now);
+        // Datagrams the socket would not take are dropped; the protocol retries.
+        if (sent == 0) break;
+        off += sent;
+    }
+    io->ntx = 0;
+}
+
+/**
+ * @brief Stages a datagram to @p addr and returns its buffer; io_push() sends it.
+ */
+static uint8_t *io_out(workq_io_t *io, const void *addr, uint32_t addr_len, uint64_t now) {
+    if (io->ntx == WORKQ_TX_BATCH) io_flush(io, now);
+    ttak_net_msg_t *m = &io->tx[io->ntx];
+    memset(m, 0, sizeof(*m));
+    m->buf = io->tx_buf[io->ntx];
+    if (addr && addr_len > 0 && addr_len <= sizeof(io->tx_addr[0])) {
+        memcpy(&io->tx_addr[io->ntx], addr, addr_len);
+        m->addr = &io->tx_addr[io->ntx];
+        m->addr_len = addr_len;
+    }
+    return io->tx_buf[io->ntx];
+}
+
+static void io_push(workq_io_t *io, size_t len) {
+    io->tx[io->ntx].len = len;
+    io->ntx++;
+}
+
+static size_t io_recv(workq_io_t *io, uint32_t wait_ms, uint64_t now) {
+#ifndef _WIN32
+    if (wait_ms > 0) {
+        ttak_net_guard_snapshot_t snap;
+        if (ttak_net_endpoint_snapshot_guard(io->endpoint, io->owner, &snap, now) == TTAK_IO_SUCCESS) {
+            struct pollfd p = { .fd = snap.fd, .events = POLLIN, .revents = 0 };
+            poll(&p, 1, (int)wait_ms);
+        }
+    }
+#else
+    (void)wait_ms;
+#endif
+    for (size_t i = 0; i < WORKQ_RX_BATCH; i++) {
+        memset(&io->rx[i], 0, sizeof(io->rx[i]));
+        io->rx[i].buf = io->rx_buf[i];
+        io->rx[i].len = TTAK_NET_WORKQ_DATAGRAM;
+        io->rx[i].addr = &io->rx_addr[i];
+        io->rx[i].addr_len = sizeof(io->rx_addr[i]);
+    }
+    size_t got = 0;
+    ttak_net_endpoint_recv_batch(io->endpoint, io->owner, io->rx, WORKQ_RX_BATCH, WORKQ_DONTWAIT, &got, now);
+    return got;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Coordinator                                                              */
+/* ----------------------------------------------------------------------- */
+
+typedef struct coord_lease {
+    uint64_t id;                /* 0 while the slot is free. */
+    uint64_t start;
+    uint64_t count;
+    uint64_t expires;
+    uint32_t worker;            /* Index into the worker table. */
+    uint32_t next_free;
+} coord_lease_t;
+
+typedef struct coord_worker {
+    uint64_t id;                /* 0 while the slot is free. */
+    uint64_t acked;             /* Last result batch accepted, or WORKQ_SEQ_ANY. */
+    uint64_t last_seen;
+    uint32_t held;
+    uint32_t addr_len;
+    struct sockaddr_storage addr;
+} coord_worker_t;
+
+typedef struct coord_range {
+    uint64_t start;
+    uint64_t count;
+} coord_range_t;
+
+struct ttak_net_workq_coord {
+    ttak_net_workq_coord_config_t cfg;
+    coord_lease_t *leases;
+    uint32_t free_head;
+    uint32_t outstanding;
+    coord_range_t *reissue;     /* Expired ranges, handed out before fresh ones. */
+    uint32_t reissue_n;
+    coord_worker_t *workers;
+    uint64_t next_seed;
+    uint64_t grants;            /* Upper bits of lease ids. */
+    uint64_t busy_until;
+    uint64_t next_sweep;
+    ttak_net_workq_coord_stats_t stats;
+    ttak_net_workq_result_t results[WORKQ_MAX_ENTRIES];
+    workq_io_t io;
+};
+
+ttak_net_workq_coord_t *ttak_net_workq_coord_create(const ttak_net_workq_coord_config_t *cfg,
+                                                    ttak_shared_net_endpoint_t *endpoint,
+                                                    ttak_owner_t *owner) {
+    if (!cfg || !cfg->sink || !endpoint || cfg->end_seed <= cfg->first_seed) return NULL;
+    if (cfg->max_leases > (1U << WORKQ_SLOT_BITS)) return NULL;
+    ttak_net_workq_coord_t *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    c->cfg = *cfg;
+    if (!c->cfg.lease_seeds) c->cfg.lease_seeds = 4096;
+    if (!c->cfg.lease_ttl_ms) c->cfg.lease_ttl_ms = 10000;
+    if (!c->cfg.busy_backoff_ms) c->cfg.busy_backoff_ms = 100;
+    if (!c->cfg.leases_per_worker) c->cfg.leases_per_worker = 4;
+    if (c->cfg.leases_per_worker > TTAK_NET_WORKQ_MAX_WORKER_LEASES) {
+        c->cfg.leases_per_worker = TTAK_NET_WORKQ_MAX_WORKER_LEASES;
+    }
+    if (!c->cfg.max_leases) c->cfg.max_leases = 1024;
+    if (!c->cfg.max_workers) c->cfg.max_workers = 256;
+
+    c->leases = calloc(c->cfg.max_leases, sizeof(*c->leases));
+    c->reissue = calloc(c->cfg.max_leases, sizeof(*c->reissue));
+    c->workers = calloc(c->cfg.max_workers, sizeof(*c->workers));
+    if (!c->leases || !c->reissue || !c->workers) {
+        ttak_net_workq_coord_destroy(c);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < c->cfg.max_leases; i++) {
+        c->leases[i].next_free = i + 1 < c->cfg.max_leases ? i + 1 : WORKQ_NONE;
+    }
+    c->free_head = 0;
+    c->next_seed = cfg->first_seed;
+    c->io.endpoint = endpoint;
+    c->io.owner = owner;
+    return c;
+}
+
+void ttak_net_workq_coord_destroy(ttak_net_workq_coord_t *coord) {
+    if (!coord) return;
+    free(coord->leases);
+    free(coord->reissue);
+    free(coord->workers);
+    free(coord);
+}
+
+bool ttak_net_workq_coord_finished(const ttak_net_workq_coord_t *coord) {
+    return coord->next_seed >= coord->cfg.end_seed && coord->reissue_n == 0 && coord->outstanding == 0;
+}
+
+void ttak_net_workq_coord_stats(const ttak_net_workq_coord_t *coord, ttak_net_workq_coord_stats_t *out) {
+    *out = coord->stats;
+    out->workers = 0;
+    for (uint32_t i = 0; i < coord->cfg.max_workers; i++) {
+        if (coord->workers[i].id) out->workers++;
+    }
+}
+
+static coord_lease_t *coord_lease(ttak_net_workq_coord_t *c, uint64_t id) {
+    uint64_t slot = id & WORKQ_SLOT_MASK;
+    if (id == 0 || slot >= c->cfg.max_leases || c->leases[slot].id != id) return NULL;
+    return &c->leases[slot];
+}
+
+/**
+ * @brief Frees a lease slot, putting the range back up for grabs unless
+ *        it was completed.
+ */
+static void coord_release(ttak_net_workq_coord_t *c, coord_lease_t *l, bool reissue) {
+    if (reissue) {
+        c->reissue[c->reissue_n].start = l->start;
+        c->reissue[c->reissue_n].count = l->count;
+        c->reissue_n++;
+    }
+    c->workers[l->worker].held--;
+    c->outstanding--;
+    l->id = 0;
+    l->next_free = c->free_head;
+    c->free_head = (uint32_t)(l - c->leases);
+}
+
+static void coord_sweep(ttak_net_workq_coord_t *c, uint64_t now) {
+    if (now < c->next_sweep) return;
+    uint64_t step = c->cfg.lease_ttl_ms / 8;
+    c->next_sweep = now + (step ? step : 1);
+    for (uint32_t i = 0; i < c->cfg.max_leases; i++) {
+        coord_lease_t *l = &c->leases[i];
+        if (l->id && l->expires <= now) {
+            coord_release(c, l, true);
+            c->stats.reassigned++;
+        }
+    }
+}
+
+/**
+ * @brief Finds the worker with @p id, adding it if new.
+ *
+ * A full table makes room by forgetting the longest-silent worker that
+ * holds no lease; if every worker holds one, the newcomer is ignored.
+ */
+static coord_worker_t *coord_worker(ttak_net_workq_coord_t *c, uint64_t id, const void *addr, uint32_t addr_len,
+                                    uint64_t now) {
+    coord_worker_t *victim = NULL;
+    for (uint32_t i = 0; i < c->cfg.max_workers; i++) {
+        coord_worker_t *w = &c->workers[i];
+        if (w->id == id) {
+            victim = w;
+            break;
+        }
+        if (w->id == 0) {
+            if (!victim || victim->id != 0) victim = w;
+        } else if (w->held == 0 && (!victim || (victim->id != 0 && w->last_seen < victim->last_seen))) {
+            victim = w;
+        }
+    }
+    if (!victim) return NULL;
+    if (victim->id != id) {
+        memset(victim, 0, sizeof(*victim));
+        victim->id = id;
+        victim->acked = WORKQ_SEQ_ANY;
+    }
+    victim->last_seen = now;
+    if (addr_len > 0 && addr_len <= sizeof(victim->addr)) {
+        memcpy(&victim->addr, addr, addr_len);
+        victim->addr_len = addr_len;
+    }
+    return victim;
+}
+
+/**
+ * @brief Hands @p w up to @p want more leases, within its per-worker cap.
+ */
+static void coord_grant(ttak_net_workq_coord_t *c, coord_worker_t *w, uint32_t want, uint64_t now) {
+    while (want > 0 && w->held < c->cfg.leases_per_worker && now >= c->busy_until && c->free_head != WORKQ_NONE) {
+        coord_range_t r;
+        if (c->reissue_n > 0) {
+            r = c->reissue[--c->reissue_n];
+        } else if (c->next_seed < c->cfg.end_seed) {
+            r.start = c->next_seed;
+            r.count = c->cfg.end_seed - c->next_seed;
+            if (r.count > c->cfg.lease_seeds) r.count = c->cfg.lease_seeds;
+            c->next_seed += r.count;
+        } else {
+            break;
+        }
+        uint32_t slot = c->free_head;
+        coord_lease_t *l = &c->leases[slot];
+        c->free_head = l->next_free;
+        l->id = (++c->grants << WORKQ_SLOT_BITS) | slot;
+        l->start = r.start;
+        l->count = r.count;
+        l->expires = now + c->cfg.lease_ttl_ms;
+        l->worker = (uint32_t)(w - c->workers);
+        w->held++;
+        want--;
+        c->outstanding++;
+        c->stats.granted++;
+    }
+}
+
+static uint8_t coord_flags(const ttak_net_workq_coord_t *c, uint64_t now) {
+    uint8_t flags = 0;
+    if (ttak_net_workq_coord_finished(c)) flags |= WORKQ_FLAG_FINISHED;
+    if (now < c->busy_until) flags |= WORKQ_FLAG_BUSY;
+    return flags;
+}
+
+static void coord_on_request(ttak_net_workq_coord_t *c, coord_worker_t *w, const workq_hdr_t *h, uint64_t now) {
+    if (h->flags & WORKQ_FLAG_HELLO) w->acked = WORKQ_SEQ_ANY;
+    coord_grant(c, w, h->count, now);
+
+    uint8_t *out = io_out(&c->io, &w->addr, w->addr_len, now);
+    uint32_t idx = (uint32_t)(w - c->workers);
+    uint16_t n = 0;
+    for (uint32_t i = 0; i < c->cfg.max_leases && n < w->held; i++) {
+        const coord_lease_t *l = &c->leases[i];
+        if (!l->id || l->worker != idx) continue;
+        uint8_t *e = out + WORKQ_HDR + (size_t)n * WORKQ_GRANT_ENTRY;
+        put_u64(e, l->id);
+        put_u64(e + 8, l->start);
+        put_u64(e + 16, l->count);
+        n++;
+    }
+    hdr_put(out, WORKQ_MSG_GRANT, coord_flags(c, now), n, w->id, 0);
+    io_push(&c->io, WORKQ_HDR + (size_t)n * WORKQ_GRANT_ENTRY);
+}
+
+static void coord_on_heartbeat(ttak_net_workq_coord_t *c, coord_worker_t *w, const workq_hdr_t *h,
+                               const uint8_t *body, size_t len, uint64_t now) {
+    if ((size_t)h->count * WORKQ_ID_ENTRY > len) return;
+    uint32_t idx = (uint32_t)(w - c->workers);
+    uint8_t *out = NULL;
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < h->count; i++) {
+        uint64_t id = get_u64(body + (size_t)i * WORKQ_ID_ENTRY);
+        coord_lease_t *l = coord_lease(c, id);
+        if (l && l->worker == idx) {
+            l->expires = now + c->cfg.lease_ttl_ms;
+            continue;
+        }
+        if (!out) out = io_out(&c->io, &w->addr, w->addr_len, now);
+        put_u64(out + WORKQ_HDR + (size_t)n * WORKQ_ID_ENTRY, id);
+        n++;
+    }
+    if (out) {
+        hdr_put(out, WORKQ_MSG_REVOKE, 0, n, w->id, 0);
+        io_push(&c->io, WORKQ_HDR + (size_t)n * WORKQ_ID_ENTRY);
+    }
+}
+
+static void coord_ack(ttak_net_workq_coord_t *c, const coord_worker_t *w, uint8_t flags, uint64_t now) {
+    uint8_t *out = io_out(&c->io, &w->addr, w->addr_len, now);
+    hdr_put(out, WORKQ_MSG_ACK, flags, 0, w->id, w->acked == WORKQ_SEQ_ANY ? 0 : w->acked);
+    io_push(&c->io, WORKQ_HDR);
+}
+
+static void coord_on_results(ttak_net_workq_coord_t *c, coord_worker_t *w, const workq_hdr_t *h,
+                             const uint8_t *body, size_t len, uint64_t now) {
+    // The first batch seen fixes where the stream starts, even if it is
+    // refused below; otherwise the batch behind it would be taken first.
+    if (w->acked == WORKQ_SEQ_ANY) w->acked = h->seq - 1;
+    if (h->seq != w->acked + 1) {
+        // A retransmission of something accepted, or a batch behind a lost one.
+        c->stats.duplicates++;
+        coord_ack(c, w, 0, now);
+        return;
+    }
+    if (now < c->busy_until) {
+        c->stats.refused++;
+        coord_ack(c, w, WORKQ_FLAG_BUSY, now);
+        return;
+    }
+
+    size_t n = 0, off = 0;
+    for (uint16_t i = 0; i < h->count; i++) {
+        if (len - off < WORKQ_RESULT_HEAD) return;
+        uint16_t rlen = get_u16(body + off + 8);
+        if (len - off - WORKQ_RESULT_HEAD < rlen) return;
+        if (body[off + 10] == WORKQ_ENTRY_RECORD) {
+            ttak_net_workq_result_t *r = &c->results[n++];
+            r->worker = w->id;
+            r->lease = get_u64(body + off);
+            r->data = body + off + WORKQ_RESULT_HEAD;
+            r->len = rlen;
+        }
+        off += WORKQ_RESULT_HEAD + rlen;
+    }
+    if (n > 0 && !c->cfg.sink(c->results, n, c->cfg.sink_arg)) {
+        c->busy_until = now + c->cfg.busy_backoff_ms;
+        c->stats.refused++;
+        coord_ack(c, w, WORKQ_FLAG_BUSY, now);
+        return;
+    }
+    c->stats.results += n;
+
+    uint32_t idx = (uint32_t)(w - c->workers);
+    off = 0;
+    for (uint16_t i = 0; i < h->count; i++) {
+        coord_lease_t *l = coord_lease(c, get_u64(body + off));
+        if (l && l->worker == idx) {
+            if (body[off + 10] == WORKQ_ENTRY_DONE) {
+                coord_release(c, l, false);
+                c->stats.completed++;
+            } else {
+                l->expires = now + c->cfg.lease_ttl_ms;
+            }
+        }
+        off += WORKQ_RESULT_HEAD + get_u16(body + off + 8);
+    }
+    w->acked = h->seq;
+    coord_ack(c, w, 0, now);
+}
+
+size_t ttak_net_workq_coord_poll(ttak_net_workq_coord_t *coord, uint32_t wait_ms, uint64_t now) {
+    if (!coord) return 0;
+    coord_sweep(coord, now);
+    size_t got = io_recv(&coord->io, wait_ms, now);
+    for (size_t i = 0; i < got; i++) {
+        const ttak_net_msg_t *m = &coord->io.rx[i];
+        workq_hdr_t h;
+        if ((m->flags & MSG_TRUNC) || !hdr_get(coord->io.rx_buf[i], m->bytes, &h)) continue;
+        coord_worker_t *w = coord_worker(coord, h.worker, m->addr, m->addr_len, now);
+        if (!w) continue;
+        const uint8_t *body = coord->io.rx_buf[i] + WORKQ_HDR;
+        size_t len = m->bytes - WORKQ_HDR;
+        switch (h.type) {
+        case WORKQ_MSG_REQUEST:
+            coord_on_request(coord, w, &h, now);
+            break;
+        case WORKQ_MSG_HEARTBEAT:
+            coord_on_heartbeat(coord, w, &h, body, len, now);
+            break;
+        case WORKQ_MSG_RESULTS:
+            coord_on_results(coord, w, &h, body, len, now);
+            break;
+        default:
+            break;
+        }
+    }
+    io_flush(&coord->io, now);
+    return got;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Worker                                                                   */
+/* ----------------------------------------------------------------------- */
+
+typedef enum worker_slot_state {
+    SLOT_FREE = 0,
+    SLOT_READY,                 /* Granted, waiting for a thread. */
+    SLOT_TAKEN,                 /* A thread works on it. */
+    SLOT_DONE,                  /* DONE entry queued, not yet acknowledged. */
+    SLOT_REVOKED                /* Taken back while a thread held it. */
+} worker_slot_state_t;
+
+typedef struct worker_slot {
+    ttak_net_workq_lease_t lease;
+    worker_slot_state_t state;
+} worker_slot_t;
+
+typedef struct worker_dgram {
+    uint64_t seq;
+    size_t len;
+    uint8_t buf[TTAK_NET_WORKQ_DATAGRAM];
+} worker_dgram_t;
+
+struct ttak_net_workq_worker {
+    ttak_net_workq_worker_config_t cfg;
+    uint64_t id;
+    struct sockaddr_storage coord_addr;
+    uint32_t coord_len;
+    ttak_mutex_t lock;
+    ttak_eventcount_t changed;      /* Leases, buffer room or the finished flag moved. */
+    worker_slot_t slots[TTAK_NET_WORKQ_MAX_WORKER_LEASES];
+    uint8_t *pend;                  /* Encoded entries not yet in a datagram. */
+    size_t pend_len;
+    worker_dgram_t *inflight;       /* Ring of cfg.window sent, unacknowledged batches. */
+    uint32_t in_head;
+    uint32_t in_count;
+    uint64_t next_seq;
+    uint64_t next_request;
+    uint64_t next_heartbeat;
+    uint64_t resend_at;
+    uint64_t busy_until;
+    bool hello;
+    bool finished;
+    ttak_net_workq_worker_stats_t stats;
+    workq_io_t io;
+};
+
+static uint64_t workq_mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+ttak_net_workq_worker_t *ttak_net_workq_worker_create(const ttak_net_workq_worker_config_t *cfg,
+                                                      ttak_shared_net_endpoint_t *endpoint,
+                                                      ttak_owner_t *owner,
+                                                      const void *addr,
+                                                      uint32_t addr_len) {
+    if (!endpoint || addr_len > sizeof(struct sockaddr_storage) || (addr_len > 0 && !addr)) return NULL;
+    ttak_net_workq_worker_t *w = calloc(1, sizeof(*w));
+    if (!w) return NULL;
+    if (cfg) w->cfg = *cfg;
+    if (!w->cfg.leases) w->cfg.leases = 4;
+    if (w->cfg.leases > TTAK_NET_WORKQ_MAX_WORKER_LEASES) w->cfg.leases = TTAK_NET_WORKQ_MAX_WORKER_LEASES;
+    if (!w->cfg.heartbeat_ms) w->cfg.heartbeat_ms = 2000;
+    if (!w->cfg.rto_ms) w->cfg.rto_ms = 200;
+    if (!w->cfg.window) w->cfg.window = 8;
+    if (w->cfg.window > TTAK_NET_WORKQ_MAX_WINDOW) w->cfg.window = TTAK_NET_WORKQ_MAX_WINDOW;
+    if (w->cfg.max_pending_bytes < TTAK_NET_WORKQ_DATAGRAM) {
+        w->cfg.max_pending_bytes = w->cfg.max_pending_bytes ? TTAK_NET_WORKQ_DATAGRAM : 65536;
+    }
+
+    w->pend = malloc(w->cfg.max_pending_bytes);
+    w->inflight = calloc(w->cfg.window, sizeof(*w->inflight));
+    if (!w->pend || !w->inflight) {
+        free(w->pend);
+        free(w->inflight);
+        free(w);
+        return NULL;
+    }
+    w->id = w->cfg.worker_id;
+    if (!w->id) {
+        uint64_t salt = (uint64_t)(uintptr_t)w;
+#ifndef _WIN32
+        salt ^= (uint64_t)getpid() << 32;
+#endif
+        w->id = workq_mix(ttak_get_tick_count_ns() ^ salt);
+        if (!w->id) w->id = 1;
+    }
+    if (addr_len > 0) memcpy(&w->coord_addr, addr, addr_len);
+    w->coord_len = addr_len;
+    ttak_mutex_init(&w->lock);
+    ttak_eventcount_init(&w->changed);
+    w->next_seq = 1;
+    w->hello = true;
+    w->io.endpoint = endpoint;
+    w->io.owner = owner;
+    return w;
+}
+
+void ttak_net_workq_worker_destroy(ttak_net_workq_worker_t *worker) {
+    if (!worker) return;
+    ttak_mutex_destroy(&worker->lock);
+    free(worker->pend);
+    free(worker->inflight);
+    free(worker);
+}
+
+uint64_t ttak_net_workq_worker_id(const ttak_net_workq_worker_t *worker) {
+    return worker->id;
+}
+
+void ttak_net_workq_worker_stats(ttak_net_workq_worker_t *worker, ttak_net_workq_worker_stats_t *out) {
+    ttak_mutex_lock(&worker->lock);
+    *out = worker->stats;
+    ttak_mutex_unlock(&worker->lock);
+}
+
+bool ttak_net_workq_worker_finished(ttak_net_workq_worker_t *worker) {
+    ttak_mutex_lock(&worker->lock);
+    bool done = worker->finished && worker->pend_len == 0 && worker->in_count == 0;
+    ttak_mutex_unlock(&worker->lock);
+    return done;
+}
+
+static worker_slot_t *worker_slot(ttak_net_workq_worker_t *w, uint64_t id) {
+    for (uint32_t i = 0; i < w->cfg.leases; i++) {
+        if (w->slots[i].state != SLOT_FREE && w->slots[i].lease.id == id) return &w->slots[i];
+    }
+    return NULL;
+}
+
+static void worker_send(ttak_net_workq_worker_t *w, const uint8_t *buf, size_t len, uint64_t now) {
+    uint8_t *out = io_out(&w->io, &w->coord_addr, w->coord_len, now);
+    memcpy(out, buf, len);
+    io_push(&w->io, len);
+}
+
+/**
+ * @brief Moves whole entries from the front of the buffer into a new batch.
+ */
+static void worker_seal(ttak_net_workq_worker_t *w, uint64_t now) {
+    worker_dgram_t *d = &w->inflight[(w->in_head + w->in_count) % w->cfg.window];
+    size_t off = 0;
+    uint16_t n = 0;
+    while (off < w->pend_len) {
+        size_t elen = WORKQ_RESULT_HEAD + get_u16(w->pend + off + 8);
+        if (WORKQ_HDR + off + elen > TTAK_NET_WORKQ_DATAGRAM) break;
+        off += elen;
+        n++;
+    }
+    d->seq = w->next_seq++;
+    hdr_put(d->buf, WORKQ_MSG_RESULTS, 0, n, w->id, d->seq);
+    memcpy(d->buf + WORKQ_HDR, w->pend, off);
+    d->len = WORKQ_HDR + off;
+    memmove(w->pend, w->pend + off, w->pend_len - off);
+    w->pend_len -= off;
+    if (w->in_count == 0) w->resend_at = now + w->cfg.rto_ms;
+    w->in_count++;
+    w->stats.batches++;
+    worker_send(w, d->buf, d->len, now);
+}
+
+static void worker_on_grant(ttak_net_workq_worker_t *w, const workq_hdr_t *h, const uint8_t *body, size_t len) {
+    if ((size_t)h->count * WORKQ_GRANT_ENTRY > len) return;
+    w->hello = false;
+    w->finished = (h->flags & WORKQ_FLAG_FINISHED) != 0;
+    for (uint16_t i = 0; i < h->count; i++) {
+        const uint8_t *e = body + (size_t)i * WORKQ_GRANT_ENTRY;
+        uint64_t id = get_u64(e);
+        if (worker_slot(w, id)) continue;
+        for (uint32_t s = 0; s < w->cfg.leases; s++) {
+            if (w->slots[s].state != SLOT_FREE) continue;
+            w->slots[s].lease.id = id;
+            w->slots[s].lease.start = get_u64(e + 8);
+            w->slots[s].lease.count = get_u64(e + 16);
+            w->slots[s].state = SLOT_READY;
+            w->stats.leases++;
+            break;
+        }
+    }
+}
+
+static void worker_on_revoke(ttak_net_workq_worker_t *w, const workq_hdr_t *h, const uint8_t *body, size_t len) {
+    if ((size_t)h->count * WORKQ_ID_ENTRY > len) return;
+    for (uint16_t i = 0; i < h->count; i++) {
+        worker_slot_t *s = worker_slot(w, get_u64(body + (size_t)i * WORKQ_ID_ENTRY));
+        if (!s || s->state == SLOT_REVOKED) continue;
+        s->state = s->state == SLOT_TAKEN ? SLOT_REVOKED : SLOT_FREE;
+        w->stats.revoked++;
+    }
+}
+
+static void worker_on_ack(ttak_net_workq_worker_t *w, const workq_hdr_t *h, uint64_t now) {
+    if (h->flags & WORKQ_FLAG_BUSY) {
+        w->busy_until = now + w->cfg.rto_ms;
+        w->stats.refused++;
+    }
+    bool progressed = false;
+    while (w->in_count > 0 && w->inflight[w->in_head].seq <= h->seq) {
+        // Slots whose DONE entry just landed can take a new lease.
+        const worker_dgram_t *d = &w->inflight[w->in_head];
+        size_t off = WORKQ_HDR;
+        while (off + WORKQ_RESULT_HEAD <= d->len) {
+            if (d->buf[off + 10] == WORKQ_ENTRY_DONE) {
+                worker_slot_t *s = worker_slot(w, get_u64(d->buf + off));
+                if (s && s->state == SLOT_DONE) {
+                    s->state = SLOT_FREE;
+                    w->next_request = 0;
+                }
+            }
+            off += WORKQ_RESULT_HEAD + get_u16(d->buf + off + 8);
+        }
+        w->in_head = (w->in_head + 1) % w->cfg.window;
+        w->in_count--;
+        progressed = true;
+    }
+    if (progressed) w->resend_at = w->in_count ? now + w->cfg.rto_ms : 0;
+}
+
+size_t ttak_net_workq_worker_poll(ttak_net_workq_worker_t *worker, uint32_t wait_ms, uint64_t now) {
+    if (!worker) return 0;
+    ttak_net_workq_worker_t *w = worker;
+    uint8_t msg[TTAK_NET_WORKQ_DATAGRAM];
+    bool changed = false;
+
+    ttak_mutex_lock(&w->lock);
+    uint16_t want = 0, held = 0;
+    for (uint32_t i = 0; i < w->cfg.leases; i++) {
+        if (w->slots[i].state == SLOT_FREE) {
+            want++;
+        } else if (w->slots[i].state != SLOT_REVOKED) {
+            put_u64(msg + WORKQ_HDR + (size_t)held * WORKQ_ID_ENTRY, w->slots[i].lease.id);
+            held++;
+        }
+    }
+    if (held > 0 && now >= w->next_heartbeat) {
+        hdr_put(msg, WORKQ_MSG_HEARTBEAT, 0, held, w->id, 0);
+        worker_send(w, msg, WORKQ_HDR + (size_t)held * WORKQ_ID_ENTRY, now);
+        w->next_heartbeat = now + w->cfg.heartbeat_ms;
+    }
+    if (want > 0 && now >= w->next_request) {
+        hdr_put(msg, WORKQ_MSG_REQUEST, w->hello ? WORKQ_FLAG_HELLO : 0, want, w->id, 0);
+        worker_send(w, msg, WORKQ_HDR, now);
+        w->next_request = now + w->cfg.rto_ms;
+    }
+    if (now >= w->busy_until) {
+        if (w->in_count > 0 && now >= w->resend_at) {
+            for (uint32_t i = 0; i < w->in_count; i++) {
+                const worker_dgram_t *d = &w->inflight[(w->in_head + i) % w->cfg.window];
+                worker_send(w, d->buf, d->len, now);
+            }
+            w->stats.retransmits += w->in_count;
+            w->resend_at = now + w->cfg.rto_ms;
+        }
+        while (w->pend_len > 0 && w->in_count < w->cfg.window) {
+            worker_seal(w, now);
+            changed = true;
+        }
+    }
+    ttak_mutex_unlock(&w->lock);
+    io_flush(&w->io, now);
+
+    size_t got = io_recv(&w->io, wait_ms, now);
+    ttak_mutex_lock(&w->lock);
+    for (size_t i = 0; i < got; i++) {
+        const ttak_net_msg_t *m = &w->io.rx[i];
+        workq_hdr_t h;
+        if ((m->flags & MSG_TRUNC) || !hdr_get(w->io.rx_buf[i], m->bytes, &h) || h.worker != w->id) continue;
+        const uint8_t *body = w->io.rx_buf[i] + WORKQ_HDR;
+        size_t len = m->bytes - WORKQ_HDR;
+        switch (h.type) {
+        case WORKQ_MSG_GRANT:
+            worker_on_grant(w, &h, body, len);
+            break;
+        case WORKQ_MSG_REVOKE:
+            worker_on_revoke(w, &h, body, len);
+            break;
+        case WORKQ_MSG_ACK:
+            worker_on_ack(w, &h, now);
+            break;
+        default:
+            continue;
+        }
+        changed = true;
+    }
+    ttak_mutex_unlock(&w->lock);
+    if (changed) ttak_eventcount_notify_all(&w->changed);
+    return got;
+}
+
+typedef enum worker_op_kind {
+    WORKER_OP_ACQUIRE,
+    WORKER_OP_SUBMIT,
+    WORKER_OP_COMPLETE
+} worker_op_kind_t;
+
+typedef struct worker_op {
+    worker_op_kind_t kind;
+    uint64_t lease;
+    const void *data;
+    uint32_t len;
+    ttak_net_workq_lease_t *out;
+} worker_op_t;
+
+static void worker_append(ttak_net_workq_worker_t *w, uint64_t lease, uint8_t kind, const void *data, uint32_t len) {
+    uint8_t *e = w->pend + w->pend_len;
+    put_u64(e, lease);
+    put_u16(e + 8, (uint16_t)len);
+    e[10] = kind;
+    e[11] = 0;
+    if (len) memcpy(e + WORKQ_RESULT_HEAD, data, len);
+    w->pend_len += WORKQ_RESULT_HEAD + len;
+}
+
+/**
+ * @brief One try at @p op under the lock; TTAK_NET_WORKQ_WOULD_BLOCK means wait.
+ */
+static ttak_net_workq_status_t worker_attempt(ttak_net_workq_worker_t *w, const worker_op_t *op) {
+    ttak_net_workq_status_t st = TTAK_NET_WORKQ_WOULD_BLOCK;
+    ttak_mutex_lock(&w->lock);
+    if (op->kind == WORKER_OP_ACQUIRE) {
+        for (uint32_t i = 0; i < w->cfg.leases; i++) {
+            if (w->slots[i].state == SLOT_READY) {
+                w->slots[i].state = SLOT_TAKEN;
+                *op->out = w->slots[i].lease;
+                st = TTAK_NET_WORKQ_OK;
+                break;
+            }
+        }
+        if (st != TTAK_NET_WORKQ_OK && w->finished) st = TTAK_NET_WORKQ_FINISHED;
+        ttak_mutex_unlock(&w->lock);
+        return st;
+    }
+
+    worker_slot_t *s = worker_slot(w, op->lease);
+    if (!s || (s->state != SLOT_TAKEN && s->state != SLOT_REVOKED)) {
+        st = TTAK_NET_WORKQ_INVALID;
+    } else if (s->state == SLOT_REVOKED) {
+        if (op->kind == WORKER_OP_COMPLETE) s->state = SLOT_FREE;
+        st = TTAK_NET_WORKQ_REVOKED;
+    } else if (w->pend_len + WORKQ_RESULT_HEAD + op->len <= w->cfg.max_pending_bytes) {
+        if (op->kind == WORKER_OP_SUBMIT) {
+            worker_append(w, op->lease, WORKQ_ENTRY_RECORD, op->data, op->len);
+            w->stats.records++;
+        } else {
+            worker_append(w, op->lease, WORKQ_ENTRY_DONE, NULL, 0);
+            s->state = SLOT_DONE;
+        }
+        st = TTAK_NET_WORKQ_OK;
+    }
+    ttak_mutex_unlock(&w->lock);
+    return st;
+}
+
+static ttak_net_workq_status_t worker_run(ttak_net_workq_worker_t *w, const worker_op_t *op, uint64_t timeout_ns) {
+    uint64_t deadline = TTAK_WAIT_FOREVER;
+    if (timeout_ns != 0 && timeout_ns != TTAK_WAIT_FOREVER) {
+        uint64_t now = ttak_get_tick_count_ns();
+        deadline = timeout_ns > TTAK_WAIT_FOREVER - now ? TTAK_WAIT_FOREVER : now + timeout_ns;
+    }
+    for (;;) {
+        ttak_net_workq_status_t st = worker_attempt(w, op);
+        if (st != TTAK_NET_WORKQ_WOULD_BLOCK || timeout_ns == 0) return st;
+        uint64_t left = TTAK_WAIT_FOREVER;
+        if (deadline != TTAK_WAIT_FOREVER) {
+            uint64_t now = ttak_get_tick_count_ns();
+            if (now >= deadline) return TTAK_NET_WORKQ_TIMEOUT;
+            left = deadline - now;
+        }
+        uint32_t key = ttak_eventcount_prepare(&w->changed);
+        st = worker_attempt(w, op);
+        if (st != TTAK_NET_WORKQ_WOULD_BLOCK) {
+            ttak_eventcount_cancel(&w->changed);
+            return st;
+        }
+        ttak_eventcount_wait_for(&w->changed, key, left);
+    }
+}
+
+ttak_net_workq_status_t ttak_net_workq_worker_acquire(ttak_net_workq_worker_t *worker,
+                                                      ttak_net_workq_lease_t *out,
+                                                      uint64_t timeout_ns) {
+    if (!worker || !out) return TTAK_NET_WORKQ_INVALID;
+    worker_op_t op = { .kind = WORKER_OP_ACQUIRE, .out = out };
+    return worker_run(worker, &op, timeout_ns);
+}
+
+ttak_net_workq_status_t ttak_net_workq_worker_submit(ttak_net_workq_worker_t *worker, uint64_t lease,
+                                                     const void *data, uint32_t len, uint64_t timeout_ns) {
+    if (!worker || (len > 0 && !data) || len > TTAK_NET_WORKQ_MAX_RECORD) return TTAK_NET_WORKQ_INVALID;
+    if (WORKQ_RESULT_HEAD + (size_t)len > worker->cfg.max_pending_bytes) return TTAK_NET_WORKQ_INVALID;
+    worker_op_t op = { .kind = WORKER_OP_SUBMIT, .lease = lease, .data = data, .len = len };
+    return worker_run(worker, &op, timeout_ns);
+}
+
+ttak_net_workq_status_t ttak_net_workq_worker_complete(ttak_net_workq_worker_t *worker, uint64_t lease,
+                                                       uint64_t timeout_ns) {
+    if (!worker) return TTAK_NET_WORKQ_INVALID;
+    worker_op_t op = { .kind = WORKER_OP_COMPLETE, .lease = lease };
+    return worker_run(worker, &op, timeout_ns);
+}
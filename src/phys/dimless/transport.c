@@ -8,8 +8,12 @@
  */
 
 #include <ttak/phys/dimless/transport.h>
+#include <ttak/thread/parallel.h>
 
+#include <float.h>
 #include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
 
 static ttak_phys_status_t ttak_phys_require_output(double *out) {
     if (!out) {
@@ -250,3 +254,294 @@ ttak_phys_status_t ttak_phys_calc_km(
     *out_km = (sherwood * diffusivity) / length;
     return TTAK_PHYS_SUCCESS;
 }
+
+/*
+ * Batched variants. The lane checks mirror the validators above but
+ * return the status instead of branching on it, and a lane's status is the
+ * first failing check in the same order as the scalar call. Every compare
+ * is evaluated unconditionally and the results combined as integers: a
+ * compare behind a short circuit could raise a floating-point exception
+ * if hoisted, so the compiler would keep the branch and the loop would not
+ * vectorize. fabs(x) <= DBL_MAX is false exactly for NaN and infinities.
+ */
+
+#define TTAK_PHYS_BATCH_MAX_ARITY 6
+
+static inline int ttak_phys_lane_positive(double value) {
+    const int finite = fabs(value) <= DBL_MAX;
+    const int in_range = value > 0.0;
+    return (1 - finite) * TTAK_PHYS_ERR_INVALID_ARGUMENT + finite * (1 - in_range) * TTAK_PHYS_ERR_OUT_OF_RANGE;
+}
+
+static inline int ttak_phys_lane_real(double value) {
+    const int finite = fabs(value) <= DBL_MAX;
+    return (1 - finite) * TTAK_PHYS_ERR_INVALID_ARGUMENT;
+}
+
+static inline int ttak_phys_lane_non_negative(double value) {
+    const int finite = fabs(value) <= DBL_MAX;
+    const int in_range = value >= 0.0;
+    return (1 - finite) * TTAK_PHYS_ERR_INVALID_ARGUMENT + finite * (1 - in_range) * TTAK_PHYS_ERR_OUT_OF_RANGE;
+}
+
+static inline int ttak_phys_lane_divisor(double value) {
+    const int finite = fabs(value) <= DBL_MAX;
+    const int zero = value == 0.0;
+    const int negative = value < 0.0;
+    return (1 - finite) * TTAK_PHYS_ERR_INVALID_ARGUMENT + zero * TTAK_PHYS_ERR_DIVIDE_BY_ZERO +
+           negative * TTAK_PHYS_ERR_OUT_OF_RANGE;
+}
+
+/* Keeps the earlier failure, if any. */
+static inline int ttak_phys_lane_then(int status, int next) {
+    return status + (status == 0) * next;
+}
+
+/* Fills n lanes; every pointer is already offset to the tile. status never overlaps the doubles. */
+typedef void (*ttak_phys_tile_fn)(double *out, uint8_t *restrict status, const double *const *in, size_t n);
+
+static void ttak_phys_tile_reynolds(double *out, uint8_t *restrict status, const double *const *in, size_t n) {
+    const double *rho = in[0], *velocity = in[1], *length = in[2], *mu = in[3];
+    for (size_t i = 0; i < n; ++i) {
+        int s = ttak_phys_lane_positive(rho[i]);
+        s = ttak_phys_lane_then(s, ttak_phys_lane_positive(length[i]));
+        s = ttak_phys_lane_then(s, ttak_phys_lane_divisor(mu[i]));
+        s = ttak_phys_lane_then(s, ttak_phys_lane_real(velocity[i]));
+        const double re = (rho[i] * fabs(velocity[i]) * length[i]) / mu[i];
+        out[i] = s ? NAN : re;
+        status[i] = (uint8_t)s;
+    }
+}
+
+static void ttak_phys_tile_schmidt(double *out, uint8_t *restrict status, const double *const *in, size_t n) {
+    const double *rho = in[0], *mu = in[1], *diffusivity = in[2];
+    for (size_t i = 0; i < n; ++i) {
+        int s = ttak_phys_lane_positive(rho[i]);
+        s = ttak_phys_lane_then(s, ttak_phys_lane_divisor(diffusivity[i]));
+        s = ttak_phys_lane_then(s, ttak_phys_lane_positive(mu[i]));
+        const double sc = mu[i] / (rho[i] * diffusivity[i]);
+        out[i] = s ? NAN : sc;
+        status[i] = (uint8_t)s;
+    }
+}
+
+static void ttak_phys_tile_mass_peclet(double *out, uint8_t *restrict status, const double *const *in, size_t n) {
+    const double *velocity = in[0], *length = in[1], *diffusivity = in[2];
+    for (size_t i = 0; i < n; ++i) {
+        int s = ttak_phys_lane_divisor(diffusivity[i]);
+        s = ttak_phys_lane_then(s, ttak_phys_lane_positive(length[i]));
+        s = ttak_phys_lane_then(s, ttak_phys_lane_real(velocity[i]));
+        const double pe = (fabs(velocity[i]) * length[i]) / diffusivity[i];
+        out[i] = s ? NAN : pe;
+        status[i] = (uint8_t)s;
+    }
+}
+
+static void ttak_phys_tile_sherwood(double *out, uint8_t *restrict status, const double *const *in, size_t n) {
+    const double *km = in[0], *length = in[1], *diffusivity = in[2];
+    for (size_t i = 0; i < n; ++i) {
+        int s = ttak_phys_lane_non_negative(km[i]);
+        s = ttak_phys_lane_then(s, ttak_phys_lane_positive(length[i]));
+        s = ttak_phys_lane_then(s, ttak_phys_lane_divisor(diffusivity[i]));
+        const double sh = (km[i] * length[i]) / diffusivity[i];
+        out[i] = s ? NAN : sh;
+        status[i] = (uint8_t)s;
+    }
+}
+
+static void ttak_phys_tile_prandtl(double *out, uint8_t *restrict status, const double *const *in, size_t n) {
+    const double *mu = in[0], *cp = in[1], *conductivity = in[2];
+    for (size_t i = 0; i < n; ++i) {
+        int s = ttak_phys_lane_divisor(conductivity[i]);
+        s = ttak_phys_lane_then(s, ttak_phys_lane_positive(mu[i]));
+        s = ttak_phys_lane_then(s, ttak_phys_lane_positive(cp[i]));
+        const double pr = (cp[i] * mu[i]) / conductivity[i];
+        out[i] = s ? NAN : pr;
+        status[i] = (uint8_t)s;
+    }
+}
+
+/* Thermal and mass Grashof numbers share the formula and the checks. */
+static void ttak_phys_tile_grashof(double *out, uint8_t *restrict status, const double *const *in, size_t n) {
+    const double *gravity = in[0], *beta = in[1], *delta = in[2], *length = in[3], *rho = in[4], *mu = in[5];
+    for (size_t i = 0; i < n; ++i) {
+        int s = ttak_phys_lane_divisor(mu[i]);
+        s = ttak_phys_lane_then(s, ttak_phys_lane_positive(rho[i]));
+        s = ttak_phys_lane_then(s, ttak_phys_lane_positive(length[i]));
+        const double nu = mu[i] / rho[i];
+        const double l3 = length[i] * length[i] * length[i];
+        const double gr = (gravity[i] * beta[i] * delta[i] * l3) / (nu * nu);
+        out[i] = s ? NAN : gr;
+        status[i] = (uint8_t)s;
+    }
+}
+
+static void ttak_phys_tile_rayleigh(double *out, uint8_t *restrict status, const double *const *in, size_t n) {
+    const double *grashof = in[0], *pr_or_sc = in[1];
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = grashof[i] * pr_or_sc[i];
+        status[i] = TTAK_PHYS_SUCCESS;
+    }
+}
+
+static void ttak_phys_tile_km(double *out, uint8_t *restrict status, const double *const *in, size_t n) {
+    const double *sherwood = in[0], *length = in[1], *diffusivity = in[2];
+    for (size_t i = 0; i < n; ++i) {
+        int s = ttak_phys_lane_non_negative(sherwood[i]);
+        s = ttak_phys_lane_then(s, ttak_phys_lane_divisor(length[i]));
+        s = ttak_phys_lane_then(s, ttak_phys_lane_positive(diffusivity[i]));
+        const double km = (sherwood[i] * diffusivity[i]) / length[i];
+        out[i] = s ? NAN : km;
+        status[i] = (uint8_t)s;
+    }
+}
+
+typedef struct ttak_phys_batch_job {
+    const ttak_phys_batch_t *batch;
+    double *out;
+    const double *const *in;
+    size_t arity;
+    ttak_phys_tile_fn tile;
+    /* (lane << 8) | status of the lowest failing lane seen so far. */
+    _Atomic uint64_t first_bad;
+} ttak_phys_batch_job_t;
+
+static void ttak_phys_batch_body(void *ctx, size_t begin, size_t end) {
+    ttak_phys_batch_job_t *job = ctx;
+    uint8_t scratch[TTAK_PHYS_BATCH_TILE];
+    const double *in[TTAK_PHYS_BATCH_MAX_ARITY];
+    bool reported = false;
+    for (size_t base = begin; base < end; base += TTAK_PHYS_BATCH_TILE) {
+        size_t n = end - base < TTAK_PHYS_BATCH_TILE ? end - base : TTAK_PHYS_BATCH_TILE;
+        for (size_t a = 0; a < job->arity; ++a) in[a] = job->in[a] + base;
+        uint8_t *status = job->batch->status ? job->batch->status + base : scratch;
+        job->tile(job->out + base, status, in, n);
+        for (size_t i = 0; i < n && !reported; ++i) {
+            if (!status[i]) continue;
+            uint64_t mine = ((uint64_t)(base + i) << 8) | status[i];
+            uint64_t seen = atomic_load_explicit(&job->first_bad, memory_order_relaxed);
+            while (mine < seen &&
+                   !atomic_compare_exchange_weak_explicit(&job->first_bad, &seen, mine,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+            }
+            reported = true;
+        }
+    }
+}
+
+static ttak_phys_status_t ttak_phys_batch_run(
+    const ttak_phys_batch_t *batch,
+    double *out,
+    const double *const *in,
+    size_t arity,
+    ttak_phys_tile_fn tile) {
+    if (!batch) return TTAK_PHYS_ERR_INVALID_ARGUMENT;
+    if (batch->count == 0) return TTAK_PHYS_SUCCESS;
+    ttak_phys_status_t status = ttak_phys_require_output(out);
+    if (status != TTAK_PHYS_SUCCESS) return status;
+    for (size_t a = 0; a < arity; ++a) {
+        if (!in[a]) return TTAK_PHYS_ERR_INVALID_ARGUMENT;
+    }
+
+    ttak_phys_batch_job_t job = { .batch = batch, .out = out, .in = in, .arity = arity, .tile = tile };
+    atomic_init(&job.first_bad, UINT64_MAX);
+    ttak_parallel_for(batch->pool, 0, batch->count, batch->grain, ttak_phys_batch_body, &job, batch->now);
+    uint64_t bad = atomic_load_explicit(&job.first_bad, memory_order_relaxed);
+    return bad == UINT64_MAX ? TTAK_PHYS_SUCCESS : (ttak_phys_status_t)(bad & 0xFF);
+}
+
+ttak_phys_status_t ttak_phys_calc_reynolds_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_re,
+    const double *rho,
+    const double *velocity,
+    const double *length,
+    const double *dynamic_viscosity) {
+    const double *in[] = { rho, velocity, length, dynamic_viscosity };
+    return ttak_phys_batch_run(batch, out_re, in, 4, ttak_phys_tile_reynolds);
+}
+
+ttak_phys_status_t ttak_phys_calc_schmidt_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_sc,
+    const double *rho,
+    const double *dynamic_viscosity,
+    const double *diffusivity) {
+    const double *in[] = { rho, dynamic_viscosity, diffusivity };
+    return ttak_phys_batch_run(batch, out_sc, in, 3, ttak_phys_tile_schmidt);
+}
+
+ttak_phys_status_t ttak_phys_calc_mass_peclet_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_pe,
+    const double *velocity,
+    const double *length,
+    const double *diffusivity) {
+    const double *in[] = { velocity, length, diffusivity };
+    return ttak_phys_batch_run(batch, out_pe, in, 3, ttak_phys_tile_mass_peclet);
+}
+
+ttak_phys_status_t ttak_phys_calc_sherwood_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_sh,
+    const double *mass_transfer_coeff,
+    const double *length,
+    const double *diffusivity) {
+    const double *in[] = { mass_transfer_coeff, length, diffusivity };
+    return ttak_phys_batch_run(batch, out_sh, in, 3, ttak_phys_tile_sherwood);
+}
+
+ttak_phys_status_t ttak_phys_calc_prandtl_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_pr,
+    const double *dynamic_viscosity,
+    const double *specific_heat,
+    const double *thermal_conductivity) {
+    const double *in[] = { dynamic_viscosity, specific_heat, thermal_conductivity };
+    return ttak_phys_batch_run(batch, out_pr, in, 3, ttak_phys_tile_prandtl);
+}
+
+ttak_phys_status_t ttak_phys_calc_grashof_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_gr,
+    const double *gravity,
+    const double *expansion_coeff,
+    const double *delta_temp,
+    const double *length,
+    const double *rho,
+    const double *dynamic_viscosity) {
+    const double *in[] = { gravity, expansion_coeff, delta_temp, length, rho, dynamic_viscosity };
+    return ttak_phys_batch_run(batch, out_gr, in, 6, ttak_phys_tile_grashof);
+}
+
+ttak_phys_status_t ttak_phys_calc_grashof_mass_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_grm,
+    const double *gravity,
+    const double *expansion_coeff_mass,
+    const double *delta_conc,
+    const double *length,
+    const double *rho,
+    const double *dynamic_viscosity) {
+    const double *in[] = { gravity, expansion_coeff_mass, delta_conc, length, rho, dynamic_viscosity };
+    return ttak_phys_batch_run(batch, out_grm, in, 6, ttak_phys_tile_grashof);
+}
+
+ttak_phys_status_t ttak_phys_calc_rayleigh_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_ra,
+    const double *grashof,
+    const double *pr_or_sc) {
+    const double *in[] = { grashof, pr_or_sc };
+    return ttak_phys_batch_run(batch, out_ra, in, 2, ttak_phys_tile_rayleigh);
+}
+
+ttak_phys_status_t ttak_phys_calc_km_batch(
+    const ttak_phys_batch_t *batch,
+    double *out_km,
+    const double *sherwood,
+    const double *length,
+    const double *diffusivity) {
+    const double *in[] = { sherwood, length, diffusivity };
+    return ttak_phys_batch_run(batch, out_km, in, 3, ttak_phys_tile_km);
+}
@@ -1,6 +1,9 @@
 #include <ttak/phys/mem/buddy.h>
 #include <ttak/types/ttak_compiler.h>
 #include <ttak/mem/epoch.h>
+#include <ttak/timing/timing.h>
+#include <ttak/log/logger.h>
+#include <ttak/sync/qlock.h>
 
 #include <stdalign.h>
 #include <stdatomic.h>
@@ -11,6 +14,8 @@
 #include <stdint.h>
 #include <limits.h>
 #include <pthread.h>
+#include <errno.h>
+#include <time.h>
 #if defined(_MSC_VER)
 #include <intrin.h>
 #include <malloc.h>
@@ -63,8 +68,27 @@ typedef struct ttak_buddy_zone {
     _Atomic size_t bytes_in_use;
 } ttak_buddy_zone_t;
 
+/*
+ * Per-thread magazines: a short stack of ready blocks per low order so the
+ * common small request never touches the shared free lists. Blocks parked
+ * in a magazine keep in_use set so a neighbour cannot coalesce with them.
+ */
+#ifndef TTAK_BUDDY_MAGAZINES
+#if defined(__TINYC__)
+#define TTAK_BUDDY_MAGAZINES 0
+#else
+#define TTAK_BUDDY_MAGAZINES 1
+#endif
+#endif
+#define TTAK_BUDDY_MAG_MAX_ORDER TTAK_BUDDY_TIER1_MAX_ORDER
+#define TTAK_BUDDY_MAG_ORDERS (TTAK_BUDDY_MAG_MAX_ORDER - TTAK_BUDDY_MIN_ORDER + 1U)
+#define TTAK_BUDDY_MAG_CAPACITY 32U
+#define TTAK_BUDDY_MAG_BATCH (TTAK_BUDDY_MAG_CAPACITY / 2U)
+
 static ttak_buddy_zone_t g_zone;
-static atomic_flag g_tier1_lock = ATOMIC_FLAG_INIT;
+/* Bumped on every (re)initialisation so stale magazines are discarded. */
+static _Atomic uint64_t g_zone_generation = 0;
+static ttak_hot_lock_t g_tier1_lock;
 static pthread_mutex_t g_tier2_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_rwlock_t g_tier3_lock = PTHREAD_RWLOCK_INITIALIZER;
 static pthread_mutex_t g_tier4_lock = PTHREAD_MUTEX_INITIALIZER;
@@ -88,6 +112,18 @@ static int buddy_debug_enabled(void) {
     return cached;
 }
 
+/*
+ * fprintf() to stderr, limited per call site: allocation failures under
+ * memory pressure would otherwise print once per request.
+ */
+#define BUDDY_LOG(...)                                                                         \
+    do {                                                                                       \
+        static ttak_log_limit_t buddy_log_limit_ = TTAK_LOG_LIMIT_INIT(5.0, 10.0, 1);          \
+        if (ttak_logger_limit_pass(NULL, &buddy_log_limit_, TTAK_LOG_WARN, __FILE__, __LINE__)) { \
+            fprintf(stderr, __VA_ARGS__);                                                      \
+        }                                                                                      \
+    } while (0)
+
 static inline uint8_t ttak_buddy_ctz64(uint64_t value) {
 #if defined(_MSC_VER)
     unsigned long index;
@@ -109,12 +145,11 @@ static inline uint8_t ttak_buddy_msb64(uint64_t value) {
 }
 
 static inline void buddy_lock_tier1(void) {
-    while (atomic_flag_test_and_set_explicit(&g_tier1_lock, memory_order_acquire)) {
-    }
+    ttak_hot_lock(&g_tier1_lock);
 }
 
 static inline void buddy_unlock_tier1(void) {
-    atomic_flag_clear_explicit(&g_tier1_lock, memory_order_release);
+    ttak_hot_unlock(&g_tier1_lock);
 }
 
 static inline void buddy_lock_tier2(void) {
@@ -262,13 +297,46 @@ static void buddy_release_owned_segments_locked(void) {
     }
 }
 
+/*
+ * Returns a segment slot for a new pool. Slots vacated by
+ * buddy_release_free_segments_locked() are reused first; blocks keep
+ * pointers into g_zone.segments, so live slots never move.
+ */
+static ttak_buddy_segment_t *buddy_segment_slot_locked(void) {
+    for (uint8_t i = 0; i < g_zone.segment_count; ++i) {
+        if (!g_zone.segments[i].start) {
+            return &g_zone.segments[i];
+        }
+    }
+    if (g_zone.segment_count >= TTAK_BUDDY_MAX_SEGMENTS) {
+        return NULL;
+    }
+    return &g_zone.segments[g_zone.segment_count++];
+}
+
+/* Unlocked pre-check so a full zone does not allocate a buffer only to drop it. */
+static bool buddy_segment_slot_available(void) {
+    if (g_zone.segment_count < TTAK_BUDDY_MAX_SEGMENTS) {
+        return true;
+    }
+    for (uint8_t i = 0; i < g_zone.segment_count; ++i) {
+        if (!g_zone.segments[i].start) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static bool buddy_add_segment_locked(void *pool_start, size_t pool_len, uint8_t owns_buffer) {
     size_t min_block = order_size(TTAK_BUDDY_MIN_ORDER);
-    if (!pool_start || pool_len < min_block || g_zone.segment_count >= TTAK_BUDDY_MAX_SEGMENTS) {
+    if (!pool_start || pool_len < min_block) {
         return false;
     }
 
-    ttak_buddy_segment_t *segment = &g_zone.segments[g_zone.segment_count++];
+    ttak_buddy_segment_t *segment = buddy_segment_slot_locked();
+    if (!segment) {
+        return false;
+    }
     segment->start = (unsigned char *)pool_start;
     segment->length = pool_len;
     segment->owns_buffer = owns_buffer;
@@ -330,7 +398,7 @@ static bool buddy_should_grow(size_t upcoming_bytes) {
 }
 
 static bool buddy_expand_zone(size_t min_bytes) {
-    if (g_zone.embedded_mode || g_zone.segment_count >= TTAK_BUDDY_MAX_SEGMENTS) {
+    if (g_zone.embedded_mode || !buddy_segment_slot_available()) {
         return false;
     }
 
@@ -344,7 +412,7 @@ static bool buddy_expand_zone(size_t min_bytes) {
 
     if (current_capacity >= capacity_limit) {
         if (buddy_debug_enabled()) {
-            fprintf(stderr, "[Buddy] Auto-growth capped at %zu bytes (limit reached).\n", capacity_limit);
+            BUDDY_LOG("[Buddy] Auto-growth capped at %zu bytes (limit reached).\n", capacity_limit);
         }
         return false;
     }
@@ -390,17 +458,15 @@ static bool buddy_expand_zone(size_t min_bytes) {
     bool added = false;
     uint8_t new_segment_count = 0;
     buddy_lock_all();
-    if (g_zone.segment_count < TTAK_BUDDY_MAX_SEGMENTS) {
-        added = buddy_add_segment_locked(buffer, aligned, 1U);
-        new_segment_count = g_zone.segment_count;
-    }
+    added = buddy_add_segment_locked(buffer, aligned, 1U);
+    new_segment_count = g_zone.segment_count;
     buddy_unlock_all();
 
     if (!added) {
         buddy_heap_free(buffer);
     } else if (buddy_debug_enabled()) {
         size_t cap = buddy_capacity();
-        fprintf(stderr, "[Buddy] Auto-expanded pool by %zu bytes (segments=%u, capacity=%zu)\n",
+        BUDDY_LOG("[Buddy] Auto-expanded pool by %zu bytes (segments=%u, capacity=%zu)\n",
                 aligned, new_segment_count, cap);
     }
     return added;
@@ -490,7 +556,13 @@ static ttak_buddy_block_t *list_pop_head(uint8_t order) {
     return block;
 }
 
-static void list_remove(uint8_t order, ttak_buddy_block_t *target) {
+/**
+ * @brief Unlinks a block from its free list.
+ *
+ * @return true when the block was found on the list; a free-looking buddy
+ *         that is still parked off-list (e.g. mid-release) reports false.
+ */
+static bool list_remove(uint8_t order, ttak_buddy_block_t *target) {
     ttak_buddy_block_t **cur = &g_zone.free_lists[order];
     while (*cur) {
         if (*cur == target) {
@@ -499,43 +571,249 @@ static void list_remove(uint8_t order, ttak_buddy_block_t *target) {
             if (!g_zone.free_lists[order]) {
                 mark_order_empty(order);
             }
-            return;
+            return true;
         }
         cur = &((*cur)->next);
     }
+    return false;
 }
 
-static void buddy_defragment(void) {
-    buddy_lock_background();
-    for (uint8_t order = TTAK_BUDDY_MIN_ORDER; order < g_zone.max_order; ++order) {
+/* Next order the incremental coalescer visits; guarded by the background lock. */
+static uint8_t g_coalesce_cursor = TTAK_BUDDY_MIN_ORDER;
+
+/*
+ * Merges free buddy pairs from @p from upwards, visiting each order once.
+ * Merged blocks land one order up, so a pass cascades as far as the pool
+ * allows. Checks the clock every few blocks and stops once @p deadline_ns
+ * has passed. Caller holds the background lock.
+ *
+ * @return Order to resume from, or 0 once the pass reached the top.
+ */
+static uint8_t buddy_coalesce_locked(uint8_t from, uint64_t deadline_ns, size_t *merges) {
+    size_t visited = 0;
+    for (uint8_t order = from; order < g_zone.max_order; ++order) {
         buddy_lock_for_order(order, true);
         ttak_buddy_block_t *block = g_zone.free_lists[order];
         while (block) {
+            if ((++visited & 31U) == 0 && deadline_ns != UINT64_MAX &&
+                ttak_get_tick_count_ns() >= deadline_ns) {
+                buddy_unlock_for_order(order, true);
+                return order;
+            }
             ttak_buddy_block_t *next = block->next;
             ttak_buddy_block_t *pair = buddy_pair(block, order);
-            if (pair && !pair->in_use && pair->order == order) {
-                list_remove(order, block);
-                list_remove(order, pair);
-                buddy_unlock_for_order(order, true);
-                ttak_buddy_block_t *merged =
-                    (block_offset(block) < block_offset(pair)) ? block : pair;
-                merged->order = order + 1;
-                buddy_lock_for_order(order + 1, true);
-                list_push(order + 1, merged);
-                buddy_unlock_for_order(order + 1, true);
-                buddy_lock_for_order(order, true);
-                block = g_zone.free_lists[order];
+            if (!pair || pair->in_use || pair->order != order) {
+                block = next;
+                continue;
+            }
+            list_remove(order, block);
+            if (!list_remove(order, pair)) {
+                /* The pair is mid-release and will coalesce on its own. */
+                list_push(order, block);
+                block = next;
                 continue;
             }
-            block = next;
+            buddy_unlock_for_order(order, true);
+            ttak_buddy_block_t *merged =
+                (block_offset(block) < block_offset(pair)) ? block : pair;
+            merged->order = order + 1;
+            buddy_lock_for_order(order + 1, true);
+            list_push(order + 1, merged);
+            buddy_unlock_for_order(order + 1, true);
+            if (merges) (*merges)++;
+            buddy_lock_for_order(order, true);
+            block = g_zone.free_lists[order];
         }
         buddy_unlock_for_order(order, true);
     }
+    return 0;
+}
+
+static void buddy_defragment(void) {
+    buddy_lock_background();
+    buddy_coalesce_locked(TTAK_BUDDY_MIN_ORDER, UINT64_MAX, NULL);
+    g_coalesce_cursor = TTAK_BUDDY_MIN_ORDER;
     buddy_unlock_background();
 }
 
+size_t ttak_mem_buddy_coalesce_step(uint64_t budget_ns) {
+    uint64_t now = ttak_get_tick_count_ns();
+    uint64_t deadline = (budget_ns >= UINT64_MAX - now) ? UINT64_MAX : now + budget_ns;
+    size_t merges = 0;
+    buddy_lock_background();
+    uint8_t from = g_coalesce_cursor;
+    if (from < TTAK_BUDDY_MIN_ORDER || from >= g_zone.max_order) {
+        from = TTAK_BUDDY_MIN_ORDER;
+    }
+    uint8_t resume = buddy_coalesce_locked(from, deadline, &merges);
+    g_coalesce_cursor = resume ? resume : TTAK_BUDDY_MIN_ORDER;
+    buddy_unlock_background();
+    return merges;
+}
+
+/*
+ * Unmaps auto-grown segments whose every byte sits on a free list.
+ * Blocks parked in magazines or awaiting epoch reclamation are in use, so
+ * their segment stays. Capacity never drops below @p keep_bytes or below
+ * twice the bytes in use, which keeps the next allocation from tripping
+ * the growth threshold straight away. Caller holds every pool lock.
+ */
+static size_t buddy_release_free_segments_locked(size_t keep_bytes) {
+    size_t free_bytes[TTAK_BUDDY_MAX_SEGMENTS] = {0};
+    for (uint8_t order = TTAK_BUDDY_MIN_ORDER; order <= TTAK_BUDDY_MAX_ORDER; ++order) {
+        for (ttak_buddy_block_t *blk = g_zone.free_lists[order]; blk; blk = blk->next) {
+            free_bytes[blk->segment - g_zone.segments] += order_size(order);
+        }
+    }
+
+    size_t used = atomic_load_explicit(&g_zone.bytes_in_use, memory_order_relaxed);
+    size_t floor = (used > SIZE_MAX / 2U) ? SIZE_MAX : used * 2U;
+    if (floor < keep_bytes) {
+        floor = keep_bytes;
+    }
+
+    size_t released = 0;
+    for (uint8_t i = 0; i < g_zone.segment_count; ++i) {
+        ttak_buddy_segment_t *segment = &g_zone.segments[i];
+        if (!segment->start || !segment->owns_buffer || free_bytes[i] != segment->length) {
+            continue;
+        }
+        size_t capacity = atomic_load_explicit(&g_zone.pool_len, memory_order_relaxed);
+        if (capacity - segment->length < floor) {
+            continue;
+        }
+        for (uint8_t order = TTAK_BUDDY_MIN_ORDER; order <= TTAK_BUDDY_MAX_ORDER; ++order) {
+            ttak_buddy_block_t **cur = &g_zone.free_lists[order];
+            while (*cur) {
+                if ((*cur)->segment == segment) {
+                    *cur = (*cur)->next;
+                } else {
+                    cur = &(*cur)->next;
+                }
+            }
+            if (!g_zone.free_lists[order]) {
+                mark_order_empty(order);
+            }
+        }
+        buddy_heap_free(segment->start);
+        atomic_fetch_sub_explicit(&g_zone.pool_len, segment->length, memory_order_relaxed);
+        released += segment->length;
+        memset(segment, 0, sizeof(*segment));
+    }
+
+    if (released) {
+        g_zone.max_order = 0;
+        g_zone.pool_start = NULL;
+        for (uint8_t i = 0; i < g_zone.segment_count; ++i) {
+            ttak_buddy_segment_t *segment = &g_zone.segments[i];
+            if (!segment->start) continue;
+            if (!g_zone.pool_start) g_zone.pool_start = segment->start;
+            uint8_t segment_max = max_order_for_pool(segment->length);
+            if (segment_max > g_zone.max_order) g_zone.max_order = segment_max;
+        }
+    }
+    return released;
+}
+
+size_t ttak_mem_buddy_release_free_segments(size_t keep_bytes) {
+    buddy_lock_all();
+    size_t released = buddy_release_free_segments_locked(keep_bytes);
+    buddy_unlock_all();
+    if (released && buddy_debug_enabled()) {
+        BUDDY_LOG("[Buddy] Released %zu bytes of free segments (capacity=%zu)\n",
+                released, buddy_capacity());
+    }
+    return released;
+}
+
+static pthread_once_t g_compactor_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_compactor_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_compactor_cond;
+static pthread_t g_compactor_thread;
+static bool g_compactor_started = false;
+static bool g_compactor_stop = false;
+static ttak_mem_buddy_compactor_config_t g_compactor_cfg;
+
+static void buddy_compactor_cond_init(void) {
+#ifdef _WIN32
+    pthread_cond_init(&g_compactor_cond, NULL);
+#else
+    /* Deadlines are computed on CLOCK_MONOTONIC; the condvar must agree. */
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_compactor_cond, &attr);
+    pthread_condattr_destroy(&attr);
+#endif
+}
+
+static void *buddy_compactor_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&g_compactor_lock);
+    while (!g_compactor_stop) {
+        ttak_mem_buddy_compactor_config_t cfg = g_compactor_cfg;
+        pthread_mutex_unlock(&g_compactor_lock);
+
+        ttak_mem_buddy_coalesce_step(cfg.budget_ns);
+        if (cfg.keep_bytes != SIZE_MAX) {
+            ttak_mem_buddy_release_free_segments(cfg.keep_bytes);
+        }
+
+        pthread_mutex_lock(&g_compactor_lock);
+        if (g_compactor_stop) break;
+        uint64_t wake = ttak_get_tick_count_ns() + cfg.interval_ns;
+        struct timespec ts;
+        ts.tv_sec = (time_t)(wake / 1000000000ULL);
+        ts.tv_nsec = (long)(wake % 1000000000ULL);
+        pthread_cond_timedwait(&g_compactor_cond, &g_compactor_lock, &ts);
+    }
+    pthread_mutex_unlock(&g_compactor_lock);
+    return NULL;
+}
+
+int ttak_mem_buddy_start_compactor(const ttak_mem_buddy_compactor_config_t *config) {
+    ttak_mem_buddy_compactor_config_t cfg = {
+        TTAK_MEM_BUDDY_COMPACTOR_INTERVAL_NS, TTAK_MEM_BUDDY_COMPACTOR_BUDGET_NS,
+        TTAK_MEM_BUDDY_COMPACTOR_KEEP_BYTES
+    };
+    if (config) {
+        if (config->interval_ns) cfg.interval_ns = config->interval_ns;
+        if (config->budget_ns) cfg.budget_ns = config->budget_ns;
+        cfg.keep_bytes = config->keep_bytes;
+    }
+    pthread_once(&g_compactor_once, buddy_compactor_cond_init);
+
+    pthread_mutex_lock(&g_compactor_lock);
+    if (g_compactor_started) {
+        pthread_mutex_unlock(&g_compactor_lock);
+        return EALREADY;
+    }
+    g_compactor_cfg = cfg;
+    g_compactor_stop = false;
+    int rc = pthread_create(&g_compactor_thread, NULL, buddy_compactor_main, NULL);
+    if (rc == 0) g_compactor_started = true;
+    pthread_mutex_unlock(&g_compactor_lock);
+    return rc;
+}
+
+void ttak_mem_buddy_stop_compactor(void) {
+    pthread_mutex_lock(&g_compactor_lock);
+    if (!g_compactor_started) {
+        pthread_mutex_unlock(&g_compactor_lock);
+        return;
+    }
+    g_compactor_stop = true;
+    pthread_cond_signal(&g_compactor_cond);
+    pthread_mutex_unlock(&g_compactor_lock);
+    pthread_join(g_compactor_thread, NULL);
+    pthread_mutex_lock(&g_compactor_lock);
+    g_compactor_started = false;
+    pthread_mutex_unlock(&g_compactor_lock);
+}
+
 void ttak_mem_buddy_init(void *pool_start, size_t pool_len, int embedded_mode) {
     buddy_lock_all();
+    atomic_fetch_add_explicit(&g_zone_generation, 1, memory_order_acq_rel);
     buddy_release_owned_segments_locked();
     atomic_store_explicit(&g_free_mask, 0, memory_order_relaxed);
     memset(&g_zone, 0, sizeof(g_zone));
@@ -548,7 +826,7 @@ void ttak_mem_buddy_init(void *pool_start, size_t pool_len, int embedded_mode) {
     }
     if (buddy_debug_enabled()) {
         size_t cap = atomic_load_explicit(&g_zone.pool_len, memory_order_relaxed);
-        fprintf(stderr, "[Buddy] Initialized pool_len=%zu embedded_mode=%u segments=%u\n",
+        BUDDY_LOG("[Buddy] Initialized pool_len=%zu embedded_mode=%u segments=%u\n",
                 cap, g_zone.embedded_mode, g_zone.segment_count);
     }
     buddy_unlock_all();
@@ -611,6 +889,142 @@ static void split_block(uint8_t target_order, ttak_buddy_block_t *block) {
     block->in_use = 1;
 }
 
+/* Returns a block to the shared free lists, coalescing with free buddies. */
+static void buddy_release_block(ttak_buddy_block_t *block) {
+    while (true) {
+        uint8_t order = block->order;
+        buddy_lock_for_order(order, true);
+        block->in_use = 0;
+        if (order >= g_zone.max_order) {
+            list_push(order, block);
+            buddy_unlock_for_order(order, true);
+            break;
+        }
+        ttak_buddy_block_t *pair = buddy_pair(block, order);
+        if (!pair || pair->in_use || pair->order != order ||
+            !list_remove(order, pair)) {
+            list_push(order, block);
+            buddy_unlock_for_order(order, true);
+            break;
+        }
+        buddy_unlock_for_order(order, true);
+        block = (block_offset(block) < block_offset(pair)) ? block : pair;
+        block->order = order + 1U;
+    }
+}
+
+#if TTAK_BUDDY_MAGAZINES
+typedef struct ttak_buddy_magazine {
+    uint32_t count;
+    ttak_buddy_block_t *blocks[TTAK_BUDDY_MAG_CAPACITY];
+} ttak_buddy_magazine_t;
+
+typedef struct ttak_buddy_mag_cache {
+    uint64_t generation;
+    ttak_buddy_magazine_t mags[TTAK_BUDDY_MAG_ORDERS];
+} ttak_buddy_mag_cache_t;
+
+static _Thread_local ttak_buddy_mag_cache_t t_buddy_mags;
+static _Thread_local bool t_buddy_mags_registered = false;
+static pthread_once_t g_buddy_mag_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_buddy_mag_key;
+
+/*
+ * Pushes @p count blocks back to the shared lists under one tier-1 lock
+ * acquisition. Merges that climb out of tier 1 are finished afterwards
+ * through the regular per-order path.
+ */
+static void buddy_mag_flush(ttak_buddy_block_t **blocks, uint32_t count) {
+    ttak_buddy_block_t *escalated = NULL;
+    buddy_lock_tier1();
+    for (uint32_t i = 0; i < count; ++i) {
+        ttak_buddy_block_t *block = blocks[i];
+        block->in_use = 0;
+        while (true) {
+            uint8_t order = block->order;
+            ttak_buddy_block_t *pair =
+                (order < g_zone.max_order) ? buddy_pair(block, order) : NULL;
+            if (!pair || pair->in_use || pair->order != order ||
+                !list_remove(order, pair)) {
+                list_push(order, block);
+                break;
+            }
+            block = (block_offset(block) < block_offset(pair)) ? block : pair;
+            block->order = order + 1U;
+            if (block->order > TTAK_BUDDY_TIER1_MAX_ORDER) {
+                block->next = escalated;
+                escalated = block;
+                break;
+            }
+        }
+    }
+    buddy_unlock_tier1();
+    while (escalated) {
+        ttak_buddy_block_t *next = escalated->next;
+        escalated->next = NULL;
+        buddy_release_block(escalated);
+        escalated = next;
+    }
+}
+
+static void buddy_mag_destructor(void *arg) {
+    ttak_buddy_mag_cache_t *cache = (ttak_buddy_mag_cache_t *)arg;
+    if (!cache) return;
+    if (cache->generation == atomic_load_explicit(&g_zone_generation, memory_order_acquire)) {
+        for (uint32_t i = 0; i < TTAK_BUDDY_MAG_ORDERS; ++i) {
+            buddy_mag_flush(cache->mags[i].blocks, cache->mags[i].count);
+        }
+    }
+    memset(cache, 0, sizeof(*cache));
+}
+
+/* Returns every block parked in this thread's magazines to the shared lists. */
+static void buddy_mag_drain_local(void) {
+    if (t_buddy_mags.generation != atomic_load_explicit(&g_zone_generation, memory_order_acquire)) {
+        return;
+    }
+    for (uint32_t i = 0; i < TTAK_BUDDY_MAG_ORDERS; ++i) {
+        buddy_mag_flush(t_buddy_mags.mags[i].blocks, t_buddy_mags.mags[i].count);
+        t_buddy_mags.mags[i].count = 0;
+    }
+}
+
+static void buddy_mag_key_init(void) {
+    pthread_key_create(&g_buddy_mag_key, buddy_mag_destructor);
+}
+
+/* Returns this thread's magazine for @p order, or NULL when not cached. */
+static ttak_buddy_magazine_t *buddy_mag_for_order(uint8_t order) {
+    if (order < TTAK_BUDDY_MIN_ORDER || order > TTAK_BUDDY_MAG_MAX_ORDER) {
+        return NULL;
+    }
+    uint64_t generation = atomic_load_explicit(&g_zone_generation, memory_order_acquire);
+    if (TTAK_UNLIKELY(t_buddy_mags.generation != generation)) {
+        /* Pool was re-initialised; cached blocks point into the old zone. */
+        memset(t_buddy_mags.mags, 0, sizeof(t_buddy_mags.mags));
+        t_buddy_mags.generation = generation;
+    }
+    if (TTAK_UNLIKELY(!t_buddy_mags_registered)) {
+        pthread_once(&g_buddy_mag_once, buddy_mag_key_init);
+        pthread_setspecific(g_buddy_mag_key, &t_buddy_mags);
+        t_buddy_mags_registered = true;
+    }
+    return &t_buddy_mags.mags[order - TTAK_BUDDY_MIN_ORDER];
+}
+
+/* Refills a magazine with exact-order blocks under one lock acquisition. */
+static void buddy_mag_refill(ttak_buddy_magazine_t *mag, uint8_t order) {
+    buddy_lock_tier1();
+    while (mag->count < TTAK_BUDDY_MAG_BATCH) {
+        ttak_buddy_block_t *block = list_pop_head(order);
+        if (!block) break;
+        block->in_use = 1;
+        mag->blocks[mag->count++] = block;
+    }
+    buddy_unlock_tier1();
+}
+#endif
+
 void *ttak_mem_buddy_alloc(const ttak_mem_req_t *req) {
     if (!req) {
         return NULL;
@@ -618,7 +1032,7 @@ void *ttak_mem_buddy_alloc(const ttak_mem_req_t *req) {
 
     /* Overflow check */
     if (req->size_bytes > (size_t)-1 - sizeof(ttak_buddy_block_t)) {
-        fprintf(stderr, "[Buddy] ENOMEM(12): Requested size %zu overflows size_t.\n", req->size_bytes);
+        BUDDY_LOG("[Buddy] ENOMEM(12): Requested size %zu overflows size_t.\n", req->size_bytes);
         return NULL;
     }
 
@@ -630,13 +1044,31 @@ void *ttak_mem_buddy_alloc(const ttak_mem_req_t *req) {
         return NULL;
     }
 
+#if TTAK_BUDDY_MAGAZINES
+    /* Worst-fit callers ask for the largest hole, which a magazine cannot honour. */
+    ttak_buddy_magazine_t *mag =
+        (req->priority != TTAK_PRIORITY_WORST_FIT) ? buddy_mag_for_order(order) : NULL;
+    if (mag) {
+        if (mag->count == 0) {
+            buddy_mag_refill(mag, order);
+        }
+        if (mag->count > 0) {
+            ttak_buddy_block_t *cached = mag->blocks[--mag->count];
+            buddy_account_alloc(cached->order);
+            cached->owner_tag = req->owner_tag;
+            cached->call_safety = req->call_safety;
+            return (void *)(cached + 1);
+        }
+    }
+#endif
+
     if (order > g_zone.max_order && !g_zone.embedded_mode) {
         if (buddy_expand_zone(block_bytes)) {
             /* max_order updated inside buddy_expand_zone */
         }
     }
     if (order > g_zone.max_order) {
-        fprintf(stderr, "[Buddy] ENOMEM(12): Requested size %zu + header exceeds max_order %u. g_zone: pool_len=%zu\n",
+        BUDDY_LOG("[Buddy] ENOMEM(12): Requested size %zu + header exceeds max_order %u. g_zone: pool_len=%zu\n",
                 req->size_bytes, g_zone.max_order, buddy_capacity());
         return NULL;
     }
@@ -652,6 +1084,10 @@ void *ttak_mem_buddy_alloc(const ttak_mem_req_t *req) {
         }
     }
     if (!block) {
+#if TTAK_BUDDY_MAGAZINES
+        /* Parked blocks cannot coalesce; give them back before defragmenting. */
+        buddy_mag_drain_local();
+#endif
         buddy_defragment();
         block = select_block(order, req->priority);
     }
@@ -662,7 +1098,7 @@ void *ttak_mem_buddy_alloc(const ttak_mem_req_t *req) {
         }
     }
     if (!block) {
-        fprintf(stderr, "[Buddy] ENOMEM(12): Allocation failed for needed size %zu (order %u). Current pool state: pool_len=%zu, max_order=%u\n",
+        BUDDY_LOG("[Buddy] ENOMEM(12): Allocation failed for needed size %zu (order %u). Current pool state: pool_len=%zu, max_order=%u\n",
                 needed, order, buddy_capacity(), g_zone.max_order);
         return NULL;
     }
@@ -673,30 +1109,71 @@ void *ttak_mem_buddy_alloc(const ttak_mem_req_t *req) {
     return (void *)(block + 1);
 }
 
+int ttak_mem_buddy_grow(void *ptr, size_t size_bytes) {
+    if (!ptr || size_bytes > (size_t)-1 - sizeof(ttak_buddy_block_t)) return 0;
+    ttak_buddy_block_t *block = ((ttak_buddy_block_t *)ptr) - 1;
+    uint8_t want = order_for_size(size_bytes + sizeof(ttak_buddy_block_t));
+    uint8_t start = block->order;
+    if (want <= start) return 1;
+    if (want > g_zone.max_order) return 0;
+
+    /* Same pairing as buddy_release_block(), but the block stays in use. */
+    while (block->order < want) {
+        uint8_t order = block->order;
+        if (block_offset(block) & order_size(order)) break;
+        buddy_lock_for_order(order, true);
+        ttak_buddy_block_t *pair = buddy_pair(block, order);
+        bool absorbed = pair && !pair->in_use && pair->order == order && list_remove(order, pair);
+        buddy_unlock_for_order(order, true);
+        if (!absorbed) break;
+        block->order = order + 1U;
+    }
+    if (block->order < want) {
+        /* Hand back whatever was absorbed before the run stopped. */
+        split_block(start, block);
+        return 0;
+    }
+    buddy_account_free(start);
+    buddy_account_alloc(block->order);
+    return 1;
+}
+
 static void ttak_buddy_cleanup(void *ptr) {
     if (!ptr) return;
     ttak_buddy_block_t *block = (ttak_buddy_block_t *)ptr;
     buddy_account_free(block->order);
-    while (true) {
-        uint8_t order = block->order;
-        buddy_lock_for_order(order, true);
-        block->in_use = 0;
-        if (order >= g_zone.max_order) {
-            list_push(order, block);
-            buddy_unlock_for_order(order, true);
-            break;
+#if TTAK_BUDDY_MAGAZINES
+    ttak_buddy_magazine_t *mag = buddy_mag_for_order(block->order);
+    if (mag) {
+        if (mag->count == TTAK_BUDDY_MAG_CAPACITY) {
+            mag->count -= TTAK_BUDDY_MAG_BATCH;
+            buddy_mag_flush(&mag->blocks[mag->count], TTAK_BUDDY_MAG_BATCH);
         }
-        ttak_buddy_block_t *pair = buddy_pair(block, order);
-        if (!pair || pair->in_use || pair->order != order) {
-            list_push(order, block);
-            buddy_unlock_for_order(order, true);
-            break;
+        block->in_use = 1;
+        mag->blocks[mag->count++] = block;
+        return;
+    }
+#endif
+    buddy_release_block(block);
+}
+
+_Static_assert(TTAK_MEM_BUDDY_ORDER_COUNT == TTAK_BUDDY_MAX_ORDER + 1U, "buddy order count mismatch");
+
+void ttak_mem_buddy_stats(ttak_mem_buddy_stats_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    buddy_lock_all();
+    out->pool_bytes = atomic_load_explicit(&g_zone.pool_len, memory_order_relaxed);
+    out->bytes_in_use = atomic_load_explicit(&g_zone.bytes_in_use, memory_order_relaxed);
+    for (uint8_t order = TTAK_BUDDY_MIN_ORDER; order <= TTAK_BUDDY_MAX_ORDER; ++order) {
+        size_t count = 0;
+        for (ttak_buddy_block_t *blk = g_zone.free_lists[order]; blk; blk = blk->next) {
+            count++;
         }
-        list_remove(order, pair);
-        buddy_unlock_for_order(order, true);
-        block = (block_offset(block) < block_offset(pair)) ? block : pair;
-        block->order = order + 1U;
+        out->free_blocks[order] = count;
+        if (count) out->largest_free_block = order_size(order);
     }
+    buddy_unlock_all();
 }
 
 void ttak_mem_buddy_free(void *ptr) {
@@ -137,3 +137,209 @@ void ttak_heap_tree_destroy(ttak_heap_tree_t *heap, uint64_t now) {
     heap->size = 0;
     heap->capacity = 0;
 }
+
+/* Free handles keep their free-list link in @c where, tagged by this bit. */
+#define DHEAP_FREE 0x80000000u
+
+/* Slots before position 0, so each sibling group d*p+1..d*p+d starts a line. */
+#define DHEAP_LEAD (TTAK_DHEAP_ARITY - 1)
+
+_Static_assert(sizeof(ttak_dheap_entry_t) * TTAK_DHEAP_ARITY % 64 == 0,
+               "a sibling group must fill whole cache lines");
+
+static void *dheap_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
+}
+
+static void dheap_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/**
+ * @brief Allocate a d-ary heap with room for @p capacity entries.
+ *
+ * @param heap     Heap to initialize.
+ * @param capacity Most entries held at once; below 2^31.
+ * @return False on allocation failure or bad capacity.
+ */
+bool ttak_dheap_init(ttak_dheap_t *heap, uint32_t capacity) {
+    if (!heap) return false;
+    memset(heap, 0, sizeof(*heap));
+    if (capacity == 0 || capacity >= DHEAP_FREE) return false;
+
+    heap->block = dheap_aligned_alloc(sizeof(ttak_dheap_entry_t) * ((size_t)capacity + DHEAP_LEAD));
+    heap->handles = (uint32_t *)malloc(sizeof(uint32_t) * capacity);
+    heap->where = (uint32_t *)malloc(sizeof(uint32_t) * capacity);
+    if (!heap->block || !heap->handles || !heap->where) {
+        ttak_dheap_destroy(heap);
+        return false;
+    }
+    heap->entries = (ttak_dheap_entry_t *)heap->block + DHEAP_LEAD;
+    heap->capacity = capacity;
+    for (uint32_t i = 0; i < capacity; i++) {
+        heap->where[i] = DHEAP_FREE | (i + 1 < capacity ? i + 1 : (DHEAP_FREE - 1));
+    }
+    heap->free_head = 0;
+    return true;
+}
+
+/**
+ * @brief Release the d-ary heap's storage.
+ *
+ * @param heap Heap to destroy.
+ */
+void ttak_dheap_destroy(ttak_dheap_t *heap) {
+    if (!heap) return;
+    if (heap->block) dheap_aligned_free(heap->block);
+    free(heap->handles);
+    free(heap->where);
+    memset(heap, 0, sizeof(*heap));
+}
+
+/* Writes @p e with handle @p h to position @p pos. */
+static inline void dheap_place(ttak_dheap_t *heap, uint32_t pos, ttak_dheap_entry_t e, uint32_t h) {
+    heap->entries[pos] = e;
+    heap->handles[pos] = h;
+    heap->where[h] = pos;
+}
+
+/* Moves the hole at @p pos up until @p e fits, then fills it. */
+static void dheap_sift_up(ttak_dheap_t *heap, uint32_t pos, ttak_dheap_entry_t e, uint32_t h) {
+    while (pos > 0) {
+        uint32_t parent = (pos - 1) / TTAK_DHEAP_ARITY;
+        if (heap->entries[parent].key <= e.key) break;
+        dheap_place(heap, pos, heap->entries[parent], heap->handles[parent]);
+        pos = parent;
+    }
+    dheap_place(heap, pos, e, h);
+}
+
+/* Moves the hole at @p pos down until @p e fits, then fills it. */
+static void dheap_sift_down(ttak_dheap_t *heap, uint32_t pos, ttak_dheap_entry_t e, uint32_t h) {
+    for (;;) {
+        uint32_t first = pos * TTAK_DHEAP_ARITY + 1;
+        if (first >= heap->size) break;
+        uint32_t last = first + TTAK_DHEAP_ARITY < heap->size ? first + TTAK_DHEAP_ARITY : heap->size;
+        uint32_t best = first;
+        for (uint32_t c = first + 1; c < last; c++) {
+            if (heap->entries[c].key < heap->entries[best].key) best = c;
+        }
+        if (heap->entries[best].key >= e.key) break;
+        dheap_place(heap, pos, heap->entries[best], heap->handles[best]);
+        pos = best;
+    }
+    dheap_place(heap, pos, e, h);
+}
+
+/**
+ * @brief Insert a keyed payload.
+ *
+ * @param heap    Heap to update.
+ * @param key     Ordering key; smallest pops first.
+ * @param payload Value stored inline with the key.
+ * @return Handle for later update/remove, or TTAK_DHEAP_NONE when full.
+ */
+uint32_t ttak_dheap_push(ttak_dheap_t *heap, uint64_t key, uintptr_t payload) {
+    if (!heap || heap->size >= heap->capacity) return TTAK_DHEAP_NONE;
+    uint32_t h = heap->free_head;
+    uint32_t next = heap->where[h] & ~DHEAP_FREE;
+    heap->free_head = next < heap->capacity ? next : TTAK_DHEAP_NONE;
+
+    ttak_dheap_entry_t e = { key, payload };
+    dheap_sift_up(heap, heap->size++, e, h);
+    return h;
+}
+
+/**
+ * @brief Read the minimum without removing it.
+ *
+ * @param heap    Heap to inspect.
+ * @param key     Receives the key, may be NULL.
+ * @param payload Receives the payload, may be NULL.
+ * @return False if empty.
+ */
+bool ttak_dheap_peek(const ttak_dheap_t *heap, uint64_t *key, uintptr_t *payload) {
+    if (!heap || heap->size == 0) return false;
+    if (key) *key = heap->entries[0].key;
+    if (payload) *payload = heap->entries[0].payload;
+    return true;
+}
+
+/**
+ * @brief Check whether a handle names a live entry.
+ */
+bool ttak_dheap_contains(const ttak_dheap_t *heap, uint32_t handle) {
+    return heap && handle < heap->capacity && !(heap->where[handle] & DHEAP_FREE);
+}
+
+/**
+ * @brief Remove the entry at handle @p handle.
+ *
+ * @param heap    Heap to update.
+ * @param handle  Handle returned by ttak_dheap_push().
+ * @param payload Receives the payload, may be NULL.
+ * @return False if the handle is not live.
+ */
+bool ttak_dheap_remove(ttak_dheap_t *heap, uint32_t handle, uintptr_t *payload) {
+    if (!ttak_dheap_contains(heap, handle)) return false;
+    uint32_t pos = heap->where[handle];
+    if (payload) *payload = heap->entries[pos].payload;
+
+    uint32_t last = --heap->size;
+    if (pos != last) {
+        // The last entry fills the hole, moving whichever way its key says.
+        ttak_dheap_entry_t e = heap->entries[last];
+        uint32_t h = heap->handles[last];
+        if (pos > 0 && e.key < heap->entries[(pos - 1) / TTAK_DHEAP_ARITY].key) {
+            dheap_sift_up(heap, pos, e, h);
+        } else {
+            dheap_sift_down(heap, pos, e, h);
+        }
+    }
+    heap->where[handle] = DHEAP_FREE | (heap->free_head == TTAK_DHEAP_NONE ? DHEAP_FREE - 1 : heap->free_head);
+    heap->free_head = handle;
+    return true;
+}
+
+/**
+ * @brief Remove the minimum.
+ *
+ * @param heap    Heap to update.
+ * @param key     Receives the key, may be NULL.
+ * @param payload Receives the payload, may be NULL.
+ * @return False if empty.
+ */
+bool ttak_dheap_pop(ttak_dheap_t *heap, uint64_t *key, uintptr_t *payload) {
+    if (!heap || heap->size == 0) return false;
+    if (key) *key = heap->entries[0].key;
+    return ttak_dheap_remove(heap, heap->handles[0], payload);
+}
+
+/**
+ * @brief Re-key a live entry (decrease-key or increase-key).
+ *
+ * @param heap   Heap to update.
+ * @param handle Handle returned by ttak_dheap_push().
+ * @param key    New key.
+ * @return False if the handle is not live.
+ */
+bool ttak_dheap_update(ttak_dheap_t *heap, uint32_t handle, uint64_t key) {
+    if (!ttak_dheap_contains(heap, handle)) return false;
+    uint32_t pos = heap->where[handle];
+    ttak_dheap_entry_t e = heap->entries[pos];
+    bool up = key < e.key;
+    e.key = key;
+    if (up) dheap_sift_up(heap, pos, e, handle);
+    else dheap_sift_down(heap, pos, e, handle);
+    return true;
+}
@@ -1,94 +1,208 @@
 #include <ttak/priority/internal/queue.h>
 #include <ttak/mem/mem.h>
+#include <ttak/types/ttak_compiler.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 
+#ifdef TTAK_QUEUE_TRACE
+#define PQ_TRACE(...) fprintf(stderr, __VA_ARGS__)
+#else
+#define PQ_TRACE(...) ((void)0)
+#endif
+
+#define PQ_BAND_MASK ((size_t)TTAK_PQ_BAND_CAPACITY - 1U)
+
+/**
+ * @brief One ring slot. @c seq says whose turn it is: pos for a producer,
+ *        pos + 1 for a consumer.
+ */
+typedef struct {
+    _Atomic size_t seq;
+    ttak_task_t *task;
+} pq_cell_t;
+
 /**
- * @brief Insert a task into the queue according to its priority.
+ * @brief Bounded MPMC ring (Vyukov). Producers and consumers each claim a
+ *        position with one CAS on their own cache line.
+ */
+struct __internal_ttak_pq_ring_t {
+    _Alignas(64) _Atomic size_t enqueue_pos;
+    _Alignas(64) _Atomic size_t dequeue_pos;
+    _Alignas(64) pq_cell_t cells[TTAK_PQ_BAND_CAPACITY];
+};
+
+static inline unsigned pq_band_for_priority(int priority) {
+    if (priority < TTAK_PQ_PRIORITY_MIN) priority = TTAK_PQ_PRIORITY_MIN;
+    if (priority > TTAK_PQ_PRIORITY_MAX) priority = TTAK_PQ_PRIORITY_MAX;
+    return (unsigned)(priority - TTAK_PQ_PRIORITY_MIN);
+}
+
+/**
+ * @brief Returns the ring for @p band, installing a fresh one on first use.
+ */
+static __internal_ttak_pq_ring_t *pq_band_ring(struct __internal_ttak_proc_priority_queue_t *q, unsigned band) {
+    __internal_ttak_pq_ring_t *ring = atomic_load_explicit(&q->bands[band], memory_order_acquire);
+    if (ring) return ring;
+
+    __internal_ttak_pq_ring_t *fresh = (__internal_ttak_pq_ring_t *)ttak_dangerous_alloc(sizeof(*fresh));
+    if (!fresh) return NULL;
+    atomic_init(&fresh->enqueue_pos, 0);
+    atomic_init(&fresh->dequeue_pos, 0);
+    for (size_t i = 0; i < TTAK_PQ_BAND_CAPACITY; i++) {
+        atomic_init(&fresh->cells[i].seq, i);
+    }
+    if (!atomic_compare_exchange_strong_explicit(&q->bands[band], &ring, fresh,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        ttak_dangerous_free(fresh);
+        return ring;
+    }
+    return fresh;
+}
+
+static bool pq_ring_push(__internal_ttak_pq_ring_t *ring, ttak_task_t *task) {
+    size_t pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        pq_cell_t *cell = &ring->cells[pos & PQ_BAND_MASK];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                cell->task = task;
+                atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+                return true;
+            }
+        } else if (dif < 0) {
+            return false; /* Full: the consumer of this lap has not caught up. */
+        } else {
+            pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+static ttak_task_t *pq_ring_pop(__internal_ttak_pq_ring_t *ring) {
+    size_t pos = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+    for (;;) {
+        pq_cell_t *cell = &ring->cells[pos & PQ_BAND_MASK];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                ttak_task_t *task = cell->task;
+                atomic_store_explicit(&cell->seq, pos + TTAK_PQ_BAND_CAPACITY, memory_order_release);
+                return task;
+            }
+        } else if (dif < 0) {
+            return NULL; /* Empty. */
+        } else {
+            pos = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Enqueue a task in the band for its priority.
  *
  * @param q        Queue to update.
  * @param task     Task to enqueue.
  * @param priority Priority score (higher = sooner).
- * @param now      Timestamp for allocations.
+ * @param now      Unused; kept for the vtable signature.
+ * @return False if the band is full or its ring could not be allocated.
  */
-static void q_push(struct __internal_ttak_proc_priority_queue_t *q, ttak_task_t *task, int priority, uint64_t now) {
+static _Bool q_push(struct __internal_ttak_proc_priority_queue_t *q, ttak_task_t *task, int priority, uint64_t now) {
     (void)now;
-    if (!q) return;
-    struct __internal_ttak_qnode_t *node = (struct __internal_ttak_qnode_t *)ttak_dangerous_alloc(sizeof(struct __internal_ttak_qnode_t));
-    if (!node) {
-        fprintf(stderr, "[queue] push failed: node alloc failed\n");
-        return;
+    if (!q || !task) return 0;
+    unsigned band = pq_band_for_priority(priority);
+    __internal_ttak_pq_ring_t *ring = pq_band_ring(q, band);
+    if (!ring || !pq_ring_push(ring, task)) {
+        PQ_TRACE("[queue] push failed task=%p priority=%d shard=%p\n", (void*)task, priority, (void*)q);
+        return 0;
     }
-    fprintf(stderr, "[queue] push task=%p priority=%d shard=%p head=%p\n", (void*)task, priority, (void*)q, (void*)q->head);
-    node->task = task;
-    node->priority = priority;
-    node->next = NULL;
-    if (!q->head || q->head->priority < priority) {
-        node->next = q->head;
-        q->head = node;
-    } else {
-        struct __internal_ttak_qnode_t *current = q->head;
-        while (current->next && current->next->priority >= priority) {
-            current = current->next;
-        }
-        node->next = current->next;
-        current->next = node;
-    }
-    q->size++;
+    atomic_fetch_add_explicit(&q->size, 1, memory_order_relaxed);
+    /* Publish the band after the task so a popper that sees the bit finds it. */
+    atomic_fetch_or_explicit(&q->nonempty, UINT64_C(1) << band, memory_order_seq_cst);
+    PQ_TRACE("[queue] push task=%p priority=%d band=%u shard=%p\n", (void*)task, priority, band, (void*)q);
+    return 1;
 }
 
 /**
- * @brief Remove the highest-priority task if one exists.
+ * @brief Remove a task from the most urgent non-empty band.
  *
  * @param q   Queue to pop from.
- * @param now Timestamp for pointer access validation.
+ * @param now Unused; kept for the vtable signature.
  * @return Task pointer or NULL when empty.
  */
 static ttak_task_t *q_pop(struct __internal_ttak_proc_priority_queue_t *q, uint64_t now) {
     (void)now;
-    if (!q || !q->head) return NULL;
-    struct __internal_ttak_qnode_t *node = q->head;
-    
-    ttak_task_t *task = node->task;
-    q->head = node->next;
-    q->size--;
-    ttak_dangerous_free(node);
-    fprintf(stderr, "[queue] pop task=%p shard=%p new_head=%p size=%zu\n", (void*)task, (void*)q, (void*)q->head, q->size);
-    return task;
+    if (!q) return NULL;
+    uint64_t bits = atomic_load_explicit(&q->nonempty, memory_order_seq_cst);
+    while (bits) {
+        unsigned band = 63U - (unsigned)__builtin_clzll(bits);
+        __internal_ttak_pq_ring_t *ring = atomic_load_explicit(&q->bands[band], memory_order_acquire);
+        ttak_task_t *task = ring ? pq_ring_pop(ring) : NULL;
+        if (task) {
+            atomic_fetch_sub_explicit(&q->size, 1, memory_order_relaxed);
+            PQ_TRACE("[queue] pop task=%p band=%u shard=%p\n", (void*)task, band, (void*)q);
+            return task;
+        }
+        /*
+         * The band looked empty: clear its bit, then look once more so a
+         * push that set the bit before the clear is not stranded.
+         */
+        uint64_t bit = UINT64_C(1) << band;
+        atomic_fetch_and_explicit(&q->nonempty, ~bit, memory_order_seq_cst);
+        task = ring ? pq_ring_pop(ring) : NULL;
+        if (task) {
+            atomic_fetch_or_explicit(&q->nonempty, bit, memory_order_seq_cst);
+            atomic_fetch_sub_explicit(&q->size, 1, memory_order_relaxed);
+            PQ_TRACE("[queue] pop task=%p band=%u shard=%p\n", (void*)task, band, (void*)q);
+            return task;
+        }
+        bits = atomic_load_explicit(&q->nonempty, memory_order_seq_cst) & (bit - 1U);
+    }
+    return NULL;
 }
 
 /**
  * @brief Block until a task is available, then pop it.
  *
+ * Producers must signal @p cond while holding @p mutex, or a wakeup may
+ * be missed; push itself does not take the mutex.
+ *
  * @param q     Queue to pop from.
- * @param mutex Mutex associated with the condition variable.
+ * @param mutex Mutex associated with the condition variable (held by the caller).
  * @param cond  Condition variable signaled when tasks arrive.
  * @param now   Timestamp for pointer validation.
  * @return Popped task pointer.
  */
 static ttak_task_t *q_pop_blocking(struct __internal_ttak_proc_priority_queue_t *q, pthread_mutex_t *mutex, pthread_cond_t *cond, uint64_t now) {
     if (!q) return NULL;
-    while (q->head == NULL) {
+    ttak_task_t *task;
+    while ((task = q_pop(q, now)) == NULL) {
         pthread_cond_wait(cond, mutex);
     }
-    return q_pop(q, now);
+    return task;
 }
 
 /**
  * @brief Return the number of queued tasks.
  *
+ * Exact when the queue is quiescent; approximate under concurrent use.
+ *
  * @param q Queue to inspect.
  * @return Element count.
  */
 static size_t q_get_size(struct __internal_ttak_proc_priority_queue_t *q) {
-    return q ? q->size : 0;
+    return q ? atomic_load_explicit(&q->size, memory_order_relaxed) : 0;
 }
 
 /**
- * @brief Return the configured capacity hint.
+ * @brief Return the queue capacity.
  *
  * @param q Queue to inspect.
- * @return Capacity stored on the queue.
+ * @return Total slots across every band.
  */
 static size_t q_get_cap(struct __internal_ttak_proc_priority_queue_t *q) {
     return q ? q->cap : 0;
@@ -101,12 +215,26 @@ static size_t q_get_cap(struct __internal_ttak_proc_priority_queue_t *q) {
  */
 void ttak_priority_queue_init(struct __internal_ttak_proc_priority_queue_t *q) {
     if (!q) return;
-    q->head = NULL;
-    q->size = 0;
-    q->cap = 0;
+    atomic_init(&q->nonempty, 0);
+    atomic_init(&q->size, 0);
+    for (size_t b = 0; b < TTAK_PQ_BANDS; b++) {
+        atomic_init(&q->bands[b], NULL);
+    }
+    q->cap = (size_t)TTAK_PQ_BANDS * TTAK_PQ_BAND_CAPACITY;
+    q->init = ttak_priority_queue_init;
     q->push = q_push;
     q->pop = q_pop;
     q->pop_blocking = q_pop_blocking;
     q->get_size = q_get_size;
     q->get_cap = q_get_cap;
 }
+
+void ttak_priority_queue_destroy(struct __internal_ttak_proc_priority_queue_t *q) {
+    if (!q) return;
+    for (size_t b = 0; b < TTAK_PQ_BANDS; b++) {
+        __internal_ttak_pq_ring_t *ring = atomic_exchange_explicit(&q->bands[b], NULL, memory_order_acq_rel);
+        if (ring) ttak_dangerous_free(ring);
+    }
+    atomic_store_explicit(&q->nonempty, 0, memory_order_relaxed);
+    atomic_store_explicit(&q->size, 0, memory_order_relaxed);
+}
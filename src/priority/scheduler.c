@@ -2,63 +2,69 @@
  * @file scheduler.c
  * @brief Priority scheduler — task history tracking and EWMA prediction.
  *
- * Maintains per-task execution time history using a sharded hash-map array.
- * The shard for each task is selected deterministically via the same
- * Fibonacci-hashing / Latin-square routing used by the thread pool, so that
- * the same task hash always lands in the same shard.  Each shard has its own
- * mutex, eliminating the single global hot-lock that previously serialised
- * all history reads and writes.
+ * Execution history lives in one fixed-size, open-addressed table keyed by
+ * task hash. Slots are claimed with a single CAS on the key and updated
+ * with plain atomic loads and stores, so recording and lookups never take a
+ * lock or retry. Two workers finishing the same task type at once may lose
+ * one of their samples, which an EWMA tolerates. When a probe window is
+ * full the newest hash evicts one slot in it, bounding memory no matter how
+ * many distinct (func, arg) pairs pass through.
  */
 
 #include <ttak/priority/scheduler.h>
-#include <ttak/mem/mem.h>
-#include <ttak/ht/map.h>
-#include <ttak/timing/timing.h>
-#include <pthread.h>
+#include <stdatomic.h>
 #include <stddef.h>
-#include <string.h>
-#include "../../internal/ttak/shard_map.h"
 
 /* -----------------------------------------------------------------------
- * Sharded history storage
+ * History table
  * ----------------------------------------------------------------------- */
 
-/** One independent segment of the execution-history map. */
+#define SCHED_HISTORY_MASK ((size_t)TTAK_SCHED_HISTORY_SLOTS - 1U)
+
+/** EWMA values carry 8 fractional bits of milliseconds. */
+#define SCHED_EWMA_SHIFT 8
+/** Set once a slot holds its first sample. */
+#define SCHED_EWMA_VALID (UINT64_C(1) << 63)
+
+/** One table slot; a key of 0 marks it free. */
 typedef struct {
-    tt_map_t       *map;
-    pthread_mutex_t lock;
-    _Bool           initialized;
-} ttak_sched_history_shard_t;
-
-static ttak_sched_history_shard_t history_shards[TTAK_POOL_SHARD_COUNT];
-
-/* One-time global initialisation guard */
-static pthread_once_t history_once = PTHREAD_ONCE_INIT;
-
-static void history_shards_init_once(void) {
-    uint64_t now = ttak_get_tick_count();
-    for (size_t s = 0; s < TTAK_POOL_SHARD_COUNT; s++) {
-        pthread_mutex_init(&history_shards[s].lock, NULL);
-        history_shards[s].map = ttak_create_map(32, now);
-        history_shards[s].initialized = (history_shards[s].map != NULL);
-    }
-}
+    _Atomic uint64_t key;
+    _Atomic uint64_t ewma; /**< Fixed-point average | SCHED_EWMA_VALID, or 0. */
+} ttak_sched_history_slot_t;
 
-/* -----------------------------------------------------------------------
- * Internal helpers
- * ----------------------------------------------------------------------- */
+static ttak_sched_history_slot_t history[TTAK_SCHED_HISTORY_SLOTS];
+
+static inline size_t sched_home_slot(uint64_t hash) {
+    /* Fibonacci hashing: task hashes are already mixed, but not always in the low bits. */
+    return (size_t)((hash * 0x9E3779B97F4A7C15ULL) >> 40) & SCHED_HISTORY_MASK;
+}
 
 /**
- * @brief Select the history shard for @p hash using the routing table.
- *
- * Uses ttak_shard_for_hash() so the same hash always maps to the same shard,
- * matching the routing used in ttak_thread_pool_schedule_task().
- *
- * @param hash  Task hash.
- * @return      Pointer to the corresponding history shard.
+ * @brief Returns the slot holding @p hash, claiming or evicting one if
+ *        @p claim is set; NULL when absent and not claiming.
  */
-static inline ttak_sched_history_shard_t *sched_shard_for_hash(uint64_t hash) {
-    return &history_shards[ttak_shard_for_hash(hash)];
+static ttak_sched_history_slot_t *sched_slot(uint64_t hash, _Bool claim) {
+    size_t home = sched_home_slot(hash);
+    for (size_t i = 0; i < TTAK_SCHED_HISTORY_PROBE; i++) {
+        ttak_sched_history_slot_t *slot = &history[(home + i) & SCHED_HISTORY_MASK];
+        uint64_t key = atomic_load_explicit(&slot->key, memory_order_acquire);
+        if (key == hash) return slot;
+        if (key != 0) continue;
+        if (!claim) return NULL; /* Keys are never removed, so the probe ends here. */
+        if (atomic_compare_exchange_strong_explicit(&slot->key, &key, hash,
+                                                    memory_order_acq_rel, memory_order_acquire) ||
+            key == hash) {
+            return slot;
+        }
+    }
+    if (!claim) return NULL;
+
+    /* Window full: evict a victim picked by the hash's upper bits. */
+    ttak_sched_history_slot_t *victim =
+        &history[(home + (size_t)(hash >> 32) % TTAK_SCHED_HISTORY_PROBE) & SCHED_HISTORY_MASK];
+    atomic_store_explicit(&victim->ewma, 0, memory_order_relaxed);
+    atomic_store_explicit(&victim->key, hash, memory_order_release);
+    return victim;
 }
 
 /* -----------------------------------------------------------------------
@@ -66,7 +72,7 @@ static inline ttak_sched_history_shard_t *sched_shard_for_hash(uint64_t hash) {
  * ----------------------------------------------------------------------- */
 
 void ttak_scheduler_init(void) {
-    pthread_once(&history_once, history_shards_init_once);
+    /* The table is statically zeroed; nothing to set up. */
 }
 
 void ttak_scheduler_record_execution(ttak_task_t *task, uint64_t duration_ms) {
@@ -74,19 +80,25 @@ void ttak_scheduler_record_execution(ttak_task_t *task, uint64_t duration_ms) {
     uint64_t hash = ttak_task_get_hash(task);
     if (hash == 0) return;
 
-    uint64_t now = ttak_get_tick_count();
-    ttak_sched_history_shard_t *shard = sched_shard_for_hash(hash);
-    if (!shard->initialized) return;
-
-    pthread_mutex_lock(&shard->lock);
-    size_t old_avg = 0;
-    if (ttak_map_get_key(shard->map, (uintptr_t)hash, &old_avg, now)) {
-        size_t new_avg = (size_t)((old_avg * 0.7) + (duration_ms * 0.3));
-        ttak_insert_to_map(shard->map, (uintptr_t)hash, new_avg, now);
-    } else {
-        ttak_insert_to_map(shard->map, (uintptr_t)hash, (size_t)duration_ms, now);
-    }
-    pthread_mutex_unlock(&shard->lock);
+    ttak_sched_history_slot_t *slot = sched_slot(hash, 1);
+    if (duration_ms > (UINT64_MAX >> (SCHED_EWMA_SHIFT + 2))) duration_ms = UINT64_MAX >> (SCHED_EWMA_SHIFT + 2);
+    uint64_t sample = duration_ms << SCHED_EWMA_SHIFT;
+    uint64_t old = atomic_load_explicit(&slot->ewma, memory_order_relaxed);
+    uint64_t avg = (old & SCHED_EWMA_VALID)
+                 ? ((old & ~SCHED_EWMA_VALID) * 7 + sample * 3) / 10
+                 : sample;
+    atomic_store_explicit(&slot->ewma, avg | SCHED_EWMA_VALID, memory_order_relaxed);
+}
+
+_Bool ttak_scheduler_history_get(uint64_t hash, uint64_t *avg_ms) {
+    if (hash == 0) return 0;
+    ttak_sched_history_slot_t *slot = sched_slot(hash, 0);
+    if (!slot) return 0;
+    uint64_t v = atomic_load_explicit(&slot->ewma, memory_order_relaxed);
+    /* Re-check the key: the slot may have been handed to another hash meanwhile. */
+    if (!(v & SCHED_EWMA_VALID) || atomic_load_explicit(&slot->key, memory_order_acquire) != hash) return 0;
+    if (avg_ms) *avg_ms = (v & ~SCHED_EWMA_VALID) >> SCHED_EWMA_SHIFT;
+    return 1;
 }
 
 int ttak_scheduler_get_adjusted_priority(ttak_task_t *task, int base_priority) {
@@ -95,18 +107,8 @@ int ttak_scheduler_get_adjusted_priority(ttak_task_t *task, int base_priority) {
     if (hash == 0) return base_priority;
 
     int adj_priority = base_priority;
-    uint64_t now = ttak_get_tick_count();
-    size_t avg_runtime = 0;
-    _Bool found = 0;
-
-    ttak_sched_history_shard_t *shard = sched_shard_for_hash(hash);
-    if (shard->initialized) {
-        pthread_mutex_lock(&shard->lock);
-        found = ttak_map_get_key(shard->map, (uintptr_t)hash, &avg_runtime, now);
-        pthread_mutex_unlock(&shard->lock);
-    }
-
-    if (found) {
+    uint64_t avg_runtime = 0;
+    if (ttak_scheduler_history_get(hash, &avg_runtime)) {
         if (avg_runtime < 10) adj_priority += 5;
         else if (avg_runtime < 50) adj_priority += 2;
         else if (avg_runtime > 2000) adj_priority -= 5;
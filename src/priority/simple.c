@@ -1,6 +1,10 @@
 #include <ttak/priority/simple.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/container/pool.h>
+#include <ttak/mem/epoch.h>
 #include <ttak/mem/mem.h>
 #include <stddef.h>
+#include <stdlib.h>
 
 /* Queue Implementation */
 
@@ -197,3 +201,297 @@ void ttak_simple_stack_destroy(ttak_simple_stack_t *s, uint64_t now) {
         ttak_simple_stack_pop(s, now);
     }
 }
+
+/* Concurrent Queue and Stack */
+
+/* Pause rounds a pusher waits in an elimination slot for a popper. */
+#define MPMC_ELIM_SPINS 64
+
+/**
+ * @brief Node pool plus a count of its users: the container, and every
+ *        node sitting in an EBR batch. The last one out frees it.
+ */
+struct ttak_simple_mpmc_pool {
+    ttak_object_pool_t *objects;
+    _Atomic size_t refs;
+};
+
+static ttak_simple_mpmc_pool_t *mpmc_pool_create(void) {
+    ttak_simple_mpmc_pool_t *pool = (ttak_simple_mpmc_pool_t *)malloc(sizeof(*pool));
+    if (!pool) return NULL;
+    pool->objects = ttak_object_pool_create(256, sizeof(ttak_simple_mpmc_node_t));
+    if (!pool->objects) {
+        free(pool);
+        return NULL;
+    }
+    atomic_init(&pool->refs, 1);
+    return pool;
+}
+
+static void mpmc_pool_release(ttak_simple_mpmc_pool_t *pool) {
+    if (atomic_fetch_sub_explicit(&pool->refs, 1, memory_order_acq_rel) == 1) {
+        ttak_object_pool_destroy(pool->objects);
+        free(pool);
+    }
+}
+
+static ttak_simple_mpmc_node_t *mpmc_node_new(ttak_simple_mpmc_pool_t *pool, void *data) {
+    ttak_simple_mpmc_node_t *node = (ttak_simple_mpmc_node_t *)ttak_object_pool_alloc(pool->objects);
+    if (!node) return NULL;
+    node->data = data;
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    node->owner = pool;
+    return node;
+}
+
+/* EBR cleanup: the node is unreachable, so it can go back to its pool. */
+static void mpmc_node_recycle(void *ptr) {
+    ttak_simple_mpmc_node_t *node = (ttak_simple_mpmc_node_t *)ptr;
+    ttak_simple_mpmc_pool_t *pool = node->owner;
+    ttak_object_pool_free(pool->objects, node);
+    mpmc_pool_release(pool);
+}
+
+/* Hands a node other threads may still be reading to EBR. */
+static void mpmc_node_retire(ttak_simple_mpmc_node_t *node) {
+    atomic_fetch_add_explicit(&node->owner->refs, 1, memory_order_relaxed);
+    ttak_epoch_retire(node, mpmc_node_recycle);
+}
+
+/**
+ * @brief Initialize a Michael-Scott queue with its dummy node.
+ *
+ * @param q Queue to initialize.
+ * @return False on allocation failure.
+ */
+bool ttak_simple_mpmc_queue_init(ttak_simple_mpmc_queue_t *q) {
+    if (!q) return false;
+    q->pool = mpmc_pool_create();
+    ttak_simple_mpmc_node_t *dummy = q->pool ? mpmc_node_new(q->pool, NULL) : NULL;
+    if (!dummy) {
+        if (q->pool) mpmc_pool_release(q->pool);
+        q->pool = NULL;
+        return false;
+    }
+    atomic_init(&q->head, dummy);
+    atomic_init(&q->tail, dummy);
+    atomic_init(&q->size, 0);
+    return true;
+}
+
+/**
+ * @brief Link a node after the tail, helping a lagging tail forward.
+ *
+ * @param q    Queue to update.
+ * @param data Data pointer to store.
+ * @return False if no node could be allocated.
+ */
+bool ttak_simple_mpmc_queue_push(ttak_simple_mpmc_queue_t *q, void *data) {
+    if (!q || !q->pool) return false;
+    ttak_simple_mpmc_node_t *node = mpmc_node_new(q->pool, data);
+    if (!node) return false;
+
+    ttak_epoch_enter();
+    for (;;) {
+        ttak_simple_mpmc_node_t *tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+        ttak_simple_mpmc_node_t *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+        if (tail != atomic_load_explicit(&q->tail, memory_order_acquire)) continue;
+        if (next) {
+            atomic_compare_exchange_weak(&q->tail, &tail, next);
+            continue;
+        }
+        if (atomic_compare_exchange_weak(&tail->next, &next, node)) {
+            atomic_compare_exchange_strong(&q->tail, &tail, node);
+            break;
+        }
+    }
+    ttak_epoch_exit();
+    atomic_fetch_add_explicit(&q->size, 1, memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Swing the head to its successor, which becomes the new dummy.
+ *
+ * @param q   Queue to update.
+ * @param out Receives the dequeued pointer; may be NULL.
+ * @return False when empty.
+ */
+bool ttak_simple_mpmc_queue_pop(ttak_simple_mpmc_queue_t *q, void **out) {
+    if (!q || !q->pool) return false;
+    ttak_epoch_enter();
+    for (;;) {
+        ttak_simple_mpmc_node_t *head = atomic_load_explicit(&q->head, memory_order_acquire);
+        ttak_simple_mpmc_node_t *tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+        ttak_simple_mpmc_node_t *next = atomic_load_explicit(&head->next, memory_order_acquire);
+        if (head != atomic_load_explicit(&q->head, memory_order_acquire)) continue;
+        if (!next) {
+            ttak_epoch_exit();
+            return false;
+        }
+        if (head == tail) {
+            atomic_compare_exchange_weak(&q->tail, &tail, next);
+            continue;
+        }
+        // Read before the CAS: once head moves, another pop may retire next.
+        void *data = next->data;
+        if (atomic_compare_exchange_weak(&q->head, &head, next)) {
+            mpmc_node_retire(head);
+            ttak_epoch_exit();
+            atomic_fetch_sub_explicit(&q->size, 1, memory_order_relaxed);
+            if (out) *out = data;
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Return the approximate element count.
+ */
+size_t ttak_simple_mpmc_queue_size(ttak_simple_mpmc_queue_t *q) {
+    return q ? atomic_load_explicit(&q->size, memory_order_relaxed) : 0;
+}
+
+/**
+ * @brief Free every node and drop the queue's hold on its pool.
+ *
+ * @param q Queue to destroy.
+ */
+void ttak_simple_mpmc_queue_destroy(ttak_simple_mpmc_queue_t *q) {
+    if (!q || !q->pool) return;
+    ttak_simple_mpmc_node_t *node = atomic_load_explicit(&q->head, memory_order_relaxed);
+    while (node) {
+        ttak_simple_mpmc_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        ttak_object_pool_free(q->pool->objects, node);
+        node = next;
+    }
+    mpmc_pool_release(q->pool);
+    q->pool = NULL;
+    atomic_store_explicit(&q->head, NULL, memory_order_relaxed);
+    atomic_store_explicit(&q->tail, NULL, memory_order_relaxed);
+}
+
+/* Elimination slot picked by a per-thread xorshift. */
+static _Atomic(ttak_simple_mpmc_node_t *) *mpmc_elim_slot(ttak_simple_mpmc_stack_t *s) {
+    static _Thread_local uint32_t state;
+    if (!state) state = (uint32_t)(uintptr_t)&state | 1u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return &s->elim[state % TTAK_SIMPLE_ELIM_SLOTS];
+}
+
+/**
+ * @brief Initialize an empty Treiber stack.
+ *
+ * @param s Stack to initialize.
+ * @return False on allocation failure.
+ */
+bool ttak_simple_mpmc_stack_init(ttak_simple_mpmc_stack_t *s) {
+    if (!s) return false;
+    atomic_init(&s->top, NULL);
+    for (int i = 0; i < TTAK_SIMPLE_ELIM_SLOTS; i++) atomic_init(&s->elim[i], NULL);
+    atomic_init(&s->size, 0);
+    s->pool = mpmc_pool_create();
+    return s->pool != NULL;
+}
+
+/**
+ * @brief Push, falling back to an elimination slot when @c top is contended.
+ *
+ * @param s    Stack to update.
+ * @param data Data pointer to store.
+ * @return False if no node could be allocated.
+ */
+bool ttak_simple_mpmc_stack_push(ttak_simple_mpmc_stack_t *s, void *data) {
+    if (!s || !s->pool) return false;
+    ttak_simple_mpmc_node_t *node = mpmc_node_new(s->pool, data);
+    if (!node) return false;
+
+    // Pinned so an offered node cannot be recycled and re-offered at the
+    // same address while we still compare the slot against it.
+    ttak_epoch_enter();
+    for (;;) {
+        ttak_simple_mpmc_node_t *top = atomic_load_explicit(&s->top, memory_order_relaxed);
+        atomic_store_explicit(&node->next, top, memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(&s->top, &top, node, memory_order_release,
+                                                  memory_order_relaxed)) {
+            break;
+        }
+        _Atomic(ttak_simple_mpmc_node_t *) *slot = mpmc_elim_slot(s);
+        ttak_simple_mpmc_node_t *empty = NULL;
+        if (!atomic_compare_exchange_strong(slot, &empty, node)) continue;
+        for (int i = 0; i < MPMC_ELIM_SPINS && atomic_load_explicit(slot, memory_order_acquire) == node; i++) {
+            ttak_arch_pause();
+        }
+        ttak_simple_mpmc_node_t *mine = node;
+        // Taking the offer back failing means a pop consumed it.
+        if (!atomic_compare_exchange_strong(slot, &mine, NULL)) break;
+    }
+    ttak_epoch_exit();
+    atomic_fetch_add_explicit(&s->size, 1, memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Pop, falling back to taking a waiting push's offer when contended.
+ *
+ * @param s   Stack to update.
+ * @param out Receives the popped pointer; may be NULL.
+ * @return False when empty.
+ */
+bool ttak_simple_mpmc_stack_pop(ttak_simple_mpmc_stack_t *s, void **out) {
+    if (!s || !s->pool) return false;
+    ttak_simple_mpmc_node_t *taken = NULL;
+    ttak_epoch_enter();
+    for (;;) {
+        ttak_simple_mpmc_node_t *top = atomic_load_explicit(&s->top, memory_order_acquire);
+        if (!top) break;
+        // The pin keeps top from being recycled, so its next is current and no ABA can occur.
+        ttak_simple_mpmc_node_t *next = atomic_load_explicit(&top->next, memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(&s->top, &top, next, memory_order_acquire,
+                                                  memory_order_relaxed)) {
+            taken = top;
+            break;
+        }
+        _Atomic(ttak_simple_mpmc_node_t *) *slot = mpmc_elim_slot(s);
+        ttak_simple_mpmc_node_t *offer = atomic_load_explicit(slot, memory_order_acquire);
+        if (offer && atomic_compare_exchange_strong(slot, &offer, NULL)) {
+            taken = offer;
+            break;
+        }
+    }
+    if (taken) {
+        if (out) *out = taken->data;
+        mpmc_node_retire(taken);
+    }
+    ttak_epoch_exit();
+    if (!taken) return false;
+    atomic_fetch_sub_explicit(&s->size, 1, memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Return the approximate element count.
+ */
+size_t ttak_simple_mpmc_stack_size(ttak_simple_mpmc_stack_t *s) {
+    return s ? atomic_load_explicit(&s->size, memory_order_relaxed) : 0;
+}
+
+/**
+ * @brief Free every node and drop the stack's hold on its pool.
+ *
+ * @param s Stack to destroy.
+ */
+void ttak_simple_mpmc_stack_destroy(ttak_simple_mpmc_stack_t *s) {
+    if (!s || !s->pool) return;
+    ttak_simple_mpmc_node_t *node = atomic_load_explicit(&s->top, memory_order_relaxed);
+    while (node) {
+        ttak_simple_mpmc_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        ttak_object_pool_free(s->pool->objects, node);
+        node = next;
+    }
+    mpmc_pool_release(s->pool);
+    s->pool = NULL;
+    atomic_store_explicit(&s->top, NULL, memory_order_relaxed);
+}
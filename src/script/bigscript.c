@@ -1,11 +1,21 @@
 /**
  * @file bigscript.c
- * @brief BigScript interpreter — lexer, parser, and evaluator.
+ * @brief BigScript interpreter — lexer, compiler, and register VM.
  *
  * BigScript is a minimal scripting language for LibTTAK that operates on
  * arbitrary-precision numeric types (ttak_bigint_t, ttak_bigreal_t,
- * ttak_bigcomplex_t).  Scripts are compiled to an AST and interpreted
- * in a single pass.
+ * ttak_bigcomplex_t).  Scripts are compiled in a single pass to register
+ * bytecode: each function owns a window of VM registers holding its locals
+ * followed by expression temporaries, and instructions name their operands
+ * directly, so reading a variable or a literal copies nothing.  The compiler
+ * folds integer constant expressions, resolves constant conditions and fuses
+ * a comparison feeding a branch into one compare-and-jump.  The evaluator
+ * dispatches through a label table under GCC and Clang and a switch
+ * elsewhere; results move between registers instead of being deep-copied.
+ * Batch evaluation first runs each seed through a 64-bit interpreter of the
+ * same bytecode and only hands seeds whose values leave that range to the
+ * bigint VM.  Compiled programs can be shared through a process-wide cache
+ * keyed by source hash, optionally backed by bytecode files on disk.
  */
 
 #include <ttak/script/bigscript.h>
@@ -13,41 +23,82 @@
 #include <ttak/math/bigint.h>
 #include <ttak/math/sum_divisors.h>
 #include <ttak/security/sha256.h>
+#include <ttak/mem/epoch.h>
+#include "../../internal/ttak/factor_internal.h"
+#include <stdatomic.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <pthread.h>
 
 #define MAX_CONSTANTS 1024
 #define MAX_CODE 16384
 #define MAX_LOCALS 256
 #define MAX_FUNCTIONS 64
+#define MAX_REGS 256      /* Registers in one frame: locals, then temporaries. */
+#define MAX_BUILTIN_ARGS 2
+#define VM_REGS 1024      /* Register file shared by all active frames. */
+#define VM_FRAMES 256
 
+/* Operand words name a frame register, or a constant when this bit is set. */
+#define OPND_CONST 0x80000000u
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(TTAK_BIGSCRIPT_SWITCH_DISPATCH)
+#define BIGSCRIPT_THREADED 1
+#endif
+
+/* Hot programs are translated to native code on x86-64; TTAK_BIGSCRIPT_NO_JIT keeps them interpreted. */
+#if defined(__x86_64__) && defined(__unix__) && !defined(TTAK_BIGSCRIPT_NO_JIT)
+#define BIGSCRIPT_JIT 1
+#include <sys/mman.h>
+#endif
+
+/*
+ * Instruction layouts (one word each):
+ *   MOVE d s | ADD..GE d a b | JMP t | JMP_IF_FALSE c t | JCMP mask a b t |
+ *   RETURN s | CALL fn base | CALL_BUILTIN bi argc d args...
+ * JCMP jumps unless the sign of cmp(a, b) is in mask (bit 0 less, bit 1
+ * equal, bit 2 greater).  CALL runs fn with its frame starting at register
+ * base, where the arguments were placed; the result comes back in base.
+ */
 typedef enum {
-    OP_HALT = 0, OP_PUSH_CONST, OP_LOAD_LOCAL, OP_STORE_LOCAL,
+    OP_HALT = 0, OP_MOVE,
     OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD,
     OP_EQ, OP_NEQ, OP_LT, OP_LE, OP_GT, OP_GE,
-    OP_AND, OP_OR, OP_NOT,
-    OP_JMP, OP_JMP_IF_FALSE, OP_RETURN,
-    OP_CALL, OP_CALL_BUILTIN, OP_POP
+    OP_JMP, OP_JMP_IF_FALSE, OP_JCMP, OP_RETURN,
+    OP_CALL, OP_CALL_BUILTIN
 } opcode_t;
 
+#define OP_COUNT (OP_CALL_BUILTIN + 1)
+
 typedef struct { ttak_bigscript_variant_t value; } constant_t;
-typedef struct { uint32_t start_ip; uint32_t arity; uint32_t locals_count; char name[64]; } function_t;
+typedef struct { uint32_t start_ip; uint32_t arity; uint32_t locals_count; uint32_t frame_size; char name[64]; } function_t;
 
 struct ttak_bigscript_program_t {
     uint32_t code[MAX_CODE]; uint32_t code_len;
     constant_t constants[MAX_CONSTANTS]; uint32_t constants_len;
     function_t functions[MAX_FUNCTIONS]; uint32_t functions_len;
+    int32_t main_fn;
     ttak_bigscript_limits_t limits;
+    uint64_t const_u64[MAX_CONSTANTS];   /* Value of each constant that is a non-negative 64-bit integer. */
+    uint8_t const_small[MAX_CONSTANTS];  /* Non-zero where const_u64 holds the constant exactly. */
+    _Atomic uint32_t refs;               /* Owners: the compiler's caller, plus the program cache and its users. */
+    _Atomic int jit_state;               /* JIT_COLD until translated, then JIT_READY or JIT_NONE. */
+    _Atomic size_t hot;                  /* Seeds evaluated while cold. */
+    void *jit_entry;                     /* Native main, published by jit_state. */
+    void *jit_code; size_t jit_size;
     char source_sha256[65];
 };
 
+typedef struct { uint32_t ret_ip; uint32_t base; } frame_t;
+
 struct ttak_bigscript_vm_t {
     ttak_bigscript_limits_t limits;
-    ttak_bigscript_variant_t *stack; uint32_t stack_cap; uint32_t stack_top;
-    ttak_bigscript_variant_t *locals; uint32_t locals_cap; uint32_t locals_top;
-    uint32_t call_depth; uint32_t steps; uint64_t now;
+    ttak_bigscript_variant_t *regs; uint32_t regs_cap;
+    ttak_bigscript_variant_t scratch;
+    uint64_t *wregs;   /* Word registers for native code, allocated on first use. */
+    frame_t frames[VM_FRAMES];
 };
 
 static void variant_init(ttak_bigscript_variant_t *v, uint64_t now) {
@@ -65,9 +116,32 @@ static void variant_free(ttak_bigscript_variant_t *v, uint64_t now) {
     v->type = TTAK_BIGSCRIPT_VAL_INT;
 }
 
+/* Frees @p v and leaves it holding a zero of @p type. */
+static void variant_reset(ttak_bigscript_variant_t *v, ttak_bigscript_val_type_t type, uint64_t now) {
+    variant_free(v, now);
+    v->type = type;
+    if (type == TTAK_BIGSCRIPT_VAL_INT) ttak_bigint_init(&v->v.i, now);
+    else if (type == TTAK_BIGSCRIPT_VAL_REAL) ttak_bigreal_init(&v->v.r, now);
+    else ttak_bigcomplex_init(&v->v.c, now);
+}
+
+/* Integer view of @p v, keeping its limbs when it already holds an integer. */
+static inline ttak_bigint_t *variant_as_int(ttak_bigscript_variant_t *v, uint64_t now) {
+    if (v->type != TTAK_BIGSCRIPT_VAL_INT) variant_reset(v, TTAK_BIGSCRIPT_VAL_INT, now);
+    return &v->v.i;
+}
+
+/* Moves without copying limbs; bigints hold no pointers into themselves. */
+static inline void variant_swap(ttak_bigscript_variant_t *a, ttak_bigscript_variant_t *b) {
+    ttak_bigscript_variant_t t = *a; *a = *b; *b = t;
+}
+
 static bool variant_copy(ttak_bigscript_variant_t *dst, const ttak_bigscript_variant_t *src, uint64_t now) {
     if (!dst || !src) return false;
     if (dst == src) return true;
+    if (dst->type == TTAK_BIGSCRIPT_VAL_INT && src->type == TTAK_BIGSCRIPT_VAL_INT) {
+        return ttak_bigint_copy(&dst->v.i, &src->v.i, now);
+    }
     variant_free(dst, now);
     dst->type = src->type;
     if (src->type == TTAK_BIGSCRIPT_VAL_INT) {
@@ -83,13 +157,6 @@ static bool variant_copy(ttak_bigscript_variant_t *dst, const ttak_bigscript_var
     return false;
 }
 
-static void variant_set_int_u64(ttak_bigscript_variant_t *v, uint64_t val, uint64_t now) {
-    if (!v) return;
-    variant_free(v, now);
-    v->type = TTAK_BIGSCRIPT_VAL_INT;
-    ttak_bigint_init_u64(&v->v.i, val, now);
-}
-
 typedef enum { BLT_S = 0, BLT_IS_ZERO, BLT_REAL, BLT_COMPLEX } builtin_idx_t;
 static const char *BUILTIN_NAMES[] = { "s", "is_zero", "real", "complex" };
 
@@ -146,14 +213,26 @@ skip:
 }
 
 typedef struct { char name[64]; int depth; int local_idx; } local_var_t;
-typedef struct { lexer_t *lex; token_t curr; token_t peek; ttak_bigscript_program_t *prog; ttak_bigscript_error_t *err; local_var_t locals[MAX_LOCALS]; int local_count; int scope_depth; uint64_t now; } parser_t;
+typedef struct {
+    lexer_t *lex; token_t curr; token_t peek; ttak_bigscript_program_t *prog; ttak_bigscript_error_t *err;
+    local_var_t locals[MAX_LOCALS]; int local_count; int scope_depth; uint64_t now;
+    uint32_t temp_top;   /* First free register of the current function. */
+    uint32_t frame_size; /* Registers the current function needs. */
+    uint32_t last_ip;    /* Start of the last instruction, for the peephole pass. */
+} parser_t;
+
+#define NO_IP UINT32_MAX
 
 static void advance(parser_t *p) { p->curr = p->peek; p->peek = next_token(p->lex); }
 static bool match(parser_t *p, token_type_t t) { if (p->curr.type == t) { advance(p); return true; } return false; }
 static void consume(parser_t *p, token_type_t t, const char *msg) { if (p->curr.type == t) { advance(p); } else { set_err(p->err, TTAK_BIGSCRIPT_ERR_SYNTAX, msg); } }
-static void emit(parser_t *p, uint32_t op) { if (p->prog->code_len < MAX_CODE) { p->prog->code[p->prog->code_len++] = op; } }
+static void emit(parser_t *p, uint32_t w) {
+    if (p->prog->code_len < MAX_CODE) { p->prog->code[p->prog->code_len++] = w; }
+    else { set_err(p->err, TTAK_BIGSCRIPT_ERR_LIMIT, "Program too large"); }
+}
+static void emit_op(parser_t *p, opcode_t op) { p->last_ip = p->prog->code_len; emit(p, (uint32_t)op); }
 
-static void parse_expression(parser_t *p);
+static uint32_t parse_expression(parser_t *p);
 static void parse_statement(parser_t *p);
 static void parse_block(parser_t *p);
 
@@ -162,7 +241,138 @@ static int resolve_local(parser_t *p, token_t *name) {
     return -1;
 }
 
-static void parse_primary(parser_t *p) {
+static bool is_temp(const parser_t *p, uint32_t o) { return !(o & OPND_CONST) && o >= (uint32_t)p->local_count; }
+
+static void note_regs(parser_t *p, uint32_t n) { if (n > p->frame_size) { p->frame_size = n; } }
+
+static uint32_t alloc_reg(parser_t *p) {
+    if (p->temp_top >= MAX_REGS) { set_err(p->err, TTAK_BIGSCRIPT_ERR_LIMIT, "Expression too deep"); return 0; }
+    uint32_t r = p->temp_top++; note_regs(p, p->temp_top); return r;
+}
+
+/* Temporaries are released in reverse order of allocation. */
+static void release(parser_t *p, uint32_t o) { if (is_temp(p, o) && o + 1 == p->temp_top) { p->temp_top--; } }
+
+/* Takes ownership of @p v. */
+static uint32_t add_constant(parser_t *p, ttak_bigscript_variant_t *v) {
+    ttak_bigscript_program_t *prog = p->prog;
+    if (prog->constants_len >= MAX_CONSTANTS) {
+        set_err(p->err, TTAK_BIGSCRIPT_ERR_LIMIT, "Too many constants"); variant_free(v, p->now); return OPND_CONST;
+    }
+    prog->constants[prog->constants_len].value = *v;
+    return OPND_CONST | prog->constants_len++;
+}
+
+static uint32_t add_constant_u64(parser_t *p, uint64_t val) {
+    ttak_bigscript_variant_t v; variant_init(&v, p->now); ttak_bigint_set_u64(&v.v.i, val, p->now);
+    return add_constant(p, &v);
+}
+
+static const ttak_bigint_t *const_int(const parser_t *p, uint32_t o) {
+    if (!(o & OPND_CONST) || p->err->code != TTAK_BIGSCRIPT_ERR_NONE) { return NULL; }
+    const ttak_bigscript_variant_t *v = &p->prog->constants[o & ~OPND_CONST].value;
+    return v->type == TTAK_BIGSCRIPT_VAL_INT ? &v->v.i : NULL;
+}
+
+/* Drops a folded operand when it is the newest constant, so folding a chain keeps one entry. */
+static void drop_constant(parser_t *p, uint32_t o) {
+    ttak_bigscript_program_t *prog = p->prog;
+    if ((o & OPND_CONST) && prog->constants_len > 0 && (o & ~OPND_CONST) == prog->constants_len - 1) {
+        variant_free(&prog->constants[--prog->constants_len].value, p->now);
+    }
+}
+
+/* Comparison outcomes accepted by a relational opcode: bit 0 less, bit 1 equal, bit 2 greater. */
+static uint32_t cmp_mask(uint32_t op) {
+    if (op == OP_EQ) return 2u;
+    if (op == OP_NEQ) return 5u;
+    if (op == OP_LT) return 1u;
+    if (op == OP_LE) return 3u;
+    if (op == OP_GT) return 4u;
+    return 6u;
+}
+
+static inline bool cmp_holds(uint32_t mask, int c) { return (mask >> ((c > 0) - (c < 0) + 1)) & 1u; }
+
+/* Integer semantics shared by constant folding; false leaves the operation to run time. */
+static bool fold_int(uint32_t op, ttak_bigint_t *r, const ttak_bigint_t *a, const ttak_bigint_t *b, uint64_t now) {
+    if (op == OP_ADD) return ttak_bigint_add(r, a, b, now);
+    if (op == OP_SUB) return ttak_bigint_sub(r, a, b, now);
+    if (op == OP_MUL) return ttak_bigint_mul(r, a, b, now);
+    if (op == OP_DIV || op == OP_MOD) {
+        if (ttak_bigint_is_zero(b)) return false;
+        if (op == OP_MOD) return ttak_bigint_mod(r, a, b, now);
+        ttak_bigint_t rem; ttak_bigint_init(&rem, now);
+        bool ok = ttak_bigint_div(r, &rem, a, b, now);
+        ttak_bigint_free(&rem, now); return ok;
+    }
+    return ttak_bigint_set_u64(r, cmp_holds(cmp_mask(op), ttak_bigint_cmp(a, b)) ? 1 : 0, now);
+}
+
+static uint32_t emit_binary(parser_t *p, opcode_t op, uint32_t a, uint32_t b) {
+    const ttak_bigint_t *ka = const_int(p, a), *kb = const_int(p, b);
+    if (ka && kb) {
+        ttak_bigscript_variant_t r; variant_init(&r, p->now);
+        if (fold_int(op, &r.v.i, ka, kb, p->now)) { drop_constant(p, b); drop_constant(p, a); return add_constant(p, &r); }
+        variant_free(&r, p->now);
+    }
+    release(p, b); release(p, a);
+    uint32_t d = alloc_reg(p);
+    emit_op(p, op); emit(p, d); emit(p, a); emit(p, b);
+    return d;
+}
+
+static void emit_move(parser_t *p, uint32_t d, uint32_t s) { if (d != s) { emit_op(p, OP_MOVE); emit(p, d); emit(p, s); } }
+
+/* Emits a branch taken when @p c is false and returns the word holding its target. */
+static uint32_t emit_branch_unless(parser_t *p, uint32_t c) {
+    uint32_t *code = p->prog->code; uint32_t at = p->last_ip;
+    if (is_temp(p, c) && at != NO_IP && at + 4 == p->prog->code_len && code[at] >= OP_EQ && code[at] <= OP_GE && code[at + 1] == c) {
+        uint32_t mask = cmp_mask(code[at]), a = code[at + 2], b = code[at + 3];
+        p->prog->code_len = at;
+        emit_op(p, OP_JCMP); emit(p, mask); emit(p, a); emit(p, b);
+    } else {
+        emit_op(p, OP_JMP_IF_FALSE); emit(p, c);
+    }
+    release(p, c);
+    emit(p, 0); return p->prog->code_len - 1;
+}
+
+static uint32_t parse_call(parser_t *p, token_t name) {
+    char nbuf[64] = {0}; size_t nl = name.length < 63 ? name.length : 63; memcpy(nbuf, name.start, nl); nbuf[nl] = '\0';
+    int bi = -1; for (int i = 0; i < 4; i++) { if (strcmp(nbuf, BUILTIN_NAMES[i]) == 0) { bi = i; break; } }
+    if (bi >= 0) {
+        uint32_t args[MAX_BUILTIN_ARGS]; uint32_t argc = 0;
+        if (p->curr.type != TOK_RPAREN) { do { uint32_t o = parse_expression(p); if (argc < MAX_BUILTIN_ARGS) { args[argc] = o; } argc++; } while (match(p, TOK_COMMA)); }
+        consume(p, TOK_RPAREN, "Expected ')'");
+        uint32_t max_args = (bi == BLT_COMPLEX) ? 2 : 1;
+        if (argc < 1 || argc > max_args) { set_err(p->err, TTAK_BIGSCRIPT_ERR_SYNTAX, "Wrong builtin arity"); return 0; }
+        for (uint32_t i = argc; i-- > 0;) { release(p, args[i]); }
+        uint32_t d = alloc_reg(p);
+        emit_op(p, OP_CALL_BUILTIN); emit(p, (uint32_t)bi); emit(p, argc); emit(p, d);
+        for (uint32_t i = 0; i < argc; i++) { emit(p, args[i]); }
+        return d;
+    }
+    int fi = -1; for (uint32_t i = 0; i < p->prog->functions_len; i++) { if (strcmp(p->prog->functions[i].name, nbuf) == 0) { fi = (int)i; break; } }
+    /* Arguments go to consecutive registers, which become the callee's first locals. */
+    uint32_t base = p->temp_top, argc = 0;
+    if (p->curr.type != TOK_RPAREN) {
+        do {
+            uint32_t o = parse_expression(p);
+            if (!is_temp(p, o)) { emit_move(p, alloc_reg(p), o); }
+            argc++;
+        } while (match(p, TOK_COMMA));
+    }
+    consume(p, TOK_RPAREN, "Expected ')'");
+    if (fi < 0) { set_err(p->err, TTAK_BIGSCRIPT_ERR_SYNTAX, "Undefined fn"); return 0; }
+    if (argc != p->prog->functions[fi].arity) { set_err(p->err, TTAK_BIGSCRIPT_ERR_SYNTAX, "Wrong argument count"); return 0; }
+    p->temp_top = base;
+    uint32_t d = alloc_reg(p);
+    emit_op(p, OP_CALL); emit(p, (uint32_t)fi); emit(p, base);
+    return d;
+}
+
+static uint32_t parse_primary(parser_t *p) {
     if (p->curr.type == TOK_INT) {
         token_t tok = p->curr; advance(p);
         ttak_bigint_t val; ttak_bigint_init_u64(&val, 0, p->now);
@@ -174,68 +384,82 @@ static void parse_primary(parser_t *p) {
                 ttak_bigint_free(&t1, p->now); ttak_bigint_free(&t2, p->now);
             }
         }
-        variant_init(&p->prog->constants[p->prog->constants_len].value, p->now);
-        ttak_bigint_copy(&p->prog->constants[p->prog->constants_len].value.v.i, &val, p->now);
+        ttak_bigscript_variant_t v; variant_init(&v, p->now);
+        ttak_bigint_copy(&v.v.i, &val, p->now);
         ttak_bigint_free(&val, p->now);
-        emit(p, OP_PUSH_CONST); emit(p, p->prog->constants_len++);
+        return add_constant(p, &v);
     } else if (p->curr.type == TOK_IDENT) {
         token_t name = p->curr; advance(p);
-        if (match(p, TOK_LPAREN)) {
-            int argc = 0; if (p->curr.type != TOK_RPAREN) { do { parse_expression(p); argc++; } while (match(p, TOK_COMMA)); }
-            consume(p, TOK_RPAREN, "Expected ')'");
-            char nbuf[64] = {0}; size_t nl = name.length < 63 ? name.length : 63; memcpy(nbuf, name.start, nl); nbuf[nl] = '\0';
-            int bi = -1; for (int i = 0; i < 4; i++) { if (strcmp(nbuf, BUILTIN_NAMES[i]) == 0) { bi = i; break; } }
-            if (bi >= 0) { emit(p, OP_CALL_BUILTIN); emit(p, (uint32_t)bi); emit(p, (uint32_t)argc); }
-            else {
-                int fi = -1; for (uint32_t i = 0; i < p->prog->functions_len; i++) { if (strcmp(p->prog->functions[i].name, nbuf) == 0) { fi = (int)i; break; } }
-                if (fi >= 0) { emit(p, OP_CALL); emit(p, (uint32_t)fi); emit(p, (uint32_t)argc); }
-                else { set_err(p->err, TTAK_BIGSCRIPT_ERR_SYNTAX, "Undefined fn"); }
-            }
-        } else { int l = resolve_local(p, &name); if (l >= 0) { emit(p, OP_LOAD_LOCAL); emit(p, (uint32_t)l); } else { set_err(p->err, TTAK_BIGSCRIPT_ERR_SYNTAX, "Undefined var"); } }
-    } else if (match(p, TOK_LPAREN)) { parse_expression(p); consume(p, TOK_RPAREN, "Expected ')'"); }
+        if (match(p, TOK_LPAREN)) { return parse_call(p, name); }
+        int l = resolve_local(p, &name); if (l >= 0) { return (uint32_t)l; }
+        set_err(p->err, TTAK_BIGSCRIPT_ERR_SYNTAX, "Undefined var");
+    } else if (match(p, TOK_LPAREN)) { uint32_t o = parse_expression(p); consume(p, TOK_RPAREN, "Expected ')'"); return o; }
+    else { set_err(p->err, TTAK_BIGSCRIPT_ERR_SYNTAX, "Expected expression"); }
+    return 0;
 }
 
-static void parse_unary(parser_t *p) { parse_primary(p); }
-static void parse_term(parser_t *p) { 
-    parse_unary(p); 
-    while (p->curr.type == TOK_STAR || p->curr.type == TOK_SLASH) { 
-        token_type_t op = p->curr.type; advance(p); parse_unary(p); 
-        emit(p, (op == TOK_STAR) ? OP_MUL : OP_DIV); 
+static uint32_t parse_unary(parser_t *p) { return parse_primary(p); }
+static uint32_t parse_term(parser_t *p) { 
+    uint32_t a = parse_unary(p); 
+    while (p->curr.type == TOK_STAR || p->curr.type == TOK_SLASH || p->curr.type == TOK_PERCENT) { 
+        token_type_t op = p->curr.type; advance(p); uint32_t b = parse_unary(p); 
+        a = emit_binary(p, (op == TOK_STAR) ? OP_MUL : (op == TOK_SLASH) ? OP_DIV : OP_MOD, a, b); 
     } 
+    return a;
 }
-static void parse_arith(parser_t *p) { 
-    parse_term(p); 
+static uint32_t parse_arith(parser_t *p) { 
+    uint32_t a = parse_term(p); 
     while (p->curr.type == TOK_PLUS || p->curr.type == TOK_MINUS) { 
-        token_type_t op = p->curr.type; advance(p); parse_term(p); 
-        emit(p, (op == TOK_PLUS) ? OP_ADD : OP_SUB); 
+        token_type_t op = p->curr.type; advance(p); uint32_t b = parse_term(p); 
+        a = emit_binary(p, (op == TOK_PLUS) ? OP_ADD : OP_SUB, a, b); 
     } 
+    return a;
 }
-static void parse_comparison(parser_t *p) { 
-    parse_arith(p); 
+static uint32_t parse_comparison(parser_t *p) { 
+    uint32_t a = parse_arith(p); 
     while (p->curr.type == TOK_LT || p->curr.type == TOK_GT || p->curr.type == TOK_LE || p->curr.type == TOK_GE) { 
-        token_type_t op = p->curr.type; advance(p); parse_arith(p); 
-        if (op == TOK_LT) { emit(p, OP_LT); } else if (op == TOK_GT) { emit(p, OP_GT); } else if (op == TOK_LE) { emit(p, OP_LE); } else { emit(p, OP_GE); }
+        token_type_t op = p->curr.type; advance(p); uint32_t b = parse_arith(p); 
+        a = emit_binary(p, (op == TOK_LT) ? OP_LT : (op == TOK_GT) ? OP_GT : (op == TOK_LE) ? OP_LE : OP_GE, a, b);
     } 
+    return a;
 }
-static void parse_equality(parser_t *p) { 
-    parse_comparison(p); 
+static uint32_t parse_equality(parser_t *p) { 
+    uint32_t a = parse_comparison(p); 
     while (p->curr.type == TOK_EQ_EQ || p->curr.type == TOK_BANG_EQ) { 
-        token_type_t op = p->curr.type; advance(p); parse_comparison(p); 
-        emit(p, (op == TOK_EQ_EQ) ? OP_EQ : OP_NEQ); 
+        token_type_t op = p->curr.type; advance(p); uint32_t b = parse_comparison(p); 
+        a = emit_binary(p, (op == TOK_EQ_EQ) ? OP_EQ : OP_NEQ, a, b); 
     } 
+    return a;
+}
+static uint32_t parse_expression(parser_t *p) { return parse_equality(p); }
+
+static local_var_t *declare_local(parser_t *p, token_t name) {
+    if (p->local_count >= MAX_LOCALS) { set_err(p->err, TTAK_BIGSCRIPT_ERR_LIMIT, "Too many locals"); return NULL; }
+    local_var_t *l = &p->locals[p->local_count++]; size_t nl = name.length < 63 ? name.length : 63; memcpy(l->name, name.start, nl); l->name[nl] = '\0';
+    l->depth = p->scope_depth; l->local_idx = p->local_count - 1; note_regs(p, (uint32_t)p->local_count);
+    return l;
 }
-static void parse_expression(parser_t *p) { parse_equality(p); }
 
 static void parse_statement(parser_t *p) {
+    /* No temporaries live across statements, so a new local takes the next free register. */
+    p->temp_top = (uint32_t)p->local_count;
     if (match(p, TOK_LET)) {
-        token_t name = p->curr; consume(p, TOK_IDENT, "Expected name"); consume(p, TOK_EQ, "Expected '='"); parse_expression(p); consume(p, TOK_SEMICOLON, "Expected ';'");
-        local_var_t *l = &p->locals[p->local_count++]; size_t nl = name.length < 63 ? name.length : 63; memcpy(l->name, name.start, nl); l->name[nl] = '\0';
-        l->depth = p->scope_depth; l->local_idx = p->local_count - 1; emit(p, OP_STORE_LOCAL); emit(p, (uint32_t)l->local_idx);
+        token_t name = p->curr; consume(p, TOK_IDENT, "Expected name"); consume(p, TOK_EQ, "Expected '='"); uint32_t o = parse_expression(p); consume(p, TOK_SEMICOLON, "Expected ';'");
+        /* A temporary result already sits in that register. */
+        if (!is_temp(p, o)) { emit_move(p, (uint32_t)p->local_count, o); }
+        declare_local(p, name);
     } else if (match(p, TOK_IF)) {
-        consume(p, TOK_LPAREN, "Expected '('"); parse_expression(p); consume(p, TOK_RPAREN, "Expected ')'");
-        emit(p, OP_JMP_IF_FALSE); uint32_t jf = p->prog->code_len; emit(p, 0); parse_block(p); p->prog->code[jf] = p->prog->code_len;
-    } else if (match(p, TOK_RETURN)) { parse_expression(p); consume(p, TOK_SEMICOLON, "Expected ';'"); emit(p, OP_RETURN); }
-    else { parse_expression(p); consume(p, TOK_SEMICOLON, "Expected ';'"); emit(p, OP_POP); }
+        consume(p, TOK_LPAREN, "Expected '('"); uint32_t c = parse_expression(p); consume(p, TOK_RPAREN, "Expected ')'");
+        const ttak_bigint_t *kc = const_int(p, c);
+        if (kc) {
+            bool taken = !ttak_bigint_is_zero(kc); uint32_t mark = p->prog->code_len;
+            parse_block(p);
+            if (!taken) { p->prog->code_len = mark; p->last_ip = NO_IP; }
+        } else {
+            uint32_t jf = emit_branch_unless(p, c); parse_block(p); p->prog->code[jf] = p->prog->code_len;
+        }
+    } else if (match(p, TOK_RETURN)) { uint32_t o = parse_expression(p); consume(p, TOK_SEMICOLON, "Expected ';'"); emit_op(p, OP_RETURN); emit(p, o); }
+    else { parse_expression(p); consume(p, TOK_SEMICOLON, "Expected ';'"); }
 }
 
 static void parse_block(parser_t *p) {
@@ -247,41 +471,139 @@ static void parse_block(parser_t *p) {
 
 static void parse_function(parser_t *p) {
     consume(p, TOK_FN, "Expected 'fn'"); token_t name = p->curr; consume(p, TOK_IDENT, "Expected name"); 
+    if (p->prog->functions_len >= MAX_FUNCTIONS) { set_err(p->err, TTAK_BIGSCRIPT_ERR_LIMIT, "Too many functions"); return; }
     function_t *f = &p->prog->functions[p->prog->functions_len++]; size_t nl = name.length < 63 ? name.length : 63; memcpy(f->name, name.start, nl); f->name[nl] = '\0';
-    f->start_ip = p->prog->code_len; f->arity = 0; p->local_count = 0; p->scope_depth = 1;
+    f->start_ip = p->prog->code_len; f->arity = 0; p->local_count = 0; p->scope_depth = 1; p->temp_top = 0; p->frame_size = 0; p->last_ip = NO_IP;
     consume(p, TOK_LPAREN, "Expected '('");
-    if (p->curr.type != TOK_RPAREN) { do { token_t arg = p->curr; consume(p, TOK_IDENT, "Expected arg"); local_var_t *l = &p->locals[p->local_count++]; size_t al = arg.length < 63 ? arg.length : 63; memcpy(l->name, arg.start, al); l->name[al] = '\0'; l->depth = 1; l->local_idx = p->local_count - 1; f->arity++; } while (match(p, TOK_COMMA)); }
+    if (p->curr.type != TOK_RPAREN) { do { token_t arg = p->curr; consume(p, TOK_IDENT, "Expected arg"); if (!declare_local(p, arg)) { return; } f->arity++; } while (match(p, TOK_COMMA)); }
     consume(p, TOK_RPAREN, "Expected ')'"); parse_block(p); f->locals_count = (uint32_t)p->local_count;
-    variant_init(&p->prog->constants[p->prog->constants_len].value, p->now); emit(p, OP_PUSH_CONST); emit(p, p->prog->constants_len++); emit(p, OP_RETURN);
+    emit_op(p, OP_RETURN); emit(p, add_constant_u64(p, 0));
+    /* The return value lands in register 0, so even a nullary function owns one. */
+    f->frame_size = p->frame_size > 0 ? p->frame_size : 1;
 }
 
 static void parse_program(parser_t *p) { while (p->curr.type != TOK_EOF) { if (p->curr.type == TOK_FN) { parse_function(p); } else { set_err(p->err, TTAK_BIGSCRIPT_ERR_SYNTAX, "Only fns allowed at top level"); return; } if (p->err->code != TTAK_BIGSCRIPT_ERR_NONE) { return; } } }
 
+static void source_hash(const char *source, char out_hex[65]) {
+    SHA256_CTX ctx; sha256_init(&ctx); sha256_update(&ctx, (const uint8_t*)source, strlen(source)); uint8_t d[32]; sha256_final(&ctx, d);
+    for (int i = 0; i < 32; i++) { snprintf(&out_hex[i*2], 3, "%02x", d[i]); }
+}
+
+/* Derives the run-time tables of a program whose code, constants and functions are in place. */
+static void program_finish(ttak_bigscript_program_t *prog) {
+    prog->main_fn = -1;
+    for (uint32_t i = 0; i < prog->functions_len; i++) { if (strcmp(prog->functions[i].name, "main") == 0) { prog->main_fn = (int32_t)i; break; } }
+    for (uint32_t i = 0; i < prog->constants_len; i++) {
+        const ttak_bigscript_variant_t *v = &prog->constants[i].value;
+        prog->const_small[i] = v->type == TTAK_BIGSCRIPT_VAL_INT && ttak_bigint_export_u64(&v->v.i, &prog->const_u64[i]);
+    }
+}
+
+static bool verify_opnd(const ttak_bigscript_program_t *prog, uint32_t o, uint32_t frame) {
+    return (o & OPND_CONST) ? (o & ~OPND_CONST) < prog->constants_len : o < frame;
+}
+
+/*
+ * Words in the instruction at @p ip of a function spanning [lo, end) with
+ * @p frame registers, or 0 if it is malformed.  Jump targets are checked
+ * against @p starts, the instruction boundaries, once those are known.
+ */
+static uint32_t verify_insn(const ttak_bigscript_program_t *prog, uint32_t ip, uint32_t lo, uint32_t end, uint32_t frame, const uint8_t *starts) {
+    const uint32_t *c = prog->code + ip; uint32_t room = end - ip;
+    #define V_OP(o) verify_opnd(prog, (o), frame)
+    #define V_TARGET(t) (!starts || ((t) >= lo && (t) < end && starts[(t)]))
+    switch (c[0]) {
+    case OP_HALT: return 1;
+    case OP_MOVE: return room >= 3 && c[1] < frame && V_OP(c[2]) ? 3 : 0;
+    case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD:
+    case OP_EQ: case OP_NEQ: case OP_LT: case OP_LE: case OP_GT: case OP_GE:
+        return room >= 4 && c[1] < frame && V_OP(c[2]) && V_OP(c[3]) ? 4 : 0;
+    case OP_JMP: return room >= 2 && V_TARGET(c[1]) ? 2 : 0;
+    case OP_JMP_IF_FALSE: return room >= 3 && V_OP(c[1]) && V_TARGET(c[2]) ? 3 : 0;
+    case OP_JCMP: return room >= 5 && c[1] <= 7u && V_OP(c[2]) && V_OP(c[3]) && V_TARGET(c[4]) ? 5 : 0;
+    case OP_RETURN: return room >= 2 && V_OP(c[1]) ? 2 : 0;
+    case OP_CALL: return room >= 3 && c[1] < prog->functions_len && c[2] < frame ? 3 : 0;
+    case OP_CALL_BUILTIN:
+        if (room < 4 || c[1] > BLT_COMPLEX || c[2] < 1 || c[2] > MAX_BUILTIN_ARGS || room < 4 + c[2] || c[3] >= frame) { return 0; }
+        for (uint32_t i = 0; i < c[2]; i++) { if (!V_OP(c[4 + i])) { return 0; } }
+        return 4 + c[2];
+    default: return 0;
+    }
+    #undef V_TARGET
+    #undef V_OP
+}
+
+/*
+ * Checks bytecode that did not come straight from the compiler before any
+ * evaluator sees it.  The interpreters and the native tier index registers,
+ * constants and functions by operand without bounds checks, so every
+ * operand must fit its function's frame or the tables, every jump must land
+ * on an instruction of the same function, and no function may run past its
+ * end.  The compiler lays functions out in order, each ending in RETURN.
+ */
+static bool program_verify(const ttak_bigscript_program_t *prog) {
+    const uint32_t n = prog->code_len, nf = prog->functions_len;
+    if (n == 0 || nf == 0 || n > MAX_CODE || nf > MAX_FUNCTIONS || prog->constants_len > MAX_CONSTANTS || prog->functions[0].start_ip != 0) { return false; }
+    uint8_t *starts = calloc(n, 1);
+    if (!starts) { return false; }
+    bool ok = true;
+    /* The first pass finds instruction boundaries, the second checks jumps against them. */
+    for (int pass = 0; ok && pass < 2; pass++) {
+        for (uint32_t fi = 0; ok && fi < nf; fi++) {
+            const function_t *f = &prog->functions[fi];
+            const uint32_t end = fi + 1 < nf ? prog->functions[fi + 1].start_ip : n;
+            ok = f->start_ip < end && end <= n && f->frame_size >= 1 && f->frame_size <= MAX_REGS && f->arity <= f->frame_size &&
+                 memchr(f->name, '\0', sizeof(f->name)) != NULL;
+            uint32_t ip = f->start_ip, last = OP_HALT;
+            while (ok && ip < end) {
+                uint32_t len = verify_insn(prog, ip, f->start_ip, end, f->frame_size, pass ? starts : NULL);
+                if (len == 0) { ok = false; break; }
+                starts[ip] = 1; last = prog->code[ip]; ip += len;
+            }
+            ok = ok && (last == OP_RETURN || last == OP_JMP);
+        }
+    }
+    free(starts);
+    return ok;
+}
+
 ttak_bigscript_program_t *ttak_bigscript_compile(const char *source, ttak_bigscript_loader_t *loader, const ttak_bigscript_limits_t *limits, ttak_bigscript_error_t *err, uint64_t now) {
-    (void)loader; ttak_bigscript_program_t *prog = (ttak_bigscript_program_t*)ttak_mem_alloc_raw(sizeof(ttak_bigscript_program_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-    if (!prog) { return NULL; }
-    memset(prog, 0, sizeof(ttak_bigscript_program_t)); if (limits) { prog->limits = *limits; }
-    lexer_t lex = { source, 1, 0, prog->limits, err }; parser_t p = { &lex, {TOK_EOF,NULL,0,0}, {TOK_EOF,NULL,0,0}, prog, err, {{{0},0,0}}, 0, 0, now };
+    (void)loader; ttak_bigscript_error_t local_err = { TTAK_BIGSCRIPT_ERR_NONE, NULL }; if (!err) { err = &local_err; }
+    if (!source) { set_err(err, TTAK_BIGSCRIPT_ERR_SYNTAX, "No source"); return NULL; }
+    ttak_bigscript_program_t *prog = (ttak_bigscript_program_t*)ttak_mem_alloc_raw(sizeof(ttak_bigscript_program_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!prog) { set_err(err, TTAK_BIGSCRIPT_ERR_OOM, "Out of memory"); return NULL; }
+    memset(prog, 0, sizeof(ttak_bigscript_program_t)); atomic_init(&prog->refs, 1); if (limits) { prog->limits = *limits; }
+    lexer_t lex = { source, 1, 0, prog->limits, err }; parser_t p = { &lex, {TOK_EOF,NULL,0,0}, {TOK_EOF,NULL,0,0}, prog, err, {{{0},0,0}}, 0, 0, now, 0, 0, NO_IP };
     p.peek = next_token(&lex); advance(&p); while (p.curr.type != TOK_EOF) { parse_program(&p); }
-    SHA256_CTX ctx; sha256_init(&ctx); sha256_update(&ctx, (const uint8_t*)source, strlen(source)); uint8_t d[32]; sha256_final(&ctx, d);
-    for (int i = 0; i < 32; i++) { snprintf(&prog->source_sha256[i*2], 3, "%02x", d[i]); }
+    /* Half-emitted code must never reach the VM, which trusts its operands. */
+    if (err->code != TTAK_BIGSCRIPT_ERR_NONE) { ttak_bigscript_program_free(prog, now); return NULL; }
+    source_hash(source, prog->source_sha256);
+    program_finish(prog);
     return prog;
 }
 
-void ttak_bigscript_program_free(ttak_bigscript_program_t *prog, uint64_t now) { if (prog) { for (uint32_t i = 0; i < prog->constants_len; i++) { variant_free(&prog->constants[i].value, now); } ttak_mem_free(prog); } }
+void ttak_bigscript_program_free(ttak_bigscript_program_t *prog, uint64_t now) {
+    if (!prog || atomic_fetch_sub_explicit(&prog->refs, 1, memory_order_acq_rel) != 1) { return; }
+    for (uint32_t i = 0; i < prog->constants_len; i++) { variant_free(&prog->constants[i].value, now); }
+#ifdef BIGSCRIPT_JIT
+    if (prog->jit_code) { munmap(prog->jit_code, prog->jit_size); }
+#endif
+    ttak_mem_free(prog);
+}
 
 ttak_bigscript_vm_t *ttak_bigscript_vm_create(const ttak_bigscript_limits_t *limits, uint64_t now) {
     ttak_bigscript_vm_t *vm = (ttak_bigscript_vm_t*)ttak_mem_alloc_raw(sizeof(ttak_bigscript_vm_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
     if (!vm) { return NULL; }
     memset(vm, 0, sizeof(ttak_bigscript_vm_t)); if (limits) { vm->limits = *limits; }
-    vm->stack_cap = 1024; vm->stack = (ttak_bigscript_variant_t*)ttak_mem_alloc_raw(sizeof(ttak_bigscript_variant_t) * 1024, __TTAK_UNSAFE_MEM_FOREVER__, now);
-    for (uint32_t i = 0; i < 1024; i++) { variant_init(&vm->stack[i], now); }
-    vm->locals_cap = 1024; vm->locals = (ttak_bigscript_variant_t*)ttak_mem_alloc_raw(sizeof(ttak_bigscript_variant_t) * 1024, __TTAK_UNSAFE_MEM_FOREVER__, now);
-    for (uint32_t i = 0; i < 1024; i++) { variant_init(&vm->locals[i], now); }
+    vm->regs = (ttak_bigscript_variant_t*)ttak_mem_alloc_raw(sizeof(ttak_bigscript_variant_t) * VM_REGS, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!vm->regs) { ttak_mem_free(vm); return NULL; }
+    vm->regs_cap = VM_REGS;
+    for (uint32_t i = 0; i < VM_REGS; i++) { variant_init(&vm->regs[i], now); }
+    variant_init(&vm->scratch, now);
     return vm;
 }
 
-void ttak_bigscript_vm_free(ttak_bigscript_vm_t *vm, uint64_t now) { if (vm) { for (uint32_t i = 0; i < vm->stack_cap; i++) { variant_free(&vm->stack[i], now); } for (uint32_t i = 0; i < vm->locals_cap; i++) { variant_free(&vm->locals[i], now); } ttak_mem_free(vm->stack); ttak_mem_free(vm->locals); ttak_mem_free(vm); } }
+void ttak_bigscript_vm_free(ttak_bigscript_vm_t *vm, uint64_t now) { if (vm) { for (uint32_t i = 0; i < vm->regs_cap; i++) { variant_free(&vm->regs[i], now); } variant_free(&vm->scratch, now); ttak_mem_free(vm->wregs); ttak_mem_free(vm->regs); ttak_mem_free(vm); } }
 
 void ttak_bigscript_hash_program(ttak_bigscript_program_t *prog, char out_hex[65]) { if (prog) { strncpy(out_hex, prog->source_sha256, 64); out_hex[64] = '\0'; } else { memset(out_hex, 0, 65); } }
 
@@ -289,123 +611,838 @@ void ttak_bigscript_value_free(ttak_bigscript_value_t *val, uint64_t now) {
     if (val) { variant_free(&val->value, now); }
 }
 
-bool ttak_bigscript_eval_seed(ttak_bigscript_program_t *prog, ttak_bigscript_vm_t *vm, const ttak_bigint_t *seed, const ttak_bigint_t *sn, ttak_bigscript_value_t *out, ttak_bigscript_error_t *err, uint64_t now) {
-    (void)err; int mi = -1; for (uint32_t i = 0; i < prog->functions_len; i++) { if (strcmp(prog->functions[i].name, "main") == 0) { mi = (int)i; break; } }
-    if (mi < 0) { return false; }
-    function_t *f = &prog->functions[mi];
-    vm->stack_top = 0; vm->locals_top = 0; vm->call_depth = 0; vm->steps = 0; vm->now = now;
-    variant_set_int_u64(&vm->locals[0], 0, now); ttak_bigint_copy(&vm->locals[0].v.i, seed, now);
-    variant_set_int_u64(&vm->locals[1], 0, now); ttak_bigint_copy(&vm->locals[1].v.i, sn, now);
-    uint32_t ip = f->start_ip;
-    while (ip < prog->code_len) {
-        uint32_t op = prog->code[ip++];
-        #define POP1(a) a = &vm->stack[--vm->stack_top]
-        #define POP2(a, b) b = &vm->stack[--vm->stack_top]; a = &vm->stack[--vm->stack_top]
-        #define PUSH(v) variant_copy(&vm->stack[vm->stack_top++], v, now)
-        switch(op) {
-            case OP_PUSH_CONST: { uint32_t i = prog->code[ip++]; PUSH(&prog->constants[i].value); break; }
-            case OP_LOAD_LOCAL: { uint32_t i = prog->code[ip++]; PUSH(&vm->locals[i]); break; }
-            case OP_STORE_LOCAL: { uint32_t i = prog->code[ip++]; ttak_bigscript_variant_t *v; POP1(v); variant_copy(&vm->locals[i], v, now); break; }
-            case OP_ADD: {
-                ttak_bigscript_variant_t *a, *b; POP2(a, b);
-                ttak_bigscript_variant_t r; variant_init(&r, now);
-                if (a->type == TTAK_BIGSCRIPT_VAL_COMPLEX || b->type == TTAK_BIGSCRIPT_VAL_COMPLEX) {
-                    ttak_bigscript_variant_t aa, bb; variant_init(&aa, now); variant_init(&bb, now);
-                    variant_copy(&aa, a, now); variant_copy(&bb, b, now);
-                    r.type = TTAK_BIGSCRIPT_VAL_COMPLEX; ttak_bigcomplex_init(&r.v.c, now);
-                    if (aa.type == TTAK_BIGSCRIPT_VAL_COMPLEX && bb.type == TTAK_BIGSCRIPT_VAL_COMPLEX)
-                        ttak_bigcomplex_add(&r.v.c, &aa.v.c, &bb.v.c, now);
-                    variant_free(&aa, now); variant_free(&bb, now);
-                } else if (a->type == TTAK_BIGSCRIPT_VAL_REAL || b->type == TTAK_BIGSCRIPT_VAL_REAL) {
-                    r.type = TTAK_BIGSCRIPT_VAL_REAL; ttak_bigreal_init(&r.v.r, now);
-                } else {
-                    ttak_bigint_add(&r.v.i, &a->v.i, &b->v.i, now);
-                }
-                PUSH(&r); variant_free(&r, now); break;
-            }
-            case OP_SUB: {
-                ttak_bigscript_variant_t *a, *b; POP2(a, b);
-                ttak_bigscript_variant_t r; variant_init(&r, now);
-                if (a->type == TTAK_BIGSCRIPT_VAL_INT && b->type == TTAK_BIGSCRIPT_VAL_INT) {
-                    ttak_bigint_sub(&r.v.i, &a->v.i, &b->v.i, now);
-                }
-                PUSH(&r); variant_free(&r, now); break;
-            }
-            case OP_MUL: {
-                ttak_bigscript_variant_t *a, *b; POP2(a, b);
-                ttak_bigscript_variant_t r; variant_init(&r, now);
-                if (a->type == TTAK_BIGSCRIPT_VAL_INT && b->type == TTAK_BIGSCRIPT_VAL_INT) {
-                    ttak_bigint_mul(&r.v.i, &a->v.i, &b->v.i, now);
-                }
-                PUSH(&r); variant_free(&r, now); break;
-            }
-            case OP_DIV: {
-                ttak_bigscript_variant_t *a, *b; POP2(a, b);
-                ttak_bigscript_variant_t q, rr; variant_init(&q, now); variant_init(&rr, now);
-                if (a->type == TTAK_BIGSCRIPT_VAL_INT && b->type == TTAK_BIGSCRIPT_VAL_INT) {
-                    ttak_bigint_div(&q.v.i, &rr.v.i, &a->v.i, &b->v.i, now);
-                }
-                PUSH(&q); variant_free(&q, now); variant_free(&rr, now); break;
-            }
-            case OP_EQ: {
-                ttak_bigscript_variant_t *a, *b; POP2(a, b);
-                ttak_bigscript_variant_t r; variant_init(&r, now);
-                if (a->type == TTAK_BIGSCRIPT_VAL_INT && b->type == TTAK_BIGSCRIPT_VAL_INT) {
-                    ttak_bigint_set_u64(&r.v.i, ttak_bigint_cmp(&a->v.i, &b->v.i) == 0 ? 1 : 0, now);
-                }
-                PUSH(&r); variant_free(&r, now); break;
-            }
-            case OP_JMP_IF_FALSE: {
-                uint32_t d = prog->code[ip++]; ttak_bigscript_variant_t *c; POP1(c);
-                if (c->type == TTAK_BIGSCRIPT_VAL_INT && ttak_bigint_cmp_u64(&c->v.i, 0) == 0) { ip = d; }
-                break;
+/* Mixed-type addition: complex + complex adds, anything else involving a complex or a real yields zero of that type. */
+static bool vm_mixed_add(ttak_bigscript_vm_t *vm, ttak_bigscript_variant_t *d, const ttak_bigscript_variant_t *a, const ttak_bigscript_variant_t *b, uint64_t now) {
+    ttak_bigscript_variant_t *r = &vm->scratch; bool ok = true;
+    if (a->type == TTAK_BIGSCRIPT_VAL_COMPLEX || b->type == TTAK_BIGSCRIPT_VAL_COMPLEX) {
+        variant_reset(r, TTAK_BIGSCRIPT_VAL_COMPLEX, now);
+        if (a->type == TTAK_BIGSCRIPT_VAL_COMPLEX && b->type == TTAK_BIGSCRIPT_VAL_COMPLEX) { ok = ttak_bigcomplex_add(&r->v.c, &a->v.c, &b->v.c, now); }
+    } else {
+        variant_reset(r, TTAK_BIGSCRIPT_VAL_REAL, now);
+    }
+    variant_swap(d, r); return ok;
+}
+
+static bool vm_builtin(ttak_bigscript_vm_t *vm, uint32_t bi, uint32_t argc, const ttak_bigscript_variant_t *a0, const ttak_bigscript_variant_t *a1, ttak_bigscript_variant_t *d, uint64_t now) {
+    /* Built in scratch and swapped in, since d may be one of the arguments. */
+    ttak_bigscript_variant_t *r = &vm->scratch; bool ok = true;
+    if (bi == BLT_S) {
+        ttak_bigint_t *ri = variant_as_int(r, now);
+        if (a0->type != TTAK_BIGSCRIPT_VAL_INT || !ttak_sum_proper_divisors_big(&a0->v.i, ri, now)) { ok = ttak_bigint_set_u64(ri, 0, now); }
+    } else if (bi == BLT_IS_ZERO) {
+        bool z = (a0->type == TTAK_BIGSCRIPT_VAL_INT) ? ttak_bigint_is_zero(&a0->v.i)
+               : (a0->type == TTAK_BIGSCRIPT_VAL_REAL) ? ttak_bigint_is_zero(&a0->v.r.mantissa)
+               : ttak_bigint_is_zero(&a0->v.c.real.mantissa) && ttak_bigint_is_zero(&a0->v.c.imag.mantissa);
+        ok = ttak_bigint_set_u64(variant_as_int(r, now), z ? 1 : 0, now);
+    } else if (bi == BLT_REAL) {
+        if (a0->type == TTAK_BIGSCRIPT_VAL_INT) {
+            variant_reset(r, TTAK_BIGSCRIPT_VAL_REAL, now);
+            ok = ttak_bigint_copy(&r->v.r.mantissa, &a0->v.i, now); r->v.r.exponent = 0;
+        } else if (a0->type == TTAK_BIGSCRIPT_VAL_REAL) {
+            ok = variant_copy(r, a0, now);
+        } else {
+            variant_reset(r, TTAK_BIGSCRIPT_VAL_INT, now);
+        }
+    } else {
+        variant_reset(r, TTAK_BIGSCRIPT_VAL_COMPLEX, now);
+        const ttak_bigscript_variant_t *parts[2] = { a0, argc >= 2 ? a1 : NULL };
+        ttak_bigreal_t *dst[2] = { &r->v.c.real, &r->v.c.imag };
+        for (int i = 0; i < 2 && ok; i++) {
+            if (!parts[i]) { break; }
+            if (parts[i]->type == TTAK_BIGSCRIPT_VAL_INT) ok = ttak_bigint_copy(&dst[i]->mantissa, &parts[i]->v.i, now);
+            else if (parts[i]->type == TTAK_BIGSCRIPT_VAL_REAL) ok = ttak_bigreal_copy(dst[i], &parts[i]->v.r, now);
+        }
+    }
+    variant_swap(d, r); return ok;
+}
+
+/* Outcome of the word-sized tier: a value, or a request to rerun the seed on bigints. */
+typedef enum { FAST_DONE = 0, FAST_BAIL } fast_status_t;
+
+/* s() on a word, unless an input bit limit below 64 makes the bigint path answer differently. */
+static bool fast_sumdiv(uint64_t n, uint64_t *out) {
+    ttak_sumdiv_limits_t sl; ttak_sum_divisors_get_limits(&sl);
+    if (sl.max_input_bits != 0 && sl.max_input_bits < 64) return false;
+    return ttak_sum_proper_divisors_u64(n, out);
+}
+
+/*
+ * Runs the program on 64-bit unsigned registers.  Anything the bigint VM
+ * would answer differently (a negative or wider result, a non-integer
+ * constant or builtin, a zero divisor, a depth overflow) bails out, so the
+ * bigint VM stays the only place errors are reported.
+ */
+static fast_status_t fast_eval(const ttak_bigscript_program_t *prog, uint64_t *regs, uint64_t seed, uint64_t sn, uint64_t *out) {
+    const function_t *f = &prog->functions[prog->main_fn];
+    if (f->frame_size > VM_REGS) return FAST_BAIL;
+    uint32_t depth_cap = (prog->limits.max_call_depth && prog->limits.max_call_depth < VM_FRAMES) ? prog->limits.max_call_depth : VM_FRAMES;
+    frame_t frames[VM_FRAMES];
+    const uint32_t *code = prog->code;
+    uint64_t *R = regs;
+    uint32_t ip = f->start_ip, base = 0, depth = 0;
+    R[0] = seed; R[1] = sn;
+
+    #define FAST_OPND(w, dst) do { uint32_t w_ = (w); \
+            if (w_ & OPND_CONST) { if (!prog->const_small[w_ & ~OPND_CONST]) return FAST_BAIL; (dst) = prog->const_u64[w_ & ~OPND_CONST]; } \
+            else { (dst) = R[w_]; } } while (0)
+    for (;;) {
+        uint32_t op = code[ip++];
+        switch ((opcode_t)op) {
+        case OP_MOVE: { uint64_t s; FAST_OPND(code[ip + 1], s); R[code[ip]] = s; ip += 2; break; }
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD:
+        case OP_EQ: case OP_NEQ: case OP_LT: case OP_LE: case OP_GT: case OP_GE: {
+            uint64_t a, b, r; uint32_t d = code[ip];
+            FAST_OPND(code[ip + 1], a); FAST_OPND(code[ip + 2], b); ip += 3;
+            if (op == OP_ADD) { r = a + b; if (r < a) return FAST_BAIL; }
+            else if (op == OP_SUB) { if (a < b) return FAST_BAIL; r = a - b; }
+            else if (op == OP_MUL) { r = a * b; if (a != 0 && r / a != b) return FAST_BAIL; }
+            else if (op == OP_DIV || op == OP_MOD) { if (b == 0) return FAST_BAIL; r = op == OP_DIV ? a / b : a % b; }
+            else { r = cmp_holds(cmp_mask(op), (a > b) - (a < b)); }
+            R[d] = r;
+            break;
+        }
+        case OP_JMP: ip = code[ip]; break;
+        case OP_JMP_IF_FALSE: { uint64_t c; FAST_OPND(code[ip], c); ip = c == 0 ? code[ip + 1] : ip + 2; break; }
+        case OP_JCMP: {
+            uint64_t a, b; FAST_OPND(code[ip + 1], a); FAST_OPND(code[ip + 2], b);
+            ip = cmp_holds(code[ip], (a > b) - (a < b)) ? ip + 4 : code[ip + 3];
+            break;
+        }
+        case OP_RETURN: {
+            uint64_t s; FAST_OPND(code[ip], s);
+            if (depth == 0) { *out = s; return FAST_DONE; }
+            R[0] = s;
+            const frame_t *fr = &frames[--depth];
+            ip = fr->ret_ip; base = fr->base; R = regs + base;
+            break;
+        }
+        case OP_CALL: {
+            const function_t *callee = &prog->functions[code[ip]]; uint32_t nb = base + code[ip + 1];
+            if (depth >= depth_cap || nb + callee->frame_size > VM_REGS) return FAST_BAIL;
+            frames[depth].ret_ip = ip + 2; frames[depth].base = base; depth++;
+            base = nb; R = regs + base; ip = callee->start_ip;
+            break;
+        }
+        case OP_CALL_BUILTIN: {
+            uint32_t bi = code[ip], argc = code[ip + 1], d = code[ip + 2]; uint64_t a;
+            FAST_OPND(code[ip + 3], a); ip += 3 + argc;
+            if (bi == BLT_S) { if (!fast_sumdiv(a, &R[d])) return FAST_BAIL; }
+            else if (bi == BLT_IS_ZERO) { R[d] = a == 0; }
+            else return FAST_BAIL;
+            break;
+        }
+        case OP_HALT:
+        default:
+            return FAST_BAIL;
+        }
+    }
+    #undef FAST_OPND
+}
+
+/*
+ * Native tier.  Once a program has evaluated TTAK_BIGSCRIPT_JIT_THRESHOLD
+ * seeds, its bytecode is translated instruction by instruction into x86-64
+ * code with the same semantics as fast_eval(): every bytecode function
+ * becomes a native function over the word register file, and each guard
+ * that makes fast_eval() bail returns 1 instead, after which the caller
+ * reruns the seed on the bigint VM.  Other targets keep the interpreter.
+ */
+#ifndef TTAK_BIGSCRIPT_JIT_THRESHOLD
+#define TTAK_BIGSCRIPT_JIT_THRESHOLD 4096
+#endif
+
+enum { JIT_COLD = 0, JIT_BUSY, JIT_READY, JIT_NONE };
+
+#ifdef BIGSCRIPT_JIT
+/* Returns 0 with the result in regs[0], or 1 to bail.  regs_end bounds the frames. */
+typedef int (*jit_entry_t)(uint64_t *regs, uint32_t depth, uint64_t *regs_end);
+
+typedef enum { FIX_IP = 0, FIX_FN, FIX_BAIL, FIX_EXIT } jit_fix_kind_t;
+typedef struct { uint32_t at; uint32_t kind; uint32_t target; } jit_fix_t;
+
+typedef struct {
+    uint8_t *buf; size_t len, cap;
+    jit_fix_t *fix; size_t nfix, fix_cap;
+    bool ok;
+} jit_t;
+
+static void jit_put(jit_t *j, const void *src, size_t n) {
+    if (!j->ok) { return; }
+    if (j->len + n > j->cap) {
+        size_t cap = j->cap ? j->cap * 2 : 4096; while (cap < j->len + n) { cap *= 2; }
+        uint8_t *nb = realloc(j->buf, cap); if (!nb) { j->ok = false; return; }
+        j->buf = nb; j->cap = cap;
+    }
+    memcpy(j->buf + j->len, src, n); j->len += n;
+}
+
+#define JIT_BYTES(j, ...) do { static const uint8_t b_[] = { __VA_ARGS__ }; jit_put((j), b_, sizeof(b_)); } while (0)
+
+static void jit_u32(jit_t *j, uint32_t v) { jit_put(j, &v, sizeof(v)); }
+static void jit_u64(jit_t *j, uint64_t v) { jit_put(j, &v, sizeof(v)); }
+
+/* Emits a rel32 whose target is resolved once every label is known. */
+static void jit_rel(jit_t *j, jit_fix_kind_t kind, uint32_t target) {
+    if (!j->ok) { return; }
+    if (j->nfix == j->fix_cap) {
+        size_t cap = j->fix_cap ? j->fix_cap * 2 : 256;
+        jit_fix_t *nf = realloc(j->fix, cap * sizeof(*nf)); if (!nf) { j->ok = false; return; }
+        j->fix = nf; j->fix_cap = cap;
+    }
+    j->fix[j->nfix++] = (jit_fix_t){ (uint32_t)j->len, kind, target };
+    jit_u32(j, 0);
+}
+
+static void jit_jcc(jit_t *j, uint8_t cc, jit_fix_kind_t kind, uint32_t target) { uint8_t b[2] = { 0x0F, cc }; jit_put(j, b, 2); jit_rel(j, kind, target); }
+static void jit_jmp(jit_t *j, jit_fix_kind_t kind, uint32_t target) { JIT_BYTES(j, 0xE9); jit_rel(j, kind, target); }
+
+/* Loads operand @p o into rax (@p rcx false) or rcx; a constant wider than a word bails. */
+static void jit_load(jit_t *j, const ttak_bigscript_program_t *prog, uint32_t o, bool rcx) {
+    if (o & OPND_CONST) {
+        if (!prog->const_small[o & ~OPND_CONST]) { jit_jmp(j, FIX_BAIL, 0); return; }
+        uint8_t b[2] = { 0x48, rcx ? 0xB9 : 0xB8 }; jit_put(j, b, 2); jit_u64(j, prog->const_u64[o & ~OPND_CONST]);
+    } else {
+        uint8_t b[3] = { 0x48, 0x8B, rcx ? 0x8B : 0x83 }; jit_put(j, b, 3); jit_u32(j, o * 8u);
+    }
+}
+
+static void jit_store(jit_t *j, uint32_t d) { JIT_BYTES(j, 0x48, 0x89, 0x83); jit_u32(j, d * 8u); }
+
+static bool jit_sumdiv(uint64_t n, uint64_t *out) { return fast_sumdiv(n, out); }
+
+static void jit_function_prologue(jit_t *j) {
+    JIT_BYTES(j, 0x53, 0x41, 0x54, 0x41, 0x55,   /* push rbx; push r12; push r13 */
+                 0x48, 0x89, 0xFB,               /* mov rbx, rdi */
+                 0x41, 0x89, 0xF4,               /* mov r12d, esi */
+                 0x49, 0x89, 0xD5);              /* mov r13, rdx */
+}
+
+/* Translates the whole program; returns the entry of main, or NULL when the code cannot be mapped. */
+static jit_entry_t jit_translate(ttak_bigscript_program_t *prog) {
+    const uint32_t *code = prog->code; uint32_t n = prog->code_len;
+    uint32_t depth_cap = (prog->limits.max_call_depth && prog->limits.max_call_depth < VM_FRAMES) ? prog->limits.max_call_depth : VM_FRAMES;
+    uint32_t *ip_off = malloc(sizeof(uint32_t) * (n + 1)), fn_off[MAX_FUNCTIONS];
+    for (uint32_t f = 0; f < MAX_FUNCTIONS; f++) { fn_off[f] = UINT32_MAX; }
+    jit_t j = { NULL, 0, 0, NULL, 0, 0, ip_off != NULL };
+    if (ip_off) { for (uint32_t i = 0; i <= n; i++) { ip_off[i] = UINT32_MAX; } }
+    uint32_t ip = 0;
+    while (j.ok && ip < n) {
+        for (uint32_t f = 0; f < prog->functions_len; f++) { if (prog->functions[f].start_ip == ip) { fn_off[f] = (uint32_t)j.len; jit_function_prologue(&j); } }
+        ip_off[ip] = (uint32_t)j.len;
+        uint32_t op = code[ip];
+        switch ((opcode_t)op) {
+        case OP_MOVE: jit_load(&j, prog, code[ip + 2], false); jit_store(&j, code[ip + 1]); ip += 3; break;
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD:
+        case OP_EQ: case OP_NEQ: case OP_LT: case OP_LE: case OP_GT: case OP_GE: {
+            jit_load(&j, prog, code[ip + 2], false); jit_load(&j, prog, code[ip + 3], true);
+            if (op == OP_ADD) { JIT_BYTES(&j, 0x48, 0x01, 0xC8); jit_jcc(&j, 0x82, FIX_BAIL, 0); }        /* add rax, rcx; jc */
+            else if (op == OP_SUB) { JIT_BYTES(&j, 0x48, 0x29, 0xC8); jit_jcc(&j, 0x82, FIX_BAIL, 0); }   /* sub rax, rcx; jb */
+            else if (op == OP_MUL) { JIT_BYTES(&j, 0x48, 0xF7, 0xE1); jit_jcc(&j, 0x80, FIX_BAIL, 0); }   /* mul rcx; jo */
+            else if (op == OP_DIV || op == OP_MOD) {
+                JIT_BYTES(&j, 0x48, 0x85, 0xC9); jit_jcc(&j, 0x84, FIX_BAIL, 0);                         /* test rcx, rcx; jz */
+                JIT_BYTES(&j, 0x31, 0xD2, 0x48, 0xF7, 0xF1);                                             /* xor edx, edx; div rcx */
+                if (op == OP_MOD) { JIT_BYTES(&j, 0x48, 0x89, 0xD0); }                                   /* mov rax, rdx */
+            } else {
+                static const uint8_t setcc[] = { [OP_EQ] = 0x94, [OP_NEQ] = 0x95, [OP_LT] = 0x92, [OP_LE] = 0x96, [OP_GT] = 0x97, [OP_GE] = 0x93 };
+                uint8_t b[9] = { 0x48, 0x39, 0xC8, 0x0F, setcc[op], 0xC0, 0x0F, 0xB6, 0xC0 };          /* cmp; setcc al; movzx eax, al */
+                jit_put(&j, b, sizeof(b));
             }
-            case OP_RETURN: { 
-                ttak_bigscript_variant_t *rv; POP1(rv); 
-                if (out) { 
-                    variant_init(&out->value, now);
-                    if (variant_copy(&out->value, rv, now)) {
-                        if (rv->type == TTAK_BIGSCRIPT_VAL_INT) out->is_found = (ttak_bigint_cmp_u64(&rv->v.i, 0) != 0);
-                        else out->is_found = true;
-                    } else {
-                        out->is_found = false;
-                    }
-                } 
-                return true; 
+            jit_store(&j, code[ip + 1]); ip += 4; break;
+        }
+        case OP_JMP: jit_jmp(&j, FIX_IP, code[ip + 1]); ip += 2; break;
+        case OP_JMP_IF_FALSE:
+            jit_load(&j, prog, code[ip + 1], false); JIT_BYTES(&j, 0x48, 0x85, 0xC0); jit_jcc(&j, 0x84, FIX_IP, code[ip + 2]);
+            ip += 3; break;
+        case OP_JCMP: {
+            /* Branch to the target when the comparison falls outside the mask. */
+            uint32_t mask = code[ip + 1];
+            jit_load(&j, prog, code[ip + 2], false); jit_load(&j, prog, code[ip + 3], true); JIT_BYTES(&j, 0x48, 0x39, 0xC8);
+            uint8_t cc = mask == 2 ? 0x85 : mask == 5 ? 0x84 : mask == 1 ? 0x83 : mask == 3 ? 0x87 : mask == 4 ? 0x86 : mask == 6 ? 0x82 : 0;
+            if (cc) { jit_jcc(&j, cc, FIX_IP, code[ip + 4]); }
+            else if (mask == 0) { jit_jmp(&j, FIX_IP, code[ip + 4]); }
+            ip += 5; break;
+        }
+        case OP_RETURN:
+            jit_load(&j, prog, code[ip + 1], false);
+            JIT_BYTES(&j, 0x48, 0x89, 0x03, 0x31, 0xC0);                                                 /* mov [rbx], rax; xor eax, eax */
+            jit_jmp(&j, FIX_EXIT, 0); ip += 2; break;
+        case OP_CALL: {
+            uint32_t fi = code[ip + 1], base = code[ip + 2];
+            if (fi >= prog->functions_len) { j.ok = false; break; }
+            JIT_BYTES(&j, 0x41, 0x81, 0xFC); jit_u32(&j, depth_cap); jit_jcc(&j, 0x83, FIX_BAIL, 0);     /* cmp r12d, cap; jae */
+            JIT_BYTES(&j, 0x48, 0x8D, 0xBB); jit_u32(&j, (base + prog->functions[fi].frame_size) * 8u);  /* lea rdi, [rbx + end] */
+            JIT_BYTES(&j, 0x4C, 0x39, 0xEF); jit_jcc(&j, 0x87, FIX_BAIL, 0);                             /* cmp rdi, r13; ja */
+            JIT_BYTES(&j, 0x48, 0x8D, 0xBB); jit_u32(&j, base * 8u);                                     /* lea rdi, [rbx + base] */
+            JIT_BYTES(&j, 0x41, 0x8D, 0x74, 0x24, 0x01, 0x4C, 0x89, 0xEA);                               /* lea esi, [r12 + 1]; mov rdx, r13 */
+            JIT_BYTES(&j, 0xE8); jit_rel(&j, FIX_FN, fi);
+            JIT_BYTES(&j, 0x85, 0xC0); jit_jcc(&j, 0x85, FIX_BAIL, 0);                                   /* test eax, eax; jnz */
+            ip += 3; break;
+        }
+        case OP_CALL_BUILTIN: {
+            uint32_t bi = code[ip + 1], argc = code[ip + 2], d = code[ip + 3];
+            jit_load(&j, prog, code[ip + 4], false);
+            if (bi == BLT_IS_ZERO) {
+                JIT_BYTES(&j, 0x48, 0x85, 0xC0, 0x0F, 0x94, 0xC0, 0x0F, 0xB6, 0xC0); jit_store(&j, d);   /* test; sete al; movzx */
+            } else if (bi == BLT_S) {
+                JIT_BYTES(&j, 0x48, 0x89, 0xC7, 0x48, 0x8D, 0xB3); jit_u32(&j, d * 8u);                  /* mov rdi, rax; lea rsi, [rbx + d] */
+                JIT_BYTES(&j, 0x48, 0xB8); jit_u64(&j, (uint64_t)(uintptr_t)&jit_sumdiv);                /* mov rax, jit_sumdiv */
+                JIT_BYTES(&j, 0xFF, 0xD0, 0x84, 0xC0); jit_jcc(&j, 0x84, FIX_BAIL, 0);                   /* call rax; test al, al; jz */
+            } else {
+                jit_jmp(&j, FIX_BAIL, 0);
             }
-            case OP_CALL_BUILTIN: {
-                uint32_t bi = prog->code[ip++]; uint32_t ac = prog->code[ip++];
-                ttak_bigscript_variant_t res; variant_init(&res, now);
-                if (bi == BLT_S) {
-                    if (vm->stack[vm->stack_top-1].type == TTAK_BIGSCRIPT_VAL_INT)
-                        ttak_sum_proper_divisors_big(&vm->stack[vm->stack_top-1].v.i, &res.v.i, now);
-                } else if (bi == BLT_REAL) {
-                    if (vm->stack[vm->stack_top-1].type == TTAK_BIGSCRIPT_VAL_INT) {
-                        res.type = TTAK_BIGSCRIPT_VAL_REAL; ttak_bigreal_init(&res.v.r, now);
-                        ttak_bigint_copy(&res.v.r.mantissa, &vm->stack[vm->stack_top-1].v.i, now);
-                        res.v.r.exponent = 0;
-                    } else if (vm->stack[vm->stack_top-1].type == TTAK_BIGSCRIPT_VAL_REAL) {
-                        variant_copy(&res, &vm->stack[vm->stack_top-1], now);
-                    }
-                } else if (bi == BLT_COMPLEX) {
-                    res.type = TTAK_BIGSCRIPT_VAL_COMPLEX; ttak_bigcomplex_init(&res.v.c, now);
-                    if (ac >= 1) {
-                        ttak_bigscript_variant_t *re = &vm->stack[vm->stack_top - ac];
-                        if (re->type == TTAK_BIGSCRIPT_VAL_INT) ttak_bigint_copy(&res.v.c.real.mantissa, &re->v.i, now);
-                        else if (re->type == TTAK_BIGSCRIPT_VAL_REAL) ttak_bigreal_copy(&res.v.c.real, &re->v.r, now);
-                    }
-                    if (ac >= 2) {
-                        ttak_bigscript_variant_t *im = &vm->stack[vm->stack_top - ac + 1];
-                        if (im->type == TTAK_BIGSCRIPT_VAL_INT) ttak_bigint_copy(&res.v.c.imag.mantissa, &im->v.i, now);
-                        else if (im->type == TTAK_BIGSCRIPT_VAL_REAL) ttak_bigreal_copy(&res.v.c.imag, &im->v.r, now);
-                    }
-                }
-                for(uint32_t i=0; i<ac; i++) { vm->stack_top--; }
-                PUSH(&res); variant_free(&res, now); break;
+            ip += 4 + argc; break;
+        }
+        case OP_HALT:
+        default:
+            jit_jmp(&j, FIX_BAIL, 0); ip += 1; break;
+        }
+    }
+    uint32_t bail = (uint32_t)j.len;
+    JIT_BYTES(&j, 0xB8, 0x01, 0x00, 0x00, 0x00);                                                         /* mov eax, 1 */
+    uint32_t exit = (uint32_t)j.len;
+    JIT_BYTES(&j, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3);                                                   /* pop r13; pop r12; pop rbx; ret */
+
+    void *mem = MAP_FAILED;
+    for (size_t i = 0; j.ok && i < j.nfix; i++) {
+        const jit_fix_t *fx = &j.fix[i];
+        uint32_t to = fx->kind == FIX_BAIL ? bail : fx->kind == FIX_EXIT ? exit
+                    : fx->kind == FIX_FN ? fn_off[fx->target] : (fx->target < n ? ip_off[fx->target] : UINT32_MAX);
+        if (to == UINT32_MAX) { j.ok = false; break; }
+        int32_t rel = (int32_t)to - (int32_t)(fx->at + 4);
+        memcpy(j.buf + fx->at, &rel, sizeof(rel));
+    }
+    if (j.ok) { mem = mmap(NULL, j.len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0); }
+    if (mem != MAP_FAILED) {
+        memcpy(mem, j.buf, j.len);
+        if (mprotect(mem, j.len, PROT_READ | PROT_EXEC) != 0) { munmap(mem, j.len); mem = MAP_FAILED; }
+    }
+    free(j.buf); free(j.fix); free(ip_off);
+    if (mem == MAP_FAILED || fn_off[prog->main_fn] == UINT32_MAX) { if (mem != MAP_FAILED) { munmap(mem, j.len); } return NULL; }
+    prog->jit_code = mem; prog->jit_size = j.len;
+    return (jit_entry_t)(void *)((uint8_t *)mem + fn_off[prog->main_fn]);
+}
+#endif
+
+/* Translates @p prog once; concurrent callers that lose the race keep interpreting. */
+static void jit_try(ttak_bigscript_program_t *prog) {
+    int cold = JIT_COLD;
+    if (!atomic_compare_exchange_strong_explicit(&prog->jit_state, &cold, JIT_BUSY, memory_order_acq_rel, memory_order_relaxed)) { return; }
+#ifdef BIGSCRIPT_JIT
+    void *entry = prog->main_fn >= 0 ? (void *)jit_translate(prog) : NULL;
+    if (entry) { prog->jit_entry = entry; atomic_store_explicit(&prog->jit_state, JIT_READY, memory_order_release); return; }
+#endif
+    atomic_store_explicit(&prog->jit_state, JIT_NONE, memory_order_release);
+}
+
+/* Counts @p seeds evaluations towards the threshold and returns the native entry once there is one. */
+static void *jit_hot(ttak_bigscript_program_t *prog, size_t seeds) {
+    int st = atomic_load_explicit(&prog->jit_state, memory_order_acquire);
+    if (st == JIT_READY) { return prog->jit_entry; }
+    if (st != JIT_COLD) { return NULL; }
+    if (atomic_fetch_add_explicit(&prog->hot, seeds, memory_order_relaxed) + seeds < TTAK_BIGSCRIPT_JIT_THRESHOLD) { return NULL; }
+    jit_try(prog);
+    return atomic_load_explicit(&prog->jit_state, memory_order_acquire) == JIT_READY ? prog->jit_entry : NULL;
+}
+
+/* One seed on the word tier: native code when @p entry is set, the interpreter otherwise. */
+static fast_status_t fast_run(const ttak_bigscript_program_t *prog, void *entry, uint64_t *regs, uint64_t seed, uint64_t sn, uint64_t *out) {
+#ifdef BIGSCRIPT_JIT
+    if (entry) {
+        if (prog->functions[prog->main_fn].frame_size > VM_REGS) return FAST_BAIL;
+        regs[0] = seed; regs[1] = sn;
+        if (((jit_entry_t)entry)(regs, 0, regs + VM_REGS) != 0) return FAST_BAIL;
+        *out = regs[0]; return FAST_DONE;
+    }
+#else
+    (void)entry;
+#endif
+    return fast_eval(prog, regs, seed, sn, out);
+}
+
+bool ttak_bigscript_jit_compile(ttak_bigscript_program_t *prog) {
+    if (!prog) { return false; }
+    jit_try(prog);
+    return atomic_load_explicit(&prog->jit_state, memory_order_acquire) == JIT_READY;
+}
+bool ttak_bigscript_eval_seed(ttak_bigscript_program_t *prog, ttak_bigscript_vm_t *vm, const ttak_bigint_t *seed, const ttak_bigint_t *sn, ttak_bigscript_value_t *out, ttak_bigscript_error_t *err, uint64_t now) {
+    if (!prog || !vm || prog->main_fn < 0) { set_err(err, TTAK_BIGSCRIPT_ERR_RUNTIME, "No main function"); return false; }
+    const function_t *f = &prog->functions[prog->main_fn];
+    if (f->frame_size > vm->regs_cap) { set_err(err, TTAK_BIGSCRIPT_ERR_LIMIT, "Frame too large"); return false; }
+    void *entry = jit_hot(prog, 1); uint64_t ws, wsn, wr;
+    if (entry && !vm->wregs) { vm->wregs = ttak_mem_alloc_raw(sizeof(uint64_t) * VM_REGS, __TTAK_UNSAFE_MEM_FOREVER__, now); }
+    if (entry && vm->wregs && ttak_bigint_export_u64(seed, &ws) && ttak_bigint_export_u64(sn, &wsn) &&
+        fast_run(prog, entry, vm->wregs, ws, wsn, &wr) == FAST_DONE) {
+        if (out) {
+            variant_init(&out->value, now);
+            if (!ttak_bigint_set_u64(&out->value.v.i, wr, now)) { variant_free(&out->value, now); set_err(err, TTAK_BIGSCRIPT_ERR_OOM, "Out of memory"); return false; }
+            out->is_found = wr != 0;
+        }
+        return true;
+    }
+    ttak_bigscript_variant_t *R = vm->regs;
+    if (!ttak_bigint_copy(variant_as_int(&R[0], now), seed, now) || !ttak_bigint_copy(variant_as_int(&R[1], now), sn, now)) {
+        set_err(err, TTAK_BIGSCRIPT_ERR_OOM, "Out of memory"); return false;
+    }
+    uint32_t depth_cap = (vm->limits.max_call_depth && vm->limits.max_call_depth < VM_FRAMES) ? vm->limits.max_call_depth : VM_FRAMES;
+    const uint32_t *code = prog->code; const constant_t *K = prog->constants;
+    uint32_t ip = f->start_ip, base = 0, depth = 0;
+
+    #define OPND(w) ((((w) & OPND_CONST) != 0) ? &K[(w) & ~OPND_CONST].value : (const ttak_bigscript_variant_t *)&R[(w)])
+    #define BOTH_INT(a, b) ((a)->type == TTAK_BIGSCRIPT_VAL_INT && (b)->type == TTAK_BIGSCRIPT_VAL_INT)
+    #define VM_OPERANDS() \
+        ttak_bigscript_variant_t *d = &R[code[ip]]; \
+        const ttak_bigscript_variant_t *a = OPND(code[ip + 1]), *b = OPND(code[ip + 2]); \
+        ip += 3
+#ifdef BIGSCRIPT_THREADED
+    static const void *const dispatch[OP_COUNT] = {
+        [OP_HALT] = &&op_HALT, [OP_MOVE] = &&op_MOVE,
+        [OP_ADD] = &&op_ADD, [OP_SUB] = &&op_SUB, [OP_MUL] = &&op_MUL, [OP_DIV] = &&op_DIV, [OP_MOD] = &&op_MOD,
+        [OP_EQ] = &&op_EQ, [OP_NEQ] = &&op_NEQ, [OP_LT] = &&op_LT, [OP_LE] = &&op_LE, [OP_GT] = &&op_GT, [OP_GE] = &&op_GE,
+        [OP_JMP] = &&op_JMP, [OP_JMP_IF_FALSE] = &&op_JMP_IF_FALSE, [OP_JCMP] = &&op_JCMP, [OP_RETURN] = &&op_RETURN,
+        [OP_CALL] = &&op_CALL, [OP_CALL_BUILTIN] = &&op_CALL_BUILTIN,
+    };
+    #define VM_CASE(name) op_##name:
+    #define VM_NEXT() goto *dispatch[code[ip++]]
+    VM_NEXT();
+#else
+    #define VM_CASE(name) case OP_##name:
+    #define VM_NEXT() continue
+    for (;;) switch ((opcode_t)code[ip++]) {
+#endif
+    #define VM_ARITH(name, call) VM_CASE(name) { \
+            VM_OPERANDS(); \
+            if (BOTH_INT(a, b)) { if (!(call)) goto fail_oom; } \
+            else if (!ttak_bigint_set_u64(variant_as_int(d, now), 0, now)) goto fail_oom; \
+            VM_NEXT(); \
+        }
+    #define VM_COMPARE(name, rel) VM_CASE(name) { \
+            VM_OPERANDS(); \
+            uint64_t t = BOTH_INT(a, b) && ttak_bigint_cmp(&a->v.i, &b->v.i) rel 0; \
+            if (!ttak_bigint_set_u64(variant_as_int(d, now), t, now)) goto fail_oom; \
+            VM_NEXT(); \
+        }
+    VM_CASE(MOVE) { ttak_bigscript_variant_t *d = &R[code[ip]]; const ttak_bigscript_variant_t *s = OPND(code[ip + 1]); ip += 2; if (!variant_copy(d, s, now)) goto fail_oom; VM_NEXT(); }
+    VM_CASE(ADD) {
+        VM_OPERANDS();
+        if (BOTH_INT(a, b)) { if (!ttak_bigint_add(variant_as_int(d, now), &a->v.i, &b->v.i, now)) goto fail_oom; }
+        else if (!vm_mixed_add(vm, d, a, b, now)) goto fail_oom;
+        VM_NEXT();
+    }
+    VM_ARITH(SUB, ttak_bigint_sub(variant_as_int(d, now), &a->v.i, &b->v.i, now))
+    VM_ARITH(MUL, ttak_bigint_mul(variant_as_int(d, now), &a->v.i, &b->v.i, now))
+    VM_CASE(DIV) {
+        VM_OPERANDS();
+        if (BOTH_INT(a, b)) {
+            if (ttak_bigint_is_zero(&b->v.i)) goto fail_div;
+            if (!ttak_bigint_div(variant_as_int(d, now), variant_as_int(&vm->scratch, now), &a->v.i, &b->v.i, now)) goto fail_oom;
+        } else if (!ttak_bigint_set_u64(variant_as_int(d, now), 0, now)) goto fail_oom;
+        VM_NEXT();
+    }
+    VM_CASE(MOD) {
+        VM_OPERANDS();
+        if (BOTH_INT(a, b)) {
+            if (ttak_bigint_is_zero(&b->v.i)) goto fail_div;
+            if (!ttak_bigint_mod(variant_as_int(d, now), &a->v.i, &b->v.i, now)) goto fail_oom;
+        } else if (!ttak_bigint_set_u64(variant_as_int(d, now), 0, now)) goto fail_oom;
+        VM_NEXT();
+    }
+    VM_COMPARE(EQ, ==)
+    VM_COMPARE(NEQ, !=)
+    VM_COMPARE(LT, <)
+    VM_COMPARE(LE, <=)
+    VM_COMPARE(GT, >)
+    VM_COMPARE(GE, >=)
+    VM_CASE(JMP) { ip = code[ip]; VM_NEXT(); }
+    VM_CASE(JMP_IF_FALSE) {
+        const ttak_bigscript_variant_t *c = OPND(code[ip]);
+        ip = (c->type == TTAK_BIGSCRIPT_VAL_INT && ttak_bigint_is_zero(&c->v.i)) ? code[ip + 1] : ip + 2;
+        VM_NEXT();
+    }
+    VM_CASE(JCMP) {
+        uint32_t mask = code[ip]; const ttak_bigscript_variant_t *a = OPND(code[ip + 1]), *b = OPND(code[ip + 2]);
+        ip = (BOTH_INT(a, b) && cmp_holds(mask, ttak_bigint_cmp(&a->v.i, &b->v.i))) ? ip + 4 : code[ip + 3];
+        VM_NEXT();
+    }
+    VM_CASE(RETURN) {
+        uint32_t s = code[ip];
+        if (depth == 0) {
+            if (out) {
+                variant_init(&out->value, now);
+                bool ok = true;
+                if (s & OPND_CONST) { ok = variant_copy(&out->value, OPND(s), now); }
+                else { variant_swap(&out->value, &R[s]); }
+                if (ok && out->value.type == TTAK_BIGSCRIPT_VAL_INT) out->is_found = !ttak_bigint_is_zero(&out->value.v.i);
+                else out->is_found = ok;
             }
-            case OP_POP: { vm->stack_top--; break; }
-            default: break;
+            return true;
+        }
+        /* The caller reads the result from the callee's register 0. */
+        if (s & OPND_CONST) { if (!variant_copy(&R[0], OPND(s), now)) goto fail_oom; }
+        else { variant_swap(&R[0], &R[s]); }
+        const frame_t *fr = &vm->frames[--depth];
+        ip = fr->ret_ip; base = fr->base; R = vm->regs + base;
+        VM_NEXT();
+    }
+    VM_CASE(CALL) {
+        const function_t *callee = &prog->functions[code[ip]]; uint32_t nb = base + code[ip + 1];
+        if (depth >= depth_cap || nb + callee->frame_size > vm->regs_cap) { set_err(err, TTAK_BIGSCRIPT_ERR_LIMIT, "Call depth exceeded"); return false; }
+        vm->frames[depth].ret_ip = ip + 2; vm->frames[depth].base = base; depth++;
+        base = nb; R = vm->regs + base; ip = callee->start_ip;
+        VM_NEXT();
+    }
+    VM_CASE(CALL_BUILTIN) {
+        uint32_t bi = code[ip], argc = code[ip + 1]; ttak_bigscript_variant_t *d = &R[code[ip + 2]];
+        const ttak_bigscript_variant_t *a0 = OPND(code[ip + 3]), *a1 = argc >= 2 ? OPND(code[ip + 4]) : NULL;
+        ip += 3 + argc;
+        if (!vm_builtin(vm, bi, argc, a0, a1, d, now)) goto fail_oom;
+        VM_NEXT();
+    }
+    VM_CASE(HALT) { set_err(err, TTAK_BIGSCRIPT_ERR_RUNTIME, "Fell off the end of a function"); return false; }
+#ifndef BIGSCRIPT_THREADED
+    }
+#endif
+    #undef VM_COMPARE
+    #undef VM_ARITH
+    #undef VM_NEXT
+    #undef VM_CASE
+    #undef VM_OPERANDS
+    #undef BOTH_INT
+    #undef OPND
+fail_div:
+    set_err(err, TTAK_BIGSCRIPT_ERR_MATH, "Division by zero"); return false;
+fail_oom:
+    set_err(err, TTAK_BIGSCRIPT_ERR_OOM, "Out of memory"); return false;
+}
+
+/* Seeds per ttak_bigscript_eval_batch() task. */
+#ifndef TTAK_BIGSCRIPT_BATCH_CHUNK
+#define TTAK_BIGSCRIPT_BATCH_CHUNK 256
+#endif
+
+typedef struct {
+    ttak_bigscript_program_t *prog;
+    const ttak_bigint_t *seeds;
+    const ttak_bigint_t *sns;
+    ttak_bigscript_value_t *outs;
+    ttak_bigscript_error_t *errs;
+    size_t count;
+    _Atomic bool failed;
+    uint64_t now;
+} batch_ctx_t;
+
+static void batch_chunk(void *arg, size_t index) {
+    batch_ctx_t *ctx = arg;
+    size_t lo = index * TTAK_BIGSCRIPT_BATCH_CHUNK, hi = lo + TTAK_BIGSCRIPT_BATCH_CHUNK;
+    if (hi > ctx->count) hi = ctx->count;
+    uint64_t now = ctx->now;
+    /* Inputs and results are unpacked into lane arrays first, so the interpreter loop touches no bigints. */
+    uint64_t seed[TTAK_BIGSCRIPT_BATCH_CHUNK], sn[TTAK_BIGSCRIPT_BATCH_CHUNK], res[TTAK_BIGSCRIPT_BATCH_CHUNK];
+    bool fast[TTAK_BIGSCRIPT_BATCH_CHUNK];
+    uint64_t *regs = ttak_mem_alloc_raw(sizeof(uint64_t) * VM_REGS, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    for (size_t i = lo; i < hi; i++) {
+        size_t k = i - lo;
+        fast[k] = regs && ttak_bigint_export_u64(&ctx->seeds[i], &seed[k]) && ttak_bigint_export_u64(&ctx->sns[i], &sn[k]);
+    }
+    void *entry = jit_hot(ctx->prog, hi - lo);
+    for (size_t k = 0; k < hi - lo; k++) {
+        if (fast[k]) fast[k] = fast_run(ctx->prog, entry, regs, seed[k], sn[k], &res[k]) == FAST_DONE;
+    }
+    ttak_mem_free(regs);
+
+    ttak_bigscript_vm_t *vm = NULL;
+    for (size_t i = lo; i < hi; i++) {
+        size_t k = i - lo;
+        ttak_bigscript_error_t local = { TTAK_BIGSCRIPT_ERR_NONE, NULL };
+        ttak_bigscript_error_t *err = ctx->errs ? &ctx->errs[i] : &local;
+        ttak_bigscript_value_t *out = &ctx->outs[i];
+        err->code = TTAK_BIGSCRIPT_ERR_NONE; err->message = NULL;
+        if (fast[k]) {
+            variant_init(&out->value, now);
+            if (ttak_bigint_set_u64(&out->value.v.i, res[k], now)) { out->is_found = res[k] != 0; continue; }
+            variant_free(&out->value, now);
+        }
+        if (!vm && !(vm = ttak_bigscript_vm_create(&ctx->prog->limits, now))) { set_err(err, TTAK_BIGSCRIPT_ERR_OOM, "Out of memory"); }
+        if (!vm || !ttak_bigscript_eval_seed(ctx->prog, vm, &ctx->seeds[i], &ctx->sns[i], out, err, now)) {
+            /* Failed seeds still hold a value the caller can free. */
+            variant_init(&out->value, now); out->is_found = false;
+            atomic_store_explicit(&ctx->failed, true, memory_order_relaxed);
+        }
+    }
+    ttak_bigscript_vm_free(vm, now);
+}
+
+bool ttak_bigscript_eval_batch(ttak_bigscript_program_t *prog, const ttak_bigint_t *seeds, const ttak_bigint_t *sns,
+                               size_t count, ttak_bigscript_value_t *outs, ttak_bigscript_error_t *errs,
+                               ttak_thread_pool_t *pool, uint64_t now) {
+    if (!prog || prog->main_fn < 0 || (count && (!seeds || !sns || !outs))) {
+        for (size_t i = 0; i < count; i++) {
+            if (outs) { variant_init(&outs[i].value, now); outs[i].is_found = false; }
+            if (errs) { errs[i].code = TTAK_BIGSCRIPT_ERR_RUNTIME; errs[i].message = "No main function"; }
+        }
+        return false;
+    }
+    batch_ctx_t ctx = { .prog = prog, .seeds = seeds, .sns = sns, .outs = outs, .errs = errs, .count = count, .now = now };
+    atomic_init(&ctx.failed, false);
+    ttak_factor_parallel_for(pool, (count + TTAK_BIGSCRIPT_BATCH_CHUNK - 1) / TTAK_BIGSCRIPT_BATCH_CHUNK, batch_chunk, &ctx, now);
+    return !atomic_load(&ctx.failed);
+}
+
+#define CACHE_BUCKETS 256u
+
+/*
+ * Program cache.  Entries hang off a fixed array of hash chains keyed by
+ * source hash; readers walk a chain under an epoch without locking, while
+ * inserts and evictions run under g_cache_lock.  An entry is linked in
+ * fully built and unlinked without touching its own next pointer, so a
+ * reader standing on it can always finish its walk.  The cache owns one
+ * reference per entry and hands it back through ttak_epoch_retire(), so a
+ * reader that found a program can still take its own reference.  Past
+ * TTAK_BIGSCRIPT_CACHE_MAX entries, a miss evicts the entry whose last hit
+ * is oldest, which keeps hot reloads from accumulating dead programs.
+ */
+typedef struct cache_entry {
+    char sha[65];
+    ttak_bigscript_limits_t limits;
+    ttak_bigscript_program_t *prog;
+    _Atomic uint64_t last_use;                 /* Timestamp of the latest hit. */
+    struct cache_entry *_Atomic next;
+} cache_entry_t;
+
+static cache_entry_t *_Atomic g_cache_buckets[CACHE_BUCKETS];
+static size_t g_cache_count;                   /* Guarded by g_cache_lock. */
+static pthread_mutex_t g_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static char g_cache_dir[1024];
+
+#define CACHE_MAGIC 0x43534254u   /* "TBSC" */
+#define CACHE_VERSION 1u
+#define CACHE_FILE_MAX (16u << 20)
+
+/* The key is a SHA-256 in hex, so its leading digits are already uniform. */
+static size_t cache_bucket(const char sha[65]) {
+    size_t h = 0;
+    for (int i = 0; i < 8; i++) { h = (h << 4) | (size_t)(isdigit((unsigned char)sha[i]) ? sha[i] - '0' : (sha[i] | 0x20) - 'a' + 10); }
+    return h & (CACHE_BUCKETS - 1);
+}
+
+static cache_entry_t *cache_find(const char sha[65], const ttak_bigscript_limits_t *limits) {
+    for (cache_entry_t *e = atomic_load_explicit(&g_cache_buckets[cache_bucket(sha)], memory_order_acquire); e;
+         e = atomic_load_explicit(&e->next, memory_order_acquire)) {
+        if (memcmp(e->sha, sha, 64) == 0 && memcmp(&e->limits, limits, sizeof(*limits)) == 0) { return e; }
+    }
+    return NULL;
+}
+
+static void cache_entry_release(void *ptr) {
+    cache_entry_t *e = ptr;
+    ttak_bigscript_program_free(e->prog, 0);
+    ttak_mem_free(e);
+}
+
+/* Unlinks @p victim from its chain and retires it; the caller holds g_cache_lock. */
+static bool cache_unlink(cache_entry_t *victim) {
+    cache_entry_t *_Atomic *link = &g_cache_buckets[cache_bucket(victim->sha)];
+    for (cache_entry_t *e; (e = atomic_load_explicit(link, memory_order_relaxed)) != NULL; link = &e->next) {
+        if (e == victim) {
+            atomic_store_explicit(link, atomic_load_explicit(&victim->next, memory_order_relaxed), memory_order_release);
+            g_cache_count--;
+            ttak_epoch_retire(victim, cache_entry_release);
+            return true;
         }
     }
     return false;
 }
+
+/* Evicts the least recently hit entry; the caller holds g_cache_lock. */
+static bool cache_evict_one(void) {
+    cache_entry_t *victim = NULL; uint64_t oldest = UINT64_MAX;
+    for (size_t b = 0; b < CACHE_BUCKETS; b++) {
+        for (cache_entry_t *e = atomic_load_explicit(&g_cache_buckets[b], memory_order_relaxed); e;
+             e = atomic_load_explicit(&e->next, memory_order_relaxed)) {
+            uint64_t t = atomic_load_explicit(&e->last_use, memory_order_relaxed);
+            if (!victim || t < oldest) { victim = e; oldest = t; }
+        }
+    }
+    return victim && cache_unlink(victim);
+}
+
+static void cache_path(char *out, size_t cap, const char sha[65]) { snprintf(out, cap, "%s/%s.tbc", g_cache_dir, sha); }
+
+typedef struct { uint8_t *buf; size_t len, cap; bool ok; } wbuf_t;
+
+static void wbuf_put(wbuf_t *w, const void *src, size_t n) {
+    if (!w->ok) { return; }
+    if (w->len + n > w->cap) {
+        size_t cap = w->cap ? w->cap * 2 : 4096; while (cap < w->len + n) { cap *= 2; }
+        uint8_t *nb = realloc(w->buf, cap); if (!nb) { w->ok = false; return; }
+        w->buf = nb; w->cap = cap;
+    }
+    memcpy(w->buf + w->len, src, n); w->len += n;
+}
+
+static void wbuf_u32(wbuf_t *w, uint32_t v) { wbuf_put(w, &v, sizeof(v)); }
+
+/*
+ * File layout, host byte order: magic, version, limb bits, limits, source
+ * hash, code, functions, then each constant as sign, limb count and limbs,
+ * followed by the SHA-256 of everything before it.  Files are written to a
+ * temporary name and renamed, so readers never see a partial file.
+ */
+static void cache_save(const ttak_bigscript_program_t *prog) {
+    wbuf_t w = { NULL, 0, 0, true };
+    wbuf_u32(&w, CACHE_MAGIC); wbuf_u32(&w, CACHE_VERSION); wbuf_u32(&w, (uint32_t)(sizeof(limb_t) * 8));
+    wbuf_put(&w, &prog->limits, sizeof(prog->limits)); wbuf_put(&w, prog->source_sha256, 64);
+    wbuf_u32(&w, prog->code_len); wbuf_put(&w, prog->code, sizeof(uint32_t) * prog->code_len);
+    wbuf_u32(&w, prog->functions_len); wbuf_put(&w, prog->functions, sizeof(function_t) * prog->functions_len);
+    wbuf_u32(&w, prog->constants_len);
+    for (uint32_t i = 0; i < prog->constants_len; i++) {
+        const ttak_bigscript_variant_t *v = &prog->constants[i].value;
+        /* The compiler only produces integer constants. */
+        if (v->type != TTAK_BIGSCRIPT_VAL_INT) { w.ok = false; break; }
+        uint8_t neg = v->v.i.is_negative; uint32_t used = (uint32_t)v->v.i.used;
+        wbuf_put(&w, &neg, 1); wbuf_u32(&w, used); wbuf_put(&w, ttak_bigint_limbs(&v->v.i), sizeof(limb_t) * used);
+    }
+    if (w.ok) {
+        SHA256_CTX ctx; uint8_t d[32]; sha256_init(&ctx); sha256_update(&ctx, w.buf, w.len); sha256_final(&ctx, d);
+        wbuf_put(&w, d, sizeof(d));
+    }
+    char path[1100], tmp[1120];
+    cache_path(path, sizeof(path), prog->source_sha256);
+    snprintf(tmp, sizeof(tmp), "%s.%lu.tmp", path, (unsigned long)pthread_self());
+    FILE *fp = w.ok ? fopen(tmp, "wb") : NULL;
+    if (fp) {
+        bool ok = fwrite(w.buf, 1, w.len, fp) == w.len;
+        ok = (fclose(fp) == 0) && ok;
+        if (!ok || rename(tmp, path) != 0) { remove(tmp); }
+    }
+    free(w.buf);
+}
+
+typedef struct { const uint8_t *p; size_t left; } rbuf_t;
+
+static bool rbuf_get(rbuf_t *r, void *dst, size_t n) {
+    if (n > r->left) { return false; }
+    memcpy(dst, r->p, n); r->p += n; r->left -= n; return true;
+}
+
+/* Returns NULL for a missing, stale or damaged file; the caller then compiles. */
+static ttak_bigscript_program_t *cache_load(const char sha[65], const ttak_bigscript_limits_t *limits, uint64_t now) {
+    char path[1100]; cache_path(path, sizeof(path), sha);
+    FILE *fp = fopen(path, "rb");
+    if (!fp) { return NULL; }
+    uint8_t *buf = NULL; long sz = -1;
+    if (fseek(fp, 0, SEEK_END) == 0) { sz = ftell(fp); }
+    if (sz > 32 && sz <= (long)CACHE_FILE_MAX && fseek(fp, 0, SEEK_SET) == 0 && (buf = malloc((size_t)sz)) && fread(buf, 1, (size_t)sz, fp) != (size_t)sz) { free(buf); buf = NULL; }
+    fclose(fp);
+    if (!buf) { return NULL; }
+
+    ttak_bigscript_program_t *prog = NULL;
+    SHA256_CTX ctx; uint8_t d[32]; sha256_init(&ctx); sha256_update(&ctx, buf, (size_t)sz - 32); sha256_final(&ctx, d);
+    rbuf_t r = { buf, (size_t)sz - 32 };
+    uint32_t magic = 0, version = 0, limb_bits = 0; ttak_bigscript_limits_t lim; char fsha[64];
+    if (memcmp(d, buf + sz - 32, 32) != 0 || !rbuf_get(&r, &magic, 4) || !rbuf_get(&r, &version, 4) || !rbuf_get(&r, &limb_bits, 4) ||
+        magic != CACHE_MAGIC || version != CACHE_VERSION || limb_bits != sizeof(limb_t) * 8 ||
+        !rbuf_get(&r, &lim, sizeof(lim)) || memcmp(&lim, limits, sizeof(lim)) != 0 ||
+        !rbuf_get(&r, fsha, 64) || memcmp(fsha, sha, 64) != 0) {
+        goto out;
+    }
+    prog = (ttak_bigscript_program_t*)ttak_mem_alloc_raw(sizeof(ttak_bigscript_program_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!prog) { goto out; }
+    memset(prog, 0, sizeof(*prog)); atomic_init(&prog->refs, 1);
+    prog->limits = lim; memcpy(prog->source_sha256, sha, 64);
+    bool ok = rbuf_get(&r, &prog->code_len, 4) && prog->code_len <= MAX_CODE && rbuf_get(&r, prog->code, sizeof(uint32_t) * prog->code_len) &&
+              rbuf_get(&r, &prog->functions_len, 4) && prog->functions_len <= MAX_FUNCTIONS &&
+              rbuf_get(&r, prog->functions, sizeof(function_t) * prog->functions_len);
+    uint32_t nconst = 0;
+    ok = ok && rbuf_get(&r, &nconst, 4) && nconst <= MAX_CONSTANTS;
+    limb_t *limbs = NULL;
+    for (uint32_t i = 0; ok && i < nconst; i++) {
+        uint8_t neg = 0; uint32_t used = 0;
+        ok = rbuf_get(&r, &neg, 1) && rbuf_get(&r, &used, 4) && (size_t)used * sizeof(limb_t) <= r.left;
+        if (!ok) { break; }
+        /* Limbs sit at any offset in the file, so copy them out before use. */
+        if (used) {
+            limb_t *nl = realloc(limbs, sizeof(limb_t) * used);
+            if (!nl) { ok = false; break; }
+            limbs = nl;
+            rbuf_get(&r, limbs, sizeof(limb_t) * used);
+        }
+        ttak_bigscript_variant_t *v = &prog->constants[i].value;
+        variant_init(v, now); prog->constants_len = i + 1;
+        ok = ttak_bigint_set_limbs(&v->v.i, used ? limbs : &(limb_t){0}, used, now);
+        v->v.i.is_negative = neg != 0 && !ttak_bigint_is_zero(&v->v.i);
+    }
+    free(limbs);
+    /* The checksum only catches damage; whoever can write the file can forge it. */
+    if (!ok || r.left != 0 || !program_verify(prog)) { ttak_bigscript_program_free(prog, now); prog = NULL; goto out; }
+    program_finish(prog);
+out:
+    free(buf);
+    return prog;
+}
+
+bool ttak_bigscript_cache_set_dir(const char *dir) {
+    if (dir && strlen(dir) >= sizeof(g_cache_dir)) { return false; }
+    pthread_mutex_lock(&g_cache_lock);
+    if (dir) { strcpy(g_cache_dir, dir); } else { g_cache_dir[0] = '\0'; }
+    pthread_mutex_unlock(&g_cache_lock);
+    return true;
+}
+
+ttak_bigscript_program_t *ttak_bigscript_compile_cached(const char *source, ttak_bigscript_loader_t *loader, const ttak_bigscript_limits_t *limits, ttak_bigscript_error_t *err, uint64_t now) {
+    if (!source) { return ttak_bigscript_compile(source, loader, limits, err, now); }
+    ttak_bigscript_limits_t lim; memset(&lim, 0, sizeof(lim)); if (limits) { lim = *limits; }
+    char sha[65]; source_hash(source, sha);
+
+    ttak_epoch_enter();
+    cache_entry_t *e = cache_find(sha, &lim);
+    ttak_bigscript_program_t *prog = NULL;
+    if (e) {
+        prog = e->prog; atomic_fetch_add_explicit(&prog->refs, 1, memory_order_relaxed);
+        /* Skip the store when the stamp is current, so hot entries stay shared in every cache. */
+        if (atomic_load_explicit(&e->last_use, memory_order_relaxed) != now) { atomic_store_explicit(&e->last_use, now, memory_order_relaxed); }
+    }
+    ttak_epoch_exit();
+    if (prog) { return prog; }
+
+    /* Compiling under the lock keeps concurrent misses on one script to one compile. */
+    pthread_mutex_lock(&g_cache_lock);
+    if ((e = cache_find(sha, &lim)) != NULL) {
+        prog = e->prog; atomic_fetch_add_explicit(&prog->refs, 1, memory_order_relaxed);
+        pthread_mutex_unlock(&g_cache_lock);
+        return prog;
+    }
+    bool on_disk = g_cache_dir[0] != '\0', loaded = false;
+    if (on_disk) { loaded = (prog = cache_load(sha, &lim, now)) != NULL; }
+    if (!prog) { prog = ttak_bigscript_compile(source, loader, &lim, err, now); }
+    if (!prog) { pthread_mutex_unlock(&g_cache_lock); return NULL; }
+    if (on_disk && !loaded) { cache_save(prog); }
+
+    e = ttak_mem_alloc_raw(sizeof(*e), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (e) {
+        memcpy(e->sha, sha, sizeof(e->sha)); e->limits = lim; e->prog = prog;
+        atomic_init(&e->last_use, now);
+        atomic_fetch_add_explicit(&prog->refs, 1, memory_order_relaxed);
+        while (g_cache_count >= TTAK_BIGSCRIPT_CACHE_MAX && cache_evict_one()) {}
+        cache_entry_t *_Atomic *head = &g_cache_buckets[cache_bucket(sha)];
+        atomic_init(&e->next, atomic_load_explicit(head, memory_order_relaxed));
+        atomic_store_explicit(head, e, memory_order_release);
+        g_cache_count++;
+    }
+    pthread_mutex_unlock(&g_cache_lock);
+    return prog;
+}
+
+void ttak_bigscript_cache_clear(void) {
+    pthread_mutex_lock(&g_cache_lock);
+    for (size_t b = 0; b < CACHE_BUCKETS; b++) {
+        /* Detached chains keep their links until the grace period ends. */
+        cache_entry_t *e = atomic_exchange_explicit(&g_cache_buckets[b], NULL, memory_order_acq_rel);
+        while (e) {
+            cache_entry_t *next = atomic_load_explicit(&e->next, memory_order_relaxed);
+            ttak_epoch_retire(e, cache_entry_release);
+            e = next;
+        }
+    }
+    g_cache_count = 0;
+    pthread_mutex_unlock(&g_cache_lock);
+}
@@ -13,10 +13,15 @@
  * Notes:
  *  - This code assumes ctx->hw_state.aes.round_keys stores 15 round keys for AES-256:
  *    rk[0..14], each 16 bytes (total 240 bytes).
- *  - This code performs GHASH in software. (You can later add CLMUL/PMULL/VSX paths.)
+ *  - GHASH uses PCLMULQDQ or PMULL when exposed, with the powers H^1..H^8 (H^16
+ *    with AVX-512) precomputed so a run of blocks costs one reduction; the
+ *    software fallback uses 4-bit Shoup tables.
+ *  - AES-CTR keeps 8 blocks (16 with VAES) in flight so the round latency
+ *    overlaps across independent counters.
  */
 
 #include <ttak/security/security_engine.h>
+#include "../../internal/ttak/key_schedule.h"
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -58,6 +63,25 @@
 #  define TTAK_USE_ARM64_CRYPTO 0
 #endif
 
+/*
+ * x86_64 carry-less multiply for GHASH: PCLMULQDQ plus SSSE3 for the byte
+ * reversal. The AVX-512 path additionally needs VAES and VPCLMULQDQ to run
+ * four blocks per instruction, and AVX512BW for the byte shuffles.
+ */
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(__PCLMUL__) && defined(__SSSE3__)
+#  include <immintrin.h>
+#  define TTAK_USE_X86_CLMUL 1
+#else
+#  define TTAK_USE_X86_CLMUL 0
+#endif
+
+#if TTAK_USE_X86_AESNI && TTAK_USE_X86_CLMUL && defined(__VAES__) && defined(__VPCLMULQDQ__) && \
+    defined(__AVX512F__) && defined(__AVX512BW__)
+#  define TTAK_USE_X86_VAES512 1
+#else
+#  define TTAK_USE_X86_VAES512 0
+#endif
+
 /* You can extend with PPC VSX AES, MIPS, RISC-V Zk* later. */
 #define TTAK_USE_PPC64LE_VSX 0
 #define TTAK_USE_MIPS64_MSA  0
@@ -98,16 +122,17 @@ static inline uint32_t ttak_bswap32(uint32_t v) {
 #endif
 }
 
-/* --- GHASH (soft) --- */
+/* --- GHASH --- */
 
 /**
- * @brief XOR 16 bytes: dst ^= src
- * @param dst 16-byte destination buffer.
- * @param src 16-byte source buffer.
+ * @def TTAK_GHASH_POWERS
+ * @brief Powers of H kept per key: the widest run aggregated into one reduction.
  */
-static inline void ttak_xor16(uint8_t dst[16], const uint8_t src[16]) {
-    for (int i = 0; i < 16; i++) dst[i] ^= src[i];
-}
+#if TTAK_USE_X86_VAES512
+#  define TTAK_GHASH_POWERS 16u
+#else
+#  define TTAK_GHASH_POWERS 8u
+#endif
 
 /**
  * @brief Load 64-bit big-endian from buffer (unaligned-safe).
@@ -135,48 +160,308 @@ static inline void ttak_store_be64(uint8_t *p, uint64_t v) {
     memcpy(p, &v, sizeof(v));
 }
 
+#if TTAK_USE_X86_CLMUL
+
+/*
+ * Blocks are byte-reversed on load, which turns GCM's reflected bit order
+ * into the layout PCLMULQDQ multiplies; the 256-bit product is shifted left
+ * by one and reduced modulo x^128 + x^7 + x^2 + x + 1 as in Gueron and
+ * Kounavis, "Intel Carry-Less Multiplication Instruction and its Usage for
+ * Computing the GCM Mode". Shift and reduction are linear, so a run of
+ * products is summed unreduced and reduced once.
+ */
+
 /**
- * @brief GHASH multiply (Y := (Y xor X) * H) in GF(2^128), software fallback.
- *
- * This is a bitwise reference implementation. It is correct but not fast.
- * You can add CLMUL/PMULL/VSX accelerated variants later.
+ * @brief GHASH key: H^1..H^TTAK_GHASH_POWERS, byte-reversed.
+ */
+typedef struct {
+    __m128i h[TTAK_GHASH_POWERS]; /**< h[i] = H^(i + 1). */
+#if TTAK_USE_X86_VAES512
+    __m512i hz[4];                /**< hz[k] lanes hold H^(16 - 4k) .. H^(13 - 4k). */
+#endif
+} ttak_ghash_key_t;
+
+static inline __m128i ttak_ghash_bswap(__m128i v) {
+    return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+/**
+ * @brief Accumulate the unreduced product a * b into lo, mid and hi.
+ */
+static inline void ttak_ghash_clmul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *mid, __m128i *hi) {
+    *lo  = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+    *hi  = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+    *mid = _mm_xor_si128(*mid, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x01),
+                                             _mm_clmulepi64_si128(a, b, 0x10)));
+}
+
+/**
+ * @brief Reduce a summed product back to one field element.
+ */
+static inline __m128i ttak_ghash_clmul_reduce(__m128i lo, __m128i mid, __m128i hi) {
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    /* Shift hi:lo left by one bit. */
+    __m128i lo_carry = _mm_srli_epi32(lo, 31);
+    __m128i hi_carry = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    __m128i cross = _mm_srli_si128(lo_carry, 12);
+    hi_carry = _mm_slli_si128(hi_carry, 4);
+    lo_carry = _mm_slli_si128(lo_carry, 4);
+    lo = _mm_or_si128(lo, lo_carry);
+    hi = _mm_or_si128(_mm_or_si128(hi, hi_carry), cross);
+
+    /* Fold lo into hi. */
+    __m128i a = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    __m128i a_hi = _mm_srli_si128(a, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(a, 12));
+    __m128i b = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    b = _mm_xor_si128(b, a_hi);
+    lo = _mm_xor_si128(lo, b);
+    return _mm_xor_si128(hi, lo);
+}
+
+static inline __m128i ttak_ghash_clmul_mul(__m128i a, __m128i b) {
+    __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+    ttak_ghash_clmul_acc(a, b, &lo, &mid, &hi);
+    return ttak_ghash_clmul_reduce(lo, mid, hi);
+}
+
+#if TTAK_USE_X86_VAES512
+static inline __m512i ttak_ghash_bswap512(__m512i v) {
+    const __m512i mask = _mm512_broadcast_i32x4(_mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    return _mm512_shuffle_epi8(v, mask);
+}
+
+/** @brief XOR of the four 128-bit lanes of @p v. */
+static inline __m128i ttak_ghash_fold512(__m512i v) {
+    __m256i t = _mm256_xor_si256(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1));
+    return _mm_xor_si128(_mm256_castsi256_si128(t), _mm256_extracti128_si256(t, 1));
+}
+#endif
+
+static void ttak_ghash_init(ttak_ghash_key_t *key, const uint8_t h_raw[16]) {
+    __m128i h = ttak_ghash_bswap(_mm_loadu_si128((const __m128i *)h_raw));
+    key->h[0] = h;
+    for (unsigned i = 1; i < TTAK_GHASH_POWERS; i++) {
+        key->h[i] = ttak_ghash_clmul_mul(key->h[i - 1], h);
+    }
+#if TTAK_USE_X86_VAES512
+    for (unsigned k = 0; k < 4; k++) {
+        __m128i lanes[4] = { key->h[15 - 4 * k], key->h[14 - 4 * k], key->h[13 - 4 * k], key->h[12 - 4 * k] };
+        key->hz[k] = _mm512_loadu_si512((const void *)lanes);
+    }
+#endif
+}
+
+/**
+ * @brief Absorb @p blocks 16-byte blocks into the accumulator Y.
  *
- * @param y_acc 16-byte accumulator Y (updated in place).
- * @param h_key 16-byte hash subkey H.
- * @param x_in  16-byte input block X.
- */
-static void ttak_ghash_update_soft(uint8_t y_acc[16], const uint8_t h_key[16], const uint8_t x_in[16]) {
-    /* Y <- Y xor X */
-    ttak_xor16(y_acc, x_in);
-
-    /* Interpret as two 64-bit big-endian words for the classic bitwise algorithm. */
-    uint64_t v0 = ttak_load_be64(h_key + 0);
-    uint64_t v1 = ttak_load_be64(h_key + 8);
-
-    uint64_t z0 = 0, z1 = 0;
-
-    /* Process 128 bits of Y (big-endian bit order). */
-    for (int i = 0; i < 128; i++) {
-        const uint8_t byte = y_acc[i >> 3];
-        const uint8_t mask = (uint8_t)(1u << (7 - (i & 7)));
-        if (byte & mask) {
-            z0 ^= v0;
-            z1 ^= v1;
+ * Eight blocks X1..X8 fold in as (Y ^ X1) H^8 ^ X2 H^7 ^ ... ^ X8 H, with
+ * one reduction for the run; sixteen at a time under AVX-512.
+ */
+static void ttak_ghash_blocks(const ttak_ghash_key_t *key, uint8_t y_acc[16], const uint8_t *data, size_t blocks) {
+    __m128i y = ttak_ghash_bswap(_mm_loadu_si128((const __m128i *)y_acc));
+
+#if TTAK_USE_X86_VAES512
+    for (; blocks >= 16; blocks -= 16, data += 256) {
+        __m512i lo = _mm512_setzero_si512(), mid = _mm512_setzero_si512(), hi = _mm512_setzero_si512();
+        for (unsigned k = 0; k < 4; k++) {
+            __m512i d = ttak_ghash_bswap512(_mm512_loadu_si512((const void *)(data + 64 * k)));
+            if (k == 0) d = _mm512_xor_si512(d, _mm512_zextsi128_si512(y));
+            lo  = _mm512_xor_si512(lo, _mm512_clmulepi64_epi128(d, key->hz[k], 0x00));
+            hi  = _mm512_xor_si512(hi, _mm512_clmulepi64_epi128(d, key->hz[k], 0x11));
+            mid = _mm512_xor_si512(mid, _mm512_xor_si512(_mm512_clmulepi64_epi128(d, key->hz[k], 0x01),
+                                                         _mm512_clmulepi64_epi128(d, key->hz[k], 0x10)));
+        }
+        y = ttak_ghash_clmul_reduce(ttak_ghash_fold512(lo), ttak_ghash_fold512(mid), ttak_ghash_fold512(hi));
+    }
+#endif
+
+    for (; blocks >= 8; blocks -= 8, data += 128) {
+        __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+        for (unsigned j = 0; j < 8; j++) {
+            __m128i x = ttak_ghash_bswap(_mm_loadu_si128((const __m128i *)(data + 16 * j)));
+            if (j == 0) x = _mm_xor_si128(x, y);
+            ttak_ghash_clmul_acc(x, key->h[7 - j], &lo, &mid, &hi);
         }
+        y = ttak_ghash_clmul_reduce(lo, mid, hi);
+    }
+
+    for (; blocks > 0; blocks--, data += 16) {
+        __m128i x = ttak_ghash_bswap(_mm_loadu_si128((const __m128i *)data));
+        y = ttak_ghash_clmul_mul(_mm_xor_si128(y, x), key->h[0]);
+    }
+
+    _mm_storeu_si128((__m128i *)y_acc, ttak_ghash_bswap(y));
+}
+
+#elif TTAK_USE_ARM64_CRYPTO
+
+/*
+ * Reversing the bits of each byte maps GCM's reflected order onto plain
+ * polynomial order in a little-endian 128-bit lane, so PMULL multiplies
+ * directly and the high half folds back through x^128 = x^7 + x^2 + x + 1
+ * (0x87). As on x86, a run of products is summed and reduced once.
+ */
+
+/**
+ * @brief GHASH key: H^1..H^TTAK_GHASH_POWERS, bit-reversed per byte.
+ */
+typedef struct {
+    uint64x2_t h[TTAK_GHASH_POWERS]; /**< h[i] = H^(i + 1). */
+} ttak_ghash_key_t;
+
+static inline uint64x2_t ttak_ghash_load(const uint8_t *p) {
+    return vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(p)));
+}
+
+static inline void ttak_ghash_store(uint8_t *p, uint64x2_t v) {
+    vst1q_u8(p, vrbitq_u8(vreinterpretq_u8_u64(v)));
+}
+
+static inline uint64x2_t ttak_ghash_pmull(uint64_t a, uint64_t b) {
+    return vreinterpretq_u64_p128(vmull_p64((poly64_t)a, (poly64_t)b));
+}
+
+static inline void ttak_ghash_pmull_acc(uint64x2_t a, uint64x2_t b, uint64x2_t *lo, uint64x2_t *mid, uint64x2_t *hi) {
+    const uint64_t a0 = vgetq_lane_u64(a, 0), a1 = vgetq_lane_u64(a, 1);
+    const uint64_t b0 = vgetq_lane_u64(b, 0), b1 = vgetq_lane_u64(b, 1);
+    *lo  = veorq_u64(*lo, ttak_ghash_pmull(a0, b0));
+    *hi  = veorq_u64(*hi, ttak_ghash_pmull(a1, b1));
+    *mid = veorq_u64(*mid, veorq_u64(ttak_ghash_pmull(a0, b1), ttak_ghash_pmull(a1, b0)));
+}
+
+static inline uint64x2_t ttak_ghash_pmull_reduce(uint64x2_t lo, uint64x2_t mid, uint64x2_t hi) {
+    const uint64x2_t zero = vdupq_n_u64(0);
+    /* 256-bit product as words r0..r3: lo = {r0, r1}, hi = {r2, r3}. */
+    lo = veorq_u64(lo, vextq_u64(zero, mid, 1));
+    hi = veorq_u64(hi, vextq_u64(mid, zero, 1));
+    /* r3 x^192 = r3 0x87 x^64, landing in r1 and r2. */
+    uint64x2_t t = ttak_ghash_pmull(vgetq_lane_u64(hi, 1), 0x87u);
+    lo = veorq_u64(lo, vextq_u64(zero, t, 1));
+    hi = veorq_u64(hi, vextq_u64(t, zero, 1));
+    /* r2 x^128 = r2 0x87, landing in r0 and r1. */
+    return veorq_u64(lo, ttak_ghash_pmull(vgetq_lane_u64(hi, 0), 0x87u));
+}
+
+static inline uint64x2_t ttak_ghash_pmull_mul(uint64x2_t a, uint64x2_t b) {
+    uint64x2_t lo = vdupq_n_u64(0), mid = vdupq_n_u64(0), hi = vdupq_n_u64(0);
+    ttak_ghash_pmull_acc(a, b, &lo, &mid, &hi);
+    return ttak_ghash_pmull_reduce(lo, mid, hi);
+}
+
+static void ttak_ghash_init(ttak_ghash_key_t *key, const uint8_t h_raw[16]) {
+    uint64x2_t h = ttak_ghash_load(h_raw);
+    key->h[0] = h;
+    for (unsigned i = 1; i < TTAK_GHASH_POWERS; i++) {
+        key->h[i] = ttak_ghash_pmull_mul(key->h[i - 1], h);
+    }
+}
 
-        /* Shift V right by 1 and reduce with R = 0xE1... when LSB was 1. */
-        const uint64_t lsb = (v1 & 1u);
-        v1 = (v1 >> 1) | (v0 << 63);
-        v0 = (v0 >> 1);
-        if (lsb) {
-            v0 ^= 0xE100000000000000ULL;
+/**
+ * @brief Absorb @p blocks 16-byte blocks into the accumulator Y, eight per reduction.
+ */
+static void ttak_ghash_blocks(const ttak_ghash_key_t *key, uint8_t y_acc[16], const uint8_t *data, size_t blocks) {
+    uint64x2_t y = ttak_ghash_load(y_acc);
+
+    for (; blocks >= 8; blocks -= 8, data += 128) {
+        uint64x2_t lo = vdupq_n_u64(0), mid = vdupq_n_u64(0), hi = vdupq_n_u64(0);
+        for (unsigned j = 0; j < 8; j++) {
+            uint64x2_t x = ttak_ghash_load(data + 16 * j);
+            if (j == 0) x = veorq_u64(x, y);
+            ttak_ghash_pmull_acc(x, key->h[7 - j], &lo, &mid, &hi);
         }
+        y = ttak_ghash_pmull_reduce(lo, mid, hi);
     }
 
-    ttak_store_be64(y_acc + 0, z0);
-    ttak_store_be64(y_acc + 8, z1);
+    for (; blocks > 0; blocks--, data += 16) {
+        y = ttak_ghash_pmull_mul(veorq_u64(y, ttak_ghash_load(data)), key->h[0]);
+    }
+
+    ttak_ghash_store(y_acc, y);
+}
+
+#else
+
+/*
+ * Shoup's 4-bit tables: hh/hl[i] hold the 16 multiples of H by a nibble, so
+ * a block costs 32 table lookups instead of 128 conditional shifts.
+ */
+
+/**
+ * @brief GHASH key: nibble multiples of H as big-endian halves.
+ */
+typedef struct {
+    uint64_t hh[16]; /**< High 64 bits of i * H. */
+    uint64_t hl[16]; /**< Low 64 bits of i * H. */
+} ttak_ghash_key_t;
+
+/** @brief Reduction of the four bits shifted out of the low end, pre-shifted by 48. */
+static const uint64_t ttak_ghash_last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+static void ttak_ghash_init(ttak_ghash_key_t *key, const uint8_t h_raw[16]) {
+    uint64_t vh = ttak_load_be64(h_raw + 0);
+    uint64_t vl = ttak_load_be64(h_raw + 8);
+
+    /* Index 8 is H itself (the nibble's top bit is x^0); 4, 2, 1 are H x, H x^2, H x^3. */
+    key->hh[8] = vh;
+    key->hl[8] = vl;
+    for (unsigned i = 4; i > 0; i >>= 1) {
+        const uint64_t t = (vl & 1u) ? 0xE100000000000000ULL : 0;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ t;
+        key->hh[i] = vh;
+        key->hl[i] = vl;
+    }
+    key->hh[0] = 0;
+    key->hl[0] = 0;
+    for (unsigned i = 2; i <= 8; i *= 2) {
+        for (unsigned j = 1; j < i; j++) {
+            key->hh[i + j] = key->hh[i] ^ key->hh[j];
+            key->hl[i + j] = key->hl[i] ^ key->hl[j];
+        }
+    }
 }
 
+/**
+ * @brief Y := Y * H, consuming Y a nibble at a time from the last byte.
+ */
+static void ttak_ghash_mul_table(const ttak_ghash_key_t *key, uint8_t y[16]) {
+    uint64_t zh = 0, zl = 0;
+    for (int i = 15; i >= 0; i--) {
+        const uint8_t nib[2] = { (uint8_t)(y[i] & 0x0Fu), (uint8_t)(y[i] >> 4) };
+        for (int k = 0; k < 2; k++) {
+            if (i != 15 || k != 0) {
+                const unsigned rem = (unsigned)(zl & 0x0Fu);
+                zl = (zh << 60) | (zl >> 4);
+                zh = (zh >> 4) ^ (ttak_ghash_last4[rem] << 48);
+            }
+            zh ^= key->hh[nib[k]];
+            zl ^= key->hl[nib[k]];
+        }
+    }
+    ttak_store_be64(y + 0, zh);
+    ttak_store_be64(y + 8, zl);
+}
+
+/**
+ * @brief Absorb @p blocks 16-byte blocks into the accumulator Y.
+ */
+static void ttak_ghash_blocks(const ttak_ghash_key_t *key, uint8_t y_acc[16], const uint8_t *data, size_t blocks) {
+    for (; blocks > 0; blocks--, data += 16) {
+        for (int i = 0; i < 16; i++) y_acc[i] ^= data[i];
+        ttak_ghash_mul_table(key, y_acc);
+    }
+}
+
+#endif
+
 /* --- Portable AES-256 fallback --- */
 
 /**
@@ -272,14 +557,12 @@ static inline void ttak_aes_addroundkey(uint8_t s[16], const uint8_t rk[16]) {
 /**
  * @brief Encrypt one AES-256 block using portable software rounds.
  *
- * This function expects pre-expanded round keys in ctx->hw_state.aes.round_keys.
- *
- * @param out 16-byte output.
- * @param in  16-byte input.
- * @param ctx Crypto context containing round keys.
+ * @param out        16-byte output.
+ * @param in         16-byte input.
+ * @param round_keys The 15 pre-expanded round keys.
  */
-static void ttak_aes256_enc_block_soft(uint8_t out[16], const uint8_t in[16], const ttak_crypto_ctx_t *ctx) {
-    const uint8_t *rk = (const uint8_t *)ctx->hw_state.aes.round_keys;
+static void ttak_aes256_enc_block_soft(uint8_t out[16], const uint8_t in[16], const uint8_t (*round_keys)[16]) {
+    const uint8_t *rk = round_keys[0];
 
     uint8_t s[16];
     memcpy(s, in, 16);
@@ -311,13 +594,13 @@ static void ttak_aes256_enc_block_soft(uint8_t out[16], const uint8_t in[16], co
  * This is a compile-time selection. If intrinsics are not available/exposed by the toolchain,
  * the function always falls back to portable software.
  *
- * @param out 16-byte output.
- * @param in  16-byte input.
- * @param ctx Crypto context containing round keys.
+ * @param out        16-byte output.
+ * @param in         16-byte input.
+ * @param round_keys The 15 pre-expanded round keys.
  */
-static inline void ttak_aes256_enc_block(uint8_t out[16], const uint8_t in[16], const ttak_crypto_ctx_t *ctx) {
+static inline void ttak_aes256_enc_block(uint8_t out[16], const uint8_t in[16], const uint8_t (*round_keys)[16]) {
 #if TTAK_USE_X86_AESNI
-    const __m128i *rk = (const __m128i *)ctx->hw_state.aes.round_keys;
+    const __m128i *rk = (const __m128i *)round_keys;
     __m128i b = _mm_loadu_si128((const __m128i *)in);
     b = _mm_xor_si128(b, rk[0]);
     for (int r = 1; r < 14; r++) {
@@ -330,48 +613,236 @@ static inline void ttak_aes256_enc_block(uint8_t out[16], const uint8_t in[16],
     /*
      * ARMv8 Crypto intrinsics are only available when __ARM_FEATURE_CRYPTO is defined.
      * This avoids build failures on toolchains that target AArch64 but do not expose AES intrinsics.
+     *
+     * AESE XORs its key before SubBytes and ShiftRows, so round r consumes
+     * rk[r - 1]: thirteen AESE+AESMC rounds on rk[0..12], a final AESE on
+     * rk[13], and rk[14] as a plain XOR.
      */
-    const uint8x16_t *rk = (const uint8x16_t *)ctx->hw_state.aes.round_keys;
+    const uint8x16_t *rk = (const uint8x16_t *)round_keys;
     uint8x16_t b = vld1q_u8(in);
+    for (int r = 0; r < 13; r++) {
+        b = vaesmcq_u8(vaeseq_u8(b, rk[r]));
+    }
+    b = veorq_u8(vaeseq_u8(b, rk[13]), rk[14]);
+    vst1q_u8(out, b);
 
-    /* Initial AddRoundKey. */
-    b = veorq_u8(b, rk[0]);
+#else
+    ttak_aes256_enc_block_soft(out, in, round_keys);
+#endif
+}
 
-    /* 13 full rounds for AES-256: rounds 1..13 include MixColumns. */
-    for (int r = 1; r < 14; r++) {
-        b = vaeseq_u8(b, rk[r]);   /* SubBytes + ShiftRows + AddRoundKey */
-        b = vaesmcq_u8(b);         /* MixColumns */
+/* --- AES-256 CTR --- */
+
+/**
+ * @def TTAK_AES_CTR_LANES
+ * @brief Blocks the CTR loop keeps in flight on the 128-bit paths.
+ */
+#define TTAK_AES_CTR_LANES 8u
+
+/**
+ * @brief XOR @p blocks blocks of @p in with AES_K(IV || counter + i) into @p out.
+ *
+ * The caller guarantees counter + blocks does not pass 2^32. @p out may
+ * equal @p in.
+ *
+ * @param round_keys The 15 pre-expanded round keys.
+ * @param iv         12-byte IV.
+ * @param counter    Counter of the first block.
+ */
+static void ttak_aes256_ctr_blocks(const uint8_t (*round_keys)[16], const uint8_t iv[12], uint32_t counter,
+                                   const uint8_t *in, uint8_t *out, size_t blocks) {
+#if TTAK_USE_X86_AESNI
+    const __m128i *rk = (const __m128i *)round_keys;
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    /*
+     * Keep the counter block byte-reversed so the big-endian counter sits in
+     * the low dword, where a 32-bit add increments it without carrying into
+     * the IV, exactly as GCM's inc32 does.
+     */
+    uint8_t first[16];
+    memcpy(first, iv, 12);
+    const uint32_t be = ttak_bswap32(counter);
+    memcpy(first + 12, &be, 4);
+    __m128i ctr = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)first), bswap);
+
+#  if TTAK_USE_X86_VAES512
+    if (blocks >= 16) {
+        __m512i rkz[15];
+        for (int r = 0; r < 15; r++) rkz[r] = _mm512_broadcast_i32x4(rk[r]);
+        const __m512i bswapz = _mm512_broadcast_i32x4(bswap);
+        const __m512i four = _mm512_broadcast_i32x4(_mm_set_epi32(0, 0, 0, 4));
+        __m512i ctrz = _mm512_add_epi32(_mm512_broadcast_i32x4(ctr), _mm512_set_epi32(0, 0, 0, 3, 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 0));
+        for (; blocks >= 16; blocks -= 16, in += 256, out += 256) {
+            __m512i b[4];
+            for (int k = 0; k < 4; k++) {
+                b[k] = _mm512_xor_si512(_mm512_shuffle_epi8(ctrz, bswapz), rkz[0]);
+                ctrz = _mm512_add_epi32(ctrz, four);
+            }
+            for (int r = 1; r < 14; r++) {
+                for (int k = 0; k < 4; k++) b[k] = _mm512_aesenc_epi128(b[k], rkz[r]);
+            }
+            for (int k = 0; k < 4; k++) {
+                b[k] = _mm512_aesenclast_epi128(b[k], rkz[14]);
+                __m512i src = _mm512_loadu_si512((const void *)(in + 64 * k));
+                _mm512_storeu_si512((void *)(out + 64 * k), _mm512_xor_si512(src, b[k]));
+            }
+        }
+        ctr = _mm512_castsi512_si128(ctrz);
+    }
+#  endif
+
+    const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+    for (; blocks >= TTAK_AES_CTR_LANES; blocks -= TTAK_AES_CTR_LANES, in += 16 * TTAK_AES_CTR_LANES,
+                                         out += 16 * TTAK_AES_CTR_LANES) {
+        __m128i b[TTAK_AES_CTR_LANES];
+        for (unsigned j = 0; j < TTAK_AES_CTR_LANES; j++) {
+            b[j] = _mm_xor_si128(_mm_shuffle_epi8(ctr, bswap), rk[0]);
+            ctr = _mm_add_epi32(ctr, one);
+        }
+        for (int r = 1; r < 14; r++) {
+            for (unsigned j = 0; j < TTAK_AES_CTR_LANES; j++) b[j] = _mm_aesenc_si128(b[j], rk[r]);
+        }
+        for (unsigned j = 0; j < TTAK_AES_CTR_LANES; j++) {
+            b[j] = _mm_aesenclast_si128(b[j], rk[14]);
+            __m128i src = _mm_loadu_si128((const __m128i *)(in + 16 * j));
+            _mm_storeu_si128((__m128i *)(out + 16 * j), _mm_xor_si128(src, b[j]));
+        }
+    }
+    for (; blocks > 0; blocks--, in += 16, out += 16) {
+        __m128i b = _mm_xor_si128(_mm_shuffle_epi8(ctr, bswap), rk[0]);
+        ctr = _mm_add_epi32(ctr, one);
+        for (int r = 1; r < 14; r++) b = _mm_aesenc_si128(b, rk[r]);
+        b = _mm_aesenclast_si128(b, rk[14]);
+        _mm_storeu_si128((__m128i *)out, _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), b));
     }
 
-    /* Final round: AES single round without MixColumns.
-       Implement as AESE with last key then XOR with final key is not correct.
-       Correct is: AESE with rk[14] and no AESMC.
-       In ARM intrinsics, vaeseq_u8 performs the round including AddRoundKey.
-       So we do final round directly with rk[14] but without vaesmcq_u8. */
-    b = vaeseq_u8(b, rk[14]);
-    vst1q_u8(out, b);
+#elif TTAK_USE_ARM64_CRYPTO
+    const uint8x16_t *rk = (const uint8x16_t *)round_keys;
+    uint8_t blk[16];
+    memcpy(blk, iv, 12);
+    for (; blocks >= TTAK_AES_CTR_LANES; blocks -= TTAK_AES_CTR_LANES, in += 16 * TTAK_AES_CTR_LANES,
+                                         out += 16 * TTAK_AES_CTR_LANES) {
+        uint8x16_t b[TTAK_AES_CTR_LANES];
+        for (unsigned j = 0; j < TTAK_AES_CTR_LANES; j++) {
+            const uint32_t be = ttak_bswap32(counter++);
+            memcpy(blk + 12, &be, 4);
+            b[j] = vld1q_u8(blk);
+        }
+        for (int r = 0; r < 13; r++) {
+            for (unsigned j = 0; j < TTAK_AES_CTR_LANES; j++) b[j] = vaesmcq_u8(vaeseq_u8(b[j], rk[r]));
+        }
+        for (unsigned j = 0; j < TTAK_AES_CTR_LANES; j++) {
+            b[j] = veorq_u8(vaeseq_u8(b[j], rk[13]), rk[14]);
+            vst1q_u8(out + 16 * j, veorq_u8(vld1q_u8(in + 16 * j), b[j]));
+        }
+    }
+    for (; blocks > 0; blocks--, in += 16, out += 16) {
+        uint8_t ks[16];
+        const uint32_t be = ttak_bswap32(counter++);
+        memcpy(blk + 12, &be, 4);
+        ttak_aes256_enc_block(ks, blk, round_keys);
+        vst1q_u8(out, veorq_u8(vld1q_u8(in), vld1q_u8(ks)));
+    }
 
 #else
-    ttak_aes256_enc_block_soft(out, in, ctx);
+    uint8_t blk[16];
+    memcpy(blk, iv, 12);
+    for (; blocks > 0; blocks--, in += 16, out += 16) {
+        uint8_t ks[16];
+        const uint32_t be = ttak_bswap32(counter++);
+        memcpy(blk + 12, &be, 4);
+        ttak_aes256_enc_block(ks, blk, round_keys);
+        for (int j = 0; j < 16; j++) out[j] = (uint8_t)(in[j] ^ ks[j]);
+    }
 #endif
 }
 
+/* --- AES-256 key schedule --- */
+
+/**
+ * @brief FIPS 197 key expansion of a 32-byte key into 15 round keys.
+ *
+ * 60 words, Rcon applied every 8th word and an extra SubWord halfway
+ * through each 8-word group.
+ */
+static void ttak_aes256_expand(uint8_t (*round_keys)[16], const uint8_t key[32]) {
+    uint8_t *w = round_keys[0];
+    memcpy(w, key, 32);
+    uint8_t rcon = 0x01;
+    for (size_t i = 8; i < 60; i++) {
+        uint8_t t[4];
+        memcpy(t, w + (i - 1) * 4, 4);
+        if (i % 8 == 0) {
+            const uint8_t t0 = t[0];
+            t[0] = (uint8_t)(ttak_aes_sbox[t[1]] ^ rcon);
+            t[1] = ttak_aes_sbox[t[2]];
+            t[2] = ttak_aes_sbox[t[3]];
+            t[3] = ttak_aes_sbox[t0];
+            rcon = ttak_aes_xtime(rcon);
+        } else if (i % 8 == 4) {
+            for (int j = 0; j < 4; j++) t[j] = ttak_aes_sbox[t[j]];
+        }
+        for (int j = 0; j < 4; j++) {
+            w[i * 4 + (size_t)j] = (uint8_t)(w[(i - 8) * 4 + (size_t)j] ^ t[j]);
+        }
+    }
+}
+
+/**
+ * @brief Expand ctx->key (32 bytes) into ctx->hw_state.aes.round_keys.
+ *
+ * @param ctx Crypto context; key and key_len must be set.
+ * @return TTAK_IO_ERR_INVALID_ARGUMENT unless the key is 32 bytes.
+ */
+ttak_io_status_t ttak_aes256_expand_key(ttak_crypto_ctx_t *ctx) {
+    if (!ctx || !ctx->key || ctx->key_len != 32U) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    ttak_aes256_expand(ctx->hw_state.aes.round_keys, ctx->key);
+    ctx->hw_state.aes.rounds = 14;
+    return TTAK_IO_SUCCESS;
+}
+
+_Static_assert(sizeof(ttak_ghash_key_t) <= TTAK_SECURITY_GHASH_KEY_BYTES,
+               "ttak_security_schedule_t has no room for this GHASH key");
+_Static_assert(alignof(ttak_ghash_key_t) <= 64, "GHASH key needs more than cache-line alignment");
+
+void ttak_aes256_gcm_schedule_fill(ttak_security_schedule_t *sched) {
+    static const uint8_t zero_blk[16] = {0};
+    uint8_t h_key[16];
+    ttak_aes256_expand(sched->u.aes.round_keys, sched->key);
+    ttak_aes256_enc_block(h_key, zero_blk, (const uint8_t (*)[16])sched->u.aes.round_keys);
+    ttak_ghash_init((ttak_ghash_key_t *)(void *)sched->u.aes.ghash, h_key);
+    memset(h_key, 0, sizeof(h_key));
+}
+
 /* --- AES-256 GCM API --- */
 
 /**
- * @brief Execute AES-256 GCM (encrypt + authenticate) with software GHASH.
+ * @def TTAK_AES_GCM_CHUNK_BLOCKS
+ * @brief Blocks encrypted before GHASH reads them back, sized to stay in L1.
+ */
+#define TTAK_AES_GCM_CHUNK_BLOCKS 64u
+
+/**
+ * @brief Execute AES-256 GCM (encrypt + authenticate).
  *
  * This function expects:
  *  - ctx->iv points to a 12-byte IV (96-bit nonce).
  *  - ctx->tag points to a 16-byte tag output buffer.
- *  - ctx->hw_state.aes.round_keys contains AES-256 round keys (15 x 16 bytes).
+ *  - ctx->hw_state.aes.round_keys contains AES-256 round keys (15 x 16 bytes),
+ *    unless ctx->schedule is an AES-256 schedule of ctx->key, whose round
+ *    keys and GHASH powers are used instead.
  *
  * This implementation:
- *  - Computes H = AES_K(0^128)
+ *  - Computes H = AES_K(0^128) and its powers
  *  - GHASHes AAD, then ciphertext blocks
  *  - Uses AES-CTR with counter appended to IV as 32-bit big-endian
  *  - Produces tag = GHASH(...) xor AES_K(J0)
  *
+ * The payload is processed in chunks of TTAK_AES_GCM_CHUNK_BLOCKS: each
+ * chunk is encrypted and then hashed while it is still in cache.
+ *
  * @param ctx Crypto context.
  * @param in  Optional input buffer (if NULL, uses ctx->in).
  * @param out Optional output buffer (if NULL, uses ctx->out).
@@ -397,27 +868,45 @@ ttak_io_status_t ttak_aes256_gcm_execute(ttak_crypto_ctx_t *ctx,
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
 
-    uint8_t h_key[16];
+    const size_t full_blocks = d_len / 16;
+    const size_t rem_bytes   = d_len % 16;
+
+    /* Counters 2 .. 2^32 - 1 are available; refuse before writing anything. */
+    if ((uint64_t)full_blocks + (rem_bytes ? 1u : 0u) > 0xFFFFFFFEull) {
+        return TTAK_IO_ERR_RANGE;
+    }
+
     uint8_t y_acc[16] = {0};
     uint8_t j0[16] = {0};
     uint8_t j0_enc[16];
-    uint8_t zero_blk[16] = {0};
-
-    /* 1) H = AES_K(0^128) */
-    ttak_aes256_enc_block(h_key, zero_blk, ctx);
+    const uint8_t (*rk)[16];
+    const ttak_ghash_key_t *gk;
+    ttak_ghash_key_t gkey;
+
+    /* 1) H = AES_K(0^128), unless the session schedule already holds its powers */
+    const ttak_security_schedule_t *sched = ttak_security_schedule_match(ctx, TTAK_SECURITY_CIPHER_AES256);
+    if (sched) {
+        rk = (const uint8_t (*)[16])sched->u.aes.round_keys;
+        gk = (const ttak_ghash_key_t *)(const void *)sched->u.aes.ghash;
+    } else {
+        uint8_t h_key[16];
+        static const uint8_t zero_blk[16] = {0};
+        rk = (const uint8_t (*)[16])ctx->hw_state.aes.round_keys;
+        ttak_aes256_enc_block(h_key, zero_blk, rk);
+        ttak_ghash_init(&gkey, h_key);
+        gk = &gkey;
+    }
 
     /* 2) GHASH AAD */
     if (ctx->aad && ctx->aad_len > 0) {
         const size_t aad_full = ctx->aad_len / 16;
         const size_t aad_rem  = ctx->aad_len % 16;
 
-        for (size_t i = 0; i < aad_full; i++) {
-            ttak_ghash_update_soft(y_acc, h_key, ctx->aad + (i * 16));
-        }
+        ttak_ghash_blocks(gk, y_acc, ctx->aad, aad_full);
         if (aad_rem) {
             uint8_t pad[16] = {0};
             memcpy(pad, ctx->aad + (aad_full * 16), aad_rem);
-            ttak_ghash_update_soft(y_acc, h_key, pad);
+            ttak_ghash_blocks(gk, y_acc, pad, 1);
         }
     }
 
@@ -429,55 +918,28 @@ ttak_io_status_t ttak_aes256_gcm_execute(ttak_crypto_ctx_t *ctx,
     j0[15] = 1;
 
     /* E(K, J0) */
-    ttak_aes256_enc_block(j0_enc, j0, ctx);
+    ttak_aes256_enc_block(j0_enc, j0, rk);
 
     /* 4) AES-CTR encryption and GHASH of ciphertext */
     uint32_t counter = 2;
-    const size_t full_blocks = d_len / 16;
-    const size_t rem_bytes   = d_len % 16;
-
-    for (size_t i = 0; i < full_blocks; i++) {
-        uint8_t ctr_blk[16];
-        uint8_t ks[16];
-
-        if (counter == 0U) {
-            return TTAK_IO_ERR_RANGE;
-        }
-        memcpy(ctr_blk, ctx->iv, 12);
-        const uint32_t be = ttak_bswap32(counter);
-        memcpy(ctr_blk + 12, &be, 4);
-
-        ttak_aes256_enc_block(ks, ctr_blk, ctx);
-
-        for (int j = 0; j < 16; j++) {
-            p_dst[i * 16 + (size_t)j] = (uint8_t)(p_src[i * 16 + (size_t)j] ^ ks[j]);
-        }
-
-        ttak_ghash_update_soft(y_acc, h_key, p_dst + (i * 16));
-        counter++;
+    for (size_t done = 0; done < full_blocks;) {
+        size_t n = full_blocks - done;
+        if (n > TTAK_AES_GCM_CHUNK_BLOCKS) n = TTAK_AES_GCM_CHUNK_BLOCKS;
+        ttak_aes256_ctr_blocks(rk, ctx->iv, counter, p_src + done * 16, p_dst + done * 16, n);
+        ttak_ghash_blocks(gk, y_acc, p_dst + done * 16, n);
+        counter += (uint32_t)n;
+        done += n;
     }
 
     if (rem_bytes) {
-        uint8_t ctr_blk[16];
-        uint8_t ks[16];
         uint8_t cpad[16] = {0};
 
-        if (counter == 0U) {
-            return TTAK_IO_ERR_RANGE;
-        }
-        memcpy(ctr_blk, ctx->iv, 12);
-        const uint32_t be = ttak_bswap32(counter);
-        memcpy(ctr_blk + 12, &be, 4);
-
-        ttak_aes256_enc_block(ks, ctr_blk, ctx);
-
-        for (size_t j = 0; j < rem_bytes; j++) {
-            p_dst[full_blocks * 16 + j] = (uint8_t)(p_src[full_blocks * 16 + j] ^ ks[j]);
-            cpad[j] = p_dst[full_blocks * 16 + j];
-        }
-
+        memcpy(cpad, p_src + full_blocks * 16, rem_bytes);
+        ttak_aes256_ctr_blocks(rk, ctx->iv, counter, cpad, cpad, 1);
         /* GHASH needs 16-byte blocks; pad the final ciphertext fragment with zeros. */
-        ttak_ghash_update_soft(y_acc, h_key, cpad);
+        memset(cpad + rem_bytes, 0, 16 - rem_bytes);
+        memcpy(p_dst + full_blocks * 16, cpad, rem_bytes);
+        ttak_ghash_blocks(gk, y_acc, cpad, 1);
     }
 
     /* 5) GHASH lengths: [len(AAD)]_64 || [len(C)]_64 in bits, both big-endian */
@@ -486,7 +948,7 @@ ttak_io_status_t ttak_aes256_gcm_execute(ttak_crypto_ctx_t *ctx,
     const uint64_t c_bits   = (uint64_t)d_len * 8ull;
     ttak_store_be64(len_blk + 0, aad_bits);
     ttak_store_be64(len_blk + 8, c_bits);
-    ttak_ghash_update_soft(y_acc, h_key, len_blk);
+    ttak_ghash_blocks(gk, y_acc, len_blk, 1);
 
     /* 6) Tag = GHASH xor E(K, J0) */
     for (int i = 0; i < 16; i++) {
@@ -0,0 +1,481 @@
+/**
+ * @file argon2.c
+ * @brief Argon2id over arena-backed memory, with pool-parallel lanes.
+ *
+ * Follows RFC 9106 version 0x13. BLAKE2b, the variable-length hash H'
+ * and the BlaMka compression G are local to this file. The whole block
+ * matrix comes from one claim on a private arena generation sized for it,
+ * so a derivation is a single registered buffer, not one malloc per lane,
+ * and the buffer is wiped before the generation is retired.
+ *
+ * Within a slice the lanes only read blocks of earlier slices (or their
+ * own), so they are independent: lane 0 runs on the caller while the
+ * others go to the pool, and every slice ends with a join.
+ */
+
+#include <ttak/security/argon2.h>
+#include <ttak/mem/arena_helper.h>
+#include <ttak/mem/fastpath.h>
+#include <ttak/priority/nice.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+#define TTAK_ARGON2_VERSION 0x13U
+#define TTAK_ARGON2_TYPE_ID 2U
+#define TTAK_ARGON2_SYNC_POINTS 4U
+#define TTAK_ARGON2_WORDS (TTAK_ARGON2_BLOCK_LEN / 8U)
+#define TTAK_ARGON2_ADDRESSES TTAK_ARGON2_WORDS
+#define TTAK_ARGON2_PREHASH_LEN 64U
+#define TTAK_ARGON2_MAX_LANES 0xFFFFFFU
+
+/** @brief Lanes one slice hands to the pool in a single batch. */
+#define TTAK_ARGON2_POOL_BATCH 64U
+
+/* Wipes secrets so the compiler cannot drop the stores. */
+static void ttak_argon2_wipe(void *p, size_t n) {
+    volatile uint8_t *v = p;
+    while (n--) *v++ = 0;
+}
+
+static inline uint64_t ttak_argon2_load64(const uint8_t *p) {
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+static inline void ttak_argon2_store64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline void ttak_argon2_store32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline uint64_t ttak_argon2_rotr(uint64_t x, unsigned n) {
+    return (x >> n) | (x << (64 - n));
+}
+
+/* ---- BLAKE2b ---- */
+
+typedef struct {
+    uint64_t h[8];
+    uint64_t t;
+    uint8_t buf[128];
+    size_t buf_len;
+    size_t out_len;
+} ttak_blake2b_t;
+
+static const uint64_t ttak_blake2b_iv[8] = {
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+static const uint8_t ttak_blake2b_sigma[12][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+    { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+    { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+    { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+    { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+    { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+    { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+    { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+    { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+};
+
+#define TTAK_BLAKE2B_G(v, a, b, c, d, x, y)                    \
+    do {                                                       \
+        v[a] += v[b] + (x);                                    \
+        v[d] = ttak_argon2_rotr(v[d] ^ v[a], 32);              \
+        v[c] += v[d];                                          \
+        v[b] = ttak_argon2_rotr(v[b] ^ v[c], 24);              \
+        v[a] += v[b] + (y);                                    \
+        v[d] = ttak_argon2_rotr(v[d] ^ v[a], 16);              \
+        v[c] += v[d];                                          \
+        v[b] = ttak_argon2_rotr(v[b] ^ v[c], 63);              \
+    } while (0)
+
+static void ttak_blake2b_compress(ttak_blake2b_t *s, const uint8_t block[128], bool last) {
+    uint64_t m[16], v[16];
+    for (int i = 0; i < 16; ++i) m[i] = ttak_argon2_load64(block + 8 * i);
+    for (int i = 0; i < 8; ++i) {
+        v[i] = s->h[i];
+        v[i + 8] = ttak_blake2b_iv[i];
+    }
+    v[12] ^= s->t;
+    if (last) v[14] = ~v[14];
+    for (int r = 0; r < 12; ++r) {
+        const uint8_t *sg = ttak_blake2b_sigma[r];
+        TTAK_BLAKE2B_G(v, 0, 4, 8, 12, m[sg[0]], m[sg[1]]);
+        TTAK_BLAKE2B_G(v, 1, 5, 9, 13, m[sg[2]], m[sg[3]]);
+        TTAK_BLAKE2B_G(v, 2, 6, 10, 14, m[sg[4]], m[sg[5]]);
+        TTAK_BLAKE2B_G(v, 3, 7, 11, 15, m[sg[6]], m[sg[7]]);
+        TTAK_BLAKE2B_G(v, 0, 5, 10, 15, m[sg[8]], m[sg[9]]);
+        TTAK_BLAKE2B_G(v, 1, 6, 11, 12, m[sg[10]], m[sg[11]]);
+        TTAK_BLAKE2B_G(v, 2, 7, 8, 13, m[sg[12]], m[sg[13]]);
+        TTAK_BLAKE2B_G(v, 3, 4, 9, 14, m[sg[14]], m[sg[15]]);
+    }
+    for (int i = 0; i < 8; ++i) s->h[i] ^= v[i] ^ v[i + 8];
+}
+
+static void ttak_blake2b_init(ttak_blake2b_t *s, size_t out_len) {
+    memcpy(s->h, ttak_blake2b_iv, sizeof(s->h));
+    s->h[0] ^= 0x01010000ULL ^ (uint64_t)out_len;
+    s->t = 0;
+    s->buf_len = 0;
+    s->out_len = out_len;
+}
+
+static void ttak_blake2b_update(ttak_blake2b_t *s, const void *data, size_t len) {
+    const uint8_t *p = data;
+    while (len) {
+        /* The last block is compressed by final(), so only flush when more input follows. */
+        if (s->buf_len == sizeof(s->buf)) {
+            s->t += sizeof(s->buf);
+            ttak_blake2b_compress(s, s->buf, false);
+            s->buf_len = 0;
+        }
+        size_t take = sizeof(s->buf) - s->buf_len;
+        if (take > len) take = len;
+        memcpy(s->buf + s->buf_len, p, take);
+        s->buf_len += take;
+        p += take;
+        len -= take;
+    }
+}
+
+static void ttak_blake2b_update32(ttak_blake2b_t *s, uint32_t v) {
+    uint8_t b[4];
+    ttak_argon2_store32(b, v);
+    ttak_blake2b_update(s, b, sizeof(b));
+}
+
+static void ttak_blake2b_final(ttak_blake2b_t *s, uint8_t *out) {
+    uint8_t full[64];
+    s->t += s->buf_len;
+    memset(s->buf + s->buf_len, 0, sizeof(s->buf) - s->buf_len);
+    ttak_blake2b_compress(s, s->buf, true);
+    for (int i = 0; i < 8; ++i) ttak_argon2_store64(full + 8 * i, s->h[i]);
+    memcpy(out, full, s->out_len);
+    ttak_argon2_wipe(full, sizeof(full));
+    ttak_argon2_wipe(s, sizeof(*s));
+}
+
+/**
+ * @brief H' from RFC 9106 section 3.3: BLAKE2b stretched to @p out_len bytes.
+ */
+static void ttak_argon2_hash_long(uint8_t *out, size_t out_len, const uint8_t *in, size_t in_len) {
+    ttak_blake2b_t s;
+    if (out_len <= 64) {
+        ttak_blake2b_init(&s, out_len);
+        ttak_blake2b_update32(&s, (uint32_t)out_len);
+        ttak_blake2b_update(&s, in, in_len);
+        ttak_blake2b_final(&s, out);
+        return;
+    }
+    uint8_t v[64];
+    ttak_blake2b_init(&s, 64);
+    ttak_blake2b_update32(&s, (uint32_t)out_len);
+    ttak_blake2b_update(&s, in, in_len);
+    ttak_blake2b_final(&s, v);
+    memcpy(out, v, 32);
+    out += 32;
+    out_len -= 32;
+    while (out_len > 64) {
+        ttak_blake2b_init(&s, 64);
+        ttak_blake2b_update(&s, v, 64);
+        ttak_blake2b_final(&s, v);
+        memcpy(out, v, 32);
+        out += 32;
+        out_len -= 32;
+    }
+    ttak_blake2b_init(&s, out_len);
+    ttak_blake2b_update(&s, v, 64);
+    ttak_blake2b_final(&s, out);
+    ttak_argon2_wipe(v, sizeof(v));
+}
+
+/* ---- BlaMka compression ---- */
+
+typedef struct {
+    uint64_t v[TTAK_ARGON2_WORDS];
+} ttak_argon2_block_t;
+
+static inline uint64_t ttak_argon2_fblamka(uint64_t x, uint64_t y) {
+    return x + y + 2 * (uint64_t)(uint32_t)x * (uint32_t)y;
+}
+
+#define TTAK_ARGON2_GB(a, b, c, d)                            \
+    do {                                                      \
+        a = ttak_argon2_fblamka(a, b);                        \
+        d = ttak_argon2_rotr(d ^ a, 32);                      \
+        c = ttak_argon2_fblamka(c, d);                        \
+        b = ttak_argon2_rotr(b ^ c, 24);                      \
+        a = ttak_argon2_fblamka(a, b);                        \
+        d = ttak_argon2_rotr(d ^ a, 16);                      \
+        c = ttak_argon2_fblamka(c, d);                        \
+        b = ttak_argon2_rotr(b ^ c, 63);                      \
+    } while (0)
+
+/* The permutation P over sixteen words named by stride pairs. */
+#define TTAK_ARGON2_P(w, i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15) \
+    do {                                                                                       \
+        TTAK_ARGON2_GB(w[i0], w[i4], w[i8], w[i12]);                                           \
+        TTAK_ARGON2_GB(w[i1], w[i5], w[i9], w[i13]);                                           \
+        TTAK_ARGON2_GB(w[i2], w[i6], w[i10], w[i14]);                                          \
+        TTAK_ARGON2_GB(w[i3], w[i7], w[i11], w[i15]);                                          \
+        TTAK_ARGON2_GB(w[i0], w[i5], w[i10], w[i15]);                                          \
+        TTAK_ARGON2_GB(w[i1], w[i6], w[i11], w[i12]);                                          \
+        TTAK_ARGON2_GB(w[i2], w[i7], w[i8], w[i13]);                                           \
+        TTAK_ARGON2_GB(w[i3], w[i4], w[i9], w[i14]);                                           \
+    } while (0)
+
+/**
+ * @brief next = G(prev, ref), XORed into the old @p next when @p with_xor.
+ */
+static void ttak_argon2_fill_block(const ttak_argon2_block_t *prev, const ttak_argon2_block_t *ref,
+                                   ttak_argon2_block_t *next, bool with_xor) {
+    ttak_argon2_block_t r, q;
+    for (size_t i = 0; i < TTAK_ARGON2_WORDS; ++i) r.v[i] = prev->v[i] ^ ref->v[i];
+    q = r;
+    if (with_xor) {
+        for (size_t i = 0; i < TTAK_ARGON2_WORDS; ++i) r.v[i] ^= next->v[i];
+    }
+    uint64_t *w = q.v;
+    for (size_t i = 0; i < 8; ++i) {
+        size_t b = 16 * i;
+        TTAK_ARGON2_P(w, b, b + 1, b + 2, b + 3, b + 4, b + 5, b + 6, b + 7, b + 8, b + 9, b + 10, b + 11,
+                      b + 12, b + 13, b + 14, b + 15);
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        size_t b = 2 * i;
+        TTAK_ARGON2_P(w, b, b + 1, b + 16, b + 17, b + 32, b + 33, b + 48, b + 49, b + 64, b + 65, b + 80,
+                      b + 81, b + 96, b + 97, b + 112, b + 113);
+    }
+    for (size_t i = 0; i < TTAK_ARGON2_WORDS; ++i) next->v[i] = q.v[i] ^ r.v[i];
+}
+
+/* ---- Memory filling ---- */
+
+typedef struct {
+    ttak_argon2_block_t *memory;
+    uint32_t passes;
+    uint32_t lanes;
+    uint32_t lane_len;    /**< Blocks per lane (q). */
+    uint32_t segment_len; /**< Blocks per lane per slice. */
+    uint32_t blocks;      /**< Total blocks (m'). */
+} ttak_argon2_instance_t;
+
+typedef struct {
+    const ttak_argon2_instance_t *inst;
+    uint32_t pass;
+    uint32_t lane;
+    uint32_t slice;
+} ttak_argon2_segment_t;
+
+static void ttak_argon2_next_addresses(ttak_argon2_block_t *address, ttak_argon2_block_t *input) {
+    static const ttak_argon2_block_t zero;
+    input->v[6]++;
+    ttak_argon2_fill_block(&zero, input, address, false);
+    ttak_argon2_fill_block(&zero, address, address, false);
+}
+
+/**
+ * @brief Maps the pseudo-random J1 onto a block of the reference area (RFC 9106 3.4.1.2).
+ */
+static uint32_t ttak_argon2_index_alpha(const ttak_argon2_instance_t *inst, uint32_t pass, uint32_t slice,
+                                        uint32_t index, uint32_t j1, bool same_lane) {
+    uint32_t area;
+    if (pass == 0) {
+        if (slice == 0) {
+            area = index - 1;
+        } else if (same_lane) {
+            area = slice * inst->segment_len + index - 1;
+        } else {
+            area = slice * inst->segment_len - (index == 0 ? 1U : 0U);
+        }
+    } else if (same_lane) {
+        area = inst->lane_len - inst->segment_len + index - 1;
+    } else {
+        area = inst->lane_len - inst->segment_len - (index == 0 ? 1U : 0U);
+    }
+    uint64_t x = ((uint64_t)j1 * j1) >> 32;
+    uint32_t rel = area - 1 - (uint32_t)(((uint64_t)area * x) >> 32);
+    uint32_t start = (pass == 0 || slice == TTAK_ARGON2_SYNC_POINTS - 1) ? 0 : (slice + 1) * inst->segment_len;
+    return (uint32_t)(((uint64_t)start + rel) % inst->lane_len);
+}
+
+static void ttak_argon2_fill_segment(const ttak_argon2_instance_t *inst, uint32_t pass, uint32_t lane,
+                                     uint32_t slice) {
+    /* Argon2id: data-independent addressing for the first half of pass 0. */
+    bool independent = pass == 0 && slice < TTAK_ARGON2_SYNC_POINTS / 2;
+    ttak_argon2_block_t input, address;
+    if (independent) {
+        memset(&input, 0, sizeof(input));
+        input.v[0] = pass;
+        input.v[1] = lane;
+        input.v[2] = slice;
+        input.v[3] = inst->blocks;
+        input.v[4] = inst->passes;
+        input.v[5] = TTAK_ARGON2_TYPE_ID;
+    }
+
+    uint32_t start = (pass == 0 && slice == 0) ? 2 : 0;
+    if (independent && start) ttak_argon2_next_addresses(&address, &input);
+
+    ttak_argon2_block_t *row = inst->memory + (size_t)lane * inst->lane_len;
+    for (uint32_t i = start; i < inst->segment_len; ++i) {
+        uint32_t col = slice * inst->segment_len + i;
+        const ttak_argon2_block_t *prev = &row[col ? col - 1 : inst->lane_len - 1];
+        uint64_t rand;
+        if (independent) {
+            if (i % TTAK_ARGON2_ADDRESSES == 0) ttak_argon2_next_addresses(&address, &input);
+            rand = address.v[i % TTAK_ARGON2_ADDRESSES];
+        } else {
+            rand = prev->v[0];
+        }
+        uint32_t ref_lane = (pass == 0 && slice == 0) ? lane : (uint32_t)((rand >> 32) % inst->lanes);
+        uint32_t ref_col = ttak_argon2_index_alpha(inst, pass, slice, i, (uint32_t)rand, ref_lane == lane);
+        const ttak_argon2_block_t *ref = inst->memory + (size_t)ref_lane * inst->lane_len + ref_col;
+        ttak_argon2_fill_block(prev, ref, &row[col], pass != 0);
+    }
+}
+
+static void *ttak_argon2_segment_task(void *arg) {
+    ttak_argon2_segment_t *s = arg;
+    ttak_argon2_fill_segment(s->inst, s->pass, s->lane, s->slice);
+    return NULL;
+}
+
+/**
+ * @brief Fills one slice of every lane; returns once all of them are done.
+ */
+static void ttak_argon2_fill_slice(const ttak_argon2_instance_t *inst, ttak_thread_pool_t *pool, uint32_t pass,
+                                   uint32_t slice, uint64_t now) {
+    for (uint32_t first = 0; first < inst->lanes; first += TTAK_ARGON2_POOL_BATCH) {
+        uint32_t n = inst->lanes - first;
+        if (n > TTAK_ARGON2_POOL_BATCH) n = TTAK_ARGON2_POOL_BATCH;
+        if (!pool || n == 1) {
+            for (uint32_t l = 0; l < n; ++l) ttak_argon2_fill_segment(inst, pass, first + l, slice);
+            continue;
+        }
+        ttak_argon2_segment_t segs[TTAK_ARGON2_POOL_BATCH];
+        ttak_pool_batch_item_t items[TTAK_ARGON2_POOL_BATCH];
+        for (uint32_t l = 0; l < n; ++l) {
+            segs[l] = (ttak_argon2_segment_t){ inst, pass, first + l, slice };
+            items[l] = (ttak_pool_batch_item_t){ ttak_argon2_segment_task, &segs[l] };
+        }
+        ttak_pool_batch_t *batch = ttak_thread_pool_submit_batch(pool, items + 1, n - 1, __TT_SCHED_NORMAL__, now);
+        size_t queued = batch ? ttak_pool_batch_submitted(batch) : 0;
+        ttak_argon2_segment_task(&segs[0]);
+        for (size_t l = 1 + queued; l < n; ++l) ttak_argon2_segment_task(&segs[l]);
+        if (batch) ttak_pool_batch_destroy(batch);
+    }
+}
+
+ttak_io_status_t ttak_argon2id(const ttak_argon2_params_t *params, const uint8_t *pwd, size_t pwd_len,
+                               const uint8_t *salt, size_t salt_len, uint8_t *out, size_t out_len, uint64_t now) {
+    static const ttak_argon2_params_t defaults = { 0 };
+    if (!params) params = &defaults;
+    uint32_t passes = params->t_cost ? params->t_cost : TTAK_ARGON2_DEFAULT_T_COST;
+    uint32_t m_cost = params->m_cost_kib ? params->m_cost_kib : TTAK_ARGON2_DEFAULT_M_COST_KIB;
+    uint32_t lanes = params->lanes ? params->lanes : TTAK_ARGON2_DEFAULT_LANES;
+
+    if (!out || out_len < TTAK_ARGON2_TAG_MIN_LEN || out_len > UINT32_MAX || (!pwd && pwd_len) ||
+        !salt || salt_len < TTAK_ARGON2_SALT_MIN_LEN || lanes > TTAK_ARGON2_MAX_LANES ||
+        (uint64_t)m_cost < 8ULL * lanes || (!params->secret && params->secret_len) ||
+        (!params->ad && params->ad_len) || pwd_len > UINT32_MAX || salt_len > UINT32_MAX ||
+        params->secret_len > UINT32_MAX || params->ad_len > UINT32_MAX) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+
+    ttak_argon2_instance_t inst;
+    inst.passes = passes;
+    inst.lanes = lanes;
+    inst.segment_len = m_cost / (lanes * TTAK_ARGON2_SYNC_POINTS);
+    inst.lane_len = inst.segment_len * TTAK_ARGON2_SYNC_POINTS;
+    inst.blocks = inst.lane_len * lanes;
+    size_t bytes = (size_t)inst.blocks * TTAK_ARGON2_BLOCK_LEN;
+    if (bytes / TTAK_ARGON2_BLOCK_LEN != inst.blocks || bytes > SIZE_MAX - 8 * TTAK_CACHE_LINE_SIZE) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+
+    /* H0 over the parameters and every input, each prefixed with its length. */
+    uint8_t h0[TTAK_ARGON2_PREHASH_LEN + 8];
+    ttak_blake2b_t s;
+    ttak_blake2b_init(&s, TTAK_ARGON2_PREHASH_LEN);
+    ttak_blake2b_update32(&s, lanes);
+    ttak_blake2b_update32(&s, (uint32_t)out_len);
+    ttak_blake2b_update32(&s, m_cost);
+    ttak_blake2b_update32(&s, passes);
+    ttak_blake2b_update32(&s, TTAK_ARGON2_VERSION);
+    ttak_blake2b_update32(&s, TTAK_ARGON2_TYPE_ID);
+    ttak_blake2b_update32(&s, (uint32_t)pwd_len);
+    ttak_blake2b_update(&s, pwd, pwd_len);
+    ttak_blake2b_update32(&s, (uint32_t)salt_len);
+    ttak_blake2b_update(&s, salt, salt_len);
+    ttak_blake2b_update32(&s, (uint32_t)params->secret_len);
+    ttak_blake2b_update(&s, params->secret, params->secret_len);
+    ttak_blake2b_update32(&s, (uint32_t)params->ad_len);
+    ttak_blake2b_update(&s, params->ad, params->ad_len);
+    ttak_blake2b_final(&s, h0);
+
+    /* One generation holding the whole matrix, with room for the epoch scatter offset. */
+    ttak_arena_env_t env;
+    ttak_arena_env_config_t cfg;
+    ttak_arena_env_config_init(&cfg);
+    cfg.generation_bytes = bytes + 8 * TTAK_CACHE_LINE_SIZE;
+    cfg.chunk_bytes = bytes;
+    ttak_arena_generation_t gen;
+    if (!ttak_arena_env_init(&env, &cfg)) {
+        ttak_argon2_wipe(h0, sizeof(h0));
+        return TTAK_IO_ERR_SYS_FAILURE;
+    }
+    if (!ttak_arena_generation_begin(&env, &gen, 0)) {
+        ttak_arena_env_destroy(&env);
+        ttak_argon2_wipe(h0, sizeof(h0));
+        return TTAK_IO_ERR_SYS_FAILURE;
+    }
+    inst.memory = ttak_arena_generation_claim(&env, &gen, bytes);
+    if (!inst.memory) {
+        ttak_arena_generation_retire(&env, &gen);
+        ttak_arena_env_destroy(&env);
+        ttak_argon2_wipe(h0, sizeof(h0));
+        return TTAK_IO_ERR_SYS_FAILURE;
+    }
+
+    uint8_t bytes_block[TTAK_ARGON2_BLOCK_LEN];
+    for (uint32_t l = 0; l < lanes; ++l) {
+        for (uint32_t c = 0; c < 2; ++c) {
+            ttak_argon2_store32(h0 + TTAK_ARGON2_PREHASH_LEN, c);
+            ttak_argon2_store32(h0 + TTAK_ARGON2_PREHASH_LEN + 4, l);
+            ttak_argon2_hash_long(bytes_block, sizeof(bytes_block), h0, sizeof(h0));
+            ttak_argon2_block_t *b = &inst.memory[(size_t)l * inst.lane_len + c];
+            for (size_t i = 0; i < TTAK_ARGON2_WORDS; ++i) b->v[i] = ttak_argon2_load64(bytes_block + 8 * i);
+        }
+    }
+    ttak_argon2_wipe(h0, sizeof(h0));
+
+    for (uint32_t pass = 0; pass < passes; ++pass) {
+        for (uint32_t slice = 0; slice < TTAK_ARGON2_SYNC_POINTS; ++slice) {
+            ttak_argon2_fill_slice(&inst, params->pool, pass, slice, now);
+        }
+    }
+
+    ttak_argon2_block_t final = inst.memory[inst.lane_len - 1];
+    for (uint32_t l = 1; l < lanes; ++l) {
+        const ttak_argon2_block_t *last = &inst.memory[(size_t)l * inst.lane_len + inst.lane_len - 1];
+        for (size_t i = 0; i < TTAK_ARGON2_WORDS; ++i) final.v[i] ^= last->v[i];
+    }
+    for (size_t i = 0; i < TTAK_ARGON2_WORDS; ++i) ttak_argon2_store64(bytes_block + 8 * i, final.v[i]);
+    ttak_argon2_hash_long(out, out_len, bytes_block, sizeof(bytes_block));
+
+    ttak_argon2_wipe(bytes_block, sizeof(bytes_block));
+    ttak_argon2_wipe(&final, sizeof(final));
+    ttak_mem_stream_zero(inst.memory, bytes);
+    ttak_arena_generation_retire(&env, &gen);
+    ttak_arena_env_destroy(&env);
+    return TTAK_IO_SUCCESS;
+}
@@ -0,0 +1,738 @@
+/**
+ * @file blake3.c
+ * @brief BLAKE3 hash tree with SIMD chunk lanes and pool-parallel subtrees.
+ *
+ * Whole chunks are compressed 16, 8 or 4 at a time (AVX-512, AVX2,
+ * SSE2/NEON) with one chunk per vector lane, and parent nodes of the
+ * bottom tree levels go through the same kernel. The input is split into
+ * aligned power-of-two subtrees whose chaining values are merged on a
+ * stack exactly as the reference incremental hasher merges them, so the
+ * tree shape, and hence the digest, never depends on the lane width or on
+ * how subtrees were shared out between threads.
+ */
+
+#include <ttak/security/blake3.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/priority/nice.h>
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define TTAK_BLAKE3_CHUNK_START 1U
+#define TTAK_BLAKE3_CHUNK_END 2U
+#define TTAK_BLAKE3_PARENT 4U
+#define TTAK_BLAKE3_ROOT 8U
+#define TTAK_BLAKE3_KEYED_HASH 16U
+
+#define TTAK_BLAKE3_BLOCKS_PER_CHUNK (TTAK_BLAKE3_CHUNK_LEN / TTAK_BLAKE3_BLOCK_LEN)
+
+/** @brief Chunks whose chaining values one subtree batch keeps on the stack. */
+#define TTAK_BLAKE3_BATCH_CHUNKS 64U
+
+/** @brief Deepest chaining value stack: one entry per bit of the chunk count. */
+#define TTAK_BLAKE3_MAX_DEPTH 64U
+
+/**
+ * @def TTAK_BLAKE3_MAX_LANES
+ * @brief Widest chunk kernel compiled in.
+ */
+#if defined(TTAK_HAS_AVX512F)
+#  include <immintrin.h>
+#  define TTAK_BLAKE3_MAX_LANES 16U
+#elif defined(TTAK_HAS_AVX2)
+#  include <immintrin.h>
+#  define TTAK_BLAKE3_MAX_LANES 8U
+#elif defined(TTAK_HAS_SSE2)
+#  include <emmintrin.h>
+#  define TTAK_BLAKE3_MAX_LANES 4U
+#elif defined(TTAK_HAS_NEON) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  include <arm_neon.h>
+#  define TTAK_BLAKE3_MAX_LANES 4U
+#else
+#  define TTAK_BLAKE3_MAX_LANES 1U
+#endif
+#define TTAK_BLAKE3_V4 (TTAK_BLAKE3_MAX_LANES >= 4U)
+
+static const uint32_t ttak_blake3_iv[8] = {
+    0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU,
+    0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U
+};
+
+/* Unrolled rounds turn the schedule lookups into fixed register choices. */
+#if defined(__clang__)
+#  define TTAK_BLAKE3_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && !defined(__TINYC__)
+#  define TTAK_BLAKE3_UNROLL _Pragma("GCC unroll 7")
+#else
+#  define TTAK_BLAKE3_UNROLL
+#endif
+
+/* Message word order for each of the seven rounds. */
+static const uint8_t ttak_blake3_schedule[7][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 },
+};
+
+static inline uint32_t ttak_blake3_load32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void ttak_blake3_store32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t ttak_blake3_rotr(uint32_t v, unsigned n) {
+    return (v >> n) | (v << (32U - n));
+}
+
+/* ---- Four-word vectors: SSE2 or NEON ---- */
+
+#if TTAK_BLAKE3_V4
+#if defined(TTAK_HAS_SSE2)
+typedef __m128i ttak_blake3_v4_t;
+#define TTAK_B3V4_ADD(a, b) _mm_add_epi32((a), (b))
+#define TTAK_B3V4_XOR(a, b) _mm_xor_si128((a), (b))
+#define TTAK_B3V4_ROT(a, n) _mm_or_si128(_mm_srli_epi32((a), (n)), _mm_slli_epi32((a), 32 - (n)))
+#define TTAK_B3V4_R16(a) _mm_shufflehi_epi16(_mm_shufflelo_epi16((a), 0xB1), 0xB1)
+#define TTAK_B3V4_SET1(x) _mm_set1_epi32((int)(x))
+#define TTAK_B3V4_LOAD(p) _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define TTAK_B3V4_STORE(p, v) _mm_storeu_si128((__m128i *)(void *)(p), (v))
+#define TTAK_B3V4_SET4(a, b, c, d) _mm_setr_epi32((int)(a), (int)(b), (int)(c), (int)(d))
+#define TTAK_B3V4_ROTL1(a) _mm_shuffle_epi32((a), _MM_SHUFFLE(0, 3, 2, 1))
+#define TTAK_B3V4_ROTL2(a) _mm_shuffle_epi32((a), _MM_SHUFFLE(1, 0, 3, 2))
+#define TTAK_B3V4_ROTL3(a) _mm_shuffle_epi32((a), _MM_SHUFFLE(2, 1, 0, 3))
+
+/** @brief Loads a 4x4 tile of words, transposed: r[i] holds word i of rows 0..3. */
+static inline void ttak_blake3_transpose4(ttak_blake3_v4_t r[4]) {
+    __m128i lo01 = _mm_unpacklo_epi32(r[0], r[1]), hi01 = _mm_unpackhi_epi32(r[0], r[1]);
+    __m128i lo23 = _mm_unpacklo_epi32(r[2], r[3]), hi23 = _mm_unpackhi_epi32(r[2], r[3]);
+    r[0] = _mm_unpacklo_epi64(lo01, lo23);
+    r[1] = _mm_unpackhi_epi64(lo01, lo23);
+    r[2] = _mm_unpacklo_epi64(hi01, hi23);
+    r[3] = _mm_unpackhi_epi64(hi01, hi23);
+}
+#else
+typedef uint32x4_t ttak_blake3_v4_t;
+#define TTAK_B3V4_ADD(a, b) vaddq_u32((a), (b))
+#define TTAK_B3V4_XOR(a, b) veorq_u32((a), (b))
+#define TTAK_B3V4_ROT(a, n) vsriq_n_u32(vshlq_n_u32((a), 32 - (n)), (a), (n))
+#define TTAK_B3V4_R16(a) vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(a)))
+#define TTAK_B3V4_SET1(x) vdupq_n_u32((uint32_t)(x))
+#define TTAK_B3V4_LOAD(p) vld1q_u32((const uint32_t *)(const void *)(p))
+#define TTAK_B3V4_STORE(p, v) vst1q_u32((uint32_t *)(void *)(p), (v))
+#define TTAK_B3V4_SET4(a, b, c, d) \
+    vsetq_lane_u32((d), vsetq_lane_u32((c), vsetq_lane_u32((b), vdupq_n_u32(a), 1), 2), 3)
+#define TTAK_B3V4_ROTL1(a) vextq_u32((a), (a), 1)
+#define TTAK_B3V4_ROTL2(a) vextq_u32((a), (a), 2)
+#define TTAK_B3V4_ROTL3(a) vextq_u32((a), (a), 3)
+
+static inline void ttak_blake3_transpose4(ttak_blake3_v4_t r[4]) {
+    uint32x4x2_t t01 = vtrnq_u32(r[0], r[1]);
+    uint32x4x2_t t23 = vtrnq_u32(r[2], r[3]);
+    r[0] = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+    r[1] = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+    r[2] = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+    r[3] = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+}
+#endif
+#define TTAK_B3V4_R12(a) TTAK_B3V4_ROT((a), 12)
+#define TTAK_B3V4_R8(a)  TTAK_B3V4_ROT((a), 8)
+#define TTAK_B3V4_R7(a)  TTAK_B3V4_ROT((a), 7)
+#endif
+
+/* ---- Single-block compression ---- */
+
+#if TTAK_BLAKE3_V4
+/*
+ * One block with the state held as four rows. The column step works on
+ * the rows directly; the diagonal step first rotates rows 1..3 by one,
+ * two and three words so each diagonal lines up in a single word lane.
+ */
+#define TTAK_BLAKE3_ROW_G(a, b, c, d, x, y)                                           \
+    do {                                                                             \
+        a = TTAK_B3V4_ADD(TTAK_B3V4_ADD(a, b), (x)); d = TTAK_B3V4_R16(TTAK_B3V4_XOR(d, a)); \
+        c = TTAK_B3V4_ADD(c, d);                     b = TTAK_B3V4_R12(TTAK_B3V4_XOR(b, c)); \
+        a = TTAK_B3V4_ADD(TTAK_B3V4_ADD(a, b), (y)); d = TTAK_B3V4_R8(TTAK_B3V4_XOR(d, a));  \
+        c = TTAK_B3V4_ADD(c, d);                     b = TTAK_B3V4_R7(TTAK_B3V4_XOR(b, c));  \
+    } while (0)
+
+/** @brief Full 16-word compression output; words 0..7 are the next chaining value. */
+static void ttak_blake3_compress(const uint32_t cv[8], const uint8_t block[TTAK_BLAKE3_BLOCK_LEN],
+                                 uint32_t block_len, uint64_t counter, uint32_t flags, uint32_t out[16]) {
+    uint32_t m[16];
+    for (int i = 0; i < 16; ++i) m[i] = ttak_blake3_load32(block + 4 * i);
+    const ttak_blake3_v4_t cv0 = TTAK_B3V4_LOAD(cv), cv1 = TTAK_B3V4_LOAD(cv + 4);
+    ttak_blake3_v4_t r0 = cv0, r1 = cv1;
+    ttak_blake3_v4_t r2 = TTAK_B3V4_LOAD(ttak_blake3_iv);
+    ttak_blake3_v4_t r3 = TTAK_B3V4_SET4((uint32_t)counter, (uint32_t)(counter >> 32), block_len, flags);
+
+    TTAK_BLAKE3_UNROLL
+    for (int r = 0; r < 7; ++r) {
+        const uint8_t *k = ttak_blake3_schedule[r];
+        TTAK_BLAKE3_ROW_G(r0, r1, r2, r3, TTAK_B3V4_SET4(m[k[0]], m[k[2]], m[k[4]], m[k[6]]),
+                          TTAK_B3V4_SET4(m[k[1]], m[k[3]], m[k[5]], m[k[7]]));
+        r1 = TTAK_B3V4_ROTL1(r1);
+        r2 = TTAK_B3V4_ROTL2(r2);
+        r3 = TTAK_B3V4_ROTL3(r3);
+        TTAK_BLAKE3_ROW_G(r0, r1, r2, r3, TTAK_B3V4_SET4(m[k[8]], m[k[10]], m[k[12]], m[k[14]]),
+                          TTAK_B3V4_SET4(m[k[9]], m[k[11]], m[k[13]], m[k[15]]));
+        r1 = TTAK_B3V4_ROTL3(r1);
+        r2 = TTAK_B3V4_ROTL2(r2);
+        r3 = TTAK_B3V4_ROTL1(r3);
+    }
+    TTAK_B3V4_STORE(out, TTAK_B3V4_XOR(r0, r2));
+    TTAK_B3V4_STORE(out + 4, TTAK_B3V4_XOR(r1, r3));
+    TTAK_B3V4_STORE(out + 8, TTAK_B3V4_XOR(r2, cv0));
+    TTAK_B3V4_STORE(out + 12, TTAK_B3V4_XOR(r3, cv1));
+}
+#else
+#define TTAK_BLAKE3_G(s, a, b, c, d, x, y)                         \
+    do {                                                           \
+        s[a] = s[a] + s[b] + (x); s[d] = ttak_blake3_rotr(s[d] ^ s[a], 16); \
+        s[c] = s[c] + s[d];       s[b] = ttak_blake3_rotr(s[b] ^ s[c], 12); \
+        s[a] = s[a] + s[b] + (y); s[d] = ttak_blake3_rotr(s[d] ^ s[a], 8);  \
+        s[c] = s[c] + s[d];       s[b] = ttak_blake3_rotr(s[b] ^ s[c], 7);  \
+    } while (0)
+
+/** @brief Full 16-word compression output; words 0..7 are the next chaining value. */
+static void ttak_blake3_compress(const uint32_t cv[8], const uint8_t block[TTAK_BLAKE3_BLOCK_LEN],
+                                 uint32_t block_len, uint64_t counter, uint32_t flags, uint32_t out[16]) {
+    uint32_t m[16], s[16];
+    for (int i = 0; i < 16; ++i) m[i] = ttak_blake3_load32(block + 4 * i);
+    for (int i = 0; i < 8; ++i) s[i] = cv[i];
+    for (int i = 0; i < 4; ++i) s[8 + i] = ttak_blake3_iv[i];
+    s[12] = (uint32_t)counter;
+    s[13] = (uint32_t)(counter >> 32);
+    s[14] = block_len;
+    s[15] = flags;
+
+    TTAK_BLAKE3_UNROLL
+    for (int r = 0; r < 7; ++r) {
+        const uint8_t *k = ttak_blake3_schedule[r];
+        TTAK_BLAKE3_G(s, 0, 4, 8, 12, m[k[0]], m[k[1]]);
+        TTAK_BLAKE3_G(s, 1, 5, 9, 13, m[k[2]], m[k[3]]);
+        TTAK_BLAKE3_G(s, 2, 6, 10, 14, m[k[4]], m[k[5]]);
+        TTAK_BLAKE3_G(s, 3, 7, 11, 15, m[k[6]], m[k[7]]);
+        TTAK_BLAKE3_G(s, 0, 5, 10, 15, m[k[8]], m[k[9]]);
+        TTAK_BLAKE3_G(s, 1, 6, 11, 12, m[k[10]], m[k[11]]);
+        TTAK_BLAKE3_G(s, 2, 7, 8, 13, m[k[12]], m[k[13]]);
+        TTAK_BLAKE3_G(s, 3, 4, 9, 14, m[k[14]], m[k[15]]);
+    }
+    for (int i = 0; i < 8; ++i) {
+        out[i] = s[i] ^ s[i + 8];
+        out[i + 8] = s[i + 8] ^ cv[i];
+    }
+}
+
+#endif
+
+/**
+ * @brief A node whose last compression has not run yet.
+ *
+ * The caller decides whether it becomes a chaining value or, with the
+ * ROOT flag, the output of the whole hash.
+ */
+typedef struct {
+    uint32_t cv[8];
+    uint8_t block[TTAK_BLAKE3_BLOCK_LEN];
+    uint32_t block_len;
+    uint64_t counter;
+    uint32_t flags;
+} ttak_blake3_output_t;
+
+static void ttak_blake3_output_cv(const ttak_blake3_output_t *o, uint8_t cv[32]) {
+    uint32_t w[16];
+    ttak_blake3_compress(o->cv, o->block, o->block_len, o->counter, o->flags, w);
+    for (int i = 0; i < 8; ++i) ttak_blake3_store32(cv + 4 * i, w[i]);
+}
+
+static void ttak_blake3_output_root(const ttak_blake3_output_t *o, uint8_t *out, size_t out_len) {
+    uint8_t bytes[64];
+    for (uint64_t counter = 0; out_len; ++counter) {
+        uint32_t w[16];
+        ttak_blake3_compress(o->cv, o->block, o->block_len, counter, o->flags | TTAK_BLAKE3_ROOT, w);
+        for (int i = 0; i < 16; ++i) ttak_blake3_store32(bytes + 4 * i, w[i]);
+        size_t take = out_len < sizeof(bytes) ? out_len : sizeof(bytes);
+        memcpy(out, bytes, take);
+        out += take;
+        out_len -= take;
+    }
+}
+
+/** @brief Runs all but the last block of a chunk of 0..1024 bytes. */
+static void ttak_blake3_chunk_output(const uint32_t key[8], const uint8_t *in, size_t len, uint64_t counter,
+                                     uint32_t flags, ttak_blake3_output_t *o) {
+    uint32_t cv[8], w[16];
+    memcpy(cv, key, sizeof(cv));
+    uint32_t start = TTAK_BLAKE3_CHUNK_START;
+    while (len > TTAK_BLAKE3_BLOCK_LEN) {
+        ttak_blake3_compress(cv, in, TTAK_BLAKE3_BLOCK_LEN, counter, flags | start, w);
+        memcpy(cv, w, sizeof(cv));
+        start = 0;
+        in += TTAK_BLAKE3_BLOCK_LEN;
+        len -= TTAK_BLAKE3_BLOCK_LEN;
+    }
+    memcpy(o->cv, cv, sizeof(cv));
+    memset(o->block, 0, sizeof(o->block));
+    if (len) memcpy(o->block, in, len);
+    o->block_len = (uint32_t)len;
+    o->counter = counter;
+    o->flags = flags | start | TTAK_BLAKE3_CHUNK_END;
+}
+
+static void ttak_blake3_parent_output(const uint32_t key[8], const uint8_t left[32], const uint8_t right[32],
+                                      uint32_t flags, ttak_blake3_output_t *o) {
+    memcpy(o->cv, key, sizeof(o->cv));
+    memcpy(o->block, left, 32);
+    memcpy(o->block + 32, right, 32);
+    o->block_len = TTAK_BLAKE3_BLOCK_LEN;
+    o->counter = 0;
+    o->flags = flags | TTAK_BLAKE3_PARENT;
+}
+
+/* ---- Vector lanes ---- */
+
+/*
+ * A lanes kernel compresses @p blocks consecutive 64-byte blocks for each
+ * of its lanes, lane j reading from base + j * stride and, when @p step is
+ * set, using counter + j. Chunks use stride 1024 and step 1; a row of
+ * parent nodes is 64-byte blocks of two chaining values each, stride 64
+ * and step 0. Lane j's chaining value is stored at out + 32 j.
+ */
+#define TTAK_BLAKE3_VG(v, a, b, c, d, x, y, ADD, XOR, R16, R12, R8, R7) \
+    do {                                                               \
+        v[a] = ADD(ADD(v[a], v[b]), (x)); v[d] = R16(XOR(v[d], v[a]));   \
+        v[c] = ADD(v[c], v[d]);           v[b] = R12(XOR(v[b], v[c]));   \
+        v[a] = ADD(ADD(v[a], v[b]), (y)); v[d] = R8(XOR(v[d], v[a]));    \
+        v[c] = ADD(v[c], v[d]);           v[b] = R7(XOR(v[b], v[c]));    \
+    } while (0)
+
+#define TTAK_BLAKE3_VROUNDS(v, m, ADD, XOR, R16, R12, R8, R7)                                   \
+    TTAK_BLAKE3_UNROLL                                                                         \
+    for (int r = 0; r < 7; ++r) {                                                              \
+        const uint8_t *k = ttak_blake3_schedule[r];                                            \
+        TTAK_BLAKE3_VG(v, 0, 4, 8, 12, m[k[0]], m[k[1]], ADD, XOR, R16, R12, R8, R7);           \
+        TTAK_BLAKE3_VG(v, 1, 5, 9, 13, m[k[2]], m[k[3]], ADD, XOR, R16, R12, R8, R7);           \
+        TTAK_BLAKE3_VG(v, 2, 6, 10, 14, m[k[4]], m[k[5]], ADD, XOR, R16, R12, R8, R7);          \
+        TTAK_BLAKE3_VG(v, 3, 7, 11, 15, m[k[6]], m[k[7]], ADD, XOR, R16, R12, R8, R7);          \
+        TTAK_BLAKE3_VG(v, 0, 5, 10, 15, m[k[8]], m[k[9]], ADD, XOR, R16, R12, R8, R7);          \
+        TTAK_BLAKE3_VG(v, 1, 6, 11, 12, m[k[10]], m[k[11]], ADD, XOR, R16, R12, R8, R7);        \
+        TTAK_BLAKE3_VG(v, 2, 7, 8, 13, m[k[12]], m[k[13]], ADD, XOR, R16, R12, R8, R7);         \
+        TTAK_BLAKE3_VG(v, 3, 4, 9, 14, m[k[14]], m[k[15]], ADD, XOR, R16, R12, R8, R7);         \
+    }
+
+/** @brief Per-lane counter words: counter + j when @p step is set. */
+static inline void ttak_blake3_lane_counters(uint32_t *lo, uint32_t *hi, size_t lanes, uint64_t counter, bool step) {
+    for (size_t j = 0; j < lanes; ++j) {
+        uint64_t c = counter + (step ? j : 0);
+        lo[j] = (uint32_t)c;
+        hi[j] = (uint32_t)(c >> 32);
+    }
+}
+
+#if defined(TTAK_HAS_AVX512F)
+#define TTAK_B3V16_ADD(a, b) _mm512_add_epi32((a), (b))
+#define TTAK_B3V16_XOR(a, b) _mm512_xor_si512((a), (b))
+#define TTAK_B3V16_R16(a) _mm512_ror_epi32((a), 16)
+#define TTAK_B3V16_R12(a) _mm512_ror_epi32((a), 12)
+#define TTAK_B3V16_R8(a)  _mm512_ror_epi32((a), 8)
+#define TTAK_B3V16_R7(a)  _mm512_ror_epi32((a), 7)
+
+/**
+ * @brief m[i] = word i of the 64-byte blocks at block + j * stride, j = 0..15.
+ *
+ * The same 4x4 word transposes within 128-bit lanes, then 128-bit lane
+ * shuffles, as the ChaCha20 kernels use to store their blocks.
+ */
+static inline void ttak_blake3_load_transpose16(__m512i m[16], const uint8_t *block, size_t stride) {
+    __m512i x[4][4];
+    for (int g = 0; g < 4; ++g) {
+        __m512i r0 = _mm512_loadu_si512((const void *)(block + (4 * g + 0) * stride));
+        __m512i r1 = _mm512_loadu_si512((const void *)(block + (4 * g + 1) * stride));
+        __m512i r2 = _mm512_loadu_si512((const void *)(block + (4 * g + 2) * stride));
+        __m512i r3 = _mm512_loadu_si512((const void *)(block + (4 * g + 3) * stride));
+        __m512i lo01 = _mm512_unpacklo_epi32(r0, r1), hi01 = _mm512_unpackhi_epi32(r0, r1);
+        __m512i lo23 = _mm512_unpacklo_epi32(r2, r3), hi23 = _mm512_unpackhi_epi32(r2, r3);
+        /* 128-bit lane k of x[g][w]: word 4k + w of blocks 4g .. 4g + 3. */
+        x[g][0] = _mm512_unpacklo_epi64(lo01, lo23);
+        x[g][1] = _mm512_unpackhi_epi64(lo01, lo23);
+        x[g][2] = _mm512_unpacklo_epi64(hi01, hi23);
+        x[g][3] = _mm512_unpackhi_epi64(hi01, hi23);
+    }
+    for (int w = 0; w < 4; ++w) {
+        __m512i p02 = _mm512_shuffle_i32x4(x[0][w], x[1][w], _MM_SHUFFLE(2, 0, 2, 0));
+        __m512i q02 = _mm512_shuffle_i32x4(x[2][w], x[3][w], _MM_SHUFFLE(2, 0, 2, 0));
+        __m512i p13 = _mm512_shuffle_i32x4(x[0][w], x[1][w], _MM_SHUFFLE(3, 1, 3, 1));
+        __m512i q13 = _mm512_shuffle_i32x4(x[2][w], x[3][w], _MM_SHUFFLE(3, 1, 3, 1));
+        m[0 + w] = _mm512_shuffle_i32x4(p02, q02, _MM_SHUFFLE(2, 0, 2, 0));
+        m[8 + w] = _mm512_shuffle_i32x4(p02, q02, _MM_SHUFFLE(3, 1, 3, 1));
+        m[4 + w] = _mm512_shuffle_i32x4(p13, q13, _MM_SHUFFLE(2, 0, 2, 0));
+        m[12 + w] = _mm512_shuffle_i32x4(p13, q13, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+}
+
+static void ttak_blake3_lanes16(const uint8_t *base, size_t stride, size_t blocks, const uint32_t key[8],
+                                uint64_t counter, bool step, uint32_t flags, uint32_t start, uint32_t end,
+                                uint8_t *out) {
+    alignas(64) uint32_t lo[16], hi[16], words[8][16];
+    ttak_blake3_lane_counters(lo, hi, 16, counter, step);
+    const __m512i vlo = _mm512_load_si512((const void *)lo), vhi = _mm512_load_si512((const void *)hi);
+    __m512i h[8];
+    for (int i = 0; i < 8; ++i) h[i] = _mm512_set1_epi32((int)key[i]);
+
+    for (size_t b = 0; b < blocks; ++b) {
+        const uint8_t *block = base + b * TTAK_BLAKE3_BLOCK_LEN;
+        __m512i m[16], v[16];
+        ttak_blake3_load_transpose16(m, block, stride);
+        uint32_t f = flags | (b == 0 ? start : 0) | (b + 1 == blocks ? end : 0);
+        for (int i = 0; i < 8; ++i) v[i] = h[i];
+        for (int i = 0; i < 4; ++i) v[8 + i] = _mm512_set1_epi32((int)ttak_blake3_iv[i]);
+        v[12] = vlo;
+        v[13] = vhi;
+        v[14] = _mm512_set1_epi32((int)TTAK_BLAKE3_BLOCK_LEN);
+        v[15] = _mm512_set1_epi32((int)f);
+        TTAK_BLAKE3_VROUNDS(v, m, TTAK_B3V16_ADD, TTAK_B3V16_XOR, TTAK_B3V16_R16, TTAK_B3V16_R12,
+                            TTAK_B3V16_R8, TTAK_B3V16_R7)
+        for (int i = 0; i < 8; ++i) h[i] = _mm512_xor_si512(v[i], v[i + 8]);
+    }
+
+    for (int i = 0; i < 8; ++i) _mm512_store_si512((void *)words[i], h[i]);
+    for (int j = 0; j < 16; ++j) {
+        for (int i = 0; i < 8; ++i) ttak_blake3_store32(out + 32 * j + 4 * i, words[i][j]);
+    }
+}
+#endif
+
+#if defined(TTAK_HAS_AVX2)
+#define TTAK_B3V8_ADD(a, b) _mm256_add_epi32((a), (b))
+#define TTAK_B3V8_XOR(a, b) _mm256_xor_si256((a), (b))
+#define TTAK_B3V8_ROT(a, n) _mm256_or_si256(_mm256_srli_epi32((a), (n)), _mm256_slli_epi32((a), 32 - (n)))
+#define TTAK_B3V8_R16(a) _mm256_shuffle_epi8((a), rot16)
+#define TTAK_B3V8_R12(a) TTAK_B3V8_ROT((a), 12)
+#define TTAK_B3V8_R8(a)  _mm256_shuffle_epi8((a), rot8)
+#define TTAK_B3V8_R7(a)  TTAK_B3V8_ROT((a), 7)
+
+/** @brief m[i] = word i of the 32-byte rows at row + j * stride, j = 0..7. */
+static inline void ttak_blake3_load_transpose8(__m256i m[8], const uint8_t *row, size_t stride) {
+    __m256i t[8], u[8];
+    for (int j = 0; j < 8; j += 2) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(const void *)(row + j * stride));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(const void *)(row + (j + 1) * stride));
+        t[j] = _mm256_unpacklo_epi32(a, b);
+        t[j + 1] = _mm256_unpackhi_epi32(a, b);
+    }
+    /* Within each 128-bit half of u[4 q + w]: word w, or 4 + w, of rows 4q .. 4q + 3. */
+    for (int q = 0; q < 2; ++q) {
+        u[4 * q + 0] = _mm256_unpacklo_epi64(t[4 * q + 0], t[4 * q + 2]);
+        u[4 * q + 1] = _mm256_unpackhi_epi64(t[4 * q + 0], t[4 * q + 2]);
+        u[4 * q + 2] = _mm256_unpacklo_epi64(t[4 * q + 1], t[4 * q + 3]);
+        u[4 * q + 3] = _mm256_unpackhi_epi64(t[4 * q + 1], t[4 * q + 3]);
+    }
+    for (int w = 0; w < 4; ++w) {
+        m[w] = _mm256_permute2x128_si256(u[w], u[4 + w], 0x20);
+        m[4 + w] = _mm256_permute2x128_si256(u[w], u[4 + w], 0x31);
+    }
+}
+
+static void ttak_blake3_lanes8(const uint8_t *base, size_t stride, size_t blocks, const uint32_t key[8],
+                               uint64_t counter, bool step, uint32_t flags, uint32_t start, uint32_t end,
+                               uint8_t *out) {
+    alignas(32) uint32_t lo[8], hi[8], words[8][8];
+    ttak_blake3_lane_counters(lo, hi, 8, counter, step);
+    const __m256i rot16 = _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                          13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    const __m256i rot8 = _mm256_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1,
+                                         12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1);
+    const __m256i vlo = _mm256_load_si256((const __m256i *)(const void *)lo);
+    const __m256i vhi = _mm256_load_si256((const __m256i *)(const void *)hi);
+    __m256i h[8];
+    for (int i = 0; i < 8; ++i) h[i] = _mm256_set1_epi32((int)key[i]);
+
+    for (size_t b = 0; b < blocks; ++b) {
+        const uint8_t *block = base + b * TTAK_BLAKE3_BLOCK_LEN;
+        __m256i m[16], v[16];
+        ttak_blake3_load_transpose8(m, block, stride);
+        ttak_blake3_load_transpose8(m + 8, block + 32, stride);
+        uint32_t f = flags | (b == 0 ? start : 0) | (b + 1 == blocks ? end : 0);
+        for (int i = 0; i < 8; ++i) v[i] = h[i];
+        for (int i = 0; i < 4; ++i) v[8 + i] = _mm256_set1_epi32((int)ttak_blake3_iv[i]);
+        v[12] = vlo;
+        v[13] = vhi;
+        v[14] = _mm256_set1_epi32((int)TTAK_BLAKE3_BLOCK_LEN);
+        v[15] = _mm256_set1_epi32((int)f);
+        TTAK_BLAKE3_VROUNDS(v, m, TTAK_B3V8_ADD, TTAK_B3V8_XOR, TTAK_B3V8_R16, TTAK_B3V8_R12,
+                            TTAK_B3V8_R8, TTAK_B3V8_R7)
+        for (int i = 0; i < 8; ++i) h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+    }
+
+    for (int i = 0; i < 8; ++i) _mm256_store_si256((__m256i *)(void *)words[i], h[i]);
+    for (int j = 0; j < 8; ++j) {
+        for (int i = 0; i < 8; ++i) ttak_blake3_store32(out + 32 * j + 4 * i, words[i][j]);
+    }
+}
+#endif
+
+#if TTAK_BLAKE3_V4
+
+static void ttak_blake3_lanes4(const uint8_t *base, size_t stride, size_t blocks, const uint32_t key[8],
+                               uint64_t counter, bool step, uint32_t flags, uint32_t start, uint32_t end,
+                               uint8_t *out) {
+    alignas(16) uint32_t lo[4], hi[4];
+    ttak_blake3_lane_counters(lo, hi, 4, counter, step);
+    const ttak_blake3_v4_t vlo = TTAK_B3V4_LOAD(lo), vhi = TTAK_B3V4_LOAD(hi);
+    ttak_blake3_v4_t h[8];
+    for (int i = 0; i < 8; ++i) h[i] = TTAK_B3V4_SET1(key[i]);
+
+    for (size_t b = 0; b < blocks; ++b) {
+        const uint8_t *block = base + b * TTAK_BLAKE3_BLOCK_LEN;
+        ttak_blake3_v4_t m[16], v[16];
+        for (int g = 0; g < 4; ++g) {
+            for (int j = 0; j < 4; ++j) m[4 * g + j] = TTAK_B3V4_LOAD(block + j * stride + 16 * g);
+            ttak_blake3_transpose4(m + 4 * g);
+        }
+        uint32_t f = flags | (b == 0 ? start : 0) | (b + 1 == blocks ? end : 0);
+        for (int i = 0; i < 8; ++i) v[i] = h[i];
+        for (int i = 0; i < 4; ++i) v[8 + i] = TTAK_B3V4_SET1(ttak_blake3_iv[i]);
+        v[12] = vlo;
+        v[13] = vhi;
+        v[14] = TTAK_B3V4_SET1(TTAK_BLAKE3_BLOCK_LEN);
+        v[15] = TTAK_B3V4_SET1(f);
+        TTAK_BLAKE3_VROUNDS(v, m, TTAK_B3V4_ADD, TTAK_B3V4_XOR, TTAK_B3V4_R16, TTAK_B3V4_R12,
+                            TTAK_B3V4_R8, TTAK_B3V4_R7)
+        for (int i = 0; i < 8; ++i) h[i] = TTAK_B3V4_XOR(v[i], v[i + 8]);
+    }
+
+    /* Words 0..3 and 4..7 of each lane, transposed back into rows. */
+    ttak_blake3_transpose4(h);
+    ttak_blake3_transpose4(h + 4);
+    for (int j = 0; j < 4; ++j) {
+        TTAK_B3V4_STORE(out + 32 * j, h[j]);
+        TTAK_B3V4_STORE(out + 32 * j + 16, h[4 + j]);
+    }
+}
+#endif
+
+/** @brief Scalar fallback for one lane of the kernels above. */
+static void ttak_blake3_lanes1(const uint8_t *base, size_t blocks, const uint32_t key[8], uint64_t counter,
+                               uint32_t flags, uint32_t start, uint32_t end, uint8_t out[32]) {
+    uint32_t cv[8], w[16];
+    memcpy(cv, key, sizeof(cv));
+    for (size_t b = 0; b < blocks; ++b) {
+        uint32_t f = flags | (b == 0 ? start : 0) | (b + 1 == blocks ? end : 0);
+        ttak_blake3_compress(cv, base + b * TTAK_BLAKE3_BLOCK_LEN, TTAK_BLAKE3_BLOCK_LEN, counter, f, w);
+        memcpy(cv, w, sizeof(cv));
+    }
+    for (int i = 0; i < 8; ++i) ttak_blake3_store32(out + 4 * i, cv[i]);
+}
+
+/**
+ * @brief Chaining values of @p count inputs of @p blocks blocks each.
+ *
+ * Input j starts at base + j * stride; see the lanes kernels. Outputs may
+ * overwrite inputs the kernel has already consumed, which lets a row of
+ * parents be reduced in place.
+ */
+static void ttak_blake3_hash_many(const uint8_t *base, size_t stride, size_t count, size_t blocks,
+                                  const uint32_t key[8], uint64_t counter, bool step, uint32_t flags,
+                                  uint32_t start, uint32_t end, uint8_t *out) {
+#if defined(TTAK_HAS_AVX512F)
+    for (; count >= 16; count -= 16, base += 16 * stride, out += 16 * 32, counter += step ? 16 : 0) {
+        ttak_blake3_lanes16(base, stride, blocks, key, counter, step, flags, start, end, out);
+    }
+#endif
+#if defined(TTAK_HAS_AVX2)
+    for (; count >= 8; count -= 8, base += 8 * stride, out += 8 * 32, counter += step ? 8 : 0) {
+        ttak_blake3_lanes8(base, stride, blocks, key, counter, step, flags, start, end, out);
+    }
+#endif
+#if TTAK_BLAKE3_MAX_LANES >= 4U
+    for (; count >= 4; count -= 4, base += 4 * stride, out += 4 * 32, counter += step ? 4 : 0) {
+        ttak_blake3_lanes4(base, stride, blocks, key, counter, step, flags, start, end, out);
+    }
+#endif
+    for (; count; --count, base += stride, out += 32, counter += step ? 1 : 0) {
+        ttak_blake3_lanes1(base, blocks, key, counter, flags, start, end, out);
+    }
+}
+
+/* ---- Tree ---- */
+
+/**
+ * @brief Chaining value of the @p chunks whole chunks at @p in.
+ *
+ * @p chunks is a power of two and @p counter a multiple of it, so this is
+ * a complete subtree of the final tree. It is never the root: the last
+ * chunk of an input is always left out of these subtrees.
+ */
+static void ttak_blake3_subtree_cv(const uint8_t *in, size_t chunks, const uint32_t key[8], uint64_t counter,
+                                   uint32_t flags, uint8_t cv[32]) {
+    if (chunks > TTAK_BLAKE3_BATCH_CHUNKS) {
+        uint8_t pair[64];
+        size_t half = chunks / 2;
+        ttak_blake3_subtree_cv(in, half, key, counter, flags, pair);
+        ttak_blake3_subtree_cv(in + half * TTAK_BLAKE3_CHUNK_LEN, half, key, counter + half, flags, pair + 32);
+        ttak_blake3_hash_many(pair, 64, 1, 1, key, 0, false, flags | TTAK_BLAKE3_PARENT, 0, 0, cv);
+        return;
+    }
+
+    uint8_t cvs[TTAK_BLAKE3_BATCH_CHUNKS * 32];
+    ttak_blake3_hash_many(in, TTAK_BLAKE3_CHUNK_LEN, chunks, TTAK_BLAKE3_BLOCKS_PER_CHUNK, key, counter, true,
+                          flags, TTAK_BLAKE3_CHUNK_START, TTAK_BLAKE3_CHUNK_END, cvs);
+    for (size_t n = chunks; n > 1; n /= 2) {
+        ttak_blake3_hash_many(cvs, 64, n / 2, 1, key, 0, false, flags | TTAK_BLAKE3_PARENT, 0, 0, cvs);
+    }
+    memcpy(cv, cvs, 32);
+}
+
+/** @brief Chaining values of completed subtrees, merged lazily as the reference hasher does. */
+typedef struct {
+    uint8_t cv[TTAK_BLAKE3_MAX_DEPTH][32];
+    size_t len;
+} ttak_blake3_stack_t;
+
+static unsigned ttak_blake3_popcount(uint64_t x) {
+    unsigned n = 0;
+    for (; x; x &= x - 1) ++n;
+    return n;
+}
+
+/** @brief Merges until the stack describes the first @p chunks chunks. */
+static void ttak_blake3_stack_merge(ttak_blake3_stack_t *st, const uint32_t key[8], uint32_t flags, uint64_t chunks) {
+    size_t keep = ttak_blake3_popcount(chunks);
+    while (st->len > keep) {
+        ttak_blake3_hash_many(st->cv[st->len - 2], 64, 1, 1, key, 0, false, flags | TTAK_BLAKE3_PARENT, 0, 0,
+                              st->cv[st->len - 2]);
+        --st->len;
+    }
+}
+
+/** @brief Pushes the chaining value of the subtree starting at chunk @p counter. */
+static void ttak_blake3_stack_push(ttak_blake3_stack_t *st, const uint32_t key[8], uint32_t flags, uint64_t counter,
+                                   const uint8_t cv[32]) {
+    ttak_blake3_stack_merge(st, key, flags, counter);
+    memcpy(st->cv[st->len++], cv, 32);
+}
+
+/** @brief Size in chunks of the next subtree at @p pos of a @p total chunk prefix, at most @p cap. */
+static size_t ttak_blake3_next_subtree(size_t pos, size_t total, size_t cap) {
+    size_t size = 1;
+    while (size * 2 <= total - pos && size * 2 <= cap) size *= 2;
+    while (pos & (size - 1)) size /= 2;
+    return size;
+}
+
+static void ttak_blake3_key_words(const uint8_t *key, uint32_t words[8], uint32_t *flags) {
+    if (key) {
+        for (int i = 0; i < 8; ++i) words[i] = ttak_blake3_load32(key + 4 * i);
+        *flags = TTAK_BLAKE3_KEYED_HASH;
+    } else {
+        memcpy(words, ttak_blake3_iv, sizeof(ttak_blake3_iv));
+        *flags = 0;
+    }
+}
+
+/** @brief Folds the stack into the last chunk and writes the root output. */
+static void ttak_blake3_finish(ttak_blake3_stack_t *st, const uint32_t key[8], uint32_t flags, const uint8_t *in,
+                               size_t len, size_t prefix_chunks, uint8_t *out, size_t out_len) {
+    ttak_blake3_stack_merge(st, key, flags, prefix_chunks);
+    size_t offset = prefix_chunks * TTAK_BLAKE3_CHUNK_LEN;
+    ttak_blake3_output_t o;
+    ttak_blake3_chunk_output(key, in + offset, len - offset, prefix_chunks, flags, &o);
+    while (st->len) {
+        uint8_t cv[32];
+        ttak_blake3_output_cv(&o, cv);
+        ttak_blake3_parent_output(key, st->cv[--st->len], cv, flags, &o);
+    }
+    ttak_blake3_output_root(&o, out, out_len);
+}
+
+/** @brief Whole chunks ahead of the last, possibly partial, chunk. */
+static size_t ttak_blake3_prefix_chunks(size_t len) {
+    return len ? (len - 1) / TTAK_BLAKE3_CHUNK_LEN : 0;
+}
+
+void ttak_blake3_hash(const uint8_t *key, const uint8_t *in, size_t len, uint8_t *out, size_t out_len) {
+    if (!out || !out_len || (!in && len)) {
+        return;
+    }
+    uint32_t kw[8], flags;
+    ttak_blake3_key_words(key, kw, &flags);
+
+    ttak_blake3_stack_t st;
+    st.len = 0;
+    size_t prefix = ttak_blake3_prefix_chunks(len);
+    for (size_t pos = 0; pos < prefix;) {
+        size_t size = ttak_blake3_next_subtree(pos, prefix, SIZE_MAX);
+        uint8_t cv[32];
+        ttak_blake3_subtree_cv(in + pos * TTAK_BLAKE3_CHUNK_LEN, size, kw, pos, flags, cv);
+        ttak_blake3_stack_push(&st, kw, flags, pos, cv);
+        pos += size;
+    }
+    ttak_blake3_finish(&st, kw, flags, in, len, prefix, out, out_len);
+}
+
+/* ---- Pool ---- */
+
+typedef struct {
+    const uint8_t *in;
+    size_t pos;
+    size_t size;
+    const uint32_t *key;
+    uint32_t flags;
+    uint8_t cv[32];
+} ttak_blake3_task_t;
+
+static void *ttak_blake3_subtree_task(void *arg) {
+    ttak_blake3_task_t *t = arg;
+    ttak_blake3_subtree_cv(t->in + t->pos * TTAK_BLAKE3_CHUNK_LEN, t->size, t->key, t->pos, t->flags, t->cv);
+    return NULL;
+}
+
+void ttak_blake3_hash_pool(ttak_thread_pool_t *pool, const uint8_t *key, const uint8_t *in, size_t len,
+                           uint8_t *out, size_t out_len, uint64_t now) {
+    if (!pool || len < TTAK_BLAKE3_POOL_MIN_BYTES) {
+        ttak_blake3_hash(key, in, len, out, out_len);
+        return;
+    }
+    if (!out || !out_len || !in) {
+        return;
+    }
+    uint32_t kw[8], flags;
+    ttak_blake3_key_words(key, kw, &flags);
+
+    /* Subtrees of at most cap chunks: about MAX_TASKS of them, plus the ragged tail. */
+    size_t prefix = ttak_blake3_prefix_chunks(len);
+    size_t cap = TTAK_BLAKE3_BATCH_CHUNKS;
+    while (prefix / cap > TTAK_BLAKE3_POOL_MAX_TASKS) cap *= 2;
+
+    ttak_blake3_task_t tasks[TTAK_BLAKE3_POOL_MAX_TASKS + TTAK_BLAKE3_MAX_DEPTH];
+    ttak_pool_batch_item_t items[TTAK_BLAKE3_POOL_MAX_TASKS + TTAK_BLAKE3_MAX_DEPTH];
+    size_t n = 0;
+    for (size_t pos = 0; pos < prefix; ++n) {
+        size_t size = ttak_blake3_next_subtree(pos, prefix, cap);
+        tasks[n] = (ttak_blake3_task_t){ in, pos, size, kw, flags, { 0 } };
+        items[n] = (ttak_pool_batch_item_t){ ttak_blake3_subtree_task, &tasks[n] };
+        pos += size;
+    }
+
+    ttak_pool_batch_t *batch = n > 1 ? ttak_thread_pool_submit_batch(pool, items + 1, n - 1, __TT_SCHED_NORMAL__, now)
+                                     : NULL;
+    size_t queued = batch ? ttak_pool_batch_submitted(batch) : 0;
+    if (n) ttak_blake3_subtree_task(&tasks[0]);
+    for (size_t i = 1 + queued; i < n; ++i) ttak_blake3_subtree_task(&tasks[i]);
+    if (batch) ttak_pool_batch_destroy(batch);
+
+    ttak_blake3_stack_t st;
+    st.len = 0;
+    for (size_t i = 0; i < n; ++i) ttak_blake3_stack_push(&st, kw, flags, tasks[i].pos, tasks[i].cv);
+    ttak_blake3_finish(&st, kw, flags, in, len, prefix, out, out_len);
+}
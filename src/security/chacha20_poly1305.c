@@ -1,13 +1,21 @@
 /**
  * @file chacha20_poly1305.c
- * @brief ChaCha20-Poly1305 AEAD cipher (RFC 8439) — pure software path.
+ * @brief ChaCha20-Poly1305 AEAD cipher (RFC 8439).
  *
  * Implements the full ChaCha20 keystream generator and the Poly1305 MAC.
- * No hardware acceleration is used; this is the portable fallback invoked
- * by the security engine when TTAK_SECURITY_CHACHA20_POLY1305 is requested.
+ *
+ * The keystream is generated 4, 8 or 16 blocks at a time (SSE2/NEON, AVX2,
+ * AVX-512) with one block per vector lane, capped by the lane width of the
+ * driver ttak_security_pick_driver() returns. Poly1305 runs four blocks per
+ * step on AVX2 using precomputed r^1..r^4, radix 2^44 with 128-bit products
+ * on other 64-bit hosts, and radix 2^26 elsewhere. Large batches can move
+ * their keystream to a GPU backend, leaving only Poly1305 on the CPU.
  */
 
 #include <ttak/security/security_engine.h>
+#include <ttak/arch/ttak_arch.h>
+
+#include "../../internal/ttak/security_accel.h"
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -21,13 +29,65 @@
 #define TTAK_CHACHA_BLOCK_BYTES 64U
 #define TTAK_POLY1305_BLOCK_BYTES 16U
 #define TTAK_POLY1305_MASK26 0x3FFFFFFULL
-#define TTAK_POLY1305_HIBIT (1ULL << 24)
+
+/**
+ * @def TTAK_CHACHA_MAX_LANES
+ * @brief Widest keystream kernel compiled in, in blocks.
+ */
+#if defined(TTAK_HAS_AVX512F)
+#  include <immintrin.h>
+#  define TTAK_CHACHA_MAX_LANES 16U
+#elif defined(TTAK_HAS_AVX2)
+#  include <immintrin.h>
+#  define TTAK_CHACHA_MAX_LANES 8U
+#elif defined(TTAK_HAS_SSE2)
+#  include <emmintrin.h>
+#  define TTAK_CHACHA_MAX_LANES 4U
+#elif defined(TTAK_HAS_NEON) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  include <arm_neon.h>
+#  define TTAK_CHACHA_MAX_LANES 4U
+#else
+#  define TTAK_CHACHA_MAX_LANES 1U
+#endif
+
+/*
+ * Poly1305 limb layout: radix 2^26 when AVX2 can run four blocks per step
+ * (and where no 128-bit product exists), radix 2^44 otherwise.
+ */
+#if !defined(TTAK_HAS_AVX2) && defined(__SIZEOF_INT128__)
+#  define TTAK_POLY1305_RADIX44 1
+#  define TTAK_POLY1305_MASK44 0xFFFFFFFFFFFULL
+#  define TTAK_POLY1305_MASK42 0x3FFFFFFFFFFULL
+#  define TTAK_POLY1305_HIBIT (1ULL << 40)
+#else
+#  define TTAK_POLY1305_RADIX44 0
+#  define TTAK_POLY1305_HIBIT (1ULL << 24)
+#endif
+
+/**
+ * @def TTAK_POLY1305_VECTOR_MIN_BLOCKS
+ * @brief Shortest run, in 16-byte blocks, worth the AVX2 four-way path.
+ */
+#ifndef TTAK_POLY1305_VECTOR_MIN_BLOCKS
+#define TTAK_POLY1305_VECTOR_MIN_BLOCKS 8U
+#endif
+
+/**
+ * @def TTAK_CHACHA_CHUNK_BLOCKS
+ * @brief Keystream blocks generated per pass of the execute loop.
+ */
+#ifndef TTAK_CHACHA_CHUNK_BLOCKS
+#define TTAK_CHACHA_CHUNK_BLOCKS 32U
+#endif
 
 typedef struct {
     uint64_t r[5];
     uint64_t r5[5];
     uint64_t h[5];
     uint64_t pad[2];
+#if defined(TTAK_HAS_AVX2)
+    uint64_t rpow[5][4]; /**< rpow[i][j]: limb i of r^(4 - j), the multiplier of lane j. */
+#endif
     uint8_t buffer[TTAK_POLY1305_BLOCK_BYTES];
     size_t buffer_used;
 } ttak_poly1305_state_t;
@@ -117,10 +177,423 @@ static void ttak_chacha20_block(uint8_t out[TTAK_CHACHA_BLOCK_BYTES],
     }
 }
 
+/*
+ * Vector keystream kernels keep one block per lane: x[i] holds word i of
+ * every block, so the quarter rounds are the scalar ones on vectors. The
+ * lanes differ only in their counter. Afterwards each group of four words
+ * is transposed 4x4 within 128-bit lanes, which leaves 16-byte runs of
+ * single blocks to store.
+ */
+#define TTAK_CHACHA_VQR(a, b, c, d, ADD, XOR, R16, R12, R8, R7) \
+    do {                                                        \
+        (a) = ADD((a), (b)); (d) = R16(XOR((d), (a)));          \
+        (c) = ADD((c), (d)); (b) = R12(XOR((b), (c)));          \
+        (a) = ADD((a), (b)); (d) = R8(XOR((d), (a)));           \
+        (c) = ADD((c), (d)); (b) = R7(XOR((b), (c)));           \
+    } while (0)
+
+#define TTAK_CHACHA_VROUNDS(x, ADD, XOR, R16, R12, R8, R7)                              \
+    for (int round = 0; round < 10; ++round) {                                         \
+        TTAK_CHACHA_VQR(x[0], x[4], x[8], x[12], ADD, XOR, R16, R12, R8, R7);          \
+        TTAK_CHACHA_VQR(x[1], x[5], x[9], x[13], ADD, XOR, R16, R12, R8, R7);          \
+        TTAK_CHACHA_VQR(x[2], x[6], x[10], x[14], ADD, XOR, R16, R12, R8, R7);         \
+        TTAK_CHACHA_VQR(x[3], x[7], x[11], x[15], ADD, XOR, R16, R12, R8, R7);         \
+        TTAK_CHACHA_VQR(x[0], x[5], x[10], x[15], ADD, XOR, R16, R12, R8, R7);         \
+        TTAK_CHACHA_VQR(x[1], x[6], x[11], x[12], ADD, XOR, R16, R12, R8, R7);         \
+        TTAK_CHACHA_VQR(x[2], x[7], x[8], x[13], ADD, XOR, R16, R12, R8, R7);          \
+        TTAK_CHACHA_VQR(x[3], x[4], x[9], x[14], ADD, XOR, R16, R12, R8, R7);          \
+    }
+
+static inline void ttak_chacha20_init_words(uint32_t w[16], const uint32_t key[8], uint32_t counter,
+                                            const uint32_t nonce[3]) {
+    w[0] = TTAK_CHACHA_CONST0;
+    w[1] = TTAK_CHACHA_CONST1;
+    w[2] = TTAK_CHACHA_CONST2;
+    w[3] = TTAK_CHACHA_CONST3;
+    memcpy(w + 4, key, 8 * sizeof(uint32_t));
+    w[12] = counter;
+    memcpy(w + 13, nonce, 3 * sizeof(uint32_t));
+}
+
+/*
+ * Each width has a core that runs the rounds from per-lane input words and
+ * stores lane j's block at out + 64 j. blocksN() feeds it one key with
+ * consecutive counters; lanesN() feeds it words[i][j], word i of lane j,
+ * so the lanes may belong to different messages.
+ */
+#if defined(TTAK_HAS_AVX512F)
+#define TTAK_V16_ADD(a, b) _mm512_add_epi32((a), (b))
+#define TTAK_V16_XOR(a, b) _mm512_xor_si512((a), (b))
+#define TTAK_V16_R16(a) _mm512_rol_epi32((a), 16)
+#define TTAK_V16_R12(a) _mm512_rol_epi32((a), 12)
+#define TTAK_V16_R8(a)  _mm512_rol_epi32((a), 8)
+#define TTAK_V16_R7(a)  _mm512_rol_epi32((a), 7)
+
+static inline void ttak_chacha20_core16(uint8_t *out, const __m512i in[16]) {
+    __m512i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = in[i];
+
+    TTAK_CHACHA_VROUNDS(x, TTAK_V16_ADD, TTAK_V16_XOR, TTAK_V16_R16, TTAK_V16_R12, TTAK_V16_R8, TTAK_V16_R7)
+
+    /* t[g][j], 128-bit lane k: words 4g..4g+3 of block 4k + j. */
+    __m512i t[4][4];
+    for (int g = 0; g < 4; ++g) {
+        __m512i a0 = _mm512_add_epi32(x[4 * g + 0], in[4 * g + 0]);
+        __m512i a1 = _mm512_add_epi32(x[4 * g + 1], in[4 * g + 1]);
+        __m512i a2 = _mm512_add_epi32(x[4 * g + 2], in[4 * g + 2]);
+        __m512i a3 = _mm512_add_epi32(x[4 * g + 3], in[4 * g + 3]);
+        __m512i lo01 = _mm512_unpacklo_epi32(a0, a1), hi01 = _mm512_unpackhi_epi32(a0, a1);
+        __m512i lo23 = _mm512_unpacklo_epi32(a2, a3), hi23 = _mm512_unpackhi_epi32(a2, a3);
+        t[g][0] = _mm512_unpacklo_epi64(lo01, lo23);
+        t[g][1] = _mm512_unpackhi_epi64(lo01, lo23);
+        t[g][2] = _mm512_unpacklo_epi64(hi01, hi23);
+        t[g][3] = _mm512_unpackhi_epi64(hi01, hi23);
+    }
+    /* Gather lane k of t[0..3][j] into one register: the whole of block 4k + j. */
+    for (int j = 0; j < 4; ++j) {
+        __m512i p02 = _mm512_shuffle_i32x4(t[0][j], t[1][j], _MM_SHUFFLE(2, 0, 2, 0));
+        __m512i q02 = _mm512_shuffle_i32x4(t[2][j], t[3][j], _MM_SHUFFLE(2, 0, 2, 0));
+        __m512i p13 = _mm512_shuffle_i32x4(t[0][j], t[1][j], _MM_SHUFFLE(3, 1, 3, 1));
+        __m512i q13 = _mm512_shuffle_i32x4(t[2][j], t[3][j], _MM_SHUFFLE(3, 1, 3, 1));
+        _mm512_storeu_si512((void *)(out + 64 * (0 + j)), _mm512_shuffle_i32x4(p02, q02, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm512_storeu_si512((void *)(out + 64 * (8 + j)), _mm512_shuffle_i32x4(p02, q02, _MM_SHUFFLE(3, 1, 3, 1)));
+        _mm512_storeu_si512((void *)(out + 64 * (4 + j)), _mm512_shuffle_i32x4(p13, q13, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm512_storeu_si512((void *)(out + 64 * (12 + j)), _mm512_shuffle_i32x4(p13, q13, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+}
+
+/** @brief Sixteen keystream blocks for counters counter .. counter + 15. */
+static void ttak_chacha20_blocks16(uint8_t *out, const uint32_t key[8], uint32_t counter, const uint32_t nonce[3]) {
+    uint32_t w[16];
+    ttak_chacha20_init_words(w, key, counter, nonce);
+    __m512i in[16];
+    for (int i = 0; i < 16; ++i) in[i] = _mm512_set1_epi32((int)w[i]);
+    in[12] = _mm512_add_epi32(in[12], _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    ttak_chacha20_core16(out, in);
+}
+
+/** @brief Sixteen independent blocks, lane j from words[0..15][j]. */
+static void ttak_chacha20_lanes16(uint8_t *out, const uint32_t words[16][16]) {
+    __m512i in[16];
+    for (int i = 0; i < 16; ++i) in[i] = _mm512_loadu_si512((const void *)words[i]);
+    ttak_chacha20_core16(out, in);
+}
+#endif
+
+#if defined(TTAK_HAS_AVX2)
+#define TTAK_V8_ADD(a, b) _mm256_add_epi32((a), (b))
+#define TTAK_V8_XOR(a, b) _mm256_xor_si256((a), (b))
+#define TTAK_V8_ROT(a, n) _mm256_or_si256(_mm256_slli_epi32((a), (n)), _mm256_srli_epi32((a), 32 - (n)))
+#define TTAK_V8_R16(a) _mm256_shuffle_epi8((a), rot16)
+#define TTAK_V8_R12(a) TTAK_V8_ROT((a), 12)
+#define TTAK_V8_R8(a)  _mm256_shuffle_epi8((a), rot8)
+#define TTAK_V8_R7(a)  TTAK_V8_ROT((a), 7)
+
+static inline void ttak_chacha20_core8(uint8_t *out, const __m256i in[16]) {
+    const __m256i rot16 = _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                          13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    const __m256i rot8 = _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+                                         14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+    __m256i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = in[i];
+
+    TTAK_CHACHA_VROUNDS(x, TTAK_V8_ADD, TTAK_V8_XOR, TTAK_V8_R16, TTAK_V8_R12, TTAK_V8_R8, TTAK_V8_R7)
+
+    /* t[g][j], 128-bit lane k: words 4g..4g+3 of block 4k + j. */
+    __m256i t[4][4];
+    for (int g = 0; g < 4; ++g) {
+        __m256i a0 = _mm256_add_epi32(x[4 * g + 0], in[4 * g + 0]);
+        __m256i a1 = _mm256_add_epi32(x[4 * g + 1], in[4 * g + 1]);
+        __m256i a2 = _mm256_add_epi32(x[4 * g + 2], in[4 * g + 2]);
+        __m256i a3 = _mm256_add_epi32(x[4 * g + 3], in[4 * g + 3]);
+        __m256i lo01 = _mm256_unpacklo_epi32(a0, a1), hi01 = _mm256_unpackhi_epi32(a0, a1);
+        __m256i lo23 = _mm256_unpacklo_epi32(a2, a3), hi23 = _mm256_unpackhi_epi32(a2, a3);
+        t[g][0] = _mm256_unpacklo_epi64(lo01, lo23);
+        t[g][1] = _mm256_unpackhi_epi64(lo01, lo23);
+        t[g][2] = _mm256_unpacklo_epi64(hi01, hi23);
+        t[g][3] = _mm256_unpackhi_epi64(hi01, hi23);
+    }
+    for (int j = 0; j < 4; ++j) {
+        uint8_t *b_lo = out + 64 * j, *b_hi = out + 64 * (4 + j);
+        _mm256_storeu_si256((__m256i *)(b_lo + 0), _mm256_permute2x128_si256(t[0][j], t[1][j], 0x20));
+        _mm256_storeu_si256((__m256i *)(b_lo + 32), _mm256_permute2x128_si256(t[2][j], t[3][j], 0x20));
+        _mm256_storeu_si256((__m256i *)(b_hi + 0), _mm256_permute2x128_si256(t[0][j], t[1][j], 0x31));
+        _mm256_storeu_si256((__m256i *)(b_hi + 32), _mm256_permute2x128_si256(t[2][j], t[3][j], 0x31));
+    }
+}
+
+/** @brief Eight keystream blocks for counters counter .. counter + 7. */
+static void ttak_chacha20_blocks8(uint8_t *out, const uint32_t key[8], uint32_t counter, const uint32_t nonce[3]) {
+    uint32_t w[16];
+    ttak_chacha20_init_words(w, key, counter, nonce);
+    __m256i in[16];
+    for (int i = 0; i < 16; ++i) in[i] = _mm256_set1_epi32((int)w[i]);
+    in[12] = _mm256_add_epi32(in[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    ttak_chacha20_core8(out, in);
+}
+
+/** @brief Eight independent blocks, lane j from words[0..15][j]. */
+static void ttak_chacha20_lanes8(uint8_t *out, const uint32_t words[16][8]) {
+    __m256i in[16];
+    for (int i = 0; i < 16; ++i) in[i] = _mm256_loadu_si256((const __m256i *)(const void *)words[i]);
+    ttak_chacha20_core8(out, in);
+}
+#endif
+
+#if defined(TTAK_HAS_SSE2)
+#define TTAK_V4_ADD(a, b) _mm_add_epi32((a), (b))
+#define TTAK_V4_XOR(a, b) _mm_xor_si128((a), (b))
+#define TTAK_V4_ROT(a, n) _mm_or_si128(_mm_slli_epi32((a), (n)), _mm_srli_epi32((a), 32 - (n)))
+#define TTAK_V4_R16(a) _mm_shufflehi_epi16(_mm_shufflelo_epi16((a), 0xB1), 0xB1)
+#define TTAK_V4_R12(a) TTAK_V4_ROT((a), 12)
+#define TTAK_V4_R8(a)  TTAK_V4_ROT((a), 8)
+#define TTAK_V4_R7(a)  TTAK_V4_ROT((a), 7)
+
+static inline void ttak_chacha20_core4(uint8_t *out, const __m128i in[16]) {
+    __m128i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = in[i];
+
+    TTAK_CHACHA_VROUNDS(x, TTAK_V4_ADD, TTAK_V4_XOR, TTAK_V4_R16, TTAK_V4_R12, TTAK_V4_R8, TTAK_V4_R7)
+
+    for (int g = 0; g < 4; ++g) {
+        __m128i a0 = _mm_add_epi32(x[4 * g + 0], in[4 * g + 0]);
+        __m128i a1 = _mm_add_epi32(x[4 * g + 1], in[4 * g + 1]);
+        __m128i a2 = _mm_add_epi32(x[4 * g + 2], in[4 * g + 2]);
+        __m128i a3 = _mm_add_epi32(x[4 * g + 3], in[4 * g + 3]);
+        __m128i lo01 = _mm_unpacklo_epi32(a0, a1), hi01 = _mm_unpackhi_epi32(a0, a1);
+        __m128i lo23 = _mm_unpacklo_epi32(a2, a3), hi23 = _mm_unpackhi_epi32(a2, a3);
+        _mm_storeu_si128((__m128i *)(out + 0 * 64 + 16 * g), _mm_unpacklo_epi64(lo01, lo23));
+        _mm_storeu_si128((__m128i *)(out + 1 * 64 + 16 * g), _mm_unpackhi_epi64(lo01, lo23));
+        _mm_storeu_si128((__m128i *)(out + 2 * 64 + 16 * g), _mm_unpacklo_epi64(hi01, hi23));
+        _mm_storeu_si128((__m128i *)(out + 3 * 64 + 16 * g), _mm_unpackhi_epi64(hi01, hi23));
+    }
+}
+
+/** @brief Four keystream blocks for counters counter .. counter + 3. */
+static void ttak_chacha20_blocks4(uint8_t *out, const uint32_t key[8], uint32_t counter, const uint32_t nonce[3]) {
+    uint32_t w[16];
+    ttak_chacha20_init_words(w, key, counter, nonce);
+    __m128i in[16];
+    for (int i = 0; i < 16; ++i) in[i] = _mm_set1_epi32((int)w[i]);
+    in[12] = _mm_add_epi32(in[12], _mm_set_epi32(3, 2, 1, 0));
+    ttak_chacha20_core4(out, in);
+}
+
+/** @brief Four independent blocks, lane j from words[0..15][j]. */
+static void ttak_chacha20_lanes4(uint8_t *out, const uint32_t words[16][4]) {
+    __m128i in[16];
+    for (int i = 0; i < 16; ++i) in[i] = _mm_loadu_si128((const __m128i *)(const void *)words[i]);
+    ttak_chacha20_core4(out, in);
+}
+#elif TTAK_CHACHA_MAX_LANES == 4U
+#define TTAK_V4_ADD(a, b) vaddq_u32((a), (b))
+#define TTAK_V4_XOR(a, b) veorq_u32((a), (b))
+#define TTAK_V4_ROT(a, n) vsriq_n_u32(vshlq_n_u32((a), (n)), (a), 32 - (n))
+#define TTAK_V4_R16(a) vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(a)))
+#define TTAK_V4_R12(a) TTAK_V4_ROT((a), 12)
+#define TTAK_V4_R8(a)  TTAK_V4_ROT((a), 8)
+#define TTAK_V4_R7(a)  TTAK_V4_ROT((a), 7)
+
+static inline void ttak_chacha20_core4(uint8_t *out, const uint32x4_t in[16]) {
+    uint32x4_t x[16];
+    for (int i = 0; i < 16; ++i) x[i] = in[i];
+
+    TTAK_CHACHA_VROUNDS(x, TTAK_V4_ADD, TTAK_V4_XOR, TTAK_V4_R16, TTAK_V4_R12, TTAK_V4_R8, TTAK_V4_R7)
+
+    for (int g = 0; g < 4; ++g) {
+        uint32x4x2_t t01 = vtrnq_u32(vaddq_u32(x[4 * g + 0], in[4 * g + 0]), vaddq_u32(x[4 * g + 1], in[4 * g + 1]));
+        uint32x4x2_t t23 = vtrnq_u32(vaddq_u32(x[4 * g + 2], in[4 * g + 2]), vaddq_u32(x[4 * g + 3], in[4 * g + 3]));
+        vst1q_u32((uint32_t *)(void *)(out + 0 * 64 + 16 * g), vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+        vst1q_u32((uint32_t *)(void *)(out + 1 * 64 + 16 * g), vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+        vst1q_u32((uint32_t *)(void *)(out + 2 * 64 + 16 * g), vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+        vst1q_u32((uint32_t *)(void *)(out + 3 * 64 + 16 * g), vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+    }
+}
+
+/** @brief Four keystream blocks for counters counter .. counter + 3. */
+static void ttak_chacha20_blocks4(uint8_t *out, const uint32_t key[8], uint32_t counter, const uint32_t nonce[3]) {
+    static const uint32_t lane_offsets[4] = { 0, 1, 2, 3 };
+    uint32_t w[16];
+    ttak_chacha20_init_words(w, key, counter, nonce);
+    uint32x4_t in[16];
+    for (int i = 0; i < 16; ++i) in[i] = vdupq_n_u32(w[i]);
+    in[12] = vaddq_u32(in[12], vld1q_u32(lane_offsets));
+    ttak_chacha20_core4(out, in);
+}
+
+/** @brief Four independent blocks, lane j from words[0..15][j]. */
+static void ttak_chacha20_lanes4(uint8_t *out, const uint32_t words[16][4]) {
+    uint32x4_t in[16];
+    for (int i = 0; i < 16; ++i) in[i] = vld1q_u32(words[i]);
+    ttak_chacha20_core4(out, in);
+}
+#endif
+
+/**
+ * @brief Keystream for @p blocks blocks starting at @p counter.
+ *
+ * Uses the widest kernel that fits both the remaining blocks and
+ * @p lanes, the driver's preferred parallel block count.
+ */
+static void ttak_chacha20_keystream(uint8_t *out, const uint32_t key[8], uint32_t counter, const uint32_t nonce[3],
+                                    size_t blocks, size_t lanes) {
+#if defined(TTAK_HAS_AVX512F)
+    for (; lanes >= 16U && blocks >= 16U; blocks -= 16U, counter += 16U, out += 16U * TTAK_CHACHA_BLOCK_BYTES) {
+        ttak_chacha20_blocks16(out, key, counter, nonce);
+    }
+#endif
+#if defined(TTAK_HAS_AVX2)
+    for (; lanes >= 8U && blocks >= 8U; blocks -= 8U, counter += 8U, out += 8U * TTAK_CHACHA_BLOCK_BYTES) {
+        ttak_chacha20_blocks8(out, key, counter, nonce);
+    }
+#endif
+#if TTAK_CHACHA_MAX_LANES >= 4U
+    for (; lanes >= 4U && blocks >= 4U; blocks -= 4U, counter += 4U, out += 4U * TTAK_CHACHA_BLOCK_BYTES) {
+        ttak_chacha20_blocks4(out, key, counter, nonce);
+    }
+#endif
+    (void)lanes;
+    for (; blocks > 0; blocks--, counter++, out += TTAK_CHACHA_BLOCK_BYTES) {
+        ttak_chacha20_block(out, key, counter, nonce);
+    }
+}
+
+#if TTAK_POLY1305_RADIX44
+/*
+ * Radix 2^44 (44 + 44 + 42 bits): three limbs, nine 64x64->128 products
+ * per block. r and h use the first three entries of their arrays and r5
+ * holds 20 r1 and 20 r2 for the wrapped terms.
+ */
 static void ttak_poly1305_blocks(ttak_poly1305_state_t *st,
                                  const uint8_t *m,
                                  size_t bytes,
                                  uint64_t hibit) {
+    typedef unsigned __int128 u128;
+    const uint64_t r0 = st->r[0];
+    const uint64_t r1 = st->r[1];
+    const uint64_t r2 = st->r[2];
+    const uint64_t s1 = st->r5[1];
+    const uint64_t s2 = st->r5[2];
+    uint64_t h0 = st->h[0];
+    uint64_t h1 = st->h[1];
+    uint64_t h2 = st->h[2];
+
+    while (bytes >= TTAK_POLY1305_BLOCK_BYTES) {
+        uint64_t t0 = ttak_load64_le(m);
+        uint64_t t1 = ttak_load64_le(m + 8);
+
+        h0 += t0 & TTAK_POLY1305_MASK44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & TTAK_POLY1305_MASK44;
+        h2 += ((t1 >> 24) & TTAK_POLY1305_MASK42) | hibit;
+
+        u128 d0 = (u128)h0 * r0 + (u128)h1 * s2 + (u128)h2 * s1;
+        u128 d1 = (u128)h0 * r1 + (u128)h1 * r0 + (u128)h2 * s2;
+        u128 d2 = (u128)h0 * r2 + (u128)h1 * r1 + (u128)h2 * r0;
+
+        uint64_t c = (uint64_t)(d0 >> 44);
+        h0 = (uint64_t)d0 & TTAK_POLY1305_MASK44;
+        d1 += c;
+        c = (uint64_t)(d1 >> 44);
+        h1 = (uint64_t)d1 & TTAK_POLY1305_MASK44;
+        d2 += c;
+        c = (uint64_t)(d2 >> 42);
+        h2 = (uint64_t)d2 & TTAK_POLY1305_MASK42;
+        h0 += c * 5U;
+        c = h0 >> 44;
+        h0 &= TTAK_POLY1305_MASK44;
+        h1 += c;
+
+        m += TTAK_POLY1305_BLOCK_BYTES;
+        bytes -= TTAK_POLY1305_BLOCK_BYTES;
+    }
+
+    st->h[0] = h0;
+    st->h[1] = h1;
+    st->h[2] = h2;
+}
+
+static void ttak_poly1305_init(ttak_poly1305_state_t *st,
+                               const uint8_t key[32]) {
+    uint64_t t0 = ttak_load64_le(key + 0);
+    uint64_t t1 = ttak_load64_le(key + 8);
+
+    memset(st->r, 0, sizeof(st->r));
+    memset(st->r5, 0, sizeof(st->r5));
+    st->r[0] = t0 & 0xFFC0FFFFFFFULL;
+    st->r[1] = ((t0 >> 44) | (t1 << 20)) & 0xFFFFFC0FFFFULL;
+    st->r[2] = (t1 >> 24) & 0x00FFFFFFC0FULL;
+    st->r5[1] = st->r[1] * 20U;
+    st->r5[2] = st->r[2] * 20U;
+
+    memset(st->h, 0, sizeof(st->h));
+    st->pad[0] = ttak_load64_le(key + 16);
+    st->pad[1] = ttak_load64_le(key + 24);
+    st->buffer_used = 0;
+}
+
+/** @brief Fully reduces h, adds the pad and writes the tag. */
+static void ttak_poly1305_emit(ttak_poly1305_state_t *st, uint8_t mac[16]) {
+    uint64_t h0 = st->h[0];
+    uint64_t h1 = st->h[1];
+    uint64_t h2 = st->h[2];
+
+    uint64_t c = h1 >> 44;
+    h1 &= TTAK_POLY1305_MASK44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= TTAK_POLY1305_MASK42;
+    h0 += c * 5U;
+    c = h0 >> 44;
+    h0 &= TTAK_POLY1305_MASK44;
+    h1 += c;
+    c = h1 >> 44;
+    h1 &= TTAK_POLY1305_MASK44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= TTAK_POLY1305_MASK42;
+    h0 += c * 5U;
+    c = h0 >> 44;
+    h0 &= TTAK_POLY1305_MASK44;
+    h1 += c;
+
+    uint64_t g0 = h0 + 5U;
+    c = g0 >> 44;
+    g0 &= TTAK_POLY1305_MASK44;
+    uint64_t g1 = h1 + c;
+    c = g1 >> 44;
+    g1 &= TTAK_POLY1305_MASK44;
+    uint64_t g2 = h2 + c - (1ULL << 42);
+
+    uint64_t mask = (g2 >> 63) - 1ULL;
+    g0 &= mask;
+    g1 &= mask;
+    g2 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+
+    uint64_t t0 = st->pad[0];
+    uint64_t t1 = st->pad[1];
+    h0 += t0 & TTAK_POLY1305_MASK44;
+    c = h0 >> 44;
+    h0 &= TTAK_POLY1305_MASK44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & TTAK_POLY1305_MASK44) + c;
+    c = h1 >> 44;
+    h1 &= TTAK_POLY1305_MASK44;
+    h2 += ((t1 >> 24) & TTAK_POLY1305_MASK42) + c;
+    h2 &= TTAK_POLY1305_MASK42;
+
+    ttak_store64_le(mac, h0 | (h1 << 44));
+    ttak_store64_le(mac + 8, (h1 >> 20) | (h2 << 24));
+}
+
+#else /* radix 2^26 */
+
+static void ttak_poly1305_blocks_scalar(ttak_poly1305_state_t *st,
+                                        const uint8_t *m,
+                                        size_t bytes,
+                                        uint64_t hibit) {
     uint64_t h0 = st->h[0];
     uint64_t h1 = st->h[1];
     uint64_t h2 = st->h[2];
@@ -185,6 +658,183 @@ static void ttak_poly1305_blocks(ttak_poly1305_state_t *st,
     st->h[4] = h4;
 }
 
+#if defined(TTAK_HAS_AVX2)
+/** @brief h = h r mod 2^130 - 5 in radix 2^26, used to precompute the powers of r. */
+static void ttak_poly1305_mul26(uint64_t h[5], const uint64_t r[5]) {
+    uint64_t s1 = r[1] * 5U, s2 = r[2] * 5U, s3 = r[3] * 5U, s4 = r[4] * 5U;
+    uint64_t d0 = h[0] * r[0] + h[1] * s4 + h[2] * s3 + h[3] * s2 + h[4] * s1;
+    uint64_t d1 = h[0] * r[1] + h[1] * r[0] + h[2] * s4 + h[3] * s3 + h[4] * s2;
+    uint64_t d2 = h[0] * r[2] + h[1] * r[1] + h[2] * r[0] + h[3] * s4 + h[4] * s3;
+    uint64_t d3 = h[0] * r[3] + h[1] * r[2] + h[2] * r[1] + h[3] * r[0] + h[4] * s4;
+    uint64_t d4 = h[0] * r[4] + h[1] * r[3] + h[2] * r[2] + h[3] * r[1] + h[4] * r[0];
+    uint64_t c = d0 >> 26;
+    d0 &= TTAK_POLY1305_MASK26;
+    d1 += c;
+    c = d1 >> 26;
+    d1 &= TTAK_POLY1305_MASK26;
+    d2 += c;
+    c = d2 >> 26;
+    d2 &= TTAK_POLY1305_MASK26;
+    d3 += c;
+    c = d3 >> 26;
+    d3 &= TTAK_POLY1305_MASK26;
+    d4 += c;
+    c = d4 >> 26;
+    d4 &= TTAK_POLY1305_MASK26;
+    d0 += c * 5U;
+    c = d0 >> 26;
+    d0 &= TTAK_POLY1305_MASK26;
+    d1 += c;
+    h[0] = d0;
+    h[1] = d1;
+    h[2] = d2;
+    h[3] = d3;
+    h[4] = d4;
+}
+
+/* One vector carry pass over five radix-2^26 limbs in 64-bit lanes. */
+#define TTAK_POLY_V_CARRY(d0, d1, d2, d3, d4, mask)                                          \
+    do {                                                                                   \
+        __m256i c_;                                                                        \
+        c_ = _mm256_srli_epi64((d0), 26); (d0) = _mm256_and_si256((d0), (mask));           \
+        (d1) = _mm256_add_epi64((d1), c_);                                                 \
+        c_ = _mm256_srli_epi64((d3), 26); (d3) = _mm256_and_si256((d3), (mask));           \
+        (d4) = _mm256_add_epi64((d4), c_);                                                 \
+        c_ = _mm256_srli_epi64((d1), 26); (d1) = _mm256_and_si256((d1), (mask));           \
+        (d2) = _mm256_add_epi64((d2), c_);                                                 \
+        c_ = _mm256_srli_epi64((d4), 26); (d4) = _mm256_and_si256((d4), (mask));           \
+        (d0) = _mm256_add_epi64((d0), _mm256_add_epi64(c_, _mm256_slli_epi64(c_, 2)));    \
+        c_ = _mm256_srli_epi64((d2), 26); (d2) = _mm256_and_si256((d2), (mask));           \
+        (d3) = _mm256_add_epi64((d3), c_);                                                 \
+        c_ = _mm256_srli_epi64((d0), 26); (d0) = _mm256_and_si256((d0), (mask));           \
+        (d1) = _mm256_add_epi64((d1), c_);                                                 \
+        c_ = _mm256_srli_epi64((d3), 26); (d3) = _mm256_and_si256((d3), (mask));           \
+        (d4) = _mm256_add_epi64((d4), c_);                                                 \
+    } while (0)
+
+/* d = a r for five-limb vectors, with s = 5 r for the wrapped terms. */
+#define TTAK_POLY_V_MUL(d, a, r, s)                                                               \
+    do {                                                                                        \
+        (d)[0] = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[0], (r)[0]),              \
+                                                   _mm256_mul_epu32((a)[1], (s)[4])),             \
+                                  _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[2], (s)[3]), \
+                                                                    _mm256_mul_epu32((a)[3], (s)[2])), \
+                                                   _mm256_mul_epu32((a)[4], (s)[1])));            \
+        (d)[1] = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[0], (r)[1]),              \
+                                                   _mm256_mul_epu32((a)[1], (r)[0])),             \
+                                  _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[2], (s)[4]), \
+                                                                    _mm256_mul_epu32((a)[3], (s)[3])), \
+                                                   _mm256_mul_epu32((a)[4], (s)[2])));            \
+        (d)[2] = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[0], (r)[2]),              \
+                                                   _mm256_mul_epu32((a)[1], (r)[1])),             \
+                                  _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[2], (r)[0]), \
+                                                                    _mm256_mul_epu32((a)[3], (s)[4])), \
+                                                   _mm256_mul_epu32((a)[4], (s)[3])));            \
+        (d)[3] = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[0], (r)[3]),              \
+                                                   _mm256_mul_epu32((a)[1], (r)[2])),             \
+                                  _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[2], (r)[1]), \
+                                                                    _mm256_mul_epu32((a)[3], (r)[0])), \
+                                                   _mm256_mul_epu32((a)[4], (s)[4])));            \
+        (d)[4] = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[0], (r)[4]),              \
+                                                   _mm256_mul_epu32((a)[1], (r)[3])),             \
+                                  _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32((a)[2], (r)[2]), \
+                                                                    _mm256_mul_epu32((a)[3], (r)[1])), \
+                                                   _mm256_mul_epu32((a)[4], (r)[0])));            \
+    } while (0)
+
+/** @brief Splits blocks m .. m + 3 into five 26-bit limb vectors, lane j holding block j. */
+static inline void ttak_poly1305_load4(__m256i l[5], const uint8_t *m, __m256i mask, __m256i hibit) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(const void *)m);
+    __m256i y = _mm256_loadu_si256((const __m256i *)(const void *)(m + 32));
+    __m256i lo = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(x, y), 0xD8);
+    __m256i hi = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(x, y), 0xD8);
+    l[0] = _mm256_and_si256(lo, mask);
+    l[1] = _mm256_and_si256(_mm256_srli_epi64(lo, 26), mask);
+    l[2] = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(lo, 52), _mm256_slli_epi64(hi, 12)), mask);
+    l[3] = _mm256_and_si256(_mm256_srli_epi64(hi, 14), mask);
+    l[4] = _mm256_or_si256(_mm256_srli_epi64(hi, 40), hibit);
+}
+
+/**
+ * @brief Absorbs a multiple of four blocks, four at a time.
+ *
+ * Lane j accumulates blocks j, j + 4, ...: each step is A = (A + M) r^4,
+ * and the last group is weighted by r^4, r^3, r^2, r before the lanes are
+ * summed back into h.
+ */
+static void ttak_poly1305_blocks4(ttak_poly1305_state_t *st,
+                                  const uint8_t *m,
+                                  size_t bytes,
+                                  uint64_t hibit) {
+    const __m256i mask = _mm256_set1_epi64x((long long)TTAK_POLY1305_MASK26);
+    const __m256i hib = _mm256_set1_epi64x((long long)hibit);
+    __m256i r4[5], s4[5], a[5], msg[5], d[5];
+    for (int i = 0; i < 5; ++i) {
+        r4[i] = _mm256_set1_epi64x((long long)st->rpow[i][0]);
+        s4[i] = _mm256_set1_epi64x((long long)(st->rpow[i][0] * 5U));
+        a[i] = _mm256_set_epi64x(0, 0, 0, (long long)st->h[i]);
+    }
+
+    for (; bytes > 4U * TTAK_POLY1305_BLOCK_BYTES; bytes -= 4U * TTAK_POLY1305_BLOCK_BYTES) {
+        ttak_poly1305_load4(msg, m, mask, hib);
+        for (int i = 0; i < 5; ++i) a[i] = _mm256_add_epi64(a[i], msg[i]);
+        TTAK_POLY_V_MUL(d, a, r4, s4);
+        TTAK_POLY_V_CARRY(d[0], d[1], d[2], d[3], d[4], mask);
+        for (int i = 0; i < 5; ++i) a[i] = d[i];
+        m += 4U * TTAK_POLY1305_BLOCK_BYTES;
+    }
+
+    __m256i rp[5], sp[5];
+    ttak_poly1305_load4(msg, m, mask, hib);
+    for (int i = 0; i < 5; ++i) {
+        a[i] = _mm256_add_epi64(a[i], msg[i]);
+        rp[i] = _mm256_loadu_si256((const __m256i *)(const void *)st->rpow[i]);
+        sp[i] = _mm256_add_epi64(rp[i], _mm256_slli_epi64(rp[i], 2));
+    }
+    TTAK_POLY_V_MUL(d, a, rp, sp);
+
+    uint64_t lanes[5][4], h[5];
+    for (int i = 0; i < 5; ++i) {
+        _mm256_storeu_si256((__m256i *)(void *)lanes[i], d[i]);
+        h[i] = lanes[i][0] + lanes[i][1] + lanes[i][2] + lanes[i][3];
+    }
+    uint64_t c = h[0] >> 26;
+    h[0] &= TTAK_POLY1305_MASK26;
+    h[1] += c;
+    c = h[1] >> 26;
+    h[1] &= TTAK_POLY1305_MASK26;
+    h[2] += c;
+    c = h[2] >> 26;
+    h[2] &= TTAK_POLY1305_MASK26;
+    h[3] += c;
+    c = h[3] >> 26;
+    h[3] &= TTAK_POLY1305_MASK26;
+    h[4] += c;
+    c = h[4] >> 26;
+    h[4] &= TTAK_POLY1305_MASK26;
+    h[0] += c * 5U;
+    c = h[0] >> 26;
+    h[0] &= TTAK_POLY1305_MASK26;
+    h[1] += c;
+    memcpy(st->h, h, sizeof(h));
+}
+#endif
+
+static void ttak_poly1305_blocks(ttak_poly1305_state_t *st,
+                                 const uint8_t *m,
+                                 size_t bytes,
+                                 uint64_t hibit) {
+#if defined(TTAK_HAS_AVX2)
+    if (bytes >= TTAK_POLY1305_VECTOR_MIN_BLOCKS * TTAK_POLY1305_BLOCK_BYTES) {
+        size_t wide = bytes & ~(size_t)(4U * TTAK_POLY1305_BLOCK_BYTES - 1U);
+        ttak_poly1305_blocks4(st, m, wide, hibit);
+        m += wide;
+        bytes -= wide;
+    }
+#endif
+    ttak_poly1305_blocks_scalar(st, m, bytes, hibit);
+}
+
 static void ttak_poly1305_init(ttak_poly1305_state_t *st,
                                const uint8_t key[32]) {
     uint64_t t0 = ttak_load32_le(key + 0);
@@ -204,73 +854,23 @@ static void ttak_poly1305_init(ttak_poly1305_state_t *st,
     st->r5[3] = st->r[3] * 5U;
     st->r5[4] = st->r[4] * 5U;
 
+#if defined(TTAK_HAS_AVX2)
+    uint64_t pw[5];
+    memcpy(pw, st->r, sizeof(pw));
+    for (int j = 3; j >= 0; --j) {
+        for (int i = 0; i < 5; ++i) st->rpow[i][j] = pw[i];
+        if (j) ttak_poly1305_mul26(pw, st->r);
+    }
+#endif
+
     memset(st->h, 0, sizeof(st->h));
     st->pad[0] = ttak_load64_le(key + 16);
     st->pad[1] = ttak_load64_le(key + 24);
     st->buffer_used = 0;
 }
 
-static void ttak_poly1305_update(ttak_poly1305_state_t *st,
-                                 const uint8_t *m,
-                                 size_t bytes) {
-    if (!bytes) {
-        return;
-    }
-
-    if (st->buffer_used) {
-        size_t need = TTAK_POLY1305_BLOCK_BYTES - st->buffer_used;
-        if (need > bytes) {
-            need = bytes;
-        }
-        memcpy(st->buffer + st->buffer_used, m, need);
-        st->buffer_used += need;
-        m += need;
-        bytes -= need;
-        if (st->buffer_used == TTAK_POLY1305_BLOCK_BYTES) {
-            ttak_poly1305_blocks(st, st->buffer, TTAK_POLY1305_BLOCK_BYTES, TTAK_POLY1305_HIBIT);
-            st->buffer_used = 0;
-        }
-    }
-
-    while (bytes >= TTAK_POLY1305_BLOCK_BYTES) {
-        ttak_poly1305_blocks(st, m, TTAK_POLY1305_BLOCK_BYTES, TTAK_POLY1305_HIBIT);
-        m += TTAK_POLY1305_BLOCK_BYTES;
-        bytes -= TTAK_POLY1305_BLOCK_BYTES;
-    }
-
-    if (bytes) {
-        memcpy(st->buffer, m, bytes);
-        st->buffer_used = bytes;
-    }
-}
-
-static void ttak_poly1305_pad16(ttak_poly1305_state_t *st) {
-    if (!st->buffer_used) {
-        return;
-    }
-    memset(st->buffer + st->buffer_used, 0,
-           TTAK_POLY1305_BLOCK_BYTES - st->buffer_used);
-    ttak_poly1305_blocks(st, st->buffer, TTAK_POLY1305_BLOCK_BYTES, TTAK_POLY1305_HIBIT);
-    st->buffer_used = 0;
-}
-
-static void ttak_poly1305_finish(ttak_poly1305_state_t *st,
-                                 uint64_t aad_len,
-                                 uint64_t text_len,
-                                 uint8_t mac[16]) {
-    if (st->buffer_used) {
-        st->buffer[st->buffer_used] = 1;
-        memset(st->buffer + st->buffer_used + 1, 0,
-               TTAK_POLY1305_BLOCK_BYTES - st->buffer_used - 1);
-        ttak_poly1305_blocks(st, st->buffer, TTAK_POLY1305_BLOCK_BYTES, 0);
-        st->buffer_used = 0;
-    }
-
-    uint8_t len_block[16];
-    ttak_store64_le(len_block, aad_len);
-    ttak_store64_le(len_block + 8, text_len);
-    ttak_poly1305_blocks(st, len_block, sizeof(len_block), TTAK_POLY1305_HIBIT);
-
+/** @brief Fully reduces h, adds the pad and writes the tag. */
+static void ttak_poly1305_emit(ttak_poly1305_state_t *st, uint8_t mac[16]) {
     uint64_t h0 = st->h[0];
     uint64_t h1 = st->h[1];
     uint64_t h2 = st->h[2];
@@ -336,6 +936,74 @@ static void ttak_poly1305_finish(ttak_poly1305_state_t *st,
     ttak_store64_le(mac + 8, high);
 }
 
+
+#endif /* TTAK_POLY1305_RADIX44 */
+
+static void ttak_poly1305_update(ttak_poly1305_state_t *st,
+                                 const uint8_t *m,
+                                 size_t bytes) {
+    if (!bytes) {
+        return;
+    }
+
+    if (st->buffer_used) {
+        size_t need = TTAK_POLY1305_BLOCK_BYTES - st->buffer_used;
+        if (need > bytes) {
+            need = bytes;
+        }
+        memcpy(st->buffer + st->buffer_used, m, need);
+        st->buffer_used += need;
+        m += need;
+        bytes -= need;
+        if (st->buffer_used == TTAK_POLY1305_BLOCK_BYTES) {
+            ttak_poly1305_blocks(st, st->buffer, TTAK_POLY1305_BLOCK_BYTES, TTAK_POLY1305_HIBIT);
+            st->buffer_used = 0;
+        }
+    }
+
+    size_t full = bytes & ~(size_t)(TTAK_POLY1305_BLOCK_BYTES - 1U);
+    if (full) {
+        ttak_poly1305_blocks(st, m, full, TTAK_POLY1305_HIBIT);
+        m += full;
+        bytes -= full;
+    }
+
+    if (bytes) {
+        memcpy(st->buffer, m, bytes);
+        st->buffer_used = bytes;
+    }
+}
+
+static void ttak_poly1305_pad16(ttak_poly1305_state_t *st) {
+    if (!st->buffer_used) {
+        return;
+    }
+    memset(st->buffer + st->buffer_used, 0,
+           TTAK_POLY1305_BLOCK_BYTES - st->buffer_used);
+    ttak_poly1305_blocks(st, st->buffer, TTAK_POLY1305_BLOCK_BYTES, TTAK_POLY1305_HIBIT);
+    st->buffer_used = 0;
+}
+
+static void ttak_poly1305_finish(ttak_poly1305_state_t *st,
+                                 uint64_t aad_len,
+                                 uint64_t text_len,
+                                 uint8_t mac[16]) {
+    if (st->buffer_used) {
+        st->buffer[st->buffer_used] = 1;
+        memset(st->buffer + st->buffer_used + 1, 0,
+               TTAK_POLY1305_BLOCK_BYTES - st->buffer_used - 1);
+        ttak_poly1305_blocks(st, st->buffer, TTAK_POLY1305_BLOCK_BYTES, 0);
+        st->buffer_used = 0;
+    }
+
+    uint8_t len_block[16];
+    ttak_store64_le(len_block, aad_len);
+    ttak_store64_le(len_block + 8, text_len);
+    ttak_poly1305_blocks(st, len_block, sizeof(len_block), TTAK_POLY1305_HIBIT);
+
+    ttak_poly1305_emit(st, mac);
+}
+
 static bool ttak_copy_from_ctx(const uint8_t *linear,
                                const uint8_t *const *blocks,
                                size_t block_size,
@@ -481,32 +1149,49 @@ ttak_io_status_t ttak_chacha20_poly1305_execute(ttak_crypto_ctx_t *ctx,
     }
     ttak_poly1305_pad16(&poly);
 
+    /* Counter 0 keyed Poly1305; the text may use counters 1 .. 2^32 - 1. */
+    if ((uint64_t)total_len > (uint64_t)UINT32_MAX * TTAK_CHACHA_BLOCK_BYTES) {
+        return TTAK_IO_ERR_RANGE;
+    }
+
+    const ttak_security_driver_t *driver = ttak_security_pick_driver(TTAK_SECURITY_CHACHA20_POLY1305);
+    size_t lanes = (driver && driver->lane_width) ? driver->lane_width : 1U;
+    bool linear = src_linear && dst_linear;
+
     size_t offset = 0;
     uint32_t counter = 1U;
-    uint8_t keystream[TTAK_CHACHA_BLOCK_BYTES];
-    uint8_t buffer[TTAK_CHACHA_BLOCK_BYTES];
+    uint8_t keystream[TTAK_CHACHA_CHUNK_BLOCKS * TTAK_CHACHA_BLOCK_BYTES];
+    uint8_t buffer[TTAK_CHACHA_CHUNK_BLOCKS * TTAK_CHACHA_BLOCK_BYTES];
 
     while (offset < total_len) {
         size_t chunk = total_len - offset;
-        if (chunk > TTAK_CHACHA_BLOCK_BYTES) {
-            chunk = TTAK_CHACHA_BLOCK_BYTES;
+        if (chunk > sizeof(keystream)) {
+            chunk = sizeof(keystream);
         }
-        if (counter == 0U) {
-            return TTAK_IO_ERR_RANGE;
-        }
-        ttak_chacha20_block(keystream, key_words, counter, nonce_words);
-        counter++;
-        if (!ttak_copy_from_ctx(src_linear, in_blocks, block_size, block_count,
-                                offset, buffer, chunk)) {
-            return TTAK_IO_ERR_RANGE;
-        }
-        for (size_t i = 0; i < chunk; ++i) {
-            buffer[i] ^= keystream[i];
-        }
-        ttak_poly1305_update(&poly, buffer, chunk);
-        if (!ttak_copy_to_ctx(dst_linear, out_blocks, block_size, block_count,
-                              offset, buffer, chunk)) {
-            return TTAK_IO_ERR_RANGE;
+        size_t blocks = (chunk + TTAK_CHACHA_BLOCK_BYTES - 1U) / TTAK_CHACHA_BLOCK_BYTES;
+        ttak_chacha20_keystream(keystream, key_words, counter, nonce_words, blocks, lanes);
+        counter += (uint32_t)blocks;
+
+        if (linear) {
+            const uint8_t *src = src_linear + offset;
+            uint8_t *dst = dst_linear + offset;
+            for (size_t i = 0; i < chunk; ++i) {
+                dst[i] = src[i] ^ keystream[i];
+            }
+            ttak_poly1305_update(&poly, dst, chunk);
+        } else {
+            if (!ttak_copy_from_ctx(src_linear, in_blocks, block_size, block_count,
+                                    offset, buffer, chunk)) {
+                return TTAK_IO_ERR_RANGE;
+            }
+            for (size_t i = 0; i < chunk; ++i) {
+                buffer[i] ^= keystream[i];
+            }
+            ttak_poly1305_update(&poly, buffer, chunk);
+            if (!ttak_copy_to_ctx(dst_linear, out_blocks, block_size, block_count,
+                                  offset, buffer, chunk)) {
+                return TTAK_IO_ERR_RANGE;
+            }
         }
         offset += chunk;
     }
@@ -525,3 +1210,219 @@ ttak_io_status_t ttak_chacha20_poly1305_execute(ttak_crypto_ctx_t *ctx,
     memcpy(ctx->tag, tag_block, tag_len);
     return TTAK_IO_SUCCESS;
 }
+
+/** @brief One keystream block owed to a record: counter 0 is its Poly1305 key. */
+typedef struct {
+    uint32_t record;
+    uint32_t counter;
+} ttak_chacha_batch_job_t;
+
+/** @brief Writes the tag of a record whose @c out already holds the ciphertext. */
+static void ttak_chacha_batch_tag(ttak_crypto_ctx_t *ctx, const uint8_t otk[32]) {
+    ttak_poly1305_state_t poly;
+    ttak_poly1305_init(&poly, otk);
+    if (ctx->aad_len) {
+        ttak_poly1305_update(&poly, ctx->aad, ctx->aad_len);
+    }
+    ttak_poly1305_pad16(&poly);
+    ttak_poly1305_update(&poly, ctx->out, ctx->in_len);
+    ttak_poly1305_pad16(&poly);
+    uint8_t tag_block[16];
+    ttak_poly1305_finish(&poly, ctx->aad_len, ctx->in_len, tag_block);
+    size_t tag_len = ctx->tag_len ? ctx->tag_len : 16U;
+    if (tag_len > 16U) {
+        tag_len = 16U;
+    }
+    memcpy(ctx->tag, tag_block, tag_len);
+}
+
+/** @brief True when @p ctx is a well-formed linear record. */
+static bool ttak_chacha_batch_linear(const ttak_crypto_ctx_t *ctx) {
+    return ctx && ctx->key && ctx->key_len == 32 && ctx->tag &&
+           (!ctx->aad_len || ctx->aad) && (ctx->iv_len == 0 || ctx->iv_len == 12U) &&
+           ctx->in && ctx->out;
+}
+
+/** @brief True when @p ctx is large enough to be worth sending to a GPU backend. */
+static bool ttak_chacha_batch_offload(const ttak_crypto_ctx_t *ctx) {
+    return ttak_chacha_batch_linear(ctx) && ctx->in_len >= TTAK_SECURITY_ACCEL_MIN_RECORD_BYTES &&
+           (uint64_t)ctx->in_len <= (uint64_t)UINT32_MAX * TTAK_CHACHA_BLOCK_BYTES;
+}
+
+/**
+ * @brief Encrypts the batch's large records on a GPU backend and tags them.
+ *
+ * @return true when the records ttak_chacha_batch_offload() accepts are
+ *         done; false, with nothing written, when they stay on the CPU.
+ */
+static bool ttak_chacha_batch_accel(ttak_crypto_ctx_t *ctxs, size_t count) {
+    if (!ttak_security_accel_available()) {
+        return false;
+    }
+    uint64_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (ttak_chacha_batch_offload(&ctxs[i])) bytes += ctxs[i].in_len;
+    }
+    if (bytes < TTAK_SECURITY_ACCEL_MIN_BATCH_BYTES ||
+        !ttak_security_accel_chacha20(ctxs, count, ttak_chacha_batch_offload)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        ttak_crypto_ctx_t *ctx = &ctxs[i];
+        if (!ttak_chacha_batch_offload(ctx)) continue;
+        uint32_t key_words[8], nonce_words[3];
+        for (size_t w = 0; w < 8; ++w) key_words[w] = ttak_load32_le(ctx->key + w * 4);
+        for (size_t w = 0; w < 3; ++w) nonce_words[w] = ttak_load32_le(ctx->iv + w * 4);
+        uint8_t otk[TTAK_CHACHA_BLOCK_BYTES];
+        ttak_chacha20_block(otk, key_words, 0U, nonce_words);
+        ttak_chacha_batch_tag(ctx, otk);
+    }
+    return true;
+}
+
+/** @brief True when @p ctx is a linear record short enough to share lanes with others. */
+static bool ttak_chacha_batch_eligible(const ttak_crypto_ctx_t *ctx) {
+    return ttak_chacha_batch_linear(ctx) && ctx->in_len <= TTAK_CHACHA_BATCH_MAX_BYTES;
+}
+
+/**
+ * @brief Runs one window of eligible records with their blocks spread over
+ *        vector lanes across record boundaries.
+ */
+static void ttak_chacha_batch_window(ttak_crypto_ctx_t *ctxs, const uint32_t *idx, size_t n, size_t lanes) {
+    uint32_t key_words[TTAK_SECURITY_BATCH_WINDOW][8];
+    uint32_t nonce_words[TTAK_SECURITY_BATCH_WINDOW][3];
+    uint8_t otk[TTAK_SECURITY_BATCH_WINDOW][32];
+    for (size_t r = 0; r < n; ++r) {
+        const ttak_crypto_ctx_t *ctx = &ctxs[idx[r]];
+        for (size_t i = 0; i < 8; ++i) key_words[r][i] = ttak_load32_le(ctx->key + i * 4);
+        for (size_t i = 0; i < 3; ++i) nonce_words[r][i] = ttak_load32_le(ctx->iv + i * 4);
+    }
+
+    uint32_t words[16][TTAK_CHACHA_MAX_LANES];
+    ttak_chacha_batch_job_t jobs[TTAK_CHACHA_MAX_LANES];
+    uint8_t keystream[TTAK_CHACHA_MAX_LANES * TTAK_CHACHA_BLOCK_BYTES];
+    size_t filled = 0;
+    size_t r = 0;
+    uint32_t counter = 0;
+
+    while (r < n || filled) {
+        /* Deal out blocks record by record until every lane has one. */
+        while (r < n && filled < lanes) {
+            const ttak_crypto_ctx_t *ctx = &ctxs[idx[r]];
+            uint32_t w[16];
+            ttak_chacha20_init_words(w, key_words[r], counter, nonce_words[r]);
+            for (int i = 0; i < 16; ++i) words[i][filled] = w[i];
+            jobs[filled].record = (uint32_t)r;
+            jobs[filled].counter = counter;
+            filled++;
+            size_t blocks = (ctx->in_len + TTAK_CHACHA_BLOCK_BYTES - 1U) / TTAK_CHACHA_BLOCK_BYTES;
+            if (counter++ == blocks) {
+                counter = 0;
+                r++;
+            }
+        }
+        if (r == n && filled < lanes) {
+            /* Last, partial group: pad with copies of lane 0 and ignore them. */
+            for (size_t j = filled; j < lanes; ++j) {
+                for (int i = 0; i < 16; ++i) words[i][j] = words[i][0];
+            }
+        }
+
+        switch (lanes) {
+#if defined(TTAK_HAS_AVX512F)
+            case 16U: ttak_chacha20_lanes16(keystream, (const uint32_t (*)[16])words); break;
+#endif
+#if defined(TTAK_HAS_AVX2)
+            case 8U: {
+                uint32_t w8[16][8];
+                for (int i = 0; i < 16; ++i) memcpy(w8[i], words[i], sizeof(w8[i]));
+                ttak_chacha20_lanes8(keystream, (const uint32_t (*)[8])w8);
+                break;
+            }
+#endif
+#if TTAK_CHACHA_MAX_LANES >= 4U
+            case 4U: {
+                uint32_t w4[16][4];
+                for (int i = 0; i < 16; ++i) memcpy(w4[i], words[i], sizeof(w4[i]));
+                ttak_chacha20_lanes4(keystream, (const uint32_t (*)[4])w4);
+                break;
+            }
+#endif
+            default:
+                break;
+        }
+
+        for (size_t j = 0; j < filled; ++j) {
+            ttak_crypto_ctx_t *ctx = &ctxs[idx[jobs[j].record]];
+            const uint8_t *ks = keystream + j * TTAK_CHACHA_BLOCK_BYTES;
+            if (jobs[j].counter == 0) {
+                memcpy(otk[jobs[j].record], ks, sizeof(otk[0]));
+                continue;
+            }
+            size_t off = (size_t)(jobs[j].counter - 1U) * TTAK_CHACHA_BLOCK_BYTES;
+            size_t len = ctx->in_len - off;
+            if (len > TTAK_CHACHA_BLOCK_BYTES) {
+                len = TTAK_CHACHA_BLOCK_BYTES;
+            }
+            for (size_t i = 0; i < len; ++i) {
+                ctx->out[off + i] = ctx->in[off + i] ^ ks[i];
+            }
+        }
+        filled = 0;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        ttak_chacha_batch_tag(&ctxs[idx[i]], otk[i]);
+    }
+}
+
+ttak_io_status_t ttak_chacha20_poly1305_execute_batch(ttak_crypto_ctx_t *ctxs,
+                                                      size_t count,
+                                                      const ttak_security_driver_t *driver,
+                                                      ttak_io_status_t *statuses) {
+    if (!ctxs && count) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    size_t lanes = (driver && driver->lane_width) ? driver->lane_width : 1U;
+    if (lanes > TTAK_CHACHA_MAX_LANES) {
+        lanes = TTAK_CHACHA_MAX_LANES;
+    }
+    lanes = lanes >= 16U ? 16U : lanes >= 8U ? 8U : lanes >= 4U ? 4U : 1U;
+    bool offloaded = ttak_chacha_batch_accel(ctxs, count);
+
+    ttak_io_status_t first = TTAK_IO_SUCCESS;
+    uint32_t idx[TTAK_SECURITY_BATCH_WINDOW];
+    size_t i = 0;
+    while (i < count) {
+        /* Collect a window of records that can share lanes; run the rest on their own. */
+        size_t n = 0;
+        for (; i < count && n < TTAK_SECURITY_BATCH_WINDOW; ++i) {
+            ttak_crypto_ctx_t *ctx = &ctxs[i];
+            if (offloaded && ttak_chacha_batch_offload(ctx)) {
+                if (statuses) {
+                    statuses[i] = TTAK_IO_SUCCESS;
+                }
+                continue;
+            }
+            if (lanes > 1U && ttak_chacha_batch_eligible(ctx)) {
+                idx[n++] = (uint32_t)i;
+                continue;
+            }
+            ttak_io_status_t rc = ttak_chacha20_poly1305_execute(ctx, ctx->in, ctx->out, ctx->in_len);
+            if (statuses) {
+                statuses[i] = rc;
+            }
+            if (rc != TTAK_IO_SUCCESS && first == TTAK_IO_SUCCESS) {
+                first = rc;
+            }
+        }
+        if (n) {
+            ttak_chacha_batch_window(ctxs, idx, n, lanes);
+            if (statuses) {
+                for (size_t j = 0; j < n; ++j) statuses[idx[j]] = TTAK_IO_SUCCESS;
+            }
+        }
+    }
+    return first;
+}
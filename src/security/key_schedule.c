@@ -0,0 +1,108 @@
+/**
+ * @file key_schedule.c
+ * @brief Session key schedules and the small per-session cache holding them.
+ *
+ * Each schedule keeps a copy of the key it was built from, so a kernel
+ * given ctx->schedule can confirm it belongs to ctx->key before skipping
+ * its own expansion. Keys are compared in constant time.
+ */
+
+#include <ttak/security/key_schedule.h>
+#include "../../internal/ttak/key_schedule.h"
+
+#include <string.h>
+
+static void ttak_schedule_wipe_bytes(void *p, size_t n) {
+    volatile uint8_t *v = p;
+    while (n--) *v++ = 0;
+}
+
+static bool ttak_schedule_key_equal(const uint8_t *a, const uint8_t *b, size_t len) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; ++i) diff |= (uint8_t)(a[i] ^ b[i]);
+    return diff == 0;
+}
+
+static bool ttak_schedule_key_len_ok(ttak_security_cipher_t cipher, size_t key_len) {
+    if (cipher == TTAK_SECURITY_CIPHER_AES256) return key_len == 32;
+    if (cipher == TTAK_SECURITY_CIPHER_LEA) return key_len == 16 || key_len == 24 || key_len == 32;
+    if (cipher == TTAK_SECURITY_CIPHER_SEED) return key_len == 16;
+    return false;
+}
+
+ttak_security_cipher_t ttak_security_op_cipher(ttak_security_op_t op) {
+    if (op == TTAK_SECURITY_AES_GCM) return TTAK_SECURITY_CIPHER_AES256;
+    if (op == TTAK_SECURITY_LEA_ENC || op == TTAK_SECURITY_LEA_CTR) return TTAK_SECURITY_CIPHER_LEA;
+    if (op == TTAK_SECURITY_SEED_ENC || op == TTAK_SECURITY_SEED_CTR) return TTAK_SECURITY_CIPHER_SEED;
+    return TTAK_SECURITY_CIPHER_NONE;
+}
+
+ttak_io_status_t ttak_security_schedule_init(ttak_security_schedule_t *sched,
+                                             ttak_security_op_t op,
+                                             const uint8_t *key,
+                                             size_t key_len) {
+    if (!sched) return TTAK_IO_ERR_INVALID_ARGUMENT;
+    ttak_security_schedule_wipe(sched);
+    ttak_security_cipher_t cipher = ttak_security_op_cipher(op);
+    if (!key || !ttak_schedule_key_len_ok(cipher, key_len)) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    memcpy(sched->key, key, key_len);
+    sched->key_len = key_len;
+    if (cipher == TTAK_SECURITY_CIPHER_AES256) {
+        ttak_aes256_gcm_schedule_fill(sched);
+    } else if (cipher == TTAK_SECURITY_CIPHER_LEA) {
+        ttak_lea_schedule_init(&sched->u.lea, key, key_len);
+    } else {
+        ttak_seed_expand_key(sched->u.seed, key);
+    }
+    sched->cipher = cipher;
+    return TTAK_IO_SUCCESS;
+}
+
+void ttak_security_schedule_wipe(ttak_security_schedule_t *sched) {
+    if (sched) ttak_schedule_wipe_bytes(sched, sizeof(*sched));
+}
+
+const ttak_security_schedule_t *ttak_security_schedule_match(const ttak_crypto_ctx_t *ctx,
+                                                             ttak_security_cipher_t cipher) {
+    const ttak_security_schedule_t *sched = ctx->schedule;
+    if (!sched || sched->cipher != cipher || !ctx->key || ctx->key_len != sched->key_len) {
+        return NULL;
+    }
+    return ttak_schedule_key_equal(sched->key, ctx->key, ctx->key_len) ? sched : NULL;
+}
+
+void ttak_security_schedule_cache_init(ttak_security_schedule_cache_t *cache) {
+    if (cache) memset(cache, 0, sizeof(*cache));
+}
+
+void ttak_security_schedule_cache_clear(ttak_security_schedule_cache_t *cache) {
+    if (cache) ttak_schedule_wipe_bytes(cache, sizeof(*cache));
+}
+
+const ttak_security_schedule_t *ttak_security_schedule_cache_get(ttak_security_schedule_cache_t *cache,
+                                                                 ttak_security_op_t op,
+                                                                 const uint8_t *key,
+                                                                 size_t key_len) {
+    ttak_security_cipher_t cipher = ttak_security_op_cipher(op);
+    if (!cache || !key || !ttak_schedule_key_len_ok(cipher, key_len)) return NULL;
+
+    uint64_t now = ++cache->clock;
+    ttak_security_schedule_t *victim = &cache->slots[0];
+    for (size_t i = 0; i < TTAK_SECURITY_SCHEDULE_CACHE_SLOTS; ++i) {
+        ttak_security_schedule_t *slot = &cache->slots[i];
+        if (slot->cipher == cipher && slot->key_len == key_len &&
+            ttak_schedule_key_equal(slot->key, key, key_len)) {
+            slot->last_use = now;
+            return slot;
+        }
+        if (victim->cipher != TTAK_SECURITY_CIPHER_NONE &&
+            (slot->cipher == TTAK_SECURITY_CIPHER_NONE || slot->last_use < victim->last_use)) {
+            victim = slot;
+        }
+    }
+    if (ttak_security_schedule_init(victim, op, key, key_len) != TTAK_IO_SUCCESS) return NULL;
+    victim->last_use = now;
+    return victim;
+}
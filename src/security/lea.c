@@ -2,56 +2,111 @@
  * @file lea.c
  * @brief LEA block cipher implementation (KS X 3246).
  *
- * Implements key schedule expansion for 128/192/256-bit keys and a
- * software encrypt path.  The encrypt loop is written to allow the
- * compiler to auto-vectorise when lane_width > 1 is requested by the
- * security engine driver.
+ * Implements the 128/192/256-bit key schedules, ECB encryption of whole
+ * blocks and counter mode. Blocks are encrypted 4, 8 or 16 at a time
+ * (SSE2/NEON, AVX2, AVX-512) with one block per 32-bit vector lane, capped
+ * by the lane width of the driver ttak_security_pick_driver() returns;
+ * LEA is only additions, rotations and XORs, so every lane does exactly
+ * what the scalar round does.
  */
 
 #include <ttak/security/lea.h>
+#include <ttak/arch/ttak_arch.h>
 
 #include <string.h>
 
+#include "../../internal/ttak/key_schedule.h"
+
+/**
+ * @def TTAK_LEA_MAX_LANES
+ * @brief Widest block kernel compiled in.
+ */
+#if defined(TTAK_HAS_AVX512F)
+#  include <immintrin.h>
+#  define TTAK_LEA_MAX_LANES 16U
+#elif defined(TTAK_HAS_AVX2)
+#  include <immintrin.h>
+#  define TTAK_LEA_MAX_LANES 8U
+#elif defined(TTAK_HAS_SSE2)
+#  include <emmintrin.h>
+#  define TTAK_LEA_MAX_LANES 4U
+#elif defined(TTAK_HAS_NEON) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  include <arm_neon.h>
+#  define TTAK_LEA_MAX_LANES 4U
+#else
+#  define TTAK_LEA_MAX_LANES 1U
+#endif
+
 static inline uint32_t ttak_rotl32(uint32_t value, unsigned int bits) {
-    return (value << bits) | (value >> (32U - bits));
+    bits &= 31U;
+    return bits ? (value << bits) | (value >> (32U - bits)) : value;
 }
 
 static inline uint32_t ttak_rotr32(uint32_t value, unsigned int bits) {
-    return (value >> bits) | (value << (32U - bits));
+    return ttak_rotl32(value, 32U - bits);
+}
+
+static inline uint32_t ttak_lea_load32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void ttak_lea_store32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
 }
 
 static const uint32_t ttak_lea_delta[8] = {
-    0x9e3779b9U, 0x3c6ef373U, 0xdaa66d2cU, 0x78dde6e5U,
-    0x1715609fU, 0xb54cda58U, 0x53845412U, 0xf1bbcdcB
+    0xc3efe9dbU, 0x44626b02U, 0x79e27c8aU, 0x78df30ecU,
+    0x715ea49eU, 0xc785da0aU, 0xe04ef22aU, 0xe5c40957U
 };
 
-static void ttak_lea_schedule_256(ttak_lea_schedule_t *sched,
-                                  const uint8_t *key_bytes) {
-    uint32_t key_words[8];
-    for (size_t i = 0; i < 8; ++i) {
-        key_words[i] = (uint32_t)key_bytes[i * 4 + 0] |
-                       ((uint32_t)key_bytes[i * 4 + 1] << 8) |
-                       ((uint32_t)key_bytes[i * 4 + 2] << 16) |
-                       ((uint32_t)key_bytes[i * 4 + 3] << 24);
-    }
-
-    for (size_t round = 0; round < 32; ++round) {
-        uint32_t delta = ttak_rotl32(ttak_lea_delta[round & 7], round);
-        key_words[round & 7] = ttak_rotl32(key_words[round & 7] + delta, 1);
-        key_words[(round + 1) & 7] =
-            ttak_rotl32(key_words[(round + 1) & 7] + ttak_rotl32(delta, 1), 3);
-        key_words[(round + 2) & 7] =
-            ttak_rotl32(key_words[(round + 2) & 7] + ttak_rotl32(delta, 2), 6);
-        key_words[(round + 3) & 7] =
-            ttak_rotl32(key_words[(round + 3) & 7] + ttak_rotl32(delta, 3), 11);
-
-        uint32_t *rk = &sched->round_keys[round * 6];
-        rk[0] = key_words[(round) & 7];
-        rk[1] = key_words[(round + 1) & 7];
-        rk[2] = key_words[(round + 2) & 7];
-        rk[3] = key_words[(round + 3) & 7];
-        rk[4] = key_words[(round + 4) & 7];
-        rk[5] = key_words[(round + 5) & 7];
+static void ttak_lea_schedule_128(ttak_lea_schedule_t *sched, const uint32_t *k) {
+    uint32_t t[4] = { k[0], k[1], k[2], k[3] };
+    for (uint32_t i = 0; i < 24; ++i) {
+        uint32_t delta = ttak_lea_delta[i & 3];
+        t[0] = ttak_rotl32(t[0] + ttak_rotl32(delta, i), 1);
+        t[1] = ttak_rotl32(t[1] + ttak_rotl32(delta, i + 1), 3);
+        t[2] = ttak_rotl32(t[2] + ttak_rotl32(delta, i + 2), 6);
+        t[3] = ttak_rotl32(t[3] + ttak_rotl32(delta, i + 3), 11);
+        uint32_t *rk = &sched->round_keys[i * 6];
+        rk[0] = t[0];
+        rk[1] = t[1];
+        rk[2] = t[2];
+        rk[3] = t[1];
+        rk[4] = t[3];
+        rk[5] = t[1];
+    }
+    sched->rounds = 24;
+}
+
+static void ttak_lea_schedule_192(ttak_lea_schedule_t *sched, const uint32_t *k) {
+    static const unsigned shifts[6] = { 1, 3, 6, 11, 13, 17 };
+    uint32_t t[6] = { k[0], k[1], k[2], k[3], k[4], k[5] };
+    for (uint32_t i = 0; i < 28; ++i) {
+        uint32_t delta = ttak_lea_delta[i % 6];
+        uint32_t *rk = &sched->round_keys[i * 6];
+        for (uint32_t j = 0; j < 6; ++j) {
+            t[j] = ttak_rotl32(t[j] + ttak_rotl32(delta, i + j), shifts[j]);
+            rk[j] = t[j];
+        }
+    }
+    sched->rounds = 28;
+}
+
+static void ttak_lea_schedule_256(ttak_lea_schedule_t *sched, const uint32_t *k) {
+    static const unsigned shifts[6] = { 1, 3, 6, 11, 13, 17 };
+    uint32_t t[8];
+    memcpy(t, k, sizeof(t));
+    for (uint32_t i = 0; i < 32; ++i) {
+        uint32_t delta = ttak_lea_delta[i & 7];
+        uint32_t *rk = &sched->round_keys[i * 6];
+        for (uint32_t j = 0; j < 6; ++j) {
+            uint32_t w = (6 * i + j) & 7;
+            t[w] = ttak_rotl32(t[w] + ttak_rotl32(delta, i + j), shifts[j]);
+            rk[j] = t[w];
+        }
     }
     sched->rounds = 32;
 }
@@ -61,29 +116,26 @@ void ttak_lea_schedule_init(ttak_lea_schedule_t *sched,
                             size_t key_len) {
     if (!sched) return;
     memset(sched, 0, sizeof(*sched));
-    if (!key) return;
+    if (!key || (key_len != 16 && key_len != 24 && key_len != 32)) return;
 
-    if (key_len >= 32) {
-        ttak_lea_schedule_256(sched, key);
+    uint32_t k[8];
+    for (size_t i = 0; i < key_len / 4; ++i) k[i] = ttak_lea_load32(key + 4 * i);
+    if (key_len == 16) {
+        ttak_lea_schedule_128(sched, k);
+    } else if (key_len == 24) {
+        ttak_lea_schedule_192(sched, k);
     } else {
-        uint8_t expanded[32] = {0};
-        size_t copy = key_len < sizeof(expanded) ? key_len : sizeof(expanded);
-        memcpy(expanded, key, copy);
-        ttak_lea_schedule_256(sched, expanded);
+        ttak_lea_schedule_256(sched, k);
     }
 }
 
 static void ttak_lea_encrypt_block(uint8_t *out,
                                    const uint8_t *in,
                                    const ttak_lea_schedule_t *sched) {
-    uint32_t x0 = (uint32_t)in[0] | ((uint32_t)in[1] << 8) |
-                  ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
-    uint32_t x1 = (uint32_t)in[4] | ((uint32_t)in[5] << 8) |
-                  ((uint32_t)in[6] << 16) | ((uint32_t)in[7] << 24);
-    uint32_t x2 = (uint32_t)in[8] | ((uint32_t)in[9] << 8) |
-                  ((uint32_t)in[10] << 16) | ((uint32_t)in[11] << 24);
-    uint32_t x3 = (uint32_t)in[12] | ((uint32_t)in[13] << 8) |
-                  ((uint32_t)in[14] << 16) | ((uint32_t)in[15] << 24);
+    uint32_t x0 = ttak_lea_load32(in);
+    uint32_t x1 = ttak_lea_load32(in + 4);
+    uint32_t x2 = ttak_lea_load32(in + 8);
+    uint32_t x3 = ttak_lea_load32(in + 12);
 
     for (size_t r = 0; r < sched->rounds; ++r) {
         const uint32_t *rk = &sched->round_keys[r * 6];
@@ -97,22 +149,193 @@ static void ttak_lea_encrypt_block(uint8_t *out,
         x3 = t3;
     }
 
-    out[0] = (uint8_t)(x0 & 0xFF);
-    out[1] = (uint8_t)((x0 >> 8) & 0xFF);
-    out[2] = (uint8_t)((x0 >> 16) & 0xFF);
-    out[3] = (uint8_t)((x0 >> 24) & 0xFF);
-    out[4] = (uint8_t)(x1 & 0xFF);
-    out[5] = (uint8_t)((x1 >> 8) & 0xFF);
-    out[6] = (uint8_t)((x1 >> 16) & 0xFF);
-    out[7] = (uint8_t)((x1 >> 24) & 0xFF);
-    out[8] = (uint8_t)(x2 & 0xFF);
-    out[9] = (uint8_t)((x2 >> 8) & 0xFF);
-    out[10] = (uint8_t)((x2 >> 16) & 0xFF);
-    out[11] = (uint8_t)((x2 >> 24) & 0xFF);
-    out[12] = (uint8_t)(x3 & 0xFF);
-    out[13] = (uint8_t)((x3 >> 8) & 0xFF);
-    out[14] = (uint8_t)((x3 >> 16) & 0xFF);
-    out[15] = (uint8_t)((x3 >> 24) & 0xFF);
+    ttak_lea_store32(out, x0);
+    ttak_lea_store32(out + 4, x1);
+    ttak_lea_store32(out + 8, x2);
+    ttak_lea_store32(out + 12, x3);
+}
+
+/*
+ * One round with the state named (a, b, c, d) = (X0, X1, X2, X3). The new
+ * X1..X3 overwrite b..d and the old X0 becomes X3, so the next round runs
+ * on (b, c, d, a) and names repeat every four rounds.
+ */
+#define TTAK_LEA_VROUND(a, b, c, d, rk, XOR, ADD, ROL, SET1)                            \
+    do {                                                                               \
+        d = ROL(ADD(XOR(c, SET1((rk)[4])), XOR(d, SET1((rk)[5]))), 29);                \
+        c = ROL(ADD(XOR(b, SET1((rk)[2])), XOR(c, SET1((rk)[3]))), 27);                \
+        b = ROL(ADD(XOR(a, SET1((rk)[0])), XOR(b, SET1((rk)[1]))), 9);                 \
+    } while (0)
+
+#define TTAK_LEA_VROUNDS(x, sched, XOR, ADD, ROL, SET1)                                 \
+    for (size_t r = 0; r < (sched)->rounds; r += 4) {                                  \
+        const uint32_t *rk = &(sched)->round_keys[r * 6];                              \
+        TTAK_LEA_VROUND(x[0], x[1], x[2], x[3], rk, XOR, ADD, ROL, SET1);              \
+        TTAK_LEA_VROUND(x[1], x[2], x[3], x[0], rk + 6, XOR, ADD, ROL, SET1);          \
+        TTAK_LEA_VROUND(x[2], x[3], x[0], x[1], rk + 12, XOR, ADD, ROL, SET1);         \
+        TTAK_LEA_VROUND(x[3], x[0], x[1], x[2], rk + 18, XOR, ADD, ROL, SET1);         \
+    }
+
+#if defined(TTAK_HAS_AVX512F)
+#define TTAK_LEA_V16_XOR(a, b) _mm512_xor_si512((a), (b))
+#define TTAK_LEA_V16_ADD(a, b) _mm512_add_epi32((a), (b))
+#define TTAK_LEA_V16_ROL(a, n) _mm512_rol_epi32((a), (n))
+#define TTAK_LEA_V16_SET1(w) _mm512_set1_epi32((int)(w))
+
+/* Swaps 128-bit lane k of r[j] with lane j of r[k]; its own inverse. */
+static inline void ttak_lea_transpose_lanes16(__m512i r[4]) {
+    __m512i p0 = _mm512_shuffle_i32x4(r[0], r[1], _MM_SHUFFLE(1, 0, 1, 0));
+    __m512i p1 = _mm512_shuffle_i32x4(r[2], r[3], _MM_SHUFFLE(1, 0, 1, 0));
+    __m512i q0 = _mm512_shuffle_i32x4(r[0], r[1], _MM_SHUFFLE(3, 2, 3, 2));
+    __m512i q1 = _mm512_shuffle_i32x4(r[2], r[3], _MM_SHUFFLE(3, 2, 3, 2));
+    r[0] = _mm512_shuffle_i32x4(p0, p1, _MM_SHUFFLE(2, 0, 2, 0));
+    r[1] = _mm512_shuffle_i32x4(p0, p1, _MM_SHUFFLE(3, 1, 3, 1));
+    r[2] = _mm512_shuffle_i32x4(q0, q1, _MM_SHUFFLE(2, 0, 2, 0));
+    r[3] = _mm512_shuffle_i32x4(q0, q1, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+/* 4x4 transpose of 32-bit words inside every 128-bit lane; its own inverse. */
+static inline void ttak_lea_transpose_words16(__m512i r[4]) {
+    __m512i t0 = _mm512_unpacklo_epi32(r[0], r[1]), t1 = _mm512_unpacklo_epi32(r[2], r[3]);
+    __m512i t2 = _mm512_unpackhi_epi32(r[0], r[1]), t3 = _mm512_unpackhi_epi32(r[2], r[3]);
+    r[0] = _mm512_unpacklo_epi64(t0, t1);
+    r[1] = _mm512_unpackhi_epi64(t0, t1);
+    r[2] = _mm512_unpacklo_epi64(t2, t3);
+    r[3] = _mm512_unpackhi_epi64(t2, t3);
+}
+
+/** @brief Encrypts sixteen consecutive blocks; @p out may be @p in. */
+static void ttak_lea_blocks16(uint8_t *out, const uint8_t *in, const ttak_lea_schedule_t *sched) {
+    __m512i x[4];
+    for (int i = 0; i < 4; ++i) x[i] = _mm512_loadu_si512((const void *)(in + 64 * i));
+    ttak_lea_transpose_lanes16(x);
+    ttak_lea_transpose_words16(x);
+    TTAK_LEA_VROUNDS(x, sched, TTAK_LEA_V16_XOR, TTAK_LEA_V16_ADD, TTAK_LEA_V16_ROL, TTAK_LEA_V16_SET1)
+    ttak_lea_transpose_words16(x);
+    ttak_lea_transpose_lanes16(x);
+    for (int i = 0; i < 4; ++i) _mm512_storeu_si512((void *)(out + 64 * i), x[i]);
+}
+#endif
+
+#if defined(TTAK_HAS_AVX2)
+#define TTAK_LEA_V8_XOR(a, b) _mm256_xor_si256((a), (b))
+#define TTAK_LEA_V8_ADD(a, b) _mm256_add_epi32((a), (b))
+#define TTAK_LEA_V8_ROL(a, n) _mm256_or_si256(_mm256_slli_epi32((a), (n)), _mm256_srli_epi32((a), 32 - (n)))
+#define TTAK_LEA_V8_SET1(w) _mm256_set1_epi32((int)(w))
+
+static inline void ttak_lea_transpose_words8(__m256i r[4]) {
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]), t1 = _mm256_unpacklo_epi32(r[2], r[3]);
+    __m256i t2 = _mm256_unpackhi_epi32(r[0], r[1]), t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    r[0] = _mm256_unpacklo_epi64(t0, t1);
+    r[1] = _mm256_unpackhi_epi64(t0, t1);
+    r[2] = _mm256_unpacklo_epi64(t2, t3);
+    r[3] = _mm256_unpackhi_epi64(t2, t3);
+}
+
+/** @brief Encrypts eight consecutive blocks; @p out may be @p in. */
+static void ttak_lea_blocks8(uint8_t *out, const uint8_t *in, const ttak_lea_schedule_t *sched) {
+    __m256i v[4], x[4];
+    for (int i = 0; i < 4; ++i) v[i] = _mm256_loadu_si256((const __m256i *)(const void *)(in + 32 * i));
+    /* x[j] holds blocks j and j + 4, one per 128-bit lane. */
+    x[0] = _mm256_permute2x128_si256(v[0], v[2], 0x20);
+    x[1] = _mm256_permute2x128_si256(v[0], v[2], 0x31);
+    x[2] = _mm256_permute2x128_si256(v[1], v[3], 0x20);
+    x[3] = _mm256_permute2x128_si256(v[1], v[3], 0x31);
+    ttak_lea_transpose_words8(x);
+    TTAK_LEA_VROUNDS(x, sched, TTAK_LEA_V8_XOR, TTAK_LEA_V8_ADD, TTAK_LEA_V8_ROL, TTAK_LEA_V8_SET1)
+    ttak_lea_transpose_words8(x);
+    v[0] = _mm256_permute2x128_si256(x[0], x[1], 0x20);
+    v[1] = _mm256_permute2x128_si256(x[2], x[3], 0x20);
+    v[2] = _mm256_permute2x128_si256(x[0], x[1], 0x31);
+    v[3] = _mm256_permute2x128_si256(x[2], x[3], 0x31);
+    for (int i = 0; i < 4; ++i) _mm256_storeu_si256((__m256i *)(void *)(out + 32 * i), v[i]);
+}
+#endif
+
+#if defined(TTAK_HAS_SSE2)
+#define TTAK_LEA_V4_XOR(a, b) _mm_xor_si128((a), (b))
+#define TTAK_LEA_V4_ADD(a, b) _mm_add_epi32((a), (b))
+#define TTAK_LEA_V4_ROL(a, n) _mm_or_si128(_mm_slli_epi32((a), (n)), _mm_srli_epi32((a), 32 - (n)))
+#define TTAK_LEA_V4_SET1(w) _mm_set1_epi32((int)(w))
+
+static inline void ttak_lea_transpose_words4(__m128i r[4]) {
+    __m128i t0 = _mm_unpacklo_epi32(r[0], r[1]), t1 = _mm_unpacklo_epi32(r[2], r[3]);
+    __m128i t2 = _mm_unpackhi_epi32(r[0], r[1]), t3 = _mm_unpackhi_epi32(r[2], r[3]);
+    r[0] = _mm_unpacklo_epi64(t0, t1);
+    r[1] = _mm_unpackhi_epi64(t0, t1);
+    r[2] = _mm_unpacklo_epi64(t2, t3);
+    r[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+/** @brief Encrypts four consecutive blocks; @p out may be @p in. */
+static void ttak_lea_blocks4(uint8_t *out, const uint8_t *in, const ttak_lea_schedule_t *sched) {
+    __m128i x[4];
+    for (int i = 0; i < 4; ++i) x[i] = _mm_loadu_si128((const __m128i *)(const void *)(in + 16 * i));
+    ttak_lea_transpose_words4(x);
+    TTAK_LEA_VROUNDS(x, sched, TTAK_LEA_V4_XOR, TTAK_LEA_V4_ADD, TTAK_LEA_V4_ROL, TTAK_LEA_V4_SET1)
+    ttak_lea_transpose_words4(x);
+    for (int i = 0; i < 4; ++i) _mm_storeu_si128((__m128i *)(void *)(out + 16 * i), x[i]);
+}
+#elif TTAK_LEA_MAX_LANES == 4U
+#define TTAK_LEA_V4_XOR(a, b) veorq_u32((a), (b))
+#define TTAK_LEA_V4_ADD(a, b) vaddq_u32((a), (b))
+#define TTAK_LEA_V4_ROL(a, n) vsriq_n_u32(vshlq_n_u32((a), (n)), (a), 32 - (n))
+#define TTAK_LEA_V4_SET1(w) vdupq_n_u32((w))
+
+/** @brief Encrypts four consecutive blocks; @p out may be @p in. */
+static void ttak_lea_blocks4(uint8_t *out, const uint8_t *in, const ttak_lea_schedule_t *sched) {
+    /* De-interleaving load: val[j] is word j of each of the four blocks. */
+    uint32x4x4_t v = vld4q_u32((const uint32_t *)(const void *)in);
+    uint32x4_t x[4] = { v.val[0], v.val[1], v.val[2], v.val[3] };
+    TTAK_LEA_VROUNDS(x, sched, TTAK_LEA_V4_XOR, TTAK_LEA_V4_ADD, TTAK_LEA_V4_ROL, TTAK_LEA_V4_SET1)
+    v.val[0] = x[0];
+    v.val[1] = x[1];
+    v.val[2] = x[2];
+    v.val[3] = x[3];
+    vst4q_u32((uint32_t *)(void *)out, v);
+}
+#endif
+
+/**
+ * @brief Encrypts @p blocks consecutive blocks from @p in to @p out.
+ *
+ * Uses the widest kernel that fits both the remaining blocks and
+ * @p lanes, the driver's preferred parallel block count. @p out may be
+ * @p in but must not otherwise overlap it.
+ */
+static void ttak_lea_encrypt_blocks(uint8_t *out, const uint8_t *in, size_t blocks,
+                                    const ttak_lea_schedule_t *sched, size_t lanes) {
+#if defined(TTAK_HAS_AVX512F)
+    for (; lanes >= 16U && blocks >= 16U; blocks -= 16U, in += 256, out += 256) {
+        ttak_lea_blocks16(out, in, sched);
+    }
+#endif
+#if defined(TTAK_HAS_AVX2)
+    for (; lanes >= 8U && blocks >= 8U; blocks -= 8U, in += 128, out += 128) {
+        ttak_lea_blocks8(out, in, sched);
+    }
+#endif
+#if TTAK_LEA_MAX_LANES >= 4U
+    for (; lanes >= 4U && blocks >= 4U; blocks -= 4U, in += 64, out += 64) {
+        ttak_lea_blocks4(out, in, sched);
+    }
+#endif
+    (void)lanes;
+    for (; blocks > 0; blocks--, in += TTAK_LEA_BLOCK_SIZE, out += TTAK_LEA_BLOCK_SIZE) {
+        ttak_lea_encrypt_block(out, in, sched);
+    }
+}
+
+static size_t ttak_lea_lanes(const ttak_security_driver_t *driver) {
+    return (driver && driver->lane_width > 0) ? driver->lane_width : 1;
+}
+
+/* The session schedule when it matches @p ctx, else @p local expanded from ctx->key. */
+static const ttak_lea_schedule_t *ttak_lea_ctx_schedule(const ttak_crypto_ctx_t *ctx, ttak_lea_schedule_t *local) {
+    const ttak_security_schedule_t *sched = ttak_security_schedule_match(ctx, TTAK_SECURITY_CIPHER_LEA);
+    if (sched) return &sched->u.lea;
+    ttak_lea_schedule_init(local, ctx->key, ctx->key_len);
+    return local;
 }
 
 ttak_io_status_t ttak_lea_encrypt_simd(const ttak_crypto_ctx_t *ctx,
@@ -120,6 +343,9 @@ ttak_io_status_t ttak_lea_encrypt_simd(const ttak_crypto_ctx_t *ctx,
     if (!ctx || !ctx->in || !ctx->out || !ctx->key) {
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
+    if (ctx->key_len != 16 && ctx->key_len != 24 && ctx->key_len != 32) {
+        return TTAK_IO_ERR_RANGE;
+    }
     if (ctx->in_len == 0 || (ctx->in_len % TTAK_LEA_BLOCK_SIZE) != 0) {
         return TTAK_IO_ERR_RANGE;
     }
@@ -127,25 +353,55 @@ ttak_io_status_t ttak_lea_encrypt_simd(const ttak_crypto_ctx_t *ctx,
         return TTAK_IO_ERR_RANGE;
     }
 
-    ttak_lea_schedule_t sched;
-    ttak_lea_schedule_init(&sched, ctx->key, ctx->key_len);
+    ttak_lea_schedule_t local;
+    const ttak_lea_schedule_t *sched = ttak_lea_ctx_schedule(ctx, &local);
+    ttak_lea_encrypt_blocks(ctx->out, ctx->in, ctx->in_len / TTAK_LEA_BLOCK_SIZE, sched, ttak_lea_lanes(driver));
+    if (sched == &local) memset(&local, 0, sizeof(local));
+    return TTAK_IO_SUCCESS;
+}
 
-    size_t blocks = ctx->in_len / TTAK_LEA_BLOCK_SIZE;
-    size_t lanes = 1;
-    if (driver && driver->lane_width > 0) {
-        lanes = driver->lane_width;
+/** @brief Writes @p count big-endian counter blocks from @p ctr and advances it. */
+static void ttak_lea_counter_blocks(uint8_t *out, uint8_t ctr[TTAK_LEA_BLOCK_SIZE], size_t count) {
+    for (size_t b = 0; b < count; ++b, out += TTAK_LEA_BLOCK_SIZE) {
+        memcpy(out, ctr, TTAK_LEA_BLOCK_SIZE);
+        for (int i = (int)TTAK_LEA_BLOCK_SIZE - 1; i >= 0 && ++ctr[i] == 0; --i) {
+        }
     }
+}
 
-    size_t offset = 0;
-    while (blocks > 0) {
-        size_t batch = (blocks < lanes) ? blocks : lanes;
-        for (size_t b = 0; b < batch; ++b) {
-            const uint8_t *src = ctx->in + (offset + b) * TTAK_LEA_BLOCK_SIZE;
-            uint8_t *dst = ctx->out + (offset + b) * TTAK_LEA_BLOCK_SIZE;
-            ttak_lea_encrypt_block(dst, src, &sched);
-        }
-        offset += batch;
-        blocks -= batch;
+ttak_io_status_t ttak_lea_ctr_execute(ttak_crypto_ctx_t *ctx,
+                                      const ttak_security_driver_t *driver) {
+    if (!ctx || !ctx->key || (ctx->in_len && (!ctx->in || !ctx->out))) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    if (ctx->iv_len && ctx->iv_len != TTAK_LEA_BLOCK_SIZE) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    if (ctx->key_len != 16 && ctx->key_len != 24 && ctx->key_len != 32) {
+        return TTAK_IO_ERR_RANGE;
+    }
+    if (ctx->out_len < ctx->in_len) {
+        return TTAK_IO_ERR_RANGE;
+    }
+
+    ttak_lea_schedule_t local;
+    const ttak_lea_schedule_t *sched = ttak_lea_ctx_schedule(ctx, &local);
+    size_t lanes = ttak_lea_lanes(driver);
+
+    uint8_t ks[TTAK_LEA_CTR_CHUNK_BLOCKS * TTAK_LEA_BLOCK_SIZE];
+    const uint8_t *in = ctx->in;
+    uint8_t *out = ctx->out;
+    for (size_t left = ctx->in_len; left > 0;) {
+        size_t bytes = left < sizeof(ks) ? left : sizeof(ks);
+        size_t blocks = (bytes + TTAK_LEA_BLOCK_SIZE - 1) / TTAK_LEA_BLOCK_SIZE;
+        ttak_lea_counter_blocks(ks, ctx->iv, blocks);
+        ttak_lea_encrypt_blocks(ks, ks, blocks, sched, lanes);
+        for (size_t i = 0; i < bytes; ++i) out[i] = in[i] ^ ks[i];
+        in += bytes;
+        out += bytes;
+        left -= bytes;
     }
+    memset(ks, 0, sizeof(ks));
+    if (sched == &local) memset(&local, 0, sizeof(local));
     return TTAK_IO_SUCCESS;
 }
@@ -0,0 +1,150 @@
+/**
+ * @file security_accel.c
+ * @brief Backend selection and packing for GPU ChaCha20 offload.
+ *
+ * Backends are tried CUDA, then ROCm, then OpenCL, as in ntt_accel.c; one
+ * whose kernel fails is skipped by later batches. Records are copied into
+ * one staging buffer so a batch costs one upload, one launch and one
+ * download however many records it holds.
+ */
+
+#include "../../internal/ttak/security_accel.h"
+#include <ttak/mem/mem.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ATOMIC_VAR_INIT
+#  define ATOMIC_VAR_INIT(x) (x)
+#endif
+
+#define TTAK_SECURITY_ACCEL_BLOCK_BYTES 64U
+
+typedef struct ttak_security_accel_ops {
+    bool (*chacha20)(const uint32_t *records, size_t record_count, uint8_t *data, size_t blocks);
+    atomic_bool *enabled;
+} ttak_security_accel_ops_t;
+
+#define TTAK_SECURITY_ACCEL_DECLARE(P)                                                                        \
+    bool ttak_security_accel_##P##_chacha20(const uint32_t *records, size_t record_count, uint8_t *data,     \
+                                            size_t blocks);                                                  \
+    static atomic_bool g_security_accel_##P##_enabled = ATOMIC_VAR_INIT(true);                               \
+    static const ttak_security_accel_ops_t g_security_accel_##P = { ttak_security_accel_##P##_chacha20,      \
+                                                                    &g_security_accel_##P##_enabled };
+
+#if defined(ENABLE_CUDA)
+TTAK_SECURITY_ACCEL_DECLARE(cuda)
+#endif
+#if defined(ENABLE_ROCM)
+TTAK_SECURITY_ACCEL_DECLARE(rocm)
+#endif
+#if defined(ENABLE_OPENCL)
+TTAK_SECURITY_ACCEL_DECLARE(opencl)
+#endif
+
+static const ttak_security_accel_ops_t *const g_security_accel_backends[] = {
+#if defined(ENABLE_CUDA)
+    &g_security_accel_cuda,
+#endif
+#if defined(ENABLE_ROCM)
+    &g_security_accel_rocm,
+#endif
+#if defined(ENABLE_OPENCL)
+    &g_security_accel_opencl,
+#endif
+    NULL
+};
+
+static bool ttak_security_accel_enabled(const ttak_security_accel_ops_t *ops) {
+    return atomic_load_explicit(ops->enabled, memory_order_relaxed);
+}
+
+/* TTAK_SECURITY_KERNEL=scalar, which pins the CPU drivers to one lane, also keeps batches off the GPU. */
+static bool ttak_security_accel_allowed(void) {
+    const char *env = getenv("TTAK_SECURITY_KERNEL");
+    return !(env && strcmp(env, "scalar") == 0);
+}
+
+bool ttak_security_accel_available(void) {
+    if (!ttak_security_accel_allowed()) return false;
+    for (size_t i = 0; g_security_accel_backends[i]; ++i) {
+        if (ttak_security_accel_enabled(g_security_accel_backends[i])) return true;
+    }
+    return false;
+}
+
+static void ttak_security_accel_wipe(void *p, size_t n) {
+    volatile uint8_t *v = p;
+    while (n--) *v++ = 0;
+}
+
+static inline uint32_t ttak_security_accel_load32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static size_t ttak_security_accel_blocks(const ttak_crypto_ctx_t *ctx) {
+    return (ctx->in_len + TTAK_SECURITY_ACCEL_BLOCK_BYTES - 1U) / TTAK_SECURITY_ACCEL_BLOCK_BYTES;
+}
+
+bool ttak_security_accel_chacha20(ttak_crypto_ctx_t *ctxs, size_t count,
+                                  bool (*pick)(const ttak_crypto_ctx_t *ctx)) {
+    if (!ttak_security_accel_available()) return false;
+
+    size_t records = 0, blocks = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!pick(&ctxs[i])) continue;
+        records++;
+        blocks += ttak_security_accel_blocks(&ctxs[i]);
+    }
+    /* Block indices and counters are 32-bit on the device. */
+    if (records == 0 || blocks == 0 || blocks > UINT32_MAX) return false;
+
+    size_t record_bytes = records * TTAK_SECURITY_ACCEL_RECORD_WORDS * sizeof(uint32_t);
+    uint32_t *packed = ttak_mem_alloc_raw(record_bytes, __TTAK_UNSAFE_MEM_FOREVER__, 0);
+    uint8_t *data = ttak_mem_alloc_raw(blocks * TTAK_SECURITY_ACCEL_BLOCK_BYTES, __TTAK_UNSAFE_MEM_FOREVER__, 0);
+    bool ok = false;
+    if (packed && data) {
+        memset(packed, 0, record_bytes);
+        uint32_t *rec = packed;
+        size_t first = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const ttak_crypto_ctx_t *ctx = &ctxs[i];
+            if (!pick(ctx)) continue;
+            for (size_t w = 0; w < 8; ++w) rec[w] = ttak_security_accel_load32(ctx->key + 4 * w);
+            for (size_t w = 0; w < 3; ++w) rec[8 + w] = ttak_security_accel_load32(ctx->iv + 4 * w);
+            rec[11] = (uint32_t)first;
+            memcpy(data + first * TTAK_SECURITY_ACCEL_BLOCK_BYTES, ctx->in, ctx->in_len);
+            first += ttak_security_accel_blocks(ctx);
+            rec += TTAK_SECURITY_ACCEL_RECORD_WORDS;
+        }
+
+        for (size_t b = 0; !ok && g_security_accel_backends[b]; ++b) {
+            const ttak_security_accel_ops_t *ops = g_security_accel_backends[b];
+            if (!ttak_security_accel_enabled(ops)) continue;
+            ok = ops->chacha20(packed, records, data, blocks);
+            if (!ok) atomic_store_explicit(ops->enabled, false, memory_order_relaxed);
+        }
+
+        if (ok) {
+            first = 0;
+            for (size_t i = 0; i < count; ++i) {
+                ttak_crypto_ctx_t *ctx = &ctxs[i];
+                if (!pick(ctx)) continue;
+                memcpy(ctx->out, data + first * TTAK_SECURITY_ACCEL_BLOCK_BYTES, ctx->in_len);
+                first += ttak_security_accel_blocks(ctx);
+            }
+        }
+    }
+    /* The staging copies hold keys and plaintext. */
+    if (packed) {
+        ttak_security_accel_wipe(packed, record_bytes);
+        ttak_mem_free(packed);
+    }
+    if (data) {
+        ttak_security_accel_wipe(data, blocks * TTAK_SECURITY_ACCEL_BLOCK_BYTES);
+        ttak_mem_free(data);
+    }
+    return ok;
+}
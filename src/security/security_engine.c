@@ -2,62 +2,175 @@
  * @file security_engine.c
  * @brief Runtime dispatch engine — routes crypto ops to the best driver.
  *
- * Detects SIMD capabilities (AVX-512, AVX2, NEON) at compile time and
- * selects the widest available lane width.  Falls back to a scalar driver
- * on platforms without SIMD extensions.
+ * The first request for a driver builds a per-operation table: each entry
+ * names the kernel for that operation and the widest lane count that both
+ * the compiled kernels (TTAK_HAS_*) and the running CPU
+ * (ttak_arch_features()) support. ttak_security_execute() is then a table
+ * lookup and one indirect call.
  */
 
 #include <ttak/security/security_engine.h>
 #include <ttak/security/lea.h>
 #include <ttak/security/seed.h>
-#include <ttak/security/security_engine.h>
+#include <ttak/security/blake3.h>
+#include <ttak/security/argon2.h>
+#include <ttak/arch/ttak_arch.h>
 
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 
-#if defined(__GNUC__) || defined(__clang__)
-#define TTAK_MAYBE_UNUSED __attribute__((unused))
-#else
-#define TTAK_MAYBE_UNUSED
-#endif
+static ttak_io_status_t ttak_security_kernel_lea(ttak_crypto_ctx_t *ctx,
+                                                 const ttak_security_driver_t *driver) {
+    return ttak_lea_encrypt_simd(ctx, driver);
+}
+
+static ttak_io_status_t ttak_security_kernel_seed(ttak_crypto_ctx_t *ctx,
+                                                  const ttak_security_driver_t *driver) {
+    return ttak_seed_encrypt_aligned(ctx, driver);
+}
+
+/* The caller must have run ttak_aes256_expand_key() on @p ctx or set a matching ctx->schedule. */
+static ttak_io_status_t ttak_security_kernel_aes_gcm(ttak_crypto_ctx_t *ctx,
+                                                     const ttak_security_driver_t *driver) {
+    (void)driver;
+    return ttak_aes256_gcm_execute(ctx, ctx->in, ctx->out, ctx->in_len);
+}
+
+static ttak_io_status_t ttak_security_kernel_chacha(ttak_crypto_ctx_t *ctx,
+                                                    const ttak_security_driver_t *driver) {
+    (void)driver;
+    return ttak_chacha20_poly1305_execute(ctx, ctx->in, ctx->out, ctx->in_len);
+}
 
-static ttak_security_driver_t g_scalar_driver TTAK_MAYBE_UNUSED = {
+/* Linear input only; ttak_blake3_hash_pool() is the entry point for pool-sized buffers. */
+static ttak_io_status_t ttak_security_kernel_blake3(ttak_crypto_ctx_t *ctx,
+                                                    const ttak_security_driver_t *driver) {
+    (void)driver;
+    if (!ctx->out || !ctx->out_len || (!ctx->in && ctx->in_len) ||
+        (ctx->key_len && (ctx->key_len != TTAK_BLAKE3_KEY_LEN || !ctx->key))) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    ttak_blake3_hash(ctx->key_len ? ctx->key : NULL, ctx->in, ctx->in_len, ctx->out, ctx->out_len);
+    return TTAK_IO_SUCCESS;
+}
+
+/* Password in @c in, salt in @c aad, optional secret in @c key, tag of @c out_len bytes in @c out. */
+static ttak_io_status_t ttak_security_kernel_argon2id(ttak_crypto_ctx_t *ctx,
+                                                      const ttak_security_driver_t *driver) {
+    (void)driver;
+    ttak_argon2_params_t params = {
+        .t_cost = ctx->hw_state.argon2.t_cost,
+        .m_cost_kib = ctx->hw_state.argon2.m_cost_kib,
+        .lanes = ctx->hw_state.argon2.lanes,
+        .secret = ctx->key,
+        .secret_len = ctx->key_len,
+    };
+    return ttak_argon2id(&params, ctx->in, ctx->in_len, ctx->aad, ctx->aad_len, ctx->out, ctx->out_len, 0);
+}
+
+static ttak_io_status_t ttak_security_kernel_unsupported(ttak_crypto_ctx_t *ctx,
+                                                         const ttak_security_driver_t *driver) {
+    (void)ctx;
+    (void)driver;
+    return TTAK_IO_ERR_INVALID_ARGUMENT;
+}
+
+static const ttak_security_driver_t g_unsupported_driver = {
     .kind = TTAK_SECURITY_DRIVER_SCALAR,
-    .name = "scalar",
-    .lane_width = 1
+    .name = "unsupported",
+    .lane_width = 1,
+    .op = TTAK_SECURITY_OP_COUNT,
+    .execute = ttak_security_kernel_unsupported
 };
 
-static ttak_security_driver_t g_simd_driver = {
-    .kind = TTAK_SECURITY_DRIVER_SIMD,
-    .name = "simd",
-    .lane_width = 8
-};
+static ttak_security_driver_t g_security_drivers[TTAK_SECURITY_OP_COUNT];
+static pthread_once_t g_security_drivers_once = PTHREAD_ONCE_INIT;
 
-static const ttak_security_driver_t *ttak_security_detect_driver(void) {
-#if defined(__AVX512F__)
-    g_simd_driver.lane_width = 16;
-    g_simd_driver.name = "avx512";
-    return &g_simd_driver;
-#elif defined(__AVX2__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
-    g_simd_driver.lane_width = 8;
-#if defined(__ARM_NEON) || defined(__ARM_NEON__)
-    g_simd_driver.name = "neon";
+/** @brief Lane count of the widest vector unit the compiled kernels may use. */
+static size_t ttak_security_compiled_lanes(void) {
+#if defined(TTAK_HAS_AVX512F)
+    return 16;
+#elif defined(TTAK_HAS_AVX2) || defined(TTAK_HAS_NEON)
+    return 8;
+#elif defined(TTAK_HAS_SSE2)
+    return 4;
 #else
-    g_simd_driver.name = "avx2";
+    return 1;
 #endif
-    return &g_simd_driver;
+}
+
+/** @brief Lane count of the widest vector unit the running CPU reports. */
+static size_t ttak_security_host_lanes(uint32_t features) {
+    if (features & TTAK_ARCH_FEATURE_AVX512F) return 16;
+    if (features & (TTAK_ARCH_FEATURE_AVX2 | TTAK_ARCH_FEATURE_NEON)) return 8;
+    if (features & TTAK_ARCH_FEATURE_SSE2) return 4;
+    return 1;
+}
+
+static const char *ttak_security_lane_name(size_t lanes) {
+    switch (lanes) {
+        case 16:
+            return "avx512";
+        case 8:
+#if defined(TTAK_HAS_NEON)
+            return "neon";
 #else
-    return &g_scalar_driver;
+            return "avx2";
 #endif
+        case 4:
+            return "sse2";
+        default:
+            return "scalar";
+    }
 }
 
-const ttak_security_driver_t *ttak_security_pick_driver(ttak_security_op_t op) {
-    (void)op;
-    return ttak_security_detect_driver();
+/* TTAK_SECURITY_KERNEL=scalar forces single-lane drivers, e.g. to cross-check results. */
+static void ttak_security_build_drivers(void) {
+    size_t lanes = ttak_security_compiled_lanes();
+    size_t host = ttak_security_host_lanes(ttak_arch_features());
+    if (host < lanes) {
+        lanes = host;
+    }
+    const char *env = getenv("TTAK_SECURITY_KERNEL");
+    if (env && strcmp(env, "scalar") == 0) {
+        lanes = 1;
+    }
+
+    for (int op = 0; op < TTAK_SECURITY_OP_COUNT; ++op) {
+        ttak_security_driver_t *d = &g_security_drivers[op];
+        *d = g_unsupported_driver;
+        d->op = (ttak_security_op_t)op;
+    }
+
+    static const struct {
+        ttak_security_op_t op;
+        ttak_security_kernel_fn execute;
+    } kernels[] = {
+        { TTAK_SECURITY_LEA_ENC, ttak_security_kernel_lea },
+        { TTAK_SECURITY_SEED_ENC, ttak_security_kernel_seed },
+        { TTAK_SECURITY_AES_GCM, ttak_security_kernel_aes_gcm },
+        { TTAK_SECURITY_CHACHA20_POLY1305, ttak_security_kernel_chacha },
+        { TTAK_SECURITY_HASH_FAST, ttak_security_kernel_blake3 },
+        { TTAK_SECURITY_KDF_HARD, ttak_security_kernel_argon2id },
+        { TTAK_SECURITY_LEA_CTR, ttak_lea_ctr_execute },
+        { TTAK_SECURITY_SEED_CTR, ttak_seed_ctr_execute },
+    };
+    for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); ++i) {
+        ttak_security_driver_t *d = &g_security_drivers[kernels[i].op];
+        d->kind = lanes > 1 ? TTAK_SECURITY_DRIVER_SIMD : TTAK_SECURITY_DRIVER_SCALAR;
+        d->name = ttak_security_lane_name(lanes);
+        d->lane_width = lanes;
+        d->execute = kernels[i].execute;
+    }
 }
 
-static ttak_io_status_t ttak_security_handle_lea(ttak_crypto_ctx_t *ctx) {
-    const ttak_security_driver_t *driver = ttak_security_pick_driver(TTAK_SECURITY_LEA_ENC);
-    return ttak_lea_encrypt_simd(ctx, driver);
+const ttak_security_driver_t *ttak_security_pick_driver(ttak_security_op_t op) {
+    if ((unsigned)op >= (unsigned)TTAK_SECURITY_OP_COUNT) {
+        return &g_unsupported_driver;
+    }
+    pthread_once(&g_security_drivers_once, ttak_security_build_drivers);
+    return &g_security_drivers[op];
 }
 
 ttak_io_status_t ttak_security_execute(ttak_crypto_ctx_t *ctx,
@@ -67,21 +180,33 @@ ttak_io_status_t ttak_security_execute(ttak_crypto_ctx_t *ctx,
     if (!ctx) {
         return TTAK_IO_ERR_INVALID_ARGUMENT;
     }
+    const ttak_security_driver_t *driver = ttak_security_pick_driver(op);
+    return driver->execute(ctx, driver);
+}
 
-    switch (op) {
-        case TTAK_SECURITY_LEA_ENC:
-            return ttak_security_handle_lea(ctx);
-        case TTAK_SECURITY_AES_GCM:
-            return ttak_aes256_gcm_execute(ctx, ctx->in, ctx->out, ctx->in_len);
-        case TTAK_SECURITY_CHACHA20_POLY1305:
-            return ttak_chacha20_poly1305_execute(ctx, ctx->in, ctx->out, ctx->in_len);
-        case TTAK_SECURITY_SEED_ENC:
-            return ttak_seed_encrypt_aligned(ctx,
-                                             ttak_security_pick_driver(TTAK_SECURITY_SEED_ENC));
-        case TTAK_SECURITY_SIGN_PQC:
-        case TTAK_SECURITY_HASH_FAST:
-        case TTAK_SECURITY_KDF_HARD:
-        default:
-            return TTAK_IO_ERR_INVALID_ARGUMENT;
+ttak_io_status_t ttak_security_execute_batch(ttak_crypto_ctx_t *ctxs,
+                                             size_t count,
+                                             ttak_security_op_t op,
+                                             ttak_io_status_t *statuses,
+                                             uint64_t now) {
+    (void)now;
+    if (!ctxs && count) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    const ttak_security_driver_t *driver = ttak_security_pick_driver(op);
+    if (op == TTAK_SECURITY_CHACHA20_POLY1305) {
+        return ttak_chacha20_poly1305_execute_batch(ctxs, count, driver, statuses);
+    }
+
+    ttak_io_status_t first = TTAK_IO_SUCCESS;
+    for (size_t i = 0; i < count; ++i) {
+        ttak_io_status_t rc = driver->execute(&ctxs[i], driver);
+        if (statuses) {
+            statuses[i] = rc;
+        }
+        if (rc != TTAK_IO_SUCCESS && first == TTAK_IO_SUCCESS) {
+            first = rc;
+        }
     }
+    return first;
 }
@@ -2,16 +2,22 @@
  * @file seed.c
  * @brief SEED block cipher implementation (KS X 1213 / ISO 18033-3).
  *
- * Pure software implementation using the official SEED S-boxes and key
- * schedule constants from the KISA specification.  No platform-specific
- * optimisations; intended as a portable reference path.
+ * Single blocks use the official SEED S-box tables and key schedule
+ * constants from the KISA specification.  Counter mode on SIMD builds
+ * also has a bitsliced path: one vector register holds one bit position of
+ * 128 to 512 blocks, and the S-boxes are evaluated as a Boolean circuit
+ * (inversion in a GF((2^4)^2) tower plus the affine output maps), so bulk
+ * keystream needs no table lookups at all.
  */
 
 #include <ttak/security/seed.h>
+#include <ttak/arch/ttak_arch.h>
 
+#include <stdalign.h>
 #include <string.h>
 
 #include "seed_tables.h"
+#include "../../internal/ttak/key_schedule.h"
 
 #define TTAK_SEED_BLOCK_BYTES 16U
 #define TTAK_SEED_ROUNDS      16U
@@ -45,21 +51,17 @@ static inline void ttak_seed_store32(uint8_t *dst, uint32_t v) {
     dst[3] = (uint8_t)v;
 }
 
-static void ttak_seed_key_schedule(ttak_crypto_ctx_t *ctx) {
-    if (ctx->hw_state.seed.rounds == TTAK_SEED_ROUNDS) {
-        return;
-    }
-
-    uint32_t A = ttak_seed_load32(ctx->key + 0);
-    uint32_t B = ttak_seed_load32(ctx->key + 4);
-    uint32_t C = ttak_seed_load32(ctx->key + 8);
-    uint32_t D = ttak_seed_load32(ctx->key + 12);
+void ttak_seed_expand_key(uint32_t round_keys[32], const uint8_t key[16]) {
+    uint32_t A = ttak_seed_load32(key + 0);
+    uint32_t B = ttak_seed_load32(key + 4);
+    uint32_t C = ttak_seed_load32(key + 8);
+    uint32_t D = ttak_seed_load32(key + 12);
 
     for (size_t i = 0; i < TTAK_SEED_ROUNDS; ++i) {
         uint32_t T0 = (A + C - ttak_seed_kc[i]);
         uint32_t T1 = (B - D + ttak_seed_kc[i]);
-        ctx->hw_state.seed.round_keys[i * 2]     = ttak_seed_g(T0);
-        ctx->hw_state.seed.round_keys[i * 2 + 1] = ttak_seed_g(T1);
+        round_keys[i * 2]     = ttak_seed_g(T0);
+        round_keys[i * 2 + 1] = ttak_seed_g(T1);
 
         if ((i & 1U) == 0U) {
             uint32_t tmpA = A;
@@ -71,7 +73,19 @@ static void ttak_seed_key_schedule(ttak_crypto_ctx_t *ctx) {
             D = (D << 8) | (tmpC >> 24);
         }
     }
-    ctx->hw_state.seed.rounds = TTAK_SEED_ROUNDS;
+}
+
+/* Returns the round keys for @p ctx: its session schedule, or hw_state expanded once. */
+static const uint32_t *ttak_seed_key_schedule(ttak_crypto_ctx_t *ctx) {
+    const ttak_security_schedule_t *sched = ttak_security_schedule_match(ctx, TTAK_SECURITY_CIPHER_SEED);
+    if (sched) {
+        return sched->u.seed;
+    }
+    if (ctx->hw_state.seed.rounds != TTAK_SEED_ROUNDS) {
+        ttak_seed_expand_key(ctx->hw_state.seed.round_keys, ctx->key);
+        ctx->hw_state.seed.rounds = TTAK_SEED_ROUNDS;
+    }
+    return ctx->hw_state.seed.round_keys;
 }
 
 static inline void ttak_seed_round(uint32_t *L0, uint32_t *L1,
@@ -157,7 +171,7 @@ ttak_io_status_t ttak_seed_encrypt_aligned(const ttak_crypto_ctx_t *ctx,
         return TTAK_IO_ERR_RANGE;
     }
 
-    ttak_seed_key_schedule((ttak_crypto_ctx_t *)ctx);
+    const uint32_t *rk = ttak_seed_key_schedule((ttak_crypto_ctx_t *)ctx);
 
     size_t lanes = (driver && driver->lane_width) ? driver->lane_width : 1U;
     size_t offset = 0;
@@ -166,9 +180,361 @@ ttak_io_status_t ttak_seed_encrypt_aligned(const ttak_crypto_ctx_t *ctx,
         for (size_t i = 0; i < batch; ++i) {
             const uint8_t *src = ttak_seed_in_block(ctx, offset + i, block_size);
             uint8_t *dst = ttak_seed_out_block(ctx, offset + i, block_size);
-            ttak_seed_encrypt_block(dst, src, ctx->hw_state.seed.round_keys);
+            ttak_seed_encrypt_block(dst, src, rk);
         }
         offset += batch;
     }
     return TTAK_IO_SUCCESS;
 }
+
+static inline uint64_t ttak_seed_load64(const uint8_t *src) {
+    return ((uint64_t)ttak_seed_load32(src) << 32) | ttak_seed_load32(src + 4);
+}
+
+static inline void ttak_seed_store64(uint8_t *dst, uint64_t v) {
+    ttak_seed_store32(dst, (uint32_t)(v >> 32));
+    ttak_seed_store32(dst + 4, (uint32_t)v);
+}
+
+/**
+ * @def TTAK_SEED_PLANE_BITS
+ * @brief Blocks per bitsliced batch, one per bit of a plane register; 0
+ *        when no vector plane is compiled in.
+ */
+#if defined(TTAK_HAS_AVX512F)
+#  include <immintrin.h>
+typedef __m512i ttak_seed_plane_t;
+#  define TTAK_SEED_PLANE_BITS 512U
+#  define TTAK_SEED_P_XOR(a, b) _mm512_xor_si512((a), (b))
+#  define TTAK_SEED_P_XOR3(a, b, c) _mm512_ternarylogic_epi64((a), (b), (c), 0x96)
+#  define TTAK_SEED_P_AND(a, b) _mm512_and_si512((a), (b))
+#  define TTAK_SEED_P_MAJ(a, b, c) _mm512_ternarylogic_epi64((a), (b), (c), 0xE8)
+#  define TTAK_SEED_P_NOT(a) _mm512_ternarylogic_epi64((a), (a), (a), 0x55)
+#  define TTAK_SEED_P_MASK(bit) _mm512_set1_epi64(-(long long)(bit))
+#  define TTAK_SEED_P_LOAD(p) _mm512_load_si512((const void *)(p))
+#  define TTAK_SEED_P_STORE(p, v) _mm512_store_si512((void *)(p), (v))
+#elif defined(TTAK_HAS_AVX2)
+#  include <immintrin.h>
+typedef __m256i ttak_seed_plane_t;
+#  define TTAK_SEED_PLANE_BITS 256U
+#  define TTAK_SEED_P_XOR(a, b) _mm256_xor_si256((a), (b))
+#  define TTAK_SEED_P_AND(a, b) _mm256_and_si256((a), (b))
+#  define TTAK_SEED_P_OR(a, b) _mm256_or_si256((a), (b))
+#  define TTAK_SEED_P_MASK(bit) _mm256_set1_epi64x(-(long long)(bit))
+#  define TTAK_SEED_P_LOAD(p) _mm256_load_si256((const __m256i *)(const void *)(p))
+#  define TTAK_SEED_P_STORE(p, v) _mm256_store_si256((__m256i *)(void *)(p), (v))
+#elif defined(TTAK_HAS_SSE2)
+#  include <emmintrin.h>
+typedef __m128i ttak_seed_plane_t;
+#  define TTAK_SEED_PLANE_BITS 128U
+#  define TTAK_SEED_P_XOR(a, b) _mm_xor_si128((a), (b))
+#  define TTAK_SEED_P_AND(a, b) _mm_and_si128((a), (b))
+#  define TTAK_SEED_P_OR(a, b) _mm_or_si128((a), (b))
+#  define TTAK_SEED_P_MASK(bit) _mm_set1_epi64x(-(long long)(bit))
+#  define TTAK_SEED_P_LOAD(p) _mm_load_si128((const __m128i *)(const void *)(p))
+#  define TTAK_SEED_P_STORE(p, v) _mm_store_si128((__m128i *)(void *)(p), (v))
+#elif defined(TTAK_HAS_NEON)
+#  include <arm_neon.h>
+typedef uint64x2_t ttak_seed_plane_t;
+#  define TTAK_SEED_PLANE_BITS 128U
+#  define TTAK_SEED_P_XOR(a, b) veorq_u64((a), (b))
+#  define TTAK_SEED_P_AND(a, b) vandq_u64((a), (b))
+#  define TTAK_SEED_P_MAJ(a, b, c) vbslq_u64(veorq_u64((a), (b)), (c), (a))
+#  define TTAK_SEED_P_MASK(bit) vdupq_n_u64(0 - (uint64_t)(bit))
+#  define TTAK_SEED_P_NOT(a) veorq_u64((a), vdupq_n_u64(~(uint64_t)0))
+#  define TTAK_SEED_P_LOAD(p) vld1q_u64((p))
+#  define TTAK_SEED_P_STORE(p, v) vst1q_u64((p), (v))
+#else
+#  define TTAK_SEED_PLANE_BITS 0U
+#endif
+
+#if TTAK_SEED_PLANE_BITS
+#ifndef TTAK_SEED_P_XOR3
+#  define TTAK_SEED_P_XOR3(a, b, c) TTAK_SEED_P_XOR(TTAK_SEED_P_XOR((a), (b)), (c))
+#endif
+#ifndef TTAK_SEED_P_MAJ
+#  define TTAK_SEED_P_MAJ(a, b, c) \
+    TTAK_SEED_P_OR(TTAK_SEED_P_AND((a), (b)), TTAK_SEED_P_AND((c), TTAK_SEED_P_XOR((a), (b))))
+#endif
+#ifndef TTAK_SEED_P_NOT
+#  define TTAK_SEED_P_NOT(a) TTAK_SEED_P_XOR((a), TTAK_SEED_P_MASK(1))
+#endif
+
+#define TTAK_SEED_PLANE_WORDS (TTAK_SEED_PLANE_BITS / 64U)
+
+typedef ttak_seed_plane_t ttak_seed_p;
+
+/* GF(2^4) = GF(2)[z] / (z^4 + z + 1), schoolbook product. */
+static inline void ttak_seed_gf16_mul(ttak_seed_p r[4], const ttak_seed_p a[4], const ttak_seed_p b[4]) {
+#define M_(i, j) TTAK_SEED_P_AND(a[i], b[j])
+    ttak_seed_p c0 = M_(0, 0);
+    ttak_seed_p c1 = TTAK_SEED_P_XOR(M_(0, 1), M_(1, 0));
+    ttak_seed_p c2 = TTAK_SEED_P_XOR3(M_(0, 2), M_(1, 1), M_(2, 0));
+    ttak_seed_p c3 = TTAK_SEED_P_XOR(TTAK_SEED_P_XOR(M_(0, 3), M_(1, 2)), TTAK_SEED_P_XOR(M_(2, 1), M_(3, 0)));
+    ttak_seed_p c4 = TTAK_SEED_P_XOR3(M_(1, 3), M_(2, 2), M_(3, 1));
+    ttak_seed_p c5 = TTAK_SEED_P_XOR(M_(2, 3), M_(3, 2));
+    ttak_seed_p c6 = M_(3, 3);
+#undef M_
+    r[0] = TTAK_SEED_P_XOR(c0, c4);
+    r[1] = TTAK_SEED_P_XOR3(c1, c4, c5);
+    r[2] = TTAK_SEED_P_XOR3(c2, c5, c6);
+    r[3] = TTAK_SEED_P_XOR(c3, c6);
+}
+
+static inline void ttak_seed_gf16_sq(ttak_seed_p r[4], const ttak_seed_p a[4]) {
+    ttak_seed_p a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3];
+    r[0] = TTAK_SEED_P_XOR(a0, a2);
+    r[1] = a2;
+    r[2] = TTAK_SEED_P_XOR(a1, a3);
+    r[3] = a3;
+}
+
+/**
+ * @brief Inverse in GF(2^8) mod x^8+x^6+x^5+x+1 of eight bit planes,
+ *        returned in the tower basis the output maps expect.
+ *
+ * The input is mapped into GF(2^4)[y] / (y^2 + y + 8), where h*y + l has
+ * inverse (h*y + h + l) / (8*h^2 + h*l + l^2). Zero maps to zero.
+ */
+static inline void ttak_seed_inv_bs(ttak_seed_p u[8], const ttak_seed_p x[8]) {
+    ttak_seed_p l[4], h[4], hl[4], d[4], t[4], d2[4], d3[4], dinv[4];
+    l[0] = TTAK_SEED_P_XOR3(x[0], x[2], x[5]);
+    l[1] = x[5];
+    l[2] = TTAK_SEED_P_XOR3(x[4], x[6], x[7]);
+    l[3] = TTAK_SEED_P_XOR3(x[1], x[5], x[6]);
+    h[0] = TTAK_SEED_P_XOR3(x[2], x[5], x[7]);
+    h[2] = TTAK_SEED_P_XOR3(x[1], x[2], x[4]);
+    h[2] = TTAK_SEED_P_XOR(h[2], x[7]);
+    h[1] = TTAK_SEED_P_XOR(h[2], x[3]);
+    h[3] = TTAK_SEED_P_XOR3(x[3], x[5], x[6]);
+    for (int i = 0; i < 4; ++i) hl[i] = TTAK_SEED_P_XOR(h[i], l[i]);
+
+    /* d = 8*h^2 + h*l + l^2; 8*h^2 is linear in h. */
+    ttak_seed_gf16_mul(t, h, l);
+    ttak_seed_gf16_sq(d, l);
+    d[0] = TTAK_SEED_P_XOR3(d[0], t[0], h[2]);
+    d[1] = TTAK_SEED_P_XOR3(d[1], t[1], TTAK_SEED_P_XOR3(h[1], h[2], h[3]));
+    d[2] = TTAK_SEED_P_XOR3(d[2], t[2], h[1]);
+    d[3] = TTAK_SEED_P_XOR3(d[3], t[3], TTAK_SEED_P_XOR3(h[0], h[2], h[3]));
+
+    /* d^-1 = d^14 = (d^3)^4 * d^2. */
+    ttak_seed_gf16_sq(d2, d);
+    ttak_seed_gf16_mul(d3, d2, d);
+    ttak_seed_gf16_sq(t, d3);
+    ttak_seed_gf16_sq(t, t);
+    ttak_seed_gf16_mul(dinv, t, d2);
+
+    ttak_seed_gf16_mul(u + 4, h, dinv);
+    ttak_seed_gf16_mul(u, hl, dinv);
+}
+
+/* S1(x) = A1 * x^-1 + 0xa9, from the tower basis. */
+static inline void ttak_seed_s1_out(ttak_seed_p y[8], const ttak_seed_p u[8]) {
+    ttak_seed_p u47 = TTAK_SEED_P_XOR(u[4], u[7]);
+    ttak_seed_p u14 = TTAK_SEED_P_XOR(u[1], u[4]);
+    ttak_seed_p u57 = TTAK_SEED_P_XOR(u[5], u[7]);
+    y[0] = TTAK_SEED_P_NOT(u14);
+    y[1] = TTAK_SEED_P_XOR3(u[1], u[3], u57);
+    y[2] = TTAK_SEED_P_XOR3(u[0], u[2], u47);
+    y[3] = TTAK_SEED_P_NOT(TTAK_SEED_P_XOR(u[0], u14));
+    y[4] = TTAK_SEED_P_XOR(u[2], u[7]);
+    y[5] = TTAK_SEED_P_NOT(TTAK_SEED_P_XOR3(u[0], u[2], u57));
+    y[6] = u57;
+    y[7] = TTAK_SEED_P_NOT(TTAK_SEED_P_XOR3(u14, u[6], u[7]));
+}
+
+/* S2(x) = A2 * x^-1 + 0x38, from the tower basis. */
+static inline void ttak_seed_s2_out(ttak_seed_p y[8], const ttak_seed_p u[8]) {
+    ttak_seed_p u56 = TTAK_SEED_P_XOR(u[5], u[6]);
+    ttak_seed_p u23 = TTAK_SEED_P_XOR(u[2], u[3]);
+    y[0] = TTAK_SEED_P_XOR(u23, u56);
+    y[1] = TTAK_SEED_P_XOR3(u[1], u56, u[7]);
+    y[2] = TTAK_SEED_P_XOR(u[2], u[7]);
+    y[3] = TTAK_SEED_P_NOT(TTAK_SEED_P_XOR3(u23, u[6], u[7]));
+    y[4] = TTAK_SEED_P_NOT(TTAK_SEED_P_XOR3(u[0], u[4], u[7]));
+    y[5] = TTAK_SEED_P_NOT(u[6]);
+    y[6] = TTAK_SEED_P_XOR(u[0], u56);
+    y[7] = TTAK_SEED_P_XOR3(u[0], u[1], TTAK_SEED_P_XOR(u23, u[5]));
+}
+
+/**
+ * @brief Bitsliced G function, in place on 32 planes (plane j is bit j).
+ *
+ * Output byte b takes bit j from every S-box output except the one the
+ * mask m_{(j/2) - b} of the specification clears.
+ */
+static void ttak_seed_g_bs(ttak_seed_p x[32]) {
+    ttak_seed_p y[4][8];
+    for (int b = 0; b < 4; ++b) {
+        ttak_seed_p u[8];
+        ttak_seed_inv_bs(u, &x[8 * b]);
+        if (b & 1) {
+            ttak_seed_s2_out(y[b], u);
+        } else {
+            ttak_seed_s1_out(y[b], u);
+        }
+    }
+    for (int j = 0; j < 8; ++j) {
+        ttak_seed_p all = TTAK_SEED_P_XOR(TTAK_SEED_P_XOR(y[0][j], y[1][j]), TTAK_SEED_P_XOR(y[2][j], y[3][j]));
+        for (int b = 0; b < 4; ++b) {
+            x[8 * b + j] = TTAK_SEED_P_XOR(all, y[((j >> 1) - b) & 3][j]);
+        }
+    }
+}
+
+/* d += a modulo 2^32, ripple carry across the planes. */
+static inline void ttak_seed_add_bs(ttak_seed_p d[32], const ttak_seed_p a[32]) {
+    ttak_seed_p carry = TTAK_SEED_P_AND(d[0], a[0]);
+    d[0] = TTAK_SEED_P_XOR(d[0], a[0]);
+    for (int j = 1; j < 32; ++j) {
+        ttak_seed_p s = TTAK_SEED_P_XOR3(d[j], a[j], carry);
+        carry = TTAK_SEED_P_MAJ(d[j], a[j], carry);
+        d[j] = s;
+    }
+}
+
+/* In-place transpose: afterwards bit r of a[p] is what bit p of a[r] was. */
+static void ttak_seed_transpose64(uint64_t a[64]) {
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for (unsigned j = 32; j; j >>= 1, m ^= m << j) {
+        for (unsigned k = 0; k < 64; k = (k + j + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k + j]) & m;
+            a[k + j] ^= t;
+            a[k] ^= t << j;
+        }
+    }
+}
+
+typedef struct {
+    /* Plane s: L0 bits 0..31, L1, R0, R1; word g covers blocks 64g..64g+63. */
+    alignas(64) uint64_t planes[128][TTAK_SEED_PLANE_WORDS];
+    uint64_t rows[64];
+} ttak_seed_bs_scratch_t;
+
+/**
+ * @brief Encrypts TTAK_SEED_PLANE_BITS counter blocks starting at
+ *        (@p hi, @p lo) into @p ks.
+ */
+static void ttak_seed_ctr_keystream_bs(uint8_t *ks, uint64_t hi, uint64_t lo, const uint32_t *rk,
+                                       ttak_seed_bs_scratch_t *sc) {
+    /* Word row r of the block (bit r of hi or lo) is plane r ^ 32 of its half. */
+    for (unsigned g = 0; g < TTAK_SEED_PLANE_WORDS; ++g) {
+        uint64_t h = hi, l = lo;
+        for (unsigned k = 0; k < 64; ++k) {
+            sc->rows[k] = h;
+            h += (++l == 0);
+        }
+        ttak_seed_transpose64(sc->rows);
+        for (unsigned r = 0; r < 64; ++r) sc->planes[r ^ 32U][g] = sc->rows[r];
+        l = lo;
+        for (unsigned k = 0; k < 64; ++k) sc->rows[k] = l++;
+        ttak_seed_transpose64(sc->rows);
+        for (unsigned r = 0; r < 64; ++r) sc->planes[64U + (r ^ 32U)][g] = sc->rows[r];
+        hi += (lo + 64 < lo);
+        lo += 64;
+    }
+
+    ttak_seed_p st[128];
+    for (unsigned s = 0; s < 128; ++s) st[s] = TTAK_SEED_P_LOAD(sc->planes[s]);
+
+    ttak_seed_p *L = st, *R = st + 64;
+    for (size_t round = 0; round < TTAK_SEED_ROUNDS; ++round) {
+        uint32_t k0 = rk[round * 2], k1 = rk[round * 2 + 1];
+        ttak_seed_p t0[32], t1[32];
+        for (unsigned j = 0; j < 32; ++j) {
+            t0[j] = TTAK_SEED_P_XOR(R[j], TTAK_SEED_P_MASK((k0 >> j) & 1U));
+            t1[j] = TTAK_SEED_P_XOR3(R[32 + j], TTAK_SEED_P_MASK((k1 >> j) & 1U), t0[j]);
+        }
+        ttak_seed_g_bs(t1);
+        ttak_seed_add_bs(t0, t1);
+        ttak_seed_g_bs(t0);
+        ttak_seed_add_bs(t1, t0);
+        ttak_seed_g_bs(t1);
+        ttak_seed_add_bs(t0, t1);
+        for (unsigned j = 0; j < 32; ++j) {
+            L[j] = TTAK_SEED_P_XOR(L[j], t0[j]);
+            L[32 + j] = TTAK_SEED_P_XOR(L[32 + j], t1[j]);
+        }
+        if (round < TTAK_SEED_ROUNDS - 1) {
+            ttak_seed_p *tmp = L;
+            L = R;
+            R = tmp;
+        }
+    }
+    for (unsigned s = 0; s < 64; ++s) {
+        TTAK_SEED_P_STORE(sc->planes[s], L[s]);
+        TTAK_SEED_P_STORE(sc->planes[64 + s], R[s]);
+    }
+
+    for (unsigned g = 0; g < TTAK_SEED_PLANE_WORDS; ++g) {
+        uint8_t *dst = ks + (size_t)g * 64U * TTAK_SEED_BLOCK_BYTES;
+        for (unsigned half = 0; half < 2; ++half) {
+            for (unsigned r = 0; r < 64; ++r) sc->rows[r] = sc->planes[64U * half + (r ^ 32U)][g];
+            ttak_seed_transpose64(sc->rows);
+            for (unsigned k = 0; k < 64; ++k) {
+                ttak_seed_store64(dst + k * TTAK_SEED_BLOCK_BYTES + 8U * half, sc->rows[k]);
+            }
+        }
+    }
+}
+#endif /* TTAK_SEED_PLANE_BITS */
+
+ttak_io_status_t ttak_seed_ctr_execute(ttak_crypto_ctx_t *ctx,
+                                       const ttak_security_driver_t *driver) {
+    if (!ctx || !ctx->key || (ctx->in_len && (!ctx->in || !ctx->out))) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    if (ctx->iv_len && ctx->iv_len != TTAK_SEED_BLOCK_BYTES) {
+        return TTAK_IO_ERR_INVALID_ARGUMENT;
+    }
+    if (ctx->key_len != 16 || ctx->out_len < ctx->in_len) {
+        return TTAK_IO_ERR_RANGE;
+    }
+
+    const uint32_t *rk = ttak_seed_key_schedule(ctx);
+    uint64_t hi = ttak_seed_load64(ctx->iv);
+    uint64_t lo = ttak_seed_load64(ctx->iv + 8);
+    const uint8_t *in = ctx->in;
+    uint8_t *out = ctx->out;
+    size_t left = ctx->in_len;
+
+#if TTAK_SEED_PLANE_BITS
+    if (driver && driver->lane_width > 1) {
+        enum { BATCH = TTAK_SEED_PLANE_BITS * TTAK_SEED_BLOCK_BYTES };
+        ttak_seed_bs_scratch_t sc;
+        alignas(64) uint8_t ks[BATCH];
+        while (left >= (size_t)TTAK_SEED_CTR_BITSLICE_MIN_BLOCKS * TTAK_SEED_BLOCK_BYTES) {
+            size_t bytes = left < BATCH ? left : BATCH;
+            ttak_seed_ctr_keystream_bs(ks, hi, lo, rk, &sc);
+            for (size_t i = 0; i < bytes; ++i) out[i] = in[i] ^ ks[i];
+            size_t blocks = (bytes + TTAK_SEED_BLOCK_BYTES - 1) / TTAK_SEED_BLOCK_BYTES;
+            hi += (lo + blocks < lo);
+            lo += blocks;
+            in += bytes;
+            out += bytes;
+            left -= bytes;
+        }
+        memset(ks, 0, sizeof(ks));
+        memset(&sc, 0, sizeof(sc));
+    }
+#else
+    (void)driver;
+#endif
+
+    while (left > 0) {
+        uint8_t block[TTAK_SEED_BLOCK_BYTES];
+        size_t bytes = left < TTAK_SEED_BLOCK_BYTES ? left : TTAK_SEED_BLOCK_BYTES;
+        ttak_seed_store64(block, hi);
+        ttak_seed_store64(block + 8, lo);
+        ttak_seed_encrypt_block(block, block, rk);
+        for (size_t i = 0; i < bytes; ++i) out[i] = in[i] ^ block[i];
+        hi += (++lo == 0);
+        in += bytes;
+        out += bytes;
+        left -= bytes;
+    }
+
+    ttak_seed_store64(ctx->iv, hi);
+    ttak_seed_store64(ctx->iv + 8, lo);
+    return TTAK_IO_SUCCESS;
+}
@@ -5,12 +5,51 @@
  * Only the hot loops are left comment-free to keep the listing compact; everything
  * else calls out the reasoning so future call sites can be confident about the endian
  * handling and padding steps.
+ *
+ * Compression runs on the SHA extensions when the compiler exposes them (SHA-NI on
+ * x86_64, the ARMv8 crypto extension on AArch64) and on the portable round loop
+ * otherwise. sha256_hash_many() hashes independent messages side by side, one per
+ * 32-bit vector lane, on AVX2 and AVX-512.
  */
 #include <ttak/security/sha256.h>
 #include <string.h>
 
+#include <stdalign.h>
 #include <stdint.h>
 
+/*
+ * x86_64 SHA-NI: __SHA__ for the round instructions plus SSE4.1 for the
+ * state blend. As with AES-NI, nothing is enabled just for being on x86_64.
+ */
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(__SHA__) && defined(__SSE4_1__)
+#  include <immintrin.h>
+#  define TTAK_USE_X86_SHANI 1
+#else
+#  define TTAK_USE_X86_SHANI 0
+#endif
+
+/* AArch64 SHA-256 instructions (FEAT_SHA256), exposed by +sha2 or +crypto. */
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#  include <arm_neon.h>
+#  define TTAK_USE_ARM64_SHA2 1
+#else
+#  define TTAK_USE_ARM64_SHA2 0
+#endif
+
+/*
+ * Multi-buffer lane count: 16 on AVX-512, 8 on AVX2 unless SHA-NI is there
+ * (eight lanes of vector rounds do not beat one stream of SHA256RNDS2).
+ */
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(__AVX512F__)
+#  include <immintrin.h>
+#  define TTAK_SHA256_MB_LANES 16
+#elif (defined(__x86_64__) || defined(_M_X64)) && defined(__AVX2__) && !TTAK_USE_X86_SHANI
+#  include <immintrin.h>
+#  define TTAK_SHA256_MB_LANES 8
+#else
+#  define TTAK_SHA256_MB_LANES 0
+#endif
+
 #define ROTLEFT(a, b) (((a) << (b)) | ((a) >> (32 - (b))))
 #define ROTRIGHT(a, b) (((a) >> (b)) | ((a) << (32 - (b))))
 
@@ -32,62 +71,164 @@ static const uint32_t k[64] = {
     0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
 
+static const uint32_t sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static inline uint32_t sha256_load_be32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3];
+}
+
+static inline void sha256_store_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+#if TTAK_USE_X86_SHANI
+/*
+ * The SHA-NI round instruction keeps the state as ABEF / CDGH and takes two
+ * rounds of W + K in the low half of its third operand.
+ */
+static void sha256_transform(uint32_t state[8], const uint8_t *data, size_t blocks) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)&state[0]), 0xB1);
+    __m128i st1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)&state[4]), 0x1B);
+    __m128i st0 = _mm_alignr_epi8(tmp, st1, 8);
+    st1 = _mm_blend_epi16(st1, tmp, 0xF0);
+
+    for (; blocks; --blocks, data += 64) {
+        __m128i save0 = st0, save1 = st1;
+        __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)(data + 0)), bswap);
+        __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)(data + 16)), bswap);
+        __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)(data + 32)), bswap);
+        __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)(data + 48)), bswap);
+
+/* Four rounds on group i, whose words are in wa; wb/wc/wd are the next groups in ring order. */
+#define SHANI_ROUNDS(i, wa)                                                                            \
+        do {                                                                                           \
+            __m128i wk = _mm_add_epi32((wa), _mm_loadu_si128((const __m128i *)(const void *)&k[4 * (i)])); \
+            st1 = _mm_sha256rnds2_epu32(st1, st0, wk);                                                 \
+            st0 = _mm_sha256rnds2_epu32(st0, st1, _mm_shuffle_epi32(wk, 0x0E));                        \
+        } while (0)
+/* wa = W[4i .. 4i + 3] from the four preceding groups wa (i - 4), wb, wc, wd (i - 1). */
+#define SHANI_SCHEDULE(wa, wb, wc, wd)                                                                 \
+        (wa) = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32((wa), (wb)),                     \
+                                                  _mm_alignr_epi8((wd), (wc), 4)), (wd))
+
+        SHANI_ROUNDS(0, w0);
+        SHANI_ROUNDS(1, w1);
+        SHANI_ROUNDS(2, w2);
+        SHANI_ROUNDS(3, w3);
+        for (int i = 4; i < 16; i += 4) {
+            SHANI_SCHEDULE(w0, w1, w2, w3);
+            SHANI_ROUNDS(i, w0);
+            SHANI_SCHEDULE(w1, w2, w3, w0);
+            SHANI_ROUNDS(i + 1, w1);
+            SHANI_SCHEDULE(w2, w3, w0, w1);
+            SHANI_ROUNDS(i + 2, w2);
+            SHANI_SCHEDULE(w3, w0, w1, w2);
+            SHANI_ROUNDS(i + 3, w3);
+        }
+#undef SHANI_SCHEDULE
+#undef SHANI_ROUNDS
+
+        st0 = _mm_add_epi32(st0, save0);
+        st1 = _mm_add_epi32(st1, save1);
+    }
+
+    tmp = _mm_shuffle_epi32(st0, 0x1B);
+    st1 = _mm_shuffle_epi32(st1, 0xB1);
+    _mm_storeu_si128((__m128i *)(void *)&state[0], _mm_blend_epi16(tmp, st1, 0xF0));
+    _mm_storeu_si128((__m128i *)(void *)&state[4], _mm_alignr_epi8(st1, tmp, 8));
+}
+#elif TTAK_USE_ARM64_SHA2
+/* SHA256H / SHA256H2 take four rounds of W + K with the state as ABCD / EFGH. */
+static void sha256_transform(uint32_t state[8], const uint8_t *data, size_t blocks) {
+    uint32x4_t st0 = vld1q_u32(&state[0]);
+    uint32x4_t st1 = vld1q_u32(&state[4]);
+
+    for (; blocks; --blocks, data += 64) {
+        uint32x4_t save0 = st0, save1 = st1;
+        uint32x4_t w[4];
+        for (int i = 0; i < 16; ++i) {
+            if (i < 4) {
+                w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+            } else {
+                w[i & 3] = vsha256su1q_u32(vsha256su0q_u32(w[i & 3], w[(i + 1) & 3]),
+                                           w[(i + 2) & 3], w[(i + 3) & 3]);
+            }
+            uint32x4_t wk = vaddq_u32(w[i & 3], vld1q_u32(&k[4 * i]));
+            uint32x4_t abcd = st0;
+            st0 = vsha256hq_u32(st0, st1, wk);
+            st1 = vsha256h2q_u32(st1, abcd, wk);
+        }
+        st0 = vaddq_u32(st0, save0);
+        st1 = vaddq_u32(st1, save1);
+    }
+
+    vst1q_u32(&state[0], st0);
+    vst1q_u32(&state[4], st1);
+}
+#else
 /**
- * @brief Compress a single 512-bit block.
+ * @brief Compress @p blocks consecutive 512-bit blocks.
  *
- * @param ctx  Hash state.
- * @param data 64-byte chunk.
+ * @param state  Running hash state.
+ * @param data   64 * @p blocks bytes.
+ * @param blocks Number of blocks.
  */
-static void sha256_transform(SHA256_CTX *ctx, const uint8_t data[]) {
+static void sha256_transform(uint32_t state[8], const uint8_t *data, size_t blocks) {
     uint32_t a, b, c, d, e, f, g, h;
     uint32_t w[64];
     uint32_t i, j;
 
-    /* Load the chunk as big-endian words regardless of host order. */
-    for (i = 0, j = 0; i < 16; ++i, j += 4) {
-        w[i] = (uint32_t)data[j] << 24 |
-               (uint32_t)data[j + 1] << 16 |
-               (uint32_t)data[j + 2] << 8 |
-               (uint32_t)data[j + 3];
-    }
+    for (; blocks; --blocks, data += 64) {
+        /* Load the chunk as big-endian words regardless of host order. */
+        for (i = 0, j = 0; i < 16; ++i, j += 4) {
+            w[i] = sha256_load_be32(data + j);
+        }
 
-    /* Extend the schedule with the standard sigma functions. */
-    for (; i < 64; ++i) {
-        w[i] = SIG1(w[i - 2]) + w[i - 7] + SIG0(w[i - 15]) + w[i - 16];
-    }
+        /* Extend the schedule with the standard sigma functions. */
+        for (; i < 64; ++i) {
+            w[i] = SIG1(w[i - 2]) + w[i - 7] + SIG0(w[i - 15]) + w[i - 16];
+        }
 
-    a = ctx->state[0];
-    b = ctx->state[1];
-    c = ctx->state[2];
-    d = ctx->state[3];
-    e = ctx->state[4];
-    f = ctx->state[5];
-    g = ctx->state[6];
-    h = ctx->state[7];
-
-    for (i = 0; i < 64; ++i) {
-        uint32_t t1 = h + EP1(e) + CH(e, f, g) + k[i] + w[i];
-        uint32_t t2 = EP0(a) + MAJ(a, b, c);
-        h = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
-    }
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        f = state[5];
+        g = state[6];
+        h = state[7];
+
+        for (i = 0; i < 64; ++i) {
+            uint32_t t1 = h + EP1(e) + CH(e, f, g) + k[i] + w[i];
+            uint32_t t2 = EP0(a) + MAJ(a, b, c);
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
 
-    /* State words stay in host order; finalization handles the final swap out. */
-    ctx->state[0] += a;
-    ctx->state[1] += b;
-    ctx->state[2] += c;
-    ctx->state[3] += d;
-    ctx->state[4] += e;
-    ctx->state[5] += f;
-    ctx->state[6] += g;
-    ctx->state[7] += h;
+        /* State words stay in host order; finalization handles the final swap out. */
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
 }
+#endif
 
 /**
  * @brief Initialize the SHA-256 state.
@@ -97,14 +238,7 @@ static void sha256_transform(SHA256_CTX *ctx, const uint8_t data[]) {
 void sha256_init(SHA256_CTX *ctx) {
     ctx->datalen = 0;
     ctx->bitlen = 0;
-    ctx->state[0] = 0x6a09e667;
-    ctx->state[1] = 0xbb67ae85;
-    ctx->state[2] = 0x3c6ef372;
-    ctx->state[3] = 0xa54ff53a;
-    ctx->state[4] = 0x510e527f;
-    ctx->state[5] = 0x9b05688c;
-    ctx->state[6] = 0x1f83d9ab;
-    ctx->state[7] = 0x5be0cd19;
+    memcpy(ctx->state, sha256_iv, sizeof(sha256_iv));
 }
 
 /**
@@ -115,18 +249,32 @@ void sha256_init(SHA256_CTX *ctx) {
  * @param len  Number of bytes to process.
  */
 void sha256_update(SHA256_CTX *ctx, const uint8_t data[], size_t len) {
-    size_t i;
+    if (!len) return;
 
-    for (i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
+    /* Top up a partial block first, then compress whole blocks straight from the input. */
+    if (ctx->datalen) {
+        size_t take = 64 - ctx->datalen;
+        if (take > len) take = len;
+        memcpy(ctx->data + ctx->datalen, data, take);
+        ctx->datalen += (uint32_t)take;
+        data += take;
+        len -= take;
+        if (ctx->datalen < 64) return;
+        sha256_transform(ctx->state, ctx->data, 1);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
+    }
 
-        if (ctx->datalen == 64) {
-            sha256_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
-        }
+    size_t blocks = len / 64;
+    if (blocks) {
+        sha256_transform(ctx->state, data, blocks);
+        ctx->bitlen += (uint64_t)blocks * 512;
+        data += blocks * 64;
+        len -= blocks * 64;
     }
+
+    memcpy(ctx->data, data, len);
+    ctx->datalen = (uint32_t)len;
 }
 
 /**
@@ -144,7 +292,7 @@ void sha256_final(SHA256_CTX *ctx, uint8_t hash[]) {
 
     if (i > 56) {
         while(i < 64) ctx->data[i++] = 0x00;
-        sha256_transform(ctx, ctx->data);
+        sha256_transform(ctx->state, ctx->data, 1);
         memset(ctx->data, 0, 56);
         i = 0;
     }
@@ -162,12 +310,159 @@ void sha256_final(SHA256_CTX *ctx, uint8_t hash[]) {
     ctx->data[57] = ctx->bitlen >> 48;
     ctx->data[56] = ctx->bitlen >> 56;
 
-    sha256_transform(ctx, ctx->data);
+    sha256_transform(ctx->state, ctx->data, 1);
 
     for (i = 0; i < 8; ++i) {
-        hash[i * 4] = (ctx->state[i] >> 24) & 0xFF;
-        hash[i * 4 + 1] = (ctx->state[i] >> 16) & 0xFF;
-        hash[i * 4 + 2] = (ctx->state[i] >> 8) & 0xFF;
-        hash[i * 4 + 3] = (ctx->state[i]) & 0xFF;
+        sha256_store_be32(hash + i * 4, ctx->state[i]);
     }
 }
+
+#if TTAK_SHA256_MB_LANES
+/**
+ * @brief Returns block @p b of the padded form of a message.
+ *
+ * Whole blocks point into the message; the one or two tail blocks are built
+ * in @p scratch with the 0x80 marker and the big-endian bit length.
+ */
+static const uint8_t *sha256_padded_block(const uint8_t *msg, size_t len, size_t b, size_t nblocks,
+                                          uint8_t scratch[64]) {
+    size_t start = b * 64;
+    if (start + 64 <= len) return msg + start;
+
+    size_t have = len > start ? len - start : 0;
+    memset(scratch, 0, 64);
+    if (have) memcpy(scratch, msg + start, have);
+    if (len >= start) scratch[have] = 0x80;
+    if (b + 1 == nblocks) {
+        uint64_t bits = (uint64_t)len * 8;
+        for (int i = 0; i < 8; ++i) scratch[63 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    return scratch;
+}
+
+/** @brief Padded length of a @p len-byte message in blocks. */
+static inline size_t sha256_padded_blocks(size_t len) {
+    return (len + 9 + 63) / 64;
+}
+
+#if TTAK_SHA256_MB_LANES == 16
+typedef __m512i sha256_vec_t;
+#define MB_ADD(a, b) _mm512_add_epi32((a), (b))
+#define MB_XOR(a, b) _mm512_xor_si512((a), (b))
+#define MB_AND(a, b) _mm512_and_si512((a), (b))
+#define MB_ROR(a, n) _mm512_ror_epi32((a), (n))
+#define MB_SHR(a, n) _mm512_srli_epi32((a), (n))
+#define MB_CH(e, f, g) _mm512_ternarylogic_epi32((e), (f), (g), 0xCA)
+#define MB_MAJ(a, b, c) _mm512_ternarylogic_epi32((a), (b), (c), 0xE8)
+#define MB_SET1(x) _mm512_set1_epi32((int)(x))
+#define MB_LOAD(p) _mm512_load_si512((const void *)(p))
+#define MB_STORE(p, v) _mm512_store_si512((void *)(p), (v))
+#else
+typedef __m256i sha256_vec_t;
+#define MB_ADD(a, b) _mm256_add_epi32((a), (b))
+#define MB_XOR(a, b) _mm256_xor_si256((a), (b))
+#define MB_AND(a, b) _mm256_and_si256((a), (b))
+#define MB_ROR(a, n) _mm256_or_si256(_mm256_srli_epi32((a), (n)), _mm256_slli_epi32((a), 32 - (n)))
+#define MB_SHR(a, n) _mm256_srli_epi32((a), (n))
+#define MB_CH(e, f, g) _mm256_xor_si256((g), _mm256_and_si256((e), _mm256_xor_si256((f), (g))))
+#define MB_MAJ(a, b, c) _mm256_or_si256(_mm256_and_si256((a), (b)), _mm256_and_si256((c), _mm256_or_si256((a), (b))))
+#define MB_SET1(x) _mm256_set1_epi32((int)(x))
+#define MB_LOAD(p) _mm256_load_si256((const __m256i *)(const void *)(p))
+#define MB_STORE(p, v) _mm256_store_si256((__m256i *)(void *)(p), (v))
+#endif
+
+/**
+ * @brief Hashes up to TTAK_SHA256_MB_LANES messages, one per lane.
+ *
+ * Every lane runs for as many blocks as the longest message; the state of
+ * a lane whose message has ended is masked out of the feed-forward.
+ */
+static void sha256_hash_lanes(const uint8_t *const msgs[], const size_t lens[], size_t count,
+                              uint8_t digests[][SHA256_BLOCK_SIZE]) {
+    enum { L = TTAK_SHA256_MB_LANES };
+    alignas(64) uint32_t cols[16][L];
+    alignas(64) uint32_t out[8][L];
+    alignas(64) uint32_t live[L];
+    uint8_t scratch[64];
+    size_t nblocks[L], maxblocks = 0;
+    for (size_t l = 0; l < L; ++l) {
+        nblocks[l] = l < count ? sha256_padded_blocks(lens[l]) : 0;
+        if (nblocks[l] > maxblocks) maxblocks = nblocks[l];
+    }
+
+    sha256_vec_t st[8];
+    for (int i = 0; i < 8; ++i) st[i] = MB_SET1(sha256_iv[i]);
+
+    for (size_t b = 0; b < maxblocks; ++b) {
+        /* Transpose block b of every live message into word-major columns. */
+        for (size_t l = 0; l < L; ++l) {
+            live[l] = b < nblocks[l] ? UINT32_MAX : 0;
+            if (!live[l]) {
+                for (int t = 0; t < 16; ++t) cols[t][l] = 0;
+                continue;
+            }
+            const uint8_t *p = sha256_padded_block(msgs[l], lens[l], b, nblocks[l], scratch);
+            for (int t = 0; t < 16; ++t) cols[t][l] = sha256_load_be32(p + 4 * t);
+        }
+
+        sha256_vec_t w[16];
+        sha256_vec_t a = st[0], bb = st[1], c = st[2], d = st[3];
+        sha256_vec_t e = st[4], f = st[5], g = st[6], h = st[7];
+        for (int i = 0; i < 64; ++i) {
+            sha256_vec_t wi;
+            if (i < 16) {
+                wi = MB_LOAD(cols[i]);
+            } else {
+                sha256_vec_t w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+                sha256_vec_t s0 = MB_XOR(MB_XOR(MB_ROR(w15, 7), MB_ROR(w15, 18)), MB_SHR(w15, 3));
+                sha256_vec_t s1 = MB_XOR(MB_XOR(MB_ROR(w2, 17), MB_ROR(w2, 19)), MB_SHR(w2, 10));
+                wi = MB_ADD(MB_ADD(w[i & 15], s0), MB_ADD(w[(i - 7) & 15], s1));
+            }
+            w[i & 15] = wi;
+            sha256_vec_t ep1 = MB_XOR(MB_XOR(MB_ROR(e, 6), MB_ROR(e, 11)), MB_ROR(e, 25));
+            sha256_vec_t ep0 = MB_XOR(MB_XOR(MB_ROR(a, 2), MB_ROR(a, 13)), MB_ROR(a, 22));
+            sha256_vec_t t1 = MB_ADD(MB_ADD(h, ep1), MB_ADD(MB_CH(e, f, g), MB_ADD(wi, MB_SET1(k[i]))));
+            sha256_vec_t t2 = MB_ADD(ep0, MB_MAJ(a, bb, c));
+            h = g;
+            g = f;
+            f = e;
+            e = MB_ADD(d, t1);
+            d = c;
+            c = bb;
+            bb = a;
+            a = MB_ADD(t1, t2);
+        }
+        /* Lanes past the end of their message keep the digest they already have. */
+        sha256_vec_t keep = MB_LOAD(live);
+        sha256_vec_t next[8] = { a, bb, c, d, e, f, g, h };
+        for (int i = 0; i < 8; ++i) st[i] = MB_ADD(st[i], MB_AND(next[i], keep));
+    }
+
+    for (int i = 0; i < 8; ++i) MB_STORE(out[i], st[i]);
+    for (size_t l = 0; l < count; ++l) {
+        for (int i = 0; i < 8; ++i) sha256_store_be32(digests[l] + 4 * i, out[i][l]);
+    }
+}
+#endif
+
+void sha256_hash_many(const uint8_t *const msgs[], const size_t lens[], size_t count,
+                      uint8_t digests[][SHA256_BLOCK_SIZE]) {
+    size_t i = 0;
+#if TTAK_SHA256_MB_LANES
+    for (; count - i >= TTAK_SHA256_MB_MIN_BATCH; i += TTAK_SHA256_MB_LANES) {
+        size_t n = count - i < TTAK_SHA256_MB_LANES ? count - i : TTAK_SHA256_MB_LANES;
+        sha256_hash_lanes(msgs + i, lens + i, n, digests + i);
+        if (n < TTAK_SHA256_MB_LANES) {
+            i += n;
+            break;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        SHA256_CTX ctx;
+        sha256_init(&ctx);
+        sha256_update(&ctx, msgs[i], lens[i]);
+        sha256_final(&ctx, digests[i]);
+    }
+}
+
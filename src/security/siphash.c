@@ -1,13 +1,23 @@
 /**
  * @file siphash.c
- * @brief SipHash-2-4 implementation for byte buffers and single uint64 keys.
+ * @brief SipHash-2-4 and SipHash-1-3 for byte buffers and single uint64 keys.
  *
- * SipHash-2-4 uses 2 compression rounds per block and 4 finalisation rounds.
- * The 128-bit seed is split into k0/k1 to match the reference implementation
- * by Aumasson and Bernstein (2012).
+ * SipHash-2-4 uses 2 compression rounds per block and 4 finalisation rounds;
+ * SipHash-1-3 uses 1 and 3. The 128-bit seed is split into k0/k1 to match
+ * the reference implementation by Aumasson and Bernstein (2012).
+ *
+ * The SipHash-1-3 batch runs four keys through one AVX2 state, one 64-bit
+ * lane per key. A key of n whole words takes n + 1 steps (its words, then
+ * the length block); lanes that finish early keep their state through the
+ * rest of the group's steps, so all four enter finalisation together.
  */
 
 #include <ttak/security/siphash.h>
+#include <ttak/arch/ttak_arch.h>
+
+#if defined(TTAK_HAS_AVX2)
+#  include <immintrin.h>
+#endif
 
 #define ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
 
@@ -39,6 +49,22 @@
         v2 = ROTL(v2, 32);  \
     } while (0)
 
+/* Length block: the trailing len % 8 bytes with len in the top byte. */
+static inline uint64_t ttak_siphash_tail(const uint8_t *left, size_t len) {
+    uint64_t b = ((uint64_t)len) << 56;
+    switch (len % 8) {
+        case 7: b |= ((uint64_t)left[6]) << 48; // fallthrough
+        case 6: b |= ((uint64_t)left[5]) << 40; // fallthrough
+        case 5: b |= ((uint64_t)left[4]) << 32; // fallthrough
+        case 4: b |= ((uint64_t)left[3]) << 24; // fallthrough
+        case 3: b |= ((uint64_t)left[2]) << 16; // fallthrough
+        case 2: b |= ((uint64_t)left[1]) << 8;  // fallthrough
+        case 1: b |= ((uint64_t)left[0]); break;
+        case 0: break;
+    }
+    return b;
+}
+
 uint64_t ttak_siphash24(const void *key, size_t len, uint64_t k0, uint64_t k1) {
     uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
     uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
@@ -56,19 +82,7 @@ uint64_t ttak_siphash24(const void *key, size_t len, uint64_t k0, uint64_t k1) {
         v0 ^= m;
     }
 
-    const uint8_t *left = data;
-    uint64_t b = ((uint64_t)len) << 56;
-    switch (len % 8) {
-        case 7: b |= ((uint64_t)left[6]) << 48; // fallthrough
-        case 6: b |= ((uint64_t)left[5]) << 40; // fallthrough
-        case 5: b |= ((uint64_t)left[4]) << 32; // fallthrough
-        case 4: b |= ((uint64_t)left[3]) << 24; // fallthrough
-        case 3: b |= ((uint64_t)left[2]) << 16; // fallthrough
-        case 2: b |= ((uint64_t)left[1]) << 8;  // fallthrough
-        case 1: b |= ((uint64_t)left[0]); break;
-        case 0: break;
-    }
-
+    uint64_t b = ttak_siphash_tail(data, len);
     v3 ^= b;
     SIPROUND;
     SIPROUND;
@@ -103,3 +117,132 @@ uint64_t ttak_siphash24_u64(uint64_t val, uint64_t k0, uint64_t k1) {
 
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+uint64_t ttak_siphash13(const void *key, size_t len, uint64_t k0, uint64_t k1) {
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+    const uint8_t *data = (const uint8_t *)key;
+    const uint8_t *end = data + (len - (len % 8));
+    uint64_t m;
+
+    for (; data != end; data += 8) {
+        m = U8TO64_LE(data);
+        v3 ^= m;
+        SIPROUND;
+        v0 ^= m;
+    }
+
+    uint64_t b = ttak_siphash_tail(data, len);
+    v3 ^= b;
+    SIPROUND;
+    v0 ^= b;
+
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+#if defined(TTAK_HAS_AVX2)
+
+static inline __m256i ttak_siphash_rotl4(__m256i x, int b) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, b), _mm256_srli_epi64(x, 64 - b));
+}
+
+#define SIPROUND4                                                                      \
+    do {                                                                               \
+        v0 = _mm256_add_epi64(v0, v1);                                                 \
+        v1 = ttak_siphash_rotl4(v1, 13);                                               \
+        v1 = _mm256_xor_si256(v1, v0);                                                 \
+        v0 = _mm256_shuffle_epi32(v0, _MM_SHUFFLE(2, 3, 0, 1));                        \
+        v2 = _mm256_add_epi64(v2, v3);                                                 \
+        v3 = _mm256_shuffle_epi8(v3, rot16);                                           \
+        v3 = _mm256_xor_si256(v3, v2);                                                 \
+        v0 = _mm256_add_epi64(v0, v3);                                                 \
+        v3 = ttak_siphash_rotl4(v3, 21);                                               \
+        v3 = _mm256_xor_si256(v3, v0);                                                 \
+        v2 = _mm256_add_epi64(v2, v1);                                                 \
+        v1 = ttak_siphash_rotl4(v1, 17);                                               \
+        v1 = _mm256_xor_si256(v1, v2);                                                 \
+        v2 = _mm256_shuffle_epi32(v2, _MM_SHUFFLE(2, 3, 0, 1));                        \
+    } while (0)
+
+/* Word a key absorbs at @p step: a data word, then the length block, then 0. */
+static inline uint64_t ttak_siphash_word(const uint8_t *key, size_t len, size_t step) {
+    size_t words = len / 8;
+    if (step < words) return U8TO64_LE(key + 8 * step);
+    return step == words ? ttak_siphash_tail(key + 8 * words, len) : 0;
+}
+
+static void ttak_siphash13_x4(const void *const *keys, const size_t *lens, uint64_t k0, uint64_t k1,
+                              uint64_t out[4]) {
+    const __m256i rot16 = _mm256_setr_epi8(6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13,
+                                           6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13);
+    __m256i v0 = _mm256_set1_epi64x((long long)(0x736f6d6570736575ULL ^ k0));
+    __m256i v1 = _mm256_set1_epi64x((long long)(0x646f72616e646f6dULL ^ k1));
+    __m256i v2 = _mm256_set1_epi64x((long long)(0x6c7967656e657261ULL ^ k0));
+    __m256i v3 = _mm256_set1_epi64x((long long)(0x7465646279746573ULL ^ k1));
+    const uint8_t *p[4] = { keys[0], keys[1], keys[2], keys[3] };
+    size_t words[4] = { lens[0] / 8, lens[1] / 8, lens[2] / 8, lens[3] / 8 };
+    size_t steps = words[0], common = words[0];
+    for (int i = 1; i < 4; ++i) {
+        if (words[i] > steps) steps = words[i];
+        if (words[i] < common) common = words[i];
+    }
+    const __m256i last = _mm256_setr_epi64x((long long)words[0], (long long)words[1], (long long)words[2],
+                                            (long long)words[3]);
+
+    /* Every lane is still absorbing data words. */
+    size_t step = 0;
+    for (; step < common; ++step) {
+        __m256i m = _mm256_setr_epi64x((long long)U8TO64_LE(p[0] + 8 * step), (long long)U8TO64_LE(p[1] + 8 * step),
+                                       (long long)U8TO64_LE(p[2] + 8 * step), (long long)U8TO64_LE(p[3] + 8 * step));
+        v3 = _mm256_xor_si256(v3, m);
+        SIPROUND4;
+        v0 = _mm256_xor_si256(v0, m);
+    }
+    for (; step <= steps; ++step) {
+        __m256i m = _mm256_setr_epi64x((long long)ttak_siphash_word(p[0], lens[0], step),
+                                       (long long)ttak_siphash_word(p[1], lens[1], step),
+                                       (long long)ttak_siphash_word(p[2], lens[2], step),
+                                       (long long)ttak_siphash_word(p[3], lens[3], step));
+        /* Lanes past their length block keep their state; words are far below 2^63. */
+        __m256i done = _mm256_cmpgt_epi64(_mm256_set1_epi64x((long long)step), last);
+        __m256i s0 = v0, s1 = v1, s2 = v2, s3 = v3;
+        v3 = _mm256_xor_si256(v3, m);
+        SIPROUND4;
+        v0 = _mm256_xor_si256(v0, m);
+        v0 = _mm256_blendv_epi8(v0, s0, done);
+        v1 = _mm256_blendv_epi8(v1, s1, done);
+        v2 = _mm256_blendv_epi8(v2, s2, done);
+        v3 = _mm256_blendv_epi8(v3, s3, done);
+    }
+
+    v2 = _mm256_xor_si256(v2, _mm256_set1_epi64x(0xff));
+    SIPROUND4;
+    SIPROUND4;
+    SIPROUND4;
+    __m256i h = _mm256_xor_si256(_mm256_xor_si256(v0, v1), _mm256_xor_si256(v2, v3));
+    _mm256_storeu_si256((__m256i *)out, h);
+}
+
+#undef SIPROUND4
+
+#endif /* TTAK_HAS_AVX2 */
+
+void ttak_siphash13_batch(const void *const *keys, const size_t *lens, size_t n,
+                          uint64_t k0, uint64_t k1, uint64_t *out) {
+    size_t i = 0;
+#if defined(TTAK_HAS_AVX2)
+    for (; i + 4 <= n; i += 4) {
+        ttak_siphash13_x4(keys + i, lens + i, k0, k1, out + i);
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = ttak_siphash13(keys[i], lens[i], k0, k1);
+    }
+}
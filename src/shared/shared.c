@@ -9,7 +9,9 @@
 #include <ttak/timing/timing.h>
 #include <ttak/mem/mem.h>
 #include <ttak/mem/epoch.h>
+#include <ttak/mem/hazard.h>
 #include <ttak/types/ttak_compiler.h>
+#include "../../internal/app_types.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
@@ -112,6 +114,44 @@ static ttak_shared_result_t _ttak_shared_validate_owner(ttak_shared_t *self, tta
     return TTAK_OWNER_SUCCESS;
 }
 
+/* Source of owner_gen stamps; a resource re-initialised at the same address never matches old cache entries. */
+static uint64_t _Atomic g_shared_owner_gen = 1;
+
+/*
+ * Per-thread cache of passed owner checks for ttak_shared_read(). Owners
+ * are only ever added to a resource, so a pass stays valid until the
+ * resource's owner_gen changes; owner IDs are never reused, so the ID
+ * guards against a recycled owner address. Tiny C has no thread-local
+ * storage, so there every read checks the mask.
+ */
+#define TTAK_SHARED_OWNER_CACHE_WAYS 8
+
+typedef struct {
+    const ttak_shared_t *self;
+    const ttak_owner_t *owner;
+    uint32_t owner_id;
+    uint64_t gen;
+} _ttak_shared_owner_pass_t;
+
+#if !defined(__TINYC__)
+static TTAK_THREAD_LOCAL _ttak_shared_owner_pass_t t_owner_passes[TTAK_SHARED_OWNER_CACHE_WAYS];
+#endif
+
+static bool _ttak_shared_owner_ok(ttak_shared_t *self, ttak_owner_t *claimant) {
+    if (!claimant) return false;
+    if (self->level < TTAK_SHARED_LEVEL_3) return true;
+#if !defined(__TINYC__)
+    uint64_t gen = atomic_load_explicit(&self->owner_gen, memory_order_relaxed);
+    _ttak_shared_owner_pass_t *e = &t_owner_passes[(((uintptr_t)self >> 6) ^ ((uintptr_t)claimant >> 4)) % TTAK_SHARED_OWNER_CACHE_WAYS];
+    if (TTAK_LIKELY(e->self == self && e->owner == claimant && e->owner_id == claimant->id && e->gen == gen)) return true;
+    if (!ttak_dynamic_mask_test(&self->owners_mask, claimant->id)) return false;
+    e->self = self; e->owner = claimant; e->owner_id = claimant->id; e->gen = gen;
+    return true;
+#else
+    return ttak_dynamic_mask_test(&self->owners_mask, claimant->id);
+#endif
+}
+
 /**
  * @brief Default implementation of the allocate method.
  */
@@ -135,6 +175,7 @@ static ttak_shared_result_t ttak_shared_allocate_impl(ttak_shared_t *self, size_
     self->ts = header->ts;
     self->type_name = "raw_buffer";
     atomic_init(&self->retired_ptr, (void *)0);
+    atomic_store_explicit(&self->owner_gen, atomic_fetch_add(&g_shared_owner_gen, 1), memory_order_relaxed);
 
     return TTAK_OWNER_SUCCESS;
 }
@@ -164,7 +205,7 @@ static const void *ttak_shared_access_impl(ttak_shared_t *self, ttak_owner_t *cl
 
     /* [ULTRA-FAST LOCK-FREE PATH] */
     if (TTAK_UNLIKELY(self->is_atomic_read)) {
-        ttak_rwlock_rdlock(&self->rwlock);
+        ttak_brlock_rdlock(&self->rwlock);
     }
 
     /* 
@@ -186,7 +227,7 @@ static const void *ttak_shared_access_impl(ttak_shared_t *self, ttak_owner_t *cl
     if (result) *result = res;
 
     if (TTAK_UNLIKELY(res != TTAK_OWNER_SUCCESS && self->level == TTAK_SHARED_LEVEL_3)) {
-        if (self->is_atomic_read) ttak_rwlock_unlock(&self->rwlock);
+        if (self->is_atomic_read) ttak_brlock_rdunlock(&self->rwlock);
         return NULL;
     }
 
@@ -196,12 +237,22 @@ static const void *ttak_shared_access_impl(ttak_shared_t *self, ttak_owner_t *cl
 static const void *ttak_shared_access_ebr_impl(ttak_shared_t *self, ttak_owner_t *claimant, bool use_ebr_protection, ttak_shared_result_t *result) {
     if (TTAK_UNLIKELY(!self)) return NULL;
 
-    if (TTAK_LIKELY(use_ebr_protection)) {
-        ttak_epoch_enter();
+    void *ptr;
+    if (TTAK_UNLIKELY(use_ebr_protection && self->reclaim_mode == TTAK_RECLAIM_HAZARD)) {
+        /* Pin the container, then the payload; release_ebr() drops both. */
+        if (TTAK_UNLIKELY(ttak_hazard_available() < 2)) {
+            if (result) *result = TTAK_OWNER_SHARE_DENIED;
+            return NULL;
+        }
+        (void)ttak_hazard_publish(self);
+        ptr = ttak_hazard_protect(&self->shared);
+    } else {
+        if (TTAK_LIKELY(use_ebr_protection)) {
+            ttak_epoch_enter();
+        }
+        /* Use acquire load to ensure we see the payload data written by swap_ebr */
+        ptr = atomic_load_explicit(&self->shared, memory_order_acquire);
     }
-
-    /* Use acquire load to ensure we see the payload data written by swap_ebr */
-    void *ptr = atomic_load_explicit(&self->shared, memory_order_acquire);
     
     if (TTAK_LIKELY(self->level == TTAK_SHARED_NO_LEVEL)) {
         if (result) *result = TTAK_OWNER_SUCCESS;
@@ -213,7 +264,7 @@ static const void *ttak_shared_access_ebr_impl(ttak_shared_t *self, ttak_owner_t
     if (result) *result = res;
 
     if (TTAK_UNLIKELY(res != TTAK_OWNER_SUCCESS && self->level == TTAK_SHARED_LEVEL_3)) {
-        if (use_ebr_protection) ttak_epoch_exit();
+        if (use_ebr_protection) self->release_ebr(self);
         return NULL;
     }
 
@@ -223,13 +274,17 @@ static const void *ttak_shared_access_ebr_impl(ttak_shared_t *self, ttak_owner_t
 static void ttak_shared_release_impl(ttak_shared_t *self) {
     if (!self) return;
     if (self->is_atomic_read) {
-        ttak_rwlock_unlock(&self->rwlock);
+        ttak_brlock_rdunlock(&self->rwlock);
     }
 }
 
 static void ttak_shared_release_ebr_impl(ttak_shared_t *self) {
-    (void)self;
     /* Assumes caller used use_ebr_protection=true in access_ebr */
+    if (self && self->reclaim_mode == TTAK_RECLAIM_HAZARD) {
+        ttak_hazard_release();
+        ttak_hazard_release();
+        return;
+    }
     ttak_epoch_exit();
 }
 
@@ -266,17 +321,17 @@ static ttak_shared_result_t ttak_shared_sync_all_impl(ttak_shared_t *self, ttak_
 
 static ttak_shared_result_t ttak_shared_set_ro_impl(ttak_shared_t *self) {
     if (!self) return TTAK_OWNER_INVALID;
-    ttak_rwlock_wrlock(&self->rwlock);
+    ttak_brlock_wrlock(&self->rwlock);
     self->status |= TTAK_SHARED_READONLY;
-    ttak_rwlock_unlock(&self->rwlock);
+    ttak_brlock_wrunlock(&self->rwlock);
     return TTAK_OWNER_SUCCESS;
 }
 
 static ttak_shared_result_t ttak_shared_set_rw_impl(ttak_shared_t *self) {
     if (!self) return TTAK_OWNER_INVALID;
-    ttak_rwlock_wrlock(&self->rwlock);
+    ttak_brlock_wrlock(&self->rwlock);
     self->status &= ~TTAK_SHARED_READONLY;
-    ttak_rwlock_unlock(&self->rwlock);
+    ttak_brlock_wrunlock(&self->rwlock);
     return TTAK_OWNER_SUCCESS;
 }
 
@@ -286,6 +341,33 @@ static ttak_shared_result_t ttak_shared_set_atomic_read_impl(ttak_shared_t *self
     return TTAK_OWNER_SUCCESS;
 }
 
+static ttak_shared_result_t ttak_shared_set_reclaim_mode_impl(ttak_shared_t *self, ttak_reclaim_mode_t mode) {
+    if (!self) return TTAK_OWNER_INVALID;
+    if (mode != TTAK_RECLAIM_EPOCH && mode != TTAK_RECLAIM_HAZARD) return TTAK_OWNER_INVALID;
+    ttak_brlock_wrlock(&self->rwlock);
+    /* ttak_shared_read() readers are only visible to epochs. */
+    if (mode == TTAK_RECLAIM_HAZARD && (self->status & TTAK_SHARED_READ_MOSTLY)) {
+        ttak_brlock_wrunlock(&self->rwlock);
+        return TTAK_OWNER_INVALID;
+    }
+    self->reclaim_mode = mode;
+    ttak_brlock_wrunlock(&self->rwlock);
+    return TTAK_OWNER_SUCCESS;
+}
+
+static ttak_shared_result_t ttak_shared_set_read_mostly_impl(ttak_shared_t *self, bool enable) {
+    if (!self) return TTAK_OWNER_INVALID;
+    ttak_brlock_wrlock(&self->rwlock);
+    if (enable && self->reclaim_mode != TTAK_RECLAIM_EPOCH) {
+        ttak_brlock_wrunlock(&self->rwlock);
+        return TTAK_OWNER_INVALID;
+    }
+    if (enable) self->status |= TTAK_SHARED_READ_MOSTLY;
+    else self->status &= ~TTAK_SHARED_READ_MOSTLY;
+    ttak_brlock_wrunlock(&self->rwlock);
+    return TTAK_OWNER_SUCCESS;
+}
+
 /* Helper for retired container cleanup */
 static void _ttak_shared_container_cleanup(void *ptr) {
     ttak_shared_t *self = (ttak_shared_t *)ptr;
@@ -300,7 +382,7 @@ static void _ttak_shared_container_cleanup(void *ptr) {
         if (page) ttak_dangerous_free((void *)page);
     }
     
-    ttak_rwlock_destroy(&self->rwlock);
+    ttak_brlock_destroy(&self->rwlock);
     
     /* Finally free the container itself */
     ttak_mem_free(self);
@@ -312,12 +394,12 @@ static void ttak_shared_retire_impl(ttak_shared_t *self) {
     /* Retire the internal data if it exists */
     void *ptr = atomic_load(&self->shared);
     if (ptr) {
-        ttak_epoch_retire(ptr, self->cleanup ? self->cleanup : ttak_mem_free);
         atomic_store(&self->shared, (void *)0);
+        ttak_reclaim_retire(self->reclaim_mode, ptr, self->cleanup ? self->cleanup : ttak_mem_free);
     }
 
     /* Retire the container itself */
-    ttak_epoch_retire(self, _ttak_shared_container_cleanup);
+    ttak_reclaim_retire(self->reclaim_mode, self, _ttak_shared_container_cleanup);
 }
 
 /**
@@ -339,17 +421,21 @@ void ttak_shared_init(ttak_shared_t *self) {
     self->set_ro = ttak_shared_set_ro_impl;
     self->set_rw = ttak_shared_set_rw_impl;
     self->set_atomic_read = ttak_shared_set_atomic_read_impl;
+    self->set_reclaim_mode = ttak_shared_set_reclaim_mode_impl;
+    self->set_read_mostly = ttak_shared_set_read_mostly_impl;
     self->retire = ttak_shared_retire_impl;
 
-    ttak_rwlock_init(&self->rwlock);
+    ttak_brlock_init(&self->rwlock);
     ttak_dynamic_mask_init(&self->owners_mask);
     
     atomic_init(&self->shared, (void *)0);
     atomic_init(&self->retired_ptr, (void *)0);
+    atomic_init(&self->owner_gen, atomic_fetch_add(&g_shared_owner_gen, 1));
     
     self->status = TTAK_SHARED_READY;
     self->level = TTAK_SHARED_LEVEL_1;
     self->is_atomic_read = false;
+    self->reclaim_mode = TTAK_RECLAIM_EPOCH;
     self->size = 0;
     self->ts = 0;
     self->cleanup = NULL;
@@ -379,7 +465,7 @@ void ttak_shared_init(ttak_shared_t *self) {
 void ttak_shared_destroy(ttak_shared_t *self) {
     if (!self) return;
 
-    ttak_rwlock_wrlock(&self->rwlock);
+    ttak_brlock_wrlock(&self->rwlock);
     
     void *ptr = atomic_load(&self->shared);
     if (self->cleanup && ptr) {
@@ -396,8 +482,8 @@ void ttak_shared_destroy(ttak_shared_t *self) {
         if (page) ttak_dangerous_free((void *)page);
     }
     
-    ttak_rwlock_unlock(&self->rwlock);
-    ttak_rwlock_destroy(&self->rwlock);
+    ttak_brlock_wrunlock(&self->rwlock);
+    ttak_brlock_destroy(&self->rwlock);
 }
 
 ttak_shared_result_t ttak_shared_swap_ebr(ttak_shared_t *self, void *new_shared, size_t new_size) {
@@ -412,6 +498,22 @@ ttak_shared_result_t ttak_shared_swap_ebr(ttak_shared_t *self, void *new_shared,
     header->ts = ttak_get_tick_count_ns();
     memcpy(header->data, new_shared, new_size);
 
+    /*
+     * Read-mostly: publish by pointer swap. The write lock only orders
+     * writers; ttak_shared_read() never takes it, and no status bit that
+     * readers share a line with is touched.
+     */
+    if (self->status & TTAK_SHARED_READ_MOSTLY) {
+        ttak_brlock_wrlock(&self->rwlock);
+        void *old_ptr = atomic_exchange_explicit(&self->shared, header->data, memory_order_acq_rel);
+        self->size = new_size;
+        self->ts = header->ts;
+        self->cleanup = _ttak_shared_payload_free;
+        ttak_brlock_wrunlock(&self->rwlock);
+        if (old_ptr) ttak_epoch_retire(old_ptr, _ttak_shared_payload_free);
+        return TTAK_OWNER_SUCCESS;
+    }
+
     /* OPTIMIZATION: Lock-free path for NO_LEVEL */
     if (TTAK_LIKELY(self->level == TTAK_SHARED_NO_LEVEL)) {
         void *old_ptr = atomic_exchange_explicit(&self->shared, header->data, memory_order_acq_rel);
@@ -421,13 +523,13 @@ ttak_shared_result_t ttak_shared_swap_ebr(ttak_shared_t *self, void *new_shared,
         self->cleanup = _ttak_shared_payload_free;
 
         if (old_ptr) {
-            ttak_epoch_retire(old_ptr, self->cleanup);
+            ttak_reclaim_retire(self->reclaim_mode, old_ptr, self->cleanup);
         }
         return TTAK_OWNER_SUCCESS;
     }
 
     /* Fallback for strict levels */
-    ttak_rwlock_wrlock(&self->rwlock);
+    ttak_brlock_wrlock(&self->rwlock);
     self->status |= TTAK_SHARED_SWAPPING;
 
     void *old_ptr = atomic_load_explicit(&self->shared, memory_order_relaxed);
@@ -439,10 +541,10 @@ ttak_shared_result_t ttak_shared_swap_ebr(ttak_shared_t *self, void *new_shared,
 
     self->status &= ~TTAK_SHARED_SWAPPING;
     self->status |= TTAK_SHARED_DIRTY;
-    ttak_rwlock_unlock(&self->rwlock);
+    ttak_brlock_wrunlock(&self->rwlock);
 
     if (old_ptr) {
-        ttak_epoch_retire(old_ptr, self->cleanup);
+        ttak_reclaim_retire(self->reclaim_mode, old_ptr, self->cleanup);
     }
 
     return TTAK_OWNER_SUCCESS;
@@ -458,3 +560,21 @@ uint64_t ttak_shared_get_payload_ts(const void *ptr) {
     return TTAK_GET_HEADER(ptr)->ts;
 }
 
+
+const void *ttak_shared_read(ttak_shared_t *self, ttak_owner_t *claimant, ttak_shared_result_t *result) {
+    if (TTAK_UNLIKELY(!self)) return NULL;
+    ttak_epoch_enter();
+    void *ptr = atomic_load_explicit(&self->shared, memory_order_acquire);
+    bool ok = self->level == TTAK_SHARED_NO_LEVEL || _ttak_shared_owner_ok(self, claimant);
+    if (result) *result = ok ? TTAK_OWNER_SUCCESS : TTAK_OWNER_INVALID;
+    if (TTAK_UNLIKELY(!ptr || (!ok && self->level == TTAK_SHARED_LEVEL_3))) {
+        ttak_epoch_exit();
+        return NULL;
+    }
+    return ptr;
+}
+
+void ttak_shared_read_end(ttak_shared_t *self) {
+    (void)self;
+    ttak_epoch_exit();
+}
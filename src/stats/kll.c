@@ -0,0 +1,189 @@
+#include <ttak/stats/kll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef struct {
+    uint64_t value;
+    uint64_t weight;
+} kll_weighted_t;
+
+static int kll_compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int kll_compare_weighted(const void *a, const void *b) {
+    uint64_t x = ((const kll_weighted_t *)a)->value, y = ((const kll_weighted_t *)b)->value;
+    return (x > y) - (x < y);
+}
+
+static unsigned kll_coin(ttak_kll_t *sk) {
+    uint64_t x = sk->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    sk->rng = x;
+    return (unsigned)(x >> 63);
+}
+
+/* Capacity of level @p h: k at the top, shrinking by 2/3 per level below. */
+static uint32_t kll_level_cap(const ttak_kll_t *sk, uint32_t h) {
+    double cap = (double)sk->k;
+    for (uint32_t depth = sk->levels - 1 - h; depth > 0 && cap > TTAK_KLL_MIN_LEVEL_CAP; --depth) {
+        cap *= 2.0 / 3.0;
+    }
+    uint32_t c = (uint32_t)ceil(cap);
+    return c < TTAK_KLL_MIN_LEVEL_CAP ? TTAK_KLL_MIN_LEVEL_CAP : c;
+}
+
+static _Bool kll_reserve(ttak_kll_t *sk, uint32_t h, uint32_t need) {
+    if (need <= sk->alloc[h]) return 1;
+    uint32_t grow = sk->alloc[h] ? sk->alloc[h] * 2 : kll_level_cap(sk, h) + 1;
+    if (grow < need) grow = need;
+    uint64_t *items = realloc(sk->items[h], (size_t)grow * sizeof(*items));
+    if (!items) return 0;
+    sk->items[h] = items;
+    sk->alloc[h] = grow;
+    return 1;
+}
+
+/*
+ * Sorts level @p h and promotes every other sample, from a random parity,
+ * at twice the weight. An odd sample out stays behind so the total weight
+ * is unchanged.
+ */
+static _Bool kll_compact(ttak_kll_t *sk, uint32_t h) {
+    if (h + 1 >= TTAK_KLL_MAX_LEVELS) return 0;
+    if (h + 1 == sk->levels) sk->levels++;
+    uint32_t len = sk->len[h];
+    uint32_t paired = len & ~1U;
+    if (!kll_reserve(sk, h + 1, sk->len[h + 1] + paired / 2)) return 0;
+
+    uint64_t *src = sk->items[h];
+    qsort(src, len, sizeof(*src), kll_compare_u64);
+    uint64_t *dst = sk->items[h + 1];
+    for (uint32_t i = kll_coin(sk); i < paired; i += 2) {
+        dst[sk->len[h + 1]++] = src[i];
+    }
+    if (len & 1U) src[0] = src[len - 1];
+    sk->len[h] = len & 1U;
+    return 1;
+}
+
+/* Compacts every level at or over capacity until none is. */
+static _Bool kll_compress(ttak_kll_t *sk) {
+    _Bool changed = 1;
+    while (changed) {
+        changed = 0;
+        for (uint32_t h = 0; h < sk->levels; ++h) {
+            if (sk->len[h] >= kll_level_cap(sk, h)) {
+                if (!kll_compact(sk, h)) return 0;
+                changed = 1;
+            }
+        }
+    }
+    return 1;
+}
+
+void ttak_kll_init(ttak_kll_t *sk, uint32_t k, uint64_t seed) {
+    memset(sk, 0, sizeof(*sk));
+    sk->k = k ? k : TTAK_KLL_DEFAULT_K;
+    if (sk->k < TTAK_KLL_MIN_LEVEL_CAP) sk->k = TTAK_KLL_MIN_LEVEL_CAP;
+    sk->min = UINT64_MAX;
+    sk->rng = seed ? seed : 0x9e3779b97f4a7c15ULL;
+}
+
+void ttak_kll_destroy(ttak_kll_t *sk) {
+    if (!sk) return;
+    for (uint32_t h = 0; h < TTAK_KLL_MAX_LEVELS; ++h) free(sk->items[h]);
+    memset(sk, 0, sizeof(*sk));
+}
+
+_Bool ttak_kll_update(ttak_kll_t *sk, uint64_t value) {
+    if (!sk->levels) sk->levels = 1;
+    if (!kll_reserve(sk, 0, sk->len[0] + 1)) return 0;
+    sk->items[0][sk->len[0]++] = value;
+    sk->n++;
+    if (value < sk->min) sk->min = value;
+    if (value > sk->max) sk->max = value;
+    if (sk->len[0] >= kll_level_cap(sk, 0)) return kll_compress(sk);
+    return 1;
+}
+
+_Bool ttak_kll_merge(ttak_kll_t *dst, const ttak_kll_t *src) {
+    if (!src->n) return 1;
+    if (src->levels > dst->levels) dst->levels = src->levels;
+    for (uint32_t h = 0; h < src->levels; ++h) {
+        if (!src->len[h]) continue;
+        if (!kll_reserve(dst, h, dst->len[h] + src->len[h])) return 0;
+        memcpy(dst->items[h] + dst->len[h], src->items[h], (size_t)src->len[h] * sizeof(uint64_t));
+        dst->len[h] += src->len[h];
+    }
+    dst->n += src->n;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    return kll_compress(dst);
+}
+
+uint64_t ttak_kll_count(const ttak_kll_t *sk) {
+    return sk->n;
+}
+
+_Bool ttak_kll_quantiles(const ttak_kll_t *sk, const double *qs, size_t nq, uint64_t *out) {
+    if (!sk->n) return 0;
+    size_t m = 0;
+    for (uint32_t h = 0; h < sk->levels; ++h) m += sk->len[h];
+    kll_weighted_t *all = malloc(m * sizeof(*all));
+    if (!all) return 0;
+    size_t j = 0;
+    for (uint32_t h = 0; h < sk->levels; ++h) {
+        for (uint32_t i = 0; i < sk->len[h]; ++i) {
+            all[j].value = sk->items[h][i];
+            all[j].weight = 1ULL << h;
+            ++j;
+        }
+    }
+    qsort(all, m, sizeof(*all), kll_compare_weighted);
+    /* Prefix sums in place of the weights, for a binary search per quantile. */
+    for (size_t i = 1; i < m; ++i) all[i].weight += all[i - 1].weight;
+
+    for (size_t i = 0; i < nq; ++i) {
+        double q = qs[i];
+        if (q <= 0.0) {
+            out[i] = sk->min;
+            continue;
+        }
+        if (q >= 1.0) {
+            out[i] = sk->max;
+            continue;
+        }
+        uint64_t rank = (uint64_t)ceil(q * (double)sk->n);
+        if (rank == 0) rank = 1;
+        size_t lo = 0, hi = m - 1;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (all[mid].weight >= rank) hi = mid;
+            else lo = mid + 1;
+        }
+        out[i] = all[lo].value;
+    }
+    free(all);
+    return 1;
+}
+
+uint64_t ttak_kll_quantile(const ttak_kll_t *sk, double q) {
+    uint64_t v = 0;
+    return ttak_kll_quantiles(sk, &q, 1, &v) ? v : 0;
+}
+
+double ttak_kll_rank(const ttak_kll_t *sk, uint64_t value) {
+    if (!sk->n) return 0.0;
+    uint64_t below = 0;
+    for (uint32_t h = 0; h < sk->levels; ++h) {
+        for (uint32_t i = 0; i < sk->len[h]; ++i) {
+            if (sk->items[h][i] <= value) below += 1ULL << h;
+        }
+    }
+    return (double)below / (double)sk->n;
+}
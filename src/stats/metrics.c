@@ -0,0 +1,624 @@
+/**
+ * @file metrics.c
+ * @brief Metric registry, Prometheus text writer and the scrape server.
+ */
+
+#include <ttak/stats/metrics.h>
+#include <ttak/mem/mem.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/types/ttak_compiler.h>
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+/** Poll interval of the server thread, bounding ttak_metrics_server_stop() latency. */
+#define TTAK_METRICS_POLL_MS 100
+/** Bytes of an HTTP request read before answering. */
+#define TTAK_METRICS_REQ_MAX 4096
+
+static _Atomic uint32_t g_metrics_thread_seq;
+static _Thread_local uint32_t t_metrics_cell = UINT32_MAX;
+
+/* Counter cell of the calling thread, fixed for its lifetime. */
+static inline uint32_t metrics_thread_cell(void) {
+    if (TTAK_UNLIKELY(t_metrics_cell == UINT32_MAX)) {
+        t_metrics_cell = atomic_fetch_add_explicit(&g_metrics_thread_seq, 1, memory_order_relaxed) %
+                         TTAK_STATS_SHARDS;
+    }
+    return t_metrics_cell;
+}
+
+static void *metrics_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
+}
+
+static void metrics_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+static char *metrics_strdup(const char *s) {
+    if (!s) return NULL;
+    size_t n = strlen(s) + 1;
+    char *d = malloc(n);
+    if (d) memcpy(d, s, n);
+    return d;
+}
+
+static bool metrics_name_valid(const char *name) {
+    if (!name || !*name) return false;
+    for (const char *p = name; *p; p++) {
+        char c = *p;
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+        if (!alpha && (p == name || c < '0' || c > '9')) return false;
+    }
+    return true;
+}
+
+static void metric_free(ttak_metric_t *m) {
+    if (m->hist) free(m->hist);
+    free(m->name);
+    free(m->help);
+    free(m->labels);
+    metrics_aligned_free(m);
+}
+
+void ttak_metrics_registry_init(ttak_metrics_registry_t *reg) {
+    pthread_mutex_init(&reg->lock, NULL);
+    reg->head = NULL;
+    reg->tail = NULL;
+}
+
+void ttak_metrics_registry_destroy(ttak_metrics_registry_t *reg) {
+    if (!reg) return;
+    ttak_metric_t *m = reg->head;
+    while (m) {
+        ttak_metric_t *next = m->next;
+        metric_free(m);
+        m = next;
+    }
+    reg->head = reg->tail = NULL;
+    pthread_mutex_destroy(&reg->lock);
+}
+
+static ttak_metric_t *metrics_add(ttak_metrics_registry_t *reg, ttak_metric_type_t type, const char *name,
+                                  const char *help, const char *labels) {
+    if (!reg || !metrics_name_valid(name)) return NULL;
+    ttak_metric_t *m = metrics_aligned_alloc(sizeof(*m));
+    if (!m) return NULL;
+    memset(m, 0, sizeof(*m));
+    m->type = type;
+    m->name = metrics_strdup(name);
+    m->help = metrics_strdup(help);
+    m->labels = labels && *labels ? metrics_strdup(labels) : NULL;
+    if (!m->name || (help && !m->help) || (labels && *labels && !m->labels)) {
+        metric_free(m);
+        return NULL;
+    }
+    atomic_init(&m->gauge, 0);
+    for (int i = 0; i < TTAK_STATS_SHARDS; i++) atomic_init(&m->cells[i].value, 0);
+    return m;
+}
+
+static ttak_metric_t *metrics_publish(ttak_metrics_registry_t *reg, ttak_metric_t *m) {
+    pthread_mutex_lock(&reg->lock);
+    if (reg->tail) {
+        reg->tail->next = m;
+    } else {
+        reg->head = m;
+    }
+    reg->tail = m;
+    pthread_mutex_unlock(&reg->lock);
+    return m;
+}
+
+ttak_metric_t *ttak_metrics_counter(ttak_metrics_registry_t *reg, const char *name, const char *help,
+                                    const char *labels) {
+    ttak_metric_t *m = metrics_add(reg, TTAK_METRIC_COUNTER, name, help, labels);
+    return m ? metrics_publish(reg, m) : NULL;
+}
+
+ttak_metric_t *ttak_metrics_gauge(ttak_metrics_registry_t *reg, const char *name, const char *help,
+                                  const char *labels) {
+    ttak_metric_t *m = metrics_add(reg, TTAK_METRIC_GAUGE, name, help, labels);
+    return m ? metrics_publish(reg, m) : NULL;
+}
+
+ttak_metric_t *ttak_metrics_histogram(ttak_metrics_registry_t *reg, const char *name, const char *help,
+                                      const char *labels) {
+    ttak_metric_t *m = metrics_add(reg, TTAK_METRIC_HISTOGRAM, name, help, labels);
+    if (!m) return NULL;
+    m->hist = malloc(sizeof(*m->hist));
+    if (!m->hist) {
+        metric_free(m);
+        return NULL;
+    }
+    ttak_stats_init(m->hist, 0, 0);
+    return metrics_publish(reg, m);
+}
+
+ttak_metric_t *ttak_metrics_register_fn(ttak_metrics_registry_t *reg, ttak_metric_type_t type,
+                                        const char *name, const char *help, const char *labels,
+                                        ttak_metric_read_fn read, void *arg, const void *owner) {
+    if (!read || type == TTAK_METRIC_HISTOGRAM) return NULL;
+    ttak_metric_t *m = metrics_add(reg, type, name, help, labels);
+    if (!m) return NULL;
+    m->read = read;
+    m->arg = arg;
+    m->owner = owner;
+    return metrics_publish(reg, m);
+}
+
+ttak_metric_t *ttak_metrics_register_histogram_fn(ttak_metrics_registry_t *reg, const char *name,
+                                                  const char *help, const char *labels,
+                                                  ttak_metric_snapshot_fn snapshot, void *arg,
+                                                  const void *owner) {
+    if (!snapshot) return NULL;
+    ttak_metric_t *m = metrics_add(reg, TTAK_METRIC_HISTOGRAM, name, help, labels);
+    if (!m) return NULL;
+    m->snapshot = snapshot;
+    m->arg = arg;
+    m->owner = owner;
+    return metrics_publish(reg, m);
+}
+
+/* Unlinks every metric @p match accepts; called with the lock held. */
+static size_t metrics_remove_if(ttak_metrics_registry_t *reg, bool (*match)(const ttak_metric_t *, const void *),
+                                const void *key) {
+    size_t removed = 0;
+    ttak_metric_t *prev = NULL, *m = reg->head;
+    while (m) {
+        ttak_metric_t *next = m->next;
+        if (match(m, key)) {
+            if (prev) {
+                prev->next = next;
+            } else {
+                reg->head = next;
+            }
+            if (reg->tail == m) reg->tail = prev;
+            metric_free(m);
+            removed++;
+        } else {
+            prev = m;
+        }
+        m = next;
+    }
+    return removed;
+}
+
+static bool metrics_match_self(const ttak_metric_t *m, const void *key) {
+    return m == key;
+}
+
+static bool metrics_match_owner(const ttak_metric_t *m, const void *key) {
+    return m->owner == key;
+}
+
+void ttak_metrics_unregister(ttak_metrics_registry_t *reg, ttak_metric_t *metric) {
+    if (!reg || !metric) return;
+    pthread_mutex_lock(&reg->lock);
+    metrics_remove_if(reg, metrics_match_self, metric);
+    pthread_mutex_unlock(&reg->lock);
+}
+
+size_t ttak_metrics_unregister_owner(ttak_metrics_registry_t *reg, const void *owner) {
+    if (!reg || !owner) return 0;
+    pthread_mutex_lock(&reg->lock);
+    size_t removed = metrics_remove_if(reg, metrics_match_owner, owner);
+    pthread_mutex_unlock(&reg->lock);
+    return removed;
+}
+
+void ttak_metric_add(ttak_metric_t *metric, uint64_t n) {
+    atomic_fetch_add_explicit(&metric->cells[metrics_thread_cell()].value, n, memory_order_relaxed);
+}
+
+double ttak_metric_value(const ttak_metric_t *metric) {
+    if (!metric) return 0.0;
+    if (metric->read) return metric->read(metric->arg);
+    if (metric->type == TTAK_METRIC_GAUGE) {
+        return (double)atomic_load_explicit(&metric->gauge, memory_order_relaxed);
+    }
+    if (metric->type == TTAK_METRIC_COUNTER) {
+        uint64_t sum = 0;
+        for (int i = 0; i < TTAK_STATS_SHARDS; i++) {
+            sum += atomic_load_explicit(&metric->cells[i].value, memory_order_relaxed);
+        }
+        return (double)sum;
+    }
+    return 0.0;
+}
+
+/* --- Text exposition --- */
+
+/**
+ * @brief Small output buffer in front of the sink.
+ */
+typedef struct metrics_out {
+    ttak_metrics_sink_fn sink;
+    void *arg;
+    int failed;
+    size_t len;
+    char buf[4096];
+} metrics_out_t;
+
+static void out_flush(metrics_out_t *o) {
+    if (o->len && !o->failed && o->sink(o->arg, o->buf, o->len) != 0) o->failed = 1;
+    o->len = 0;
+}
+
+static void out_write(metrics_out_t *o, const char *s, size_t n) {
+    while (n && !o->failed) {
+        size_t room = sizeof(o->buf) - o->len;
+        size_t take = n < room ? n : room;
+        memcpy(o->buf + o->len, s, take);
+        o->len += take;
+        s += take;
+        n -= take;
+        if (o->len == sizeof(o->buf)) out_flush(o);
+    }
+}
+
+static void out_puts(metrics_out_t *o, const char *s) {
+    out_write(o, s, strlen(s));
+}
+
+static void out_printf(metrics_out_t *o, const char *fmt, ...) {
+    char tmp[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+    if (n > 0) out_write(o, tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+}
+
+static void out_double(metrics_out_t *o, double v) {
+    if (isnan(v)) {
+        out_puts(o, "NaN");
+    } else if (isinf(v)) {
+        out_puts(o, v > 0 ? "+Inf" : "-Inf");
+    } else if (v == (double)(int64_t)v && fabs(v) < 9.007199254740992e15) {
+        out_printf(o, "%" PRId64, (int64_t)v);
+    } else {
+        out_printf(o, "%.17g", v);
+    }
+}
+
+/* name{labels[,extra]} */
+static void out_series(metrics_out_t *o, const ttak_metric_t *m, const char *suffix, const char *extra) {
+    out_puts(o, m->name);
+    if (suffix) out_puts(o, suffix);
+    if (m->labels || extra) {
+        out_puts(o, "{");
+        if (m->labels) out_puts(o, m->labels);
+        if (m->labels && extra) out_puts(o, ",");
+        if (extra) out_puts(o, extra);
+        out_puts(o, "}");
+    }
+    out_puts(o, " ");
+}
+
+static void out_header(metrics_out_t *o, const ttak_metric_t *m) {
+    static const char *const type_names[] = { "counter", "gauge", "histogram" };
+    if (m->help) {
+        out_puts(o, "# HELP ");
+        out_puts(o, m->name);
+        out_puts(o, " ");
+        for (const char *p = m->help; *p; p++) {
+            if (*p == '\\') {
+                out_puts(o, "\\\\");
+            } else if (*p == '\n') {
+                out_puts(o, "\\n");
+            } else {
+                out_write(o, p, 1);
+            }
+        }
+        out_puts(o, "\n");
+    }
+    out_puts(o, "# TYPE ");
+    out_puts(o, m->name);
+    out_puts(o, " ");
+    out_puts(o, type_names[m->type]);
+    out_puts(o, "\n");
+}
+
+static uint64_t metrics_bucket_upper(size_t idx) {
+    return idx + 1 < TTAK_STATS_HIST_BUCKETS ? ttak_stats_bucket_lower(idx + 1) - 1 : UINT64_MAX;
+}
+
+/*
+ * Cumulative buckets at le = 2^k - 1, from 0 up to the first bound that
+ * holds every sample. The log-linear stats buckets split each power of two
+ * evenly, so these bounds fall exactly on stats bucket edges.
+ */
+static void out_histogram(metrics_out_t *o, const ttak_metric_t *m, ttak_stats_snapshot_t *snap) {
+    if (m->snapshot) {
+        memset(snap, 0, sizeof(*snap));
+        m->snapshot(m->arg, snap);
+    } else {
+        ttak_stats_snapshot(m->hist, snap);
+    }
+    uint64_t cum = 0;
+    size_t idx = 0;
+    char le[48];
+    for (unsigned k = 0; k <= 64 && cum < snap->count; k++) {
+        uint64_t bound = k == 64 ? UINT64_MAX : (1ULL << k) - 1ULL;
+        while (idx < TTAK_STATS_HIST_BUCKETS && metrics_bucket_upper(idx) <= bound) {
+            cum += snap->histogram[idx++];
+        }
+        snprintf(le, sizeof(le), "le=\"%" PRIu64 "\"", bound);
+        out_series(o, m, "_bucket", le);
+        out_printf(o, "%" PRIu64 "\n", cum);
+    }
+    out_series(o, m, "_bucket", "le=\"+Inf\"");
+    out_printf(o, "%" PRIu64 "\n", snap->count);
+    out_series(o, m, "_sum", NULL);
+    out_printf(o, "%" PRIu64 "\n", snap->sum);
+    out_series(o, m, "_count", NULL);
+    out_printf(o, "%" PRIu64 "\n", snap->count);
+}
+
+static void out_metric(metrics_out_t *o, const ttak_metric_t *m, ttak_stats_snapshot_t *snap) {
+    if (m->type == TTAK_METRIC_HISTOGRAM) {
+        out_histogram(o, m, snap);
+        return;
+    }
+    out_series(o, m, NULL, NULL);
+    out_double(o, ttak_metric_value(m));
+    out_puts(o, "\n");
+}
+
+static bool metrics_seen_before(const ttak_metrics_registry_t *reg, const ttak_metric_t *m) {
+    for (const ttak_metric_t *p = reg->head; p != m; p = p->next) {
+        if (strcmp(p->name, m->name) == 0) return true;
+    }
+    return false;
+}
+
+int ttak_metrics_write(ttak_metrics_registry_t *reg, ttak_metrics_sink_fn sink, void *arg) {
+    if (!reg || !sink) return -1;
+    metrics_out_t *o = malloc(sizeof(*o));
+    ttak_stats_snapshot_t *snap = malloc(sizeof(*snap));
+    if (!o || !snap) {
+        free(o);
+        free(snap);
+        return -1;
+    }
+    o->sink = sink;
+    o->arg = arg;
+    o->failed = 0;
+    o->len = 0;
+
+    pthread_mutex_lock(&reg->lock);
+    /* One family at a time: the first series of a name pulls in the later ones. */
+    for (const ttak_metric_t *m = reg->head; m && !o->failed; m = m->next) {
+        if (metrics_seen_before(reg, m)) continue;
+        out_header(o, m);
+        for (const ttak_metric_t *s = m; s; s = s->next) {
+            if (s == m || strcmp(s->name, m->name) == 0) out_metric(o, s, snap);
+        }
+    }
+    pthread_mutex_unlock(&reg->lock);
+    out_flush(o);
+
+    int rc = o->failed ? -1 : 0;
+    free(snap);
+    free(o);
+    return rc;
+}
+
+static int metrics_file_sink(void *arg, const char *data, size_t len) {
+    return fwrite(data, 1, len, (FILE *)arg) == len ? 0 : -1;
+}
+
+int ttak_metrics_write_file(ttak_metrics_registry_t *reg, FILE *out) {
+    if (!out) return -1;
+    return ttak_metrics_write(reg, metrics_file_sink, out);
+}
+
+/* --- Built-in metrics --- */
+
+static double builtin_mem_usage(void *arg) {
+    (void)arg;
+    return (double)ttak_mem_get_usage();
+}
+
+static double builtin_epoch_field(void *arg) {
+    ttak_epoch_stats_t st;
+    ttak_epoch_stats_snapshot(&st);
+    switch ((uintptr_t)arg) {
+        case 0: return (double)st.pending_batches;
+        case 1: return (double)st.pending_bytes;
+        case 2: return (double)st.pinned_threads;
+        default: return (double)st.oldest_epoch_lag;
+    }
+}
+
+static void builtin_epoch_reclaim(void *arg, ttak_stats_snapshot_t *out) {
+    (void)arg;
+    ttak_epoch_stats_t *st = malloc(sizeof(*st));
+    if (!st) return;
+    ttak_epoch_stats_snapshot(st);
+    *out = st->reclaim_ns;
+    free(st);
+}
+
+static ttak_metrics_registry_t g_default_registry;
+static pthread_once_t g_default_once = PTHREAD_ONCE_INIT;
+
+static void metrics_default_init(void) {
+    ttak_metrics_registry_t *reg = &g_default_registry;
+    ttak_metrics_registry_init(reg);
+    ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_mem_usage_bytes",
+                             "Bytes currently allocated through the ttak allocator.", NULL,
+                             builtin_mem_usage, NULL, NULL);
+    ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_epoch_pending_batches",
+                             "Sealed retire batches waiting for reclamation.", NULL,
+                             builtin_epoch_field, (void *)(uintptr_t)0, NULL);
+    ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_epoch_pending_bytes",
+                             "Declared bytes retired but not yet reclaimed.", NULL,
+                             builtin_epoch_field, (void *)(uintptr_t)1, NULL);
+    ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_epoch_pinned_threads",
+                             "Threads inside an epoch critical section.", NULL,
+                             builtin_epoch_field, (void *)(uintptr_t)2, NULL);
+    ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_epoch_oldest_lag",
+                             "Epochs the oldest pinned thread is behind.", NULL,
+                             builtin_epoch_field, (void *)(uintptr_t)3, NULL);
+    ttak_metrics_register_histogram_fn(reg, "ttak_epoch_reclaim_ns",
+                                       "Duration of epoch reclaim passes in nanoseconds.", NULL,
+                                       builtin_epoch_reclaim, NULL, NULL);
+}
+
+ttak_metrics_registry_t *ttak_metrics_default(void) {
+    pthread_once(&g_default_once, metrics_default_init);
+    return &g_default_registry;
+}
+
+/* --- HTTP --- */
+
+#ifndef _WIN32
+
+static int metrics_fd_sink(void *arg, const char *data, size_t len) {
+    int fd = *(int *)arg;
+    while (len) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0) return -1;
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+int ttak_metrics_serve_fd(ttak_metrics_registry_t *reg, int fd) {
+    /* Read up to the end of the headers, or until the client goes quiet. */
+    char req[TTAK_METRICS_REQ_MAX];
+    size_t have = 0;
+    while (have < sizeof(req) - 1) {
+        ssize_t n = recv(fd, req + have, sizeof(req) - 1 - have, 0);
+        if (n <= 0) break;
+        have += (size_t)n;
+        req[have] = '\0';
+        if (strstr(req, "\r\n\r\n") || strstr(req, "\n\n")) break;
+    }
+    static const char hdr[] = "HTTP/1.0 200 OK\r\n"
+                              "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                              "Connection: close\r\n\r\n";
+    if (metrics_fd_sink(&fd, hdr, sizeof(hdr) - 1) != 0) return -1;
+    return ttak_metrics_write(reg, metrics_fd_sink, &fd);
+}
+
+struct ttak_metrics_server {
+    ttak_metrics_registry_t *reg;
+    int listen_fd;
+    uint16_t port;
+    _Atomic bool stop;
+    pthread_t thread;
+};
+
+static void *metrics_server_main(void *arg) {
+    ttak_metrics_server_t *srv = arg;
+    while (!atomic_load_explicit(&srv->stop, memory_order_acquire)) {
+        struct pollfd pfd = { .fd = srv->listen_fd, .events = POLLIN, .revents = 0 };
+        if (poll(&pfd, 1, TTAK_METRICS_POLL_MS) <= 0) continue;
+        int fd = accept(srv->listen_fd, NULL, NULL);
+        if (fd < 0) continue;
+        /* A stalled client may hold the thread for at most this long. */
+        struct timeval tv = { .tv_sec = 1, .tv_usec = 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        ttak_metrics_serve_fd(srv->reg, fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+ttak_metrics_server_t *ttak_metrics_server_start(ttak_metrics_registry_t *reg, const char *bind_addr,
+                                                 uint16_t port) {
+    if (!reg) return NULL;
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, bind_addr ? bind_addr : "127.0.0.1", &addr.sin_addr) != 1) return NULL;
+
+    ttak_metrics_server_t *srv = calloc(1, sizeof(*srv));
+    if (!srv) return NULL;
+    srv->reg = reg;
+    atomic_init(&srv->stop, false);
+    srv->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (srv->listen_fd < 0) goto fail;
+    int one = 1;
+    setsockopt(srv->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(srv->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) goto fail;
+    if (listen(srv->listen_fd, 16) != 0) goto fail;
+    socklen_t alen = sizeof(addr);
+    if (getsockname(srv->listen_fd, (struct sockaddr *)&addr, &alen) != 0) goto fail;
+    srv->port = ntohs(addr.sin_port);
+    if (pthread_create(&srv->thread, NULL, metrics_server_main, srv) != 0) goto fail;
+    return srv;
+
+fail:
+    if (srv->listen_fd >= 0) close(srv->listen_fd);
+    free(srv);
+    return NULL;
+}
+
+uint16_t ttak_metrics_server_port(const ttak_metrics_server_t *server) {
+    return server ? server->port : 0;
+}
+
+void ttak_metrics_server_stop(ttak_metrics_server_t *server) {
+    if (!server) return;
+    atomic_store_explicit(&server->stop, true, memory_order_release);
+    pthread_join(server->thread, NULL);
+    close(server->listen_fd);
+    free(server);
+}
+
+#else
+
+int ttak_metrics_serve_fd(ttak_metrics_registry_t *reg, int fd) {
+    (void)reg;
+    (void)fd;
+    return -1;
+}
+
+ttak_metrics_server_t *ttak_metrics_server_start(ttak_metrics_registry_t *reg, const char *bind_addr,
+                                                 uint16_t port) {
+    (void)reg;
+    (void)bind_addr;
+    (void)port;
+    return NULL;
+}
+
+uint16_t ttak_metrics_server_port(const ttak_metrics_server_t *server) {
+    (void)server;
+    return 0;
+}
+
+void ttak_metrics_server_stop(ttak_metrics_server_t *server) {
+    (void)server;
+}
+
+#endif
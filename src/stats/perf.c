@@ -0,0 +1,244 @@
+#include <ttak/stats/perf.h>
+#include <ttak/timing/timing.h>
+#include <ttak/types/ttak_compiler.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define TTAK_PERF_LINUX 1
+#endif
+
+#if defined(TTAK_PERF_LINUX) && (defined(__x86_64__) || defined(__i386__))
+#define TTAK_PERF_RDPMC 1
+#endif
+
+enum { PERF_UNTRIED = 0, PERF_OPEN, PERF_REFUSED };
+
+typedef struct perf_thread {
+    int state;
+    int leader;                        /**< Group leader fd (cycles). */
+    int fd[TTAK_PERF_EVENTS];          /**< -1 for a counter the kernel refused. */
+    int slot[TTAK_PERF_EVENTS];        /**< Position in the group read, or -1. */
+    int members;
+    void *page[TTAK_PERF_EVENTS];      /**< struct perf_event_mmap_page, or NULL. */
+} perf_thread_t;
+
+static _Thread_local perf_thread_t t_perf;
+static pthread_once_t g_perf_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_perf_key;
+
+static void perf_close(perf_thread_t *t) {
+#ifdef TTAK_PERF_LINUX
+    long page = sysconf(_SC_PAGESIZE);
+    for (int e = 0; e < TTAK_PERF_EVENTS; e++) {
+        if (t->page[e]) munmap(t->page[e], (size_t)page);
+        if (t->fd[e] >= 0) close(t->fd[e]);
+        t->page[e] = NULL;
+        t->fd[e] = -1;
+        t->slot[e] = -1;
+    }
+#endif
+    t->leader = -1;
+    t->members = 0;
+    t->state = PERF_UNTRIED;
+}
+
+static void perf_thread_exit(void *arg) {
+    perf_close(arg);
+}
+
+static void perf_make_key(void) {
+    pthread_key_create(&g_perf_key, perf_thread_exit);
+}
+
+#ifdef TTAK_PERF_LINUX
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} g_perf_events[TTAK_PERF_EVENTS] = {
+    [TTAK_PERF_CYCLES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    [TTAK_PERF_INSTRUCTIONS] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    [TTAK_PERF_CACHE_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    [TTAK_PERF_BRANCH_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+static int perf_open_event(ttak_perf_event_t e, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = g_perf_events[e].type;
+    attr.config = g_perf_events[e].config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+/**
+ * @brief Opens the group on first use; later calls only test the state.
+ */
+static perf_thread_t *perf_thread(void) {
+    perf_thread_t *t = &t_perf;
+    if (TTAK_LIKELY(t->state != PERF_UNTRIED)) return t;
+    t->state = PERF_REFUSED;
+    t->leader = -1;
+    t->members = 0;
+    for (int e = 0; e < TTAK_PERF_EVENTS; e++) {
+        t->fd[e] = -1;
+        t->slot[e] = -1;
+        t->page[e] = NULL;
+    }
+#ifdef TTAK_PERF_LINUX
+    t->leader = perf_open_event(TTAK_PERF_CYCLES, -1);
+    if (t->leader < 0) return t;
+    t->fd[TTAK_PERF_CYCLES] = t->leader;
+    t->slot[TTAK_PERF_CYCLES] = t->members++;
+    /* A PMU without one of the others still counts the rest. */
+    for (int e = TTAK_PERF_CYCLES + 1; e < TTAK_PERF_EVENTS; e++) {
+        int fd = perf_open_event((ttak_perf_event_t)e, t->leader);
+        if (fd < 0) continue;
+        t->fd[e] = fd;
+        t->slot[e] = t->members++;
+    }
+#ifdef TTAK_PERF_RDPMC
+    long page = sysconf(_SC_PAGESIZE);
+    for (int e = 0; e < TTAK_PERF_EVENTS; e++) {
+        if (t->fd[e] < 0) continue;
+        void *p = mmap(NULL, (size_t)page, PROT_READ, MAP_SHARED, t->fd[e], 0);
+        t->page[e] = p == MAP_FAILED ? NULL : p;
+    }
+#endif
+    t->state = PERF_OPEN;
+    pthread_once(&g_perf_key_once, perf_make_key);
+    pthread_setspecific(g_perf_key, t);
+#endif
+    return t;
+}
+
+#ifdef TTAK_PERF_RDPMC
+/**
+ * @brief Reads one counter in user space with the mmap page's seqlock.
+ *
+ * @return false when rdpmc is not allowed or the event is not on a PMU
+ *         right now; the caller then falls back to read().
+ */
+static _Bool perf_rdpmc(const void *page, uint64_t *out) {
+    const volatile struct perf_event_mmap_page *pc = page;
+    uint32_t seq;
+    uint64_t count;
+    do {
+        seq = pc->lock;
+        __asm__ volatile("" ::: "memory");
+        uint32_t idx = pc->index;
+        if (!pc->cap_user_rdpmc || idx == 0) return 0;
+        uint32_t lo, hi;
+        __asm__ volatile("rdpmc" : "=a"(lo), "=d"(hi) : "c"(idx - 1));
+        int64_t pmc = (int64_t)(((uint64_t)hi << 32) | lo);
+        unsigned shift = 64u - pc->pmc_width;
+        pmc = (int64_t)((uint64_t)pmc << shift) >> shift;
+        count = (uint64_t)pc->offset + (uint64_t)pmc;
+        __asm__ volatile("" ::: "memory");
+    } while (pc->lock != seq);
+    *out = count;
+    return 1;
+}
+#endif
+
+_Bool ttak_perf_available(void) {
+    return perf_thread()->state == PERF_OPEN;
+}
+
+void ttak_perf_thread_close(void) {
+    perf_thread_t *t = &t_perf;
+    if (t->state == PERF_UNTRIED) return;
+    perf_close(t);
+}
+
+uint32_t ttak_perf_open_mask(void) {
+    perf_thread_t *t = perf_thread();
+    uint32_t mask = 0;
+    for (int e = 0; e < TTAK_PERF_EVENTS; e++) {
+        if (t->fd[e] >= 0) mask |= 1u << e;
+    }
+    return mask;
+}
+
+void ttak_perf_read(ttak_perf_sample_t *out) {
+    perf_thread_t *t = perf_thread();
+    memset(out->value, 0, sizeof(out->value));
+#ifdef TTAK_PERF_LINUX
+    if (t->state == PERF_OPEN) {
+        _Bool fast = 1;
+#ifdef TTAK_PERF_RDPMC
+        for (int e = 0; e < TTAK_PERF_EVENTS && fast; e++) {
+            if (t->fd[e] < 0) continue;
+            fast = t->page[e] && perf_rdpmc(t->page[e], &out->value[e]);
+        }
+#else
+        fast = 0;
+#endif
+        if (!fast) {
+            uint64_t buf[1 + TTAK_PERF_EVENTS];
+            ssize_t n = read(t->leader, buf, sizeof(buf));
+            if (n >= (ssize_t)sizeof(uint64_t)) {
+                for (int e = 0; e < TTAK_PERF_EVENTS; e++) {
+                    int s = t->slot[e];
+                    out->value[e] = (s >= 0 && (uint64_t)s < buf[0]) ? buf[1 + s] : 0;
+                }
+            }
+        }
+    }
+#else
+    (void)t;
+#endif
+    out->ns = ttak_get_tick_count_ns();
+}
+
+void ttak_perf_region_init(ttak_perf_region_t *r, const char *name) {
+    r->name = name;
+    ttak_stats_init(&r->ns, 0, 1000000);
+    for (int e = 0; e < TTAK_PERF_EVENTS; e++) ttak_stats_init(&r->event[e], 0, 1000000);
+}
+
+void ttak_perf_region_record(ttak_perf_region_t *r, const ttak_perf_sample_t *begin,
+                             const ttak_perf_sample_t *end) {
+    ttak_stats_record(&r->ns, end->ns - begin->ns);
+    for (int e = 0; e < TTAK_PERF_EVENTS; e++) {
+        /* A counter that went backwards was reopened mid-region. */
+        uint64_t d = end->value[e] >= begin->value[e] ? end->value[e] - begin->value[e] : 0;
+        ttak_stats_record(&r->event[e], d);
+    }
+}
+
+void ttak_perf_region_summary(const ttak_perf_region_t *r, ttak_perf_summary_t *out) {
+    ttak_stats_snapshot_t snap;
+    ttak_stats_totals(&r->ns, &snap);
+    memset(out, 0, sizeof(*out));
+    out->passes = snap.count;
+    if (!snap.count) return;
+    double n = (double)snap.count;
+    out->ns = (double)snap.sum / n;
+    for (int e = 0; e < TTAK_PERF_EVENTS; e++) {
+        ttak_stats_totals(&r->event[e], &snap);
+        out->value[e] = (double)snap.sum / n;
+    }
+    if (out->value[TTAK_PERF_CYCLES] > 0.0) {
+        out->ipc = out->value[TTAK_PERF_INSTRUCTIONS] / out->value[TTAK_PERF_CYCLES];
+    }
+}
+
+void ttak_perf_region_print(const ttak_perf_region_t *r) {
+    ttak_perf_summary_t s;
+    ttak_perf_region_summary(r, &s);
+    printf("%-24s passes=%llu ns=%.1f cycles=%.1f ipc=%.2f cache-miss=%.2f branch-miss=%.2f\n",
+           r->name ? r->name : "(region)", (unsigned long long)s.passes, s.ns,
+           s.value[TTAK_PERF_CYCLES], s.ipc, s.value[TTAK_PERF_CACHE_MISSES],
+           s.value[TTAK_PERF_BRANCH_MISSES]);
+}
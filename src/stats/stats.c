@@ -1,128 +1,155 @@
 #include <ttak/stats/stats.h>
+#include <ttak/types/ttak_compiler.h>
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
 
+static _Atomic uint32_t g_stats_thread_seq;
+_Thread_local uint32_t ttak_stats_thread_cell = UINT32_MAX;
+
+/* Cell of the calling thread, fixed for its lifetime. */
+static inline uint32_t stats_thread_cell(void) {
+    if (TTAK_UNLIKELY(ttak_stats_thread_cell == UINT32_MAX)) {
+        ttak_stats_thread_cell =
+            atomic_fetch_add_explicit(&g_stats_thread_seq, 1, memory_order_relaxed) % TTAK_STATS_SHARDS;
+    }
+    return ttak_stats_thread_cell;
+}
+
+size_t ttak_stats_bucket_of(uint64_t value) {
+    return ttak_stats_bucket_index(value);
+}
+
+uint64_t ttak_stats_bucket_lower(size_t idx) {
+    if (idx < TTAK_STATS_SUB_BUCKETS) return (uint64_t)idx;
+    unsigned e = (unsigned)(idx >> TTAK_STATS_SUB_BITS) + TTAK_STATS_SUB_BITS - 1U;
+    uint64_t sub = (uint64_t)(idx & (TTAK_STATS_SUB_BUCKETS - 1U));
+    return (TTAK_STATS_SUB_BUCKETS | sub) << (e - TTAK_STATS_SUB_BITS);
+}
+
+/* Largest value in bucket @p idx. */
+static uint64_t stats_bucket_upper(size_t idx) {
+    return (idx + 1 < TTAK_STATS_HIST_BUCKETS) ? ttak_stats_bucket_lower(idx + 1) - 1 : UINT64_MAX;
+}
+
 /**
  * @brief Initializes stats with defined histogram range.
  */
 void ttak_stats_init(ttak_stats_t *s, uint64_t hist_min, uint64_t hist_max) {
-    s->count = 0;
-    s->sum = 0;
-    s->min = UINT64_MAX;
-    s->max = 0;
-    memset(s->histogram, 0, sizeof(s->histogram));
+    memset(s, 0, sizeof(*s));
     s->hist_min = hist_min;
     s->hist_max = hist_max;
-    // Calculate bucket size
-    s->hist_step = (hist_max > hist_min) ? (hist_max - hist_min) / TTAK_STATS_HIST_BUCKETS : 1;
-    if (s->hist_step == 0) s->hist_step = 1;
-    ttak_spin_init(&s->lock);
+    for (int i = 0; i < TTAK_STATS_SHARDS; i++) {
+        atomic_store_explicit(&s->cells[i].min, UINT64_MAX, memory_order_relaxed);
+    }
 }
 
 /**
- * @brief Threads-safe recording of a value.
+ * @brief Records a value into the calling thread's cell.
  */
-void ttak_stats_record(ttak_stats_t *s, uint64_t value) {
-    ttak_spin_lock(&s->lock);
-    s->count++;
-    s->sum += value;
-    if (value < s->min) s->min = value;
-    if (value > s->max) s->max = value;
-    
-    // Update histogram bucket
-    if (value >= s->hist_min && value < s->hist_max) {
-        size_t idx = (value - s->hist_min) / s->hist_step;
-        if (idx >= TTAK_STATS_HIST_BUCKETS) idx = TTAK_STATS_HIST_BUCKETS - 1;
-        s->histogram[idx]++;
-    }
-    ttak_spin_unlock(&s->lock);
+void (ttak_stats_record)(ttak_stats_t *s, uint64_t value) {
+    ttak_stats_cell_record(&s->cells[stats_thread_cell()], value);
 }
 
-#include <stdlib.h>
-#include <ttak/math/bigreal.h>
+/**
+ * @brief Merges the scalar counters only.
+ */
+void ttak_stats_totals(const ttak_stats_t *s, ttak_stats_snapshot_t *out) {
+    out->count = 0;
+    out->sum = 0;
+    out->min = UINT64_MAX;
+    out->max = 0;
+    for (int i = 0; i < TTAK_STATS_SHARDS; i++) {
+        const ttak_stats_cell_t *c = &s->cells[i];
+        out->count += atomic_load_explicit(&c->count, memory_order_relaxed);
+        out->sum += atomic_load_explicit(&c->sum, memory_order_relaxed);
+        uint64_t mn = atomic_load_explicit(&c->min, memory_order_relaxed);
+        uint64_t mx = atomic_load_explicit(&c->max, memory_order_relaxed);
+        if (mn < out->min) out->min = mn;
+        if (mx > out->max) out->max = mx;
+    }
+    if (out->count == 0) out->min = 0;
+}
 
-static int compare_u64(const void *a, const void *b) {
-    uint64_t val_a = *(const uint64_t *)a;
-    uint64_t val_b = *(const uint64_t *)b;
-    if (val_a < val_b) return -1;
-    if (val_a > val_b) return 1;
-    return 0;
+/**
+ * @brief Sums every cell's counters and buckets.
+ */
+void ttak_stats_snapshot(const ttak_stats_t *s, ttak_stats_snapshot_t *out) {
+    ttak_stats_totals(s, out);
+    memset(out->histogram, 0, sizeof(out->histogram));
+    for (int i = 0; i < TTAK_STATS_SHARDS; i++) {
+        const ttak_stats_cell_t *c = &s->cells[i];
+        if (!atomic_load_explicit(&c->count, memory_order_relaxed)) continue;
+        for (size_t b = 0; b < TTAK_STATS_HIST_BUCKETS; b++) {
+            out->histogram[b] += atomic_load_explicit(&c->histogram[b], memory_order_relaxed);
+        }
+    }
 }
 
-_Bool ttak_stats_compute_percentiles(uint64_t *data, size_t count, 
-                                   ttak_bigreal_t *p50, ttak_bigreal_t *p95, 
-                                   ttak_bigreal_t *p99, ttak_bigreal_t *p999, 
-                                   uint64_t now) {
-    if (!data || count == 0) return false;
-    
-    // Sort a copy of the data
-    uint64_t *sorted = malloc(count * sizeof(uint64_t));
-    if (!sorted) return false;
-    memcpy(sorted, data, count * sizeof(uint64_t));
-    qsort(sorted, count, sizeof(uint64_t), compare_u64);
-    
-    size_t i50 = (count * 50) / 100;
-    size_t i95 = (count * 95) / 100;
-    size_t i99 = (count * 99) / 100;
-    size_t i999 = (count * 999) / 1000;
-    
-    if (i50 >= count) i50 = count - 1;
-    if (i95 >= count) i95 = count - 1;
-    if (i99 >= count) i99 = count - 1;
-    if (i999 >= count) i999 = count - 1;
-    
-    ttak_bigint_set_u64(&p50->mantissa, sorted[i50], now);
-    p50->exponent = 0;
-    ttak_bigint_set_u64(&p95->mantissa, sorted[i95], now);
-    p95->exponent = 0;
-    ttak_bigint_set_u64(&p99->mantissa, sorted[i99], now);
-    p99->exponent = 0;
-    ttak_bigint_set_u64(&p999->mantissa, sorted[i999], now);
-    p999->exponent = 0;
-    
-    free(sorted);
-    return true;
+/**
+ * @brief Walks the buckets to the one holding rank ceil(q * count).
+ */
+uint64_t ttak_stats_snapshot_percentile(const ttak_stats_snapshot_t *snap, double q) {
+    uint64_t total = 0;
+    for (size_t b = 0; b < TTAK_STATS_HIST_BUCKETS; b++) total += snap->histogram[b];
+    if (total == 0) return 0;
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    uint64_t rank = (uint64_t)ceil(q * (double)total);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t b = 0; b < TTAK_STATS_HIST_BUCKETS; b++) {
+        seen += snap->histogram[b];
+        if (seen >= rank) {
+            uint64_t v = stats_bucket_upper(b);
+            if (v > snap->max) v = snap->max;
+            if (v < snap->min) v = snap->min;
+            return v;
+        }
+    }
+    return snap->max;
 }
 
 /**
  * @brief Calculates mean.
  */
 double ttak_stats_mean(ttak_stats_t *s) {
-    ttak_spin_lock(&s->lock);
-    double mean = (s->count > 0) ? (double)s->sum / s->count : 0.0;
-    ttak_spin_unlock(&s->lock);
-    return mean;
+    ttak_stats_snapshot_t totals;
+    ttak_stats_totals(s, &totals);
+    return (totals.count > 0) ? (double)totals.sum / totals.count : 0.0;
 }
 
 /**
  * @brief Prints ASCII representation of stats.
  */
 void ttak_stats_print_ascii(ttak_stats_t *s) {
-    ttak_spin_lock(&s->lock);
+    ttak_stats_snapshot_t snap;
+    ttak_stats_snapshot(s, &snap);
     printf("Stats: Count=%lu, Min=%lu, Max=%lu, Mean=%.2f\n", 
-           s->count, s->min, s->max, (s->count > 0) ? (double)s->sum / s->count : 0.0);
+           snap.count, snap.min, snap.max, (snap.count > 0) ? (double)snap.sum / snap.count : 0.0);
+    printf("p50=%lu, p99=%lu, p99.9=%lu\n",
+           ttak_stats_snapshot_percentile(&snap, 0.50),
+           ttak_stats_snapshot_percentile(&snap, 0.99),
+           ttak_stats_snapshot_percentile(&snap, 0.999));
     printf("Histogram:\n");
-    
+
+    size_t first = ttak_stats_bucket_of(s->hist_min);
+    size_t last = (s->hist_max > s->hist_min) ? ttak_stats_bucket_of(s->hist_max - 1) : first;
+
     // Find max count for scaling
     uint64_t max_count = 0;
-    for (int i = 0; i < TTAK_STATS_HIST_BUCKETS; i++) {
-        if (s->histogram[i] > max_count) max_count = s->histogram[i];
+    for (size_t i = first; i <= last; i++) {
+        if (snap.histogram[i] > max_count) max_count = snap.histogram[i];
     }
     
-    // Print bars
-    for (int i = 0; i < TTAK_STATS_HIST_BUCKETS; i++) {
-        uint64_t lower = s->hist_min + i * s->hist_step;
-        uint64_t upper = lower + s->hist_step;
-        printf("[%4lu-%4lu] ", lower, upper); 
-        
-        int bars = 0;
-        if (max_count > 0) {
-            bars = (s->histogram[i] * 20) / max_count;
-        }
+    // Print non-empty bars
+    for (size_t i = first; i <= last; i++) {
+        if (!snap.histogram[i]) continue;
+        printf("[%4lu-%4lu] ", ttak_stats_bucket_lower(i), stats_bucket_upper(i));
         
+        int bars = (int)((snap.histogram[i] * 20) / max_count);
         for (int j = 0; j < bars; j++) printf("#");
-        printf(" (%lu)\n", s->histogram[i]);
+        printf(" (%lu)\n", snap.histogram[i]);
     }
-    ttak_spin_unlock(&s->lock);
-}
\ No newline at end of file
+}
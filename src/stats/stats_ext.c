@@ -1,11 +1,19 @@
 #include <ttak/stats/stats_ext.h>
+#include <ttak/async/sched.h>
 #include <ttak/mem/mem.h>
-#include <ttak/thread/pool.h>
+#include <ttak/thread/parallel.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 void ttak_stats_ext_init(ttak_stats_ext_t *s, uint64_t now) {
+    ttak_stats_ext_init_mode(s, TTAK_STATS_EXT_FAST, now);
+}
+
+void ttak_stats_ext_init_mode(ttak_stats_ext_t *s, ttak_stats_ext_mode_t mode, uint64_t now) {
     ttak_stats_init(&s->base, 0, 100);
+    s->mode = mode;
+    memset(&s->welford, 0, sizeof(s->welford));
     s->promoted = false;
     ttak_bigint_init(&s->count_big, now);
     ttak_bigint_init(&s->sum_x_big, now);
@@ -16,12 +24,40 @@ void ttak_stats_ext_init(ttak_stats_ext_t *s, uint64_t now) {
     ttak_spin_init(&s->lock_ext);
 }
 
-void ttak_stats_ext_record(ttak_stats_ext_t *s, uint64_t x, uint64_t y, uint64_t now) {
-    ttak_spin_lock(&s->lock_ext);
-    
+void ttak_stats_ext_destroy(ttak_stats_ext_t *s, uint64_t now) {
+    ttak_bigint_free(&s->count_big, now);
+    ttak_bigint_free(&s->sum_x_big, now);
+    ttak_bigint_free(&s->sum_x_sq_big, now);
+    ttak_bigint_free(&s->sum_y_big, now);
+    ttak_bigint_free(&s->sum_y_sq_big, now);
+    ttak_bigint_free(&s->sum_xy_big, now);
+}
+
+void ttak_stats_welford_merge(ttak_stats_welford_t *dst, const ttak_stats_welford_t *src) {
+    if (!src->n) return;
+    if (!dst->n) {
+        *dst = *src;
+        return;
+    }
+    double na = (double)dst->n, nb = (double)src->n, n = na + nb;
+    double dx = src->mean_x - dst->mean_x;
+    double dy = src->mean_y - dst->mean_y;
+    double w = na * nb / n;
+    dst->m2_x += src->m2_x + dx * dx * w;
+    dst->m2_y += src->m2_y + dy * dy * w;
+    dst->c_xy += src->c_xy + dx * dy * w;
+    dst->mean_x += dx * nb / n;
+    dst->mean_y += dy * nb / n;
+    dst->n += src->n;
+}
+
+/* Exact power sums for TTAK_STATS_EXT_EXACT. Called with lock_ext held. */
+static void stats_ext_record_exact(ttak_stats_ext_t *s, uint64_t x, uint64_t y, uint64_t now) {
     // Check for overflow in base stats (uint64_t)
     if (!s->promoted) {
-        if (s->base.count == UINT64_MAX || (UINT64_MAX - s->base.sum < x)) {
+        ttak_stats_snapshot_t totals;
+        ttak_stats_totals(&s->base, &totals);
+        if (totals.count == UINT64_MAX || (UINT64_MAX - totals.sum < x)) {
             s->promoted = true;
             // Promotion already implicitly handled by always updating bigints below,
             // but we could perform a one-time sync here if we didn't update bigints.
@@ -50,13 +86,75 @@ void ttak_stats_ext_record(ttak_stats_ext_t *s, uint64_t x, uint64_t y, uint64_t
     ttak_bigint_free(&bx, now);
     ttak_bigint_free(&by, now);
     ttak_bigint_free(&bprod, now);
-    
+}
+
+void ttak_stats_ext_record(ttak_stats_ext_t *s, uint64_t x, uint64_t y, uint64_t now) {
+    ttak_spin_lock(&s->lock_ext);
+    ttak_stats_welford_update(&s->welford, (double)x, (double)y);
+    if (s->mode == TTAK_STATS_EXT_EXACT) {
+        stats_ext_record_exact(s, x, y, now);
+    }
+    ttak_spin_unlock(&s->lock_ext);
+
     ttak_stats_record(&s->base, x);
-    
+}
+
+static ttak_stats_welford_t stats_ext_moments(ttak_stats_ext_t *s) {
+    ttak_spin_lock(&s->lock_ext);
+    ttak_stats_welford_t w = s->welford;
     ttak_spin_unlock(&s->lock_ext);
+    return w;
 }
 
-_Bool ttak_stats_ext_variance(ttak_bigreal_t *res, ttak_stats_ext_t *s, uint64_t now) {
+double ttak_stats_ext_mean_f64(ttak_stats_ext_t *s) {
+    return stats_ext_moments(s).mean_x;
+}
+
+_Bool ttak_stats_ext_variance_f64(ttak_stats_ext_t *s, double *out) {
+    ttak_stats_welford_t w = stats_ext_moments(s);
+    if (!w.n) return false;
+    *out = w.m2_x / (double)w.n;
+    return true;
+}
+
+_Bool ttak_stats_ext_stddev_f64(ttak_stats_ext_t *s, double *out) {
+    double var;
+    if (!ttak_stats_ext_variance_f64(s, &var)) return false;
+    *out = sqrt(var);
+    return true;
+}
+
+_Bool ttak_stats_ext_correlation_f64(ttak_stats_ext_t *s, double *out) {
+    ttak_stats_welford_t w = stats_ext_moments(s);
+    if (!(w.m2_x > 0.0) || !(w.m2_y > 0.0)) return false;
+    *out = w.c_xy / sqrt(w.m2_x * w.m2_y);
+    return true;
+}
+
+_Bool ttak_stats_ext_linear_regression_f64(ttak_stats_ext_t *s, double *slope, double *intercept) {
+    ttak_stats_welford_t w = stats_ext_moments(s);
+    if (!(w.m2_x > 0.0)) return false;
+    double b = w.c_xy / w.m2_x;
+    if (slope) *slope = b;
+    if (intercept) *intercept = w.mean_y - b * w.mean_x;
+    return true;
+}
+
+/* Stores @p v as a 16-significant-digit decimal bigreal. */
+static _Bool stats_ext_f64_to_bigreal(ttak_bigreal_t *res, double v, uint64_t now) {
+    if (!isfinite(v)) return false;
+    double a = fabs(v);
+    int64_t e = (a > 0.0) ? (int64_t)floor(log10(a)) - 15 : 0;
+    /* Multiply by the exact power of ten where possible. */
+    double scaled = (e < 0) ? a * pow(10.0, (double)-e) : a / pow(10.0, (double)e);
+    uint64_t m = (uint64_t)llround(scaled);
+    if (!ttak_bigint_set_u64(&res->mantissa, m, now)) return false;
+    res->mantissa.is_negative = (v < 0.0) && m != 0;
+    res->exponent = e;
+    return true;
+}
+
+static _Bool stats_ext_variance_exact(ttak_bigreal_t *res, ttak_stats_ext_t *s, uint64_t now) {
     // Var = (E[X^2] - E[X]^2) = (sum_x_sq / n) - (sum_x / n)^2
     ttak_bigreal_t n, sx, sx2, t1, t2;
     ttak_bigreal_init(&n, now);
@@ -91,27 +189,31 @@ _Bool ttak_stats_ext_variance(ttak_bigreal_t *res, ttak_stats_ext_t *s, uint64_t
     return true;
 }
 
+_Bool ttak_stats_ext_variance(ttak_bigreal_t *res, ttak_stats_ext_t *s, uint64_t now) {
+    if (s->mode == TTAK_STATS_EXT_EXACT) {
+        ttak_spin_lock(&s->lock_ext);
+        _Bool ok = stats_ext_variance_exact(res, s, now);
+        ttak_spin_unlock(&s->lock_ext);
+        return ok;
+    }
+    double var;
+    return ttak_stats_ext_variance_f64(s, &var) && stats_ext_f64_to_bigreal(res, var, now);
+}
+
 _Bool ttak_stats_ext_stddev(ttak_bigreal_t *res, ttak_stats_ext_t *s, uint64_t now) {
-    ttak_bigreal_t var;
-    ttak_bigreal_init(&var, now);
-    ttak_stats_ext_variance(&var, s, now);
-    // res = sqrt(var). Placeholder:
-    ttak_bigreal_copy(res, &var, now);
-    ttak_bigreal_free(&var, now);
-    return true;
+    double sd;
+    return ttak_stats_ext_stddev_f64(s, &sd) && stats_ext_f64_to_bigreal(res, sd, now);
 }
 
 _Bool ttak_stats_ext_correlation(ttak_bigreal_t *res, ttak_stats_ext_t *s, uint64_t now) {
-    (void)res; (void)s; (void)now;
-    // r = (n*sum_xy - sum_x*sum_y) / sqrt((n*sum_x2 - sum_x^2) * (n*sum_y2 - sum_y^2))
-    return false; // Complex for now without sqrt
+    double r;
+    return ttak_stats_ext_correlation_f64(s, &r) && stats_ext_f64_to_bigreal(res, r, now);
 }
 
 _Bool ttak_stats_ext_linear_regression(ttak_bigreal_t *slope, ttak_bigreal_t *intercept, ttak_stats_ext_t *s, uint64_t now) {
-    (void)slope; (void)intercept; (void)s; (void)now;
-    // slope b = (n*sum_xy - sum_x*sum_y) / (n*sum_x2 - sum_x^2)
-    // intercept a = (sum_y - b*sum_x) / n
-    return false;
+    double b, a;
+    if (!ttak_stats_ext_linear_regression_f64(s, &b, &a)) return false;
+    return stats_ext_f64_to_bigreal(slope, b, now) && stats_ext_f64_to_bigreal(intercept, a, now);
 }
 
 _Bool ttak_stats_dist_normal(ttak_bigreal_t *res, const ttak_bigreal_t *x, const ttak_bigreal_t *mu, const ttak_bigreal_t *sigma, uint64_t now) {
@@ -133,42 +235,117 @@ _Bool ttak_stats_dist_binomial(ttak_bigreal_t *res, uint64_t k, uint64_t n, cons
 }
 
 typedef struct {
-    uint64_t *data;
-    size_t count;
+    const uint64_t *data;
     ttak_stats_ext_t *s;
     uint64_t now;
 } stats_parallel_task_t;
 
-static void* stats_parallel_worker(void *arg) {
+static void stats_parallel_body(void *arg, size_t begin, size_t end) {
     stats_parallel_task_t *task = (stats_parallel_task_t *)arg;
-    for (size_t i = 0; i < task->count; i++) {
-        ttak_stats_ext_record(task->s, task->data[i], 0, task->now);
+    ttak_stats_ext_t *s = task->s;
+    if (s->mode == TTAK_STATS_EXT_EXACT) {
+        for (size_t i = begin; i < end; i++) {
+            ttak_stats_ext_record(s, task->data[i], 0, task->now);
+        }
+        return;
     }
-    return NULL;
+
+    ttak_stats_welford_t local = {0};
+    for (size_t i = begin; i < end; i++) {
+        ttak_stats_welford_update(&local, (double)task->data[i], 0.0);
+        ttak_stats_record(&s->base, task->data[i]);
+    }
+    ttak_spin_lock(&s->lock_ext);
+    ttak_stats_welford_merge(&s->welford, &local);
+    ttak_spin_unlock(&s->lock_ext);
 }
 
 _Bool ttak_stats_parallel_process(ttak_stats_ext_t *s, uint64_t *data, size_t count, ttak_scheduler_t *sched, uint64_t now) {
     if (!s || !data || count == 0) return false;
     (void)sched;
     
-    int num_threads = 4;
-    size_t chunk_size = count / num_threads;
-    ttak_future_t *futures[4];
-    stats_parallel_task_t tasks[4];
-    
-    for (int i = 0; i < num_threads; i++) {
-        tasks[i].data = &data[i * chunk_size];
-        tasks[i].count = (i == num_threads - 1) ? (count - i * chunk_size) : chunk_size;
-        tasks[i].s = s;
-        tasks[i].now = now;
-        futures[i] = ttak_thread_pool_submit_task(async_pool, stats_parallel_worker, &tasks[i], __TT_SCHED_NORMAL__, now);
+    stats_parallel_task_t task = { data, s, now };
+    ttak_parallel_for(ttak_async_pool(), 0, count, 0, stats_parallel_body, &task, now);
+    return true;
+}
+
+/** Bins of the radix pass; each bin is 1/4096 of the sample range. */
+#define TTAK_SELECT_BIN_BITS 12
+#define TTAK_SELECT_BINS (1U << TTAK_SELECT_BIN_BITS)
+
+/** Samples below which a pass stays on the calling thread. */
+#define TTAK_SELECT_MIN_CHUNK 65536
+
+/** Most chunks a pass is split into. */
+#define TTAK_SELECT_MAX_CHUNKS 16
+
+typedef struct {
+    const uint64_t *data;
+    size_t begin;
+    size_t end;
+    uint64_t min;
+    uint64_t max;
+    uint64_t base;                      /* Shared: smallest sample. */
+    unsigned shift;                     /* Shared: bin = (v - base) >> shift. */
+    const int32_t *slot_of_bin;         /* Shared: candidate slot per bin, or -1. */
+    uint64_t *cand;                     /* Shared: candidate buffer. */
+    size_t *cursor;                     /* Write position per slot for this chunk. */
+    size_t hist[TTAK_SELECT_BINS];
+} select_chunk_t;
+
+static void *select_minmax_task(void *arg) {
+    select_chunk_t *c = (select_chunk_t *)arg;
+    uint64_t mn = UINT64_MAX, mx = 0;
+    for (size_t i = c->begin; i < c->end; i++) {
+        uint64_t v = c->data[i];
+        if (v < mn) mn = v;
+        if (v > mx) mx = v;
     }
-    
-    for (int i = 0; i < num_threads; i++) {
-        if (futures[i]) ttak_future_get(futures[i]);
+    c->min = mn;
+    c->max = mx;
+    return NULL;
+}
+
+static void *select_hist_task(void *arg) {
+    select_chunk_t *c = (select_chunk_t *)arg;
+    memset(c->hist, 0, sizeof(c->hist));
+    for (size_t i = c->begin; i < c->end; i++) {
+        c->hist[(c->data[i] - c->base) >> c->shift]++;
     }
-    
-    return true;
+    return NULL;
+}
+
+static void *select_scatter_task(void *arg) {
+    select_chunk_t *c = (select_chunk_t *)arg;
+    for (size_t i = c->begin; i < c->end; i++) {
+        uint64_t v = c->data[i];
+        int32_t slot = c->slot_of_bin[(v - c->base) >> c->shift];
+        if (slot >= 0) c->cand[c->cursor[slot]++] = v;
+    }
+    return NULL;
+}
+
+typedef struct {
+    void *(*fn)(void *);
+    select_chunk_t *chunks;
+} select_loop_t;
+
+static void select_loop_body(void *arg, size_t begin, size_t end) {
+    select_loop_t *loop = (select_loop_t *)arg;
+    for (size_t i = begin; i < end; i++) loop->fn(&loop->chunks[i]);
+}
+
+/* Runs @p fn over every chunk, one chunk per claim, on the caller and @p pool. */
+static void select_run(ttak_thread_pool_t *pool, void *(*fn)(void *), select_chunk_t *chunks,
+                       size_t n, uint64_t now) {
+    select_loop_t loop = { fn, chunks };
+    ttak_parallel_for(pool, 0, n, 1, select_loop_body, &loop, now);
+}
+
+static void select_swap(uint64_t *a, uint64_t *b) {
+    uint64_t t = *a;
+    *a = *b;
+    *b = t;
 }
 
 static int compare_u64(const void *a, const void *b) {
@@ -179,40 +356,168 @@ static int compare_u64(const void *a, const void *b) {
     return 0;
 }
 
-_Bool ttak_stats_compute_percentiles(uint64_t *data, size_t count,
-                                     ttak_bigreal_t *p50, ttak_bigreal_t *p95,
-                                     ttak_bigreal_t *p99, ttak_bigreal_t *p999,
-                                     uint64_t now) {
-    if (!data || count == 0) return false;
+/*
+ * Introselect for several sorted ranks at once over a[lo, hi): a three-way
+ * partition around a median-of-three pivot, recursing only into the sides
+ * that hold a wanted rank, falling back to a sort once @p depth runs out.
+ */
+static void select_multi(uint64_t *a, size_t lo, size_t hi, const size_t *ranks, size_t nr, int depth) {
+    while (nr > 0 && hi - lo > 16) {
+        if (depth-- <= 0) break;
+        uint64_t x = a[lo], y = a[lo + (hi - lo) / 2], z = a[hi - 1];
+        uint64_t pivot = (x < y) ? ((y < z) ? y : (x < z ? z : x)) : ((x < z) ? x : (y < z ? z : y));
+        size_t lt = lo, i = lo, gt = hi;
+        while (i < gt) {
+            if (a[i] < pivot) select_swap(&a[lt++], &a[i++]);
+            else if (a[i] > pivot) select_swap(&a[i], &a[--gt]);
+            else i++;
+        }
+        /* Ranks in [lt, gt) already hold the pivot. */
+        size_t l = 0;
+        while (l < nr && ranks[l] < lt) l++;
+        size_t g = l;
+        while (g < nr && ranks[g] < gt) g++;
+        if (l) select_multi(a, lo, lt, ranks, l, depth);
+        ranks += g;
+        nr -= g;
+        lo = gt;
+    }
+    if (nr > 0) qsort(a + lo, hi - lo, sizeof(*a), compare_u64);
+}
+
+typedef struct {
+    size_t rank;
+    size_t out;
+} select_want_t;
 
-    // Sort the data to find percentiles
-    qsort(data, count, sizeof(uint64_t), compare_u64);
+static int compare_want(const void *a, const void *b) {
+    const select_want_t *x = (const select_want_t *)a, *y = (const select_want_t *)b;
+    return (x->rank > y->rank) - (x->rank < y->rank);
+}
+
+_Bool ttak_stats_select_quantiles(const uint64_t *data, size_t count, const double *qs, size_t nq,
+                                  uint64_t *out, ttak_thread_pool_t *pool, uint64_t now) {
+    if (!data || count == 0 || !qs || !out || nq == 0) return false;
 
-    size_t idx;
+    size_t nchunks = count / TTAK_SELECT_MIN_CHUNK;
+    if (nchunks < 1) nchunks = 1;
+    if (nchunks > TTAK_SELECT_MAX_CHUNKS) nchunks = TTAK_SELECT_MAX_CHUNKS;
+    if (!pool) nchunks = 1;
 
-    if (p50) {
-        idx = (size_t)(0.50 * (double)count);
-        if (idx >= count) idx = count - 1;
-        ttak_bigreal_init_u64(p50, data[idx], now);
+    select_chunk_t *chunks = calloc(nchunks, sizeof(*chunks));
+    select_want_t *wants = malloc(nq * sizeof(*wants));
+    int32_t *slot_of_bin = malloc(TTAK_SELECT_BINS * sizeof(*slot_of_bin));
+    size_t *cursors = calloc(nchunks * nq, sizeof(*cursors));
+    size_t *slot_bin = malloc(nq * sizeof(*slot_bin));
+    size_t *slot_base = malloc((nq + 1) * sizeof(*slot_base));
+    size_t *local_ranks = malloc(nq * sizeof(*local_ranks));
+    uint64_t *cand = NULL;
+    _Bool ok = false;
+    if (!chunks || !wants || !slot_of_bin || !cursors || !slot_bin || !slot_base || !local_ranks) goto out;
+
+    for (size_t i = 0; i < nq; i++) {
+        double q = qs[i] < 0.0 ? 0.0 : (qs[i] > 1.0 ? 1.0 : qs[i]);
+        size_t r = (size_t)(q * (double)count);
+        wants[i].rank = r >= count ? count - 1 : r;
+        wants[i].out = i;
     }
+    qsort(wants, nq, sizeof(*wants), compare_want);
 
-    if (p95) {
-        idx = (size_t)(0.95 * (double)count);
-        if (idx >= count) idx = count - 1;
-        ttak_bigreal_init_u64(p95, data[idx], now);
+    size_t step = count / nchunks;
+    for (size_t c = 0; c < nchunks; c++) {
+        chunks[c].data = data;
+        chunks[c].begin = c * step;
+        chunks[c].end = (c + 1 == nchunks) ? count : (c + 1) * step;
     }
 
-    if (p99) {
-        idx = (size_t)(0.99 * (double)count);
-        if (idx >= count) idx = count - 1;
-        ttak_bigreal_init_u64(p99, data[idx], now);
+    /* Pass 1: the range, so the bins spread over the samples actually present. */
+    select_run(pool, select_minmax_task, chunks, nchunks, now);
+    uint64_t mn = UINT64_MAX, mx = 0;
+    for (size_t c = 0; c < nchunks; c++) {
+        if (chunks[c].min < mn) mn = chunks[c].min;
+        if (chunks[c].max > mx) mx = chunks[c].max;
     }
+    uint64_t range = mx - mn;
+    unsigned bits = range ? 64U - (unsigned)__builtin_clzll(range) : 0U;
+    unsigned shift = bits > TTAK_SELECT_BIN_BITS ? bits - TTAK_SELECT_BIN_BITS : 0U;
 
-    if (p999) {
-        idx = (size_t)(0.999 * (double)count);
-        if (idx >= count) idx = count - 1;
-        ttak_bigreal_init_u64(p999, data[idx], now);
+    /* Pass 2: per-chunk histograms locate every wanted rank's bin. */
+    for (size_t c = 0; c < nchunks; c++) {
+        chunks[c].base = mn;
+        chunks[c].shift = shift;
+    }
+    select_run(pool, select_hist_task, chunks, nchunks, now);
+
+    for (size_t b = 0; b < TTAK_SELECT_BINS; b++) slot_of_bin[b] = -1;
+    size_t nslots = 0, seen = 0, bin = 0, bin_total = 0;
+    slot_base[0] = 0;
+    for (size_t i = 0; i < nq; i++) {
+        while (1) {
+            bin_total = 0;
+            for (size_t c = 0; c < nchunks; c++) bin_total += chunks[c].hist[bin];
+            if (wants[i].rank < seen + bin_total) break;
+            seen += bin_total;
+            bin++;
+        }
+        if (nslots == 0 || slot_bin[nslots - 1] != bin) {
+            slot_of_bin[bin] = (int32_t)nslots;
+            slot_bin[nslots] = bin;
+            slot_base[nslots + 1] = slot_base[nslots] + bin_total;
+            nslots++;
+        }
+        /* Rank within the candidate buffer, whose slots follow bin order. */
+        local_ranks[i] = slot_base[nslots - 1] + (wants[i].rank - seen);
     }
 
+    /* Pass 3: copy each wanted bin's samples out, chunk by chunk in order. */
+    cand = malloc(slot_base[nslots] * sizeof(*cand));
+    if (!cand) goto out;
+    for (size_t s = 0; s < nslots; s++) {
+        size_t pos = slot_base[s];
+        for (size_t c = 0; c < nchunks; c++) {
+            cursors[c * nq + s] = pos;
+            pos += chunks[c].hist[slot_bin[s]];
+        }
+    }
+    for (size_t c = 0; c < nchunks; c++) {
+        chunks[c].slot_of_bin = slot_of_bin;
+        chunks[c].cand = cand;
+        chunks[c].cursor = &cursors[c * nq];
+    }
+    select_run(pool, select_scatter_task, chunks, nchunks, now);
+
+    /* Finish inside each bin; slots follow bin order, so the ranks stay sorted. */
+    for (size_t s = 0, i = 0; s < nslots; s++) {
+        size_t first = i;
+        while (i < nq && local_ranks[i] < slot_base[s + 1]) i++;
+        select_multi(cand, slot_base[s], slot_base[s + 1], &local_ranks[first], i - first, 64);
+        for (size_t k = first; k < i; k++) out[wants[k].out] = cand[local_ranks[k]];
+    }
+    ok = true;
+
+out:
+    free(cand);
+    free(local_ranks);
+    free(slot_base);
+    free(slot_bin);
+    free(cursors);
+    free(slot_of_bin);
+    free(wants);
+    free(chunks);
+    return ok;
+}
+
+_Bool ttak_stats_compute_percentiles(uint64_t *data, size_t count,
+                                     ttak_bigreal_t *p50, ttak_bigreal_t *p95,
+                                     ttak_bigreal_t *p99, ttak_bigreal_t *p999,
+                                     uint64_t now) {
+    static const double qs[4] = { 0.50, 0.95, 0.99, 0.999 };
+    uint64_t vals[4];
+    if (!ttak_stats_select_quantiles(data, count, qs, 4, vals, ttak_async_pool(), now)) return false;
+
+    if (p50) ttak_bigreal_init_u64(p50, vals[0], now);
+    if (p95) ttak_bigreal_init_u64(p95, vals[1], now);
+    if (p99) ttak_bigreal_init_u64(p99, vals[2], now);
+    if (p999) ttak_bigreal_init_u64(p999, vals[3], now);
     return true;
 }
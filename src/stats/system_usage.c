@@ -1,12 +1,17 @@
 #include <ttak/stats/system_usage.h>
+#include <ttak/mem_tree/mem_tree.h>
+#include <ttak/timing/timing.h>
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #ifndef _WIN32
 #include <unistd.h>
 #include <dirent.h>
+#include <fcntl.h>
 #endif
 
 typedef struct {
@@ -93,7 +98,11 @@ static double ttak_cpu_usage_delta(ttak_cpu_snapshot_t prev, ttak_cpu_snapshot_t
     return (double)(totald - idled) * 100.0 / (double)totald;
 }
 
+static bool sampler_latest_cpu(int core, double *out);
+
 double ttak_get_cpu_usage_total(void) {
+    double cached;
+    if (sampler_latest_cpu(-1, &cached)) return cached;
     ttak_cpu_snapshot_t now_total = {0};
     ttak_cpu_snapshot_t *now_cores = NULL;
     size_t now_core_count = 0;
@@ -114,6 +123,8 @@ double ttak_get_cpu_usage_total(void) {
 
 double ttak_get_cpu_usage_per_core(int core) {
     if (core < 0) return -1.0;
+    double cached;
+    if (sampler_latest_cpu(core, &cached)) return cached;
 
     ttak_cpu_snapshot_t now_total = {0};
     ttak_cpu_snapshot_t *now_cores = NULL;
@@ -171,10 +182,14 @@ double ttak_get_gpu_usage_per_cu(int cu) {
     return -1.0;
 }
 
+static bool sampler_latest_rss(size_t *out);
+
 size_t ttak_get_rss_footprint(void) {
 #ifdef _WIN32
     return 0;
 #else
+    size_t cached;
+    if (sampler_latest_rss(&cached)) return cached;
     FILE *f = fopen("/proc/self/statm", "r");
     if (!f) return 0;
     unsigned long size_pages = 0;
@@ -214,3 +229,444 @@ char *ttak_get_rss_footprint_full(void) {
              rss_bytes, vmrss_kb, vmsize_kb);
     return json;
 }
+
+/* --- Background sampler --- */
+
+/** Bytes of /proc/stat read per sample; the per-CPU lines come first. */
+#define TTAK_SYS_STAT_BUF (64U * 1024U)
+/** Bytes read from every other file. */
+#define TTAK_SYS_SMALL_BUF 512U
+
+typedef struct {
+    unsigned long long idle;
+    unsigned long long total;
+} sampler_ticks_t;
+
+enum {
+    SAMPLER_FD_STAT = 0,
+    SAMPLER_FD_STATM,
+    SAMPLER_FD_PSI_CPU,
+    SAMPLER_FD_PSI_MEM,
+    SAMPLER_FD_PSI_IO,
+    SAMPLER_FD_MEM_CURRENT,
+    SAMPLER_FD_MEM_MAX,
+    SAMPLER_FD_MEM_HIGH,
+    SAMPLER_FD_COUNT
+};
+
+/**
+ * @brief Sampler state. The writer side is serialised by @c write_lock;
+ *        readers only touch @c seq, @c snap and the pressure mirrors.
+ */
+typedef struct {
+    pthread_mutex_t write_lock;
+    bool fds_open;
+    int fd[SAMPLER_FD_COUNT];
+    char *stat_buf;
+    sampler_ticks_t prev_total;
+    sampler_ticks_t prev_core[TTAK_SYS_MAX_CPUS];
+    bool have_prev;
+    long page_size;
+
+    _Atomic uint64_t seq;               /**< Odd while a snapshot is being written. */
+    ttak_sys_snapshot_t snap;
+    _Atomic int32_t cpu_psi_centi;      /**< psi_cpu.some_avg10 x 100, or -1. */
+    _Atomic int32_t mem_psi_centi;
+
+    pthread_mutex_t ctl_lock;           /**< Guards the thread fields below. */
+    pthread_cond_t ctl_cond;
+    pthread_t thread;
+    _Atomic bool running;               /**< Written under @c ctl_lock, read anywhere. */
+    bool stop;
+    uint64_t period_ns;
+
+    ttak_mem_tree_t *_Atomic tree;
+    _Atomic uint32_t tree_threshold_centi;
+
+    pthread_mutex_t hook_lock;          /**< Held across hook calls so replacing one waits them out. */
+    ttak_sys_sample_fn hook;
+    void *hook_arg;
+} sampler_t;
+
+static sampler_t g_sampler = {
+    .write_lock = PTHREAD_MUTEX_INITIALIZER,
+    .ctl_lock = PTHREAD_MUTEX_INITIALIZER,
+    .ctl_cond = PTHREAD_COND_INITIALIZER,
+    .hook_lock = PTHREAD_MUTEX_INITIALIZER,
+    .cpu_psi_centi = -1,
+    .mem_psi_centi = -1,
+};
+
+/* Integer scanner: skips to the next digit run and parses it. */
+static const char *scan_u64(const char *p, const char *end, unsigned long long *out) {
+    while (p < end && (*p < '0' || *p > '9')) {
+        if (*p == '\n') return NULL;
+        p++;
+    }
+    if (p >= end) return NULL;
+    unsigned long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = v * 10U + (unsigned long long)(*p++ - '0');
+    *out = v;
+    return p;
+}
+
+/* "12.34" after @p key, in hundredths. */
+static bool scan_centi(const char *line, const char *end, const char *key, unsigned long long *out) {
+    size_t klen = strlen(key);
+    for (const char *p = line; p + klen <= end; p++) {
+        if (memcmp(p, key, klen) != 0) continue;
+        p += klen;
+        unsigned long long whole = 0, frac = 0;
+        while (p < end && *p >= '0' && *p <= '9') whole = whole * 10U + (unsigned long long)(*p++ - '0');
+        if (p < end && *p == '.') {
+            p++;
+            int digits = 0;
+            while (p < end && *p >= '0' && *p <= '9') {
+                if (digits < 2) frac = frac * 10U + (unsigned long long)(*p - '0');
+                digits++;
+                p++;
+            }
+            if (digits == 1) frac *= 10U;
+        }
+        *out = whole * 100U + frac;
+        return true;
+    }
+    return false;
+}
+
+#ifndef _WIN32
+
+static ssize_t sampler_pread(int fd, char *buf, size_t cap) {
+    if (fd < 0) return -1;
+    ssize_t n = pread(fd, buf, cap - 1, 0);
+    if (n >= 0) buf[n] = '\0';
+    return n;
+}
+
+static int sampler_open_in(const char *dir, const char *name) {
+    char path[768];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+/* Cgroup directories of this process: the v2 (unified) one and the v1 memory one. */
+static void sampler_cgroup_dirs(char *v2, size_t v2_len, char *v1mem, size_t v1_len) {
+    v2[0] = v1mem[0] = '\0';
+    FILE *f = fopen("/proc/self/cgroup", "r");
+    if (!f) return;
+    const char *v2_root = access("/sys/fs/cgroup/cgroup.controllers", F_OK) == 0 ? "/sys/fs/cgroup"
+                                                                                   : "/sys/fs/cgroup/unified";
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\n")] = '\0';
+        if (strncmp(line, "0::", 3) == 0) {
+            snprintf(v2, v2_len, "%s%s", v2_root, line + 3);
+        } else {
+            char *ctl = strchr(line, ':');
+            char *path = ctl ? strchr(ctl + 1, ':') : NULL;
+            if (!path) continue;
+            *path++ = '\0';
+            for (char *tok = strtok(ctl + 1, ","); tok; tok = strtok(NULL, ",")) {
+                if (strcmp(tok, "memory") == 0) snprintf(v1mem, v1_len, "/sys/fs/cgroup/memory%s", path);
+            }
+        }
+    }
+    fclose(f);
+}
+
+static void sampler_open_fds(sampler_t *st) {
+    for (int i = 0; i < SAMPLER_FD_COUNT; i++) st->fd[i] = -1;
+    st->fd[SAMPLER_FD_STAT] = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    st->fd[SAMPLER_FD_STATM] = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+
+    char v2[640], v1mem[640];
+    sampler_cgroup_dirs(v2, sizeof(v2), v1mem, sizeof(v1mem));
+    if (v2[0]) {
+        st->fd[SAMPLER_FD_PSI_CPU] = sampler_open_in(v2, "cpu.pressure");
+        st->fd[SAMPLER_FD_PSI_MEM] = sampler_open_in(v2, "memory.pressure");
+        st->fd[SAMPLER_FD_PSI_IO] = sampler_open_in(v2, "io.pressure");
+        st->fd[SAMPLER_FD_MEM_CURRENT] = sampler_open_in(v2, "memory.current");
+        st->fd[SAMPLER_FD_MEM_MAX] = sampler_open_in(v2, "memory.max");
+        st->fd[SAMPLER_FD_MEM_HIGH] = sampler_open_in(v2, "memory.high");
+    }
+    /* The root cgroup has no pressure files of its own; the system-wide ones stand in. */
+    if (st->fd[SAMPLER_FD_PSI_CPU] < 0) st->fd[SAMPLER_FD_PSI_CPU] = open("/proc/pressure/cpu", O_RDONLY | O_CLOEXEC);
+    if (st->fd[SAMPLER_FD_PSI_MEM] < 0) st->fd[SAMPLER_FD_PSI_MEM] = open("/proc/pressure/memory", O_RDONLY | O_CLOEXEC);
+    if (st->fd[SAMPLER_FD_PSI_IO] < 0) st->fd[SAMPLER_FD_PSI_IO] = open("/proc/pressure/io", O_RDONLY | O_CLOEXEC);
+    if (st->fd[SAMPLER_FD_MEM_CURRENT] < 0 && v1mem[0]) {
+        st->fd[SAMPLER_FD_MEM_CURRENT] = sampler_open_in(v1mem, "memory.usage_in_bytes");
+        st->fd[SAMPLER_FD_MEM_MAX] = sampler_open_in(v1mem, "memory.limit_in_bytes");
+        st->fd[SAMPLER_FD_MEM_HIGH] = sampler_open_in(v1mem, "memory.soft_limit_in_bytes");
+    }
+    st->page_size = sysconf(_SC_PAGESIZE);
+    st->fds_open = true;
+}
+
+static float sampler_busy(sampler_ticks_t prev, sampler_ticks_t now) {
+    unsigned long long totald = now.total - prev.total;
+    unsigned long long idled = now.idle - prev.idle;
+    if (totald == 0 || idled > totald) return 0.0f;
+    return (float)((double)(totald - idled) * 100.0 / (double)totald);
+}
+
+static void sampler_parse_stat(sampler_t *st, ttak_sys_snapshot_t *snap) {
+    ssize_t n = sampler_pread(st->fd[SAMPLER_FD_STAT], st->stat_buf, TTAK_SYS_STAT_BUF);
+    if (n <= 0) return;
+    const char *p = st->stat_buf, *end = st->stat_buf + n;
+    uint32_t ncpu = 0;
+    while (p < end && p[0] == 'c' && p + 3 <= end && memcmp(p, "cpu", 3) == 0) {
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) break;  /* Truncated line. */
+        bool is_total = p[3] == ' ';
+        const char *q = p + 3;
+        if (!is_total) {
+            unsigned long long idx;
+            q = scan_u64(q, eol, &idx);
+            if (!q) break;
+        }
+        unsigned long long f[10] = {0};
+        for (int i = 0; i < 10 && q; i++) q = scan_u64(q, eol, &f[i]);
+        sampler_ticks_t t;
+        t.idle = f[3] + f[4];
+        t.total = 0;
+        for (int i = 0; i < 8; i++) t.total += f[i];  /* guest time is already in user. */
+        if (is_total) {
+            snap->cpu_total = st->have_prev ? (double)sampler_busy(st->prev_total, t) : 0.0;
+            st->prev_total = t;
+        } else if (ncpu < TTAK_SYS_MAX_CPUS) {
+            snap->cpu_core[ncpu] = st->have_prev ? sampler_busy(st->prev_core[ncpu], t) : 0.0f;
+            st->prev_core[ncpu] = t;
+            ncpu++;
+        }
+        p = eol + 1;
+    }
+    snap->ncpu = ncpu;
+}
+
+static void sampler_parse_statm(sampler_t *st, ttak_sys_snapshot_t *snap) {
+    char buf[TTAK_SYS_SMALL_BUF];
+    ssize_t n = sampler_pread(st->fd[SAMPLER_FD_STATM], buf, sizeof(buf));
+    if (n <= 0 || st->page_size <= 0) return;
+    unsigned long long size = 0, resident = 0;
+    const char *q = scan_u64(buf, buf + n, &size);
+    if (q) q = scan_u64(q, buf + n, &resident);
+    if (!q) return;
+    snap->vm_bytes = (size_t)size * (size_t)st->page_size;
+    snap->rss_bytes = (size_t)resident * (size_t)st->page_size;
+}
+
+static bool sampler_parse_psi(int fd, ttak_sys_psi_t *out) {
+    char buf[TTAK_SYS_SMALL_BUF];
+    ssize_t n = sampler_pread(fd, buf, sizeof(buf));
+    if (n <= 0) return false;
+    const char *end = buf + n;
+    const char *full = strstr(buf, "full ");
+    const char *some_end = full ? full : end;
+    unsigned long long v;
+    if (!scan_centi(buf, some_end, "avg10=", &v)) return false;
+    out->some_avg10 = (double)v / 100.0;
+    if (scan_centi(buf, some_end, "avg60=", &v)) out->some_avg60 = (double)v / 100.0;
+    const char *tot = strstr(buf, "total=");
+    if (tot && tot < some_end && scan_u64(tot, some_end, &v)) out->some_total_us = v;
+    if (full && scan_centi(full, end, "avg10=", &v)) out->full_avg10 = (double)v / 100.0;
+    return true;
+}
+
+/* A limit file: a byte count, or "max" (v2) / a huge page-rounded value (v1) for none. */
+static bool sampler_parse_limit(int fd, uint64_t *out) {
+    char buf[64];
+    ssize_t n = sampler_pread(fd, buf, sizeof(buf));
+    if (n <= 0) return false;
+    if (strncmp(buf, "max", 3) == 0) {
+        *out = UINT64_MAX;
+        return true;
+    }
+    unsigned long long v;
+    if (!scan_u64(buf, buf + n, &v)) return false;
+    *out = v >= (1ULL << 62) ? UINT64_MAX : (uint64_t)v;
+    return true;
+}
+
+static void sampler_collect(sampler_t *st, ttak_sys_snapshot_t *snap) {
+    if (!st->fds_open) {
+        st->stat_buf = malloc(TTAK_SYS_STAT_BUF);
+        sampler_open_fds(st);
+    }
+    if (st->stat_buf) sampler_parse_stat(st, snap);
+    sampler_parse_statm(st, snap);
+
+    uint64_t current = 0;
+    snap->has_cgroup_mem = sampler_parse_limit(st->fd[SAMPLER_FD_MEM_CURRENT], &current);
+    snap->cgroup_mem_current = current;
+    snap->cgroup_mem_max = UINT64_MAX;
+    snap->cgroup_mem_high = UINT64_MAX;
+    if (snap->has_cgroup_mem) {
+        sampler_parse_limit(st->fd[SAMPLER_FD_MEM_MAX], &snap->cgroup_mem_max);
+        sampler_parse_limit(st->fd[SAMPLER_FD_MEM_HIGH], &snap->cgroup_mem_high);
+    }
+
+    snap->has_psi = sampler_parse_psi(st->fd[SAMPLER_FD_PSI_CPU], &snap->psi_cpu);
+    snap->has_psi |= sampler_parse_psi(st->fd[SAMPLER_FD_PSI_MEM], &snap->psi_mem);
+    snap->has_psi |= sampler_parse_psi(st->fd[SAMPLER_FD_PSI_IO], &snap->psi_io);
+}
+
+#else
+
+static void sampler_collect(sampler_t *st, ttak_sys_snapshot_t *snap) {
+    (void)st;
+    snap->cpu_total = -1.0;
+    snap->cgroup_mem_max = UINT64_MAX;
+    snap->cgroup_mem_high = UINT64_MAX;
+}
+
+#endif
+
+void ttak_sys_sampler_sample_now(void) {
+    sampler_t *st = &g_sampler;
+    pthread_mutex_lock(&st->write_lock);
+    ttak_sys_snapshot_t next;
+    memset(&next, 0, sizeof(next));
+    sampler_collect(st, &next);
+    st->have_prev = true;
+    next.ts_ns = ttak_get_tick_count_ns();
+
+    /* Seqlock publish: odd while the copy is in flight. */
+    uint64_t seq = atomic_load_explicit(&st->seq, memory_order_relaxed);
+    next.seq = seq / 2 + 1;
+    atomic_store_explicit(&st->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&st->snap, &next, sizeof(next));
+    atomic_store_explicit(&st->seq, seq + 2, memory_order_release);
+
+    atomic_store_explicit(&st->cpu_psi_centi, next.has_psi ? (int32_t)(next.psi_cpu.some_avg10 * 100.0) : -1,
+                          memory_order_relaxed);
+    atomic_store_explicit(&st->mem_psi_centi, next.has_psi ? (int32_t)(next.psi_mem.some_avg10 * 100.0) : -1,
+                          memory_order_relaxed);
+    pthread_mutex_unlock(&st->write_lock);
+
+    ttak_mem_tree_t *tree = atomic_load_explicit(&st->tree, memory_order_acquire);
+    if (tree && next.has_psi &&
+        next.psi_mem.some_avg10 * 100.0 >= (double)atomic_load_explicit(&st->tree_threshold_centi, memory_order_relaxed)) {
+        ttak_mem_tree_report_pressure(tree, atomic_load(&tree->pressure_threshold));
+    }
+
+    pthread_mutex_lock(&st->hook_lock);
+    if (st->hook) st->hook(&next, st->hook_arg);
+    pthread_mutex_unlock(&st->hook_lock);
+}
+
+bool ttak_sys_sampler_read(ttak_sys_snapshot_t *out) {
+    sampler_t *st = &g_sampler;
+    for (;;) {
+        uint64_t s1 = atomic_load_explicit(&st->seq, memory_order_acquire);
+        if (s1 == 0) return false;
+        if (s1 & 1U) continue;
+        memcpy(out, &st->snap, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&st->seq, memory_order_relaxed) == s1) return true;
+    }
+}
+
+double ttak_sys_cpu_pressure(void) {
+    int32_t v = atomic_load_explicit(&g_sampler.cpu_psi_centi, memory_order_relaxed);
+    return v < 0 ? -1.0 : (double)v / 100.0;
+}
+
+double ttak_sys_mem_pressure(void) {
+    int32_t v = atomic_load_explicit(&g_sampler.mem_psi_centi, memory_order_relaxed);
+    return v < 0 ? -1.0 : (double)v / 100.0;
+}
+
+void ttak_sys_sampler_attach_mem_tree(ttak_mem_tree_t *tree, double threshold_pct) {
+    if (threshold_pct < 0.0) threshold_pct = 0.0;
+    atomic_store_explicit(&g_sampler.tree_threshold_centi, (uint32_t)(threshold_pct * 100.0), memory_order_relaxed);
+    atomic_store_explicit(&g_sampler.tree, tree, memory_order_release);
+}
+
+void ttak_sys_sampler_set_hook(ttak_sys_sample_fn fn, void *arg) {
+    pthread_mutex_lock(&g_sampler.hook_lock);
+    g_sampler.hook = fn;
+    g_sampler.hook_arg = arg;
+    pthread_mutex_unlock(&g_sampler.hook_lock);
+}
+
+static bool sampler_latest_cpu(int core, double *out) {
+    if (!ttak_sys_sampler_running()) return false;
+    ttak_sys_snapshot_t snap;
+    if (!ttak_sys_sampler_read(&snap)) return false;
+    if (core < 0) {
+        *out = snap.cpu_total;
+    } else {
+        *out = (uint32_t)core < snap.ncpu ? (double)snap.cpu_core[core] : -1.0;
+    }
+    return true;
+}
+
+static bool sampler_latest_rss(size_t *out) {
+    if (!ttak_sys_sampler_running()) return false;
+    ttak_sys_snapshot_t snap;
+    if (!ttak_sys_sampler_read(&snap) || snap.rss_bytes == 0) return false;
+    *out = snap.rss_bytes;
+    return true;
+}
+
+static void *sampler_main(void *arg) {
+    sampler_t *st = arg;
+    pthread_mutex_lock(&st->ctl_lock);
+    while (!st->stop) {
+        pthread_mutex_unlock(&st->ctl_lock);
+        ttak_sys_sampler_sample_now();
+        pthread_mutex_lock(&st->ctl_lock);
+        if (st->stop) break;
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        uint64_t wake = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec + st->period_ns;
+        ts.tv_sec = (time_t)(wake / 1000000000ULL);
+        ts.tv_nsec = (long)(wake % 1000000000ULL);
+        pthread_cond_timedwait(&st->ctl_cond, &st->ctl_lock, &ts);
+    }
+    pthread_mutex_unlock(&st->ctl_lock);
+    return NULL;
+}
+
+int ttak_sys_sampler_start(uint32_t hz) {
+    sampler_t *st = &g_sampler;
+    if (hz == 0) hz = 1;
+    if (hz > 1000) hz = 1000;
+    pthread_mutex_lock(&st->ctl_lock);
+    st->period_ns = 1000000000ULL / hz;
+    int rc = 0;
+    if (!atomic_load_explicit(&st->running, memory_order_relaxed)) {
+        st->stop = false;
+        if (pthread_create(&st->thread, NULL, sampler_main, st) == 0) {
+            atomic_store_explicit(&st->running, true, memory_order_release);
+        } else {
+            rc = -1;
+        }
+    } else {
+        pthread_cond_signal(&st->ctl_cond);
+    }
+    pthread_mutex_unlock(&st->ctl_lock);
+    return rc;
+}
+
+void ttak_sys_sampler_stop(void) {
+    sampler_t *st = &g_sampler;
+    pthread_mutex_lock(&st->ctl_lock);
+    if (!atomic_load_explicit(&st->running, memory_order_relaxed)) {
+        pthread_mutex_unlock(&st->ctl_lock);
+        return;
+    }
+    st->stop = true;
+    pthread_cond_signal(&st->ctl_cond);
+    pthread_t thread = st->thread;
+    pthread_mutex_unlock(&st->ctl_lock);
+    pthread_join(thread, NULL);
+    pthread_mutex_lock(&st->ctl_lock);
+    atomic_store_explicit(&st->running, false, memory_order_release);
+    pthread_mutex_unlock(&st->ctl_lock);
+}
+
+bool ttak_sys_sampler_running(void) {
+    return atomic_load_explicit(&g_sampler.running, memory_order_acquire);
+}
@@ -0,0 +1,121 @@
+#include <ttak/sync/brlock.h>
+#include <ttak/timing/timing.h>
+#include <ttak/types/ttak_compiler.h>
+#include <ttak/arch/ttak_arch.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+_Static_assert((TTAK_BRLOCK_TABLE_SIZE & (TTAK_BRLOCK_TABLE_SIZE - 1)) == 0,
+               "visible-readers table size must be a power of two");
+
+/**
+ * @brief Process-wide visible-readers table; a slot holds the lock its
+ *        reader is in, or NULL.
+ */
+static _Alignas(64) ttak_brlock_t *_Atomic g_visible[TTAK_BRLOCK_TABLE_SIZE];
+
+#if !defined(__TINYC__)
+/**
+ * @brief Biased read locks the calling thread holds, newest last.
+ */
+typedef struct brlock_tls {
+    uint32_t held;
+    struct {
+        ttak_brlock_t *lock;
+        uint32_t slot;
+    } fast[TTAK_BRLOCK_MAX_FAST];
+} brlock_tls_t;
+
+static _Thread_local brlock_tls_t t_brlock;
+
+static inline uint32_t brlock_slot(const brlock_tls_t *tls, const ttak_brlock_t *lock) {
+    /* The TLS block's address identifies the thread. */
+    uint64_t h = ((uint64_t)(uintptr_t)tls ^ ((uint64_t)(uintptr_t)lock << 7)) * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(h >> 40) & (TTAK_BRLOCK_TABLE_SIZE - 1);
+}
+#endif
+
+int ttak_brlock_init(ttak_brlock_t *lock) {
+    atomic_init(&lock->rbias, 1);
+    atomic_init(&lock->inhibit_until_ns, 0);
+    return pthread_rwlock_init(&lock->lock, NULL);
+}
+
+int ttak_brlock_destroy(ttak_brlock_t *lock) {
+    return pthread_rwlock_destroy(&lock->lock);
+}
+
+int ttak_brlock_rdlock(ttak_brlock_t *lock) {
+#if !defined(__TINYC__)
+    brlock_tls_t *tls = &t_brlock;
+    if (atomic_load_explicit(&lock->rbias, memory_order_relaxed) && tls->held < TTAK_BRLOCK_MAX_FAST) {
+        uint32_t slot = brlock_slot(tls, lock);
+        ttak_brlock_t *expected = NULL;
+        if (atomic_compare_exchange_strong_explicit(&g_visible[slot], &expected, lock,
+                                                    memory_order_seq_cst, memory_order_relaxed)) {
+            /* Pairs with the writer clearing rbias before it scans the table. */
+            if (TTAK_LIKELY(atomic_load_explicit(&lock->rbias, memory_order_seq_cst))) {
+                tls->fast[tls->held].lock = lock;
+                tls->fast[tls->held].slot = slot;
+                tls->held++;
+                return 0;
+            }
+            atomic_store_explicit(&g_visible[slot], NULL, memory_order_release);
+        }
+    }
+#endif
+    int rc = pthread_rwlock_rdlock(&lock->lock);
+    if (rc != 0) return rc;
+#if !defined(__TINYC__)
+    /* No writer can be inside while we hold the read side, so re-biasing is safe here. */
+    if (!atomic_load_explicit(&lock->rbias, memory_order_relaxed) &&
+        ttak_get_tick_count_ns() >= atomic_load_explicit(&lock->inhibit_until_ns, memory_order_relaxed)) {
+        atomic_store_explicit(&lock->rbias, 1, memory_order_release);
+    }
+#endif
+    return 0;
+}
+
+int ttak_brlock_rdunlock(ttak_brlock_t *lock) {
+#if !defined(__TINYC__)
+    brlock_tls_t *tls = &t_brlock;
+    for (uint32_t i = tls->held; i-- > 0;) {
+        if (tls->fast[i].lock != lock) continue;
+        atomic_store_explicit(&g_visible[tls->fast[i].slot], NULL, memory_order_release);
+        tls->fast[i] = tls->fast[--tls->held];
+        return 0;
+    }
+#endif
+    return pthread_rwlock_unlock(&lock->lock);
+}
+
+int ttak_brlock_wrlock(ttak_brlock_t *lock) {
+    int rc = pthread_rwlock_wrlock(&lock->lock);
+    if (rc != 0) return rc;
+    if (atomic_load_explicit(&lock->rbias, memory_order_relaxed)) {
+        atomic_store_explicit(&lock->rbias, 0, memory_order_seq_cst);
+        uint64_t start = ttak_get_tick_count_ns();
+        for (size_t i = 0; i < TTAK_BRLOCK_TABLE_SIZE; i++) {
+            unsigned spins = 0;
+            while (atomic_load_explicit(&g_visible[i], memory_order_acquire) == lock) {
+                ttak_arch_pause();
+#ifndef _WIN32
+                if ((++spins & 255u) == 0) sched_yield();
+#endif
+            }
+        }
+        uint64_t now = ttak_get_tick_count_ns();
+        atomic_store_explicit(&lock->inhibit_until_ns, now + (now - start) * TTAK_BRLOCK_INHIBIT_MULT,
+                              memory_order_relaxed);
+    }
+    return 0;
+}
+
+int ttak_brlock_wrunlock(ttak_brlock_t *lock) {
+    return pthread_rwlock_unlock(&lock->lock);
+}
@@ -0,0 +1,353 @@
+#include <ttak/sync/qlock.h>
+#include <ttak/types/ttak_compiler.h>
+#include <ttak/arch/ttak_arch.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sched.h>
+#else
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+/** CPUs covered by the NUMA node table; higher CPUs report node 0. */
+#define QLOCK_MAX_CPUS 1024
+/** Highest NUMA node number probed in sysfs. */
+#define QLOCK_MAX_NODES 64
+/** Pauses between yields while waiting, so an owner preempted on a busy CPU can run. */
+#define QLOCK_SPINS_PER_YIELD 256u
+
+typedef struct qlock_mcs_slot {
+    _Alignas(64) ttak_mcs_node_t node;
+} qlock_mcs_slot_t;
+
+typedef struct qlock_clh_slot {
+    _Alignas(64) ttak_clh_node_t node;
+} qlock_clh_slot_t;
+
+/**
+ * @brief Per-thread queue nodes.
+ */
+typedef struct qlock_tls {
+    qlock_mcs_slot_t mcs[TTAK_MCS_MAX_HELD];
+    uint32_t mcs_used;           /**< Bit i set while mcs[i] is queued or owning. */
+    ttak_clh_node_t *clh_free;   /**< CLH nodes this thread owns and is not using. */
+    bool key_set;                /**< Exit destructor registered for this thread. */
+} qlock_tls_t;
+
+_Static_assert(TTAK_MCS_MAX_HELD <= 32, "mcs_used is a 32-bit mask");
+
+static pthread_once_t g_qlock_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_qlock_key;
+
+static void qlock_thread_exit(void *arg) {
+    qlock_tls_t *tls = (qlock_tls_t *)arg;
+    ttak_clh_node_t *node = tls->clh_free;
+    while (node) {
+        ttak_clh_node_t *next = node->free_next;
+        free(node);
+        node = next;
+    }
+    tls->clh_free = NULL;
+    tls->key_set = false;
+#if defined(__TINYC__)
+    free(tls);
+#endif
+}
+
+static void qlock_make_key(void) {
+    pthread_key_create(&g_qlock_key, qlock_thread_exit);
+}
+
+#if defined(__TINYC__)
+/* Tiny C has no _Thread_local; keep the state behind the key instead. */
+static qlock_tls_t *qlock_tls(void) {
+    pthread_once(&g_qlock_key_once, qlock_make_key);
+    qlock_tls_t *tls = (qlock_tls_t *)pthread_getspecific(g_qlock_key);
+    if (TTAK_LIKELY(tls != NULL)) return tls;
+    tls = (qlock_tls_t *)aligned_alloc(64, sizeof(*tls));
+    if (!tls) {
+        fprintf(stderr, "[FATAL] qlock: out of memory for thread state\n");
+        abort();
+    }
+    memset(tls, 0, sizeof(*tls));
+    tls->key_set = true;
+    pthread_setspecific(g_qlock_key, tls);
+    return tls;
+}
+
+static inline void qlock_register_exit(qlock_tls_t *tls) {
+    (void)tls;
+}
+#else
+static _Thread_local qlock_tls_t t_qlock;
+
+static inline qlock_tls_t *qlock_tls(void) {
+    return &t_qlock;
+}
+
+/**
+ * @brief Arranges for the thread's cached CLH nodes to be freed at exit.
+ */
+static inline void qlock_register_exit(qlock_tls_t *tls) {
+    if (TTAK_LIKELY(tls->key_set)) return;
+    pthread_once(&g_qlock_key_once, qlock_make_key);
+    pthread_setspecific(g_qlock_key, tls);
+    tls->key_set = true;
+}
+#endif
+
+static inline void qlock_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+/**
+ * @brief One step of a wait loop: a pause, and now and then a yield.
+ */
+static inline void qlock_relax(uint32_t *spins) {
+    ttak_arch_pause();
+    if ((++*spins % QLOCK_SPINS_PER_YIELD) == 0) qlock_yield();
+}
+
+/* ---- Ticket ------------------------------------------------------------ */
+
+void ttak_ticket_lock(ttak_ticket_t *lock) {
+    uint32_t ticket = atomic_fetch_add_explicit(&lock->next, 1, memory_order_relaxed);
+    uint32_t spins = 0;
+    for (;;) {
+        uint32_t owner = atomic_load_explicit(&lock->owner, memory_order_acquire);
+        if (owner == ticket) return;
+        /* Each waiter ahead is roughly one critical section of waiting. */
+        for (uint32_t i = (ticket - owner) * 8; i > 1; i--) ttak_arch_pause();
+        qlock_relax(&spins);
+    }
+}
+
+/* ---- MCS --------------------------------------------------------------- */
+
+static inline ttak_mcs_node_t *mcs_node_take(qlock_tls_t *tls) {
+    uint32_t free_mask = ~tls->mcs_used;
+    if (TTAK_MCS_MAX_HELD < 32) free_mask &= (1u << TTAK_MCS_MAX_HELD) - 1u;
+    if (TTAK_UNLIKELY(free_mask == 0)) {
+        fprintf(stderr, "[FATAL] qlock: thread holds more than %d MCS locks\n", TTAK_MCS_MAX_HELD);
+        abort();
+    }
+    int idx = __builtin_ctz(free_mask);
+    tls->mcs_used |= 1u << idx;
+    ttak_mcs_node_t *node = &tls->mcs[idx].node;
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    atomic_store_explicit(&node->locked, 1, memory_order_relaxed);
+    return node;
+}
+
+static inline void mcs_node_put(qlock_tls_t *tls, ttak_mcs_node_t *node) {
+    size_t idx = (size_t)((qlock_mcs_slot_t *)node - tls->mcs);
+    tls->mcs_used &= ~(1u << idx);
+}
+
+void ttak_mcs_lock(ttak_mcs_t *lock) {
+    qlock_tls_t *tls = qlock_tls();
+    ttak_mcs_node_t *node = mcs_node_take(tls);
+    ttak_mcs_node_t *pred = atomic_exchange_explicit(&lock->tail, node, memory_order_acq_rel);
+    if (pred) {
+        atomic_store_explicit(&pred->next, node, memory_order_release);
+        uint32_t spins = 0;
+        while (atomic_load_explicit(&node->locked, memory_order_acquire)) qlock_relax(&spins);
+    }
+    lock->holder = node;
+}
+
+bool ttak_mcs_trylock(ttak_mcs_t *lock) {
+    if (atomic_load_explicit(&lock->tail, memory_order_relaxed) != NULL) return false;
+    qlock_tls_t *tls = qlock_tls();
+    ttak_mcs_node_t *node = mcs_node_take(tls);
+    ttak_mcs_node_t *expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&lock->tail, &expected, node,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+        mcs_node_put(tls, node);
+        return false;
+    }
+    lock->holder = node;
+    return true;
+}
+
+void ttak_mcs_unlock(ttak_mcs_t *lock) {
+    ttak_mcs_node_t *node = lock->holder;
+    ttak_mcs_node_t *next = atomic_load_explicit(&node->next, memory_order_acquire);
+    if (!next) {
+        ttak_mcs_node_t *expected = node;
+        if (atomic_compare_exchange_strong_explicit(&lock->tail, &expected, NULL,
+                                                    memory_order_release, memory_order_relaxed)) {
+            mcs_node_put(qlock_tls(), node);
+            return;
+        }
+        /* A successor swapped the tail but has not linked in yet. */
+        uint32_t spins = 0;
+        while (!(next = atomic_load_explicit(&node->next, memory_order_acquire))) qlock_relax(&spins);
+    }
+    atomic_store_explicit(&next->locked, 0, memory_order_release);
+    mcs_node_put(qlock_tls(), node);
+}
+
+/* ---- CLH --------------------------------------------------------------- */
+
+static inline ttak_clh_node_t *clh_node_take(qlock_tls_t *tls) {
+    ttak_clh_node_t *node = tls->clh_free;
+    if (TTAK_LIKELY(node != NULL)) {
+        tls->clh_free = node->free_next;
+    } else {
+        node = (ttak_clh_node_t *)aligned_alloc(64, sizeof(qlock_clh_slot_t));
+        if (!node) {
+            fprintf(stderr, "[FATAL] qlock: out of memory for a CLH node\n");
+            abort();
+        }
+        qlock_register_exit(tls);
+    }
+    atomic_store_explicit(&node->locked, 1, memory_order_relaxed);
+    return node;
+}
+
+static inline void clh_node_put(qlock_tls_t *tls, ttak_clh_node_t *node) {
+    node->free_next = tls->clh_free;
+    tls->clh_free = node;
+}
+
+void ttak_clh_lock(ttak_clh_t *lock) {
+    qlock_tls_t *tls = qlock_tls();
+    ttak_clh_node_t *node = clh_node_take(tls);
+    ttak_clh_node_t *pred = atomic_exchange_explicit(&lock->tail, node, memory_order_acq_rel);
+    if (pred) {
+        uint32_t spins = 0;
+        while (atomic_load_explicit(&pred->locked, memory_order_acquire)) qlock_relax(&spins);
+        /* The predecessor gave its node up when it released; it is ours now. */
+        clh_node_put(tls, pred);
+    }
+    lock->holder = node;
+}
+
+bool ttak_clh_trylock(ttak_clh_t *lock) {
+    if (atomic_load_explicit(&lock->tail, memory_order_relaxed) != NULL) return false;
+    qlock_tls_t *tls = qlock_tls();
+    ttak_clh_node_t *node = clh_node_take(tls);
+    ttak_clh_node_t *expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&lock->tail, &expected, node,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+        clh_node_put(tls, node);
+        return false;
+    }
+    lock->holder = node;
+    return true;
+}
+
+void ttak_clh_unlock(ttak_clh_t *lock) {
+    ttak_clh_node_t *node = lock->holder;
+    ttak_clh_node_t *expected = node;
+    /* Nobody queued behind us: empty the lock and keep the node. */
+    if (atomic_compare_exchange_strong_explicit(&lock->tail, &expected, NULL,
+                                                memory_order_release, memory_order_relaxed)) {
+        clh_node_put(qlock_tls(), node);
+        return;
+    }
+    atomic_store_explicit(&node->locked, 0, memory_order_release);
+}
+
+/* ---- NUMA topology ----------------------------------------------------- */
+
+static pthread_once_t g_topology_once = PTHREAD_ONCE_INIT;
+static uint8_t g_cpu_node[QLOCK_MAX_CPUS];
+
+/**
+ * @brief Fills g_cpu_node from the sysfs node cpulists ("0-3,8-11").
+ */
+static void qlock_load_topology(void) {
+#if defined(__linux__)
+    char path[64];
+    char buf[1024];
+    for (int node = 0; node < QLOCK_MAX_NODES; node++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *f = fopen(path, "r");
+        if (!f) continue;
+        size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+        fclose(f);
+        buf[n] = '\0';
+        char *p = buf;
+        while (*p >= '0' && *p <= '9') {
+            long lo = strtol(p, &p, 10);
+            long hi = lo;
+            if (*p == '-') hi = strtol(p + 1, &p, 10);
+            for (long cpu = lo; cpu <= hi && cpu < QLOCK_MAX_CPUS; cpu++) {
+                g_cpu_node[cpu] = (uint8_t)node;
+            }
+            if (*p == ',') p++;
+        }
+    }
+#endif
+}
+
+int ttak_qlock_current_node(void) {
+#if defined(__linux__)
+    pthread_once(&g_topology_once, qlock_load_topology);
+    int cpu = sched_getcpu();
+    if (cpu < 0 || cpu >= QLOCK_MAX_CPUS) return 0;
+    return g_cpu_node[cpu];
+#else
+    return 0;
+#endif
+}
+
+/* ---- Cohort ------------------------------------------------------------ */
+
+void ttak_cohort_init(ttak_cohort_t *lock) {
+    ttak_ticket_init(&lock->global);
+    for (int i = 0; i < TTAK_COHORT_MAX_NODES; i++) {
+        ttak_ticket_init(&lock->local[i].lock);
+        lock->local[i].global_held = false;
+        lock->local[i].batch = 0;
+    }
+    lock->holder = 0;
+}
+
+void ttak_cohort_lock(ttak_cohort_t *lock) {
+    uint32_t idx = (uint32_t)ttak_qlock_current_node() % TTAK_COHORT_MAX_NODES;
+    ttak_cohort_local_t *local = &lock->local[idx];
+    ttak_ticket_lock(&local->lock);
+    if (!local->global_held) ttak_ticket_lock(&lock->global);
+    lock->holder = idx;
+}
+
+bool ttak_cohort_trylock(ttak_cohort_t *lock) {
+    uint32_t idx = (uint32_t)ttak_qlock_current_node() % TTAK_COHORT_MAX_NODES;
+    ttak_cohort_local_t *local = &lock->local[idx];
+    if (!ttak_ticket_trylock(&local->lock)) return false;
+    if (!local->global_held && !ttak_ticket_trylock(&lock->global)) {
+        ttak_ticket_unlock(&local->lock);
+        return false;
+    }
+    lock->holder = idx;
+    return true;
+}
+
+void ttak_cohort_unlock(ttak_cohort_t *lock) {
+    ttak_cohort_local_t *local = &lock->local[lock->holder];
+    if (local->batch < TTAK_COHORT_BATCH && ttak_ticket_has_waiters(&local->lock)) {
+        /* Hand the global lock to the next waiter on this node. */
+        local->batch++;
+        local->global_held = true;
+        ttak_ticket_unlock(&local->lock);
+        return;
+    }
+    local->batch = 0;
+    local->global_held = false;
+    ttak_ticket_unlock(&lock->global);
+    ttak_ticket_unlock(&local->lock);
+}
@@ -0,0 +1,258 @@
+#include <ttak/sync/waitword.h>
+#include <ttak/timing/timing.h>
+#include <ttak/types/ttak_compiler.h>
+#include <ttak/arch/ttak_arch.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define TTAK_WAITWORD_FUTEX 1
+#elif defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Synchronization.lib")
+#endif
+#define TTAK_WAITWORD_WIN32 1
+#elif defined(__APPLE__)
+#define TTAK_WAITWORD_ULOCK 1
+#define UL_COMPARE_AND_WAIT 1
+#define UL_COMPARE_AND_WAIT_SHARED 3
+#define ULF_WAKE_ALL 0x00000100
+#define ULF_NO_ERRNO 0x01000000
+extern int __ulock_wait(uint32_t operation, void *addr, uint64_t value, uint32_t timeout_us);
+extern int __ulock_wake(uint32_t operation, void *addr, uint64_t wake_value);
+#else
+#include <pthread.h>
+#define TTAK_WAITWORD_BUCKETS 64
+#endif
+
+#if defined(TTAK_WAITWORD_BUCKETS)
+/*
+ * Portable fallback: waiters sleep on a condvar picked by the word's
+ * address. The bucket mutex makes the value check and the sleep atomic
+ * with respect to a waker, which takes the same mutex before broadcasting.
+ */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} g_buckets[TTAK_WAITWORD_BUCKETS];
+static pthread_once_t g_buckets_once = PTHREAD_ONCE_INIT;
+
+static void waitword_buckets_init(void) {
+    for (int i = 0; i < TTAK_WAITWORD_BUCKETS; i++) {
+        pthread_mutex_init(&g_buckets[i].lock, NULL);
+        pthread_cond_init(&g_buckets[i].cond, NULL);
+    }
+}
+
+static inline int waitword_bucket(const void *word) {
+    return (int)(((uintptr_t)word >> 2) * 0x9E3779B1u >> 26) & (TTAK_WAITWORD_BUCKETS - 1);
+}
+#endif
+
+/** Longest nap of a shared wait on platforms without a cross-process address wait. */
+#define TTAK_WAITWORD_SHARED_NAP_NS 1000000ull
+
+#if !defined(TTAK_WAITWORD_FUTEX) && !defined(TTAK_WAITWORD_ULOCK)
+static int waitword_nap(uint64_t timeout_ns) {
+    uint64_t ns = timeout_ns < TTAK_WAITWORD_SHARED_NAP_NS ? timeout_ns : TTAK_WAITWORD_SHARED_NAP_NS;
+#if defined(_WIN32)
+    Sleep((DWORD)((ns + 999999ull) / 1000000ull));
+#else
+    struct timespec ts = { 0, (long)ns };
+    nanosleep(&ts, NULL);
+#endif
+    return ns == timeout_ns ? ETIMEDOUT : 0;
+}
+#endif
+
+/**
+ * @brief Process-shared wait: a plain futex or shared ulock, or a bounded nap elsewhere.
+ */
+int ttak_waitword_wait_shared(_Atomic uint32_t *word, uint32_t expected, uint64_t timeout_ns) {
+#if defined(TTAK_WAITWORD_FUTEX)
+    struct timespec ts;
+    struct timespec *tsp = NULL;
+    if (timeout_ns != TTAK_WAIT_FOREVER) {
+        ts.tv_sec = (time_t)(timeout_ns / 1000000000ull);
+        ts.tv_nsec = (long)(timeout_ns % 1000000000ull);
+        tsp = &ts;
+    }
+    if (syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, expected, tsp, NULL, 0) == 0) return 0;
+    return errno == ETIMEDOUT ? ETIMEDOUT : 0;
+#elif defined(TTAK_WAITWORD_ULOCK)
+    uint32_t us = 0;
+    if (timeout_ns != TTAK_WAIT_FOREVER) {
+        uint64_t v = (timeout_ns + 999ull) / 1000ull;
+        us = v == 0 ? 1 : (v > UINT32_MAX ? UINT32_MAX : (uint32_t)v);
+    }
+    int rc = __ulock_wait(UL_COMPARE_AND_WAIT_SHARED | ULF_NO_ERRNO, (void *)word, expected, us);
+    return rc == -ETIMEDOUT ? ETIMEDOUT : 0;
+#else
+    if (atomic_load_explicit(word, memory_order_acquire) != expected) return 0;
+    return waitword_nap(timeout_ns);
+#endif
+}
+
+void ttak_waitword_wake_shared(_Atomic uint32_t *word, bool all) {
+#if defined(TTAK_WAITWORD_FUTEX)
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, all ? INT32_MAX : 1, NULL, NULL, 0);
+#elif defined(TTAK_WAITWORD_ULOCK)
+    __ulock_wake(UL_COMPARE_AND_WAIT_SHARED | ULF_NO_ERRNO | (all ? ULF_WAKE_ALL : 0), (void *)word, 0);
+#else
+    /* Nappers re-check on their own. */
+    (void)word;
+    (void)all;
+#endif
+}
+
+int ttak_waitword_wait(_Atomic uint32_t *word, uint32_t expected, uint64_t timeout_ns) {
+#if defined(TTAK_WAITWORD_FUTEX)
+    struct timespec ts;
+    struct timespec *tsp = NULL;
+    if (timeout_ns != TTAK_WAIT_FOREVER) {
+        ts.tv_sec = (time_t)(timeout_ns / 1000000000ull);
+        ts.tv_nsec = (long)(timeout_ns % 1000000000ull);
+        tsp = &ts;
+    }
+    if (syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT_PRIVATE, expected, tsp, NULL, 0) == 0) return 0;
+    return errno == ETIMEDOUT ? ETIMEDOUT : 0;
+#elif defined(TTAK_WAITWORD_WIN32)
+    DWORD ms = INFINITE;
+    if (timeout_ns != TTAK_WAIT_FOREVER) {
+        uint64_t v = (timeout_ns + 999999ull) / 1000000ull;
+        ms = v >= INFINITE ? INFINITE - 1 : (DWORD)v;
+    }
+    if (WaitOnAddress((volatile VOID *)word, &expected, sizeof(expected), ms)) return 0;
+    return GetLastError() == ERROR_TIMEOUT ? ETIMEDOUT : 0;
+#elif defined(TTAK_WAITWORD_ULOCK)
+    uint32_t us = 0;
+    if (timeout_ns != TTAK_WAIT_FOREVER) {
+        uint64_t v = (timeout_ns + 999ull) / 1000ull;
+        us = v == 0 ? 1 : (v > UINT32_MAX ? UINT32_MAX : (uint32_t)v);
+    }
+    int rc = __ulock_wait(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO, (void *)word, expected, us);
+    return rc == -ETIMEDOUT ? ETIMEDOUT : 0;
+#else
+    pthread_once(&g_buckets_once, waitword_buckets_init);
+    int b = waitword_bucket(word);
+    int rc = 0;
+    pthread_mutex_lock(&g_buckets[b].lock);
+    if (atomic_load_explicit(word, memory_order_acquire) == expected) {
+        if (timeout_ns == TTAK_WAIT_FOREVER) {
+            pthread_cond_wait(&g_buckets[b].cond, &g_buckets[b].lock);
+        } else {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            uint64_t ns = (uint64_t)ts.tv_nsec + timeout_ns % 1000000000ull;
+            ts.tv_sec += (time_t)(timeout_ns / 1000000000ull + ns / 1000000000ull);
+            ts.tv_nsec = (long)(ns % 1000000000ull);
+            rc = pthread_cond_timedwait(&g_buckets[b].cond, &g_buckets[b].lock, &ts) == ETIMEDOUT ? ETIMEDOUT : 0;
+        }
+    }
+    pthread_mutex_unlock(&g_buckets[b].lock);
+    return rc;
+#endif
+}
+
+static void waitword_wake(_Atomic uint32_t *word, bool all) {
+#if defined(TTAK_WAITWORD_FUTEX)
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE_PRIVATE, all ? INT32_MAX : 1, NULL, NULL, 0);
+#elif defined(TTAK_WAITWORD_WIN32)
+    if (all) WakeByAddressAll((PVOID)word);
+    else WakeByAddressSingle((PVOID)word);
+#elif defined(TTAK_WAITWORD_ULOCK)
+    __ulock_wake(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO | (all ? ULF_WAKE_ALL : 0), (void *)word, 0);
+#else
+    /* Buckets are shared, so a single wake could land on another word's waiter. */
+    (void)all;
+    pthread_once(&g_buckets_once, waitword_buckets_init);
+    int b = waitword_bucket(word);
+    pthread_mutex_lock(&g_buckets[b].lock);
+    pthread_cond_broadcast(&g_buckets[b].cond);
+    pthread_mutex_unlock(&g_buckets[b].lock);
+#endif
+}
+
+void ttak_waitword_wake_one(_Atomic uint32_t *word) {
+    waitword_wake(word, false);
+}
+
+void ttak_waitword_wake_all(_Atomic uint32_t *word) {
+    waitword_wake(word, true);
+}
+
+static int waitword_await(_Atomic uint32_t *word, uint32_t expected, uint64_t timeout_ns, bool shared) {
+    for (int i = 0; i < TTAK_WAITWORD_SPINS; i++) {
+        if (atomic_load_explicit(word, memory_order_acquire) != expected) return 0;
+        ttak_arch_pause();
+    }
+    uint64_t deadline = TTAK_WAIT_FOREVER;
+    if (timeout_ns != TTAK_WAIT_FOREVER) deadline = ttak_get_tick_count_ns() + timeout_ns;
+    while (atomic_load_explicit(word, memory_order_acquire) == expected) {
+        uint64_t left = TTAK_WAIT_FOREVER;
+        if (deadline != TTAK_WAIT_FOREVER) {
+            uint64_t now = ttak_get_tick_count_ns();
+            if (now >= deadline) return ETIMEDOUT;
+            left = deadline - now;
+        }
+        if (shared) ttak_waitword_wait_shared(word, expected, left);
+        else ttak_waitword_wait(word, expected, left);
+    }
+    return 0;
+}
+
+int ttak_waitword_await(_Atomic uint32_t *word, uint32_t expected, uint64_t timeout_ns) {
+    return waitword_await(word, expected, timeout_ns, false);
+}
+
+void ttak_eventcount_wait(ttak_eventcount_t *ec, uint32_t key) {
+    ttak_eventcount_wait_for(ec, key, TTAK_WAIT_FOREVER);
+}
+
+int ttak_eventcount_wait_for(ttak_eventcount_t *ec, uint32_t key, uint64_t timeout_ns) {
+    int rc = waitword_await(&ec->seq, key, timeout_ns, false);
+    atomic_fetch_sub_explicit(&ec->waiters, 1, memory_order_relaxed);
+    return rc;
+}
+
+int ttak_eventcount_wait_shared(ttak_eventcount_t *ec, uint32_t key, uint64_t timeout_ns) {
+    int rc = waitword_await(&ec->seq, key, timeout_ns, true);
+    atomic_fetch_sub_explicit(&ec->waiters, 1, memory_order_relaxed);
+    return rc;
+}
+
+/**
+ * @brief Bumps the sequence and wakes, but only if someone has prepared.
+ *
+ * The fence pairs with the seq_cst increment in prepare(): either this
+ * load sees the waiter, or the waiter's re-check sees what the caller
+ * published before notifying.
+ */
+static inline void eventcount_signal(ttak_eventcount_t *ec, bool all, bool shared) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (TTAK_LIKELY(atomic_load_explicit(&ec->waiters, memory_order_relaxed) == 0)) return;
+    atomic_fetch_add_explicit(&ec->seq, 1, memory_order_release);
+    if (shared) ttak_waitword_wake_shared(&ec->seq, all);
+    else waitword_wake(&ec->seq, all);
+}
+
+void ttak_eventcount_notify(ttak_eventcount_t *ec) {
+    eventcount_signal(ec, false, false);
+}
+
+void ttak_eventcount_notify_all(ttak_eventcount_t *ec) {
+    eventcount_signal(ec, true, false);
+}
+
+void ttak_eventcount_notify_shared(ttak_eventcount_t *ec, bool all) {
+    eventcount_signal(ec, all, true);
+}
@@ -0,0 +1,359 @@
+#include <ttak/thread/parallel.h>
+#include <ttak/sync/waitword.h>
+#include <ttak/priority/nice.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1u << RADIX_BITS)
+#define RADIX_PASSES (64 / RADIX_BITS)
+
+/*
+ * One fork/join over @c count indices. Helpers and the caller claim
+ * indices from @c next; whoever finishes the last one raises @c done.
+ * Helpers may be dequeued after the caller has returned, so the job is
+ * reference counted and the last reference frees it.
+ */
+typedef struct parallel_job {
+    _Atomic size_t refs;
+    _Atomic size_t next;
+    _Atomic size_t left;
+    _Atomic uint32_t done;
+    size_t count;
+    void (*fn)(void *ctx, size_t index);
+    void *ctx;
+} parallel_job_t;
+
+static void parallel_job_release(parallel_job_t *job) {
+    if (atomic_fetch_sub_explicit(&job->refs, 1, memory_order_acq_rel) == 1) free(job);
+}
+
+static void parallel_job_drain(parallel_job_t *job, bool caller) {
+    size_t ran = 0;
+    for (;;) {
+        size_t i = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (i >= job->count) break;
+        job->fn(job->ctx, i);
+        ran++;
+    }
+    if (!ran || atomic_fetch_sub_explicit(&job->left, ran, memory_order_acq_rel) != ran) return;
+    atomic_store_explicit(&job->done, 1, memory_order_release);
+    /* The caller is the only waiter and never sleeps on work it finished itself. */
+    if (!caller) ttak_waitword_wake_one(&job->done);
+}
+
+static void *parallel_job_helper(void *arg) {
+    parallel_job_t *job = arg;
+    parallel_job_drain(job, false);
+    parallel_job_release(job);
+    return NULL;
+}
+
+static size_t parallel_helpers(ttak_thread_pool_t *pool) {
+    return pool ? ttak_thread_pool_live_workers(pool) : 0;
+}
+
+/**
+ * @brief Runs fn(ctx, i) for every i in [0, count) on the caller and the pool.
+ */
+static void parallel_run(ttak_thread_pool_t *pool, size_t count, void (*fn)(void *ctx, size_t index),
+                         void *ctx, uint64_t now) {
+    size_t helpers = count > 1 ? parallel_helpers(pool) : 0;
+    if (helpers > count - 1) helpers = count - 1;
+    parallel_job_t *job = helpers ? malloc(sizeof(*job)) : NULL;
+    if (!job) {
+        for (size_t i = 0; i < count; i++) fn(ctx, i);
+        return;
+    }
+    atomic_init(&job->refs, 1 + helpers);
+    atomic_init(&job->next, 0);
+    atomic_init(&job->left, count);
+    atomic_init(&job->done, 0);
+    job->count = count;
+    job->fn = fn;
+    job->ctx = ctx;
+    for (size_t h = 0; h < helpers; h++) {
+        if (!ttak_thread_pool_submit_detached(pool, parallel_job_helper, job, __TT_SCHED_NORMAL__, now)) {
+            atomic_fetch_sub_explicit(&job->refs, helpers - h, memory_order_acq_rel);
+            break;
+        }
+    }
+    parallel_job_drain(job, true);
+    ttak_waitword_await(&job->done, 0, TTAK_WAIT_FOREVER);
+    parallel_job_release(job);
+}
+
+/**
+ * @brief Grain for @p n indices: @p grain itself, or an even split when 0.
+ */
+static size_t parallel_grain(ttak_thread_pool_t *pool, size_t n, size_t grain) {
+    if (grain) return grain;
+    size_t parts = (parallel_helpers(pool) + 1) * TTAK_PARALLEL_CHUNKS_PER_THREAD;
+    grain = n / parts + (n % parts != 0);
+    return grain ? grain : 1;
+}
+
+static inline size_t parallel_chunks(size_t n, size_t grain) {
+    return n / grain + (n % grain != 0);
+}
+
+typedef struct parallel_range {
+    size_t begin;
+    size_t end;
+    size_t grain;
+    void *ctx;
+    ttak_parallel_body_t body;
+    ttak_parallel_reduce_body_t reduce;
+    ttak_parallel_op_t op;
+    unsigned char *data;            /* Scan elements, or reduce accumulators. */
+    unsigned char *carry;           /* Scan: prefix of the chunks before each chunk. */
+    size_t size;
+    const void *identity;
+} parallel_range_t;
+
+static inline void parallel_chunk_bounds(const parallel_range_t *r, size_t chunk, size_t *b, size_t *e) {
+    *b = r->begin + chunk * r->grain;
+    *e = r->end - *b > r->grain ? *b + r->grain : r->end;
+}
+
+static void parallel_for_chunk(void *arg, size_t chunk) {
+    parallel_range_t *r = arg;
+    size_t b, e;
+    parallel_chunk_bounds(r, chunk, &b, &e);
+    r->body(r->ctx, b, e);
+}
+
+void ttak_parallel_for(ttak_thread_pool_t *pool, size_t begin, size_t end, size_t grain,
+                       ttak_parallel_body_t body, void *ctx, uint64_t now) {
+    if (!body || end <= begin) return;
+    size_t n = end - begin;
+    grain = parallel_grain(pool, n, grain);
+    size_t chunks = parallel_chunks(n, grain);
+    if (chunks == 1 || !parallel_helpers(pool)) {
+        body(ctx, begin, end);
+        return;
+    }
+    parallel_range_t r = { .begin = begin, .end = end, .grain = grain, .ctx = ctx, .body = body };
+    parallel_run(pool, chunks, parallel_for_chunk, &r, now);
+}
+
+static void parallel_reduce_chunk(void *arg, size_t chunk) {
+    parallel_range_t *r = arg;
+    size_t b, e;
+    parallel_chunk_bounds(r, chunk, &b, &e);
+    void *acc = r->data + chunk * r->size;
+    memcpy(acc, r->identity, r->size);
+    r->reduce(r->ctx, b, e, acc);
+}
+
+_Bool ttak_parallel_reduce(ttak_thread_pool_t *pool, size_t begin, size_t end, size_t grain,
+                           void *result, size_t size, const void *identity,
+                           ttak_parallel_reduce_body_t body, ttak_parallel_op_t op, void *ctx, uint64_t now) {
+    if (!result || !size || !identity || !body || !op) return false;
+    size_t n = end > begin ? end - begin : 0;
+    grain = parallel_grain(pool, n, grain);
+    size_t chunks = n ? parallel_chunks(n, grain) : 0;
+    unsigned char *accs = NULL;
+    if (chunks > 1 && parallel_helpers(pool)) accs = malloc(chunks * size);
+    if (!accs) {
+        memmove(result, identity, size);
+        if (n) body(ctx, begin, end, result);
+        return true;
+    }
+    parallel_range_t r = { .begin = begin, .end = end, .grain = grain, .ctx = ctx, .reduce = body,
+                           .data = accs, .size = size, .identity = identity };
+    parallel_run(pool, chunks, parallel_reduce_chunk, &r, now);
+    for (size_t c = 1; c < chunks; c++) op(ctx, accs, accs, accs + c * size);
+    memcpy(result, accs, size);
+    free(accs);
+    return true;
+}
+
+static void parallel_scan_local(void *arg, size_t chunk) {
+    parallel_range_t *r = arg;
+    size_t b, e;
+    parallel_chunk_bounds(r, chunk, &b, &e);
+    for (size_t i = b + 1; i < e; i++) {
+        r->op(r->ctx, r->data + i * r->size, r->data + (i - 1) * r->size, r->data + i * r->size);
+    }
+}
+
+static void parallel_scan_carry(void *arg, size_t index) {
+    parallel_range_t *r = arg;
+    size_t chunk = index + 1, b, e;
+    parallel_chunk_bounds(r, chunk, &b, &e);
+    const void *carry = r->carry + index * r->size;
+    for (size_t i = b; i < e; i++) r->op(r->ctx, r->data + i * r->size, carry, r->data + i * r->size);
+}
+
+_Bool ttak_parallel_scan(ttak_thread_pool_t *pool, void *data, size_t count, size_t size, size_t grain,
+                         ttak_parallel_op_t op, void *ctx, uint64_t now) {
+    if ((!data && count) || !size || !op) return false;
+    if (count < 2) return true;
+    grain = parallel_grain(pool, count, grain);
+    size_t chunks = parallel_chunks(count, grain);
+    parallel_range_t r = { .begin = 0, .end = count, .grain = grain, .ctx = ctx, .op = op,
+                           .data = data, .size = size };
+    if (chunks > 1 && parallel_helpers(pool)) r.carry = malloc((chunks - 1) * size);
+    if (!r.carry) {
+        r.grain = count;
+        parallel_scan_local(&r, 0);
+        return true;
+    }
+    parallel_run(pool, chunks, parallel_scan_local, &r, now);
+    /* carry[c] is the prefix of chunks 0..c, i.e. what chunk c + 1 still lacks. */
+    memcpy(r.carry, r.data + (grain - 1) * size, size);
+    for (size_t c = 1; c + 1 < chunks; c++) {
+        op(ctx, r.carry + c * size, r.carry + (c - 1) * size, r.data + ((c + 1) * grain - 1) * size);
+    }
+    parallel_run(pool, chunks - 1, parallel_scan_carry, &r, now);
+    free(r.carry);
+    return true;
+}
+
+/*
+ * LSD radix sort. The input is cut into blocks; every pass counts each
+ * block's digits, turns the counts into per-block output cursors (bucket
+ * by bucket, block by block, which keeps the sort stable), and scatters
+ * the blocks in parallel. One up-front pass counts all eight digits so
+ * passes whose digit never varies are skipped.
+ */
+typedef struct radix_sort {
+    unsigned char *src;
+    unsigned char *dst;
+    size_t elem;                    /* 8 for keys, 16 for pairs; the key comes first. */
+    size_t count;
+    size_t block;
+    unsigned shift;
+    size_t *hist;                   /* [block][pass][bucket] counts, then cursors. */
+} radix_sort_t;
+
+static inline uint64_t radix_key(const unsigned char *p) {
+    uint64_t k;
+    memcpy(&k, p, sizeof(k));
+    return k;
+}
+
+static inline void radix_block_bounds(const radix_sort_t *rs, size_t blk, size_t *b, size_t *e) {
+    *b = blk * rs->block;
+    *e = rs->count - *b > rs->block ? *b + rs->block : rs->count;
+}
+
+static void radix_count_all(void *arg, size_t blk) {
+    radix_sort_t *rs = arg;
+    size_t b, e;
+    radix_block_bounds(rs, blk, &b, &e);
+    size_t *h = rs->hist + blk * RADIX_PASSES * RADIX_BUCKETS;
+    for (size_t i = b; i < e; i++) {
+        uint64_t k = radix_key(rs->src + i * rs->elem);
+        for (unsigned p = 0; p < RADIX_PASSES; p++) {
+            h[p * RADIX_BUCKETS + ((k >> (p * RADIX_BITS)) & (RADIX_BUCKETS - 1))]++;
+        }
+    }
+}
+
+static void radix_count(void *arg, size_t blk) {
+    radix_sort_t *rs = arg;
+    size_t b, e;
+    radix_block_bounds(rs, blk, &b, &e);
+    unsigned pass = rs->shift / RADIX_BITS;
+    size_t *h = rs->hist + (blk * RADIX_PASSES + pass) * RADIX_BUCKETS;
+    memset(h, 0, RADIX_BUCKETS * sizeof(*h));
+    for (size_t i = b; i < e; i++) {
+        h[(radix_key(rs->src + i * rs->elem) >> rs->shift) & (RADIX_BUCKETS - 1)]++;
+    }
+}
+
+static void radix_scatter(void *arg, size_t blk) {
+    radix_sort_t *rs = arg;
+    size_t b, e;
+    radix_block_bounds(rs, blk, &b, &e);
+    unsigned pass = rs->shift / RADIX_BITS;
+    size_t *cur = rs->hist + (blk * RADIX_PASSES + pass) * RADIX_BUCKETS;
+    unsigned shift = rs->shift;
+    if (rs->elem == sizeof(uint64_t)) {
+        const uint64_t *src = (const uint64_t *)rs->src;
+        uint64_t *dst = (uint64_t *)rs->dst;
+        for (size_t i = b; i < e; i++) {
+            uint64_t k = src[i];
+            dst[cur[(k >> shift) & (RADIX_BUCKETS - 1)]++] = k;
+        }
+    } else {
+        const ttak_parallel_kv_t *src = (const ttak_parallel_kv_t *)rs->src;
+        ttak_parallel_kv_t *dst = (ttak_parallel_kv_t *)rs->dst;
+        for (size_t i = b; i < e; i++) {
+            dst[cur[(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+        }
+    }
+}
+
+static void radix_copy_back(void *arg, size_t blk) {
+    radix_sort_t *rs = arg;
+    size_t b, e;
+    radix_block_bounds(rs, blk, &b, &e);
+    memcpy(rs->dst + b * rs->elem, rs->src + b * rs->elem, (e - b) * rs->elem);
+}
+
+static bool radix_sort(ttak_thread_pool_t *pool, void *data, size_t count, size_t elem, uint64_t now) {
+    if (count < 2) return true;
+    size_t blocks = count / TTAK_PARALLEL_SORT_MIN_BLOCK;
+    size_t cap = (parallel_helpers(pool) + 1) * TTAK_PARALLEL_CHUNKS_PER_THREAD;
+    if (cap > TTAK_PARALLEL_SORT_MAX_BLOCKS) cap = TTAK_PARALLEL_SORT_MAX_BLOCKS;
+    if (blocks > cap) blocks = cap;
+    if (blocks == 0) blocks = 1;
+
+    radix_sort_t rs = { .src = data, .elem = elem, .count = count };
+    rs.block = count / blocks + (count % blocks != 0);
+    blocks = parallel_chunks(count, rs.block);
+    rs.dst = malloc(count * elem);
+    rs.hist = calloc(blocks * RADIX_PASSES * RADIX_BUCKETS, sizeof(*rs.hist));
+    if (!rs.dst || !rs.hist) {
+        free(rs.dst);
+        free(rs.hist);
+        return false;
+    }
+    unsigned char *scratch = rs.dst;
+
+    parallel_run(pool, blocks, radix_count_all, &rs, now);
+    bool fresh = true;              /* Block counts still describe rs.src. */
+    for (unsigned pass = 0; pass < RADIX_PASSES; pass++) {
+        rs.shift = pass * RADIX_BITS;
+        if (!fresh) parallel_run(pool, blocks, radix_count, &rs, now);
+        bool trivial = false;
+        size_t pos = 0;
+        for (unsigned d = 0; d < RADIX_BUCKETS && !trivial; d++) {
+            size_t total = 0;
+            for (size_t blk = 0; blk < blocks; blk++) {
+                size_t *h = rs.hist + (blk * RADIX_PASSES + pass) * RADIX_BUCKETS + d;
+                size_t n = *h;
+                *h = pos;
+                pos += n;
+                total += n;
+            }
+            trivial = total == count;
+        }
+        /* Every key shares this digit: the pass would copy the array unchanged. */
+        if (trivial) continue;
+        parallel_run(pool, blocks, radix_scatter, &rs, now);
+        unsigned char *t = rs.src;
+        rs.src = rs.dst;
+        rs.dst = t;
+        fresh = false;
+    }
+    if (rs.src != data) parallel_run(pool, blocks, radix_copy_back, &rs, now);
+    free(scratch);
+    free(rs.hist);
+    return true;
+}
+
+_Bool ttak_parallel_sort_u64(ttak_thread_pool_t *pool, uint64_t *keys, size_t count, uint64_t now) {
+    if (!keys && count) return false;
+    return radix_sort(pool, keys, count, sizeof(*keys), now);
+}
+
+_Bool ttak_parallel_sort_kv(ttak_thread_pool_t *pool, ttak_parallel_kv_t *pairs, size_t count, uint64_t now) {
+    if (!pairs && count) return false;
+    return radix_sort(pool, pairs, count, sizeof(*pairs), now);
+}
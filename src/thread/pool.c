@@ -2,12 +2,23 @@
 #include <ttak/mem/mem.h>
 #include <ttak/sync/sync.h>
 #include <ttak/async/promise.h>
+#include <ttak/async/wait_group.h>
+#include <ttak/timing/timing.h>
+#include <ttak/log/trace.h>
+#include <ttak/stats/metrics.h>
+#include <ttak/stats/system_usage.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <pthread.h>
 #include <signal.h>
 #include <errno.h>
 #include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+#if defined(__linux__)
+#include <sched.h>
+#include <dirent.h>
+#endif
 
 #include <ttak/priority/scheduler.h>
 #include "../../internal/ttak/shard_map.h"
@@ -19,8 +30,8 @@
 #define TTAK_BURST_COOL_DEFAULT_Q10 TTAK_BURST_EWMA_SCALE
 
 typedef struct ttak_burst_tracker {
-    _Atomic uint32_t ewma_row[TTAK_POOL_SHARD_COUNT];
-    _Atomic uint32_t ewma_col[TTAK_POOL_SHARD_COUNT];
+    _Atomic uint32_t ewma_row[TTAK_POOL_SHARD_MAX];
+    _Atomic uint32_t ewma_col[TTAK_POOL_SHARD_MAX];
     _Atomic uint32_t total_ewma;
 } ttak_burst_tracker_t;
 
@@ -80,7 +91,7 @@ static void ttak_pool_burst_record(ttak_thread_pool_t *pool,
                                    uint32_t row,
                                    uint32_t col,
                                    uint32_t urgency_q10) {
-    if (!pool || row >= TTAK_POOL_SHARD_COUNT || col >= TTAK_POOL_SHARD_COUNT) return;
+    if (!pool || row >= pool->shard_count || col >= pool->shard_count) return;
     uint32_t d = ttak_burst_domain_index(domain);
     ttak_burst_tracker_t *tracker = &g_burst_trackers[d];
     uint32_t sample = TTAK_BURST_EWMA_SCALE + urgency_q10;
@@ -98,10 +109,10 @@ static void ttak_pool_burst_record(ttak_thread_pool_t *pool,
 
 static size_t ttak_pool_select_shard_with_burst(ttak_thread_pool_t *pool, ttak_task_t *task) {
     uint64_t hash = ttak_task_get_hash(task);
-    size_t shard_idx = (hash != 0) ? ttak_shard_for_hash(hash) : 0;
+    size_t shard_idx = (hash != 0) ? ttak_shard_for_hash_n(pool->shard_route, pool->shard_log2, hash) : 0;
 
     uint32_t row = 0U, col = 0U;
-    ttak_shard_hash_to_coords(hash, &row, &col);
+    ttak_shard_hash_to_coords_n(hash, pool->shard_log2, &row, &col);
     ttak_task_domain_t domain = ttak_task_get_domain(task);
     uint32_t d = ttak_burst_domain_index(domain);
     uint32_t urgency_q10 = 0U;
@@ -117,8 +128,8 @@ static size_t ttak_pool_select_shard_with_burst(ttak_thread_pool_t *pool, ttak_t
     uint32_t col_w = atomic_load_explicit(&tracker->ewma_col[col], memory_order_relaxed);
     uint32_t burst_score = row_w + col_w + urgency_q10;
     size_t active_shards = pool->num_threads;
-    if (active_shards == 0U || active_shards > TTAK_THREAD_POOL_SHARDS) {
-        active_shards = TTAK_THREAD_POOL_SHARDS;
+    if (active_shards == 0U || active_shards > pool->shard_count) {
+        active_shards = pool->shard_count;
     }
     if (burst_score > (total + TTAK_BURST_EWMA_SCALE)) {
         uint32_t cool_row = TTAK_BURST_COOL_DEFAULT_Q10;
@@ -134,9 +145,9 @@ static size_t ttak_pool_select_shard_with_burst(ttak_thread_pool_t *pool, ttak_t
 /**
  * @brief Stop all workers and signal shutdown.
  *
- * Acquires the coarse pool_lock (used only here and for is_shutdown checks)
- * to flip the flag, then broadcasts on every shard condition variable so that
- * workers blocked in their preferred shard's cond_wait wake up immediately.
+ * Acquires the coarse pool_lock (also held by parking workers) to flip the
+ * flag, then broadcasts task_cond and every shard condition variable so
+ * that parked workers wake up immediately.
  *
  * @param pool Pool to shut down.
  */
@@ -144,25 +155,303 @@ static void pool_force_shutdown(ttak_thread_pool_t *pool) {
     if (!pool) return;
     pthread_mutex_lock(&pool->pool_lock);
     pool->is_shutdown = true;
-    for (size_t i = 0; i < pool->num_threads; i++) {
+    for (size_t i = 0; i < pool->worker_slots; i++) {
         if (pool->workers[i]) {
             pool->workers[i]->should_stop = true;
         }
     }
     /* Wake workers waiting on any shard cond */
-    for (size_t s = 0; s < TTAK_THREAD_POOL_SHARDS; s++) {
+    for (size_t s = 0; s < pool->shard_count; s++) {
         pthread_cond_broadcast(&pool->shards[s].cond);
     }
     pthread_cond_broadcast(&pool->task_cond);
     pthread_mutex_unlock(&pool->pool_lock);
 }
 
+/**
+ * @brief EDF heap order: the earlier deadline ranks higher.
+ */
+static int pool_edf_cmp(const void *a, const void *b) {
+    uint64_t da = ttak_task_get_deadline((const ttak_task_t *)a);
+    uint64_t db = ttak_task_get_deadline((const ttak_task_t *)b);
+    return (da < db) - (da > db);
+}
+
+/** Most distinct NUMA nodes a pool groups shards by (TTAK_MEM_NUMA_NODE's range). */
+#define TTAK_POOL_MAX_NUMA_NODES 256
+
+/** Most CPUs a NUMA-aware pool discovers from the process affinity mask. */
+#define TTAK_POOL_MAX_CPUS 1024
+
+/**
+ * @brief NUMA node of @p cpu, from the cpuN/nodeM link in sysfs; -1 if unknown.
+ */
+static int pool_cpu_node(int cpu) {
+#if defined(__linux__)
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR *dir = opendir(path);
+    if (!dir) return -1;
+    int node = -1;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+/**
+ * @brief Lists the CPUs the process may run on; returns how many were stored.
+ */
+static size_t pool_allowed_cpus(int *out, size_t cap) {
+    size_t n = 0;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE && n < cap; cpu++) {
+        if (CPU_ISSET(cpu, &set)) out[n++] = cpu;
+    }
+#else
+    (void)out;
+    (void)cap;
+#endif
+    return n;
+}
+
+/**
+ * @brief Assigns each worker its node group's shard range and a preferred shard in it.
+ *
+ * Without NUMA awareness there is a single group spanning every shard and
+ * worker i prefers shard ttak_shard_for_worker_n(i).
+ */
+static void pool_assign_shards(ttak_thread_pool_t *pool, _Bool numa_aware) {
+    pool->numa_groups = 1;
+    if (!numa_aware) {
+        for (size_t i = 0; i < pool->worker_slots; i++) {
+            ttak_worker_t *w = pool->workers[i];
+            w->shard_lo = 0;
+            w->shard_hi = pool->shard_count;
+            w->preferred_shard = ttak_shard_for_worker_n(pool->shard_count, i);
+        }
+        return;
+    }
+
+    int nodes[TTAK_POOL_MAX_NUMA_NODES];
+    size_t members[TTAK_POOL_MAX_NUMA_NODES] = {0};
+    size_t groups = 0;
+    for (size_t i = 0; i < pool->worker_slots; i++) {
+        int node = pool->workers[i]->numa_node;
+        size_t g = 0;
+        while (g < groups && nodes[g] != node) g++;
+        if (g == groups && groups < TTAK_POOL_MAX_NUMA_NODES) nodes[groups++] = node;
+    }
+    pool->numa_groups = groups ? groups : 1;
+
+    for (size_t i = 0; i < pool->worker_slots; i++) {
+        ttak_worker_t *w = pool->workers[i];
+        size_t g = 0, lo, hi;
+        while (g < groups && nodes[g] != w->numa_node) g++;
+        if (g == groups) g = groups - 1; /* Nodes past the table share the last group. */
+        ttak_shard_group_range(pool->shard_count, pool->numa_groups, g, &lo, &hi);
+        w->shard_lo = lo;
+        w->shard_hi = hi;
+        w->preferred_shard = lo + members[g]++ % (hi - lo);
+    }
+}
+
+/**
+ * @brief Starts the thread of worker slot @p w.
+ *
+ * Each start builds its own attribute so an elastic worker added long
+ * after creation gets the same small stack and CPU pin as the first ones.
+ *
+ * @return 0, or the pthread_create error.
+ */
+static int pool_start_worker(ttak_thread_pool_t *pool, ttak_worker_t *w) {
+    /* Initialize pthread attribute if available so Windows shim can shrink stacks */
+    pthread_attr_t attr;
+    const pthread_attr_t *attr_for_thread = NULL;
+    if (pthread_attr_init(&attr) == 0) {
+        pthread_attr_setstacksize(&attr, 1024 * 512);
+        attr_for_thread = &attr;
+#if defined(__linux__)
+        /* Pin through the attribute so the worker's first touch is already local. */
+        if (w->cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(w->cpu, &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        }
+#endif
+    }
+    atomic_store_explicit(&w->retire, false, memory_order_relaxed);
+    atomic_store_explicit(&w->state, TTAK_WORKER_SLOT_RUNNING, memory_order_release);
+    int rc = pthread_create(&w->thread, attr_for_thread, ttak_worker_routine, w);
+    if (rc == 0) {
+        atomic_fetch_add_explicit(&pool->live_workers, 1, memory_order_relaxed);
+    } else {
+        atomic_store_explicit(&w->state, TTAK_WORKER_SLOT_FREE, memory_order_relaxed);
+    }
+    if (attr_for_thread) pthread_attr_destroy(&attr);
+    return rc;
+}
+
+/**
+ * @brief Joins elastic workers that retired, freeing their slots.
+ */
+static void pool_reap_workers(ttak_thread_pool_t *pool) {
+    for (size_t i = pool->num_threads; i < pool->worker_slots; i++) {
+        ttak_worker_t *w = pool->workers[i];
+        if (atomic_load_explicit(&w->state, memory_order_acquire) != TTAK_WORKER_SLOT_EXITED) continue;
+        pthread_join(w->thread, NULL);
+        atomic_store_explicit(&w->state, TTAK_WORKER_SLOT_FREE, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&pool->live_workers, 1, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Starts up to @p count workers in free elastic slots.
+ */
+static void pool_grow(ttak_thread_pool_t *pool, size_t count) {
+    for (size_t i = pool->num_threads; i < pool->worker_slots && count > 0; i++) {
+        ttak_worker_t *w = pool->workers[i];
+        if (atomic_load_explicit(&w->state, memory_order_relaxed) != TTAK_WORKER_SLOT_FREE) continue;
+        w->should_stop = false;
+        w->exit_code = 0;
+        if (pool_start_worker(pool, w) != 0) return;
+        count--;
+    }
+}
+
+/**
+ * @brief Asks the highest running elastic worker to exit when next idle.
+ */
+static void pool_shrink(ttak_thread_pool_t *pool) {
+    for (size_t i = pool->worker_slots; i-- > pool->num_threads;) {
+        ttak_worker_t *w = pool->workers[i];
+        if (atomic_load_explicit(&w->state, memory_order_relaxed) != TTAK_WORKER_SLOT_RUNNING) continue;
+        if (atomic_load_explicit(&w->retire, memory_order_relaxed)) continue;
+        atomic_store_explicit(&w->retire, true, memory_order_relaxed);
+        /* A parked worker notices only once woken. */
+        pthread_mutex_lock(&pool->pool_lock);
+        pthread_cond_broadcast(&pool->task_cond);
+        pthread_mutex_unlock(&pool->pool_lock);
+        return;
+    }
+}
+
+/** Tasks waiting in shard queues, EDF heaps and worker deques. */
+static size_t pool_queued_tasks(const ttak_thread_pool_t *pool) {
+    size_t depth = 0;
+    for (size_t s = 0; s < pool->shard_count; s++) {
+        depth += pool->shards[s].queue.get_size((__i_tt_proc_pq_t *)&pool->shards[s].queue);
+        depth += atomic_load_explicit(&pool->shards[s].edf_size, memory_order_relaxed);
+    }
+    /* Batched refills park tasks in deques; a new worker steals those too. */
+    for (size_t i = 0; i < pool->worker_slots; i++) {
+        depth += ttak_ws_deque_size(&pool->workers[i]->deque);
+    }
+    return depth;
+}
+
+/** Tasks run to completion by every worker slot so far. */
+static uint64_t pool_tasks_done(const ttak_thread_pool_t *pool) {
+    uint64_t done = 0;
+    for (size_t i = 0; i < pool->worker_slots; i++) {
+        done += atomic_load_explicit(&pool->workers[i]->tasks_done, memory_order_relaxed);
+    }
+    return done;
+}
+
+/**
+ * @brief Elastic sizing loop.
+ *
+ * Every TTAK_THREAD_POOL_ELASTIC_TICK_NS it estimates how long queued work
+ * waits from Little's law (queued tasks over tasks completed per tick),
+ * smooths that with the burst EWMA, and adds workers while the estimate
+ * stays above @c grow_wait_us. Queued work with no task finished and no
+ * worker left searching means every worker is stuck on a blocking task, so
+ * the pool grows regardless of the estimate; CPU pressure above
+ * TTAK_THREAD_POOL_PSI_CPU_MAX suppresses only the estimate-driven growth.
+ * A burst the routing trackers rate as hot grows it two workers at a time.
+ * After @c shrink_idle_ns with nothing queued and some worker idle
+ * throughout, one extra worker is retired per period.
+ */
+static void *pool_elastic_main(void *arg) {
+    ttak_thread_pool_t *pool = (ttak_thread_pool_t *)arg;
+    uint64_t last_done = 0;
+    uint64_t idle_since = ttak_get_tick_count_ns();
+
+    pthread_mutex_lock(&pool->elastic_lock);
+    while (!pool->elastic_stop) {
+        uint64_t wake = ttak_get_tick_count_ns() + TTAK_THREAD_POOL_ELASTIC_TICK_NS;
+        struct timespec ts;
+        ts.tv_sec = (time_t)(wake / 1000000000ULL);
+        ts.tv_nsec = (long)(wake % 1000000000ULL);
+        pthread_cond_timedwait(&pool->elastic_cond, &pool->elastic_lock, &ts);
+        if (pool->elastic_stop) break;
+        pthread_mutex_unlock(&pool->elastic_lock);
+
+        pool_reap_workers(pool);
+
+        size_t depth = pool_queued_tasks(pool);
+        uint64_t done = pool_tasks_done(pool);
+        uint64_t done_delta = done - last_done;
+        last_done = done;
+
+        uint64_t wait_us = (uint64_t)depth * (TTAK_THREAD_POOL_ELASTIC_TICK_NS / 1000ULL) /
+                           (done_delta ? done_delta : 1U);
+        ttak_burst_update_ewma(&pool->wait_ewma_us, wait_us > UINT32_MAX ? UINT32_MAX : (uint32_t)wait_us);
+
+        size_t live = atomic_load_explicit(&pool->live_workers, memory_order_relaxed);
+        size_t spinning = atomic_load_explicit(&pool->spinning_workers, memory_order_relaxed);
+        size_t parked = atomic_load_explicit(&pool->parked_workers, memory_order_relaxed);
+        uint64_t now = ttak_get_tick_count_ns();
+
+        /* Blocked workers still justify a new one under CPU pressure; slowness does not. */
+        _Bool slow = depth >= live &&
+                     atomic_load_explicit(&pool->wait_ewma_us, memory_order_relaxed) > pool->grow_wait_us &&
+                     ttak_sys_cpu_pressure() < TTAK_THREAD_POOL_PSI_CPU_MAX;
+        _Bool stuck = depth > 0 && done_delta == 0 && spinning == 0 && parked == 0;
+        if (live < pool->worker_slots && (slow || stuck)) {
+            size_t step = 1;
+            for (size_t d = 0; d < TTAK_BURST_DOMAIN_COUNT; d++) {
+                uint32_t mag = atomic_load_explicit(&pool->burst_mag_q10[d], memory_order_relaxed);
+                if (mag > 2U * TTAK_BURST_EWMA_SCALE + TTAK_BURST_EWMA_SCALE / 4U) step = 2;
+            }
+            pool_grow(pool, step);
+            idle_since = now;
+        } else if (depth > 0 || spinning + parked == 0) {
+            idle_since = now;
+        } else if (now - idle_since >= pool->shrink_idle_ns) {
+            pool_shrink(pool);
+            idle_since = now;
+        }
+
+        pthread_mutex_lock(&pool->elastic_lock);
+    }
+    pthread_mutex_unlock(&pool->elastic_lock);
+    return NULL;
+}
+
+void ttak_thread_pool_options_init(ttak_thread_pool_options_t *options) {
+    if (!options) return;
+    memset(options, 0, sizeof(*options));
+}
+
 /**
  * @brief Create a thread pool with the given worker count.
  *
- * Initialises TTAK_THREAD_POOL_SHARDS independent queue shards, each with its
- * own mutex and condition variable, then spawns @p num_threads workers.  Each
- * worker is assigned a preferred shard via ttak_shard_for_worker().
+ * Equivalent to ttak_thread_pool_create_ex() with only @p default_nice set.
  *
  * @param num_threads Number of worker threads.
  * @param default_nice Initial nice value for workers.
@@ -170,12 +459,51 @@ static void pool_force_shutdown(ttak_thread_pool_t *pool) {
  * @return Pointer to the created pool or NULL on failure.
  */
 ttak_thread_pool_t *ttak_thread_pool_create(size_t num_threads, int default_nice, uint64_t now) {
-    /* Initialize pthread attribute if available so Windows shim can shrink stacks */
-    pthread_attr_t attr;
-    const pthread_attr_t *attr_for_threads = NULL;
-    if (pthread_attr_init(&attr) == 0) {
-        pthread_attr_setstacksize(&attr, 1024 * 512);
-        attr_for_threads = &attr;
+    ttak_thread_pool_options_t options;
+    ttak_thread_pool_options_init(&options);
+    options.default_nice = default_nice;
+    return ttak_thread_pool_create_ex(num_threads, &options, now);
+}
+
+/**
+ * @brief Create a thread pool with explicit placement options.
+ *
+ * Sizes the shard set from the larger of @p num_threads and the elastic
+ * ceiling (ttak_shard_count_for_threads()), generates the matching
+ * Latin-square routing table, and initialises each shard's queue, mutex and
+ * condition variable before spawning the workers. Each worker slot is given
+ * a CPU (if any), its node's shard range and a preferred shard within it
+ * (see pool_assign_shards()); only the first @p num_threads start, the rest
+ * are left to the sizing thread (see pool_elastic_main()).
+ *
+ * @param num_threads Number of worker threads.
+ * @param options     Placement options, or NULL for the defaults.
+ * @param now         Timestamp for memory tracking.
+ * @return Pointer to the created pool or NULL on failure.
+ */
+ttak_thread_pool_t *ttak_thread_pool_create_ex(size_t num_threads, const ttak_thread_pool_options_t *options, uint64_t now) {
+    ttak_thread_pool_options_t opts;
+    ttak_thread_pool_options_init(&opts);
+    if (options) opts = *options;
+    int default_nice = opts.default_nice;
+
+    /* Resolve the CPU plan up front so a bad CPU fails before anything is built. */
+    int allowed[TTAK_POOL_MAX_CPUS];
+    const int *cpus = NULL;
+    size_t cpu_count = 0;
+    if (opts.cpus && opts.cpu_count) {
+        for (size_t c = 0; c < opts.cpu_count; c++) {
+#if defined(__linux__)
+            if (opts.cpus[c] < 0 || opts.cpus[c] >= CPU_SETSIZE) return NULL;
+#else
+            if (opts.cpus[c] < 0) return NULL;
+#endif
+        }
+        cpus = opts.cpus;
+        cpu_count = opts.cpu_count;
+    } else if (opts.numa_aware) {
+        cpu_count = pool_allowed_cpus(allowed, TTAK_POOL_MAX_CPUS);
+        cpus = cpu_count ? allowed : NULL;
     }
 
     /* Ensure smart scheduler is ready */
@@ -183,11 +511,18 @@ ttak_thread_pool_t *ttak_thread_pool_create(size_t num_threads, int default_nice
 
     ttak_thread_pool_t *pool = (ttak_thread_pool_t *)ttak_mem_alloc_raw(sizeof(ttak_thread_pool_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
     if (!pool) {
-        if (attr_for_threads) pthread_attr_destroy(&attr);
         return NULL;
     }
 
+    size_t max_threads = opts.max_threads > num_threads ? opts.max_threads : num_threads;
     pool->num_threads = num_threads;
+    pool->worker_slots = max_threads;
+    atomic_init(&pool->live_workers, 0);
+    pool->grow_wait_us = opts.grow_wait_us ? opts.grow_wait_us : TTAK_THREAD_POOL_GROW_WAIT_US;
+    pool->shrink_idle_ns = opts.shrink_idle_ns ? opts.shrink_idle_ns : TTAK_THREAD_POOL_SHRINK_IDLE_NS;
+    atomic_init(&pool->wait_ewma_us, 0);
+    pool->elastic = false;
+    pool->elastic_stop = false;
     pool->creation_ts = now;
     pool->is_shutdown = false;
     for (size_t d = 0; d < TTAK_BURST_DOMAIN_COUNT; d++) {
@@ -196,74 +531,137 @@ ttak_thread_pool_t *ttak_thread_pool_create(size_t num_threads, int default_nice
         atomic_store_explicit(&pool->burst_mag_q10[d], 0U, memory_order_relaxed);
     }
     pool->force_shutdown = pool_force_shutdown;
+    pool->metrics = NULL;
+
+    atomic_store_explicit(&pool->spinning_workers, 0, memory_order_relaxed);
+    atomic_store_explicit(&pool->parked_workers, 0, memory_order_relaxed);
+    ttak_thread_pool_set_idle_config(pool, NULL);
 
-    /* Coarse lock used only for shutdown signalling */
+    /* Coarse lock used for parking and shutdown signalling */
     pthread_mutex_init(&pool->pool_lock, NULL);
+#ifdef _WIN32
     pthread_cond_init(&pool->task_cond, NULL);
+#else
+    /* Park deadlines are computed on CLOCK_MONOTONIC; the condvar must agree. */
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&pool->task_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+#endif
+
+    /* Size the shard set and routing table for this worker count */
+    pool->shard_count = ttak_shard_count_for_threads(max_threads, &pool->shard_log2);
+    pool->shards = (ttak_pool_shard_t *)ttak_mem_alloc_raw(sizeof(ttak_pool_shard_t) * pool->shard_count, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    pool->shard_route = (uint8_t *)ttak_mem_alloc_raw(pool->shard_count * pool->shard_count, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!pool->shards || !pool->shard_route) {
+        fprintf(stderr, "[FATAL] Failed to allocate %zu pool shards\n", pool->shard_count);
+        if (pool->shards) ttak_mem_free(pool->shards);
+        if (pool->shard_route) ttak_mem_free(pool->shard_route);
+        pthread_mutex_destroy(&pool->pool_lock);
+        pthread_cond_destroy(&pool->task_cond);
+        ttak_mem_free(pool);
+        return NULL;
+    }
+    ttak_shard_route_build(pool->shard_route, pool->shard_log2);
 
     /* Initialise all per-shard queues, locks, and condition variables */
-    for (size_t s = 0; s < TTAK_THREAD_POOL_SHARDS; s++) {
+    for (size_t s = 0; s < pool->shard_count; s++) {
         ttak_priority_queue_init(&pool->shards[s].queue);
         pthread_mutex_init(&pool->shards[s].lock, NULL);
         pthread_cond_init(&pool->shards[s].cond, NULL);
+        ttak_heap_tree_init(&pool->shards[s].edf, 16, pool_edf_cmp);
+        atomic_init(&pool->shards[s].edf_size, 0);
     }
+    atomic_init(&pool->shed_count, 0);
 
-    pool->workers = (ttak_worker_t **)ttak_mem_alloc_raw(sizeof(ttak_worker_t *) * num_threads, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    pool->workers = (ttak_worker_t **)ttak_mem_alloc_raw(sizeof(ttak_worker_t *) * max_threads, __TTAK_UNSAFE_MEM_FOREVER__, now);
     if (!pool->workers) {
         fprintf(stderr, "[FATAL] Failed to allocate worker array\n");
-        for (size_t s = 0; s < TTAK_THREAD_POOL_SHARDS; s++) {
+        for (size_t s = 0; s < pool->shard_count; s++) {
             pthread_mutex_destroy(&pool->shards[s].lock);
             pthread_cond_destroy(&pool->shards[s].cond);
+            ttak_heap_tree_destroy(&pool->shards[s].edf, now);
         }
+        ttak_mem_free(pool->shards);
+        ttak_mem_free(pool->shard_route);
         pthread_mutex_destroy(&pool->pool_lock);
         pthread_cond_destroy(&pool->task_cond);
-        if (attr_for_threads) pthread_attr_destroy(&attr);
         ttak_mem_free(pool);
         return NULL;
     }
 
-    for (size_t i = 0; i < num_threads; i++) {
+    /*
+     * Every worker slot and its deque exist before any thread starts
+     * stealing, elastic ones included, so the array never changes under
+     * a thief; an unstarted slot just has an empty deque.
+     */
+    for (size_t i = 0; i < max_threads; i++) {
         pool->workers[i] = (ttak_worker_t *)ttak_mem_alloc_raw(sizeof(ttak_worker_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-        if (!pool->workers[i]) {
+        if (!pool->workers[i] || !ttak_ws_deque_init(&pool->workers[i]->deque, 0)) {
             fprintf(stderr, "[FATAL] Failed to allocate worker %zu\n", i);
-            pool->num_threads = i;
+            pool->worker_slots = i;
             pool_force_shutdown(pool);
-            if (attr_for_threads) pthread_attr_destroy(&attr);
-            return NULL;
+                return NULL;
         }
         pool->workers[i]->pool = pool;
         pool->workers[i]->should_stop = false;
         pool->workers[i]->exit_code = 0;
-        /* Assign shard affinity: spread workers evenly across shards */
-        pool->workers[i]->preferred_shard = ttak_shard_for_worker(i);
+        pool->workers[i]->cpu = cpus ? cpus[i % cpu_count] : -1;
+        pool->workers[i]->numa_node = cpus ? pool_cpu_node(pool->workers[i]->cpu) : -1;
 
         pool->workers[i]->wrapper = (ttak_worker_wrapper_t *)ttak_mem_alloc_raw(sizeof(ttak_worker_wrapper_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
         if (!pool->workers[i]->wrapper) {
             fprintf(stderr, "[FATAL] Failed to allocate worker wrapper %zu\n", i);
             ttak_mem_free(pool->workers[i]);
             pool->workers[i] = NULL;
-            pool->num_threads = i;
+            pool->worker_slots = i;
             pool_force_shutdown(pool);
-            if (attr_for_threads) pthread_attr_destroy(&attr);
-            return NULL;
+                return NULL;
         }
         pool->workers[i]->wrapper->nice_val = default_nice;
         pool->workers[i]->wrapper->ts = now;
         /* Pre-initialize jump magic so abort checks don't fail before first setjmp */
         pool->workers[i]->wrapper->jmp_magic = 0;
         pool->workers[i]->wrapper->jmp_tid = 0;
+        pool->workers[i]->steal_seed = 0x9E3779B97F4A7C15ULL * (uint64_t)(i + 1);
+        atomic_init(&pool->workers[i]->state, TTAK_WORKER_SLOT_FREE);
+        atomic_init(&pool->workers[i]->retire, false);
+        atomic_init(&pool->workers[i]->tasks_done, 0);
+    }
 
-        int rc = pthread_create(&pool->workers[i]->thread, attr_for_threads, ttak_worker_routine, pool->workers[i]);
+    /* Assign shard affinity: spread workers evenly across their node's shards */
+    pool_assign_shards(pool, opts.numa_aware);
+
+    for (size_t i = 0; i < num_threads; i++) {
+        int rc = pool_start_worker(pool, pool->workers[i]);
         if (rc != 0) {
             fprintf(stderr, "[FATAL] Failed to create worker thread %zu: %d\n", i, rc);
-            pool->num_threads = i;
+            pool->worker_slots = i;
             pool_force_shutdown(pool);
-            if (attr_for_threads) pthread_attr_destroy(&attr);
-            return NULL;
+                return NULL;
+        }
+    }
+
+    if (max_threads > num_threads) {
+        pthread_mutex_init(&pool->elastic_lock, NULL);
+#ifdef _WIN32
+        pthread_cond_init(&pool->elastic_cond, NULL);
+#else
+        pthread_condattr_t elastic_attr;
+        pthread_condattr_init(&elastic_attr);
+        pthread_condattr_setclock(&elastic_attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&pool->elastic_cond, &elastic_attr);
+        pthread_condattr_destroy(&elastic_attr);
+#endif
+        pool->elastic = pthread_create(&pool->elastic_thread, NULL, pool_elastic_main, pool) == 0;
+        if (!pool->elastic) {
+            /* Still a working pool, just a fixed one. */
+            pthread_mutex_destroy(&pool->elastic_lock);
+            pthread_cond_destroy(&pool->elastic_cond);
         }
     }
 
-    if (attr_for_threads) pthread_attr_destroy(&attr);
     return pool;
 }
 
@@ -303,13 +701,241 @@ ttak_future_t *ttak_thread_pool_submit_task(ttak_thread_pool_t *pool, void *(*fu
     return ttak_promise_get_future(promise);
 }
 
+ttak_future_t *ttak_thread_pool_submit_deadline(ttak_thread_pool_t *pool, void *(*func)(void *), void *arg,
+                                                uint64_t deadline_ts, uint64_t now) {
+    if (!pool || deadline_ts == 0) return NULL;
+
+    ttak_promise_t *promise = ttak_promise_create(now);
+    if (!promise) return NULL;
+    ttak_task_t *task = ttak_task_create((ttak_task_func_t)func, arg, promise, now);
+    if (!task) {
+        ttak_mem_free(promise->future);
+        ttak_mem_free(promise);
+        return NULL;
+    }
+    ttak_task_set_deadline(task, deadline_ts);
+    if (!ttak_thread_pool_schedule_task(pool, task, 0, now)) {
+        ttak_task_destroy(task, now);
+        ttak_mem_free(promise->future);
+        ttak_mem_free(promise);
+        return NULL;
+    }
+    return ttak_promise_get_future(promise);
+}
+
+size_t ttak_thread_pool_live_workers(const ttak_thread_pool_t *pool) {
+    return pool ? atomic_load_explicit(&pool->live_workers, memory_order_relaxed) : 0;
+}
+
+uint64_t ttak_thread_pool_shed_count(const ttak_thread_pool_t *pool) {
+    return pool ? atomic_load_explicit(&pool->shed_count, memory_order_relaxed) : 0;
+}
+
+/* --- Metrics --- */
+
+static double pool_metric_live(void *arg) {
+    ttak_thread_pool_t *pool = arg;
+    return (double)atomic_load_explicit(&pool->live_workers, memory_order_relaxed);
+}
+
+static double pool_metric_spinning(void *arg) {
+    ttak_thread_pool_t *pool = arg;
+    return (double)atomic_load_explicit(&pool->spinning_workers, memory_order_relaxed);
+}
+
+static double pool_metric_parked(void *arg) {
+    ttak_thread_pool_t *pool = arg;
+    return (double)atomic_load_explicit(&pool->parked_workers, memory_order_relaxed);
+}
+
+static double pool_metric_queued(void *arg) {
+    return (double)pool_queued_tasks(arg);
+}
+
+static double pool_metric_done(void *arg) {
+    return (double)pool_tasks_done(arg);
+}
+
+static double pool_metric_shed(void *arg) {
+    return (double)ttak_thread_pool_shed_count(arg);
+}
+
+static double pool_metric_wait(void *arg) {
+    ttak_thread_pool_t *pool = arg;
+    return (double)atomic_load_explicit(&pool->wait_ewma_us, memory_order_relaxed);
+}
+
+/* The burst gauges need the pool and a domain; the domain rides in the low pointer bits. */
+static double pool_metric_burst(void *arg) {
+    uintptr_t tagged = (uintptr_t)arg;
+    ttak_thread_pool_t *pool = (ttak_thread_pool_t *)(tagged & ~(uintptr_t)3U);
+    size_t d = (size_t)(tagged & 3U);
+    return (double)atomic_load_explicit(&pool->burst_mag_q10[d], memory_order_relaxed) / TTAK_BURST_EWMA_SCALE;
+}
+
+size_t ttak_thread_pool_export_metrics(ttak_thread_pool_t *pool, ttak_metrics_registry_t *reg, const char *labels) {
+    if (!pool || !reg || pool->metrics) return 0;
+    static const struct {
+        ttak_metric_type_t type;
+        const char *name;
+        const char *help;
+        ttak_metric_read_fn read;
+    } series[] = {
+        { TTAK_METRIC_GAUGE, "ttak_pool_live_workers", "Worker threads running.", pool_metric_live },
+        { TTAK_METRIC_GAUGE, "ttak_pool_spinning_workers", "Idle workers still spinning or yielding.", pool_metric_spinning },
+        { TTAK_METRIC_GAUGE, "ttak_pool_parked_workers", "Idle workers parked on the pool condition.", pool_metric_parked },
+        { TTAK_METRIC_GAUGE, "ttak_pool_queued_tasks", "Tasks waiting in shards, deadline heaps and deques.", pool_metric_queued },
+        { TTAK_METRIC_COUNTER, "ttak_pool_tasks_done_total", "Tasks run to completion.", pool_metric_done },
+        { TTAK_METRIC_COUNTER, "ttak_pool_shed_total", "Deadline tasks dropped as already late.", pool_metric_shed },
+        { TTAK_METRIC_GAUGE, "ttak_pool_wait_ewma_us", "Smoothed estimate of queue wait in microseconds.", pool_metric_wait },
+    };
+    size_t n = 0;
+    for (size_t i = 0; i < sizeof(series) / sizeof(series[0]); i++) {
+        if (ttak_metrics_register_fn(reg, series[i].type, series[i].name, series[i].help, labels,
+                                     series[i].read, pool, pool)) {
+            n++;
+        }
+    }
+    _Static_assert(TTAK_BURST_DOMAIN_COUNT <= 4, "burst domain must fit in two pointer bits");
+    for (size_t d = 0; d < TTAK_BURST_DOMAIN_COUNT; d++) {
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%s%sdomain=\"%zu\"", labels ? labels : "", labels && *labels ? "," : "", d);
+        if (ttak_metrics_register_fn(reg, TTAK_METRIC_GAUGE, "ttak_pool_burst_magnitude", "Burst EWMA magnitude per domain (1.0 = uniform).",
+                                     buf, pool_metric_burst, (void *)((uintptr_t)pool | d), pool)) {
+            n++;
+        }
+    }
+    pool->metrics = reg;
+    return n;
+}
+
+_Bool ttak_thread_pool_submit_detached(ttak_thread_pool_t *pool, void *(*func)(void *), void *arg, int priority, uint64_t now) {
+    if (!pool) return 0;
+    ttak_task_t *task = ttak_task_create((ttak_task_func_t)func, arg, NULL, now);
+    if (!task) return 0;
+    int adjusted_priority = ttak_scheduler_get_adjusted_priority(task, priority);
+    if (!ttak_thread_pool_schedule_task(pool, task, adjusted_priority, now)) {
+        ttak_task_destroy(task, now);
+        return 0;
+    }
+    return 1;
+}
+
+_Bool ttak_thread_pool_submit_wg(ttak_thread_pool_t *pool, ttak_wait_group_t *wg, void *(*func)(void *), void *arg,
+                                 int priority, uint64_t now) {
+    if (!pool || !wg) return 0;
+    ttak_task_t *task = ttak_task_create((ttak_task_func_t)func, arg, NULL, now);
+    if (!task) return 0;
+    ttak_task_set_wait_group(task, wg);
+    int adjusted_priority = ttak_scheduler_get_adjusted_priority(task, priority);
+    /* Count the task before a worker can possibly finish it. */
+    ttak_wait_group_add(wg, 1);
+    if (!ttak_thread_pool_schedule_task(pool, task, adjusted_priority, now)) {
+        ttak_task_destroy(task, now);
+        ttak_wait_group_done(wg);
+        return 0;
+    }
+    return 1;
+}
+
+void ttak_thread_pool_idle_config_init(ttak_thread_pool_idle_config_t *config) {
+    if (!config) return;
+    config->spin_rounds = TTAK_THREAD_POOL_SPIN_ROUNDS;
+    config->max_pauses = TTAK_THREAD_POOL_MAX_PAUSES;
+    config->yield_rounds = TTAK_THREAD_POOL_YIELD_ROUNDS;
+    config->park_ns = TTAK_THREAD_POOL_PARK_NS;
+}
+
+void ttak_thread_pool_set_idle_config(ttak_thread_pool_t *pool, const ttak_thread_pool_idle_config_t *config) {
+    if (!pool) return;
+    ttak_thread_pool_idle_config_t cfg;
+    ttak_thread_pool_idle_config_init(&cfg);
+    if (config) {
+        cfg.spin_rounds = config->spin_rounds;
+        cfg.max_pauses = config->max_pauses ? config->max_pauses : 1U;
+        cfg.yield_rounds = config->yield_rounds;
+        if (config->park_ns) cfg.park_ns = config->park_ns;
+    }
+    atomic_store_explicit(&pool->idle_spin_rounds, cfg.spin_rounds, memory_order_relaxed);
+    atomic_store_explicit(&pool->idle_max_pauses, cfg.max_pauses, memory_order_relaxed);
+    atomic_store_explicit(&pool->idle_yield_rounds, cfg.yield_rounds, memory_order_relaxed);
+    atomic_store_explicit(&pool->idle_park_ns, cfg.park_ns, memory_order_relaxed);
+}
+
+void ttak_thread_pool_get_idle_config(const ttak_thread_pool_t *pool, ttak_thread_pool_idle_config_t *config) {
+    if (!config) return;
+    if (!pool) {
+        ttak_thread_pool_idle_config_init(config);
+        return;
+    }
+    config->spin_rounds = atomic_load_explicit(&pool->idle_spin_rounds, memory_order_relaxed);
+    config->max_pauses = atomic_load_explicit(&pool->idle_max_pauses, memory_order_relaxed);
+    config->yield_rounds = atomic_load_explicit(&pool->idle_yield_rounds, memory_order_relaxed);
+    config->park_ns = atomic_load_explicit(&pool->idle_park_ns, memory_order_relaxed);
+}
+
+/**
+ * @brief Wakes up to @p tasks parked workers for newly queued work.
+ *
+ * Idle workers that are still spinning will find the work on their own, so
+ * the condition variable is only touched when every idle worker is parked.
+ * The seq_cst loads pair with the parking worker's seq_cst increment: either
+ * the worker's final rescan sees the queued task or this load sees it parked.
+ */
+static void pool_wake_idle(ttak_thread_pool_t *pool, size_t tasks) {
+    size_t parked = atomic_load_explicit(&pool->parked_workers, memory_order_seq_cst);
+    if (parked == 0) return;
+    if (atomic_load_explicit(&pool->spinning_workers, memory_order_seq_cst) != 0) return;
+    pthread_mutex_lock(&pool->pool_lock);
+    if (tasks >= parked) {
+        pthread_cond_broadcast(&pool->task_cond);
+    } else {
+        for (size_t i = 0; i < tasks; i++) pthread_cond_signal(&pool->task_cond);
+    }
+    pthread_mutex_unlock(&pool->pool_lock);
+}
+
+/**
+ * @brief Routes @p task to its shard and enqueues it without waking anyone.
+ *
+ * @return 0 if the pool refused the task.
+ */
+static _Bool pool_enqueue(ttak_thread_pool_t *pool, ttak_task_t *task, int priority, uint64_t now) {
+    /* Abort early without touching any lock */
+    if (pool->is_shutdown) return 0;
+
+    /* Deterministic shard selection via hash → coordinate → table lookup */
+    size_t shard_idx = ttak_pool_select_shard_with_burst(pool, task);
+    ttak_pool_shard_t *shard = &pool->shards[shard_idx];
+    TTAK_TRACE(TTAK_TRACE_TASK_SUBMIT, (uintptr_t)task, shard_idx);
+
+    if (ttak_task_get_deadline(task) != 0) {
+        pthread_mutex_lock(&shard->lock);
+        size_t before = shard->edf.size;
+        ttak_heap_tree_push(&shard->edf, task, now);
+        _Bool queued = shard->edf.size != before;
+        /* seq_cst: pairs with the parking worker's rescan, like the bitmap. */
+        if (queued) atomic_store_explicit(&shard->edf_size, shard->edf.size, memory_order_seq_cst);
+        pthread_mutex_unlock(&shard->lock);
+        return queued;
+    }
+
+    /* A worker feeding its own shard keeps the task local, lock-free. */
+    ttak_worker_t *self = ttak_worker_current();
+    if (self && self->pool == pool && self->preferred_shard == shard_idx &&
+        ttak_ws_deque_push(&self->deque, task)) {
+        return 1;
+    }
+
+    return shard->queue.push(&shard->queue, task, priority, now);
+}
+
 /**
  * @brief Queue a prepared task for execution using deterministic shard routing.
  *
  * The task's hash is mapped to (row, col) coordinates via Fibonacci hashing,
- * then indexed into the Latin-square routing table to select a shard.  Only
- * the selected shard's lock is held during the push, keeping the critical
- * section small.
+ * then indexed into the Latin-square routing table to select a shard.  The
+ * shard queue is lock-free, so the push takes no lock at all.
  *
  * When the task hash is 0 (unknown), the task falls back to shard 0.
  *
@@ -317,38 +943,132 @@ ttak_future_t *ttak_thread_pool_submit_task(ttak_thread_pool_t *pool, void *(*fu
  * @param task     Task instance created earlier.
  * @param priority Priority hint.
  * @param now      Timestamp for queue bookkeeping.
- * @return true if scheduled, false if the pool is shutting down.
+ * @return true if scheduled, false if the pool is shutting down or the
+ *         shard's priority band is full.
  */
 _Bool ttak_thread_pool_schedule_task(ttak_thread_pool_t *pool, ttak_task_t *task, int priority, uint64_t now) {
     if (!pool || !task) return 0;
 
-    /* Abort early without touching any lock */
-    if (pool->is_shutdown) return 0;
+    if (!pool_enqueue(pool, task, priority, now)) return 0;
+    pool_wake_idle(pool, 1);
+    return 1;
+}
 
-    /* Deterministic shard selection via hash → coordinate → table lookup */
-    size_t shard_idx = ttak_pool_select_shard_with_burst(pool, task);
-    ttak_pool_shard_t *shard = &pool->shards[shard_idx];
+/**
+ * @brief One call of a batch; its task runs batch_item_run() on it.
+ */
+typedef struct {
+    ttak_pool_batch_t *batch;
+    void *(*func)(void *);
+    void *arg;
+    void *result;
+} ttak_pool_batch_slot_t;
 
-    pthread_mutex_lock(&shard->lock);
-    if (pool->is_shutdown) {
-        pthread_mutex_unlock(&shard->lock);
-        return 0;
+struct ttak_pool_batch {
+    _Atomic size_t pending;     /**< Submitted calls still running or queued. */
+    size_t submitted;
+    _Bool done;                 /**< Guarded by @c mutex. */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    ttak_pool_batch_slot_t slots[];
+};
+
+static void batch_finish(ttak_pool_batch_t *batch, size_t calls) {
+    if (atomic_fetch_sub_explicit(&batch->pending, calls, memory_order_acq_rel) != calls) return;
+    pthread_mutex_lock(&batch->mutex);
+    batch->done = true;
+    pthread_cond_broadcast(&batch->cond);
+    pthread_mutex_unlock(&batch->mutex);
+}
+
+static void *batch_item_run(void *arg) {
+    ttak_pool_batch_slot_t *slot = (ttak_pool_batch_slot_t *)arg;
+    slot->result = slot->func(slot->arg);
+    batch_finish(slot->batch, 1);
+    return NULL;
+}
+
+ttak_pool_batch_t *ttak_thread_pool_submit_batch(ttak_thread_pool_t *pool, const ttak_pool_batch_item_t *items,
+                                                 size_t count, int priority, uint64_t now) {
+    if (!pool || !items || count == 0 || pool->is_shutdown) return NULL;
+    if (count > (SIZE_MAX - sizeof(ttak_pool_batch_t)) / sizeof(ttak_pool_batch_slot_t)) return NULL;
+
+    ttak_pool_batch_t *batch = (ttak_pool_batch_t *)ttak_mem_alloc_raw(
+        sizeof(ttak_pool_batch_t) + count * sizeof(ttak_pool_batch_slot_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!batch) return NULL;
+    /* One reference for the submitter keeps the batch open until all calls are queued. */
+    atomic_init(&batch->pending, count + 1);
+    batch->submitted = 0;
+    batch->done = false;
+    pthread_mutex_init(&batch->mutex, NULL);
+    pthread_cond_init(&batch->cond, NULL);
+
+    size_t i = 0;
+    for (; i < count; i++) {
+        ttak_pool_batch_slot_t *slot = &batch->slots[i];
+        slot->batch = batch;
+        slot->func = items[i].func;
+        slot->arg = items[i].arg;
+        slot->result = NULL;
+
+        ttak_task_t *task = ttak_task_create(batch_item_run, slot, NULL, now);
+        if (!task) break;
+        /* Route and record history as the wrapped call, not the trampoline. */
+        ttak_task_set_hash(task, ttak_task_hash_of((ttak_task_func_t)slot->func, slot->arg));
+        if (!pool_enqueue(pool, task, priority, now)) {
+            ttak_task_destroy(task, now);
+            break;
+        }
     }
+    batch->submitted = i;
 
-    shard->queue.push(&shard->queue, task, priority, now);
-    pthread_cond_broadcast(&shard->cond);
-    pthread_mutex_unlock(&shard->lock);
+    /* One wake-up pass for the whole batch. */
+    if (i) pool_wake_idle(pool, i);
 
-    /*
-     * Wake idle workers on other shards as a work-stealing hint without
-     * keeping this shard's mutex locked.
-     */
-    for (size_t s = 0; s < TTAK_THREAD_POOL_SHARDS; s++) {
-        if (s == shard_idx) continue;
-        pthread_cond_broadcast(&pool->shards[s].cond);
+    if (i == 0) {
+        pthread_mutex_destroy(&batch->mutex);
+        pthread_cond_destroy(&batch->cond);
+        ttak_mem_free(batch);
+        return NULL;
     }
+    /* Drop the unsubmitted calls and the submitter's reference together. */
+    batch_finish(batch, count - i + 1);
+    return batch;
+}
 
-    return 1;
+size_t ttak_pool_batch_submitted(const ttak_pool_batch_t *batch) {
+    return batch ? batch->submitted : 0;
+}
+
+_Bool ttak_pool_batch_done(ttak_pool_batch_t *batch) {
+    if (!batch) return true;
+    pthread_mutex_lock(&batch->mutex);
+    _Bool done = batch->done;
+    pthread_mutex_unlock(&batch->mutex);
+    return done;
+}
+
+size_t ttak_pool_batch_wait(ttak_pool_batch_t *batch) {
+    if (!batch) return 0;
+    pthread_mutex_lock(&batch->mutex);
+    while (!batch->done) {
+        pthread_cond_wait(&batch->cond, &batch->mutex);
+    }
+    pthread_mutex_unlock(&batch->mutex);
+    return batch->submitted;
+}
+
+void *ttak_pool_batch_result(const ttak_pool_batch_t *batch, size_t index) {
+    if (!batch || index >= batch->submitted) return NULL;
+    return batch->slots[index].result;
+}
+
+void ttak_pool_batch_destroy(ttak_pool_batch_t *batch) {
+    if (!batch) return;
+    ttak_pool_batch_wait(batch);
+    pthread_mutex_destroy(&batch->mutex);
+    pthread_cond_destroy(&batch->cond);
+    ttak_mem_free(batch);
 }
 
 /**
@@ -359,10 +1079,34 @@ _Bool ttak_thread_pool_schedule_task(ttak_thread_pool_t *pool, ttak_task_t *task
 void ttak_thread_pool_destroy(ttak_thread_pool_t *pool) {
     if (!pool) return;
 
+    /* No scrape may read the pool once teardown starts. */
+    if (pool->metrics) ttak_metrics_unregister_owner(pool->metrics, pool);
+
+    /* Stop resizing before the worker set is torn down. */
+    if (pool->elastic) {
+        pthread_mutex_lock(&pool->elastic_lock);
+        pool->elastic_stop = true;
+        pthread_cond_signal(&pool->elastic_cond);
+        pthread_mutex_unlock(&pool->elastic_lock);
+        pthread_join(pool->elastic_thread, NULL);
+        pthread_mutex_destroy(&pool->elastic_lock);
+        pthread_cond_destroy(&pool->elastic_cond);
+    }
+
     pool_force_shutdown(pool);
 
-    for (size_t i = 0; i < pool->num_threads; i++) {
-        pthread_join(pool->workers[i]->thread, NULL);
+    for (size_t i = 0; i < pool->worker_slots; i++) {
+        if (atomic_load_explicit(&pool->workers[i]->state, memory_order_acquire) != TTAK_WORKER_SLOT_FREE) {
+            pthread_join(pool->workers[i]->thread, NULL);
+        }
+    }
+    /* Deques are stolen from until the last worker exits. */
+    for (size_t i = 0; i < pool->worker_slots; i++) {
+        ttak_task_t *t;
+        while ((t = (ttak_task_t *)ttak_ws_deque_pop(&pool->workers[i]->deque)) != NULL) {
+            ttak_task_destroy(t, pool->creation_ts);
+        }
+        ttak_ws_deque_destroy(&pool->workers[i]->deque);
         ttak_mem_free(pool->workers[i]->wrapper);
         ttak_mem_free(pool->workers[i]);
     }
@@ -372,14 +1116,21 @@ void ttak_thread_pool_destroy(ttak_thread_pool_t *pool) {
     pthread_cond_destroy(&pool->task_cond);
 
     /* Drain any remaining tasks from each shard and tear down shard resources */
-    for (size_t s = 0; s < TTAK_THREAD_POOL_SHARDS; s++) {
+    for (size_t s = 0; s < pool->shard_count; s++) {
         ttak_task_t *t;
         while ((t = pool->shards[s].queue.pop(&pool->shards[s].queue, pool->creation_ts)) != NULL) {
             ttak_task_destroy(t, pool->creation_ts);
         }
+        ttak_priority_queue_destroy(&pool->shards[s].queue);
+        while ((t = (ttak_task_t *)ttak_heap_tree_pop(&pool->shards[s].edf, pool->creation_ts)) != NULL) {
+            ttak_task_destroy(t, pool->creation_ts);
+        }
+        ttak_heap_tree_destroy(&pool->shards[s].edf, pool->creation_ts);
         pthread_mutex_destroy(&pool->shards[s].lock);
         pthread_cond_destroy(&pool->shards[s].cond);
     }
+    ttak_mem_free(pool->shards);
+    ttak_mem_free(pool->shard_route);
 
     ttak_mem_free(pool);
 }
@@ -7,11 +7,22 @@
  * rather than terminating the whole process.
  *
  * Workers use shard-affine dequeuing: each worker has a preferred shard
- * derived from its index (ttak_shard_for_worker()).  It first tries to pop
- * from that shard under the shard's own lock.  If the shard is empty the
- * worker performs work stealing: it scans the remaining shards in rotation
- * order until it finds a task or determines all shards are empty, at which
- * point it blocks on its preferred shard's condition variable.
+ * derived from its index (ttak_shard_for_worker()) and a Chase-Lev deque of
+ * tasks it owns. A worker runs from its deque first; when that is empty it
+ * moves up to TTAK_THREAD_POOL_BATCH tasks from its preferred shard into the
+ * deque straight from the shard's lock-free queue. Only then does it steal: first from the
+ * deques of randomly chosen workers, then from the other shards' queues. A
+ * burst routed to one shard is thereby spread across every idle worker.
+ *
+ * Deadline tasks sit apart in each shard's EDF heap and are taken before
+ * anything else, from the preferred shard first and then while stealing;
+ * one found already past its deadline is shed rather than run.
+ *
+ * A worker that finds nothing backs off in three phases: pause-instruction
+ * spinning with exponential backoff, sched_yield(), and finally parking on
+ * the pool's condition variable. The pool counts spinning and parked
+ * workers so submitters only signal when nobody is left spinning, and the
+ * last spinner to find work wakes one parked worker to take over the search.
  */
 
 #include <ttak/thread/worker.h>
@@ -20,6 +31,8 @@
 #include <ttak/mem/epoch.h>
 #include <ttak/timing/timing.h>
 #include <ttak/priority/scheduler.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/log/trace.h>
 #ifdef _WIN32
     #include <windows.h>
 #else
@@ -54,41 +67,241 @@ void ttak_worker_abort(void) {
     }
 }
 
+ttak_worker_t *ttak_worker_current(void) {
+    return get_current_worker();
+}
+
+int ttak_worker_numa_node(void) {
+    ttak_worker_t *worker = get_current_worker();
+    return worker ? worker->numa_node : -1;
+}
+
+ttak_detachable_context_t *ttak_worker_detachable_context(void) {
+    ttak_worker_t *worker = get_current_worker();
+    return worker ? &worker->detachable : NULL;
+}
+
 static void threaded_function_wrapper(ttak_worker_t *worker, ttak_task_t *task) {
     (void)worker;
     if (task) {
         uint64_t start_time = ttak_get_tick_count();
         ttak_task_set_start_ts(task, start_time);
+        TTAK_TRACE(TTAK_TRACE_TASK_START, (uintptr_t)task, 0);
         ttak_task_execute(task, start_time);
+        TTAK_TRACE(TTAK_TRACE_TASK_END, (uintptr_t)task, 0);
         uint64_t end_time = ttak_get_tick_count();
         ttak_scheduler_record_execution(task, (end_time >= start_time) ? (end_time - start_time) : 0);
     }
 }
 
+static inline uint64_t worker_next_random(ttak_worker_t *self) {
+    uint64_t x = self->steal_seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    self->steal_seed = x;
+    return x;
+}
+
+/**
+ * @brief Moves up to TTAK_THREAD_POOL_BATCH tasks from @p shard into the deque.
+ *
+ * The queue yields tasks most urgent first; they are pushed in reverse so
+ * the owner pops them in that order and thieves take the least urgent.
+ *
+ * @return The most urgent task, already removed from the deque, or NULL.
+ */
+static ttak_task_t *worker_refill_from_shard(ttak_worker_t *self, ttak_pool_shard_t *shard, uint64_t now) {
+    ttak_task_t *batch[TTAK_THREAD_POOL_BATCH];
+    size_t n = 0;
+    while (n < TTAK_THREAD_POOL_BATCH) {
+        ttak_task_t *task = shard->queue.pop(&shard->queue, now);
+        if (!task) break;
+        batch[n++] = task;
+    }
+    if (n == 0) return NULL;
+
+    while (n > 1) {
+        ttak_task_t *task = batch[--n];
+        if (!ttak_ws_deque_push(&self->deque, task)) {
+            /*
+             * No room to grow: hand it back to the shard rather than drop it.
+             * The slot it came from frees up as soon as any worker pops.
+             */
+            while (!shard->queue.push(&shard->queue, task, 0, now)) sched_yield();
+        }
+    }
+    return batch[0];
+}
+
+/**
+ * @brief Pops the earliest-deadline task of @p shard, shedding late ones.
+ *
+ * A task whose deadline has already passed is completed without running
+ * (its future resolves to NULL) and counted in the pool's shed counter.
+ */
+static ttak_task_t *worker_pop_edf(ttak_thread_pool_t *pool, ttak_pool_shard_t *shard) {
+    while (atomic_load_explicit(&shard->edf_size, memory_order_relaxed) != 0) {
+        pthread_mutex_lock(&shard->lock);
+        ttak_task_t *task = (ttak_task_t *)ttak_heap_tree_pop(&shard->edf, 0);
+        atomic_store_explicit(&shard->edf_size, shard->edf.size, memory_order_relaxed);
+        pthread_mutex_unlock(&shard->lock);
+        if (!task) return NULL;
+
+        uint64_t now = ttak_get_tick_count();
+        if (now < ttak_task_get_deadline(task)) return task;
+        ttak_task_shed(task, now);
+        ttak_task_destroy(task, now);
+        atomic_fetch_add_explicit(&pool->shed_count, 1, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Steals from the deque of a randomly chosen worker, then from the rest in order.
+ *
+ * In a NUMA-aware pool every worker on the thief's node is tried before
+ * any remote one.
+ */
+static ttak_task_t *worker_steal_from_workers(ttak_worker_t *self, ttak_thread_pool_t *pool) {
+    size_t n = pool->worker_slots;
+    if (n < 2) return NULL;
+    _Bool split = pool->numa_groups > 1;
+    size_t start = (size_t)(worker_next_random(self) % n);
+    for (int pass = 0; pass < (split ? 2 : 1); pass++) {
+        for (size_t k = 0; k < n; k++) {
+            ttak_worker_t *victim = pool->workers[(start + k) % n];
+            if (!victim || victim == self) continue;
+            if (split && ((victim->numa_node == self->numa_node) != (pass == 0))) continue;
+            ttak_task_t *task = (ttak_task_t *)ttak_ws_deque_steal(&victim->deque);
+            if (task) return task;
+        }
+    }
+    return NULL;
+}
+
 /**
  * @brief Try to steal a task from any shard other than @p skip_shard.
  *
- * Scans shards in index order (wrapping around @p skip_shard) and returns
- * the first task found, or NULL if all shards are empty.  Each try-lock
- * attempt is non-blocking so as not to starve the preferred shard.
+ * Starts at a random shard of the worker's own node group, then moves on to
+ * the remaining shards, and returns the first task found, or NULL if all
+ * shards are empty.  Shard queues are lock-free, so a busy shard costs
+ * a failed CAS rather than a blocked thread.
  *
+ * @param self       Stealing worker.
  * @param pool       Pool to steal from.
  * @param skip_shard Shard index already tried (the preferred shard).
  * @param now        Timestamp for queue operations.
  * @return Stolen task, or NULL.
  */
-static ttak_task_t *worker_steal_task(ttak_thread_pool_t *pool, size_t skip_shard, uint64_t now) {
-    for (size_t s = 0; s < TTAK_THREAD_POOL_SHARDS; s++) {
+static ttak_task_t *worker_steal_task(ttak_worker_t *self, ttak_thread_pool_t *pool, size_t skip_shard, uint64_t now) {
+    size_t lo = self->shard_lo;
+    size_t span = self->shard_hi - lo;
+    size_t start = (size_t)(worker_next_random(self) % span);
+    for (size_t k = 0; k < span; k++) {
+        size_t s = lo + (start + k) % span;
         if (s == skip_shard) continue;
         ttak_pool_shard_t *shard = &pool->shards[s];
-        if (pthread_mutex_trylock(&shard->lock) != 0) continue;
-        ttak_task_t *task = shard->queue.pop(&shard->queue, now);
-        pthread_mutex_unlock(&shard->lock);
+        ttak_task_t *task = worker_pop_edf(pool, shard);
+        if (!task) task = shard->queue.pop(&shard->queue, now);
+        if (task) return task;
+    }
+    if (span == pool->shard_count) return NULL;
+
+    size_t mask = pool->shard_count - 1U;
+    start = (size_t)worker_next_random(self) & mask;
+    for (size_t k = 0; k < pool->shard_count; k++) {
+        size_t s = (start + k) & mask;
+        if (s >= lo && s < self->shard_hi) continue;
+        ttak_pool_shard_t *shard = &pool->shards[s];
+        ttak_task_t *task = worker_pop_edf(pool, shard);
+        if (!task) task = shard->queue.pop(&shard->queue, now);
         if (task) return task;
     }
     return NULL;
 }
 
+/**
+ * @brief Returns true if any shard or deque of @p pool may hold a task.
+ *
+ * The seq_cst loads of the non-empty bitmaps pair with the seq_cst update a
+ * push makes, so a parking worker cannot miss a task whose submitter saw
+ * no parked workers.
+ */
+static _Bool worker_pool_has_work(ttak_thread_pool_t *pool) {
+    for (size_t s = 0; s < pool->shard_count; s++) {
+        if (atomic_load_explicit(&pool->shards[s].queue.nonempty, memory_order_seq_cst) != 0) return 1;
+        if (atomic_load_explicit(&pool->shards[s].edf_size, memory_order_seq_cst) != 0) return 1;
+    }
+    for (size_t i = 0; i < pool->worker_slots; i++) {
+        ttak_worker_t *w = pool->workers[i];
+        if (w && ttak_ws_deque_size(&w->deque) > 0) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sleeps on the pool condition variable until signalled or the park timeout.
+ *
+ * Called with the worker counted as spinning; it is counted as parked for
+ * the duration and as spinning again on return.
+ */
+static void worker_park(ttak_worker_t *self, ttak_thread_pool_t *pool) {
+    uint64_t park_ns = atomic_load_explicit(&pool->idle_park_ns, memory_order_relaxed);
+    pthread_mutex_lock(&pool->pool_lock);
+    atomic_fetch_add_explicit(&pool->parked_workers, 1, memory_order_seq_cst);
+    atomic_fetch_sub_explicit(&pool->spinning_workers, 1, memory_order_seq_cst);
+    if (!self->should_stop && !pool->is_shutdown && !worker_pool_has_work(pool)) {
+        uint64_t wake = ttak_get_tick_count_ns() + park_ns;
+        struct timespec ts;
+        ts.tv_sec = (time_t)(wake / 1000000000ULL);
+        ts.tv_nsec = (long)(wake % 1000000000ULL);
+        pthread_cond_timedwait(&pool->task_cond, &pool->pool_lock, &ts);
+    }
+    atomic_fetch_add_explicit(&pool->spinning_workers, 1, memory_order_seq_cst);
+    atomic_fetch_sub_explicit(&pool->parked_workers, 1, memory_order_seq_cst);
+    pthread_mutex_unlock(&pool->pool_lock);
+}
+
+/**
+ * @brief One idle round: spin with backoff, yield, or park, by round number.
+ *
+ * @param round Idle rounds so far; reset once the worker has parked.
+ */
+static void worker_idle(ttak_worker_t *self, ttak_thread_pool_t *pool, uint32_t *round) {
+    uint32_t spin_rounds = atomic_load_explicit(&pool->idle_spin_rounds, memory_order_relaxed);
+    uint32_t yield_rounds = atomic_load_explicit(&pool->idle_yield_rounds, memory_order_relaxed);
+    uint32_t r = (*round)++;
+    if (r < spin_rounds) {
+        uint32_t max_pauses = atomic_load_explicit(&pool->idle_max_pauses, memory_order_relaxed);
+        uint32_t pauses = (r < 31U && (1U << r) < max_pauses) ? (1U << r) : max_pauses;
+        for (uint32_t i = 0; i < pauses; i++) ttak_arch_pause();
+        return;
+    }
+    if (r - spin_rounds < yield_rounds) {
+        sched_yield();
+        return;
+    }
+    worker_park(self, pool);
+    *round = 0;
+}
+
+/**
+ * @brief Stops counting the worker as spinning now that it has a task.
+ *
+ * Submitters skipped their signal because this worker was spinning; if it
+ * was the last spinner and more work is queued, one parked worker is woken
+ * to keep searching in its place.
+ */
+static void worker_stop_spinning(ttak_thread_pool_t *pool) {
+    if (atomic_fetch_sub_explicit(&pool->spinning_workers, 1, memory_order_seq_cst) != 1) return;
+    if (atomic_load_explicit(&pool->parked_workers, memory_order_seq_cst) == 0) return;
+    if (!worker_pool_has_work(pool)) return;
+    pthread_mutex_lock(&pool->pool_lock);
+    pthread_cond_signal(&pool->task_cond);
+    pthread_mutex_unlock(&pool->pool_lock);
+}
+
 void *ttak_worker_routine(void *arg) {
     ttak_worker_t *self = (ttak_worker_t *)arg;
     ttak_thread_pool_t *pool = self->pool;
@@ -97,6 +310,7 @@ void *ttak_worker_routine(void *arg) {
     set_current_worker(self);
     ttak_epoch_register_thread();
     ttak_epoch_exit();
+    ttak_detachable_context_init_confined(&self->detachable, TTAK_ARENA_HAS_EPOCH_RECLAMATION);
     if (self->wrapper) {
 #ifdef _WIN32
         int p = THREAD_PRIORITY_NORMAL;
@@ -113,28 +327,58 @@ void *ttak_worker_routine(void *arg) {
     /* Use the shard assigned at creation time for affinity-first scheduling */
     size_t pref = self->preferred_shard;
     ttak_pool_shard_t *pref_shard = &pool->shards[pref];
+    _Bool retiring = 0;
 
-    while (!self->should_stop && !pool->is_shutdown) {
+    while (!retiring && !self->should_stop && !pool->is_shutdown) {
         volatile uint64_t now = ttak_get_tick_count();
         ttak_task_t *task = NULL;
+        ttak_trace_source_t source = TTAK_TRACE_SRC_EDF;
+        _Bool spinning = 0;
+        uint32_t idle_round = 0;
 
         /* --- Shard-affine fetch with robust fallback to work stealing --- */
         while (!task && !self->should_stop && !pool->is_shutdown) {
-            /* 1. Try preferred shard (fast path) */
-            pthread_mutex_lock(&pref_shard->lock);
-            task = pref_shard->queue.pop(&pref_shard->queue, now);
-            pthread_mutex_unlock(&pref_shard->lock);
+            /* 0. Deadline class of the preferred shard goes first */
+            task = worker_pop_edf(pool, pref_shard);
+            source = TTAK_TRACE_SRC_EDF;
+            if (task) break;
+
+            /* 1. Own deque, lock-free (fast path) */
+            task = (ttak_task_t *)ttak_ws_deque_pop(&self->deque);
+            source = TTAK_TRACE_SRC_DEQUE;
             if (task) break;
 
-            /* 2. Try stealing from other shards (throughput path) */
-            task = worker_steal_task(pool, pref, now);
+            /* 2. Refill from the preferred shard */
+            task = worker_refill_from_shard(self, pref_shard, now);
+            source = TTAK_TRACE_SRC_SHARD;
             if (task) break;
 
-            /* 3. Still idle? Yield and retry to avoid lost-signal stalls. */
-            sched_yield();
+            /* 3. Steal: other workers' deques, then other shards */
+            task = worker_steal_from_workers(self, pool);
+            source = TTAK_TRACE_SRC_WORKER;
+            if (task) break;
+            task = worker_steal_task(self, pool, pref, now);
+            source = TTAK_TRACE_SRC_REMOTE_SHARD;
+            if (task) break;
+
+            /* 4. Still idle: an elastic extra asked to retire leaves here, with its deque empty. */
+            if (atomic_load_explicit(&self->retire, memory_order_relaxed)) {
+                retiring = 1;
+                break;
+            }
+
+            /* 5. Spin, then yield, then park. */
+            if (!spinning) {
+                spinning = 1;
+                atomic_fetch_add_explicit(&pool->spinning_workers, 1, memory_order_seq_cst);
+            }
+            worker_idle(self, pool, &idle_round);
         }
+        if (spinning) worker_stop_spinning(pool);
 
         if (task) {
+            TTAK_TRACE(source >= TTAK_TRACE_SRC_WORKER ? TTAK_TRACE_TASK_STEAL : TTAK_TRACE_TASK_DEQUEUE,
+                       (uintptr_t)task, source);
             fprintf(stderr, "[worker] %p executing task %p\n", (void*)self, (void*)task);
             volatile _Bool epoch_active = 0;
             if (tt_setjmp(self->wrapper->env, &self->wrapper->jmp_magic, &self->wrapper->jmp_tid) == 0) {
@@ -143,8 +387,15 @@ void *ttak_worker_routine(void *arg) {
                 ttak_epoch_exit(); epoch_active = 0;
             } else if (epoch_active) { ttak_epoch_exit(); epoch_active = 0; self->exit_code = TTAK_ERR_FATAL_EXIT; }
             ttak_task_destroy(task, now);
+            atomic_store_explicit(&self->tasks_done,
+                                  atomic_load_explicit(&self->tasks_done, memory_order_relaxed) + 1,
+                                  memory_order_relaxed);
         }
     }
+    ttak_detachable_context_destroy(&self->detachable);
+    set_current_worker(NULL);
     ttak_epoch_deregister_thread();
+    /* Last touch of the slot: the sizing thread may reuse it once it sees this. */
+    atomic_store_explicit(&self->state, TTAK_WORKER_SLOT_EXITED, memory_order_release);
     return (void *)(uintptr_t)self->exit_code;
 }
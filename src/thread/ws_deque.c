@@ -0,0 +1,129 @@
+/**
+ * @file ws_deque.c
+ * @brief Chase-Lev deque with the C11 orderings of Le et al. (PPoPP 2013).
+ */
+
+#include <ttak/thread/ws_deque.h>
+#include <ttak/mem/mem.h>
+
+#include <string.h>
+
+struct ttak_ws_deque_ring {
+    size_t mask;
+    ttak_ws_deque_ring_t *retired;  /**< Ring this one replaced; freed at destroy. */
+    void *_Atomic slots[];
+};
+
+static ttak_ws_deque_ring_t *ws_ring_new(size_t capacity) {
+    ttak_ws_deque_ring_t *ring =
+        (ttak_ws_deque_ring_t *)ttak_dangerous_alloc(sizeof(*ring) + capacity * sizeof(void *));
+    if (!ring) return NULL;
+    ring->mask = capacity - 1;
+    ring->retired = NULL;
+    for (size_t i = 0; i < capacity; ++i) atomic_init(&ring->slots[i], NULL);
+    return ring;
+}
+
+static inline void *ws_ring_get(ttak_ws_deque_ring_t *ring, int64_t i) {
+    return atomic_load_explicit(&ring->slots[(size_t)i & ring->mask], memory_order_relaxed);
+}
+
+static inline void ws_ring_put(ttak_ws_deque_ring_t *ring, int64_t i, void *item) {
+    atomic_store_explicit(&ring->slots[(size_t)i & ring->mask], item, memory_order_relaxed);
+}
+
+bool ttak_ws_deque_init(ttak_ws_deque_t *dq, size_t capacity) {
+    if (!dq) return false;
+    size_t cap = 2;
+    if (capacity == 0) capacity = TTAK_WS_DEQUE_DEFAULT_CAPACITY;
+    while (cap < capacity) cap <<= 1;
+    ttak_ws_deque_ring_t *ring = ws_ring_new(cap);
+    if (!ring) return false;
+    atomic_init(&dq->top, 0);
+    atomic_init(&dq->bottom, 0);
+    atomic_init(&dq->ring, ring);
+    return true;
+}
+
+void ttak_ws_deque_destroy(ttak_ws_deque_t *dq) {
+    if (!dq) return;
+    ttak_ws_deque_ring_t *ring = atomic_load_explicit(&dq->ring, memory_order_relaxed);
+    while (ring) {
+        ttak_ws_deque_ring_t *older = ring->retired;
+        ttak_dangerous_free(ring);
+        ring = older;
+    }
+    atomic_store_explicit(&dq->ring, NULL, memory_order_relaxed);
+}
+
+/**
+ * @brief Doubles the ring, copying the live range [t, b).
+ */
+static ttak_ws_deque_ring_t *ws_grow(ttak_ws_deque_t *dq, ttak_ws_deque_ring_t *old, int64_t t, int64_t b) {
+    size_t cap = (old->mask + 1) << 1;
+    if (cap == 0) return NULL;
+    ttak_ws_deque_ring_t *ring = ws_ring_new(cap);
+    if (!ring) return NULL;
+    for (int64_t i = t; i < b; ++i) ws_ring_put(ring, i, ws_ring_get(old, i));
+    ring->retired = old;
+    atomic_store_explicit(&dq->ring, ring, memory_order_release);
+    return ring;
+}
+
+bool ttak_ws_deque_push(ttak_ws_deque_t *dq, void *item) {
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    ttak_ws_deque_ring_t *ring = atomic_load_explicit(&dq->ring, memory_order_relaxed);
+    if (b - t > (int64_t)ring->mask) {
+        ring = ws_grow(dq, ring, t, b);
+        if (!ring) return false;
+    }
+    ws_ring_put(ring, b, item);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+    return true;
+}
+
+void *ttak_ws_deque_pop(ttak_ws_deque_t *dq) {
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+    ttak_ws_deque_ring_t *ring = atomic_load_explicit(&dq->ring, memory_order_relaxed);
+    atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+
+    if (t > b) {
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+    void *item = ws_ring_get(ring, b);
+    if (t == b) {
+        /* Last item: race the thieves for it. */
+        if (!atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            item = NULL;
+        }
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+    }
+    return item;
+}
+
+void *ttak_ws_deque_steal(ttak_ws_deque_t *dq) {
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+
+    ttak_ws_deque_ring_t *ring = atomic_load_explicit(&dq->ring, memory_order_acquire);
+    void *item = ws_ring_get(ring, t);
+    if (!atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return item;
+}
+
+size_t ttak_ws_deque_size(const ttak_ws_deque_t *dq) {
+    int64_t b = atomic_load_explicit(&((ttak_ws_deque_t *)dq)->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&((ttak_ws_deque_t *)dq)->top, memory_order_relaxed);
+    return (b > t) ? (size_t)(b - t) : 0;
+}
@@ -1,75 +1,284 @@
 /**
  * @file timing.c
- * @brief High-resolution clock and TSC frequency calibration.
+ * @brief High-resolution clock, TSC calibration and the coarse clock ticker.
  *
- * Provides ttak_now_ns() which returns a monotonic nanosecond timestamp.
- * On x86-64 the TSC is used after a one-time calibration against
- * clock_gettime(CLOCK_MONOTONIC); other platforms fall back directly to
- * clock_gettime or Windows QPC.
+ * ttak_get_tick_count_ns() is the OS monotonic clock's nanoseconds. On
+ * x86-64 with an invariant TSC it is read from the TSC instead, mapped onto
+ * the OS clock by a calibration taken on first use; other platforms, and
+ * CPUs without an invariant TSC, read clock_gettime or Windows QPC.
+ *
+ * One background clock thread, started when the TSC is adopted or the
+ * coarse clock is first read, does the upkeep:
+ *  - it re-measures the TSC rate against the OS clock after 1 s, 10 s and
+ *    100 s, publishing each refined mapping anchored where the previous one
+ *    stood so the clock never jumps;
+ *  - it checks the TSC against the OS clock every second and drops back to
+ *    the OS clock for good if they drift apart;
+ *  - while the coarse clock is in use it publishes the time every
+ *    TTAK_COARSE_TICK_NS for ttak_get_tick_count_coarse_ns().
  */
 
 #include <ttak/timing/timing.h>
 #include <time.h>
 #include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #ifdef _WIN32
     #include <windows.h>
-    #include <stdbool.h>
 #endif
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__)) && !defined(__TINYC__)
+    #include <cpuid.h>
+#elif (defined(__x86_64__) || defined(_M_X64)) && defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+/** How often the clock thread checks and refines the TSC mapping. */
+#define TTAK_CLOCK_MAINTAIN_NS 1000000000ULL
+
+_Atomic uint64_t g_ttak_coarse_ns = 0;
+
+static pthread_mutex_t g_clock_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_clock_cond;
+static pthread_once_t g_clock_once = PTHREAD_ONCE_INIT;
+static bool g_clock_running = false;
+static bool g_coarse_wanted = false;
+
+static void clock_sleep_ns(uint64_t ns) {
+#ifdef _WIN32
+    Sleep((DWORD)(ns / 1000000ULL));
+#else
+    struct timespec ts = { (time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL) };
+    nanosleep(&ts, NULL);
+#endif
+}
 
 #if defined(__x86_64__) || defined(_M_X64)
+/** Calibrations taken: the first one, then refinements at 1 s, 10 s and 100 s. */
+#define TSC_CALIBRATIONS 4
+
 uint64_t g_tsc_freq_ghz = 0;
 uint64_t g_tsc_scale = 0; // Fixed point 32.32
+_Atomic int g_tsc_state = TTAK_TSC_UNCALIBRATED;
+const ttak_tsc_calibration_t *_Atomic g_tsc_calibration = NULL;
+
 static pthread_mutex_t g_tsc_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* Written once each and never reused, so a reader holding any of them stays valid. */
+static ttak_tsc_calibration_t g_tsc_calibs[TSC_CALIBRATIONS];
+static unsigned g_tsc_calib_count = 0;
+/* First calibration point, the origin every refinement measures from. */
+static uint64_t g_tsc_origin;
+static uint64_t g_tsc_origin_ns;
+static uint64_t g_tsc_next_refine_ns;
+/* TSC clock minus OS clock as of the last refinement; the drift check's reference. */
+static int64_t g_tsc_offset_ns;
+static uint64_t g_tsc_offset_at_ns;
+
+static bool tsc_is_invariant(void) {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, (int)0x80000000);
+    if ((unsigned)regs[0] < 0x80000007U) return false;
+    __cpuid(regs, (int)0x80000007);
+    return ((unsigned)regs[3] >> 8) & 1U;
+#elif (defined(__GNUC__) || defined(__clang__)) && !defined(__TINYC__)
+    unsigned a, b, c, d;
+    if (!__get_cpuid(0x80000007U, &a, &b, &c, &d)) return false;
+    return (d >> 8) & 1U;
+#else
+    return false;
+#endif
+}
+
+static void tsc_publish(uint64_t base, uint64_t base_ns, uint64_t scale) {
+    ttak_tsc_calibration_t *c = &g_tsc_calibs[g_tsc_calib_count++];
+    c->base = base;
+    c->base_ns = base_ns;
+    c->scale = scale;
+    g_tsc_scale = scale;
+    atomic_store_explicit(&g_tsc_calibration, c, memory_order_release);
+}
+
+static void tsc_fall_back(void) {
+    atomic_store_explicit(&g_tsc_calibration, NULL, memory_order_release);
+    atomic_store_explicit(&g_tsc_state, TTAK_TSC_FALLBACK, memory_order_release);
+}
+
+static void clock_thread_ensure(void);
 
 void calibrate_tsc(void) {
-    if (g_tsc_freq_ghz != 0) return;
+    if (atomic_load_explicit(&g_tsc_state, memory_order_acquire) != TTAK_TSC_UNCALIBRATED) return;
 
     pthread_mutex_lock(&g_tsc_mutex);
-    if (g_tsc_freq_ghz == 0) {
-        uint64_t tsc_start, tsc_end;
-        double elapsed;
+    if (atomic_load_explicit(&g_tsc_state, memory_order_relaxed) == TTAK_TSC_UNCALIBRATED) {
+        const char *source = getenv("TTAK_CLOCK_SOURCE");
+        bool forced_os = source && strcmp(source, "os") == 0;
+        bool forced_tsc = source && strcmp(source, "tsc") == 0;
 
-#ifdef _WIN32
-        LARGE_INTEGER qpf, qpc_start, qpc_end;
-        QueryPerformanceFrequency(&qpf);
-        QueryPerformanceCounter(&qpc_start);
-        tsc_start = ttak_arch_rdtsc();
+        uint64_t os_start = ttak_clock_os_ns();
+        uint64_t tsc_start = ttak_arch_rdtsc();
+        clock_sleep_ns(10000000ULL); // 10ms
+        uint64_t os_end = ttak_clock_os_ns();
+        uint64_t tsc_end = ttak_arch_rdtsc();
 
-        Sleep(10); // 10ms
+        double elapsed = (double)(os_end - os_start) * 1e-9;
+        double freq_hz = (elapsed > 0 && tsc_end > tsc_start) ? (double)(tsc_end - tsc_start) / elapsed : 0;
+        bool sane = freq_hz >= 1e8 && freq_hz <= 1e11;
+        if (sane) {
+            g_tsc_freq_ghz = (uint64_t)(freq_hz / 1e9);
+            if (g_tsc_freq_ghz == 0) g_tsc_freq_ghz = 1;
+            g_tsc_scale = (uint64_t)((1e9 * (double)(1ULL << 32)) / freq_hz);
+        } else {
+            g_tsc_freq_ghz = 2;
+            g_tsc_scale = (1ULL << 32) / 2;
+        }
 
-        QueryPerformanceCounter(&qpc_end);
-        tsc_end = ttak_arch_rdtsc();
+        if (sane && !forced_os && (forced_tsc || tsc_is_invariant())) {
+            g_tsc_origin = tsc_end;
+            g_tsc_origin_ns = os_end;
+            g_tsc_next_refine_ns = os_end + TTAK_CLOCK_MAINTAIN_NS;
+            g_tsc_offset_ns = 0;
+            g_tsc_offset_at_ns = 0;
+            tsc_publish(tsc_end, os_end, g_tsc_scale);
+            atomic_store_explicit(&g_tsc_state, TTAK_TSC_STABLE, memory_order_release);
+        } else {
+            tsc_fall_back();
+        }
+    }
+    pthread_mutex_unlock(&g_tsc_mutex);
 
-        elapsed = (double)(qpc_end.QuadPart - qpc_start.QuadPart) / (double)qpf.QuadPart;
-#else
-        struct timespec ts_start, ts_end;
-        clock_gettime(CLOCK_MONOTONIC, &ts_start);
-        tsc_start = ttak_arch_rdtsc();
+    if (atomic_load_explicit(&g_tsc_state, memory_order_acquire) == TTAK_TSC_STABLE) clock_thread_ensure();
+}
 
-        struct timespec sleep_ts = {0, 10000000}; // 10ms
-        nanosleep(&sleep_ts, NULL);
+/**
+ * @brief Refines or checks the TSC mapping; runs on the clock thread only.
+ *
+ * A refinement measures the rate from the origin to now. One more than 1%
+ * off the previous rate, or drift from the OS clock beyond 1 ms plus
+ * 100 ppm of the time since the last refinement, means the TSC is not
+ * trustworthy here and the OS clock takes over.
+ */
+static void tsc_maintain(void) {
+    const ttak_tsc_calibration_t *c = atomic_load_explicit(&g_tsc_calibration, memory_order_acquire);
+    if (!c) return;
+    uint64_t os = ttak_clock_os_ns();
+    uint64_t tsc = ttak_arch_rdtsc();
+    uint64_t clk = ttak_tsc_to_ns(c, tsc);
+    int64_t offset = (int64_t)(clk - os);
 
-        clock_gettime(CLOCK_MONOTONIC, &ts_end);
-        tsc_end = ttak_arch_rdtsc();
+    if (os >= g_tsc_next_refine_ns && g_tsc_calib_count < TSC_CALIBRATIONS) {
+        if (tsc <= g_tsc_origin) {
+            tsc_fall_back();
+            return;
+        }
+        double scale = (double)(os - g_tsc_origin_ns) / (double)(tsc - g_tsc_origin) * (double)(1ULL << 32);
+        double prev = (double)c->scale;
+        if (scale < prev * 0.99 || scale > prev * 1.01) {
+            tsc_fall_back();
+            return;
+        }
+        /* Anchor at the current reading so the clock stays continuous. */
+        tsc_publish(tsc, clk, (uint64_t)scale);
+        g_tsc_offset_ns = offset;
+        g_tsc_offset_at_ns = os;
+        g_tsc_next_refine_ns = g_tsc_origin_ns + (os - g_tsc_origin_ns) * 10U;
+        return;
+    }
 
-        elapsed = (double)(ts_end.tv_sec - ts_start.tv_sec) + (double)(ts_end.tv_nsec - ts_start.tv_nsec) * 1e-9;
+    if (g_tsc_offset_at_ns == 0) return; /* Nothing to compare against before the first refinement. */
+    int64_t drift = offset - g_tsc_offset_ns;
+    if (drift < 0) drift = -drift;
+    if ((uint64_t)drift > 1000000ULL + (os - g_tsc_offset_at_ns) / 10000U) tsc_fall_back();
+}
 #endif
 
-        if (elapsed > 0) {
-            double freq_hz = (double)(tsc_end - tsc_start) / elapsed;
-            uint64_t freq_ghz = (uint64_t)(freq_hz / 1e9);
-            if (freq_ghz == 0) freq_ghz = 2;
-            g_tsc_freq_ghz = freq_ghz;
-            g_tsc_scale = (uint64_t)((1e9 * (1ULL << 32)) / freq_hz);
-        } else {
-            g_tsc_freq_ghz = 2;
-            g_tsc_scale = (1ULL << 32) / 2;
+static void clock_init_once(void) {
+#ifdef _WIN32
+    pthread_cond_init(&g_clock_cond, NULL);
+#else
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_clock_cond, &attr);
+    pthread_condattr_destroy(&attr);
+#endif
+}
+
+static void coarse_publish(uint64_t now) {
+    /* Only ever moves forward, including across a fallback to the OS clock. */
+    uint64_t prev = atomic_load_explicit(&g_ttak_coarse_ns, memory_order_relaxed);
+    while (now > prev && !atomic_compare_exchange_weak_explicit(&g_ttak_coarse_ns, &prev, now,
+                                                                memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void *clock_thread_main(void *arg) {
+    (void)arg;
+    uint64_t last_maintain = ttak_clock_os_ns();
+    pthread_mutex_lock(&g_clock_lock);
+    for (;;) {
+        uint64_t period = g_coarse_wanted ? TTAK_COARSE_TICK_NS : TTAK_CLOCK_MAINTAIN_NS;
+        struct timespec ts;
+#ifdef _WIN32
+        clock_gettime(CLOCK_REALTIME, &ts);
+#else
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+        uint64_t wake = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec + period;
+        ts.tv_sec = (time_t)(wake / 1000000000ULL);
+        ts.tv_nsec = (long)(wake % 1000000000ULL);
+        pthread_cond_timedwait(&g_clock_cond, &g_clock_lock, &ts);
+        bool coarse = g_coarse_wanted;
+        pthread_mutex_unlock(&g_clock_lock);
+
+        if (coarse) coarse_publish(ttak_get_tick_count_ns());
+#if defined(__x86_64__) || defined(_M_X64)
+        uint64_t os = ttak_clock_os_ns();
+        if (os - last_maintain >= TTAK_CLOCK_MAINTAIN_NS) {
+            last_maintain = os;
+            tsc_maintain();
         }
+#endif
+        pthread_mutex_lock(&g_clock_lock);
     }
-    pthread_mutex_unlock(&g_tsc_mutex);
+    return NULL;
+}
+
+/**
+ * @brief Starts the detached clock thread once. Call with @c g_clock_lock held.
+ */
+static void clock_thread_start_locked(void) {
+    if (g_clock_running) return;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, clock_thread_main, NULL) != 0) return;
+    pthread_detach(thread);
+    g_clock_running = true;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+static void clock_thread_ensure(void) {
+    pthread_once(&g_clock_once, clock_init_once);
+    pthread_mutex_lock(&g_clock_lock);
+    clock_thread_start_locked();
+    pthread_mutex_unlock(&g_clock_lock);
 }
 #endif
 
+uint64_t ttak_coarse_clock_start(void) {
+    uint64_t now = ttak_get_tick_count_ns();
+    pthread_once(&g_clock_once, clock_init_once);
+    pthread_mutex_lock(&g_clock_lock);
+    clock_thread_start_locked();
+    /* Without a ticker the value would freeze; leave it 0 so readers keep using the precise clock. */
+    if (g_clock_running && !g_coarse_wanted) {
+        g_coarse_wanted = true;
+        coarse_publish(now);
+        pthread_cond_signal(&g_clock_cond);
+    }
+    pthread_mutex_unlock(&g_clock_lock);
+    return now;
+}
+
 #ifdef _WIN32
 uint64_t ttak_get_tick_count_ns_win32(void) {
     static LARGE_INTEGER freq;
@@ -0,0 +1,328 @@
+#include <ttak/timing/wheel.h>
+#include <ttak/timing/timing.h>
+#include <ttak/thread/pool.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define WHEEL_BITS 6U
+#define WHEEL_MASK ((uint64_t)TTAK_TIMER_WHEEL_SLOTS - 1U)
+#define WHEEL_SPAN (UINT64_C(1) << (WHEEL_BITS * TTAK_TIMER_WHEEL_LEVELS))
+#define WHEEL_WHERE_EXPIRED 0xFFFFU
+
+static inline uint64_t wheel_rotr(uint64_t x, unsigned r) {
+    return (x >> r) | (x << ((64U - r) & 63U));
+}
+
+/**
+ * @brief First tick at or after @p ns; a timer is never due early.
+ */
+static uint64_t wheel_tick_ceil(const ttak_timer_wheel_t *wheel, uint64_t ns) {
+    if (ns <= wheel->origin_ns) return 0;
+    return (ns - wheel->origin_ns + wheel->tick_ns - 1U) / wheel->tick_ns;
+}
+
+static uint64_t wheel_tick_floor(const ttak_timer_wheel_t *wheel, uint64_t ns) {
+    if (ns <= wheel->origin_ns) return 0;
+    return (ns - wheel->origin_ns) / wheel->tick_ns;
+}
+
+static void wheel_link(ttak_timer_t **head, ttak_timer_t *timer) {
+    timer->next = *head;
+    if (*head) (*head)->pprev = &timer->next;
+    *head = timer;
+    timer->pprev = head;
+}
+
+static void wheel_unlink(ttak_timer_wheel_t *wheel, ttak_timer_t *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next) timer->next->pprev = timer->pprev;
+    if (timer->where != WHEEL_WHERE_EXPIRED) {
+        unsigned level = timer->where / TTAK_TIMER_WHEEL_SLOTS;
+        unsigned slot = timer->where % TTAK_TIMER_WHEEL_SLOTS;
+        if (!wheel->slots[level][slot]) wheel->occupied[level] &= ~(UINT64_C(1) << slot);
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+    wheel->pending--;
+}
+
+/**
+ * @brief Links @p timer into the slot for its due tick, which is not
+ *        before @c current.
+ *
+ * Level k takes timers due within 64^(k+1) ticks, in the slot for bits
+ * [6k, 6k+6) of the due tick. One further out than the wheel spans goes
+ * to the last slot of the top level and is re-placed when it cascades.
+ */
+static void wheel_place(ttak_timer_wheel_t *wheel, ttak_timer_t *timer) {
+    uint64_t due = timer->expires;
+    uint64_t delta = due - wheel->current;
+    if (delta >= WHEEL_SPAN) {
+        due = wheel->current + WHEEL_SPAN - 1U;
+        delta = WHEEL_SPAN - 1U;
+    }
+    unsigned level = 0;
+    while (level + 1U < TTAK_TIMER_WHEEL_LEVELS && delta >= (UINT64_C(1) << (WHEEL_BITS * (level + 1U)))) {
+        level++;
+    }
+    unsigned slot = (unsigned)((due >> (WHEEL_BITS * level)) & WHEEL_MASK);
+    timer->where = (uint16_t)(level * TTAK_TIMER_WHEEL_SLOTS + slot);
+    wheel_link(&wheel->slots[level][slot], timer);
+    wheel->occupied[level] |= UINT64_C(1) << slot;
+}
+
+/**
+ * @brief Next tick after @c current at which a slot is collected or
+ *        cascaded, or UINT64_MAX if the wheel is empty.
+ *
+ * Per level, the first occupied slot among the next 64 positions is
+ * found with one rotate and count-trailing-zeros on its bitmap.
+ */
+static uint64_t wheel_next_event(const ttak_timer_wheel_t *wheel) {
+    uint64_t best = UINT64_MAX;
+    for (unsigned level = 0; level < TTAK_TIMER_WHEEL_LEVELS; level++) {
+        uint64_t bits = wheel->occupied[level];
+        if (!bits) continue;
+        unsigned shift = WHEEL_BITS * level;
+        uint64_t block = wheel->current >> shift;
+        unsigned from = (unsigned)((block + 1U) & WHEEL_MASK);
+        uint64_t d = (uint64_t)__builtin_ctzll(wheel_rotr(bits, from)) + 1U;
+        uint64_t tick = (block + d) << shift;
+        if (tick < best) best = tick;
+    }
+    return best;
+}
+
+/**
+ * @brief Processes tick @c current: cascades every level whose slot
+ *        boundary it is, then moves the due level-0 slot to the expired list.
+ */
+static void wheel_process_tick(ttak_timer_wheel_t *wheel) {
+    uint64_t tick = wheel->current;
+    for (unsigned level = TTAK_TIMER_WHEEL_LEVELS - 1U; level > 0; level--) {
+        unsigned shift = WHEEL_BITS * level;
+        if (tick & ((UINT64_C(1) << shift) - 1U)) continue;
+        unsigned slot = (unsigned)((tick >> shift) & WHEEL_MASK);
+        ttak_timer_t *list = wheel->slots[level][slot];
+        wheel->slots[level][slot] = NULL;
+        wheel->occupied[level] &= ~(UINT64_C(1) << slot);
+        while (list) {
+            ttak_timer_t *next = list->next;
+            wheel_place(wheel, list);
+            list = next;
+        }
+    }
+
+    unsigned slot = (unsigned)(tick & WHEEL_MASK);
+    ttak_timer_t *list = wheel->slots[0][slot];
+    wheel->slots[0][slot] = NULL;
+    wheel->occupied[0] &= ~(UINT64_C(1) << slot);
+    while (list) {
+        ttak_timer_t *next = list->next;
+        list->where = WHEEL_WHERE_EXPIRED;
+        wheel_link(&wheel->expired, list);
+        list = next;
+    }
+}
+
+void ttak_timer_init(ttak_timer_t *timer, ttak_timer_fn fn, void *arg) {
+    if (!timer) return;
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->where = 0;
+    timer->fn = fn;
+    timer->arg = arg;
+}
+
+void ttak_timer_wheel_init(ttak_timer_wheel_t *wheel, uint64_t tick_ns, uint64_t now_ns) {
+    if (!wheel) return;
+    pthread_mutex_init(&wheel->lock, NULL);
+#ifdef _WIN32
+    pthread_cond_init(&wheel->cond, NULL);
+#else
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&wheel->cond, &attr);
+    pthread_condattr_destroy(&attr);
+#endif
+    wheel->tick_ns = tick_ns ? tick_ns : TTAK_TIMER_WHEEL_TICK_NS;
+    wheel->origin_ns = now_ns;
+    wheel->current = 0;
+    wheel->pending = 0;
+    for (unsigned level = 0; level < TTAK_TIMER_WHEEL_LEVELS; level++) {
+        wheel->occupied[level] = 0;
+        for (unsigned slot = 0; slot < TTAK_TIMER_WHEEL_SLOTS; slot++) wheel->slots[level][slot] = NULL;
+    }
+    wheel->expired = NULL;
+    wheel->pool = NULL;
+    wheel->running = false;
+    wheel->stop = false;
+    wheel->wake_tick = 0;
+}
+
+void ttak_timer_wheel_destroy(ttak_timer_wheel_t *wheel) {
+    if (!wheel) return;
+    ttak_timer_wheel_stop(wheel);
+    pthread_mutex_destroy(&wheel->lock);
+    pthread_cond_destroy(&wheel->cond);
+}
+
+void ttak_timer_arm(ttak_timer_wheel_t *wheel, ttak_timer_t *timer, uint64_t expires_ns) {
+    if (!wheel || !timer) return;
+    pthread_mutex_lock(&wheel->lock);
+    if (timer->pprev) wheel_unlink(wheel, timer);
+    uint64_t due = wheel_tick_ceil(wheel, expires_ns);
+    /* The current tick is already processed. */
+    if (due <= wheel->current) due = wheel->current + 1U;
+    timer->expires = due;
+    wheel_place(wheel, timer);
+    wheel->pending++;
+    if (wheel->running && due < wheel->wake_tick) pthread_cond_signal(&wheel->cond);
+    pthread_mutex_unlock(&wheel->lock);
+}
+
+_Bool ttak_timer_cancel(ttak_timer_wheel_t *wheel, ttak_timer_t *timer) {
+    if (!wheel || !timer) return false;
+    pthread_mutex_lock(&wheel->lock);
+    _Bool was_pending = timer->pprev != NULL;
+    if (was_pending) wheel_unlink(wheel, timer);
+    pthread_mutex_unlock(&wheel->lock);
+    return was_pending;
+}
+
+uint64_t ttak_timer_wheel_pending(ttak_timer_wheel_t *wheel) {
+    if (!wheel) return 0;
+    pthread_mutex_lock(&wheel->lock);
+    uint64_t pending = wheel->pending;
+    pthread_mutex_unlock(&wheel->lock);
+    return pending;
+}
+
+uint64_t ttak_timer_wheel_advance(ttak_timer_wheel_t *wheel, uint64_t now_ns) {
+    if (!wheel) return UINT64_MAX;
+    uint64_t target = wheel_tick_floor(wheel, now_ns);
+
+    pthread_mutex_lock(&wheel->lock);
+    for (;;) {
+        /* Callbacks run unlocked, one at a time, so they may re-arm or cancel. */
+        while (wheel->expired) {
+            ttak_timer_t *timer = wheel->expired;
+            ttak_timer_fn fn = timer->fn;
+            void *arg = timer->arg;
+            struct ttak_thread_pool *pool = wheel->pool;
+            wheel_unlink(wheel, timer);
+            pthread_mutex_unlock(&wheel->lock);
+            if (fn && (!pool || !ttak_thread_pool_submit_detached(pool, fn, arg, 0, ttak_get_tick_count()))) {
+                fn(arg);
+            }
+            pthread_mutex_lock(&wheel->lock);
+        }
+        if (wheel->current >= target) break;
+        uint64_t next = wheel_next_event(wheel);
+        if (next > target) {
+            wheel->current = target;
+            break;
+        }
+        wheel->current = next;
+        wheel_process_tick(wheel);
+    }
+
+    uint64_t next = wheel_next_event(wheel);
+    uint64_t delay = UINT64_MAX;
+    if (next != UINT64_MAX) {
+        uint64_t due_ns = wheel->origin_ns + next * wheel->tick_ns;
+        delay = due_ns > now_ns ? due_ns - now_ns : 0;
+    }
+    pthread_mutex_unlock(&wheel->lock);
+    return delay;
+}
+
+/**
+ * @brief Driver loop: advance, then sleep until the next event or an
+ *        earlier arm signals.
+ */
+static void *wheel_main(void *arg) {
+    ttak_timer_wheel_t *wheel = (ttak_timer_wheel_t *)arg;
+    pthread_mutex_lock(&wheel->lock);
+    while (!wheel->stop) {
+        pthread_mutex_unlock(&wheel->lock);
+        ttak_timer_wheel_advance(wheel, ttak_get_tick_count_ns());
+        pthread_mutex_lock(&wheel->lock);
+        if (wheel->stop || wheel->expired) continue;
+
+        uint64_t next = wheel_next_event(wheel);
+        wheel->wake_tick = next;
+        if (next == UINT64_MAX) {
+            pthread_cond_wait(&wheel->cond, &wheel->lock);
+        } else {
+            uint64_t due_ns = wheel->origin_ns + next * wheel->tick_ns;
+            uint64_t now_ns = ttak_get_tick_count_ns();
+            if (due_ns > now_ns) {
+                /* Sleep a relative delay; the tick clock need not share CLOCK_MONOTONIC's epoch. */
+                struct timespec ts;
+#ifdef _WIN32
+                clock_gettime(CLOCK_REALTIME, &ts);
+#else
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+                uint64_t wake = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec + (due_ns - now_ns);
+                ts.tv_sec = (time_t)(wake / 1000000000ULL);
+                ts.tv_nsec = (long)(wake % 1000000000ULL);
+                pthread_cond_timedwait(&wheel->cond, &wheel->lock, &ts);
+            }
+        }
+        /* Busy again: arms need not signal until the next sleep. */
+        wheel->wake_tick = 0;
+    }
+    pthread_mutex_unlock(&wheel->lock);
+    return NULL;
+}
+
+_Bool ttak_timer_wheel_start(ttak_timer_wheel_t *wheel, struct ttak_thread_pool *pool) {
+    if (!wheel) return false;
+    pthread_mutex_lock(&wheel->lock);
+    if (wheel->running) {
+        pthread_mutex_unlock(&wheel->lock);
+        return false;
+    }
+    wheel->pool = pool;
+    wheel->stop = false;
+    wheel->wake_tick = 0;
+    wheel->running = pthread_create(&wheel->thread, NULL, wheel_main, wheel) == 0;
+    _Bool started = wheel->running;
+    pthread_mutex_unlock(&wheel->lock);
+    return started;
+}
+
+void ttak_timer_wheel_stop(ttak_timer_wheel_t *wheel) {
+    if (!wheel) return;
+    pthread_mutex_lock(&wheel->lock);
+    if (!wheel->running) {
+        pthread_mutex_unlock(&wheel->lock);
+        return;
+    }
+    wheel->stop = true;
+    pthread_cond_signal(&wheel->cond);
+    pthread_mutex_unlock(&wheel->lock);
+    pthread_join(wheel->thread, NULL);
+    pthread_mutex_lock(&wheel->lock);
+    wheel->running = false;
+    wheel->stop = false;
+    wheel->pool = NULL;
+    pthread_mutex_unlock(&wheel->lock);
+}
+
+static ttak_timer_wheel_t g_shared_wheel;
+static pthread_once_t g_shared_wheel_once = PTHREAD_ONCE_INIT;
+
+static void shared_wheel_init(void) {
+    ttak_timer_wheel_init(&g_shared_wheel, 0, ttak_get_tick_count_ns());
+    ttak_timer_wheel_start(&g_shared_wheel, NULL);
+}
+
+ttak_timer_wheel_t *ttak_timer_wheel_shared(void) {
+    pthread_once(&g_shared_wheel_once, shared_wheel_init);
+    return &g_shared_wheel;
+}
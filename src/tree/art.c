@@ -0,0 +1,448 @@
+#include <ttak/tree/art.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mem/mem.h>
+#include <string.h>
+
+#if defined(TTAK_HAS_SSE2)
+#  include <emmintrin.h>
+#elif defined(TTAK_HAS_NEON)
+#  include <arm_neon.h>
+#endif
+
+enum { ART_NODE4, ART_NODE16, ART_NODE48, ART_NODE256 };
+
+/**
+ * @brief Immutable set of the routes ending inside one node's key byte.
+ *
+ * Entry @c len is the number of bits the route takes from the node's byte
+ * (0 to 7) and @c bits those bits, high-aligned. Entries are sorted by
+ * length, longest first, so the first match is the best one.
+ */
+typedef struct art_routes {
+    uint32_t n;
+    struct {
+        uint8_t len;
+        uint8_t bits;
+        uintptr_t value;
+    } e[];
+} art_routes_t;
+
+struct ttak_art_node {
+    uint8_t type;                   /**< Fixed at creation. */
+    _Atomic uint16_t count;         /**< Children; published after the child it counts. */
+    art_routes_t *_Atomic routes;   /**< NULL when no route ends here. */
+};
+
+typedef ttak_art_node_t *_Atomic art_slot_t;
+
+typedef struct {
+    ttak_art_node_t h;
+    uint8_t keys[4];
+    art_slot_t children[4];
+} art_node4_t;
+
+typedef struct {
+    ttak_art_node_t h;
+    _Alignas(16) uint8_t keys[16];
+    art_slot_t children[16];
+} art_node16_t;
+
+typedef struct {
+    ttak_art_node_t h;
+    _Atomic uint8_t index[256];     /**< Slot + 1 per key byte, 0 when absent. */
+    art_slot_t children[48];
+} art_node48_t;
+
+typedef struct {
+    ttak_art_node_t h;
+    art_slot_t children[256];
+} art_node256_t;
+
+static const uint16_t art_capacity[] = { 4, 16, 48, 256 };
+
+static ttak_art_node_t *art_node_new(int type) {
+    static const size_t bytes[] = {
+        sizeof(art_node4_t), sizeof(art_node16_t), sizeof(art_node48_t), sizeof(art_node256_t),
+    };
+    ttak_art_node_t *node = ttak_dangerous_calloc(1, bytes[type]);
+    if (node) node->type = (uint8_t)type;
+    return node;
+}
+
+/* Mask of the top @p len bits of a byte. */
+static inline uint8_t art_mask(unsigned len) {
+    return (uint8_t)(0xFF00u >> len);
+}
+
+/* Position of @p byte among the first @p n keys of a node16, or -1. */
+static inline int art_find16(const art_node16_t *node, uint8_t byte, unsigned n) {
+#if defined(TTAK_HAS_SSE2)
+    __m128i eq = _mm_cmpeq_epi8(_mm_load_si128((const __m128i *)node->keys), _mm_set1_epi8((char)byte));
+    unsigned mask = (unsigned)_mm_movemask_epi8(eq) & ((1u << n) - 1);
+    return mask ? __builtin_ctz(mask) : -1;
+#elif defined(TTAK_HAS_NEON)
+    uint8x16_t eq = vceqq_u8(vld1q_u8(node->keys), vdupq_n_u8(byte));
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+    mask &= n >= 16 ? ~0ULL : (1ULL << (4 * n)) - 1;
+    return mask ? __builtin_ctzll(mask) >> 2 : -1;
+#else
+    for (unsigned i = 0; i < n; i++) {
+        if (node->keys[i] == byte) return (int)i;
+    }
+    return -1;
+#endif
+}
+
+/* Slot holding the child for @p byte, or NULL; a node256 slot may hold NULL. */
+static art_slot_t *art_find_slot(ttak_art_node_t *node, uint8_t byte) {
+    unsigned n = atomic_load_explicit(&node->count, memory_order_acquire);
+    switch (node->type) {
+    case ART_NODE4: {
+        art_node4_t *n4 = (art_node4_t *)node;
+        for (unsigned i = 0; i < n && i < 4; i++) {
+            if (n4->keys[i] == byte) return &n4->children[i];
+        }
+        return NULL;
+    }
+    case ART_NODE16: {
+        int i = art_find16((art_node16_t *)node, byte, n > 16 ? 16 : n);
+        return i < 0 ? NULL : &((art_node16_t *)node)->children[i];
+    }
+    case ART_NODE48: {
+        art_node48_t *n48 = (art_node48_t *)node;
+        unsigned idx = atomic_load_explicit(&n48->index[byte], memory_order_acquire);
+        return idx ? &n48->children[idx - 1] : NULL;
+    }
+    default:
+        return &((art_node256_t *)node)->children[byte];
+    }
+}
+
+static ttak_art_node_t *art_child(ttak_art_node_t *node, uint8_t byte) {
+    art_slot_t *slot = art_find_slot(node, byte);
+    return slot ? atomic_load_explicit(slot, memory_order_acquire) : NULL;
+}
+
+/* Runs @p body with @p byte and @p child bound to each child of @p node; writer side only. */
+#define ART_FOR_EACH_CHILD(node, byte, child, body)                                          \
+    do {                                                                                     \
+        unsigned art_n_ = atomic_load_explicit(&(node)->count, memory_order_relaxed);        \
+        if ((node)->type == ART_NODE4 || (node)->type == ART_NODE16) {                       \
+            uint8_t *art_k_ = (node)->type == ART_NODE4 ? ((art_node4_t *)(node))->keys      \
+                                                        : ((art_node16_t *)(node))->keys;    \
+            art_slot_t *art_c_ = (node)->type == ART_NODE4 ? ((art_node4_t *)(node))->children \
+                                                           : ((art_node16_t *)(node))->children; \
+            for (unsigned art_i_ = 0; art_i_ < art_n_; art_i_++) {                           \
+                uint8_t byte = art_k_[art_i_];                                               \
+                ttak_art_node_t *child = atomic_load_explicit(&art_c_[art_i_], memory_order_relaxed); \
+                body                                                                         \
+            }                                                                                \
+        } else {                                                                             \
+            for (unsigned art_b_ = 0; art_b_ < 256; art_b_++) {                              \
+                uint8_t byte = (uint8_t)art_b_;                                              \
+                ttak_art_node_t *child = art_child((node), byte);                            \
+                if (!child) continue;                                                        \
+                body                                                                         \
+            }                                                                                \
+        }                                                                                    \
+    } while (0)
+
+/* Adds a child to @p node, which has room; the release store publishes it. */
+static void art_append(ttak_art_node_t *node, uint8_t byte, ttak_art_node_t *child) {
+    unsigned n = atomic_load_explicit(&node->count, memory_order_relaxed);
+    switch (node->type) {
+    case ART_NODE4:
+        ((art_node4_t *)node)->keys[n] = byte;
+        atomic_store_explicit(&((art_node4_t *)node)->children[n], child, memory_order_relaxed);
+        break;
+    case ART_NODE16:
+        ((art_node16_t *)node)->keys[n] = byte;
+        atomic_store_explicit(&((art_node16_t *)node)->children[n], child, memory_order_relaxed);
+        break;
+    case ART_NODE48: {
+        art_node48_t *n48 = (art_node48_t *)node;
+        atomic_store_explicit(&n48->children[n], child, memory_order_relaxed);
+        atomic_store_explicit(&n48->index[byte], (uint8_t)(n + 1), memory_order_release);
+        break;
+    }
+    default:
+        atomic_store_explicit(&((art_node256_t *)node)->children[byte], child, memory_order_release);
+        break;
+    }
+    atomic_store_explicit(&node->count, (uint16_t)(n + 1), memory_order_release);
+}
+
+/*
+ * Copies @p node into a new node of @p type, leaving out the child for
+ * @p skip when @p skip is 0..255. The copy shares the routes set.
+ */
+static ttak_art_node_t *art_copy(ttak_art_node_t *node, int type, int skip) {
+    ttak_art_node_t *copy = art_node_new(type);
+    if (!copy) return NULL;
+    atomic_store_explicit(&copy->routes, atomic_load_explicit(&node->routes, memory_order_relaxed),
+                          memory_order_relaxed);
+    ART_FOR_EACH_CHILD(node, byte, child, {
+        if (byte != skip) art_append(copy, byte, child);
+    });
+    return copy;
+}
+
+/* Publishes @p fresh in place of @p old at @p slot and retires @p old. */
+static void art_replace(art_slot_t *slot, ttak_art_node_t *old, ttak_art_node_t *fresh) {
+    atomic_store_explicit(slot, fresh, memory_order_release);
+    ttak_epoch_retire(old, ttak_dangerous_free);
+}
+
+/* Adds @p child under @p byte to the node at @p slot, growing the node if full. */
+static bool art_add_child(art_slot_t *slot, uint8_t byte, ttak_art_node_t *child) {
+    ttak_art_node_t *node = atomic_load_explicit(slot, memory_order_relaxed);
+    if (atomic_load_explicit(&node->count, memory_order_relaxed) < art_capacity[node->type]) {
+        art_append(node, byte, child);
+        return true;
+    }
+    ttak_art_node_t *grown = art_copy(node, node->type + 1, -1);
+    if (!grown) return false;
+    art_append(grown, byte, child);
+    art_replace(slot, node, grown);
+    return true;
+}
+
+/* Drops the child under @p byte from the node at @p slot, shrinking the node to fit. */
+static bool art_drop_child(art_slot_t *slot, uint8_t byte) {
+    ttak_art_node_t *node = atomic_load_explicit(slot, memory_order_relaxed);
+    unsigned left = atomic_load_explicit(&node->count, memory_order_relaxed) - 1u;
+    if (node->type == ART_NODE256 && left > art_capacity[ART_NODE48] / 2) {
+        atomic_store_explicit(&((art_node256_t *)node)->children[byte], NULL, memory_order_release);
+        atomic_store_explicit(&node->count, (uint16_t)left, memory_order_release);
+        return true;
+    }
+    // Slots of node4/16/48 are only ever appended, so removal copies the node.
+    int type = ART_NODE4;
+    while (left > art_capacity[type]) type++;
+    ttak_art_node_t *shrunk = art_copy(node, type, byte);
+    if (!shrunk) return false;
+    art_replace(slot, node, shrunk);
+    return true;
+}
+
+/* Position of route (@p len, @p bits) in @p set, or -1. */
+static int art_routes_find(const art_routes_t *set, unsigned len, uint8_t bits) {
+    for (uint32_t i = 0; set && i < set->n; i++) {
+        if (set->e[i].len == len && set->e[i].bits == bits) return (int)i;
+    }
+    return -1;
+}
+
+static art_routes_t *art_routes_new(uint32_t n) {
+    art_routes_t *set = ttak_dangerous_calloc(1, sizeof(*set) + n * sizeof(set->e[0]));
+    if (set) set->n = n;
+    return set;
+}
+
+/* Publishes @p fresh as @p node's route set, retiring the old one. */
+static void art_routes_swap(ttak_art_node_t *node, art_routes_t *fresh) {
+    art_routes_t *old = atomic_load_explicit(&node->routes, memory_order_relaxed);
+    atomic_store_explicit(&node->routes, fresh, memory_order_release);
+    if (old) ttak_epoch_retire(old, ttak_dangerous_free);
+}
+
+/* Sets route (@p len, @p bits) in @p node; 1 if new, 0 if replaced, -1 on allocation failure. */
+static int art_routes_put(ttak_art_node_t *node, unsigned len, uint8_t bits, uintptr_t value) {
+    art_routes_t *old = atomic_load_explicit(&node->routes, memory_order_relaxed);
+    uint32_t n = old ? old->n : 0;
+    int at = art_routes_find(old, len, bits);
+    art_routes_t *set = art_routes_new(at >= 0 ? n : n + 1);
+    if (!set) return -1;
+
+    uint32_t j = 0;
+    bool placed = false;
+    for (uint32_t i = 0; i < n; i++) {
+        if ((int)i == at) continue;
+        if (!placed && old->e[i].len <= len) {
+            set->e[j].len = (uint8_t)len;
+            set->e[j].bits = bits;
+            set->e[j++].value = value;
+            placed = true;
+        }
+        set->e[j++] = old->e[i];
+    }
+    if (!placed) {
+        set->e[j].len = (uint8_t)len;
+        set->e[j].bits = bits;
+        set->e[j].value = value;
+    }
+    art_routes_swap(node, set);
+    return at < 0;
+}
+
+/* Removes route (@p len, @p bits) from @p node; false if absent or allocation failed. */
+static bool art_routes_del(ttak_art_node_t *node, unsigned len, uint8_t bits) {
+    art_routes_t *old = atomic_load_explicit(&node->routes, memory_order_relaxed);
+    int at = art_routes_find(old, len, bits);
+    if (at < 0) return false;
+    art_routes_t *set = NULL;
+    if (old->n > 1) {
+        if (!(set = art_routes_new(old->n - 1))) return false;
+        for (uint32_t i = 0, j = 0; i < old->n; i++) {
+            if ((int)i != at) set->e[j++] = old->e[i];
+        }
+    }
+    art_routes_swap(node, set);
+    return true;
+}
+
+bool ttak_art_init(ttak_art_t *art) {
+    if (!art) return false;
+    ttak_art_node_t *root = art_node_new(ART_NODE4);
+    if (!root) return false;
+    atomic_init(&art->root, root);
+    atomic_init(&art->size, 0);
+    ttak_mutex_init(&art->lock);
+    return true;
+}
+
+static void art_free(ttak_art_node_t *node) {
+    ART_FOR_EACH_CHILD(node, byte, child, {
+        (void)byte;
+        art_free(child);
+    });
+    ttak_dangerous_free(atomic_load_explicit(&node->routes, memory_order_relaxed));
+    ttak_dangerous_free(node);
+}
+
+void ttak_art_destroy(ttak_art_t *art) {
+    if (!art) return;
+    ttak_art_node_t *root = atomic_load_explicit(&art->root, memory_order_relaxed);
+    if (root) art_free(root);
+    atomic_store_explicit(&art->root, NULL, memory_order_relaxed);
+    ttak_mutex_destroy(&art->lock);
+}
+
+bool ttak_art_insert(ttak_art_t *art, const uint8_t *prefix, unsigned prefix_len, uintptr_t value) {
+    if (!art || (!prefix && prefix_len) || prefix_len > 8 * TTAK_ART_MAX_KEY) return false;
+    unsigned depth = prefix_len / 8, rem = prefix_len % 8;
+    uint8_t bits = rem ? prefix[depth] & art_mask(rem) : 0;
+
+    ttak_mutex_lock(&art->lock);
+    ttak_epoch_enter();
+    art_slot_t *slot = &art->root;
+    bool ok = true;
+    for (unsigned d = 0; d < depth && ok; d++) {
+        ttak_art_node_t *node = atomic_load_explicit(slot, memory_order_relaxed);
+        if (!art_child(node, prefix[d])) {
+            ttak_art_node_t *fresh = art_node_new(ART_NODE4);
+            ok = fresh && art_add_child(slot, prefix[d], fresh);
+            if (!ok) {
+                ttak_dangerous_free(fresh);
+                break;
+            }
+            node = atomic_load_explicit(slot, memory_order_relaxed);
+        }
+        slot = art_find_slot(node, prefix[d]);
+    }
+    if (ok) {
+        int added = art_routes_put(atomic_load_explicit(slot, memory_order_relaxed), rem, bits, value);
+        ok = added >= 0;
+        if (added > 0) atomic_fetch_add_explicit(&art->size, 1, memory_order_relaxed);
+    }
+    ttak_epoch_exit();
+    ttak_mutex_unlock(&art->lock);
+    return ok;
+}
+
+bool ttak_art_remove(ttak_art_t *art, const uint8_t *prefix, unsigned prefix_len) {
+    if (!art || (!prefix && prefix_len) || prefix_len > 8 * TTAK_ART_MAX_KEY) return false;
+    unsigned depth = prefix_len / 8, rem = prefix_len % 8;
+    uint8_t bits = rem ? prefix[depth] & art_mask(rem) : 0;
+
+    ttak_mutex_lock(&art->lock);
+    ttak_epoch_enter();
+    art_slot_t *path[TTAK_ART_MAX_KEY + 1];
+    path[0] = &art->root;
+    bool found = true;
+    for (unsigned d = 0; d < depth && found; d++) {
+        art_slot_t *next = art_find_slot(atomic_load_explicit(path[d], memory_order_relaxed), prefix[d]);
+        found = next && atomic_load_explicit(next, memory_order_relaxed);
+        path[d + 1] = next;
+    }
+    found = found && art_routes_del(atomic_load_explicit(path[depth], memory_order_relaxed), rem, bits);
+    if (found) {
+        atomic_fetch_sub_explicit(&art->size, 1, memory_order_relaxed);
+        // Prune nodes left with neither routes nor children; the root stays.
+        for (unsigned d = depth; d > 0; d--) {
+            ttak_art_node_t *node = atomic_load_explicit(path[d], memory_order_relaxed);
+            if (atomic_load_explicit(&node->routes, memory_order_relaxed) ||
+                atomic_load_explicit(&node->count, memory_order_relaxed)) {
+                break;
+            }
+            if (!art_drop_child(path[d - 1], prefix[d - 1])) break;
+            ttak_epoch_retire(node, ttak_dangerous_free);
+        }
+    }
+    ttak_epoch_exit();
+    ttak_mutex_unlock(&art->lock);
+    return found;
+}
+
+bool ttak_art_get(ttak_art_t *art, const uint8_t *prefix, unsigned prefix_len, uintptr_t *out) {
+    if (!art || (!prefix && prefix_len) || prefix_len > 8 * TTAK_ART_MAX_KEY) return false;
+    unsigned depth = prefix_len / 8, rem = prefix_len % 8;
+    uint8_t bits = rem ? prefix[depth] & art_mask(rem) : 0;
+
+    ttak_epoch_enter();
+    ttak_art_node_t *node = atomic_load_explicit(&art->root, memory_order_acquire);
+    for (unsigned d = 0; d < depth && node; d++) node = art_child(node, prefix[d]);
+    bool found = false;
+    if (node) {
+        art_routes_t *set = atomic_load_explicit(&node->routes, memory_order_acquire);
+        int at = art_routes_find(set, rem, bits);
+        if ((found = at >= 0) && out) *out = set->e[at].value;
+    }
+    ttak_epoch_exit();
+    return found;
+}
+
+bool ttak_art_lookup_pinned(ttak_art_t *art, const uint8_t *key, size_t key_len, uintptr_t *out,
+                            unsigned *matched_len) {
+    if (!art || (!key && key_len) || key_len > TTAK_ART_MAX_KEY) return false;
+    ttak_art_node_t *node = atomic_load_explicit(&art->root, memory_order_acquire);
+    bool found = false;
+    uintptr_t best = 0;
+    unsigned best_len = 0;
+
+    for (size_t d = 0; node; d++) {
+        art_routes_t *set = atomic_load_explicit(&node->routes, memory_order_acquire);
+        if (set) {
+            // Past the key's last byte only a whole-byte route can still match.
+            uint8_t byte = d < key_len ? key[d] : 0;
+            for (uint32_t i = 0; i < set->n; i++) {
+                unsigned len = set->e[i].len;
+                if ((d < key_len || len == 0) && (byte & art_mask(len)) == set->e[i].bits) {
+                    found = true;
+                    best = set->e[i].value;
+                    best_len = (unsigned)(8 * d) + len;
+                    break;
+                }
+            }
+        }
+        if (d == key_len) break;
+        node = art_child(node, key[d]);
+    }
+    if (found) {
+        if (out) *out = best;
+        if (matched_len) *matched_len = best_len;
+    }
+    return found;
+}
+
+bool ttak_art_lookup(ttak_art_t *art, const uint8_t *key, size_t key_len, uintptr_t *out, unsigned *matched_len) {
+    ttak_epoch_enter();
+    bool found = ttak_art_lookup_pinned(art, key, key_len, out, matched_len);
+    ttak_epoch_exit();
+    return found;
+}
+
+size_t ttak_art_size(ttak_art_t *art) {
+    return art ? atomic_load_explicit(&art->size, memory_order_relaxed) : 0;
+}
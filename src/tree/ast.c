@@ -1,5 +1,7 @@
 #include <ttak/tree/ast.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/arena_helper.h>
+#include <string.h>
 #include <stdlib.h>
 
 /**
@@ -12,6 +14,34 @@ void ttak_ast_tree_init(ttak_ast_tree_t *tree, void (*free_value)(void*)) {
     if (!tree) return;
     tree->root = NULL;
     tree->free_value = free_value;
+    tree->arena_env = NULL;
+    tree->arena = NULL;
+    tree->arena_lane = 0;
+}
+
+/**
+ * @brief Back the nodes of a tree without a root with an arena lane.
+ *
+ * @param tree       Tree to configure.
+ * @param env        Arena helper context.
+ * @param generation Laned generation nodes are claimed from.
+ * @param lane       Lane the tree claims from; no other thread may use it.
+ * @return False if the tree has a root or the generation has no lanes.
+ */
+bool ttak_ast_tree_use_arena(ttak_ast_tree_t *tree, ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                             uint32_t lane) {
+    if (!tree || tree->root || !env || !generation || !generation->lanes) return false;
+    tree->arena_env = env;
+    tree->arena = generation;
+    tree->arena_lane = lane;
+    return true;
+}
+
+/**
+ * @brief Claim @p bytes from the tree's arena lane.
+ */
+static void *ast_arena_claim(ttak_ast_tree_t *tree, size_t bytes) {
+    return ttak_arena_generation_claim_lane(tree->arena_env, tree->arena, tree->arena_lane, bytes);
 }
 
 /**
@@ -32,10 +62,35 @@ ttak_ast_node_t *ttak_ast_create_node(int type, void *value, uint64_t now) {
     node->num_children = 0;
     node->cap_children = 0;
     node->parent = NULL;
+    node->arena_owner = NULL;
     
     return node;
 }
 
+/**
+ * @brief Allocate a node from the tree's arena when it has one.
+ *
+ * @param tree  Tree the node will belong to.
+ * @param type  Application-specific node type.
+ * @param value Payload pointer stored on the node.
+ * @param now   Timestamp for allocator bookkeeping.
+ * @return Pointer to the node or NULL on allocation failure.
+ */
+ttak_ast_node_t *ttak_ast_tree_create_node(ttak_ast_tree_t *tree, int type, void *value, uint64_t now) {
+    if (!tree || !tree->arena) return ttak_ast_create_node(type, value, now);
+    ttak_ast_node_t *node = ast_arena_claim(tree, sizeof(ttak_ast_node_t));
+    if (!node) return NULL;
+
+    node->type = type;
+    node->value = value;
+    node->children = NULL;
+    node->num_children = 0;
+    node->cap_children = 0;
+    node->parent = NULL;
+    node->arena_owner = tree;
+    return node;
+}
+
 /**
  * @brief Append a child node to the parent.
  *
@@ -49,13 +104,23 @@ void ttak_ast_add_child(ttak_ast_node_t *parent, ttak_ast_node_t *child, uint64_
     // Check if we need to resize children array
     if (parent->num_children >= parent->cap_children) {
         size_t new_cap = (parent->cap_children == 0) ? 4 : parent->cap_children * 2;
-        ttak_ast_node_t **new_children = (ttak_ast_node_t **)ttak_mem_realloc_raw(
-            parent->children, 
-            sizeof(ttak_ast_node_t *) * new_cap, 
-            __TTAK_UNSAFE_MEM_FOREVER__, 
-            now
-        );
-        if (!new_children) return;
+        ttak_ast_node_t **new_children;
+        if (parent->arena_owner) {
+            // Arena arrays cannot grow in place; the old one is dropped with the generation.
+            new_children = ast_arena_claim(parent->arena_owner, sizeof(ttak_ast_node_t *) * new_cap);
+            if (!new_children) return;
+            if (parent->num_children) {
+                memcpy(new_children, parent->children, sizeof(ttak_ast_node_t *) * parent->num_children);
+            }
+        } else {
+            new_children = (ttak_ast_node_t **)ttak_mem_realloc_raw(
+                parent->children, 
+                sizeof(ttak_ast_node_t *) * new_cap, 
+                __TTAK_UNSAFE_MEM_FOREVER__, 
+                now
+            );
+            if (!new_children) return;
+        }
         parent->children = new_children;
         parent->cap_children = new_cap;
     }
@@ -74,12 +139,13 @@ void ttak_ast_add_child(ttak_ast_node_t *parent, ttak_ast_node_t *child, uint64_
 static void recursive_destroy_node(ttak_ast_node_t *node, void (*free_value)(void*), uint64_t now) {
     if (!node) return;
     
-    if (ttak_mem_access(node, now)) {
+    bool in_arena = node->arena_owner != NULL;
+    if (in_arena || ttak_mem_access(node, now)) {
         for (size_t i = 0; i < node->num_children; i++) {
             recursive_destroy_node(node->children[i], free_value, now);
         }
         
-        if (node->children) {
+        if (node->children && !in_arena) {
             ttak_mem_free(node->children);
         }
         
@@ -87,18 +153,21 @@ static void recursive_destroy_node(ttak_ast_node_t *node, void (*free_value)(voi
             free_value(node->value);
         }
         
-        ttak_mem_free(node);
+        if (!in_arena) ttak_mem_free(node);
     }
 }
 
 /**
  * @brief Destroy the entire AST.
  *
+ * An arena-backed tree with no free_value hook is dropped without a walk;
+ * its nodes go when the generation is retired.
+ *
  * @param tree Tree to destroy.
  * @param now  Timestamp for memory bookkeeping.
  */
 void ttak_ast_tree_destroy(ttak_ast_tree_t *tree, uint64_t now) {
     if (!tree || !tree->root) return;
-    recursive_destroy_node(tree->root, tree->free_value, now);
+    if (!tree->arena || tree->free_value) recursive_destroy_node(tree->root, tree->free_value, now);
     tree->root = NULL;
 }
@@ -1,5 +1,6 @@
 #include <ttak/tree/bplus.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/arena_helper.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -8,35 +9,74 @@
 /**
  * @brief Allocate a B+ tree node configured as leaf or internal.
  *
- * @param order Maximum number of children.
- * @param leaf  Whether the node starts as a leaf.
- * @param now   Timestamp for allocator bookkeeping.
+ * Arena-backed trees carve the node and its arrays from one lane claim;
+ * otherwise each piece is a separate allocation.
+ *
+ * @param tree Tree the node belongs to.
+ * @param leaf Whether the node starts as a leaf.
+ * @param now  Timestamp for allocator bookkeeping.
  * @return Pointer to the node or NULL on failure.
  */
-static ttak_bplus_node_t *create_node(int order, bool leaf, uint64_t now) {
-    ttak_bplus_node_t *node = (ttak_bplus_node_t *)ttak_mem_alloc_raw(sizeof(ttak_bplus_node_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-    if (!node) return NULL;
-    
-    node->is_leaf = leaf;
-    node->n = 0;
-    node->next = NULL;
-    
+static ttak_bplus_node_t *create_node(const ttak_bplus_tree_t *tree, bool leaf, uint64_t now) {
     // Allocate max size (order is max children, so max keys = order-1, but we allow order for overflow handling before split)
     // Actually safe implementation allocates order+1 slots to simplify "insert then split".
-    int cap = order + 1;
-    node->keys = (void **)ttak_mem_alloc_raw(sizeof(void *) * cap, __TTAK_UNSAFE_MEM_FOREVER__, now);
-    
-    if (leaf) {
-        node->values = (void **)ttak_mem_alloc_raw(sizeof(void *) * cap, __TTAK_UNSAFE_MEM_FOREVER__, now);
-        node->children = NULL;
+    size_t cap = (size_t)tree->order + 1;
+    ttak_bplus_node_t *node;
+
+    if (tree->arena) {
+        size_t bytes = sizeof(*node) + sizeof(void *) * (2 * cap + (leaf ? 0 : 1));
+        node = ttak_arena_generation_claim_lane(tree->arena_env, tree->arena, tree->arena_lane, bytes);
+        if (!node) return NULL;
+        node->keys = (void **)(node + 1);
+        node->values = leaf ? node->keys + cap : NULL;
+        node->children = leaf ? NULL : (struct ttak_bplus_node **)(node->keys + cap);
     } else {
-        node->children = (struct ttak_bplus_node **)ttak_mem_alloc_raw(sizeof(struct ttak_bplus_node *) * (cap + 1), __TTAK_UNSAFE_MEM_FOREVER__, now);
-        node->values = NULL;
+        node = (ttak_bplus_node_t *)ttak_mem_alloc_raw(sizeof(ttak_bplus_node_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (!node) return NULL;
+        node->keys = (void **)ttak_mem_alloc_raw(sizeof(void *) * cap, __TTAK_UNSAFE_MEM_FOREVER__, now);
+
+        if (leaf) {
+            node->values = (void **)ttak_mem_alloc_raw(sizeof(void *) * cap, __TTAK_UNSAFE_MEM_FOREVER__, now);
+            node->children = NULL;
+        } else {
+            node->children = (struct ttak_bplus_node **)ttak_mem_alloc_raw(sizeof(struct ttak_bplus_node *) * (cap + 1), __TTAK_UNSAFE_MEM_FOREVER__, now);
+            node->values = NULL;
+        }
     }
-    
+
+    node->is_leaf = leaf;
+    node->n = 0;
+    node->next = NULL;
     return node;
 }
 
+/**
+ * @brief Release one node's storage without touching its keys or values.
+ *
+ * Arena nodes stay in place until their generation is retired.
+ */
+static void free_node(const ttak_bplus_tree_t *tree, ttak_bplus_node_t *node) {
+    if (tree->arena) return;
+    ttak_mem_free(node->keys);
+    if (node->is_leaf) ttak_mem_free(node->values);
+    else ttak_mem_free(node->children);
+    ttak_mem_free(node);
+}
+
+/**
+ * @brief Check that a node is still live; arena nodes carry no header to check.
+ */
+static bool node_live(const ttak_bplus_tree_t *tree, ttak_bplus_node_t *node, uint64_t now) {
+    return tree->arena || ttak_mem_access(node, now);
+}
+
+/**
+ * @brief Fewest keys a non-root node keeps; a merge of two such nodes still fits.
+ */
+static int min_keys(const ttak_bplus_tree_t *tree) {
+    return (tree->order - 1) / 2;
+}
+
 /**
  * @brief Initialize a B+ tree with comparison and destructor callbacks.
  *
@@ -53,6 +93,27 @@ void ttak_bplus_init(ttak_bplus_tree_t *tree, int order, int (*cmp)(const void*,
     tree->cmp = cmp;
     tree->key_free = kf;
     tree->val_free = vf;
+    tree->arena_env = NULL;
+    tree->arena = NULL;
+    tree->arena_lane = 0;
+}
+
+/**
+ * @brief Back an empty tree's nodes with an arena lane.
+ *
+ * @param tree       Empty tree.
+ * @param env        Arena helper context.
+ * @param generation Laned generation the nodes are claimed from.
+ * @param lane       Lane the tree claims from; no other thread may use it.
+ * @return False if the tree holds nodes or the generation has no lanes.
+ */
+bool ttak_bplus_use_arena(ttak_bplus_tree_t *tree, ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                          uint32_t lane) {
+    if (!tree || tree->root || !env || !generation || !generation->lanes) return false;
+    tree->arena_env = env;
+    tree->arena = generation;
+    tree->arena_lane = lane;
+    return true;
 }
 
 /**
@@ -68,7 +129,7 @@ void *ttak_bplus_get(ttak_bplus_tree_t *tree, const void *key, uint64_t now) {
     ttak_bplus_node_t *c = tree->root;
     
     while (!c->is_leaf) {
-        if (!ttak_mem_access(c, now)) return NULL;
+        if (!node_live(tree, c, now)) return NULL;
         int i = 0;
         while (i < c->n && tree->cmp(key, c->keys[i]) >= 0) {
             i++;
@@ -76,7 +137,7 @@ void *ttak_bplus_get(ttak_bplus_tree_t *tree, const void *key, uint64_t now) {
         c = c->children[i];
     }
     
-    if (!ttak_mem_access(c, now)) return NULL;
+    if (!node_live(tree, c, now)) return NULL;
     for (int i = 0; i < c->n; i++) {
         if (tree->cmp(key, c->keys[i]) == 0) {
             return c->values[i];
@@ -85,6 +146,47 @@ void *ttak_bplus_get(ttak_bplus_tree_t *tree, const void *key, uint64_t now) {
     return NULL;
 }
 
+/**
+ * @brief Visit the pairs between two bounds by walking the leaf list.
+ *
+ * @param tree  Tree to scan.
+ * @param lo    Inclusive lower bound, or NULL.
+ * @param hi    Inclusive upper bound, or NULL.
+ * @param visit Called per pair; returning false ends the scan.
+ * @param ctx   Passed through to @p visit.
+ * @param now   Timestamp for pointer validation.
+ * @return Number of pairs visited.
+ */
+size_t ttak_bplus_range(ttak_bplus_tree_t *tree, const void *lo, const void *hi,
+                        ttak_bplus_visit_t visit, void *ctx, uint64_t now) {
+    if (!tree || !tree->root || !visit) return 0;
+    ttak_bplus_node_t *c = tree->root;
+
+    while (!c->is_leaf) {
+        if (!node_live(tree, c, now)) return 0;
+        int i = 0;
+        while (lo && i < c->n && tree->cmp(lo, c->keys[i]) >= 0) {
+            i++;
+        }
+        c = c->children[i];
+    }
+
+    size_t visited = 0;
+    int i = 0;
+    while (lo && i < c->n && tree->cmp(c->keys[i], lo) < 0) {
+        i++;
+    }
+    for (; c; c = c->next, i = 0) {
+        if (!node_live(tree, c, now)) break;
+        for (; i < c->n; i++) {
+            if (hi && tree->cmp(c->keys[i], hi) > 0) return visited;
+            visited++;
+            if (!visit(c->keys[i], c->values[i], ctx)) return visited;
+        }
+    }
+    return visited;
+}
+
 /**
  * @brief Insert a promoted key into the parent chain, splitting as needed.
  *
@@ -100,7 +202,7 @@ static void insert_parent(ttak_bplus_tree_t *tree, ttak_bplus_node_t *left, void
                           ttak_bplus_node_t **parents, int parent_idx, uint64_t now) {
     if (parent_idx < 0) {
         // New Root
-        ttak_bplus_node_t *root = create_node(tree->order, false, now);
+        ttak_bplus_node_t *root = create_node(tree, false, now);
         root->keys[0] = key;
         root->children[0] = left;
         root->children[1] = right;
@@ -126,7 +228,7 @@ static void insert_parent(ttak_bplus_tree_t *tree, ttak_bplus_node_t *left, void
 
     if (parent->n >= tree->order) {
         // Split internal
-        ttak_bplus_node_t *new_node = create_node(tree->order, false, now);
+        ttak_bplus_node_t *new_node = create_node(tree, false, now);
         int split_idx = (tree->order + 1) / 2; // Bias left? usually order/2.
         // Actually for internal:
         // Keys: [0..split-1] stay, [split] moves up, [split+1..end] move right
@@ -161,7 +263,7 @@ void ttak_bplus_insert(ttak_bplus_tree_t *tree, void *key, void *value, uint64_t
     if (!tree) return;
     
     if (!tree->root) {
-        tree->root = create_node(tree->order, true, now);
+        tree->root = create_node(tree, true, now);
         tree->root->keys[0] = key;
         tree->root->values[0] = value;
         tree->root->n = 1;
@@ -206,7 +308,7 @@ void ttak_bplus_insert(ttak_bplus_tree_t *tree, void *key, void *value, uint64_t
 
     if (leaf->n >= tree->order) {
         // Split leaf
-        ttak_bplus_node_t *new_leaf = create_node(tree->order, true, now);
+        ttak_bplus_node_t *new_leaf = create_node(tree, true, now);
         int split = (tree->order + 1) / 2;
         
         // Move second half
@@ -227,47 +329,340 @@ void ttak_bplus_insert(ttak_bplus_tree_t *tree, void *key, void *value, uint64_t
     }
 }
 
+/**
+ * @brief Restore the minimum fill of @p c after it lost a key.
+ *
+ * Borrows a key from an adjacent sibling when one can spare it, otherwise
+ * merges with a sibling, which removes a key from the parent; that parent
+ * is then rebalanced in turn.
+ *
+ * @param tree    B+ tree instance.
+ * @param c       Node that may have underflowed.
+ * @param parents Ancestors of @p c, root first.
+ * @param slots   Child index taken at each ancestor.
+ * @param depth   Number of ancestors.
+ */
+static void rebalance(ttak_bplus_tree_t *tree, ttak_bplus_node_t *c, ttak_bplus_node_t **parents,
+                      int *slots, int depth) {
+    int min = min_keys(tree);
+    while (depth > 0 && c->n < min) {
+        ttak_bplus_node_t *p = parents[depth - 1];
+        int ci = slots[depth - 1];
+        ttak_bplus_node_t *left = ci > 0 ? p->children[ci - 1] : NULL;
+        ttak_bplus_node_t *right = ci < p->n ? p->children[ci + 1] : NULL;
+
+        if (left && left->n > min) {
+            // Rotate left's last entry into the front of c.
+            for (int j = c->n; j > 0; j--) c->keys[j] = c->keys[j - 1];
+            if (c->is_leaf) {
+                for (int j = c->n; j > 0; j--) c->values[j] = c->values[j - 1];
+                c->keys[0] = left->keys[left->n - 1];
+                c->values[0] = left->values[left->n - 1];
+                p->keys[ci - 1] = c->keys[0];
+            } else {
+                for (int j = c->n + 1; j > 0; j--) c->children[j] = c->children[j - 1];
+                c->keys[0] = p->keys[ci - 1];
+                c->children[0] = left->children[left->n];
+                p->keys[ci - 1] = left->keys[left->n - 1];
+            }
+            c->n++;
+            left->n--;
+            return;
+        }
+        if (right && right->n > min) {
+            // Rotate right's first entry onto the end of c.
+            if (c->is_leaf) {
+                c->keys[c->n] = right->keys[0];
+                c->values[c->n] = right->values[0];
+                for (int j = 0; j < right->n - 1; j++) {
+                    right->keys[j] = right->keys[j + 1];
+                    right->values[j] = right->values[j + 1];
+                }
+                p->keys[ci] = right->keys[0];
+            } else {
+                c->keys[c->n] = p->keys[ci];
+                c->children[c->n + 1] = right->children[0];
+                p->keys[ci] = right->keys[0];
+                for (int j = 0; j < right->n - 1; j++) right->keys[j] = right->keys[j + 1];
+                for (int j = 0; j < right->n; j++) right->children[j] = right->children[j + 1];
+            }
+            c->n++;
+            right->n--;
+            return;
+        }
+
+        // Merge the pair (dst, src) around separator p->keys[k].
+        int k = left ? ci - 1 : ci;
+        ttak_bplus_node_t *dst = left ? left : c;
+        ttak_bplus_node_t *src = left ? c : right;
+        if (dst->is_leaf) {
+            for (int j = 0; j < src->n; j++) {
+                dst->keys[dst->n + j] = src->keys[j];
+                dst->values[dst->n + j] = src->values[j];
+            }
+            dst->n += src->n;
+            dst->next = src->next;
+        } else {
+            dst->keys[dst->n] = p->keys[k];
+            for (int j = 0; j < src->n; j++) dst->keys[dst->n + 1 + j] = src->keys[j];
+            for (int j = 0; j <= src->n; j++) dst->children[dst->n + 1 + j] = src->children[j];
+            dst->n += 1 + src->n;
+        }
+        free_node(tree, src);
+        for (int j = k; j < p->n - 1; j++) p->keys[j] = p->keys[j + 1];
+        for (int j = k + 1; j < p->n; j++) p->children[j] = p->children[j + 1];
+        p->n--;
+
+        c = p;
+        depth--;
+    }
+
+    ttak_bplus_node_t *root = tree->root;
+    if (root->n == 0) {
+        if (root->is_leaf) {
+            tree->root = NULL;
+        } else {
+            tree->root = root->children[0];
+        }
+        free_node(tree, root);
+    }
+}
+
+/**
+ * @brief Remove a key and free its pair through the tree's callbacks.
+ *
+ * @param tree Tree to mutate.
+ * @param key  Key to remove.
+ * @param now  Timestamp for pointer validation.
+ * @return true if the key was present.
+ */
+bool ttak_bplus_remove(ttak_bplus_tree_t *tree, const void *key, uint64_t now) {
+    if (!tree || !tree->root) return false;
+
+    ttak_bplus_node_t *leaf = tree->root;
+    ttak_bplus_node_t *parents[MAX_PATH];
+    int slots[MAX_PATH];
+    int depth = 0;
+    while (!leaf->is_leaf) {
+        if (!node_live(tree, leaf, now)) return false;
+        int i = 0;
+        while (i < leaf->n && tree->cmp(key, leaf->keys[i]) >= 0) {
+            i++;
+        }
+        parents[depth] = leaf;
+        slots[depth++] = i;
+        leaf = leaf->children[i];
+    }
+    if (!node_live(tree, leaf, now)) return false;
+
+    int i = 0;
+    while (i < leaf->n && tree->cmp(key, leaf->keys[i]) > 0) {
+        i++;
+    }
+    if (i == leaf->n || tree->cmp(key, leaf->keys[i]) != 0) return false;
+    void *old_key = leaf->keys[i];
+    void *old_val = leaf->values[i];
+
+    // A leaf's first key may also route in one ancestor; point it at the successor.
+    if (i == 0) {
+        void *succ = leaf->n > 1 ? leaf->keys[1] : (leaf->next ? leaf->next->keys[0] : NULL);
+        for (int d = depth - 1; d >= 0; d--) {
+            int ci = slots[d];
+            if (ci > 0 && parents[d]->keys[ci - 1] == old_key) {
+                if (succ) parents[d]->keys[ci - 1] = succ;
+                break;
+            }
+        }
+    }
+
+    for (int j = i; j < leaf->n - 1; j++) {
+        leaf->keys[j] = leaf->keys[j + 1];
+        leaf->values[j] = leaf->values[j + 1];
+    }
+    leaf->n--;
+    rebalance(tree, leaf, parents, slots, depth);
+
+    if (tree->key_free) tree->key_free(old_key);
+    if (tree->val_free && old_val) tree->val_free(old_val);
+    return true;
+}
+
+/**
+ * @brief Number of nodes to split @p items entries into at one level.
+ *
+ * Aims for @p per entries per node, but never leaves a node of a
+ * multi-node level below @p min.
+ */
+static size_t bulk_nodes(size_t items, size_t per, size_t min) {
+    size_t nodes = (items + per - 1) / per;
+    if (nodes > 1 && items / nodes < min) nodes = min ? items / min : 1;
+    return nodes ? nodes : 1;
+}
+
+/**
+ * @brief Free the nodes of a partly built level and the subtrees beneath them.
+ */
+static void bulk_discard(const ttak_bplus_tree_t *tree, ttak_bplus_node_t **nodes, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        ttak_bplus_node_t *node = nodes[i];
+        if (!node->is_leaf) bulk_discard(tree, node->children, (size_t)node->n + 1);
+        free_node(tree, node);
+    }
+}
+
+/**
+ * @brief Build the tree bottom-up from pairs sorted by strictly increasing key.
+ *
+ * @param tree   Empty tree to fill.
+ * @param keys   Sorted keys, taken over by the tree.
+ * @param values Values matching @p keys.
+ * @param n      Number of pairs.
+ * @param fill   Fraction of each node to fill (0, 1]; lower leaves room
+ *               for later inserts without splits.
+ * @param now    Timestamp for allocations.
+ * @return false if the tree was not empty, the keys were not sorted, or
+ *         allocation failed; the tree is then left unchanged.
+ */
+bool ttak_bplus_bulk_load(ttak_bplus_tree_t *tree, void *const *keys, void *const *values, size_t n,
+                          double fill, uint64_t now) {
+    if (!tree || tree->root || !keys || !values) return false;
+    if (n == 0) return true;
+    for (size_t i = 1; i < n; i++) {
+        if (tree->cmp(keys[i - 1], keys[i]) >= 0) return false;
+    }
+    if (!(fill > 0.0) || fill > 1.0) fill = 1.0;
+
+    size_t max = (size_t)tree->order - 1;
+    size_t min = (size_t)min_keys(tree);
+    size_t per = (size_t)(fill * (double)max + 0.5);
+    if (per < min) per = min;
+    if (per < 1) per = 1;
+    if (per > max) per = max;
+
+    // Leaves, linked left to right.
+    size_t count = bulk_nodes(n, per, min);
+    ttak_bplus_node_t **level = malloc(count * sizeof(*level));
+    void **low = malloc(count * sizeof(*low));
+    if (!level || !low) {
+        free(level);
+        free(low);
+        return false;
+    }
+    size_t pos = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t take = n / count + (i < n % count);
+        ttak_bplus_node_t *leaf = create_node(tree, true, now);
+        if (!leaf || !leaf->keys || !leaf->values) {
+            if (leaf) free_node(tree, leaf);
+            bulk_discard(tree, level, i);
+            free(level);
+            free(low);
+            return false;
+        }
+        for (size_t j = 0; j < take; j++) {
+            leaf->keys[j] = keys[pos + j];
+            leaf->values[j] = values[pos + j];
+        }
+        leaf->n = (int)take;
+        if (i > 0) level[i - 1]->next = leaf;
+        level[i] = leaf;
+        low[i] = keys[pos];
+        pos += take;
+    }
+
+    // Internal levels: each parent routes by the lowest key of its children after the first.
+    while (count > 1) {
+        size_t parents = bulk_nodes(count, per + 1, min + 1);
+        ttak_bplus_node_t **up = malloc(parents * sizeof(*up));
+        void **up_low = malloc(parents * sizeof(*up_low));
+        if (!up || !up_low) {
+            free(up);
+            free(up_low);
+            bulk_discard(tree, level, count);
+            free(level);
+            free(low);
+            return false;
+        }
+        size_t c = 0;
+        for (size_t i = 0; i < parents; i++) {
+            size_t take = count / parents + (i < count % parents);
+            ttak_bplus_node_t *node = create_node(tree, false, now);
+            if (!node || !node->keys || !node->children) {
+                if (node) free_node(tree, node);
+                for (size_t j = 0; j < i; j++) free_node(tree, up[j]);
+                bulk_discard(tree, level, count);
+                free(up);
+                free(up_low);
+                free(level);
+                free(low);
+                return false;
+            }
+            for (size_t j = 0; j < take; j++) {
+                node->children[j] = level[c + j];
+                if (j > 0) node->keys[j - 1] = low[c + j];
+            }
+            node->n = (int)take - 1;
+            up[i] = node;
+            up_low[i] = low[c];
+            c += take;
+        }
+        free(level);
+        free(low);
+        level = up;
+        low = up_low;
+        count = parents;
+    }
+
+    tree->root = level[0];
+    free(level);
+    free(low);
+    return true;
+}
+
 /**
  * @brief Recursively destroy an entire subtree.
  *
+ * @param tree Tree owning the nodes.
  * @param node Node to destroy.
  * @param kf   Key destructor.
  * @param vf   Value destructor.
  * @param now  Timestamp for memory bookkeeping.
  */
-static void recursive_destroy(ttak_bplus_node_t *node, void (*kf)(void*), void (*vf)(void*), uint64_t now) {
+static void recursive_destroy(const ttak_bplus_tree_t *tree, ttak_bplus_node_t *node, void (*kf)(void*), void (*vf)(void*), uint64_t now) {
     if (!node) return;
     if (!node->is_leaf) {
         for (int i = 0; i <= node->n; i++) {
-            recursive_destroy(node->children[i], kf, vf, now);
+            recursive_destroy(tree, node->children[i], kf, vf, now);
         }
-        ttak_mem_free(node->children);
     } else {
         if (vf) {
             for (int i = 0; i < node->n; i++) {
                  vf(node->values[i]);
             }
         }
-        ttak_mem_free(node->values);
-    }
-    
-    if (kf) {
-        for (int i = 0; i < node->n; i++) {
-            kf(node->keys[i]);
+        // Internal routing keys alias leaf keys, so only leaves own them.
+        if (kf) {
+            for (int i = 0; i < node->n; i++) {
+                kf(node->keys[i]);
+            }
         }
     }
-    ttak_mem_free(node->keys);
-    ttak_mem_free(node);
+    free_node(tree, node);
 }
 
 /**
  * @brief Destroy the B+ tree and release all nodes.
  *
+ * An arena-backed tree without destructors is dropped without a walk;
+ * retiring its generation then releases the nodes in one step.
+ *
  * @param tree Tree to destroy.
  * @param now  Timestamp for destructor bookkeeping.
  */
 void ttak_bplus_destroy(ttak_bplus_tree_t *tree, uint64_t now) {
     if (!tree || !tree->root) return;
-    recursive_destroy(tree->root, tree->key_free, tree->val_free, now);
+    if (!tree->arena || tree->key_free || tree->val_free) {
+        recursive_destroy(tree, tree->root, tree->key_free, tree->val_free, now);
+    }
     tree->root = NULL;
 }
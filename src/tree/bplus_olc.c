@@ -0,0 +1,415 @@
+#include <ttak/tree/bplus_olc.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mem/mem.h>
+#include <sched.h>
+
+#define OLC_HALF (TTAK_BPLUS_OLC_FANOUT / 2)
+#define OLC_OBSOLETE 1u
+#define OLC_LOCKED 2u
+
+#define olc_load(p) atomic_load_explicit((p), memory_order_relaxed)
+#define olc_store(p, v) atomic_store_explicit((p), (v), memory_order_relaxed)
+
+static ttak_bplus_olc_node_t *olc_node_new(bool leaf) {
+    ttak_bplus_olc_node_t *node = ttak_dangerous_calloc(1, sizeof(*node));
+    if (node) node->leaf = leaf;
+    return node;
+}
+
+/* Backs off before a restart; the lock holder may need this CPU to finish. */
+static void olc_backoff(unsigned *spins) {
+    if (++*spins & 63) ttak_arch_pause();
+    else sched_yield();
+}
+
+/* Starts an optimistic read; false if the node is locked or unlinked. */
+static inline bool olc_read(ttak_bplus_olc_node_t *node, uint64_t *v) {
+    uint64_t x = atomic_load_explicit(&node->version, memory_order_acquire);
+    if (x & (OLC_LOCKED | OLC_OBSOLETE)) return false;
+    *v = x;
+    return true;
+}
+
+/* True if nothing wrote @p node since olc_read() returned @p v. */
+static inline bool olc_valid(ttak_bplus_olc_node_t *node, uint64_t v) {
+    atomic_thread_fence(memory_order_acquire);
+    return olc_load(&node->version) == v;
+}
+
+/* Takes the write lock if the node is still at version @p v. */
+static inline bool olc_lock(ttak_bplus_olc_node_t *node, uint64_t v) {
+    return atomic_compare_exchange_strong_explicit(&node->version, &v, v + OLC_LOCKED,
+                                                   memory_order_acquire, memory_order_relaxed);
+}
+
+static inline void olc_unlock(ttak_bplus_olc_node_t *node) {
+    atomic_fetch_add_explicit(&node->version, OLC_LOCKED, memory_order_release);
+}
+
+static inline void olc_unlock_obsolete(ttak_bplus_olc_node_t *node) {
+    atomic_fetch_add_explicit(&node->version, OLC_LOCKED | OLC_OBSOLETE, memory_order_release);
+}
+
+/* Key count, clamped so a torn read cannot index past the arrays. */
+static inline uint32_t olc_count(ttak_bplus_olc_node_t *node) {
+    uint32_t n = olc_load(&node->n);
+    return n > TTAK_BPLUS_OLC_FANOUT ? TTAK_BPLUS_OLC_FANOUT : n;
+}
+
+/* Keys below @p key, or at most @p key when @p inclusive; branch-free. */
+static inline uint32_t olc_rank(ttak_bplus_olc_node_t *node, uint32_t n, uint64_t key, bool inclusive) {
+    uint32_t r = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t k = olc_load(&node->keys[i]);
+        r += inclusive ? k <= key : k < key;
+    }
+    return r;
+}
+
+bool ttak_bplus_olc_init(ttak_bplus_olc_t *tree) {
+    if (!tree) return false;
+    ttak_bplus_olc_node_t *root = olc_node_new(true);
+    atomic_init(&tree->root, root);
+    atomic_init(&tree->size, 0);
+    return root != NULL;
+}
+
+static void olc_free(ttak_bplus_olc_node_t *node) {
+    if (!node->leaf) {
+        uint32_t n = olc_load(&node->n);
+        for (uint32_t i = 0; i <= n; i++) olc_free(olc_load(&node->children[i]));
+    }
+    ttak_dangerous_free(node);
+}
+
+void ttak_bplus_olc_destroy(ttak_bplus_olc_t *tree) {
+    if (!tree) return;
+    ttak_bplus_olc_node_t *root = olc_load(&tree->root);
+    if (root) olc_free(root);
+    olc_store(&tree->root, NULL);
+    olc_store(&tree->size, 0);
+}
+
+/*
+ * Descends optimistically to the leaf for @p key. On success *leaf is read
+ * at version *lv, and *parent (NULL for a root leaf) at *pv with the leaf
+ * at child index *slot. False means restart.
+ */
+static bool olc_descend(ttak_bplus_olc_t *tree, uint64_t key, ttak_bplus_olc_node_t **leaf, uint64_t *lv,
+                        ttak_bplus_olc_node_t **parent, uint64_t *pv, uint32_t *slot) {
+    ttak_bplus_olc_node_t *node = atomic_load_explicit(&tree->root, memory_order_acquire);
+    uint64_t v;
+    if (!olc_read(node, &v)) return false;
+    // The root may have split between loading it and reading its version.
+    if (node != atomic_load_explicit(&tree->root, memory_order_acquire)) return false;
+
+    ttak_bplus_olc_node_t *p = NULL;
+    uint64_t p_v = 0;
+    uint32_t ci = 0;
+    while (!node->leaf) {
+        ci = olc_rank(node, olc_count(node), key, true);
+        ttak_bplus_olc_node_t *child = olc_load(&node->children[ci]);
+        uint64_t cv;
+        if (!child || !olc_read(child, &cv) || !olc_valid(node, v)) return false;
+        p = node;
+        p_v = v;
+        node = child;
+        v = cv;
+    }
+    *leaf = node;
+    *lv = v;
+    if (parent) {
+        *parent = p;
+        *pv = p_v;
+        *slot = ci;
+    }
+    return true;
+}
+
+bool ttak_bplus_olc_get_pinned(ttak_bplus_olc_t *tree, uint64_t key, uint64_t *out) {
+    for (unsigned spins = 0;; olc_backoff(&spins)) {
+        ttak_bplus_olc_node_t *leaf;
+        uint64_t v;
+        if (!olc_descend(tree, key, &leaf, &v, NULL, NULL, NULL)) continue;
+        uint32_t n = olc_count(leaf);
+        uint32_t pos = olc_rank(leaf, n, key, false);
+        bool found = pos < n && olc_load(&leaf->keys[pos]) == key;
+        uint64_t val = found ? olc_load(&leaf->values[pos]) : 0;
+        if (!olc_valid(leaf, v)) continue;
+        if (found && out) *out = val;
+        return found;
+    }
+}
+
+bool ttak_bplus_olc_get(ttak_bplus_olc_t *tree, uint64_t key, uint64_t *out) {
+    ttak_epoch_enter();
+    bool found = ttak_bplus_olc_get_pinned(tree, key, out);
+    ttak_epoch_exit();
+    return found;
+}
+
+/* Inserts separator @p sep with right child @p right into locked inner @p node, which has room. */
+static void olc_inner_put(ttak_bplus_olc_node_t *node, uint64_t sep, ttak_bplus_olc_node_t *right) {
+    uint32_t n = olc_load(&node->n);
+    uint32_t pos = olc_rank(node, n, sep, false);
+    for (uint32_t j = n; j > pos; j--) {
+        olc_store(&node->keys[j], olc_load(&node->keys[j - 1]));
+        olc_store(&node->children[j + 1], olc_load(&node->children[j]));
+    }
+    olc_store(&node->keys[pos], sep);
+    olc_store(&node->children[pos + 1], right);
+    olc_store(&node->n, n + 1);
+}
+
+/* Moves the upper half of locked, full @p node to a new sibling; NULL on allocation failure. */
+static ttak_bplus_olc_node_t *olc_split(ttak_bplus_olc_node_t *node, uint64_t *sep) {
+    ttak_bplus_olc_node_t *right = olc_node_new(node->leaf);
+    if (!right) return NULL;
+    if (node->leaf) {
+        for (uint32_t j = OLC_HALF; j < TTAK_BPLUS_OLC_FANOUT; j++) {
+            olc_store(&right->keys[j - OLC_HALF], olc_load(&node->keys[j]));
+            olc_store(&right->values[j - OLC_HALF], olc_load(&node->values[j]));
+        }
+        olc_store(&right->n, TTAK_BPLUS_OLC_FANOUT - OLC_HALF);
+        *sep = olc_load(&right->keys[0]);
+    } else {
+        // keys[OLC_HALF] moves up; the keys and children after it move right.
+        for (uint32_t j = OLC_HALF + 1; j < TTAK_BPLUS_OLC_FANOUT; j++) {
+            olc_store(&right->keys[j - OLC_HALF - 1], olc_load(&node->keys[j]));
+        }
+        for (uint32_t j = OLC_HALF + 1; j <= TTAK_BPLUS_OLC_FANOUT; j++) {
+            olc_store(&right->children[j - OLC_HALF - 1], olc_load(&node->children[j]));
+        }
+        olc_store(&right->n, TTAK_BPLUS_OLC_FANOUT - OLC_HALF - 1);
+        *sep = olc_load(&node->keys[OLC_HALF]);
+    }
+    olc_store(&node->n, OLC_HALF);
+    return right;
+}
+
+/*
+ * Splits @p node, read at @p v, under the locks of it and its parent,
+ * publishing the new sibling. Returns 1 when the split happened, 0 when
+ * the caller must restart, and -1 on allocation failure.
+ */
+static int olc_split_locked(ttak_bplus_olc_t *tree, ttak_bplus_olc_node_t *node, uint64_t v,
+                            ttak_bplus_olc_node_t *parent, uint64_t pv) {
+    if (parent && !olc_lock(parent, pv)) return 0;
+    if (!olc_lock(node, v)) {
+        if (parent) olc_unlock(parent);
+        return 0;
+    }
+    if (!parent && node != olc_load(&tree->root)) {
+        olc_unlock(node);
+        return 0;
+    }
+
+    ttak_bplus_olc_node_t *root = NULL;
+    if (!parent && !(root = olc_node_new(false))) {
+        olc_unlock(node);
+        return -1;
+    }
+    uint64_t sep;
+    ttak_bplus_olc_node_t *right = olc_split(node, &sep);
+    if (!right) {
+        if (root) ttak_dangerous_free(root);
+        olc_unlock(node);
+        if (parent) olc_unlock(parent);
+        return -1;
+    }
+    if (parent) {
+        olc_inner_put(parent, sep, right);
+        olc_unlock(parent);
+    } else {
+        olc_store(&root->keys[0], sep);
+        olc_store(&root->children[0], node);
+        olc_store(&root->children[1], right);
+        olc_store(&root->n, 1);
+        atomic_store_explicit(&tree->root, root, memory_order_release);
+    }
+    olc_unlock(node);
+    return 1;
+}
+
+/*
+ * Like olc_descend(), but splits the first full node met on the way and
+ * reports a restart, so the leaf reached has room and so has every inner
+ * node above it. Sets *failed on allocation failure.
+ */
+static bool olc_descend_for_insert(ttak_bplus_olc_t *tree, uint64_t key, ttak_bplus_olc_node_t **leaf,
+                                   uint64_t *lv, bool *failed) {
+    ttak_bplus_olc_node_t *node = atomic_load_explicit(&tree->root, memory_order_acquire);
+    uint64_t v;
+    if (!olc_read(node, &v)) return false;
+    if (node != atomic_load_explicit(&tree->root, memory_order_acquire)) return false;
+
+    ttak_bplus_olc_node_t *parent = NULL;
+    uint64_t pv = 0;
+    for (;;) {
+        uint32_t n = olc_count(node);
+        if (n == TTAK_BPLUS_OLC_FANOUT) {
+            if (olc_split_locked(tree, node, v, parent, pv) < 0) *failed = true;
+            return false;
+        }
+        if (node->leaf) break;
+        ttak_bplus_olc_node_t *child = olc_load(&node->children[olc_rank(node, n, key, true)]);
+        uint64_t cv;
+        if (!child || !olc_read(child, &cv) || !olc_valid(node, v)) return false;
+        parent = node;
+        pv = v;
+        node = child;
+        v = cv;
+    }
+    *leaf = node;
+    *lv = v;
+    return true;
+}
+
+bool ttak_bplus_olc_insert(ttak_bplus_olc_t *tree, uint64_t key, uint64_t value) {
+    ttak_epoch_enter();
+    for (unsigned spins = 0;; olc_backoff(&spins)) {
+        ttak_bplus_olc_node_t *leaf;
+        uint64_t v;
+        bool failed = false;
+        if (!olc_descend_for_insert(tree, key, &leaf, &v, &failed)) {
+            if (failed) {
+                ttak_epoch_exit();
+                return false;
+            }
+            continue;
+        }
+        // An unchanged version means the leaf still has room and still covers key.
+        if (!olc_lock(leaf, v)) continue;
+
+        uint32_t n = olc_load(&leaf->n);
+        uint32_t pos = olc_rank(leaf, n, key, false);
+        if (pos < n && olc_load(&leaf->keys[pos]) == key) {
+            olc_store(&leaf->values[pos], value);
+        } else {
+            for (uint32_t j = n; j > pos; j--) {
+                olc_store(&leaf->keys[j], olc_load(&leaf->keys[j - 1]));
+                olc_store(&leaf->values[j], olc_load(&leaf->values[j - 1]));
+            }
+            olc_store(&leaf->keys[pos], key);
+            olc_store(&leaf->values[pos], value);
+            olc_store(&leaf->n, n + 1);
+            atomic_fetch_add_explicit(&tree->size, 1, memory_order_relaxed);
+        }
+        olc_unlock(leaf);
+        ttak_epoch_exit();
+        return true;
+    }
+}
+
+/* Unlinks the empty, locked child at @p slot from @p parent if the parent is still at @p pv and keeps a child. */
+static bool olc_unlink_leaf(ttak_bplus_olc_node_t *parent, uint64_t pv, uint32_t slot) {
+    if (!parent || !olc_lock(parent, pv)) return false;
+    uint32_t n = olc_load(&parent->n);
+    if (n == 0) {
+        olc_unlock(parent);
+        return false;
+    }
+    // Drop the separator on the side of the leaf that still has a neighbour.
+    uint32_t k = slot > 0 ? slot - 1 : 0;
+    for (uint32_t j = k; j + 1 < n; j++) olc_store(&parent->keys[j], olc_load(&parent->keys[j + 1]));
+    for (uint32_t j = slot; j < n; j++) olc_store(&parent->children[j], olc_load(&parent->children[j + 1]));
+    olc_store(&parent->n, n - 1);
+    olc_unlock(parent);
+    return true;
+}
+
+bool ttak_bplus_olc_remove(ttak_bplus_olc_t *tree, uint64_t key) {
+    ttak_epoch_enter();
+    for (unsigned spins = 0;; olc_backoff(&spins)) {
+        ttak_bplus_olc_node_t *leaf, *parent;
+        uint64_t v, pv;
+        uint32_t slot;
+        if (!olc_descend(tree, key, &leaf, &v, &parent, &pv, &slot)) continue;
+        if (!olc_lock(leaf, v)) continue;
+
+        uint32_t n = olc_load(&leaf->n);
+        uint32_t pos = olc_rank(leaf, n, key, false);
+        if (pos >= n || olc_load(&leaf->keys[pos]) != key) {
+            olc_unlock(leaf);
+            ttak_epoch_exit();
+            return false;
+        }
+        for (uint32_t j = pos; j + 1 < n; j++) {
+            olc_store(&leaf->keys[j], olc_load(&leaf->keys[j + 1]));
+            olc_store(&leaf->values[j], olc_load(&leaf->values[j + 1]));
+        }
+        olc_store(&leaf->n, n - 1);
+        atomic_fetch_sub_explicit(&tree->size, 1, memory_order_relaxed);
+
+        if (n == 1 && olc_unlink_leaf(parent, pv, slot)) {
+            olc_unlock_obsolete(leaf);
+            ttak_epoch_retire(leaf, ttak_dangerous_free);
+        } else {
+            olc_unlock(leaf);
+        }
+        ttak_epoch_exit();
+        return true;
+    }
+}
+
+size_t ttak_bplus_olc_range(ttak_bplus_olc_t *tree, uint64_t lo, uint64_t hi,
+                            ttak_bplus_olc_visit_t visit, void *ctx) {
+    if (!tree || !visit || lo > hi) return 0;
+    uint64_t keys[TTAK_BPLUS_OLC_FANOUT], vals[TTAK_BPLUS_OLC_FANOUT];
+    size_t visited = 0;
+    uint64_t cur = lo;
+
+    for (;;) {
+        uint32_t got = 0;
+        bool more = false;
+        uint64_t next = 0;
+        ttak_epoch_enter();
+        for (unsigned spins = 0;; olc_backoff(&spins)) {
+            // Descend to cur's leaf, noting the lowest separator above it as the next start.
+            ttak_bplus_olc_node_t *node = atomic_load_explicit(&tree->root, memory_order_acquire);
+            uint64_t v;
+            if (!olc_read(node, &v) || node != atomic_load_explicit(&tree->root, memory_order_acquire)) continue;
+            bool ok = true;
+            more = false;
+            while (ok && !node->leaf) {
+                uint32_t n = olc_count(node);
+                uint32_t ci = olc_rank(node, n, cur, true);
+                if (ci < n) {
+                    uint64_t up = olc_load(&node->keys[ci]);
+                    if (!more || up < next) next = up;
+                    more = true;
+                }
+                ttak_bplus_olc_node_t *child = olc_load(&node->children[ci]);
+                uint64_t cv;
+                ok = child && olc_read(child, &cv) && olc_valid(node, v);
+                if (ok) {
+                    node = child;
+                    v = cv;
+                }
+            }
+            if (!ok) continue;
+            uint32_t n = olc_count(node);
+            got = 0;
+            for (uint32_t i = olc_rank(node, n, cur, false); i < n; i++) {
+                uint64_t k = olc_load(&node->keys[i]);
+                if (k > hi) break;
+                keys[got] = k;
+                vals[got++] = olc_load(&node->values[i]);
+            }
+            if (olc_valid(node, v)) break;
+        }
+        ttak_epoch_exit();
+
+        for (uint32_t i = 0; i < got; i++) {
+            visited++;
+            if (!visit(keys[i], vals[i], ctx)) return visited;
+        }
+        if (!more || next > hi || next <= cur) return visited;
+        cur = next;
+    }
+}
+
+size_t ttak_bplus_olc_size(ttak_bplus_olc_t *tree) {
+    return tree ? atomic_load_explicit(&tree->size, memory_order_relaxed) : 0;
+}
@@ -0,0 +1,246 @@
+#include <ttak/tree/bplus_u64.h>
+#include <ttak/arch/ttak_arch.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(TTAK_HAS_AVX2)
+#include <immintrin.h>
+#elif defined(TTAK_HAS_NEON) && defined(TTAK_ARCH_AARCH64)
+#include <arm_neon.h>
+#endif
+
+#define BPLUS_U64_HALF (TTAK_BPLUS_U64_FANOUT / 2)
+#define BPLUS_U64_MAX_HEIGHT 32
+
+_Static_assert(TTAK_BPLUS_U64_FANOUT == 16, "node search is unrolled for 16 keys");
+
+static void *bplus_u64_aligned_alloc(size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, 64);
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, bytes) != 0) ptr = NULL;
+    return ptr;
+#endif
+}
+
+static void bplus_u64_aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+static ttak_bplus_u64_node_t *bplus_u64_node_new(bool leaf) {
+    ttak_bplus_u64_node_t *node = bplus_u64_aligned_alloc(sizeof(*node));
+    if (!node) return NULL;
+    memset(node, 0, sizeof(*node));
+    for (int i = 0; i < TTAK_BPLUS_U64_FANOUT; i++) node->keys[i] = UINT64_MAX;
+    node->leaf = leaf;
+    return node;
+}
+
+/*
+ * Number of the node's keys strictly below @p key (inclusive == false) or
+ * at most @p key (inclusive == true). Scans all slots and masks to n, so
+ * the UINT64_MAX padding only matters when key itself is UINT64_MAX.
+ */
+static inline uint32_t bplus_u64_rank(const ttak_bplus_u64_node_t *node, uint64_t key, bool inclusive) {
+    uint32_t mask;
+#if defined(TTAK_HAS_AVX2)
+    // No unsigned 64-bit compare; flip the sign bits and compare signed.
+    const __m256i bias = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+    __m256i k = _mm256_xor_si256(_mm256_set1_epi64x((long long)key), bias);
+    mask = 0;
+    for (int i = 0; i < TTAK_BPLUS_U64_FANOUT; i += 4) {
+        __m256i v = _mm256_xor_si256(_mm256_load_si256((const __m256i *)(node->keys + i)), bias);
+        // keys > key gives "at most" by complement; key > keys gives "below" directly.
+        __m256i hit = inclusive ? _mm256_cmpgt_epi64(v, k) : _mm256_cmpgt_epi64(k, v);
+        uint32_t bits = (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(hit));
+        mask |= (inclusive ? ~bits & 0xf : bits) << i;
+    }
+#elif defined(TTAK_HAS_NEON) && defined(TTAK_ARCH_AARCH64)
+    uint64x2_t k = vdupq_n_u64(key);
+    mask = 0;
+    for (int i = 0; i < TTAK_BPLUS_U64_FANOUT; i += 2) {
+        uint64x2_t v = vld1q_u64(node->keys + i);
+        uint64x2_t below = inclusive ? vcleq_u64(v, k) : vcltq_u64(v, k);
+        mask |= (uint32_t)(vgetq_lane_u64(below, 0) & 1) << i;
+        mask |= (uint32_t)(vgetq_lane_u64(below, 1) & 1) << (i + 1);
+    }
+#else
+    mask = 0;
+    for (int i = 0; i < TTAK_BPLUS_U64_FANOUT; i++) {
+        uint64_t kv = node->keys[i];
+        mask |= (uint32_t)(inclusive ? kv <= key : kv < key) << i;
+    }
+#endif
+    return (uint32_t)__builtin_popcount(mask & ((1u << node->n) - 1));
+}
+
+void ttak_bplus_u64_init(ttak_bplus_u64_t *tree) {
+    if (!tree) return;
+    tree->root = NULL;
+    tree->size = 0;
+    tree->height = 0;
+}
+
+/* Leaf that would hold @p key. */
+static const ttak_bplus_u64_node_t *bplus_u64_find_leaf(const ttak_bplus_u64_t *tree, uint64_t key) {
+    const ttak_bplus_u64_node_t *c = tree->root;
+    while (!c->leaf) c = c->children[bplus_u64_rank(c, key, true)];
+    return c;
+}
+
+bool ttak_bplus_u64_get(const ttak_bplus_u64_t *tree, uint64_t key, uint64_t *out) {
+    if (!tree || !tree->root) return false;
+    const ttak_bplus_u64_node_t *leaf = bplus_u64_find_leaf(tree, key);
+    uint32_t i = bplus_u64_rank(leaf, key, false);
+    if (i >= leaf->n || leaf->keys[i] != key) return false;
+    if (out) *out = leaf->values[i];
+    return true;
+}
+
+/* Inserts at @p i of a leaf with room. */
+static void bplus_u64_leaf_put(ttak_bplus_u64_node_t *leaf, uint32_t i, uint64_t key, uint64_t value) {
+    memmove(leaf->keys + i + 1, leaf->keys + i, (leaf->n - i) * sizeof(uint64_t));
+    memmove(leaf->values + i + 1, leaf->values + i, (leaf->n - i) * sizeof(uint64_t));
+    leaf->keys[i] = key;
+    leaf->values[i] = value;
+    leaf->n++;
+}
+
+/* Inserts separator @p sep and right child @p right after child @p ci of a node with room. */
+static void bplus_u64_inner_put(ttak_bplus_u64_node_t *node, uint32_t ci, uint64_t sep,
+                                ttak_bplus_u64_node_t *right) {
+    memmove(node->keys + ci + 1, node->keys + ci, (node->n - ci) * sizeof(uint64_t));
+    memmove(node->children + ci + 2, node->children + ci + 1, (node->n - ci) * sizeof(node->children[0]));
+    node->keys[ci] = sep;
+    node->children[ci + 1] = right;
+    node->n++;
+}
+
+/* Clears @p node's keys from @p from onward back to padding. */
+static void bplus_u64_truncate(ttak_bplus_u64_node_t *node, uint32_t from) {
+    for (uint32_t i = from; i < TTAK_BPLUS_U64_FANOUT; i++) node->keys[i] = UINT64_MAX;
+    node->n = from;
+}
+
+bool ttak_bplus_u64_insert(ttak_bplus_u64_t *tree, uint64_t key, uint64_t value) {
+    if (!tree) return false;
+    if (!tree->root) {
+        tree->root = bplus_u64_node_new(true);
+        if (!tree->root) return false;
+        tree->height = 1;
+    }
+
+    ttak_bplus_u64_node_t *path[BPLUS_U64_MAX_HEIGHT];
+    uint32_t slot[BPLUS_U64_MAX_HEIGHT];
+    int depth = 0;
+    ttak_bplus_u64_node_t *c = tree->root;
+    while (!c->leaf) {
+        uint32_t ci = bplus_u64_rank(c, key, true);
+        path[depth] = c;
+        slot[depth++] = ci;
+        c = c->children[ci];
+    }
+
+    uint32_t i = bplus_u64_rank(c, key, false);
+    if (i < c->n && c->keys[i] == key) {
+        c->values[i] = value;
+        return true;
+    }
+    if (c->n < TTAK_BPLUS_U64_FANOUT) {
+        bplus_u64_leaf_put(c, i, key, value);
+        tree->size++;
+        return true;
+    }
+
+    // Full leaf: move the upper half to a new right sibling.
+    ttak_bplus_u64_node_t *right = bplus_u64_node_new(true);
+    if (!right) return false;
+    memcpy(right->keys, c->keys + BPLUS_U64_HALF, BPLUS_U64_HALF * sizeof(uint64_t));
+    memcpy(right->values, c->values + BPLUS_U64_HALF, BPLUS_U64_HALF * sizeof(uint64_t));
+    right->n = BPLUS_U64_HALF;
+    bplus_u64_truncate(c, BPLUS_U64_HALF);
+    right->next = c->next;
+    c->next = right;
+    if (i <= BPLUS_U64_HALF) bplus_u64_leaf_put(c, i, key, value);
+    else bplus_u64_leaf_put(right, i - BPLUS_U64_HALF, key, value);
+    tree->size++;
+
+    uint64_t sep = right->keys[0];
+    ttak_bplus_u64_node_t *left = c;
+    while (depth > 0) {
+        ttak_bplus_u64_node_t *p = path[--depth];
+        uint32_t ci = slot[depth];
+        if (p->n < TTAK_BPLUS_U64_FANOUT) {
+            bplus_u64_inner_put(p, ci, sep, right);
+            return true;
+        }
+
+        // Full internal node: merge in the separator, keep the lower half,
+        // push the middle key up, and move the rest to a new sibling.
+        uint64_t keys[TTAK_BPLUS_U64_FANOUT + 1];
+        ttak_bplus_u64_node_t *kids[TTAK_BPLUS_U64_FANOUT + 2];
+        memcpy(keys, p->keys, ci * sizeof(uint64_t));
+        keys[ci] = sep;
+        memcpy(keys + ci + 1, p->keys + ci, (TTAK_BPLUS_U64_FANOUT - ci) * sizeof(uint64_t));
+        memcpy(kids, p->children, (ci + 1) * sizeof(kids[0]));
+        kids[ci + 1] = right;
+        memcpy(kids + ci + 2, p->children + ci + 1, (TTAK_BPLUS_U64_FANOUT - ci) * sizeof(kids[0]));
+
+        ttak_bplus_u64_node_t *sib = bplus_u64_node_new(false);
+        if (!sib) return false;
+        memcpy(p->keys, keys, BPLUS_U64_HALF * sizeof(uint64_t));
+        memcpy(p->children, kids, (BPLUS_U64_HALF + 1) * sizeof(kids[0]));
+        bplus_u64_truncate(p, BPLUS_U64_HALF);
+        uint32_t rn = TTAK_BPLUS_U64_FANOUT - BPLUS_U64_HALF;
+        memcpy(sib->keys, keys + BPLUS_U64_HALF + 1, rn * sizeof(uint64_t));
+        memcpy(sib->children, kids + BPLUS_U64_HALF + 1, (rn + 1) * sizeof(kids[0]));
+        sib->n = rn;
+
+        sep = keys[BPLUS_U64_HALF];
+        left = p;
+        right = sib;
+    }
+
+    ttak_bplus_u64_node_t *root = bplus_u64_node_new(false);
+    if (!root) return false;
+    root->keys[0] = sep;
+    root->children[0] = left;
+    root->children[1] = right;
+    root->n = 1;
+    tree->root = root;
+    tree->height++;
+    return true;
+}
+
+size_t ttak_bplus_u64_range(const ttak_bplus_u64_t *tree, uint64_t lo, uint64_t hi,
+                            ttak_bplus_u64_visit_t visit, void *ctx) {
+    if (!tree || !tree->root || !visit || lo > hi) return 0;
+    const ttak_bplus_u64_node_t *c = bplus_u64_find_leaf(tree, lo);
+    size_t visited = 0;
+    for (uint32_t i = bplus_u64_rank(c, lo, false); c; c = c->next, i = 0) {
+        for (; i < c->n; i++) {
+            if (c->keys[i] > hi) return visited;
+            visited++;
+            if (!visit(c->keys[i], c->values[i], ctx)) return visited;
+        }
+    }
+    return visited;
+}
+
+static void bplus_u64_free(ttak_bplus_u64_node_t *node) {
+    if (!node->leaf) {
+        for (uint32_t i = 0; i <= node->n; i++) bplus_u64_free(node->children[i]);
+    }
+    bplus_u64_aligned_free(node);
+}
+
+void ttak_bplus_u64_destroy(ttak_bplus_u64_t *tree) {
+    if (!tree || !tree->root) return;
+    bplus_u64_free(tree->root);
+    ttak_bplus_u64_init(tree);
+}
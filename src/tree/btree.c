@@ -1,36 +1,69 @@
 #include <ttak/tree/btree.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/arena_helper.h>
 #include <stdlib.h>
+#include <string.h>
 
 /**
  * @brief Allocate a B-tree node with capacity derived from t.
  *
- * @param t    Minimum degree.
+ * Arena-backed trees carve the node and its three arrays from one lane
+ * claim; otherwise each piece is a separate allocation.
+ *
+ * @param tree Tree the node belongs to.
  * @param leaf Indicates whether the node starts as a leaf.
  * @param now  Timestamp for allocator bookkeeping.
  * @return Pointer to the node or NULL on failure.
  */
-static ttak_btree_node_t *create_node(int t, bool leaf, uint64_t now) {
-    ttak_btree_node_t *node = (ttak_btree_node_t *)ttak_mem_alloc_raw(sizeof(ttak_btree_node_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-    if (!node) return NULL;
+static ttak_btree_node_t *create_node(const ttak_btree_t *tree, bool leaf, uint64_t now) {
+    // Max keys = 2t-1. Max children = 2t.
+    size_t max_keys = 2 * tree->t - 1;
+    size_t max_children = 2 * tree->t;
+    ttak_btree_node_t *node;
+
+    if (tree->arena) {
+        size_t bytes = sizeof(*node) + sizeof(void *) * (2 * max_keys + max_children);
+        node = ttak_arena_generation_claim_lane(tree->arena_env, tree->arena, tree->arena_lane, bytes);
+        if (!node) return NULL;
+        node->keys = (void **)(node + 1);
+        node->values = node->keys + max_keys;
+        node->children = (struct ttak_btree_node **)(node->values + max_keys);
+    } else {
+        node = (ttak_btree_node_t *)ttak_mem_alloc_raw(sizeof(ttak_btree_node_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        if (!node) return NULL;
+        node->keys = (void **)ttak_mem_alloc_raw(sizeof(void *) * max_keys, __TTAK_UNSAFE_MEM_FOREVER__, now);
+        node->values = (void **)ttak_mem_alloc_raw(sizeof(void *) * max_keys, __TTAK_UNSAFE_MEM_FOREVER__, now);
+        node->children = (struct ttak_btree_node **)ttak_mem_alloc_raw(sizeof(struct ttak_btree_node *) * max_children, __TTAK_UNSAFE_MEM_FOREVER__, now);
 
+        if (!node->keys || !node->values || !node->children) {
+            // Cleanup if partial alloc failed (simplified: just return null, leaking partials in this simplified prototype)
+            // ideally we free what we alloc'd.
+            return NULL;
+        }
+    }
     node->leaf = leaf;
     node->n = 0;
-    
-    // Allocate arrays. Max keys = 2t-1. Max children = 2t.
-    size_t max_keys = 2 * t - 1;
-    size_t max_children = 2 * t;
+    return node;
+}
 
-    node->keys = (void **)ttak_mem_alloc_raw(sizeof(void *) * max_keys, __TTAK_UNSAFE_MEM_FOREVER__, now);
-    node->values = (void **)ttak_mem_alloc_raw(sizeof(void *) * max_keys, __TTAK_UNSAFE_MEM_FOREVER__, now);
-    node->children = (struct ttak_btree_node **)ttak_mem_alloc_raw(sizeof(struct ttak_btree_node *) * max_children, __TTAK_UNSAFE_MEM_FOREVER__, now);
+/**
+ * @brief Release one node's storage without touching its keys or values.
+ *
+ * Arena nodes stay in place until their generation is retired.
+ */
+static void free_node(const ttak_btree_t *tree, ttak_btree_node_t *node) {
+    if (tree->arena) return;
+    ttak_mem_free(node->keys);
+    ttak_mem_free(node->values);
+    ttak_mem_free(node->children);
+    ttak_mem_free(node);
+}
 
-    if (!node->keys || !node->values || !node->children) {
-        // Cleanup if partial alloc failed (simplified: just return null, leaking partials in this simplified prototype)
-        // ideally we free what we alloc'd.
-        return NULL; 
-    }
-    return node;
+/**
+ * @brief Check that a node is still live; arena nodes carry no header to check.
+ */
+static bool node_live(const ttak_btree_t *tree, ttak_btree_node_t *node, uint64_t now) {
+    return tree->arena || ttak_mem_access(node, now);
 }
 
 /**
@@ -49,6 +82,27 @@ void ttak_btree_init(ttak_btree_t *tree, int t, int (*cmp)(const void*, const vo
     tree->cmp = cmp;
     tree->key_free = key_free;
     tree->val_free = val_free;
+    tree->arena_env = NULL;
+    tree->arena = NULL;
+    tree->arena_lane = 0;
+}
+
+/**
+ * @brief Back an empty tree's nodes with an arena lane.
+ *
+ * @param tree       Empty tree.
+ * @param env        Arena helper context.
+ * @param generation Laned generation the nodes are claimed from.
+ * @param lane       Lane the tree claims from; no other thread may use it.
+ * @return False if the tree holds nodes or the generation has no lanes.
+ */
+bool ttak_btree_use_arena(ttak_btree_t *tree, ttak_arena_env_t *env, ttak_arena_generation_t *generation,
+                          uint32_t lane) {
+    if (!tree || tree->root || !env || !generation || !generation->lanes) return false;
+    tree->arena_env = env;
+    tree->arena = generation;
+    tree->arena_lane = lane;
+    return true;
 }
 
 /**
@@ -62,7 +116,7 @@ void ttak_btree_init(ttak_btree_t *tree, int t, int (*cmp)(const void*, const vo
 static void split_child(ttak_btree_t *tree, ttak_btree_node_t *x, int i, uint64_t now) {
     int t = tree->t;
     ttak_btree_node_t *y = x->children[i];
-    ttak_btree_node_t *z = create_node(t, y->leaf, now);
+    ttak_btree_node_t *z = create_node(tree, y->leaf, now);
     
     z->n = t - 1;
 
@@ -147,13 +201,13 @@ void ttak_btree_insert(ttak_btree_t *tree, void *key, void *value, uint64_t now)
     
     ttak_btree_node_t *r = tree->root;
     if (!r) {
-        tree->root = create_node(tree->t, true, now);
+        tree->root = create_node(tree, true, now);
         tree->root->keys[0] = key;
         tree->root->values[0] = value;
         tree->root->n = 1;
     } else {
         if (r->n == 2 * tree->t - 1) {
-            ttak_btree_node_t *s = create_node(tree->t, false, now);
+            ttak_btree_node_t *s = create_node(tree, false, now);
             tree->root = s;
             s->children[0] = r;
             split_child(tree, s, 0, now);
@@ -174,7 +228,7 @@ void ttak_btree_insert(ttak_btree_t *tree, void *key, void *value, uint64_t now)
  * @return Stored value or NULL if absent.
  */
 static void *search_recursive(ttak_btree_t *tree, ttak_btree_node_t *x, const void *k, uint64_t now) {
-    if (!x || !ttak_mem_access(x, now)) return NULL;
+    if (!x || !node_live(tree, x, now)) return NULL;
     
     int i = 0;
     while (i < x->n && tree->cmp(k, x->keys[i]) > 0) {
@@ -203,20 +257,307 @@ void *ttak_btree_search(ttak_btree_t *tree, const void *key, uint64_t now) {
     return search_recursive(tree, tree->root, key, now);
 }
 
+/**
+ * @brief Merge child i + 1 of @p x and separator i into child i.
+ *
+ * Both children hold t - 1 keys, so the result holds exactly 2t - 1.
+ */
+static void merge_children(const ttak_btree_t *tree, ttak_btree_node_t *x, int i) {
+    ttak_btree_node_t *y = x->children[i];
+    ttak_btree_node_t *z = x->children[i + 1];
+
+    y->keys[y->n] = x->keys[i];
+    y->values[y->n] = x->values[i];
+    for (int j = 0; j < z->n; j++) {
+        y->keys[y->n + 1 + j] = z->keys[j];
+        y->values[y->n + 1 + j] = z->values[j];
+    }
+    if (!y->leaf) {
+        for (int j = 0; j <= z->n; j++) {
+            y->children[y->n + 1 + j] = z->children[j];
+        }
+    }
+    y->n += 1 + z->n;
+
+    for (int j = i; j < x->n - 1; j++) {
+        x->keys[j] = x->keys[j + 1];
+        x->values[j] = x->values[j + 1];
+    }
+    for (int j = i + 1; j < x->n; j++) {
+        x->children[j] = x->children[j + 1];
+    }
+    x->n--;
+    free_node(tree, z);
+}
+
+/**
+ * @brief Make sure child i of @p x holds at least t keys before descending.
+ *
+ * Rotates a key through @p x from a sibling that can spare one, or else
+ * merges with a sibling.
+ *
+ * @return Index of the child to descend into, which moves left on a merge
+ *         with the left sibling.
+ */
+static int fill_child(ttak_btree_t *tree, ttak_btree_node_t *x, int i) {
+    int t = tree->t;
+    ttak_btree_node_t *c = x->children[i];
+
+    if (i > 0 && x->children[i - 1]->n >= t) {
+        ttak_btree_node_t *left = x->children[i - 1];
+        for (int j = c->n; j > 0; j--) {
+            c->keys[j] = c->keys[j - 1];
+            c->values[j] = c->values[j - 1];
+        }
+        if (!c->leaf) {
+            for (int j = c->n + 1; j > 0; j--) c->children[j] = c->children[j - 1];
+            c->children[0] = left->children[left->n];
+        }
+        c->keys[0] = x->keys[i - 1];
+        c->values[0] = x->values[i - 1];
+        x->keys[i - 1] = left->keys[left->n - 1];
+        x->values[i - 1] = left->values[left->n - 1];
+        c->n++;
+        left->n--;
+        return i;
+    }
+    if (i < x->n && x->children[i + 1]->n >= t) {
+        ttak_btree_node_t *right = x->children[i + 1];
+        c->keys[c->n] = x->keys[i];
+        c->values[c->n] = x->values[i];
+        if (!c->leaf) c->children[c->n + 1] = right->children[0];
+        x->keys[i] = right->keys[0];
+        x->values[i] = right->values[0];
+        for (int j = 0; j < right->n - 1; j++) {
+            right->keys[j] = right->keys[j + 1];
+            right->values[j] = right->values[j + 1];
+        }
+        if (!right->leaf) {
+            for (int j = 0; j < right->n; j++) right->children[j] = right->children[j + 1];
+        }
+        c->n++;
+        right->n--;
+        return i;
+    }
+    if (i < x->n) {
+        merge_children(tree, x, i);
+        return i;
+    }
+    merge_children(tree, x, i - 1);
+    return i - 1;
+}
+
+/**
+ * @brief Unlink @p k from the subtree at @p x, handing its pair back.
+ *
+ * Single pass from the top: every node descended into is first topped up
+ * to t keys, so the removal never has to walk back up.
+ *
+ * @return true if the key was found.
+ */
+static bool remove_from(ttak_btree_t *tree, ttak_btree_node_t *x, const void *k,
+                        void **out_key, void **out_val) {
+    int t = tree->t;
+    for (;;) {
+        int i = 0;
+        while (i < x->n && tree->cmp(k, x->keys[i]) > 0) {
+            i++;
+        }
+
+        if (i < x->n && tree->cmp(k, x->keys[i]) == 0) {
+            if (x->leaf) {
+                *out_key = x->keys[i];
+                *out_val = x->values[i];
+                for (int j = i; j < x->n - 1; j++) {
+                    x->keys[j] = x->keys[j + 1];
+                    x->values[j] = x->values[j + 1];
+                }
+                x->n--;
+                return true;
+            }
+
+            ttak_btree_node_t *y = x->children[i];
+            ttak_btree_node_t *z = x->children[i + 1];
+            if (y->n >= t || z->n >= t) {
+                // Replace the key with its predecessor or successor, unlinked from below.
+                ttak_btree_node_t *m = y->n >= t ? y : z;
+                ttak_btree_node_t *e = m;
+                while (!e->leaf) e = m == y ? e->children[e->n] : e->children[0];
+                const void *repl = m == y ? e->keys[e->n - 1] : e->keys[0];
+                *out_key = x->keys[i];
+                *out_val = x->values[i];
+                void *rk = NULL, *rv = NULL;
+                remove_from(tree, m, repl, &rk, &rv);
+                x->keys[i] = rk;
+                x->values[i] = rv;
+                return true;
+            }
+            merge_children(tree, x, i);
+            x = y;
+            continue;
+        }
+
+        if (x->leaf) return false;
+        if (x->children[i]->n < t) i = fill_child(tree, x, i);
+        x = x->children[i];
+    }
+}
+
+/**
+ * @brief Remove a key and free its pair through the tree's callbacks.
+ *
+ * @param tree Tree to mutate.
+ * @param key  Key to remove.
+ * @param now  Timestamp for pointer validation.
+ * @return true if the key was present.
+ */
+bool ttak_btree_remove(ttak_btree_t *tree, const void *key, uint64_t now) {
+    if (!tree || !tree->root || !node_live(tree, tree->root, now)) return false;
+
+    void *old_key = NULL, *old_val = NULL;
+    bool found = remove_from(tree, tree->root, key, &old_key, &old_val);
+
+    ttak_btree_node_t *r = tree->root;
+    if (r->n == 0) {
+        tree->root = r->leaf ? NULL : r->children[0];
+        free_node(tree, r);
+    }
+    if (found) {
+        if (tree->key_free) tree->key_free(old_key);
+        if (tree->val_free && old_val) tree->val_free(old_val);
+    }
+    return found;
+}
+
+/**
+ * @brief Free the nodes of a partly built level and the subtrees beneath them.
+ */
+static void bulk_discard(const ttak_btree_t *tree, ttak_btree_node_t **nodes, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        ttak_btree_node_t *node = nodes[i];
+        if (!node->leaf) bulk_discard(tree, node->children, (size_t)node->n + 1);
+        free_node(tree, node);
+    }
+}
+
+/**
+ * @brief Build the tree bottom-up from pairs sorted by strictly increasing key.
+ *
+ * Each level is cut into nodes of about @p fill * (2t - 1) keys with one
+ * key between neighbours promoted; the promoted keys form the next level
+ * up, whose nodes then own exactly the children below them.
+ *
+ * @param tree   Empty tree to fill.
+ * @param keys   Sorted keys, taken over by the tree.
+ * @param values Values matching @p keys.
+ * @param n      Number of pairs.
+ * @param fill   Fraction of each node to fill (0, 1].
+ * @param now    Timestamp for allocations.
+ * @return false if the tree was not empty, the keys were not sorted, or
+ *         allocation failed; the tree is then left unchanged.
+ */
+bool ttak_btree_bulk_load(ttak_btree_t *tree, void *const *keys, void *const *values, size_t n,
+                          double fill, uint64_t now) {
+    if (!tree || tree->root || !keys || !values) return false;
+    if (n == 0) return true;
+    for (size_t i = 1; i < n; i++) {
+        if (tree->cmp(keys[i - 1], keys[i]) >= 0) return false;
+    }
+    if (!(fill > 0.0) || fill > 1.0) fill = 1.0;
+
+    size_t t = (size_t)tree->t;
+    size_t max = 2 * t - 1;
+    size_t per = (size_t)(fill * (double)max + 0.5);
+    if (per < t - 1) per = t - 1;
+    if (per > max) per = max;
+
+    // The current level's items, then the nodes built over them.
+    void **ik = malloc(n * sizeof(*ik));
+    void **iv = malloc(n * sizeof(*iv));
+    if (!ik || !iv) {
+        free(ik);
+        free(iv);
+        return false;
+    }
+    memcpy(ik, keys, n * sizeof(*ik));
+    memcpy(iv, values, n * sizeof(*iv));
+    ttak_btree_node_t **below = NULL;
+    size_t items = n;
+    bool leaf = true;
+
+    for (;;) {
+        // Each node but the last takes a separator along with its keys.
+        size_t count = items <= max ? 1 : (items + 1 + per) / (per + 1);
+        if (count > 1 && (items + 1) / count < t) count = (items + 1) / t;
+        size_t own = items - (count - 1);
+
+        ttak_btree_node_t **level = malloc(count * sizeof(*level));
+        if (!level) goto fail;
+        size_t pos = 0, child = 0;
+        for (size_t i = 0; i < count; i++) {
+            size_t take = own / count + (i < own % count);
+            ttak_btree_node_t *node = create_node(tree, leaf, now);
+            if (!node) {
+                for (size_t j = 0; j < i; j++) free_node(tree, level[j]);
+                free(level);
+                goto fail;
+            }
+            for (size_t j = 0; j < take; j++) {
+                node->keys[j] = ik[pos + j];
+                node->values[j] = iv[pos + j];
+            }
+            if (!leaf) {
+                for (size_t j = 0; j <= take; j++) node->children[j] = below[child + j];
+                child += take + 1;
+            }
+            node->n = (int)take;
+            pos += take;
+            level[i] = node;
+            if (i + 1 < count) {
+                // Promote the separator, compacting in place: i < pos always.
+                ik[i] = ik[pos];
+                iv[i] = iv[pos];
+                pos++;
+            }
+        }
+        free(below);
+        below = level;
+        items = count - 1;
+        leaf = false;
+        if (count == 1) break;
+    }
+
+    tree->root = below[0];
+    free(below);
+    free(ik);
+    free(iv);
+    return true;
+
+fail:
+    if (below) {
+        bulk_discard(tree, below, items + 1);
+        free(below);
+    }
+    free(ik);
+    free(iv);
+    return false;
+}
+
 /**
  * @brief Recursively free a subtree.
  *
+ * @param tree Tree owning the nodes.
  * @param x   Node to destroy.
  * @param kf  Key destructor.
  * @param vf  Value destructor.
  * @param now Timestamp for bookkeeping.
  */
-static void destroy_recursive(ttak_btree_node_t *x, void (*kf)(void*), void (*vf)(void*), uint64_t now) {
+static void destroy_recursive(const ttak_btree_t *tree, ttak_btree_node_t *x, void (*kf)(void*), void (*vf)(void*), uint64_t now) {
     if (!x) return;
     
     if (!x->leaf) {
         for (int i = 0; i <= x->n; i++) {
-            destroy_recursive(x->children[i], kf, vf, now);
+            destroy_recursive(tree, x->children[i], kf, vf, now);
         }
     }
     
@@ -227,20 +568,22 @@ static void destroy_recursive(ttak_btree_node_t *x, void (*kf)(void*), void (*vf
         }
     }
     
-    ttak_mem_free(x->keys);
-    ttak_mem_free(x->values);
-    ttak_mem_free(x->children);
-    ttak_mem_free(x);
+    free_node(tree, x);
 }
 
 /**
  * @brief Destroy the entire B-tree.
  *
+ * An arena-backed tree without destructors is dropped without a walk;
+ * retiring its generation then releases the nodes in one step.
+ *
  * @param tree Tree to tear down.
  * @param now  Timestamp for destructor bookkeeping.
  */
 void ttak_btree_destroy(ttak_btree_t *tree, uint64_t now) {
     if (!tree || !tree->root) return;
-    destroy_recursive(tree->root, tree->key_free, tree->val_free, now);
+    if (!tree->arena || tree->key_free || tree->val_free) {
+        destroy_recursive(tree, tree->root, tree->key_free, tree->val_free, now);
+    }
     tree->root = NULL;
 }
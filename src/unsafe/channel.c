@@ -0,0 +1,141 @@
+/**
+ * @file channel.c
+ * @brief Region channels: a ring of region handles plus two eventcounts.
+ *
+ * Regions are moved into and out of ring slots in place through
+ * reserve/commit and claim/release, so the ring never copies a handle
+ * twice and never looks at the bytes behind it.
+ */
+
+#include <ttak/unsafe/channel.h>
+#include <ttak/timing/timing.h>
+
+#include <stdlib.h>
+
+ttak_region_chan_t *ttak_region_chan_create(size_t capacity, ttak_ringbuf_mode_t mode, size_t elem_size,
+                                            uint32_t recv_ctx_id, const char *recv_tag) {
+    if (capacity == 0) return NULL;
+    ttak_region_chan_t *chan = calloc(1, sizeof(*chan));
+    if (!chan) return NULL;
+    chan->ring = ttak_ringbuf_create_ex(capacity, sizeof(ttak_unsafe_region_t), mode);
+    if (!chan->ring) {
+        free(chan);
+        return NULL;
+    }
+    chan->elem_size = elem_size ? elem_size : 1;
+    chan->recv_ctx_id = recv_ctx_id;
+    chan->recv_tag = recv_tag;
+    atomic_init(&chan->closed, 0);
+    ttak_eventcount_init(&chan->not_empty);
+    ttak_eventcount_init(&chan->not_full);
+    return chan;
+}
+
+void ttak_region_chan_destroy(ttak_region_chan_t *chan,
+                              void (*drop)(ttak_unsafe_region_t *region, void *arg), void *arg) {
+    if (!chan) return;
+    ttak_ringbuf_slot_t slot;
+    while (ttak_ringbuf_claim(chan->ring, &slot)) {
+        ttak_unsafe_region_t region = *(ttak_unsafe_region_t *)slot.ptr;
+        ttak_ringbuf_release(chan->ring, &slot);
+        if (drop) drop(&region, arg);
+    }
+    ttak_ringbuf_destroy(chan->ring);
+    free(chan);
+}
+
+static bool chan_try_send(ttak_region_chan_t *chan, ttak_unsafe_region_t *src) {
+    ttak_ringbuf_slot_t slot;
+    if (!ttak_ringbuf_reserve(chan->ring, &slot)) return false;
+    ttak_unsafe_region_t *cell = (ttak_unsafe_region_t *)slot.ptr;
+    ttak_unsafe_region_init(cell, chan->recv_ctx_id, NULL);
+    /* Cannot fail: the cell is empty and the caller checked the pin count. */
+    ttak_unsafe_region_move_cross_ctx(cell, src, chan->recv_ctx_id, chan->recv_tag);
+    ttak_ringbuf_commit(chan->ring, &slot);
+    ttak_eventcount_notify(&chan->not_empty);
+    return true;
+}
+
+static bool chan_try_recv(ttak_region_chan_t *chan, ttak_unsafe_region_t *dst) {
+    ttak_ringbuf_slot_t slot;
+    if (!ttak_ringbuf_claim(chan->ring, &slot)) return false;
+    ttak_unsafe_region_steal(dst, (ttak_unsafe_region_t *)slot.ptr);
+    ttak_ringbuf_release(chan->ring, &slot);
+    ttak_eventcount_notify(&chan->not_full);
+    return true;
+}
+
+static inline bool chan_closed(const ttak_region_chan_t *chan) {
+    return atomic_load_explicit(&chan->closed, memory_order_acquire) != 0;
+}
+
+static inline bool chan_attempt(ttak_region_chan_t *chan, ttak_unsafe_region_t *region, bool send) {
+    return send ? chan_try_send(chan, region) : chan_try_recv(chan, region);
+}
+
+/**
+ * @brief Retries one transfer until it succeeds, the channel closes, or time runs out.
+ *
+ * Parking follows the eventcount protocol: announce, re-check both the
+ * ring and the closed flag, then sleep.
+ */
+static ttak_chan_status_t chan_transfer(ttak_region_chan_t *chan, ttak_unsafe_region_t *region,
+                                        uint64_t timeout_ns, bool send) {
+    ttak_eventcount_t *ec = send ? &chan->not_full : &chan->not_empty;
+    uint64_t deadline = TTAK_WAIT_FOREVER;
+    if (timeout_ns != 0 && timeout_ns != TTAK_WAIT_FOREVER) {
+        uint64_t now = ttak_get_tick_count_ns();
+        deadline = timeout_ns > TTAK_WAIT_FOREVER - now ? TTAK_WAIT_FOREVER : now + timeout_ns;
+    }
+    for (;;) {
+        if (send && chan_closed(chan)) return TTAK_CHAN_CLOSED;
+        if (chan_attempt(chan, region, send)) return TTAK_CHAN_OK;
+        /* Closed receivers still take what was queued before the close. */
+        if (!send && chan_closed(chan)) return chan_try_recv(chan, region) ? TTAK_CHAN_OK : TTAK_CHAN_CLOSED;
+        if (timeout_ns == 0) return TTAK_CHAN_WOULD_BLOCK;
+        uint64_t left = TTAK_WAIT_FOREVER;
+        if (deadline != TTAK_WAIT_FOREVER) {
+            uint64_t now = ttak_get_tick_count_ns();
+            if (now >= deadline) return TTAK_CHAN_TIMEOUT;
+            left = deadline - now;
+        }
+        uint32_t key = ttak_eventcount_prepare(ec);
+        if (chan_closed(chan)) {
+            ttak_eventcount_cancel(ec);
+            continue;
+        }
+        if (chan_attempt(chan, region, send)) {
+            ttak_eventcount_cancel(ec);
+            return TTAK_CHAN_OK;
+        }
+        ttak_eventcount_wait_for(ec, key, left);
+    }
+}
+
+ttak_chan_status_t ttak_region_chan_send(ttak_region_chan_t *chan, ttak_unsafe_region_t *src,
+                                         uint64_t timeout_ns) {
+    if (!chan || !src || src->pin_count != 0 || ttak_unsafe_region_is_empty(src)) return TTAK_CHAN_INVALID;
+    if (src->size % chan->elem_size != 0) return TTAK_CHAN_INVALID;
+    return chan_transfer(chan, src, timeout_ns, true);
+}
+
+ttak_chan_status_t ttak_region_chan_recv(ttak_region_chan_t *chan, ttak_unsafe_region_t *dst,
+                                         uint64_t timeout_ns) {
+    if (!chan || !dst || dst->pin_count != 0 || dst->ptr != NULL || dst->size != 0) return TTAK_CHAN_INVALID;
+    return chan_transfer(chan, dst, timeout_ns, false);
+}
+
+void ttak_region_chan_close(ttak_region_chan_t *chan) {
+    if (!chan) return;
+    atomic_store_explicit(&chan->closed, 1, memory_order_release);
+    ttak_eventcount_notify_all(&chan->not_empty);
+    ttak_eventcount_notify_all(&chan->not_full);
+}
+
+bool ttak_region_chan_is_closed(const ttak_region_chan_t *chan) {
+    return chan ? chan_closed(chan) : true;
+}
+
+size_t ttak_region_chan_len(ttak_region_chan_t *chan) {
+    return chan ? ttak_ringbuf_count(chan->ring) : 0;
+}
@@ -8,6 +8,8 @@
  */
 
 #include <ttak/unsafe/context.h>
+#include <ttak/arch/ttak_arch.h>
+#include <ttak/timing/timing.h>
 #include <string.h>
 
 static ttak_owner_t *ttak_context_pick_owner(const ttak_context_t *ctx, ttak_context_inherit_t side) {
@@ -83,3 +85,124 @@ void *ttak_context_shared(const ttak_context_t *ctx, size_t *size_out) {
     if (size_out) *size_out = ctx->shared_size;
     return ctx->shared_mem;
 }
+
+/* Bridge state word: bit 0 is the holding side, bit 1 the busy flag. */
+#define BRIDGE_SIDE 1u
+#define BRIDGE_BUSY 2u
+#define BRIDGE_GEN  4u
+
+static inline uint32_t bridge_side(ttak_context_inherit_t side) {
+    return side == __TTAK_CTX_USE_SECOND__ ? 1u : 0u;
+}
+
+/* Publishes @p next and wakes sleepers; pairs with the waiter's registration in bridge_sleep(). */
+static void bridge_publish(ttak_context_bridge_t *bridge, uint32_t next) {
+    atomic_store_explicit(&bridge->state, next, memory_order_seq_cst);
+    if (atomic_load_explicit(&bridge->waiters, memory_order_seq_cst) != 0) {
+        ttak_waitword_wake_all(&bridge->state);
+    }
+}
+
+bool ttak_context_bridge_init(ttak_context_bridge_t *bridge,
+                              ttak_owner_t *first,
+                              ttak_owner_t *second,
+                              void *shared_mem,
+                              size_t shared_size,
+                              ttak_context_inherit_t inherit_side) {
+    if (!bridge || !first || !second) return false;
+    if ((first->policy_flags | second->policy_flags) & TTAK_OWNER_STRICT_ISOLATION) return false;
+    memset(bridge, 0, sizeof(*bridge));
+    bridge->owners[0] = first;
+    bridge->owners[1] = second;
+    bridge->shared_mem = shared_mem;
+    bridge->shared_size = shared_size;
+    atomic_init(&bridge->state, bridge_side(inherit_side));
+    atomic_init(&bridge->waiters, 0);
+    bridge->initialized = true;
+    return true;
+}
+
+void ttak_context_bridge_destroy(ttak_context_bridge_t *bridge) {
+    if (!bridge) return;
+    memset(bridge, 0, sizeof(*bridge));
+}
+
+bool ttak_context_bridge_enter(ttak_context_bridge_t *bridge, ttak_context_inherit_t side, uint64_t timeout_ns) {
+    if (!bridge || !bridge->initialized) return false;
+    uint32_t want = bridge_side(side);
+    uint64_t deadline = TTAK_WAIT_FOREVER;
+    for (int spins = 0;; spins++) {
+        uint32_t s = atomic_load_explicit(&bridge->state, memory_order_acquire);
+        if ((s & (BRIDGE_SIDE | BRIDGE_BUSY)) == want) {
+            if (atomic_compare_exchange_weak_explicit(&bridge->state, &s, s | BRIDGE_BUSY,
+                                                      memory_order_acquire, memory_order_relaxed)) {
+                return true;
+            }
+            continue;
+        }
+        if (timeout_ns == 0) return false;
+        if (spins < TTAK_WAITWORD_SPINS) {
+            ttak_arch_pause();
+            continue;
+        }
+        uint64_t left = TTAK_WAIT_FOREVER;
+        if (timeout_ns != TTAK_WAIT_FOREVER) {
+            uint64_t now = ttak_get_tick_count_ns();
+            if (deadline == TTAK_WAIT_FOREVER) deadline = now + timeout_ns;
+            if (now >= deadline) return false;
+            left = deadline - now;
+        }
+        atomic_fetch_add_explicit(&bridge->waiters, 1, memory_order_seq_cst);
+        if (atomic_load_explicit(&bridge->state, memory_order_seq_cst) == s) {
+            ttak_waitword_wait(&bridge->state, s, left);
+        }
+        atomic_fetch_sub_explicit(&bridge->waiters, 1, memory_order_relaxed);
+    }
+}
+
+void ttak_context_bridge_leave(ttak_context_bridge_t *bridge, ttak_context_inherit_t next_side) {
+    if (!bridge || !bridge->initialized) return;
+    uint32_t s = atomic_load_explicit(&bridge->state, memory_order_relaxed);
+    /* Only the busy holder writes the word, so no CAS is needed. */
+    bridge_publish(bridge, ((s & ~(BRIDGE_SIDE | BRIDGE_BUSY)) + BRIDGE_GEN) | bridge_side(next_side));
+}
+
+bool ttak_context_bridge_run(ttak_context_bridge_t *bridge,
+                             ttak_context_inherit_t side,
+                             ttak_context_callback_t cb,
+                             void *arg,
+                             ttak_context_inherit_t next_side,
+                             uint64_t timeout_ns) {
+    if (!cb || !ttak_context_bridge_enter(bridge, side, timeout_ns)) return false;
+    cb(bridge->shared_mem, bridge->shared_size, arg);
+    ttak_context_bridge_leave(bridge, next_side);
+    return true;
+}
+
+bool ttak_context_bridge_handoff(ttak_context_bridge_t *bridge,
+                                 ttak_context_inherit_t from,
+                                 ttak_context_inherit_t to) {
+    if (!bridge || !bridge->initialized) return false;
+    uint32_t s = atomic_load_explicit(&bridge->state, memory_order_relaxed);
+    if ((s & (BRIDGE_SIDE | BRIDGE_BUSY)) != bridge_side(from)) return false;
+    uint32_t next = ((s & ~BRIDGE_SIDE) + BRIDGE_GEN) | bridge_side(to);
+    if (!atomic_compare_exchange_strong_explicit(&bridge->state, &s, next,
+                                                 memory_order_acq_rel, memory_order_relaxed)) {
+        return false;
+    }
+    if (atomic_load_explicit(&bridge->waiters, memory_order_seq_cst) != 0) {
+        ttak_waitword_wake_all(&bridge->state);
+    }
+    return true;
+}
+
+ttak_owner_t *ttak_context_bridge_owner(const ttak_context_bridge_t *bridge, ttak_context_inherit_t side) {
+    if (!bridge) return NULL;
+    return bridge->owners[bridge_side(side)];
+}
+
+ttak_context_inherit_t ttak_context_bridge_active(const ttak_context_bridge_t *bridge) {
+    if (!bridge) return __TTAK_CTX_USE_FIRST__;
+    return (atomic_load_explicit(&bridge->state, memory_order_acquire) & BRIDGE_SIDE) ? __TTAK_CTX_USE_SECOND__
+                                                                                      : __TTAK_CTX_USE_FIRST__;
+}
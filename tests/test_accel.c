@@ -0,0 +1,158 @@
+#include <ttak/ttak_accelerator.h>
+#include "test_macros.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Mirrors the CPU backend's output layout. */
+typedef struct {
+    uint64_t prime;
+    uint32_t exponent;
+    uint32_t reserved;
+} accel_slot_t;
+
+typedef struct {
+    uint64_t value;
+    uint32_t factor_count;
+    uint32_t checksum;
+    uint32_t reserved;
+    accel_slot_t slots[64];
+} accel_record_t;
+
+typedef struct {
+    uint32_t guard;
+    uint32_t record_count;
+    uint32_t payload_checksum;
+    uint32_t reserved;
+} accel_prefix_t;
+
+#define ACCEL_VALUES 200
+
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static int is_prime_slow(uint64_t p) {
+    if (p < 2) return 0;
+    for (uint64_t d = 2; d <= 1000 && d < p; ++d) {
+        if (p % d == 0) return 0;
+    }
+    return 1;
+}
+
+/* Unmasks @p output in place and checks each record multiplies back to its value. */
+static void check_records(uint8_t *output, const uint64_t *values, size_t count) {
+    accel_prefix_t prefix;
+    memcpy(&prefix, output, sizeof(prefix));
+    ASSERT(prefix.record_count == count);
+    uint8_t *payload = output + sizeof(prefix);
+    for (size_t i = 0; i < count * sizeof(accel_record_t); ++i) {
+        payload[i] ^= (uint8_t)(prefix.guard >> (8 * (i & 3)));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        accel_record_t record;
+        memcpy(&record, payload + i * sizeof(record), sizeof(record));
+        ASSERT(record.value == values[i]);
+        uint64_t product = 1;
+        for (uint32_t s = 0; s < record.factor_count; ++s) {
+            if (s > 0) ASSERT(record.slots[s - 1].prime < record.slots[s].prime);
+            ASSERT(is_prime_slow(record.slots[s].prime) || record.slots[s].prime > 1000000);
+            for (uint32_t e = 0; e < record.slots[s].exponent; ++e) {
+                product *= record.slots[s].prime;
+            }
+        }
+        ASSERT_MSG(product == (values[i] == 0 ? 1 : values[i]), "value %zu did not multiply back", i);
+    }
+}
+
+void test_accel_cpu_factors_batch() {
+    static uint64_t values[ACCEL_VALUES];
+    static uint8_t output[sizeof(accel_prefix_t) + ACCEL_VALUES * sizeof(accel_record_t)];
+    /* Semiprimes of two 32-bit primes are the hardest case for rho. */
+    values[0] = 4294967291ULL * 4294967279ULL;
+    values[1] = 1;
+    values[2] = 1ULL << 63;
+    values[3] = 18446744073709551557ULL;
+    values[4] = 1000000007ULL * 1000000009ULL;
+    for (size_t i = 5; i < ACCEL_VALUES; ++i) {
+        values[i] = mix(i) | 1;
+    }
+
+    uint32_t checksum = 0;
+    ttak_accel_batch_item_t item = {
+        .input = (const uint8_t *)values,
+        .input_len = sizeof(values),
+        .output = output,
+        .output_len = sizeof(output),
+        .mask_seed = 0x5a5a1234u,
+        .checksum_salt = 0,
+        .checksum_out = &checksum
+    };
+    ttak_accel_config_t config = { .preferred_target = TTAK_ACCEL_TARGET_CPU };
+    ASSERT(ttak_execute_batch(&item, 1, &config) == TTAK_RESULT_OK);
+
+    accel_prefix_t prefix;
+    memcpy(&prefix, output, sizeof(prefix));
+    ASSERT(prefix.payload_checksum == checksum);
+    check_records(output, values, ACCEL_VALUES);
+
+    uint8_t *payload = output + sizeof(prefix);
+    accel_record_t record;
+    memcpy(&record, payload, sizeof(record));
+    ASSERT(record.factor_count == 2);
+    ASSERT(record.slots[0].prime == 4294967279ULL);
+    ASSERT(record.slots[1].prime == 4294967291ULL);
+    memcpy(&record, payload + 2 * sizeof(record), sizeof(record));
+    ASSERT(record.factor_count == 1 && record.slots[0].prime == 2 && record.slots[0].exponent == 63);
+    memcpy(&record, payload + 3 * sizeof(record), sizeof(record));
+    ASSERT(record.factor_count == 1 && record.slots[0].prime == values[3]);
+}
+
+void test_accel_hybrid_covers_every_item() {
+    enum { ITEMS = 5, PER_ITEM = 40 };
+    static uint64_t values[ITEMS][PER_ITEM];
+    static uint8_t output[ITEMS][sizeof(accel_prefix_t) + PER_ITEM * sizeof(accel_record_t)];
+    ttak_accel_batch_item_t items[ITEMS];
+    for (size_t i = 0; i < ITEMS; ++i) {
+        for (size_t j = 0; j < PER_ITEM; ++j) {
+            values[i][j] = mix(i * PER_ITEM + j + 1000);
+        }
+        items[i] = (ttak_accel_batch_item_t){
+            .input = (const uint8_t *)values[i],
+            .input_len = (i + 1) * 8 * sizeof(uint64_t),
+            .output = output[i],
+            .output_len = sizeof(output[i])
+        };
+    }
+    ttak_accel_config_t config = { .preferred_target = TTAK_ACCEL_TARGET_HYBRID };
+    /* Repeat so the split is also exercised after the rates are measured. */
+    for (int round = 0; round < 3; ++round) {
+        ASSERT(ttak_execute_batch(items, ITEMS, &config) == TTAK_RESULT_OK);
+        for (size_t i = 0; i < ITEMS; ++i) {
+            check_records(output[i], values[i], (i + 1) * 8);
+        }
+    }
+}
+
+void test_accel_cpu_rejects_short_output() {
+    uint64_t value = 15;
+    uint8_t output[sizeof(accel_prefix_t)];
+    ttak_accel_batch_item_t item = {
+        .input = (const uint8_t *)&value,
+        .input_len = sizeof(value),
+        .output = output,
+        .output_len = sizeof(output)
+    };
+    ASSERT(ttak_execute_batch(&item, 1, NULL) == TTAK_RESULT_ERR_ARGUMENT);
+}
+
+int main() {
+    RUN_TEST(test_accel_cpu_factors_batch);
+    RUN_TEST(test_accel_hybrid_covers_every_item);
+    RUN_TEST(test_accel_cpu_rejects_short_output);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <ttak/security/security_engine.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_macros.h"
+
+static size_t hex(const char *s, uint8_t *out) {
+    size_t i = 0;
+    for (; s[2 * i]; i++) {
+        unsigned v;
+        sscanf(s + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+    return i;
+}
+
+static void seal(const uint8_t key[32], const uint8_t iv[12], const uint8_t *aad, size_t aad_len,
+                 const uint8_t *in, uint8_t *out, size_t len, uint8_t tag[16]) {
+    ttak_crypto_ctx_t ctx = { .key = key, .key_len = 32, .iv_len = 12, .aad = aad, .aad_len = aad_len,
+                              .tag = tag, .tag_len = 16 };
+    memcpy(ctx.iv, iv, 12);
+    ASSERT(ttak_aes256_expand_key(&ctx) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_aes256_gcm_execute(&ctx, in, out, len) == TTAK_IO_SUCCESS);
+}
+
+static void test_gcm_spec_case_16(void) {
+    // McGrew & Viega test case 16: AES-256 with AAD and a partial last block.
+    uint8_t key[32], iv[12], aad[20], pt[60], ct[60], want[60], tag[16], want_tag[16];
+    hex("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308", key);
+    hex("cafebabefacedbaddecaf888", iv);
+    hex("feedfacedeadbeeffeedfacedeadbeefabaddad2", aad);
+    hex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+        "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39", pt);
+    hex("522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+        "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662", want);
+    hex("76fc6ece0f4e1768cddf8853bb2d551b", want_tag);
+    seal(key, iv, aad, sizeof(aad), pt, ct, sizeof(pt), tag);
+    ASSERT(memcmp(ct, want, sizeof(ct)) == 0);
+    ASSERT(memcmp(tag, want_tag, 16) == 0);
+}
+
+static void test_gcm_long_messages(void) {
+    // Lengths that end in the single-block, 8-block and 16-block GHASH paths, checked against OpenSSL.
+    static const struct {
+        size_t len;
+        const char *tag;
+        const char *last16;
+    } cases[] = {
+        { 255, "b33e4c482a5876a48de795a4fb8b07ba", "d58e9507ceeabb135c56ec014182d6e7" },
+        { 389, "10a820acee0e35444e09a73f9e91fd21", "c754e9777794681f6788b17fa90285cb" },
+        { 4147, "349a0558744fd13c3a5a98035dd08fe1", "9661ea191f7cb0727f7acdca06cd28c0" },
+    };
+    uint8_t key[32], iv[12], aad[37];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(i * 13 + 1);
+    for (int i = 0; i < 12; i++) iv[i] = (uint8_t)(0xA0 + i);
+    for (int i = 0; i < 37; i++) aad[i] = (uint8_t)(i ^ 0x5c);
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        size_t len = cases[c].len;
+        uint8_t *pt = malloc(len), *ct = malloc(len);
+        ASSERT(pt != NULL && ct != NULL);
+        for (size_t i = 0; i < len; i++) pt[i] = (uint8_t)(i * 31 + 7);
+
+        uint8_t tag[16], want_tag[16], want_last[16];
+        hex(cases[c].tag, want_tag);
+        hex(cases[c].last16, want_last);
+        seal(key, iv, aad, sizeof(aad), pt, ct, len, tag);
+        ASSERT_MSG(memcmp(tag, want_tag, 16) == 0, "tag for %zu bytes", len);
+        ASSERT(memcmp(ct + len - 16, want_last, 16) == 0);
+
+        // Sealing in place gives the same record.
+        uint8_t tag2[16];
+        seal(key, iv, aad, sizeof(aad), pt, pt, len, tag2);
+        ASSERT(memcmp(pt, ct, len) == 0 && memcmp(tag, tag2, 16) == 0);
+        free(pt);
+        free(ct);
+    }
+}
+
+static void test_gcm_chunking_is_invisible(void) {
+    // Every length up to a few chunks agrees with a byte-at-a-time keystream prefix.
+    enum { MAX = 2100 };
+    uint8_t key[32] = { 7 }, iv[12] = { 1, 2, 3 }, tag[16];
+    uint8_t *zero = calloc(MAX, 1), *full = malloc(MAX), *part = malloc(MAX);
+    ASSERT(zero != NULL && full != NULL && part != NULL);
+    seal(key, iv, NULL, 0, zero, full, MAX, tag);
+    for (size_t len = 1; len < MAX; len += 37) {
+        seal(key, iv, NULL, 0, zero, part, len, tag);
+        ASSERT_MSG(memcmp(part, full, len) == 0, "keystream prefix at %zu", len);
+    }
+    free(zero);
+    free(full);
+    free(part);
+}
+
+int main(void) {
+    RUN_TEST(test_gcm_spec_case_16);
+    RUN_TEST(test_gcm_long_messages);
+    RUN_TEST(test_gcm_chunking_is_invisible);
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <ttak/security/argon2.h>
+#include <ttak/security/security_engine.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_macros.h"
+
+static size_t hex(const char *s, uint8_t *out) {
+    size_t i = 0;
+    for (; s[2 * i]; i++) {
+        unsigned v;
+        sscanf(s + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+    return i;
+}
+
+static void test_argon2id_rfc9106(void) {
+    // RFC 9106 section 5.3.
+    uint8_t pwd[32], salt[16], secret[8], ad[12], tag[32], want[32];
+    memset(pwd, 0x01, sizeof(pwd));
+    memset(salt, 0x02, sizeof(salt));
+    memset(secret, 0x03, sizeof(secret));
+    memset(ad, 0x04, sizeof(ad));
+    hex("0d640df58d78766c08c037a34a8b53c9d01ef0452d75b65eb52520e96b01e659", want);
+    ttak_argon2_params_t params = { .t_cost = 3, .m_cost_kib = 32, .lanes = 4, .secret = secret,
+                                    .secret_len = sizeof(secret), .ad = ad, .ad_len = sizeof(ad) };
+    ASSERT(ttak_argon2id(&params, pwd, sizeof(pwd), salt, sizeof(salt), tag, sizeof(tag), 0) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(tag, want, 32) == 0);
+}
+
+static void test_argon2id_shapes(void) {
+    // Odd lane counts, memory that rounds down, and tags on both sides of 64 bytes.
+    static const struct {
+        uint32_t t, m, p;
+        size_t tag_len;
+        const char *tag;
+    } cases[] = {
+        { 1, 16, 1, 4, "a9dd8722" },
+        { 1, 64, 1, 32, "729c7a54441bc13559bdca71348c4e554599e719c08a952601ed5c83618c1bbd" },
+        { 3, 300, 2, 16, "4b93eda3d2fb91e8853a2837410df959" },
+        { 2, 37, 3, 100,
+          "2a5b4487f252ec93b16c2ce9105db3bf8bb5b811686e5452350fe1266d1dacf7fd58f347ebc962586c2fcf4bf1e0e228"
+          "008f694800a88068932796d8b9dee78061f9cdf2cf4ae5e597955a3732e45a4114fc7d206b62868a30e7879eaad2d078"
+          "ced9dc75" },
+        // The reference implementation's own Argon2id test: 64 MiB, two passes.
+        { 2, 1U << 16, 1, 32, "09316115d5cf24ed5a15a31a3ba326e5cf32edc24702987c02b6566f61913cf7" },
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        uint8_t want[100], tag[100];
+        hex(cases[c].tag, want);
+        ttak_argon2_params_t params = { .t_cost = cases[c].t, .m_cost_kib = cases[c].m, .lanes = cases[c].p };
+        ASSERT(ttak_argon2id(&params, (const uint8_t *)"password", 8, (const uint8_t *)"somesalt", 8, tag,
+                             cases[c].tag_len, 0) == TTAK_IO_SUCCESS);
+        ASSERT_MSG(memcmp(tag, want, cases[c].tag_len) == 0, "t=%u m=%u p=%u", cases[c].t, cases[c].m, cases[c].p);
+    }
+}
+
+static void test_argon2id_pool_matches_single(void) {
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, 0);
+    ASSERT(pool != NULL);
+    uint8_t single[32], pooled[32];
+    ttak_argon2_params_t params = { .t_cost = 2, .m_cost_kib = 4096, .lanes = 4 };
+    ASSERT(ttak_argon2id(&params, (const uint8_t *)"pw", 2, (const uint8_t *)"saltsalt", 8, single, 32, 0) ==
+           TTAK_IO_SUCCESS);
+    params.pool = pool;
+    ASSERT(ttak_argon2id(&params, (const uint8_t *)"pw", 2, (const uint8_t *)"saltsalt", 8, pooled, 32, 0) ==
+           TTAK_IO_SUCCESS);
+    ASSERT(memcmp(single, pooled, 32) == 0);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void test_argon2id_rejects_bad_parameters(void) {
+    uint8_t tag[32];
+    const uint8_t *salt = (const uint8_t *)"somesalt";
+    ttak_argon2_params_t params = { .t_cost = 1, .m_cost_kib = 64, .lanes = 1 };
+    ASSERT(ttak_argon2id(&params, NULL, 0, salt, 7, tag, 32, 0) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_argon2id(&params, NULL, 0, salt, 8, tag, 3, 0) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_argon2id(&params, NULL, 5, salt, 8, tag, 32, 0) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_argon2id(&params, NULL, 0, salt, 8, NULL, 32, 0) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    params.lanes = 9;
+    ASSERT(ttak_argon2id(&params, NULL, 0, salt, 8, tag, 32, 0) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    params.lanes = 8;
+    ASSERT(ttak_argon2id(&params, NULL, 0, salt, 8, tag, 32, 0) == TTAK_IO_SUCCESS);
+}
+
+static void test_argon2id_engine_op(void) {
+    uint8_t pwd[32], salt[16], secret[8], tag[32], want[32];
+    memset(pwd, 0x01, sizeof(pwd));
+    memset(salt, 0x02, sizeof(salt));
+    memset(secret, 0x03, sizeof(secret));
+    ttak_argon2_params_t params = { .t_cost = 2, .m_cost_kib = 64, .lanes = 2, .secret = secret,
+                                    .secret_len = sizeof(secret) };
+    ASSERT(ttak_argon2id(&params, pwd, sizeof(pwd), salt, sizeof(salt), want, sizeof(want), 0) == TTAK_IO_SUCCESS);
+
+    ttak_crypto_ctx_t ctx = { .in = pwd, .in_len = sizeof(pwd), .aad = salt, .aad_len = sizeof(salt),
+                              .key = secret, .key_len = sizeof(secret), .out = tag, .out_len = sizeof(tag) };
+    ctx.hw_state.argon2.t_cost = 2;
+    ctx.hw_state.argon2.m_cost_kib = 64;
+    ctx.hw_state.argon2.lanes = 2;
+    ASSERT(ttak_security_execute(&ctx, TTAK_SECURITY_KDF_HARD, 0) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(tag, want, sizeof(tag)) == 0);
+
+    ctx.aad = NULL;
+    ASSERT(ttak_security_execute(&ctx, TTAK_SECURITY_KDF_HARD, 0) == TTAK_IO_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+    RUN_TEST(test_argon2id_rfc9106);
+    RUN_TEST(test_argon2id_shapes);
+    RUN_TEST(test_argon2id_pool_matches_single);
+    RUN_TEST(test_argon2id_rejects_bad_parameters);
+    RUN_TEST(test_argon2id_engine_op);
+    return 0;
+}
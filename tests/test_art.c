@@ -0,0 +1,229 @@
+#include <ttak/tree/art.h>
+#include <ttak/mem/epoch.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "test_macros.h"
+
+#define REF_ROUTES 3000
+#define REF_LOOKUPS 50000
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static uint32_t v4(unsigned a, unsigned b, unsigned c, unsigned d) {
+    return (uint32_t)a << 24 | (uint32_t)b << 16 | (uint32_t)c << 8 | d;
+}
+
+static void test_art_v4_basic(void) {
+    ttak_art_t art;
+    ASSERT(ttak_art_init(&art));
+    uintptr_t v = 0;
+    unsigned len = 0;
+    ASSERT(!ttak_art_lookup_v4(&art, v4(10, 1, 2, 3), &v, &len));
+
+    ASSERT(ttak_art_insert_v4(&art, 0, 0, 1));
+    ASSERT(ttak_art_insert_v4(&art, v4(10, 0, 0, 0), 8, 2));
+    ASSERT(ttak_art_insert_v4(&art, v4(10, 1, 0, 0), 16, 3));
+    ASSERT(ttak_art_insert_v4(&art, v4(10, 1, 2, 0), 24, 4));
+    ASSERT(ttak_art_insert_v4(&art, v4(10, 1, 2, 128), 25, 5));
+    ASSERT(ttak_art_insert_v4(&art, v4(10, 1, 2, 200), 32, 6));
+    ASSERT(ttak_art_insert_v4(&art, v4(10, 1, 3, 255), 22, 7)); /* 10.1.0.0/22; host bits ignored */
+    ASSERT(!ttak_art_insert_v4(&art, 0, 33, 0));
+    ASSERT(ttak_art_size(&art) == 7);
+
+    ASSERT(ttak_art_lookup_v4(&art, v4(192, 168, 0, 1), &v, &len) && v == 1 && len == 0);
+    ASSERT(ttak_art_lookup_v4(&art, v4(10, 9, 9, 9), &v, &len) && v == 2 && len == 8);
+    ASSERT(ttak_art_lookup_v4(&art, v4(10, 1, 9, 9), &v, &len) && v == 3 && len == 16);
+    ASSERT(ttak_art_lookup_v4(&art, v4(10, 1, 3, 9), &v, &len) && v == 7 && len == 22);
+    ASSERT(ttak_art_lookup_v4(&art, v4(10, 1, 2, 9), &v, &len) && v == 4 && len == 24);
+    ASSERT(ttak_art_lookup_v4(&art, v4(10, 1, 2, 129), &v, &len) && v == 5 && len == 25);
+    ASSERT(ttak_art_lookup_v4(&art, v4(10, 1, 2, 200), &v, &len) && v == 6 && len == 32);
+
+    ASSERT(ttak_art_insert_v4(&art, v4(10, 1, 2, 0), 24, 40));
+    ASSERT(ttak_art_size(&art) == 7);
+    uint8_t p[4];
+    ttak_art_v4_bytes(v4(10, 1, 2, 0), p);
+    ASSERT(ttak_art_get(&art, p, 24, &v) && v == 40);
+    ASSERT(!ttak_art_get(&art, p, 23, NULL));
+
+    ASSERT(ttak_art_remove_v4(&art, v4(10, 1, 2, 128), 25));
+    ASSERT(!ttak_art_remove_v4(&art, v4(10, 1, 2, 128), 25));
+    ASSERT(ttak_art_lookup_v4(&art, v4(10, 1, 2, 129), &v, &len) && v == 40 && len == 24);
+    ASSERT(ttak_art_remove_v4(&art, v4(10, 1, 2, 200), 32));
+    ASSERT(ttak_art_remove_v4(&art, v4(10, 1, 2, 0), 24));
+    ASSERT(ttak_art_lookup_v4(&art, v4(10, 1, 2, 200), &v, &len) && v == 7 && len == 22);
+    ASSERT(ttak_art_remove_v4(&art, 0, 0));
+    ASSERT(!ttak_art_lookup_v4(&art, v4(11, 0, 0, 0), &v, &len));
+    ASSERT(ttak_art_size(&art) == 3);
+    ttak_art_destroy(&art);
+    ttak_epoch_reclaim();
+}
+
+static void test_art_v6_and_fanout(void) {
+    ttak_art_t art;
+    ASSERT(ttak_art_init(&art));
+    uint8_t a[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+    ASSERT(ttak_art_insert(&art, a, 32, 1));
+    ASSERT(ttak_art_insert(&art, a, 128, 2));
+    ASSERT(!ttak_art_insert(&art, a, 129, 3));
+
+    /* One node takes every child byte, growing through node16, node48 and node256. */
+    uint8_t b[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+    for (unsigned i = 0; i < 256; i++) {
+        b[4] = (uint8_t)i;
+        ASSERT(ttak_art_insert(&art, b, 40, 100 + i));
+    }
+    uintptr_t v;
+    unsigned len;
+    ASSERT(ttak_art_lookup(&art, a, 16, &v, &len) && v == 2 && len == 128);
+    for (unsigned i = 0; i < 256; i++) {
+        b[4] = (uint8_t)i;
+        b[15] = 0x5a;
+        ASSERT(ttak_art_lookup(&art, b, 16, &v, &len) && v == 100 + i && len == 40);
+    }
+    /* ...and shrinks back as they go. */
+    for (unsigned i = 0; i < 256; i++) {
+        b[4] = (uint8_t)i;
+        if (i != 0) ASSERT(ttak_art_remove(&art, b, 40));
+        if (i % 17 == 0) ASSERT(ttak_art_lookup(&art, a, 16, &v, &len) && v == 2);
+    }
+    b[4] = 7;
+    ASSERT(ttak_art_lookup(&art, b, 16, &v, &len) && v == 1 && len == 32);
+    ASSERT(ttak_art_lookup(&art, a, 16, &v, &len) && v == 2 && len == 128);
+    ASSERT(ttak_art_size(&art) == 3);
+    ttak_art_destroy(&art);
+    ttak_epoch_reclaim();
+}
+
+typedef struct {
+    uint32_t addr;
+    unsigned len;
+    bool live;
+} ref_route_t;
+
+static ref_route_t routes[REF_ROUTES];
+
+static uint32_t prefix_mask(unsigned len) {
+    return len ? ~0u << (32 - len) : 0;
+}
+
+/* Linear longest-prefix match over the live reference routes. */
+static int ref_lookup(uint32_t addr) {
+    int best = -1;
+    for (int i = 0; i < REF_ROUTES; i++) {
+        if (!routes[i].live || ((addr ^ routes[i].addr) & prefix_mask(routes[i].len))) continue;
+        if (best < 0 || routes[i].len > routes[best].len) best = i;
+    }
+    return best;
+}
+
+static void test_art_matches_reference(void) {
+    ttak_art_t art;
+    ASSERT(ttak_art_init(&art));
+    /* Clustered addresses so prefixes nest; duplicates keep the first entry. */
+    for (int i = 0; i < REF_ROUTES; i++) {
+        unsigned len = (unsigned)(rng() % 33);
+        uint32_t addr = (uint32_t)(rng() & 0x0F0F3FFF) & prefix_mask(len);
+        routes[i] = (ref_route_t){ addr, len, true };
+        for (int j = 0; j < i; j++) {
+            if (routes[j].live && routes[j].addr == addr && routes[j].len == len) routes[i].live = false;
+        }
+        if (routes[i].live) ASSERT(ttak_art_insert_v4(&art, addr, len, (uintptr_t)i));
+    }
+    for (int i = 0; i < REF_ROUTES; i += 3) {
+        if (routes[i].live) ASSERT(ttak_art_remove_v4(&art, routes[i].addr, routes[i].len));
+        routes[i].live = false;
+    }
+    size_t live = 0;
+    for (int i = 0; i < REF_ROUTES; i++) live += routes[i].live;
+    ASSERT(ttak_art_size(&art) == live);
+
+    for (int i = 0; i < REF_LOOKUPS; i++) {
+        uint32_t addr = (uint32_t)(rng() & 0x0F0F3FFF);
+        int want = ref_lookup(addr);
+        uintptr_t v;
+        unsigned len;
+        bool hit = ttak_art_lookup_v4(&art, addr, &v, &len);
+        ASSERT(hit == (want >= 0));
+        if (hit) ASSERT((int)v == want && len == routes[want].len);
+    }
+    ttak_art_destroy(&art);
+    ttak_epoch_reclaim();
+}
+
+static ttak_art_t g_art;
+static _Atomic int g_stop;
+static _Atomic int g_bad;
+
+/* Flaps /24 and /32 routes under a permanent 10.0.0.0/8. */
+static void *writer_main(void *p) {
+    (void)p;
+    for (int round = 0; round < 20; round++) {
+        for (unsigned i = 0; i < 256; i++) {
+            ttak_art_insert_v4(&g_art, v4(10, i, 0, 0), 24, 24);
+            ttak_art_insert_v4(&g_art, v4(10, i, 0, 1), 32, 32);
+        }
+        for (unsigned i = 0; i < 256; i += 1 + (round & 1)) {
+            ttak_art_remove_v4(&g_art, v4(10, i, 0, 1), 32);
+            ttak_art_remove_v4(&g_art, v4(10, i, 0, 0), 24);
+        }
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void *reader_main(void *p) {
+    (void)p;
+    unsigned i = 0;
+    while (!atomic_load(&g_stop)) {
+        ttak_epoch_enter();
+        for (int k = 0; k < 256; k++, i = (i + 1) % 256) {
+            uintptr_t v;
+            unsigned len;
+            uint8_t addr[4];
+            ttak_art_v4_bytes(v4(10, i, 0, (unsigned)(k & 1)), addr);
+            if (!ttak_art_lookup_pinned(&g_art, addr, 4, &v, &len) || v != len || (len != 8 && len != 24 && len != 32) ||
+                (len == 32 && !(k & 1))) {
+                atomic_fetch_add(&g_bad, 1);
+            }
+        }
+        ttak_epoch_exit();
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void test_art_concurrent(void) {
+    ASSERT(ttak_art_init(&g_art));
+    ASSERT(ttak_art_insert_v4(&g_art, v4(10, 0, 0, 0), 8, 8));
+    atomic_store(&g_stop, 0);
+    atomic_store(&g_bad, 0);
+
+    pthread_t readers[2], writer;
+    for (int i = 0; i < 2; i++) pthread_create(&readers[i], NULL, reader_main, NULL);
+    pthread_create(&writer, NULL, writer_main, NULL);
+    pthread_join(writer, NULL);
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < 2; i++) pthread_join(readers[i], NULL);
+
+    ASSERT(atomic_load(&g_bad) == 0);
+    /* The last round removed every other pair. */
+    ASSERT(ttak_art_size(&g_art) == 1 + 256);
+    ttak_art_destroy(&g_art);
+    ttak_epoch_reclaim();
+}
+
+int main(void) {
+    RUN_TEST(test_art_v4_basic);
+    RUN_TEST(test_art_v6_and_fanout);
+    RUN_TEST(test_art_matches_reference);
+    RUN_TEST(test_art_concurrent);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <ttak/tree/ast.h>
+#include <ttak/mem/arena_helper.h>
+#include <stdint.h>
+#include "test_macros.h"
+
+#define AST_FANOUT 50
+#define AST_LEAVES 20
+
+static size_t values_freed;
+
+static void count_free(void *value) {
+    (void)value;
+    values_freed++;
+}
+
+/* Builds a root with AST_FANOUT children of AST_LEAVES leaves each; returns the node count. */
+static size_t build(ttak_ast_tree_t *tree, uint64_t now) {
+    static int payload;
+    size_t nodes = 1;
+    tree->root = ttak_ast_tree_create_node(tree, 0, &payload, now);
+    ASSERT(tree->root != NULL);
+    for (int i = 0; i < AST_FANOUT; i++) {
+        ttak_ast_node_t *mid = ttak_ast_tree_create_node(tree, 1, &payload, now);
+        ASSERT(mid != NULL);
+        ttak_ast_add_child(tree->root, mid, now);
+        nodes++;
+        for (int j = 0; j < AST_LEAVES; j++) {
+            ttak_ast_node_t *leaf = ttak_ast_tree_create_node(tree, 2, &payload, now);
+            ASSERT(leaf != NULL);
+            ttak_ast_add_child(mid, leaf, now);
+            nodes++;
+        }
+    }
+    return nodes;
+}
+
+static void check_shape(const ttak_ast_tree_t *tree) {
+    ASSERT(tree->root->num_children == AST_FANOUT);
+    for (int i = 0; i < AST_FANOUT; i++) {
+        ttak_ast_node_t *mid = tree->root->children[i];
+        ASSERT(mid->type == 1 && mid->parent == tree->root);
+        ASSERT(mid->num_children == AST_LEAVES);
+        for (int j = 0; j < AST_LEAVES; j++) {
+            ASSERT(mid->children[j]->type == 2 && mid->children[j]->parent == mid);
+        }
+    }
+}
+
+static void test_ast_heap(void) {
+    uint64_t now = 1000;
+    ttak_ast_tree_t tree;
+    ttak_ast_tree_init(&tree, count_free);
+    size_t nodes = build(&tree, now);
+    ASSERT(tree.root->arena_owner == NULL);
+    check_shape(&tree);
+    values_freed = 0;
+    ttak_ast_tree_destroy(&tree, now);
+    ASSERT(values_freed == nodes);
+    ASSERT(tree.root == NULL);
+}
+
+static void test_ast_arena(void) {
+    uint64_t now = 1000;
+    ttak_arena_env_t env;
+    ttak_arena_env_config_t cfg;
+    ttak_arena_env_config_init(&cfg);
+    cfg.generation_bytes = 1 << 16;
+    cfg.lane_refill_bytes = 1 << 16;
+    ASSERT(ttak_arena_env_init(&env, &cfg));
+    ttak_arena_generation_t gen;
+    ASSERT(ttak_arena_generation_begin_lanes(&env, &gen, 1, 1));
+
+    ttak_ast_tree_t tree;
+    ttak_ast_tree_init(&tree, NULL);
+    ASSERT(ttak_ast_tree_use_arena(&tree, &env, &gen, 0));
+    build(&tree, now);
+    ASSERT(!ttak_ast_tree_use_arena(&tree, &env, &gen, 0));
+    ASSERT(tree.root->arena_owner == &tree);
+    check_shape(&tree);
+    ttak_ast_tree_destroy(&tree, now);
+    ASSERT(tree.root == NULL);
+
+    /* A free_value hook still sees every payload. */
+    ttak_ast_tree_init(&tree, count_free);
+    ASSERT(ttak_ast_tree_use_arena(&tree, &env, &gen, 0));
+    size_t nodes = build(&tree, now);
+    values_freed = 0;
+    ttak_ast_tree_destroy(&tree, now);
+    ASSERT(values_freed == nodes);
+
+    ASSERT(ttak_arena_generation_retire(&env, &gen));
+    ttak_arena_env_destroy(&env);
+}
+
+int main(void) {
+    RUN_TEST(test_ast_heap);
+    RUN_TEST(test_ast_arena);
+    return 0;
+}
@@ -2,6 +2,9 @@
 #include <ttak/async/sched.h>
 #include <ttak/async/promise.h>
 #include <ttak/mem/mem.h>
+#include <ttak/thread/pool.h>
+#include <ttak/timing/timing.h>
+#include <stdint.h>
 #include "test_macros.h"
 
 void *my_task_func(void *arg) {
@@ -77,6 +80,20 @@ void test_async_schedule_with_pool() {
     ttak_mem_free(promise);
 }
 
+void test_async_pool_built_on_first_use() {
+    ASSERT(ttak_async_pool() == NULL);
+    ttak_async_init(0);
+    ASSERT(async_pool == NULL);
+
+    ttak_thread_pool_t *pool = ttak_async_pool();
+    ASSERT(pool != NULL);
+    ASSERT(async_pool == pool);
+    ASSERT(ttak_async_pool() == pool);
+
+    ttak_async_shutdown();
+    ASSERT(ttak_async_pool() == NULL);
+}
+
 void test_task_metadata_domain_urgency() {
     uint64_t now = 5000;
     ttak_task_t *task = ttak_task_create(my_task_func, NULL, NULL, now);
@@ -96,11 +113,99 @@ void test_task_metadata_domain_urgency() {
     ttak_task_destroy(task, now + 10);
 }
 
+static void *stage_add(void *result, void *arg) {
+    return (void *)((uintptr_t)result + (uintptr_t)arg);
+}
+
+static void *stage_id(void *arg) {
+    return arg;
+}
+
+void test_future_then_chain(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+
+    ttak_promise_t *promise = ttak_promise_create(now);
+    ASSERT(promise != NULL);
+    ttak_future_t *src = ttak_promise_get_future(promise);
+
+    /* Chain four stages before the source resolves; none of them blocks. */
+    ttak_future_t *stages[4];
+    ttak_future_t *prev = src;
+    for (int i = 0; i < 4; ++i) {
+        stages[i] = ttak_future_then(prev, pool, stage_add, (void *)(uintptr_t)(i + 1), now);
+        ASSERT(stages[i] != NULL);
+        prev = stages[i];
+    }
+    ASSERT(!ttak_future_is_ready(stages[3]));
+    ttak_promise_set_value(promise, (void *)(uintptr_t)100, now);
+    ASSERT(ttak_future_get(stages[3]) == (void *)(uintptr_t)110);
+
+    /* Already ready and no pool: runs inline on the caller. */
+    ttak_future_t *late = ttak_future_then(src, NULL, stage_add, (void *)(uintptr_t)5, now);
+    ASSERT(late != NULL && ttak_future_is_ready(late));
+    ASSERT(ttak_future_get(late) == (void *)(uintptr_t)105);
+
+    ttak_future_destroy(late);
+    for (int i = 0; i < 4; ++i) ttak_future_destroy(stages[i]);
+    ttak_future_destroy(src);
+    ttak_mem_free(promise);
+    ttak_thread_pool_destroy(pool);
+}
+
+void test_future_when_all_any(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(4, 0, now);
+    ASSERT(pool != NULL);
+
+    enum { N = 8 };
+    ttak_future_t *futs[N];
+    for (int i = 0; i < N; ++i) {
+        futs[i] = ttak_thread_pool_submit_task(pool, stage_id, (void *)(uintptr_t)(i * 10), 0, now);
+        ASSERT(futs[i] != NULL);
+    }
+    void *results[N];
+    ttak_future_t *all = ttak_future_when_all(futs, N, results, now);
+    ASSERT(all != NULL);
+    ASSERT(ttak_future_get(all) == (void *)results);
+    for (int i = 0; i < N; ++i) ASSERT(results[i] == (void *)(uintptr_t)(i * 10));
+
+    ttak_promise_t *never = ttak_promise_create(now);
+    ttak_promise_t *first = ttak_promise_create(now);
+    ttak_future_t *pair[2] = { ttak_promise_get_future(never), ttak_promise_get_future(first) };
+    size_t winner = SIZE_MAX;
+    ttak_future_t *any = ttak_future_when_any(pair, 2, &winner, now);
+    ASSERT(any != NULL && !ttak_future_is_ready(any));
+    ttak_promise_set_value(first, (void *)(uintptr_t)7, now);
+    ASSERT(ttak_future_get(any) == (void *)(uintptr_t)7);
+    ASSERT(winner == 1);
+    /* The loser still fires into the join, which must be alive until then. */
+    ttak_promise_set_value(never, (void *)(uintptr_t)8, now);
+    ASSERT(winner == 1);
+
+    ttak_future_t *none = ttak_future_when_all(futs, 0, NULL, now);
+    ASSERT(none != NULL && ttak_future_is_ready(none));
+    ASSERT(ttak_future_when_any(futs, 0, NULL, now) == NULL);
+
+    ttak_future_destroy(none);
+    ttak_future_destroy(any);
+    ttak_future_destroy(all);
+    for (int i = 0; i < 2; ++i) ttak_future_destroy(pair[i]);
+    ttak_mem_free(never);
+    ttak_mem_free(first);
+    for (int i = 0; i < N; ++i) ttak_future_destroy(futs[i]);
+    ttak_thread_pool_destroy(pool);
+}
+
 int main() {
     RUN_TEST(test_task_create_execute);
     RUN_TEST(test_promise_future_basic);
     RUN_TEST(test_async_schedule_fallback);
     RUN_TEST(test_async_schedule_with_pool);
+    RUN_TEST(test_async_pool_built_on_first_use);
     RUN_TEST(test_task_metadata_domain_urgency);
+    RUN_TEST(test_future_then_chain);
+    RUN_TEST(test_future_when_all_any);
     return 0;
 }
@@ -1,4 +1,7 @@
 #include <ttak/atomic/atomic.h>
+#include <ttak/atomic/atomic128.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "test_macros.h"
 
 void test_atomic_basic() {
@@ -14,7 +17,101 @@ void test_atomic_basic() {
     ASSERT(ttak_atomic_read64(&val) == 21);
 }
 
+static void test_atomic128_basic(void) {
+    ttak_atomic128_t v = { 1, 2 };
+    ttak_u128_t exp = { 1, 3 };
+    ASSERT(!ttak_atomic128_cas(&v, &exp, (ttak_u128_t){ 9, 9 }));
+    ASSERT(exp.lo == 1 && exp.hi == 2);
+    ASSERT(ttak_atomic128_cas(&v, &exp, (ttak_u128_t){ UINT64_MAX, 5 }));
+    ASSERT(v.lo == UINT64_MAX && v.hi == 5);
+
+    // The runtime path must agree with whatever the inline one compiled to.
+    exp = (ttak_u128_t){ UINT64_MAX, 4 };
+    ASSERT(!ttak_atomic128_cas_runtime(&v, &exp, (ttak_u128_t){ 0, 0 }));
+    ASSERT(exp.lo == UINT64_MAX && exp.hi == 5);
+    ASSERT(ttak_atomic128_cas_runtime(&v, &exp, (ttak_u128_t){ 7, 8 }));
+
+    ttak_u128_t cur = ttak_atomic128_load(&v);
+    ASSERT(cur.lo == 7 && cur.hi == 8);
+    ttak_atomic128_store(&v, (ttak_u128_t){ 0, 1ULL << 63 });
+    cur = ttak_atomic128_load(&v);
+    ASSERT(cur.lo == 0 && cur.hi == 1ULL << 63);
+
+#if defined(__x86_64__) || defined(__aarch64__)
+    ASSERT(ttak_atomic128_is_lock_free());
+#endif
+}
+
+#define STACK_NODES 64
+#define STACK_THREADS 4
+#define STACK_ROUNDS 50000
+
+/* Treiber stack whose head pairs a node pointer with a full 64-bit tag. */
+typedef struct node {
+    struct node *_Atomic next;
+    _Atomic int owned;
+} node_t;
+
+static ttak_atomic128_t g_head;
+static node_t g_nodes[STACK_NODES];
+static _Atomic int g_bad;
+
+static void stack_push(node_t *n, bool runtime) {
+    ttak_u128_t old = ttak_atomic128_load(&g_head);
+    for (;;) {
+        atomic_store_explicit(&n->next, (node_t *)(uintptr_t)old.lo, memory_order_relaxed);
+        ttak_u128_t next = { (uint64_t)(uintptr_t)n, old.hi + 1 };
+        if (runtime ? ttak_atomic128_cas_runtime(&g_head, &old, next) : ttak_atomic128_cas(&g_head, &old, next)) return;
+    }
+}
+
+static node_t *stack_pop(bool runtime) {
+    ttak_u128_t old = ttak_atomic128_load(&g_head);
+    for (;;) {
+        node_t *top = (node_t *)(uintptr_t)old.lo;
+        if (!top) return NULL;
+        // Nodes are never freed, so a stale top is still readable; the tag
+        // rejects the CAS if it was popped and pushed back meanwhile.
+        ttak_u128_t next = { (uint64_t)(uintptr_t)atomic_load_explicit(&top->next, memory_order_relaxed),
+                             old.hi + 1 };
+        if (runtime ? ttak_atomic128_cas_runtime(&g_head, &old, next) : ttak_atomic128_cas(&g_head, &old, next)) {
+            return top;
+        }
+    }
+}
+
+static void *stack_worker(void *arg) {
+    bool runtime = (uintptr_t)arg & 1;
+    for (int i = 0; i < STACK_ROUNDS; i++) {
+        node_t *n = stack_pop(runtime);
+        if (!n) continue;
+        if (atomic_exchange(&n->owned, 1)) atomic_store(&g_bad, 1);
+        atomic_store(&n->owned, 0);
+        stack_push(n, runtime);
+    }
+    return NULL;
+}
+
+static void test_atomic128_tagged_stack(void) {
+    for (int i = 0; i < STACK_NODES; i++) stack_push(&g_nodes[i], false);
+    pthread_t t[STACK_THREADS];
+    for (uintptr_t i = 0; i < STACK_THREADS; i++) {
+        ASSERT(pthread_create(&t[i], NULL, stack_worker, (void *)i) == 0);
+    }
+    for (int i = 0; i < STACK_THREADS; i++) pthread_join(t[i], NULL);
+    ASSERT(!atomic_load(&g_bad));
+
+    // Every node is back exactly once.
+    int seen[STACK_NODES] = { 0 };
+    node_t *n;
+    while ((n = stack_pop(false)) != NULL) seen[n - g_nodes]++;
+    for (int i = 0; i < STACK_NODES; i++) ASSERT(seen[i] == 1);
+    ASSERT(ttak_atomic128_load(&g_head).hi >= 2ULL * STACK_NODES);
+}
+
 int main() {
     RUN_TEST(test_atomic_basic);
+    RUN_TEST(test_atomic128_basic);
+    RUN_TEST(test_atomic128_tagged_stack);
     return 0;
-}
\ No newline at end of file
+}
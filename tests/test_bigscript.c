@@ -1,9 +1,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <assert.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include "test_macros.h"
 #include <ttak/script/bigscript.h>
 #include <ttak/timing/timing.h>
+#include <ttak/math/sum_divisors.h>
+#include <ttak/thread/pool.h>
+#include <ttak/security/sha256.h>
 
 void test_basic_arithmetic(void) {
     printf("[TEST] Basic Arithmetic\n");
@@ -30,14 +36,14 @@ void test_basic_arithmetic(void) {
     ttak_bigscript_value_t out;
     memset(&out, 0, sizeof(out));
     bool ok = ttak_bigscript_eval_seed(prog, vm, &seed, &sn, &out, &err, now);
-    assert(ok);
+    ASSERT(ok);
     
     uint64_t res = 0;
     if (out.value.type == TTAK_BIGSCRIPT_VAL_INT) {
         ttak_bigint_export_u64(&out.value.v.i, &res);
     }
     printf("Result: %lu (Expected: 50)\n", res);
-    assert(res == 50);
+    ASSERT(res == 50);
     
     ttak_bigscript_value_free(&out, now);
     ttak_bigint_free(&seed, now);
@@ -59,7 +65,7 @@ void test_builtin_s(void) {
     uint64_t now = ttak_get_tick_count();
     ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
     ttak_bigscript_program_t *prog = ttak_bigscript_compile(src, NULL, NULL, &err, now);
-    assert(prog);
+    ASSERT(prog);
     
     ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(NULL, now);
     ttak_bigint_t seed, sn;
@@ -70,8 +76,8 @@ void test_builtin_s(void) {
     ttak_bigscript_value_t out;
     memset(&out, 0, sizeof(out));
     bool ok = ttak_bigscript_eval_seed(prog, vm, &seed, &sn, &out, &err, now);
-    assert(ok);
-    assert(out.is_found == true);
+    ASSERT(ok);
+    ASSERT(out.is_found == true);
     
     ttak_bigscript_value_free(&out, now);
     ttak_bigint_free(&seed, now);
@@ -86,7 +92,7 @@ void test_constant_return(void) {
     uint64_t now = ttak_get_tick_count();
     ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
     ttak_bigscript_program_t *prog = ttak_bigscript_compile(src, NULL, NULL, &err, now);
-    assert(prog);
+    ASSERT(prog);
     ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(NULL, now);
     ttak_bigint_t seed, sn;
     ttak_bigint_init_u64(&seed, 0, now); ttak_bigint_init_u64(&sn, 0, now);
@@ -99,7 +105,7 @@ void test_constant_return(void) {
         ttak_bigint_export_u64(&out.value.v.i, &res);
     }
     printf("Result: %lu (Expected: 50)\n", res);
-    assert(res == 50);
+    ASSERT(res == 50);
     ttak_bigscript_value_free(&out, now); ttak_bigint_free(&seed, now); ttak_bigint_free(&sn, now);
     ttak_bigscript_vm_free(vm, now); ttak_bigscript_program_free(prog, now);
 }
@@ -116,7 +122,7 @@ void test_real_complex(void) {
     uint64_t now = ttak_get_tick_count();
     ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
     ttak_bigscript_program_t *prog = ttak_bigscript_compile(src, NULL, NULL, &err, now);
-    assert(prog);
+    ASSERT(prog);
     
     ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(NULL, now);
     ttak_bigint_t seed, sn;
@@ -126,15 +132,15 @@ void test_real_complex(void) {
     ttak_bigscript_value_t out;
     memset(&out, 0, sizeof(out));
     bool ok = ttak_bigscript_eval_seed(prog, vm, &seed, &sn, &out, &err, now);
-    assert(ok);
-    assert(out.value.type == TTAK_BIGSCRIPT_VAL_COMPLEX);
+    ASSERT(ok);
+    ASSERT(out.value.type == TTAK_BIGSCRIPT_VAL_COMPLEX);
     
     uint64_t re = 0, im = 0;
     ttak_bigint_export_u64(&out.value.v.c.real.mantissa, &re);
     ttak_bigint_export_u64(&out.value.v.c.imag.mantissa, &im);
     printf("Result: %lu + %lui\n", re, im);
-    assert(re == 5);
-    assert(im == 10);
+    ASSERT(re == 5);
+    ASSERT(im == 10);
     
     ttak_bigscript_value_free(&out, now);
     ttak_bigint_free(&seed, now);
@@ -143,11 +149,402 @@ void test_real_complex(void) {
     ttak_bigscript_program_free(prog, now);
 }
 
+static uint64_t eval_u64(ttak_bigscript_program_t *prog, ttak_bigscript_vm_t *vm, uint64_t seed_v, uint64_t sn_v, bool *ok_out, ttak_bigscript_error_t *err, uint64_t now) {
+    ttak_bigint_t seed, sn;
+    ttak_bigint_init_u64(&seed, seed_v, now);
+    ttak_bigint_init_u64(&sn, sn_v, now);
+    ttak_bigscript_value_t out;
+    memset(&out, 0, sizeof(out));
+    *ok_out = ttak_bigscript_eval_seed(prog, vm, &seed, &sn, &out, err, now);
+    uint64_t res = 0;
+    if (*ok_out && out.value.type == TTAK_BIGSCRIPT_VAL_INT) {
+        ttak_bigint_export_u64(&out.value.v.i, &res);
+    }
+    if (*ok_out) ttak_bigscript_value_free(&out, now);
+    ttak_bigint_free(&seed, now);
+    ttak_bigint_free(&sn, now);
+    return res;
+}
+
+void test_control_flow_and_mod(void) {
+    printf("[TEST] Control Flow, Comparisons and Modulo\n");
+    const char *src =
+        "fn main(seed, sn) {\n"
+        "  if (seed == 100) { return 1; }\n"
+        "  if (seed < 50) { return 2; }\n"
+        "  if (seed >= sn) { return 3; }\n"
+        "  if (seed % 7 != 0) { return seed % 7 + 10; }\n"
+        "  return 0;\n"
+        "}\n";
+    uint64_t now = ttak_get_tick_count();
+    ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+    ttak_bigscript_program_t *prog = ttak_bigscript_compile(src, NULL, NULL, &err, now);
+    ASSERT(prog);
+    ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(NULL, now);
+    bool ok;
+    // The same VM serves every seed; registers left by one run must not leak into the next.
+    ASSERT(eval_u64(prog, vm, 100, 0, &ok, &err, now) == 1 && ok);
+    ASSERT(eval_u64(prog, vm, 49, 0, &ok, &err, now) == 2 && ok);
+    ASSERT(eval_u64(prog, vm, 60, 60, &ok, &err, now) == 3 && ok);
+    ASSERT(eval_u64(prog, vm, 61, 90, &ok, &err, now) == 15 && ok);
+    ASSERT(eval_u64(prog, vm, 63, 90, &ok, &err, now) == 0 && ok);
+    ttak_bigscript_vm_free(vm, now);
+    ttak_bigscript_program_free(prog, now);
+}
+
+void test_constant_folding(void) {
+    printf("[TEST] Constant Folding\n");
+    // Folded at compile time, including the dead branch and the literal condition.
+    const char *src =
+        "fn main(seed, sn) {\n"
+        "  let k = (2 * 3 + 4) % 7 * 100000000000 * 100000000000;\n"
+        "  if (0) { return 99; }\n"
+        "  if (1 < 2) { return k / 100000000000 + seed - seed; }\n"
+        "  return 7;\n"
+        "}\n";
+    uint64_t now = ttak_get_tick_count();
+    ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+    ttak_bigscript_program_t *prog = ttak_bigscript_compile(src, NULL, NULL, &err, now);
+    ASSERT(prog);
+    ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(NULL, now);
+    bool ok;
+    ASSERT(eval_u64(prog, vm, 5, 0, &ok, &err, now) == 300000000000ULL && ok);
+    ttak_bigscript_vm_free(vm, now);
+    ttak_bigscript_program_free(prog, now);
+}
+
+void test_function_calls(void) {
+    printf("[TEST] Function Calls\n");
+    const char *src =
+        "fn fact(n) { if (n <= 1) { return 1; } return n * fact(n - 1); }\n"
+        "fn pick(a, b, c) { if (a > b) { return c; } return a + b + c; }\n"
+        "fn main(seed, sn) {\n"
+        "  let t = pick(seed, 3, 1000);\n"
+        "  return fact(seed) + t;\n"
+        "}\n";
+    uint64_t now = ttak_get_tick_count();
+    ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+    ttak_bigscript_program_t *prog = ttak_bigscript_compile(src, NULL, NULL, &err, now);
+    ASSERT(prog);
+    ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(NULL, now);
+    bool ok;
+    ASSERT(eval_u64(prog, vm, 20, 0, &ok, &err, now) == 2432902008176640000ULL + 1000 && ok);
+    ASSERT(eval_u64(prog, vm, 2, 0, &ok, &err, now) == 2 + 1005 && ok);
+    ttak_bigscript_vm_free(vm, now);
+    ttak_bigscript_program_free(prog, now);
+
+    // Unbounded recursion stops at the call depth limit.
+    ttak_bigscript_limits_t limits = {0};
+    limits.max_call_depth = 16;
+    prog = ttak_bigscript_compile("fn f(n) { return f(n + 1); } fn main(seed, sn) { return f(seed); }", NULL, &limits, &err, now);
+    ASSERT(prog);
+    vm = ttak_bigscript_vm_create(&limits, now);
+    eval_u64(prog, vm, 0, 0, &ok, &err, now);
+    ASSERT(!ok && err.code == TTAK_BIGSCRIPT_ERR_LIMIT);
+    ttak_bigscript_vm_free(vm, now);
+    ttak_bigscript_program_free(prog, now);
+}
+
+void test_errors(void) {
+    printf("[TEST] Errors\n");
+    uint64_t now = ttak_get_tick_count();
+    ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+    ASSERT(ttak_bigscript_compile("fn main(seed, sn) { return y; }", NULL, NULL, &err, now) == NULL);
+    ASSERT(err.code == TTAK_BIGSCRIPT_ERR_SYNTAX);
+    err.code = TTAK_BIGSCRIPT_ERR_NONE;
+    ASSERT(ttak_bigscript_compile("fn main(seed, sn) { return s(seed, sn); }", NULL, NULL, &err, now) == NULL);
+    ASSERT(err.code == TTAK_BIGSCRIPT_ERR_SYNTAX);
+
+    // A zero divisor is left to run time rather than folded.
+    err.code = TTAK_BIGSCRIPT_ERR_NONE;
+    ttak_bigscript_program_t *prog = ttak_bigscript_compile("fn main(seed, sn) { return seed / (sn - sn) + 1 / 0; }", NULL, NULL, &err, now);
+    ASSERT(prog);
+    ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(NULL, now);
+    bool ok;
+    eval_u64(prog, vm, 5, 3, &ok, &err, now);
+    ASSERT(!ok && err.code == TTAK_BIGSCRIPT_ERR_MATH);
+    ttak_bigscript_vm_free(vm, now);
+    ttak_bigscript_program_free(prog, now);
+}
+
+void test_eval_batch(void) {
+    printf("[TEST] Batch Evaluation\n");
+    // Cubes of the larger seeds overflow 64 bits and divisions by zero fail,
+    // so the batch mixes word-sized results, bigint reruns and errors.
+    const char *src =
+        "fn main(seed, sn) {\n"
+        "  if (seed % 97 == 0) { return seed / (sn - sn); }\n"
+        "  if (s(seed) == sn) { return seed * seed * seed; }\n"
+        "  return seed % 7;\n"
+        "}\n";
+    uint64_t now = ttak_get_tick_count();
+    ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+    ttak_bigscript_program_t *prog = ttak_bigscript_compile(src, NULL, NULL, &err, now);
+    ASSERT(prog);
+    enum { N = 1000 };
+    ttak_bigint_t *seeds = calloc(N, sizeof(*seeds)), *sns = calloc(N, sizeof(*sns));
+    ttak_bigscript_value_t *outs = calloc(N, sizeof(*outs));
+    ttak_bigscript_error_t *errs = calloc(N, sizeof(*errs));
+    ASSERT(seeds && sns && outs && errs);
+    for (size_t i = 0; i < N; i++) {
+        uint64_t v = (i % 2) ? (uint64_t)i + 2 : (1ULL << 40) + i, sv = 0;
+        ttak_sum_proper_divisors_u64(v, &sv);
+        ttak_bigint_init_u64(&seeds[i], v, now);
+        ttak_bigint_init_u64(&sns[i], (i % 3) ? sv : sv + 1, now);
+    }
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, now);
+    ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(NULL, now);
+    for (int pass = 0; pass < 2; pass++) {
+        ASSERT(!ttak_bigscript_eval_batch(prog, seeds, sns, N, outs, errs, pass ? pool : NULL, now));
+        for (size_t i = 0; i < N; i++) {
+            ttak_bigscript_value_t ref; memset(&ref, 0, sizeof(ref));
+            ttak_bigscript_error_t rerr = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+            bool ok = ttak_bigscript_eval_seed(prog, vm, &seeds[i], &sns[i], &ref, &rerr, now);
+            ASSERT(errs[i].code == rerr.code);
+            if (ok) {
+                ASSERT(outs[i].is_found == ref.is_found);
+                ASSERT(ttak_bigint_cmp(&outs[i].value.v.i, &ref.value.v.i) == 0);
+                ttak_bigscript_value_free(&ref, now);
+            }
+            ttak_bigscript_value_free(&outs[i], now);
+        }
+    }
+    ttak_bigscript_vm_free(vm, now);
+    ttak_thread_pool_destroy(pool);
+    for (size_t i = 0; i < N; i++) { ttak_bigint_free(&seeds[i], now); ttak_bigint_free(&sns[i], now); }
+    free(seeds); free(sns); free(outs); free(errs);
+    ttak_bigscript_program_free(prog, now);
+}
+
+void test_compile_cache(void) {
+    printf("[TEST] Compiled Program Cache\n");
+    const char *src = "fn main(seed, sn) { if (seed > 10) { return seed * 100000000000 * 100000000000; } return seed + sn; }\n";
+    uint64_t now = ttak_get_tick_count();
+    ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+    ttak_bigscript_limits_t limits = {0};
+    limits.max_call_depth = 8;
+
+    ttak_bigscript_program_t *a = ttak_bigscript_compile_cached(src, NULL, &limits, &err, now);
+    ttak_bigscript_program_t *b = ttak_bigscript_compile_cached(src, NULL, &limits, &err, now);
+    ttak_bigscript_program_t *c = ttak_bigscript_compile_cached(src, NULL, NULL, &err, now);
+    ASSERT(a && a == b && c && c != a);
+    ASSERT(ttak_bigscript_compile_cached("fn main(seed, sn) { return y; }", NULL, NULL, &err, now) == NULL);
+    ASSERT(err.code == TTAK_BIGSCRIPT_ERR_SYNTAX);
+    err.code = TTAK_BIGSCRIPT_ERR_NONE;
+    ttak_bigscript_program_free(b, now);
+    ttak_bigscript_program_free(c, now);
+    // Clearing the cache leaves held programs usable.
+    ttak_bigscript_cache_clear();
+    ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(&limits, now);
+    bool ok;
+    ASSERT(eval_u64(a, vm, 3, 4, &ok, &err, now) == 7 && ok);
+    ttak_bigscript_program_free(a, now);
+
+    // A bytecode file written by one compile is loaded by the next.
+    char dir[] = "/tmp/ttak_bigscript_cacheXXXXXX";
+    ASSERT(mkdtemp(dir));
+    ASSERT(ttak_bigscript_cache_set_dir(dir));
+    a = ttak_bigscript_compile_cached(src, NULL, &limits, &err, now);
+    ASSERT(a);
+    char hash[65], path[256];
+    ttak_bigscript_hash_program(a, hash);
+    snprintf(path, sizeof(path), "%s/%s.tbc", dir, hash);
+    ASSERT(access(path, R_OK) == 0);
+    ttak_bigscript_program_free(a, now);
+    ttak_bigscript_cache_clear();
+    a = ttak_bigscript_compile_cached(src, NULL, &limits, &err, now);
+    ASSERT(a);
+    ASSERT(eval_u64(a, vm, 3, 4, &ok, &err, now) == 7 && ok);
+    ttak_bigscript_value_t out; memset(&out, 0, sizeof(out));
+    ttak_bigint_t seed, sn, expect;
+    ttak_bigint_init_u64(&seed, 11, now); ttak_bigint_init_u64(&sn, 0, now); ttak_bigint_init_u64(&expect, 1100000000000ULL, now);
+    ttak_bigint_mul_u64(&expect, &expect, 100000000000ULL, now);
+    ASSERT(ttak_bigscript_eval_seed(a, vm, &seed, &sn, &out, &err, now));
+    ASSERT(ttak_bigint_cmp(&out.value.v.i, &expect) == 0);
+    ttak_bigscript_value_free(&out, now);
+    ttak_bigscript_program_free(a, now);
+    ttak_bigscript_cache_clear();
+
+    // A damaged file is ignored and rewritten.
+    FILE *fp = fopen(path, "r+b");
+    ASSERT(fp);
+    fseek(fp, 20, SEEK_SET); fputc(0x5a, fp); fclose(fp);
+    a = ttak_bigscript_compile_cached(src, NULL, &limits, &err, now);
+    ASSERT(a);
+    ASSERT(eval_u64(a, vm, 3, 4, &ok, &err, now) == 7 && ok);
+    ttak_bigscript_program_free(a, now);
+    ttak_bigscript_cache_clear();
+
+    // A file with a valid checksum but an out-of-range operand is rejected
+    // and replaced by a fresh compile.
+    fp = fopen(path, "rb");
+    ASSERT(fp);
+    uint8_t good[4096], bad[4096];
+    size_t len = fread(good, 1, sizeof(good), fp);
+    fclose(fp);
+    ASSERT(len > 32 && len < sizeof(good));
+    size_t code_at = 12 + sizeof(ttak_bigscript_limits_t) + 64 + 4;
+    for (uint32_t w = 1; w < 4; w++) {
+        memcpy(bad, good, len);
+        uint32_t word = 0x7FFFFFF0u;
+        memcpy(bad + code_at + 4 * w, &word, 4);
+        SHA256_CTX ctx;
+        sha256_init(&ctx); sha256_update(&ctx, bad, len - 32); sha256_final(&ctx, bad + len - 32);
+        fp = fopen(path, "wb");
+        ASSERT(fp && fwrite(bad, 1, len, fp) == len);
+        fclose(fp);
+        a = ttak_bigscript_compile_cached(src, NULL, &limits, &err, now);
+        ASSERT(a);
+        ASSERT(eval_u64(a, vm, 3, 4, &ok, &err, now) == 7 && ok);
+        ttak_bigscript_program_free(a, now);
+        ttak_bigscript_cache_clear();
+        fp = fopen(path, "rb");
+        ASSERT(fp && fread(bad, 1, sizeof(bad), fp) == len);
+        fclose(fp);
+        ASSERT(memcmp(bad, good, len) == 0);
+    }
+
+    // Everything the compiler emits passes the loader's checks: a second
+    // compile loads the file instead of rewriting it.
+    const char *more[] = {
+        "fn fact(n) { if (n <= 1) { return 1; } return n * fact(n - 1); }\n"
+        "fn main(seed, sn) { if (seed % 5 == 0) { return fact(seed % 40); } return fact(seed % 19) / (seed % 7) + sn - seed; }\n",
+        "fn f(n) { if (n == 0) { return 0; } return f(n - 1) + 1; }\n"
+        "fn main(seed, sn) { let a = f(seed % 7); if (a != sn) { if (a >= 3) { return real(a) + complex(s(seed), is_zero(sn)); } } return a / 2; }\n",
+    };
+    for (size_t m = 0; m < sizeof(more) / sizeof(more[0]); m++) {
+        a = ttak_bigscript_compile_cached(more[m], NULL, &limits, &err, now);
+        ASSERT(a);
+        char mpath[256];
+        ttak_bigscript_hash_program(a, hash);
+        snprintf(mpath, sizeof(mpath), "%s/%s.tbc", dir, hash);
+        ttak_bigscript_program_free(a, now);
+        ttak_bigscript_cache_clear();
+        struct utimbuf epoch = { 0, 0 };
+        ASSERT(utime(mpath, &epoch) == 0);
+        a = ttak_bigscript_compile_cached(more[m], NULL, &limits, &err, now);
+        ASSERT(a);
+        struct stat st;
+        ASSERT(stat(mpath, &st) == 0 && st.st_mtime == 0);
+        ttak_bigscript_program_free(a, now);
+        ttak_bigscript_cache_clear();
+        remove(mpath);
+    }
+    ttak_bigscript_cache_set_dir(NULL);
+
+    remove(path);
+    rmdir(dir);
+    ttak_bigint_free(&seed, now); ttak_bigint_free(&sn, now); ttak_bigint_free(&expect, now);
+    ttak_bigscript_vm_free(vm, now);
+}
+
+void test_compile_cache_eviction(void) {
+    printf("[TEST] Program Cache Eviction\n");
+    uint64_t now = ttak_get_tick_count();
+    ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+    char src[128];
+    ttak_bigscript_cache_clear();
+
+    // Script 0 keeps getting hits, script 1 is held by the caller only.
+    snprintf(src, sizeof(src), "fn main(seed, sn) { return seed + %d; }", 0);
+    ttak_bigscript_program_t *hot = ttak_bigscript_compile_cached(src, NULL, NULL, &err, now);
+    snprintf(src, sizeof(src), "fn main(seed, sn) { return seed + %d; }", 1);
+    ttak_bigscript_program_t *cold = ttak_bigscript_compile_cached(src, NULL, NULL, &err, now);
+    ASSERT(hot && cold);
+    for (int i = 2; i < 2 + 3 * TTAK_BIGSCRIPT_CACHE_MAX; i++) {
+        snprintf(src, sizeof(src), "fn main(seed, sn) { return seed + %d; }", 0);
+        ttak_bigscript_program_t *p = ttak_bigscript_compile_cached(src, NULL, NULL, &err, now + (uint64_t)i);
+        ASSERT(p == hot);
+        ttak_bigscript_program_free(p, now);
+        snprintf(src, sizeof(src), "fn main(seed, sn) { return seed + %d; }", i);
+        p = ttak_bigscript_compile_cached(src, NULL, NULL, &err, now + (uint64_t)i);
+        ASSERT(p);
+        ttak_bigscript_program_free(p, now);
+    }
+
+    // The cold script was evicted: asking again compiles a new program,
+    // while the caller's copy stays usable.
+    snprintf(src, sizeof(src), "fn main(seed, sn) { return seed + %d; }", 1);
+    ttak_bigscript_program_t *again = ttak_bigscript_compile_cached(src, NULL, NULL, &err, now + 1000);
+    ASSERT(again && again != cold);
+    ttak_bigscript_vm_t *vm = ttak_bigscript_vm_create(NULL, now);
+    bool ok;
+    ASSERT(eval_u64(cold, vm, 5, 0, &ok, &err, now) == 6 && ok);
+    ASSERT(eval_u64(again, vm, 5, 0, &ok, &err, now) == 6 && ok);
+    ttak_bigscript_vm_free(vm, now);
+    ttak_bigscript_program_free(again, now);
+    ttak_bigscript_program_free(cold, now);
+    ttak_bigscript_program_free(hot, now);
+    ttak_bigscript_cache_clear();
+}
+
+void test_jit(void) {
+    printf("[TEST] Native Tier\n");
+    // Overflowing products, zero divisors, deep recursion and s() all have
+    // to match the interpreter, whether the native code handles them or bails.
+    const char *srcs[] = {
+        "fn fact(n) { if (n <= 1) { return 1; } return n * fact(n - 1); }\n"
+        "fn main(seed, sn) { if (seed % 5 == 0) { return fact(seed % 40); } return fact(seed % 19) / (seed % 7) + sn - seed; }\n",
+        "fn f(n) { if (n == 0) { return 0; } return f(n - 1) + 1; }\n"
+        "fn main(seed, sn) { if (seed < 100000) { if (s(seed) == sn) { return f(seed % 24) * 100000000000 * 100000000000; } }\n"
+        "  return is_zero(seed % 3) + f(seed % 24); }\n",
+        "fn main(seed, sn) { let a = seed / 3; if (seed != sn) { if (seed >= 7) { return a % 13 - 3; } } return real(seed); }\n",
+    };
+    uint64_t now = ttak_get_tick_count();
+    ttak_bigscript_limits_t limits = {0};
+    limits.max_call_depth = 20;
+    for (size_t p = 0; p < sizeof(srcs) / sizeof(srcs[0]); p++) {
+        ttak_bigscript_error_t err = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+        ttak_bigscript_program_t *jit = ttak_bigscript_compile(srcs[p], NULL, &limits, &err, now);
+        ttak_bigscript_program_t *ref = ttak_bigscript_compile(srcs[p], NULL, &limits, &err, now);
+        ASSERT(jit && ref);
+#if defined(__x86_64__) && defined(__unix__)
+        ASSERT(ttak_bigscript_jit_compile(jit));
+#endif
+        ttak_bigscript_vm_t *vj = ttak_bigscript_vm_create(&limits, now), *vr = ttak_bigscript_vm_create(&limits, now);
+        for (uint64_t i = 0; i < 600; i++) {
+            // A few seeds sit past 64 bits, which the native code never sees.
+            ttak_bigint_t seed, sn;
+            ttak_bigint_init_u64(&seed, i + 1, now);
+            if (i % 50 == 49) ttak_bigint_mul_u64(&seed, &seed, 0xFFFFFFFFFFFFFFFFULL, now);
+            uint64_t sv = 0;
+            ttak_sum_proper_divisors_u64(i + 1, &sv);
+            ttak_bigint_init_u64(&sn, (i % 2) ? sv : i + 1, now);
+            ttak_bigscript_value_t oj, orf;
+            memset(&oj, 0, sizeof(oj)); memset(&orf, 0, sizeof(orf));
+            ttak_bigscript_error_t ej = {TTAK_BIGSCRIPT_ERR_NONE, NULL}, er = {TTAK_BIGSCRIPT_ERR_NONE, NULL};
+            bool okj = ttak_bigscript_eval_seed(jit, vj, &seed, &sn, &oj, &ej, now);
+            bool okr = ttak_bigscript_eval_seed(ref, vr, &seed, &sn, &orf, &er, now);
+            ASSERT(okj == okr && ej.code == er.code);
+            if (okj) {
+                ASSERT(oj.is_found == orf.is_found && oj.value.type == orf.value.type);
+                if (oj.value.type == TTAK_BIGSCRIPT_VAL_INT) ASSERT(ttak_bigint_cmp(&oj.value.v.i, &orf.value.v.i) == 0);
+                ttak_bigscript_value_free(&oj, now);
+                ttak_bigscript_value_free(&orf, now);
+            }
+            ttak_bigint_free(&seed, now);
+            ttak_bigint_free(&sn, now);
+        }
+        ttak_bigscript_vm_free(vj, now);
+        ttak_bigscript_vm_free(vr, now);
+        ttak_bigscript_program_free(jit, now);
+        ttak_bigscript_program_free(ref, now);
+    }
+}
+
 int main(void) {
     test_constant_return();
     test_basic_arithmetic();
     test_builtin_s();
     test_real_complex();
+    test_control_flow_and_mod();
+    test_constant_folding();
+    test_function_calls();
+    test_errors();
+    test_eval_batch();
+    test_compile_cache();
+    test_compile_cache_eviction();
+    test_jit();
     printf("All bigscript tests passed!\n");
     return 0;
 }
@@ -0,0 +1,126 @@
+#include <ttak/security/blake3.h>
+#include <ttak/security/security_engine.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_macros.h"
+
+static size_t hex(const char *s, uint8_t *out) {
+    size_t i = 0;
+    for (; s[2 * i]; i++) {
+        unsigned v;
+        sscanf(s + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+    return i;
+}
+
+/* Input bytes i % 251 and key bytes 1..32, as in the official test vectors. */
+static uint8_t *pattern(size_t len) {
+    uint8_t *p = malloc(len ? len : 1);
+    ASSERT(p != NULL);
+    for (size_t i = 0; i < len; i++) p[i] = (uint8_t)(i % 251);
+    return p;
+}
+
+static const uint8_t test_key[32] = {
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+    17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+};
+
+static void test_blake3_vectors(void) {
+    // Lengths around chunk and subtree edges, checked against the reference implementation.
+    static const struct {
+        size_t len;
+        int keyed;
+        const char *digest;
+    } cases[] = {
+        { 0, 0, "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262" },
+        { 1, 0, "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213" },
+        { 1023, 0, "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11" },
+        { 1024, 0, "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7" },
+        { 1025, 0, "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444" },
+        { 2049, 0, "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030" },
+        { 8192, 0, "aae792484c8efe4f19e2ca7d371d8c467ffb10748d8a5a1ae579948f718a2a63" },
+        { 31745, 0, "5c80ce0c3bbe9a6f432a1c6c2ccbde45923d23249386988a30f512d23919eb98" },
+        { 102400, 0, "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085" },
+        { 0, 1, "b54fe6f9a432e254a10d31999015209281ec73f50e83e9fbbf5092b6ef8493df" },
+        { 1023, 1, "61906d32abaff230621cc94c12a02fbd8c64d83cbefde75764be89921f0a6f61" },
+        { 8193, 1, "6145ad73322d6c2aafa41de609ee9f13676486ae4405c7f30c3ea4e8ddf94106" },
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        uint8_t *in = pattern(cases[c].len), want[32], got[32];
+        hex(cases[c].digest, want);
+        ttak_blake3_hash(cases[c].keyed ? test_key : NULL, in, cases[c].len, got, sizeof(got));
+        ASSERT_MSG(memcmp(got, want, 32) == 0, "digest of %zu bytes (keyed %d)", cases[c].len, cases[c].keyed);
+        free(in);
+    }
+}
+
+static void test_blake3_extended_output(void) {
+    uint8_t *in = pattern(65), want[97], got[97] = {0}, prefix[40] = {0};
+    hex("de1e5fa0be70df6d2be8fffd0e99ceaa8eb6e8c93a63f2d8d1c30ecb6b263dee0e16e0a4749d6811dd1d6d1265c29729"
+        "b1b75a9ac346cf93f0e1d7296dfcfd4313b3a227faaaaf7757cc95b4e87a49be3b8a270a12020233509b1c3632b3485eef",
+        want);
+    ttak_blake3_hash(NULL, in, 65, got, sizeof(got));
+    ASSERT(memcmp(got, want, sizeof(want)) == 0);
+    ttak_blake3_hash(NULL, in, 65, prefix, sizeof(prefix));
+    ASSERT(memcmp(prefix, want, sizeof(prefix)) == 0);
+    free(in);
+}
+
+static void test_blake3_pool_matches_single(void) {
+    enum { LEN = 1574913 };
+    uint8_t *in = pattern(LEN), want[32], single[32], pooled[32], keyed[32], keyed_pooled[32];
+    hex("00101bd71bb70f6c2a369338107f5b7ed3d98600bad605430def3cbc00e80091", want);
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, 0);
+    ASSERT(pool != NULL);
+
+    ttak_blake3_hash(NULL, in, LEN, single, sizeof(single));
+    ttak_blake3_hash_pool(pool, NULL, in, LEN, pooled, sizeof(pooled), 0);
+    ASSERT(memcmp(single, want, 32) == 0 && memcmp(pooled, want, 32) == 0);
+
+    ttak_blake3_hash(test_key, in, LEN, keyed, sizeof(keyed));
+    ttak_blake3_hash_pool(pool, test_key, in, LEN, keyed_pooled, sizeof(keyed_pooled), 0);
+    ASSERT(memcmp(keyed, keyed_pooled, 32) == 0 && memcmp(keyed, single, 32) != 0);
+
+    // Below the split threshold, and with no pool, the call stays on this thread.
+    ttak_blake3_hash_pool(pool, NULL, in, 8192, pooled, sizeof(pooled), 0);
+    ttak_blake3_hash(NULL, in, 8192, single, sizeof(single));
+    ASSERT(memcmp(single, pooled, 32) == 0);
+    ttak_blake3_hash_pool(NULL, NULL, in, LEN, pooled, sizeof(pooled), 0);
+    ASSERT(memcmp(pooled, want, 32) == 0);
+
+    ttak_thread_pool_destroy(pool);
+    free(in);
+}
+
+static void test_blake3_engine_op(void) {
+    uint8_t *in = pattern(1025), want[32], got[32], keyed[32];
+    hex("d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444", want);
+    ttak_crypto_ctx_t ctx = { .in = in, .in_len = 1025, .out = got, .out_len = sizeof(got) };
+    ASSERT(ttak_security_execute(&ctx, TTAK_SECURITY_HASH_FAST, 0) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(got, want, 32) == 0);
+
+    ctx.key = test_key;
+    ctx.key_len = 32;
+    ctx.out = keyed;
+    ASSERT(ttak_security_execute(&ctx, TTAK_SECURITY_HASH_FAST, 0) == TTAK_IO_SUCCESS);
+    ttak_blake3_hash(test_key, in, 1025, got, sizeof(got));
+    ASSERT(memcmp(got, keyed, 32) == 0);
+
+    ctx.key_len = 16;
+    ASSERT(ttak_security_execute(&ctx, TTAK_SECURITY_HASH_FAST, 0) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ctx.key_len = 0;
+    ctx.out = NULL;
+    ASSERT(ttak_security_execute(&ctx, TTAK_SECURITY_HASH_FAST, 0) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    free(in);
+}
+
+int main(void) {
+    RUN_TEST(test_blake3_vectors);
+    RUN_TEST(test_blake3_extended_output);
+    RUN_TEST(test_blake3_pool_matches_single);
+    RUN_TEST(test_blake3_engine_op);
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <ttak/container/bloom.h>
+#include <ttak/container/set.h>
+#include <stdint.h>
+#include <string.h>
+#include "test_macros.h"
+
+#define BLOOM_KEYS 20000
+
+static int key_cmp_u64(const void *a, const void *b) {
+    return *(const uint64_t *)a != *(const uint64_t *)b;
+}
+
+static void test_bloom_basic(void) {
+    ttak_bloom_t *f = ttak_bloom_create(BLOOM_KEYS, 0);
+    ASSERT(f != NULL);
+    for (uint64_t i = 0; i < BLOOM_KEYS; i++) ttak_bloom_add(f, &i, sizeof(i));
+    for (uint64_t i = 0; i < BLOOM_KEYS; i++) ASSERT(ttak_bloom_may_contain(f, &i, sizeof(i)));
+
+    /* About 1% at 10 bits per key; allow slack for the blocked layout. */
+    size_t fp = 0;
+    for (uint64_t i = BLOOM_KEYS; i < 3 * BLOOM_KEYS; i++) fp += ttak_bloom_may_contain(f, &i, sizeof(i));
+    ASSERT(fp < 2 * BLOOM_KEYS / 40);
+
+    ttak_bloom_clear(f);
+    ASSERT(f->count == 0);
+    uint64_t k = 7;
+    ASSERT(!ttak_bloom_may_contain(f, &k, sizeof(k)));
+    ttak_bloom_destroy(f);
+}
+
+static uint64_t set_keys[2 * BLOOM_KEYS];
+
+static void test_set_front_filter(void) {
+    ttak_set_t set;
+    uint64_t now = 1000;
+    ttak_set_init(&set, 16, NULL, key_cmp_u64, NULL);
+    for (int i = 0; i < 2 * BLOOM_KEYS; i++) set_keys[i] = (uint64_t)i * 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < 100; i++) ttak_set_add(&set, &set_keys[i], sizeof(uint64_t), now);
+    ASSERT(ttak_set_enable_filter(&set, 1000));
+    ASSERT(set.filter->count == 100);
+
+    /* Grows past its sizing by rebuilding. */
+    for (int i = 100; i < BLOOM_KEYS; i++) ttak_set_add(&set, &set_keys[i], sizeof(uint64_t), now);
+    ASSERT(set.table.size == BLOOM_KEYS);
+    ASSERT(set.filter->capacity >= BLOOM_KEYS);
+    for (int i = 0; i < BLOOM_KEYS; i++) ASSERT(ttak_set_contains(&set, &set_keys[i], sizeof(uint64_t), now));
+    for (int i = BLOOM_KEYS; i < 2 * BLOOM_KEYS; i++) {
+        ASSERT(!ttak_set_contains(&set, &set_keys[i], sizeof(uint64_t), now));
+    }
+
+    /* Removing most keys rebuilds the filter without losing the rest. */
+    for (int i = 0; i < BLOOM_KEYS; i += 4) {
+        ASSERT(ttak_set_remove(&set, &set_keys[i], sizeof(uint64_t), now));
+    }
+    for (int i = 1; i < BLOOM_KEYS; i += 4) {
+        ASSERT(ttak_set_remove(&set, &set_keys[i], sizeof(uint64_t), now));
+    }
+    for (int i = 2; i < BLOOM_KEYS; i += 4) {
+        ASSERT(ttak_set_remove(&set, &set_keys[i], sizeof(uint64_t), now));
+    }
+    ASSERT(set.filter->count < BLOOM_KEYS);
+    for (int i = 0; i < BLOOM_KEYS; i++) {
+        ASSERT(ttak_set_contains(&set, &set_keys[i], sizeof(uint64_t), now) == (i % 4 == 3));
+    }
+    ttak_set_destroy(&set, now);
+    ASSERT(set.filter == NULL);
+}
+
+int main(void) {
+    RUN_TEST(test_bloom_basic);
+    RUN_TEST(test_set_front_filter);
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include <ttak/tree/bplus.h>
+#include <ttak/tree/bplus_u64.h>
+#include <ttak/mem/arena_helper.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+#define BPLUS_KEYS 20000
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+typedef struct {
+    uint64_t last;
+    size_t seen;
+    int ordered;
+} range_ctx_t;
+
+static bool visit_generic(void *key, void *value, void *ctx) {
+    range_ctx_t *r = ctx;
+    uint64_t k = *(uint64_t *)key;
+    if (r->seen && k <= r->last) r->ordered = 0;
+    if ((uint64_t)(uintptr_t)value != k + 1) r->ordered = 0;
+    r->last = k;
+    r->seen++;
+    return true;
+}
+
+static uint64_t gen_keys[BPLUS_KEYS];
+
+static void test_bplus_range(void) {
+    ttak_bplus_tree_t tree;
+    uint64_t now = 1000;
+    ttak_bplus_init(&tree, 8, cmp_u64, NULL, NULL);
+    /* Insert the even numbers 0..2N in a scrambled order. */
+    for (int i = 0; i < BPLUS_KEYS; i++) gen_keys[i] = (uint64_t)((i * 7919) % BPLUS_KEYS) * 2;
+    for (int i = 0; i < BPLUS_KEYS; i++) {
+        ttak_bplus_insert(&tree, &gen_keys[i], (void *)(uintptr_t)(gen_keys[i] + 1), now);
+    }
+
+    range_ctx_t r = { 0, 0, 1 };
+    ASSERT(ttak_bplus_range(&tree, NULL, NULL, visit_generic, &r, now) == BPLUS_KEYS);
+    ASSERT(r.ordered && r.last == 2 * (BPLUS_KEYS - 1));
+
+    /* Odd bounds fall between keys: 101..199 holds 102..198. */
+    uint64_t lo = 101, hi = 199;
+    r = (range_ctx_t){ 0, 0, 1 };
+    ASSERT(ttak_bplus_range(&tree, &lo, &hi, visit_generic, &r, now) == 49);
+    ASSERT(r.ordered && r.last == 198);
+    ttak_bplus_destroy(&tree, now);
+}
+
+static bool visit_u64(uint64_t key, uint64_t value, void *ctx) {
+    range_ctx_t *r = ctx;
+    if (r->seen && key <= r->last) r->ordered = 0;
+    if (value != ~key) r->ordered = 0;
+    r->last = key;
+    r->seen++;
+    return r->seen < 1000;
+}
+
+static void test_bplus_u64(void) {
+    ttak_bplus_u64_t tree;
+    ttak_bplus_u64_init(&tree);
+    uint64_t v;
+    ASSERT(!ttak_bplus_u64_get(&tree, 1, &v));
+
+    /* Keys spread over the whole range, including both extremes. */
+    for (uint64_t i = 0; i < BPLUS_KEYS; i++) {
+        uint64_t k = i * 0x9e3779b97f4a7c15ULL;
+        ASSERT(ttak_bplus_u64_insert(&tree, k, ~k));
+    }
+    ASSERT(ttak_bplus_u64_insert(&tree, UINT64_MAX, 0));
+    ASSERT(tree.size == BPLUS_KEYS + 1);
+    ASSERT(tree.height > 2);
+    for (uint64_t i = 0; i < BPLUS_KEYS; i++) {
+        uint64_t k = i * 0x9e3779b97f4a7c15ULL;
+        ASSERT(ttak_bplus_u64_get(&tree, k, &v) && v == ~k);
+        ASSERT(!ttak_bplus_u64_get(&tree, k + 1, NULL));
+    }
+    ASSERT(ttak_bplus_u64_get(&tree, UINT64_MAX, &v) && v == 0);
+
+    /* Replacing keeps the size. */
+    ASSERT(ttak_bplus_u64_insert(&tree, 0, 5));
+    ASSERT(tree.size == BPLUS_KEYS + 1);
+    ASSERT(ttak_bplus_u64_get(&tree, 0, &v) && v == 5);
+    ASSERT(ttak_bplus_u64_insert(&tree, 0, ~0ULL));
+
+    range_ctx_t r = { 0, 0, 1 };
+    ASSERT(ttak_bplus_u64_range(&tree, 1, UINT64_MAX - 1, visit_u64, &r) == 1000);
+    ASSERT(r.ordered);
+    ttak_bplus_u64_destroy(&tree);
+    ASSERT(tree.root == NULL && tree.size == 0);
+
+    /* Sequential keys and a dense range. */
+    for (uint64_t k = 0; k < BPLUS_KEYS; k++) ASSERT(ttak_bplus_u64_insert(&tree, k, ~k));
+    r = (range_ctx_t){ 0, 0, 1 };
+    ASSERT(ttak_bplus_u64_range(&tree, 500, 1200, visit_u64, &r) == 701);
+    ASSERT(r.ordered && r.last == 1200);
+    ttak_bplus_u64_destroy(&tree);
+}
+
+static size_t keys_freed;
+
+static void count_free(void *key) {
+    (void)key;
+    keys_freed++;
+}
+
+/* Checks ordering, fill, and equal leaf depth below @p node; returns the leaf depth. */
+static int check_bplus(const ttak_bplus_tree_t *tree, const ttak_bplus_node_t *node, const uint64_t *lo,
+                       const uint64_t *hi, int is_root) {
+    if (!is_root) ASSERT(node->n >= (tree->order - 1) / 2);
+    for (int i = 0; i < node->n; i++) {
+        uint64_t k = *(const uint64_t *)node->keys[i];
+        if (lo) ASSERT(k >= *lo);
+        if (hi) ASSERT(k < *hi);
+        if (i > 0) ASSERT(k > *(const uint64_t *)node->keys[i - 1]);
+    }
+    if (node->is_leaf) return 0;
+    int depth = -1;
+    for (int i = 0; i <= node->n; i++) {
+        const uint64_t *clo = i > 0 ? node->keys[i - 1] : lo;
+        const uint64_t *chi = i < node->n ? node->keys[i] : hi;
+        int d = check_bplus(tree, node->children[i], clo, chi, 0);
+        if (depth < 0) depth = d;
+        ASSERT(d == depth);
+    }
+    return depth + 1;
+}
+
+static uint64_t del_keys[BPLUS_KEYS];
+
+static void test_bplus_bulk_load_and_remove(void) {
+    ttak_bplus_tree_t tree;
+    uint64_t now = 1000;
+    static void *kp[BPLUS_KEYS], *vp[BPLUS_KEYS];
+    for (int i = 0; i < BPLUS_KEYS; i++) {
+        del_keys[i] = (uint64_t)i * 3;
+        kp[i] = &del_keys[i];
+        vp[i] = (void *)(uintptr_t)(del_keys[i] + 1);
+    }
+
+    ttak_bplus_init(&tree, 16, cmp_u64, count_free, NULL);
+    void *unsorted[2] = { kp[1], kp[0] };
+    ASSERT(!ttak_bplus_bulk_load(&tree, unsorted, vp, 2, 1.0, now));
+    ASSERT(tree.root == NULL);
+
+    ASSERT(ttak_bplus_bulk_load(&tree, kp, vp, BPLUS_KEYS, 0.7, now));
+    check_bplus(&tree, tree.root, NULL, NULL, 1);
+    ASSERT(!ttak_bplus_bulk_load(&tree, kp, vp, 1, 1.0, now));
+    range_ctx_t r = { 0, 0, 1 };
+    ASSERT(ttak_bplus_range(&tree, NULL, NULL, visit_generic, &r, now) == BPLUS_KEYS);
+    ASSERT(r.ordered);
+    for (int i = 0; i < BPLUS_KEYS; i++) ASSERT(ttak_bplus_get(&tree, kp[i], now) == vp[i]);
+    /* Spare room from the 0.7 fill takes inserts between the loaded keys. */
+    static uint64_t extra[BPLUS_KEYS];
+    for (int i = 0; i < BPLUS_KEYS; i += 7) {
+        extra[i] = (uint64_t)i * 3 + 1;
+        ttak_bplus_insert(&tree, &extra[i], (void *)(uintptr_t)(extra[i] + 1), now);
+    }
+    check_bplus(&tree, tree.root, NULL, NULL, 1);
+
+    /* Remove in a scrambled order, checking the structure as it shrinks. */
+    keys_freed = 0;
+    size_t removed = 0;
+    for (int i = 0; i < BPLUS_KEYS; i++) {
+        int j = (int)(((uint64_t)i * 7919) % BPLUS_KEYS);
+        ASSERT(ttak_bplus_remove(&tree, kp[j], now));
+        ASSERT(!ttak_bplus_remove(&tree, kp[j], now));
+        removed++;
+        if (i % 997 == 0 && tree.root) check_bplus(&tree, tree.root, NULL, NULL, 1);
+        if (i % 4999 == 0) {
+            int k = (int)(((uint64_t)(i + 1) * 7919) % BPLUS_KEYS);
+            ASSERT(ttak_bplus_get(&tree, kp[k], now) == vp[k]);
+        }
+    }
+    ASSERT(keys_freed == removed);
+    for (int i = 0; i < BPLUS_KEYS; i += 7) {
+        ASSERT(ttak_bplus_get(&tree, &extra[i], now) == (void *)(uintptr_t)(extra[i] + 1));
+        ASSERT(ttak_bplus_remove(&tree, &extra[i], now));
+    }
+    ASSERT(tree.root == NULL);
+    ttak_bplus_destroy(&tree, now);
+}
+
+static void test_bplus_arena(void) {
+    uint64_t now = 1000;
+    ttak_arena_env_t env;
+    ttak_arena_env_config_t cfg;
+    ttak_arena_env_config_init(&cfg);
+    cfg.generation_bytes = 1 << 16;
+    cfg.lane_refill_bytes = 1 << 16;
+    ASSERT(ttak_arena_env_init(&env, &cfg));
+    ttak_arena_generation_t gen;
+    ASSERT(ttak_arena_generation_begin_lanes(&env, &gen, 1, 1));
+
+    static uint64_t akeys[BPLUS_KEYS];
+    ttak_bplus_tree_t tree;
+    ttak_bplus_init(&tree, 8, cmp_u64, NULL, NULL);
+    ASSERT(ttak_bplus_use_arena(&tree, &env, &gen, 0));
+    for (int i = 0; i < BPLUS_KEYS; i++) {
+        int j = (int)(((uint64_t)i * 7919) % BPLUS_KEYS);
+        akeys[j] = (uint64_t)j;
+        ttak_bplus_insert(&tree, &akeys[j], (void *)(uintptr_t)(akeys[j] + 1), now);
+    }
+    check_bplus(&tree, tree.root, NULL, NULL, 1);
+    for (int i = 0; i < BPLUS_KEYS; i += 2) ASSERT(ttak_bplus_remove(&tree, &akeys[i], now));
+    check_bplus(&tree, tree.root, NULL, NULL, 1);
+    range_ctx_t r = { 0, 0, 1 };
+    ASSERT(ttak_bplus_range(&tree, NULL, NULL, visit_generic, &r, now) == BPLUS_KEYS / 2);
+    ASSERT(r.ordered);
+    for (int i = 1; i < BPLUS_KEYS; i += 2) {
+        ASSERT(ttak_bplus_get(&tree, &akeys[i], now) == (void *)(uintptr_t)(akeys[i] + 1));
+    }
+    ttak_bplus_destroy(&tree, now);
+    ASSERT(tree.root == NULL);
+
+    ASSERT(ttak_arena_generation_retire(&env, &gen));
+    ttak_arena_env_destroy(&env);
+}
+
+int main(void) {
+    RUN_TEST(test_bplus_range);
+    RUN_TEST(test_bplus_bulk_load_and_remove);
+    RUN_TEST(test_bplus_u64);
+    RUN_TEST(test_bplus_arena);
+    return 0;
+}
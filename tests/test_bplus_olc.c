@@ -0,0 +1,142 @@
+#include <ttak/tree/bplus_olc.h>
+#include <ttak/mem/epoch.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "test_macros.h"
+
+#define KEYS_PER_WRITER 4096
+#define WRITERS 2
+
+static uint64_t value_of(uint64_t key) { return key * 3 + 1; }
+
+typedef struct {
+    uint64_t last;
+    size_t count;
+    bool ordered;
+} range_ctx_t;
+
+static bool range_check(uint64_t key, uint64_t value, void *p) {
+    range_ctx_t *c = p;
+    if (c->count && key <= c->last) c->ordered = false;
+    if (value != value_of(key)) c->ordered = false;
+    c->last = key;
+    c->count++;
+    return true;
+}
+
+static bool range_stop(uint64_t key, uint64_t value, void *p) {
+    (void)key;
+    (void)value;
+    return ++*(size_t *)p < 5;
+}
+
+static void test_bplus_olc_basic(void) {
+    ttak_bplus_olc_t tree;
+    ASSERT(ttak_bplus_olc_init(&tree));
+
+    uint64_t v = 0;
+    ASSERT(!ttak_bplus_olc_get(&tree, 42, &v));
+    ASSERT(ttak_bplus_olc_insert(&tree, 42, 7));
+    ASSERT(ttak_bplus_olc_get(&tree, 42, &v) && v == 7);
+    ASSERT(ttak_bplus_olc_insert(&tree, 42, 8));
+    ASSERT(ttak_bplus_olc_get(&tree, 42, &v) && v == 8);
+    ASSERT(ttak_bplus_olc_size(&tree) == 1);
+    ASSERT(ttak_bplus_olc_remove(&tree, 42));
+    ASSERT(!ttak_bplus_olc_remove(&tree, 42));
+    ASSERT(ttak_bplus_olc_size(&tree) == 0);
+
+    // Reverse order exercises splits at the left edge of every node.
+    for (uint64_t k = 20000; k-- > 0;) ASSERT(ttak_bplus_olc_insert(&tree, k * 2, value_of(k * 2)));
+    ASSERT(ttak_bplus_olc_size(&tree) == 20000);
+    for (uint64_t k = 0; k < 40000; k++) ASSERT(ttak_bplus_olc_get(&tree, k, &v) == ((k & 1) == 0));
+
+    range_ctx_t c = {0, 0, true};
+    ASSERT(ttak_bplus_olc_range(&tree, 101, 2001, range_check, &c) == 950);
+    ASSERT(c.ordered && c.count == 950 && c.last == 2000);
+    size_t seen = 0;
+    ASSERT(ttak_bplus_olc_range(&tree, 0, UINT64_MAX, range_stop, &seen) == 5);
+
+    // Emptying whole runs of leaves unlinks them; the rest stays reachable.
+    for (uint64_t k = 0; k < 30000; k += 2) ASSERT(ttak_bplus_olc_remove(&tree, k));
+    ASSERT(ttak_bplus_olc_size(&tree) == 5000);
+    c = (range_ctx_t){0, 0, true};
+    ASSERT(ttak_bplus_olc_range(&tree, 0, UINT64_MAX, range_check, &c) == 5000);
+    ASSERT(c.ordered);
+    for (uint64_t k = 0; k < 30000; k += 2) ASSERT(ttak_bplus_olc_insert(&tree, k, value_of(k)));
+    for (uint64_t k = 0; k < 40000; k += 2) ASSERT(ttak_bplus_olc_get(&tree, k, &v) && v == value_of(k));
+
+    ttak_bplus_olc_destroy(&tree);
+    ttak_epoch_reclaim();
+}
+
+static ttak_bplus_olc_t g_tree;
+static _Atomic int g_stop;
+static _Atomic int g_bad;
+
+/* Writers interleave their keys so they contend for the same leaves. */
+static void *writer_main(void *p) {
+    uint64_t id = (uint64_t)(uintptr_t)p;
+    for (int round = 0; round < 8; round++) {
+        for (uint64_t k = 0; k < KEYS_PER_WRITER; k++) {
+            uint64_t key = k * WRITERS + id;
+            ttak_bplus_olc_insert(&g_tree, key, value_of(key));
+        }
+        for (uint64_t k = 0; k < KEYS_PER_WRITER; k += 1 + (round & 1)) {
+            ttak_bplus_olc_remove(&g_tree, k * WRITERS + id);
+        }
+        sched_yield();
+    }
+    for (uint64_t k = 0; k < KEYS_PER_WRITER; k++) {
+        uint64_t key = k * WRITERS + id;
+        ttak_bplus_olc_insert(&g_tree, key, value_of(key));
+    }
+    return NULL;
+}
+
+static void *reader_main(void *p) {
+    (void)p;
+    uint64_t k = 0;
+    while (!atomic_load(&g_stop)) {
+        for (int i = 0; i < 256; i++, k = (k + 7) % (WRITERS * KEYS_PER_WRITER)) {
+            uint64_t v;
+            if (ttak_bplus_olc_get(&g_tree, k, &v) && v != value_of(k)) atomic_fetch_add(&g_bad, 1);
+        }
+        range_ctx_t c = {0, 0, true};
+        ttak_bplus_olc_range(&g_tree, k, k + 200, range_check, &c);
+        if (!c.ordered) atomic_fetch_add(&g_bad, 1);
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void test_bplus_olc_concurrent(void) {
+    ASSERT(ttak_bplus_olc_init(&g_tree));
+    atomic_store(&g_stop, 0);
+    atomic_store(&g_bad, 0);
+
+    pthread_t readers[2], writers[WRITERS];
+    for (int i = 0; i < 2; i++) pthread_create(&readers[i], NULL, reader_main, NULL);
+    for (uintptr_t i = 0; i < WRITERS; i++) pthread_create(&writers[i], NULL, writer_main, (void *)i);
+    for (int i = 0; i < WRITERS; i++) pthread_join(writers[i], NULL);
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < 2; i++) pthread_join(readers[i], NULL);
+
+    ASSERT(atomic_load(&g_bad) == 0);
+    ASSERT(ttak_bplus_olc_size(&g_tree) == WRITERS * KEYS_PER_WRITER);
+    for (uint64_t k = 0; k < WRITERS * KEYS_PER_WRITER; k++) {
+        uint64_t v = 0;
+        ASSERT(ttak_bplus_olc_get(&g_tree, k, &v) && v == value_of(k));
+    }
+    range_ctx_t c = {0, 0, true};
+    ASSERT(ttak_bplus_olc_range(&g_tree, 0, UINT64_MAX, range_check, &c) == WRITERS * KEYS_PER_WRITER);
+    ASSERT(c.ordered);
+    ttak_bplus_olc_destroy(&g_tree);
+    ttak_epoch_reclaim();
+}
+
+int main(void) {
+    RUN_TEST(test_bplus_olc_basic);
+    RUN_TEST(test_bplus_olc_concurrent);
+    return 0;
+}
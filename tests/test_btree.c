@@ -0,0 +1,161 @@
+#include <ttak/tree/btree.h>
+#include <ttak/mem/arena_helper.h>
+#include <stdint.h>
+#include "test_macros.h"
+
+#define BTREE_KEYS 20000
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static size_t keys_freed;
+
+static void count_free(void *key) {
+    (void)key;
+    keys_freed++;
+}
+
+/* Checks key order, fill, and equal leaf depth; returns the subtree's key count via @p count. */
+static int check_btree(const ttak_btree_t *tree, const ttak_btree_node_t *node, const uint64_t *lo,
+                       const uint64_t *hi, int is_root, size_t *count) {
+    if (!is_root) ASSERT(node->n >= tree->t - 1);
+    ASSERT(node->n <= 2 * tree->t - 1);
+    for (int i = 0; i < node->n; i++) {
+        uint64_t k = *(const uint64_t *)node->keys[i];
+        if (lo) ASSERT(k > *lo);
+        if (hi) ASSERT(k < *hi);
+        if (i > 0) ASSERT(k > *(const uint64_t *)node->keys[i - 1]);
+    }
+    *count += (size_t)node->n;
+    if (node->leaf) return 0;
+    int depth = -1;
+    for (int i = 0; i <= node->n; i++) {
+        int d = check_btree(tree, node->children[i], i > 0 ? node->keys[i - 1] : lo,
+                            i < node->n ? node->keys[i] : hi, 0, count);
+        if (depth < 0) depth = d;
+        ASSERT(d == depth);
+    }
+    return depth + 1;
+}
+
+static uint64_t keys[BTREE_KEYS];
+static void *kp[BTREE_KEYS], *vp[BTREE_KEYS];
+
+static void test_btree_bulk_load(void) {
+    uint64_t now = 1000;
+    for (int i = 0; i < BTREE_KEYS; i++) {
+        keys[i] = (uint64_t)i * 2;
+        kp[i] = &keys[i];
+        vp[i] = (void *)(uintptr_t)(keys[i] + 1);
+    }
+    /* Sizes around node boundaries, and both fill extremes. */
+    size_t sizes[] = { 1, 2, 5, 6, 7, 8, 50, 1000, BTREE_KEYS };
+    double fills[] = { 0.01, 0.5, 1.0 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t f = 0; f < 3; f++) {
+            ttak_btree_t tree;
+            ttak_btree_init(&tree, 4, cmp_u64, NULL, NULL);
+            ASSERT(ttak_btree_bulk_load(&tree, kp, vp, sizes[s], fills[f], now));
+            size_t count = 0;
+            check_btree(&tree, tree.root, NULL, NULL, 1, &count);
+            ASSERT(count == sizes[s]);
+            for (size_t i = 0; i < sizes[s]; i++) ASSERT(ttak_btree_search(&tree, kp[i], now) == vp[i]);
+            uint64_t odd = 3;
+            ASSERT(ttak_btree_search(&tree, &odd, now) == NULL);
+            ASSERT(!ttak_btree_bulk_load(&tree, kp, vp, 1, 1.0, now));
+            ttak_btree_destroy(&tree, now);
+        }
+    }
+    ttak_btree_t tree;
+    ttak_btree_init(&tree, 4, cmp_u64, NULL, NULL);
+    void *unsorted[2] = { kp[1], kp[0] };
+    ASSERT(!ttak_btree_bulk_load(&tree, unsorted, vp, 2, 1.0, now));
+    ASSERT(tree.root == NULL);
+}
+
+static void test_btree_remove(void) {
+    uint64_t now = 1000;
+    ttak_btree_t tree;
+    ttak_btree_init(&tree, 3, cmp_u64, count_free, NULL);
+    for (int i = 0; i < BTREE_KEYS; i++) {
+        int j = (int)(((uint64_t)i * 7919) % BTREE_KEYS);
+        ttak_btree_insert(&tree, kp[j], vp[j], now);
+    }
+
+    keys_freed = 0;
+    for (int i = 0; i < BTREE_KEYS; i++) {
+        int j = (int)(((uint64_t)i * 104729) % BTREE_KEYS);
+        ASSERT(ttak_btree_remove(&tree, kp[j], now));
+        ASSERT(!ttak_btree_remove(&tree, kp[j], now));
+        if (i % 997 == 0 && tree.root) {
+            size_t count = 0;
+            check_btree(&tree, tree.root, NULL, NULL, 1, &count);
+            ASSERT(count == (size_t)(BTREE_KEYS - i - 1));
+            int k = (int)(((uint64_t)(i + 1) * 104729) % BTREE_KEYS);
+            ASSERT(ttak_btree_search(&tree, kp[k], now) == vp[k]);
+        }
+    }
+    ASSERT(keys_freed == BTREE_KEYS);
+    ASSERT(tree.root == NULL);
+
+    /* Removing from a bulk-loaded tree. */
+    ASSERT(ttak_btree_bulk_load(&tree, kp, vp, BTREE_KEYS, 1.0, now));
+    for (int i = 0; i < BTREE_KEYS; i += 2) ASSERT(ttak_btree_remove(&tree, kp[i], now));
+    size_t count = 0;
+    check_btree(&tree, tree.root, NULL, NULL, 1, &count);
+    ASSERT(count == BTREE_KEYS / 2);
+    for (int i = 0; i < BTREE_KEYS; i++) {
+        ASSERT(ttak_btree_search(&tree, kp[i], now) == (i % 2 ? vp[i] : NULL));
+    }
+    ttak_btree_destroy(&tree, now);
+}
+
+static void test_btree_arena(void) {
+    uint64_t now = 1000;
+    ttak_arena_env_t env;
+    ttak_arena_env_config_t cfg;
+    ttak_arena_env_config_init(&cfg);
+    cfg.generation_bytes = 1 << 16;
+    cfg.lane_refill_bytes = 1 << 16;
+    ASSERT(ttak_arena_env_init(&env, &cfg));
+    ttak_arena_generation_t gen;
+    ASSERT(ttak_arena_generation_begin_lanes(&env, &gen, 1, 1));
+
+    ttak_btree_t tree;
+    ttak_btree_init(&tree, 4, cmp_u64, NULL, NULL);
+    ASSERT(ttak_btree_use_arena(&tree, &env, &gen, 0));
+    for (int i = 0; i < BTREE_KEYS; i++) {
+        int j = (int)(((uint64_t)i * 7919) % BTREE_KEYS);
+        ttak_btree_insert(&tree, kp[j], vp[j], now);
+    }
+    ASSERT(!ttak_btree_use_arena(&tree, &env, &gen, 0));
+    for (int i = 0; i < BTREE_KEYS; i += 3) ASSERT(ttak_btree_remove(&tree, kp[i], now));
+    size_t count = 0;
+    check_btree(&tree, tree.root, NULL, NULL, 1, &count);
+    ASSERT(count == BTREE_KEYS - (BTREE_KEYS + 2) / 3);
+    for (int i = 0; i < BTREE_KEYS; i++) {
+        ASSERT(ttak_btree_search(&tree, kp[i], now) == (i % 3 ? vp[i] : NULL));
+    }
+    ttak_btree_destroy(&tree, now);
+    ASSERT(tree.root == NULL);
+
+    /* Destructors still run for arena trees that set them. */
+    ttak_btree_init(&tree, 4, cmp_u64, count_free, NULL);
+    ASSERT(ttak_btree_use_arena(&tree, &env, &gen, 0));
+    ASSERT(ttak_btree_bulk_load(&tree, kp, vp, BTREE_KEYS, 1.0, now));
+    keys_freed = 0;
+    ttak_btree_destroy(&tree, now);
+    ASSERT(keys_freed == BTREE_KEYS);
+
+    ASSERT(ttak_arena_generation_retire(&env, &gen));
+    ttak_arena_env_destroy(&env);
+}
+
+int main(void) {
+    RUN_TEST(test_btree_bulk_load);
+    RUN_TEST(test_btree_remove);
+    RUN_TEST(test_btree_arena);
+    return 0;
+}
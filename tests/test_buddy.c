@@ -0,0 +1,147 @@
+#include <ttak/phys/mem/buddy.h>
+#include <ttak/mem/epoch.h>
+#include "test_macros.h"
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#define POOL_SIZE (1u << 20)
+#define SMALL_BLOCKS 512
+
+static alignas(64) unsigned char pool[POOL_SIZE];
+
+static void *buddy_alloc_bytes(size_t bytes) {
+    ttak_mem_req_t req = { .size_bytes = bytes, .priority = TTAK_PRIORITY_BEST_FIT,
+                           .owner_tag = 0, .call_safety = 0, .flags = 0 };
+    return ttak_mem_buddy_alloc(&req);
+}
+
+static void test_buddy_small_churn(void) {
+    ttak_mem_buddy_init(pool, sizeof(pool), 1);
+    void *ptrs[SMALL_BLOCKS];
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < SMALL_BLOCKS; ++i) {
+            ptrs[i] = buddy_alloc_bytes(40 + (size_t)(i % 3) * 100);
+            ASSERT(ptrs[i] != NULL);
+            memset(ptrs[i], i & 0xFF, 40);
+        }
+        for (int i = 0; i < SMALL_BLOCKS; ++i) {
+            ASSERT(((unsigned char *)ptrs[i])[39] == (unsigned char)(i & 0xFF));
+            ttak_mem_buddy_free(ptrs[i]);
+        }
+        ttak_epoch_reclaim();
+        ttak_epoch_reclaim();
+    }
+}
+
+static void test_buddy_large_after_small(void) {
+    ttak_mem_buddy_init(pool, sizeof(pool), 1);
+    void *ptrs[SMALL_BLOCKS];
+    for (int i = 0; i < SMALL_BLOCKS; ++i) {
+        ptrs[i] = buddy_alloc_bytes(64);
+        ASSERT(ptrs[i] != NULL);
+    }
+    for (int i = 0; i < SMALL_BLOCKS; ++i) ttak_mem_buddy_free(ptrs[i]);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+
+    /* Blocks parked in magazines must not prevent the pool from coalescing. */
+    void *big = buddy_alloc_bytes(POOL_SIZE / 2);
+    ASSERT(big != NULL);
+    ttak_mem_buddy_free(big);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+}
+
+static void *buddy_thread_worker(void *arg) {
+    (void)arg;
+    /* Retired blocks only return on a successful reclaim, so keep the in-flight total under the pool size. */
+    for (int i = 0; i < 400; ++i) {
+        void *p = buddy_alloc_bytes(32 + (size_t)(i % 5) * 64);
+        ASSERT(p != NULL);
+        memset(p, 0xA5, 32);
+        ttak_mem_buddy_free(p);
+        if ((i & 15) == 0) ttak_epoch_reclaim();
+    }
+    return NULL;
+}
+
+static void test_buddy_threads(void) {
+    ttak_mem_buddy_init(pool, sizeof(pool), 1);
+    /* Keeps the pool from collapsing into a single block that every thread races to split. */
+    void *keeper = buddy_alloc_bytes(32);
+    ASSERT(keeper != NULL);
+    pthread_t threads[4];
+    for (int i = 0; i < 4; ++i) ASSERT(pthread_create(&threads[i], NULL, buddy_thread_worker, NULL) == 0);
+    for (int i = 0; i < 4; ++i) pthread_join(threads[i], NULL);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    void *big = buddy_alloc_bytes(POOL_SIZE / 4);
+    ASSERT(big != NULL);
+    ttak_mem_buddy_free(big);
+    ttak_mem_buddy_free(keeper);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+}
+
+static size_t buddy_pool_bytes(void) {
+    ttak_mem_buddy_stats_t stats;
+    ttak_mem_buddy_stats(&stats);
+    return stats.pool_bytes;
+}
+
+static void test_buddy_release_free_segments(void) {
+    ttak_mem_buddy_init(NULL, 0, 0);
+    void *big = buddy_alloc_bytes(256 * 1024);
+    ASSERT(big != NULL);
+    ASSERT(buddy_pool_bytes() > 0);
+    /* A segment holding a live block stays mapped. */
+    ASSERT(ttak_mem_buddy_release_free_segments(0) == 0);
+
+    ttak_mem_buddy_free(big);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    ttak_mem_buddy_coalesce_step(UINT64_MAX);
+    ASSERT(ttak_mem_buddy_release_free_segments(SIZE_MAX) == 0);
+    ASSERT(ttak_mem_buddy_release_free_segments(0) > 0);
+    ASSERT(buddy_pool_bytes() == 0);
+
+    /* The zone regrows into the vacated segment slot. */
+    big = buddy_alloc_bytes(256 * 1024);
+    ASSERT(big != NULL);
+    ttak_mem_buddy_free(big);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+}
+
+static void test_buddy_background_compactor(void) {
+    ttak_mem_buddy_init(NULL, 0, 0);
+    ttak_mem_buddy_compactor_config_t cfg = { .interval_ns = 1000000ULL, .budget_ns = 0, .keep_bytes = 0 };
+    ASSERT(ttak_mem_buddy_start_compactor(&cfg) == 0);
+    ASSERT(ttak_mem_buddy_start_compactor(&cfg) == EALREADY);
+
+    void *big = buddy_alloc_bytes(512 * 1024);
+    ASSERT(big != NULL);
+    ttak_mem_buddy_free(big);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    for (int i = 0; i < 2000 && buddy_pool_bytes() != 0; ++i) {
+        struct timespec ts = { 0, 1000000L };
+        nanosleep(&ts, NULL);
+    }
+    ASSERT(buddy_pool_bytes() == 0);
+    ttak_mem_buddy_stop_compactor();
+    ttak_mem_buddy_stop_compactor();
+}
+
+int main(void) {
+    RUN_TEST(test_buddy_small_churn);
+    RUN_TEST(test_buddy_large_after_small);
+    RUN_TEST(test_buddy_threads);
+    RUN_TEST(test_buddy_release_free_segments);
+    RUN_TEST(test_buddy_background_compactor);
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <ttak/container/bytering.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+#include "test_macros.h"
+
+#define BR_RECORDS 100000
+
+static void test_bytering_reserve_commit(void) {
+    ttak_bytering_t *ring = ttak_bytering_create(100);
+    ASSERT(ring != NULL);
+    ASSERT(ring->capacity == 128);
+    ASSERT(ttak_bytering_max_record(ring) == 56);
+    ASSERT(ttak_bytering_reserve(ring, 57) == NULL);
+    ASSERT(ttak_bytering_is_empty(ring));
+
+    // Reserve the worst case, commit what was actually written.
+    char *dst = ttak_bytering_reserve(ring, 40);
+    ASSERT(dst != NULL && ((uintptr_t)dst & 7) == 0);
+    memcpy(dst, "hello", 5);
+    ttak_bytering_commit(ring, 5);
+    ASSERT(ttak_bytering_used(ring) == 16);
+    ASSERT(ttak_bytering_push(ring, "", 0));
+
+    size_t len = 0;
+    const char *rec = ttak_bytering_peek(ring, &len);
+    ASSERT(rec == dst && len == 5 && memcmp(rec, "hello", 5) == 0);
+    ASSERT(ttak_bytering_peek(ring, &len) == rec);
+    ttak_bytering_release(ring);
+    ASSERT(ttak_bytering_peek(ring, &len) != NULL && len == 0);
+    ttak_bytering_release(ring);
+    ASSERT(ttak_bytering_peek(ring, &len) == NULL);
+    ttak_bytering_destroy(ring);
+}
+
+static void test_bytering_wraps_contiguously(void) {
+    ttak_bytering_t *ring = ttak_bytering_create(128);
+    char buf[48];
+    size_t len = 0;
+
+    // Offsets 0..95 used; a third 48-byte span cannot fit in the last 32
+    // bytes, so it needs 32 bytes of padding plus 48 at the start.
+    ASSERT(ttak_bytering_push(ring, memset(buf, 'a', 40), 40));
+    ASSERT(ttak_bytering_push(ring, memset(buf, 'b', 40), 40));
+    ASSERT(!ttak_bytering_push(ring, memset(buf, 'c', 40), 40));
+    ASSERT(ttak_bytering_peek(ring, &len) != NULL && len == 40);
+    ttak_bytering_release(ring);
+    ASSERT(ttak_bytering_push(ring, buf, 40));
+
+    const char *rec = ttak_bytering_peek(ring, &len);
+    ASSERT(rec && len == 40 && rec[0] == 'b');
+    ttak_bytering_release(ring);
+    rec = ttak_bytering_peek(ring, &len);
+    ASSERT(rec == (const char *)ring->buffer + TTAK_BYTERING_HDR);
+    ASSERT(len == 40 && rec[0] == 'c' && rec[39] == 'c');
+    ttak_bytering_release(ring);
+    ASSERT(ttak_bytering_is_empty(ring));
+    ttak_bytering_destroy(ring);
+}
+
+static size_t record_len(uint32_t i) {
+    return (i * 2654435761u >> 7) % 200;
+}
+
+static void *bytering_producer(void *arg) {
+    ttak_bytering_t *ring = arg;
+    for (uint32_t i = 0; i < BR_RECORDS; i++) {
+        size_t len = record_len(i);
+        uint8_t *dst;
+        while (!(dst = ttak_bytering_reserve(ring, len + sizeof(i)))) sched_yield();
+        memcpy(dst, &i, sizeof(i));
+        memset(dst + sizeof(i), (int)(i & 0xff), len);
+        ttak_bytering_commit(ring, len + sizeof(i));
+    }
+    return NULL;
+}
+
+static void test_bytering_spsc_threads(void) {
+    ttak_bytering_t *ring = ttak_bytering_create(4096);
+    pthread_t producer;
+    ASSERT(pthread_create(&producer, NULL, bytering_producer, ring) == 0);
+
+    int ok = 1;
+    for (uint32_t i = 0; i < BR_RECORDS;) {
+        size_t len;
+        const uint8_t *rec = ttak_bytering_peek(ring, &len);
+        if (!rec) {
+            sched_yield();
+            continue;
+        }
+        uint32_t seq;
+        memcpy(&seq, rec, sizeof(seq));
+        if (seq != i || len != record_len(i) + sizeof(seq)) ok = 0;
+        for (size_t k = sizeof(seq); k < len; k++) {
+            if (rec[k] != (uint8_t)(i & 0xff)) ok = 0;
+        }
+        ttak_bytering_release(ring);
+        i++;
+    }
+    pthread_join(producer, NULL);
+    ASSERT(ok);
+    ASSERT(ttak_bytering_is_empty(ring));
+    ttak_bytering_destroy(ring);
+}
+
+int main(void) {
+    RUN_TEST(test_bytering_reserve_commit);
+    RUN_TEST(test_bytering_wraps_contiguously);
+    RUN_TEST(test_bytering_spsc_threads);
+    return 0;
+}
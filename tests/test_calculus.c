@@ -0,0 +1,132 @@
+#include <ttak/math/calculus.h>
+#include <ttak/thread/pool.h>
+#include <ttak/timing/timing.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include "test_macros.h"
+
+static _Bool f_sin(double *y, const double *x, size_t n, void *ctx) {
+    (void)ctx;
+    for (size_t i = 0; i < n; ++i) y[i] = sin(x[i]);
+    return 1;
+}
+
+static _Bool f_sqrt(double *y, const double *x, size_t n, void *ctx) {
+    (void)ctx;
+    for (size_t i = 0; i < n; ++i) y[i] = sqrt(x[i]);
+    return 1;
+}
+
+/* Narrow peak at 0.3 that the first rule barely sees. */
+static _Bool f_peak(double *y, const double *x, size_t n, void *ctx) {
+    (void)ctx;
+    for (size_t i = 0; i < n; ++i) {
+        const double d = x[i] - 0.3;
+        y[i] = 1.0 / (d * d + 1e-6);
+    }
+    return 1;
+}
+
+/* Fails once the shared call counter reaches the limit in ctx. */
+typedef struct {
+    _Atomic int calls;
+    int limit;
+} abort_ctx_t;
+
+static _Bool f_abort(double *y, const double *x, size_t n, void *ctx) {
+    abort_ctx_t *c = ctx;
+    if (atomic_fetch_add(&c->calls, 1) >= c->limit) return 0;
+    for (size_t i = 0; i < n; ++i) y[i] = 1.0 / (x[i] * x[i] + 1e-8);
+    return 1;
+}
+
+static _Bool f_nan(double *y, const double *x, size_t n, void *ctx) {
+    (void)ctx;
+    for (size_t i = 0; i < n; ++i) y[i] = x[i] > 0.9 ? NAN : 1.0;
+    return 1;
+}
+
+static double peak_exact(void) {
+    return 1e3 * (atan(0.7 / 1e-3) + atan(0.3 / 1e-3));
+}
+
+static void check_suite(ttak_calculus_quad_options_t *o) {
+    ttak_calculus_quad_result_t r;
+    ASSERT(ttak_calculus_integrate_f64(&r, f_sin, 0.0, M_PI, o, NULL));
+    ASSERT(r.converged);
+    ASSERT(fabs(r.value - 2.0) < 1e-12);
+    ASSERT(r.evaluations == 15 * (2 * r.intervals - 1));
+
+    ASSERT(ttak_calculus_integrate_f64(&r, f_sqrt, 0.0, 1.0, o, NULL));
+    ASSERT(r.converged);
+    ASSERT(fabs(r.value - 2.0 / 3.0) < 1e-10);
+    ASSERT(r.error < 1e-9);
+    ASSERT(r.intervals > 1);
+
+    ASSERT(ttak_calculus_integrate_f64(&r, f_peak, 0.0, 1.0, o, NULL));
+    ASSERT(r.converged);
+    ASSERT(fabs(r.value - peak_exact()) < 1e-9 * peak_exact());
+
+    // Reversed bounds negate; equal bounds give zero without a call.
+    ASSERT(ttak_calculus_integrate_f64(&r, f_sin, M_PI, 0.0, o, NULL));
+    ASSERT(fabs(r.value + 2.0) < 1e-12);
+    ASSERT(ttak_calculus_integrate_f64(&r, f_sin, 1.0, 1.0, o, NULL));
+    ASSERT(r.value == 0.0 && r.evaluations == 0 && r.converged);
+}
+
+static void test_integrate_f64_inline(void) {
+    ttak_calculus_quad_options_t o;
+    ttak_calculus_quad_options_init(&o);
+    o.pool = NULL;
+    check_suite(&o);
+}
+
+static void test_integrate_f64_pool(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, now);
+    ASSERT(pool != NULL);
+    ttak_calculus_quad_options_t o;
+    ttak_calculus_quad_options_init(&o);
+    o.pool = pool;
+    o.now = now;
+    for (int rep = 0; rep < 20; ++rep) check_suite(&o);
+
+    // A failing integrand stops every participant and reports failure.
+    abort_ctx_t c = { .limit = 5 };
+    ttak_calculus_quad_result_t r;
+    ASSERT(!ttak_calculus_integrate_f64(&r, f_abort, -1.0, 1.0, &o, &c));
+    ttak_thread_pool_destroy(pool);
+}
+
+static void test_integrate_f64_limits(void) {
+    ttak_calculus_quad_options_t o;
+    ttak_calculus_quad_options_init(&o);
+    o.pool = NULL;
+    ttak_calculus_quad_result_t r;
+
+    // Out of budget: still an estimate, flagged as unconverged.
+    o.max_intervals = 7;
+    ASSERT(ttak_calculus_integrate_f64(&r, f_peak, 0.0, 1.0, &o, NULL));
+    ASSERT(!r.converged);
+    ASSERT(r.intervals <= 7);
+    ASSERT(isfinite(r.value));
+
+    o.max_intervals = 0;
+    ASSERT(!ttak_calculus_integrate_f64(&r, f_nan, 0.0, 1.0, &o, NULL));
+    ASSERT(!ttak_calculus_integrate_f64(&r, f_sin, 0.0, INFINITY, &o, NULL));
+    ASSERT(!ttak_calculus_integrate_f64(&r, NULL, 0.0, 1.0, &o, NULL));
+    o.abs_tol = NAN;
+    ASSERT(!ttak_calculus_integrate_f64(&r, f_sin, 0.0, 1.0, &o, NULL));
+
+    // Defaults, including the shared pool when async is not initialised.
+    ASSERT(ttak_calculus_integrate_f64(&r, f_sin, 0.0, M_PI, NULL, NULL));
+    ASSERT(fabs(r.value - 2.0) < 1e-12);
+}
+
+int main(void) {
+    RUN_TEST(test_integrate_f64_inline);
+    RUN_TEST(test_integrate_f64_pool);
+    RUN_TEST(test_integrate_f64_limits);
+    return 0;
+}
@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "test_macros.h"
@@ -70,7 +71,95 @@ static void test_rfc8439_vector(void) {
     ASSERT(memcmp(tag, expected_tag, sizeof(tag)) == 0);
 }
 
+static size_t hex(const char *s, uint8_t *out) {
+    size_t i = 0;
+    for (; s[2 * i]; i++) {
+        unsigned v;
+        sscanf(s + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+    return i;
+}
+
+static void seal(const uint8_t key[32], const uint8_t nonce[12], const uint8_t *aad, size_t aad_len,
+                 const uint8_t *in, uint8_t *out, size_t len, uint8_t tag[16]) {
+    ttak_crypto_ctx_t ctx = { .key = key, .key_len = 32, .iv_len = 12, .aad = aad, .aad_len = aad_len,
+                              .tag = tag, .tag_len = 16 };
+    memcpy(ctx.iv, nonce, 12);
+    ASSERT(ttak_chacha20_poly1305_execute(&ctx, in, out, len) == TTAK_IO_SUCCESS);
+}
+
+static void test_long_messages(void) {
+    // Lengths that cover a partial block, the four-way Poly1305 path and several keystream chunks, checked against OpenSSL.
+    static const struct {
+        size_t len;
+        const char *tag;
+        const char *last16;
+    } cases[] = {
+        { 63, "b95124cb68c64d350166596ad7908d23", "b06fce0534ee675d3713989ee63641cb" },
+        { 129, "1ed3acee6169bd2c990201e575c6f7ae", "3efa932b9278f6b6beef6082812376be" },
+        { 1000, "9cab1e944f42610fde6efd54076f48b4", "e4f39253559563e65c2a3b7b174c5d4f" },
+        { 5000, "b4e53302f1d3cef14ffc670c72b51631", "eada1ffcd15bd3fbd76c9b67e0f25089" },
+    };
+    uint8_t key[32], nonce[12], aad[37];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(i * 13 + 1);
+    for (int i = 0; i < 12; i++) nonce[i] = (uint8_t)(0xA0 + i);
+    for (int i = 0; i < 37; i++) aad[i] = (uint8_t)(i ^ 0x5c);
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        size_t len = cases[c].len;
+        uint8_t *pt = malloc(len), *ct = malloc(len);
+        ASSERT(pt != NULL && ct != NULL);
+        for (size_t i = 0; i < len; i++) pt[i] = (uint8_t)(i * 31 + 7);
+
+        uint8_t tag[16], want_tag[16], want_last[16];
+        hex(cases[c].tag, want_tag);
+        hex(cases[c].last16, want_last);
+        seal(key, nonce, aad, sizeof(aad), pt, ct, len, tag);
+        ASSERT_MSG(memcmp(tag, want_tag, 16) == 0, "tag for %zu bytes", len);
+        ASSERT(memcmp(ct + len - 16, want_last, 16) == 0);
+
+        // Sealing in place gives the same record.
+        uint8_t tag2[16];
+        seal(key, nonce, aad, sizeof(aad), pt, pt, len, tag2);
+        ASSERT(memcmp(pt, ct, len) == 0 && memcmp(tag, tag2, 16) == 0);
+        free(pt);
+        free(ct);
+    }
+}
+
+static void test_scattered_blocks_match_linear(void) {
+    // 100-byte segments split keystream blocks and Poly1305 blocks unevenly.
+    enum { SEG = 100, NSEG = 23, LEN = SEG * NSEG };
+    uint8_t key[32] = { 9 }, nonce[12] = { 4, 5, 6 }, aad[5] = { 1, 2, 3, 4, 5 };
+    uint8_t *pt = malloc(LEN), *ct = malloc(LEN), *scattered = malloc(LEN);
+    ASSERT(pt != NULL && ct != NULL && scattered != NULL);
+    for (size_t i = 0; i < LEN; i++) pt[i] = (uint8_t)(i ^ (i >> 8));
+
+    uint8_t tag[16], tag2[16];
+    seal(key, nonce, aad, sizeof(aad), pt, ct, LEN, tag);
+
+    const uint8_t *in_blocks[NSEG];
+    uint8_t *out_blocks[NSEG];
+    for (int i = 0; i < NSEG; i++) {
+        in_blocks[i] = pt + i * SEG;
+        out_blocks[i] = scattered + i * SEG;
+    }
+    ttak_crypto_ctx_t ctx = { .key = key, .key_len = 32, .iv_len = 12, .aad = aad, .aad_len = sizeof(aad),
+                              .tag = tag2, .tag_len = 16, .in_blocks = in_blocks, .out_blocks = out_blocks,
+                              .block_size = SEG, .block_count = NSEG };
+    memcpy(ctx.iv, nonce, 12);
+    ASSERT(ttak_chacha20_poly1305_execute(&ctx, NULL, NULL, 0) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(scattered, ct, LEN) == 0);
+    ASSERT(memcmp(tag, tag2, 16) == 0);
+    free(pt);
+    free(ct);
+    free(scattered);
+}
+
 int main(void) {
     RUN_TEST(test_rfc8439_vector);
+    RUN_TEST(test_long_messages);
+    RUN_TEST(test_scattered_blocks_match_linear);
     return 0;
 }
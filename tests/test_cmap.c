@@ -0,0 +1,111 @@
+#include <ttak/ht/cmap.h>
+#include <ttak/mem/epoch.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "test_macros.h"
+
+#define KEYS_PER_WRITER 4096
+
+static size_t value_of(uintptr_t key) { return (size_t)key * 3 + 1; }
+
+static void test_cmap_basic(void) {
+    ttak_cmap_t *map = ttak_cmap_create(0);
+    ASSERT(map != NULL);
+
+    size_t v = 0;
+    ASSERT(!ttak_cmap_get(map, 42, &v));
+    ASSERT(ttak_cmap_put(map, 42, 7));
+    ASSERT(ttak_cmap_get(map, 42, &v) && v == 7);
+    ASSERT(ttak_cmap_put(map, 42, 8));
+    ASSERT(ttak_cmap_get(map, 42, &v) && v == 8);
+    ASSERT(ttak_cmap_size(map) == 1);
+    ASSERT(ttak_cmap_remove(map, 42));
+    ASSERT(!ttak_cmap_remove(map, 42));
+    ASSERT(!ttak_cmap_get(map, 42, NULL));
+    ASSERT(ttak_cmap_size(map) == 0);
+    ttak_cmap_destroy(map);
+}
+
+static void test_cmap_grow(void) {
+    ttak_cmap_t *map = ttak_cmap_create(16);
+    ASSERT(map != NULL);
+    for (uintptr_t k = 0; k < 100000; k++) ASSERT(ttak_cmap_put(map, k, value_of(k)));
+    ASSERT(ttak_cmap_size(map) == 100000);
+
+    ttak_epoch_enter();
+    for (uintptr_t k = 0; k < 100000; k++) {
+        size_t v = 0;
+        ASSERT(ttak_cmap_get_pinned(map, k, &v) && v == value_of(k));
+    }
+    ttak_epoch_exit();
+
+    for (uintptr_t k = 0; k < 100000; k += 2) ASSERT(ttak_cmap_remove(map, k));
+    ASSERT(ttak_cmap_size(map) == 50000);
+    for (uintptr_t k = 0; k < 100000; k++) ASSERT(ttak_cmap_get(map, k, NULL) == ((k & 1) != 0));
+    ttak_cmap_destroy(map);
+    ttak_epoch_reclaim();
+}
+
+typedef struct {
+    ttak_cmap_t *map;
+    uintptr_t base;
+} writer_arg_t;
+
+static _Atomic int g_stop;
+static _Atomic int g_bad;
+
+static void *writer_main(void *p) {
+    writer_arg_t *a = p;
+    for (int round = 0; round < 8; round++) {
+        for (uintptr_t k = 0; k < KEYS_PER_WRITER; k++) ttak_cmap_put(a->map, a->base + k, value_of(a->base + k));
+        for (uintptr_t k = 0; k < KEYS_PER_WRITER; k += 2) ttak_cmap_remove(a->map, a->base + k);
+        sched_yield();
+    }
+    for (uintptr_t k = 0; k < KEYS_PER_WRITER; k++) ttak_cmap_put(a->map, a->base + k, value_of(a->base + k));
+    return NULL;
+}
+
+static void *reader_main(void *p) {
+    ttak_cmap_t *map = p;
+    uintptr_t k = 0;
+    while (!atomic_load(&g_stop)) {
+        for (int i = 0; i < 256; i++, k = (k + 7) % (2 * KEYS_PER_WRITER)) {
+            size_t v;
+            if (ttak_cmap_get(map, k, &v) && v != value_of(k)) atomic_fetch_add(&g_bad, 1);
+        }
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void test_cmap_concurrent(void) {
+    ttak_cmap_t *map = ttak_cmap_create(0);
+    ASSERT(map != NULL);
+    atomic_store(&g_stop, 0);
+    atomic_store(&g_bad, 0);
+
+    pthread_t readers[2], writers[2];
+    writer_arg_t args[2] = {{map, 0}, {map, KEYS_PER_WRITER}};
+    for (int i = 0; i < 2; i++) pthread_create(&readers[i], NULL, reader_main, map);
+    for (int i = 0; i < 2; i++) pthread_create(&writers[i], NULL, writer_main, &args[i]);
+    for (int i = 0; i < 2; i++) pthread_join(writers[i], NULL);
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < 2; i++) pthread_join(readers[i], NULL);
+
+    ASSERT(atomic_load(&g_bad) == 0);
+    ASSERT(ttak_cmap_size(map) == 2 * KEYS_PER_WRITER);
+    for (uintptr_t k = 0; k < 2 * KEYS_PER_WRITER; k++) {
+        size_t v = 0;
+        ASSERT(ttak_cmap_get(map, k, &v) && v == value_of(k));
+    }
+    ttak_cmap_destroy(map);
+    ttak_epoch_reclaim();
+}
+
+int main(void) {
+    RUN_TEST(test_cmap_basic);
+    RUN_TEST(test_cmap_grow);
+    RUN_TEST(test_cmap_concurrent);
+    return 0;
+}
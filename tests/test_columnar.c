@@ -0,0 +1,179 @@
+#include <ttak/container/columnar.h>
+#include <ttak/timing/timing.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+#define COL_ROWS 100003
+
+enum { C_USER, C_DELTA, C_DUR, C_SCORE, C_BYTES, C_PORT };
+
+static ttak_columnar_t *build_table(void) {
+    const ttak_col_type_t types[] = { TTAK_COL_U32, TTAK_COL_I64, TTAK_COL_F64,
+                                      TTAK_COL_F32, TTAK_COL_U64, TTAK_COL_I32 };
+    ttak_columnar_t *t = ttak_columnar_create(types, 6, 0);
+    uint64_t x = 88172645463325252ULL;
+    // Append in uneven batches to exercise growth.
+    for (size_t done = 0; done < COL_ROWS;) {
+        size_t n = (done % 7 + 1) * 997;
+        if (n > COL_ROWS - done) n = COL_ROWS - done;
+        uint32_t user[7 * 997];
+        int64_t delta[7 * 997];
+        double dur[7 * 997];
+        float score[7 * 997];
+        uint64_t bytes[7 * 997];
+        int32_t port[7 * 997];
+        for (size_t i = 0; i < n; i++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            user[i] = (uint32_t)(x % 1000) + (x & 1 ? 0x80000000u : 0);
+            delta[i] = (int64_t)(x % 2001) - 1000 + (x & 2 ? INT64_MIN / 2 : 0);
+            dur[i] = (double)(x % 10000) / 100.0;
+            score[i] = (x % 97 == 0) ? NAN : (float)(x % 500) - 250.0f;
+            bytes[i] = x;
+            port[i] = (int32_t)(x % 65536) - 32768;
+        }
+        const void *cols[] = { user, delta, dur, score, bytes, port };
+        ASSERT(ttak_columnar_append(t, n, cols));
+        done += n;
+    }
+    ASSERT(ttak_columnar_rows(t) == COL_ROWS);
+    return t;
+}
+
+static int check_op(ttak_col_op_t op, int lt, int eq, int unordered) {
+    if (unordered) return op == TTAK_COL_NE;
+    switch (op) {
+        case TTAK_COL_EQ: return eq;
+        case TTAK_COL_NE: return !eq;
+        case TTAK_COL_LT: return lt;
+        case TTAK_COL_LE: return lt || eq;
+        case TTAK_COL_GT: return !lt && !eq;
+        case TTAK_COL_GE: return !lt;
+    }
+    return 0;
+}
+
+static void test_columnar_filters_match_reference(void) {
+    ttak_columnar_t *t = build_table();
+    size_t words = ttak_columnar_mask_words(t);
+    uint64_t *sel = malloc(words * sizeof(uint64_t));
+
+    const uint32_t *user = ttak_columnar_column(t, C_USER);
+    const int64_t *delta = ttak_columnar_column(t, C_DELTA);
+    const double *dur = ttak_columnar_column(t, C_DUR);
+    const float *score = ttak_columnar_column(t, C_SCORE);
+    const uint64_t *bytes = ttak_columnar_column(t, C_BYTES);
+    const int32_t *port = ttak_columnar_column(t, C_PORT);
+    uint32_t ku = user[17];
+    int64_t kd = -3;
+    double kdur = 50.0;
+    float ks = 0.0f;
+    uint64_t kb = bytes[123];
+    int32_t kp = 100;
+
+    for (int op = TTAK_COL_EQ; op <= TTAK_COL_GE; op++) {
+        size_t hits[6];
+        const void *ops[] = { &ku, &kd, &kdur, &ks, &kb, &kp };
+        for (int c = 0; c < 6; c++) {
+            hits[c] = ttak_columnar_filter(t, (size_t)c, (ttak_col_op_t)op, ops[c], sel, false);
+            size_t want = 0;
+            int ok = 1;
+            for (size_t r = 0; r < COL_ROWS; r++) {
+                int e;
+                switch (c) {
+                    case C_USER: e = check_op(op, user[r] < ku, user[r] == ku, 0); break;
+                    case C_DELTA: e = check_op(op, delta[r] < kd, delta[r] == kd, 0); break;
+                    case C_DUR: e = check_op(op, dur[r] < kdur, dur[r] == kdur, 0); break;
+                    case C_SCORE: e = check_op(op, score[r] < ks, score[r] == ks, isnan(score[r])); break;
+                    case C_BYTES: e = check_op(op, bytes[r] < kb, bytes[r] == kb, 0); break;
+                    default: e = check_op(op, port[r] < kp, port[r] == kp, 0); break;
+                }
+                want += (size_t)e;
+                if (((sel[r / 64] >> (r % 64)) & 1) != (uint64_t)e) ok = 0;
+            }
+            ASSERT(ok);
+            ASSERT(hits[c] == want);
+            // No bits past the last row.
+            ASSERT((sel[words - 1] >> (COL_ROWS % 64)) == 0);
+        }
+    }
+    free(sel);
+    ttak_columnar_destroy(t);
+}
+
+static void test_columnar_refine_and_gather(void) {
+    ttak_columnar_t *t = build_table();
+    uint64_t *sel = malloc(ttak_columnar_mask_words(t) * sizeof(uint64_t));
+    const double *dur = ttak_columnar_column(t, C_DUR);
+    const int32_t *port = ttak_columnar_column(t, C_PORT);
+
+    double lo = 10.0;
+    int32_t zero = 0;
+    ttak_columnar_filter(t, C_DUR, TTAK_COL_GE, &lo, sel, false);
+    size_t hits = ttak_columnar_filter(t, C_PORT, TTAK_COL_GT, &zero, sel, true);
+
+    double *out = malloc(hits * sizeof(double));
+    ASSERT(ttak_columnar_gather(t, C_DUR, sel, out) == hits);
+    size_t k = 0;
+    int ok = 1;
+    for (size_t r = 0; r < COL_ROWS; r++) {
+        if (dur[r] >= lo && port[r] > 0) {
+            if (k >= hits || out[k] != dur[r]) ok = 0;
+            k++;
+        }
+    }
+    ASSERT(ok && k == hits);
+    free(out);
+    free(sel);
+    ttak_columnar_destroy(t);
+}
+
+typedef struct {
+    uint64_t sum[TTAK_COLUMNAR_MAX_CHUNKS];
+    size_t rows[TTAK_COLUMNAR_MAX_CHUNKS];
+} scan_partials_t;
+
+static void sum_bytes(const ttak_columnar_t *t, size_t begin, size_t end, size_t chunk, void *ctx) {
+    scan_partials_t *p = ctx;
+    const uint64_t *bytes = ttak_columnar_column(t, C_BYTES);
+    uint64_t s = 0;
+    for (size_t r = begin; r < end; r++) s += bytes[r] & 0xffff;
+    p->sum[chunk] = s;
+    p->rows[chunk] = end - begin;
+}
+
+static void test_columnar_parallel_scan(void) {
+    ttak_columnar_t *t = build_table();
+    const uint64_t *bytes = ttak_columnar_column(t, C_BYTES);
+    uint64_t want = 0;
+    for (size_t r = 0; r < COL_ROWS; r++) want += bytes[r] & 0xffff;
+
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+    ttak_thread_pool_t *pools[] = { pool, NULL };
+    for (int p = 0; p < 2; p++) {
+        scan_partials_t parts = {0};
+        size_t n = ttak_columnar_scan(t, pools[p], sum_bytes, &parts, now);
+        ASSERT(n > 1 && n <= TTAK_COLUMNAR_MAX_CHUNKS);
+        uint64_t got = 0;
+        size_t rows = 0;
+        for (size_t i = 0; i < n; i++) {
+            got += parts.sum[i];
+            rows += parts.rows[i];
+        }
+        ASSERT(got == want && rows == COL_ROWS);
+    }
+    ttak_thread_pool_destroy(pool);
+    ttak_columnar_destroy(t);
+}
+
+int main(void) {
+    RUN_TEST(test_columnar_filters_match_reference);
+    RUN_TEST(test_columnar_refine_and_gather);
+    RUN_TEST(test_columnar_parallel_scan);
+    return 0;
+}
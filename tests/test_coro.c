@@ -0,0 +1,142 @@
+#include <ttak/async/coro.h>
+#include <ttak/async/promise.h>
+#include <ttak/mem/mem.h>
+#include <ttak/timing/timing.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+typedef struct {
+    ttak_future_t *input;
+    uintptr_t sum;
+    int yields;
+} chain_state_t;
+
+static ttak_coro_status_t chain_body(ttak_coro_t *co, void *arg) {
+    chain_state_t *s = (chain_state_t *)arg;
+    TTAK_CORO_BEGIN(co);
+    TTAK_CORO_AWAIT_FUTURE(co, s->input);
+    s->sum += (uintptr_t)ttak_coro_value(co);
+    for (s->yields = 0; s->yields < 3; s->yields++) {
+        TTAK_CORO_YIELD(co);
+    }
+    TTAK_CORO_SLEEP(co, TT_MILLI_SECOND(2));
+    TTAK_CORO_RETURN(co, (void *)(s->sum + 1));
+    TTAK_CORO_END(co);
+}
+
+static void test_coro_future_yield_sleep(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+
+    ttak_promise_t *promise = ttak_promise_create(now);
+    chain_state_t s = { .input = ttak_promise_get_future(promise) };
+    ttak_future_t *done = ttak_coro_spawn(pool, chain_body, &s, 0, now);
+    ASSERT(done != NULL);
+    ASSERT(!ttak_future_is_ready(done));
+
+    ttak_promise_set_value(promise, (void *)(uintptr_t)41, now);
+    ASSERT(ttak_future_get(done) == (void *)(uintptr_t)42);
+    ASSERT(s.yields == 3);
+
+    ttak_future_destroy(done);
+    ttak_future_destroy(s.input);
+    ttak_mem_free(promise);
+    ttak_thread_pool_destroy(pool);
+}
+
+typedef struct {
+    int fd;
+    short seen;
+    char byte;
+} fd_state_t;
+
+static ttak_coro_status_t fd_body(ttak_coro_t *co, void *arg) {
+    fd_state_t *s = (fd_state_t *)arg;
+    TTAK_CORO_BEGIN(co);
+    TTAK_CORO_AWAIT_FD(co, s->fd, POLLIN, TT_SECOND(5));
+    s->seen = ttak_coro_revents(co);
+    if (s->seen & POLLIN) {
+        ASSERT(read(s->fd, &s->byte, 1) == 1);
+    }
+    TTAK_CORO_END(co);
+}
+
+static void test_coro_fd_wait_and_timeout(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+    int fds[2];
+    ASSERT(pipe(fds) == 0);
+
+    fd_state_t s = { .fd = fds[0] };
+    ttak_future_t *done = ttak_coro_spawn(pool, fd_body, &s, 0, now);
+    ASSERT(done != NULL);
+    usleep(5000);
+    ASSERT(!ttak_future_is_ready(done));
+    ASSERT(write(fds[1], "x", 1) == 1);
+    ttak_future_get(done);
+    ASSERT((s.seen & POLLIN) && s.byte == 'x');
+    ttak_future_destroy(done);
+
+    /* Shutdown releases a pending wait as a timeout. */
+    fd_state_t idle = { .fd = fds[0] };
+    done = ttak_coro_spawn(pool, fd_body, &idle, 0, now);
+    ASSERT(done != NULL);
+    usleep(5000);
+    ttak_coro_reactor_shutdown();
+    ttak_future_get(done);
+    ASSERT(idle.seen == 0);
+    ttak_future_destroy(done);
+
+    close(fds[0]);
+    close(fds[1]);
+    ttak_thread_pool_destroy(pool);
+}
+
+#define SESSIONS 1000
+
+static _Atomic int g_sessions_done;
+
+static ttak_coro_status_t session_body(ttak_coro_t *co, void *arg) {
+    (void)arg;
+    TTAK_CORO_BEGIN(co);
+    TTAK_CORO_SLEEP(co, TT_MILLI_SECOND(20));
+    atomic_fetch_add(&g_sessions_done, 1);
+    TTAK_CORO_END(co);
+}
+
+static void test_coro_many_sessions_few_workers(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+    atomic_store(&g_sessions_done, 0);
+
+    static ttak_future_t *done[SESSIONS];
+    uint64_t start = ttak_get_tick_count_ns();
+    for (int i = 0; i < SESSIONS; ++i) {
+        /* Distinct args spread the tasks so no priority band fills up. */
+        done[i] = ttak_coro_spawn(pool, session_body, (void *)(uintptr_t)(i + 1), 0, now);
+        ASSERT(done[i] != NULL);
+    }
+    for (int i = 0; i < SESSIONS; ++i) {
+        ttak_future_get(done[i]);
+        ttak_future_destroy(done[i]);
+    }
+    ASSERT(atomic_load(&g_sessions_done) == SESSIONS);
+    /* Every session slept concurrently on two workers, not one after another. */
+    ASSERT(ttak_get_tick_count_ns() - start < TT_SECOND(5));
+
+    ttak_coro_reactor_shutdown();
+    ttak_thread_pool_destroy(pool);
+}
+
+int main(void) {
+    RUN_TEST(test_coro_future_yield_sleep);
+    RUN_TEST(test_coro_fd_wait_and_timeout);
+    RUN_TEST(test_coro_many_sessions_few_workers);
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <ttak/ht/counter.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+#define CM_THREADS 4
+#define CM_KEYS 2000
+#define CM_ADDS 100000
+
+/* Skewed key: low keys are hit most, key 1 about half the time. */
+static uintptr_t cm_key(uint64_t *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 7;
+    *x ^= *x << 17;
+    return (uintptr_t)(CM_KEYS / (*x % CM_KEYS + 1));
+}
+
+typedef struct {
+    ttak_counter_map_t *map;
+    uint64_t seed;
+} cm_arg_t;
+
+static void *cm_worker(void *p) {
+    cm_arg_t *a = p;
+    uint64_t x = a->seed;
+    for (int i = 0; i < CM_ADDS; i++) ttak_counter_map_add(a->map, cm_key(&x), 1);
+    return NULL;
+}
+
+static void test_counter_map_concurrent_counts(void) {
+    ttak_counter_map_t *map = ttak_counter_map_create(CM_KEYS);
+    ASSERT(map != NULL);
+    pthread_t th[CM_THREADS];
+    cm_arg_t args[CM_THREADS];
+    for (int t = 0; t < CM_THREADS; t++) {
+        args[t] = (cm_arg_t){ map, 0x1234567ULL * (uint64_t)(t + 1) };
+        pthread_create(&th[t], NULL, cm_worker, &args[t]);
+    }
+    for (int t = 0; t < CM_THREADS; t++) pthread_join(th[t], NULL);
+
+    uint64_t *want = calloc(CM_KEYS + 1, sizeof(uint64_t));
+    size_t distinct = 0;
+    for (int t = 0; t < CM_THREADS; t++) {
+        uint64_t x = args[t].seed;
+        for (int i = 0; i < CM_ADDS; i++) {
+            uintptr_t k = cm_key(&x);
+            if (want[k]++ == 0) distinct++;
+        }
+    }
+    int ok = 1;
+    for (uintptr_t k = 0; k <= CM_KEYS; k++) {
+        if (ttak_counter_map_get(map, k) != want[k]) ok = 0;
+    }
+    ASSERT(ok);
+    ASSERT(ttak_counter_map_size(map) == distinct);
+
+    ttak_counter_entry_t top[10];
+    ASSERT(ttak_counter_map_top_k(map, 10, top) == 10);
+    ASSERT(top[0].key == 1 && top[0].count == want[1]);
+    for (int i = 1; i < 10; i++) {
+        ASSERT(top[i].count <= top[i - 1].count);
+        ASSERT(top[i].count == want[top[i].key]);
+    }
+    // Nothing outside the top 10 beats the 10th.
+    size_t above = 0;
+    for (uintptr_t k = 0; k <= CM_KEYS; k++) above += want[k] > top[9].count;
+    ASSERT(above < 10);
+
+    free(want);
+    ttak_counter_map_destroy(map);
+}
+
+static void test_counter_map_merge_and_full(void) {
+    ttak_counter_map_t *a = ttak_counter_map_create(100);
+    ttak_counter_map_t *b = ttak_counter_map_create(100);
+    for (uintptr_t k = 0; k < 50; k++) {
+        ASSERT(ttak_counter_map_add(a, k, k));
+        ASSERT(ttak_counter_map_add(b, k + 25, 2));
+    }
+    ASSERT(ttak_counter_map_merge(a, b));
+    ASSERT(ttak_counter_map_size(a) == 75);
+    ASSERT(ttak_counter_map_get(a, 0) == 0);
+    ASSERT(ttak_counter_map_get(a, 10) == 10);
+    ASSERT(ttak_counter_map_get(a, 30) == 32);
+    ASSERT(ttak_counter_map_get(a, 70) == 2);
+    ASSERT(ttak_counter_map_get(a, 1000) == 0);
+
+    ttak_counter_entry_t top[100];
+    ASSERT(ttak_counter_map_top_k(a, 100, top) == 75);
+    ASSERT(top[0].key == 49 && top[0].count == 51);
+
+    // Past its capacity the map refuses new keys but keeps counting old ones.
+    uintptr_t k = 1000;
+    while (ttak_counter_map_add(b, k, 1)) k++;
+    ASSERT(ttak_counter_map_size(b) >= 100);
+    ASSERT(ttak_counter_map_add(b, 30, 1));
+    ASSERT(ttak_counter_map_get(b, 30) == 3);
+    ttak_counter_map_destroy(a);
+    ttak_counter_map_destroy(b);
+}
+
+int main(void) {
+    RUN_TEST(test_counter_map_concurrent_counts);
+    RUN_TEST(test_counter_map_merge_and_full);
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include <ttak/mem/detachable.h>
 #include "test_macros.h"
+#include <string.h>
 #include <time.h>
 
 static void test_detached_mode_requires_epoch(void) {
@@ -75,10 +76,104 @@ static void test_flip_detection_is_conservative_with_long_gap(void) {
     ttak_detachable_context_destroy(&ctx);
 }
 
+static void test_size_class_depot_reuses_buffers(void) {
+    ttak_detachable_context_t ctx;
+    ttak_detachable_context_init(&ctx, TTAK_ARENA_USE_LOCKED_ACCESS);
+
+    ttak_detachable_allocation_t a = ttak_detachable_mem_alloc(&ctx, 64 * 1024, 0);
+    ASSERT(a.data != NULL);
+    void *first = a.data;
+    memset(a.data, 0xAB, a.size);
+    ttak_detachable_mem_free(&ctx, &a);
+    ASSERT(ctx.class_caches[2].count == 1);
+
+    /* Any request in the 16K..64K class reuses the buffer, zeroed. */
+    ttak_detachable_allocation_t b = ttak_detachable_mem_alloc(&ctx, 40 * 1024, 0);
+    ASSERT(b.data == first);
+    ASSERT((b.detach_status.bits & TTAK_DETACHABLE_PARTIAL_CACHE) != 0);
+    for (size_t i = 0; i < b.size; i += 1024) ASSERT(((unsigned char *)b.data)[i] == 0);
+    ASSERT(ctx.class_caches[2].count == 0);
+    ttak_detachable_mem_free(&ctx, &b);
+
+    /* Beyond the largest class nothing is cached. */
+    ttak_detachable_allocation_t big = ttak_detachable_mem_alloc(&ctx, TTAK_DETACHABLE_CLASS_MAX_BYTES + 1, 0);
+    ASSERT(big.data != NULL);
+    ttak_detachable_mem_free(&ctx, &big);
+    for (size_t i = 0; i < TTAK_DETACHABLE_SIZE_CLASSES; ++i) {
+        ASSERT(ctx.class_caches[i].count == (i == 2 ? 1u : 0u));
+    }
+    ttak_detachable_context_destroy(&ctx);
+}
+
+static void test_front_cache_skips_depot(void) {
+    ttak_detachable_context_t ctx;
+    ttak_detachable_context_init(&ctx, TTAK_ARENA_USE_LOCKED_ACCESS);
+    ttak_detachable_front_t front;
+    ttak_detachable_front_init(&front, &ctx);
+
+    void *seen[TTAK_DETACHABLE_FRONT_SLOTS + 1];
+    ttak_detachable_allocation_t allocs[TTAK_DETACHABLE_FRONT_SLOTS + 1];
+    for (size_t round = 0; round < 3; ++round) {
+        for (size_t i = 0; i <= TTAK_DETACHABLE_FRONT_SLOTS; ++i) {
+            allocs[i] = ttak_detachable_mem_alloc_front(&front, 4096, 0);
+            ASSERT(allocs[i].data != NULL);
+            if (round == 0) seen[i] = allocs[i].data;
+        }
+        for (size_t i = 0; i <= TTAK_DETACHABLE_FRONT_SLOTS; ++i) {
+            ttak_detachable_mem_free_front(&front, &allocs[i]);
+        }
+        /* The front keeps its slots; the overflow spills to the depot. */
+        ASSERT(front.count[0] == TTAK_DETACHABLE_FRONT_SLOTS);
+        ASSERT(ctx.class_caches[0].count == 1);
+    }
+    ASSERT(front.hits == 2 * TTAK_DETACHABLE_FRONT_SLOTS);
+
+    /* Steady state: every buffer came from the first round. */
+    for (size_t i = 0; i <= TTAK_DETACHABLE_FRONT_SLOTS; ++i) {
+        allocs[i] = ttak_detachable_mem_alloc_front(&front, 3000, 0);
+        bool reused = false;
+        for (size_t j = 0; j <= TTAK_DETACHABLE_FRONT_SLOTS; ++j) reused |= (allocs[i].data == seen[j]);
+        ASSERT(reused);
+    }
+    for (size_t i = 0; i <= TTAK_DETACHABLE_FRONT_SLOTS; ++i) ttak_detachable_mem_free_front(&front, &allocs[i]);
+
+    ttak_detachable_front_flush(&front);
+    ASSERT(front.count[0] == 0);
+    ASSERT(ctx.class_caches[0].count == TTAK_DETACHABLE_FRONT_SLOTS + 1);
+    ttak_detachable_context_destroy(&ctx);
+}
+
+static void test_confined_context_skips_flip_quarantine(void) {
+    ttak_detachable_context_t ctx;
+    ttak_detachable_context_init_confined(&ctx, TTAK_ARENA_USE_LOCKED_ACCESS);
+    ASSERT(ctx.flags & TTAK_ARENA_IS_SINGLE_THREAD);
+    ASSERT(!(ctx.flags & TTAK_ARENA_USE_LOCKED_ACCESS));
+    ctx.flip_event_threshold = 2;
+    ctx.flip_window_ns = 1000000000ULL;
+    ctx.flip_max_gap_ns = UINT64_MAX;
+
+    /* The same churn that trips the flip detector on a shared context. */
+    void *first = NULL;
+    for (int i = 0; i < 4; ++i) {
+        ttak_detachable_allocation_t alloc = ttak_detachable_mem_alloc(&ctx, 8, 0);
+        ASSERT(alloc.data != NULL);
+        if (i == 0) first = alloc.data;
+        else ASSERT(alloc.data == first);
+        ttak_detachable_mem_free(&ctx, &alloc);
+    }
+    ASSERT(ctx.quarantine.len == 0);
+    ASSERT(ctx.small_cache.count == 1);
+    ASSERT(atomic_load(&ctx.flip_event_count) == 0);
+    ttak_detachable_context_destroy(&ctx);
+}
+
 int main(void) {
     RUN_TEST(test_detached_mode_requires_epoch);
     RUN_TEST(test_detached_mode_stays_separate_from_standard);
     RUN_TEST(test_flip_hot_path_bypasses_cache);
     RUN_TEST(test_flip_detection_is_conservative_with_long_gap);
+    RUN_TEST(test_size_class_depot_reuses_buffers);
+    RUN_TEST(test_front_cache_skips_depot);
+    RUN_TEST(test_confined_context_skips_flip_quarantine);
     return 0;
 }
@@ -0,0 +1,91 @@
+#include <ttak/mask/dynamic_mask.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+#define MASK_BITS 300000
+
+static void test_find_set_bits(void) {
+    ttak_dynamic_mask_t mask;
+    ttak_dynamic_mask_init(&mask);
+    uint32_t idx;
+    ASSERT(!ttak_dynamic_mask_find_first(&mask, &idx));
+
+    ASSERT(ttak_dynamic_mask_set(&mask, MASK_BITS - 1));
+    ASSERT(ttak_dynamic_mask_find_first(&mask, &idx) && idx == MASK_BITS - 1);
+
+    uint32_t picks[] = {5, 64, 4095, 4096, 262143, 262144};
+    for (size_t i = 0; i < sizeof(picks) / sizeof(picks[0]); i++) {
+        ASSERT(ttak_dynamic_mask_set(&mask, picks[i]));
+    }
+
+    // Iterate with find_next and compare against the expected sequence.
+    uint32_t expect[] = {5, 64, 4095, 4096, 262143, 262144, MASK_BITS - 1};
+    uint32_t from = 0;
+    for (size_t i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        ASSERT(ttak_dynamic_mask_find_next(&mask, from, &idx));
+        ASSERT(idx == expect[i]);
+        from = idx + 1;
+    }
+    ASSERT(!ttak_dynamic_mask_find_next(&mask, from, &idx));
+
+    ttak_dynamic_mask_clear(&mask, 5);
+    ttak_dynamic_mask_clear(&mask, 64);
+    ASSERT(ttak_dynamic_mask_find_first(&mask, &idx) && idx == 4095);
+    ASSERT(ttak_dynamic_mask_count(&mask) == 5);
+    ttak_dynamic_mask_destroy(&mask);
+}
+
+static void test_claim_first_free(void) {
+    ttak_dynamic_mask_t mask;
+    ttak_dynamic_mask_init(&mask);
+    uint32_t idx;
+
+    // Claims hand out 0..n-1 in order and grow past the initial capacity.
+    for (uint32_t i = 0; i < 10000; i++) {
+        ASSERT(ttak_dynamic_mask_claim_first_free(&mask, &idx));
+        ASSERT(idx == i);
+    }
+    ASSERT(ttak_dynamic_mask_count(&mask) == 10000);
+
+    // Freed slots are reused lowest first.
+    ttak_dynamic_mask_clear(&mask, 7000);
+    ttak_dynamic_mask_clear(&mask, 63);
+    ASSERT(ttak_dynamic_mask_find_first_free(&mask, &idx) && idx == 63);
+    ASSERT(ttak_dynamic_mask_claim_first_free(&mask, &idx) && idx == 63);
+    ASSERT(ttak_dynamic_mask_claim_first_free(&mask, &idx) && idx == 7000);
+    ASSERT(ttak_dynamic_mask_claim_first_free(&mask, &idx) && idx == 10000);
+    ttak_dynamic_mask_destroy(&mask);
+}
+
+static void test_count_range(void) {
+    ttak_dynamic_mask_t mask;
+    ttak_dynamic_mask_init(&mask);
+    uint8_t *ref = calloc(MASK_BITS, 1);
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < 50000; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        uint32_t b = (uint32_t)(x % MASK_BITS);
+        ASSERT(ttak_dynamic_mask_set(&mask, b));
+        ref[b] = 1;
+    }
+
+    uint32_t ranges[][2] = {{0, MASK_BITS}, {3, 61}, {100, 100}, {63, 65}, {1000, 250001}, {12, MASK_BITS + 500}};
+    for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        size_t want = 0;
+        for (uint32_t i = ranges[r][0]; i < ranges[r][1] && i < MASK_BITS; i++) want += ref[i];
+        ASSERT(ttak_dynamic_mask_count_range(&mask, ranges[r][0], ranges[r][1]) == want);
+    }
+    ASSERT(ttak_dynamic_mask_count_range(&mask, 0, MASK_BITS) == ttak_dynamic_mask_count(&mask));
+    free(ref);
+    ttak_dynamic_mask_destroy(&mask);
+}
+
+int main(void) {
+    RUN_TEST(test_find_set_bits);
+    RUN_TEST(test_claim_first_free);
+    RUN_TEST(test_count_range);
+    return 0;
+}
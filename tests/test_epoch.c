@@ -0,0 +1,231 @@
+#include <ttak/mem/epoch.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "test_macros.h"
+
+static atomic_size_t g_cleaned;
+static atomic_size_t g_bulk_calls;
+static int g_slots[4096];
+
+static void count_cleanup(void *ptr) {
+    (void)ptr;
+    atomic_fetch_add(&g_cleaned, 1);
+}
+
+static void count_bulk_cleanup(void **ptrs, size_t count) {
+    ASSERT(count > 0 && count <= TTAK_EPOCH_BATCH_SIZE);
+    for (size_t i = 0; i < count; ++i) ASSERT(ptrs[i] != NULL);
+    atomic_fetch_add(&g_bulk_calls, 1);
+    atomic_fetch_add(&g_cleaned, count);
+}
+
+static void reset_counters(void) {
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    atomic_store(&g_cleaned, 0);
+    atomic_store(&g_bulk_calls, 0);
+}
+
+static void test_epoch_batched_retire(void) {
+    ttak_epoch_set_reclaim_threshold(0);
+    reset_counters();
+
+    const size_t n = TTAK_EPOCH_BATCH_SIZE * 3 + 5;
+    for (size_t i = 0; i < n; ++i) ttak_epoch_retire(&g_slots[i], count_cleanup);
+    /* Nothing is freed until a reclaim sees the sealing epoch pass. */
+    ASSERT(atomic_load(&g_cleaned) == 0);
+
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    ASSERT(atomic_load(&g_cleaned) == n);
+    ttak_epoch_set_reclaim_threshold(TTAK_EPOCH_RECLAIM_THRESHOLD);
+}
+
+static void test_epoch_bulk_cleanup(void) {
+    ttak_epoch_set_reclaim_threshold(0);
+    reset_counters();
+
+    static void *ptrs[200];
+    for (size_t i = 0; i < 200; ++i) ptrs[i] = &g_slots[i];
+    ttak_epoch_retire_bulk(ptrs, 100, count_bulk_cleanup);
+    ttak_epoch_retire_bulk(ptrs + 100, 100, count_bulk_cleanup);
+
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    ASSERT(atomic_load(&g_cleaned) == 200);
+    /* Consecutive calls keep filling the same batch: ceil(200 / 64) cleanups. */
+    ASSERT(atomic_load(&g_bulk_calls) == (200 + TTAK_EPOCH_BATCH_SIZE - 1) / TTAK_EPOCH_BATCH_SIZE);
+    ttak_epoch_set_reclaim_threshold(TTAK_EPOCH_RECLAIM_THRESHOLD);
+}
+
+static void test_epoch_auto_reclaim(void) {
+    ttak_epoch_set_reclaim_threshold(4);
+    reset_counters();
+
+    /* Never call reclaim explicitly: retires alone must keep the backlog bounded. */
+    for (size_t round = 0; round < 8; ++round) {
+        for (size_t i = 0; i < 1024; ++i) ttak_epoch_retire(&g_slots[i], count_cleanup);
+    }
+    ASSERT(atomic_load(&g_cleaned) >= 8 * 1024 - 8 * TTAK_EPOCH_BATCH_SIZE);
+    ttak_epoch_set_reclaim_threshold(TTAK_EPOCH_RECLAIM_THRESHOLD);
+}
+
+static atomic_int g_reader_state;
+
+static void *stalled_reader(void *arg) {
+    (void)arg;
+    ttak_epoch_enter();
+    atomic_store(&g_reader_state, 1);
+    while (atomic_load(&g_reader_state) != 2) { }
+    ttak_epoch_exit();
+    ttak_epoch_deregister_thread();
+    return NULL;
+}
+
+static void test_epoch_reader_blocks_reclaim(void) {
+    ttak_epoch_set_reclaim_threshold(0);
+    reset_counters();
+
+    atomic_store(&g_reader_state, 0);
+    pthread_t reader;
+    ASSERT(pthread_create(&reader, NULL, stalled_reader, NULL) == 0);
+    while (atomic_load(&g_reader_state) != 1) { }
+
+    for (size_t i = 0; i < 10; ++i) ttak_epoch_retire(&g_slots[i], count_cleanup);
+    for (int i = 0; i < 4; ++i) ttak_epoch_reclaim();
+    ASSERT(atomic_load(&g_cleaned) == 0);
+
+    atomic_store(&g_reader_state, 2);
+    pthread_join(reader, NULL);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    ASSERT(atomic_load(&g_cleaned) == 10);
+    ttak_epoch_set_reclaim_threshold(TTAK_EPOCH_RECLAIM_THRESHOLD);
+}
+
+static void *exiting_retirer(void *arg) {
+    (void)arg;
+    for (size_t i = 0; i < 7; ++i) ttak_epoch_retire(&g_slots[i], count_cleanup);
+    return NULL; /* No deregister: thread exit seals the partial batch. */
+}
+
+static void test_epoch_thread_exit_flushes(void) {
+    ttak_epoch_set_reclaim_threshold(0);
+    reset_counters();
+
+    pthread_t t;
+    ASSERT(pthread_create(&t, NULL, exiting_retirer, NULL) == 0);
+    pthread_join(t, NULL);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    ASSERT(atomic_load(&g_cleaned) == 7);
+    ttak_epoch_set_reclaim_threshold(TTAK_EPOCH_RECLAIM_THRESHOLD);
+}
+
+static ttak_epoch_thread_stats_t *self_stats(ttak_epoch_thread_stats_t *buf, size_t cap) {
+    size_t n = ttak_epoch_thread_stats(buf, cap);
+    ASSERT(n <= cap);
+    ttak_thread_state_t *self = t_local_state;
+    for (size_t i = 0; i < n; ++i) {
+        if (buf[i].logical_tid == self->logical_tid) return &buf[i];
+    }
+    ASSERT(0);
+    return NULL;
+}
+
+static void test_epoch_stats_snapshot(void) {
+    ttak_epoch_set_reclaim_threshold(0);
+    reset_counters();
+
+    static ttak_epoch_thread_stats_t threads[64];
+    ttak_epoch_stats_t before, after;
+    ttak_epoch_stats_snapshot(&before);
+
+    for (size_t i = 0; i < 100; ++i) ttak_epoch_retire_sized(&g_slots[i], 32, count_cleanup);
+    ttak_epoch_thread_stats_t *me = self_stats(threads, 64);
+    ASSERT(me->pending_ptrs == 100 && me->pending_bytes == 100 * 32);
+
+    /* A stalled reader shows up as epoch lag and keeps the backlog pinned. */
+    atomic_store(&g_reader_state, 0);
+    pthread_t reader;
+    ASSERT(pthread_create(&reader, NULL, stalled_reader, NULL) == 0);
+    while (atomic_load(&g_reader_state) != 1) { }
+    for (int i = 0; i < 4; ++i) ttak_epoch_reclaim();
+    ttak_epoch_stats_snapshot(&after);
+    ASSERT(after.pinned_threads >= 1);
+    ASSERT(after.oldest_epoch_lag >= 1);
+    ASSERT(after.pending_bytes >= 100 * 32);
+    ASSERT(self_stats(threads, 64)->pending_ptrs == 100);
+
+    atomic_store(&g_reader_state, 2);
+    pthread_join(reader, NULL);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    me = self_stats(threads, 64);
+    ASSERT(me->pending_ptrs == 0 && me->pending_bytes == 0);
+
+    ttak_epoch_stats_snapshot(&after);
+    ASSERT(after.oldest_epoch_lag == 0);
+    ASSERT(after.reclaim_ns.count >= before.reclaim_ns.count + 6);
+    ASSERT(after.registered_threads >= 2);
+    ttak_epoch_set_reclaim_threshold(TTAK_EPOCH_RECLAIM_THRESHOLD);
+}
+
+#define CHURN_WAVE 8
+
+static pthread_barrier_t g_churn_barrier;
+static uint32_t g_churn_tids[CHURN_WAVE];
+
+static void *churn_worker(void *arg) {
+    size_t idx = (size_t)arg;
+    ttak_epoch_enter();
+    ttak_epoch_exit();
+    g_churn_tids[idx] = t_local_state->logical_tid;
+    /* Everyone holds an id at once; then half leave explicitly, half just exit. */
+    pthread_barrier_wait(&g_churn_barrier);
+    if (idx & 1) ttak_epoch_deregister_thread();
+    return NULL;
+}
+
+static void test_epoch_tid_recycling(void) {
+    ttak_epoch_set_reclaim_threshold(0);
+    reset_counters();
+    size_t before = ttak_epoch_thread_stats(NULL, 0);
+
+    ASSERT(pthread_barrier_init(&g_churn_barrier, NULL, CHURN_WAVE) == 0);
+    for (int wave = 0; wave < 200; ++wave) {
+        pthread_t t[CHURN_WAVE];
+        for (size_t i = 0; i < CHURN_WAVE; ++i) ASSERT(pthread_create(&t[i], NULL, churn_worker, (void *)i) == 0);
+        for (size_t i = 0; i < CHURN_WAVE; ++i) pthread_join(t[i], NULL);
+        for (size_t i = 0; i < CHURN_WAVE; ++i) {
+            ASSERT(g_churn_tids[i] != t_local_state->logical_tid);
+            for (size_t j = i + 1; j < CHURN_WAVE; ++j) ASSERT(g_churn_tids[i] != g_churn_tids[j]);
+        }
+    }
+    pthread_barrier_destroy(&g_churn_barrier);
+
+    /* 1600 threads came and went; ids only cover the widest wave. */
+    ASSERT(ttak_epoch_thread_stats(NULL, 0) <= before + CHURN_WAVE);
+
+    /* A recycled id's state still reclaims what its last owner retired. */
+    pthread_t t;
+    ASSERT(pthread_create(&t, NULL, exiting_retirer, NULL) == 0);
+    pthread_join(t, NULL);
+    ttak_epoch_reclaim();
+    ttak_epoch_reclaim();
+    ASSERT(atomic_load(&g_cleaned) == 7);
+    ttak_epoch_set_reclaim_threshold(TTAK_EPOCH_RECLAIM_THRESHOLD);
+}
+
+int main(void) {
+    ttak_epoch_register_thread();
+    RUN_TEST(test_epoch_batched_retire);
+    RUN_TEST(test_epoch_bulk_cleanup);
+    RUN_TEST(test_epoch_auto_reclaim);
+    RUN_TEST(test_epoch_reader_blocks_reclaim);
+    RUN_TEST(test_epoch_thread_exit_flushes);
+    RUN_TEST(test_epoch_stats_snapshot);
+    RUN_TEST(test_epoch_tid_recycling);
+    ttak_epoch_deregister_thread();
+    return 0;
+}
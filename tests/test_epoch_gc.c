@@ -1,7 +1,10 @@
 #include <ttak/mem/epoch_gc.h>
 #include <ttak/mem/mem.h>
 #include <ttak/mem_tree/mem_tree.h>
+#include <ttak/timing/timing.h>
+#include <errno.h>
 #include <stdatomic.h>
+#include <unistd.h>
 #include "test_macros.h"
 
 /**
@@ -47,11 +50,61 @@ static void test_epoch_gc_rotate_cleanup(void) {
     ttak_epoch_gc_rotate(&gc);
 
     /* the pointer was freed during rotation – destroy has nothing left */
+    ttak_epoch_gc_stats_t stats;
+    ttak_epoch_gc_stats_snapshot(&gc, &stats);
+    ASSERT(stats.epoch == 1);
+    ASSERT(stats.rotate_ns.count == 1);
+    ttak_epoch_gc_destroy(&gc);
+}
+
+static void *registered_block(ttak_epoch_gc_t *gc, size_t size, _Bool release) {
+    void *ptr = ttak_mem_alloc_raw(size, __TTAK_UNSAFE_MEM_FOREVER__, 0);
+    ASSERT(ptr != NULL);
+    ttak_epoch_gc_register(gc, ptr, size);
+    if (release) ttak_mem_node_release(ttak_mem_tree_find_node(&gc->tree, ptr));
+    return ptr;
+}
+
+/**
+ * Test: the background reclaimer is woken by registration pressure, not its timer.
+ */
+static void test_epoch_gc_reclaimer_pressure(void) {
+    ttak_epoch_gc_t gc;
+    ttak_epoch_gc_init(&gc);
+
+    /* Intervals far beyond the test's runtime: only pressure can trigger a pass. */
+    ttak_epoch_gc_reclaimer_config_t cfg = {TT_SECOND(30), TT_SECOND(30), 4096, -1};
+    ASSERT(ttak_epoch_gc_start_reclaimer(&gc, &cfg) == 0);
+    ASSERT(ttak_epoch_gc_start_reclaimer(&gc, &cfg) == EALREADY);
+
+    ttak_epoch_gc_stats_t stats;
+    for (int i = 0; i < 2000; ++i) {
+        ttak_epoch_gc_stats_snapshot(&gc, &stats);
+        if (stats.epoch >= 1) break;
+        usleep(1000);
+    }
+    ASSERT(stats.epoch == 1); /* The pass made on startup. */
+
+    void *victim = registered_block(&gc, 2048, 1);
+    ttak_epoch_gc_stats_snapshot(&gc, &stats);
+    ASSERT(stats.epoch == 1);
+    registered_block(&gc, 2048, 0); /* Crosses the 4096-byte threshold. */
+
+    int waited = 0;
+    while (ttak_mem_tree_find_node(&gc.tree, victim) != NULL) {
+        ASSERT(++waited < 2000);
+        usleep(1000);
+    }
+    ttak_epoch_gc_stats_snapshot(&gc, &stats);
+    ASSERT(stats.epoch == 2);
+
+    ttak_epoch_gc_stop_reclaimer(&gc);
     ttak_epoch_gc_destroy(&gc);
 }
 
 int main(void) {
     RUN_TEST(test_epoch_gc_register_and_destroy);
     RUN_TEST(test_epoch_gc_rotate_cleanup);
+    RUN_TEST(test_epoch_gc_reclaimer_pressure);
     return 0;
 }
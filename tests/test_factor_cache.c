@@ -0,0 +1,160 @@
+#include <ttak/math/factor_cache.h>
+#include <ttak/math/sum_divisors.h>
+#include <ttak/timing/timing.h>
+#include "test_macros.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/* Checks the cached aliquot step of @p value against the uncached one. */
+static void check_step(ttak_factor_cache_t *cache, uint64_t value) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_bigint_t n, got, want;
+    ttak_bigint_init_u64(&n, value, now);
+    ttak_bigint_init(&got, now);
+    ttak_bigint_init(&want, now);
+    ASSERT(ttak_factor_cache_sum_proper_divisors(cache, &n, &got, now));
+    ASSERT(ttak_sum_proper_divisors_big(&n, &want, now));
+    ASSERT_MSG(ttak_bigint_cmp(&got, &want) == 0, "s(%llu) mismatch", (unsigned long long)value);
+    ttak_bigint_free(&n, now);
+    ttak_bigint_free(&got, now);
+    ttak_bigint_free(&want, now);
+}
+
+void test_factor_cache_hits_repeat_values() {
+    uint64_t now = ttak_get_tick_count();
+    ttak_factor_cache_t *cache = ttak_factor_cache_create(256, NULL, now);
+    ASSERT(cache != NULL);
+    for (int round = 0; round < 2; ++round) {
+        for (uint64_t i = 2; i < 100; ++i) check_step(cache, mix(i) >> 8);
+    }
+    ttak_factor_cache_stats_t stats;
+    ttak_factor_cache_get_stats(cache, &stats);
+    ASSERT(stats.misses == 98 && stats.hits == 98 && stats.evictions == 0);
+
+    ttak_u128_t sigma;
+    ASSERT(ttak_factor_cache_sigma_u64(cache, 1ULL << 63, &sigma, now));
+    ASSERT(sigma.hi == 0 && sigma.lo == UINT64_MAX);
+    ASSERT(!ttak_factor_cache_sigma_u64(cache, 1, &sigma, now));
+
+    /* (2^64 + 1) = 274177 * 67280421310721, so sigma = 274178 * 67280421310722. */
+    ttak_u256_t sigma256;
+    ASSERT(ttak_factor_cache_sigma_u128(cache, ttak_u128_make(1, 1), &sigma256, now));
+    ttak_u128_t expect = ttak_u128_mul64(274178ULL, 67280421310722ULL);
+    ASSERT(sigma256.limb[0] == expect.lo && sigma256.limb[1] == expect.hi);
+    ASSERT(sigma256.limb[2] == 0 && sigma256.limb[3] == 0);
+
+    ttak_bigint_t n;
+    ttak_bigint_init(&n, now);
+    ASSERT(ttak_bigint_set_u128(&n, ttak_u128_make(1, 1), now));
+    ttak_prime_factor_big_t *factors = NULL;
+    size_t count = 0;
+    ASSERT(ttak_factor_cache_get(cache, &n, &factors, &count, NULL, now));
+    ASSERT(count == 2 && factors[0].a == 1 && factors[1].a == 1);
+    ASSERT(ttak_bigint_cmp_u64(&factors[0].p, 274177ULL) == 0 ||
+           ttak_bigint_cmp_u64(&factors[1].p, 274177ULL) == 0);
+    ttak_factor_cache_free_factors(factors, count, now);
+    ttak_bigint_free(&n, now);
+    ttak_factor_cache_destroy(cache, now);
+}
+
+void test_factor_cache_evicts_when_full() {
+    uint64_t now = ttak_get_tick_count();
+    ttak_factor_cache_t *cache = ttak_factor_cache_create(TTAK_FACTOR_CACHE_SHARDS, NULL, now);
+    ASSERT(cache != NULL);
+    for (uint64_t i = 0; i < 300; ++i) check_step(cache, 1000000 + i);
+    for (uint64_t i = 0; i < 300; ++i) check_step(cache, 1000000 + 3 * i);
+    ttak_factor_cache_stats_t stats;
+    ttak_factor_cache_get_stats(cache, &stats);
+    ASSERT(stats.resident <= TTAK_FACTOR_CACHE_SHARDS);
+    ASSERT(stats.evictions > 0);
+    ASSERT(stats.hits + stats.misses == 600);
+    ttak_factor_cache_destroy(cache, now);
+}
+
+void test_factor_cache_store_survives_reopen() {
+    char path[] = "/tmp/ttak_factor_cache_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    close(fd);
+    uint64_t now = ttak_get_tick_count();
+
+    /* Too small to hold them all: evicted entries come back from the file. */
+    ttak_factor_cache_t *cache = ttak_factor_cache_create(TTAK_FACTOR_CACHE_SHARDS, path, now);
+    ASSERT(cache != NULL);
+    for (uint64_t i = 2; i < 80; ++i) check_step(cache, mix(i) >> 4);
+    for (uint64_t i = 2; i < 80; ++i) check_step(cache, mix(i) >> 4);
+    ttak_factor_cache_stats_t stats;
+    ttak_factor_cache_get_stats(cache, &stats);
+    ASSERT(stats.misses == 78 && stats.stored == 78);
+    ASSERT(stats.store_hits > 0);
+    ttak_factor_cache_destroy(cache, now);
+
+    /* A torn record at the tail is dropped on open. */
+    fd = open(path, O_WRONLY | O_APPEND);
+    ASSERT(fd >= 0);
+    static const uint8_t torn[12] = { 0x40, 0, 0, 0, 1 };
+    ASSERT(write(fd, torn, sizeof(torn)) == (ssize_t)sizeof(torn));
+    close(fd);
+
+    cache = ttak_factor_cache_create(1024, path, now);
+    ASSERT(cache != NULL);
+    for (uint64_t i = 2; i < 80; ++i) check_step(cache, mix(i) >> 4);
+    check_step(cache, 600851475143ULL);
+    ttak_factor_cache_get_stats(cache, &stats);
+    ASSERT(stats.misses == 1 && stats.store_hits == 78 && stats.stored == 79);
+    ttak_factor_cache_destroy(cache, now);
+
+    cache = ttak_factor_cache_create(1024, path, now);
+    ASSERT(cache != NULL);
+    check_step(cache, 600851475143ULL);
+    ttak_factor_cache_get_stats(cache, &stats);
+    ASSERT(stats.misses == 0 && stats.store_hits == 1);
+    ttak_factor_cache_destroy(cache, now);
+    unlink(path);
+}
+
+typedef struct {
+    ttak_factor_cache_t *cache;
+    uint64_t offset;
+} cache_worker_t;
+
+static void *cache_worker(void *arg) {
+    cache_worker_t *w = arg;
+    for (uint64_t i = 0; i < 400; ++i) check_step(w->cache, 5000 + (i + w->offset) % 200);
+    return NULL;
+}
+
+void test_factor_cache_concurrent_lookups() {
+    uint64_t now = ttak_get_tick_count();
+    ttak_factor_cache_t *cache = ttak_factor_cache_create(128, NULL, now);
+    ASSERT(cache != NULL);
+    pthread_t threads[4];
+    cache_worker_t workers[4];
+    for (int i = 0; i < 4; ++i) {
+        workers[i] = (cache_worker_t){ cache, (uint64_t)i * 37 };
+        ASSERT(pthread_create(&threads[i], NULL, cache_worker, &workers[i]) == 0);
+    }
+    for (int i = 0; i < 4; ++i) pthread_join(threads[i], NULL);
+    ttak_factor_cache_stats_t stats;
+    ttak_factor_cache_get_stats(cache, &stats);
+    ASSERT(stats.hits + stats.misses == 1600);
+    ttak_factor_cache_destroy(cache, now);
+}
+
+int main() {
+    RUN_TEST(test_factor_cache_hits_repeat_values);
+    RUN_TEST(test_factor_cache_evicts_when_full);
+    RUN_TEST(test_factor_cache_store_survives_reopen);
+    RUN_TEST(test_factor_cache_concurrent_lookups);
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <ttak/mem/hazard.h>
+#include <ttak/shared/shared.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+typedef struct {
+    int value;
+    _Atomic int freed;
+} hazard_obj_t;
+
+static atomic_size_t g_freed;
+
+static void obj_cleanup(void *ptr) {
+    hazard_obj_t *obj = (hazard_obj_t *)ptr;
+    ASSERT(atomic_exchange(&obj->freed, 1) == 0);
+    atomic_fetch_add(&g_freed, 1);
+}
+
+static void obj_free_cleanup(void *ptr) {
+    obj_cleanup(ptr);
+    free(ptr);
+}
+
+static hazard_obj_t *obj_new(int value) {
+    hazard_obj_t *obj = (hazard_obj_t *)calloc(1, sizeof(hazard_obj_t));
+    ASSERT(obj != NULL);
+    obj->value = value;
+    return obj;
+}
+
+static void test_hazard_protect_blocks_free(void) {
+    atomic_store(&g_freed, 0);
+    static void * _Atomic slot;
+    hazard_obj_t *obj = obj_new(1);
+    atomic_store(&slot, obj);
+
+    ASSERT(ttak_hazard_protect(&slot) == obj);
+    atomic_store(&slot, NULL);
+    ttak_hazard_retire(obj, obj_cleanup);
+    ttak_hazard_scan();
+    ASSERT(atomic_load(&g_freed) == 0);
+    ASSERT(ttak_hazard_pending() == 1);
+
+    ttak_hazard_release();
+    ttak_hazard_scan();
+    ASSERT(atomic_load(&g_freed) == 1);
+    ASSERT(ttak_hazard_pending() == 0);
+    free(obj);
+}
+
+static void * _Atomic g_current;
+static atomic_int g_reader_state;
+static hazard_obj_t *g_pinned;
+
+static void *stalled_reader(void *arg) {
+    (void)arg;
+    g_pinned = (hazard_obj_t *)ttak_hazard_protect(&g_current);
+    atomic_store(&g_reader_state, 1);
+    while (atomic_load(&g_reader_state) != 2) { }
+    /* Still readable after thousands of retirements. */
+    ASSERT(g_pinned->value == 0 && atomic_load(&g_pinned->freed) == 0);
+    ttak_hazard_release();
+    return NULL;
+}
+
+static void test_hazard_stalled_reader_is_bounded(void) {
+    atomic_store(&g_freed, 0);
+    atomic_store(&g_reader_state, 0);
+    atomic_store(&g_current, obj_new(0));
+
+    pthread_t reader;
+    ASSERT(pthread_create(&reader, NULL, stalled_reader, NULL) == 0);
+    while (atomic_load(&g_reader_state) != 1) { }
+
+    enum { SWAPS = 20000 };
+    size_t peak = 0;
+    for (int i = 1; i <= SWAPS; ++i) {
+        void *old = atomic_exchange(&g_current, obj_new(i));
+        ttak_hazard_retire(old, obj_free_cleanup);
+        size_t pending = ttak_hazard_pending();
+        if (pending > peak) peak = pending;
+    }
+    /* Unlike EBR, one stalled reader pins only what it protects. */
+    ASSERT(peak <= 4 * TTAK_HAZARD_SCAN_MIN);
+    ASSERT(atomic_load(&g_freed) >= SWAPS - peak);
+    ASSERT(atomic_load(&g_pinned->freed) == 0);
+
+    atomic_store(&g_reader_state, 2);
+    pthread_join(reader, NULL);
+    ttak_hazard_scan();
+    ASSERT(ttak_hazard_pending() == 0);
+    ASSERT(atomic_load(&g_freed) == SWAPS);
+}
+
+static void *exiting_retirer(void *arg) {
+    ttak_hazard_retire(arg, obj_cleanup);
+    return NULL; /* Exit hands the retirement over as an orphan. */
+}
+
+static void test_hazard_thread_exit_orphans(void) {
+    atomic_store(&g_freed, 0);
+    static void * _Atomic slot;
+    hazard_obj_t *obj = obj_new(7);
+    atomic_store(&slot, obj);
+    ASSERT(ttak_hazard_protect(&slot) == obj);
+
+    pthread_t t;
+    ASSERT(pthread_create(&t, NULL, exiting_retirer, obj) == 0);
+    pthread_join(t, NULL);
+    ASSERT(atomic_load(&g_freed) == 0);
+
+    ttak_hazard_release();
+    ttak_hazard_scan();
+    ASSERT(atomic_load(&g_freed) == 1);
+    free(obj);
+}
+
+static ttak_shared_t g_hz_shared;
+
+static void *shared_stalled_reader(void *arg) {
+    (void)arg;
+    ttak_shared_result_t res;
+    const int *data = g_hz_shared.access_ebr(&g_hz_shared, NULL, true, &res);
+    ASSERT(data != NULL);
+    int seen = *data;
+    atomic_store(&g_reader_state, 1);
+    while (atomic_load(&g_reader_state) != 2) { }
+    /* The payload this reader holds survives every swap made meanwhile. */
+    ASSERT(*data == seen);
+    g_hz_shared.release_ebr(&g_hz_shared);
+    return NULL;
+}
+
+static void test_hazard_shared_mode(void) {
+    ttak_shared_init(&g_hz_shared);
+    ASSERT(g_hz_shared.set_reclaim_mode(&g_hz_shared, TTAK_RECLAIM_HAZARD) == TTAK_OWNER_SUCCESS);
+    ASSERT(g_hz_shared.allocate(&g_hz_shared, sizeof(int), TTAK_SHARED_NO_LEVEL) == TTAK_OWNER_SUCCESS);
+
+    atomic_store(&g_reader_state, 0);
+    pthread_t reader;
+    ASSERT(pthread_create(&reader, NULL, shared_stalled_reader, NULL) == 0);
+    while (atomic_load(&g_reader_state) != 1) { }
+
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT(ttak_shared_swap_ebr(&g_hz_shared, &i, sizeof(i)) == TTAK_OWNER_SUCCESS);
+        /* A stalled reader no longer lets retired payloads pile up. */
+        ASSERT(ttak_hazard_pending() <= 4 * TTAK_HAZARD_SCAN_MIN);
+    }
+
+    atomic_store(&g_reader_state, 2);
+    pthread_join(reader, NULL);
+    ttak_hazard_scan();
+    ASSERT(ttak_hazard_pending() == 0);
+    ttak_shared_destroy(&g_hz_shared);
+}
+
+int main(void) {
+    RUN_TEST(test_hazard_protect_blocks_free);
+    RUN_TEST(test_hazard_stalled_reader_is_bounded);
+    RUN_TEST(test_hazard_thread_exit_orphans);
+    RUN_TEST(test_hazard_shared_mode);
+    return 0;
+}
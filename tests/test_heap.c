@@ -0,0 +1,100 @@
+#include <ttak/priority/heap.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+#define HEAP_CAP 4096
+
+static uint64_t rng_state = 0x2545F4914F6CDD1DULL;
+
+static uint64_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void test_dheap_order_and_capacity(void) {
+    ttak_dheap_t heap;
+    ASSERT(!ttak_dheap_init(&heap, 0));
+    ASSERT(ttak_dheap_init(&heap, HEAP_CAP));
+    /* Each sibling group starts a cache line. */
+    ASSERT(((uintptr_t)&heap.entries[1] & 63) == 0);
+    ASSERT(!ttak_dheap_pop(&heap, NULL, NULL));
+
+    for (uint32_t i = 0; i < HEAP_CAP; i++) {
+        uint64_t key = rng() % 1000;
+        ASSERT(ttak_dheap_push(&heap, key, (uintptr_t)key * 2) != TTAK_DHEAP_NONE);
+    }
+    ASSERT(ttak_dheap_push(&heap, 1, 1) == TTAK_DHEAP_NONE);
+
+    uint64_t prev = 0, key;
+    uintptr_t payload;
+    for (uint32_t i = 0; i < HEAP_CAP; i++) {
+        ASSERT(ttak_dheap_pop(&heap, &key, &payload));
+        ASSERT(key >= prev && payload == key * 2);
+        prev = key;
+    }
+    ASSERT(heap.size == 0);
+    /* Every handle came back to the free list. */
+    for (uint32_t i = 0; i < HEAP_CAP; i++) ASSERT(ttak_dheap_push(&heap, i, i) != TTAK_DHEAP_NONE);
+    ttak_dheap_destroy(&heap);
+}
+
+static uint64_t ref_key[HEAP_CAP];
+static bool ref_live[HEAP_CAP];
+
+/* Random pushes, re-keys and removals, checked against a flat array. */
+static void test_dheap_handles(void) {
+    ttak_dheap_t heap;
+    ASSERT(ttak_dheap_init(&heap, HEAP_CAP));
+    for (int step = 0; step < 200000; step++) {
+        uint32_t op = (uint32_t)(rng() % 8);
+        uint32_t h = (uint32_t)(rng() % HEAP_CAP);
+        if (op < 3) {
+            uint64_t key = rng() % 100000;
+            bool full = heap.size == HEAP_CAP;
+            uint32_t got = ttak_dheap_push(&heap, key, key + 7);
+            ASSERT((got == TTAK_DHEAP_NONE) == full);
+            if (got != TTAK_DHEAP_NONE) {
+                ASSERT(!ref_live[got]);
+                ref_live[got] = true;
+                ref_key[got] = key;
+            }
+        } else if (op < 5) {
+            uint64_t key = rng() % 100000;
+            ASSERT(ttak_dheap_update(&heap, h, key) == ref_live[h]);
+            if (ref_live[h]) ref_key[h] = key;
+        } else if (op < 6) {
+            uintptr_t payload = 0;
+            ASSERT(ttak_dheap_remove(&heap, h, &payload) == ref_live[h]);
+            ref_live[h] = false;
+        } else {
+            uint64_t min = UINT64_MAX;
+            for (uint32_t i = 0; i < HEAP_CAP; i++) {
+                if (ref_live[i] && ref_key[i] < min) min = ref_key[i];
+            }
+            uint64_t key;
+            if (min == UINT64_MAX) {
+                ASSERT(!ttak_dheap_peek(&heap, &key, NULL));
+                continue;
+            }
+            uint32_t top = heap.handles[0];
+            ASSERT(ttak_dheap_pop(&heap, &key, NULL) && key == min && ref_key[top] == min);
+            ref_live[top] = false;
+        }
+    }
+    uint32_t live = 0;
+    for (uint32_t i = 0; i < HEAP_CAP; i++) {
+        live += ref_live[i];
+        ASSERT(ttak_dheap_contains(&heap, i) == ref_live[i]);
+    }
+    ASSERT(heap.size == live);
+    ttak_dheap_destroy(&heap);
+}
+
+int main(void) {
+    RUN_TEST(test_dheap_order_and_capacity);
+    RUN_TEST(test_dheap_handles);
+    return 0;
+}
@@ -1,4 +1,7 @@
 #include <ttak/ht/map.h>
+#include <ttak/ht/hash.h>
+#include <ttak/ht/wyhash.h>
+#include <string.h>
 #include "test_macros.h"
 
 void test_map_basic() {
@@ -17,7 +20,103 @@ void test_map_basic() {
     // For now, we assume it might be leaked or we need to find the destroy function.
 }
 
+void test_map_grow_and_churn(void) {
+    uint64_t now = 500;
+    tt_map_t *map = ttak_create_map(16, now);
+    ASSERT(map != NULL);
+
+    for (uintptr_t k = 1; k <= 20000; k++) ttak_insert_to_map(map, k * 7919, (size_t)k, now);
+    ASSERT(map->size == 20000);
+    for (uintptr_t k = 1; k <= 20000; k++) {
+        size_t v = 0;
+        ASSERT(ttak_map_get_key(map, k * 7919, &v, now));
+        ASSERT(v == (size_t)k);
+    }
+    ASSERT(!ttak_map_get_key(map, 3, NULL, now));
+
+    /* Delete and reinsert repeatedly; tombstones must not exhaust the map. */
+    size_t cap = map->cap;
+    for (int round = 0; round < 20; round++) {
+        for (uintptr_t k = 1; k <= 20000; k += 2) ttak_delete_from_map(map, k * 7919, now);
+        for (uintptr_t k = 1; k <= 20000; k += 2) ttak_insert_to_map(map, k * 7919 + (uintptr_t)round + 1, (size_t)k, now);
+        for (uintptr_t k = 1; k <= 20000; k += 2) ttak_delete_from_map(map, k * 7919 + (uintptr_t)round + 1, now);
+        for (uintptr_t k = 1; k <= 20000; k += 2) ttak_insert_to_map(map, k * 7919, (size_t)k, now);
+    }
+    ASSERT(map->size == 20000);
+    ASSERT(map->cap <= cap * 2);
+    for (uintptr_t k = 1; k <= 20000; k++) {
+        size_t v = 0;
+        ASSERT(ttak_map_get_key(map, k * 7919, &v, now));
+        ASSERT(v == (size_t)k);
+    }
+    ttak_destroy_map(map);
+}
+
+static void test_map_get_batch(void) {
+    uint64_t now = 1000;
+    tt_map_t *map = ttak_create_map(8, now);
+    ASSERT(map != NULL);
+    for (uintptr_t k = 1; k <= 5000; k++) ttak_insert_to_map(map, k * 31, (size_t)k, now);
+
+    /* Even keys are present, odd ones are not; 77 spans windows unevenly. */
+    uintptr_t keys[77];
+    size_t out[77];
+    _Bool found[77];
+    for (int i = 0; i < 77; i++) keys[i] = (uintptr_t)(i + 1) * 31 + (uintptr_t)(i % 2);
+    ASSERT(ttak_map_get_batch(map, keys, 77, out, found, now) == 39);
+    for (int i = 0; i < 77; i++) {
+        size_t v = 0;
+        _Bool hit = ttak_map_get_key(map, keys[i], &v, now);
+        ASSERT(found[i] == hit);
+        ASSERT(out[i] == (hit ? v : 0));
+    }
+    ASSERT(ttak_map_get_batch(map, keys, 77, out, NULL, now) == 39);
+    ttak_destroy_map(map);
+}
+
+static void test_hash_bytes_batch(void) {
+    static uint8_t buf[64][300];
+    const void *keys[64];
+    size_t lens[64];
+    uint64_t out[64];
+    for (int i = 0; i < 64; i++) {
+        for (int j = 0; j < 300; j++) buf[i][j] = (uint8_t)(i * 31 + j * 7);
+        keys[i] = buf[i];
+        lens[i] = (size_t)i * 5;
+    }
+    ttak_hash_bytes_batch(keys, lens, 63, 42, out);
+    for (int i = 0; i < 63; i++) {
+        ASSERT(out[i] == ttak_hash_bytes(keys[i], lens[i], 42));
+        if (lens[i] < TTAK_HASH_AES_MIN_LEN) ASSERT(out[i] == ttak_wyhash(keys[i], lens[i], 42));
+    }
+
+    uint64_t ukeys[37], uout[37];
+    for (int i = 0; i < 37; i++) ukeys[i] = (uint64_t)i * 0x9e3779b97f4a7c15ULL;
+    ttak_hash_u64_batch(ukeys, 37, 7, uout);
+    for (int i = 0; i < 37; i++) ASSERT(uout[i] == ttak_hash_u64(ukeys[i], 7));
+    ASSERT(ttak_hash_kernel_name() != NULL);
+}
+
+static void test_hash_bytes_long_keys(void) {
+    uint8_t key[257];
+    memset(key, 0x5a, sizeof(key));
+    uint64_t base = ttak_hash_bytes(key, sizeof(key), 1);
+    ASSERT(base == ttak_hash_bytes(key, sizeof(key), 1));
+    ASSERT(base != ttak_hash_bytes(key, sizeof(key), 2));
+    ASSERT(base != ttak_hash_bytes(key, sizeof(key) - 1, 1));
+    /* Every single-bit flip must change the hash, including in the overlapping tail. */
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] ^= 0x10;
+        ASSERT(ttak_hash_bytes(key, sizeof(key), 1) != base);
+        key[i] ^= 0x10;
+    }
+}
+
 int main() {
     RUN_TEST(test_map_basic);
+    RUN_TEST(test_map_grow_and_churn);
+    RUN_TEST(test_map_get_batch);
+    RUN_TEST(test_hash_bytes_batch);
+    RUN_TEST(test_hash_bytes_long_keys);
     return 0;
 }
@@ -0,0 +1,76 @@
+#include <ttak/ht/snapshot.h>
+#include <ttak/ht/map.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static char snap_path[64];
+
+static void test_snapshot_round_trip(void) {
+    uint64_t now = 1000;
+    tt_map_t *map = ttak_create_map(16, now);
+    ASSERT(map != NULL);
+    for (uintptr_t k = 1; k <= 30000; k++) ttak_insert_to_map(map, k * 7919, (size_t)k * 3, now);
+    for (uintptr_t k = 1; k <= 30000; k += 5) ttak_delete_from_map(map, k * 7919, now);
+    ASSERT(ttak_map_snapshot_write(map, snap_path) == 0);
+
+    ttak_map_snapshot_t *snap = ttak_map_snapshot_open(snap_path, now);
+    ASSERT(snap != NULL);
+    ASSERT(snap->map->size == map->size);
+    ASSERT(snap->map->cap == map->cap);
+    for (uintptr_t k = 1; k <= 30000; k++) {
+        size_t v = 0;
+        _Bool hit = ttak_map_get_key(snap->map, k * 7919, &v, now);
+        ASSERT(hit == ((k - 1) % 5 != 0));
+        if (hit) ASSERT(v == (size_t)k * 3);
+    }
+    uintptr_t keys[3] = { 2 * 7919, 6 * 7919, 12345 };
+    size_t out[3];
+    ASSERT(ttak_map_get_batch(snap->map, keys, 3, out, NULL, now) == 1);
+    ASSERT(out[0] == 6);
+
+    /* Rewriting replaces the file; the open mapping keeps the old contents. */
+    ttak_insert_to_map(map, 6 * 7919, 99, now);
+    ASSERT(ttak_map_snapshot_write(map, snap_path) == 0);
+    size_t v = 0;
+    ASSERT(!ttak_map_get_key(snap->map, 6 * 7919, &v, now));
+    ttak_map_snapshot_close(snap);
+
+    snap = ttak_map_snapshot_open(snap_path, now);
+    ASSERT(snap != NULL);
+    ASSERT(ttak_map_get_key(snap->map, 6 * 7919, &v, now) && v == 99);
+    ttak_map_snapshot_close(snap);
+    ttak_destroy_map(map);
+}
+
+static void test_snapshot_rejects_bad_files(void) {
+    uint64_t now = 1000;
+    tt_map_t *map = ttak_create_map(16, now);
+    for (uintptr_t k = 1; k <= 100; k++) ttak_insert_to_map(map, k, (size_t)k, now);
+    ASSERT(ttak_map_snapshot_write(map, snap_path) == 0);
+    ttak_destroy_map(map);
+
+    /* Flip the stored capacity; the header check must catch it. */
+    FILE *f = fopen(snap_path, "r+b");
+    ASSERT(f != NULL);
+    uint64_t cap = 1u << 20;
+    fseek(f, (long)offsetof(ttak_map_snapshot_header_t, cap), SEEK_SET);
+    fwrite(&cap, sizeof(cap), 1, f);
+    fclose(f);
+    ASSERT(ttak_map_snapshot_open(snap_path, now) == NULL);
+
+    /* Truncated file. */
+    ASSERT(truncate(snap_path, 100) == 0);
+    ASSERT(ttak_map_snapshot_open(snap_path, now) == NULL);
+    unlink(snap_path);
+    ASSERT(ttak_map_snapshot_open(snap_path, now) == NULL);
+}
+
+int main(void) {
+    snprintf(snap_path, sizeof(snap_path), "/tmp/ttak_snap_%d.bin", (int)getpid());
+    RUN_TEST(test_snapshot_round_trip);
+    RUN_TEST(test_snapshot_rejects_bad_files);
+    unlink(snap_path);
+    return 0;
+}
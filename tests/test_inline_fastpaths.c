@@ -0,0 +1,145 @@
+#define TTAK_INLINE_FASTPATHS 1
+#include <ttak/container/ringbuf.h>
+#include <ttak/container/pool.h>
+#include <ttak/ht/map.h>
+#include <ttak/limit/limit.h>
+#include <ttak/stats/stats.h>
+#include <ttak/timing/timing.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_macros.h"
+
+static void test_inline_ringbuf(void) {
+    ttak_ringbuf_t *rb = ttak_ringbuf_create_ex(64, sizeof(uint64_t), TTAK_RINGBUF_SPSC);
+    ASSERT(rb != NULL);
+    // Fast and out-of-line calls share the ring and its cached views.
+    for (uint64_t i = 0; i < 64; i++) {
+        ASSERT((i & 1) ? ttak_ringbuf_push(rb, &i) : (ttak_ringbuf_push)(rb, &i));
+    }
+    uint64_t v = 99;
+    ASSERT(!ttak_ringbuf_push(rb, &v));
+    for (uint64_t i = 0; i < 64; i++) {
+        ASSERT(((i & 2) ? ttak_ringbuf_pop(rb, &v) : (ttak_ringbuf_pop)(rb, &v)) && v == i);
+    }
+    ASSERT(!ttak_ringbuf_pop(rb, &v));
+    for (uint64_t i = 0; i < 1000; i++) {
+        ASSERT(ttak_ringbuf_push(rb, &i) && ttak_ringbuf_pop(rb, &v) && v == i);
+    }
+    ttak_ringbuf_destroy(rb);
+
+    // Other modes always take the library path.
+    rb = ttak_ringbuf_create(4, sizeof(uint64_t));
+    ASSERT(rb != NULL);
+    for (uint64_t i = 0; i < 4; i++) ASSERT(ttak_ringbuf_push(rb, &i));
+    ASSERT(!ttak_ringbuf_push(rb, &v));
+    for (uint64_t i = 0; i < 4; i++) ASSERT(ttak_ringbuf_pop(rb, &v) && v == i);
+    ttak_ringbuf_destroy(rb);
+}
+
+static void test_inline_map(void) {
+    uint64_t now = ttak_get_tick_count();
+    tt_map_t *map = ttak_create_map(16, now);
+    ASSERT(map != NULL);
+    for (uintptr_t k = 1; k <= 5000; k++) ttak_insert_to_map(map, k * 31, (size_t)k, now);
+    for (uintptr_t k = 1; k <= 5000; k++) {
+        size_t a = 0, b = 0;
+        ASSERT(ttak_map_get_key(map, k * 31, &a, now) && a == k);
+        ASSERT((ttak_map_get_key)(map, k * 31, &b, now) && b == a);
+    }
+    ASSERT(!ttak_map_get_key(map, 7, NULL, now));
+    ttak_delete_from_map(map, 31, now);
+    ASSERT(!ttak_map_get_key(map, 31, NULL, now));
+    ttak_destroy_map(map);
+}
+
+typedef struct {
+    ttak_object_pool_t *pool;
+    int bad;
+} pool_arg_t;
+
+static void *pool_worker(void *p) {
+    pool_arg_t *a = p;
+    void *held[100];
+    for (int round = 0; round < 200; round++) {
+        for (int i = 0; i < 100; i++) {
+            held[i] = ttak_object_pool_alloc(a->pool);
+            if (!held[i]) { a->bad = 1; return NULL; }
+            memset(held[i], round & 0xff, 48);
+        }
+        for (int i = 0; i < 100; i++) {
+            if (((unsigned char *)held[i])[47] != (round & 0xff)) a->bad = 1;
+            ttak_object_pool_free(a->pool, held[i]);
+        }
+    }
+    return NULL;
+}
+
+static void test_inline_pool(void) {
+    ttak_object_pool_t *pool = ttak_object_pool_create(64, 48);
+    ASSERT(pool != NULL);
+    // The first call binds the thread's magazine through the library.
+    void *a = ttak_object_pool_alloc(pool);
+    void *b = ttak_object_pool_alloc(pool);
+    ASSERT(a && b && a != b);
+    ttak_object_pool_free(pool, a);
+    ASSERT(ttak_object_pool_alloc(pool) == a);
+    ttak_object_pool_free(pool, b);
+    ttak_object_pool_free(pool, a);
+    ttak_object_pool_free(pool, a);
+
+    pool_arg_t args[4];
+    pthread_t t[4];
+    for (int i = 0; i < 4; i++) {
+        args[i] = (pool_arg_t){ pool, 0 };
+        ASSERT(pthread_create(&t[i], NULL, pool_worker, &args[i]) == 0);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(t[i], NULL);
+        ASSERT(!args[i].bad);
+    }
+    ttak_object_pool_destroy(pool);
+}
+
+static void test_inline_stats(void) {
+    ttak_stats_t *s = malloc(sizeof(*s));
+    ASSERT(s != NULL);
+    ttak_stats_init(s, 0, 1000);
+    for (uint64_t v = 1; v <= 1000; v++) {
+        if (v & 1) ttak_stats_record(s, v);
+        else (ttak_stats_record)(s, v);
+    }
+    ttak_stats_snapshot_t snap;
+    ttak_stats_snapshot(s, &snap);
+    ASSERT(snap.count == 1000 && snap.sum == 500500 && snap.min == 1 && snap.max == 1000);
+    uint64_t in_buckets = 0;
+    for (size_t i = 0; i < TTAK_STATS_HIST_BUCKETS; i++) in_buckets += snap.histogram[i];
+    ASSERT(in_buckets == 1000);
+    ASSERT(ttak_stats_bucket_of(12345) == ttak_stats_bucket_index(12345));
+    free(s);
+}
+
+static void test_inline_token_bucket(void) {
+    ttak_token_bucket_t tb;
+    // A negligible rate: the burst is all there is.
+    ttak_token_bucket_init(&tb, 1e-6, 10.0);
+    int taken = 0;
+    for (int i = 0; i < 20; i++) taken += ttak_token_bucket_consume(&tb, 1.0);
+    ASSERT(taken == 10);
+    ASSERT(!ttak_token_bucket_consume(&tb, 0.5));
+
+    ttak_ratelimit_t rl;
+    ttak_ratelimit_init(&rl, 1e-6, 3.0);
+    ASSERT(ttak_ratelimit_allow(&rl) && ttak_ratelimit_allow(&rl) && ttak_ratelimit_allow(&rl));
+    ASSERT(!ttak_ratelimit_allow(&rl));
+    ASSERT(ttak_tokens_to_nanotokens(1.5) == 1500000000ULL && ttak_tokens_to_nanotokens(-1.0) == 0);
+}
+
+int main(void) {
+    RUN_TEST(test_inline_ringbuf);
+    RUN_TEST(test_inline_map);
+    RUN_TEST(test_inline_pool);
+    RUN_TEST(test_inline_stats);
+    RUN_TEST(test_inline_token_bucket);
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <ttak/io/chain.h>
+#include <ttak/timing/timing.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static int chain_equals(const ttak_io_chain_t *chain, const char *text) {
+    char buf[256];
+    size_t n = strlen(text);
+    if (chain->len != n) return 0;
+    return ttak_io_chain_copyout(chain, 0, buf, sizeof(buf)) == n && memcmp(buf, text, n) == 0;
+}
+
+static void test_chain_append_and_slice(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_io_chain_t a;
+    ttak_io_chain_init(&a, NULL);
+    ASSERT(ttak_io_chain_append(&a, "hello ", 6, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_chain_append(&a, "world", 5, now) == TTAK_IO_SUCCESS);
+    // Small appends fill the tail block instead of adding segments.
+    ASSERT(a.count == 1 && chain_equals(&a, "hello world"));
+
+    uint8_t *hdr = ttak_io_chain_reserve(&a, 2, now);
+    ASSERT(hdr != NULL);
+    memcpy(hdr, "!!", 2);
+    ASSERT(a.count == 1 && chain_equals(&a, "hello world!!"));
+
+    // A slice shares the block; the owner can no longer append in place.
+    ttak_io_chain_t b;
+    ttak_io_chain_init(&b, NULL);
+    ASSERT(ttak_io_chain_append_slice(&b, &a, 6, 5) == TTAK_IO_SUCCESS);
+    ASSERT(b.count == 1 && b.segs[0].block == a.segs[0].block && chain_equals(&b, "world"));
+    ASSERT(ttak_io_chain_append(&a, "?", 1, now) == TTAK_IO_SUCCESS);
+    ASSERT(a.count == 2 && chain_equals(&a, "hello world!!?"));
+    ASSERT(ttak_io_chain_append_slice(&b, &a, 10, 5) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_io_chain_append_slice(&a, &a, 0, 1) == TTAK_IO_ERR_INVALID_ARGUMENT);
+
+    // Dropping the original leaves the slice intact.
+    ttak_io_chain_destroy(&a);
+    ASSERT(a.len == 0 && a.count == 0);
+    ASSERT(chain_equals(&b, "world"));
+    ttak_io_chain_destroy(&b);
+
+    // Large appends span blocks; many segments outgrow the inline array.
+    static uint8_t big[3 * TTAK_IO_CHAIN_BLOCK_BYTES];
+    for (size_t i = 0; i < sizeof(big); i++) big[i] = (uint8_t)(i * 13U);
+    ttak_io_chain_t c;
+    ttak_io_chain_init(&c, NULL);
+    ttak_io_chain_t pieces;
+    ttak_io_chain_init(&pieces, NULL);
+    ASSERT(ttak_io_chain_append(&pieces, big, sizeof(big), now) == TTAK_IO_SUCCESS);
+    for (size_t off = 0; off < sizeof(big); off += 256) {
+        ASSERT(ttak_io_chain_append_slice(&c, &pieces, off, 128) == TTAK_IO_SUCCESS);
+    }
+    ASSERT(c.count == sizeof(big) / 256 && c.count > TTAK_IO_CHAIN_INLINE_SEGS);
+    uint8_t out[128];
+    ASSERT(ttak_io_chain_copyout(&c, 128 * 5, out, sizeof(out)) == sizeof(out));
+    ASSERT(memcmp(out, big + 256 * 5, sizeof(out)) == 0);
+    ttak_io_chain_destroy(&pieces);
+    ttak_io_chain_destroy(&c);
+}
+
+static void test_chain_split_consume(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_io_chain_t msg;
+    ttak_io_chain_init(&msg, NULL);
+    ttak_io_chain_t body;
+    ttak_io_chain_init(&body, NULL);
+    ASSERT(ttak_io_chain_append(&body, "PAYLOAD", 7, now) == TTAK_IO_SUCCESS);
+
+    ASSERT(ttak_io_chain_append(&msg, "HDR:", 4, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_chain_append_chain(&msg, &body) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_chain_append(&msg, ":END", 4, now) == TTAK_IO_SUCCESS);
+    ASSERT(msg.count == 3 && chain_equals(&msg, "HDR:PAYLOAD:END"));
+
+    // Splitting inside a segment leaves both halves a window into it.
+    ttak_io_chain_t tail;
+    ttak_io_chain_init(&tail, NULL);
+    ASSERT(ttak_io_chain_split(&msg, 6, &tail) == TTAK_IO_SUCCESS);
+    ASSERT(chain_equals(&msg, "HDR:PA") && chain_equals(&tail, "YLOAD:END"));
+    ASSERT(msg.segs[1].block == tail.segs[0].block);
+    ASSERT(ttak_io_chain_split(&msg, 7, &tail) == TTAK_IO_ERR_INVALID_ARGUMENT);
+
+    ttak_io_chain_consume(&tail, 3);
+    ASSERT(chain_equals(&tail, "AD:END") && tail.count == 2);
+    ttak_io_chain_consume(&tail, 3);
+    ASSERT(chain_equals(&tail, "END") && tail.count == 1);
+    ttak_io_chain_consume(&tail, 100);
+    ASSERT(tail.len == 0 && tail.count == 0);
+
+    ttak_io_chain_destroy(&msg);
+    ASSERT(chain_equals(&body, "PAYLOAD"));
+    ttak_io_chain_destroy(&body);
+}
+
+static void test_chain_socket_io(void) {
+    uint64_t now = ttak_get_tick_count();
+    int sv[2];
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+    // A received region becomes a block without a copy.
+    ASSERT(write(sv[1], "received", 8) == 8);
+    ttak_io_zerocopy_region_t region;
+    ttak_io_zerocopy_region_init(&region);
+    ASSERT(ttak_io_zerocopy_recv_fd(sv[0], &region, 64, 0, now) == TTAK_IO_SUCCESS);
+    const uint8_t *rx = region.data;
+    ttak_io_chain_t msg;
+    ttak_io_chain_init(&msg, NULL);
+    ASSERT(ttak_io_chain_append(&msg, "[", 1, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_chain_adopt_region(&msg, &region) == TTAK_IO_SUCCESS);
+    ASSERT(region.data == NULL && region.allocation.data == NULL);
+    ASSERT(ttak_io_chain_append(&msg, "]", 1, now) == TTAK_IO_SUCCESS);
+    ASSERT(msg.count == 3 && msg.segs[1].data == rx);
+
+    struct iovec iov[4];
+    ASSERT(ttak_io_chain_to_iovec(&msg, iov, 4) == 3);
+    ASSERT(iov[1].iov_base == (void *)rx && iov[1].iov_len == 8);
+
+    // One gather send frames the message and empties the chain.
+    size_t sent = 0;
+    ASSERT(ttak_io_chain_send(sv[0], &msg, 0, &sent) == TTAK_IO_SUCCESS);
+    ASSERT(sent == 10 && msg.len == 0);
+    char buf[16];
+    ASSERT(read(sv[1], buf, sizeof(buf)) == 10 && memcmp(buf, "[received]", 10) == 0);
+    ASSERT(ttak_io_chain_send(sv[0], &msg, 0, &sent) == TTAK_IO_SUCCESS && sent == 0);
+
+    ttak_io_chain_destroy(&msg);
+    close(sv[0]);
+    close(sv[1]);
+}
+
+int main(void) {
+    RUN_TEST(test_chain_append_and_slice);
+    RUN_TEST(test_chain_split_consume);
+    RUN_TEST(test_chain_socket_io);
+    return 0;
+}
@@ -0,0 +1,292 @@
+#include <ttak/io/compress.h>
+#include <ttak/mem/owner.h>
+#include <ttak/timing/timing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static uint64_t rng = 88172645463325252ULL;
+
+static uint64_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+}
+
+/* JSONL-like records: compressible, with runs both near and far apart. */
+static size_t fill_ledger(uint8_t *buf, size_t len, uint64_t first) {
+    size_t off = 0;
+    for (uint64_t seed = first; off < len; seed++) {
+        char line[160];
+        int n = snprintf(line, sizeof(line), "{\"seed\":%llu,\"kind\":\"found\",\"steps\":%llu,\"peak\":%llu}\n",
+                         (unsigned long long)seed, (unsigned long long)(seed % 97),
+                         (unsigned long long)(next_rand() % 1000000));
+        size_t take = (size_t)n < len - off ? (size_t)n : len - off;
+        memcpy(buf + off, line, take);
+        off += take;
+    }
+    return len;
+}
+
+static uint8_t *flatten(const ttak_io_chain_t *chain) {
+    uint8_t *flat = malloc(chain->len ? chain->len : 1);
+    ASSERT(flat != NULL);
+    ASSERT(ttak_io_chain_copyout(chain, 0, flat, chain->len) == chain->len);
+    return flat;
+}
+
+static void roundtrip(const uint8_t *src, size_t len, const ttak_io_compress_dict_t *dict) {
+    size_t cap = ttak_io_compress_bound(len);
+    uint8_t *enc = malloc(cap);
+    uint8_t *dec = malloc(len + 1);
+    ASSERT(enc != NULL && dec != NULL);
+    size_t n = ttak_io_compress_block(src, len, enc, cap, dict);
+    ASSERT(n > 0 && n <= cap);
+    size_t got = 0;
+    ASSERT(ttak_io_decompress_block(enc, n, dec, len, dict, &got) == TTAK_IO_SUCCESS);
+    ASSERT(got == len && memcmp(src, dec, len) == 0);
+    if (len > 0) ASSERT(ttak_io_decompress_block(enc, n, dec, len - 1, dict, &got) == TTAK_IO_ERR_RANGE);
+    free(enc);
+    free(dec);
+}
+
+static void test_block_roundtrip(void) {
+    size_t len = 200000;
+    uint8_t *buf = malloc(len);
+    ASSERT(buf != NULL);
+    for (size_t i = 0; i < 40; i++) {
+        buf[i] = (uint8_t)next_rand();
+        roundtrip(buf, i, NULL);
+    }
+
+    memset(buf, 'a', len);
+    roundtrip(buf, len, NULL);
+    uint8_t enc[8192];
+    ASSERT(ttak_io_compress_block(buf, 65536, enc, sizeof(enc), NULL) < 400);
+
+    for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)next_rand();
+    roundtrip(buf, len, NULL);
+    // Random bytes do not shrink, so a tight bound fails instead of overflowing.
+    ASSERT(ttak_io_compress_block(buf, 4096, enc, 4095, NULL) == 0);
+
+    fill_ledger(buf, len, 1);
+    roundtrip(buf, len, NULL);
+    ASSERT(ttak_io_compress_block(buf, 65536, enc, 0, NULL) == 0);
+    free(buf);
+}
+
+static void test_block_rejects_corruption(void) {
+    uint8_t src[16384], enc[20000], dec[16384];
+    fill_ledger(src, sizeof(src), 1000);
+    size_t n = ttak_io_compress_block(src, sizeof(src), enc, sizeof(enc), NULL);
+    ASSERT(n > 0 && n < sizeof(src) / 2);
+    size_t got;
+    ASSERT(ttak_io_decompress_block(enc, n - 1, dec, sizeof(dec), NULL, &got) == TTAK_IO_ERR_RANGE);
+
+    // Flipped bytes must decode to something in bounds or fail; never overrun.
+    uint8_t bad[20000];
+    int failed = 0;
+    for (int round = 0; round < 2000; round++) {
+        memcpy(bad, enc, n);
+        for (int k = 0; k < 3; k++) bad[next_rand() % n] ^= (uint8_t)(1U << (next_rand() % 8));
+        got = 0;
+        ttak_io_status_t st = ttak_io_decompress_block(bad, n, dec, sizeof(dec), NULL, &got);
+        if (st != TTAK_IO_SUCCESS) failed++;
+        else ASSERT(got <= sizeof(dec));
+    }
+    ASSERT(failed > 0);
+}
+
+static void test_dictionary(void) {
+    uint8_t sample[32768], record[512], enc[1024], dec[512];
+    fill_ledger(sample, sizeof(sample), 5000);
+    fill_ledger(record, sizeof(record), 9000);
+    ttak_io_compress_dict_t *dict = ttak_io_compress_dict_create(sample, sizeof(sample));
+    ASSERT(dict != NULL);
+    ASSERT(ttak_io_compress_dict_id(dict) != 0);
+    ASSERT(ttak_io_compress_dict_create(sample, 0) == NULL);
+
+    // A short block compresses far better when primed with typical records.
+    size_t plain = ttak_io_compress_block(record, sizeof(record), enc, sizeof(enc), NULL);
+    size_t primed = ttak_io_compress_block(record, sizeof(record), enc, sizeof(enc), dict);
+    ASSERT(plain > 0 && primed > 0 && primed < plain);
+    size_t got = 0;
+    ASSERT(ttak_io_decompress_block(enc, primed, dec, sizeof(dec), dict, &got) == TTAK_IO_SUCCESS);
+    ASSERT(got == sizeof(record) && memcmp(dec, record, got) == 0);
+    // Without the dictionary the back-references point before the output.
+    ASSERT(ttak_io_decompress_block(enc, primed, dec, sizeof(dec), NULL, &got) == TTAK_IO_ERR_RANGE);
+
+    // A match that starts in the dictionary and runs on into the block.
+    uint8_t tail[300];
+    memcpy(tail, sample + sizeof(sample) - 100, 100);
+    for (size_t i = 100; i < sizeof(tail); i++) tail[i] = tail[i - 100];
+    roundtrip(tail, sizeof(tail), dict);
+    for (int i = 0; i < 50; i++) roundtrip(sample + next_rand() % 30000, 1 + next_rand() % 2000, dict);
+
+    // Frames record the dictionary id and refuse a mismatched one.
+    ttak_io_chain_t chain;
+    ttak_io_chain_init(&chain, NULL);
+    ASSERT(ttak_io_compress_frame(NULL, sample, sizeof(sample), 4096, dict, &chain, 0) == TTAK_IO_SUCCESS);
+    uint8_t *frame = flatten(&chain);
+    uint8_t *out = malloc(sizeof(sample));
+    ASSERT(ttak_io_decompress_frame(NULL, frame, chain.len, NULL, out, sizeof(sample), &got) ==
+           TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_io_decompress_frame(NULL, frame, chain.len, dict, out, sizeof(sample), &got) == TTAK_IO_SUCCESS);
+    ASSERT(got == sizeof(sample) && memcmp(out, sample, got) == 0);
+    free(out);
+    free(frame);
+    ttak_io_chain_destroy(&chain);
+    ttak_io_compress_dict_destroy(dict);
+}
+
+#define FRAME_BYTES (3U * 1024U * 1024U + 777U)
+
+static void test_frame_parallel(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(4, 0, now);
+    ASSERT(pool != NULL);
+    uint8_t *src = malloc(FRAME_BYTES);
+    ASSERT(src != NULL);
+    fill_ledger(src, FRAME_BYTES, 1);
+    // An incompressible stretch is stored raw.
+    for (size_t i = 1000000; i < 1200000; i++) src[i] = (uint8_t)next_rand();
+
+    ttak_io_chain_t chain;
+    ttak_io_chain_init(&chain, NULL);
+    ASSERT(ttak_io_compress_frame(pool, src, FRAME_BYTES, 0, NULL, &chain, now) == TTAK_IO_SUCCESS);
+    ASSERT(chain.len < FRAME_BYTES / 2);
+    uint8_t *frame = flatten(&chain);
+
+    size_t size = 0;
+    ASSERT(ttak_io_decompress_frame_size(frame, chain.len, &size) == TTAK_IO_SUCCESS);
+    ASSERT(size == FRAME_BYTES);
+    ASSERT(ttak_io_decompress_frame_size(frame, chain.len - 1, &size) == TTAK_IO_ERR_RANGE);
+
+    uint8_t *out = malloc(FRAME_BYTES);
+    size_t got = 0;
+    ASSERT(ttak_io_decompress_frame(pool, frame, chain.len, NULL, out, FRAME_BYTES - 1, &got) == TTAK_IO_ERR_RANGE);
+    ASSERT(ttak_io_decompress_frame(pool, frame, chain.len, NULL, out, FRAME_BYTES, &got) == TTAK_IO_SUCCESS);
+    ASSERT(got == FRAME_BYTES && memcmp(out, src, FRAME_BYTES) == 0);
+
+    // A broken block fails the whole frame.
+    frame[TTAK_IO_COMPRESS_FRAME_HEADER + TTAK_IO_COMPRESS_BLOCK_HEADER] ^= 0xff;
+    frame[TTAK_IO_COMPRESS_FRAME_HEADER + TTAK_IO_COMPRESS_BLOCK_HEADER + 1] ^= 0xff;
+    ASSERT(ttak_io_decompress_frame(pool, frame, chain.len, NULL, out, FRAME_BYTES, &got) == TTAK_IO_ERR_RANGE);
+
+    free(out);
+    free(frame);
+    ttak_io_chain_destroy(&chain);
+    free(src);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void test_streams(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    size_t len = 700000;
+    uint8_t *src = malloc(len);
+    ASSERT(pool != NULL && src != NULL);
+    fill_ledger(src, len, 77);
+
+    // Odd-sized writes, a flush midway, and one write large enough to skip the buffer.
+    ttak_io_compress_stream_t cs;
+    ASSERT(ttak_io_compress_stream_init(&cs, pool, TTAK_IO_COMPRESS_BLOCK_MAX + 1, NULL) ==
+           TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_io_compress_stream_init(&cs, pool, 16384, NULL) == TTAK_IO_SUCCESS);
+    ttak_io_chain_t framed;
+    ttak_io_chain_init(&framed, NULL);
+    size_t off = 0;
+    while (off < 200000) {
+        size_t n = 1 + next_rand() % 3000;
+        ASSERT(ttak_io_compress_stream_write(&cs, src + off, n, &framed, now) == TTAK_IO_SUCCESS);
+        off += n;
+    }
+    ASSERT(ttak_io_compress_stream_flush(&cs, &framed, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_compress_stream_write(&cs, src + off, len - off, &framed, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_compress_stream_finish(&cs, &framed, now) == TTAK_IO_SUCCESS);
+    ASSERT(cs.raw_bytes == len && cs.out_bytes == framed.len);
+    ttak_io_compress_stream_destroy(&cs);
+
+    // Trailing bytes after the frame stay in the input.
+    ASSERT(ttak_io_chain_append(&framed, "next", 4, now) == TTAK_IO_SUCCESS);
+
+    // Feed the reader in small slices, as a socket would deliver them.
+    ttak_io_decompress_stream_t ds;
+    ttak_io_decompress_stream_init(&ds, NULL);
+    ttak_io_chain_t in, out;
+    ttak_io_chain_init(&in, NULL);
+    ttak_io_chain_init(&out, NULL);
+    for (size_t pos = 0; pos < framed.len;) {
+        size_t n = 1 + next_rand() % 5000;
+        if (n > framed.len - pos) n = framed.len - pos;
+        ASSERT(ttak_io_chain_append_slice(&in, &framed, pos, n) == TTAK_IO_SUCCESS);
+        pos += n;
+        ASSERT(ttak_io_decompress_stream_feed(&ds, &in, &out, now) == TTAK_IO_SUCCESS);
+    }
+    ASSERT(ttak_io_decompress_stream_done(&ds));
+    ASSERT(in.len == 4 && ds.raw_bytes == len && out.len == len);
+    uint8_t *flat = flatten(&out);
+    ASSERT(memcmp(flat, src, len) == 0);
+    free(flat);
+    ttak_io_decompress_stream_destroy(&ds);
+
+    // A frame for another dictionary is refused up front.
+    ttak_io_compress_dict_t *dict = ttak_io_compress_dict_create(src, 4096);
+    ttak_io_chain_destroy(&in);
+    ASSERT(ttak_io_compress_frame(NULL, src, 1000, 0, dict, &in, now) == TTAK_IO_SUCCESS);
+    ttak_io_decompress_stream_init(&ds, NULL);
+    ASSERT(ttak_io_decompress_stream_feed(&ds, &in, &out, now) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ttak_io_decompress_stream_destroy(&ds);
+    ttak_io_compress_dict_destroy(dict);
+
+    ttak_io_chain_destroy(&in);
+    ttak_io_chain_destroy(&out);
+    ttak_io_chain_destroy(&framed);
+    free(src);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void test_decompress_mmap(void) {
+    uint64_t now = ttak_get_tick_count_ns();
+    size_t len = 300000;
+    uint8_t *src = malloc(len);
+    ASSERT(src != NULL);
+    fill_ledger(src, len, 42);
+    ttak_io_chain_t chain;
+    ttak_io_chain_init(&chain, NULL);
+    ASSERT(ttak_io_compress_frame(NULL, src, len, 32768, NULL, &chain, now) == TTAK_IO_SUCCESS);
+
+    char path[] = "/tmp/ttak_compress_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    unlink(path);
+    uint8_t *frame = flatten(&chain);
+    ASSERT(write(fd, frame, chain.len) == (ssize_t)chain.len);
+    free(frame);
+
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ttak_io_mmap_t *map = ttak_io_mmap_create(fd, owner, TT_SECOND(30), 0, now);
+    ASSERT(map != NULL);
+    ttak_detachable_allocation_t out;
+    ASSERT(ttak_io_decompress_mmap(NULL, map, NULL, NULL, &out, now) == TTAK_IO_SUCCESS);
+    ASSERT(out.size == len && memcmp(out.data, src, len) == 0);
+    ttak_detachable_mem_free(ttak_detachable_context_default(), &out);
+    ttak_io_mmap_close(map, now);
+    ttak_owner_destroy(owner);
+
+    ttak_io_chain_destroy(&chain);
+    free(src);
+}
+
+int main(void) {
+    RUN_TEST(test_block_roundtrip);
+    RUN_TEST(test_block_rejects_corruption);
+    RUN_TEST(test_dictionary);
+    RUN_TEST(test_frame_parallel);
+    RUN_TEST(test_streams);
+    RUN_TEST(test_decompress_mmap);
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <ttak/io/io.h>
+#include <ttak/timing/timing.h>
+#include <ttak/timing/wheel.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static void test_coarse_window_skips_writes(void) {
+    uint64_t now = TT_SECOND(100);
+    int sv[2];
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    ttak_io_guard_t g;
+    ASSERT(ttak_io_guard_init(&g, sv[0], NULL, TT_SECOND(10), now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_guard_set_coarse(&g, TT_MILLI_SECOND(100), NULL) == TTAK_IO_SUCCESS);
+    // The deadline covers the window so uses inside it are never cut short.
+    ASSERT(g.expires_at == now + TT_SECOND(10) + TT_MILLI_SECOND(100));
+
+    // Refreshes inside the window leave the guard untouched.
+    for (uint64_t t = 1; t < 100; t += 7) {
+        ASSERT(ttak_io_guard_refresh(&g, now + TT_MILLI_SECOND(t)) == TTAK_IO_SUCCESS);
+        ASSERT(g.last_used == now);
+    }
+    ASSERT(ttak_io_guard_refresh(&g, now + TT_MILLI_SECOND(100)) == TTAK_IO_SUCCESS);
+    ASSERT(g.last_used == now + TT_MILLI_SECOND(100));
+
+    // Without a wheel, valid() still checks the clock.
+    uint64_t deadline = g.expires_at;
+    ASSERT(ttak_io_guard_valid(&g, deadline));
+    ASSERT(!ttak_io_guard_valid(&g, deadline + 1));
+
+    // Back to strict tracking.
+    ASSERT(ttak_io_guard_set_coarse(&g, 0, NULL) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_guard_refresh(&g, now + TT_MILLI_SECOND(101)) == TTAK_IO_SUCCESS);
+    ASSERT(g.last_used == now + TT_MILLI_SECOND(101));
+    ASSERT(g.expires_at == now + TT_MILLI_SECOND(101) + TT_SECOND(10));
+
+    ttak_io_guard_close(&g, now);
+    ASSERT(ttak_io_guard_set_coarse(&g, 1, NULL) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    close(sv[1]);
+}
+
+static void test_wheel_enforces_expiry(void) {
+    uint64_t now = TT_SECOND(100);
+    ttak_timer_wheel_t wheel;
+    ttak_timer_wheel_init(&wheel, TT_MILLI_SECOND(1), now);
+    int sv[2];
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    ttak_io_guard_t g;
+    ASSERT(ttak_io_guard_init(&g, sv[0], NULL, TT_MILLI_SECOND(50), now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_guard_set_coarse(&g, TT_MILLI_SECOND(10), &wheel) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_timer_wheel_pending(&wheel) == 1);
+
+    // valid() trusts the timer, not the caller's clock.
+    ASSERT(ttak_io_guard_valid(&g, now + TT_SECOND(10)));
+
+    // A refresh moves the deadline; the timer follows it instead of expiring.
+    ASSERT(ttak_io_guard_refresh(&g, now + TT_MILLI_SECOND(40)) == TTAK_IO_SUCCESS);
+    ttak_timer_wheel_advance(&wheel, now + TT_MILLI_SECOND(70));
+    ASSERT(ttak_io_guard_valid(&g, now));
+    ASSERT(ttak_timer_wheel_pending(&wheel) == 1);
+
+    ttak_timer_wheel_advance(&wheel, now + TT_MILLI_SECOND(101));
+    ASSERT(!ttak_io_guard_valid(&g, now));
+    ASSERT(ttak_io_guard_refresh(&g, now + TT_MILLI_SECOND(102)) == TTAK_IO_ERR_EXPIRED_GUARD);
+    ASSERT(!ttak_io_guard_valid(&g, now));
+    ASSERT(ttak_timer_wheel_pending(&wheel) == 0);
+
+    // Rebinding revives the guard and re-arms; closing disarms.
+    ASSERT(ttak_io_guard_close(&g, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_guard_rebind(&g, sv[1], NULL, TT_MILLI_SECOND(50), now + TT_MILLI_SECOND(200)) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_guard_valid(&g, now) && ttak_timer_wheel_pending(&wheel) == 1);
+    ASSERT(ttak_io_guard_close(&g, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_timer_wheel_pending(&wheel) == 0);
+
+    ttak_timer_wheel_destroy(&wheel);
+}
+
+int main(void) {
+    RUN_TEST(test_coarse_window_skips_writes);
+    RUN_TEST(test_wheel_enforces_expiry);
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <ttak/io/mmap.h>
+#include <ttak/net/view.h>
+#include <ttak/mem/owner.h>
+#include <ttak/timing/timing.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+#define MAP_BYTES (3U * 1024U * 1024U + 123U)
+
+static uint8_t pattern(size_t i) {
+    return (uint8_t)((i * 131U) ^ (i >> 12));
+}
+
+static int make_file(size_t len) {
+    char path[] = "/tmp/ttak_mmap_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    unlink(path);
+    uint8_t *buf = malloc(len);
+    ASSERT(buf != NULL);
+    for (size_t i = 0; i < len; i++) buf[i] = pattern(i);
+    ASSERT(write(fd, buf, len) == (ssize_t)len);
+    free(buf);
+    return fd;
+}
+
+typedef struct {
+    int calls;
+    ttak_io_status_t status;
+    size_t bytes;
+} prefetch_t;
+
+static void on_prefetch(ttak_io_status_t status, size_t bytes, void *user) {
+    prefetch_t *p = user;
+    p->status = status;
+    p->bytes = bytes;
+    p->calls++;
+}
+
+static void test_map_and_slice(void) {
+    uint64_t now = ttak_get_tick_count_ns();
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_io_mmap_t *map = ttak_io_mmap_create(make_file(MAP_BYTES), owner, TT_SECOND(30),
+                                              TTAK_IO_MMAP_HUGE, now);
+    ASSERT(map != NULL && map->len == MAP_BYTES);
+    ASSERT(((uintptr_t)map->data & (TTAK_IO_MMAP_HUGE_ALIGN - 1U)) == 0);
+
+    const uint8_t *p = NULL;
+    ASSERT(ttak_io_mmap_retain(map, 4097, 64, &p, now) == TTAK_IO_SUCCESS);
+    for (size_t i = 0; i < 64; i++) ASSERT(p[i] == pattern(4097 + i));
+    ttak_io_mmap_release(map);
+    ASSERT(ttak_io_mmap_retain(map, MAP_BYTES - 10, 11, &p, now) == TTAK_IO_ERR_RANGE);
+    ASSERT(ttak_io_mmap_retain(map, MAP_BYTES, 0, &p, now) == TTAK_IO_SUCCESS);
+    ttak_io_mmap_release(map);
+
+    ASSERT(ttak_io_mmap_advise(map, 0, 0, TTAK_IO_MMAP_SEQUENTIAL, now) == TTAK_IO_SUCCESS);
+    ASSERT(map->advice == TTAK_IO_MMAP_SEQUENTIAL);
+    ASSERT(ttak_io_mmap_advise(map, 100, 5000, TTAK_IO_MMAP_RANDOM, now) == TTAK_IO_SUCCESS);
+    ASSERT(map->advice == TTAK_IO_MMAP_SEQUENTIAL);
+    ASSERT(ttak_io_mmap_advise(map, MAP_BYTES + 1, 0, TTAK_IO_MMAP_RANDOM, now) == TTAK_IO_ERR_RANGE);
+
+    // Without a pool the prefetch completes before returning.
+    prefetch_t pf = { 0 };
+    ASSERT(ttak_io_mmap_prefetch(map, 1000, 0, on_prefetch, &pf, now) == TTAK_IO_SUCCESS);
+    ASSERT(pf.calls == 1 && pf.status == TTAK_IO_SUCCESS && pf.bytes == MAP_BYTES - 1000);
+    ASSERT(atomic_load(&map->refs) == 1);
+
+    ttak_io_mmap_close(map, now);
+    ttak_owner_destroy(owner);
+}
+
+static void test_view_outlives_close(void) {
+    uint64_t now = ttak_get_tick_count_ns();
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_io_mmap_t *map = ttak_io_mmap_create(make_file(8192), owner, TT_SECOND(30), TTAK_IO_MMAP_POPULATE, now);
+    ASSERT(map != NULL);
+
+    ttak_net_view_t view;
+    ttak_net_view_init(&view);
+    ASSERT(ttak_net_view_from_mmap(&view, map, 100, 200, now) == TTAK_IO_SUCCESS);
+    ASSERT(view.len == 200 && view.map == map && ttak_net_view_data(&view) == map->data + 100);
+
+    // Closing stops new slices but the view keeps its pages.
+    ttak_io_mmap_close(map, now);
+    for (size_t i = 0; i < view.len; i++) ASSERT(ttak_net_view_data(&view)[i] == pattern(100 + i));
+    ttak_net_view_release(&view);
+    ASSERT(view.data == NULL && view.map == NULL);
+    ttak_owner_destroy(owner);
+}
+
+static void test_guard_expiry(void) {
+    uint64_t now = TT_SECOND(10);
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_io_mmap_t *map = ttak_io_mmap_create(make_file(4096), owner, TT_MILLI_SECOND(5), 0, now);
+    ASSERT(map != NULL);
+
+    // Each slice refreshes the TTL; an idle mapping expires.
+    const uint8_t *p;
+    ASSERT(ttak_io_mmap_retain(map, 0, 16, &p, now + TT_MILLI_SECOND(4)) == TTAK_IO_SUCCESS);
+    ttak_io_mmap_release(map);
+    ASSERT(ttak_io_mmap_retain(map, 0, 16, &p, now + TT_MILLI_SECOND(8)) == TTAK_IO_SUCCESS);
+    ttak_io_mmap_release(map);
+    ASSERT(ttak_io_mmap_retain(map, 0, 16, &p, now + TT_MILLI_SECOND(20)) == TTAK_IO_ERR_EXPIRED_GUARD);
+    ttak_net_view_t view;
+    ASSERT(ttak_net_view_from_mmap(&view, map, 0, 16, now + TT_MILLI_SECOND(20)) == TTAK_IO_ERR_EXPIRED_GUARD);
+    ASSERT(ttak_io_mmap_prefetch(map, 0, 0, NULL, NULL, now + TT_MILLI_SECOND(20)) == TTAK_IO_ERR_EXPIRED_GUARD);
+
+    ttak_io_mmap_close(map, now);
+    ASSERT(ttak_io_mmap_create(-1, owner, TT_SECOND(1), 0, now) == NULL);
+    ttak_owner_destroy(owner);
+}
+
+int main(void) {
+    RUN_TEST(test_map_and_slice);
+    RUN_TEST(test_view_outlives_close);
+    RUN_TEST(test_guard_expiry);
+    return 0;
+}
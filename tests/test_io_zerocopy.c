@@ -0,0 +1,134 @@
+#include <ttak/io/zerocopy.h>
+#include <ttak/timing/timing.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static void tcp_pair(int *client, int *server) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT(lfd >= 0);
+    ASSERT(bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    socklen_t len = sizeof(addr);
+    ASSERT(getsockname(lfd, (struct sockaddr *)&addr, &len) == 0);
+    ASSERT(listen(lfd, 1) == 0);
+    *client = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT(*client >= 0);
+    ASSERT(connect(*client, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    *server = accept(lfd, NULL, NULL);
+    ASSERT(*server >= 0);
+    close(lfd);
+}
+
+static void read_exact(int fd, uint8_t *dst, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t rc = recv(fd, dst + got, len - got, 0);
+        ASSERT(rc > 0);
+        got += (size_t)rc;
+    }
+}
+
+static void test_zerocopy_send_tcp(void) {
+    uint64_t now = ttak_get_tick_count();
+    int cli, srv;
+    tcp_pair(&cli, &srv);
+    ttak_io_zerocopy_tx_t tx;
+    ASSERT(ttak_io_zerocopy_tx_init(&tx, cli, NULL, 0) == TTAK_IO_SUCCESS);
+    ASSERT(tx.threshold == TTAK_IO_ZC_TX_THRESHOLD);
+    if (!tx.enabled) printf("  SO_ZEROCOPY unavailable; sends copy\n");
+
+    enum { BIG = 32 * 1024, SMALL = 512, ROUNDS = 3 };
+    uint8_t *in = malloc(BIG);
+    ASSERT(in != NULL);
+    for (int r = 0; r < ROUNDS; r++) {
+        ttak_detachable_allocation_t a = ttak_io_zerocopy_tx_alloc(&tx, BIG, now);
+        ASSERT(a.data != NULL);
+        for (size_t i = 0; i < BIG; i++) ((uint8_t *)a.data)[i] = (uint8_t)(i * 13U + (size_t)r);
+        size_t sent = 0;
+        ASSERT(ttak_io_zerocopy_send(&tx, &a, BIG, 0, &sent) == TTAK_IO_SUCCESS);
+        ASSERT(sent == BIG && a.data == NULL);
+        read_exact(srv, in, BIG);
+        for (size_t i = 0; i < BIG; i++) ASSERT(in[i] == (uint8_t)(i * 13U + (size_t)r));
+    }
+
+    // Below the threshold the payload is copied and its buffer freed at once.
+    uint32_t pending = tx.count;
+    ttak_detachable_allocation_t s = ttak_io_zerocopy_tx_alloc(&tx, SMALL, now);
+    memset(s.data, 'x', SMALL);
+    ASSERT(ttak_io_zerocopy_send(&tx, &s, SMALL, 0, NULL) == TTAK_IO_SUCCESS);
+    ASSERT(tx.count <= pending);
+    read_exact(srv, in, SMALL);
+    ASSERT(in[0] == 'x' && in[SMALL - 1] == 'x');
+
+    // Every zero-copy send is eventually reported done and its buffer freed.
+    uint64_t deadline = ttak_get_tick_count() + 5000;
+    while (tx.count > 0 && ttak_get_tick_count() < deadline) ttak_io_zerocopy_tx_reap(&tx, 10);
+    ASSERT(tx.count == 0);
+    if (tx.enabled) ASSERT(tx.copied + tx.zerocopied >= ROUNDS);
+
+    ASSERT(ttak_io_zerocopy_send(&tx, &s, 1, 0, NULL) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ttak_io_zerocopy_tx_destroy(&tx, 0);
+    free(in);
+    close(cli);
+    close(srv);
+}
+
+static void test_zerocopy_unsupported_socket(void) {
+    uint64_t now = ttak_get_tick_count();
+    int sv[2];
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    ttak_io_zerocopy_tx_t tx;
+    ASSERT(ttak_io_zerocopy_tx_init(&tx, sv[0], NULL, 1) == TTAK_IO_SUCCESS);
+    ASSERT(!tx.enabled);
+    ttak_detachable_allocation_t a = ttak_io_zerocopy_tx_alloc(&tx, 64, now);
+    memcpy(a.data, "unix", 4);
+    size_t sent = 0;
+    ASSERT(ttak_io_zerocopy_send(&tx, &a, 4, 0, &sent) == TTAK_IO_SUCCESS && sent == 4);
+    ASSERT(tx.count == 0);
+    char out[4];
+    ASSERT(read(sv[1], out, 4) == 4 && memcmp(out, "unix", 4) == 0);
+    ttak_io_zerocopy_tx_destroy(&tx, 0);
+    close(sv[0]);
+    close(sv[1]);
+}
+
+static void test_zerocopy_sendfile(void) {
+    FILE *f = tmpfile();
+    ASSERT(f != NULL);
+    for (int i = 0; i < 10000; i++) fputc('a' + i % 26, f);
+    fflush(f);
+    int sv[2];
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+    uint64_t off = 100;
+    size_t sent = 0;
+    ASSERT(ttak_io_zerocopy_sendfile(sv[0], fileno(f), &off, 5000, &sent) == TTAK_IO_SUCCESS);
+    ASSERT(sent == 5000 && off == 5100);
+    uint8_t out[5000];
+    read_exact(sv[1], out, sizeof(out));
+    for (int i = 0; i < 5000; i++) ASSERT(out[i] == 'a' + (i + 100) % 26);
+
+    // Asking past the end stops at end of file.
+    ASSERT(ttak_io_zerocopy_sendfile(sv[0], fileno(f), &off, 10000, &sent) == TTAK_IO_SUCCESS);
+    ASSERT(sent == 4900 && off == 10000);
+    read_exact(sv[1], out, 4900);
+    fclose(f);
+    close(sv[0]);
+    close(sv[1]);
+}
+
+int main(void) {
+    RUN_TEST(test_zerocopy_send_tcp);
+    RUN_TEST(test_zerocopy_unsupported_socket);
+    RUN_TEST(test_zerocopy_sendfile);
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <ttak/security/key_schedule.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_macros.h"
+
+static size_t hex(const char *s, uint8_t *out) {
+    size_t i = 0;
+    for (; s[2 * i]; i++) {
+        unsigned v;
+        sscanf(s + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+    return i;
+}
+
+static void test_gcm_schedule_skips_expansion(void) {
+    // McGrew & Viega test case 16, sealed with only the session schedule expanded.
+    uint8_t key[32], aad[20], pt[60], ct[60], want[60], tag[16], want_tag[16];
+    hex("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308", key);
+    hex("feedfacedeadbeeffeedfacedeadbeefabaddad2", aad);
+    hex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+        "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39", pt);
+    hex("522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+        "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662", want);
+    hex("76fc6ece0f4e1768cddf8853bb2d551b", want_tag);
+
+    ttak_security_schedule_t sched;
+    ASSERT(ttak_security_schedule_init(&sched, TTAK_SECURITY_AES_GCM, key, 32) == TTAK_IO_SUCCESS);
+    ASSERT(sched.cipher == TTAK_SECURITY_CIPHER_AES256);
+    ttak_crypto_ctx_t ctx = { .key = key, .key_len = 32, .iv_len = 12, .aad = aad, .aad_len = sizeof(aad),
+                              .tag = tag, .tag_len = 16, .schedule = &sched };
+    hex("cafebabefacedbaddecaf888", ctx.iv);
+    ASSERT(ttak_aes256_gcm_execute(&ctx, pt, ct, sizeof(pt)) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(ct, want, sizeof(ct)) == 0);
+    ASSERT(memcmp(tag, want_tag, 16) == 0);
+
+    // A schedule of another key is not used: the context's own round keys are.
+    uint8_t other[32];
+    memcpy(other, key, 32);
+    other[31] ^= 1;
+    ASSERT(ttak_security_schedule_init(&sched, TTAK_SECURITY_AES_GCM, other, 32) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_aes256_expand_key(&ctx) == TTAK_IO_SUCCESS);
+    memset(ct, 0, sizeof(ct));
+    ASSERT(ttak_aes256_gcm_execute(&ctx, pt, ct, sizeof(pt)) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(ct, want, sizeof(ct)) == 0);
+    ASSERT(memcmp(tag, want_tag, 16) == 0);
+    ttak_security_schedule_wipe(&sched);
+    ASSERT(sched.cipher == TTAK_SECURITY_CIPHER_NONE);
+}
+
+static void test_block_cipher_schedules_match(void) {
+    // LEA and SEED, ECB and counter mode, with and without a schedule.
+    static const struct {
+        ttak_security_op_t op;
+        size_t key_len;
+    } cases[] = {
+        { TTAK_SECURITY_LEA_ENC, 16 }, { TTAK_SECURITY_LEA_CTR, 24 }, { TTAK_SECURITY_LEA_CTR, 32 },
+        { TTAK_SECURITY_SEED_ENC, 16 }, { TTAK_SECURITY_SEED_CTR, 16 },
+    };
+    enum { LEN = 16 * 300 };
+    uint8_t *in = malloc(LEN), *ref = malloc(LEN), *got = malloc(LEN);
+    ASSERT(in && ref && got);
+    for (size_t i = 0; i < LEN; i++) in[i] = (uint8_t)(i * 17 + 3);
+    uint8_t key[32];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(i * 11 + 5);
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        ttak_crypto_ctx_t ctx = { .in = in, .in_len = LEN, .out = ref, .out_len = LEN, .key = key,
+                                  .key_len = cases[c].key_len };
+        ASSERT(ttak_security_execute(&ctx, cases[c].op, 0) == TTAK_IO_SUCCESS);
+
+        ttak_security_schedule_t sched;
+        ASSERT(ttak_security_schedule_init(&sched, cases[c].op, key, cases[c].key_len) == TTAK_IO_SUCCESS);
+        ctx = (ttak_crypto_ctx_t){ .in = in, .in_len = LEN, .out = got, .out_len = LEN, .key = key,
+                                   .key_len = cases[c].key_len, .schedule = &sched };
+        ASSERT(ttak_security_execute(&ctx, cases[c].op, 0) == TTAK_IO_SUCCESS);
+        ASSERT_MSG(memcmp(ref, got, LEN) == 0, "case %zu", c);
+        // SEED leaves hw_state untouched when the schedule supplies the round keys.
+        if (ttak_security_op_cipher(cases[c].op) == TTAK_SECURITY_CIPHER_SEED) {
+            ASSERT(ctx.hw_state.seed.rounds == 0);
+        }
+    }
+    free(in);
+    free(ref);
+    free(got);
+}
+
+static void test_schedule_rejects_bad_keys(void) {
+    uint8_t key[32] = {0};
+    ttak_security_schedule_t sched;
+    ASSERT(ttak_security_schedule_init(&sched, TTAK_SECURITY_AES_GCM, key, 16) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(sched.cipher == TTAK_SECURITY_CIPHER_NONE);
+    ASSERT(ttak_security_schedule_init(&sched, TTAK_SECURITY_SEED_CTR, key, 32) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_security_schedule_init(&sched, TTAK_SECURITY_CHACHA20_POLY1305, key, 32) ==
+           TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_security_schedule_init(&sched, TTAK_SECURITY_LEA_ENC, NULL, 16) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_security_schedule_init(&sched, TTAK_SECURITY_LEA_ENC, key, 24) == TTAK_IO_SUCCESS);
+}
+
+static void test_schedule_cache_lru(void) {
+    ttak_security_schedule_cache_t cache;
+    ttak_security_schedule_cache_init(&cache);
+    uint8_t keys[TTAK_SECURITY_SCHEDULE_CACHE_SLOTS + 1][32];
+    for (size_t k = 0; k <= TTAK_SECURITY_SCHEDULE_CACHE_SLOTS; k++) {
+        for (int i = 0; i < 32; i++) keys[k][i] = (uint8_t)(k * 41 + i);
+    }
+
+    const ttak_security_schedule_t *first[TTAK_SECURITY_SCHEDULE_CACHE_SLOTS];
+    for (size_t k = 0; k < TTAK_SECURITY_SCHEDULE_CACHE_SLOTS; k++) {
+        first[k] = ttak_security_schedule_cache_get(&cache, TTAK_SECURITY_AES_GCM, keys[k], 32);
+        ASSERT(first[k] != NULL && memcmp(first[k]->key, keys[k], 32) == 0);
+    }
+    // Hits return the same slot.
+    ASSERT(ttak_security_schedule_cache_get(&cache, TTAK_SECURITY_AES_GCM, keys[0], 32) == first[0]);
+    ASSERT(ttak_security_schedule_cache_get(&cache, TTAK_SECURITY_AES_GCM, keys[0], 32) == first[0]);
+
+    // Key 1 is now the least recently used and makes room for the new key.
+    const ttak_security_schedule_t *fresh =
+        ttak_security_schedule_cache_get(&cache, TTAK_SECURITY_AES_GCM, keys[TTAK_SECURITY_SCHEDULE_CACHE_SLOTS], 32);
+    ASSERT(fresh == first[1]);
+    ASSERT(ttak_security_schedule_cache_get(&cache, TTAK_SECURITY_AES_GCM, keys[0], 32) == first[0]);
+    // The same key under another cipher is a separate entry.
+    const ttak_security_schedule_t *lea = ttak_security_schedule_cache_get(&cache, TTAK_SECURITY_LEA_CTR, keys[0], 32);
+    ASSERT(lea != NULL && lea != first[0] && lea->cipher == TTAK_SECURITY_CIPHER_LEA);
+
+    ASSERT(ttak_security_schedule_cache_get(&cache, TTAK_SECURITY_HASH_FAST, keys[0], 32) == NULL);
+    ASSERT(ttak_security_schedule_cache_get(&cache, TTAK_SECURITY_AES_GCM, keys[0], 31) == NULL);
+    ttak_security_schedule_cache_clear(&cache);
+    for (size_t k = 0; k < TTAK_SECURITY_SCHEDULE_CACHE_SLOTS; k++) {
+        ASSERT(cache.slots[k].cipher == TTAK_SECURITY_CIPHER_NONE);
+    }
+}
+
+int main(void) {
+    RUN_TEST(test_gcm_schedule_skips_expansion);
+    RUN_TEST(test_block_cipher_schedules_match);
+    RUN_TEST(test_schedule_rejects_bad_keys);
+    RUN_TEST(test_schedule_cache_lru);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <ttak/stats/kll.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+#define KLL_N 200000
+
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/* Samples are a shuffled 0..KLL_N-1, so the true rank of v is v / KLL_N. */
+static void test_kll_rank_error_bounded(void) {
+    ttak_kll_t sk;
+    ttak_kll_init(&sk, 0, 42);
+    for (uint64_t i = 0; i < KLL_N; ++i) {
+        ASSERT(ttak_kll_update(&sk, (i * 7919) % KLL_N));
+    }
+    ASSERT(ttak_kll_count(&sk) == KLL_N);
+
+    size_t held = 0;
+    for (uint32_t h = 0; h < sk.levels; ++h) held += sk.len[h];
+    ASSERT(held < 4 * TTAK_KLL_DEFAULT_K);
+
+    const double qs[] = { 0.0, 0.01, 0.5, 0.9, 0.99, 0.999, 1.0 };
+    uint64_t out[7];
+    ASSERT(ttak_kll_quantiles(&sk, qs, 7, out));
+    ASSERT(out[0] == 0);
+    ASSERT(out[6] == KLL_N - 1);
+    for (int i = 1; i < 6; ++i) {
+        double err = (double)out[i] / KLL_N - qs[i];
+        ASSERT(err < 0.03 && err > -0.03);
+        ASSERT(i == 1 || out[i] >= out[i - 1]);
+    }
+    double r = ttak_kll_rank(&sk, KLL_N / 4);
+    ASSERT(r > 0.22 && r < 0.28);
+    ttak_kll_destroy(&sk);
+}
+
+static void test_kll_merge_matches_joined_stream(void) {
+    ttak_kll_t parts[4], all;
+    for (int p = 0; p < 4; ++p) ttak_kll_init(&parts[p], 0, (uint64_t)p + 1);
+    ttak_kll_init(&all, 0, 99);
+    /* Each part sees a different range, so only a correct merge gets the middle right. */
+    for (uint64_t i = 0; i < KLL_N; ++i) {
+        uint64_t v = mix(i) % (KLL_N / 4);
+        int p = (int)(i % 4);
+        ASSERT(ttak_kll_update(&parts[p], v + (uint64_t)p * (KLL_N / 4)));
+    }
+    for (int p = 0; p < 4; ++p) {
+        ASSERT(ttak_kll_merge(&all, &parts[p]));
+        ttak_kll_destroy(&parts[p]);
+    }
+    ASSERT(ttak_kll_count(&all) == KLL_N);
+    const double qs[] = { 0.1, 0.5, 0.95 };
+    for (int i = 0; i < 3; ++i) {
+        double err = (double)ttak_kll_quantile(&all, qs[i]) / KLL_N - qs[i];
+        ASSERT(err < 0.03 && err > -0.03);
+    }
+    ttak_kll_destroy(&all);
+
+    ttak_kll_t empty;
+    ttak_kll_init(&empty, 0, 1);
+    ASSERT(ttak_kll_quantile(&empty, 0.5) == 0);
+    ASSERT(ttak_kll_rank(&empty, 10) == 0.0);
+    ttak_kll_destroy(&empty);
+}
+
+int main(void) {
+    RUN_TEST(test_kll_rank_error_bounded);
+    RUN_TEST(test_kll_merge_matches_joined_stream);
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <ttak/security/lea.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_macros.h"
+
+static size_t hex(const char *s, uint8_t *out) {
+    size_t i = 0;
+    for (; s[2 * i]; i++) {
+        unsigned v;
+        sscanf(s + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+    return i;
+}
+
+static const ttak_security_driver_t scalar_driver = { .name = "scalar", .lane_width = 1 };
+static const ttak_security_driver_t wide_driver = { .name = "wide", .lane_width = 16 };
+
+static void test_lea_vectors(void) {
+    // KS X 3246 reference vectors, one per key length.
+    static const struct {
+        const char *key, *pt, *ct;
+    } cases[] = {
+        { "0f1e2d3c4b5a69788796a5b4c3d2e1f0", "101112131415161718191a1b1c1d1e1f",
+          "9fc84e3528c6c6185532c7a704648bfd" },
+        { "0f1e2d3c4b5a69788796a5b4c3d2e1f0f0e1d2c3b4a59687", "202122232425262728292a2b2c2d2e2f",
+          "6fb95e325aad1b878cdcf5357674c6f2" },
+        { "0f1e2d3c4b5a69788796a5b4c3d2e1f0f0e1d2c3b4a5968778695a4b3c2d1e0f",
+          "303132333435363738393a3b3c3d3e3f", "d651aff647b189c13a8900ca27f9e197" },
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        uint8_t key[32], pt[16], want[16], got[16];
+        size_t key_len = hex(cases[c].key, key);
+        hex(cases[c].pt, pt);
+        hex(cases[c].ct, want);
+        ttak_crypto_ctx_t ctx = { .in = pt, .in_len = 16, .out = got, .out_len = 16, .key = key, .key_len = key_len };
+        ASSERT(ttak_lea_encrypt_simd(&ctx, &scalar_driver) == TTAK_IO_SUCCESS);
+        ASSERT_MSG(memcmp(got, want, 16) == 0, "LEA-%zu", key_len * 8);
+
+        ttak_lea_schedule_t sched;
+        ttak_lea_schedule_init(&sched, key, key_len);
+        ASSERT(sched.rounds == 16 + key_len / 2);
+    }
+}
+
+static void test_lea_wide_matches_scalar(void) {
+    // 16-, 8- and 4-block kernels plus a scalar tail, for every key length.
+    enum { BLOCKS = 16 + 8 + 4 + 3 };
+    uint8_t key[32], in[BLOCKS * 16], ref[BLOCKS * 16], got[BLOCKS * 16];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(i * 29 + 1);
+    for (size_t i = 0; i < sizeof(in); i++) in[i] = (uint8_t)(i * 7);
+    for (size_t key_len = 16; key_len <= 32; key_len += 8) {
+        ttak_crypto_ctx_t ctx = { .in = in, .in_len = sizeof(in), .out = ref, .out_len = sizeof(ref),
+                                  .key = key, .key_len = key_len };
+        ASSERT(ttak_lea_encrypt_simd(&ctx, &scalar_driver) == TTAK_IO_SUCCESS);
+        ctx.out = got;
+        ASSERT(ttak_lea_encrypt_simd(&ctx, &wide_driver) == TTAK_IO_SUCCESS);
+        ASSERT_MSG(memcmp(ref, got, sizeof(ref)) == 0, "LEA-%zu", key_len * 8);
+    }
+}
+
+static void test_lea_ctr_vector(void) {
+    // The counter wraps from all ones to zero after the first block.
+    uint8_t key[32], in[40], want[40], got[40];
+    hex("0f1e2d3c4b5a69788796a5b4c3d2e1f0f0e1d2c3b4a5968778695a4b3c2d1e0f", key);
+    hex("724a07d03febcafa6119bbd11ce873ad5ae077b6be3779ebedaf9691180a2ead671934509605b5f9", want);
+    for (size_t i = 0; i < sizeof(in); i++) in[i] = (uint8_t)i;
+    ttak_crypto_ctx_t ctx = { .in = in, .in_len = sizeof(in), .out = got, .out_len = sizeof(got),
+                              .key = key, .key_len = 32 };
+    memset(ctx.iv, 0xff, 16);
+    ASSERT(ttak_lea_ctr_execute(&ctx, &wide_driver) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(got, want, sizeof(want)) == 0);
+    static const uint8_t next[16] = { [15] = 2 };
+    ASSERT(memcmp(ctx.iv, next, 16) == 0);
+
+    // A 192-bit key, with the counter carrying out of its low 64 bits.
+    uint8_t want192[37];
+    hex("f6184c3c84055503c5e68c1a17a57f7e8d9f103ff40858a42b3e31c6624e993c469519c5bd", want192);
+    hex("0011223344556677fffffffffffffffe", ctx.iv);
+    ctx.key_len = 24;
+    ctx.in_len = sizeof(want192);
+    ASSERT(ttak_lea_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(got, want192, sizeof(want192)) == 0);
+}
+
+static void test_lea_ctr_streams(void) {
+    enum { LEN = 16 * 100 + 5 };
+    uint8_t *in = malloc(LEN), *ref = malloc(LEN), *got = malloc(LEN);
+    ASSERT(in && ref && got);
+    for (size_t i = 0; i < LEN; i++) in[i] = (uint8_t)(i * 131 + 7);
+    uint8_t key[16];
+    for (int i = 0; i < 16; i++) key[i] = (uint8_t)(0x5A ^ i);
+    ttak_crypto_ctx_t ctx = { .in = in, .in_len = LEN, .out = ref, .out_len = LEN, .key = key, .key_len = 16 };
+    ASSERT(ttak_lea_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_SUCCESS);
+
+    // Split calls continue from the advanced counter, in either driver.
+    memset(ctx.iv, 0, 16);
+    ctx.out = got;
+    ctx.in_len = 16 * 37;
+    ASSERT(ttak_lea_ctr_execute(&ctx, &wide_driver) == TTAK_IO_SUCCESS);
+    ctx.in = in + 16 * 37;
+    ctx.out = got + 16 * 37;
+    ctx.in_len = LEN - 16 * 37;
+    ASSERT(ttak_lea_ctr_execute(&ctx, &wide_driver) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(ref, got, LEN) == 0);
+
+    // In place decryption restores the plaintext.
+    memset(ctx.iv, 0, 16);
+    ctx.in = ref;
+    ctx.out = ref;
+    ctx.in_len = LEN;
+    ASSERT(ttak_security_execute(&ctx, TTAK_SECURITY_LEA_CTR, 0) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(ref, in, LEN) == 0);
+    free(in);
+    free(ref);
+    free(got);
+}
+
+static void test_lea_rejects_bad_arguments(void) {
+    uint8_t key[32] = {0}, buf[32] = {0};
+    ttak_crypto_ctx_t ctx = { .in = buf, .in_len = 32, .out = buf, .out_len = 32, .key = key, .key_len = 20 };
+    ASSERT(ttak_lea_encrypt_simd(&ctx, &scalar_driver) == TTAK_IO_ERR_RANGE);
+    ASSERT(ttak_lea_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_ERR_RANGE);
+    ctx.key_len = 16;
+    ctx.in_len = 31;
+    ASSERT(ttak_lea_encrypt_simd(&ctx, &scalar_driver) == TTAK_IO_ERR_RANGE);
+    ASSERT(ttak_lea_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_SUCCESS);
+    ctx.iv_len = 8;
+    ASSERT(ttak_lea_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ctx.iv_len = 16;
+    ctx.out_len = 30;
+    ASSERT(ttak_lea_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_ERR_RANGE);
+
+    ttak_lea_schedule_t sched;
+    ttak_lea_schedule_init(&sched, key, 20);
+    ASSERT(sched.rounds == 0);
+}
+
+int main(void) {
+    RUN_TEST(test_lea_vectors);
+    RUN_TEST(test_lea_wide_matches_scalar);
+    RUN_TEST(test_lea_ctr_vector);
+    RUN_TEST(test_lea_ctr_streams);
+    RUN_TEST(test_lea_rejects_bad_arguments);
+    return 0;
+}
@@ -1,7 +1,12 @@
 #include <ttak/limit/limit.h>
 #include "test_macros.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sched.h>
 #include <unistd.h>
 
+#define T0 1000000000000ULL
+
 static void test_ratelimit_refill_logic(void) {
     ttak_ratelimit_t rl;
     ttak_ratelimit_init(&rl, 10.0, 2.0); /* 10 tokens/sec, burst 2 */
@@ -14,7 +19,111 @@ static void test_ratelimit_refill_logic(void) {
     ASSERT(ttak_ratelimit_allow(&rl));
 }
 
+static void test_token_bucket_nanotokens(void) {
+    ttak_token_bucket_t tb;
+    ttak_token_bucket_init_at(&tb, 1000.0, 5.0, T0);
+    for (int i = 0; i < 5; i++) ASSERT(ttak_token_bucket_take(&tb, TTAK_NANOTOKENS_PER_TOKEN, T0));
+    ASSERT(!ttak_token_bucket_take(&tb, TTAK_NANOTOKENS_PER_TOKEN, T0));
+
+    /* 1000 tokens/s credits exactly one token per millisecond. */
+    ASSERT(ttak_token_bucket_available(&tb, T0 + 1000000ULL) == TTAK_NANOTOKENS_PER_TOKEN);
+    ASSERT(ttak_token_bucket_take(&tb, TTAK_NANOTOKENS_PER_TOKEN, T0 + 1000000ULL));
+    ASSERT(ttak_token_bucket_available(&tb, T0 + 60000000000ULL) == 5 * TTAK_NANOTOKENS_PER_TOKEN);
+
+    ttak_token_bucket_give(&tb, TTAK_NANOTOKENS_PER_TOKEN);
+    ASSERT(ttak_token_bucket_available(&tb, T0 + 60000000000ULL) == 5 * TTAK_NANOTOKENS_PER_TOKEN);
+
+    ttak_token_bucket_t slow;
+    ttak_token_bucket_init_at(&slow, 0.5, 1.0, T0);
+    ASSERT(ttak_token_bucket_take(&slow, TTAK_NANOTOKENS_PER_TOKEN, T0));
+    uint64_t half = ttak_token_bucket_available(&slow, T0 + 1000000000ULL);
+    ASSERT(half >= TTAK_NANOTOKENS_PER_TOKEN / 2 - 2 && half <= TTAK_NANOTOKENS_PER_TOKEN / 2);
+}
+
+static void test_gcra(void) {
+    ttak_gcra_t g;
+    ttak_gcra_init(&g, 10.0, 2.0);
+
+    ASSERT(ttak_gcra_allow(&g, T0));
+    ASSERT(ttak_gcra_allow(&g, T0));
+    uint64_t wait = ttak_gcra_check(&g, 1, T0);
+    ASSERT(wait == 100000000ULL);
+    ASSERT(!ttak_gcra_allow(&g, T0 + wait - 1));
+    ASSERT(ttak_gcra_allow(&g, T0 + wait));
+    ASSERT(ttak_gcra_check(&g, 3, T0 + 10000000000ULL) != 0);
+    ASSERT(ttak_gcra_check(&g, 2, T0 + 10000000000ULL) == 0);
+}
+
+static void test_tenant_limiter_isolation(void) {
+    ttak_tenant_limiter_t *lim = ttak_tenant_limiter_create(64, 100.0, 10.0, 4.0, 1000000ULL, T0);
+    ASSERT(lim != NULL);
+
+    int a = 0, b = 0;
+    for (int i = 0; i < 50; i++) a += ttak_tenant_limiter_allow(lim, 1, T0);
+    for (int i = 0; i < 50; i++) b += ttak_tenant_limiter_allow(lim, 2, T0);
+    ASSERT(a == 10);
+    ASSERT(b == 10);
+
+    /* 100 tokens/s refills one token per 10 ms. */
+    ASSERT(ttak_tenant_limiter_allow(lim, 1, T0 + 10000000ULL));
+    ASSERT(!ttak_tenant_limiter_allow(lim, 1, T0 + 10000000ULL));
+    ttak_tenant_limiter_destroy(lim);
+}
+
+static void test_tenant_limiter_reconcile(void) {
+    ttak_tenant_limiter_t *lim = ttak_tenant_limiter_create(2, 1.0, 10.0, 8.0, 1000000ULL, T0);
+    ASSERT(lim != NULL);
+
+    /* One allow leases 8 more tokens, leaving the bucket with 1. */
+    ASSERT(ttak_tenant_limiter_allow(lim, 5, T0));
+    ASSERT(ttak_tenant_limiter_consume(lim, 5, 1.0, T0));
+    ttak_tenant_limiter_reconcile(lim, T0 + 2000000ULL);
+    /* The returned lease is spendable again after reconciliation. */
+    int n = 0;
+    for (int i = 0; i < 20; i++) n += ttak_tenant_limiter_consume(lim, 5, 1.0, T0 + 2000000ULL);
+    ASSERT(n == 8);
+
+    /* Tenants past capacity share one overflow bucket. */
+    for (int i = 0; i < 10; i++) ASSERT(ttak_tenant_limiter_allow(lim, 6, T0));
+    int over = 0;
+    for (int i = 0; i < 20; i++) over += ttak_tenant_limiter_allow(lim, 7, T0);
+    for (int i = 0; i < 20; i++) over += ttak_tenant_limiter_allow(lim, 8, T0);
+    ASSERT(over == 10);
+    ttak_tenant_limiter_destroy(lim);
+}
+
+static _Atomic int g_admitted;
+
+static void *tenant_worker(void *arg) {
+    ttak_tenant_limiter_t *lim = arg;
+    for (int i = 0; i < 20000; i++) {
+        if (ttak_tenant_limiter_allow(lim, 42, T0)) atomic_fetch_add(&g_admitted, 1);
+        if ((i & 255) == 0) sched_yield();
+    }
+    return NULL;
+}
+
+static void test_tenant_limiter_concurrent(void) {
+    ttak_tenant_limiter_t *lim = ttak_tenant_limiter_create(16, 1000.0, 100.0, 8.0, 0, T0);
+    ASSERT(lim != NULL);
+    atomic_store(&g_admitted, 0);
+
+    pthread_t th[4];
+    for (int i = 0; i < 4; i++) pthread_create(&th[i], NULL, tenant_worker, lim);
+    for (int i = 0; i < 4; i++) pthread_join(th[i], NULL);
+
+    int admitted = atomic_load(&g_admitted);
+    ASSERT(admitted <= 100);
+    ASSERT(admitted > 100 - 4 * 8);
+    ttak_tenant_limiter_destroy(lim);
+}
+
 int main(void) {
     RUN_TEST(test_ratelimit_refill_logic);
+    RUN_TEST(test_token_bucket_nanotokens);
+    RUN_TEST(test_gcra);
+    RUN_TEST(test_tenant_limiter_isolation);
+    RUN_TEST(test_tenant_limiter_reconcile);
+    RUN_TEST(test_tenant_limiter_concurrent);
     return 0;
 }
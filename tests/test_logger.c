@@ -2,6 +2,10 @@
 #include "test_macros.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
 
 static char last_log[256];
 
@@ -22,7 +26,317 @@ static void test_logger_filters_levels(void) {
     ASSERT(strcmp(last_log, "Critical Error 404") == 0);
 }
 
+/* --- Deferred mode --- */
+
+#define ASYNC_CAP 8192
+
+static char async_lines[ASYNC_CAP][128];
+static int async_count;
+static ttak_log_level_t async_level;
+
+/* Runs on the writer thread only; read after ttak_logger_flush(). */
+static void async_sink(ttak_log_level_t level, const char *msg) {
+    if (async_count < ASYNC_CAP) snprintf(async_lines[async_count], sizeof(async_lines[0]), "%s", msg);
+    async_count++;
+    async_level = level;
+}
+
+static void test_async_matches_printf(void) {
+    ttak_logger_t logger;
+    ttak_logger_init(&logger, async_sink, TTAK_LOG_INFO);
+    ttak_logger_async_config_t cfg = { .overflow = TTAK_LOG_OVERFLOW_BLOCK };
+    ASSERT(ttak_logger_start_async(&logger, &cfg));
+    async_count = 0;
+
+    char name[16];
+    snprintf(name, sizeof(name), "worker-7");
+    int v = 300;
+    ttak_logger_log(&logger, TTAK_LOG_WARN, "%s took %5.2f ms (%d%%)", name, 3.14159, 42);
+    // The string is copied when logging, not when the writer runs.
+    memcpy(name, "clobbered", 10);
+    ttak_logger_log(&logger, TTAK_LOG_INFO, "[%-6s|%*d|%.*s]", "ab", 5, -12, 3, "abcdef");
+    ttak_logger_log(&logger, TTAK_LOG_INFO, "%hhd %hu %lx %llu %zu %c %#o", v, 70000, 0xbeefUL,
+                    18446744073709551615ULL, (size_t)12345, 'Z', 8);
+    ttak_logger_log(&logger, TTAK_LOG_INFO, "%p %s", (void *)&logger, (const char *)NULL);
+    ttak_logger_log(&logger, TTAK_LOG_DEBUG, "filtered %d", 1);
+    long double ld = 2.5L;
+    ttak_logger_log(&logger, TTAK_LOG_ERROR, "fallback %.1Lf", ld);
+    ttak_logger_flush(&logger);
+
+    char want[128];
+    ASSERT(async_count == 5);
+    ASSERT(strcmp(async_lines[0], "worker-7 took  3.14 ms (42%)") == 0);
+    snprintf(want, sizeof(want), "[%-6s|%*d|%.*s]", "ab", 5, -12, 3, "abcdef");
+    ASSERT(strcmp(async_lines[1], want) == 0);
+    snprintf(want, sizeof(want), "%hhd %hu %lx %llu %zu %c %#o", v, 70000, 0xbeefUL,
+             18446744073709551615ULL, (size_t)12345, 'Z', 8);
+    ASSERT(strcmp(async_lines[2], want) == 0);
+    snprintf(want, sizeof(want), "%p (null)", (void *)&logger);
+    ASSERT(strcmp(async_lines[3], want) == 0);
+    ASSERT(strcmp(async_lines[4], "fallback 2.5") == 0 && async_level == TTAK_LOG_ERROR);
+
+    // Stopping writes the rest and returns to synchronous logging.
+    ttak_logger_log(&logger, TTAK_LOG_INFO, "last %u", 9u);
+    ttak_logger_stop_async(&logger);
+    ASSERT(async_count == 6 && strcmp(async_lines[5], "last 9") == 0);
+    ASSERT(logger.async == NULL);
+    ttak_logger_log(&logger, TTAK_LOG_INFO, "sync");
+    ASSERT(async_count == 7);
+}
+
+static ttak_logger_t *thread_logger;
+
+static void *log_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+    for (int i = 0; i < 1000; i++) {
+        ttak_logger_log(thread_logger, TTAK_LOG_INFO, "t%d %d", id, i);
+    }
+    return NULL;
+}
+
+static void test_async_threads_keep_order(void) {
+    ttak_logger_t logger;
+    ttak_logger_init(&logger, async_sink, TTAK_LOG_INFO);
+    // A small ring makes the producers wait on the writer.
+    ttak_logger_async_config_t cfg = { .ring_bytes = 1, .overflow = TTAK_LOG_OVERFLOW_BLOCK };
+    ASSERT(ttak_logger_start_async(&logger, &cfg));
+    thread_logger = &logger;
+    async_count = 0;
+
+    // Threads run in two waves so the second reuses the rings of the first.
+    for (int wave = 0; wave < 2; wave++) {
+        pthread_t th[4];
+        for (int t = 0; t < 4; t++) ASSERT(pthread_create(&th[t], NULL, log_thread, (void *)(intptr_t)t) == 0);
+        for (int t = 0; t < 4; t++) pthread_join(th[t], NULL);
+        ttak_logger_flush(&logger);
+    }
+    ASSERT(async_count == 8000 && ttak_logger_dropped(&logger) == 0);
+
+    int next[4][2] = { { 0 } };
+    for (int i = 0; i < async_count; i++) {
+        int id, seq;
+        ASSERT(sscanf(async_lines[i], "t%d %d", &id, &seq) == 2 && id >= 0 && id < 4);
+        int wave = next[id][0] == 1000 ? 1 : 0;
+        ASSERT(seq == next[id][wave]);
+        next[id][wave]++;
+    }
+    ttak_logger_stop_async(&logger);
+}
+
+static void slow_sink(ttak_log_level_t level, const char *msg) {
+    (void)level;
+    (void)msg;
+    usleep(1000);
+    async_count++;
+}
+
+static void test_async_drop_counts(void) {
+    ttak_logger_t logger;
+    ttak_logger_init(&logger, slow_sink, TTAK_LOG_INFO);
+    ttak_logger_async_config_t cfg = { .ring_bytes = 8192, .overflow = TTAK_LOG_OVERFLOW_DROP };
+    ASSERT(ttak_logger_start_async(&logger, &cfg));
+    async_count = 0;
+    for (int i = 0; i < 2000; i++) ttak_logger_log(&logger, TTAK_LOG_INFO, "drop %d", i);
+    ttak_logger_flush(&logger);
+    uint64_t dropped = ttak_logger_dropped(&logger);
+    ASSERT(dropped > 0);
+    ASSERT((uint64_t)async_count + dropped == 2000);
+    ttak_logger_stop_async(&logger);
+}
+
+static void test_async_batched_fd(void) {
+    int fds[2];
+    ASSERT(pipe(fds) == 0);
+    ttak_logger_t logger;
+    ttak_logger_init(&logger, NULL, TTAK_LOG_DEBUG);
+    ttak_logger_async_config_t cfg = { .fd = fds[1] };
+    ASSERT(ttak_logger_start_async(&logger, &cfg));
+    for (int i = 0; i < 100; i++) ttak_logger_log(&logger, i % 2 ? TTAK_LOG_ERROR : TTAK_LOG_DEBUG, "line %d", i);
+    ttak_logger_stop_async(&logger);
+    close(fds[1]);
+
+    char buf[4096];
+    size_t got = 0;
+    ssize_t n;
+    while ((n = read(fds[0], buf + got, sizeof(buf) - 1 - got)) > 0) got += (size_t)n;
+    buf[got] = '\0';
+    close(fds[0]);
+    char *line = buf;
+    for (int i = 0; i < 100; i++) {
+        char want[32];
+        snprintf(want, sizeof(want), "[%s] line %d\n", i % 2 ? "ERROR" : "DEBUG", i);
+        ASSERT(strncmp(line, want, strlen(want)) == 0);
+        line += strlen(want);
+    }
+    ASSERT(*line == '\0');
+}
+
+/* --- Binary stream --- */
+
+#define BIN_CAP 64
+
+static ttak_log_bin_entry_t bin_entries[BIN_CAP];
+static char bin_msgs[BIN_CAP][128];
+static int bin_count;
+
+static void bin_sink(const ttak_log_bin_entry_t *entry, void *user) {
+    (void)user;
+    if (bin_count < BIN_CAP) {
+        bin_entries[bin_count] = *entry;
+        snprintf(bin_msgs[bin_count], sizeof(bin_msgs[0]), "%s", entry->msg);
+        if (entry->file) bin_entries[bin_count].file = strstr(entry->file, "test_logger.c") ? "ok" : "bad";
+    }
+    bin_count++;
+}
+
+static int bin_file(void) {
+    char path[] = "/tmp/ttak_binlog_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    unlink(path);
+    return fd;
+}
+
+static uint8_t *bin_read(int fd, size_t *len) {
+    off_t size = lseek(fd, 0, SEEK_END);
+    ASSERT(size > 0);
+    uint8_t *buf = malloc((size_t)size);
+    ASSERT(buf != NULL);
+    ASSERT(pread(fd, buf, (size_t)size, 0) == (ssize_t)size);
+    *len = (size_t)size;
+    return buf;
+}
+
+static void log_bin_stream(ttak_logger_t *logger, int round) {
+    for (int i = 0; i < 3; i++) {
+        TTAK_LOG_BIN(logger, TTAK_LOG_INFO, "round %d item %d of %s", round, i, "three");
+    }
+    TTAK_LOG_BIN(logger, TTAK_LOG_WARN, "%-5s|%*.*f|%lld|%hhu|%c|%.3s|%%", "ab", 8, 2, -1.5, -9000000000LL,
+                 (unsigned char)200, 'q', "truncated");
+    ttak_logger_log(logger, TTAK_LOG_ERROR, "plain %x", 255u);
+    TTAK_LOG_BIN(logger, TTAK_LOG_DEBUG, "filtered %d", round);
+}
+
+static void test_binary_roundtrip(void) {
+    int fd = bin_file();
+    ttak_logger_t logger;
+    ttak_logger_init(&logger, NULL, TTAK_LOG_INFO);
+    ttak_logger_async_config_t cfg = { .fd = fd, .binary = true, .overflow = TTAK_LOG_OVERFLOW_BLOCK };
+    // Two streams in one file; each carries its own dictionary.
+    for (int round = 0; round < 2; round++) {
+        ASSERT(ttak_logger_start_async(&logger, &cfg));
+        log_bin_stream(&logger, round);
+        ttak_logger_stop_async(&logger);
+    }
+
+    size_t len;
+    uint8_t *buf = bin_read(fd, &len);
+    size_t records = 0;
+    bin_count = 0;
+    ASSERT(ttak_logger_bin_decode(buf, len, bin_sink, NULL, &records));
+    ASSERT(records == 10 && bin_count == 10);
+
+    char want[128];
+    snprintf(want, sizeof(want), "%-5s|%*.*f|%lld|%hhu|%c|%.3s|%%", "ab", 8, 2, -1.5, -9000000000LL,
+             (unsigned char)200, 'q', "truncated");
+    for (int round = 0; round < 2; round++) {
+        ttak_log_bin_entry_t *e = &bin_entries[round * 5];
+        for (int i = 0; i < 3; i++) {
+            char item[64];
+            snprintf(item, sizeof(item), "round %d item %d of three", round, i);
+            ASSERT(strcmp(bin_msgs[round * 5 + i], item) == 0);
+            ASSERT(e[i].level == TTAK_LOG_INFO && strcmp(e[i].file, "ok") == 0 && e[i].line == e[0].line);
+        }
+        ASSERT(strcmp(bin_msgs[round * 5 + 3], want) == 0 && e[3].level == TTAK_LOG_WARN);
+        ASSERT(e[3].line > e[0].line && e[3].timestamp_ns >= e[0].timestamp_ns);
+        ASSERT(strcmp(bin_msgs[round * 5 + 4], "plain ff") == 0);
+        ASSERT(e[4].file == NULL && e[4].level == TTAK_LOG_ERROR);
+    }
+
+    // Damage is reported, with the messages before it delivered.
+    bin_count = 0;
+    ASSERT(!ttak_logger_bin_decode(buf, len - 1, bin_sink, NULL, &records));
+    ASSERT(records >= 5 && records < 10);
+    ASSERT(!ttak_logger_bin_decode("not a log", 9, bin_sink, NULL, NULL));
+    free(buf);
+    close(fd);
+}
+
+static void test_binary_sites_elsewhere(void) {
+    // Outside binary mode a site logs like ttak_logger_log().
+    ttak_logger_t logger;
+    ttak_logger_init(&logger, mock_sink, TTAK_LOG_INFO);
+    TTAK_LOG_BIN(&logger, TTAK_LOG_WARN, "sync %s %d", "site", 5);
+    ASSERT(strcmp(last_log, "sync site 5") == 0);
+
+    ttak_logger_async_config_t cfg = { .overflow = TTAK_LOG_OVERFLOW_BLOCK };
+    ttak_logger_init(&logger, async_sink, TTAK_LOG_INFO);
+    ASSERT(ttak_logger_start_async(&logger, &cfg));
+    async_count = 0;
+    TTAK_LOG_BIN(&logger, TTAK_LOG_ERROR, "deferred %u", 7u);
+    ttak_logger_stop_async(&logger);
+    ASSERT(async_count == 1 && strcmp(async_lines[0], "deferred 7") == 0 && async_level == TTAK_LOG_ERROR);
+}
+
+/* --- Call-site limits --- */
+
+static int limit_evals;
+
+static int limit_arg(void) {
+    return ++limit_evals;
+}
+
+static void test_limited_sampling_and_rate(void) {
+    ttak_logger_t logger;
+    ttak_logger_init(&logger, async_sink, TTAK_LOG_INFO);
+    async_count = 0;
+    limit_evals = 0;
+    for (int i = 0; i < 100; i++) TTAK_LOG_LIMITED(&logger, TTAK_LOG_WARN, 0.0, 0.0, 10, "sampled %d", limit_arg());
+    // Suppressed calls never evaluate their arguments.
+    ASSERT(async_count == 10 && limit_evals == 10);
+    ASSERT(strcmp(async_lines[0], "sampled 1") == 0 && strcmp(async_lines[9], "sampled 10") == 0);
+
+    async_count = 0;
+    for (int i = 0; i < 50; i++) TTAK_LOG_LIMITED(&logger, TTAK_LOG_WARN, 0.001, 3.0, 1, "burst %d", i);
+    ASSERT(async_count == 3 && strcmp(async_lines[2], "burst 2") == 0);
+
+    // Filtered levels are neither logged nor counted.
+    async_count = 0;
+    for (int i = 0; i < 5; i++) TTAK_LOG_LIMITED(&logger, TTAK_LOG_DEBUG, 0.001, 1.0, 1, "debug %d", limit_arg());
+    ASSERT(async_count == 0 && limit_evals == 10);
+}
+
+static void test_limited_summary(void) {
+    ttak_logger_t logger;
+    ttak_logger_init(&logger, async_sink, TTAK_LOG_INFO);
+    ttak_log_limit_t lim = TTAK_LOG_LIMIT_INIT(0.001, 1.0, 1);
+    lim.report_ns = 20000000ULL;
+    async_count = 0;
+    for (int i = 0; i < 8; i++) {
+        if (ttak_logger_limit_pass(&logger, &lim, TTAK_LOG_WARN, "site.c", 42)) {
+            ttak_logger_log(&logger, TTAK_LOG_WARN, "storm %d", i);
+        }
+    }
+    ASSERT(async_count == 1 && atomic_load(&lim.suppressed) == 7);
+
+    usleep(60000);
+    ASSERT(!ttak_logger_limit_pass(&logger, &lim, TTAK_LOG_WARN, "site.c", 42));
+    ASSERT(async_count == 2 && strcmp(async_lines[1], "suppressed 8 messages from site.c:42") == 0);
+    ASSERT(async_level == TTAK_LOG_WARN && atomic_load(&lim.suppressed) == 0);
+    // Nothing new to report within the interval.
+    ASSERT(!ttak_logger_limit_pass(&logger, &lim, TTAK_LOG_WARN, "site.c", 42));
+    ASSERT(async_count == 2);
+}
+
 int main(void) {
     RUN_TEST(test_logger_filters_levels);
+    RUN_TEST(test_async_matches_printf);
+    RUN_TEST(test_async_threads_keep_order);
+    RUN_TEST(test_async_drop_counts);
+    RUN_TEST(test_async_batched_fd);
+    RUN_TEST(test_binary_roundtrip);
+    RUN_TEST(test_binary_sites_elsewhere);
+    RUN_TEST(test_limited_sampling_and_rate);
+    RUN_TEST(test_limited_summary);
     return 0;
 }
@@ -0,0 +1,211 @@
+#include <ttak/math/mat4.h>
+#include <ttak/math/matrix.h>
+#include <ttak/math/vector.h>
+#include <ttak/mem/owner.h>
+#include <ttak/timing/timing.h>
+#include "test_macros.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+static double frand(uint64_t *state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double)(*state >> 11) / 9007199254740992.0 * 4.0 - 2.0;
+}
+
+static void naive_mul_d(double *r, const double *a, const double *b) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            double s = 0.0;
+            for (int k = 0; k < 4; k++) s += a[i * 4 + k] * b[k * 4 + j];
+            r[i * 4 + j] = s;
+        }
+    }
+}
+
+void test_mat4_mul_matches_naive() {
+    uint64_t state = 7;
+    for (int iter = 0; iter < 200; iter++) {
+        ttak_mat4d_t a, b, r;
+        ttak_mat4f_t af, bf, rf;
+        for (int i = 0; i < 16; i++) {
+            a.m[i] = frand(&state);
+            b.m[i] = frand(&state);
+            af.m[i] = (float)a.m[i];
+            bf.m[i] = (float)b.m[i];
+        }
+        double expect[16];
+        naive_mul_d(expect, a.m, b.m);
+        ttak_mat4d_mul(&r, &a, &b);
+        ttak_mat4f_mul(&rf, &af, &bf);
+        for (int i = 0; i < 16; i++) {
+            ASSERT(fabs(r.m[i] - expect[i]) < 1e-12);
+            ASSERT(fabs(rf.m[i] - expect[i]) < 1e-4);
+        }
+        /* In-place on either side. */
+        ttak_mat4d_t a2 = a, b2 = b;
+        ttak_mat4d_mul(&a2, &a2, &b);
+        ttak_mat4d_mul(&b2, &a, &b2);
+        for (int i = 0; i < 16; i++) ASSERT(a2.m[i] == r.m[i] && b2.m[i] == r.m[i]);
+        ttak_mat4f_t af2 = af;
+        ttak_mat4f_mul(&af2, &af2, &bf);
+        for (int i = 0; i < 16; i++) ASSERT(af2.m[i] == rf.m[i]);
+    }
+
+    ttak_mat4d_t id, m, r;
+    ttak_mat4d_identity(&id);
+    for (int i = 0; i < 16; i++) m.m[i] = i + 1;
+    ttak_mat4d_mul(&r, &m, &id);
+    for (int i = 0; i < 16; i++) ASSERT(r.m[i] == m.m[i]);
+    ttak_mat4d_transpose(&r, &m);
+    ASSERT(r.m[1] == 5 && r.m[4] == 2 && r.m[15] == 16);
+    ttak_mat4d_transpose(&r, &r);
+    for (int i = 0; i < 16; i++) ASSERT(r.m[i] == m.m[i]);
+}
+
+void test_mat4_transform_matches_mul_vec() {
+    enum { N = 37 };
+    uint64_t state = 11;
+    ttak_mat4f_t mf;
+    ttak_mat4d_t md;
+    for (int i = 0; i < 16; i++) {
+        md.m[i] = frand(&state);
+        mf.m[i] = (float)md.m[i];
+    }
+    ttak_vec4f_t inf[N], outf[N];
+    ttak_vec4d_t ind[N], outd[N];
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < 4; j++) {
+            ind[i].v[j] = frand(&state);
+            inf[i].v[j] = (float)ind[i].v[j];
+        }
+    }
+    ttak_mat4f_transform(&mf, inf, outf, N);
+    ttak_mat4d_transform(&md, ind, outd, N);
+    for (int i = 0; i < N; i++) {
+        ttak_vec4f_t one_f;
+        ttak_vec4d_t one_d;
+        ttak_mat4f_mul_vec(&one_f, &mf, &inf[i]);
+        ttak_mat4d_mul_vec(&one_d, &md, &ind[i]);
+        for (int r = 0; r < 4; r++) {
+            double expect = 0.0;
+            for (int k = 0; k < 4; k++) expect += md.m[r * 4 + k] * ind[i].v[k];
+            ASSERT(fabs(outd[i].v[r] - expect) < 1e-12);
+            ASSERT(fabs(outf[i].v[r] - expect) < 1e-4);
+            ASSERT(one_d.v[r] == outd[i].v[r] && one_f.v[r] == outf[i].v[r]);
+        }
+    }
+    /* In place over the batch. */
+    ttak_mat4d_transform(&md, ind, ind, N);
+    for (int i = 0; i < N; i++) {
+        for (int r = 0; r < 4; r++) ASSERT(ind[i].v[r] == outd[i].v[r]);
+    }
+}
+
+void test_mat4_rotation_and_vec_ops() {
+    ttak_mat4d_t rz;
+    ttak_mat4d_rotation(&rz, 2, M_PI / 2);
+    ttak_vec4d_t x = {{1, 0, 0, 1}}, out;
+    ttak_mat4d_mul_vec(&out, &rz, &x);
+    ASSERT(fabs(out.v[0]) < 1e-15 && fabs(out.v[1] - 1.0) < 1e-15 && out.v[3] == 1.0);
+
+    ttak_mat4f_t rx;
+    ttak_mat4f_rotation(&rx, 0, (float)M_PI / 2);
+    ttak_vec4f_t y = {{0, 1, 0, 0}}, outf;
+    ttak_mat4f_mul_vec(&outf, &rx, &y);
+    ASSERT(fabsf(outf.v[1]) < 1e-6f && fabsf(outf.v[2] - 1.0f) < 1e-6f);
+
+    ttak_vec4d_t a = {{1, 2, 3, 9}}, b = {{4, 5, 6, 9}}, c;
+    ASSERT(ttak_vec4d_dot(&a, &b) == 32 + 81);
+    ttak_vec4d_cross(&c, &a, &b);
+    ASSERT(c.v[0] == -3 && c.v[1] == 6 && c.v[2] == -3 && c.v[3] == 0);
+    ttak_vec4f_t af = {{1, 0, 0, 0}}, bf = {{0, 1, 0, 0}};
+    ttak_vec4f_cross(&af, &af, &bf);
+    ASSERT(af.v[2] == 1.0f && ttak_vec4f_dot(&af, &bf) == 0.0f);
+}
+
+void test_bigreal_double_round_trip() {
+    uint64_t now = ttak_get_tick_count();
+    static const double values[] = {
+        0.0, 1.0, -1.0, 0.5, -0.125, 3.141592653589793, 1e-300, 5e-324, 1.7976931348623157e308,
+        123456789012345678.0, -2.25e15, 0.1, 18446744073709549568.0,
+    };
+    ttak_bigreal_t br;
+    ttak_bigreal_init(&br, now);
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        double back = 0;
+        ASSERT(ttak_bigreal_set_double(&br, values[i], now));
+        ASSERT(ttak_bigreal_to_double(&br, &back));
+        ASSERT_MSG(back == values[i], "round trip of %.17g gave %.17g", values[i], back);
+    }
+    ASSERT(ttak_bigreal_set_double(&br, 0.5, now) && br.exponent == -1);
+    ASSERT(!ttak_bigreal_set_double(&br, NAN, now));
+    ASSERT(!ttak_bigreal_set_double(&br, INFINITY, now));
+
+    /* 10^400 is a valid bigreal but not a double. */
+    ttak_bigreal_init_u64(&br, 1, now);
+    br.exponent = 400;
+    double huge;
+    ASSERT(!ttak_bigreal_to_double(&br, &huge) && isinf(huge));
+    ttak_bigreal_free(&br, now);
+}
+
+void test_bulk_matrix_vector_access() {
+    uint64_t now = ttak_get_tick_count();
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+
+    tt_shared_matrix_t *sm = ttak_matrix_create(3, 3, owner, now);
+    ASSERT(sm != NULL);
+    ttak_bigreal_t vals[9];
+    for (int i = 0; i < 9; i++) ttak_bigreal_init_u64(&vals[i], (uint64_t)i + 1, now);
+    ASSERT(!ttak_matrix_set_all(sm, owner, vals, 8, now));
+    ASSERT(ttak_matrix_set_all(sm, owner, vals, 9, now));
+
+    ttak_mat4d_t md;
+    ASSERT(ttak_matrix_export_f64(sm, owner, &md));
+    ASSERT(md.m[0] == 1 && md.m[2] == 3 && md.m[4] == 4 && md.m[10] == 9);
+    ASSERT(md.m[3] == 0 && md.m[12] == 0 && md.m[15] == 1);
+
+    md.m[0] = -0.75;
+    md.m[10] = 2.5;
+    ASSERT(ttak_matrix_import_f64(sm, owner, &md, now));
+    ASSERT(ttak_matrix_get_all(sm, owner, vals, 9, now));
+    double d;
+    ASSERT(ttak_bigreal_to_double(&vals[0], &d) && d == -0.75);
+    ASSERT(ttak_bigreal_to_double(&vals[8], &d) && d == 2.5);
+    ASSERT(ttak_bigreal_to_double(&vals[5], &d) && d == 6);
+
+    tt_shared_vector_t *sv = ttak_vector_create(3, owner, now);
+    ASSERT(sv != NULL);
+    ASSERT(ttak_vector_set_all(sv, owner, vals, 3, now));
+    ttak_vec4d_t vd;
+    ASSERT(ttak_vector_export_f64(sv, owner, &vd));
+    ASSERT(vd.v[0] == -0.75 && vd.v[1] == 2 && vd.v[2] == 3 && vd.v[3] == 0);
+    ttak_vec4d_t moved;
+    ttak_mat4d_mul_vec(&moved, &md, &vd);
+    ASSERT(ttak_vector_import_f64(sv, owner, &moved, now));
+    ASSERT(ttak_vector_get_all(sv, owner, vals, 3, now));
+    ASSERT(ttak_bigreal_to_double(&vals[2], &d) && fabs(d - (7 * -0.75 + 8 * 2 + 2.5 * 3)) < 1e-12);
+    ASSERT(!ttak_vector_get_all(sv, owner, vals, 4, now));
+
+    ttak_owner_t *stranger = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(!ttak_matrix_export_f64(sm, stranger, &md));
+    ASSERT(!ttak_vector_set_all(sv, stranger, vals, 3, now));
+    ttak_owner_destroy(stranger);
+
+    for (int i = 0; i < 9; i++) ttak_bigreal_free(&vals[i], now);
+    ttak_vector_destroy(sv, now);
+    ttak_shared_destroy(&sm->base);
+    free(sm);
+    ttak_owner_destroy(owner);
+}
+
+int main() {
+    RUN_TEST(test_mat4_mul_matches_naive);
+    RUN_TEST(test_mat4_transform_matches_mul_vec);
+    RUN_TEST(test_mat4_rotation_and_vec_ops);
+    RUN_TEST(test_bigreal_double_round_trip);
+    RUN_TEST(test_bulk_matrix_vector_access);
+    return 0;
+}
@@ -1,19 +1,44 @@
 #include <ttak/math/bigint.h>
+#include <ttak/math/bigint_accel.h>
+#include <ttak/math/bigint_mont.h>
 #include <ttak/math/bigmul.h>
+#include <ttak/math/factor.h>
+#include <ttak/math/limbs.h>
+#include <ttak/security/sha256.h>
 #include <ttak/mem/mem.h>
+#include <ttak/async/future.h>
 #include "test_macros.h"
 #include <string.h>
+#include <stdlib.h>
 
 static uint64_t bigint_as_u64(const ttak_bigint_t *bi) {
     const limb_t *limbs = bi->is_dynamic ? bi->data.dyn_ptr : bi->data.sso_buf;
     uint64_t value = 0;
-    size_t max_limbs = bi->used < 2 ? bi->used : 2;
+    const size_t per_u64 = 64 / TTAK_BIGINT_LIMB_BITS;
+    size_t max_limbs = bi->used < per_u64 ? bi->used : per_u64;
     for (size_t i = 0; i < max_limbs; ++i) {
-        value |= ((uint64_t)limbs[i]) << (i * 32);
+        value |= ((uint64_t)limbs[i]) << (i * TTAK_BIGINT_LIMB_BITS);
     }
     return value;
 }
 
+void test_bigint_accel_warmup_matches_availability() {
+    bool available = ttak_bigint_accel_warmup();
+    ASSERT(available == ttak_bigint_accel_available());
+    ASSERT(ttak_bigint_accel_min_limbs() > 0);
+}
+
+void test_bigint_accel_calibrate_applies_threshold() {
+    size_t before = ttak_bigint_accel_min_limbs();
+    size_t measured = ttak_bigint_accel_calibrate(0);
+    if (!ttak_bigint_accel_available()) {
+        ASSERT(measured == 0);
+        ASSERT(ttak_bigint_accel_min_limbs() == before);
+    } else if (measured != 0 && getenv("TTAK_BIGINT_ACCEL_THRESHOLD") == NULL) {
+        ASSERT(ttak_bigint_accel_min_limbs() == measured);
+    }
+}
+
 void test_bigint_init() {
     ttak_bigint_t *bi = ttak_mem_alloc_raw(sizeof(ttak_bigint_t), __TTAK_UNSAFE_MEM_FOREVER__, 0);
     ASSERT(bi != NULL);
@@ -70,10 +95,610 @@ void test_bigint_unit_ops() {
     ttak_bigint_free(&sum, 18);
 }
 
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+static limb_t rand_limb(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    // Bias towards all-ones limbs so carries ripple through whole arrays.
+    return (rng_state & 7) == 0 ? (limb_t)-1 : (limb_t)rng_state;
+}
+
+void test_limb_kernels_match_reference() {
+    enum { N = 37 };
+    limb_t a[N], b[N], r[N], ref[N];
+    for (int round = 0; round < 200; ++round) {
+        size_t n = (size_t)round % N + 1;
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = rand_limb();
+            b[i] = rand_limb();
+            r[i] = rand_limb();
+        }
+        limb_t m = rand_limb();
+
+        ttak_dlimb_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            acc += (ttak_dlimb_t)a[i] + b[i];
+            ref[i] = (limb_t)acc;
+            acc >>= TTAK_BIGINT_LIMB_BITS;
+        }
+        ASSERT(ttak_limbs_add_n(r, a, b, n) == (limb_t)acc);
+        ASSERT(memcmp(r, ref, n * sizeof(limb_t)) == 0);
+
+        limb_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            ttak_dlimb_t d = (ttak_dlimb_t)a[i] - b[i] - borrow;
+            ref[i] = (limb_t)d;
+            borrow = (limb_t)(d >> TTAK_BIGINT_LIMB_BITS) & 1;
+        }
+        ASSERT(ttak_limbs_sub_n(r, a, b, n) == borrow);
+        ASSERT(memcmp(r, ref, n * sizeof(limb_t)) == 0);
+
+        limb_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            ttak_dlimb_t p = (ttak_dlimb_t)a[i] * m + b[i] + carry;
+            ref[i] = (limb_t)p;
+            carry = (limb_t)(p >> TTAK_BIGINT_LIMB_BITS);
+        }
+        memcpy(r, b, n * sizeof(limb_t));
+        ASSERT(ttak_limbs_addmul_1(r, a, n, m) == carry);
+        ASSERT(memcmp(r, ref, n * sizeof(limb_t)) == 0);
+
+        // submul_1 undoes addmul_1.
+        ASSERT(ttak_limbs_submul_1(r, a, n, m) == carry);
+        ASSERT(memcmp(r, b, n * sizeof(limb_t)) == 0);
+
+        limb_t hi = ttak_limbs_mul_1(r, a, n, m);
+        memset(ref, 0, sizeof(ref));
+        ASSERT(ttak_limbs_addmul_1(ref, a, n, m) == hi);
+        ASSERT(memcmp(r, ref, n * sizeof(limb_t)) == 0);
+
+        // Results may be written over an operand.
+        memcpy(r, a, n * sizeof(limb_t));
+        limb_t c1 = ttak_limbs_add_n(r, r, b, n);
+        ASSERT(ttak_limbs_sub_n(r, r, b, n) == c1 && memcmp(r, a, n * sizeof(limb_t)) == 0);
+    }
+    ASSERT(ttak_limbs_kernel_name() != NULL);
+}
+
+void test_limb_mul_ladder_matches_basecase() {
+    static const size_t sizes[][2] = {
+        { 1, 1 }, { 5, 3 }, { 33, 33 }, { 40, 21 }, { 100, 99 }, { 129, 129 },
+        { 200, 150 }, { 300, 101 }, { 513, 257 }, { 700, 700 }, { 2100, 2050 },
+    };
+    static const ttak_limbs_mul_algo_t algos[] = {
+        TTAK_LIMBS_MUL_AUTO, TTAK_LIMBS_MUL_KARATSUBA, TTAK_LIMBS_MUL_TOOM3, TTAK_LIMBS_MUL_NTT,
+        TTAK_LIMBS_MUL_FFT,
+    };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        size_t an = sizes[s][0], bn = sizes[s][1];
+        limb_t *a = malloc(an * sizeof(limb_t));
+        limb_t *b = malloc(bn * sizeof(limb_t));
+        limb_t *ref = malloc(2 * an * sizeof(limb_t));
+        limb_t *r = malloc(2 * an * sizeof(limb_t));
+        ASSERT(a && b && ref && r);
+        // Odd rounds use all-ones operands, the worst case for every carry.
+        for (int round = 0; round < 2; ++round) {
+            for (size_t i = 0; i < an; ++i) a[i] = round ? (limb_t)-1 : rand_limb();
+            for (size_t i = 0; i < bn; ++i) b[i] = round ? (limb_t)-1 : rand_limb();
+            ttak_limbs_mul_basecase(ref, a, an, b, bn);
+            for (size_t k = 0; k < sizeof(algos) / sizeof(algos[0]); ++k) {
+                memset(r, 0xA5, (an + bn) * sizeof(limb_t));
+                ASSERT(ttak_limbs_mul_algo(r, b, bn, a, an, algos[k], 0));
+                ASSERT(memcmp(r, ref, (an + bn) * sizeof(limb_t)) == 0);
+            }
+            // Squares take the NTT path that transforms one operand.
+            ttak_limbs_mul_basecase(ref, a, an, a, an);
+            ASSERT(ttak_limbs_mul_algo(r, a, an, a, an, TTAK_LIMBS_MUL_NTT, 0));
+            ASSERT(memcmp(r, ref, 2 * an * sizeof(limb_t)) == 0);
+        }
+        free(a);
+        free(b);
+        free(ref);
+        free(r);
+    }
+}
+
+typedef struct {
+    ttak_thread_pool_t *pool;
+    const limb_t *a, *b;
+    size_t an, bn;
+    limb_t *r;
+} mul_job_t;
+
+static void *mul_on_pool(void *arg) {
+    mul_job_t *job = arg;
+    return (void *)(uintptr_t)ttak_limbs_mul_parallel(job->r, job->a, job->an, job->b, job->bn, job->pool, 0);
+}
+
+void test_limb_mul_parallel_matches_serial() {
+    // The first fits one NTT block, the others need column passes too; Toom-3 is the reference.
+    static const size_t sizes[][2] = { { 8192, 8192 }, { 40000, 40000 }, { 70000, 9000 } };
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, 0);
+    ASSERT(pool != NULL);
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        size_t an = sizes[s][0], bn = sizes[s][1];
+        limb_t *a = malloc(an * sizeof(limb_t));
+        limb_t *b = malloc(bn * sizeof(limb_t));
+        limb_t *ref = malloc(2 * an * sizeof(limb_t));
+        limb_t *r = malloc(2 * an * sizeof(limb_t));
+        ASSERT(a && b && ref && r);
+        for (size_t i = 0; i < an; ++i) a[i] = rand_limb();
+        for (size_t i = 0; i < bn; ++i) b[i] = rand_limb();
+        ASSERT(ttak_limbs_mul_algo(ref, a, an, b, bn, TTAK_LIMBS_MUL_TOOM3, 0));
+        memset(r, 0xA5, (an + bn) * sizeof(limb_t));
+        ASSERT(ttak_limbs_mul_parallel(r, a, an, b, bn, pool, 0));
+        ASSERT(memcmp(r, ref, (an + bn) * sizeof(limb_t)) == 0);
+
+        ASSERT(ttak_limbs_mul_algo(ref, a, an, a, an, TTAK_LIMBS_MUL_TOOM3, 0));
+        ASSERT(ttak_limbs_mul_parallel(r, a, an, a, an, pool, 0));
+        ASSERT(memcmp(r, ref, 2 * an * sizeof(limb_t)) == 0);
+        free(a);
+        free(b);
+        free(ref);
+        free(r);
+    }
+    ttak_thread_pool_destroy(pool);
+
+    // Called from the only worker, the product must not wait on itself.
+    pool = ttak_thread_pool_create(1, 0, 0);
+    ASSERT(pool != NULL);
+    size_t n = 20000;
+    limb_t *a = malloc(n * sizeof(limb_t));
+    limb_t *ref = malloc(2 * n * sizeof(limb_t));
+    limb_t *r = malloc(2 * n * sizeof(limb_t));
+    ASSERT(a && ref && r);
+    for (size_t i = 0; i < n; ++i) a[i] = rand_limb();
+    ASSERT(ttak_limbs_mul_algo(ref, a, n, a, n, TTAK_LIMBS_MUL_TOOM3, 0));
+    mul_job_t job = { pool, a, a, n, n, r };
+    ttak_future_t *fut = ttak_thread_pool_submit_task(pool, mul_on_pool, &job, 0, 0);
+    ASSERT(fut != NULL);
+    ASSERT(ttak_future_get(fut) == (void *)(uintptr_t)1);
+    ASSERT(memcmp(r, ref, 2 * n * sizeof(limb_t)) == 0);
+    ttak_thread_pool_destroy(pool);
+    free(a);
+    free(ref);
+    free(r);
+}
+
+static void set_random(ttak_bigint_t *bi, size_t bytes) {
+    ttak_bigint_set_u64(bi, 0, 0);
+    for (size_t i = 0; i < bytes; i += 8) {
+        ttak_bigint_mul_u64(bi, bi, 1ULL << 32, 0);
+        ttak_bigint_mul_u64(bi, bi, 1ULL << 32, 0);
+        ttak_bigint_add_u64(bi, bi, (uint64_t)rand_limb() | 1, 0);
+    }
+}
+
+void test_limb_divrem_recovers_operands() {
+    // Quotient and divisor lengths on both sides of the recursion threshold.
+    static const size_t sizes[][2] = {
+        { 1, 1 }, { 7, 3 }, { 60, 50 }, { 200, 49 }, { 513, 300 }, { 3000, 1100 }, { 5000, 2600 },
+    };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        size_t qn = sizes[s][0], dn = sizes[s][1];
+        size_t nn = qn + dn;
+        limb_t *q = malloc(qn * sizeof(limb_t));
+        limb_t *d = malloc(dn * sizeof(limb_t));
+        limb_t *n = malloc(nn * sizeof(limb_t));
+        limb_t *got_q = malloc((nn - dn + 1) * sizeof(limb_t));
+        limb_t *got_r = malloc(dn * sizeof(limb_t));
+        limb_t *rm = malloc(dn * sizeof(limb_t));
+        ASSERT(q && d && n && got_q && got_r && rm);
+        // Rounds: random, all-ones (quotient digits at the clamp), a small top limb (large shift).
+        for (int round = 0; round < 3; ++round) {
+            for (size_t i = 0; i < qn; ++i) q[i] = round == 1 ? (limb_t)-1 : rand_limb();
+            for (size_t i = 0; i < dn; ++i) d[i] = round == 1 ? (limb_t)-1 : rand_limb();
+            if (round == 2) d[dn - 1] = 3;
+            if (d[dn - 1] == 0) d[dn - 1] = 1;
+            ASSERT(ttak_limbs_mul(n, q, qn, d, dn, 0));
+            // Add the largest remainder, d - 1.
+            memcpy(rm, d, dn * sizeof(limb_t));
+            for (size_t i = 0; i < dn && rm[i]-- == 0; ++i) {}
+            limb_t carry = ttak_limbs_add_n(n, n, rm, dn);
+            for (size_t i = dn; carry && i < nn; ++i) carry = ++n[i] == 0;
+            ASSERT(carry == 0);
+
+            memset(got_q, 0xA5, (nn - dn + 1) * sizeof(limb_t));
+            ASSERT(ttak_limbs_divrem(got_q, got_r, n, nn, d, dn, 0));
+            ASSERT(memcmp(got_q, q, qn * sizeof(limb_t)) == 0 && got_q[qn] == 0);
+            ASSERT(memcmp(got_r, rm, dn * sizeof(limb_t)) == 0);
+            memset(got_r, 0, dn * sizeof(limb_t));
+            ASSERT(ttak_limbs_divrem(NULL, got_r, n, nn, d, dn, 0));
+            ASSERT(memcmp(got_r, rm, dn * sizeof(limb_t)) == 0);
+        }
+        free(q);
+        free(d);
+        free(n);
+        free(got_q);
+        free(got_r);
+        free(rm);
+    }
+}
+
+void test_bigint_to_string_long() {
+    // 10^k - 1 and 10^k sit on either side of a power the split divides by.
+    const size_t k = 20000;
+    ttak_bigint_t x;
+    ttak_bigint_init(&x, 0);
+    ASSERT(ttak_bigint_set_u64(&x, 1, 0));
+    for (size_t i = 0; i < k; ++i) ASSERT(ttak_bigint_mul_u64(&x, &x, 10, 0));
+    char *str = ttak_bigint_to_string(&x, 0);
+    ASSERT(str && strlen(str) == k + 1 && str[0] == '1');
+    for (size_t i = 1; i <= k; ++i) ASSERT(str[i] == '0');
+    ttak_mem_free(str);
+
+    ttak_bigint_t one;
+    ttak_bigint_init_u64(&one, 1, 0);
+    ASSERT(ttak_bigint_sub(&x, &x, &one, 0));
+    str = ttak_bigint_to_string(&x, 0);
+    ASSERT(str && strlen(str) == k);
+    for (size_t i = 0; i < k; ++i) ASSERT(str[i] == '9');
+    ttak_mem_free(str);
+
+    // A random value against digit-by-digit division.
+    set_random(&x, 4000);
+    x.is_negative = true;
+    str = ttak_bigint_to_string(&x, 0);
+    ASSERT(str && str[0] == '-');
+    ttak_bigint_t t, rem;
+    ttak_bigint_init_copy(&t, &x, 0);
+    ttak_bigint_init(&rem, 0);
+    t.is_negative = false;
+    size_t len = strlen(str);
+    for (size_t i = len; i-- > 1;) {
+        ASSERT(ttak_bigint_div_u64(&t, &rem, &t, 10, 0));
+        ASSERT(str[i] == (char)('0' + bigint_as_u64(&rem)));
+    }
+    ASSERT(ttak_bigint_is_zero(&t));
+    ttak_mem_free(str);
+    ttak_bigint_free(&t, 0);
+    ttak_bigint_free(&rem, 0);
+    ttak_bigint_free(&one, 0);
+    ttak_bigint_free(&x, 0);
+}
+
+void test_bigint_mul_div_roundtrip() {
+    ttak_bigint_t n, d, q, r, back;
+    ttak_bigint_init(&n, 0);
+    ttak_bigint_init(&d, 0);
+    ttak_bigint_init(&q, 0);
+    ttak_bigint_init(&r, 0);
+    ttak_bigint_init(&back, 0);
+    for (size_t round = 0; round < 40; ++round) {
+        set_random(&n, 8 + round * 12);
+        set_random(&d, 8 + (round % 7) * 9);
+        ASSERT(ttak_bigint_div(&q, &r, &n, &d, 0));
+        ASSERT(ttak_bigint_cmp(&r, &d) < 0);
+        ASSERT(ttak_bigint_mul(&back, &q, &d, 0));
+        ASSERT(ttak_bigint_add(&back, &back, &r, 0));
+        ASSERT(ttak_bigint_cmp(&back, &n) == 0);
+        ASSERT(ttak_bigint_sub(&back, &back, &r, 0));
+        ASSERT(ttak_bigint_sub(&back, &back, &n, 0));
+        ASSERT(ttak_bigint_cmp_u64(&back, 0) < 0 || ttak_bigint_is_zero(&r));
+    }
+
+    // 64-bit divisors above 2^32, and a remainder check against native arithmetic.
+    ASSERT(ttak_bigint_set_u64(&n, 0xFFFFFFFFFFFFFFFFULL, 0));
+    ASSERT(ttak_bigint_mul_u64(&n, &n, 0xFFFFFFFFFFFFFFFFULL, 0));
+    ASSERT(ttak_bigint_div_u64(&q, &r, &n, 0x1234567890ABCDEFULL, 0));
+    ASSERT(ttak_bigint_mul_u64(&back, &q, 0x1234567890ABCDEFULL, 0));
+    ASSERT(ttak_bigint_add(&back, &back, &r, 0));
+    ASSERT(ttak_bigint_cmp(&back, &n) == 0);
+    ASSERT(ttak_bigint_cmp_u64(&r, 0x1234567890ABCDEFULL) < 0);
+    ASSERT(ttak_bigint_set_u64(&n, 1000000007ULL * 998244353ULL + 12345, 0));
+    ASSERT(ttak_bigint_mod_u64(&r, &n, 998244353ULL * 3, 0));
+    ASSERT(bigint_as_u64(&r) == (1000000007ULL * 998244353ULL + 12345) % (998244353ULL * 3));
+
+    char *str = ttak_bigint_to_string(&back, 0);
+    ASSERT(str && strcmp(str, "340282366920938463426481119284349108225") == 0);
+    ttak_mem_free(str);
+
+    ttak_bigint_free(&n, 0);
+    ttak_bigint_free(&d, 0);
+    ttak_bigint_free(&q, 0);
+    ttak_bigint_free(&r, 0);
+    ttak_bigint_free(&back, 0);
+}
+
+void test_bigint_aliased_operands() {
+    ttak_bigint_t a, b, x, ref, q, r, q_ref, r_ref;
+    ttak_bigint_t *all[] = { &a, &b, &x, &ref, &q, &r, &q_ref, &r_ref };
+    for (size_t i = 0; i < 8; ++i) ttak_bigint_init(all[i], 0);
+
+    static const size_t sizes[] = { 8, 16, 24, 40, 200, 4000 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        set_random(&a, sizes[i]);
+        set_random(&b, sizes[(i + 3) % 6]);
+        a.is_negative = (i & 1) != 0;
+
+        // dst == lhs, dst == rhs and dst == lhs == rhs against a distinct destination.
+        ASSERT(ttak_bigint_mul(&ref, &a, &b, 0));
+        ASSERT(ttak_bigint_copy(&x, &a, 0));
+        ASSERT(ttak_bigint_mul(&x, &x, &b, 0));
+        ASSERT(ttak_bigint_cmp(&x, &ref) == 0);
+        ASSERT(ttak_bigint_copy(&x, &b, 0));
+        ASSERT(ttak_bigint_mul(&x, &a, &x, 0));
+        ASSERT(ttak_bigint_cmp(&x, &ref) == 0);
+        ASSERT(ttak_bigint_mul(&ref, &a, &a, 0));
+        ASSERT(ttak_bigint_copy(&x, &a, 0));
+        ASSERT(ttak_bigint_mul(&x, &x, &x, 0));
+        ASSERT(ttak_bigint_cmp(&x, &ref) == 0);
+
+        ASSERT(ttak_bigint_mul_u64(&ref, &a, 0xFEDCBA9876543210ULL, 0));
+        ASSERT(ttak_bigint_copy(&x, &a, 0));
+        ASSERT(ttak_bigint_mul_u64(&x, &x, 0xFEDCBA9876543210ULL, 0));
+        ASSERT(ttak_bigint_cmp(&x, &ref) == 0);
+
+        ASSERT(ttak_bigint_div_u64(&q_ref, &r_ref, &a, 0x9E3779B97F4A7C15ULL, 0));
+        ASSERT(ttak_bigint_copy(&x, &a, 0));
+        ASSERT(ttak_bigint_div_u64(&x, &r, &x, 0x9E3779B97F4A7C15ULL, 0));
+        ASSERT(ttak_bigint_cmp(&x, &q_ref) == 0 && ttak_bigint_cmp(&r, &r_ref) == 0);
+
+        // Quotient over the dividend and remainder over the divisor.
+        set_random(&a, sizes[i] + 64);
+        ASSERT(ttak_bigint_div(&q_ref, &r_ref, &a, &b, 0));
+        ASSERT(ttak_bigint_copy(&q, &a, 0));
+        ASSERT(ttak_bigint_copy(&r, &b, 0));
+        ASSERT(ttak_bigint_div(&q, &r, &q, &r, 0));
+        ASSERT(ttak_bigint_cmp(&q, &q_ref) == 0 && ttak_bigint_cmp(&r, &r_ref) == 0);
+        ASSERT(ttak_bigint_copy(&r, &a, 0));
+        ASSERT(ttak_bigint_mod(&r, &r, &b, 0));
+        ASSERT(ttak_bigint_cmp(&r, &r_ref) == 0);
+    }
+
+    for (size_t i = 0; i < 8; ++i) ttak_bigint_free(all[i], 0);
+    ttak_bigint_scratch_release();
+}
+
+/* Square-and-multiply with a full division per step. */
+static void powmod_reference(ttak_bigint_t *dst, const ttak_bigint_t *base, const ttak_bigint_t *exp,
+                             const ttak_bigint_t *n) {
+    ttak_bigint_t b, e, bit;
+    ttak_bigint_init(&b, 0);
+    ttak_bigint_init_copy(&e, exp, 0);
+    ttak_bigint_init(&bit, 0);
+    ttak_bigint_mod(&b, base, n, 0);
+    if (b.is_negative) ttak_bigint_add(&b, &b, n, 0);
+    ttak_bigint_set_u64(dst, 1, 0);
+    while (!ttak_bigint_is_zero(&e)) {
+        ttak_bigint_div_u64(&e, &bit, &e, 2, 0);
+        if (!ttak_bigint_is_zero(&bit)) {
+            ttak_bigint_mul(dst, dst, &b, 0);
+            ttak_bigint_mod(dst, dst, n, 0);
+        }
+        ttak_bigint_mul(&b, &b, &b, 0);
+        ttak_bigint_mod(&b, &b, n, 0);
+    }
+    ttak_bigint_free(&b, 0);
+    ttak_bigint_free(&e, 0);
+    ttak_bigint_free(&bit, 0);
+}
+
+void test_bigint_mont_powmod_matches_reference() {
+    ttak_bigint_t n, base, exp, got, want, a_f, b_f;
+    ttak_bigint_t *all[] = { &n, &base, &exp, &got, &want, &a_f, &b_f };
+    for (size_t i = 0; i < 7; ++i) ttak_bigint_init(all[i], 0);
+
+    static const size_t mod_bytes[] = { 8, 16, 64, 136, 512 };
+    for (size_t i = 0; i < 10; ++i) {
+        set_random(&n, mod_bytes[i % 5]);
+        if (i >= 5) ASSERT(ttak_bigint_mul_u64(&n, &n, 6, 0)); // Even moduli run Barrett.
+        set_random(&base, mod_bytes[(i + 2) % 5]);
+        base.is_negative = (i % 3) == 0;
+        set_random(&exp, 8 + (i % 4) * 24);
+
+        ttak_bigint_mont_ctx_t ctx;
+        ASSERT(ttak_bigint_mont_init(&ctx, &n, 0));
+        ASSERT(ctx.barrett == (i >= 5));
+        powmod_reference(&want, &base, &exp, &n);
+        ASSERT(ttak_bigint_mont_powmod(&ctx, &got, &base, &exp, 0));
+        ASSERT(ttak_bigint_cmp(&got, &want) == 0);
+        ASSERT(ttak_bigint_powmod(&got, &base, &exp, &n, 0));
+        ASSERT(ttak_bigint_cmp(&got, &want) == 0);
+
+        // The comb covers the exponent, then falls back for a longer one.
+        ttak_bigint_mont_comb_t comb;
+        ASSERT(ttak_bigint_mont_comb_init(&comb, &ctx, &base, ttak_bigint_get_bit_length(&exp) + 5, 0));
+        ASSERT(ttak_bigint_mont_comb_powmod(&comb, &got, &exp, 0));
+        ASSERT(ttak_bigint_cmp(&got, &want) == 0);
+        ASSERT(ttak_bigint_mul(&exp, &exp, &exp, 0));
+        powmod_reference(&want, &base, &exp, &n);
+        ASSERT(ttak_bigint_mont_comb_powmod(&comb, &got, &exp, 0));
+        ASSERT(ttak_bigint_cmp(&got, &want) == 0);
+        ttak_bigint_set_u64(&exp, 0, 0);
+        ASSERT(ttak_bigint_mont_comb_powmod(&comb, &got, &exp, 0));
+        ASSERT(ttak_bigint_cmp_u64(&got, 1) == 0);
+        ttak_bigint_mont_comb_free(&comb);
+
+        // Products in internal form against mul + mod.
+        set_random(&exp, mod_bytes[(i + 4) % 5]);
+        ASSERT(ttak_bigint_mul(&want, &base, &exp, 0));
+        ASSERT(ttak_bigint_mod(&want, &want, &n, 0));
+        if (want.is_negative) ASSERT(ttak_bigint_add(&want, &want, &n, 0));
+        ASSERT(ttak_bigint_mont_to(&ctx, &a_f, &base, 0));
+        ASSERT(ttak_bigint_mont_to(&ctx, &b_f, &exp, 0));
+        ASSERT(ttak_bigint_mont_mul(&ctx, &a_f, &a_f, &b_f, 0));
+        ASSERT(ttak_bigint_mont_from(&ctx, &got, &a_f, 0));
+        ASSERT(ttak_bigint_cmp(&got, &want) == 0);
+        ASSERT(ttak_bigint_mulmod(&got, &base, &exp, &n, 0));
+        ASSERT(ttak_bigint_cmp(&got, &want) == 0);
+        ttak_bigint_mont_free(&ctx);
+    }
+
+    // Fermat on the Mersenne prime 2^127 - 1.
+    ASSERT(ttak_bigint_set_u128(&n, ttak_u128_make(0x7FFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL), 0));
+    ASSERT(ttak_bigint_set_u128(&exp, ttak_u128_make(0x7FFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFEULL), 0));
+    ASSERT(ttak_bigint_set_u64(&base, 3, 0));
+    ASSERT(ttak_bigint_powmod(&got, &base, &exp, &n, 0));
+    ASSERT(ttak_bigint_cmp_u64(&got, 1) == 0);
+
+    for (size_t i = 0; i < 7; ++i) ttak_bigint_free(all[i], 0);
+}
+
+void test_factor_big_stops_at_prime_cofactor() {
+    ttak_bigint_t n;
+    ttak_bigint_init(&n, 0);
+    // 15 * (2^127 - 1): trial division alone would hit its step limit.
+    ASSERT(ttak_bigint_set_u128(&n, ttak_u128_make(0x7FFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL), 0));
+    ASSERT(ttak_bigint_mul_u64(&n, &n, 15, 0));
+    ttak_prime_factor_big_t *factors = NULL;
+    size_t count = 0;
+    ASSERT(ttak_factor_big(&n, &factors, &count, 0) == 0);
+    ASSERT(count == 3);
+    ASSERT(ttak_bigint_cmp_u64(&factors[0].p, 3) == 0 && factors[0].a == 1);
+    ASSERT(ttak_bigint_cmp_u64(&factors[1].p, 5) == 0 && factors[1].a == 1);
+    ASSERT(ttak_bigint_get_bit_length(&factors[2].p) == 127);
+    for (size_t i = 0; i < count; ++i) ttak_bigint_free(&factors[i].p, 0);
+    ttak_mem_free(factors);
+    ttak_bigint_free(&n, 0);
+}
+
+static void set_decimal(ttak_bigint_t *bi, const char *digits) {
+    ASSERT(ttak_bigint_set_u64(bi, 0, 0));
+    for (const char *c = digits; *c; ++c) {
+        ASSERT(ttak_bigint_mul_u64(bi, bi, 10, 0));
+        ASSERT(ttak_bigint_add_u64(bi, bi, (uint64_t)(*c - '0'), 0));
+    }
+}
+
+void test_bigint_signed_add_sub() {
+    ttak_bigint_t a, b, r;
+    ttak_bigint_init_u64(&a, 7, 0);
+    ttak_bigint_init_u64(&b, 10, 0);
+    ttak_bigint_init(&r, 0);
+    b.is_negative = true;
+    ASSERT(ttak_bigint_add(&r, &a, &b, 0)); // 7 + -10
+    ASSERT(r.is_negative);
+    ASSERT(ttak_bigint_add_u64(&r, &r, 3, 0) && ttak_bigint_is_zero(&r));
+    ASSERT(ttak_bigint_sub(&r, &a, &b, 0) && ttak_bigint_cmp_u64(&r, 17) == 0); // 7 - -10
+    ASSERT(ttak_bigint_sub(&r, &b, &a, 0) && r.is_negative); // -10 - 7
+    ASSERT(ttak_bigint_add_u64(&r, &r, 17, 0) && ttak_bigint_is_zero(&r));
+    ASSERT(ttak_bigint_sub(&r, &b, &b, 0) && ttak_bigint_is_zero(&r));
+    ttak_bigint_free(&a, 0);
+    ttak_bigint_free(&b, 0);
+    ttak_bigint_free(&r, 0);
+}
+
+void test_factor_ecm_finds_15_digit_factor() {
+    ttak_bigint_t n, q, f;
+    ttak_bigint_init(&n, 0);
+    ttak_bigint_init(&q, 0);
+    ttak_bigint_init(&f, 0);
+    set_decimal(&n, "544529763028297");
+    set_decimal(&q, "651609842485723421852387861941");
+    ASSERT(ttak_bigint_mul(&n, &n, &q, 0));
+    ttak_factor_ecm_params_t params = { 2000, 0, 300, 1 };
+    ASSERT(ttak_factor_ecm(&n, &params, NULL, &f, 0) == 1);
+    ASSERT(ttak_bigint_cmp_u64(&f, 544529763028297ULL) == 0 || ttak_bigint_cmp(&f, &q) == 0);
+    ttak_bigint_free(&n, 0);
+    ttak_bigint_free(&q, 0);
+    ttak_bigint_free(&f, 0);
+}
+
+void test_factor_siqs_splits_40_digit_semiprime() {
+    ttak_bigint_t n, p, q, f;
+    ttak_bigint_init(&n, 0);
+    ttak_bigint_init(&p, 0);
+    ttak_bigint_init(&q, 0);
+    ttak_bigint_init(&f, 0);
+    set_decimal(&p, "58205312626925217407");
+    set_decimal(&q, "65941320597534372071");
+    ASSERT(ttak_bigint_mul(&n, &p, &q, 0));
+    ASSERT(ttak_factor_siqs(&n, NULL, &f, 0) == 1);
+    ASSERT(ttak_bigint_cmp(&f, &p) == 0 || ttak_bigint_cmp(&f, &q) == 0);
+    ttak_bigint_free(&n, 0);
+    ttak_bigint_free(&p, 0);
+    ttak_bigint_free(&q, 0);
+    ttak_bigint_free(&f, 0);
+}
+
+void test_factor_big_splits_large_cofactors() {
+    ttak_bigint_t n, p, q;
+    ttak_bigint_init(&n, 0);
+    ttak_bigint_init(&p, 0);
+    ttak_bigint_init(&q, 0);
+    // 12 * p22 * p21^2: trial division, a perfect square and a 43-digit semiprime on the way.
+    set_decimal(&p, "6291738931427273549201");
+    set_decimal(&q, "879725332136096265959");
+    ASSERT(ttak_bigint_mul(&n, &p, &q, 0));
+    ASSERT(ttak_bigint_mul(&n, &n, &q, 0));
+    ASSERT(ttak_bigint_mul_u64(&n, &n, 12, 0));
+    ttak_prime_factor_big_t *factors = NULL;
+    size_t count = 0;
+    ASSERT(ttak_factor_big(&n, &factors, &count, 0) == 0);
+    ASSERT(count == 4);
+    uint32_t seen = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (ttak_bigint_cmp_u64(&factors[i].p, 2) == 0 && factors[i].a == 2) seen |= 1;
+        if (ttak_bigint_cmp_u64(&factors[i].p, 3) == 0 && factors[i].a == 1) seen |= 2;
+        if (ttak_bigint_cmp(&factors[i].p, &p) == 0 && factors[i].a == 1) seen |= 4;
+        if (ttak_bigint_cmp(&factors[i].p, &q) == 0 && factors[i].a == 2) seen |= 8;
+        ttak_bigint_free(&factors[i].p, 0);
+    }
+    ASSERT(seen == 15);
+    ttak_mem_free(factors);
+
+    // p21 * p22 alone has no perfect power to take apart and goes to ECM, then the sieve.
+    ASSERT(ttak_bigint_mul(&n, &p, &q, 0));
+    ASSERT(ttak_factor_big(&n, &factors, &count, 0) == 0);
+    ASSERT(count == 2);
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT(ttak_bigint_cmp(&factors[i].p, &p) == 0 || ttak_bigint_cmp(&factors[i].p, &q) == 0);
+        ttak_bigint_free(&factors[i].p, 0);
+    }
+    ttak_mem_free(factors);
+    ttak_bigint_free(&n, 0);
+    ttak_bigint_free(&p, 0);
+    ttak_bigint_free(&q, 0);
+}
+
+void test_bigint_words_and_hash() {
+    ttak_bigint_t bi;
+    ttak_bigint_init(&bi, 0);
+    ttak_u256_t v = ttak_u256_from_limbs(0x0123456789ABCDEFULL, 0, 0xFEDCBA9876543210ULL, 42);
+    ASSERT(ttak_bigint_set_u256(&bi, v, 0));
+    ttak_u256_t out;
+    ASSERT(ttak_bigint_export_u256(&bi, &out));
+    ASSERT(memcmp(&out, &v, sizeof(v)) == 0);
+    ttak_u128_t w;
+    ASSERT(!ttak_bigint_export_u128(&bi, &w));
+    ASSERT(ttak_bigint_get_bit_length(&bi) == 249);
+
+    // Digests cover whole 32-bit words, whatever the limb width.
+    ASSERT(ttak_bigint_set_u64(&bi, 0x0102030405ULL, 0));
+    uint8_t got[32], want[32];
+    ttak_bigint_hash(&bi, got);
+    const uint8_t le[8] = { 5, 4, 3, 2, 1, 0, 0, 0 };
+    SHA256_CTX ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, le, sizeof(le));
+    sha256_final(&ctx, want);
+    ASSERT(memcmp(got, want, sizeof(got)) == 0);
+    ttak_bigint_free(&bi, 0);
+}
+
 int main() {
     RUN_TEST(test_bigint_init);
     RUN_TEST(test_bigint_mersenne_mod_basic);
     RUN_TEST(test_bigmul_init);
     RUN_TEST(test_bigint_unit_ops);
+    RUN_TEST(test_limb_kernels_match_reference);
+    RUN_TEST(test_limb_mul_ladder_matches_basecase);
+    RUN_TEST(test_limb_mul_parallel_matches_serial);
+    RUN_TEST(test_bigint_mul_div_roundtrip);
+    RUN_TEST(test_limb_divrem_recovers_operands);
+    RUN_TEST(test_bigint_to_string_long);
+    RUN_TEST(test_bigint_aliased_operands);
+    RUN_TEST(test_bigint_mont_powmod_matches_reference);
+    RUN_TEST(test_factor_big_stops_at_prime_cofactor);
+    RUN_TEST(test_bigint_signed_add_sub);
+    RUN_TEST(test_factor_ecm_finds_15_digit_factor);
+    RUN_TEST(test_factor_siqs_splits_40_digit_semiprime);
+    RUN_TEST(test_factor_big_splits_large_cofactors);
+    RUN_TEST(test_bigint_words_and_hash);
+    RUN_TEST(test_bigint_accel_warmup_matches_availability);
+    RUN_TEST(test_bigint_accel_calibrate_applies_threshold);
     return 0;
 }
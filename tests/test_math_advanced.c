@@ -1,8 +1,13 @@
 #include <ttak/math/bigreal.h>
 #include <ttak/math/bigcomplex.h>
+#include <ttak/math/fft.h>
 #include <ttak/math/ntt.h>
+#include <ttak/math/ntt_accel.h>
+#include <ttak/arch/ttak_arch.h>
 #include <ttak/mem/mem.h>
 #include "test_macros.h"
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
@@ -10,9 +15,10 @@
 static uint64_t bigint_as_u64(const ttak_bigint_t *bi) {
     const limb_t *limbs = bi->is_dynamic ? bi->data.dyn_ptr : bi->data.sso_buf;
     uint64_t value = 0;
-    size_t max_limbs = bi->used < 2 ? bi->used : 2;
+    const size_t per_u64 = 64 / TTAK_BIGINT_LIMB_BITS;
+    size_t max_limbs = bi->used < per_u64 ? bi->used : per_u64;
     for (size_t i = 0; i < max_limbs; ++i) {
-        value |= ((uint64_t)limbs[i]) << (i * 32);
+        value |= ((uint64_t)limbs[i]) << (i * TTAK_BIGINT_LIMB_BITS);
     }
     return value;
 }
@@ -130,6 +136,262 @@ void test_ntt_pointwise_mul() {
     }
 }
 
+void test_ntt_plan_cyclic_convolution() {
+    // A built-in 30-bit prime (R = 2^32) and 29 * 2^57 + 1 (R = 2^64).
+    static const ttak_ntt_prime_t wide = {
+        4179340454199820289ULL, 3ULL, 57U, 0x39FFFFFFFFFFFFFFULL, 1878466934230121386ULL
+    };
+    const ttak_ntt_prime_t *primes[2] = { &ttak_ntt_primes[1], &wide };
+    enum { N = 64 };
+    uint64_t a[N], b[N], c[N], expected[N];
+    uint64_t seed = 0x853c49e6748fea9bULL;
+    for (size_t k = 0; k < ARRAY_SIZE(primes); ++k) {
+        const ttak_ntt_prime_t *prime = primes[k];
+        const uint64_t mod = prime->modulus;
+        for (size_t i = 0; i < N; ++i) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            a[i] = (seed >> 11) % mod;
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            b[i] = (seed >> 3) % mod;
+            expected[i] = 0;
+        }
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                size_t at = (i + j) % N;
+                expected[at] = ttak_mod_add(expected[at], ttak_mod_mul(a[i], b[j], mod), mod);
+            }
+        }
+
+        ttak_ntt_plan_t plan;
+        ASSERT(ttak_ntt_plan_init(&plan, prime, N));
+        ttak_ntt_plan_forward(&plan, a);
+        ttak_ntt_plan_forward(&plan, b);
+        ttak_ntt_plan_pointwise_mul(&plan, c, a, b);
+        ttak_ntt_plan_inverse(&plan, c);
+        ttak_ntt_plan_destroy(&plan);
+        ASSERT(memcmp(c, expected, sizeof(c)) == 0);
+    }
+
+    ttak_ntt_plan_t bad;
+    ASSERT(!ttak_ntt_plan_init(&bad, &ttak_ntt_primes[0], 12));
+    ASSERT(!ttak_ntt_plan_init(&bad, &ttak_ntt_primes[1], (size_t)1 << 22));
+    ttak_ntt_plan_destroy(&bad);
+}
+
+static size_t bit_reverse_index(size_t i, size_t n) {
+    size_t r = 0;
+    for (size_t bit = 1; bit < n; bit <<= 1) {
+        r = (r << 1) | (i & 1);
+        i >>= 1;
+    }
+    return r;
+}
+
+void test_ntt_plan_kernels_agree() {
+    // Every kernel the host can run must match the scalar butterflies bit
+    // for bit; 2^17 also crosses TTAK_NTT_BLOCK_ELEMS.
+    const ttak_ntt_prime_t *primes[] = { &ttak_ntt_primes[0], &ttak_ntt_primes[1], &ttak_ntt_primes[2],
+                                         &ttak_ntt_primes50[0], &ttak_ntt_primes50[1] };
+    const size_t big = (size_t)1 << 17;
+    uint64_t *a = malloc(big * sizeof(uint64_t));
+    uint64_t *b = malloc(big * sizeof(uint64_t));
+    uint64_t *va = malloc(big * sizeof(uint64_t));
+    uint64_t *vb = malloc(big * sizeof(uint64_t));
+    uint64_t *sa = malloc(big * sizeof(uint64_t));
+    uint64_t *sb = malloc(big * sizeof(uint64_t));
+    uint64_t *ref = malloc(big * sizeof(uint64_t));
+    ASSERT(a && b && va && vb && sa && sb && ref);
+    const bool avx2 = (ttak_arch_features() & TTAK_ARCH_FEATURE_AVX2) != 0;
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    for (size_t k = 0; k < ARRAY_SIZE(primes); ++k) {
+        const uint64_t mod = primes[k]->modulus;
+        ttak_ntt_kernel_t kernels[2] = { ttak_ntt_kernel_for(primes[k]), TTAK_NTT_KERNEL_SCALAR };
+        if (avx2 && mod < (1ULL << 31) && kernels[0] != TTAK_NTT_KERNEL_AVX2) kernels[1] = TTAK_NTT_KERNEL_AVX2;
+        for (size_t n = 1; n <= big; n <<= 1) {
+            if (n > 4096 && n < big) continue;
+            for (size_t i = 0; i < n; ++i) {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                a[i] = (seed >> 7) % mod;
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                b[i] = (seed >> 9) % mod;
+            }
+            ttak_ntt_plan_t plan;
+            ASSERT(ttak_ntt_plan_init(&plan, primes[k], n));
+            ttak_ntt_plan_t scalar = plan;
+            scalar.kernel = TTAK_NTT_KERNEL_SCALAR;
+            memcpy(sa, a, n * sizeof(uint64_t));
+            memcpy(sb, b, n * sizeof(uint64_t));
+            ttak_ntt_plan_forward(&scalar, sa);
+            ttak_ntt_plan_forward(&scalar, sb);
+            memcpy(ref, sa, n * sizeof(uint64_t));
+
+            // Spot-check the spectrum against the definition.
+            uint64_t root = ttak_mod_pow(primes[k]->primitive_root, (mod - 1) / n, mod);
+            for (size_t f = 0; f < n; f += n / 4 + 1) {
+                uint64_t wf = ttak_mod_pow(root, f, mod), x = 0, w = 1;
+                for (size_t i = 0; i < n; ++i) {
+                    x = ttak_mod_add(x, ttak_mod_mul(a[i], w, mod), mod);
+                    w = ttak_mod_mul(w, wf, mod);
+                }
+                ASSERT(sa[bit_reverse_index(f, n)] == x);
+            }
+
+            ttak_ntt_plan_pointwise_mul(&scalar, sa, sa, sb);
+            ttak_ntt_plan_inverse(&scalar, sa);
+            // Coefficient 0 of the cyclic convolution.
+            uint64_t c0 = 0;
+            for (size_t i = 0; i < n; ++i) {
+                c0 = ttak_mod_add(c0, ttak_mod_mul(a[i], b[(n - i) % n], mod), mod);
+            }
+            ASSERT(sa[0] == c0);
+
+            for (size_t v = 0; v < ARRAY_SIZE(kernels); ++v) {
+                plan.kernel = kernels[v];
+                memcpy(va, a, n * sizeof(uint64_t));
+                memcpy(vb, b, n * sizeof(uint64_t));
+                ttak_ntt_plan_forward(&plan, va);
+                ttak_ntt_plan_forward(&plan, vb);
+                ASSERT(memcmp(va, ref, n * sizeof(uint64_t)) == 0);
+                ttak_ntt_plan_pointwise_mul(&plan, va, va, vb);
+                ttak_ntt_plan_inverse(&plan, va);
+                ASSERT(memcmp(va, sa, n * sizeof(uint64_t)) == 0);
+            }
+            ttak_ntt_plan_destroy(&plan);
+        }
+    }
+    free(a);
+    free(b);
+    free(va);
+    free(vb);
+    free(sa);
+    free(sb);
+    free(ref);
+}
+
+void test_fft_plan_matches_dft() {
+    // Each kernel the host runs against a long double DFT; 2^15 crosses TTAK_FFT_BLOCK_ELEMS.
+    const size_t big = (size_t)1 << 15;
+    double *re = malloc(big * sizeof(double));
+    double *im = malloc(big * sizeof(double));
+    double *xr = malloc(big * sizeof(double));
+    double *xi = malloc(big * sizeof(double));
+    ASSERT(re && im && xr && xi);
+    ttak_fft_kernel_t kernels[3] = { TTAK_FFT_KERNEL_SCALAR, ttak_fft_kernel_default(), TTAK_FFT_KERNEL_SCALAR };
+    const uint32_t avx2_fma = TTAK_ARCH_FEATURE_AVX2 | TTAK_ARCH_FEATURE_FMA;
+    if ((ttak_arch_features() & avx2_fma) == avx2_fma) kernels[2] = TTAK_FFT_KERNEL_AVX2;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (size_t n = 1; n <= big; n <<= 1) {
+        if (n > 4096 && n < big) continue;
+        for (size_t i = 0; i < n; ++i) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            xr[i] = (double)(int32_t)(seed >> 32) / 2147483648.0;
+            xi[i] = (double)(int32_t)seed / 2147483648.0;
+        }
+        ttak_fft_plan_t plan;
+        ASSERT(ttak_fft_plan_init(&plan, n));
+        const double tol = 1e-12 * (double)n;
+        for (size_t v = 0; v < ARRAY_SIZE(kernels); ++v) {
+            plan.kernel = kernels[v];
+            memcpy(re, xr, n * sizeof(double));
+            memcpy(im, xi, n * sizeof(double));
+            ttak_fft_plan_forward(&plan, re, im);
+            for (size_t f = 0; f < n; f += n / 4 + 1) {
+                long double sr = 0, si = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    long double ang = -2.0L * 3.14159265358979323846264338327950288L * (long double)((i * f) % n) / (long double)n;
+                    long double c = cosl(ang), s = sinl(ang);
+                    sr += xr[i] * c - xi[i] * s;
+                    si += xr[i] * s + xi[i] * c;
+                }
+                size_t r = bit_reverse_index(f, n);
+                ASSERT(fabsl(re[r] - sr) < tol && fabsl(im[r] - si) < tol);
+            }
+            ttak_fft_plan_inverse(&plan, re, im);
+            for (size_t i = 0; i < n; ++i) {
+                ASSERT(fabs(re[i] - xr[i]) < 1e-13 && fabs(im[i] - xi[i]) < 1e-13);
+            }
+        }
+        ttak_fft_plan_destroy(&plan);
+    }
+    ASSERT(!ttak_fft_plan_get(3, 0));
+    ASSERT(ttak_fft_plan_get(64, 0) == ttak_fft_plan_get(64, 0));
+    free(re);
+    free(im);
+    free(xr);
+    free(xi);
+}
+
+void test_bigcomplex_fft_roundtrip() {
+    enum { N = 8 };
+    ttak_bigcomplex_t v[N];
+    for (size_t i = 0; i < N; ++i) ttak_bigcomplex_init(&v[i], 500);
+    // A shifted impulse transforms to the roots of unity, in natural order.
+    ASSERT(ttak_bigreal_set_double(&v[1].real, 1.0, 501));
+    ASSERT(ttak_bigcomplex_fft(v, N, false, 502));
+    for (size_t f = 0; f < N; ++f) {
+        double re = 0, im = 0;
+        ASSERT(ttak_bigreal_to_double(&v[f].real, &re) && ttak_bigreal_to_double(&v[f].imag, &im));
+        ASSERT(fabs(re - cos(-2 * M_PI * (double)f / N)) < 1e-12);
+        ASSERT(fabs(im - sin(-2 * M_PI * (double)f / N)) < 1e-12);
+    }
+    ASSERT(ttak_bigcomplex_fft(v, N, true, 503));
+    for (size_t i = 0; i < N; ++i) {
+        double re = 0, im = 0;
+        ASSERT(ttak_bigreal_to_double(&v[i].real, &re) && ttak_bigreal_to_double(&v[i].imag, &im));
+        ASSERT(fabs(re - (i == 1)) < 1e-12 && fabs(im) < 1e-12);
+    }
+    ASSERT(!ttak_bigcomplex_fft(v, 6, false, 504));
+    for (size_t i = 0; i < N; ++i) ttak_bigcomplex_free(&v[i], 505);
+}
+
+void test_ntt_accel_batch_matches_transform() {
+    enum { N = 256, ROWS = 3 };
+    static const ttak_ntt_prime_t wide = {
+        4179340454199820289ULL, 3ULL, 57U, 0x39FFFFFFFFFFFFFFULL, 1878466934230121386ULL
+    };
+    const ttak_ntt_prime_t *primes[3] = { &ttak_ntt_primes[0], &ttak_ntt_primes50[0], &wide };
+    static uint64_t lhs[ROWS * N], rhs[ROWS * N], expected[ROWS * N], got[ROWS * N];
+
+    for (size_t p = 0; p < 3; ++p) {
+        const ttak_ntt_prime_t *prime = primes[p];
+        uint64_t x = 0x2545f4914f6cdd1dULL + p;
+        for (size_t i = 0; i < ROWS * N; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            /* Unreduced inputs are accepted like ttak_ntt_transform() does. */
+            lhs[i] = i % 7 == 0 ? x : x % prime->modulus;
+            rhs[i] = (x >> 11) % prime->modulus;
+        }
+        memcpy(expected, lhs, sizeof(expected));
+        for (size_t r = 0; r < ROWS; ++r) {
+            uint64_t other[N];
+            memcpy(other, rhs + r * N, sizeof(other));
+            ASSERT(ttak_ntt_transform(expected + r * N, N, prime, false));
+            ASSERT(ttak_ntt_transform(other, N, prime, false));
+            ttak_ntt_pointwise_mul(expected + r * N, expected + r * N, other, N, prime);
+            ttak_ntt_pointwise_square(expected + r * N, expected + r * N, N, prime);
+            ASSERT(ttak_ntt_transform(expected + r * N, N, prime, true));
+        }
+
+        ttak_ntt_accel_batch_t *a = ttak_ntt_accel_batch_create(N, ROWS, 0);
+        ttak_ntt_accel_batch_t *b = ttak_ntt_accel_batch_create(N, ROWS, 0);
+        ASSERT(a != NULL && b != NULL);
+        ASSERT(ttak_ntt_accel_upload(a, lhs));
+        ASSERT(ttak_ntt_accel_upload(b, rhs));
+        ASSERT(ttak_ntt_accel_transform(a, prime, false));
+        ASSERT(ttak_ntt_accel_transform(b, prime, false));
+        ASSERT(ttak_ntt_accel_pointwise_mul(a, a, b, prime));
+        ASSERT(ttak_ntt_accel_pointwise_square(a, a, prime));
+        ASSERT(ttak_ntt_accel_transform(a, prime, true));
+        ASSERT(ttak_ntt_accel_download(a, got));
+        ASSERT_MSG(memcmp(got, expected, sizeof(got)) == 0, "batched NTT differs under prime %zu", p);
+        ttak_ntt_accel_batch_destroy(b);
+        ttak_ntt_accel_batch_destroy(a);
+    }
+    ASSERT(ttak_ntt_accel_batch_create(3, 1, 0) == NULL);
+}
+
 void test_crt_combine_basic() {
     ttak_u128_t value = ttak_u128_shl(ttak_u128_from_u64(1), 96);
     value = ttak_u128_add64(value, 0x123456789ULL);
@@ -161,6 +423,11 @@ int main() {
     RUN_TEST(test_bigcomplex_add_basic);
     RUN_TEST(test_ntt_roundtrip);
     RUN_TEST(test_ntt_pointwise_mul);
+    RUN_TEST(test_ntt_plan_cyclic_convolution);
+    RUN_TEST(test_ntt_plan_kernels_agree);
+    RUN_TEST(test_fft_plan_matches_dft);
+    RUN_TEST(test_bigcomplex_fft_roundtrip);
+    RUN_TEST(test_ntt_accel_batch_matches_transform);
     RUN_TEST(test_crt_combine_basic);
     RUN_TEST(test_next_power_of_two);
     return 0;
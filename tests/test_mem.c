@@ -1,6 +1,11 @@
 #include <ttak/mem/mem.h>
+#include <ttak/mem/fastpath.h>
 #include "test_macros.h"
+#include <pthread.h>
 #include <string.h>
+#if defined(__linux__) && !EMBEDDED
+#include <sys/mman.h>
+#endif
 
 void test_mem_alloc_free(void) {
     uint64_t now = 100;
@@ -49,9 +54,275 @@ void test_mem_realloc(void) {
     ttak_mem_free(new_ptr);
 }
 
+void test_mem_realloc_grow(void) {
+    uint64_t now = 250;
+    /* Medium blocks step through the VMA tier into the large one. */
+    size_t size = 3000;
+    unsigned char *p = ttak_mem_alloc_safe(size, 1000, now, false, false, true, false, TTAK_MEM_STRICT_CHECK);
+    ASSERT(p != NULL);
+    memset(p, 0x3C, size);
+    while (size < 6 * 1024 * 1024) {
+        size_t next = size + size / 2 + 1;
+        p = ttak_mem_realloc_safe(p, next, 1000, now, false, TTAK_MEM_STRICT_CHECK);
+        ASSERT(p != NULL);
+        ttak_mem_header_t *h = (ttak_mem_header_t *)p - 1;
+        ASSERT(h->size == next && h->checksum == ttak_calc_header_checksum(h));
+        ASSERT(p[0] == 0x3C && p[size - 1] == 0x3C && p[size / 2] == 0x3C);
+        /* The grown tail reads zero, including where the old canary was. */
+        for (size_t i = size; i < next; i += 509) ASSERT(p[i] == 0);
+        ASSERT(p[next - 1] == 0);
+        ASSERT(ttak_mem_access(p, now) == p);
+        memset(p + size, 0x3C, next - size);
+        size = next;
+    }
+    ttak_mem_free(p);
+
+    /* A grown root is registered at its current address and takes the new lifetime. */
+    void *root = ttak_root_alloc(100 * 1024, 5, 10);
+    ASSERT(root != NULL);
+    root = ttak_mem_realloc_safe(root, 300 * 1024, 50, 10, true, TTAK_MEM_DEFAULT);
+    ASSERT(root != NULL);
+    size_t count = 0;
+    void **dirty = tt_inspect_dirty_pointers(30, &count);
+    ASSERT(count == 0);
+    free(dirty);
+    dirty = tt_inspect_dirty_pointers(100, &count);
+    ASSERT(dirty != NULL && count == 1 && dirty[0] == root);
+    free(dirty);
+    ttak_mem_free(root);
+}
+
+#if defined(__linux__) && !EMBEDDED
+/* Pages of [p, p + len) that are resident. Embedded builds clear their pool blocks. */
+static size_t resident_pages(void *p, size_t len) {
+    uintptr_t start = (uintptr_t)p & ~(uintptr_t)4095;
+    size_t span = ((uintptr_t)p + len - start + 4095) / 4096;
+    unsigned char *vec = malloc(span);
+    ASSERT(vec != NULL);
+    ASSERT(mincore((void *)start, span * 4096, vec) == 0);
+    size_t n = 0;
+    for (size_t i = 0; i < span; i++) n += vec[i] & 1;
+    free(vec);
+    return n;
+}
+#endif
+
+void test_mem_zeroed_lazily(void) {
+    uint64_t now = 260;
+    size_t big = 64 * 1024 * 1024;
+    unsigned char *p = ttak_mem_alloc_raw(big, 1000, now);
+    ASSERT(p != NULL);
+#if defined(__linux__) && !EMBEDDED
+    /* Fresh pages are not cleared by hand, so they are not faulted in yet. */
+    ASSERT(resident_pages(p, big) < big / 4096 / 4);
+#endif
+    for (size_t i = 0; i < big; i += 4093) ASSERT(p[i] == 0);
+    ASSERT(p[big - 1] == 0);
+    ttak_mem_free(p);
+
+    unsigned char *d = ttak_dangerous_calloc(1, big);
+    ASSERT(d != NULL && ((uintptr_t)d & 63) == 0);
+#if defined(__linux__) && !EMBEDDED
+    ASSERT(resident_pages(d, big) < big / 4096 / 4);
+#endif
+    ASSERT(d[0] == 0 && d[big / 2] == 0 && d[big - 1] == 0);
+    ttak_dangerous_free(d);
+
+    /* Recycled blocks are still cleared. */
+    for (int round = 0; round < 3; round++) {
+        unsigned char *v = ttak_mem_alloc_raw(100 * 1024, 1000, now);
+        ASSERT(v != NULL);
+        for (size_t i = 0; i < 100 * 1024; i += 97) ASSERT(v[i] == 0);
+        memset(v, 0xFF, 100 * 1024);
+        ttak_mem_free(v);
+    }
+
+    /* More large bootstrap blocks than the mapping table holds. */
+    enum { MANY = 80 };
+    unsigned char *blocks[MANY];
+    for (int i = 0; i < MANY; i++) {
+        blocks[i] = ttak_dangerous_calloc(256 * 1024, 1);
+        ASSERT(blocks[i] != NULL);
+        ASSERT(blocks[i][0] == 0 && blocks[i][256 * 1024 - 1] == 0);
+        memset(blocks[i], i, 256 * 1024);
+    }
+    for (int i = 0; i < MANY; i++) {
+        ASSERT(blocks[i][12345] == (unsigned char)i);
+        ttak_dangerous_free(blocks[i]);
+    }
+}
+
+#define ROOT_THREADS 4
+#define ROOT_ITERS   256
+
+static void *root_churn_worker(void *arg) {
+    (void)arg;
+    for (int i = 0; i < ROOT_ITERS; ++i) {
+        void *p = ttak_root_alloc(64 + (size_t)(i % 7) * 128, 1000, 10);
+        ASSERT(p != NULL);
+        ttak_mem_free(p);
+    }
+    return NULL;
+}
+
+void test_mem_root_registry_concurrent(void) {
+    pthread_t threads[ROOT_THREADS];
+    for (int i = 0; i < ROOT_THREADS; ++i) {
+        ASSERT(pthread_create(&threads[i], NULL, root_churn_worker, NULL) == 0);
+    }
+    for (int i = 0; i < ROOT_THREADS; ++i) pthread_join(threads[i], NULL);
+
+    /* One expired root must be reported; the churned ones must not linger. */
+    void *expired = ttak_root_alloc(128, 5, 10);
+    ASSERT(expired != NULL);
+    size_t count = 0;
+    void **dirty = tt_inspect_dirty_pointers(100, &count);
+    ASSERT(dirty != NULL);
+    ASSERT(count == 1);
+    ASSERT(dirty[0] == expired);
+    free(dirty);
+    ttak_mem_free(expired);
+}
+
+void test_mem_placement_hints(void) {
+    uint64_t now = 400;
+    size_t big = 4 * 1024 * 1024;
+    ttak_mem_flags_t flags = TTAK_MEM_HUGE_PAGES | TTAK_MEM_NUMA_NODE(0);
+    unsigned char *ptr = ttak_mem_alloc_safe(big, 1000, now, false, false, true, false, flags);
+    ASSERT(ptr != NULL);
+#if defined(__linux__) && !EMBEDDED
+    /* Huge-page requests start their mapping on a 2 MiB boundary. */
+    ASSERT((((uintptr_t)ptr - sizeof(ttak_mem_header_t)) & (2 * 1024 * 1024 - 1)) == 0);
+#endif
+    memset(ptr, 0x5A, big);
+    ASSERT(ptr[big - 1] == 0x5A);
+    ttak_mem_free(ptr);
+
+    /* Medium blocks accept a node hint too; a nonexistent node is not fatal. */
+    void *mid = ttak_mem_alloc_safe(64 * 1024, 1000, now, false, false, true, false, TTAK_MEM_NUMA_NODE(200));
+    ASSERT(mid != NULL);
+    memset(mid, 0, 64 * 1024);
+    ttak_mem_free(mid);
+}
+
+void test_mem_bulk(void) {
+    enum { BULK = 300 };
+    void *ptrs[BULK];
+    ASSERT(ttak_mem_alloc_bulk(ptrs, BULK, 96, 5, 10, true, TTAK_MEM_DEFAULT) == BULK);
+    for (int i = 0; i < BULK; ++i) {
+        ASSERT(ptrs[i] != NULL);
+        ASSERT(((unsigned char *)ptrs[i])[95] == 0);
+        memset(ptrs[i], i & 0xFF, 96);
+    }
+
+    /* Every bulk root is registered and expires like a single allocation. */
+    size_t count = 0;
+    void **dirty = tt_inspect_dirty_pointers(100, &count);
+    ASSERT(dirty != NULL);
+    ASSERT(count == BULK);
+    free(dirty);
+
+    /* Duplicates and NULLs are tolerated. */
+    void *extra[BULK + 2];
+    memcpy(extra, ptrs, sizeof(ptrs));
+    extra[BULK] = ptrs[0];
+    extra[BULK + 1] = NULL;
+    ttak_mem_free_bulk(extra, BULK + 2);
+
+    count = 0;
+    dirty = tt_inspect_dirty_pointers(100, &count);
+    ASSERT(count == 0);
+    free(dirty);
+
+    ASSERT(ttak_mem_alloc_bulk(ptrs, 0, 96, 5, 10, false, TTAK_MEM_DEFAULT) == 0);
+    ASSERT(ttak_mem_alloc_bulk(ptrs, 16, 4096, 1000, 10, false, TTAK_MEM_DEFAULT) == 16);
+    ttak_mem_free_bulk(ptrs, 16);
+}
+
+void test_mem_stream_large(void) {
+    ASSERT(ttak_mem_stream_kernel() != NULL);
+    ASSERT(ttak_mem_stream_nt_threshold() >= TTAK_MEM_STREAM_NT_MIN_BYTES);
+
+    /* Force the streaming kernels and check the ragged head and tail. */
+    ttak_mem_stream_set_nt_threshold(TTAK_MEM_STREAM_NT_MIN_BYTES);
+    size_t len = TTAK_MEM_STREAM_NT_MIN_BYTES + 77;
+    unsigned char *src = malloc(len + 64);
+    unsigned char *dst = malloc(len + 64);
+    ASSERT(src != NULL && dst != NULL);
+    for (size_t i = 0; i < len + 64; ++i) src[i] = (unsigned char)(i * 31U);
+    memset(dst, 0xee, len + 64);
+
+    ttak_mem_stream_copy(dst + 3, src + 5, len);
+    ASSERT(memcmp(dst + 3, src + 5, len) == 0);
+    ASSERT(dst[2] == 0xee && dst[len + 3] == 0xee);
+
+    ttak_mem_stream_zero(dst + 1, len);
+    ASSERT(dst[0] == 0xee && dst[len + 1] == src[len + 3]);
+    for (size_t i = 1; i <= len; ++i) ASSERT(dst[i] == 0);
+
+    ttak_mem_stream_set_nt_threshold(SIZE_MAX);
+    ttak_mem_stream_copy(dst, src, len);
+    ASSERT(memcmp(dst, src, len) == 0);
+
+    /* Uncached copies stream below the crossover too, edges included. */
+    memset(dst, 0xee, len + 64);
+    ttak_mem_stream_copy_uncached(dst + 7, src + 1, 16384 + 13);
+    ASSERT(memcmp(dst + 7, src + 1, 16384 + 13) == 0);
+    ASSERT(dst[6] == 0xee && dst[7 + 16384 + 13] == 0xee);
+    free(src);
+    free(dst);
+}
+
+#define MEM_HEADER(p) ((ttak_mem_header_t *)(p) - 1)
+
+void test_mem_access_accounting(void) {
+    uint64_t now = 100;
+    void *counted = ttak_mem_alloc_safe(64, 1000, now, false, false, true, false, TTAK_MEM_DEFAULT);
+    void *quiet = ttak_mem_alloc_safe(64, 1000, now, false, false, true, false, TTAK_MEM_ACCESS_UNCOUNTED);
+    void *sampled = ttak_mem_alloc_safe(64, 1000, now, false, false, true, false, TTAK_MEM_ACCESS_SAMPLED);
+    ASSERT(counted && quiet && sampled);
+
+    ttak_mem_set_access_accounting(TTAK_MEM_ACCESS_COUNT_ALL, 16);
+    for (int i = 0; i < 256; i++) {
+        ASSERT(ttak_mem_access(counted, now) == counted);
+        ASSERT(ttak_mem_access(quiet, now) == quiet);
+        ASSERT(ttak_mem_access(sampled, now) == sampled);
+    }
+    ASSERT(MEM_HEADER(counted)->access_count == 256);
+    ASSERT(MEM_HEADER(quiet)->access_count == 0);
+    /* One add of 16 per 16 accesses on this thread. */
+    ASSERT(MEM_HEADER(sampled)->access_count == 256);
+
+    /* TTL checks still apply to blocks that are not counted. */
+    ASSERT(ttak_mem_access(quiet, now + 2000) == NULL);
+
+    /* The global mode governs blocks allocated without a flag. */
+    ttak_mem_set_access_accounting(TTAK_MEM_ACCESS_COUNT_OFF, 0);
+    for (int i = 0; i < 100; i++) ASSERT(ttak_mem_access(counted, now) == counted);
+    ASSERT(MEM_HEADER(counted)->access_count == 256);
+
+    /* Realloc keeps a block's own mode. */
+    ttak_mem_set_access_accounting(TTAK_MEM_ACCESS_COUNT_ALL, 64);
+    quiet = ttak_mem_realloc_safe(quiet, 128, 1000, now, false, TTAK_MEM_DEFAULT);
+    ASSERT(quiet != NULL);
+    ASSERT(ttak_mem_access(quiet, now) == quiet);
+    ASSERT(MEM_HEADER(quiet)->access_count == 0);
+
+    ttak_mem_free(counted);
+    ttak_mem_free(quiet);
+    ttak_mem_free(sampled);
+}
+
 int main(void) {
     RUN_TEST(test_mem_alloc_free);
     RUN_TEST(test_mem_freep);
     RUN_TEST(test_mem_realloc);
+    RUN_TEST(test_mem_realloc_grow);
+    RUN_TEST(test_mem_zeroed_lazily);
+    RUN_TEST(test_mem_root_registry_concurrent);
+    RUN_TEST(test_mem_placement_hints);
+    RUN_TEST(test_mem_bulk);
+    RUN_TEST(test_mem_stream_large);
+    RUN_TEST(test_mem_access_accounting);
     return 0;
 }
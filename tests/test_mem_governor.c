@@ -0,0 +1,135 @@
+#include <ttak/mem/governor.h>
+#include <ttak/mem/detachable.h>
+#include <ttak/mem/mem.h>
+#include <ttak/mem/mem_stats.h>
+#include <ttak/timing/timing.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "test_macros.h"
+
+static void test_governor_classify(void) {
+    ttak_mem_governor_config_t cfg = {0};
+    ASSERT(ttak_mem_governor_start(&cfg) == 0);
+    ttak_mem_governor_stop();
+
+    ttak_sys_snapshot_t snap;
+    memset(&snap, 0, sizeof(snap));
+    snap.has_cgroup_mem = true;
+    snap.cgroup_mem_max = 1000;
+    snap.cgroup_mem_high = UINT64_MAX;
+    snap.cgroup_mem_current = 500;
+    ASSERT(ttak_mem_governor_classify(&snap) == TTAK_MEM_PRESSURE_NONE);
+    snap.cgroup_mem_current = 850;
+    ASSERT(ttak_mem_governor_classify(&snap) == TTAK_MEM_PRESSURE_SOFT);
+    snap.cgroup_mem_current = 950;
+    ASSERT(ttak_mem_governor_classify(&snap) == TTAK_MEM_PRESSURE_HARD);
+
+    /* memory.high below memory.max is the limit that counts. */
+    snap.cgroup_mem_high = 600;
+    snap.cgroup_mem_current = 500;
+    ASSERT(ttak_mem_governor_classify(&snap) == TTAK_MEM_PRESSURE_SOFT);
+
+    /* No limit at all: only PSI can raise the level. */
+    snap.cgroup_mem_high = snap.cgroup_mem_max = UINT64_MAX;
+    ASSERT(ttak_mem_governor_classify(&snap) == TTAK_MEM_PRESSURE_NONE);
+    snap.has_psi = true;
+    snap.psi_mem.some_avg10 = 12.0;
+    ASSERT(ttak_mem_governor_classify(&snap) == TTAK_MEM_PRESSURE_SOFT);
+    snap.psi_mem.full_avg10 = 6.0;
+    ASSERT(ttak_mem_governor_classify(&snap) == TTAK_MEM_PRESSURE_HARD);
+}
+
+typedef struct {
+    _Atomic int calls;
+    _Atomic int hard_calls;
+} shed_probe_t;
+
+static size_t on_pressure(ttak_mem_pressure_t level, const ttak_sys_snapshot_t *snap, void *arg) {
+    shed_probe_t *probe = arg;
+    (void)snap;
+    atomic_fetch_add(&probe->calls, 1);
+    if (level == TTAK_MEM_PRESSURE_HARD) atomic_fetch_add(&probe->hard_calls, 1);
+    return 4096;
+}
+
+static void test_governor_sheds_detachable_and_calls_back(void) {
+    ttak_detachable_context_t ctx;
+    ttak_detachable_context_init(&ctx, TTAK_ARENA_USE_LOCKED_ACCESS);
+    ttak_detachable_allocation_t a = ttak_detachable_mem_alloc(&ctx, 4096, 0);
+    ASSERT(a.data != NULL);
+    ttak_detachable_mem_free(&ctx, &a);
+    ASSERT(ctx.class_caches[0].count == 1);
+
+    shed_probe_t probe = {0};
+    ASSERT(ttak_mem_governor_add_callback(on_pressure, &probe) == 0);
+
+    /* A one-byte limit puts any process at hard pressure. */
+    ttak_mem_governor_config_t cfg = {0};
+    cfg.limit_bytes = 1;
+    cfg.cooldown_ns = 1000000ULL;
+    cfg.hz = 200;
+    ASSERT(ttak_mem_governor_start(&cfg) == 0);
+    uint64_t deadline = ttak_get_tick_count_ns() + 2000000000ULL;
+    while (atomic_load(&probe.hard_calls) < 2 && ttak_get_tick_count_ns() < deadline) {
+        ttak_sys_sampler_sample_now();
+    }
+    ttak_mem_governor_stop();
+    ASSERT(atomic_load(&probe.hard_calls) >= 2);
+    ASSERT(ttak_mem_governor_level() == TTAK_MEM_PRESSURE_NONE);
+    ASSERT(ctx.class_caches[0].count == 0);
+
+    ttak_mem_governor_stats_t stats;
+    ttak_mem_governor_stats(&stats);
+    ASSERT(stats.sheds >= 2);
+    ASSERT(stats.limit_bytes == 1);
+    ASSERT(stats.released_bytes >= 2 * 4096 + 4096);
+
+    ttak_mem_governor_remove_callback(on_pressure, &probe);
+    int calls = atomic_load(&probe.calls);
+    ASSERT(ttak_mem_governor_shed(TTAK_MEM_PRESSURE_SOFT, NULL) == 0);
+    ASSERT(atomic_load(&probe.calls) == calls);
+    ttak_detachable_context_destroy(&ctx);
+}
+
+#if !EMBEDDED
+/* Embedded builds serve small blocks from the buddy pool, not pocket pages. */
+#define ORPHAN_BLOCKS 400
+
+static void *alloc_and_exit(void *arg) {
+    void **blocks = arg;
+    uint64_t now = ttak_get_tick_count();
+    for (int i = 0; i < ORPHAN_BLOCKS; ++i) {
+        blocks[i] = ttak_mem_alloc_safe(48, 1000, now, false, false, true, false, TTAK_MEM_DEFAULT);
+    }
+    return NULL;
+}
+
+static void test_mem_trim_unmaps_orphan_pages(void) {
+    static void *blocks[ORPHAN_BLOCKS];
+    pthread_t th;
+    ASSERT(pthread_create(&th, NULL, alloc_and_exit, blocks) == 0);
+    pthread_join(th, NULL);
+    for (int i = 0; i < ORPHAN_BLOCKS; ++i) {
+        ASSERT(blocks[i] != NULL);
+        ttak_mem_free(blocks[i]);
+    }
+
+    ttak_mem_stats_t before, after;
+    ttak_mem_stats_snapshot(&before, NULL);
+    size_t released = ttak_mem_trim();
+    ttak_mem_stats_snapshot(&after, NULL);
+    ASSERT(released >= 4096);
+    ASSERT(after.tiers[TTAK_MEM_STATS_TIER_POCKET].reserved_bytes + released ==
+           before.tiers[TTAK_MEM_STATS_TIER_POCKET].reserved_bytes);
+}
+#endif
+
+int main(void) {
+    RUN_TEST(test_governor_classify);
+    RUN_TEST(test_governor_sheds_detachable_and_calls_back);
+#if !EMBEDDED
+    RUN_TEST(test_mem_trim_unmaps_orphan_pages);
+#endif
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <ttak/mem/mem.h>
+#include <ttak/mem/mem_stats.h>
+#include <ttak/timing/timing.h>
+#include "test_macros.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SMALL_COUNT 200
+#define MEDIUM_COUNT 8
+
+static void test_mem_stats_tracks_tiers(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_mem_stats_t before, during, after;
+    ttak_mem_stats_snapshot(&before, NULL);
+    ASSERT(before.tiers[TTAK_MEM_STATS_TIER_POCKET].alloc_rate == 0.0);
+
+    void *small[SMALL_COUNT];
+    void *medium[MEDIUM_COUNT];
+    for (int i = 0; i < SMALL_COUNT; ++i) {
+        small[i] = ttak_mem_alloc_safe(48, 10, now, false, false, true, false, TTAK_MEM_DEFAULT);
+        ASSERT(small[i] != NULL);
+    }
+    for (int i = 0; i < MEDIUM_COUNT; ++i) {
+        medium[i] = ttak_mem_alloc_safe(32 * 1024, 1000, now, false, false, true, false, TTAK_MEM_DEFAULT);
+        ASSERT(medium[i] != NULL);
+    }
+
+    ttak_mem_stats_snapshot(&during, &before);
+    const ttak_mem_tier_stats_t *pocket = &during.tiers[TTAK_MEM_STATS_TIER_POCKET];
+    const ttak_mem_tier_stats_t *vma = &during.tiers[TTAK_MEM_STATS_TIER_VMA];
+    ASSERT(pocket->allocs - before.tiers[TTAK_MEM_STATS_TIER_POCKET].allocs == SMALL_COUNT);
+    ASSERT(vma->allocs - before.tiers[TTAK_MEM_STATS_TIER_VMA].allocs == MEDIUM_COUNT);
+    ASSERT(vma->live_bytes - before.tiers[TTAK_MEM_STATS_TIER_VMA].live_bytes >= MEDIUM_COUNT * 32 * 1024);
+    ASSERT(pocket->alloc_rate > 0.0);
+
+    uint64_t sum = 0;
+    for (int t = 0; t < TTAK_MEM_STATS_TIER_COUNT; ++t) {
+        ASSERT(during.tiers[t].reserved_bytes >= during.tiers[t].live_bytes);
+        sum += during.tiers[t].live_bytes;
+    }
+    ASSERT(sum == during.total_live_bytes);
+
+    /* Carved pages hold exactly the live blocks plus the free slots. */
+    size_t slots = 0;
+    for (size_t i = 0; i < TTAK_MEM_STATS_POCKET_BINS; ++i) slots += during.pocket_free_blocks[i];
+    ASSERT(slots == pocket->free_blocks);
+    ASSERT(pocket->reserved_bytes >= pocket->live_bytes + pocket->free_blocks * 32);
+    ASSERT(pocket->largest_free_block == 0 || pocket->largest_free_block >= 32);
+
+    for (int i = 0; i < SMALL_COUNT; ++i) ttak_mem_free(small[i]);
+    for (int i = 0; i < MEDIUM_COUNT; ++i) ttak_mem_free(medium[i]);
+
+    ttak_mem_stats_snapshot(&after, &during);
+    ASSERT(after.tiers[TTAK_MEM_STATS_TIER_POCKET].frees - pocket->frees == SMALL_COUNT);
+    ASSERT(after.tiers[TTAK_MEM_STATS_TIER_VMA].frees - vma->frees == MEDIUM_COUNT);
+    ASSERT(after.tiers[TTAK_MEM_STATS_TIER_VMA].live_bytes == before.tiers[TTAK_MEM_STATS_TIER_VMA].live_bytes);
+    ASSERT(after.tiers[TTAK_MEM_STATS_TIER_POCKET].live_bytes == before.tiers[TTAK_MEM_STATS_TIER_POCKET].live_bytes);
+    ASSERT(after.tiers[TTAK_MEM_STATS_TIER_POCKET].free_rate > 0.0);
+}
+
+static void test_mem_stats_lite_and_report(void) {
+    ttak_mem_stats_t before, after;
+    ttak_mem_stats_snapshot(&before, NULL);
+    void *p = ttak_mem_alloc_lite(40, __TTAK_UNSAFE_MEM_FOREVER__, 0, TTAK_MEM_DEFAULT);
+    ASSERT(p != NULL);
+    ttak_mem_stats_snapshot(&after, &before);
+    ASSERT(after.total_live_bytes > before.total_live_bytes);
+    ttak_mem_free_lite(p);
+
+    ttak_mem_tier_stats_t tier = { .live_bytes = 100, .reserved_bytes = 300, .largest_free_block = 50 };
+    double frag = ttak_mem_stats_fragmentation(&tier);
+    ASSERT(frag > 0.74 && frag < 0.76);
+    tier.largest_free_block = 200;
+    ASSERT(ttak_mem_stats_fragmentation(&tier) == 0.0);
+
+    FILE *out = tmpfile();
+    ASSERT(out != NULL);
+    ASSERT(ttak_mem_stats_write_report(&after, out) == 0);
+    rewind(out);
+    char line[512];
+    ASSERT(fgets(line, sizeof(line), out) != NULL);
+    ASSERT(strstr(line, "bytes live") != NULL);
+    ASSERT(fgets(line, sizeof(line), out) != NULL);
+    ASSERT(strncmp(line, "pocket", 6) == 0);
+    fclose(out);
+    ASSERT(ttak_mem_stats_write_report(NULL, stdout) == -1);
+}
+
+int main(void) {
+    RUN_TEST(test_mem_stats_tracks_tiers);
+    RUN_TEST(test_mem_stats_lite_and_report);
+    return 0;
+}
@@ -0,0 +1,312 @@
+#include <ttak/mem_tree/mem_tree.h>
+#include <ttak/mem/mem.h>
+#include <ttak/timing/timing.h>
+#include "../internal/app_types.h"
+#include <pthread.h>
+#include "test_macros.h"
+
+#define LIVE_NODES    5000
+#define EXPIRED_NODES 1000
+
+static void *tracked_block(void) {
+    void *p = ttak_mem_alloc_raw(64, __TTAK_UNSAFE_MEM_FOREVER__, 0);
+    ASSERT(p != NULL);
+    return p;
+}
+
+static void test_mem_tree_sweeps_only_expired(void) {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+    ttak_mem_tree_set_manual_cleanup(&tree, true);
+
+    uint64_t now = TT_SECOND(100);
+    for (int i = 0; i < LIVE_NODES; ++i) {
+        ttak_mem_node_t *node = ttak_mem_tree_add(&tree, tracked_block(), 64, now + TT_MINUTE(10), false);
+        ASSERT(node != NULL);
+        ttak_mem_node_release(node);
+    }
+    for (int i = 0; i < EXPIRED_NODES; ++i) {
+        ttak_mem_node_t *node = ttak_mem_tree_add(&tree, tracked_block(), 64, now + TT_SECOND(1), false);
+        ASSERT(node != NULL);
+        ttak_mem_node_release(node);
+    }
+    ASSERT(ttak_mem_tree_node_count(&tree) == LIVE_NODES + EXPIRED_NODES);
+
+    /* Nothing has expired yet; the sweep must not free anything. */
+    ttak_mem_tree_perform_cleanup(&tree, now);
+    ASSERT(ttak_mem_tree_node_count(&tree) == LIVE_NODES + EXPIRED_NODES);
+
+    /* A small budget stops early and reports that work remains. */
+    uint64_t later = now + TT_SECOND(2);
+    ttak_mem_tree_report_pressure(&tree, 1);
+    ASSERT(ttak_mem_tree_perform_cleanup_budget(&tree, later, 100));
+    int passes = 1;
+    while (ttak_mem_tree_perform_cleanup_budget(&tree, later, 100)) {
+        ASSERT(++passes < 100);
+    }
+    /* Cost follows the expired nodes: the live ones are never visited. */
+    ASSERT(passes <= (2 * EXPIRED_NODES) / 100 + 1);
+    ASSERT(ttak_mem_tree_node_count(&tree) == LIVE_NODES);
+
+    ttak_mem_tree_destroy(&tree);
+}
+
+static void test_mem_tree_far_future_and_referenced(void) {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+    ttak_mem_tree_set_manual_cleanup(&tree, true);
+
+    uint64_t now = TT_SECOND(10);
+    /* Beyond the wheel horizon: parked on the overflow list first. */
+    ttak_mem_node_t *far = ttak_mem_tree_add(&tree, tracked_block(), 64, now + TT_MINUTE(30), false);
+    ttak_mem_node_t *held = ttak_mem_tree_add(&tree, tracked_block(), 64, now + 5, false);
+    ttak_mem_node_t *forever = ttak_mem_tree_add(&tree, tracked_block(), 64, __TTAK_UNSAFE_MEM_FOREVER__, false);
+    ASSERT(far && held && forever);
+    ttak_mem_node_release(far);
+    ttak_mem_node_release(forever);
+
+    for (uint64_t t = now; t < now + TT_MINUTE(29); t += TT_SECOND(20)) {
+        ttak_mem_tree_report_pressure(&tree, 1);
+        ttak_mem_tree_perform_cleanup(&tree, t);
+    }
+    /* Still referenced, not yet expired, and never expiring, respectively. */
+    ASSERT(ttak_mem_tree_node_count(&tree) == 3);
+
+    ttak_mem_node_release(held);
+    ttak_mem_tree_perform_cleanup(&tree, now + TT_MINUTE(31));
+    ASSERT(ttak_mem_tree_node_count(&tree) == 1);
+    ASSERT(ttak_mem_tree_find_node(&tree, forever->ptr) == forever);
+
+    ttak_mem_tree_destroy(&tree);
+}
+
+static void test_mem_tree_index_lookup(void) {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+    ttak_mem_tree_set_manual_cleanup(&tree, true);
+
+    enum { N = 3000 };
+    static void *ptrs[N];
+    for (int i = 0; i < N; ++i) {
+        ptrs[i] = tracked_block();
+        ASSERT(ttak_mem_tree_add(&tree, ptrs[i], 64, (uint64_t)i * TT_SECOND(1), true) != NULL);
+    }
+    for (int i = 0; i < N; i += 7) {
+        ttak_mem_node_t *node = ttak_mem_tree_find_node(&tree, ptrs[i]);
+        ASSERT(node != NULL && node->ptr == ptrs[i]);
+    }
+
+    ttak_mem_tree_remove_bulk(&tree, ptrs, N / 2);
+    ASSERT(ttak_mem_tree_node_count(&tree) == N - N / 2);
+    ASSERT(ttak_mem_tree_find_node(&tree, ptrs[0]) == NULL);
+    ASSERT(ttak_mem_tree_find_node(&tree, ptrs[N - 1]) != NULL);
+    for (int i = 0; i < N / 2; ++i) ttak_mem_free(ptrs[i]);
+
+    ttak_mem_tree_destroy(&tree);
+}
+
+static void test_mem_tree_cleanup_thread_starts_on_first_add(void) {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+    ASSERT(!tree.cleanup_thread);
+
+    void *p = tracked_block();
+    ASSERT(ttak_mem_tree_add(&tree, p, 64, ttak_get_tick_count() + TT_SECOND(60), true) != NULL);
+    ASSERT(tree.cleanup_thread);
+
+    ttak_mem_tree_set_manual_cleanup(&tree, true);
+    ASSERT(!tree.cleanup_thread);
+    ttak_mem_tree_set_manual_cleanup(&tree, false);
+    ASSERT(tree.cleanup_thread);
+
+    ttak_mem_tree_destroy(&tree);
+}
+
+static void test_mem_tree_slab_recycles_nodes(void) {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+    ttak_mem_tree_set_manual_cleanup(&tree, true);
+
+    enum { N = TTAK_MEM_TREE_SLAB_NODES * 4 };
+    static void *ptrs[N];
+    for (int i = 0; i < N; ++i) {
+        ptrs[i] = tracked_block();
+        ASSERT(ttak_mem_tree_add(&tree, ptrs[i], 64, __TTAK_UNSAFE_MEM_FOREVER__, true) != NULL);
+    }
+    size_t slabs = tree.slab_count;
+    ASSERT(slabs == 4);
+
+    /* Detached nodes go back to the free list and are handed out again. */
+    for (int round = 0; round < 3; ++round) {
+        ttak_mem_tree_remove_bulk(&tree, ptrs, N);
+        ASSERT(ttak_mem_tree_node_count(&tree) == 0);
+        for (int i = 0; i < N; ++i) {
+            ttak_mem_node_t *node = ttak_mem_tree_add(&tree, ptrs[i], 64, __TTAK_UNSAFE_MEM_FOREVER__, true);
+            ASSERT(node != NULL && atomic_load(&node->ref_count) == 1);
+        }
+        ASSERT(tree.slab_count == slabs);
+    }
+    ASSERT(ttak_mem_tree_find_node(&tree, ptrs[N - 1])->ptr == ptrs[N - 1]);
+
+    ttak_mem_tree_destroy(&tree);
+}
+
+typedef struct {
+    ttak_mem_tree_t *tree;
+    void **stable;
+    int count;
+    _Atomic int *stop;
+    _Atomic int misses;
+} lookup_ctx_t;
+
+static void *lookup_reader(void *arg) {
+    lookup_ctx_t *ctx = arg;
+    while (!atomic_load(ctx->stop)) {
+        for (int i = 0; i < ctx->count; ++i) {
+            ttak_mem_node_t *node = ttak_mem_tree_find_node(ctx->tree, ctx->stable[i]);
+            if (!node || node->ptr != ctx->stable[i]) atomic_fetch_add(&ctx->misses, 1);
+        }
+    }
+    return NULL;
+}
+
+static void test_mem_tree_lockfree_lookup_during_churn(void) {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+    ttak_mem_tree_set_manual_cleanup(&tree, true);
+
+    enum { STABLE = 512, CHURN = 4096 };
+    static void *stable[STABLE];
+    static void *churn[CHURN];
+    for (int i = 0; i < STABLE; ++i) {
+        stable[i] = tracked_block();
+        ASSERT(ttak_mem_tree_add(&tree, stable[i], 64, __TTAK_UNSAFE_MEM_FOREVER__, true) != NULL);
+    }
+    for (int i = 0; i < CHURN; ++i) churn[i] = tracked_block();
+
+    _Atomic int stop = 0;
+    lookup_ctx_t ctx = { .tree = &tree, .stable = stable, .count = STABLE, .stop = &stop };
+    pthread_t readers[2];
+    for (int i = 0; i < 2; ++i) ASSERT(pthread_create(&readers[i], NULL, lookup_reader, &ctx) == 0);
+
+    /* Grows the index through several rebuilds and leaves tombstones behind. */
+    for (int round = 0; round < 8; ++round) {
+        for (int i = 0; i < CHURN; ++i) {
+            ASSERT(ttak_mem_tree_add(&tree, churn[i], 64, __TTAK_UNSAFE_MEM_FOREVER__, true) != NULL);
+        }
+        ttak_mem_tree_remove_bulk(&tree, churn, CHURN);
+    }
+    atomic_store(&stop, 1);
+    for (int i = 0; i < 2; ++i) pthread_join(readers[i], NULL);
+
+    ASSERT(atomic_load(&ctx.misses) == 0);
+    ASSERT(ttak_mem_tree_node_count(&tree) == STABLE);
+    ASSERT(ttak_mem_tree_find_node(&tree, churn[0]) == NULL);
+    for (int i = 0; i < CHURN; ++i) ttak_mem_free(churn[i]);
+    ttak_mem_tree_destroy(&tree);
+}
+
+static void test_mem_tree_remove_after_drain(void) {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+    ttak_mem_tree_set_manual_cleanup(&tree, true);
+
+    enum { N = TTAK_MEM_TREE_SLAB_NODES * 2 };
+    static void *ptrs[N];
+    static ttak_mem_node_t *nodes[N];
+    uint64_t now = TT_SECOND(10);
+    for (int i = 0; i < N; ++i) {
+        ptrs[i] = tracked_block();
+        nodes[i] = ttak_mem_tree_add(&tree, ptrs[i], 64, now + TT_MINUTE(5), true);
+        ASSERT(nodes[i] != NULL);
+    }
+    /* The sweep drains the shard inboxes into the wheel. */
+    ttak_mem_tree_report_pressure(&tree, 1);
+    ttak_mem_tree_perform_cleanup(&tree, now);
+    ASSERT(ttak_mem_tree_node_count(&tree) == N);
+
+    /* Filed nodes are only detached here; the next drain recycles them. */
+    for (int i = 0; i < N; i += 2) ttak_mem_tree_remove(&tree, nodes[i]);
+    ASSERT(ttak_mem_tree_node_count(&tree) == N / 2);
+    ASSERT(ttak_mem_tree_find_node(&tree, ptrs[0]) == NULL);
+    ASSERT(ttak_mem_tree_find_node(&tree, ptrs[1]) == nodes[1]);
+
+    /* Expiry must skip the detached nodes and free only the tracked ones. */
+    for (int i = 1; i < N; i += 2) ttak_mem_node_release(nodes[i]);
+    ttak_mem_tree_report_pressure(&tree, 1);
+    ttak_mem_tree_perform_cleanup(&tree, now + TT_MINUTE(6));
+    ASSERT(ttak_mem_tree_node_count(&tree) == 0);
+
+    size_t slabs = tree.slab_count;
+    for (int i = 0; i < N; i += 2) {
+        ASSERT(ttak_mem_tree_add(&tree, ptrs[i], 64, __TTAK_UNSAFE_MEM_FOREVER__, true) != NULL);
+    }
+    ASSERT(tree.slab_count == slabs);
+
+    ttak_mem_tree_destroy(&tree);
+}
+
+typedef struct {
+    ttak_mem_tree_t *tree;
+    void **blocks;
+    int count;
+    _Atomic int failures;
+} churn_ctx_t;
+
+static void *churn_writer(void *arg) {
+    churn_ctx_t *ctx = arg;
+    for (int round = 0; round < 64; ++round) {
+        for (int i = 0; i < ctx->count; ++i) {
+            if (!ttak_mem_tree_add(ctx->tree, ctx->blocks[i], 64, TT_SECOND(1), true)) atomic_fetch_add(&ctx->failures, 1);
+        }
+        for (int i = 0; i < ctx->count; ++i) {
+            ttak_mem_node_t *node = ttak_mem_tree_find_node(ctx->tree, ctx->blocks[i]);
+            if (!node) atomic_fetch_add(&ctx->failures, 1);
+            else ttak_mem_tree_remove(ctx->tree, node);
+        }
+    }
+    return NULL;
+}
+
+static void test_mem_tree_sharded_churn_during_sweeps(void) {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+    ttak_mem_tree_set_manual_cleanup(&tree, true);
+
+    enum { WRITERS = 4, PER = 256 };
+    static void *blocks[WRITERS][PER];
+    churn_ctx_t ctx[WRITERS];
+    pthread_t th[WRITERS];
+    for (int w = 0; w < WRITERS; ++w) {
+        for (int i = 0; i < PER; ++i) blocks[w][i] = tracked_block();
+        ctx[w] = (churn_ctx_t){ .tree = &tree, .blocks = blocks[w], .count = PER };
+        ASSERT(pthread_create(&th[w], NULL, churn_writer, &ctx[w]) == 0);
+    }
+    /* The writers hold a reference, so sweeps only file and recycle nodes. */
+    for (int i = 0; i < 200; ++i) {
+        ttak_mem_tree_report_pressure(&tree, 1);
+        ttak_mem_tree_perform_cleanup(&tree, TT_SECOND(2));
+    }
+    for (int w = 0; w < WRITERS; ++w) {
+        pthread_join(th[w], NULL);
+        ASSERT(atomic_load(&ctx[w].failures) == 0);
+    }
+    ASSERT(ttak_mem_tree_node_count(&tree) == 0);
+
+    ttak_mem_tree_destroy(&tree);
+    for (int w = 0; w < WRITERS; ++w) {
+        for (int i = 0; i < PER; ++i) ttak_mem_free(blocks[w][i]);
+    }
+}
+
+int main(void) {
+    RUN_TEST(test_mem_tree_sweeps_only_expired);
+    RUN_TEST(test_mem_tree_far_future_and_referenced);
+    RUN_TEST(test_mem_tree_index_lookup);
+    RUN_TEST(test_mem_tree_cleanup_thread_starts_on_first_add);
+    RUN_TEST(test_mem_tree_slab_recycles_nodes);
+    RUN_TEST(test_mem_tree_lockfree_lookup_during_churn);
+    RUN_TEST(test_mem_tree_remove_after_drain);
+    RUN_TEST(test_mem_tree_sharded_churn_during_sweeps);
+    return 0;
+}
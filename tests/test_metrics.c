@@ -0,0 +1,198 @@
+#include <ttak/stats/metrics.h>
+#include <ttak/thread/pool.h>
+#include <ttak/net/lattice.h>
+#include <ttak/timing/timing.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+typedef struct {
+    char *data;
+    size_t len;
+} text_t;
+
+static int text_sink(void *arg, const char *data, size_t len) {
+    text_t *t = arg;
+    char *grown = realloc(t->data, t->len + len + 1);
+    if (!grown) return -1;
+    memcpy(grown + t->len, data, len);
+    t->data = grown;
+    t->len += len;
+    t->data[t->len] = '\0';
+    return 0;
+}
+
+static char *render(ttak_metrics_registry_t *reg) {
+    text_t t = { NULL, 0 };
+    ASSERT(ttak_metrics_write(reg, text_sink, &t) == 0);
+    return t.data ? t.data : calloc(1, 1);
+}
+
+static size_t count_of(const char *hay, const char *needle) {
+    size_t n = 0;
+    for (const char *p = strstr(hay, needle); p; p = strstr(p + 1, needle)) n++;
+    return n;
+}
+
+typedef struct {
+    ttak_metric_t *counter;
+    int iters;
+} bump_arg_t;
+
+static void *bump(void *arg) {
+    bump_arg_t *a = arg;
+    for (int i = 0; i < a->iters; i++) ttak_metric_inc(a->counter);
+    return NULL;
+}
+
+static void test_metrics_owned_series(void) {
+    ttak_metrics_registry_t reg;
+    ttak_metrics_registry_init(&reg);
+    ASSERT(ttak_metrics_counter(&reg, "9bad", NULL, NULL) == NULL);
+    ASSERT(ttak_metrics_counter(&reg, "bad-name", NULL, NULL) == NULL);
+
+    ttak_metric_t *c = ttak_metrics_counter(&reg, "req_total", "Requests\nserved.", "route=\"/a\"");
+    ttak_metric_t *c2 = ttak_metrics_counter(&reg, "req_total", NULL, "route=\"/b\"");
+    ttak_metric_t *g = ttak_metrics_gauge(&reg, "inflight", "In flight.", NULL);
+    ttak_metric_t *h = ttak_metrics_histogram(&reg, "latency_ns", "Latency.", NULL);
+    ASSERT(c && c2 && g && h);
+
+    pthread_t th[4];
+    bump_arg_t arg = { c, 25000 };
+    for (int i = 0; i < 4; i++) ASSERT(pthread_create(&th[i], NULL, bump, &arg) == 0);
+    for (int i = 0; i < 4; i++) pthread_join(th[i], NULL);
+    ASSERT(ttak_metric_value(c) == 100000.0);
+    ttak_metric_add(c2, 7);
+
+    ttak_metric_set(g, 10);
+    ttak_metric_gauge_add(g, -13);
+    ASSERT(ttak_metric_value(g) == -3.0);
+
+    for (uint64_t v = 1; v <= 1000; v++) ttak_metric_observe(h, v);
+
+    char *out = render(&reg);
+    /* Both series of one family under a single header. */
+    ASSERT(count_of(out, "# TYPE req_total counter") == 1);
+    ASSERT(strstr(out, "# HELP req_total Requests\\nserved.\n") != NULL);
+    ASSERT(strstr(out, "req_total{route=\"/a\"} 100000\n") != NULL);
+    ASSERT(strstr(out, "req_total{route=\"/b\"} 7\n") != NULL);
+    ASSERT(strstr(out, "inflight -3\n") != NULL);
+    ASSERT(strstr(out, "# TYPE latency_ns histogram") != NULL);
+    ASSERT(strstr(out, "latency_ns_bucket{le=\"0\"} 0\n") != NULL);
+    ASSERT(strstr(out, "latency_ns_bucket{le=\"1\"} 1\n") != NULL);
+    ASSERT(strstr(out, "latency_ns_bucket{le=\"511\"} 511\n") != NULL);
+    ASSERT(strstr(out, "latency_ns_bucket{le=\"1023\"} 1000\n") != NULL);
+    ASSERT(strstr(out, "latency_ns_bucket{le=\"2047\"}") == NULL);
+    ASSERT(strstr(out, "latency_ns_bucket{le=\"+Inf\"} 1000\n") != NULL);
+    ASSERT(strstr(out, "latency_ns_sum 500500\n") != NULL);
+    ASSERT(strstr(out, "latency_ns_count 1000\n") != NULL);
+    free(out);
+
+    ttak_metrics_unregister(&reg, c2);
+    out = render(&reg);
+    ASSERT(strstr(out, "route=\"/b\"") == NULL);
+    ASSERT(strstr(out, "route=\"/a\"") != NULL);
+    free(out);
+    ttak_metrics_registry_destroy(&reg);
+}
+
+static double read_half(void *arg) {
+    return *(double *)arg / 2;
+}
+
+static void test_metrics_callbacks_and_owners(void) {
+    ttak_metrics_registry_t reg;
+    ttak_metrics_registry_init(&reg);
+    static double src = 5;
+    int owner;
+    ASSERT(ttak_metrics_register_fn(&reg, TTAK_METRIC_GAUGE, "half", NULL, NULL, read_half, &src, &owner));
+    ASSERT(ttak_metrics_register_fn(&reg, TTAK_METRIC_HISTOGRAM, "nope", NULL, NULL, read_half, &src, &owner) == NULL);
+    char *out = render(&reg);
+    ASSERT(strstr(out, "half 2.5\n") != NULL);
+    free(out);
+    ASSERT(ttak_metrics_unregister_owner(&reg, &owner) == 1);
+    out = render(&reg);
+    ASSERT(out[0] == '\0');
+    free(out);
+    ttak_metrics_registry_destroy(&reg);
+}
+
+static void test_metrics_pool_and_lattice_export(void) {
+    ttak_metrics_registry_t reg;
+    ttak_metrics_registry_init(&reg);
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+    ASSERT(ttak_thread_pool_export_metrics(pool, &reg, "pool=\"t\"") == 11);
+    ASSERT(ttak_thread_pool_export_metrics(pool, &reg, NULL) == 0);
+
+    ttak_net_lattice_t *lat = ttak_net_lattice_create(4, now);
+    ASSERT(lat != NULL);
+    ASSERT(ttak_net_lattice_export_metrics(lat, &reg, NULL) == 4);
+    ASSERT(ttak_net_lattice_write(lat, 0, "hi", 2, now));
+
+    char *out = render(&reg);
+    ASSERT(strstr(out, "ttak_pool_live_workers{pool=\"t\"} 2\n") != NULL);
+    ASSERT(strstr(out, "ttak_pool_burst_magnitude{pool=\"t\",domain=\"3\"}") != NULL);
+    ASSERT(strstr(out, "# TYPE ttak_pool_tasks_done_total counter") != NULL);
+    ASSERT(strstr(out, "ttak_lattice_capacity_slots 16\n") != NULL);
+    ASSERT(strstr(out, "ttak_lattice_nodes 1\n") != NULL);
+    free(out);
+
+    ttak_thread_pool_destroy(pool);
+    ttak_net_lattice_destroy(lat, now);
+    out = render(&reg);
+    ASSERT(out[0] == '\0');
+    free(out);
+    ttak_metrics_registry_destroy(&reg);
+}
+
+static void test_metrics_default_and_http(void) {
+    ttak_metrics_registry_t *reg = ttak_metrics_default();
+    ASSERT(reg == ttak_metrics_default());
+    ttak_metric_t *c = ttak_metrics_counter(reg, "test_scrapes_total", NULL, NULL);
+    ASSERT(c != NULL);
+    ttak_metric_add(c, 3);
+
+    ttak_metrics_server_t *srv = ttak_metrics_server_start(reg, NULL, 0);
+    ASSERT(srv != NULL);
+    ASSERT(ttak_metrics_server_port(srv) != 0);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT(fd >= 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(ttak_metrics_server_port(srv));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    ASSERT(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    const char req[] = "GET /metrics HTTP/1.0\r\n\r\n";
+    ASSERT(send(fd, req, sizeof(req) - 1, 0) == (ssize_t)(sizeof(req) - 1));
+    text_t t = { NULL, 0 };
+    char buf[1024];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) text_sink(&t, buf, (size_t)n);
+    close(fd);
+    ttak_metrics_server_stop(srv);
+
+    ASSERT(t.data != NULL);
+    ASSERT(strncmp(t.data, "HTTP/1.0 200 OK\r\n", 17) == 0);
+    ASSERT(strstr(t.data, "# TYPE ttak_mem_usage_bytes gauge") != NULL);
+    ASSERT(strstr(t.data, "# TYPE ttak_epoch_reclaim_ns histogram") != NULL);
+    ASSERT(strstr(t.data, "test_scrapes_total 3\n") != NULL);
+    free(t.data);
+    ttak_metrics_unregister(reg, c);
+}
+
+int main(void) {
+    RUN_TEST(test_metrics_owned_series);
+    RUN_TEST(test_metrics_callbacks_and_owners);
+    RUN_TEST(test_metrics_pool_and_lattice_export);
+    RUN_TEST(test_metrics_default_and_http);
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <ttak/net/connpool.h>
+#include <ttak/mem/owner.h>
+#include <ttak/timing/timing.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+typedef struct {
+    ttak_shared_net_endpoint_t *_Atomic ep;
+    _Atomic int calls;
+    _Atomic int status;
+} checkout_t;
+
+static void on_ready(ttak_shared_net_endpoint_t *ep, ttak_io_status_t status, void *user) {
+    checkout_t *c = user;
+    atomic_store(&c->status, (int)status);
+    atomic_store(&c->ep, ep);
+    atomic_fetch_add(&c->calls, 1);
+}
+
+static int wait_for(_Atomic int *v, int want) {
+    uint64_t deadline = ttak_get_tick_count() + 5000;
+    while (atomic_load(v) < want) {
+        if (ttak_get_tick_count() > deadline) return 0;
+        sched_yield();
+    }
+    return 1;
+}
+
+static int wait_idle(ttak_net_conn_pool_t *pool, size_t want) {
+    uint64_t deadline = ttak_get_tick_count() + 5000;
+    for (;;) {
+        ttak_net_conn_pool_stats_t st;
+        ttak_net_conn_pool_stats(pool, &st);
+        if (st.idle >= want && st.connecting == 0) return 1;
+        if (ttak_get_tick_count() > deadline) return 0;
+        sched_yield();
+    }
+}
+
+static int listen_loopback(struct sockaddr_in *sa) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT(fd >= 0);
+    memset(sa, 0, sizeof(*sa));
+    sa->sin_family = AF_INET;
+    sa->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT(bind(fd, (struct sockaddr *)sa, sizeof(*sa)) == 0);
+    ASSERT(listen(fd, 16) == 0);
+    socklen_t len = sizeof(*sa);
+    ASSERT(getsockname(fd, (struct sockaddr *)sa, &len) == 0);
+    return fd;
+}
+
+static int endpoint_fd(ttak_shared_net_endpoint_t *ep, ttak_owner_t *owner, uint64_t now) {
+    ttak_net_guard_snapshot_t snap;
+    ASSERT(ttak_net_endpoint_snapshot_guard(ep, owner, &snap, now) == TTAK_IO_SUCCESS);
+    return snap.fd;
+}
+
+static void run_pool(ttak_io_reactor_t *reactor) {
+    uint64_t now = ttak_get_tick_count_ns();
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    struct sockaddr_in sa;
+    int lfd = listen_loopback(&sa);
+
+    ttak_net_conn_pool_config_t cfg = { .max_idle = 2 };
+    ttak_net_conn_pool_t *pool = ttak_net_conn_pool_create(&cfg, reactor, owner);
+    ASSERT(pool != NULL);
+
+    // A miss connects; the handshake completes off the calling thread.
+    checkout_t c1 = { 0 };
+    ASSERT(ttak_net_conn_pool_checkout(pool, &sa, sizeof(sa), on_ready, &c1, now) == TTAK_IO_SUCCESS);
+    ASSERT(wait_for(&c1.calls, 1));
+    ASSERT(atomic_load(&c1.status) == TTAK_IO_SUCCESS && atomic_load(&c1.ep) != NULL);
+    int server = accept(lfd, NULL, NULL);
+    ASSERT(server >= 0);
+    ttak_shared_net_endpoint_t *ep = atomic_load(&c1.ep);
+    ASSERT(write(endpoint_fd(ep, owner, now), "ping", 4) == 4);
+    char buf[8];
+    ASSERT(read(server, buf, sizeof(buf)) == 4);
+
+    // Checked back in, it is handed out again without a new handshake.
+    ttak_net_conn_pool_checkin(pool, ep, true, now);
+    checkout_t c2 = { 0 };
+    ASSERT(ttak_net_conn_pool_checkout(pool, &sa, sizeof(sa), on_ready, &c2, now) == TTAK_IO_SUCCESS);
+    ASSERT(atomic_load(&c2.calls) == 1 && atomic_load(&c2.ep) == ep);
+    ttak_net_conn_pool_stats_t st;
+    ttak_net_conn_pool_stats(pool, &st);
+    ASSERT(st.reused == 1 && st.connected == 1 && st.idle == 0);
+
+    // A connection the peer closed fails the health check and is replaced.
+    ttak_net_conn_pool_checkin(pool, ep, true, now);
+    close(server);
+    checkout_t c3 = { 0 };
+    ASSERT(ttak_net_conn_pool_checkout(pool, &sa, sizeof(sa), on_ready, &c3, now) == TTAK_IO_SUCCESS);
+    ASSERT(wait_for(&c3.calls, 1) && atomic_load(&c3.status) == TTAK_IO_SUCCESS);
+    ttak_net_conn_pool_stats(pool, &st);
+    ASSERT(st.discarded == 1 && st.connected == 2);
+    server = accept(lfd, NULL, NULL);
+    ASSERT(server >= 0);
+    close(server);
+    ttak_net_conn_pool_checkin(pool, atomic_load(&c3.ep), false, now);
+
+    // Prewarming fills the idle list up to max_idle.
+    ASSERT(ttak_net_conn_pool_prewarm(pool, &sa, sizeof(sa), 5, now) == 2);
+    ASSERT(wait_idle(pool, 2));
+    ASSERT(ttak_net_conn_pool_prewarm(pool, &sa, sizeof(sa), 2, now) == 0);
+    int warm[2];
+    for (int i = 0; i < 2; i++) {
+        warm[i] = accept(lfd, NULL, NULL);
+        ASSERT(warm[i] >= 0);
+    }
+
+    // Idle connections past their TTL are not reused.
+    checkout_t c4 = { 0 };
+    ASSERT(ttak_net_conn_pool_checkout(pool, &sa, sizeof(sa), on_ready, &c4,
+                                       now + TTAK_NET_CONN_POOL_DEFAULT_IDLE_TTL + TT_SECOND(100)) == TTAK_IO_SUCCESS);
+    ASSERT(wait_for(&c4.calls, 1) && atomic_load(&c4.status) == TTAK_IO_SUCCESS);
+    ttak_net_conn_pool_stats(pool, &st);
+    ASSERT(st.discarded == 3 && st.idle == 0);
+    ttak_net_conn_pool_checkin(pool, atomic_load(&c4.ep), true, now);
+
+    // A refused connect reports the failure to the callback.
+    close(lfd);
+    checkout_t c5 = { 0 };
+    ttak_io_status_t rc = ttak_net_conn_pool_checkout(pool, &sa, sizeof(sa), on_ready, &c5, now);
+    if (rc == TTAK_IO_SUCCESS) {
+        ASSERT(wait_for(&c5.calls, 1));
+        ASSERT(atomic_load(&c5.ep) == NULL && atomic_load(&c5.status) != TTAK_IO_SUCCESS);
+    }
+
+    ttak_net_conn_pool_destroy(pool, now);
+    for (int i = 0; i < 2; i++) close(warm[i]);
+    ttak_owner_destroy(owner);
+}
+
+static void test_pool_with_reactor(void) {
+    ttak_io_reactor_t *r = ttak_io_reactor_create(1, NULL);
+    ASSERT(r != NULL);
+    run_pool(r);
+    ttak_io_reactor_destroy(r);
+}
+
+static void test_pool_without_reactor(void) {
+    run_pool(NULL);
+}
+
+int main(void) {
+    RUN_TEST(test_pool_with_reactor);
+    RUN_TEST(test_pool_without_reactor);
+    return 0;
+}
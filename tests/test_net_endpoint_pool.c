@@ -0,0 +1,161 @@
+#include <ttak/net/endpoint.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/mem/owner.h>
+#include <ttak/timing/timing.h>
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+/* Lets the grace period of every pending release pass. */
+static void drain_releases(ttak_net_endpoint_pool_t *pool) {
+    for (int i = 0; i < 8 && atomic_load(&pool->deferred) > 0; i++) {
+        ttak_epoch_flush();
+        ttak_epoch_reclaim();
+    }
+}
+
+static void bind_socket(ttak_shared_net_endpoint_t *ep, ttak_owner_t *owner, uint64_t now) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT(fd >= 0);
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT(ttak_net_endpoint_bind_fd(ep, owner, fd, AF_INET, SOCK_DGRAM, 0, &sa, sizeof(sa),
+                                     TTAK_NET_ENDPOINT_IPV4, TT_SECOND(30), now) == TTAK_IO_SUCCESS);
+}
+
+static void test_release_then_reuse(void) {
+    uint64_t now = TT_SECOND(100);
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_net_endpoint_pool_t pool;
+    ttak_net_endpoint_pool_init(&pool, 4);
+
+    ttak_shared_net_endpoint_t *ep = ttak_net_endpoint_pool_acquire(&pool, owner, now);
+    ASSERT(ep != NULL && pool.created == 1);
+    bind_socket(ep, owner, now);
+    ttak_net_endpoint_attr_t attr = { .role_flags = TTAK_NET_ROLE_SERVER, .listen_backlog = 7 };
+    ttak_net_endpoint_set_role(ep, &attr, owner, now);
+    ttak_net_guard_snapshot_t stale;
+    ASSERT(ttak_net_endpoint_snapshot_guard(ep, owner, &stale, now) == TTAK_IO_SUCCESS);
+
+    // A release only becomes reusable once its epoch has passed.
+    ttak_net_endpoint_pool_release(&pool, ep, owner, now);
+    ASSERT(pool.deferred == 1 && pool.idle == 0);
+    drain_releases(&pool);
+    ASSERT(pool.deferred == 0 && pool.idle == 1);
+
+    ttak_shared_net_endpoint_t *again = ttak_net_endpoint_pool_acquire(&pool, owner, now + 1);
+    ASSERT(again == ep && pool.reused == 1 && pool.created == 1 && pool.idle == 0);
+
+    // The payload is back to its create() state and old snapshots are stale.
+    ttak_shared_result_t res = 0;
+    ttak_net_endpoint_t *p = ttak_shared_net_endpoint_access(again, owner, &res);
+    ASSERT(p != NULL && res == TTAK_OWNER_SUCCESS);
+    ASSERT(p->fd == -1 && p->guard.closed && p->addr.len == 0);
+    ASSERT(p->role_flags == TTAK_NET_ROLE_CLIENT && p->listen_backlog == SOMAXCONN);
+    ASSERT(p->generation_id > stale.guard_generation);
+    ttak_shared_net_endpoint_release(again);
+    bind_socket(again, owner, now + 1);
+    ASSERT(ttak_net_endpoint_guard_commit(&stale, now + 2) == TTAK_IO_SUCCESS);
+    p = ttak_shared_net_endpoint_access(again, owner, &res);
+    ASSERT(p != NULL && p->guard.last_used == now + 1);
+    ttak_shared_net_endpoint_release(again);
+
+    ttak_net_endpoint_pool_release(&pool, again, owner, now + 3);
+    ttak_net_endpoint_pool_destroy(&pool, now + 3);
+    ASSERT(pool.idle == 0 && pool.deferred == 0);
+    ttak_owner_destroy(owner);
+}
+
+static void test_reuse_moves_owner(void) {
+    uint64_t now = TT_SECOND(100);
+    ttak_owner_t *a = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ttak_owner_t *b = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(a != NULL && b != NULL);
+    ttak_net_endpoint_pool_t pool;
+    ttak_net_endpoint_pool_init(&pool, 0);
+    ASSERT(pool.max_idle == TTAK_NET_ENDPOINT_POOL_DEFAULT_IDLE);
+
+    ttak_shared_net_endpoint_t *ep = ttak_net_endpoint_pool_acquire(&pool, a, now);
+    ASSERT(ep != NULL);
+    ttak_net_endpoint_pool_release(&pool, ep, a, now);
+    drain_releases(&pool);
+
+    ttak_shared_net_endpoint_t *again = ttak_net_endpoint_pool_acquire(&pool, b, now);
+    ASSERT(again == ep);
+    ttak_shared_result_t res = 0;
+    ASSERT(ttak_shared_net_endpoint_access(again, b, &res) != NULL && res == TTAK_OWNER_SUCCESS);
+    ttak_shared_net_endpoint_release(again);
+    // The previous owner lost its access along with the connection.
+    res = 0;
+    ASSERT(ttak_shared_net_endpoint_access(again, a, &res) == NULL || res != TTAK_OWNER_SUCCESS);
+    bind_socket(again, b, now);
+
+    ttak_net_endpoint_pool_release(&pool, again, b, now);
+    ttak_net_endpoint_pool_destroy(&pool, now);
+    ttak_owner_destroy(a);
+    ttak_owner_destroy(b);
+}
+
+static void test_pool_caps_idle(void) {
+    uint64_t now = TT_SECOND(100);
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_net_endpoint_pool_t pool;
+    ttak_net_endpoint_pool_init(&pool, 2);
+
+    ttak_shared_net_endpoint_t *eps[4];
+    for (int i = 0; i < 4; i++) {
+        eps[i] = ttak_net_endpoint_pool_acquire(&pool, owner, now);
+        ASSERT(eps[i] != NULL);
+    }
+    ASSERT(pool.created == 4);
+    for (int i = 0; i < 4; i++) ttak_net_endpoint_pool_release(&pool, eps[i], owner, now);
+    drain_releases(&pool);
+    ASSERT(pool.idle == 2);
+
+    // Endpoints created outside the pool are destroyed rather than kept.
+    ttak_shared_net_endpoint_t *plain = ttak_net_endpoint_create(owner, now);
+    ASSERT(plain != NULL);
+    ttak_net_endpoint_destroy(plain, owner, now);
+
+    ttak_net_endpoint_pool_destroy(&pool, now);
+    ttak_owner_destroy(owner);
+}
+
+static void test_guard_rebind(void) {
+    uint64_t now = TT_SECOND(100);
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    int sv[2];
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+    ttak_io_guard_t g;
+    ASSERT(ttak_io_guard_init(&g, sv[0], owner, TT_SECOND(1), now) == TTAK_IO_SUCCESS);
+    char tag[32];
+    snprintf(tag, sizeof(tag), "iofd-%d", sv[0]);
+    ASSERT(strcmp(g.resource_tag, tag) == 0);
+    ASSERT(ttak_io_guard_close(&g, now) == TTAK_IO_SUCCESS);
+    ASSERT(!ttak_io_guard_valid(&g, now));
+
+    ASSERT(ttak_io_guard_rebind(&g, sv[1], owner, TT_SECOND(1), now + 5) == TTAK_IO_SUCCESS);
+    snprintf(tag, sizeof(tag), "iofd-%d", sv[1]);
+    ASSERT(strcmp(g.resource_tag, tag) == 0);
+    ASSERT(ttak_io_guard_valid(&g, now + 5) && g.expires_at == now + 5 + TT_SECOND(1));
+    ASSERT(ttak_io_guard_rebind(&g, -1, owner, TT_SECOND(1), now) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ttak_io_guard_close(&g, now);
+    ttak_owner_destroy(owner);
+}
+
+int main(void) {
+    RUN_TEST(test_release_then_reuse);
+    RUN_TEST(test_reuse_moves_owner);
+    RUN_TEST(test_pool_caps_idle);
+    RUN_TEST(test_guard_rebind);
+    return 0;
+}
@@ -0,0 +1,321 @@
+#include <ttak/net/lattice.h>
+#include <ttak/io/reactor.h>
+#include <ttak/timing/timing.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static void test_lattice_sized_slots(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_lattice_t *lat = ttak_net_lattice_create_sized(4, 1500, now);
+    ASSERT(lat != NULL);
+    ASSERT(lat->slot_size == 1536);
+    ASSERT(ttak_net_lattice_create_sized(4, TTAK_LATTICE_MAX_SLOT_SIZE + 1, now) == NULL);
+
+    // Payloads sit back to back behind the descriptors.
+    ASSERT(lat->slots[1].data == lat->slots[0].data + lat->slot_size);
+    ASSERT(lat->slots[0].data == (uint8_t *)(lat->slots + lat->capacity));
+
+    uint8_t pkt[1536], out[1536];
+    for (size_t i = 0; i < sizeof(pkt); i++) pkt[i] = (uint8_t)(i * 7U);
+    ASSERT(!ttak_net_lattice_write(lat, 0, pkt, 1537, now));
+    ASSERT(ttak_net_lattice_write(lat, 0, pkt, 1536, now));
+    uint32_t len = 0;
+    ASSERT(ttak_net_lattice_read(lat, 0, out, &len, now));
+    ASSERT(len == 1536 && memcmp(pkt, out, len) == 0);
+
+    // Filling the lattice grows a successor with the same slot size.
+    for (uint32_t i = 0; i < lat->capacity + 4; i++) ASSERT(ttak_net_lattice_write(lat, 0, pkt, 64, now));
+    ASSERT(lat->next != NULL && lat->next->slot_size == lat->slot_size);
+    ttak_net_lattice_destroy(lat, now);
+}
+
+static void test_lattice_classes(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_lattice_classes_t set;
+    ASSERT(!ttak_net_lattice_classes_init(&set, 3));
+    ASSERT(ttak_net_lattice_classes_init(&set, 4));
+    ASSERT(ttak_net_lattice_class_size(0) == 256 && ttak_net_lattice_class_size(3) == 65536);
+    ASSERT(ttak_net_lattice_class_size(TTAK_LATTICE_CLASSES) == 0);
+
+    uint8_t *big = malloc(65536);
+    uint8_t *out = malloc(65536);
+    ASSERT(big && out);
+    for (size_t i = 0; i < 65536; i++) big[i] = (uint8_t)(i ^ (i >> 8));
+
+    // Each payload lands in the smallest class that fits; untouched classes stay unallocated.
+    ASSERT(ttak_net_lattice_classes_write(&set, 0, big, 200, now));
+    ASSERT(ttak_net_lattice_classes_write(&set, 0, big, 1400, now));
+    ASSERT(ttak_net_lattice_classes_write(&set, 0, big, 40000, now));
+    ASSERT(!ttak_net_lattice_classes_write(&set, 0, big, 65537, now));
+    ASSERT(set.lattices[0] != NULL && set.lattices[1] != NULL);
+    ASSERT(set.lattices[2] == NULL && set.lattices[3] != NULL);
+
+    // A small destination only sees classes it can hold.
+    uint32_t len = 0;
+    ASSERT(ttak_net_lattice_classes_read(&set, 0, out, 2048, &len, now));
+    ASSERT(len == 200 && memcmp(out, big, len) == 0);
+    ASSERT(ttak_net_lattice_classes_read(&set, 0, out, 2048, &len, now));
+    ASSERT(len == 1400 && memcmp(out, big, len) == 0);
+    ASSERT(!ttak_net_lattice_classes_read(&set, 0, out, 2048, &len, now));
+    ASSERT(ttak_net_lattice_classes_read(&set, 0, out, 65536, &len, now));
+    ASSERT(len == 40000 && memcmp(out, big, len) == 0);
+
+    ttak_net_lattice_classes_destroy(&set, now);
+    free(big);
+    free(out);
+}
+
+static void test_lattice_batches(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_lattice_t *lat = ttak_net_lattice_create_sized(4, 2048, now);
+    ASSERT(lat != NULL);
+
+    // More messages than one lattice gives a worker spill into successors.
+    enum { N = 48 };
+    uint8_t pkts[N][64];
+    ttak_net_lattice_msg_t in[N];
+    for (int i = 0; i < N; i++) {
+        memset(pkts[i], i, sizeof(pkts[i]));
+        in[i].data = pkts[i];
+        in[i].len = (uint32_t)(i + 1);
+    }
+    ASSERT(ttak_net_lattice_write_batch(lat, 2, in, N, now) == N);
+    ASSERT(lat->next != NULL);
+
+    // Another worker sees none of them; the writer's reads come back in order, in place.
+    ttak_net_lattice_msg_t out[N];
+    ASSERT(ttak_net_lattice_read_batch(lat, 0, out, N, now) == 0);
+    ASSERT(ttak_net_lattice_read_batch(lat, 2, out, 20, now) == 20);
+    size_t got = 20 + ttak_net_lattice_read_batch(lat, 2, out + 20, N, now);
+    ASSERT(got == N);
+    for (int i = 0; i < N; i++) {
+        ASSERT(out[i].len == (uint32_t)(i + 1) && out[i].data[0] == (uint8_t)i);
+        ASSERT(out[i].data == out[i].slot->data);
+    }
+    ttak_net_lattice_release_batch(out, N);
+    for (const ttak_net_lattice_t *node = lat; node; node = node->next) {
+        ASSERT(node->used_slots == 0);
+    }
+
+    // Released slots take new writes; an oversized message ends the batch.
+    in[2].len = 4096;
+    ASSERT(ttak_net_lattice_write_batch(lat, 2, in, N, now) == 2);
+    ttak_net_lattice_destroy(lat, now);
+}
+
+#define BELL_MSGS 2000
+
+typedef struct {
+    ttak_net_lattice_t *lat;
+    _Atomic uint32_t got;
+    uint32_t waits;
+} bell_consumer_t;
+
+static void *bell_consumer_main(void *p) {
+    bell_consumer_t *c = p;
+    ttak_net_lattice_msg_t out[16];
+    while (atomic_load(&c->got) < BELL_MSGS) {
+        size_t n = ttak_net_lattice_read_batch(c->lat, 2, out, 16, 0);
+        if (n == 0) {
+            c->waits++;
+            ASSERT(ttak_net_lattice_wait(c->lat, 2, TTAK_WAIT_FOREVER));
+            continue;
+        }
+        ttak_net_lattice_release_batch(out, n);
+        atomic_fetch_add(&c->got, (uint32_t)n);
+    }
+    return NULL;
+}
+
+/* Writes for lane 2 in bursts, pausing so the consumer goes to sleep between them. */
+static void bell_produce(ttak_net_lattice_t *lat) {
+    uint8_t pkt[32] = { 7 };
+    ttak_net_lattice_msg_t batch[4];
+    for (int i = 0; i < 4; i++) batch[i] = (ttak_net_lattice_msg_t){ pkt, sizeof(pkt), NULL, NULL };
+    for (uint32_t sent = 0; sent < BELL_MSGS;) {
+        if (sent % 8 == 0) {
+            size_t n = ttak_net_lattice_write_batch(lat, 2, batch, 4, 0);
+            sent += (uint32_t)n;
+            if (n == 0) sched_yield();
+        } else if (ttak_net_lattice_write(lat, 2, pkt, sizeof(pkt), 0)) {
+            sent++;
+        } else {
+            sched_yield();
+        }
+        if (sent % 100 == 0) usleep(200);
+    }
+}
+
+static void test_lattice_doorbell_wait(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_lattice_t *lat = ttak_net_lattice_create_sized(4, 256, now);
+    ASSERT(lat != NULL);
+    ASSERT(!ttak_net_lattice_wait(lat, 2, 0));
+    ASSERT(ttak_net_lattice_enable_doorbells(lat, false));
+    ASSERT(!ttak_net_lattice_enable_doorbells(lat, false));
+    ASSERT(ttak_net_lattice_doorbell_fd(lat, 2) == -1);
+
+    // Counts are per lane: tid 6 shares lane 2, tid 0 has its own.
+    uint8_t pkt[16] = { 0 };
+    ASSERT(!ttak_net_lattice_wait(lat, 2, 1000000ULL));
+    ASSERT(ttak_net_lattice_write(lat, 6, pkt, sizeof(pkt), now));
+    ASSERT(ttak_net_lattice_write(lat, 2, pkt, sizeof(pkt), now));
+    ASSERT(ttak_net_lattice_pending(lat, 2) == 2 && ttak_net_lattice_pending(lat, 0) == 0);
+    ASSERT(ttak_net_lattice_wait(lat, 2, 0));
+    ASSERT(!ttak_net_lattice_doorbell_arm(lat, 2));
+    uint32_t len;
+    uint8_t out[256];
+    ASSERT(ttak_net_lattice_read(lat, 2, out, &len, now));
+    ASSERT(ttak_net_lattice_pending(lat, 6) == 1);
+    ASSERT(ttak_net_lattice_read(lat, 2, out, &len, now));
+    ASSERT(ttak_net_lattice_pending(lat, 2) == 0);
+
+    bell_consumer_t c = { .lat = lat };
+    pthread_t th;
+    ASSERT(pthread_create(&th, NULL, bell_consumer_main, &c) == 0);
+    bell_produce(lat);
+    pthread_join(th, NULL);
+    ASSERT(atomic_load(&c.got) == BELL_MSGS && c.waits > 0);
+    ASSERT(ttak_net_lattice_pending(lat, 2) == 0);
+    ttak_net_lattice_destroy(lat, now);
+}
+
+typedef struct {
+    ttak_net_lattice_t *lat;
+    _Atomic uint32_t got;
+    _Atomic uint32_t wakeups;
+} bell_watch_t;
+
+static void bell_on_ready(int fd, short revents, void *user) {
+    (void)fd;
+    bell_watch_t *w = user;
+    if (!(revents & POLLIN)) return;
+    atomic_fetch_add(&w->wakeups, 1);
+    ttak_net_lattice_msg_t out[16];
+    do {
+        size_t n;
+        while ((n = ttak_net_lattice_read_batch(w->lat, 2, out, 16, 0)) > 0) {
+            ttak_net_lattice_release_batch(out, n);
+            atomic_fetch_add(&w->got, (uint32_t)n);
+        }
+    } while (!ttak_net_lattice_doorbell_arm(w->lat, 2));
+}
+
+static void test_lattice_doorbell_reactor(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_lattice_t *lat = ttak_net_lattice_create_sized(4, 256, now);
+    ASSERT(lat != NULL);
+    ASSERT(ttak_net_lattice_enable_doorbells(lat, true));
+    int fd = ttak_net_lattice_doorbell_fd(lat, 2);
+    ASSERT(fd >= 0 && ttak_net_lattice_doorbell_fd(lat, 0) != fd);
+
+    // Unarmed, writes only count; the eventfd stays quiet.
+    uint8_t pkt[16] = { 0 };
+    ASSERT(ttak_net_lattice_write(lat, 2, pkt, sizeof(pkt), now));
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    ASSERT(poll(&pfd, 1, 0) == 0);
+    uint32_t len;
+    uint8_t out[256];
+    ASSERT(ttak_net_lattice_read(lat, 2, out, &len, now));
+
+    // Armed, the first write makes it readable and later ones add nothing.
+    ASSERT(ttak_net_lattice_doorbell_arm(lat, 2));
+    ASSERT(ttak_net_lattice_write(lat, 2, pkt, sizeof(pkt), now));
+    ASSERT(ttak_net_lattice_write(lat, 2, pkt, sizeof(pkt), now));
+    ASSERT(poll(&pfd, 1, 0) == 1);
+    uint64_t count = 0;
+    ASSERT(read(fd, &count, sizeof(count)) == sizeof(count) && count == 1);
+    ASSERT(ttak_net_lattice_read(lat, 2, out, &len, now));
+    ASSERT(ttak_net_lattice_read(lat, 2, out, &len, now));
+
+    ttak_io_reactor_t *r = ttak_io_reactor_create(1, NULL);
+    ASSERT(r != NULL);
+    bell_watch_t w = { .lat = lat };
+    ttak_io_guard_t guard;
+    ASSERT(ttak_io_guard_init(&guard, dup(fd), NULL, TT_HOUR(1), now) == TTAK_IO_SUCCESS);
+    ttak_io_watch_t *watch = NULL;
+    ASSERT(ttak_net_lattice_doorbell_arm(lat, 2));
+    ASSERT(ttak_io_reactor_add(r, &guard, POLLIN, bell_on_ready, &w, NULL, &watch, now) == TTAK_IO_SUCCESS);
+    bell_produce(lat);
+    uint64_t deadline = ttak_get_tick_count() + 5000;
+    while (atomic_load(&w.got) < BELL_MSGS && ttak_get_tick_count() < deadline) usleep(1000);
+    ASSERT(atomic_load(&w.got) == BELL_MSGS);
+    // Bursts coalesce: far fewer wakeups than messages.
+    ASSERT(atomic_load(&w.wakeups) > 0 && atomic_load(&w.wakeups) < BELL_MSGS / 2);
+
+    ttak_io_reactor_remove(watch);
+    ttak_io_reactor_destroy(r);
+    ttak_io_guard_close(&guard, now);
+    ttak_net_lattice_destroy(lat, now);
+}
+
+static void maint_wait(ttak_net_lattice_t *lat, ttak_net_lattice_maint_stats_t *st, uint64_t spares,
+                       uint64_t compactions) {
+    for (int i = 0; i < 2000; i++) {
+        ttak_net_lattice_maintenance_stats(lat, st);
+        if (st->spares >= spares && st->compactions >= compactions) return;
+        usleep(1000);
+    }
+    ASSERT(!"maintenance thread made no progress");
+}
+
+static void test_lattice_maintenance(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_lattice_t *lat = ttak_net_lattice_create_sized(4, 256, now);
+    ASSERT(lat != NULL);
+    ASSERT(ttak_net_lattice_start_maintenance(lat, 4) == 0);
+    ASSERT(ttak_net_lattice_start_maintenance(lat, 4) == EALREADY);
+    ttak_net_lattice_maint_stats_t st;
+    maint_wait(lat, &st, 4, 0);
+
+    // A burst over ten lattices' worth links spares or lattices grown ahead first.
+    enum { MSGS = 160 };
+    uint8_t pkt[256], out[256];
+    for (int i = 0; i < MSGS; i++) {
+        memset(pkt, i, 64);
+        ASSERT(ttak_net_lattice_write(lat, (uint32_t)(i & 1) * 2, pkt, 64, now));
+    }
+    uint64_t nodes = 0;
+    for (const ttak_net_lattice_t *node = lat; node; node = node->next) nodes++;
+    ASSERT(nodes >= MSGS / 16);
+    ttak_net_lattice_maintenance_stats(lat, &st);
+    ASSERT(st.spare_hits + st.grown + st.inline_allocs == nodes - 1);
+    ASSERT(st.spare_hits + st.grown >= 4);
+
+    // Draining leaves idle lattices for the thread to fold; it also refills the spares.
+    uint32_t len;
+    for (int i = 0; i < MSGS; i++) {
+        ASSERT(ttak_net_lattice_read(lat, (uint32_t)(i & 1) * 2, out, &len, now));
+        ASSERT(len == 64);
+    }
+    maint_wait(lat, &st, 4, 1);
+    uint64_t live = 0;
+    for (const ttak_net_lattice_t *node = lat; node; node = node->next) live += !node->is_stub;
+    ASSERT(live < nodes);
+
+    // Writes refill the stubs the compaction left.
+    for (int i = 0; i < MSGS; i++) ASSERT(ttak_net_lattice_write(lat, (uint32_t)(i & 1) * 2, pkt, 64, now));
+    for (int i = 0; i < MSGS; i++) ASSERT(ttak_net_lattice_read(lat, (uint32_t)(i & 1) * 2, out, &len, now));
+
+    ttak_net_lattice_stop_maintenance(lat);
+    ttak_net_lattice_stop_maintenance(lat);
+    ASSERT(ttak_net_lattice_start_maintenance(lat, 2) == 0);
+    ttak_net_lattice_destroy(lat, now);
+}
+
+int main(void) {
+    RUN_TEST(test_lattice_sized_slots);
+    RUN_TEST(test_lattice_classes);
+    RUN_TEST(test_lattice_batches);
+    RUN_TEST(test_lattice_doorbell_wait);
+    RUN_TEST(test_lattice_doorbell_reactor);
+    RUN_TEST(test_lattice_maintenance);
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <ttak/net/endpoint.h>
+#include <ttak/mem/owner.h>
+#include <ttak/timing/timing.h>
+#include <arpa/inet.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static int udp_bound(struct sockaddr_in *addr) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT(fd >= 0);
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT(bind(fd, (struct sockaddr *)addr, sizeof(*addr)) == 0);
+    socklen_t len = sizeof(*addr);
+    ASSERT(getsockname(fd, (struct sockaddr *)addr, &len) == 0);
+    return fd;
+}
+
+static void test_driver_batches(void) {
+    ttak_net_driver_ops_t ops;
+    ttak_net_os_t os;
+    ttak_net_driver_detect(&ops, &os, NULL);
+    ASSERT(ops.socket_sendmmsg && ops.socket_recvmmsg && ops.socket_offload);
+
+    struct sockaddr_in raddr, saddr;
+    int rx = udp_bound(&raddr);
+    int tx = udp_bound(&saddr);
+
+    enum { N = 80 };    /* More than one kernel chunk. */
+    char out[N][16], in[N][16];
+    struct sockaddr_in from[N];
+    ttak_net_msg_t msgs[N];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < N; i++) {
+        memset(out[i], 'a' + i % 26, sizeof(out[i]));
+        msgs[i].buf = out[i];
+        msgs[i].len = (size_t)(i % 16) + 1;
+        msgs[i].addr = &raddr;
+        msgs[i].addr_len = sizeof(raddr);
+    }
+    ASSERT(ops.socket_sendmmsg(tx, msgs, N, 0) == N);
+    for (int i = 0; i < N; i++) ASSERT(msgs[i].bytes == (size_t)(i % 16) + 1);
+
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < N; i++) {
+        msgs[i].buf = in[i];
+        msgs[i].len = sizeof(in[i]);
+        msgs[i].addr = &from[i];
+        msgs[i].addr_len = sizeof(from[i]);
+    }
+    int got = 0;
+    while (got < N) {
+        int rc = ops.socket_recvmmsg(rx, msgs + got, (size_t)(N - got), 0);
+        ASSERT(rc > 0);
+        got += rc;
+    }
+    for (int i = 0; i < N; i++) {
+        ASSERT(msgs[i].bytes == (size_t)(i % 16) + 1 && in[i][0] == 'a' + i % 26);
+        ASSERT(msgs[i].addr_len == sizeof(saddr) && from[i].sin_port == saddr.sin_port);
+    }
+
+    // Nothing queued: a non-blocking batch fails instead of waiting.
+    ASSERT(ops.socket_recvmmsg(rx, msgs, N, MSG_DONTWAIT) == -1);
+
+#if defined(__linux__)
+    // One GSO send arrives as separate datagrams without GRO ...
+    static char big[4 * 500];
+    memset(big, 'g', sizeof(big));
+    ttak_net_msg_t g = { .buf = big, .len = sizeof(big), .addr = &raddr, .addr_len = sizeof(raddr), .gso_size = 500 };
+    if (ops.socket_sendmmsg(tx, &g, 1, 0) == 1) {
+        static char seg[4][512];
+        memset(msgs, 0, sizeof(msgs));
+        for (int i = 0; i < 4; i++) {
+            msgs[i].buf = seg[i];
+            msgs[i].len = sizeof(seg[i]);
+        }
+        got = 0;
+        while (got < 4) {
+            int rc = ops.socket_recvmmsg(rx, msgs + got, (size_t)(4 - got), 0);
+            ASSERT(rc > 0);
+            got += rc;
+        }
+        for (int i = 0; i < 4; i++) ASSERT(msgs[i].bytes == 500 && msgs[i].gso_size == 0);
+
+        // ... and coalesced again with it, reported with the segment size.
+        ttak_net_offload_t cfg = { .udp_gro = true };
+        if (ops.socket_offload(rx, &cfg) == 0) {
+            static char agg[sizeof(big)];
+            ttak_net_msg_t r = { .buf = agg, .len = sizeof(agg) };
+            ASSERT(ops.socket_sendmmsg(tx, &g, 1, 0) == 1);
+            size_t total = 0;
+            while (total < sizeof(big)) {
+                ASSERT(ops.socket_recvmmsg(rx, &r, 1, 0) == 1);
+                ASSERT(r.gso_size == 0 || r.gso_size == 500);
+                total += r.bytes;
+            }
+            ASSERT(total == sizeof(big));
+        }
+    }
+#endif
+    close(rx);
+    close(tx);
+}
+
+static void test_endpoint_batches(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_shared_net_endpoint_t *ep = ttak_net_endpoint_create(owner, now);
+    ASSERT(ep != NULL);
+
+    struct sockaddr_in raddr, saddr;
+    int rx = udp_bound(&raddr);
+    int tx = udp_bound(&saddr);
+    ASSERT(connect(tx, (struct sockaddr *)&raddr, sizeof(raddr)) == 0);
+    ASSERT(ttak_net_endpoint_bind_fd(ep, owner, tx, AF_INET, SOCK_DGRAM, 0, &raddr, (uint8_t)sizeof(raddr),
+                                     TTAK_NET_ENDPOINT_IPV4, TT_HOUR(1), now) == TTAK_IO_SUCCESS);
+
+    char payload[8][4];
+    ttak_net_msg_t msgs[8];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < 8; i++) {
+        memset(payload[i], '0' + i, sizeof(payload[i]));
+        msgs[i].buf = payload[i];
+        msgs[i].len = sizeof(payload[i]);
+    }
+    size_t sent = 0;
+    ASSERT(ttak_net_endpoint_send_batch(ep, owner, msgs, 8, 0, &sent, now) == TTAK_IO_SUCCESS);
+    ASSERT(sent == 8);
+
+    char buf[8];
+    for (int i = 0; i < 8; i++) {
+        ASSERT(recv(rx, buf, sizeof(buf), 0) == 4 && buf[0] == '0' + i);
+    }
+
+    size_t received = 1;
+    ASSERT(ttak_net_endpoint_recv_batch(ep, owner, msgs, 8, MSG_DONTWAIT, &received, now) == TTAK_IO_ERR_NEEDS_RETRY);
+    ASSERT(received == 0);
+
+    ttak_net_offload_t none = {0};
+    ASSERT(ttak_net_endpoint_set_offload(ep, owner, &none, now) == TTAK_IO_SUCCESS);
+
+    ttak_net_endpoint_destroy(ep, owner, now);
+    ttak_owner_destroy(owner);
+    close(rx);
+}
+
+int main(void) {
+    RUN_TEST(test_driver_batches);
+    RUN_TEST(test_endpoint_batches);
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <ttak/net/parse.h>
+#include <ttak/timing/timing.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static int token_is(const ttak_net_token_t *tok, const char *text) {
+    return tok->len == strlen(text) && memcmp(tok->data, text, tok->len) == 0;
+}
+
+/* Feeds @p text as its own segment, the way separately received buffers arrive. */
+static void feed_segment(ttak_net_parser_t *p, const char *text, uint64_t now) {
+    ttak_io_chain_t c;
+    ttak_io_chain_init(&c, NULL);
+    ASSERT(ttak_io_chain_append(&c, text, strlen(text), now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_net_parser_feed_chain(p, &c) == TTAK_IO_SUCCESS);
+    ttak_io_chain_destroy(&c);
+}
+
+static void test_scan_byte(void) {
+    uint8_t buf[160];
+    memset(buf, 'a', sizeof(buf));
+    ASSERT(ttak_net_scan_byte(buf, sizeof(buf), 'x') == NULL);
+    for (size_t at = 0; at < sizeof(buf); at++) {
+        buf[at] = 'x';
+        for (size_t from = 0; from <= at; from += 7) {
+            ASSERT(ttak_net_scan_byte(buf + from, sizeof(buf) - from, 'x') == buf + at);
+        }
+        ASSERT(ttak_net_scan_byte(buf, at, 'x') == NULL);
+        buf[at] = 'a';
+    }
+}
+
+static void test_length_prefixed(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_parser_t p;
+    ttak_net_parser_config_t cfg = { .kind = TTAK_NET_FRAME_LENGTH, .length_bytes = 2, .max_frame = 64 };
+    ASSERT(ttak_net_parser_init(&p, &cfg, NULL));
+
+    // Resumes across byte-at-a-time input.
+    const uint8_t wire[] = { 0x00, 0x05, 'h', 'e', 'l', 'l', 'o', 0x00, 0x00, 0x00, 0x02, 'o' };
+    ttak_net_frame_t f;
+    for (size_t i = 0; i < 6; i++) {
+        ASSERT(ttak_net_parser_feed(&p, wire + i, 1, now) == TTAK_IO_SUCCESS);
+        ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_NEED_MORE);
+    }
+    ASSERT(ttak_net_parser_feed(&p, wire + 6, sizeof(wire) - 6, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && token_is(&f.payload, "hello"));
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && f.payload.len == 0);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_NEED_MORE);
+    ASSERT(ttak_net_parser_feed(&p, "k", 1, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && token_is(&f.payload, "ok"));
+    ASSERT(p.frames == 3 && p.copied_bytes == 0);
+
+    // A prefix over max_frame is an error.
+    const uint8_t huge[] = { 0x01, 0x00 };
+    ASSERT(ttak_net_parser_feed(&p, huge, 2, now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_ERROR);
+    ttak_net_parser_destroy(&p);
+
+    ttak_net_parser_config_t le = { .kind = TTAK_NET_FRAME_LENGTH, .length_bytes = 4, .length_little_endian = true };
+    ASSERT(ttak_net_parser_init(&p, &le, NULL));
+    const uint8_t wire4[] = { 3, 0, 0, 0, 'a', 'b', 'c' };
+    ASSERT(ttak_net_parser_feed(&p, wire4, sizeof(wire4), now) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && token_is(&f.payload, "abc"));
+    ttak_net_parser_destroy(&p);
+
+    cfg.length_bytes = 3;
+    ASSERT(!ttak_net_parser_init(&p, &cfg, NULL));
+}
+
+static void test_delimited(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_parser_t p;
+    ttak_net_parser_config_t cfg = { .kind = TTAK_NET_FRAME_DELIMITER, .delim = (const uint8_t *)"\r\n",
+                                     .delim_len = 2, .max_frame = 32 };
+    ASSERT(ttak_net_parser_init(&p, &cfg, NULL));
+    ttak_net_frame_t f;
+
+    // A delimiter split across segments is still found; frames inside one segment are not copied.
+    feed_segment(&p, "abc\r", now);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_NEED_MORE);
+    feed_segment(&p, "\ndef\r\nx\ry", now);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && token_is(&f.payload, "abc"));
+    ASSERT(f.payload.data == p.in.segs[0].data);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && token_is(&f.payload, "def"));
+    ASSERT(p.copied_bytes == 0);
+
+    // A lone CR is data; a frame over two segments is joined in scratch space.
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_NEED_MORE);
+    feed_segment(&p, "z\r\n", now);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && token_is(&f.payload, "x\ryz"));
+    ASSERT(f.payload.data == p.scratch && p.copied_bytes == 4);
+
+    // No delimiter within max_frame is an error.
+    feed_segment(&p, "0123456789012345678901234567890123456789", now);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_ERROR);
+    ttak_net_parser_reset(&p);
+    feed_segment(&p, "ok\r\n", now);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && token_is(&f.payload, "ok"));
+    ttak_net_parser_destroy(&p);
+}
+
+static void test_http_request(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_parser_t p;
+    ttak_net_parser_config_t cfg = { .kind = TTAK_NET_FRAME_HTTP1 };
+    ASSERT(ttak_net_parser_init(&p, &cfg, NULL));
+
+    // The first part arrives through a zero-copy view.
+    int sv[2];
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    const char *head = "\r\nPOST /submit?x=1 HTTP/1.1\r\nHost: example\r\nContent-Le";
+    ASSERT(write(sv[1], head, strlen(head)) == (ssize_t)strlen(head));
+    ttak_net_view_t view;
+    ttak_net_view_init(&view);
+    ASSERT(ttak_io_zerocopy_recv_fd(sv[0], &view.region, 256, 0, now) == TTAK_IO_SUCCESS);
+    view.data = view.region.data;
+    view.len = view.region.len;
+    const uint8_t *rx = view.data;
+    ASSERT(ttak_net_parser_feed_view(&p, &view, now) == TTAK_IO_SUCCESS);
+    ASSERT(view.region.allocation.data == NULL);
+    close(sv[0]);
+    close(sv[1]);
+    feed_segment(&p, "ngth:  5 \r\nX-Empty:\r\n\r\nhelloGET / HTTP/1.0\n\n", now);
+
+    ttak_net_frame_t f;
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && f.http == TTAK_NET_HTTP_REQUEST_LINE);
+    ASSERT(token_is(&f.method, "POST") && token_is(&f.target, "/submit?x=1") && token_is(&f.version, "HTTP/1.1"));
+    ASSERT(f.method.data == rx + 2);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && f.http == TTAK_NET_HTTP_HEADER);
+    ASSERT(token_is(&f.name, "Host") && token_is(&f.value, "example"));
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && f.http == TTAK_NET_HTTP_HEADER);
+    ASSERT(token_is(&f.name, "Content-Length") && token_is(&f.value, "5"));
+    ASSERT(p.has_content_length && p.content_length == 5);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && token_is(&f.name, "X-Empty") && f.value.len == 0);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && f.http == TTAK_NET_HTTP_HEADERS_DONE);
+
+    ttak_net_token_t body;
+    ASSERT(ttak_net_parser_take(&p, (size_t)p.content_length, &body) == TTAK_NET_PARSE_FRAME);
+    ASSERT(token_is(&body, "hello"));
+
+    // The next message starts right after the body; bare LF line ends are accepted.
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && f.http == TTAK_NET_HTTP_REQUEST_LINE);
+    ASSERT(token_is(&f.method, "GET") && token_is(&f.target, "/") && token_is(&f.version, "HTTP/1.0"));
+    ASSERT(!p.has_content_length);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_FRAME && f.http == TTAK_NET_HTTP_HEADERS_DONE);
+    ASSERT(ttak_net_parser_next(&p, &f) == TTAK_NET_PARSE_NEED_MORE);
+    ASSERT(p.copied_bytes == strlen("Content-Length:  5 \r"));
+
+    // Malformed input.
+    const char *bad[] = {
+        "GET /\r\n",
+        "GET / FTP/1.1\r\n",
+        "GET / HTTP/1.1\r\n folded\r\n",
+        "GET / HTTP/1.1\r\nName : v\r\n",
+        "GET / HTTP/1.1\r\nContent-Length: 1x\r\n",
+        "GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        ttak_net_parser_reset(&p);
+        feed_segment(&p, bad[i], now);
+        ttak_net_parse_status_t st;
+        do {
+            st = ttak_net_parser_next(&p, &f);
+        } while (st == TTAK_NET_PARSE_FRAME);
+        ASSERT(st == TTAK_NET_PARSE_ERROR);
+    }
+    ttak_net_parser_destroy(&p);
+}
+
+int main(void) {
+    RUN_TEST(test_scan_byte);
+    RUN_TEST(test_length_prefixed);
+    RUN_TEST(test_delimited);
+    RUN_TEST(test_http_request);
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include <ttak/net/session.h>
+#include <ttak/net/endpoint.h>
+#include <ttak/mem/owner.h>
+#include <ttak/timing/timing.h>
+#include <arpa/inet.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static size_t roots(ttak_net_session_mgr_t *mgr, size_t *shards_used) {
+    size_t n = 0, used = 0;
+    for (uint32_t i = 0; i < TTAK_NET_SESSION_SHARDS; i++) {
+        size_t here = 0;
+        for (ttak_net_session_t *s = mgr->shards[i].head; s; s = s->next_sibling) here++;
+        used += here != 0;
+        n += here;
+    }
+    if (shards_used) *shards_used = used;
+    return n;
+}
+
+static void test_sessions_spread_over_shards(void) {
+    uint64_t now = TT_SECOND(100);
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_shared_net_endpoint_t *ep = ttak_net_endpoint_create(owner, now);
+    ASSERT(ep != NULL);
+
+    ttak_net_session_mgr_t mgr;
+    ttak_net_session_mgr_init(&mgr, false);
+
+    enum { N = 512 };
+    static ttak_net_session_t *s[N];
+    for (int i = 0; i < N; i++) {
+        s[i] = ttak_net_session_mgr_create(&mgr, ep, NULL, owner, now);
+        ASSERT(s[i] != NULL && s[i]->id == (uint64_t)i + 1);
+    }
+    size_t used = 0;
+    ASSERT(roots(&mgr, &used) == N);
+    ASSERT(used == TTAK_NET_SESSION_SHARDS);
+
+    // Closing every other session unlinks it from its own shard only.
+    for (int i = 0; i < N; i += 2) ttak_net_session_mgr_close(&mgr, s[i], now);
+    ASSERT(roots(&mgr, NULL) == N / 2);
+    // Sessions without an immortal endpoint never touch the wheel.
+    ASSERT(ttak_timer_wheel_pending(&mgr.wheel) == 0);
+
+    ttak_net_session_mgr_destroy(&mgr, now);
+    ttak_net_endpoint_destroy(ep, owner, now);
+    ttak_owner_destroy(owner);
+}
+
+static void test_child_lists(void) {
+    uint64_t now = TT_SECOND(100);
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_shared_net_endpoint_t *ep = ttak_net_endpoint_create(owner, now);
+    ASSERT(ep != NULL);
+
+    ttak_net_session_mgr_t mgr;
+    ttak_net_session_mgr_init(&mgr, false);
+    ttak_net_session_t *parent = ttak_net_session_mgr_create(&mgr, ep, NULL, owner, now);
+    ttak_net_session_t *a = ttak_net_session_mgr_create(&mgr, ep, parent, owner, now);
+    ttak_net_session_t *b = ttak_net_session_mgr_create(&mgr, ep, parent, owner, now);
+    ttak_net_session_t *c = ttak_net_session_mgr_create(&mgr, ep, b, owner, now);
+    ASSERT(parent && a && b && c);
+    ASSERT(parent->first_child == b && b->next_sibling == a && b->first_child == c);
+    ASSERT(roots(&mgr, NULL) == 1);
+
+    // Closing a child takes its subtree out of the parent's list.
+    ttak_epoch_enter();
+    ttak_net_session_mgr_close(&mgr, b, now);
+    ASSERT(parent->first_child == a && a->next_sibling == NULL);
+    ASSERT((b->state_flags & TTAK_NET_SESSION_ZOMBIE) && (c->state_flags & TTAK_NET_SESSION_ZOMBIE));
+    ttak_epoch_exit();
+
+    // A closed parent accepts no children.
+    ttak_epoch_enter();
+    ttak_net_session_mgr_close(&mgr, parent, now);
+    ASSERT(a->state_flags & TTAK_NET_SESSION_ZOMBIE);
+    ASSERT(ttak_net_session_mgr_create(&mgr, ep, parent, owner, now) == NULL);
+    ttak_epoch_exit();
+    ASSERT(roots(&mgr, NULL) == 0);
+
+    ttak_net_session_mgr_destroy(&mgr, now);
+    ttak_net_endpoint_destroy(ep, owner, now);
+    ttak_owner_destroy(owner);
+}
+
+static ttak_shared_net_endpoint_t *immortal_udp(ttak_owner_t *owner, uint64_t now) {
+    ttak_shared_net_endpoint_t *ep = ttak_net_endpoint_create(owner, now);
+    ASSERT(ep != NULL);
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT(fd >= 0);
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    ASSERT(bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    ASSERT(ttak_net_endpoint_bind_fd(ep, owner, fd, AF_INET, SOCK_DGRAM, 0, &addr, (uint8_t)sizeof(addr),
+                                     TTAK_NET_ENDPOINT_IPV4, UINT64_MAX, now) == TTAK_IO_SUCCESS);
+    return ep;
+}
+
+static void test_tick_fires_due_checks(void) {
+    uint64_t now = TT_SECOND(100);
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_shared_net_endpoint_t *healthy = immortal_udp(owner, now);
+    ttak_shared_net_endpoint_t *failing = immortal_udp(owner, now);
+    ttak_shared_net_endpoint_t *plain = ttak_net_endpoint_create(owner, now);
+    ASSERT(plain != NULL);
+
+    ttak_net_session_mgr_t mgr;
+    ttak_net_session_mgr_init(&mgr, false);
+    ttak_net_session_t *h = ttak_net_session_mgr_create(&mgr, healthy, NULL, owner, now);
+    ttak_net_session_t *f = ttak_net_session_mgr_create(&mgr, failing, NULL, owner, now);
+    ASSERT(ttak_net_session_mgr_create(&mgr, plain, NULL, owner, now) != NULL);
+    ASSERT(h && f && (h->state_flags & TTAK_NET_SESSION_IMMORTAL));
+    ASSERT(ttak_timer_wheel_pending(&mgr.wheel) == 2);
+    uint64_t first = h->next_sanity_ns;
+    ASSERT(first == now + TT_SECOND(5));
+
+    // Nothing is due yet.
+    ttak_net_session_mgr_tick(&mgr, now + TT_SECOND(1));
+    ASSERT(h->next_sanity_ns == first && ttak_timer_wheel_pending(&mgr.wheel) == 2);
+
+    // Once due, a healthy socket is re-armed and a dead one shut down.
+    ASSERT(ttak_net_endpoint_close(failing, owner, now) == TTAK_IO_SUCCESS);
+    ttak_epoch_enter();
+    ttak_net_session_mgr_tick(&mgr, first);
+    ASSERT(h->next_sanity_ns == first + TT_SECOND(5));
+    ASSERT(f->state_flags & TTAK_NET_SESSION_ZOMBIE);
+    ttak_epoch_exit();
+    ASSERT(ttak_timer_wheel_pending(&mgr.wheel) == 1);
+    ASSERT(roots(&mgr, NULL) == 2);
+
+    // Closing the last immortal session disarms its check.
+    ttak_net_session_mgr_close(&mgr, h, now);
+    ASSERT(ttak_timer_wheel_pending(&mgr.wheel) == 0);
+
+    ttak_net_session_mgr_destroy(&mgr, now);
+    ttak_net_endpoint_destroy(healthy, owner, now);
+    ttak_net_endpoint_destroy(failing, owner, now);
+    ttak_net_endpoint_destroy(plain, owner, now);
+    ttak_owner_destroy(owner);
+}
+
+static void test_affinity_follows_endpoint(void) {
+    uint64_t now = TT_SECOND(100);
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_shared_net_endpoint_t *x = ttak_net_endpoint_create(owner, now);
+    ttak_shared_net_endpoint_t *y = ttak_net_endpoint_create(owner, now);
+    ASSERT(x && y);
+
+    ttak_net_session_mgr_t mgr;
+    ttak_net_session_mgr_init(&mgr, false);
+    ttak_net_session_t *a = ttak_net_session_mgr_create(&mgr, x, NULL, owner, now);
+    ttak_net_session_t *b = ttak_net_session_mgr_create(&mgr, x, a, owner, now);
+    ttak_net_session_t *c = ttak_net_session_mgr_create(&mgr, y, NULL, owner, now);
+    ASSERT(a && b && c);
+
+    // Sessions over one endpoint share its guard's task hash, and so its pool shard.
+    ttak_shared_result_t res = 0;
+    ttak_net_endpoint_t *payload = ttak_shared_net_endpoint_access(x, owner, &res);
+    ASSERT(payload != NULL);
+    ASSERT(a->affinity != 0 && a->affinity == ttak_io_guard_affinity(&payload->guard));
+    ttak_shared_net_endpoint_release(x);
+    ASSERT(b->affinity == a->affinity && c->affinity != a->affinity);
+
+    ttak_net_session_mgr_destroy(&mgr, now);
+    ttak_net_endpoint_destroy(x, owner, now);
+    ttak_net_endpoint_destroy(y, owner, now);
+    ttak_owner_destroy(owner);
+}
+
+int main(void) {
+    RUN_TEST(test_sessions_spread_over_shards);
+    RUN_TEST(test_child_lists);
+    RUN_TEST(test_tick_fires_due_checks);
+    RUN_TEST(test_affinity_follows_endpoint);
+    return 0;
+}
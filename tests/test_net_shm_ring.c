@@ -0,0 +1,188 @@
+#include <ttak/net/shm_ring.h>
+#include <ttak/timing/timing.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static void fill(uint8_t *buf, uint32_t len, uint32_t seed) {
+    for (uint32_t i = 0; i < len; i++) buf[i] = (uint8_t)(seed * 31U + i);
+}
+
+static void test_shm_ring_roundtrip_and_wrap(void) {
+    ttak_net_shm_ring_t *ring = ttak_net_shm_ring_create(NULL, 4096, TTAK_NET_SHM_RING_SPSC);
+    ASSERT(ring != NULL);
+    ASSERT(ttak_net_shm_ring_max_record(ring) == 2048 - sizeof(ttak_net_shm_record_t));
+    ASSERT(!ttak_net_shm_ring_send(ring, "x", ttak_net_shm_ring_max_record(ring) + 1, 0, 0));
+
+    // Odd sizes walk the records across the end of the ring many times.
+    uint8_t in[2048], out[2048];
+    for (uint32_t i = 0; i < 500; i++) {
+        uint32_t len = (i * 97U) % 1500U;
+        fill(in, len, i);
+        ASSERT(ttak_net_shm_ring_send(ring, in, len, i, 0));
+        uint32_t got = 0;
+        uint64_t ts = 0;
+        ASSERT(ttak_net_shm_ring_recv(ring, out, sizeof(out), &got, &ts, 0));
+        ASSERT(got == len && ts == i && memcmp(in, out, len) == 0);
+    }
+
+    // A full ring refuses without waiting; an empty one reports length 0.
+    uint32_t sent = 0;
+    while (ttak_net_shm_ring_send(ring, in, 1000, 0, 0)) sent++;
+    ASSERT(sent >= 3);
+    ttak_net_shm_ring_stats_t st;
+    ttak_net_shm_ring_stats(ring, &st);
+    ASSERT(st.full >= 1 && st.sent == 500 + sent);
+
+    // A short buffer leaves the record queued and reports its length.
+    uint32_t got = 0;
+    ASSERT(!ttak_net_shm_ring_recv(ring, out, 10, &got, NULL, 0));
+    ASSERT(got == 1000);
+    for (uint32_t i = 0; i < sent; i++) ASSERT(ttak_net_shm_ring_recv(ring, out, sizeof(out), &got, NULL, 0));
+    ASSERT(!ttak_net_shm_ring_recv(ring, out, sizeof(out), &got, NULL, 1000000));
+    ASSERT(got == 0);
+    ttak_net_shm_ring_close(ring);
+}
+
+static void test_shm_ring_named_open(void) {
+    char name[64];
+    snprintf(name, sizeof(name), "/ttak-test-ring-%ld", (long)getpid());
+    ttak_net_shm_ring_unlink(name);
+    ttak_net_shm_ring_t *a = ttak_net_shm_ring_create(name, 8192, TTAK_NET_SHM_RING_SPSC);
+    ASSERT(a != NULL);
+    ASSERT(ttak_net_shm_ring_create(name, 8192, TTAK_NET_SHM_RING_SPSC) == NULL && errno == EEXIST);
+    ttak_net_shm_ring_t *b = ttak_net_shm_ring_open(name);
+    ASSERT(b != NULL);
+    ASSERT(ttak_net_shm_ring_unlink(name) == 0);
+    ASSERT(ttak_net_shm_ring_open(name) == NULL);
+
+    // The two handles map the object at different addresses.
+    ASSERT(ttak_net_shm_ring_send(a, "hello", 5, 7, 0));
+    char out[16];
+    uint32_t got = 0;
+    ASSERT(ttak_net_shm_ring_recv(b, out, sizeof(out), &got, NULL, 0));
+    ASSERT(got == 5 && memcmp(out, "hello", 5) == 0);
+    ttak_net_shm_ring_close(b);
+    ttak_net_shm_ring_close(a);
+}
+
+#define PRODUCERS 2
+#define PER_PRODUCER 3000
+
+typedef struct {
+    ttak_net_shm_ring_t *ring;
+    _Atomic uint32_t *remaining;
+    uint64_t sum;
+    uint32_t count;
+    int bad;
+} consumer_arg_t;
+
+static void *consumer_main(void *p) {
+    consumer_arg_t *arg = p;
+    uint8_t buf[512];
+    while (atomic_load(arg->remaining) > 0) {
+        uint32_t len = 0;
+        if (!ttak_net_shm_ring_recv(arg->ring, buf, sizeof(buf), &len, NULL, 20000000ULL)) continue;
+        atomic_fetch_sub(arg->remaining, 1);
+        uint32_t v;
+        memcpy(&v, buf, sizeof(v));
+        for (uint32_t i = sizeof(v); i < len; i++) {
+            if (buf[i] != (uint8_t)v) arg->bad++;
+        }
+        arg->sum += v;
+        arg->count++;
+    }
+    return NULL;
+}
+
+static void test_shm_ring_mpmc_across_processes(void) {
+    ttak_net_shm_ring_t *ring = ttak_net_shm_ring_create(NULL, 16384, TTAK_NET_SHM_RING_MPMC);
+    ASSERT(ring != NULL);
+
+    pid_t kids[PRODUCERS];
+    for (int p = 0; p < PRODUCERS; p++) {
+        kids[p] = fork();
+        ASSERT(kids[p] >= 0);
+        if (kids[p] == 0) {
+            // A fresh handle on the inherited descriptor, as a sidecar would hold.
+            ttak_net_shm_ring_t *mine = ttak_net_shm_ring_open_fd(ttak_net_shm_ring_fd(ring));
+            if (!mine) _exit(2);
+            uint8_t buf[512];
+            for (uint32_t i = 0; i < PER_PRODUCER; i++) {
+                uint32_t v = (uint32_t)p * PER_PRODUCER + i;
+                uint32_t len = sizeof(v) + (v * 13U) % 300U;
+                memcpy(buf, &v, sizeof(v));
+                memset(buf + sizeof(v), (uint8_t)v, len - sizeof(v));
+                if (!ttak_net_shm_ring_send(mine, buf, len, 0, TTAK_WAIT_FOREVER)) _exit(3);
+            }
+            ttak_net_shm_ring_close(mine);
+            _exit(0);
+        }
+    }
+
+    _Atomic uint32_t remaining = PRODUCERS * PER_PRODUCER;
+    consumer_arg_t args[2] = { { ring, &remaining, 0, 0, 0 }, { ring, &remaining, 0, 0, 0 } };
+    pthread_t th[2];
+    for (int i = 0; i < 2; i++) ASSERT(pthread_create(&th[i], NULL, consumer_main, &args[i]) == 0);
+    for (int i = 0; i < 2; i++) pthread_join(th[i], NULL);
+    for (int p = 0; p < PRODUCERS; p++) {
+        int status = 0;
+        ASSERT(waitpid(kids[p], &status, 0) == kids[p]);
+        ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    uint64_t n = (uint64_t)PRODUCERS * PER_PRODUCER;
+    ASSERT(args[0].count + args[1].count == n);
+    ASSERT(args[0].sum + args[1].sum == n * (n - 1) / 2);
+    ASSERT(args[0].bad == 0 && args[1].bad == 0);
+    ttak_net_shm_ring_close(ring);
+}
+
+static void test_shm_ring_to_lattice(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_shm_ring_t *ring = ttak_net_shm_ring_create(NULL, 8192, TTAK_NET_SHM_RING_SPSC);
+    ttak_net_lattice_t *lat = ttak_net_lattice_create_sized(4, 256, now);
+    uint8_t *out = malloc(TTAK_LATTICE_MAX_SLOT_SIZE);
+    ASSERT(ring != NULL && lat != NULL && out != NULL);
+
+    uint8_t in[1024];
+    for (uint32_t i = 0; i < 5; i++) {
+        fill(in, 100 + i, i);
+        ASSERT(ttak_net_shm_ring_send(ring, in, 100 + i, now, 0));
+    }
+    fill(in, 1000, 99);
+    ASSERT(ttak_net_shm_ring_send(ring, in, 1000, now, 0));
+    ASSERT(ttak_net_shm_ring_send(ring, in, 10, now, 0));
+
+    // The oversized record stops the sweep and stays queued with the one behind it.
+    ASSERT(ttak_net_shm_ring_to_lattice(ring, lat, 0, 64, now) == 5);
+    uint32_t got = 0;
+    ASSERT(ttak_net_shm_ring_recv(ring, out, TTAK_LATTICE_MAX_SLOT_SIZE, &got, NULL, 0));
+    ASSERT(got == 1000 && memcmp(in, out, got) == 0);
+    ASSERT(ttak_net_shm_ring_to_lattice(ring, lat, 0, 64, now) == 1);
+
+    ttak_net_lattice_msg_t msgs[8];
+    size_t seen = ttak_net_lattice_read_batch(lat, 0, msgs, 8, now);
+    ASSERT(seen == 6);
+    for (size_t i = 0; i < seen; i++) ASSERT((msgs[i].len >= 100 && msgs[i].len < 105) || msgs[i].len == 10);
+    ttak_net_lattice_release_batch(msgs, seen);
+    ttak_net_shm_ring_stats_t st;
+    ttak_net_shm_ring_stats(ring, &st);
+    ASSERT(st.received == 7 && st.dropped == 0);
+    free(out);
+    ttak_net_lattice_destroy(lat, now);
+    ttak_net_shm_ring_close(ring);
+}
+
+int main(void) {
+    RUN_TEST(test_shm_ring_roundtrip_and_wrap);
+    RUN_TEST(test_shm_ring_named_open);
+    RUN_TEST(test_shm_ring_mpmc_across_processes);
+    RUN_TEST(test_shm_ring_to_lattice);
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include <ttak/net/tls.h>
+#include <ttak/mem/owner.h>
+#include <ttak/timing/timing.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static const uint8_t tls_key[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+};
+static const uint8_t tls_iv[12] = { 0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88 };
+
+static void hex(const char *s, uint8_t *out) {
+    for (size_t i = 0; s[2 * i]; i++) {
+        unsigned v;
+        sscanf(s + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+}
+
+/* Connected TCP pair over loopback; the sender side goes into an endpoint. */
+static void tcp_pair(int *client, int *server) {
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT(lfd >= 0);
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT(bind(lfd, (struct sockaddr *)&sa, sizeof(sa)) == 0);
+    ASSERT(listen(lfd, 1) == 0);
+    socklen_t len = sizeof(sa);
+    ASSERT(getsockname(lfd, (struct sockaddr *)&sa, &len) == 0);
+    *client = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT(*client >= 0);
+    ASSERT(connect(*client, (struct sockaddr *)&sa, sizeof(sa)) == 0);
+    *server = accept(lfd, NULL, NULL);
+    ASSERT(*server >= 0);
+    close(lfd);
+}
+
+static ttak_shared_net_endpoint_t *wrap(int fd, ttak_owner_t *owner, uint64_t now) {
+    ttak_shared_net_endpoint_t *ep = ttak_net_endpoint_create(owner, now);
+    ASSERT(ep != NULL);
+    ASSERT(ttak_net_endpoint_bind_fd(ep, owner, fd, AF_INET, SOCK_STREAM, 0, NULL, 0,
+                                     TTAK_NET_ENDPOINT_IPV4, TT_SECOND(30), now) == TTAK_IO_SUCCESS);
+    return ep;
+}
+
+static void read_exact(int fd, uint8_t *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = read(fd, buf + got, len - got);
+        ASSERT(n > 0);
+        got += (size_t)n;
+    }
+}
+
+static void test_aes256_key_schedule(void) {
+    // GCM test cases 13 and 14 (McGrew & Viega): zero key, zero IV.
+    uint8_t key[32] = { 0 };
+    uint8_t tag[16], out[16], in[16] = { 0 }, want[16];
+    ttak_crypto_ctx_t ctx = { .key = key, .key_len = 32, .iv_len = 12, .tag = tag, .tag_len = 16 };
+    ASSERT(ttak_aes256_expand_key(&ctx) == TTAK_IO_SUCCESS);
+    ASSERT(ctx.hw_state.aes.rounds == 14);
+
+    ASSERT(ttak_aes256_gcm_execute(&ctx, in, out, 0) == TTAK_IO_SUCCESS);
+    hex("530f8afbc74536b9a963b4f1c4cb738b", want);
+    ASSERT(memcmp(tag, want, 16) == 0);
+
+    ASSERT(ttak_aes256_gcm_execute(&ctx, in, out, sizeof(in)) == TTAK_IO_SUCCESS);
+    hex("cea7403d4d606b6e074ec5d3baf39d18", want);
+    ASSERT(memcmp(out, want, 16) == 0);
+    hex("d0d1c8a799996bf0265b98b5d48ab919", want);
+    ASSERT(memcmp(tag, want, 16) == 0);
+
+    ctx.key_len = 16;
+    ASSERT(ttak_aes256_expand_key(&ctx) == TTAK_IO_ERR_INVALID_ARGUMENT);
+}
+
+static void test_user_seal(void) {
+    uint64_t now = ttak_get_tick_count_ns();
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    int client, server;
+    tcp_pair(&client, &server);
+    ttak_shared_net_endpoint_t *ep = wrap(client, owner, now);
+
+    ttak_crypto_ctx_t tx = { .key = tls_key, .key_len = 32, .iv_len = 12 };
+    memcpy(tx.iv, tls_iv, 12);
+    ttak_net_tls_params_t params = {
+        .version = TTAK_NET_TLS_1_2, .cipher = TTAK_NET_TLS_AES_256_GCM, .tx = &tx, .tx_seq = 5, .force_user = true,
+    };
+    ttak_net_tls_t tls;
+    ASSERT(ttak_net_tls_enable(&tls, ep, owner, &params, now) == TTAK_IO_SUCCESS);
+    ASSERT(tls.tx_mode == TTAK_NET_TLS_MODE_USER && tls.rx_mode == TTAK_NET_TLS_MODE_NONE);
+
+    // Two records: a full one and the rest.
+    size_t total = TTAK_NET_TLS_MAX_PLAINTEXT + 100;
+    uint8_t *msg = malloc(total);
+    ASSERT(msg != NULL);
+    for (size_t i = 0; i < total; i++) msg[i] = (uint8_t)(i * 7);
+    size_t sent = 0;
+    ASSERT(ttak_net_tls_send(&tls, ep, owner, msg, total, 0, &sent, now) == TTAK_IO_SUCCESS);
+    ASSERT(sent == total && tls.records == 2 && tls.tx_seq == 7);
+
+    uint8_t *rec = malloc(TTAK_NET_TLS_MAX_PLAINTEXT + TTAK_NET_TLS_MAX_OVERHEAD);
+    ASSERT(rec != NULL);
+    size_t off = 0;
+    for (uint64_t seq = 5; seq < 7; seq++) {
+        size_t plen = seq == 5 ? TTAK_NET_TLS_MAX_PLAINTEXT : 100;
+        read_exact(server, rec, 5 + 8);
+        ASSERT(rec[0] == TTAK_NET_TLS_APPLICATION_DATA && rec[1] == 3 && rec[2] == 3);
+        ASSERT((size_t)((rec[3] << 8) | rec[4]) == 8 + plen + 16);
+        read_exact(server, rec + 13, plen + 16);
+
+        // Explicit nonce: the IV's last 8 bytes, counting up from the first record.
+        uint8_t nonce[12];
+        memcpy(nonce, tls_iv, 12);
+        nonce[11] = (uint8_t)(nonce[11] + (seq - 5));
+        ASSERT(memcmp(rec + 5, nonce + 4, 8) == 0);
+
+        // Recompute the record the way RFC 5288 describes it.
+        uint8_t aad[13] = { 0, 0, 0, 0, 0, 0, 0, (uint8_t)seq, 23, 3, 3, (uint8_t)(plen >> 8), (uint8_t)plen };
+        uint8_t tag[16];
+        uint8_t *ct = malloc(plen);
+        ASSERT(ct != NULL);
+        ttak_crypto_ctx_t ref = { .key = tls_key, .key_len = 32, .iv_len = 12, .aad = aad, .aad_len = 13,
+                                  .tag = tag, .tag_len = 16 };
+        memcpy(ref.iv, nonce, 12);
+        ASSERT(ttak_aes256_expand_key(&ref) == TTAK_IO_SUCCESS);
+        ASSERT(ttak_aes256_gcm_execute(&ref, msg + off, ct, plen) == TTAK_IO_SUCCESS);
+        ASSERT(memcmp(rec + 13, ct, plen) == 0);
+        ASSERT(memcmp(rec + 13 + plen, tag, 16) == 0);
+        free(ct);
+        off += plen;
+    }
+
+    // Sealing directly refuses a buffer too small for the record.
+    size_t out_len = 0;
+    ASSERT(ttak_net_tls_seal(&tls, 23, msg, 10, rec, 10 + 5 + 8 + 15, &out_len) == TTAK_IO_ERR_RANGE);
+    ASSERT(tls.tx_seq == 7);
+
+    ttak_net_tls_destroy(&tls);
+    free(rec);
+    free(msg);
+    close(server);
+    ttak_net_endpoint_destroy(ep, owner, now);
+    ttak_owner_destroy(owner);
+}
+
+static void test_user_sendfile(void) {
+    uint64_t now = ttak_get_tick_count_ns();
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    int client, server;
+    tcp_pair(&client, &server);
+    ttak_shared_net_endpoint_t *ep = wrap(client, owner, now);
+
+    char path[] = "/tmp/ttak_tls_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    unlink(path);
+    ASSERT(write(fd, "0123456789abcdef", 16) == 16);
+
+    ttak_crypto_ctx_t tx = { .key = tls_key, .key_len = 32, .iv_len = 12 };
+    memcpy(tx.iv, tls_iv, 12);
+    ttak_net_tls_params_t params = {
+        .version = TTAK_NET_TLS_1_3, .cipher = TTAK_NET_TLS_CHACHA20_POLY1305, .tx = &tx, .force_user = true,
+    };
+    ttak_net_tls_t tls;
+    ASSERT(ttak_net_tls_enable(&tls, ep, owner, &params, now) == TTAK_IO_SUCCESS);
+    uint64_t offset = 4;
+    size_t sent = 0;
+    ASSERT(ttak_net_tls_sendfile(&tls, ep, owner, fd, &offset, 100, &sent, now) == TTAK_IO_SUCCESS);
+    ASSERT(sent == 12 && offset == 16 && tls.records == 1);
+
+    // TLS 1.3: outer type is application data, the inner type trails the text.
+    uint8_t rec[5 + 13 + 16];
+    read_exact(server, rec, sizeof(rec));
+    ASSERT(rec[0] == 23 && rec[3] == 0 && rec[4] == 13 + 16);
+    uint8_t inner[13], tag[16];
+    memcpy(inner, "456789abcdef", 12);
+    inner[12] = 23;
+    ttak_crypto_ctx_t ref = { .key = tls_key, .key_len = 32, .iv_len = 12, .aad = rec, .aad_len = 5,
+                              .tag = tag, .tag_len = 16 };
+    memcpy(ref.iv, tls_iv, 12);
+    uint8_t ct[13];
+    ASSERT(ttak_chacha20_poly1305_execute(&ref, inner, ct, sizeof(inner)) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(rec + 5, ct, 13) == 0 && memcmp(rec + 18, tag, 16) == 0);
+
+    ttak_net_tls_destroy(&tls);
+    close(fd);
+    close(server);
+    ttak_net_endpoint_destroy(ep, owner, now);
+    ttak_owner_destroy(owner);
+}
+
+static void test_kernel_matches_user(void) {
+    uint64_t now = ttak_get_tick_count_ns();
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    int client, server, uclient, userver;
+    tcp_pair(&client, &server);
+    tcp_pair(&uclient, &userver);
+    ttak_shared_net_endpoint_t *ep = wrap(client, owner, now);
+    ttak_shared_net_endpoint_t *uep = wrap(uclient, owner, now);
+
+    ttak_crypto_ctx_t tx = { .key = tls_key, .key_len = 32, .iv_len = 12 };
+    memcpy(tx.iv, tls_iv, 12);
+    ttak_net_tls_params_t params = {
+        .version = TTAK_NET_TLS_1_3, .cipher = TTAK_NET_TLS_AES_256_GCM, .tx = &tx, .tx_seq = 3,
+    };
+    ttak_net_tls_t ktls, utls;
+    ASSERT(ttak_net_tls_enable(&ktls, ep, owner, &params, now) == TTAK_IO_SUCCESS);
+    params.force_user = true;
+    ASSERT(ttak_net_tls_enable(&utls, uep, owner, &params, now) == TTAK_IO_SUCCESS);
+    ASSERT(utls.tx_mode == TTAK_NET_TLS_MODE_USER);
+
+    // Whichever side protects the records, the bytes on the wire are the same.
+    static const char msg[] = "kernel or not, same record";
+    size_t sent = 0;
+    ASSERT(ttak_net_tls_send(&ktls, ep, owner, msg, sizeof(msg), 0, &sent, now) == TTAK_IO_SUCCESS);
+    ASSERT(sent == sizeof(msg));
+    ASSERT(ttak_net_tls_send(&utls, uep, owner, msg, sizeof(msg), 0, &sent, now) == TTAK_IO_SUCCESS);
+    ASSERT(sent == sizeof(msg));
+    uint8_t a[5 + sizeof(msg) + 1 + 16], b[sizeof(a)];
+    read_exact(server, a, sizeof(a));
+    read_exact(userver, b, sizeof(b));
+    ASSERT(memcmp(a, b, sizeof(a)) == 0);
+    if (ktls.tx_mode != TTAK_NET_TLS_MODE_KERNEL) printf("  kernel TLS unavailable, compared userspace only\n");
+
+    ttak_net_tls_destroy(&ktls);
+    ttak_net_tls_destroy(&utls);
+    close(server);
+    close(userver);
+    ttak_net_endpoint_destroy(ep, owner, now);
+    ttak_net_endpoint_destroy(uep, owner, now);
+    ttak_owner_destroy(owner);
+}
+
+static void test_rejects_bad_keys(void) {
+    uint64_t now = ttak_get_tick_count_ns();
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+    ttak_shared_net_endpoint_t *ep = ttak_net_endpoint_create(owner, now);
+    ASSERT(ep != NULL);
+    ttak_crypto_ctx_t tx = { .key = tls_key, .key_len = 16, .iv_len = 12 };
+    ttak_net_tls_params_t params = { .tx = &tx };
+    ttak_net_tls_t tls;
+    ASSERT(ttak_net_tls_enable(&tls, ep, owner, &params, now) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    params.tx = NULL;
+    ASSERT(ttak_net_tls_enable(&tls, ep, owner, &params, now) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ttak_net_endpoint_destroy(ep, owner, now);
+    ttak_owner_destroy(owner);
+}
+
+int main(void) {
+    RUN_TEST(test_aes256_key_schedule);
+    RUN_TEST(test_user_seal);
+    RUN_TEST(test_user_sendfile);
+    RUN_TEST(test_kernel_matches_user);
+    RUN_TEST(test_rejects_bad_keys);
+    return 0;
+}
@@ -0,0 +1,215 @@
+#include <ttak/net/workq.h>
+#include <ttak/mem/owner.h>
+#include <ttak/timing/timing.h>
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static ttak_shared_net_endpoint_t *udp_endpoint(ttak_owner_t *owner, struct sockaddr_in *addr) {
+    uint64_t now = ttak_get_tick_count();
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT(fd >= 0);
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT(bind(fd, (struct sockaddr *)addr, sizeof(*addr)) == 0);
+    socklen_t len = sizeof(*addr);
+    ASSERT(getsockname(fd, (struct sockaddr *)addr, &len) == 0);
+    ttak_shared_net_endpoint_t *ep = ttak_net_endpoint_create(owner, now);
+    ASSERT(ep != NULL);
+    ASSERT(ttak_net_endpoint_bind_fd(ep, owner, fd, AF_INET, SOCK_DGRAM, 0, addr, (uint8_t)sizeof(*addr),
+                                     TTAK_NET_ENDPOINT_IPV4, TT_HOUR(1), now) == TTAK_IO_SUCCESS);
+    return ep;
+}
+
+typedef struct {
+    uint8_t *seen;
+    uint64_t records;
+    uint64_t dups;
+    int refuse;
+} sink_state_t;
+
+static bool collect(const ttak_net_workq_result_t *res, size_t n, void *arg) {
+    sink_state_t *s = arg;
+    if (s->refuse > 0) {
+        s->refuse--;
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint64_t seed;
+        ASSERT(res[i].len == sizeof(seed));
+        memcpy(&seed, res[i].data, sizeof(seed));
+        if (s->seen[seed]) s->dups++;
+        s->seen[seed] = 1;
+        s->records++;
+    }
+    return true;
+}
+
+typedef struct {
+    ttak_net_workq_coord_t *coord;
+    ttak_net_workq_worker_t *worker;
+    _Atomic bool stop;
+} loop_t;
+
+static void *coord_main(void *p) {
+    loop_t *l = p;
+    while (!atomic_load(&l->stop)) ttak_net_workq_coord_poll(l->coord, 5, ttak_get_tick_count());
+    return NULL;
+}
+
+static void *poll_main(void *p) {
+    loop_t *l = p;
+    while (!atomic_load(&l->stop)) ttak_net_workq_worker_poll(l->worker, 5, ttak_get_tick_count());
+    return NULL;
+}
+
+/* Reports every seed of every lease until the coordinator runs dry. */
+static void *compute_main(void *p) {
+    ttak_net_workq_worker_t *w = p;
+    ttak_net_workq_lease_t lease;
+    for (;;) {
+        ttak_net_workq_status_t st = ttak_net_workq_worker_acquire(w, &lease, 10000000000ULL);
+        if (st == TTAK_NET_WORKQ_FINISHED) break;
+        ASSERT(st == TTAK_NET_WORKQ_OK);
+        for (uint64_t s = lease.start; s < lease.start + lease.count; s++) {
+            ASSERT(ttak_net_workq_worker_submit(w, lease.id, &s, sizeof(s), TTAK_WAIT_FOREVER) == TTAK_NET_WORKQ_OK);
+        }
+        ASSERT(ttak_net_workq_worker_complete(w, lease.id, TTAK_WAIT_FOREVER) == TTAK_NET_WORKQ_OK);
+    }
+    return NULL;
+}
+
+#define SEEDS 20000
+
+static void test_workq_spreads_range_once(void) {
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    struct sockaddr_in caddr, waddr;
+    ttak_shared_net_endpoint_t *cep = udp_endpoint(owner, &caddr);
+
+    sink_state_t sink = { calloc(SEEDS, 1), 0, 0, 3 };
+    ttak_net_workq_coord_config_t cc = { .first_seed = 0, .end_seed = SEEDS, .lease_seeds = 1000,
+                                         .busy_backoff_ms = 20, .sink = collect, .sink_arg = &sink };
+    loop_t cl = { .coord = ttak_net_workq_coord_create(&cc, cep, owner) };
+    ASSERT(cl.coord != NULL);
+    ASSERT(ttak_net_workq_coord_create(&(ttak_net_workq_coord_config_t){ .end_seed = 1 }, cep, owner) == NULL);
+
+    // A small result buffer makes submit block on the upload.
+    ttak_net_workq_worker_config_t wc = { .leases = 2, .rto_ms = 20, .max_pending_bytes = 2048 };
+    ttak_shared_net_endpoint_t *wep[2];
+    loop_t wl[2];
+    pthread_t ct, pt[2], wt[2];
+    ASSERT(pthread_create(&ct, NULL, coord_main, &cl) == 0);
+    for (int i = 0; i < 2; i++) {
+        wep[i] = udp_endpoint(owner, &waddr);
+        memset(&wl[i], 0, sizeof(wl[i]));
+        wl[i].worker = ttak_net_workq_worker_create(&wc, wep[i], owner, &caddr, sizeof(caddr));
+        ASSERT(wl[i].worker != NULL);
+        ASSERT(pthread_create(&pt[i], NULL, poll_main, &wl[i]) == 0);
+        ASSERT(pthread_create(&wt[i], NULL, compute_main, wl[i].worker) == 0);
+    }
+    ASSERT(ttak_net_workq_worker_id(wl[0].worker) != ttak_net_workq_worker_id(wl[1].worker));
+
+    for (int i = 0; i < 2; i++) pthread_join(wt[i], NULL);
+    for (int i = 0; i < 2; i++) {
+        ASSERT(ttak_net_workq_worker_finished(wl[i].worker));
+        atomic_store(&wl[i].stop, true);
+        pthread_join(pt[i], NULL);
+    }
+    atomic_store(&cl.stop, true);
+    pthread_join(ct, NULL);
+
+    ASSERT(ttak_net_workq_coord_finished(cl.coord));
+    ASSERT(sink.records == SEEDS && sink.dups == 0);
+    ttak_net_workq_coord_stats_t cs;
+    ttak_net_workq_coord_stats(cl.coord, &cs);
+    ASSERT(cs.workers == 2 && cs.granted == SEEDS / 1000 && cs.completed == SEEDS / 1000);
+    ASSERT(cs.reassigned == 0 && cs.results == SEEDS && cs.refused >= 3);
+    ttak_net_workq_worker_stats_t ws[2];
+    ttak_net_workq_worker_stats(wl[0].worker, &ws[0]);
+    ttak_net_workq_worker_stats(wl[1].worker, &ws[1]);
+    ASSERT(ws[0].records + ws[1].records == SEEDS);
+    ASSERT(ws[0].refused + ws[1].refused >= 1);
+
+    for (int i = 0; i < 2; i++) {
+        ttak_net_workq_worker_destroy(wl[i].worker);
+        ttak_net_endpoint_destroy(wep[i], owner, ttak_get_tick_count());
+    }
+    ttak_net_workq_coord_destroy(cl.coord);
+    ttak_net_endpoint_destroy(cep, owner, ttak_get_tick_count());
+    ttak_owner_destroy(owner);
+    free(sink.seen);
+}
+
+static void test_workq_reassigns_dead_worker_leases(void) {
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    struct sockaddr_in caddr, waddr;
+    ttak_shared_net_endpoint_t *cep = udp_endpoint(owner, &caddr);
+
+    sink_state_t sink = { calloc(4000, 1), 0, 0, 0 };
+    ttak_net_workq_coord_config_t cc = { .first_seed = 0, .end_seed = 4000, .lease_seeds = 500,
+                                         .lease_ttl_ms = 200, .sink = collect, .sink_arg = &sink };
+    loop_t cl = { .coord = ttak_net_workq_coord_create(&cc, cep, owner) };
+    ASSERT(cl.coord != NULL);
+    pthread_t ct;
+    ASSERT(pthread_create(&ct, NULL, coord_main, &cl) == 0);
+
+    // The first worker takes a lease, reports part of it and dies.
+    ttak_net_workq_worker_config_t wc = { .leases = 2, .heartbeat_ms = 50, .rto_ms = 20 };
+    ttak_shared_net_endpoint_t *dep = udp_endpoint(owner, &waddr);
+    loop_t dead = { .worker = ttak_net_workq_worker_create(&wc, dep, owner, &caddr, sizeof(caddr)) };
+    pthread_t dt;
+    ASSERT(pthread_create(&dt, NULL, poll_main, &dead) == 0);
+    ttak_net_workq_lease_t lease;
+    ASSERT(ttak_net_workq_worker_acquire(dead.worker, &lease, 10000000000ULL) == TTAK_NET_WORKQ_OK);
+    ASSERT(ttak_net_workq_worker_complete(dead.worker, lease.id + 1, 0) == TTAK_NET_WORKQ_INVALID);
+    ASSERT(ttak_net_workq_worker_submit(dead.worker, lease.id, &lease.start, 8, 0) == TTAK_NET_WORKQ_OK);
+    ttak_net_workq_worker_stats_t ds = {0};
+    while (ds.batches == 0) {
+        usleep(1000);
+        ttak_net_workq_worker_stats(dead.worker, &ds);
+    }
+    usleep(50000);  /* Let the batch be acknowledged. */
+    atomic_store(&dead.stop, true);
+    pthread_join(dt, NULL);
+    ttak_net_workq_worker_destroy(dead.worker);
+
+    // A survivor picks up the dead worker's leases once they expire.
+    ttak_shared_net_endpoint_t *sep = udp_endpoint(owner, &waddr);
+    loop_t live = { .worker = ttak_net_workq_worker_create(&wc, sep, owner, &caddr, sizeof(caddr)) };
+    pthread_t lt, wt;
+    ASSERT(pthread_create(&lt, NULL, poll_main, &live) == 0);
+    ASSERT(pthread_create(&wt, NULL, compute_main, live.worker) == 0);
+    pthread_join(wt, NULL);
+    atomic_store(&live.stop, true);
+    pthread_join(lt, NULL);
+    atomic_store(&cl.stop, true);
+    pthread_join(ct, NULL);
+
+    ttak_net_workq_coord_stats_t cs;
+    ttak_net_workq_coord_stats(cl.coord, &cs);
+    ASSERT(ttak_net_workq_coord_finished(cl.coord));
+    ASSERT(cs.reassigned == 2 && cs.completed == 8 && cs.granted == 10);
+    // The seed the dead worker reported arrives again from the survivor.
+    ASSERT(sink.records == 4001 && sink.dups == 1);
+    for (int i = 0; i < 4000; i++) ASSERT(sink.seen[i]);
+
+    ttak_net_workq_worker_destroy(live.worker);
+    ttak_net_endpoint_destroy(sep, owner, ttak_get_tick_count());
+    ttak_net_endpoint_destroy(dep, owner, ttak_get_tick_count());
+    ttak_net_workq_coord_destroy(cl.coord);
+    ttak_net_endpoint_destroy(cep, owner, ttak_get_tick_count());
+    ttak_owner_destroy(owner);
+    free(sink.seen);
+}
+
+int main(void) {
+    RUN_TEST(test_workq_spreads_range_once);
+    RUN_TEST(test_workq_reassigns_dead_worker_leases);
+    return 0;
+}
@@ -3,7 +3,9 @@
 #include <string.h>
 #include <assert.h>
 #include <time.h> // For rand() seed if needed
+#include <pthread.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/profile.h>
 #include <ttak/timing/timing.h> // For ttak_get_tick_count
 #include "../internal/ttak/mem_internal.h" // For internal definitions like ttak_allocation_tier_t
 
@@ -160,6 +162,114 @@ void test_general_allocator(void) {
     }
 }
 
+void test_lite_allocator(void) {
+    fprintf(stderr, "\n--- Running Header-Lite Allocator Tests ---\n");
+    TEST_ASSERT(sizeof(ttak_mem_lite_header_t) == 16, "Lite header is 16 bytes");
+
+    size_t sizes[] = {16, 48, 112, 2048};
+    for (int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        size_t test_size = sizes[i];
+        uint64_t now = get_test_tick_count();
+        void *ptr = ttak_mem_alloc_lite(test_size, __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_STRICT_CHECK);
+        TEST_ASSERT(ptr != NULL, "Lite alloc returned non-NULL");
+        TEST_ASSERT(((uintptr_t)ptr & 15) == 0, "Lite user pointer is 16-byte aligned");
+        TEST_ASSERT(((unsigned char *)ptr)[test_size - 1] == 0, "Lite block is zeroed");
+        memset(ptr, 0x5A, test_size);
+        TEST_ASSERT(ttak_mem_access_lite(ptr, now + 1000) == ptr, "Lite access without TTL");
+        ttak_mem_free_lite(ptr);
+    }
+
+    uint64_t now = get_test_tick_count();
+    /* Keeps the pocket page mapped so the freed block can be inspected. */
+    void *keeper = ttak_mem_alloc_lite(64, 10, now, TTAK_MEM_DEFAULT);
+    void *ttl_ptr = ttak_mem_alloc_lite(64, 10, now, TTAK_MEM_DEFAULT);
+    TEST_ASSERT(ttl_ptr != NULL, "Lite alloc with TTL returned non-NULL");
+    TEST_ASSERT(ttak_mem_access_lite(ttl_ptr, now + 5) == ttl_ptr, "Lite access before expiry");
+    TEST_ASSERT(ttak_mem_access_lite(ttl_ptr, now + 11) == NULL, "Lite access after expiry");
+    ttak_mem_free_lite(ttl_ptr);
+    ttak_mem_free_lite(ttl_ptr);
+    TEST_ASSERT(ttak_mem_access_lite(ttl_ptr, now) == NULL, "Lite double free is ignored");
+    ttak_mem_free_lite(keeper);
+}
+
+#define REMOTE_FREE_BLOCKS 200
+
+static void *remote_free_worker(void *arg) {
+    void **ptrs = (void **)arg;
+    for (int i = 0; i < REMOTE_FREE_BLOCKS; ++i) ttak_mem_free(ptrs[i]);
+    return NULL;
+}
+
+void test_pocket_remote_free(void) {
+    fprintf(stderr, "\n--- Running Pocket Remote-Free Tests ---\n");
+    void *first[REMOTE_FREE_BLOCKS];
+    void *second[REMOTE_FREE_BLOCKS];
+    uint64_t now = get_test_tick_count();
+    for (int i = 0; i < REMOTE_FREE_BLOCKS; ++i) {
+        first[i] = ttak_mem_alloc_safe(48, 100, now, false, false, true, false, TTAK_MEM_DEFAULT);
+        TEST_ASSERT(first[i] != NULL, "Producer pocket alloc returned non-NULL");
+    }
+
+    pthread_t consumer;
+    TEST_ASSERT(pthread_create(&consumer, NULL, remote_free_worker, first) == 0, "Consumer thread started");
+    pthread_join(consumer, NULL);
+
+    /* The producer drains its remote stack instead of mapping fresh pages. */
+    int reused = 0;
+    for (int i = 0; i < REMOTE_FREE_BLOCKS; ++i) {
+        second[i] = ttak_mem_alloc_safe(48, 100, now, false, false, true, false, TTAK_MEM_DEFAULT);
+        TEST_ASSERT(second[i] != NULL, "Producer realloc returned non-NULL");
+        for (int j = 0; j < REMOTE_FREE_BLOCKS; ++j) {
+            if (second[i] == first[j]) { ++reused; break; }
+        }
+    }
+    TEST_ASSERT(reused >= REMOTE_FREE_BLOCKS / 2, "Remotely freed blocks are reused by the owner");
+    for (int i = 0; i < REMOTE_FREE_BLOCKS; ++i) ttak_mem_free(second[i]);
+}
+
+#define PROFILE_BLOCKS 2000
+
+void test_heap_profiler(void) {
+    fprintf(stderr, "\n--- Running Heap Profiler Tests ---\n");
+    static void *ptrs[PROFILE_BLOCKS];
+    uint64_t now = get_test_tick_count();
+    ttak_mem_profile_reset();
+    ttak_mem_profile_start(4096);
+    for (int i = 0; i < PROFILE_BLOCKS; ++i) {
+        ptrs[i] = ttak_mem_alloc_safe(1000, TT_SECOND(5), now, false, false, true, false, TTAK_MEM_DEFAULT);
+        TEST_ASSERT(ptrs[i] != NULL, "Profiled alloc returned non-NULL");
+    }
+
+    /* ~2 MB at a 4 KiB mean interval should yield on the order of 500 samples. */
+    ttak_mem_profile_site_stats_t total;
+    size_t sites = ttak_mem_profile_totals(&total);
+    TEST_ASSERT(sites >= 1, "At least one site recorded");
+    TEST_ASSERT(total.alloc_count >= 250 && total.alloc_count <= 1000, "Sample count tracks the interval");
+    TEST_ASSERT(total.inuse_count == total.alloc_count, "All samples are live before free");
+    TEST_ASSERT(total.alloc_bytes == total.alloc_count * 1000, "Sampled bytes are recorded");
+
+    for (int i = 0; i < PROFILE_BLOCKS; ++i) ttak_mem_free(ptrs[i]);
+    ttak_mem_profile_totals(&total);
+    TEST_ASSERT(total.inuse_count == 0 && total.inuse_bytes == 0, "Frees are credited back");
+
+    FILE *out = tmpfile();
+    TEST_ASSERT(out != NULL, "tmpfile available");
+    TEST_ASSERT(ttak_mem_profile_write_pprof(out) == 0, "pprof profile written");
+    rewind(out);
+    char line[256];
+    TEST_ASSERT(fgets(line, sizeof(line), out) != NULL, "Profile has a header line");
+    TEST_ASSERT(strncmp(line, "heap profile: 0: 0 [", 20) == 0, "Header reports no live samples");
+    TEST_ASSERT(strstr(line, "@ heap_v2/4096") != NULL, "Header carries the sampling rate");
+    fclose(out);
+
+    ttak_mem_profile_stop();
+    TEST_ASSERT(ttak_mem_profile_interval() == 0, "Profiler stopped");
+    ttak_mem_profile_reset();
+    void *unsampled = ttak_mem_alloc_safe(1 << 20, TT_SECOND(5), now, false, false, true, false, TTAK_MEM_DEFAULT);
+    ttak_mem_free(unsampled);
+    TEST_ASSERT(ttak_mem_profile_totals(&total) == 0 && total.alloc_count == 0, "No samples while stopped");
+}
+
 int main(void) {
     ttak_mem_set_trace(0); // Disable tracing for cleaner test output
     // Initialize global_mem_tree and global_ptr_map if they weren't used by earlier tests
@@ -169,6 +279,9 @@ int main(void) {
     test_vma_allocator();
     test_general_allocator();
     test_scoped_allocator();
+    test_lite_allocator();
+    test_pocket_remote_free();
+    test_heap_profiler();
 
     fprintf(stderr, "\nAll new memory module tests completed.\n");
     return 0;
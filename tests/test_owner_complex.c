@@ -56,6 +56,51 @@ static void root_supervisor(void *ctx, void *args) {
     printf("[Root] Child execution finished and destroyed.\n");
 }
 
+// Handles, table growth and transfer through the lock-free slot tables
+static void test_owner_handles(void) {
+    ttak_owner_t *a = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ttak_owner_t *b = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(a != NULL && b != NULL);
+
+    ttak_owner_name_t fn = ttak_owner_intern("do_work");
+    ASSERT(fn != TTAK_OWNER_NAME_NONE);
+    ASSERT(ttak_owner_intern("do_work") == fn);
+    ASSERT(ttak_owner_name_find("never_interned_name") == TTAK_OWNER_NAME_NONE);
+    ASSERT(ttak_owner_register_func_id(a, fn, child_task));
+
+    static user_ctx_t res[200];
+    ttak_owner_name_t ids[200];
+    char name[32];
+    for (int i = 0; i < 200; ++i) {
+        snprintf(name, sizeof(name), "res_%d", i);
+        ids[i] = ttak_owner_intern(name);
+        res[i].secret_value = i;
+        ASSERT(ttak_owner_register_resource_id(a, ids[i], &res[i]));
+    }
+    for (int i = 0; i < 200; ++i) {
+        void *out = NULL;
+        ASSERT(ttak_owner_lookup_resource(a, ids[i], &out));
+        ASSERT(out == &res[i]);
+    }
+
+    int input = 7;
+    ASSERT(ttak_owner_execute_id(a, fn, ids[42], &input));
+    ASSERT(res[42].secret_value == 49);
+
+    ASSERT(ttak_owner_transfer_resource(a, b, "res_42"));
+    ASSERT(!ttak_owner_lookup_resource(a, ids[42], NULL));
+    ASSERT(ttak_owner_lookup_resource(b, ids[42], NULL));
+    ASSERT(!ttak_owner_transfer_resource(a, b, "res_42"));
+
+    ASSERT(ttak_owner_forget_data(a, &res[7]));
+    ASSERT(!ttak_owner_lookup_resource(a, ids[7], NULL));
+    ASSERT(ttak_owner_register_resource_id(a, ids[7], &res[7]));
+    ASSERT(ttak_owner_lookup_resource(a, ids[7], NULL));
+
+    ttak_owner_destroy(a);
+    ttak_owner_destroy(b);
+}
+
 int main() {
     printf("=== Test: Complex Owner Hierarchy ===\n");
     
@@ -75,6 +120,8 @@ int main() {
     
     // 4. Cleanup
     ttak_owner_destroy(root);
+
+    test_owner_handles();
     
     printf("=== Test: Owner Passed ===\n");
     return 0;
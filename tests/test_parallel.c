@@ -0,0 +1,207 @@
+#include <ttak/thread/parallel.h>
+#include <ttak/timing/timing.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_macros.h"
+
+#define PAR_N 200003
+
+static uint64_t rng_next(uint64_t *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+static void mark_body(void *ctx, size_t begin, size_t end) {
+    _Atomic uint8_t *seen = ctx;
+    for (size_t i = begin; i < end; i++) atomic_fetch_add_explicit(&seen[i], 1, memory_order_relaxed);
+}
+
+static void test_parallel_for_covers_range_once(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, now);
+    ASSERT(pool != NULL);
+    static _Atomic uint8_t seen[PAR_N];
+    const size_t grains[] = { 0, 1, 7, 4096, PAR_N * 2 };
+    for (size_t g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+        memset((void *)seen, 0, sizeof(seen));
+        ttak_parallel_for(pool, 5, PAR_N, grains[g], mark_body, (void *)seen, now);
+        for (size_t i = 0; i < PAR_N; i++) ASSERT(seen[i] == (i >= 5));
+    }
+    /* No pool: runs inline. */
+    memset((void *)seen, 0, sizeof(seen));
+    ttak_parallel_for(NULL, 0, PAR_N, 0, mark_body, (void *)seen, now);
+    for (size_t i = 0; i < PAR_N; i++) ASSERT(seen[i] == 1);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void sum_body(void *ctx, size_t begin, size_t end, void *acc) {
+    const uint64_t *v = ctx;
+    uint64_t *sum = acc;
+    for (size_t i = begin; i < end; i++) *sum += v[i];
+}
+
+static void add_op(void *ctx, void *out, const void *lhs, const void *rhs) {
+    (void)ctx;
+    *(uint64_t *)out = *(const uint64_t *)lhs + *(const uint64_t *)rhs;
+}
+
+/* 2x2 matrix product: associative but not commutative. */
+typedef struct { uint64_t m[4]; } mat2_t;
+
+static void mat_op(void *ctx, void *out, const void *lhs, const void *rhs) {
+    (void)ctx;
+    const mat2_t *a = lhs, *b = rhs;
+    mat2_t r;
+    r.m[0] = a->m[0] * b->m[0] + a->m[1] * b->m[2];
+    r.m[1] = a->m[0] * b->m[1] + a->m[1] * b->m[3];
+    r.m[2] = a->m[2] * b->m[0] + a->m[3] * b->m[2];
+    r.m[3] = a->m[2] * b->m[1] + a->m[3] * b->m[3];
+    *(mat2_t *)out = r;
+}
+
+static void mat_body(void *ctx, size_t begin, size_t end, void *acc) {
+    const mat2_t *v = ctx;
+    for (size_t i = begin; i < end; i++) mat_op(NULL, acc, acc, &v[i]);
+}
+
+static void test_parallel_reduce_in_order(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, now);
+    uint64_t *v = malloc(PAR_N * sizeof(*v));
+    mat2_t *m = malloc(PAR_N * sizeof(*m));
+    ASSERT(v && m);
+    uint64_t s = 0x9e3779b97f4a7c15ULL, expect = 0;
+    mat2_t mexpect = { { 1, 0, 0, 1 } };
+    for (size_t i = 0; i < PAR_N; i++) {
+        v[i] = rng_next(&s);
+        expect += v[i];
+        for (int k = 0; k < 4; k++) m[i].m[k] = rng_next(&s);
+        mat_op(NULL, &mexpect, &mexpect, &m[i]);
+    }
+    uint64_t zero = 0, sum = 1;
+    ASSERT(ttak_parallel_reduce(pool, 0, PAR_N, 0, &sum, sizeof(sum), &zero, sum_body, add_op, v, now));
+    ASSERT(sum == expect);
+    ASSERT(ttak_parallel_reduce(pool, 0, PAR_N, 333, &sum, sizeof(sum), &zero, sum_body, add_op, v, now));
+    ASSERT(sum == expect);
+    ASSERT(ttak_parallel_reduce(pool, 3, 3, 0, &sum, sizeof(sum), &zero, sum_body, add_op, v, now));
+    ASSERT(sum == 0);
+
+    const mat2_t id = { { 1, 0, 0, 1 } };
+    mat2_t prod;
+    ASSERT(ttak_parallel_reduce(pool, 0, PAR_N, 1000, &prod, sizeof(prod), &id, mat_body, mat_op, m, now));
+    ASSERT(memcmp(&prod, &mexpect, sizeof(prod)) == 0);
+    free(m);
+    free(v);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void test_parallel_scan_matches_serial(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, now);
+    mat2_t *m = malloc(PAR_N * sizeof(*m));
+    mat2_t *ref = malloc(PAR_N * sizeof(*ref));
+    ASSERT(m && ref);
+    const size_t grains[] = { 0, 1, 999, PAR_N };
+    for (size_t g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+        size_t n = grains[g] == 1 ? 5000 : PAR_N;
+        uint64_t s = 12345 + g;
+        for (size_t i = 0; i < n; i++) {
+            for (int k = 0; k < 4; k++) m[i].m[k] = rng_next(&s);
+            ref[i] = m[i];
+            if (i) mat_op(NULL, &ref[i], &ref[i - 1], &ref[i]);
+        }
+        ASSERT(ttak_parallel_scan(pool, m, n, sizeof(*m), grains[g], mat_op, NULL, now));
+        ASSERT(memcmp(m, ref, n * sizeof(*m)) == 0);
+    }
+    free(ref);
+    free(m);
+    ttak_thread_pool_destroy(pool);
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void test_parallel_sort_u64(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, now);
+    size_t n = 1000003;
+    uint64_t *keys = malloc(n * sizeof(*keys));
+    uint64_t *ref = malloc(n * sizeof(*ref));
+    ASSERT(keys && ref);
+    /* Full-width keys, then keys that vary only in the low 20 bits (skipped passes). */
+    for (int round = 0; round < 2; round++) {
+        uint64_t s = 777 + (uint64_t)round;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t k = rng_next(&s);
+            keys[i] = ref[i] = round ? (0xabcd000000000000ULL | (k & 0xfffff)) : k;
+        }
+        qsort(ref, n, sizeof(*ref), cmp_u64);
+        ASSERT(ttak_parallel_sort_u64(pool, keys, n, now));
+        ASSERT(memcmp(keys, ref, n * sizeof(*keys)) == 0);
+    }
+    /* Small input takes the single-block path. */
+    uint64_t small[] = { 9, 3, UINT64_MAX, 0, 3, 1ULL << 63 };
+    ASSERT(ttak_parallel_sort_u64(NULL, small, 6, now));
+    ASSERT(small[0] == 0 && small[1] == 3 && small[2] == 3 && small[3] == 9 && small[4] == 1ULL << 63 &&
+           small[5] == UINT64_MAX);
+    ASSERT(ttak_parallel_sort_u64(pool, NULL, 0, now));
+    ASSERT(!ttak_parallel_sort_u64(pool, NULL, 4, now));
+    free(ref);
+    free(keys);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void test_parallel_sort_kv_is_stable(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, now);
+    size_t n = 300007;
+    ttak_parallel_kv_t *pairs = malloc(n * sizeof(*pairs));
+    ASSERT(pairs);
+    uint64_t s = 4242;
+    for (size_t i = 0; i < n; i++) {
+        pairs[i].key = rng_next(&s) % 1000;
+        pairs[i].value = i;
+    }
+    ASSERT(ttak_parallel_sort_kv(pool, pairs, n, now));
+    for (size_t i = 1; i < n; i++) {
+        ASSERT(pairs[i - 1].key <= pairs[i].key);
+        if (pairs[i - 1].key == pairs[i].key) ASSERT(pairs[i - 1].value < pairs[i].value);
+    }
+    free(pairs);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void nested_body(void *ctx, size_t begin, size_t end) {
+    ttak_thread_pool_t *pool = ctx;
+    for (size_t i = begin; i < end; i++) {
+        uint64_t zero = 0, sum = 0;
+        uint64_t v[1000];
+        for (size_t k = 0; k < 1000; k++) v[k] = k;
+        ttak_parallel_reduce(pool, 0, 1000, 10, &sum, sizeof(sum), &zero, sum_body, add_op, v, 0);
+        ASSERT(sum == 999 * 1000 / 2);
+    }
+}
+
+static void test_parallel_nested_in_pool(void) {
+    /* Inner loops run from helper tasks of the same pool without deadlocking. */
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ttak_parallel_for(pool, 0, 64, 1, nested_body, pool, now);
+    ttak_thread_pool_destroy(pool);
+}
+
+int main(void) {
+    RUN_TEST(test_parallel_for_covers_range_once);
+    RUN_TEST(test_parallel_reduce_in_order);
+    RUN_TEST(test_parallel_scan_matches_serial);
+    RUN_TEST(test_parallel_sort_u64);
+    RUN_TEST(test_parallel_sort_kv_is_stable);
+    RUN_TEST(test_parallel_nested_in_pool);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <ttak/stats/perf.h>
+#include <pthread.h>
+#include <stdio.h>
+#include "test_macros.h"
+
+static ttak_perf_region_t g_region;
+
+static uint64_t spin_work(uint64_t n) {
+    volatile uint64_t acc = 0;
+    for (uint64_t i = 0; i < n; i++) acc += i * 2654435761u;
+    return acc;
+}
+
+static void test_perf_read_is_monotonic(void) {
+    ttak_perf_sample_t a, b;
+    ttak_perf_read(&a);
+    spin_work(100000);
+    ttak_perf_read(&b);
+    ASSERT(b.ns >= a.ns);
+    uint32_t mask = ttak_perf_open_mask();
+    if (!ttak_perf_available()) {
+        /* Refused by the host: every counter reads zero. */
+        ASSERT(mask == 0);
+        for (int e = 0; e < TTAK_PERF_EVENTS; e++) ASSERT(a.value[e] == 0 && b.value[e] == 0);
+        return;
+    }
+    ASSERT(mask & (1u << TTAK_PERF_CYCLES));
+    ASSERT(b.value[TTAK_PERF_CYCLES] > a.value[TTAK_PERF_CYCLES]);
+    if (mask & (1u << TTAK_PERF_INSTRUCTIONS)) {
+        /* The loop retires at least one instruction per iteration. */
+        ASSERT(b.value[TTAK_PERF_INSTRUCTIONS] - a.value[TTAK_PERF_INSTRUCTIONS] >= 100000);
+    }
+}
+
+static void *region_worker(void *arg) {
+    (void)arg;
+    for (int i = 0; i < 50; i++) {
+        TTAK_PERF_BEGIN(&g_region)
+        spin_work(1000);
+        TTAK_PERF_END(&g_region)
+    }
+    ttak_perf_thread_close();
+    return NULL;
+}
+
+static void test_perf_region_aggregates_threads(void) {
+    ttak_perf_region_init(&g_region, "spin");
+    pthread_t th[3];
+    for (int i = 0; i < 3; i++) ASSERT(pthread_create(&th[i], NULL, region_worker, NULL) == 0);
+    region_worker(NULL);
+    for (int i = 0; i < 3; i++) pthread_join(th[i], NULL);
+
+    ttak_perf_summary_t s;
+    ttak_perf_region_summary(&g_region, &s);
+    ASSERT(s.passes == 200);
+    ASSERT(s.ns > 0.0);
+    if (ttak_perf_available() && (ttak_perf_open_mask() & (1u << TTAK_PERF_INSTRUCTIONS))) {
+        ASSERT(s.value[TTAK_PERF_INSTRUCTIONS] >= 1000.0);
+        ASSERT(s.ipc > 0.0);
+    } else if (!ttak_perf_available()) {
+        ASSERT(s.ipc == 0.0);
+    }
+    ttak_perf_region_print(&g_region);
+}
+
+static void test_perf_reopen_after_close(void) {
+    _Bool before = ttak_perf_available();
+    ttak_perf_thread_close();
+    ASSERT(ttak_perf_available() == before);
+}
+
+int main(void) {
+    test_perf_read_is_monotonic();
+    test_perf_region_aggregates_threads();
+    test_perf_reopen_after_close();
+    printf("perf counters %s\n", ttak_perf_available() ? "available" : "unavailable; zero counts");
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <ttak/phys/dimless/transport.h>
+#include <ttak/thread/parallel.h>
+#include <ttak/timing/timing.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_macros.h"
+
+#define LANES 5003
+
+static uint64_t rng_next(uint64_t *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+/* Mostly valid magnitudes, with zeros, negatives, NaN and inf mixed in. */
+static double sample(uint64_t *s) {
+    uint64_t r = rng_next(s);
+    switch (r % 64) {
+        case 0: return 0.0;
+        case 1: return -1.5;
+        case 2: return NAN;
+        case 3: return INFINITY;
+        default: return 1e-3 + (double)(r >> 11) / 9007199254740992.0 * 10.0;
+    }
+}
+
+/* Grashof leaves g, beta and the difference unchecked, so NaN and inf can pass. */
+static int close_enough(double a, double b) {
+    return a == b || (isnan(a) && isnan(b)) || fabs(a - b) <= 1e-14 * fabs(b);
+}
+
+static double *in[6];
+static double *out;
+static uint8_t *status;
+
+/* Checks a batched result against the scalar call, lane by lane. */
+#define CHECK_LANES(ret, call_scalar)                                         \
+    do {                                                                      \
+        ttak_phys_status_t first = TTAK_PHYS_SUCCESS;                         \
+        for (size_t i = 0; i < LANES; ++i) {                                  \
+            double want = 0.0;                                                \
+            ttak_phys_status_t st = call_scalar;                              \
+            ASSERT(status[i] == (uint8_t)st);                                 \
+            if (st == TTAK_PHYS_SUCCESS) {                                    \
+                ASSERT(close_enough(out[i], want));                           \
+            } else {                                                          \
+                ASSERT(isnan(out[i]));                                        \
+                if (first == TTAK_PHYS_SUCCESS) first = st;                   \
+            }                                                                 \
+        }                                                                     \
+        ASSERT((ret) == first);                                               \
+    } while (0)
+
+static void run_all(const ttak_phys_batch_t *b) {
+    ttak_phys_status_t r;
+    r = ttak_phys_calc_reynolds_batch(b, out, in[0], in[1], in[2], in[3]);
+    CHECK_LANES(r, ttak_phys_calc_reynolds(&want, in[0][i], in[1][i], in[2][i], in[3][i]));
+    r = ttak_phys_calc_schmidt_batch(b, out, in[0], in[1], in[2]);
+    CHECK_LANES(r, ttak_phys_calc_schmidt(&want, in[0][i], in[1][i], in[2][i]));
+    r = ttak_phys_calc_mass_peclet_batch(b, out, in[0], in[1], in[2]);
+    CHECK_LANES(r, ttak_phys_calc_mass_peclet(&want, in[0][i], in[1][i], in[2][i]));
+    r = ttak_phys_calc_sherwood_batch(b, out, in[0], in[1], in[2]);
+    CHECK_LANES(r, ttak_phys_calc_sherwood(&want, in[0][i], in[1][i], in[2][i]));
+    r = ttak_phys_calc_prandtl_batch(b, out, in[0], in[1], in[2]);
+    CHECK_LANES(r, ttak_phys_calc_prandtl(&want, in[0][i], in[1][i], in[2][i]));
+    r = ttak_phys_calc_grashof_batch(b, out, in[0], in[1], in[2], in[3], in[4], in[5]);
+    CHECK_LANES(r, ttak_phys_calc_grashof(&want, in[0][i], in[1][i], in[2][i], in[3][i], in[4][i], in[5][i]));
+    r = ttak_phys_calc_grashof_mass_batch(b, out, in[0], in[1], in[2], in[3], in[4], in[5]);
+    CHECK_LANES(r, ttak_phys_calc_grashof_mass(&want, in[0][i], in[1][i], in[2][i], in[3][i], in[4][i], in[5][i]));
+    r = ttak_phys_calc_km_batch(b, out, in[0], in[1], in[2]);
+    CHECK_LANES(r, ttak_phys_calc_km(&want, in[0][i], in[1][i], in[2][i]));
+}
+
+static void test_batch_matches_scalar(void) {
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (int k = 0; k < 6; ++k) {
+        in[k] = malloc(LANES * sizeof(double));
+        ASSERT(in[k] != NULL);
+        for (size_t i = 0; i < LANES; ++i) in[k][i] = sample(&seed);
+    }
+    out = malloc(LANES * sizeof(double));
+    status = malloc(LANES);
+    ASSERT(out && status);
+
+    uint64_t now = ttak_get_tick_count();
+    ttak_phys_batch_t b = { .count = LANES, .status = status, .now = now };
+    run_all(&b);
+
+    // Small chunks on a pool must not change any lane or the reported status.
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(3, 0, now);
+    ASSERT(pool != NULL);
+    b.pool = pool;
+    b.grain = 300;
+    run_all(&b);
+    ttak_thread_pool_destroy(pool);
+
+    // Without a status array the return value still names the first failure.
+    memset(in[3], 0, LANES * sizeof(double));
+    in[3][7] = NAN;
+    b = (ttak_phys_batch_t){ .count = LANES, .now = now };
+    ASSERT(ttak_phys_calc_km_batch(&b, out, in[2], in[3], in[4]) != TTAK_PHYS_SUCCESS);
+    for (size_t i = 0; i < LANES; ++i) in[3][i] = 1.0 + (double)i;
+    in[3][LANES - 1] = 0.0;
+    ttak_phys_status_t expect = TTAK_PHYS_SUCCESS;
+    for (size_t i = 0; i < LANES && expect == TTAK_PHYS_SUCCESS; ++i) {
+        double tmp;
+        expect = ttak_phys_calc_mass_peclet(&tmp, in[0][i], in[1][i], in[3][i]);
+    }
+    ASSERT(ttak_phys_calc_mass_peclet_batch(&b, out, in[0], in[1], in[3]) == expect);
+
+    // In place: the output may be one of the inputs.
+    for (size_t i = 0; i < LANES; ++i) {
+        in[0][i] = 2.0;
+        in[1][i] = (double)i;
+    }
+    ASSERT(ttak_phys_calc_rayleigh_batch(&b, in[1], in[0], in[1]) == TTAK_PHYS_SUCCESS);
+    for (size_t i = 0; i < LANES; ++i) ASSERT(in[1][i] == 2.0 * (double)i);
+
+    ASSERT(ttak_phys_calc_rayleigh_batch(NULL, out, in[0], in[1]) == TTAK_PHYS_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_phys_calc_rayleigh_batch(&b, out, in[0], NULL) == TTAK_PHYS_ERR_INVALID_ARGUMENT);
+    b.count = 0;
+    ASSERT(ttak_phys_calc_rayleigh_batch(&b, NULL, NULL, NULL) == TTAK_PHYS_SUCCESS);
+
+    for (int k = 0; k < 6; ++k) free(in[k]);
+    free(out);
+    free(status);
+}
+
+int main(void) {
+    RUN_TEST(test_batch_matches_scalar);
+    return 0;
+}
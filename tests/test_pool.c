@@ -1,4 +1,9 @@
 #include <ttak/container/pool.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
 #include "test_macros.h"
 
 static void test_object_pool_reuses_slots(void) {
@@ -17,7 +22,139 @@ static void test_object_pool_reuses_slots(void) {
     ttak_object_pool_destroy(pool);
 }
 
+#define GROW_ITEMS 1000
+
+static void test_object_pool_grows_by_chunk(void) {
+    ttak_object_pool_t *pool = ttak_object_pool_create(4, 3);
+    ASSERT(pool != NULL);
+    ASSERT(ttak_object_pool_capacity(pool) == 4);
+
+    static unsigned char *items[GROW_ITEMS];
+    for (int i = 0; i < GROW_ITEMS; ++i) {
+        items[i] = ttak_object_pool_alloc(pool);
+        ASSERT(items[i] != NULL);
+        memset(items[i], (int)(i & 0xff), 3);
+    }
+    ASSERT(ttak_object_pool_capacity(pool) >= GROW_ITEMS);
+    for (int i = 0; i < GROW_ITEMS; ++i) {
+        ASSERT(items[i][0] == (unsigned char)(i & 0xff) && items[i][2] == (unsigned char)(i & 0xff));
+    }
+
+    size_t cap = ttak_object_pool_capacity(pool);
+    for (int i = 0; i < GROW_ITEMS; ++i) ttak_object_pool_free(pool, items[i]);
+    /* Second frees and foreign pointers are ignored. */
+    ttak_object_pool_free(pool, items[0]);
+    int local;
+    ttak_object_pool_free(pool, &local);
+    ttak_object_pool_free(pool, items[1] + 1);
+
+    for (int i = 0; i < GROW_ITEMS; ++i) {
+        items[i] = ttak_object_pool_alloc(pool);
+        ASSERT(items[i] != NULL);
+        for (int j = 0; j < i && i < 64; ++j) ASSERT(items[j] != items[i]);
+    }
+    ASSERT(ttak_object_pool_capacity(pool) == cap);
+    ttak_object_pool_destroy(pool);
+}
+
+typedef struct {
+    ttak_object_pool_t *pool;
+    void **items;
+    int count;
+    int got;
+} bounded_ctx_t;
+
+static void *bounded_worker(void *arg) {
+    bounded_ctx_t *ctx = (bounded_ctx_t *)arg;
+    for (int i = 0; i < ctx->count; ++i) {
+        ctx->items[i] = ttak_object_pool_alloc(ctx->pool);
+        if (ctx->items[i]) ctx->got++;
+    }
+    return NULL;
+}
+
+static void test_object_pool_ceiling_steals_magazines(void) {
+    ttak_object_pool_t *pool = ttak_object_pool_create_ex(16, 32, 64);
+    ASSERT(pool != NULL);
+
+    void *items[65];
+    for (int i = 0; i < 64; ++i) {
+        items[i] = ttak_object_pool_alloc(pool);
+        ASSERT(items[i] != NULL);
+    }
+    ASSERT(ttak_object_pool_alloc(pool) == NULL);
+    ASSERT(ttak_object_pool_capacity(pool) == 64);
+
+    /* Every item parks in this thread's magazine or the shared stack. */
+    for (int i = 0; i < 64; ++i) ttak_object_pool_free(pool, items[i]);
+
+    bounded_ctx_t ctx = { .pool = pool, .items = items, .count = 65 };
+    pthread_t t;
+    ASSERT(pthread_create(&t, NULL, bounded_worker, &ctx) == 0);
+    pthread_join(t, NULL);
+    ASSERT(ctx.got == 64);
+    ttak_object_pool_destroy(pool);
+}
+
+#define STRESS_THREADS 4
+#define STRESS_ROUNDS 20000
+#define STRESS_HAND 64
+
+typedef struct {
+    uint64_t owner;
+    uint64_t round;
+} stress_item_t;
+
+static ttak_object_pool_t *g_stress_pool;
+static _Atomic(stress_item_t *) g_hand[STRESS_HAND];
+static _Atomic int g_stress_errors;
+
+static void *stress_worker(void *arg) {
+    uint64_t self = (uint64_t)(uintptr_t)arg;
+    for (uint64_t r = 0; r < STRESS_ROUNDS; ++r) {
+        stress_item_t *it = ttak_object_pool_alloc(g_stress_pool);
+        if (!it) {
+            atomic_fetch_add(&g_stress_errors, 1);
+            continue;
+        }
+        it->owner = self;
+        it->round = r;
+        if ((r & 7) == 0) sched_yield();
+        if (it->owner != self || it->round != r) atomic_fetch_add(&g_stress_errors, 1);
+        /* Hand some items to another thread to free. */
+        stress_item_t *prev = atomic_exchange(&g_hand[(r * 7 + self) % STRESS_HAND], (r & 1) ? it : NULL);
+        if (!(r & 1)) ttak_object_pool_free(g_stress_pool, it);
+        if (prev) ttak_object_pool_free(g_stress_pool, prev);
+    }
+    return NULL;
+}
+
+static void test_object_pool_concurrent_alloc_free(void) {
+    g_stress_pool = ttak_object_pool_create(64, sizeof(stress_item_t));
+    ASSERT(g_stress_pool != NULL);
+    atomic_store(&g_stress_errors, 0);
+    for (int i = 0; i < STRESS_HAND; ++i) atomic_store(&g_hand[i], NULL);
+
+    pthread_t threads[STRESS_THREADS];
+    for (uintptr_t i = 0; i < STRESS_THREADS; ++i) {
+        ASSERT(pthread_create(&threads[i], NULL, stress_worker, (void *)(i + 1)) == 0);
+    }
+    for (int i = 0; i < STRESS_THREADS; ++i) pthread_join(threads[i], NULL);
+    ASSERT(atomic_load(&g_stress_errors) == 0);
+
+    for (int i = 0; i < STRESS_HAND; ++i) {
+        stress_item_t *it = atomic_exchange(&g_hand[i], NULL);
+        if (it) ttak_object_pool_free(g_stress_pool, it);
+    }
+    /* Nothing leaked: far fewer items than operations were ever carved. */
+    ASSERT(ttak_object_pool_capacity(g_stress_pool) <= 1024);
+    ttak_object_pool_destroy(g_stress_pool);
+}
+
 int main(void) {
     RUN_TEST(test_object_pool_reuses_slots);
+    RUN_TEST(test_object_pool_grows_by_chunk);
+    RUN_TEST(test_object_pool_ceiling_steals_magazines);
+    RUN_TEST(test_object_pool_concurrent_alloc_free);
     return 0;
 }
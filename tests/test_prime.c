@@ -0,0 +1,139 @@
+#include <ttak/math/prime.h>
+#include <ttak/mem/mem.h>
+#include <ttak/timing/timing.h>
+#include "test_macros.h"
+
+#include <stdint.h>
+
+static bool naive_is_prime(uint64_t n) {
+    if (n < 2) return false;
+    for (uint64_t d = 2; d * d <= n; ++d) {
+        if (n % d == 0) return false;
+    }
+    return true;
+}
+
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+void test_prime_odd_bits_match_trial_division() {
+    uint64_t now = ttak_get_tick_count();
+    /* Spans several segments and a partial last word. */
+    uint64_t limit = (uint64_t)TTAK_PRIME_SIEVE_SEGMENT_WORDS * 128 * 3 + 77;
+    uint64_t *bits = ttak_prime_odd_bits(limit, now);
+    ASSERT(bits != NULL);
+    for (uint64_t v = 1; v <= limit; v += 2) {
+        ASSERT_MSG(ttak_prime_is_odd_marked(bits, v) == naive_is_prime(v), "odd bit for %llu", (unsigned long long)v);
+    }
+    ASSERT(!ttak_prime_is_odd_marked(bits, limit + 2));
+    ttak_mem_free(bits);
+
+    size_t count = 0;
+    uint32_t *primes = ttak_prime_odd_list(100000, &count, now);
+    ASSERT(primes != NULL);
+    ASSERT(count == 9591 && primes[0] == 3 && primes[count - 1] == 99991);
+    ttak_mem_free(primes);
+    primes = ttak_prime_odd_list(1000, &count, now);
+    ASSERT(primes != NULL && count == 167 && primes[166] == 997);
+    ttak_mem_free(primes);
+
+    size_t small = 0;
+    const uint16_t *table = ttak_prime_small_table(&small);
+    ASSERT(small == 168 && table[0] == 2 && table[167] == 997);
+}
+
+/* Walks [lo, hi) in chunks of @p chunk and checks every value in between. */
+static void check_sieve_range(uint64_t lo, uint64_t hi, size_t chunk) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_prime_sieve_t *sieve = ttak_prime_sieve_create(lo, hi, now);
+    ASSERT(sieve != NULL);
+    uint64_t buf[64];
+    uint64_t expect = lo;
+    size_t got;
+    while ((got = ttak_prime_sieve_next(sieve, buf, chunk)) > 0) {
+        ASSERT(got <= chunk);
+        for (size_t i = 0; i < got; ++i) {
+            for (; expect < buf[i]; ++expect) ASSERT_MSG(!ttak_is_prime_u64(expect), "sieve skipped %llu", (unsigned long long)expect);
+            ASSERT_MSG(ttak_is_prime_u64(buf[i]), "sieve reported %llu", (unsigned long long)buf[i]);
+            expect = buf[i] + 1;
+        }
+    }
+    for (; expect < hi; ++expect) ASSERT(!ttak_is_prime_u64(expect));
+    ASSERT(ttak_prime_sieve_next(sieve, buf, chunk) == 0);
+    ttak_prime_sieve_destroy(sieve);
+}
+
+void test_prime_sieve_walks_ranges() {
+    check_sieve_range(0, 3000, 7);
+    check_sieve_range(2, 3, 1);
+    check_sieve_range(5, 5, 4);
+    check_sieve_range(1000000000000ULL, 1000000000000ULL + 1200000, 64);
+    check_sieve_range((1ULL << 48) - 3000, (1ULL << 48) + 3000, 3);
+}
+
+void test_prime_is_prime_edge_cases() {
+    ASSERT(!ttak_is_prime_u64(0) && !ttak_is_prime_u64(1));
+    ASSERT(ttak_is_prime_u64(2) && ttak_is_prime_u64(3) && !ttak_is_prime_u64(4));
+    for (uint64_t n = 0; n < 200000; ++n) ASSERT_MSG(ttak_is_prime_u64(n) == naive_is_prime(n), "n=%llu", (unsigned long long)n);
+    /* Past 997^2 trial division no longer decides and Miller-Rabin does. */
+    for (uint64_t n = 994009; n < 1300000; ++n) ASSERT_MSG(ttak_is_prime_u64(n) == naive_is_prime(n), "n=%llu", (unsigned long long)n);
+
+    /* Strong pseudoprimes to several small bases, and Carmichael numbers. */
+    static const uint64_t composites[] = {
+        561ULL, 41041ULL, 3215031751ULL, 2152302898747ULL, 3474749660383ULL, 341550071728321ULL,
+        3825123056546413051ULL, 1193557489ULL * 1193557489ULL, 4294967291ULL * 4294967279ULL,
+        18446744030759878681ULL,
+    };
+    for (size_t i = 0; i < sizeof(composites) / sizeof(composites[0]); ++i) {
+        ASSERT_MSG(!ttak_is_prime_u64(composites[i]), "composite %llu", (unsigned long long)composites[i]);
+    }
+    static const uint64_t primes[] = {
+        1000000007ULL, 4294967291ULL, 4294967311ULL, 299210837ULL, 407521ULL,
+        9223372036854775783ULL, 18446744073709551557ULL, 18446744073709551533ULL,
+    };
+    for (size_t i = 0; i < sizeof(primes) / sizeof(primes[0]); ++i) {
+        ASSERT_MSG(ttak_is_prime_u64(primes[i]), "prime %llu", (unsigned long long)primes[i]);
+    }
+    ASSERT(!ttak_is_prime_u64(UINT64_MAX));
+}
+
+void test_prime_batch_matches_scalar() {
+    enum { N = 997 };
+    static uint64_t values[N];
+    static bool batch[N];
+    for (size_t i = 0; i < N; ++i) {
+        uint64_t v = mix(i + 1);
+        /* Mix full-width odd values, small ones and known primes so lanes differ in exponent length. */
+        if (i % 5 == 0) v >>= (i % 60);
+        if (i % 7 == 0) v = 18446744073709551557ULL;
+        if (i % 11 == 0) v = 4294967291ULL * 4294967279ULL;
+        values[i] = v | 1;
+    }
+    ttak_is_prime_u64_batch(values, N, batch);
+    size_t found = 0;
+    for (size_t i = 0; i < N; ++i) {
+        ASSERT_MSG(batch[i] == ttak_is_prime_u64(values[i]), "batch mismatch at %zu", i);
+        found += batch[i];
+    }
+    ASSERT(found > N / 7);
+
+    uint64_t run[3000];
+    bool run_prime[3000];
+    for (size_t i = 0; i < 3000; ++i) run[i] = 1000000000000000000ULL + i;
+    ttak_is_prime_u64_batch(run, 3000, run_prime);
+    for (size_t i = 0; i < 3000; ++i) ASSERT(run_prime[i] == ttak_is_prime_u64(run[i]));
+}
+
+int main() {
+    RUN_TEST(test_prime_odd_bits_match_trial_division);
+    RUN_TEST(test_prime_sieve_walks_ranges);
+    RUN_TEST(test_prime_is_prime_edge_cases);
+    RUN_TEST(test_prime_batch_matches_scalar);
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include <ttak/priority/queue.h>
 #include <ttak/async/task.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "test_macros.h"
 
 void *dummy_func(void *arg) { (void)arg; return NULL; }
@@ -27,9 +29,103 @@ void test_priority_queue_basic() {
     
     ttak_task_destroy(t1, now);
     ttak_task_destroy(t2, now);
+    ttak_priority_queue_destroy(&q);
+}
+
+/* Equal priorities leave FIFO; out-of-range priorities clamp to the end bands. */
+void test_priority_queue_bands() {
+    struct __internal_ttak_proc_priority_queue_t q;
+    ttak_priority_queue_init(&q);
+    ttak_task_t *t[6];
+    for (uintptr_t i = 0; i < 6; i++) t[i] = (ttak_task_t *)(i + 1);
+
+    ASSERT(q.push(&q, t[0], 0, 0));
+    ASSERT(q.push(&q, t[1], -1000, 0));
+    ASSERT(q.push(&q, t[2], 0, 0));
+    ASSERT(q.push(&q, t[3], 1000, 0));
+    ASSERT(q.push(&q, t[4], TTAK_PQ_PRIORITY_MAX, 0));
+    ASSERT(q.push(&q, t[5], TTAK_PQ_PRIORITY_MIN, 0));
+
+    ASSERT(q.pop(&q, 0) == t[3]);
+    ASSERT(q.pop(&q, 0) == t[4]);
+    ASSERT(q.pop(&q, 0) == t[0]);
+    ASSERT(q.pop(&q, 0) == t[2]);
+    ASSERT(q.pop(&q, 0) == t[1]);
+    ASSERT(q.pop(&q, 0) == t[5]);
+    ASSERT(q.pop(&q, 0) == NULL);
+    ttak_priority_queue_destroy(&q);
+}
+
+/* A full band refuses the push instead of allocating or dropping silently. */
+void test_priority_queue_full_band() {
+    struct __internal_ttak_proc_priority_queue_t q;
+    ttak_priority_queue_init(&q);
+    for (uintptr_t i = 0; i < TTAK_PQ_BAND_CAPACITY; i++) {
+        ASSERT(q.push(&q, (ttak_task_t *)(i + 1), 3, 0));
+    }
+    ASSERT(!q.push(&q, (ttak_task_t *)1, 3, 0));
+    /* Other bands are independent. */
+    ASSERT(q.push(&q, (ttak_task_t *)1, 4, 0));
+    ASSERT(q.get_size(&q) == TTAK_PQ_BAND_CAPACITY + 1);
+    ASSERT(q.pop(&q, 0) == (ttak_task_t *)1);
+    for (uintptr_t i = 0; i < TTAK_PQ_BAND_CAPACITY; i++) {
+        ASSERT(q.pop(&q, 0) == (ttak_task_t *)(i + 1));
+    }
+    ASSERT(q.get_size(&q) == 0);
+    ttak_priority_queue_destroy(&q);
+}
+
+#define MPMC_THREADS 4
+#define MPMC_PER_THREAD 20000
+
+static struct __internal_ttak_proc_priority_queue_t g_mpmc_q;
+static _Atomic size_t g_mpmc_popped;
+static _Atomic uint64_t g_mpmc_sum;
+
+static void *mpmc_producer(void *arg) {
+    uintptr_t base = (uintptr_t)arg * MPMC_PER_THREAD;
+    for (uintptr_t i = 0; i < MPMC_PER_THREAD; i++) {
+        ttak_task_t *task = (ttak_task_t *)(base + i + 1);
+        while (!g_mpmc_q.push(&g_mpmc_q, task, (int)(i % 8), 0)) { }
+    }
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg) {
+    (void)arg;
+    while (atomic_load(&g_mpmc_popped) < MPMC_THREADS * MPMC_PER_THREAD) {
+        ttak_task_t *task = g_mpmc_q.pop(&g_mpmc_q, 0);
+        if (!task) continue;
+        atomic_fetch_add(&g_mpmc_sum, (uint64_t)(uintptr_t)task);
+        atomic_fetch_add(&g_mpmc_popped, 1);
+    }
+    return NULL;
+}
+
+void test_priority_queue_mpmc() {
+    ttak_priority_queue_init(&g_mpmc_q);
+    atomic_store(&g_mpmc_popped, 0);
+    atomic_store(&g_mpmc_sum, 0);
+    pthread_t prod[MPMC_THREADS], cons[MPMC_THREADS];
+    for (uintptr_t i = 0; i < MPMC_THREADS; i++) {
+        ASSERT(pthread_create(&cons[i], NULL, mpmc_consumer, NULL) == 0);
+        ASSERT(pthread_create(&prod[i], NULL, mpmc_producer, (void *)i) == 0);
+    }
+    for (int i = 0; i < MPMC_THREADS; i++) pthread_join(prod[i], NULL);
+    for (int i = 0; i < MPMC_THREADS; i++) pthread_join(cons[i], NULL);
+
+    /* Every task came out exactly once. */
+    uint64_t n = (uint64_t)MPMC_THREADS * MPMC_PER_THREAD;
+    ASSERT(atomic_load(&g_mpmc_popped) == n);
+    ASSERT(atomic_load(&g_mpmc_sum) == n * (n + 1) / 2);
+    ASSERT(g_mpmc_q.pop(&g_mpmc_q, 0) == NULL);
+    ttak_priority_queue_destroy(&g_mpmc_q);
 }
 
 int main() {
     RUN_TEST(test_priority_queue_basic);
+    RUN_TEST(test_priority_queue_bands);
+    RUN_TEST(test_priority_queue_full_band);
+    RUN_TEST(test_priority_queue_mpmc);
     return 0;
 }
@@ -0,0 +1,136 @@
+#include <ttak/io/reactor.h>
+#include <ttak/timing/timing.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+#define RX_PIPES 64
+#define RX_ROUNDS 20
+
+typedef struct {
+    int fds[2];
+    ttak_io_guard_t guard;
+    ttak_io_watch_t *watch;
+    _Atomic int bytes;
+    _Atomic int hups;
+    _Atomic int released;
+} rx_pipe_t;
+
+static void rx_on_ready(int fd, short revents, void *user) {
+    rx_pipe_t *p = user;
+    if (revents & POLLIN) {
+        // Edge-triggered: drain until EAGAIN.
+        char buf[64];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) atomic_fetch_add(&p->bytes, (int)n);
+    }
+    if (revents & POLLERR) atomic_fetch_add(&p->hups, 1);
+}
+
+static void rx_release(void *user) {
+    atomic_fetch_add(&((rx_pipe_t *)user)->released, 1);
+}
+
+static void rx_open(rx_pipe_t *p, uint64_t ttl, uint64_t now) {
+    atomic_init(&p->bytes, 0);
+    atomic_init(&p->hups, 0);
+    atomic_init(&p->released, 0);
+    ASSERT(pipe(p->fds) == 0);
+    fcntl(p->fds[0], F_SETFL, fcntl(p->fds[0], F_GETFL) | O_NONBLOCK);
+    ASSERT(ttak_io_guard_init(&p->guard, p->fds[0], NULL, ttl, now) == TTAK_IO_SUCCESS);
+}
+
+static int rx_wait(_Atomic int *v, int want) {
+    uint64_t deadline = ttak_get_tick_count() + 5000;
+    while (atomic_load(v) < want) {
+        if (ttak_get_tick_count() > deadline) return 0;
+        sched_yield();
+    }
+    return 1;
+}
+
+static void run_reactor(ttak_thread_pool_t *pool) {
+    static rx_pipe_t pipes[RX_PIPES];
+    uint64_t now = ttak_get_tick_count();
+    ttak_io_reactor_t *r = ttak_io_reactor_create(2, pool);
+    ASSERT(r != NULL);
+
+    for (int i = 0; i < RX_PIPES; i++) {
+        rx_open(&pipes[i], TT_SECOND(3600), now);
+        ASSERT(ttak_io_reactor_add(r, &pipes[i].guard, POLLIN, rx_on_ready, &pipes[i], rx_release,
+                                   &pipes[i].watch, now) == TTAK_IO_SUCCESS);
+    }
+    ASSERT(ttak_io_reactor_watch_count(r) == RX_PIPES);
+
+    for (int round = 1; round <= RX_ROUNDS; round++) {
+        for (int i = 0; i < RX_PIPES; i++) ASSERT(write(pipes[i].fds[1], "abc", 3) == 3);
+        for (int i = 0; i < RX_PIPES; i++) ASSERT(rx_wait(&pipes[i].bytes, 3 * round));
+    }
+
+    // Removed watches get no callbacks and are released.
+    ttak_io_reactor_remove(pipes[0].watch);
+    ASSERT(rx_wait(&pipes[0].released, 1));
+    ASSERT(write(pipes[0].fds[1], "x", 1) == 1);
+    ASSERT(write(pipes[1].fds[1], "x", 1) == 1);
+    ASSERT(rx_wait(&pipes[1].bytes, 3 * RX_ROUNDS + 1));
+    ASSERT(atomic_load(&pipes[0].bytes) == 3 * RX_ROUNDS);
+    ASSERT(ttak_io_reactor_watch_count(r) == RX_PIPES - 1);
+
+    ttak_io_reactor_destroy(r);
+    for (int i = 0; i < RX_PIPES; i++) {
+        ASSERT(rx_wait(&pipes[i].released, 1));
+        ASSERT(atomic_load(&pipes[i].released) == 1);
+        close(pipes[i].fds[0]);
+        close(pipes[i].fds[1]);
+    }
+}
+
+static void test_reactor_inline(void) {
+    run_reactor(NULL);
+}
+
+static void test_reactor_pool_dispatch(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+    run_reactor(pool);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void test_reactor_expired_guard(void) {
+    rx_pipe_t p;
+    ttak_io_reactor_t *r = ttak_io_reactor_create(1, NULL);
+    ASSERT(r != NULL);
+
+    // A guard that expires right after registration.
+    uint64_t now = ttak_get_tick_count();
+    rx_open(&p, 1, now);
+    ASSERT(ttak_io_reactor_add(r, &p.guard, POLLIN, rx_on_ready, &p, rx_release, &p.watch, now) ==
+           TTAK_IO_SUCCESS);
+    while (ttak_get_tick_count() <= now + 1) sched_yield();
+
+    ASSERT(write(p.fds[1], "a", 1) == 1);
+    ASSERT(rx_wait(&p.hups, 1));
+    ASSERT(rx_wait(&p.released, 1));
+    ASSERT(ttak_io_reactor_watch_count(r) == 0);
+    ASSERT(atomic_load(&p.bytes) == 0);
+
+    ttak_io_guard_t dead;
+    ASSERT(ttak_io_guard_init(&dead, p.fds[1], NULL, 1, 0) == TTAK_IO_SUCCESS);
+    ASSERT(ttak_io_reactor_add(r, &dead, POLLOUT, rx_on_ready, NULL, NULL, NULL, now + 10) ==
+           TTAK_IO_ERR_EXPIRED_GUARD);
+
+    ttak_io_reactor_destroy(r);
+    close(p.fds[0]);
+    close(p.fds[1]);
+}
+
+int main(void) {
+    RUN_TEST(test_reactor_inline);
+    RUN_TEST(test_reactor_pool_dispatch);
+    RUN_TEST(test_reactor_expired_guard);
+    return 0;
+}
@@ -1,4 +1,8 @@
 #include <ttak/container/ringbuf.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include "test_macros.h"
 
 static void test_ringbuf_push_pop_cycle(void) {
@@ -22,7 +26,139 @@ static void test_ringbuf_push_pop_cycle(void) {
     ttak_ringbuf_destroy(rb);
 }
 
+static void test_ringbuf_batch_and_slots_every_mode(void) {
+    static const ttak_ringbuf_mode_t modes[] = { TTAK_RINGBUF_LOCKED, TTAK_RINGBUF_SPSC, TTAK_RINGBUF_MPMC };
+    for (size_t m = 0; m < 3; ++m) {
+        ttak_ringbuf_t *rb = ttak_ringbuf_create_ex(6, sizeof(uint64_t), modes[m]);
+        ASSERT(rb != NULL);
+        /* Lock-free capacities round up to a power of two. */
+        size_t cap = modes[m] == TTAK_RINGBUF_LOCKED ? 6 : 8;
+        ASSERT(rb->capacity == cap);
+
+        uint64_t in[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+        uint64_t out[10] = { 0 };
+        ASSERT(ttak_ringbuf_push_n(rb, in, 3) == 3);
+        ASSERT(ttak_ringbuf_pop_n(rb, out, 2) == 2);
+        ASSERT(out[0] == 1 && out[1] == 2);
+        /* A batch wraps around the end and stops at full. */
+        ASSERT(ttak_ringbuf_push_n(rb, in + 3, 7) == cap - 1);
+        ASSERT(ttak_ringbuf_is_full(rb));
+        ASSERT(ttak_ringbuf_count(rb) == cap);
+        ttak_ringbuf_slot_t slot;
+        ASSERT(!ttak_ringbuf_reserve(rb, &slot));
+        ASSERT(ttak_ringbuf_pop_n(rb, out, 10) == cap);
+        for (size_t i = 0; i < cap; ++i) ASSERT(out[i] == 3 + i);
+        ASSERT(ttak_ringbuf_is_empty(rb));
+        ASSERT(!ttak_ringbuf_claim(rb, &slot));
+
+        /* Zero-copy: write in place, publish, read in place, free. */
+        ASSERT(ttak_ringbuf_reserve(rb, &slot));
+        *(uint64_t *)slot.ptr = 42;
+        ttak_ringbuf_commit(rb, &slot);
+        ASSERT(ttak_ringbuf_count(rb) == 1);
+        ASSERT(ttak_ringbuf_claim(rb, &slot));
+        ASSERT(*(const uint64_t *)slot.ptr == 42);
+        ttak_ringbuf_release(rb, &slot);
+        ASSERT(ttak_ringbuf_is_empty(rb));
+        ttak_ringbuf_destroy(rb);
+    }
+}
+
+#define STREAM_ITEMS 200000
+
+static void *spsc_producer(void *arg) {
+    ttak_ringbuf_t *rb = (ttak_ringbuf_t *)arg;
+    uint64_t batch[16];
+    uint64_t next = 0;
+    while (next < STREAM_ITEMS) {
+        size_t n = 0;
+        while (n < 16 && next + n < STREAM_ITEMS) {
+            batch[n] = next + n;
+            n++;
+        }
+        size_t pushed = ttak_ringbuf_push_n(rb, batch, n);
+        if (pushed == 0) sched_yield();
+        next += pushed;
+    }
+    return NULL;
+}
+
+static void test_ringbuf_spsc_stream_in_order(void) {
+    ttak_ringbuf_t *rb = ttak_ringbuf_create_ex(64, sizeof(uint64_t), TTAK_RINGBUF_SPSC);
+    ASSERT(rb != NULL);
+    pthread_t producer;
+    ASSERT(pthread_create(&producer, NULL, spsc_producer, rb) == 0);
+    uint64_t expect = 0;
+    uint64_t batch[8];
+    while (expect < STREAM_ITEMS) {
+        size_t n = ttak_ringbuf_pop_n(rb, batch, 8);
+        if (n == 0) sched_yield();
+        for (size_t i = 0; i < n; ++i) ASSERT(batch[i] == expect++);
+    }
+    pthread_join(producer, NULL);
+    ASSERT(ttak_ringbuf_is_empty(rb));
+    ttak_ringbuf_destroy(rb);
+}
+
+#define MPMC_THREADS 4
+#define MPMC_PER_THREAD 50000
+
+static _Atomic uint64_t g_mpmc_sum;
+static _Atomic size_t g_mpmc_popped;
+
+static void *mpmc_producer(void *arg) {
+    ttak_ringbuf_t *rb = (ttak_ringbuf_t *)arg;
+    for (uint64_t i = 1; i <= MPMC_PER_THREAD;) {
+        if (i % 2) {
+            if (ttak_ringbuf_push(rb, &i)) i++;
+            else sched_yield();
+        } else {
+            ttak_ringbuf_slot_t slot;
+            if (ttak_ringbuf_reserve(rb, &slot)) {
+                *(uint64_t *)slot.ptr = i++;
+                ttak_ringbuf_commit(rb, &slot);
+            } else {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg) {
+    ttak_ringbuf_t *rb = (ttak_ringbuf_t *)arg;
+    uint64_t batch[4];
+    while (atomic_load(&g_mpmc_popped) < (size_t)MPMC_THREADS * MPMC_PER_THREAD) {
+        size_t n = ttak_ringbuf_pop_n(rb, batch, 4);
+        if (n == 0) sched_yield();
+        for (size_t i = 0; i < n; ++i) atomic_fetch_add(&g_mpmc_sum, batch[i]);
+        atomic_fetch_add(&g_mpmc_popped, n);
+    }
+    return NULL;
+}
+
+static void test_ringbuf_mpmc_no_loss(void) {
+    ttak_ringbuf_t *rb = ttak_ringbuf_create_ex(32, sizeof(uint64_t), TTAK_RINGBUF_MPMC);
+    ASSERT(rb != NULL);
+    atomic_store(&g_mpmc_sum, 0);
+    atomic_store(&g_mpmc_popped, 0);
+    pthread_t threads[2 * MPMC_THREADS];
+    for (int i = 0; i < MPMC_THREADS; ++i) {
+        ASSERT(pthread_create(&threads[i], NULL, mpmc_producer, rb) == 0);
+        ASSERT(pthread_create(&threads[MPMC_THREADS + i], NULL, mpmc_consumer, rb) == 0);
+    }
+    for (int i = 0; i < 2 * MPMC_THREADS; ++i) pthread_join(threads[i], NULL);
+    uint64_t per = (uint64_t)MPMC_PER_THREAD * (MPMC_PER_THREAD + 1) / 2;
+    ASSERT(atomic_load(&g_mpmc_popped) == (size_t)MPMC_THREADS * MPMC_PER_THREAD);
+    ASSERT(atomic_load(&g_mpmc_sum) == per * MPMC_THREADS);
+    ASSERT(ttak_ringbuf_is_empty(rb));
+    ttak_ringbuf_destroy(rb);
+}
+
 int main(void) {
     RUN_TEST(test_ringbuf_push_pop_cycle);
+    RUN_TEST(test_ringbuf_batch_and_slots_every_mode);
+    RUN_TEST(test_ringbuf_spsc_stream_in_order);
+    RUN_TEST(test_ringbuf_mpmc_no_loss);
     return 0;
 }
@@ -2,6 +2,7 @@
 #include "test_macros.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 void test_sha256_basic() {
     SHA256_CTX ctx;
@@ -32,7 +33,69 @@ void test_sha256_basic() {
     ASSERT(memcmp(hash, expected_empty_hash, SHA256_BLOCK_SIZE) == 0);
 }
 
+static void digest_hex(const uint8_t d[SHA256_BLOCK_SIZE], char out[65]) {
+    for (int i = 0; i < SHA256_BLOCK_SIZE; i++) snprintf(out + 2 * i, 3, "%02x", d[i]);
+}
+
+void test_sha256_long_and_chunked(void) {
+    SHA256_CTX ctx;
+    uint8_t hash[SHA256_BLOCK_SIZE];
+    char hex[65];
+
+    /* FIPS 180-4 two-block vector: the padding spills into a second block. */
+    const char *two = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    sha256_init(&ctx);
+    sha256_update(&ctx, (const uint8_t *)two, strlen(two));
+    sha256_final(&ctx, hash);
+    digest_hex(hash, hex);
+    ASSERT(strcmp(hex, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1") == 0);
+
+    /* One million 'a', fed in uneven pieces so whole blocks bypass the buffer. */
+    uint8_t *a = malloc(1000000);
+    ASSERT(a != NULL);
+    memset(a, 'a', 1000000);
+    sha256_init(&ctx);
+    for (size_t off = 0, step = 1; off < 1000000; off += step, step = step * 7 % 1009 + 1) {
+        size_t n = off + step > 1000000 ? 1000000 - off : step;
+        sha256_update(&ctx, a + off, n);
+    }
+    sha256_final(&ctx, hash);
+    digest_hex(hash, hex);
+    ASSERT(strcmp(hex, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0") == 0);
+    free(a);
+}
+
+void test_sha256_hash_many_matches_single(void) {
+    enum { N = 37 };
+    uint8_t buf[1200];
+    for (size_t i = 0; i < sizeof(buf); i++) buf[i] = (uint8_t)(i * 131 + 17);
+
+    /* Lengths straddle the one/two tail-block boundary (55/56) and mix short with long. */
+    const uint8_t *msgs[N];
+    size_t lens[N];
+    uint8_t many[N][SHA256_BLOCK_SIZE];
+    for (int i = 0; i < N; i++) {
+        lens[i] = (i % 5 == 4) ? (size_t)(i * 31) : (size_t)(50 + i % 9);
+        msgs[i] = buf + i;
+    }
+    lens[0] = 0;
+    msgs[0] = NULL;
+    sha256_hash_many(msgs, lens, N, many);
+
+    for (int i = 0; i < N; i++) {
+        SHA256_CTX ctx;
+        uint8_t one[SHA256_BLOCK_SIZE];
+        sha256_init(&ctx);
+        sha256_update(&ctx, msgs[i], lens[i]);
+        sha256_final(&ctx, one);
+        ASSERT_MSG(memcmp(one, many[i], SHA256_BLOCK_SIZE) == 0, "message %d (%zu bytes)", i, lens[i]);
+    }
+    sha256_hash_many(msgs, lens, 0, many);
+}
+
 int main() {
     RUN_TEST(test_sha256_basic);
+    RUN_TEST(test_sha256_long_and_chunked);
+    RUN_TEST(test_sha256_hash_many_matches_single);
     return 0;
 }
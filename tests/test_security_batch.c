@@ -0,0 +1,222 @@
+#include <ttak/security/security_engine.h>
+#include <ttak/net/lattice.h>
+#include <ttak/timing/timing.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_macros.h"
+
+#define BATCH_N 70
+
+static void setup_record(ttak_crypto_ctx_t *ctx, uint8_t key[32], uint8_t *aad, uint8_t *tag,
+                         const uint8_t *in, uint8_t *out, size_t len, size_t r) {
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(r * 7 + i * 13 + 1);
+    for (int i = 0; i < 13; i++) aad[i] = (uint8_t)(r ^ (i * 5));
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->key = key;
+    ctx->key_len = 32;
+    ctx->iv_len = 12;
+    for (int i = 0; i < 12; i++) ctx->iv[i] = (uint8_t)(0xA0 + r + i);
+    ctx->aad = aad;
+    ctx->aad_len = r % 14;
+    ctx->tag = tag;
+    ctx->tag_len = 16;
+    ctx->in = in;
+    ctx->in_len = len;
+    ctx->out = out;
+    ctx->out_len = len;
+}
+
+static size_t record_len(size_t r) {
+    // Mixes empty, sub-block, multi-block and one over-TTAK_CHACHA_BATCH_MAX_BYTES record.
+    if (r == 5) return TTAK_CHACHA_BATCH_MAX_BYTES + 77;
+    return (r * 37) % 300;
+}
+
+static void test_chacha_batch_matches_single(void) {
+    uint64_t now = ttak_get_tick_count();
+    static uint8_t keys[BATCH_N][32], aads[BATCH_N][13], tags[BATCH_N][16], want_tags[BATCH_N][16];
+    ttak_crypto_ctx_t batch[BATCH_N], one;
+    ttak_io_status_t statuses[BATCH_N];
+    uint8_t *pt[BATCH_N], *ct[BATCH_N], *want[BATCH_N];
+
+    for (size_t r = 0; r < BATCH_N; r++) {
+        size_t len = record_len(r);
+        pt[r] = malloc(len + 1);
+        ct[r] = malloc(len + 1);
+        want[r] = malloc(len + 1);
+        ASSERT(pt[r] && ct[r] && want[r]);
+        for (size_t i = 0; i < len; i++) pt[r][i] = (uint8_t)(i * 31 + r);
+
+        uint8_t key[32], aad[13];
+        setup_record(&one, key, aad, want_tags[r], pt[r], want[r], len, r);
+        ASSERT(ttak_security_execute(&one, TTAK_SECURITY_CHACHA20_POLY1305, now) == TTAK_IO_SUCCESS);
+        setup_record(&batch[r], keys[r], aads[r], tags[r], pt[r], ct[r], len, r);
+    }
+
+    ASSERT(ttak_security_execute_batch(batch, BATCH_N, TTAK_SECURITY_CHACHA20_POLY1305,
+                                       statuses, now) == TTAK_IO_SUCCESS);
+    for (size_t r = 0; r < BATCH_N; r++) {
+        ASSERT(statuses[r] == TTAK_IO_SUCCESS);
+        ASSERT_MSG(memcmp(ct[r], want[r], record_len(r)) == 0, "ciphertext of record %zu", r);
+        ASSERT_MSG(memcmp(tags[r], want_tags[r], 16) == 0, "tag of record %zu", r);
+    }
+
+    // A bad record fails alone; its neighbours still seal.
+    batch[3].key_len = 16;
+    memset(tags[4], 0, 16);
+    ASSERT(ttak_security_execute_batch(batch, BATCH_N, TTAK_SECURITY_CHACHA20_POLY1305,
+                                       statuses, now) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(statuses[3] == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(statuses[4] == TTAK_IO_SUCCESS && memcmp(tags[4], want_tags[4], 16) == 0);
+    ASSERT(ttak_security_execute_batch(NULL, 0, TTAK_SECURITY_CHACHA20_POLY1305, NULL, now) ==
+           TTAK_IO_SUCCESS);
+
+    for (size_t r = 0; r < BATCH_N; r++) {
+        free(pt[r]);
+        free(ct[r]);
+        free(want[r]);
+    }
+}
+
+static void test_chacha_batch_in_place_over_lattice(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_net_lattice_t *lat = ttak_net_lattice_create_sized(4, 256, now);
+    ASSERT(lat != NULL);
+    enum { SLOTS = 16 };
+    static uint8_t keys[SLOTS][32], aads[SLOTS][13], tags[SLOTS][16], want_tags[SLOTS][16];
+    ttak_crypto_ctx_t ctxs[SLOTS], one;
+    uint8_t want[SLOTS][256];
+
+    for (size_t r = 0; r < SLOTS; r++) {
+        uint8_t *payload = lat->slots[r].data;
+        size_t len = 16 + r * 15;
+        for (size_t i = 0; i < len; i++) payload[i] = (uint8_t)(r * 3 + i);
+        uint8_t key[32], aad[13];
+        setup_record(&one, key, aad, want_tags[r], payload, want[r], len, r);
+        ASSERT(ttak_chacha20_poly1305_execute(&one, payload, want[r], len) == TTAK_IO_SUCCESS);
+        setup_record(&ctxs[r], keys[r], aads[r], tags[r], payload, payload, len, r);
+    }
+
+    ASSERT(ttak_security_execute_batch(ctxs, SLOTS, TTAK_SECURITY_CHACHA20_POLY1305, NULL, now) ==
+           TTAK_IO_SUCCESS);
+    for (size_t r = 0; r < SLOTS; r++) {
+        ASSERT_MSG(memcmp(lat->slots[r].data, want[r], 16 + r * 15) == 0, "slot %zu", r);
+        ASSERT(memcmp(tags[r], want_tags[r], 16) == 0);
+    }
+    ttak_net_lattice_destroy(lat, now);
+}
+
+static void test_chacha_batch_bulk_records(void) {
+    // Enough large records to cross the accelerator gates, plus a small one and an in-place one;
+    // the result is the same whether or not a GPU backend takes the batch.
+    uint64_t now = ttak_get_tick_count();
+    enum { BULK = 5 };
+    static const size_t lens[BULK] = { (3U << 20) + 17, 100, (2U << 20) + 64, (3U << 20) - 1,
+                                       TTAK_SECURITY_ACCEL_MIN_RECORD_BYTES };
+    static uint8_t keys[BULK][32], aads[BULK][13], tags[BULK][16], want_tags[BULK][16];
+    ttak_crypto_ctx_t batch[BULK], one;
+    ttak_io_status_t statuses[BULK];
+    uint8_t *pt[BULK], *ct[BULK], *want[BULK];
+
+    for (size_t r = 0; r < BULK; r++) {
+        pt[r] = malloc(lens[r]);
+        want[r] = malloc(lens[r]);
+        ASSERT(pt[r] && want[r]);
+        for (size_t i = 0; i < lens[r]; i++) pt[r][i] = (uint8_t)(i * 29 + r * 3);
+        uint8_t key[32], aad[13];
+        setup_record(&one, key, aad, want_tags[r], pt[r], want[r], lens[r], r);
+        ASSERT(ttak_chacha20_poly1305_execute(&one, pt[r], want[r], lens[r]) == TTAK_IO_SUCCESS);
+        ct[r] = r == 3 ? pt[r] : malloc(lens[r]);
+        ASSERT(ct[r] != NULL);
+        setup_record(&batch[r], keys[r], aads[r], tags[r], pt[r], ct[r], lens[r], r);
+    }
+
+    ASSERT(ttak_security_execute_batch(batch, BULK, TTAK_SECURITY_CHACHA20_POLY1305, statuses, now) ==
+           TTAK_IO_SUCCESS);
+    for (size_t r = 0; r < BULK; r++) {
+        ASSERT(statuses[r] == TTAK_IO_SUCCESS);
+        ASSERT_MSG(memcmp(ct[r], want[r], lens[r]) == 0, "ciphertext of record %zu", r);
+        ASSERT_MSG(memcmp(tags[r], want_tags[r], 16) == 0, "tag of record %zu", r);
+    }
+    for (size_t r = 0; r < BULK; r++) {
+        if (ct[r] != pt[r]) free(ct[r]);
+        free(pt[r]);
+        free(want[r]);
+    }
+}
+
+static void test_gcm_batch_matches_single(void) {
+    uint64_t now = ttak_get_tick_count();
+    enum { N = 5 };
+    uint8_t key[32] = { 9 }, pt[N][100], ct[N][100], want[N][100], tags[N][16], want_tag[16];
+    ttak_crypto_ctx_t ctxs[N];
+    ttak_io_status_t statuses[N];
+
+    for (size_t r = 0; r < N; r++) {
+        for (size_t i = 0; i < sizeof(pt[r]); i++) pt[r][i] = (uint8_t)(r + i);
+        ttak_crypto_ctx_t one = { .key = key, .key_len = 32, .iv_len = 12, .tag = want_tag, .tag_len = 16,
+                                  .in = pt[r], .in_len = 20 * r, .out = want[r] };
+        one.iv[0] = (uint8_t)r;
+        ASSERT(ttak_aes256_expand_key(&one) == TTAK_IO_SUCCESS);
+        ASSERT(ttak_security_execute(&one, TTAK_SECURITY_AES_GCM, now) == TTAK_IO_SUCCESS);
+
+        ctxs[r] = one;
+        ctxs[r].tag = tags[r];
+        ctxs[r].out = ct[r];
+        ASSERT(ttak_aes256_expand_key(&ctxs[r]) == TTAK_IO_SUCCESS);
+        ASSERT(ttak_security_execute_batch(&ctxs[r], 1, TTAK_SECURITY_AES_GCM, NULL, now) ==
+               TTAK_IO_SUCCESS);
+        ASSERT(memcmp(ct[r], want[r], 20 * r) == 0 && memcmp(tags[r], want_tag, 16) == 0);
+    }
+    ASSERT(ttak_security_execute_batch(ctxs, N, TTAK_SECURITY_AES_GCM, statuses, now) == TTAK_IO_SUCCESS);
+    for (size_t r = 0; r < N; r++) ASSERT(statuses[r] == TTAK_IO_SUCCESS);
+}
+
+static void test_driver_table(void) {
+    static const ttak_security_op_t supported[] = {
+        TTAK_SECURITY_LEA_ENC, TTAK_SECURITY_SEED_ENC, TTAK_SECURITY_AES_GCM, TTAK_SECURITY_CHACHA20_POLY1305,
+        TTAK_SECURITY_HASH_FAST, TTAK_SECURITY_KDF_HARD, TTAK_SECURITY_LEA_CTR, TTAK_SECURITY_SEED_CTR,
+    };
+    for (int op = 0; op < TTAK_SECURITY_OP_COUNT; op++) {
+        const ttak_security_driver_t *d = ttak_security_pick_driver((ttak_security_op_t)op);
+        ASSERT(d != NULL && d->execute != NULL && d->name != NULL);
+        ASSERT(d->op == (ttak_security_op_t)op && d->lane_width >= 1);
+        ASSERT(ttak_security_pick_driver((ttak_security_op_t)op) == d);
+    }
+    for (size_t i = 0; i < sizeof(supported) / sizeof(supported[0]); i++) {
+        const ttak_security_driver_t *d = ttak_security_pick_driver(supported[i]);
+        ASSERT(strcmp(d->name, "unsupported") != 0);
+        ASSERT(d->lane_width == 1 || d->kind == TTAK_SECURITY_DRIVER_SIMD);
+    }
+
+    const ttak_security_driver_t *none = ttak_security_pick_driver(TTAK_SECURITY_SIGN_PQC);
+    ttak_crypto_ctx_t ctx = {0};
+    ASSERT(strcmp(none->name, "unsupported") == 0);
+    ASSERT(none->execute(&ctx, none) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_security_pick_driver(TTAK_SECURITY_OP_COUNT)->execute(&ctx, NULL) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ASSERT(ttak_security_execute(&ctx, (ttak_security_op_t)99, 0) == TTAK_IO_ERR_INVALID_ARGUMENT);
+
+    // The driver's kernel is what ttak_security_execute() runs.
+    uint8_t key[32] = { 1 }, pt[40] = { 2 }, a[40], b[40], ta[16], tb[16];
+    ttak_crypto_ctx_t x = { .key = key, .key_len = 32, .iv_len = 12, .tag = ta, .tag_len = 16,
+                            .in = pt, .in_len = sizeof(pt), .out = a, .out_len = sizeof(a) };
+    ttak_crypto_ctx_t y = x;
+    y.tag = tb;
+    y.out = b;
+    const ttak_security_driver_t *d = ttak_security_pick_driver(TTAK_SECURITY_CHACHA20_POLY1305);
+    ASSERT(ttak_security_execute(&x, TTAK_SECURITY_CHACHA20_POLY1305, 0) == TTAK_IO_SUCCESS);
+    ASSERT(d->execute(&y, d) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(a, b, sizeof(a)) == 0 && memcmp(ta, tb, 16) == 0);
+}
+
+int main(void) {
+    RUN_TEST(test_driver_table);
+    RUN_TEST(test_chacha_batch_matches_single);
+    RUN_TEST(test_chacha_batch_in_place_over_lattice);
+    RUN_TEST(test_chacha_batch_bulk_records);
+    RUN_TEST(test_gcm_batch_matches_single);
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <ttak/security/seed.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "test_macros.h"
@@ -89,7 +90,107 @@ static void test_seed_vectors(void) {
     run_case(key4, plain4, cipher4);
 }
 
+static size_t hex(const char *s, uint8_t *out) {
+    size_t i = 0;
+    for (; s[2 * i]; i++) {
+        unsigned v;
+        sscanf(s + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+    return i;
+}
+
+static const ttak_security_driver_t scalar_driver = { .name = "scalar", .lane_width = 1 };
+static const ttak_security_driver_t wide_driver = { .name = "wide", .lane_width = 16 };
+
+static void ctr_run(const uint8_t *key, const uint8_t *iv, const uint8_t *in, uint8_t *out, size_t len,
+                    const ttak_security_driver_t *driver, uint8_t *iv_after) {
+    ttak_crypto_ctx_t ctx = { .in = in, .in_len = len, .out = out, .out_len = len, .key = key, .key_len = 16 };
+    memcpy(ctx.iv, iv, 16);
+    ASSERT(ttak_seed_ctr_execute(&ctx, driver) == TTAK_IO_SUCCESS);
+    if (iv_after) memcpy(iv_after, ctx.iv, 16);
+}
+
+static void test_seed_ctr_vector(void) {
+    // The last two counters carry out of the low 64 bits.
+    uint8_t key[16], iv[16], in[37], want[37], out[37], next[16];
+    hex("0f1e2d3c4b5a69788796a5b4c3d2e1f0", key);
+    hex("0011223344556677fffffffffffffffe", iv);
+    hex("6f37eebb7ed2b9545489aa14cfb30b12aea3e45da6d511c9a0c9eb13991cff62b947d1f172", want);
+    for (size_t i = 0; i < sizeof(in); i++) in[i] = (uint8_t)i;
+    ctr_run(key, iv, in, out, sizeof(in), &scalar_driver, next);
+    ASSERT(memcmp(out, want, sizeof(want)) == 0);
+    uint8_t want_next[16];
+    hex("00112233445566780000000000000001", want_next);
+    ASSERT(memcmp(next, want_next, 16) == 0);
+}
+
+static void test_seed_ctr_bitsliced_matches_tables(void) {
+    // Long enough for several full bitsliced batches plus a partial one and a table tail.
+    enum { LEN = 16 * 1200 + 9 };
+    uint8_t *in = malloc(LEN), *ref = malloc(LEN), *got = malloc(LEN);
+    ASSERT(in && ref && got);
+    for (size_t i = 0; i < LEN; i++) in[i] = (uint8_t)(i * 131 + 7);
+    uint8_t key[16], iv[16], iv_ref[16], iv_got[16];
+    for (int i = 0; i < 16; i++) key[i] = (uint8_t)(0xA5 ^ (i * 17));
+    hex("fedcba9876543210fffffffffffffe80", iv);
+
+    ctr_run(key, iv, in, ref, LEN, &scalar_driver, iv_ref);
+    ctr_run(key, iv, in, got, LEN, &wide_driver, iv_got);
+    ASSERT(memcmp(ref, got, LEN) == 0);
+    ASSERT(memcmp(iv_ref, iv_got, 16) == 0);
+
+    // Split calls continue the stream from the advanced counter.
+    uint8_t mid[16];
+    ctr_run(key, iv, in, got, 16 * 700, &wide_driver, mid);
+    ctr_run(key, mid, in + 16 * 700, got + 16 * 700, LEN - 16 * 700, &wide_driver, NULL);
+    ASSERT(memcmp(ref, got, LEN) == 0);
+
+    // In place, and decryption is the same operation.
+    memcpy(got, ref, LEN);
+    ctr_run(key, iv, got, got, LEN, &wide_driver, NULL);
+    ASSERT(memcmp(got, in, LEN) == 0);
+    free(in);
+    free(ref);
+    free(got);
+}
+
+static void test_seed_ctr_rejects_bad_arguments(void) {
+    uint8_t key[16] = {0}, buf[32] = {0};
+    ttak_crypto_ctx_t ctx = { .in = buf, .in_len = 32, .out = buf, .out_len = 32, .key = key, .key_len = 16 };
+    ctx.iv_len = 12;
+    ASSERT(ttak_seed_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ctx.iv_len = 16;
+    ctx.key_len = 32;
+    ASSERT(ttak_seed_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_ERR_RANGE);
+    ctx.key_len = 16;
+    ctx.out_len = 31;
+    ASSERT(ttak_seed_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_ERR_RANGE);
+    ctx.out_len = 32;
+    ctx.out = NULL;
+    ASSERT(ttak_seed_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_ERR_INVALID_ARGUMENT);
+    ctx.in_len = 0;
+    ASSERT(ttak_seed_ctr_execute(&ctx, &scalar_driver) == TTAK_IO_SUCCESS);
+}
+
+static void test_seed_ctr_engine_op(void) {
+    uint8_t key[16], in[100], want[100], got[100];
+    for (int i = 0; i < 16; i++) key[i] = (uint8_t)i;
+    for (int i = 0; i < 100; i++) in[i] = (uint8_t)(3 * i);
+    uint8_t iv[16] = {0};
+    ctr_run(key, iv, in, want, sizeof(in), &scalar_driver, NULL);
+    ttak_crypto_ctx_t ctx = { .in = in, .in_len = sizeof(in), .out = got, .out_len = sizeof(got),
+                              .key = key, .key_len = 16, .iv_len = 16 };
+    ASSERT(ttak_security_execute(&ctx, TTAK_SECURITY_SEED_CTR, 0) == TTAK_IO_SUCCESS);
+    ASSERT(memcmp(got, want, sizeof(got)) == 0);
+    ASSERT(ctx.iv[15] == 7);
+}
+
 int main(void) {
     RUN_TEST(test_seed_vectors);
+    RUN_TEST(test_seed_ctr_vector);
+    RUN_TEST(test_seed_ctr_bitsliced_matches_tables);
+    RUN_TEST(test_seed_ctr_rejects_bad_arguments);
+    RUN_TEST(test_seed_ctr_engine_op);
     return 0;
 }
@@ -12,6 +12,8 @@
  *     queued into a different shard.
  *  6. The sharded scheduler history produces correct priority adjustments
  *     while accepting concurrent access from multiple threads.
+ *  7. Generated routing tables keep the Latin property up to
+ *     TTAK_POOL_SHARD_MAX, and pools size their shard set from num_threads.
  */
 
 #include <ttak/thread/pool.h>
@@ -24,6 +26,7 @@
 #include <stddef.h>
 #include <string.h>
 #include <unistd.h>
+#include <pthread.h>
 #include "test_macros.h"
 
 /* Pull in the internal header so we can validate the mapping functions directly. */
@@ -243,6 +246,51 @@ void test_sharded_scheduler_history(void) {
     ttak_task_destroy(t_long,  now);
 }
 
+#define HIST_THREADS 4
+#define HIST_HASHES  (TTAK_SCHED_HISTORY_SLOTS * 4)
+
+static void *history_writer(void *arg) {
+    uintptr_t id = (uintptr_t)arg;
+    ttak_task_t *task = ttak_task_create(dummy_short_fn, NULL, NULL, ttak_get_tick_count());
+    ASSERT(task != NULL);
+    for (uint64_t i = 0; i < HIST_HASHES; i++) {
+        /* Shared hot key plus a stream of per-thread unique keys. */
+        ttak_task_set_hash(task, 0xC0FFEEULL);
+        ttak_scheduler_record_execution(task, 40);
+        ttak_task_set_hash(task, ((uint64_t)id << 40) | (i + 1));
+        ttak_scheduler_record_execution(task, 3000);
+    }
+    ttak_task_destroy(task, ttak_get_tick_count());
+    return NULL;
+}
+
+/**
+ * Far more distinct hashes than slots: the table stays fixed, evicts, and
+ * concurrent updates of one hot key still converge on its duration.
+ */
+void test_scheduler_history_table_bounded(void) {
+    pthread_t threads[HIST_THREADS];
+    for (uintptr_t t = 0; t < HIST_THREADS; t++) {
+        ASSERT(pthread_create(&threads[t], NULL, history_writer, (void *)(t + 1)) == 0);
+    }
+    for (int t = 0; t < HIST_THREADS; t++) pthread_join(threads[t], NULL);
+
+    uint64_t avg = 0;
+    ASSERT(ttak_scheduler_history_get(0xC0FFEEULL, &avg));
+    ASSERT_MSG(avg >= 38 && avg <= 40, "hot key EWMA %llu should settle at 40", (unsigned long long)avg);
+
+    /* The most recent unique key of some thread survives eviction. */
+    int recent = 0;
+    for (uint64_t t = 1; t <= HIST_THREADS; t++) {
+        if (ttak_scheduler_history_get((t << 40) | HIST_HASHES, &avg)) {
+            ASSERT(avg == 3000);
+            recent++;
+        }
+    }
+    ASSERT(recent > 0);
+    ASSERT(!ttak_scheduler_history_get(0, NULL));
+}
+
 /* -------------------------------------------------------------------------
  * 7. Worker affinity assignment mirrors ttak_shard_for_worker().
  * ---------------------------------------------------------------------- */
@@ -262,14 +310,125 @@ void test_worker_shard_affinity(void) {
     ttak_thread_pool_destroy(pool);
 }
 
+/* -------------------------------------------------------------------------
+ * 8. Generated tables: Latin for every order, identical to the 8×8 default.
+ * ---------------------------------------------------------------------- */
+static uint8_t generated_route[TTAK_POOL_SHARD_MAX * TTAK_POOL_SHARD_MAX];
+
+void test_generated_route_tables(void) {
+    ttak_shard_route_build(generated_route, TTAK_POOL_SHARD_LOG2);
+    for (size_t r = 0; r < TTAK_POOL_SHARD_COUNT; r++) {
+        for (size_t c = 0; c < TTAK_POOL_SHARD_COUNT; c++) {
+            ASSERT(generated_route[r * TTAK_POOL_SHARD_COUNT + c] == shard_route_table[r][c]);
+        }
+    }
+
+    for (uint32_t log2 = TTAK_POOL_SHARD_LOG2; ((size_t)1 << log2) <= TTAK_POOL_SHARD_MAX; log2++) {
+        size_t n = (size_t)1 << log2;
+        ttak_shard_route_build(generated_route, log2);
+        for (size_t r = 0; r < n; r++) {
+            uint8_t row_seen[TTAK_POOL_SHARD_MAX] = {0};
+            uint8_t col_seen[TTAK_POOL_SHARD_MAX] = {0};
+            for (size_t c = 0; c < n; c++) {
+                uint8_t v = generated_route[r * n + c];
+                uint8_t w = generated_route[c * n + r];
+                ASSERT_MSG(v < n && !row_seen[v], "order %zu row %zu: bad shard %u", n, r, v);
+                ASSERT_MSG(w < n && !col_seen[w], "order %zu col %zu: bad shard %u", n, r, w);
+                row_seen[v] = col_seen[w] = 1;
+            }
+        }
+
+        /* Sequential hashes must reach every shard of the larger orders too. */
+        uint8_t hit[TTAK_POOL_SHARD_MAX] = {0};
+        size_t distinct = 0;
+        for (uint64_t h = 1; h <= 64 * n; h++) {
+            size_t s = ttak_shard_for_hash_n(generated_route, log2, h);
+            ASSERT(s < n);
+            if (!hit[s]) { hit[s] = 1; distinct++; }
+        }
+        ASSERT_MSG(distinct == n, "order %zu: only %zu shards reached", n, distinct);
+    }
+}
+
+void test_shard_count_for_threads(void) {
+    uint32_t log2 = 0;
+    ASSERT(ttak_shard_count_for_threads(1, &log2) == TTAK_POOL_SHARD_COUNT && log2 == TTAK_POOL_SHARD_LOG2);
+    ASSERT(ttak_shard_count_for_threads(16, NULL) == 8);
+    ASSERT(ttak_shard_count_for_threads(17, NULL) == 16);
+    ASSERT(ttak_shard_count_for_threads(128, &log2) == 64 && log2 == 6);
+    ASSERT(ttak_shard_count_for_threads(100000, &log2) == TTAK_POOL_SHARD_MAX && log2 == 8);
+}
+
+void test_shard_group_ranges(void) {
+    size_t lo, hi;
+    /* Groups tile the shards contiguously and evenly. */
+    for (size_t groups = 1; groups <= 8; groups++) {
+        size_t next = 0;
+        for (size_t g = 0; g < groups; g++) {
+            ttak_shard_group_range(32, groups, g, &lo, &hi);
+            ASSERT(lo == next && hi > lo);
+            ASSERT(hi - lo >= 32 / groups && hi - lo <= 32 / groups + 1);
+            next = hi;
+        }
+        ASSERT(next == 32);
+    }
+    /* More groups than shards: one shard each, wrapping. */
+    ttak_shard_group_range(8, 12, 9, &lo, &hi);
+    ASSERT(lo == 1 && hi == 2);
+    ttak_shard_group_range(8, 0, 0, &lo, &hi);
+    ASSERT(lo == 0 && hi == 8);
+}
+
+static _Atomic int wide_counter = 0;
+
+void *wide_task(void *arg) {
+    (void)arg;
+    wide_counter++;
+    return NULL;
+}
+
+void test_pool_wide_shards(void) {
+    uint64_t now = ttak_get_tick_count();
+    const size_t N = 64;
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(N, 0, now);
+    ASSERT(pool != NULL);
+    ASSERT(pool->shard_count == 32);
+    ASSERT(((size_t)1 << pool->shard_log2) == pool->shard_count);
+    for (size_t i = 0; i < N; i++) {
+        ASSERT(pool->workers[i]->preferred_shard == (i & 31));
+    }
+
+    wide_counter = 0;
+    ttak_future_t *futures[128];
+    for (int i = 0; i < 128; i++) {
+        ttak_promise_t *promise = ttak_promise_create(now);
+        ASSERT(promise != NULL);
+        ttak_task_t *ct = ttak_task_create(wide_task, NULL, promise, now);
+        ASSERT(ct != NULL);
+        ttak_task_set_hash(ct, (uint64_t)i + 1);
+        ASSERT(ttak_thread_pool_schedule_task(pool, ct, 0, now));
+        futures[i] = ttak_promise_get_future(promise);
+    }
+    for (int i = 0; i < 128; i++) {
+        ttak_future_get(futures[i]);
+    }
+    ASSERT(wide_counter == 128);
+    ttak_thread_pool_destroy(pool);
+}
+
 int main(void) {
     RUN_TEST(test_route_table_bounds);
     RUN_TEST(test_shard_mapping_deterministic);
     RUN_TEST(test_latin_square_property);
     RUN_TEST(test_worker_shard_affinity);
     RUN_TEST(test_sharded_scheduler_history);
+    RUN_TEST(test_scheduler_history_table_bounded);
     RUN_TEST(test_pool_sharded_routing);
     RUN_TEST(test_pool_sharded_routing_net_urgency);
     RUN_TEST(test_work_stealing);
+    RUN_TEST(test_generated_route_tables);
+    RUN_TEST(test_shard_count_for_threads);
+    RUN_TEST(test_shard_group_ranges);
+    RUN_TEST(test_pool_wide_shards);
     return 0;
 }
@@ -1,31 +1,32 @@
 #include <ttak/shared/shared.h>
 #include <ttak/mem/owner.h>
 #include <stdio.h>
-#include <assert.h>
 #include <string.h>
+#include <pthread.h>
+#include "test_macros.h"
 
 void test_shared_basic(void) {
     ttak_shared_t shared;
     ttak_shared_init(&shared);
 
     ttak_shared_result_t res = shared.allocate_typed(&shared, sizeof(int), "int", TTAK_SHARED_LEVEL_3);
-    assert(res == TTAK_OWNER_SUCCESS);
-    assert(strcmp(shared.type_name, "int") == 0);
+    ASSERT(res == TTAK_OWNER_SUCCESS);
+    ASSERT(strcmp(shared.type_name, "int") == 0);
 
     ttak_owner_t *owner1 = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
     ttak_owner_t *owner2 = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
 
     res = shared.add_owner(&shared, owner1);
-    assert(res == TTAK_OWNER_SUCCESS);
+    ASSERT(res == TTAK_OWNER_SUCCESS);
 
     res = shared.add_owner(&shared, owner2);
-    assert(res == TTAK_OWNER_SUCCESS);
+    ASSERT(res == TTAK_OWNER_SUCCESS);
 
     /* Test access */
     ttak_shared_result_t access_res;
     int *data = tt_shared_access(int, &shared, owner1, &access_res);
-    assert(data != NULL);
-    assert(access_res == TTAK_OWNER_SUCCESS);
+    ASSERT(data != NULL);
+    ASSERT(access_res == TTAK_OWNER_SUCCESS);
 
     *data = 42;
     shared.release(&shared);
@@ -33,13 +34,13 @@ void test_shared_basic(void) {
     /* Test sync and access from another owner */
     int affected = 0;
     res = shared.sync_all(&shared, owner1, &affected);
-    assert(res == TTAK_OWNER_SUCCESS);
-    assert(affected == 2);
+    ASSERT(res == TTAK_OWNER_SUCCESS);
+    ASSERT(affected == 2);
 
     const int *data2 = tt_shared_access(const int, &shared, owner2, &access_res);
-    assert(data2 != NULL);
-    assert(access_res == TTAK_OWNER_SUCCESS);
-    assert(*data2 == 42);
+    ASSERT(data2 != NULL);
+    ASSERT(access_res == TTAK_OWNER_SUCCESS);
+    ASSERT(*data2 == 42);
     shared.release(&shared);
 
     /* Cleanup */
@@ -50,7 +51,86 @@ void test_shared_basic(void) {
     printf("test_shared_basic passed!\n");
 }
 
+typedef struct {
+    uint64_t version;
+    uint64_t check;
+} route_table_t;
+
+typedef struct {
+    ttak_shared_t *shared;
+    ttak_owner_t *owner;
+    _Atomic int *stop;
+    uint64_t reads;
+    int torn;
+} reader_arg_t;
+
+static void *read_mostly_reader(void *p) {
+    reader_arg_t *a = p;
+    while (!atomic_load_explicit(a->stop, memory_order_relaxed)) {
+        ttak_shared_result_t res;
+        const route_table_t *t = ttak_shared_read(a->shared, a->owner, &res);
+        if (t) {
+            if (res != TTAK_OWNER_SUCCESS || t->check != ~t->version) a->torn++;
+            ttak_shared_read_end(a->shared);
+            a->reads++;
+        }
+    }
+    ttak_epoch_deregister_thread();
+    return NULL;
+}
+
+void test_shared_read_mostly(void) {
+    ttak_shared_t shared;
+    ttak_shared_init(&shared);
+    ASSERT(shared.allocate_typed(&shared, sizeof(route_table_t), "route_table_t", TTAK_SHARED_LEVEL_3) == TTAK_OWNER_SUCCESS);
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ttak_owner_t *stranger = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(shared.add_owner(&shared, owner) == TTAK_OWNER_SUCCESS);
+    ASSERT(shared.set_read_mostly(&shared, true) == TTAK_OWNER_SUCCESS);
+    ASSERT(shared.set_reclaim_mode(&shared, TTAK_RECLAIM_HAZARD) == TTAK_OWNER_INVALID);
+
+    route_table_t t = { 0, ~0ULL };
+    ASSERT(ttak_shared_swap_ebr(&shared, &t, sizeof(t)) == TTAK_OWNER_SUCCESS);
+    ASSERT((shared.status & TTAK_SHARED_DIRTY) == 0);
+
+    ttak_shared_result_t res;
+    ASSERT(ttak_shared_read(&shared, stranger, &res) == NULL && res == TTAK_OWNER_INVALID);
+    const route_table_t *r = ttak_shared_read(&shared, owner, &res);
+    ASSERT(r && res == TTAK_OWNER_SUCCESS && r->check == ~r->version);
+    ttak_shared_read_end(&shared);
+
+    /* Readers never see a half-written table while a writer keeps publishing. */
+    _Atomic int stop = 0;
+    enum { READERS = 3 };
+    pthread_t th[READERS];
+    reader_arg_t args[READERS];
+    for (int i = 0; i < READERS; i++) {
+        args[i] = (reader_arg_t){ &shared, owner, &stop, 0, 0 };
+        pthread_create(&th[i], NULL, read_mostly_reader, &args[i]);
+    }
+    for (uint64_t v = 1; v <= 2000; v++) {
+        t.version = v;
+        t.check = ~v;
+        ASSERT(ttak_shared_swap_ebr(&shared, &t, sizeof(t)) == TTAK_OWNER_SUCCESS);
+    }
+    atomic_store(&stop, 1);
+    for (int i = 0; i < READERS; i++) {
+        pthread_join(th[i], NULL);
+        ASSERT(args[i].torn == 0);
+    }
+    r = ttak_shared_read(&shared, owner, &res);
+    ASSERT(r && r->version == 2000);
+    ttak_shared_read_end(&shared);
+
+    ttak_epoch_reclaim();
+    ttak_owner_destroy(owner);
+    ttak_owner_destroy(stranger);
+    ttak_shared_destroy(&shared);
+    printf("test_shared_read_mostly passed!\n");
+}
+
 int main(void) {
     test_shared_basic();
+    test_shared_read_mostly();
     return 0;
 }
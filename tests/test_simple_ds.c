@@ -1,7 +1,10 @@
 #include "test_macros.h"
 #include <ttak/priority/simple.h>
 #include <ttak/priority/nice.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdint.h>
+#include <stdlib.h>
 
 void test_simple_queue() {
     ttak_simple_queue_t q;
@@ -55,6 +58,121 @@ void test_simple_stack() {
     ttak_simple_stack_destroy(&s, now);
 }
 
+#define MPMC_PER_PRODUCER 20000
+#define MPMC_PRODUCERS 2
+
+typedef struct {
+    ttak_simple_mpmc_queue_t *q;
+    ttak_simple_mpmc_stack_t *s;
+    uintptr_t id;
+    _Atomic int *seen;
+    _Atomic int *taken;
+    int order_ok;
+} mpmc_arg_t;
+
+static void *mpmc_queue_producer(void *p) {
+    mpmc_arg_t *a = p;
+    for (uintptr_t i = 0; i < MPMC_PER_PRODUCER; i++) {
+        while (!ttak_simple_mpmc_queue_push(a->q, (void *)((a->id << 32) | (i + 1)))) sched_yield();
+    }
+    return NULL;
+}
+
+static void *mpmc_queue_consumer(void *p) {
+    mpmc_arg_t *a = p;
+    uintptr_t last[MPMC_PRODUCERS] = {0};
+    a->order_ok = 1;
+    while (atomic_load(a->taken) < MPMC_PRODUCERS * MPMC_PER_PRODUCER) {
+        void *v;
+        if (!ttak_simple_mpmc_queue_pop(a->q, &v)) {
+            sched_yield();
+            continue;
+        }
+        uintptr_t id = (uintptr_t)v >> 32, seq = (uintptr_t)v & 0xffffffffu;
+        if (seq <= last[id]) a->order_ok = 0;
+        last[id] = seq;
+        atomic_fetch_add(&a->seen[id * MPMC_PER_PRODUCER + seq - 1], 1);
+        atomic_fetch_add(a->taken, 1);
+    }
+    return NULL;
+}
+
+void test_mpmc_queue() {
+    ttak_simple_mpmc_queue_t q;
+    ASSERT(ttak_simple_mpmc_queue_init(&q));
+    void *v;
+    ASSERT(!ttak_simple_mpmc_queue_pop(&q, &v));
+    int a = 1, b = 2;
+    ASSERT(ttak_simple_mpmc_queue_push(&q, &a));
+    ASSERT(ttak_simple_mpmc_queue_push(&q, &b));
+    ASSERT(ttak_simple_mpmc_queue_size(&q) == 2);
+    ASSERT(ttak_simple_mpmc_queue_pop(&q, &v) && v == &a);
+    ASSERT(ttak_simple_mpmc_queue_pop(&q, &v) && v == &b);
+
+    _Atomic int *seen = calloc(MPMC_PRODUCERS * MPMC_PER_PRODUCER, sizeof(*seen));
+    _Atomic int taken = 0;
+    pthread_t th[4];
+    mpmc_arg_t args[4];
+    for (int i = 0; i < 4; i++) {
+        args[i] = (mpmc_arg_t){ .q = &q, .id = (uintptr_t)(i % MPMC_PRODUCERS), .seen = seen, .taken = &taken };
+        pthread_create(&th[i], NULL, i < MPMC_PRODUCERS ? mpmc_queue_producer : mpmc_queue_consumer, &args[i]);
+    }
+    for (int i = 0; i < 4; i++) pthread_join(th[i], NULL);
+
+    for (int i = MPMC_PRODUCERS; i < 4; i++) ASSERT(args[i].order_ok);
+    for (int i = 0; i < MPMC_PRODUCERS * MPMC_PER_PRODUCER; i++) ASSERT(atomic_load(&seen[i]) == 1);
+    ASSERT(ttak_simple_mpmc_queue_size(&q) == 0);
+
+    // Leftover nodes are released by destroy.
+    ttak_simple_mpmc_queue_push(&q, &a);
+    ttak_simple_mpmc_queue_destroy(&q);
+    free(seen);
+}
+
+static void *mpmc_stack_worker(void *p) {
+    mpmc_arg_t *a = p;
+    for (uintptr_t i = 0; i < MPMC_PER_PRODUCER; i++) {
+        while (!ttak_simple_mpmc_stack_push(a->s, (void *)((a->id << 32) | (i + 1)))) sched_yield();
+        void *v;
+        if (ttak_simple_mpmc_stack_pop(a->s, &v)) {
+            uintptr_t id = (uintptr_t)v >> 32, seq = (uintptr_t)v & 0xffffffffu;
+            atomic_fetch_add(&a->seen[id * MPMC_PER_PRODUCER + seq - 1], 1);
+        }
+    }
+    return NULL;
+}
+
+void test_mpmc_stack() {
+    ttak_simple_mpmc_stack_t s;
+    ASSERT(ttak_simple_mpmc_stack_init(&s));
+    int a = 1, b = 2;
+    void *v;
+    ASSERT(!ttak_simple_mpmc_stack_pop(&s, &v));
+    ASSERT(ttak_simple_mpmc_stack_push(&s, &a));
+    ASSERT(ttak_simple_mpmc_stack_push(&s, &b));
+    ASSERT(ttak_simple_mpmc_stack_pop(&s, &v) && v == &b);
+    ASSERT(ttak_simple_mpmc_stack_pop(&s, &v) && v == &a);
+
+    enum { WORKERS = 4 };
+    _Atomic int *seen = calloc(WORKERS * MPMC_PER_PRODUCER, sizeof(*seen));
+    pthread_t th[WORKERS];
+    mpmc_arg_t args[WORKERS];
+    for (int i = 0; i < WORKERS; i++) {
+        args[i] = (mpmc_arg_t){ .s = &s, .id = (uintptr_t)i, .seen = seen };
+        pthread_create(&th[i], NULL, mpmc_stack_worker, &args[i]);
+    }
+    for (int i = 0; i < WORKERS; i++) pthread_join(th[i], NULL);
+
+    while (ttak_simple_mpmc_stack_pop(&s, &v)) {
+        uintptr_t id = (uintptr_t)v >> 32, seq = (uintptr_t)v & 0xffffffffu;
+        atomic_fetch_add(&seen[id * MPMC_PER_PRODUCER + seq - 1], 1);
+    }
+    for (int i = 0; i < WORKERS * MPMC_PER_PRODUCER; i++) ASSERT(atomic_load(&seen[i]) == 1);
+    ASSERT(ttak_simple_mpmc_stack_size(&s) == 0);
+    ttak_simple_mpmc_stack_destroy(&s);
+    free(seen);
+}
+
 void test_nice_utils() {
     // Test lock_priority
     ASSERT(ttak_lock_priority(-20) == 0); 
@@ -76,6 +194,8 @@ void test_nice_utils() {
 int main() {
     RUN_TEST(test_simple_queue);
     RUN_TEST(test_simple_stack);
+    RUN_TEST(test_mpmc_queue);
+    RUN_TEST(test_mpmc_stack);
     RUN_TEST(test_nice_utils);
     return 0;
 }
@@ -0,0 +1,54 @@
+#include <ttak/security/siphash.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+/* Reference key 00..0f and messages 00, 01, ..., as in the SipHash paper. */
+static const uint64_t k0 = 0x0706050403020100ULL;
+static const uint64_t k1 = 0x0f0e0d0c0b0a0908ULL;
+
+static void test_siphash_vectors(void) {
+    uint8_t msg[64];
+    for (int i = 0; i < 64; i++) msg[i] = (uint8_t)i;
+    ASSERT(ttak_siphash24(msg, 15, k0, k1) == 0xa129ca6149be45e5ULL);
+
+    static const struct {
+        size_t len;
+        uint64_t want;
+    } cases[] = {
+        { 0, 0xabac0158050fc4dcULL },  { 1, 0xc9f49bf37d57ca93ULL },  { 7, 0xd3927d989bb11140ULL },
+        { 8, 0x369095118d299a8eULL },  { 15, 0xd320d86d2a519956ULL }, { 16, 0xcc4fdd1a7d908b66ULL },
+        { 63, 0x9d199062b7bbb3a8ULL },
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        ASSERT_MSG(ttak_siphash13(msg, cases[c].len, k0, k1) == cases[c].want, "SipHash-1-3 of %zu bytes",
+                   cases[c].len);
+    }
+}
+
+static void test_siphash13_batch_matches_single(void) {
+    // Groups of four with equal, mixed and very uneven lengths, and a short tail.
+    enum { N = 4 * 9 + 3 };
+    static uint8_t buf[N][200];
+    const void *keys[N];
+    size_t lens[N];
+    uint64_t out[N];
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < sizeof(buf[i]); j++) buf[i][j] = (uint8_t)(i * 31 + j * 7);
+        keys[i] = buf[i];
+        lens[i] = i < 8 ? 16 : (i * 37) % 200;
+    }
+    lens[20] = 0;
+    lens[21] = 199;
+    ttak_siphash13_batch(keys, lens, N, k0, k1, out);
+    for (size_t i = 0; i < N; i++) {
+        ASSERT_MSG(out[i] == ttak_siphash13(keys[i], lens[i], k0, k1), "key %zu (%zu bytes)", i, lens[i]);
+    }
+    ttak_siphash13_batch(keys, lens, 0, k0, k1, NULL);
+}
+
+int main(void) {
+    RUN_TEST(test_siphash_vectors);
+    RUN_TEST(test_siphash13_batch_matches_single);
+    return 0;
+}
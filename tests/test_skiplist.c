@@ -0,0 +1,188 @@
+#include <ttak/container/skiplist.h>
+#include <ttak/mem/epoch.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+#define SL_KEYS 20000
+#define KEYS_PER_WRITER 4096
+#define POP_KEYS 20000
+
+static uintptr_t value_of(uint64_t key) { return (uintptr_t)(key * 3 + 1); }
+
+typedef struct {
+    uint64_t last;
+    size_t count;
+    bool ok;
+} order_ctx_t;
+
+static bool check_order(uint64_t key, uintptr_t value, void *p) {
+    order_ctx_t *c = p;
+    if ((c->count && key <= c->last) || value != value_of(key)) c->ok = false;
+    c->last = key;
+    c->count++;
+    return true;
+}
+
+static void test_skiplist_basic(void) {
+    ttak_skiplist_t list;
+    ASSERT(ttak_skiplist_init(&list));
+    uintptr_t v = 0;
+    ASSERT(!ttak_skiplist_get(&list, 42, &v));
+    ASSERT(ttak_skiplist_put(&list, 42, 7));
+    ASSERT(ttak_skiplist_get(&list, 42, &v) && v == 7);
+    ASSERT(ttak_skiplist_put(&list, 42, 8));
+    ASSERT(ttak_skiplist_get(&list, 42, &v) && v == 8);
+    ASSERT(ttak_skiplist_size(&list) == 1);
+    ASSERT(ttak_skiplist_remove(&list, 42));
+    ASSERT(!ttak_skiplist_remove(&list, 42));
+    ASSERT(!ttak_skiplist_get(&list, 42, NULL));
+
+    for (uint64_t i = 0; i < SL_KEYS; i++) {
+        uint64_t k = (i * 7919) % SL_KEYS * 2;
+        ASSERT(ttak_skiplist_put(&list, k, value_of(k)));
+    }
+    ASSERT(ttak_skiplist_size(&list) == SL_KEYS);
+    for (uint64_t k = 0; k < 2 * SL_KEYS; k++) ASSERT(ttak_skiplist_get(&list, k, &v) == ((k & 1) == 0));
+
+    order_ctx_t c = { 0, 0, true };
+    ASSERT(ttak_skiplist_range(&list, 0, UINT64_MAX, check_order, &c) == SL_KEYS);
+    ASSERT(c.ok && c.last == 2 * (SL_KEYS - 1));
+    c = (order_ctx_t){ 0, 0, true };
+    ASSERT(ttak_skiplist_range(&list, 101, 2001, check_order, &c) == 950);
+    ASSERT(c.ok);
+
+    /* Fingers give the same answers as fresh searches, ascending or not. */
+    ttak_epoch_enter();
+    ttak_skiplist_finger_t f;
+    ttak_skiplist_finger_init(&list, &f);
+    for (uint64_t k = 0; k < 2 * SL_KEYS; k += 3) {
+        ASSERT(ttak_skiplist_get_finger(&list, &f, k, &v) == ((k & 1) == 0));
+        if ((k & 1) == 0) ASSERT(v == value_of(k));
+    }
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint64_t k = (i * 104729) % (2 * SL_KEYS);
+        ASSERT(ttak_skiplist_get_finger(&list, &f, k, NULL) == ((k & 1) == 0));
+    }
+    ttak_epoch_exit();
+
+    /* Bulk expiry of a key range, then the smallest keys in order. */
+    ASSERT(ttak_skiplist_remove_range(&list, 0, 9999) == 5000);
+    ASSERT(ttak_skiplist_size(&list) == SL_KEYS - 5000);
+    ASSERT(!ttak_skiplist_get(&list, 9998, NULL) && ttak_skiplist_get(&list, 10000, NULL));
+    uint64_t k;
+    for (uint64_t want = 10000; want < 10100; want += 2) {
+        ASSERT(ttak_skiplist_pop_min(&list, &k, &v) && k == want && v == value_of(want));
+    }
+    ASSERT(ttak_skiplist_remove_range(&list, 0, UINT64_MAX) == SL_KEYS - 5050);
+    ASSERT(!ttak_skiplist_pop_min(&list, &k, &v));
+    ASSERT(ttak_skiplist_size(&list) == 0);
+    ttak_skiplist_destroy(&list);
+    ttak_epoch_reclaim();
+}
+
+static ttak_skiplist_t g_list;
+static _Atomic int g_stop;
+static _Atomic int g_bad;
+
+/* Writers interleave keys so they fight over the same towers. */
+static void *writer_main(void *p) {
+    uint64_t id = (uint64_t)(uintptr_t)p;
+    for (int round = 0; round < 8; round++) {
+        for (uint64_t k = 0; k < KEYS_PER_WRITER; k++) ttak_skiplist_put(&g_list, 2 * k + id, value_of(2 * k + id));
+        for (uint64_t k = 0; k < KEYS_PER_WRITER; k += 1 + (round & 1)) ttak_skiplist_remove(&g_list, 2 * k + id);
+        sched_yield();
+    }
+    for (uint64_t k = 0; k < KEYS_PER_WRITER; k++) ttak_skiplist_put(&g_list, 2 * k + id, value_of(2 * k + id));
+    return NULL;
+}
+
+static void *reader_main(void *p) {
+    (void)p;
+    uint64_t k = 0;
+    while (!atomic_load(&g_stop)) {
+        for (int i = 0; i < 256; i++, k = (k + 7) % (2 * KEYS_PER_WRITER)) {
+            uintptr_t v;
+            if (ttak_skiplist_get(&g_list, k, &v) && v != value_of(k)) atomic_fetch_add(&g_bad, 1);
+        }
+        order_ctx_t c = { 0, 0, true };
+        ttak_skiplist_range(&g_list, k, k + 300, check_order, &c);
+        if (!c.ok) atomic_fetch_add(&g_bad, 1);
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void test_skiplist_concurrent(void) {
+    ASSERT(ttak_skiplist_init(&g_list));
+    atomic_store(&g_stop, 0);
+    atomic_store(&g_bad, 0);
+
+    pthread_t readers[2], writers[2];
+    for (int i = 0; i < 2; i++) pthread_create(&readers[i], NULL, reader_main, NULL);
+    for (uintptr_t i = 0; i < 2; i++) pthread_create(&writers[i], NULL, writer_main, (void *)i);
+    for (int i = 0; i < 2; i++) pthread_join(writers[i], NULL);
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < 2; i++) pthread_join(readers[i], NULL);
+
+    ASSERT(atomic_load(&g_bad) == 0);
+    ASSERT(ttak_skiplist_size(&g_list) == 2 * KEYS_PER_WRITER);
+    order_ctx_t c = { 0, 0, true };
+    ASSERT(ttak_skiplist_range(&g_list, 0, UINT64_MAX, check_order, &c) == 2 * KEYS_PER_WRITER);
+    ASSERT(c.ok);
+    ttak_skiplist_destroy(&g_list);
+    ttak_epoch_reclaim();
+}
+
+static _Atomic uint8_t popped[POP_KEYS];
+
+static void *consumer_main(void *p) {
+    (void)p;
+    uint64_t k;
+    uintptr_t v;
+    while (!atomic_load(&g_stop) || ttak_skiplist_size(&g_list)) {
+        if (!ttak_skiplist_pop_min(&g_list, &k, &v)) {
+            sched_yield();
+            continue;
+        }
+        if (k >= POP_KEYS || v != value_of(k) || atomic_fetch_add(&popped[k], 1) != 0) atomic_fetch_add(&g_bad, 1);
+    }
+    return NULL;
+}
+
+static void *producer_main(void *p) {
+    uint64_t id = (uint64_t)(uintptr_t)p;
+    for (uint64_t k = id; k < POP_KEYS; k += 2) {
+        ttak_skiplist_put(&g_list, k, value_of(k));
+        if ((k & 255) == id) sched_yield();
+    }
+    return NULL;
+}
+
+/* Every key is popped exactly once while producers and consumers overlap. */
+static void test_skiplist_pop_concurrent(void) {
+    ASSERT(ttak_skiplist_init(&g_list));
+    atomic_store(&g_stop, 0);
+    atomic_store(&g_bad, 0);
+    pthread_t producers[2], consumers[2];
+    for (int i = 0; i < 2; i++) pthread_create(&consumers[i], NULL, consumer_main, NULL);
+    for (uintptr_t i = 0; i < 2; i++) pthread_create(&producers[i], NULL, producer_main, (void *)i);
+    for (int i = 0; i < 2; i++) pthread_join(producers[i], NULL);
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < 2; i++) pthread_join(consumers[i], NULL);
+
+    ASSERT(atomic_load(&g_bad) == 0);
+    for (int k = 0; k < POP_KEYS; k++) ASSERT(atomic_load(&popped[k]) == 1);
+    ASSERT(ttak_skiplist_size(&g_list) == 0);
+    ttak_skiplist_destroy(&g_list);
+    ttak_epoch_reclaim();
+}
+
+int main(void) {
+    RUN_TEST(test_skiplist_basic);
+    RUN_TEST(test_skiplist_concurrent);
+    RUN_TEST(test_skiplist_pop_concurrent);
+    return 0;
+}
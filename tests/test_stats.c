@@ -1,21 +1,204 @@
 #include <ttak/stats/stats.h>
+#include <ttak/stats/stats_ext.h>
+#include <ttak/timing/timing.h>
+#include <pthread.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 #include "test_macros.h"
 
 static void test_stats_accumulates_basic_metrics(void) {
-    ttak_stats_t stats;
+    static ttak_stats_t stats;
     ttak_stats_init(&stats, 0, 100);
 
     ttak_stats_record(&stats, 10);
     ttak_stats_record(&stats, 20);
     ttak_stats_record(&stats, 30);
 
-    ASSERT(stats.count == 3);
-    ASSERT(stats.min == 10);
-    ASSERT(stats.max == 30);
+    static ttak_stats_snapshot_t snap;
+    ttak_stats_snapshot(&stats, &snap);
+    ASSERT(snap.count == 3);
+    ASSERT(snap.min == 10);
+    ASSERT(snap.max == 30);
     ASSERT(ttak_stats_mean(&stats) == 20.0);
 }
 
+static void test_stats_log_linear_buckets(void) {
+    /* Small values are exact; every bucket is at most 1/16 of its value wide. */
+    for (uint64_t v = 0; v < TTAK_STATS_SUB_BUCKETS; ++v) {
+        ASSERT(ttak_stats_bucket_of(v) == v);
+    }
+    size_t prev = 0;
+    for (uint64_t v = 1; v < (1ULL << 20); v += 1 + v / 97) {
+        size_t b = ttak_stats_bucket_of(v);
+        ASSERT(b >= prev);
+        ASSERT(ttak_stats_bucket_lower(b) <= v);
+        ASSERT(b + 1 == TTAK_STATS_HIST_BUCKETS || ttak_stats_bucket_lower(b + 1) > v);
+        ASSERT(v - ttak_stats_bucket_lower(b) <= v / TTAK_STATS_SUB_BUCKETS);
+        prev = b;
+    }
+    ASSERT(ttak_stats_bucket_of(UINT64_MAX) == TTAK_STATS_HIST_BUCKETS - 1);
+}
+
+static void test_stats_tail_percentiles(void) {
+    static ttak_stats_t stats;
+    static ttak_stats_snapshot_t snap;
+    ttak_stats_init(&stats, 0, 1000000);
+    for (uint64_t v = 1; v <= 100000; ++v) ttak_stats_record(&stats, v);
+    ttak_stats_snapshot(&stats, &snap);
+
+    const double qs[] = { 0.5, 0.99, 0.999 };
+    for (int i = 0; i < 3; ++i) {
+        uint64_t exact = (uint64_t)(qs[i] * 100000);
+        uint64_t got = ttak_stats_snapshot_percentile(&snap, qs[i]);
+        ASSERT(got >= exact);
+        ASSERT(got - exact <= exact / TTAK_STATS_SUB_BUCKETS);
+    }
+    ASSERT(ttak_stats_snapshot_percentile(&snap, 1.0) == 100000);
+    ASSERT(ttak_stats_snapshot_percentile(&snap, 0.0) == 1);
+}
+
+#define REC_THREADS 4
+#define REC_PER_THREAD 50000
+
+static ttak_stats_t g_shared_stats;
+
+static void *record_worker(void *arg) {
+    uint64_t base = (uint64_t)(uintptr_t)arg;
+    for (uint64_t i = 0; i < REC_PER_THREAD; ++i) {
+        ttak_stats_record(&g_shared_stats, base + (i & 1023));
+    }
+    return NULL;
+}
+
+static void test_stats_concurrent_record(void) {
+    ttak_stats_init(&g_shared_stats, 0, 100000);
+    pthread_t threads[REC_THREADS];
+    for (uintptr_t i = 0; i < REC_THREADS; ++i) {
+        ASSERT(pthread_create(&threads[i], NULL, record_worker, (void *)(i * 10000 + 1)) == 0);
+    }
+    for (int i = 0; i < REC_THREADS; ++i) pthread_join(threads[i], NULL);
+
+    static ttak_stats_snapshot_t snap;
+    ttak_stats_snapshot(&g_shared_stats, &snap);
+    ASSERT(snap.count == (uint64_t)REC_THREADS * REC_PER_THREAD);
+    ASSERT(snap.min == 1);
+    ASSERT(snap.max == (REC_THREADS - 1) * 10000 + 1 + 1023);
+    uint64_t buckets = 0;
+    for (size_t b = 0; b < TTAK_STATS_HIST_BUCKETS; ++b) buckets += snap.histogram[b];
+    ASSERT(buckets == snap.count);
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+#define SELECT_N 400000
+
+static void check_select(const uint64_t *data, size_t n, ttak_thread_pool_t *pool) {
+    static const double qs[] = { 0.0, 0.5, 0.9, 0.99, 0.999, 0.9999, 1.0, 0.5 };
+    const size_t nq = sizeof(qs) / sizeof(qs[0]);
+    uint64_t out[8];
+    ASSERT(ttak_stats_select_quantiles(data, n, qs, nq, out, pool, ttak_get_tick_count()));
+
+    uint64_t *sorted = malloc(n * sizeof(*sorted));
+    ASSERT(sorted != NULL);
+    memcpy(sorted, data, n * sizeof(*sorted));
+    qsort(sorted, n, sizeof(*sorted), cmp_u64);
+    for (size_t i = 0; i < nq; ++i) {
+        size_t r = (size_t)(qs[i] * (double)n);
+        if (r >= n) r = n - 1;
+        ASSERT(out[i] == sorted[r]);
+    }
+    free(sorted);
+}
+
+static void test_stats_select_quantiles_exact(void) {
+    uint64_t *data = malloc(SELECT_N * sizeof(*data));
+    ASSERT(data != NULL);
+
+    /* Long-tailed latencies: mostly small, a few huge. */
+    uint64_t x = 88172645463325252ULL;
+    for (size_t i = 0; i < SELECT_N; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        uint64_t v = 1000 + (x % 5000);
+        if ((x >> 40) % 1000 == 0) v *= 1000;
+        data[i] = v;
+    }
+    uint64_t first = data[0], last = data[SELECT_N - 1];
+    check_select(data, SELECT_N, NULL);
+    ASSERT(data[0] == first && data[SELECT_N - 1] == last);
+
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, ttak_get_tick_count());
+    ASSERT(pool != NULL);
+    check_select(data, SELECT_N, pool);
+
+    /* Heavy duplicates and a single value. */
+    for (size_t i = 0; i < SELECT_N; ++i) data[i] = (i % 3) ? 7 : 9;
+    check_select(data, SELECT_N, pool);
+    check_select(data, 1, pool);
+    ttak_thread_pool_destroy(pool);
+    free(data);
+}
+
+static void test_stats_ext_fast_moments(void) {
+    uint64_t now = ttak_get_tick_count();
+    static ttak_stats_ext_t fast, exact;
+    ttak_stats_ext_init(&fast, now);
+    ttak_stats_ext_init_mode(&exact, TTAK_STATS_EXT_EXACT, now);
+    for (uint64_t x = 1; x <= 1000; ++x) {
+        ttak_stats_ext_record(&fast, x, 2 * x + 3, now);
+        ttak_stats_ext_record(&exact, x, 2 * x + 3, now);
+    }
+
+    /* Population variance of 1..n is (n^2 - 1) / 12. */
+    double var, sd, r, slope, icpt;
+    ASSERT(ttak_stats_ext_variance_f64(&fast, &var));
+    ASSERT(fabs(var - 83333.25) < 1e-6);
+    ASSERT(ttak_stats_ext_stddev_f64(&fast, &sd) && fabs(sd * sd - var) < 1e-6);
+    ASSERT(fabs(ttak_stats_ext_mean_f64(&fast) - 500.5) < 1e-9);
+    ASSERT(ttak_stats_ext_correlation_f64(&fast, &r) && fabs(r - 1.0) < 1e-12);
+    ASSERT(ttak_stats_ext_linear_regression_f64(&fast, &slope, &icpt));
+    ASSERT(fabs(slope - 2.0) < 1e-12 && fabs(icpt - 3.0) < 1e-9);
+
+    /* The bigreal view holds the same value to 16 significant digits. */
+    ttak_bigreal_t big;
+    ttak_bigreal_init(&big, now);
+    uint64_t m = 0;
+    ASSERT(ttak_stats_ext_variance(&big, &fast, now));
+    ASSERT(ttak_bigint_export_u64(&big.mantissa, &m));
+    ASSERT(big.exponent == -11);
+    ASSERT(fabs((double)m * 1e-11 - var) < 1e-9 * var);
+    ASSERT(ttak_stats_ext_variance(&big, &exact, now));
+    ttak_bigreal_free(&big, now);
+
+    /* Chunked parallel folding matches one pass. */
+    static uint64_t data[10000];
+    for (size_t i = 0; i < 10000; ++i) data[i] = (i * 2654435761u) % 100000;
+    static ttak_stats_ext_t seq, par;
+    ttak_stats_ext_init(&seq, now);
+    ttak_stats_ext_init(&par, now);
+    for (size_t i = 0; i < 10000; ++i) ttak_stats_ext_record(&seq, data[i], 0, now);
+    ASSERT(ttak_stats_parallel_process(&par, data, 10000, NULL, now));
+    double v1, v2;
+    ASSERT(ttak_stats_ext_variance_f64(&seq, &v1) && ttak_stats_ext_variance_f64(&par, &v2));
+    ASSERT(fabs(v1 - v2) < 1e-6 * v1);
+    ASSERT(fabs(ttak_stats_ext_mean_f64(&seq) - ttak_stats_ext_mean_f64(&par)) < 1e-9);
+    ASSERT(ttak_stats_ext_correlation_f64(&par, &r) == false);
+
+    ttak_stats_ext_destroy(&fast, now);
+    ttak_stats_ext_destroy(&exact, now);
+    ttak_stats_ext_destroy(&seq, now);
+    ttak_stats_ext_destroy(&par, now);
+}
+
 int main(void) {
     RUN_TEST(test_stats_accumulates_basic_metrics);
+    RUN_TEST(test_stats_log_linear_buckets);
+    RUN_TEST(test_stats_tail_percentiles);
+    RUN_TEST(test_stats_concurrent_record);
+    RUN_TEST(test_stats_select_quantiles_exact);
+    RUN_TEST(test_stats_ext_fast_moments);
     return 0;
 }
@@ -0,0 +1,79 @@
+#include <ttak/math/factor.h>
+#include <ttak/math/sum_divisors.h>
+#include <ttak/mem/mem.h>
+#include <ttak/timing/timing.h>
+#include "test_macros.h"
+#include <stdint.h>
+
+/* sigma(n) from its factorisation; proper divisor sums overflow near 2^64. */
+static ttak_u128_t sigma_reference(uint64_t n, uint64_t now) {
+    ttak_prime_factor_t *factors = NULL;
+    size_t count = 0;
+    ASSERT(ttak_factor_u64(n, &factors, &count, now) == 0);
+    ttak_u128_t sigma = ttak_u128_from_u64(1);
+    for (size_t i = 0; i < count; ++i) {
+        ttak_u128_t term = ttak_u128_from_u64(1);
+        uint64_t power = 1;
+        for (uint32_t e = 0; e < factors[i].a; ++e) {
+            power *= factors[i].p;
+            term = ttak_u128_add64(term, power);
+        }
+        sigma = ttak_u256_low128(ttak_u128_mul_u128(sigma, term));
+    }
+    ttak_mem_free(factors);
+    return sigma;
+}
+
+/* Checks sigma over [start, start + count) against the per-value path. */
+static void check_range(uint64_t start, size_t count, ttak_thread_pool_t *pool) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_u128_t *sigma = ttak_mem_alloc_raw(count * sizeof(*sigma), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ASSERT(sigma != NULL);
+    ASSERT(ttak_sum_divisors_range(start, count, sigma, pool, now));
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t n = start + i;
+        uint64_t proper = 0;
+        ttak_u128_t expected = ttak_sum_proper_divisors_u64(n, &proper)
+                                   ? ttak_u128_add64(ttak_u128_from_u64(proper), n)
+                                   : sigma_reference(n, now);
+        ASSERT_MSG(ttak_u128_cmp(sigma[i], expected) == 0, "sigma(%llu) mismatch", (unsigned long long)n);
+    }
+    ttak_mem_free(sigma);
+}
+
+void test_sum_divisors_range_small() {
+    ttak_u128_t sigma[12];
+    ASSERT(ttak_sum_divisors_range(1, 12, sigma, NULL, 0));
+    static const uint64_t expected[12] = { 1, 3, 4, 7, 6, 12, 8, 15, 13, 18, 12, 28 };
+    for (size_t i = 0; i < 12; ++i) {
+        ASSERT(sigma[i].hi == 0 && sigma[i].lo == expected[i]);
+    }
+    ASSERT(!ttak_sum_divisors_range(0, 4, sigma, NULL, 0));
+    ASSERT(!ttak_sum_divisors_range(UINT64_MAX - 2, 4, sigma, NULL, 0));
+}
+
+void test_sum_divisors_range_matches_per_value() {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(4, 0, now);
+    ASSERT(pool != NULL);
+    /* Several segments, with a partial one at the end. */
+    check_range(1, 3 * TTAK_SUMDIV_RANGE_SEGMENT + 123, pool);
+    check_range(1000000000000ULL - 5000, 10000, pool);
+    check_range(1ULL << 40, 4096, NULL);
+    ttak_thread_pool_destroy(pool);
+}
+
+void test_sum_divisors_range_beyond_sieve_bound() {
+    /* Past TTAK_SUMDIV_RANGE_SIEVE_MAX_PRIME^2 the cofactors left by the sieve are factored. */
+    check_range(UINT64_MAX - 300, 301, NULL);
+    ttak_u128_t sigma;
+    ASSERT(ttak_sum_divisors_range(9223372036854775808ULL, 1, &sigma, NULL, 0));
+    ASSERT(sigma.hi == 0 && sigma.lo == UINT64_MAX);
+}
+
+int main() {
+    RUN_TEST(test_sum_divisors_range_small);
+    RUN_TEST(test_sum_divisors_range_matches_per_value);
+    RUN_TEST(test_sum_divisors_range_beyond_sieve_bound);
+    return 0;
+}
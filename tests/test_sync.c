@@ -1,7 +1,15 @@
 #include <ttak/sync/sync.h>
 #include <ttak/sync/spinlock.h>
+#include <ttak/sync/qlock.h>
+#include <ttak/sync/brlock.h>
+#include <ttak/sync/waitword.h>
+#include <errno.h>
+#include <pthread.h>
 #include "test_macros.h"
 
+#define QLOCK_THREADS 4
+#define QLOCK_ITERS 20000
+
 static void test_mutex_basic(void) {
     ttak_mutex_t mutex;
     ASSERT(ttak_mutex_init(&mutex) == 0);
@@ -20,8 +28,209 @@ static void test_spinlock_paths(void) {
     ttak_spin_unlock(&lock);
 }
 
+/*
+ * Each lock kind guards a plain counter bumped with a deliberate
+ * read-modify-write split in two; a lost update means mutual exclusion failed.
+ */
+#define QLOCK_STRESS(kind, type)                                               \
+    static type g_##kind##_lock;                                               \
+    static uint64_t g_##kind##_count;                                          \
+    static void *kind##_worker(void *arg) {                                    \
+        (void)arg;                                                             \
+        for (int i = 0; i < QLOCK_ITERS; i++) {                                \
+            ttak_##kind##_lock(&g_##kind##_lock);                              \
+            uint64_t v = g_##kind##_count;                                     \
+            __asm__ volatile("" ::: "memory");                                 \
+            g_##kind##_count = v + 1;                                          \
+            ttak_##kind##_unlock(&g_##kind##_lock);                            \
+        }                                                                      \
+        return NULL;                                                           \
+    }                                                                          \
+    static void test_##kind##_exclusion(void) {                                \
+        ttak_##kind##_init(&g_##kind##_lock);                                  \
+        g_##kind##_count = 0;                                                  \
+        pthread_t th[QLOCK_THREADS];                                           \
+        for (int i = 0; i < QLOCK_THREADS; i++)                                \
+            ASSERT(pthread_create(&th[i], NULL, kind##_worker, NULL) == 0);    \
+        for (int i = 0; i < QLOCK_THREADS; i++) pthread_join(th[i], NULL);     \
+        ASSERT(g_##kind##_count == (uint64_t)QLOCK_THREADS * QLOCK_ITERS);     \
+        ASSERT(ttak_##kind##_trylock(&g_##kind##_lock));                       \
+        ASSERT(!ttak_##kind##_trylock(&g_##kind##_lock));                      \
+        ttak_##kind##_unlock(&g_##kind##_lock);                                \
+    }
+
+QLOCK_STRESS(ticket, ttak_ticket_t)
+QLOCK_STRESS(mcs, ttak_mcs_t)
+QLOCK_STRESS(clh, ttak_clh_t)
+QLOCK_STRESS(cohort, ttak_cohort_t)
+
+static void test_mcs_nested_release_out_of_order(void) {
+    ttak_mcs_t a = TTAK_MCS_INITIALIZER, b = TTAK_MCS_INITIALIZER;
+    ttak_mcs_lock(&a);
+    ttak_mcs_lock(&b);
+    ttak_mcs_unlock(&a);
+    ASSERT(ttak_mcs_trylock(&a));
+    ttak_mcs_unlock(&b);
+    ttak_mcs_unlock(&a);
+    ASSERT(ttak_mcs_trylock(&b));
+    ttak_mcs_unlock(&b);
+}
+
+static void test_hot_lock_static_init(void) {
+    static ttak_hot_lock_t lock;
+    ASSERT(ttak_hot_trylock(&lock));
+    ttak_hot_unlock(&lock);
+    ttak_hot_lock(&lock);
+    ASSERT(!ttak_hot_trylock(&lock));
+    ttak_hot_unlock(&lock);
+}
+
+static ttak_brlock_t g_brlock = TTAK_BRLOCK_INITIALIZER;
+static uint64_t g_br_a, g_br_b;
+static _Atomic int g_br_torn;
+
+static void *brlock_reader(void *arg) {
+    (void)arg;
+    for (int i = 0; i < QLOCK_ITERS; i++) {
+        ASSERT(ttak_brlock_rdlock(&g_brlock) == 0);
+        if (g_br_a != g_br_b) atomic_fetch_add(&g_br_torn, 1);
+        ASSERT(ttak_brlock_rdunlock(&g_brlock) == 0);
+    }
+    return NULL;
+}
+
+static void *brlock_writer(void *arg) {
+    (void)arg;
+    for (int i = 0; i < QLOCK_ITERS / 100; i++) {
+        ASSERT(ttak_brlock_wrlock(&g_brlock) == 0);
+        g_br_a++;
+        __asm__ volatile("" ::: "memory");
+        g_br_b++;
+        ASSERT(ttak_brlock_wrunlock(&g_brlock) == 0);
+    }
+    return NULL;
+}
+
+static void test_brlock_readers_see_whole_writes(void) {
+    pthread_t th[QLOCK_THREADS];
+    ASSERT(pthread_create(&th[0], NULL, brlock_writer, NULL) == 0);
+    for (int i = 1; i < QLOCK_THREADS; i++) ASSERT(pthread_create(&th[i], NULL, brlock_reader, NULL) == 0);
+    for (int i = 0; i < QLOCK_THREADS; i++) pthread_join(th[i], NULL);
+    ASSERT(atomic_load(&g_br_torn) == 0);
+    ASSERT(g_br_a == QLOCK_ITERS / 100);
+}
+
+static void test_brlock_nested_reads(void) {
+    ttak_brlock_t a, b;
+    ASSERT(ttak_brlock_init(&a) == 0);
+    ASSERT(ttak_brlock_init(&b) == 0);
+    /* Second read of the same lock collides with its own slot and goes slow. */
+    ASSERT(ttak_brlock_rdlock(&a) == 0);
+    ASSERT(ttak_brlock_rdlock(&a) == 0);
+    ASSERT(ttak_brlock_rdlock(&b) == 0);
+    ASSERT(ttak_brlock_rdunlock(&a) == 0);
+    ASSERT(ttak_brlock_rdunlock(&b) == 0);
+    ASSERT(ttak_brlock_rdunlock(&a) == 0);
+    /* Writers get in once every reader has left, biased or not. */
+    ASSERT(ttak_brlock_wrlock(&a) == 0);
+    ASSERT(ttak_brlock_wrunlock(&a) == 0);
+    ASSERT(ttak_brlock_rdlock(&a) == 0);
+    ASSERT(ttak_brlock_rdunlock(&a) == 0);
+    ASSERT(ttak_brlock_destroy(&a) == 0);
+    ASSERT(ttak_brlock_destroy(&b) == 0);
+}
+
+static void test_waitword_timeout_and_mismatch(void) {
+    _Atomic uint32_t word = 5;
+    /* A stale expected value returns at once. */
+    ASSERT(ttak_waitword_wait(&word, 4, TTAK_WAIT_FOREVER) == 0);
+    ASSERT(ttak_waitword_await(&word, 5, 2000000) == ETIMEDOUT);
+    ASSERT(ttak_waitword_await(&word, 4, 0) == 0);
+}
+
+static _Atomic uint32_t g_ww_word;
+
+static void *waitword_setter(void *arg) {
+    (void)arg;
+    atomic_store(&g_ww_word, 1);
+    ttak_waitword_wake_all(&g_ww_word);
+    return NULL;
+}
+
+static void test_waitword_wake(void) {
+    pthread_t th;
+    atomic_store(&g_ww_word, 0);
+    ASSERT(pthread_create(&th, NULL, waitword_setter, NULL) == 0);
+    ASSERT(ttak_waitword_await(&g_ww_word, 0, TTAK_WAIT_FOREVER) == 0);
+    ASSERT(atomic_load(&g_ww_word) == 1);
+    pthread_join(th, NULL);
+}
+
+#define EC_ITEMS 5000
+
+static ttak_eventcount_t g_ec = TTAK_EVENTCOUNT_INITIALIZER;
+static _Atomic uint32_t g_ec_avail;
+static _Atomic uint32_t g_ec_taken;
+
+static int ec_try_take(void) {
+    uint32_t n = atomic_load(&g_ec_avail);
+    while (n > 0) {
+        if (atomic_compare_exchange_weak(&g_ec_avail, &n, n - 1)) return 1;
+    }
+    return 0;
+}
+
+static void *ec_consumer(void *arg) {
+    (void)arg;
+    for (;;) {
+        if (atomic_load(&g_ec_taken) >= EC_ITEMS) {
+            ttak_eventcount_notify_all(&g_ec);
+            return NULL;
+        }
+        if (ec_try_take()) {
+            atomic_fetch_add(&g_ec_taken, 1);
+            continue;
+        }
+        uint32_t key = ttak_eventcount_prepare(&g_ec);
+        if (ec_try_take()) {
+            ttak_eventcount_cancel(&g_ec);
+            atomic_fetch_add(&g_ec_taken, 1);
+            continue;
+        }
+        if (atomic_load(&g_ec_taken) >= EC_ITEMS) {
+            ttak_eventcount_cancel(&g_ec);
+            continue;
+        }
+        ttak_eventcount_wait(&g_ec, key);
+    }
+}
+
+static void test_eventcount_no_lost_wakeups(void) {
+    pthread_t th[3];
+    for (int i = 0; i < 3; i++) ASSERT(pthread_create(&th[i], NULL, ec_consumer, NULL) == 0);
+    for (int i = 0; i < EC_ITEMS; i++) {
+        atomic_fetch_add(&g_ec_avail, 1);
+        ttak_eventcount_notify(&g_ec);
+    }
+    /* The consumer that takes the last item broadcasts to the others. */
+    for (int i = 0; i < 3; i++) pthread_join(th[i], NULL);
+    ASSERT(atomic_load(&g_ec_taken) == EC_ITEMS);
+    ASSERT(atomic_load(&g_ec.waiters) == 0);
+}
+
 int main(void) {
     RUN_TEST(test_mutex_basic);
     RUN_TEST(test_spinlock_paths);
+    RUN_TEST(test_ticket_exclusion);
+    RUN_TEST(test_mcs_exclusion);
+    RUN_TEST(test_clh_exclusion);
+    RUN_TEST(test_cohort_exclusion);
+    RUN_TEST(test_mcs_nested_release_out_of_order);
+    RUN_TEST(test_hot_lock_static_init);
+    RUN_TEST(test_brlock_readers_see_whole_writes);
+    RUN_TEST(test_brlock_nested_reads);
+    RUN_TEST(test_waitword_timeout_and_mismatch);
+    RUN_TEST(test_waitword_wake);
+    RUN_TEST(test_eventcount_no_lost_wakeups);
     return 0;
 }
@@ -1,4 +1,6 @@
 #include <ttak/stats/system_usage.h>
+#include <ttak/timing/timing.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "test_macros.h"
@@ -24,7 +26,49 @@ static void test_system_usage_api_basics(void) {
     free(json);
 }
 
+static void test_system_usage_sampler_snapshots(void) {
+    ttak_sys_snapshot_t snap;
+    ttak_sys_sampler_sample_now();
+    ASSERT(ttak_sys_sampler_read(&snap));
+    uint64_t first = snap.seq;
+    ASSERT(first >= 1);
+    ASSERT(snap.ts_ns != 0);
+#ifdef __linux__
+    ASSERT(snap.ncpu >= 1);
+    ASSERT(snap.rss_bytes > 0);
+    ASSERT(snap.vm_bytes >= snap.rss_bytes);
+#endif
+    if (snap.has_cgroup_mem) ASSERT(snap.cgroup_mem_max > 0 && snap.cgroup_mem_high > 0);
+    if (snap.has_psi) ASSERT(ttak_sys_cpu_pressure() >= 0.0 && ttak_sys_cpu_pressure() <= 100.0);
+
+    /* Burn some CPU between two samples so the busy figure has something to show. */
+    volatile uint64_t sink = 0;
+    uint64_t until = ttak_get_tick_count_ns() + 20000000ULL;
+    while (ttak_get_tick_count_ns() < until) sink++;
+    ttak_sys_sampler_sample_now();
+    ASSERT(ttak_sys_sampler_read(&snap));
+    ASSERT(snap.seq == first + 1);
+    ASSERT(snap.cpu_total >= 0.0 && snap.cpu_total <= 100.0);
+    for (uint32_t i = 0; i < snap.ncpu; i++) ASSERT(snap.cpu_core[i] >= 0.0f && snap.cpu_core[i] <= 100.0f);
+
+    ASSERT(ttak_sys_sampler_start(200) == 0);
+    ASSERT(ttak_sys_sampler_running());
+    uint64_t deadline = ttak_get_tick_count_ns() + 2000000000ULL;
+    do {
+        ASSERT(ttak_sys_sampler_read(&snap));
+    } while (snap.seq < first + 4 && ttak_get_tick_count_ns() < deadline);
+    ASSERT(snap.seq >= first + 4);
+    /* Answered from the snapshot while the sampler runs. */
+    double total = ttak_get_cpu_usage_total();
+    ASSERT(total >= 0.0 && total <= 100.0);
+    ASSERT(ttak_get_rss_footprint() > 0);
+    ttak_sys_sampler_stop();
+    ASSERT(!ttak_sys_sampler_running());
+    ttak_sys_sampler_stop();
+}
+
 int main(void) {
     RUN_TEST(test_system_usage_api_basics);
+    RUN_TEST(test_system_usage_sampler_snapshots);
     return 0;
 }
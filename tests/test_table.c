@@ -1,5 +1,7 @@
 #include "test_macros.h"
 #include <ttak/ht/table.h>
+#include <ttak/security/siphash.h>
+#include <stdio.h>
 #include <string.h>
 #include <stdint.h>
 
@@ -56,8 +58,160 @@ void test_table_resize() {
     ttak_table_destroy(&tbl, now);
 }
 
+#define INC_KEYS 50000
+
+static uint64_t inc_keys[INC_KEYS];
+
+static int key_cmp_u64(const void *a, const void *b) {
+    return *(const uint64_t *)a != *(const uint64_t *)b;
+}
+
+static void test_table_incremental_resize(void) {
+    ttak_table_t tbl;
+    ttak_table_init(&tbl, 16, NULL, key_cmp_u64, NULL, NULL);
+    uint64_t now = 1000;
+    for (int i = 0; i < INC_KEYS; i++) inc_keys[i] = (uint64_t)i * 2654435761ULL;
+
+    int saw_migration = 0;
+    for (int i = 0; i < INC_KEYS; i++) {
+        ttak_table_put(&tbl, &inc_keys[i], sizeof(uint64_t), (void *)(uintptr_t)(i + 1), now);
+        if (tbl.old_ctrls && tbl.old_size > TTAK_TABLE_MIGRATE_STEP) {
+            saw_migration = 1;
+            /* Mid-migration, both generations answer lookups. */
+            int j = i / 2;
+            ASSERT(ttak_table_get(&tbl, &inc_keys[j], sizeof(uint64_t), now) == (void *)(uintptr_t)(j + 1));
+        }
+    }
+    ASSERT(saw_migration);
+    ASSERT(tbl.size == INC_KEYS);
+
+    /* Grow once more, then update and remove pairs still in the old arrays. */
+    while (!tbl.old_ctrls) {
+        static uint64_t extra[INC_KEYS];
+        static int n;
+        extra[n] = ((uint64_t)n << 40) | 1;
+        ttak_table_put(&tbl, &extra[n], sizeof(uint64_t), (void *)1, now);
+        n++;
+    }
+    ASSERT(tbl.old_size > 1000);
+    for (int i = 0; i < INC_KEYS; i += 3) {
+        ttak_table_put(&tbl, &inc_keys[i], sizeof(uint64_t), (void *)(uintptr_t)(i + 7), now);
+    }
+    for (int i = 1; i < INC_KEYS; i += 3) ASSERT(ttak_table_remove(&tbl, &inc_keys[i], sizeof(uint64_t), now));
+    ASSERT(tbl.old_ctrls == NULL);
+
+    for (int i = 0; i < INC_KEYS; i++) {
+        void *v = ttak_table_get(&tbl, &inc_keys[i], sizeof(uint64_t), now);
+        if (i % 3 == 0) ASSERT(v == (void *)(uintptr_t)(i + 7));
+        else if (i % 3 == 1) ASSERT(v == NULL);
+        else ASSERT(v == (void *)(uintptr_t)(i + 1));
+    }
+    ttak_table_destroy(&tbl, now);
+}
+
+static void test_table_get_batch(void) {
+    ttak_table_t tbl;
+    ttak_table_init(&tbl, 16, NULL, key_cmp_u64, NULL, NULL);
+    uint64_t now = 1000;
+    for (int i = 0; i < INC_KEYS; i++) inc_keys[i] = (uint64_t)i * 2654435761ULL;
+
+    static const void *keys[INC_KEYS];
+    static size_t lens[INC_KEYS];
+    static void *out[INC_KEYS];
+    for (int i = 0; i < INC_KEYS; i++) {
+        keys[i] = &inc_keys[i];
+        lens[i] = sizeof(uint64_t);
+    }
+
+    int checked_mid_migration = 0;
+    for (int i = 0; i < INC_KEYS; i++) {
+        ttak_table_put(&tbl, &inc_keys[i], sizeof(uint64_t), (void *)(uintptr_t)(i + 1), now);
+        if (!checked_mid_migration && tbl.old_ctrls && tbl.old_size > 1000) {
+            /* Keys split across both generations, plus ones not inserted yet. */
+            checked_mid_migration = 1;
+            ASSERT(ttak_table_get_batch(&tbl, keys, lens, (size_t)i + 100, out, now) == (size_t)i + 1);
+            for (int j = 0; j < i + 100; j++) ASSERT(out[j] == (j <= i ? (void *)(uintptr_t)(j + 1) : NULL));
+        }
+    }
+    ASSERT(checked_mid_migration);
+    ASSERT(ttak_table_get_batch(&tbl, keys, lens, INC_KEYS, out, now) == INC_KEYS);
+    for (int i = 0; i < INC_KEYS; i++) ASSERT(out[i] == (void *)(uintptr_t)(i + 1));
+    ttak_table_destroy(&tbl, now);
+}
+
+static void test_table_siphash13(void) {
+    // String keys of assorted lengths through the SipHash-1-3 batch path.
+    enum { N = 500 };
+    static char names[N][40];
+    static const void *keys[N + 1];
+    static size_t lens[N + 1];
+    static void *out[N + 1];
+    ttak_table_t tbl;
+    ttak_table_init(&tbl, 16, ttak_siphash13, key_cmp_str, NULL, NULL);
+    uint64_t now = 1000;
+    for (int i = 0; i < N; i++) {
+        int len = snprintf(names[i], sizeof(names[i]), "k%d%.*s", i, i % 30, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+        keys[i] = names[i];
+        lens[i] = (size_t)len + 1;
+        ttak_table_put(&tbl, names[i], lens[i], (void *)(uintptr_t)(i + 1), now);
+    }
+    keys[N] = "absent";
+    lens[N] = 7;
+    ASSERT(ttak_table_get_batch(&tbl, keys, lens, N + 1, out, now) == N);
+    for (int i = 0; i < N; i++) {
+        ASSERT(out[i] == (void *)(uintptr_t)(i + 1));
+        ASSERT(ttak_table_get(&tbl, keys[i], lens[i], now) == out[i]);
+    }
+    ASSERT(out[N] == NULL);
+    ttak_table_destroy(&tbl, now);
+}
+
+static void test_table_inline_keys(void) {
+    ttak_table_t tbl;
+    ttak_table_init_inline(&tbl, 16, NULL, NULL, NULL);
+    uint64_t now = 1000;
+    ASSERT(tbl.ikeys != NULL && tbl.keys == NULL);
+
+    /* Keys are copied into the slots, so one scratch buffer serves them all. */
+    uint8_t buf[16];
+    for (uint32_t i = 0; i < 20000; i++) {
+        size_t len = sizeof(i) + i % 13;
+        memset(buf, 0xa5, sizeof(buf));
+        memcpy(buf, &i, sizeof(i));
+        ttak_table_put(&tbl, buf, len, (void *)(uintptr_t)(i + 1), now);
+    }
+    ASSERT(tbl.size == 20000);
+    for (uint32_t i = 0; i < 20000; i++) {
+        size_t len = sizeof(i) + i % 13;
+        memset(buf, 0xa5, sizeof(buf));
+        memcpy(buf, &i, sizeof(i));
+        ASSERT(ttak_table_get(&tbl, buf, len, now) == (void *)(uintptr_t)(i + 1));
+    }
+
+    /* Same bytes, different length: a different key. */
+    uint8_t zero[16] = {0};
+    ttak_table_put(&tbl, zero, 3, (void *)3, now);
+    ttak_table_put(&tbl, zero, 4, (void *)4, now);
+    ASSERT(ttak_table_get(&tbl, zero, 3, now) == (void *)3);
+    ASSERT(ttak_table_get(&tbl, zero, 4, now) == (void *)4);
+
+    /* Long keys are stored by pointer and compared bytewise. */
+    static const char long_key[] = "2001:0db8:85a3:0000:0000:8a2e:0370:7334#443";
+    char probe[sizeof(long_key)];
+    memcpy(probe, long_key, sizeof(long_key));
+    ttak_table_put(&tbl, (void *)long_key, sizeof(long_key), (void *)9, now);
+    ASSERT(ttak_table_get(&tbl, probe, sizeof(probe), now) == (void *)9);
+    ASSERT(ttak_table_remove(&tbl, probe, sizeof(probe), now));
+    ASSERT(ttak_table_get(&tbl, long_key, sizeof(long_key), now) == NULL);
+    ttak_table_destroy(&tbl, now);
+}
+
 int main() {
     RUN_TEST(test_table_basic);
     RUN_TEST(test_table_resize);
+    RUN_TEST(test_table_incremental_resize);
+    RUN_TEST(test_table_get_batch);
+    RUN_TEST(test_table_siphash13);
+    RUN_TEST(test_table_inline_keys);
     return 0;
 }
@@ -1,7 +1,11 @@
 #include <ttak/thread/pool.h>
 #include <ttak/async/future.h>
+#include <ttak/async/wait_group.h>
 #include <ttak/timing/timing.h>
+#include <sched.h>
 #include <unistd.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include "test_macros.h"
 
 void *thread_func(void *arg) {
@@ -26,7 +30,353 @@ void test_thread_pool_basic() {
     ttak_thread_pool_destroy(pool);
 }
 
+static void *confined_ctx_func(void *arg) {
+    ttak_detachable_context_t **seen = (ttak_detachable_context_t **)arg;
+    ttak_detachable_context_t *ctx = ttak_worker_detachable_context();
+    *seen = ctx;
+    if (!ctx) return NULL;
+    ttak_detachable_allocation_t alloc = ttak_detachable_mem_alloc(ctx, 8192, 0);
+    void *data = alloc.data;
+    ttak_detachable_mem_free(ctx, &alloc);
+    /* Same-worker reuse comes straight back out of the class depot. */
+    ttak_detachable_allocation_t again = ttak_detachable_mem_alloc(ctx, 8192, 0);
+    void *ok = (again.data == data) ? (void *)1 : NULL;
+    ttak_detachable_mem_free(ctx, &again);
+    return ok;
+}
+
+static void test_thread_pool_worker_context(void) {
+    ASSERT(ttak_worker_detachable_context() == NULL);
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+
+    ttak_detachable_context_t *seen = NULL;
+    ttak_future_t *fut = ttak_thread_pool_submit_task(pool, confined_ctx_func, &seen, 0, now);
+    ASSERT(fut != NULL);
+    ASSERT(ttak_future_get(fut) == (void *)1);
+    ASSERT(seen != NULL && (seen->flags & TTAK_ARENA_IS_SINGLE_THREAD));
+    ASSERT(seen == &pool->workers[0]->detachable || seen == &pool->workers[1]->detachable);
+
+    ttak_thread_pool_destroy(pool);
+}
+
+#define SKEW_TASKS 64
+#define SKEW_WORKERS 4
+
+static atomic_int g_skew_done;
+static ttak_worker_t *_Atomic g_skew_ran_on[SKEW_TASKS];
+
+static void *skew_task(void *arg) {
+    size_t idx = (size_t)(uintptr_t)arg;
+    atomic_store(&g_skew_ran_on[idx], ttak_worker_current());
+    usleep(2000);
+    atomic_fetch_add(&g_skew_done, 1);
+    return NULL;
+}
+
+static void test_thread_pool_skewed_hash_is_stolen(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(SKEW_WORKERS, 0, now);
+    ASSERT(pool != NULL);
+    atomic_store(&g_skew_done, 0);
+
+    /* Every task hashes alike, so routing piles them onto a single shard. */
+    for (size_t i = 0; i < SKEW_TASKS; ++i) {
+        ttak_task_t *task = ttak_task_create(skew_task, (void *)(uintptr_t)i, NULL, now);
+        ASSERT(task != NULL);
+        ttak_task_set_hash(task, 0x1234);
+        ASSERT(ttak_thread_pool_schedule_task(pool, task, 0, now));
+    }
+    for (int spins = 0; atomic_load(&g_skew_done) < SKEW_TASKS && spins < 10000; ++spins) usleep(1000);
+    ASSERT(atomic_load(&g_skew_done) == SKEW_TASKS);
+
+    size_t distinct = 0;
+    for (size_t w = 0; w < SKEW_WORKERS; ++w) {
+        for (size_t i = 0; i < SKEW_TASKS; ++i) {
+            if (atomic_load(&g_skew_ran_on[i]) == pool->workers[w]) { distinct++; break; }
+        }
+    }
+    ASSERT(distinct > 1);
+    ttak_thread_pool_destroy(pool);
+}
+
+#define BATCH_TASKS 2000
+
+static void *batch_square(void *arg) {
+    uintptr_t v = (uintptr_t)arg;
+    return (void *)(v * v);
+}
+
+static void test_thread_pool_submit_batch(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(4, 0, now);
+    ASSERT(pool != NULL);
+
+    static ttak_pool_batch_item_t items[BATCH_TASKS];
+    for (size_t i = 0; i < BATCH_TASKS; ++i) {
+        items[i].func = batch_square;
+        items[i].arg = (void *)(uintptr_t)i;
+    }
+    ttak_pool_batch_t *batch = ttak_thread_pool_submit_batch(pool, items, BATCH_TASKS, 0, now);
+    ASSERT(batch != NULL);
+    ASSERT(ttak_pool_batch_submitted(batch) == BATCH_TASKS);
+    ASSERT(ttak_pool_batch_wait(batch) == BATCH_TASKS);
+    ASSERT(ttak_pool_batch_done(batch));
+    for (size_t i = 0; i < BATCH_TASKS; ++i) {
+        ASSERT(ttak_pool_batch_result(batch, i) == (void *)(uintptr_t)(i * i));
+    }
+    ASSERT(ttak_pool_batch_result(batch, BATCH_TASKS) == NULL);
+    ttak_pool_batch_destroy(batch);
+
+    ASSERT(ttak_thread_pool_submit_batch(pool, items, 0, 0, now) == NULL);
+    ttak_thread_pool_destroy(pool);
+}
+
+/* Distinct args spread the tasks over shards so no band fills up. */
+#define WG_SUM ((size_t)BATCH_TASKS * (BATCH_TASKS + 1) / 2)
+
+static _Atomic size_t g_wg_hits;
+
+static void *wg_count(void *arg) {
+    atomic_fetch_add_explicit(&g_wg_hits, (uintptr_t)arg, memory_order_relaxed);
+    return NULL;
+}
+
+static void test_thread_pool_detached_and_wait_group(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(4, 0, now);
+    ASSERT(pool != NULL);
+
+    ttak_wait_group_t wg;
+    ttak_wait_group_init(&wg);
+    atomic_store(&g_wg_hits, 0);
+    for (size_t i = 0; i < BATCH_TASKS; ++i) {
+        ASSERT(ttak_thread_pool_submit_wg(pool, &wg, wg_count, (void *)(uintptr_t)(i + 1), 0, now));
+    }
+    ttak_wait_group_wait(&wg);
+    ASSERT(ttak_wait_group_pending(&wg) == 0);
+    ASSERT(atomic_load(&g_wg_hits) == WG_SUM);
+
+    /* Detached tasks have no handle; join them through a counter instead. */
+    atomic_store(&g_wg_hits, 0);
+    for (size_t i = 0; i < BATCH_TASKS; ++i) {
+        ASSERT(ttak_thread_pool_submit_detached(pool, wg_count, (void *)(uintptr_t)(i + 1), 0, now));
+    }
+    while (atomic_load(&g_wg_hits) != WG_SUM) sched_yield();
+
+    /* A failed submit leaves the group's count untouched. */
+    ASSERT(!ttak_thread_pool_submit_wg(NULL, &wg, wg_count, NULL, 0, now));
+    ASSERT(ttak_wait_group_pending(&wg) == 0);
+    ttak_wait_group_wait(&wg);
+    ttak_wait_group_destroy(&wg);
+    ttak_thread_pool_destroy(pool);
+}
+
+static _Atomic int g_edf_gate;
+static _Atomic int g_edf_pos;
+static uintptr_t g_edf_order[4];
+
+static void *edf_gate_task(void *arg) {
+    while (!atomic_load(&g_edf_gate)) sched_yield();
+    return arg;
+}
+
+static void *edf_record(void *arg) {
+    g_edf_order[atomic_fetch_add(&g_edf_pos, 1)] = (uintptr_t)arg;
+    return arg;
+}
+
+static void test_thread_pool_deadline_class(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(1, 0, now);
+    ASSERT(pool != NULL);
+    atomic_store(&g_edf_gate, 0);
+    atomic_store(&g_edf_pos, 0);
+
+    /* Hold the only worker while the queues fill up. */
+    ttak_future_t *gate = ttak_thread_pool_submit_task(pool, edf_gate_task, NULL, 0, now);
+    ASSERT(gate != NULL);
+    usleep(20000);
+
+    ttak_future_t *plain = ttak_thread_pool_submit_task(pool, edf_record, (void *)(uintptr_t)4, 10, now);
+    ttak_future_t *late = ttak_thread_pool_submit_deadline(pool, edf_record, (void *)(uintptr_t)9, now + 1, now);
+    ttak_future_t *far = ttak_thread_pool_submit_deadline(pool, edf_record, (void *)(uintptr_t)2, now + 60000, now);
+    ttak_future_t *near = ttak_thread_pool_submit_deadline(pool, edf_record, (void *)(uintptr_t)1, now + 30000, now);
+    ASSERT(plain && late && far && near);
+    ASSERT(ttak_thread_pool_submit_deadline(pool, edf_record, NULL, 0, now) == NULL);
+    usleep(20000); /* Let the short deadline lapse. */
+    atomic_store(&g_edf_gate, 1);
+
+    ASSERT(ttak_future_get(plain) == (void *)(uintptr_t)4);
+    ASSERT(ttak_future_get(late) == NULL);
+    ASSERT(ttak_future_get(far) == (void *)(uintptr_t)2);
+    ASSERT(ttak_future_get(near) == (void *)(uintptr_t)1);
+    /* Deadline tasks ran earliest first and ahead of the priority queue. */
+    ASSERT(atomic_load(&g_edf_pos) == 3);
+    ASSERT(g_edf_order[0] == 1 && g_edf_order[1] == 2 && g_edf_order[2] == 4);
+    ASSERT(ttak_thread_pool_shed_count(pool) == 1);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void *park_task(void *arg) {
+    return arg;
+}
+
+static _Atomic int g_elastic_gate;
+static _Atomic int g_elastic_running;
+
+static void *elastic_block_task(void *arg) {
+    atomic_fetch_add(&g_elastic_running, 1);
+    while (!atomic_load(&g_elastic_gate)) usleep(1000);
+    return arg;
+}
+
+static void test_thread_pool_elastic_grow_shrink(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_options_t opts;
+    ttak_thread_pool_options_init(&opts);
+    opts.max_threads = 4;
+    opts.shrink_idle_ns = 20000000ULL;
+    ttak_thread_pool_t *pool = ttak_thread_pool_create_ex(1, &opts, now);
+    ASSERT(pool != NULL);
+    ASSERT(ttak_thread_pool_live_workers(pool) == 1);
+    atomic_store(&g_elastic_gate, 0);
+    atomic_store(&g_elastic_running, 0);
+
+    /* Four blocking tasks on one base worker: only growth lets them all start. */
+    ttak_future_t *futs[4];
+    for (uintptr_t i = 0; i < 4; ++i) {
+        futs[i] = ttak_thread_pool_submit_task(pool, elastic_block_task, (void *)(i + 1), 0, now);
+        ASSERT(futs[i] != NULL);
+    }
+    for (int spins = 0; atomic_load(&g_elastic_running) < 4 && spins < 5000; ++spins) usleep(1000);
+    ASSERT(atomic_load(&g_elastic_running) == 4);
+    ASSERT(ttak_thread_pool_live_workers(pool) == 4);
+
+    atomic_store(&g_elastic_gate, 1);
+    for (uintptr_t i = 0; i < 4; ++i) ASSERT(ttak_future_get(futs[i]) == (void *)(i + 1));
+
+    /* Idle extras retire one per idle period, never below the base count. */
+    for (int spins = 0; ttak_thread_pool_live_workers(pool) > 1 && spins < 5000; ++spins) usleep(1000);
+    ASSERT(ttak_thread_pool_live_workers(pool) == 1);
+
+    /* The pool still runs work after shrinking. */
+    ttak_future_t *after = ttak_thread_pool_submit_task(pool, park_task, (void *)(uintptr_t)7, 0, now);
+    ASSERT(after != NULL);
+    ASSERT(ttak_future_get(after) == (void *)(uintptr_t)7);
+    ttak_thread_pool_destroy(pool);
+}
+
+static void test_thread_pool_idle_park_and_wake(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(4, 0, now);
+    ASSERT(pool != NULL);
+
+    ttak_thread_pool_idle_config_t cfg;
+    ttak_thread_pool_get_idle_config(pool, &cfg);
+    ASSERT(cfg.spin_rounds == TTAK_THREAD_POOL_SPIN_ROUNDS);
+    ASSERT(cfg.park_ns == TTAK_THREAD_POOL_PARK_NS);
+
+    /* Park at once and for longer than the test could wait. */
+    cfg.spin_rounds = 0;
+    cfg.yield_rounds = 0;
+    cfg.park_ns = 30ULL * 1000000000ULL;
+    ttak_thread_pool_set_idle_config(pool, &cfg);
+    for (int spins = 0; atomic_load(&pool->parked_workers) < 4 && spins < 5000; ++spins) usleep(1000);
+    ASSERT(atomic_load(&pool->parked_workers) == 4);
+    ASSERT(atomic_load(&pool->spinning_workers) == 0);
+
+    /* Only a real signal can wake a parked worker before its timeout. */
+    uint64_t start = ttak_get_tick_count_ns();
+    for (uintptr_t i = 1; i <= 8; ++i) {
+        ttak_future_t *fut = ttak_thread_pool_submit_task(pool, park_task, (void *)i, 0, now);
+        ASSERT(fut != NULL);
+        ASSERT(ttak_future_get(fut) == (void *)i);
+    }
+    ASSERT(ttak_get_tick_count_ns() - start < 5ULL * 1000000000ULL);
+
+    ttak_thread_pool_set_idle_config(pool, NULL);
+    ttak_thread_pool_get_idle_config(pool, &cfg);
+    ASSERT(cfg.yield_rounds == TTAK_THREAD_POOL_YIELD_ROUNDS);
+    /* Destroy must wake parked workers too. */
+    ttak_thread_pool_destroy(pool);
+}
+
+static void *where_am_i(void *arg) {
+    (void)arg;
+#if defined(__linux__)
+    return (void *)(intptr_t)sched_getcpu();
+#else
+    return (void *)(intptr_t)-1;
+#endif
+}
+
+static void *my_node(void *arg) {
+    (void)arg;
+    return (void *)(intptr_t)ttak_worker_numa_node();
+}
+
+static void test_thread_pool_placement(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_options_t opts;
+    ttak_thread_pool_options_init(&opts);
+
+    int bad_cpu = -1;
+    opts.cpus = &bad_cpu;
+    opts.cpu_count = 1;
+    ASSERT(ttak_thread_pool_create_ex(2, &opts, now) == NULL);
+
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &allowed)) cpu++;
+
+    opts.cpus = &cpu;
+    ttak_thread_pool_t *pinned = ttak_thread_pool_create_ex(2, &opts, now);
+    ASSERT(pinned != NULL);
+    ASSERT(pinned->workers[0]->cpu == cpu && pinned->workers[1]->cpu == cpu);
+    for (int i = 0; i < 4; ++i) {
+        ttak_future_t *fut = ttak_thread_pool_submit_task(pinned, where_am_i, NULL, 0, now);
+        ASSERT(fut != NULL);
+        ASSERT((intptr_t)ttak_future_get(fut) == cpu);
+    }
+    ttak_thread_pool_destroy(pinned);
+#endif
+
+    ttak_thread_pool_options_init(&opts);
+    opts.numa_aware = 1;
+    ttak_thread_pool_t *pool = ttak_thread_pool_create_ex(4, &opts, now);
+    ASSERT(pool != NULL);
+    ASSERT(pool->numa_groups >= 1 && pool->numa_groups <= 4);
+    for (size_t i = 0; i < 4; ++i) {
+        ttak_worker_t *w = pool->workers[i];
+        ASSERT(w->shard_lo < w->shard_hi && w->shard_hi <= pool->shard_count);
+        ASSERT(w->preferred_shard >= w->shard_lo && w->preferred_shard < w->shard_hi);
+        /* Same node, same shard group. */
+        for (size_t j = 0; j < 4; ++j) {
+            if (pool->workers[j]->numa_node == w->numa_node) ASSERT(pool->workers[j]->shard_lo == w->shard_lo);
+        }
+    }
+    ttak_future_t *fut = ttak_thread_pool_submit_task(pool, my_node, NULL, 0, now);
+    ASSERT(fut != NULL);
+    intptr_t node = (intptr_t)ttak_future_get(fut);
+    ASSERT(node >= -1);
+    ttak_thread_pool_destroy(pool);
+    ASSERT(ttak_worker_numa_node() == -1);
+}
+
 int main() {
     RUN_TEST(test_thread_pool_basic);
+    RUN_TEST(test_thread_pool_worker_context);
+    RUN_TEST(test_thread_pool_skewed_hash_is_stolen);
+    RUN_TEST(test_thread_pool_submit_batch);
+    RUN_TEST(test_thread_pool_detached_and_wait_group);
+    RUN_TEST(test_thread_pool_deadline_class);
+    RUN_TEST(test_thread_pool_idle_park_and_wake);
+    RUN_TEST(test_thread_pool_elastic_grow_shrink);
+    RUN_TEST(test_thread_pool_placement);
     return 0;
 }
@@ -0,0 +1,151 @@
+#include <ttak/timing/wheel.h>
+#include <ttak/timing/timing.h>
+#include <ttak/thread/pool.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+#define TICK 1000000ULL
+
+typedef struct {
+    ttak_timer_t timer;
+    uint64_t due_tick;
+    uint64_t fired_at;
+    int fired;
+} probe_t;
+
+static uint64_t g_clock_tick;
+
+static void *probe_fire(void *arg) {
+    probe_t *p = (probe_t *)arg;
+    p->fired++;
+    p->fired_at = g_clock_tick;
+    return NULL;
+}
+
+static void probe_arm(ttak_timer_wheel_t *wheel, probe_t *p, uint64_t due_tick) {
+    ttak_timer_init(&p->timer, probe_fire, p);
+    p->due_tick = due_tick;
+    p->fired = 0;
+    ttak_timer_arm(wheel, &p->timer, due_tick * TICK);
+}
+
+static void test_timer_wheel_levels_and_cancel(void) {
+    ttak_timer_wheel_t wheel;
+    ttak_timer_wheel_init(&wheel, TICK, 0);
+    ASSERT(ttak_timer_wheel_advance(&wheel, 0) == UINT64_MAX);
+
+    /* One per level, one past the span, one cancelled, one moved. */
+    static const uint64_t dues[] = { 5, 63, 64, 700, 5000, 300000, 20000000, 2000000000ULL };
+    enum { N = sizeof(dues) / sizeof(dues[0]) };
+    probe_t probes[N];
+    for (int i = 0; i < N; ++i) probe_arm(&wheel, &probes[i], dues[i]);
+    probe_t gone, moved;
+    probe_arm(&wheel, &gone, 10);
+    probe_arm(&wheel, &moved, 10);
+    ASSERT(ttak_timer_wheel_pending(&wheel) == N + 2);
+    ASSERT(ttak_timer_cancel(&wheel, &gone.timer));
+    ASSERT(!ttak_timer_cancel(&wheel, &gone.timer));
+    ttak_timer_arm(&wheel, &moved.timer, 4000 * TICK);
+    moved.due_tick = 4000;
+
+    /* The driver is told exactly when the first timer is due. */
+    ASSERT(ttak_timer_wheel_advance(&wheel, 0) == 5 * TICK);
+
+    /* Walk in uneven steps, including long jumps, until everything fired. */
+    uint64_t step = 1;
+    for (g_clock_tick = 0; g_clock_tick <= 2000000000ULL + 1;) {
+        ttak_timer_wheel_advance(&wheel, g_clock_tick * TICK);
+        g_clock_tick += step;
+        step = step * 3 + 1;
+        if (step > 5000000) step = 1;
+    }
+    ttak_timer_wheel_advance(&wheel, g_clock_tick * TICK);
+    ASSERT(ttak_timer_wheel_pending(&wheel) == 0);
+    for (int i = 0; i < N; ++i) {
+        ASSERT(probes[i].fired == 1);
+        ASSERT(probes[i].fired_at >= probes[i].due_tick);
+    }
+    ASSERT(gone.fired == 0);
+    ASSERT(moved.fired == 1 && moved.fired_at >= 4000);
+    ttak_timer_wheel_destroy(&wheel);
+}
+
+#define MANY 200000
+
+static void test_timer_wheel_many_exact(void) {
+    ttak_timer_wheel_t wheel;
+    ttak_timer_wheel_init(&wheel, TICK, 0);
+    probe_t *probes = (probe_t *)malloc(sizeof(probe_t) * MANY);
+    ASSERT(probes != NULL);
+    srand(7);
+    for (int i = 0; i < MANY; ++i) probe_arm(&wheel, &probes[i], 1 + (uint64_t)rand() % 100000);
+    for (int i = 0; i < MANY; i += 2) ASSERT(ttak_timer_cancel(&wheel, &probes[i].timer));
+
+    /* Stepping one tick at a time, every timer fires on exactly its tick. */
+    for (g_clock_tick = 0; g_clock_tick <= 100000; ++g_clock_tick) {
+        ttak_timer_wheel_advance(&wheel, g_clock_tick * TICK);
+    }
+    ASSERT(ttak_timer_wheel_pending(&wheel) == 0);
+    for (int i = 0; i < MANY; ++i) {
+        if (i % 2 == 0) {
+            ASSERT(probes[i].fired == 0);
+        } else {
+            ASSERT(probes[i].fired == 1);
+            ASSERT(probes[i].fired_at == probes[i].due_tick);
+        }
+    }
+    free(probes);
+    ttak_timer_wheel_destroy(&wheel);
+}
+
+static _Atomic int g_driven;
+
+static void *driven_fire(void *arg) {
+    (void)arg;
+    atomic_fetch_add(&g_driven, 1);
+    return NULL;
+}
+
+static void test_timer_wheel_driver_thread_and_pool(void) {
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+    ttak_timer_wheel_t wheel;
+    ttak_timer_wheel_init(&wheel, 0, ttak_get_tick_count_ns());
+    ASSERT(ttak_timer_wheel_start(&wheel, pool));
+    ASSERT(!ttak_timer_wheel_start(&wheel, pool));
+    atomic_store(&g_driven, 0);
+
+    /* A long timer first, so the driver sleeps long and must be woken for the short ones. */
+    ttak_timer_t far, near[4];
+    ttak_timer_init(&far, driven_fire, NULL);
+    ttak_timer_arm(&wheel, &far, ttak_get_tick_count_ns() + TT_SECOND(60));
+    usleep(5000);
+    for (int i = 0; i < 4; ++i) {
+        ttak_timer_init(&near[i], driven_fire, NULL);
+        ttak_timer_arm(&wheel, &near[i], ttak_get_tick_count_ns() + TT_MILLI_SECOND(5 * (i + 1)));
+    }
+    for (int spins = 0; atomic_load(&g_driven) < 4 && spins < 5000; ++spins) usleep(1000);
+    ASSERT(atomic_load(&g_driven) == 4);
+    ASSERT(ttak_timer_cancel(&wheel, &far));
+
+    /* The shared wheel runs callbacks on its own thread. */
+    ttak_timer_t shared;
+    ttak_timer_init(&shared, driven_fire, NULL);
+    ttak_timer_arm(ttak_timer_wheel_shared(), &shared, ttak_get_tick_count_ns() + TT_MILLI_SECOND(2));
+    for (int spins = 0; atomic_load(&g_driven) < 5 && spins < 5000; ++spins) usleep(1000);
+    ASSERT(atomic_load(&g_driven) == 5);
+
+    ttak_timer_wheel_destroy(&wheel);
+    ttak_thread_pool_destroy(pool);
+}
+
+int main(void) {
+    RUN_TEST(test_timer_wheel_levels_and_cancel);
+    RUN_TEST(test_timer_wheel_many_exact);
+    RUN_TEST(test_timer_wheel_driver_thread_and_pool);
+    return 0;
+}
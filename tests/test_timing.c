@@ -1,6 +1,7 @@
 #include <ttak/timing/timing.h>
 #include <ttak/timing/deadline.h>
 #include "test_macros.h"
+#include <pthread.h>
 #include <unistd.h>
 
 static void test_timing_basic(void) {
@@ -20,8 +21,65 @@ static void test_deadline_expiration(void) {
     ASSERT(ttak_deadline_is_expired(&dl) == true);
 }
 
+static void test_timing_tracks_os_clock(void) {
+    /* Whatever backs it, the tick clock shares the OS clock's epoch and rate. */
+    for (int i = 0; i < 50; ++i) {
+        uint64_t os = ttak_clock_os_ns();
+        uint64_t tick = ttak_get_tick_count_ns();
+        uint64_t diff = tick > os ? tick - os : os - tick;
+        ASSERT(diff < TT_MILLI_SECOND(5));
+        usleep(1000);
+    }
+#if defined(__x86_64__) || defined(_M_X64)
+    ASSERT(atomic_load(&g_tsc_state) != TTAK_TSC_UNCALIBRATED);
+    ASSERT((atomic_load(&g_tsc_state) == TTAK_TSC_STABLE) == (atomic_load(&g_tsc_calibration) != NULL));
+#endif
+}
+
+#define MONO_READS 200000
+
+static void *mono_reader(void *arg) {
+    _Bool *ok = (_Bool *)arg;
+    uint64_t prev = ttak_get_tick_count_ns();
+    uint64_t prev_coarse = ttak_get_tick_count_coarse_ns();
+    for (int i = 0; i < MONO_READS; ++i) {
+        uint64_t now = ttak_get_tick_count_ns();
+        uint64_t coarse = ttak_get_tick_count_coarse_ns();
+        if (now < prev || coarse < prev_coarse) *ok = 0;
+        prev = now;
+        prev_coarse = coarse;
+    }
+    return NULL;
+}
+
+static void test_timing_monotonic_across_threads(void) {
+    pthread_t threads[4];
+    _Bool ok[4] = { 1, 1, 1, 1 };
+    for (int i = 0; i < 4; ++i) ASSERT(pthread_create(&threads[i], NULL, mono_reader, &ok[i]) == 0);
+    for (int i = 0; i < 4; ++i) {
+        pthread_join(threads[i], NULL);
+        ASSERT(ok[i]);
+    }
+}
+
+static void test_timing_coarse_clock(void) {
+    uint64_t first = ttak_get_tick_count_coarse_ns();
+    ASSERT(first > 0);
+    usleep(30000);
+    uint64_t coarse = ttak_get_tick_count_coarse_ns();
+    uint64_t precise = ttak_get_tick_count_ns();
+    /* The ticker kept it moving, at most a few ticks behind. */
+    ASSERT(coarse >= first + TT_MILLI_SECOND(20));
+    ASSERT(coarse <= precise);
+    ASSERT(precise - coarse < TT_MILLI_SECOND(20));
+    ASSERT(ttak_get_tick_count_coarse() == coarse / 1000000ULL);
+}
+
 int main(void) {
     RUN_TEST(test_timing_basic);
     RUN_TEST(test_deadline_expiration);
+    RUN_TEST(test_timing_tracks_os_clock);
+    RUN_TEST(test_timing_monotonic_across_threads);
+    RUN_TEST(test_timing_coarse_clock);
     return 0;
 }
@@ -0,0 +1,113 @@
+#include <ttak/log/trace.h>
+#include <ttak/thread/pool.h>
+#include <ttak/timing/timing.h>
+#include <ttak/priority/nice.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_macros.h"
+
+static char *dump_json(void) {
+    FILE *f = tmpfile();
+    ASSERT(f != NULL);
+    ASSERT(ttak_trace_write_json(f) == 0);
+    long len = ftell(f);
+    ASSERT(len > 0);
+    char *buf = malloc((size_t)len + 1);
+    ASSERT(buf != NULL);
+    rewind(f);
+    ASSERT(fread(buf, 1, (size_t)len, f) == (size_t)len);
+    buf[len] = '\0';
+    fclose(f);
+    return buf;
+}
+
+static void test_trace_disabled_records_nothing(void) {
+    ttak_trace_stop();
+    ttak_trace_reset();
+    for (int i = 0; i < 1000; i++) ttak_trace_user("ignored", (uint64_t)i);
+    ASSERT(ttak_trace_event_count() == 0);
+    ASSERT(!ttak_trace_is_enabled());
+}
+
+static _Atomic int g_ran;
+
+static void *count_task(void *arg) {
+    (void)arg;
+    atomic_fetch_add(&g_ran, 1);
+    return NULL;
+}
+
+static void test_trace_pool_tasks_and_user_events(void) {
+    ttak_trace_reset();
+    ttak_trace_start();
+    uint64_t now = ttak_get_tick_count();
+    ttak_thread_pool_t *pool = ttak_thread_pool_create(2, 0, now);
+    ASSERT(pool != NULL);
+    atomic_store(&g_ran, 0);
+    for (int i = 0; i < 16; i++) {
+        ASSERT(ttak_thread_pool_submit_detached(pool, count_task, NULL, __TT_SCHED_NORMAL__, now));
+    }
+    while (atomic_load(&g_ran) < 16) sched_yield();
+    ttak_trace_user("phase \"one\"", 42);
+    ttak_thread_pool_destroy(pool);
+    ttak_trace_stop();
+
+    ASSERT(ttak_trace_event_count() >= 16 * 4 + 1);
+    char *json = dump_json();
+    ASSERT(strncmp(json, "{\"displayTimeUnit\"", 18) == 0);
+    ASSERT(strstr(json, "\"name\":\"submit\"") != NULL);
+    ASSERT(strstr(json, "\"ph\":\"B\"") != NULL);
+    ASSERT(strstr(json, "\"ph\":\"E\"") != NULL);
+    ASSERT(strstr(json, "\"ph\":\"f\",\"ts\"") != NULL);
+    ASSERT(strstr(json, "\"source\":") != NULL);
+    ASSERT(strstr(json, "\"name\":\"phase \\\"one\\\"\"") != NULL);
+    ASSERT(strstr(json, "\"value\":42") != NULL);
+    ASSERT(strcmp(json + strlen(json) - 4, "\n]}\n") == 0);
+    free(json);
+
+    ttak_trace_reset();
+    ASSERT(ttak_trace_event_count() == 0);
+}
+
+static void test_trace_ring_keeps_latest(void) {
+    ttak_trace_reset();
+    ttak_trace_start();
+    for (uint64_t i = 0; i < TTAK_TRACE_RING_EVENTS * 2 + 5; i++) ttak_trace_user("tick", i);
+    ttak_trace_stop();
+    ASSERT(ttak_trace_event_count() == TTAK_TRACE_RING_EVENTS);
+    char *json = dump_json();
+    char last[64];
+    snprintf(last, sizeof(last), "\"value\":%d}", TTAK_TRACE_RING_EVENTS * 2 + 4);
+    ASSERT(strstr(json, last) != NULL);
+    ASSERT(strstr(json, "\"value\":0}") == NULL);
+    free(json);
+    ttak_trace_reset();
+}
+
+static void test_trace_emit_cost(void) {
+    enum { N = 1000000 };
+    ttak_trace_reset();
+    ttak_trace_start();
+    uint64_t t0 = ttak_get_tick_count_ns();
+    for (uint64_t i = 0; i < N; i++) ttak_trace_user("bench", i);
+    uint64_t t1 = ttak_get_tick_count_ns();
+    ttak_trace_stop();
+    uint64_t off0 = ttak_get_tick_count_ns();
+    for (uint64_t i = 0; i < N; i++) ttak_trace_user("bench", i);
+    uint64_t off1 = ttak_get_tick_count_ns();
+    double on_ns = (double)(t1 - t0) / N, off_ns = (double)(off1 - off0) / N;
+    printf("    trace: %.1f ns/event enabled, %.2f ns disabled\n", on_ns, off_ns);
+    /* Loose bound: shared CI machines are noisy. */
+    ASSERT(on_ns < 500.0);
+    ttak_trace_reset();
+}
+
+int main(void) {
+    RUN_TEST(test_trace_disabled_records_nothing);
+    RUN_TEST(test_trace_pool_tasks_and_user_events);
+    RUN_TEST(test_trace_ring_keeps_latest);
+    RUN_TEST(test_trace_emit_cost);
+    return 0;
+}
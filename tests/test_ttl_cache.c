@@ -0,0 +1,232 @@
+#include <ttak/container/ttl_cache.h>
+#include <ttak/mem/epoch.h>
+#include <ttak/timing/timing.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include "test_macros.h"
+
+static void test_ttl_cache_basic(void) {
+    ttak_ttl_cache_t *cache = ttak_ttl_cache_create(NULL);
+    ASSERT(cache != NULL);
+    uint64_t now = ttak_get_tick_count_ns();
+    char buf[32];
+    size_t len = 0;
+
+    ASSERT(ttak_ttl_cache_get(cache, 7, buf, sizeof(buf), &len, now) == TTAK_TTL_CACHE_MISS);
+    ASSERT(ttak_ttl_cache_put(cache, 7, "seven", 5, 0, now) == TTAK_TTL_CACHE_OK);
+    ASSERT(ttak_ttl_cache_get(cache, 7, buf, sizeof(buf), &len, now) == TTAK_TTL_CACHE_OK);
+    ASSERT(len == 5 && memcmp(buf, "seven", 5) == 0);
+    ASSERT(ttak_ttl_cache_get(cache, 7, buf, 2, &len, now) == TTAK_TTL_CACHE_TOO_SMALL && len == 5);
+
+    // Replacing keeps one entry; the pinned view reads in place.
+    ASSERT(ttak_ttl_cache_put(cache, 7, "SEVEN!", 6, 0, now) == TTAK_TTL_CACHE_OK);
+    ttak_epoch_enter();
+    const char *p = ttak_ttl_cache_get_pinned(cache, 7, &len, now);
+    ASSERT(p != NULL && len == 6 && memcmp(p, "SEVEN!", 6) == 0);
+    ttak_epoch_exit();
+
+    ttak_ttl_cache_stats_t st;
+    ttak_ttl_cache_stats(cache, &st);
+    ASSERT(st.entries == 1 && st.hits == 3 && st.misses == 1);
+
+    ASSERT(ttak_ttl_cache_remove(cache, 7));
+    ASSERT(!ttak_ttl_cache_remove(cache, 7));
+    ASSERT(ttak_ttl_cache_get(cache, 7, buf, sizeof(buf), &len, now) == TTAK_TTL_CACHE_MISS);
+    ttak_ttl_cache_stats(cache, &st);
+    ASSERT(st.entries == 0 && st.bytes == 0);
+    ttak_ttl_cache_destroy(cache);
+    ttak_epoch_reclaim();
+}
+
+static void test_ttl_cache_expiry(void) {
+    ttak_ttl_cache_t *cache = ttak_ttl_cache_create(NULL);
+    ASSERT(cache != NULL);
+    uint64_t now = ttak_get_tick_count_ns();
+    uint64_t v = 1;
+    size_t len;
+    ASSERT(ttak_ttl_cache_put(cache, 1, &v, sizeof(v), 20000000ULL, now) == TTAK_TTL_CACHE_OK);
+    ASSERT(ttak_ttl_cache_put(cache, 2, &v, sizeof(v), 0, now) == TTAK_TTL_CACHE_OK);
+
+    // Lookups treat the entry as gone at its deadline, before the wheel removes it.
+    ASSERT(ttak_ttl_cache_get(cache, 1, &v, sizeof(v), &len, now) == TTAK_TTL_CACHE_OK);
+    ASSERT(ttak_ttl_cache_get(cache, 1, &v, sizeof(v), &len, now + 20000000ULL) == TTAK_TTL_CACHE_MISS);
+
+    ttak_ttl_cache_stats_t st;
+    for (int i = 0; i < 1000; i++) {
+        ttak_ttl_cache_stats(cache, &st);
+        if (st.expirations == 1) break;
+        usleep(1000);
+    }
+    ASSERT(st.expirations == 1 && st.entries == 1);
+    ASSERT(ttak_ttl_cache_get(cache, 2, &v, sizeof(v), &len, ttak_get_tick_count_ns()) == TTAK_TTL_CACHE_OK);
+
+    // A replaced entry's timer goes with it.
+    now = ttak_get_tick_count_ns();
+    ASSERT(ttak_ttl_cache_put(cache, 3, &v, sizeof(v), 10000000ULL, now) == TTAK_TTL_CACHE_OK);
+    ASSERT(ttak_ttl_cache_put(cache, 3, &v, sizeof(v), 0, now) == TTAK_TTL_CACHE_OK);
+    usleep(30000);
+    ASSERT(ttak_ttl_cache_get(cache, 3, &v, sizeof(v), &len, ttak_get_tick_count_ns()) == TTAK_TTL_CACHE_OK);
+    ttak_ttl_cache_destroy(cache);
+    ttak_epoch_reclaim();
+}
+
+static void test_ttl_cache_budget(void) {
+    ttak_ttl_cache_config_t cfg = { .max_bytes = TTAK_TTL_CACHE_SHARDS * 4096 };
+    ttak_ttl_cache_t *cache = ttak_ttl_cache_create(&cfg);
+    ASSERT(cache != NULL);
+    uint64_t now = ttak_get_tick_count_ns();
+    uint8_t val[256], big[8192];
+    memset(val, 0xab, sizeof(val));
+    size_t len;
+
+    ASSERT(ttak_ttl_cache_put(cache, 0, big, sizeof(big), 0, now) == TTAK_TTL_CACHE_TOO_LARGE);
+
+    // A key hit between every insert keeps its second chance and survives the churn.
+    ASSERT(ttak_ttl_cache_put(cache, 0, val, sizeof(val), 0, now) == TTAK_TTL_CACHE_OK);
+    for (uint64_t k = 1; k < 2000; k++) {
+        ASSERT(ttak_ttl_cache_put(cache, k, val, sizeof(val), 0, now) == TTAK_TTL_CACHE_OK);
+        ASSERT(ttak_ttl_cache_get(cache, 0, val, sizeof(val), &len, now) == TTAK_TTL_CACHE_OK);
+    }
+    ttak_ttl_cache_stats_t st;
+    ttak_ttl_cache_stats(cache, &st);
+    ASSERT(st.bytes <= cfg.max_bytes && st.evictions > 0);
+    ASSERT(st.entries + st.evictions == 2000);
+    ttak_ttl_cache_destroy(cache);
+    ttak_epoch_reclaim();
+}
+
+static _Atomic int g_computes;
+
+static bool slow_square(uint64_t key, void *out, size_t cap, size_t *len, void *arg) {
+    (void)arg;
+    ASSERT(cap >= sizeof(uint64_t));
+    atomic_fetch_add(&g_computes, 1);
+    usleep(50000);
+    uint64_t v = key * key;
+    memcpy(out, &v, sizeof(v));
+    *len = sizeof(v);
+    return true;
+}
+
+static bool refuse(uint64_t key, void *out, size_t cap, size_t *len, void *arg) {
+    (void)key; (void)out; (void)cap; (void)len; (void)arg;
+    return false;
+}
+
+typedef struct {
+    ttak_ttl_cache_t *cache;
+    pthread_barrier_t *start;
+    _Atomic int bad;
+} herd_t;
+
+static void *herd_main(void *p) {
+    herd_t *h = p;
+    pthread_barrier_wait(h->start);
+    uint64_t v = 0;
+    size_t len = 0;
+    if (ttak_ttl_cache_get_or_compute(h->cache, 12, slow_square, NULL, 0, &v, sizeof(v), &len,
+                                      ttak_get_tick_count_ns()) != TTAK_TTL_CACHE_OK || v != 144) {
+        atomic_store(&h->bad, 1);
+    }
+    return NULL;
+}
+
+static void test_ttl_cache_coalesces(void) {
+    enum { THREADS = 8 };
+    ttak_ttl_cache_t *cache = ttak_ttl_cache_create(NULL);
+    ASSERT(cache != NULL);
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, THREADS);
+    herd_t h = { .cache = cache, .start = &start };
+    pthread_t t[THREADS];
+    for (int i = 0; i < THREADS; i++) ASSERT(pthread_create(&t[i], NULL, herd_main, &h) == 0);
+    for (int i = 0; i < THREADS; i++) pthread_join(t[i], NULL);
+    pthread_barrier_destroy(&start);
+
+    // One compute for the whole herd; the rest waited for it or hit its result.
+    ASSERT(!atomic_load(&h.bad) && atomic_load(&g_computes) == 1);
+    ttak_ttl_cache_stats_t st;
+    ttak_ttl_cache_stats(cache, &st);
+    ASSERT(st.computes == 1 && st.coalesced >= 1 && st.entries == 1);
+
+    // A declined compute caches nothing.
+    uint64_t v;
+    size_t len;
+    uint64_t now = ttak_get_tick_count_ns();
+    ASSERT(ttak_ttl_cache_get_or_compute(cache, 5, refuse, NULL, 0, &v, sizeof(v), &len, now) ==
+           TTAK_TTL_CACHE_FAILED);
+    ASSERT(ttak_ttl_cache_get(cache, 5, &v, sizeof(v), &len, now) == TTAK_TTL_CACHE_MISS);
+    ttak_ttl_cache_destroy(cache);
+    ttak_epoch_reclaim();
+}
+
+typedef struct {
+    ttak_ttl_cache_t *cache;
+    uint64_t base;
+    _Atomic int *stop;
+    _Atomic int *bad;
+} churn_t;
+
+/* Values repeat their key, so a reader can tell a torn or misplaced copy. */
+static void *churn_writer(void *p) {
+    churn_t *c = p;
+    uint64_t val[16];
+    for (int round = 0; round < 200; round++) {
+        for (uint64_t k = 0; k < 256; k++) {
+            for (int i = 0; i < 16; i++) val[i] = k;
+            ttak_ttl_cache_put(c->cache, k, val, sizeof(val), (k & 1) ? 1000000ULL : 0, ttak_get_tick_count_ns());
+        }
+        ttak_ttl_cache_remove(c->cache, (uint64_t)round & 255);
+    }
+    return NULL;
+}
+
+static void *churn_reader(void *p) {
+    churn_t *c = p;
+    uint64_t val[16];
+    size_t len;
+    while (!atomic_load(c->stop)) {
+        for (uint64_t k = 0; k < 256; k++) {
+            if (ttak_ttl_cache_get(c->cache, k, val, sizeof(val), &len, ttak_get_tick_count_ns()) != TTAK_TTL_CACHE_OK) {
+                continue;
+            }
+            for (int i = 0; i < 16; i++) {
+                if (val[i] != k) atomic_store(c->bad, 1);
+            }
+        }
+    }
+    ttak_epoch_deregister_thread();
+    return NULL;
+}
+
+static void test_ttl_cache_concurrent(void) {
+    ttak_ttl_cache_config_t cfg = { .max_bytes = TTAK_TTL_CACHE_SHARDS * 2048 };
+    ttak_ttl_cache_t *cache = ttak_ttl_cache_create(&cfg);
+    ASSERT(cache != NULL);
+    _Atomic int stop = 0, bad = 0;
+    churn_t c = { cache, 0, &stop, &bad };
+    pthread_t w[2], r[4];
+    for (int i = 0; i < 4; i++) ASSERT(pthread_create(&r[i], NULL, churn_reader, &c) == 0);
+    for (int i = 0; i < 2; i++) ASSERT(pthread_create(&w[i], NULL, churn_writer, &c) == 0);
+    for (int i = 0; i < 2; i++) pthread_join(w[i], NULL);
+    atomic_store(&stop, 1);
+    for (int i = 0; i < 4; i++) pthread_join(r[i], NULL);
+    ASSERT(!atomic_load(&bad));
+
+    ttak_ttl_cache_stats_t st;
+    ttak_ttl_cache_stats(cache, &st);
+    ASSERT(st.bytes <= cfg.max_bytes && st.hits > 0);
+    ttak_ttl_cache_destroy(cache);
+    ttak_epoch_reclaim();
+}
+
+int main(void) {
+    RUN_TEST(test_ttl_cache_basic);
+    RUN_TEST(test_ttl_cache_expiry);
+    RUN_TEST(test_ttl_cache_budget);
+    RUN_TEST(test_ttl_cache_coalesces);
+    RUN_TEST(test_ttl_cache_concurrent);
+    return 0;
+}
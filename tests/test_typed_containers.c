@@ -0,0 +1,131 @@
+#include <ttak/ht/typed_map.h>
+#include <ttak/container/typed_ringbuf.h>
+#include <ttak/priority/typed_heap.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+TTAK_MAP_DEFINE(u64map, uint64_t, uint32_t, TTAK_TYPED_HASH_U64, TTAK_TYPED_EQ)
+TTAK_MAP_DEFINE(strmap, const char *, int, TTAK_TYPED_HASH_STR, TTAK_TYPED_STR_EQ)
+
+typedef struct {
+    uint64_t seq;
+    uint32_t payload[6];
+} msg_t;
+
+TTAK_RINGBUF_DEFINE(msgring, msg_t)
+
+typedef struct {
+    uint64_t deadline;
+    uint32_t id;
+} job_t;
+
+#define JOB_LESS(a, b) ((a).deadline < (b).deadline)
+TTAK_HEAP_DEFINE(jobheap, job_t, JOB_LESS)
+
+static void test_typed_map(void) {
+    u64map_t m;
+    ASSERT(u64map_init(&m, 0));
+    ASSERT(u64map_get(&m, 1) == NULL);
+    for (uint64_t k = 0; k < 50000; k++) ASSERT(u64map_put(&m, k * 7919, (uint32_t)k));
+    ASSERT(u64map_size(&m) == 50000);
+    for (uint64_t k = 0; k < 50000; k++) {
+        uint32_t *v = u64map_get(&m, k * 7919);
+        ASSERT(v != NULL && *v == (uint32_t)k);
+    }
+    ASSERT(u64map_put(&m, 0, 99) && *u64map_get(&m, 0) == 99 && u64map_size(&m) == 50000);
+
+    // Churn through tombstones; the map rehashes instead of filling with them.
+    uint32_t old;
+    for (uint64_t k = 0; k < 50000; k += 2) ASSERT(u64map_remove(&m, k * 7919, &old) && old == (k ? k : 99));
+    ASSERT(!u64map_remove(&m, 0, NULL));
+    for (uint64_t k = 1ULL << 40; k < (1ULL << 40) + 100000; k++) {
+        ASSERT(u64map_put(&m, k, 1));
+        ASSERT(u64map_remove(&m, k, NULL));
+    }
+    ASSERT(u64map_size(&m) == 25000 && m.cap <= 65536);
+
+    size_t pos = 0, seen = 0;
+    uint64_t *key;
+    uint32_t *val;
+    while (u64map_next(&m, &pos, &key, &val)) {
+        ASSERT((*key / 7919) % 2 == 1 && *val == (uint32_t)(*key / 7919));
+        seen++;
+    }
+    ASSERT(seen == 25000);
+    u64map_destroy(&m);
+
+    strmap_t s;
+    ASSERT(strmap_init(&s, 4));
+    char a[] = "alpha";
+    ASSERT(strmap_put(&s, "alpha", 1) && strmap_put(&s, "beta", 2));
+    ASSERT(*strmap_get(&s, a) == 1 && *strmap_get(&s, "beta") == 2 && !strmap_get(&s, "gamma"));
+    strmap_destroy(&s);
+}
+
+#define RING_MSGS 200000
+
+static void *ring_producer(void *p) {
+    msgring_t *rb = p;
+    for (uint64_t i = 0; i < RING_MSGS; i++) {
+        msg_t m = { .seq = i, .payload = { (uint32_t)i } };
+        while (!msgring_push(rb, m)) sched_yield();
+    }
+    return NULL;
+}
+
+static void test_typed_ringbuf(void) {
+    msgring_t rb;
+    ASSERT(!msgring_init(&rb, 0));
+    ASSERT(msgring_init(&rb, 100));
+    ASSERT(msgring_capacity(&rb) == 128);
+
+    msg_t m = {0};
+    for (uint64_t i = 0; i < 128; i++) {
+        m.seq = i;
+        ASSERT(msgring_push(&rb, m));
+    }
+    ASSERT(!msgring_push(&rb, m) && msgring_count(&rb) == 128);
+    for (uint64_t i = 0; i < 128; i++) ASSERT(msgring_pop(&rb, &m) && m.seq == i);
+    ASSERT(!msgring_pop(&rb, &m));
+
+    // One producer thread, one consumer: order and contents survive.
+    pthread_t t;
+    ASSERT(pthread_create(&t, NULL, ring_producer, &rb) == 0);
+    for (uint64_t i = 0; i < RING_MSGS; i++) {
+        while (!msgring_pop(&rb, &m)) sched_yield();
+        ASSERT(m.seq == i && m.payload[0] == (uint32_t)i);
+    }
+    pthread_join(t, NULL);
+    msgring_destroy(&rb);
+}
+
+static void test_typed_heap(void) {
+    jobheap_t h;
+    ASSERT(jobheap_init(&h, 0));
+    job_t j;
+    ASSERT(!jobheap_pop(&h, &j) && jobheap_peek(&h) == NULL);
+
+    srand(7);
+    for (uint32_t i = 0; i < 10000; i++) {
+        job_t in = { (uint64_t)rand() % 5000, i };
+        ASSERT(jobheap_push(&h, in));
+    }
+    ASSERT(jobheap_size(&h) == 10000);
+    uint64_t prev = 0;
+    for (uint32_t i = 0; i < 10000; i++) {
+        uint64_t top = jobheap_peek(&h)->deadline;
+        ASSERT(jobheap_pop(&h, &j) && j.deadline == top && j.deadline >= prev);
+        prev = j.deadline;
+    }
+    ASSERT(jobheap_size(&h) == 0);
+    jobheap_destroy(&h);
+}
+
+int main(void) {
+    RUN_TEST(test_typed_map);
+    RUN_TEST(test_typed_ringbuf);
+    RUN_TEST(test_typed_heap);
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <ttak/unsafe/channel.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+#define CTX_SEND 1u
+#define CTX_RECV 2u
+
+static void test_chan_moves_without_copy(void) {
+    ttak_region_chan_t *ch = ttak_region_chan_create(4, TTAK_RINGBUF_SPSC, sizeof(uint32_t), CTX_RECV, "recv");
+    ASSERT(ch != NULL);
+    uint32_t *buf = malloc(16 * sizeof(*buf));
+    ASSERT(buf != NULL);
+    ttak_unsafe_region_t src, dst;
+    ttak_unsafe_region_init(&src, CTX_SEND, "send");
+    ttak_unsafe_region_init(&dst, 0, NULL);
+    ASSERT(ttak_unsafe_region_adopt(&src, buf, 16 * sizeof(*buf), 16 * sizeof(*buf), "send", CTX_SEND));
+
+    ASSERT(ttak_region_chan_send(ch, &src, 0) == TTAK_CHAN_OK);
+    ASSERT(ttak_unsafe_region_is_empty(&src));
+    ASSERT(ttak_region_chan_len(ch) == 1);
+    ASSERT(ttak_region_chan_recv(ch, &dst, 0) == TTAK_CHAN_OK);
+    ASSERT(dst.ptr == buf && dst.size == 16 * sizeof(*buf));
+    ASSERT(dst.ctx_id == CTX_RECV);
+    ASSERT(dst.allocator_tag && dst.allocator_tag[0] == 'r');
+    ASSERT(ttak_region_chan_recv(ch, &dst, 0) == TTAK_CHAN_INVALID); /* dst not empty */
+    ttak_unsafe_region_reset(&dst);
+    ASSERT(ttak_region_chan_recv(ch, &dst, 0) == TTAK_CHAN_WOULD_BLOCK);
+    ASSERT(ttak_region_chan_recv(ch, &dst, 2000000) == TTAK_CHAN_TIMEOUT);
+    free(buf);
+    ttak_region_chan_destroy(ch, NULL, NULL);
+}
+
+static void test_chan_rejects_bad_regions(void) {
+    ttak_region_chan_t *ch = ttak_region_chan_create(2, TTAK_RINGBUF_MPMC, 8, CTX_RECV, NULL);
+    char buf[16];
+    ttak_unsafe_region_t r;
+    ttak_unsafe_region_init(&r, CTX_SEND, NULL);
+    ASSERT(ttak_region_chan_send(ch, &r, 0) == TTAK_CHAN_INVALID); /* empty */
+    ASSERT(ttak_unsafe_region_adopt(&r, buf, 12, 16, NULL, CTX_SEND));
+    ASSERT(ttak_region_chan_send(ch, &r, 0) == TTAK_CHAN_INVALID); /* not whole elements */
+    r.size = 8;
+    ttak_unsafe_region_pin(&r);
+    ASSERT(ttak_region_chan_send(ch, &r, 0) == TTAK_CHAN_INVALID); /* pinned */
+    ttak_unsafe_region_unpin(&r);
+    ASSERT(ttak_region_chan_send(ch, &r, 0) == TTAK_CHAN_OK);
+    ttak_region_chan_destroy(ch, NULL, NULL);
+}
+
+static void count_drop(ttak_unsafe_region_t *region, void *arg) {
+    (void)region;
+    (*(int *)arg)++;
+}
+
+static void test_chan_close_drains_then_fails(void) {
+    ttak_region_chan_t *ch = ttak_region_chan_create(2, TTAK_RINGBUF_MPMC, 1, CTX_RECV, NULL);
+    char a[4], b[4], c[4];
+    ttak_unsafe_region_t r;
+    ttak_unsafe_region_init(&r, CTX_SEND, NULL);
+    ttak_unsafe_region_adopt(&r, a, 4, 4, NULL, CTX_SEND);
+    ASSERT(ttak_region_chan_send(ch, &r, 0) == TTAK_CHAN_OK);
+    ttak_unsafe_region_adopt(&r, b, 4, 4, NULL, CTX_SEND);
+    ASSERT(ttak_region_chan_send(ch, &r, 0) == TTAK_CHAN_OK);
+    ttak_unsafe_region_adopt(&r, c, 4, 4, NULL, CTX_SEND);
+    ASSERT(ttak_region_chan_send(ch, &r, 0) == TTAK_CHAN_WOULD_BLOCK);
+    ASSERT(r.ptr == c);
+    ttak_region_chan_close(ch);
+    ASSERT(ttak_region_chan_is_closed(ch));
+    ASSERT(ttak_region_chan_send(ch, &r, TTAK_WAIT_FOREVER) == TTAK_CHAN_CLOSED);
+    ttak_unsafe_region_t d;
+    ttak_unsafe_region_init(&d, 0, NULL);
+    ASSERT(ttak_region_chan_recv(ch, &d, TTAK_WAIT_FOREVER) == TTAK_CHAN_OK && d.ptr == a);
+    int dropped = 0;
+    ttak_region_chan_destroy(ch, count_drop, &dropped);
+    ASSERT(dropped == 1);
+}
+
+#define PIPE_ITEMS 20000
+#define PIPE_SIDES 2
+
+typedef struct {
+    ttak_region_chan_t *ch;
+    uint32_t *items;
+    _Atomic uint8_t *seen;
+    int base;
+} pipe_arg_t;
+
+static void *pipe_send(void *p) {
+    pipe_arg_t *a = p;
+    for (int i = a->base; i < PIPE_ITEMS; i += PIPE_SIDES) {
+        ttak_unsafe_region_t r;
+        ttak_unsafe_region_init(&r, CTX_SEND, NULL);
+        ttak_unsafe_region_adopt(&r, &a->items[i], sizeof(uint32_t), sizeof(uint32_t), NULL, CTX_SEND);
+        if (ttak_region_chan_send(a->ch, &r, TTAK_WAIT_FOREVER) != TTAK_CHAN_OK) abort();
+    }
+    return NULL;
+}
+
+static void *pipe_recv(void *p) {
+    pipe_arg_t *a = p;
+    for (;;) {
+        ttak_unsafe_region_t r;
+        ttak_unsafe_region_init(&r, 0, NULL);
+        ttak_chan_status_t st = ttak_region_chan_recv(a->ch, &r, TTAK_WAIT_FOREVER);
+        if (st == TTAK_CHAN_CLOSED) break;
+        if (st != TTAK_CHAN_OK || r.ctx_id != CTX_RECV) abort();
+        uint32_t v = *(uint32_t *)r.ptr;
+        atomic_fetch_add_explicit(&a->seen[v], 1, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+static void test_chan_blocking_pipeline(void) {
+    ttak_region_chan_t *ch = ttak_region_chan_create(8, TTAK_RINGBUF_MPMC, sizeof(uint32_t), CTX_RECV, NULL);
+    uint32_t *items = malloc(PIPE_ITEMS * sizeof(*items));
+    _Atomic uint8_t *seen = calloc(PIPE_ITEMS, sizeof(*seen));
+    ASSERT(items && seen);
+    for (uint32_t i = 0; i < PIPE_ITEMS; i++) items[i] = i;
+    pthread_t tx[PIPE_SIDES], rx[PIPE_SIDES];
+    pipe_arg_t args[PIPE_SIDES];
+    for (int i = 0; i < PIPE_SIDES; i++) {
+        args[i] = (pipe_arg_t){ ch, items, seen, i };
+        pthread_create(&rx[i], NULL, pipe_recv, &args[i]);
+    }
+    for (int i = 0; i < PIPE_SIDES; i++) pthread_create(&tx[i], NULL, pipe_send, &args[i]);
+    for (int i = 0; i < PIPE_SIDES; i++) pthread_join(tx[i], NULL);
+    ttak_region_chan_close(ch);
+    for (int i = 0; i < PIPE_SIDES; i++) pthread_join(rx[i], NULL);
+    for (uint32_t i = 0; i < PIPE_ITEMS; i++) ASSERT(seen[i] == 1);
+    ttak_region_chan_destroy(ch, NULL, NULL);
+    free((void *)seen);
+    free(items);
+}
+
+int main(void) {
+    RUN_TEST(test_chan_moves_without_copy);
+    RUN_TEST(test_chan_rejects_bad_regions);
+    RUN_TEST(test_chan_close_drains_then_fails);
+    RUN_TEST(test_chan_blocking_pipeline);
+    return 0;
+}
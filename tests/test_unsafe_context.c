@@ -0,0 +1,96 @@
+#include <ttak/unsafe/context.h>
+#include <pthread.h>
+#include <stdint.h>
+#include "test_macros.h"
+
+static void bump(void *shared, size_t size, void *arg) {
+    (void)size;
+    (void)arg;
+    (*(uint64_t *)shared)++;
+}
+
+static void test_bridge_handoff_and_policy(void) {
+    ttak_owner_t *io = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ttak_owner_t *worker = ttak_owner_create(TTAK_OWNER_DENY_THREADING);
+    ttak_owner_t *isolated = ttak_owner_create(TTAK_OWNER_STRICT_ISOLATION);
+    ASSERT(io && worker && isolated);
+    uint64_t counter = 0;
+    ttak_context_bridge_t bridge;
+    ASSERT(!ttak_context_bridge_init(&bridge, io, isolated, &counter, sizeof(counter), __TTAK_CTX_USE_FIRST__));
+    ASSERT(ttak_context_bridge_init(&bridge, io, worker, &counter, sizeof(counter), __TTAK_CTX_USE_FIRST__));
+    ASSERT(ttak_context_bridge_owner(&bridge, __TTAK_CTX_USE_SECOND__) == worker);
+    ASSERT(ttak_context_bridge_active(&bridge) == __TTAK_CTX_USE_FIRST__);
+
+    /* The side that does not hold the bridge cannot enter or hand it off. */
+    ASSERT(!ttak_context_bridge_enter(&bridge, __TTAK_CTX_USE_SECOND__, 0));
+    ASSERT(!ttak_context_bridge_handoff(&bridge, __TTAK_CTX_USE_SECOND__, __TTAK_CTX_USE_FIRST__));
+    ASSERT(!ttak_context_bridge_run(&bridge, __TTAK_CTX_USE_SECOND__, bump, NULL, __TTAK_CTX_USE_FIRST__, 1000000));
+
+    ASSERT(ttak_context_bridge_run(&bridge, __TTAK_CTX_USE_FIRST__, bump, NULL, __TTAK_CTX_USE_FIRST__, 0));
+    ASSERT(counter == 1);
+    ASSERT(ttak_context_bridge_enter(&bridge, __TTAK_CTX_USE_FIRST__, 0));
+    /* Busy: a hand-off must wait for leave(). */
+    ASSERT(!ttak_context_bridge_handoff(&bridge, __TTAK_CTX_USE_FIRST__, __TTAK_CTX_USE_SECOND__));
+    ttak_context_bridge_leave(&bridge, __TTAK_CTX_USE_FIRST__);
+    ASSERT(ttak_context_bridge_handoff(&bridge, __TTAK_CTX_USE_FIRST__, __TTAK_CTX_USE_SECOND__));
+    ASSERT(ttak_context_bridge_active(&bridge) == __TTAK_CTX_USE_SECOND__);
+    ASSERT(ttak_context_bridge_run(&bridge, __TTAK_CTX_USE_SECOND__, bump, NULL, __TTAK_CTX_USE_FIRST__, 0));
+    ASSERT(counter == 2 && ttak_context_bridge_active(&bridge) == __TTAK_CTX_USE_FIRST__);
+
+    ttak_context_bridge_destroy(&bridge);
+    ttak_owner_destroy(isolated);
+    ttak_owner_destroy(worker);
+    ttak_owner_destroy(io);
+}
+
+#define PING_ROUNDS 20000
+
+typedef struct {
+    ttak_context_bridge_t *bridge;
+    ttak_context_inherit_t side;
+    _Bool ok;
+} ping_arg_t;
+
+static void step(void *shared, size_t size, void *arg) {
+    (void)size;
+    uint64_t *v = shared;
+    ping_arg_t *p = arg;
+    /* Sides alternate strictly: first sees even values, second odd ones. */
+    if ((*v & 1) != (p->side == __TTAK_CTX_USE_SECOND__ ? 1u : 0u)) p->ok = 0;
+    (*v)++;
+}
+
+static void *ping_thread(void *arg) {
+    ping_arg_t *p = arg;
+    ttak_context_inherit_t other = p->side == __TTAK_CTX_USE_FIRST__ ? __TTAK_CTX_USE_SECOND__ : __TTAK_CTX_USE_FIRST__;
+    for (int i = 0; i < PING_ROUNDS; i++) {
+        if (!ttak_context_bridge_run(p->bridge, p->side, step, p, other, TTAK_WAIT_FOREVER)) p->ok = 0;
+    }
+    return NULL;
+}
+
+static void test_bridge_ping_pong(void) {
+    ttak_owner_t *io = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ttak_owner_t *worker = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    uint64_t value = 0;
+    ttak_context_bridge_t bridge;
+    ASSERT(ttak_context_bridge_init(&bridge, io, worker, &value, sizeof(value), __TTAK_CTX_USE_FIRST__));
+    ping_arg_t a = { &bridge, __TTAK_CTX_USE_FIRST__, 1 };
+    ping_arg_t b = { &bridge, __TTAK_CTX_USE_SECOND__, 1 };
+    pthread_t ta, tb;
+    pthread_create(&ta, NULL, ping_thread, &a);
+    pthread_create(&tb, NULL, ping_thread, &b);
+    pthread_join(ta, NULL);
+    pthread_join(tb, NULL);
+    ASSERT(a.ok && b.ok);
+    ASSERT(value == 2 * PING_ROUNDS);
+    ttak_context_bridge_destroy(&bridge);
+    ttak_owner_destroy(worker);
+    ttak_owner_destroy(io);
+}
+
+int main(void) {
+    RUN_TEST(test_bridge_handoff_and_policy);
+    RUN_TEST(test_bridge_ping_pong);
+    return 0;
+}
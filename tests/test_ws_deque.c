@@ -0,0 +1,75 @@
+#include <ttak/thread/ws_deque.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "test_macros.h"
+
+#define ITEMS 100000
+#define THIEVES 3
+
+static void test_ws_deque_owner_order(void) {
+    ttak_ws_deque_t dq;
+    ASSERT(ttak_ws_deque_init(&dq, 2));
+    ASSERT(ttak_ws_deque_pop(&dq) == NULL);
+    /* Pushing past the initial ring forces several grows. */
+    for (uintptr_t i = 1; i <= 100; ++i) ASSERT(ttak_ws_deque_push(&dq, (void *)i));
+    ASSERT(ttak_ws_deque_size(&dq) == 100);
+    ASSERT(ttak_ws_deque_steal(&dq) == (void *)1);
+    ASSERT(ttak_ws_deque_pop(&dq) == (void *)100);
+    for (uintptr_t i = 99; i >= 2; --i) ASSERT(ttak_ws_deque_pop(&dq) == (void *)i);
+    ASSERT(ttak_ws_deque_pop(&dq) == NULL);
+    ASSERT(ttak_ws_deque_steal(&dq) == NULL);
+    ttak_ws_deque_destroy(&dq);
+}
+
+static ttak_ws_deque_t g_dq;
+static atomic_uchar g_seen[ITEMS + 1];
+static atomic_int g_taken;
+static atomic_bool g_done;
+
+static void take(void *item) {
+    uintptr_t v = (uintptr_t)item;
+    ASSERT(v >= 1 && v <= ITEMS);
+    ASSERT(atomic_fetch_add(&g_seen[v], 1) == 0);
+    atomic_fetch_add(&g_taken, 1);
+}
+
+static void *thief(void *arg) {
+    (void)arg;
+    while (!atomic_load(&g_done) || ttak_ws_deque_size(&g_dq) > 0) {
+        void *item = ttak_ws_deque_steal(&g_dq);
+        if (item) take(item);
+    }
+    return NULL;
+}
+
+static void test_ws_deque_concurrent_steal(void) {
+    ASSERT(ttak_ws_deque_init(&g_dq, 0));
+    atomic_store(&g_done, false);
+    pthread_t threads[THIEVES];
+    for (int i = 0; i < THIEVES; ++i) ASSERT(pthread_create(&threads[i], NULL, thief, NULL) == 0);
+
+    for (uintptr_t i = 1; i <= ITEMS; ++i) {
+        ASSERT(ttak_ws_deque_push(&g_dq, (void *)i));
+        /* The owner pops a third of the time, racing thieves for the last item. */
+        if (i % 3 == 0) {
+            void *item = ttak_ws_deque_pop(&g_dq);
+            if (item) take(item);
+        }
+    }
+    void *item;
+    while ((item = ttak_ws_deque_pop(&g_dq)) != NULL) take(item);
+    atomic_store(&g_done, true);
+    for (int i = 0; i < THIEVES; ++i) pthread_join(threads[i], NULL);
+
+    /* Every item was taken exactly once. */
+    ASSERT(atomic_load(&g_taken) == ITEMS);
+    ttak_ws_deque_destroy(&g_dq);
+}
+
+int main(void) {
+    RUN_TEST(test_ws_deque_owner_order);
+    RUN_TEST(test_ws_deque_concurrent_steal);
+    return 0;
+}